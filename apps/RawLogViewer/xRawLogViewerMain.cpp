@@ -30,6 +30,7 @@
 #include <mrpt/obs/CObservationRange.h>
 #include <mrpt/obs/CObservationStereoImages.h>
 #include <mrpt/obs/CRawlog.h>
+#include <mrpt/obs/CRawlogIndexedFile.h>
 #include <mrpt/poses/CPosePDFGaussian.h>
 #include <mrpt/poses/CPosePDFParticles.h>
 #include <mrpt/serialization/CArchive.h>
@@ -1779,8 +1780,8 @@ bool xRawLogViewerFrame::AskForOpenRawlog(std::string& fil)
 {
 	wxString caption = wxT("Choose a file to open");
 	wxString wildcard =
-		wxT("RawLog files (*.rawlog,*.rawlog.gz)|*.rawlog;*.rawlog.gz|All "
-			"files (*.*)|*.*");
+		wxT("RawLog files (*.rawlog,*.rawlog.gz,*.rawlogx)|*.rawlog;*.rawlog."
+			"gz;*.rawlogx|All files (*.*)|*.*");
 
 	wxString defaultDir(
 		(iniFile->read_string(iniFileSect, "LastDir", ".").c_str()));
@@ -2021,6 +2022,12 @@ void xRawLogViewerFrame::loadRawlogFile(const string& str, int first, int last)
 
 	wxBusyCursor waitCursor;
 
+	if (CRawlogIndexedFile::IsIndexedRawlogFile(str))
+	{
+		loadIndexedRawlogFile(str, first, last);
+		return;
+	}
+
 	CFileGZInputStream fil(str);
 
 	uint64_t filSize = fil.getTotalBytesCount();
@@ -2229,6 +2236,79 @@ void xRawLogViewerFrame::loadRawlogFile(const string& str, int first, int last)
 	WX_END_TRY
 }
 
+void xRawLogViewerFrame::loadIndexedRawlogFile(
+	const string& str, int first, int last)
+{
+	CRawlogIndexedFile fil;
+	if (!fil.open(str))
+	{
+		wxMessageBox(
+			string(string("Error opening indexed rawlog:\n") + str).c_str(),
+			_("Error loading file"), wxOK, this);
+		return;
+	}
+
+	const int N = static_cast<int>(fil.size());
+	const int i0 = std::max(0, first);
+	const int i1 = (last == -1 || last >= N) ? N - 1 : last;
+
+	loadedFileName = str;
+	StatusBar1->SetStatusText(
+		(mrpt::format("Loading file: %s", str.c_str()).c_str()));
+
+	wxProgressDialog progDia(
+		wxT("Progress of rawlog load"), wxT("Loading..."),
+		std::max(1, i1 - i0 + 1), this,
+		wxPD_CAN_ABORT | wxPD_APP_MODAL | wxPD_SMOOTH | wxPD_AUTO_HIDE |
+			wxPD_ELAPSED_TIME | wxPD_ESTIMATED_TIME | wxPD_REMAINING_TIME);
+	progDia.SetSize(500, progDia.GetSize().GetHeight());
+	progDia.Center();
+	wxTheApp->Yield();	// Let the app. process messages
+
+	rawlog.clear();
+	crono_Loading.Tic();
+
+	string errorMsg;
+	try
+	{
+		for (int i = i0; i <= i1; i++)
+		{
+			if ((i - i0) % 100 == 0)
+			{
+				wxString auxStr;
+				auxStr.sprintf(
+					wxT("Loading... %u objects"),
+					static_cast<unsigned int>(rawlog.size()));
+				if (!progDia.Update(i - i0, auxStr)) break;
+				wxTheApp->Yield();	// Let the app. process messages
+			}
+
+			auto newObj = fil.getEntry(i);
+			if (IS_CLASS(*newObj, CObservationComment))
+				rawlog.setCommentText(
+					std::dynamic_pointer_cast<CObservationComment>(newObj)
+						->text);
+			else
+				rawlog.insert(newObj);
+		}
+	}
+	catch (std::bad_alloc&)
+	{
+		wxMessageBox(_("OUT OF MEMORY: Try loading a smaller range of the "
+					   "indexed rawlog."));
+	}
+	catch (exception& e)
+	{
+		errorMsg = mrpt::exception_to_str(e);
+	}
+
+	timeToLoad = crono_Loading.Tac();
+	progDia.Update(std::max(1, i1 - i0 + 1));
+
+	rebuildTreeView();
+	txtException->SetValue(errorMsg.c_str());
+}
+
 //------------------------------------------------------------------------
 //           Rebuilds the tree view with data in "rawlog"
 //------------------------------------------------------------------------
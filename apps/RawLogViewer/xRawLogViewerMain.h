@@ -162,6 +162,11 @@ class xRawLogViewerFrame : public wxFrame
 	 */
 	void loadRawlogFile(const std::string& str, int first = 0, int last = -1);
 
+	/** Used by loadRawlogFile() for indexed rawlog files
+	 * (mrpt::obs::CRawlogIndexedFile): only entries [first,last] are read
+	 */
+	void loadIndexedRawlogFile(const std::string& str, int first, int last);
+
 	/** Rebuilds the tree view with the data in "rawlog".
 	 */
 	void rebuildTreeView();
@@ -80,6 +80,7 @@ const std::string iniFileSect("CONF_LIN");
 #include <mrpt/opengl/COpenGLScene.h>
 #include <mrpt/opengl/CPlanarLaserScan.h>  // It's in lib mrpt-maps
 #include <mrpt/opengl/CPointCloud.h>
+#include <mrpt/opengl/CPointCloudBlocks.h>
 #include <mrpt/opengl/CPointCloudColoured.h>
 #include <mrpt/opengl/stock_objects.h>
 #include <mrpt/serialization/CArchive.h>
@@ -374,6 +375,8 @@ const long _DSceneViewerFrame::ID_TRAVELLING_TIMER = wxNewId();
 
 const long _DSceneViewerFrame::ID_TIMER_AUTOPLAY = wxNewId();
 
+const long _DSceneViewerFrame::ID_TIMER_LAZYLOAD = wxNewId();
+
 BEGIN_EVENT_TABLE(_DSceneViewerFrame, wxFrame)
 //(*EventTable(_DSceneViewerFrame)
 //*)
@@ -767,6 +770,7 @@ _DSceneViewerFrame::_DSceneViewerFrame(wxWindow* parent, wxWindowID id)
 	Bind(wxEVT_MENU, &svf::OnMenuCameraTrackingArbitrary, this, ID_MENUITEM14);
 	Bind(wxEVT_TIMER, &svf::OntimAutoplay, this, ID_TIMER_AUTOPLAY);
 	Bind(wxEVT_TIMER, &svf::OnTravellingTrigger, this, ID_TRAVELLING_TIMER);
+	Bind(wxEVT_TIMER, &svf::OntimLazyLoad, this, ID_TIMER_LAZYLOAD);
 
 	// Create the wxCanvas object:
 	m_canvas =
@@ -786,6 +790,9 @@ _DSceneViewerFrame::_DSceneViewerFrame(wxWindow* parent, wxWindowID id)
 
 	m_tTravelling.SetOwner(this, ID_TRAVELLING_TIMER);
 
+	m_tLazyLoad.SetOwner(this, ID_TIMER_LAZYLOAD);
+	m_tLazyLoad.Start(50, false);
+
 	m_dlg_tracking = new CDlgCamTracking(this);
 
 	Maximize();
@@ -869,8 +876,6 @@ void _DSceneViewerFrame::loadFromFile(
 		// Save the path
 		saveLastUsedDirectoryToCfgFile(fil);
 
-		CFileGZInputStream f(fil);
-
 		const auto oldCanvasCamera = m_canvas->cameraParams();
 
 		static mrpt::system::CTicTac tictac;
@@ -881,7 +886,19 @@ void _DSceneViewerFrame::loadFromFile(
 			tictac.Tic();
 
 			openGLSceneRef->clear();
-			mrpt::serialization::archiveFrom(f) >> *openGLSceneRef;
+			if (COpenGLScene::isBlockFile(fil))
+			{
+				// Points are loaded later, progressively (see
+				// OntimLazyLoad()):
+				ASSERTMSG_(
+					openGLSceneRef->loadFromBlockFile(fil),
+					"Error loading the block file");
+			}
+			else
+			{
+				CFileGZInputStream f(fil);
+				mrpt::serialization::archiveFrom(f) >> *openGLSceneRef;
+			}
 		}
 
 		double timeToLoad = tictac.Tac();
@@ -1008,6 +1025,26 @@ void _DSceneViewerFrame::OnbtnAutoplayClicked(wxCommandEvent& event)
 	if (btnAutoplay->GetValue()) m_autoplayTimer->Start(5, true);  // One-shot:
 }
 
+// Keep redrawing while there are visible clouds of block files not fully
+// loaded yet, so they are progressively refined:
+void _DSceneViewerFrame::OntimLazyLoad(wxTimerEvent&)
+{
+	auto& openGLSceneRef = m_canvas->getOpenGLSceneRef();
+	if (!openGLSceneRef) return;
+
+	bool pending = false;
+	{
+		std::lock_guard<std::mutex> lock(critSec_UpdateScene);
+		openGLSceneRef->visitAllObjects(
+			[&pending](const CRenderizable::Ptr& o) {
+				if (auto b = std::dynamic_pointer_cast<CPointCloudBlocks>(o);
+					b && b->hasPendingVisibleBlocks())
+					pending = true;
+			});
+	}
+	if (pending) m_canvas->Refresh(false);
+}
+
 void _DSceneViewerFrame::OntimAutoplay(wxTimerEvent& event)
 {
 	// Load next file:
@@ -1178,8 +1215,9 @@ void _DSceneViewerFrame::OnMenuSave(wxCommandEvent& event)
 	try
 	{
 		wxString caption = wxT("Save scene to file");
-		wxString wildcard =
-			wxT("3Dscene files (*.3Dscene)|*.3Dscene|All files (*.*)|*.*");
+		wxString wildcard = wxT(
+			"3Dscene files (*.3Dscene)|*.3Dscene|3Dscene block files, for "
+			"large point clouds (*.3Dscene)|*.3Dscene|All files (*.*)|*.*");
 		wxString defaultDir(
 			(iniFile->read_string(iniFileSect, "LastDir", ".").c_str()));
 		wxString defaultFilename;
@@ -1192,6 +1230,15 @@ void _DSceneViewerFrame::OnMenuSave(wxCommandEvent& event)
 
 		wxString fileName = dialog.GetPath();
 
+		if (dialog.GetFilterIndex() == 1)
+		{
+			ASSERTMSG_(
+				m_canvas->getOpenGLSceneRef()->saveToBlockFile(
+					string(fileName.mb_str())),
+				"Error saving the block file");
+			return;
+		}
+
 		CFileGZOutputStream fo(string(fileName.mb_str()));
 		mrpt::serialization::archiveFrom(fo) << *m_canvas->getOpenGLSceneRef();
 	}
@@ -101,6 +101,7 @@ class _DSceneViewerFrame : public wxFrame
 	void OnmnuImportImageView(wxCommandEvent& event);
 
 	void OntimAutoplay(wxTimerEvent& event);
+	void OntimLazyLoad(wxTimerEvent& event);
 
 	//(*Identifiers(_DSceneViewerFrame)
 	static const long ID_BUTTON1;
@@ -157,6 +158,7 @@ class _DSceneViewerFrame : public wxFrame
 
 	static const long ID_TRAVELLING_TIMER;
 	static const long ID_TIMER_AUTOPLAY;
+	static const long ID_TIMER_LAZYLOAD;
 
 	//(*Declarations(_DSceneViewerFrame)
 	wxMenuItem* MenuItem8;
@@ -213,6 +215,9 @@ class _DSceneViewerFrame : public wxFrame
 	std::vector<mrpt::opengl::CRenderizable::Ptr> m_selected_gl_objects;
 
 	wxTimer m_tTravelling;
+	/** Redraws while there are point clouds partially loaded from block files
+	 */
+	wxTimer m_tLazyLoad;
 	bool m_travelling_is_arbitrary;
 	std::optional<mrpt::Clock::time_point> m_travelling_start_time;
 
@@ -54,6 +54,9 @@ using namespace std;
 
 TCalibrationImageList lst_images;  // Here are all the images: file_name -> data
 mrpt::img::TCamera camera_params;
+// Settings of the last calibration: it is run incrementally if they do not
+// change, so only the new images are processed.
+std::string last_calib_settings;
 
 // END VARIABLES  ============================
 
@@ -641,11 +644,22 @@ void camera_calib_guiDialog::OnbtnRunCalibClick(wxCommandEvent& event)
 
 		wxBusyCursor waitcur;
 
+		mrpt::vision::TChessboardCornersOptions detectOpts;
+		detectOpts.normalize_image = normalize_image;
+		detectOpts.useScaramuzzaMethod = useScaramuzzaAlternativeDetector;
+		detectOpts.maxDetectionWidth = 1024;
+
+		const std::string settings = mrpt::format(
+			"%u %u %f %f %i %i", check_size_x, check_size_y,
+			check_squares_length_X_meters, check_squares_length_Y_meters,
+			normalize_image ? 1 : 0, useScaramuzzaAlternativeDetector ? 1 : 0);
+		const bool incremental = (settings == last_calib_settings);
+
 		bool res = mrpt::vision::checkerBoardCameraCalibration(
 			lst_images, check_size_x, check_size_y,
 			check_squares_length_X_meters, check_squares_length_Y_meters,
-			camera_params, normalize_image, nullptr /* MSE */,
-			false /* skip draw */, useScaramuzzaAlternativeDetector);
+			camera_params, detectOpts, incremental);
+		last_calib_settings = res ? settings : std::string();
 
 		refreshDisplayedImage();
 
@@ -1993,6 +1993,7 @@ void kinect_calibrate_guiDialog::OnbtnRunCalibClick(wxCommandEvent& event)
 	try
 	{
 		// ============ Set parameters ============
+		const mrpt::vision::TStereoCalibParams formerParams = m_calib_params;
 		m_calib_params.check_size_x = edCalibCheckX->GetValue();
 		m_calib_params.check_size_y = edCalibCheckY->GetValue();
 
@@ -2014,6 +2015,22 @@ void kinect_calibrate_guiDialog::OnbtnRunCalibClick(wxCommandEvent& event)
 
 		m_calib_params.normalize_image = cbCalibNormalize->IsChecked();
 		m_calib_params.use_robust_kernel = cbCalibUseRobust->IsChecked();
+		m_calib_params.detection_max_width = 1024;
+
+		// Only process the new image pairs, unless the settings changed:
+		const auto& a = formerParams;
+		const auto& b = m_calib_params;
+		m_calib_params.incremental = a.check_size_x == b.check_size_x &&
+			a.check_size_y == b.check_size_y &&
+			a.check_squares_length_X_meters ==
+				b.check_squares_length_X_meters &&
+			a.check_squares_length_Y_meters ==
+				b.check_squares_length_Y_meters &&
+			a.normalize_image == b.normalize_image &&
+			a.maxIters == b.maxIters && a.optimize_k1 == b.optimize_k1 &&
+			a.optimize_k2 == b.optimize_k2 && a.optimize_k3 == b.optimize_k3 &&
+			a.optimize_t1 == b.optimize_t1 && a.optimize_t2 == b.optimize_t2 &&
+			a.use_robust_kernel == b.use_robust_kernel;
 
 		//			wxBusyInfo info(_("Running optimizer..."),this);
 		//			wxTheApp->Yield();
@@ -2378,6 +2395,8 @@ void kinect_calibrate_guiDialog::OnbtnListRemoveSelectedClick(
 	if (sel == wxNOT_FOUND || sel >= (int)m_calib_images.size()) return;
 
 	m_calib_images.erase(m_calib_images.begin() + sel);
+	// The former results can't be reused as incremental calibration:
+	m_calib_result = mrpt::vision::TStereoCalibResults();
 	UpdateListOfImages();
 	WX_END_TRY
 }
@@ -47,6 +47,8 @@ void register_tests_atan2lut();
 void register_tests_strings();
 void register_tests_octomaps();
 void register_tests_yaml();
+void register_tests_nav();
+void register_tests_containers();
 // -------------------------------------------------
 
 using TestFunctor =
@@ -7,6 +7,7 @@
    | Released under BSD License. See: https://www.mrpt.org/License          |
    +------------------------------------------------------------------------+ */
 
+#include <mrpt/core/cpu.h>
 #include <mrpt/io/CFileGZInputStream.h>
 #include <mrpt/obs/CObservation3DRangeScan.h>
 #include <mrpt/random.h>
@@ -39,8 +40,21 @@ void generateRandomMaskImage(
 				mrpt::random::getRandomGenerator().drawUniform(0.0, 3.0));
 }
 
+// Instruction sets to benchmark in obs3d_test_depth_to_3d():
+enum class SimdSet : int
+{
+	None = 0,
+	SSE2,
+	AVX2,
+	NEON
+};
+
+// a: SimdSet. b: bit flags: 0x01 min filter, 0x02 max filter, 0x04 2x2
+// decimation, 0x08 organized point cloud.
 double obs3d_test_depth_to_3d(int a, int b)
 {
+	using mrpt::cpu::feature;
+
 	CObservation3DRangeScan obs1;
 	{
 		CFileGZInputStream f(rgbd_test_rawlog_file);
@@ -49,8 +63,19 @@ double obs3d_test_depth_to_3d(int a, int b)
 
 	CTimeLogger timlog;
 
+	const auto simd = static_cast<SimdSet>(a);
 	T3DPointsProjectionParams pp;
-	pp.USE_SSE2 = (a & 0x01) != 0;
+	pp.USE_SSE2 = (simd != SimdSet::None);
+	pp.decimation = (b & 0x04) ? 2 : 1;
+	pp.MAKE_ORGANIZED = (b & 0x08) != 0;
+
+	// Hide the faster instruction sets, so the requested one is used:
+	const bool hadAVX2 = mrpt::cpu::supports(feature::AVX2);
+	const bool hadNEON = mrpt::cpu::supports(feature::NEON);
+	if (simd != SimdSet::AVX2)
+		mrpt::cpu::overrideDetectedFeature(feature::AVX2, false);
+	if (simd != SimdSet::NEON)
+		mrpt::cpu::overrideDetectedFeature(feature::NEON, false);
 
 	TRangeImageFilterParams fp;
 	mrpt::math::CMatrixF minF, maxF;
@@ -77,6 +102,10 @@ double obs3d_test_depth_to_3d(int a, int b)
 
 		if (i > 0) timlog.leave("run");
 	}
+
+	mrpt::cpu::overrideDetectedFeature(feature::AVX2, hadAVX2);
+	mrpt::cpu::overrideDetectedFeature(feature::NEON, hadNEON);
+
 	const double t = timlog.getMeanTime("run");
 	timlog.clear(true);
 	return t;
@@ -130,33 +159,46 @@ void register_tests_CObservation3DRangeScan()
 {
 	if (mrpt::system::fileExists(rgbd_test_rawlog_file))
 	{
-		lstTests.emplace_back(
-			"3DRangeScan: 320x240 Depth->3D (w/o SSE2)", obs3d_test_depth_to_3d,
-			0x00, 0);
-		lstTests.emplace_back(
-			"3DRangeScan: 320x240 Depth->3D (w/SSE2)", obs3d_test_depth_to_3d,
-			0x01, 0);
-
-		lstTests.emplace_back(
-			"3DRangeScan: 320x240 Depth->3D (w/o SSE2,minFilter)",
-			obs3d_test_depth_to_3d, 0x00, 0x01);
-		lstTests.emplace_back(
-			"3DRangeScan: 320x240 Depth->3D (w/SSE2,minFilter)",
-			obs3d_test_depth_to_3d, 0x01, 0x01);
-
-		lstTests.emplace_back(
-			"3DRangeScan: 320x240 Depth->3D (w/o SSE2,maxFilter)",
-			obs3d_test_depth_to_3d, 0x00, 0x02);
-		lstTests.emplace_back(
-			"3DRangeScan: 320x240 Depth->3D (w/SSE2,maxFilter)",
-			obs3d_test_depth_to_3d, 0x01, 0x02);
-
-		lstTests.emplace_back(
-			"3DRangeScan: 320x240 Depth->3D (w/o SSE2,min/maxFilter)",
-			obs3d_test_depth_to_3d, 0x00, 0x03);
-		lstTests.emplace_back(
-			"3DRangeScan: 320x240 Depth->3D (w/SSE2,min/maxFilter)",
-			obs3d_test_depth_to_3d, 0x01, 0x03);
+		using mrpt::cpu::feature;
+		const std::vector<std::pair<SimdSet, std::string>> simdSets = {
+			{SimdSet::None, "w/o SIMD"},
+			{SimdSet::SSE2, "w/SSE2"},
+			{SimdSet::AVX2, "w/AVX2"},
+			{SimdSet::NEON, "w/NEON"}};
+		const std::vector<std::pair<int, std::string>> variants = {
+			{0x00, ""},
+			{0x01, ",minFilter"},
+			{0x02, ",maxFilter"},
+			{0x03, ",min/maxFilter"},
+			{0x04, ",decim=2"},
+			{0x08, ",organized"}};
+
+		const auto isSupported = [](SimdSet s) {
+			switch (s)
+			{
+				case SimdSet::SSE2: return mrpt::cpu::supports(feature::SSE2);
+				case SimdSet::AVX2: return mrpt::cpu::supports(feature::AVX2);
+				case SimdSet::NEON: return mrpt::cpu::supports(feature::NEON);
+				default: return true;
+			};
+		};
+
+		for (const auto& [simd, simdName] : simdSets)
+		{
+			if (!isSupported(simd)) continue;
+
+			for (const auto& [flags, variantName] : variants)
+			{
+				// TestData only keeps a pointer to the name:
+				static std::list<std::string> names;
+				names.push_back(
+					"3DRangeScan: 320x240 Depth->3D ("s + simdName +
+					variantName + ")");
+				lstTests.emplace_back(
+					names.back().c_str(), obs3d_test_depth_to_3d,
+					static_cast<int>(simd), flags);
+			}
+		}
 
 		lstTests.emplace_back(
 			"3DRangeScan: 320x240 Depth->2D scan", obs3d_test_depth_to_2d_scan);
@@ -0,0 +1,184 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <mrpt/containers/CDynamicGrid.h>
+#include <mrpt/containers/CDynamicGrid3D.h>
+#include <mrpt/containers/concurrent_hash_map.h>
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "common.h"
+
+namespace
+{
+constexpr unsigned int NUM_OPS_PER_THREAD = 200000;
+constexpr uint64_t NUM_KEYS = 20000;
+
+/** A mutex-guarded std::unordered_map, with the same interface as
+ * concurrent_hash_map for the operations used in these tests */
+class guarded_unordered_map
+{
+   public:
+	void insert(uint64_t key, uint64_t value)
+	{
+		std::lock_guard<std::mutex> lck(m_mtx);
+		m_map.emplace(key, value);
+	}
+	bool contains(uint64_t key) const
+	{
+		std::lock_guard<std::mutex> lck(m_mtx);
+		return m_map.count(key) != 0;
+	}
+
+   private:
+	std::unordered_map<uint64_t, uint64_t> m_map;
+	mutable std::mutex m_mtx;
+};
+
+// nThreads threads doing lookups of random keys, and one insertion each
+// `insertPeriod` operations. Returns the time per operation.
+template <class MAP>
+double hash_map_test(int nThreads, int insertPeriod)
+{
+	MAP m;
+	for (uint64_t k = 0; k < NUM_KEYS; k += 2)
+		m.insert(k, k);
+
+	std::vector<std::thread> threads;
+	std::atomic<uint64_t> nFound{0};
+	mrpt::system::CTicTac tictac;
+	tictac.Tic();
+	for (int t = 0; t < nThreads; t++)
+		threads.emplace_back([&m, &nFound, t, insertPeriod]() {
+			uint64_t rng = 0x12345678 + t, found = 0;
+			for (unsigned int i = 0; i < NUM_OPS_PER_THREAD; i++)
+			{
+				rng = rng * 6364136223846793005ULL + 1442695040888963407ULL;
+				const uint64_t key = (rng >> 33) % (4 * NUM_KEYS);
+				if (insertPeriod > 0 && (i % insertPeriod) == 0)
+					m.insert(key, i);
+				else if (m.contains(key))
+					found++;
+			}
+			nFound += found;
+		});
+	for (auto& th : threads)
+		th.join();
+	const double t = tictac.Tac();
+	dummy_do_nothing_with_string(std::to_string(nFound));
+	return t / (NUM_OPS_PER_THREAD * nThreads);
+}
+
+// Sum of the 5x5 neighbourhood of each cell of a 2D grid, visiting the cells
+// in storage order. Returns the time per cell.
+template <class GRID>
+double grid2d_window_test(int gridSize, int)
+{
+	GRID grid(0, gridSize * 0.1, 0, gridSize * 0.1, 0.1);
+	grid.forEachCell([](size_t cx, size_t cy, float& c) {
+		c = static_cast<float>((cx * 7 + cy * 13) % 17);
+	});
+
+	double total = 0;
+	mrpt::system::CTicTac tictac;
+	tictac.Tic();
+	grid.forEachCell([&](size_t cx, size_t cy, const float&) {
+		grid.forEachCellInWindow(
+			cx, cy, 2, [&](int, int, const float& c) { total += c; });
+	});
+	const double t = tictac.Tac();
+	dummy_do_nothing_with_string(std::to_string(total));
+	return t / (grid.getSizeX() * grid.getSizeY());
+}
+
+// Walks along z each column of a 3D grid, reading the 6 neighbours of each
+// voxel (as in ray casting). Returns the time per voxel.
+template <class GRID>
+double grid3d_columns_test(int gridSize, int)
+{
+	const double L = gridSize * 0.1;
+	GRID grid(0, L, 0, L, 0, L, 0.1, 0.1);
+	grid.forEachCell([](size_t cx, size_t cy, size_t cz, float& c) {
+		c = static_cast<float>((cx * 7 + cy * 13 + cz) % 17);
+	});
+
+	const int nx = grid.getSizeX(), ny = grid.getSizeY(),
+			  nz = grid.getSizeZ();
+	double total = 0;
+	mrpt::system::CTicTac tictac;
+	tictac.Tic();
+	for (int cy = 1; cy + 1 < ny; cy++)
+		for (int cx = 1; cx + 1 < nx; cx++)
+			for (int cz = 1; cz + 1 < nz; cz++)
+				total += *grid.cellByIndex(cx - 1, cy, cz) +
+					*grid.cellByIndex(cx + 1, cy, cz) +
+					*grid.cellByIndex(cx, cy - 1, cz) +
+					*grid.cellByIndex(cx, cy + 1, cz) +
+					*grid.cellByIndex(cx, cy, cz - 1) +
+					*grid.cellByIndex(cx, cy, cz + 1);
+	const double t = tictac.Tac();
+	dummy_do_nothing_with_string(std::to_string(total));
+	return t / grid.getVoxelCount();
+}
+}  // namespace
+
+// ------------------------------------------------------
+// register_tests_containers
+// ------------------------------------------------------
+void register_tests_containers()
+{
+	using lockfree_t =
+		mrpt::containers::concurrent_hash_map<uint64_t, uint64_t>;
+
+	// TestData only keeps a pointer to the name:
+	static std::list<std::string> names;
+
+	for (int nThreads : {1, 4})
+	{
+		for (int insertPeriod : {0, 10})
+		{
+			const std::string desc = mrpt::format(
+				"%i thread(s), %s", nThreads,
+				insertPeriod ? "10% inserts" : "lookups");
+			names.push_back("Containers: concurrent_hash_map, " + desc);
+			lstTests.emplace_back(
+				names.back().c_str(), &hash_map_test<lockfree_t>, nThreads,
+				insertPeriod);
+			names.push_back("Containers: mutex+std::unordered_map, " + desc);
+			lstTests.emplace_back(
+				names.back().c_str(), &hash_map_test<guarded_unordered_map>,
+				nThreads, insertPeriod);
+		}
+	}
+
+	using namespace mrpt::containers;
+	using grid2d_t = CDynamicGrid<float>;
+	using grid2d_tiled_t = CDynamicGrid<float, GridLayoutTiled2D<3>>;
+	using grid3d_t = CDynamicGrid3D<float>;
+	using grid3d_tiled_t = CDynamicGrid3D<float, double, GridLayoutTiled3D<2>>;
+
+	lstTests.emplace_back(
+		"Containers: CDynamicGrid 2000x2000, 5x5 window, row-major",
+		&grid2d_window_test<grid2d_t>, 2000);
+	lstTests.emplace_back(
+		"Containers: CDynamicGrid 2000x2000, 5x5 window, tiled 8x8",
+		&grid2d_window_test<grid2d_tiled_t>, 2000);
+	lstTests.emplace_back(
+		"Containers: CDynamicGrid3D 200^3, z columns, row-major",
+		&grid3d_columns_test<grid3d_t>, 200);
+	lstTests.emplace_back(
+		"Containers: CDynamicGrid3D 200^3, z columns, tiled 4^3",
+		&grid3d_columns_test<grid3d_tiled_t>, 200);
+}
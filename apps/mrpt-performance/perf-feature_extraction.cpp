@@ -92,6 +92,32 @@ double benchmark_detectFeatures_FASTER(int N, int threshold)
 	return T;
 }
 
+// ------------------------------------------------------
+//		Benchmark: tiled detection and descriptors, 4K image
+// ------------------------------------------------------
+template <TKeyPointMethod FEAT_TYPE, bool TILED>
+double benchmark_detectFeatures4K(int N, int num_feats)
+{
+	CImage img, img4K;
+	getTestImage(0, img);
+	img.scaleImage(img4K, 3840, 2160, mrpt::img::IMG_INTERP_LINEAR);
+
+	CFeatureExtraction fExt;
+	fExt.profiler.enable();
+	fExt.options.featsType = FEAT_TYPE;
+	fExt.options.tiling.enabled = TILED;
+	for (int i = 0; i < N; i++)
+	{
+		CFeatureList fs;
+		fExt.detectFeatures(img4K, fs, 0, num_feats);
+		fExt.computeDescriptors(img4K, fs, descORB);
+		if (i == (N - 1))
+			std::cout << "(" << std::setw(4) << fs.size() << " found)\n";
+	}
+	return fExt.profiler.getMeanTime("detectFeatures") +
+		fExt.profiler.getMeanTime("computeDescriptors");
+}
+
 // ------------------------------------------------------
 // register_tests_feature_extraction
 // ------------------------------------------------------
@@ -141,4 +167,17 @@ void register_tests_feature_extraction()
 			"feature_computeDescriptor [640x480,N=100]: SIFT (OpenCV)",
 			benchmark_computeDescriptor<descSIFT>, 6, 100);
 			*/
+
+	lstTests.emplace_back(
+		"feature_extraction [3840x2160,N=2000]: FAST+ORB desc",
+		benchmark_detectFeatures4K<featFAST, false>, 5, 2000);
+	lstTests.emplace_back(
+		"feature_extraction [3840x2160,N=2000]: FAST+ORB desc (tiled)",
+		benchmark_detectFeatures4K<featFAST, true>, 5, 2000);
+	lstTests.emplace_back(
+		"feature_extraction [3840x2160,N=2000]: ORB+ORB desc",
+		benchmark_detectFeatures4K<featORB, false>, 5, 2000);
+	lstTests.emplace_back(
+		"feature_extraction [3840x2160,N=2000]: ORB+ORB desc (tiled)",
+		benchmark_detectFeatures4K<featORB, true>, 5, 2000);
 }
@@ -8,6 +8,8 @@
    +------------------------------------------------------------------------+ */
 
 #include <mrpt/img/CImage.h>
+#include <mrpt/random.h>
+#include <mrpt/vision/CBinaryDescriptorMatcher.h>
 #include <mrpt/vision/CFeatureExtraction.h>
 
 #include "common.h"
@@ -258,6 +260,84 @@ double feature_matching_test_FAST_SAD(int w, int h)
 	return T;
 }
 
+// ------------------------------------------------------
+//				Benchmark: ORB + Hamming
+// ------------------------------------------------------
+// useMatcher: 0=matchFeatures(), 1=CBinaryDescriptorMatcher
+double feature_matching_test_ORB(int nFeats, int useMatcher)
+{
+	CImage imL, imR;
+	CFeatureExtraction fExt;
+	CFeatureList featsL, featsR;
+	CMatchedFeatureList matches;
+
+	getTestImage(0, imR);
+	getTestImage(1, imL);
+
+	fExt.options.featsType = featORB;
+	fExt.detectFeatures(imL, featsL, 0, nFeats);
+	fExt.detectFeatures(imR, featsR, 0, nFeats);
+
+	TMatchingOptions opt;
+	opt.matching_method = TMatchingOptions::mmDescriptorORB;
+	CBinaryDescriptorMatcher matcher;
+
+	const size_t N = 20;
+	CTicTac tictac;
+	tictac.Tic();
+	for (size_t i = 0; i < N; i++)
+	{
+		if (useMatcher) matcher.match(featsL, featsR, matches);
+		else
+			matchFeatures(featsL, featsR, matches, opt);
+	}
+	return tictac.Tac() / N;
+}
+
+// ------------------------------------------------------
+//	Benchmark: large sets of 256-bit binary descriptors
+// ------------------------------------------------------
+// Half of the descriptors in the second set are noisy copies of those in
+// the first one.
+template <CBinaryDescriptorMatcher::TSearchMethod METHOD>
+double feature_matching_test_binary(int nDescs, int nThreads)
+{
+	auto& rng = mrpt::random::getRandomGenerator();
+	rng.randomize(123);
+
+	CBinaryDescriptorMatcher::TPackedDescriptors set1, set2;
+	set1.resize(nDescs, 32);
+	set2.resize(nDescs, 32);
+	std::vector<uint8_t> d(32);
+	for (int i = 0; i < nDescs; i++)
+	{
+		for (auto& b : d)
+			b = static_cast<uint8_t>(rng.drawUniform32bit());
+		set1.setRow(i, d.data());
+		for (int k = 0; k < 20; k++)
+		{
+			const auto bit = rng.drawUniform32bit() % 256;
+			d[bit / 8] ^= static_cast<uint8_t>(1 << (bit % 8));
+		}
+		if (i % 2)
+			for (auto& b : d)
+				b = static_cast<uint8_t>(rng.drawUniform32bit());
+		set2.setRow((i * 7919) % nDescs, d.data());
+	}
+
+	CBinaryDescriptorMatcher matcher;
+	matcher.options.method = METHOD;
+	matcher.options.numThreads = nThreads;
+	std::vector<TBinaryDescriptorMatch> matches;
+
+	const size_t N = 3;
+	CTicTac tictac;
+	tictac.Tic();
+	for (size_t i = 0; i < N; i++)
+		matcher.match(set1, set2, matches);
+	return tictac.Tac() / N;
+}
+
 // ------------------------------------------------------
 // register_tests_feature_extraction
 // ------------------------------------------------------
@@ -281,4 +361,30 @@ void register_tests_feature_matching()
 	lstTests.emplace_back(
 		"feature_matching [640x480]: FAST + SAD",
 		feature_matching_test_FAST_SAD, 640, 480);
+	lstTests.emplace_back(
+		"feature_matching [640x480,N=1000]: ORB matchFeatures()",
+		feature_matching_test_ORB, 1000, 0);
+	lstTests.emplace_back(
+		"feature_matching [640x480,N=1000]: ORB CBinaryDescriptorMatcher",
+		feature_matching_test_ORB, 1000, 1);
+
+	using m_t = CBinaryDescriptorMatcher;
+	lstTests.emplace_back(
+		"binary_matching [N=5000]: brute force, 1 thread",
+		feature_matching_test_binary<m_t::smBruteForce>, 5000, 1);
+	lstTests.emplace_back(
+		"binary_matching [N=5000]: brute force, all threads",
+		feature_matching_test_binary<m_t::smBruteForce>, 5000, 0);
+	lstTests.emplace_back(
+		"binary_matching [N=5000]: multi-index hashing, 1 thread",
+		feature_matching_test_binary<m_t::smMultiIndexHashing>, 5000, 1);
+	lstTests.emplace_back(
+		"binary_matching [N=50000]: brute force, all threads",
+		feature_matching_test_binary<m_t::smBruteForce>, 50000, 0);
+	lstTests.emplace_back(
+		"binary_matching [N=50000]: multi-index hashing, 1 thread",
+		feature_matching_test_binary<m_t::smMultiIndexHashing>, 50000, 1);
+	lstTests.emplace_back(
+		"binary_matching [N=50000]: multi-index hashing, all threads",
+		feature_matching_test_binary<m_t::smMultiIndexHashing>, 50000, 0);
 }
@@ -114,6 +114,61 @@ double graphs_dijkstra(int nNodes, int _N)
 	return ret;
 }
 
+// Shortest path between two nodes of a random-walk 2D pose graph with loop
+// closures. METHOD: 0=full tree, 1=early exit, 2=A*, 3=bidirectional.
+template <int METHOD>
+double graphs_dijkstra_p2p(int nNodes, int _N)
+{
+	const long N = _N;
+
+	getRandomGenerator().randomize(222);
+	auto& rnd = getRandomGenerator();
+	using graph_t = mrpt::graphs::CNetworkOfPoses2D;
+	using dijkstra_t = mrpt::graphs::CDijkstra<graph_t>;
+	graph_t gs;
+	gs.nodes[0] = CPose2D();
+	for (TNodeID i = 1; i < TNodeID(nNodes); i++)
+	{
+		gs.nodes[i] = gs.nodes[i - 1] +
+			CPose2D(1.0, 0, rnd.drawUniform(-0.3, 0.3));
+		gs.insertEdge(i - 1, i, gs.nodes[i] - gs.nodes[i - 1]);
+		if (i > 50 && rnd.drawUniform(0, 1) < 0.1)
+		{
+			const TNodeID j = rnd.drawUniform32bit() % (i - 50);
+			gs.insertEdge(j, i, gs.nodes[i] - gs.nodes[j]);
+		}
+	}
+	const auto w = &graph_t::dijkstra_edge_length;
+	const auto adj = dijkstra_t(gs, 0, 1, w).getCachedAdjacencyMatrixPtr();
+
+	CTimeLogger tims;
+	for (long i = 0; i < N; i++)
+	{
+		const TNodeID from = rnd.drawUniform32bit() % nNodes;
+		const TNodeID to = rnd.drawUniform32bit() % nNodes;
+		dijkstra_t::edge_list_t path;
+
+		tims.enter("op");
+		if constexpr (METHOD == 0)
+			dijkstra_t(gs, from, w, {}, std::numeric_limits<size_t>::max(), adj)
+				.getShortestPathTo(to, path);
+		else if constexpr (METHOD == 1)
+			dijkstra_t(gs, from, to, w, {}, adj).getShortestPathTo(to, path);
+		else if constexpr (METHOD == 2)
+			dijkstra_t(
+				gs, from, to, w, &graph_t::dijkstra_heuristic_euclidean, adj)
+				.getShortestPathTo(to, path);
+		else
+			dijkstra_t::getShortestPathBidirectional(
+				gs, from, to, path, w, nullptr, adj);
+		tims.leave("op");
+	}
+	tims.enable(false);
+	double ret = tims.getMeanTime("op");
+	tims.clear(true /* deep clear */);
+	return ret;
+}
+
 // ------------------------------------------------------
 // register_tests_graph
 // ------------------------------------------------------
@@ -292,4 +347,17 @@ void register_tests_graph()
 	lstTests.emplace_back(
 		"graph(2d,vec): dijkstra 1e5 nodes",
 		graphs_dijkstra<CPose2D, map_traits_map_as_vector>, 1e5, 50);
+
+	lstTests.emplace_back(
+		"graph(2d): shortest path 1e5 nodes, full tree",
+		graphs_dijkstra_p2p<0>, 1e5, 10);
+	lstTests.emplace_back(
+		"graph(2d): shortest path 1e5 nodes, early exit",
+		graphs_dijkstra_p2p<1>, 1e5, 50);
+	lstTests.emplace_back(
+		"graph(2d): shortest path 1e5 nodes, A*", graphs_dijkstra_p2p<2>, 1e5,
+		50);
+	lstTests.emplace_back(
+		"graph(2d): shortest path 1e5 nodes, bidirectional",
+		graphs_dijkstra_p2p<3>, 1e5, 50);
 }
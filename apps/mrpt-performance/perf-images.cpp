@@ -10,10 +10,12 @@
 #include <mrpt/config/CConfigFileMemory.h>
 #include <mrpt/core/cpu.h>
 #include <mrpt/img/CImage.h>
+#include <mrpt/img/CImageBufferPool.h>
 #include <mrpt/img/TStereoCamera.h>
 #include <mrpt/random.h>
 #include <mrpt/system/filesystem.h>
 #include <mrpt/vision/CImagePyramid.h>
+#include <mrpt/vision/CStereoMatcher.h>
 #include <mrpt/vision/CStereoRectifyMap.h>
 
 #include "common.h"
@@ -164,6 +166,29 @@ double image_test_2(int w, int h)
 	return R;
 }
 
+// Creating and destroying images, as grabbers do for each frame:
+double image_create_destroy(int w, int usePool)
+{
+	auto& pool = mrpt::img::CImageBufferPool::Instance();
+	const bool wasEnabled = pool.isEnabled();
+	pool.setEnabled(usePool != 0);
+
+	const int h = w * 3 / 4;
+	const size_t N = 2000;
+	CTicTac tictac;
+	for (size_t i = 0; i < N; i++)
+	{
+		CImage img(w, h, mrpt::img::CH_RGB);
+		// Touch the pixels, as a real grabber would:
+		img.ptrLine<uint8_t>(h - 1)[0] = 0;
+		if (i == 0) tictac.Tic();
+	}
+	const double R = tictac.Tac() / (N - 1);
+
+	pool.setEnabled(wasEnabled);
+	return R;
+}
+
 template <TImageChannels IMG_CHANNELS, bool DISABLE_SIMD = false>
 double image_halfsample(int w, int h)
 {
@@ -194,6 +219,49 @@ double image_halfsample(int w, int h)
 	return tictac.Tac() / N;
 }
 
+// Raw Bayer (GBRG) 1280x960 camera frame -> CImage
+template <TImageChannels IMG_CHANNELS>
+double image_demosaic(int method, [[maybe_unused]] int a2)
+{
+	const unsigned int w = 1280, h = 960;
+	std::vector<uint8_t> raw(w * h);
+	for (auto& v : raw)
+		v = static_cast<uint8_t>(getRandomGenerator().drawUniform32bit());
+
+	CImage img;
+	CTicTac tictac;
+	const size_t N = 100;
+
+	tictac.Tic();
+	for (size_t i = 0; i < N; i++)
+		img.loadFromBayer(
+			raw.data(), w, h, w, mrpt::img::BAYER_GBRG,
+			static_cast<mrpt::img::TDemosaicMethod>(method), IMG_CHANNELS);
+
+	return tictac.Tac() / N;
+}
+
+// YUV 4:2:2 1280x960 camera frame -> CImage
+template <TImageChannels IMG_CHANNELS>
+double image_yuv422([[maybe_unused]] int a1, [[maybe_unused]] int a2)
+{
+	const unsigned int w = 1280, h = 960;
+	std::vector<uint8_t> raw(w * h * 2);
+	for (auto& v : raw)
+		v = static_cast<uint8_t>(getRandomGenerator().drawUniform32bit());
+
+	CImage img;
+	CTicTac tictac;
+	const size_t N = 100;
+
+	tictac.Tic();
+	for (size_t i = 0; i < N; i++)
+		img.loadFromYUV422(
+			raw.data(), w, h, 2 * w, mrpt::img::YUV422_UYVY, IMG_CHANNELS);
+
+	return tictac.Tac() / N;
+}
+
 template <TImageChannels IMG_CHANNELS, bool DISABLE_SIMD = false>
 double image_halfsample_smooth(int w, int h)
 {
@@ -299,6 +367,26 @@ double image_buildPyramid(int N, int NOCTS)
 	return R;
 }
 
+template <bool FUSED_GRAY, bool USE_SIMD>
+double image_buildPyramidGaussian(int N, int NOCTS)
+{
+	CImage img;
+	getTestImage(0, img);
+
+	mrpt::vision::CImagePyramid pyr;
+	pyr.fusedGrayscale = FUSED_GRAY;
+	pyr.useSIMD = USE_SIMD;
+	// Run once in advance not to count the memory reservation:
+	pyr.buildPyramid(img, NOCTS, mrpt::vision::PyramidFilter::Gaussian5, true);
+
+	CTicTac tictac;
+	tictac.Tic();
+	for (int i = 0; i < N; i++)
+		pyr.buildPyramid(
+			img, NOCTS, mrpt::vision::PyramidFilter::Gaussian5, true);
+	return tictac.Tac() / N;
+}
+
 const char* EXAMPLE_STEREO_CALIB =
 	"[CAMERA_PARAMS_LEFT]\n"
 	"resolution = [1024 768]\n"
@@ -380,6 +468,64 @@ double stereoimage_rectify(int, int)
 	return tictac.Tac() / N;
 }
 
+template <int w, int h, bool GRAY, bool HALF, size_t THREADS>
+double stereoimage_rectify_opts(int, int)
+{
+	const CImage imgL(w, h, CH_RGB), imgR(w, h, CH_RGB);
+	CImage imgL2, imgR2;
+
+	mrpt::img::TStereoCamera params;
+	params.loadFromConfigFile(
+		"CAMERA_PARAMS",
+		mrpt::config::CConfigFileMemory(std::string(EXAMPLE_STEREO_CALIB)));
+	params.scaleToResolution(w, h);
+
+	mrpt::vision::CStereoRectifyMap rectify_map;
+	rectify_map.setFromCamParams(params);
+
+	mrpt::vision::TRemapOptions opts;
+	opts.grayscale = GRAY;
+	opts.halfResolution = HALF;
+	opts.numThreads = THREADS;
+
+	CTicTac tictac;
+	const size_t N = 20;
+	tictac.Tic();
+	for (size_t i = 0; i < N; i++)
+		rectify_map.rectify(imgL, imgR, imgL2, imgR2, opts);
+
+	return tictac.Tac() / N;
+}
+
+template <bool SGM, size_t THREADS>
+double stereo_disparity(int w, int h)
+{
+	// A random texture, shifted 20 pixels:
+	auto& rng = mrpt::random::getRandomGenerator();
+	rng.randomize(123);
+	std::vector<uint8_t> imgL(w * h), imgR(w * h);
+	for (auto& p : imgR)
+		p = rng.drawUniform32bit() & 0xff;
+	for (int y = 0; y < h; y++)
+		for (int x = 0; x < w; x++)
+			imgL[y * w + x] = imgR[y * w + std::max(x - 20, 0)];
+
+	mrpt::vision::CStereoMatcher matcher;
+	matcher.options.method = SGM ? mrpt::vision::CStereoMatcher::smSemiGlobal
+								 : mrpt::vision::CStereoMatcher::smBlockMatching;
+	matcher.options.numDisparities = 64;
+	matcher.options.numThreads = THREADS;
+	mrpt::math::CMatrixFloat disp;
+
+	CTicTac tictac;
+	const size_t N = 5;
+	tictac.Tic();
+	for (size_t i = 0; i < N; i++)
+		matcher.computeDisparity(imgL.data(), imgR.data(), w, h, w, disp);
+
+	return tictac.Tac() / N;
+}
+
 // ------------------------------------------------------
 // register_tests_image
 // ------------------------------------------------------
@@ -428,6 +574,19 @@ void register_tests_image()
 			"images: Load JPG 800x600 shared mem", image_saveload<true>, 2, 1);
 	}
 
+	lstTests.emplace_back(
+		"images: Create+destroy RGB 640x480 (heap)", image_create_destroy, 640,
+		0);
+	lstTests.emplace_back(
+		"images: Create+destroy RGB 640x480 (CImageBufferPool)",
+		image_create_destroy, 640, 1);
+	lstTests.emplace_back(
+		"images: Create+destroy RGB 1920x1440 (heap)", image_create_destroy,
+		1920, 0);
+	lstTests.emplace_back(
+		"images: Create+destroy RGB 1920x1440 (CImageBufferPool)",
+		image_create_destroy, 1920, 1);
+
 	lstTests.emplace_back(
 		"images: Gauss filter (640x480)", image_test_2, 640, 480);
 	lstTests.emplace_back(
@@ -538,6 +697,23 @@ void register_tests_image()
 	lstTests.emplace_back(
 		"images: RGB->GRAY 8u (1280x1024)", image_rgb2gray_8u, 1280, 1024);
 
+	lstTests.emplace_back(
+		"images: Bayer->RGB bilinear (1280x960)", image_demosaic<CH_RGB>,
+		mrpt::img::DEMOSAIC_BILINEAR, 0);
+	lstTests.emplace_back(
+		"images: Bayer->RGB edge-aware (1280x960)", image_demosaic<CH_RGB>,
+		mrpt::img::DEMOSAIC_EDGE_AWARE, 0);
+	lstTests.emplace_back(
+		"images: Bayer->GRAY bilinear (1280x960)", image_demosaic<CH_GRAY>,
+		mrpt::img::DEMOSAIC_BILINEAR, 0);
+	lstTests.emplace_back(
+		"images: Bayer->GRAY half size (1280x960)", image_demosaic<CH_GRAY>,
+		mrpt::img::DEMOSAIC_HALF_SIZE, 0);
+	lstTests.emplace_back(
+		"images: UYVY->RGB (1280x960)", image_yuv422<CH_RGB>, 0, 0);
+	lstTests.emplace_back(
+		"images: UYVY->GRAY (1280x960)", image_yuv422<CH_GRAY>, 0, 0);
+
 	lstTests.emplace_back(
 		"images: KLT score (WIN=2 5x5)", image_KLTscore, 2, 1e7);
 	lstTests.emplace_back(
@@ -602,6 +778,16 @@ void register_tests_image()
 		"images: buildPyramid 640x480,4 levs,   smooth,gray",
 		image_buildPyramid<true, false, true>, 500, 4);
 
+	lstTests.emplace_back(
+		"images: buildPyramid 640x480,4 levs,Gaussian,rgb->gray",
+		image_buildPyramidGaussian<false, false>, 500, 4);
+	lstTests.emplace_back(
+		"images: buildPyramid 640x480,4 levs,Gaussian,rgb->gray,SIMD",
+		image_buildPyramidGaussian<false, true>, 500, 4);
+	lstTests.emplace_back(
+		"images: buildPyramid 640x480,4 levs,Gaussian,rgb->gray,SIMD,fused",
+		image_buildPyramidGaussian<true, true>, 500, 4);
+
 	lstTests.emplace_back(
 		"stereo: prepare rectify map 640x480 RGB",
 		stereoimage_rectify_prepare_map<CH_RGB, 640, 480, 640, 480>);
@@ -649,4 +835,30 @@ void register_tests_image()
 	lstTests.emplace_back(
 		"stereo: rectify 1024x768->640x480 GRAY",
 		stereoimage_rectify<CH_GRAY, 1024, 768, 640, 480>);
+
+	lstTests.emplace_back(
+		"stereo: rectify 1920x1080 RGB (1 thread)",
+		stereoimage_rectify_opts<1920, 1080, false, false, 1>);
+	lstTests.emplace_back(
+		"stereo: rectify 1920x1080 RGB (all threads)",
+		stereoimage_rectify_opts<1920, 1080, false, false, 0>);
+	lstTests.emplace_back(
+		"stereo: rectify+grayscale 1920x1080 RGB (all threads)",
+		stereoimage_rectify_opts<1920, 1080, true, false, 0>);
+	lstTests.emplace_back(
+		"stereo: rectify+grayscale+half 1920x1080 RGB (all threads)",
+		stereoimage_rectify_opts<1920, 1080, true, true, 0>);
+
+	lstTests.emplace_back(
+		"stereo: census BM disparity 640x480, 64 disp. (1 thread)",
+		stereo_disparity<false, 1>, 640, 480);
+	lstTests.emplace_back(
+		"stereo: census BM disparity 640x480, 64 disp. (all threads)",
+		stereo_disparity<false, 0>, 640, 480);
+	lstTests.emplace_back(
+		"stereo: census SGM disparity 640x480, 64 disp. (1 thread)",
+		stereo_disparity<true, 1>, 640, 480);
+	lstTests.emplace_back(
+		"stereo: census SGM disparity 640x480, 64 disp. (all threads)",
+		stereo_disparity<true, 0>, 640, 480);
 }
@@ -20,8 +20,12 @@
 #include <mrpt/obs/stock_observations.h>
 #include <mrpt/serialization/CArchive.h>
 #include <mrpt/serialization/stl_serialization.h>
+#include <mrpt/system/CPerfCounters.h>
 #include <mrpt/version.h>
 
+#include <optional>
+#include <regex>
+
 #include "common.h"
 
 using namespace mrpt;
@@ -54,6 +58,7 @@ void getTestImage(unsigned int img_index, mrpt::img::CImage& out_img)
 }
 
 #include "run_build_tables.h"
+#include "run_results_io.h"
 
 // ------------------------------------------------------
 //						MAIN
@@ -69,6 +74,39 @@ int main(int argc, char** argv)
 			"Run only the tests containing the given substring", false, "NAME",
 			"NAME", cmd);
 
+		TCLAP::ValueArg<std::string> arg_regex(
+			"e", "match-regex",
+			"Run only the tests whose name matches the given regular "
+			"expression (ECMAScript syntax, partial match)",
+			false, "REGEX", "REGEX", cmd);
+		TCLAP::ValueArg<std::string> arg_exclude_regex(
+			"x", "exclude-regex",
+			"Do not run tests whose name matches the given regular expression",
+			false, "REGEX", "REGEX", cmd);
+		TCLAP::ValueArg<unsigned int> arg_repetitions(
+			"n", "repetitions",
+			"Number of timed runs of each test. Reported time is the median",
+			false, 1, "N", cmd);
+		TCLAP::ValueArg<unsigned int> arg_warmup(
+			"", "warmup", "Number of untimed runs of each test before timing",
+			false, 0, "N", cmd);
+		TCLAP::ValueArg<std::string> arg_json(
+			"", "json", "Save results (in seconds) to a JSON file", false, "",
+			"results.json", cmd);
+		TCLAP::ValueArg<std::string> arg_csv(
+			"", "csv", "Save results (in seconds) to a CSV file", false, "",
+			"results.csv", cmd);
+		TCLAP::MultiArg<std::string> arg_compare(
+			"", "compare",
+			"Don't run any test, instead compare two result files (JSON or "
+			"CSV) given as `--compare BASE --compare NEW`, and exit with "
+			"code 1 if any test is slower than the threshold",
+			false, "FILE", cmd);
+		TCLAP::ValueArg<double> arg_threshold(
+			"", "threshold",
+			"Slowdown threshold for --compare, in percent (Default: 10)", false,
+			10.0, "PERCENT", cmd);
+
 		TCLAP::SwitchArg arg_build_tables(
 			"t", "tables",
 			"Don't run any test, instead build the tables of compared "
@@ -78,6 +116,12 @@ int main(int argc, char** argv)
 			"r", "release",
 			"Don't use the postfix 'dev' in the performance stats file", cmd,
 			false);
+		TCLAP::SwitchArg arg_perf_counters(
+			"", "perf-counters",
+			"Also measure hardware performance counters (IPC, cache and "
+			"branch miss rates) of each test. Linux only; ignored if "
+			"counters are not available",
+			cmd, false);
 
 		// Parse arguments:
 		if (!cmd.parse(argc, argv))
@@ -85,13 +129,47 @@ int main(int argc, char** argv)
 
 		if (arg_build_tables.isSet()) return run_build_tables();
 
+		if (arg_compare.isSet())
+		{
+			const auto& files = arg_compare.getValue();
+			if (files.size() != 2)
+				throw std::runtime_error(
+					"--compare must be given exactly twice: BASE and NEW "
+					"result files");
+			return run_compare_results(
+				files[0], files[1], arg_threshold.getValue());
+		}
+
 		const std::string filName = "./mrpt-performance.html";
 
 		std::string match_contains;
 		if (arg_contains.isSet())
 		{
-			cout << "Using match filter: " << match_contains << endl;
 			match_contains = arg_contains.getValue();
+			cout << "Using match filter: " << match_contains << endl;
+		}
+		std::optional<std::regex> match_regex, exclude_regex;
+		if (arg_regex.isSet())
+		{
+			match_regex.emplace(arg_regex.getValue());
+			cout << "Using regex filter: " << arg_regex.getValue() << endl;
+		}
+		if (arg_exclude_regex.isSet())
+			exclude_regex.emplace(arg_exclude_regex.getValue());
+
+		const unsigned int nRepetitions =
+			std::max(1U, arg_repetitions.getValue());
+		const unsigned int nWarmup = arg_warmup.getValue();
+		std::vector<TPerfResult> all_results;
+
+		bool usePerfCounters = arg_perf_counters.isSet();
+		if (usePerfCounters &&
+			!mrpt::system::CPerfCounters::ThreadInstance().available())
+		{
+			cerr << "Warning: hardware performance counters are not "
+					"available, ignoring --perf-counters."
+				 << endl;
+			usePerfCounters = false;
 		}
 
 		bool doLog = true;
@@ -142,6 +220,8 @@ int main(int argc, char** argv)
 		register_tests_strings();
 		register_tests_octomaps();
 		register_tests_yaml();
+		register_tests_nav();
+		register_tests_containers();
 
 		if (doLog)
 		{
@@ -159,13 +239,43 @@ int main(int argc, char** argv)
 			if (!match_contains.empty())
 				if (string::npos == string(it->name).find(match_contains))
 					continue;  // doesn't have the substring
+			if (match_regex && !std::regex_search(it->name, *match_regex))
+				continue;
+			if (exclude_regex && std::regex_search(it->name, *exclude_regex))
+				continue;
 
 			printf("%-60s", it->name);
 			cout.flush();
 
 			try
 			{
-				const double t = it->func(it->arg1, it->arg2);	// Run it.
+				for (unsigned int i = 0; i < nWarmup; i++)
+					it->func(it->arg1, it->arg2);
+
+				// Counters of the calling thread only, and including the
+				// (untimed) set-up code of each test:
+				mrpt::system::TPerfCounterValues counters;
+				if (usePerfCounters)
+					counters =
+						mrpt::system::CPerfCounters::ThreadInstance().read();
+
+				std::vector<double> times;
+				times.reserve(nRepetitions);
+				for (unsigned int i = 0; i < nRepetitions; i++)
+					times.push_back(it->func(it->arg1, it->arg2));	// Run it.
+
+				TPerfResult stats = computePerfStats(it->name, times);
+				if (usePerfCounters)
+				{
+					counters =
+						mrpt::system::CPerfCounters::ThreadInstance().read() -
+						counters;
+					stats.ipc = counters.ipc();
+					stats.cache_miss_rate = counters.cacheMissRate();
+					stats.branch_miss_rate = counters.branchMissRate();
+				}
+				all_results.push_back(stats);
+				const double t = stats.median;
 
 				mrpt::system::consoleColorAndStyle(
 					mrpt::system::ConsoleForegroundColor::GREEN);
@@ -174,6 +284,11 @@ int main(int argc, char** argv)
 
 				mrpt::system::consoleColorAndStyle(
 					mrpt::system::ConsoleForegroundColor::DEFAULT);
+				if (nRepetitions > 1)
+					cout << " (p10: " << mrpt::system::intervalFormat(stats.p10)
+						 << ", p90: " << mrpt::system::intervalFormat(stats.p90)
+						 << ")";
+				if (usePerfCounters) cout << " " << counters.asString();
 				cout << endl;
 
 				// Make list of all data:
@@ -232,6 +347,22 @@ int main(int argc, char** argv)
 			cout << endl << "Checkout the logfile: " << filName << endl;
 		}
 
+		// Machine-readable outputs:
+		if (arg_json.isSet())
+		{
+			if (!saveResultsJSON(arg_json.getValue(), all_results))
+				throw std::runtime_error(
+					"Error writing to: " + arg_json.getValue());
+			cout << "Saved JSON results to: " << arg_json.getValue() << endl;
+		}
+		if (arg_csv.isSet())
+		{
+			if (!saveResultsCSV(arg_csv.getValue(), all_results))
+				throw std::runtime_error(
+					"Error writing to: " + arg_csv.getValue());
+			cout << "Saved CSV results to: " << arg_csv.getValue() << endl;
+		}
+
 		// Save to perf-data dir?
 		if (HAVE_PERF_DATA_DIR)
 		{
@@ -8,6 +8,9 @@
    +------------------------------------------------------------------------+ */
 
 #include <mrpt/core/round.h>
+#include <mrpt/expr/CRuntimeCompiledExpression.h>
+#include <mrpt/math/TPoint3D.h>
+#include <mrpt/math/kmeans.h>
 #include <mrpt/random.h>
 
 #include "common.h"
@@ -53,6 +56,81 @@ double math_test_FUNC(int a1, int a2, FUNC func)
 	return t;
 }
 
+double math_test_expr(int a1, int a2)
+{
+	const char* formulas[] = {
+		"x^2 + x*y + 1 - 3*y/(1 + x*x)", "sin(x)*cos(y) + atan2(y, x)",
+		"if (x > y, x, y) * 2"};
+
+	double x = 0, y = 0;
+	mrpt::expr::CRuntimeCompiledExpression expr;
+	expr.register_symbol_table({{"x", &x}, {"y", &y}});
+	expr.compile(formulas[a1]);
+
+	const size_t N = 1000000;
+	std::vector<double> xs(N), ys(N), out(N);
+	getRandomGenerator().drawUniformVector(xs, -5.0, 5.0);
+	getRandomGenerator().drawUniformVector(ys, -5.0, 5.0);
+
+	CTicTac tictac;
+	if (a2)
+		expr.eval_batch({{"x", xs.data()}, {"y", ys.data()}}, out.data(), N);
+	else
+	{
+		for (size_t i = 0; i < N; i++)
+		{
+			x = xs[i];
+			y = ys[i];
+			out[i] = expr.eval();
+		}
+	}
+	double t = tictac.Tac() / N;
+	dummy_do_nothing_with_string(mrpt::format("%f", out[N / 2]));
+	return t;
+}
+
+// a1: number of points; a2: 0=kmeanspp(), 1=kmeans_parallel() 1 thread,
+// 2=kmeans_parallel() all threads, 3=mini-batch kmeans_parallel()
+double math_test_kmeans(int a1, int a2)
+{
+	const size_t N = a1, K = 20;
+	std::vector<TPoint3D> pts(N);
+	auto& rng = getRandomGenerator();
+	rng.randomize(123);
+	for (size_t i = 0; i < N; i++)
+	{
+		const double c = double(i % K);
+		pts[i] = TPoint3D(
+			c + rng.drawGaussian1D(0, 0.2), 2 * c + rng.drawGaussian1D(0, 0.2),
+			rng.drawGaussian1D(0, 0.2));
+	}
+	std::vector<int> assignments;
+	double cost;
+
+	CTicTac tictac;
+	if (a2 == 0)
+	{
+		std::vector<std::vector<double>> v(N);
+		for (size_t i = 0; i < N; i++)
+			v[i] = {pts[i].x, pts[i].y, pts[i].z};
+		tictac.Tic();
+		std::vector<std::vector<double>> centers;
+		cost = kmeanspp(K, v, assignments, &centers, 1);
+	}
+	else
+	{
+		TKMeansParallelOptions opts;
+		opts.attempts = 1;
+		opts.seed = 1;
+		opts.numThreads = (a2 == 1) ? 1 : 0;
+		if (a2 == 3) opts.miniBatchSize = 1024;
+		cost = kmeans_parallel(K, pts, assignments, nullptr, opts);
+	}
+	double t = tictac.Tac();
+	dummy_do_nothing_with_string(mrpt::format("%f", cost));
+	return t;
+}
+
 // ------------------------------------------------------
 // register_tests_math
 // ------------------------------------------------------
@@ -78,4 +156,35 @@ void register_tests_math()
 			return math_test_FUNC<double, decltype(mrpt::hypot_fast<double>)>(
 				arg1, arg2, mrpt::hypot_fast<double>);
 		});
+
+	lstTests.emplace_back(
+		"math: CRuntimeCompiledExpression arithmetic eval()", math_test_expr, 0,
+		0);
+	lstTests.emplace_back(
+		"math: CRuntimeCompiledExpression arithmetic eval_batch()",
+		math_test_expr, 0, 1);
+	lstTests.emplace_back(
+		"math: CRuntimeCompiledExpression trigonometric eval()",
+		math_test_expr, 1, 0);
+	lstTests.emplace_back(
+		"math: CRuntimeCompiledExpression trigonometric eval_batch()",
+		math_test_expr, 1, 1);
+	lstTests.emplace_back(
+		"math: CRuntimeCompiledExpression conditional eval()", math_test_expr,
+		2, 0);
+	lstTests.emplace_back(
+		"math: CRuntimeCompiledExpression conditional eval_batch()",
+		math_test_expr, 2, 1);
+
+	lstTests.emplace_back(
+		"math: kmeanspp() 100k points 3D, k=20", math_test_kmeans, 100000, 0);
+	lstTests.emplace_back(
+		"math: kmeans_parallel() 100k points 3D, k=20, 1 thread",
+		math_test_kmeans, 100000, 1);
+	lstTests.emplace_back(
+		"math: kmeans_parallel() 100k points 3D, k=20", math_test_kmeans,
+		100000, 2);
+	lstTests.emplace_back(
+		"math: kmeans_parallel() mini-batch 1M points 3D, k=20",
+		math_test_kmeans, 1000000, 3);
 }
@@ -9,6 +9,7 @@
 
 #include <mrpt/math/CMatrixDynamic.h>
 #include <mrpt/math/CMatrixFixed.h>
+#include <mrpt/math/ops_matrices.h>
 #include <mrpt/random.h>
 
 #include "common.h"
@@ -18,6 +19,9 @@ using namespace mrpt::math;
 using namespace mrpt::random;
 using namespace std;
 
+// Written from benchmarks, so their results are not optimized out:
+volatile double dummy_sink = 0;
+
 // ------------------------------------------------------
 // register_tests_matrices:
 //   The code for matrices is split in several files
@@ -87,20 +91,49 @@ double matrix_test_mult_dyn(int a1, int a2)
 template <typename T, size_t DIM1, size_t DIM2, size_t DIM3>
 double matrix_test_mult_fix(int a1, int a2)
 {
-	CMatrixFixed<T, DIM1, DIM2> A;
+	// Inline products with loop-invariant inputs may be optimized out, so
+	// operands change in each iteration and all results are used:
+	CMatrixFixed<T, DIM1, DIM2> A[16];
 	CMatrixFixed<T, DIM2, DIM3> B;
-	CMatrixFixed<T, DIM1, DIM3> C;
+	CMatrixFixed<T, DIM1, DIM3> C, acc;
 
-	getRandomGenerator().drawGaussian1DMatrix(A, T(0), T(1));
+	for (auto& a : A)
+		getRandomGenerator().drawGaussian1DMatrix(a, T(0), T(1));
 	getRandomGenerator().drawGaussian1DMatrix(B, T(0), T(1));
 
 	const long N = 10000;
 	CTicTac tictac;
 	for (long i = 0; i < N; i++)
 	{
-		C.matProductOf_AB(A, B);
+		C.matProductOf_AB(A[i % 16], B);
+		acc += C;
 	}
-	return tictac.Tac() / N;
+	const double t = tictac.Tac() / N;
+	dummy_sink = acc(0, 0);
+	return t;
+}
+
+template <typename T, size_t DIM1, size_t DIM2>
+double matrix_test_HCHt_fix(int a1, int a2)
+{
+	CMatrixFixed<T, DIM1, DIM2> H[16];
+	CMatrixFixed<T, DIM2, DIM2> C;
+	CMatrixFixed<T, DIM1, DIM1> R, acc;
+
+	for (auto& h : H)
+		getRandomGenerator().drawGaussian1DMatrix(h, T(0), T(1));
+	getRandomGenerator().drawGaussian1DMatrix(C, T(0), T(1));
+
+	const long N = 10000;
+	CTicTac tictac;
+	for (long i = 0; i < N; i++)
+	{
+		R = mrpt::math::multiply_HCHt(H[i % 16], C);
+		acc += R;
+	}
+	const double t = tictac.Tac() / N;
+	dummy_sink = acc(0, 0);
+	return t;
 }
 
 template <typename T, size_t DIM1>
@@ -130,6 +163,29 @@ double matrix_test_inv_fix(int a1, int a2)
 	return tictac.Tac() / N;
 }
 
+template <typename T, size_t DIM1>
+double matrix_test_inv_pd_fix(int a1, int a2)
+{
+	CMatrixFixed<T, DIM1, DIM1> A[16], A2, acc;
+	for (auto& a : A)
+	{
+		getRandomGenerator().drawGaussian1DMatrix(A2, T(0), T(1));
+		a.matProductOf_AAt(A2);
+		a += CMatrixFixed<T, DIM1, DIM1>::Identity();
+	}
+
+	const long N = 10000;
+	CTicTac tictac;
+	for (long i = 0; i < N; i++)
+	{
+		A2 = A[i % 16].inverse_LLt();
+		acc += A2;
+	}
+	const double t = tictac.Tac() / N;
+	dummy_sink = acc(0, 0);
+	return t;
+}
+
 template <typename T, size_t DIM1>
 double matrix_test_det_dyn(int a1, int a2)
 {
@@ -214,6 +270,21 @@ void register_tests_matrices1()
 	lstTests.emplace_back(
 		"matrix: multiply, dyn[double], 3x6 * 6x3",
 		matrix_test_mult_dyn<double, 3, 6, 3>);
+	lstTests.emplace_back(
+		"matrix: multiply, fix[double], 3x6 * 6x3",
+		matrix_test_mult_fix<double, 3, 6, 3>);
+	lstTests.emplace_back(
+		"matrix: multiply, dyn[double], 6x6 * 6x6",
+		matrix_test_mult_dyn<double, 6, 6, 6>);
+	lstTests.emplace_back(
+		"matrix: multiply, fix[double], 6x6 * 6x6",
+		matrix_test_mult_fix<double, 6, 6, 6>);
+	lstTests.emplace_back(
+		"matrix: multiply_HCHt, fix[double], 3x6 * 6x6 * 6x3",
+		matrix_test_HCHt_fix<double, 3, 6>);
+	lstTests.emplace_back(
+		"matrix: multiply_HCHt, fix[double], 6x6 * 6x6 * 6x6",
+		matrix_test_HCHt_fix<double, 6, 6>);
 	lstTests.emplace_back(
 		"matrix: multiply, dyn[float ], 10x40 * 40x10",
 		matrix_test_mult_dyn<float, 10, 40, 10>);
@@ -236,6 +307,12 @@ void register_tests_matrices1()
 	lstTests.emplace_back(
 		"matrix: inverse_LLt(), fix[double] 6x6",
 		matrix_test_inv_fix<double, 6>);
+	lstTests.emplace_back(
+		"matrix: inverse_LLt(), fix[double] 3x3 def. positive",
+		matrix_test_inv_pd_fix<double, 3>);
+	lstTests.emplace_back(
+		"matrix: inverse_LLt(), fix[double] 6x6 def. positive",
+		matrix_test_inv_pd_fix<double, 6>);
 	lstTests.emplace_back(
 		"matrix: inverse_LLt(), dyn[double] 20x20",
 		matrix_test_inv_dyn<double, 20>);
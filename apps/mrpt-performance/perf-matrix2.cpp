@@ -14,6 +14,7 @@
 #include <mrpt/random.h>
 
 #include <Eigen/Dense>
+#include <map>
 
 #include "common.h"
 
@@ -125,6 +126,115 @@ double matrix_test_chol_Nx6x6_sparse(int DIM, int a2)
 	return tictac.Tac() / N;
 }
 
+// Information matrices with the structure of those factorized by
+// optimize_graph_spa_levmarq() (a path of poses with loop closures, in blocks
+// of the pose dimension) and by ScalarFactorGraph (a GMRF grid with
+// smoothness factors between 4-neighbors), to compare the sparse Cholesky
+// backends (see CSparseMatrix::CholeskyDecomp::BackendName()):
+CSparseMatrix sparse_test_graphslam_matrix(int nNodes, int B)
+{
+	std::map<std::pair<int, int>, double> H;
+	auto lmbAddEdge = [&](int i, int j) {
+		const double w = getRandomGenerator().drawUniform(1.0, 2.0);
+		for (int k = 0; k < B; k++)
+			for (int l = 0; l < B; l++)
+			{
+				const double v = (k == l ? w : 0.1 * w);
+				H[{i * B + k, i * B + l}] += v;
+				H[{j * B + k, j * B + l}] += v;
+				H[{i * B + k, j * B + l}] -= v;
+				H[{j * B + k, i * B + l}] -= v;
+			}
+	};
+	for (int i = 1; i < nNodes; i++)
+	{
+		lmbAddEdge(i - 1, i);
+		// Revisit older places from time to time:
+		if (i % 10 == 0 && i >= 50) lmbAddEdge(i - 50 + (i % 7), i);
+	}
+	for (int k = 0; k < B; k++)
+		H[{k, k}] += 1.0;
+
+	CSparseMatrix SM(nNodes * B, nNodes * B);
+	for (const auto& [ij, v] : H)
+		SM.insert_entry(ij.first, ij.second, v);
+	SM.compressFromTriplet();
+	return SM;
+}
+
+CSparseMatrix sparse_test_gmrf_matrix(int nx, int ny)
+{
+	std::map<std::pair<int, int>, double> H;
+	auto lmbAddFactor = [&](int i, int j) {
+		H[{i, i}] += 1;
+		H[{j, j}] += 1;
+		H[{i, j}] -= 1;
+		H[{j, i}] -= 1;
+	};
+	for (int y = 0; y < ny; y++)
+		for (int x = 0; x < nx; x++)
+		{
+			const int i = x + y * nx;
+			H[{i, i}] += 0.01;	// observations, or a weak prior
+			if (x + 1 < nx) lmbAddFactor(i, i + 1);
+			if (y + 1 < ny) lmbAddFactor(i, i + nx);
+		}
+
+	CSparseMatrix SM(nx * ny, nx * ny);
+	for (const auto& [ij, v] : H)
+		SM.insert_entry(ij.first, ij.second, v);
+	SM.compressFromTriplet();
+	return SM;
+}
+
+double matrix_test_chol_sparse_matrix(const CSparseMatrix& SM, int nReps)
+{
+	const long N = nReps == 0 ? 10 : nReps;
+	CTicTac tictac;
+	for (long i = 0; i < N; i++)
+	{
+		CSparseMatrix::CholeskyDecomp CHOL(SM);
+	}
+	return tictac.Tac() / N;
+}
+
+double matrix_test_chol_update_sparse_matrix(const CSparseMatrix& SM, int nReps)
+{
+	CSparseMatrix::CholeskyDecomp CHOL(SM);
+
+	const long N = nReps == 0 ? 10 : nReps;
+	CTicTac tictac;
+	for (long i = 0; i < N; i++)
+		CHOL.update(SM);
+	return tictac.Tac() / N;
+}
+
+double matrix_test_chol_sparse_graphslam2D(int nNodes, int nReps)
+{
+	return matrix_test_chol_sparse_matrix(
+		sparse_test_graphslam_matrix(nNodes, 3), nReps);
+}
+double matrix_test_chol_sparse_graphslam3D(int nNodes, int nReps)
+{
+	return matrix_test_chol_sparse_matrix(
+		sparse_test_graphslam_matrix(nNodes, 6), nReps);
+}
+double matrix_test_chol_update_sparse_graphslam3D(int nNodes, int nReps)
+{
+	return matrix_test_chol_update_sparse_matrix(
+		sparse_test_graphslam_matrix(nNodes, 6), nReps);
+}
+double matrix_test_chol_sparse_gmrf(int side, int nReps)
+{
+	return matrix_test_chol_sparse_matrix(
+		sparse_test_gmrf_matrix(side, side), nReps);
+}
+double matrix_test_chol_update_sparse_gmrf(int side, int nReps)
+{
+	return matrix_test_chol_update_sparse_matrix(
+		sparse_test_gmrf_matrix(side, side), nReps);
+}
+
 double matrix_test_loadFromArray(int N, int a2)
 {
 	alignas(MRPT_MAX_STATIC_ALIGN_BYTES) double nums[4 * 4] = {
@@ -202,6 +312,25 @@ void register_tests_matrices2()
 		"matrix: chol, sparse      140x[6x6]", matrix_test_chol_Nx6x6_sparse,
 		140);
 
+	lstTests.emplace_back(
+		"matrix: chol, sparse graphslam(2d) 1000 KFs",
+		matrix_test_chol_sparse_graphslam2D, 1000);
+	lstTests.emplace_back(
+		"matrix: chol, sparse graphslam(3d) 1000 KFs",
+		matrix_test_chol_sparse_graphslam3D, 1000);
+	lstTests.emplace_back(
+		"matrix: chol update, sparse graphslam(3d) 1000 KFs",
+		matrix_test_chol_update_sparse_graphslam3D, 1000);
+	lstTests.emplace_back(
+		"matrix: chol, sparse GMRF 100x100", matrix_test_chol_sparse_gmrf,
+		100);
+	lstTests.emplace_back(
+		"matrix: chol, sparse GMRF 300x300", matrix_test_chol_sparse_gmrf, 300,
+		2);
+	lstTests.emplace_back(
+		"matrix: chol update, sparse GMRF 300x300",
+		matrix_test_chol_update_sparse_gmrf, 300, 2);
+
 	lstTests.emplace_back(
 		"matrix: loadFromArray[double] 4x4", matrix_test_loadFromArray, 1e7);
 	lstTests.emplace_back(
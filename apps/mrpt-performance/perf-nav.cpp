@@ -0,0 +1,194 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <mrpt/nav/holonomic/CHolonomicFullEval.h>
+#include <mrpt/nav/reactive/CMultiObjMotionOpt_Scalarization.h>
+#include <mrpt/nav/planners/TMoveTree.h>
+#include <mrpt/random.h>
+
+#include "common.h"
+
+using namespace mrpt::nav;
+using mrpt::math::TPose2D;
+
+// Builds a tree of random nodes, as grown by an RRT in a 20x20m area:
+static void buildRandomTree(TMoveTreeSE2_TP& tree, int nNodes)
+{
+	auto& rng = mrpt::random::getRandomGenerator();
+	rng.randomize(123);
+
+	tree.insertNode(0, TNodeSE2_TP(TPose2D(0, 0, 0)));
+	for (int i = 1; i < nNodes; i++)
+	{
+		const TPose2D p(
+			rng.drawUniform(-10.0, 10.0), rng.drawUniform(-10.0, 10.0),
+			rng.drawUniform(-M_PI, M_PI));
+		const auto parent = static_cast<mrpt::graphs::TNodeID>(
+			rng.drawUniform32bit() % i);
+		tree.insertNodeAndEdge(
+			parent, i, TNodeSE2_TP(p), TMoveEdgeSE2_TP(parent, p));
+	}
+}
+
+// Time per node insertion, for a tree of nNodes:
+double move_tree_insert(int nNodes, int)
+{
+	CTicTac tictac;
+	TMoveTreeSE2_TP tree;
+	buildRandomTree(tree, nNodes);
+	return tictac.Tac() / nNodes;
+}
+
+// Time per nearest node query, with or without the KD-tree:
+template <bool USE_KDTREE>
+double move_tree_nearest(int nNodes, int)
+{
+	TMoveTreeSE2_TP tree;
+	buildRandomTree(tree, nNodes);
+
+	auto& rng = mrpt::random::getRandomGenerator();
+	const PoseDistanceMetric<TNodeSE2> metric;
+	const int N = 1000;
+	std::vector<TNodeSE2> queries;
+	for (int i = 0; i < N; i++)
+		queries.emplace_back(TPose2D(
+			rng.drawUniform(-10.0, 10.0), rng.drawUniform(-10.0, 10.0),
+			rng.drawUniform(-M_PI, M_PI)));
+
+	size_t dummy = 0;
+	CTicTac tictac;
+	for (const auto& q : queries)
+	{
+		if constexpr (USE_KDTREE) dummy += tree.getNearestNode(q, metric);
+		else
+			dummy += tree.getNearestNodeBruteForce(q, metric);
+	}
+	const double t = tictac.Tac() / N;
+	if (dummy == 0) std::cout << "\n";
+	return t;
+}
+
+// Time per call to CHolonomicFullEval::navigate(), for nDirs directions
+// and a random, cluttered TP-Space:
+double holonomic_full_eval(int nDirs, int)
+{
+	auto& rng = mrpt::random::getRandomGenerator();
+	rng.randomize(123);
+
+	CHolonomicFullEval holo;
+	ClearanceDiagram clearance;
+	CAbstractHolonomicReactiveMethod::NavInput ni;
+	ni.clearance = &clearance;
+	ni.targets.emplace_back(0.6, 0.3);
+	ni.obstacles.resize(nDirs);
+	for (auto& o : ni.obstacles)
+		o = rng.drawUniform(0.0, 1.0) < 0.3 ? 1.0 : rng.drawUniform(0.2, 1.0);
+
+	CAbstractHolonomicReactiveMethod::NavOutput no;
+	const int N = 200;
+	CTicTac tictac;
+	for (int i = 0; i < N; i++)
+		holo.navigate(ni, no);
+	return tictac.Tac() / N;
+}
+
+// Time per call to CMultiObjMotionOpt_Scalarization::decide(), with scores
+// as in reactive2d_config.ini, for nCandidates motion candidates:
+double multiobj_scalarization(int nCandidates, int)
+{
+	auto& rng = mrpt::random::getRandomGenerator();
+	rng.randomize(123);
+
+	CMultiObjMotionOpt_Scalarization opt;
+	auto& p = opt.parameters;
+	p.formula_score.clear();
+	p.formula_score["col_free_dist_score"] = "collision_free_distance";
+	p.formula_score["path_index_near_target"] =
+		"var dif:=abs(target_k-move_k); if (dif>(num_paths/2)) { "
+		"dif:=num_paths-dif; }; exp(-abs(dif / (num_paths/10.0)));";
+	p.formula_score["euclidean_nearness"] =
+		"(ref_dist - dist_eucl_final) / ref_dist";
+	p.formula_score["hysteresis_score"] = "hysteresis";
+	p.formula_score["clearance_score"] = "clearance";
+	p.scores_to_normalize = {"clearance_score"};
+	p.scalar_score_formula =
+		"col_free_dist_score + path_index_near_target + euclidean_nearness + "
+		"hysteresis_score + 0.5 * clearance_score";
+
+	std::vector<TCandidateMovementPTG> movs(nCandidates);
+	for (auto& m : movs)
+	{
+		m.speed = 1.0;
+		m.props["collision_free_distance"] = rng.drawUniform(0.0, 1.0);
+		m.props["target_k"] = 30;
+		m.props["move_k"] = rng.drawUniform32bit() % 120;
+		m.props["num_paths"] = 120;
+		m.props["ref_dist"] = 5.0;
+		m.props["dist_eucl_final"] = rng.drawUniform(0.0, 5.0);
+		m.props["hysteresis"] = rng.drawUniform(0.0, 1.0);
+		m.props["clearance"] = rng.drawUniform(0.0, 2.0);
+	}
+
+	CMultiObjectiveMotionOptimizerBase::TResultInfo ri;
+	const int N = 200;
+	int dummy = 0;
+	CTicTac tictac;
+	for (int i = 0; i < N; i++)
+		dummy += opt.decide(movs, ri);
+	const double t = tictac.Tac() / N;
+	if (dummy == 0) std::cout << "\n";
+	return t;
+}
+
+// ------------------------------------------------------
+// register_tests_nav
+// ------------------------------------------------------
+void register_tests_nav()
+{
+	lstTests.emplace_back(
+		"nav: TMoveTree insert node (1e3 nodes)", move_tree_insert, 1000);
+	lstTests.emplace_back(
+		"nav: TMoveTree insert node (1e5 nodes)", move_tree_insert, 100000);
+
+	lstTests.emplace_back(
+		"nav: TMoveTree nearest node, KD-tree (1e3 nodes)",
+		move_tree_nearest<true>, 1000);
+	lstTests.emplace_back(
+		"nav: TMoveTree nearest node, linear (1e3 nodes)",
+		move_tree_nearest<false>, 1000);
+	lstTests.emplace_back(
+		"nav: TMoveTree nearest node, KD-tree (1e4 nodes)",
+		move_tree_nearest<true>, 10000);
+	lstTests.emplace_back(
+		"nav: TMoveTree nearest node, linear (1e4 nodes)",
+		move_tree_nearest<false>, 10000);
+	lstTests.emplace_back(
+		"nav: TMoveTree nearest node, KD-tree (1e5 nodes)",
+		move_tree_nearest<true>, 100000);
+	lstTests.emplace_back(
+		"nav: TMoveTree nearest node, linear (1e5 nodes)",
+		move_tree_nearest<false>, 100000);
+
+	lstTests.emplace_back(
+		"nav: CHolonomicFullEval::navigate (120 directions)",
+		holonomic_full_eval, 120);
+	lstTests.emplace_back(
+		"nav: CHolonomicFullEval::navigate (360 directions)",
+		holonomic_full_eval, 360);
+	lstTests.emplace_back(
+		"nav: CHolonomicFullEval::navigate (1000 directions)",
+		holonomic_full_eval, 1000);
+
+	lstTests.emplace_back(
+		"nav: CMultiObjMotionOpt_Scalarization::decide (10 candidates)",
+		multiobj_scalarization, 10);
+	lstTests.emplace_back(
+		"nav: CMultiObjMotionOpt_Scalarization::decide (100 candidates)",
+		multiobj_scalarization, 100);
+}
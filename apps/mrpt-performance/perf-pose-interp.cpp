@@ -86,6 +86,67 @@ double pose_interp_test(int a1, int a2)
 	}
 }
 
+// Queries at sorted times, as when deskewing a lidar scan, either one by one
+// or with the batch interpolate():
+template <typename PATH_T, bool UNIFORM, bool BATCH>
+double pose_interp_sorted_test(int a1, int a2)
+{
+	using pose_t = typename PATH_T::pose_t;
+	using namespace std::chrono_literals;
+	const long N = 20000, Q = 1000000;
+
+	const auto a = pose_t(
+		mrpt::poses::CPose3D(1.0, 2.0, 0, 10.0_deg, .0, .0).asTPose());
+
+	PATH_T pose_path;
+	const auto t0 = mrpt::Clock::now();
+	auto t = t0;
+	for (long i = 0; i < N; i++)
+	{
+		pose_path.insert(t, a);
+		if (UNIFORM) t += 10ms;
+		else
+		{
+			std::chrono::duration<double> randomDuration(
+				mrpt::random::getRandomGenerator().drawUniform(0.001, 0.019));
+			t += std::chrono::duration_cast<mrpt::Clock::duration>(
+				randomDuration);
+		}
+	}
+
+	std::vector<mrpt::Clock::time_point> ts(Q);
+	for (long i = 0; i < Q; i++)
+		ts[i] = t0 + (t - t0) * i / Q;
+
+	// Build the internal cache outside of the timed section:
+	pose_t p;
+	bool valid;
+	pose_path.interpolate(t0, p, valid);
+
+	mrpt::system::CTicTac tictac;
+	size_t nValid = 0;
+	if (BATCH)
+	{
+		std::vector<pose_t> poses;
+		tictac.Tic();
+		nValid = pose_path.interpolate(ts, poses);
+		p = poses.back();
+	}
+	else
+	{
+		tictac.Tic();
+		for (long i = 0; i < Q; i++)
+		{
+			pose_path.interpolate(ts[i], p, valid);
+			if (valid) nValid++;
+		}
+	}
+	const double T = tictac.Tac() / Q;
+	dummy_do_nothing_with_string(
+		mrpt::format("%s %u", p.asString().c_str(), (unsigned)nValid));
+	return T;
+}
+
 // ------------------------------------------------------
 // register_tests_pose_interp
 // ------------------------------------------------------
@@ -126,4 +187,20 @@ void register_tests_pose_interp()
 	lstTests.emplace_back(
 		"CPose2DInterpolator: TPose2D query",
 		&pose_interp_test<CPose2DInterpolator, TPose2D, true, false>);
+
+	lstTests.emplace_back(
+		"CPose3DInterpolator: TPose3D sorted queries, uniform rate",
+		&pose_interp_sorted_test<CPose3DInterpolator, true, false>);
+	lstTests.emplace_back(
+		"CPose3DInterpolator: TPose3D sorted queries, uniform rate, batch",
+		&pose_interp_sorted_test<CPose3DInterpolator, true, true>);
+	lstTests.emplace_back(
+		"CPose3DInterpolator: TPose3D sorted queries, random rate",
+		&pose_interp_sorted_test<CPose3DInterpolator, false, false>);
+	lstTests.emplace_back(
+		"CPose3DInterpolator: TPose3D sorted queries, random rate, batch",
+		&pose_interp_sorted_test<CPose3DInterpolator, false, true>);
+	lstTests.emplace_back(
+		"CPose2DInterpolator: TPose2D sorted queries, uniform rate, batch",
+		&pose_interp_sorted_test<CPose2DInterpolator, true, true>);
 }
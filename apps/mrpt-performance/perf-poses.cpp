@@ -13,6 +13,7 @@
 #include <mrpt/poses/CPose3DPDFGaussian.h>
 #include <mrpt/poses/CPose3DQuat.h>
 #include <mrpt/poses/CPose3DQuatPDFGaussian.h>
+#include <mrpt/poses/Lie/SE.h>
 #include <mrpt/random/RandomGenerators.h>
 
 #include <Eigen/Dense>	// for 6x8 fixed-matrices
@@ -431,6 +432,100 @@ double poses_test_convert_quat_ypr_pdf(int a1, int a2)
 	return T;
 }
 
+// Lie SE(3) ======================
+// a1: 0=single, on CPose3D objects; 1=batch, on manifold vectors
+namespace
+{
+std::vector<Lie::SE<3>::tangent_vector> randomTangentVectors(size_t N)
+{
+	std::vector<Lie::SE<3>::tangent_vector> xs(N);
+	for (auto& x : xs)
+		for (int k = 0; k < 6; k++)
+			x[k] = getRandomGenerator().drawUniform(-1.5, 1.5);
+	return xs;
+}
+}  // namespace
+
+double poses_test_SE3_exp(int a1, int a2)
+{
+	const long N = 100000;
+	const auto xs = randomTangentVectors(N);
+	std::vector<Lie::SE<3>::manifold_vector> Ps(N);  // outside of the timing
+	double s = 0;
+	CTicTac tictac;
+	if (a1 == 0)
+	{
+		for (long i = 0; i < N; i++)
+			s += Lie::SE<3>::exp(xs[i]).x();
+	}
+	else
+	{
+		Lie::SE<3>::exp(xs, Ps);
+		s = Ps.back()[9];
+	}
+	double T = tictac.Tac() / N;
+	dummy_do_nothing_with_string(mrpt::format("%f", s));
+	return T;
+}
+
+double poses_test_SE3_log(int a1, int a2)
+{
+	const long N = 100000;
+	const auto xs = randomTangentVectors(N);
+	std::vector<CPose3D> poses(N);
+	std::vector<Lie::SE<3>::manifold_vector> Ps(N);
+	for (long i = 0; i < N; i++)
+	{
+		poses[i] = Lie::SE<3>::exp(xs[i]);
+		Ps[i] = Lie::SE<3>::asManifoldVector(poses[i]);
+	}
+	std::vector<Lie::SE<3>::tangent_vector> logs(N);
+	double s = 0;
+	CTicTac tictac;
+	if (a1 == 0)
+	{
+		for (long i = 0; i < N; i++)
+			s += Lie::SE<3>::log(poses[i])[3];
+	}
+	else
+	{
+		Lie::SE<3>::log(Ps, logs);
+		s = logs.back()[3];
+	}
+	double T = tictac.Tac() / N;
+	dummy_do_nothing_with_string(mrpt::format("%f", s));
+	return T;
+}
+
+double poses_test_SE3_jacob_dlogv_dv(int a1, int a2)
+{
+	const long N = 100000;
+	const auto xs = randomTangentVectors(N);
+	std::vector<CPose3D> poses(N);
+	std::vector<Lie::SE<3>::manifold_vector> Ps(N);
+	for (long i = 0; i < N; i++)
+	{
+		poses[i] = Lie::SE<3>::exp(xs[i]);
+		Ps[i] = Lie::SE<3>::asManifoldVector(poses[i]);
+	}
+	std::vector<Lie::SE<3>::mat2tang_jacob> Js(N);
+	double s = 0;
+	CTicTac tictac;
+	if (a1 == 0)
+	{
+		for (long i = 0; i < N; i++)
+			s += Lie::SE<3>::jacob_dlogv_dv(poses[i])(3, 0);
+	}
+	else
+	{
+		Lie::SE<3>::jacob_dlogv_dv(Ps, Js);
+		s = Js.back()(3, 0);
+	}
+	double T = tictac.Tac() / N;
+	dummy_do_nothing_with_string(mrpt::format("%f", s));
+	return T;
+}
+
 // ------------------------------------------------------
 // register_tests_poses
 // ------------------------------------------------------
@@ -497,4 +592,18 @@ void register_tests_poses()
 	lstTests.emplace_back(
 		"poses: Conv CPose3D Gauss <- CPose3DQuat Gauss (SUT)",
 		poses_test_convert_ypr_quat_pdf, 1);
+
+	lstTests.emplace_back(
+		"poses: SE<3>::exp() -> CPose3D", poses_test_SE3_exp, 0);
+	lstTests.emplace_back(
+		"poses: SE<3>::exp() batch -> manifold", poses_test_SE3_exp, 1);
+	lstTests.emplace_back("poses: SE<3>::log(CPose3D)", poses_test_SE3_log, 0);
+	lstTests.emplace_back(
+		"poses: SE<3>::log() batch <- manifold", poses_test_SE3_log, 1);
+	lstTests.emplace_back(
+		"poses: SE<3>::jacob_dlogv_dv(CPose3D)",
+		poses_test_SE3_jacob_dlogv_dv, 0);
+	lstTests.emplace_back(
+		"poses: SE<3>::jacob_dlogv_dv() batch <- manifold",
+		poses_test_SE3_jacob_dlogv_dv, 1);
 }
@@ -12,6 +12,8 @@
 #include <mrpt/math/CVectorDynamic.h>
 #include <mrpt/random.h>
 
+#include <thread>
+
 #include "common.h"
 
 using namespace mrpt;
@@ -196,6 +198,99 @@ double random_test_10(int a1, int a2)
 	return tictac.Tac() / N;
 }
 
+template <class GENERATOR>
+double random_test_11(int a1, int a2)
+{
+	GENERATOR g(123);
+
+	// test 11: raw numbers of other generators
+	// ----------------------------------------
+	const long N = 100000000;
+	typename GENERATOR::result_type acc = 0;
+	CTicTac tictac;
+	for (long i = 0; i < N; i++)
+		acc ^= g();
+	const double t = tictac.Tac() / N;
+	if (acc == 1) std::cout << " ";	 // avoid the loop being optimized out
+	return t;
+}
+
+double random_test_12(int a1, int a2)
+{
+	CRandomGenerator rg;
+
+	// test 12: drawGaussian1DVector vs fillGaussian
+	// ----------------------------------------
+	const long N = 100;
+	std::vector<double> v(a1);
+	CTicTac tictac;
+	for (long i = 0; i < N; i++)
+	{
+		if (a2) rg.fillGaussian(v);
+		else
+			rg.drawGaussian1DVector(v);
+	}
+	return tictac.Tac() / (N * a1);
+}
+
+template <class GENERATOR>
+double random_test_13(int a1, int a2)
+{
+	GENERATOR g(123);
+
+	// test 13: fillGaussian with other generators
+	// ----------------------------------------
+	const long N = 100;
+	std::vector<float> v(a1);
+	CTicTac tictac;
+	for (long i = 0; i < N; i++)
+		mrpt::random::fillGaussian(g, v);
+	return tictac.Tac() / (N * a1);
+}
+
+template <size_t DIM>
+double random_test_14(int a1, int a2)
+{
+	Generator_Xoshiro256pp g(123);
+	CRandomGenerator rg;
+
+	CMatrixFixed<double, DIM, DIM> R;
+	rg.drawGaussian1DMatrix(R, 0.0, 1.0);
+
+	CMatrixFixed<double, DIM, DIM> COV;
+	COV.matProductOf_AAt(R);
+
+	const size_t NSAMPS = 1000;
+
+	// test 14: drawGaussianMultivariateMany with fillGaussian
+	// ----------------------------------------
+	const long N = 1000;
+	CTicTac tictac;
+	std::vector<CVectorDouble> res;
+	for (long i = 0; i < N; i++)
+		mrpt::random::drawGaussianMultivariateMany(g, res, NSAMPS, COV);
+	return tictac.Tac() / (N * NSAMPS);
+}
+
+double random_test_15(int a1, int a2)
+{
+	// test 15: one Philox4x32 stream per thread
+	// ----------------------------------------
+	const size_t nThreads = a1, nPerThread = 10000000;
+	std::vector<std::vector<float>> bufs(
+		nThreads, std::vector<float>(nPerThread));
+	CTicTac tictac;
+	std::vector<std::thread> threads;
+	for (size_t t = 0; t < nThreads; t++)
+		threads.emplace_back([&bufs, t]() {
+			Generator_Philox4x32 g(123, t);
+			mrpt::random::fillGaussian(g, bufs[t]);
+		});
+	for (auto& t : threads)
+		t.join();
+	return tictac.Tac() / (nThreads * nPerThread);
+}
+
 // ------------------------------------------------------
 // register_tests_random
 // ------------------------------------------------------
@@ -231,6 +326,34 @@ void register_tests_random()
 		"random: drawGaussianMultivariateMany(dyn 6x6, 1000)", random_test_9,
 		6);
 
+	lstTests.emplace_back(
+		"random: Generator_Xoshiro256pp (64bit)",
+		random_test_11<Generator_Xoshiro256pp>);
+	lstTests.emplace_back(
+		"random: Generator_Philox4x32", random_test_11<Generator_Philox4x32>);
+	lstTests.emplace_back(
+		"random: drawGaussian1DVector (len=1e5)", random_test_12, 100000, 0);
+	lstTests.emplace_back(
+		"random: fillGaussian MT19937 (len=1e5)", random_test_12, 100000, 1);
+	lstTests.emplace_back(
+		"random: fillGaussian Xoshiro256pp (float, len=1e5)",
+		random_test_13<Generator_Xoshiro256pp>, 100000);
+	lstTests.emplace_back(
+		"random: fillGaussian Philox4x32 (float, len=1e5)",
+		random_test_13<Generator_Philox4x32>, 100000);
+	lstTests.emplace_back(
+		"random: drawGaussianMultivariateMany(Xoshiro256pp, 3x3, 1000)",
+		random_test_14<3>);
+	lstTests.emplace_back(
+		"random: drawGaussianMultivariateMany(Xoshiro256pp, 6x6, 1000)",
+		random_test_14<6>);
+	lstTests.emplace_back(
+		"random: fillGaussian Philox4x32 streams (1 thread)", random_test_15,
+		1);
+	lstTests.emplace_back(
+		"random: fillGaussian Philox4x32 streams (4 threads)", random_test_15,
+		4);
+
 	lstTests.emplace_back("random: permuteVector (len=10)", random_test_10, 10);
 	lstTests.emplace_back(
 		"random: permuteVector (len=100)", random_test_10, 100);
@@ -9,6 +9,8 @@
 
 #include "common.h"
 //
+#include <mrpt/config/CConfigFileMemory.h>
+#include <mrpt/config/CConfigSectionBinder.h>
 #include <mrpt/containers/yaml.h>
 #include <mrpt/system/filesystem.h>
 
@@ -89,6 +91,23 @@ double yaml_FromFile(int, int)
 	return r;
 }
 
+double yaml_FromFile_noComments(int, int)
+{
+	if (!prepareYamlTestFile()) return 0;
+	mrpt::containers::YamlParseOptions po;
+	po.parseComments = false;
+	mrpt::system::CTimeLogger tl;
+	for (unsigned int i = 0; i < 10; i++)
+	{
+		tl.enter("t");
+		auto doc = mrpt::containers::yaml::FromFile(fil, po);
+		tl.leave("t");
+	}
+	double r = tl.getMeanTime("t");
+	tl.clear(true);	 // deep clear to silent dtor stats
+	return r;
+}
+
 double yaml_loadFromText(int, int)
 {
 	if (!prepareYamlTestFile()) return 0;
@@ -172,6 +191,54 @@ double yaml_iterate(int, int)
 	return r;
 }
 
+// An INI file with N keys in one section:
+static mrpt::config::CConfigFileMemory makeBigConfig(int N)
+{
+	std::string s = "[params]\n";
+	for (int i = 0; i < N; i++)
+		s += mrpt::format("param%04i = %f\n", i, i * 0.5);
+	return mrpt::config::CConfigFileMemory(s);
+}
+
+double config_read_double(int N, int)
+{
+	const auto cfg = makeBigConfig(N);
+	std::vector<double> vals(N);
+
+	mrpt::system::CTimeLogger tl;
+	for (unsigned int rep = 0; rep < 10; rep++)
+	{
+		tl.enter("t");
+		for (int i = 0; i < N; i++)
+			vals[i] = cfg.read_double(
+				"params", mrpt::format("param%04i", i), vals[i]);
+		tl.leave("t");
+	}
+	double r = tl.getMeanTime("t");
+	tl.clear(true);	 // deep clear to silent dtor stats
+	return r;
+}
+
+double config_sectionBinder(int N, int)
+{
+	const auto cfg = makeBigConfig(N);
+	std::vector<double> vals(N);
+
+	mrpt::system::CTimeLogger tl;
+	for (unsigned int rep = 0; rep < 10; rep++)
+	{
+		tl.enter("t");
+		mrpt::config::CConfigSectionBinder b;
+		for (int i = 0; i < N; i++)
+			b.bind(mrpt::format("param%04i", i), vals[i]);
+		b.load(cfg, "params");
+		tl.leave("t");
+	}
+	double r = tl.getMeanTime("t");
+	tl.clear(true);	 // deep clear to silent dtor stats
+	return r;
+}
+
 #ifdef RUN_YAMLCPP_COMPARISON
 double yaml_yamlcpp_FromFile(int, int)
 {
@@ -264,10 +331,16 @@ void register_tests_yaml()
 {
 	lstTests.emplace_back("yaml: loadFromFile() big file", &yaml_loadFromFile);
 	lstTests.emplace_back("yaml: FromFile() big file", &yaml_FromFile);
+	lstTests.emplace_back(
+		"yaml: FromFile() big file, no comments", &yaml_FromFile_noComments);
 	lstTests.emplace_back("yaml: loadFromText() small", &yaml_loadFromText);
 	lstTests.emplace_back("yaml: FromText() small", &yaml_FromText);
 	lstTests.emplace_back("yaml: query in a big doc", &yaml_query);
 	lstTests.emplace_back("yaml: iterate a big doc", &yaml_iterate);
+	lstTests.emplace_back(
+		"config: read_double() 1000 keys", &config_read_double, 1000);
+	lstTests.emplace_back(
+		"config: CConfigSectionBinder 1000 keys", &config_sectionBinder, 1000);
 
 #ifdef RUN_YAMLCPP_COMPARISON
 	lstTests.emplace_back(
@@ -0,0 +1,283 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <mrpt/containers/yaml.h>
+#include <mrpt/core/bits_math.h>
+#include <mrpt/core/format.h>
+#include <mrpt/system/datetime.h>
+#include <mrpt/system/filesystem.h>
+#include <mrpt/system/os.h>
+#include <mrpt/system/string_utils.h>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <numeric>
+
+/** Statistics of the repeated runs of one test. Times in seconds. */
+struct TPerfResult
+{
+	std::string name;
+	size_t repetitions = 0;
+	double median = 0, mean = 0, stddev = 0, min = 0, max = 0, p10 = 0,
+		   p90 = 0;
+	/** Hardware counter ratios over all repetitions (--perf-counters), or
+	 * NaN if not measured */
+	double ipc = std::numeric_limits<double>::quiet_NaN(),
+		   cache_miss_rate = std::numeric_limits<double>::quiet_NaN(),
+		   branch_miss_rate = std::numeric_limits<double>::quiet_NaN();
+};
+
+/** Linear-interpolated percentile `q` in [0,1] of a sorted vector */
+double sortedPercentile(const std::vector<double>& sorted, double q)
+{
+	ASSERT_(!sorted.empty());
+	const double pos = q * (sorted.size() - 1);
+	const size_t i0 = static_cast<size_t>(std::floor(pos));
+	const size_t i1 = std::min(i0 + 1, sorted.size() - 1);
+	const double frac = pos - i0;
+	return sorted[i0] * (1 - frac) + sorted[i1] * frac;
+}
+
+TPerfResult computePerfStats(
+	const std::string& name, std::vector<double> times)
+{
+	ASSERT_(!times.empty());
+	std::sort(times.begin(), times.end());
+
+	TPerfResult r;
+	r.name = name;
+	r.repetitions = times.size();
+	r.min = times.front();
+	r.max = times.back();
+	r.median = sortedPercentile(times, 0.5);
+	r.p10 = sortedPercentile(times, 0.1);
+	r.p90 = sortedPercentile(times, 0.9);
+	r.mean = std::accumulate(times.begin(), times.end(), 0.0) / times.size();
+	double sq = 0;
+	for (const double t : times)
+		sq += mrpt::square(t - r.mean);
+	r.stddev = times.size() > 1 ? std::sqrt(sq / (times.size() - 1)) : 0;
+	return r;
+}
+
+std::string escapeJSON(const std::string& s)
+{
+	std::string out;
+	for (const char c : s)
+	{
+		if (c == '"' || c == '\\') out += '\\';
+		out += c;
+	}
+	return out;
+}
+
+/** JSON number, or `null` if `v` is NaN */
+std::string numberOrNullJSON(double v)
+{
+	return std::isnan(v) ? std::string("null") : mrpt::format("%.6e", v);
+}
+
+bool saveResultsJSON(
+	const std::string& fileName, const std::vector<TPerfResult>& results)
+{
+	std::ofstream f(fileName);
+	if (!f.is_open()) return false;
+
+	f << "{\n";
+	f << "  \"mrpt_version\": \"" << escapeJSON(MRPT_getVersion()) << "\",\n";
+	f << "  \"date\": \""
+	  << mrpt::system::dateTimeLocalToString(mrpt::Clock::now()) << "\",\n";
+	f << "  \"tests\": [\n";
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		const auto& r = results[i];
+		f << mrpt::format(
+			"    {\"name\": \"%s\", \"repetitions\": %u, \"median\": %.9e, "
+			"\"mean\": %.9e, \"stddev\": %.9e, \"min\": %.9e, \"max\": %.9e, "
+			"\"p10\": %.9e, \"p90\": %.9e, \"ipc\": %s, "
+			"\"cache_miss_rate\": %s, \"branch_miss_rate\": %s}%s\n",
+			escapeJSON(r.name).c_str(), static_cast<unsigned>(r.repetitions),
+			r.median, r.mean, r.stddev, r.min, r.max, r.p10, r.p90,
+			numberOrNullJSON(r.ipc).c_str(),
+			numberOrNullJSON(r.cache_miss_rate).c_str(),
+			numberOrNullJSON(r.branch_miss_rate).c_str(),
+			i + 1 < results.size() ? "," : "");
+	}
+	f << "  ]\n}\n";
+	return true;
+}
+
+bool saveResultsCSV(
+	const std::string& fileName, const std::vector<TPerfResult>& results)
+{
+	std::ofstream f(fileName);
+	if (!f.is_open()) return false;
+
+	f << "name,repetitions,median,mean,stddev,min,max,p10,p90,ipc,"
+		 "cache_miss_rate,branch_miss_rate\n";
+	for (const auto& r : results)
+	{
+		std::string name;
+		for (const char c : r.name)
+		{
+			if (c == '"') name += '"';
+			name += c;
+		}
+		f << mrpt::format(
+			"\"%s\",%u,%.9e,%.9e,%.9e,%.9e,%.9e,%.9e,%.9e,%.6e,%.6e,%.6e\n",
+			name.c_str(), static_cast<unsigned>(r.repetitions), r.median,
+			r.mean, r.stddev, r.min, r.max, r.p10, r.p90, r.ipc,
+			r.cache_miss_rate, r.branch_miss_rate);
+	}
+	return true;
+}
+
+/** Loads a file saved with saveResultsCSV() (if its extension is "csv") or
+ * saveResultsJSON() (otherwise). */
+std::vector<TPerfResult> loadResults(const std::string& fileName)
+{
+	if (!mrpt::system::fileExists(fileName))
+		THROW_EXCEPTION_FMT("File not found: `%s`", fileName.c_str());
+
+	std::vector<TPerfResult> results;
+	if (mrpt::system::lowerCase(mrpt::system::extractFileExtension(
+			fileName)) == "csv")
+	{
+		std::ifstream f(fileName);
+		std::string line;
+		std::getline(f, line);	// header
+		while (std::getline(f, line))
+		{
+			if (line.empty() || line.front() != '"') continue;
+			// Quoted name, with "" as escaped quotes:
+			TPerfResult r;
+			size_t i = 1;
+			for (; i < line.size(); i++)
+			{
+				if (line[i] == '"')
+				{
+					if (i + 1 < line.size() && line[i + 1] == '"') i++;
+					else
+						break;
+				}
+				r.name += line[i];
+			}
+			std::vector<std::string> fields;
+			mrpt::system::tokenize(line.substr(i + 1), ",", fields);
+			// (The last 3 hardware counter fields are optional)
+			ASSERTMSG_(
+				fields.size() == 8 || fields.size() == 11,
+				mrpt::format("Malformed CSV line: `%s`", line.c_str()));
+			r.repetitions = std::stoul(fields[0]);
+			double* dst[] = {&r.median, &r.mean, &r.stddev, &r.min,
+							 &r.max,	&r.p10,	 &r.p90};
+			for (size_t k = 0; k < 7; k++)
+				*dst[k] = std::stod(fields[k + 1]);
+			if (fields.size() == 11)
+			{
+				r.ipc = std::stod(fields[8]);
+				r.cache_miss_rate = std::stod(fields[9]);
+				r.branch_miss_rate = std::stod(fields[10]);
+			}
+			results.push_back(r);
+		}
+	}
+	else
+	{
+		const auto doc = mrpt::containers::yaml::FromFile(fileName);
+		ASSERTMSG_(
+			doc.has("tests") && doc["tests"].isSequence(),
+			"JSON file has no `tests` array");
+		for (const auto& node : doc["tests"].asSequence())
+		{
+			const mrpt::containers::yaml t(node);
+			TPerfResult r;
+			r.name = t["name"].as<std::string>();
+			r.repetitions = t["repetitions"].as<int>();
+			r.median = t["median"].as<double>();
+			r.mean = t["mean"].as<double>();
+			r.stddev = t["stddev"].as<double>();
+			r.min = t["min"].as<double>();
+			r.max = t["max"].as<double>();
+			r.p10 = t["p10"].as<double>();
+			r.p90 = t["p90"].as<double>();
+			for (auto& [key, dst] :
+				 {std::make_pair("ipc", &r.ipc),
+				  std::make_pair("cache_miss_rate", &r.cache_miss_rate),
+				  std::make_pair("branch_miss_rate", &r.branch_miss_rate)})
+				if (t.has(key) && !t[key].isNullNode())
+					*dst = t[key].as<double>();
+			results.push_back(r);
+		}
+	}
+	return results;
+}
+
+// ------------------------------------------------------
+//                     run_compare_results
+// ------------------------------------------------------
+/** Compares the median times of the tests in two result files, and returns
+ * non-zero if any test in `newFile` is slower than in `baseFile` by more than
+ * `thresholdPercent`. */
+int run_compare_results(
+	const std::string& baseFile, const std::string& newFile,
+	double thresholdPercent)
+{
+	using namespace std;
+
+	const auto base = loadResults(baseFile);
+	const auto cur = loadResults(newFile);
+
+	map<string, const TPerfResult*> baseByName;
+	for (const auto& r : base)
+		baseByName[r.name] = &r;
+
+	cout << "Comparing: " << newFile << "\n"
+		 << "  against: " << baseFile << "\n"
+		 << "Threshold: " << thresholdPercent << "%\n\n";
+	printf(
+		"%-60s %12s %12s %9s\n", "Test", "Base median", "New median",
+		"Change");
+
+	size_t nSlower = 0, nFaster = 0, nCompared = 0;
+	for (const auto& r : cur)
+	{
+		const auto it = baseByName.find(r.name);
+		if (it == baseByName.end()) continue;
+		const TPerfResult& b = *it->second;
+		if (b.median <= 0) continue;
+		nCompared++;
+
+		const double change = 100.0 * (r.median - b.median) / b.median;
+		const bool slower = change > thresholdPercent;
+		const bool faster = change < -thresholdPercent;
+		if (slower) nSlower++;
+		if (faster) nFaster++;
+
+		printf(
+			"%-60s %12s %12s ", r.name.c_str(),
+			mrpt::system::intervalFormat(b.median).c_str(),
+			mrpt::system::intervalFormat(r.median).c_str());
+		if (slower || faster)
+			mrpt::system::consoleColorAndStyle(
+				slower ? mrpt::system::ConsoleForegroundColor::RED
+					   : mrpt::system::ConsoleForegroundColor::GREEN);
+		printf("%+8.1f%%", change);
+		mrpt::system::consoleColorAndStyle(
+			mrpt::system::ConsoleForegroundColor::DEFAULT);
+		printf("%s\n", slower ? "  SLOWER" : "");
+	}
+
+	cout << "\nCompared tests: " << nCompared << ", slower: " << nSlower
+		 << ", faster: " << nFaster << "\n";
+	return nSlower ? 1 : 0;
+}
@@ -0,0 +1,519 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+/*---------------------------------------------------------------
+	APPLICATION: mrpt-replay-benchmark
+	FILE: mrpt-replay-benchmark_main.cpp
+
+	End-to-end benchmark of the SLAM and localization applications in
+	mrpt::apps: replays the sample datasets in share/mrpt/datasets through
+	each app as fast as possible (no GUI, no log files), and reports the
+	latency of each step (percentiles), the peak resident memory and the
+	accuracy with respect to a ground truth (or a reference solution), as
+	JSON or CSV.
+ ---------------------------------------------------------------*/
+
+#include <mrpt/3rdparty/tclap/CmdLine.h>
+#include <mrpt/apps/ICP_SLAM_App.h>
+#include <mrpt/apps/KFSLAMApp.h>
+#include <mrpt/apps/MonteCarloLocalization_App.h>
+#include <mrpt/apps/RBPF_SLAM_App.h>
+#include <mrpt/core/bits_math.h>
+#include <mrpt/core/format.h>
+#include <mrpt/math/CMatrixDynamic.h>
+#include <mrpt/poses/CPose3D.h>
+#include <mrpt/poses/Lie/SE.h>
+#include <mrpt/system/CTicTac.h>
+#include <mrpt/system/datetime.h>
+#include <mrpt/system/filesystem.h>
+#include <mrpt/system/memory.h>
+#include <mrpt/system/os.h>
+#include <mrpt/version.h>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <sys/resource.h>
+#endif
+
+using namespace std::string_literals;
+
+namespace
+{
+constexpr double NaN = std::numeric_limits<double>::quiet_NaN();
+
+/** Results of replaying one dataset through one app. Times in seconds. */
+struct TReplayResult
+{
+	std::string name, app;
+	size_t steps = 0;
+	double total_time = 0;
+	/** Per-step latency statistics */
+	double mean = 0, p50 = 0, p90 = 0, p99 = 0, max = 0;
+	/** Peak resident set size (bytes) while running this case */
+	uint64_t peak_rss = 0;
+	/** Error (SE(3) log norm) of the last estimated pose wrt the reference */
+	double final_pose_error = NaN;
+	/** RMSE of the estimated positions (meters) wrt a ground truth path */
+	double path_rmse = NaN;
+	/** Mean error of the estimated landmarks (meters) wrt the ground truth */
+	double landmark_error = NaN;
+};
+
+/** The output of one run of an app */
+struct TRunOutput
+{
+	std::vector<double> stepTimes;
+	std::vector<mrpt::math::TPose3D> path;
+	double landmarkError = NaN;
+};
+
+struct TReplayCase
+{
+	std::string name;
+	std::string app;
+	/** Runs the app once. Arguments: share dir, temporary output dir */
+	std::function<TRunOutput(const std::string&, const std::string&)> run;
+	/** The expected last pose of the path, if known */
+	std::optional<mrpt::math::TPose3D> finalPose;
+	/** A ground truth file of the robot path (one row "x y z yaw pitch roll"
+	 * per step), relative to the share dir */
+	std::string groundTruthPath;
+};
+
+/** Linear-interpolated percentile `q` in [0,1] of a sorted vector */
+double sortedPercentile(const std::vector<double>& sorted, double q)
+{
+	if (sorted.empty()) return NaN;
+	const double pos = q * (sorted.size() - 1);
+	const size_t i0 = static_cast<size_t>(std::floor(pos));
+	const size_t i1 = std::min(i0 + 1, sorted.size() - 1);
+	const double frac = pos - i0;
+	return sorted[i0] * (1 - frac) + sorted[i1] * frac;
+}
+
+// Peak resident memory. In Linux, the peak (VmHWM) can be reset between
+// cases, so it is measured for each one; elsewhere, it is that of the whole
+// process so far.
+void resetPeakRSS()
+{
+#if defined(__linux__)
+	std::ofstream f("/proc/self/clear_refs");
+	if (f.is_open()) f << "5";
+#endif
+}
+
+uint64_t peakRSS()
+{
+#if defined(__linux__)
+	std::ifstream f("/proc/self/status");
+	std::string line;
+	while (std::getline(f, line))
+		if (line.compare(0, 6, "VmHWM:") == 0)
+			return std::stoull(line.substr(6)) * 1024;
+#endif
+#if defined(_WIN32)
+	return mrpt::system::getMemoryUsage();
+#else
+	struct rusage ru;
+	if (getrusage(RUSAGE_SELF, &ru) != 0) return 0;
+#if defined(__APPLE__)
+	return static_cast<uint64_t>(ru.ru_maxrss);
+#else
+	return static_cast<uint64_t>(ru.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+template <class MAP>
+std::vector<mrpt::math::TPose3D> pathValues(const MAP& m)
+{
+	std::vector<mrpt::math::TPose3D> path;
+	for (const auto& kv : m)
+		path.push_back(kv.second);
+	return path;
+}
+
+// Common settings to run an app without GUI nor output files:
+template <class APP>
+void initApp(
+	APP& app, const char* appName, const std::string& ini,
+	const std::string& rawlog, const std::string& outDir)
+{
+	app.setMinLoggingLevel(mrpt::system::LVL_ERROR);
+	const char* argv[] = {appName, ini.c_str(), rawlog.c_str()};
+	app.initialize(sizeof(argv) / sizeof(argv[0]), argv);
+	app.params.write("MappingApplication", "logOutput_dir", outDir);
+	app.params.write("MappingApplication", "SHOW_PROGRESS_3D_REAL_TIME", false);
+	app.params.write("MappingApplication", "SHOW_PROGRESS_IN_WINDOW", false);
+	app.params.write("MappingApplication", "SAVE_3D_SCENE", false);
+	app.params.write("MappingApplication", "SAVE_MAP_IMAGES", false);
+	app.params.write("MappingApplication", "LOG_FREQUENCY", 0);
+}
+
+template <class APP>
+TReplayCase slamCase(
+	const std::string& name, const std::string& appName,
+	const std::string& ini, const std::string& rawlog,
+	const std::string& finalPose)
+{
+	TReplayCase c;
+	c.name = name;
+	c.app = appName;
+	c.finalPose = mrpt::math::TPose3D::FromString(finalPose);
+	c.run = [=](const std::string& share, const std::string& outDir) {
+		APP app;
+		initApp(
+			app, appName.c_str(),
+			share + "/config_files/"s + appName + "/"s + ini,
+			share + "/datasets/"s + rawlog, outDir);
+		app.quits_with_esc_key = false;
+		app.run();
+
+		TRunOutput o;
+		o.stepTimes = app.out_step_exec_times;
+		o.path = pathValues(app.out_estimated_path);
+		return o;
+	};
+	return c;
+}
+
+TReplayCase kfCase(
+	const std::string& name, const std::string& ini,
+	const std::string& rawlog, const std::string& gtPrefix)
+{
+	TReplayCase c;
+	c.name = name;
+	c.app = "kf-slam";
+	c.groundTruthPath =
+		"/datasets/"s + gtPrefix + "_ground_truth_robot_path.txt";
+	c.run = [=](const std::string& share, const std::string& outDir) {
+		mrpt::apps::KFSLAMApp app;
+		initApp(
+			app, "kf-slam", share + "/config_files/kf-slam/"s + ini,
+			share + "/datasets/"s + rawlog, outDir);
+		app.params.write("MappingApplication", "SHOW_3D_LIVE", false);
+		app.params.write("MappingApplication", "SAVE_3D_SCENES", false);
+		app.params.write("MappingApplication", "SAVE_LOG_FREQUENCY", 1000000);
+		app.params.write(
+			"MappingApplication", "ground_truth_file",
+			share + "/datasets/"s + gtPrefix + "_ground_truth.txt"s);
+		app.loc_error_wrt_gt = NaN;
+		app.run();
+
+		TRunOutput o;
+		o.stepTimes = app.out_step_exec_times;
+		o.path = app.out_estimated_path;
+		o.landmarkError = app.loc_error_wrt_gt;
+		return o;
+	};
+	return c;
+}
+
+TReplayCase mclCase(
+	const std::string& name, const std::string& ini,
+	const std::string& rawlog, const std::string& map, bool use3D,
+	const std::string& finalPose)
+{
+	using MCL = mrpt::apps::MonteCarloLocalization_Rawlog;
+
+	TReplayCase c;
+	c.name = name;
+	c.app = "pf-localization";
+	c.finalPose = mrpt::math::TPose3D::FromString(finalPose);
+	c.run = [=](const std::string& share, const std::string& outDir) {
+		MCL app;
+		app.setMinLoggingLevel(mrpt::system::LVL_ERROR);
+		const auto iniFile = share + "/config_files/pf-localization/"s + ini;
+		const auto rawlogFile = share + "/datasets/"s + rawlog;
+		const char* argv[] = {
+			"pf-localization", iniFile.c_str(), rawlogFile.c_str()};
+		app.initialize(sizeof(argv) / sizeof(argv[0]), argv);
+		app.params.write(MCL::sect, "logOutput_dir", outDir);
+		app.params.write(MCL::sect, "SHOW_PROGRESS_3D_REAL_TIME", false);
+		app.params.write(MCL::sect, "3DSceneFrequency", -1);
+		app.params.write(MCL::sect, "LOG_FREQUENCY", 0);
+		app.params.write(MCL::sect, "experimentRepetitions", 1);
+		app.params.write(MCL::sect, "use_3D_poses", use3D);
+		app.params.write(MCL::sect, "map_file", share + "/datasets/"s + map);
+		app.fill_out_estimated_path = true;
+		app.allow_quit_on_esc_key = false;
+		app.run();
+
+		TRunOutput o;
+		o.stepTimes = app.out_step_exec_times;
+		for (const auto& kv : app.out_estimated_path)
+			o.path.push_back(kv.second);
+		return o;
+	};
+	return c;
+}
+
+// The reference final poses are those checked by the unit tests of each app
+// (libs/apps/src/*_unittest.cpp), for datasets without a ground truth path.
+std::vector<TReplayCase> allCases()
+{
+	const std::string telecom =
+		"2006-01ENE-21-SENA_Telecom Faculty_one_loop_only.rawlog";
+	const std::string telecomFinal = "[3.4548 -18.0399 0 -86.48 0 0]";
+
+	std::vector<TReplayCase> cases;
+	cases.push_back(slamCase<mrpt::apps::ICP_SLAM_App_Rawlog>(
+		"icp-slam/pointmap", "icp-slam", "icp-slam_demo_classic.ini",
+		telecom, telecomFinal));
+	cases.push_back(slamCase<mrpt::apps::ICP_SLAM_App_Rawlog>(
+		"icp-slam/gridmap", "icp-slam", "icp-slam_demo_classic_gridmatch.ini",
+		telecom, telecomFinal));
+	cases.push_back(slamCase<mrpt::apps::RBPF_SLAM_App_Rawlog>(
+		"rbpf-slam/optimal_sampling", "rbpf-slam",
+		"gridmapping_optimal_sampling.ini", telecom, telecomFinal));
+	cases.push_back(slamCase<mrpt::apps::RBPF_SLAM_App_Rawlog>(
+		"rbpf-slam/ro-slam_MC", "rbpf-slam", "RO-SLAM_simulatedData_MC.ini",
+		"RO-SLAM_demo.rawlog",
+		"[1.938686 3.352273 0.000000 114.993417 0.000000 0.000000]"));
+	cases.push_back(mclCase(
+		"pf-localization/2D", "localization_demo.ini",
+		"localization_demo.rawlog", "localization_demo.simplemap.gz", false,
+		"[15.89 -10.0 0 4.8 0 0]"));
+	cases.push_back(mclCase(
+		"pf-localization/3D", "localization_demo.ini",
+		"localization_demo.rawlog", "localization_demo.simplemap.gz", true,
+		"[15.89 -10.0 0 4.8 0 0]"));
+	cases.push_back(kfCase(
+		"kf-slam/2D", "EKF-SLAM_test_2d.ini", "kf-slam_demo.rawlog",
+		"kf-slam_demo"));
+	cases.push_back(kfCase(
+		"kf-slam/6D", "EKF-SLAM_6D_test.ini", "kf-slam_6D_demo.rawlog",
+		"kf-slam_6D_demo"));
+	return cases;
+}
+
+double pathRMSE(
+	const std::vector<mrpt::math::TPose3D>& path, const std::string& gtFile)
+{
+	mrpt::math::CMatrixDouble gt;
+	gt.loadFromTextFile(gtFile);
+	const size_t n = std::min<size_t>(gt.rows(), path.size());
+	if (n == 0 || gt.cols() < 2) return NaN;
+	double sq = 0;
+	for (size_t i = 0; i < n; i++)
+	{
+		const double z = gt.cols() == 6 ? gt(i, 2) : 0;
+		sq += mrpt::square(path[i].x - gt(i, 0)) +
+			mrpt::square(path[i].y - gt(i, 1)) + mrpt::square(path[i].z - z);
+	}
+	return std::sqrt(sq / n);
+}
+
+TReplayResult runCase(
+	const TReplayCase& c, const std::string& shareDir, unsigned nRepetitions)
+{
+	TReplayResult r;
+	r.name = c.name;
+	r.app = c.app;
+
+	const auto outDir = mrpt::system::getTempFileName() + "_dir"s;
+	std::vector<double> times;
+	TRunOutput out;
+
+	resetPeakRSS();
+	mrpt::system::CTicTac tictac;
+	for (unsigned rep = 0; rep < nRepetitions; rep++)
+	{
+		tictac.Tic();
+		out = c.run(shareDir, outDir);
+		r.total_time += tictac.Tac();
+		times.insert(times.end(), out.stepTimes.begin(), out.stepTimes.end());
+	}
+	r.peak_rss = peakRSS();
+	mrpt::system::deleteFilesInDirectory(outDir, true);
+
+	r.total_time /= nRepetitions;
+	r.steps = out.stepTimes.size();
+	std::sort(times.begin(), times.end());
+	r.mean = times.empty()
+		? NaN
+		: std::accumulate(times.begin(), times.end(), 0.0) / times.size();
+	r.p50 = sortedPercentile(times, 0.5);
+	r.p90 = sortedPercentile(times, 0.9);
+	r.p99 = sortedPercentile(times, 0.99);
+	r.max = times.empty() ? NaN : times.back();
+
+	if (c.finalPose && !out.path.empty())
+	{
+		const auto err = mrpt::poses::CPose3D(out.path.back()) -
+			mrpt::poses::CPose3D(*c.finalPose);
+		r.final_pose_error = mrpt::poses::Lie::SE<3>::log(err).norm();
+	}
+	if (!c.groundTruthPath.empty())
+		r.path_rmse = pathRMSE(out.path, shareDir + c.groundTruthPath);
+	r.landmark_error = out.landmarkError;
+	return r;
+}
+
+std::string jsonNumber(double v)
+{
+	return std::isfinite(v) ? mrpt::format("%.9e", v) : "null"s;
+}
+
+void writeJSON(std::ostream& f, const std::vector<TReplayResult>& results)
+{
+	f << "{\n";
+	f << "  \"mrpt_version\": \"" << mrpt::system::MRPT_getVersion() << "\",\n";
+	f << "  \"date\": \""
+	  << mrpt::system::dateTimeLocalToString(mrpt::Clock::now()) << "\",\n";
+	f << "  \"cases\": [\n";
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		const auto& r = results[i];
+		f << mrpt::format(
+			"    {\"name\": \"%s\", \"app\": \"%s\", \"steps\": %u, "
+			"\"total_time\": %s, \"step_mean\": %s, \"step_p50\": %s, "
+			"\"step_p90\": %s, \"step_p99\": %s, \"step_max\": %s, "
+			"\"peak_rss_bytes\": %llu, \"final_pose_error\": %s, "
+			"\"path_rmse\": %s, \"landmark_error\": %s}%s\n",
+			r.name.c_str(), r.app.c_str(), static_cast<unsigned>(r.steps),
+			jsonNumber(r.total_time).c_str(), jsonNumber(r.mean).c_str(),
+			jsonNumber(r.p50).c_str(), jsonNumber(r.p90).c_str(),
+			jsonNumber(r.p99).c_str(), jsonNumber(r.max).c_str(),
+			static_cast<unsigned long long>(r.peak_rss),
+			jsonNumber(r.final_pose_error).c_str(),
+			jsonNumber(r.path_rmse).c_str(),
+			jsonNumber(r.landmark_error).c_str(),
+			i + 1 < results.size() ? "," : "");
+	}
+	f << "  ]\n}\n";
+}
+
+void writeCSV(std::ostream& f, const std::vector<TReplayResult>& results)
+{
+	f << "name,app,steps,total_time,step_mean,step_p50,step_p90,step_p99,"
+		 "step_max,peak_rss_bytes,final_pose_error,path_rmse,landmark_error\n";
+	for (const auto& r : results)
+	{
+		// NaN (no ground truth) are written as empty fields:
+		auto num = [](double v) {
+			return std::isfinite(v) ? mrpt::format("%.9e", v) : ""s;
+		};
+		f << r.name << "," << r.app << "," << r.steps << ","
+		  << num(r.total_time) << "," << num(r.mean) << "," << num(r.p50)
+		  << "," << num(r.p90) << "," << num(r.p99) << "," << num(r.max)
+		  << "," << r.peak_rss << "," << num(r.final_pose_error) << ","
+		  << num(r.path_rmse) << "," << num(r.landmark_error) << "\n";
+	}
+}
+
+}  // namespace
+
+// ------------------------------------------------------
+//						MAIN
+// ------------------------------------------------------
+int main(int argc, char** argv)
+{
+	try
+	{
+		TCLAP::CmdLine cmd(
+			"mrpt-replay-benchmark", ' ',
+			mrpt::system::MRPT_getVersion().c_str());
+
+		TCLAP::ValueArg<std::string> arg_regex(
+			"e", "match-regex",
+			"Run only the cases whose name matches the given regular "
+			"expression (ECMAScript syntax, partial match)",
+			false, "REGEX", "REGEX", cmd);
+		TCLAP::ValueArg<unsigned int> arg_repetitions(
+			"n", "repetitions",
+			"Number of runs of each case. Step latencies of all runs are "
+			"pooled; accuracy is that of the last run",
+			false, 1, "N", cmd);
+		TCLAP::ValueArg<std::string> arg_share(
+			"", "share-dir",
+			"MRPT `share/mrpt` directory, with the `datasets` and "
+			"`config_files` subdirectories",
+			false, MRPT_SHARE_DIR, "DIR", cmd);
+		TCLAP::ValueArg<std::string> arg_json(
+			"", "json", "Save results (in seconds and bytes) to a JSON file",
+			false, "", "results.json", cmd);
+		TCLAP::ValueArg<std::string> arg_csv(
+			"", "csv", "Save results (in seconds and bytes) to a CSV file",
+			false, "", "results.csv", cmd);
+		TCLAP::SwitchArg arg_list(
+			"l", "list", "List the names of all cases and exit", cmd, false);
+
+		// Parse arguments:
+		if (!cmd.parse(argc, argv))
+			throw std::runtime_error("");  // should exit.
+
+		const auto cases = allCases();
+		if (arg_list.isSet())
+		{
+			for (const auto& c : cases)
+				std::cout << c.name << "\n";
+			return 0;
+		}
+
+		std::optional<std::regex> match_regex;
+		if (arg_regex.isSet()) match_regex.emplace(arg_regex.getValue());
+
+		const std::string shareDir = arg_share.getValue();
+		ASSERT_DIRECTORY_EXISTS_(shareDir + "/datasets"s);
+
+		const unsigned nRepetitions = std::max(1U, arg_repetitions.getValue());
+
+		std::vector<TReplayResult> results;
+		for (const auto& c : cases)
+		{
+			if (match_regex && !std::regex_search(c.name, *match_regex))
+				continue;
+
+			std::cerr << "Running " << c.name << "..." << std::endl;
+			const auto r = runCase(c, shareDir, nRepetitions);
+			std::cerr << mrpt::format(
+				"  %u steps, p50=%.03f ms p99=%.03f ms, peak RSS=%.01f MB\n",
+				static_cast<unsigned>(r.steps), 1e3 * r.p50, 1e3 * r.p99,
+				r.peak_rss / (1024.0 * 1024.0));
+			results.push_back(r);
+		}
+
+		if (arg_json.isSet())
+		{
+			std::ofstream f(arg_json.getValue());
+			ASSERTMSG_(
+				f.is_open(), "Error writing to: "s + arg_json.getValue());
+			writeJSON(f, results);
+		}
+		if (arg_csv.isSet())
+		{
+			std::ofstream f(arg_csv.getValue());
+			ASSERTMSG_(
+				f.is_open(), "Error writing to: "s + arg_csv.getValue());
+			writeCSV(f, results);
+		}
+		if (!arg_json.isSet() && !arg_csv.isSet())
+			writeJSON(std::cout, results);
+
+		return 0;
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << mrpt::exception_to_str(e);
+		return -1;
+	}
+}
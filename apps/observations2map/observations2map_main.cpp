@@ -24,6 +24,8 @@
 #include <mrpt/serialization/CArchive.h>
 #include <mrpt/system/os.h>
 
+#include <cstdlib>
+
 using namespace mrpt;
 using namespace mrpt::maps;
 using namespace mrpt::opengl;
@@ -51,15 +53,50 @@ int main(int argc, char** argv)
 			"-\n");
 
 		// Process arguments:
-		if ((argc != 4 && argc != 6) ||
-			(argc == 6 && 0 != mrpt::system::os::_strcmp(argv[4], "-s")))
+		int numThreads = -1;  // -1: as given in the config file
+		double tileSize = 50.0, voxelSize = 0;
+		double framesMemoryMB = 1024;
+		bool argsOk = argc >= 4;
+		for (int i = 4; argsOk && i < argc; i += 2)
+		{
+			if (i + 1 >= argc)
+			{
+				argsOk = false;
+				break;
+			}
+			const std::string arg = argv[i];
+			if (arg == "-s") METRIC_MAP_CONFIG_SECTION = string(argv[i + 1]);
+			else if (arg == "--threads")
+				numThreads = std::atoi(argv[i + 1]);
+			else if (arg == "--tile-size")
+				tileSize = std::atof(argv[i + 1]);
+			else if (arg == "--voxel-size")
+				voxelSize = std::atof(argv[i + 1]);
+			else if (arg == "--frames-memory")
+				framesMemoryMB = std::atof(argv[i + 1]);
+			else
+				argsOk = false;
+		}
+		if (!argsOk || tileSize <= 0)
 		{
 			cout << "Use: observations2map <config_file.ini> "
 					"<observations.simplemap> <outputmap_prefix> [-s "
-					"INI_FILE_SECTION_NAME] "
+					"INI_FILE_SECTION_NAME] [--threads N] [--tile-size M] "
+					"[--voxel-size M] [--frames-memory MB]"
 				 << endl;
 			cout << "  Default: INI_FILE_SECTION_NAME = MappingApplication"
 				 << endl;
+			cout << "  --threads N: Build maps in parallel, in tiles of "
+					"--tile-size meters (default: 50). 0: all cores. "
+					"Default: numThreads from the config file, or 1"
+				 << endl;
+			cout << "  --voxel-size M: Decimate merged points maps with a "
+					"voxel grid. Default: 0 (disabled)"
+				 << endl;
+			cout << "  --frames-memory MB: For simplemaps with externally "
+					"stored frames, maximum memory of loaded frames. "
+					"Default: 1024 (0: unlimited)"
+				 << endl;
 			cout << "Push any key to exit..." << endl;
 			os::getch();
 			return -1;
@@ -69,14 +106,17 @@ int main(int argc, char** argv)
 		string inputFile = std::string(argv[2]);
 		string outprefix = std::string(argv[3]);
 
-		if (argc > 4) { METRIC_MAP_CONFIG_SECTION = string(argv[5]); }
-
 		// Load simplemap:
 		cout << "Loading simplemap...";
 		mrpt::maps::CSimpleMap simplemap;
-		mrpt::io::CFileGZInputStream f(inputFile.c_str());
-		mrpt::serialization::archiveFrom(f) >> simplemap;
-		cout << "done: " << simplemap.size() << " observations." << endl;
+		if (!simplemap.loadFromFile(inputFile))
+			throw std::runtime_error("Error loading simplemap: " + inputFile);
+		simplemap.setExternalStorageMemoryBudget(
+			static_cast<size_t>(framesMemoryMB * 1024 * 1024));
+		cout << "done: " << simplemap.size() << " observations"
+			 << (simplemap.isExternallyStored() ? " (externally stored)."
+												: ".")
+			 << endl;
 
 		// Create metric maps:
 		TSetOfMetricMapInitializers mapCfg;
@@ -89,7 +129,9 @@ int main(int argc, char** argv)
 		// Build metric maps:
 		cout << "Building metric maps...";
 
-		metricMap.loadFromProbabilisticPosesAndObservations(simplemap);
+		if (numThreads >= 0)
+			metricMap.numThreads = static_cast<unsigned int>(numThreads);
+		metricMap.loadFromSimpleMapInTiles(simplemap, tileSize, voxelSize);
 
 		cout << "done." << endl;
 
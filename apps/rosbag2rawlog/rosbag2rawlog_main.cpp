@@ -18,6 +18,7 @@
 #include <cv_bridge/cv_bridge.h>
 #include <mrpt/3rdparty/tclap/CmdLine.h>
 #include <mrpt/containers/yaml.h>
+#include <mrpt/core/WorkerThreadsPool.h>
 #include <mrpt/io/CFileGZInputStream.h>
 #include <mrpt/io/CFileGZOutputStream.h>
 #include <mrpt/obs/CActionCollection.h>
@@ -26,6 +27,7 @@
 #include <mrpt/obs/CObservationIMU.h>
 #include <mrpt/obs/CObservationPointCloud.h>
 #include <mrpt/obs/CObservationRotatingScan.h>
+#include <mrpt/obs/CRawlogIndexedFile.h>
 #include <mrpt/poses/CPose3DQuat.h>
 #include <mrpt/ros1bridge/imu.h>
 #include <mrpt/ros1bridge/point_cloud2.h>
@@ -46,7 +48,10 @@
 #include <tf2/exceptions.h>
 #include <tf2_msgs/TFMessage.h>
 
+#include <deque>
+#include <future>
 #include <memory>
+#include <thread>
 
 using namespace mrpt;
 using namespace mrpt::io;
@@ -61,8 +66,10 @@ TCLAP::UnlabeledMultiArg<std::string> arg_input_files(
 	"bags", "Input bag files (required) (*.bag)", true, "log.bag", cmd);
 
 TCLAP::ValueArg<std::string> arg_output_file(
-	"o", "output", "Output dataset (*.rawlog)", true, "", "dataset_out.rawlog",
-	cmd);
+	"o", "output",
+	"Output dataset (*.rawlog). Use the extension *.rawlogx (or --indexed) "
+	"to write a chunked, indexed rawlog (see mrpt::obs::CRawlogIndexedFile)",
+	true, "", "dataset_out.rawlog", cmd);
 
 TCLAP::ValueArg<std::string> arg_config_file(
 	"c", "config", "Config yaml file (*.yml)", true, "", "config.yml", cmd);
@@ -74,9 +81,28 @@ TCLAP::SwitchArg arg_overwrite(
 TCLAP::ValueArg<std::string> arg_world_frame(
 	"f", "frame", "World TF frame", true, "", "world", cmd);
 
+TCLAP::SwitchArg arg_indexed(
+	"", "indexed",
+	"Write a chunked, indexed rawlog, whatever the output file extension.",
+	cmd, false);
+
+TCLAP::ValueArg<unsigned int> arg_threads(
+	"", "threads",
+	"Threads converting messages and compressing chunks of indexed rawlogs "
+	"(Default=0: as many as hardware threads)",
+	false, 0, "0", cmd);
+
 using Obs = std::list<mrpt::serialization::CSerializable::Ptr>;
 
-using CallbackFunction = std::function<Obs(const rosbag::MessageInstance&)>;
+/** The conversion of one message, run in the pool of converter threads.
+ * Empty if there is nothing to convert. */
+using ConversionTask = std::function<Obs()>;
+
+/** Called from the bag reading thread for each message: reads it (the bag
+ * cannot be read from several threads), updates any state (tf buffer,
+ * synchronizers) and returns the conversion task. */
+using CallbackFunction =
+	std::function<ConversionTask(const rosbag::MessageInstance&)>;
 
 template <typename... Args>
 class RosSynchronizer
@@ -96,15 +122,7 @@ class RosSynchronizer
 	{
 	}
 
-	template <std::size_t... N>
-	Obs signal(std::index_sequence<N...>)
-	{
-		auto ptr = m_callback(std::get<N>(m_cache)...);
-		m_cache = {};
-		return ptr;
-	}
-
-	Obs signal()
+	ConversionTask signal()
 	{
 		auto& frame = std::get<0>(m_cache)->header.frame_id;
 		auto& stamp = std::get<0>(m_cache)->header.stamp;
@@ -134,9 +152,15 @@ class RosSynchronizer
 			auto acts = mrpt::obs::CActionCollection::Create();
 			acts->insert(odom_move);
 
-			auto obs = signal(std::make_index_sequence<sizeof...(Args)>{});
-			obs.push_front(acts);
-			return obs;
+			// The odometry is computed here, in order, and the conversion of
+			// the synchronized messages is deferred:
+			Tuple msgs;
+			std::swap(msgs, m_cache);
+			return [callback = m_callback, msgs, acts]() {
+				auto obs = std::apply(callback, msgs);
+				obs.push_front(acts);
+				return obs;
+			};
 		}
 		return {};
 	}
@@ -147,7 +171,7 @@ class RosSynchronizer
 		return (std::get<N>(m_cache) && ...);
 	}
 
-	Obs checkAndSignal()
+	ConversionTask checkAndSignal()
 	{
 		if (check(std::make_index_sequence<sizeof...(Args)>{}))
 		{ return signal(); }
@@ -166,7 +190,7 @@ class RosSynchronizer
 						i, Tuple>::type::element_type>();
 				return ptr->checkAndSignal();
 			}
-			return Obs();
+			return ConversionTask();
 		};
 	}
 
@@ -187,10 +211,9 @@ class RosSynchronizer
 	Callback m_callback;
 };
 
-Obs toPointCloud2(std::string_view msg, const rosbag::MessageInstance& rosmsg)
+Obs toPointCloud2(
+	std::string_view msg, const sensor_msgs::PointCloud2::Ptr& pts)
 {
-	auto pts = rosmsg.instantiate<sensor_msgs::PointCloud2>();
-
 	auto ptsObs = mrpt::obs::CObservationPointCloud::Create();
 	ptsObs->sensorLabel = msg;
 	ptsObs->timestamp = mrpt::ros1bridge::fromROS(pts->header.stamp);
@@ -233,10 +256,9 @@ Obs toPointCloud2(std::string_view msg, const rosbag::MessageInstance& rosmsg)
 	return {ptsObs};
 }
 
-Obs toRotatingScan(std::string_view msg, const rosbag::MessageInstance& rosmsg)
+Obs toRotatingScan(
+	std::string_view msg, const sensor_msgs::PointCloud2::Ptr& pts)
 {
-	auto pts = rosmsg.instantiate<sensor_msgs::PointCloud2>();
-
 	// Convert points:
 	std::set<std::string> fields = mrpt::ros1bridge::extractFields(*pts);
 
@@ -263,10 +285,8 @@ Obs toRotatingScan(std::string_view msg, const rosbag::MessageInstance& rosmsg)
 	return {obsRotScan};
 }
 
-Obs toIMU(std::string_view msg, const rosbag::MessageInstance& rosmsg)
+Obs toIMU(std::string_view msg, const sensor_msgs::Imu::Ptr& pts)
 {
-	auto pts = rosmsg.instantiate<sensor_msgs::Imu>();
-
 	auto mrptObs = mrpt::obs::CObservationIMU::Create();
 
 	mrptObs->sensorLabel = msg;
@@ -332,10 +352,8 @@ Obs toRangeImage(
 	return {};
 }
 
-Obs toImage(std::string_view msg, const rosbag::MessageInstance& rosmsg)
+Obs toImage(std::string_view msg, const sensor_msgs::Image::Ptr& image)
 {
-	auto image = rosmsg.instantiate<sensor_msgs::Image>();
-
 	auto cv_ptr = cv_bridge::toCvShare(image);
 
 	auto imgObs = mrpt::obs::CObservationImage::Create();
@@ -343,13 +361,15 @@ Obs toImage(std::string_view msg, const rosbag::MessageInstance& rosmsg)
 	imgObs->sensorLabel = msg;
 	imgObs->timestamp = mrpt::ros1bridge::fromROS(image->header.stamp);
 
-	imgObs->image = mrpt::img::CImage(cv_ptr->image, mrpt::img::SHALLOW_COPY);
+	// Deep copy: the ROS message is released before the image is saved
+	imgObs->image = mrpt::img::CImage(cv_ptr->image, mrpt::img::DEEP_COPY);
 
 	return {imgObs};
 }
 
 template <bool isStatic>
-Obs toTf(tf2::BufferCore& tfBuffer, const rosbag::MessageInstance& rosmsg)
+ConversionTask toTf(
+	tf2::BufferCore& tfBuffer, const rosbag::MessageInstance& rosmsg)
 {
 	if (rosmsg.getDataType() == "tf2_msgs/TFMessage")
 	{
@@ -415,7 +435,9 @@ class Transcriber
 			else if (sensorType == "CObservationImage")
 			{
 				auto callback = [=](const rosbag::MessageInstance& m) {
-					return toImage(sensorName, m);
+					auto rosMsg = m.instantiate<sensor_msgs::Image>();
+					return ConversionTask(
+						[=]() { return toImage(sensorName, rosMsg); });
 				};
 				m_lookup[sensor.at("image_topic").as<std::string>()]
 					.emplace_back(callback);
@@ -423,7 +445,9 @@ class Transcriber
 			else if (sensorType == "CObservationPointCloud")
 			{
 				auto callback = [=](const rosbag::MessageInstance& m) {
-					return toPointCloud2(sensorName, m);
+					auto rosMsg = m.instantiate<sensor_msgs::PointCloud2>();
+					return ConversionTask(
+						[=]() { return toPointCloud2(sensorName, rosMsg); });
 				};
 				m_lookup[sensor.at("topic").as<std::string>()].emplace_back(
 					callback);
@@ -432,7 +456,9 @@ class Transcriber
 			else if (sensorType == "CObservationRotatingScan")
 			{
 				auto callback = [=](const rosbag::MessageInstance& m) {
-					return toRotatingScan(sensorName, m);
+					auto rosMsg = m.instantiate<sensor_msgs::PointCloud2>();
+					return ConversionTask(
+						[=]() { return toRotatingScan(sensorName, rosMsg); });
 				};
 				m_lookup[sensor.at("topic").as<std::string>()].emplace_back(
 					callback);
@@ -440,7 +466,9 @@ class Transcriber
 			else if (sensorType == "CObservationIMU")
 			{
 				auto callback = [=](const rosbag::MessageInstance& m) {
-					return toIMU(sensorName, m);
+					auto rosMsg = m.instantiate<sensor_msgs::Imu>();
+					return ConversionTask(
+						[=]() { return toIMU(sensorName, rosMsg); });
 				};
 				m_lookup[sensor.at("topic").as<std::string>()].emplace_back(
 					callback);
@@ -450,18 +478,17 @@ class Transcriber
 		}
 	}
 
-	Obs toMrpt(const rosbag::MessageInstance& rosmsg)
+	/** Returns the conversion tasks for one message, to be run in order */
+	std::vector<ConversionTask> toMrpt(const rosbag::MessageInstance& rosmsg)
 	{
-		Obs rets;
+		std::vector<ConversionTask> rets;
 		auto topic = rosmsg.getTopic();
 
 		if (auto search = m_lookup.find(topic); search != m_lookup.end())
 		{
 			for (const auto& callback : search->second)
-			{
-				auto obs = callback(rosmsg);
-				rets.insert(rets.end(), obs.begin(), obs.end());
-			}
+				if (auto task = callback(rosmsg); task)
+					rets.emplace_back(std::move(task));
 		}
 		else
 		{
@@ -522,22 +549,66 @@ int main(int argc, char** argv)
 			return 1;
 		}
 
+		const size_t nThreads = arg_threads.getValue() != 0
+			? arg_threads.getValue()
+			: std::max<size_t>(1, std::thread::hardware_concurrency());
+
+		const bool indexed = arg_indexed.isSet() ||
+			mrpt::system::extractFileExtension(output_rawlog_file) ==
+				"rawlogx";
+
 		CFileGZOutputStream fil_out;
+		mrpt::obs::CRawlogIndexedFileWriter indexed_out;
+		indexed_out.numThreads = nThreads;
+
 		cout << "Opening for writing: '" << output_rawlog_file << "'...\n";
-		if (!fil_out.open(output_rawlog_file))
+		if (!(indexed ? indexed_out.open(output_rawlog_file)
+					  : fil_out.open(output_rawlog_file)))
 			throw std::runtime_error("Error writing file!");
 
 		auto arch = archiveFrom(fil_out);
+		auto lmbWrite = [&](const Obs& ptrs) {
+			for (auto& ptr : ptrs)
+			{
+				if (indexed)
+					indexed_out.write(ptr);
+				else
+					arch << ptr;
+			}
+		};
+
+		// Pipeline: messages are read here, converted in the pool, and the
+		// results written here in the same order than read (the view merges
+		// all bags by timestamp), while the indexed writer compresses chunks
+		// in its own threads.
+		mrpt::WorkerThreadsPool pool(
+			nThreads, mrpt::WorkerThreadsPool::POLICY_FIFO, "rosbag2rawlog");
+		std::deque<std::future<Obs>> pending;
+		const size_t maxPending = 4 * nThreads;
+
+		// Writes the converted results at the front of the queue, waiting
+		// for them if there are too many pending, or if `all`:
+		auto lmbWritePending = [&](bool all) {
+			while (!pending.empty())
+			{
+				auto& f = pending.front();
+				if (!all && pending.size() <= maxPending &&
+					f.wait_for(std::chrono::seconds(0)) !=
+						std::future_status::ready)
+					break;
+				lmbWrite(f.get());
+				pending.pop_front();
+			}
+		};
+
 		Transcriber t(arg_world_frame.getValue(), config);
 		const auto nEntries = full_view.size();
 		size_t curEntry = 0, showProgressCnt = 0;
 		for (const auto& m : full_view)
 		{
-			auto ptrs = t.toMrpt(m);
-			for (auto& ptr : ptrs)
-			{
-				arch << ptr;
-			}
+			for (auto& task : t.toMrpt(m))
+				pending.emplace_back(pool.enqueue(std::move(task)));
+			lmbWritePending(false);
 
 			curEntry++;
 
@@ -554,6 +625,8 @@ int main(int argc, char** argv)
 				showProgressCnt = 0;
 			}
 		}
+		lmbWritePending(true);
+		indexed_out.close();
 		printf("\n");
 
 		for (auto& bag : bags)
@@ -180,6 +180,7 @@ macro(internal_define_mrpt_lib name headers_only )
 	# Enable SIMD especial instructions in especialized source files, even if
 	# those instructions are NOT enabled globally for the entire build:
 	handle_special_simd_flags("${${name}_srcs}" ".*\.SSE2.cpp"  "-msse2")
+	handle_special_simd_flags("${${name}_srcs}" ".*\.POPCNT.cpp"  "-mpopcnt")
 	handle_special_simd_flags("${${name}_srcs}" ".*\.SSSE3.cpp"  "-msse3 -mssse3")
 	handle_special_simd_flags("${${name}_srcs}" ".*\.AVX.cpp"  "-mavx")
 	handle_special_simd_flags("${${name}_srcs}" ".*\.AVX2.cpp"  "-mavx2")
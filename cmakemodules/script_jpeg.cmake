@@ -61,3 +61,17 @@ if((NOT CMAKE_MRPT_HAS_JPEG_SYSTEM) AND NOT ("${CMAKE_SYSTEM_NAME}" STREQUAL "Em
 
 	include_directories("${JPEG_INCLUDE_DIRS}")
 endif()
+
+# Check for the TurboJPEG API of a system libjpeg-turbo (optional):
+# ===================================================
+set(CMAKE_MRPT_HAS_TURBOJPEG 0)
+option(DISABLE_TURBOJPEG "Force not using the TurboJPEG API" "OFF")
+mark_as_advanced(DISABLE_TURBOJPEG)
+if(CMAKE_MRPT_HAS_JPEG_SYSTEM AND NOT DISABLE_TURBOJPEG)
+	find_path(TURBOJPEG_INCLUDE_DIR turbojpeg.h)
+	find_library(TURBOJPEG_LIBRARY turbojpeg)
+	mark_as_advanced(TURBOJPEG_INCLUDE_DIR TURBOJPEG_LIBRARY)
+	if(TURBOJPEG_INCLUDE_DIR AND TURBOJPEG_LIBRARY)
+		set(CMAKE_MRPT_HAS_TURBOJPEG 1)
+	endif()
+endif()
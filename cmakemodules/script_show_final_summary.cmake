@@ -130,6 +130,7 @@ SHOW_CONFIG_LINE_SYSTEM("fyaml (YAML/JSON parsing)           " CMAKE_MRPT_HAS_LI
 SHOW_CONFIG_LINE_SYSTEM("gtest (Google unit testing library) " CMAKE_MRPT_HAS_GTEST)
 SHOW_CONFIG_LINE_SYSTEM("jsoncpp (JSON format serialization) " CMAKE_MRPT_HAS_JSONCPP "[Version: ${jsoncpp_VERSION}]")
 SHOW_CONFIG_LINE_SYSTEM("libjpeg (jpeg)                      " CMAKE_MRPT_HAS_JPEG)
+SHOW_CONFIG_LINE_SYSTEM("TurboJPEG API (libjpeg-turbo)       " CMAKE_MRPT_HAS_TURBOJPEG)
 SHOW_CONFIG_LINE_SYSTEM("liblas (ASPRS LAS LiDAR format)     " CMAKE_MRPT_HAS_LIBLAS)
 SHOW_CONFIG_LINE       ("mexplus                             " CMAKE_MRPT_HAS_MATLAB)
 SHOW_CONFIG_LINE_SYSTEM("Octomap                             " CMAKE_MRPT_HAS_OCTOMAP "[Version: ${OCTOMAP_VERSION}]")
@@ -140,8 +141,10 @@ SHOW_CONFIG_LINE_SYSTEM("OpenGL GLES                         " CMAKE_MRPT_HAS_GL
 SHOW_CONFIG_LINE_SYSTEM("GLUT                                " CMAKE_MRPT_HAS_GLUT)
 SHOW_CONFIG_LINE_SYSTEM("PCAP (Wireshark logs for Velodyne)  " CMAKE_MRPT_HAS_LIBPCAP)
 SHOW_CONFIG_LINE_SYSTEM("SuiteSparse                         " CMAKE_MRPT_HAS_SUITESPARSE)
+SHOW_CONFIG_LINE_SYSTEM(" - CHOLMOD sparse Cholesky          " CMAKE_MRPT_HAS_CHOLMOD)
 SHOW_CONFIG_LINE_SYSTEM("tinyxml2                            " CMAKE_MRPT_HAS_TINYXML2)
 SHOW_CONFIG_LINE_SYSTEM("wxWidgets                           " CMAKE_MRPT_HAS_WXWIDGETS "[Version: ${wxWidgets_VERSION_STRING} ${CMAKE_WXWIDGETS_TOOLKIT_NAME}]")
+SHOW_CONFIG_LINE_SYSTEM("zstd (Zstandard compression)        " CMAKE_MRPT_HAS_ZSTD "[Version: ${ZSTD_VERSION}]")
 message(STATUS  "")
 
 message(STATUS " ______________________ GUI LIBRARIES ______________________")
@@ -36,3 +36,22 @@ if(SuiteSparse_FOUND)
 	set(CMAKE_MRPT_HAS_SUITESPARSE 1)
 	set(CMAKE_MRPT_HAS_SUITESPARSE_SYSTEM 1)
 endif()
+
+# Optional CHOLMOD backend for CSparseMatrix::CholeskyDecomp (supernodal,
+# multithreaded through the BLAS/LAPACK it was built against):
+set(CMAKE_MRPT_HAS_CHOLMOD 0)
+set(CMAKE_MRPT_HAS_CHOLMOD_SYSTEM 0)
+if(CMAKE_MRPT_HAS_SUITESPARSE)
+	option(MRPT_SPARSE_CHOLESKY_CHOLMOD "Use SuiteSparse CHOLMOD instead of CSparse in CSparseMatrix::CholeskyDecomp" "OFF")
+	if(MRPT_SPARSE_CHOLESKY_CHOLMOD)
+		find_path(CHOLMOD_INCLUDE_DIR cholmod.h
+			HINTS ${SuiteSparse_INCLUDE_DIRS}
+			PATH_SUFFIXES suitesparse)
+		if(CHOLMOD_INCLUDE_DIR)
+			set(CMAKE_MRPT_HAS_CHOLMOD 1)
+			set(CMAKE_MRPT_HAS_CHOLMOD_SYSTEM 1)
+		else()
+			message(WARNING "MRPT_SPARSE_CHOLESKY_CHOLMOD is ON but cholmod.h was not found: using CSparse instead.")
+		endif()
+	endif()
+endif()
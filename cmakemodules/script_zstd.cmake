@@ -0,0 +1,20 @@
+# Check for system libzstd (Zstandard compression):
+#  https://facebook.github.io/zstd/
+# ===================================================
+set(CMAKE_MRPT_HAS_ZSTD 0)
+set(CMAKE_MRPT_HAS_ZSTD_SYSTEM 0)
+
+option(DISABLE_ZSTD "Forces NOT using libzstd, even if it could be found by CMake" "OFF")
+mark_as_advanced(DISABLE_ZSTD)
+
+if(NOT DISABLE_ZSTD)
+	find_package(PkgConfig QUIET)
+	if(PKG_CONFIG_FOUND)
+		pkg_check_modules(ZSTD QUIET IMPORTED_TARGET libzstd)
+		if(ZSTD_FOUND)
+			# pkg-config imported target: "PkgConfig::ZSTD"
+			set(CMAKE_MRPT_HAS_ZSTD 1)
+			set(CMAKE_MRPT_HAS_ZSTD_SYSTEM 1)
+		endif()
+	endif()
+endif()
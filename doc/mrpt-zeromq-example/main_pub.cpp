@@ -8,7 +8,7 @@
    +---------------------------------------------------------------------------+ */
 
 #include <zmq.h>
-#include <mrpt/serialization/serialization_zmq.h>
+#include <mrpt/serialization/zmq_serialization.h>
 #include <assert.h>
 #include <mrpt/poses/CPose3D.h>
 #include <mrpt/img/CImage.h>
@@ -31,12 +31,12 @@ int main()
 		{
 			mrpt::poses::CPose3D  my_pose(0.5f,0.5f,1.5f ,DEG2RAD(-90.0f),DEG2RAD(0),DEG2RAD(-90.0f)  );
 			printf("Publishing pose...\n");
-			mrpt::comms::mrpt_send_to_zmq(pub_sock, my_pose);
+			mrpt::serialization::mrpt_send_to_zmq(pub_sock, my_pose);
 			std::this_thread::sleep_for(100ms);
 
 			mrpt::img::CImage my_img(800,600, CH_RGB);
 			printf("Publishing img...\n");
-			mrpt::comms::mrpt_send_to_zmq(pub_sock, my_img, 0 /* max_packet_len: 0=no max size */);
+			mrpt::serialization::mrpt_send_to_zmq(pub_sock, my_img, 0 /* max_packet_len: 0=no max size */);
 			std::this_thread::sleep_for(100ms);
 		}
 
@@ -9,7 +9,7 @@
  */
 
 #include <zmq.h>
-#include <mrpt/serialization/serialization_zmq.h>
+#include <mrpt/serialization/zmq_serialization.h>
 #include <assert.h>
 #include <stdio.h>
 #include <mrpt/poses/CPose3D.h>
@@ -0,0 +1,122 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/serialization/CSerializable.h>
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+
+namespace mrpt::apps
+{
+/** Writes objects to a gz-compressed rawlog file in background threads, so
+ * the caller never waits for serialization or compression.
+ *
+ * The pipeline has three stages:
+ *  - Serialization: each object passed to write() is serialized into its own
+ *    memory buffer, in parallel in a pool of threads.
+ *  - Compression: serialized objects are grouped, in order, into chunks of
+ *    about `chunkSize` bytes, each compressed in parallel as an independent
+ *    gzip member (see mrpt::io::zip::compress_gz_data_block()).
+ *  - Appending: one thread writes the compressed chunks to the file, in
+ *    order.
+ *
+ * A sequence of gzip members is a valid .gz file, so the output can be read
+ * as any other rawlog (e.g. with mrpt::io::CFileGZInputStream). Objects are
+ * stored in the same order than passed to write().
+ *
+ * Statistics per source (the sensor label of observations, or the class
+ * name of other objects) are available with getSourceStats() while writing.
+ *
+ * \code
+ * CRawlogPipelinedWriter w;
+ * w.open("dataset.rawlog", 1);
+ * w.write(obs);  // returns immediately
+ * ...
+ * w.close();  // waits for all pending objects
+ * \endcode
+ *
+ * \sa CRawlogPrefetchReader
+ * \note (New in MRPT 2.4.9)
+ * \ingroup mrpt_apps_grp
+ */
+class CRawlogPipelinedWriter
+{
+   public:
+	CRawlogPipelinedWriter();
+	/** Calls close() */
+	~CRawlogPipelinedWriter();
+
+	CRawlogPipelinedWriter(const CRawlogPipelinedWriter&) = delete;
+	CRawlogPipelinedWriter& operator=(const CRawlogPipelinedWriter&) = delete;
+
+	/** @name Parameters (change before open())
+		@{ */
+	/** Threads for serialization and compression (Default=0: as many as
+	 * hardware threads) */
+	size_t numThreads = 0;
+	/** Approximate size (bytes) of uncompressed chunks (Default=1 MiB) */
+	size_t chunkSize = 1024 * 1024;
+	/** write() blocks while there are this number of objects waiting to be
+	 * serialized and appended (Default=10000) */
+	size_t maxPendingObjects = 10000;
+	/** Chunks are compressed and written after this time (seconds) without
+	 * new objects, even if smaller than chunkSize (Default=1.0) */
+	double flushPeriod = 1.0;
+	/** @} */
+
+	/** Creates the output file and starts the background threads.
+	 * \param compressLevel 0: no compression, 1 (fastest) to 9 (best).
+	 * \exception std::exception If the file cannot be created. */
+	void open(const std::string& fileName, int compressLevel = 1);
+	bool isOpen() const;
+
+	/** Waits for all the pending objects to be written, and closes the file.
+	 * \exception std::exception Upon serialization or file errors. */
+	void close();
+
+	/** Queues an object to be written. The object must not be modified
+	 * afterwards.
+	 * \param source Source name for the statistics. If empty, the sensor
+	 * label of observations or the class name of other objects is used.
+	 */
+	void write(
+		const mrpt::serialization::CSerializable::Ptr& obj,
+		const std::string& source = std::string());
+
+	/** Statistics of the objects of one source */
+	struct TSourceStats
+	{
+		TSourceStats() = default;
+
+		/** Objects and bytes (uncompressed) written so far */
+		size_t writtenObjects = 0;
+		uint64_t writtenBytes = 0;
+		/** Objects waiting in the pipeline */
+		size_t pendingObjects = 0;
+	};
+
+	/** Statistics of each source, since open() */
+	std::map<std::string, TSourceStats> getSourceStats() const;
+
+	/** Objects waiting to be serialized and appended to a chunk */
+	size_t getPendingObjects() const;
+	/** Chunks waiting to be compressed and written */
+	size_t getPendingChunks() const;
+	/** Bytes written to the file so far (compressed) */
+	uint64_t getFileBytes() const;
+
+   private:
+	struct Impl;
+	std::unique_ptr<Impl> m_impl;
+};
+
+}  // namespace mrpt::apps
@@ -0,0 +1,100 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/io/CStream.h>
+#include <mrpt/obs/CActionCollection.h>
+#include <mrpt/obs/CObservation.h>
+#include <mrpt/obs/CSensoryFrame.h>
+
+#include <cstdint>
+#include <memory>
+
+namespace mrpt::apps
+{
+/** Reads a rawlog stream in background threads, so decompression and object
+ * deserialization overlap with the processing of previous entries.
+ *
+ * Two pipeline stages run in their own threads:
+ *  - Decompression: reads blocks of raw bytes from the input stream (e.g. a
+ *    mrpt::io::CFileGZInputStream), into a bounded queue of blocks.
+ *  - Deserialization: parses those bytes into objects, grouped as in
+ *    mrpt::obs::CRawlog::getActionObservationPairOrObservation(), into a
+ *    bounded queue of entries.
+ *
+ * getNextEntry() returns entries in the same order than they are stored in
+ * the file. Both queues are bounded, so memory usage is limited even if the
+ * consumer is much slower than the reader.
+ *
+ * \code
+ * mrpt::io::CFileGZInputStream f("dataset.rawlog");
+ * CRawlogPrefetchReader reader;
+ * reader.start(f);
+ * while (reader.getNextEntry(action, sf, obs, rawlogEntry)) { ... }
+ * \endcode
+ *
+ * \note (New in MRPT 2.4.9)
+ * \ingroup mrpt_apps_grp
+ */
+class CRawlogPrefetchReader
+{
+   public:
+	CRawlogPrefetchReader();
+	/** Stops the background threads, if running. */
+	~CRawlogPrefetchReader();
+
+	CRawlogPrefetchReader(const CRawlogPrefetchReader&) = delete;
+	CRawlogPrefetchReader& operator=(const CRawlogPrefetchReader&) = delete;
+
+	/** @name Parameters (change before start())
+		@{ */
+	/** Maximum number of parsed entries waiting to be returned (Default=32) */
+	size_t entriesQueueCapacity = 32;
+	/** Size (bytes) of each block read by the decompression thread
+	 * (Default=256 KiB) */
+	size_t blockSize = 256 * 1024;
+	/** Maximum number of blocks waiting to be parsed (Default=16) */
+	size_t blocksQueueCapacity = 16;
+	/** Whether to hint parsed observations to start decoding their
+	 * externally-stored images in the background, while they wait in the
+	 * queue (see mrpt::obs::CObservation::prefetch()) (Default=true) */
+	bool prefetchExternalImages = true;
+	/** @} */
+
+	/** Starts reading from an already open stream, which must not be accessed
+	 * by the caller until stop() is called or EOF is reached.
+	 * Calling start() again stops any former reading. */
+	void start(mrpt::io::CStream& in);
+
+	/** Stops the background threads. Unread entries are discarded. */
+	void stop();
+
+	/** Returns the next entry, blocking until it is available. Either `action`
+	 * and `observations`, or `observation` are returned, the others being
+	 * empty pointers. `rawlogEntry` is updated with the number of objects
+	 * read from the file so far.
+	 * \return false on EOF, a read error, or if start() was not called.
+	 * \sa mrpt::obs::CRawlog::getActionObservationPairOrObservation()
+	 */
+	bool getNextEntry(
+		mrpt::obs::CActionCollection::Ptr& action,
+		mrpt::obs::CSensoryFrame::Ptr& observations,
+		mrpt::obs::CObservation::Ptr& observation, size_t& rawlogEntry);
+
+	/** Bytes read so far from the input stream by the decompression thread,
+	 * as given by its mrpt::io::CStream::getPosition(). Useful for progress
+	 * indicators. */
+	uint64_t getInputPosition() const;
+
+   private:
+	struct Impl;
+	std::unique_ptr<Impl> m_impl;
+};
+
+}  // namespace mrpt::apps
@@ -9,6 +9,8 @@
 
 #pragma once
 
+#include <mrpt/apps/CRawlogPrefetchReader.h>
+#include <mrpt/core/WorkerThreadsPool.h>
 #include <mrpt/io/CFileGZInputStream.h>
 #include <mrpt/io/CFileGZOutputStream.h>
 #include <mrpt/obs/CRawlog.h>
@@ -16,7 +18,13 @@
 #include <mrpt/system/CTicTac.h>
 #include <mrpt/system/os.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <future>
 #include <iostream>
+#include <thread>
 
 // Aparently, TCLAP headers can't be included in more than one source file
 //  or duplicated linking symbols appear! -> Use forward declarations instead:
@@ -30,6 +38,15 @@ namespace mrpt::apps
 {
 /** A virtual class that implements the common stuff around parsing a rawlog
  * file and (optionally) display a progress indicator to the console.
+ * The input file is decompressed and parsed in background threads while
+ * entries are processed, see CRawlogPrefetchReader.
+ *
+ * If m_numThreads is not 1, processOneEntry() is invoked in parallel in a pool
+ * of threads, for a bounded number of entries read ahead, while
+ * OnPostProcess() is still invoked from the calling thread and in the same
+ * order than entries are read from the file. This is only valid for derived
+ * classes whose processOneEntry() modifies nothing but the entry itself (or
+ * atomic counters), regardless of the order of entries.
  * \ingroup mrpt_apps_grp
  */
 class CRawlogProcessor
@@ -45,6 +62,15 @@ class CRawlogProcessor
 	uint64_t m_filSize;
 	size_t m_rawlogEntry;
 	double m_timToParse;  // Public variable, at end will hold ellapsed time.
+	/** Threads for processOneEntry() (Default=1: no parallelism, 0: as many
+	 * as hardware threads). See the class description.
+	 * \note (New in MRPT 2.4.9) */
+	size_t m_numThreads = 1;
+	/** Index of the first entry in the input stream, if it was advanced
+	 * before doProcessRawlog() (see mrpt::obs::CRawlogSidecarIndex), so that
+	 * m_rawlogEntry keeps counting from the beginning of the file.
+	 * \note (New in MRPT 2.4.9) */
+	size_t m_firstRawlogEntry = 0;
 
 	// Ctor
 	CRawlogProcessor(
@@ -71,62 +97,133 @@ class CRawlogProcessor
 
 		size_t rawlogEntryCount = 0;
 
-		// Parse the entire rawlog:
-		auto arch = mrpt::serialization::archiveFrom(m_in_rawlog);
-		while (mrpt::obs::CRawlog::getActionObservationPairOrObservation(
-			arch, actions, SF, obs, rawlogEntryCount))
+		// Parallel processing of entries, if enabled:
+		const size_t nThreads = m_numThreads != 0
+			? m_numThreads
+			: std::max<size_t>(1, std::thread::hardware_concurrency());
+		std::unique_ptr<mrpt::WorkerThreadsPool> pool;
+		if (nThreads > 1)
+			pool = std::make_unique<mrpt::WorkerThreadsPool>(
+				nThreads, mrpt::WorkerThreadsPool::POLICY_FIFO, "rawlogProc");
+
+		struct TPendingEntry
 		{
-			m_rawlogEntry = rawlogEntryCount - 1;
+			mrpt::obs::CActionCollection::Ptr actions;
+			mrpt::obs::CSensoryFrame::Ptr SF;
+			mrpt::obs::CObservation::Ptr obs;
+			std::future<bool> processed;
+		};
+		std::deque<std::shared_ptr<TPendingEntry>> pending;
+		const size_t maxPending = 4 * nThreads;
+		bool stopRequested = false;
+
+		// Post-processes in order the entries already processed, or all of
+		// them if `all`. Returns false if the processing has been stopped.
+		auto lmbPostProcess = [&](bool all) {
+			while (!pending.empty())
+			{
+				auto& e = *pending.front();
+				if (!all && pending.size() < maxPending &&
+					e.processed.wait_for(std::chrono::seconds(0)) !=
+						std::future_status::ready)
+					break;
+
+				const bool ret = e.processed.get();
+				if (!stopRequested) OnPostProcess(e.actions, e.SF, e.obs);
+				pending.pop_front();
+				if (!ret) stopRequested = true;
+			}
+			return !stopRequested;
+		};
 
-			// Abort if the user presses ESC:
-			if (mrpt::system::os::kbhit())
-				if (27 == mrpt::system::os::getch())
+		// Parse the entire rawlog:
+		CRawlogPrefetchReader reader;
+		reader.start(m_in_rawlog);
+		try
+		{
+			while (reader.getNextEntry(actions, SF, obs, rawlogEntryCount))
+			{
+				m_rawlogEntry = m_firstRawlogEntry + rawlogEntryCount - 1;
+
+				// Abort if the user presses ESC:
+				if (mrpt::system::os::kbhit())
+					if (27 == mrpt::system::os::getch())
+					{
+						std::cerr << "Aborted since user pressed ESC.\n";
+						break;
+					}
+
+				// Update status to the console?
+				const mrpt::system::TTimeStamp tNow = mrpt::system::now();
+				if (mrpt::system::timeDifference(m_last_console_update, tNow) >
+					0.25)
 				{
-					std::cerr << "Aborted since user pressed ESC.\n";
-					break;
+					m_last_console_update = tNow;
+					uint64_t fil_pos = reader.getInputPosition();
+					if (verbose)
+					{
+						std::cout << mrpt::format(
+							"Progress: %7u objects --- Pos: %9sB/%c%9sB \r",
+							(unsigned int)(m_rawlogEntry + 1),
+							mrpt::system::unitsFormat(fil_pos).c_str(),
+							(fil_pos > m_filSize ? '>' : ' '),
+							mrpt::system::unitsFormat(m_filSize)
+								.c_str());	// \r -> don't go to the next line...
+
+						std::cout.flush();
+					}
 				}
 
-			// Update status to the console?
-			const mrpt::system::TTimeStamp tNow = mrpt::system::now();
-			if (mrpt::system::timeDifference(m_last_console_update, tNow) >
-				0.25)
-			{
-				m_last_console_update = tNow;
-				uint64_t fil_pos = m_in_rawlog.getPosition();
-				if (verbose)
+				bool process_ret = true;
+				if (pool)
 				{
-					std::cout << mrpt::format(
-						"Progress: %7u objects --- Pos: %9sB/%c%9sB \r",
-						(unsigned int)(m_rawlogEntry + 1),
-						mrpt::system::unitsFormat(fil_pos).c_str(),
-						(fil_pos > m_filSize ? '>' : ' '),
-						mrpt::system::unitsFormat(m_filSize)
-							.c_str());	// \r -> don't go to the next line...
-
-					std::cout.flush();
+					auto e = std::make_shared<TPendingEntry>();
+					e->actions = std::move(actions);
+					e->SF = std::move(SF);
+					e->obs = std::move(obs);
+					e->processed = pool->enqueue([this, e]() {
+						return processOneEntry(e->actions, e->SF, e->obs);
+					});
+					pending.push_back(std::move(e));
+					process_ret = lmbPostProcess(false);
 				}
-			}
+				else
+				{
+					// Do whatever:
+					process_ret = processOneEntry(actions, SF, obs);
 
-			// Do whatever:
-			bool process_ret = processOneEntry(actions, SF, obs);
+					// Post process:
+					OnPostProcess(actions, SF, obs);
+				}
 
-			// Post process:
-			OnPostProcess(actions, SF, obs);
+				// Clear read objects:
+				actions.reset();
+				SF.reset();
+				obs.reset();
 
-			// Clear read objects:
-			actions.reset();
-			SF.reset();
-			obs.reset();
+				if (!process_ret)
+				{
+					// Returning false means we should stop parsing the rest of
+					// the rawlog:
+					std::cerr << "\nParsing stopped due to request from Rawlog "
+								 "filter implementation.\n";
+					break;
+				}
+			};	// end while
 
-			if (!process_ret)
-			{
-				// Returning false means we should stop parsing the rest of the
-				// rawlog:
+			// Entries read ahead (discarded if the processing was stopped):
+			const bool wasStopped = stopRequested;
+			if (!lmbPostProcess(true) && !wasStopped)
 				std::cerr << "\nParsing stopped due to request from Rawlog "
 							 "filter implementation.\n";
-				break;
-			}
-		};	// end while
+		}
+		catch (...)
+		{
+			// Tasks still running refer to this object:
+			for (auto& e : pending)
+				if (e->processed.valid()) e->processed.wait();
+			throw;
+		}
 
 		if (verbose) std::cout << "\n";	 // new line after the "\r".
 
@@ -223,7 +320,9 @@ class CRawlogProcessorFilterObservations
 {
    public:
 	mrpt::io::CFileGZOutputStream& m_out_rawlog;
-	size_t m_entries_removed, m_entries_parsed;
+	/** Atomic, since entries may be processed in parallel (see
+	 * CRawlogProcessor::m_numThreads) */
+	std::atomic<size_t> m_entries_removed, m_entries_parsed;
 	/** Set to true to indicate that we are sure we don't have to keep on
 	 * reading. */
 	bool m_we_are_done_with_this_rawlog;
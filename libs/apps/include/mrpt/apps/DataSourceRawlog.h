@@ -9,13 +9,18 @@
 #pragma once
 
 #include <mrpt/apps/BaseAppDataSource.h>
+#include <mrpt/apps/CRawlogPrefetchReader.h>
 #include <mrpt/io/CFileGZInputStream.h>
 #include <mrpt/serialization/CArchive.h>
 #include <mrpt/system/COutputLogger.h>
 
 namespace mrpt::apps
 {
-/** Implementation of BaseAppDataSource for reading from a rawlog file
+/** Implementation of BaseAppDataSource for reading from a rawlog file.
+ * Decompression and deserialization run in background threads, see
+ * CRawlogPrefetchReader. If the rawlog has an up-to-date sidecar index (see
+ * mrpt::obs::CRawlogSidecarIndex), the entries before the rawlog offset are
+ * skipped without deserializing them.
  *
  * \ingroup mrpt_apps_grp
  */
@@ -35,8 +40,12 @@ class DataSourceRawlog : virtual public BaseAppDataSource,
 	std::string m_rawlogFileName = "UNDEFINED.rawlog";
 	std::size_t m_rawlog_offset = 0;
 	std::size_t m_rawlogEntry = 0;
+	/** Entries skipped with the sidecar index, before m_rawlog_reader */
+	std::size_t m_rawlogEntryBase = 0;
 	mrpt::io::CFileGZInputStream m_rawlog_io;
-	mrpt::serialization::CArchive::UniquePtr m_rawlog_arch;
+	/** Declared after m_rawlog_io, so its threads stop before closing it */
+	CRawlogPrefetchReader m_rawlog_reader;
+	bool m_rawlog_opened = false;
 };
 
 }  // namespace mrpt::apps
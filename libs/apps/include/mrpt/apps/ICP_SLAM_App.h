@@ -17,6 +17,7 @@
 #include <mrpt/system/COutputLogger.h>
 
 #include <atomic>
+#include <vector>
 
 namespace mrpt::apps
 {
@@ -73,6 +74,12 @@ class ICP_SLAM_App_Base : virtual public mrpt::system::COutputLogger,
 
 	std::map<mrpt::system::TTimeStamp, mrpt::math::TPose3D> out_estimated_path;
 
+	/** Execution time (seconds) of each step of the algorithm (each call to
+	 * CMetricMapBuilderICP::processActionObservation()), in order. Cleared
+	 * on each call to run().
+	 * \note (New in MRPT 2.4.9) */
+	std::vector<double> out_step_exec_times;
+
 	/** @} */
 };
 
@@ -10,9 +10,11 @@
 
 #include <mrpt/config/CConfigFileBase.h>
 #include <mrpt/config/CConfigFileMemory.h>
+#include <mrpt/math/TPose3D.h>
 #include <mrpt/system/COutputLogger.h>
 
 #include <memory>
+#include <vector>
 
 namespace mrpt::apps
 {
@@ -63,6 +65,15 @@ class KFSLAMApp : public mrpt::system::COutputLogger
 	/** Average localization error, when supplied with a ground-truth file */
 	double loc_error_wrt_gt = 0;
 
+	/** The mean robot pose after each step, in order.
+	 * \note (New in MRPT 2.4.9) */
+	std::vector<mrpt::math::TPose3D> out_estimated_path;
+
+	/** Execution time (seconds) of each step of the algorithm (each call to
+	 * processActionObservation()), in order. Cleared on each call to run().
+	 * \note (New in MRPT 2.4.9) */
+	std::vector<double> out_step_exec_times;
+
 	/** @} */
 
    private:
@@ -16,6 +16,8 @@
 #include <mrpt/poses/CPose3DInterpolator.h>
 #include <mrpt/system/COutputLogger.h>
 
+#include <vector>
+
 namespace mrpt::apps
 {
 /** MonteCarlo (Particle filter) localization wrapper class for CLI or custom
@@ -75,6 +77,12 @@ class MonteCarloLocalization_Base : virtual public mrpt::system::COutputLogger,
 	/** Controlled by flag `fill_out_estimated_path` */
 	mrpt::poses::CPose3DInterpolator out_estimated_path;
 
+	/** Execution time (seconds) of each step of the algorithm (each call to
+	 * the particle filter), of all the repetitions if `experimentRepetitions`
+	 * is >1. Cleared on each call to run().
+	 * \note (New in MRPT 2.4.9) */
+	std::vector<double> out_step_exec_times;
+
 	/** @} */
 
    protected:
@@ -8,6 +8,7 @@
    +------------------------------------------------------------------------+ */
 #pragma once
 
+#include <mrpt/apps/CRawlogPipelinedWriter.h>
 #include <mrpt/config/CConfigFileBase.h>
 #include <mrpt/config/CConfigFileMemory.h>
 #include <mrpt/hwdrivers/CGenericSensor.h>
@@ -21,6 +22,13 @@
 namespace mrpt::apps
 {
 /** RawlogGrabber application wrapper class.
+ *
+ * Objects are written to the output rawlog in background threads, with a
+ * CRawlogPipelinedWriter, so high-bandwidth sensors do not delay the others.
+ * The throughput and queue depth of each sensor are logged every
+ * `writer_stats_period` seconds (a `[global]` option, default=5, 0 to
+ * disable). The writer threads can be set with `writer_threads` (default=0,
+ * all hardware threads).
  *
  * \note If the environment variable `MRPT_HWDRIVERS_VERBOSE=1` is defined
  * before calling initialize(), verbosity level will be changed to LVL_DEBUG.
@@ -99,6 +107,10 @@ class RawlogGrabberApp : public mrpt::system::COutputLogger
 	void dump_verbose_info(const mrpt::obs::CSensoryFrame& sf) const;
 	void dump_GPS_mode_info(const mrpt::obs::CObservationGPS& o) const;
 	void dump_IMU_info(const mrpt::obs::CObservationIMU& o) const;
+	void dump_writer_stats(
+		const std::map<std::string, CRawlogPipelinedWriter::TSourceStats>&
+			last,
+		double period) const;
 
 	void process_observations_for_sf(const TListObservations& list_obs);
 	void process_observations_for_nonsf(const TListObservations& list_obs);
@@ -132,7 +144,8 @@ class RawlogGrabberApp : public mrpt::system::COutputLogger
 	 * CCameraSensor's. */
 	std::string m_rawlog_ext_imgs_dir;
 
-	mrpt::serialization::CArchive* m_out_arch_ptr = nullptr;
+	/** Serializes, compresses and writes objects in background threads */
+	CRawlogPipelinedWriter m_writer;
 
 	mrpt::obs::CSensoryFrame m_curSF;
 	double SF_max_time_span = 0.25;	 // Seconds
@@ -0,0 +1,307 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "apps-precomp.h"  // Precompiled headers
+//
+#include <mrpt/apps/CRawlogPipelinedWriter.h>
+#include <mrpt/core/WorkerThreadsPool.h>
+#include <mrpt/io/CFileOutputStream.h>
+#include <mrpt/io/CMemoryStream.h>
+#include <mrpt/io/zip.h>
+#include <mrpt/obs/CObservation.h>
+#include <mrpt/serialization/CArchive.h>
+#include <mrpt/system/datetime.h>
+#include <mrpt/system/thread_name.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <future>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace mrpt::apps;
+
+using Buffer = std::vector<uint8_t>;
+
+struct CRawlogPipelinedWriter::Impl
+{
+	mrpt::io::CFileOutputStream file;
+	int compressLevel = 1;
+	size_t chunkSize = 0, maxPendingObjects = 0, maxPendingChunks = 0;
+	double flushPeriod = 1.0;
+
+	std::unique_ptr<mrpt::WorkerThreadsPool> pool;
+	std::thread appendThread;
+
+	struct PendingObject
+	{
+		std::string source;
+		std::future<Buffer> data;
+	};
+
+	mutable std::mutex mtx;
+	// All guarded by mtx:
+	std::condition_variable cvNewObject, cvSpace;
+	std::deque<PendingObject> objects;
+	std::map<std::string, TSourceStats> stats;
+	bool closing = false;
+	std::exception_ptr error;
+
+	std::atomic<size_t> pendingChunks{0};
+	std::atomic<uint64_t> fileBytes{0};
+
+	/** The appending thread: groups serialized objects into chunks, and
+	 * writes the compressed chunks to the file, both in order. */
+	void appendThreadMain();
+};
+
+void CRawlogPipelinedWriter::Impl::appendThreadMain()
+{
+	Buffer chunk;
+	std::deque<std::future<Buffer>> compressed;
+	auto lastObjectTime = mrpt::Clock::now();
+
+	auto lmbSubmitChunk = [&]() {
+		if (chunk.empty()) return;
+		pendingChunks++;
+		compressed.push_back(
+			pool->enqueue([level = compressLevel, c = std::move(chunk)]() {
+				Buffer out;
+				if (!mrpt::io::zip::compress_gz_data_block(c, out, level))
+					THROW_EXCEPTION("Error compressing rawlog chunk");
+				return out;
+			}));
+		chunk = Buffer();
+		chunk.reserve(chunkSize + chunkSize / 4);
+	};
+
+	// Writes the chunks already compressed, or all of them if `all`:
+	auto lmbWriteChunks = [&](bool all) {
+		while (!compressed.empty())
+		{
+			auto& f = compressed.front();
+			if (!all && compressed.size() <= maxPendingChunks &&
+				f.wait_for(std::chrono::seconds(0)) !=
+					std::future_status::ready)
+				break;
+
+			const Buffer data = f.get();
+			compressed.pop_front();
+			pendingChunks--;
+			file.Write(data.data(), data.size());
+			fileBytes += data.size();
+		}
+	};
+
+	try
+	{
+		chunk.reserve(chunkSize + chunkSize / 4);
+		for (;;)
+		{
+			PendingObject obj;
+			bool gotObject = false, finished = false;
+			{
+				std::unique_lock<std::mutex> lck(mtx);
+				// Wake up periodically to write compressed chunks:
+				const auto timeout =
+					std::chrono::milliseconds(compressed.empty() ? 200 : 10);
+				cvNewObject.wait_for(lck, timeout, [this]() {
+					return !objects.empty() || closing;
+				});
+				if (!objects.empty())
+				{
+					obj = std::move(objects.front());
+					objects.pop_front();
+					gotObject = true;
+				}
+				else
+					finished = closing;
+			}
+
+			if (gotObject)
+			{
+				// Wait for the serialization of this object:
+				const Buffer data = obj.data.get();
+				chunk.insert(chunk.end(), data.begin(), data.end());
+				{
+					std::lock_guard<std::mutex> lck(mtx);
+					auto& s = stats[obj.source];
+					s.pendingObjects--;
+					s.writtenObjects++;
+					s.writtenBytes += data.size();
+				}
+				cvSpace.notify_all();
+				lastObjectTime = mrpt::Clock::now();
+
+				if (chunk.size() >= chunkSize) lmbSubmitChunk();
+			}
+			else if (
+				mrpt::system::timeDifference(
+					lastObjectTime, mrpt::Clock::now()) >= flushPeriod)
+				lmbSubmitChunk();
+
+			if (finished) break;
+			lmbWriteChunks(false);
+		}
+		lmbSubmitChunk();
+		lmbWriteChunks(true);
+	}
+	catch (...)
+	{
+		// Reported by write() or close():
+		std::lock_guard<std::mutex> lck(mtx);
+		error = std::current_exception();
+		cvSpace.notify_all();
+	}
+
+	// Wait for in-flight tasks, which refer to this object:
+	for (auto& f : compressed)
+		f.wait();
+}
+
+CRawlogPipelinedWriter::CRawlogPipelinedWriter()
+	: m_impl(std::make_unique<Impl>())
+{
+}
+
+CRawlogPipelinedWriter::~CRawlogPipelinedWriter()
+{
+	try
+	{
+		close();
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << "[~CRawlogPipelinedWriter] " << mrpt::exception_to_str(e)
+				  << "\n";
+	}
+}
+
+void CRawlogPipelinedWriter::open(
+	const std::string& fileName, int compressLevel)
+{
+	close();
+
+	auto& m = *m_impl;
+	if (!m.file.open(fileName))
+		THROW_EXCEPTION_FMT(
+			"Error creating rawlog file '%s'", fileName.c_str());
+
+	const size_t nThreads = numThreads != 0
+		? numThreads
+		: std::max<size_t>(1, std::thread::hardware_concurrency());
+
+	m.compressLevel = compressLevel;
+	m.chunkSize = std::max<size_t>(1, chunkSize);
+	m.maxPendingObjects = std::max<size_t>(1, maxPendingObjects);
+	m.maxPendingChunks = 2 * nThreads;
+	m.flushPeriod = flushPeriod;
+	m.objects.clear();
+	m.stats.clear();
+	m.closing = false;
+	m.error = nullptr;
+	m.pendingChunks = 0;
+	m.fileBytes = 0;
+
+	m.pool = std::make_unique<mrpt::WorkerThreadsPool>(
+		nThreads, mrpt::WorkerThreadsPool::POLICY_FIFO, "rawlogWriter");
+	m.appendThread = std::thread([&m]() { m.appendThreadMain(); });
+	mrpt::system::thread_name("rawlogAppend", m.appendThread);
+}
+
+bool CRawlogPipelinedWriter::isOpen() const
+{
+	return m_impl->appendThread.joinable();
+}
+
+void CRawlogPipelinedWriter::close()
+{
+	auto& m = *m_impl;
+	if (!m.appendThread.joinable()) return;
+
+	{
+		std::lock_guard<std::mutex> lck(m.mtx);
+		m.closing = true;
+	}
+	m.cvNewObject.notify_all();
+	m.appendThread.join();
+
+	// Waits for any serialization task still running:
+	m.pool.reset();
+	m.objects.clear();
+	m.file.close();
+
+	if (m.error) std::rethrow_exception(m.error);
+}
+
+void CRawlogPipelinedWriter::write(
+	const mrpt::serialization::CSerializable::Ptr& obj,
+	const std::string& source)
+{
+	ASSERT_(obj);
+	ASSERTMSG_(isOpen(), "open() must be called first");
+
+	std::string src = source;
+	if (src.empty())
+	{
+		if (const auto* o = dynamic_cast<const mrpt::obs::CObservation*>(
+				obj.get());
+			o && !o->sensorLabel.empty())
+			src = o->sensorLabel;
+		else
+			src = obj->GetRuntimeClass()->className;
+	}
+
+	auto& m = *m_impl;
+	std::unique_lock<std::mutex> lck(m.mtx);
+	m.cvSpace.wait(lck, [&]() {
+		return m.objects.size() < m.maxPendingObjects || m.error;
+	});
+	if (m.error) std::rethrow_exception(m.error);
+
+	m.stats[src].pendingObjects++;
+	m.objects.push_back(
+		{src, m.pool->enqueue([obj]() {
+			 mrpt::io::CMemoryStream ms;
+			 auto arch = mrpt::serialization::archiveFrom(ms);
+			 arch << *obj;
+			 const auto* p = static_cast<const uint8_t*>(ms.getRawBufferData());
+			 return Buffer(p, p + ms.getTotalBytesCount());
+		 })});
+	lck.unlock();
+	m.cvNewObject.notify_one();
+}
+
+std::map<std::string, CRawlogPipelinedWriter::TSourceStats>
+	CRawlogPipelinedWriter::getSourceStats() const
+{
+	std::lock_guard<std::mutex> lck(m_impl->mtx);
+	return m_impl->stats;
+}
+
+size_t CRawlogPipelinedWriter::getPendingObjects() const
+{
+	std::lock_guard<std::mutex> lck(m_impl->mtx);
+	return m_impl->objects.size();
+}
+
+size_t CRawlogPipelinedWriter::getPendingChunks() const
+{
+	return m_impl->pendingChunks;
+}
+
+uint64_t CRawlogPipelinedWriter::getFileBytes() const
+{
+	return m_impl->fileBytes;
+}
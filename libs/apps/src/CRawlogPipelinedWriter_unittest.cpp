@@ -0,0 +1,94 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/apps/CRawlogPipelinedWriter.h>
+#include <mrpt/io/CFileGZInputStream.h>
+#include <mrpt/obs/CObservation2DRangeScan.h>
+#include <mrpt/obs/CObservationOdometry.h>
+#include <mrpt/obs/CSensoryFrame.h>
+#include <mrpt/obs/stock_observations.h>
+#include <mrpt/serialization/CArchive.h>
+#include <mrpt/system/filesystem.h>
+
+using namespace mrpt::obs;
+
+TEST(CRawlogPipelinedWriter, writeAndReadBack)
+{
+	for (const int compressLevel : {0, 1})
+	{
+		const auto fil = mrpt::system::getTempFileName();
+		const size_t N = 500;
+
+		mrpt::apps::CRawlogPipelinedWriter w;
+		// Small chunks, to test many of them in flight:
+		w.chunkSize = 4096;
+		w.numThreads = 3;
+		w.open(fil, compressLevel);
+		EXPECT_TRUE(w.isOpen());
+
+		for (size_t i = 0; i < N; i++)
+		{
+			const auto t = mrpt::Clock::fromDouble(1.0 + i);
+			if (i % 10 == 0)
+			{
+				auto sf = CSensoryFrame::Create();
+				auto odo = CObservationOdometry::Create();
+				odo->timestamp = t;
+				sf->insert(odo);
+				w.write(sf);
+			}
+			else
+			{
+				auto obs = CObservation2DRangeScan::Create();
+				stock_observations::example2DRangeScan(*obs);
+				obs->timestamp = t;
+				obs->sensorLabel = "LIDAR";
+				w.write(obs);
+			}
+		}
+		w.close();
+		EXPECT_FALSE(w.isOpen());
+
+		const auto stats = w.getSourceStats();
+		ASSERT_EQ(stats.count("LIDAR"), 1U);
+		ASSERT_EQ(stats.count("CSensoryFrame"), 1U);
+		EXPECT_EQ(stats.at("LIDAR").writtenObjects, N - N / 10);
+		EXPECT_EQ(stats.at("CSensoryFrame").writtenObjects, N / 10);
+		EXPECT_EQ(stats.at("LIDAR").pendingObjects, 0U);
+		EXPECT_GT(w.getFileBytes(), 0U);
+
+		// Read back, in order:
+		mrpt::io::CFileGZInputStream f(fil);
+		auto arch = mrpt::serialization::archiveFrom(f);
+		for (size_t i = 0; i < N; i++)
+		{
+			const auto t = mrpt::Clock::fromDouble(1.0 + i);
+			auto o = arch.ReadObject();
+			if (i % 10 == 0)
+			{
+				auto sf = std::dynamic_pointer_cast<CSensoryFrame>(o);
+				ASSERT_TRUE(sf);
+				ASSERT_EQ(sf->size(), 1U);
+				EXPECT_EQ(sf->getObservationByIndex(0)->timestamp, t);
+			}
+			else
+			{
+				auto obs =
+					std::dynamic_pointer_cast<CObservation2DRangeScan>(o);
+				ASSERT_TRUE(obs);
+				EXPECT_EQ(obs->timestamp, t);
+				EXPECT_EQ(obs->sensorLabel, "LIDAR");
+			}
+		}
+		// EOF:
+		uint8_t dummy;
+		EXPECT_EQ(f.Read(&dummy, 1), 0U);
+	}
+}
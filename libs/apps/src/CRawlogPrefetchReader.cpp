@@ -0,0 +1,272 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "apps-precomp.h"  // Precompiled headers
+//
+#include <mrpt/apps/CRawlogPrefetchReader.h>
+#include <mrpt/obs/CRawlog.h>
+#include <mrpt/serialization/CArchive.h>
+#include <mrpt/system/thread_name.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace mrpt::apps;
+
+namespace
+{
+/** Blocking FIFO with a maximum size. push() and pop() return false once
+ * abort() has been called. */
+template <typename T>
+class BlockingBoundedQueue
+{
+   public:
+	explicit BlockingBoundedQueue(size_t capacity) : m_capacity(capacity) {}
+
+	bool push(T&& v)
+	{
+		std::unique_lock<std::mutex> lck(m_mtx);
+		m_cvNotFull.wait(
+			lck, [this]() { return m_aborted || m_q.size() < m_capacity; });
+		if (m_aborted) return false;
+		m_q.push_back(std::move(v));
+		m_cvNotEmpty.notify_one();
+		return true;
+	}
+
+	bool pop(T& v)
+	{
+		std::unique_lock<std::mutex> lck(m_mtx);
+		m_cvNotEmpty.wait(lck, [this]() { return m_aborted || !m_q.empty(); });
+		if (m_aborted) return false;
+		v = std::move(m_q.front());
+		m_q.pop_front();
+		m_cvNotFull.notify_one();
+		return true;
+	}
+
+	void abort()
+	{
+		std::unique_lock<std::mutex> lck(m_mtx);
+		m_aborted = true;
+		m_cvNotEmpty.notify_all();
+		m_cvNotFull.notify_all();
+	}
+
+   private:
+	const size_t m_capacity;
+	std::deque<T> m_q;
+	bool m_aborted = false;
+	std::mutex m_mtx;
+	std::condition_variable m_cvNotEmpty, m_cvNotFull;
+};
+
+/** An empty block signals the end of the input stream */
+using Block = std::vector<uint8_t>;
+
+/** Read-only stream over the blocks produced by the decompression thread */
+class CBlockQueueStream : public mrpt::io::CStream
+{
+   public:
+	explicit CBlockQueueStream(BlockingBoundedQueue<Block>& q) : m_q(q) {}
+
+	size_t Read(void* Buffer, size_t Count) override
+	{
+		auto* out = reinterpret_cast<uint8_t*>(Buffer);
+		size_t nRead = 0;
+		while (nRead < Count)
+		{
+			if (m_blockPos >= m_block.size())
+			{
+				if (m_eof || !m_q.pop(m_block) || m_block.empty())
+				{
+					m_eof = true;
+					break;
+				}
+				m_blockPos = 0;
+			}
+			const size_t n =
+				std::min(Count - nRead, m_block.size() - m_blockPos);
+			std::memcpy(out + nRead, m_block.data() + m_blockPos, n);
+			m_blockPos += n;
+			nRead += n;
+		}
+		m_position += nRead;
+		return nRead;
+	}
+	size_t Write(const void*, size_t) override
+	{
+		THROW_EXCEPTION("Write() not supported by this stream");
+	}
+	uint64_t Seek(int64_t, mrpt::io::CStream::TSeekOrigin) override
+	{
+		THROW_EXCEPTION("Seek() not supported by this stream");
+	}
+	uint64_t getTotalBytesCount() const override { return 0; }
+	uint64_t getPosition() const override { return m_position; }
+
+   private:
+	BlockingBoundedQueue<Block>& m_q;
+	Block m_block;
+	size_t m_blockPos = 0;
+	uint64_t m_position = 0;
+	bool m_eof = false;
+};
+
+struct TEntry
+{
+	mrpt::obs::CActionCollection::Ptr action;
+	mrpt::obs::CSensoryFrame::Ptr observations;
+	mrpt::obs::CObservation::Ptr observation;
+	size_t rawlogEntry = 0;
+	/** False for the end-of-stream marker */
+	bool valid = false;
+};
+
+}  // namespace
+
+struct CRawlogPrefetchReader::Impl
+{
+	std::unique_ptr<BlockingBoundedQueue<Block>> blocks;
+	std::unique_ptr<BlockingBoundedQueue<TEntry>> entries;
+	std::thread decompressThread, parseThread;
+	std::atomic<uint64_t> inputPosition{0};
+	bool eof = true;
+};
+
+CRawlogPrefetchReader::CRawlogPrefetchReader()
+	: m_impl(std::make_unique<Impl>())
+{
+}
+
+CRawlogPrefetchReader::~CRawlogPrefetchReader() { stop(); }
+
+void CRawlogPrefetchReader::start(mrpt::io::CStream& in)
+{
+	MRPT_START
+
+	stop();
+
+	ASSERT_GT_(entriesQueueCapacity, 0U);
+	ASSERT_GT_(blocksQueueCapacity, 0U);
+	ASSERT_GT_(blockSize, 0U);
+
+	auto& m = *m_impl;
+	m.blocks = std::make_unique<BlockingBoundedQueue<Block>>(
+		blocksQueueCapacity);
+	m.entries =
+		std::make_unique<BlockingBoundedQueue<TEntry>>(entriesQueueCapacity);
+	m.inputPosition = in.getPosition();
+	m.eof = false;
+
+	m.decompressThread = std::thread([this, &in]() {
+		auto& m = *m_impl;
+		try
+		{
+			for (;;)
+			{
+				Block b(blockSize);
+				const size_t n = in.Read(b.data(), b.size());
+				m.inputPosition = in.getPosition();
+				if (!n) break;
+				b.resize(n);
+				if (!m.blocks->push(std::move(b))) return;	// aborted
+			}
+		}
+		catch (const std::exception& e)
+		{
+			std::cerr << "[CRawlogPrefetchReader] Error reading input stream:\n"
+					  << mrpt::exception_to_str(e) << std::endl;
+		}
+		// EOF marker:
+		m.blocks->push(Block());
+	});
+	mrpt::system::thread_name("rawlogDecompress", m.decompressThread);
+
+	m.parseThread = std::thread([this]() {
+		auto& m = *m_impl;
+		CBlockQueueStream blockStream(*m.blocks);
+		auto arch = mrpt::serialization::archiveFrom(blockStream);
+		size_t rawlogEntry = 0;
+		for (;;)
+		{
+			TEntry e;
+			if (!mrpt::obs::CRawlog::getActionObservationPairOrObservation(
+					arch, e.action, e.observations, e.observation,
+					rawlogEntry))
+				break;
+			e.rawlogEntry = rawlogEntry;
+			e.valid = true;
+			if (prefetchExternalImages)
+			{
+				if (e.observation) e.observation->prefetch();
+				if (e.observations)
+					for (const auto& o : *e.observations)
+						if (o) o->prefetch();
+			}
+			if (!m.entries->push(std::move(e))) return;	 // aborted
+		}
+		// No more blocks needed, in case of a parsing error:
+		m.blocks->abort();
+		// EOF marker:
+		m.entries->push(TEntry());
+	});
+	mrpt::system::thread_name("rawlogParse", m.parseThread);
+
+	MRPT_END
+}
+
+void CRawlogPrefetchReader::stop()
+{
+	auto& m = *m_impl;
+	if (m.blocks) m.blocks->abort();
+	if (m.entries) m.entries->abort();
+	if (m.decompressThread.joinable()) m.decompressThread.join();
+	if (m.parseThread.joinable()) m.parseThread.join();
+	m.blocks.reset();
+	m.entries.reset();
+	m.eof = true;
+}
+
+bool CRawlogPrefetchReader::getNextEntry(
+	mrpt::obs::CActionCollection::Ptr& action,
+	mrpt::obs::CSensoryFrame::Ptr& observations,
+	mrpt::obs::CObservation::Ptr& observation, size_t& rawlogEntry)
+{
+	action.reset();
+	observations.reset();
+	observation.reset();
+
+	auto& m = *m_impl;
+	if (m.eof || !m.entries) return false;
+
+	TEntry e;
+	if (!m.entries->pop(e) || !e.valid)
+	{
+		m.eof = true;
+		return false;
+	}
+	action = std::move(e.action);
+	observations = std::move(e.observations);
+	observation = std::move(e.observation);
+	rawlogEntry = e.rawlogEntry;
+	return true;
+}
+
+uint64_t CRawlogPrefetchReader::getInputPosition() const
+{
+	return m_impl->inputPosition;
+}
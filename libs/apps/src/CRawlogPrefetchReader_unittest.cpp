@@ -0,0 +1,131 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/apps/CRawlogPrefetchReader.h>
+#include <mrpt/io/CMemoryStream.h>
+#include <mrpt/obs/CActionRobotMovement2D.h>
+#include <mrpt/obs/CObservation2DRangeScan.h>
+#include <mrpt/obs/CObservationOdometry.h>
+#include <mrpt/obs/stock_observations.h>
+#include <mrpt/serialization/CArchive.h>
+
+using namespace mrpt::obs;
+
+namespace
+{
+// Writes a rawlog mixing the observations-only and the SF/action formats.
+// Returns the timestamps of all observations, in order.
+std::vector<mrpt::Clock::time_point> writeTestRawlog(
+	mrpt::io::CMemoryStream& buf, size_t nEntries)
+{
+	std::vector<mrpt::Clock::time_point> stamps;
+	auto arch = mrpt::serialization::archiveFrom(buf);
+	for (size_t i = 0; i < nEntries; i++)
+	{
+		const auto t = mrpt::Clock::fromDouble(1.0 + i);
+		stamps.push_back(t);
+		if (i % 2 == 0)
+		{
+			auto obs = CObservation2DRangeScan::Create();
+			stock_observations::example2DRangeScan(*obs);
+			obs->timestamp = t;
+			arch << *obs;
+		}
+		else
+		{
+			CActionCollection acts;
+			CActionRobotMovement2D act;
+			act.computeFromOdometry(
+				mrpt::poses::CPose2D(0.1, 0, 0),
+				CActionRobotMovement2D::TMotionModelOptions());
+			acts.insert(act);
+			arch << acts;
+
+			CSensoryFrame sf;
+			auto obs = CObservationOdometry::Create();
+			obs->timestamp = t;
+			sf.insert(obs);
+			arch << sf;
+		}
+	}
+	buf.Seek(0);
+	return stamps;
+}
+}  // namespace
+
+TEST(CRawlogPrefetchReader, ReadInOrder)
+{
+	for (const size_t blockSize :
+		 {size_t(16), size_t(1000), size_t(256 * 1024)})
+	{
+		mrpt::io::CMemoryStream buf;
+		const auto stamps = writeTestRawlog(buf, 50);
+
+		mrpt::apps::CRawlogPrefetchReader reader;
+		reader.blockSize = blockSize;
+		reader.entriesQueueCapacity = 4;
+		reader.blocksQueueCapacity = 2;
+		reader.start(buf);
+
+		CActionCollection::Ptr acts;
+		CSensoryFrame::Ptr sf;
+		CObservation::Ptr obs;
+		size_t rawlogEntry = 0, nEntries = 0, nObjects = 0;
+		while (reader.getNextEntry(acts, sf, obs, rawlogEntry))
+		{
+			ASSERT_LT(nEntries, stamps.size());
+			if (nEntries % 2 == 0)
+			{
+				ASSERT_TRUE(obs);
+				EXPECT_FALSE(acts);
+				EXPECT_FALSE(sf);
+				EXPECT_EQ(obs->timestamp, stamps[nEntries]);
+				nObjects += 1;
+			}
+			else
+			{
+				EXPECT_FALSE(obs);
+				ASSERT_TRUE(acts);
+				ASSERT_TRUE(sf);
+				ASSERT_EQ(sf->size(), 1U);
+				EXPECT_EQ(
+					sf->getObservationByIndex(0)->timestamp, stamps[nEntries]);
+				nObjects += 2;
+			}
+			EXPECT_EQ(rawlogEntry, nObjects);
+			nEntries++;
+		}
+		EXPECT_EQ(nEntries, stamps.size());
+
+		// Once EOF is reached, it keeps returning false:
+		EXPECT_FALSE(reader.getNextEntry(acts, sf, obs, rawlogEntry));
+	}
+}
+
+TEST(CRawlogPrefetchReader, StopBeforeEOF)
+{
+	mrpt::io::CMemoryStream buf;
+	writeTestRawlog(buf, 200);
+
+	mrpt::apps::CRawlogPrefetchReader reader;
+	reader.blockSize = 64;
+	reader.entriesQueueCapacity = 2;
+	reader.start(buf);
+
+	CActionCollection::Ptr acts;
+	CSensoryFrame::Ptr sf;
+	CObservation::Ptr obs;
+	size_t rawlogEntry = 0;
+	EXPECT_TRUE(reader.getNextEntry(acts, sf, obs, rawlogEntry));
+
+	// Must not block, even if the threads are waiting on full queues:
+	reader.stop();
+	EXPECT_FALSE(reader.getNextEntry(acts, sf, obs, rawlogEntry));
+}
@@ -10,7 +10,8 @@
 #include "apps-precomp.h"  // Precompiled headers
 //
 #include <mrpt/apps/DataSourceRawlog.h>
-#include <mrpt/obs/CRawlog.h>
+#include <mrpt/obs/CRawlogSidecarIndex.h>
+#include <mrpt/system/datetime.h>
 
 using namespace mrpt::apps;
 
@@ -22,7 +23,7 @@ bool DataSourceRawlog::impl_get_next_observations(
 	MRPT_START
 
 	// 1st time? Open rawlog:
-	if (!m_rawlog_arch)
+	if (!m_rawlog_opened)
 	{
 		std::string err_msg;
 		if (!m_rawlog_io.open(m_rawlogFileName, err_msg))
@@ -30,19 +31,38 @@ bool DataSourceRawlog::impl_get_next_observations(
 			THROW_EXCEPTION_FMT(
 				"Error opening rawlog file: `%s`", err_msg.c_str());
 		}
-		m_rawlog_arch = mrpt::serialization::archiveUniquePtrFrom(m_rawlog_io);
-
 		MRPT_LOG_INFO_FMT("RAWLOG file: `%s`", m_rawlogFileName.c_str());
+
+		// If there is an up-to-date sidecar index, print a summary and skip
+		// the first entries without parsing them:
+		mrpt::obs::CRawlogSidecarIndex idx;
+		if (idx.load(m_rawlogFileName))
+		{
+			MRPT_LOG_INFO_FMT(
+				"RAWLOG index: %zu entries, %zu sensors, %.03f seconds",
+				idx.entries().size(), idx.sensorSummary().size(),
+				idx.firstTimestamp() != INVALID_TIMESTAMP
+					? mrpt::system::timeDifference(
+						  idx.firstTimestamp(), idx.lastTimestamp())
+					: .0);
+			if (m_rawlog_offset > 1)
+				m_rawlogEntryBase =
+					idx.skipToEntry(m_rawlog_io, m_rawlog_offset - 1);
+		}
+
+		m_rawlog_reader.start(m_rawlog_io);
+		m_rawlog_opened = true;
 	}
 
 	// Read:
 
 	for (;;)
 	{
-		if (!mrpt::obs::CRawlog::getActionObservationPairOrObservation(
-				*m_rawlog_arch, action, observations, observation,
-				m_rawlogEntry))
+		size_t entriesRead = 0;
+		if (!m_rawlog_reader.getNextEntry(
+				action, observations, observation, entriesRead))
 			return false;
+		m_rawlogEntry = m_rawlogEntryBase + entriesRead;
 
 		// Optional skip of first N entries
 		if (m_rawlogEntry < m_rawlog_offset) continue;
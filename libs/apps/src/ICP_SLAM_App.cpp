@@ -70,6 +70,8 @@ void ICP_SLAM_App_Base::run()
 {
 	MRPT_START
 
+	out_step_exec_times.clear();
+
 	using namespace mrpt;
 	using namespace mrpt::slam;
 	using namespace mrpt::obs;
@@ -264,6 +266,7 @@ void ICP_SLAM_App_Base::run()
 		else
 			mapBuilder.processActionObservation(*action, *observations);
 		t_exec = tictac.Tac();
+		out_step_exec_times.push_back(t_exec);
 		MRPT_LOG_INFO_FMT("Map building executed in %.03fms", 1000.0f * t_exec);
 
 		// Info log:
@@ -432,7 +435,8 @@ void ICP_SLAM_App_Base::run()
 		"----------- **END** (total time: %.03f sec) ---------",
 		tictacGlobal.Tac());
 
-	// Save map:
+	// Save map (with asyncMapUpdate, once all keyframes are inserted):
+	mapBuilder.waitForMapUpdates();
 	mapBuilder.getCurrentlyBuiltMap(finalMap);
 
 	{
@@ -65,6 +65,9 @@ void KFSLAMApp::run()
 {
 	MRPT_START
 
+	out_estimated_path.clear();
+	out_step_exec_times.clear();
+
 	// 2D or 3D implementation:
 	const auto kf_implementation = mrpt::system::trim(params.read_string(
 		"MappingApplication", "kf_implementation", "CRangeBearingKFSLAM"));
@@ -415,6 +418,7 @@ void KFSLAMApp::Run_KF_SLAM()
 			mapping.processActionObservation(action, observations);
 
 			const double tim_kf_iter = kftictac.Tac();
+			out_step_exec_times.push_back(tim_kf_iter);
 
 			// Get current state:
 			// -------------------------------
@@ -427,6 +431,7 @@ void KFSLAMApp::Run_KF_SLAM()
 
 			// Build the path:
 			meanPath.push_back(robotPoseMean3D.asTPose());
+			out_estimated_path.push_back(meanPath.back());
 
 			// Save mean pose:
 			if (!(step % SAVE_LOG_FREQUENCY))
@@ -50,6 +50,9 @@ void generic_kf_slam_test(
 
 		// Check results:
 		EXPECT_LT(app.loc_error_wrt_gt, 0.1);
+		EXPECT_FALSE(app.out_estimated_path.empty());
+		EXPECT_EQ(
+			app.out_step_exec_times.size(), app.out_estimated_path.size());
 	}
 	catch (const std::exception& e)
 	{
@@ -80,6 +83,36 @@ TEST(KFSLAMApp, EKF_SLAM_2D)
 		});
 }
 
+TEST(KFSLAMApp, SEIF_SLAM_3D)
+{
+	generic_kf_slam_test(
+		"EKF-SLAM_6D_test.ini", "kf-slam_6D_demo.rawlog",
+		[](mrpt::config::CConfigFileBase& c) {
+			using namespace std::string_literals;
+			c.write("RangeBearingKFSLAM_KalmanFilter", "method", "kfSEIF");
+			c.write(
+				"RangeBearingKFSLAM_KalmanFilter", "SEIF_max_active_landmarks",
+				10);
+			c.write("MappingApplication", "SHOW_3D_LIVE", false);
+			c.write("MappingApplication", "SAVE_3D_SCENES", false);
+		});
+}
+
+TEST(KFSLAMApp, SEIF_SLAM_2D)
+{
+	generic_kf_slam_test(
+		"EKF-SLAM_test_2d.ini", "kf-slam_demo.rawlog",
+		[](mrpt::config::CConfigFileBase& c) {
+			using namespace std::string_literals;
+			c.write("RangeBearingKFSLAM_KalmanFilter", "method", "kfSEIF");
+			c.write(
+				"RangeBearingKFSLAM_KalmanFilter", "SEIF_max_active_landmarks",
+				10);
+			c.write("MappingApplication", "SHOW_3D_LIVE", false);
+			c.write("MappingApplication", "SAVE_3D_SCENES", false);
+		});
+}
+
 TEST(KFSLAMApp, EKF_SLAM_3D_data_assoc_JCBB_Maha)
 {
 	generic_kf_slam_test(
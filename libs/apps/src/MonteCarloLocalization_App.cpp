@@ -12,6 +12,7 @@
 #include <mrpt/apps/MonteCarloLocalization_App.h>
 #include <mrpt/bayes/CParticleFilter.h>
 #include <mrpt/config/CConfigFile.h>
+#include <mrpt/core/WorkerThreadsPool.h>
 #include <mrpt/gui/CDisplayWindow3D.h>
 #include <mrpt/gui/CDisplayWindowPlots.h>
 #include <mrpt/io/CFileGZInputStream.h>
@@ -46,8 +47,11 @@
 #include <mrpt/system/CTicTac.h>
 #include <mrpt/system/filesystem.h>
 #include <mrpt/system/os.h>
+#include <mrpt/system/string_utils.h>
 
 #include <Eigen/Dense>
+#include <future>
+#include <thread>
 
 using namespace mrpt::apps;
 
@@ -161,6 +165,65 @@ struct pf2gauss_t<CMonteCarloLocalization3D>
 	}
 };
 
+// For observation-only rawlogs: builds an auxiliary pair of action-SF, since
+// montecarlo-localization only accepts those pairs as input, with the
+// observation and a dummy odometry increment since the last one used:
+template <class MONTECARLO_TYPE>
+void obsToActionSF(
+	const CObservation::Ptr& obs, const CPose2D& pending_most_recent_odo,
+	CPose2D& last_used_abs_odo,
+	const CActionRobotMovement2D::TMotionModelOptions& actOdom2D_params,
+	const CActionRobotMovement3D::TMotionModelOptions& actOdom3D_params,
+	CActionCollection::Ptr& action, CSensoryFrame::Ptr& observations)
+{
+	// SF: Just one observation:
+	observations = std::make_shared<CSensoryFrame>();
+	observations->insert(obs);
+
+	// ActionCollection: Just one action with a dummy odometry
+	action = std::make_shared<CActionCollection>();
+
+	if (pf2gauss_t<MONTECARLO_TYPE>::PF_IS_3D)
+	{
+		CActionRobotMovement3D actOdom3D;
+
+		const CPose3D odo_incr =
+			CPose3D(pending_most_recent_odo - last_used_abs_odo);
+		last_used_abs_odo = pending_most_recent_odo;
+
+		actOdom3D.computeFromOdometry(odo_incr, actOdom3D_params);
+		action->insert(actOdom3D);
+	}
+	else
+	{
+		CActionRobotMovement2D actOdom2D;
+
+		const CPose2D odo_incr = pending_most_recent_odo - last_used_abs_odo;
+		last_used_abs_odo = pending_most_recent_odo;
+
+		actOdom2D.computeFromOdometry(odo_incr, actOdom2D_params);
+		action->insert(actOdom2D);
+	}
+}
+
+// Averaged distance of the particles to the ground truth, weighted by their
+// normalized weights:
+template <class MONTECARLO_TYPE>
+double particlesErrorToGT(const MONTECARLO_TYPE& pdf, const CPose2D& gt)
+{
+	double sumW = 0;
+	double locErr = 0;
+	for (size_t k = 0; k < pdf.size(); k++)
+		sumW += exp(pdf.getW(k));
+	for (size_t k = 0; k < pdf.size(); k++)
+	{
+		const auto pk = pdf.getParticlePose(k);
+		locErr += mrpt::hypot_fast(gt.x() - pk.x, gt.y() - pk.y) *
+			exp(pdf.getW(k)) / sumW;
+	}
+	return locErr;
+}
+
 template <class MONTECARLO_TYPE>
 void MonteCarloLocalization_Base::do_pf_localization()
 {
@@ -370,6 +433,249 @@ void MonteCarloLocalization_Base::do_pf_localization()
 			(init_max.x - init_min.x) * (init_max.y - init_min.y);
 	}
 
+	// --------------------------------------------------------------------
+	//						BATCH EXPERIMENTS
+	// --------------------------------------------------------------------
+	// All the runs (configurations x particle counts x repetitions) share
+	// the map and the dataset, loaded only once, and run in parallel:
+	if (cfg.read_bool(sect, "batch_mode", false))
+	{
+		const bool initOnFreeSpace =
+			!cfg.read_bool(sect, "init_PDF_mode", false, true);
+		const auto baseSeed =
+			static_cast<uint32_t>(cfg.read_uint64_t(sect, "batch_seed", 1234));
+		size_t numThreads = cfg.read_uint64_t(sect, "batch_threads", 0);
+		if (!numThreads)
+			numThreads = std::max(1U, std::thread::hardware_concurrency());
+
+		// Configurations: PF_options and KLD_options, with the keys of each
+		// section in "batch_configs" replacing theirs:
+		std::vector<std::string> cfgNames;
+		mrpt::system::tokenize(
+			cfg.read_string(sect, "batch_configs", ""), " ,\t", cfgNames);
+		if (cfgNames.empty()) cfgNames.emplace_back();
+
+		struct TBatchRun
+		{
+			std::string config;
+			int particles = 0;
+			size_t repetition = 0;
+			uint32_t seed = 0;
+			CParticleFilter::TParticleFilterOptions pfOptions;
+			TMonteCarloLocalizationParams pdfOptions;
+			// Results:
+			size_t steps = 0, errorSamples = 0;
+			double execTime = 0, meanError = 0, finalError = 0;
+			bool converged = false;
+			std::string errorMsg;
+		};
+		std::vector<TBatchRun> runs;
+		for (const auto& name : cfgNames)
+		{
+			CParticleFilter::TParticleFilterOptions cfgPfOptions = pfOptions;
+			TMonteCarloLocalizationParams cfgPdfOptions = pdfPredictionOptions;
+			if (!name.empty())
+			{
+				ASSERTMSG_(
+					cfg.sectionExists(name),
+					"Missing batch_configs section: " + name);
+				CConfigFileMemory c(cfg.getContent());
+				std::vector<std::string> keys;
+				cfg.getAllKeys(name, keys);
+				for (const auto& k : keys)
+				{
+					const auto v = cfg.read_string(name, k, "");
+					c.write("PF_options", k, v);
+					c.write("KLD_options", k, v);
+				}
+				cfgPfOptions.loadFromConfigFile(c, "PF_options");
+				cfgPdfOptions.KLD_params.loadFromConfigFile(c, "KLD_options");
+			}
+			// Runs are parallelized instead, so each one only depends on its
+			// seed:
+			cfgPfOptions.numThreads = 1;
+
+			for (int PARTICLE_COUNT : particles_count)
+				for (size_t rep = 0; rep < NUM_REPS; rep++)
+				{
+					TBatchRun r;
+					r.config = name.empty() ? "default" : name;
+					r.particles = PARTICLE_COUNT;
+					r.repetition = rep;
+					// The same seeds for all configurations:
+					r.seed = baseSeed + static_cast<uint32_t>(rep);
+					r.pfOptions = cfgPfOptions;
+					r.pdfOptions = cfgPdfOptions;
+					runs.push_back(std::move(r));
+				}
+		}
+
+		// Load the whole dataset, as pairs of action-SF:
+		struct TBatchStep
+		{
+			CActionCollection::Ptr action;
+			CSensoryFrame::Ptr observations;
+			Clock::time_point timestamp = INVALID_TIMESTAMP;
+		};
+		std::vector<TBatchStep> dataset;
+		{
+			CPose2D last_used_abs_odo(0, 0, 0),
+				pending_most_recent_odo(0, 0, 0);
+			bool is_1st_odo = true;
+			for (;;)
+			{
+				TBatchStep s;
+				CObservation::Ptr obs;
+				if (!impl_get_next_observations(s.action, s.observations, obs))
+					break;
+				if (obs)
+				{
+					if (auto odo = std::dynamic_pointer_cast<
+							CObservationOdometry>(obs);
+						odo)
+					{
+						pending_most_recent_odo = odo->odometry;
+						if (is_1st_odo) last_used_abs_odo = odo->odometry;
+						is_1st_odo = false;
+						continue;
+					}
+					obsToActionSF<MONTECARLO_TYPE>(
+						obs, pending_most_recent_odo, last_used_abs_odo,
+						actOdom2D_params, actOdom3D_params, s.action,
+						s.observations);
+				}
+				if (s.observations->size() > 0)
+					s.timestamp =
+						s.observations->getObservationByIndex(0)->timestamp;
+				dataset.push_back(std::move(s));
+			}
+		}
+
+		// Fill the caches of the map and observations now, so they are only
+		// read while the filters run concurrently:
+		for (const auto& m : metricMap->maps)
+			if (auto grid = std::dynamic_pointer_cast<COccupancyGridMap2D>(m);
+				grid)
+				grid->precomputeLikelihoodCache();
+		for (const auto& s : dataset)
+			metricMap->computeObservationsLikelihood(
+				*s.observations, CPose3D());
+
+		MRPT_LOG_INFO_STREAM(
+			"Batch mode: " << runs.size() << " runs of " << dataset.size()
+						   << " steps, on " << numThreads << " threads.");
+
+		auto lmbRun = [&](TBatchRun& r) {
+			getRandomGenerator().randomize(r.seed);
+
+			MONTECARLO_TYPE pdf;
+			pdf.options = r.pdfOptions;
+			pdf.options.metricMap = metricMap;
+
+			CParticleFilter PF;
+			PF.m_options = r.pfOptions;
+			PF.setMinLoggingLevel(mrpt::system::LVL_WARN);
+
+			if (initOnFreeSpace)
+				pf2gauss_t<MONTECARLO_TYPE>::resetOnFreeSpace(
+					pdf, *metricMap, r.particles, init_min, init_max);
+			else
+				pf2gauss_t<MONTECARLO_TYPE>::resetUniform(
+					pdf, r.particles, init_min, init_max);
+
+			CParticleFilter::TParticleFilterStats stats;
+			typename MONTECARLO_TYPE::type_value pdfEstimation;
+			CPose2D expectedPose;  // Ground truth
+			bool hasGT = false;
+			CTicTac tic;
+			for (size_t step = 0; step < dataset.size(); step++)
+			{
+				const auto& s = dataset[step];
+				if (step < rawlog_offset) continue;
+				// As in regular runs, not executed at the first step:
+				if (step > rawlog_offset)
+				{
+					tic.Tic();
+					PF.executeOn(
+						pdf, s.action.get(), s.observations.get(), &stats);
+					r.execTime += tic.Tac();
+					r.steps++;
+				}
+				pdf.getMean(pdfEstimation);
+
+				expectedPose = CPose2D();
+				getGroundTruth(expectedPose, step, GT, s.timestamp);
+				hasGT = expectedPose.x() != 0 || expectedPose.y() != 0 ||
+					expectedPose.phi() != 0;
+				if (hasGT)
+				{
+					r.finalError = particlesErrorToGT(pdf, expectedPose);
+					r.meanError += r.finalError;
+					r.errorSamples++;
+				}
+				if (step == testConvergenceAt) break;
+			}
+			if (r.errorSamples) r.meanError /= r.errorSamples;
+			r.converged = sqrt(pdf.getCovariance().det()) < 2 &&
+				(!hasGT || pdfEstimation.distanceTo(expectedPose) < 2);
+		};
+
+		CTicTac tictacGlobal;
+		tictacGlobal.Tic();
+		{
+			mrpt::WorkerThreadsPool pool(
+				numThreads, mrpt::WorkerThreadsPool::POLICY_FIFO, "pf-batch");
+			std::vector<std::future<void>> futures;
+			for (auto& r : runs)
+				futures.emplace_back(pool.enqueue([&lmbRun, &r]() {
+					try
+					{
+						lmbRun(r);
+					}
+					catch (const std::exception& e)
+					{
+						r.errorMsg = mrpt::exception_to_str(e);
+					}
+				}));
+			for (auto& f : futures)
+				f.get();
+		}
+		MRPT_LOG_INFO_FMT(
+			"Total execution time: %.06f sec", tictacGlobal.Tac());
+
+		// The results table:
+		const auto resultsFile = OUT_DIR_PREFIX + "_BATCH_RESULTS.txt";
+		CFileOutputStream f;
+		if (!f.open(resultsFile))
+			THROW_EXCEPTION_FMT(
+				"Cannot create results file: '%s'", resultsFile.c_str());
+		f.printf(
+			"%% config  #particles  repetition  seed  steps  "
+			"average_time_per_step  mean_error  final_error  converged\n");
+		for (const auto& r : runs)
+		{
+			if (!r.errorMsg.empty())
+			{
+				MRPT_LOG_ERROR_STREAM(
+					"Run '" << r.config << "' " << r.particles << " particles, "
+							<< "repetition " << r.repetition
+							<< " failed: " << r.errorMsg);
+				continue;
+			}
+			f.printf(
+				"%s %i %u %u %u %e %f %f %i\n", r.config.c_str(), r.particles,
+				static_cast<unsigned int>(r.repetition),
+				static_cast<unsigned int>(r.seed),
+				static_cast<unsigned int>(r.steps),
+				r.steps ? r.execTime / r.steps : .0,
+				r.errorSamples ? r.meanError : std::nan(""),
+				r.errorSamples ? r.finalError : std::nan(""),
+				r.converged ? 1 : 0);
+		}
+		MRPT_LOG_INFO_STREAM("Batch results saved to: " << resultsFile);
+		return;
+	}
+
 	for (int PARTICLE_COUNT : particles_count)
 	{
 		MRPT_LOG_INFO_FMT(
@@ -579,40 +885,10 @@ void MonteCarloLocalization_Base::do_pf_localization()
 					}
 					else
 					{
-						// SF: Just one observation:
-						// ------------------------------------------------------
-						observations = std::make_shared<CSensoryFrame>();
-						observations->insert(obs);
-
-						// ActionCollection: Just one action with a dummy
-						// odometry
-						// ------------------------------------------------------
-						action = std::make_shared<CActionCollection>();
-
-						if (pf2gauss_t<MONTECARLO_TYPE>::PF_IS_3D)
-						{
-							CActionRobotMovement3D actOdom3D;
-
-							const CPose3D odo_incr = CPose3D(
-								pending_most_recent_odo - last_used_abs_odo);
-							last_used_abs_odo = pending_most_recent_odo;
-
-							actOdom3D.computeFromOdometry(
-								odo_incr, actOdom3D_params);
-							action->insert(actOdom3D);
-						}
-						else
-						{
-							CActionRobotMovement2D actOdom2D;
-
-							const CPose2D odo_incr =
-								pending_most_recent_odo - last_used_abs_odo;
-							last_used_abs_odo = pending_most_recent_odo;
-
-							actOdom2D.computeFromOdometry(
-								odo_incr, actOdom2D_params);
-							action->insert(actOdom2D);
-						}
+						obsToActionSF<MONTECARLO_TYPE>(
+							obs, pending_most_recent_odo, last_used_abs_odo,
+							actOdom2D_params, actOdom3D_params, action,
+							observations);
 					}
 				}
 				else
@@ -767,6 +1043,9 @@ void MonteCarloLocalization_Base::do_pf_localization()
 
 					double run_time = tictac.Tac();
 					executionTimes.push_back(run_time);
+					convergenceErrors_mtx.lock();
+					out_step_exec_times.push_back(run_time);
+					convergenceErrors_mtx.unlock();
 					if (!SAVE_STATS_ONLY)
 					{
 						MRPT_LOG_INFO_FMT(
@@ -802,18 +1081,7 @@ void MonteCarloLocalization_Base::do_pf_localization()
 				if (expectedPose.x() != 0 || expectedPose.y() != 0 ||
 					expectedPose.phi() != 0)
 				{  // Averaged error to GT
-					double sumW = 0;
-					double locErr = 0;
-					for (size_t k = 0; k < pdf.size(); k++)
-						sumW += exp(pdf.getW(k));
-					for (size_t k = 0; k < pdf.size(); k++)
-					{
-						const auto pk = pdf.getParticlePose(k);
-						locErr += mrpt::hypot_fast(
-									  expectedPose.x() - pk.x,
-									  expectedPose.y() - pk.y) *
-							exp(pdf.getW(k)) / sumW;
-					}
+					const double locErr = particlesErrorToGT(pdf, expectedPose);
 					convergenceErrors_mtx.lock();
 					convergenceErrors.push_back(locErr);
 					convergenceErrors_mtx.unlock();
@@ -1230,6 +1498,8 @@ void MonteCarloLocalization_Base::run()
 {
 	MRPT_START
 
+	out_step_exec_times.clear();
+
 	// Detect 2D vs 3D particle filter?
 	const bool is_3D = params.read_bool(sect, "use_3D_poses", false);
 
@@ -71,6 +71,8 @@ void RBPF_SLAM_App_Base::run()
 {
 	MRPT_START
 
+	out_step_exec_times.clear();
+
 	using namespace mrpt;
 	using namespace mrpt::slam;
 	using namespace mrpt::obs;
@@ -323,6 +325,7 @@ void RBPF_SLAM_App_Base::run()
 		tictac.Tic();
 		mapBuilder->processActionObservation(*action, *observations);
 		t_exec = tictac.Tac();
+		out_step_exec_times.push_back(t_exec);
 		MRPT_LOG_INFO_FMT("Map building executed in %.03fms", 1000.0f * t_exec);
 
 		// Info log:
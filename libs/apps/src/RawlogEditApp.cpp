@@ -67,7 +67,9 @@ DECLARE_OP_FUNCTION(op_export_imu_txt);
 DECLARE_OP_FUNCTION(op_export_odometry_txt);
 // ^^^
 
+DECLARE_OP_FUNCTION(op_build_index);
 DECLARE_OP_FUNCTION(op_externalize);
+DECLARE_OP_FUNCTION(op_from_indexed);
 DECLARE_OP_FUNCTION(op_generate_3d_pointclouds);
 DECLARE_OP_FUNCTION(op_info);
 DECLARE_OP_FUNCTION(op_keep_label);
@@ -76,11 +78,13 @@ DECLARE_OP_FUNCTION(op_list_poses);
 DECLARE_OP_FUNCTION(op_list_rangebearing);
 DECLARE_OP_FUNCTION(op_list_timestamps);
 DECLARE_OP_FUNCTION(op_recalc_odometry);
+DECLARE_OP_FUNCTION(op_recompress);
 DECLARE_OP_FUNCTION(op_remap_timestamps);
 DECLARE_OP_FUNCTION(op_remove_label);
 DECLARE_OP_FUNCTION(op_rename_externals);
 DECLARE_OP_FUNCTION(op_sensors_pose);
 DECLARE_OP_FUNCTION(op_stereo_rectify);
+DECLARE_OP_FUNCTION(op_to_indexed);
 DECLARE_OP_FUNCTION(op_undistort);
 
 // Declare the supported command line switches ===========
@@ -166,6 +170,21 @@ TCLAP::ValueArg<double> arg_odo_D(
 	"Distance between left-right wheels (meters), used in --recalc-odometry.",
 	false, 0, "D", cmd);
 
+TCLAP::ValueArg<int> arg_compress_level(
+	"", "compress-level",
+	"Compression level for --recompress (Default: 1 for gz, 3 for zstd).",
+	false, 0, "LEVEL", cmd);
+TCLAP::ValueArg<int> arg_compress_threads(
+	"", "compress-threads",
+	"Number of worker threads for --recompress in zstd format (Default: 0).",
+	false, 0, "N", cmd);
+TCLAP::ValueArg<size_t> arg_threads(
+	"", "threads",
+	"Number of threads to process observations in parallel, in --externalize, "
+	"--undistort, --stereo-rectify, --generate-3d-pointclouds, --remove-label "
+	"and --keep-label (Default: 1. 0: as many as hardware threads).",
+	false, 1, "N", cmd);
+
 TCLAP::SwitchArg arg_overwrite(
 	"w", "overwrite", "Force overwrite target file without prompting.", cmd,
 	false);
@@ -196,7 +215,9 @@ void RawlogEditApp::run(int argc, const char** argv)
 	ops_functors["de-externalize"] = &op_deexternalize;
 
 	arg_ops.push_back(std::make_unique<TCLAP::SwitchArg>(
-		"", "info", "Op: parse input file and dump information and statistics.",
+		"", "info",
+		"Op: parse input file and dump information and statistics (from "
+		"its sidecar index, see --build-index).",
 		cmd, false));
 	ops_functors["info"] = &op_info;
 
@@ -213,7 +234,9 @@ void RawlogEditApp::run(int argc, const char** argv)
 		"Op: dump a list of all the poses of the observations in the "
 		"dataset.\n"
 		"Optionally the output text file can be changed with "
-		"--text-file-output.",
+		"--text-file-output. If its extension is `.traj`, the sensor poses "
+		"are saved by timestamp as a binary trajectory file instead (see "
+		"mrpt::poses::CTrajectoryMappedFile).",
 		cmd, false));
 	ops_functors["list-poses"] = &op_list_poses;
 
@@ -470,6 +493,45 @@ void RawlogEditApp::run(int argc, const char** argv)
 		cmd, false));
 	ops_functors["describe"] = &op_describe;
 
+	arg_ops.push_back(std::make_unique<TCLAP::SwitchArg>(
+		"", "to-indexed",
+		"Op: Converts the input rawlog into a chunked, indexed rawlog file "
+		"with random access (see mrpt::obs::CRawlogIndexedFile).\n"
+		"Requires: -o (or --output)\n",
+		cmd, false));
+	ops_functors["to-indexed"] = &op_to_indexed;
+
+	arg_ops.push_back(std::make_unique<TCLAP::SwitchArg>(
+		"", "from-indexed",
+		"Op: Converts an indexed rawlog file (see --to-indexed) back into a "
+		"regular rawlog file. Only the given range is read from the input.\n"
+		"Requires: -o (or --output)\n"
+		"Optional: --from-index, --from-time, --to-index, --to-time.\n",
+		cmd, false));
+	ops_functors["from-indexed"] = &op_from_indexed;
+
+	arg_ops.push_back(std::make_unique<TCLAP::ValueArg<std::string>>(
+		"", "recompress",
+		"Op: Writes all the entries of the input rawlog into a new file "
+		"compressed in the given format: 'gz' (gzip) or 'zstd' (Zstandard, "
+		"much faster to decompress). The input format (plain, gz or zstd) "
+		"is auto-detected.\n"
+		"Requires: -o (or --output)\n"
+		"Optional: --compress-level, --compress-threads.\n",
+		false, "", "gz|zstd", cmd));
+	ops_functors["recompress"] = &op_recompress;
+
+	arg_ops.push_back(std::make_unique<TCLAP::SwitchArg>(
+		"", "build-index",
+		"Op: (re)generates the sidecar index of the input rawlog "
+		"(`<input>.idx`, see mrpt::obs::CRawlogSidecarIndex), with the "
+		"offset, timestamp, class and sensor label of every entry. It is "
+		"also generated by --info and --list-timestamps on their first run, "
+		"and used, while up to date, by those operations and by --cut to "
+		"skip the entries before the cut.\n",
+		cmd, false));
+	ops_functors["build-index"] = &op_build_index;
+
 	// --------------- End of list of possible operations --------
 
 	// Parse arguments:
@@ -16,12 +16,12 @@
 #include <mrpt/core/round.h>
 #include <mrpt/hwdrivers/CGenericSensor.h>
 #include <mrpt/img/CImage.h>
-#include <mrpt/io/CFileGZOutputStream.h>
 #include <mrpt/io/vector_loadsave.h>
 #include <mrpt/obs/CActionCollection.h>
 #include <mrpt/obs/CActionRobotMovement2D.h>
 #include <mrpt/obs/CObservationGPS.h>
 #include <mrpt/obs/CObservationIMU.h>
+#include <mrpt/obs/CObservationIMUBatch.h>
 #include <mrpt/obs/CObservationOdometry.h>
 #include <mrpt/obs/CSensoryFrame.h>
 #include <mrpt/serialization/CArchive.h>
@@ -100,6 +100,8 @@ void RawlogGrabberApp::runImpl()
 	bool use_sensoryframes = false;
 	int GRABBER_PERIOD_MS = 1000;
 	int rawlog_GZ_compress_level = 1;  // 0: No compress, 1-9: compress level
+	int writer_threads = 0;	 // 0: all hardware threads
+	double writer_stats_period = 5.0;  // seconds, 0: disabled
 
 	MRPT_LOAD_CONFIG_VAR(rawlog_prefix, string, params, GLOBAL_SECT);
 	MRPT_LOAD_CONFIG_VAR(time_between_launches, int, params, GLOBAL_SECT);
@@ -108,6 +110,8 @@ void RawlogGrabberApp::runImpl()
 	MRPT_LOAD_CONFIG_VAR(GRABBER_PERIOD_MS, int, params, GLOBAL_SECT);
 
 	MRPT_LOAD_CONFIG_VAR(rawlog_GZ_compress_level, int, params, GLOBAL_SECT);
+	MRPT_LOAD_CONFIG_VAR(writer_threads, int, params, GLOBAL_SECT);
+	MRPT_LOAD_CONFIG_VAR(writer_stats_period, double, params, GLOBAL_SECT);
 
 	// Build full rawlog file name:
 	string rawlog_postfix = "_";
@@ -167,18 +171,17 @@ void RawlogGrabberApp::runImpl()
 	// ----------------------------------------------
 	// Run:
 	// ----------------------------------------------
-	mrpt::io::CFileGZOutputStream out_file;
-	auto out_arch_obj = archiveFrom(out_file);
-	m_out_arch_ptr = &out_arch_obj;
-
-	out_file.open(rawlog_filename, rawlog_GZ_compress_level);
+	m_writer.numThreads = static_cast<size_t>(std::max(0, writer_threads));
+	m_writer.open(rawlog_filename, rawlog_GZ_compress_level);
 
 	CGenericSensor::TListObservations copy_of_m_global_list_obs;
 
 	MRPT_LOG_INFO_STREAM("Press any key to exit program");
 
-	mrpt::system::CTicTac run_timer;
+	mrpt::system::CTicTac run_timer, stats_timer;
 	run_timer.Tic();
+	stats_timer.Tic();
+	auto last_stats = m_writer.getSourceStats();
 
 	auto lambdaProcessPending = [&]() {
 		auto lock = mrpt::lockHelper(cs_m_global_list_obs);
@@ -209,6 +212,13 @@ void RawlogGrabberApp::runImpl()
 		// See if we have observations and process them:
 		lambdaProcessPending();
 
+		if (writer_stats_period > 0 && stats_timer.Tac() >= writer_stats_period)
+		{
+			dump_writer_stats(last_stats, stats_timer.Tac());
+			last_stats = m_writer.getSourceStats();
+			stats_timer.Tic();
+		}
+
 		std::this_thread::sleep_for(
 			std::chrono::milliseconds(GRABBER_PERIOD_MS));
 	}
@@ -223,8 +233,8 @@ void RawlogGrabberApp::runImpl()
 	// Final check of pending objects:
 	lambdaProcessPending();
 
-	// Flush file to disk:
-	out_file.close();
+	// Wait for pending objects and flush file to disk:
+	m_writer.close();
 
 	// Wait all threads:
 	// ----------------------------
@@ -278,6 +288,15 @@ void RawlogGrabberApp::dump_verbose_info(
 	{
 		dump_IMU_info(*imu);
 	}
+	else if (auto imuBatch =
+				 std::dynamic_pointer_cast<mrpt::obs::CObservationIMUBatch>(o);
+			 imuBatch && !imuBatch->empty())
+	{
+		// Show the last sample:
+		mrpt::obs::CObservationIMU lastImu;
+		imuBatch->getSample(imuBatch->size() - 1, lastImu);
+		dump_IMU_info(lastImu);
+	}
 }
 
 void RawlogGrabberApp::dump_verbose_info(
@@ -318,6 +337,32 @@ void RawlogGrabberApp::dump_GPS_mode_info(
 	}
 }
 
+void RawlogGrabberApp::dump_writer_stats(
+	const std::map<std::string, CRawlogPipelinedWriter::TSourceStats>& last,
+	double period) const
+{
+	std::string s = mrpt::format(
+		"Writer: %u objects and %u chunks pending, %.03f MB written. "
+		"Per source:",
+		static_cast<unsigned int>(m_writer.getPendingObjects()),
+		static_cast<unsigned int>(m_writer.getPendingChunks()),
+		m_writer.getFileBytes() * 1e-6);
+
+	for (const auto& [source, st] : m_writer.getSourceStats())
+	{
+		CRawlogPipelinedWriter::TSourceStats prev;
+		if (auto it = last.find(source); it != last.end()) prev = it->second;
+
+		s += mrpt::format(
+			"\n  %-20s: %8.02f obj/s, %8.03f MB/s, %5u pending",
+			source.c_str(),
+			(st.writtenObjects - prev.writtenObjects) / period,
+			(st.writtenBytes - prev.writtenBytes) * 1e-6 / period,
+			static_cast<unsigned int>(st.pendingObjects));
+	}
+	MRPT_LOG_INFO(s);
+}
+
 void RawlogGrabberApp::dump_IMU_info(const mrpt::obs::CObservationIMU& o) const
 {
 	// Show IMU angles:
@@ -421,7 +466,7 @@ void RawlogGrabberApp::process_observations_for_sf(
 		{
 			CAction::Ptr act = std::dynamic_pointer_cast<CAction>(it->second);
 
-			(*m_out_arch_ptr) << m_curSF;
+			m_writer.write(std::make_shared<CSensoryFrame>(m_curSF));
 			MRPT_LOG_INFO_STREAM(
 				"Saved SF with " << m_curSF.size() << " objects.");
 			m_curSF.clear();
@@ -430,7 +475,7 @@ void RawlogGrabberApp::process_observations_for_sf(
 			acts.insert(*act);
 			act.reset();
 
-			(*m_out_arch_ptr) << acts;
+			m_writer.write(std::make_shared<CActionCollection>(acts));
 		}
 		else if (IS_CLASS(*it->second, CObservationOdometry))
 		{
@@ -475,7 +520,7 @@ void RawlogGrabberApp::process_observations_for_sf(
 			act->hasVelocities = true;
 			act->velocityLocal = odom->velocityLocal;
 
-			(*m_out_arch_ptr) << m_curSF;
+			m_writer.write(std::make_shared<CSensoryFrame>(m_curSF));
 
 			MRPT_LOG_INFO_STREAM(
 				"Saved SF with " << m_curSF.size() << " objects.");
@@ -485,7 +530,7 @@ void RawlogGrabberApp::process_observations_for_sf(
 			acts.insert(*act);
 			act.reset();
 
-			(*m_out_arch_ptr) << acts;
+			m_writer.write(std::make_shared<CActionCollection>(acts));
 			{
 				auto lk = mrpt::lockHelper(results_mtx);
 				rawlog_saved_objects += 2;	// m_curSF + acts;
@@ -506,7 +551,7 @@ void RawlogGrabberApp::process_observations_for_sf(
 				dump_verbose_info(m_curSF);
 
 				// Save and start a new one:
-				(*m_out_arch_ptr) << m_curSF;
+				m_writer.write(std::make_shared<CSensoryFrame>(m_curSF));
 				{
 					auto lk = mrpt::lockHelper(results_mtx);
 					rawlog_saved_objects++;
@@ -536,7 +581,7 @@ void RawlogGrabberApp::process_observations_for_nonsf(
 	for (auto& ob : list_obs)
 	{
 		auto& obj_ptr = ob.second;
-		(*m_out_arch_ptr) << *obj_ptr;
+		m_writer.write(obj_ptr);
 		{
 			auto lk = mrpt::lockHelper(results_mtx);
 			rawlog_saved_objects++;
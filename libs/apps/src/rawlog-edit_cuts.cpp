@@ -9,6 +9,7 @@
 
 #include "apps-precomp.h"  // Precompiled headers
 //
+#include <mrpt/obs/CRawlogSidecarIndex.h>
 
 #include "rawlog-edit-declarations.h"
 
@@ -130,6 +131,31 @@ DECLARE_OP_FUNCTION(op_cut)
 	TOutputRawlogCreator outrawlog;
 	CRawlogProcessor_Cut proc(
 		in_rawlog, cmdline, verbose, outrawlog.out_rawlog_io);
+
+	// If the dataset has a sidecar index, skip the entries before the cut
+	// without parsing them:
+	size_t from_index = 0;
+	double from_time = 0;
+	const bool has_from_index =
+		getArgValue<size_t>(cmdline, "from-index", from_index);
+	const bool has_from_time =
+		getArgValue<double>(cmdline, "from-time", from_time);
+	string inFile;
+	getArgValue<string>(cmdline, "input", inFile);
+
+	CRawlogSidecarIndex idx;
+	if ((has_from_index || has_from_time) && idx.load(inFile))
+	{
+		size_t first = has_from_index ? from_index : 0;
+		if (has_from_time)
+			first = std::max(
+				first,
+				idx.findEntryByTimestamp(mrpt::Clock::fromDouble(from_time)));
+		proc.m_firstRawlogEntry = idx.skipToEntry(in_rawlog, first);
+		VERBOSE_COUT << "Skipped " << proc.m_firstRawlogEntry
+					 << " entries using the sidecar index.\n";
+	}
+
 	proc.doProcessRawlog();
 
 	// Dump statistics:
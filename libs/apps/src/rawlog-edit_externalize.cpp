@@ -41,8 +41,8 @@ DECLARE_OP_FUNCTION(op_externalize)
 		bool m_external_txt{false};
 
 	   public:
-		size_t entries_converted;
-		size_t entries_skipped;	 // Already external
+		std::atomic<size_t> entries_converted;
+		std::atomic<size_t> entries_skipped;  // Already external
 
 		CRawlogProcessor_Externalize(
 			CFileGZInputStream& in_rawlog, TCLAP::CmdLine& cmdline,
@@ -237,6 +237,7 @@ DECLARE_OP_FUNCTION(op_externalize)
 	// Process
 	// ---------------------------------
 	CRawlogProcessor_Externalize proc(in_rawlog, cmdline, verbose);
+	getArgValue<size_t>(cmdline, "threads", proc.m_numThreads);
 	proc.doProcessRawlog();
 
 	// Dump statistics:
@@ -65,6 +65,7 @@ DECLARE_OP_FUNCTION(op_remove_label)
 	TOutputRawlogCreator outrawlog;
 	CRawlogProcessor_RemoveLabel proc(
 		in_rawlog, cmdline, verbose, outrawlog.out_rawlog_io, filter_label);
+	getArgValue<size_t>(cmdline, "threads", proc.m_numThreads);
 	proc.doProcessRawlog();
 
 	// Dump statistics:
@@ -123,6 +124,7 @@ DECLARE_OP_FUNCTION(op_keep_label)
 	TOutputRawlogCreator outrawlog;
 	CRawlogProcessor_KeepLabel proc(
 		in_rawlog, cmdline, verbose, outrawlog.out_rawlog_io, filter_label);
+	getArgValue<size_t>(cmdline, "threads", proc.m_numThreads);
 	proc.doProcessRawlog();
 
 	// Dump statistics:
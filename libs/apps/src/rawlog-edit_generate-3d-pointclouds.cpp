@@ -33,7 +33,7 @@ DECLARE_OP_FUNCTION(op_generate_3d_pointclouds)
 		TOutputRawlogCreator outrawlog;
 
 	   public:
-		size_t entries_modified;
+		std::atomic<size_t> entries_modified;
 
 		CRawlogProcessor_Generate3DPointClouds(
 			CFileGZInputStream& in_rawlog, TCLAP::CmdLine& cmdline,
@@ -78,6 +78,7 @@ DECLARE_OP_FUNCTION(op_generate_3d_pointclouds)
 	// Process
 	// ---------------------------------
 	CRawlogProcessor_Generate3DPointClouds proc(in_rawlog, cmdline, verbose);
+	getArgValue<size_t>(cmdline, "threads", proc.m_numThreads);
 	proc.doProcessRawlog();
 
 	// Dump statistics:
@@ -0,0 +1,146 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "apps-precomp.h"  // Precompiled headers
+//
+
+#include <mrpt/obs/CRawlogIndexedFile.h>
+#include <mrpt/obs/CRawlogSidecarIndex.h>
+#include <mrpt/serialization/CArchive.h>
+#include <mrpt/system/CTicTac.h>
+
+#include "rawlog-edit-declarations.h"
+
+using namespace mrpt;
+using namespace mrpt::obs;
+using namespace mrpt::system;
+using namespace mrpt::apps;
+using namespace std;
+using namespace mrpt::io;
+
+namespace
+{
+std::string getOutputFileName(TCLAP::CmdLine& cmdline)
+{
+	std::string out;
+	if (!getArgValue<string>(cmdline, "output", out))
+		throw runtime_error(
+			"This operation requires an output file. Use '-o file' or "
+			"'--output file'.");
+	if (fileExists(out) && !isFlagSet(cmdline, "overwrite"))
+		throw runtime_error(
+			string("*ABORTING*: Output file already exists: ") + out +
+			string("\n. Select a different output path, remove the file or "
+				   "force overwrite with '-w' or '--overwrite'."));
+	return out;
+}
+}  // namespace
+
+// ======================================================================
+//		op_to_indexed
+// ======================================================================
+DECLARE_OP_FUNCTION(op_to_indexed)
+{
+	const std::string outFile = getOutputFileName(cmdline);
+
+	CRawlogIndexedFileWriter out;
+	if (!out.open(outFile))
+		throw runtime_error(
+			string("*ABORTING*: Cannot open output file: ") + outFile);
+
+	CTicTac tictac;
+	auto arch = mrpt::serialization::archiveFrom(in_rawlog);
+	for (;;)
+	{
+		mrpt::serialization::CSerializable::Ptr obj;
+		try
+		{
+			obj = arch.ReadObject();
+		}
+		catch (const mrpt::serialization::CExceptionEOF&)
+		{
+			break;
+		}
+		if (obj) out.write(obj);
+	}
+	out.close();
+
+	VERBOSE_COUT << "Time to process file (sec)        : " << tictac.Tac()
+				 << "\n";
+	VERBOSE_COUT << "Entries written                   : " << out.size()
+				 << "\n";
+}
+
+// ======================================================================
+//		op_from_indexed
+// ======================================================================
+DECLARE_OP_FUNCTION(op_from_indexed)
+{
+	std::string inFile;
+	getArgValue<string>(cmdline, "input", inFile);
+
+	CRawlogIndexedFile in;
+	if (!in.open(inFile))
+		throw runtime_error(
+			string("*ABORTING*: Not a valid indexed rawlog file: ") + inFile);
+
+	// Optional range, found without parsing the dataset:
+	size_t idx0 = 0, idx1 = in.size() ? in.size() - 1 : 0;
+	double t0 = 0, t1 = 0;
+	getArgValue<size_t>(cmdline, "from-index", idx0);
+	getArgValue<size_t>(cmdline, "to-index", idx1);
+	const bool has_t0 = getArgValue<double>(cmdline, "from-time", t0);
+	const bool has_t1 = getArgValue<double>(cmdline, "to-time", t1);
+	if (has_t0) idx0 = in.findByTimestamp(mrpt::Clock::fromDouble(t0));
+	if (has_t1)
+	{
+		const size_t i = in.findByTimestamp(mrpt::Clock::fromDouble(t1));
+		if (i < in.size()) idx1 = i;
+	}
+
+	const std::string outFile = getOutputFileName(cmdline);
+	CFileGZOutputStream out_io;
+	if (!out_io.open(outFile))
+		throw runtime_error(
+			string("*ABORTING*: Cannot open output file: ") + outFile);
+	auto out = mrpt::serialization::archiveFrom(out_io);
+
+	CTicTac tictac;
+	size_t nWritten = 0;
+	for (size_t i = idx0; i <= idx1 && i < in.size(); i++, nWritten++)
+		out << *in.getEntry(i);
+
+	VERBOSE_COUT << "Time to process file (sec)        : " << tictac.Tac()
+				 << "\n";
+	VERBOSE_COUT << "Entries written                   : " << nWritten << "\n";
+}
+
+// ======================================================================
+//		op_build_index
+// ======================================================================
+DECLARE_OP_FUNCTION(op_build_index)
+{
+	std::string inFile;
+	getArgValue<string>(cmdline, "input", inFile);
+
+	CTicTac tictac;
+	CRawlogSidecarIndex idx;
+	idx.build(inFile);
+	if (!idx.save())
+		throw runtime_error(
+			string("*ABORTING*: Cannot write index file: ") +
+			CRawlogSidecarIndex::SidecarFileName(inFile));
+
+	VERBOSE_COUT << "Time to process file (sec)        : " << tictac.Tac()
+				 << "\n";
+	VERBOSE_COUT << "Entries indexed                   : "
+				 << idx.entries().size() << "\n";
+	VERBOSE_COUT << "Index file                        : "
+				 << CRawlogSidecarIndex::SidecarFileName(inFile) << "\n";
+}
@@ -9,6 +9,10 @@
 
 #include "apps-precomp.h"  // Precompiled headers
 //
+#include <mrpt/poses/CTrajectoryMappedFile.h>
+
+#include <optional>
+
 #include "rawlog-edit-declarations.h"
 
 using namespace mrpt;
@@ -31,6 +35,8 @@ DECLARE_OP_FUNCTION(op_list_poses)
 	   protected:
 		string m_out_file;
 		std::ofstream m_out;
+		/** The sensor poses by timestamp, for ".traj" output files */
+		std::optional<CPose3DInterpolator> m_traj;
 
 	   public:
 		CRawlogProcessor_ListPoses(
@@ -41,6 +47,12 @@ DECLARE_OP_FUNCTION(op_list_poses)
 			getArgValue<std::string>(cmdline, "text-file-output", m_out_file);
 			VERBOSE_COUT << "Writing list to: " << m_out_file << endl;
 
+			if (mrpt::system::extractFileExtension(m_out_file) == "traj")
+			{
+				m_traj.emplace();
+				return;
+			}
+
 			m_out.open(m_out_file.c_str());
 
 			if (!m_out.is_open())
@@ -52,16 +64,27 @@ DECLARE_OP_FUNCTION(op_list_poses)
 		{
 			mrpt::poses::CPose3D pose;
 			obs->getSensorPose(pose);
-			m_out << pose.asString() << std::endl;
+			if (m_traj) m_traj->insert(obs->timestamp, pose.asTPose());
+			else
+				m_out << pose.asString() << std::endl;
 
 			return true;
 		}
+
+		void saveTrajectory()
+		{
+			if (!m_traj) return;
+			CTrajectoryMappedFile::Save(*m_traj, m_out_file);
+			VERBOSE_COUT << "Saved " << m_traj->size()
+						 << " timestamped poses to: " << m_out_file << endl;
+		}
 	};
 
 	// Process
 	// ---------------------------------
 	CRawlogProcessor_ListPoses proc(in_rawlog, cmdline, verbose);
 	proc.doProcessRawlog();
+	proc.saveTrajectory();
 
 	// Dump statistics:
 	// ---------------------------------
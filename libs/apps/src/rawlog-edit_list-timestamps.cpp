@@ -9,6 +9,9 @@
 
 #include "apps-precomp.h"  // Precompiled headers
 //
+#include <mrpt/obs/CRawlogSidecarIndex.h>
+#include <mrpt/system/CTicTac.h>
+
 #include "rawlog-edit-declarations.h"
 
 using namespace mrpt;
@@ -23,47 +26,29 @@ using namespace mrpt::io;
 // ======================================================================
 DECLARE_OP_FUNCTION(op_list_timestamps)
 {
-	// A class to do this operation:
-	class CRawlogProcessor_ListTimestamps
-		: public CRawlogProcessorOnEachObservation
-	{
-	   protected:
-		string m_out_file;
-		std::ofstream m_out;
-
-	   public:
-		CRawlogProcessor_ListTimestamps(
-			CFileGZInputStream& in_rawlog, TCLAP::CmdLine& cmdline,
-			bool Verbose)
-			: CRawlogProcessorOnEachObservation(in_rawlog, cmdline, Verbose)
-		{
-			getArgValue<std::string>(cmdline, "text-file-output", m_out_file);
-			VERBOSE_COUT << "Writing list to: " << m_out_file << endl;
+	string out_file;
+	getArgValue<std::string>(cmdline, "text-file-output", out_file);
+	VERBOSE_COUT << "Writing list to: " << out_file << endl;
 
-			m_out.open(m_out_file.c_str());
+	std::ofstream out(out_file.c_str());
+	if (!out.is_open())
+		throw std::runtime_error(
+			"list-timestamps: Cannot open output text file.");
 
-			if (!m_out.is_open())
-				throw std::runtime_error(
-					"list-timestamps: Cannot open output text file.");
-		}
+	// From the sidecar index, generated on the first run:
+	string inFile;
+	getArgValue<string>(cmdline, "input", inFile);
 
-		bool processOneObservation(CObservation::Ptr& obs) override
-		{
-			m_out << std::fixed
-				  << mrpt::system::timestampToDouble(obs->timestamp) << " "
-				  << obs->sensorLabel << " "
-				  << obs->GetRuntimeClass()->className << std::endl;
-			return true;
-		}
-	};
+	CTicTac tictac;
+	CRawlogSidecarIndex idx;
+	idx.loadOrBuild(inFile);
 
-	// Process
-	// ---------------------------------
-	CRawlogProcessor_ListTimestamps proc(in_rawlog, cmdline, verbose);
-	proc.doProcessRawlog();
+	for (const auto& o : idx.observations())
+		out << std::fixed << mrpt::system::timestampToDouble(o.timestamp)
+			<< " " << o.sensorLabel << " " << o.className << "\n";
 
 	// Dump statistics:
 	// ---------------------------------
-	VERBOSE_COUT << "Time to process file (sec)        : " << proc.m_timToParse
+	VERBOSE_COUT << "Time to process file (sec)        : " << tictac.Tac()
 				 << "\n";
 }
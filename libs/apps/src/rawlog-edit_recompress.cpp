@@ -0,0 +1,109 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "apps-precomp.h"  // Precompiled headers
+//
+
+#include <mrpt/io/CFileZstdOutputStream.h>
+#include <mrpt/serialization/CArchive.h>
+#include <mrpt/system/CTicTac.h>
+
+#include <algorithm>
+
+#include "rawlog-edit-declarations.h"
+
+using namespace mrpt;
+using namespace mrpt::system;
+using namespace mrpt::apps;
+using namespace std;
+using namespace mrpt::io;
+
+// ======================================================================
+//		op_recompress
+// ======================================================================
+DECLARE_OP_FUNCTION(op_recompress)
+{
+	// The input is already decompressed by CFileGZInputStream, whatever its
+	// format (plain, gzip or zstd).
+	string format;
+	getArgValue<string>(cmdline, "recompress", format);
+
+	int level = 0, numThreads = 0;
+	const bool has_level = getArgValue<int>(cmdline, "compress-level", level);
+	getArgValue<int>(cmdline, "compress-threads", numThreads);
+
+	string outFile;
+	if (!getArgValue<string>(cmdline, "output", outFile))
+		throw runtime_error(
+			"recompress: This operation requires an output file. Use '-o "
+			"file' or '--output file'.");
+	if (fileExists(outFile) && !isFlagSet(cmdline, "overwrite"))
+		throw runtime_error(
+			string("*ABORTING*: Output file already exists: ") + outFile +
+			string("\n. Select a different output path, remove the file or "
+				   "force overwrite with '-w' or '--overwrite'."));
+
+	std::unique_ptr<CStream> out_io;
+	if (format == "gz")
+	{
+		auto f = std::make_unique<CFileGZOutputStream>();
+		if (!f->open(outFile, has_level ? level : 1))
+			throw runtime_error(
+				string("*ABORTING*: Cannot open output file: ") + outFile);
+		out_io = std::move(f);
+	}
+	else if (format == "zstd")
+	{
+		auto f = std::make_unique<CFileZstdOutputStream>();
+		f->setNumThreads(static_cast<unsigned int>(std::max(0, numThreads)));
+		std::string errMsg;
+		if (!f->open(outFile, has_level ? level : 3, errMsg))
+			throw runtime_error(
+				string("*ABORTING*: Cannot open output file: ") + outFile +
+				string(": ") + errMsg);
+		out_io = std::move(f);
+	}
+	else
+		throw runtime_error(
+			string("recompress: Unknown format '") + format +
+			string("'. Valid values: 'gz', 'zstd'."));
+
+	VERBOSE_COUT << "Writing to: " << outFile << " (" << format << ")\n";
+
+	// Copy all objects, one by one:
+	CTicTac tictac;
+	auto in = mrpt::serialization::archiveFrom(in_rawlog);
+	auto out = mrpt::serialization::archiveFrom(*out_io);
+	size_t nEntries = 0;
+	for (;;)
+	{
+		mrpt::serialization::CSerializable::Ptr obj;
+		try
+		{
+			obj = in.ReadObject();
+		}
+		catch (const mrpt::serialization::CExceptionEOF&)
+		{
+			break;
+		}
+		if (!obj) continue;
+		out << *obj;
+		nEntries++;
+	}
+	const uint64_t outSize = out_io->getPosition();
+	out_io.reset();	 // close and flush
+
+	VERBOSE_COUT << "Time to process file (sec)        : " << tictac.Tac()
+				 << "\n";
+	VERBOSE_COUT << "Entries written                   : " << nEntries
+				 << "\n";
+	VERBOSE_COUT << "Uncompressed size (bytes)         : " << outSize << "\n";
+	VERBOSE_COUT << "Compressed size (bytes)           : "
+				 << mrpt::system::getFileSize(outFile) << "\n";
+}
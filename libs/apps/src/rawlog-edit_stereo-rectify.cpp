@@ -11,6 +11,9 @@
 //
 #include <mrpt/vision/CStereoRectifyMap.h>
 
+#include <atomic>
+#include <mutex>
+
 #include "rawlog-edit-declarations.h"
 
 using namespace mrpt;
@@ -37,14 +40,13 @@ DECLARE_OP_FUNCTION(op_stereo_rectify)
 		string imgFileExtension;
 		double rectify_alpha;  // [0,1] see cvStereoRectify()
 
-		bool m_this_obs_is_ok;
-
 		mrpt::vision::CStereoRectifyMap rectify_map;
+		std::mutex rectify_map_mtx;
 
-		size_t m_num_external_files_failures;
+		std::atomic<size_t> m_num_external_files_failures;
 
 	   public:
-		size_t m_changedCams;
+		std::atomic<size_t> m_changedCams;
 
 		CRawlogProcessor_StereoRectify(
 			CFileGZInputStream& in_rawlog, TCLAP::CmdLine& cmdline,
@@ -133,8 +135,6 @@ DECLARE_OP_FUNCTION(op_stereo_rectify)
 
 		bool processOneObservation(CObservation::Ptr& obs) override
 		{
-			m_this_obs_is_ok = true;
-
 			if (strCmpI(obs->sensorLabel, target_label))
 			{
 				if (IS_CLASS(*obs, CObservationStereoImages))
@@ -146,11 +146,14 @@ DECLARE_OP_FUNCTION(op_stereo_rectify)
 					try
 					{
 						// Already initialized the rectification map?
-						if (!rectify_map.isSet())
 						{
-							// On the first ocassion, initialize map:
-							rectify_map.setAlpha(rectify_alpha);
-							rectify_map.setFromCamParams(*o);
+							std::lock_guard<std::mutex> lck(rectify_map_mtx);
+							if (!rectify_map.isSet())
+							{
+								// On the first ocassion, initialize map:
+								rectify_map.setAlpha(rectify_alpha);
+								rectify_map.setFromCamParams(*o);
+							}
 						}
 
 						// This is needed to raise an exception of the correct
@@ -160,8 +163,9 @@ DECLARE_OP_FUNCTION(op_stereo_rectify)
 
 						// This call rectifies the images in-place and also
 						// updates
-						// all the camera parameters as needed:
-						rectify_map.rectify(*o);
+						// all the camera parameters as needed. The internal
+						// cache can not be shared by several threads:
+						rectify_map.rectify(*o, m_numThreads == 1);
 
 						const string label_time = format(
 							"%s_%f", o->sensorLabel.c_str(),
@@ -185,11 +189,10 @@ DECLARE_OP_FUNCTION(op_stereo_rectify)
 					catch (mrpt::img::CExceptionExternalImageNotFound&)
 					{
 						const size_t MAX_FAILURES = 1000;
-						m_num_external_files_failures++;
 
-						if (m_num_external_files_failures < MAX_FAILURES)
+						if (++m_num_external_files_failures < MAX_FAILURES)
 						{
-							m_this_obs_is_ok = false;
+							obs.reset();  // Removed in OnPostProcess()
 							cerr << "\n *WARNING*: Dropping one observation "
 									"due to missing external image file at "
 									"rawlog entry "
@@ -214,11 +217,18 @@ DECLARE_OP_FUNCTION(op_stereo_rectify)
 			mrpt::obs::CSensoryFrame::Ptr& SF,
 			mrpt::obs::CObservation::Ptr& obs) override
 		{
-			if (!m_this_obs_is_ok) return;
-
-			ASSERT_((actions && SF) || obs);
+			// Drop the observations with missing external images:
+			if (SF)
+			{
+				for (auto it = SF->begin(); it != SF->end();)
+				{
+					if (*it) it++;
+					else
+						it = SF->erase(it);
+				}
+			}
 			if (actions) (*outrawlog.out_rawlog) << actions << SF;
-			else
+			else if (obs)
 				(*outrawlog.out_rawlog) << obs;
 		}
 	};
@@ -226,6 +236,7 @@ DECLARE_OP_FUNCTION(op_stereo_rectify)
 	// Process
 	// ---------------------------------
 	CRawlogProcessor_StereoRectify proc(in_rawlog, cmdline, verbose);
+	getArgValue<size_t>(cmdline, "threads", proc.m_numThreads);
 	proc.doProcessRawlog();
 
 	// Dump statistics:
@@ -89,6 +89,7 @@ DECLARE_OP_FUNCTION(op_undistort)
 	TOutputRawlogCreator outrawlog;
 	CRawlogProcessor_Undistort proc(
 		in_rawlog, cmdline, verbose, outrawlog.out_rawlog_io);
+	getArgValue<size_t>(cmdline, "threads", proc.m_numThreads);
 	proc.doProcessRawlog();
 
 	// Dump statistics:
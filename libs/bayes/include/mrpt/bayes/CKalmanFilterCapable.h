@@ -23,7 +23,12 @@
 #include <mrpt/system/CTimeLogger.h>
 #include <mrpt/typemeta/TEnumType.h>
 
+#include <Eigen/SparseCholesky>
+#include <Eigen/SparseCore>
+
 #include <cstring>	// memcpy
+#include <map>
+#include <memory>
 #include <vector>
 
 namespace mrpt
@@ -41,7 +46,13 @@ enum TKFMethod
 	kfEKFNaive = 0,
 	kfEKFAlaDavison,
 	kfIKFFull,
-	kfIKF
+	kfIKF,
+	/** Sparse Extended Information Filter (SEIF): the filter keeps the
+	 * information matrix in block-sparse form, with links between the
+	 * vehicle and, at most, TKF_options::SEIF_max_active_landmarks
+	 * landmarks. Only applicable to SLAM problems (FEAT_SIZE>0).
+	 * \note (New in MRPT 2.4.9) */
+	kfSEIF
 };
 
 // Forward declaration:
@@ -78,6 +89,7 @@ struct TKF_options : public mrpt::config::CLoadableOptions
 		MRPT_LOAD_CONFIG_VAR(
 			debug_verify_analytic_jacobians_threshold, double, iniFile,
 			section);
+		MRPT_LOAD_CONFIG_VAR(SEIF_max_active_landmarks, int, iniFile, section);
 	}
 
 	/** This method must display clearly all the contents of the structure in
@@ -98,6 +110,9 @@ struct TKF_options : public mrpt::config::CLoadableOptions
 		out << mrpt::format(
 			"enable_profiler                         = %c\n",
 			enable_profiler ? 'Y' : 'N');
+		out << mrpt::format(
+			"SEIF_max_active_landmarks               = %i\n",
+			SEIF_max_active_landmarks);
 		out << "\n";
 	}
 
@@ -124,6 +139,11 @@ struct TKF_options : public mrpt::config::CLoadableOptions
 	/** (default-1e-2) Sets the threshold for the difference between the
 	 * analytic and the numerical jacobians */
 	double debug_verify_analytic_jacobians_threshold{1e-2};
+	/** Only for kfSEIF: the maximum number of "active" landmarks, i.e. those
+	 * with a direct link to the vehicle in the information matrix. More
+	 * active landmarks means a more accurate, but denser, filter.
+	 * \note (New in MRPT 2.4.9) */
+	int SEIF_max_active_landmarks{20};
 };
 
 /** Auxiliary functions, for internal usage of MRPT classes */
@@ -261,6 +281,8 @@ class CKalmanFilterCapable : public mrpt::system::COutputLogger
 
 	inline size_t getStateVectorLength() const { return m_xkk.size(); }
 	inline KFVector& internal_getXkk() { return m_xkk; }
+	/** Direct access to the full covariance matrix, which is empty while
+	 * the filter is in information form (kfSEIF). \sa getFullCovariance */
 	inline KFMatrix& internal_getPkk() { return m_pkk; }
 	/** Returns the mean of the estimated value of the idx'th landmark (not
 	 * applicable to non-SLAM problems).
@@ -279,9 +301,52 @@ class CKalmanFilterCapable : public mrpt::system::COutputLogger
 	 */
 	inline void getLandmarkCov(size_t idx, KFMatrix_FxF& feat_cov) const
 	{
-		feat_cov = m_pkk.blockCopy<FEAT_SIZE, FEAT_SIZE>(
-			VEH_SIZE + idx * FEAT_SIZE, VEH_SIZE + idx * FEAT_SIZE);
+		if (!m_infoForm)
+		{
+			feat_cov = m_pkk.template blockCopy<FEAT_SIZE, FEAT_SIZE>(
+				VEH_SIZE + idx * FEAT_SIZE, VEH_SIZE + idx * FEAT_SIZE);
+			return;
+		}
+		ASSERT_(idx < getNumberOfLandmarksInTheMap());
+		std::vector<size_t> idxs(FEAT_SIZE);
+		for (size_t k = 0; k < FEAT_SIZE; k++)
+			idxs[k] = VEH_SIZE + idx * FEAT_SIZE + k;
+		KFMatrix P;
+		SEIF_getCovarianceSubmatrix(idxs, P);
+		feat_cov = P;
+	}
+	/** Returns the covariance of the vehicle part of the state vector.
+	 * \note (New in MRPT 2.4.9) */
+	inline void getVehicleCov(KFMatrix_VxV& veh_cov) const
+	{
+		if (!m_infoForm)
+		{
+			veh_cov = m_pkk.template blockCopy<VEH_SIZE, VEH_SIZE>(0, 0);
+			return;
+		}
+		KFMatrix P;
+		SEIF_getCovarianceSubmatrix(
+			mrpt::math::sequenceStdVec<size_t, 1>(0, VEH_SIZE), P);
+		veh_cov = P;
+	}
+	/** Returns the full covariance matrix. For kfSEIF, this requires
+	 * inverting the information matrix, which is only advisable in small
+	 * maps; use getLandmarkCov() or getVehicleCov() instead where possible.
+	 * \note (New in MRPT 2.4.9) */
+	inline void getFullCovariance(KFMatrix& cov) const
+	{
+		if (!m_infoForm)
+		{
+			cov = m_pkk;
+			return;
+		}
+		SEIF_getCovarianceSubmatrix(
+			mrpt::math::sequenceStdVec<size_t, 1>(0, m_xkk.size()), cov);
 	}
+	/** Whether the filter currently keeps the information matrix (kfSEIF)
+	 * instead of the covariance in m_pkk.
+	 * \note (New in MRPT 2.4.9) */
+	inline bool isInformationForm() const { return m_infoForm; }
 
    protected:
 	/** @name Kalman filter state
@@ -289,7 +354,10 @@ class CKalmanFilterCapable : public mrpt::system::COutputLogger
 
 	/** The system state vector. */
 	KFVector m_xkk;
-	/** The system full covariance matrix. */
+	/** The system full covariance matrix. Empty in information form
+	 * (kfSEIF), where the filter keeps the information matrix instead.
+	 * Setting it to the covariance of the current m_xkk (e.g. to reset the
+	 * filter) makes the next iteration rebuild the information matrix. */
 	KFMatrix m_pkk;
 
 	/** @} */
@@ -617,8 +685,49 @@ class CKalmanFilterCapable : public mrpt::system::COutputLogger
 	vector_KFArray_OBS m_Z;	 // Each entry is one observation:
 	KFMatrix m_K;  // Kalman gain
 	KFMatrix m_S_1;	 // Inverse of m_S
-	KFMatrix m_dh_dx_full_obs;
-	KFMatrix m_aux_K_dh_dx;
+	KFMatrix m_PHt;	 // P * dh_dx^t
+
+	/** @name Information form (only for kfSEIF)
+		@{ */
+	/** Whether m_info_* hold the filter estimate, instead of m_pkk */
+	bool m_infoForm{false};
+	/** Vehicle-vehicle block of the information matrix */
+	KFMatrix_VxV m_info_vv;
+	/** Vehicle-landmark blocks, only for the "active" landmarks */
+	std::map<size_t, KFMatrix_VxF> m_info_vl;
+	/** Landmark-landmark blocks: m_info_ll[i][j], with j>=i */
+	std::vector<std::map<size_t, KFMatrix_FxF>> m_info_ll;
+	using SparseMatrix = Eigen::SparseMatrix<KFTYPE>;
+	using SparseFactor = Eigen::SimplicialLDLT<SparseMatrix>;
+	/** Cached factorization of the information matrix, or empty */
+	mutable std::shared_ptr<SparseFactor> m_infoFactor;
+	/** Covariance of the vehicle and predicted landmarks */
+	KFMatrix m_Psub;
+
+	/** Builds the information matrix from m_pkk, then empties it */
+	void SEIF_fromCovariance();
+	/** Recovers m_pkk from the information matrix */
+	void SEIF_toCovariance();
+	/** Returns the factorization of the whole information matrix */
+	const SparseFactor& SEIF_factor() const;
+	/** Recovers the covariance between the given state vector entries */
+	void SEIF_getCovarianceSubmatrix(
+		const std::vector<size_t>& idxs, KFMatrix& P) const;
+	/** Motion update of the information matrix, for the vehicle transition
+	 * Jacobian F and noise Q */
+	void SEIF_predict(const KFMatrix_VxV& F, const KFMatrix_VxV& Q);
+	/** Adds the information of a new landmark, with Jacobian dy_dxv of the
+	 * inverse sensor model and covariance Py given the vehicle pose */
+	void SEIF_addLandmark(const KFMatrix_FxV& dy_dxv, const KFMatrix_FxF& Py);
+	/** Deactivates landmarks until there are at most
+	 * SEIF_max_active_landmarks, never those in keepActive */
+	void SEIF_sparsify(const std::vector<size_t>& keepActive);
+	/** Returns the (i,j) landmark-landmark block, creating it if needed */
+	KFMatrix_FxF& SEIF_block_ll(size_t i, size_t j)
+	{
+		return i <= j ? m_info_ll[i][j] : m_info_ll[j][i];
+	}
+	/** @} */
 
    protected:
 	/** The main entry point, executes one complete step: prediction + update.
@@ -667,6 +776,7 @@ MRPT_FILL_ENUM(kfEKFNaive);
 MRPT_FILL_ENUM(kfEKFAlaDavison);
 MRPT_FILL_ENUM(kfIKFFull);
 MRPT_FILL_ENUM(kfIKF);
+MRPT_FILL_ENUM(kfSEIF);
 MRPT_ENUM_TYPE_END()
 
 // Template implementation:
@@ -16,6 +16,8 @@
 #include <mrpt/math/ops_matrices.h>	 // extractSubmatrixSymmetrical()
 
 #include <Eigen/Dense>
+#include <algorithm>
+#include <limits>
 
 namespace mrpt
 {
@@ -34,7 +36,18 @@ void CKalmanFilterCapable<
 	m_timLogger.enable(KF_options.enable_profiler);
 	m_timLogger.enter("KF:complete_step");
 
-	ASSERT_(int(m_xkk.size()) == m_pkk.cols());
+	// Switch between the covariance and the information forms, as needed.
+	// A covariance matching the state vector means the user (re)set it:
+	if (KF_options.method == kfSEIF)
+	{
+		ASSERTMSG_(FEAT_SIZE != 0, "kfSEIF only applies to SLAM problems");
+		if (!m_infoForm || m_pkk.rows() == int(m_xkk.size()))
+			SEIF_fromCovariance();
+	}
+	else if (m_infoForm)
+		SEIF_toCovariance();
+
+	if (!m_infoForm) ASSERT_(int(m_xkk.size()) == m_pkk.cols());
 	ASSERT_(size_t(m_xkk.size()) >= VEH_SIZE);
 	// =============================================================
 	//  1. CREATE ACTION MATRIX u FROM ODOMETRY
@@ -132,29 +145,39 @@ void CKalmanFilterCapable<
 		KFMatrix_VxV Q;
 		OnTransitionNoise(Q);
 
-		// ====================================
-		//  3.1:  Pxx submatrix
-		// ====================================
-		// Replace old covariance:
-		m_pkk.asEigen().template block<VEH_SIZE, VEH_SIZE>(0, 0) = Q.asEigen() +
-			dfv_dxv.asEigen() * m_pkk.template block<VEH_SIZE, VEH_SIZE>(0, 0) *
-				dfv_dxv.asEigen().transpose();
-
-		// ====================================
-		//  3.2:  All Pxy_i
-		// ====================================
-		// Now, update the cov. of landmarks, if any:
-		KFMatrix_VxF aux;
-		for (size_t i = 0; i < N_map; i++)
+		if (m_infoForm)
+		{
+			// Only the blocks of the vehicle and active landmarks change:
+			SEIF_predict(dfv_dxv, Q);
+		}
+		else
 		{
-			aux = dfv_dxv.asEigen() *
-				m_pkk.template block<VEH_SIZE, FEAT_SIZE>(
-					0, VEH_SIZE + i * FEAT_SIZE);
-
-			m_pkk.asEigen().template block<VEH_SIZE, FEAT_SIZE>(
-				0, VEH_SIZE + i * FEAT_SIZE) = aux.asEigen();
-			m_pkk.asEigen().template block<FEAT_SIZE, VEH_SIZE>(
-				VEH_SIZE + i * FEAT_SIZE, 0) = aux.asEigen().transpose();
+			// ====================================
+			//  3.1:  Pxx submatrix
+			// ====================================
+			// Replace old covariance:
+			m_pkk.asEigen().template block<VEH_SIZE, VEH_SIZE>(0, 0) =
+				Q.asEigen() +
+				dfv_dxv.asEigen() *
+					m_pkk.template block<VEH_SIZE, VEH_SIZE>(0, 0) *
+					dfv_dxv.asEigen().transpose();
+
+			// ====================================
+			//  3.2:  All Pxy_i
+			// ====================================
+			// Now, update the cov. of landmarks, if any:
+			KFMatrix_VxF aux;
+			for (size_t i = 0; i < N_map; i++)
+			{
+				aux = dfv_dxv.asEigen() *
+					m_pkk.template block<VEH_SIZE, FEAT_SIZE>(
+						0, VEH_SIZE + i * FEAT_SIZE);
+
+				m_pkk.asEigen().template block<VEH_SIZE, FEAT_SIZE>(
+					0, VEH_SIZE + i * FEAT_SIZE) = aux.asEigen();
+				m_pkk.asEigen().template block<FEAT_SIZE, VEH_SIZE>(
+					VEH_SIZE + i * FEAT_SIZE, 0) = aux.asEigen().transpose();
+			}
 		}
 
 		// =============================================================
@@ -368,29 +391,42 @@ void CKalmanFilterCapable<
 
 		if (FEAT_SIZE > 0)
 		{  // SLAM-like problem:
+			// The covariance blocks involved in m_S: those in m_pkk or, in
+			// information form, only those recovered into m_Psub:
+			if (m_infoForm)
+			{
+				auto idxs = mrpt::math::sequenceStdVec<size_t, 1>(0, VEH_SIZE);
+				for (size_t lm_idx : m_predictLMidxs)
+					for (size_t k = 0; k < FEAT_SIZE; k++)
+						idxs.push_back(VEH_SIZE + lm_idx * FEAT_SIZE + k);
+				SEIF_getCovarianceSubmatrix(idxs, m_Psub);
+			}
+			const auto P = (m_infoForm ? m_Psub : m_pkk).asEigen();
+			// Offset of the i'th predicted landmark in P:
+			const auto lmOffset = [&](size_t i) {
+				return VEH_SIZE +
+					(m_infoForm ? i : m_predictLMidxs[i]) * FEAT_SIZE;
+			};
+
 			// Covariance of the vehicle pose
-			const auto Px = m_pkk.template block<VEH_SIZE, VEH_SIZE>(0, 0);
+			const auto Px = P.template block<VEH_SIZE, VEH_SIZE>(0, 0);
 
 			for (size_t i = 0; i < N_pred; ++i)
 			{
-				const size_t lm_idx_i = m_predictLMidxs[i];
 				// Pxyi^t
-				const auto Pxyi_t = m_pkk.template block<FEAT_SIZE, VEH_SIZE>(
-					VEH_SIZE + lm_idx_i * FEAT_SIZE, 0);
+				const auto Pxyi_t =
+					P.template block<FEAT_SIZE, VEH_SIZE>(lmOffset(i), 0);
 
 				// Only do j>=i (upper triangle), since m_S is symmetric:
 				for (size_t j = i; j < N_pred; ++j)
 				{
-					const size_t lm_idx_j = m_predictLMidxs[j];
 					// Sij block:
 					mrpt::math::CMatrixFixed<KFTYPE, OBS_SIZE, OBS_SIZE> Sij;
 
-					const auto Pxyj = m_pkk.template block<VEH_SIZE, FEAT_SIZE>(
-						0, VEH_SIZE + lm_idx_j * FEAT_SIZE);
-					const auto Pyiyj =
-						m_pkk.template block<FEAT_SIZE, FEAT_SIZE>(
-							VEH_SIZE + lm_idx_i * FEAT_SIZE,
-							VEH_SIZE + lm_idx_j * FEAT_SIZE);
+					const auto Pxyj =
+						P.template block<VEH_SIZE, FEAT_SIZE>(0, lmOffset(j));
+					const auto Pyiyj = P.template block<FEAT_SIZE, FEAT_SIZE>(
+						lmOffset(i), lmOffset(j));
 
 					// clang-format off
 					Sij = m_Hxs[i].asEigen() * Px     * m_Hxs[j].asEigen().transpose() +
@@ -481,151 +517,124 @@ void CKalmanFilterCapable<
 			case kfEKFNaive:
 			case kfIKFFull:
 			{
-				// Build the whole Jacobian dh_dx matrix
-				// ---------------------------------------------
-				// Keep only those whose DA is not -1
-				std::vector<int> mapIndicesForKFUpdate(data_association.size());
-				mapIndicesForKFUpdate.resize(std::distance(
-					mapIndicesForKFUpdate.begin(),
-					std::remove_copy_if(
-						data_association.begin(), data_association.end(),
-						mapIndicesForKFUpdate.begin(),
-						[](int i) { return i == -1; })));
-
-				const size_t N_upd =
-					(FEAT_SIZE == 0) ? 1 :	// Non-SLAM problems: Just one
-											// observation for the entire
-											// system.
-					mapIndicesForKFUpdate
-						.size();  // SLAM: # of observed known landmarks
-
-				// Just one, or several update iterations??
-				const size_t nKF_iterations = (KF_options.method == kfEKFNaive)
-					? 1
-					: KF_options.IKF_iterations;
-
-				const KFVector xkk_0 = m_xkk;
-
-				// For each IKF iteration (or 1 for EKF)
-				if (N_upd > 0)	// Do not update if we have no observations!
-				{
-					for (size_t IKF_iteration = 0;
-						 IKF_iteration < nKF_iterations; IKF_iteration++)
+				// The Jacobian dh_dx of the observations is block-sparse:
+				// each observation only depends on the vehicle (Hx) and one
+				// landmark (Hy), so it's never built explicitly. Instead, we
+				// keep the index of each observed landmark in the list of
+				// predictions, and its offset in the state vector:
+				std::vector<std::pair<size_t, size_t>> obsBlocks;
+				KFMatrix S_observed;  // The KF "m_S" matrix: A re-ordered,
+				// subset, version of the prediction m_S:
+
+				// Compute ytilde = OBS - PREDICTION
+				KFVector ytilde;
+
+				if (FEAT_SIZE != 0)
+				{  // SLAM problems:
+					std::vector<size_t> S_idxs;
+					std::vector<size_t> ytilde_idxs;
+					for (size_t i = 0; i < data_association.size(); ++i)
 					{
-						// Compute ytilde = OBS - PREDICTION
-						KFVector ytilde(OBS_SIZE * N_upd);
-						size_t ytilde_idx = 0;
-
-						// TODO: Use a Matrix view of "dh_dx_full" instead of
-						// creating a copy into "m_dh_dx_full_obs"
-						m_dh_dx_full_obs.setZero(
-							N_upd * OBS_SIZE,
-							VEH_SIZE + FEAT_SIZE * N_map);	// Init to zeros.
-						KFMatrix S_observed;  // The KF "m_S" matrix: A
-						// re-ordered, subset, version of
-						// the prediction m_S:
+						if (data_association[i] < 0) continue;
 
-						if (FEAT_SIZE != 0)
-						{  // SLAM problems:
-							std::vector<size_t> S_idxs;
-							S_idxs.reserve(OBS_SIZE * N_upd);
-
-							// const size_t row_len = VEH_SIZE + FEAT_SIZE *
-							// N_map;
+						const auto assoc_idx_in_map =
+							static_cast<size_t>(data_association[i]);
+						const size_t assoc_idx_in_pred =
+							mrpt::containers::find_in_vector(
+								assoc_idx_in_map, m_predictLMidxs);
+						ASSERTMSG_(
+							assoc_idx_in_pred != string::npos,
+							"OnPreComputingPredictions() didn't recommend the "
+							"prediction of a landmark which has been actually "
+							"observed!");
 
-							for (size_t i = 0; i < data_association.size(); ++i)
-							{
-								if (data_association[i] < 0) continue;
-
-								const auto assoc_idx_in_map =
-									static_cast<size_t>(data_association[i]);
-								const size_t assoc_idx_in_pred =
-									mrpt::containers::find_in_vector(
-										assoc_idx_in_map, m_predictLMidxs);
-								ASSERTMSG_(
-									assoc_idx_in_pred != string::npos,
-									"OnPreComputingPredictions() didn't "
-									"recommend the prediction of a landmark "
-									"which has been actually observed!");
-								// TODO: In these cases, extend the prediction
-								// right now instead of launching an
-								// exception... or is this a bad idea??
-
-								// Build the subset m_dh_dx_full_obs:
-								//										m_dh_dx_full_obs.block(S_idxs.size()
-								//,0, OBS_SIZE, row_len)
-								//										=
-								//										dh_dx_full.block
-								//(assoc_idx_in_pred*OBS_SIZE,0, OBS_SIZE,
-								// row_len);
-
-								m_dh_dx_full_obs
-									.template block<OBS_SIZE, VEH_SIZE>(
-										S_idxs.size(), 0) =
-									m_Hxs[assoc_idx_in_pred].asEigen();
-								m_dh_dx_full_obs
-									.template block<OBS_SIZE, FEAT_SIZE>(
-										S_idxs.size(),
-										VEH_SIZE +
-											assoc_idx_in_map * FEAT_SIZE) =
-									m_Hys[assoc_idx_in_pred].asEigen();
-
-								// S_idxs.size() is used as counter for
-								// "m_dh_dx_full_obs".
-								for (size_t k = 0; k < OBS_SIZE; k++)
-									S_idxs.push_back(
-										assoc_idx_in_pred * OBS_SIZE + k);
-
-								// ytilde_i = Z[i] - m_all_predictions[i]
-								KFArray_OBS ytilde_i = m_Z[i];
-								OnSubstractObservationVectors(
-									ytilde_i,
-									m_all_predictions
-										[m_predictLMidxs[assoc_idx_in_pred]]);
-								for (size_t k = 0; k < OBS_SIZE; k++)
-									ytilde[ytilde_idx++] = ytilde_i[k];
-							}
-							// Extract the subset that is involved in this
-							// observation:
-							mrpt::math::extractSubmatrixSymmetrical(
-								m_S, S_idxs, S_observed);
-						}
-						else
-						{  // Non-SLAM problems:
-							ASSERT_(
-								m_Z.size() == 1 &&
-								m_all_predictions.size() == 1);
-							ASSERT_(
-								m_dh_dx_full_obs.rows() == OBS_SIZE &&
-								m_dh_dx_full_obs.cols() == VEH_SIZE);
-							ASSERT_(m_Hxs.size() == 1);
-							m_dh_dx_full_obs = m_Hxs[0];  // Was: dh_dx_full
-							KFArray_OBS ytilde_i = m_Z[0];
-							OnSubstractObservationVectors(
-								ytilde_i, m_all_predictions[0]);
-							for (size_t k = 0; k < OBS_SIZE; k++)
-								ytilde[ytilde_idx++] = ytilde_i[k];
-							// Extract the subset that is involved in this
-							// observation:
-							S_observed = m_S;
-						}
+						obsBlocks.emplace_back(
+							assoc_idx_in_pred,
+							VEH_SIZE + assoc_idx_in_map * FEAT_SIZE);
+						for (size_t k = 0; k < OBS_SIZE; k++)
+							S_idxs.push_back(assoc_idx_in_pred * OBS_SIZE + k);
+						ytilde_idxs.push_back(i);
+					}
 
-						// Compute the full K matrix:
-						// ------------------------------
-						m_timLogger.enter("KF:8.update stage:1.FULLKF:build K");
+					ytilde.resize(OBS_SIZE * obsBlocks.size());
+					for (size_t k = 0; k < obsBlocks.size(); k++)
+					{
+						// ytilde_i = Z[i] - m_all_predictions[i]
+						KFArray_OBS ytilde_i = m_Z[ytilde_idxs[k]];
+						OnSubstractObservationVectors(
+							ytilde_i,
+							m_all_predictions
+								[m_predictLMidxs[obsBlocks[k].first]]);
+						ytilde.asEigen().template segment<OBS_SIZE>(
+							k * OBS_SIZE) = ytilde_i.asEigen();
+					}
+					// Extract the subset that is involved in this
+					// observation:
+					mrpt::math::extractSubmatrixSymmetrical(
+						m_S, S_idxs, S_observed);
+				}
+				else
+				{  // Non-SLAM problems: Just one observation for the entire
+					// system, with Hx=dh_dx:
+					ASSERT_(m_Z.size() == 1 && m_all_predictions.size() == 1);
+					ASSERT_(m_Hxs.size() == 1);
+					obsBlocks.emplace_back(0, 0);
+					KFArray_OBS ytilde_i = m_Z[0];
+					OnSubstractObservationVectors(
+						ytilde_i, m_all_predictions[0]);
+					ytilde = ytilde_i;
+					S_observed = m_S;
+				}
 
-						m_K.setSize(m_pkk.rows(), S_observed.cols());
+				// Number of observed known landmarks (or 1, in non-SLAM
+				// problems):
+				const size_t N_upd = obsBlocks.size();
 
-						// K = m_pkk * (~dh_dx) * m_S.inverse_LLt() );
-						m_K.asEigen() = m_pkk.asEigen() *
-							m_dh_dx_full_obs.asEigen().transpose();
+				// Do not update if we have no observations!
+				if (N_upd > 0)
+				{
+					// Just one, or several update iterations??
+					const size_t nKF_iterations =
+						(KF_options.method == kfEKFNaive)
+						? 1
+						: KF_options.IKF_iterations;
+
+					const KFVector xkk_0 = m_xkk;
+
+					// Compute P*dh_dx^t, block by block, with fixed-size
+					// products: only the columns of P of the vehicle and the
+					// observed landmarks are read.
+					m_timLogger.enter("KF:8.update stage:1.FULLKF:build K");
+
+					const size_t stat_len = m_xkk.size();
+					const auto Pkk = m_pkk.asEigen();
+					m_PHt.setSize(stat_len, OBS_SIZE * N_upd);
+					auto PHt = m_PHt.asEigen();
+					for (size_t k = 0; k < N_upd; k++)
+					{
+						auto PHt_k =
+							PHt.template middleCols<OBS_SIZE>(k * OBS_SIZE);
+						PHt_k.noalias() =
+							Pkk.template leftCols<VEH_SIZE>() *
+							m_Hxs[obsBlocks[k].first].asEigen().transpose();
+						if (FEAT_SIZE != 0)
+							PHt_k.noalias() +=
+								Pkk.template middleCols<FEAT_SIZE>(
+									obsBlocks[k].second) *
+								m_Hys[obsBlocks[k].first].asEigen().transpose();
+					}
 
-						// Inverse of S_observed -> m_S_1
-						m_S_1 = S_observed.inverse_LLt();
-						m_K.asEigen() *= m_S_1.asEigen();
+					// K = P * dh_dx^t * S^-1
+					m_S_1 = S_observed.inverse_LLt();
+					m_K.setSize(stat_len, OBS_SIZE * N_upd);
+					m_K.asEigen() = PHt * m_S_1.asEigen();
 
-						m_timLogger.leave("KF:8.update stage:1.FULLKF:build K");
+					m_timLogger.leave("KF:8.update stage:1.FULLKF:build K");
 
+					// For each IKF iteration (or 1 for EKF)
+					for (size_t IKF_iteration = 0;
+						 IKF_iteration < nKF_iterations; IKF_iteration++)
+					{
 						// Use the full K matrix to update the mean:
 						if (nKF_iterations == 1)
 						{
@@ -640,8 +649,25 @@ void CKalmanFilterCapable<
 							m_timLogger.enter(
 								"KF:8.update stage:2.FULLKF:iter.update xkk");
 
-							auto HAx_column =
-								KFVector(m_dh_dx_full_obs * (m_xkk - xkk_0));
+							// dh_dx * (m_xkk - xkk_0), block by block:
+							const KFVector Ax = m_xkk - xkk_0;
+							const auto Ax_e = Ax.asEigen();
+							KFVector HAx_column(OBS_SIZE * N_upd);
+							for (size_t k = 0; k < N_upd; k++)
+							{
+								auto HAx_k =
+									HAx_column.asEigen()
+										.template segment<OBS_SIZE>(
+											k * OBS_SIZE);
+								HAx_k.noalias() =
+									m_Hxs[obsBlocks[k].first].asEigen() *
+									Ax_e.template head<VEH_SIZE>();
+								if (FEAT_SIZE != 0)
+									HAx_k.noalias() +=
+										m_Hys[obsBlocks[k].first].asEigen() *
+										Ax_e.template segment<FEAT_SIZE>(
+											obsBlocks[k].second);
+							}
 
 							m_xkk = xkk_0;
 							m_xkk.asEigen() += m_K * (ytilde - HAx_column);
@@ -649,44 +675,16 @@ void CKalmanFilterCapable<
 							m_timLogger.leave(
 								"KF:8.update stage:2.FULLKF:iter.update xkk");
 						}
-
-						// Update the covariance just at the end
-						//  of iterations if we are in IKF, always in normal
-						//  EKF.
-						if (IKF_iteration == (nKF_iterations - 1))
-						{
-							m_timLogger.enter(
-								"KF:8.update stage:3.FULLKF:update Pkk");
-
-							// Use the full K matrix to update the covariance:
-							// m_pkk = (I - K*dh_dx ) * m_pkk;
-							// TODO: "Optimize this: sparsity!"
-
-							// K * m_dh_dx_full_obs
-							m_aux_K_dh_dx.matProductOf_AB(
-								m_K, m_dh_dx_full_obs);
-
-							// m_aux_K_dh_dx  <-- I-m_aux_K_dh_dx
-							const size_t stat_len = m_aux_K_dh_dx.cols();
-							for (size_t r = 0; r < stat_len; r++)
-							{
-								for (size_t c = 0; c < stat_len; c++)
-								{
-									if (r == c)
-										m_aux_K_dh_dx(r, c) =
-											-m_aux_K_dh_dx(r, c) + kftype(1);
-									else
-										m_aux_K_dh_dx(r, c) =
-											-m_aux_K_dh_dx(r, c);
-								}
-							}
-
-							m_pkk = m_aux_K_dh_dx * m_pkk;
-
-							m_timLogger.leave(
-								"KF:8.update stage:3.FULLKF:update Pkk");
-						}
 					}  // end for each IKF iteration
+
+					// Update the covariance just at the end of iterations if
+					// we are in IKF, always in normal EKF:
+					//  P = (I - K*dh_dx) * P = P - K * (P*dh_dx^t)^t,
+					// a rank-(OBS_SIZE*N_upd) update of P.
+					m_timLogger.enter("KF:8.update stage:3.FULLKF:update Pkk");
+					m_pkk.asEigen().noalias() -=
+						m_K.asEigen() * PHt.transpose();
+					m_timLogger.leave("KF:8.update stage:3.FULLKF:update Pkk");
 				}
 			}
 			break;
@@ -894,6 +892,67 @@ void CKalmanFilterCapable<
 			}
 			break;
 
+			// --------------------------------------------------------------------
+			// - SEIF: update of the information matrix and vector
+			// --------------------------------------------------------------------
+			case kfSEIF:
+			{
+				// Add H^t R^-1 H to the blocks of the information matrix of
+				// the vehicle and each observed landmark, and accumulate the
+				// information vector b = H^t R^-1 (z-h(x)):
+				const KFMatrix_OxO R_inv = R.inverse_LLt();
+				KFVector b;
+				b.setZero(m_xkk.size());
+				bool anyUpdate = false;
+
+				for (size_t i = 0; i < data_association.size(); ++i)
+				{
+					if (data_association[i] < 0) continue;
+
+					const auto lm_idx =
+						static_cast<size_t>(data_association[i]);
+					const size_t idx_in_pred =
+						mrpt::containers::find_in_vector(
+							lm_idx, m_predictLMidxs);
+					ASSERTMSG_(
+						idx_in_pred != string::npos,
+						"OnPreComputingPredictions() didn't recommend the "
+						"prediction of a landmark which has been actually "
+						"observed!");
+					const auto& Hx = m_Hxs[idx_in_pred].asEigen();
+					const auto& Hy = m_Hys[idx_in_pred].asEigen();
+
+					KFArray_OBS ytilde = m_Z[i];
+					OnSubstractObservationVectors(
+						ytilde, m_all_predictions[lm_idx]);
+
+					const KFMatrix_VxO HxtRi(Hx.transpose() * R_inv.asEigen());
+					const KFMatrix_FxO HytRi(Hy.transpose() * R_inv.asEigen());
+
+					m_info_vv.asEigen() += HxtRi.asEigen() * Hx;
+					m_info_vl[lm_idx].asEigen() += HxtRi.asEigen() * Hy;
+					m_info_ll[lm_idx][lm_idx].asEigen() +=
+						HytRi.asEigen() * Hy;
+
+					const size_t idx_off = VEH_SIZE + lm_idx * FEAT_SIZE;
+					b.asEigen().template segment<VEH_SIZE>(0) +=
+						HxtRi.asEigen() * ytilde.asEigen();
+					b.asEigen().template segment<FEAT_SIZE>(idx_off) +=
+						HytRi.asEigen() * ytilde.asEigen();
+					anyUpdate = true;
+				}
+
+				if (anyUpdate)
+				{
+					// Exact mean recovery: solve "Lambda * dx = b":
+					m_infoFactor.reset();
+					const Eigen::Matrix<KFTYPE, Eigen::Dynamic, 1> dx =
+						SEIF_factor().solve(b.asEigen());
+					m_xkk.asEigen() += dx;
+				}
+			}
+			break;
+
 			default: THROW_EXCEPTION("Invalid value of options.KF_method");
 		}  // end switch method
 	}
@@ -914,6 +973,20 @@ void CKalmanFilterCapable<
 		m_timLogger.leave("KF:A.add new landmarks");
 	}  // end if data_association!=empty
 
+	// SEIF: Keep the information matrix sparse, without deactivating the
+	// landmarks just observed or added:
+	if (m_infoForm)
+	{
+		m_timLogger.enter("KF:A.SEIF sparsification");
+		std::vector<size_t> observedLMs;
+		for (int i : data_association)
+			if (i >= 0) observedLMs.push_back(static_cast<size_t>(i));
+		for (size_t i = N_map; i < getNumberOfLandmarksInTheMap(); i++)
+			observedLMs.push_back(i);
+		SEIF_sparsify(observedLMs);
+		m_timLogger.leave("KF:A.SEIF sparsification");
+	}
+
 	// Post iteration user code:
 	m_timLogger.enter("KF:B.OnPostIteration");
 	OnPostIteration();
@@ -980,6 +1053,303 @@ void CKalmanFilterCapable<VEH_SIZE, OBS_SIZE, FEAT_SIZE, ACT_SIZE, KFTYPE>::
 	out_x = prediction[0];
 }
 
+template <
+	size_t VEH_SIZE, size_t OBS_SIZE, size_t FEAT_SIZE, size_t ACT_SIZE,
+	typename KFTYPE>
+void CKalmanFilterCapable<
+	VEH_SIZE, OBS_SIZE, FEAT_SIZE, ACT_SIZE, KFTYPE>::SEIF_fromCovariance()
+{
+	MRPT_START
+	const size_t n = m_xkk.size();
+	ASSERT_(int(n) == m_pkk.rows() && int(n) == m_pkk.cols());
+	ASSERT_(FEAT_SIZE != 0 && (n - VEH_SIZE) % FEAT_SIZE == 0);
+
+	// A tiny regularization, since it is common to start with an exactly
+	// known vehicle pose (null covariance):
+	KFMatrix P = m_pkk;
+	for (size_t i = 0; i < n; i++)
+		P(i, i) += KFTYPE(1e-9);
+	const KFMatrix L = P.inverse_LLt();
+
+	const size_t nLMs = (n - VEH_SIZE) / FEAT_SIZE;
+	m_info_vv = L.template blockCopy<VEH_SIZE, VEH_SIZE>(0, 0);
+	m_info_vl.clear();
+	m_info_ll.assign(nLMs, {});
+	for (size_t i = 0; i < nLMs; i++)
+	{
+		const size_t off_i = VEH_SIZE + i * FEAT_SIZE;
+		const auto Lvl = L.template blockCopy<VEH_SIZE, FEAT_SIZE>(0, off_i);
+		if (!Lvl.asEigen().isZero(0)) m_info_vl[i] = Lvl;
+		for (size_t j = i; j < nLMs; j++)
+		{
+			const auto Lll = L.template blockCopy<FEAT_SIZE, FEAT_SIZE>(
+				off_i, VEH_SIZE + j * FEAT_SIZE);
+			if (!Lll.asEigen().isZero(0)) m_info_ll[i][j] = Lll;
+		}
+	}
+
+	m_pkk.setSize(0, 0);
+	m_infoFactor.reset();
+	m_infoForm = true;
+	MRPT_END
+}
+
+template <
+	size_t VEH_SIZE, size_t OBS_SIZE, size_t FEAT_SIZE, size_t ACT_SIZE,
+	typename KFTYPE>
+void CKalmanFilterCapable<
+	VEH_SIZE, OBS_SIZE, FEAT_SIZE, ACT_SIZE, KFTYPE>::SEIF_toCovariance()
+{
+	KFMatrix P;
+	getFullCovariance(P);
+	m_pkk = std::move(P);
+	m_info_vl.clear();
+	m_info_ll.clear();
+	m_infoFactor.reset();
+	m_infoForm = false;
+}
+
+template <
+	size_t VEH_SIZE, size_t OBS_SIZE, size_t FEAT_SIZE, size_t ACT_SIZE,
+	typename KFTYPE>
+const typename CKalmanFilterCapable<
+	VEH_SIZE, OBS_SIZE, FEAT_SIZE, ACT_SIZE, KFTYPE>::SparseFactor&
+	CKalmanFilterCapable<
+		VEH_SIZE, OBS_SIZE, FEAT_SIZE, ACT_SIZE, KFTYPE>::SEIF_factor() const
+{
+	MRPT_START
+	if (m_infoFactor) return *m_infoFactor;
+
+	// Only the lower triangular part is referenced by the factorization:
+	std::vector<Eigen::Triplet<KFTYPE>> coefs;
+	const auto addBlock = [&coefs](size_t row0, size_t col0, const auto& B) {
+		for (int r = 0; r < B.rows(); r++)
+			for (int c = 0; c < B.cols(); c++)
+				if (B(r, c) != 0 && row0 + r >= col0 + c)
+					coefs.emplace_back(row0 + r, col0 + c, B(r, c));
+	};
+
+	addBlock(0, 0, m_info_vv.asEigen());
+	for (const auto& [lm_idx, B] : m_info_vl)
+		addBlock(VEH_SIZE + lm_idx * FEAT_SIZE, 0, B.asEigen().transpose());
+	for (size_t i = 0; i < m_info_ll.size(); i++)
+		for (const auto& [j, B] : m_info_ll[i])
+			addBlock(
+				VEH_SIZE + j * FEAT_SIZE, VEH_SIZE + i * FEAT_SIZE,
+				B.asEigen().transpose());
+
+	const auto n = static_cast<Eigen::Index>(m_xkk.size());
+	SparseMatrix L(n, n);
+	L.setFromTriplets(coefs.begin(), coefs.end());
+
+	auto factor = std::make_shared<SparseFactor>(L);
+	ASSERTMSG_(
+		factor->info() == Eigen::Success,
+		"SEIF: The information matrix is not positive definite");
+	m_infoFactor = factor;
+	return *factor;
+	MRPT_END
+}
+
+template <
+	size_t VEH_SIZE, size_t OBS_SIZE, size_t FEAT_SIZE, size_t ACT_SIZE,
+	typename KFTYPE>
+void CKalmanFilterCapable<VEH_SIZE, OBS_SIZE, FEAT_SIZE, ACT_SIZE, KFTYPE>::
+	SEIF_getCovarianceSubmatrix(
+		const std::vector<size_t>& idxs, KFMatrix& P) const
+{
+	using DenseMatrix = Eigen::Matrix<KFTYPE, Eigen::Dynamic, Eigen::Dynamic>;
+
+	// One column of the covariance for each requested index:
+	const size_t m = idxs.size();
+	DenseMatrix E = DenseMatrix::Zero(m_xkk.size(), m);
+	for (size_t j = 0; j < m; j++)
+		E(idxs[j], j) = 1;
+	const DenseMatrix X = SEIF_factor().solve(E);
+
+	P.setSize(m, m);
+	for (size_t a = 0; a < m; a++)
+		for (size_t b = a; b < m; b++)
+			P(a, b) = P(b, a) = KFTYPE(0.5) * (X(idxs[a], b) + X(idxs[b], a));
+}
+
+template <
+	size_t VEH_SIZE, size_t OBS_SIZE, size_t FEAT_SIZE, size_t ACT_SIZE,
+	typename KFTYPE>
+void CKalmanFilterCapable<VEH_SIZE, OBS_SIZE, FEAT_SIZE, ACT_SIZE, KFTYPE>::
+	SEIF_predict(const KFMatrix_VxV& F, const KFMatrix_VxV& Q)
+{
+	// Add the new vehicle pose x'=f(x) and marginalize out the old one.
+	// With Phi=Lambda_xx and C=F*Phi^-1*F^t+Q, this gives:
+	//  Lambda_x'x' = C^-1
+	//  Lambda_x'm  = C^-1 * F * Phi^-1 * Lambda_xm
+	//  Lambda_mm'  = Lambda_mm - K^t * (Phi - F^t*C^-1*F) * K,
+	// with K=Phi^-1*Lambda_xm, which only changes the blocks of the active
+	// landmarks (those with Lambda_xm!=0). This avoids inverting Q, which may
+	// be singular.
+	const auto& Fe = F.asEigen();
+	const KFMatrix_VxV Phi_inv = m_info_vv.inverse_LLt();
+	const KFMatrix_VxV C(Fe * Phi_inv.asEigen() * Fe.transpose() + Q.asEigen());
+	const KFMatrix_VxV C_inv = C.inverse_LLt();
+	const KFMatrix_VxV M(
+		m_info_vv.asEigen() - Fe.transpose() * C_inv.asEigen() * Fe);
+
+	std::vector<std::pair<size_t, KFMatrix_VxF>> K;
+	K.reserve(m_info_vl.size());
+	for (const auto& [lm_idx, B] : m_info_vl)
+		K.emplace_back(lm_idx, KFMatrix_VxF(Phi_inv.asEigen() * B.asEigen()));
+
+	// (m_info_vl is sorted, so K[a].first < K[b].first for a<b)
+	for (size_t a = 0; a < K.size(); a++)
+	{
+		const KFMatrix_FxV KtM(K[a].second.asEigen().transpose() * M.asEigen());
+		for (size_t b = a; b < K.size(); b++)
+			m_info_ll[K[a].first][K[b].first].asEigen() -=
+				KtM.asEigen() * K[b].second.asEigen();
+	}
+
+	const KFMatrix_VxV C_inv_F(C_inv.asEigen() * Fe);
+	for (const auto& [lm_idx, Ka] : K)
+		m_info_vl[lm_idx] = C_inv_F.asEigen() * Ka.asEigen();
+	m_info_vv = C_inv;
+
+	m_infoFactor.reset();
+}
+
+template <
+	size_t VEH_SIZE, size_t OBS_SIZE, size_t FEAT_SIZE, size_t ACT_SIZE,
+	typename KFTYPE>
+void CKalmanFilterCapable<VEH_SIZE, OBS_SIZE, FEAT_SIZE, ACT_SIZE, KFTYPE>::
+	SEIF_addLandmark(const KFMatrix_FxV& dy_dxv, const KFMatrix_FxF& Py)
+{
+	// y = g(x,z): Add the information of the linearized constraint
+	// "y - dy_dxv*x" with covariance Py:
+	const KFMatrix_FxF Py_inv = Py.inverse_LLt();
+	const KFMatrix_VxF GtPi(dy_dxv.asEigen().transpose() * Py_inv.asEigen());
+
+	const size_t lm_idx = m_info_ll.size();
+	m_info_vv.asEigen() += GtPi.asEigen() * dy_dxv.asEigen();
+	m_info_vl[lm_idx] = -GtPi.asEigen();
+	m_info_ll.emplace_back();
+	m_info_ll[lm_idx][lm_idx] = Py_inv;
+
+	m_infoFactor.reset();
+}
+
+template <
+	size_t VEH_SIZE, size_t OBS_SIZE, size_t FEAT_SIZE, size_t ACT_SIZE,
+	typename KFTYPE>
+void CKalmanFilterCapable<VEH_SIZE, OBS_SIZE, FEAT_SIZE, ACT_SIZE, KFTYPE>::
+	SEIF_sparsify(const std::vector<size_t>& keepActive)
+{
+	const size_t maxActive =
+		static_cast<size_t>(std::max(0, KF_options.SEIF_max_active_landmarks));
+	if (m_info_vl.size() <= maxActive) return;
+
+	// Keep the landmarks in keepActive, then those with the strongest links:
+	std::vector<std::pair<KFTYPE, size_t>> ranking;
+	size_t nObserved = 0;
+	for (const auto& [lm_idx, B] : m_info_vl)
+	{
+		const bool keep = std::find(
+							  keepActive.begin(), keepActive.end(), lm_idx) !=
+			keepActive.end();
+		if (keep) nObserved++;
+		ranking.emplace_back(
+			keep ? std::numeric_limits<KFTYPE>::max() : B.asEigen().norm(),
+			lm_idx);
+	}
+	const size_t nKeep = std::max(maxActive, nObserved);
+	if (nKeep >= ranking.size()) return;
+
+	std::sort(ranking.begin(), ranking.end(), [](const auto& a, const auto& b) {
+		return a.first > b.first;
+	});
+
+	// Dense submatrix of the information over (x, m+, m0), with m+ the
+	// landmarks that remain active, and m0 those to be deactivated:
+	std::vector<size_t> lms;
+	for (const auto& r : ranking)
+		lms.push_back(r.second);
+	const size_t N = VEH_SIZE + FEAT_SIZE * lms.size();
+	const auto off = [](size_t k) { return VEH_SIZE + k * FEAT_SIZE; };
+
+	using DenseMatrix = Eigen::Matrix<KFTYPE, Eigen::Dynamic, Eigen::Dynamic>;
+	DenseMatrix D = DenseMatrix::Zero(N, N);
+	D.template block<VEH_SIZE, VEH_SIZE>(0, 0) = m_info_vv.asEigen();
+	for (size_t a = 0; a < lms.size(); a++)
+	{
+		const auto& Bvl = m_info_vl.at(lms[a]).asEigen();
+		D.template block<VEH_SIZE, FEAT_SIZE>(0, off(a)) = Bvl;
+		D.template block<FEAT_SIZE, VEH_SIZE>(off(a), 0) = Bvl.transpose();
+		for (size_t b = a; b < lms.size(); b++)
+		{
+			const size_t i = std::min(lms[a], lms[b]);
+			const size_t j = std::max(lms[a], lms[b]);
+			const auto it = m_info_ll[i].find(j);
+			if (it == m_info_ll[i].end()) continue;
+			DenseMatrix Bll = it->second.asEigen();
+			if (lms[a] > lms[b]) Bll.transposeInPlace();
+			D.block(off(a), off(b), FEAT_SIZE, FEAT_SIZE) = Bll;
+			D.block(off(b), off(a), FEAT_SIZE, FEAT_SIZE) = Bll.transpose();
+		}
+	}
+
+	// D with the variables in "S" marginalized out (and their rows and
+	// columns set to zero):
+	const auto marginalize = [&D, N](const std::vector<size_t>& S) {
+		DenseMatrix D_S(N, S.size()), D_SS(S.size(), S.size());
+		for (size_t c = 0; c < S.size(); c++)
+			D_S.col(c) = D.col(S[c]);
+		for (size_t r = 0; r < S.size(); r++)
+			D_SS.row(r) = D_S.row(S[r]);
+		DenseMatrix ret = D - D_S * D_SS.ldlt().solve(D_S.transpose());
+		for (size_t s : S)
+		{
+			ret.row(s).setZero();
+			ret.col(s).setZero();
+		}
+		return ret;
+	};
+	std::vector<size_t> vars_x, vars_m0;
+	for (size_t k = 0; k < VEH_SIZE; k++)
+		vars_x.push_back(k);
+	for (size_t k = off(nKeep); k < N; k++)
+		vars_m0.push_back(k);
+	std::vector<size_t> vars_x_m0 = vars_x;
+	vars_x_m0.insert(vars_x_m0.end(), vars_m0.begin(), vars_m0.end());
+
+	// Sparsification as in Thrun et al. (IJRR 2004): approximate the joint
+	// of (x,m+,m0) by one without links between x and m0. The mean is kept.
+	const DenseMatrix newD =
+		marginalize(vars_m0) - marginalize(vars_x_m0) + marginalize(vars_x);
+
+	// Write back:
+	m_info_vv = newD.template block<VEH_SIZE, VEH_SIZE>(0, 0);
+	for (size_t a = 0; a < lms.size(); a++)
+	{
+		if (a < nKeep)
+			m_info_vl[lms[a]] =
+				newD.template block<VEH_SIZE, FEAT_SIZE>(0, off(a));
+		else
+			m_info_vl.erase(lms[a]);
+
+		for (size_t b = a; b < lms.size(); b++)
+		{
+			DenseMatrix Bll = newD.block(off(a), off(b), FEAT_SIZE, FEAT_SIZE);
+			if (lms[a] > lms[b]) Bll.transposeInPlace();
+			const size_t i = std::min(lms[a], lms[b]);
+			const size_t j = std::max(lms[a], lms[b]);
+			if (Bll.isZero(0))
+				m_info_ll[i].erase(j);
+			else
+				m_info_ll[i][j] = Bll;
+		}
+	}
+
+	m_infoFactor.reset();
+}
+
 namespace detail
 {
 // generic version for SLAM. There is a speciation below for NON-SLAM problems.
@@ -1042,6 +1412,21 @@ void addNewLandmarks(
 			for (q = 0; q < FEAT_SIZE; q++)
 				obj.internal_getXkk()[idx + q] = yn[q];
 
+			if (obj.m_infoForm)
+			{
+				// Information form: the new landmark is only linked to the
+				// vehicle, with the uncertainty of the inverse sensor model:
+				typename KF::KFMatrix_FxF P_yn_given_x;
+				if (use_dyn_dhn_jacobian)
+					P_yn_given_x = mrpt::math::multiply_HCHt(dyn_dhn, R);
+				else
+					P_yn_given_x = dyn_dhn_R_dyn_dhnT;
+				obj.SEIF_addLandmark(dyn_dxv, P_yn_given_x);
+
+				obj.getProfiler().leave("KF:9.create new LMs");
+				continue;
+			}
+
 			// --------------------
 			// Append to Pkk:
 			// --------------------
@@ -86,6 +86,14 @@ class CParticleFilter : public mrpt::system::COutputLogger
 	 *		- prSystematic: A single uniform sample is drawn in the range
 	 *(0,1/M].
 	 *
+	 * With a dynamic sample size (TParticleFilterOptions::adaptiveSampleSize)
+	 * only prMultinomial and prSystematic are allowed. Since the final number
+	 * of particles is not known in advance, prSystematic then draws the
+	 * sequence u_k = frac(u_0 + k*phi) (golden ratio phi, one uniform u_0), so
+	 * that any number of first samples is evenly spread, like in systematic
+	 * resampling, and KLD-sampling can stop at any time
+	 * (New in MRPT 2.4.9).
+	 *
 	 * See the theoretical discussion in <a
 	 *href="http://www.mrpt.org/Resampling_Schemes" >resampling schemes</a>.
 	 */
@@ -163,6 +171,15 @@ class CParticleFilter : public mrpt::system::COutputLogger
 		 * perform rejection sampling, but just the most-likely (ML) particle
 		 * found in the preliminary weight-determination stage. */
 		bool pfAuxFilterOptimal_MLE{false};
+
+		/** Number of threads used to predict and weight particles in the
+		 * "pfStandardProposal" implementation of mrpt::slam classes (MCL 2D
+		 * and 3D, RBPF mapping). 0 means using all hardware threads. Results
+		 * do not depend on the number of threads, but the observation
+		 * likelihood evaluation of the maps must be thread-safe.
+		 * (Default=1: single thread).
+		 */
+		unsigned int numThreads{1};
 	};
 
 	/** Statistics for being returned from the "execute" method. */
@@ -91,14 +91,14 @@ class CParticleFilterCapable
 	 *in TParticleFilterOptions. Those indexes are
 	 *			read sequentially by subsequent calls to fastDrawSample.
 	 *		- <b>DYNAMIC SAMPLE SIZE=YES</b>: Then:
-	 *			- If TParticleFilterOptions.resamplingMethod = prMultinomial,
-	 *the
+	 *			- If TParticleFilterOptions.resamplingMethod = prMultinomial
+	 *or prSystematic, the
 	 *internal buffers will be filled out (m_fastDrawAuxiliary.CDF, CDF_indexes
 	 *& PDF) and
 	 *				then fastDrawSample can be called an arbitrary number of
 	 *times
 	 *to
-	 *generate random indexes.
+	 *generate random indexes (see CParticleFilter::prSystematic).
 	 *			- For the rest of resampling algorithms, an exception will be
 	 *raised
 	 *since they are not appropriate for a dynamic (unknown in advance) number
@@ -277,6 +277,8 @@ class CParticleFilterCapable
 		std::vector<double> PDF;
 		std::vector<uint32_t> alreadyDrawnIndexes;
 		size_t alreadyDrawnNextOne{0};
+		/** For prSystematic with a dynamic sample size */
+		double systematicDraw{0};
 	};
 
 	/** Auxiliary vectors, see CParticleFilterCapable::prepareFastDrawSample for
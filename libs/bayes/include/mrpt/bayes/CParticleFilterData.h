@@ -16,6 +16,8 @@
 #include <algorithm>
 #include <cmath>
 #include <deque>
+#include <utility>
+#include <vector>
 
 namespace mrpt::bayes
 {
@@ -105,60 +107,85 @@ struct CParticleFilterDataImpl : public CParticleFilterCapable
 
 	/** Replaces the old particles by copies determined by the indexes in
 	 * "indx", performing an efficient copy of the necesary particles only and
-	 * allowing the number of particles to change.*/
+	 * allowing the number of particles to change.
+	 *
+	 * The substitution is done in place: the first copy of each surviving
+	 * particle keeps its slot, and only the *additional* copies of duplicated
+	 * particles are cloned, into the slots of the discarded ones (assigning
+	 * onto the existing payload objects, so their storage is reused). Hence,
+	 * the order of the output particles is not that of "indx".
+	 *
+	 * With particle_storage_mode::POINTER, the clones are made with the copy
+	 * operators of the payload type, so payloads with shared or copy-on-write
+	 * members (e.g. CMultiMetricMap::copyOnWrite) are cloned cheaply.
+	 *
+	 * \note In-place substitution is new in MRPT 2.4.9
+	 */
 	void performSubstitution(const std::vector<size_t>& indx) override
 	{
 		MRPT_START
-		// Ensure input indices are sorted
-		std::vector<size_t> sorted_indx(indx);
-		std::sort(sorted_indx.begin(), sorted_indx.end());
+		auto& parts = derived().m_particles;
+		const size_t M_old = parts.size(), M_new = indx.size();
+
+		// Number of copies of each old particle in the new set:
+		std::vector<size_t> count(M_old, 0);
+		for (const size_t i : indx)
+		{
+			ASSERTDEB_(i < M_old);
+			count[i]++;
+		}
 
-		/* Temporary buffer: */
-		particle_list_t parts;
-		parts.resize(sorted_indx.size());
+		// Slots of discarded particles, to be reused for the clones:
+		std::vector<size_t> freeSlots;
+		for (size_t i = 0; i < M_old; i++)
+			if (!count[i]) freeSlots.push_back(i);
 
-		// Implementation for particles as pointers:
-		if constexpr (
-			Derived::PARTICLE_STORAGE == particle_storage_mode::POINTER)
+		auto itFree = freeSlots.begin();
+		for (size_t i = 0; i < M_old; i++)
 		{
-			const size_t M_old = derived().m_particles.size();
-			// Index, in the *new* set, of reused particle data, indexed
-			// by *old* indices, or "-1" if not reused.
-			std::vector<int> reusedIdx(M_old, -1);
-			typename particle_list_t::iterator itDest;
-			for (size_t i = 0; i < parts.size(); i++)
+			for (size_t k = 1; k < count[i]; k++)
 			{
-				const size_t sorted_idx = sorted_indx[i];
-				parts[i].log_w = derived().m_particles[sorted_idx].log_w;
-
-				// The first time that the old particle "indx[i]" appears, we
-				// can reuse the old "data" instead of creating a new copy:
-				const int idx_of_this_in_new_set = reusedIdx[sorted_idx];
-				if (idx_of_this_in_new_set == -1)
+				size_t dst;
+				if (itFree != freeSlots.end()) dst = *(itFree++);
+				else
+				{
+					dst = parts.size();
+					parts.emplace_back();
+				}
+				auto& d = parts[dst];
+				const auto& src = parts[i];
+				d.log_w = src.log_w;
+				if constexpr (
+					Derived::PARTICLE_STORAGE == particle_storage_mode::POINTER)
 				{
-					// First time: Reuse the data from the particle.
-					parts[i].d = std::move(derived().m_particles[sorted_idx].d);
-					reusedIdx[sorted_idx] = i;
+					if (d.d && src.d) *d.d = *src.d;
+					else
+						d.d = src.d;
 				}
 				else
 				{
-					// Make a copy of the particle's data
-					// (The "= operator" already makes a deep copy)
-					parts[i].d = parts[idx_of_this_in_new_set].d;
+					d.d = src.d;
 				}
 			}
-			// Free memory of unused particles: Done automatically.
 		}
-		else
+
+		// Less particles than before: remove the unused slots, keeping the
+		// order of the rest. Note that swap() moves the payload pointers, and
+		// the discarded ones are destroyed by resize():
+		if (itFree != freeSlots.end())
 		{
-			// Implementation for particles as values:
-			auto it_idx = sorted_indx.begin();
-			auto itDest = parts.begin();
-			for (; itDest != parts.end(); ++it_idx, ++itDest)
-				*itDest = derived().m_particles[*it_idx];
+			size_t w = *itFree;
+			for (size_t r = w; r < M_old; r++)
+			{
+				if (itFree != freeSlots.end() && *itFree == r)
+				{
+					++itFree;
+					continue;
+				}
+				std::swap(parts[w++], parts[r]);
+			}
 		}
-		/* Move particles to the final container: */
-		derived().m_particles = std::move(parts);
+		parts.resize(M_new);
 		MRPT_END
 	}
 
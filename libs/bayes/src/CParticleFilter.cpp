@@ -136,6 +136,10 @@ void CParticleFilter::TParticleFilterOptions::saveToConfigFile(
 		pfAuxFilterStandard_FirstStageWeightsMonteCarlo,
 		"Only for PF_algorithm==pfAuxiliaryPFStandard");
 	MRPT_SAVE_CONFIG_VAR_COMMENT(pfAuxFilterOptimal_MLE, "See doxygen docs.");
+	MRPT_SAVE_CONFIG_VAR_COMMENT(
+		numThreads,
+		"Number of threads for particle prediction and weighting (0=all "
+		"hardware threads, default=1)");
 }
 
 /*---------------------------------------------------------------
@@ -178,6 +182,7 @@ void CParticleFilter::TParticleFilterOptions::loadFromConfigFile(
 		section.c_str());
 	MRPT_LOAD_CONFIG_VAR(
 		pfAuxFilterOptimal_MLE, bool, iniFile, section.c_str());
+	MRPT_LOAD_CONFIG_VAR(numThreads, int, iniFile, section.c_str());
 
 	MRPT_END
 }
@@ -13,6 +13,7 @@
 #include <mrpt/math/ops_vectors.h>
 #include <mrpt/random.h>
 
+#include <algorithm>
 #include <iostream>
 
 using namespace mrpt;
@@ -51,7 +52,7 @@ void CParticleFilterCapable::performResampling(
 	performSubstitution(indxs);
 
 	// Finally, equal weights:
-	for (size_t i = 0; i < out_particle_count; i++)
+	for (size_t i = 0; i < indxs.size(); i++)
 		setW(i, 0 /* Logarithmic weight */);
 
 	MRPT_END
@@ -366,10 +367,11 @@ void CParticleFilterCapable::prepareFastDrawSample(
 		// CASE: Dynamic number of particles:
 		//  -> Use m_fastDrawAuxiliary.CDF, PDF, CDF_indexes
 		// --------------------------------------------------------
-		if (PF_options.resamplingMethod != CParticleFilter::prMultinomial)
+		if (PF_options.resamplingMethod != CParticleFilter::prMultinomial &&
+			PF_options.resamplingMethod != CParticleFilter::prSystematic)
 			THROW_EXCEPTION(
-				"resamplingMethod must be 'prMultinomial' for a dynamic number "
-				"of particles!");
+				"resamplingMethod must be 'prMultinomial' or 'prSystematic' "
+				"for a dynamic number of particles!");
 
 		size_t i, j = 666666, M = particlesCount();
 
@@ -423,6 +425,9 @@ void CParticleFilterCapable::prepareFastDrawSample(
 
 		ASSERT_(j == PARTICLE_FILTER_CAPABLE_FAST_DRAW_BINS);
 
+		m_fastDrawAuxiliary.systematicDraw =
+			getRandomGenerator().drawUniform(0.0, 1.0);
+
 // Done!
 #if !defined(_MSC_VER) || (_MSC_VER > 1400)	 // <=VC2005 doesn't work with this!
 		MRPT_END_WITH_CLEAN_UP(/* Debug: */
@@ -483,12 +488,24 @@ size_t CParticleFilterCapable::fastDrawSample(
 		// CASE: Dynamic number of particles:
 		//  -> Use m_fastDrawAuxiliary.CDF, PDF, CDF_indexes
 		// --------------------------------------------------------
-		if (PF_options.resamplingMethod != CParticleFilter::prMultinomial)
+		if (PF_options.resamplingMethod != CParticleFilter::prMultinomial &&
+			PF_options.resamplingMethod != CParticleFilter::prSystematic)
 			THROW_EXCEPTION(
-				"resamplingMethod must be 'prMultinomial' for a dynamic number "
-				"of particles!");
+				"resamplingMethod must be 'prMultinomial' or 'prSystematic' "
+				"for a dynamic number of particles!");
 
-		double draw = getRandomGenerator().drawUniform(0.0, 0.999999);
+		double draw;
+		if (PF_options.resamplingMethod == CParticleFilter::prSystematic)
+		{
+			// Low-discrepancy sequence: draws are evenly spread in [0,1)
+			// for any number of samples:
+			double& u = m_fastDrawAuxiliary.systematicDraw;
+			u += 0.6180339887498949;  // Golden ratio - 1
+			if (u >= 1.0) u -= 1.0;
+			draw = std::min(u, 0.999999);
+		}
+		else
+			draw = getRandomGenerator().drawUniform(0.0, 0.999999);
 		double CDF_next = -1.;
 		double CDF = -1.;
 
@@ -0,0 +1,112 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/bayes/CParticleFilterData.h>
+
+#include <algorithm>
+
+using namespace mrpt::bayes;
+
+namespace
+{
+// A payload which counts how many times it is copied (not moved):
+struct TPayload
+{
+	TPayload() = default;
+	TPayload(const TPayload& o) : id(o.id) { copies++; }
+	TPayload(TPayload&&) = default;
+	TPayload& operator=(const TPayload& o)
+	{
+		id = o.id;
+		copies++;
+		return *this;
+	}
+	TPayload& operator=(TPayload&&) = default;
+	int id = -1;
+	static inline int copies = 0;
+};
+
+template <particle_storage_mode STORAGE>
+class CTestParticles
+	: public CParticleFilterData<TPayload, STORAGE>,
+	  public CParticleFilterDataImpl<
+		  CTestParticles<STORAGE>,
+		  typename CParticleFilterData<TPayload, STORAGE>::CParticleList>
+{
+   public:
+	explicit CTestParticles(size_t M)
+	{
+		this->m_particles.resize(M);
+		for (size_t i = 0; i < M; i++)
+		{
+			if constexpr (STORAGE == particle_storage_mode::POINTER)
+			{
+				this->m_particles[i].d.resetDefaultCtor();
+				this->m_particles[i].d->id = static_cast<int>(i);
+			}
+			else
+				this->m_particles[i].d.id = static_cast<int>(i);
+			this->m_particles[i].log_w = -1.0 * i;
+		}
+	}
+
+	int id(size_t i) const
+	{
+		if constexpr (STORAGE == particle_storage_mode::POINTER)
+			return this->m_particles[i].d->id;
+		else
+			return this->m_particles[i].d.id;
+	}
+};
+
+template <particle_storage_mode STORAGE>
+void testSubstitution(const std::vector<size_t>& indx)
+{
+	CTestParticles<STORAGE> pf(6);
+	TPayload::copies = 0;
+	pf.performSubstitution(indx);
+
+	ASSERT_EQ(pf.particlesCount(), indx.size());
+
+	// Same multiset of particles, whatever the order:
+	std::vector<size_t> ids;
+	for (size_t i = 0; i < pf.particlesCount(); i++)
+	{
+		ids.push_back(pf.id(i));
+		EXPECT_DOUBLE_EQ(pf.getW(i), -1.0 * pf.id(i));
+	}
+	std::vector<size_t> expected = indx;
+	std::sort(ids.begin(), ids.end());
+	std::sort(expected.begin(), expected.end());
+	EXPECT_EQ(ids, expected);
+
+	// Only the duplicates are copied:
+	const size_t nUnique =
+		std::unique(expected.begin(), expected.end()) - expected.begin();
+	EXPECT_EQ(TPayload::copies, static_cast<int>(indx.size() - nUnique));
+}
+}  // namespace
+
+TEST(CParticleFilterData, performSubstitution)
+{
+	const std::vector<std::vector<size_t>> tests = {
+		{0, 1, 2, 3, 4, 5},	 // Identity
+		{5, 4, 3, 2, 1, 0},	 // Permutation
+		{0, 0, 0, 3, 3, 5},	 // Same count
+		{2, 2, 2},	// Less particles
+		{1, 4, 5},	// Less particles, no duplicates
+		{0, 1, 1, 1, 3, 4, 4, 5, 5, 5}	// More particles
+	};
+	for (const auto& indx : tests)
+	{
+		testSubstitution<particle_storage_mode::VALUE>(indx);
+		testSubstitution<particle_storage_mode::POINTER>(indx);
+	}
+}
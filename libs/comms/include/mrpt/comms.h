@@ -13,4 +13,5 @@
 #include <mrpt/comms/CInterfaceFTDI.h>
 #include <mrpt/comms/CSerialPort.h>
 #include <mrpt/comms/CServerTCPSocket.h>
+#include <mrpt/comms/CSharedMemoryRingBuffer.h>
 #include <mrpt/comms/net_utils.h>
\ No newline at end of file
@@ -18,6 +18,11 @@
 
 namespace mrpt
 {
+namespace containers
+{
+class lockfree_byte_ring;
+}
+
 /** Serial and networking devices and utilities */
 namespace comms
 {
@@ -35,6 +40,7 @@ class CServerTCPSocket;
 class CClientTCPSocket : public mrpt::io::CStream
 {
 	friend class CServerTCPSocket;
+	friend class CTCPReactor;
 
    public:
 	/** See description of CClientTCPSocket */
@@ -141,6 +147,15 @@ class CClientTCPSocket : public mrpt::io::CStream
 		void* Buffer, const size_t Count, const int timeoutStart_ms = -1,
 		const int timeoutBetween_ms = -1);
 
+	/** Like readAsync(), but reads straight into the free space of a byte
+	 * ring, up to filling it, so a parser thread can consume the data in
+	 * place. The calling thread must be the only producer of the ring.
+	 * \return The number of bytes read (0 if the ring is full).
+	 * \note (New in MRPT 2.4.9) */
+	size_t readAsyncInto(
+		mrpt::containers::lockfree_byte_ring& ring,
+		const int timeoutStart_ms = -1, const int timeoutBetween_ms = -1);
+
 	/** A method for writing to the socket with optional timeouts.
 	 *  The method supports writing block by block as the socket allows us to
 	 * write more data.
@@ -11,6 +11,11 @@
 #include <mrpt/io/CStream.h>
 #include <mrpt/system/CTicTac.h>
 
+namespace mrpt::containers
+{
+class lockfree_byte_ring;
+}
+
 namespace mrpt::comms
 {
 /** A communications serial port implementing the interface mrpt::io::CStream.
@@ -121,6 +126,15 @@ class CSerialPort : public mrpt::io::CStream
 	 */
 	size_t Read(void* Buffer, size_t Count) override;
 
+	/** Like Read(), but reads straight into the free space of a byte ring,
+	 * up to filling it, so a parser thread can consume the data in place.
+	 * The calling thread must be the only producer of the ring.
+	 * eturn The number of bytes read (0 if the ring is full).
+	 * \exception std::exception On communication errors
+	 * 
+ote (New in MRPT 2.4.9) */
+	size_t ReadInto(mrpt::containers::lockfree_byte_ring& ring);
+
 	/** Reads one text line from the serial port in POSIX "canonical mode".
 	 *  This method reads from the serial port until one of the characters in
 	 * \a eol are found.
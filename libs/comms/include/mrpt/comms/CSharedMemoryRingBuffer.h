@@ -0,0 +1,139 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace mrpt::comms
+{
+/** A lock-free, multi-producer, multi-consumer broadcast ring buffer of
+ * messages, living in a named shared memory segment, so it can be used to
+ * exchange data between processes on the same machine.
+ *
+ * The segment holds a fixed number of slots, each with room for one message
+ * of up to slotCapacity() bytes. Writers reserve slots with an atomic
+ * counter and never wait for readers: once the ring wraps around, the oldest
+ * messages are overwritten. Each reader keeps its own cursor (the index of
+ * the next message to read), and is told if it lagged behind and lost
+ * messages. Slots are protected by sequence numbers (a "seqlock"), so readers
+ * never see a partially written message.
+ *
+ * One process creates the segment with Create() and the others attach to it
+ * with Open(). The segment name is removed from the system when its creator
+ * object is destroyed, but processes that already opened it can keep using
+ * it until they close it.
+ *
+ * This is the transport used by mrpt::comms::SharedMemoryTopicReceiver and
+ * mrpt::comms::bridgeTopicToSharedMemory() to connect nodelets Topics across
+ * processes (see `#include <mrpt/comms/SharedMemoryTopic.h>`).
+ *
+ * \note Implemented for POSIX shared memory (`shm_open()`) and Windows file
+ * mappings.
+ * \note (New in MRPT 2.4.9)
+ * \ingroup mrpt_comms_grp
+ */
+class CSharedMemoryRingBuffer
+{
+   public:
+	using Ptr = std::shared_ptr<CSharedMemoryRingBuffer>;
+
+	struct Parameters
+	{
+		/** Number of messages kept in the ring */
+		size_t numSlots = 32;
+		/** Maximum length of each message, in bytes */
+		size_t slotCapacity = 4 * 1024 * 1024;
+	};
+
+	/** Creates a new shared memory ring buffer with the given name.
+	 * \exception std::exception If the segment already exists or on any
+	 * system error. */
+	static Ptr Create(const std::string& name, const Parameters& p);
+	/** \overload with default parameters */
+	static Ptr Create(const std::string& name)
+	{
+		return Create(name, Parameters());
+	}
+
+	/** Attaches to an existing shared memory ring buffer, waiting up to
+	 * `timeout_seconds` for its creator to set it up.
+	 * \exception std::exception If it does not exist after the timeout, or
+	 * on any system error. */
+	static Ptr Open(const std::string& name, double timeout_seconds = 0);
+
+	~CSharedMemoryRingBuffer();
+
+	CSharedMemoryRingBuffer(const CSharedMemoryRingBuffer&) = delete;
+	CSharedMemoryRingBuffer& operator=(const CSharedMemoryRingBuffer&) =
+		delete;
+
+	const std::string& name() const { return m_name; }
+	size_t numSlots() const;
+	size_t slotCapacity() const;
+	/** Whether this object created the segment (and will remove it) */
+	bool isOwner() const { return m_owner; }
+
+	/** Total number of messages written so far, i.e. the index that the next
+	 * message will get. New readers normally start reading from here. */
+	uint64_t writeIndex() const;
+
+	/** Writes a copy of a message into the ring.
+	 * \exception std::exception If len > slotCapacity() */
+	void write(const void* data, size_t len);
+
+	/** Writes a message directly into a reserved slot of the ring, with no
+	 * intermediate copy: `fill` gets the slot memory and its capacity, and
+	 * must return the actual length of the message. If it throws, the slot
+	 * is released without publishing anything and the exception propagates
+	 * to the caller. */
+	void writeInPlace(const std::function<size_t(void*, size_t)>& fill);
+
+	enum class ReadResult : uint8_t
+	{
+		/** One message was read and `cursor` advanced. */
+		Ok = 0,
+		/** There are no new messages yet. */
+		NoData,
+		/** The reader lagged behind and the message at `cursor` was
+		 * overwritten. `cursor` is moved forward to the oldest message still
+		 * available; just call read() again. */
+		Overrun
+	};
+
+	/** Reads the message with index `cursor` into `out`.
+	 * \param[in,out] cursor Index of the message to read, updated by this
+	 * method.
+	 * \param[out] numLost If not null, incremented with the number of lost
+	 * messages upon ReadResult::Overrun. */
+	ReadResult read(
+		uint64_t& cursor, std::vector<uint8_t>& out,
+		uint64_t* numLost = nullptr) const;
+
+   private:
+	CSharedMemoryRingBuffer() = default;
+
+	struct Header;
+	struct SlotHeader;
+
+	SlotHeader& slot(uint64_t index) const;
+	uint64_t reserveSlot() const;
+
+	std::string m_name;
+	bool m_owner = false;
+	void* m_base = nullptr;
+	size_t m_mappedSize = 0;
+	/** OS handle (file descriptor or HANDLE) */
+	intptr_t m_handle = -1;
+};
+
+}  // namespace mrpt::comms
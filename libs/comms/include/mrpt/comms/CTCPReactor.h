@@ -0,0 +1,193 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/serialization/CMessage.h>
+#include <mrpt/system/COutputLogger.h>
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace mrpt::comms
+{
+class CClientTCPSocket;
+
+/** An event loop serving many TCP connections from a single thread, with
+ * non-blocking sockets, for servers with many clients (e.g. telemetry from a
+ * fleet of robots) where one thread per connection, as with
+ * CServerTCPSocket::accept() and CClientTCPSocket::receiveMessage(), does not
+ * scale.
+ *
+ * The reactor accepts connections on any number of listening ports (see
+ * listen()), and also handles outgoing connections (connect()) or already
+ * connected sockets (addConnection()). Each connection is identified by a
+ * connection_id_t, never reused within a reactor.
+ *
+ * Data is exchanged as mrpt::serialization::CMessage objects, framed in the
+ * same format than CClientTCPSocket::sendMessage() and
+ * CClientTCPSocket::receiveMessage(), so the reactor interoperates with
+ * regular blocking sockets on the other side. Incoming messages are passed to
+ * the callback set with setOnMessage() as soon as complete, and outgoing ones
+ * are queued per connection by sendMessage() (which never blocks) and written
+ * as the socket accepts more data.
+ *
+ * All the I/O and callbacks happen in the thread running the loop: either a
+ * thread of the reactor, with start(), or a user thread calling runOnce().
+ * Callbacks must return quickly, and must be set before starting the loop.
+ * Other methods may be called from any thread, including the callbacks.
+ *
+ * Events are waited for with `epoll` in Linux, `kqueue` in macOS and BSD
+ * systems, and `poll()` (`WSAPoll()` in Windows) otherwise.
+ *
+ * \code
+ * mrpt::comms::CTCPReactor reactor;
+ * reactor.setOnMessage([&](auto conn, const mrpt::serialization::CMessage& m)
+ * {
+ *     // Echo back:
+ *     reactor.sendMessage(conn, m);
+ * });
+ * reactor.listen(23000, "0.0.0.0");
+ * reactor.start();
+ * \endcode
+ *
+ * \sa CServerTCPSocket, CClientTCPSocket
+ * \note (New in MRPT 2.4.9)
+ * \ingroup mrpt_comms_grp
+ */
+class CTCPReactor : public mrpt::system::COutputLogger
+{
+   public:
+	using connection_id_t = uint64_t;
+
+	CTCPReactor();
+	/** Stops the loop thread, if running, and closes all the sockets */
+	~CTCPReactor() override;
+
+	CTCPReactor(const CTCPReactor&) = delete;
+	CTCPReactor& operator=(const CTCPReactor&) = delete;
+
+	/** @name Callbacks (to be set before running the loop)
+	 * @{ */
+	using on_connection_t = std::function<void(connection_id_t)>;
+	using on_message_t = std::function<void(
+		connection_id_t, const mrpt::serialization::CMessage&)>;
+
+	/** Called for each new connection, accepted or added */
+	void setOnConnection(const on_connection_t& f) { m_onConnection = f; }
+	/** Called for each message received */
+	void setOnMessage(const on_message_t& f) { m_onMessage = f; }
+	/** Called when a connection is closed: by the remote side, by
+	 * closeConnection(), or upon a socket or framing error. */
+	void setOnDisconnection(const on_connection_t& f)
+	{
+		m_onDisconnection = f;
+	}
+	/** @} */
+
+	/** @name Connections
+	 * @{ */
+	/** Starts listening for incoming connections, which are accepted by the
+	 * loop.
+	 * \param IPaddress The interface to bound the socket to, "0.0.0.0" for
+	 * all of them.
+	 * \exception std::exception On any error creating the socket. */
+	void listen(
+		unsigned short listenPort,
+		const std::string& IPaddress = std::string("127.0.0.1"),
+		int maxConnectionsWaiting = 50);
+
+	/** Connects to a TCP server (this call blocks until connected, see
+	 * CClientTCPSocket::connect()) and adds the connection to the reactor.
+	 * \exception std::exception On connection errors. */
+	connection_id_t connect(
+		const std::string& remotePartAddress, unsigned short remotePartTCPPort,
+		unsigned int timeout_ms = 3000);
+
+	/** Moves an already connected socket into the reactor, which becomes
+	 * the owner of the connection: `sock` is left disconnected. */
+	connection_id_t addConnection(CClientTCPSocket& sock);
+
+	/** Closes a connection, discarding its pending outgoing messages.
+	 * \return false if the connection does not exist (anymore). */
+	bool closeConnection(connection_id_t conn);
+
+	/** Number of open connections (not counting listening sockets) */
+	size_t getConnectionCount() const;
+
+	/** Returns the remote IP address and port of a connection, or an empty
+	 * string and 0 if it does not exist. */
+	std::string getRemoteAddress(
+		connection_id_t conn, unsigned short* port = nullptr) const;
+	/** @} */
+
+	/** @name Messages
+	 * @{ */
+	/** Queues a message to be sent through a connection. This call never
+	 * blocks.
+	 * \return false if the connection does not exist, or if its queue of
+	 * outgoing data would exceed getMaxWriteQueueBytes() (the message is
+	 * then dropped). */
+	bool sendMessage(
+		connection_id_t conn, const mrpt::serialization::CMessage& msg);
+
+	/** Queues a message to all the open connections.
+	 * \return The number of connections it was queued to. */
+	size_t broadcastMessage(const mrpt::serialization::CMessage& msg);
+
+	/** Bytes queued in a connection, waiting to be written */
+	size_t getWriteQueueBytes(connection_id_t conn) const;
+
+	/** Maximum bytes waiting to be written per connection (default: 64 MB),
+	 * to bound the memory used by slow receivers. */
+	void setMaxWriteQueueBytes(size_t n) { m_maxWriteQueueBytes = n; }
+	size_t getMaxWriteQueueBytes() const { return m_maxWriteQueueBytes; }
+
+	/** Incoming messages with longer contents are considered a framing error
+	 * and their connection is closed (default: 256 MB). */
+	void setMaxMessageLength(size_t n) { m_maxMessageLength = n; }
+	size_t getMaxMessageLength() const { return m_maxMessageLength; }
+	/** @} */
+
+	/** @name Event loop
+	 * @{ */
+	/** Runs the loop in a new thread, until stop() */
+	void start();
+	/** Stops the loop thread started by start(), and waits for it to end.
+	 * Connections remain open. */
+	void stop();
+	bool isRunning() const { return m_thread.joinable(); }
+
+	/** Waits for events up to `timeout_ms` milliseconds (-1: forever, until
+	 * some event or a call to wakeUp()) and processes them, for users who run
+	 * the loop in their own thread. Do not use together with start(). */
+	void runOnce(int timeout_ms = -1);
+
+	/** Makes runOnce() return as soon as possible */
+	void wakeUp();
+	/** @} */
+
+   private:
+	struct Impl;
+	std::unique_ptr<Impl> m_impl;
+
+	on_connection_t m_onConnection, m_onDisconnection;
+	on_message_t m_onMessage;
+
+	size_t m_maxWriteQueueBytes = 64 * 1024 * 1024;
+	size_t m_maxMessageLength = 256 * 1024 * 1024;
+
+	std::thread m_thread;
+	std::atomic_bool m_stopRequested{false};
+};
+
+}  // namespace mrpt::comms
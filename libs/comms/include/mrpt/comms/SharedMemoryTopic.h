@@ -0,0 +1,208 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/comms/CSharedMemoryRingBuffer.h>
+#include <mrpt/comms/nodelets.h>
+#include <mrpt/io/CMemoryStream.h>
+#include <mrpt/serialization/CArchive.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+
+namespace mrpt::comms
+{
+/** \addtogroup mrpt_comms_grp
+ * @{ */
+
+namespace internal
+{
+/** A write-only stream into a fixed block of memory. Writes beyond its end
+ * are truncated, which makes CArchive throw. */
+class CFixedBufferOutputStream : public mrpt::io::CStream
+{
+   public:
+	CFixedBufferOutputStream(void* data, size_t capacity)
+		: m_data(static_cast<uint8_t*>(data)), m_capacity(capacity)
+	{
+	}
+	size_t Read(void*, size_t) override
+	{
+		throw std::runtime_error("[CFixedBufferOutputStream] Write-only");
+	}
+	size_t Write(const void* Buffer, size_t Count) override
+	{
+		const size_t n = std::min(Count, m_capacity - m_position);
+		std::memcpy(m_data + m_position, Buffer, n);
+		m_position += n;
+		return n;
+	}
+	uint64_t Seek(int64_t, CStream::TSeekOrigin) override
+	{
+		throw std::runtime_error("[CFixedBufferOutputStream] Not seekable");
+	}
+	uint64_t getTotalBytesCount() const override { return m_position; }
+	uint64_t getPosition() const override { return m_position; }
+
+   private:
+	uint8_t* m_data;
+	size_t m_capacity, m_position = 0;
+};
+}  // namespace internal
+
+/** Forwards all the messages of type `T` published to a local nodelets Topic
+ * to a shared memory ring buffer, from which other processes can publish them
+ * into their own Topics with a SharedMemoryTopicReceiver.
+ *
+ * `T` must be a smart pointer to a mrpt::serialization::CSerializable class,
+ * for example mrpt::obs::CObservation::Ptr. Each message is serialized
+ * directly into the shared memory, with no intermediate copy. Messages not
+ * fitting into CSharedMemoryRingBuffer::slotCapacity() are dropped, with an
+ * error message to std::cerr.
+ *
+ * \return The Topic subscriber which does the forwarding, which must be kept
+ * alive as long as messages are to be forwarded.
+ *
+ * \code
+ * // Driver process:
+ * auto ring = CSharedMemoryRingBuffer::Create("/mrpt_obs");
+ * auto topic = dir->getTopic("/obs");
+ * auto bridge = bridgeTopicToSharedMemory<CObservation::Ptr>(topic, ring);
+ * topic->publish(obs);  // as usual
+ *
+ * // SLAM process:
+ * auto ring = CSharedMemoryRingBuffer::Open("/mrpt_obs", 5.0);
+ * auto topic = dir->getTopic("/obs");
+ * auto sub = topic->createSubscriber<CObservation::Ptr>(...);  // as usual
+ * SharedMemoryTopicReceiver<CObservation::Ptr> rx(topic, ring);
+ * \endcode
+ *
+ * \note Do not bridge a topic in both directions with the same ring, or each
+ * message would be published back and forth forever.
+ * \note (New in MRPT 2.4.9)
+ */
+template <class T>
+Subscriber::Ptr bridgeTopicToSharedMemory(
+	const Topic::Ptr& topic, const CSharedMemoryRingBuffer::Ptr& ring)
+{
+	return topic->createSubscriber<T>([ring](const T& msg) {
+		if (!msg) return;
+		try
+		{
+			ring->writeInPlace([&](void* dst, size_t capacity) {
+				internal::CFixedBufferOutputStream out(dst, capacity);
+				mrpt::serialization::archiveFrom(out).WriteObject(msg.get());
+				return static_cast<size_t>(out.getPosition());
+			});
+		}
+		catch (const std::exception& e)
+		{
+			std::cerr << "[bridgeTopicToSharedMemory] Error sending to '"
+					  << ring->name() << "': " << e.what() << std::endl;
+		}
+	});
+}
+
+/** Publishes into a local nodelets Topic all messages of type `T` written
+ * to a shared memory ring buffer by another process with
+ * bridgeTopicToSharedMemory(). A thread, running while this object exists,
+ * polls the ring and deserializes its messages, and subscribers to the
+ * Topic are then invoked from that thread.
+ *
+ * Messages are received starting from the moment this object is created.
+ * If the Topic subscribers are too slow to keep up with the publisher, the
+ * oldest messages are lost (see lostCount()).
+ *
+ * \note (New in MRPT 2.4.9)
+ */
+template <class T>
+class SharedMemoryTopicReceiver
+{
+   public:
+	using Ptr = std::shared_ptr<SharedMemoryTopicReceiver<T>>;
+
+	/** \param pollPeriod Time to sleep when there are no new messages. */
+	SharedMemoryTopicReceiver(
+		const Topic::Ptr& topic, const CSharedMemoryRingBuffer::Ptr& ring,
+		std::chrono::microseconds pollPeriod = std::chrono::microseconds(200))
+		: m_topic(topic),
+		  m_ring(ring),
+		  m_cursor(ring->writeIndex()),
+		  m_thread([this, pollPeriod]() { run(pollPeriod); })
+	{
+	}
+
+	~SharedMemoryTopicReceiver()
+	{
+		m_stop = true;
+		if (m_thread.joinable()) m_thread.join();
+	}
+
+	SharedMemoryTopicReceiver(const SharedMemoryTopicReceiver&) = delete;
+	SharedMemoryTopicReceiver& operator=(const SharedMemoryTopicReceiver&) =
+		delete;
+
+	/** Number of messages published into the Topic so far */
+	uint64_t receivedCount() const { return m_received; }
+	/** Number of messages missed because this receiver lagged behind */
+	uint64_t lostCount() const { return m_lost; }
+
+   private:
+	Topic::Ptr m_topic;
+	CSharedMemoryRingBuffer::Ptr m_ring;
+	uint64_t m_cursor;
+	std::atomic<uint64_t> m_received{0}, m_lost{0};
+	std::atomic_bool m_stop{false};
+	std::thread m_thread;  // Must be the last member
+
+	void run(std::chrono::microseconds pollPeriod)
+	{
+		std::vector<uint8_t> buf;
+		mrpt::io::CMemoryStream ms;
+		while (!m_stop)
+		{
+			uint64_t lost = 0;
+			switch (m_ring->read(m_cursor, buf, &lost))
+			{
+				case CSharedMemoryRingBuffer::ReadResult::NoData:
+					std::this_thread::sleep_for(pollPeriod);
+					break;
+				case CSharedMemoryRingBuffer::ReadResult::Overrun:
+					m_lost += lost;
+					break;
+				case CSharedMemoryRingBuffer::ReadResult::Ok:
+					try
+					{
+						ms.assignMemoryNotOwn(buf.data(), buf.size());
+						auto obj = mrpt::serialization::archiveFrom(ms)
+									   .ReadObject<typename T::element_type>();
+						m_received++;
+						m_topic->publish(T(std::move(obj)));
+					}
+					catch (const std::exception& e)
+					{
+						std::cerr << "[SharedMemoryTopicReceiver] Error "
+									 "receiving from '"
+								  << m_ring->name() << "': " << e.what()
+								  << std::endl;
+					}
+					break;
+			}
+		}
+	}
+};
+
+/** @} */  // end grouping
+
+}  // namespace mrpt::comms
@@ -11,6 +11,7 @@
 //
 #include <mrpt/comms/CClientTCPSocket.h>
 #include <mrpt/comms/net_utils.h>
+#include <mrpt/containers/lockfree_byte_ring.h>
 #include <mrpt/core/exceptions.h>
 
 #include <cstring>
@@ -461,6 +462,28 @@ size_t CClientTCPSocket::readAsync(
 	MRPT_END
 }
 
+size_t CClientTCPSocket::readAsyncInto(
+	mrpt::containers::lockfree_byte_ring& ring, const int timeoutStart_ms,
+	const int timeoutBetween_ms)
+{
+	// The free space may be split in two spans, if it wraps around the end of
+	// the ring storage:
+	size_t total = 0;
+	for (int span = 0; span < 2; span++)
+	{
+		size_t n;
+		uint8_t* p = ring.prepare_write(n);
+		if (!n) break;
+		const size_t nRead = readAsync(
+			p, n, total == 0 ? timeoutStart_ms : timeoutBetween_ms,
+			timeoutBetween_ms);
+		ring.commit_write(nRead);
+		total += nRead;
+		if (nRead < n) break;
+	}
+	return total;
+}
+
 /*---------------------------------------------------------------
 						writeAsync
  ---------------------------------------------------------------*/
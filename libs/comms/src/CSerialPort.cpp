@@ -10,6 +10,7 @@
 #include "comms-precomp.h"	// Precompiled headers
 //
 #include <mrpt/comms/CSerialPort.h>
+#include <mrpt/containers/lockfree_byte_ring.h>
 #include <mrpt/core/exceptions.h>
 #include <mrpt/system/os.h>
 
@@ -638,6 +639,24 @@ size_t CSerialPort::Read(void* Buffer, size_t Count)
 	MRPT_END
 }
 
+size_t CSerialPort::ReadInto(mrpt::containers::lockfree_byte_ring& ring)
+{
+	// The free space may be split in two spans, if it wraps around the end of
+	// the ring storage:
+	size_t total = 0;
+	for (int span = 0; span < 2; span++)
+	{
+		size_t n;
+		uint8_t* p = ring.prepare_write(n);
+		if (!n) break;
+		const size_t nRead = Read(p, n);
+		ring.commit_write(nRead);
+		total += nRead;
+		if (nRead < n) break;
+	}
+	return total;
+}
+
 /** Reads one text line from the serial port in POSIX "canonical mode".
  *  This method reads from the serial port until one of the characters in \a
  * eol are found.
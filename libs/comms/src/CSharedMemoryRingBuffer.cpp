@@ -0,0 +1,400 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "comms-precomp.h"	// Precompiled headers
+//
+#include <mrpt/comms/CSharedMemoryRingBuffer.h>
+#include <mrpt/core/exceptions.h>
+#include <mrpt/core/format.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <thread>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#endif
+
+using namespace mrpt::comms;
+
+static_assert(
+	std::atomic<uint64_t>::is_always_lock_free,
+	"Shared memory ring buffers require lock-free 64bit atomics");
+
+namespace
+{
+constexpr uint32_t SHM_RING_MAGIC = 0x4D52494E;  // "MRIN"
+constexpr uint32_t SHM_RING_VERSION = 1;
+constexpr size_t CACHE_LINE = 64;
+
+constexpr size_t roundUp(size_t n, size_t align)
+{
+	return ((n + align - 1) / align) * align;
+}
+
+// Max. number of times a writer yields waiting for a slot still being
+// written by a writer N messages behind (normally, never happens), before
+// assuming that writer died and taking over the slot.
+constexpr unsigned MAX_WRITER_SPINS = 100000;
+}  // namespace
+
+// The layout of the segment is: the Header, then numSlots slots, each made of
+// a SlotHeader followed by slotCapacity bytes of data, all aligned to cache
+// lines. The memory of a new segment is zero-filled, which is the valid
+// initial state of all slots.
+struct CSharedMemoryRingBuffer::Header
+{
+	std::atomic<uint32_t> magic;
+	uint32_t version;
+	uint64_t numSlots;
+	uint64_t slotCapacity;
+	uint64_t slotStride;
+	/** Number of slots reserved by writers so far */
+	alignas(CACHE_LINE) std::atomic<uint64_t> writeTicket;
+};
+
+// The message with index `t` lives in slot `t % numSlots`, whose `seq` is
+// `2t+1` while it is being written, and `2t+2` once it is complete.
+struct CSharedMemoryRingBuffer::SlotHeader
+{
+	std::atomic<uint64_t> seq;
+	uint64_t length;
+};
+
+namespace
+{
+constexpr size_t HEADER_SIZE = 2 * CACHE_LINE;
+constexpr size_t SLOT_HEADER_SIZE = CACHE_LINE;
+
+std::string systemName(const std::string& name)
+{
+	std::string s = name;
+	if (!s.empty() && s[0] == '/') s.erase(0, 1);
+	ASSERTMSG_(!s.empty(), "Empty shared memory segment name");
+	std::replace(s.begin(), s.end(), '/', '_');
+#ifdef _WIN32
+	return "Local\\" + s;
+#else
+	return "/" + s;
+#endif
+}
+}  // namespace
+
+CSharedMemoryRingBuffer::Ptr CSharedMemoryRingBuffer::Create(
+	const std::string& name, const Parameters& p)
+{
+	static_assert(sizeof(Header) <= HEADER_SIZE);
+	static_assert(sizeof(SlotHeader) <= SLOT_HEADER_SIZE);
+	ASSERT_GT_(p.numSlots, 0U);
+	ASSERT_GT_(p.slotCapacity, 0U);
+
+	const size_t stride =
+		roundUp(SLOT_HEADER_SIZE + p.slotCapacity, CACHE_LINE);
+	const size_t totalSize = HEADER_SIZE + stride * p.numSlots;
+	const std::string sysName = systemName(name);
+
+	auto ring = Ptr(new CSharedMemoryRingBuffer);
+	ring->m_name = name;
+	ring->m_owner = true;
+	ring->m_mappedSize = totalSize;
+
+#ifdef _WIN32
+	HANDLE h = CreateFileMappingA(
+		INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+		static_cast<DWORD>(static_cast<uint64_t>(totalSize) >> 32),
+		static_cast<DWORD>(totalSize & 0xFFFFFFFF), sysName.c_str());
+	if (!h)
+		THROW_EXCEPTION_FMT(
+			"Error creating shared memory '%s' (error %u)", sysName.c_str(),
+			static_cast<unsigned>(GetLastError()));
+	if (GetLastError() == ERROR_ALREADY_EXISTS)
+	{
+		CloseHandle(h);
+		THROW_EXCEPTION_FMT(
+			"Shared memory '%s' already exists", sysName.c_str());
+	}
+	ring->m_handle = reinterpret_cast<intptr_t>(h);
+	ring->m_base = MapViewOfFile(h, FILE_MAP_ALL_ACCESS, 0, 0, totalSize);
+	if (!ring->m_base)
+		THROW_EXCEPTION_FMT(
+			"Error mapping shared memory '%s' (error %u)", sysName.c_str(),
+			static_cast<unsigned>(GetLastError()));
+#else
+	const int fd = ::shm_open(sysName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0660);
+	if (fd < 0)
+		THROW_EXCEPTION_FMT(
+			"Error creating shared memory '%s': %s", sysName.c_str(),
+			std::strerror(errno));
+	ring->m_handle = fd;
+	if (0 != ::ftruncate(fd, static_cast<off_t>(totalSize)))
+		THROW_EXCEPTION_FMT(
+			"Error resizing shared memory '%s': %s", sysName.c_str(),
+			std::strerror(errno));
+	void* base =
+		::mmap(nullptr, totalSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (base == MAP_FAILED)
+		THROW_EXCEPTION_FMT(
+			"Error mapping shared memory '%s': %s", sysName.c_str(),
+			std::strerror(errno));
+	ring->m_base = base;
+#endif
+
+	auto* hdr = new (ring->m_base) Header();
+	hdr->version = SHM_RING_VERSION;
+	hdr->numSlots = p.numSlots;
+	hdr->slotCapacity = p.slotCapacity;
+	hdr->slotStride = stride;
+	hdr->writeTicket.store(0, std::memory_order_relaxed);
+	for (size_t i = 0; i < p.numSlots; i++)
+		new (&ring->slot(i)) SlotHeader();
+	// Let readers in:
+	hdr->magic.store(SHM_RING_MAGIC, std::memory_order_release);
+
+	return ring;
+}
+
+CSharedMemoryRingBuffer::Ptr CSharedMemoryRingBuffer::Open(
+	const std::string& name, double timeout_seconds)
+{
+	const std::string sysName = systemName(name);
+	const auto deadline = std::chrono::steady_clock::now() +
+		std::chrono::duration<double>(timeout_seconds);
+	const auto timedOut = [&]() {
+		if (std::chrono::steady_clock::now() >= deadline) return true;
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		return false;
+	};
+
+	auto ring = Ptr(new CSharedMemoryRingBuffer);
+	ring->m_name = name;
+	ring->m_owner = false;
+
+#ifdef _WIN32
+	HANDLE h = nullptr;
+	while (!(h = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, sysName.c_str())))
+	{
+		if (timedOut())
+			THROW_EXCEPTION_FMT(
+				"Error opening shared memory '%s' (error %u)", sysName.c_str(),
+				static_cast<unsigned>(GetLastError()));
+	}
+	ring->m_handle = reinterpret_cast<intptr_t>(h);
+	ring->m_base = MapViewOfFile(h, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+	if (!ring->m_base)
+		THROW_EXCEPTION_FMT(
+			"Error mapping shared memory '%s' (error %u)", sysName.c_str(),
+			static_cast<unsigned>(GetLastError()));
+	MEMORY_BASIC_INFORMATION mbi;
+	VirtualQuery(ring->m_base, &mbi, sizeof(mbi));
+	ring->m_mappedSize = mbi.RegionSize;
+#else
+	int fd = -1;
+	while ((fd = ::shm_open(sysName.c_str(), O_RDWR, 0)) < 0)
+	{
+		if (timedOut())
+			THROW_EXCEPTION_FMT(
+				"Error opening shared memory '%s': %s", sysName.c_str(),
+				std::strerror(errno));
+	}
+	ring->m_handle = fd;
+	// Wait for the creator to set its size:
+	struct stat st;
+	for (;;)
+	{
+		if (0 != ::fstat(fd, &st))
+			THROW_EXCEPTION_FMT(
+				"Error in fstat() for shared memory '%s': %s", sysName.c_str(),
+				std::strerror(errno));
+		if (static_cast<size_t>(st.st_size) >= HEADER_SIZE) break;
+		if (timedOut())
+			THROW_EXCEPTION_FMT(
+				"Timeout waiting for shared memory '%s' to be initialized",
+				sysName.c_str());
+	}
+	ring->m_mappedSize = static_cast<size_t>(st.st_size);
+	void* base = ::mmap(
+		nullptr, ring->m_mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd,
+		0);
+	if (base == MAP_FAILED)
+		THROW_EXCEPTION_FMT(
+			"Error mapping shared memory '%s': %s", sysName.c_str(),
+			std::strerror(errno));
+	ring->m_base = base;
+#endif
+
+	auto* hdr = static_cast<Header*>(ring->m_base);
+	while (hdr->magic.load(std::memory_order_acquire) != SHM_RING_MAGIC)
+	{
+		if (timedOut())
+			THROW_EXCEPTION_FMT(
+				"Shared memory '%s' is not a CSharedMemoryRingBuffer",
+				sysName.c_str());
+	}
+	if (hdr->version != SHM_RING_VERSION)
+		THROW_EXCEPTION_FMT(
+			"Shared memory '%s' has unsupported version %u", sysName.c_str(),
+			static_cast<unsigned>(hdr->version));
+	ASSERT_GE_(
+		ring->m_mappedSize, HEADER_SIZE + hdr->slotStride * hdr->numSlots);
+	return ring;
+}
+
+CSharedMemoryRingBuffer::~CSharedMemoryRingBuffer()
+{
+#ifdef _WIN32
+	if (m_base) UnmapViewOfFile(m_base);
+	if (m_handle != -1) CloseHandle(reinterpret_cast<HANDLE>(m_handle));
+#else
+	if (m_base) ::munmap(m_base, m_mappedSize);
+	if (m_handle != -1) ::close(static_cast<int>(m_handle));
+	if (m_owner) ::shm_unlink(systemName(m_name).c_str());
+#endif
+}
+
+size_t CSharedMemoryRingBuffer::numSlots() const
+{
+	return static_cast<const Header*>(m_base)->numSlots;
+}
+size_t CSharedMemoryRingBuffer::slotCapacity() const
+{
+	return static_cast<const Header*>(m_base)->slotCapacity;
+}
+uint64_t CSharedMemoryRingBuffer::writeIndex() const
+{
+	return static_cast<const Header*>(m_base)->writeTicket.load(
+		std::memory_order_acquire);
+}
+
+CSharedMemoryRingBuffer::SlotHeader& CSharedMemoryRingBuffer::slot(
+	uint64_t index) const
+{
+	const auto* hdr = static_cast<const Header*>(m_base);
+	auto* p = static_cast<uint8_t*>(m_base) + HEADER_SIZE +
+		hdr->slotStride * (index % hdr->numSlots);
+	return *reinterpret_cast<SlotHeader*>(p);
+}
+
+// Returns the index of the reserved message, already marked as being written,
+// or UINT64_MAX if its slot was already taken by a newer message (only if
+// this thread was suspended while numSlots newer messages were written).
+uint64_t CSharedMemoryRingBuffer::reserveSlot() const
+{
+	auto* hdr = static_cast<Header*>(m_base);
+	const uint64_t t = hdr->writeTicket.fetch_add(1, std::memory_order_acq_rel);
+	auto& s = slot(t);
+	const uint64_t writing = 2 * t + 1;
+	uint64_t cur = s.seq.load(std::memory_order_acquire);
+	for (unsigned spins = 0;;)
+	{
+		if (cur >= writing) return UINT64_MAX;
+		// Still being written by a writer numSlots messages behind?
+		if ((cur & 1) && spins++ < MAX_WRITER_SPINS)
+		{
+			std::this_thread::yield();
+			cur = s.seq.load(std::memory_order_acquire);
+			continue;
+		}
+		if (s.seq.compare_exchange_weak(
+				cur, writing, std::memory_order_acq_rel,
+				std::memory_order_acquire))
+			break;
+	}
+	return t;
+}
+
+void CSharedMemoryRingBuffer::write(const void* data, size_t len)
+{
+	writeInPlace([&](void* dst, size_t capacity) {
+		ASSERTMSG_(
+			len <= capacity,
+			mrpt::format(
+				"Message of %zu bytes does not fit in slots of %zu bytes", len,
+				capacity));
+		std::memcpy(dst, data, len);
+		return len;
+	});
+}
+
+void CSharedMemoryRingBuffer::writeInPlace(
+	const std::function<size_t(void*, size_t)>& fill)
+{
+	const uint64_t t = reserveSlot();
+	if (t == UINT64_MAX) return;  // Overwritten already: dropped
+
+	auto& s = slot(t);
+	const size_t capacity = slotCapacity();
+	size_t len = 0;
+	try
+	{
+		len = fill(reinterpret_cast<uint8_t*>(&s) + SLOT_HEADER_SIZE, capacity);
+		ASSERT_LE_(len, capacity);
+	}
+	catch (...)
+	{
+		// Publish an empty message, which readers skip:
+		s.length = 0;
+		s.seq.store(2 * t + 2, std::memory_order_release);
+		throw;
+	}
+	s.length = len;
+	s.seq.store(2 * t + 2, std::memory_order_release);
+}
+
+CSharedMemoryRingBuffer::ReadResult CSharedMemoryRingBuffer::read(
+	uint64_t& cursor, std::vector<uint8_t>& out, uint64_t* numLost) const
+{
+	const size_t N = numSlots();
+	const size_t capacity = slotCapacity();
+	for (;;)
+	{
+		const uint64_t head = writeIndex();
+		if (cursor >= head) return ReadResult::NoData;
+
+		const auto& s = slot(cursor);
+		const uint64_t complete = 2 * cursor + 2;
+		const uint64_t seq1 = s.seq.load(std::memory_order_acquire);
+		if (seq1 < complete && head < cursor + N)
+			return ReadResult::NoData;	// Still being written.
+
+		if (seq1 == complete)
+		{
+			const size_t len = std::min<size_t>(s.length, capacity);
+			out.resize(len);
+			std::memcpy(
+				out.data(),
+				reinterpret_cast<const uint8_t*>(&s) + SLOT_HEADER_SIZE, len);
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (s.seq.load(std::memory_order_relaxed) == seq1)
+			{
+				cursor++;
+				if (len == 0) continue;  // Dropped message
+				return ReadResult::Ok;
+			}
+		}
+
+		// Overwritten, or about to be: jump to the oldest available message.
+		const uint64_t head2 = writeIndex();
+		const uint64_t oldest = head2 > N ? head2 - N + 1 : 0;
+		const uint64_t newCursor = std::max(cursor + 1, oldest);
+		if (numLost) *numLost += newCursor - cursor;
+		cursor = newCursor;
+		return ReadResult::Overrun;
+	}
+}
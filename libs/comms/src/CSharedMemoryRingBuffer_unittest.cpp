@@ -0,0 +1,178 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/comms/SharedMemoryTopic.h>
+#include <mrpt/poses/CPose3D.h>
+
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+using namespace mrpt::comms;
+
+// Unique names, so parallel runs of the tests do not interfere:
+static std::string testRingName(const char* suffix)
+{
+	static const auto id =
+		std::chrono::steady_clock::now().time_since_epoch().count();
+	return "/mrpt_test_ring_" + std::to_string(id) + suffix;
+}
+
+TEST(CSharedMemoryRingBuffer, writeRead)
+{
+	CSharedMemoryRingBuffer::Parameters p;
+	p.numSlots = 4;
+	p.slotCapacity = 100;
+	auto writer = CSharedMemoryRingBuffer::Create(testRingName("a"), p);
+	EXPECT_TRUE(writer->isOwner());
+	// Another "process":
+	auto reader = CSharedMemoryRingBuffer::Open(testRingName("a"));
+	EXPECT_FALSE(reader->isOwner());
+	EXPECT_EQ(reader->numSlots(), 4U);
+	EXPECT_EQ(reader->slotCapacity(), 100U);
+
+	uint64_t cursor = reader->writeIndex();
+	std::vector<uint8_t> buf;
+	EXPECT_EQ(
+		reader->read(cursor, buf), CSharedMemoryRingBuffer::ReadResult::NoData);
+
+	for (uint8_t i = 0; i < 3; i++)
+	{
+		const std::vector<uint8_t> msg(10 + i, i);
+		writer->write(msg.data(), msg.size());
+	}
+	for (uint8_t i = 0; i < 3; i++)
+	{
+		ASSERT_EQ(
+			reader->read(cursor, buf), CSharedMemoryRingBuffer::ReadResult::Ok);
+		EXPECT_EQ(buf, std::vector<uint8_t>(10 + i, i));
+	}
+	EXPECT_EQ(
+		reader->read(cursor, buf), CSharedMemoryRingBuffer::ReadResult::NoData);
+
+	// Too large messages:
+	const std::vector<uint8_t> big(101);
+	EXPECT_ANY_THROW(writer->write(big.data(), big.size()));
+	// Failed messages are skipped:
+	EXPECT_ANY_THROW(writer->writeInPlace(
+		[](void*, size_t) -> size_t { throw std::runtime_error("x"); }));
+	writer->write("hello", 5);
+	ASSERT_EQ(
+		reader->read(cursor, buf), CSharedMemoryRingBuffer::ReadResult::Ok);
+	EXPECT_EQ(std::string(buf.begin(), buf.end()), "hello");
+
+	// Overrun:
+	for (uint8_t i = 0; i < 10; i++)
+		writer->write(&i, 1);
+	uint64_t lost = 0;
+	EXPECT_EQ(
+		reader->read(cursor, buf, &lost),
+		CSharedMemoryRingBuffer::ReadResult::Overrun);
+	EXPECT_GE(lost, 6U);
+	uint8_t last = 0;
+	size_t nRead = 0;
+	while (reader->read(cursor, buf) == CSharedMemoryRingBuffer::ReadResult::Ok)
+	{
+		ASSERT_EQ(buf.size(), 1U);
+		EXPECT_GT(buf[0], last);
+		last = buf[0];
+		nRead++;
+	}
+	EXPECT_EQ(last, 9);
+	EXPECT_EQ(lost + nRead, 10U);
+
+	// Creating it twice is an error:
+	EXPECT_ANY_THROW(CSharedMemoryRingBuffer::Create(testRingName("a"), p));
+}
+
+TEST(CSharedMemoryRingBuffer, multipleWriters)
+{
+	CSharedMemoryRingBuffer::Parameters p;
+	p.numSlots = 1024;
+	p.slotCapacity = 256;
+	auto ring = CSharedMemoryRingBuffer::Create(testRingName("b"), p);
+	auto reader = CSharedMemoryRingBuffer::Open(testRingName("b"));
+
+	const int nThreads = 4, nMsgs = 200;
+	std::vector<std::thread> threads;
+	for (int t = 0; t < nThreads; t++)
+		threads.emplace_back([&ring, t]() {
+			for (int i = 0; i < nMsgs; i++)
+			{
+				// Messages of varying length, filled with their id:
+				const std::vector<uint8_t> msg(
+					16 + (i % 200), static_cast<uint8_t>(t * nMsgs + i));
+				ring->write(msg.data(), msg.size());
+			}
+		});
+
+	uint64_t cursor = 0;
+	std::vector<uint8_t> buf;
+	int nRead = 0;
+	const auto tStart = std::chrono::steady_clock::now();
+	while (nRead < nThreads * nMsgs &&
+		   std::chrono::steady_clock::now() - tStart < std::chrono::seconds(10))
+	{
+		const auto r = reader->read(cursor, buf);
+		ASSERT_NE(r, CSharedMemoryRingBuffer::ReadResult::Overrun);
+		if (r != CSharedMemoryRingBuffer::ReadResult::Ok) continue;
+		// Never partially written:
+		ASSERT_GE(buf.size(), 16U);
+		for (const auto b : buf)
+			ASSERT_EQ(b, buf[0]);
+		nRead++;
+	}
+	for (auto& t : threads)
+		t.join();
+	EXPECT_EQ(nRead, nThreads * nMsgs);
+}
+
+TEST(CSharedMemoryRingBuffer, topicBridge)
+{
+	using mrpt::poses::CPose3D;
+
+	// A "publisher" and a "subscriber" process, each one with its own topic:
+	auto dir1 = TopicDirectory::create();
+	auto dir2 = TopicDirectory::create();
+	auto topic1 = dir1->getTopic("/poses");
+	auto topic2 = dir2->getTopic("/poses");
+
+	auto ring1 = CSharedMemoryRingBuffer::Create(testRingName("c"));
+	auto ring2 = CSharedMemoryRingBuffer::Open(testRingName("c"));
+	auto bridge = bridgeTopicToSharedMemory<CPose3D::Ptr>(topic1, ring1);
+
+	std::mutex mtx;
+	std::vector<CPose3D> rxPoses;
+	auto sub = topic2->createSubscriber<CPose3D::Ptr>(
+		[&](const CPose3D::Ptr& p) {
+			std::lock_guard<std::mutex> lck(mtx);
+			rxPoses.push_back(*p);
+		});
+	{
+		SharedMemoryTopicReceiver<CPose3D::Ptr> rx(topic2, ring2);
+
+		for (int i = 0; i < 10; i++)
+			topic1->publish(CPose3D::Create(i, 2.0, 3.0, 0.1 * i, 0, 0));
+
+		const auto tStart = std::chrono::steady_clock::now();
+		while (rx.receivedCount() < 10 &&
+			   std::chrono::steady_clock::now() - tStart <
+				   std::chrono::seconds(10))
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		EXPECT_EQ(rx.lostCount(), 0U);
+	}
+
+	ASSERT_EQ(rxPoses.size(), 10U);
+	for (int i = 0; i < 10; i++)
+	{
+		EXPECT_DOUBLE_EQ(rxPoses[i].x(), i);
+		EXPECT_NEAR(rxPoses[i].yaw(), 0.1 * i, 1e-9);
+	}
+}
@@ -0,0 +1,853 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "comms-precomp.h"	// Precompiled headers
+//
+#include <mrpt/comms/CClientTCPSocket.h>
+#include <mrpt/comms/CTCPReactor.h>
+#include <mrpt/core/exceptions.h>
+#include <mrpt/core/format.h>
+#include <mrpt/system/thread_name.h>
+
+#include <array>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#if defined(_MSC_VER)
+#pragma comment(lib, "WS2_32.LIB")
+#endif
+#else
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <cerrno>
+
+#if defined(MRPT_OS_LINUX)
+#include <sys/epoll.h>
+#define REACTOR_USE_EPOLL
+#elif defined(MRPT_OS_APPLE) || defined(__FreeBSD__) || \
+	defined(__OpenBSD__) || defined(__NetBSD__)
+#include <sys/event.h>
+#include <sys/time.h>
+#define REACTOR_USE_KQUEUE
+#else
+#include <poll.h>
+#endif
+#endif
+
+using namespace mrpt::comms;
+using mrpt::serialization::CMessage;
+
+namespace
+{
+#ifdef _WIN32
+using socket_t = SOCKET;
+const socket_t INVALID_SOCK = INVALID_SOCKET;
+int lastSocketError() { return WSAGetLastError(); }
+bool isWouldBlock(int e) { return e == WSAEWOULDBLOCK; }
+bool isInterrupted(int e) { return e == WSAEINTR; }
+void closeSocket(socket_t s) { ::closesocket(s); }
+bool setNonBlocking(socket_t s)
+{
+	unsigned long non_block_mode = 1;
+	return 0 == ioctlsocket(s, FIONBIO, &non_block_mode);
+}
+constexpr int SEND_FLAGS = 0;
+#else
+using socket_t = int;
+const socket_t INVALID_SOCK = -1;
+int lastSocketError() { return errno; }
+bool isWouldBlock(int e) { return e == EAGAIN || e == EWOULDBLOCK; }
+bool isInterrupted(int e) { return e == EINTR; }
+void closeSocket(socket_t s) { ::close(s); }
+bool setNonBlocking(socket_t s)
+{
+	const int flags = fcntl(s, F_GETFL, 0);
+	return flags != -1 && -1 != fcntl(s, F_SETFL, flags | O_NONBLOCK);
+}
+#if defined(MSG_NOSIGNAL)
+constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+constexpr int SEND_FLAGS = 0;
+#endif
+#endif
+
+/** Options for all sockets of connections */
+void setupConnectionSocket(socket_t s)
+{
+	setNonBlocking(s);
+	int one = 1;
+	// Messages are written as a whole, do not wait to fill segments:
+	setsockopt(
+		s, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&one),
+		sizeof(one));
+#if defined(SO_NOSIGPIPE)
+	// No MSG_NOSIGNAL in macOS:
+	setsockopt(s, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+}
+
+std::string socketErrorStr(int e)
+{
+#ifdef _WIN32
+	return mrpt::format("Socket error %i", e);
+#else
+	return mrpt::format("%s [%i]", strerror(e), e);
+#endif
+}
+
+/** Same framing than CClientTCPSocket::sendMessage(): magic word, type,
+ * content length, contents */
+constexpr char FRAME_MAGIC[] = "MRPTMessage";
+constexpr size_t FRAME_MAGIC_LEN = sizeof(FRAME_MAGIC) - 1;
+constexpr size_t FRAME_HEADER_LEN =
+	FRAME_MAGIC_LEN + sizeof(CMessage::type) + sizeof(uint32_t);
+
+struct PollEvent
+{
+	socket_t sock;
+	bool readable, writable;
+};
+
+/** Waits for events in a set of sockets with the best API of each OS. All
+ * methods must be called from the loop thread. */
+class Poller
+{
+   public:
+#if defined(REACTOR_USE_EPOLL)
+	Poller()
+	{
+		m_fd = epoll_create1(EPOLL_CLOEXEC);
+		if (m_fd == -1)
+			THROW_EXCEPTION_FMT(
+				"epoll_create1(): %s", socketErrorStr(errno).c_str());
+	}
+	~Poller() { ::close(m_fd); }
+	void add(socket_t s) { ctl(EPOLL_CTL_ADD, s, false); }
+	void setWritable(socket_t s, bool w) { ctl(EPOLL_CTL_MOD, s, w); }
+	void remove(socket_t s) { epoll_ctl(m_fd, EPOLL_CTL_DEL, s, nullptr); }
+	void wait(int timeout_ms, std::vector<PollEvent>& out)
+	{
+		std::array<epoll_event, 256> evs;
+		const int n = epoll_wait(m_fd, evs.data(), evs.size(), timeout_ms);
+		for (int i = 0; i < n; i++)
+		{
+			const auto e = evs[i].events;
+			// Errors and hang-ups: detected while reading.
+			out.push_back(
+				{evs[i].data.fd, (e & (EPOLLIN | EPOLLERR | EPOLLHUP)) != 0,
+				 (e & EPOLLOUT) != 0});
+		}
+	}
+
+   private:
+	int m_fd = -1;
+	void ctl(int op, socket_t s, bool w)
+	{
+		epoll_event ev;
+		ev.events = EPOLLIN | (w ? EPOLLOUT : 0);
+		ev.data.fd = s;
+		if (0 != epoll_ctl(m_fd, op, s, &ev))
+			THROW_EXCEPTION_FMT(
+				"epoll_ctl(): %s", socketErrorStr(errno).c_str());
+	}
+#elif defined(REACTOR_USE_KQUEUE)
+	Poller()
+	{
+		m_fd = kqueue();
+		if (m_fd == -1)
+			THROW_EXCEPTION_FMT("kqueue(): %s", socketErrorStr(errno).c_str());
+	}
+	~Poller() { ::close(m_fd); }
+	void add(socket_t s)
+	{
+		struct kevent ev;
+		EV_SET(&ev, s, EVFILT_READ, EV_ADD, 0, 0, nullptr);
+		if (0 != kevent(m_fd, &ev, 1, nullptr, 0, nullptr))
+			THROW_EXCEPTION_FMT("kevent(): %s", socketErrorStr(errno).c_str());
+	}
+	void setWritable(socket_t s, bool w)
+	{
+		struct kevent ev;
+		EV_SET(&ev, s, EVFILT_WRITE, w ? EV_ADD : EV_DELETE, 0, 0, nullptr);
+		kevent(m_fd, &ev, 1, nullptr, 0, nullptr);
+	}
+	void remove(socket_t s)
+	{
+		struct kevent evs[2];
+		EV_SET(&evs[0], s, EVFILT_READ, EV_DELETE, 0, 0, nullptr);
+		EV_SET(&evs[1], s, EVFILT_WRITE, EV_DELETE, 0, 0, nullptr);
+		// (The write filter may not exist: ignore errors)
+		kevent(m_fd, evs, 2, nullptr, 0, nullptr);
+	}
+	void wait(int timeout_ms, std::vector<PollEvent>& out)
+	{
+		std::array<struct kevent, 256> evs;
+		timespec ts;
+		ts.tv_sec = timeout_ms / 1000;
+		ts.tv_nsec = (timeout_ms % 1000) * 1000000L;
+		const int n = kevent(
+			m_fd, nullptr, 0, evs.data(), evs.size(),
+			timeout_ms < 0 ? nullptr : &ts);
+		for (int i = 0; i < n; i++)
+			out.push_back(
+				{static_cast<socket_t>(evs[i].ident),
+				 evs[i].filter == EVFILT_READ, evs[i].filter == EVFILT_WRITE});
+	}
+
+   private:
+	int m_fd = -1;
+#else
+	// poll(), or WSAPoll() in Windows:
+	void add(socket_t s)
+	{
+		m_index[s] = m_fds.size();
+		pollfd p;
+		p.fd = s;
+		p.events = POLLIN;
+		p.revents = 0;
+		m_fds.push_back(p);
+	}
+	void setWritable(socket_t s, bool w)
+	{
+		auto& p = m_fds.at(m_index.at(s));
+		p.events = POLLIN | (w ? POLLOUT : 0);
+	}
+	void remove(socket_t s)
+	{
+		auto it = m_index.find(s);
+		if (it == m_index.end()) return;
+		const size_t i = it->second;
+		m_index.erase(it);
+		if (i + 1 != m_fds.size())
+		{
+			m_fds[i] = m_fds.back();
+			m_index[m_fds[i].fd] = i;
+		}
+		m_fds.pop_back();
+	}
+	void wait(int timeout_ms, std::vector<PollEvent>& out)
+	{
+#ifdef _WIN32
+		const int n = WSAPoll(
+			m_fds.data(), static_cast<ULONG>(m_fds.size()), timeout_ms);
+#else
+		const int n = ::poll(m_fds.data(), m_fds.size(), timeout_ms);
+#endif
+		if (n <= 0) return;
+		for (const auto& p : m_fds)
+		{
+			if (!p.revents) continue;
+			out.push_back(
+				{static_cast<socket_t>(p.fd),
+				 (p.revents & (POLLIN | POLLERR | POLLHUP)) != 0,
+				 (p.revents & POLLOUT) != 0});
+		}
+	}
+
+   private:
+	std::vector<pollfd> m_fds;
+	std::unordered_map<socket_t, size_t> m_index;
+#endif
+};
+
+struct Connection
+{
+	CTCPReactor::connection_id_t id = 0;
+	socket_t sock = INVALID_SOCK;
+	bool listening = false;
+	std::string remoteIP;
+	unsigned short remotePort = 0;
+
+	// Only accessed from the loop thread:
+	bool registered = false;  //!< Added to the poller
+	bool announced = false;	 //!< The connection callback was called
+	std::array<uint8_t, FRAME_HEADER_LEN> rxHeader;
+	size_t rxHeaderBytes = 0;
+	bool rxInContent = false;
+	size_t rxContentBytes = 0;
+	CMessage rxMsg;
+
+	// Guarded by Impl::mtx:
+	bool closeRequested = false;
+	bool wantWrite = false;	 //!< Waiting for the socket to be writable
+	std::deque<std::vector<uint8_t>> txQueue;
+	size_t txFrontOffset = 0;
+	size_t txBytes = 0;
+};
+}  // namespace
+
+struct CTCPReactor::Impl
+{
+	mutable std::mutex mtx;
+	std::map<connection_id_t, std::unique_ptr<Connection>> conns;
+	connection_id_t nextId = 1;
+	// Requests to the loop thread:
+	std::vector<connection_id_t> pendingAdds, pendingCloses;
+	std::set<connection_id_t> pendingWrites;
+
+	// Only accessed from the loop thread:
+	Poller poller;
+	std::unordered_map<socket_t, Connection*> bySocket;
+	std::vector<PollEvent> events;
+	std::vector<uint8_t> rxBuf = std::vector<uint8_t>(64 * 1024);
+
+	// A UDP socket sending datagrams to itself, to wake up the poller:
+	socket_t wakeSock = INVALID_SOCK;
+	std::atomic_bool wakePending{false};
+
+	Connection* find(connection_id_t id) const
+	{
+		auto it = conns.find(id);
+		return it == conns.end() ? nullptr : it->second.get();
+	}
+
+	connection_id_t add(std::unique_ptr<Connection>&& c)
+	{
+		std::lock_guard<std::mutex> lck(mtx);
+		const auto id = nextId++;
+		c->id = id;
+		conns[id] = std::move(c);
+		pendingAdds.push_back(id);
+		return id;
+	}
+
+	/** Writes as much as possible of the output queue. Must be called with
+	 * mtx locked. \return false on socket errors */
+	bool flushWrites(Connection& c)
+	{
+		while (!c.txQueue.empty())
+		{
+			const auto& f = c.txQueue.front();
+			const auto r = ::send(
+				c.sock,
+				reinterpret_cast<const char*>(f.data()) + c.txFrontOffset,
+				static_cast<int>(f.size() - c.txFrontOffset), SEND_FLAGS);
+			if (r < 0)
+			{
+				const int e = lastSocketError();
+				if (isWouldBlock(e)) return true;
+				if (isInterrupted(e)) continue;
+				return false;
+			}
+			c.txFrontOffset += static_cast<size_t>(r);
+			c.txBytes -= static_cast<size_t>(r);
+			if (c.txFrontOffset == f.size())
+			{
+				c.txQueue.pop_front();
+				c.txFrontOffset = 0;
+			}
+		}
+		return true;
+	}
+};
+
+CTCPReactor::CTCPReactor()
+	: mrpt::system::COutputLogger("CTCPReactor"),
+	  m_impl(std::make_unique<Impl>())
+{
+#ifdef _WIN32
+	WSADATA wsaData;
+	if (WSAStartup(MAKEWORD(2, 2), &wsaData))
+		THROW_EXCEPTION("Error calling WSAStartup");
+#endif
+
+	// Self-connected UDP socket for wakeUp():
+	auto& d = *m_impl;
+	d.wakeSock = ::socket(AF_INET, SOCK_DGRAM, 0);
+	if (d.wakeSock == INVALID_SOCK)
+		THROW_EXCEPTION_FMT(
+			"Error creating socket: %s",
+			socketErrorStr(lastSocketError()).c_str());
+	sockaddr_in addr;
+	std::memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	addr.sin_port = 0;
+	socklen_t addrLen = sizeof(addr);
+	if (0 != ::bind(d.wakeSock, reinterpret_cast<sockaddr*>(&addr), addrLen) ||
+		0 !=
+			::getsockname(
+				d.wakeSock, reinterpret_cast<sockaddr*>(&addr), &addrLen) ||
+		0 !=
+			::connect(d.wakeSock, reinterpret_cast<sockaddr*>(&addr), addrLen))
+		THROW_EXCEPTION_FMT(
+			"Error setting up wake up socket: %s",
+			socketErrorStr(lastSocketError()).c_str());
+	setNonBlocking(d.wakeSock);
+	d.poller.add(d.wakeSock);
+}
+
+CTCPReactor::~CTCPReactor()
+{
+	stop();
+
+	auto& d = *m_impl;
+	for (auto& kv : d.conns)
+		closeSocket(kv.second->sock);
+	d.conns.clear();
+	closeSocket(d.wakeSock);
+
+#ifdef _WIN32
+	WSACleanup();
+#endif
+}
+
+void CTCPReactor::listen(
+	unsigned short listenPort, const std::string& IPaddress,
+	int maxConnectionsWaiting)
+{
+	MRPT_START
+
+	const socket_t s = ::socket(AF_INET, SOCK_STREAM, 0);
+	if (s == INVALID_SOCK)
+		THROW_EXCEPTION_FMT(
+			"Error creating socket: %s",
+			socketErrorStr(lastSocketError()).c_str());
+
+	int one = 1;
+	setsockopt(
+		s, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&one),
+		sizeof(one));
+
+	sockaddr_in desiredIP;
+	std::memset(&desiredIP, 0, sizeof(desiredIP));
+	desiredIP.sin_family = AF_INET;
+	desiredIP.sin_addr.s_addr = inet_addr(IPaddress.c_str());
+	desiredIP.sin_port = htons(listenPort);
+
+	if (0 !=
+			::bind(
+				s, reinterpret_cast<sockaddr*>(&desiredIP),
+				sizeof(desiredIP)) ||
+		0 != ::listen(s, maxConnectionsWaiting) || !setNonBlocking(s))
+	{
+		const int e = lastSocketError();
+		closeSocket(s);
+		THROW_EXCEPTION_FMT(
+			"Error listening at %s:%u: %s", IPaddress.c_str(),
+			static_cast<unsigned int>(listenPort), socketErrorStr(e).c_str());
+	}
+
+	auto c = std::make_unique<Connection>();
+	c->sock = s;
+	c->listening = true;
+	c->remoteIP = IPaddress;
+	c->remotePort = listenPort;
+	m_impl->add(std::move(c));
+	wakeUp();
+
+	MRPT_LOG_DEBUG_FMT(
+		"Listening at %s:%u", IPaddress.c_str(),
+		static_cast<unsigned int>(listenPort));
+
+	MRPT_END
+}
+
+CTCPReactor::connection_id_t CTCPReactor::connect(
+	const std::string& remotePartAddress, unsigned short remotePartTCPPort,
+	unsigned int timeout_ms)
+{
+	CClientTCPSocket sock;
+	sock.connect(remotePartAddress, remotePartTCPPort, timeout_ms);
+	return addConnection(sock);
+}
+
+CTCPReactor::connection_id_t CTCPReactor::addConnection(CClientTCPSocket& sock)
+{
+	ASSERTMSG_(sock.isConnected(), "The socket is not connected");
+
+	auto c = std::make_unique<Connection>();
+	c->sock = static_cast<socket_t>(sock.m_hSock);
+	// The socket is now ours:
+	sock.m_hSock = static_cast<decltype(sock.m_hSock)>(INVALID_SOCK);
+
+	sockaddr_in other;
+	socklen_t otherLen = sizeof(other);
+	if (0 ==
+		::getpeername(c->sock, reinterpret_cast<sockaddr*>(&other), &otherLen))
+	{
+		c->remoteIP = inet_ntoa(other.sin_addr);
+		c->remotePort = ntohs(other.sin_port);
+	}
+	setupConnectionSocket(c->sock);
+
+	const auto id = m_impl->add(std::move(c));
+	wakeUp();
+	return id;
+}
+
+bool CTCPReactor::closeConnection(connection_id_t conn)
+{
+	{
+		std::lock_guard<std::mutex> lck(m_impl->mtx);
+		Connection* c = m_impl->find(conn);
+		if (!c || c->listening || c->closeRequested) return false;
+		c->closeRequested = true;
+		m_impl->pendingCloses.push_back(conn);
+	}
+	wakeUp();
+	return true;
+}
+
+size_t CTCPReactor::getConnectionCount() const
+{
+	std::lock_guard<std::mutex> lck(m_impl->mtx);
+	size_t n = 0;
+	for (const auto& kv : m_impl->conns)
+		if (!kv.second->listening && !kv.second->closeRequested) n++;
+	return n;
+}
+
+std::string CTCPReactor::getRemoteAddress(
+	connection_id_t conn, unsigned short* port) const
+{
+	std::lock_guard<std::mutex> lck(m_impl->mtx);
+	const Connection* c = m_impl->find(conn);
+	if (port) *port = c ? c->remotePort : 0;
+	return c ? c->remoteIP : std::string();
+}
+
+bool CTCPReactor::sendMessage(connection_id_t conn, const CMessage& msg)
+{
+	// Build the frame before locking:
+	const uint32_t contentLen = static_cast<uint32_t>(msg.content.size());
+	std::vector<uint8_t> frame(FRAME_HEADER_LEN + contentLen);
+	uint8_t* p = frame.data();
+	std::memcpy(p, FRAME_MAGIC, FRAME_MAGIC_LEN);
+	p += FRAME_MAGIC_LEN;
+	std::memcpy(p, &msg.type, sizeof(msg.type));
+	p += sizeof(msg.type);
+	std::memcpy(p, &contentLen, sizeof(contentLen));
+	p += sizeof(contentLen);
+	if (contentLen) std::memcpy(p, msg.content.data(), contentLen);
+
+	auto& d = *m_impl;
+	bool wake = false;
+	{
+		std::lock_guard<std::mutex> lck(d.mtx);
+		Connection* c = d.find(conn);
+		if (!c || c->listening || c->closeRequested) return false;
+		if (c->txBytes + frame.size() > m_maxWriteQueueBytes) return false;
+
+		const bool wasEmpty = c->txQueue.empty();
+		c->txBytes += frame.size();
+		c->txQueue.push_back(std::move(frame));
+
+		// Try to write it right now, from this thread:
+		if (wasEmpty && !d.flushWrites(*c))
+		{
+			c->closeRequested = true;
+			d.pendingCloses.push_back(conn);
+			wake = true;
+		}
+		else if (c->txBytes != 0 && !c->wantWrite)
+		{
+			// Let the loop wait for the socket to be writable:
+			d.pendingWrites.insert(conn);
+			wake = true;
+		}
+	}
+	if (wake) wakeUp();
+	return true;
+}
+
+size_t CTCPReactor::broadcastMessage(const CMessage& msg)
+{
+	std::vector<connection_id_t> ids;
+	{
+		std::lock_guard<std::mutex> lck(m_impl->mtx);
+		for (const auto& kv : m_impl->conns)
+			if (!kv.second->listening) ids.push_back(kv.first);
+	}
+	size_t n = 0;
+	for (const auto id : ids)
+		if (sendMessage(id, msg)) n++;
+	return n;
+}
+
+size_t CTCPReactor::getWriteQueueBytes(connection_id_t conn) const
+{
+	std::lock_guard<std::mutex> lck(m_impl->mtx);
+	const Connection* c = m_impl->find(conn);
+	return c ? c->txBytes : 0;
+}
+
+void CTCPReactor::wakeUp()
+{
+	auto& d = *m_impl;
+	if (d.wakePending.exchange(true)) return;  // Already pending
+	const char b = 0;
+	::send(d.wakeSock, &b, 1, 0);
+}
+
+void CTCPReactor::start()
+{
+	if (m_thread.joinable()) return;
+	m_stopRequested = false;
+	m_thread = std::thread([this]() {
+		mrpt::system::thread_name("CTCPReactor");
+		while (!m_stopRequested)
+		{
+			try
+			{
+				runOnce(-1);
+			}
+			catch (const std::exception& e)
+			{
+				MRPT_LOG_ERROR_STREAM(
+					"Exception in event loop: " << mrpt::exception_to_str(e));
+			}
+		}
+	});
+}
+
+void CTCPReactor::stop()
+{
+	if (!m_thread.joinable()) return;
+	m_stopRequested = true;
+	wakeUp();
+	m_thread.join();
+}
+
+void CTCPReactor::runOnce(int timeout_ms)
+{
+	auto& d = *m_impl;
+
+	// Closes a connection now, from the loop thread:
+	auto lmbClose = [&](connection_id_t id) {
+		std::unique_ptr<Connection> c;
+		{
+			std::lock_guard<std::mutex> lck(d.mtx);
+			auto it = d.conns.find(id);
+			if (it == d.conns.end()) return;
+			c = std::move(it->second);
+			d.conns.erase(it);
+			d.pendingWrites.erase(id);
+		}
+		if (c->registered)
+		{
+			d.poller.remove(c->sock);
+			d.bySocket.erase(c->sock);
+		}
+		closeSocket(c->sock);
+		MRPT_LOG_DEBUG_FMT(
+			"Connection #%u closed", static_cast<unsigned int>(id));
+		if (c->announced && m_onDisconnection) m_onDisconnection(id);
+	};
+
+	// Adds a connection to the poller:
+	auto lmbRegister = [&](Connection* c) {
+		d.poller.add(c->sock);
+		c->registered = true;
+		d.bySocket[c->sock] = c;
+		if (c->listening) return;
+		c->announced = true;
+		if (m_onConnection) m_onConnection(c->id);
+	};
+
+	// Updates the interest in writable events of a connection:
+	auto lmbFlush = [&](Connection* c) {
+		bool ok, more;
+		{
+			std::lock_guard<std::mutex> lck(d.mtx);
+			ok = d.flushWrites(*c);
+			more = c->txBytes != 0;
+			if (!ok || more == c->wantWrite) return ok;
+			c->wantWrite = more;
+		}
+		d.poller.setWritable(c->sock, more);
+		return true;
+	};
+
+	// Parses received data into messages. false on framing errors.
+	auto lmbParse = [&](Connection* c, const uint8_t* data, size_t len) {
+		while (len > 0)
+		{
+			if (!c->rxInContent)
+			{
+				const size_t n =
+					std::min(len, FRAME_HEADER_LEN - c->rxHeaderBytes);
+				std::memcpy(&c->rxHeader[c->rxHeaderBytes], data, n);
+				c->rxHeaderBytes += n;
+				data += n;
+				len -= n;
+				if (c->rxHeaderBytes < FRAME_HEADER_LEN) break;
+
+				const uint8_t* h = c->rxHeader.data();
+				if (0 != std::memcmp(h, FRAME_MAGIC, FRAME_MAGIC_LEN))
+				{
+					MRPT_LOG_WARN_FMT(
+						"Connection #%u: invalid message frame",
+						static_cast<unsigned int>(c->id));
+					return false;
+				}
+				h += FRAME_MAGIC_LEN;
+				std::memcpy(&c->rxMsg.type, h, sizeof(c->rxMsg.type));
+				h += sizeof(c->rxMsg.type);
+				uint32_t contentLen;
+				std::memcpy(&contentLen, h, sizeof(contentLen));
+				if (contentLen > m_maxMessageLength)
+				{
+					MRPT_LOG_WARN_FMT(
+						"Connection #%u: message too long (%u bytes)",
+						static_cast<unsigned int>(c->id),
+						static_cast<unsigned int>(contentLen));
+					return false;
+				}
+				c->rxMsg.content.resize(contentLen);
+				c->rxContentBytes = 0;
+				c->rxInContent = true;
+			}
+
+			const size_t n =
+				std::min(len, c->rxMsg.content.size() - c->rxContentBytes);
+			if (n) std::memcpy(&c->rxMsg.content[c->rxContentBytes], data, n);
+			c->rxContentBytes += n;
+			data += n;
+			len -= n;
+			if (c->rxContentBytes < c->rxMsg.content.size()) break;
+
+			// Complete message:
+			c->rxInContent = false;
+			c->rxHeaderBytes = 0;
+			if (m_onMessage) m_onMessage(c->id, c->rxMsg);
+		}
+		return true;
+	};
+
+	// Reads what is available. false on errors or if closed by the peer.
+	auto lmbRead = [&](Connection* c) {
+		// (Bounded, so a busy connection does not starve the others)
+		for (int i = 0; i < 16; i++)
+		{
+			const auto r = ::recv(
+				c->sock, reinterpret_cast<char*>(d.rxBuf.data()),
+				static_cast<int>(d.rxBuf.size()), 0);
+			if (r == 0) return false;  // Closed by the other side
+			if (r < 0)
+			{
+				const int e = lastSocketError();
+				if (isWouldBlock(e)) return true;
+				if (isInterrupted(e)) continue;
+				MRPT_LOG_DEBUG_FMT(
+					"Connection #%u: %s", static_cast<unsigned int>(c->id),
+					socketErrorStr(e).c_str());
+				return false;
+			}
+			if (!lmbParse(c, d.rxBuf.data(), static_cast<size_t>(r)))
+				return false;
+		}
+		return true;
+	};
+
+	auto lmbAccept = [&](Connection* listener) {
+		for (;;)
+		{
+			sockaddr_in other;
+			socklen_t otherLen = sizeof(other);
+			const socket_t s = ::accept(
+				listener->sock, reinterpret_cast<sockaddr*>(&other),
+				&otherLen);
+			if (s == INVALID_SOCK) return;	// No more pending connections
+
+			setupConnectionSocket(s);
+			auto c = std::make_unique<Connection>();
+			c->sock = s;
+			c->remoteIP = inet_ntoa(other.sin_addr);
+			c->remotePort = ntohs(other.sin_port);
+			Connection* cPtr = c.get();
+			{
+				std::lock_guard<std::mutex> lck(d.mtx);
+				c->id = d.nextId++;
+				d.conns[c->id] = std::move(c);
+			}
+			MRPT_LOG_DEBUG_FMT(
+				"Connection #%u accepted from %s:%u",
+				static_cast<unsigned int>(cPtr->id), cPtr->remoteIP.c_str(),
+				static_cast<unsigned int>(cPtr->remotePort));
+			lmbRegister(cPtr);
+		}
+	};
+
+	// 1) Requests from other threads:
+	std::vector<connection_id_t> adds, closes, writes;
+	{
+		std::lock_guard<std::mutex> lck(d.mtx);
+		adds.swap(d.pendingAdds);
+		closes.swap(d.pendingCloses);
+		writes.assign(d.pendingWrites.begin(), d.pendingWrites.end());
+		d.pendingWrites.clear();
+	}
+	auto lmbFind = [&](connection_id_t id) {
+		std::lock_guard<std::mutex> lck(d.mtx);
+		return d.find(id);
+	};
+	for (const auto id : adds)
+		if (Connection* c = lmbFind(id); c) lmbRegister(c);
+	for (const auto id : writes)
+	{
+		Connection* c = lmbFind(id);
+		if (c && !lmbFlush(c)) closes.push_back(id);
+	}
+	for (const auto id : closes)
+		lmbClose(id);
+
+	// 2) Wait for events, unless there are new requests:
+	bool morePending;
+	{
+		std::lock_guard<std::mutex> lck(d.mtx);
+		morePending = !d.pendingAdds.empty() || !d.pendingCloses.empty() ||
+			!d.pendingWrites.empty();
+	}
+	d.events.clear();
+	d.poller.wait(morePending ? 0 : timeout_ms, d.events);
+
+	// 3) Process them:
+	std::vector<connection_id_t> failed;
+	for (const auto& ev : d.events)
+	{
+		if (ev.sock == d.wakeSock)
+		{
+			d.wakePending = false;
+			char buf[64];
+			while (::recv(d.wakeSock, buf, sizeof(buf), 0) > 0)
+			{
+			}
+			continue;
+		}
+
+		auto it = d.bySocket.find(ev.sock);
+		if (it == d.bySocket.end()) continue;
+		Connection* c = it->second;
+
+		if (c->listening)
+		{
+			if (ev.readable) lmbAccept(c);
+			continue;
+		}
+		if ((ev.readable && !lmbRead(c)) || (ev.writable && !lmbFlush(c)))
+			failed.push_back(c->id);
+	}
+	for (const auto id : failed)
+		lmbClose(id);
+}
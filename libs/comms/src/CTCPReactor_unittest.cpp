@@ -0,0 +1,122 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/comms/CClientTCPSocket.h>
+#include <mrpt/comms/CTCPReactor.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using mrpt::comms::CClientTCPSocket;
+using mrpt::comms::CTCPReactor;
+using mrpt::serialization::CMessage;
+
+namespace
+{
+CMessage makeMessage(uint32_t type, size_t len)
+{
+	CMessage m;
+	m.type = type;
+	m.content.resize(len);
+	for (size_t i = 0; i < len; i++)
+		m.content[i] = static_cast<uint8_t>(i * 7 + type);
+	return m;
+}
+
+template <typename PRED>
+bool waitFor(PRED pred)
+{
+	for (int i = 0; i < 500 && !pred(); i++)
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	return pred();
+}
+}  // namespace
+
+TEST(CTCPReactor, echoServer)
+{
+	const unsigned short port = 15011;
+
+	CTCPReactor server;
+	std::atomic_int nConn{0}, nDisc{0};
+	server.setOnConnection([&](CTCPReactor::connection_id_t) { nConn++; });
+	server.setOnDisconnection([&](CTCPReactor::connection_id_t) { nDisc++; });
+	server.setOnMessage([&](auto conn, const CMessage& m) {
+		EXPECT_TRUE(server.sendMessage(conn, m));
+	});
+	server.listen(port);
+	server.start();
+
+	// Regular blocking clients, with messages larger than socket buffers:
+	const size_t nClients = 4;
+	std::vector<CClientTCPSocket> clients(nClients);
+	for (auto& c : clients)
+		c.connect("127.0.0.1", port);
+	EXPECT_TRUE(waitFor([&]() { return nConn == int(nClients); }));
+	EXPECT_EQ(server.getConnectionCount(), nClients);
+
+	for (size_t i = 0; i < nClients; i++)
+	{
+		for (const size_t len : {0, 10, 3000000})
+		{
+			const auto m = makeMessage(static_cast<uint32_t>(i + 1), len);
+			std::thread sender(
+				[&]() { EXPECT_TRUE(clients[i].sendMessage(m)); });
+			CMessage rx;
+			EXPECT_TRUE(clients[i].receiveMessage(rx, 5000, 5000));
+			sender.join();
+			EXPECT_EQ(rx.type, m.type);
+			EXPECT_EQ(rx.content, m.content);
+		}
+	}
+
+	clients[0].close();
+	EXPECT_TRUE(waitFor([&]() { return nDisc == 1; }));
+	EXPECT_EQ(server.getConnectionCount(), nClients - 1);
+
+	server.stop();
+}
+
+TEST(CTCPReactor, reactorToReactor)
+{
+	const unsigned short port = 15012;
+
+	CTCPReactor server;
+	server.setOnMessage([&](auto conn, const CMessage& m) {
+		server.sendMessage(conn, m);
+	});
+	server.listen(port);
+	server.start();
+
+	CTCPReactor client;
+	std::atomic_int nRx{0};
+	std::atomic_bool ok{true};
+	const size_t nMsgs = 100;
+	client.setOnMessage([&](auto, const CMessage& m) {
+		// Messages must arrive in order:
+		if (m.type != static_cast<uint32_t>(nRx) ||
+			m.content != makeMessage(m.type, 100 + m.type).content)
+			ok = false;
+		nRx++;
+	});
+	const auto conn = client.connect("127.0.0.1", port);
+	EXPECT_EQ(client.getRemoteAddress(conn), "127.0.0.1");
+	client.start();
+
+	for (size_t i = 0; i < nMsgs; i++)
+		EXPECT_TRUE(
+			client.sendMessage(conn, makeMessage(uint32_t(i), 100 + i)));
+	EXPECT_TRUE(waitFor([&]() { return nRx == int(nMsgs); }));
+	EXPECT_TRUE(ok);
+
+	EXPECT_TRUE(client.closeConnection(conn));
+	EXPECT_FALSE(client.sendMessage(conn, makeMessage(0, 1)));
+	EXPECT_TRUE(waitFor([&]() { return server.getConnectionCount() == 0; }));
+}
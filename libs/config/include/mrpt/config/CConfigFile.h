@@ -97,6 +97,9 @@ class CConfigFile : public CConfigFileBase
 	/** Returs a list with all the keys into a section. */
 	void getAllKeys(const std::string& section, std::vector<std::string>& keys)
 		const override;
+	/** Returns all the keys of a section with their values */
+	void readSection(const std::string& section, key_values_t& keyValues)
+		const override;
 
 };	// End of class def.
 
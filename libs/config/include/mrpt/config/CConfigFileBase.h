@@ -14,6 +14,7 @@
 
 #include <string>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace mrpt
@@ -78,6 +79,18 @@ class CConfigFileBase
 	virtual void getAllKeys(
 		const std::string& section, std::vector<std::string>& keys) const = 0;
 
+	/** Key-value pairs of a section, in file order */
+	using key_values_t = std::vector<std::pair<std::string, std::string>>;
+
+	/** Returns all the keys of a section with their values, as they would be
+	 * returned by read_string() but untrimmed, much faster than reading them
+	 * one by one in large files. Empty if the section does not exist.
+	 * \sa CConfigSectionBinder
+	 * \note (New in MRPT 2.4.9)
+	 */
+	virtual void readSection(
+		const std::string& section, key_values_t& keyValues) const;
+
 	/** Checks if a given section exists (name is case insensitive)
 	 * \sa keyExists() */
 	bool sectionExists(const std::string& section_name) const;
@@ -79,6 +79,10 @@ class CConfigFilePrefixer : public CConfigFileBase
 	void getAllSections(std::vector<std::string>& sections) const override;
 	void getAllKeys(const std::string& section, std::vector<std::string>& keys)
 		const override;
+	/** Returns the keys of the prefixed section that start with the key
+	 * prefix, with the prefix removed */
+	void readSection(const std::string& section, key_values_t& keyValues)
+		const override;
 	void clear() override;
 
 };	// End of class def.
@@ -0,0 +1,172 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/config/CConfigFileBase.h>
+#include <mrpt/core/bits_math.h>  // DEG2RAD()
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace mrpt::config
+{
+namespace internal
+{
+bool parseBool(const std::string& s);
+double parseDouble(const std::string& s);
+int64_t parseInt(const std::string& s);
+uint64_t parseUInt(const std::string& s);
+std::string firstWord(const std::string& s);
+}  // namespace internal
+
+/** Typed bulk reading of the parameters of one section of a configuration
+ * file.
+ *
+ * Variables are bound to their keys once, then load() reads the whole section
+ * with one call to CConfigFileBase::readSection() and resolves all the keys at
+ * once, instead of one section and key look-up (plus the formatting of a
+ * default value) for each `read_*()` call. Keys are case insensitive.
+ * Variables whose keys are not in the section keep their current values, as
+ * with MRPT_LOAD_CONFIG_VAR().
+ *
+ * \code
+ * mrpt::config::CConfigSectionBinder b;
+ * b.bind("maxRange", maxRange)
+ *  .bind("decimation", decimation)
+ *  .bindDegrees("aperture", aperture)
+ *  .bindRequired("sensorLabel", sensorLabel);
+ * b.load(cfg, "sensor");	// may be called for many files or sections
+ * \endcode
+ *
+ * Supported types are `bool` (`true`/`false`, `yes`/`no` or a number),
+ * integers (unsigned ones also in hexadecimal, `0x...`), `float`, `double`,
+ * `std::string` (trimmed), enums with a mrpt::typemeta::TEnumType
+ * specialization (names or numbers, as in CConfigFileBase::read_enum()), and
+ * any other type with custom parsers (see bindCustom()).
+ *
+ * \ingroup mrpt_config_grp
+ * \note (New in MRPT 2.4.9)
+ */
+class CConfigSectionBinder
+{
+   public:
+	/** Parses the (untrimmed) value of a key. It may throw to report format
+	 * errors. */
+	using parser_t = std::function<void(const std::string& value)>;
+
+	CConfigSectionBinder() = default;
+
+	/** Binds an optional key: the variable is left unchanged if not found */
+	template <typename T>
+	CConfigSectionBinder& bind(const std::string& key, T& var)
+	{
+		return bindCustom(key, makeParser(var), false);
+	}
+
+	/** Binds a key that must exist, or load() throws */
+	template <typename T>
+	CConfigSectionBinder& bindRequired(const std::string& key, T& var)
+	{
+		return bindCustom(key, makeParser(var), true);
+	}
+
+	/** Binds an angle given in degrees in the file, stored in radians */
+	template <typename T>
+	CConfigSectionBinder& bindDegrees(
+		const std::string& key, T& var, bool required = false)
+	{
+		static_assert(std::is_floating_point_v<T>, "Requires float or double");
+		return bindCustom(
+			key,
+			[&var](const std::string& s) {
+				var = static_cast<T>(
+					mrpt::DEG2RAD(internal::parseDouble(s)));
+			},
+			required);
+	}
+
+	/** Binds a key to a user-provided parser of its value */
+	CConfigSectionBinder& bindCustom(
+		const std::string& key, parser_t parser, bool required = false);
+
+	/** Reads the section and assigns the values of all the bound variables
+	 * present in it.
+	 * \return The number of bound keys found in the section.
+	 * \exception std::exception If a required key is not found (all of them
+	 * are listed), or upon errors parsing a value. */
+	size_t load(const CConfigFileBase& cfg, const std::string& section) const;
+
+	/** Number of bound keys */
+	size_t size() const { return m_bindings.size(); }
+
+	/** Removes all the bindings */
+	void clear() { m_bindings.clear(); }
+
+   private:
+	struct Binding
+	{
+		std::string key, keyLowerCase;
+		parser_t parser;
+		bool required = false;
+	};
+	std::vector<Binding> m_bindings;
+
+	template <typename T>
+	static parser_t makeParser(T& var)
+	{
+		if constexpr (std::is_same_v<T, bool>)
+			return [&var](const std::string& s) {
+				var = internal::parseBool(s);
+			};
+		else if constexpr (std::is_same_v<T, std::string>)
+			return [&var](const std::string& s) {
+				var = mrpt::system::trim(s);
+			};
+		else if constexpr (std::is_floating_point_v<T>)
+			return [&var](const std::string& s) {
+				var = static_cast<T>(internal::parseDouble(s));
+			};
+		else if constexpr (std::is_integral_v<T>)
+			return [&var](const std::string& s) {
+				if constexpr (std::is_signed_v<T>)
+					var = checkedCast<T>(internal::parseInt(s), s);
+				else
+					var = checkedCast<T>(internal::parseUInt(s), s);
+			};
+		else if constexpr (std::is_enum_v<T>)
+			return [&var](const std::string& s) {
+				const std::string w = internal::firstWord(s);
+				if (!w.empty() && ::isdigit(w[0]))
+					var = static_cast<T>(internal::parseInt(w));
+				else
+					var = mrpt::typemeta::TEnumType<T>::name2value(w);
+			};
+		else
+			static_assert(
+				std::is_same_v<T, bool>,
+				"Unsupported type: use bindCustom() instead");
+	}
+
+	template <typename T, typename VAL>
+	static T checkedCast(VAL v, const std::string& s)
+	{
+		bool inRange = v <= std::numeric_limits<T>::max();
+		if constexpr (std::is_signed_v<T>)
+			inRange = inRange && v >= std::numeric_limits<T>::lowest();
+		if (!inRange)
+			THROW_EXCEPTION_FMT("Out of range integer: '%s'", s.c_str());
+		return static_cast<T>(v);
+	}
+};
+
+}  // namespace mrpt::config
@@ -215,4 +215,25 @@ void CConfigFile::getAllKeys(
 		*s = n->pItem;
 }
 
+void CConfigFile::readSection(
+	const std::string& section, key_values_t& keyValues) const
+{
+	keyValues.clear();
+	// Only one look-up of the section:
+	const CSimpleIniA::TKeyVal* keys = m_impl->ini->GetSection(section.c_str());
+	if (!keys) return;
+
+	keyValues.reserve(keys->size());
+	for (const auto& kv : *keys)
+	{
+		// Remove possible comments: "//", as in readString()
+		std::string val = kv.second ? kv.second : "";
+		size_t pos;
+		if ((pos = val.find("//")) != string::npos && pos > 0 &&
+			isspace(val[pos - 1]))
+			val.resize(pos);
+		keyValues.emplace_back(kv.first.pItem, std::move(val));
+	}
+}
+
 void CConfigFile::clear() { m_impl->ini->Reset(); }
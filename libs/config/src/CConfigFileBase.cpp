@@ -199,6 +199,20 @@ std::string CConfigFileBase::read_string_first_word(
 		return auxStrs[0];
 }
 
+void CConfigFileBase::readSection(
+	const std::string& section, key_values_t& keyValues) const
+{
+	std::vector<std::string> keys;
+	getAllKeys(section, keys);
+	keyValues.clear();
+	keyValues.reserve(keys.size());
+	for (auto& k : keys)
+	{
+		std::string val = readString(section, k, "");
+		keyValues.emplace_back(std::move(k), std::move(val));
+	}
+}
+
 bool CConfigFileBase::sectionExists(const std::string& section_name) const
 {
 	std::vector<std::string> sects;
@@ -224,8 +238,12 @@ void CConfigFileBase::setContentFromYAML(const std::string& yaml_block)
 	MRPT_START
 	this->clear();
 
+	// Comments are not kept in INI files, so no need to parse them:
+	mrpt::containers::YamlParseOptions po;
+	po.parseComments = false;
+
 	mrpt::containers::yaml root;
-	root.loadFromText(yaml_block);
+	root.loadFromText(yaml_block, po);
 
 	// Prepare all data here, then insert into the actual INI file at the end,
 	// to ensure that unscoped variables get first.
@@ -10,6 +10,7 @@
 #include "config-precomp.h"	 // Precompiled headers
 //
 #include <mrpt/config/CConfigFilePrefixer.h>
+#include <mrpt/system/os.h>
 
 using namespace mrpt::config;
 using namespace std;
@@ -74,6 +75,27 @@ void CConfigFilePrefixer::getAllKeys(
 	for (auto& key : keys)
 		key = m_prefix_keys + key;
 }
+void CConfigFilePrefixer::readSection(
+	const std::string& section, key_values_t& keyValues) const
+{
+	ensureIsBound();
+	m_bound_object->readSection(m_prefix_sections + section, keyValues);
+	if (m_prefix_keys.empty()) return;
+
+	key_values_t matching;
+	for (auto& kv : keyValues)
+	{
+		if (kv.first.size() < m_prefix_keys.size() ||
+			mrpt::system::os::_strnicmp(
+				kv.first.c_str(), m_prefix_keys.c_str(),
+				m_prefix_keys.size()) != 0)
+			continue;
+		matching.emplace_back(
+			kv.first.substr(m_prefix_keys.size()), std::move(kv.second));
+	}
+	keyValues = std::move(matching);
+}
+
 void CConfigFilePrefixer::clear()
 {
 	ensureIsBound();
@@ -0,0 +1,126 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "config-precomp.h"	 // Precompiled headers
+//
+#include <mrpt/config/CConfigSectionBinder.h>
+#include <mrpt/system/os.h>
+#include <mrpt/system/string_utils.h>
+
+#include <cerrno>
+#include <cstdlib>
+#include <unordered_map>
+
+using namespace mrpt::config;
+
+bool mrpt::config::internal::parseBool(const std::string& s)
+{
+	// Same rules than CConfigFileBase::read_bool():
+	const std::string v = mrpt::system::lowerCase(mrpt::system::trim(s));
+	if (v == "true" || v == "yes") return true;
+	if (v == "false" || v == "no") return false;
+	return 0 != std::atoi(v.c_str());
+}
+
+double mrpt::config::internal::parseDouble(const std::string& s)
+{
+	return std::atof(s.c_str());
+}
+
+int64_t mrpt::config::internal::parseInt(const std::string& s)
+{
+	errno = 0;
+	const long long v = std::strtoll(s.c_str(), nullptr, 10);
+	if (errno == ERANGE)
+		THROW_EXCEPTION_FMT("Out of range integer: '%s'", s.c_str());
+	return static_cast<int64_t>(v);
+}
+
+uint64_t mrpt::config::internal::parseUInt(const std::string& s)
+{
+	const std::string v = mrpt::system::trim(s);
+	if (!v.empty() && v[0] == '-')
+		THROW_EXCEPTION_FMT(
+			"Negative value for unsigned integer: '%s'", s.c_str());
+	errno = 0;
+	const uint64_t r = mrpt::system::os::_strtoull(v.c_str(), nullptr, 0);
+	if (errno == ERANGE)
+		THROW_EXCEPTION_FMT("Out of range integer: '%s'", s.c_str());
+	return r;
+}
+
+std::string mrpt::config::internal::firstWord(const std::string& s)
+{
+	std::vector<std::string> words;
+	mrpt::system::tokenize(s, "[], \t", words);
+	return words.empty() ? std::string() : words[0];
+}
+
+CConfigSectionBinder& CConfigSectionBinder::bindCustom(
+	const std::string& key, parser_t parser, bool required)
+{
+	ASSERT_(parser);
+	Binding b;
+	b.key = key;
+	b.keyLowerCase = mrpt::system::lowerCase(key);
+	b.parser = std::move(parser);
+	b.required = required;
+	m_bindings.emplace_back(std::move(b));
+	return *this;
+}
+
+size_t CConfigSectionBinder::load(
+	const CConfigFileBase& cfg, const std::string& section) const
+{
+	MRPT_START
+
+	CConfigFileBase::key_values_t keyValues;
+	cfg.readSection(section, keyValues);
+
+	// Resolve all keys at once. With repeated keys, the first one is used,
+	// as with CConfigFileBase::read_*():
+	std::unordered_map<std::string, const std::string*> values;
+	values.reserve(keyValues.size());
+	for (const auto& kv : keyValues)
+		values.emplace(mrpt::system::lowerCase(kv.first), &kv.second);
+
+	size_t found = 0;
+	std::string missing;
+	for (const auto& b : m_bindings)
+	{
+		const auto it = values.find(b.keyLowerCase);
+		if (it == values.end())
+		{
+			if (b.required)
+			{
+				if (!missing.empty()) missing += ", ";
+				missing += b.key;
+			}
+			continue;
+		}
+		try
+		{
+			b.parser(*it->second);
+		}
+		catch (const std::exception& e)
+		{
+			THROW_EXCEPTION_FMT(
+				"Error parsing key '%s' in section '%s':\n%s", b.key.c_str(),
+				section.c_str(), mrpt::exception_to_str(e).c_str());
+		}
+		found++;
+	}
+	if (!missing.empty())
+		THROW_EXCEPTION_FMT(
+			"Required keys not found in section '%s': %s", section.c_str(),
+			missing.c_str());
+	return found;
+
+	MRPT_END
+}
@@ -0,0 +1,91 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/config/CConfigFileMemory.h>
+#include <mrpt/config/CConfigFilePrefixer.h>
+#include <mrpt/config/CConfigSectionBinder.h>
+
+namespace
+{
+const char* sampleConfig = R"xxx(
+[params]
+maxRange = 80.5  // comment
+decimation = 4
+SensorLabel = LIDAR
+enabled = yes
+aperture = 180
+mask = 0x10
+name =   some text
+s1_maxRange = 10
+)xxx";
+}  // namespace
+
+TEST(CConfigSectionBinder, load)
+{
+	const mrpt::config::CConfigFileMemory cfg(sampleConfig);
+
+	double maxRange = 0, aperture = 0, notInFile = 1.5;
+	int decimation = 0;
+	bool enabled = false;
+	uint32_t mask = 0;
+	std::string label, name;
+
+	mrpt::config::CConfigSectionBinder b;
+	b.bind("maxRange", maxRange)
+		.bind("decimation", decimation)
+		.bindRequired("sensorLabel", label)
+		.bind("enabled", enabled)
+		.bindDegrees("aperture", aperture)
+		.bind("mask", mask)
+		.bind("name", name)
+		.bind("notInFile", notInFile);
+	EXPECT_EQ(b.size(), 8U);
+	EXPECT_EQ(b.load(cfg, "params"), 7U);
+
+	EXPECT_DOUBLE_EQ(maxRange, 80.5);
+	EXPECT_EQ(decimation, 4);
+	EXPECT_EQ(label, "LIDAR");
+	EXPECT_TRUE(enabled);
+	EXPECT_DOUBLE_EQ(aperture, mrpt::DEG2RAD(180.0));
+	EXPECT_EQ(mask, 16U);
+	EXPECT_EQ(name, "some text");
+	EXPECT_DOUBLE_EQ(notInFile, 1.5);
+
+	// Same values than the read_*() methods:
+	EXPECT_DOUBLE_EQ(maxRange, cfg.read_double("params", "maxRange", 0));
+	EXPECT_EQ(name, cfg.read_string("params", "name", ""));
+
+	// Missing required keys, or parse errors:
+	std::string other;
+	mrpt::config::CConfigSectionBinder b2;
+	b2.bindRequired("other", other);
+	EXPECT_ANY_THROW(b2.load(cfg, "params"));
+	EXPECT_ANY_THROW(b2.load(cfg, "noSuchSection"));
+
+	int8_t small = 0;
+	mrpt::config::CConfigSectionBinder b3;
+	b3.bind("maxRange", small).bind("mask", small);
+	EXPECT_NO_THROW(b3.load(cfg, "params"));
+	b3.clear();
+	b3.bind("decimation", mask).bind("aperture", small);
+	EXPECT_ANY_THROW(b3.load(cfg, "params"));  // 180 > int8_t
+}
+
+TEST(CConfigSectionBinder, prefixer)
+{
+	const mrpt::config::CConfigFileMemory cfg(sampleConfig);
+	const mrpt::config::CConfigFilePrefixer pr(cfg, "", "s1_");
+
+	double maxRange = 0;
+	mrpt::config::CConfigSectionBinder b;
+	b.bind("maxRange", maxRange);
+	EXPECT_EQ(b.load(pr, "params"), 1U);
+	EXPECT_DOUBLE_EQ(maxRange, 10.0);
+}
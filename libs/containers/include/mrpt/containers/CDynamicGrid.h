@@ -8,8 +8,10 @@
    +------------------------------------------------------------------------+ */
 #pragma once
 
+#include <mrpt/containers/grid_layouts.h>
 #include <mrpt/core/round.h>
 
+#include <algorithm>
 #include <cmath>
 #include <cstddef>
 #include <string>
@@ -32,14 +34,23 @@ struct dynamic_grid_txt_saver
 }  // namespace internal
 
 /** A 2D grid of dynamic size which stores any kind of data at each cell.
+ *
+ * Cells are stored in the order given by the `LAYOUT`: row-major by default,
+ * or in Morton-ordered tiles with GridLayoutTiled2D, for better cache
+ * locality in neighbourhood-heavy algorithms. Use forEachCell() to visit all
+ * cells in storage order, and forEachCellInWindow() for neighbourhoods.
+ *
  * \tparam T The type of each cell in the 2D grid.
+ * \tparam LAYOUT The storage layout, GridLayoutRowMajor2D or
+ * GridLayoutTiled2D (New in MRPT 2.4.9).
  * \ingroup mrpt_containers_grp
  */
-template <class T>
+template <class T, class LAYOUT = GridLayoutRowMajor2D>
 class CDynamicGrid
 {
    public:
 	using grid_data_t = std::vector<T>;
+	using layout_t = LAYOUT;
 	using iterator = typename grid_data_t::iterator;
 	using const_iterator = typename grid_data_t::const_iterator;
 
@@ -81,18 +92,19 @@ class CDynamicGrid
 		// Now the number of cells should be integers:
 		m_size_x = round((m_x_max - m_x_min) / m_resolution);
 		m_size_y = round((m_y_max - m_y_min) / m_resolution);
+		m_layout.setSize(m_size_x, m_size_y);
 
 		// Cells memory:
-		if (fill_value) m_map.assign(m_size_x * m_size_y, *fill_value);
+		if (fill_value) m_map.assign(m_layout.storageSize(), *fill_value);
 		else
-			m_map.resize(m_size_x * m_size_y);
+			m_map.resize(m_layout.storageSize());
 	}
 
 	/** Erase the contents of all the cells. */
 	void clear()
 	{
 		m_map.clear();
-		m_map.resize(m_size_x * m_size_y);
+		m_map.resize(m_layout.storageSize());
 	}
 
 	/** Fills all the cells with the same value
@@ -156,23 +168,35 @@ class CDynamicGrid
 		unsigned int new_size_y = round((new_y_max - new_y_min) / m_resolution);
 
 		// Reserve new memory:
+		LAYOUT new_layout;
+		new_layout.setSize(new_size_x, new_size_y);
 		grid_data_t new_map;
-		new_map.resize(new_size_x * new_size_y, defaultValueNewCells);
+		new_map.resize(new_layout.storageSize(), defaultValueNewCells);
 
 		// Copy previous rows:
-		unsigned int x, y;
-		iterator itSrc, itDst;
-		for (y = 0; y < m_size_y; y++)
+		if constexpr (LAYOUT::is_row_major)
 		{
-			for (x = 0, itSrc = (m_map.begin() + y * m_size_x),
-				itDst =
-					 (new_map.begin() + extra_x_izq +
-					  (y + extra_y_arr) * new_size_x);
-				 x < m_size_x; ++x, ++itSrc, ++itDst)
+			unsigned int x, y;
+			iterator itSrc, itDst;
+			for (y = 0; y < m_size_y; y++)
 			{
-				*itDst = *itSrc;
+				for (x = 0, itSrc = (m_map.begin() + y * m_size_x),
+					itDst =
+						 (new_map.begin() + extra_x_izq +
+						  (y + extra_y_arr) * new_size_x);
+					 x < m_size_x; ++x, ++itSrc, ++itDst)
+				{
+					*itDst = *itSrc;
+				}
 			}
 		}
+		else
+		{
+			m_layout.forEachCell([&](size_t idx, size_t cx, size_t cy) {
+				new_map[new_layout.index(
+					cx + extra_x_izq, cy + extra_y_arr)] = m_map[idx];
+			});
+		}
 
 		// Update the new map limits:
 		m_x_min = new_x_min;
@@ -182,6 +206,7 @@ class CDynamicGrid
 
 		m_size_x = new_size_x;
 		m_size_y = new_size_y;
+		m_layout = new_layout;
 
 		// Keep the new map only:
 		m_map.swap(new_map);
@@ -196,7 +221,7 @@ class CDynamicGrid
 		const int cy = y2idx(y);
 		if (cx < 0 || cx >= static_cast<int>(m_size_x)) return nullptr;
 		if (cy < 0 || cy >= static_cast<int>(m_size_y)) return nullptr;
-		return &m_map[cx + cy * m_size_x];
+		return &m_map[m_layout.index(cx, cy)];
 	}
 	/** \overload */
 	inline const T* cellByPos(double x, double y) const
@@ -205,7 +230,7 @@ class CDynamicGrid
 		const int cy = y2idx(y);
 		if (cx < 0 || cx >= static_cast<int>(m_size_x)) return nullptr;
 		if (cy < 0 || cy >= static_cast<int>(m_size_y)) return nullptr;
-		return &m_map[cx + cy * m_size_x];
+		return &m_map[m_layout.index(cx, cy)];
 	}
 
 	/** Returns a pointer to the contents of a cell given by its cell indexes,
@@ -215,7 +240,7 @@ class CDynamicGrid
 	{
 		if (cx >= m_size_x || cy >= m_size_y) return nullptr;
 		else
-			return &m_map[cx + cy * m_size_x];
+			return &m_map[m_layout.index(cx, cy)];
 	}
 
 	/** Returns a pointer to the contents of a cell given by its cell indexes,
@@ -225,7 +250,7 @@ class CDynamicGrid
 	{
 		if (cx >= m_size_x || cy >= m_size_y) return nullptr;
 		else
-			return &m_map[cx + cy * m_size_x];
+			return &m_map[m_layout.index(cx, cy)];
 	}
 
 	/** Returns the horizontal size of grid map in cells count */
@@ -251,17 +276,32 @@ class CDynamicGrid
 	{
 		return static_cast<int>((y - m_y_min) / m_resolution);
 	}
+	/** Linear (storage) index of the cell with the given coordinates, which
+	 * must be within the grid if the layout is not row-major. */
 	inline int xy2idx(double x, double y) const
 	{
-		return x2idx(x) + y2idx(y) * m_size_x;
+		if constexpr (LAYOUT::is_row_major)
+			return x2idx(x) + y2idx(y) * m_size_x;
+		else
+			return static_cast<int>(m_layout.index(x2idx(x), y2idx(y)));
 	}
 
 	/** Transform a global (linear) cell index value into its corresponding
 	 * (x,y) cell indexes. */
 	inline void idx2cxcy(int idx, int& cx, int& cy) const
 	{
-		cx = idx % m_size_x;
-		cy = idx / m_size_x;
+		if constexpr (LAYOUT::is_row_major)
+		{
+			cx = idx % m_size_x;
+			cy = idx / m_size_x;
+		}
+		else
+		{
+			size_t x, y;
+			m_layout.cellOf(idx, x, y);
+			cx = static_cast<int>(x);
+			cy = static_cast<int>(y);
+		}
 	}
 
 	/** Transform a cell index into a coordinate value of the cell central point
@@ -290,10 +330,19 @@ class CDynamicGrid
 	{
 		m.setSize(m_size_y, m_size_x);
 		if (m_map.empty()) return;
-		const T* c = &m_map[0];
-		for (size_t cy = 0; cy < m_size_y; cy++)
-			for (size_t cx = 0; cx < m_size_x; cx++)
-				m(cy, cx) = *c++;
+		if constexpr (LAYOUT::is_row_major)
+		{
+			const T* c = &m_map[0];
+			for (size_t cy = 0; cy < m_size_y; cy++)
+				for (size_t cx = 0; cx < m_size_x; cx++)
+					m(cy, cx) = *c++;
+		}
+		else
+		{
+			forEachCell([&m](size_t cx, size_t cy, const T& c) {
+				m(cy, cx) = c;
+			});
+		}
 	}
 
 	/** The user must implement this in order to provide "saveToTextFile" a way
@@ -305,16 +354,15 @@ class CDynamicGrid
 	{
 		struct aux_saver : public internal::dynamic_grid_txt_saver
 		{
-			aux_saver(const CDynamicGrid<T>& obj) : m_obj(obj) {}
+			aux_saver(const CDynamicGrid& obj) : m_obj(obj) {}
 			unsigned int getSizeX() const override { return m_obj.getSizeX(); }
 			unsigned int getSizeY() const override { return m_obj.getSizeY(); }
 			float getCellAsFloat(
 				unsigned int cx, unsigned int cy) const override
 			{
-				return m_obj.cell2float(
-					m_obj.m_map[cx + cy * m_obj.getSizeX()]);
+				return m_obj.cell2float(*m_obj.cellByIndex(cx, cy));
 			}
-			const CDynamicGrid<T>& m_obj;
+			const CDynamicGrid& m_obj;
 		};
 		aux_saver aux(*this);
 		return aux.saveToTextFile(fileName);
@@ -327,6 +375,55 @@ class CDynamicGrid
 	inline iterator end() { return m_map.end(); }
 	inline const_iterator begin() const { return m_map.begin(); }
 	inline const_iterator end() const { return m_map.end(); }
+
+	/** The storage layout of the cells in data() */
+	inline const layout_t& layout() const { return m_layout; }
+
+	/** Calls `fn(cx, cy, cell)` for each cell, in storage order, which is
+	 * the most cache-friendly way of visiting all the cells (the padding
+	 * cells of tiled layouts are skipped). \note (New in MRPT 2.4.9) */
+	template <class FN>
+	void forEachCell(FN&& fn)
+	{
+		m_layout.forEachCell([&](size_t idx, size_t cx, size_t cy) {
+			fn(cx, cy, m_map[idx]);
+		});
+	}
+	/** \overload */
+	template <class FN>
+	void forEachCell(FN&& fn) const
+	{
+		m_layout.forEachCell([&](size_t idx, size_t cx, size_t cy) {
+			fn(cx, cy, m_map[idx]);
+		});
+	}
+
+	/** Calls `fn(cx, cy, cell)` for each cell within the square window of
+	 * cells [cx-radius, cx+radius] x [cy-radius, cy+radius], clipped to the
+	 * grid limits. \note (New in MRPT 2.4.9) */
+	template <class FN>
+	void forEachCellInWindow(int cx, int cy, int radius, FN&& fn)
+	{
+		const int x0 = std::max(cx - radius, 0);
+		const int x1 = std::min(cx + radius, static_cast<int>(m_size_x) - 1);
+		const int y0 = std::max(cy - radius, 0);
+		const int y1 = std::min(cy + radius, static_cast<int>(m_size_y) - 1);
+		for (int y = y0; y <= y1; y++)
+			for (int x = x0; x <= x1; x++)
+				fn(x, y, m_map[m_layout.index(x, y)]);
+	}
+	/** \overload */
+	template <class FN>
+	void forEachCellInWindow(int cx, int cy, int radius, FN&& fn) const
+	{
+		const int x0 = std::max(cx - radius, 0);
+		const int x1 = std::min(cx + radius, static_cast<int>(m_size_x) - 1);
+		const int y0 = std::max(cy - radius, 0);
+		const int y1 = std::min(cy + radius, static_cast<int>(m_size_y) - 1);
+		for (int y = y0; y <= y1; y++)
+			for (int x = x0; x <= x1; x++)
+				fn(x, y, m_map[m_layout.index(x, y)]);
+	}
 	/** @} */
 
    protected:
@@ -358,7 +455,8 @@ class CDynamicGrid
 		}
 		m_size_x = in.template ReadAs<uint32_t>();
 		m_size_y = in.template ReadAs<uint32_t>();
-		m_map.resize(m_size_x * m_size_y);
+		m_layout.setSize(m_size_x, m_size_y);
+		m_map.resize(m_layout.storageSize());
 	}
 
    protected:
@@ -373,6 +471,8 @@ class CDynamicGrid
 
 	double m_x_min{0}, m_x_max{0}, m_y_min{0}, m_y_max{0}, m_resolution{0};
 	size_t m_size_x{0}, m_size_y{0};
+	/** Storage layout of m_map */
+	LAYOUT m_layout;
 
 };	// end of CDynamicGrid<>
 
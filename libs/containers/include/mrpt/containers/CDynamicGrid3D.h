@@ -8,8 +8,10 @@
    +------------------------------------------------------------------------+ */
 #pragma once
 
+#include <mrpt/containers/grid_layouts.h>
 #include <mrpt/core/round.h>
 
+#include <algorithm>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
@@ -20,14 +22,23 @@ namespace mrpt::containers
 {
 /** A 3D rectangular grid of dynamic size which stores any kind of data at each
  * voxel.
+ *
+ * Voxels are stored in the order given by the `LAYOUT`: row-major by default,
+ * or in Morton-ordered bricks with GridLayoutTiled3D, for better cache
+ * locality along all axes. Use forEachCell() to visit all voxels in storage
+ * order, and forEachCellInWindow() for neighbourhoods.
+ *
  * \tparam T The type of each voxel in the grid.
+ * \tparam LAYOUT The storage layout, GridLayoutRowMajor3D or
+ * GridLayoutTiled3D (New in MRPT 2.4.9).
  * \ingroup mrpt_containers_grp
  */
-template <class T, class coord_t = double>
+template <class T, class coord_t = double, class LAYOUT = GridLayoutRowMajor3D>
 class CDynamicGrid3D
 {
    public:
 	using grid_data_t = std::vector<T>;
+	using layout_t = LAYOUT;
 	using iterator = typename grid_data_t::iterator;
 	using const_iterator = typename grid_data_t::const_iterator;
 
@@ -119,30 +130,44 @@ class CDynamicGrid3D
 		size_t new_size_x_times_y = new_size_x * new_size_y;
 
 		// Reserve new memory:
+		LAYOUT new_layout;
+		new_layout.setSize(new_size_x, new_size_y, new_size_z);
 		grid_data_t new_map;
-		new_map.resize(
-			new_size_x * new_size_y * new_size_z, defaultValueNewCells);
+		new_map.resize(new_layout.storageSize(), defaultValueNewCells);
 
 		// Copy previous rows:
-		size_t x, y, z;
-		iterator itSrc, itDst;
-		for (z = 0; z < m_size_z; z++)
+		if constexpr (LAYOUT::is_row_major)
 		{
-			for (y = 0; y < m_size_y; y++)
+			size_t x, y, z;
+			iterator itSrc, itDst;
+			for (z = 0; z < m_size_z; z++)
 			{
-				for (x = 0,
-					itSrc =
-						 (m_map.begin() + y * m_size_x + z * m_size_x_times_y),
-					itDst =
-						 (new_map.begin() + extra_x_izq +
-						  (y + extra_y_arr) * new_size_x +
-						  (z + extra_z_top) * new_size_x_times_y);
-					 x < m_size_x; ++x, ++itSrc, ++itDst)
+				for (y = 0; y < m_size_y; y++)
 				{
-					*itDst = *itSrc;
+					for (x = 0,
+						itSrc =
+							 (m_map.begin() + y * m_size_x +
+							  z * m_size_x_times_y),
+						itDst =
+							 (new_map.begin() + extra_x_izq +
+							  (y + extra_y_arr) * new_size_x +
+							  (z + extra_z_top) * new_size_x_times_y);
+						 x < m_size_x; ++x, ++itSrc, ++itDst)
+					{
+						*itDst = *itSrc;
+					}
 				}
 			}
 		}
+		else
+		{
+			m_layout.forEachCell(
+				[&](size_t idx, size_t cx, size_t cy, size_t cz) {
+					new_map[new_layout.index(
+						cx + extra_x_izq, cy + extra_y_arr,
+						cz + extra_z_top)] = m_map[idx];
+				});
+		}
 
 		// Update the new map limits:
 		m_x_min = new_x_min;
@@ -156,6 +181,7 @@ class CDynamicGrid3D
 		m_size_y = new_size_y;
 		m_size_z = new_size_z;
 		m_size_x_times_y = new_size_x_times_y;
+		m_layout = new_layout;
 
 		// Keep the new map only:
 		m_map.swap(new_map);
@@ -203,12 +229,12 @@ class CDynamicGrid3D
 		m_size_y = round((m_y_max - m_y_min) / m_resolution_xy);
 		m_size_x_times_y = m_size_x * m_size_y;
 		m_size_z = round((m_z_max - m_z_min) / m_resolution_z);
+		m_layout.setSize(m_size_x, m_size_y, m_size_z);
 
 		// Cells memory:
-		if (fill_value)
-			m_map.assign(m_size_x * m_size_y * m_size_z, *fill_value);
+		if (fill_value) m_map.assign(m_layout.storageSize(), *fill_value);
 		else
-			m_map.resize(m_size_x * m_size_y * m_size_z);
+			m_map.resize(m_layout.storageSize());
 	}
 
 	/** Erase the contents of all the cells, setting them to their default
@@ -216,7 +242,7 @@ class CDynamicGrid3D
 	virtual void clear()
 	{
 		m_map.clear();
-		m_map.resize(m_size_x * m_size_y * m_size_z);
+		m_map.resize(m_layout.storageSize());
 	}
 
 	/** Fills all the cells with the same value
@@ -243,7 +269,7 @@ class CDynamicGrid3D
 		const int cx, const int cy, const int cz) const
 	{
 		if (isOutOfBounds(cx, cy, cz)) return INVALID_VOXEL_IDX;
-		return cx + cy * m_size_x + cz * m_size_x_times_y;
+		return m_layout.index(cx, cy, cz);
 	}
 
 	/** Returns a pointer to the contents of a voxel given by its coordinates,
@@ -358,6 +384,65 @@ class CDynamicGrid3D
 	inline iterator end() { return m_map.end(); }
 	inline const_iterator begin() const { return m_map.begin(); }
 	inline const_iterator end() const { return m_map.end(); }
+
+	/** The storage layout of the voxels in data() */
+	inline const layout_t& layout() const { return m_layout; }
+
+	/** Calls `fn(cx, cy, cz, voxel)` for each voxel, in storage order, which
+	 * is the most cache-friendly way of visiting all the voxels (the padding
+	 * voxels of tiled layouts are skipped). \note (New in MRPT 2.4.9) */
+	template <class FN>
+	void forEachCell(FN&& fn)
+	{
+		m_layout.forEachCell(
+			[&](size_t idx, size_t cx, size_t cy, size_t cz) {
+				fn(cx, cy, cz, m_map[idx]);
+			});
+	}
+	/** \overload */
+	template <class FN>
+	void forEachCell(FN&& fn) const
+	{
+		m_layout.forEachCell(
+			[&](size_t idx, size_t cx, size_t cy, size_t cz) {
+				fn(cx, cy, cz, static_cast<const T&>(m_map[idx]));
+			});
+	}
+
+	/** Calls `fn(cx, cy, cz, voxel)` for each voxel within the cube of
+	 * voxels of half side `radius` centered at (cx,cy,cz), clipped to the
+	 * grid limits. \note (New in MRPT 2.4.9) */
+	template <class FN>
+	void forEachCellInWindow(int cx, int cy, int cz, int radius, FN&& fn)
+	{
+		const int x0 = std::max(cx - radius, 0);
+		const int x1 = std::min(cx + radius, static_cast<int>(m_size_x) - 1);
+		const int y0 = std::max(cy - radius, 0);
+		const int y1 = std::min(cy + radius, static_cast<int>(m_size_y) - 1);
+		const int z0 = std::max(cz - radius, 0);
+		const int z1 = std::min(cz + radius, static_cast<int>(m_size_z) - 1);
+		for (int z = z0; z <= z1; z++)
+			for (int y = y0; y <= y1; y++)
+				for (int x = x0; x <= x1; x++)
+					fn(x, y, z, m_map[m_layout.index(x, y, z)]);
+	}
+	/** \overload */
+	template <class FN>
+	void forEachCellInWindow(
+		int cx, int cy, int cz, int radius, FN&& fn) const
+	{
+		const int x0 = std::max(cx - radius, 0);
+		const int x1 = std::min(cx + radius, static_cast<int>(m_size_x) - 1);
+		const int y0 = std::max(cy - radius, 0);
+		const int y1 = std::min(cy + radius, static_cast<int>(m_size_y) - 1);
+		const int z0 = std::max(cz - radius, 0);
+		const int z1 = std::min(cz + radius, static_cast<int>(m_size_z) - 1);
+		for (int z = z0; z <= z1; z++)
+			for (int y = y0; y <= y1; y++)
+				for (int x = x0; x <= x1; x++)
+					fn(x, y, z,
+					   static_cast<const T&>(m_map[m_layout.index(x, y, z)]));
+	}
 	/** @} */
 
    protected:
@@ -369,6 +454,8 @@ class CDynamicGrid3D
 	coord_t m_x_min, m_x_max, m_y_min, m_y_max, m_z_min, m_z_max,
 		m_resolution_xy, m_resolution_z;
 	size_t m_size_x, m_size_y, m_size_z, m_size_x_times_y;
+	/** Storage layout of m_map */
+	LAYOUT m_layout;
 
    public:
 	/** Serialization of all parameters, except the contents of each voxel
@@ -393,7 +480,9 @@ class CDynamicGrid3D
 		m_size_x = in.template ReadAs<uint32_t>();
 		m_size_y = in.template ReadAs<uint32_t>();
 		m_size_z = in.template ReadAs<uint32_t>();
-		m_map.resize(m_size_x * m_size_y * m_size_z);
+		m_size_x_times_y = m_size_x * m_size_y;
+		m_layout.setSize(m_size_x, m_size_y, m_size_z);
+		m_map.resize(m_layout.storageSize());
 	}
 
 };	// end of CDynamicGrid3D<>
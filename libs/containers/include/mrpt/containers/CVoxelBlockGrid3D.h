@@ -0,0 +1,292 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace mrpt::containers
+{
+/** A sparse, unbounded 3D grid of voxels, stored as hashed blocks of
+ * 2^BLOCK_BITS x 2^BLOCK_BITS x 2^BLOCK_BITS voxels (voxblox-style).
+ *
+ * Blocks are allocated the first time any of their voxels is written with
+ * cellRefByIndexAlloc(), and filled with the default voxel value. Reading a
+ * voxel in a non-allocated block returns nullptr, so memory usage grows with
+ * the observed volume only, and there is no need to resize the grid.
+ *
+ * Voxel indices are signed integers, with voxel (0,0,0) spanning from the
+ * origin to (resolution,resolution,resolution). Each block coordinate must fit
+ * in 21 bits (signed), e.g. +-1048576 blocks of 8 voxels of 0.05 m: ~420 km.
+ *
+ * \tparam T The type of each voxel in the grid.
+ * \tparam BLOCK_BITS Log2 of the block side length, in voxels.
+ * \sa CDynamicGrid3D
+ * \note (New in MRPT 2.4.9)
+ * \ingroup mrpt_containers_grp
+ */
+template <class T, unsigned int BLOCK_BITS = 3, class coord_t = double>
+class CVoxelBlockGrid3D
+{
+   public:
+	static constexpr int BLOCK_SIDE = 1 << BLOCK_BITS;
+	static constexpr size_t BLOCK_VOXELS =
+		size_t(1) << (3 * BLOCK_BITS);	// BLOCK_SIDE^3
+	using block_t = std::array<T, BLOCK_VOXELS>;
+	/** Hash key of a block, packing its (bx,by,bz) coordinates */
+	using block_key_t = uint64_t;
+
+	CVoxelBlockGrid3D(coord_t resolution = 0.10, const T& defaultValue = T())
+	{
+		setResolution(resolution, defaultValue);
+	}
+
+	CVoxelBlockGrid3D(const CVoxelBlockGrid3D& o) { *this = o; }
+	CVoxelBlockGrid3D& operator=(const CVoxelBlockGrid3D& o)
+	{
+		if (this == &o) return *this;
+		m_resolution = o.m_resolution;
+		m_defaultValue = o.m_defaultValue;
+		m_blocks.clear();
+		for (const auto& kv : o.m_blocks)
+			m_blocks[kv.first] = std::make_unique<block_t>(*kv.second);
+		m_lastKey = INVALID_KEY;
+		m_lastBlock = nullptr;
+		return *this;
+	}
+	CVoxelBlockGrid3D(CVoxelBlockGrid3D&& o) { *this = std::move(o); }
+	CVoxelBlockGrid3D& operator=(CVoxelBlockGrid3D&& o)
+	{
+		if (this == &o) return *this;
+		m_resolution = o.m_resolution;
+		m_defaultValue = o.m_defaultValue;
+		m_blocks = std::move(o.m_blocks);
+		m_lastKey = INVALID_KEY;
+		m_lastBlock = nullptr;
+		o.clear();
+		return *this;
+	}
+
+	/** Removes all blocks and changes the voxel size and default value */
+	void setResolution(coord_t resolution, const T& defaultValue = T())
+	{
+		if (!(resolution > 0))
+			throw std::invalid_argument(
+				"CVoxelBlockGrid3D: resolution must be >0");
+		m_resolution = resolution;
+		m_defaultValue = defaultValue;
+		clear();
+	}
+
+	/** Removes all blocks */
+	void clear()
+	{
+		m_blocks.clear();
+		m_lastKey = INVALID_KEY;
+		m_lastBlock = nullptr;
+	}
+
+	coord_t getResolution() const { return m_resolution; }
+	const T& getDefaultValue() const { return m_defaultValue; }
+
+	inline int x2idx(coord_t x) const
+	{
+		return static_cast<int>(std::floor(x / m_resolution));
+	}
+	inline int y2idx(coord_t y) const { return x2idx(y); }
+	inline int z2idx(coord_t z) const { return x2idx(z); }
+	/** Coordinate of the voxel lower corner */
+	inline coord_t idx2x(int cx) const { return cx * m_resolution; }
+	inline coord_t idx2y(int cy) const { return idx2x(cy); }
+	inline coord_t idx2z(int cz) const { return idx2x(cz); }
+
+	/** Returns the voxel, or nullptr if its block has not been allocated */
+	inline const T* cellByIndex(int cx, int cy, int cz) const
+	{
+		const auto it = m_blocks.find(blockKey(cx, cy, cz));
+		if (it == m_blocks.end()) return nullptr;
+		return &(*it->second)[offsetInBlock(cx, cy, cz)];
+	}
+	/** \overload */
+	inline T* cellByIndex(int cx, int cy, int cz)
+	{
+		block_t* b = findBlock(blockKey(cx, cy, cz));
+		return b ? &(*b)[offsetInBlock(cx, cy, cz)] : nullptr;
+	}
+
+	/** Returns the voxel, allocating its block if needed. */
+	inline T& cellRefByIndexAlloc(int cx, int cy, int cz)
+	{
+		const block_key_t key = blockKey(cx, cy, cz);
+		block_t* b = findBlock(key);
+		if (!b)
+		{
+			auto& ptr = m_blocks[key];
+			ptr = std::make_unique<block_t>();
+			ptr->fill(m_defaultValue);
+			b = ptr.get();
+			m_lastKey = key;
+			m_lastBlock = b;
+		}
+		return (*b)[offsetInBlock(cx, cy, cz)];
+	}
+
+	inline const T* cellByPos(coord_t x, coord_t y, coord_t z) const
+	{
+		return cellByIndex(x2idx(x), y2idx(y), z2idx(z));
+	}
+	inline T& cellRefByPosAlloc(coord_t x, coord_t y, coord_t z)
+	{
+		return cellRefByIndexAlloc(x2idx(x), y2idx(y), z2idx(z));
+	}
+
+	/** Number of allocated blocks */
+	size_t getBlockCount() const { return m_blocks.size(); }
+	/** Number of voxels in allocated blocks */
+	size_t getAllocatedVoxelCount() const
+	{
+		return m_blocks.size() * BLOCK_VOXELS;
+	}
+	/** Approximate memory used by the voxel blocks, in bytes */
+	size_t getMemoryUsage() const
+	{
+		return m_blocks.size() * (sizeof(block_t) + sizeof(block_key_t) +
+								  sizeof(std::unique_ptr<block_t>));
+	}
+
+	/** Unpacks a key into the index of the first voxel of its block */
+	static void blockKeyToFirstVoxel(
+		block_key_t key, int& cx0, int& cy0, int& cz0)
+	{
+		cx0 = unpackCoord(key >> (2 * KEY_BITS)) * BLOCK_SIDE;
+		cy0 = unpackCoord(key >> KEY_BITS) * BLOCK_SIDE;
+		cz0 = unpackCoord(key) * BLOCK_SIDE;
+	}
+
+	/** Calls `f(cx,cy,cz,value)` for all voxels in allocated blocks, in no
+	 * particular order. */
+	template <typename FUNCTOR>
+	void forEachAllocatedVoxel(FUNCTOR&& f) const
+	{
+		for (const auto& kv : m_blocks)
+		{
+			int cx0, cy0, cz0;
+			blockKeyToFirstVoxel(kv.first, cx0, cy0, cz0);
+			const block_t& b = *kv.second;
+			size_t i = 0;
+			for (int dz = 0; dz < BLOCK_SIDE; dz++)
+				for (int dy = 0; dy < BLOCK_SIDE; dy++)
+					for (int dx = 0; dx < BLOCK_SIDE; dx++)
+						f(cx0 + dx, cy0 + dy, cz0 + dz, b[i++]);
+		}
+	}
+
+	/** Direct access to the allocated blocks */
+	const std::unordered_map<block_key_t, std::unique_ptr<block_t>>& blocks()
+		const
+	{
+		return m_blocks;
+	}
+
+	/** Serialization of the resolution and all blocks (default value not
+	 * included). Voxel values are written with `writeVoxels(out, ptr, n)` */
+	template <class ARCHIVE, class WRITE_VOXELS>
+	void writeToStream(ARCHIVE& out, WRITE_VOXELS&& writeVoxels) const
+	{
+		out << static_cast<double>(m_resolution);
+		out.template WriteAs<uint32_t>(BLOCK_BITS);
+		out.template WriteAs<uint64_t>(m_blocks.size());
+		for (const auto& kv : m_blocks)
+		{
+			out.template WriteAs<uint64_t>(kv.first);
+			writeVoxels(out, kv.second->data(), BLOCK_VOXELS);
+		}
+	}
+	/** \sa writeToStream() */
+	template <class ARCHIVE, class READ_VOXELS>
+	void readFromStream(
+		ARCHIVE& in, const T& defaultValue, READ_VOXELS&& readVoxels)
+	{
+		const double res = in.template ReadAs<double>();
+		const auto blockBits = in.template ReadAs<uint32_t>();
+		if (blockBits != BLOCK_BITS)
+			throw std::runtime_error(
+				"CVoxelBlockGrid3D: stream has a different BLOCK_BITS");
+		setResolution(static_cast<coord_t>(res), defaultValue);
+		const auto nBlocks = in.template ReadAs<uint64_t>();
+		m_blocks.reserve(nBlocks);
+		for (uint64_t i = 0; i < nBlocks; i++)
+		{
+			const auto key = in.template ReadAs<uint64_t>();
+			auto b = std::make_unique<block_t>();
+			readVoxels(in, b->data(), BLOCK_VOXELS);
+			m_blocks[key] = std::move(b);
+		}
+	}
+
+	/** Computes the key of the block containing a given voxel */
+	static inline block_key_t blockKey(int cx, int cy, int cz)
+	{
+		return (packCoord(cx >> BLOCK_BITS) << (2 * KEY_BITS)) |
+			(packCoord(cy >> BLOCK_BITS) << KEY_BITS) |
+			packCoord(cz >> BLOCK_BITS);
+	}
+
+   private:
+	static constexpr unsigned int KEY_BITS = 21;
+	static constexpr block_key_t KEY_MASK = (block_key_t(1) << KEY_BITS) - 1;
+	static constexpr block_key_t INVALID_KEY =
+		std::numeric_limits<block_key_t>::max();
+
+	static inline block_key_t packCoord(int b)
+	{
+		return static_cast<block_key_t>(b) & KEY_MASK;
+	}
+	static inline int unpackCoord(block_key_t k)
+	{
+		k &= KEY_MASK;
+		// sign extension:
+		if (k & (block_key_t(1) << (KEY_BITS - 1)))
+			return static_cast<int>(k) - (1 << KEY_BITS);
+		return static_cast<int>(k);
+	}
+	static inline size_t offsetInBlock(int cx, int cy, int cz)
+	{
+		constexpr int M = BLOCK_SIDE - 1;
+		return static_cast<size_t>(
+			(cx & M) | ((cy & M) << BLOCK_BITS) |
+			((cz & M) << (2 * BLOCK_BITS)));
+	}
+
+	/** Lookup with a one-entry cache, since consecutive accesses (e.g. along
+	 * a ray) mostly fall in the same block */
+	inline block_t* findBlock(block_key_t key)
+	{
+		if (key == m_lastKey) return m_lastBlock;
+		const auto it = m_blocks.find(key);
+		if (it == m_blocks.end()) return nullptr;
+		m_lastKey = key;
+		m_lastBlock = it->second.get();
+		return m_lastBlock;
+	}
+
+	coord_t m_resolution = 0.10;
+	T m_defaultValue{};
+	std::unordered_map<block_key_t, std::unique_ptr<block_t>> m_blocks;
+	block_key_t m_lastKey = INVALID_KEY;
+	block_t* m_lastBlock = nullptr;
+};
+
+}  // namespace mrpt::containers
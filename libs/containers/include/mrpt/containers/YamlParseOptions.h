@@ -0,0 +1,25 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+namespace mrpt::containers
+{
+/** See mrpt::containers::yaml::loadFromText()
+ *
+ * \ingroup mrpt_containers_yaml
+ * \note (New in MRPT 2.4.9)
+ */
+struct YamlParseOptions
+{
+	/** Keep the comments of the parsed document. Disable it for faster
+	 * parsing when comments are not needed (e.g. configuration files). */
+	bool parseComments = true;
+};
+
+}  // namespace mrpt::containers
@@ -139,6 +139,29 @@ class circular_buffer
 		}
 	}
 
+	/** Returns a pointer to the next element to be read and, in `count`, the
+	 * number of elements which can be read from it without copying them, that
+	 * is, up to the end of the internal storage. It may be less than size()
+	 * if the data wraps around it. The pointer is valid until the next push.
+	 * \note (New in MRPT 2.4.9) */
+	const T* peek_contiguous(size_t& count) const
+	{
+		count = (m_next_write >= m_next_read) ? m_next_write - m_next_read
+											  : m_size - m_next_read;
+		return m_data.data() + m_next_read;
+	}
+
+	/** Removes `count` elements from the buffer, without reading them.
+	 * \exception std::out_of_range If the buffer has less elements than
+	 * requested.
+	 * \note (New in MRPT 2.4.9) */
+	void discard(size_t count)
+	{
+		if (count > size())
+			throw std::out_of_range("discard: not enough elements");
+		m_next_read = (m_next_read + count) % m_size;
+	}
+
 	/** Return the number of elements available for read ("pop") in the buffer
 	 * (this is NOT the maximum size of the internal buffer)
 	 * \sa capacity */
@@ -0,0 +1,410 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+
+namespace mrpt::containers
+{
+namespace internal
+{
+/** Reverses the order of the 64 bits of `x` */
+inline uint64_t reverse_bits_u64(uint64_t x)
+{
+	x = ((x >> 1) & 0x5555555555555555ULL) | ((x & 0x5555555555555555ULL) << 1);
+	x = ((x >> 2) & 0x3333333333333333ULL) | ((x & 0x3333333333333333ULL) << 2);
+	x = ((x >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((x & 0x0F0F0F0F0F0F0F0FULL) << 4);
+	x = ((x >> 8) & 0x00FF00FF00FF00FFULL) | ((x & 0x00FF00FF00FF00FFULL) << 8);
+	x = ((x >> 16) & 0x0000FFFF0000FFFFULL) |
+		((x & 0x0000FFFF0000FFFFULL) << 16);
+	return (x >> 32) | (x << 32);
+}
+
+/** Index of the highest bit set in `x` (x>0) */
+inline unsigned int highest_bit_u64(uint64_t x)
+{
+	unsigned int r = 0;
+	if (x >> 32) { x >>= 32; r += 32; }
+	if (x >> 16) { x >>= 16; r += 16; }
+	if (x >> 8) { x >>= 8; r += 8; }
+	if (x >> 4) { x >>= 4; r += 4; }
+	if (x >> 2) { x >>= 2; r += 2; }
+	if (x >> 1) r += 1;
+	return r;
+}
+}  // namespace internal
+
+/** A thread-safe, lock-free hash map which, unlike ts_hash_map, grows as
+ * needed and accepts any number of elements and hash collisions.
+ *
+ * All elements live in a single lock-free linked list, sorted by the
+ * bit-reversed hash of their keys ("split-ordered list", by Shalev and
+ * Shavit), and the hash table buckets are just shortcuts into that list. This
+ * has several nice properties:
+ *  - find() never locks nor writes to shared memory, so any number of reader
+ *    threads scale without contention.
+ *  - Insertions are done with a single compare-and-swap (CAS) operation.
+ *  - Resizing is incremental: when the average number of elements per bucket
+ *    exceeds a threshold, the number of buckets is doubled with one atomic
+ *    operation, and each new bucket is initialized the first time it is used.
+ *    Elements are never moved nor rehashed, so there are no pauses.
+ *
+ * Elements cannot be erased individually, and the pointers returned by
+ * find(), insert() or operator[] remain valid until clear() or destruction.
+ * Access to the *values* themselves is not synchronized by this class: if
+ * several threads modify the same value, use atomic values (e.g.
+ * `concurrent_hash_map<std::string, std::atomic<int>>`) or your own locks.
+ *
+ * Usage example:
+ * \code
+ * mrpt::containers::concurrent_hash_map<std::string, double> m;
+ *
+ * // Any thread:
+ * m.insert("x", 1.0);
+ * if (const double* v = m.find("x"); v) { ... }
+ * \endcode
+ *
+ * \note clear(), move and destruction are not thread-safe.
+ * \sa ts_hash_map
+ * \note Defined in #include <mrpt/containers/concurrent_hash_map.h>
+ * \note (New in MRPT 2.4.9)
+ * \ingroup mrpt_containers_grp
+ */
+template <typename KEY, typename VALUE, typename HASH = std::hash<KEY>>
+class concurrent_hash_map
+{
+   public:
+	using key_type = KEY;
+	using mapped_type = VALUE;
+	using value_type = std::pair<const KEY, VALUE>;
+
+	/** Maximum average number of elements per bucket before doubling the
+	 * number of buckets */
+	static constexpr std::size_t MAX_LOAD_FACTOR = 2;
+
+	concurrent_hash_map() { init_head(); }
+	~concurrent_hash_map() { free_all(); }
+
+	concurrent_hash_map(const concurrent_hash_map&) = delete;
+	concurrent_hash_map& operator=(const concurrent_hash_map&) = delete;
+
+	/** Returns a pointer to the value for `key`, or nullptr if not found. */
+	VALUE* find(const KEY& key)
+	{
+		const uint64_t h = hash_of(key);
+		node* n = find_in_list(existing_bucket_for(h), regular_key(h), key);
+		return n ? &n->kv.second : nullptr;
+	}
+	const VALUE* find(const KEY& key) const
+	{
+		const uint64_t h = hash_of(key);
+		node* n = find_in_list(existing_bucket_for(h), regular_key(h), key);
+		return n ? &n->kv.second : nullptr;
+	}
+	bool contains(const KEY& key) const { return find(key) != nullptr; }
+
+	/** Inserts a new element, constructing its value from `args` only if
+	 * `key` does not exist yet.
+	 * \return A pointer to the value for `key` and whether it was inserted.
+	 */
+	template <typename... Args>
+	std::pair<VALUE*, bool> try_emplace(const KEY& key, Args&&... args)
+	{
+		const uint64_t h = hash_of(key);
+		node_base* start = bucket_for(h);
+		const uint64_t soKey = regular_key(h);
+		if (node* n = find_in_list(start, soKey, key); n)
+			return {&n->kv.second, false};
+
+		node* newNode = new node(soKey, key, std::forward<Args>(args)...);
+		node_base* r = insert_in_list(start, newNode);
+		if (r != newNode)
+		{
+			// Another thread inserted the same key in the meanwhile:
+			delete newNode;
+			return {&static_cast<node*>(r)->kv.second, false};
+		}
+		grow_if_needed(m_size.fetch_add(1, std::memory_order_relaxed) + 1);
+		return {&newNode->kv.second, true};
+	}
+
+	/** Inserts a copy of `value` for `key` if it did not exist yet.
+	 * \return A pointer to the value for `key` and whether it was inserted.
+	 */
+	std::pair<VALUE*, bool> insert(const KEY& key, const VALUE& value)
+	{
+		return try_emplace(key, value);
+	}
+
+	/** Returns the value for `key`, default-constructing it if it did not
+	 * exist yet. */
+	VALUE& operator[](const KEY& key) { return *try_emplace(key).first; }
+
+	/** Number of elements. */
+	std::size_t size() const { return m_size.load(std::memory_order_relaxed); }
+	bool empty() const { return size() == 0; }
+
+	/** Current number of hash buckets (always a power of two). */
+	std::size_t bucket_count() const
+	{
+		return m_bucketCount.load(std::memory_order_relaxed);
+	}
+
+	/** Invokes `f(const KEY&, VALUE&)` for each element. It is safe to run
+	 * concurrently with insertions, although elements inserted while this
+	 * runs may be visited or not. */
+	template <typename FUNCTOR>
+	void for_each(FUNCTOR&& f)
+	{
+		for (node_base* n = head(); n;
+			 n = n->next.load(std::memory_order_acquire))
+		{
+			if (!is_regular(n->soKey)) continue;
+			auto& kv = static_cast<node*>(n)->kv;
+			f(kv.first, kv.second);
+		}
+	}
+
+	/** Removes all elements. \note Not thread-safe. */
+	void clear()
+	{
+		free_all();
+		m_size = 0;
+		m_bucketCount = FIRST_SEGMENT_LEN;
+		init_head();
+	}
+
+   private:
+	struct node_base
+	{
+		/** Sort key: bit-reversed hash. Odd for elements, even for the
+		 * bucket placeholder nodes. */
+		uint64_t soKey = 0;
+		std::atomic<node_base*> next{nullptr};
+	};
+	struct node : public node_base
+	{
+		template <typename... Args>
+		node(uint64_t k, const KEY& key, Args&&... args)
+			: kv(std::piecewise_construct, std::forward_as_tuple(key),
+				 std::forward_as_tuple(std::forward<Args>(args)...))
+		{
+			node_base::soKey = k;
+		}
+		value_type kv;
+	};
+
+	enum bucket_state_t : uint8_t
+	{
+		UNUSED = 0,
+		INITIALIZING,
+		READY
+	};
+	/** The placeholder nodes are stored in the buckets themselves, saving
+	 * one pointer indirection per lookup. */
+	struct bucket_t
+	{
+		node_base placeholder;
+		std::atomic<uint8_t> state{UNUSED};
+	};
+
+	// Buckets are stored in segments which are never reallocated: segment
+	// #0 holds FIRST_SEGMENT_LEN buckets, and segment #i>0 holds buckets
+	// [2^(i+FIRST_SEGMENT_BITS-1), 2^(i+FIRST_SEGMENT_BITS)).
+	static constexpr unsigned int FIRST_SEGMENT_BITS = 6;
+	static constexpr std::size_t FIRST_SEGMENT_LEN = 1U << FIRST_SEGMENT_BITS;
+	static constexpr unsigned int NUM_SEGMENTS = 64 - FIRST_SEGMENT_BITS;
+
+	std::array<std::atomic<bucket_t*>, NUM_SEGMENTS> m_segments{};
+	std::atomic<std::size_t> m_bucketCount{FIRST_SEGMENT_LEN};
+	std::atomic<std::size_t> m_size{0};
+
+	static bool is_regular(uint64_t soKey) { return (soKey & 1) != 0; }
+	static uint64_t regular_key(uint64_t h)
+	{
+		return internal::reverse_bits_u64(h) | 1;
+	}
+	static uint64_t hash_of(const KEY& key)
+	{
+		// Mix the bits, since many std::hash<> are the identity function:
+		uint64_t z = static_cast<uint64_t>(HASH()(key)) + 0x9E3779B97F4A7C15ULL;
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		return z ^ (z >> 31);
+	}
+
+	/** Bucket #0 always exists, as the head of the list */
+	void init_head()
+	{
+		segment(0)[0].state.store(READY, std::memory_order_release);
+	}
+	node_base* head() const
+	{
+		return &m_segments[0].load(std::memory_order_acquire)[0].placeholder;
+	}
+
+	/** Returns the segment #i, allocating it if needed */
+	bucket_t* segment(unsigned int i)
+	{
+		bucket_t* s = m_segments[i].load(std::memory_order_acquire);
+		if (s) return s;
+		const std::size_t len =
+			i == 0 ? FIRST_SEGMENT_LEN
+				   : (std::size_t(1) << (i + FIRST_SEGMENT_BITS - 1));
+		bucket_t* newSeg = new bucket_t[len];
+		if (m_segments[i].compare_exchange_strong(
+				s, newSeg, std::memory_order_acq_rel,
+				std::memory_order_acquire))
+			return newSeg;
+		delete[] newSeg;
+		return s;
+	}
+
+	static unsigned int segment_of(std::size_t b, std::size_t& idx)
+	{
+		if (b < FIRST_SEGMENT_LEN)
+		{
+			idx = b;
+			return 0;
+		}
+		const unsigned int hb = internal::highest_bit_u64(b);
+		idx = b - (std::size_t(1) << hb);
+		return hb - FIRST_SEGMENT_BITS + 1;
+	}
+
+	static std::size_t parent_bucket(std::size_t b)
+	{
+		return b & ~(std::size_t(1) << internal::highest_bit_u64(b));
+	}
+
+	/** Returns the placeholder node of the bucket for hash `h`,
+	 * initializing it if needed. */
+	node_base* bucket_for(uint64_t h)
+	{
+		return get_bucket(
+			h & (m_bucketCount.load(std::memory_order_acquire) - 1));
+	}
+
+	/** Like bucket_for(), but without initializing any bucket: if it was
+	 * not used yet, the search starts at its closest initialized parent. */
+	node_base* existing_bucket_for(uint64_t h) const
+	{
+		std::size_t b = h & (m_bucketCount.load(std::memory_order_acquire) - 1);
+		for (;;)
+		{
+			std::size_t idx;
+			const unsigned int iSeg = segment_of(b, idx);
+			bucket_t* s = m_segments[iSeg].load(std::memory_order_acquire);
+			if (s && s[idx].state.load(std::memory_order_acquire) == READY)
+				return &s[idx].placeholder;
+			b = parent_bucket(b);  // (bucket #0 always exists)
+		}
+	}
+
+	/** Returns the placeholder of bucket `b`, or that of one of its parents
+	 * if another thread is initializing it right now. */
+	node_base* get_bucket(std::size_t b)
+	{
+		std::size_t idx;
+		bucket_t& bkt = segment(segment_of(b, idx))[idx];
+		if (bkt.state.load(std::memory_order_acquire) == READY)
+			return &bkt.placeholder;
+
+		// Its "parent" bucket (its index without the highest bit) holds all
+		// the elements of this one, until split by inserting its placeholder:
+		node_base* parent = get_bucket(parent_bucket(b));
+		uint8_t st = UNUSED;
+		if (!bkt.state.compare_exchange_strong(
+				st, INITIALIZING, std::memory_order_acquire,
+				std::memory_order_acquire))
+			return st == READY ? &bkt.placeholder : parent;
+
+		bkt.placeholder.soKey = internal::reverse_bits_u64(b);
+		insert_in_list(parent, &bkt.placeholder);
+		bkt.state.store(READY, std::memory_order_release);
+		return &bkt.placeholder;
+	}
+
+	node* find_in_list(node_base* start, uint64_t soKey, const KEY& key) const
+	{
+		node_base* n = start->next.load(std::memory_order_acquire);
+		while (n && n->soKey < soKey)
+			n = n->next.load(std::memory_order_acquire);
+		for (; n && n->soKey == soKey;
+			 n = n->next.load(std::memory_order_acquire))
+			if (static_cast<node*>(n)->kv.first == key)
+				return static_cast<node*>(n);
+		return nullptr;
+	}
+
+	/** Inserts `newNode` after `start`, keeping the list sorted.
+	 * \return `newNode`, or the existing element with the same key. */
+	node_base* insert_in_list(node_base* start, node_base* newNode)
+	{
+		const uint64_t soKey = newNode->soKey;
+		for (;;)
+		{
+			node_base* prev = start;
+			node_base* curr = prev->next.load(std::memory_order_acquire);
+			while (curr && curr->soKey < soKey)
+			{
+				prev = curr;
+				curr = curr->next.load(std::memory_order_acquire);
+			}
+			for (; curr && curr->soKey == soKey;
+				 curr = curr->next.load(std::memory_order_acquire))
+			{
+				if (static_cast<node*>(curr)->kv.first ==
+					static_cast<node*>(newNode)->kv.first)
+					return curr;
+				prev = curr;
+			}
+			// Nodes are never removed, so if prev->next is still curr,
+			// this is the right place:
+			newNode->next.store(curr, std::memory_order_relaxed);
+			if (prev->next.compare_exchange_weak(
+					curr, newNode, std::memory_order_release,
+					std::memory_order_relaxed))
+				return newNode;
+		}
+	}
+
+	void grow_if_needed(std::size_t newSize)
+	{
+		std::size_t bc = m_bucketCount.load(std::memory_order_relaxed);
+		if (newSize > bc * MAX_LOAD_FACTOR &&
+			bc < (std::size_t(1) << (sizeof(std::size_t) * 8 - 2)))
+			m_bucketCount.compare_exchange_strong(
+				bc, bc * 2, std::memory_order_release,
+				std::memory_order_relaxed);
+	}
+
+	void free_all()
+	{
+		if (bucket_t* s0 = m_segments[0].load(std::memory_order_relaxed); s0)
+		{
+			node_base* n = &s0[0].placeholder;
+			while (n)
+			{
+				node_base* next = n->next.load(std::memory_order_relaxed);
+				if (is_regular(n->soKey)) delete static_cast<node*>(n);
+				n = next;
+			}
+		}
+		for (auto& s : m_segments)
+			delete[] s.exchange(nullptr, std::memory_order_relaxed);
+	}
+};
+
+}  // namespace mrpt::containers
@@ -0,0 +1,313 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mrpt::containers
+{
+// Storage layouts (the order of cells in memory) for CDynamicGrid and
+// CDynamicGrid3D, given as their `LAYOUT` template argument. Layouts hold the
+// grid size, and provide the storage size and the conversions between cell
+// indices and storage indices.
+
+namespace internal
+{
+/** Spread the lowest 16 bits of `v` to the even bits of the result */
+constexpr uint32_t morton_part1by1(uint32_t v)
+{
+	v &= 0x0000ffff;
+	v = (v | (v << 8)) & 0x00ff00ff;
+	v = (v | (v << 4)) & 0x0f0f0f0f;
+	v = (v | (v << 2)) & 0x33333333;
+	v = (v | (v << 1)) & 0x55555555;
+	return v;
+}
+/** Inverse of morton_part1by1() */
+constexpr uint32_t morton_compact1by1(uint32_t v)
+{
+	v &= 0x55555555;
+	v = (v | (v >> 1)) & 0x33333333;
+	v = (v | (v >> 2)) & 0x0f0f0f0f;
+	v = (v | (v >> 4)) & 0x00ff00ff;
+	v = (v | (v >> 8)) & 0x0000ffff;
+	return v;
+}
+/** Spread the lowest 10 bits of `v` to every third bit of the result */
+constexpr uint32_t morton_part1by2(uint32_t v)
+{
+	v &= 0x000003ff;
+	v = (v | (v << 16)) & 0xff0000ff;
+	v = (v | (v << 8)) & 0x0300f00f;
+	v = (v | (v << 4)) & 0x030c30c3;
+	v = (v | (v << 2)) & 0x09249249;
+	return v;
+}
+/** Inverse of morton_part1by2() */
+constexpr uint32_t morton_compact1by2(uint32_t v)
+{
+	v &= 0x09249249;
+	v = (v | (v >> 2)) & 0x030c30c3;
+	v = (v | (v >> 4)) & 0x0300f00f;
+	v = (v | (v >> 8)) & 0xff0000ff;
+	v = (v | (v >> 16)) & 0x000003ff;
+	return v;
+}
+}  // namespace internal
+
+/** Row-major layout of 2D grid cells: cell (cx,cy) is stored at
+ * `cx + cy * size_x`. The default of CDynamicGrid.
+ * \note (New in MRPT 2.4.9)
+ * \ingroup mrpt_containers_grp */
+struct GridLayoutRowMajor2D
+{
+	static constexpr bool is_row_major = true;
+
+	void setSize(size_t size_x, size_t size_y)
+	{
+		m_size_x = size_x;
+		m_size_y = size_y;
+	}
+	size_t storageSize() const { return m_size_x * m_size_y; }
+
+	/** Storage index of the cell (cx,cy), which must be within the grid */
+	size_t index(size_t cx, size_t cy) const { return cx + cy * m_size_x; }
+	/** Cell of a storage index (inverse of index()) */
+	void cellOf(size_t idx, size_t& cx, size_t& cy) const
+	{
+		cx = idx % m_size_x;
+		cy = idx / m_size_x;
+	}
+
+	/** Calls `fn(idx, cx, cy)` for each cell, in storage order */
+	template <class FN>
+	void forEachCell(FN&& fn) const
+	{
+		size_t idx = 0;
+		for (size_t cy = 0; cy < m_size_y; cy++)
+			for (size_t cx = 0; cx < m_size_x; cx++)
+				fn(idx++, cx, cy);
+	}
+
+   private:
+	size_t m_size_x = 0, m_size_y = 0;
+};
+
+/** Tiled layout of 2D grid cells: square tiles of 2^TILE_BITS cells per
+ * side, stored in row-major order, each one with its cells in Morton order
+ * (Z-order), so the neighbours of a cell in any direction are usually in the
+ * same or a nearby cache line. This speeds up neighbourhood-heavy algorithms
+ * (distance transforms, likelihood fields, Voronoi diagrams...).
+ *
+ * Grid sizes are padded to whole tiles, so the grid storage (and its
+ * begin()/end() range) may hold some unused cells. Code using a grid with
+ * this layout must access its cells through the grid methods (cellByIndex(),
+ * forEachCell(), forEachCellInWindow()...), never by computing storage
+ * indices as `cx + cy * size_x`.
+ *
+ * \tparam TILE_BITS Log2 of the tile side length, in cells (1 to 8).
+ * \sa CDynamicGrid
+ * \note (New in MRPT 2.4.9)
+ * \ingroup mrpt_containers_grp */
+template <unsigned int TILE_BITS = 3>
+struct GridLayoutTiled2D
+{
+	static_assert(TILE_BITS >= 1 && TILE_BITS <= 8, "Invalid TILE_BITS");
+	static constexpr bool is_row_major = false;
+	static constexpr size_t TILE_SIDE = size_t(1) << TILE_BITS;
+	static constexpr size_t TILE_MASK = TILE_SIDE - 1;
+	static constexpr size_t TILE_CELLS = TILE_SIDE * TILE_SIDE;
+
+	void setSize(size_t size_x, size_t size_y)
+	{
+		m_size_x = size_x;
+		m_size_y = size_y;
+		m_tiles_x = (size_x + TILE_MASK) >> TILE_BITS;
+		m_tiles_y = (size_y + TILE_MASK) >> TILE_BITS;
+	}
+	size_t storageSize() const { return m_tiles_x * m_tiles_y * TILE_CELLS; }
+
+	/** Storage index of the cell (cx,cy), which must be within the grid */
+	size_t index(size_t cx, size_t cy) const
+	{
+		const size_t tile = (cx >> TILE_BITS) + (cy >> TILE_BITS) * m_tiles_x;
+		return (tile << (2 * TILE_BITS)) |
+			internal::morton_part1by1(static_cast<uint32_t>(cx & TILE_MASK)) |
+			(internal::morton_part1by1(static_cast<uint32_t>(cy & TILE_MASK))
+			 << 1);
+	}
+	/** Cell of a storage index (inverse of index()) */
+	void cellOf(size_t idx, size_t& cx, size_t& cy) const
+	{
+		const size_t tile = idx >> (2 * TILE_BITS);
+		const auto m = static_cast<uint32_t>(idx & (TILE_CELLS - 1));
+		cx = ((tile % m_tiles_x) << TILE_BITS) |
+			internal::morton_compact1by1(m);
+		cy = ((tile / m_tiles_x) << TILE_BITS) |
+			internal::morton_compact1by1(m >> 1);
+	}
+
+	/** Calls `fn(idx, cx, cy)` for each cell, in storage order (the padding
+	 * cells of the last tiles are skipped) */
+	template <class FN>
+	void forEachCell(FN&& fn) const
+	{
+		for (size_t ty = 0; ty < m_tiles_y; ty++)
+			for (size_t tx = 0; tx < m_tiles_x; tx++)
+			{
+				const size_t first = (tx + ty * m_tiles_x) * TILE_CELLS;
+				for (size_t m = 0; m < TILE_CELLS; m++)
+				{
+					const auto m32 = static_cast<uint32_t>(m);
+					const size_t cx = (tx << TILE_BITS) |
+						internal::morton_compact1by1(m32);
+					const size_t cy = (ty << TILE_BITS) |
+						internal::morton_compact1by1(m32 >> 1);
+					if (cx < m_size_x && cy < m_size_y) fn(first + m, cx, cy);
+				}
+			}
+	}
+
+   private:
+	size_t m_size_x = 0, m_size_y = 0, m_tiles_x = 0, m_tiles_y = 0;
+};
+
+/** Row-major layout of 3D grid voxels: voxel (cx,cy,cz) is stored at
+ * `cx + cy * size_x + cz * size_x * size_y`. The default of CDynamicGrid3D.
+ * \note (New in MRPT 2.4.9)
+ * \ingroup mrpt_containers_grp */
+struct GridLayoutRowMajor3D
+{
+	static constexpr bool is_row_major = true;
+
+	void setSize(size_t size_x, size_t size_y, size_t size_z)
+	{
+		m_size_x = size_x;
+		m_size_y = size_y;
+		m_size_z = size_z;
+		m_size_xy = size_x * size_y;
+	}
+	size_t storageSize() const { return m_size_xy * m_size_z; }
+
+	/** Storage index of a voxel, which must be within the grid */
+	size_t index(size_t cx, size_t cy, size_t cz) const
+	{
+		return cx + cy * m_size_x + cz * m_size_xy;
+	}
+	/** Voxel of a storage index (inverse of index()) */
+	void cellOf(size_t idx, size_t& cx, size_t& cy, size_t& cz) const
+	{
+		cz = idx / m_size_xy;
+		idx -= cz * m_size_xy;
+		cy = idx / m_size_x;
+		cx = idx - cy * m_size_x;
+	}
+
+	/** Calls `fn(idx, cx, cy, cz)` for each voxel, in storage order */
+	template <class FN>
+	void forEachCell(FN&& fn) const
+	{
+		size_t idx = 0;
+		for (size_t cz = 0; cz < m_size_z; cz++)
+			for (size_t cy = 0; cy < m_size_y; cy++)
+				for (size_t cx = 0; cx < m_size_x; cx++)
+					fn(idx++, cx, cy, cz);
+	}
+
+   private:
+	size_t m_size_x = 0, m_size_y = 0, m_size_z = 0, m_size_xy = 0;
+};
+
+/** Tiled layout of 3D grid voxels: cubic bricks of 2^TILE_BITS voxels per
+ * side, stored in row-major order, each one with its voxels in Morton order,
+ * so neighbours along z are as close in memory as those along x (e.g. for
+ * ray casting). The same padding and access rules than GridLayoutTiled2D
+ * apply.
+ * \tparam TILE_BITS Log2 of the brick side length, in voxels (1 to 5).
+ * \sa CDynamicGrid3D
+ * \note (New in MRPT 2.4.9)
+ * \ingroup mrpt_containers_grp */
+template <unsigned int TILE_BITS = 2>
+struct GridLayoutTiled3D
+{
+	static_assert(TILE_BITS >= 1 && TILE_BITS <= 5, "Invalid TILE_BITS");
+	static constexpr bool is_row_major = false;
+	static constexpr size_t TILE_SIDE = size_t(1) << TILE_BITS;
+	static constexpr size_t TILE_MASK = TILE_SIDE - 1;
+	static constexpr size_t TILE_CELLS = TILE_SIDE * TILE_SIDE * TILE_SIDE;
+
+	void setSize(size_t size_x, size_t size_y, size_t size_z)
+	{
+		m_size_x = size_x;
+		m_size_y = size_y;
+		m_size_z = size_z;
+		m_tiles_x = (size_x + TILE_MASK) >> TILE_BITS;
+		m_tiles_y = (size_y + TILE_MASK) >> TILE_BITS;
+		m_tiles_z = (size_z + TILE_MASK) >> TILE_BITS;
+	}
+	size_t storageSize() const
+	{
+		return m_tiles_x * m_tiles_y * m_tiles_z * TILE_CELLS;
+	}
+
+	/** Storage index of a voxel, which must be within the grid */
+	size_t index(size_t cx, size_t cy, size_t cz) const
+	{
+		const size_t tile = (cx >> TILE_BITS) +
+			((cy >> TILE_BITS) + (cz >> TILE_BITS) * m_tiles_y) * m_tiles_x;
+		return (tile << (3 * TILE_BITS)) |
+			internal::morton_part1by2(static_cast<uint32_t>(cx & TILE_MASK)) |
+			(internal::morton_part1by2(static_cast<uint32_t>(cy & TILE_MASK))
+			 << 1) |
+			(internal::morton_part1by2(static_cast<uint32_t>(cz & TILE_MASK))
+			 << 2);
+	}
+	/** Voxel of a storage index (inverse of index()) */
+	void cellOf(size_t idx, size_t& cx, size_t& cy, size_t& cz) const
+	{
+		size_t tile = idx >> (3 * TILE_BITS);
+		const auto m = static_cast<uint32_t>(idx & (TILE_CELLS - 1));
+		const size_t tx = tile % m_tiles_x;
+		tile /= m_tiles_x;
+		const size_t ty = tile % m_tiles_y, tz = tile / m_tiles_y;
+		cx = (tx << TILE_BITS) | internal::morton_compact1by2(m);
+		cy = (ty << TILE_BITS) | internal::morton_compact1by2(m >> 1);
+		cz = (tz << TILE_BITS) | internal::morton_compact1by2(m >> 2);
+	}
+
+	/** Calls `fn(idx, cx, cy, cz)` for each voxel, in storage order (the
+	 * padding voxels of the last bricks are skipped) */
+	template <class FN>
+	void forEachCell(FN&& fn) const
+	{
+		size_t first = 0;
+		for (size_t tz = 0; tz < m_tiles_z; tz++)
+			for (size_t ty = 0; ty < m_tiles_y; ty++)
+				for (size_t tx = 0; tx < m_tiles_x; tx++, first += TILE_CELLS)
+					for (size_t m = 0; m < TILE_CELLS; m++)
+					{
+						const auto m32 = static_cast<uint32_t>(m);
+						const size_t cx = (tx << TILE_BITS) |
+							internal::morton_compact1by2(m32);
+						const size_t cy = (ty << TILE_BITS) |
+							internal::morton_compact1by2(m32 >> 1);
+						const size_t cz = (tz << TILE_BITS) |
+							internal::morton_compact1by2(m32 >> 2);
+						if (cx < m_size_x && cy < m_size_y && cz < m_size_z)
+							fn(first + m, cx, cy, cz);
+					}
+	}
+
+   private:
+	size_t m_size_x = 0, m_size_y = 0, m_size_z = 0;
+	size_t m_tiles_x = 0, m_tiles_y = 0, m_tiles_z = 0;
+};
+
+}  // namespace mrpt::containers
@@ -0,0 +1,189 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+namespace mrpt::containers
+{
+/** A bounded, lock-free, multiple-producer multiple-consumer (MPMC) queue
+ * implemented as a ring buffer of fixed capacity (defined at construction
+ * time, rounded up to the next power of two).
+ *
+ * Neither push nor pop operations ever block or allocate memory: a push into
+ * a full queue fails (and, for push_or_drop(), it is counted as a dropped
+ * element), and a pop from an empty queue returns false. It is also a valid,
+ * efficient single-producer single-consumer (SPSC) queue.
+ *
+ * Usage example:
+ * \code
+ * mrpt::containers::lockfree_bounded_queue<MyMsgType> q(1024);
+ *
+ * // Thread(s) 1: Write
+ * q.push_or_drop(msg);
+ *
+ * // Thread(s) 2: Read
+ * MyMsgType msg;
+ * while (q.try_pop(msg)) { ... }
+ * \endcode
+ *
+ * \note Based on the bounded MPMC queue algorithm by Dmitry Vyukov:
+ * each cell holds a sequence number that tells producers and consumers
+ * whether the cell is ready to be written or read.
+ * \sa CThreadSafeQueue, circular_buffer
+ * \note Defined in #include <mrpt/containers/lockfree_bounded_queue.h>
+ * \note (New in MRPT 2.4.9)
+ * \ingroup mrpt_containers_grp
+ */
+template <typename T>
+class lockfree_bounded_queue
+{
+   public:
+	using value_type = T;
+
+	/** Creates a queue able to hold at least `capacity` elements. */
+	explicit lockfree_bounded_queue(const std::size_t capacity)
+	{
+		if (capacity < 2) throw std::invalid_argument("capacity must be >=2");
+		std::size_t n = 2;
+		while (n < capacity)
+			n <<= 1;
+		m_mask = n - 1;
+		m_cells = std::make_unique<cell_t[]>(n);
+		for (std::size_t i = 0; i < n; i++)
+			m_cells[i].seq.store(i, std::memory_order_relaxed);
+	}
+
+	lockfree_bounded_queue(const lockfree_bounded_queue&) = delete;
+	lockfree_bounded_queue& operator=(const lockfree_bounded_queue&) = delete;
+
+	/** Inserts an element. \return false if the queue is full. */
+	bool try_push(T&& value)
+	{
+		cell_t* cell;
+		std::size_t pos = m_enqueue_pos.load(std::memory_order_relaxed);
+		for (;;)
+		{
+			cell = &m_cells[pos & m_mask];
+			const std::size_t seq = cell->seq.load(std::memory_order_acquire);
+			const auto dif =
+				static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+			if (dif == 0)
+			{
+				if (m_enqueue_pos.compare_exchange_weak(
+						pos, pos + 1, std::memory_order_relaxed))
+					break;
+			}
+			else if (dif < 0)
+				return false;  // Full
+			else
+				pos = m_enqueue_pos.load(std::memory_order_relaxed);
+		}
+		cell->data = std::move(value);
+		cell->seq.store(pos + 1, std::memory_order_release);
+		return true;
+	}
+
+	/// \overload
+	bool try_push(const T& value)
+	{
+		T copy = value;
+		return try_push(std::move(copy));
+	}
+
+	/** Like try_push(), but increments the dropped elements counter if the
+	 * queue is full. \sa dropped() */
+	bool push_or_drop(T&& value)
+	{
+		if (try_push(std::move(value))) return true;
+		m_dropped.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	/// \overload
+	bool push_or_drop(const T& value)
+	{
+		T copy = value;
+		return push_or_drop(std::move(copy));
+	}
+
+	/** Retrieves the oldest element. \return false if the queue is empty. */
+	bool try_pop(T& out_value)
+	{
+		cell_t* cell;
+		std::size_t pos = m_dequeue_pos.load(std::memory_order_relaxed);
+		for (;;)
+		{
+			cell = &m_cells[pos & m_mask];
+			const std::size_t seq = cell->seq.load(std::memory_order_acquire);
+			const auto dif = static_cast<std::intptr_t>(seq) -
+				static_cast<std::intptr_t>(pos + 1);
+			if (dif == 0)
+			{
+				if (m_dequeue_pos.compare_exchange_weak(
+						pos, pos + 1, std::memory_order_relaxed))
+					break;
+			}
+			else if (dif < 0)
+				return false;  // Empty
+			else
+				pos = m_dequeue_pos.load(std::memory_order_relaxed);
+		}
+		out_value = std::move(cell->data);
+		// Release resources held by the moved-from object now:
+		cell->data = T();
+		cell->seq.store(pos + m_mask + 1, std::memory_order_release);
+		return true;
+	}
+
+	/** Maximum number of elements in the queue. */
+	std::size_t capacity() const { return m_mask + 1; }
+
+	/** Approximate number of elements in the queue (exact only if there are
+	 * no concurrent accesses). */
+	std::size_t size_approx() const
+	{
+		const std::size_t e = m_enqueue_pos.load(std::memory_order_relaxed);
+		const std::size_t d = m_dequeue_pos.load(std::memory_order_relaxed);
+		return e >= d ? e - d : 0;
+	}
+
+	/** Number of elements rejected by push_or_drop() due to a full queue,
+	 * since construction or the last call to reset_dropped(). */
+	uint64_t dropped() const
+	{
+		return m_dropped.load(std::memory_order_relaxed);
+	}
+	void reset_dropped() { m_dropped.store(0, std::memory_order_relaxed); }
+
+   private:
+	static constexpr std::size_t CACHE_LINE = 64;
+
+	struct cell_t
+	{
+		std::atomic<std::size_t> seq{0};
+		T data{};
+	};
+
+	std::unique_ptr<cell_t[]> m_cells;
+	std::size_t m_mask = 0;
+
+	// Producer and consumer positions are kept in different cache lines to
+	// avoid false sharing:
+	alignas(CACHE_LINE) std::atomic<std::size_t> m_enqueue_pos{0};
+	alignas(CACHE_LINE) std::atomic<std::size_t> m_dequeue_pos{0};
+	alignas(CACHE_LINE) std::atomic<uint64_t> m_dropped{0};
+};
+
+}  // namespace mrpt::containers
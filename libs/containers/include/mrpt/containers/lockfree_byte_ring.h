@@ -0,0 +1,270 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+namespace mrpt::containers
+{
+/** A lock-free ring buffer of bytes with a fixed capacity (defined at
+ * construction time, rounded up to the next power of two), for passing
+ * sensor byte streams from a reader thread to a parser thread.
+ *
+ * Written and read data can be accessed in place, without intermediary
+ * copies:
+ *  - The producer gets the free space with prepare_write(), writes into it
+ *    (e.g. directly from a serial port or socket, see
+ *    mrpt::comms::CSerialPort::ReadInto()) and publishes the new data with
+ *    commit_write(). These two methods must only be used from one producer
+ *    thread (SPSC).
+ *  - Alternatively, write() copies a complete block of data, and it is safe
+ *    to call from several producer threads at once (MPSC). Blocks are never
+ *    interleaved.
+ *  - The consumer (only one thread) inspects the data in place with
+ *    peek_contiguous(), peek() or peek_many(), and consumes it with
+ *    discard(), pop() or read().
+ *
+ * Usage example:
+ * \code
+ * mrpt::containers::lockfree_byte_ring ring(0x10000);
+ *
+ * // Thread 1: Write
+ * serialPort.ReadInto(ring);
+ *
+ * // Thread 2: Read
+ * size_t n;
+ * const uint8_t* p = ring.peek_contiguous(n);
+ * const size_t parsed = myParser(p, n);
+ * ring.discard(parsed);
+ * \endcode
+ *
+ * The consumer-side API matches the one of circular_buffer<uint8_t>, so
+ * parsers can be written in terms of either class.
+ *
+ * \note Concurrent write() calls reserve their space with an atomic
+ * compare-and-swap, copy their data in parallel, and then publish it in
+ * reservation order: a producer only waits for earlier producers to finish
+ * copying their blocks.
+ * \sa circular_buffer, lockfree_bounded_queue
+ * \note Defined in #include <mrpt/containers/lockfree_byte_ring.h>
+ * \note (New in MRPT 2.4.9)
+ * \ingroup mrpt_containers_grp
+ */
+class lockfree_byte_ring
+{
+   public:
+	/** Creates a ring able to hold at least `capacity` bytes. */
+	explicit lockfree_byte_ring(const std::size_t capacity)
+	{
+		if (capacity < 2) throw std::invalid_argument("capacity must be >=2");
+		std::size_t n = 2;
+		while (n < capacity)
+			n <<= 1;
+		m_mask = n - 1;
+		m_data = std::make_unique<uint8_t[]>(n);
+	}
+
+	lockfree_byte_ring(const lockfree_byte_ring&) = delete;
+	lockfree_byte_ring& operator=(const lockfree_byte_ring&) = delete;
+
+	/** @name Producer side
+	 *  @{ */
+
+	/** Returns a pointer to the free space where the producer may write and,
+	 * in `count`, the number of bytes which can be written there, up to the
+	 * end of the internal storage. `count` may be less than available() if
+	 * the free space wraps around it; call again after commit_write() to get
+	 * the rest. Single producer only.
+	 * \sa commit_write */
+	uint8_t* prepare_write(std::size_t& count)
+	{
+		const std::size_t w = m_write.load(std::memory_order_relaxed);
+		const std::size_t r = m_read.load(std::memory_order_acquire);
+		const std::size_t offset = w & m_mask;
+		count = std::min(capacity() - (w - r), capacity() - offset);
+		return m_data.get() + offset;
+	}
+
+	/** Publishes `count` bytes written into the space returned by
+	 * prepare_write(). Single producer only.
+	 * \exception std::out_of_range If `count` is larger than the space
+	 * returned by prepare_write(). */
+	void commit_write(std::size_t count)
+	{
+		const std::size_t w = m_write.load(std::memory_order_relaxed);
+		const std::size_t r = m_read.load(std::memory_order_acquire);
+		if (count > capacity() - (w - r) || count > capacity() - (w & m_mask))
+			throw std::out_of_range("commit_write: count out of range");
+		m_reserve.store(w + count, std::memory_order_relaxed);
+		m_write.store(w + count, std::memory_order_release);
+	}
+
+	/** Copies a block of data into the ring, only if there is space for all
+	 * of it. Safe to call from several threads at once (but not at the same
+	 * time as prepare_write() and commit_write()).
+	 * \return false if there was not enough free space. */
+	bool write(const void* data, std::size_t count)
+	{
+		std::size_t start = m_reserve.load(std::memory_order_relaxed);
+		do
+		{
+			const std::size_t r = m_read.load(std::memory_order_acquire);
+			if (count > capacity() - (start - r)) return false;  // Full
+		} while (!m_reserve.compare_exchange_weak(
+			start, start + count, std::memory_order_relaxed));
+
+		const std::size_t offset = start & m_mask;
+		const std::size_t n1 = std::min(count, capacity() - offset);
+		const auto* src = static_cast<const uint8_t*>(data);
+		std::memcpy(m_data.get() + offset, src, n1);
+		std::memcpy(m_data.get(), src + n1, count - n1);
+
+		// Publish in reservation order:
+		while (m_write.load(std::memory_order_acquire) != start)
+			std::this_thread::yield();
+		m_write.store(start + count, std::memory_order_release);
+		return true;
+	}
+
+	/** Like write(), but adds `count` to the dropped bytes counter if there
+	 * is not enough free space. \sa dropped() */
+	bool write_or_drop(const void* data, std::size_t count)
+	{
+		if (write(data, count)) return true;
+		m_dropped.fetch_add(count, std::memory_order_relaxed);
+		return false;
+	}
+
+	/** @} */
+
+	/** @name Consumer side
+	 *  @{ */
+
+	/** Returns a pointer to the next byte to be read and, in `count`, the
+	 * number of bytes which can be read from it, up to the end of the internal
+	 * storage. It may be less than size() if the data wraps around it. The
+	 * pointer is valid until the next discard(), pop() or read(). */
+	const uint8_t* peek_contiguous(std::size_t& count) const
+	{
+		const std::size_t r = m_read.load(std::memory_order_relaxed);
+		const std::size_t w = m_write.load(std::memory_order_acquire);
+		const std::size_t offset = r & m_mask;
+		count = std::min(w - r, capacity() - offset);
+		return m_data.get() + offset;
+	}
+
+	/** Returns the byte at position `index` from the next one to be read,
+	 * without removing it.
+	 * \exception std::out_of_range If `index>=size()`. */
+	uint8_t peek(std::size_t index = 0) const
+	{
+		if (index >= size()) throw std::out_of_range("peek: out of range");
+		const std::size_t r = m_read.load(std::memory_order_relaxed);
+		return m_data[(r + index) & m_mask];
+	}
+
+	/** Copies the next `count` bytes into a user-provided array, without
+	 * removing them.
+	 * \exception std::out_of_range If there are less bytes than requested. */
+	void peek_many(uint8_t* out_array, std::size_t count) const
+	{
+		if (count > size())
+			throw std::out_of_range("peek_many: not enough data");
+		const std::size_t offset = m_read.load(std::memory_order_relaxed) &
+			m_mask;
+		const std::size_t n1 = std::min(count, capacity() - offset);
+		std::memcpy(out_array, m_data.get() + offset, n1);
+		std::memcpy(out_array + n1, m_data.get(), count - n1);
+	}
+
+	/** Removes the next `count` bytes, without reading them.
+	 * \exception std::out_of_range If there are less bytes than requested. */
+	void discard(std::size_t count)
+	{
+		if (count > size())
+			throw std::out_of_range("discard: not enough data");
+		m_read.fetch_add(count, std::memory_order_release);
+	}
+
+	/** Retrieves the next byte.
+	 * \exception std::out_of_range If the ring is empty. */
+	uint8_t pop()
+	{
+		const uint8_t b = peek();
+		discard(1);
+		return b;
+	}
+
+	/** Retrieves up to `max_count` bytes into a user-provided array.
+	 * \return The number of bytes read. */
+	std::size_t read(uint8_t* out_array, std::size_t max_count)
+	{
+		const std::size_t n = std::min(max_count, size());
+		peek_many(out_array, n);
+		discard(n);
+		return n;
+	}
+
+	/** Removes all the data published so far. */
+	void clear() { discard(size()); }
+
+	/** @} */
+
+	/** Number of bytes available for reading. */
+	std::size_t size() const
+	{
+		const std::size_t r = m_read.load(std::memory_order_relaxed);
+		return m_write.load(std::memory_order_acquire) - r;
+	}
+	bool empty() const { return size() == 0; }
+
+	/** Maximum number of bytes in the ring. */
+	std::size_t capacity() const { return m_mask + 1; }
+
+	/** Number of bytes which can be written right now (exact only if there
+	 * are no concurrent accesses). */
+	std::size_t available() const
+	{
+		const std::size_t w = m_reserve.load(std::memory_order_relaxed);
+		return capacity() - (w - m_read.load(std::memory_order_acquire));
+	}
+
+	/** Number of bytes rejected by write_or_drop() due to a full ring, since
+	 * construction or the last call to reset_dropped(). */
+	uint64_t dropped() const
+	{
+		return m_dropped.load(std::memory_order_relaxed);
+	}
+	void reset_dropped() { m_dropped.store(0, std::memory_order_relaxed); }
+
+   private:
+	static constexpr std::size_t CACHE_LINE = 64;
+
+	std::unique_ptr<uint8_t[]> m_data;
+	std::size_t m_mask = 0;
+
+	// Positions grow monotonically (modulo 2^N) and are masked to index the
+	// storage. They are kept in different cache lines to avoid false sharing:
+	/** End of the space reserved by producers */
+	alignas(CACHE_LINE) std::atomic<std::size_t> m_reserve{0};
+	/** End of the data published to the consumer */
+	alignas(CACHE_LINE) std::atomic<std::size_t> m_write{0};
+	/** Next byte to read */
+	alignas(CACHE_LINE) std::atomic<std::size_t> m_read{0};
+	alignas(CACHE_LINE) std::atomic<uint64_t> m_dropped{0};
+};
+
+}  // namespace mrpt::containers
@@ -10,6 +10,7 @@
 
 #include <mrpt/containers/ValueCommentPair.h>
 #include <mrpt/containers/YamlEmitOptions.h>
+#include <mrpt/containers/YamlParseOptions.h>
 #include <mrpt/containers/internal_yaml_fwrds.h>
 #include <mrpt/core/bits_math.h>  // mrpt::RAD2DEG
 #include <mrpt/core/demangle.h>
@@ -184,10 +185,11 @@ class yaml
 		const std::string_view internalAsStr() const
 		{
 			ASSERT_(isScalar());
-			if (const char* const* s = std::any_cast<const char*>(&asScalar());
+			// Parsed documents only have std::string keys, check them first:
+			if (const std::string* s = std::any_cast<std::string>(&asScalar());
 				s != nullptr)
 			{ return {*s}; }
-			if (const std::string* s = std::any_cast<std::string>(&asScalar());
+			if (const char* const* s = std::any_cast<const char*>(&asScalar());
 				s != nullptr)
 			{ return {*s}; }
 			if (const std::string_view* s =
@@ -281,39 +283,46 @@ class yaml
 	/** Parses a text as YAML or JSON (autodetected) and returns a document.
 	 * \exception std::exception Upon format errors
 	 */
-	static yaml FromText(const std::string& yamlTextBlock);
+	static yaml FromText(
+		const std::string& yamlTextBlock, const YamlParseOptions& po = {});
 
 	/** Parses a text as YAML or JSON (autodetected) and stores the contents
 	 * into this document.
 	 *
+	 * Parsing is faster if comments are not needed, with
+	 * YamlParseOptions::parseComments set to `false`.
+	 *
 	 * \exception std::exception Upon format errors
 	 */
-	void loadFromText(const std::string& yamlTextBlock);
+	void loadFromText(
+		const std::string& yamlTextBlock, const YamlParseOptions& po = {});
 
 	/** Parses the stream as YAML or JSON (autodetected) and returns a document.
 	 * \exception std::exception Upon format errors
 	 */
-	static yaml FromStream(std::istream& i);
+	static yaml FromStream(std::istream& i, const YamlParseOptions& po = {});
 
 	/** Parses a text as YAML or JSON (autodetected) and stores the contents
 	 * into this document.
 	 *
 	 * \exception std::exception Upon I/O or format errors
 	 */
-	void loadFromFile(const std::string& fileName);
+	void loadFromFile(
+		const std::string& fileName, const YamlParseOptions& po = {});
 
 	/** Parses the filename as YAML or JSON (autodetected) and returns a
 	 * document.
 	 * \exception std::exception Upon I/O or format errors.
 	 */
-	static yaml FromFile(const std::string& fileName);
+	static yaml FromFile(
+		const std::string& fileName, const YamlParseOptions& po = {});
 
 	/** Parses the stream as YAML or JSON (autodetected) and stores the contents
 	 * into this document.
 	 *
 	 * \exception std::exception Upon format errors
 	 */
-	void loadFromStream(std::istream& i);
+	void loadFromStream(std::istream& i, const YamlParseOptions& po = {});
 
 	/** Builds an object copying the structure and contents from an existing
 	 * YAMLCPP Node. Requires user to #include yamlcpp from your calling program
@@ -0,0 +1,57 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <CTraitsTest.h>
+#include <gtest/gtest.h>
+#include <mrpt/containers/CDynamicGrid3D.h>
+
+template class mrpt::CTraitsTest<mrpt::containers::CDynamicGrid3D<double>>;
+
+using mrpt::containers::CDynamicGrid3D;
+using tiled_grid3d_t = CDynamicGrid3D<
+	int, double, mrpt::containers::GridLayoutTiled3D<2>>;
+
+TEST(CDynamicGrid3D, tiledLayout)
+{
+	CDynamicGrid3D<int> grid{-1.0, 1.0, -0.5, 0.7, 0, 0.9, 0.1, 0.1};
+	tiled_grid3d_t tiled{-1.0, 1.0, -0.5, 0.7, 0, 0.9, 0.1, 0.1};
+	ASSERT_EQ(grid.getVoxelCount(), tiled.getVoxelCount());
+	EXPECT_EQ(tiled.data().size(), 20U * 12U * 12U);  // padded to 4^3 bricks
+
+	grid.forEachCell([](size_t cx, size_t cy, size_t cz, int& c) {
+		c = static_cast<int>(cx + 100 * cy + 10000 * cz);
+	});
+	size_t count = 0;
+	tiled.forEachCell([&](size_t cx, size_t cy, size_t cz, int& c) {
+		c = *grid.cellByIndex(cx, cy, cz);
+		count++;
+	});
+	EXPECT_EQ(count, grid.getVoxelCount());
+
+	for (int cz = 0; cz < static_cast<int>(grid.getSizeZ()); cz++)
+		for (int cy = 0; cy < static_cast<int>(grid.getSizeY()); cy++)
+			for (int cx = 0; cx < static_cast<int>(grid.getSizeX()); cx++)
+				EXPECT_EQ(
+					*tiled.cellByIndex(cx, cy, cz),
+					*grid.cellByIndex(cx, cy, cz));
+
+	grid.resize(-2, 2, -2, 2, -2, 2, -1, 0);
+	tiled.resize(-2, 2, -2, 2, -2, 2, -1, 0);
+	ASSERT_EQ(grid.getVoxelCount(), tiled.getVoxelCount());
+	grid.forEachCell([&](size_t cx, size_t cy, size_t cz, const int& c) {
+		EXPECT_EQ(*tiled.cellByIndex(cx, cy, cz), c);
+	});
+
+	int n = 0;
+	const auto& ctiled = tiled;
+	ctiled.forEachCellInWindow(0, 5, 5, 1, [&](int, int, int, const int&) {
+		n++;
+	});
+	EXPECT_EQ(n, 2 * 3 * 3);
+}
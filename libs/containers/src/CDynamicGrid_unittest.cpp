@@ -12,6 +12,8 @@
 #include <mrpt/containers/CDynamicGrid.h>
 #include <mrpt/core/common.h>
 
+#include <map>
+
 template class mrpt::CTraitsTest<mrpt::containers::CDynamicGrid<double>>;
 
 using mrpt::containers::CDynamicGrid;
@@ -46,3 +48,50 @@ TEST(CDynamicGrid, rangeForLoop)
 	EXPECT_EQ(counter.at(0), 20 * 20 * 10 * 10 - 1);
 	EXPECT_EQ(counter.at(8), 1);
 }
+
+TEST(CDynamicGrid, tiledLayout)
+{
+	using tiled_grid_t =
+		CDynamicGrid<int, mrpt::containers::GridLayoutTiled2D<3>>;
+	CDynamicGrid<int> grid{-1.0, 2.7, -0.5, 1.4, 0.1};
+	tiled_grid_t tiled{-1.0, 2.7, -0.5, 1.4, 0.1};
+	ASSERT_EQ(grid.getSizeX(), tiled.getSizeX());
+	ASSERT_EQ(grid.getSizeY(), tiled.getSizeY());
+	EXPECT_EQ(tiled.data().size(), 40U * 24U);	// padded to 8x8 tiles
+
+	for (unsigned int cy = 0; cy < grid.getSizeY(); cy++)
+		for (unsigned int cx = 0; cx < grid.getSizeX(); cx++)
+			*grid.cellByIndex(cx, cy) = *tiled.cellByIndex(cx, cy) =
+				static_cast<int>(cx + 1000 * cy);
+
+	// Each cell is visited once, and linear indices are consistent:
+	size_t count = 0;
+	tiled.forEachCell([&](size_t cx, size_t cy, int& c) {
+		EXPECT_EQ(c, static_cast<int>(cx + 1000 * cy));
+		const int idx = tiled.xy2idx(tiled.idx2x(cx), tiled.idx2y(cy));
+		EXPECT_EQ(&tiled.data()[idx], &c);
+		int cx2, cy2;
+		tiled.idx2cxcy(idx, cx2, cy2);
+		EXPECT_EQ(static_cast<size_t>(cx2), cx);
+		EXPECT_EQ(static_cast<size_t>(cy2), cy);
+		count++;
+	});
+	EXPECT_EQ(count, grid.getSizeX() * grid.getSizeY());
+
+	// Resizing keeps the contents, as with the row-major layout:
+	grid.resize(-5.0, 5.0, -3.0, 3.0, -1, 0.0);
+	tiled.resize(-5.0, 5.0, -3.0, 3.0, -1, 0.0);
+	ASSERT_EQ(grid.getSizeX(), tiled.getSizeX());
+	ASSERT_EQ(grid.getSizeY(), tiled.getSizeY());
+	grid.forEachCell([&](size_t cx, size_t cy, const int& c) {
+		EXPECT_EQ(*tiled.cellByIndex(cx, cy), c);
+	});
+
+	int sum = 0, n = 0;
+	tiled.forEachCellInWindow(0, 1, 1, [&](int, int, const int& c) {
+		sum += c;
+		n++;
+	});
+	EXPECT_EQ(n, 6);
+	EXPECT_EQ(sum, -6);
+}
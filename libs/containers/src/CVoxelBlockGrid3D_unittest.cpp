@@ -0,0 +1,66 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/containers/CVoxelBlockGrid3D.h>
+
+#include <map>
+#include <tuple>
+#include <utility>
+
+TEST(CVoxelBlockGrid3D, allocAndRead)
+{
+	mrpt::containers::CVoxelBlockGrid3D<int> g(0.5, -1);
+	EXPECT_EQ(g.getBlockCount(), 0U);
+	EXPECT_EQ(g.cellByIndex(0, 0, 0), nullptr);
+
+	// Negative and large indices, in different blocks:
+	const std::vector<std::tuple<int, int, int>> idxs = {
+		{0, 0, 0}, {-1, -1, -1}, {7, 7, 7}, {8, 0, 0}, {-100000, 5, 300000}};
+	int v = 0;
+	for (const auto& [x, y, z] : idxs)
+		g.cellRefByIndexAlloc(x, y, z) = v++;
+	// (0,0,0) and (7,7,7) share a block:
+	EXPECT_EQ(g.getBlockCount(), idxs.size() - 1);
+
+	v = 0;
+	for (const auto& [x, y, z] : idxs)
+	{
+		const auto* c = std::as_const(g).cellByIndex(x, y, z);
+		ASSERT_TRUE(c != nullptr);
+		EXPECT_EQ(*c, v++);
+	}
+	// Other voxels of allocated blocks have the default value:
+	ASSERT_TRUE(g.cellByIndex(1, 0, 0) != nullptr);
+	EXPECT_EQ(*g.cellByIndex(1, 0, 0), -1);
+
+	EXPECT_EQ(g.x2idx(-0.1), -1);
+	EXPECT_EQ(g.x2idx(0.6), 1);
+
+	// All voxels are visited, with the right indices:
+	std::map<std::tuple<int, int, int>, int> nonDefault;
+	size_t nVisited = 0;
+	g.forEachAllocatedVoxel([&](int x, int y, int z, int val) {
+		nVisited++;
+		if (val != -1) nonDefault[{x, y, z}] = val;
+	});
+	EXPECT_EQ(nVisited, g.getAllocatedVoxelCount());
+	ASSERT_EQ(nonDefault.size(), idxs.size());
+	for (size_t i = 0; i < idxs.size(); i++)
+		EXPECT_EQ(nonDefault[idxs[i]], static_cast<int>(i));
+
+	// Copies are deep:
+	auto g2 = g;
+	g2.cellRefByIndexAlloc(0, 0, 0) = 100;
+	EXPECT_EQ(*g.cellByIndex(0, 0, 0), 0);
+
+	g.clear();
+	EXPECT_EQ(g.getBlockCount(), 0U);
+	EXPECT_EQ(g.cellByIndex(0, 0, 0), nullptr);
+}
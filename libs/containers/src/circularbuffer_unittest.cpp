@@ -169,3 +169,33 @@ TEST(circular_buffer_tests, WritePeekCheck_uint64_t)
 {
 	impl_WritePeekCheck<uint64_t>();
 }
+
+TEST(circular_buffer_tests, PeekContiguousDiscard)
+{
+	mrpt::containers::circular_buffer<cb_t> cb(10);
+	size_t n = 1;
+	cb.peek_contiguous(n);
+	EXPECT_EQ(n, 0U);
+
+	// Make the data wrap around the end of the storage:
+	for (cb_t i = 0; i < 7; i++)
+		cb.push(i);
+	cb.discard(5);
+	EXPECT_EQ(cb.peek(), 5);
+	for (cb_t i = 7; i < 12; i++)
+		cb.push(i);
+	EXPECT_EQ(cb.size(), 7U);
+
+	const cb_t* p = cb.peek_contiguous(n);
+	EXPECT_EQ(n, 5U);
+	for (size_t i = 0; i < n; i++)
+		EXPECT_EQ(p[i], static_cast<cb_t>(5 + i));
+
+	cb.discard(n);
+	p = cb.peek_contiguous(n);
+	EXPECT_EQ(n, 2U);
+	EXPECT_EQ(p[0], 10);
+	EXPECT_EQ(p[1], 11);
+
+	EXPECT_ANY_THROW(cb.discard(3));
+}
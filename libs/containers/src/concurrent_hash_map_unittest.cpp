@@ -0,0 +1,139 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/config.h>
+#include <mrpt/containers/concurrent_hash_map.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(concurrent_hash_map, bitHelpers)
+{
+	using namespace mrpt::containers::internal;
+	EXPECT_EQ(reverse_bits_u64(0), 0U);
+	EXPECT_EQ(reverse_bits_u64(1), 0x8000000000000000ULL);
+	EXPECT_EQ(reverse_bits_u64(0x00000000000000F2ULL), 0x4F00000000000000ULL);
+	EXPECT_EQ(highest_bit_u64(1), 0U);
+	EXPECT_EQ(highest_bit_u64(0x50), 6U);
+	EXPECT_EQ(highest_bit_u64(0x8000000000000001ULL), 63U);
+}
+
+TEST(concurrent_hash_map, singleThread)
+{
+	mrpt::containers::concurrent_hash_map<std::string, double> m;
+	EXPECT_TRUE(m.empty());
+	EXPECT_EQ(m.find("uno"), nullptr);
+
+	EXPECT_TRUE(m.insert("uno", 1.0).second);
+	EXPECT_FALSE(m.insert("uno", 10.0).second);
+	m["dos"] = 2.0;
+	m["tres"] = 3.0;
+	EXPECT_EQ(m.size(), 3U);
+	ASSERT_NE(m.find("uno"), nullptr);
+	EXPECT_EQ(*m.find("uno"), 1.0);
+	EXPECT_EQ(m["dos"], 2.0);
+	EXPECT_TRUE(m.contains("tres"));
+	EXPECT_FALSE(m.contains("cuatro"));
+
+	double sum = 0;
+	m.for_each([&](const std::string&, double& v) { sum += v; });
+	EXPECT_EQ(sum, 6.0);
+
+	m.clear();
+	EXPECT_TRUE(m.empty());
+	EXPECT_FALSE(m.contains("uno"));
+	m["uno"] = 1.0;
+	EXPECT_EQ(m.size(), 1U);
+}
+
+TEST(concurrent_hash_map, growAndCollisions)
+{
+	// A terrible hash function, to check that collisions are handled:
+	struct BadHash
+	{
+		size_t operator()(int i) const { return static_cast<size_t>(i % 7); }
+	};
+	mrpt::containers::concurrent_hash_map<int, int, BadHash> bad;
+	mrpt::containers::concurrent_hash_map<int, int> m;
+	const int N = 20000;
+	for (int i = 0; i < N; i++)
+	{
+		m.insert(i, 2 * i);
+		if (i < 1000) bad.insert(i, 2 * i);
+	}
+	EXPECT_EQ(m.size(), static_cast<size_t>(N));
+	EXPECT_GE(m.bucket_count() * m.MAX_LOAD_FACTOR, static_cast<size_t>(N));
+	for (int i = 0; i < N; i++)
+	{
+		ASSERT_NE(m.find(i), nullptr);
+		EXPECT_EQ(*m.find(i), 2 * i);
+	}
+	EXPECT_EQ(m.find(N), nullptr);
+	EXPECT_EQ(bad.size(), 1000U);
+	for (int i = 0; i < 1000; i++)
+	{
+		ASSERT_NE(bad.find(i), nullptr);
+		EXPECT_EQ(*bad.find(i), 2 * i);
+	}
+
+	// Values are constructed only once, and never moved:
+	mrpt::containers::concurrent_hash_map<int, std::unique_ptr<int>> p;
+	int* ptr = p.try_emplace(1, std::make_unique<int>(5)).first->get();
+	for (int i = 2; i < 1000; i++)
+		p.try_emplace(i);
+	EXPECT_EQ(p.find(1)->get(), ptr);
+}
+
+#if !MRPT_IN_EMSCRIPTEN
+TEST(concurrent_hash_map, multipleThreads)
+{
+	constexpr int NUM_THREADS = 4, NUM_KEYS = 20000;
+
+	mrpt::containers::concurrent_hash_map<int, std::atomic<int>> m;
+	std::atomic_bool readerFailed{false};
+	std::atomic_bool done{false};
+
+	// A reader that checks that keys never disappear while the map grows:
+	std::thread reader([&]() {
+		int maxSeen = -1;
+		while (!done)
+		{
+			for (int k = 0; k <= maxSeen; k++)
+				if (!m.contains(k)) readerFailed = true;
+			while (m.contains(maxSeen + 1))
+				maxSeen++;
+		}
+	});
+
+	// All threads insert the same keys, so they race for each one:
+	std::vector<std::thread> writers;
+	for (int t = 0; t < NUM_THREADS; t++)
+		writers.emplace_back([&]() {
+			for (int k = 0; k < NUM_KEYS; k++)
+				m[k]++;
+		});
+	for (auto& t : writers)
+		t.join();
+	done = true;
+	reader.join();
+
+	EXPECT_FALSE(readerFailed);
+	EXPECT_EQ(m.size(), static_cast<size_t>(NUM_KEYS));
+	size_t count = 0;
+	m.for_each([&](int k, std::atomic<int>& v) {
+		count++;
+		EXPECT_EQ(v.load(), NUM_THREADS) << "k=" << k;
+	});
+	EXPECT_EQ(count, static_cast<size_t>(NUM_KEYS));
+}
+#endif
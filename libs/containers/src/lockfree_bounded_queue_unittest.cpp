@@ -0,0 +1,96 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/config.h>
+#include <mrpt/containers/lockfree_bounded_queue.h>
+
+#include <thread>
+#include <vector>
+
+TEST(lockfree_bounded_queue, PushPopSingleThread)
+{
+	mrpt::containers::lockfree_bounded_queue<int> q(10);
+	EXPECT_EQ(q.capacity(), 16U);
+
+	int v = -1;
+	EXPECT_FALSE(q.try_pop(v));
+
+	for (int i = 0; i < 16; i++)
+		EXPECT_TRUE(q.try_push(i));
+	EXPECT_EQ(q.size_approx(), 16U);
+
+	// Full:
+	EXPECT_FALSE(q.try_push(100));
+	EXPECT_FALSE(q.push_or_drop(101));
+	EXPECT_EQ(q.dropped(), 1U);
+
+	// FIFO order:
+	for (int i = 0; i < 16; i++)
+	{
+		EXPECT_TRUE(q.try_pop(v));
+		EXPECT_EQ(v, i);
+	}
+	EXPECT_FALSE(q.try_pop(v));
+
+	// Wrap around several times:
+	for (int i = 0; i < 100; i++)
+	{
+		EXPECT_TRUE(q.try_push(i));
+		EXPECT_TRUE(q.try_pop(v));
+		EXPECT_EQ(v, i);
+	}
+	EXPECT_EQ(q.size_approx(), 0U);
+}
+
+#if !MRPT_IN_EMSCRIPTEN
+TEST(lockfree_bounded_queue, MultipleProducers)
+{
+	constexpr int NUM_PRODUCERS = 4, NUM_PER_PRODUCER = 20000;
+
+	mrpt::containers::lockfree_bounded_queue<int> q(256);
+
+	std::vector<std::thread> producers;
+	for (int p = 0; p < NUM_PRODUCERS; p++)
+		producers.emplace_back([&q, p]() {
+			for (int i = 0; i < NUM_PER_PRODUCER; i++)
+			{
+				const int v = p * NUM_PER_PRODUCER + i;
+				while (!q.try_push(v))
+					std::this_thread::yield();
+			}
+		});
+
+	// Each value must be received exactly once, and values from one producer
+	// must arrive in order:
+	std::vector<int> lastFromProducer(NUM_PRODUCERS, -1);
+	int received = 0;
+	bool allOk = true;
+	while (received < NUM_PRODUCERS * NUM_PER_PRODUCER)
+	{
+		int v;
+		if (!q.try_pop(v))
+		{
+			std::this_thread::yield();
+			continue;
+		}
+		const int p = v / NUM_PER_PRODUCER, i = v % NUM_PER_PRODUCER;
+		if (i != lastFromProducer.at(p) + 1) allOk = false;
+		lastFromProducer.at(p) = i;
+		received++;
+	}
+	for (auto& t : producers)
+		t.join();
+
+	EXPECT_TRUE(allOk);
+	EXPECT_EQ(q.dropped(), 0U);
+	int v;
+	EXPECT_FALSE(q.try_pop(v));
+}
+#endif
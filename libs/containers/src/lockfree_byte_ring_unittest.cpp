@@ -0,0 +1,185 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/config.h>
+#include <mrpt/containers/lockfree_byte_ring.h>
+
+#include <numeric>
+#include <thread>
+#include <vector>
+
+using mrpt::containers::lockfree_byte_ring;
+
+TEST(lockfree_byte_ring, WriteReadSingleThread)
+{
+	lockfree_byte_ring r(10);
+	EXPECT_EQ(r.capacity(), 16U);
+	EXPECT_TRUE(r.empty());
+	EXPECT_THROW(r.pop(), std::out_of_range);
+
+	std::vector<uint8_t> data(16);
+	std::iota(data.begin(), data.end(), 0);
+	EXPECT_TRUE(r.write(data.data(), 10));
+	EXPECT_EQ(r.size(), 10U);
+	EXPECT_EQ(r.available(), 6U);
+
+	// All or nothing:
+	EXPECT_FALSE(r.write(data.data(), 7));
+	EXPECT_FALSE(r.write_or_drop(data.data(), 7));
+	EXPECT_EQ(r.dropped(), 7U);
+	EXPECT_EQ(r.size(), 10U);
+
+	EXPECT_EQ(r.pop(), 0);
+	EXPECT_EQ(r.peek(0), 1);
+	EXPECT_EQ(r.peek(8), 9);
+	EXPECT_THROW(r.peek(9), std::out_of_range);
+	r.discard(8);
+	EXPECT_EQ(r.size(), 1U);
+
+	// Wrap around the end of the storage:
+	EXPECT_TRUE(r.write(data.data(), 12));
+	size_t n;
+	const uint8_t* p = r.peek_contiguous(n);
+	EXPECT_EQ(n, 7U);
+	EXPECT_EQ(p[0], 9);
+	EXPECT_EQ(p[1], 0);
+
+	std::vector<uint8_t> out(13);
+	EXPECT_THROW(r.peek_many(out.data(), 14), std::out_of_range);
+	EXPECT_EQ(r.read(out.data(), 100), 13U);
+	EXPECT_EQ(out[0], 9);
+	for (size_t i = 0; i < 12; i++)
+		EXPECT_EQ(out[i + 1], i);
+	EXPECT_TRUE(r.empty());
+}
+
+TEST(lockfree_byte_ring, PrepareCommit)
+{
+	lockfree_byte_ring r(16);
+	std::vector<uint8_t> tmp(12);
+	EXPECT_TRUE(r.write(tmp.data(), 12));
+	r.discard(12);
+
+	// The free space is split in two spans:
+	size_t n;
+	uint8_t* p = r.prepare_write(n);
+	ASSERT_EQ(n, 4U);
+	for (size_t i = 0; i < n; i++)
+		p[i] = static_cast<uint8_t>(i);
+	EXPECT_THROW(r.commit_write(5), std::out_of_range);
+	r.commit_write(n);
+
+	p = r.prepare_write(n);
+	ASSERT_EQ(n, 12U);
+	p[0] = 4;
+	r.commit_write(1);
+	EXPECT_EQ(r.size(), 5U);
+
+	for (int i = 0; i < 5; i++)
+		EXPECT_EQ(r.pop(), i);
+
+	r.clear();
+	EXPECT_TRUE(r.empty());
+	EXPECT_EQ(r.available(), 16U);
+}
+
+#if !MRPT_IN_EMSCRIPTEN
+TEST(lockfree_byte_ring, SingleProducerInPlace)
+{
+	constexpr size_t TOTAL = 200000;
+	lockfree_byte_ring r(256);
+
+	std::thread producer([&r]() {
+		size_t written = 0;
+		while (written < TOTAL)
+		{
+			size_t n;
+			uint8_t* p = r.prepare_write(n);
+			n = std::min(n, TOTAL - written);
+			for (size_t i = 0; i < n; i++)
+				p[i] = static_cast<uint8_t>(written + i);
+			r.commit_write(n);
+			written += n;
+			if (!n) std::this_thread::yield();
+		}
+	});
+
+	size_t received = 0;
+	bool allOk = true;
+	while (received < TOTAL)
+	{
+		size_t n;
+		const uint8_t* p = r.peek_contiguous(n);
+		for (size_t i = 0; i < n; i++)
+			if (p[i] != static_cast<uint8_t>(received + i)) allOk = false;
+		r.discard(n);
+		received += n;
+		if (!n) std::this_thread::yield();
+	}
+	producer.join();
+	EXPECT_TRUE(allOk);
+	EXPECT_TRUE(r.empty());
+}
+
+TEST(lockfree_byte_ring, MultipleProducers)
+{
+	// Each producer writes blocks of BLOCK bytes, all equal to (p, seqNum):
+	constexpr int NUM_PRODUCERS = 4, NUM_PER_PRODUCER = 5000;
+	constexpr size_t BLOCK = 6;
+	lockfree_byte_ring r(128);
+
+	std::vector<std::thread> producers;
+	for (int p = 0; p < NUM_PRODUCERS; p++)
+		producers.emplace_back([&r, p]() {
+			for (int i = 0; i < NUM_PER_PRODUCER; i++)
+			{
+				uint8_t blk[BLOCK];
+				blk[0] = static_cast<uint8_t>(p);
+				for (size_t k = 1; k < BLOCK; k++)
+					blk[k] = static_cast<uint8_t>(i);
+				while (!r.write(blk, BLOCK))
+					std::this_thread::yield();
+			}
+		});
+
+	// Blocks must not be interleaved, and those from one producer must
+	// arrive in order:
+	std::vector<int> lastFromProducer(NUM_PRODUCERS, -1);
+	int received = 0;
+	bool allOk = true;
+	while (received < NUM_PRODUCERS * NUM_PER_PRODUCER)
+	{
+		if (r.size() < BLOCK)
+		{
+			std::this_thread::yield();
+			continue;
+		}
+		uint8_t blk[BLOCK];
+		r.read(blk, BLOCK);
+		const int p = blk[0];
+		if (p >= NUM_PRODUCERS)
+		{
+			allOk = false;
+			break;
+		}
+		const auto expected =
+			static_cast<uint8_t>(lastFromProducer.at(p) + 1);
+		for (size_t k = 1; k < BLOCK; k++)
+			if (blk[k] != expected) allOk = false;
+		lastFromProducer.at(p)++;
+		received++;
+	}
+	for (auto& t : producers)
+		t.join();
+
+	EXPECT_TRUE(allOk);
+	EXPECT_TRUE(r.empty());
+}
+#endif
@@ -754,17 +754,18 @@ bool yaml::internalPrintAsYAML(
 		return false;  // \n not emitted
 }
 
-yaml yaml::FromText(const std::string& yamlTextBlock)
+yaml yaml::FromText(
+	const std::string& yamlTextBlock, const YamlParseOptions& po)
 {
 	MRPT_START
 	yaml doc;
-	doc.loadFromText(yamlTextBlock);
+	doc.loadFromText(yamlTextBlock, po);
 	return doc;
 	MRPT_END
 }
 
 // TODO: Allow users to add custom filters?
-static yaml::scalar_t textToScalar(const std::string& s)
+static yaml::scalar_t textToScalar(std::string&& s)
 {
 	// tag:yaml.org,2002:null
 	// https://yaml.org/spec/1.2/spec.html#id2803362
@@ -772,12 +773,10 @@ static yaml::scalar_t textToScalar(const std::string& s)
 
 	// TODO: Try to parse to int or double?
 
-	return {s};
+	return {std::move(s)};
 }
 
 #if MRPT_HAS_FYAML
-static std::optional<yaml::node_t> recursiveParse(struct fy_parser* p);
-
 static bool MRPT_YAML_PARSER_VERBOSE =
 	mrpt::get_env<bool>("MRPT_YAML_PARSER_VERBOSE", false);
 
@@ -824,163 +823,137 @@ static void parseTokenComments(struct fy_token* tk, yaml::node_t& n)
 	}
 }
 
-static std::optional<yaml::node_t> recursiveParse(struct fy_parser* p)
+// Parses the next node directly into `out`, to avoid moving whole subtrees
+// around. Returns false at the end of a map or sequence (or the stream).
+static bool recursiveParse(
+	struct fy_parser* p, yaml::node_t& out, const YamlParseOptions& po)
 {
 	MRPT_START
 
-	struct fy_event* event = fy_parser_parse(p);
-	if (!event) return {};
-
-	// process event:
-	switch (event->type)
+	for (;;)
 	{
-		case FYET_NONE:
-		{
-			PARSER_DBG_OUT("Event: None");
-			fy_parser_event_free(p, event);	 // free event
-			return recursiveParse(p);  // Keep going
-		}
-		break;
-		case FYET_STREAM_START:
-		{
-			PARSER_DBG_OUT("Event: Stream start");
-			fy_parser_event_free(p, event);	 // free event
-			return recursiveParse(p);  // Keep going
-		}
-		break;
-		case FYET_STREAM_END:
-		{
-			PARSER_DBG_OUT("Event: Stream end");
-			fy_parser_event_free(p, event);	 // free event
-			return recursiveParse(p);  // Keep going
-		}
-		break;
-		case FYET_DOCUMENT_START:
-		{
-			PARSER_DBG_OUT("Event: Doc start");
-			fy_parser_event_free(p, event);	 // free event
-			return recursiveParse(p);  // Keep going
-		}
-		break;
-		case FYET_DOCUMENT_END:
-		{
-			PARSER_DBG_OUT("Event: Doc end");
-			fy_parser_event_free(p, event);	 // free event
-			return recursiveParse(p);  // Keep going
-		}
-		break;
-		case FYET_MAPPING_START:
-		{
-			PARSER_DBG_OUT("Event: MAP START");
-			fy_parser_event_free(p, event);	 // free event
-
-			yaml::node_t n;
-			yaml::map_t& m = n.d.emplace<yaml::map_t>();
-
-			parseTokenComments(event->scalar.value, n);
+		struct fy_event* event = fy_parser_parse(p);
+		if (!event) return false;
 
-			for (;;)
+		// process event:
+		switch (event->type)
+		{
+			case FYET_NONE:
+			case FYET_STREAM_START:
+			case FYET_STREAM_END:
+			case FYET_DOCUMENT_START:
+			case FYET_DOCUMENT_END:
+			case FYET_ALIAS:
+			{
+				PARSER_DBG_OUT("Event: " << static_cast<int>(event->type));
+				fy_parser_event_free(p, event);	 // free event
+				continue;  // Keep going
+			}
+			case FYET_MAPPING_START:
 			{
-				// Next event is map key:
-				auto nKey = recursiveParse(p);
-				// end of map reached?
-				if (!nKey.has_value()) break;
+				PARSER_DBG_OUT("Event: MAP START");
+				out = yaml::node_t();
+				yaml::map_t& m = out.d.emplace<yaml::map_t>();
+				if (po.parseComments)
+					parseTokenComments(event->mapping_start.mapping_start, out);
+				fy_parser_event_free(p, event);	 // free event
 
-				ASSERT_(nKey->isScalar());
+				yaml::node_t key;
+				for (;;)
+				{
+					// Next event is map key:
+					// end of map reached?
+					if (!recursiveParse(p, key, po)) break;
 
-				// Move comments from key:
-				yaml::node_t& val = m[*nKey];
+					ASSERT_(key.isScalar());
 
-				// and next event is mapped content:
-				auto nVal = recursiveParse(p);
-				ASSERT_(nVal.has_value());
+					// Keys in sorted files are appended in O(1):
+					auto it =
+						m.emplace_hint(m.end(), std::move(key), yaml::node_t());
 
-				val = std::move(nVal.value());
+					// and next event is mapped content:
+					const bool hasVal = recursiveParse(p, it->second, po);
+					ASSERT_(hasVal);
+				}
+				return true;
 			}
-
-			return n;
-		}
-		break;
-		case FYET_MAPPING_END:
-		{
-			PARSER_DBG_OUT("Event: MAP END");
-			fy_parser_event_free(p, event);	 // free event
-			return {};
-		}
-		break;
-		case FYET_SEQUENCE_START:
-		{
-			PARSER_DBG_OUT("Event: SEQ START");
-			fy_parser_event_free(p, event);	 // free event
-			yaml::node_t n;
-			yaml::sequence_t& s = n.d.emplace<yaml::sequence_t>();
-
-			parseTokenComments(event->scalar.value, n);
-
-			for (;;)
+			case FYET_MAPPING_END:
 			{
-				auto entry = recursiveParse(p);
-				if (!entry.has_value()) break;	// end of sequence reached?
-				s.push_back(std::move(entry.value()));
+				PARSER_DBG_OUT("Event: MAP END");
+				fy_parser_event_free(p, event);	 // free event
+				return false;
 			}
-
-			return n;
-		}
-		break;
-		case FYET_SEQUENCE_END:
-		{
-			PARSER_DBG_OUT("Event: SEQ END");
-			fy_parser_event_free(p, event);	 // free event
-			return {};
-		}
-		break;
-		case FYET_SCALAR:
-		{
-			size_t strValueLen = 0;
-			const char* strValue =
-				fy_token_get_text(event->scalar.value, &strValueLen);
-			const std::string sValue(strValue, strValueLen);
-
-			PARSER_DBG_OUT(
-				"token: " << reinterpret_cast<void*>(event->scalar.value)
-						  << " Scalar: implicit="
-						  << (event->scalar.tag_implicit ? "1" : "0")
-						  << " tag: " << ((void*)event->scalar.tag)
-						  << " anchor: " << ((void*)event->scalar.anchor)
-						  << fy_token_get_text0(event->scalar.anchor)
-						  << " value: " << sValue);
-
-			if (event->scalar.value)
+			case FYET_SEQUENCE_START:
 			{
-				yaml::node_t n;
-				n.d.emplace<yaml::scalar_t>(textToScalar(sValue));
-
-				parseTokenComments(event->scalar.value, n);
+				PARSER_DBG_OUT("Event: SEQ START");
+				out = yaml::node_t();
+				yaml::sequence_t& s = out.d.emplace<yaml::sequence_t>();
+				if (po.parseComments)
+					parseTokenComments(
+						event->sequence_start.sequence_start, out);
+				fy_parser_event_free(p, event);	 // free event
 
+				for (;;)
+				{
+					// end of sequence reached?
+					if (!recursiveParse(p, s.emplace_back(), po))
+					{
+						s.pop_back();
+						break;
+					}
+				}
+				return true;
+			}
+			case FYET_SEQUENCE_END:
+			{
+				PARSER_DBG_OUT("Event: SEQ END");
 				fy_parser_event_free(p, event);	 // free event
-				return n;
+				return false;
 			}
-			else
+			case FYET_SCALAR:
 			{
-				THROW_EXCEPTION(
-					"Unexpected empty scalar?! Re-run with environment "
-					"variable MRPT_YAML_PARSER_VERBOSE=1 to get more details.");
+				if (!event->scalar.value)
+				{
+					fy_parser_event_free(p, event);	 // free event
+					THROW_EXCEPTION(
+						"Unexpected empty scalar?! Re-run with environment "
+						"variable MRPT_YAML_PARSER_VERBOSE=1 to get more "
+						"details.");
+				}
+
+				size_t strValueLen = 0;
+				const char* strValue =
+					fy_token_get_text(event->scalar.value, &strValueLen);
+				std::string sValue(strValue, strValueLen);
+
+				PARSER_DBG_OUT(
+					"token: " << reinterpret_cast<void*>(event->scalar.value)
+							  << " Scalar: implicit="
+							  << (event->scalar.tag_implicit ? "1" : "0")
+							  << " value: " << sValue);
+
+				out = yaml::node_t();
+				out.d.emplace<yaml::scalar_t>(textToScalar(std::move(sValue)));
+				if (po.parseComments)
+					parseTokenComments(event->scalar.value, out);
+
+				fy_parser_event_free(p, event);	 // free event
+				return true;
 			}
-		}
-		break;
-		case FYET_ALIAS:
-			fy_parser_event_free(p, event);	 // free event
-			return recursiveParse(p);  // Keep going
-	};
+		};
 
-	THROW_EXCEPTION_FMT("Unexpected parser event type %i", event->type);
+		const int type = static_cast<int>(event->type);
+		fy_parser_event_free(p, event);	 // free event
+		THROW_EXCEPTION_FMT("Unexpected parser event type %i", type);
+	}
 
 #undef PARSER_DBG_OUT
 	MRPT_END
 }
 #endif
 
-void yaml::loadFromText(const std::string& yamlTextBlock)
+void yaml::loadFromText(
+	const std::string& yamlTextBlock, const YamlParseOptions& po)
 {
 	MRPT_START
 #if MRPT_HAS_FYAML
@@ -991,32 +964,45 @@ void yaml::loadFromText(const std::string& yamlTextBlock)
 	struct fy_parse_cfg cfg;
 	cfg.search_path = "";
 	cfg.diag = nullptr;
-	cfg.flags = FYPCF_PARSE_COMMENTS;
+	cfg.flags = po.parseComments ? FYPCF_PARSE_COMMENTS
+								 : static_cast<enum fy_parse_cfg_flags>(0);
 
 	struct fy_parser* parser = fy_parser_create(&cfg);
 	ASSERT_(parser);
 
 	if (fy_parser_set_string(
 			parser, yamlTextBlock.data(), yamlTextBlock.size()))
+	{
+		fy_parser_destroy(parser);
 		THROW_EXCEPTION("Error in fy_parser_set_string()");
+	}
 
-	auto optNode = recursiveParse(parser);
-	if (optNode.has_value()) root_ = std::move(optNode.value());
+	try
+	{
+		recursiveParse(parser, root_, po);
+	}
+	catch (...)
+	{
+		fy_parser_destroy(parser);
+		throw;
+	}
 
 	fy_parser_destroy(parser);
 
 #else
+	(void)yamlTextBlock;
+	(void)po;
 	THROW_EXCEPTION("MRPT was built without libfyaml");
 #endif
 
 	MRPT_END
 }
 
-yaml yaml::FromStream(std::istream& i)
+yaml yaml::FromStream(std::istream& i, const YamlParseOptions& po)
 {
 	MRPT_START
 	yaml doc;
-	doc.loadFromStream(i);
+	doc.loadFromStream(i, po);
 	return doc;
 	MRPT_END
 }
@@ -1041,24 +1027,24 @@ static std::string local_file_get_contents(const std::string& fileName)
 	return buffer;
 }
 
-void yaml::loadFromFile(const std::string& fileName)
+void yaml::loadFromFile(const std::string& fileName, const YamlParseOptions& po)
 {
 	MRPT_START
 	clear();
-	this->loadFromText(local_file_get_contents(fileName));
+	this->loadFromText(local_file_get_contents(fileName), po);
 	MRPT_END
 }
 
-yaml yaml::FromFile(const std::string& fileName)
+yaml yaml::FromFile(const std::string& fileName, const YamlParseOptions& po)
 {
 	MRPT_START
 	yaml doc;
-	doc.loadFromFile(fileName);
+	doc.loadFromFile(fileName, po);
 	return doc;
 	MRPT_END
 }
 
-void yaml::loadFromStream(std::istream& i)
+void yaml::loadFromStream(std::istream& i, const YamlParseOptions& po)
 {
 	MRPT_START
 	std::string str;
@@ -1069,7 +1055,7 @@ void yaml::loadFromStream(std::istream& i)
 	str.assign(
 		(std::istreambuf_iterator<char>(i)), std::istreambuf_iterator<char>());
 
-	this->loadFromText(str);
+	this->loadFromText(str, po);
 	MRPT_END
 }
 
@@ -644,6 +644,34 @@ MRPT_TEST(yaml, fromYAML)
 }
 MRPT_TEST_END()
 
+MRPT_TEST(yaml, fromYAMLWithoutComments)
+{
+	mrpt::containers::YamlParseOptions po;
+	po.parseComments = false;
+
+	const auto p = mrpt::containers::yaml::FromText(sampleYamlBlock_3, po);
+	const auto pc = mrpt::containers::yaml::FromText(sampleYamlBlock_3);
+
+	EXPECT_EQ(p["mySeq"].size(), 4U);
+	EXPECT_EQ(p["mySeq"](2).as<std::string>(), "third");
+	EXPECT_TRUE(p["mySeq"](3).isNullNode());
+	EXPECT_EQ(p["myMap"]["P"].as<double>(), -5.0);
+	EXPECT_EQ(p["myMap"]["nestedMap"]["c"].as<int>(), 3);
+
+	EXPECT_TRUE(pc["myMap"]["nestedMap"]["a"].hasComment());
+	EXPECT_FALSE(p["myMap"]["nestedMap"]["a"].hasComment());
+	EXPECT_FALSE(p["myMap"]["nestedMap"].keyHasComment("b"));
+
+	// Same contents otherwise:
+	mrpt::containers::YamlEmitOptions eo;
+	eo.emitComments = false;
+	std::stringstream ss, ssc;
+	p.printAsYAML(ss, eo);
+	pc.printAsYAML(ssc, eo);
+	EXPECT_EQ(ss.str(), ssc.str());
+}
+MRPT_TEST_END()
+
 MRPT_TEST(yaml, printInShortFormat)
 {
 	mrpt::containers::yaml n1 = mrpt::containers::yaml::Sequence({1, 2, 3});
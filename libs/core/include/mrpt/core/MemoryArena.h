@@ -0,0 +1,122 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace mrpt
+{
+/** \addtogroup mrpt_core_grp
+ * @{ */
+
+/** A monotonic memory arena: memory is handed out sequentially from large
+ * blocks, deallocation is a no-op, and all blocks are released at once when
+ * the arena is destroyed.
+ *
+ * Use it via mrpt::arena_allocator, whose copies share the ownership of the
+ * arena, so it is kept alive while any object allocated in it exists. This is
+ * used to load rawlogs with one arena per group of deserialized objects (see
+ * mrpt::serialization::CArchive::setMemoryArena()), saving millions of small
+ * heap allocations and reducing heap fragmentation.
+ *
+ * allocate() is thread-safe.
+ *
+ * \note (New in MRPT 2.4.9)
+ */
+class MemoryArena
+{
+   public:
+	using Ptr = std::shared_ptr<MemoryArena>;
+
+	/** Creates an empty arena. Memory will be requested from the system in
+	 * blocks of `blockSize` bytes (or larger, for larger allocations). */
+	explicit MemoryArena(size_t blockSize = 64 * 1024);
+	~MemoryArena();
+
+	MemoryArena(const MemoryArena&) = delete;
+	MemoryArena& operator=(const MemoryArena&) = delete;
+
+	/** Returns `bytes` of uninitialized memory with the given alignment
+	 * (which must be a power of two).
+	 * \exception std::bad_alloc On out of memory. */
+	void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+
+	/** Total bytes handed out by allocate() so far */
+	size_t allocatedBytes() const;
+	/** Total bytes of the blocks requested from the system */
+	size_t reservedBytes() const;
+	/** Number of blocks requested from the system */
+	size_t blockCount() const;
+
+   private:
+	const size_t m_blockSize;
+	mutable std::mutex m_mtx;
+	std::vector<void*> m_blocks;
+	uint8_t* m_cur = nullptr;
+	size_t m_curLeft = 0;
+	size_t m_allocated = 0, m_reserved = 0;
+
+	void* newBlock(size_t bytes, size_t alignment);
+};
+
+/** A C++11 allocator that takes memory from a mrpt::MemoryArena, and keeps it
+ * alive while any copy of the allocator exists. deallocate() is a no-op.
+ *
+ * \code
+ * auto arena = std::make_shared<mrpt::MemoryArena>();
+ * auto obs = std::allocate_shared<CObservation2DRangeScan>(
+ *     mrpt::arena_allocator<CObservation2DRangeScan>(arena));
+ * \endcode
+ *
+ * \note (New in MRPT 2.4.9)
+ */
+template <class T>
+class arena_allocator
+{
+   public:
+	using value_type = T;
+
+	explicit arena_allocator(MemoryArena::Ptr arena) : m_arena(std::move(arena))
+	{
+	}
+	template <class U>
+	arena_allocator(const arena_allocator<U>& o) noexcept : m_arena(o.arena())
+	{
+	}
+
+	T* allocate(size_t n)
+	{
+		return static_cast<T*>(m_arena->allocate(n * sizeof(T), alignof(T)));
+	}
+	void deallocate(T*, size_t) noexcept {}
+
+	const MemoryArena::Ptr& arena() const { return m_arena; }
+
+	template <class U>
+	bool operator==(const arena_allocator<U>& o) const noexcept
+	{
+		return m_arena == o.arena();
+	}
+	template <class U>
+	bool operator!=(const arena_allocator<U>& o) const noexcept
+	{
+		return m_arena != o.arena();
+	}
+
+   private:
+	MemoryArena::Ptr m_arena;
+};
+
+/** @} */  // end of grouping
+
+}  // namespace mrpt
@@ -15,11 +15,16 @@
  * @date   Dec 6, 2018
  */
 
+#include <algorithm>
+#include <array>
 #include <atomic>
 #include <condition_variable>
 #include <cstdint>
+#include <deque>
+#include <exception>
 #include <functional>
 #include <future>
+#include <memory>
 #include <mutex>
 #include <queue>
 #include <thread>
@@ -42,6 +47,19 @@ namespace mrpt
  *    to be executed.
  *  - WorkerThreadsPool::POLICY_DROP_OLD: Old jobs in the waiting queue are
  *    discarded. Note that running jobs are never aborted.
+ *  - WorkerThreadsPool::POLICY_WORK_STEALING: Each thread has its own task
+ *    deque. Tasks enqueued from within a worker thread go to its own deque
+ *    and are run by that thread in LIFO order (good for cache locality),
+ *    while idle threads steal the oldest tasks from the other deques. This
+ *    scales much better than a single queue for many small tasks, and for
+ *    tasks which enqueue more tasks (e.g. nested parallel_for()).
+ *
+ * Tasks can be given a priority with enqueueWithPriority(): pending tasks of
+ * higher priority are always started first, in all policies.
+ *
+ * parallel_for() splits a loop into chunks run by the pool threads and the
+ * calling thread. It can be safely nested, that is, called from tasks
+ * running in the same pool.
  *
  * \note Partly based on: https://github.com/progschj/ThreadPool (ZLib license)
  *
@@ -56,7 +74,19 @@ class WorkerThreadsPool
 		POLICY_FIFO,
 		/** If a task arrives and there are more pending tasks than worker
 		   threads, drop previous tasks. */
-		POLICY_DROP_OLD
+		POLICY_DROP_OLD,
+		/** Per-thread task deques, with work stealing among threads.
+		 * \note (New in MRPT 2.4.9) */
+		POLICY_WORK_STEALING
+	};
+
+	/** Task priorities, see enqueueWithPriority()
+	 * \note (New in MRPT 2.4.9) */
+	enum priority_t : uint8_t
+	{
+		PRIORITY_LOW = 0,
+		PRIORITY_NORMAL,
+		PRIORITY_HIGH
 	};
 
 	WorkerThreadsPool() = default;
@@ -70,6 +100,9 @@ class WorkerThreadsPool
 	}
 	~WorkerThreadsPool() { clear(); }
 
+	/** Adds `num_threads` new threads to the pool.
+	 * \note With POLICY_WORK_STEALING, do not call it while there are tasks
+	 * running. */
 	void resize(std::size_t num_threads);
 	/** Get number of working threads \note (New in MRPT 2.4.2) */
 	std::size_t size() const { return threads_.size(); }
@@ -81,8 +114,35 @@ class WorkerThreadsPool
 	 * available. */
 	template <class F, class... Args>
 	[[nodiscard]] auto enqueue(F&& f, Args&&... args)
+		-> std::future<typename std::result_of<F(Args...)>::type>
+	{
+		return enqueueWithPriority(
+			PRIORITY_NORMAL, std::forward<F>(f), std::forward<Args>(args)...);
+	}
+
+	/** Like enqueue(), with a given priority. Pending tasks with a higher
+	 * priority are started before any task with a lower one.
+	 * \note (New in MRPT 2.4.9) */
+	template <class F, class... Args>
+	[[nodiscard]] auto enqueueWithPriority(
+		priority_t priority, F&& f, Args&&... args)
 		-> std::future<typename std::result_of<F(Args...)>::type>;
 
+	/** Runs `fn(i)` for each `i` in the range [first, last), in parallel.
+	 * The range is split into chunks of `grain` indices, which are run by
+	 * the pool threads and by the calling thread, which blocks until all of
+	 * them are done. While waiting, the calling thread helps running other
+	 * pending tasks in the pool, so parallel_for() may be nested (called
+	 * from within tasks of the same pool) without deadlocks.
+	 *
+	 * If `fn` throws, the remaining chunks are skipped and the (first)
+	 * exception is rethrown from here.
+	 *
+	 * \note (New in MRPT 2.4.9) */
+	template <class FUNC>
+	void parallel_for(
+		std::size_t first, std::size_t last, std::size_t grain, FUNC&& fn);
+
 	/** Returns the number of enqueued tasks, currently waiting for a free
 	 * working thread to process them.  */
 	std::size_t pendingTasks() const noexcept;
@@ -98,17 +158,44 @@ class WorkerThreadsPool
 	std::string name() const { return name_; }
 
    private:
+	static constexpr std::size_t NUM_PRIORITIES = PRIORITY_HIGH + 1;
+	using task_t = std::function<void()>;
+
+	/** Per-thread task deques, for POLICY_WORK_STEALING */
+	struct worker_queue_t
+	{
+		std::mutex mtx;
+		std::array<std::deque<task_t>, NUM_PRIORITIES> tasks;
+	};
+
 	std::vector<std::thread> threads_;
 	std::atomic_bool do_stop_{false};
 	std::mutex queue_mutex_;
 	std::condition_variable condition_;
-	std::queue<std::function<void()>> tasks_;
+	/** One queue per priority (not used with POLICY_WORK_STEALING) */
+	std::array<std::queue<task_t>, NUM_PRIORITIES> tasks_;
+	std::vector<std::unique_ptr<worker_queue_t>> ws_queues_;
+	std::atomic<std::size_t> ws_next_queue_{0};
+	std::atomic<std::size_t> pending_{0};
+	/** Helper tasks of parallel_for() still pending when it returned. They
+	 * do nothing, so they are not reported by clear(). */
+	std::atomic<std::int64_t> stale_helpers_{0};
 	queue_policy_t policy_{POLICY_FIFO};
 	std::string name_{"WorkerThreadsPool"};
+
+	void pushTask(task_t&& task, priority_t priority);
+	/** Takes the next task to run, if any. `workerIdx` is the index of the
+	 * calling worker thread, or size() for other threads. */
+	bool tryPopTask(task_t& task, std::size_t workerIdx);
+	/** Runs one pending task, if any. Used while waiting in parallel_for()
+	 * \return false if there were no pending tasks. */
+	bool runPendingTask();
+	void runTask(task_t& task);
 };
 
 template <class F, class... Args>
-auto WorkerThreadsPool::enqueue(F&& f, Args&&... args)
+auto WorkerThreadsPool::enqueueWithPriority(
+	priority_t priority, F&& f, Args&&... args)
 	-> std::future<typename std::result_of<F(Args...)>::type>
 {
 	using return_type = typename std::result_of<F(Args...)>::type;
@@ -117,26 +204,78 @@ auto WorkerThreadsPool::enqueue(F&& f, Args&&... args)
 		std::bind(std::forward<F>(f), std::forward<Args>(args)...));
 
 	std::future<return_type> res = task->get_future();
-	{
-		std::unique_lock<std::mutex> lock(queue_mutex_);
+	pushTask([task]() { (*task)(); }, priority);
+	return res;
+}
 
-		// don't allow enqueueing after stopping the pool
-		if (do_stop_) throw std::runtime_error("enqueue on stopped ThreadPool");
+template <class FUNC>
+void WorkerThreadsPool::parallel_for(
+	std::size_t first, std::size_t last, std::size_t grain, FUNC&& fn)
+{
+	if (last <= first) return;
+	if (grain == 0) grain = 1;
+	const std::size_t nChunks = (last - first + grain - 1) / grain;
+
+	// Shared with the helper tasks, which may start after we return:
+	struct state_t
+	{
+		std::atomic<std::size_t> nextChunk{0}, doneChunks{0};
+		std::atomic_bool failed{false};
+		std::exception_ptr error;
+		// Number of started helpers, plus RETURNED once we return:
+		std::atomic<std::uint64_t> helpers{0};
+	};
+	constexpr std::uint64_t RETURNED = std::uint64_t(1) << 32;
+	auto st = std::make_shared<state_t>();
 
-		// policy check: drop pending tasks if we have more tasks than threads
-		if (policy_ == POLICY_DROP_OLD)
+	// Grab and run chunks until there are no more left:
+	auto runChunks = [st, first, last, grain, nChunks, &fn]() {
+		for (;;)
 		{
-			while (tasks_.size() >= threads_.size())
+			const std::size_t c = st->nextChunk++;
+			if (c >= nChunks) return;
+			if (!st->failed)
 			{
-				tasks_.pop();
+				try
+				{
+					const std::size_t i0 = first + c * grain;
+					const std::size_t i1 = std::min(last, i0 + grain);
+					for (std::size_t i = i0; i < i1; i++)
+						fn(i);
+				}
+				catch (...)
+				{
+					if (!st->failed.exchange(true))
+						st->error = std::current_exception();
+				}
 			}
+			st->doneChunks++;
 		}
+	};
 
-		// Enqeue the new task:
-		tasks_.emplace([task]() { (*task)(); });
-	}
-	condition_.notify_one();
-	return res;
+	const std::size_t nHelpers = do_stop_ ? 0 : std::min(nChunks - 1, size());
+	for (std::size_t i = 0; i < nHelpers; i++)
+		pushTask(
+			[this, st, runChunks]() {
+				if (st->helpers++ >= RETURNED)
+				{
+					stale_helpers_--;
+					return;
+				}
+				runChunks();
+			},
+			PRIORITY_NORMAL);
+
+	runChunks();
+
+	// Wait for chunks still running in other threads:
+	while (st->doneChunks < nChunks)
+		if (!runPendingTask()) std::this_thread::yield();
+
+	const std::uint64_t started = st->helpers.fetch_add(RETURNED);
+	stale_helpers_ += static_cast<std::int64_t>(nHelpers - started);
+
+	if (st->failed) std::rethrow_exception(st->error);
 }
 
 /** @} */
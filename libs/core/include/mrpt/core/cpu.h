@@ -31,6 +31,7 @@ enum class feature : unsigned int
 	SSE4_2,
 	AVX,
 	AVX2,
+	NEON,
 	// ---- end of list ----
 	FEATURE_COUNT
 };
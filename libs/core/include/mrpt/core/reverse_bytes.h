@@ -11,7 +11,9 @@
 #include <mrpt/config.h>
 #include <mrpt/core/Clock.h>
 
+#include <cstddef>
 #include <cstdint>
+#include <type_traits>
 
 namespace mrpt
 {
@@ -33,6 +35,22 @@ void reverseBytesInPlace(float& v_in_out);
 void reverseBytesInPlace(double& v_in_out);
 void reverseBytesInPlace(std::chrono::time_point<mrpt::Clock>& v_in_out);
 
+/** Reverse the order of the bytes of each of the `count` consecutive
+ * elements, of `elementSize` bytes each, stored at `data`. The whole block is
+ * converted with one tight loop per element size, which compilers
+ * auto-vectorize, instead of one reverseBytesInPlace() call per element.
+ * \note (New in MRPT 2.4.9) */
+void reverseBytesInPlaceBlock(void* data, size_t elementSize, size_t count);
+
+/** \overload for an array of `count` elements of a fixed-size type.
+ * \note (New in MRPT 2.4.9) */
+template <class T>
+inline void reverseBytesInPlaceBlock(T* data, size_t count)
+{
+	static_assert(std::is_arithmetic_v<T>, "T must be an arithmetic type");
+	reverseBytesInPlaceBlock(static_cast<void*>(data), sizeof(T), count);
+}
+
 /** Reverse the order of the bytes of a given type (useful for transforming btw
  * little/big endian)  */
 template <class T>
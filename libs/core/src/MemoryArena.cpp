@@ -0,0 +1,84 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "core-precomp.h"  // Precompiled headers
+//
+#include <mrpt/core/MemoryArena.h>
+#include <mrpt/core/aligned_allocator.h>
+#include <mrpt/core/alignment_req.h>
+
+#include <algorithm>
+#include <new>	// bad_alloc
+
+using namespace mrpt;
+
+MemoryArena::MemoryArena(size_t blockSize)
+	: m_blockSize(std::max<size_t>(blockSize, 1024))
+{
+}
+
+MemoryArena::~MemoryArena()
+{
+	for (void* b : m_blocks)
+		mrpt::aligned_free(b);
+}
+
+void* MemoryArena::newBlock(size_t bytes, size_t alignment)
+{
+	void* b = mrpt::aligned_malloc(bytes, alignment);
+	if (!b) throw std::bad_alloc();
+	m_blocks.push_back(b);
+	m_reserved += bytes;
+	return b;
+}
+
+void* MemoryArena::allocate(size_t bytes, size_t alignment)
+{
+	if (bytes == 0) bytes = 1;
+	const size_t blockAlign =
+		std::max<size_t>(MRPT_MAX_ALIGN_BYTES, alignof(std::max_align_t));
+
+	std::lock_guard<std::mutex> lck(m_mtx);
+	m_allocated += bytes;
+
+	// Large or over-aligned requests get their own block, so the current one
+	// keeps serving small objects:
+	if (alignment > blockAlign || bytes > m_blockSize / 4)
+		return newBlock(bytes, std::max(alignment, blockAlign));
+
+	size_t pad =
+		(alignment - reinterpret_cast<uintptr_t>(m_cur) % alignment) %
+		alignment;
+	if (!m_cur || pad + bytes > m_curLeft)
+	{
+		m_cur = static_cast<uint8_t*>(newBlock(m_blockSize, blockAlign));
+		m_curLeft = m_blockSize;
+		pad = 0;
+	}
+	uint8_t* p = m_cur + pad;
+	m_cur += pad + bytes;
+	m_curLeft -= pad + bytes;
+	return p;
+}
+
+size_t MemoryArena::allocatedBytes() const
+{
+	std::lock_guard<std::mutex> lck(m_mtx);
+	return m_allocated;
+}
+size_t MemoryArena::reservedBytes() const
+{
+	std::lock_guard<std::mutex> lck(m_mtx);
+	return m_reserved;
+}
+size_t MemoryArena::blockCount() const
+{
+	std::lock_guard<std::mutex> lck(m_mtx);
+	return m_blocks.size();
+}
@@ -0,0 +1,68 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/core/MemoryArena.h>
+
+#include <cstring>
+#include <vector>
+
+TEST(MemoryArena, allocate)
+{
+	mrpt::MemoryArena arena(4096);
+	EXPECT_EQ(arena.blockCount(), 0U);
+
+	std::vector<uint8_t*> ptrs;
+	for (size_t i = 1; i < 200; i++)
+	{
+		const size_t align = size_t(1) << (i % 6);
+		auto* p = static_cast<uint8_t*>(arena.allocate(i, align));
+		EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % align, 0U);
+		::memset(p, static_cast<int>(i), i);
+		ptrs.push_back(p);
+	}
+	// Nothing was overwritten:
+	for (size_t i = 1; i < 200; i++)
+		for (size_t k = 0; k < i; k++)
+			ASSERT_EQ(ptrs[i - 1][k], static_cast<uint8_t>(i));
+
+	EXPECT_EQ(arena.allocatedBytes(), 199U * 200U / 2);
+	EXPECT_GE(arena.reservedBytes(), arena.allocatedBytes());
+
+	// Large blocks, and over-aligned ones:
+	const size_t nBlocks = arena.blockCount();
+	void* big = arena.allocate(100000);
+	EXPECT_TRUE(big != nullptr);
+	EXPECT_EQ(arena.blockCount(), nBlocks + 1);
+	void* aligned = arena.allocate(10, 256);
+	EXPECT_EQ(reinterpret_cast<uintptr_t>(aligned) % 256, 0U);
+}
+
+TEST(MemoryArena, allocator)
+{
+	auto arena = std::make_shared<mrpt::MemoryArena>();
+	{
+		std::vector<double, mrpt::arena_allocator<double>> v{
+			mrpt::arena_allocator<double>(arena)};
+		for (int i = 0; i < 1000; i++)
+			v.push_back(i);
+		EXPECT_EQ(v[999], 999.0);
+	}
+	EXPECT_GE(arena->allocatedBytes(), 1000 * sizeof(double));
+
+	// shared_ptr keeps the arena alive:
+	std::weak_ptr<mrpt::MemoryArena> weakArena = arena;
+	auto p = std::allocate_shared<std::string>(
+		mrpt::arena_allocator<std::string>(arena), "hello");
+	arena.reset();
+	EXPECT_FALSE(weakArena.expired());
+	EXPECT_EQ(*p, "hello");
+	p.reset();
+	EXPECT_TRUE(weakArena.expired());
+}
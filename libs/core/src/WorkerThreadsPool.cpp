@@ -29,6 +29,10 @@
 
 using namespace mrpt;
 
+// The pool and index of the worker thread running the calling code, if any:
+static thread_local const WorkerThreadsPool* tl_pool = nullptr;
+static thread_local std::size_t tl_worker_index = 0;
+
 void WorkerThreadsPool::clear()
 {
 	{
@@ -37,11 +41,12 @@ void WorkerThreadsPool::clear()
 	}
 	condition_.notify_all();
 
-	if (!tasks_.empty())
+	const auto nPending = static_cast<std::int64_t>(pending_) - stale_helpers_;
+	if (nPending > 0)
 		std::cerr << "[WorkerThreadsPool name=`" << name_
 				  << "`] Warning: clear() called (probably from a "
 					 "dtor) while having "
-				  << tasks_.size() << " pending tasks. Aborting them.\n";
+				  << nPending << " pending tasks. Aborting them.\n";
 
 	for (auto& t : threads_)
 		if (t.joinable()) t.join();
@@ -50,38 +55,157 @@ void WorkerThreadsPool::clear()
 
 std::size_t WorkerThreadsPool::pendingTasks() const noexcept
 {
-	return tasks_.size();
+	return pending_;
 }
 
 void WorkerThreadsPool::resize(std::size_t num_threads)
 {
-	for (std::size_t i = 0; i < num_threads; ++i)
-		threads_.emplace_back([this] {
-			for (;;)
+	const std::size_t firstIdx = threads_.size();
+	if (policy_ == POLICY_WORK_STEALING)
+		while (ws_queues_.size() < firstIdx + num_threads)
+			ws_queues_.emplace_back(std::make_unique<worker_queue_t>());
+
+	for (std::size_t i = firstIdx; i < firstIdx + num_threads; ++i)
+		threads_.emplace_back([this, i] {
+			tl_pool = this;
+			tl_worker_index = i;
+			while (!do_stop_)
 			{
-				try
+				task_t task;
+				if (tryPopTask(task, i))
 				{
-					std::function<void()> task;
-					{
-						std::unique_lock<std::mutex> lock(queue_mutex_);
-						condition_.wait(lock, [this] {
-							return do_stop_ || !tasks_.empty();
-						});
-						if (do_stop_) return;
-						task = std::move(tasks_.front());
-						tasks_.pop();
-					}
-					// Execute:
-					task();
+					runTask(task);
+					continue;
 				}
-				catch (std::exception& e)
+				std::unique_lock<std::mutex> lock(queue_mutex_);
+				condition_.wait(
+					lock, [this] { return do_stop_ || pending_ != 0; });
+			}
+		});
+}
+
+void WorkerThreadsPool::pushTask(task_t&& task, priority_t priority)
+{
+	// don't allow enqueueing after stopping the pool
+	if (do_stop_) throw std::runtime_error("enqueue on stopped ThreadPool");
+
+	if (policy_ == POLICY_WORK_STEALING && !ws_queues_.empty())
+	{
+		// Tasks from worker threads go to their own deque, others are
+		// distributed in round-robin:
+		const std::size_t qIdx = tl_pool == this
+			? tl_worker_index
+			: ws_next_queue_++ % ws_queues_.size();
+		auto& q = *ws_queues_[qIdx];
+		{
+			std::unique_lock<std::mutex> lock(q.mtx);
+			q.tasks[priority].push_back(std::move(task));
+		}
+		pending_++;
+		// Sync with threads about to wait on condition_, so none misses
+		// this task:
+		std::unique_lock<std::mutex> lock(queue_mutex_);
+	}
+	else
+	{
+		std::unique_lock<std::mutex> lock(queue_mutex_);
+
+		// policy check: drop pending tasks if we have more tasks than threads
+		// (lowest priority first)
+		if (policy_ == POLICY_DROP_OLD)
+		{
+			while (pending_ != 0 && pending_ >= threads_.size())
+			{
+				for (auto& q : tasks_)
 				{
-					std::cerr << "[WorkerThreadsPool name=`" << name_
-							  << "`] Exception:\n"
-							  << mrpt::exception_to_str(e) << "\n";
+					if (q.empty()) continue;
+					q.pop();
+					pending_--;
+					break;
 				}
 			}
-		});
+		}
+
+		// Enqeue the new task:
+		tasks_[priority].push(std::move(task));
+		pending_++;
+	}
+	condition_.notify_one();
+}
+
+bool WorkerThreadsPool::tryPopTask(task_t& task, std::size_t workerIdx)
+{
+	if (pending_ == 0) return false;
+
+	if (policy_ == POLICY_WORK_STEALING && !ws_queues_.empty())
+	{
+		const std::size_t n = ws_queues_.size();
+		for (std::size_t p = NUM_PRIORITIES; p-- > 0;)
+		{
+			// The newest task in our own deque:
+			if (workerIdx < n)
+			{
+				auto& q = *ws_queues_[workerIdx];
+				std::unique_lock<std::mutex> lock(q.mtx);
+				if (!q.tasks[p].empty())
+				{
+					task = std::move(q.tasks[p].back());
+					q.tasks[p].pop_back();
+					pending_--;
+					return true;
+				}
+			}
+			// Otherwise, steal the oldest task of another thread:
+			for (std::size_t k = 1; k <= n; k++)
+			{
+				const std::size_t idx = (workerIdx + k) % n;
+				if (idx == workerIdx) continue;
+				auto& q = *ws_queues_[idx];
+				std::unique_lock<std::mutex> lock(q.mtx);
+				if (!q.tasks[p].empty())
+				{
+					task = std::move(q.tasks[p].front());
+					q.tasks[p].pop_front();
+					pending_--;
+					return true;
+				}
+			}
+		}
+		return false;
+	}
+
+	std::unique_lock<std::mutex> lock(queue_mutex_);
+	for (std::size_t p = NUM_PRIORITIES; p-- > 0;)
+	{
+		if (tasks_[p].empty()) continue;
+		task = std::move(tasks_[p].front());
+		tasks_[p].pop();
+		pending_--;
+		return true;
+	}
+	return false;
+}
+
+bool WorkerThreadsPool::runPendingTask()
+{
+	task_t task;
+	if (!tryPopTask(task, tl_pool == this ? tl_worker_index : size()))
+		return false;
+	runTask(task);
+	return true;
+}
+
+void WorkerThreadsPool::runTask(task_t& task)
+{
+	try
+	{
+		task();
+	}
+	catch (std::exception& e)
+	{
+		std::cerr << "[WorkerThreadsPool name=`" << name_ << "`] Exception:\n"
+				  << mrpt::exception_to_str(e) << "\n";
+	}
 }
 
 // code partially replicated from mrpt::system for convenience (avoid dep)
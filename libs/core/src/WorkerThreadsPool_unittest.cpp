@@ -11,6 +11,10 @@
 #include <mrpt/config.h>
 #include <mrpt/core/WorkerThreadsPool.h>
 
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
 #if !MRPT_IN_EMSCRIPTEN	 // No multithreading
 TEST(WorkerThreadsPool, runTasks)
 {
@@ -36,4 +40,95 @@ TEST(WorkerThreadsPool, runTasks)
 	}
 	EXPECT_EQ(accum, 6);
 }
+
+TEST(WorkerThreadsPool, priorities)
+{
+	for (auto policy : {mrpt::WorkerThreadsPool::POLICY_FIFO,
+						mrpt::WorkerThreadsPool::POLICY_WORK_STEALING})
+	{
+		using P = mrpt::WorkerThreadsPool;
+		mrpt::WorkerThreadsPool pool(1, policy);
+
+		// Keep the only thread busy until all tasks are enqueued:
+		std::promise<void> go;
+		auto fut0 = pool.enqueue([&go]() { go.get_future().wait(); });
+
+		std::vector<int> order;
+		auto f = [&order](int x) { order.push_back(x); };
+		auto fut1 = pool.enqueueWithPriority(P::PRIORITY_LOW, f, 1);
+		auto fut2 = pool.enqueueWithPriority(P::PRIORITY_NORMAL, f, 2);
+		auto fut3 = pool.enqueueWithPriority(P::PRIORITY_HIGH, f, 3);
+		auto fut4 = pool.enqueueWithPriority(P::PRIORITY_HIGH, f, 4);
+		go.set_value();
+		fut1.wait();
+
+		// Same priority: FIFO from a shared queue, or newest first
+		// (LIFO) from the worker's own deque with work stealing:
+		const auto expected = policy == P::POLICY_FIFO
+			? std::vector<int>({3, 4, 2, 1})
+			: std::vector<int>({4, 3, 2, 1});
+		EXPECT_EQ(order, expected);
+	}
+}
+
+TEST(WorkerThreadsPool, workStealing)
+{
+	mrpt::WorkerThreadsPool pool(
+		4, mrpt::WorkerThreadsPool::POLICY_WORK_STEALING);
+
+	std::atomic_int accum{0};
+	std::vector<std::future<void>> futs;
+	for (int i = 1; i <= 1000; i++)
+		futs.emplace_back(pool.enqueue([&accum](int x) { accum += x; }, i));
+	// Tasks which enqueue more tasks:
+	std::vector<std::future<std::future<int>>> futs2;
+	for (int i = 0; i < 10; i++)
+		futs2.emplace_back(pool.enqueue([&pool, i]() {
+			return pool.enqueue([i]() { return i * 2; });
+		}));
+
+	for (auto& f : futs)
+		f.wait();
+	EXPECT_EQ(accum.load(), 1000 * 1001 / 2);
+	for (int i = 0; i < 10; i++)
+		EXPECT_EQ(futs2[i].get().get(), i * 2);
+}
+
+TEST(WorkerThreadsPool, parallel_for)
+{
+	for (auto policy : {mrpt::WorkerThreadsPool::POLICY_FIFO,
+						mrpt::WorkerThreadsPool::POLICY_WORK_STEALING})
+	{
+		for (std::size_t nThreads : {0, 1, 3})
+		{
+			mrpt::WorkerThreadsPool pool(nThreads, policy);
+
+			constexpr std::size_t N = 1000, M = 50;
+			std::vector<int> v(N, 0);
+			pool.parallel_for(0, N, 7, [&v](std::size_t i) { v[i] += 1; });
+			for (std::size_t i = 0; i < N; i++)
+				ASSERT_EQ(v[i], 1);
+
+			// Nested:
+			std::vector<std::atomic_int> counts(N);
+			pool.parallel_for(0, N, 10, [&](std::size_t i) {
+				pool.parallel_for(0, M, 3, [&](std::size_t) { counts[i]++; });
+			});
+			for (std::size_t i = 0; i < N; i++)
+				ASSERT_EQ(counts[i].load(), static_cast<int>(M));
+
+			// Empty range:
+			pool.parallel_for(5, 5, 1, [](std::size_t) { FAIL(); });
+
+			// Exceptions are forwarded:
+			EXPECT_THROW(
+				pool.parallel_for(
+					0, N, 1,
+					[](std::size_t i) {
+						if (i == 500) throw std::runtime_error("x");
+					}),
+				std::runtime_error);
+		}
+	}
+}
 #endif	// !MRPT_IN_EMSCRIPTEN
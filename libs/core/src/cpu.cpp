@@ -60,6 +60,9 @@ void CPU_analyzer::detect_impl() noexcept
 		cpuid(info, 0x00000007);
 		feat(feature::AVX2) = !!(info[1] & (1 << 5));
 	}
+#if defined(_M_ARM64)
+	feat(feature::NEON) = true;
+#endif
 
 	// Doubt: is this required?
 	// auto xcrFeatureMask = _xgetbv(_XCR_XFEATURE_ENABLED_MASK);
@@ -87,6 +90,10 @@ void CPU_analyzer::detect_impl() noexcept
 	feat(feature::SSE4_2) = !!__builtin_cpu_supports("sse4.2");
 	feat(feature::AVX) = __builtin_cpu_supports("avx");
 	feat(feature::AVX2) = __builtin_cpu_supports("avx2");
+#endif
+	// NEON is mandatory in aarch64, optional (build flags) in 32bit ARM:
+#if defined(__ARM_NEON) || defined(__aarch64__)
+	feat(feature::NEON) = true;
 #endif
 }
 #endif
@@ -108,6 +115,7 @@ std::string mrpt::cpu::features_as_string() noexcept
 	s += mrpt::format("SSE4_2:%i ", o.feat(feature::SSE4_2) ? 1 : 0);
 	s += mrpt::format("AVX:%i ", o.feat(feature::AVX) ? 1 : 0);
 	s += mrpt::format("AVX2:%i ", o.feat(feature::AVX2) ? 1 : 0);
+	s += mrpt::format("NEON:%i ", o.feat(feature::NEON) ? 1 : 0);
 
 	return s;
 }
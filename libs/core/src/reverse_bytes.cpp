@@ -11,6 +11,7 @@
 //
 #include <mrpt/core/reverse_bytes.h>
 
+#include <algorithm>
 #include <cstdlib>
 #include <cstring>
 
@@ -151,3 +152,75 @@ void mrpt::reverseBytesInPlace(std::chrono::time_point<mrpt::Clock>& v_in_out)
 	reverseBytesInPlace_8b(val);
 	v_in_out = std::chrono::time_point<mrpt::Clock>(mrpt::Clock::duration(val));
 }
+
+// Block versions: plain loops with no calls inside, so that GCC/clang can
+// vectorize them (e.g. into SSSE3 pshufb or NEON rev instructions).
+namespace
+{
+template <typename UINT, UINT (*SWAP)(UINT)>
+void reverseBlock(void* data, size_t count)
+{
+	auto* p = static_cast<uint8_t*>(data);
+	for (size_t i = 0; i < count; i++, p += sizeof(UINT))
+	{
+		UINT v;
+		std::memcpy(&v, p, sizeof(UINT));
+		v = SWAP(v);
+		std::memcpy(p, &v, sizeof(UINT));
+	}
+}
+
+inline uint16_t swap16(uint16_t v)
+{
+	return static_cast<uint16_t>((v >> 8) | (v << 8));
+}
+inline uint32_t swap32(uint32_t v)
+{
+#if defined(_MSC_VER)
+	return _byteswap_ulong(v);
+#elif defined(HAVE_BSWAP_INTRINSICS)
+	return __builtin_bswap32(v);
+#else
+	return ((v & 0xff000000) >> 24) | ((v & 0x00ff0000) >> 8) |
+		((v & 0x0000ff00) << 8) | ((v & 0x000000ff) << 24);
+#endif
+}
+inline uint64_t swap64(uint64_t v)
+{
+#if defined(_MSC_VER)
+	return _byteswap_uint64(v);
+#elif defined(HAVE_BSWAP_INTRINSICS)
+	return __builtin_bswap64(v);
+#else
+	return (static_cast<uint64_t>(swap32(static_cast<uint32_t>(v))) << 32) |
+		swap32(static_cast<uint32_t>(v >> 32));
+#endif
+}
+}  // namespace
+
+void mrpt::reverseBytesInPlaceBlock(
+	void* data, size_t elementSize, size_t count)
+{
+	switch (elementSize)
+	{
+		case 0:
+		case 1:
+			// Nothing to do.
+			break;
+		case 2:
+			reverseBlock<uint16_t, &swap16>(data, count);
+			break;
+		case 4:
+			reverseBlock<uint32_t, &swap32>(data, count);
+			break;
+		case 8:
+			reverseBlock<uint64_t, &swap64>(data, count);
+			break;
+		default:
+		{
+			auto* p = static_cast<uint8_t*>(data);
+			for (size_t i = 0; i < count; i++, p += elementSize)
+				std::reverse(p, p + elementSize);
+		}
+	}
+}
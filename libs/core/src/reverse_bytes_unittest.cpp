@@ -12,6 +12,8 @@
 #include <mrpt/core/bit_cast.h>
 #include <mrpt/core/reverse_bytes.h>
 
+#include <vector>
+
 // Load data from constant file and check for exact match.
 TEST(bits, reverseBytes)
 {
@@ -128,3 +130,30 @@ TEST(bits, reverseBytes)
 		EXPECT_EQ(t, t_org);
 	}
 }
+
+TEST(bits, reverseBytesInPlaceBlock)
+{
+	std::vector<uint16_t> v16 = {0x1122, 0x3344, 0x5566};
+	std::vector<uint32_t> v32(37);
+	std::vector<double> vd(41);
+	for (size_t i = 0; i < v32.size(); i++)
+		v32[i] = UINT32_C(0x01020304) * static_cast<uint32_t>(i + 1);
+	for (size_t i = 0; i < vd.size(); i++)
+		vd[i] = 0.1 * i - 1.0;
+
+	auto v16r = v16;
+	auto v32r = v32;
+	auto vdr = vd;
+	mrpt::reverseBytesInPlaceBlock(v16r.data(), v16r.size());
+	mrpt::reverseBytesInPlaceBlock(v32r.data(), v32r.size());
+	mrpt::reverseBytesInPlaceBlock(vdr.data(), vdr.size());
+
+	for (size_t i = 0; i < v16.size(); i++)
+		EXPECT_EQ(v16r[i], mrpt::reverseBytes(v16[i]));
+	for (size_t i = 0; i < v32.size(); i++)
+		EXPECT_EQ(v32r[i], mrpt::reverseBytes(v32[i]));
+	for (size_t i = 0; i < vd.size(); i++)
+		EXPECT_EQ(
+			bit_cast<uint64_t>(vdr[i]),
+			bit_cast<uint64_t>(mrpt::reverseBytes(vd[i])));
+}
@@ -9,11 +9,32 @@
 
 #pragma once
 
+#include <mrpt/core/WorkerThreadsPool.h>
 #include <mrpt/detectors/CObjectDetection.h>
 
+#include <memory>
+#include <mutex>
+#include <vector>
+
 namespace mrpt::detectors
 {
-/**
+/** Object detection with OpenCV cascade classifiers.
+ *
+ * Detection can be run in parallel (option `numThreads`): the scales of the
+ * multi-scale search over the whole image are split into bands of similar
+ * cost, each one searched by a different thread with its own copy of the
+ * classifier, and all the candidates are grouped at once afterwards, so
+ * results are the same than with one single thread.
+ *
+ * With the option `trackROIs`, once some objects have been detected, the
+ * following frames are only searched within the regions of the previous
+ * detections, enlarged by `roiMargin`, and in parallel. A full image search
+ * is still done every `fullFrameEvery` frames, or whenever nothing was
+ * detected in the last frame, to find new objects.
+ *
+ * Options are read in init(), from the sections `[CascadeClassifier]`
+ * (`cascadeFilename`) and `[DetectionOptions]` (the rest of TOptions).
+ *
  * \ingroup mrpt_detectors_grp
  */
 class CCascadeClassifierDetection : virtual public CObjectDetection
@@ -26,9 +47,16 @@ class CCascadeClassifierDetection : virtual public CObjectDetection
 	/** Initialize cascade classifier detection */
 	void init(const mrpt::config::CConfigFileBase& cfg) override;
 
+	/** Forgets the detections of the last frame, so the next one is a full
+	 * image search (e.g. when switching between video streams).
+	 * 
+ote (New in MRPT 2.4.9) */
+	void resetTracking();
+
    protected:
 	/** Detect objects in a *CObservation
-	 * \return A vector with detected objects
+	 * 
+eturn A vector with detected objects
 	 */
 
 	void detectObjects_Impl(
@@ -36,7 +64,7 @@ class CCascadeClassifierDetection : virtual public CObjectDetection
 		vector_detectable_object& detected) override;
 
 	/** Cascade classifier object */
-	void* m_cascade;
+	void* m_cascade = nullptr;
 
 	struct TOptions
 	{
@@ -45,8 +73,48 @@ class CCascadeClassifierDetection : virtual public CObjectDetection
 		int minNeighbors;
 		int flags;
 		int minSize;
+		/** Maximum object size (pixels), or 0 for no limit.
+		 * 
+ote (New in MRPT 2.4.9) */
+		int maxSize{0};
+		/** Number of threads for detection (0: as many as hardware
+		 * threads).
+		 * 
+ote (New in MRPT 2.4.9) */
+		int numThreads{1};
+		/** Search only around the detections of the previous frame.
+		 * 
+ote (New in MRPT 2.4.9) */
+		bool trackROIs{false};
+		/** Margin added around each previous detection, as a fraction of
+		 * its size, for `trackROIs`. 
+ote (New in MRPT 2.4.9) */
+		double roiMargin{0.5};
+		/** With `trackROIs`, do a full image search every this number of
+		 * frames (0: never, unless nothing was detected).
+		 * 
+ote (New in MRPT 2.4.9) */
+		int fullFrameEvery{10};
 		/** Cascade classifier options */
 	} m_options;
 
+   private:
+	/** An image rectangle [pixels] */
+	struct TRect
+	{
+		int x = 0, y = 0, width = 0, height = 0;
+	};
+	/** Detections of the last frame, for `trackROIs` */
+	std::vector<TRect> m_lastDetections;
+	/** Frames since the last full image search */
+	int m_framesSinceFullSearch{0};
+
+	/** Extra copies of the classifier (OpenCV cascades cannot be shared
+	 * between threads), and the indices of those not in use */
+	std::vector<void*> m_threadCascades;
+	std::vector<size_t> m_freeCascades;
+	std::mutex m_freeCascadesMtx;
+	std::unique_ptr<mrpt::WorkerThreadsPool> m_pool;
+
 };	// End of class
 }  // namespace mrpt::detectors
@@ -9,6 +9,7 @@
 
 #pragma once
 
+#include <mrpt/core/WorkerThreadsPool.h>
 #include <mrpt/detectors/CCascadeClassifierDetection.h>
 #include <mrpt/detectors/CObjectDetection.h>
 #include <mrpt/math/CVectorDynamic.h>
@@ -16,7 +17,7 @@
 #include <mrpt/obs/obs_frwds.h>
 #include <mrpt/system/CTimeLogger.h>
 
-#include <future>
+#include <memory>
 
 namespace mrpt
 {
@@ -27,6 +28,11 @@ namespace detectors
  * Methods and variables labeled as experimentals are temporals (for debug or
  * testing
  * purposes) and may disappear in future versions.
+ *
+ * With 3D range scans, the candidates of the cascade classifier are checked
+ * against the 3D points of their regions. With the option `multithread`,
+ * all the candidates of each frame are validated in parallel, each one in a
+ * different thread (except while taking measurements or execution times).
  * \ingroup mrpt_detectors_grp
  */
 class CFaceDetection : public CObjectDetection
@@ -47,7 +53,11 @@ class CFaceDetection : public CObjectDetection
 	struct TOptions
 	{
 		int confidenceThreshold;
+		/** Validate the candidates of each frame in parallel */
 		bool multithread;
+		/** Number of threads for `multithread` (0: as many as hardware
+		 * threads). \note (New in MRPT 2.4.9) */
+		int numThreads{0};
 
 		bool useCovFilter;
 		bool useRegionsFilter;
@@ -77,45 +87,8 @@ class CFaceDetection : public CObjectDetection
 		unsigned int& falsePositivesDeleted, unsigned int& realFacesDeleted);
 
    private:
-	/** Thread that execute checkIfFaceRegions filter */
-	std::thread m_thread_checkIfFaceRegions;
-	/** Thread that execute checkIfFacePlaneCov filter */
-	std::thread m_thread_checkIfFacePlaneCov;
-	/** Thread that execute checkIfDiagonalSurface filter */
-	std::thread m_thread_checkIfDiagonalSurface;
-
-	/** Save result of checkIfFaceRegions filter */
-	bool m_checkIfFaceRegions_res;
-	/** Save result of checkIfFacePlaneCov filter */
-	bool m_checkIfFacePlaneCov_res;
-	/** Save result of checkIfDiagonalSurface filter */
-	bool m_checkIfDiagonalSurface_res;
-
-	/** Indicates to all threads that must finish their execution */
-	bool m_end_threads{false};
-
-	/** Indicates to thread_checkIfFaceRegions that exist a new face to analyze
-	 */
-	std::promise<void> m_enter_checkIfFaceRegions;
-	/** Indicates to thread_checkIfFacePlaneCov that exist a new face to analyze
-	 */
-	std::promise<void> m_enter_checkIfFacePlaneCov;
-	/** Indicates to thread_checkIfDiagonalSurface that exist a new face to
-	 * analyze */
-	std::promise<void> m_enter_checkIfDiagonalSurface;
-
-	/** Indicates to main thread that thread_checkIfFaceRegions has been
-	 * completed analisis of the last face detected */
-	std::promise<void> m_leave_checkIfFaceRegions;
-	/** Indicates to main thread that thread_checkIfFacePlaneCov has been
-	 * completed analisis of the last face detected */
-	std::promise<void> m_leave_checkIfFacePlaneCov;
-	/** Indicates to main thread that thread_checkIfDiagonalSurface has been
-	 * completed analisis of the last face detected */
-	std::promise<void> m_leave_checkIfDiagonalSurface;
-
-	/** Last face detected */
-	mrpt::obs::CObservation3DRangeScan m_lastFaceDetected;
+	/** Worker threads for `multithread` candidate validation */
+	std::unique_ptr<mrpt::WorkerThreadsPool> m_pool;
 
 	struct TMeasurement
 	{
@@ -149,28 +122,20 @@ class CFaceDetection : public CObjectDetection
 
 	bool checkIfFacePlaneCov(mrpt::obs::CObservation3DRangeScan* face);
 
-	void thread_checkIfFacePlaneCov();
-
-	static void dummy_checkIfFacePlaneCov(CFaceDetection* obj);
-
 	bool checkIfFaceRegions(mrpt::obs::CObservation3DRangeScan* face);
 
-	void thread_checkIfFaceRegions();
-
-	static void dummy_checkIfFaceRegions(CFaceDetection* obj);
+	/** Runs all the enabled filters on one candidate region.
+	 * \return false if it is not a face */
+	bool checkIfFace(mrpt::obs::CObservation3DRangeScan* face);
 
 	size_t checkRelativePosition(
 		const mrpt::math::TPoint3D& p1, const mrpt::math::TPoint3D& p2,
 		const mrpt::math::TPoint3D& p, double& dist);
 
-	void thread_checkIfDiagonalSurface();
-
 	bool checkIfDiagonalSurface(mrpt::obs::CObservation3DRangeScan* face);
 
 	bool checkIfDiagonalSurface2(mrpt::obs::CObservation3DRangeScan* face);
 
-	static void dummy_checkIfDiagonalSurface(CFaceDetection* obj);
-
 	// Experimental methods to view 3D points
 
 	void experimental_viewFacePointsScanned(
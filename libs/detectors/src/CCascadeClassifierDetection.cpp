@@ -17,6 +17,7 @@
 // Universal include for all versions of OpenCV
 #include <mrpt/3rdparty/do_opencv_includes.h>
 
+#include <algorithm>
 #include <thread>
 
 using namespace mrpt::detectors;
@@ -52,7 +53,10 @@ CCascadeClassifierDetection::CCascadeClassifierDetection()
 CCascadeClassifierDetection::~CCascadeClassifierDetection()
 {
 #if MRPT_HAS_OPENCV && MRPT_OPENCV_VERSION_NUM >= 0x200
+	m_pool.reset();
 	delete CASCADE;
+	for (void* c : m_threadCascades)
+		delete reinterpret_cast<CascadeClassifier*>(c);
 #endif
 }
 
@@ -73,6 +77,23 @@ void CCascadeClassifierDetection::init(
 		config.read_int("DetectionOptions", "minNeighbors", 3);
 	m_options.flags = config.read_int("DetectionOptions", "flags", 0);
 	m_options.minSize = config.read_int("DetectionOptions", "minSize", 30);
+	m_options.maxSize = config.read_int("DetectionOptions", "maxSize", 0);
+	m_options.numThreads =
+		config.read_int("DetectionOptions", "numThreads", 1);
+	m_options.trackROIs =
+		config.read_bool("DetectionOptions", "trackROIs", false);
+	m_options.roiMargin =
+		config.read_double("DetectionOptions", "roiMargin", 0.5);
+	m_options.fullFrameEvery =
+		config.read_int("DetectionOptions", "fullFrameEvery", 10);
+	ASSERT_GT_(m_options.scaleFactor, 1.0);
+
+	m_pool.reset();
+	delete CASCADE;
+	for (void* c : m_threadCascades)
+		delete reinterpret_cast<CascadeClassifier*>(c);
+	m_threadCascades.clear();
+	resetTracking();
 
 	m_cascade = new CascadeClassifier();
 
@@ -81,9 +102,32 @@ void CCascadeClassifierDetection::init(
 
 	// Check if cascade is empty
 	if (CASCADE->empty()) throw std::runtime_error("Incorrect cascade file.");
+
+	// One more classifier for each additional thread:
+	const size_t nThreads = m_options.numThreads > 0
+		? static_cast<size_t>(m_options.numThreads)
+		: std::max(1U, std::thread::hardware_concurrency());
+	m_freeCascades.clear();
+	m_freeCascades.push_back(0);
+	for (size_t i = 1; i < nThreads; i++)
+	{
+		auto c = new CascadeClassifier();
+		c->load(m_options.cascadeFileName);
+		m_threadCascades.push_back(c);
+		m_freeCascades.push_back(i);
+	}
+	if (nThreads > 1)
+		m_pool = std::make_unique<mrpt::WorkerThreadsPool>(
+			nThreads - 1, mrpt::WorkerThreadsPool::POLICY_FIFO, "cascade");
 #endif
 }
 
+void CCascadeClassifierDetection::resetTracking()
+{
+	m_lastDetections.clear();
+	m_framesSinceFullSearch = 0;
+}
+
 // ------------------------------------------------------
 //				detectObjects (*CObservation)
 // ------------------------------------------------------
@@ -116,18 +160,164 @@ void CCascadeClassifierDetection::detectObjects_Impl(
 		return;
 	}
 
-	vector<Rect> objects;
-
 	// Some needed preprocessing
 	const CImage img_gray(*img, FAST_REF_OR_CONVERT_TO_GRAY);
 
 	// Convert to IplImage and copy it
 	const cv::Mat& image = img_gray.asCvMatRef();
+	const Rect imageRect(0, 0, image.cols, image.rows);
+
+	const Size minSize(m_options.minSize, m_options.minSize);
+	const Size maxSize = m_options.maxSize > 0
+		? Size(m_options.maxSize, m_options.maxSize)
+		: Size();
+
+	// Each search: an image region and a range of object sizes, with the
+	// candidates grouped or not:
+	struct TSearch
+	{
+		Rect roi;
+		Size minSize, maxSize;
+		bool group = true;
+	};
+	std::vector<TSearch> searches;
+
+	const bool useROIs = m_options.trackROIs && !m_lastDetections.empty() &&
+		(m_options.fullFrameEvery <= 0 ||
+		 m_framesSinceFullSearch + 1 < m_options.fullFrameEvery);
+	if (useROIs)
+	{
+		// Enlarged previous detections, merging the overlapping ones:
+		std::vector<Rect> rois;
+		for (const auto& d : m_lastDetections)
+		{
+			const int mx = cvRound(d.width * m_options.roiMargin);
+			const int my = cvRound(d.height * m_options.roiMargin);
+			const Rect r =
+				Rect(d.x - mx, d.y - my, d.width + 2 * mx, d.height + 2 * my) &
+				imageRect;
+			if (r.area() > 0) rois.push_back(r);
+		}
+		for (bool merged = true; merged;)
+		{
+			merged = false;
+			for (size_t i = 0; i < rois.size() && !merged; i++)
+				for (size_t j = i + 1; j < rois.size() && !merged; j++)
+					if ((rois[i] & rois[j]).area() > 0)
+					{
+						rois[i] = rois[i] | rois[j];
+						rois.erase(rois.begin() + j);
+						merged = true;
+					}
+		}
+		for (const auto& r : rois)
+			searches.push_back({r, minSize, maxSize, true});
+		m_framesSinceFullSearch++;
+	}
+	else if (m_pool && m_options.flags == 0)
+	{
+		// Split the scales of a full image search into bands of similar cost.
+		// The candidates of all bands are grouped at once afterwards, so the
+		// result is the same than with one single search. Window sizes and
+		// the end condition follow CascadeClassifier::detectMultiScale():
+		const Size win = CASCADE->getOriginalWindowSize();
+		std::vector<Size> sizes;
+		std::vector<double> costs;
+		for (double f = 1;; f *= m_options.scaleFactor)
+		{
+			const Size ws(cvRound(win.width * f), cvRound(win.height * f));
+			const Size scaled(
+				cvRound(image.cols / f), cvRound(image.rows / f));
+			if (scaled.width <= win.width || scaled.height <= win.height)
+				break;
+			if (maxSize.width > 0 &&
+				(ws.width > maxSize.width || ws.height > maxSize.height))
+				break;
+			if (ws.width < minSize.width || ws.height < minSize.height)
+				continue;
+			sizes.push_back(ws);
+			costs.push_back(double(scaled.width) * scaled.height);
+		}
+
+		double totalCost = 0;
+		for (double c : costs)
+			totalCost += c;
+		const size_t nBands = std::min(m_freeCascades.size(), sizes.size());
+		double accumCost = 0;
+		size_t first = 0;
+		for (size_t i = 0; i < sizes.size(); i++)
+		{
+			accumCost += costs[i];
+			// Bands can only be split where sizes grow in both dimensions:
+			const bool last = i + 1 == sizes.size();
+			if (!last &&
+				(accumCost < totalCost * (searches.size() + 1) / nBands ||
+				 sizes[i + 1].width <= sizes[i].width ||
+				 sizes[i + 1].height <= sizes[i].height))
+				continue;
+			searches.push_back({imageRect, sizes[first], sizes[i], false});
+			first = i + 1;
+		}
+		m_framesSinceFullSearch = 0;
+	}
+	else
+	{
+		searches.push_back({imageRect, minSize, maxSize, true});
+		m_framesSinceFullSearch = 0;
+	}
+
+	std::vector<std::vector<Rect>> results(searches.size());
+	auto lmbSearch = [&](size_t i) {
+		size_t idx;
+		{
+			std::lock_guard<std::mutex> lck(m_freeCascadesMtx);
+			ASSERT_(!m_freeCascades.empty());
+			idx = m_freeCascades.back();
+			m_freeCascades.pop_back();
+		}
+		auto* cascade = idx == 0
+			? CASCADE
+			: reinterpret_cast<CascadeClassifier*>(m_threadCascades[idx - 1]);
+
+		const auto& s = searches[i];
+		try
+		{
+			cascade->detectMultiScale(
+				image(s.roi), results[i], m_options.scaleFactor,
+				s.group ? m_options.minNeighbors : 0, m_options.flags,
+				s.minSize, s.maxSize);
+		}
+		catch (...)
+		{
+			std::lock_guard<std::mutex> lck(m_freeCascadesMtx);
+			m_freeCascades.push_back(idx);
+			throw;
+		}
+		for (auto& r : results[i])
+			r += s.roi.tl();
+
+		std::lock_guard<std::mutex> lck(m_freeCascadesMtx);
+		m_freeCascades.push_back(idx);
+	};
+
+	if (m_pool && searches.size() > 1)
+		m_pool->parallel_for(0, searches.size(), 1, lmbSearch);
+	else
+		for (size_t i = 0; i < searches.size(); i++)
+			lmbSearch(i);
+
+	vector<Rect> objects;
+	bool mustGroup = false;
+	for (size_t i = 0; i < searches.size(); i++)
+	{
+		objects.insert(objects.end(), results[i].begin(), results[i].end());
+		mustGroup = mustGroup || !searches[i].group;
+	}
+	if (mustGroup) cv::groupRectangles(objects, m_options.minNeighbors, 0.2);
 
-	// Detect objects
-	CASCADE->detectMultiScale(
-		image, objects, m_options.scaleFactor, m_options.minNeighbors,
-		m_options.flags, Size(m_options.minSize, m_options.minSize));
+	m_lastDetections.clear();
+	for (const auto& r : objects)
+		m_lastDetections.push_back({r.x, r.y, r.width, r.height});
 
 	unsigned int N = objects.size();
 	// detected.resize( N );
@@ -27,7 +27,9 @@
 #include <mrpt/slam/CMetricMapsAlignmentAlgorithm.h>
 
 #include <Eigen/Dense>
+#include <algorithm>
 #include <fstream>
+#include <thread>
 
 using namespace std;
 using namespace mrpt;
@@ -57,20 +59,7 @@ CFaceDetection::CFaceDetection()
 //------------------------------------------------------------------------
 //							~CFaceDetection
 //------------------------------------------------------------------------
-CFaceDetection::~CFaceDetection()
-{
-	// Stop filters threads
-
-	m_end_threads = true;
-
-	m_enter_checkIfFacePlaneCov.set_value();
-	m_enter_checkIfFaceRegions.set_value();
-	m_enter_checkIfDiagonalSurface.set_value();
-
-	m_thread_checkIfFaceRegions.join();
-	m_thread_checkIfFacePlaneCov.join();
-	m_thread_checkIfDiagonalSurface.join();
-}
+CFaceDetection::~CFaceDetection() = default;
 
 //------------------------------------------------------------------------
 //								init
@@ -106,23 +95,18 @@ void CFaceDetection::init(const mrpt::config::CConfigFileBase& cfg)
 	m_measure.saveMeasurementsToFile =
 		cfg.read_bool("FaceDetection", "saveMeasurementsToFile", false);
 
-	// Run filters threads
+	m_options.numThreads = cfg.read_int("FaceDetection", "numThreads", 0);
+
+	// Worker threads for the validation of candidates:
+	m_pool.reset();
 	if (m_options.multithread)
 	{
-		if (m_options.useRegionsFilter)
-			m_thread_checkIfFaceRegions =
-				std::thread(dummy_checkIfFaceRegions, this);
-		if (m_options.useCovFilter)
-			m_thread_checkIfFacePlaneCov =
-				std::thread(dummy_checkIfFacePlaneCov, this);
-		if (m_options.useSizeDistanceRelationFilter ||
-			m_options.useDiagonalDistanceFilter)
-			m_thread_checkIfDiagonalSurface =
-				std::thread(dummy_checkIfDiagonalSurface, this);
-
-		m_checkIfFacePlaneCov_res = false;
-		m_checkIfFaceRegions_res = true;
-		m_checkIfDiagonalSurface_res = true;
+		const size_t nThreads = m_options.numThreads > 0
+			? static_cast<size_t>(m_options.numThreads)
+			: std::max(1U, std::thread::hardware_concurrency());
+		if (nThreads > 1)
+			m_pool = std::make_unique<mrpt::WorkerThreadsPool>(
+				nThreads - 1, mrpt::WorkerThreadsPool::POLICY_FIFO, "faces");
 	}
 
 	cascadeClassifier.init(cfg);
@@ -167,12 +151,10 @@ void CFaceDetection::detectObjects_Impl(
 
 		if (o.hasPoints3D)
 		{
-			// Vector to save detected objects to delete if they aren't a face
-			vector<size_t> deleteDetected;
-
-			// Check if all possible detected faces satisfy a serial of
-			// constrains
-			for (unsigned int i = 0; i < localDetected.size(); i++)
+			// Extract the 3D data of all the candidates:
+			const size_t nCandidates = localDetected.size();
+			std::vector<CObservation3DRangeScan> faces(nCandidates);
+			for (size_t i = 0; i < nCandidates; i++)
 			{
 				CDetectable2D::Ptr rec =
 					std::dynamic_pointer_cast<CDetectable2D>(localDetected[i]);
@@ -183,112 +165,48 @@ void CFaceDetection::detectObjects_Impl(
 				unsigned int c1 = rec->m_x;
 				unsigned int c2 = rec->m_x + rec->m_width;
 
-				o.getZoneAsObs(m_lastFaceDetected, r1, r2, c1, c2);
+				o.getZoneAsObs(faces[i], r1, r2, c1, c2);
+			}
 
-				if (m_options.multithread)
-				{
-					// To obtain experimental results
-					{
-						if (m_measure.takeTime)
-							m_timeLog.enter("Multithread filters application");
-					}
+			// Check if all possible detected faces satisfy a serial of
+			// constrains. Measurements and times are not thread-safe, so
+			// candidates are checked in parallel only without them:
+			std::vector<uint8_t> isFace(nCandidates, 1);
+			const bool parallel = m_pool && nCandidates > 1 &&
+				!m_measure.takeMeasures && !m_measure.takeTime;
 
-					// Semaphores signal
-					if (m_options.useCovFilter)
-						m_enter_checkIfFacePlaneCov.set_value();
-					if (m_options.useRegionsFilter)
-						m_enter_checkIfFaceRegions.set_value();
-					if (m_options.useSizeDistanceRelationFilter ||
-						m_options.useDiagonalDistanceFilter)
-						m_enter_checkIfDiagonalSurface.set_value();
-
-					// Semaphores wait
-					if (m_options.useCovFilter)
-						m_leave_checkIfFacePlaneCov.get_future().wait();
-					if (m_options.useRegionsFilter)
-						m_leave_checkIfFaceRegions.get_future().wait();
-					if (m_options.useSizeDistanceRelationFilter ||
-						m_options.useDiagonalDistanceFilter)
-						m_leave_checkIfDiagonalSurface.get_future().wait();
-
-					// Check resutls
-					if (!m_checkIfFacePlaneCov_res ||
-						!m_checkIfFaceRegions_res ||
-						!m_checkIfDiagonalSurface_res)
-						deleteDetected.push_back(i);
-
-					// To obtain experimental results
-					{
-						if (m_measure.takeTime)
-							m_timeLog.leave("Multithread filters application");
-					}
+			// To obtain experimental results
+			{
+				if (m_measure.takeTime)
+					m_timeLog.enter("Filters application");
+			}
 
-					m_measure.faceNum++;
-				}
-				else
+			const int firstFaceNum = m_measure.faceNum;
+			if (parallel)
+				m_pool->parallel_for(0, nCandidates, 1, [&](size_t i) {
+					isFace[i] = checkIfFace(&faces[i]) ? 1 : 0;
+				});
+			else
+				for (size_t i = 0; i < nCandidates; i++)
 				{
-					// To obtain experimental results
-					{
-						if (m_measure.takeTime)
-							m_timeLog.enter("Secuential filters application");
-					}
-
-					/////////////////////////////////////////////////////
-					// CMatrixDynamic<bool> region;
-					// experimental_segmentFace( m_lastFaceDetected,  region);
-					/////////////////////////////////////////////////////
-
-					// m_lastFaceDetected.intensityImage.saveToFile(format("%i.jpg",m_measure.faceNum));
-
-					bool remove = false;
-
-					// First check if we can adjust a plane to detected region
-					// as face, if yes it isn't a face!
-					if (m_options.useCovFilter &&
-						!checkIfFacePlaneCov(&m_lastFaceDetected))
-					{
-						deleteDetected.push_back(i);
-						remove = true;
-					}
-					else if (
-						m_options.useRegionsFilter &&
-						!checkIfFaceRegions(&m_lastFaceDetected))
-					{
-						deleteDetected.push_back(i);
-						remove = true;
-					}
-					else if (
-						(m_options.useSizeDistanceRelationFilter ||
-						 m_options.useDiagonalDistanceFilter) &&
-						!checkIfDiagonalSurface(&m_lastFaceDetected))
-					{
-						deleteDetected.push_back(i);
-						remove = true;
-					}
-
-					if (remove)
-					{
-						/*ofstream f;
-						f.open("deleted.txt", ofstream::app);
-						f << "Deleted: " << m_measure.faceNum << endl;
-						f.close();*/
-						m_measure.deletedRegions.push_back(m_measure.faceNum);
-					}
-
+					isFace[i] = checkIfFace(&faces[i]) ? 1 : 0;
 					m_measure.faceNum++;
-
-					// To obtain experimental results
-					{
-						if (m_measure.takeTime)
-							m_timeLog.leave("Secuential filters application");
-					}
 				}
+			m_measure.faceNum = firstFaceNum + static_cast<int>(nCandidates);
+
+			// To obtain experimental results
+			{
+				if (m_measure.takeTime) m_timeLog.leave("Filters application");
 			}
 
 			// Delete non faces
-			for (unsigned int i = deleteDetected.size(); i > 0; i--)
-				localDetected.erase(
-					localDetected.begin() + deleteDetected[i - 1]);
+			for (size_t i = nCandidates; i > 0; i--)
+			{
+				if (isFace[i - 1]) continue;
+				m_measure.deletedRegions.push_back(
+					firstFaceNum + static_cast<int>(i - 1));
+				localDetected.erase(localDetected.begin() + (i - 1));
+			}
 		}
 
 		// Convert 2d detected objects to 3d
@@ -318,6 +236,22 @@ void CFaceDetection::detectObjects_Impl(
 	MRPT_END
 }
 
+//------------------------------------------------------------------------
+//  						checkIfFace
+//------------------------------------------------------------------------
+bool CFaceDetection::checkIfFace(CObservation3DRangeScan* face)
+{
+	// First check if we can adjust a plane to detected region as face, if yes
+	// it isn't a face!
+	if (m_options.useCovFilter && !checkIfFacePlaneCov(face)) return false;
+	if (m_options.useRegionsFilter && !checkIfFaceRegions(face)) return false;
+	if ((m_options.useSizeDistanceRelationFilter ||
+		 m_options.useDiagonalDistanceFilter) &&
+		!checkIfDiagonalSurface(face))
+		return false;
+	return true;
+}
+
 //------------------------------------------------------------------------
 //  						checkIfFacePlane
 //------------------------------------------------------------------------
@@ -350,26 +284,6 @@ bool CFaceDetection::checkIfFacePlane(CObservation3DRangeScan* face)
 	return false;
 }
 
-void CFaceDetection::dummy_checkIfFacePlaneCov(CFaceDetection* obj)
-{
-	obj->thread_checkIfFacePlaneCov();
-}
-
-void CFaceDetection::thread_checkIfFacePlaneCov()
-{
-	for (;;)
-	{
-		m_enter_checkIfFacePlaneCov.get_future().wait();
-
-		if (m_end_threads) break;
-
-		// Perform filter
-		m_checkIfFacePlaneCov_res = checkIfFacePlaneCov(&m_lastFaceDetected);
-
-		m_leave_checkIfFacePlaneCov.set_value();
-	}
-}
-
 //------------------------------------------------------------------------
 //  					 checkIfFacePlaneCov
 //------------------------------------------------------------------------
@@ -476,26 +390,6 @@ bool CFaceDetection::checkIfFacePlaneCov(CObservation3DRangeScan* face)
 	MRPT_TRY_END
 }
 
-void CFaceDetection::dummy_checkIfFaceRegions(CFaceDetection* obj)
-{
-	obj->thread_checkIfFaceRegions();
-}
-
-void CFaceDetection::thread_checkIfFaceRegions()
-{
-	for (;;)
-	{
-		m_enter_checkIfFaceRegions.get_future().wait();
-
-		if (m_end_threads) break;
-
-		// Perform filter
-		m_checkIfFaceRegions_res = checkIfFaceRegions(&m_lastFaceDetected);
-
-		m_leave_checkIfFaceRegions.set_value();
-	}
-}
-
 //------------------------------------------------------------------------
 //							checkIfFaceRegions
 //------------------------------------------------------------------------
@@ -826,27 +720,6 @@ size_t CFaceDetection::checkRelativePosition(
 		return 1;
 }
 
-void CFaceDetection::dummy_checkIfDiagonalSurface(CFaceDetection* obj)
-{
-	obj->thread_checkIfDiagonalSurface();
-}
-
-void CFaceDetection::thread_checkIfDiagonalSurface()
-{
-	for (;;)
-	{
-		m_enter_checkIfDiagonalSurface.get_future().wait();
-
-		if (m_end_threads) break;
-
-		// Perform filter
-		m_checkIfDiagonalSurface_res =
-			checkIfDiagonalSurface(&m_lastFaceDetected);
-
-		m_leave_checkIfDiagonalSurface.set_value();
-	}
-}
-
 //------------------------------------------------------------------------
 //							checkIfDiagonalSurface
 //------------------------------------------------------------------------
@@ -1680,8 +1553,7 @@ void CFaceDetection::experimental_segmentFace(
 	mrpt::img::CImage img;
 	// Normalize the image
 	const Eigen::MatrixXf range2D =
-		m_lastFaceDetected.rangeImage.asEigen().cast<float>() *
-		m_lastFaceDetected.rangeUnits * (1.0f / 5);
+		face.rangeImage.asEigen().cast<float>() * face.rangeUnits * (1.0f / 5);
 	img.setFromMatrix(range2D);
 
 	// INITIALIZATION
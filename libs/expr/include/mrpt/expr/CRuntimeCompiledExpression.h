@@ -12,6 +12,7 @@
 
 #include <map>
 #include <memory>
+#include <cstddef>
 #include <string>
 
 #include "mrpt-expr_export.h"
@@ -97,6 +98,39 @@ class MRPT_EXPR_EXPORT CRuntimeCompiledExpression
 	 */
 	double eval() const;
 
+	/** Evaluates the precompiled formula for `N` sets of values of its
+	 * variables at once, given as arrays, e.g. `{{"x", xs}, {"y", ys}}`, and
+	 * stores the results in `out[0]`...`out[N-1]`. Variables not in `arrays`
+	 * keep the value they have when this method is called.
+	 *
+	 * Formulas made up of arithmetic operators (`+ - * / % ^`), numbers,
+	 * variables and the common math functions (`sin`, `cos`, `tan`, `asin`,
+	 * `acos`, `atan`, `atan2`, `sinh`, `cosh`, `tanh`, `exp`, `log`, `log10`,
+	 * `sqrt`, `abs`, `floor`, `ceil`, `min`, `max`) are evaluated by a
+	 * vectorized interpreter over blocks of elements, much faster than
+	 * calling eval() `N` times. Any other formula (conditionals, loops,...)
+	 * is evaluated by exprtk element by element. See is_batch_vectorized().
+	 * Results may differ from eval() in the last bits due to rounding.
+	 *
+	 * The bound variables are left unchanged, and `MRPT_EXPR_VERBOSE` is not
+	 * taken into account by this method.
+	 *
+	 * \exception std::runtime_error If the formula has not been compiled yet,
+	 * or a name in `arrays` is not a variable of the formula.
+	 * 
+ote (New in MRPT 2.4.9)
+	 */
+	void eval_batch(
+		const std::map<std::string, const double*>& arrays, double* out,
+		size_t N) const;
+
+	/** Returns true if eval_batch() evaluates this formula with the
+	 * vectorized interpreter, false if it calls exprtk for each element.
+	 * 
+ote (New in MRPT 2.4.9)
+	 */
+	bool is_batch_vectorized() const;
+
 	/** Returns true if compile() was called and ended without errors. */
 	bool is_compiled() const;
 	/** Returns the original formula passed to compile(), or an empty string if
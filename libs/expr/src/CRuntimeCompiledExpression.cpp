@@ -13,9 +13,13 @@
 #include <mrpt/expr/CRuntimeCompiledExpression.h>
 #include <mrpt/system/string_utils.h>
 
-#include <cmath>  // M_PI
+#include <algorithm>
+#include <cctype>
+#include <cmath>	// M_PI
 #include <cstdlib>
+#include <functional>
 #include <iostream>
+#include <optional>
 
 #define exprtk_disable_string_capabilities	// Workaround a bug in Ubuntu
 // precise's GCC+libstdc++
@@ -57,12 +61,429 @@ struct CRuntimeCompiledExpression::ExprVerbose
 	}
 };
 
+namespace
+{
+// Number of elements evaluated at once by each instruction of a
+// TBatchProgram, small enough for the stack of blocks to stay in cache:
+constexpr size_t BATCH_BLOCK = 256;
+
+using func1_t = double (*)(double);
+using func2_t = double (*)(double, double);
+
+enum class BatchOp : uint8_t
+{
+	Var,
+	Const,
+	Neg,
+	Add,
+	Sub,
+	Mul,
+	Div,
+	Mod,
+	Pow,
+	IntPow,
+	Func1,
+	Func2
+};
+
+struct TBatchInstr
+{
+	BatchOp op = BatchOp::Const;
+	size_t var = 0;	 //!< Var: index in TBatchProgram::vars
+	double value = 0;  //!< Const
+	int exponent = 0;  //!< IntPow
+	func1_t f1 = nullptr;
+	func2_t f2 = nullptr;
+};
+
+/** A formula in postfix order, evaluated over a stack of blocks of values */
+struct TBatchProgram
+{
+	std::vector<TBatchInstr> code;
+	/** Storage of the variables used in the formula */
+	std::vector<const double*> vars;
+	size_t maxStack = 0;
+};
+
+const std::map<std::string, func1_t>& batchFunctions1()
+{
+	static const std::map<std::string, func1_t> fs = {
+		{"abs", [](double x) { return std::abs(x); }},
+		{"acos", [](double x) { return std::acos(x); }},
+		{"asin", [](double x) { return std::asin(x); }},
+		{"atan", [](double x) { return std::atan(x); }},
+		{"ceil", [](double x) { return std::ceil(x); }},
+		{"cos", [](double x) { return std::cos(x); }},
+		{"cosh", [](double x) { return std::cosh(x); }},
+		{"exp", [](double x) { return std::exp(x); }},
+		{"floor", [](double x) { return std::floor(x); }},
+		{"log", [](double x) { return std::log(x); }},
+		{"log10", [](double x) { return std::log10(x); }},
+		{"sin", [](double x) { return std::sin(x); }},
+		{"sinh", [](double x) { return std::sinh(x); }},
+		{"sqrt", [](double x) { return std::sqrt(x); }},
+		{"tan", [](double x) { return std::tan(x); }},
+		{"tanh", [](double x) { return std::tanh(x); }}};
+	return fs;
+}
+
+/** Recursive-descent parser of the subset of exprtk formulas that can be
+ * evaluated by a TBatchProgram, with the same operator precedence and
+ * associativity than exprtk. compile() returns false for any other formula.
+ */
+class BatchCompiler
+{
+   public:
+	using lookup_t = std::function<const double*(const std::string&)>;
+
+	BatchCompiler(const std::string& s, lookup_t lookup)
+		: m_s(s), m_lookup(std::move(lookup))
+	{
+	}
+
+	bool compile(TBatchProgram& p)
+	{
+		p = TBatchProgram();
+		m_prog = &p;
+		if (!parseSum()) return false;
+		return peek() == '\0' && !p.code.empty();
+	}
+
+   private:
+	const std::string& m_s;
+	lookup_t m_lookup;
+	TBatchProgram* m_prog = nullptr;
+	size_t m_pos = 0, m_depth = 0;
+
+	char peek()
+	{
+		while (m_pos < m_s.size() &&
+			   std::isspace(static_cast<unsigned char>(m_s[m_pos])))
+			m_pos++;
+		return m_pos < m_s.size() ? m_s[m_pos] : '\0';
+	}
+	bool accept(char c)
+	{
+		if (peek() != c) return false;
+		m_pos++;
+		return true;
+	}
+
+	void push(const TBatchInstr& ins)
+	{
+		switch (ins.op)
+		{
+			case BatchOp::Var:
+			case BatchOp::Const:
+				m_prog->maxStack = std::max(m_prog->maxStack, ++m_depth);
+				break;
+			case BatchOp::Add:
+			case BatchOp::Sub:
+			case BatchOp::Mul:
+			case BatchOp::Div:
+			case BatchOp::Mod:
+			case BatchOp::Pow:
+			case BatchOp::Func2: m_depth--; break;
+			default: break;
+		};
+		m_prog->code.push_back(ins);
+	}
+	void push(BatchOp op)
+	{
+		TBatchInstr ins;
+		ins.op = op;
+		push(ins);
+	}
+
+	// sum := product (('+'|'-') product)*
+	bool parseSum()
+	{
+		if (!parseProduct()) return false;
+		for (;;)
+		{
+			BatchOp op;
+			if (accept('+')) op = BatchOp::Add;
+			else if (accept('-'))
+				op = BatchOp::Sub;
+			else
+				return true;
+			if (!parseProduct()) return false;
+			push(op);
+		}
+	}
+	// product := unary (('*'|'/'|'%') unary)*
+	bool parseProduct()
+	{
+		if (!parseUnary()) return false;
+		for (;;)
+		{
+			BatchOp op;
+			if (accept('*')) op = BatchOp::Mul;
+			else if (accept('/'))
+				op = BatchOp::Div;
+			else if (accept('%'))
+				op = BatchOp::Mod;
+			else
+				return true;
+			if (!parseUnary()) return false;
+			push(op);
+		}
+	}
+	// unary := ('-'|'+') unary | power
+	bool parseUnary()
+	{
+		if (accept('+')) return parseUnary();
+		if (!accept('-')) return parsePower();
+
+		const size_t start = m_prog->code.size();
+		if (!parseUnary()) return false;
+		auto& code = m_prog->code;
+		if (code.size() == start + 1 && code.back().op == BatchOp::Const)
+			code.back().value = -code.back().value;
+		else
+			push(BatchOp::Neg);
+		return true;
+	}
+	// power := primary ['^' unary]  (right associative, as in exprtk)
+	bool parsePower()
+	{
+		if (!parsePrimary()) return false;
+		if (!accept('^')) return true;
+
+		const size_t start = m_prog->code.size();
+		if (!parseUnary()) return false;
+		auto& code = m_prog->code;
+		if (code.size() == start + 1 && code.back().op == BatchOp::Const &&
+			code.back().value == std::round(code.back().value) &&
+			std::abs(code.back().value) <= 64)
+		{
+			TBatchInstr ins;
+			ins.op = BatchOp::IntPow;
+			ins.exponent = static_cast<int>(code.back().value);
+			code.pop_back();
+			m_depth--;
+			push(ins);
+		}
+		else
+			push(BatchOp::Pow);
+		return true;
+	}
+	// primary := number | '(' sum ')' | function '(' args ')' | variable
+	bool parsePrimary()
+	{
+		const char c = peek();
+		if (c == '(')
+		{
+			m_pos++;
+			return parseSum() && accept(')');
+		}
+		if (std::isdigit(static_cast<unsigned char>(c)) || c == '.')
+		{
+			const char* start = m_s.c_str() + m_pos;
+			char* end = nullptr;
+			TBatchInstr ins;
+			ins.value = std::strtod(start, &end);
+			if (end == start ||
+				std::find_if(start, static_cast<const char*>(end), [](char ch) {
+					return ch == 'x' || ch == 'X';
+				}) != end)
+				return false;  // e.g. hexadecimal numbers
+			m_pos += end - start;
+			push(ins);
+			return true;
+		}
+		if (!std::isalpha(static_cast<unsigned char>(c)) && c != '_')
+			return false;
+
+		std::string name;
+		while (m_pos < m_s.size() &&
+			   (std::isalnum(static_cast<unsigned char>(m_s[m_pos])) ||
+				m_s[m_pos] == '_'))
+			name += m_s[m_pos++];
+
+		if (peek() == '(')
+		{
+			m_pos++;
+			return parseFunction(mrpt::system::lowerCase(name));
+		}
+
+		const double* v = m_lookup(name);
+		if (!v) return false;
+		auto& vars = m_prog->vars;
+		TBatchInstr ins;
+		ins.op = BatchOp::Var;
+		ins.var = std::find(vars.begin(), vars.end(), v) - vars.begin();
+		if (ins.var == vars.size()) vars.push_back(v);
+		push(ins);
+		return true;
+	}
+	// The opening parenthesis is already parsed
+	bool parseFunction(const std::string& name)
+	{
+		const auto& fs1 = batchFunctions1();
+		if (auto it = fs1.find(name); it != fs1.end())
+		{
+			if (!parseSum() || !accept(')')) return false;
+			TBatchInstr ins;
+			ins.op = BatchOp::Func1;
+			ins.f1 = it->second;
+			push(ins);
+			return true;
+		}
+
+		TBatchInstr ins;
+		ins.op = BatchOp::Func2;
+		bool variadic = false;
+		if (name == "atan2")
+			ins.f2 = [](double y, double x) { return std::atan2(y, x); };
+		else if (name == "min")
+		{
+			ins.f2 = [](double a, double b) { return std::min(a, b); };
+			variadic = true;
+		}
+		else if (name == "max")
+		{
+			ins.f2 = [](double a, double b) { return std::max(a, b); };
+			variadic = true;
+		}
+		else
+			return false;
+
+		if (!parseSum() || !accept(',') || !parseSum()) return false;
+		push(ins);
+		while (variadic && accept(','))
+		{
+			if (!parseSum()) return false;
+			push(ins);
+		}
+		return accept(')');
+	}
+};
+
+double intPow(double x, int n)
+{
+	unsigned int e = static_cast<unsigned int>(n < 0 ? -n : n);
+	double r = 1.0;
+	while (e)
+	{
+		if (e & 1) r *= x;
+		x *= x;
+		e >>= 1;
+	}
+	return n < 0 ? 1.0 / r : r;
+}
+
+/** Evaluates a program, given the data of each variable as an array, or
+ * nullptr for variables with one single value. */
+void runBatchProgram(
+	const TBatchProgram& p, const std::vector<const double*>& arrays,
+	double* out, size_t N)
+{
+	std::vector<double> scalars(p.vars.size());
+	for (size_t i = 0; i < p.vars.size(); i++)
+		scalars[i] = *p.vars[i];
+
+	std::vector<double> stack(p.maxStack * BATCH_BLOCK);
+	auto blk = [&stack](size_t i) { return stack.data() + i * BATCH_BLOCK; };
+
+	for (size_t i0 = 0; i0 < N; i0 += BATCH_BLOCK)
+	{
+		const size_t n = std::min(BATCH_BLOCK, N - i0);
+		size_t top = 0;	 // Number of blocks in the stack
+		for (const auto& ins : p.code)
+		{
+			if (ins.op == BatchOp::Var || ins.op == BatchOp::Const)
+			{
+				double* r = blk(top++);
+				if (ins.op == BatchOp::Const) std::fill(r, r + n, ins.value);
+				else if (arrays[ins.var])
+					std::copy(arrays[ins.var] + i0, arrays[ins.var] + i0 + n, r);
+				else
+					std::fill(r, r + n, scalars[ins.var]);
+				continue;
+			}
+
+			double* a = blk(top - 1);
+			switch (ins.op)
+			{
+				case BatchOp::Neg:
+					for (size_t i = 0; i < n; i++)
+						a[i] = -a[i];
+					continue;
+				case BatchOp::IntPow:
+					if (ins.exponent == 2)
+						for (size_t i = 0; i < n; i++)
+							a[i] = a[i] * a[i];
+					else
+						for (size_t i = 0; i < n; i++)
+							a[i] = intPow(a[i], ins.exponent);
+					continue;
+				case BatchOp::Func1:
+					for (size_t i = 0; i < n; i++)
+						a[i] = ins.f1(a[i]);
+					continue;
+				default: break;
+			};
+
+			// Binary operators:
+			a = blk(top - 2);
+			const double* b = blk(--top);
+			switch (ins.op)
+			{
+				case BatchOp::Add:
+					for (size_t i = 0; i < n; i++)
+						a[i] += b[i];
+					break;
+				case BatchOp::Sub:
+					for (size_t i = 0; i < n; i++)
+						a[i] -= b[i];
+					break;
+				case BatchOp::Mul:
+					for (size_t i = 0; i < n; i++)
+						a[i] *= b[i];
+					break;
+				case BatchOp::Div:
+					for (size_t i = 0; i < n; i++)
+						a[i] /= b[i];
+					break;
+				case BatchOp::Mod:
+					for (size_t i = 0; i < n; i++)
+						a[i] = std::fmod(a[i], b[i]);
+					break;
+				case BatchOp::Pow:
+					for (size_t i = 0; i < n; i++)
+						a[i] = std::pow(a[i], b[i]);
+					break;
+				case BatchOp::Func2:
+					for (size_t i = 0; i < n; i++)
+						a[i] = ins.f2(a[i], b[i]);
+					break;
+				default: THROW_EXCEPTION("Unexpected batch instruction");
+			};
+		}
+		std::copy(blk(0), blk(0) + n, out + i0);
+	}
+}
+}  // namespace
+
 // We only need this to be on this translation unit, hence the advantage of
 // using our MRPT wrapper instead of the original exprtk sources.
 struct CRuntimeCompiledExpression::Impl
 {
 	exprtk::expression<double> m_compiled_formula;
 	std::string m_original_expr_str;
+	/** All the symbol tables registered in m_compiled_formula, in order */
+	std::vector<exprtk::symbol_table<double>> m_symbol_tables;
+	/** The formula as a vectorized program, if it can be lowered into one */
+	std::optional<TBatchProgram> m_batch_program;
+
+	/** Storage of a variable or constant, or nullptr if not defined */
+	double* findVariable(const std::string& name) const
+	{
+		for (const auto& st : m_symbol_tables)
+			if (auto v = st.get_variable(name); v) return &v->ref();
+		return nullptr;
+	}
 };
 
 CRuntimeCompiledExpression::CRuntimeCompiledExpression()
@@ -95,14 +516,24 @@ void CRuntimeCompiledExpression::compile(
 	symbol_table.add_constants();
 
 	m_impl->m_compiled_formula.register_symbol_table(symbol_table);
+	m_impl->m_symbol_tables.push_back(symbol_table);
 
 	// Compile user-given expressions:
+	m_impl->m_batch_program.reset();
 	exprtk::parser<double> parser;
 	if (!parser.compile(expression, m_impl->m_compiled_formula))
 		THROW_EXCEPTION_FMT(
 			"Error compiling expression (name=`%s`): `%s`. Error: `%s`",
 			expr_name_for_error_reporting.c_str(), expression.c_str(),
 			parser.error().c_str());
+
+	// And lower it, if possible, for eval_batch():
+	const Impl& impl = *m_impl;
+	BatchCompiler bc(expression, [&impl](const std::string& name) {
+		return impl.findVariable(name);
+	});
+	TBatchProgram prog;
+	if (bc.compile(prog)) m_impl->m_batch_program = std::move(prog);
 }
 
 double CRuntimeCompiledExpression::eval() const
@@ -113,6 +544,62 @@ double CRuntimeCompiledExpression::eval() const
 	return ret;
 }
 
+void CRuntimeCompiledExpression::eval_batch(
+	const std::map<std::string, const double*>& arrays, double* out,
+	size_t N) const
+{
+	ASSERT_(m_impl);
+	ASSERTMSG_(is_compiled(), "eval_batch() called before compile()");
+	if (!N) return;
+	ASSERT_(out != nullptr);
+
+	// Find the storage of each variable given as an array:
+	std::vector<std::pair<double*, const double*>> bound;
+	for (const auto& a : arrays)
+	{
+		double* v = m_impl->findVariable(a.first);
+		if (!v)
+			THROW_EXCEPTION_FMT(
+				"eval_batch(): `%s` is not a variable of the expression `%s`",
+				a.first.c_str(), m_impl->m_original_expr_str.c_str());
+		ASSERT_(a.second != nullptr);
+		bound.emplace_back(v, a.second);
+	}
+
+	if (const auto& prog = m_impl->m_batch_program; prog)
+	{
+		std::vector<const double*> varArrays(prog->vars.size(), nullptr);
+		for (const auto& b : bound)
+		{
+			const auto it =
+				std::find(prog->vars.begin(), prog->vars.end(), b.first);
+			if (it != prog->vars.end())
+				varArrays[it - prog->vars.begin()] = b.second;
+		}
+		runBatchProgram(*prog, varArrays, out, N);
+		return;
+	}
+
+	// Non-vectorizable formula: evaluate element by element with exprtk.
+	std::vector<double> oldValues;
+	for (const auto& b : bound)
+		oldValues.push_back(*b.first);
+	for (size_t i = 0; i < N; i++)
+	{
+		for (const auto& b : bound)
+			*b.first = b.second[i];
+		out[i] = m_impl->m_compiled_formula.value();
+	}
+	for (size_t k = 0; k < bound.size(); k++)
+		*bound[k].first = oldValues[k];
+}
+
+bool CRuntimeCompiledExpression::is_batch_vectorized() const
+{
+	ASSERT_(m_impl);
+	return m_impl->m_batch_program.has_value();
+}
+
 void CRuntimeCompiledExpression::register_symbol_table(
 	/** [in] Map of variables/constants by `name` ->  `value`. The
 	   references to the values in this map **must** be ensured to be valid
@@ -126,6 +613,7 @@ void CRuntimeCompiledExpression::register_symbol_table(
 		symbol_table.add_variable(v.first, *var);
 	}
 	m_impl->m_compiled_formula.register_symbol_table(symbol_table);
+	m_impl->m_symbol_tables.push_back(symbol_table);
 }
 
 exprtk::expression<double>& CRuntimeCompiledExpression::get_raw_exprtk_expr()
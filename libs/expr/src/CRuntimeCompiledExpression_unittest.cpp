@@ -11,6 +11,9 @@
 #include <gtest/gtest.h>
 #include <mrpt/expr/CRuntimeCompiledExpression.h>
 
+#include <cmath>
+#include <vector>
+
 template class mrpt::CTraitsTest<mrpt::expr::CRuntimeCompiledExpression>;
 
 TEST(RuntimeCompiledExpression, SimpleTest)
@@ -25,3 +28,54 @@ TEST(RuntimeCompiledExpression, SimpleTest)
 	EXPECT_NEAR(
 		expr.eval(), vars["x"] * vars["x"] + vars["x"] * vars["y"] + 1.0, 1e-9);
 }
+
+TEST(RuntimeCompiledExpression, evalBatch)
+{
+	double x = 0, y = 0, z = 2.0;
+	const std::map<std::string, double*> vars = {
+		{"x", &x}, {"y", &y}, {"z", &z}};
+
+	const size_t N = 1000;
+	std::vector<double> xs(N), ys(N), out(N);
+	for (size_t i = 0; i < N; i++)
+	{
+		xs[i] = 3.0 * std::sin(i * 0.37);
+		ys[i] = 2.0 * std::cos(i * 0.11) + 0.1;
+	}
+
+	// Vectorized formulas, and others evaluated by exprtk:
+	for (const auto& [formula, vectorized] :
+		 std::vector<std::pair<std::string, bool>>{
+			 {"x^2+x*y+z", true},
+			 {"-x^2 + 2^3^2*y - (1+x^2)^-2", true},
+			 {"sin(x)*COS(y) - atan2(y,x) + min(x,y,z) + max(x,y)", true},
+			 {"(x % 0.7 + abs(-y)) / (1 + sqrt(abs(x))^1.5) * pi", true},
+			 {"if (x > 0, x, -x) + z", false},
+			 {"2x + y", false}})
+	{
+		mrpt::expr::CRuntimeCompiledExpression expr;
+		expr.register_symbol_table(vars);
+		expr.compile(formula);
+		EXPECT_EQ(expr.is_batch_vectorized(), vectorized) << formula;
+
+		x = 0.25;
+		y = -1.0;
+		expr.eval_batch({{"x", xs.data()}, {"y", ys.data()}}, out.data(), N);
+		EXPECT_EQ(x, 0.25);
+		EXPECT_EQ(y, -1.0);
+
+		for (size_t i = 0; i < N; i++)
+		{
+			x = xs[i];
+			y = ys[i];
+			const double expected = expr.eval();
+			EXPECT_NEAR(out[i], expected, 1e-12 * (1 + std::abs(expected)))
+				<< formula;
+		}
+	}
+
+	mrpt::expr::CRuntimeCompiledExpression expr;
+	expr.register_symbol_table(vars);
+	expr.compile("x+y");
+	EXPECT_ANY_THROW(expr.eval_batch({{"w", xs.data()}}, out.data(), N));
+}
@@ -15,6 +15,8 @@
 #include <mrpt/graphs/CGraphPartitioner.h>
 #include <mrpt/graphs/CHypothesisNotFoundException.h>
 #include <mrpt/graphs/CNetworkOfPoses.h>
+#include <mrpt/graphs/CNodeDataPagedStore.h>
+#include <mrpt/graphs/CNodePosesSpatialIndex.h>
 #include <mrpt/graphs/THypothesis.h>
 #include <mrpt/graphs/TMRSlamNodeAnnotations.h>
 #include <mrpt/graphs/TNodeAnnotations.h>
@@ -358,6 +358,28 @@ class CNetworkOfPoses
 								  : nullptr);
 	}
 
+	/** Edge weight functor for mrpt::graphs::CDijkstra: the length of the
+	 * translation of the (mean) relative pose of the edge.
+	 * \note (New in MRPT 2.4.9) */
+	static double dijkstra_edge_length(
+		const self_t&, const TNodeID, const TNodeID,
+		const typename BASE::edge_t& edge)
+	{
+		return edge.getPoseMean().norm();
+	}
+
+	/** A* heuristic for mrpt::graphs::CDijkstra: the Euclidean distance
+	 * between the global poses of both nodes in \a nodes. It never exceeds
+	 * the actual path length with dijkstra_edge_length() edge weights if
+	 * \a nodes are consistent with edges, e.g. after calling
+	 * dijkstra_nodes_estimate().
+	 * \note (New in MRPT 2.4.9) */
+	static double dijkstra_heuristic_euclidean(
+		const self_t& graph, const TNodeID id, const TNodeID target)
+	{
+		return graph.nodes.at(id).distanceTo(graph.nodes.at(target));
+	}
+
 	/** Look for duplicated edges (even in opposite directions) between all
 	 * pairs of nodes and fuse them.  Upon return, only one edge remains
 	 * between each pair of nodes with the mean & covariance (or information
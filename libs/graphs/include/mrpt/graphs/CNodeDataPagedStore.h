@@ -0,0 +1,140 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/graphs/TNodeID.h>
+#include <mrpt/io/CFileStream.h>
+#include <mrpt/serialization/CSerializable.h>
+
+#include <cstdint>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace mrpt::graphs
+{
+/** An on-disk store of per-node data (e.g. the laser scans or point clouds
+ * observed from each node of a graph of poses), for graphs whose nodes
+ * annotations do not fit in memory.
+ *
+ * Each object is serialized and appended to the store file by put(). Only a
+ * small index (node ID -> file offset and length) and a cache with the most
+ * recently used objects (see setCacheSize()) are kept in memory; other
+ * objects are read back from disk on demand by get().
+ *
+ * Storing again the data of an existing node appends a new copy, which
+ * replaces the former one (whose space in the file is not reclaimed).
+ *
+ * \code
+ * CNodeDataPagedStore store;
+ * store.open("scans.nodestore");
+ * store.put(nodeID, scan);
+ * ...
+ * auto scan2 = store.getAs<mrpt::obs::CObservation2DRangeScan>(nodeID);
+ * \endcode
+ *
+ * <b>File format</b>: A 16 bytes header (magic string `MRPT-NDS`, format
+ * version), followed by records with a 16 bytes header (record magic, data
+ * length, node ID) and the serialized object. Upon open(), the index is
+ * rebuilt by reading the record headers. A truncated last record (e.g. after
+ * a crash while writing it) is discarded.
+ *
+ * All public methods are thread-safe.
+ *
+ * \sa CNodePosesSpatialIndex
+ * \note (New in MRPT 2.4.9)
+ * \ingroup mrpt_graphs_grp
+ */
+class CNodeDataPagedStore
+{
+   public:
+	CNodeDataPagedStore() = default;
+	~CNodeDataPagedStore();
+
+	CNodeDataPagedStore(const CNodeDataPagedStore&) = delete;
+	CNodeDataPagedStore& operator=(const CNodeDataPagedStore&) = delete;
+
+	/** Opens (or creates) a store file. The data already in the file are
+	 * kept, unless `truncate` is true.
+	 * \return false on error (file cannot be created, or it exists and it is
+	 * not in the expected format). */
+	bool open(const std::string& fileName, bool truncate = false);
+	bool is_open() const;
+	void close();
+
+	/** Maximum number of objects kept in the memory cache (Default=100).
+	 * Zero disables the cache. */
+	void setCacheSize(size_t maxObjects);
+	size_t getCacheSize() const;
+
+	/** Stores the data of a node, replacing any previous one.
+	 * \exception std::exception If the store is not open, or on write errors.
+	 */
+	void put(const TNodeID id, const mrpt::serialization::CSerializable& obj);
+	/// \overload
+	void put(
+		const TNodeID id, const mrpt::serialization::CSerializable::Ptr& obj);
+
+	/** Returns the data of a node, or nullptr if there is none. Objects in
+	 * the cache are shared, not copied.
+	 * \exception std::exception On read errors or corrupted data. */
+	mrpt::serialization::CSerializable::Ptr get(const TNodeID id) const;
+
+	/** Type-safe version of get()
+	 * \exception std::exception If the object is not of class T or derived.
+	 */
+	template <class T>
+	typename T::Ptr getAs(const TNodeID id) const
+	{
+		auto o = get(id);
+		if (!o) return {};
+		auto obj = std::dynamic_pointer_cast<T>(o);
+		ASSERTMSG_(obj, "Node data is not of the expected class");
+		return obj;
+	}
+
+	/** Whether there is data for a node */
+	bool contains(const TNodeID id) const;
+	/** Number of nodes with data */
+	size_t size() const;
+	/** IDs of all the nodes with data, in increasing order */
+	std::vector<TNodeID> getNodeIDs() const;
+
+	/** Number of objects currently held in the memory cache */
+	size_t cachedObjectCount() const;
+
+   private:
+	struct TRecordLocation
+	{
+		/** Offset of the serialized object in the file */
+		uint64_t offset = 0;
+		uint32_t length = 0;
+	};
+
+	mutable std::mutex m_mtx;
+	mutable mrpt::io::CFileStream m_f;
+	std::map<TNodeID, TRecordLocation> m_index;
+	uint64_t m_fileEnd = 0;
+
+	/** LRU cache: most recently used first */
+	size_t m_cacheSize = 100;
+	mutable std::list<
+		std::pair<TNodeID, mrpt::serialization::CSerializable::Ptr>>
+		m_cache;
+	mutable std::map<TNodeID, decltype(m_cache)::iterator> m_cacheIndex;
+
+	void cacheInsert(
+		const TNodeID id,
+		const mrpt::serialization::CSerializable::Ptr& obj) const;
+	void cacheShrink() const;
+};
+
+}  // namespace mrpt::graphs
@@ -0,0 +1,120 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/graphs/TNodeID.h>
+#include <mrpt/math/KDTreeCapable.h>
+#include <mrpt/math/TPoint3D.h>
+#include <mrpt/math/TPose3D.h>
+
+#include <map>
+#include <vector>
+
+namespace mrpt::graphs
+{
+/** A spatial index (KD-tree) over the positions of the nodes of a graph of
+ * poses, for fast retrieval of the nodes near a given location, e.g. as
+ * loop closure candidates.
+ *
+ * Node IDs and (x,y,z) coordinates are kept in compact flat arrays, apart
+ * from the graph, so the index can be kept in memory even if node contents
+ * are not (see CNodeDataPagedStore). 2D graphs are indexed with z=0.
+ *
+ * New nodes inserted with insert() are added to the existing KD-tree
+ * incrementally. Updating the position of an existing node (e.g. after
+ * optimizing the graph) rebuilds the tree upon the next query, so after a
+ * graph optimization it is better to call clear() and insertAllNodes().
+ *
+ * \code
+ * CNodePosesSpatialIndex idx;
+ * idx.insertAllNodes(graph);
+ * for (TNodeID id : idx.nodesWithinRadius(curPose.translation(), 5.0))
+ *   ...
+ * \endcode
+ *
+ * \note (New in MRPT 2.4.9)
+ * \ingroup mrpt_graphs_grp
+ */
+class CNodePosesSpatialIndex
+	: public mrpt::math::KDTreeCapable<CNodePosesSpatialIndex>
+{
+   public:
+	CNodePosesSpatialIndex();
+
+	/** Removes all nodes */
+	void clear();
+	size_t size() const { return m_ids.size(); }
+	bool empty() const { return m_ids.empty(); }
+
+	/** Inserts a new node, or updates the position of an existing one */
+	void insert(const TNodeID id, const mrpt::math::TPoint3D& pt);
+
+	/** Inserts (or updates) the positions of all the nodes of a graph of
+	 * poses (any mrpt::graphs::CNetworkOfPoses) */
+	template <class GRAPH_T>
+	void insertAllNodes(const GRAPH_T& graph)
+	{
+		for (const auto& n : graph.nodes)
+		{
+			const mrpt::math::TPose3D p(n.second.asTPose());
+			insert(n.first, mrpt::math::TPoint3D(p.x, p.y, p.z));
+		}
+	}
+
+	/** Whether the node is in the index */
+	bool contains(const TNodeID id) const { return m_id2idx.count(id) != 0; }
+
+	/** Gets the indexed position of a node.
+	 * \return false if the node is not in the index. */
+	bool getNodePosition(const TNodeID id, mrpt::math::TPoint3D& pt) const;
+
+	/** Returns the IDs of all the nodes within `radius` of `center`, sorted
+	 * by increasing distance */
+	std::vector<TNodeID> nodesWithinRadius(
+		const mrpt::math::TPoint3D& center, const double radius) const;
+
+	/** Returns the IDs of the (up to) `k` nodes nearest to `pt`, sorted by
+	 * increasing distance */
+	std::vector<TNodeID> nearestNodes(
+		const mrpt::math::TPoint3D& pt, const size_t k) const;
+
+	/** @name Interface for KDTreeCapable
+		@{ */
+	inline size_t kdtree_get_point_count() const { return m_ids.size(); }
+	inline float kdtree_get_pt(const size_t idx, int dim) const
+	{
+		return m_xyz[3 * idx + dim];
+	}
+	inline float kdtree_distance(
+		const float* p1, const size_t idx_p2, size_t size) const
+	{
+		float d = 0;
+		for (size_t i = 0; i < size; i++)
+		{
+			const float di = p1[i] - m_xyz[3 * idx_p2 + i];
+			d += di * di;
+		}
+		return d;
+	}
+	template <typename BBOX>
+	bool kdtree_get_bbox([[maybe_unused]] BBOX& bb) const
+	{
+		return false;
+	}
+	/** @} */
+
+   private:
+	/** Node IDs and their x,y,z coordinates, at 3*i+{0,1,2} */
+	std::vector<TNodeID> m_ids;
+	std::vector<float> m_xyz;
+	/** Node ID -> index in m_ids */
+	std::map<TNodeID, size_t> m_id2idx;
+};
+
+}  // namespace mrpt::graphs
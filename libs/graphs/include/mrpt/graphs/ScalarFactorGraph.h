@@ -8,11 +8,15 @@
    +------------------------------------------------------------------------+ */
 #pragma once
 
+#include <mrpt/math/CSparseMatrix.h>
 #include <mrpt/math/CVectorDynamic.h>
 #include <mrpt/system/COutputLogger.h>
 #include <mrpt/system/CTimeLogger.h>
 
 #include <deque>
+#include <memory>
+#include <unordered_map>
+#include <vector>
 
 namespace mrpt::graphs
 {
@@ -28,13 +32,24 @@ namespace mrpt::graphs
  *   - Linear error functions (for now).
  *   - Scalar (1-dim) error functions.
  *   - Gaussian factors.
- *   - Solver: Eigen SparseQR.
+ *   - Solver: sparse Cholesky of the normal equations (CSparse), or Eigen
+ * SparseQR if that is disabled or the system is not definite positive.
  *
  *  Usage:
  *   - Call initialize() to set the number of nodes.
  *   - Call addConstraints() to insert constraints. This may be called more than
  * once.
- *   - Call updateEstimation() to run one step of the linear SparseQR solver.
+ *   - Call updateEstimation() to run one step of the linear solver.
+ *
+ *  The Cholesky factorization is kept between calls to updateEstimation():
+ * if the binary factors did not change and only a few unary factors were
+ * added, removed or modified, it is updated with rank-one updates instead of
+ * being computed again, which is the typical situation when new observations
+ * are inserted into a random field map. Otherwise, the matrix is factorized
+ * again, reusing the symbolic analysis if the graph topology is the same.
+ *
+ *  Factors are evaluated by setNumThreads() threads, so their methods must
+ * be thread-safe if more than one thread is used.
  *
  * \ingroup mrpt_graph_grp
  * \note [New in MRPT 1.5.0] Requires Eigen>=3.1
@@ -99,9 +114,40 @@ class ScalarFactorGraph : public mrpt::system::COutputLogger
 		/** If !=nullptr, the variances of each estimate will be stored here. */
 		mrpt::math::CVectorDouble* solved_variances = nullptr);
 
+	/** Like updateEstimation(), but only recovers the variances of the nodes
+	 * in `varianceNodeIDs`, which are stored in `solved_variances` in the
+	 * same order. With the Cholesky solver, the cost of each variance only
+	 * depends on the sparsity of the factorization, not on the graph size.
+	 * \note (New in MRPT 2.4.9)
+	 */
+	void updateEstimation(
+		mrpt::math::CVectorDouble& solved_x_inc,
+		const std::vector<size_t>& varianceNodeIDs,
+		mrpt::math::CVectorDouble& solved_variances);
+
 	bool isProfilerEnabled() const { return m_enable_profiler; }
 	void enableProfiler(bool enable = true) { m_enable_profiler = enable; }
 
+	/** Enables the (default) sparse Cholesky solver. If disabled, Eigen
+	 * SparseQR is used, without incremental updates.
+	 * \note (New in MRPT 2.4.9) */
+	void enableCholesky(bool enable = true);
+	bool isCholeskyEnabled() const { return m_use_cholesky; }
+
+	/** Number of threads evaluating factors and variances (0: as many as
+	 * CPU cores). Default: 1.
+	 * \note (New in MRPT 2.4.9) */
+	void setNumThreads(unsigned int n) { m_num_threads = n; }
+	unsigned int getNumThreads() const { return m_num_threads; }
+
+	/** Maximum number of nodes whose unary factors may change between two
+	 * calls to updateEstimation() for the Cholesky factorization to be
+	 * modified with rank-one updates; if more nodes change, it is computed
+	 * again. Default: 500. Set to 0 to always refactorize.
+	 * \note (New in MRPT 2.4.9) */
+	void setMaxRankUpdates(size_t n) { m_max_rank_updates = n; }
+	size_t getMaxRankUpdates() const { return m_max_rank_updates; }
+
    private:
 	/** number of nodes in the graph */
 	size_t m_numNodes = 0;
@@ -112,6 +158,43 @@ class ScalarFactorGraph : public mrpt::system::COutputLogger
 	mrpt::system::CTimeLogger m_timelogger;
 	bool m_enable_profiler{false};
 
+	bool m_use_cholesky{true};
+	unsigned int m_num_threads{1};
+	size_t m_max_rank_updates{500};
+
+	/** Contributions of one factor to the normal equations H*x=g */
+	struct UnaryTerm
+	{
+		size_t node;
+		double h, g;
+	};
+	struct BinaryTerm
+	{
+		size_t i, j;
+		double hii, hij, hjj, gi, gj;
+	};
+	std::vector<UnaryTerm> m_unary_terms;
+	std::vector<BinaryTerm> m_binary_terms;
+
+	/** State of the current Cholesky factorization: the binary terms and
+	 * the (node, h) terms of each unary factor that were factorized. */
+	std::unique_ptr<mrpt::math::CSparseMatrix::CholeskyDecomp> m_chol;
+	std::vector<BinaryTerm> m_chol_binary_terms;
+	std::unordered_map<const UnaryFactorVirtualBase*, std::pair<size_t, double>>
+		m_chol_unary_terms;
+
+	void evaluateFactors();
+	/** Brings m_chol up to date with the last evaluated factors.
+	 * \return false if the system is not definite positive. */
+	bool updateCholesky();
+	void solveCholesky(
+		mrpt::math::CVectorDouble& solved_x_inc,
+		const std::vector<size_t>* varianceNodeIDs,
+		mrpt::math::CVectorDouble* solved_variances);
+	void solveSparseQR(
+		mrpt::math::CVectorDouble& solved_x_inc,
+		mrpt::math::CVectorDouble* solved_variances);
+
 };	// End of class def.
 
 }  // namespace mrpt::graphs
@@ -16,7 +16,11 @@
 #include <exception>
 #include <functional>
 #include <limits>
+#include <list>
+#include <memory>
+#include <mutex>
 #include <optional>
+#include <queue>
 #include <utility>
 #include <vector>
 
@@ -85,6 +89,12 @@ class NotConnectedGraph : public std::exception
  *    is much faster (avoids memory allocations), but should be only used if the
  *    node IDs start in 0 or a low value.
  *
+ * If only the path between two nodes is needed, use the point-to-point
+ * constructor, which stops as soon as the target is reached and optionally
+ * runs A* with a user-provided heuristic, or the static method
+ * getShortestPathBidirectional(). Trees from frequently used roots can be
+ * kept in a CDijkstraCache.
+ *
  * See a complete [C++ code example](page_graphs_dijkstra_example.html).
  *
  * \ingroup mrpt_graphs_grp
@@ -121,10 +131,6 @@ class CDijkstra
 	const TNodeID m_source_node_ID;
 
 	// Private typedefs:
-	/** A std::map (or a similar container according to MAPS_IMPLEMENTATION)
-	 * with all the neighbors of every node. */
-	using list_all_neighbors_t =
-		typename MAPS_IMPLEMENTATION::template map<TNodeID, std::set<TNodeID>>;
 	using id2pairIDs_map_t =
 		typename MAPS_IMPLEMENTATION::template map<TNodeID, TPairNodeIDs>;
 	using id2dist_map_t =
@@ -132,15 +138,37 @@ class CDijkstra
 	using id2id_map_t =
 		typename MAPS_IMPLEMENTATION::template map<TNodeID, TPrevious>;
 
+	/** An entry in the frontier of the search: a node with its tentative
+	 * distance `g` and its priority `f` (`g` plus the heuristic, if any).
+	 * Entries are never updated: outdated ones are skipped when popped. */
+	struct TFrontierEntry
+	{
+		double f, g;
+		TNodeID id;
+		bool operator>(const TFrontierEntry& o) const
+		{
+			// Ties broken by node ID, as in the sweep of a std::map:
+			return f > o.f || (f == o.f && id > o.id);
+		}
+	};
+	using frontier_t = std::priority_queue<
+		TFrontierEntry, std::vector<TFrontierEntry>,
+		std::greater<TFrontierEntry>>;
+
+   public:
+	/** A std::map (or a similar container according to MAPS_IMPLEMENTATION)
+	 * with all the neighbors of every node. */
+	using list_all_neighbors_t =
+		typename MAPS_IMPLEMENTATION::template map<TNodeID, std::set<TNodeID>>;
+
+   protected:
 	// Intermediary and final results:
 	/** All the distances */
 	id2dist_map_t m_distances;
-	std::map<TNodeID, TDistance>
-		m_distances_non_visited;  // Use a std::map here in all cases.
 	id2id_map_t m_prev_node;
 	id2pairIDs_map_t m_prev_arc;
 	std::set<TNodeID> m_lstNode_IDs;
-	list_all_neighbors_t m_allNeighbors;
+	std::shared_ptr<const list_all_neighbors_t> m_allNeighbors;
 
    public:
 	/** @name Useful typedefs
@@ -161,6 +189,13 @@ class CDijkstra
 	using functor_on_progress_t =
 		std::function<void(const graph_t& graph, size_t visitedCount)>;
 
+	/** A lower bound of the distance from node `id` to node `target`, for
+	 * A* searches (e.g. the Euclidean distance between node poses, see
+	 * mrpt::graphs::CNetworkOfPoses::dijkstra_heuristic_euclidean()).
+	 * \note (New in MRPT 2.4.9) */
+	using functor_heuristic_t = std::function<double(
+		const graph_t& graph, const TNodeID id, const TNodeID target)>;
+
 	/** @} */
 
 	/** Constructor which takes the input graph and executes the entire
@@ -179,19 +214,244 @@ class CDijkstra
 	 * functor_edge_weight if provided) to build the tree up to some limit.
 	 * Use it if you are not interested in the entire tree.
 	 *
+	 * If `adjacency` is provided (e.g. getCachedAdjacencyMatrix() of another
+	 * CDijkstra object on the same graph), it is used instead of computing
+	 * the neighbors of all nodes again.
+	 *
 	 * \sa getShortestPathTo(), getTreeGraph()
 	 *
 	 * \exception std::exception If the source nodeID is not found in the
 	 * graph
 	 *
-	 * \note `maximum_distance` was added in MRPT 2.4.1
+	 * \note `maximum_distance` was added in MRPT 2.4.1, `adjacency` in MRPT
+	 * 2.4.9
 	 */
 	CDijkstra(
 		const graph_t& graph, const TNodeID source_node_ID,
 		functor_edge_weight_t functor_edge_weight = functor_edge_weight_t(),
 		functor_on_progress_t functor_on_progress = functor_on_progress_t(),
-		const size_t maximum_distance = std::numeric_limits<size_t>::max())
+		const size_t maximum_distance = std::numeric_limits<size_t>::max(),
+		std::shared_ptr<const list_all_neighbors_t> adjacency = {})
 		: m_cached_graph(graph), m_source_node_ID(source_node_ID)
+	{
+		// Make a list of all the nodes in the graph:
+		graph.getAllNodes(m_lstNode_IDs);
+		initAdjacency(std::move(adjacency));
+
+		run(functor_edge_weight, functor_on_progress, maximum_distance,
+			INVALID_NODEID, functor_heuristic_t());
+	}
+
+	/** Point-to-point constructor: runs the Dijkstra algorithm from
+	 * `source_node_ID` only until `target_node_ID` is reached, so that
+	 * getShortestPathTo(target_node_ID) can be called next. Paths to other
+	 * nodes are only available if they were also reached before the target.
+	 *
+	 * If a `heuristic` is provided, the search becomes A*: nodes are
+	 * expanded in the order of their distance from the source plus the
+	 * heuristic estimate of their distance to the target, which visits far
+	 * less nodes in large graphs. The path is only guaranteed to be the
+	 * shortest one if the heuristic never exceeds the actual distance.
+	 *
+	 * See the main constructor for the rest of parameters.
+	 *
+	 * \exception std::exception If any of the nodes is not in the graph.
+	 * \note (New in MRPT 2.4.9)
+	 */
+	CDijkstra(
+		const graph_t& graph, const TNodeID source_node_ID,
+		const TNodeID target_node_ID,
+		functor_edge_weight_t functor_edge_weight,
+		functor_heuristic_t heuristic = functor_heuristic_t(),
+		std::shared_ptr<const list_all_neighbors_t> adjacency = {})
+		: m_cached_graph(graph), m_source_node_ID(source_node_ID)
+	{
+		initAdjacency(std::move(adjacency));
+		// All nodes in edges have at least one neighbor:
+		for (const auto& n : *m_allNeighbors)
+			if (!n.second.empty())
+				m_lstNode_IDs.insert(m_lstNode_IDs.end(), n.first);
+
+		if (m_lstNode_IDs.count(target_node_ID) == 0)
+			THROW_EXCEPTION_FMT(
+				"Cannot find the target node_ID=%lu in the graph",
+				static_cast<unsigned long>(target_node_ID));
+
+		run(functor_edge_weight, functor_on_progress_t(),
+			std::numeric_limits<size_t>::max(), target_node_ID, heuristic);
+	}
+
+	/** Bidirectional point-to-point search: computes the shortest path from
+	 * `source_node_ID` to `target_node_ID` by growing one Dijkstra search
+	 * from each end until they meet, which typically visits a fraction of
+	 * the nodes visited by a single search. Arcs in `out_path` are given
+	 * with their direction in the graph, from source to target.
+	 *
+	 * \param[out] out_distance If not nullptr, the path length is stored
+	 * here.
+	 * \return false if there is no path between both nodes.
+	 * \exception std::exception If any of the nodes is not in the graph.
+	 * \note (New in MRPT 2.4.9)
+	 */
+	static bool getShortestPathBidirectional(
+		const graph_t& graph, const TNodeID source_node_ID,
+		const TNodeID target_node_ID, edge_list_t& out_path,
+		functor_edge_weight_t functor_edge_weight = functor_edge_weight_t(),
+		double* out_distance = nullptr,
+		std::shared_ptr<const list_all_neighbors_t> adjacency = {})
+	{
+		if (!adjacency)
+		{
+			auto adj = std::make_shared<list_all_neighbors_t>();
+			graph.getAdjacencyMatrix(*adj);
+			adjacency = std::move(adj);
+		}
+		for (const TNodeID id : {source_node_ID, target_node_ID})
+		{
+			const auto it = adjacency->find(id);
+			if (it == adjacency->end() || it->second.empty())
+				THROW_EXCEPTION_FMT(
+					"Cannot find the node_ID=%lu in the graph",
+					static_cast<unsigned long>(id));
+		}
+
+		out_path.clear();
+		if (out_distance) *out_distance = 0;
+		if (source_node_ID == target_node_ID) return true;
+
+		// One search from each end (0: forward, 1: backward):
+		struct TSearch
+		{
+			id2dist_map_t dist;
+			id2id_map_t prev_node;
+			id2pairIDs_map_t prev_arc;
+			frontier_t frontier;
+
+			// Removes outdated entries from the top of the frontier:
+			bool cleanTop()
+			{
+				while (!frontier.empty() &&
+					   frontier.top().g != dist[frontier.top().id].dist)
+					frontier.pop();
+				return !frontier.empty();
+			}
+		} searches[2];
+
+		searches[0].dist[source_node_ID] = 0;
+		searches[0].frontier.push({0, 0, source_node_ID});
+		searches[1].dist[target_node_ID] = 0;
+		searches[1].frontier.push({0, 0, target_node_ID});
+
+		// Length of the best path so far, and the arc where both meet:
+		double best = std::numeric_limits<double>::max();
+		TNodeID meetFwd = INVALID_NODEID, meetBwd = INVALID_NODEID;
+		TPairNodeIDs meetArc;
+
+		while (searches[0].cleanTop() && searches[1].cleanTop())
+		{
+			const double top0 = searches[0].frontier.top().g;
+			const double top1 = searches[1].frontier.top().g;
+			// No shorter path can be found:
+			if (top0 + top1 >= best) break;
+
+			const int side = top0 <= top1 ? 0 : 1;
+			TSearch& s = searches[side];
+			TSearch& other = searches[1 - side];
+			const TNodeID u = s.frontier.top().id;
+			const double d_u = s.frontier.top().g;
+			s.frontier.pop();
+
+			const auto itNeighbors = adjacency->find(u);
+			if (itNeighbors == adjacency->end()) continue;
+			for (const TNodeID i : itNeighbors->second)
+			{
+				if (i == u) continue;  // ignore self-loops...
+
+				std::optional<typename graph_t::const_iterator> edge;
+				const double dist_ui =
+					d_u + edgeWeight(graph, u, i, functor_edge_weight, edge);
+				if (dist_ui < s.dist[i].dist)
+				{
+					if (!edge) edge = findEdge(graph, u, i);
+					s.dist[i].dist = dist_ui;
+					s.prev_node[i].id = u;
+					s.prev_arc[i] = edge.value()->first;
+					s.frontier.push({dist_ui, dist_ui, i});
+				}
+				// Does this arc join both searches?
+				const auto itOther = other.dist.find(i);
+				if (itOther != other.dist.end() &&
+					itOther->second.dist < std::numeric_limits<double>::max() &&
+					dist_ui + itOther->second.dist < best)
+				{
+					if (!edge) edge = findEdge(graph, u, i);
+					best = dist_ui + itOther->second.dist;
+					meetFwd = side == 0 ? u : i;
+					meetBwd = side == 0 ? i : u;
+					meetArc = edge.value()->first;
+				}
+			}
+		}
+		if (meetFwd == INVALID_NODEID) return false;
+
+		// Path: source -> meetFwd -> meetBwd -> target
+		out_path.push_back(meetArc);
+		for (TNodeID n = meetFwd; n != source_node_ID;
+			 n = searches[0].prev_node[n].id)
+			out_path.push_front(searches[0].prev_arc[n]);
+		for (TNodeID n = meetBwd; n != target_node_ID;
+			 n = searches[1].prev_node[n].id)
+			out_path.push_back(searches[1].prev_arc[n]);
+
+		if (out_distance) *out_distance = best;
+		return true;
+	}
+
+   protected:
+	void initAdjacency(std::shared_ptr<const list_all_neighbors_t> adjacency)
+	{
+		if (!adjacency)
+		{
+			// Precompute all neighbors of all the nodes in the given graph:
+			auto adj = std::make_shared<list_all_neighbors_t>();
+			m_cached_graph.getAdjacencyMatrix(*adj);
+			adjacency = std::move(adj);
+		}
+		m_allNeighbors = std::move(adjacency);
+	}
+
+	/** Finds the edge between u and i, whatever its direction */
+	static typename graph_t::const_iterator findEdge(
+		const graph_t& graph, const TNodeID u, const TNodeID i)
+	{
+		// edge may be i->u or u->i:
+		auto edge_ui = graph.edges.find(std::make_pair(u, i));
+		if (edge_ui == graph.edges.end())
+			edge_ui = graph.edges.find(std::make_pair(i, u));
+		ASSERT_(edge_ui != graph.edges.end());
+		return edge_ui;
+	}
+
+	/** Returns the weight of the edge between u and i. The edge is only
+	 * searched for (and returned in `edge`) if there is a weight functor,
+	 * since unit weights do not need it unless the distance improves. */
+	static double edgeWeight(
+		const graph_t& graph, const TNodeID u, const TNodeID i,
+		const functor_edge_weight_t& functor_edge_weight,
+		std::optional<typename graph_t::const_iterator>& edge)
+	{
+		if (!functor_edge_weight) return 1.;
+		edge = findEdge(graph, u, i);
+		const auto& e = *edge.value();
+		return functor_edge_weight(
+			graph, e.first.first, e.first.second, e.second);
+	}
+
+	void run(
+		const functor_edge_weight_t& functor_edge_weight,
+		const functor_on_progress_t& functor_on_progress,
+		const size_t maximum_distance, const TNodeID target_node_ID,
+		const functor_heuristic_t& heuristic)
 	{
 		/*
 		1  function Dijkstra(G, w, s)
@@ -209,10 +469,8 @@ class CDijkstra
 		13               m_distances[v] := m_distances[u] + w(u,v)
 		14               m_prev_node[v] := u
 		*/
-
-		// Make a list of all the nodes in the graph:
-		graph.getAllNodes(m_lstNode_IDs);
 		const size_t nNodes = m_lstNode_IDs.size();
+		const TNodeID source_node_ID = m_source_node_ID;
 
 		if (m_lstNode_IDs.find(source_node_ID) == m_lstNode_IDs.end())
 		{
@@ -221,38 +479,39 @@ class CDijkstra
 				static_cast<unsigned long>(source_node_ID));
 		}
 
+		const auto h = [&](const TNodeID id) {
+			return heuristic ? heuristic(m_cached_graph, id, target_node_ID)
+							 : 0.0;
+		};
+
 		// Init:
 		// m_distances: already initialized to infinity by default.
 		// m_prev_node: idem
 		// m_prev_arc: idem
-		// m_visited: idem
 		size_t visitedCount = 0;
 		m_distances[source_node_ID] = 0;
-		m_distances_non_visited[source_node_ID] = 0;
 
-		// Precompute all neighbors of all the nodes in the given graph:
-		graph.getAdjacencyMatrix(m_allNeighbors);
-
-		using namespace std;
+		// Binary heap with the non-visited nodes, sorted by distance:
+		frontier_t frontier;
+		frontier.push({h(source_node_ID), 0, source_node_ID});
 
 		TNodeID u;
 		// as long as there are nodes not yet visited.
 		do
 		{  // The algorithm:
 			// Find the nodeID with the minimum known distance so far
-			// considered:
+			// considered, skipping outdated entries of the frontier:
+			while (!frontier.empty() &&
+				   frontier.top().g != m_distances[frontier.top().id].dist)
+				frontier.pop();
+
 			double min_d = std::numeric_limits<double>::max();
 			u = INVALID_NODEID;
-
-			// No need to check if the min. distance node is not visited yet,
-			// since we keep two lists: m_distances_non_visited & m_distances
-			for (const auto& dnv : m_distances_non_visited)
+			if (!frontier.empty())
 			{
-				if (dnv.second.dist < min_d)
-				{
-					u = dnv.first;
-					min_d = dnv.second.dist;
-				}
+				u = frontier.top().id;
+				min_d = frontier.top().g;
+				frontier.pop();
 			}
 
 			if (min_d > maximum_distance)
@@ -281,81 +540,46 @@ class CDijkstra
 					nodeIDs_unconnected, err_str);
 			}
 
-			// Update distance (for possible future reference...) and remove
-			// this node from "non-visited":
-			m_distances[u] = m_distances_non_visited[u];
-			m_distances_non_visited.erase(u);
-
 			visitedCount++;
 
 			// Let the user know about our progress...
-			if (functor_on_progress) functor_on_progress(graph, visitedCount);
+			if (functor_on_progress)
+				functor_on_progress(m_cached_graph, visitedCount);
+
+			// Point-to-point mode: done.
+			if (u == target_node_ID) break;
 
 			// For each arc from "u":
-			const std::set<TNodeID>& neighborsOfU = m_allNeighbors[u];
-			for (unsigned long i : neighborsOfU)
+			const auto itNeighbors = m_allNeighbors->find(u);
+			if (itNeighbors == m_allNeighbors->end()) continue;
+			for (const TNodeID i : itNeighbors->second)
 			{
 				if (i == u) continue;  // ignore self-loops...
 
-				// the "edge_ui" may be searched here or a bit later, so the
-				// "bool" var will tell us.
-				typename graph_t::const_iterator edge_ui;
-				bool edge_ui_reverse = false;
-				bool edge_ui_found = false;
-
-				// Get weight of edge u<->i
-				double edge_ui_weight;
-				if (!functor_edge_weight) edge_ui_weight = 1.;
-				else
-				{  // edge may be i->u or u->i:
-					edge_ui = graph.edges.find(std::make_pair(u, i));
-					if (edge_ui == graph.edges.end())
-					{
-						edge_ui = graph.edges.find(std::make_pair(i, u));
-						edge_ui_reverse = true;
-					}
-					ASSERT_(edge_ui != graph.edges.end());
-					edge_ui_weight = functor_edge_weight(
-						graph, edge_ui->first.first, edge_ui->first.second,
-						edge_ui->second);
-					edge_ui_found = true;
-				}
-
-				const auto dist_ui = (min_d + edge_ui_weight);
+				// The edge "u<->i" may be searched here or a bit later:
+				std::optional<typename graph_t::const_iterator> edge_ui;
+				const auto dist_ui = min_d +
+					edgeWeight(
+						m_cached_graph, u, i, functor_edge_weight, edge_ui);
 
 				if (dist_ui > maximum_distance)	 // out of radius of interest:
 					continue;
 
 				if (dist_ui < m_distances[i].dist)
 				{  // the [] creates the entry if needed
-					// update m_distances, m_distances_non_visited
-					m_distances_non_visited[i].dist = dist_ui;
+					if (!edge_ui) edge_ui = findEdge(m_cached_graph, u, i);
 					m_distances[i].dist = dist_ui;
-
 					m_prev_node[i].id = u;
-					// If still not done above, detect the direction of the arc
-					// now:
-					if (!edge_ui_found)
-					{
-						edge_ui = graph.edges.find(std::make_pair(u, i));
-						if (edge_ui == graph.edges.end())
-						{
-							edge_ui = graph.edges.find(std::make_pair(i, u));
-							edge_ui_reverse = true;
-						}
-						ASSERT_(edge_ui != graph.edges.end());
-					}
-
-					if (!edge_ui_reverse)
-						m_prev_arc[i] = std::make_pair(u, i);  // *u -> *i
-					else
-						m_prev_arc[i] = std::make_pair(i, u);  // *i -> *u
+					// *u -> *i or *i -> *u:
+					m_prev_arc[i] = edge_ui.value()->first;
+					frontier.push({dist_ui + h(i), dist_ui, i});
 				}
 			}
 		} while (visitedCount < nNodes);
 
 	}  // end Dijkstra
 
+   public:
 	/** @name Query Dijkstra results
 	  @{ */
 
@@ -385,6 +609,15 @@ class CDijkstra
 	 * \sa  mrpt::graphs::CDirectedGraph::getAdjacencyMatrix
 	 * */
 	const list_all_neighbors_t& getCachedAdjacencyMatrix() const
+	{
+		return *m_allNeighbors;
+	}
+
+	/** \overload returns a shared pointer to the cached adjacency matrix,
+	 * which can be passed to other CDijkstra searches on the same graph.
+	 * \note (New in MRPT 2.4.9) */
+	std::shared_ptr<const list_all_neighbors_t> getCachedAdjacencyMatrixPtr()
+		const
 	{
 		return m_allNeighbors;
 	}
@@ -487,4 +720,120 @@ class CDijkstra
 
 };	// end class
 
+/** A cache of CDijkstra trees of one graph, rooted at different nodes and
+ * computed on demand, for applications asking repeatedly for shortest paths
+ * from a few frequently used nodes. The least recently used trees are
+ * discarded when there are more than the given maximum.
+ *
+ * All trees share the adjacency matrix of the graph, computed once. The
+ * cache must be clear()'ed if the graph is modified. Its methods are
+ * thread-safe.
+ *
+ * \ingroup mrpt_graphs_grp
+ * \note (New in MRPT 2.4.9)
+ */
+template <
+	class TYPE_GRAPH,
+	class MAPS_IMPLEMENTATION = mrpt::containers::map_traits_stdmap>
+class CDijkstraCache
+{
+   public:
+	using dijkstra_t = CDijkstra<TYPE_GRAPH, MAPS_IMPLEMENTATION>;
+	using graph_t = typename dijkstra_t::graph_t;
+	using functor_edge_weight_t = typename dijkstra_t::functor_edge_weight_t;
+
+	CDijkstraCache(
+		const graph_t& graph, const size_t maxTrees = 16,
+		functor_edge_weight_t functor_edge_weight = functor_edge_weight_t())
+		: m_graph(graph),
+		  m_max_trees(maxTrees),
+		  m_functor_edge_weight(std::move(functor_edge_weight))
+	{
+		ASSERT_(maxTrees > 0);
+	}
+
+	/** Returns the tree rooted at the given node, computing it first if it
+	 * is not in the cache. */
+	std::shared_ptr<const dijkstra_t> getTree(const TNodeID root)
+	{
+		std::shared_ptr<const typename dijkstra_t::list_all_neighbors_t> adj;
+		{
+			std::lock_guard<std::mutex> lck(m_mtx);
+			if (auto it = m_trees.find(root); it != m_trees.end())
+			{
+				// Move to the front of the LRU list:
+				m_lru.splice(m_lru.begin(), m_lru, it->second.second);
+				return it->second.first;
+			}
+			adj = m_adjacency;
+		}
+
+		// Compute the tree without holding the lock:
+		auto tree = std::make_shared<const dijkstra_t>(
+			m_graph, root, m_functor_edge_weight,
+			typename dijkstra_t::functor_on_progress_t(),
+			std::numeric_limits<size_t>::max(), adj);
+
+		std::lock_guard<std::mutex> lck(m_mtx);
+		if (!m_adjacency) m_adjacency = tree->getCachedAdjacencyMatrixPtr();
+		if (auto it = m_trees.find(root); it != m_trees.end())
+			return it->second.first;  // Computed by another thread meanwhile
+
+		m_lru.push_front(root);
+		m_trees[root] = {tree, m_lru.begin()};
+		while (m_trees.size() > m_max_trees)
+		{
+			m_trees.erase(m_lru.back());
+			m_lru.pop_back();
+		}
+		return tree;
+	}
+
+	/** Shortest path from `root` to `target`, using the cached tree rooted
+	 * at `root`. */
+	typename dijkstra_t::edge_list_t getShortestPath(
+		const TNodeID root, const TNodeID target)
+	{
+		return getTree(root)->getShortestPathTo(target);
+	}
+
+	/** Removes all trees, as needed after modifying the graph. */
+	void clear()
+	{
+		std::lock_guard<std::mutex> lck(m_mtx);
+		m_trees.clear();
+		m_lru.clear();
+		m_adjacency.reset();
+	}
+
+	/** Number of trees in the cache */
+	size_t size() const
+	{
+		std::lock_guard<std::mutex> lck(m_mtx);
+		return m_trees.size();
+	}
+
+	bool contains(const TNodeID root) const
+	{
+		std::lock_guard<std::mutex> lck(m_mtx);
+		return m_trees.count(root) != 0;
+	}
+
+   private:
+	const graph_t& m_graph;
+	const size_t m_max_trees;
+	const functor_edge_weight_t m_functor_edge_weight;
+
+	mutable std::mutex m_mtx;
+	/** Roots, the most recently used first */
+	std::list<TNodeID> m_lru;
+	std::map<
+		TNodeID, std::pair<
+					 std::shared_ptr<const dijkstra_t>,
+					 typename std::list<TNodeID>::iterator>>
+		m_trees;
+	std::shared_ptr<const typename dijkstra_t::list_all_neighbors_t>
+		m_adjacency;
+};
+
 }  // namespace mrpt::graphs
@@ -0,0 +1,268 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "graphs-precomp.h"	 // Precompiled headers
+//
+#include <mrpt/graphs/CNodeDataPagedStore.h>
+#include <mrpt/io/CFileInputStream.h>
+#include <mrpt/io/CMemoryStream.h>
+#include <mrpt/serialization/CArchive.h>
+#include <mrpt/system/filesystem.h>
+
+#include <cstring>
+#include <filesystem>
+#include <limits>
+
+using namespace mrpt::graphs;
+using namespace mrpt::io;
+using namespace mrpt::serialization;
+
+namespace
+{
+constexpr char HEADER_MAGIC[9] = "MRPT-NDS";
+constexpr uint32_t FORMAT_VERSION = 1;
+constexpr uint32_t RECORD_MAGIC = 0x5244534E;  // "NSDR"
+constexpr uint64_t HEADER_LEN = 16, RECORD_HEADER_LEN = 16;
+}  // namespace
+
+CNodeDataPagedStore::~CNodeDataPagedStore() { close(); }
+
+bool CNodeDataPagedStore::open(const std::string& fileName, bool truncate)
+{
+	close();
+	std::lock_guard<std::mutex> lck(m_mtx);
+
+	if (truncate || !mrpt::system::fileExists(fileName))
+	{
+		CFileStream f;
+		if (!f.open(fileName, fomWrite)) return false;
+		auto arch = archiveFrom(f);
+		f.Write(HEADER_MAGIC, 8);
+		arch << FORMAT_VERSION << uint32_t(0);
+		m_fileEnd = HEADER_LEN;
+	}
+	else
+	{
+		// Check the header and rebuild the index from the record headers:
+		CFileInputStream f;
+		if (!f.open(fileName)) return false;
+		const uint64_t fileSize = f.getTotalBytesCount();
+
+		char magic[8];
+		uint32_t version = 0, reserved;
+		if (fileSize < HEADER_LEN || f.Read(magic, 8) != 8 ||
+			std::memcmp(magic, HEADER_MAGIC, 8) != 0)
+			return false;
+		auto arch = archiveFrom(f);
+		arch >> version >> reserved;
+		if (version > FORMAT_VERSION) return false;
+
+		uint64_t pos = HEADER_LEN;
+		while (pos + RECORD_HEADER_LEN <= fileSize)
+		{
+			uint32_t recMagic, length;
+			uint64_t id;
+			arch >> recMagic >> length >> id;
+			if (recMagic != RECORD_MAGIC ||
+				pos + RECORD_HEADER_LEN + length > fileSize)
+				break;
+
+			auto& loc = m_index[static_cast<TNodeID>(id)];
+			loc.offset = pos + RECORD_HEADER_LEN;
+			loc.length = length;
+
+			pos += RECORD_HEADER_LEN + length;
+			f.Seek(pos);
+		}
+		f.close();
+		m_fileEnd = pos;
+
+		// Discard a truncated or corrupted last record, so new records are
+		// appended right after the last valid one:
+		if (pos < fileSize)
+		{
+			std::error_code ec;
+			std::filesystem::resize_file(fileName, pos, ec);
+			if (ec)
+			{
+				m_index.clear();
+				return false;
+			}
+		}
+	}
+
+	// Read & append mode:
+	if (!m_f.open(fileName, fomAppend | fomWrite))
+	{
+		m_index.clear();
+		return false;
+	}
+	return true;
+}
+
+bool CNodeDataPagedStore::is_open() const
+{
+	std::lock_guard<std::mutex> lck(m_mtx);
+	return m_f.fileOpenCorrectly();
+}
+
+void CNodeDataPagedStore::close()
+{
+	std::lock_guard<std::mutex> lck(m_mtx);
+	m_f.close();
+	m_index.clear();
+	m_cache.clear();
+	m_cacheIndex.clear();
+	m_fileEnd = 0;
+}
+
+void CNodeDataPagedStore::setCacheSize(size_t maxObjects)
+{
+	std::lock_guard<std::mutex> lck(m_mtx);
+	m_cacheSize = maxObjects;
+	cacheShrink();
+}
+
+size_t CNodeDataPagedStore::getCacheSize() const
+{
+	std::lock_guard<std::mutex> lck(m_mtx);
+	return m_cacheSize;
+}
+
+void CNodeDataPagedStore::put(
+	const TNodeID id, const mrpt::serialization::CSerializable::Ptr& obj)
+{
+	ASSERT_(obj);
+	put(id, *obj);
+
+	// Keep the object itself in the cache, instead of the serialized copy
+	// that will be read back by get():
+	std::lock_guard<std::mutex> lck(m_mtx);
+	cacheInsert(id, obj);
+}
+
+void CNodeDataPagedStore::put(
+	const TNodeID id, const mrpt::serialization::CSerializable& obj)
+{
+	MRPT_START
+	std::lock_guard<std::mutex> lck(m_mtx);
+	ASSERTMSG_(m_f.fileOpenCorrectly(), "The store is not open");
+
+	CMemoryStream buf;
+	archiveFrom(buf).WriteObject(&obj);
+	const uint64_t length = buf.getTotalBytesCount();
+	ASSERTMSG_(
+		length <= std::numeric_limits<uint32_t>::max(),
+		"Objects larger than 4 GiB are not supported");
+
+	m_f.clearError();
+	auto arch = archiveFrom(m_f);
+	arch << RECORD_MAGIC << static_cast<uint32_t>(length)
+		 << static_cast<uint64_t>(id);
+	if (m_f.Write(buf.getRawBufferData(), length) != length)
+		THROW_EXCEPTION("Error writing to the node data store");
+
+	auto& loc = m_index[id];
+	loc.offset = m_fileEnd + RECORD_HEADER_LEN;
+	loc.length = static_cast<uint32_t>(length);
+	m_fileEnd = loc.offset + length;
+
+	// Drop any former version of this node data from the cache:
+	if (auto it = m_cacheIndex.find(id); it != m_cacheIndex.end())
+	{
+		m_cache.erase(it->second);
+		m_cacheIndex.erase(it);
+	}
+	MRPT_END
+}
+
+mrpt::serialization::CSerializable::Ptr CNodeDataPagedStore::get(
+	const TNodeID id) const
+{
+	MRPT_START
+	std::lock_guard<std::mutex> lck(m_mtx);
+
+	if (auto it = m_cacheIndex.find(id); it != m_cacheIndex.end())
+	{
+		// Move to the front of the LRU list:
+		m_cache.splice(m_cache.begin(), m_cache, it->second);
+		return it->second->second;
+	}
+
+	const auto itIdx = m_index.find(id);
+	if (itIdx == m_index.end()) return {};
+	const auto& loc = itIdx->second;
+
+	std::vector<uint8_t> data(loc.length);
+	m_f.clearError();
+	m_f.Seek(loc.offset);
+	if (m_f.Read(data.data(), loc.length) != loc.length)
+		THROW_EXCEPTION("Error reading from the node data store");
+
+	CMemoryStream buf;
+	buf.assignMemoryNotOwn(data.data(), data.size());
+	auto obj = archiveFrom(buf).ReadObject();
+
+	cacheInsert(id, obj);
+	return obj;
+	MRPT_END
+}
+
+bool CNodeDataPagedStore::contains(const TNodeID id) const
+{
+	std::lock_guard<std::mutex> lck(m_mtx);
+	return m_index.count(id) != 0;
+}
+
+size_t CNodeDataPagedStore::size() const
+{
+	std::lock_guard<std::mutex> lck(m_mtx);
+	return m_index.size();
+}
+
+std::vector<TNodeID> CNodeDataPagedStore::getNodeIDs() const
+{
+	std::lock_guard<std::mutex> lck(m_mtx);
+	std::vector<TNodeID> ids;
+	ids.reserve(m_index.size());
+	for (const auto& e : m_index)
+		ids.push_back(e.first);
+	return ids;
+}
+
+size_t CNodeDataPagedStore::cachedObjectCount() const
+{
+	std::lock_guard<std::mutex> lck(m_mtx);
+	return m_cache.size();
+}
+
+void CNodeDataPagedStore::cacheInsert(
+	const TNodeID id, const mrpt::serialization::CSerializable::Ptr& obj) const
+{
+	if (!m_cacheSize) return;
+
+	if (auto it = m_cacheIndex.find(id); it != m_cacheIndex.end())
+	{
+		it->second->second = obj;
+		m_cache.splice(m_cache.begin(), m_cache, it->second);
+		return;
+	}
+	m_cache.emplace_front(id, obj);
+	m_cacheIndex[id] = m_cache.begin();
+	cacheShrink();
+}
+
+void CNodeDataPagedStore::cacheShrink() const
+{
+	while (m_cache.size() > m_cacheSize)
+	{
+		m_cacheIndex.erase(m_cache.back().first);
+		m_cache.pop_back();
+	}
+}
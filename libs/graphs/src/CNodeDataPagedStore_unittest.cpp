@@ -0,0 +1,135 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/graphs/CNodeDataPagedStore.h>
+#include <mrpt/io/CFileOutputStream.h>
+#include <mrpt/poses/CPose2D.h>
+#include <mrpt/poses/CPose3D.h>
+#include <mrpt/system/filesystem.h>
+
+#include <filesystem>
+
+using namespace mrpt::graphs;
+using namespace mrpt::poses;
+
+TEST(CNodeDataPagedStore, PutGetReopen)
+{
+	const std::string fil = mrpt::system::getTempFileName();
+	const size_t N = 500;
+
+	{
+		CNodeDataPagedStore store;
+		ASSERT_TRUE(store.open(fil, true /*truncate*/));
+		store.setCacheSize(10);
+		for (TNodeID i = 0; i < N; i++)
+			store.put(i, CPose2D(i, 2.0 * i, 0.001 * i));
+
+		EXPECT_EQ(store.size(), N);
+		EXPECT_EQ(store.cachedObjectCount(), 0U);
+		for (TNodeID i = 0; i < N; i++)
+		{
+			auto p = store.getAs<CPose2D>(i);
+			ASSERT_TRUE(p);
+			EXPECT_EQ(*p, CPose2D(i, 2.0 * i, 0.001 * i));
+		}
+		EXPECT_EQ(store.cachedObjectCount(), 10U);
+		EXPECT_FALSE(store.get(N));
+		EXPECT_FALSE(store.contains(N));
+
+		// Replace some nodes data, with another class:
+		for (TNodeID i = 0; i < N; i += 10)
+			store.put(i, CPose3D::Create(i, 1, 2, 0, 0, 0));
+
+		// Cached objects are shared:
+		auto p5a = store.get(5), p5b = store.get(5);
+		EXPECT_EQ(p5a, p5b);
+
+		// Wrong class:
+		EXPECT_THROW(store.getAs<CPose3D>(5), std::exception);
+	}
+
+	{
+		CNodeDataPagedStore store;
+		ASSERT_TRUE(store.open(fil));
+		EXPECT_EQ(store.size(), N);
+		const auto ids = store.getNodeIDs();
+		ASSERT_EQ(ids.size(), N);
+		EXPECT_EQ(ids.front(), 0U);
+		EXPECT_EQ(ids.back(), N - 1);
+
+		store.setCacheSize(0);
+		for (TNodeID i = 0; i < N; i++)
+		{
+			if (i % 10 == 0)
+			{
+				auto p = store.getAs<CPose3D>(i);
+				ASSERT_TRUE(p);
+				EXPECT_EQ(*p, CPose3D(i, 1, 2, 0, 0, 0));
+			}
+			else
+			{
+				auto p = store.getAs<CPose2D>(i);
+				ASSERT_TRUE(p);
+				EXPECT_EQ(*p, CPose2D(i, 2.0 * i, 0.001 * i));
+			}
+		}
+		EXPECT_EQ(store.cachedObjectCount(), 0U);
+
+		// Append new data to an existing store:
+		store.put(N, CPose2D(-1, -2, 0));
+	}
+
+	{
+		CNodeDataPagedStore store;
+		ASSERT_TRUE(store.open(fil));
+		EXPECT_EQ(store.size(), N + 1);
+		EXPECT_EQ(*store.getAs<CPose2D>(N), CPose2D(-1, -2, 0));
+	}
+	mrpt::system::deleteFile(fil);
+}
+
+TEST(CNodeDataPagedStore, TruncatedFile)
+{
+	const std::string fil = mrpt::system::getTempFileName();
+	{
+		CNodeDataPagedStore store;
+		ASSERT_TRUE(store.open(fil, true));
+		for (TNodeID i = 0; i < 10; i++)
+			store.put(i, CPose2D(i, 0, 0));
+	}
+
+	// Simulate a crash while writing the last record:
+	const auto fileSize = std::filesystem::file_size(fil);
+	std::filesystem::resize_file(fil, fileSize - 3);
+
+	{
+		CNodeDataPagedStore store;
+		ASSERT_TRUE(store.open(fil));
+		EXPECT_EQ(store.size(), 9U);
+		EXPECT_FALSE(store.contains(9));
+		store.put(9, CPose2D(9, 1, 0));
+	}
+	{
+		CNodeDataPagedStore store;
+		ASSERT_TRUE(store.open(fil));
+		EXPECT_EQ(store.size(), 10U);
+		EXPECT_EQ(*store.getAs<CPose2D>(8), CPose2D(8, 0, 0));
+		EXPECT_EQ(*store.getAs<CPose2D>(9), CPose2D(9, 1, 0));
+	}
+
+	// Not a store file:
+	{
+		mrpt::io::CFileOutputStream f(fil);
+		f.Write("Not a node store", 16);
+	}
+	CNodeDataPagedStore store;
+	EXPECT_FALSE(store.open(fil));
+	mrpt::system::deleteFile(fil);
+}
@@ -0,0 +1,97 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "graphs-precomp.h"	 // Precompiled headers
+//
+#include <mrpt/core/bits_math.h>  // d2f()
+#include <mrpt/graphs/CNodePosesSpatialIndex.h>
+
+#include <algorithm>
+
+using namespace mrpt::graphs;
+
+CNodePosesSpatialIndex::CNodePosesSpatialIndex()
+{
+	// Nodes are typically inserted one by one, as the graph grows:
+	kdtree_search_params.incremental = true;
+}
+
+void CNodePosesSpatialIndex::clear()
+{
+	m_ids.clear();
+	m_xyz.clear();
+	m_id2idx.clear();
+	kdtree_mark_as_outdated();
+}
+
+void CNodePosesSpatialIndex::insert(
+	const TNodeID id, const mrpt::math::TPoint3D& pt)
+{
+	const auto it = m_id2idx.find(id);
+	if (it != m_id2idx.end())
+	{
+		float* xyz = &m_xyz[3 * it->second];
+		const float x = d2f(pt.x), y = d2f(pt.y), z = d2f(pt.z);
+		if (xyz[0] == x && xyz[1] == y && xyz[2] == z) return;
+		xyz[0] = x;
+		xyz[1] = y;
+		xyz[2] = z;
+		kdtree_mark_as_outdated();
+		return;
+	}
+
+	m_id2idx[id] = m_ids.size();
+	m_ids.push_back(id);
+	m_xyz.push_back(d2f(pt.x));
+	m_xyz.push_back(d2f(pt.y));
+	m_xyz.push_back(d2f(pt.z));
+	kdtree_mark_points_appended();
+}
+
+bool CNodePosesSpatialIndex::getNodePosition(
+	const TNodeID id, mrpt::math::TPoint3D& pt) const
+{
+	const auto it = m_id2idx.find(id);
+	if (it == m_id2idx.end()) return false;
+	const float* xyz = &m_xyz[3 * it->second];
+	pt = mrpt::math::TPoint3D(xyz[0], xyz[1], xyz[2]);
+	return true;
+}
+
+std::vector<TNodeID> CNodePosesSpatialIndex::nodesWithinRadius(
+	const mrpt::math::TPoint3D& center, const double radius) const
+{
+	std::vector<std::pair<size_t, float>> found;
+	kdTreeRadiusSearch3D(
+		d2f(center.x), d2f(center.y), d2f(center.z), d2f(radius * radius),
+		found);
+
+	std::vector<TNodeID> ids;
+	ids.reserve(found.size());
+	for (const auto& idxDist : found)
+		ids.push_back(m_ids[idxDist.first]);
+	return ids;
+}
+
+std::vector<TNodeID> CNodePosesSpatialIndex::nearestNodes(
+	const mrpt::math::TPoint3D& pt, const size_t k) const
+{
+	std::vector<TNodeID> ids;
+	const size_t n = std::min(k, m_ids.size());
+	if (!n) return ids;
+
+	std::vector<size_t> idxs;
+	std::vector<float> distSqr;
+	kdTreeNClosestPoint3DIdx(pt, n, idxs, distSqr);
+
+	ids.reserve(n);
+	for (const size_t i : idxs)
+		ids.push_back(m_ids[i]);
+	return ids;
+}
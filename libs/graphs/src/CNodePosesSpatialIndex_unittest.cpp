@@ -0,0 +1,122 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/graphs/CNetworkOfPoses.h>
+#include <mrpt/graphs/CNodePosesSpatialIndex.h>
+#include <mrpt/poses/CPose3D.h>
+
+#include <algorithm>
+#include <random>
+
+using namespace mrpt::graphs;
+using namespace mrpt::poses;
+using mrpt::math::TPoint3D;
+
+namespace
+{
+// Linear search of the nodes within a radius, sorted by distance:
+template <class GRAPH_T>
+std::vector<TNodeID> bruteForceRadius(
+	const GRAPH_T& g, const TPoint3D& c, double radius)
+{
+	std::vector<std::pair<double, TNodeID>> found;
+	for (const auto& n : g.nodes)
+	{
+		const mrpt::math::TPose3D p(n.second.asTPose());
+		const double d = (TPoint3D(p.x, p.y, p.z) - c).norm();
+		if (d <= radius) found.emplace_back(d, n.first);
+	}
+	std::sort(found.begin(), found.end());
+	std::vector<TNodeID> ids;
+	for (const auto& f : found)
+		ids.push_back(f.second);
+	return ids;
+}
+}  // namespace
+
+TEST(CNodePosesSpatialIndex, RadiusSearch2D)
+{
+	std::mt19937 rng(123);
+	std::uniform_real_distribution<double> u(0, 100);
+
+	CNetworkOfPoses2D g;
+	CNodePosesSpatialIndex idx;
+	for (TNodeID i = 0; i < 2000; i++)
+	{
+		g.nodes[i] = CPose2D(u(rng), u(rng), 0);
+		// Insert nodes while querying, as the graph grows:
+		idx.insert(i, TPoint3D(g.nodes[i].x(), g.nodes[i].y(), 0));
+		if (i % 500 == 0)
+		{
+			const TPoint3D c(u(rng), u(rng), 0);
+			EXPECT_EQ(
+				idx.nodesWithinRadius(c, 10.0), bruteForceRadius(g, c, 10.0));
+		}
+	}
+	EXPECT_EQ(idx.size(), g.nodes.size());
+
+	for (int q = 0; q < 20; q++)
+	{
+		const TPoint3D c(u(rng), u(rng), 0);
+		const double r = u(rng) * 0.2;
+		EXPECT_EQ(idx.nodesWithinRadius(c, r), bruteForceRadius(g, c, r));
+	}
+
+	// Move some nodes:
+	for (TNodeID i = 0; i < 2000; i += 7)
+		g.nodes[i] = CPose2D(u(rng), u(rng), 0);
+	idx.insertAllNodes(g);
+	EXPECT_EQ(idx.size(), g.nodes.size());
+	for (int q = 0; q < 20; q++)
+	{
+		const TPoint3D c(u(rng), u(rng), 0);
+		EXPECT_EQ(idx.nodesWithinRadius(c, 8.0), bruteForceRadius(g, c, 8.0));
+	}
+
+	// Nearest nodes:
+	const TPoint3D c(50, 50, 0);
+	const auto nn = idx.nearestNodes(c, 5);
+	const auto all = bruteForceRadius(g, c, 1e6);
+	ASSERT_EQ(nn.size(), 5U);
+	for (size_t i = 0; i < nn.size(); i++)
+		EXPECT_EQ(nn[i], all[i]);
+
+	idx.clear();
+	EXPECT_TRUE(idx.empty());
+	EXPECT_TRUE(idx.nodesWithinRadius(c, 100.0).empty());
+	EXPECT_TRUE(idx.nearestNodes(c, 3).empty());
+}
+
+TEST(CNodePosesSpatialIndex, Graph3D)
+{
+	std::mt19937 rng(456);
+	std::uniform_real_distribution<double> u(-20, 20);
+
+	CNetworkOfPoses3D g;
+	for (TNodeID i = 0; i < 300; i++)
+		g.nodes[i * 3] = CPose3D(u(rng), u(rng), u(rng), 0, 0, 0);
+
+	CNodePosesSpatialIndex idx;
+	idx.insertAllNodes(g);
+	EXPECT_TRUE(idx.contains(0));
+	EXPECT_FALSE(idx.contains(1));
+
+	TPoint3D p;
+	ASSERT_TRUE(idx.getNodePosition(3, p));
+	EXPECT_NEAR(p.x, g.nodes[3].x(), 1e-4);
+	EXPECT_NEAR(p.z, g.nodes[3].z(), 1e-4);
+	EXPECT_FALSE(idx.getNodePosition(4, p));
+
+	for (int q = 0; q < 20; q++)
+	{
+		const TPoint3D c(u(rng), u(rng), u(rng));
+		EXPECT_EQ(idx.nodesWithinRadius(c, 7.0), bruteForceRadius(g, c, 7.0));
+	}
+}
@@ -9,10 +9,14 @@
 
 #include "graphs-precomp.h"	 // Precompiled headers
 //
+#include <mrpt/core/WorkerThreadsPool.h>
 #include <mrpt/graphs/ScalarFactorGraph.h>
 #include <mrpt/system/CTicTac.h>
 
 #include <Eigen/Dense>
+#include <algorithm>
+#include <thread>
+#include <tuple>
 
 using namespace mrpt;
 using namespace mrpt::graphs;
@@ -32,6 +36,7 @@ void ScalarFactorGraph::clear()
 	m_numNodes = 0;
 	m_factors_unary.clear();
 	m_factors_binary.clear();
+	m_chol.reset();
 }
 
 void ScalarFactorGraph::initialize(const size_t nodeCount)
@@ -39,6 +44,13 @@ void ScalarFactorGraph::initialize(const size_t nodeCount)
 	MRPT_LOG_DEBUG_STREAM("initialize() called, nodeCount=" << nodeCount);
 
 	m_numNodes = nodeCount;
+	m_chol.reset();
+}
+
+void ScalarFactorGraph::enableCholesky(bool enable)
+{
+	m_use_cholesky = enable;
+	if (!enable) m_chol.reset();
 }
 
 void ScalarFactorGraph::addConstraint(const UnaryFactorVirtualBase& c)
@@ -72,13 +84,6 @@ bool ScalarFactorGraph::eraseConstraint(const FactorBase& c)
 	return false;
 }
 
-/* Method:
-  (\Sigma)^{-1/2) *  d( h(x) )/d( x )  * x_incr = - (\Sigma)^{-1/2) * r(x)
-  ===================================            ========================
-			  =A                                           =b
-
-   A * x_incr = b         --> SparseQR.
-*/
 void ScalarFactorGraph::updateEstimation(
 	/** Output increment of the current estimate. Caller must add this
 	   vector to current state vector to obtain the optimal estimation. */
@@ -90,6 +95,314 @@ void ScalarFactorGraph::updateEstimation(
 
 	m_timelogger.enable(m_enable_profiler);
 
+	if (m_use_cholesky)
+	{
+		evaluateFactors();
+		if (updateCholesky())
+		{
+			solveCholesky(solved_x_inc, nullptr, solved_variances);
+			return;
+		}
+		MRPT_LOG_DEBUG(
+			"Not definite positive system, falling back to SparseQR");
+	}
+	solveSparseQR(solved_x_inc, solved_variances);
+}
+
+void ScalarFactorGraph::updateEstimation(
+	mrpt::math::CVectorDouble& solved_x_inc,
+	const std::vector<size_t>& varianceNodeIDs,
+	mrpt::math::CVectorDouble& solved_variances)
+{
+	ASSERTMSG_(m_numNodes > 0, "numNodes=0. Have you called initialize()?");
+	for (const size_t id : varianceNodeIDs)
+		ASSERT_LT_(id, m_numNodes);
+
+	m_timelogger.enable(m_enable_profiler);
+
+	if (m_use_cholesky)
+	{
+		evaluateFactors();
+		if (updateCholesky())
+		{
+			solveCholesky(solved_x_inc, &varianceNodeIDs, &solved_variances);
+			return;
+		}
+		MRPT_LOG_DEBUG(
+			"Not definite positive system, falling back to SparseQR");
+	}
+	mrpt::math::CVectorDouble allVariances;
+	solveSparseQR(solved_x_inc, &allVariances);
+	solved_variances.resize(varianceNodeIDs.size());
+	for (size_t k = 0; k < varianceNodeIDs.size(); k++)
+		solved_variances[k] = allVariances[varianceNodeIDs[k]];
+}
+
+namespace
+{
+// Runs fn(i) for i in [0,n) with up to nThreads threads (0: all cores):
+template <class FUNC>
+void runParallel(size_t n, unsigned int nThreads, FUNC&& fn)
+{
+	if (!nThreads) nThreads = std::max(1U, std::thread::hardware_concurrency());
+	nThreads = static_cast<unsigned int>(std::min<size_t>(nThreads, n));
+	if (nThreads <= 1)
+	{
+		for (size_t i = 0; i < n; i++)
+			fn(i);
+		return;
+	}
+	// The calling thread also runs chunks:
+	mrpt::WorkerThreadsPool pool(
+		nThreads - 1, mrpt::WorkerThreadsPool::POLICY_FIFO, "gmrf");
+	pool.parallel_for(0, n, std::max<size_t>(1, n / (8 * nThreads)), fn);
+}
+}  // namespace
+
+// Evaluates w*J'*J and -w*J'*r for all factors, in parallel:
+void ScalarFactorGraph::evaluateFactors()
+{
+	mrpt::system::CTimeLoggerEntry tle(m_timelogger, "GMRF.evaluate");
+
+	const size_t m1 = m_factors_unary.size(), m2 = m_factors_binary.size();
+	m_unary_terms.resize(m1);
+	m_binary_terms.resize(m2);
+
+	runParallel(m1 + m2, m_num_threads, [&](size_t k) {
+		if (k < m1)
+		{
+			const auto* e = m_factors_unary[k];
+			ASSERT_(e != nullptr);
+			ASSERT_LT_(e->node_id, m_numNodes);
+			const double w = e->getInformation();
+			double dr_dx;
+			e->evalJacobian(dr_dx);
+			auto& t = m_unary_terms[k];
+			t.node = e->node_id;
+			t.h = w * dr_dx * dr_dx;
+			t.g = -w * dr_dx * e->evaluateResidual();
+		}
+		else
+		{
+			const auto* e = m_factors_binary[k - m1];
+			ASSERT_(e != nullptr);
+			ASSERT_LT_(e->node_id_i, m_numNodes);
+			ASSERT_LT_(e->node_id_j, m_numNodes);
+			const double w = e->getInformation();
+			double dr_dxi, dr_dxj;
+			e->evalJacobian(dr_dxi, dr_dxj);
+			const double wr = w * e->evaluateResidual();
+			auto& t = m_binary_terms[k - m1];
+			t.i = e->node_id_i;
+			t.j = e->node_id_j;
+			t.hii = w * dr_dxi * dr_dxi;
+			t.hij = w * dr_dxi * dr_dxj;
+			t.hjj = w * dr_dxj * dr_dxj;
+			t.gi = -dr_dxi * wr;
+			t.gj = -dr_dxj * wr;
+		}
+	});
+}
+
+bool ScalarFactorGraph::updateCholesky()
+{
+	using mrpt::math::CSparseMatrix;
+
+	const size_t n = m_numNodes;
+
+	// (node, h) of each unary factor:
+	std::unordered_map<const UnaryFactorVirtualBase*, std::pair<size_t, double>>
+		unaryTerms;
+	unaryTerms.reserve(m_factors_unary.size());
+	for (size_t k = 0; k < m_factors_unary.size(); k++)
+	{
+		const auto& t = m_unary_terms[k];
+		auto [it, isNew] =
+			unaryTerms.try_emplace(m_factors_unary[k], t.node, t.h);
+		if (!isNew) it->second.second += t.h;	// The same factor twice
+	}
+
+	// Incremental update: only possible if binary terms did not change.
+	const auto sameBinary = [](const BinaryTerm& a, const BinaryTerm& b) {
+		return a.i == b.i && a.j == b.j && a.hii == b.hii && a.hij == b.hij &&
+			a.hjj == b.hjj;
+	};
+	if (m_chol && m_max_rank_updates > 0 &&
+		m_binary_terms.size() == m_chol_binary_terms.size() &&
+		std::equal(
+			m_binary_terms.begin(), m_binary_terms.end(),
+			m_chol_binary_terms.begin(), sameBinary))
+	{
+		mrpt::system::CTimeLoggerEntry tle(m_timelogger, "GMRF.chol_updown");
+
+		// Changes of the diagonal of H, per node:
+		std::unordered_map<size_t, double> deltas;
+		for (const auto& [f, nh] : unaryTerms)
+		{
+			const auto it = m_chol_unary_terms.find(f);
+			if (it == m_chol_unary_terms.end()) deltas[nh.first] += nh.second;
+			else if (it->second != nh)
+			{
+				deltas[nh.first] += nh.second;
+				deltas[it->second.first] -= it->second.second;
+			}
+		}
+		for (const auto& [f, nh] : m_chol_unary_terms)
+			if (!unaryTerms.count(f)) deltas[nh.first] -= nh.second;
+
+		if (deltas.size() <= m_max_rank_updates)
+		{
+			try
+			{
+				// Updates first, then downdates, so intermediate matrices
+				// remain definite positive when possible:
+				for (int pass = 0; pass < 2; pass++)
+					for (const auto& [node, d] : deltas)
+						if ((d > 0) == (pass == 0) && d != 0)
+							m_chol->rankOneUpdate(
+								{{node, std::sqrt(std::abs(d))}}, d < 0);
+
+				m_chol_unary_terms = std::move(unaryTerms);
+				return true;
+			}
+			catch (const mrpt::math::CExceptionNotDefPos&)
+			{
+				// Invalid factorization now: compute it from scratch below.
+			}
+		}
+	}
+
+	// Build the upper triangular part of H:
+	// -------------------------------------------
+	CSparseMatrix H(n, n);
+	{
+		mrpt::system::CTimeLoggerEntry tle(m_timelogger, "GMRF.build_H");
+
+		std::vector<double> diag(n, 0.0);
+		for (const auto& t : m_unary_terms)
+			diag[t.node] += t.h;
+
+		// Cross terms, merged since the compressed matrix would keep
+		// duplicated entries:
+		std::vector<std::tuple<size_t, size_t, double>> offDiag;
+		offDiag.reserve(m_binary_terms.size());
+		for (const auto& t : m_binary_terms)
+		{
+			if (t.i == t.j)
+			{
+				diag[t.i] += t.hii + 2 * t.hij + t.hjj;
+				continue;
+			}
+			diag[t.i] += t.hii;
+			diag[t.j] += t.hjj;
+			offDiag.emplace_back(std::min(t.i, t.j), std::max(t.i, t.j), t.hij);
+		}
+		std::sort(
+			offDiag.begin(), offDiag.end(), [](const auto& a, const auto& b) {
+				return std::tie(std::get<1>(a), std::get<0>(a)) <
+					std::tie(std::get<1>(b), std::get<0>(b));
+			});
+
+		// All diagonal entries are structural nonzeros, as required by
+		// rank-one updates:
+		for (size_t i = 0; i < n; i++)
+			H.insert_entry_fast(i, i, diag[i]);
+		for (size_t k = 0; k < offDiag.size();)
+		{
+			const auto [r, c, v0] = offDiag[k];
+			double v = v0;
+			for (k++; k < offDiag.size() && std::get<0>(offDiag[k]) == r &&
+				 std::get<1>(offDiag[k]) == c;
+				 k++)
+				v += std::get<2>(offDiag[k]);
+			H.insert_entry_fast(r, c, v);
+		}
+		H.compressFromTriplet();
+	}
+
+	// Factorize:
+	// -------------------------------------------
+	{
+		mrpt::system::CTimeLoggerEntry tle(m_timelogger, "GMRF.chol_factor");
+		try
+		{
+			if (m_chol && m_chol->hasSameSparsityPattern(H)) m_chol->update(H);
+			else
+				m_chol = std::make_unique<CSparseMatrix::CholeskyDecomp>(H);
+		}
+		catch (const mrpt::math::CExceptionNotDefPos&)
+		{
+			m_chol.reset();
+			return false;
+		}
+	}
+	m_chol_binary_terms = m_binary_terms;
+	m_chol_unary_terms = std::move(unaryTerms);
+	return true;
+}
+
+void ScalarFactorGraph::solveCholesky(
+	mrpt::math::CVectorDouble& solved_x_inc,
+	const std::vector<size_t>* varianceNodeIDs,
+	mrpt::math::CVectorDouble* solved_variances)
+{
+	const size_t n = m_numNodes;
+
+	// Gradient:
+	mrpt::math::CVectorDouble g;
+	g.setZero(n);
+	for (const auto& t : m_unary_terms)
+		g[t.node] += t.g;
+	for (const auto& t : m_binary_terms)
+	{
+		g[t.i] += t.gi;
+		g[t.j] += t.gj;
+	}
+
+	{
+		mrpt::system::CTimeLoggerEntry tle(m_timelogger, "GMRF.solve");
+		m_chol->backsub(g, solved_x_inc);
+	}
+
+	if (!solved_variances) return;
+
+	mrpt::system::CTimeLoggerEntry tle(m_timelogger, "GMRF.variance");
+
+	std::vector<size_t> allNodes;
+	if (!varianceNodeIDs)
+	{
+		allNodes.resize(n);
+		for (size_t i = 0; i < n; i++)
+			allNodes[i] = i;
+		varianceNodeIDs = &allNodes;
+	}
+
+	// Each variance is independent from the others, so split them in chunks:
+	const size_t nVars = varianceNodeIDs->size(), chunk = 256;
+	const size_t nChunks = (nVars + chunk - 1) / chunk;
+	solved_variances->resize(nVars);
+	runParallel(nChunks, m_num_threads, [&](size_t c) {
+		const auto first = varianceNodeIDs->begin() + c * chunk;
+		const std::vector<size_t> ids(
+			first, first + std::min(chunk, nVars - c * chunk));
+		mrpt::math::CVectorDouble vars;
+		m_chol->getInverseDiagonal(ids, vars);
+		for (size_t k = 0; k < ids.size(); k++)
+			(*solved_variances)[c * chunk + k] = vars[k];
+	});
+}
+
+/* Method:
+  (\Sigma)^{-1/2) *  d( h(x) )/d( x )  * x_incr = - (\Sigma)^{-1/2) * r(x)
+  ===================================            ========================
+			  =A                                           =b
+
+   A * x_incr = b         --> SparseQR.
+*/
+void ScalarFactorGraph::solveSparseQR(
+	mrpt::math::CVectorDouble& solved_x_inc,
+	mrpt::math::CVectorDouble* solved_variances)
+{
 #if EIGEN_VERSION_AT_LEAST(3, 1, 0)
 
 	// Number of vertices:
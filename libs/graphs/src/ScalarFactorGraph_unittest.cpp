@@ -178,4 +178,80 @@ TEST(ScalarFactorGraph, MiniMRF_BinaryEdges)
 	}
 }
 
+TEST(ScalarFactorGraph, IncrementalCholeskyMatchesSparseQR)
+{
+	// A 10x10 grid with binary edges between neighbors, and observations:
+	const size_t W = 10, N = W * W;
+	vector<double> my_map(N, .0);
+
+	std::deque<MySimpleBinaryEdge> binEdges;
+	for (size_t r = 0; r < W; r++)
+		for (size_t c = 0; c < W; c++)
+		{
+			const size_t i = r * W + c;
+			if (c + 1 < W) binEdges.emplace_back(my_map, i, i + 1, 2.0);
+			if (r + 1 < W) binEdges.emplace_back(my_map, i, i + W, 2.0);
+		}
+	std::deque<MySimpleUnaryEdge> obs;
+	for (size_t i = 0; i < N; i += 7)
+		obs.emplace_back(my_map, i, 0.1 * i, 1.0 + 0.01 * i);
+
+	// Incremental Cholesky, always refactorized Cholesky, and SparseQR:
+	ScalarFactorGraph gmrf, gmrfFull, gmrfQR;
+	gmrf.setNumThreads(2);
+	gmrfFull.setMaxRankUpdates(0);
+	gmrfQR.enableCholesky(false);
+	const auto all = {&gmrf, &gmrfFull, &gmrfQR};
+	for (auto* g : all)
+	{
+		g->initialize(N);
+		for (const auto& e : binEdges)
+			g->addConstraint(e);
+		for (const auto& e : obs)
+			g->addConstraint(e);
+	}
+
+	const std::vector<size_t> someNodes = {0, 13, 57, 99};
+	const auto check = [&]() {
+		mrpt::math::CVectorDouble x1, v1, x2, v2, x3, vs;
+		gmrf.updateEstimation(x1, &v1);
+		gmrfFull.updateEstimation(x2, &v2);
+		gmrfQR.updateEstimation(x3);
+		ASSERT_EQ(x1.size(), x3.size());
+		for (size_t i = 0; i < N; i++)
+		{
+			EXPECT_NEAR(x1[i], x3[i], 1e-8);
+			EXPECT_NEAR(x1[i], x2[i], 1e-8);
+			EXPECT_NEAR(v1[i], v2[i], 1e-8);
+		}
+		gmrf.updateEstimation(x1, someNodes, vs);
+		ASSERT_EQ(vs.size(), someNodes.size());
+		for (size_t k = 0; k < someNodes.size(); k++)
+			EXPECT_NEAR(vs[k], v2[someNodes[k]], 1e-8);
+	};
+	check();
+
+	// Rank-one updates, then downdates:
+	obs.emplace_back(my_map, 5, 3.0, 4.0);
+	obs.emplace_back(my_map, 42, -1.0, 0.5);
+	for (auto* g : all)
+	{
+		g->addConstraint(obs[obs.size() - 2]);
+		g->addConstraint(obs.back());
+	}
+	check();
+
+	for (auto* g : all)
+	{
+		EXPECT_TRUE(g->eraseConstraint(obs[0]));
+		EXPECT_TRUE(g->eraseConstraint(obs[3]));
+	}
+	check();
+
+	// Full refactorization after changing the graph:
+	for (auto* g : all)
+		EXPECT_TRUE(g->eraseConstraint(binEdges[10]));
+	check();
+}
+
 #endif	// Eigen>=3.1
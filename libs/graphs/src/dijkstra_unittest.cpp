@@ -0,0 +1,154 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/graphs/CNetworkOfPoses.h>
+#include <mrpt/graphs/dijkstra.h>
+
+#include <random>
+
+using namespace mrpt::graphs;
+using namespace mrpt::poses;
+
+namespace
+{
+using graph_t = CNetworkOfPoses2D;
+using dijkstra_t = CDijkstra<graph_t>;
+
+// Random nodes in a square, each one linked to some of the next ones with
+// edges consistent with node poses:
+graph_t randomGraph(size_t nNodes, unsigned int seed)
+{
+	std::mt19937 rng(seed);
+	std::uniform_real_distribution<double> u(0, 100);
+	graph_t g;
+	for (TNodeID i = 0; i < nNodes; i++)
+		g.nodes[i] = CPose2D(u(rng), u(rng), 0);
+	for (TNodeID i = 0; i + 1 < nNodes; i++)
+	{
+		const TNodeID j = std::min<TNodeID>(nNodes - 1, i + 1 + rng() % 10);
+		for (const TNodeID k : {i + 1, j})
+			if (!g.edgeExists(i, k))
+				g.insertEdge(i, k, g.nodes[k] - g.nodes[i]);
+		// Some arcs in the opposite direction:
+		const TNodeID l = rng() % nNodes;
+		if (l != i && !g.edgeExists(i, l) && !g.edgeExists(l, i))
+			g.insertEdge(l, i, g.nodes[i] - g.nodes[l]);
+	}
+	return g;
+}
+
+// Reference distances, by Bellman-Ford:
+std::vector<double> referenceDistances(const graph_t& g, TNodeID src)
+{
+	std::vector<double> d(g.nodes.size(), std::numeric_limits<double>::max());
+	d[src] = 0;
+	for (size_t it = 0; it < g.nodes.size(); it++)
+		for (const auto& e : g.edges)
+		{
+			const auto [a, b] = e.first;
+			const double w = e.second.norm();
+			if (d[a] + w < d[b]) d[b] = d[a] + w;
+			if (d[b] + w < d[a]) d[a] = d[b] + w;
+		}
+	return d;
+}
+
+// Checks a path is contiguous from `src` to `dst`, and returns its length:
+double pathLength(
+	const graph_t& g, const dijkstra_t::edge_list_t& path, TNodeID src,
+	TNodeID dst)
+{
+	double len = 0;
+	TNodeID cur = src;
+	for (const auto& arc : path)
+	{
+		EXPECT_TRUE(arc.first == cur || arc.second == cur);
+		cur = arc.first == cur ? arc.second : arc.first;
+		len += g.edges.find(arc)->second.norm();
+	}
+	EXPECT_EQ(cur, dst);
+	return len;
+}
+}  // namespace
+
+TEST(CDijkstra, FullTreeDistances)
+{
+	const auto g = randomGraph(300, 1);
+	const auto ref = referenceDistances(g, 0);
+
+	const dijkstra_t dij(g, 0, &graph_t::dijkstra_edge_length);
+	for (TNodeID i = 0; i < g.nodes.size(); i++)
+	{
+		ASSERT_TRUE(dij.getNodeDistanceToRoot(i).has_value());
+		EXPECT_NEAR(*dij.getNodeDistanceToRoot(i), ref[i], 1e-9);
+		EXPECT_NEAR(
+			pathLength(g, dij.getShortestPathTo(i), 0, i), ref[i], 1e-9);
+	}
+
+	// Topological distances, dense maps:
+	const CDijkstra<graph_t, mrpt::containers::map_traits_map_as_vector> hops(
+		g, 0);
+	EXPECT_EQ(*hops.getNodeDistanceToRoot(1), 1.0);
+	EXPECT_EQ(
+		hops.getShortestPathTo(299).size(), *hops.getNodeDistanceToRoot(299));
+}
+
+TEST(CDijkstra, PointToPointAStarAndBidirectional)
+{
+	const auto g = randomGraph(500, 2);
+	const auto w = &graph_t::dijkstra_edge_length;
+	std::mt19937 rng(3);
+
+	for (int k = 0; k < 20; k++)
+	{
+		const TNodeID src = rng() % 500, dst = rng() % 500;
+		const double ref = referenceDistances(g, src)[dst];
+
+		const dijkstra_t p2p(g, src, dst, w);
+		EXPECT_NEAR(*p2p.getNodeDistanceToRoot(dst), ref, 1e-9);
+		EXPECT_NEAR(
+			pathLength(g, p2p.getShortestPathTo(dst), src, dst), ref, 1e-9);
+
+		const dijkstra_t astar(
+			g, src, dst, w, &graph_t::dijkstra_heuristic_euclidean,
+			p2p.getCachedAdjacencyMatrixPtr());
+		EXPECT_NEAR(
+			pathLength(g, astar.getShortestPathTo(dst), src, dst), ref, 1e-9);
+
+		dijkstra_t::edge_list_t path;
+		double dist = 0;
+		ASSERT_TRUE(dijkstra_t::getShortestPathBidirectional(
+			g, src, dst, path, w, &dist));
+		EXPECT_NEAR(dist, ref, 1e-9);
+		EXPECT_NEAR(pathLength(g, path, src, dst), ref, 1e-9);
+	}
+}
+
+TEST(CDijkstra, CachedTrees)
+{
+	const auto g = randomGraph(100, 4);
+	CDijkstraCache<graph_t> cache(g, 2, &graph_t::dijkstra_edge_length);
+
+	const auto t0 = cache.getTree(0);
+	EXPECT_EQ(t0->getRootNodeID(), 0U);
+	EXPECT_EQ(cache.getTree(0), t0);
+	cache.getTree(10);
+	cache.getTree(0);  // Now 10 is the least recently used tree
+	cache.getTree(20);
+	EXPECT_EQ(cache.size(), 2U);
+	EXPECT_TRUE(cache.contains(0));
+	EXPECT_FALSE(cache.contains(10));
+	EXPECT_EQ(
+		cache.getShortestPath(20, 25),
+		cache.getTree(20)->getShortestPathTo(25));
+
+	cache.clear();
+	EXPECT_EQ(cache.size(), 0U);
+}
@@ -15,6 +15,9 @@
 // Graph SLAM: Batch solvers
 #include "graphslam/levmarq.h"
 
+// Graph SLAM: Incremental solvers
+#include "graphslam/CIncrementalSmoother.h"
+
 // Interfaces for implementing deciders/optimizers
 #include "graphslam/interfaces/CEdgeRegistrationDecider.h"
 #include "graphslam/interfaces/CGraphSlamOptimizer.h"
@@ -34,11 +37,13 @@
 
 // GraphSlamOptimizers
 #include "graphslam/GSO/CEmptyGSO.h"
+#include "graphslam/GSO/CIncrementalSmoothingGSO.h"
 #include "graphslam/GSO/CLevMarqGSO.h"
 
 // Graph SLAM Engine - Relevant headers
 #include "graphslam/misc/CEdgeCounter.h"
 #include "graphslam/misc/CRangeScanOps.h"
+#include "graphslam/misc/CScanDescriptorIndex.h"
 #include "graphslam/misc/CWindowManager.h"
 #include "graphslam/misc/CWindowObserver.h"
 #include "graphslam/misc/TSlidingWindow.h"
@@ -50,3 +55,4 @@
 
 // Main graphslam-engine header
 #include "graphslam/CGraphSlamEngine.h"
+#include "graphslam/CMultiSessionMapMerger.h"
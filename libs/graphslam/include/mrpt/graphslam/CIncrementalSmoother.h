@@ -0,0 +1,167 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/graphslam/types.h>
+// (Must come *after* "types.h" above)
+#include <mrpt/graphslam/levmarq_impl.h>  // Aux classes
+
+#include <map>
+#include <set>
+#include <vector>
+
+namespace mrpt::graphslam
+{
+/** Incremental smoothing of a graph of pose constraints, in the spirit of
+ * iSAM/iSAM2 (Kaess et al.): instead of solving the whole problem again each
+ * time a node or an edge is added, it keeps the square-root information
+ * matrix \f$ R \f$ (the Cholesky factor of \f$ J^\top \Lambda J \f$) and only
+ * updates its affected part.
+ *
+ * Call update() after adding nodes and edges to the graph: new edges are
+ * linearized, the factor is updated, one Gauss-Newton step is done and the
+ * new estimates are written back to `graph.nodes`. Details:
+ *  - Nodes are eliminated in the order they first appear in an edge (i.e.
+ * chronologically in SLAM). A new edge only changes the rows of \f$ R \f$
+ * from its oldest node on, so odometry-like edges re-eliminate just the last
+ * nodes, and a loop closure re-eliminates back to the oldest node it links.
+ *  - Back-substitution starts at the newest node and only propagates to older
+ * nodes while their solution changes by more than
+ * TOptions::wildfire_threshold ("wildfire" updates).
+ *  - Edges are kept linearized at the pose estimates they were added with.
+ * Only once every TOptions::relinearize_skip updates, the nodes that moved
+ * more than TOptions::relinearize_threshold away from their linearization
+ * point are relinearized, together with their edges
+ * ("fluid relinearization").
+ *
+ * The graph root node is kept fixed. Existing edges must not be modified;
+ * if edges are removed, the next update() starts over from scratch.
+ *
+ * \sa optimize_graph_spa_levmarq(),
+ * mrpt::graphslam::optimizers::CIncrementalSmoothingGSO
+ * \note (New in MRPT 2.4.9)
+ * \ingroup mrpt_graphslam_grp
+ */
+template <class GRAPH_T>
+class CIncrementalSmoother
+{
+   public:
+	using gst = graphslam_traits<GRAPH_T>;
+	using pose_t = typename gst::edge_poses_type;
+	using matrix_TxT = typename gst::matrix_TxT;
+	using Array_O = typename gst::Array_O;
+	static constexpr size_t DIMS_POSE = gst::SE_TYPE::DOFs;
+
+	struct TOptions
+	{
+		/** Nodes whose increment from their linearization point is larger
+		 * than this (infinity norm: meters or radians) are relinearized */
+		double relinearize_threshold = 0.05;
+		/** Check for nodes to relinearize every this number of updates */
+		unsigned int relinearize_skip = 10;
+		/** Back-substitution only goes on to older nodes while the solution
+		 * of a node changes by more than this (infinity norm). 0: update all
+		 * the nodes whose solution changes at all. */
+		double wildfire_threshold = 1e-3;
+	};
+
+	/** Statistics of the last call to update() */
+	struct TUpdateInfo
+	{
+		size_t new_nodes = 0, new_edges = 0;
+		size_t relinearized_nodes = 0;
+		/** Number of nodes (columns of R) eliminated again */
+		size_t reeliminated_nodes = 0;
+		/** Number of nodes whose estimate was updated in back-substitution */
+		size_t updated_nodes = 0;
+	};
+
+	/** Options of the next calls to update() */
+	TOptions options;
+
+	/** Incorporates the nodes and edges added to `graph` since the last
+	 * call, and updates the estimated poses in `graph.nodes`. */
+	void update(GRAPH_T& graph, TUpdateInfo* out_info = nullptr);
+
+	/** Like update(), but relinearizes all the edges first, e.g. to
+	 * converge after a big change in the estimate (a batch Gauss-Newton
+	 * iteration) */
+	void relinearizeAll(GRAPH_T& graph, TUpdateInfo* out_info = nullptr);
+
+	/** Forgets everything: the next update() starts from scratch */
+	void clear();
+
+	/** Number of nodes being optimized (all but the root) */
+	size_t nodeCount() const { return m_vars.size(); }
+	/** Number of edges incorporated so far */
+	size_t edgeCount() const { return m_factors.size(); }
+	/** Number of nonzero blocks of the square-root information matrix */
+	size_t factorNonZeroBlocks() const;
+
+   private:
+	static constexpr size_t INVALID_IDX = static_cast<size_t>(-1);
+
+	/** A node, and its column in the (lower triangular) factor L=R^t */
+	struct TVariable
+	{
+		mrpt::graphs::TNodeID id;
+		/** Linearization point, and the current increment from it */
+		pose_t x0;
+		Array_O delta;
+		/** Lower triangular part of the information matrix: H(r,id), by row
+		 * index r>=id, and the gradient at the linearization point */
+		std::map<size_t, matrix_TxT> H;
+		Array_O g;
+		/** Column of L, by row index (the diagonal block first) */
+		std::map<size_t, matrix_TxT> L;
+		/** Columns j<id with a nonzero block L(id,j) */
+		std::set<size_t> Lrow;
+		/** Solution of L*y=-g */
+		Array_O y;
+		/** Indices of the edges of this node in m_factors */
+		std::vector<size_t> factors;
+	};
+
+	/** An edge, with its linearization */
+	struct TFactor
+	{
+		/** A copy of the edge, since the graph may reallocate it */
+		typename gst::edge_map_entry_t edge;
+		/** Indices of its nodes in m_vars (INVALID_IDX: the root) */
+		size_t v1 = INVALID_IDX, v2 = INVALID_IDX;
+		/** Blocks of J^t*Lambda*J and J^t*Lambda*err */
+		matrix_TxT H11, H12, H22;
+		Array_O g1, g2;
+	};
+
+	std::vector<TVariable> m_vars;
+	std::map<mrpt::graphs::TNodeID, size_t> m_var_index;
+	std::vector<TFactor> m_factors;
+	/** Number of edges already incorporated, for each pair of nodes */
+	std::map<mrpt::graphs::TPairNodeIDs, size_t> m_known_edges;
+	mrpt::graphs::TNodeID m_root = mrpt::graphs::INVALID_NODEID;
+	pose_t m_root_pose;
+	unsigned int m_updates_since_relinearization = 0;
+
+	void internalUpdate(GRAPH_T& graph, bool relinearize_all, TUpdateInfo& ui);
+	/** Adds new edges to m_factors, returning the oldest affected node */
+	size_t addNewEdges(GRAPH_T& graph, TUpdateInfo& ui);
+	size_t relinearize(bool all, TUpdateInfo& ui);
+	void linearize(TFactor& f) const;
+	/** Adds (sign=1) or removes (sign=-1) an edge from H and g */
+	void addToSystem(const TFactor& f, double sign);
+	/** Computes columns [k,n) of L, and of y */
+	void eliminateFrom(size_t k);
+	/** Solves L^t*delta=y from the newest node back, while needed */
+	void backSubstitute(size_t k, GRAPH_T& graph, TUpdateInfo& ui);
+};
+
+}  // namespace mrpt::graphslam
+
+#include "CIncrementalSmoother_impl.h"
@@ -0,0 +1,332 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/core/exceptions.h>
+
+#include <Eigen/Dense>
+#include <algorithm>
+#include <functional>
+
+namespace mrpt::graphslam
+{
+template <class GRAPH_T>
+void CIncrementalSmoother<GRAPH_T>::update(
+	GRAPH_T& graph, TUpdateInfo* out_info)
+{
+	TUpdateInfo ui;
+	internalUpdate(graph, false, ui);
+	if (out_info) *out_info = ui;
+}
+
+template <class GRAPH_T>
+void CIncrementalSmoother<GRAPH_T>::relinearizeAll(
+	GRAPH_T& graph, TUpdateInfo* out_info)
+{
+	TUpdateInfo ui;
+	internalUpdate(graph, true, ui);
+	if (out_info) *out_info = ui;
+}
+
+template <class GRAPH_T>
+void CIncrementalSmoother<GRAPH_T>::clear()
+{
+	m_vars.clear();
+	m_var_index.clear();
+	m_factors.clear();
+	m_known_edges.clear();
+	m_root = mrpt::graphs::INVALID_NODEID;
+	m_updates_since_relinearization = 0;
+}
+
+template <class GRAPH_T>
+size_t CIncrementalSmoother<GRAPH_T>::factorNonZeroBlocks() const
+{
+	size_t n = 0;
+	for (const auto& v : m_vars)
+		n += v.L.size();
+	return n;
+}
+
+template <class GRAPH_T>
+void CIncrementalSmoother<GRAPH_T>::internalUpdate(
+	GRAPH_T& graph, bool relinearize_all, TUpdateInfo& ui)
+{
+	MRPT_START
+
+	// Removed edges, or a new root: start over.
+	if (graph.edges.size() < m_factors.size() ||
+		(m_root != mrpt::graphs::INVALID_NODEID && graph.root != m_root))
+		clear();
+	if (m_root == mrpt::graphs::INVALID_NODEID)
+	{
+		m_root = graph.root;
+		const auto itRoot = graph.nodes.find(m_root);
+		ASSERTMSG_(itRoot != graph.nodes.end(), "Root node has no pose");
+		m_root_pose = itRoot->second;
+	}
+
+	// Relinearize the nodes with the increments of the last update first,
+	// then linearize new edges around the same points:
+	size_t k = INVALID_IDX;
+	if (relinearize_all || ++m_updates_since_relinearization >=
+							   std::max(1U, options.relinearize_skip))
+	{
+		m_updates_since_relinearization = 0;
+		k = relinearize(relinearize_all, ui);
+	}
+	k = std::min(k, addNewEdges(graph, ui));
+	if (k == INVALID_IDX) return;  // Nothing changed
+
+	eliminateFrom(k);
+	ui.reeliminated_nodes = m_vars.size() - k;
+	backSubstitute(k, graph, ui);
+
+	MRPT_END
+}
+
+template <class GRAPH_T>
+size_t CIncrementalSmoother<GRAPH_T>::addNewEdges(
+	GRAPH_T& graph, TUpdateInfo& ui)
+{
+	size_t k = INVALID_IDX;
+	if (graph.edges.size() == m_factors.size()) return k;
+
+	// Find the new edges: those beyond the known count for each pair of
+	// nodes (new edges between the same nodes come last in the multimap).
+	std::vector<const typename gst::edge_map_entry_t*> new_edges;
+	std::set<mrpt::graphs::TNodeID> new_nodes;
+	for (auto it = graph.edges.begin(); it != graph.edges.end();)
+	{
+		const auto ids = it->first;
+		size_t& known = m_known_edges[ids];
+		for (size_t i = 0; it != graph.edges.end() && it->first == ids;
+			 ++it, ++i)
+		{
+			if (i < known) continue;
+			known++;
+			if (ids.first == ids.second) continue;
+			new_edges.push_back(&*it);
+			for (const auto id : {ids.first, ids.second})
+				if (id != m_root && !m_var_index.count(id))
+					new_nodes.insert(id);
+		}
+	}
+
+	// New nodes, in chronological (ID) order:
+	for (const auto id : new_nodes)
+	{
+		const auto itNode = graph.nodes.find(id);
+		ASSERTMSG_(
+			itNode != graph.nodes.end(),
+			mrpt::format("Edge node %u has no global pose", unsigned(id)));
+		m_var_index[id] = m_vars.size();
+		TVariable& v = m_vars.emplace_back();
+		v.id = id;
+		v.x0 = itNode->second;
+		v.delta.setZero();
+		v.g.setZero();
+		v.y.setZero();
+	}
+	ui.new_nodes = new_nodes.size();
+	if (!new_nodes.empty()) k = m_vars.size() - new_nodes.size();
+
+	for (const auto* e : new_edges)
+	{
+		TFactor& f = m_factors.emplace_back(TFactor{*e});
+		if (e->first.first != m_root) f.v1 = m_var_index.at(e->first.first);
+		if (e->first.second != m_root) f.v2 = m_var_index.at(e->first.second);
+		const size_t idx = m_factors.size() - 1;
+		for (const size_t v : {f.v1, f.v2})
+		{
+			if (v == INVALID_IDX) continue;
+			m_vars[v].factors.push_back(idx);
+			k = std::min(k, v);
+		}
+		linearize(f);
+		addToSystem(f, 1.0);
+	}
+	ui.new_edges = new_edges.size();
+	return k;
+}
+
+template <class GRAPH_T>
+size_t CIncrementalSmoother<GRAPH_T>::relinearize(bool all, TUpdateInfo& ui)
+{
+	std::set<size_t> factors;
+	for (auto& v : m_vars)
+	{
+		const double change =
+			v.delta.asEigen().template lpNorm<Eigen::Infinity>();
+		if (!all && change <= options.relinearize_threshold) continue;
+		if (change > 0) v.x0 = v.x0 + gst::SE_TYPE::exp(v.delta);
+		v.delta.setZero();
+		factors.insert(v.factors.begin(), v.factors.end());
+		ui.relinearized_nodes++;
+	}
+
+	size_t k = INVALID_IDX;
+	for (const size_t i : factors)
+	{
+		TFactor& f = m_factors[i];
+		addToSystem(f, -1.0);
+		linearize(f);
+		addToSystem(f, 1.0);
+		k = std::min({k, f.v1, f.v2});
+	}
+	return k;
+}
+
+template <class GRAPH_T>
+void CIncrementalSmoother<GRAPH_T>::linearize(TFactor& f) const
+{
+	using aux_t = detail::AuxErrorEval<typename gst::edge_t, gst>;
+
+	const pose_t& P1 = f.v1 == INVALID_IDX ? m_root_pose : m_vars[f.v1].x0;
+	const pose_t& P2 = f.v2 == INVALID_IDX ? m_root_pose : m_vars[f.v2].x0;
+	const pose_t& EDGE_POSE = f.edge.second.getPoseMean();
+
+	// Residual: inv(EDGE) * inv(P1) * P2, as in optimize_graph_spa_levmarq()
+	const Array_O err = gst::SE_TYPE::log((P2 - P1) - EDGE_POSE);
+	matrix_TxT J1, J2;
+	gst::SE_TYPE::jacob_dDinvP1invP2_de1e2(-EDGE_POSE, P1, P2, J1, J2);
+
+	const auto* edge = &f.edge;
+	aux_t::multiplyJtLambdaJ(J1, f.H11, edge);
+	aux_t::multiplyJtLambdaJ(J2, f.H22, edge);
+	aux_t::multiplyJ1tLambdaJ2(J1, J2, f.H12, edge);
+	f.g1.setZero();
+	f.g2.setZero();
+	aux_t::multiply_Jt_W_err(J1, edge, err, f.g1);
+	aux_t::multiply_Jt_W_err(J2, edge, err, f.g2);
+}
+
+template <class GRAPH_T>
+void CIncrementalSmoother<GRAPH_T>::addToSystem(const TFactor& f, double sign)
+{
+	if (f.v1 != INVALID_IDX)
+	{
+		TVariable& v = m_vars[f.v1];
+		v.H[f.v1].asEigen() += sign * f.H11.asEigen();
+		v.g.asEigen() += sign * f.g1.asEigen();
+	}
+	if (f.v2 != INVALID_IDX)
+	{
+		TVariable& v = m_vars[f.v2];
+		v.H[f.v2].asEigen() += sign * f.H22.asEigen();
+		v.g.asEigen() += sign * f.g2.asEigen();
+	}
+	if (f.v1 == INVALID_IDX || f.v2 == INVALID_IDX) return;
+	// Only the lower triangular part: H12 is the block (v1,v2)
+	if (f.v1 < f.v2)
+		m_vars[f.v1].H[f.v2].asEigen() += sign * f.H12.asEigen().transpose();
+	else
+		m_vars[f.v2].H[f.v1].asEigen() += sign * f.H12.asEigen();
+}
+
+template <class GRAPH_T>
+void CIncrementalSmoother<GRAPH_T>::eliminateFrom(size_t k)
+{
+	const size_t n = m_vars.size();
+	for (size_t c = k; c < n; c++)
+	{
+		for (const auto& rL : m_vars[c].L)
+			if (rL.first != c) m_vars[rL.first].Lrow.erase(c);
+		m_vars[c].L.clear();
+	}
+
+	// Left-looking block Cholesky: columns before k do not depend on the
+	// changed blocks, since all of them are in rows and columns >= k.
+	using block_t = Eigen::Matrix<double, DIMS_POSE, DIMS_POSE>;
+	for (size_t c = k; c < n; c++)
+	{
+		TVariable& vc = m_vars[c];
+		std::map<size_t, block_t> A;
+		for (const auto& rH : vc.H)
+			A[rH.first] = rH.second.asEigen();
+		Eigen::Matrix<double, DIMS_POSE, 1> rhs = -vc.g.asEigen();
+
+		for (const size_t j : vc.Lrow)
+		{
+			const TVariable& vj = m_vars[j];
+			auto it = vj.L.find(c);
+			const block_t Lcj = it->second.asEigen();
+			for (; it != vj.L.end(); ++it)
+			{
+				auto itA = A.try_emplace(it->first, block_t::Zero()).first;
+				itA->second.noalias() -= it->second.asEigen() * Lcj.transpose();
+			}
+			rhs.noalias() -= Lcj * vj.y.asEigen();
+		}
+
+		Eigen::LLT<block_t> llt(A[c]);
+		if (llt.info() != Eigen::Success)
+		{
+			// Not constrained wrt the root (e.g. a disconnected subgraph):
+			// regularize the diagonal block to keep going.
+			const double eps = 1e-9 * std::max(1.0, A[c].trace());
+			llt.compute(A[c] + eps * block_t::Identity());
+			ASSERTMSG_(
+				llt.info() == Eigen::Success,
+				mrpt::format(
+					"Non definite positive information matrix at node %u",
+					unsigned(vc.id)));
+		}
+		const block_t Lcc = llt.matrixL();
+		vc.L[c] = Lcc;
+		vc.y.asEigen() = Lcc.template triangularView<Eigen::Lower>().solve(rhs);
+		for (auto it = A.upper_bound(c); it != A.end(); ++it)
+		{
+			// L(r,c) = A(r,c) * Lcc^-t
+			vc.L[it->first] = Lcc.template triangularView<Eigen::Lower>()
+								  .solve(it->second.transpose())
+								  .transpose();
+			m_vars[it->first].Lrow.insert(c);
+		}
+	}
+}
+
+template <class GRAPH_T>
+void CIncrementalSmoother<GRAPH_T>::backSubstitute(
+	size_t k, GRAPH_T& graph, TUpdateInfo& ui)
+{
+	// Newest nodes first, so all L(r,c) for r>c are solved when c is:
+	std::set<size_t, std::greater<size_t>> pending;
+	for (size_t c = k; c < m_vars.size(); c++)
+		pending.insert(c);
+
+	while (!pending.empty())
+	{
+		const size_t c = *pending.begin();
+		pending.erase(pending.begin());
+
+		TVariable& vc = m_vars[c];
+		Eigen::Matrix<double, DIMS_POSE, 1> rhs = vc.y.asEigen();
+		auto it = vc.L.begin();
+		const auto& Lcc = it->second.asEigen();
+		for (++it; it != vc.L.end(); ++it)
+			rhs.noalias() -= it->second.asEigen().transpose() *
+				m_vars[it->first].delta.asEigen();
+		const Eigen::Matrix<double, DIMS_POSE, 1> new_delta =
+			Lcc.transpose().template triangularView<Eigen::Upper>().solve(rhs);
+
+		const double change =
+			(new_delta - vc.delta.asEigen()).template lpNorm<Eigen::Infinity>();
+		vc.delta.asEigen() = new_delta;
+		ui.updated_nodes++;
+
+		static_cast<pose_t&>(graph.nodes[vc.id]) =
+			vc.x0 + gst::SE_TYPE::exp(vc.delta);
+
+		if (change > options.wildfire_threshold)
+			pending.insert(vc.Lrow.begin(), vc.Lrow.end());
+	}
+}
+
+}  // namespace mrpt::graphslam
@@ -0,0 +1,186 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#pragma once
+
+#include <mrpt/config/CLoadableOptions.h>
+#include <mrpt/graphs/CNetworkOfPoses.h>
+#include <mrpt/graphslam/types.h>
+#include <mrpt/maps/CSimpleMap.h>
+#include <mrpt/slam/CGridMapAligner.h>
+#include <mrpt/system/COutputLogger.h>
+
+#include <string>
+#include <vector>
+
+namespace mrpt::graphslam
+{
+/**\brief Merges the maps of several mapping sessions of the same
+ * environment into one single graph of poses, without processing their
+ * rawlogs again.
+ *
+ * ## Description
+ *
+ * Each session is given as a mrpt::maps::CSimpleMap (keyframe poses and
+ * observations, e.g. the output of icp-slam) and, optionally, the already
+ * optimized graph of that session (e.g. from graphslam-engine), whose node
+ * IDs must be the keyframe indices. Its edges are kept as priors of the
+ * intra-session geometry; without a graph, consecutive keyframes are joined
+ * by edges with the uncertainty given in TOptions.
+ *
+ * merge() does the following:
+ *  - The keyframes of each session are grouped into submaps of
+ *    TOptions::submap_num_keyframes consecutive keyframes, each rendered
+ *    into an occupancy grid and a point cloud, in the frame of its central
+ *    keyframe (the submap "anchor").
+ *  - Each submap is globally aligned (no initial guess is needed) against
+ *    all the submaps of the other sessions with
+ *    mrpt::slam::CGridMapAligner::AlignPDFBatch(), in parallel, and the best
+ *    hypotheses are refined and verified with ICP over the point clouds.
+ *    Accepted alignments become inter-session edges between anchors.
+ *  - Sessions connected to the first one through those edges are expressed
+ *    in its frame, and all of them are jointly optimized with
+ *    mrpt::graphslam::optimize_graph_spa_levmarq().
+ *
+ * Sessions that could not be connected to the first one are not included
+ * in the merged graph (see isSessionMerged()).
+ *
+ * \note (New in MRPT 2.4.9)
+ * \ingroup mrpt_graphslam_grp
+ */
+class CMultiSessionMapMerger : public mrpt::system::COutputLogger
+{
+   public:
+	using graph_t = mrpt::graphs::CNetworkOfPoses2DInf;
+
+	CMultiSessionMapMerger();
+
+	struct TOptions : public mrpt::config::CLoadableOptions
+	{
+		TOptions();
+
+		void loadFromConfigFile(
+			const mrpt::config::CConfigFileBase& source,
+			const std::string& section) override;
+		void dumpToTextStream(std::ostream& out) const override;
+
+		/** Number of consecutive keyframes in each submap */
+		unsigned int submap_num_keyframes{10};
+		/** Resolution of the submap occupancy grids [m] */
+		float grid_resolution{0.05f};
+
+		/** Options of the global alignment of submaps. Its
+		 * `batch_num_threads` is overridden by #num_threads. */
+		mrpt::slam::CGridMapAligner::TConfigParams aligner_options;
+
+		/** How many of the most likely alignment hypotheses of each pair of
+		 * submaps are refined with ICP */
+		unsigned int max_hypotheses{3};
+		/** Minimum ICP goodness [0,1] to accept an alignment */
+		double min_icp_goodness{0.60};
+
+		/** Uncertainty of the inter-session edges */
+		double inter_session_std_xy{0.05};
+		double inter_session_std_phi{mrpt::DEG2RAD(1.0)};
+		/** Uncertainty of the edges between consecutive keyframes of the
+		 * sessions given without a graph (used by addSession()) */
+		double odometry_std_xy{0.10};
+		double odometry_std_phi{mrpt::DEG2RAD(2.0)};
+
+		/** Threads for building, aligning and verifying submaps, and
+		 * for the graph optimization (0=as many as CPU cores) */
+		unsigned int num_threads{0};
+		/** Maximum iterations of the joint graph optimization */
+		unsigned int max_iterations{100};
+	};
+
+	TOptions options;
+
+	/** An accepted alignment between submaps of two sessions: the pose of
+	 * the merged graph node `node2` relative to `node1`. */
+	struct TInterSessionConstraint
+	{
+		size_t session1 = 0, session2 = 0;
+		mrpt::graphs::TNodeID node1 = 0, node2 = 0;
+		mrpt::poses::CPose2D pose;
+		/** ICP goodness of the alignment */
+		double goodness = 0;
+	};
+
+	/** Adds a session to be merged.
+	 * \param graph The optimized graph of the session, with one node per
+	 * keyframe of `sm` (node IDs = keyframe indices), or nullptr.
+	 * \return The index of the new session.
+	 * \exception std::exception If the graph nodes do not match the
+	 * keyframes. */
+	size_t addSession(
+		const mrpt::maps::CSimpleMap& sm, const graph_t* graph = nullptr);
+
+	/** Loads a session from a `.simplemap` file and, optionally, a graph
+	 * file in text format (see
+	 * mrpt::graphs::CNetworkOfPoses::loadFromTextFile()).
+	 * \exception std::exception On any error loading the files. */
+	size_t addSessionFromFiles(
+		const std::string& simplemapFile,
+		const std::string& graphFile = std::string());
+
+	size_t getSessionCount() const { return m_sessions.size(); }
+
+	/** Removes all the sessions and results */
+	void clear();
+
+	/** Finds the inter-session constraints and jointly optimizes all the
+	 * sessions connected to the first one. */
+	void merge();
+
+	/** The merged graph. Its root is the first keyframe of the first
+	 * session. */
+	const graph_t& getMergedGraph() const { return m_graph; }
+
+	/** All the accepted inter-session constraints of the last merge() */
+	const std::vector<TInterSessionConstraint>& getInterSessionConstraints()
+		const
+	{
+		return m_constraints;
+	}
+
+	/** Whether a session is included in the merged graph */
+	bool isSessionMerged(size_t session) const;
+
+	/** The ID in the merged graph of a keyframe of a session */
+	mrpt::graphs::TNodeID getGlobalNodeID(
+		size_t session, size_t keyframe) const;
+
+	/** A simple map with all the keyframes of the merged sessions at their
+	 * optimized poses (in the merged graph node ID order). */
+	void getMergedSimpleMap(mrpt::maps::CSimpleMap& out) const;
+
+	/** Results of the joint optimization in the last merge() */
+	const TResultInfoSpaLevMarq& getOptimizationInfo() const
+	{
+		return m_optInfo;
+	}
+
+   private:
+	struct TSession
+	{
+		mrpt::maps::CSimpleMap sm;
+		/** Intra-session graph, with the keyframe indices as node IDs */
+		graph_t graph;
+		/** ID of the first keyframe in the merged graph */
+		mrpt::graphs::TNodeID firstNodeID = 0;
+		bool merged = false;
+	};
+	std::vector<TSession> m_sessions;
+
+	graph_t m_graph;
+	std::vector<TInterSessionConstraint> m_constraints;
+	TResultInfoSpaLevMarq m_optInfo{};
+};
+}  // namespace mrpt::graphslam
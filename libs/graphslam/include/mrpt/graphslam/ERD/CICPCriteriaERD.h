@@ -12,13 +12,16 @@
 #include <mrpt/config/CConfigFileBase.h>
 #include <mrpt/config/CLoadableOptions.h>
 #include <mrpt/graphslam/interfaces/CRangeScanEdgeRegistrationDecider.h>
+#include <mrpt/graphslam/misc/CScanDescriptorIndex.h>
 #include <mrpt/img/TColor.h>
+#include <mrpt/maps/CSimplePointsMap.h>
 #include <mrpt/obs/CActionCollection.h>
 #include <mrpt/obs/CObservation2DRangeScan.h>
 #include <mrpt/obs/CObservation3DRangeScan.h>
 #include <mrpt/obs/CSensoryFrame.h>
 #include <mrpt/slam/CICP.h>
 
+#include <deque>
 #include <map>
 #include <set>
 #include <string>
@@ -74,6 +77,39 @@ namespace mrpt::graphslam::deciders
  *   + \a Description   : Threshold for accepting a scan-matching edge between
  *   the current and previous nodes
  *
+ * - \b ICP_num_threads
+ *   + \a Section       : EdgeRegistrationDeciderParameters
+ *   + \a Default value : 0
+ *   + \a Required      : FALSE
+ *   + \a Description   : Threads running the ICP alignments of the current
+ *   node with the candidate nodes (0: as many as CPU cores). The points
+ *   maps of the node scans are cached, so each scan is only converted once.
+ *
+ * - \b LC_use_scan_descriptors
+ *   + \a Section       : EdgeRegistrationDeciderParameters
+ *   + \a Default value : FALSE
+ *   + \a Required      : FALSE
+ *   + \a Description   : If true, only the nodes registered less than
+ *   LC_min_nodeid_diff nodes ago are searched within ICP_max_distance. Loop
+ *   closure candidates are instead the LC_descriptor_candidates older nodes
+ *   with the most similar scans, retrieved from a
+ *   mrpt::graphslam::CScanDescriptorIndex, regardless of their distance to
+ *   the current node. The number of ICP alignments per node is then bounded,
+ *   even with large pose uncertainties.
+ *
+ * - \b LC_descriptor_candidates
+ *   + \a Section       : EdgeRegistrationDeciderParameters
+ *   + \a Default value : 5
+ *   + \a Required      : FALSE
+ *   + \a Description   : Number of loop closure candidates retrieved by scan
+ *   descriptor, if LC_use_scan_descriptors is true.
+ *
+ * - \b LC_descriptor_num_rings
+ *   + \a Section       : EdgeRegistrationDeciderParameters
+ *   + \a Default value : 20
+ *   + \a Required      : FALSE
+ *   + \a Description   : Length of the scan descriptors.
+ *
  * - \b visualize_laser_scans
  *   + \a Section       : VisualizationParameters
  *   + \a Default value : TRUE
@@ -143,7 +179,16 @@ class CICPCriteriaERD
 		double ICP_max_distance;
 		// threshold for accepting an ICP constraint in the graph
 		double ICP_goodness_thresh;
+		/** Threads for the ICP alignments of each new node (0: as many as
+		 * CPU cores) */
+		unsigned int ICP_num_threads = 0;
 		size_t LC_min_nodeid_diff;
+		/** Retrieve loop closure candidates by scan descriptor, instead of
+		 * by distance (see the .ini parameters above) */
+		bool LC_use_scan_descriptors{false};
+		size_t LC_descriptor_candidates{5};
+		unsigned int LC_descriptor_num_rings{
+			CScanDescriptorIndex::DEFAULT_NUM_RINGS};
 		bool visualize_laser_scans;
 		// keystroke to be used for the user to toggle the LaserScans from
 		// the CDisplayWindow
@@ -174,16 +219,33 @@ class CICPCriteriaERD
 		mrpt::obs::CSensoryFrame::Ptr observations,
 		mrpt::obs::CObservation::Ptr observation);
 	/**\brief Get a list of the nodeIDs whose position is within a certain
-	 * distance to the specified nodeID
+	 * distance to the specified nodeID. Only nodes with ID >= first_nodeID
+	 * are checked.
 	 */
 	void getNearbyNodesOf(
 		std::set<mrpt::graphs::TNodeID>* nodes_set,
-		const mrpt::graphs::TNodeID& cur_nodeID, double distance);
+		const mrpt::graphs::TNodeID& cur_nodeID, double distance,
+		const mrpt::graphs::TNodeID first_nodeID = 0);
+	/**\brief Adds the descriptor of the given node scan to the index, and
+	 * the nodes with the most similar scans to the set of ICP candidates
+	 */
+	void addDescriptorCandidatesOf(
+		std::set<mrpt::graphs::TNodeID>* nodes_set,
+		const mrpt::graphs::TNodeID& cur_nodeID,
+		const mrpt::obs::CObservation2DRangeScan& scan);
 	/**\brief togle the LaserScans visualization on and off
 	 */
 	void toggleLaserScansVisualization();
 	void dumpVisibilityErrorMsg(
 		std::string viz_flag, int sleep_time = 500 /* ms */);
+	/**\brief Number of threads to run nTasks ICP alignments, from
+	 * TParams::ICP_num_threads */
+	unsigned int numICPThreads(size_t nTasks) const;
+	/**\brief Points map of the 3D scan of the given node, built upon the
+	 * first call and cached in m_nodes_to_points_maps3D */
+	const mrpt::maps::CSimplePointsMap& getPointsMap3D(
+		const mrpt::graphs::TNodeID nodeID,
+		const mrpt::obs::CObservation3DRangeScan& scan);
 
 	// protected variables
 	//////////////////////////////////////////////////////////////
@@ -199,6 +261,10 @@ class CICPCriteriaERD
 		m_nodes_to_laser_scans2D;
 	std::map<mrpt::graphs::TNodeID, mrpt::obs::CObservation3DRangeScan::Ptr>
 		m_nodes_to_laser_scans3D;
+	/** Points maps of the 3D scans, reused in all their ICP alignments (2D
+	 * scans cache their own, see CRangeScanOps::getICPEdge()) */
+	std::map<mrpt::graphs::TNodeID, mrpt::maps::CSimplePointsMap::Ptr>
+		m_nodes_to_points_maps3D;
 	std::map<std::string, int> m_edge_types_to_nums;
 	bool m_is_using_3DScan{false};
 
@@ -207,6 +273,15 @@ class CICPCriteriaERD
 	// fake 2D laser scan generated from corresponding 3DRangeScan for
 	// visualization reasons
 	mrpt::obs::CObservation2DRangeScan::Ptr m_fake_laser_scan2D;
+
+	/** Scan descriptors of the nodes older than LC_min_nodeid_diff */
+	std::unique_ptr<mrpt::graphslam::CScanDescriptorIndex>
+		m_descriptor_index;
+	/** Scan descriptors of the latest nodes, not yet eligible for loop
+	 * closures */
+	std::deque<std::pair<
+		mrpt::graphs::TNodeID, CScanDescriptorIndex::descriptor_t>>
+		m_pending_descriptors;
 };
 }  // namespace mrpt::graphslam::deciders
 #include "CICPCriteriaERD_impl.h"
@@ -8,9 +8,12 @@
    +------------------------------------------------------------------------+ */
 
 #pragma once
+#include <mrpt/core/WorkerThreadsPool.h>
 #include <mrpt/opengl/CDisk.h>
 #include <mrpt/opengl/CPlanarLaserScan.h>
 
+#include <thread>
+
 namespace mrpt::graphslam::deciders
 {
 // Ctors, Dtors
@@ -125,11 +128,36 @@ bool CICPCriteriaERD<GRAPH_T>::updateState(
 	// edge registration procedure - same for both rawlog formats
 	if (registered_new_node)
 	{
+		const mrpt::graphs::TNodeID curr_nodeID =
+			this->m_graph->nodeCount() - 1;
+
 		// get set of nodes within predefined distance for ICP
 		std::set<mrpt::graphs::TNodeID> nodes_to_check_ICP;
-		this->getNearbyNodesOf(
-			&nodes_to_check_ICP, this->m_graph->nodeCount() - 1,
-			params.ICP_max_distance);
+		if (params.LC_use_scan_descriptors)
+		{
+			// Search by distance among the latest nodes only, and by scan
+			// descriptor for loop closures:
+			const mrpt::graphs::TNodeID first_nodeID =
+				curr_nodeID > params.LC_min_nodeid_diff
+				? curr_nodeID - params.LC_min_nodeid_diff
+				: 0;
+			this->getNearbyNodesOf(
+				&nodes_to_check_ICP, curr_nodeID, params.ICP_max_distance,
+				first_nodeID);
+
+			const auto& scan =
+				m_is_using_3DScan ? m_fake_laser_scan2D : m_last_laser_scan2D;
+			if (scan)
+			{
+				this->addDescriptorCandidatesOf(
+					&nodes_to_check_ICP, curr_nodeID, *scan);
+			}
+		}
+		else
+		{
+			this->getNearbyNodesOf(
+				&nodes_to_check_ICP, curr_nodeID, params.ICP_max_distance);
+		}
 		MRPT_LOG_DEBUG_FMT(
 			"Found * %lu * nodes close to nodeID %lu",
 			nodes_to_check_ICP.size(), this->m_graph->nodeCount() - 1);
@@ -169,60 +197,89 @@ void CICPCriteriaERD<GRAPH_T>::checkRegistrationCondition2D(
 	{ curr_laser_scan = search->second; }
 
 	// commence only if I have the current laser scan
-	if (curr_laser_scan)
+	if (!curr_laser_scan) return;
+
+	// previous nodes with laser scans, and the initial node position
+	// difference for their ICP edges
+	std::vector<mrpt::graphs::TNodeID> nodes;
+	std::vector<CObservation2DRangeScan::Ptr> prev_laser_scans;
+	std::vector<pose_t> initial_poses;
+	for (mrpt::graphs::TNodeID node_it : nodes_set)
 	{
-		// try adding ICP constraints with each node in the previous set
-		for (mrpt::graphs::TNodeID node_it : nodes_set)
+		search = this->m_nodes_to_laser_scans2D.find(node_it);
+		if (search == this->m_nodes_to_laser_scans2D.end()) continue;
+		nodes.push_back(node_it);
+		prev_laser_scans.push_back(search->second);
+		initial_poses.push_back(
+			this->m_graph->nodes[curr_nodeID] - this->m_graph->nodes[node_it]);
+	}
+
+	// The alignments are independent, so they run in parallel, each one with
+	// its own copy of the ICP object. Scans cache their points maps, so each
+	// one is only converted once.
+	const size_t nNodes = nodes.size();
+	std::vector<constraint_t> rel_edges(nNodes);
+	std::vector<mrpt::slam::CICP::TReturnInfo> icp_infos(nNodes);
+
+	this->m_time_logger.enter("CICPCriteriaERD::getICPEdge");
+	const unsigned int nThreads = numICPThreads(nNodes);
+	if (nThreads > 1)
+	{
+		// Built before, since the threads would build it concurrently:
+		curr_laser_scan->buildAuxPointsMap<mrpt::maps::CSimplePointsMap>();
+
+		mrpt::WorkerThreadsPool pool(
+			nThreads - 1, mrpt::WorkerThreadsPool::POLICY_FIFO, "ICP_ERD");
+		pool.parallel_for(0, nNodes, 1, [&](size_t i) {
+			mrpt::slam::CICP icp = range_ops_t::params.icp;
+			icp.options.numThreads = 1;
+			this->getICPEdge(
+				*prev_laser_scans[i], *curr_laser_scan, &rel_edges[i],
+				&initial_poses[i], &icp_infos[i], &icp);
+		});
+	}
+	else
+	{
+		for (size_t i = 0; i < nNodes; i++)
 		{
-			// get the ICP edge between current and last node
-			constraint_t rel_edge;
-			mrpt::slam::CICP::TReturnInfo icp_info;
-			CObservation2DRangeScan::Ptr prev_laser_scan;
-
-			// search for prev_laser_scan
-			search = this->m_nodes_to_laser_scans2D.find(node_it);
-			if (search != this->m_nodes_to_laser_scans2D.end())
+			this->getICPEdge(
+				*prev_laser_scans[i], *curr_laser_scan, &rel_edges[i],
+				&initial_poses[i], &icp_infos[i]);
+		}
+	}
+	this->m_time_logger.leave("CICPCriteriaERD::getICPEdge");
+
+	// register the edges in the order of the nodes
+	for (size_t i = 0; i < nNodes; i++)
+	{
+		const mrpt::graphs::TNodeID node_it = nodes[i];
+		const auto& icp_info = icp_infos[i];
+
+		// Debugging statements
+		MRPT_LOG_DEBUG_STREAM(
+			">>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>"
+			">>>>>>>>>");
+		MRPT_LOG_DEBUG_STREAM(
+			"ICP constraint between NON-successive nodes: "
+			<< node_it << " => " << curr_nodeID << std::endl
+			<< "\tnIterations = " << icp_info.nIterations
+			<< "\tgoodness = " << icp_info.goodness);
+		MRPT_LOG_DEBUG_STREAM(
+			"ICP_goodness_thresh: " << params.ICP_goodness_thresh);
+		MRPT_LOG_DEBUG_STREAM(
+			"<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<"
+			"<<<<<<<<<");
+
+		// criterion for registering a new node
+		if (icp_info.goodness > params.ICP_goodness_thresh)
+		{
+			this->registerNewEdge(node_it, curr_nodeID, rel_edges[i]);
+			m_edge_types_to_nums["ICP2D"]++;
+			// in case of loop closure
+			if (absDiff(curr_nodeID, node_it) > params.LC_min_nodeid_diff)
 			{
-				prev_laser_scan = search->second;
-
-				// make use of initial node position difference for the ICP edge
-				pose_t initial_pose = this->m_graph->nodes[curr_nodeID] -
-					this->m_graph->nodes[node_it];
-
-				this->m_time_logger.enter("CICPCriteriaERD::getICPEdge");
-				this->getICPEdge(
-					*prev_laser_scan, *curr_laser_scan, &rel_edge,
-					&initial_pose, &icp_info);
-				this->m_time_logger.leave("CICPCriteriaERD::getICPEdge");
-
-				// Debugging statements
-				MRPT_LOG_DEBUG_STREAM(
-					">>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>"
-					">>>>>>>>>");
-				MRPT_LOG_DEBUG_STREAM(
-					"ICP constraint between NON-successive nodes: "
-					<< node_it << " => " << curr_nodeID << std::endl
-					<< "\tnIterations = " << icp_info.nIterations
-					<< "\tgoodness = " << icp_info.goodness);
-				MRPT_LOG_DEBUG_STREAM(
-					"ICP_goodness_thresh: " << params.ICP_goodness_thresh);
-				MRPT_LOG_DEBUG_STREAM(
-					"<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<"
-					"<<<<<<<<<");
-
-				// criterion for registering a new node
-				if (icp_info.goodness > params.ICP_goodness_thresh)
-				{
-					this->registerNewEdge(node_it, curr_nodeID, rel_edge);
-					m_edge_types_to_nums["ICP2D"]++;
-					// in case of loop closure
-					if (absDiff(curr_nodeID, node_it) >
-						params.LC_min_nodeid_diff)
-					{
-						m_edge_types_to_nums["LC"]++;
-						this->m_just_inserted_lc = true;
-					}
-				}
+				m_edge_types_to_nums["LC"]++;
+				this->m_just_inserted_lc = true;
 			}
 		}
 	}
@@ -248,42 +305,66 @@ void CICPCriteriaERD<GRAPH_T>::checkRegistrationCondition3D(
 	{ curr_laser_scan = search->second; }
 
 	// commence only if I have the current laser scan
-	if (curr_laser_scan)
+	if (!curr_laser_scan) return;
+
+	// points maps of the previous nodes with laser scans, built (or reused)
+	// before running the alignments in parallel
+	const mrpt::maps::CSimplePointsMap& curr_points =
+		getPointsMap3D(curr_nodeID, *curr_laser_scan);
+	std::vector<mrpt::graphs::TNodeID> nodes;
+	std::vector<const mrpt::maps::CSimplePointsMap*> prev_points;
+	for (mrpt::graphs::TNodeID node_it : nodes_set)
 	{
-		// try adding ICP constraints with each node in the previous set
-		for (mrpt::graphs::TNodeID node_it : nodes_set)
+		search = m_nodes_to_laser_scans3D.find(node_it);
+		if (search == m_nodes_to_laser_scans3D.end()) continue;
+		nodes.push_back(node_it);
+		prev_points.push_back(&getPointsMap3D(node_it, *search->second));
+	}
+
+	const size_t nNodes = nodes.size();
+	std::vector<constraint_t> rel_edges(nNodes);
+	std::vector<mrpt::slam::CICP::TReturnInfo> icp_infos(nNodes);
+
+	// TODO - use initial edge estimation
+	this->m_time_logger.enter("CICPCriteriaERD::getICPEdge");
+	const unsigned int nThreads = numICPThreads(nNodes);
+	if (nThreads > 1)
+	{
+		mrpt::WorkerThreadsPool pool(
+			nThreads - 1, mrpt::WorkerThreadsPool::POLICY_FIFO, "ICP_ERD");
+		pool.parallel_for(0, nNodes, 1, [&](size_t i) {
+			mrpt::slam::CICP icp = range_ops_t::params.icp;
+			icp.options.numThreads = 1;
+			this->getICPEdge3D(
+				*prev_points[i], curr_points, &rel_edges[i], nullptr,
+				&icp_infos[i], &icp);
+		});
+	}
+	else
+	{
+		for (size_t i = 0; i < nNodes; i++)
+		{
+			this->getICPEdge3D(
+				*prev_points[i], curr_points, &rel_edges[i], nullptr,
+				&icp_infos[i]);
+		}
+	}
+	this->m_time_logger.leave("CICPCriteriaERD::getICPEdge");
+
+	for (size_t i = 0; i < nNodes; i++)
+	{
+		const mrpt::graphs::TNodeID node_it = nodes[i];
+
+		// criterion for registering a new node
+		if (icp_infos[i].goodness > params.ICP_goodness_thresh)
 		{
-			// get the ICP edge between current and last node
-			constraint_t rel_edge;
-			mrpt::slam::CICP::TReturnInfo icp_info;
-			CObservation3DRangeScan::Ptr prev_laser_scan;
-
-			// search for prev_laser_scan
-			search = m_nodes_to_laser_scans3D.find(node_it);
-			if (search != m_nodes_to_laser_scans3D.end())
+			this->registerNewEdge(node_it, curr_nodeID, rel_edges[i]);
+			m_edge_types_to_nums["ICP3D"]++;
+			// in case of loop closure
+			if (absDiff(curr_nodeID, node_it) > params.LC_min_nodeid_diff)
 			{
-				prev_laser_scan = search->second;
-
-				// TODO - use initial edge estimation
-				this->m_time_logger.enter("CICPCriteriaERD::getICPEdge");
-				this->getICPEdge(
-					*prev_laser_scan, *curr_laser_scan, &rel_edge, nullptr,
-					&icp_info);
-				this->m_time_logger.leave("CICPCriteriaERD::getICPEdge");
-
-				// criterion for registering a new node
-				if (icp_info.goodness > params.ICP_goodness_thresh)
-				{
-					this->registerNewEdge(node_it, curr_nodeID, rel_edge);
-					m_edge_types_to_nums["ICP3D"]++;
-					// in case of loop closure
-					if (absDiff(curr_nodeID, node_it) >
-						params.LC_min_nodeid_diff)
-					{
-						m_edge_types_to_nums["LC"]++;
-						this->m_just_inserted_lc = true;
-					}
-				}
+				m_edge_types_to_nums["LC"]++;
+				this->m_just_inserted_lc = true;
 			}
 		}
 	}
@@ -291,6 +372,33 @@ void CICPCriteriaERD<GRAPH_T>::checkRegistrationCondition3D(
 	MRPT_END
 }
 
+template <class GRAPH_T>
+unsigned int CICPCriteriaERD<GRAPH_T>::numICPThreads(size_t nTasks) const
+{
+	unsigned int n = params.ICP_num_threads;
+	if (n == 0) n = std::max(1U, std::thread::hardware_concurrency());
+	return static_cast<unsigned int>(
+		std::max<size_t>(1, std::min<size_t>(n, nTasks)));
+}
+
+template <class GRAPH_T>
+const mrpt::maps::CSimplePointsMap& CICPCriteriaERD<GRAPH_T>::getPointsMap3D(
+	const mrpt::graphs::TNodeID nodeID,
+	const mrpt::obs::CObservation3DRangeScan& scan)
+{
+	auto& m = m_nodes_to_points_maps3D[nodeID];
+	if (!m)
+	{
+		ASSERTDEBMSG_(
+			scan.hasRangeImage, "Laser scan doesn't contain valid range image");
+		m = mrpt::maps::CSimplePointsMap::Create();
+		m->insertObservation(scan);
+		// Build the KD-tree now, not concurrently in the alignments:
+		m->kdTreeEnsureIndexBuilt3D();
+	}
+	return *m;
+}
+
 template <class GRAPH_T>
 void CICPCriteriaERD<GRAPH_T>::registerNewEdge(
 	const mrpt::graphs::TNodeID& from, const mrpt::graphs::TNodeID& to,
@@ -304,14 +412,15 @@ void CICPCriteriaERD<GRAPH_T>::registerNewEdge(
 template <class GRAPH_T>
 void CICPCriteriaERD<GRAPH_T>::getNearbyNodesOf(
 	std::set<mrpt::graphs::TNodeID>* nodes_set,
-	const mrpt::graphs::TNodeID& cur_nodeID, double distance)
+	const mrpt::graphs::TNodeID& cur_nodeID, double distance,
+	const mrpt::graphs::TNodeID first_nodeID)
 {
 	MRPT_START
 
 	if (distance > 0)
 	{
 		// check all but the last node.
-		for (mrpt::graphs::TNodeID nodeID = 0;
+		for (mrpt::graphs::TNodeID nodeID = first_nodeID;
 			 nodeID < this->m_graph->nodeCount() - 1; ++nodeID)
 		{
 			double curr_distance = this->m_graph->nodes[nodeID].distanceTo(
@@ -319,11 +428,59 @@ void CICPCriteriaERD<GRAPH_T>::getNearbyNodesOf(
 			if (curr_distance <= distance) { nodes_set->insert(nodeID); }
 		}
 	}
-	else
+	else if (first_nodeID == 0)
 	{  // check against all nodes
 		this->m_graph->getAllNodes(*nodes_set);
 	}
+	else
+	{
+		for (mrpt::graphs::TNodeID nodeID = first_nodeID;
+			 nodeID < this->m_graph->nodeCount() - 1; ++nodeID)
+			nodes_set->insert(nodeID);
+	}
+
+	MRPT_END
+}
+
+template <class GRAPH_T>
+void CICPCriteriaERD<GRAPH_T>::addDescriptorCandidatesOf(
+	std::set<mrpt::graphs::TNodeID>* nodes_set,
+	const mrpt::graphs::TNodeID& cur_nodeID,
+	const mrpt::obs::CObservation2DRangeScan& scan)
+{
+	MRPT_START
+	mrpt::system::CTimeLoggerEntry tle(
+		this->m_time_logger, "CICPCriteriaERD::addDescriptorCandidatesOf");
+
+	if (!m_descriptor_index)
+	{
+		m_descriptor_index = std::make_unique<CScanDescriptorIndex>(
+			params.LC_descriptor_num_rings);
+	}
+	auto& index = *m_descriptor_index;
+
+	CScanDescriptorIndex::descriptor_t desc;
+	index.computeDescriptor(scan, desc);
 
+	// Nodes become loop closure candidates once they are old enough:
+	while (!m_pending_descriptors.empty() &&
+		   m_pending_descriptors.front().first + params.LC_min_nodeid_diff <
+			   cur_nodeID)
+	{
+		auto& p = m_pending_descriptors.front();
+		if (!index.contains(p.first)) index.insert(p.first, p.second);
+		m_pending_descriptors.pop_front();
+	}
+	m_pending_descriptors.emplace_back(cur_nodeID, desc);
+
+	const auto candidates = index.query(desc, params.LC_descriptor_candidates);
+	for (const auto& c : candidates)
+		nodes_set->insert(c.first);
+
+	MRPT_LOG_DEBUG_STREAM(
+		"Retrieved " << candidates.size()
+					 << " loop closure candidates by scan descriptor, out of "
+					 << index.size() << " indexed nodes");
 	MRPT_END
 }
 
@@ -622,8 +779,16 @@ void CICPCriteriaERD<GRAPH_T>::TParams::dumpToTextStream(
 		ICP_goodness_thresh * 100);
 	out << mrpt::format(
 		"ICP max radius for edge search = %.2f\n", ICP_max_distance);
+	out << mrpt::format(
+		"ICP threads (0: all cores)     = %u\n", ICP_num_threads);
 	out << mrpt::format(
 		"Min. node difference for LC    = %lu\n", LC_min_nodeid_diff);
+	out << mrpt::format(
+		"Use scan descriptors for LC    = %d\n", LC_use_scan_descriptors);
+	out << mrpt::format(
+		"Descriptor LC candidates       = %lu\n", LC_descriptor_candidates);
+	out << mrpt::format(
+		"Descriptor length (rings)      = %u\n", LC_descriptor_num_rings);
 	out << mrpt::format(
 		"Visualize laser scans          = %d\n", visualize_laser_scans);
 	out << mrpt::format(
@@ -644,6 +809,14 @@ void CICPCriteriaERD<GRAPH_T>::TParams::loadFromConfigFile(
 		source.read_double(section, "ICP_max_distance", 10, false);
 	ICP_goodness_thresh =
 		source.read_double(section, "ICP_goodness_thresh", 0.75, false);
+	ICP_num_threads = static_cast<unsigned int>(source.read_int(
+		section, "ICP_num_threads", ICP_num_threads, false));
+	LC_use_scan_descriptors = source.read_bool(
+		section, "LC_use_scan_descriptors", LC_use_scan_descriptors, false);
+	LC_descriptor_candidates = source.read_uint64_t(
+		section, "LC_descriptor_candidates", LC_descriptor_candidates, false);
+	LC_descriptor_num_rings = static_cast<unsigned int>(source.read_int(
+		section, "LC_descriptor_num_rings", LC_descriptor_num_rings, false));
 	visualize_laser_scans = source.read_bool(
 		"VisualizationParameters", "visualize_laser_scans", true, false);
 	scans_img_external_dir = source.read_string(
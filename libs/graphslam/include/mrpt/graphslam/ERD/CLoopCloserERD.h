@@ -14,6 +14,7 @@
 #include <mrpt/graphs/CHypothesisNotFoundException.h>
 #include <mrpt/graphs/THypothesis.h>
 #include <mrpt/graphslam/interfaces/CRangeScanEdgeRegistrationDecider.h>
+#include <mrpt/graphslam/misc/CScanDescriptorIndex.h>
 #include <mrpt/graphslam/misc/TNodeProps.h>
 #include <mrpt/graphslam/misc/TSlidingWindow.h>
 #include <mrpt/graphslam/misc/TUncertaintyPath.h>
@@ -194,6 +195,24 @@ exponential.
  *   + \a Description   : Boolean flag indicating whether to check for loop
  *   closures only in the current node's partition
  *
+ * - \b LC_num_threads
+ *   + \a Section       : EdgeRegistrationDeciderParameters
+ *   + \a Default value : 0
+ *   + \a Required      : FALSE
+ *   + \a Description   : Threads running the ICP alignments of the loop
+ *   closure hypotheses and the pair-wise consistency matrix (0: as many as
+ *   CPU cores)
+ *
+ * - \b LC_descriptor_candidates
+ *   + \a Section       : EdgeRegistrationDeciderParameters
+ *   + \a Default value : 0
+ *   + \a Required      : FALSE
+ *   + \a Description   : If >0, each node of a partition is only aligned
+ *   with the nodes of the other group whose scans are the most similar,
+ *   by the mrpt::graphslam::CScanDescriptorIndex descriptor, up to this
+ *   number. The rest of the hypotheses are discarded without running ICP.
+ *   0 evaluates all the pairs of nodes.
+ *
  * - \b visualize_map_partitions
  *   + \a Section       : VisualizationParameters
  *   + \a Default value : TRUE
@@ -489,6 +508,14 @@ class CLoopCloserERD : public virtual mrpt::graphslam::deciders::
 		 * registered
 		 */
 		int full_partition_per_nodes;
+		/**\brief Threads for generateHypotsPool() and
+		 * generatePWConsistenciesMatrix() (0: as many as CPU cores)
+		 */
+		unsigned int LC_num_threads = 0;
+		/**\brief Hypotheses per node aligned with ICP, picked by scan
+		 * descriptor similarity (0: all the pairs of nodes)
+		 */
+		size_t LC_descriptor_candidates = 0;
 		bool visualize_map_partitions;
 		std::string keystroke_map_partitions;
 
@@ -601,9 +628,27 @@ class CLoopCloserERD : public virtual mrpt::graphslam::deciders::
 	 */
 	void evaluatePartitionsForLC(const partitions_t& partitions);
 
+	/**\brief Compute the dominant eigenvector of the (symmetric) consistency
+	 * matrix, and check the ratio of its two largest eigenvalues.
+	 *
+	 * If use_power_method is true, the two largest eigenvalues are found by
+	 * subspace (block power) iteration, instead of a full dense
+	 * eigen-decomposition.
+	 *
+	 * \return True if the eigenvalues ratio surpasses
+	 * TLoopClosureParams::LC_eigenvalues_ratio_thresh
+	 */
 	bool computeDominantEigenVector(
 		const mrpt::math::CMatrixDouble& consist_matrix,
 		mrpt::math::CVectorDouble* eigvec, bool use_power_method = false);
+	/**\brief Pair-wise consistency of two hypotheses, given the optimal paths
+	 * a1=>a2 and b1=>b2. Thread-safe.
+	 *
+	 * \sa generatePWConsistencyElement
+	 */
+	static double computePWConsistency(
+		const path_t& path_a1_a2, const hypot_t& hypot_b1_a2,
+		const path_t& path_b1_b2, const hypot_t& hypot_b2_a1);
 	/**\brief Return the pair-wise consistency between the observations of the
 	 * given nodes.
 	 *
@@ -705,6 +750,26 @@ class CLoopCloserERD : public virtual mrpt::graphslam::deciders::
 		constraint_t* rel_edge,
 		mrpt::slam::CICP::TReturnInfo* icp_info = nullptr,
 		const TGetICPEdgeAdParams* ad_params = nullptr);
+	/**\brief Like getICPEdge(), aligning the scans with the given ICP
+	 * instance, so it can be called from several threads, each one with its
+	 * own instance.
+	 */
+	bool getICPEdgeWith(
+		mrpt::slam::CICP& icp, const mrpt::graphs::TNodeID& from,
+		const mrpt::graphs::TNodeID& to, constraint_t* rel_edge,
+		mrpt::slam::CICP::TReturnInfo* icp_info,
+		const TGetICPEdgeAdParams* ad_params);
+	/**\brief Number of threads for a loop closure stage of `nTasks`
+	 * independent tasks */
+	unsigned int numLCThreads(size_t nTasks) const;
+	/**\brief For each node of groupB, flags whether the hypotheses with each
+	 * node of groupA (in the generateHypotsPool() order) are among the
+	 * LC_descriptor_candidates with the most similar scans.
+	 */
+	std::vector<uint8_t> selectHypotsByScanDescriptor(
+		const std::vector<uint32_t>& groupA,
+		const std::vector<uint32_t>& groupB,
+		const TGenerateHypotsPoolAdParams* ad_params);
 	/**\brief compute the minimum uncertainty of each node position with
 	 * regards to the graph root.
 	 *
@@ -9,12 +9,19 @@
 
 #pragma once
 #include <mrpt/containers/stl_containers_utils.h>
+#include <mrpt/core/WorkerThreadsPool.h>
 #include <mrpt/math/data_utils.h>
 #include <mrpt/math/ops_matrices.h>
 #include <mrpt/math/utils.h>
 #include <mrpt/obs/obs_utils.h>
 #include <mrpt/opengl/CEllipsoid3D.h>
 #include <mrpt/opengl/CSphere.h>
+#include <mrpt/system/CTimeLogger.h>
+
+#include <Eigen/Dense>
+#include <algorithm>
+#include <memory>
+#include <thread>
 
 namespace mrpt::graphslam::deciders
 {
@@ -225,10 +232,21 @@ bool CLoopCloserERD<GRAPH_T>::getICPEdge(
 	const mrpt::graphs::TNodeID& from, const mrpt::graphs::TNodeID& to,
 	constraint_t* rel_edge, mrpt::slam::CICP::TReturnInfo* icp_info,
 	const TGetICPEdgeAdParams* ad_params)
+{
+	return getICPEdgeWith(
+		range_ops_t::params.icp, from, to, rel_edge, icp_info, ad_params);
+}
+
+template <class GRAPH_T>
+bool CLoopCloserERD<GRAPH_T>::getICPEdgeWith(
+	mrpt::slam::CICP& icp, const mrpt::graphs::TNodeID& from,
+	const mrpt::graphs::TNodeID& to, constraint_t* rel_edge,
+	mrpt::slam::CICP::TReturnInfo* icp_info,
+	const TGetICPEdgeAdParams* ad_params)
 {
 	MRPT_START
 	ASSERTDEB_(rel_edge);
-	this->m_time_logger.enter("getICPEdge");
+	mrpt::system::CTimeLoggerEntry tle(this->m_time_logger, "getICPEdge");
 
 	using namespace mrpt::obs;
 	using namespace std;
@@ -281,10 +299,9 @@ bool CLoopCloserERD<GRAPH_T>::getICPEdge(
 					  << "| init_estim: " << initial_estim);
 
 	range_ops_t::getICPEdge(
-		*from_scan, *to_scan, rel_edge, &initial_estim, icp_info);
+		*from_scan, *to_scan, rel_edge, &initial_estim, icp_info, &icp);
 	MRPT_LOG_DEBUG_STREAM("*************");
 
-	this->m_time_logger.leave("getICPEdge");
 	return true;
 	MRPT_END
 }  // end of getICPEdge
@@ -572,7 +589,7 @@ void CLoopCloserERD<GRAPH_T>::evalPWConsistenciesMatrix(
 	// compute dominant eigenvector
 	CVectorDouble u;
 	bool valid_lambda_ratio =
-		this->computeDominantEigenVector(consist_matrix, &u, false);
+		this->computeDominantEigenVector(consist_matrix, &u, true);
 	if (!valid_lambda_ratio) return;
 
 	// cout << "Dominant eigenvector: " << u.transpose() << endl;
@@ -745,91 +762,109 @@ void CLoopCloserERD<GRAPH_T>::generateHypotsPool(
 	int hypot_counter = 0;
 	int invalid_hypots = 0;	 // just for keeping track of them.
 	{
-		// iterate over all the nodes in both groups
+		// iterate over all the nodes in both groups.
+		// By default hypotheses will direct bi => ai; If the hypothesis is
+		// traversed the opposite way, take the opposite of the constraint
+		std::vector<std::unique_ptr<TGetICPEdgeAdParams>> icp_ad_params;
 		for (unsigned int b_it : groupB)
 		{
 			for (unsigned int a_it : groupA)
 			{
-				// by default hypotheses will direct bi => ai; If the hypothesis
-				// is
-				// traversed the opposite way, take the opposite of the
-				// constraint
 				auto* hypot = new hypot_t;
 				hypot->from = b_it;
 				hypot->to = a_it;
 				hypot->id = hypot_counter++;
+				generated_hypots->push_back(hypot);
 
 				// [from] *b_it ====[edge]===> [to]  *a_it
 
 				// Fetch and set the pose and LaserScan of from, to nodeIDs
 				//
 				// even if icp_ad_params NULL, it will be handled appropriately
-				// by the
-				// getICPEdge fun.
-				// bool from_success, to_success;
-				TGetICPEdgeAdParams* icp_ad_params = nullptr;
+				// by the getICPEdge fun.
+				auto& icp_params = icp_ad_params.emplace_back();
 				if (ad_params)
 				{
-					icp_ad_params = new TGetICPEdgeAdParams;
-					// from_success = fillNodePropsFromGroupParams(
+					icp_params = std::make_unique<TGetICPEdgeAdParams>();
 					fillNodePropsFromGroupParams(
 						b_it, ad_params->groupB_params,
-						&icp_ad_params->from_params);
-					// to_success = fillNodePropsFromGroupParams(
+						&icp_params->from_params);
 					fillNodePropsFromGroupParams(
 						a_it, ad_params->groupA_params,
-						&icp_ad_params->to_params);
-
-					// MRPT_LOG_DEBUG_STREAM(">>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>");
-					// MRPT_LOG_DEBUG_STREAM("From nodeID (other): " << *b_it);
-					// MRPT_LOG_DEBUG_STREAM("From params (other): "
-					//<< icp_ad_params->from_params.getAsString());
-					// MRPT_LOG_DEBUG_STREAM("from_success: " << (from_success?
-					// "TRUE" : "FALSE"));
-					// MRPT_LOG_DEBUG_STREAM("**********");
-					// MRPT_LOG_DEBUG_STREAM("To nodeID (own)   : " << *a_it);
-					// MRPT_LOG_DEBUG_STREAM("To params (own)   : "
-					//<< icp_ad_params->to_params.getAsString());
-					// MRPT_LOG_DEBUG_STREAM("to_success: " << (to_success?
-					// "TRUE" : "FALSE"));
-					// MRPT_LOG_DEBUG_STREAM("<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<");
+						&icp_params->to_params);
 				}
+			}
+		}
 
-				// fetch the ICP constraint bi => ai
-				mrpt::slam::CICP::TReturnInfo icp_info;
-				constraint_t edge;
-				bool found_edge = this->getICPEdge(
-					b_it, a_it, &edge, &icp_info, icp_ad_params);
+		// fetch the ICP constraints bi => ai. They are independent, so they
+		// run in parallel, each one with its own copy of the ICP object.
+		const size_t nHypots = generated_hypots->size();
+		std::vector<mrpt::slam::CICP::TReturnInfo> icp_infos(nHypots);
+		std::vector<constraint_t> edges(nHypots);
+		std::vector<uint8_t> found_edges(nHypots, 0);
+
+		// Optionally, skip pairs with very different scans:
+		std::vector<uint8_t> run_icp(nHypots, 1);
+		if (m_lc_params.LC_descriptor_candidates > 0 &&
+			m_lc_params.LC_descriptor_candidates < groupA.size())
+		{
+			run_icp =
+				this->selectHypotsByScanDescriptor(groupA, groupB, ad_params);
+		}
 
-				hypot->setEdge(edge);
-				hypot->goodness =
-					icp_info.goodness;	// goodness related to the edge
+		const unsigned int nThreads = numLCThreads(nHypots);
+		if (nThreads > 1)
+		{
+			mrpt::WorkerThreadsPool pool(
+				nThreads - 1, mrpt::WorkerThreadsPool::POLICY_FIFO, "LC_ICP");
+			pool.parallel_for(0, nHypots, 1, [&](size_t i) {
+				if (!run_icp[i]) return;
+				const hypot_t* hypot = (*generated_hypots)[i];
+				mrpt::slam::CICP icp = range_ops_t::params.icp;
+				icp.options.numThreads = 1;
+				found_edges[i] = this->getICPEdgeWith(
+					icp, hypot->from, hypot->to, &edges[i], &icp_infos[i],
+					icp_ad_params[i].get());
+			});
+		}
+		else
+		{
+			for (size_t i = 0; i < nHypots; i++)
+			{
+				if (!run_icp[i]) continue;
+				const hypot_t* hypot = (*generated_hypots)[i];
+				found_edges[i] = this->getICPEdge(
+					hypot->from, hypot->to, &edges[i], &icp_infos[i],
+					icp_ad_params[i].get());
+			}
+		}
 
-				// Check if invalid
-				//
-				// Goodness Threshold
-				double goodness_thresh =
-					m_laser_params.goodness_threshold_win.getMedian() *
-					m_lc_icp_constraint_factor;
-				bool accept_goodness = icp_info.goodness > goodness_thresh;
-				MRPT_LOG_DEBUG_STREAM(
-					"generateHypotsPool:\nCurr. Goodness: "
-					<< icp_info.goodness << "|\t Threshold: " << goodness_thresh
-					<< " => " << (accept_goodness ? "ACCEPT" : "REJECT")
-					<< endl);
-
-				if (!found_edge || !accept_goodness)
-				{
-					hypot->is_valid = false;
-					invalid_hypots++;
-				}
-				generated_hypots->push_back(hypot);
-				MRPT_LOG_DEBUG_STREAM(hypot->getAsString());
+		// Goodness Threshold
+		const double goodness_thresh =
+			m_laser_params.goodness_threshold_win.getMedian() *
+			m_lc_icp_constraint_factor;
+		for (size_t i = 0; i < nHypots; i++)
+		{
+			hypot_t* hypot = (*generated_hypots)[i];
+			const auto& icp_info = icp_infos[i];
+
+			hypot->setEdge(edges[i]);
+			hypot->goodness =
+				icp_info.goodness;	// goodness related to the edge
 
-				// delete pointer to getICPEdge additional parameters if they
-				// were initialized
-				delete icp_ad_params;
+			// Check if invalid
+			bool accept_goodness = icp_info.goodness > goodness_thresh;
+			MRPT_LOG_DEBUG_STREAM(
+				"generateHypotsPool:\nCurr. Goodness: "
+				<< icp_info.goodness << "|\t Threshold: " << goodness_thresh
+				<< " => " << (accept_goodness ? "ACCEPT" : "REJECT") << endl);
+
+			if (!found_edges[i] || !accept_goodness)
+			{
+				hypot->is_valid = false;
+				invalid_hypots++;
 			}
+			MRPT_LOG_DEBUG_STREAM(hypot->getAsString());
 		}
 		MRPT_LOG_DEBUG_STREAM(
 			"Generated pool of hypotheses...\tsize = "
@@ -851,16 +886,66 @@ bool CLoopCloserERD<GRAPH_T>::computeDominantEigenVector(
 	using namespace std;
 	ASSERTDEB_(eigvec);
 
-	this->m_time_logger.enter("DominantEigenvectorComputation");
+	mrpt::system::CTimeLoggerEntry tle(
+		this->m_time_logger, "DominantEigenvectorComputation");
+
+	const int n = consist_matrix.rows();
+	if (n < 2)
+	{
+		MRPT_LOG_DEBUG_STREAM(
+			"Consistency matrix of size "
+			<< n << " => Skipping current evaluation.");
+		return false;
+	}
+	eigvec->resize(n);
 
 	double lambda1, lambda2;  // eigenvalues to use
 	bool is_valid_lambda_ratio = false;
 
 	if (use_power_method)
 	{
-		THROW_EXCEPTION(
-			"\nPower method for computing the first two "
-			"eigenvectors/eigenvalues hasn't been implemented yet\n");
+		// Subspace iteration with a small block of vectors, so that the
+		// second eigenvalue converges as well. The matrix is shifted to be
+		// semidefinite positive, so its largest eigenvalues are also the
+		// largest ones in magnitude.
+		const auto A = consist_matrix.asEigen();
+		const int p = std::min(n, 4);
+		const double shift = A.cwiseAbs().rowwise().sum().maxCoeff();
+		Eigen::MatrixXd Q(n, p);
+		for (int i = 0; i < n; i++)
+			for (int j = 0; j < p; j++)
+				Q(i, j) = j == 0 ? 1.0 : std::cos(i * j + 0.5 * j);
+
+		Eigen::VectorXd ritz = Eigen::VectorXd::Zero(p);
+		const int max_iters = 1000;
+		const double tol = 1e-9 * std::max(1.0, shift);
+		for (int iter = 0; iter < max_iters; iter++)
+		{
+			const Eigen::MatrixXd Z = A * Q + shift * Q;
+			Q = Eigen::HouseholderQR<Eigen::MatrixXd>(Z).householderQ() *
+				Eigen::MatrixXd::Identity(n, p);
+
+			// Rayleigh-Ritz: eigenpairs of A in the current subspace
+			const Eigen::MatrixXd AQ = A * Q;
+			Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> es(
+				Q.transpose() * AQ);
+			Q = Q * es.eigenvectors();
+			ritz = es.eigenvalues();  // ascending order
+
+			// Residuals of the two largest eigenpairs:
+			const Eigen::MatrixXd R = AQ * es.eigenvectors();
+			double max_residual = 0;
+			for (int j = p - 2; j < p; j++)
+				max_residual = std::max(
+					max_residual, (R.col(j) - ritz[j] * Q.col(j)).norm());
+			if (max_residual < tol) break;
+		}
+
+		for (int i = 0; i != n; ++i)
+			(*eigvec)[i] = std::abs(Q(i, p - 1));
+
+		lambda1 = ritz[p - 1];
+		lambda2 = ritz[p - 2];
 	}
 	else
 	{  // call to eigenVectors method
@@ -871,7 +956,7 @@ bool CLoopCloserERD<GRAPH_T>::computeDominantEigenVector(
 		// assert that the eivenvectors, eigenvalues, consistency matrix are of
 		// the same size
 		ASSERTDEBMSG_(
-			eigvecs.size() == eigvals.size() &&
+			eigvecs.cols() == eigvals.size() &&
 				consist_matrix.cols() == eigvals.size(),
 			mrpt::format(
 				"Size of eigvecs \"%lu\","
@@ -906,7 +991,6 @@ bool CLoopCloserERD<GRAPH_T>::computeDominantEigenVector(
 	is_valid_lambda_ratio =
 		(curr_lambda_ratio > m_lc_params.LC_eigenvalues_ratio_thresh);
 
-	this->m_time_logger.leave("DominantEigenvectorComputation");
 	return is_valid_lambda_ratio;
 
 	MRPT_END
@@ -944,111 +1028,120 @@ void CLoopCloserERD<GRAPH_T>::generatePWConsistenciesMatrix(
 		<< "\tgroupB: " << getSTLContainerAsString(groupB) << endl
 		<< "\tHypots pool Size: " << hypots_pool.size());
 
-	// b1
+	// Optimal paths between all pairs of nodes in each group. They are
+	// computed once (each Dijkstra projection serves the following nodes
+	// of the group already visited by it) and kept for all the hypotheses
+	// pairs using them.
+	std::map<std::pair<TNodeID, TNodeID>, path_t> opt_paths;
+	auto fetchGroupPaths = [&](const std::vector<uint32_t>& group,
+							   const paths_t* group_opt_paths) {
+		for (auto n1_it = group.begin(); n1_it != group.end(); ++n1_it)
+		{
+			bool projected_from_n1 = false;
+			for (auto n2_it = n1_it + 1; n2_it != group.end(); ++n2_it)
+			{
+				const TNodeID n1 = *n1_it, n2 = *n2_it;
+				if (group_opt_paths)
+				{
+					opt_paths[{n1, n2}] =
+						*this->findPathByEnds(*group_opt_paths, n1, n2, true);
+					continue;
+				}
+				const path_t* path =
+					projected_from_n1 ? this->queryOptimalPath(n2) : nullptr;
+				if (!path)
+				{
+					MRPT_LOG_DEBUG_STREAM(
+						"Running dijkstra " << n1 << " => " << n2);
+					execDijkstraProjection(n1, n2);
+					projected_from_n1 = true;
+					path = this->queryOptimalPath(n2);
+				}
+				// No path if the graph is still too small for projecting:
+				if (!path || path->getSource() != n1 ||
+					path->getDestination() != n2)
+					continue;
+				opt_paths[{n1, n2}] = *path;
+			}
+		}
+	};
+	fetchGroupPaths(groupA, groupA_opt_paths);
+	fetchGroupPaths(groupB, groupB_opt_paths);
+
+	std::map<std::pair<TNodeID, TNodeID>, const hypot_t*> hypots_by_ends;
+	for (const hypot_t* h : hypots_pool)
+		hypots_by_ends.emplace(std::make_pair(h->from, h->to), h);
+	auto hypotByEnds = [&](TNodeID from, TNodeID to) {
+		const auto it = hypots_by_ends.find({from, to});
+		if (it == hypots_by_ends.end())
+			throw mrpt::graphs::HypothesisNotFoundException(from, to);
+		return it->second;
+	};
+
+	// All the consistency elements to evaluate, for each pair of hypotheses
+	// b2=>a1, b1=>a2:
+	struct TPWConsistencyTask
+	{
+		const hypot_t *hypot_b2_a1, *hypot_b1_a2;
+		const path_t *path_a1_a2, *path_b1_b2;
+	};
+	std::vector<TPWConsistencyTask> tasks;
 	for (auto b1_it = groupB.begin(); b1_it != groupB.end(); ++b1_it)
 	{
-		TNodeID b1 = *b1_it;
-
-		// b2
 		for (auto b2_it = b1_it + 1; b2_it != groupB.end(); ++b2_it)
 		{
-			TNodeID b2 = *b2_it;
-
-			// a1
+			const auto path_b = opt_paths.find({*b1_it, *b2_it});
 			for (auto a1_it = groupA.begin(); a1_it != groupA.end(); ++a1_it)
 			{
-				TNodeID a1 = *a1_it;
-				hypot_t* hypot_b2_a1 =
-					this->findHypotByEnds(hypots_pool, b2, a1);
-				// MRPT_LOG_DEBUG_STREAM("hypot_b2_a1: " <<
-				// hypot_b2_a1->getAsString());
-
-				// a2
+				const hypot_t* hypot_b2_a1 = hypotByEnds(*b2_it, *a1_it);
 				for (auto a2_it = a1_it + 1; a2_it != groupA.end(); ++a2_it)
 				{
-					TNodeID a2 = *a2_it;
-					hypot_t* hypot_b1_a2 =
-						this->findHypotByEnds(hypots_pool, b1, a2);
-					// MRPT_LOG_DEBUG_STREAM("hypot_b1_a2: " <<
-					// hypot_b1_a2->getAsString());
-
-					double consistency;
-
-					// compute consistency element
-					if (hypot_b2_a1->is_valid && hypot_b1_a2->is_valid)
-					{
-						// extract vector of hypotheses that connect the given
-						// nodes,
-						// instead of passing the whole hypothesis pool.
-						hypotsp_t extracted_hypots;
-						extracted_hypots.push_back(hypot_b2_a1);
-						extracted_hypots.push_back(hypot_b1_a2);
-
-						paths_t* curr_opt_paths = nullptr;
-						if (groupA_opt_paths || groupB_opt_paths)
-						{  // fill curr_opt_paths
-							curr_opt_paths = new paths_t();
-						}
-
-						// decide on additional optimal paths
-						if (curr_opt_paths)
-						{
-							// groupA
-							if (groupA_opt_paths)
-							{  // a1 -> a2 optimal path
-								const path_t* p = this->findPathByEnds(
-									*groupA_opt_paths, a1, a2, true);
-								curr_opt_paths->push_back(*p);
-							}
-							else
-							{  // empty
-								curr_opt_paths->push_back(path_t());
-							}
-
-							if (groupB_opt_paths)
-							{  // b1 -> b2 optimal path
-								const path_t* p = this->findPathByEnds(
-									*groupB_opt_paths, b1, b2, true);
-								curr_opt_paths->push_back(*p);
-							}
-							else
-							{  // empty
-								curr_opt_paths->push_back(path_t());
-							}
-						}
-
-						consistency = this->generatePWConsistencyElement(
-							a1, a2, b1, b2, extracted_hypots, curr_opt_paths);
-
-						delete curr_opt_paths;
-					}
-					else
-					{  //  null those that don't look good
-						consistency = 0;
-					}
-
-					// MRPT_LOG_DEBUG_STREAM(
-					//"Adding hypothesis consistency for nodeIDs: "
-					//<< "[b1] " << b1 << ", [b2] -> " << b2
-					//<< ", [a1] -> " << a1 << ", [a2] -> " << a2
-					//<< " ==> " << consistency << endl);
-
-					// fill the PW consistency matrix corresponding element -
-					// symmetrical
-					int id1 = hypot_b2_a1->id;
-					int id2 = hypot_b1_a2->id;
-
-					(*consist_matrix)(id1, id2) = consistency;
-					(*consist_matrix)(id2, id1) = consistency;
-
-					// MRPT_LOG_DEBUG_STREAM("id1 = " << id1 << "\t|"
-					//<< "id2 = " << id2 << "\t|"
-					//<< "consistency = " << consistency);
+					const auto path_a = opt_paths.find({*a1_it, *a2_it});
+					TPWConsistencyTask& t = tasks.emplace_back();
+					t.hypot_b2_a1 = hypot_b2_a1;
+					t.hypot_b1_a2 = hypotByEnds(*b1_it, *a2_it);
+					t.path_a1_a2 =
+						path_a != opt_paths.end() ? &path_a->second : nullptr;
+					t.path_b1_b2 =
+						path_b != opt_paths.end() ? &path_b->second : nullptr;
 				}
 			}
 		}
 	}
 
+	// compute consistency elements. Null those that don't look good.
+	std::vector<double> consistencies(tasks.size(), 0);
+	auto evalTask = [&](size_t i) {
+		const TPWConsistencyTask& t = tasks[i];
+		if (t.hypot_b2_a1->is_valid && t.hypot_b1_a2->is_valid &&
+			t.path_a1_a2 && t.path_b1_b2)
+		{
+			consistencies[i] = computePWConsistency(
+				*t.path_a1_a2, *t.hypot_b1_a2, *t.path_b1_b2, *t.hypot_b2_a1);
+		}
+	};
+	const unsigned int nThreads = numLCThreads(tasks.size());
+	if (nThreads > 1)
+	{
+		mrpt::WorkerThreadsPool pool(
+			nThreads - 1, mrpt::WorkerThreadsPool::POLICY_FIFO, "LC_PWC");
+		pool.parallel_for(0, tasks.size(), 64, evalTask);
+	}
+	else
+	{
+		for (size_t i = 0; i < tasks.size(); i++)
+			evalTask(i);
+	}
+
+	// fill the PW consistency matrix corresponding element - symmetrical
+	for (size_t i = 0; i < tasks.size(); i++)
+	{
+		const int id1 = tasks[i].hypot_b2_a1->id;
+		const int id2 = tasks[i].hypot_b1_a2->id;
+		(*consist_matrix)(id1, id2) = consistencies[i];
+		(*consist_matrix)(id2, id1) = consistencies[i];
+	}
+
 	// MRPT_LOG_WARN_STREAM("Consistency matrix:" << endl
 	//<< header_sep << endl
 	//<< *consist_matrix << endl);
@@ -1107,7 +1200,7 @@ double CLoopCloserERD<GRAPH_T>::generatePWConsistencyElement(
 
 	// b1 ==> b2
 	const path_t* path_b1_b2;
-	if (!opt_paths || opt_paths->rend()->isEmpty())
+	if (!opt_paths || opt_paths->rbegin()->isEmpty())
 	{
 		MRPT_LOG_DEBUG_STREAM(
 			"Running djkstra [b1] " << b1 << " => [b2] " << b2);
@@ -1128,20 +1221,11 @@ double CLoopCloserERD<GRAPH_T>::generatePWConsistencyElement(
 	// forward edge b2=>a1
 	hypot_t* hypot_b2_a1 = this->findHypotByEnds(hypots, b2, a1);
 
-	// Composition of Poses
-	// Order : a1 ==> a2 ==> b1 ==> b2 ==> a1
-	constraint_t res_transform(path_a1_a2->curr_pose_pdf);
-	res_transform += hypot_b1_a2->getInverseEdge();
-	res_transform += path_b1_b2->curr_pose_pdf;
-	res_transform += hypot_b2_a1->getEdge();
-
 	MRPT_LOG_DEBUG_STREAM(
-		"\n-----------Resulting Transformation----------- Hypots: #"
+		"\n-----------Resulting Consistency----------- Hypots: #"
 		<< hypot_b1_a2->id << ", #" << hypot_b2_a1->id << endl
 		<< "a1 --> a2 => b1 --> b2 => a1: " << a1 << " --> " << a2 << " => "
 		<< b1 << " --> " << b2 << " => " << a1 << endl
-		<< res_transform << endl
-		<< endl
 		<< "DIJKSTRA: " << a1 << " --> " << a2 << ": "
 		<< path_a1_a2->curr_pose_pdf << endl
 		<< "DIJKSTRA: " << b1 << " --> " << b2 << ": "
@@ -1151,29 +1235,38 @@ double CLoopCloserERD<GRAPH_T>::generatePWConsistencyElement(
 		<< "hypot_b2_a1:\n"
 		<< hypot_b2_a1->getEdge() << endl);
 
+	return computePWConsistency(
+		*path_a1_a2, *hypot_b1_a2, *path_b1_b2, *hypot_b2_a1);
+	MRPT_END
+}  // end of generatePWConsistencyElement
+
+template <class GRAPH_T>
+double CLoopCloserERD<GRAPH_T>::computePWConsistency(
+	const path_t& path_a1_a2, const hypot_t& hypot_b1_a2,
+	const path_t& path_b1_b2, const hypot_t& hypot_b2_a1)
+{
+	// Composition of Poses
+	// Order : a1 ==> a2 ==> b1 ==> b2 ==> a1
+	constraint_t res_transform(path_a1_a2.curr_pose_pdf);
+	res_transform += hypot_b1_a2.getInverseEdge();
+	res_transform += path_b1_b2.curr_pose_pdf;
+	res_transform += hypot_b2_a1.getEdge();
+
 	// get the vector of the corresponding transformation - [x, y, phi] form
 	typename pose_t::vector_t T;
 	res_transform.getMeanVal().asVector(T);
 
 	// information matrix
-	CMatrixDouble33 cov_mat;
+	mrpt::math::CMatrixDouble33 cov_mat;
 	res_transform.getCovariance(cov_mat);
 
 	// there has to be an error with the initial Olson formula - p.15.
 	// There must be a minus in the exponent and the covariance matrix instead
 	// of
 	// the information matrix.
-	double exponent = -mrpt::math::multiply_HtCH_scalar(T, cov_mat);
-	double consistency_elem = exp(exponent);
-
-	// cout << "T = " << endl << T << endl;
-	// cout << "exponent = " << exponent << endl;
-	// cout << "consistency_elem = " << consistency_elem << endl;
-	// mrpt::system::pause();
-
-	return consistency_elem;
-	MRPT_END
-}  // end of generatePWConsistencyElement
+	const double exponent = -mrpt::math::multiply_HtCH_scalar(T, cov_mat);
+	return std::exp(exponent);
+}
 
 template <class GRAPH_T>
 const mrpt::graphslam::TUncertaintyPath<GRAPH_T>*
@@ -1252,6 +1345,79 @@ mrpt::graphs::detail::THypothesis<GRAPH_T>*
 	}
 }
 
+template <class GRAPH_T>
+std::vector<uint8_t> CLoopCloserERD<GRAPH_T>::selectHypotsByScanDescriptor(
+	const std::vector<uint32_t>& groupA, const std::vector<uint32_t>& groupB,
+	const TGenerateHypotsPoolAdParams* ad_params)
+{
+	MRPT_START
+	mrpt::system::CTimeLoggerEntry tle(
+		this->m_time_logger, "selectHypotsByScanDescriptor");
+
+	const size_t k = m_lc_params.LC_descriptor_candidates;
+	const size_t nA = groupA.size();
+	std::vector<uint8_t> selected(nA * groupB.size(), 0);
+
+	// Descriptors of the scans of each node (empty if there is no scan):
+	const auto getDescriptor =
+		[&](mrpt::graphs::TNodeID nodeID,
+			const std::map<mrpt::graphs::TNodeID, node_props_t>*
+				group_params) {
+			CScanDescriptorIndex::descriptor_t desc;
+			node_props_t props;
+			const bool has_props = group_params &&
+				fillNodePropsFromGroupParams(nodeID, *group_params, &props);
+			global_pose_t pose;
+			mrpt::obs::CObservation2DRangeScan::Ptr scan;
+			this->getPropsOfNodeID(
+				nodeID, &pose, scan, has_props ? &props : nullptr);
+			if (scan)
+			{
+				CScanDescriptorIndex::computeDescriptor(
+					*scan, desc, CScanDescriptorIndex::DEFAULT_NUM_RINGS);
+			}
+			return desc;
+		};
+
+	std::vector<CScanDescriptorIndex::descriptor_t> descsA;
+	descsA.reserve(nA);
+	for (const auto a : groupA)
+		descsA.push_back(getDescriptor(
+			a, ad_params ? &ad_params->groupA_params : nullptr));
+
+	std::vector<std::pair<float, size_t>> dists;
+	for (size_t ib = 0; ib < groupB.size(); ib++)
+	{
+		const auto descB = getDescriptor(
+			groupB[ib], ad_params ? &ad_params->groupB_params : nullptr);
+
+		dists.clear();
+		for (size_t ia = 0; ia < nA; ia++)
+		{
+			// Nodes without scans would not get an ICP edge anyway:
+			if (descB.empty() || descsA[ia].empty()) continue;
+			dists.emplace_back(
+				CScanDescriptorIndex::descriptorDistanceSqr(descB, descsA[ia]),
+				ia);
+		}
+		const size_t n = std::min(k, dists.size());
+		std::partial_sort(dists.begin(), dists.begin() + n, dists.end());
+		for (size_t i = 0; i < n; i++)
+			selected[ib * nA + dists[i].second] = 1;
+	}
+	return selected;
+	MRPT_END
+}
+
+template <class GRAPH_T>
+unsigned int CLoopCloserERD<GRAPH_T>::numLCThreads(size_t nTasks) const
+{
+	unsigned int n = m_lc_params.LC_num_threads;
+	if (n == 0) n = std::max(1U, std::thread::hardware_concurrency());
+	return static_cast<unsigned int>(
+		std::max<size_t>(1, std::min<size_t>(n, nTasks)));
+}
+
 template <class GRAPH_T>
 void CLoopCloserERD<GRAPH_T>::execDijkstraProjection(
 	mrpt::graphs::TNodeID starting_node, mrpt::graphs::TNodeID ending_node)
@@ -2509,6 +2675,10 @@ void CLoopCloserERD<GRAPH_T>::TLoopClosureParams::dumpToTextStream(
 	   << (LC_check_curr_partition_only ? "TRUE" : "FALSE") << endl;
 	ss << "New registered nodes required for full partitioning   = "
 	   << full_partition_per_nodes << endl;
+	ss << "Threads for evaluating loop closures (0: all cores)   = "
+	   << LC_num_threads << endl;
+	ss << "ICP hypotheses per node by scan descriptor (0: all)   = "
+	   << LC_descriptor_candidates << endl;
 	ss << "Visualize map partitions                              = "
 	   << (visualize_map_partitions ? "TRUE" : "FALSE") << endl;
 
@@ -2531,6 +2701,10 @@ void CLoopCloserERD<GRAPH_T>::TLoopClosureParams::loadFromConfigFile(
 		source.read_bool(section, "LC_check_curr_partition_only", true, false);
 	full_partition_per_nodes =
 		source.read_int(section, "full_partition_per_nodes", 50, false);
+	LC_num_threads = static_cast<unsigned int>(
+		source.read_int(section, "LC_num_threads", 0, false));
+	LC_descriptor_candidates = source.read_uint64_t(
+		section, "LC_descriptor_candidates", LC_descriptor_candidates, false);
 	visualize_map_partitions = source.read_bool(
 		"VisualizationParameters", "visualize_map_partitions", true, false);
 
@@ -0,0 +1,107 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#pragma once
+
+#include <mrpt/graphslam/CIncrementalSmoother.h>
+#include <mrpt/graphslam/GSO/CLevMarqGSO.h>
+
+#include <map>
+#include <string>
+
+namespace mrpt::graphslam::optimizers
+{
+/**\brief Incremental (iSAM-style) graph slam optimization scheme.
+ *
+ * ## Description
+ *
+ * Instead of optimizing the whole graph (or the nodes around the current
+ * one) again each time a node is registered, as CLevMarqGSO does, the
+ * square-root information matrix of the graph is kept between calls, and
+ * only its part affected by the new nodes and edges is updated. See
+ * mrpt::graphslam::CIncrementalSmoother for the details. The time of each
+ * update is roughly constant along odometry-like steps, and proportional to
+ * the length of the loop after a loop closure.
+ *
+ * Graph visualization and the rest of parameters are those of CLevMarqGSO,
+ * but \b optimization_distance, which is ignored: all the nodes are always
+ * estimated.
+ *
+ * ### .ini Configuration Parameters
+ *
+ * \htmlinclude graphslam-engine_config_params_preamble.txt
+ *
+ * - \b relinearize_threshold
+ *   + \a Section       : OptimizerParameters
+ *   + \a Default value : 0.05
+ *   + \a Required      : FALSE
+ *   + \a Description   : Nodes whose estimate moves more than this (meters or
+ *   radians) away from their linearization point are relinearized.
+ *
+ * - \b relinearize_skip
+ *   + \a Section       : OptimizerParameters
+ *   + \a Default value : 10
+ *   + \a Required      : FALSE
+ *   + \a Description   : Look for nodes to relinearize only once in this
+ *   number of updates.
+ *
+ * - \b wildfire_threshold
+ *   + \a Section       : OptimizerParameters
+ *   + \a Default value : 1e-3
+ *   + \a Required      : FALSE
+ *   + \a Description   : Older nodes are only updated while the estimates of
+ *   the newer ones change more than this.
+ *
+ * \note (New in MRPT 2.4.9)
+ * \ingroup mrpt_graphslam_grp
+ */
+template <class GRAPH_T = typename mrpt::graphs::CNetworkOfPoses2DInf>
+class CIncrementalSmoothingGSO
+	: public mrpt::graphslam::optimizers::CLevMarqGSO<GRAPH_T>
+{
+   public:
+	/**\brief Handy typedefs */
+	/**\{*/
+	using lm_parent = mrpt::graphslam::optimizers::CLevMarqGSO<GRAPH_T>;
+	using smoother_t = mrpt::graphslam::CIncrementalSmoother<GRAPH_T>;
+	/**\}*/
+
+	CIncrementalSmoothingGSO();
+	~CIncrementalSmoothingGSO() override;
+
+	bool updateState(
+		mrpt::obs::CActionCollection::Ptr action,
+		mrpt::obs::CSensoryFrame::Ptr observations,
+		mrpt::obs::CObservation::Ptr observation) override;
+
+	void initializeVisuals() override;
+	void notifyOfWindowEvents(
+		const std::map<std::string, bool>& events_occurred) override;
+
+	void loadParams(const std::string& source_fname) override;
+	void printParams() const override;
+	void getDescriptiveReport(std::string* report_str) const override;
+
+	const smoother_t& getSmoother() const { return m_smoother; }
+
+   protected:
+	/** Locks the graph and calls incrementalUpdate(). Used in multithreaded
+	 * optimization */
+	void optimizeGraph() override;
+	/** Incorporates the new nodes and edges to the smoother, and updates the
+	 * graph nodes. If `relinearize_all` is true, all the edges are
+	 * relinearized first, as in an iteration of a batch solver. */
+	void incrementalUpdate(bool relinearize_all = false);
+
+	smoother_t m_smoother;
+	/** Statistics of the last update */
+	typename smoother_t::TUpdateInfo m_last_update_info;
+};
+}  // namespace mrpt::graphslam::optimizers
+#include "CIncrementalSmoothingGSO_impl.h"
@@ -0,0 +1,205 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#pragma once
+#include <mrpt/config/CConfigFile.h>
+#include <mrpt/graphslam/GSO/CIncrementalSmoothingGSO.h>
+#include <mrpt/system/CTimeLogger.h>
+
+namespace mrpt::graphslam::optimizers
+{
+template <class GRAPH_T>
+CIncrementalSmoothingGSO<GRAPH_T>::CIncrementalSmoothingGSO()
+{
+	this->initializeLoggers("CIncrementalSmoothingGSO");
+}
+
+template <class GRAPH_T>
+CIncrementalSmoothingGSO<GRAPH_T>::~CIncrementalSmoothingGSO()
+{
+	if (this->m_thread_optimize.joinable()) this->m_thread_optimize.join();
+}
+
+template <class GRAPH_T>
+bool CIncrementalSmoothingGSO<GRAPH_T>::updateState(
+	[[maybe_unused]] mrpt::obs::CActionCollection::Ptr action,
+	[[maybe_unused]] mrpt::obs::CSensoryFrame::Ptr observations,
+	[[maybe_unused]] mrpt::obs::CObservation::Ptr observation)
+{
+	MRPT_START
+	if (this->m_graph->nodeCount() > this->m_last_total_num_of_nodes)
+	{
+		this->m_last_total_num_of_nodes = this->m_graph->nodeCount();
+		this->registered_new_node = true;
+
+		if (this->opt_params.optimization_on_second_thread)
+		{
+			// join the previous optimization thread
+			if (this->m_thread_optimize.joinable())
+				this->m_thread_optimize.join();
+
+			this->m_thread_optimize =
+				std::thread(&CIncrementalSmoothingGSO::optimizeGraph, this);
+		}
+		else
+		{
+			this->incrementalUpdate();
+		}
+	}
+	return true;
+	MRPT_END
+}
+
+template <class GRAPH_T>
+void CIncrementalSmoothingGSO<GRAPH_T>::initializeVisuals()
+{
+	MRPT_START
+	ASSERTDEB_(this->m_has_read_config);
+	lm_parent::parent::initializeVisuals();
+
+	// No optimization distance to show, just the graph:
+	this->initGraphVisualization();
+	if (this->m_win_observer)
+	{
+		this->m_win_observer->registerKeystroke(
+			this->opt_params.keystroke_optimize_graph,
+			"Manually trigger a full graph optimization");
+	}
+	MRPT_END
+}
+
+template <class GRAPH_T>
+void CIncrementalSmoothingGSO<GRAPH_T>::notifyOfWindowEvents(
+	const std::map<std::string, bool>& events_occurred)
+{
+	MRPT_START
+	lm_parent::notifyOfWindowEvents(events_occurred);
+
+	const auto it =
+		events_occurred.find(this->opt_params.keystroke_optimize_graph);
+	if (it != events_occurred.end() && it->second)
+		this->incrementalUpdate(/*relinearize_all=*/true);
+	MRPT_END
+}
+
+template <class GRAPH_T>
+void CIncrementalSmoothingGSO<GRAPH_T>::optimizeGraph()
+{
+	MRPT_START
+	std::lock_guard<std::mutex> graph_lock(*this->m_graph_section);
+	this->incrementalUpdate();
+	MRPT_END
+}
+
+template <class GRAPH_T>
+void CIncrementalSmoothingGSO<GRAPH_T>::incrementalUpdate(bool relinearize_all)
+{
+	MRPT_START
+	mrpt::system::CTimeLoggerEntry tle(
+		this->m_time_logger, "CIncrementalSmoothingGSO::incrementalUpdate");
+
+	// if less than X nodes exist overall, do not try optimizing
+	if (this->m_min_nodes_for_optimization > this->m_graph->nodes.size())
+		return;
+
+	auto& ui = m_last_update_info;
+	if (relinearize_all) m_smoother.relinearizeAll(*this->m_graph, &ui);
+	else
+		m_smoother.update(*this->m_graph, &ui);
+
+	this->m_just_fully_optimized_graph =
+		ui.reeliminated_nodes > 0 &&
+		ui.reeliminated_nodes == m_smoother.nodeCount();
+
+	MRPT_LOG_DEBUG_STREAM(
+		"Incremental update: " << ui.new_nodes << " new nodes, "
+							   << ui.new_edges << " new edges, "
+							   << ui.relinearized_nodes << " relinearized, "
+							   << ui.reeliminated_nodes << " re-eliminated, "
+							   << ui.updated_nodes << " updated nodes.");
+	MRPT_END
+}
+
+template <class GRAPH_T>
+void CIncrementalSmoothingGSO<GRAPH_T>::loadParams(
+	const std::string& source_fname)
+{
+	MRPT_START
+	lm_parent::loadParams(source_fname);
+
+	// All the nodes are always estimated:
+	this->opt_params.optimization_distance = -1;
+
+	mrpt::config::CConfigFile source(source_fname);
+	const std::string section = "OptimizerParameters";
+	auto& o = m_smoother.options;
+	o.relinearize_threshold = source.read_double(
+		section, "relinearize_threshold", o.relinearize_threshold, false);
+	o.relinearize_skip = static_cast<unsigned int>(source.read_int(
+		section, "relinearize_skip", o.relinearize_skip, false));
+	o.wildfire_threshold = source.read_double(
+		section, "wildfire_threshold", o.wildfire_threshold, false);
+	MRPT_END
+}
+
+template <class GRAPH_T>
+void CIncrementalSmoothingGSO<GRAPH_T>::printParams() const
+{
+	lm_parent::printParams();
+
+	const auto& o = m_smoother.options;
+	std::cout << "-----------[ Incremental Smoothing ] -------\n";
+	std::cout << "Relinearize threshold          = " << o.relinearize_threshold
+			  << "\n";
+	std::cout << "Relinearize every N updates    = " << o.relinearize_skip
+			  << "\n";
+	std::cout << "Wildfire threshold             = " << o.wildfire_threshold
+			  << "\n";
+}
+
+template <class GRAPH_T>
+void CIncrementalSmoothingGSO<GRAPH_T>::getDescriptiveReport(
+	std::string* report_str) const
+{
+	MRPT_START
+	using namespace std;
+
+	const static std::string report_sep(2, '\n');
+	const static std::string header_sep(80, '#');
+
+	// Report on graph
+	stringstream class_props_ss;
+	class_props_ss << "Incremental Smoothing Optimization Summary: "
+				   << std::endl;
+	class_props_ss << header_sep << std::endl;
+	class_props_ss << "Nodes: " << m_smoother.nodeCount()
+				   << " | Edges: " << m_smoother.edgeCount()
+				   << " | Nonzero blocks of R: "
+				   << m_smoother.factorNonZeroBlocks() << std::endl;
+
+	// time and output logging
+	const std::string time_res = this->m_time_logger.getStatsAsText();
+	const std::string output_res = this->getLogAsString();
+
+	// merge the individual reports
+	report_str->clear();
+	lm_parent::parent::getDescriptiveReport(report_str);
+
+	*report_str += class_props_ss.str();
+	*report_str += report_sep;
+
+	*report_str += time_res;
+	*report_str += report_sep;
+
+	*report_str += output_res;
+	*report_str += report_sep;
+
+	MRPT_END
+}
+}  // namespace mrpt::graphslam::optimizers
@@ -19,10 +19,14 @@
 #include <mrpt/poses/CPose2D.h>
 #include <mrpt/poses/CPose3D.h>
 
+#include <atomic>
 #include <cmath>
 #include <iostream>
 #include <map>
+#include <memory>
+#include <set>
 #include <string>
+#include <thread>
 
 namespace mrpt::graphslam::optimizers
 {
@@ -48,7 +52,12 @@ namespace mrpt::graphslam::optimizers
  *   + \a Default value :  FALSE
  *   + \a Required      : FALSE
  *   + \a Description   : Specify whether to use a second thread to optimize
- *   the graph.
+ *   the graph. The second thread optimizes a snapshot of the graph without
+ *   locking it, so the node/edge deciders keep on adding nodes meanwhile. The
+ *   optimized poses are merged back into the graph at the next updateState()
+ *   call after the optimization finishes. The nodes added in the meantime are
+ *   moved along with the newest node of the snapshot, keeping their relative
+ *   poses to it.
  *
  * - \b LC_min_nodeid_diff
  *  + \a Section       : GeneralConfiguration
@@ -99,6 +108,26 @@ namespace mrpt::graphslam::optimizers
  *  + \a Required      : FALSE
  *  + \a Description   : Refers to the Levenberg-Marquardt optimization.
  *
+ * - \b reuse_symbolic_factorization
+ *  + \a Section       : OptimizerParameters
+ *  + \a Default value : TRUE
+ *  + \a Required      : FALSE
+ *  + \a Description   : Keep the sparse Cholesky ordering and symbolic
+ *  factorization between successive optimizations, recomputing it only when
+ *  the structure of the optimized subgraph changes. See
+ *  mrpt::graphslam::TSparseCholeskyCache (New in MRPT 2.4.9)
+ *
+ * - \b sliding_window_size
+ *  + \a Section       : OptimizerParameters
+ *  + \a Default value : 0
+ *  + \a Required      : FALSE
+ *  + \a Description   : If >0, the partial optimizations are done over the
+ *  last \b sliding_window_size nodes instead of those within
+ *  \b optimization_distance, and the older nodes are marginalized out into a
+ *  prior on the window (see mrpt::graphslam::marginalize_graph_nodes()),
+ *  instead of being held fixed. Full optimizations discard the prior, which is
+ *  computed again from the new estimates. (New in MRPT 2.4.9)
+ *
  *  \note For a detailed description of the optimization parameters of the
  *  Levenberg-Marquardt scheme, refer to
  *
@@ -131,7 +160,7 @@ class CLevMarqGSO
 	/**\}*/
 
 	CLevMarqGSO();
-	~CLevMarqGSO() override = default;
+	~CLevMarqGSO() override;
 
 	bool updateState(
 		mrpt::obs::CActionCollection::Ptr action,
@@ -178,6 +207,12 @@ class CLevMarqGSO
 		// nodeID difference for an edge to be considered loop closure
 		int LC_min_nodeid_diff;
 
+		/** Reuse the sparse Cholesky symbolic factorization across calls */
+		bool reuse_symbolic_factorization{true};
+
+		/** If >0, optimize the last nodes, marginalizing the older ones */
+		size_t sliding_window_size{0};
+
 		// Map of TPairNodesID to their corresponding edge as recorded in the
 		// last update of the optimizer state
 		typename GRAPH_T::edges_map_t last_pair_nodes_to_edge;
@@ -234,13 +269,42 @@ class CLevMarqGSO
 	 *
 	 */
 	void _optimizeGraph(bool is_full_update = false);
-	/** \brief Wrapper around _optimizeGraph which first locks the section and
-	 * then calls the _optimizeGraph method.
+	/**\brief Optimize the nodes of the given graph, which may be m_graph or
+	 * a snapshot of it.
+	 *
+	 * \param[out] optimized_nodes If not nullptr, filled with the IDs of the
+	 * nodes whose poses were optimized.
+	 */
+	void optimizeGraphInstance(
+		GRAPH_T& graph, bool is_full_update,
+		std::set<mrpt::graphs::TNodeID>* optimized_nodes = nullptr);
+	/** \brief Optimize the snapshot of the graph taken by
+	 * startSnapshotOptimization().
 	 *
-	 * Used in multithreaded optimization
-	 * \sa _optimizeGraph()
+	 * Runs on the second thread, without locking the graph section.
+	 * \sa _optimizeGraph(), mergeOptimizedSnapshot()
 	 */
 	void optimizeGraph() override;
+	/**\brief Copy the graph and start optimizing the copy on the second
+	 * thread.
+	 *
+	 * \warning Must be called with the graph section locked, and no
+	 * optimization running.
+	 */
+	void startSnapshotOptimization(bool is_full_update);
+	/**\brief If the optimization of the snapshot has finished, write the
+	 * optimized poses back into the graph. The nodes added after the snapshot
+	 * was taken are moved by the same correction as the newest node of the
+	 * snapshot.
+	 *
+	 * \warning Must be called with the graph section locked.
+	 * \return True if the results of an optimization were merged.
+	 */
+	bool mergeOptimizedSnapshot();
+	/**\brief Block until the optimization on the second thread (if any)
+	 * finishes.
+	 */
+	void waitForSnapshotOptimization();
 	/**\brief Check if a loop closure edge was added in the graph.
 	 *
 	 * Match the previously registered edges in the graph with the current. If
@@ -261,6 +325,11 @@ class CLevMarqGSO
 	 * \return True for issuing a full graph optimization, False otherwise
 	 */
 	bool checkForFullOptimization();
+	/**\brief Fill in the last \b sliding_window_size nodes, and marginalize
+	 * out the older ones that are not yet in m_marginal_prior
+	 */
+	void updateSlidingWindow(
+		const GRAPH_T& graph, std::set<mrpt::graphs::TNodeID>* window);
 	/**\brief Initialize objects relateed to the Graph Visualization
 	 */
 	void initGraphVisualization();
@@ -315,7 +384,7 @@ class CLevMarqGSO
 	 * distance to the specified nodeID
 	 */
 	void getNearbyNodesOf(
-		std::set<mrpt::graphs::TNodeID>* nodes_set,
+		const GRAPH_T& graph, std::set<mrpt::graphs::TNodeID>* nodes_set,
 		const mrpt::graphs::TNodeID& cur_nodeID, double distance);
 
 	// protected members
@@ -333,6 +402,25 @@ class CLevMarqGSO
 	// Use second thread for graph optimization
 	std::thread m_thread_optimize;
 
+	/**\name Optimization on the second thread
+	 *
+	 * The second thread only accesses the snapshot, and the front end only
+	 * reads it back after m_snapshot_optimized is set.
+	 */
+	/**\{*/
+	/**\brief Copy of the graph under optimization */
+	std::unique_ptr<GRAPH_T> m_graph_snapshot;
+	/**\brief Nodes of the snapshot whose poses were optimized */
+	std::set<mrpt::graphs::TNodeID> m_snapshot_optimized_nodes;
+	bool m_snapshot_is_full_update{false};
+	/**\brief Set by the second thread once the snapshot is optimized */
+	std::atomic_bool m_snapshot_optimized{false};
+	/**\brief A full optimization was requested while the second thread was
+	 * busy: issue it next.
+	 */
+	bool m_pending_full_update{false};
+	/**\}*/
+
 	/**\brief Enumeration that defines the behaviors towards using or ignoring a
 	 * newly added loop closure to fully optimize the graph
 	 */
@@ -385,6 +473,12 @@ class CLevMarqGSO
 
 	/**\brief Minimum number of nodes before we try optimizing the graph */
 	size_t m_min_nodes_for_optimization{3};
+
+	/**\brief Sparse Cholesky factorization reused between optimizations */
+	mrpt::graphslam::TSparseCholeskyCache m_cholesky_cache;
+
+	/**\brief Prior from the nodes marginalized out of the sliding window */
+	mrpt::graphslam::TMarginalizationPrior<GRAPH_T> m_marginal_prior;
 };
 }  // namespace mrpt::graphslam::optimizers
 #include "CLevMarqGSO_impl.h"
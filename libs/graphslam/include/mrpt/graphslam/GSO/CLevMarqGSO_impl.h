@@ -20,6 +20,12 @@ CLevMarqGSO<GRAPH_T>::CLevMarqGSO()
 	this->initializeLoggers("CLevMarqGSO");
 }
 
+template <class GRAPH_T>
+CLevMarqGSO<GRAPH_T>::~CLevMarqGSO()
+{
+	this->waitForSnapshotOptimization();
+}
+
 template <class GRAPH_T>
 bool CLevMarqGSO<GRAPH_T>::updateState(
 	mrpt::obs::CActionCollection::Ptr action,
@@ -27,6 +33,12 @@ bool CLevMarqGSO<GRAPH_T>::updateState(
 	mrpt::obs::CObservation::Ptr observation)
 {
 	MRPT_START
+	// Apply the results of the last optimization on the second thread as
+	// soon as they are ready:
+	if (opt_params.optimization_on_second_thread &&
+		this->mergeOptimizedSnapshot())
+	{ m_just_fully_optimized_graph = m_snapshot_is_full_update; }
+
 	if (this->m_graph->nodeCount() > m_last_total_num_of_nodes)
 	{
 		m_last_total_num_of_nodes = this->m_graph->nodeCount();
@@ -38,17 +50,24 @@ bool CLevMarqGSO<GRAPH_T>::updateState(
 			m_first_time_call = true;
 		}
 
+		bool is_full_update = this->checkForFullOptimization();
 		if (opt_params.optimization_on_second_thread)
 		{
-			// join the previous optimization thread
-			m_thread_optimize.join();
+			m_just_fully_optimized_graph = false;
 
-			// optimize the graph - run on a seperate thread
-			m_thread_optimize = std::thread(&CLevMarqGSO::optimizeGraph, this);
+			// Do not wait for the previous optimization: the new nodes will
+			// be included in the next one.
+			is_full_update = is_full_update || m_pending_full_update;
+			if (m_thread_optimize.joinable())
+			{ m_pending_full_update = is_full_update; }
+			else
+			{
+				m_pending_full_update = false;
+				this->startSnapshotOptimization(is_full_update);
+			}
 		}
 		else
 		{  // single threaded implementation
-			bool is_full_update = this->checkForFullOptimization();
 			this->_optimizeGraph(is_full_update);
 		}
 	}
@@ -102,7 +121,13 @@ void CLevMarqGSO<GRAPH_T>::notifyOfWindowEvents(
 		{ this->toggleOptDistanceVisualization(); }
 
 		if (events_occurred.find(opt_params.keystroke_optimize_graph)->second)
-		{ this->_optimizeGraph(/*is_full_update=*/true); }
+		{
+			// Finish and apply any optimization running on the second thread
+			// first:
+			this->waitForSnapshotOptimization();
+			this->mergeOptimizedSnapshot();
+			this->_optimizeGraph(/*is_full_update=*/true);
+		}
 	}
 
 	// graph toggling
@@ -371,30 +396,128 @@ void CLevMarqGSO<GRAPH_T>::optimizeGraph()
 									<< "\t" << std::this_thread::get_id()
 									<< endl
 									<< "\t"
-									<< "Trying to grab lock... ");
+									<< "Optimizing graph snapshot of "
+									<< m_graph_snapshot->nodeCount()
+									<< " nodes... ");
+
+	// No need to lock the graph section: only this thread accesses the
+	// snapshot until m_snapshot_optimized is set.
+	this->optimizeGraphInstance(
+		*m_graph_snapshot, m_snapshot_is_full_update,
+		&m_snapshot_optimized_nodes);
+	m_snapshot_optimized = true;
+
+	MRPT_END
+}
+
+template <class GRAPH_T>
+void CLevMarqGSO<GRAPH_T>::startSnapshotOptimization(bool is_full_update)
+{
+	MRPT_START
+	ASSERT_(!m_thread_optimize.joinable());
+
+	this->m_time_logger.enter("CLevMarqGSO::startSnapshotOptimization");
+	if (!m_graph_snapshot) m_graph_snapshot = std::make_unique<GRAPH_T>();
+	// (assignment reuses the already allocated nodes of the last snapshot)
+	*m_graph_snapshot = *this->m_graph;
+	this->m_time_logger.leave("CLevMarqGSO::startSnapshotOptimization");
+
+	m_snapshot_is_full_update = is_full_update;
+	m_snapshot_optimized_nodes.clear();
+	m_snapshot_optimized = false;
+	m_thread_optimize = std::thread(&CLevMarqGSO::optimizeGraph, this);
+
+	MRPT_END
+}
+
+template <class GRAPH_T>
+bool CLevMarqGSO<GRAPH_T>::mergeOptimizedSnapshot()
+{
+	MRPT_START
+	if (!m_snapshot_optimized) return false;
+	if (m_thread_optimize.joinable()) m_thread_optimize.join();
+	m_snapshot_optimized = false;
+
+	this->m_time_logger.enter("CLevMarqGSO::mergeOptimizedSnapshot");
+	auto& nodes = this->m_graph->nodes;
+	const auto& opt_nodes = m_graph_snapshot->nodes;
+
+	// Nodes added after the snapshot keep their pose relative to the newest
+	// node of the snapshot, which must be computed before updating it:
+	std::map<mrpt::graphs::TNodeID, pose_t> rel_poses;
+	if (!opt_nodes.empty())
+	{
+		const auto anchor = opt_nodes.rbegin()->first;
+		const auto it_anchor = nodes.find(anchor);
+		if (it_anchor != nodes.end() &&
+			m_snapshot_optimized_nodes.count(anchor) != 0)
+		{
+			for (auto it = nodes.upper_bound(anchor); it != nodes.end(); ++it)
+				if (opt_nodes.count(it->first) == 0)
+					rel_poses[it->first] = it->second - it_anchor->second;
+		}
+	}
+
+	for (const auto id : m_snapshot_optimized_nodes)
+	{
+		auto it = nodes.find(id);
+		if (it == nodes.end()) continue;
+		static_cast<pose_t&>(it->second) = opt_nodes.at(id);
+	}
 
-	std::lock_guard<std::mutex> graph_lock(*this->m_graph_section);
-	this->_optimizeGraph();
+	if (!rel_poses.empty())
+	{
+		const pose_t anchor_pose = opt_nodes.rbegin()->second;
+		for (const auto& rel : rel_poses)
+			static_cast<pose_t&>(nodes[rel.first]) = anchor_pose + rel.second;
+	}
 
-	this->logFmt(mrpt::system::LVL_DEBUG, "2nd thread grabbed the lock..");
+	this->logFmt(
+		mrpt::system::LVL_DEBUG,
+		"Merged %u optimized nodes, moved %u nodes added meanwhile",
+		static_cast<unsigned>(m_snapshot_optimized_nodes.size()),
+		static_cast<unsigned>(rel_poses.size()));
+	this->m_time_logger.leave("CLevMarqGSO::mergeOptimizedSnapshot");
+	return true;
 
 	MRPT_END
 }
 
+template <class GRAPH_T>
+void CLevMarqGSO<GRAPH_T>::waitForSnapshotOptimization()
+{
+	if (m_thread_optimize.joinable()) m_thread_optimize.join();
+}
+
 template <class GRAPH_T>
 void CLevMarqGSO<GRAPH_T>::_optimizeGraph(bool is_full_update /*=false*/)
+{
+	this->optimizeGraphInstance(*(this->m_graph), is_full_update);
+	m_just_fully_optimized_graph = is_full_update;
+}
+
+template <class GRAPH_T>
+void CLevMarqGSO<GRAPH_T>::optimizeGraphInstance(
+	GRAPH_T& graph, bool is_full_update,
+	std::set<mrpt::graphs::TNodeID>* optimized_nodes)
 {
 	MRPT_START
 	this->m_time_logger.enter("CLevMarqGSO::_optimizeGraph");
 
 	// if less than X nodes exist overall, do not try optimizing
-	if (m_min_nodes_for_optimization > this->m_graph->nodes.size()) { return; }
+	if (m_min_nodes_for_optimization > graph.nodes.size())
+	{
+		this->m_time_logger.leave("CLevMarqGSO::_optimizeGraph");
+		return;
+	}
 
 	mrpt::system::CTicTac optimization_timer;
 	optimization_timer.Tic();
 
 	// set of nodes for which the optimization procedure will take place
 	std::set<mrpt::graphs::TNodeID>* nodes_to_optimize;
+	const bool use_sliding_window =
+		!is_full_update && opt_params.sliding_window_size > 0;
 
 	// fill in the nodes in certain distance to the current node, only if
 	// is_full_update is not instructed
@@ -405,6 +528,11 @@ void CLevMarqGSO<GRAPH_T>::_optimizeGraph(bool is_full_update /*=false*/)
 		// node.
 		nodes_to_optimize = nullptr;
 	}
+	else if (use_sliding_window)
+	{
+		nodes_to_optimize = new std::set<mrpt::graphs::TNodeID>;
+		this->updateSlidingWindow(graph, nodes_to_optimize);
+	}
 	else
 	{
 		nodes_to_optimize = new std::set<mrpt::graphs::TNodeID>;
@@ -414,23 +542,33 @@ void CLevMarqGSO<GRAPH_T>::_optimizeGraph(bool is_full_update /*=false*/)
 		// optimization procedure starts only after certain number of nodes has
 		// been added
 		this->getNearbyNodesOf(
-			nodes_to_optimize, this->m_graph->nodeCount() - 1,
+			graph, nodes_to_optimize, graph.nodeCount() - 1,
 			opt_params.optimization_distance);
-		nodes_to_optimize->insert(this->m_graph->nodeCount() - 1);
+		nodes_to_optimize->insert(graph.nodeCount() - 1);
+	}
+
+	if (optimized_nodes)
+	{
+		if (nodes_to_optimize) { *optimized_nodes = *nodes_to_optimize; }
+		else
+		{
+			graph.getAllNodes(*optimized_nodes);
+			optimized_nodes->erase(graph.root);
+		}
 	}
 
 	graphslam::TResultInfoSpaLevMarq levmarq_info;
 
 	// Execute the optimization
 	mrpt::graphslam::optimize_graph_spa_levmarq(
-		*(this->m_graph), levmarq_info, nodes_to_optimize, opt_params.cfg,
-		&CLevMarqGSO<GRAPH_T>::levMarqFeedback);  // functor feedback
+		graph, levmarq_info, nodes_to_optimize, opt_params.cfg,
+		&CLevMarqGSO<GRAPH_T>::levMarqFeedback,	 // functor feedback
+		opt_params.reuse_symbolic_factorization ? &m_cholesky_cache : nullptr,
+		use_sliding_window ? &m_marginal_prior : nullptr);
 
-	if (is_full_update) { m_just_fully_optimized_graph = true; }
-	else
-	{
-		m_just_fully_optimized_graph = false;
-	}
+	// All the nodes may have moved: marginalize them again from the new
+	// estimates.
+	if (is_full_update) m_marginal_prior.clear();
 
 	double elapsed_time = optimization_timer.Tac();
 	this->logFmt(
@@ -443,7 +581,34 @@ void CLevMarqGSO<GRAPH_T>::_optimizeGraph(bool is_full_update /*=false*/)
 
 	this->m_time_logger.leave("CLevMarqGSO::_optimizeGraph");
 	MRPT_END
-}  // end of _optimizeGraph
+}  // end of optimizeGraphInstance
+
+template <class GRAPH_T>
+void CLevMarqGSO<GRAPH_T>::updateSlidingWindow(
+	const GRAPH_T& graph, std::set<mrpt::graphs::TNodeID>* window)
+{
+	MRPT_START
+	const auto& nodes = graph.nodes;
+	const auto root = graph.root;
+
+	for (auto it = nodes.rbegin();
+		 it != nodes.rend() && window->size() < opt_params.sliding_window_size;
+		 ++it)
+		if (it->first != root) window->insert(it->first);
+
+	// Marginalize the nodes that left the window since the last call, oldest
+	// first:
+	const auto& marginalized = m_marginal_prior.marginalized_nodes;
+	auto it = marginalized.empty() ? nodes.begin()
+								   : nodes.upper_bound(*marginalized.rbegin());
+	for (; it != nodes.end() && window->count(it->first) == 0; ++it)
+	{
+		if (it->first == root) continue;
+		mrpt::graphslam::marginalize_graph_nodes(
+			graph, {it->first}, m_marginal_prior);
+	}
+	MRPT_END
+}
 
 template <class GRAPH_T>
 bool CLevMarqGSO<GRAPH_T>::checkForLoopClosures()
@@ -578,25 +743,27 @@ void CLevMarqGSO<GRAPH_T>::levMarqFeedback(
 
 template <class GRAPH_T>
 void CLevMarqGSO<GRAPH_T>::getNearbyNodesOf(
-	std::set<mrpt::graphs::TNodeID>* nodes_set,
+	const GRAPH_T& graph, std::set<mrpt::graphs::TNodeID>* nodes_set,
 	const mrpt::graphs::TNodeID& cur_nodeID, double distance)
 {
 	MRPT_START
 
 	if (distance > 0)
 	{
+		const auto& cur_pose = graph.nodes.at(cur_nodeID);
 		// check all but the last node.
-		for (mrpt::graphs::TNodeID nodeID = 0;
-			 nodeID < this->m_graph->nodeCount() - 1; ++nodeID)
+		for (mrpt::graphs::TNodeID nodeID = 0; nodeID < graph.nodeCount() - 1;
+			 ++nodeID)
 		{
-			double curr_distance = this->m_graph->nodes[nodeID].distanceTo(
-				this->m_graph->nodes[cur_nodeID]);
+			const auto it = graph.nodes.find(nodeID);
+			if (it == graph.nodes.end()) continue;
+			double curr_distance = it->second.distanceTo(cur_pose);
 			if (curr_distance <= distance) { nodes_set->insert(nodeID); }
 		}
 	}
 	else
 	{  // check against all nodes
-		this->m_graph->getAllNodes(*nodes_set);
+		graph.getAllNodes(*nodes_set);
 	}
 
 	MRPT_END
@@ -694,6 +861,9 @@ void CLevMarqGSO<GRAPH_T>::OptimizationParams::dumpToTextStream(
 		<< (optimization_on_second_thread ? "TRUE" : "FALSE") << std::endl;
 	out << "Optimize nodes in distance     = " << optimization_distance << "\n";
 	out << "Min. node difference for LC    = " << LC_min_nodeid_diff << "\n";
+	out << "Reuse symbolic factorization   = "
+		<< (reuse_symbolic_factorization ? "TRUE" : "FALSE") << "\n";
+	out << "Sliding window size            = " << sliding_window_size << "\n";
 	// out << cfg.getAsString() << std::endl;
 	MRPT_END
 }
@@ -708,6 +878,10 @@ void CLevMarqGSO<GRAPH_T>::OptimizationParams::loadFromConfigFile(
 		"GeneralConfiguration", "LC_min_nodeid_diff", 30, false);
 	optimization_distance =
 		source.read_double(section, "optimization_distance", 5, false);
+	reuse_symbolic_factorization = source.read_bool(
+		section, "reuse_symbolic_factorization", true, false);
+	sliding_window_size = static_cast<size_t>(
+		source.read_uint64_t(section, "sliding_window_size", 0, false));
 	// asert the previous value
 	ASSERTDEBMSG_(
 		optimization_distance == 1 || optimization_distance > 0,
@@ -14,6 +14,7 @@
 #include <mrpt/graphslam/ERD/CEmptyERD.h>
 #include <mrpt/graphslam/ERD/CICPCriteriaERD.h>
 #include <mrpt/graphslam/ERD/CLoopCloserERD.h>
+#include <mrpt/graphslam/GSO/CIncrementalSmoothingGSO.h>
 #include <mrpt/graphslam/GSO/CLevMarqGSO.h>
 #include <mrpt/graphslam/NRD/CEmptyNRD.h>
 #include <mrpt/graphslam/NRD/CFixedIntervalsNRD.h>
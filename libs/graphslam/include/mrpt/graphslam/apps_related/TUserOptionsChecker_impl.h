@@ -58,6 +58,8 @@ void TUserOptionsChecker<GRAPH_t>::createDeciderOptimizerMappings()
 		&createGraphSlamOptimizer<CLevMarqGSO<GRAPH_t>>;
 	optimizers_map["CEmptyGSO"] =
 		&createGraphSlamOptimizer<CLevMarqGSO<GRAPH_t>>;
+	optimizers_map["CIncrementalSmoothingGSO"] =
+		&createGraphSlamOptimizer<CIncrementalSmoothingGSO<GRAPH_t>>;
 
 	// create the decider optimizer, specific to the GRAPH_T template type
 	this->_createDeciderOptimizerMappings();
@@ -417,6 +419,20 @@ void TUserOptionsChecker<GRAPH_t>::populateDeciderOptimizerProperties()
 		optimizers_descriptions.push_back(opt);
 	}
 
+	{  // CIncrementalSmoothingGSO
+		auto* opt = new TOptimizerProps;
+		opt->name = "CIncrementalSmoothingGSO";
+		opt->description =
+			"Incremental (iSAM-like) graphSLAM solver - Updates only the part "
+			"of the square-root information matrix affected by new nodes and "
+			"edges";
+		opt->is_mr_slam_class = true;
+		opt->is_slam_2d = true;
+		opt->is_slam_3d = true;
+
+		optimizers_descriptions.push_back(opt);
+	}
+
 	MRPT_END
 }
 }  // namespace mrpt::graphslam::apps
@@ -8,7 +8,6 @@
    +------------------------------------------------------------------------+ */
 #pragma once
 
-#include <mrpt/containers/stl_containers_utils.h>  // find_in_vector()
 #include <mrpt/containers/yaml.h>
 #include <mrpt/graphslam/types.h>
 #include <mrpt/math/CSparseMatrix.h>
@@ -16,11 +15,111 @@
 // (Must come *after* "types.h" above)
 #include <mrpt/graphslam/levmarq_impl.h>  // Aux classes
 
+#include <algorithm>
+#include <array>
 #include <map>
 #include <memory>
+#include <set>
+#include <vector>
 
 namespace mrpt::graphslam
 {
+/** Sparse Cholesky factorization kept between calls to
+ * optimize_graph_spa_levmarq(), so the fill-in reducing (AMD) ordering and
+ * the symbolic analysis of the Hessian are only recomputed when its sparsity
+ * pattern changes (i.e. when nodes or edges are added or removed).
+ * Iterations that only change numeric values just refactorize numerically.
+ *
+ * \note (New in MRPT 2.4.9)
+ * \ingroup mrpt_graphslam_grp
+ */
+struct TSparseCholeskyCache
+{
+	std::unique_ptr<mrpt::math::CSparseMatrix::CholeskyDecomp> chol;
+
+	/** Statistics: number of full (symbolic+numeric) and numeric-only
+	 * factorizations done so far. */
+	size_t num_symbolic_factorizations = 0, num_numeric_factorizations = 0;
+
+	/** Factorizes `H`, reusing the symbolic analysis if possible. */
+	void factorize(const mrpt::math::CSparseMatrix& H)
+	{
+		if (chol && chol->hasSameSparsityPattern(H))
+		{
+			num_numeric_factorizations++;
+			chol->update(H);
+		}
+		else
+		{
+			chol.reset();
+			num_symbolic_factorizations++;
+			chol = std::make_unique<mrpt::math::CSparseMatrix::CholeskyDecomp>(
+				H);
+		}
+	}
+
+	void clear() { chol.reset(); }
+};
+
+/** Dense prior factor on the boundary nodes of a sliding window, resulting
+ * from marginalizing out older nodes with marginalize_graph_nodes(). Passed
+ * to optimize_graph_spa_levmarq(), it replaces all the edges of the
+ * marginalized nodes, so the window is optimized as if those nodes were still
+ * free variables, instead of just holding them fixed.
+ *
+ * If \f$ \delta \f$ stacks the increments \f$ \log(x_{0,i}^{-1} x_i) \f$ of
+ * the poses of #nodes from their #linearization_points, the prior adds
+ * \f$ \delta^\top H \delta + 2 b^\top \delta \f$ to the cost.
+ *
+ * \note (New in MRPT 2.4.9)
+ * \ingroup mrpt_graphslam_grp
+ */
+template <class GRAPH_T>
+struct TMarginalizationPrior
+{
+	using pose_t = typename GRAPH_T::constraint_t::type_value;
+
+	/** The nodes affected by the prior, and their poses when it was computed
+	 */
+	std::vector<mrpt::graphs::TNodeID> nodes;
+	std::vector<pose_t> linearization_points;
+	/** Information matrix and gradient of the prior, blocks in the order of
+	 * #nodes */
+	mrpt::math::CMatrixDouble H;
+	mrpt::math::CVectorDouble b;
+
+	/** Nodes marginalized out so far */
+	std::set<mrpt::graphs::TNodeID> marginalized_nodes;
+	/** Pairs of nodes whose edges are already accounted for in the prior.
+	 * Edges between these nodes are ignored by optimize_graph_spa_levmarq()
+	 */
+	std::set<mrpt::graphs::TPairNodeIDs> marginalized_edges;
+
+	bool empty() const { return marginalized_nodes.empty(); }
+	void clear() { *this = TMarginalizationPrior(); }
+
+	/** Computes the stacked increments \f$ \delta \f$ of the current poses
+	 * in `graph`, and returns the cost of the prior */
+	double evaluate(
+		const GRAPH_T& graph, mrpt::math::CVectorDouble& delta) const
+	{
+		using SE_TYPE = typename graphslam_traits<GRAPH_T>::SE_TYPE;
+		constexpr auto DIMS_POSE = SE_TYPE::DOFs;
+
+		delta.resize(nodes.size() * DIMS_POSE);
+		for (size_t k = 0; k < nodes.size(); k++)
+		{
+			const pose_t& P = graph.nodes.find(nodes[k])->second;
+			const auto d = SE_TYPE::log(P - linearization_points[k]);
+			for (size_t i = 0; i < DIMS_POSE; i++)
+				delta[k * DIMS_POSE + i] = d[i];
+		}
+		if (nodes.empty()) return 0;
+		return delta.asEigen().dot(H.asEigen() * delta.asEigen()) +
+			2 * b.asEigen().dot(delta.asEigen());
+	}
+};
+
 /** Optimize a graph of pose constraints using the Sparse Pose Adjustment (SPA)
  *sparse representation and a Levenberg-Marquardt optimizer.
  *  This method works for all types of graphs derived from \a CNetworkOfPoses
@@ -47,6 +146,15 @@ namespace mrpt::graphslam
  * \param[in] functor_feedback Optional: a pointer to a user function can be
  *set here to be called on each LM loop iteration (eg to refresh the current
  *state and error, refresh a GUI, etc.)
+ * \param[in,out] cholesky_cache Optional: if provided, the sparse Cholesky
+ *symbolic factorization is kept there and reused across calls while the
+ *structure of the problem does not change (e.g. in incremental optimization).
+ *Otherwise, it is only reused between iterations of this call.
+ * \param[in] marginal_prior Optional: a prior on the boundary of the nodes to
+ *optimize, from marginalizing out the nodes outside of them with
+ *marginalize_graph_nodes() (sliding-window optimization). The edges already
+ *marginalized into it are ignored. Without it, the nodes that are not
+ *optimized are just held fixed.
  *
  * List of optional parameters by name in "extra_params":
  *		- "verbose": (default=0) If !=0, produce verbose ouput.
@@ -61,6 +169,9 @@ namespace mrpt::graphslam
  *		- "e2": (default=1e-6) Lev-marq algorithm iteration stopping criterion
  *#2:
  *|delta_incr| < e2*(x_norm+e2)
+ *		- "num_threads": (default=0) Number of threads to evaluate the errors,
+ *Jacobians, gradient and Hessian of the edges in parallel. 0 means a thread
+ *per core, but only for large graphs (thousands of edges per thread).
  *
  * \note The following graph types are supported:
  *mrpt::graphs::CNetworkOfPoses2D, mrpt::graphs::CNetworkOfPoses3D,
@@ -82,7 +193,9 @@ void optimize_graph_spa_levmarq(
 	GRAPH_T& graph, TResultInfoSpaLevMarq& out_info,
 	const std::set<mrpt::graphs::TNodeID>* in_nodes_to_optimize = nullptr,
 	const mrpt::containers::yaml& extra_params = {},
-	FEEDBACK_CALLABLE functor_feedback = FEEDBACK_CALLABLE())
+	FEEDBACK_CALLABLE functor_feedback = FEEDBACK_CALLABLE(),
+	TSparseCholeskyCache* cholesky_cache = nullptr,
+	const TMarginalizationPrior<GRAPH_T>* marginal_prior = nullptr)
 {
 	using namespace mrpt;
 	using namespace mrpt::poses;
@@ -169,6 +282,8 @@ void optimize_graph_spa_levmarq(
 		if (nodes_to_optimize->find(ids.first) == nodes_to_optimize->end() &&
 			nodes_to_optimize->find(ids.second) == nodes_to_optimize->end())
 			continue;  // Skip this edge, none of the IDs are free variables.
+		if (marginal_prior && marginal_prior->marginalized_edges.count(ids))
+			continue;  // Already in the prior
 
 		// get the current global poses of both nodes in this constraint:
 		auto itP1 = graph.nodes.find(ids.first);
@@ -191,18 +306,27 @@ void optimize_graph_spa_levmarq(
 	// The number of constraints, or observations actually implied in this
 	// problem:
 	const size_t nObservations = lstObservationData.size();
-	ASSERTDEB_GT_(nObservations, 0);
-	// Cholesky object, as a pointer to reuse it between iterations:
-
-	using SparseCholeskyDecompPtr =
-		std::unique_ptr<CSparseMatrix::CholeskyDecomp>;
-	SparseCholeskyDecompPtr ptrCh;
+	ASSERTDEB_(
+		nObservations > 0 || (marginal_prior && !marginal_prior->empty()));
+	// Cholesky object, to reuse it between iterations (and maybe calls):
+	TSparseCholeskyCache localCholCache;
+	TSparseCholeskyCache& cholCache =
+		cholesky_cache ? *cholesky_cache : localCholCache;
+
+	// Threads to evaluate the edges, each one in charge of a contiguous range
+	// of them, and accumulating its own part of the gradient and Hessian:
+	const size_t nThreads = detail::levmarqNumThreads(
+		extra_params.getOrDefault<size_t>("num_threads", 0), nObservations);
+	std::unique_ptr<mrpt::WorkerThreadsPool> pool;
+	if (nThreads > 1)
+		pool = std::make_unique<mrpt::WorkerThreadsPool>(
+			nThreads - 1, mrpt::WorkerThreadsPool::POLICY_FIFO, "graphslam_lm");
 
 	// The list of Jacobians: for each constraint i->j,
 	//  we need the pair of Jacobians: { dh(xi,xj)_dxi, dh(xi,xj)_dxj },
 	//  which are "first" and "second" in each pair.
-	// Index of the map are the node IDs {i,j} for each contraint.
-	typename gst::map_pairIDs_pairJacobs_t lstJacobians;
+	// In the same order than lstObservationData.
+	std::vector<typename gst::TPairJacobs> lstJacobians;
 	// The vector of errors: err_k = SE(2/3)::pseudo_Ln( P_i * EDGE_ij *
 	// inv(P_j) )
 	// Separated vectors for each edge. i \in [0,nObservations-1], in
@@ -214,32 +338,161 @@ void optimize_graph_spa_levmarq(
 	// ===================================
 	profiler.enter("optimize_graph_spa_levmarq.Jacobians&err");
 	double total_sqr_err = computeJacobiansAndErrors<GRAPH_T>(
-		graph, lstObservationData, lstJacobians, errs);
+		graph, lstObservationData, lstJacobians, errs, pool.get(), nThreads);
 	profiler.leave("optimize_graph_spa_levmarq.Jacobians&err");
 
-	// Only once (since this will be static along iterations), build a quick
-	// look-up table with the
-	//  indices of the free nodes associated to the (first_id,second_id) of each
-	//  Jacobian pair:
+	// Only once (since this will be static along iterations), build a flat,
+	// index-based, representation of the problem:
+	// - The poses of the free nodes, by their index in [0,nFreeNodes-1].
+	// - The indices of the free nodes of each observation ("-1" if that node
+	// is fixed, as defined by "nodes_to_optimize").
+	// - The list of nonzero blocks of the upper triangular part of the
+	// Hessian, by (column,row) free node indices, and the blocks each
+	// observation contributes to.
 	// ------------------------------------------------------------------------
+	profiler.enter("optimize_graph_spa_levmarq.structure");
+	std::map<TNodeID, size_t> freeNodeIndex;
+	std::vector<typename GRAPH_T::global_pose_t*> freeNodePoses;
+	freeNodePoses.reserve(nFreeNodes);
+	for (const TNodeID id : *nodes_to_optimize)
+	{
+		auto itP = graph.nodes.find(id);
+		ASSERTMSG_(itP != graph.nodes.end(), "Free node has no global pose");
+		freeNodeIndex.emplace_hint(
+			freeNodeIndex.end(), id, freeNodePoses.size());
+		freeNodePoses.push_back(&itP->second);
+	}
+	const auto freeIndexOf = [&](TNodeID id) {
+		const auto it = freeNodeIndex.find(id);
+		return it == freeNodeIndex.end() ? string::npos : it->second;
+	};
+
 	vector<pair<size_t, size_t>> obsIdx2fnIdx;
-	// "relatedFreeNodeIndex" is in [0,nFreeNodes-1], or "-1" if that node
-	// is fixed, as defined by "nodes_to_optimize"
 	obsIdx2fnIdx.reserve(nObservations);
-	ASSERTDEB_(lstJacobians.size() == nObservations);
-	for (auto itJ = lstJacobians.begin(); itJ != lstJacobians.end(); ++itJ)
-	{
-		const TNodeID id1 = itJ->first.first;
-		const TNodeID id2 = itJ->first.second;
+	for (const auto& obs : lstObservationData)
 		obsIdx2fnIdx.emplace_back(
-			mrpt::containers::find_in_vector(id1, *nodes_to_optimize),
-			mrpt::containers::find_in_vector(id2, *nodes_to_optimize));
+			freeIndexOf(obs.edge->first.first),
+			freeIndexOf(obs.edge->first.second));
+
+	// The same, for the nodes of the marginalization prior, if any:
+	const bool use_prior = marginal_prior && !marginal_prior->nodes.empty();
+	vector<size_t> priorIdx2fnIdx;
+	CVectorDouble prior_delta;
+	double prior_err = 0;
+	if (use_prior)
+	{
+		for (const TNodeID id : marginal_prior->nodes)
+			priorIdx2fnIdx.push_back(freeIndexOf(id));
+		prior_err = marginal_prior->evaluate(graph, prior_delta);
+	}
+
+	// Nonzero blocks, sorted by (column,row) as the sparse H is built.
+	// Blocks of each observation: {(i,i), (j,j), (i,j) or (j,i)}:
+	const auto blockKey = [](size_t a, size_t b) {
+		return std::make_pair(std::max(a, b), std::min(a, b));
+	};
+	std::map<pair<size_t, size_t>, size_t> blockIndex;
+	for (const auto& idx : obsIdx2fnIdx)
+	{
+		if (idx.first != string::npos) blockIndex[{idx.first, idx.first}];
+		if (idx.second != string::npos) blockIndex[{idx.second, idx.second}];
+		if (idx.first != string::npos && idx.second != string::npos)
+			blockIndex[blockKey(idx.first, idx.second)];
 	}
+	for (const size_t idx_k : priorIdx2fnIdx)
+		for (const size_t idx_l : priorIdx2fnIdx)
+			if (idx_k != string::npos && idx_l != string::npos)
+				blockIndex[blockKey(idx_k, idx_l)];
+
+	vector<pair<size_t, size_t>> blockColRow;
+	blockColRow.reserve(blockIndex.size());
+	for (auto& b : blockIndex)
+	{
+		b.second = blockColRow.size();
+		blockColRow.push_back(b.first);
+	}
+	const size_t nBlocks = blockColRow.size();
+
+	vector<std::array<size_t, 3>> obsIdx2blocks;
+	obsIdx2blocks.reserve(nObservations);
+	for (const auto& idx : obsIdx2fnIdx)
+	{
+		std::array<size_t, 3> blk{string::npos, string::npos, string::npos};
+		if (idx.first != string::npos)
+			blk[0] = blockIndex[{idx.first, idx.first}];
+		if (idx.second != string::npos)
+			blk[1] = blockIndex[{idx.second, idx.second}];
+		if (idx.first != string::npos && idx.second != string::npos)
+			blk[2] = blockIndex[blockKey(idx.first, idx.second)];
+		obsIdx2blocks.push_back(blk);
+	}
+	profiler.leave("optimize_graph_spa_levmarq.structure");
+
+	// Accumulates the gradient and the Hessian blocks of the observations in
+	// [first,last):
+	using matrix_TxT = typename gst::matrix_TxT;
+	using aux_t = detail::AuxErrorEval<typename gst::edge_t, gst>;
+	const auto accumulateObservations = [&](size_t first, size_t last,
+											CVectorDouble& g,
+											vector<matrix_TxT>& H_blocks) {
+		for (size_t idx_obs = first; idx_obs < last; idx_obs++)
+		{
+			//  grad[k] += J^t_{i->k} * Inf.Matrix * errs_i
+			//    k: [0,nFreeNodes-1]     <-- IDs.first & IDs.second
+			//    i: [0,nObservations-1]  <--- idx_obs
+			const auto* edge = lstObservationData[idx_obs].edge;
+			const matrix_TxT& J1 = lstJacobians[idx_obs].first;
+			const matrix_TxT& J2 = lstJacobians[idx_obs].second;
+			const size_t idx1 = obsIdx2fnIdx[idx_obs].first;
+			const size_t idx2 = obsIdx2fnIdx[idx_obs].second;
+			const auto& blk = obsIdx2blocks[idx_obs];
+
+			matrix_TxT JtJ(mrpt::math::UNINITIALIZED_MATRIX);
+			// Is "i" a free (to be optimized) node? -> Ji^t * Inf *  Ji
+			if (idx1 != string::npos)
+			{
+				typename gst::Array_O grad_idx1;
+				grad_idx1.setZero();
+				aux_t::multiply_Jt_W_err(J1, edge, errs[idx_obs], grad_idx1);
+				for (unsigned int i = 0; i < DIMS_POSE; i++)
+					g[DIMS_POSE * idx1 + i] += grad_idx1[i];
+
+				aux_t::multiplyJtLambdaJ(J1, JtJ, edge);
+				H_blocks[blk[0]] += JtJ;
+			}
+			// Is "j" a free (to be optimized) node? -> Jj^t * Inf *  Jj
+			if (idx2 != string::npos)
+			{
+				typename gst::Array_O grad_idx2;
+				grad_idx2.setZero();
+				aux_t::multiply_Jt_W_err(J2, edge, errs[idx_obs], grad_idx2);
+				for (unsigned int i = 0; i < DIMS_POSE; i++)
+					g[DIMS_POSE * idx2 + i] += grad_idx2[i];
+
+				aux_t::multiplyJtLambdaJ(J2, JtJ, edge);
+				H_blocks[blk[1]] += JtJ;
+			}
+			// Are both "i" and "j" free nodes? -> Ji^t * Inf *  Jj
+			if (idx1 != string::npos && idx2 != string::npos)
+			{
+				aux_t::multiplyJ1tLambdaJ2(J1, J2, JtJ, edge);
+				// Only the upper triangular part of the Hessian is built:
+				if (idx1 < idx2) H_blocks[blk[2]] += JtJ;
+				else
+					H_blocks[blk[2]].sum_At(JtJ);
+			}
+		}
+	};
 
 	// other important vars for the main loop:
 	CVectorDouble grad(nFreeNodes * DIMS_POSE);
 	grad.setZero();
-	using map_ID2matrix_TxT_t = std::map<TNodeID, typename gst::matrix_TxT>;
+	vector<matrix_TxT> H_blocks(nBlocks);
+	// Per-thread accumulators:
+	vector<CVectorDouble> thread_grad(pool ? nThreads : 0);
+	vector<vector<matrix_TxT>> thread_H_blocks(pool ? nThreads : 0);
+	// Backup of the free node poses, to revert rejected steps:
+	vector<typename GRAPH_T::global_pose_t> old_poses_backup(nFreeNodes);
 
 	double lambda = initial_lambda;	 // Will be actually set on first iteration.
 	double v = 1;  // was 2, changed since it's modified in the first pass.
@@ -254,7 +507,6 @@ void optimize_graph_spa_levmarq(
 
 	for (size_t iter = 0; iter < max_iters; ++iter)
 	{
-		vector<map_ID2matrix_TxT_t> H_map(nFreeNodes);
 		last_iter = iter;
 
 		// This will be false only when the delta leads to a worst solution and
@@ -263,68 +515,82 @@ void optimize_graph_spa_levmarq(
 		{
 			have_to_recompute_H_and_grad = false;
 			// ======================================================================
-			// Compute the gradient: grad = J^t * errs
+			// Compute the gradient: grad = J^t * errs, and the nonzero blocks
+			// of the upper triangular part of the Hessian: H = J^t * J
 			// ======================================================================
 			//  "grad" can be seen as composed of N independent arrays, each one
 			//  being:
 			//   grad_i = \sum_k J^t_{k->i} errs_k
 			// that is: g_i is the "dot-product" of the i'th (transposed)
 			// block-column of J and the vector of errors "errs"
-			profiler.enter("optimize_graph_spa_levmarq.grad");
+			profiler.enter("optimize_graph_spa_levmarq.grad&H");
 
 			grad.setZero();
+			for (auto& b : H_blocks)
+				b.setZero();
 
-			// "lstJacobians" is sorted in the same order than
-			// "lstObservationData":
-			ASSERTDEB_EQUAL_(lstJacobians.size(), lstObservationData.size());
+			if (!pool) accumulateObservations(0, nObservations, grad, H_blocks);
+			else
 			{
-				size_t idx_obs;
-				typename gst::map_pairIDs_pairJacobs_t::const_iterator itJ;
+				const size_t chunk = (nObservations + nThreads - 1) / nThreads;
+				pool->parallel_for(0, nThreads, 1, [&](size_t t) {
+					thread_grad[t].resize(grad.size());
+					thread_grad[t].setZero();
+					thread_H_blocks[t].assign(nBlocks, matrix_TxT());
+					accumulateObservations(
+						t * chunk, std::min(nObservations, (t + 1) * chunk),
+						thread_grad[t], thread_H_blocks[t]);
+				});
+				// Reduce, always in the same order, by ranges of blocks:
+				const size_t blk_chunk = (nBlocks + nThreads - 1) / nThreads;
+				const size_t grad_chunk =
+					(size_t(grad.size()) + nThreads - 1) / nThreads;
+				pool->parallel_for(0, nThreads, 1, [&](size_t t) {
+					const size_t b1 = std::min(nBlocks, (t + 1) * blk_chunk);
+					for (size_t b = t * blk_chunk; b < b1; b++)
+						for (const auto& Ht : thread_H_blocks)
+							H_blocks[b] += Ht[b];
+					const size_t g1 =
+						std::min(size_t(grad.size()), (t + 1) * grad_chunk);
+					for (size_t i = t * grad_chunk; i < g1; i++)
+						for (const auto& gt : thread_grad)
+							grad[i] += gt[i];
+				});
+			}
 
-				for (idx_obs = 0, itJ = lstJacobians.begin();
-					 itJ != lstJacobians.end(); ++itJ, ++idx_obs)
+			// The prior: its gradient is H*delta+b, and its dense Hessian
+			// blocks between its free nodes:
+			if (use_prior)
+			{
+				const Eigen::VectorXd prior_grad =
+					marginal_prior->H.asEigen() * prior_delta.asEigen() +
+					marginal_prior->b.asEigen();
+				for (size_t k = 0; k < priorIdx2fnIdx.size(); k++)
 				{
-					// make sure they're in the expected order!
-					ASSERTDEB_(
-						itJ->first == lstObservationData[idx_obs].edge->first);
-
-					//  grad[k] += J^t_{i->k} * Inf.Matrix * errs_i
-					//    k: [0,nFreeNodes-1]     <-- IDs.first & IDs.second
-					//    i: [0,nObservations-1]  <--- idx_obs
+					const size_t idx_k = priorIdx2fnIdx[k];
+					if (idx_k == string::npos) continue;
+					for (unsigned int i = 0; i < DIMS_POSE; i++)
+						grad[DIMS_POSE * idx_k + i] +=
+							prior_grad[DIMS_POSE * k + i];
 
-					// Get the corresponding indices in the vector of "free
-					// variables" being optimized:
-					const size_t idx1 = obsIdx2fnIdx[idx_obs].first;
-					const size_t idx2 = obsIdx2fnIdx[idx_obs].second;
-
-					if (idx1 != string::npos)
+					for (size_t l = k; l < priorIdx2fnIdx.size(); l++)
 					{
-						typename gst::Array_O grad_idx1;
-						detail::AuxErrorEval<typename gst::edge_t, gst>::
-							multiply_Jt_W_err(
-								itJ->second.first /* J */,
-								lstObservationData[idx_obs].edge /* W */,
-								errs[idx_obs] /* err */, grad_idx1 /* out */
-							);
-						for (unsigned int i = 0; i < DIMS_POSE; i++)
-							grad[DIMS_POSE * idx1 + i] += grad_idx1[i];
-					}
-
-					if (idx2 != string::npos)
-					{
-						typename gst::Array_O grad_idx2;
-						detail::AuxErrorEval<typename gst::edge_t, gst>::
-							multiply_Jt_W_err(
-								itJ->second.second /* J */,
-								lstObservationData[idx_obs].edge /* W */,
-								errs[idx_obs] /* err */, grad_idx2 /* out */
-							);
-						for (unsigned int i = 0; i < DIMS_POSE; i++)
-							grad[DIMS_POSE * idx2 + i] += grad_idx2[i];
+						const size_t idx_l = priorIdx2fnIdx[l];
+						if (idx_l == string::npos) continue;
+						matrix_TxT Hkl;
+						Hkl.asEigen() =
+							marginal_prior->H.asEigen()
+								.template block<DIMS_POSE, DIMS_POSE>(
+									k * DIMS_POSE, l * DIMS_POSE);
+						auto& H_kl =
+							H_blocks[blockIndex.at(blockKey(idx_k, idx_l))];
+						if (idx_k <= idx_l) H_kl += Hkl;
+						else
+							H_kl.sum_At(Hkl);
 					}
 				}
 			}
-			profiler.leave("optimize_graph_spa_levmarq.grad");
+			profiler.leave("optimize_graph_spa_levmarq.grad&H");
 
 			// End condition #1
 			const double grad_norm_inf = math::norm_inf(
@@ -341,83 +607,6 @@ void optimize_graph_spa_levmarq(
 				break;
 			}
 
-			profiler.enter("optimize_graph_spa_levmarq.sp_H:build map");
-			// ======================================================================
-			// Build sparse representation of the upper triangular part of
-			//  the Hessian matrix H = J^t * J
-			//
-			// Sparse memory structure is a vector of maps, such as:
-			//  - H_map[i]: corresponds to the i'th column of H.
-			//              Here "i" corresponds to [0,N-1] indices of
-			//              appearance in the map "*nodes_to_optimize".
-			//  - H_map[i][j] is the entry for the j'th row, with "j" also in
-			//  the range [0,N-1] as ordered in "*nodes_to_optimize".
-			// ======================================================================
-			{
-				size_t idxObs;
-				typename gst::map_pairIDs_pairJacobs_t::const_iterator
-					itJacobPair;
-
-				for (idxObs = 0, itJacobPair = lstJacobians.begin();
-					 idxObs < nObservations; ++itJacobPair, ++idxObs)
-				{
-					const bool Hij_upper_triang =
-						itJacobPair->first.first < itJacobPair->first.second;
-
-					// Indices in the "H_map" vector:
-					const size_t idx_i = obsIdx2fnIdx[idxObs].first;
-					const size_t idx_j = obsIdx2fnIdx[idxObs].second;
-
-					const bool is_i_free_node = idx_i != string::npos;
-					const bool is_j_free_node = idx_j != string::npos;
-
-					// Take references to both Jacobians (wrt pose "i" and pose
-					// "j"), taking into account the possible
-					// switch in their order:
-					const typename gst::matrix_TxT& J1 =
-						itJacobPair->second.first;
-					const typename gst::matrix_TxT& J2 =
-						itJacobPair->second.second;
-
-					// Is "i" a free (to be optimized) node? -> Ji^t * Inf *  Ji
-					if (is_i_free_node)
-					{
-						typename gst::matrix_TxT JtJ(
-							mrpt::math::UNINITIALIZED_MATRIX);
-						detail::AuxErrorEval<typename gst::edge_t, gst>::
-							multiplyJtLambdaJ(
-								J1, JtJ, lstObservationData[idxObs].edge);
-						H_map[idx_i][idx_i] += JtJ;
-					}
-					// Is "j" a free (to be optimized) node? -> Jj^t * Inf *  Jj
-					if (is_j_free_node)
-					{
-						typename gst::matrix_TxT JtJ(
-							mrpt::math::UNINITIALIZED_MATRIX);
-						detail::AuxErrorEval<typename gst::edge_t, gst>::
-							multiplyJtLambdaJ(
-								J2, JtJ, lstObservationData[idxObs].edge);
-						H_map[idx_j][idx_j] += JtJ;
-					}
-					// Are both "i" and "j" free nodes? -> Ji^t * Inf *  Jj
-					if (is_i_free_node && is_j_free_node)
-					{
-						typename gst::matrix_TxT JtJ(
-							mrpt::math::UNINITIALIZED_MATRIX);
-						detail::AuxErrorEval<typename gst::edge_t, gst>::
-							multiplyJ1tLambdaJ2(
-								J1, J2, JtJ, lstObservationData[idxObs].edge);
-						// We sort IDs such as "i" < "j" and we can build just
-						// the upper triangular part of the Hessian:
-						if (Hij_upper_triang)  // H_map[col][row]
-							H_map[idx_j][idx_i] += JtJ;
-						else
-							H_map[idx_i][idx_j].sum_At(JtJ);
-					}
-				}
-			}
-			profiler.leave("optimize_graph_spa_levmarq.sp_H:build map");
-
 			// Just in the first iteration, we need to calculate an estimate for
 			// the first value of "lamdba":
 			if (lambda <= 0 && iter == 0)
@@ -425,18 +614,13 @@ void optimize_graph_spa_levmarq(
 				profiler.enter(
 					"optimize_graph_spa_levmarq.lambda_init");	// ---\  .
 				double H_diagonal_max = 0;
-				for (size_t i = 0; i < nFreeNodes; i++)
-					for (auto it = H_map[i].begin(); it != H_map[i].end(); ++it)
-					{
-						const size_t j =
-							it->first;	// entry submatrix is for (i,j).
-						if (i == j)
-						{
-							for (size_t k = 0; k < DIMS_POSE; k++)
-								mrpt::keep_max(
-									H_diagonal_max, it->second(k, k));
-						}
-					}
+				for (size_t b = 0; b < nBlocks; b++)
+				{
+					// entry submatrix is for (i,j).
+					if (blockColRow[b].first != blockColRow[b].second) continue;
+					for (size_t k = 0; k < DIMS_POSE; k++)
+						mrpt::keep_max(H_diagonal_max, H_blocks[b](k, k));
+				}
 				lambda = tau * H_diagonal_max;
 
 				profiler.leave(
@@ -467,41 +651,37 @@ void optimize_graph_spa_levmarq(
 		// Note: we only need to fill out the upper diagonal part, since
 		// Cholesky will later on ignore the other part.
 		CSparseMatrix sp_H(nFreeNodes * DIMS_POSE, nFreeNodes * DIMS_POSE);
-		for (size_t i = 0; i < nFreeNodes; i++)
+		for (size_t b = 0; b < nBlocks; b++)
 		{
-			const size_t i_offset = i * DIMS_POSE;
-
-			for (auto it = H_map[i].begin(); it != H_map[i].end(); ++it)
+			// entry submatrix is for (row j, column i).
+			const size_t i_offset = blockColRow[b].first * DIMS_POSE;
+			const size_t j_offset = blockColRow[b].second * DIMS_POSE;
+			const matrix_TxT& Hij = H_blocks[b];
+
+			// For i==j (diagonal blocks), it's different, since we only
+			// need to insert their
+			// upper-diagonal half and also we have to add the lambda*I to
+			// the diagonal from the Lev-Marq. algorithm:
+			if (i_offset == j_offset)
 			{
-				const size_t j = it->first;	 // entry submatrix is for (i,j).
-				const size_t j_offset = j * DIMS_POSE;
-
-				// For i==j (diagonal blocks), it's different, since we only
-				// need to insert their
-				// upper-diagonal half and also we have to add the lambda*I to
-				// the diagonal from the Lev-Marq. algorithm:
-				if (i == j)
+				for (size_t r = 0; r < DIMS_POSE; r++)
 				{
-					for (size_t r = 0; r < DIMS_POSE; r++)
+					// c=r: add lambda from LM
+					sp_H.insert_entry_fast(
+						j_offset + r, i_offset + r, Hij(r, r) + lambda);
+					// c>r:
+					for (size_t c = r + 1; c < DIMS_POSE; c++)
 					{
-						// c=r: add lambda from LM
 						sp_H.insert_entry_fast(
-							j_offset + r, i_offset + r,
-							it->second(r, r) + lambda);
-						// c>r:
-						for (size_t c = r + 1; c < DIMS_POSE; c++)
-						{
-							sp_H.insert_entry_fast(
-								j_offset + r, i_offset + c, it->second(r, c));
-						}
+							j_offset + r, i_offset + c, Hij(r, c));
 					}
 				}
-				else
-				{
-					sp_H.insert_submatrix(j_offset, i_offset, it->second);
-				}
 			}
-		}  // end for each free node, build sp_H
+			else
+			{
+				sp_H.insert_submatrix(j_offset, i_offset, Hij);
+			}
+		}  // end for each block, build sp_H
 
 		sp_H.compressFromTriplet();
 		profiler.leave("optimize_graph_spa_levmarq.sp_H:build");
@@ -515,14 +695,11 @@ void optimize_graph_spa_levmarq(
 		try
 		{
 			profiler.enter("optimize_graph_spa_levmarq.sp_H:chol");
-			if (!ptrCh.get())
-				ptrCh = std::make_unique<CSparseMatrix::CholeskyDecomp>(sp_H);
-			else
-				ptrCh.get()->update(sp_H);
+			cholCache.factorize(sp_H);
 			profiler.leave("optimize_graph_spa_levmarq.sp_H:chol");
 
 			profiler.enter("optimize_graph_spa_levmarq.sp_H:backsub");
-			ptrCh->backsub(grad, delta);
+			cholCache.chol->backsub(grad, delta);
 			profiler.leave("optimize_graph_spa_levmarq.sp_H:backsub");
 		}
 		catch (CExceptionNotDefPos&)
@@ -550,11 +727,9 @@ void optimize_graph_spa_levmarq(
 		profiler.enter("optimize_graph_spa_levmarq.x_norm");
 		double x_norm = 0;
 		{
-			for (unsigned long it : *nodes_to_optimize)
+			for (const auto* itP : freeNodePoses)
 			{
-				auto itP = graph.nodes.find(it);
-				const typename gst::graph_t::constraint_t::type_value& P =
-					itP->second;
+				const typename gst::graph_t::constraint_t::type_value& P = *itP;
 				for (size_t i = 0; i < DIMS_POSE; i++)
 					x_norm += square(P[i]);
 			}
@@ -582,13 +757,10 @@ void optimize_graph_spa_levmarq(
 			//  new_x = old_x [+] (-delta)    , with [+] being the "manifold
 			//  exp()+add" operation.
 			// =====================================================================================
-			typename gst::graph_t::global_poses_t old_poses_backup;
-
 			{
-				ASSERTDEB_(
-					delta.size() == int(nodes_to_optimize->size() * DIMS_POSE));
+				ASSERTDEB_(delta.size() == int(nFreeNodes * DIMS_POSE));
 				const double* delta_ptr = &delta[0];
-				for (unsigned long it : *nodes_to_optimize)
+				for (size_t k = 0; k < nFreeNodes; k++)
 				{
 					typename gst::Array_O exp_delta;
 					for (size_t i = 0; i < DIMS_POSE; i++)
@@ -597,34 +769,42 @@ void optimize_graph_spa_levmarq(
 					// Gauss-Newton formula above.
 
 					// new_x_i =  exp_delta_i (+) old_x_i
-					auto it_old_value = graph.nodes.find(it);
-					old_poses_backup[it] =
-						it_old_value->second;  // back up the old pose as a copy
+					auto& P = *freeNodePoses[k];
+					old_poses_backup[k] = P;  // back up the old pose as a copy
 
 					// Update estimate:
-					it_old_value->second =
-						it_old_value->second + gst::SE_TYPE::exp(exp_delta);
+					P = P + gst::SE_TYPE::exp(exp_delta);
 				}
 			}
 
 			// =============================================================
 			// Compute Jacobians & errors with the new "graph.nodes" info:
 			// =============================================================
-			typename gst::map_pairIDs_pairJacobs_t new_lstJacobians;
+			std::vector<typename gst::TPairJacobs> new_lstJacobians;
 			std::vector<typename gst::Array_O> new_errs;
 
 			profiler.enter("optimize_graph_spa_levmarq.Jacobians&err");
 			double new_total_sqr_err = computeJacobiansAndErrors<GRAPH_T>(
-				graph, lstObservationData, new_lstJacobians, new_errs);
+				graph, lstObservationData, new_lstJacobians, new_errs,
+				pool.get(), nThreads);
 			profiler.leave("optimize_graph_spa_levmarq.Jacobians&err");
 
+			CVectorDouble new_prior_delta;
+			double new_prior_err = 0;
+			if (use_prior)
+				new_prior_err =
+					marginal_prior->evaluate(graph, new_prior_delta);
+
 			// Now, to decide whether to accept the change:
-			if (new_total_sqr_err < total_sqr_err)	// rho>0)
+			if (new_total_sqr_err + new_prior_err <
+				total_sqr_err + prior_err)	// rho>0)
 			{
 				// Accept the new point:
 				new_lstJacobians.swap(lstJacobians);
 				new_errs.swap(errs);
 				std::swap(new_total_sqr_err, total_sqr_err);
+				prior_delta = new_prior_delta;
+				prior_err = new_prior_err;
 
 				// Instruct to recompute H and grad from the new Jacobians.
 				have_to_recompute_H_and_grad = true;
@@ -633,9 +813,8 @@ void optimize_graph_spa_levmarq(
 			{
 				// Nope...
 				// We have to revert the "graph.nodes" to "old_poses_backup"
-				for (auto it = old_poses_backup.begin();
-					 it != old_poses_backup.end(); ++it)
-					graph.nodes[it->first] = it->second;
+				for (size_t k = 0; k < nFreeNodes; k++)
+					*freeNodePoses[k] = old_poses_backup[k];
 
 				if (verbose)
 					cout << "[optimize_graph_spa_levmarq] Got larger error="
@@ -660,6 +839,169 @@ void optimize_graph_spa_levmarq(
 	MRPT_END
 }  // end of optimize_graph_spa_levmarq()
 
+/** Marginalizes out the nodes `nodes_to_marginalize` of `graph` into the
+ * dense prior `prior` (sliding-window optimization), by taking the Schur
+ * complement of the information matrix of their edges (but those already in
+ * the prior) and of the former prior, linearized at the current poses.
+ *
+ * The resulting prior is on the boundary nodes, those linked to the
+ * marginalized ones. The root and the nodes marginalized before are taken as
+ * fixed. The graph is not modified: pass `prior` to
+ * optimize_graph_spa_levmarq() to optimize the rest of nodes (the window)
+ * without its marginalized edges.
+ *
+ * Call it with the nodes leaving the window, oldest first, before optimizing
+ * the window. Its cost is cubic in the number of marginalized plus boundary
+ * nodes, and linear in the number of edges of the graph (scanned once).
+ *
+ * 
+ote (New in MRPT 2.4.9)
+ * \ingroup mrpt_graphslam_grp
+ */
+template <class GRAPH_T>
+void marginalize_graph_nodes(
+	const GRAPH_T& graph,
+	const std::set<mrpt::graphs::TNodeID>& nodes_to_marginalize,
+	TMarginalizationPrior<GRAPH_T>& prior)
+{
+	using mrpt::graphs::TNodeID;
+	using gst = graphslam_traits<GRAPH_T>;
+	using aux_t = detail::AuxErrorEval<typename gst::edge_t, gst>;
+	constexpr auto DIMS_POSE = gst::SE_TYPE::DOFs;
+
+	MRPT_START
+
+	const auto isVariable = [&](TNodeID id) {
+		return id != graph.root && prior.marginalized_nodes.count(id) == 0;
+	};
+
+	// Variables: the nodes to eliminate first, then the boundary nodes.
+	std::vector<TNodeID> vars;
+	std::map<TNodeID, size_t> var_index;
+	const auto addVariable = [&](TNodeID id) {
+		if (isVariable(id) && var_index.count(id) == 0)
+		{
+			var_index[id] = vars.size();
+			vars.push_back(id);
+		}
+	};
+	for (const TNodeID id : nodes_to_marginalize)
+		addVariable(id);
+	const size_t nMarg = vars.size();
+	if (nMarg == 0) return;
+
+	const auto isMarginalized = [&](TNodeID id) {
+		const auto it = var_index.find(id);
+		return it != var_index.end() && it->second < nMarg;
+	};
+
+	// Edges of the nodes to eliminate, not in the prior yet:
+	std::vector<const typename gst::edge_map_entry_t*> edges;
+	std::set<mrpt::graphs::TPairNodeIDs> new_pairs;
+	for (const auto& e : graph.edges)
+	{
+		const auto& ids = e.first;
+		if (!isMarginalized(ids.first) && !isMarginalized(ids.second))
+			continue;
+		if (prior.marginalized_edges.count(ids)) continue;
+
+		ASSERTMSG_(graph.nodes.count(ids.first), "Edge node1 has no pose");
+		ASSERTMSG_(graph.nodes.count(ids.second), "Edge node2 has no pose");
+		edges.push_back(&e);
+		new_pairs.insert(ids);
+		addVariable(ids.first);
+		addVariable(ids.second);
+	}
+	for (const TNodeID id : prior.nodes)
+		addVariable(id);
+	// Keep the boundary nodes sorted by ID:
+	std::sort(vars.begin() + nMarg, vars.end());
+	for (size_t i = nMarg; i < vars.size(); i++)
+		var_index[vars[i]] = i;
+
+	// Information matrix and gradient for all the variables:
+	const size_t n = vars.size() * DIMS_POSE;
+	Eigen::MatrixXd H = Eigen::MatrixXd::Zero(n, n);
+	Eigen::VectorXd g = Eigen::VectorXd::Zero(n);
+
+	for (const auto* e : edges)
+	{
+		const auto& EDGE_POSE = e->second.getPoseMean();
+		const auto& P1 = graph.nodes.find(e->first.first)->second;
+		const auto& P2 = graph.nodes.find(e->first.second)->second;
+
+		const typename gst::Array_O err =
+			gst::SE_TYPE::log((P2 - P1) - EDGE_POSE);
+		typename gst::matrix_TxT J[2];
+		gst::SE_TYPE::jacob_dDinvP1invP2_de1e2(
+			-EDGE_POSE, P1, P2, J[0], J[1]);
+
+		const TNodeID ids[2] = {e->first.first, e->first.second};
+		for (int a = 0; a < 2; a++)
+		{
+			const auto ita = var_index.find(ids[a]);
+			if (ita == var_index.end()) continue;  // A fixed node
+			const size_t ia = ita->second * DIMS_POSE;
+
+			typename gst::Array_O ga;
+			ga.setZero();
+			aux_t::multiply_Jt_W_err(J[a], e, err, ga);
+			g.template segment<DIMS_POSE>(ia) += ga.asEigen();
+
+			for (int c = 0; c < 2; c++)
+			{
+				const auto itc = var_index.find(ids[c]);
+				if (itc == var_index.end()) continue;
+				typename gst::matrix_TxT Hac;
+				aux_t::multiplyJ1tLambdaJ2(J[a], J[c], Hac, e);
+				H.template block<DIMS_POSE, DIMS_POSE>(
+					ia, itc->second * DIMS_POSE) += Hac.asEigen();
+			}
+		}
+	}
+
+	// The former prior, linearized at the current poses:
+	if (!prior.nodes.empty())
+	{
+		mrpt::math::CVectorDouble delta;
+		prior.evaluate(graph, delta);
+		const Eigen::VectorXd prior_grad =
+			prior.H.asEigen() * delta.asEigen() + prior.b.asEigen();
+
+		std::vector<size_t> idx;
+		for (const TNodeID id : prior.nodes)
+			idx.push_back(var_index.at(id) * DIMS_POSE);
+		for (size_t k = 0; k < idx.size(); k++)
+		{
+			g.template segment<DIMS_POSE>(idx[k]) +=
+				prior_grad.template segment<DIMS_POSE>(k * DIMS_POSE);
+			for (size_t l = 0; l < idx.size(); l++)
+				H.template block<DIMS_POSE, DIMS_POSE>(idx[k], idx[l]) +=
+					prior.H.asEigen().template block<DIMS_POSE, DIMS_POSE>(
+						k * DIMS_POSE, l * DIMS_POSE);
+		}
+	}
+
+	// Schur complement of the marginalized block:
+	const size_t m = nMarg * DIMS_POSE, nb = n - m;
+	const auto Hmm = H.topLeftCorner(m, m).ldlt();
+	const Eigen::MatrixXd Hbm = H.bottomLeftCorner(nb, m);
+	const Eigen::MatrixXd Hb = H.bottomRightCorner(nb, nb) -
+		Hbm * Hmm.solve(H.topRightCorner(m, nb));
+	const Eigen::VectorXd gb = g.tail(nb) - Hbm * Hmm.solve(g.head(m));
+
+	prior.nodes.assign(vars.begin() + nMarg, vars.end());
+	prior.linearization_points.clear();
+	for (const TNodeID id : prior.nodes)
+		prior.linearization_points.push_back(graph.nodes.find(id)->second);
+	prior.H = mrpt::math::CMatrixDouble(0.5 * (Hb + Hb.transpose()));
+	prior.b = mrpt::math::CVectorDouble(gb);
+	prior.marginalized_nodes.insert(vars.begin(), vars.begin() + nMarg);
+	prior.marginalized_edges.insert(new_pairs.begin(), new_pairs.end());
+
+	MRPT_END
+}
+
 /**  @} */	// end of grouping
 
 }  // namespace mrpt::graphslam
@@ -8,7 +8,12 @@
    +------------------------------------------------------------------------+ */
 #pragma once
 
+#include <mrpt/core/WorkerThreadsPool.h>
+
 #include <Eigen/Dense>
+#include <algorithm>
+#include <numeric>
+#include <thread>
 #include <vector>
 
 namespace mrpt
@@ -144,6 +149,20 @@ struct AuxErrorEval<CPose3DPDFGaussianInf, gst>
 	}
 };
 
+// Number of threads to evaluate "nObservations" edges, given the user
+// parameter "num_threads" (0: auto)
+inline size_t levmarqNumThreads(size_t num_threads, size_t nObservations)
+{
+	// In auto mode, so many edges per thread at least, or threads would cost
+	// more than they save:
+	constexpr size_t MIN_EDGES_PER_THREAD = 2000;
+	if (num_threads == 0)
+		num_threads = std::min<size_t>(
+			std::max(1U, std::thread::hardware_concurrency()),
+			nObservations / MIN_EDGES_PER_THREAD);
+	return std::max<size_t>(1, std::min(num_threads, nObservations));
+}
+
 }  // namespace detail
 
 // Compute, at once, jacobians and the error vectors for each constraint in
@@ -207,5 +226,56 @@ double computeJacobiansAndErrors(
 	return ret_err;
 }
 
+// Like above, but with the Jacobians in a vector, in the same order than
+// "lstObservationData". If a thread pool is given, the observations are split
+// into "nChunks" contiguous ranges, evaluated in parallel.
+template <class GRAPH_T>
+double computeJacobiansAndErrors(
+	[[maybe_unused]] const GRAPH_T& graph,
+	const std::vector<typename graphslam_traits<GRAPH_T>::observation_info_t>&
+		lstObservationData,
+	std::vector<typename graphslam_traits<GRAPH_T>::TPairJacobs>& lstJacobians,
+	std::vector<typename graphslam_traits<GRAPH_T>::Array_O>& errs,
+	mrpt::WorkerThreadsPool* pool = nullptr, size_t nChunks = 1)
+{
+	using gst = graphslam_traits<GRAPH_T>;
+
+	const size_t nObservations = lstObservationData.size();
+	lstJacobians.resize(nObservations);
+	errs.resize(nObservations);
+
+	if (!pool) nChunks = 1;
+	nChunks = std::max<size_t>(1, std::min(nChunks, nObservations));
+	const size_t chunk = (nObservations + nChunks - 1) / nChunks;
+	// Squared error of each chunk, added up in order in the end:
+	std::vector<double> chunk_errs(nChunks, 0.0);
+
+	const auto evalChunk = [&](size_t c) {
+		const size_t last = std::min(nObservations, (c + 1) * chunk);
+		for (size_t i = c * chunk; i < last; i++)
+		{
+			const typename gst::observation_info_t& obs = lstObservationData[i];
+			const auto& EDGE_POSE = *obs.edge_mean;
+
+			// DinvP1invP2 = inv(EDGE) * inv(P1) * P2 = (P2 \ominus P1) \ominus
+			// EDGE
+			const typename gst::graph_t::constraint_t::type_value DinvP1invP2 =
+				((*obs.P2) - (*obs.P1)) - EDGE_POSE;
+			errs[i] = gst::SE_TYPE::log(DinvP1invP2);
+
+			gst::SE_TYPE::jacob_dDinvP1invP2_de1e2(
+				-EDGE_POSE, *obs.P1, *obs.P2, lstJacobians[i].first,
+				lstJacobians[i].second);
+
+			chunk_errs[c] += mrpt::square(errs[i].norm());
+		}
+	};
+	if (nChunks > 1) pool->parallel_for(0, nChunks, 1, evalChunk);
+	else
+		evalChunk(0);
+
+	return std::accumulate(chunk_errs.begin(), chunk_errs.end(), 0.0);
+}
+
 }  // namespace graphslam
 }  // namespace mrpt
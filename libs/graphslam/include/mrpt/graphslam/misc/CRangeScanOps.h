@@ -78,13 +78,19 @@ class CRangeScanOps
 	 * can transform the one into the other.
 	 *
 	 * User can optionally ask that additional information be returned in a
-	 * TReturnInfo struct
+	 * TReturnInfo struct. Alignments run with `params.icp`, or with `icp` if
+	 * given, e.g. one instance per thread for concurrent calls.
+	 *
+	 * The scans are aligned as their auxiliary points maps (see
+	 * mrpt::obs::CObservation2DRangeScan::buildAuxPointsMap()), which are
+	 * cached in the scans, with their KD-trees, for the next alignments.
 	 */
 	void getICPEdge(
 		const mrpt::obs::CObservation2DRangeScan& from,
 		const mrpt::obs::CObservation2DRangeScan& to, constraint_t* rel_edge,
 		const mrpt::poses::CPose2D* initial_pose = nullptr,
-		mrpt::slam::CICP::TReturnInfo* icp_info = nullptr);
+		mrpt::slam::CICP::TReturnInfo* icp_info = nullptr,
+		mrpt::slam::CICP* icp = nullptr);
 	/**\brief Align the 3D range scans provided and find the potential edge that
 	 * can transform the one into the other.
 	 *
@@ -98,6 +104,16 @@ class CRangeScanOps
 		const mrpt::obs::CObservation3DRangeScan& to, constraint_t* rel_edge,
 		const mrpt::poses::CPose2D* initial_pose = nullptr,
 		mrpt::slam::CICP::TReturnInfo* icp_info = nullptr);
+	/**\brief Like the CObservation3DRangeScan version of getICPEdge(), from
+	 * the points maps of both scans, e.g. cached by the caller.
+	 * Alignments run with `params.icp`, or with `icp` if given.
+	 */
+	void getICPEdge3D(
+		const mrpt::maps::CPointsMap& from, const mrpt::maps::CPointsMap& to,
+		constraint_t* rel_edge,
+		const mrpt::poses::CPose2D* initial_pose = nullptr,
+		mrpt::slam::CICP::TReturnInfo* icp_info = nullptr,
+		mrpt::slam::CICP* icp = nullptr);
 	/**\brief Reduce the size of the given CPointsMap by keeping one out of
 	 * "keep_point_every" points.
 	 *
@@ -17,23 +17,23 @@ void CRangeScanOps<GRAPH_T>::getICPEdge(
 	const mrpt::obs::CObservation2DRangeScan& from,
 	const mrpt::obs::CObservation2DRangeScan& to, constraint_t* rel_edge,
 	const mrpt::poses::CPose2D* initial_pose_in,
-	mrpt::slam::CICP::TReturnInfo* icp_info)
+	mrpt::slam::CICP::TReturnInfo* icp_info, mrpt::slam::CICP* icp)
 {
 	MRPT_START
 
-	mrpt::maps::CSimplePointsMap m1, m2;
+	// Cached in the scans (thread-safe), so the points and KD-tree of each
+	// scan are only built once for all its alignments:
+	const auto* m1 = from.buildAuxPointsMap<mrpt::maps::CSimplePointsMap>();
+	const auto* m2 = to.buildAuxPointsMap<mrpt::maps::CSimplePointsMap>();
+	ASSERT_(m1 && m2);
 	mrpt::slam::CICP::TReturnInfo info;
 
-	// have them initialized prior - and then just clear them
-	m1.insertObservation(from);
-	m2.insertObservation(to);
-
 	// If given, use initial_pose_in as a first guess for the ICP
 	mrpt::poses::CPose2D initial_pose;
 	if (initial_pose_in) { initial_pose = *initial_pose_in; }
 
 	mrpt::poses::CPosePDF::Ptr pdf =
-		params.icp.Align(&m1, &m2, initial_pose, info);
+		(icp ? *icp : params.icp).Align(m1, m2, initial_pose, info);
 
 	// return the edge regardless of the goodness of the alignment
 	rel_edge->copyFrom(*pdf);
@@ -57,20 +57,32 @@ void CRangeScanOps<GRAPH_T>::getICPEdge(
 	ASSERTDEBMSG_(
 		to.hasRangeImage, "Laser scan doesn't contain valid range image");
 
-	// TODO - have this as a class member
 	mrpt::maps::CSimplePointsMap m1, m2;
-	mrpt::slam::CICP::TReturnInfo info;
-
 	m1.insertObservation(from);
 	m2.insertObservation(to);
 
+	getICPEdge3D(m1, m2, rel_edge, initial_pose_in, icp_info);
+
+	MRPT_END
+}
+
+template <class GRAPH_T>
+void CRangeScanOps<GRAPH_T>::getICPEdge3D(
+	const mrpt::maps::CPointsMap& from, const mrpt::maps::CPointsMap& to,
+	constraint_t* rel_edge, const mrpt::poses::CPose2D* initial_pose_in,
+	mrpt::slam::CICP::TReturnInfo* icp_info, mrpt::slam::CICP* icp)
+{
+	MRPT_START
+
+	mrpt::slam::CICP::TReturnInfo info;
+
 	// If given, use initial_pose_in as a first guess for the ICP
 	mrpt::poses::CPose3D initial_pose;
 	if (initial_pose_in)
 	{ initial_pose = mrpt::poses::CPose3D(*initial_pose_in); }
 
 	mrpt::poses::CPose3DPDF::Ptr pdf =
-		params.icp.Align3D(&m1, &m2, initial_pose, info);
+		(icp ? *icp : params.icp).Align3D(&from, &to, initial_pose, info);
 
 	// return the edge regardless of the goodness of the alignment
 	// copy from the 3D PDF
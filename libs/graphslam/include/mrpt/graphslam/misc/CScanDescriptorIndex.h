@@ -0,0 +1,149 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#pragma once
+
+#include <mrpt/graphs/TNodeID.h>
+#include <mrpt/obs/CObservation2DRangeScan.h>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <nanoflann.hpp>
+#include <utility>
+#include <vector>
+
+namespace mrpt::graphslam
+{
+/**\brief Global index of laser scan descriptors, for retrieving loop closure
+ * candidates by place appearance instead of by pose distance.
+ *
+ * ## Description
+ *
+ * Each scan is summarized into a rotation-invariant descriptor: the
+ * normalized histogram of its ranges over `num_rings` concentric rings
+ * (the "ring key" of Scan Context), with linear interpolation between
+ * neighboring rings to reduce quantization effects. Since it does not depend
+ * on the order of the beams, the descriptor of a 360 degrees scan does not
+ * change with the robot heading.
+ *
+ * Descriptors are stored in a flat array and indexed with an incremental
+ * KD-tree (nanoflann::KDTreeSingleIndexDynamicAdaptor), so the `k` most
+ * similar scans to a query are found in sublinear time, and only those need
+ * to be checked with ICP.
+ *
+ * mrpt::obs::CObservation3DRangeScan observations can be indexed by
+ * converting them into 2D scans first (see
+ * mrpt::graphslam::CRangeScanOps::convert3DTo2DRangeScan()).
+ *
+ * \note (New in MRPT 2.4.9)
+ * \ingroup mrpt_graphslam_grp
+ */
+class CScanDescriptorIndex
+{
+   public:
+	using descriptor_t = std::vector<float>;
+
+	constexpr static unsigned int DEFAULT_NUM_RINGS = 20;
+
+	/** \param num_rings Length of the descriptors.
+	 * \param max_range Radius of the outermost ring (meters). Use 0 to take
+	 * the maximum range of each scan. */
+	CScanDescriptorIndex(
+		unsigned int num_rings = DEFAULT_NUM_RINGS, double max_range = 0);
+
+	/** Computes the ring histogram descriptor of a scan.
+	 * \param[out] desc A vector of length `num_rings`, summing up to 1 (or
+	 * all zeros, if the scan has no valid ranges). */
+	static void computeDescriptor(
+		const mrpt::obs::CObservation2DRangeScan& scan, descriptor_t& desc,
+		unsigned int num_rings, double max_range = 0);
+	/// \overload With the parameters of this index
+	void computeDescriptor(
+		const mrpt::obs::CObservation2DRangeScan& scan,
+		descriptor_t& desc) const
+	{
+		computeDescriptor(scan, desc, m_num_rings, m_max_range);
+	}
+
+	/** Squared Euclidean distance between two descriptors */
+	static float descriptorDistanceSqr(
+		const descriptor_t& a, const descriptor_t& b);
+
+	/** Adds the descriptor of a node to the index.
+	 * \exception std::exception If the node is already in the index, or the
+	 * descriptor length is not num_rings. */
+	void insert(const mrpt::graphs::TNodeID id, const descriptor_t& desc);
+	/// \overload
+	void insert(
+		const mrpt::graphs::TNodeID id,
+		const mrpt::obs::CObservation2DRangeScan& scan);
+
+	/** Finds the (up to) `k` indexed nodes with the most similar descriptors
+	 * to `desc`.
+	 * \return Pairs of node ID and squared descriptor distance, sorted by
+	 * increasing distance. */
+	std::vector<std::pair<mrpt::graphs::TNodeID, float>> query(
+		const descriptor_t& desc, size_t k) const;
+	/// \overload
+	std::vector<std::pair<mrpt::graphs::TNodeID, float>> query(
+		const mrpt::obs::CObservation2DRangeScan& scan, size_t k) const;
+
+	/** Whether a node is in the index */
+	bool contains(const mrpt::graphs::TNodeID id) const
+	{
+		return m_id2idx.count(id) != 0;
+	}
+	/** Gets the descriptor of an indexed node.
+	 * \return false if the node is not in the index. */
+	bool getDescriptor(
+		const mrpt::graphs::TNodeID id, descriptor_t& desc) const;
+
+	size_t size() const { return m_ids.size(); }
+	bool empty() const { return m_ids.empty(); }
+	void clear();
+
+	unsigned int getNumRings() const { return m_num_rings; }
+	double getMaxRange() const { return m_max_range; }
+
+	/** @name Interface for nanoflann
+		@{ */
+	inline size_t kdtree_get_point_count() const { return m_ids.size(); }
+	inline float kdtree_get_pt(const size_t idx, size_t dim) const
+	{
+		return m_descs[idx * m_num_rings + dim];
+	}
+	template <typename BBOX>
+	bool kdtree_get_bbox([[maybe_unused]] BBOX& bb) const
+	{
+		return false;
+	}
+	/** @} */
+
+   private:
+	unsigned int m_num_rings;
+	double m_max_range;
+
+	/** Node IDs and their descriptors, at [i*num_rings, (i+1)*num_rings) */
+	std::vector<mrpt::graphs::TNodeID> m_ids;
+	std::vector<float> m_descs;
+	std::map<mrpt::graphs::TNodeID, size_t> m_id2idx;
+
+	using metric_t = nanoflann::L2_Simple_Adaptor<float, CScanDescriptorIndex>;
+	using kdtree_t = nanoflann::KDTreeSingleIndexDynamicAdaptor<
+		metric_t, CScanDescriptorIndex, -1, size_t>;
+
+	/** Built upon the first query, then new descriptors are added to it */
+	mutable std::unique_ptr<kdtree_t> m_kdtree;
+	mutable size_t m_num_indexed = 0;
+	mutable std::mutex m_kdtree_mtx;
+
+	void updateKDTree() const;
+};
+}  // namespace mrpt::graphslam
@@ -0,0 +1,484 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "graphslam-precomp.h"	// Precompiled headers
+//
+#include <mrpt/config/CConfigFileBase.h>
+#include <mrpt/core/WorkerThreadsPool.h>
+#include <mrpt/graphslam/CMultiSessionMapMerger.h>
+#include <mrpt/graphslam/levmarq.h>
+#include <mrpt/maps/CMultiMetricMap.h>
+#include <mrpt/maps/COccupancyGridMap2D.h>
+#include <mrpt/maps/CSimplePointsMap.h>
+#include <mrpt/poses/CPosePDFGaussian.h>
+#include <mrpt/poses/CPosePDFSOG.h>
+#include <mrpt/slam/CICP.h>
+
+#include <algorithm>
+#include <deque>
+#include <future>
+#include <optional>
+#include <thread>
+
+using namespace mrpt::graphslam;
+using mrpt::graphs::TNodeID;
+using mrpt::maps::CMultiMetricMap;
+using mrpt::maps::CSimpleMap;
+using mrpt::maps::CSimplePointsMap;
+using mrpt::poses::CPose2D;
+using mrpt::poses::CPose3D;
+using mrpt::poses::CPosePDFGaussianInf;
+
+namespace
+{
+CPosePDFGaussianInf makeEdge(
+	const CPose2D& p, const double std_xy, const double std_phi)
+{
+	CPosePDFGaussianInf e;
+	e.mean = p;
+	e.cov_inv.setZero();
+	e.cov_inv(0, 0) = e.cov_inv(1, 1) = 1.0 / mrpt::square(std_xy);
+	e.cov_inv(2, 2) = 1.0 / mrpt::square(std_phi);
+	return e;
+}
+}  // namespace
+
+CMultiSessionMapMerger::CMultiSessionMapMerger()
+	: mrpt::system::COutputLogger("CMultiSessionMapMerger")
+{
+}
+
+size_t CMultiSessionMapMerger::addSession(
+	const CSimpleMap& sm, const graph_t* graph)
+{
+	MRPT_START
+
+	ASSERTMSG_(!sm.empty(), "Cannot merge an empty simple map");
+
+	TSession s;
+	s.sm = sm;
+	if (graph)
+	{
+		// Reuse the optimized session: its poses and edges:
+		ASSERTMSG_(
+			graph->nodes.size() == sm.size(),
+			mrpt::format(
+				"The graph has %zu nodes, but the simple map %zu keyframes",
+				graph->nodes.size(), sm.size()));
+		for (size_t i = 0; i < sm.size(); i++)
+			ASSERTMSG_(
+				graph->nodes.count(i) != 0,
+				mrpt::format("The graph has no node for keyframe #%zu", i));
+
+		s.graph.nodes = graph->nodes;
+		for (const auto& e : graph->edges)
+		{
+			const auto [from, to] = e.first;
+			ASSERT_(from < sm.size() && to < sm.size());
+			if (graph->edges_store_inverse_poses)
+			{
+				CPosePDFGaussianInf inv;
+				e.second.inverse(inv);
+				s.graph.insertEdge(from, to, inv);
+			}
+			else
+				s.graph.insertEdge(from, to, e.second);
+		}
+	}
+	else
+	{
+		// Chain of consecutive keyframes:
+		for (size_t i = 0; i < sm.size(); i++)
+		{
+			const auto [pdf, sf] = sm.get(i);
+			s.graph.nodes[i] = CPose2D(pdf->getMeanVal());
+			if (i == 0) continue;
+			s.graph.insertEdge(
+				i - 1, i,
+				makeEdge(
+					s.graph.nodes[i] - s.graph.nodes[i - 1],
+					options.odometry_std_xy, options.odometry_std_phi));
+		}
+	}
+
+	if (!m_sessions.empty())
+		s.firstNodeID = m_sessions.back().firstNodeID +
+			static_cast<TNodeID>(m_sessions.back().sm.size());
+
+	m_sessions.emplace_back(std::move(s));
+	return m_sessions.size() - 1;
+
+	MRPT_END
+}
+
+size_t CMultiSessionMapMerger::addSessionFromFiles(
+	const std::string& simplemapFile, const std::string& graphFile)
+{
+	CSimpleMap sm;
+	if (!sm.loadFromFile(simplemapFile))
+		THROW_EXCEPTION_FMT(
+			"Error loading simplemap file: '%s'", simplemapFile.c_str());
+	if (graphFile.empty()) return addSession(sm);
+
+	graph_t graph;
+	graph.loadFromTextFile(graphFile);
+	return addSession(sm, &graph);
+}
+
+void CMultiSessionMapMerger::clear()
+{
+	m_sessions.clear();
+	m_graph.clear();
+	m_constraints.clear();
+	m_optInfo = TResultInfoSpaLevMarq();
+}
+
+bool CMultiSessionMapMerger::isSessionMerged(size_t session) const
+{
+	ASSERT_LT_(session, m_sessions.size());
+	return m_sessions[session].merged;
+}
+
+TNodeID CMultiSessionMapMerger::getGlobalNodeID(
+	size_t session, size_t keyframe) const
+{
+	ASSERT_LT_(session, m_sessions.size());
+	ASSERT_LT_(keyframe, m_sessions[session].sm.size());
+	return m_sessions[session].firstNodeID + static_cast<TNodeID>(keyframe);
+}
+
+void CMultiSessionMapMerger::merge()
+{
+	MRPT_START
+
+	ASSERT_ABOVE_(options.submap_num_keyframes, 0U);
+
+	m_graph.clear();
+	m_constraints.clear();
+	m_optInfo = TResultInfoSpaLevMarq();
+	for (auto& s : m_sessions)
+		s.merged = false;
+	if (m_sessions.empty()) return;
+
+	size_t nThreads = options.num_threads;
+	if (!nThreads) nThreads = std::max(1U, std::thread::hardware_concurrency());
+	mrpt::WorkerThreadsPool pool(
+		nThreads, mrpt::WorkerThreadsPool::POLICY_FIFO, "map_merger");
+
+	// 1) Split the sessions into submaps:
+	// ----------------------------------------
+	struct TSubmap
+	{
+		size_t session = 0;
+		/** Keyframes [first,last), in the frame of the anchor keyframe */
+		size_t first = 0, last = 0, anchor = 0;
+		CMultiMetricMap::Ptr map;
+	};
+	std::vector<TSubmap> submaps;
+	for (size_t s = 0; s < m_sessions.size(); s++)
+	{
+		const size_t N = m_sessions[s].sm.size();
+		for (size_t first = 0; first < N;
+			 first += options.submap_num_keyframes)
+		{
+			TSubmap sub;
+			sub.session = s;
+			sub.first = first;
+			sub.last =
+				std::min<size_t>(N, first + options.submap_num_keyframes);
+			sub.anchor = (sub.first + sub.last - 1) / 2;
+			submaps.push_back(sub);
+		}
+	}
+
+	mrpt::maps::TSetOfMetricMapInitializers inits;
+	{
+		mrpt::maps::COccupancyGridMap2D::TMapDefinition def;
+		def.resolution = options.grid_resolution;
+		inits.push_back(def);
+	}
+	{
+		CSimplePointsMap::TMapDefinition def;
+		def.insertionOpts.minDistBetweenLaserPoints = options.grid_resolution;
+		inits.push_back(def);
+	}
+
+	{
+		std::vector<std::future<void>> futs;
+		for (auto& sub : submaps)
+			futs.emplace_back(pool.enqueue([this, &inits, &sub]() {
+				const TSession& ses = m_sessions[sub.session];
+				sub.map = std::make_shared<CMultiMetricMap>(inits);
+				const CPose3D anchor(ses.graph.nodes.at(sub.anchor));
+				for (size_t k = sub.first; k < sub.last; k++)
+				{
+					const auto [pdf, sf] = ses.sm.get(k);
+					sf->insertObservationsInto(
+						*sub.map, CPose3D(ses.graph.nodes.at(k)) - anchor);
+				}
+			}));
+		for (auto& f : futs)
+			f.get();
+	}
+	MRPT_LOG_INFO_FMT(
+		"Built %zu submaps from %zu sessions.", submaps.size(),
+		m_sessions.size());
+
+	// 2) Global alignment of each submap against those of later sessions:
+	// ----------------------------------------------------------------------
+	struct TPair
+	{
+		size_t a = 0, b = 0;
+		mrpt::poses::CPosePDF::Ptr pdf;
+		double goodness = 0;
+		CPose2D pose;
+	};
+	std::vector<TPair> pairs;
+
+	mrpt::slam::CGridMapAligner aligner;
+	aligner.options = options.aligner_options;
+	aligner.options.batch_num_threads = static_cast<unsigned int>(nThreads);
+	for (size_t a = 0; a < submaps.size(); a++)
+	{
+		std::vector<const mrpt::maps::CMetricMap*> candidates;
+		std::vector<size_t> idxs;
+		for (size_t b = a + 1; b < submaps.size(); b++)
+		{
+			if (submaps[b].session == submaps[a].session) continue;
+			candidates.push_back(submaps[b].map.get());
+			idxs.push_back(b);
+		}
+		if (candidates.empty()) continue;
+
+		const auto pdfs = aligner.AlignPDFBatch(
+			submaps[a].map.get(), candidates,
+			mrpt::poses::CPosePDFGaussian());
+		for (size_t i = 0; i < pdfs.size(); i++)
+		{
+			TPair p;
+			p.a = a;
+			p.b = idxs[i];
+			p.pdf = pdfs[i];
+			pairs.push_back(p);
+		}
+	}
+
+	// 3) Refine and verify the best hypotheses of each pair with ICP:
+	// ----------------------------------------------------------------------
+	{
+		std::vector<std::future<void>> futs;
+		for (auto& p : pairs)
+			futs.emplace_back(pool.enqueue([this, &submaps, &p]() {
+				std::vector<std::pair<double, CPose2D>> hyps;
+				if (auto sog =
+						std::dynamic_pointer_cast<mrpt::poses::CPosePDFSOG>(
+							p.pdf);
+					sog)
+				{
+					for (const auto& m : *sog)
+						hyps.emplace_back(m.log_w, m.mean);
+					std::sort(
+						hyps.begin(), hyps.end(),
+						[](const auto& h1, const auto& h2) {
+							return h1.first > h2.first;
+						});
+					if (hyps.size() > options.max_hypotheses)
+						hyps.resize(options.max_hypotheses);
+				}
+				else if (p.pdf)
+					hyps.emplace_back(0, p.pdf->getMeanVal());
+
+				const auto pts1 =
+					submaps[p.a].map->mapByClass<CSimplePointsMap>();
+				const auto pts2 =
+					submaps[p.b].map->mapByClass<CSimplePointsMap>();
+
+				mrpt::slam::CICP icp;
+				icp.options.maxIterations = 50;
+				icp.options.thresholdDist = 0.5f;
+				icp.options.smallestThresholdDist = 0.05f;
+				for (const auto& h : hyps)
+				{
+					mrpt::slam::CICP::TReturnInfo info;
+					const auto est =
+						icp.Align(pts1.get(), pts2.get(), h.second, info);
+					if (info.goodness > p.goodness)
+					{
+						p.goodness = info.goodness;
+						p.pose = est->getMeanVal();
+					}
+				}
+			}));
+		for (auto& f : futs)
+			f.get();
+	}
+
+	for (const auto& p : pairs)
+	{
+		if (p.goodness < options.min_icp_goodness) continue;
+		const TSubmap &s1 = submaps[p.a], &s2 = submaps[p.b];
+
+		TInterSessionConstraint c;
+		c.session1 = s1.session;
+		c.session2 = s2.session;
+		c.node1 = getGlobalNodeID(s1.session, s1.anchor);
+		c.node2 = getGlobalNodeID(s2.session, s2.anchor);
+		c.pose = p.pose;
+		c.goodness = p.goodness;
+		m_constraints.push_back(c);
+	}
+	MRPT_LOG_INFO_FMT(
+		"Accepted %zu inter-session constraints out of %zu submap pairs.",
+		m_constraints.size(), pairs.size());
+
+	// 4) Initial pose of each session connected to the first one:
+	// ----------------------------------------------------------------------
+	const auto localPose = [this](size_t s, TNodeID globalID) {
+		return m_sessions[s].graph.nodes.at(
+			globalID - m_sessions[s].firstNodeID);
+	};
+
+	std::vector<std::optional<CPose2D>> origins(m_sessions.size());
+	origins[0] = CPose2D();
+	std::deque<size_t> pending = {0};
+	while (!pending.empty())
+	{
+		const size_t s = pending.front();
+		pending.pop_front();
+		for (const auto& c : m_constraints)
+		{
+			std::optional<CPose2D> newOrigin;
+			size_t other = 0;
+			if (c.session1 == s && !origins[c.session2])
+			{
+				other = c.session2;
+				const CPose2D n2 =
+					*origins[s] + localPose(s, c.node1) + c.pose;
+				newOrigin = n2 + (-localPose(other, c.node2));
+			}
+			else if (c.session2 == s && !origins[c.session1])
+			{
+				other = c.session1;
+				const CPose2D n1 =
+					*origins[s] + localPose(s, c.node2) + (-c.pose);
+				newOrigin = n1 + (-localPose(other, c.node1));
+			}
+			if (!newOrigin) continue;
+			origins[other] = newOrigin;
+			pending.push_back(other);
+		}
+	}
+
+	// 5) Merged graph: intra-session edges as priors + new constraints:
+	// ----------------------------------------------------------------------
+	m_graph.root = m_sessions[0].firstNodeID;
+	size_t nMerged = 0;
+	for (size_t s = 0; s < m_sessions.size(); s++)
+	{
+		if (!origins[s]) continue;
+		TSession& ses = m_sessions[s];
+		ses.merged = true;
+		nMerged++;
+		for (const auto& n : ses.graph.nodes)
+			m_graph.nodes[ses.firstNodeID + n.first] = *origins[s] + n.second;
+		for (const auto& e : ses.graph.edges)
+			m_graph.insertEdge(
+				ses.firstNodeID + e.first.first,
+				ses.firstNodeID + e.first.second, e.second);
+	}
+	size_t nInterEdges = 0;
+	for (const auto& c : m_constraints)
+	{
+		if (!origins[c.session1]) continue;
+		m_graph.insertEdge(
+			c.node1, c.node2,
+			makeEdge(
+				c.pose, options.inter_session_std_xy,
+				options.inter_session_std_phi));
+		nInterEdges++;
+	}
+	MRPT_LOG_INFO_FMT(
+		"Merging %zu out of %zu sessions.", nMerged, m_sessions.size());
+
+	// 6) Joint optimization:
+	// ----------------------------------------------------------------------
+	if (nInterEdges)
+	{
+		mrpt::containers::yaml params;
+		params["max_iterations"] = static_cast<int>(options.max_iterations);
+		params["num_threads"] = static_cast<int>(options.num_threads);
+		optimize_graph_spa_levmarq(m_graph, m_optInfo, nullptr, params);
+		MRPT_LOG_INFO_FMT(
+			"Optimization: %zu iterations, final error=%e", m_optInfo.num_iters,
+			m_optInfo.final_total_sq_error);
+	}
+
+	MRPT_END
+}
+
+void CMultiSessionMapMerger::getMergedSimpleMap(CSimpleMap& out) const
+{
+	out.clear();
+	for (size_t s = 0; s < m_sessions.size(); s++)
+	{
+		const TSession& ses = m_sessions[s];
+		if (!ses.merged) continue;
+		for (size_t k = 0; k < ses.sm.size(); k++)
+		{
+			const auto [pdf, sf] = ses.sm.get(k);
+			out.insert(
+				mrpt::poses::CPosePDFGaussian(
+					m_graph.nodes.at(getGlobalNodeID(s, k))),
+				*sf);
+		}
+	}
+}
+
+CMultiSessionMapMerger::TOptions::TOptions()
+{
+	// Submaps are small, so a global search over all orientations is fast
+	// and does not depend on feature detectors:
+	aligner_options.methodSelection =
+		mrpt::slam::CGridMapAligner::amCorrelation;
+}
+
+void CMultiSessionMapMerger::TOptions::loadFromConfigFile(
+	const mrpt::config::CConfigFileBase& source, const std::string& section)
+{
+	MRPT_LOAD_CONFIG_VAR(submap_num_keyframes, int, source, section);
+	MRPT_LOAD_CONFIG_VAR(grid_resolution, float, source, section);
+	MRPT_LOAD_CONFIG_VAR(max_hypotheses, int, source, section);
+	MRPT_LOAD_CONFIG_VAR(min_icp_goodness, double, source, section);
+	MRPT_LOAD_CONFIG_VAR(inter_session_std_xy, double, source, section);
+	MRPT_LOAD_CONFIG_VAR_DEGREES(inter_session_std_phi, source, section);
+	MRPT_LOAD_CONFIG_VAR(odometry_std_xy, double, source, section);
+	MRPT_LOAD_CONFIG_VAR_DEGREES(odometry_std_phi, source, section);
+	MRPT_LOAD_CONFIG_VAR(num_threads, int, source, section);
+	MRPT_LOAD_CONFIG_VAR(max_iterations, int, source, section);
+
+	aligner_options.loadFromConfigFile(source, section);
+}
+
+void CMultiSessionMapMerger::TOptions::dumpToTextStream(std::ostream& out) const
+{
+	out << "\n----------- [CMultiSessionMapMerger::TOptions] ------------ \n\n";
+
+	LOADABLEOPTS_DUMP_VAR(submap_num_keyframes, int)
+	LOADABLEOPTS_DUMP_VAR(grid_resolution, float)
+	LOADABLEOPTS_DUMP_VAR(max_hypotheses, int)
+	LOADABLEOPTS_DUMP_VAR(min_icp_goodness, double)
+	LOADABLEOPTS_DUMP_VAR(inter_session_std_xy, double)
+	LOADABLEOPTS_DUMP_VAR_DEG(inter_session_std_phi)
+	LOADABLEOPTS_DUMP_VAR(odometry_std_xy, double)
+	LOADABLEOPTS_DUMP_VAR_DEG(odometry_std_phi)
+	LOADABLEOPTS_DUMP_VAR(num_threads, int)
+	LOADABLEOPTS_DUMP_VAR(max_iterations, int)
+
+	aligner_options.dumpToTextStream(out);
+}
@@ -0,0 +1,117 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/graphslam/CMultiSessionMapMerger.h>
+#include <mrpt/maps/COccupancyGridMap2D.h>
+#include <mrpt/math/wrap2pi.h>
+#include <mrpt/obs/CObservation2DRangeScan.h>
+#include <mrpt/poses/CPosePDFGaussian.h>
+
+using mrpt::graphslam::CMultiSessionMapMerger;
+using mrpt::maps::COccupancyGridMap2D;
+using mrpt::maps::CSimpleMap;
+using mrpt::poses::CPose2D;
+
+namespace
+{
+// An asymmetric world, with some rooms:
+COccupancyGridMap2D createWorld()
+{
+	COccupancyGridMap2D world(-1.0f, 13.0f, -1.0f, 9.0f, 0.05f);
+	const double walls[][4] = {
+		{0, 0, 12, 0.2},	 {0, 0, 0.2, 8},	 {11.8, 0, 12, 8},
+		{0, 7.8, 12, 8},	 {4, 0, 4.2, 3},	 {4, 5, 4.2, 8},
+		{8, 2, 8.2, 6},		 {8, 6, 10, 6.2},	 {1.5, 2, 2.5, 2.6},
+		{6, 6.5, 6.4, 7.8},	 {10, 1, 11.8, 1.2}, {2.5, 5.5, 3, 7}};
+	for (unsigned int cy = 0; cy < world.getSizeY(); cy++)
+		for (unsigned int cx = 0; cx < world.getSizeX(); cx++)
+		{
+			const double x = world.idx2x(cx), y = world.idx2y(cy);
+			float p = (x < 0 || y < 0 || x > 12 || y > 8) ? 0.5f : 0.95f;
+			for (const auto& w : walls)
+				if (x >= w[0] && x <= w[2] && y >= w[1] && y <= w[3])
+					p = 0.05f;
+			world.setCell(cx, cy, p);
+		}
+	return world;
+}
+
+// A session along a straight path, with its poses stored in the frame of
+// `sessionOrigin` (unknown to the merger):
+CSimpleMap createSession(
+	const COccupancyGridMap2D& world, const CPose2D& sessionOrigin,
+	const CPose2D& start, const CPose2D& end, size_t nKeyframes)
+{
+	CSimpleMap sm;
+	for (size_t i = 0; i < nKeyframes; i++)
+	{
+		const double t = double(i) / (nKeyframes - 1);
+		const CPose2D truePose(
+			start.x() + t * (end.x() - start.x()),
+			start.y() + t * (end.y() - start.y()),
+			start.phi() + t * mrpt::math::angDistance(start.phi(), end.phi()));
+
+		auto scan = mrpt::obs::CObservation2DRangeScan::Create();
+		scan->aperture = 2 * M_PI;
+		scan->maxRange = 15;
+		world.laserScanSimulator(*scan, truePose, 0.5f, 360);
+
+		mrpt::obs::CSensoryFrame sf;
+		sf.insert(scan);
+		sm.insert(
+			mrpt::poses::CPosePDFGaussian(truePose - sessionOrigin), sf);
+	}
+	return sm;
+}
+}  // namespace
+
+TEST(CMultiSessionMapMerger, TwoSessions)
+{
+	const auto world = createWorld();
+	const CPose2D origin2(5.0, -3.0, mrpt::DEG2RAD(70.0));
+
+	// The world frame is the one of the first session:
+	const CSimpleMap sm1 = createSession(
+		world, CPose2D(), CPose2D(1, 4, 0), CPose2D(7, 4, 0.5), 20);
+	const CSimpleMap sm2 = createSession(
+		world, origin2, CPose2D(10, 4, M_PI), CPose2D(2, 4, 2.5), 20);
+
+	CMultiSessionMapMerger merger;
+	merger.options.submap_num_keyframes = 10;
+	merger.options.num_threads = 2;
+	EXPECT_EQ(merger.addSession(sm1), 0U);
+	EXPECT_EQ(merger.addSession(sm2), 1U);
+	EXPECT_EQ(merger.getGlobalNodeID(1, 3), 23U);
+	EXPECT_ANY_THROW(merger.addSession(CSimpleMap()));
+
+	merger.merge();
+
+	EXPECT_FALSE(merger.getInterSessionConstraints().empty());
+	EXPECT_TRUE(merger.isSessionMerged(0));
+	EXPECT_TRUE(merger.isSessionMerged(1));
+
+	const auto& g = merger.getMergedGraph();
+	EXPECT_EQ(g.nodes.size(), sm1.size() + sm2.size());
+	for (size_t k = 0; k < sm2.size(); k++)
+	{
+		const auto [pdf, sf] = sm2.get(k);
+		const CPose2D truePose = origin2 + CPose2D(pdf->getMeanVal());
+		const CPose2D& p = g.nodes.at(merger.getGlobalNodeID(1, k));
+		EXPECT_NEAR(p.x(), truePose.x(), 0.1);
+		EXPECT_NEAR(p.y(), truePose.y(), 0.1);
+		EXPECT_NEAR(
+			mrpt::math::angDistance(p.phi(), truePose.phi()), 0,
+			mrpt::DEG2RAD(2.0));
+	}
+
+	CSimpleMap merged;
+	merger.getMergedSimpleMap(merged);
+	EXPECT_EQ(merged.size(), sm1.size() + sm2.size());
+}
@@ -0,0 +1,165 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "graphslam-precomp.h"	// Precompiled headers
+//
+#include <mrpt/graphslam/misc/CScanDescriptorIndex.h>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace mrpt::graphslam;
+using mrpt::graphs::TNodeID;
+
+CScanDescriptorIndex::CScanDescriptorIndex(
+	unsigned int num_rings, double max_range)
+	: m_num_rings(num_rings), m_max_range(max_range)
+{
+	ASSERT_ABOVE_(num_rings, 0U);
+	ASSERT_GE_(max_range, 0.0);
+}
+
+void CScanDescriptorIndex::computeDescriptor(
+	const mrpt::obs::CObservation2DRangeScan& scan, descriptor_t& desc,
+	unsigned int num_rings, double max_range)
+{
+	ASSERT_ABOVE_(num_rings, 0U);
+	desc.assign(num_rings, .0f);
+
+	const double maxR = max_range > 0 ? max_range : scan.maxRange;
+	if (maxR <= 0) return;
+
+	// Ranges are assigned to the two nearest ring centers, at
+	// (i+0.5)*maxR/num_rings, with linear weights:
+	const double k = num_rings / maxR;
+	const int lastRing = static_cast<int>(num_rings) - 1;
+	size_t nValid = 0;
+	for (size_t i = 0; i < scan.getScanSize(); i++)
+	{
+		if (!scan.getScanRangeValidity(i)) continue;
+		const double r = scan.getScanRange(i);
+		if (r <= 0 || r > maxR) continue;
+
+		const double t = r * k - 0.5;
+		const int i0 = static_cast<int>(std::floor(t));
+		const float w = static_cast<float>(t - i0);
+		desc[std::clamp(i0, 0, lastRing)] += 1.0f - w;
+		desc[std::clamp(i0 + 1, 0, lastRing)] += w;
+		nValid++;
+	}
+	if (!nValid) return;
+
+	const float norm = 1.0f / nValid;
+	for (auto& v : desc)
+		v *= norm;
+}
+
+float CScanDescriptorIndex::descriptorDistanceSqr(
+	const descriptor_t& a, const descriptor_t& b)
+{
+	ASSERT_EQUAL_(a.size(), b.size());
+	float d = 0;
+	for (size_t i = 0; i < a.size(); i++)
+	{
+		const float di = a[i] - b[i];
+		d += di * di;
+	}
+	return d;
+}
+
+void CScanDescriptorIndex::insert(const TNodeID id, const descriptor_t& desc)
+{
+	ASSERT_EQUAL_(desc.size(), static_cast<size_t>(m_num_rings));
+	ASSERTMSG_(!contains(id), "Node is already in the descriptor index");
+
+	m_id2idx[id] = m_ids.size();
+	m_ids.push_back(id);
+	m_descs.insert(m_descs.end(), desc.begin(), desc.end());
+}
+
+void CScanDescriptorIndex::insert(
+	const TNodeID id, const mrpt::obs::CObservation2DRangeScan& scan)
+{
+	descriptor_t desc;
+	computeDescriptor(scan, desc);
+	insert(id, desc);
+}
+
+void CScanDescriptorIndex::updateKDTree() const
+{
+	std::lock_guard<std::mutex> lck(m_kdtree_mtx);
+	const size_t N = m_ids.size();
+	if (m_kdtree && m_num_indexed == N) return;
+
+	if (!m_kdtree)
+	{
+		// (The dynamic index adds all existing points in its ctor)
+		m_kdtree = std::make_unique<kdtree_t>(
+			static_cast<int>(m_num_rings), *this,
+			nanoflann::KDTreeSingleIndexAdaptorParams(10));
+	}
+	else
+	{
+		// Incremental update: only add the new descriptors:
+		m_kdtree->addPoints(m_num_indexed, N - 1);
+	}
+	m_num_indexed = N;
+}
+
+std::vector<std::pair<TNodeID, float>> CScanDescriptorIndex::query(
+	const descriptor_t& desc, size_t k) const
+{
+	ASSERT_EQUAL_(desc.size(), static_cast<size_t>(m_num_rings));
+
+	std::vector<std::pair<TNodeID, float>> res;
+	k = std::min(k, m_ids.size());
+	if (!k) return res;
+
+	updateKDTree();
+
+	std::vector<size_t> idxs(k);
+	std::vector<float> distSqr(k);
+	nanoflann::KNNResultSet<float> resultSet(k);
+	resultSet.init(idxs.data(), distSqr.data());
+	m_kdtree->findNeighbors(resultSet, desc.data(), nanoflann::SearchParams());
+
+	const size_t nFound = resultSet.size();
+	res.reserve(nFound);
+	for (size_t i = 0; i < nFound; i++)
+		res.emplace_back(m_ids[idxs[i]], distSqr[i]);
+	return res;
+}
+
+std::vector<std::pair<TNodeID, float>> CScanDescriptorIndex::query(
+	const mrpt::obs::CObservation2DRangeScan& scan, size_t k) const
+{
+	descriptor_t desc;
+	computeDescriptor(scan, desc);
+	return query(desc, k);
+}
+
+bool CScanDescriptorIndex::getDescriptor(
+	const TNodeID id, descriptor_t& desc) const
+{
+	const auto it = m_id2idx.find(id);
+	if (it == m_id2idx.end()) return false;
+	const auto first = m_descs.begin() + it->second * m_num_rings;
+	desc.assign(first, first + m_num_rings);
+	return true;
+}
+
+void CScanDescriptorIndex::clear()
+{
+	std::lock_guard<std::mutex> lck(m_kdtree_mtx);
+	m_ids.clear();
+	m_descs.clear();
+	m_id2idx.clear();
+	m_kdtree.reset();
+	m_num_indexed = 0;
+}
@@ -0,0 +1,163 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/graphslam/misc/CScanDescriptorIndex.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+using mrpt::graphs::TNodeID;
+using mrpt::graphslam::CScanDescriptorIndex;
+using mrpt::obs::CObservation2DRangeScan;
+
+namespace
+{
+struct TPlace
+{
+	double w, h;  // room size
+	double x, y;  // sensor position in the room
+};
+
+// 360 deg scan from within a rectangular room [0,w]x[0,h], with the first
+// ray at `heading`:
+CObservation2DRangeScan scanOfPlace(
+	const TPlace& p, double heading, double noise, std::mt19937& rng)
+{
+	std::normal_distribution<double> n(0, 1);
+	const size_t N = 360;
+	CObservation2DRangeScan scan;
+	scan.aperture = 2 * M_PI;
+	scan.maxRange = 30;
+	scan.resizeScan(N);
+	for (size_t i = 0; i < N; i++)
+	{
+		const double a = heading + 2 * M_PI * i / N;
+		const double c = std::cos(a), s = std::sin(a);
+		double r = 1e9;
+		if (c > 1e-9) r = std::min(r, (p.w - p.x) / c);
+		if (c < -1e-9) r = std::min(r, -p.x / c);
+		if (s > 1e-9) r = std::min(r, (p.h - p.y) / s);
+		if (s < -1e-9) r = std::min(r, -p.y / s);
+		r += noise * n(rng);
+		scan.setScanRange(i, static_cast<float>(r));
+		scan.setScanRangeValidity(i, r > 0 && r < scan.maxRange);
+	}
+	return scan;
+}
+
+std::vector<TPlace> randomPlaces(size_t n, std::mt19937& rng)
+{
+	std::uniform_real_distribution<double> size(2.0, 20.0), u(0.1, 0.9);
+	std::vector<TPlace> places;
+	for (size_t i = 0; i < n; i++)
+	{
+		TPlace p;
+		p.w = size(rng);
+		p.h = size(rng);
+		p.x = p.w * u(rng);
+		p.y = p.h * u(rng);
+		places.push_back(p);
+	}
+	return places;
+}
+}  // namespace
+
+TEST(CScanDescriptorIndex, RotationInvariance)
+{
+	std::mt19937 rng(1);
+	const auto places = randomPlaces(10, rng);
+
+	for (const auto& p : places)
+	{
+		// Rotations by a multiple of the beam step only permute the ranges:
+		CScanDescriptorIndex::descriptor_t d1, d2;
+		CScanDescriptorIndex::computeDescriptor(
+			scanOfPlace(p, 0, 0, rng), d1, 20);
+		CScanDescriptorIndex::computeDescriptor(
+			scanOfPlace(p, 2 * M_PI * 97 / 360, 0, rng), d2, 20);
+
+		ASSERT_EQ(d1.size(), 20U);
+		float sum = 0;
+		for (const float v : d1)
+			sum += v;
+		EXPECT_NEAR(sum, 1.0f, 1e-4f);
+		EXPECT_LT(CScanDescriptorIndex::descriptorDistanceSqr(d1, d2), 1e-8f);
+	}
+
+	// No valid ranges:
+	CObservation2DRangeScan empty;
+	empty.maxRange = 10;
+	CScanDescriptorIndex::descriptor_t d;
+	CScanDescriptorIndex::computeDescriptor(empty, d, 8);
+	EXPECT_EQ(d, CScanDescriptorIndex::descriptor_t(8, .0f));
+}
+
+TEST(CScanDescriptorIndex, RetrievePlaces)
+{
+	std::mt19937 rng(2);
+	std::uniform_real_distribution<double> heading(-M_PI, M_PI);
+	const size_t nPlaces = 300;
+	const auto places = randomPlaces(nPlaces, rng);
+
+	CScanDescriptorIndex index(32, 30.0);
+	for (size_t i = 0; i < nPlaces; i++)
+		index.insert(i, scanOfPlace(places[i], heading(rng), 0, rng));
+	EXPECT_EQ(index.size(), nPlaces);
+	EXPECT_TRUE(index.contains(0));
+	EXPECT_FALSE(index.contains(nPlaces));
+	EXPECT_ANY_THROW(index.insert(0, scanOfPlace(places[0], 0, 0, rng)));
+
+	const size_t k = 5;
+	size_t nTop1 = 0, nTopK = 0;
+	for (size_t i = 0; i < nPlaces; i++)
+	{
+		// Revisit with another heading and noisy ranges:
+		CScanDescriptorIndex::descriptor_t q;
+		index.computeDescriptor(
+			scanOfPlace(places[i], heading(rng), 0.01, rng), q);
+		const auto res = index.query(q, k);
+		ASSERT_EQ(res.size(), k);
+
+		// Same result than a linear search:
+		std::vector<std::pair<float, TNodeID>> all;
+		for (size_t j = 0; j < nPlaces; j++)
+		{
+			CScanDescriptorIndex::descriptor_t dj;
+			ASSERT_TRUE(index.getDescriptor(j, dj));
+			all.emplace_back(
+				CScanDescriptorIndex::descriptorDistanceSqr(q, dj), j);
+		}
+		std::sort(all.begin(), all.end());
+		for (size_t j = 0; j < k; j++)
+		{
+			EXPECT_NEAR(res[j].second, all[j].first, 1e-6f);
+			if (j > 0) { EXPECT_GE(res[j].second, res[j - 1].second); }
+		}
+
+		if (res[0].first == i) nTop1++;
+		for (const auto& r : res)
+			if (r.first == i) nTopK++;
+	}
+	EXPECT_GT(nTop1, nPlaces * 8 / 10);
+	EXPECT_GT(nTopK, nPlaces * 95 / 100);
+
+	// New nodes are found after the first query:
+	index.insert(nPlaces, scanOfPlace(places[7], 0.3, 0, rng));
+	const auto res = index.query(scanOfPlace(places[7], 1.0, 0, rng), 2);
+	ASSERT_EQ(res.size(), 2U);
+	EXPECT_TRUE(
+		(res[0].first == 7 && res[1].first == nPlaces) ||
+		(res[0].first == nPlaces && res[1].first == 7));
+
+	index.clear();
+	EXPECT_TRUE(index.empty());
+	EXPECT_TRUE(index.query(CScanDescriptorIndex::descriptor_t(32), 3).empty());
+}
@@ -8,6 +8,7 @@
    +------------------------------------------------------------------------+ */
 
 #include <gtest/gtest.h>
+#include <mrpt/graphslam/CIncrementalSmoother.h>
 #include <mrpt/serialization/CArchive.h>
 #include <mrpt/system/filesystem.h>
 #include <test_mrpt_common.h>
@@ -77,6 +78,183 @@ class GraphTester : public GraphSlamLevMarqTest<my_graph_t>,
 
 	}  // end test_ring_path
 
+	void test_cholesky_cache()
+	{
+		my_graph_t graph;
+		GraphSlamLevMarqTest<my_graph_t>::create_ring_path(graph);
+		my_graph_t graph_cached = graph;
+
+		mrpt::containers::yaml params;
+		params["max_iterations"] = 100;
+
+		graphslam::TResultInfoSpaLevMarq levmarq_info;
+		graphslam::optimize_graph_spa_levmarq(
+			graph, levmarq_info, nullptr, params);
+
+		// Same problem, reusing the symbolic factorization:
+		graphslam::TSparseCholeskyCache cache;
+		using feedback_t =
+			typename graphslam::graphslam_traits<my_graph_t>::TFunctorFeedback;
+		graphslam::optimize_graph_spa_levmarq(
+			graph_cached, levmarq_info, nullptr, params, feedback_t(), &cache);
+		EXPECT_EQ(cache.num_symbolic_factorizations, 1U);
+		EXPECT_GE(cache.num_numeric_factorizations, 1U);
+		compare_two_graphs(graph, graph_cached, 1e-6, 1e-6);
+
+		// The structure is unchanged in a subsequent call: numeric only.
+		for (auto& n : graph_cached.nodes)
+			if (n.first != graph_cached.root) n.second.x_incr(0.1);
+		const auto nNumeric = cache.num_numeric_factorizations;
+		graphslam::optimize_graph_spa_levmarq(
+			graph_cached, levmarq_info, nullptr, params, feedback_t(), &cache);
+		EXPECT_EQ(cache.num_symbolic_factorizations, 1U);
+		EXPECT_GT(cache.num_numeric_factorizations, nNumeric);
+	}
+
+	void test_parallel_evaluation()
+	{
+		my_graph_t graph;
+		GraphSlamLevMarqTest<my_graph_t>::create_ring_path(graph);
+		my_graph_t graph_mt = graph;
+
+		mrpt::containers::yaml params;
+		params["max_iterations"] = 100;
+		graphslam::TResultInfoSpaLevMarq levmarq_info, levmarq_info_mt;
+		graphslam::optimize_graph_spa_levmarq(
+			graph, levmarq_info, nullptr, params);
+
+		// Same problem, with the edges split among several threads:
+		params["num_threads"] = 4;
+		graphslam::optimize_graph_spa_levmarq(
+			graph_mt, levmarq_info_mt, nullptr, params);
+		EXPECT_EQ(levmarq_info.num_iters, levmarq_info_mt.num_iters);
+		compare_two_graphs(graph, graph_mt, 1e-6, 1e-9);
+	}
+
+	void test_incremental_smoother()
+	{
+		my_graph_t graph;
+		GraphSlamLevMarqTest<my_graph_t>::create_ring_path(graph);
+
+		my_graph_t graph_batch = graph;
+		mrpt::containers::yaml params;
+		params["max_iterations"] = 100;
+		graphslam::TResultInfoSpaLevMarq levmarq_info;
+		graphslam::optimize_graph_spa_levmarq(
+			graph_batch, levmarq_info, nullptr, params);
+
+		// Feed the same graph node by node, with the edges to older nodes:
+		my_graph_t graph_inc;
+		graph_inc.root = graph.root;
+		graphslam::CIncrementalSmoother<my_graph_t> smoother;
+		typename graphslam::CIncrementalSmoother<my_graph_t>::TUpdateInfo ui;
+		for (const auto& n : graph.nodes)
+		{
+			graph_inc.nodes[n.first] = n.second;
+			TNodeID oldest = n.first;
+			for (const auto& e : graph.edges)
+			{
+				const auto [from, to] = e.first;
+				if (std::max(from, to) != n.first) continue;
+				graph_inc.insertEdge(from, to, e.second);
+				if (std::min(from, to) != graph.root)
+					oldest = std::min(oldest, std::min(from, to));
+			}
+			smoother.update(graph_inc, &ui);
+			if (n.first == graph.root) continue;
+			EXPECT_EQ(ui.new_nodes, 1U);
+			// Only nodes from the oldest one linked by the new edges on are
+			// eliminated again (all but the root, in chronological order):
+			if (ui.relinearized_nodes == 0)
+			{ EXPECT_EQ(ui.reeliminated_nodes, n.first - oldest + 1); }
+		}
+		EXPECT_EQ(smoother.edgeCount(), graph.edges.size());
+		EXPECT_EQ(smoother.nodeCount(), graph.nodes.size() - 1);
+
+		// No changes: nothing to do, until the next relinearization.
+		smoother.options.relinearize_skip = 1000;
+		smoother.update(graph_inc, &ui);
+		EXPECT_EQ(ui.updated_nodes, 0U);
+
+		for (int i = 0; i < 10; i++)
+			smoother.relinearizeAll(graph_inc, &ui);
+		EXPECT_LT(graph_inc.chi2(), graph.chi2());
+		EXPECT_NEAR(graph_inc.chi2(), graph_batch.chi2(), 1e-3);
+		compare_two_graphs(graph_inc, graph_batch, 1e-2, 1e-9);
+	}
+
+	void test_marginalization()
+	{
+		my_graph_t graph;
+		GraphSlamLevMarqTest<my_graph_t>::create_ring_path(graph);
+		mrpt::containers::yaml params;
+		params["max_iterations"] = 100;
+		graphslam::TResultInfoSpaLevMarq levmarq_info;
+		graphslam::optimize_graph_spa_levmarq(
+			graph, levmarq_info, nullptr, params);
+
+		// Marginalize the oldest nodes at the optimum, in one or two steps:
+		std::set<TNodeID> old1, old2, old_all, window;
+		for (const auto& n : graph.nodes)
+		{
+			if (n.first < 20) old1.insert(n.first);
+			else if (n.first < 35)
+				old2.insert(n.first);
+			else
+				window.insert(n.first);
+		}
+		old_all = old1;
+		old_all.insert(old2.begin(), old2.end());
+
+		graphslam::TMarginalizationPrior<my_graph_t> prior, prior_one_step;
+		graphslam::marginalize_graph_nodes(graph, old1, prior);
+		graphslam::marginalize_graph_nodes(graph, old2, prior);
+		graphslam::marginalize_graph_nodes(graph, old_all, prior_one_step);
+
+		EXPECT_EQ(prior.marginalized_nodes.size(), old_all.size() - 1);
+		EXPECT_EQ(prior.nodes, prior_one_step.nodes);
+		EXPECT_FALSE(prior.nodes.empty());
+		for (const auto id : prior.nodes)
+			EXPECT_TRUE(window.count(id));
+		EXPECT_NEAR(
+			(prior.H.asEigen() - prior_one_step.H.asEigen()).norm(), 0,
+			1e-6 * prior.H.asEigen().norm());
+		// At the optimum, the prior has no gradient:
+		EXPECT_NEAR(prior.b.asEigen().norm(), 0, 1e-3);
+
+		// New, inconsistent, information in the window pulls all the nodes:
+		auto itEdge = graph.edges.begin();
+		while (!window.count(itEdge->first.first))
+			++itEdge;
+		auto new_edge = itEdge->second;
+		if constexpr (my_graph_t::edge_t::is_PDF()) new_edge.mean.x_incr(0.05);
+		else
+			new_edge.x_incr(0.05);
+		graph.insertEdge(itEdge->first.first, itEdge->first.second, new_edge);
+
+		my_graph_t graph_batch = graph, graph_marg = graph, graph_fixed = graph;
+		using feedback_t =
+			typename graphslam::graphslam_traits<my_graph_t>::TFunctorFeedback;
+		graphslam::optimize_graph_spa_levmarq(
+			graph_batch, levmarq_info, nullptr, params);
+		graphslam::optimize_graph_spa_levmarq(
+			graph_marg, levmarq_info, &window, params, feedback_t(), nullptr,
+			&prior);
+		graphslam::optimize_graph_spa_levmarq(
+			graph_fixed, levmarq_info, &window, params);
+
+		// Marginalizing gets much closer to the full solution than just
+		// fixing the old nodes:
+		double err_marg = 0, err_fixed = 0;
+		for (const auto id : window)
+		{
+			const auto p = graph_batch.nodes[id].asVectorVal();
+			err_marg += (graph_marg.nodes[id].asVectorVal() - p).sum_abs();
+			err_fixed += (graph_fixed.nodes[id].asVectorVal() - p).sum_abs();
+		}
+		EXPECT_LT(err_marg, 0.2 * err_fixed);
+	}
+
 	void compare_two_graphs(
 		const my_graph_t& g1, const my_graph_t& g2,
 		const double eps_node_pos = 1e-3, const double eps_edges = 1e-3)
@@ -235,6 +413,26 @@ using GraphTester3DInf = GraphTester<CNetworkOfPoses3DInf>;
 	TEST_F(_TYPE, OptimizeCompareKnownSolution)                                \
 	{                                                                          \
 		test_optimize_compare_known_solution(#_TYPE);                          \
+	}                                                                          \
+	TEST_F(_TYPE, ReuseCholeskySymbolic)                                       \
+	{                                                                          \
+		getRandomGenerator().randomize(123);                                   \
+		test_cholesky_cache();                                                 \
+	}                                                                          \
+	TEST_F(_TYPE, ParallelEvaluation)                                          \
+	{                                                                          \
+		getRandomGenerator().randomize(123);                                   \
+		test_parallel_evaluation();                                            \
+	}                                                                          \
+	TEST_F(_TYPE, IncrementalSmoother)                                         \
+	{                                                                          \
+		getRandomGenerator().randomize(123);                                   \
+		test_incremental_smoother();                                           \
+	}                                                                          \
+	TEST_F(_TYPE, SlidingWindowMarginalization)                                \
+	{                                                                          \
+		getRandomGenerator().randomize(123);                                   \
+		test_marginalization();                                                \
 	}
 
 GRAPHS_TESTS(GraphTester2D)
@@ -15,6 +15,7 @@
 #include <mrpt/system/datetime.h>
 
 #include <mutex>
+#include <vector>
 
 namespace mrpt::gui
 {
@@ -85,6 +86,22 @@ class CMyGLCanvas_DisplayWindow3D;
  *   } // scene is unlocked upon dtor of `locker`
  * \endcode
  *
+ * Scenes that take long to build or update can also be prepared without
+ * holding any lock, and then committed with commitScene(): the render thread
+ * swaps them in at the beginning of the next frame, so it never waits for the
+ * producer. To apply small changes to the current scene, modify a shallow
+ * copy of it obtained with getSceneSnapshot():
+ * \code
+ *   mrpt::gui::CDisplayWindow3D	win("My window");
+ *   // ...
+ *   auto scene = win.getSceneSnapshot();  // shares the 3D objects
+ *   // Replace (do not modify in place) objects shared with the window, or
+ *   // insert new ones:
+ *   scene->removeObject(oldObj);
+ *   scene->insert(newObj);
+ *   win.commitScene(scene);
+ * \endcode
+ *
  * Notice however that a copy of the smart pointer is made, so replacement of
  * the entire scene via `operator =` is not possible if using this method.
  * Instead, the content of the scene should be assigned using the `operator =`
@@ -124,6 +141,20 @@ class CDisplayWindow3D : public mrpt::gui::CBaseGUIWindow
 	/** Critical section for accessing m_3Dscene */
 	mutable std::recursive_timed_mutex m_csAccess3DScene;
 
+	/** The last scene passed to commitScene() not swapped in yet (or
+	 * nullptr), and the replaced scenes, to be released by the render thread
+	 * so their OpenGL resources are freed in the right context. Both are
+	 * protected by m_nextSceneMtx. */
+	mrpt::opengl::COpenGLScene::Ptr m_nextScene;
+	std::vector<mrpt::opengl::COpenGLScene::Ptr> m_replacedScenes;
+	mutable std::mutex m_nextSceneMtx;
+
+	/** Swaps in the pending committed scene, if any. Must be called with
+	 * m_csAccess3DScene locked. */
+	void internal_applyCommittedScene();
+	/** Releases the replaced scenes (called from the render thread) */
+	void internal_releaseReplacedScenes();
+
 	/** Throws an exception on initialization error */
 	void createOpenGLContext();
 
@@ -175,6 +206,39 @@ class CDisplayWindow3D : public mrpt::gui::CBaseGUIWindow
 	 */
 	void unlockAccess3DScene();
 
+	/** Replaces the scene of the window by `scene`, without waiting for the
+	 * render thread: the scene is swapped in at the beginning of the next
+	 * frame (if several scenes are committed before that, only the last one is
+	 * shown). The caller must not modify `scene` after this call, build the
+	 * next one instead, e.g. from getSceneSnapshot().
+	 *
+	 * GPU buffers of new or modified objects are uploaded by the render
+	 * thread while drawing the next frame, once per object no matter how many
+	 * times it changed since the last frame. Objects shared with the previous
+	 * scene keep their buffers.
+	 *
+	 * \param repaint If true, forceRepaint() is called.
+	 * \sa getSceneSnapshot, hasPendingScene
+	 * \note (New in MRPT 2.4.9)
+	 */
+	void commitScene(
+		const mrpt::opengl::COpenGLScene::Ptr& scene, bool repaint = true);
+
+	/** Returns a new scene with copies of the viewports of the last committed
+	 * scene (or the current one), sharing their 3D objects, to be modified
+	 * and passed to commitScene(). The scene lock is only held while copying
+	 * the viewports. Objects shared with the window must be replaced instead
+	 * of modified in place, since the render thread may be drawing them.
+	 * \note (New in MRPT 2.4.9)
+	 */
+	mrpt::opengl::COpenGLScene::Ptr getSceneSnapshot();
+
+	/** Whether a scene passed to commitScene() has not been swapped in by the
+	 * render thread yet.
+	 * \note (New in MRPT 2.4.9)
+	 */
+	bool hasPendingScene() const;
+
 	/** Repaints the window. forceRepaint, repaint and updateWindow are all
 	 * aliases of the same method */
 	void forceRepaint();
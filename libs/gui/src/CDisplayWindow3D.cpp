@@ -196,6 +196,10 @@ void CMyGLCanvas_DisplayWindow3D::OnPreRender()
 
 	COpenGLScene::Ptr& ptrScene = m_win3D->get3DSceneAndLock();
 	if (ptrScene) openGLSceneRef = ptrScene;
+
+	// Free the OpenGL resources of scenes replaced via commitScene() here,
+	// with our GL context being the current one:
+	m_win3D->internal_releaseReplacedScenes();
 }
 
 void CMyGLCanvas_DisplayWindow3D::OnPostRender()
@@ -474,11 +478,56 @@ void CDisplayWindow3D::setWindowTitle([[maybe_unused]] const std::string& str)
 opengl::COpenGLScene::Ptr& CDisplayWindow3D::get3DSceneAndLock()
 {
 	m_csAccess3DScene.lock();
+	internal_applyCommittedScene();
 	return m_3Dscene;
 }
 
 void CDisplayWindow3D::unlockAccess3DScene() { m_csAccess3DScene.unlock(); }
 
+void CDisplayWindow3D::commitScene(
+	const mrpt::opengl::COpenGLScene::Ptr& scene, bool repaint)
+{
+	ASSERT_(scene);
+	{
+		std::lock_guard<std::mutex> lck(m_nextSceneMtx);
+		// A previous scene not shown yet is just dropped:
+		if (m_nextScene) m_replacedScenes.push_back(std::move(m_nextScene));
+		m_nextScene = scene;
+	}
+	if (repaint) forceRepaint();
+}
+
+mrpt::opengl::COpenGLScene::Ptr CDisplayWindow3D::getSceneSnapshot()
+{
+	std::lock_guard<std::recursive_timed_mutex> lck(m_csAccess3DScene);
+	internal_applyCommittedScene();
+	return std::make_shared<COpenGLScene>(*m_3Dscene);
+}
+
+bool CDisplayWindow3D::hasPendingScene() const
+{
+	std::lock_guard<std::mutex> lck(m_nextSceneMtx);
+	return m_nextScene != nullptr;
+}
+
+void CDisplayWindow3D::internal_applyCommittedScene()
+{
+	std::lock_guard<std::mutex> lck(m_nextSceneMtx);
+	if (!m_nextScene) return;
+	m_replacedScenes.push_back(std::move(m_3Dscene));
+	m_3Dscene = std::move(m_nextScene);
+}
+
+void CDisplayWindow3D::internal_releaseReplacedScenes()
+{
+	std::vector<COpenGLScene::Ptr> toRelease;
+	{
+		std::lock_guard<std::mutex> lck(m_nextSceneMtx);
+		toRelease.swap(m_replacedScenes);
+	}
+	// Scenes are destroyed here, unless still referenced by the user.
+}
+
 void CDisplayWindow3D::forceRepaint()
 {
 #if MRPT_HAS_WXWIDGETS && MRPT_HAS_OPENGL_GLUT
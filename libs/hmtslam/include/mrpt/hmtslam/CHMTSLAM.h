@@ -22,10 +22,17 @@
 #include <mrpt/slam/TKLDParams.h>
 #include <mrpt/system/COutputLogger.h>
 
+#include <functional>
 #include <map>
+#include <memory>
 #include <queue>
 #include <thread>
 
+namespace mrpt
+{
+class WorkerThreadsPool;
+}
+
 namespace mrpt
 {
 /** Classes related to the implementation of Hybrid Metric Topological (HMT)
@@ -264,6 +271,20 @@ class CHMTSLAM : public mrpt::system::COutputLogger,
 	void thread_3D_viewer();
 	/** Threads handles */
 	std::thread m_hThread_LSLAM, m_hThread_TBI, m_hThread_3D_viewer;
+
+	/** Worker threads for the particles of each LMH and the topological
+	 * loop-closure detectors, created on demand. \sa runInParallel() */
+	std::shared_ptr<mrpt::WorkerThreadsPool> m_threadPool;
+
+	/** Runs `f(i0,i1)` for contiguous blocks `[i0,i1)` which split the range
+	 * `[0,N)`, in parallel with `numThreads` threads (0=all hardware
+	 * threads), or just `f(0,N)` in the calling thread for numThreads=1.
+	 * Exceptions thrown by `f` are re-thrown in the calling thread.
+	 * Only called from the LSLAM thread.
+	 * \note (New in MRPT 2.4.9) */
+	void runInParallel(
+		unsigned int numThreads, size_t N,
+		const std::function<void(size_t, size_t)>& f);
 	/** @} */
 
 	/** @name HMT-SLAM sub-processes.
@@ -506,6 +527,14 @@ class CHMTSLAM : public mrpt::system::COutputLogger,
 		/** Options passed to this TLC constructor */
 		CTopLCDetector_FabMap::TOptions TLC_fabmap_options;
 
+		/** [TBI] Number of threads to evaluate the topological loop-closure
+		 * detectors on the candidate areas (0: all hardware threads).
+		 * Results do not depend on the number of threads.
+		 * The threads for the particles of each LMH are set with
+		 * pf_options.numThreads instead. (Default=1: single thread).
+		 * \note (New in MRPT 2.4.9) */
+		unsigned int TLC_num_threads{1};
+
 	} m_options;
 
 };	// End of class CHMTSLAM.
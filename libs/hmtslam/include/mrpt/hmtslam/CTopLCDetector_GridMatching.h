@@ -66,5 +66,12 @@ class CTopLCDetector_GridMatching : public CTopLCDetectorBase
 		void dumpToTextStream(
 			std::ostream& out) const override;	// See base docs
 	};
+
+   protected:
+	/** Shared by all the grid alignments, so the features of each area grid
+	 * are only extracted again after the area changes.
+	 * \note (New in MRPT 2.4.9) */
+	std::shared_ptr<mrpt::slam::COccupancyGridMapFeatureExtractor>
+		m_grid_feat_extr;
 };	// end class
 }  // namespace mrpt::hmtslam
@@ -846,17 +846,15 @@ void CLSLAM_RBPF_2DLASER::prediction_and_update_pfOptimalProposal(
 	// ----------------------------------------------------------------------
 
 	// ICP used if "pfOptimalProposal_mapSelection" = 0 or 1
-	CICP icp;
-	CICP::TReturnInfo icpInfo;
-
 	// ICP options
 	// ------------------------------
-	icp.options.maxIterations = 80;
-	icp.options.thresholdDist = 0.50f;
-	icp.options.thresholdAng = 20.0_deg;
-	icp.options.smallestThresholdDist = 0.05f;
-	icp.options.ALFA = 0.5f;
-	icp.options.doRANSAC = false;
+	CICP::TConfigParams icpOptions;
+	icpOptions.maxIterations = 80;
+	icpOptions.thresholdDist = 0.50f;
+	icpOptions.thresholdAng = 20.0_deg;
+	icpOptions.smallestThresholdDist = 0.05f;
+	icpOptions.ALFA = 0.5f;
+	icpOptions.doRANSAC = false;
 
 	// Build the map of points to align:
 	CSimplePointsMap localMapPoints;
@@ -874,48 +872,60 @@ void CLSLAM_RBPF_2DLASER::prediction_and_update_pfOptimalProposal(
 	const size_t M = LMH->m_particles.size();
 	LMH->m_log_w_metric_history.resize(M);
 
-	for (size_t i = 0; i < M; i++)
+	// The first robot pose in the SLAM execution: All m_particles start
+	// at the same point (this is the lowest bound of subsequent
+	// uncertainty):
+	// New pose = old pose.
+	// part_pose: Unmodified
+	if (!LMH->m_SFs.empty())
 	{
-		CLocalMetricHypothesis::CParticleData& part = LMH->m_particles[i];
-		CPose3D* part_pose = LMH->getCurrentPose(i);
-
-		if (LMH->m_SFs.empty())
-		{
-			// The first robot pose in the SLAM execution: All m_particles start
-			// at the same point (this is the lowest bound of subsequent
-			// uncertainty):
-			// New pose = old pose.
-			// part_pose: Unmodified
-		}
-		else
+		// 1) ICP of the local map against each particle map. This is the
+		// costly part, done in parallel: each block of particles uses its own
+		// ICP object and local map, since alignment updates their caches.
+		std::vector<CPosePDFGaussian> icpEstimations(M);
+		m_parent->runInParallel(
+			PF_options.numThreads, M, [&](size_t i0, size_t i1) {
+				CICP icp;
+				icp.options = icpOptions;
+				CICP::TReturnInfo info;
+				const CSimplePointsMap localPts(localMapPoints);
+
+				for (size_t i = i0; i < i1; i++)
+				{
+					// Select map to use with ICP:
+					CMetricMap* mapalign;
+					auto& mMap = LMH->m_particles[i].d->metricMaps;
+
+					if (auto pPts = mMap.mapByClass<CSimplePointsMap>(); pPts)
+						mapalign = pPts.get();
+					else if (auto pGrid = mMap.mapByClass<COccupancyGridMap2D>();
+							 pGrid)
+						mapalign = pGrid.get();
+					else
+						THROW_EXCEPTION(
+							"There is no point or grid map. At least one "
+							"needed for ICP.");
+
+					// Use ICP to align to each particle's map:
+					CPosePDF::Ptr alignEst = icp.Align(
+						mapalign, &localPts, initialPoseEstimation, info);
+
+					icpEstimations[i].copyFrom(*alignEst);
+				}
+			});
+
+		// 2) Generate gaussian-distributed 2D-pose increments according to
+		// the ICP estimation. The random generator is not thread-safe, so
+		// this is done sequentially, in the same order as always:
+		// -------------------------------------------------------------------
+		std::vector<CPose2D> newPoses2D(M);
+		for (size_t i = 0; i < M; i++)
 		{
-			// ICP and add noise:
-			CPosePDFGaussian icpEstimation;
-
-			// Select map to use with ICP:
-			CMetricMap* mapalign;
-			auto& mMap = part.d->metricMaps;
-
-			if (auto pPts = mMap.mapByClass<CSimplePointsMap>(); pPts)
-				mapalign = pPts.get();
-			else if (auto pGrid = mMap.mapByClass<COccupancyGridMap2D>(); pGrid)
-				mapalign = pGrid.get();
-			else
-				THROW_EXCEPTION(
-					"There is no point or grid map. At least one needed for "
-					"ICP.");
-
-			// Use ICP to align to each particle's map:
-			CPosePDF::Ptr alignEst = icp.Align(
-				mapalign, &localMapPoints, initialPoseEstimation, icpInfo);
-
-			icpEstimation.copyFrom(*alignEst);
-
-			// Generate gaussian-distributed 2D-pose increments according to
-			// "finalEstimatedPoseGauss":
-			// -------------------------------------------------------------------------------------------
+			CLocalMetricHypothesis::CParticleData& part = LMH->m_particles[i];
+			CPose3D* part_pose = LMH->getCurrentPose(i);
+
 			// Set the gaussian pose:
-			CPose3DPDFGaussian finalEstimatedPoseGauss(icpEstimation);
+			CPose3DPDFGaussian finalEstimatedPoseGauss(icpEstimations[i]);
 
 			CPose3D noisy_increment;
 			finalEstimatedPoseGauss.drawSingleSample(noisy_increment);
@@ -923,25 +933,31 @@ void CLSLAM_RBPF_2DLASER::prediction_and_update_pfOptimalProposal(
 			CPose3D new_pose;
 			new_pose.composeFrom(*part_pose, noisy_increment);
 
-			CPose2D new_pose2d = CPose2D(new_pose);
+			newPoses2D[i] = CPose2D(new_pose);
 
 			// Add the pose to the path:
 			part.d->robotPoses[LMH->m_currentRobotPose] = new_pose;
+		}
 
-			// Update the weight:
-			// ---------------------------------------------------------------------------
-			const double log_lik = PF_options.powFactor *
-				auxiliarComputeObservationLikelihood(
-									   PF_options, LMH, i, sf, &new_pose2d);
-
-			part.log_w += log_lik;
-
-			// Add to historic record of log_w weights:
-			LMH->m_log_w_metric_history[i][currentPoseID] += log_lik;
+		// 3) Update the weights, in parallel again (each particle has its own
+		// maps):
+		// -------------------------------------------------------------------
+		m_parent->runInParallel(
+			PF_options.numThreads, M, [&](size_t i0, size_t i1) {
+				for (size_t i = i0; i < i1; i++)
+				{
+					const double log_lik = PF_options.powFactor *
+						auxiliarComputeObservationLikelihood(
+											   PF_options, LMH, i, sf,
+											   &newPoses2D[i]);
 
-		}  // end else we can do ICP
+					LMH->m_particles[i].log_w += log_lik;
 
-	}  // end for each particle i
+					// Add to historic record of log_w weights:
+					LMH->m_log_w_metric_history[i][currentPoseID] += log_lik;
+				}
+			});
+	}
 
 	// Accumulate the log likelihood of this LMH as a whole:
 	double out_max_log_w;
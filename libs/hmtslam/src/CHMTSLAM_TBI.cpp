@@ -185,6 +185,22 @@ CHMTSLAM::TMessageLSLAMfromTBI::Ptr CHMTSLAM::TBI_main_method(
 	{
 		std::lock_guard<std::mutex> lock(obj->m_topLCdets_cs);
 
+		// The (LC detector, candidate area) pairs are independent, so they
+		// are evaluated in parallel, then merged into each candidate in the
+		// same order of a sequential evaluation:
+		struct TLCJob
+		{
+			CTopLCDetectorBase* detector;
+			CHMHMapNode::TNodeID candidate;
+			CHMHMapNode::Ptr refArea;
+
+			// Output:
+			double log_lik = 0;
+			CPose3DPDF::Ptr pdf;
+		};
+		std::vector<TLCJob> jobs;
+		jobs.reserve(obj->m_topLCdets.size() * msg->loopClosureData.size());
+
 		for (auto it = obj->m_topLCdets.begin(); it != obj->m_topLCdets.end();
 			 ++it)
 		{
@@ -195,35 +211,49 @@ CHMTSLAM::TMessageLSLAMfromTBI::Ptr CHMTSLAM::TBI_main_method(
 				// ----------------------------------------------------------------------------------------------------------------
 				// TODO: ...
 
-				// Proceed:
-				// ----------------------------------------------------------------------------------------------------------------
-				const CHMHMapNode::Ptr refArea =
-					obj->m_map.getNodeByID(candidate.first);
-				double this_log_lik;
-
-				// get the output from this LC detector:
-				CPose3DPDF::Ptr pdf = (*it)->computeTopologicalObservationModel(
-					LMH->m_ID, currentArea, refArea, this_log_lik);
-
-				// Add to the output:
-				candidate.second.log_lik += this_log_lik;
+				TLCJob job;
+				job.detector = *it;
+				job.candidate = candidate.first;
+				job.refArea = obj->m_map.getNodeByID(candidate.first);
+				jobs.push_back(std::move(job));
+			}  // end for each candidate area
+		}  // end for each LC detector
 
-				// This is because not all LC detector MUST return a pose PDF
-				// (i.e. image-based detectors)
-				if (pdf)
+		obj->runInParallel(
+			obj->m_options.TLC_num_threads, jobs.size(),
+			[&](size_t i0, size_t i1) {
+				for (size_t i = i0; i < i1; i++)
 				{
-					ASSERT_(IS_CLASS(*pdf, CPose3DPDFSOG));
-					CPose3DPDFSOG::Ptr SOG =
-						std::dynamic_pointer_cast<CPose3DPDFSOG>(pdf);
-
-					// Mix (append) the modes, if any:
-					if (SOG->size() > 0)
-						candidate.second.delta_new_cur.appendFrom(*SOG);
-					else
-						lstNodesToErase.insert(candidate.first);
+					// get the output from this LC detector:
+					jobs[i].pdf =
+						jobs[i].detector->computeTopologicalObservationModel(
+							LMH_ID, currentArea, jobs[i].refArea,
+							jobs[i].log_lik);
 				}
-			}  // end for each candidate area
-		}  // end for each LC detector
+			});
+
+		for (const auto& job : jobs)
+		{
+			auto& candidate = msg->loopClosureData[job.candidate];
+
+			// Add to the output:
+			candidate.log_lik += job.log_lik;
+
+			// This is because not all LC detector MUST return a pose PDF
+			// (i.e. image-based detectors)
+			if (job.pdf)
+			{
+				ASSERT_(IS_CLASS(*job.pdf, CPose3DPDFSOG));
+				CPose3DPDFSOG::Ptr SOG =
+					std::dynamic_pointer_cast<CPose3DPDFSOG>(job.pdf);
+
+				// Mix (append) the modes, if any:
+				if (SOG->size() > 0)
+					candidate.delta_new_cur.appendFrom(*SOG);
+				else
+					lstNodesToErase.insert(job.candidate);
+			}
+		}
 
 	}  // end of m_topLCdets_cs lock
 
@@ -27,6 +27,7 @@
 #include "hmtslam-precomp.h"  // Precomp header
 //
 #include <mrpt/config/CConfigFile.h>
+#include <mrpt/core/WorkerThreadsPool.h>
 #include <mrpt/io/CFileStream.h>
 #include <mrpt/io/CMemoryStream.h>
 #include <mrpt/serialization/stl_serialization.h>
@@ -319,6 +320,8 @@ void CHMTSLAM::TOptions::loadFromConfigFile(
 
 	std::cout << "TLC_detectors: " << TLC_detectors.size() << std::endl;
 
+	MRPT_LOAD_CONFIG_VAR(TLC_num_threads, int, source, section);
+
 	// load other sub-classes:
 	AA_options.loadFromConfigFile(source, section);
 }
@@ -342,6 +345,7 @@ void CHMTSLAM::TOptions::dumpToTextStream(std::ostream& out) const
 	LOADABLEOPTS_DUMP_VAR_DEG(MIN_ODOMETRY_STD_PHI);
 
 	LOADABLEOPTS_DUMP_VAR(random_seed, int);
+	LOADABLEOPTS_DUMP_VAR(TLC_num_threads, int);
 
 	AA_options.dumpToTextStream(out);
 	pf_options.dumpToTextStream(out);
@@ -521,6 +525,44 @@ std::string CHMTSLAM::generateUniqueAreaLabel()
 	return format("%li", (long int)(m_nextAreaLabel++));
 }
 
+/*---------------------------------------------------------------
+						runInParallel
+  ---------------------------------------------------------------*/
+void CHMTSLAM::runInParallel(
+	unsigned int numThreads, size_t N,
+	const std::function<void(size_t, size_t)>& f)
+{
+	size_t nThreads = numThreads;
+	if (nThreads == 0)
+		nThreads = std::max<size_t>(1, std::thread::hardware_concurrency());
+	nThreads = std::min(nThreads, N);
+
+	if (nThreads <= 1)
+	{
+		if (N > 0) f(0, N);
+		return;
+	}
+
+	if (!m_threadPool || m_threadPool->size() != nThreads)
+		m_threadPool = std::make_shared<mrpt::WorkerThreadsPool>(
+			nThreads, mrpt::WorkerThreadsPool::POLICY_FIFO, "hmtslam");
+
+	std::vector<std::future<void>> tasks;
+	tasks.reserve(nThreads);
+	const size_t blockLen = (N + nThreads - 1) / nThreads;
+	for (size_t i0 = 0; i0 < N; i0 += blockLen)
+	{
+		const size_t i1 = std::min(N, i0 + blockLen);
+		tasks.emplace_back(
+			m_threadPool->enqueue([&f, i0, i1]() { f(i0, i1); }));
+	}
+	// Wait for all and propagate exceptions, if any:
+	for (auto& t : tasks)
+		t.wait();
+	for (auto& t : tasks)
+		t.get();
+}
+
 /*---------------------------------------------------------------
 						generatePoseID
   ---------------------------------------------------------------*/
@@ -14,6 +14,8 @@
 #include <mrpt/serialization/CArchive.h>
 #include <mrpt/system/filesystem.h>
 
+#include <atomic>
+
 using namespace mrpt::slam;
 using namespace mrpt::hmtslam;
 using namespace mrpt::poses;
@@ -23,7 +25,8 @@ using namespace mrpt::serialization;
 using namespace mrpt::maps;
 
 CTopLCDetector_GridMatching::CTopLCDetector_GridMatching(CHMTSLAM* hmtslam)
-	: CTopLCDetectorBase(hmtslam)
+	: CTopLCDetectorBase(hmtslam),
+	  m_grid_feat_extr(std::make_shared<COccupancyGridMapFeatureExtractor>())
 {
 }
 
@@ -54,6 +57,7 @@ CPose3DPDF::Ptr CTopLCDetector_GridMatching::computeTopologicalObservationModel(
 	const CTopLCDetector_GridMatching::TOptions& o =
 		m_hmtslam->m_options.TLC_grid_options;
 	gridAligner.options = o.matchingOptions;
+	gridAligner.setFeatureExtractor(m_grid_feat_extr);
 
 	CMultiMetricMap::Ptr hMapCur =
 		currentArea->m_annotations.getAs<CMultiMetricMap>(
@@ -91,8 +95,9 @@ CPose3DPDF::Ptr CTopLCDetector_GridMatching::computeTopologicalObservationModel(
 	if (!m_hmtslam->m_options.LOG_OUTPUT_DIR.empty())
 	{
 		mrpt::system::createDirectory(dbg_dir);
-		static int cnt = 0;
-		++cnt;
+		// (This may be called from several threads, see TLC_num_threads)
+		static std::atomic_int cntAll{0};
+		const int cnt = ++cntAll;
 		const std::string filStat = dbg_dir +
 			format("/state_%05i_test_%i_%i.hmtslam", cnt,
 				   (int)currentArea->getID(), (int)refArea->getID());
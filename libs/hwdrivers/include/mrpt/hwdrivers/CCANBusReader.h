@@ -10,9 +10,12 @@
 
 #include <mrpt/comms/CSerialPort.h>
 #include <mrpt/hwdrivers/CGenericSensor.h>
+#include <mrpt/obs/CObservationCANBusBatch.h>
 #include <mrpt/obs/CObservationCANBusJ1939.h>
 #include <mrpt/system/COutputLogger.h>
 
+#include <memory>
+
 namespace mrpt::hwdrivers
 {
 /** This "software driver" implements the communication protocol for interfacing
@@ -49,8 +52,24 @@ namespace mrpt::hwdrivers
  *   pose_yaw=0	// Angles in degrees
  *   pose_pitch=0
  *   pose_roll=0
+ *
+ *   // Linux only: read from a SocketCAN interface instead of the serial
+ *   // adapter (all the COM_* and CANBusSpeed options are then ignored):
+ *   SocketCAN_interface = can0
+ *   // Store all the frames read in each call to doProcess() in one
+ *   // mrpt::obs::CObservationCANBusBatch (Default=true), instead of one
+ *   // mrpt::obs::CObservationCANBusJ1939 per frame:
+ *   SocketCAN_batch = true
+ *   // Frames read per recvmmsg() system call (Default=64):
+ *   SocketCAN_framesPerRead = 64
+ *   // Optional list of "id/mask" pairs (hexadecimal) of the frames to
+ *   // accept, with "id & mask == frame_id & mask", applied by the kernel:
+ *   SocketCAN_filters = 0x0CF00400/0x00FFFF00 0x18FEF100/0x00FFFF00
  *  \endcode
  *
+ * With SocketCAN, frames are timestamped by the kernel upon reception, and
+ * the frames dropped by the kernel are reported by getReceptionStats().
+ *
  * \sa C2DRangeFinderAbstract
  * \ingroup mrpt_hwdrivers_grp
  */
@@ -104,6 +123,20 @@ class CCANBusReader : public mrpt::system::COutputLogger, public CGenericSensor
 	bool m_CANBusChannel_isOpen{
 		false};	 // if the can bus channel is open or not
 
+	/** @name SocketCAN interface
+		@{ */
+	std::string m_socketcan_interface;
+	bool m_socketcan_batch{true};
+	unsigned int m_socketcan_frames_per_read{64};
+	std::string m_socketcan_filters;
+	/** Socket and reception buffers (only in Linux) */
+	struct SocketCAN;
+	std::unique_ptr<SocketCAN> m_socketcan;
+
+	void socketCANOpen();
+	void socketCANProcess();
+	/** @} */
+
    protected:
 	/** See the class documentation at the top for expected parameters */
 	void loadConfig_sensorSpecific(
@@ -169,6 +202,10 @@ class CCANBusReader : public mrpt::system::COutputLogger, public CGenericSensor
 
 	void doProcess() override;
 
+	/** Frames received and dropped, only with SocketCAN.
+	 * \note (New in MRPT 2.4.9) */
+	TReceptionStats getReceptionStats() const override;
+
 };	// End of class
 
 }  // namespace mrpt::hwdrivers
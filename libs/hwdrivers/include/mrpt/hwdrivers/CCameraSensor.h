@@ -185,6 +185,15 @@ namespace mrpt::hwdrivers
  *    # Options for grabber_type= ffmpeg -------------------------------------
  *    ffmpeg_url             = rtsp://127.0.0.1      // [ffmpeg] The video file
  * or IP camera to open
+ *    ffmpeg_threads         = 0                     // [ffmpeg] Decoding
+ * threads (0: automatic)
+ *    ffmpeg_hwaccel         = vaapi                 // [ffmpeg] Optional
+ * hardware decoding (vaapi, cuda, vdpau, qsv,...).
+ *    ffmpeg_hwaccel_device  = /dev/dri/renderD128   // [ffmpeg] Optional
+ * hardware decoding device
+ *    ffmpeg_decoder         = h264_v4l2m2m          // [ffmpeg] Optional
+ * decoder name, instead of the default one for the codec.
+ *    See mrpt::hwdrivers::CFFMPEG_InputStream::TDecodingOptions
  *
  *    # Options for grabber_type= rawlog -------------------------------------
  *    rawlog_file            = mylog.rawlog          // [rawlog] This can be
@@ -450,6 +459,7 @@ class CCameraSensor : public mrpt::system::COutputLogger, public CGenericSensor
 
 	// Options for grabber_type= ffmpeg -------------------------------------
 	std::string m_ffmpeg_url;
+	CFFMPEG_InputStream::TDecodingOptions m_ffmpeg_decoding;
 
 	// Options for grabber_type= rawlog -------------------------------------
 	std::string m_rawlog_file;
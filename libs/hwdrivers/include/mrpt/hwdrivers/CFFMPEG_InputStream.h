@@ -27,6 +27,12 @@ namespace mrpt::hwdrivers
  *
  *  Frames are retrieved by calling CFFMPEG_InputStream::retrieveFrame
  *
+ *  Decoding uses several threads by default, and can be done in hardware
+ *  (e.g. VAAPI, NVDEC or V4L2 memory-to-memory decoders), see
+ *  CFFMPEG_InputStream::decodingOptions. Frames are converted straight into
+ *  the pixel buffers of the output image. seekToTime() jumps to any time
+ *  of video files using the index of the container.
+ *
  *   For an example of usage, see the file "samples/grab_camera_ffmpeg"
  *
  * \note This class is an easy to use C++ wrapper for ffmpeg libraries
@@ -50,6 +56,30 @@ class CFFMPEG_InputStream
 	bool m_grab_as_grayscale;
 
    public:
+	/** Decoding options, used by the next call to openURL().
+	 * \note (New in MRPT 2.4.9) */
+	struct TDecodingOptions
+	{
+		TDecodingOptions() = default;
+
+		/** Decoding threads (Default=0: automatic, 1: no extra threads) */
+		int threads = 0;
+		/** Type of hardware decoding device, as in the `-hwaccel` option of
+		 * the ffmpeg program (e.g. "vaapi", "cuda", "vdpau", "qsv",
+		 * "videotoolbox", "d3d11va"). Empty (Default) means software
+		 * decoding. If it is not available for the video, decoding falls
+		 * back to software. */
+		std::string hwaccel;
+		/** The hardware device to use (e.g. "/dev/dri/renderD128" for
+		 * VAAPI), or empty (Default) for the default one. */
+		std::string hwaccelDevice;
+		/** Name of a specific decoder to use instead of the default one for
+		 * the video codec (e.g. "h264_v4l2m2m", "h264_cuvid"). */
+		std::string decoderName;
+	};
+
+	TDecodingOptions decodingOptions;
+
 	/** Default constructor, does not open any video source at startup */
 	CFFMPEG_InputStream();
 	/** Destructor */
@@ -97,5 +127,23 @@ class CFFMPEG_InputStream
 	 *  \sa openURL, close, isOpen
 	 */
 	bool retrieveFrame(mrpt::img::CImage& out_img);
+
+	/** Moves to the given time (seconds since the beginning of the video)
+	 * of a video file, such that the next retrieveFrame() returns the first
+	 * frame at or after it.
+	 *  \return false on any error, or if the source does not support
+	 * seeking.
+	 *  \note (New in MRPT 2.4.9) */
+	bool seekToTime(double t);
+
+	/** Returns the time (seconds since the beginning of the video) of the
+	 * last frame returned by retrieveFrame(), or -1 if unknown.
+	 *  \note (New in MRPT 2.4.9) */
+	double getLastFrameTime() const;
+
+	/** Returns whether frames are being decoded in hardware, after
+	 * openURL().
+	 *  \note (New in MRPT 2.4.9) */
+	bool isHardwareDecoding() const;
 };
 }  // namespace mrpt::hwdrivers
@@ -10,7 +10,7 @@
 #pragma once
 
 #include <mrpt/comms/CSerialPort.h>
-#include <mrpt/containers/circular_buffer.h>
+#include <mrpt/containers/lockfree_byte_ring.h>
 #include <mrpt/hwdrivers/CGenericSensor.h>
 #include <mrpt/io/CFileOutputStream.h>
 #include <mrpt/obs/CObservationGPS.h>
@@ -235,6 +235,18 @@ class CGPSInterface : public mrpt::system::COutputLogger, public CGenericSensor
 		const std::string& cmd_line, mrpt::obs::CObservationGPS& out_obs,
 		const bool verbose = false);
 
+	/** Like parse_NMEA(const std::string&,...), for a line of `len` chars
+	 * starting at `cmd_line` (not NUL-terminated), parsed in place without
+	 * memory allocations.
+	 * \param recycledMsgs If not null, parsed messages are stored into
+	 * message objects taken from this list, if it has one of the same type,
+	 * instead of new ones.
+	 * \note (New in MRPT 2.4.9) */
+	static bool parse_NMEA(
+		const char* cmd_line, size_t len, mrpt::obs::CObservationGPS& out_obs,
+		const bool verbose = false,
+		mrpt::obs::CObservationGPS::message_list_t* recycledMsgs = nullptr);
+
 	/** Gets the latest GGA command or an empty string if no newer GGA command
 	 * was received since the last call to this method.
 	 * \param[in] reset If set to true, will empty the GGA cache so next calls
@@ -309,7 +321,7 @@ class CGPSInterface : public mrpt::system::COutputLogger, public CGenericSensor
 
    private:
 	/** Auxiliary buffer for readings */
-	mrpt::containers::circular_buffer<uint8_t> m_rx_buffer;
+	mrpt::containers::lockfree_byte_ring m_rx_buffer;
 	PARSERS m_parser{CGPSInterface::AUTO};
 	std::string m_raw_dump_file_prefix;
 	std::string m_COMname;
@@ -360,6 +372,24 @@ class CGPSInterface : public mrpt::system::COutputLogger, public CGenericSensor
 	void flushParsedMessagesNow();
 	/** A private copy of the last received gps datum */
 	mrpt::obs::CObservationGPS m_just_parsed_messages;
+
+	/** \name Recycling of objects, to avoid memory allocations while parsing
+	 * @{ */
+	/** Returns an empty observation, reusing one of those previously queued
+	 * out if the user does not hold it anymore. */
+	mrpt::obs::CObservationGPS::Ptr getRecycledObservation();
+	/** Observations queued out, to be recycled once released */
+	std::vector<mrpt::obs::CObservationGPS::Ptr> m_obs_pool;
+	size_t m_obs_pool_next{0};
+	/** Message objects of recycled observations, at most one per type */
+	mrpt::obs::CObservationGPS::message_list_t m_recycled_msgs;
+	/** Scratch buffer for incoming frames that cannot be parsed in place */
+	std::vector<uint8_t> m_rx_frame;
+	/** Returns a pointer to the first `len` bytes in m_rx_buffer, in place if
+	 * they are contiguous in memory, or copied into m_rx_frame otherwise.
+	 * They are valid until m_rx_buffer is modified. */
+	const uint8_t* peekRxFrame(size_t len);
+	/** @} */
 	/** Used in getLastGGA() */
 	std::string m_last_GGA;
 };	// end class
@@ -10,10 +10,12 @@
 #pragma once
 
 #include <mrpt/config/CConfigFileBase.h>
+#include <mrpt/containers/lockfree_bounded_queue.h>
 #include <mrpt/obs/CObservation.h>
 #include <mrpt/typemeta/TEnumType.h>
 
 #include <map>
+#include <memory>
 #include <mutex>
 
 namespace mrpt
@@ -53,6 +55,11 @@ struct TSensorClassId
  *			- "grab_decimation": (Optional) Grab only 1 out of N observations
  *captured
  *by the sensor (default is 1, i.e. do not decimate).
+ *			- "use_lockfree_queue": (Optional) If true, observations are passed
+ *from the sensor thread to the consumer through a bounded lock-free queue of
+ *capacity "max_queue_len", instead of a mutex-protected list (default is
+ *false). Observations arriving when the queue is full are dropped and
+ *counted, see CGenericSensor::getDroppedObservationsCount (New in MRPT 2.4.9).
  *		- CGenericSensor::initialize
  *		- CGenericSensor::doProcess
  *		- CGenericSensor::getObservations
@@ -115,11 +122,45 @@ class CGenericSensor
 	 */
 	static void registerClass(const TSensorClassId* pNewClass);
 
+	/** Number of observations discarded so far because the lock-free queue
+	 * was full. Always 0 unless "use_lockfree_queue" is enabled.
+	 * \note (New in MRPT 2.4.9) */
+	uint64_t getDroppedObservationsCount() const
+	{
+		return m_objQueue ? m_objQueue->dropped() : 0;
+	}
+
+	/** Reception statistics of sensors receiving data packets, see
+	 * getReceptionStats(). \note (New in MRPT 2.4.9) */
+	struct TReceptionStats
+	{
+		TReceptionStats() = default;
+
+		/** Number of packets received */
+		uint64_t received = 0;
+		/** Number of packets lost, e.g. overflowing the operating system
+		 * socket buffers or the driver queues */
+		uint64_t dropped = 0;
+		/** Mean and maximum time between the arrival of each packet and its
+		 * processing by the driver [seconds] */
+		double latencyMean = 0, latencyMax = 0;
+	};
+
+	/** Returns the packet reception statistics since initialize(), for the
+	 * sensors that implement it (all zeros otherwise).
+	 * \sa CVelodyneScanner
+	 * \note (New in MRPT 2.4.9) */
+	virtual TReceptionStats getReceptionStats() const { return {}; }
+
    private:
 	/** The critical section for m_objList */
 	std::mutex m_csObjList;
 	/** The queue of objects to be returned by getObservations */
 	TListObservations m_objList;
+	/** Used instead of m_objList if "use_lockfree_queue" is enabled. Ordering
+	 * by timestamp is done by the consumer, in getObservations() */
+	std::unique_ptr<mrpt::containers::lockfree_bounded_queue<TListObsPair>>
+		m_objQueue;
 
 	/** Used in registerClass */
 	using registered_sensor_classes_t =
@@ -139,6 +180,8 @@ class CGenericSensor
 	 */
 	size_t m_grab_decimation{0};
 	/** See CGenericSensor */
+	bool m_use_lockfree_queue{false};
+	/** See CGenericSensor */
 	std::string m_sensorLabel = "UNNAMED_SENSOR";
 
 	/** @} */
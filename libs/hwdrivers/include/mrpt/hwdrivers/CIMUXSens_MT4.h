@@ -45,6 +45,11 @@ namespace mrpt::hwdrivers
  *                             // the port is a COM port
  *    #deviceId     = xxxxx    // Device ID to open, or first one if empty.
  *    #logFile      = xxxx     // If provided, will enable XSens SDK's own log
+ *    #batchSize    = 1        // >1: Generate CObservationIMUBatch objects
+ *                             // with this number of samples each
+ *    #useHardwareTimestamps = false // Timestamp samples with the device
+ *                             // clock ("SampleTimeFine") instead of the
+ *                             // reception time
  *  \endcode
  *
  *  \note Set the environment variable "MRPT_HWDRIVERS_VERBOSE" to "1" to
@@ -87,6 +92,14 @@ class CIMUXSens_MT4 : public hwdrivers::CGenericSensor
 	std::string m_xsensLogFile;
 
 	int m_sampleFreq{100};
+	/** Number of samples per observation: 1 for one CObservationIMU per
+	 * sample, or N>1 for one mrpt::obs::CObservationIMUBatch each N samples.
+	 */
+	size_t m_batchSize{1};
+	/** Timestamp samples with the device sample counter instead of the
+	 * reception time (the first sample is still stamped with the computer
+	 * clock, which is used again if they drift apart more than 0.1 s). */
+	bool m_useHardwareTimestamps{false};
 
 	mrpt::poses::CPose3D m_sensorPose;
 
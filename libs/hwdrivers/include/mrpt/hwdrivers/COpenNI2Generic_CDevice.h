@@ -127,28 +127,38 @@ class COpenNI2Generic::CDevice
 		obs.rangeImage_setSize(h, w);
 	}
 
-	inline void setPixel(
-		const openni::RGB888Pixel& src, mrpt::img::CImage& rgb, int x, int y)
+	/** Copies one row of pixels, converting RGB to the BGR order of CImage,
+	 * and mirroring it if needed. */
+	void copyRow(
+		const openni::RGB888Pixel* src, mrpt::img::CImage& rgb, int w,
+		const int y)
 	{
-		rgb.setPixel(x, y, (src.r << 16) + (src.g << 8) + src.b);
-	}
-	inline void setPixel(
-		const openni::DepthPixel& src, mrpt::math::CMatrix_u16& depth_mm, int x,
-		int y)
-	{
-		depth_mm(y, x) = src;
-	}
-
-	template <class NI_PIXEL, class MRPT_DATA>
-	void copyRow(const char* src, MRPT_DATA& rgb, int w, const int y)
-	{
-		const auto* s = (const NI_PIXEL*)src;
-		for (int xc = 0; xc < w; ++xc, ++s)
+		auto* d = rgb.ptrLine<uint8_t>(y);
+		int step = 3;
+		if (isMirrorMode())
 		{
-			int x = xc;
-			if (isMirrorMode()) { x = w - xc - 1; }
-			setPixel(*s, rgb, x, y);
+			d += 3 * (w - 1);
+			step = -3;
 		}
+		for (int x = 0; x < w; ++x, ++src, d += step)
+		{
+			d[0] = src->b;
+			d[1] = src->g;
+			d[2] = src->r;
+		}
+	}
+	/** Copies one row of depth pixels (already in mm, as rangeImage), with
+	 * a plain memcpy() unless mirroring it. */
+	void copyRow(
+		const openni::DepthPixel* src, mrpt::math::CMatrix_u16& depth_mm,
+		int w, const int y)
+	{
+		static_assert(sizeof(openni::DepthPixel) == sizeof(uint16_t));
+		auto* d = &depth_mm(y, 0);
+		if (isMirrorMode())
+			std::reverse_copy(src, src + w, d);
+		else
+			std::memcpy(d, src, sizeof(uint16_t) * w);
 	}
 
 	template <class NI_PIXEL, class MRPT_DATA>
@@ -161,7 +171,7 @@ class COpenNI2Generic::CDevice
 		resize(dst, width, height);
 		for (int y = 0; y < height; ++y, data += stride)
 		{
-			copyRow<NI_PIXEL, MRPT_DATA>(data, dst, width, y);
+			copyRow(reinterpret_cast<const NI_PIXEL*>(data), dst, width, y);
 		}
 	}
 
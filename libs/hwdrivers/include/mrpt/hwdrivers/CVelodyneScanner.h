@@ -10,11 +10,18 @@
 #pragma once
 
 #include <mrpt/config/CConfigFileBase.h>
+#include <mrpt/containers/lockfree_bounded_queue.h>
 #include <mrpt/hwdrivers/CGenericSensor.h>
 #include <mrpt/obs/CObservationGPS.h>
 #include <mrpt/obs/CObservationVelodyneScan.h>
 #include <mrpt/typemeta/TEnumType.h>
 
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
 namespace mrpt::hwdrivers
 {
 /** A C++ interface to Velodyne laser scanners (HDL-64, HDL-32, VLP-16), working
@@ -88,6 +95,24 @@ namespace mrpt::hwdrivers
  * via a configuration file with CGenericSensor::loadConfig() (see example
  * config file section below).
  *
+ * <h2>Batched reception:</h2><hr>
+ *  By default, packets are received one by one from the UDP sockets each
+ * time getNextObservation() is called. At high packet rates (e.g. ~12k
+ * packets/s for 128-beam devices) packets may be dropped if the process
+ * is not scheduled in time. In Linux, enabling `rx_thread` receives them
+ * instead in a dedicated thread (optionally pinned to a CPU core), in
+ * batches with `recvmmsg()` into preallocated buffers, stamped by the kernel
+ * upon arrival (`SO_TIMESTAMPNS`) and kept in a queue until processed.
+ * Dropped packets and latencies are reported by getReceptionStats().
+ *
+ * <h2>Fast offline replay of PCAP files:</h2><hr>
+ *  processPCAPFile() reads a whole PCAP file (set with setPCAPInputFile())
+ * as fast as possible, without libpcap and ignoring the original timing:
+ * the file is memory-mapped, split into complete scans in the calling
+ * thread, and scans are then decoded (and converted to point clouds, if
+ * requested) in a pool of worker threads. Observations are passed to a user
+ * callback in the same order than live replay would return them.
+ *
  * <h2>About timestamps:</h2><hr>
  *  Each gathered observation of type mrpt::obs::CObservationVelodyneScan is
  * populated with two timestamps, one for the local PC timestamp and,
@@ -124,6 +149,12 @@ namespace mrpt::hwdrivers
  *   #return_type     = STRONGEST  // Any of: 'STRONGEST', 'LAST', 'DUAL'
  * (Default: unchanged). Requires setting `device_ip`
  *
+ *   # Batched reception in a dedicated thread (Linux only). See above.
+ *   #rx_thread       = false
+ *   #rx_thread_cpu   = -1      // CPU core to pin the thread to (-1: any)
+ *   #rx_batch_size   = 64      // Max. packets per recvmmsg() call
+ *   #rx_queue_length = 4096    // Max. packets waiting to be processed
+ *
  *   # ---- Offline operation ----
  *   # If uncommented, this class will read from the PCAP instead of connecting
  * and listeling
@@ -247,6 +278,16 @@ class CVelodyneScanner : public mrpt::hwdrivers::CGenericSensor
 	/** Default: 0 (in seconds) */
 	double m_pcap_repeat_delay{0.0};
 
+	// Batched reception:
+	/** Default: false */
+	bool m_rx_thread{false};
+	/** Default: -1 (do not pin the thread to any CPU) */
+	int m_rx_thread_cpu{-1};
+	/** Default: 64 */
+	unsigned int m_rx_batch_size{64};
+	/** Default: 4096 */
+	unsigned int m_rx_queue_length{4096};
+
 	/** See the class documentation at the top for expected parameters */
 	void loadConfig_sensorSpecific(
 		const mrpt::config::CConfigFileBase& configSource,
@@ -347,8 +388,33 @@ class CVelodyneScanner : public mrpt::hwdrivers::CGenericSensor
 	 */
 	void setFramePublishing(bool on);
 
+	/** Enables receiving UDP packets in batches in a dedicated thread,
+	 * optionally pinned to the CPU core `pinToCPU` (Linux only, ignored
+	 * otherwise). See the discussion at the top of this page.
+	 * \param batchSize Maximum number of packets per recvmmsg() call.
+	 * \param queueLength Maximum number of packets waiting to be processed
+	 * by getNextObservation(). Newer ones are dropped.
+	 * \note (New in MRPT 2.4.9) */
+	void setReceiverThread(
+		bool enable, int pinToCPU = -1, unsigned int batchSize = 64,
+		unsigned int queueLength = 4096)
+	{
+		m_rx_thread = enable;
+		m_rx_thread_cpu = pinToCPU;
+		m_rx_batch_size = batchSize;
+		m_rx_queue_length = queueLength;
+	}
+	bool isReceiverThreadEnabled() const { return m_rx_thread; }
+
 	/** @} */
 
+	/** Counts the packets received and dropped since initialize(), including
+	 * those dropped by the operating system (only with the receiver thread,
+	 * see setReceiverThread()), and the latency from their arrival to their
+	 * processing in getNextObservation().
+	 * \note (New in MRPT 2.4.9) */
+	TReceptionStats getReceptionStats() const override;
+
 	/** Polls the UDP port for incoming data packets. The user *must* call this
 	 * method in a timely fashion to grab data as it it generated by the device.
 	 *  The minimum call rate should be the expected number of data
@@ -378,6 +444,30 @@ class CVelodyneScanner : public mrpt::hwdrivers::CGenericSensor
 	 */
 	void initialize() override;
 
+	/** Reads the whole PCAP file set with setPCAPInputFile() as fast as
+	 * possible (see discussion at the top of this page), invoking `callback`
+	 * with each CObservationVelodyneScan (one per full revolution, or one per
+	 * data packet if frame publishing is disabled, see setFramePublishing())
+	 * and each CObservationGPS, in file order. initialize() is not required.
+	 *
+	 * \param numThreads Number of worker threads decoding scans, or 0 to use
+	 * as many as hardware threads.
+	 * \param generatePointClouds Whether to call
+	 * CObservationVelodyneScan::generatePointCloud() with `pcParams` for each
+	 * scan before passing it to the callback.
+	 * \return The number of observations passed to the callback.
+	 * \exception std::exception If the file cannot be read or it is not a
+	 * Ethernet PCAP capture.
+	 * \note (New in MRPT 2.4.9) */
+	size_t processPCAPFile(
+		const std::function<void(const mrpt::obs::CObservation::Ptr&)>&
+			callback,
+		unsigned int numThreads = 0, bool generatePointClouds = true,
+		const mrpt::obs::CObservationVelodyneScan::
+			TGeneratePointCloudParameters& pcParams =
+				mrpt::obs::CObservationVelodyneScan::
+					TGeneratePointCloudParameters());
+
 	/** Close the UDP sockets set-up in \a initialize(). This is called
 	 * automatically upon destruction */
 	void close();
@@ -422,8 +512,57 @@ class CVelodyneScanner : public mrpt::hwdrivers::CGenericSensor
 		mrpt::system::TTimeStamp& data_pkt_time, uint8_t* out_data_buffer,
 		mrpt::system::TTimeStamp& pos_pkt_time, uint8_t* out_pos_buffer);
 
+	/** Loads the default calibration of the model, if none was loaded */
+	void internal_assure_calibration();
+	/** Parses a position packet into a GPS observation, keeping the last
+	 * valid RMC frame for stamping scans */
+	mrpt::obs::CObservationGPS::Ptr internal_process_pos_packet(
+		const mrpt::obs::CObservationVelodyneScan::TVelodynePositionPacket& pkt,
+		const mrpt::system::TTimeStamp& pkt_timestamp);
+	/** Returns a new empty scan with this sensor label, pose and calibration */
+	mrpt::obs::CObservationVelodyneScan::Ptr internal_new_scan() const;
+	/** Sets the timestamps of a scan from those of its first data packet */
+	void internal_stamp_scan(
+		mrpt::obs::CObservationVelodyneScan& scan,
+		const mrpt::obs::CObservationVelodyneScan::TVelodyneRawPacket&
+			first_pkt,
+		const mrpt::system::TTimeStamp& pkt_timestamp) const;
+	/** Position packets decimation: false if the packet must be ignored */
+	bool internal_accept_pos_packet(
+		const mrpt::system::TTimeStamp& pkt_timestamp);
+
 	/** In progress RX scan */
 	mrpt::obs::CObservationVelodyneScan::Ptr m_rx_scan;
+	/** Packets in the largest scan so far, to reserve them in new scans */
+	size_t m_rx_scan_capacity{0};
+
+	/** A packet received in the receiver thread */
+	template <class PACKET>
+	struct TRxPacket
+	{
+		mrpt::system::TTimeStamp timestamp;
+		PACKET pkt;
+	};
+	using data_queue_t = mrpt::containers::lockfree_bounded_queue<
+		TRxPacket<mrpt::obs::CObservationVelodyneScan::TVelodyneRawPacket>>;
+	using pos_queue_t = mrpt::containers::lockfree_bounded_queue<TRxPacket<
+		mrpt::obs::CObservationVelodyneScan::TVelodynePositionPacket>>;
+	std::unique_ptr<data_queue_t> m_rx_data_queue;
+	std::unique_ptr<pos_queue_t> m_rx_pos_queue;
+	std::thread m_rx_thread_handle;
+	std::atomic_bool m_rx_thread_running{false};
+	/** Packets dropped by the OS in the data and position sockets */
+	std::atomic<uint64_t> m_rx_os_dropped[2] = {{0}, {0}};
+
+	void internal_start_rx_thread();
+	void internal_stop_rx_thread();
+	void internal_rx_thread();
+
+	/** Packets processed and their latencies (drops are counted apart) */
+	TReceptionStats m_rx_stats;
+	double m_rx_latency_sum{0};
+	mutable std::mutex m_rx_stats_mtx;
+	void internal_update_rx_stats(const mrpt::system::TTimeStamp& pktTime);
 
 	mrpt::obs::gnss::Message_NMEA_RMC m_last_gps_rmc;
 	mrpt::system::TTimeStamp m_last_gps_rmc_age;
@@ -12,16 +12,32 @@
 // This file contains portions of code from sicklms200.cc from the Player/Stage
 // project.
 
+#include <mrpt/comms/net_utils.h>
 #include <mrpt/hwdrivers/CCANBusReader.h>
 #include <mrpt/system/CTicTac.h>
 #include <mrpt/system/crc.h>
 #include <mrpt/system/os.h>
+#include <mrpt/system/string_utils.h>
 
+#include <algorithm>
 #include <cstdio>  // printf
 #include <cstring>	// memset
 #include <iostream>
+#include <mutex>
 #include <thread>
 
+#if defined(__linux__)
+#include <linux/can.h>
+#include <linux/can/raw.h>
+#include <net/if.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <ctime>
+#endif
+
 IMPLEMENTS_GENERIC_SENSOR(CCANBusReader, mrpt::hwdrivers)
 
 #define RET_ERROR(msg)                                                         \
@@ -47,6 +63,29 @@ char hexCharToInt(char n)
 		return 0;
 }
 
+struct CCANBusReader::SocketCAN
+{
+#if defined(__linux__)
+	int fd = -1;
+
+	// Buffers to receive a batch of frames, allocated only once:
+	std::vector<mmsghdr> msgs;
+	std::vector<iovec> iovs;
+	std::vector<can_frame> frames;
+	std::vector<uint8_t> ctrl;
+	size_t ctrlSize = 0;
+
+	~SocketCAN()
+	{
+		if (fd >= 0) ::close(fd);
+	}
+#endif
+
+	mutable std::mutex statsMtx;
+	TReceptionStats stats;
+	double latencySum = 0;
+};
+
 /*-------------------------------------------------------------
 						CCANBusReader
 -------------------------------------------------------------*/
@@ -83,6 +122,12 @@ CCANBusReader::~CCANBusReader()
 
 void CCANBusReader::doProcess()
 {
+	if (!m_socketcan_interface.empty())
+	{
+		socketCANProcess();
+		return;
+	}
+
 	mrpt::obs::CObservationCANBusJ1939::Ptr obs =
 		mrpt::obs::CObservationCANBusJ1939::Create();
 	bool thereIsObservation;
@@ -173,6 +218,15 @@ void CCANBusReader::loadConfig_sensorSpecific(
 		configSource.read_int(iniSection, "COM_baudRate", m_com_baudRate);
 	m_nTries_connect =
 		configSource.read_int(iniSection, "nTries_connect", m_nTries_connect);
+
+	m_socketcan_interface = configSource.read_string(
+		iniSection, "SocketCAN_interface", m_socketcan_interface);
+	m_socketcan_batch = configSource.read_bool(
+		iniSection, "SocketCAN_batch", m_socketcan_batch);
+	m_socketcan_frames_per_read = configSource.read_int(
+		iniSection, "SocketCAN_framesPerRead", m_socketcan_frames_per_read);
+	m_socketcan_filters = configSource.read_string(
+		iniSection, "SocketCAN_filters", m_socketcan_filters);
 }
 
 /*-------------------------------------------------------------
@@ -452,6 +506,12 @@ bool CCANBusReader::waitContinuousSampleFrame(
 -------------------------------------------------------------*/
 void CCANBusReader::initialize()
 {
+	if (!m_socketcan_interface.empty())
+	{
+		socketCANOpen();
+		return;
+	}
+
 	string err_str;
 	memset(m_received_frame_buffer, 0, sizeof(m_received_frame_buffer));
 	if (!tryToOpenComms(&err_str))
@@ -731,3 +791,219 @@ bool CCANBusReader::sendCommandToCANReader(
 
 	return false;
 }
+
+void CCANBusReader::socketCANOpen()
+{
+#if defined(__linux__)
+	m_socketcan = std::make_unique<SocketCAN>();
+	auto& sc = *m_socketcan;
+
+	sc.fd = ::socket(PF_CAN, SOCK_RAW, CAN_RAW);
+	if (sc.fd < 0)
+		THROW_EXCEPTION_FMT(
+			"Error creating SocketCAN socket:\n%s",
+			mrpt::comms::net::getLastSocketErrorStr().c_str());
+
+	ifreq ifr;
+	std::memset(&ifr, 0, sizeof(ifr));
+	std::strncpy(
+		ifr.ifr_name, m_socketcan_interface.c_str(), sizeof(ifr.ifr_name) - 1);
+	if (::ioctl(sc.fd, SIOCGIFINDEX, &ifr) < 0)
+		THROW_EXCEPTION_FMT(
+			"Unknown SocketCAN interface '%s':\n%s",
+			m_socketcan_interface.c_str(),
+			mrpt::comms::net::getLastSocketErrorStr().c_str());
+
+	// Filters, applied by the kernel:
+	std::vector<std::string> lstFilters;
+	mrpt::system::tokenize(m_socketcan_filters, " \t,", lstFilters);
+	if (!lstFilters.empty())
+	{
+		std::vector<can_filter> filters;
+		for (const auto& f : lstFilters)
+		{
+			const auto pos = f.find('/');
+			if (pos == std::string::npos)
+				THROW_EXCEPTION_FMT(
+					"Invalid SocketCAN filter '%s', expected 'id/mask'",
+					f.c_str());
+			can_filter cf;
+			cf.can_id = std::stoul(f.substr(0, pos), nullptr, 16);
+			cf.can_mask = std::stoul(f.substr(pos + 1), nullptr, 16);
+			// 29-bit identifiers only match extended frames:
+			if ((cf.can_id | cf.can_mask) > CAN_SFF_MASK)
+			{
+				cf.can_id |= CAN_EFF_FLAG;
+				cf.can_mask |= CAN_EFF_FLAG;
+			}
+			filters.push_back(cf);
+		}
+		if (::setsockopt(
+				sc.fd, SOL_CAN_RAW, CAN_RAW_FILTER, filters.data(),
+				sizeof(can_filter) * filters.size()))
+			THROW_EXCEPTION_FMT(
+				"Error setting SocketCAN filters:\n%s",
+				mrpt::comms::net::getLastSocketErrorStr().c_str());
+	}
+
+	// Kernel arrival timestamps, and counter of frames dropped by the
+	// kernel, for each frame:
+	const int on = 1;
+	if (::setsockopt(sc.fd, SOL_SOCKET, SO_TIMESTAMPNS, &on, sizeof(on)) ||
+		::setsockopt(sc.fd, SOL_SOCKET, SO_RXQ_OVFL, &on, sizeof(on)))
+		THROW_EXCEPTION_FMT(
+			"Error in setsockopt():\n%s",
+			mrpt::comms::net::getLastSocketErrorStr().c_str());
+	// Room for the frames received between calls to doProcess() (the kernel
+	// limits it to the net.core.rmem_max setting):
+	const int rcvBufSize = 1024 * 1024;
+	::setsockopt(
+		sc.fd, SOL_SOCKET, SO_RCVBUF, &rcvBufSize, sizeof(rcvBufSize));
+
+	sockaddr_can addr;
+	std::memset(&addr, 0, sizeof(addr));
+	addr.can_family = AF_CAN;
+	addr.can_ifindex = ifr.ifr_ifindex;
+	if (::bind(sc.fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)))
+		THROW_EXCEPTION_FMT(
+			"Error binding to SocketCAN interface '%s':\n%s",
+			m_socketcan_interface.c_str(),
+			mrpt::comms::net::getLastSocketErrorStr().c_str());
+
+	const size_t nBatch = std::max(1u, m_socketcan_frames_per_read);
+	sc.ctrlSize = CMSG_SPACE(sizeof(timespec)) + CMSG_SPACE(sizeof(uint32_t));
+	sc.msgs.assign(nBatch, mmsghdr());
+	sc.iovs.resize(nBatch);
+	sc.frames.resize(nBatch);
+	sc.ctrl.resize(nBatch * sc.ctrlSize);
+	for (size_t i = 0; i < nBatch; i++)
+	{
+		sc.iovs[i].iov_base = &sc.frames[i];
+		sc.iovs[i].iov_len = sizeof(can_frame);
+		auto& h = sc.msgs[i].msg_hdr;
+		h.msg_iov = &sc.iovs[i];
+		h.msg_iovlen = 1;
+		h.msg_control = &sc.ctrl[i * sc.ctrlSize];
+	}
+	m_state = ssWorking;
+#else
+	THROW_EXCEPTION("SocketCAN is only available in Linux");
+#endif
+}
+
+void CCANBusReader::socketCANProcess()
+{
+	if (!m_socketcan) socketCANOpen();
+
+#if defined(__linux__)
+	auto& sc = *m_socketcan;
+	const int nBatch = static_cast<int>(sc.msgs.size());
+
+	CObservationCANBusBatch::Ptr batch;
+	uint64_t received = 0;
+	uint32_t osDropped = 0;
+	bool gotDropped = false;
+	double latencySum = 0, latencyMax = 0;
+
+	// Read all the frames already received, in batches:
+	for (;;)
+	{
+		for (auto& m : sc.msgs)
+		{
+			m.msg_hdr.msg_controllen = sc.ctrlSize;
+			m.msg_hdr.msg_flags = 0;
+		}
+		const int n =
+			::recvmmsg(sc.fd, sc.msgs.data(), nBatch, MSG_DONTWAIT, nullptr);
+		if (n < 0)
+		{
+			if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+				break;
+			m_state = ssError;
+			THROW_EXCEPTION_FMT(
+				"Error in recvmmsg():\n%s",
+				mrpt::comms::net::getLastSocketErrorStr().c_str());
+		}
+
+		// Kernel timestamps are in CLOCK_REALTIME: convert them to the
+		// mrpt::Clock source from their age.
+		timespec nowRT;
+		clock_gettime(CLOCK_REALTIME, &nowRT);
+		const auto now = mrpt::Clock::now();
+
+		for (int i = 0; i < n; i++)
+		{
+			auto& h = sc.msgs[i].msg_hdr;
+			if (sc.msgs[i].msg_len < sizeof(can_frame)) continue;
+
+			auto t = now;
+			for (cmsghdr* c = CMSG_FIRSTHDR(&h); c; c = CMSG_NXTHDR(&h, c))
+			{
+				if (c->cmsg_level != SOL_SOCKET) continue;
+				if (c->cmsg_type == SCM_TIMESTAMPNS)
+				{
+					timespec ts;
+					std::memcpy(&ts, CMSG_DATA(c), sizeof(ts));
+					const double age = (nowRT.tv_sec - ts.tv_sec) +
+						1e-9 * (nowRT.tv_nsec - ts.tv_nsec);
+					t = now -
+						std::chrono::duration_cast<mrpt::Clock::duration>(
+							std::chrono::duration<double>(age));
+					latencySum += age;
+					latencyMax = std::max(latencyMax, age);
+				}
+				else if (c->cmsg_type == SO_RXQ_OVFL)
+				{
+					// Total dropped by the kernel for this socket:
+					std::memcpy(&osDropped, CMSG_DATA(c), sizeof(osDropped));
+					gotDropped = true;
+				}
+			}
+
+			const can_frame& f = sc.frames[i];
+			const auto len = std::min<uint8_t>(f.can_dlc, CAN_MAX_DLEN);
+			received++;
+
+			if (m_socketcan_batch)
+			{
+				if (!batch)
+				{
+					batch = CObservationCANBusBatch::Create();
+					batch->sensorLabel = m_sensorLabel;
+					batch->reserve(nBatch);
+				}
+				batch->addFrame(t, f.can_id, f.data, len);
+			}
+			else
+			{
+				auto obs = CObservationCANBusJ1939::Create();
+				obs->timestamp = t;
+				obs->sensorLabel = m_sensorLabel;
+				obs->setFromCANFrame(f.can_id, f.data, len);
+				appendObservation(obs);
+			}
+		}
+		if (n < nBatch) break;
+	}
+
+	if (batch) appendObservation(batch);
+
+	if (received)
+	{
+		std::lock_guard<std::mutex> lck(sc.statsMtx);
+		auto& st = sc.stats;
+		st.received += received;
+		if (gotDropped) st.dropped = osDropped;
+		sc.latencySum += latencySum;
+		st.latencyMean = sc.latencySum / st.received;
+		st.latencyMax = std::max(st.latencyMax, latencyMax);
+	}
+#endif
+}
+
+CGenericSensor::TReceptionStats CCANBusReader::getReceptionStats() const
+{
+	if (!m_socketcan) return {};
+	std::lock_guard<std::mutex> lck(m_socketcan->statsMtx);
+	return m_socketcan->stats;
+}
@@ -157,6 +157,7 @@ void CCameraSensor::initialize()
 			"[CCameraSensor::initialize] FFmpeg stream: %s...\n",
 			m_ffmpeg_url.c_str());
 		m_cap_ffmpeg = std::make_unique<CFFMPEG_InputStream>();
+		m_cap_ffmpeg->decodingOptions = m_ffmpeg_decoding;
 
 		if (!m_cap_ffmpeg->openURL(m_ffmpeg_url, m_capture_grayscale))
 		{
@@ -585,6 +586,16 @@ void CCameraSensor::loadConfig_sensorSpecific(
 	// FFmpeg options:
 	m_ffmpeg_url = mrpt::system::trim(
 		configSource.read_string(iniSection, "ffmpeg_url", m_ffmpeg_url));
+	m_ffmpeg_decoding.threads = configSource.read_int(
+		iniSection, "ffmpeg_threads", m_ffmpeg_decoding.threads);
+	m_ffmpeg_decoding.hwaccel = mrpt::system::trim(configSource.read_string(
+		iniSection, "ffmpeg_hwaccel", m_ffmpeg_decoding.hwaccel));
+	m_ffmpeg_decoding.hwaccelDevice =
+		mrpt::system::trim(configSource.read_string(
+			iniSection, "ffmpeg_hwaccel_device",
+			m_ffmpeg_decoding.hwaccelDevice));
+	m_ffmpeg_decoding.decoderName = mrpt::system::trim(configSource.read_string(
+		iniSection, "ffmpeg_decoder", m_ffmpeg_decoding.decoderName));
 
 	// Rawlog options:
 	m_rawlog_file = mrpt::system::trim(
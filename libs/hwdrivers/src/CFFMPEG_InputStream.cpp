@@ -24,11 +24,17 @@ extern "C"
 #include <libavformat/avformat.h>
 #include <libavutil/imgutils.h>
 #include <libswscale/swscale.h>
+#if LIBAVCODEC_VERSION_MAJOR >= 58
+#include <libavutil/hwcontext.h>
+#endif
 }
 #endif
 
 #include <mrpt/hwdrivers/CFFMPEG_InputStream.h>
 
+#include <algorithm>
+#include <iostream>
+
 using namespace mrpt;
 using namespace mrpt::hwdrivers;
 
@@ -53,10 +59,138 @@ struct TFFMPEGContext
 	AVCodec* pCodec{nullptr};
 	AVCodecContext* pCodecCtx{nullptr};
 	AVFrame* pFrame{nullptr};
-	AVFrame* pFrameRGB{nullptr};
+	/** Frames decoded in hardware are downloaded here */
+	AVFrame* pFrameSW{nullptr};
 	SwsContext* img_convert_ctx{nullptr};
-	std::vector<uint8_t> buffer;
+	AVBufferRef* hwDeviceCtx{nullptr};
+	AVPixelFormat hwPixFmt{AV_PIX_FMT_NONE};
+	/** The decoder is being flushed at the end of the stream */
+	bool eof{false};
+	/** Frames before this time are discarded after seekToTime() */
+	double seekTarget{-1};
+	double lastFrameTime{-1};
 };
+
+#if LIBAVCODEC_VERSION_MAJOR >= 58
+/** Picks the pixel format of the hardware decoder, if offered */
+static AVPixelFormat getHardwareFormat(
+	AVCodecContext* c, const AVPixelFormat* fmts)
+{
+	const auto* ctx = static_cast<const TFFMPEGContext*>(c->opaque);
+	for (const AVPixelFormat* p = fmts; *p != AV_PIX_FMT_NONE; p++)
+		if (*p == ctx->hwPixFmt) return *p;
+
+	std::cerr << "[CFFMPEG_InputStream] Hardware decoding not available for "
+				 "this video, using software decoding.\n";
+	return avcodec_default_get_format(c, fmts);
+}
+#endif
+
+/** Reads the next packet of the video stream and sends it to the decoder,
+ * or starts flushing it at the end of the stream. With the old decoding
+ * API, this returns once a whole frame is decoded. */
+static bool sendNextPacket(TFFMPEGContext* ctx)
+{
+	AVPacket packet;
+	while (!ctx->eof)
+	{
+		if (av_read_frame(ctx->pFormatCtx, &packet) < 0)
+		{
+			// End of stream: get the frames still in the decoder
+			ctx->eof = true;
+#if LIBAVFORMAT_VERSION_MAJOR >= 57
+			return avcodec_send_packet(ctx->pCodecCtx, nullptr) >= 0;
+#else
+			return false;
+#endif
+		}
+		if (packet.stream_index != ctx->videoStream)
+		{
+			av_packet_unref(&packet);
+			continue;
+		}
+
+#if LIBAVFORMAT_VERSION_MAJOR >= 57
+		const int ret = avcodec_send_packet(ctx->pCodecCtx, &packet);
+		av_packet_unref(&packet);
+		if (ret < 0)
+		{
+			std::cerr << "[CFFMPEG_InputStream] avcodec_send_packet error "
+						 "code="
+					  << ret << std::endl;
+			return false;
+		}
+		return true;
+#else
+		int frameFinished = 0;
+		avcodec_decode_video2(
+			ctx->pCodecCtx, ctx->pFrame, &frameFinished, &packet);
+		av_packet_unref(&packet);
+		if (frameFinished) return true;
+#endif
+	}
+	return false;
+}
+
+/** Time of the decoded frame, in seconds since the start of the stream, or
+ * -1 if unknown */
+static double frameTime(const TFFMPEGContext* ctx)
+{
+#if LIBAVCODEC_VERSION_MAJOR >= 58
+	const int64_t pts = ctx->pFrame->best_effort_timestamp;
+#else
+	const int64_t pts = av_frame_get_best_effort_timestamp(ctx->pFrame);
+#endif
+	if (pts == AV_NOPTS_VALUE) return -1;
+
+	const AVStream* st = ctx->pFormatCtx->streams[ctx->videoStream];
+	const int64_t start = st->start_time != AV_NOPTS_VALUE ? st->start_time : 0;
+	return (pts - start) * av_q2d(st->time_base);
+}
+
+/** Converts the decoded frame straight into the pixels of the image */
+static bool convertFrame(
+	TFFMPEGContext* ctx, bool grayscale, mrpt::img::CImage& out_img)
+{
+	const AVFrame* src = ctx->pFrame;
+#if LIBAVCODEC_VERSION_MAJOR >= 58
+	if (ctx->hwPixFmt != AV_PIX_FMT_NONE && src->format == ctx->hwPixFmt)
+	{
+		// Download it from the device memory:
+		av_frame_unref(ctx->pFrameSW);
+		if (av_hwframe_transfer_data(ctx->pFrameSW, ctx->pFrame, 0) < 0)
+		{
+			std::cerr << "[CFFMPEG_InputStream] Error downloading frame from "
+						 "the hardware decoder."
+					  << std::endl;
+			return false;
+		}
+		src = ctx->pFrameSW;
+	}
+#endif
+	const int width = src->width, height = src->height;
+
+	ctx->img_convert_ctx = sws_getCachedContext(
+		ctx->img_convert_ctx, width, height,
+		static_cast<AVPixelFormat>(src->format), width, height,
+		grayscale ? AV_PIX_FMT_GRAY8 : AV_PIX_FMT_BGR24,  // BGR for OpenCV
+		SWS_BICUBIC, nullptr, nullptr, nullptr);
+	if (!ctx->img_convert_ctx) return false;
+
+	// Reuses the pixels of the image if it has the right size, or a pooled
+	// buffer otherwise:
+	if (out_img.isExternallyStored()) out_img = mrpt::img::CImage();
+	out_img.resize(
+		width, height, grayscale ? mrpt::img::CH_GRAY : mrpt::img::CH_RGB);
+
+	uint8_t* dst[4] = {out_img.ptrLine<uint8_t>(0), nullptr, nullptr, nullptr};
+	const int dstStride[4] = {
+		static_cast<int>(out_img.getRowStride()), 0, 0, 0};
+	sws_scale(
+		ctx->img_convert_ctx, src->data, src->linesize, 0, height, dst,
+		dstStride);
+	return true;
+}
 }  // namespace mrpt::hwdrivers
 #endif
 
@@ -175,14 +309,24 @@ bool CFFMPEG_InputStream::openURL(
 	}
 
 	// Get a pointer to the codec context for the video stream
+	const AVCodec* codec = nullptr;
+	if (!decodingOptions.decoderName.empty())
+	{
+		codec = avcodec_find_decoder_by_name(
+			decodingOptions.decoderName.c_str());
+		if (codec == nullptr)
+			std::cerr << "[CFFMPEG_InputStream::openURL] Decoder not found: "
+					  << decodingOptions.decoderName
+					  << ", using the default one." << std::endl;
+	}
 #if LIBAVFORMAT_VERSION_MAJOR >= 57
 	ctx->pCodecPars = ctx->pFormatCtx->streams[ctx->videoStream]->codecpar;
 	// Find the decoder for the video stream
-	const AVCodec* codec = avcodec_find_decoder(ctx->pCodecPars->codec_id);
+	if (!codec) codec = avcodec_find_decoder(ctx->pCodecPars->codec_id);
 #else
 	ctx->pCodecCtx = ctx->pFormatCtx->streams[ctx->videoStream]->codec;
 	// Find the decoder for the video stream
-	codec = avcodec_find_decoder(ctx->pCodecCtx->codec_id);
+	if (!codec) codec = avcodec_find_decoder(ctx->pCodecCtx->codec_id);
 #endif
 	if (codec == nullptr)
 	{
@@ -216,6 +360,54 @@ bool CFFMPEG_InputStream::openURL(
 	ctx->pCodecCtx->codec_id = codec->id;
 #endif
 
+	// Threaded decoding, of several frames at once and/or of slices of
+	// each frame:
+	ctx->pCodecCtx->thread_count = std::max(0, decodingOptions.threads);
+	ctx->pCodecCtx->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+
+#if LIBAVCODEC_VERSION_MAJOR >= 58
+	// Hardware decoding:
+	if (!decodingOptions.hwaccel.empty())
+	{
+		const auto type =
+			av_hwdevice_find_type_by_name(decodingOptions.hwaccel.c_str());
+		for (int i = 0; type != AV_HWDEVICE_TYPE_NONE; i++)
+		{
+			const AVCodecHWConfig* cfg = avcodec_get_hw_config(codec, i);
+			if (!cfg) break;
+			if ((cfg->methods & AV_CODEC_HW_CONFIG_METHOD_HW_DEVICE_CTX) &&
+				cfg->device_type == type)
+			{
+				ctx->hwPixFmt = cfg->pix_fmt;
+				break;
+			}
+		}
+		const auto& dev = decodingOptions.hwaccelDevice;
+		if (ctx->hwPixFmt != AV_PIX_FMT_NONE &&
+			av_hwdevice_ctx_create(
+				&ctx->hwDeviceCtx, type, dev.empty() ? nullptr : dev.c_str(),
+				nullptr, 0) < 0)
+			ctx->hwPixFmt = AV_PIX_FMT_NONE;
+
+		if (ctx->hwPixFmt != AV_PIX_FMT_NONE)
+		{
+			ctx->pCodecCtx->hw_device_ctx = av_buffer_ref(ctx->hwDeviceCtx);
+			ctx->pCodecCtx->opaque = ctx;
+			ctx->pCodecCtx->get_format = &getHardwareFormat;
+		}
+		else
+			std::cerr << "[CFFMPEG_InputStream::openURL] Hardware decoding '"
+					  << decodingOptions.hwaccel
+					  << "' not available, using software decoding."
+					  << std::endl;
+	}
+#else
+	if (!decodingOptions.hwaccel.empty())
+		std::cerr << "[CFFMPEG_InputStream::openURL] Hardware decoding "
+					 "requires libavcodec >=58."
+				  << std::endl;
+#endif
+
 	// Open codec
 	if (avcodec_open2(ctx->pCodecCtx, codec, nullptr) < 0)
 	{
@@ -225,12 +417,11 @@ bool CFFMPEG_InputStream::openURL(
 		return false;
 	}
 
-	// Allocate video frame
+	// Allocate video frames
 	ctx->pFrame = av_frame_alloc();
-	// Allocate an AVFrame structure
-	ctx->pFrameRGB = av_frame_alloc();
+	ctx->pFrameSW = av_frame_alloc();
 
-	if (ctx->pFrameRGB == nullptr || ctx->pFrame == nullptr)
+	if (ctx->pFrame == nullptr || ctx->pFrameSW == nullptr)
 	{
 		std::cerr << "[CFFMPEG_InputStream::openURL] Could not alloc memory "
 					 "for frame buffers: "
@@ -238,31 +429,9 @@ bool CFFMPEG_InputStream::openURL(
 		return false;
 	}
 
-	// Determine required buffer size and allocate buffer
-#if LIBAVFORMAT_VERSION_MAJOR >= 57
-	const auto width = ctx->pCodecPars->width, height = ctx->pCodecPars->height;
-#else
-	const auto width = ctx->pCodecCtx->width, height = ctx->pCodecCtx->height;
-#endif
-	int numBytes = av_image_get_buffer_size(
-		m_grab_as_grayscale ? AV_PIX_FMT_GRAY8 : AV_PIX_FMT_BGR24, width,
-		height, 1);
-	if (numBytes < 0)
-	{
-		std::cerr << "[CFFMPEG_InputStream::openURL] av_image_get_buffer_size "
-					 "error code: "
-				  << numBytes << std::endl;
-		return false;
-	}
-
-	ctx->buffer.resize(numBytes);
-
-	// Assign appropriate parts of buffer to image planes in pFrameRGB
-
-	av_image_fill_arrays(
-		ctx->pFrameRGB->data, ctx->pFrameRGB->linesize, &ctx->buffer[0],
-		m_grab_as_grayscale ? AV_PIX_FMT_GRAY8 : AV_PIX_FMT_BGR24, width,
-		height, 1);
+	ctx->eof = false;
+	ctx->seekTarget = -1;
+	ctx->lastFrameTime = -1;
 
 	return true;  // OK.
 #else
@@ -283,7 +452,12 @@ void CFFMPEG_InputStream::close()
 	// Close the codec
 	if (ctx->pCodecCtx)
 	{
+#if LIBAVFORMAT_VERSION_MAJOR >= 57
+		// Allocated by us:
+		avcodec_free_context(&ctx->pCodecCtx);
+#else
 		avcodec_close(ctx->pCodecCtx);
+#endif
 		ctx->pCodecCtx = nullptr;
 	}
 
@@ -295,12 +469,10 @@ void CFFMPEG_InputStream::close()
 	}
 
 	// Free frames memory:
-	ctx->buffer.clear();
-
-	if (ctx->pFrameRGB)
+	if (ctx->pFrameSW)
 	{
-		av_frame_free(&ctx->pFrameRGB);
-		ctx->pFrameRGB = nullptr;
+		av_frame_free(&ctx->pFrameSW);
+		ctx->pFrameSW = nullptr;
 	}
 	if (ctx->pFrame)
 	{
@@ -314,6 +486,9 @@ void CFFMPEG_InputStream::close()
 		ctx->img_convert_ctx = nullptr;
 	}
 
+	if (ctx->hwDeviceCtx) av_buffer_unref(&ctx->hwDeviceCtx);
+	ctx->hwPixFmt = AV_PIX_FMT_NONE;
+
 #endif
 }
 
@@ -327,97 +502,85 @@ bool CFFMPEG_InputStream::retrieveFrame(mrpt::img::CImage& out_img)
 
 	TFFMPEGContext* ctx = &m_impl->m_state;
 
-	AVPacket packet;
-
-#if LIBAVFORMAT_VERSION_MAJOR < 57
-	int frameFinished;
-#endif
-
-#if LIBAVFORMAT_VERSION_MAJOR >= 57
-	const auto width = ctx->pCodecPars->width, height = ctx->pCodecPars->height;
-#else
-	const auto width = ctx->pCodecCtx->width, height = ctx->pCodecCtx->height;
-#endif
-
-	while (av_read_frame(ctx->pFormatCtx, &packet) >= 0)
+	// Get the frames already decoded, feeding the decoder with new packets
+	// only when it needs them:
+	for (;;)
 	{
-		// Is this a packet from the video stream?
-		if (packet.stream_index != ctx->videoStream)
+#if LIBAVFORMAT_VERSION_MAJOR >= 57
+		const int ret = avcodec_receive_frame(ctx->pCodecCtx, ctx->pFrame);
+		if (ret == AVERROR_EOF) return false;
+		if (ret == AVERROR(EAGAIN))
 		{
-			av_packet_unref(&packet);
+			if (!sendNextPacket(ctx)) return false;
 			continue;
 		}
-
-		// Decode video frame
-#if LIBAVFORMAT_VERSION_MAJOR >= 57
-		int ret = avcodec_send_packet(ctx->pCodecCtx, &packet);
 		if (ret < 0)
 		{
-			std::cerr << std::endl
-					  << "[CFFMPEG_InputStream] avcodec_send_packet error code="
-					  << ret << std::endl
-					  << std::endl;
+			std::cerr << "[CFFMPEG_InputStream] avcodec_receive_frame "
+						 "error code="
+					  << ret << std::endl;
 			return false;
 		}
-		while (ret >= 0)
+#else
+		if (!sendNextPacket(ctx)) return false;
+#endif
+
+		const double t = frameTime(ctx);
+		if (ctx->seekTarget >= 0)
 		{
-			ret = avcodec_receive_frame(ctx->pCodecCtx, ctx->pFrame);
-			if (ret == AVERROR(EAGAIN)) continue;
+			// Decoded from the previous key frame, but not wanted:
+			if (t >= 0 && t < ctx->seekTarget - 1e-6) continue;
+			ctx->seekTarget = -1;
+		}
+		ctx->lastFrameTime = t;
 
-			if (ret == AVERROR_EOF) return false;
-			else if (ret < 0)
-			{
-				std::cerr << std::endl
-						  << "[CFFMPEG_InputStream] avcodec_receive_frame "
-							 "error code="
-						  << ret << std::endl
-						  << std::endl;
-				return false;
-			}
+		return convertFrame(ctx, m_grab_as_grayscale, out_img);
+	}
+#else
+	return false;
+#endif
+}
 
+/* --------------------------------------------------------
+					seekToTime
+   -------------------------------------------------------- */
+bool CFFMPEG_InputStream::seekToTime(double t)
+{
+#if MRPT_HAS_FFMPEG
+	if (!this->isOpen()) return false;
+
+	TFFMPEGContext* ctx = &m_impl->m_state;
+	const AVStream* st = ctx->pFormatCtx->streams[ctx->videoStream];
+	const int64_t start = st->start_time != AV_NOPTS_VALUE ? st->start_time : 0;
+	const auto target = start + static_cast<int64_t>(t / av_q2d(st->time_base));
+
+	// To the previous key frame:
+	if (av_seek_frame(
+			ctx->pFormatCtx, ctx->videoStream, target, AVSEEK_FLAG_BACKWARD) <
+		0)
+		return false;
+	avcodec_flush_buffers(ctx->pCodecCtx);
+	ctx->eof = false;
+	ctx->seekTarget = std::max(0.0, t);
+	return true;
 #else
-		avcodec_decode_video2(
-			ctx->pCodecCtx, ctx->pFrame, &frameFinished, &packet);
-		if (!frameFinished)
-		{
-			// Free the packet that was allocated by av_read_frame
-			av_packet_unref(&packet);
-			continue;
-		}
+	return false;
 #endif
-			// Convert the image from its native format to RGB:
-			ctx->img_convert_ctx = sws_getCachedContext(
-				ctx->img_convert_ctx, width, height, ctx->pCodecCtx->pix_fmt,
-				width, height,
-				m_grab_as_grayscale ?  // BGR vs. RGB for OpenCV
-					AV_PIX_FMT_GRAY8
-									: AV_PIX_FMT_BGR24,
-				SWS_BICUBIC, nullptr, nullptr, nullptr);
-
-			sws_scale(
-				ctx->img_convert_ctx, ctx->pFrame->data, ctx->pFrame->linesize,
-				0, height, ctx->pFrameRGB->data, ctx->pFrameRGB->linesize);
-
-			// std::cout << "[retrieveFrame] Generating image: " <<
-			// ctx->pCodecPars->width << "x" << ctx->pCodecPars->height
-			// << std::endl; std::cout << "  linsize: " <<
-			// ctx->pFrameRGB->linesize[0] << std::endl;
-
-			if (ctx->pFrameRGB->linesize[0] !=
-				((m_grab_as_grayscale ? 1 : 3) * width))
-				THROW_EXCEPTION("FIXME: linesize!=width case not handled yet.");
-
-			out_img.loadFromMemoryBuffer(
-				width, height, !m_grab_as_grayscale, ctx->pFrameRGB->data[0]);
-
-			// Free the packet that was allocated by av_read_frame
-			av_packet_unref(&packet);
-			return true;
-		}
-#if LIBAVFORMAT_VERSION_MAJOR >= 57
-	}
+}
+
+double CFFMPEG_InputStream::getLastFrameTime() const
+{
+#if MRPT_HAS_FFMPEG
+	return m_impl->m_state.lastFrameTime;
+#else
+	return -1;
 #endif
-	return false;  // Error reading/ EOF
+}
+
+bool CFFMPEG_InputStream::isHardwareDecoding() const
+{
+#if MRPT_HAS_FFMPEG
+	return isOpen() && m_impl->m_state.hwPixFmt != AV_PIX_FMT_NONE;
 #else
 	return false;
 #endif
@@ -289,30 +289,37 @@ void CGPSInterface::doProcess()
 	auto* stream_serial = dynamic_cast<CSerialPort*>(m_data_stream.get());
 	auto* stream_tcpip = dynamic_cast<CClientTCPSocket*>(m_data_stream.get());
 
-	// Read as many bytes as available:
-	uint8_t buf[0x1000];
-	const size_t to_read =
-		std::min(m_rx_buffer.available() - 1, sizeof(buf) - 1);
+	// Read as many bytes as available (up to 4 KiB per call), straight into
+	// the free space of the rx buffer, which may be split in two spans if it
+	// wraps around its end:
+	size_t toRead = 0x1000;
+	std::array<std::pair<const uint8_t*, size_t>, 2> newData;
+	size_t nSpans = 0;
 	try
 	{
-		size_t nRead = 0;
-		if (to_read > 0)
 		{
 			std::lock_guard<std::mutex> lock(*m_data_stream_cs);
-			if (stream_tcpip)
-			{ nRead = stream_tcpip->readAsync(buf, to_read, 100, 10); }
-			else if (stream_serial)
+			while (nSpans < newData.size() && toRead > 0)
 			{
-				nRead = stream_serial->Read(buf, to_read);
-			}
-			else
-			{
-				nRead = m_data_stream->Read(buf, to_read);
+				size_t n;
+				uint8_t* p = m_rx_buffer.prepare_write(n);
+				n = std::min(n, toRead);
+				if (!n) break;
+				size_t nRead;
+				if (stream_tcpip)
+					nRead =
+						stream_tcpip->readAsync(p, n, nSpans ? 10 : 100, 10);
+				else if (stream_serial)
+					nRead = stream_serial->Read(p, n);
+				else
+					nRead = m_data_stream->Read(p, n);
+				m_rx_buffer.commit_write(nRead);
+				newData[nSpans++] = {p, nRead};
+				toRead -= nRead;
+				if (nRead < n) break;
 			}
 		}
 
-		if (nRead) m_rx_buffer.push_many(buf, nRead);
-
 		// Also dump to raw file:
 		if (!m_raw_dump_file_prefix.empty() &&
 			!m_raw_output_file.fileOpenCorrectly())
@@ -335,8 +342,11 @@ void CGPSInterface::doProcess()
 						  << sFileName << "`\n";
 			m_raw_output_file.open(sFileName, mrpt::io::OpenMode::TRUNCATE);
 		}
-		if (nRead && m_raw_output_file.fileOpenCorrectly())
-		{ m_raw_output_file.Write(buf, nRead); }
+		if (m_raw_output_file.fileOpenCorrectly())
+			for (size_t i = 0; i < nSpans; i++)
+				if (newData[i].second)
+					m_raw_output_file.Write(
+						newData[i].first, newData[i].second);
 	}
 	catch (std::exception&)
 	{
@@ -433,7 +443,7 @@ void CGPSInterface::flushParsedMessagesNow()
 	else
 		m_just_parsed_messages.sensorLabel = m_sensorLabel;
 	// Add observation to the output queue:
-	CObservationGPS::Ptr newObs = std::make_shared<CObservationGPS>();
+	CObservationGPS::Ptr newObs = getRecycledObservation();
 	m_just_parsed_messages.swap(*newObs);
 	CGenericSensor::appendObservation(newObs);
 	m_just_parsed_messages.clear();
@@ -444,6 +454,46 @@ void CGPSInterface::flushParsedMessagesNow()
 	m_state = ssWorking;
 }
 
+CObservationGPS::Ptr CGPSInterface::getRecycledObservation()
+{
+	// Max. number of observations in the user side before allocating more:
+	constexpr size_t OBS_POOL_SIZE = 32;
+
+	for (auto& o : m_obs_pool)
+	{
+		// Only this pool holds it?
+		if (o.use_count() != 1) continue;
+
+		// Keep its messages to parse new ones into them:
+		m_recycled_msgs.merge(o->messages);
+		o->clear();
+		o->has_satellite_timestamp = false;
+		return o;
+	}
+
+	// Replace the oldest observation, if the user keeps all of them:
+	auto o = std::make_shared<CObservationGPS>();
+	if (m_obs_pool.size() < OBS_POOL_SIZE) m_obs_pool.push_back(o);
+	else
+	{
+		m_obs_pool[m_obs_pool_next] = o;
+		m_obs_pool_next = (m_obs_pool_next + 1) % OBS_POOL_SIZE;
+	}
+	return o;
+}
+
+const uint8_t* CGPSInterface::peekRxFrame(size_t len)
+{
+	size_t nContiguous;
+	const uint8_t* p = m_rx_buffer.peek_contiguous(nContiguous);
+	if (nContiguous >= len) return p;
+
+	// The frame wraps around the end of the circular buffer:
+	if (m_rx_frame.size() < len) m_rx_frame.resize(len);
+	m_rx_buffer.peek_many(m_rx_frame.data(), len);
+	return m_rx_frame.data();
+}
+
 /* -----------------------------------------------------
 					parseBuffer
 ----------------------------------------------------- */
@@ -13,6 +13,9 @@
 #include <mrpt/system/filesystem.h>
 #include <mrpt/system/os.h>
 
+#include <array>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 
 using namespace mrpt::hwdrivers;
@@ -22,6 +25,108 @@ using namespace std;
 
 const size_t MAX_NMEA_LINE_LENGTH = 1024;
 
+namespace
+{
+/** A field in a NMEA line, referring to the original characters */
+struct NMEAToken
+{
+	const char* p = nullptr;
+	size_t n = 0;
+
+	size_t size() const { return n; }
+	bool empty() const { return n == 0; }
+	char operator[](size_t i) const { return p[i]; }
+	bool operator==(const char* s) const
+	{
+		return std::strlen(s) == n && std::memcmp(p, s, n) == 0;
+	}
+	bool operator!=(const char* s) const { return !(*this == s); }
+
+	/** Like atof() of the field, from its `from`-th character */
+	double toDouble(size_t from = 0) const
+	{
+		char buf[32];
+		return std::atof(toCString(buf, sizeof(buf), from));
+	}
+	/** Like atoi() of the field, from its `from`-th character */
+	int toInt(size_t from = 0) const
+	{
+		char buf[32];
+		return std::atoi(toCString(buf, sizeof(buf), from));
+	}
+
+   private:
+	const char* toCString(char* buf, size_t bufLen, size_t from) const
+	{
+		const size_t len = from < n ? std::min(n - from, bufLen - 1) : 0;
+		if (len) std::memcpy(buf, p + from, len);
+		buf[len] = '\0';
+		return buf;
+	}
+};
+
+/** Fields of a NMEA line, split as with mrpt::system::tokenize() without
+ * skipping empty ones, and trimmed. */
+struct NMEATokens
+{
+	static constexpr size_t MAX_TOKENS = 64;
+	std::array<NMEAToken, MAX_TOKENS> tokens;
+	size_t count = 0;
+
+	NMEATokens(const char* s, size_t len)
+	{
+		size_t start = 0;
+		for (size_t pos = 0; pos <= len && count < MAX_TOKENS; pos++)
+		{
+			if (pos < len && !std::strchr("*,\t\r\n", s[pos])) continue;
+			size_t b = start, e = pos;
+			while (b < e && (s[b] == ' ' || s[b] == '\t'))
+				b++;
+			while (e > b && (s[e - 1] == ' ' || s[e - 1] == '\t'))
+				e--;
+			tokens[count++] = {s + b, e - b};
+			start = pos + 1;
+		}
+	}
+
+	size_t size() const { return count; }
+	NMEAToken& operator[](size_t i) { return tokens[i]; }
+	const NMEAToken& operator[](size_t i) const { return tokens[i]; }
+};
+
+/** Stores a copy of `msg` in `obs`, reusing the existing object of the same
+ * type, if any, or one from `recycled`, if not null. */
+template <class MSG_CLASS>
+void storeMsg(
+	CObservationGPS& obs, const MSG_CLASS& msg,
+	CObservationGPS::message_list_t* recycled)
+{
+	const auto type =
+		static_cast<gnss::gnss_message_type_t>(MSG_CLASS::msg_type);
+	if (auto it = obs.messages.find(type); it != obs.messages.end())
+	{
+		if (auto* m = dynamic_cast<MSG_CLASS*>(it->second.get()); m)
+		{
+			*m = msg;
+			return;
+		}
+	}
+	else if (recycled)
+	{
+		if (auto it2 = recycled->find(type); it2 != recycled->end() &&
+			dynamic_cast<MSG_CLASS*>(it2->second.get()))
+		{
+			// Move the map node with its message, without allocations:
+			auto node = recycled->extract(it2);
+			*dynamic_cast<MSG_CLASS*>(node.mapped().get()) = msg;
+			obs.messages.insert(std::move(node));
+			return;
+		}
+	}
+	obs.setMsg(msg);
+}
+}  // namespace
+
 bool CGPSInterface::implement_parser_NMEA(size_t& out_minimum_rx_buf_to_decide)
 {
 	out_minimum_rx_buf_to_decide = 3;
@@ -55,43 +160,46 @@ bool CGPSInterface::implement_parser_NMEA(size_t& out_minimum_rx_buf_to_decide)
 	if (!recognized) return false;
 
 	// It starts OK: try to find the end of the line
-	std::string line;
+	size_t lineLen = 0;
 	bool line_is_ended = false;
-	for (size_t i = 0; i < nBytesAval && i < MAX_NMEA_LINE_LENGTH; i++)
+	for (; lineLen < nBytesAval && lineLen < MAX_NMEA_LINE_LENGTH; lineLen++)
 	{
-		const char val = static_cast<char>(m_rx_buffer.peek(i));
+		const char val = static_cast<char>(m_rx_buffer.peek(lineLen));
 		if (val == '\r' || val == '\n')
 		{
 			line_is_ended = true;
 			break;
 		}
-		line.push_back(val);
 	}
 	if (line_is_ended)
 	{
-		// Pop from buffer:
-		for (size_t i = 0; i < line.size(); i++)
-			m_rx_buffer.pop();
-
-		// Parse:
+		// Parse in place:
+		const char* line = reinterpret_cast<const char*>(peekRxFrame(lineLen));
 		const bool did_have_gga = m_just_parsed_messages.has_GGA_datum();
 		if (CGPSInterface::parse_NMEA(
-				line, m_just_parsed_messages, false /*verbose*/))
+				line, lineLen, m_just_parsed_messages, false /*verbose*/,
+				&m_recycled_msgs))
 		{
 			// Parsers must set only the part of the msg type:
 			m_just_parsed_messages.sensorLabel = "NMEA";
 
 			// Save GGA cache (useful for NTRIP,...)
 			const bool now_has_gga = m_just_parsed_messages.has_GGA_datum();
-			if (now_has_gga && !did_have_gga) { m_last_GGA = line; }
+			if (now_has_gga && !did_have_gga) m_last_GGA.assign(line, lineLen);
 		}
 		else
 		{
 			if (m_verbose)
+			{
 				std::cerr << "[CGPSInterface::implement_parser_NMEA] Line "
-							 "of unknown format ignored: `"
-						  << line << "`\n";
+							 "of unknown format ignored: `";
+				std::cerr.write(line, lineLen);
+				std::cerr << "`\n";
+			}
 		}
+
+		// Pop from buffer:
+		m_rx_buffer.discard(lineLen);
 		return true;
 	}
 	else
@@ -108,30 +216,43 @@ bool CGPSInterface::implement_parser_NMEA(size_t& out_minimum_rx_buf_to_decide)
 bool CGPSInterface::parse_NMEA(
 	const std::string& s, mrpt::obs::CObservationGPS& out_obs,
 	const bool verbose)
+{
+	return parse_NMEA(s.data(), s.size(), out_obs, verbose);
+}
+
+bool CGPSInterface::parse_NMEA(
+	const char* s, size_t len, mrpt::obs::CObservationGPS& out_obs,
+	const bool verbose,
+	mrpt::obs::CObservationGPS::message_list_t* recycledMsgs)
 {
 	static mrpt::system::TTimeStamp last_known_date =
 		mrpt::system::now();  // For building complete date+time in msgs without
 	// a date.
 	static mrpt::system::TTimeStamp last_known_time = mrpt::system::now();
 
-	if (verbose) cout << "[CGPSInterface] GPS raw string: " << s << endl;
+	if (verbose)
+	{
+		cout << "[CGPSInterface] GPS raw string: ";
+		cout.write(s, len);
+		cout << endl;
+	}
 
 	// Firstly! If the string does not start with "$GP" it is not valid:
-	if (s.size() < 7) return false;
+	if (len < 7) return false;
 	if (s[0] != '$') return false;
 
-	std::vector<std::string> lstTokens;
-	mrpt::system::tokenize(
-		s, "*,\t\r\n", lstTokens, false /* do not skip blank tokens */);
+	// Split into trimmed fields, without skipping blank ones:
+	NMEATokens lstTokens(s, len);
 	if (lstTokens.size() < 3) return false;
 
-	for (auto& lstToken : lstTokens)
-		lstToken = mrpt::system::trim(lstToken);  // Trim whitespaces
-
 	bool parsed_ok = false;
 
 	// Remove talker ID "$xxGGA" ==> "GGA"
-	if (lstTokens[0].size() > 3) lstTokens[0] = lstTokens[0].substr(3);
+	if (lstTokens[0].size() > 3)
+	{
+		lstTokens[0].p += 3;
+		lstTokens[0].n -= 3;
+	}
 
 	// Try to determine the kind of command:
 	if (lstTokens[0] == "GGA" && lstTokens.size() >= 13)
@@ -140,7 +261,7 @@ bool CGPSInterface::parse_NMEA(
 		//					GGA
 		// ---------------------------------------------
 		bool all_fields_ok = true;
-		std::string token;
+		NMEAToken token;
 
 		// Fill out the output structure:
 		gnss::Message_NMEA_GGA gga;
@@ -151,7 +272,7 @@ bool CGPSInterface::parse_NMEA(
 		{
 			gga.fields.UTCTime.hour = 10 * (token[0] - '0') + token[1] - '0';
 			gga.fields.UTCTime.minute = 10 * (token[2] - '0') + token[3] - '0';
-			gga.fields.UTCTime.sec = atof(&(token.c_str()[4]));
+			gga.fields.UTCTime.sec = token.toDouble(4);
 		}
 		else
 			all_fields_ok = false;
@@ -161,7 +282,7 @@ bool CGPSInterface::parse_NMEA(
 		if (token.size() >= 4)
 		{
 			double lat = 10 * (token[0] - '0') + token[1] - '0';
-			lat += atof(&(token.c_str()[2])) / 60.0;
+			lat += token.toDouble(2) / 60.0;
 			gga.fields.latitude_degrees = lat;
 		}
 		else
@@ -179,7 +300,7 @@ bool CGPSInterface::parse_NMEA(
 		{
 			double lat =
 				100 * (token[0] - '0') + 10 * (token[1] - '0') + token[2] - '0';
-			lat += atof(&(token.c_str()[3])) / 60.0;
+			lat += token.toDouble(3) / 60.0;
 			gga.fields.longitude_degrees = lat;
 		}
 		else
@@ -194,18 +315,18 @@ bool CGPSInterface::parse_NMEA(
 		// fix quality:
 		token = lstTokens[6];
 		if (!token.empty())
-			gga.fields.fix_quality = (unsigned char)atoi(token.c_str());
+			gga.fields.fix_quality = (unsigned char)token.toInt();
 
 		// sats:
 		token = lstTokens[7];
 		if (!token.empty())
-			gga.fields.satellitesUsed = (unsigned char)atoi(token.c_str());
+			gga.fields.satellitesUsed = (unsigned char)token.toInt();
 
 		// HDOP:
 		token = lstTokens[8];
 		if (!token.empty())
 		{
-			gga.fields.HDOP = (float)atof(token.c_str());
+			gga.fields.HDOP = (float)token.toDouble();
 			gga.fields.thereis_HDOP = true;
 		}
 
@@ -213,7 +334,7 @@ bool CGPSInterface::parse_NMEA(
 		token = lstTokens[9];
 		if (token.empty()) all_fields_ok = false;
 		else
-			gga.fields.altitude_meters = atof(token.c_str());
+			gga.fields.altitude_meters = token.toDouble();
 
 		// Units of the altitude:
 		//		token = lstTokens[10];
@@ -221,7 +342,7 @@ bool CGPSInterface::parse_NMEA(
 
 		// Geoidal separation [B] (undulation)
 		token = lstTokens[11];
-		if (!token.empty()) gga.fields.geoidal_distance = atof(token.c_str());
+		if (!token.empty()) gga.fields.geoidal_distance = token.toDouble();
 
 		// Units of the geoidal separation:
 		//		token = lstTokens[12];
@@ -235,7 +356,7 @@ bool CGPSInterface::parse_NMEA(
 
 		if (all_fields_ok)
 		{
-			out_obs.setMsg(gga);
+			storeMsg(out_obs, gga, recycledMsgs);
 			out_obs.originalReceivedTimestamp = mrpt::system::now();
 			out_obs.timestamp =
 				gga.fields.UTCTime.getAsTimestamp(last_known_date);
@@ -249,7 +370,7 @@ bool CGPSInterface::parse_NMEA(
 		//					GPRMC
 		// ---------------------------------------------
 		bool all_fields_ok = true;
-		std::string token;
+		NMEAToken token;
 
 		// Fill out the output structure:
 		gnss::Message_NMEA_RMC rmc;
@@ -260,7 +381,7 @@ bool CGPSInterface::parse_NMEA(
 		{
 			rmc.fields.UTCTime.hour = 10 * (token[0] - '0') + token[1] - '0';
 			rmc.fields.UTCTime.minute = 10 * (token[2] - '0') + token[3] - '0';
-			rmc.fields.UTCTime.sec = atof(&(token.c_str()[4]));
+			rmc.fields.UTCTime.sec = token.toDouble(4);
 		}
 		else
 			all_fields_ok = false;
@@ -269,14 +390,14 @@ bool CGPSInterface::parse_NMEA(
 		token = lstTokens[2];
 		if (token.empty()) all_fields_ok = false;
 		else
-			rmc.fields.validity_char = token.c_str()[0];
+			rmc.fields.validity_char = token[0];
 
 		// Latitude:
 		token = lstTokens[3];
 		if (token.size() >= 4)
 		{
 			double lat = 10 * (token[0] - '0') + token[1] - '0';
-			lat += atof(&(token.c_str()[2])) / 60.0;
+			lat += token.toDouble(2) / 60.0;
 			rmc.fields.latitude_degrees = lat;
 		}
 		else
@@ -294,7 +415,7 @@ bool CGPSInterface::parse_NMEA(
 		{
 			double lat =
 				100 * (token[0] - '0') + 10 * (token[1] - '0') + token[2] - '0';
-			lat += atof(&(token.c_str()[3])) / 60.0;
+			lat += token.toDouble(3) / 60.0;
 			rmc.fields.longitude_degrees = lat;
 		}
 		else
@@ -308,11 +429,11 @@ bool CGPSInterface::parse_NMEA(
 
 		// Speed:
 		token = lstTokens[7];
-		if (!token.empty()) rmc.fields.speed_knots = atof(token.c_str());
+		if (!token.empty()) rmc.fields.speed_knots = token.toDouble();
 
 		// Direction:
 		token = lstTokens[8];
-		if (!token.empty()) rmc.fields.direction_degrees = atof(token.c_str());
+		if (!token.empty()) rmc.fields.direction_degrees = token.toDouble();
 
 		// Date:
 		token = lstTokens[9];
@@ -320,7 +441,7 @@ bool CGPSInterface::parse_NMEA(
 		{
 			rmc.fields.date_day = 10 * (token[0] - '0') + token[1] - '0';
 			rmc.fields.date_month = 10 * (token[2] - '0') + token[3] - '0';
-			rmc.fields.date_year = atoi(&(token.c_str()[4]));
+			rmc.fields.date_year = token.toInt(4);
 		}
 		else
 			all_fields_ok = false;
@@ -329,7 +450,7 @@ bool CGPSInterface::parse_NMEA(
 		token = lstTokens[10];
 		if (token.size() >= 2)
 		{
-			rmc.fields.magnetic_dir = atof(token.c_str());
+			rmc.fields.magnetic_dir = token.toDouble();
 			// E/W:
 			token = lstTokens[11];
 			if (token.empty()) all_fields_ok = false;
@@ -344,14 +465,14 @@ bool CGPSInterface::parse_NMEA(
 			token = lstTokens[12];
 			if (token.empty()) all_fields_ok = false;
 			else
-				rmc.fields.positioning_mode = token.c_str()[0];
+				rmc.fields.positioning_mode = token[0];
 		}
 		else
 			rmc.fields.positioning_mode = 'A';	// Default for older receiver
 
 		if (all_fields_ok)
 		{
-			out_obs.setMsg(rmc);
+			storeMsg(out_obs, rmc, recycledMsgs);
 			out_obs.originalReceivedTimestamp = mrpt::system::now();
 			out_obs.timestamp =
 				rmc.fields.UTCTime.getAsTimestamp(rmc.getDateAsTimestamp());
@@ -367,7 +488,7 @@ bool CGPSInterface::parse_NMEA(
 		//					GPGLL
 		// ---------------------------------------------
 		bool all_fields_ok = true;
-		std::string token;
+		NMEAToken token;
 
 		// Fill out the output structure:
 		gnss::Message_NMEA_GLL gll;
@@ -376,7 +497,7 @@ bool CGPSInterface::parse_NMEA(
 		if (token.size() >= 4)
 		{
 			double lat = 10 * (token[0] - '0') + token[1] - '0';
-			lat += atof(&(token.c_str()[2])) / 60.0;
+			lat += token.toDouble(2) / 60.0;
 			gll.fields.latitude_degrees = lat;
 		}
 		else
@@ -394,7 +515,7 @@ bool CGPSInterface::parse_NMEA(
 		{
 			double lat =
 				100 * (token[0] - '0') + 10 * (token[1] - '0') + token[2] - '0';
-			lat += atof(&(token.c_str()[3])) / 60.0;
+			lat += token.toDouble(3) / 60.0;
 			gll.fields.longitude_degrees = lat;
 		}
 		else
@@ -416,7 +537,7 @@ bool CGPSInterface::parse_NMEA(
 					10 * (token[0] - '0') + token[1] - '0';
 				gll.fields.UTCTime.minute =
 					10 * (token[2] - '0') + token[3] - '0';
-				gll.fields.UTCTime.sec = atof(&(token.c_str()[4]));
+				gll.fields.UTCTime.sec = token.toDouble(4);
 			}
 			else
 				all_fields_ok = false;
@@ -425,12 +546,12 @@ bool CGPSInterface::parse_NMEA(
 			token = lstTokens[6];
 			if (token.empty()) all_fields_ok = false;
 			else
-				gll.fields.validity_char = token.c_str()[0];
+				gll.fields.validity_char = token[0];
 		}
 
 		if (all_fields_ok)
 		{
-			out_obs.setMsg(gll);
+			storeMsg(out_obs, gll, recycledMsgs);
 			out_obs.originalReceivedTimestamp = mrpt::system::now();
 			out_obs.timestamp =
 				gll.fields.UTCTime.getAsTimestamp(last_known_date);
@@ -445,15 +566,15 @@ bool CGPSInterface::parse_NMEA(
 		//					GPVTG
 		// ---------------------------------------------
 		bool all_fields_ok = true;
-		std::string token;
+		NMEAToken token;
 
 		// Fill out the output structure:
 		gnss::Message_NMEA_VTG vtg;
 
-		vtg.fields.true_track = atof(lstTokens[1].c_str());
-		vtg.fields.magnetic_track = atof(lstTokens[3].c_str());
-		vtg.fields.ground_speed_knots = atof(lstTokens[5].c_str());
-		vtg.fields.ground_speed_kmh = atof(lstTokens[7].c_str());
+		vtg.fields.true_track = lstTokens[1].toDouble();
+		vtg.fields.magnetic_track = lstTokens[3].toDouble();
+		vtg.fields.ground_speed_knots = lstTokens[5].toDouble();
+		vtg.fields.ground_speed_kmh = lstTokens[7].toDouble();
 
 		if (lstTokens[2] != "T" || lstTokens[4] != "M" || lstTokens[6] != "N" ||
 			lstTokens[8] != "K")
@@ -461,7 +582,7 @@ bool CGPSInterface::parse_NMEA(
 
 		if (all_fields_ok)
 		{
-			out_obs.setMsg(vtg);
+			storeMsg(out_obs, vtg, recycledMsgs);
 			out_obs.originalReceivedTimestamp = mrpt::system::now();
 			out_obs.timestamp = last_known_time;
 			out_obs.has_satellite_timestamp = false;
@@ -474,7 +595,7 @@ bool CGPSInterface::parse_NMEA(
 		//					GPZDA
 		// ---------------------------------------------
 		bool all_fields_ok = true;
-		std::string token;
+		NMEAToken token;
 
 		// Fill out the output structure:
 		gnss::Message_NMEA_ZDA zda;
@@ -492,24 +613,24 @@ bool CGPSInterface::parse_NMEA(
 		{
 			zda.fields.UTCTime.hour = 10 * (token[0] - '0') + token[1] - '0';
 			zda.fields.UTCTime.minute = 10 * (token[2] - '0') + token[3] - '0';
-			zda.fields.UTCTime.sec = atof(&(token.c_str()[4]));
+			zda.fields.UTCTime.sec = token.toDouble(4);
 		}
 		else
 			all_fields_ok = false;
 
 		// Day:
 		token = lstTokens[2];
-		if (!token.empty()) zda.fields.date_day = atoi(token.c_str());
+		if (!token.empty()) zda.fields.date_day = token.toInt();
 		// Month:
 		token = lstTokens[3];
-		if (!token.empty()) zda.fields.date_month = atoi(token.c_str());
+		if (!token.empty()) zda.fields.date_month = token.toInt();
 		// Year:
 		token = lstTokens[4];
-		if (!token.empty()) zda.fields.date_year = atoi(token.c_str());
+		if (!token.empty()) zda.fields.date_year = token.toInt();
 
 		if (all_fields_ok)
 		{
-			out_obs.setMsg(zda);
+			storeMsg(out_obs, zda, recycledMsgs);
 			out_obs.originalReceivedTimestamp = mrpt::system::now();
 			try
 			{
@@ -532,7 +653,7 @@ bool CGPSInterface::parse_NMEA(
 		//					GSA
 		// ---------------------------------------------
 		bool all_fields_ok = true;
-		std::string token;
+		NMEAToken token;
 
 		// Fill out the output structure:
 		gnss::Message_NMEA_GSA gsa;
@@ -565,13 +686,13 @@ bool CGPSInterface::parse_NMEA(
 			if (token.size() > 1) gsa.fields.PRNs[i][1] = token[1];
 		}
 		// PDOP:
-		gsa.fields.PDOP = ::atof(lstTokens[3 + 12 + 0].data());
-		gsa.fields.HDOP = ::atof(lstTokens[3 + 12 + 1].data());
-		gsa.fields.VDOP = ::atof(lstTokens[3 + 12 + 2].data());
+		gsa.fields.PDOP = lstTokens[3 + 12 + 0].toDouble();
+		gsa.fields.HDOP = lstTokens[3 + 12 + 1].toDouble();
+		gsa.fields.VDOP = lstTokens[3 + 12 + 2].toDouble();
 
 		if (all_fields_ok)
 		{
-			out_obs.setMsg(gsa);
+			storeMsg(out_obs, gsa, recycledMsgs);
 			out_obs.originalReceivedTimestamp = mrpt::system::now();
 		}
 		parsed_ok = all_fields_ok;
@@ -9,18 +9,62 @@
 
 #include "hwdrivers-precomp.h"	// Precompiled headers
 //
+#include <mrpt/core/reverse_bytes.h>
 #include <mrpt/hwdrivers/CGPSInterface.h>
 #include <mrpt/io/CMemoryStream.h>
+#include <mrpt/serialization/CArchive.h>
 #include <mrpt/system/crc.h>
 #include <mrpt/system/filesystem.h>
 #include <mrpt/system/os.h>
 
+#include <cstring>
 #include <iostream>
 
 using namespace mrpt::hwdrivers;
 using namespace mrpt::obs;
 using namespace std;
 
+// Bytes before each frame in m_rx_frame, see storeFrame()
+static constexpr size_t FRAME_PREFIX_LEN = 2 * sizeof(uint32_t);
+
+/** Deserializes the frame of `frameLen` bytes stored in `buf` after
+ * FRAME_PREFIX_LEN free bytes as a message of type `msg_id` into
+ * `obs.messages`, reusing the message already there or in `recycled`, if any,
+ * of the same type. */
+static const gnss::gnss_message* storeFrame(
+	uint8_t* buf, uint32_t frameLen, uint32_t msg_id, CObservationGPS& obs,
+	CObservationGPS::message_list_t& recycled)
+{
+	// ------ Serialization format:
+	// const int32_t msg_id = message_type;
+	// out << msg_id;
+	// this->internal_writeToStream(out);  == >  out <<
+	// static_cast<uint32_t>(DATA_LEN); out.WriteBuffer(DATA_PTR,DATA_LEN);
+	// }
+	// ------
+	const uint32_t hdr[2] = {
+		mrpt::toNativeEndianness(msg_id), mrpt::toNativeEndianness(frameLen)};
+	std::memcpy(buf, hdr, FRAME_PREFIX_LEN);
+
+	mrpt::io::CMemoryStream tmpStream;
+	tmpStream.assignMemoryNotOwn(buf, FRAME_PREFIX_LEN + frameLen);
+	auto arch = mrpt::serialization::archiveFrom(tmpStream);
+
+	const auto type = static_cast<gnss::gnss_message_type_t>(msg_id);
+	auto it = obs.messages.find(type);
+	if (it == obs.messages.end())
+	{
+		if (auto itRec = recycled.find(type); itRec != recycled.end())
+			it = obs.messages.insert(recycled.extract(itRec)).position;
+	}
+	if (it != obs.messages.end() && it->second.get())
+		it->second->readFromStream(arch);
+	else
+		obs.messages[type].set(
+			gnss::gnss_message::readAndBuildFromStream(arch));
+	return obs.messages[type].get();
+}
+
 bool CGPSInterface::implement_parser_NOVATEL_OEM6(
 	size_t& out_minimum_rx_buf_to_decide)
 {
@@ -73,11 +117,11 @@ bool CGPSInterface::implement_parser_NOVATEL_OEM6(
 			return true;  // we must wait for more data in the buffer
 		}
 
-		std::vector<uint8_t> buf(expected_total_msg_len);
-		m_rx_buffer.pop_many(reinterpret_cast<uint8_t*>(&buf[0]), sizeof(hdr));
-		m_rx_buffer.pop_many(
-			reinterpret_cast<uint8_t*>(&buf[sizeof(hdr)]),
-			hdr.msg_len + 4 /*crc*/);
+		if (m_rx_frame.size() < FRAME_PREFIX_LEN + expected_total_msg_len)
+			m_rx_frame.resize(FRAME_PREFIX_LEN + expected_total_msg_len);
+		uint8_t* buf = m_rx_frame.data() + FRAME_PREFIX_LEN;
+		m_rx_buffer.peek_many(buf, expected_total_msg_len);
+		m_rx_buffer.discard(expected_total_msg_len);
 
 		// Check CRC:
 		const uint32_t crc_computed =
@@ -93,33 +137,20 @@ bool CGPSInterface::implement_parser_NOVATEL_OEM6(
 		// 1st, test if we have a specific data structure for this msg_id:
 		const bool use_generic_container = !gnss_message::FactoryKnowsMsgType(
 			(gnss_message_type_t)(NV_OEM6_MSG2ENUM + hdr.msg_id));
-		// ------ Serialization format:
-		// const int32_t msg_id = message_type;
-		// out << msg_id;
-		// this->internal_writeToStream(out);  == >  out <<
-		// static_cast<uint32_t>(DATA_LEN); out.WriteBuffer(DATA_PTR,DATA_LEN);
-		// }
-		// ------
-		mrpt::io::CMemoryStream tmpStream;
-		auto arch = mrpt::serialization::archiveFrom(tmpStream);
 		const uint32_t msg_id = use_generic_container
 			? (uint32_t)(NV_OEM6_GENERIC_SHORT_FRAME)
 			: (uint32_t)hdr.msg_id + NV_OEM6_MSG2ENUM;
-		arch << (uint32_t)(msg_id);
 		// This len = hdr + hdr.msg_len + 4 (crc);
-		arch << (uint32_t)(expected_total_msg_len);
-		arch.WriteBuffer(&buf[0], buf.size());
-
-		tmpStream.Seek(0);
-		gnss_message_ptr msg(gnss_message::readAndBuildFromStream(arch));
-		if (!msg.get())
+		const gnss_message* msg = storeFrame(
+			buf, expected_total_msg_len, msg_id, m_just_parsed_messages,
+			m_recycled_msgs);
+		if (!msg)
 		{
 			std::cerr << "[CGPSInterface::implement_parser_NOVATEL_OEM6] Error "
 						 "parsing binary packet msg_id="
 					  << hdr.msg_id << "\n";
 			return true;
 		}
-		m_just_parsed_messages.messages[msg->message_type] = msg;
 		m_just_parsed_messages.originalReceivedTimestamp = mrpt::system::now();
 		if (!CObservationGPS::GPS_time_to_UTC(
 				hdr.week, hdr.ms_in_week * 1e-3, num_leap_seconds,
@@ -152,11 +183,11 @@ bool CGPSInterface::implement_parser_NOVATEL_OEM6(
 			return true;  // we must wait for more data in the buffer
 		}
 
-		std::vector<uint8_t> buf(expected_total_msg_len);
-		m_rx_buffer.pop_many(reinterpret_cast<uint8_t*>(&buf[0]), sizeof(hdr));
-		m_rx_buffer.pop_many(
-			reinterpret_cast<uint8_t*>(&buf[sizeof(hdr)]),
-			hdr.msg_len + 4 /*crc*/);
+		if (m_rx_frame.size() < FRAME_PREFIX_LEN + expected_total_msg_len)
+			m_rx_frame.resize(FRAME_PREFIX_LEN + expected_total_msg_len);
+		uint8_t* buf = m_rx_frame.data() + FRAME_PREFIX_LEN;
+		m_rx_buffer.peek_many(buf, expected_total_msg_len);
+		m_rx_buffer.discard(expected_total_msg_len);
 
 		// Check CRC:
 		const uint32_t crc_computed =
@@ -172,38 +203,25 @@ bool CGPSInterface::implement_parser_NOVATEL_OEM6(
 		// 1st, test if we have a specific data structure for this msg_id:
 		const bool use_generic_container = !gnss_message::FactoryKnowsMsgType(
 			(gnss_message_type_t)(NV_OEM6_MSG2ENUM + hdr.msg_id));
-		// ------ Serialization format:
-		// const int32_t msg_id = message_type;
-		// out << msg_id;
-		// this->internal_writeToStream(out);  == >  out <<
-		// static_cast<uint32_t>(DATA_LEN); out.WriteBuffer(DATA_PTR,DATA_LEN);
-		// }
-		// ------
-		mrpt::io::CMemoryStream tmpStream;
-		auto arch = mrpt::serialization::archiveFrom(tmpStream);
-		const int32_t msg_id = use_generic_container
+		const uint32_t msg_id = use_generic_container
 			? (uint32_t)(NV_OEM6_GENERIC_FRAME)
 			: (uint32_t)hdr.msg_id + NV_OEM6_MSG2ENUM;
-		arch << msg_id;
-		arch << (uint32_t)(expected_total_msg_len);
-		arch.WriteBuffer(&buf[0], buf.size());
-
-		tmpStream.Seek(0);
-		gnss_message_ptr msg(gnss_message::readAndBuildFromStream(arch));
-		if (!msg.get())
+		const gnss_message* msg = storeFrame(
+			buf, expected_total_msg_len, msg_id, m_just_parsed_messages,
+			m_recycled_msgs);
+		if (!msg)
 		{
 			std::cerr << "[CGPSInterface::implement_parser_NOVATEL_OEM6] Error "
 						 "parsing binary packet msg_id="
 					  << hdr.msg_id << "\n";
 			return true;
 		}
-		m_just_parsed_messages.messages[msg->message_type] = msg;
 		m_just_parsed_messages.originalReceivedTimestamp = mrpt::system::now();
 		{
 			// Detect NV_OEM6_IONUTC msgs to learn about the current leap
 			// seconds:
 			const auto* ionutc =
-				dynamic_cast<const gnss::Message_NV_OEM6_IONUTC*>(msg.get());
+				dynamic_cast<const gnss::Message_NV_OEM6_IONUTC*>(msg);
 			if (ionutc) num_leap_seconds = ionutc->fields.deltat_ls;
 		}
 		if (!CObservationGPS::GPS_time_to_UTC(
@@ -389,3 +389,69 @@ TEST(CGPSInterface, parse_NMEA_stream)
 	EXPECT_NEAR(msg3->fields.longitude_degrees, -2.407810500, 0.0001);
 	EXPECT_NEAR(msg3->fields.latitude_degrees, 36.829821500, 0.0001);
 }
+
+TEST(CGPSInterface, parse_NMEA_span_recycledMsgs)
+{
+	// A line within a larger, not NUL-terminated buffer:
+	const std::string rx =
+		"$GPRMC,161229.487,A,3723.2475,N,12158.3416,W,0.13,309.62,120598, ,*10"
+		"\r\n$GPRMC,161230";
+	const size_t len = rx.find('\r');
+
+	mrpt::obs::CObservationGPS obs1;
+	EXPECT_TRUE(CGPSInterface::parse_NMEA(rx.data(), len, obs1));
+	const auto* msg1 = obs1.getMsgByClassPtr<gnss::Message_NMEA_RMC>();
+	ASSERT_TRUE(msg1 != nullptr);
+	EXPECT_NEAR(msg1->fields.direction_degrees, 309.62, 1e-10);
+	EXPECT_EQ(msg1->fields.date_year, 98);
+
+	// Messages of released observations are reused:
+	mrpt::obs::CObservationGPS::message_list_t recycled;
+	recycled.swap(obs1.messages);
+
+	const std::string line2 =
+		"$GNRMC,161231.487,A,3723.2475,S,12158.3416,E,0.13,109.62,120598, ,*10";
+	mrpt::obs::CObservationGPS obs2;
+	EXPECT_TRUE(CGPSInterface::parse_NMEA(
+		line2.data(), line2.size(), obs2, false, &recycled));
+	EXPECT_TRUE(recycled.empty());
+	const auto* msg2 = obs2.getMsgByClassPtr<gnss::Message_NMEA_RMC>();
+	EXPECT_EQ(msg2, msg1);
+	ASSERT_TRUE(msg2 != nullptr);
+	EXPECT_NEAR(msg2->fields.latitude_degrees, -(37 + 23.2475 / 60.0), 1e-10);
+	EXPECT_NEAR(msg2->fields.direction_degrees, 109.62, 1e-10);
+}
+
+TEST(CGPSInterface, recycled_observations)
+{
+	auto buf = std::make_shared<mrpt::io::CMemoryStream>();
+	const std::string line =
+		"$GPRMC,161229.487,A,3723.2475,N,12158.3416,W,0.13,309.62,120598, "
+		",*10\r\n";
+
+	CGPSInterface gps;
+	gps.bindStream(buf);
+	gps.initialize();
+
+	const CObservationGPS* lastObs = nullptr;
+	for (int i = 0; i < 3; i++)
+	{
+		// Feed one more line:
+		const auto pos = buf->getPosition();
+		buf->Write(line.data(), line.size());
+		buf->Seek(pos);
+		gps.doProcess();
+
+		mrpt::hwdrivers::CGenericSensor::TListObservations obss;
+		gps.getObservations(obss);
+		ASSERT_EQ(obss.size(), 1U);
+		auto obs = mrpt::ptr_cast<CObservationGPS>::from(obss.begin()->second);
+		ASSERT_TRUE(obs);
+		EXPECT_TRUE(obs->hasMsgClass<gnss::Message_NMEA_RMC>());
+		EXPECT_EQ(obs->messages.size(), 1U);
+
+		// The previous one was released, so it is reused:
+		if (lastObs) { EXPECT_EQ(obs.get(), lastObs); }
+		lastObs = obs.get();
+	}
+}
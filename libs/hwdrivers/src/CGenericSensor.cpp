@@ -47,7 +47,8 @@ void CGenericSensor::appendObservations(
 	{
 		m_grab_decimation_counter = 0;
 
-		std::lock_guard<std::mutex> lock(m_csObjList);
+		std::unique_lock<std::mutex> lock(m_csObjList, std::defer_lock);
+		if (!m_objQueue) lock.lock();
 
 		for (const auto& obj : objs)
 		{
@@ -67,7 +68,10 @@ void CGenericSensor::appendObservations(
 				THROW_EXCEPTION("Passed object must be CObservation.");
 
 			// Add it:
-			m_objList.insert(TListObsPair(timestamp, obj));
+			if (m_objQueue)
+				m_objQueue->push_or_drop(TListObsPair(timestamp, obj));
+			else
+				m_objList.insert(TListObsPair(timestamp, obj));
 		}
 	}
 }
@@ -77,6 +81,15 @@ void CGenericSensor::appendObservations(
 -------------------------------------------------------------*/
 void CGenericSensor::getObservations(TListObservations& lstObjects)
 {
+	if (m_objQueue)
+	{
+		lstObjects.clear();
+		TListObsPair o;
+		while (m_objQueue->try_pop(o))
+			lstObjects.insert(std::move(o));
+		return;
+	}
+
 	std::lock_guard<std::mutex> lock(m_csObjList);
 	lstObjects = m_objList;
 	m_objList.clear();	// Memory of objects will be freed by invoker.
@@ -129,8 +142,22 @@ void CGenericSensor::loadConfig(
 	m_grab_decimation = static_cast<size_t>(
 		cfg.read_int(sect, "grab_decimation", int(m_grab_decimation)));
 
+	m_use_lockfree_queue =
+		cfg.read_bool(sect, "use_lockfree_queue", m_use_lockfree_queue);
+
 	m_sensorLabel = cfg.read_string(sect, "sensorLabel", m_sensorLabel);
 
+	// Note: loadConfig() must be called before the sensor starts grabbing.
+	if (m_use_lockfree_queue)
+	{
+		ASSERT_GE_(m_max_queue_len, 2U);
+		m_objQueue = std::make_unique<
+			mrpt::containers::lockfree_bounded_queue<TListObsPair>>(
+			m_max_queue_len);
+	}
+	else
+		m_objQueue.reset();
+
 	m_grab_decimation_counter = 0;
 
 	loadConfig_sensorSpecific(cfg, sect);
@@ -12,7 +12,9 @@
 #include <mrpt/hwdrivers/CIMUXSens_MT4.h>
 #include <mrpt/obs/CObservationGPS.h>
 #include <mrpt/obs/CObservationIMU.h>
+#include <mrpt/obs/CObservationIMUBatch.h>
 
+#include <cmath>
 #include <iostream>
 #include <thread>
 
@@ -48,8 +50,38 @@ class MyXSensCallback : public XsCallback
 	CIMUXSens_MT4* me = nullptr;
 
    private:
-	//	uint64_t m_timeStartUI = 0;
-	mrpt::system::TTimeStamp m_timeStartTT;
+	/** Samples not sent yet, if m_batchSize>1 */
+	mrpt::obs::CObservationIMUBatch::Ptr m_batch;
+
+	// Hardware timestamps: computer time of the first sample, plus the
+	// elapsed time counted by the device.
+	bool m_hwTimeValid = false;
+	uint32_t m_lastSampleTimeFine = 0;
+	mrpt::system::TTimeStamp m_hwTime;
+
+	/** Returns the timestamp of a sample from its "SampleTimeFine" counter
+	 * (units of 100 us, wrapping at 2^32) */
+	mrpt::system::TTimeStamp hardwareTimestamp(
+		uint32_t sampleTimeFine, mrpt::system::TTimeStamp now)
+	{
+		if (m_hwTimeValid)
+		{
+			// (unsigned arithmetic handles the counter wrap-around)
+			const uint32_t ticks = sampleTimeFine - m_lastSampleTimeFine;
+			m_hwTime += std::chrono::microseconds(100 * uint64_t(ticks));
+		}
+		m_lastSampleTimeFine = sampleTimeFine;
+
+		// Re-synchronize with the computer clock upon start up, lost samples
+		// or too much drift:
+		if (!m_hwTimeValid ||
+			std::abs(mrpt::system::timeDifference(m_hwTime, now)) > 0.1)
+		{
+			m_hwTime = now;
+			m_hwTimeValid = true;
+		}
+		return m_hwTime;
+	}
 
    protected:
 	void onLiveDataAvailable(XsDevice*, const XsDataPacket* ptrpacket) override
@@ -63,130 +95,123 @@ class MyXSensCallback : public XsCallback
 		// Data properly collected: extract data fields
 		// -------------------------------------------------
 		me->m_state = mrpt::hwdrivers::CGenericSensor::ssWorking;
-		CObservationIMU::Ptr obs = std::make_shared<CObservationIMU>();
+
+		// Values of this sample (no per-sample memory allocation, until
+		// they are stored in an observation):
+		std::array<double, COUNT_IMU_DATA_FIELDS> vals;
+		std::array<bool, COUNT_IMU_DATA_FIELDS> present;
+		vals.fill(0);
+		present.fill(false);
 
 		if (packet.containsOrientation())
 		{
 			XsEuler euler = packet.orientationEuler();
-			obs->rawMeasurements[IMU_YAW] = DEG2RAD(euler.yaw());
-			obs->dataIsPresent[IMU_YAW] = true;
-			obs->rawMeasurements[IMU_PITCH] = DEG2RAD(euler.pitch());
-			obs->dataIsPresent[IMU_PITCH] = true;
-			obs->rawMeasurements[IMU_ROLL] = DEG2RAD(euler.roll());
-			obs->dataIsPresent[IMU_ROLL] = true;
+			vals[IMU_YAW] = DEG2RAD(euler.yaw());
+			present[IMU_YAW] = true;
+			vals[IMU_PITCH] = DEG2RAD(euler.pitch());
+			present[IMU_PITCH] = true;
+			vals[IMU_ROLL] = DEG2RAD(euler.roll());
+			present[IMU_ROLL] = true;
 
 			XsQuaternion quat = packet.orientationQuaternion();
-			obs->rawMeasurements[IMU_ORI_QUAT_X] = quat.x();
-			obs->dataIsPresent[IMU_ORI_QUAT_X] = true;
-			obs->rawMeasurements[IMU_ORI_QUAT_Y] = quat.y();
-			obs->dataIsPresent[IMU_ORI_QUAT_Y] = true;
-			obs->rawMeasurements[IMU_ORI_QUAT_Z] = quat.z();
-			obs->dataIsPresent[IMU_ORI_QUAT_Z] = true;
-			obs->rawMeasurements[IMU_ORI_QUAT_W] = quat.w();
-			obs->dataIsPresent[IMU_ORI_QUAT_W] = true;
+			vals[IMU_ORI_QUAT_X] = quat.x();
+			present[IMU_ORI_QUAT_X] = true;
+			vals[IMU_ORI_QUAT_Y] = quat.y();
+			present[IMU_ORI_QUAT_Y] = true;
+			vals[IMU_ORI_QUAT_Z] = quat.z();
+			present[IMU_ORI_QUAT_Z] = true;
+			vals[IMU_ORI_QUAT_W] = quat.w();
+			present[IMU_ORI_QUAT_W] = true;
 		}
 
 		if (packet.containsCalibratedAcceleration())
 		{
 			XsVector acc_data = packet.calibratedAcceleration();
-			obs->rawMeasurements[IMU_X_ACC] = acc_data[0];
-			obs->dataIsPresent[IMU_X_ACC] = true;
-			obs->rawMeasurements[IMU_Y_ACC] = acc_data[1];
-			obs->dataIsPresent[IMU_Y_ACC] = true;
-			obs->rawMeasurements[IMU_Z_ACC] = acc_data[2];
-			obs->dataIsPresent[IMU_Z_ACC] = true;
+			vals[IMU_X_ACC] = acc_data[0];
+			present[IMU_X_ACC] = true;
+			vals[IMU_Y_ACC] = acc_data[1];
+			present[IMU_Y_ACC] = true;
+			vals[IMU_Z_ACC] = acc_data[2];
+			present[IMU_Z_ACC] = true;
 		}
 
 		if (packet.containsCalibratedGyroscopeData())
 		{
 			XsVector gyr_data = packet.calibratedGyroscopeData();
-			obs->rawMeasurements[IMU_YAW_VEL] = gyr_data[2];
-			obs->dataIsPresent[IMU_YAW_VEL] = true;
-			obs->rawMeasurements[IMU_PITCH_VEL] = gyr_data[1];
-			obs->dataIsPresent[IMU_PITCH_VEL] = true;
-			obs->rawMeasurements[IMU_ROLL_VEL] = gyr_data[0];
-			obs->dataIsPresent[IMU_ROLL_VEL] = true;
+			vals[IMU_YAW_VEL] = gyr_data[2];
+			present[IMU_YAW_VEL] = true;
+			vals[IMU_PITCH_VEL] = gyr_data[1];
+			present[IMU_PITCH_VEL] = true;
+			vals[IMU_ROLL_VEL] = gyr_data[0];
+			present[IMU_ROLL_VEL] = true;
 		}
 
 		if (packet.containsCalibratedMagneticField())
 		{
 			XsVector mag_data = packet.calibratedMagneticField();
-			obs->rawMeasurements[IMU_MAG_X] = mag_data[0];
-			obs->dataIsPresent[IMU_MAG_X] = true;
-			obs->rawMeasurements[IMU_MAG_Y] = mag_data[1];
-			obs->dataIsPresent[IMU_MAG_Y] = true;
-			obs->rawMeasurements[IMU_MAG_Z] = mag_data[2];
-			obs->dataIsPresent[IMU_MAG_Z] = true;
+			vals[IMU_MAG_X] = mag_data[0];
+			present[IMU_MAG_X] = true;
+			vals[IMU_MAG_Y] = mag_data[1];
+			present[IMU_MAG_Y] = true;
+			vals[IMU_MAG_Z] = mag_data[2];
+			present[IMU_MAG_Z] = true;
 		}
 
 		if (packet.containsVelocity())
 		{
 			XsVector vel_data = packet.velocity();
-			obs->rawMeasurements[IMU_X_VEL] = vel_data[0];
-			obs->dataIsPresent[IMU_X_VEL] = true;
-			obs->rawMeasurements[IMU_Y_VEL] = vel_data[1];
-			obs->dataIsPresent[IMU_Y_VEL] = true;
-			obs->rawMeasurements[IMU_Z_VEL] = vel_data[2];
-			obs->dataIsPresent[IMU_Z_VEL] = true;
+			vals[IMU_X_VEL] = vel_data[0];
+			present[IMU_X_VEL] = true;
+			vals[IMU_Y_VEL] = vel_data[1];
+			present[IMU_Y_VEL] = true;
+			vals[IMU_Z_VEL] = vel_data[2];
+			present[IMU_Z_VEL] = true;
 		}
 
 		if (packet.containsTemperature())
 		{
-			obs->rawMeasurements[IMU_TEMPERATURE] = packet.temperature();
-			obs->dataIsPresent[IMU_TEMPERATURE] = true;
+			vals[IMU_TEMPERATURE] = packet.temperature();
+			present[IMU_TEMPERATURE] = true;
 		}
 
 		if (packet.containsAltitude())
 		{
-			obs->rawMeasurements[IMU_ALTITUDE] = packet.altitude();
-			obs->dataIsPresent[IMU_ALTITUDE] = true;
+			vals[IMU_ALTITUDE] = packet.altitude();
+			present[IMU_ALTITUDE] = true;
 		}
 
 		// TimeStamp
-#if 0  // I can't find a generic conversion between sample time and seconds!
-		if (packet.containsSampleTime64())
-		{
-		dev->getDataPacketByIndex()
-			const uint64_t nowUI = packet.sampleTime64();
-			std::cout << "nowUI: " << nowUI << "\n";
-
-			uint64_t AtUI = 0;
-			if (m_timeStartUI == 0)
-			{
-				m_timeStartUI = nowUI;
-				m_timeStartTT = mrpt::system::now();
-			}
-			else
-				AtUI = nowUI - m_timeStartUI;  // ms
+		const mrpt::system::TTimeStamp now = mrpt::system::now();
+		mrpt::system::TTimeStamp t = now;
+		if (me->m_useHardwareTimestamps && packet.containsSampleTimeFine())
+			t = hardwareTimestamp(packet.sampleTimeFine(), now);
 
-			obs->timestamp = m_timeStartTT + std::chrono::milliseconds(AtUI);
+		if (me->m_batchSize <= 1)
+		{
+			auto obs = CObservationIMU::Create();
+			obs->rawMeasurements = vals;
+			obs->dataIsPresent = present;
+			obs->timestamp = t;
+			obs->sensorPose = me->m_sensorPose;
+			obs->sensorLabel = me->m_sensorLabel;
+			me->appendObservation(obs);
 		}
 		else
-		if (packet.containsUtcTime())
 		{
-			XsTimeInfo utc = packet.utcTime();
-
-			mrpt::system::TTimeParts parts;
-
-			parts.day_of_week = 0;
-			parts.daylight_saving = 0;
-			parts.year = utc.m_year;
-			parts.month = utc.m_month;
-			parts.day = utc.m_day;
-			parts.hour = utc.m_hour;
-			parts.minute = utc.m_minute;
-			parts.second = utc.m_second + (utc.m_nano * 1000000000.0);
-
-			obs->timestamp = mrpt::system::buildTimestampFromParts(parts);
+			if (!m_batch)
+			{
+				m_batch = CObservationIMUBatch::Create();
+				m_batch->reserve(me->m_batchSize);
+				m_batch->sensorPose = me->m_sensorPose;
+				m_batch->sensorLabel = me->m_sensorLabel;
+			}
+			m_batch->addSample(t, vals, present);
+			if (m_batch->size() >= me->m_batchSize)
+			{
+				me->appendObservation(m_batch);
+				m_batch.reset();
+			}
 		}
-		else
-#endif
-		obs->timestamp = mrpt::system::now();
-
-		obs->sensorPose = me->m_sensorPose;
-		obs->sensorLabel = me->m_sensorLabel;
-
-		me->appendObservation(obs);
 
 		if (packet.containsLatitudeLongitude())
 		{
@@ -213,17 +238,15 @@ class MyXSensCallback : public XsCallback
 			else
 			{
 				rGPS.UTCTime.hour =
-					((obs->timestamp.time_since_epoch().count() /
+					((t.time_since_epoch().count() /
 					  (60 * 60 * ((uint64_t)1000000 / 100))) %
 					 24);
 				rGPS.UTCTime.minute =
-					((obs->timestamp.time_since_epoch().count() /
+					((t.time_since_epoch().count() /
 					  (60 * ((uint64_t)1000000 / 100))) %
 					 60);
 				rGPS.UTCTime.sec = fmod(
-					obs->timestamp.time_since_epoch().count() /
-						(1000000.0 / 100),
-					60);
+					t.time_since_epoch().count() / (1000000.0 / 100), 60);
 			}
 
 			if (packet.containsVelocity())
@@ -240,8 +263,8 @@ class MyXSensCallback : public XsCallback
 				rGPS.speed_knots = rGPS.direction_degrees = 0;
 
 			obsGPS->setMsg(rGPSs);
-			obsGPS->timestamp = obs->timestamp;
-			obsGPS->originalReceivedTimestamp = obs->timestamp;
+			obsGPS->timestamp = t;
+			obsGPS->originalReceivedTimestamp = now;
 			obsGPS->has_satellite_timestamp = false;
 			obsGPS->sensorPose = me->m_sensorPose;
 			obsGPS->sensorLabel = me->m_sensorLabel;
@@ -526,6 +549,9 @@ void CIMUXSens_MT4::loadConfig_sensorSpecific(
 	m_port_bauds = c.read_int(s, "baudRate", m_port_bauds, false);
 	m_deviceId = c.read_string(s, "deviceId", m_deviceId, false);
 	m_xsensLogFile = c.read_string(s, "logFile", m_xsensLogFile, false);
+	m_batchSize = c.read_uint64_t(s, "batchSize", m_batchSize, false);
+	m_useHardwareTimestamps = c.read_bool(
+		s, "useHardwareTimestamps", m_useHardwareTimestamps, false);
 
 #ifdef _WIN32
 	m_portname = c.read_string(s, "portname_WIN", m_portname, false);
@@ -716,15 +716,56 @@ bool CImageGrabber_FlyCapture2::getObservation(
 			pf == PIXEL_FORMAT_BGRU || pf == PIXEL_FORMAT_RGBU ||
 			pf == PIXEL_FORMAT_BGR16 || pf == PIXEL_FORMAT_BGRU16 ||
 			pf == PIXEL_FORMAT_422YUV8_JPEG;
-		// Decode image:
-		error = image.Convert(
-			is_color ? PIXEL_FORMAT_BGR : PIXEL_FORMAT_MONO8, FC2_BUF_IMG);
-		CHECK_FC2_ERROR(error)
-		// Convert PGR FlyCapture2 image ==> OpenCV format:
-		unsigned int img_rows, img_cols, img_stride;
-		FC2_BUF_IMG->GetDimensions(&img_rows, &img_cols, &img_stride);
-		out_observation.image.loadFromMemoryBuffer(
-			img_cols, img_rows, is_color, FC2_BUF_IMG->GetData());
+		// Bayer and YUV 4:2:2 formats are decoded directly into the output
+		// image:
+		mrpt::img::TBayerPattern bayer = mrpt::img::BAYER_RGGB;
+		bool is_bayer = false;
+		if (pf == PIXEL_FORMAT_RAW8)
+		{
+			is_bayer = true;
+			switch (image.GetBayerTileFormat())
+			{
+				case FlyCapture2::RGGB:
+					bayer = mrpt::img::BAYER_RGGB;
+					break;
+				case FlyCapture2::GRBG:
+					bayer = mrpt::img::BAYER_GRBG;
+					break;
+				case FlyCapture2::GBRG:
+					bayer = mrpt::img::BAYER_GBRG;
+					break;
+				case FlyCapture2::BGGR:
+					bayer = mrpt::img::BAYER_BGGR;
+					break;
+				default:
+					is_bayer = false;
+			};
+		}
+		if (is_bayer)
+		{
+			out_observation.image.loadFromBayer(
+				image.GetData(), image.GetCols(), image.GetRows(),
+				image.GetStride(), bayer, mrpt::img::DEMOSAIC_EDGE_AWARE);
+		}
+		else if (pf == PIXEL_FORMAT_422YUV8)
+		{
+			// Point Grey 4:2:2 byte order is UYVY:
+			out_observation.image.loadFromYUV422(
+				image.GetData(), image.GetCols(), image.GetRows(),
+				image.GetStride(), mrpt::img::YUV422_UYVY);
+		}
+		else
+		{
+			// Decode image:
+			error = image.Convert(
+				is_color ? PIXEL_FORMAT_BGR : PIXEL_FORMAT_MONO8, FC2_BUF_IMG);
+			CHECK_FC2_ERROR(error)
+			// Convert PGR FlyCapture2 image ==> OpenCV format:
+			unsigned int img_rows, img_cols, img_stride;
+			FC2_BUF_IMG->GetDimensions(&img_rows, &img_cols, &img_stride);
+			out_observation.image.loadFromMemoryBuffer(
+				img_cols, img_rows, is_color, FC2_BUF_IMG->GetData());
+		}
 		// It seems timestamp is not always correctly filled in the incoming
 		// imgs:
 		if (timestamp.seconds != 0)
@@ -11,6 +11,7 @@
 //
 #include <mrpt/3rdparty/do_opencv_includes.h>
 #include <mrpt/hwdrivers/CImageGrabber_OpenCV.h>
+#include <mrpt/img/CImageBufferPool.h>
 
 #include <thread>
 
@@ -209,7 +210,10 @@ bool CImageGrabber_OpenCV::getObservation(
 	//  there's no way:
 	for (int nTries = 0; nTries < 10; nTries++)
 	{
+		// Frames reuse the buffers of former (already destroyed) frames:
 		cv::Mat capImg;
+		capImg.allocator =
+			mrpt::img::CImageBufferPool::Instance().matAllocator();
 		if (m_capture->cap.retrieve(capImg))
 		{
 			// Fill the output class:
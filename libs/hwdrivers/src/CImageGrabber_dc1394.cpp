@@ -27,6 +27,64 @@ using namespace mrpt::hwdrivers;
 #define THE_CAMERA static_cast<dc1394camera_t*>(m_dc1394camera)
 #define THE_CONTEXT static_cast<dc1394_t*>(m_dc1394_lib_context)
 
+#if MRPT_HAS_LIBDC1394_2
+// Decodes the most common frame formats (8-bit mono, Bayer and YUV 4:2:2)
+// directly into the output image, without intermediary buffers.
+// Returns false for other formats.
+static bool decodeFrameIntoImage(
+	const dc1394video_frame_t* frame, mrpt::img::CImage& img)
+{
+	using namespace mrpt::img;
+
+	const unsigned int width = frame->size[0];
+	const unsigned int height = frame->size[1];
+
+	switch (frame->color_coding)
+	{
+		case DC1394_COLOR_CODING_MONO8:
+			if (frame->stride != width) return false;
+			img.loadFromMemoryBuffer(width, height, false, frame->image);
+			return true;
+
+		case DC1394_COLOR_CODING_RAW8:
+		{
+			TBayerPattern pattern;
+			switch (frame->color_filter)
+			{
+				case DC1394_COLOR_FILTER_RGGB:
+					pattern = BAYER_RGGB;
+					break;
+				case DC1394_COLOR_FILTER_GBRG:
+					pattern = BAYER_GBRG;
+					break;
+				case DC1394_COLOR_FILTER_GRBG:
+					pattern = BAYER_GRBG;
+					break;
+				case DC1394_COLOR_FILTER_BGGR:
+					pattern = BAYER_BGGR;
+					break;
+				default:
+					return false;
+			};
+			img.loadFromBayer(
+				frame->image, width, height, frame->stride, pattern,
+				DEMOSAIC_EDGE_AWARE);
+			return true;
+		}
+
+		case DC1394_COLOR_CODING_YUV422:
+			img.loadFromYUV422(
+				frame->image, width, height, frame->stride,
+				frame->yuv_byte_order == DC1394_BYTE_ORDER_YUYV ? YUV422_YUYV
+																: YUV422_UYVY);
+			return true;
+
+		default:
+			return false;
+	};
+}
+#endif
+
 /*-------------------------------------------------------------
 					Constructor
  -------------------------------------------------------------*/
@@ -472,33 +530,32 @@ bool CImageGrabber_dc1394::getObservation(
 
 	if (!m_options.deinterlace_stereo)
 	{
-		/*-----------------------------------------------------------------------
-		 *  convert the image from what ever format it is to its RGB8
-		 *-----------------------------------------------------------------------*/
-		// dc1394_get_image_size_from_video_mode(THE_CAMERA, m_desired_mode,
-		// &width, &height);
-
-		auto* new_frame = static_cast<dc1394video_frame_t*>(
-			calloc(1, sizeof(dc1394video_frame_t)));
-		new_frame->color_coding = DC1394_COLOR_CODING_RGB8;
-		dc1394_convert_frames(frame, new_frame);
-
-		// Fill the output class:
-		out_observation.image.loadFromMemoryBuffer(
-			width, height, true, new_frame->image, true /* BGR -> RGB */);
-
-		// Free temporary frame:
-		free(new_frame->image);
-		free(new_frame);
+		// Mono, Bayer and YUV422 frames are decoded directly into the
+		// output image. Otherwise, use libdc1394 to convert to RGB8:
+		if (!decodeFrameIntoImage(frame, out_observation.image))
+		{
+			auto* new_frame = static_cast<dc1394video_frame_t*>(
+				calloc(1, sizeof(dc1394video_frame_t)));
+			new_frame->color_coding = DC1394_COLOR_CODING_RGB8;
+			dc1394_convert_frames(frame, new_frame);
+
+			// Fill the output class:
+			out_observation.image.loadFromMemoryBuffer(
+				width, height, true, new_frame->image, true /* BGR -> RGB */);
+
+			// Free temporary frame:
+			free(new_frame->image);
+			free(new_frame);
+		}
 	}
 	else
 	{
 		// Stereo images:
-		auto* imageBuf = new uint8_t[width * height * 2];
-		auto* imageBufRGB = new uint8_t[width * height * 2 * 3];
+		std::vector<uint8_t> imageBuf(width * height * 2);
 
 		if ((err = dc1394_deinterlace_stereo(
-				 frame->image, imageBuf, width, 2 * height)) != DC1394_SUCCESS)
+				 frame->image, imageBuf.data(), width, 2 * height)) !=
+			DC1394_SUCCESS)
 		{
 			cerr << "[CImageGrabber_dc1394] ERROR: Could not deinterlace "
 					"stereo images: "
@@ -506,25 +563,11 @@ bool CImageGrabber_dc1394::getObservation(
 			return false;
 		}
 
-		if ((err = dc1394_bayer_decoding_8bit(
-				 imageBuf, imageBufRGB, width, 2 * height,
-				 DC1394_COLOR_FILTER_GBRG,	// Has to be this value for
-				 // Bumblebee!
-				 DC1394_BAYER_METHOD_HQLINEAR)) != DC1394_SUCCESS)
-		{
-			cerr << "[CImageGrabber_dc1394] ERROR: Could not apply Bayer "
-					"conversion: "
-				 << err << endl;
-			return false;
-		}
-
-		out_observation.image.loadFromMemoryBuffer(
-			width, height, true, imageBufRGB);	// Left cam.
-		// out_observation.image.loadFromMemoryBuffer(width,height,true,
-		// imageBufRGB+ width*height*3 ); // Right cam.
-
-		delete[] imageBuf;
-		delete[] imageBufRGB;
+		// Demosaic the left camera only, straight into the output image.
+		// GBRG: Has to be this value for Bumblebee!
+		out_observation.image.loadFromBayer(
+			imageBuf.data(), width, height, width, mrpt::img::BAYER_GBRG,
+			mrpt::img::DEMOSAIC_EDGE_AWARE);
 	}
 
 	// Now we can return the frame to the ring buffer:
@@ -581,11 +624,11 @@ bool CImageGrabber_dc1394::getObservation(
 	else
 	{
 		// Stereo images:
-		auto* imageBuf = new uint8_t[width * height * 2];
-		auto* imageBufRGB = new uint8_t[width * height * 2 * 3];
+		std::vector<uint8_t> imageBuf(width * height * 2);
 
 		if ((err = dc1394_deinterlace_stereo(
-				 frame->image, imageBuf, width, 2 * height)) != DC1394_SUCCESS)
+				 frame->image, imageBuf.data(), width, 2 * height)) !=
+			DC1394_SUCCESS)
 		{
 			cerr << "[CImageGrabber_dc1394] ERROR: Could not deinterlace "
 					"stereo images: "
@@ -593,26 +636,14 @@ bool CImageGrabber_dc1394::getObservation(
 			return false;
 		}
 
-		if ((err = dc1394_bayer_decoding_8bit(
-				 imageBuf, imageBufRGB, width, 2 * height,
-				 DC1394_COLOR_FILTER_GBRG,	// Has to be this value for
-				 // Bumblebee!
-				 DC1394_BAYER_METHOD_HQLINEAR)) != DC1394_SUCCESS)
-		{
-			cerr << "[CImageGrabber_dc1394] ERROR: Could not apply Bayer "
-					"conversion: "
-				 << err << endl;
-			return false;
-		}
-
-		out_observation.imageLeft.loadFromMemoryBuffer(
-			width, height, true, imageBufRGB);	// Left cam.
-		out_observation.imageRight.loadFromMemoryBuffer(
-			width, height, true,
-			imageBufRGB + width * height * 3);	// Right cam.
-
-		delete[] imageBuf;
-		delete[] imageBufRGB;
+		// Demosaic each camera straight into the output images.
+		// GBRG: Has to be this value for Bumblebee!
+		out_observation.imageLeft.loadFromBayer(
+			imageBuf.data(), width, height, width, mrpt::img::BAYER_GBRG,
+			mrpt::img::DEMOSAIC_EDGE_AWARE);
+		out_observation.imageRight.loadFromBayer(
+			imageBuf.data() + width * height, width, height, width,
+			mrpt::img::BAYER_GBRG, mrpt::img::DEMOSAIC_EDGE_AWARE);
 	}
 
 	// Now we can return the frame to the ring buffer:
@@ -16,7 +16,9 @@
 // Universal include for all versions of OpenCV
 #include <mrpt/3rdparty/do_opencv_includes.h>
 
+#include <algorithm>
 #include <atomic>
+#include <cstring>
 #include <mutex>
 #include <thread>
 
@@ -829,17 +831,15 @@ bool COpenNI2Generic::CDevice::getNextFrameRGBD(
 		frame[COLOR_STREAM].getStrideInBytes(),
 		frame[DEPTH_STREAM].getStrideInBytes()};
 
-	for (int yc = 0; yc < height; ++yc)
+	// Row by row, straight into the (pooled) buffers of the observation:
+	for (int y = 0; y < height; ++y)
 	{
-		const auto* pRgb = (const openni::RGB888Pixel*)data[COLOR_STREAM];
-		const auto* pDepth = (const openni::DepthPixel*)data[DEPTH_STREAM];
-		for (int xc = 0; xc < width; ++xc, ++pDepth, ++pRgb)
-		{
-			int x = xc;
-			if (isMirrorMode()) { x = width - x - 1; }
-			setPixel(*pRgb, obs.intensityImage, x, yc);
-			setPixel(*pDepth, obs.rangeImage, x, yc);
-		}
+		copyRow(
+			reinterpret_cast<const openni::RGB888Pixel*>(data[COLOR_STREAM]),
+			obs.intensityImage, width, y);
+		copyRow(
+			reinterpret_cast<const openni::DepthPixel*>(data[DEPTH_STREAM]),
+			obs.rangeImage, width, y);
 		data[COLOR_STREAM] += step[COLOR_STREAM];
 		data[DEPTH_STREAM] += step[DEPTH_STREAM];
 	}
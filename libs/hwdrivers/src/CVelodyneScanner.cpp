@@ -10,14 +10,22 @@
 #include "hwdrivers-precomp.h"	// Precompiled headers
 //
 #include <mrpt/comms/net_utils.h>
+#include <mrpt/core/WorkerThreadsPool.h>
 #include <mrpt/core/reverse_bytes.h>
 #include <mrpt/hwdrivers/CGPSInterface.h>
 #include <mrpt/hwdrivers/CVelodyneScanner.h>
+#include <mrpt/io/CFileInputStream.h>
 #include <mrpt/serialization/CArchive.h>
 #include <mrpt/system/datetime.h>  // timeDifference
 #include <mrpt/system/filesystem.h>
+#include <mrpt/system/thread_name.h>
 
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <future>
 #include <iostream>
+#include <limits>
 #include <thread>
 
 // socket's hdrs:
@@ -44,12 +52,20 @@ using socklen_t = int;
 #include <netinet/tcp.h>
 #include <poll.h>
 #include <sys/ioctl.h>
+#include <sys/mman.h>
 #include <sys/socket.h>
+#include <sys/stat.h>
 #include <sys/time.h>  // gettimeofday()
 #include <sys/types.h>
 #include <unistd.h>
 
 #include <cerrno>
+#include <ctime>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
 #endif
 
 #if MRPT_HAS_LIBPCAP
@@ -166,6 +182,12 @@ void CVelodyneScanner::loadConfig_sensorSpecific(
 	MRPT_LOAD_HERE_CONFIG_VAR(
 		pos_packets_min_period, double, m_pos_packets_min_period, cfg, sect);
 
+	MRPT_LOAD_HERE_CONFIG_VAR(rx_thread, bool, m_rx_thread, cfg, sect);
+	MRPT_LOAD_HERE_CONFIG_VAR(rx_thread_cpu, int, m_rx_thread_cpu, cfg, sect);
+	MRPT_LOAD_HERE_CONFIG_VAR(rx_batch_size, int, m_rx_batch_size, cfg, sect);
+	MRPT_LOAD_HERE_CONFIG_VAR(
+		rx_queue_length, int, m_rx_queue_length, cfg, sect);
+
 	using mrpt::DEG2RAD;
 	m_sensorPose = mrpt::poses::CPose3D(
 		cfg.read_float(sect, "pose_x", 0), cfg.read_float(sect, "pose_y", 0),
@@ -222,31 +244,7 @@ bool CVelodyneScanner::getNextObservation(
 		}
 
 		if (pos_pkt_timestamp != INVALID_TIMESTAMP)
-		{
-			mrpt::obs::CObservationGPS::Ptr gps_obs =
-				mrpt::obs::CObservationGPS::Create();
-			gps_obs->sensorLabel = this->m_sensorLabel + std::string("_GPS");
-			gps_obs->sensorPose = m_sensorPose;
-
-			gps_obs->originalReceivedTimestamp = pos_pkt_timestamp;
-
-			bool parsed_ok = CGPSInterface::parse_NMEA(
-				std::string(rx_pos_pkt.NMEA_GPRMC), *gps_obs);
-			const mrpt::obs::gnss::Message_NMEA_RMC* msg_rmc =
-				gps_obs->getMsgByClassPtr<mrpt::obs::gnss::Message_NMEA_RMC>();
-			if (!parsed_ok || !msg_rmc || msg_rmc->fields.validity_char != 'A')
-			{
-				gps_obs->has_satellite_timestamp = false;
-				gps_obs->timestamp = pos_pkt_timestamp;
-			}
-			else
-			{
-				// We have live GPS signal and a recent RMC frame:
-				m_last_gps_rmc_age = pos_pkt_timestamp;
-				m_last_gps_rmc = *msg_rmc;
-			}
-			outGPS = gps_obs;  // save in output object
-		}
+			outGPS = internal_process_pos_packet(rx_pos_pkt, pos_pkt_timestamp);
 
 		if (data_pkt_timestamp != INVALID_TIMESTAMP)
 		{
@@ -268,6 +266,8 @@ bool CVelodyneScanner::getNextObservation(
 				{
 					outScan = m_rx_scan;
 					m_rx_scan.reset();
+					m_rx_scan_capacity = std::max(
+						m_rx_scan_capacity, outScan->scan_packets.size());
 
 					if (m_pcap)
 					{
@@ -283,68 +283,14 @@ bool CVelodyneScanner::getNextObservation(
 			// Create smart ptr to new in-progress observation:
 			if (!m_rx_scan)
 			{
-				m_rx_scan = mrpt::obs::CObservationVelodyneScan::Create();
-				m_rx_scan->sensorLabel =
-					this->m_sensorLabel + std::string("_SCAN");
-				m_rx_scan->sensorPose = m_sensorPose;
-				m_rx_scan->calibration =
-					m_velodyne_calib;  // Embed a copy of the calibration info
-
-				{
-					const model_properties_list_t& lstModels =
-						TModelPropertiesFactory::get();
-					auto it = lstModels.find(this->m_model);
-					if (it != lstModels.end())
-					{  // Model params:
-						m_rx_scan->maxRange = it->second.maxRange;
-					}
-					else  // default params:
-					{
-						m_rx_scan->maxRange = 120.0;
-					}
-				}
+				m_rx_scan = internal_new_scan();
+				// Avoid reallocations while accumulating packets:
+				m_rx_scan->scan_packets.reserve(m_rx_scan_capacity);
 			}
 
 			// For the first packet, set timestamp:
 			if (m_rx_scan->scan_packets.empty())
-			{
-				m_rx_scan->originalReceivedTimestamp = data_pkt_timestamp;
-				// Using GPS, if available:
-				if (m_last_gps_rmc.fields.validity_char == 'A' &&
-					mrpt::system::timeDifference(
-						m_last_gps_rmc_age, data_pkt_timestamp) <
-						m_pos_packets_timing_timeout)
-				{
-					// Each Velodyne data packet has a timestamp field,
-					// with the number of us since the top of the current HOUR:
-					// take the date and time from the GPS, then modify minutes
-					// and seconds from data pkt:
-					const mrpt::system::TTimeStamp gps_tim =
-						m_last_gps_rmc.fields.UTCTime.getAsTimestamp(
-							m_last_gps_rmc.getDateAsTimestamp());
-
-					mrpt::system::TTimeParts tim_parts;
-					mrpt::system::timestampToParts(gps_tim, tim_parts);
-					tim_parts.minute =
-						rx_pkt.gps_timestamp() /*us from top of hour*/ /
-						60000000ul;
-					tim_parts.second =
-						(rx_pkt.gps_timestamp() /*us from top of hour*/ %
-						 60000000ul) *
-						1e-6;
-
-					const mrpt::system::TTimeStamp data_pkt_tim =
-						mrpt::system::buildTimestampFromParts(tim_parts);
-
-					m_rx_scan->timestamp = data_pkt_tim;
-					m_rx_scan->has_satellite_timestamp = true;
-				}
-				else
-				{
-					m_rx_scan->has_satellite_timestamp = false;
-					m_rx_scan->timestamp = data_pkt_timestamp;
-				}
-			}
+				internal_stamp_scan(*m_rx_scan, rx_pkt, data_pkt_timestamp);
 
 			// Accumulate pkts in the observation object:
 			m_rx_scan->scan_packets.push_back(rx_pkt);
@@ -362,6 +308,108 @@ bool CVelodyneScanner::getNextObservation(
 	}
 }
 
+mrpt::obs::CObservationGPS::Ptr CVelodyneScanner::internal_process_pos_packet(
+	const mrpt::obs::CObservationVelodyneScan::TVelodynePositionPacket& pkt,
+	const mrpt::system::TTimeStamp& pkt_timestamp)
+{
+	mrpt::obs::CObservationGPS::Ptr gps_obs =
+		mrpt::obs::CObservationGPS::Create();
+	gps_obs->sensorLabel = this->m_sensorLabel + std::string("_GPS");
+	gps_obs->sensorPose = m_sensorPose;
+
+	gps_obs->originalReceivedTimestamp = pkt_timestamp;
+
+	bool parsed_ok =
+		CGPSInterface::parse_NMEA(std::string(pkt.NMEA_GPRMC), *gps_obs);
+	const mrpt::obs::gnss::Message_NMEA_RMC* msg_rmc =
+		gps_obs->getMsgByClassPtr<mrpt::obs::gnss::Message_NMEA_RMC>();
+	if (!parsed_ok || !msg_rmc || msg_rmc->fields.validity_char != 'A')
+	{
+		gps_obs->has_satellite_timestamp = false;
+		gps_obs->timestamp = pkt_timestamp;
+	}
+	else
+	{
+		// We have live GPS signal and a recent RMC frame:
+		m_last_gps_rmc_age = pkt_timestamp;
+		m_last_gps_rmc = *msg_rmc;
+	}
+	return gps_obs;
+}
+
+mrpt::obs::CObservationVelodyneScan::Ptr CVelodyneScanner::internal_new_scan()
+	const
+{
+	auto scan = mrpt::obs::CObservationVelodyneScan::Create();
+	scan->sensorLabel = this->m_sensorLabel + std::string("_SCAN");
+	scan->sensorPose = m_sensorPose;
+	// Embed a copy of the calibration info:
+	scan->calibration = m_velodyne_calib;
+
+	const model_properties_list_t& lstModels = TModelPropertiesFactory::get();
+	auto it = lstModels.find(this->m_model);
+	if (it != lstModels.end())
+	{  // Model params:
+		scan->maxRange = it->second.maxRange;
+	}
+	else  // default params:
+	{
+		scan->maxRange = 120.0;
+	}
+	return scan;
+}
+
+void CVelodyneScanner::internal_stamp_scan(
+	mrpt::obs::CObservationVelodyneScan& scan,
+	const mrpt::obs::CObservationVelodyneScan::TVelodyneRawPacket& first_pkt,
+	const mrpt::system::TTimeStamp& pkt_timestamp) const
+{
+	scan.originalReceivedTimestamp = pkt_timestamp;
+	// Using GPS, if available:
+	if (m_last_gps_rmc.fields.validity_char == 'A' &&
+		mrpt::system::timeDifference(m_last_gps_rmc_age, pkt_timestamp) <
+			m_pos_packets_timing_timeout)
+	{
+		// Each Velodyne data packet has a timestamp field,
+		// with the number of us since the top of the current HOUR:
+		// take the date and time from the GPS, then modify minutes
+		// and seconds from data pkt:
+		const mrpt::system::TTimeStamp gps_tim =
+			m_last_gps_rmc.fields.UTCTime.getAsTimestamp(
+				m_last_gps_rmc.getDateAsTimestamp());
+
+		mrpt::system::TTimeParts tim_parts;
+		mrpt::system::timestampToParts(gps_tim, tim_parts);
+		tim_parts.minute =
+			first_pkt.gps_timestamp() /*us from top of hour*/ / 60000000ul;
+		tim_parts.second =
+			(first_pkt.gps_timestamp() /*us from top of hour*/ % 60000000ul) *
+			1e-6;
+
+		scan.timestamp = mrpt::system::buildTimestampFromParts(tim_parts);
+		scan.has_satellite_timestamp = true;
+	}
+	else
+	{
+		scan.has_satellite_timestamp = false;
+		scan.timestamp = pkt_timestamp;
+	}
+}
+
+bool CVelodyneScanner::internal_accept_pos_packet(
+	const mrpt::system::TTimeStamp& pkt_timestamp)
+{
+	if ((m_last_pos_packet_timestamp != INVALID_TIMESTAMP) &&
+		mrpt::system::timeDifference(
+			m_last_pos_packet_timestamp, pkt_timestamp) <
+			m_pos_packets_min_period)
+		return false;
+
+	// Reset time watch:
+	m_last_pos_packet_timestamp = pkt_timestamp;
+	return true;
+}
+
 void CVelodyneScanner::doProcess()
 {
 	CObservationVelodyneScan::Ptr obs;
@@ -380,16 +428,8 @@ void CVelodyneScanner::doProcess()
 	}
 }
 
-/** Tries to initialize the sensor, after setting all the parameters with a call
- * to loadConfig.
- *  \exception This method must throw an exception with a descriptive message if
- * some critical error is found. */
-void CVelodyneScanner::initialize()
+void CVelodyneScanner::internal_assure_calibration()
 {
-	this->close();
-
-	// (0) Preparation:
-	// --------------------------------
 	// Make sure we have calibration data:
 	if (m_velodyne_calib.empty())
 	{
@@ -403,6 +443,26 @@ void CVelodyneScanner::initialize()
 				"`model` name. Please, specify a valid `model` or load a valid "
 				"XML configuration file first.");
 	}
+}
+
+/** Tries to initialize the sensor, after setting all the parameters with a call
+ * to loadConfig.
+ *  \exception This method must throw an exception with a descriptive message if
+ * some critical error is found. */
+void CVelodyneScanner::initialize()
+{
+	this->close();
+
+	{
+		std::lock_guard<std::mutex> lck(m_rx_stats_mtx);
+		m_rx_stats = TReceptionStats();
+		m_rx_latency_sum = 0;
+		m_rx_os_dropped[0] = m_rx_os_dropped[1] = 0;
+	}
+
+	// (0) Preparation:
+	// --------------------------------
+	internal_assure_calibration();
 
 	// online vs off line operation??
 	// -------------------------------
@@ -480,6 +540,10 @@ void CVelodyneScanner::initialize()
 		if (-1 == fcntl(m_hPositionSock, F_SETFL, oldflags))
 			THROW_EXCEPTION("Error entering non-blocking mode with fcntl();");
 #endif
+
+		// (3) Optional receiver thread
+		// --------------------------------
+		if (m_rx_thread) internal_start_rx_thread();
 	}
 	else
 	{  // Offline:
@@ -543,6 +607,8 @@ void CVelodyneScanner::initialize()
 
 void CVelodyneScanner::close()
 {
+	internal_stop_rx_thread();
+
 	if (m_hDataSock != INVALID_SOCKET)
 	{
 		shutdown(m_hDataSock, 2);  // SD_BOTH  );
@@ -639,6 +705,38 @@ bool CVelodyneScanner::receivePackets(
 			data_pkt_timestamp, (uint8_t*)&out_data_pkt, pos_pkt_timestamp,
 			(uint8_t*)&out_pos_pkt);
 	}
+	else if (m_rx_data_queue)
+	{
+		// Packets from the receiver thread:
+		if (!m_rx_thread_running)
+			THROW_EXCEPTION("The UDP receiver thread stopped due to an error");
+
+		data_pkt_timestamp = INVALID_TIMESTAMP;
+		pos_pkt_timestamp = INVALID_TIMESTAMP;
+
+		// Wait up to ~1 ms, like the poll() timeout without the thread:
+		for (int i = 0; i < 2; i++)
+		{
+			if (i > 0)
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+			data_queue_t::value_type d;
+			if (m_rx_data_queue->try_pop(d))
+			{
+				data_pkt_timestamp = d.timestamp;
+				out_data_pkt = d.pkt;
+			}
+			pos_queue_t::value_type p;
+			if (m_rx_pos_queue->try_pop(p))
+			{
+				pos_pkt_timestamp = p.timestamp;
+				out_pos_pkt = p.pkt;
+			}
+			if (data_pkt_timestamp != INVALID_TIMESTAMP ||
+				pos_pkt_timestamp != INVALID_TIMESTAMP)
+				break;
+		}
+	}
 	else
 	{
 		data_pkt_timestamp = internal_receive_UDP_packet(
@@ -649,6 +747,14 @@ bool CVelodyneScanner::receivePackets(
 			CObservationVelodyneScan::POS_PACKET_SIZE, m_device_ip);
 	}
 
+	if (!m_pcap)
+	{
+		if (data_pkt_timestamp != INVALID_TIMESTAMP)
+			internal_update_rx_stats(data_pkt_timestamp);
+		if (pos_pkt_timestamp != INVALID_TIMESTAMP)
+			internal_update_rx_stats(pos_pkt_timestamp);
+	}
+
 // Optional PCAP dump:
 #if MRPT_HAS_LIBPCAP
 	// Save to PCAP file?
@@ -739,21 +845,11 @@ bool CVelodyneScanner::receivePackets(
 	// "remember" whether internal data is already in big or little endian.
 
 	// Position packet decimation:
-	if (pos_pkt_timestamp != INVALID_TIMESTAMP)
+	if (pos_pkt_timestamp != INVALID_TIMESTAMP &&
+		!internal_accept_pos_packet(pos_pkt_timestamp))
 	{
-		if ((m_last_pos_packet_timestamp != INVALID_TIMESTAMP) &&
-			mrpt::system::timeDifference(
-				m_last_pos_packet_timestamp, pos_pkt_timestamp) <
-				m_pos_packets_min_period)
-		{
-			// Ignore this packet
-			pos_pkt_timestamp = INVALID_TIMESTAMP;
-		}
-		else
-		{
-			// Reset time watch:
-			m_last_pos_packet_timestamp = pos_pkt_timestamp;
-		}
+		// Ignore this packet
+		pos_pkt_timestamp = INVALID_TIMESTAMP;
 	}
 
 	return ret;
@@ -866,6 +962,241 @@ mrpt::system::TTimeStamp CVelodyneScanner::internal_receive_UDP_packet(
 		time2.time_since_epoch().count() / 2));
 }
 
+void CVelodyneScanner::internal_update_rx_stats(
+	const mrpt::system::TTimeStamp& pktTime)
+{
+	const double latency =
+		mrpt::system::timeDifference(pktTime, mrpt::Clock::now());
+
+	std::lock_guard<std::mutex> lck(m_rx_stats_mtx);
+	m_rx_stats.received++;
+	m_rx_latency_sum += latency;
+	m_rx_stats.latencyMean = m_rx_latency_sum / m_rx_stats.received;
+	m_rx_stats.latencyMax = std::max(m_rx_stats.latencyMax, latency);
+}
+
+CGenericSensor::TReceptionStats CVelodyneScanner::getReceptionStats() const
+{
+	std::lock_guard<std::mutex> lck(m_rx_stats_mtx);
+	TReceptionStats s = m_rx_stats;
+	s.dropped += m_rx_os_dropped[0] + m_rx_os_dropped[1];
+	if (m_rx_data_queue)
+		s.dropped += m_rx_data_queue->dropped() + m_rx_pos_queue->dropped();
+	return s;
+}
+
+void CVelodyneScanner::internal_start_rx_thread()
+{
+#if defined(__linux__)
+	// Kernel arrival timestamps, and counters of packets dropped by the
+	// kernel, for each packet:
+	for (const auto sock : {m_hDataSock, m_hPositionSock})
+	{
+		const int on = 1;
+		if (setsockopt(sock, SOL_SOCKET, SO_TIMESTAMPNS, &on, sizeof(on)) ||
+			setsockopt(sock, SOL_SOCKET, SO_RXQ_OVFL, &on, sizeof(on)))
+			THROW_EXCEPTION_FMT(
+				"Error in setsockopt():\n%s",
+				mrpt::comms::net::getLastSocketErrorStr().c_str());
+	}
+	// Room for bursts of data packets (the kernel limits it to the
+	// net.core.rmem_max setting):
+	const int rcvBufSize = 8 * 1024 * 1024;
+	setsockopt(
+		m_hDataSock, SOL_SOCKET, SO_RCVBUF, &rcvBufSize, sizeof(rcvBufSize));
+
+	// Position packets are much less frequent than data packets:
+	m_rx_data_queue =
+		std::make_unique<data_queue_t>(std::max(2u, m_rx_queue_length));
+	m_rx_pos_queue =
+		std::make_unique<pos_queue_t>(std::max(2u, m_rx_queue_length / 16));
+
+	m_rx_thread_running = true;
+	m_rx_thread_handle =
+		std::thread(&CVelodyneScanner::internal_rx_thread, this);
+	mrpt::system::thread_name("velodyneRx", m_rx_thread_handle);
+#else
+	std::cerr << "[CVelodyneScanner] Warning: `rx_thread` is only available "
+				 "in Linux. Ignoring it.\n";
+#endif
+}
+
+void CVelodyneScanner::internal_stop_rx_thread()
+{
+	m_rx_thread_running = false;
+	if (m_rx_thread_handle.joinable()) m_rx_thread_handle.join();
+
+	std::lock_guard<std::mutex> lck(m_rx_stats_mtx);
+	if (m_rx_data_queue)
+		m_rx_stats.dropped +=
+			m_rx_data_queue->dropped() + m_rx_pos_queue->dropped();
+	m_rx_data_queue.reset();
+	m_rx_pos_queue.reset();
+}
+
+void CVelodyneScanner::internal_rx_thread()
+{
+#if defined(__linux__)
+	try
+	{
+		if (m_rx_thread_cpu >= 0)
+		{
+			cpu_set_t cpus;
+			CPU_ZERO(&cpus);
+			CPU_SET(m_rx_thread_cpu, &cpus);
+			if (pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus))
+				std::cerr << "[CVelodyneScanner] Warning: could not pin the "
+							 "receiver thread to CPU #"
+						  << m_rx_thread_cpu << "\n";
+		}
+
+		const in_addr_t devip =
+			m_device_ip.empty() ? 0 : inet_addr(m_device_ip.c_str());
+		const unsigned int nBatch = std::max(1u, m_rx_batch_size);
+		const size_t ctrlSize =
+			CMSG_SPACE(sizeof(timespec)) + CMSG_SPACE(sizeof(uint32_t));
+
+		// Buffers to receive a batch of packets from one socket, allocated
+		// only once:
+		struct Slab
+		{
+			std::vector<mmsghdr> msgs;
+			std::vector<iovec> iovs;
+			std::vector<sockaddr_in> addrs;
+			std::vector<uint8_t> data, ctrl;
+		};
+		auto initSlab = [&](Slab& slab, size_t pktSize) {
+			slab.msgs.assign(nBatch, mmsghdr());
+			slab.iovs.resize(nBatch);
+			slab.addrs.resize(nBatch);
+			slab.data.resize(nBatch * pktSize);
+			slab.ctrl.resize(nBatch * ctrlSize);
+			for (size_t i = 0; i < nBatch; i++)
+			{
+				slab.iovs[i].iov_base = &slab.data[i * pktSize];
+				slab.iovs[i].iov_len = pktSize;
+				auto& h = slab.msgs[i].msg_hdr;
+				h.msg_name = &slab.addrs[i];
+				h.msg_iov = &slab.iovs[i];
+				h.msg_iovlen = 1;
+				h.msg_control = &slab.ctrl[i * ctrlSize];
+			}
+		};
+
+		auto receiveBatch = [&](platform_socket_t sock, Slab& slab,
+								auto& queue, std::atomic<uint64_t>& osDropped) {
+			using rx_packet_t =
+				typename std::remove_reference_t<decltype(queue)>::value_type;
+			constexpr size_t pktSize = sizeof(rx_packet_t::pkt);
+
+			for (auto& m : slab.msgs)
+			{
+				m.msg_hdr.msg_namelen = sizeof(sockaddr_in);
+				m.msg_hdr.msg_controllen = ctrlSize;
+				m.msg_hdr.msg_flags = 0;
+			}
+			const int n =
+				recvmmsg(sock, slab.msgs.data(), nBatch, MSG_DONTWAIT, nullptr);
+			if (n < 0)
+			{
+				if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+					THROW_EXCEPTION_FMT(
+						"Error in recvmmsg():\n%s",
+						mrpt::comms::net::getLastSocketErrorStr().c_str());
+				return;
+			}
+
+			// Kernel timestamps are in CLOCK_REALTIME: convert them to the
+			// mrpt::Clock source from their age.
+			timespec nowRT;
+			clock_gettime(CLOCK_REALTIME, &nowRT);
+			const auto now = mrpt::Clock::now();
+
+			for (int i = 0; i < n; i++)
+			{
+				auto& h = slab.msgs[i].msg_hdr;
+
+				rx_packet_t p;
+				p.timestamp = now;
+				for (cmsghdr* c = CMSG_FIRSTHDR(&h); c; c = CMSG_NXTHDR(&h, c))
+				{
+					if (c->cmsg_level != SOL_SOCKET) continue;
+					if (c->cmsg_type == SCM_TIMESTAMPNS)
+					{
+						timespec ts;
+						std::memcpy(&ts, CMSG_DATA(c), sizeof(ts));
+						const double age = (nowRT.tv_sec - ts.tv_sec) +
+							1e-9 * (nowRT.tv_nsec - ts.tv_nsec);
+						p.timestamp = now -
+							std::chrono::duration_cast<mrpt::Clock::duration>(
+								std::chrono::duration<double>(age));
+					}
+					else if (c->cmsg_type == SO_RXQ_OVFL)
+					{
+						// Total dropped by the kernel for this socket:
+						uint32_t dropped;
+						std::memcpy(&dropped, CMSG_DATA(c), sizeof(dropped));
+						osDropped = dropped;
+					}
+				}
+
+				if (slab.msgs[i].msg_len != pktSize ||
+					(h.msg_flags & MSG_TRUNC))
+				{
+					std::cerr << "[CVelodyneScanner] Warning: incomplete "
+								 "Velodyne packet read: "
+							  << slab.msgs[i].msg_len << " bytes\n";
+					continue;
+				}
+				if (devip && slab.addrs[i].sin_addr.s_addr != devip) continue;
+
+				std::memcpy(
+					static_cast<void*>(&p.pkt), &slab.data[i * pktSize],
+					pktSize);
+				queue.push_or_drop(std::move(p));
+			}
+		};
+
+		Slab slabs[2];
+		initSlab(slabs[0], CObservationVelodyneScan::PACKET_SIZE);
+		initSlab(slabs[1], CObservationVelodyneScan::POS_PACKET_SIZE);
+
+		struct pollfd fds[2];
+		fds[0].fd = m_hDataSock;
+		fds[1].fd = m_hPositionSock;
+		fds[0].events = fds[1].events = POLLIN;
+
+		while (m_rx_thread_running)
+		{
+			// Short timeout, to check for stop requests:
+			const int ret = poll(fds, 2, 100 /*ms*/);
+			if (ret < 0)
+			{
+				if (errno == EINTR) continue;
+				THROW_EXCEPTION_FMT(
+					"Error in UDP poll():\n%s",
+					mrpt::comms::net::getLastSocketErrorStr().c_str());
+			}
+			if (fds[0].revents & POLLIN)
+				receiveBatch(
+					m_hDataSock, slabs[0], *m_rx_data_queue,
+					m_rx_os_dropped[0]);
+			if (fds[1].revents & POLLIN)
+				receiveBatch(
+					m_hPositionSock, slabs[1], *m_rx_pos_queue,
+					m_rx_os_dropped[1]);
+		}
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << "[CVelodyneScanner] UDP receiver thread stopped due to "
+					 "an error:\n"
+				  << e.what() << "\n";
+		m_rx_thread_running = false;
+	}
+#endif
+}
+
 bool CVelodyneScanner::internal_read_PCAP_packet(
 	mrpt::system::TTimeStamp& data_pkt_time, uint8_t* out_data_buffer,
 	mrpt::system::TTimeStamp& pos_pkt_time, uint8_t* out_pos_buffer)
@@ -988,6 +1319,279 @@ bool CVelodyneScanner::internal_read_PCAP_packet(
 #endif
 }
 
+namespace
+{
+/** Read-only view of a whole file, memory-mapped if possible */
+struct MappedFile
+{
+	const uint8_t* data = nullptr;
+	uint64_t size = 0;
+#if defined(_WIN32)
+	HANDLE hFile = INVALID_HANDLE_VALUE, hMap = nullptr;
+#else
+	int fd = -1;
+	bool mapped = false;
+#endif
+	// Fallback if memory mapping is not available:
+	std::vector<uint8_t> buf;
+
+	explicit MappedFile(const std::string& fileName)
+	{
+		if (!mrpt::system::fileExists(fileName))
+			THROW_EXCEPTION_FMT(
+				"PCAP file does not exist: '%s'", fileName.c_str());
+		size = mrpt::system::getFileSize(fileName);
+		if (size == 0 || size > std::numeric_limits<size_t>::max()) return;
+
+#if defined(_WIN32)
+		hFile = CreateFileA(
+			fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+			OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (hFile != INVALID_HANDLE_VALUE)
+		{
+			hMap =
+				CreateFileMappingA(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (hMap)
+				data = static_cast<const uint8_t*>(
+					MapViewOfFile(hMap, FILE_MAP_READ, 0, 0, 0));
+		}
+#else
+		fd = ::open(fileName.c_str(), O_RDONLY);
+		if (fd >= 0)
+		{
+			void* p = ::mmap(
+				nullptr, static_cast<size_t>(size), PROT_READ, MAP_PRIVATE, fd,
+				0);
+			if (p != MAP_FAILED)
+			{
+				data = static_cast<const uint8_t*>(p);
+				mapped = true;
+				// Read once, front to back:
+				::madvise(p, static_cast<size_t>(size), MADV_SEQUENTIAL);
+			}
+		}
+#endif
+		if (data) return;
+
+		mrpt::io::CFileInputStream f;
+		if (!f.open(fileName))
+			THROW_EXCEPTION_FMT(
+				"Error opening PCAP file: '%s'", fileName.c_str());
+		buf.resize(static_cast<size_t>(size));
+		if (f.Read(buf.data(), buf.size()) != buf.size())
+			THROW_EXCEPTION_FMT(
+				"Error reading PCAP file: '%s'", fileName.c_str());
+		data = buf.data();
+	}
+	~MappedFile()
+	{
+#if defined(_WIN32)
+		if (data && buf.empty()) UnmapViewOfFile(data);
+		if (hMap) CloseHandle(hMap);
+		if (hFile != INVALID_HANDLE_VALUE) CloseHandle(hFile);
+#else
+		if (mapped)
+			::munmap(const_cast<uint8_t*>(data), static_cast<size_t>(size));
+		if (fd >= 0) ::close(fd);
+#endif
+	}
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+};
+
+template <typename T>
+T readPCAPField(const uint8_t* p, bool swapped)
+{
+	T v;
+	std::memcpy(&v, p, sizeof(T));
+	if (swapped) mrpt::reverseBytesInPlace(v);
+	return v;
+}
+}  // namespace
+
+size_t CVelodyneScanner::processPCAPFile(
+	const std::function<void(const mrpt::obs::CObservation::Ptr&)>& callback,
+	unsigned int numThreads, bool generatePointClouds,
+	const CObservationVelodyneScan::TGeneratePointCloudParameters& pcParams)
+{
+	MRPT_START
+
+	ASSERTMSG_(
+		!m_pcap_input_file.empty(),
+		"No PCAP file was set, see setPCAPInputFile()");
+	ASSERT_(callback);
+
+	internal_assure_calibration();
+
+	// Same state than live replay, to stamp scans with GPS time:
+	m_last_pos_packet_timestamp = INVALID_TIMESTAMP;
+	m_last_gps_rmc_age = INVALID_TIMESTAMP;
+	m_last_gps_rmc.fields.validity_char = 'V';
+
+	const MappedFile file(m_pcap_input_file);
+	const uint8_t* const data = file.data;
+	const uint64_t fileSize = file.size;
+
+	// PCAP global header:
+	constexpr size_t GLOBAL_HEADER_LEN = 24, RECORD_HEADER_LEN = 16;
+	if (fileSize < GLOBAL_HEADER_LEN)
+		THROW_EXCEPTION_FMT(
+			"Not a PCAP file: '%s'", m_pcap_input_file.c_str());
+
+	uint32_t magic;
+	std::memcpy(&magic, data, sizeof(magic));
+	bool swapped = false, nanoseconds = false;
+	switch (magic)
+	{
+		case 0xa1b2c3d4: break;
+		case 0xd4c3b2a1: swapped = true; break;
+		case 0xa1b23c4d: nanoseconds = true; break;
+		case 0x4d3cb2a1:
+			swapped = nanoseconds = true;
+			break;
+		default:
+			THROW_EXCEPTION_FMT(
+				"Not a PCAP file (pcapng is not supported): '%s'",
+				m_pcap_input_file.c_str());
+	}
+	const uint32_t linkType = readPCAPField<uint32_t>(data + 20, swapped);
+	if (linkType != 1 /* LINKTYPE_ETHERNET */)
+		THROW_EXCEPTION_FMT(
+			"Unsupported PCAP link type=%u, only Ethernet captures can be "
+			"replayed",
+			static_cast<unsigned int>(linkType));
+	const double fracToSeconds = nanoseconds ? 1e-9 : 1e-6;
+
+	// Only accept packets from this IP, if set:
+	uint32_t filterIP = 0;
+	if (!m_device_ip.empty()) filterIP = inet_addr(m_device_ip.c_str());
+
+	// Decoding scans, which are emitted in order:
+	if (numThreads == 0)
+		numThreads = std::max(1U, std::thread::hardware_concurrency());
+	const size_t maxInFlight = 4 * numThreads;
+
+	struct TPending
+	{
+		mrpt::obs::CObservation::Ptr obs;
+		std::future<void> decoded;
+	};
+	std::deque<TPending> pending;
+	size_t numEmitted = 0;
+
+	auto lmbEmitFront = [&]() {
+		auto& p = pending.front();
+		if (p.decoded.valid()) p.decoded.get();	 // may rethrow
+		callback(p.obs);
+		pending.pop_front();
+		numEmitted++;
+	};
+
+	// Declared after the file and the pending list, so its threads are done
+	// before they are destroyed (e.g. if the callback throws):
+	mrpt::WorkerThreadsPool pool(
+		numThreads, mrpt::WorkerThreadsPool::POLICY_FIFO, "velodynePCAP");
+
+	// Scan being split, as pointers to its packets within the file:
+	mrpt::obs::CObservationVelodyneScan::Ptr scan;
+	std::vector<const CObservationVelodyneScan::TVelodyneRawPacket*> scanPkts;
+
+	auto lmbFlushScan = [&]() {
+		auto futDecode = pool.enqueue(
+			[scan, pkts = std::move(scanPkts), generatePointClouds,
+			 &pcParams]() {
+				scan->scan_packets.resize(pkts.size());
+				for (size_t i = 0; i < pkts.size(); i++)
+					scan->scan_packets[i] = *pkts[i];
+				if (generatePointClouds) scan->generatePointCloud(pcParams);
+			});
+		pending.push_back({scan, std::move(futDecode)});
+		scanPkts.clear();
+		scan.reset();
+	};
+
+	uint64_t pos = GLOBAL_HEADER_LEN;
+	while (pos + RECORD_HEADER_LEN <= fileSize)
+	{
+		const uint8_t* rec = data + pos;
+		const uint32_t tsSec = readPCAPField<uint32_t>(rec, swapped);
+		const uint32_t tsFrac = readPCAPField<uint32_t>(rec + 4, swapped);
+		const uint32_t inclLen = readPCAPField<uint32_t>(rec + 8, swapped);
+		pos += RECORD_HEADER_LEN;
+		if (pos + inclLen > fileSize) break;  // truncated capture
+		const uint8_t* frame = data + pos;
+		pos += inclLen;
+
+		// Ethernet + IPv4 + UDP headers:
+		constexpr size_t ETH_LEN = 14;
+		if (inclLen < ETH_LEN + 20 + 8) continue;
+		if (frame[12] != 0x08 || frame[13] != 0x00) continue;  // not IPv4
+		const uint8_t* ip = frame + ETH_LEN;
+		const size_t ipLen = (ip[0] & 0x0f) * 4u;
+		if (ip[9] != 17 /* UDP */ || ipLen < 20) continue;
+		if (ETH_LEN + ipLen + 8 > inclLen) continue;
+		if (filterIP != 0 && std::memcmp(ip + 12, &filterIP, 4) != 0)
+			continue;
+		const uint8_t* udp = ip + ipLen;
+		const uint16_t dstPort = static_cast<uint16_t>((udp[2] << 8) | udp[3]);
+		const uint8_t* payload = udp + 8;
+		const size_t payloadLen = inclLen - (ETH_LEN + ipLen + 8);
+
+		const mrpt::system::TTimeStamp pktTime = mrpt::Clock::fromDouble(
+			tsSec + tsFrac * fracToSeconds);
+
+		if (dstPort == VELODYNE_POSITION_UDP_PORT &&
+			payloadLen >= CObservationVelodyneScan::POS_PACKET_SIZE)
+		{
+			if (!internal_accept_pos_packet(pktTime)) continue;
+			CObservationVelodyneScan::TVelodynePositionPacket posPkt;
+			std::memcpy(
+				&posPkt, payload, CObservationVelodyneScan::POS_PACKET_SIZE);
+			pending.push_back({internal_process_pos_packet(posPkt, pktTime)});
+		}
+		else if (
+			dstPort == VELODYNE_DATA_UDP_PORT &&
+			payloadLen >= CObservationVelodyneScan::PACKET_SIZE)
+		{
+			// (Packed struct, usable in place)
+			const auto* pkt = reinterpret_cast<
+				const CObservationVelodyneScan::TVelodyneRawPacket*>(payload);
+
+			// Break into a new scan when the azimuth passes 360->0 deg, as in
+			// getNextObservation():
+			if (!scanPkts.empty() &&
+				(pkt->blocks[0].rotation() <
+					 scanPkts.back()->blocks[0].rotation() ||
+				 !m_return_frames))
+				lmbFlushScan();
+
+			if (!scan)
+			{
+				scan = internal_new_scan();
+				internal_stamp_scan(*scan, *pkt, pktTime);
+			}
+			scanPkts.push_back(pkt);
+		}
+
+		// Emit finished observations, waiting for the oldest ones if there
+		// are too many being decoded:
+		while (!pending.empty() &&
+			   (pending.size() > maxInFlight ||
+				!pending.front().decoded.valid() ||
+				pending.front().decoded.wait_for(std::chrono::seconds(0)) ==
+					std::future_status::ready))
+			lmbEmitFront();
+	}
+	// The last, incomplete scan is discarded, as in getNextObservation().
+
+	while (!pending.empty())
+		lmbEmitFront();
+
+	return numEmitted;
+
+	MRPT_END
+}
+
 bool CVelodyneScanner::setLidarReturnType(return_type_t ret_type)
 {
 	/* HTTP-based config: http://10.0.0.100/tab/config.html
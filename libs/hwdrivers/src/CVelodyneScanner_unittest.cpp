@@ -96,3 +96,50 @@ TEST(CVelodyneScanner, sample_hdl32_dataset)
 }
 
 #endif	// MRPT_HAS_LIBPCAP
+
+#if MRPT_HAS_TINYXML2
+TEST(CVelodyneScanner, processPCAPFile)
+{
+	const string fil =
+		UNITTEST_BASEDIR + string("/tests/sample_velodyne_vlp16_gps.pcap");
+
+	if (!mrpt::system::fileExists(fil))
+	{
+		std::cerr << "WARNING: Skipping test due to missing file: " << fil
+				  << "\n";
+		return;
+	}
+
+	CVelodyneScanner velodyne;
+	velodyne.setModelName(mrpt::hwdrivers::CVelodyneScanner::VLP16);
+	velodyne.setPCAPInputFile(fil);
+
+	for (const unsigned int nThreads : {1U, 4U})
+	{
+		size_t nScans = 0, nGPS = 0;
+		mrpt::Clock::time_point lastScanTime;
+		const size_t nObs = velodyne.processPCAPFile(
+			[&](const mrpt::obs::CObservation::Ptr& o) {
+				if (auto scan = std::dynamic_pointer_cast<
+						mrpt::obs::CObservationVelodyneScan>(o);
+					scan)
+				{
+					// Emitted in order:
+					EXPECT_GT(scan->originalReceivedTimestamp, lastScanTime);
+					lastScanTime = scan->originalReceivedTimestamp;
+					EXPECT_FALSE(scan->scan_packets.empty());
+					EXPECT_FALSE(scan->point_cloud.x.empty());
+					nScans++;
+				}
+				else if (std::dynamic_pointer_cast<
+							 mrpt::obs::CObservationGPS>(o))
+					nGPS++;
+			},
+			nThreads);
+
+		EXPECT_EQ(nScans, 4U);
+		EXPECT_GT(nGPS, 0U);
+		EXPECT_EQ(nObs, nScans + nGPS);
+	}
+}
+#endif
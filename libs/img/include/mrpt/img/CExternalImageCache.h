@@ -0,0 +1,155 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/core/WorkerThreadsPool.h>
+#include <mrpt/img/CImage.h>
+
+#include <condition_variable>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace mrpt::img
+{
+/** Asynchronous prefetching and LRU cache of decoded, externally-stored
+ * images (see mrpt::img::CImage::setExternalStorage()).
+ *
+ * Code iterating over a dataset gives "will need soon" hints through
+ * CImage::prefetch() (or mrpt::obs::CObservation::prefetch(),
+ * mrpt::obs::CRawlog::prefetchExternalImages(), which call it), and image
+ * files are then loaded and decoded by a small pool of background threads
+ * into this cache. When the image is first accessed, CImage takes it from
+ * the cache instead of decoding the file again, waiting for the decoding if
+ * it was already in progress. CImage::unload() releases its pixels back to
+ * the cache, so unloading and reloading an image does not decode it again.
+ *
+ * Images are identified by the absolute path of their external file. At most
+ * getMaxMemory() bytes of decoded images are kept, evicting the least
+ * recently used ones first, and at most getMaxPendingPrefetches() hints
+ * wait to be decoded; later hints are ignored until some decoding finishes.
+ *
+ * Images taken from the cache are removed from it, so they are never shared
+ * between two CImage objects.
+ *
+ * This class is a singleton; all methods are thread-safe.
+ *
+ * \ingroup mrpt_img_grp
+ * \note (New in MRPT 2.4.9)
+ */
+class CExternalImageCache
+{
+   public:
+	/** The unique instance */
+	static CExternalImageCache& Instance();
+
+	struct Stats
+	{
+		/** Images taken from the cache, and how many of them were still
+		 * being decoded when requested */
+		uint64_t hits = 0, waits = 0;
+		/** Requested images not found in the cache */
+		uint64_t misses = 0;
+		/** Images decoded in the background */
+		uint64_t prefetched = 0;
+		/** Hints ignored because too many were pending */
+		uint64_t droppedHints = 0;
+		/** Images removed from the cache to respect the memory limit */
+		uint64_t evicted = 0;
+		/** Current contents of the cache */
+		std::size_t memoryBytes = 0, numImages = 0;
+	};
+
+	/** Hint that the image with this absolute path will be needed soon, so
+	 * its decoding starts in the background (if not already cached). */
+	void prefetch(const std::string& absPath);
+
+	/** Takes the image with the given absolute path out of the cache, waiting
+	 * for its decoding if it is already in progress.
+	 * \return false if it is neither cached nor being decoded.
+	 */
+	bool take(const std::string& absPath, CImage& out);
+
+	/** Puts a decoded image (not an externally-stored one) into the cache,
+	 * replacing any former image with the same path. */
+	void put(const std::string& absPath, CImage&& img);
+
+	/** Removes all cached images */
+	void clear();
+
+	/** Number of background decoding threads. Only has effect if called
+	 * before the first prefetch() (Default: 2) */
+	void setNumThreads(std::size_t n);
+	std::size_t getNumThreads() const;
+
+	/** Maximum memory of decoded images kept in the cache (Default:
+	 * 256 MiB). Zero disables the cache. */
+	void setMaxMemory(std::size_t bytes);
+	std::size_t getMaxMemory() const;
+
+	/** Maximum number of hints waiting to be decoded (Default: 32) */
+	void setMaxPendingPrefetches(std::size_t n);
+	std::size_t getMaxPendingPrefetches() const;
+
+	/** Whether CImage::unload() releases its images into the cache
+	 * (Default: true). Disable it if your code modifies externally-stored
+	 * images in place, so later loads do not get the modified pixels. */
+	void setCacheUnloadedImages(bool enable);
+	bool getCacheUnloadedImages() const;
+
+	Stats getStats() const;
+	/** Resets all the counters in Stats, except the current contents */
+	void resetStats();
+
+	CExternalImageCache(const CExternalImageCache&) = delete;
+	CExternalImageCache& operator=(const CExternalImageCache&) = delete;
+
+   private:
+	CExternalImageCache() = default;
+	~CExternalImageCache() = default;
+
+	enum class pending_state_t : uint8_t
+	{
+		Queued,
+		Decoding
+	};
+
+	struct TCachedImage
+	{
+		std::string path;
+		CImage img;
+		std::size_t bytes = 0;
+	};
+	using lru_list_t = std::list<TCachedImage>;
+
+	void decodeTask(const std::string& absPath);
+	// These must be called with m_mtx locked:
+	void insert(const std::string& absPath, CImage&& img);
+	void erase(lru_list_t::iterator it);
+	void evict(std::size_t maxMemory);
+
+	mutable std::mutex m_mtx;
+	std::condition_variable m_decoded;
+	/** Most recently used images first */
+	lru_list_t m_lru;
+	std::unordered_map<std::string, lru_list_t::iterator> m_index;
+	/** Hints not decoded yet */
+	std::unordered_map<std::string, pending_state_t> m_pending;
+	Stats m_stats;
+	std::size_t m_numThreads = 2, m_maxMemory = 256 * 1024 * 1024,
+				m_maxPending = 32;
+	bool m_cacheUnloaded = true;
+	/** Created upon the first prefetch() */
+	std::unique_ptr<mrpt::WorkerThreadsPool> m_threads;
+};
+
+}  // namespace mrpt::img
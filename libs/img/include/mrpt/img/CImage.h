@@ -63,6 +63,41 @@ enum TImageChannels : uint8_t
 	CH_RGB = 3
 };
 
+/** Color filter array (Bayer) layouts of raw camera images, named after the
+ * colors of the top-left 2x2 pixels in row-major order.
+ * \sa CImage::loadFromBayer() */
+enum TBayerPattern : uint8_t
+{
+	BAYER_RGGB = 0,
+	BAYER_BGGR,
+	BAYER_GRBG,
+	BAYER_GBRG
+};
+
+/** Demosaicing methods for CImage::loadFromBayer() */
+enum TDemosaicMethod : uint8_t
+{
+	/** Bilinear interpolation of the two missing colors of each pixel */
+	DEMOSAIC_BILINEAR = 0,
+	/** Green is interpolated along the direction with the lowest gradient,
+	 * and red and blue from color differences to green (Hamilton-Adams).
+	 * Much less zipper artifacts than bilinear at edges. */
+	DEMOSAIC_EDGE_AWARE,
+	/** One output pixel per 2x2 Bayer cell, without interpolation: the output
+	 * image has half the width and height of the raw one. */
+	DEMOSAIC_HALF_SIZE
+};
+
+/** Byte orders of 4:2:2 YUV (YCbCr) images, with 4 bytes per 2 pixels.
+ * \sa CImage::loadFromYUV422() */
+enum TYUV422Layout : uint8_t
+{
+	/** Y0 U Y1 V (also known as YUY2) */
+	YUV422_YUYV = 0,
+	/** U Y0 V Y1 (e.g. IIDC/1394 cameras) */
+	YUV422_UYVY
+};
+
 /** For usage in one of the CImage constructors */
 enum ctor_CImage_ref_or_gray
 {
@@ -818,12 +853,22 @@ class CImage : public mrpt::serialization::CSerializable, public CCanvas
 	 * \unload
 	 */
 	inline void forceLoad() const { makeSureImageIsLoaded(true); }
+	/** For external storage image objects only, hints that the image will be
+	 * needed soon, so it is loaded and decoded in a background thread (see
+	 * CExternalImageCache). It does nothing if the image is already loaded,
+	 * or for images without the flag "external storage".
+	 * \sa forceLoad
+	 * \note (New in MRPT 2.4.9)
+	 */
+	void prefetch() const noexcept;
 	/** For external storage image objects only, this method unloads the image
 	 * from memory (or does nothing if already unloaded).
 	 *  It does not need to be called explicitly, unless the user wants to save
 	 * memory for images that will not be used often.
 	 *  If called for an image without the flag "external storage", it is
 	 * simply ignored.
+	 *  The decoded image is kept in the CExternalImageCache (within its
+	 * memory limit), so loading it again does not need to decode the file.
 	 * \sa setExternalStorage, forceLoad
 	 */
 	void unload() const noexcept;
@@ -849,6 +894,39 @@ class CImage : public mrpt::serialization::CSerializable, public CCanvas
 		unsigned int width, unsigned int height, unsigned int bytesPerRow,
 		unsigned char* red, unsigned char* green, unsigned char* blue);
 
+	/** Demosaics a raw Bayer image from a camera, writing the result
+	 * directly into this image (its buffer is reused if it already has the
+	 * right size and number of channels).
+	 *
+	 * \param raw 8-bit raw pixels, `rowStride` bytes per row.
+	 * \param width,height Size of the raw image, both must be even and >=4.
+	 * \param outChannels CH_RGB for a color image, or CH_GRAY to obtain the
+	 * luminance without creating an intermediary color image.
+	 * \param method With DEMOSAIC_HALF_SIZE, this image will have a size of
+	 * `width/2 x height/2`. Together with `outChannels=CH_GRAY` this is the
+	 * fastest way to feed a vision front-end from a Bayer camera (SSE2
+	 * optimized).
+	 * \note (New in MRPT 2.4.9)
+	 */
+	void loadFromBayer(
+		const uint8_t* raw, unsigned int width, unsigned int height,
+		size_t rowStride, TBayerPattern pattern,
+		TDemosaicMethod method = DEMOSAIC_BILINEAR,
+		TImageChannels outChannels = CH_RGB);
+
+	/** Converts a 4:2:2 YUV image (ITU-R BT.601, as in camera video modes)
+	 * writing the result directly into this image (its buffer is reused if
+	 * it already has the right size and number of channels). With
+	 * `outChannels=CH_GRAY` only the Y (luminance) channel is kept (SSE2
+	 * optimized).
+	 * \param width Must be even.
+	 * \note (New in MRPT 2.4.9)
+	 */
+	void loadFromYUV422(
+		const uint8_t* data, unsigned int width, unsigned int height,
+		size_t rowStride, TYUV422Layout layout,
+		TImageChannels outChannels = CH_RGB);
+
 	/** Set the image from a matrix, interpreted as grayscale intensity values,
 	 *in the range [0,1] (normalized=true) or [0,255] (normalized=false)
 	 *	Matrix indexes are assumed to be in this order: M(row,column)
@@ -928,9 +1006,21 @@ class CImage : public mrpt::serialization::CSerializable, public CCanvas
 	}
 
 	/** Reads the image from a binary stream containing a binary jpeg file.
+	 * \param scaleDenominator 1, 2, 4 or 8: the image is decoded at that
+	 * fraction of its size (rounding up), in the DCT domain, which is much
+	 * faster than decoding it whole. (New in MRPT 2.4.9)
 	 * \exception std::exception On pixel coordinates out of bounds
+	 * \sa loadFromMemoryAsJPEG
+	 */
+	void loadFromStreamAsJPEG(
+		mrpt::io::CStream& in, unsigned int scaleDenominator = 1);
+
+	/** Like loadFromStreamAsJPEG(), for a JPEG file already in memory, which
+	 * is faster (and uses the TurboJPEG API, if MRPT was built with it).
+	 * \note (New in MRPT 2.4.9)
 	 */
-	void loadFromStreamAsJPEG(mrpt::io::CStream& in);
+	void loadFromMemoryAsJPEG(
+		const uint8_t* data, size_t length, unsigned int scaleDenominator = 1);
 
 	/** Load image from a file, whose format is determined from the extension
 	 * (internally uses OpenCV).
@@ -952,12 +1042,21 @@ class CImage : public mrpt::serialization::CSerializable, public CCanvas
 	 *
 	 * Note that this function uses cv::imdecode() internally to reuse the
 	 * memory buffer used by the image already loaded into this CImage, if
-	 * possible, minimizing the number of memory allocations.
+	 * possible, minimizing the number of memory allocations. JPEG files are
+	 * decoded with libjpeg(-turbo) or TurboJPEG instead, see
+	 * loadFromMemoryAsJPEG().
+	 *
+	 * \param scaleDenominator 1, 2, 4 or 8: load the image at that fraction
+	 * of its size (rounding up). JPEG files are decoded at that scale in the
+	 * DCT domain, which is much faster than decoding them whole; other
+	 * formats are downscaled after decoding. (New in MRPT 2.4.9)
 	 *
 	 * \return False on any error
 	 * \sa saveToFile, setExternalStorage,loadFromXPM, loadTGA
 	 */
-	bool loadFromFile(const std::string& fileName, int isColor = -1);
+	bool loadFromFile(
+		const std::string& fileName, int isColor = -1,
+		unsigned int scaleDenominator = 1);
 
 	/** Static method to construct an CImage object from a file.
 	 * See CImage::loadFromFile() for meaning of parameters.
@@ -998,14 +1097,15 @@ class CImage : public mrpt::serialization::CSerializable, public CCanvas
 	 *
 	 * \param jpeg_quality Only for JPEG files, the quality of the compression
 	 * in the range [0-100]. Larger is better quality but slower.
-	 * \note jpeg_quality is only effective if MRPT is compiled against OpenCV
-	 * 1.1.0 or newer.
+	 * \note JPEG files are encoded as in saveToStreamAsJPEG().
 	 * \return False on any error
 	 * \sa loadFromFile
 	 */
 	bool saveToFile(const std::string& fileName, int jpeg_quality = 95) const;
 
 	/** Save image to binary stream as a JPEG (.jpg) compressed format.
+	 * Uses the TurboJPEG API of libjpeg-turbo if MRPT was built with it (see
+	 * the CMake option DISABLE_TURBOJPEG), or libjpeg otherwise.
 	 * \exception std::exception On number of rows or cols equal to zero or
 	 * other errors.
 	 * \sa saveToJPEG
@@ -0,0 +1,116 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <vector>
+
+// Forward declaration:
+namespace cv
+{
+class MatAllocator;
+}
+
+namespace mrpt::img
+{
+/** A pool of memory buffers for image pixels, grouped into size classes, so
+ * the buffers of images which are destroyed are reused by the next images
+ * of a similar size instead of going back to the system heap.
+ *
+ * All images created by mrpt::img::CImage (constructors, resize()) and by
+ * the camera grabbers draw their pixels from this pool, via the OpenCV
+ * allocator returned by matAllocator(). Buffers return to the pool
+ * automatically when the last image (or observation) using them dies.
+ *
+ * Requests are rounded up to size classes in 1/8 steps between consecutive
+ * powers of two, so at most 12.5% of memory is wasted, and buffers of an
+ * image of the same (or a slightly smaller) size are reused. Buffers smaller
+ * than MIN_POOLED_BYTES are never pooled. At most getMaxPooledBytes() are
+ * kept in the pool; buffers beyond that limit are freed.
+ *
+ * This class is a singleton; all methods are thread-safe.
+ *
+ * \ingroup mrpt_img_grp
+ * \note (New in MRPT 2.4.9)
+ */
+class CImageBufferPool
+{
+   public:
+	/** The unique instance. It is never destroyed, so images with static
+	 * storage can be safely released at program exit. */
+	static CImageBufferPool& Instance();
+
+	/** Buffers smaller than this are not pooled */
+	static constexpr std::size_t MIN_POOLED_BYTES = 4096;
+	/** Alignment of all returned buffers */
+	static constexpr std::size_t ALIGNMENT = 64;
+
+	struct Stats
+	{
+		/** Requests served from, or missed by, the pool */
+		uint64_t hits = 0, misses = 0;
+		/** Buffers returned to the pool, or freed because it was full */
+		uint64_t returned = 0, discarded = 0;
+		/** Current contents of the pool */
+		std::size_t pooledBytes = 0, pooledBuffers = 0;
+	};
+
+	/** Returns a buffer of at least `bytes` bytes, which must be released
+	 * with release() with the same `bytes` value. */
+	void* allocate(std::size_t bytes);
+	/** Returns to the pool a buffer obtained with allocate(). */
+	void release(void* ptr, std::size_t bytes);
+
+	/** The actual size of the buffers allocated for a request of `bytes`. */
+	static std::size_t sizeClass(std::size_t bytes);
+
+	/** Disabling the pool frees all pooled buffers, and afterwards all
+	 * requests go directly to the heap. Enabled by default, unless the
+	 * environment variable `MRPT_IMAGE_BUFFER_POOL=0` is defined. */
+	void setEnabled(bool enabled);
+	bool isEnabled() const;
+
+	/** Maximum memory kept in the pool (Default: 256 MiB) */
+	void setMaxPooledBytes(std::size_t maxBytes);
+	std::size_t getMaxPooledBytes() const;
+
+	/** Frees all pooled buffers */
+	void clear();
+
+	Stats getStats() const;
+	/** Resets the hits, misses, returned and discarded counters */
+	void resetStats();
+
+	/** An OpenCV allocator drawing from this pool, to be assigned to
+	 * `cv::Mat::allocator` before creating a matrix (or before filling it
+	 * from a cv::VideoCapture, etc.). `nullptr` if MRPT was built without
+	 * OpenCV. */
+	cv::MatAllocator* matAllocator();
+
+	CImageBufferPool(const CImageBufferPool&) = delete;
+	CImageBufferPool& operator=(const CImageBufferPool&) = delete;
+
+   private:
+	CImageBufferPool();
+	~CImageBufferPool() = default;
+
+	void releaseAll();	// Must be called with m_mtx locked
+
+	mutable std::mutex m_mtx;
+	/** Free buffers, by size class */
+	std::map<std::size_t, std::vector<void*>> m_free;
+	Stats m_stats;
+	std::size_t m_maxPooledBytes = 256 * 1024 * 1024;
+	bool m_enabled = true;
+};
+
+}  // namespace mrpt::img
@@ -0,0 +1,221 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "img-precomp.h"  // Precompiled headers
+//
+#include <mrpt/img/CExternalImageCache.h>
+
+#include <algorithm>
+#include <iterator>
+
+using namespace mrpt::img;
+
+CExternalImageCache& CExternalImageCache::Instance()
+{
+	// Never destroyed, since images may be unloaded from static objects:
+	static auto* instance = new CExternalImageCache();
+	return *instance;
+}
+
+void CExternalImageCache::prefetch(const std::string& absPath)
+{
+	std::lock_guard<std::mutex> lck(m_mtx);
+	if (!m_maxMemory) return;
+
+	if (auto it = m_index.find(absPath); it != m_index.end())
+	{
+		// Already cached: mark as recently used.
+		m_lru.splice(m_lru.begin(), m_lru, it->second);
+		return;
+	}
+	if (m_pending.count(absPath)) return;
+	if (m_pending.size() >= m_maxPending)
+	{
+		m_stats.droppedHints++;
+		return;
+	}
+
+	if (!m_threads)
+		m_threads = std::make_unique<mrpt::WorkerThreadsPool>(
+			m_numThreads, mrpt::WorkerThreadsPool::POLICY_FIFO,
+			"imgPrefetch");
+
+	m_pending[absPath] = pending_state_t::Queued;
+	auto fut = m_threads->enqueue([this, absPath]() { decodeTask(absPath); });
+}
+
+void CExternalImageCache::decodeTask(const std::string& absPath)
+{
+	{
+		std::lock_guard<std::mutex> lck(m_mtx);
+		auto it = m_pending.find(absPath);
+		// Not wanted anymore, or already being loaded by the user:
+		if (it == m_pending.end()) return;
+		it->second = pending_state_t::Decoding;
+	}
+
+	CImage img;
+	bool ok = false;
+	try
+	{
+		ok = img.loadFromFile(absPath);
+	}
+	catch (const std::exception&)
+	{
+		// The error will be reported when the image is actually needed.
+	}
+
+	std::lock_guard<std::mutex> lck(m_mtx);
+	m_pending.erase(absPath);
+	if (ok)
+	{
+		m_stats.prefetched++;
+		insert(absPath, std::move(img));
+	}
+	m_decoded.notify_all();
+}
+
+bool CExternalImageCache::take(const std::string& absPath, CImage& out)
+{
+	std::unique_lock<std::mutex> lck(m_mtx);
+
+	if (auto p = m_pending.find(absPath); p != m_pending.end())
+	{
+		if (p->second == pending_state_t::Queued)
+		{
+			// Faster to decode it now, than waiting for earlier hints:
+			m_pending.erase(p);
+			m_stats.misses++;
+			return false;
+		}
+		m_stats.waits++;
+		m_decoded.wait(lck, [&]() { return !m_pending.count(absPath); });
+	}
+
+	auto it = m_index.find(absPath);
+	if (it == m_index.end())
+	{
+		m_stats.misses++;
+		return false;
+	}
+	m_stats.hits++;
+	out = std::move(it->second->img);
+	erase(it->second);
+	return true;
+}
+
+void CExternalImageCache::put(const std::string& absPath, CImage&& img)
+{
+	std::lock_guard<std::mutex> lck(m_mtx);
+	insert(absPath, std::move(img));
+}
+
+void CExternalImageCache::insert(const std::string& absPath, CImage&& img)
+{
+	if (auto it = m_index.find(absPath); it != m_index.end()) erase(it->second);
+
+	const std::size_t bytes = img.getRowStride() * img.getHeight();
+	if (bytes > m_maxMemory) return;
+	evict(m_maxMemory - bytes);
+
+	m_lru.push_front({absPath, std::move(img), bytes});
+	m_index[absPath] = m_lru.begin();
+	m_stats.memoryBytes += bytes;
+	m_stats.numImages++;
+}
+
+void CExternalImageCache::erase(lru_list_t::iterator it)
+{
+	m_stats.memoryBytes -= it->bytes;
+	m_stats.numImages--;
+	m_index.erase(it->path);
+	m_lru.erase(it);
+}
+
+void CExternalImageCache::evict(std::size_t maxMemory)
+{
+	while (!m_lru.empty() && m_stats.memoryBytes > maxMemory)
+	{
+		erase(std::prev(m_lru.end()));
+		m_stats.evicted++;
+	}
+}
+
+void CExternalImageCache::clear()
+{
+	std::lock_guard<std::mutex> lck(m_mtx);
+	m_lru.clear();
+	m_index.clear();
+	m_stats.memoryBytes = 0;
+	m_stats.numImages = 0;
+}
+
+void CExternalImageCache::setNumThreads(std::size_t n)
+{
+	std::lock_guard<std::mutex> lck(m_mtx);
+	m_numThreads = std::max<std::size_t>(n, 1);
+}
+
+std::size_t CExternalImageCache::getNumThreads() const
+{
+	std::lock_guard<std::mutex> lck(m_mtx);
+	return m_numThreads;
+}
+
+void CExternalImageCache::setMaxMemory(std::size_t bytes)
+{
+	std::lock_guard<std::mutex> lck(m_mtx);
+	m_maxMemory = bytes;
+	evict(bytes);
+}
+
+std::size_t CExternalImageCache::getMaxMemory() const
+{
+	std::lock_guard<std::mutex> lck(m_mtx);
+	return m_maxMemory;
+}
+
+void CExternalImageCache::setMaxPendingPrefetches(std::size_t n)
+{
+	std::lock_guard<std::mutex> lck(m_mtx);
+	m_maxPending = n;
+}
+
+std::size_t CExternalImageCache::getMaxPendingPrefetches() const
+{
+	std::lock_guard<std::mutex> lck(m_mtx);
+	return m_maxPending;
+}
+
+void CExternalImageCache::setCacheUnloadedImages(bool enable)
+{
+	std::lock_guard<std::mutex> lck(m_mtx);
+	m_cacheUnloaded = enable;
+}
+
+bool CExternalImageCache::getCacheUnloadedImages() const
+{
+	std::lock_guard<std::mutex> lck(m_mtx);
+	return m_cacheUnloaded && m_maxMemory > 0;
+}
+
+CExternalImageCache::Stats CExternalImageCache::getStats() const
+{
+	std::lock_guard<std::mutex> lck(m_mtx);
+	return m_stats;
+}
+
+void CExternalImageCache::resetStats()
+{
+	std::lock_guard<std::mutex> lck(m_mtx);
+	Stats s;
+	s.memoryBytes = m_stats.memoryBytes;
+	s.numImages = m_stats.numImages;
+	m_stats = s;
+}
@@ -0,0 +1,102 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/config.h>
+#include <mrpt/img/CExternalImageCache.h>
+#include <test_mrpt_common.h>
+
+#include <chrono>
+#include <thread>
+
+using namespace std::string_literals;
+using mrpt::img::CExternalImageCache;
+using mrpt::img::CImage;
+
+#if MRPT_HAS_OPENCV
+TEST(CExternalImageCache, putTakeEvict)
+{
+	auto& cache = CExternalImageCache::Instance();
+	cache.clear();
+	cache.resetStats();
+	const auto oldMax = cache.getMaxMemory();
+
+	CImage out;
+	EXPECT_FALSE(cache.take("/a.png", out));
+
+	// Three images of 10000 bytes, in a cache for only two of them:
+	cache.setMaxMemory(25000);
+	for (const char* f : {"/a.png", "/b.png", "/c.png"})
+	{
+		CImage img(100, 100, mrpt::img::CH_GRAY);
+		img.setPixel(0, 0, f[1]);
+		cache.put(f, std::move(img));
+	}
+	auto s = cache.getStats();
+	EXPECT_EQ(s.numImages, 2U);
+	EXPECT_EQ(s.evicted, 1U);
+
+	EXPECT_FALSE(cache.take("/a.png", out));
+	ASSERT_TRUE(cache.take("/b.png", out));
+	EXPECT_EQ(out.at<uint8_t>(0, 0), 'b');
+	// Taken images leave the cache:
+	EXPECT_FALSE(cache.take("/b.png", out));
+
+	s = cache.getStats();
+	EXPECT_EQ(s.hits, 1U);
+	EXPECT_EQ(s.misses, 3U);
+	EXPECT_EQ(s.numImages, 1U);
+	EXPECT_EQ(s.memoryBytes, 10000U);
+
+	cache.setMaxMemory(oldMax);
+	cache.clear();
+}
+
+TEST(CExternalImageCache, prefetchAndUnload)
+{
+	const auto imgFile = mrpt::UNITTEST_BASEDIR +
+		"/samples/img_basic_example/frame_color.jpg"s;
+
+	auto& cache = CExternalImageCache::Instance();
+	cache.clear();
+	cache.resetStats();
+
+	CImage img;
+	img.setExternalStorage(imgFile);
+	img.prefetch();
+	// Either decoded in the background, or by the caller if the decoding
+	// did not start yet:
+	EXPECT_EQ(img.getWidth(), 320U);
+	auto s = cache.getStats();
+	EXPECT_EQ(s.hits + s.misses, 1U);
+	EXPECT_EQ(s.numImages, 0U);
+
+	// Unloaded images go to the cache, and are reused:
+	img.unload();
+	EXPECT_EQ(cache.getStats().numImages, 1U);
+	img.prefetch();	 // Already cached
+	EXPECT_EQ(img.getHeight(), 240U);
+	s = cache.getStats();
+	EXPECT_EQ(s.hits + s.misses, 2U);
+	EXPECT_GE(s.hits, 1U);
+	EXPECT_EQ(s.numImages, 0U);
+
+	// Background decoding:
+	const auto nPrefetched = s.prefetched;
+	CImage img2;
+	img2.setExternalStorage(imgFile);
+	img2.prefetch();
+	const auto tStart = std::chrono::steady_clock::now();
+	while (cache.getStats().prefetched == nPrefetched &&
+		   std::chrono::steady_clock::now() - tStart < std::chrono::seconds(10))
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	EXPECT_EQ(img2.getWidth(), 320U);
+	EXPECT_EQ(cache.getStats().hits, s.hits + 1);
+}
+#endif
@@ -49,7 +49,7 @@ void impl_image_SSE2_scale_half_1c8u(
 
 	const int sw = w / 16;
 	const int sh = h / 2;
-	const int rest_w = w - (16 * w);
+	const int rest_w = w - (16 * sw);
 
 	for (int i = 0; i < sh; i++)
 	{
@@ -94,7 +94,7 @@ void impl_image_SSE2_scale_half_smooth_1c8u(
 
 	const int sw = w / 16;
 	const int sh = h / 2;
-	const int rest_w = w - (16 * w);
+	const int rest_w = w - (16 * sw);
 
 	for (int i = 0; i < sh; i++)
 	{
@@ -119,10 +119,13 @@ void impl_image_SSE2_scale_half_smooth_1c8u(
 		if (rest_w != 0)
 		{
 			const uint8_t* ir = in + 16 * sw;
-			const uint8_t* irr = in + step_in;
+			const uint8_t* irr = ir + step_in;
 			for (int p = 0; p < rest_w / 2; p++)
 			{
-				*outp++ = (ir[0] + ir[1] + irr[0] + irr[1]) / 4;
+				// Same rounding than the _mm_avg_epu8/16 above:
+				const int a = (ir[0] + irr[0] + 1) >> 1;
+				const int b = (ir[1] + irr[1] + 1) >> 1;
+				*outp++ = static_cast<uint8_t>((a + b + 1) >> 1);
 				ir += 2;
 				irr += 2;
 			}
@@ -185,6 +188,123 @@ void image_SSE2_scale_half_smooth_1c8u(
 	}
 }
 
+/** Converts each 2x2 Bayer cell into 1x1 gray pixel, as the weighted sum of
+ * its 4 raw values: `(w[0]*a + w[1]*b + w[2]*c + w[3]*d + 128) >> 8`, with
+ * `a b` the top and `c d` the bottom raw pixels of the cell.
+ *  - <b>Input format:</b> uint8_t, 1 channel (raw Bayer), size w x h
+ *  - <b>Output format:</b> uint8_t, 1 channel, size w/2 x h/2
+ *  - <b>Preconditions:</b> the weights must sum 256.
+ *  - <b>Notes:</b> Unaligned loads and stores.
+ *  - <b>Requires:</b> SSE2
+ *  - <b>Invoked from:</b> mrpt::img::CImage::loadFromBayer()
+ */
+void image_SSE2_bayer_half_gray_8u(
+	const uint8_t* in, uint8_t* out, int w, int h, size_t step_in,
+	size_t step_out, const uint16_t weights[4])
+{
+	const __m128i m = _mm_set1_epi16(0x00ff);
+	const __m128i w00 = _mm_set1_epi16(static_cast<short>(weights[0]));
+	const __m128i w01 = _mm_set1_epi16(static_cast<short>(weights[1]));
+	const __m128i w10 = _mm_set1_epi16(static_cast<short>(weights[2]));
+	const __m128i w11 = _mm_set1_epi16(static_cast<short>(weights[3]));
+	const __m128i half = _mm_set1_epi16(128);
+
+	const int sw = w / 16;
+	const int sh = h / 2;
+
+	for (int i = 0; i < sh; i++)
+	{
+		const uint8_t* r0 = in;
+		const uint8_t* r1 = in + step_in;
+		uint8_t* outp = out;
+		for (int j = 0; j < sw; j++)
+		{
+			const __m128i a =
+				_mm_loadu_si128(reinterpret_cast<const __m128i*>(r0));
+			const __m128i b =
+				_mm_loadu_si128(reinterpret_cast<const __m128i*>(r1));
+			// The sum of all weighted values is <= 255*256+128, so it fits
+			// in unsigned 16-bit lanes:
+			__m128i y = _mm_add_epi16(
+				_mm_mullo_epi16(_mm_and_si128(a, m), w00),
+				_mm_mullo_epi16(_mm_srli_epi16(a, 8), w01));
+			y = _mm_add_epi16(y, _mm_mullo_epi16(_mm_and_si128(b, m), w10));
+			y = _mm_add_epi16(y, _mm_mullo_epi16(_mm_srli_epi16(b, 8), w11));
+			y = _mm_srli_epi16(_mm_add_epi16(y, half), 8);
+			_mm_storel_epi64(
+				reinterpret_cast<__m128i*>(outp), _mm_packus_epi16(y, y));
+			r0 += 16;
+			r1 += 16;
+			outp += 8;
+		}
+		// Extra pixels? (w mod 16 != 0)
+		for (int p = 16 * sw; p + 1 < w; p += 2)
+		{
+			*outp++ = static_cast<uint8_t>(
+				(weights[0] * r0[0] + weights[1] * r0[1] + weights[2] * r1[0] +
+				 weights[3] * r1[1] + 128) >>
+				8);
+			r0 += 2;
+			r1 += 2;
+		}
+
+		in += 2 * step_in;
+		out += step_out;
+	}
+}
+
+/** Extracts the Y (luminance) channel of a 4:2:2 YUV image, with YUYV or UYVY
+ * byte order.
+ *  - <b>Input format:</b> uint8_t, 2 bytes per pixel
+ *  - <b>Output format:</b> uint8_t, 1 channel
+ *  - <b>Preconditions:</b> w must be even.
+ *  - <b>Notes:</b> Unaligned loads and stores.
+ *  - <b>Requires:</b> SSE2
+ *  - <b>Invoked from:</b> mrpt::img::CImage::loadFromYUV422()
+ */
+void image_SSE2_yuv422_to_gray_8u(
+	const uint8_t* in, uint8_t* out, int w, int h, size_t step_in,
+	size_t step_out, bool uyvy)
+{
+	const __m128i m = _mm_set1_epi16(0x00ff);
+	const int sw = w / 16;
+
+	for (int i = 0; i < h; i++)
+	{
+		const uint8_t* inp = in;
+		uint8_t* outp = out;
+		for (int j = 0; j < sw; j++)
+		{
+			__m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(inp));
+			__m128i b =
+				_mm_loadu_si128(reinterpret_cast<const __m128i*>(inp + 16));
+			if (uyvy)
+			{
+				a = _mm_srli_epi16(a, 8);
+				b = _mm_srli_epi16(b, 8);
+			}
+			else
+			{
+				a = _mm_and_si128(a, m);
+				b = _mm_and_si128(b, m);
+			}
+			_mm_storeu_si128(
+				reinterpret_cast<__m128i*>(outp), _mm_packus_epi16(a, b));
+			inp += 32;
+			outp += 16;
+		}
+		// Extra pixels? (w mod 16 != 0)
+		for (int p = 16 * sw; p < w; p++)
+		{
+			*outp++ = inp[uyvy ? 1 : 0];
+			inp += 2;
+		}
+
+		in += step_in;
+		out += step_out;
+	}
+}
+
 // TODO:
 // Sum of absolute differences: Use  _mm_sad_epu8
 
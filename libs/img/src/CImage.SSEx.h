@@ -30,3 +30,9 @@ void image_SSSE3_rgb_to_gray_8u(
 void image_SSSE3_bgr_to_gray_8u(
 	const uint8_t* in, uint8_t* out, int w, int h, size_t in_step,
 	size_t out_step);
+void image_SSE2_bayer_half_gray_8u(
+	const uint8_t* in, uint8_t* out, int w, int h, size_t in_step,
+	size_t out_step, const uint16_t weights[4]);
+void image_SSE2_yuv422_to_gray_8u(
+	const uint8_t* in, uint8_t* out, int w, int h, size_t in_step,
+	size_t out_step, bool uyvy);
@@ -252,6 +252,13 @@ void impl_image_SSSE3_rgb_or_bgr_to_gray_8u(
 				outp += 8;
 			}
 		}
+		// Extra pixels? (w mod 16 != 0), with the same weights than above:
+		const uint8_t* ip = in + 48 * sw;
+		for (int x = 16 * sw; x < w; x++, ip += 3)
+		{
+			const int b = ip[IS_RGB ? 2 : 0], g = ip[1], r = ip[IS_RGB ? 0 : 2];
+			*outp++ = static_cast<uint8_t>((77 * b + 150 * g + 29 * r) >> 8);
+		}
 		in += step_in;
 		out += step_out;
 	}
@@ -12,7 +12,9 @@
 #include <mrpt/core/cpu.h>
 #include <mrpt/core/get_env.h>
 #include <mrpt/core/round.h>  // for round()
+#include <mrpt/img/CExternalImageCache.h>
 #include <mrpt/img/CImage.h>
+#include <mrpt/img/CImageBufferPool.h>
 #include <mrpt/io/CFileInputStream.h>
 #include <mrpt/io/CFileOutputStream.h>
 #include <mrpt/io/CMemoryStream.h>
@@ -26,6 +28,7 @@
 #include <mrpt/system/CTimeLogger.h>
 #include <mrpt/system/filesystem.h>
 #include <mrpt/system/memory.h>
+#include <mrpt/system/string_utils.h>
 
 #include <iostream>
 
@@ -296,9 +299,13 @@ void CImage::resize(
 	static_assert(
 		pixelDepth2CvDepth<int>(PixelDepth::D8U) + CV_8UC(3) == CV_8UC3);
 
-	m_impl->img = cv::Mat(
+	// Reuse the pixel buffers of former images:
+	cv::Mat m;
+	m.allocator = CImageBufferPool::Instance().matAllocator();
+	m.create(
 		static_cast<int>(height), static_cast<int>(width),
 		pixelDepth2CvDepth<int>(depth) + ((nChannels - 1) << CV_CN_SHIFT));
+	m_impl->img = std::move(m);
 
 #if IMAGE_ALLOC_PERFLOG
 	alloc_tims.leave(sLog.c_str());
@@ -331,14 +338,44 @@ mrpt::img::CImage CImage::LoadFromFile(const std::string& fileName, int isColor)
 	return im;
 }
 
-bool CImage::loadFromFile(const std::string& fileName, int isColor)
+bool CImage::loadFromFile(
+	const std::string& fileName, int isColor, unsigned int scaleDenominator)
 {
 	MRPT_START
 
 #if MRPT_HAS_OPENCV
+	ASSERTMSG_(
+		scaleDenominator == 1 || scaleDenominator == 2 ||
+			scaleDenominator == 4 || scaleDenominator == 8,
+		"scaleDenominator must be 1, 2, 4 or 8");
 #ifdef HAVE_OPENCV_IMGCODECS
 	std::vector<uint8_t> fileData;
 	if (!mrpt::io::loadBinaryFile(fileData, fileName)) return false;
+
+#if MRPT_HAS_JPEG
+	// JPEG files (SOI marker): decode them with libjpeg, at the desired scale
+	if (fileData.size() > 2 && fileData[0] == 0xFF && fileData[1] == 0xD8)
+	{
+		try
+		{
+			loadFromMemoryAsJPEG(
+				fileData.data(), fileData.size(), scaleDenominator);
+		}
+		catch (const std::exception&)
+		{
+			return false;
+		}
+		m_imgIsExternalStorage = false;
+		m_externalFile.clear();
+		if (m_impl->img.empty()) return false;
+		if (isColor == 0 && m_impl->img.channels() == 3)
+			cv::cvtColor(m_impl->img, m_impl->img, cv::COLOR_BGR2GRAY);
+		else if (isColor > 0 && m_impl->img.channels() == 1)
+			cv::cvtColor(m_impl->img, m_impl->img, cv::COLOR_GRAY2BGR);
+		return true;
+	}
+#endif
+
 	const cv::Mat data(fileData.size(), 1, CV_8UC1, fileData.data());
 
 	// Reuse the buffer (save memory allocations) if possible:
@@ -356,6 +393,16 @@ bool CImage::loadFromFile(const std::string& fileName, int isColor)
 
 	if (m_impl->img.empty()) return false;
 
+	if (scaleDenominator > 1)
+	{
+		const auto d = static_cast<int>(scaleDenominator);
+		cv::resize(
+			m_impl->img, m_impl->img,
+			cv::Size(
+				(m_impl->img.cols + d - 1) / d, (m_impl->img.rows + d - 1) / d),
+			0, 0, cv::INTER_AREA);
+	}
+
 	return true;
 #else
 	THROW_EXCEPTION("MRPT has been compiled with MRPT_HAS_OPENCV=0 !");
@@ -370,6 +417,19 @@ bool CImage::saveToFile(const std::string& fileName, int jpeg_quality) const
 	makeSureImageIsLoaded();  // For delayed loaded images stored externally
 	ASSERT_(!m_impl->img.empty());
 
+#if MRPT_HAS_JPEG
+	const auto ext = mrpt::system::lowerCase(
+		mrpt::system::extractFileExtension(fileName));
+	if ((ext == "jpg" || ext == "jpeg") && m_impl->img.depth() == CV_8U &&
+		(m_impl->img.channels() == 1 || m_impl->img.channels() == 3))
+	{
+		mrpt::io::CFileOutputStream f;
+		if (!f.open(fileName)) return false;
+		saveToStreamAsJPEG(f, jpeg_quality);
+		return true;
+	}
+#endif
+
 #ifdef HAVE_OPENCV_IMGCODECS
 	const std::vector<int> params = {cv::IMWRITE_JPEG_QUALITY, jpeg_quality};
 	return cv::imwrite(fileName, m_impl->img, params);
@@ -664,11 +724,7 @@ void CImage::serializeFrom(mrpt::serialization::CArchive& in, uint8_t version)
 			in >> nBytes;
 			std::vector<uint8_t> buf(nBytes);
 			in.ReadBuffer(buf.data(), nBytes);
-
-			mrpt::io::CMemoryStream aux;
-			aux.assignMemoryNotOwn(buf.data(), buf.size());
-			aux.Seek(0);
-			loadFromStreamAsJPEG(aux);
+			loadFromMemoryAsJPEG(buf.data(), buf.size());
 		}
 		break;
 		case 2:
@@ -803,12 +859,7 @@ void CImage::serializeFrom(mrpt::serialization::CArchive& in, uint8_t version)
 
 						std::vector<uint8_t> buf(nBytes);
 						in.ReadBuffer(buf.data(), nBytes);
-
-						mrpt::io::CMemoryStream aux;
-						aux.assignMemoryNotOwn(buf.data(), buf.size());
-						aux.Seek(0);
-
-						loadFromStreamAsJPEG(aux);
+						loadFromMemoryAsJPEG(buf.data(), buf.size());
 					}
 				}
 			}
@@ -990,7 +1041,7 @@ CImage CImage::grayscale() const
 #if MRPT_HAS_OPENCV
 static bool my_img_to_grayscale(const cv::Mat& src, cv::Mat& dest)
 {
-	if (dest.size() != src.size() || dest.type() != src.type())
+	if (dest.size() != src.size() || dest.type() != CV_8UC1)
 		dest = cv::Mat(src.rows, src.cols, CV_8UC1);
 
 		// If possible, use SSE optimized version:
@@ -1624,11 +1675,43 @@ void CImage::unload() const noexcept
 			std::cout << "[CImage::unload()] Called on this="
 					  << reinterpret_cast<const void*>(this) << std::endl;
 
+		auto& cache = CExternalImageCache::Instance();
+		if (!m_impl->img.empty() && cache.getCacheUnloadedImages())
+		{
+			try
+			{
+				CImage decoded;
+				decoded.m_impl->img = m_impl->img;
+				cache.put(
+					getExternalStorageFileAbsolutePath(), std::move(decoded));
+			}
+			catch (const std::exception&)
+			{
+				// Not cached, no problem.
+			}
+		}
+
 		const_cast<cv::Mat&>(m_impl->img) = cv::Mat();
 	}
 #endif
 }
 
+void CImage::prefetch() const noexcept
+{
+#if MRPT_HAS_OPENCV
+	if (!m_imgIsExternalStorage || !m_impl->img.empty()) return;
+	try
+	{
+		CExternalImageCache::Instance().prefetch(
+			getExternalStorageFileAbsolutePath());
+	}
+	catch (const std::exception&)
+	{
+		// It is just a hint.
+	}
+#endif
+}
+
 void CImage::makeSureImageIsLoaded(bool allowNonInitialized) const
 {
 #if MRPT_HAS_OPENCV
@@ -1641,6 +1724,21 @@ void CImage::makeSureImageIsLoaded(bool allowNonInitialized) const
 		string wholeFile;
 		getExternalStorageFileAbsolutePath(wholeFile);
 
+		// Already decoded in the background, or unloaded?
+		CImage decoded;
+		if (CExternalImageCache::Instance().take(wholeFile, decoded))
+		{
+#if MRPT_HAS_OPENCV
+			const_cast<cv::Mat&>(m_impl->img) =
+				std::move(decoded.m_impl->img);
+#endif
+			if (MRPT_DEBUG_IMG_LAZY_LOAD)
+				std::cout << "[CImage] Lazy-load image file '" << wholeFile
+						  << "' taken from CExternalImageCache on this="
+						  << reinterpret_cast<const void*>(this) << std::endl;
+			return;
+		}
+
 		const std::string tmpFile = m_externalFile;
 
 		bool ret = const_cast<CImage*>(this)->loadFromFile(wholeFile);
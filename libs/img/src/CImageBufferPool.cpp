@@ -0,0 +1,227 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "img-precomp.h"  // Precompiled headers
+//
+#include <mrpt/core/aligned_allocator.h>
+#include <mrpt/core/get_env.h>
+#include <mrpt/img/CImageBufferPool.h>
+
+#include <new>
+
+// Universal include for all versions of OpenCV
+#include <mrpt/3rdparty/do_opencv_includes.h>
+
+using namespace mrpt::img;
+
+#if MRPT_HAS_OPENCV
+namespace
+{
+#if MRPT_OPENCV_VERSION_NUM >= 0x412
+using access_flag_t = cv::AccessFlag;
+#else
+using access_flag_t = int;
+#endif
+
+// Same than OpenCV's default allocator, but using CImageBufferPool:
+class PooledMatAllocator : public cv::MatAllocator
+{
+   public:
+	explicit PooledMatAllocator(CImageBufferPool& pool) : m_pool(pool) {}
+
+	cv::UMatData* allocate(
+		int dims, const int* sizes, int type, void* data0, size_t* step,
+		access_flag_t, cv::UMatUsageFlags) const override
+	{
+		size_t total = CV_ELEM_SIZE(type);
+		for (int i = dims - 1; i >= 0; i--)
+		{
+			if (step)
+			{
+				if (data0 && step[i] != CV_AUTOSTEP)
+				{
+					CV_Assert(total <= step[i]);
+					total = step[i];
+				}
+				else
+					step[i] = total;
+			}
+			total *= sizes[i];
+		}
+		auto* u = new cv::UMatData(this);
+		u->data = u->origdata = static_cast<uchar*>(
+			data0 ? data0 : m_pool.allocate(total));
+		u->size = total;
+		if (data0) u->flags |= cv::UMatData::USER_ALLOCATED;
+		return u;
+	}
+
+	bool allocate(
+		cv::UMatData* u, access_flag_t, cv::UMatUsageFlags) const override
+	{
+		return u != nullptr;
+	}
+
+	void deallocate(cv::UMatData* u) const override
+	{
+		if (!u) return;
+		CV_Assert(u->urefcount == 0);
+		CV_Assert(u->refcount == 0);
+		if (!(u->flags & cv::UMatData::USER_ALLOCATED))
+		{
+			m_pool.release(u->origdata, u->size);
+			u->origdata = nullptr;
+		}
+		delete u;
+	}
+
+   private:
+	CImageBufferPool& m_pool;
+};
+}  // namespace
+#endif
+
+CImageBufferPool& CImageBufferPool::Instance()
+{
+	// Never destroyed, on purpose (see docs):
+	static auto* instance = new CImageBufferPool();
+	return *instance;
+}
+
+CImageBufferPool::CImageBufferPool()
+	: m_enabled(mrpt::get_env<bool>("MRPT_IMAGE_BUFFER_POOL", true))
+{
+}
+
+std::size_t CImageBufferPool::sizeClass(std::size_t bytes)
+{
+	if (bytes <= MIN_POOLED_BYTES)
+		return (bytes + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+
+	// 1/8 of the largest power of two below "bytes":
+	std::size_t step = 1;
+	while ((step << 4) < bytes)
+		step <<= 1;
+	return (bytes + step - 1) & ~(step - 1);
+}
+
+void* CImageBufferPool::allocate(std::size_t bytes)
+{
+	const std::size_t cls = sizeClass(bytes);
+	if (cls >= MIN_POOLED_BYTES)
+	{
+		std::lock_guard<std::mutex> lck(m_mtx);
+		if (m_enabled)
+		{
+			auto it = m_free.find(cls);
+			if (it != m_free.end() && !it->second.empty())
+			{
+				void* ptr = it->second.back();
+				it->second.pop_back();
+				m_stats.hits++;
+				m_stats.pooledBuffers--;
+				m_stats.pooledBytes -= cls;
+				return ptr;
+			}
+			m_stats.misses++;
+		}
+	}
+	void* ptr = mrpt::aligned_malloc(cls, ALIGNMENT);
+	if (!ptr) throw std::bad_alloc();
+	return ptr;
+}
+
+void CImageBufferPool::release(void* ptr, std::size_t bytes)
+{
+	if (!ptr) return;
+	const std::size_t cls = sizeClass(bytes);
+	if (cls >= MIN_POOLED_BYTES)
+	{
+		std::lock_guard<std::mutex> lck(m_mtx);
+		if (m_enabled)
+		{
+			if (m_stats.pooledBytes + cls <= m_maxPooledBytes)
+			{
+				m_free[cls].push_back(ptr);
+				m_stats.returned++;
+				m_stats.pooledBuffers++;
+				m_stats.pooledBytes += cls;
+				return;
+			}
+			m_stats.discarded++;
+		}
+	}
+	mrpt::aligned_free(ptr);
+}
+
+void CImageBufferPool::releaseAll()
+{
+	for (auto& kv : m_free)
+		for (void* ptr : kv.second)
+			mrpt::aligned_free(ptr);
+	m_free.clear();
+	m_stats.pooledBuffers = 0;
+	m_stats.pooledBytes = 0;
+}
+
+void CImageBufferPool::setEnabled(bool enabled)
+{
+	std::lock_guard<std::mutex> lck(m_mtx);
+	m_enabled = enabled;
+	if (!enabled) releaseAll();
+}
+
+bool CImageBufferPool::isEnabled() const
+{
+	std::lock_guard<std::mutex> lck(m_mtx);
+	return m_enabled;
+}
+
+void CImageBufferPool::setMaxPooledBytes(std::size_t maxBytes)
+{
+	std::lock_guard<std::mutex> lck(m_mtx);
+	m_maxPooledBytes = maxBytes;
+	if (m_stats.pooledBytes > maxBytes) releaseAll();
+}
+
+std::size_t CImageBufferPool::getMaxPooledBytes() const
+{
+	std::lock_guard<std::mutex> lck(m_mtx);
+	return m_maxPooledBytes;
+}
+
+void CImageBufferPool::clear()
+{
+	std::lock_guard<std::mutex> lck(m_mtx);
+	releaseAll();
+}
+
+CImageBufferPool::Stats CImageBufferPool::getStats() const
+{
+	std::lock_guard<std::mutex> lck(m_mtx);
+	return m_stats;
+}
+
+void CImageBufferPool::resetStats()
+{
+	std::lock_guard<std::mutex> lck(m_mtx);
+	m_stats.hits = m_stats.misses = 0;
+	m_stats.returned = m_stats.discarded = 0;
+}
+
+cv::MatAllocator* CImageBufferPool::matAllocator()
+{
+#if MRPT_HAS_OPENCV
+	// Never destroyed either, since images may outlive any static object:
+	static auto* allocator = new PooledMatAllocator(*this);
+	return allocator;
+#else
+	return nullptr;
+#endif
+}
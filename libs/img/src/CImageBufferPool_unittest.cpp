@@ -0,0 +1,99 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/config.h>
+#include <mrpt/img/CImage.h>
+#include <mrpt/img/CImageBufferPool.h>
+
+#include <cstdint>
+
+using mrpt::img::CImageBufferPool;
+
+TEST(CImageBufferPool, sizeClass)
+{
+	EXPECT_EQ(CImageBufferPool::sizeClass(1), 64U);
+	EXPECT_EQ(CImageBufferPool::sizeClass(4096), 4096U);
+	EXPECT_EQ(CImageBufferPool::sizeClass(4097), 4608U);
+	EXPECT_EQ(CImageBufferPool::sizeClass(8192), 8192U);
+	EXPECT_EQ(CImageBufferPool::sizeClass(640 * 480 * 3), 983040U);
+	for (std::size_t n = 1; n < 10000000; n = n * 3 + 1)
+	{
+		const auto c = CImageBufferPool::sizeClass(n);
+		EXPECT_GE(c, n);
+		EXPECT_LE(c, n + n / 8 + CImageBufferPool::ALIGNMENT);
+		EXPECT_EQ(CImageBufferPool::sizeClass(c), c);
+	}
+}
+
+TEST(CImageBufferPool, reuse)
+{
+	auto& pool = CImageBufferPool::Instance();
+	pool.clear();
+	pool.resetStats();
+
+	const std::size_t N = 100000;
+	void* a = pool.allocate(N);
+	EXPECT_EQ(reinterpret_cast<uintptr_t>(a) % CImageBufferPool::ALIGNMENT, 0U);
+	pool.release(a, N);
+	auto s = pool.getStats();
+	EXPECT_EQ(s.misses, 1U);
+	EXPECT_EQ(s.returned, 1U);
+	EXPECT_EQ(s.pooledBuffers, 1U);
+	EXPECT_EQ(s.pooledBytes, CImageBufferPool::sizeClass(N));
+
+	// A slightly smaller request, in the same size class:
+	void* b = pool.allocate(N - 10);
+	EXPECT_EQ(a, b);
+	s = pool.getStats();
+	EXPECT_EQ(s.hits, 1U);
+	EXPECT_EQ(s.pooledBuffers, 0U);
+
+	// Small buffers are not pooled:
+	void* c = pool.allocate(100);
+	pool.release(c, 100);
+	EXPECT_EQ(pool.getStats().pooledBuffers, 0U);
+
+	// Memory limit:
+	const auto oldMax = pool.getMaxPooledBytes();
+	pool.setMaxPooledBytes(N / 2);
+	pool.release(b, N - 10);
+	s = pool.getStats();
+	EXPECT_EQ(s.discarded, 1U);
+	EXPECT_EQ(s.pooledBytes, 0U);
+	pool.setMaxPooledBytes(oldMax);
+}
+
+#if MRPT_HAS_OPENCV
+TEST(CImageBufferPool, imagesReuseBuffers)
+{
+	auto& pool = CImageBufferPool::Instance();
+	pool.clear();
+	pool.resetStats();
+
+	const void* pixels = nullptr;
+	{
+		mrpt::img::CImage img(640, 480, mrpt::img::CH_RGB);
+		pixels = img.ptrLine<uint8_t>(0);
+	}
+	EXPECT_EQ(pool.getStats().pooledBuffers, 1U);
+	{
+		// Shallow copies keep the buffer alive:
+		mrpt::img::CImage img(640, 480, mrpt::img::CH_RGB);
+		EXPECT_EQ(img.ptrLine<uint8_t>(0), pixels);
+		mrpt::img::CImage copy(img, mrpt::img::SHALLOW_COPY);
+		img.clear();
+		EXPECT_EQ(pool.getStats().pooledBuffers, 0U);
+	}
+	const auto s = pool.getStats();
+	EXPECT_EQ(s.hits, 1U);
+	EXPECT_EQ(s.misses, 1U);
+	EXPECT_EQ(s.pooledBuffers, 1U);
+}
+#endif
@@ -11,8 +11,13 @@
 //
 #include <mrpt/config.h>
 #include <mrpt/img/CImage.h>
+#include <mrpt/io/CMemoryStream.h>
 #include <mrpt/io/CStream.h>
 
+#include <algorithm>
+#include <functional>
+#include <vector>
+
 #include "CImage_impl.h"
 
 // Universal include for all versions of OpenCV
@@ -38,6 +43,10 @@ using mrpt::io::CStream;
 #include <cstdio>
 #define mrpt_jpeg_source_mgr jpeg_source_mgr
 
+#if MRPT_HAS_TURBOJPEG
+#include <turbojpeg.h>
+#endif
+
 typedef struct
 {
 	struct jpeg_destination_mgr pub; /* public fields */
@@ -48,7 +57,7 @@ typedef struct
 
 using mrpt_dest_ptr = mrpt_destination_mgr*;
 
-#define OUTPUT_BUF_SIZE 4096 /* choose an efficiently fwrite'able size */
+#define OUTPUT_BUF_SIZE 16384 /* choose an efficiently fwrite'able size */
 
 /*
  * Initialize destination --- called by jpeg_start_compress
@@ -163,7 +172,7 @@ typedef struct
 
 using my_src_ptr = my_source_mgr*;
 
-#define INPUT_BUF_SIZE 4096 /* choose an efficiently fread'able size */
+#define INPUT_BUF_SIZE 16384 /* choose an efficiently fread'able size */
 
 /*
  * Initialize source --- called by jpeg_read_header
@@ -345,211 +354,303 @@ jpeg_stdio_src(j_decompress_ptr cinfo, CStream* in)
 // ---------------------------------------------------------------------------------------
 #endif	// MRPT_HAS_JPEG
 
-void CImage::saveToStreamAsJPEG(CStream& out, const int jpeg_quality) const
+// ---------------------------------------------------------------------------------------
+//			Encoding and decoding of whole images (TurboJPEG or libjpeg)
+// ---------------------------------------------------------------------------------------
+#if MRPT_HAS_JPEG
+namespace
 {
-#if MRPT_HAS_OPENCV && MRPT_HAS_JPEG
-	MRPT_START
+// Returns the first row of a new image of the given size and channels (1: gray
+// or 3: BGR, as CImage), and its stride in bytes.
+using jpeg_allocator_t = std::function<uint8_t*(
+	unsigned int w, unsigned int h, unsigned int ch, size_t& step)>;
+
+// Rows per call to jpeg_{read,write}_scanlines()
+constexpr unsigned int JPEG_ROWS_PER_CALL = 16;
+
+#ifdef JCS_EXTENSIONS
+// libjpeg-turbo converts to/from BGR by itself, with SIMD code:
+constexpr bool JPEG_SWAP_RB = false;
+#else
+constexpr bool JPEG_SWAP_RB = true;
+#endif
 
-	makeSureImageIsLoaded();  // For delayed loaded images stored externally
+void swapRB(uint8_t* px, unsigned int n)
+{
+	for (unsigned int i = 0; i < n; i++, px += 3)
+		std::swap(px[0], px[2]);
+}
+
+void checkScaleDenominator(unsigned int scaleDenom)
+{
+	ASSERTMSG_(
+		scaleDenom == 1 || scaleDenom == 2 || scaleDenom == 4 ||
+			scaleDenom == 8,
+		"JPEG images can only be decoded at scales 1, 1/2, 1/4 or 1/8");
+}
 
+void libjpegEncode(
+	const uint8_t* px, size_t step, unsigned int w, unsigned int h,
+	unsigned int ch, int quality, CStream& out)
+{
 	struct jpeg_compress_struct cinfo;
 	struct jpeg_error_mgr jerr;
-
-	const auto& img = m_impl->img;
-
-	const unsigned int nCols = img.cols, nRows = img.rows;
-	const bool is_color = (img.channels() == 3);
-
-	// Some previous verification:
-	ASSERT_(nCols >= 1 && nRows >= 1);
-	ASSERT_(img.channels() == 1 || img.channels() == 3);
-
-	// 1) Initialization of the JPEG compresion object:
-	// --------------------------------------------------
 	cinfo.err = jpeg_std_error(&jerr);
 	jpeg_create_compress(&cinfo);
-
-	// 2) Set the destination of jpeg data:
-	// --------------------------------------------------
 	jpeg_stdio_dest(&cinfo, &out);
 
-	// 3) Set parameters for compression:
-	// --------------------------------------------------
-	cinfo.image_width = nCols;
-	cinfo.image_height = nRows;
-	cinfo.input_components = is_color ? 3 : 1;
-	cinfo.in_color_space = is_color ? JCS_RGB : JCS_GRAYSCALE;
-
+	cinfo.image_width = w;
+	cinfo.image_height = h;
+	cinfo.input_components = ch;
+#ifdef JCS_EXTENSIONS
+	cinfo.in_color_space = ch == 3 ? JCS_EXT_BGR : JCS_GRAYSCALE;
+#else
+	cinfo.in_color_space = ch == 3 ? JCS_RGB : JCS_GRAYSCALE;
+#endif
 	jpeg_set_defaults(&cinfo);
-	/* Make optional parameter settings here */
-	/* Now you can set any non-default parameters you wish to.
-	 * Here we just illustrate the use of quality (quantization table) scaling:
-	 */
 	jpeg_set_quality(
-		&cinfo, jpeg_quality /* quality per cent */,
+		&cinfo, quality /* quality per cent */,
 		TRUE /* limit to baseline-JPEG values */);
-
-	// 4) Start:
-	// --------------------------------------------------
 	jpeg_start_compress(&cinfo, TRUE);
 
-	// 5) Write scan lines:
-	// --------------------------------------------------
-	if (is_color)
+	const bool swap = JPEG_SWAP_RB && ch == 3;
+	std::vector<uint8_t> rgb(swap ? 3 * w : 0);
+	JSAMPROW rows[JPEG_ROWS_PER_CALL];
+	while (cinfo.next_scanline < h)
 	{
-		JSAMPROW row_pointer[1]; /* pointer to a single row */
-		row_pointer[0] = new uint8_t[img.step[0]];
-
-		for (unsigned int row = 0; row < nRows; row++)
+		const unsigned int y = cinfo.next_scanline;
+		const unsigned int n = swap ? 1 : std::min(JPEG_ROWS_PER_CALL, h - y);
+		for (unsigned int i = 0; i < n; i++)
+			rows[i] = const_cast<JSAMPROW>(px + (y + i) * step);
+		if (swap)
 		{
-			// Flip RGB bytes order!
-			const uint8_t* src = img.ptr<uint8_t>(row);
-			uint8_t* target = row_pointer[0];
-			for (unsigned int col = 0; col < nCols; col++)
-			{
-				target[0] = src[2];
-				target[1] = src[1];
-				target[2] = src[0];
-
-				target += 3;
-				src += 3;
-			}
-
-			if (1 != jpeg_write_scanlines(&cinfo, row_pointer, 1))
-			{ THROW_EXCEPTION("jpeg_write_scanlines: didn't work!!"); }
+			std::copy_n(rows[0], 3 * w, rgb.data());
+			swapRB(rgb.data(), w);
+			rows[0] = rgb.data();
 		}
+		if (jpeg_write_scanlines(&cinfo, rows, n) == 0)
+		{ THROW_EXCEPTION("jpeg_write_scanlines: didn't work!!"); }
+	}
+	jpeg_finish_compress(&cinfo);
+	jpeg_destroy_compress(&cinfo);
+}
 
-		delete[] row_pointer[0];
-	}  // end "color"
-	else
-	{  // Is grayscale:
-		JSAMPROW row_pointer[1]; /* pointer to a single row */
+// `cinfo` must have its source already set
+void libjpegDecode(
+	jpeg_decompress_struct& cinfo, unsigned int scaleDenom,
+	const jpeg_allocator_t& alloc)
+{
+	jpeg_read_header(&cinfo, TRUE);
 
-		for (unsigned int row = 0; row < nRows; row++)
-		{
-			row_pointer[0] = const_cast<JSAMPROW>(img.ptr<uint8_t>(row));
+	// Scaling is done in the DCT domain, so it is much faster than decoding
+	// the whole image:
+	cinfo.scale_num = 1;
+	cinfo.scale_denom = scaleDenom;
+	const bool gray = cinfo.num_components == 1;
+#ifdef JCS_EXTENSIONS
+	cinfo.out_color_space = gray ? JCS_GRAYSCALE : JCS_EXT_BGR;
+#else
+	cinfo.out_color_space = gray ? JCS_GRAYSCALE : JCS_RGB;
+#endif
+	jpeg_start_decompress(&cinfo);
 
-			// Gray scale:
-			if (1 != jpeg_write_scanlines(&cinfo, row_pointer, 1))
-			{ THROW_EXCEPTION("jpeg_write_scanlines: didn't work!!"); }
-		}
+	const unsigned int w = cinfo.output_width, h = cinfo.output_height;
+	size_t step = 0;
+	uint8_t* px = alloc(w, h, gray ? 1 : 3, step);
+
+	JSAMPROW rows[JPEG_ROWS_PER_CALL];
+	while (cinfo.output_scanline < h)
+	{
+		const unsigned int y = cinfo.output_scanline;
+		const unsigned int n = std::min(JPEG_ROWS_PER_CALL, h - y);
+		for (unsigned int i = 0; i < n; i++)
+			rows[i] = px + (y + i) * step;
+		const unsigned int nRead = jpeg_read_scanlines(&cinfo, rows, n);
+		if (nRead == 0)
+		{ THROW_EXCEPTION("jpeg_read_scanlines: didn't work!!"); }
+		if (JPEG_SWAP_RB && !gray)
+			for (unsigned int i = 0; i < nRead; i++)
+				swapRB(rows[i], w);
 	}
+	jpeg_finish_decompress(&cinfo);
+}
 
-	// 6) Compress and finish:
-	// --------------------------------------------------
-	jpeg_finish_compress(&cinfo);
-	jpeg_destroy_compress(&cinfo);
+#if MRPT_HAS_TURBOJPEG
+// TurboJPEG handles reused by each thread:
+struct TTurboJPEGHandle
+{
+	explicit TTurboJPEGHandle(bool compress)
+		: h(compress ? tjInitCompress() : tjInitDecompress())
+	{
+		if (!h) THROW_EXCEPTION_FMT("TurboJPEG error: %s", tjGetErrorStr());
+	}
+	~TTurboJPEGHandle() { tjDestroy(h); }
+	TTurboJPEGHandle(const TTurboJPEGHandle&) = delete;
+	TTurboJPEGHandle& operator=(const TTurboJPEGHandle&) = delete;
 
-	// DONE!
-	MRPT_END
+	tjhandle h;
+};
+
+void turbojpegEncode(
+	const uint8_t* px, size_t step, unsigned int w, unsigned int h,
+	unsigned int ch, int quality, CStream& out)
+{
+	thread_local TTurboJPEGHandle tj(true);
+
+	unsigned char* buf = nullptr;
+	unsigned long len = 0;
+	// Same chroma subsampling than libjpeg defaults:
+	if (0 != tjCompress2(
+				 tj.h, const_cast<unsigned char*>(px), static_cast<int>(w),
+				 static_cast<int>(step), static_cast<int>(h),
+				 ch == 3 ? TJPF_BGR : TJPF_GRAY, &buf, &len,
+				 ch == 3 ? TJSAMP_420 : TJSAMP_GRAY, quality, 0))
+	{
+		if (buf) tjFree(buf);
+		THROW_EXCEPTION_FMT("tjCompress2() error: %s", tjGetErrorStr());
+	}
+	out.Write(buf, len);
+	tjFree(buf);
+}
+
+void turbojpegDecode(
+	const uint8_t* data, size_t len, unsigned int scaleDenom,
+	const jpeg_allocator_t& alloc)
+{
+	thread_local TTurboJPEGHandle tj(false);
+
+	auto* jpegBuf = const_cast<unsigned char*>(data);
+	const auto jpegLen = static_cast<unsigned long>(len);
+	int w = 0, h = 0, subsamp = 0, colorspace = 0;
+	if (0 != tjDecompressHeader3(
+				 tj.h, jpegBuf, jpegLen, &w, &h, &subsamp, &colorspace))
+		THROW_EXCEPTION_FMT(
+			"tjDecompressHeader3() error: %s", tjGetErrorStr());
+
+	const bool gray = colorspace == TJCS_GRAY;
+	const tjscalingfactor sf = {1, static_cast<int>(scaleDenom)};
+	const int sw = TJSCALED(w, sf), sh = TJSCALED(h, sf);
+	size_t step = 0;
+	uint8_t* px = alloc(sw, sh, gray ? 1 : 3, step);
+	if (0 != tjDecompress2(
+				 tj.h, jpegBuf, jpegLen, px, sw, static_cast<int>(step), sh,
+				 gray ? TJPF_GRAY : TJPF_BGR, 0))
+		THROW_EXCEPTION_FMT("tjDecompress2() error: %s", tjGetErrorStr());
+}
+#endif
+
+void jpegEncode(
+	const uint8_t* px, size_t step, unsigned int w, unsigned int h,
+	unsigned int ch, int quality, CStream& out)
+{
+#if MRPT_HAS_TURBOJPEG
+	turbojpegEncode(px, step, w, h, ch, quality, out);
+#else
+	libjpegEncode(px, step, w, h, ch, quality, out);
 #endif
 }
 
-void CImage::loadFromStreamAsJPEG(CStream& in)
+void jpegDecodeMemory(
+	const uint8_t* data, size_t len, unsigned int scaleDenom,
+	const jpeg_allocator_t& alloc)
 {
-#if MRPT_HAS_OPENCV && MRPT_HAS_JPEG
-	MRPT_START
+	checkScaleDenominator(scaleDenom);
+#if MRPT_HAS_TURBOJPEG
+	turbojpegDecode(data, len, scaleDenom, alloc);
+#else
+	struct jpeg_decompress_struct cinfo;
+	struct jpeg_error_mgr jerr;
+	cinfo.err = jpeg_std_error(&jerr);
+	jpeg_create_decompress(&cinfo);
+#if JPEG_LIB_VERSION >= 80 || defined(MEM_SRCDST_SUPPORTED)
+	jpeg_mem_src(
+		&cinfo, const_cast<unsigned char*>(data),
+		static_cast<unsigned long>(len));
+	libjpegDecode(cinfo, scaleDenom, alloc);
+#else
+	mrpt::io::CMemoryStream in;
+	in.assignMemoryNotOwn(data, len);
+	jpeg_stdio_src(&cinfo, &in);
+	libjpegDecode(cinfo, scaleDenom, alloc);
+#endif
+	jpeg_destroy_decompress(&cinfo);
+#endif
+}
+
+void jpegDecodeStream(
+	CStream& in, unsigned int scaleDenom, const jpeg_allocator_t& alloc)
+{
+	checkScaleDenominator(scaleDenom);
 
 	// This could have been ported to cv::imdecode(). But on a second thought,
 	// it may be not be as easy: imdecode() assumes an input buffer of known
 	// size while here we do not know the size to read from the CStream in
 	// advance.
-
 	struct jpeg_decompress_struct cinfo;
 	struct jpeg_error_mgr jerr;
-
-	/* Step 1: allocate and initialize JPEG decompression object */
-
-	/* We set up the normal JPEG error routines, then override error_exit. */
 	cinfo.err = jpeg_std_error(&jerr);
-
-	/* Now we can initialize the JPEG decompression object. */
 	jpeg_create_decompress(&cinfo);
-
-	/* Step 2: specify data source (eg, a file) */
 	jpeg_stdio_src(&cinfo, &in);
+	libjpegDecode(cinfo, scaleDenom, alloc);
+	jpeg_destroy_decompress(&cinfo);
+}
+}  // namespace
+#endif	// MRPT_HAS_JPEG
 
-	/* Step 3: read file parameters with jpeg_read_header() */
-	jpeg_read_header(&cinfo, TRUE);
-
-	/* Step 4: set parameters for decompression */
-
-	/* Step 5: Start decompressor */
-	jpeg_start_decompress(&cinfo);
-
-	/* We may need to do some setup of our own at this point before reading
-	 * the data.  After jpeg_start_decompress() we have the correct scaled
-	 * output image dimensions available, as well as the output colormap
-	 * if we asked for color quantization.
-	 * In this example, we need to make an output work buffer of the right size.
-	 */
-	/* JSAMPLEs per row in output buffer */
-	/* physical row width in output buffer */
-	const int row_stride = cinfo.output_width * cinfo.output_components;
-	/* Make a one-row-high sample array that will go away when done with image
-	 */
-	/* Output row buffer */
-	JSAMPARRAY buffer = (*cinfo.mem->alloc_sarray)(
-		(j_common_ptr)&cinfo, JPOOL_IMAGE, row_stride, 1);
-
-	// Resize the CImage now:
-	this->resize(
-		cinfo.output_width, cinfo.output_height,
-		cinfo.out_color_components == 1 ? CH_GRAY : CH_RGB);
-	auto& img = m_impl->img;
+#if MRPT_HAS_OPENCV && MRPT_HAS_JPEG
+static jpeg_allocator_t imageAllocator(CImage& img, cv::Mat& m)
+{
+	return [&img, &m](
+			   unsigned int w, unsigned int h, unsigned int ch,
+			   size_t& step) {
+		img.resize(w, h, ch == 1 ? CH_GRAY : CH_RGB);
+		step = m.step[0];
+		return m.ptr<uint8_t>(0);
+	};
+}
+#endif
 
-	/* Step 6: while (scan lines remain to be read) */
-	/*           jpeg_read_scanlines(...); */
+void CImage::saveToStreamAsJPEG(CStream& out, const int jpeg_quality) const
+{
+#if MRPT_HAS_OPENCV && MRPT_HAS_JPEG
+	MRPT_START
 
-	/* Here we use the library's state variable cinfo.output_scanline as the
-	 * loop counter, so that we don't have to keep track ourselves.
-	 */
-	const unsigned int nCols = cinfo.output_width, nRows = cinfo.output_height;
+	makeSureImageIsLoaded();  // For delayed loaded images stored externally
 
-	for (unsigned int row = 0; row < nRows; row++)
-	{
-		/* jpeg_read_scanlines expects an array of pointers to scanlines.
-		 * Here the array is only one element long, but you could ask for
-		 * more than one scanline at a time if that's more convenient.
-		 */
-		jpeg_read_scanlines(&cinfo, buffer, 1);
-
-		/* Copy into the CImage object */
-		if (isColor())
-		{
-			// Flip RGB bytes order!
-			auto target = img.ptr<uint8_t>(row);
-			const auto* src = buffer[0];
-			for (unsigned int col = 0; col < nCols; col++)
-			{
-				target[0] = src[2];
-				target[1] = src[1];
-				target[2] = src[0];
-
-				target += 3;
-				src += 3;
-			}
-		}
-		else
-		{
-			// Gray scale:
-			std::memcpy(img.ptr<uint8_t>(row), buffer[0], row_stride);
-		}
-	}
+	const auto& img = m_impl->img;
 
-	/* Step 7: Finish decompression */
+	// Some previous verification:
+	ASSERT_(img.cols >= 1 && img.rows >= 1);
+	ASSERT_(img.channels() == 1 || img.channels() == 3);
+	ASSERT_(img.depth() == CV_8U);
 
-	jpeg_finish_decompress(&cinfo);
-	/* We can ignore the return value since suspension is not possible
-	 * with the stdio data source.
-	 */
+	jpegEncode(
+		img.ptr<uint8_t>(0), img.step[0], img.cols, img.rows, img.channels(),
+		jpeg_quality, out);
 
-	/* Step 8: Release JPEG decompression object */
+	MRPT_END
+#endif
+}
 
-	/* This is an important step since it will release a good deal of memory. */
-	jpeg_destroy_decompress(&cinfo);
+void CImage::loadFromStreamAsJPEG(CStream& in, unsigned int scaleDenominator)
+{
+#if MRPT_HAS_OPENCV && MRPT_HAS_JPEG
+	MRPT_START
+	jpegDecodeStream(in, scaleDenominator, imageAllocator(*this, m_impl->img));
+	MRPT_END
+#endif
+}
 
-	// DONE!
+void CImage::loadFromMemoryAsJPEG(
+	const uint8_t* data, size_t length, unsigned int scaleDenominator)
+{
+#if MRPT_HAS_OPENCV && MRPT_HAS_JPEG
+	MRPT_START
+	ASSERT_(data != nullptr && length > 0);
+	jpegDecodeMemory(
+		data, length, scaleDenominator, imageAllocator(*this, m_impl->img));
 	MRPT_END
+#else
+	THROW_EXCEPTION("MRPT built without OpenCV or libjpeg support");
 #endif
 }
@@ -0,0 +1,456 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "img-precomp.h"  // Precompiled headers
+//
+#include <mrpt/core/cpu.h>
+#include <mrpt/img/CImage.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+// Universal include for all versions of OpenCV
+#include <mrpt/3rdparty/do_opencv_includes.h>
+
+#include "CImage.SSEx.h"
+#include "CImage_impl.h"
+
+// Conversions of raw camera images (Bayer and 4:2:2 YUV) into CImage.
+// All kernels write directly into the (possibly reused) buffer of the output
+// image, without any intermediary full-size image.
+
+using namespace mrpt::img;
+
+#if MRPT_HAS_OPENCV
+namespace
+{
+enum : uint8_t
+{
+	CFA_R = 0,
+	CFA_G = 1,
+	CFA_B = 2
+};
+
+// Color of the 2x2 top-left pixels, row-major, for each TBayerPattern
+constexpr uint8_t cfaColors[4][4] = {
+	{CFA_R, CFA_G, CFA_G, CFA_B},  // RGGB
+	{CFA_B, CFA_G, CFA_G, CFA_R},  // BGGR
+	{CFA_G, CFA_R, CFA_B, CFA_G},  // GRBG
+	{CFA_G, CFA_B, CFA_R, CFA_G}  // GBRG
+};
+
+inline uint8_t clamp8(int v)
+{
+	return static_cast<uint8_t>(v < 0 ? 0 : (v > 255 ? 255 : v));
+}
+
+// Mirrored index (without repeating the border pixel), so neighbors out of
+// the image keep the parity, hence the color, of the pixels they replace.
+inline int mirror(int i, int n)
+{
+	return i < 0 ? -i : (i >= n ? 2 * n - 2 - i : i);
+}
+
+// Luminance weights (ITU-R BT.601), scaled by 256:
+constexpr int LUM_R = 77, LUM_G = 150, LUM_B = 29;
+
+// Writes one output pixel, either as BGR (the CImage channel order) or gray
+template <int NCH>
+inline void storePixel(uint8_t* out, int x, int r, int g, int b)
+{
+	if constexpr (NCH == 3)
+	{
+		out[3 * x + 0] = static_cast<uint8_t>(b);
+		out[3 * x + 1] = static_cast<uint8_t>(g);
+		out[3 * x + 2] = static_cast<uint8_t>(r);
+	}
+	else
+	{
+		out[x] = static_cast<uint8_t>(
+			(LUM_R * r + LUM_G * g + LUM_B * b + 128) >> 8);
+	}
+}
+
+template <int NCH>
+void demosaicBilinear(
+	const uint8_t* raw, int w, int h, size_t step, const uint8_t* cfa,
+	uint8_t* out, size_t outStep)
+{
+	for (int y = 0; y < h; y++)
+	{
+		const uint8_t* ru = raw + mirror(y - 1, h) * step;
+		const uint8_t* rc = raw + y * step;
+		const uint8_t* rd = raw + mirror(y + 1, h) * step;
+		uint8_t* o = out + y * outStep;
+
+		const uint8_t* rowCfa = cfa + 2 * (y & 1);
+		// Color of the horizontal neighbors of green pixels in this row:
+		const bool hNeighborsAreR =
+			(rowCfa[0] == CFA_G ? rowCfa[1] : rowCfa[0]) == CFA_R;
+
+		for (int x = 0; x < w; x++)
+		{
+			const int xl = x > 0 ? x - 1 : 1, xr = x + 1 < w ? x + 1 : w - 2;
+			const int v = rc[x];
+			const uint8_t c = rowCfa[x & 1];
+			if (c == CFA_G)
+			{
+				const int hAvg = (rc[xl] + rc[xr] + 1) >> 1;
+				const int vAvg = (ru[x] + rd[x] + 1) >> 1;
+				if (hNeighborsAreR) storePixel<NCH>(o, x, hAvg, v, vAvg);
+				else
+					storePixel<NCH>(o, x, vAvg, v, hAvg);
+			}
+			else
+			{
+				const int cross = (rc[xl] + rc[xr] + ru[x] + rd[x] + 2) >> 2;
+				const int diag = (ru[xl] + ru[xr] + rd[xl] + rd[xr] + 2) >> 2;
+				if (c == CFA_R) storePixel<NCH>(o, x, v, cross, diag);
+				else
+					storePixel<NCH>(o, x, diag, cross, v);
+			}
+		}
+	}
+}
+
+// Hamilton-Adams: green along the direction with the lowest gradient (with a
+// 2nd order correction from the center color), then red and blue from the
+// color differences to green of their neighbors.
+// The green plane is first stored in the output image (in the G channel, or
+// in the gray image itself), then completed row by row.
+template <int NCH>
+void demosaicEdgeAware(
+	const uint8_t* raw, int w, int h, size_t step, const uint8_t* cfa,
+	uint8_t* out, size_t outStep)
+{
+	// Offset and stride of green values in output rows:
+	constexpr int GO = NCH == 3 ? 1 : 0;
+	constexpr int GS = NCH;
+
+	// 1st pass: green plane
+	for (int y = 0; y < h; y++)
+	{
+		const uint8_t* ruu = raw + mirror(y - 2, h) * step;
+		const uint8_t* ru = raw + mirror(y - 1, h) * step;
+		const uint8_t* rc = raw + y * step;
+		const uint8_t* rd = raw + mirror(y + 1, h) * step;
+		const uint8_t* rdd = raw + mirror(y + 2, h) * step;
+		uint8_t* g = out + y * outStep + GO;
+		const uint8_t* rowCfa = cfa + 2 * (y & 1);
+
+		for (int x = 0; x < w; x++)
+		{
+			const int v = rc[x];
+			if (rowCfa[x & 1] == CFA_G)
+			{
+				g[GS * x] = static_cast<uint8_t>(v);
+				continue;
+			}
+			const int xl = mirror(x - 1, w), xr = mirror(x + 1, w);
+			const int xll = mirror(x - 2, w), xrr = mirror(x + 2, w);
+
+			const int lapH = 2 * v - rc[xll] - rc[xrr];
+			const int lapV = 2 * v - ruu[x] - rdd[x];
+			const int dH = std::abs(rc[xl] - rc[xr]) + std::abs(lapH);
+			const int dV = std::abs(ru[x] - rd[x]) + std::abs(lapV);
+			// Estimates, scaled by 4:
+			const int gH = 2 * (rc[xl] + rc[xr]) + lapH;
+			const int gV = 2 * (ru[x] + rd[x]) + lapV;
+			int g4;
+			if (dH < dV) g4 = 2 * gH;
+			else if (dV < dH)
+				g4 = 2 * gV;
+			else
+				g4 = gH + gV;
+			g[GS * x] = clamp8((g4 + 4) >> 3);
+		}
+	}
+
+	// 2nd pass: red and blue. For gray outputs, the green values of rows
+	// y-1 and y are kept aside before being overwritten by the luminance.
+	std::vector<uint8_t> gPrevBuf, gCurBuf;
+	if constexpr (NCH == 1)
+	{
+		gPrevBuf.resize(w);
+		gCurBuf.resize(w);
+	}
+
+	for (int y = 0; y < h; y++)
+	{
+		const uint8_t* ru = raw + mirror(y - 1, h) * step;
+		const uint8_t* rc = raw + y * step;
+		const uint8_t* rd = raw + mirror(y + 1, h) * step;
+		uint8_t* o = out + y * outStep;
+
+		const uint8_t *gu, *gc, *gd;
+		if constexpr (NCH == 3)
+		{
+			gu = out + mirror(y - 1, h) * outStep + GO;
+			gc = o + GO;
+			gd = out + mirror(y + 1, h) * outStep + GO;
+		}
+		else
+		{
+			std::swap(gPrevBuf, gCurBuf);
+			std::copy(o, o + w, gCurBuf.begin());
+			// Row y+1 is still untouched, row y-1 only in gPrevBuf:
+			gu = y > 0 ? gPrevBuf.data() : out + outStep;
+			gc = gCurBuf.data();
+			gd = y + 1 < h ? out + (y + 1) * outStep : gPrevBuf.data();
+		}
+
+		const uint8_t* rowCfa = cfa + 2 * (y & 1);
+		const bool hNeighborsAreR =
+			(rowCfa[0] == CFA_G ? rowCfa[1] : rowCfa[0]) == CFA_R;
+
+		for (int x = 0; x < w; x++)
+		{
+			const int xl = x > 0 ? x - 1 : 1, xr = x + 1 < w ? x + 1 : w - 2;
+			const int v = rc[x];
+			const int g = gc[GS * x];
+			const uint8_t c = rowCfa[x & 1];
+			if (c == CFA_G)
+			{
+				const int dH =
+					(rc[xl] - gc[GS * xl] + rc[xr] - gc[GS * xr] + 1) >> 1;
+				const int dV =
+					(ru[x] - gu[GS * x] + rd[x] - gd[GS * x] + 1) >> 1;
+				const int hVal = clamp8(g + dH), vVal = clamp8(g + dV);
+				if (hNeighborsAreR) storePixel<NCH>(o, x, hVal, g, vVal);
+				else
+					storePixel<NCH>(o, x, vVal, g, hVal);
+			}
+			else
+			{
+				const int dDiag = (ru[xl] - gu[GS * xl] + ru[xr] - gu[GS * xr] +
+								   rd[xl] - gd[GS * xl] + rd[xr] - gd[GS * xr] +
+								   2) >>
+					2;
+				const int other = clamp8(g + dDiag);
+				if (c == CFA_R) storePixel<NCH>(o, x, v, g, other);
+				else
+					storePixel<NCH>(o, x, other, g, v);
+			}
+		}
+	}
+}
+
+// One output pixel per 2x2 Bayer cell
+void demosaicHalfSizeRGB(
+	const uint8_t* raw, int w, int h, size_t step, const uint8_t* cfa,
+	uint8_t* out, size_t outStep)
+{
+	// Offsets of R, G1, G2, B within each cell, as (row, col):
+	int rOff = 0, bOff = 0, g1Off = -1, g2Off = 0;
+	for (int i = 0; i < 4; i++)
+	{
+		const int off = (i >> 1) * static_cast<int>(step) + (i & 1);
+		if (cfa[i] == CFA_R) rOff = off;
+		else if (cfa[i] == CFA_B)
+			bOff = off;
+		else if (g1Off < 0)
+			g1Off = off;
+		else
+			g2Off = off;
+	}
+	for (int y = 0; y + 1 < h; y += 2)
+	{
+		const uint8_t* r = raw + y * step;
+		uint8_t* o = out + (y / 2) * outStep;
+		for (int x = 0; x + 1 < w; x += 2, r += 2, o += 3)
+		{
+			o[0] = r[bOff];
+			o[1] = static_cast<uint8_t>((r[g1Off] + r[g2Off] + 1) >> 1);
+			o[2] = r[rOff];
+		}
+	}
+}
+
+void demosaicHalfSizeGray(
+	const uint8_t* raw, int w, int h, size_t step, const uint8_t* cfa,
+	uint8_t* out, size_t outStep)
+{
+	uint16_t weights[4];
+	for (int i = 0; i < 4; i++)
+		weights[i] = cfa[i] == CFA_R ? LUM_R
+									 : (cfa[i] == CFA_B ? LUM_B : LUM_G / 2);
+
+#if MRPT_ARCH_INTEL_COMPATIBLE
+	if (mrpt::cpu::supports(mrpt::cpu::feature::SSE2))
+	{
+		image_SSE2_bayer_half_gray_8u(raw, out, w, h, step, outStep, weights);
+		return;
+	}
+#endif
+
+	for (int y = 0; y + 1 < h; y += 2)
+	{
+		const uint8_t* r0 = raw + y * step;
+		const uint8_t* r1 = r0 + step;
+		uint8_t* o = out + (y / 2) * outStep;
+		for (int x = 0; x + 1 < w; x += 2)
+			*o++ = static_cast<uint8_t>(
+				(weights[0] * r0[x] + weights[1] * r0[x + 1] +
+				 weights[2] * r1[x] + weights[3] * r1[x + 1] + 128) >>
+				8);
+	}
+}
+
+// ITU-R BT.601, "video range" Y in [16,235], as used by cameras (and OpenCV
+// cvtColor() YUV422 conversions)
+void yuv422ToBGR(
+	const uint8_t* in, int w, int h, size_t step, bool uyvy, uint8_t* out,
+	size_t outStep)
+{
+	const int iY0 = uyvy ? 1 : 0, iU = uyvy ? 0 : 1, iY1 = uyvy ? 3 : 2,
+			  iV = uyvy ? 2 : 3;
+	for (int y = 0; y < h; y++)
+	{
+		const uint8_t* p = in + y * step;
+		uint8_t* o = out + y * outStep;
+		for (int x = 0; x + 1 < w; x += 2, p += 4, o += 6)
+		{
+			const int d = p[iU] - 128, e = p[iV] - 128;
+			const int cr = 409 * e + 128;
+			const int cg = -100 * d - 208 * e + 128;
+			const int cb = 516 * d + 128;
+
+			const int c0 = 298 * (p[iY0] - 16);
+			o[0] = clamp8((c0 + cb) >> 8);
+			o[1] = clamp8((c0 + cg) >> 8);
+			o[2] = clamp8((c0 + cr) >> 8);
+
+			const int c1 = 298 * (p[iY1] - 16);
+			o[3] = clamp8((c1 + cb) >> 8);
+			o[4] = clamp8((c1 + cg) >> 8);
+			o[5] = clamp8((c1 + cr) >> 8);
+		}
+	}
+}
+
+void yuv422ToGray(
+	const uint8_t* in, int w, int h, size_t step, bool uyvy, uint8_t* out,
+	size_t outStep)
+{
+#if MRPT_ARCH_INTEL_COMPATIBLE
+	if (mrpt::cpu::supports(mrpt::cpu::feature::SSE2))
+	{
+		image_SSE2_yuv422_to_gray_8u(in, out, w, h, step, outStep, uyvy);
+		return;
+	}
+#endif
+	const int iY = uyvy ? 1 : 0;
+	for (int y = 0; y < h; y++)
+	{
+		const uint8_t* p = in + y * step + iY;
+		uint8_t* o = out + y * outStep;
+		for (int x = 0; x < w; x++, p += 2)
+			o[x] = *p;
+	}
+}
+
+}  // namespace
+#endif
+
+void CImage::loadFromBayer(
+	const uint8_t* raw, unsigned int width, unsigned int height,
+	size_t rowStride, TBayerPattern pattern, TDemosaicMethod method,
+	TImageChannels outChannels)
+{
+	MRPT_START
+
+#if MRPT_HAS_OPENCV
+	ASSERT_(raw != nullptr);
+	ASSERTMSG_(
+		width >= 4 && height >= 4 && (width % 2) == 0 && (height % 2) == 0,
+		mrpt::format(
+			"Bayer images must have even sizes >=4, got %ux%u", width,
+			height));
+	ASSERT_GE_(rowStride, width);
+	ASSERT_LT_(static_cast<unsigned>(pattern), 4U);
+
+	const uint8_t* cfa = cfaColors[pattern];
+	const int w = static_cast<int>(width), h = static_cast<int>(height);
+	const bool gray = outChannels == CH_GRAY;
+
+	if (method == DEMOSAIC_HALF_SIZE)
+		resize(width / 2, height / 2, outChannels);
+	else
+		resize(width, height, outChannels);
+	m_imgIsExternalStorage = false;
+	m_externalFile.clear();
+
+	uint8_t* out = m_impl->img.data;
+	const size_t outStep = m_impl->img.step[0];
+
+	switch (method)
+	{
+		case DEMOSAIC_BILINEAR:
+			if (gray)
+				demosaicBilinear<1>(raw, w, h, rowStride, cfa, out, outStep);
+			else
+				demosaicBilinear<3>(raw, w, h, rowStride, cfa, out, outStep);
+			break;
+		case DEMOSAIC_EDGE_AWARE:
+			if (gray)
+				demosaicEdgeAware<1>(raw, w, h, rowStride, cfa, out, outStep);
+			else
+				demosaicEdgeAware<3>(raw, w, h, rowStride, cfa, out, outStep);
+			break;
+		case DEMOSAIC_HALF_SIZE:
+			if (gray)
+				demosaicHalfSizeGray(raw, w, h, rowStride, cfa, out, outStep);
+			else
+				demosaicHalfSizeRGB(raw, w, h, rowStride, cfa, out, outStep);
+			break;
+		default:
+			THROW_EXCEPTION("Unknown value for TDemosaicMethod");
+	};
+#else
+	THROW_EXCEPTION("Operation not supported: build MRPT against OpenCV!");
+#endif
+
+	MRPT_END
+}
+
+void CImage::loadFromYUV422(
+	const uint8_t* data, unsigned int width, unsigned int height,
+	size_t rowStride, TYUV422Layout layout, TImageChannels outChannels)
+{
+	MRPT_START
+
+#if MRPT_HAS_OPENCV
+	ASSERT_(data != nullptr);
+	ASSERTMSG_(
+		width > 0 && height > 0 && (width % 2) == 0,
+		mrpt::format(
+			"YUV422 images must have an even width, got %ux%u", width,
+			height));
+	ASSERT_GE_(rowStride, 2 * width);
+
+	resize(width, height, outChannels);
+	m_imgIsExternalStorage = false;
+	m_externalFile.clear();
+
+	uint8_t* out = m_impl->img.data;
+	const size_t outStep = m_impl->img.step[0];
+	const bool uyvy = layout == YUV422_UYVY;
+	const int w = static_cast<int>(width), h = static_cast<int>(height);
+
+	if (outChannels == CH_GRAY)
+		yuv422ToGray(data, w, h, rowStride, uyvy, out, outStep);
+	else
+		yuv422ToBGR(data, w, h, rowStride, uyvy, out, outStep);
+#else
+	THROW_EXCEPTION("Operation not supported: build MRPT against OpenCV!");
+#endif
+
+	MRPT_END
+}
@@ -528,6 +528,49 @@ TEST(CImage, LoadAndSave)
 	}
 }
 
+#if MRPT_HAS_JPEG
+TEST(CImage, JPEGStreamsAndScaledDecoding)
+{
+	using namespace mrpt::img;
+
+	CImage a;
+	ASSERT_TRUE(a.loadFromFile(tstImgFileColor));
+
+	mrpt::io::CMemoryStream buf;
+	a.saveToStreamAsJPEG(buf, 95);
+	ASSERT_GT(buf.getTotalBytesCount(), 0U);
+
+	CImage fromStream, fromMemory;
+	buf.Seek(0);
+	fromStream.loadFromStreamAsJPEG(buf);
+	fromMemory.loadFromMemoryAsJPEG(
+		reinterpret_cast<const uint8_t*>(buf.getRawBufferData()),
+		buf.getTotalBytesCount());
+	EXPECT_EQ(fromStream.getWidth(), a.getWidth());
+	EXPECT_EQ(fromStream.getHeight(), a.getHeight());
+	EXPECT_TRUE(fromStream.isColor());
+	EXPECT_EQ(
+		cv::norm(
+			fromStream.asCvMatRef(), fromMemory.asCvMatRef(), cv::NORM_INF),
+		0);
+	// Lossy, but channels must not be swapped:
+	EXPECT_LT(
+		cv::norm(fromStream.asCvMatRef(), a.asCvMatRef(), cv::NORM_L1) /
+			(a.getWidth() * a.getHeight() * 3),
+		4.0);
+
+	for (unsigned int d : {2U, 4U, 8U})
+	{
+		CImage scaled;
+		scaled.loadFromMemoryAsJPEG(
+			reinterpret_cast<const uint8_t*>(buf.getRawBufferData()),
+			buf.getTotalBytesCount(), d);
+		EXPECT_EQ(scaled.getWidth(), (a.getWidth() + d - 1) / d);
+		EXPECT_EQ(scaled.getHeight(), (a.getHeight() + d - 1) / d);
+	}
+}
+#endif
+
 TEST(CImage, DifferentAccessMethodsColor)
 {
 	using namespace mrpt::img;
@@ -579,4 +622,99 @@ TEST(CImage, DifferentAccessMethodsGray)
 	}
 }
 
+TEST(CImage, LoadFromBayer)
+{
+	using namespace mrpt::img;
+
+	// A uniform color (R,G,B)=(200,100,50) seen through each Bayer pattern:
+	const unsigned int w = 40, h = 20, stride = 48;
+	const uint8_t rgb[3] = {200, 100, 50};
+	// Colors of the top-left 2x2 pixels for each pattern (0=R,1=G,2=B):
+	const int cfa[4][4] = {
+		{0, 1, 1, 2}, {2, 1, 1, 0}, {1, 0, 2, 1}, {1, 2, 0, 1}};
+	const uint8_t gray = (77 * 200 + 150 * 100 + 29 * 50 + 128) >> 8;
+
+	for (int pat = 0; pat < 4; pat++)
+	{
+		std::vector<uint8_t> raw(stride * h);
+		for (unsigned int y = 0; y < h; y++)
+			for (unsigned int x = 0; x < w; x++)
+				raw[y * stride + x] = rgb[cfa[pat][(y % 2) * 2 + (x % 2)]];
+
+		for (const auto method :
+			 {DEMOSAIC_BILINEAR, DEMOSAIC_EDGE_AWARE, DEMOSAIC_HALF_SIZE})
+		{
+			const unsigned int ow = method == DEMOSAIC_HALF_SIZE ? w / 2 : w;
+			const unsigned int oh = method == DEMOSAIC_HALF_SIZE ? h / 2 : h;
+
+			CImage im;
+			im.loadFromBayer(
+				raw.data(), w, h, stride, static_cast<TBayerPattern>(pat),
+				method, CH_RGB);
+			ASSERT_EQ(im.getWidth(), ow);
+			ASSERT_EQ(im.getHeight(), oh);
+			ASSERT_TRUE(im.isColor());
+			for (unsigned int y = 0; y < oh; y++)
+				for (unsigned int x = 0; x < ow; x++)
+				{
+					// BGR channel order:
+					EXPECT_EQ(im.at<uint8_t>(x, y, 0), rgb[2]);
+					EXPECT_EQ(im.at<uint8_t>(x, y, 1), rgb[1]);
+					EXPECT_EQ(im.at<uint8_t>(x, y, 2), rgb[0]);
+				}
+
+			im.loadFromBayer(
+				raw.data(), w, h, stride, static_cast<TBayerPattern>(pat),
+				method, CH_GRAY);
+			ASSERT_EQ(im.getWidth(), ow);
+			ASSERT_FALSE(im.isColor());
+			for (unsigned int y = 0; y < oh; y++)
+				for (unsigned int x = 0; x < ow; x++)
+					EXPECT_NEAR(im.at<uint8_t>(x, y), gray, 1);
+		}
+	}
+}
+
+TEST(CImage, LoadFromYUV422)
+{
+	using namespace mrpt::img;
+
+	// 4x2 pixels: black, white, and a pure (saturated) red
+	const uint8_t yuyv[2][8] = {
+		{16, 128, 235, 128, 16, 128, 235, 128},
+		{82, 90, 82, 240, 82, 90, 82, 240}};
+	std::vector<uint8_t> buf(2 * 8), bufUYVY(2 * 8);
+	for (int r = 0; r < 2; r++)
+		for (int i = 0; i < 8; i += 2)
+		{
+			buf[r * 8 + i] = yuyv[r][i];
+			buf[r * 8 + i + 1] = yuyv[r][i + 1];
+			bufUYVY[r * 8 + i] = yuyv[r][i + 1];
+			bufUYVY[r * 8 + i + 1] = yuyv[r][i];
+		}
+
+	for (const auto layout : {YUV422_YUYV, YUV422_UYVY})
+	{
+		const auto& data = layout == YUV422_YUYV ? buf : bufUYVY;
+		CImage im;
+		im.loadFromYUV422(data.data(), 4, 2, 8, layout, CH_RGB);
+		ASSERT_EQ(im.getWidth(), 4U);
+		ASSERT_EQ(im.getHeight(), 2U);
+		for (int c = 0; c < 3; c++)
+		{
+			EXPECT_EQ(im.at<uint8_t>(0, 0, c), 0);
+			EXPECT_EQ(im.at<uint8_t>(1, 0, c), 255);
+		}
+		EXPECT_NEAR(im.at<uint8_t>(0, 1, 2), 255, 2);	// R
+		EXPECT_NEAR(im.at<uint8_t>(0, 1, 1), 0, 2);	// G
+		EXPECT_NEAR(im.at<uint8_t>(0, 1, 0), 0, 2);	// B
+
+		im.loadFromYUV422(data.data(), 4, 2, 8, layout, CH_GRAY);
+		ASSERT_FALSE(im.isColor());
+		EXPECT_EQ(im.at<uint8_t>(0, 0), 16);
+		EXPECT_EQ(im.at<uint8_t>(1, 0), 235);
+		EXPECT_EQ(im.at<uint8_t>(3, 1), 82);
+	}
+}
+
 #endif	// MRPT_HAS_OPENCV
@@ -17,6 +17,8 @@ namespace mrpt::io
 /** Transparently opens a compressed "gz" file and reads uncompressed data from
  * it.
  *   If the file is not a .gz file, it silently reads data from the file.
+ *   Zstandard compressed files (see CFileZstdOutputStream) are detected by
+ * their magic number and transparently decompressed too (New in MRPT 2.4.9).
  *  This class requires compiling MRPT with wxWidgets. If wxWidgets is not
  * available then the class is actually mapped to the standard CFileInputStream
  *
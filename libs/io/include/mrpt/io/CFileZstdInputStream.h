@@ -0,0 +1,100 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/core/optional_ref.h>
+#include <mrpt/core/pimpl.h>
+#include <mrpt/io/CStream.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace mrpt::io
+{
+/** Opens a Zstandard compressed file ("file.zst") and reads uncompressed data
+ * from it. Concatenated zstd frames (e.g. from appending) are read in
+ * sequence.
+ *
+ * Normally there is no need to use this class directly: CFileGZInputStream
+ * detects zstd files by their magic number and uses this class internally.
+ *
+ * This class requires compiling MRPT against libzstd (`MRPT_HAS_ZSTD`);
+ * otherwise, open() always fails.
+ *
+ * \sa CFileZstdOutputStream, CFileGZInputStream
+ * \ingroup mrpt_io_grp
+ * \note (New in MRPT 2.4.9)
+ */
+class CFileZstdInputStream : public CStream
+{
+   private:
+	struct Impl;
+	mrpt::pimpl<Impl> m_f;
+	/** Compressed file size */
+	uint64_t m_file_size{0};
+
+   public:
+	/** Constructor without open */
+	CFileZstdInputStream();
+
+	/** Constructor and open
+	 * \param fileName The file to be open in this stream
+	 * \exception std::exception If there's an error opening the file.
+	 */
+	CFileZstdInputStream(const std::string& fileName);
+
+	CFileZstdInputStream(const CFileZstdInputStream&) = delete;
+	CFileZstdInputStream& operator=(const CFileZstdInputStream&) = delete;
+
+	/** Dtor */
+	~CFileZstdInputStream() override;
+
+	std::string getStreamDescription() const override;
+
+	/** Returns true if the file exists and starts with the zstd frame magic
+	 * number. */
+	static bool isZstdFile(const std::string& fileName);
+
+	/** Sets the dictionary the file was compressed with. Must be called before
+	 * open(). An empty vector disables the dictionary.
+	 * \sa CFileZstdOutputStream::setDictionary()
+	 */
+	void setDictionary(const std::vector<uint8_t>& dict);
+
+	/** Opens the file for read.
+	 * \param fileName The file to be open in this stream
+	 * \return false if there's an error opening the file, true otherwise
+	 */
+	bool open(
+		const std::string& fileName,
+		mrpt::optional_ref<std::string> error_msg = std::nullopt);
+	/** Closes the file */
+	void close();
+	/** Returns true if the file was open without errors. */
+	bool fileOpenCorrectly() const;
+	/** Returns true if the file was open without errors. */
+	bool is_open() { return fileOpenCorrectly(); }
+	/** Will be true if EOF has been already reached. */
+	bool checkEOF();
+	/** Returns the path of the filename passed to open(), or empty if none. */
+	std::string filePathAtUse() const;
+
+	/** Method for getting the total number of <b>compressed</b> bytes of in the
+	 * file (the physical size of the compressed file). */
+	uint64_t getTotalBytesCount() const override;
+	/** Method for getting the current cursor position in the <b>compressed</b>
+	 * file, where 0 is the first byte and TotalBytesCount-1 the last one. */
+	uint64_t getPosition() const override;
+
+	/** This method is not implemented in this class */
+	uint64_t Seek(int64_t, CStream::TSeekOrigin = sFromBeginning) override;
+	size_t Read(void* Buffer, size_t Count) override;
+	size_t Write(const void* Buffer, size_t Count) override;
+};	// End of class def.
+}  // namespace mrpt::io
@@ -0,0 +1,119 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/core/optional_ref.h>
+#include <mrpt/core/pimpl.h>
+#include <mrpt/io/CStream.h>
+#include <mrpt/io/open_flags.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace mrpt::io
+{
+/** Saves data to a file and transparently compress the data using the
+ * Zstandard algorithm ("file.zst").
+ *
+ * Compared to gzip, zstd decompresses several times faster for similar
+ * compression ratios, and it can optionally use several worker threads to
+ * compress (see setNumThreads()) and a pre-trained dictionary (see
+ * setDictionary()), which helps with many small, similar sensor payloads.
+ *
+ * Files written by this class are transparently read by CFileGZInputStream,
+ * hence by all rawlog loading code.
+ *
+ * This class requires compiling MRPT against libzstd (`MRPT_HAS_ZSTD`);
+ * otherwise, open() always fails.
+ *
+ * \sa CFileZstdInputStream, CFileGZOutputStream
+ * \ingroup mrpt_io_grp
+ * \note (New in MRPT 2.4.9)
+ */
+class CFileZstdOutputStream : public CStream
+{
+   private:
+	struct Impl;
+	mrpt::pimpl<Impl> m_f;
+
+   public:
+	/** Constructor: opens an output file with the given compression level
+	 * (Default=3, the zstd library default).
+	 *
+	 * \param fileName The file to be open in this stream
+	 * \param mode If set to APPEND, a new zstd frame is appended to the end of
+	 * the file. Otherwise, previous contents will be lost.
+	 * \exception std::exception if the file cannot be opened.
+	 */
+	CFileZstdOutputStream(
+		const std::string& fileName, const OpenMode mode = OpenMode::TRUNCATE,
+		int compressionLevel = 3);
+
+	/** Constructor, without opening the file.
+	 * \sa open
+	 */
+	CFileZstdOutputStream();
+
+	CFileZstdOutputStream(const CFileZstdOutputStream&) = delete;
+	CFileZstdOutputStream& operator=(const CFileZstdOutputStream&) = delete;
+
+	/** Destructor */
+	~CFileZstdOutputStream() override;
+
+	std::string getStreamDescription() const override;
+
+	/** Sets the number of worker threads used to compress (Default=0: all
+	 * work done in the caller thread). Must be called before open().
+	 * It is silently ignored if libzstd was built without multithreading.
+	 */
+	void setNumThreads(unsigned int numThreads);
+
+	/** Sets a dictionary (e.g. trained with `zstd --train`) to compress with.
+	 * Must be called before open(). The same dictionary must be passed to
+	 * CFileZstdInputStream::setDictionary() to read the file back.
+	 * An empty vector disables the dictionary.
+	 */
+	void setDictionary(const std::vector<uint8_t>& dict);
+
+	/** Open a file for write, choosing the compression level
+	 * \param fileName The file to be open in this stream
+	 * \param compress_level 1:fastest, 19:best (negative values are even
+	 * faster levels)
+	 * \return true on success, false on any error.
+	 */
+	bool open(
+		const std::string& fileName, int compress_level = 3,
+		mrpt::optional_ref<std::string> error_msg = std::nullopt,
+		const OpenMode mode = OpenMode::TRUNCATE);
+
+	/** Flushes all pending data and closes the file */
+	void close();
+	/** Returns true if the file was open without errors. */
+	bool fileOpenCorrectly() const;
+	/** Returns true if the file was open without errors. */
+	bool is_open() { return fileOpenCorrectly(); }
+	/** Method for getting the current cursor position in the
+	 * <b>uncompressed</b> stream, where 0 is the first byte. */
+	uint64_t getPosition() const override;
+
+	/** Returns the path of the filename passed to open(), or empty if none. */
+	std::string filePathAtUse() const;
+
+	/** This method is not implemented in this class */
+	uint64_t Seek(int64_t, CStream::TSeekOrigin = sFromBeginning) override;
+	/** This method is not implemented in this class */
+	uint64_t getTotalBytesCount() const override;
+	size_t Read(void* Buffer, size_t Count) override;
+	size_t Write(const void* Buffer, size_t Count) override;
+};	// End of class def.
+static_assert(
+	!std::is_copy_constructible_v<CFileZstdOutputStream> &&
+		!std::is_copy_assignable_v<CFileZstdOutputStream>,
+	"Copy Check");
+}  // namespace mrpt::io
@@ -0,0 +1,69 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace mrpt::io
+{
+/** Read-only, memory-mapped view of a whole file. Pages are loaded by the OS
+ * upon first access, so large files can be parsed in place, even from several
+ * threads, without reading them into intermediary buffers.
+ *
+ * \code
+ * mrpt::io::CMemoryMappedFile f("groundtruth.txt");
+ * mrpt::system::for_each_line(f.text(), [](std::string_view line) {...});
+ * \endcode
+ *
+ * If memory mapping is not available (e.g. emscripten), open() reads the
+ * whole file into memory instead.
+ *
+ * \sa mrpt::system::for_each_line(), mrpt::system::split_text_into_chunks()
+ * \note (New in MRPT 2.4.9)
+ * \ingroup mrpt_io_grp
+ */
+class CMemoryMappedFile
+{
+   public:
+	CMemoryMappedFile();
+	/** Calls open() */
+	explicit CMemoryMappedFile(const std::string& fileName);
+	~CMemoryMappedFile();
+
+	CMemoryMappedFile(const CMemoryMappedFile&) = delete;
+	CMemoryMappedFile& operator=(const CMemoryMappedFile&) = delete;
+
+	/** Maps a file. Empty files are valid and have no data.
+	 * \exception std::exception If the file cannot be opened or mapped. */
+	void open(const std::string& fileName);
+	bool isOpen() const;
+	void close();
+
+	/** File contents, valid until close(). nullptr for empty files. */
+	const uint8_t* data() const;
+	/** File size (bytes) */
+	uint64_t size() const;
+	bool empty() const { return size() == 0; }
+
+	/** The file contents as text, valid until close() */
+	std::string_view text() const
+	{
+		return {reinterpret_cast<const char*>(data()),
+				static_cast<size_t>(size())};
+	}
+
+   private:
+	struct Impl;
+	std::unique_ptr<Impl> m_impl;
+};
+
+}  // namespace mrpt::io
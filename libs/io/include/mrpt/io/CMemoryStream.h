@@ -11,6 +11,8 @@
 #include <mrpt/core/safe_pointers.h>
 #include <mrpt/io/CStream.h>
 
+#include <memory>
+
 namespace mrpt
 {
 namespace io
@@ -98,8 +100,9 @@ namespace internal
 {
 struct TFreeFnDataForZMQ
 {
-	CMemoryStream* buf{nullptr};
-	bool do_free{true};
+	/** Shared by all the message parts of one buffer, which is freed when the
+	 * last of them is disposed of by ZMQ. */
+	std::shared_ptr<CMemoryStream> buf;
 	TFreeFnDataForZMQ() = default;
 };
 /** Used in mrpt_send_to_zmq(). `hint` points to a `TFreeFnDataForZMQ` struct,
@@ -12,14 +12,21 @@
 #include <iosfwd>
 #include <memory>
 #include <string>
+#include <string_view>
 
 namespace mrpt::io
 {
+class CMemoryMappedFile;
+
 /** A class for parsing text files, returning each non-empty and non-comment
  * line, along its line number. Lines are strip out of leading and trailing
  * whitespaces. By default, lines starting with either "#", "//" or "%" are
  * skipped as comment lines, unless this behavior is explicitly disabled with
  * \a enableCommentFilters.
+ *
+ * Files opened by name are memory-mapped (see CMemoryMappedFile) and parsed
+ * in place; getNextLine(std::string_view&) returns their lines without any
+ * copy.
  * \ingroup mrpt_io_grp
  */
 class CTextFileLinesParser
@@ -66,6 +73,14 @@ class CTextFileLinesParser
 	 */
 	bool getNextLine(std::istringstream& buf);
 
+	/** Returns the next (non-comment) line, without copying it if the parser
+	 * was opened with a file name. The view is valid until the next call to
+	 * getNextLine() or close().
+	 * \return false on EOF.
+	 * \note (New in MRPT 2.4.9)
+	 */
+	bool getNextLine(std::string_view& out_str);
+
 	/** Return the line number of the last line returned with \a getNextLine */
 	size_t getCurrentLineNumber() const;
 
@@ -80,10 +95,16 @@ class CTextFileLinesParser
 	/** Points to either a user-owned object, or to m_my_in */
 	std::istream* m_in{nullptr};
 	std::shared_ptr<std::istream> m_my_in;
+	/** Files opened by name, and their text still to be parsed */
+	std::shared_ptr<CMemoryMappedFile> m_mapped;
+	std::string_view m_pending;
+	/** Last line read from m_in */
+	std::string m_line;
 	size_t m_curLineNum{0};
 	bool m_filter_MATLAB_comments{true};
 	bool m_filter_C_comments{true};
 	bool m_filter_SH_comments{true};
 
+	bool isComment(std::string_view lin) const;
 };	// end of CTextFileLinesParser
 }  // namespace mrpt::io
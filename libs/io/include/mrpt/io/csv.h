@@ -8,10 +8,11 @@
    +------------------------------------------------------------------------+ */
 #pragma once
 
-#include <fstream>
-#include <iosfwd>
-#include <sstream>
+#include <mrpt/io/CMemoryMappedFile.h>
+#include <mrpt/system/text_parsing.h>
+
 #include <string>
+#include <type_traits>
 #include <vector>
 
 namespace mrpt::io
@@ -21,40 +22,50 @@ namespace mrpt::io
  * @{ */
 
 /** Loads a matrix from a CSV text file.
- * Empty lines or those with a trailing `#` are ignored.
+ * Empty lines or those with a trailing `#` are ignored. Cells which are not
+ * a number are loaded as 0.
  * Requires including the `<Eigen/Dense>` header in the user translation unit.
  *
+ * The file is memory-mapped and parsed in place, with
+ * mrpt::system::parse_number().
+ *
  * \tparam MATRIX Can be any Eigen matrix or mrpt::math matrices.
+ * \exception std::exception If the file cannot be opened.
  *
  * \note Based on: https://stackoverflow.com/a/39146048/1631514
  */
 template <typename MATRIX>
 void load_csv(const std::string& path, MATRIX& M)
 {
-	std::ifstream indata;
-	indata.open(path);
-	std::string line;
-	std::vector<typename MATRIX::Scalar> values;
-	uint rows = 0;
-	while (std::getline(indata, line))
-	{
-		if (!line.empty() && line[0] == '#') continue;
-		std::stringstream lineStream(line);
-		std::string cell;
-		while (std::getline(lineStream, cell, ','))
+	using Scalar = typename MATRIX::Scalar;
+	using parse_t =
+		std::conditional_t<std::is_same_v<Scalar, float>, float, double>;
+
+	const CMemoryMappedFile f(path);
+	std::vector<Scalar> values;
+	size_t rows = 0;
+	mrpt::system::for_each_line(f.text(), [&](std::string_view line) {
+		if (line.empty() || line[0] == '#') return true;
+		for (;;)
 		{
-			std::stringstream cs(cell);
-			typename MATRIX::Scalar val;
-			cs >> val;
-			values.push_back(val);
+			const size_t comma = line.find(',');
+			const std::string_view cell =
+				mrpt::system::trim_view(line.substr(0, comma));
+			parse_t val = 0;
+			mrpt::system::parse_number(
+				cell.data(), cell.data() + cell.size(), val);
+			values.push_back(static_cast<Scalar>(val));
+			if (comma == std::string_view::npos) break;
+			line.remove_prefix(comma + 1);
 		}
 		++rows;
-	}
+		return true;
+	});
 	// Convert from RowMajor if needed!
 	M = Eigen::Map<const Eigen::Matrix<
 		typename MATRIX::Scalar, MATRIX::RowsAtCompileTime,
 		MATRIX::ColsAtCompileTime, Eigen::RowMajor>>(
-		values.data(), rows, values.size() / rows);
+		values.data(), rows, rows ? values.size() / rows : 0);
 }
 
 /** @} */
@@ -11,10 +11,12 @@
 //
 #include <mrpt/core/exceptions.h>
 #include <mrpt/io/CFileGZInputStream.h>
+#include <mrpt/io/CFileZstdInputStream.h>
 #include <mrpt/system/filesystem.h>
 
 #include <cerrno>
 #include <cstring>	// strerror
+#include <memory>
 #include <type_traits>
 //
 #include <mrpt/config.h>
@@ -36,6 +38,8 @@ struct CFileGZInputStream::Impl
 {
 	gzFile f = nullptr;
 	std::string filename;
+	/** Used instead of `f` for Zstandard compressed files */
+	std::shared_ptr<CFileZstdInputStream> zstd;
 };
 
 CFileGZInputStream::CFileGZInputStream()
@@ -56,7 +60,21 @@ bool CFileGZInputStream::open(
 {
 	MRPT_START
 
-	if (m_f->f) gzclose(m_f->f);
+	close();
+
+	// Zstandard files are detected by their magic number:
+	if (CFileZstdInputStream::isZstdFile(fileName))
+	{
+		m_f->zstd = std::make_shared<CFileZstdInputStream>();
+		if (!m_f->zstd->open(fileName, error_msg))
+		{
+			m_f->zstd.reset();
+			return false;
+		}
+		m_file_size = m_f->zstd->getTotalBytesCount();
+		m_f->filename = fileName;
+		return true;
+	}
 
 	// Get compressed file size:
 	m_file_size = mrpt::system::getFileSize(fileName);
@@ -81,6 +99,11 @@ bool CFileGZInputStream::open(
 
 void CFileGZInputStream::close()
 {
+	if (m_f->zstd)
+	{
+		m_f->zstd.reset();
+		m_f->filename.clear();
+	}
 	if (m_f->f)
 	{
 		gzclose(m_f->f);
@@ -92,6 +115,7 @@ void CFileGZInputStream::close()
 CFileGZInputStream::~CFileGZInputStream() { close(); }
 size_t CFileGZInputStream::Read(void* Buffer, size_t Count)
 {
+	if (m_f->zstd) return m_f->zstd->Read(Buffer, Count);
 	if (!m_f->f) { THROW_EXCEPTION("File is not open."); }
 
 	return gzread(m_f->f, Buffer, Count);
@@ -105,19 +129,25 @@ size_t CFileGZInputStream::Write(
 
 uint64_t CFileGZInputStream::getTotalBytesCount() const
 {
+	if (m_f->zstd) return m_file_size;
 	if (!m_f->f) { THROW_EXCEPTION("File is not open."); }
 	return m_file_size;
 }
 
 uint64_t CFileGZInputStream::getPosition() const
 {
+	if (m_f->zstd) return m_f->zstd->getPosition();
 	if (!m_f->f) { THROW_EXCEPTION("File is not open."); }
 	return gztell(m_f->f);
 }
 
-bool CFileGZInputStream::fileOpenCorrectly() const { return m_f->f != nullptr; }
+bool CFileGZInputStream::fileOpenCorrectly() const
+{
+	return m_f->f != nullptr || m_f->zstd;
+}
 bool CFileGZInputStream::checkEOF()
 {
+	if (m_f->zstd) return m_f->zstd->checkEOF();
 	if (!m_f->f) return true;
 	else
 		return 0 != gzeof(m_f->f);
@@ -131,7 +161,8 @@ uint64_t CFileGZInputStream::Seek(int64_t, CStream::TSeekOrigin)
 std::string CFileGZInputStream::getStreamDescription() const
 {
 	return mrpt::format(
-		"mrpt::io::CFileGZInputStream for file '%s'", m_f->filename.c_str());
+		"mrpt::io::CFileGZInputStream for file '%s'%s", m_f->filename.c_str(),
+		m_f->zstd ? " (zstd)" : "");
 }
 
 std::string CFileGZInputStream::filePathAtUse() const
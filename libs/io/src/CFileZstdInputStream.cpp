@@ -0,0 +1,260 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "io-precomp.h"	 // Precompiled headers
+//
+#include <mrpt/core/exceptions.h>
+#include <mrpt/io/CFileZstdInputStream.h>
+#include <mrpt/system/filesystem.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>	// strerror
+#include <type_traits>
+//
+#include <mrpt/config.h>
+#if MRPT_HAS_ZSTD
+#include <zstd.h>
+#endif
+
+using namespace mrpt::io;
+using namespace std;
+
+static_assert(
+	!std::is_copy_constructible_v<CFileZstdInputStream> &&
+		!std::is_copy_assignable_v<CFileZstdInputStream>,
+	"Copy Check");
+
+struct CFileZstdInputStream::Impl
+{
+	FILE* f = nullptr;
+	std::string filename;
+#if MRPT_HAS_ZSTD
+	ZSTD_DCtx* dctx = nullptr;
+	ZSTD_inBuffer in = {nullptr, 0, 0};
+#endif
+	std::vector<uint8_t> inBuf;
+	std::vector<uint8_t> dict;
+	/** Compressed bytes read from the file so far */
+	uint64_t fileBytesRead = 0;
+	/** Last return value of ZSTD_decompressStream(): 0 at frame ends */
+	size_t lastRet = 0;
+	bool fileEOF = false;
+	/** Set when no more output can be decompressed */
+	bool drained = false;
+};
+
+CFileZstdInputStream::CFileZstdInputStream()
+	: m_f(mrpt::make_impl<CFileZstdInputStream::Impl>())
+{
+}
+
+CFileZstdInputStream::CFileZstdInputStream(const string& fileName)
+	: CFileZstdInputStream()
+{
+	MRPT_START
+	std::string err_msg;
+	if (!open(fileName, err_msg))
+		THROW_EXCEPTION_FMT(
+			"Error trying to open file: '%s', error: '%s'", fileName.c_str(),
+			err_msg.c_str());
+	MRPT_END
+}
+
+bool CFileZstdInputStream::isZstdFile(const std::string& fileName)
+{
+	// Little-endian 0xFD2FB528
+	const uint8_t magic[4] = {0x28, 0xb5, 0x2f, 0xfd};
+
+	FILE* f = fopen(fileName.c_str(), "rb");
+	if (!f) return false;
+	uint8_t buf[4];
+	const bool ok =
+		fread(buf, 1, sizeof(buf), f) == sizeof(buf) &&
+		0 == memcmp(buf, magic, sizeof(magic));
+	fclose(f);
+	return ok;
+}
+
+void CFileZstdInputStream::setDictionary(const std::vector<uint8_t>& dict)
+{
+	m_f->dict = dict;
+}
+
+bool CFileZstdInputStream::open(
+	const std::string& fileName, mrpt::optional_ref<std::string> error_msg)
+{
+	MRPT_START
+
+	close();
+
+#if MRPT_HAS_ZSTD
+	// Get compressed file size:
+	m_file_size = mrpt::system::getFileSize(fileName);
+	if (m_file_size == uint64_t(-1))
+	{
+		if (error_msg)
+			error_msg.value().get() =
+				mrpt::format("Couldn't access the file '%s'", fileName.c_str());
+		return false;
+	}
+
+	m_f->f = fopen(fileName.c_str(), "rb");
+	if (m_f->f == nullptr)
+	{
+		if (error_msg) error_msg.value().get() = std::string(strerror(errno));
+		return false;
+	}
+
+	m_f->dctx = ZSTD_createDCtx();
+	ASSERT_(m_f->dctx != nullptr);
+	if (!m_f->dict.empty())
+	{
+		const size_t ret = ZSTD_DCtx_loadDictionary(
+			m_f->dctx, m_f->dict.data(), m_f->dict.size());
+		if (ZSTD_isError(ret))
+		{
+			if (error_msg)
+				error_msg.value().get() = std::string(ZSTD_getErrorName(ret));
+			close();
+			return false;
+		}
+	}
+
+	m_f->inBuf.resize(ZSTD_DStreamInSize());
+	m_f->in = {m_f->inBuf.data(), 0, 0};
+	m_f->fileBytesRead = 0;
+	m_f->lastRet = 0;
+	m_f->fileEOF = false;
+	m_f->drained = false;
+	m_f->filename = fileName;
+	return true;
+#else
+	(void)fileName;
+	if (error_msg)
+		error_msg.value().get() =
+			"MRPT was built without Zstandard (libzstd) support";
+	return false;
+#endif
+
+	MRPT_END
+}
+
+void CFileZstdInputStream::close()
+{
+#if MRPT_HAS_ZSTD
+	if (m_f->dctx)
+	{
+		ZSTD_freeDCtx(m_f->dctx);
+		m_f->dctx = nullptr;
+	}
+#endif
+	if (m_f->f)
+	{
+		fclose(m_f->f);
+		m_f->f = nullptr;
+		m_f->filename.clear();
+	}
+}
+
+CFileZstdInputStream::~CFileZstdInputStream() { close(); }
+size_t CFileZstdInputStream::Read(void* Buffer, size_t Count)
+{
+	if (!m_f->f) { THROW_EXCEPTION("File is not open."); }
+
+#if MRPT_HAS_ZSTD
+	auto& in = m_f->in;
+	ZSTD_outBuffer out = {Buffer, Count, 0};
+	while (out.pos < out.size)
+	{
+		if (in.pos == in.size && !m_f->fileEOF)
+		{
+			const size_t n =
+				fread(m_f->inBuf.data(), 1, m_f->inBuf.size(), m_f->f);
+			m_f->fileBytesRead += n;
+			m_f->fileEOF = (n < m_f->inBuf.size());
+			in = {m_f->inBuf.data(), n, 0};
+		}
+
+		const size_t prevIn = in.pos, prevOut = out.pos;
+		const size_t ret = ZSTD_decompressStream(m_f->dctx, &out, &in);
+		if (ZSTD_isError(ret))
+			THROW_EXCEPTION_FMT(
+				"Error decompressing file '%s': %s", m_f->filename.c_str(),
+				ZSTD_getErrorName(ret));
+		m_f->lastRet = ret;
+
+		if (in.pos == prevIn && out.pos == prevOut && m_f->fileEOF)
+		{
+			// Nothing else to decompress (or a truncated last frame):
+			m_f->drained = true;
+			break;
+		}
+	}
+	return out.pos;
+#else
+	(void)Buffer;
+	(void)Count;
+	return 0;
+#endif
+}
+
+size_t CFileZstdInputStream::Write(
+	[[maybe_unused]] const void* Buffer, [[maybe_unused]] size_t Count)
+{
+	THROW_EXCEPTION("Trying to write to an input file stream.");
+}
+
+uint64_t CFileZstdInputStream::getTotalBytesCount() const
+{
+	if (!m_f->f) { THROW_EXCEPTION("File is not open."); }
+	return m_file_size;
+}
+
+uint64_t CFileZstdInputStream::getPosition() const
+{
+	if (!m_f->f) { THROW_EXCEPTION("File is not open."); }
+#if MRPT_HAS_ZSTD
+	return m_f->fileBytesRead - (m_f->in.size - m_f->in.pos);
+#else
+	return 0;
+#endif
+}
+
+bool CFileZstdInputStream::fileOpenCorrectly() const
+{
+	return m_f->f != nullptr;
+}
+bool CFileZstdInputStream::checkEOF()
+{
+	if (!m_f->f) return true;
+#if MRPT_HAS_ZSTD
+	return m_f->drained ||
+		(m_f->fileEOF && m_f->in.pos == m_f->in.size && m_f->lastRet == 0);
+#else
+	return true;
+#endif
+}
+
+uint64_t CFileZstdInputStream::Seek(int64_t, CStream::TSeekOrigin)
+{
+	THROW_EXCEPTION("Method not available in this class.");
+}
+
+std::string CFileZstdInputStream::getStreamDescription() const
+{
+	return mrpt::format(
+		"mrpt::io::CFileZstdInputStream for file '%s'", m_f->filename.c_str());
+}
+
+std::string CFileZstdInputStream::filePathAtUse() const
+{
+	// Returns opened file:
+	return m_f->filename;
+}
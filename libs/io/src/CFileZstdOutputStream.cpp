@@ -0,0 +1,223 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "io-precomp.h"	 // Precompiled headers
+//
+#include <mrpt/core/exceptions.h>
+#include <mrpt/io/CFileZstdOutputStream.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>	// strerror
+//
+#include <mrpt/config.h>
+#if MRPT_HAS_ZSTD
+#include <zstd.h>
+#endif
+
+using namespace mrpt::io;
+using namespace std;
+
+struct CFileZstdOutputStream::Impl
+{
+	FILE* f = nullptr;
+	std::string filename;
+#if MRPT_HAS_ZSTD
+	ZSTD_CCtx* cctx = nullptr;
+#endif
+	std::vector<uint8_t> outBuf;
+	std::vector<uint8_t> dict;
+	unsigned int numThreads = 0;
+	/** Uncompressed bytes written so far */
+	uint64_t position = 0;
+};
+
+CFileZstdOutputStream::CFileZstdOutputStream()
+	: m_f(mrpt::make_impl<CFileZstdOutputStream::Impl>())
+{
+}
+
+CFileZstdOutputStream::CFileZstdOutputStream(
+	const std::string& fileName, const OpenMode mode, int compressionLevel)
+	: CFileZstdOutputStream()
+{
+	MRPT_START
+	std::string err_msg;
+	if (!open(fileName, compressionLevel, err_msg, mode))
+		THROW_EXCEPTION_FMT(
+			"Error trying to open file: '%s', error: '%s'", fileName.c_str(),
+			err_msg.c_str());
+	MRPT_END
+}
+
+void CFileZstdOutputStream::setNumThreads(unsigned int numThreads)
+{
+	m_f->numThreads = numThreads;
+}
+
+void CFileZstdOutputStream::setDictionary(const std::vector<uint8_t>& dict)
+{
+	m_f->dict = dict;
+}
+
+bool CFileZstdOutputStream::open(
+	const string& fileName, int compress_level,
+	mrpt::optional_ref<std::string> error_msg, const OpenMode mode)
+{
+	MRPT_START
+
+	close();
+
+#if MRPT_HAS_ZSTD
+	m_f->f =
+		fopen(fileName.c_str(), mode == OpenMode::APPEND ? "ab" : "wb");
+	if (m_f->f == nullptr)
+	{
+		if (error_msg) error_msg.value().get() = std::string(strerror(errno));
+		return false;
+	}
+
+	auto& cctx = m_f->cctx;
+	cctx = ZSTD_createCCtx();
+	ASSERT_(cctx != nullptr);
+
+	size_t ret =
+		ZSTD_CCtx_setParameter(cctx, ZSTD_c_compressionLevel, compress_level);
+	if (!ZSTD_isError(ret))
+		ret = ZSTD_CCtx_setParameter(cctx, ZSTD_c_checksumFlag, 1);
+	// Fails if libzstd was built without multithreading: just ignore it.
+	if (m_f->numThreads > 0)
+		ZSTD_CCtx_setParameter(
+			cctx, ZSTD_c_nbWorkers, static_cast<int>(m_f->numThreads));
+	if (!ZSTD_isError(ret) && !m_f->dict.empty())
+		ret = ZSTD_CCtx_loadDictionary(
+			cctx, m_f->dict.data(), m_f->dict.size());
+	if (ZSTD_isError(ret))
+	{
+		if (error_msg)
+			error_msg.value().get() = std::string(ZSTD_getErrorName(ret));
+		// Do not flush any frame into the file:
+		ZSTD_freeCCtx(cctx);
+		cctx = nullptr;
+		close();
+		return false;
+	}
+
+	m_f->outBuf.resize(ZSTD_CStreamOutSize());
+	m_f->filename = fileName;
+	m_f->position = 0;
+	return true;
+#else
+	(void)fileName;
+	(void)compress_level;
+	(void)mode;
+	if (error_msg)
+		error_msg.value().get() =
+			"MRPT was built without Zstandard (libzstd) support";
+	return false;
+#endif
+
+	MRPT_END
+}
+
+CFileZstdOutputStream::~CFileZstdOutputStream() { close(); }
+void CFileZstdOutputStream::close()
+{
+#if MRPT_HAS_ZSTD
+	if (m_f->cctx)
+	{
+		// Flush the end of the frame:
+		if (m_f->f)
+		{
+			ZSTD_inBuffer in = {nullptr, 0, 0};
+			for (;;)
+			{
+				ZSTD_outBuffer out = {
+					m_f->outBuf.data(), m_f->outBuf.size(), 0};
+				const size_t remaining =
+					ZSTD_compressStream2(m_f->cctx, &out, &in, ZSTD_e_end);
+				if (ZSTD_isError(remaining)) break;
+				fwrite(out.dst, 1, out.pos, m_f->f);
+				if (remaining == 0) break;
+			}
+		}
+		ZSTD_freeCCtx(m_f->cctx);
+		m_f->cctx = nullptr;
+	}
+#endif
+	if (m_f->f)
+	{
+		fclose(m_f->f);
+		m_f->f = nullptr;
+		m_f->filename.clear();
+	}
+}
+
+size_t CFileZstdOutputStream::Read(void*, size_t)
+{
+	THROW_EXCEPTION("Trying to read from an output file stream.");
+}
+
+size_t CFileZstdOutputStream::Write(const void* Buffer, size_t Count)
+{
+	if (!m_f->f) { THROW_EXCEPTION("File is not open."); }
+#if MRPT_HAS_ZSTD
+	ZSTD_inBuffer in = {Buffer, Count, 0};
+	while (in.pos < in.size)
+	{
+		ZSTD_outBuffer out = {m_f->outBuf.data(), m_f->outBuf.size(), 0};
+		const size_t ret =
+			ZSTD_compressStream2(m_f->cctx, &out, &in, ZSTD_e_continue);
+		if (ZSTD_isError(ret))
+			THROW_EXCEPTION_FMT(
+				"Error compressing data: %s", ZSTD_getErrorName(ret));
+		if (fwrite(out.dst, 1, out.pos, m_f->f) != out.pos)
+			THROW_EXCEPTION_FMT(
+				"Error writing to file '%s'", m_f->filename.c_str());
+	}
+	m_f->position += Count;
+	return Count;
+#else
+	(void)Buffer;
+	(void)Count;
+	return 0;
+#endif
+}
+
+uint64_t CFileZstdOutputStream::getPosition() const
+{
+	if (!m_f->f) { THROW_EXCEPTION("File is not open."); }
+	return m_f->position;
+}
+
+bool CFileZstdOutputStream::fileOpenCorrectly() const
+{
+	return m_f->f != nullptr;
+}
+uint64_t CFileZstdOutputStream::Seek(int64_t, CStream::TSeekOrigin)
+{
+	THROW_EXCEPTION("Method not available in this class.");
+}
+
+uint64_t CFileZstdOutputStream::getTotalBytesCount() const
+{
+	THROW_EXCEPTION("Method not available in this class.");
+}
+std::string CFileZstdOutputStream::getStreamDescription() const
+{
+	return mrpt::format(
+		"mrpt::io::CFileZstdOutputStream for file '%s'",
+		m_f->filename.c_str());
+}
+
+std::string CFileZstdOutputStream::filePathAtUse() const
+{
+	// Returns opened file:
+	return m_f->filename;
+}
@@ -0,0 +1,130 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/config.h>
+#include <mrpt/io/CFileGZInputStream.h>
+#include <mrpt/io/CFileGZOutputStream.h>
+#include <mrpt/io/CFileZstdInputStream.h>
+#include <mrpt/io/CFileZstdOutputStream.h>
+#include <mrpt/random/RandomGenerators.h>
+#include <mrpt/system/filesystem.h>
+
+#include <algorithm>  // std::equal
+
+#if MRPT_HAS_ZSTD
+
+// Low entropy test data, larger than the zstd internal buffers:
+static std::vector<uint8_t> generate_zstd_test_data()
+{
+	mrpt::random::Generator_MT19937 mersenne_engine;
+	mersenne_engine.seed(123U);
+	std::vector<uint8_t> data(300000);
+	for (auto& d : data)
+		d = mersenne_engine() % 4;
+	return data;
+}
+
+TEST(CFileZstdStreams, readwriteTmpFile)
+{
+	const auto tst_data = generate_zstd_test_data();
+	const size_t N = tst_data.size();
+
+	for (unsigned int nThreads : {0U, 2U})
+	{
+		const std::string fil = mrpt::system::getTempFileName() + ".zst";
+		{
+			mrpt::io::CFileZstdOutputStream fil_out;
+			fil_out.setNumThreads(nThreads);
+			ASSERT_TRUE(fil_out.open(fil, 3));
+			// In chunks of different sizes:
+			EXPECT_EQ(fil_out.Write(&tst_data[0], 10), 10U);
+			EXPECT_EQ(fil_out.Write(&tst_data[10], N - 10), N - 10);
+			EXPECT_EQ(fil_out.getPosition(), N);
+		}
+		EXPECT_TRUE(mrpt::io::CFileZstdInputStream::isZstdFile(fil));
+
+		// Append a second frame:
+		{
+			mrpt::io::CFileZstdOutputStream fil_out(
+				fil, mrpt::io::OpenMode::APPEND);
+			EXPECT_EQ(fil_out.Write(&tst_data[0], N / 2), N / 2);
+		}
+
+		// Read back, directly or auto-detected by CFileGZInputStream:
+		for (int useGZ = 0; useGZ < 2; useGZ++)
+		{
+			std::unique_ptr<mrpt::io::CStream> in;
+			if (useGZ)
+			{
+				auto gz = std::make_unique<mrpt::io::CFileGZInputStream>();
+				ASSERT_TRUE(gz->open(fil));
+				in = std::move(gz);
+			}
+			else
+				in = std::make_unique<mrpt::io::CFileZstdInputStream>(fil);
+
+			std::vector<uint8_t> rd_buf(N + N / 2 + 5);
+			EXPECT_EQ(in->Read(&rd_buf[0], 1), 1U);
+			EXPECT_EQ(in->Read(&rd_buf[1], rd_buf.size() - 1), N + N / 2 - 1);
+			EXPECT_TRUE(
+				std::equal(tst_data.begin(), tst_data.end(), rd_buf.begin()));
+			EXPECT_TRUE(std::equal(
+				tst_data.begin(), tst_data.begin() + N / 2,
+				rd_buf.begin() + N));
+			EXPECT_EQ(in->Read(&rd_buf[0], 1), 0U);
+			EXPECT_EQ(in->getPosition(), in->getTotalBytesCount());
+		}
+	}
+}
+
+TEST(CFileZstdStreams, dictionary)
+{
+	const auto tst_data = generate_zstd_test_data();
+	const std::vector<uint8_t> dict(tst_data.begin(), tst_data.begin() + 1024);
+
+	const std::string fil = mrpt::system::getTempFileName() + ".zst";
+	{
+		mrpt::io::CFileZstdOutputStream fil_out;
+		fil_out.setDictionary(dict);
+		ASSERT_TRUE(fil_out.open(fil));
+		fil_out.Write(&tst_data[0], tst_data.size());
+	}
+
+	// Reading without the dictionary must fail:
+	{
+		mrpt::io::CFileZstdInputStream fil_in(fil);
+		uint8_t rd_buf[16];
+		EXPECT_ANY_THROW(fil_in.Read(rd_buf, sizeof(rd_buf)));
+	}
+	// And work with it:
+	{
+		mrpt::io::CFileZstdInputStream fil_in;
+		fil_in.setDictionary(dict);
+		ASSERT_TRUE(fil_in.open(fil));
+		std::vector<uint8_t> rd_buf(tst_data.size());
+		EXPECT_EQ(fil_in.Read(&rd_buf[0], rd_buf.size()), rd_buf.size());
+		EXPECT_EQ(rd_buf, tst_data);
+		EXPECT_EQ(fil_in.Read(&rd_buf[0], 1), 0U);
+		EXPECT_TRUE(fil_in.checkEOF());
+	}
+}
+
+#endif
+
+TEST(CFileZstdStreams, isZstdFile)
+{
+	const std::string fil = mrpt::system::getTempFileName() + ".gz";
+	{
+		mrpt::io::CFileGZOutputStream fil_out(fil);
+		fil_out.Write("hello", 5);
+	}
+	EXPECT_FALSE(mrpt::io::CFileZstdInputStream::isZstdFile(fil));
+	EXPECT_FALSE(mrpt::io::CFileZstdInputStream::isZstdFile(fil + ".none"));
+}
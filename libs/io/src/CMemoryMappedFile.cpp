@@ -0,0 +1,131 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "io-precomp.h"	 // Precompiled headers
+//
+#include <mrpt/core/exceptions.h>
+#include <mrpt/io/CFileInputStream.h>
+#include <mrpt/io/CMemoryMappedFile.h>
+#include <mrpt/system/filesystem.h>
+
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#elif !MRPT_IN_EMSCRIPTEN
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#define MEMORYMAPPEDFILE_HAS_MMAP
+#endif
+
+using namespace mrpt::io;
+
+struct CMemoryMappedFile::Impl
+{
+	bool isOpen = false;
+	const uint8_t* data = nullptr;
+	uint64_t dataSize = 0;
+
+#if defined(_WIN32)
+	HANDLE hFile = INVALID_HANDLE_VALUE, hMap = nullptr;
+#elif defined(MEMORYMAPPEDFILE_HAS_MMAP)
+	int fd = -1;
+#endif
+	// Fallback if memory mapping is not available:
+	std::vector<uint8_t> buffer;
+
+	void map(const std::string& fileName)
+	{
+		dataSize = mrpt::system::getFileSize(fileName);
+		ASSERTMSG_(
+			dataSize != static_cast<uint64_t>(-1),
+			"Cannot open file: " + fileName);
+		if (dataSize == 0) return;	// Nothing to map
+#if defined(_WIN32)
+		hFile = CreateFileA(
+			fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+			OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		ASSERTMSG_(
+			hFile != INVALID_HANDLE_VALUE, "Cannot open file: " + fileName);
+		hMap = CreateFileMappingA(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		ASSERTMSG_(hMap, "Cannot map file: " + fileName);
+		data = static_cast<const uint8_t*>(
+			MapViewOfFile(hMap, FILE_MAP_READ, 0, 0, 0));
+#elif defined(MEMORYMAPPEDFILE_HAS_MMAP)
+		fd = ::open(fileName.c_str(), O_RDONLY);
+		ASSERTMSG_(fd >= 0, "Cannot open file: " + fileName);
+		void* p = ::mmap(
+			nullptr, static_cast<size_t>(dataSize), PROT_READ, MAP_SHARED, fd,
+			0);
+		if (p != MAP_FAILED)
+		{
+			data = static_cast<const uint8_t*>(p);
+			// Files are usually parsed from the beginning to the end:
+			::madvise(p, static_cast<size_t>(dataSize), MADV_SEQUENTIAL);
+		}
+#else
+		CFileInputStream f;
+		ASSERTMSG_(f.open(fileName), "Cannot open file: " + fileName);
+		buffer.resize(static_cast<size_t>(dataSize));
+		ASSERT_EQUAL_(f.Read(buffer.data(), buffer.size()), buffer.size());
+		data = buffer.data();
+#endif
+		ASSERTMSG_(data, "Cannot map file: " + fileName);
+	}
+
+	void unmap()
+	{
+#if defined(_WIN32)
+		if (data) UnmapViewOfFile(data);
+		if (hMap) CloseHandle(hMap);
+		if (hFile != INVALID_HANDLE_VALUE) CloseHandle(hFile);
+		hMap = nullptr;
+		hFile = INVALID_HANDLE_VALUE;
+#elif defined(MEMORYMAPPEDFILE_HAS_MMAP)
+		if (data) ::munmap(const_cast<uint8_t*>(data), dataSize);
+		if (fd >= 0) ::close(fd);
+		fd = -1;
+#endif
+		buffer = std::vector<uint8_t>();
+		data = nullptr;
+		dataSize = 0;
+		isOpen = false;
+	}
+};
+
+CMemoryMappedFile::CMemoryMappedFile() : m_impl(std::make_unique<Impl>()) {}
+
+CMemoryMappedFile::CMemoryMappedFile(const std::string& fileName)
+	: CMemoryMappedFile()
+{
+	open(fileName);
+}
+
+CMemoryMappedFile::~CMemoryMappedFile() { close(); }
+
+void CMemoryMappedFile::open(const std::string& fileName)
+{
+	close();
+	try
+	{
+		m_impl->map(fileName);
+	}
+	catch (...)
+	{
+		m_impl->unmap();
+		throw;
+	}
+	m_impl->isOpen = true;
+}
+
+bool CMemoryMappedFile::isOpen() const { return m_impl->isOpen; }
+void CMemoryMappedFile::close() { m_impl->unmap(); }
+const uint8_t* CMemoryMappedFile::data() const { return m_impl->data; }
+uint64_t CMemoryMappedFile::size() const { return m_impl->dataSize; }
@@ -199,9 +199,7 @@ bool CMemoryStream::loadBufferFromFile(const std::string& file_name)
 // be freed here.
 void mrpt::io::internal::free_fn_for_zmq(void* /* data*/, void* hint)
 {
-	auto* fd = reinterpret_cast<mrpt::io::internal::TFreeFnDataForZMQ*>(hint);
-	if (fd->do_free) delete fd->buf;
-	delete fd;
+	delete reinterpret_cast<mrpt::io::internal::TFreeFnDataForZMQ*>(hint);
 }
 
 std::string CMemoryStream::getStreamDescription() const
@@ -10,8 +10,9 @@
 #include "io-precomp.h"	 // Precompiled headers
 //
 #include <mrpt/core/exceptions.h>
+#include <mrpt/io/CMemoryMappedFile.h>
 #include <mrpt/io/CTextFileLinesParser.h>
-#include <mrpt/system/string_utils.h>
+#include <mrpt/system/text_parsing.h>
 
 #include <sstream>
 
@@ -37,34 +38,44 @@ void CTextFileLinesParser::open(const std::string& fil)
 	m_curLineNum = 0;
 	m_fileName = fil;
 	this->close();
-	auto ifs = std::make_shared<std::ifstream>();
-	ifs->clear();
-	ifs->open(fil.c_str());
-	if (!ifs->is_open())
+	auto f = std::make_shared<CMemoryMappedFile>();
+	try
+	{
+		f->open(fil);
+	}
+	catch (const std::exception&)
+	{
 		THROW_EXCEPTION_FMT("Error opening file '%s' for reading", fil.c_str());
-	m_my_in = std::shared_ptr<std::istream>(ifs);
-	m_in = m_my_in.get();
+	}
+	m_mapped = f;
+	m_pending = m_mapped->text();
 }
 
 void CTextFileLinesParser::close()
 {
-	if (!m_in) return;
 	m_my_in.reset();
 	m_in = nullptr;
+	m_mapped.reset();
+	m_pending = {};
 }
 void CTextFileLinesParser::rewind()
 {
 	m_curLineNum = 0;
+	if (m_mapped)
+	{
+		m_pending = m_mapped->text();
+		return;
+	}
 	m_in->clear();
 	m_in->seekg(0);
 }
 
 bool CTextFileLinesParser::getNextLine(std::string& out_str)
 {
-	std::istringstream buf;
-	if (getNextLine(buf))
+	std::string_view lin;
+	if (getNextLine(lin))
 	{
-		out_str = buf.str();
+		out_str.assign(lin);
 		return true;
 	}
 	out_str.clear();
@@ -73,27 +84,55 @@ bool CTextFileLinesParser::getNextLine(std::string& out_str)
 
 bool CTextFileLinesParser::getNextLine(std::istringstream& buf)
 {
-	ASSERT_(m_in != nullptr);
-	while (!m_in->fail())
+	std::string_view lin;
+	if (!getNextLine(lin)) return false;
+	// Parse the line as a string stream:
+	buf.str(std::string(lin));
+	buf.clear();
+	return true;
+}
+
+bool CTextFileLinesParser::getNextLine(std::string_view& out_str)
+{
+	ASSERT_(m_in != nullptr || m_mapped);
+	for (;;)
 	{
-		std::string lin;
-		std::getline(*m_in, lin);
+		std::string_view lin;
+		if (m_mapped)
+		{
+			if (m_pending.empty()) break;
+			const size_t eol = m_pending.find('\n');
+			lin = m_pending.substr(0, eol);
+			m_pending.remove_prefix(
+				eol == std::string_view::npos ? m_pending.size() : eol + 1);
+		}
+		else
+		{
+			if (m_in->fail()) break;
+			m_line.clear();  // not done by getline() if already at EOF
+			std::getline(*m_in, m_line);
+			lin = m_line;
+		}
 		m_curLineNum++;
-		lin = mrpt::system::trim(lin);
+		if (!lin.empty() && lin.back() == '\r') lin.remove_suffix(1);
+		lin = mrpt::system::trim_view(lin);
 		if (lin.empty()) continue;	// Ignore empty lines.
-		// Ignore comments lines, starting with "#" or "//".
-		if ((m_filter_SH_comments && mrpt::system::strStarts(lin, "#")) ||
-			(m_filter_C_comments && mrpt::system::strStarts(lin, "//")) ||
-			(m_filter_MATLAB_comments && mrpt::system::strStarts(lin, "%")))
-			continue;
-		// Parse the line as a string stream:
-		buf.str(lin);
-		buf.clear();
+		if (isComment(lin)) continue;
+		out_str = lin;
 		return true;
-	};
+	}
+	out_str = {};
 	return false;
 }
 
+bool CTextFileLinesParser::isComment(std::string_view lin) const
+{
+	// Ignore comments lines, starting with "#", "//" or "%":
+	return (m_filter_SH_comments && lin[0] == '#') ||
+		(m_filter_C_comments && lin.substr(0, 2) == "//") ||
+		(m_filter_MATLAB_comments && lin[0] == '%');
+}
+
 size_t CTextFileLinesParser::getCurrentLineNumber() const
 {
 	return m_curLineNum;
@@ -10,7 +10,9 @@
 #include <gtest/gtest.h>
 #include <mrpt/core/common.h>
 #include <mrpt/io/CTextFileLinesParser.h>
+#include <mrpt/system/filesystem.h>
 
+#include <fstream>
 #include <sstream>
 
 TEST(CTextFileLinesParser, parse)
@@ -45,3 +47,42 @@ TEST(CTextFileLinesParser, parse)
 	// EOF:
 	EXPECT_FALSE(parser.getNextLine(line));
 }
+
+TEST(CTextFileLinesParser, parseMappedFile)
+{
+	const auto fil = mrpt::system::getTempFileName();
+	{
+		std::ofstream f(fil, std::ios::binary);
+		f << "  1st line \r\n"
+			 "\r\n"
+			 "// comment\n"
+			 "% comment\n"
+			 "\t2nd line";
+	}
+	{
+		mrpt::io::CTextFileLinesParser parser(fil);
+		for (int pass = 0; pass < 2; pass++)
+		{
+			std::string_view line;
+			EXPECT_TRUE(parser.getNextLine(line));
+			EXPECT_EQ(parser.getCurrentLineNumber(), 1U);
+			EXPECT_EQ(line, "1st line");
+
+			EXPECT_TRUE(parser.getNextLine(line));
+			EXPECT_EQ(parser.getCurrentLineNumber(), 5U);
+			EXPECT_EQ(line, "2nd line");
+
+			EXPECT_FALSE(parser.getNextLine(line));
+			parser.rewind();
+		}
+
+		parser.enableCommentFilters(false, true, true);
+		std::string line;
+		EXPECT_TRUE(parser.getNextLine(line));
+		EXPECT_TRUE(parser.getNextLine(line));
+		EXPECT_EQ(line, "% comment");
+	}
+	mrpt::system::deleteFile(fil);
+
+	EXPECT_ANY_THROW(mrpt::io::CTextFileLinesParser p(fil));
+}
@@ -11,22 +11,14 @@
 //
 #include "zlib.h"
 
-// For named pipes:
-#ifdef _WIN32
-#define WIN32_LEAN_AND_MEAN
-#include <windows.h>
-#endif
-
 #include <mrpt/core/exceptions.h>
 #include <mrpt/io/CFileGZInputStream.h>
 #include <mrpt/io/CFileGZOutputStream.h>
-#include <mrpt/io/CFileInputStream.h>
 #include <mrpt/io/vector_loadsave.h>
 #include <mrpt/io/zip.h>
 #include <mrpt/system/filesystem.h>
 
-#include <chrono>
-#include <iostream>
+#include <cstring>
 
 using namespace mrpt;
 using namespace mrpt::io;
@@ -264,95 +256,32 @@ bool mrpt::io::zip::compress_gz_data_block(
 	out_gz_data.clear();
 	if (in_data.empty()) return true;
 
-	const unsigned int nPipeName =
-		std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
-	std::string pipe_file_name;
-
-// Create an anonymous pipe for writing the data to:
-#ifdef _WIN32
-	// Windows:
-	pipe_file_name =
-		format("\\\\.\\pipe\\mrpt_compress_gz_data_block_%u", nPipeName);
-
-	HANDLE hPipe = CreateNamedPipeA(
-		pipe_file_name.c_str(),
-		PIPE_ACCESS_DUPLEX | 0x00080000 /* FILE_FLAG_FIRST_PIPE_INSTANCE */,
-		PIPE_TYPE_BYTE, PIPE_UNLIMITED_INSTANCES, in_data.size() + 1000,
-		in_data.size() + 1000, 0, nullptr);
-	if (hPipe == INVALID_HANDLE_VALUE)
-		THROW_EXCEPTION("Error creating named pipe for gz-file compression");
-#else
-	// Unix:
-	pipe_file_name = format("/tmp/mrpt_compress_gz_data_block_%u", nPipeName);
-#endif
-
-	bool retVal = false;
-	try
+	// Compress in memory, with a gzip header and trailer (windowBits+16).
+	// This is thread-safe, so several blocks can be compressed in parallel
+	// and their outputs concatenated into one valid multi-member .gz file.
+	z_stream strm;
+	std::memset(&strm, 0, sizeof(strm));
+	if (Z_OK !=
+		deflateInit2(
+			&strm, compress_level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY))
+		return false;
+
+	out_gz_data.resize(deflateBound(&strm, in_data.size()) + 32);
+	strm.next_in = const_cast<Bytef*>(in_data.data());
+	strm.avail_in = static_cast<uInt>(in_data.size());
+	strm.next_out = out_gz_data.data();
+	strm.avail_out = static_cast<uInt>(out_gz_data.size());
+
+	const int ret = deflate(&strm, Z_FINISH);
+	out_gz_data.resize(strm.total_out);
+	deflateEnd(&strm);
+
+	if (ret != Z_STREAM_END)
 	{
-		// Write as gz
-		{
-			gzFile f = gzopen(
-				pipe_file_name.c_str(), format("wb%i", compress_level).c_str());
-			if (f)
-			{
-				retVal = (int)in_data.size() ==
-					gzwrite(f, &in_data[0], in_data.size());
-				gzclose(f);
-			}
-			else
-			{
-				std::cerr << "[compress_gz_data_block] Error writing to pipe: "
-						  << pipe_file_name << std::endl;
-			}
-		}
-		// Read it all:
-		if (retVal)
-		{
-#ifdef _WIN32
-			// Read (windows)
-			const size_t N = GetFileSize(hPipe, nullptr);
-			if (N)
-			{
-				out_gz_data.resize(N);
-				DWORD nRead;
-				SetFilePointer(hPipe, 0, nullptr, FILE_BEGIN);
-				if (N)
-				{
-					ReadFile(hPipe, &out_gz_data[0], N, &nRead, nullptr);
-					retVal = nRead == N;
-				}
-			}
-			else
-			{
-				retVal = false;
-			}
-#else
-			// Read (Unix)
-			{
-				CFileInputStream iss;
-				if (iss.open(pipe_file_name))
-				{
-					const size_t M = iss.getTotalBytesCount();
-					out_gz_data.resize(M);
-					if (M) retVal = M == iss.Read(&out_gz_data[0], M);
-				}
-			}
-#endif
-		}
+		out_gz_data.clear();
+		return false;
 	}
-	catch (...)
-	{
-		retVal = false;
-	}
-
-// Close the pipe:
-#ifdef _WIN32
-	CloseHandle(hPipe);
-#else
-	remove(pipe_file_name.c_str());
-#endif
-
-	return retVal;
+	return true;
 }
 
 bool mrpt::io::zip::decompress_gz_data_block(
@@ -10,6 +10,8 @@
 #include <gtest/gtest.h>
 #include <mrpt/io/zip.h>
 
+#include <thread>
+
 using namespace mrpt;
 using namespace mrpt::io;
 using namespace std;
@@ -51,3 +53,34 @@ TEST(Compress, DataBlockGZ)
 		EXPECT_TRUE(all_eq) << "Mismatch after compressing/decompressing";
 	}
 }
+
+TEST(Compress, DataBlockGZ_ConcatenatedMembers)
+{
+	// Blocks compressed independently (and in parallel) must form a valid
+	// multi-member .gz stream once concatenated:
+	std::vector<uint8_t> all_data, all_gz;
+	std::vector<std::vector<uint8_t>> gz_blocks(4);
+	std::vector<std::thread> threads;
+	std::vector<std::vector<uint8_t>> blocks(gz_blocks.size());
+	for (size_t b = 0; b < blocks.size(); b++)
+	{
+		blocks[b].resize(10000 + 1000 * b);
+		for (size_t i = 0; i < blocks[b].size(); i++)
+			blocks[b][i] = static_cast<uint8_t>(i * (b + 1));
+		all_data.insert(all_data.end(), blocks[b].begin(), blocks[b].end());
+	}
+	for (size_t b = 0; b < blocks.size(); b++)
+		threads.emplace_back([&, b]() {
+			EXPECT_TRUE(
+				mrpt::io::zip::compress_gz_data_block(blocks[b], gz_blocks[b]));
+		});
+	for (auto& t : threads)
+		t.join();
+	for (const auto& gz : gz_blocks)
+		all_gz.insert(all_gz.end(), gz.begin(), gz.end());
+
+	std::vector<uint8_t> recovered_data;
+	ASSERT_TRUE(
+		mrpt::io::zip::decompress_gz_data_block(all_gz, recovered_data));
+	EXPECT_EQ(recovered_data, all_data);
+}
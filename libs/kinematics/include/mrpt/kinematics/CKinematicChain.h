@@ -8,6 +8,7 @@
    +------------------------------------------------------------------------+ */
 #pragma once
 
+#include <mrpt/math/CMatrixDynamic.h>
 #include <mrpt/opengl/CSetOfObjects.h>
 #include <mrpt/poses/CPose3D.h>
 #include <mrpt/serialization/CSerializable.h>
@@ -54,6 +55,13 @@ struct TKinematicLink
 	{
 	}
 	TKinematicLink() = default;
+
+	bool operator==(const TKinematicLink& o) const
+	{
+		return theta == o.theta && d == o.d && a == o.a && alpha == o.alpha &&
+			is_prismatic == o.is_prismatic;
+	}
+	bool operator!=(const TKinematicLink& o) const { return !(*this == o); }
 };
 
 mrpt::serialization::CArchive& operator>>(
@@ -85,6 +93,12 @@ class CKinematicChain : public mrpt::serialization::CSerializable
 	/** The pose of the first link. */
 	mrpt::poses::CPose3D m_origin;
 
+	/** Cache of getAllPoses(): the links and origin the poses were last
+	 * computed for, and the poses themselves */
+	mutable std::vector<TKinematicLink> m_fk_links;
+	mutable mrpt::poses::CPose3D m_fk_origin;
+	mutable std::vector<mrpt::poses::CPose3D> m_fk_poses;
+
    public:
 	/** Return the number of links */
 	size_t size() const { return m_links.size(); }
@@ -189,6 +203,41 @@ class CKinematicChain : public mrpt::serialization::CSerializable
 		std::vector<mrpt::poses::CPose3D>& poses,
 		const mrpt::poses::CPose3D& pose0 = mrpt::poses::CPose3D()) const;
 
+	/** Returns the global pose of each link, in the format of
+	 * recomputeAllPoses(), from an internal cache: only the poses of the
+	 * links after the first one whose parameters changed since the last call
+	 * (e.g. the first changed joint of setConfiguration()) are recomputed.
+	 * The returned reference is valid until the next call. Not thread-safe.
+	 * 
+ote (New in MRPT 2.4.9)
+	 */
+	const std::vector<mrpt::poses::CPose3D>& getAllPoses() const;
+
+	/** Computes the geometric Jacobian of the end effector (the frame after
+	 * the last link) at the current configuration: a 6xN matrix whose
+	 * column `i` holds the linear (rows 0-2) and angular (rows 3-5) velocity
+	 * of the end effector, in global coordinates, for a unit velocity of
+	 * the joint "q_i". Uses the cached poses of getAllPoses().
+	 * 
+ote (New in MRPT 2.4.9)
+	 */
+	void computeJacobian(mrpt::math::CMatrixDouble& J) const;
+
+	/** Computes the pose of the end effector (the frame after the last link)
+	 * for many configurations at once, without modifying this object: each
+	 * row of `configurations` holds the "q_i" values of one configuration,
+	 * as in setConfiguration(). Configurations are evaluated in parallel
+	 * with `numThreads` threads (0: as many as hardware threads).
+	 * \exception std::exception If the number of columns doesn't match the
+	 * number of links.
+	 * 
+ote (New in MRPT 2.4.9)
+	 */
+	void computeEndEffectorPoses(
+		const mrpt::math::CMatrixDouble& configurations,
+		std::vector<mrpt::poses::CPose3D>& outPoses,
+		size_t numThreads = 0) const;
+
 };	// End of class def.
 
 }  // namespace kinematics
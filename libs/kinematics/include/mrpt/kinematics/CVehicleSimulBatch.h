@@ -0,0 +1,210 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/core/bits_math.h>
+#include <mrpt/kinematics/CVehicleVelCmd.h>
+#include <mrpt/math/TPose2D.h>
+#include <mrpt/math/TTwist2D.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace mrpt
+{
+class WorkerThreadsPool;
+}
+
+namespace mrpt::kinematics
+{
+/** Kinematic simulator of many planar vehicles of the same kind at once,
+ * with the same model than CVehicleSimul_DiffDriven or CVehicleSimul_Holo
+ * (including their velocity dynamics and optional odometry errors), but
+ * without one virtual call per vehicle and control period.
+ *
+ * The state of all vehicles is stored as a structure of arrays, and
+ * simulateOneTimeStep() integrates all of them with one loop over vehicles
+ * per control period, which the compiler can vectorize, optionally split in
+ * chunks of vehicles run in parallel.
+ *
+ * All vehicles share the simulation time, so commands are timestamped with
+ * getTime() as in the single-vehicle simulators, and simulating N vehicles
+ * here gives the same trajectories than N CVehicleSimul_DiffDriven (or
+ * CVehicleSimul_Holo) objects, up to rounding errors.
+ *
+ * \code
+ *  CVehicleSimulBatch sim(CVehicleSimulBatch::Model::DiffDriven);
+ *  sim.resize(500);
+ *  for (size_t i = 0; i < sim.size(); i++)
+ *  {
+ *    sim.setCurrentGTPose(i, ...);
+ *    sim.movementCommand(i, 0.5 , 0.1);
+ *  }
+ *  sim.simulateOneTimeStep(0.1);
+ * \endcode
+ *
+ * \sa mrpt::nav::CMultiRobotSimulator
+ * \ingroup mrpt_kinematics_grp
+ * \note (New in MRPT 2.4.9)
+ */
+class CVehicleSimulBatch
+{
+   public:
+	/** Kinematic model of the vehicles */
+	enum class Model : uint8_t
+	{
+		/** As in CVehicleSimul_DiffDriven */
+		DiffDriven = 0,
+		/** As in CVehicleSimul_Holo */
+		Holo
+	};
+
+	explicit CVehicleSimulBatch(Model model = Model::DiffDriven);
+
+	Model model() const { return m_model; }
+
+	/** Number of vehicles */
+	size_t size() const { return m_gt_x.size(); }
+	/** Changes the number of vehicles. New vehicles start at the origin,
+	 * stopped. */
+	void resize(size_t n);
+
+	/** @name Kinematic simulation and control interface
+	 * @{ */
+
+	/** Runs the simulator of all vehicles during "dt" seconds, split into
+	 * periods of setFirmwareControlPeriod() as in
+	 * CVehicleSimulVirtualBase::simulateOneTimeStep().
+	 * \param numThreads Number of threads to split vehicles among (0: all
+	 * cores). Results do not depend on it, except for the random odometry
+	 * errors.
+	 */
+	void simulateOneTimeStep(const double dt, size_t numThreads = 1);
+
+	/** \overload Running the chunks of vehicles in an existing pool of
+	 * threads, e.g. to reuse it in all time steps. */
+	void simulateOneTimeStep(const double dt, mrpt::WorkerThreadsPool& pool);
+
+	/** Get the current simulation time */
+	double getTime() const { return m_time; }
+	/** Reset time counter \sa resetStatus */
+	void resetTime() { m_time = .0; }
+	/** Reset the state and commands of all vehicles (except the simulation
+	 * time) */
+	void resetStatus();
+
+	/** The period at which the low-level controller updates velocities
+	 * (Default: 0.5 ms) */
+	void setFirmwareControlPeriod(double period);
+	double getFirmwareControlPeriod() const
+	{
+		return m_firmware_control_period;
+	}
+
+	/** Returns the ground truth pose of vehicle `i` in world coordinates */
+	mrpt::math::TPose2D getCurrentGTPose(size_t i) const
+	{
+		return {m_gt_x[i], m_gt_y[i], m_gt_phi[i]};
+	}
+	/** Brute-force move vehicle `i` to target coordinates ("teleport") */
+	void setCurrentGTPose(size_t i, const mrpt::math::TPose2D& pose);
+
+	/** Returns the pose of vehicle `i` according to its (noisy) odometry */
+	mrpt::math::TPose2D getCurrentOdometricPose(size_t i) const
+	{
+		return {m_odo_x[i], m_odo_y[i], m_odo_phi[i]};
+	}
+	/** Brute-force overwrite the odometry of vehicle `i` */
+	void setCurrentOdometricPose(size_t i, const mrpt::math::TPose2D& pose);
+
+	/** Ground truth velocity of vehicle `i` in world coordinates */
+	mrpt::math::TTwist2D getCurrentGTVel(size_t i) const
+	{
+		return {m_gt_vx[i], m_gt_vy[i], m_gt_w[i]};
+	}
+	/** Ground truth velocity of vehicle `i` in its local frame */
+	mrpt::math::TTwist2D getCurrentGTVelLocal(size_t i) const;
+	/** Odometric velocity of vehicle `i` in world coordinates */
+	mrpt::math::TTwist2D getCurrentOdometricVel(size_t i) const
+	{
+		return {m_odo_vx[i], m_odo_vy[i], m_odo_w[i]};
+	}
+	/** Odometric velocity of vehicle `i` in its local frame */
+	mrpt::math::TTwist2D getCurrentOdometricVelLocal(size_t i) const;
+
+	/** Sends a velocity command to vehicle `i`, which must be of the kind
+	 * returned by getVelCmdType() */
+	void sendVelCmd(size_t i, const CVehicleVelCmd& cmd_vel);
+	/** An empty velocity command for this kind of vehicles */
+	CVehicleVelCmd::Ptr getVelCmdType() const;
+
+	/** Model::DiffDriven only: see
+	 * CVehicleSimul_DiffDriven::movementCommand() */
+	void movementCommand(size_t i, double lin_vel, double ang_vel);
+	/** Model::DiffDriven only: see
+	 * CVehicleSimul_DiffDriven::setDelayModelParams(). Applies to all
+	 * vehicles. */
+	void setDelayModelParams(
+		double TAU_delay_sec = 1.8, double CMD_delay_sec = 0.);
+
+	/** Model::Holo only: see CVehicleSimul_Holo::sendVelRampCmd() */
+	void sendVelRampCmd(
+		size_t i, double vel, double dir, double ramp_time, double rot_speed);
+
+	/** Enable/Disable odometry errors in all vehicles, see
+	 * CVehicleSimulVirtualBase::setOdometryErrors() */
+	void setOdometryErrors(
+		bool enabled, double Ax_err_bias = 1e-3, double Ax_err_std = 10e-3,
+		double Ay_err_bias = 1e-3, double Ay_err_std = 10e-3,
+		double Aphi_err_bias = mrpt::DEG2RAD(1e-3),
+		double Aphi_err_std = mrpt::DEG2RAD(10e-3));
+
+	/** @} */
+
+   private:
+	Model m_model;
+	double m_time = .0;
+	double m_firmware_control_period{500e-6};
+
+	/** @name State vectors, one entry per vehicle
+	 *  @{ */
+	std::vector<double> m_gt_x, m_gt_y, m_gt_phi;
+	std::vector<double> m_gt_vx, m_gt_vy, m_gt_w;
+	std::vector<double> m_odo_x, m_odo_y, m_odo_phi;
+	std::vector<double> m_odo_vx, m_odo_vy, m_odo_w;
+	/** @} */
+
+	/** @name Model::DiffDriven commands, one entry per vehicle
+	 *  @{ */
+	std::vector<double> m_v, m_w;
+	std::vector<double> m_cmd_time, m_cmd_v, m_cmd_w, m_cmd_v0, m_cmd_w0;
+	double m_cTAU{.0}, m_cDELAY{.0};
+	/** @} */
+
+	/** @name Model::Holo ramp commands, one entry per vehicle
+	 *  @{ */
+	std::vector<double> m_ramp_issue_time, m_ramp_target_vx, m_ramp_target_vy,
+		m_ramp_time, m_ramp_rot_speed, m_ramp_dir, m_ramp_init_vx,
+		m_ramp_init_vy, m_ramp_init_w;
+	/** @} */
+
+	bool m_use_odo_error{false};
+	double m_Ax_err_bias = 0, m_Ax_err_std = 0;
+	double m_Ay_err_bias = 0, m_Ay_err_std = 0;
+	double m_Aphi_err_bias = 0, m_Aphi_err_std = 0;
+
+	/** Simulates vehicles [i0,i1) during `nSteps` control periods */
+	void internal_simulateRange(size_t i0, size_t i1, size_t nSteps);
+	/** Number of control periods in `dt`, and time at its end */
+	size_t internal_numSteps(double dt, double& t_end) const;
+	void internal_controlDiffDriven(size_t i0, size_t i1, double t);
+	void internal_controlHolo(size_t i0, size_t i1, double t);
+};
+
+}  // namespace mrpt::kinematics
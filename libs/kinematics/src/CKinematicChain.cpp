@@ -9,6 +9,7 @@
 
 #include "kinematics-precomp.h"	 // Precompiled headers
 //
+#include <mrpt/core/WorkerThreadsPool.h>
 #include <mrpt/kinematics/CKinematicChain.h>
 #include <mrpt/opengl/CCylinder.h>
 #include <mrpt/opengl/CSetOfObjects.h>
@@ -16,6 +17,9 @@
 #include <mrpt/serialization/CArchive.h>
 #include <mrpt/serialization/stl_serialization.h>
 
+#include <algorithm>
+#include <thread>
+
 using namespace mrpt;
 using namespace mrpt::math;
 using namespace mrpt::poses;
@@ -85,6 +89,29 @@ void CKinematicChain::serializeFrom(
 	};
 }
 
+namespace
+{
+/** Composes (in place) the pose (R,t) with the pose change of one link,
+ * i.e. with the Denavit-Hartenberg transformation:
+ * Rz(theta) * Tz(d) * Tx(a) * Rx(alpha) */
+void composeLink(
+	CMatrixDouble33& R, CVectorFixedDouble<3>& t, const TKinematicLink& l)
+{
+	const double ct = cos(l.theta), st = sin(l.theta);
+	const double ca = cos(l.alpha), sa = sin(l.alpha);
+
+	for (int r = 0; r < 3; r++)
+	{
+		const double r0 = R(r, 0), r1 = R(r, 1), r2 = R(r, 2);
+		const double c0 = ct * r0 + st * r1;
+		t[r] += l.a * c0 + l.d * r2;
+		R(r, 0) = c0;
+		R(r, 1) = ca * (ct * r1 - st * r0) + sa * r2;
+		R(r, 2) = sa * (st * r0 - ct * r1) + ca * r2;
+	}
+}
+}  // namespace
+
 /** Go thru all the links of the chain and compute the global pose of each link.
  * The "ground" link pose "pose0" defaults to the origin of coordinates,
  * but anything else can be passed as the optional argument. */
@@ -96,41 +123,125 @@ void CKinematicChain::recomputeAllPoses(
 
 	poses.resize(N + 1);
 
-	CPose3D p = m_origin;  // Cummulative pose
+	// Cummulative pose:
+	CMatrixDouble33 R = m_origin.getRotationMatrix();
+	CVectorFixedDouble<3> t = m_origin.m_coords;
+
+	poses[0] = m_origin;
+
+	for (size_t i = 0; i < N; i++)
+	{
+		composeLink(R, t, m_links[i]);
+		poses[i + 1] = CPose3D(R, t);
+	}
+}
+
+const std::vector<mrpt::poses::CPose3D>& CKinematicChain::getAllPoses() const
+{
+	const size_t N = m_links.size();
+
+	// First link whose pose must be recomputed:
+	size_t first = 0;
+	if (m_fk_poses.size() == N + 1 && m_fk_origin == m_origin)
+	{
+		while (first < N && m_fk_links[first] == m_links[first])
+			first++;
+		if (first == N) return m_fk_poses;
+	}
+	else
+	{
+		m_fk_poses.resize(N + 1);
+		m_fk_poses[0] = m_origin;
+		m_fk_origin = m_origin;
+	}
+	m_fk_links = m_links;
+
+	CMatrixDouble33 R = m_fk_poses[first].getRotationMatrix();
+	CVectorFixedDouble<3> t = m_fk_poses[first].m_coords;
+	for (size_t i = first; i < N; i++)
+	{
+		composeLink(R, t, m_links[i]);
+		m_fk_poses[i + 1] = CPose3D(R, t);
+	}
+	return m_fk_poses;
+}
 
-	poses[0] = p;
+void CKinematicChain::computeJacobian(mrpt::math::CMatrixDouble& J) const
+{
+	const auto& poses = getAllPoses();
+	const size_t N = m_links.size();
 
+	J.setZero(6, N);
+	const auto& pEnd = poses[N].m_coords;
 	for (size_t i = 0; i < N; i++)
 	{
-		// Build the 3D pose change of the i'th link:
-		const double th = m_links[i].theta;
-		const double alpha = m_links[i].alpha;
-		const double d = m_links[i].d;
-		const double a = m_links[i].a;
-
-		const double t_vals[3] = {a * cos(th), a * sin(th), d};
-		const double r_vals[3 * 3] = {
-			cos(th),
-			-sin(th) * cos(alpha),
-			sin(th) * sin(alpha),
-			sin(th),
-			cos(th) * cos(alpha),
-			-cos(th) * sin(alpha),
-			0,
-			sin(alpha),
-			cos(alpha)};
-
-		const CMatrixDouble33 R(r_vals);
-		const CVectorFixedDouble<3> t(t_vals);
-
-		CPose3D link(R, t);
-
-		p.composeFrom(p, link);
-
-		poses[i + 1] = p;
+		// The joint "q_i" moves along/around the Z axis of the frame "i":
+		const auto& R = poses[i].getRotationMatrix();
+		const double z[3] = {R(0, 2), R(1, 2), R(2, 2)};
+		if (m_links[i].is_prismatic)
+		{
+			for (int r = 0; r < 3; r++)
+				J(r, i) = z[r];
+		}
+		else
+		{
+			const auto& p = poses[i].m_coords;
+			const double dp[3] = {
+				pEnd[0] - p[0], pEnd[1] - p[1], pEnd[2] - p[2]};
+			J(0, i) = z[1] * dp[2] - z[2] * dp[1];
+			J(1, i) = z[2] * dp[0] - z[0] * dp[2];
+			J(2, i) = z[0] * dp[1] - z[1] * dp[0];
+			for (int r = 0; r < 3; r++)
+				J(3 + r, i) = z[r];
+		}
 	}
 }
 
+void CKinematicChain::computeEndEffectorPoses(
+	const mrpt::math::CMatrixDouble& configurations,
+	std::vector<mrpt::poses::CPose3D>& outPoses, size_t numThreads) const
+{
+	MRPT_START
+
+	const size_t N = m_links.size();
+	ASSERT_EQUAL_(static_cast<size_t>(configurations.cols()), N);
+	const size_t nConfigs = configurations.rows();
+	outPoses.resize(nConfigs);
+
+	const CMatrixDouble33 R0 = m_origin.getRotationMatrix();
+	const CVectorFixedDouble<3> t0 = m_origin.m_coords;
+
+	auto lmbSolve = [&](size_t k) {
+		CMatrixDouble33 R = R0;
+		CVectorFixedDouble<3> t = t0;
+		for (size_t i = 0; i < N; i++)
+		{
+			TKinematicLink l = m_links[i];
+			if (l.is_prismatic) l.d = configurations(k, i);
+			else
+				l.theta = configurations(k, i);
+			composeLink(R, t, l);
+		}
+		outPoses[k] = CPose3D(R, t);
+	};
+
+	if (!numThreads)
+		numThreads = std::max(1U, std::thread::hardware_concurrency());
+	const size_t CONFIGS_PER_BUCKET = 256;
+	if (numThreads > 1 && nConfigs > CONFIGS_PER_BUCKET)
+	{
+		mrpt::WorkerThreadsPool pool(
+			numThreads - 1, mrpt::WorkerThreadsPool::POLICY_FIFO,
+			"kinematic_chain");
+		pool.parallel_for(0, nConfigs, CONFIGS_PER_BUCKET, lmbSolve);
+	}
+	else
+		for (size_t k = 0; k < nConfigs; k++)
+			lmbSolve(k);
+
+	MRPT_END
+}
+
 const float R = 0.01f;
 
 void addBar_D(mrpt::opengl::CSetOfObjects::Ptr& objs, const double d)
@@ -197,9 +308,8 @@ void CKinematicChain::update3DObject(
 
 	const size_t N = m_links.size();
 
-	// Recompute current poses:
-	std::vector<mrpt::poses::CPose3D> all_poses;
-	recomputeAllPoses(all_poses);
+	// Recompute current poses, only from the first modified link:
+	std::vector<mrpt::poses::CPose3D> all_poses = getAllPoses();
 
 	for (size_t i = 0; i <= N; i++)
 	{
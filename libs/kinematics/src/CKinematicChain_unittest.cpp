@@ -0,0 +1,146 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/kinematics/CKinematicChain.h>
+
+using namespace mrpt::kinematics;
+using mrpt::poses::CPose3D;
+
+namespace
+{
+CKinematicChain testArm()
+{
+	CKinematicChain arm;
+	arm.setOriginPose(CPose3D(1, 2, 3, 0.4, 0.1, -0.2));
+	arm.addLink(0.3, 0.4, 0.1, 1.2, false);
+	arm.addLink(-0.7, 0.2, 0.3, -0.4, false);
+	arm.addLink(0.1, 0.25, 0.05, 0.3, true);
+	arm.addLink(1.1, 0.1, 0.2, 0.9, false);
+	return arm;
+}
+
+void expectSamePoses(
+	const std::vector<CPose3D>& p1, const std::vector<CPose3D>& p2)
+{
+	ASSERT_EQ(p1.size(), p2.size());
+	for (size_t i = 0; i < p1.size(); i++)
+		for (int r = 0; r < 12; r++)
+			EXPECT_NEAR(
+				p1[i].getHomogeneousMatrixVal<mrpt::math::CMatrixDouble44>()(
+					r / 4, r % 4),
+				p2[i].getHomogeneousMatrixVal<mrpt::math::CMatrixDouble44>()(
+					r / 4, r % 4),
+				1e-12);
+}
+}  // namespace
+
+TEST(CKinematicChain, incrementalPoses)
+{
+	CKinematicChain arm = testArm();
+	std::vector<CPose3D> poses;
+
+	arm.recomputeAllPoses(poses);
+	expectSamePoses(arm.getAllPoses(), poses);
+
+	// Change a distal joint only:
+	std::vector<double> q;
+	arm.getConfiguration(q);
+	q[3] += 0.5;
+	arm.setConfiguration(q);
+	arm.recomputeAllPoses(poses);
+	expectSamePoses(arm.getAllPoses(), poses);
+
+	// Modifying links through references, and the origin, is also detected:
+	arm.getLinkRef(1).a = 0.7;
+	arm.recomputeAllPoses(poses);
+	expectSamePoses(arm.getAllPoses(), poses);
+
+	arm.setOriginPose(CPose3D(0, 0, 1, 0, 0, 0));
+	arm.recomputeAllPoses(poses);
+	expectSamePoses(arm.getAllPoses(), poses);
+
+	arm.removeLink(0);
+	arm.recomputeAllPoses(poses);
+	expectSamePoses(arm.getAllPoses(), poses);
+}
+
+TEST(CKinematicChain, jacobian)
+{
+	CKinematicChain arm = testArm();
+	const size_t N = arm.size();
+
+	mrpt::math::CMatrixDouble J;
+	arm.computeJacobian(J);
+	ASSERT_EQ(J.rows(), 6);
+	ASSERT_EQ(static_cast<size_t>(J.cols()), N);
+
+	// Compare against numerical derivatives:
+	const CPose3D p0 = arm.getAllPoses().back();
+	const auto R0 = p0.getRotationMatrix();
+	std::vector<double> q;
+	arm.getConfiguration(q);
+	const double h = 1e-6;
+	for (size_t i = 0; i < N; i++)
+	{
+		auto qi = q;
+		qi[i] += h;
+		arm.setConfiguration(qi);
+		const CPose3D p1 = arm.getAllPoses().back();
+
+		for (int r = 0; r < 3; r++)
+			EXPECT_NEAR(J(r, i), (p1.m_coords[r] - p0.m_coords[r]) / h, 1e-4);
+
+		// Angular velocity, from dR/dq * R^T = [w]x
+		const auto R1 = p1.getRotationMatrix();
+		auto dR = [&](int r, int c) {
+			double v = 0;
+			for (int k = 0; k < 3; k++)
+				v += (R1(r, k) - R0(r, k)) / h * R0(c, k);
+			return v;
+		};
+		EXPECT_NEAR(J(3, i), dR(2, 1), 1e-4);
+		EXPECT_NEAR(J(4, i), dR(0, 2), 1e-4);
+		EXPECT_NEAR(J(5, i), dR(1, 0), 1e-4);
+	}
+}
+
+TEST(CKinematicChain, batchEndEffectorPoses)
+{
+	const CKinematicChain arm = testArm();
+	const size_t N = arm.size(), nConfigs = 1000;
+
+	mrpt::math::CMatrixDouble configs(nConfigs, N);
+	for (size_t k = 0; k < nConfigs; k++)
+		for (size_t i = 0; i < N; i++)
+			configs(k, i) = std::sin(0.1 * k + i);
+
+	std::vector<CPose3D> poses1, poses4;
+	arm.computeEndEffectorPoses(configs, poses1, 1);
+	arm.computeEndEffectorPoses(configs, poses4, 4);
+	ASSERT_EQ(poses1.size(), nConfigs);
+	expectSamePoses(poses1, poses4);
+
+	CKinematicChain arm2 = arm;
+	for (size_t k = 0; k < nConfigs; k += 97)
+	{
+		std::vector<double> q(N);
+		for (size_t i = 0; i < N; i++)
+			q[i] = configs(k, i);
+		arm2.setConfiguration(q);
+		EXPECT_NEAR(
+			(arm2.getAllPoses().back().asVectorVal() -
+			 poses1[k].asVectorVal())
+				.norm(),
+			0, 1e-12);
+	}
+
+	EXPECT_ANY_THROW(arm.computeEndEffectorPoses(
+		mrpt::math::CMatrixDouble(3, N + 1), poses1));
+}
@@ -0,0 +1,375 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "kinematics-precomp.h"	 // Precompiled header
+//
+#include <mrpt/core/WorkerThreadsPool.h>
+#include <mrpt/kinematics/CVehicleSimulBatch.h>
+#include <mrpt/kinematics/CVehicleVelCmd_DiffDriven.h>
+#include <mrpt/kinematics/CVehicleVelCmd_Holo.h>
+#include <mrpt/math/wrap2pi.h>
+#include <mrpt/random.h>
+
+#include <cmath>
+#include <thread>
+
+using namespace mrpt::kinematics;
+
+namespace
+{
+// Same as mrpt::math::wrapToPi(), without its fmod() for the usual case of
+// angles which are already (or almost) in range:
+inline double wrapAngle(double a)
+{
+	if (a >= M_PI) a -= 2 * M_PI;
+	else if (a < -M_PI)
+		a += 2 * M_PI;
+	if (a >= M_PI || a < -M_PI) a = mrpt::math::wrapToPi(a);
+	return a;
+}
+}  // namespace
+
+CVehicleSimulBatch::CVehicleSimulBatch(Model model) : m_model(model) {}
+
+void CVehicleSimulBatch::resize(size_t n)
+{
+	for (auto* v :
+		 {&m_gt_x, &m_gt_y, &m_gt_phi, &m_gt_vx, &m_gt_vy, &m_gt_w, &m_odo_x,
+		  &m_odo_y, &m_odo_phi, &m_odo_vx, &m_odo_vy, &m_odo_w, &m_v, &m_w,
+		  &m_cmd_time, &m_cmd_v, &m_cmd_w, &m_cmd_v0, &m_cmd_w0,
+		  &m_ramp_target_vx, &m_ramp_target_vy, &m_ramp_time,
+		  &m_ramp_rot_speed, &m_ramp_dir, &m_ramp_init_vx, &m_ramp_init_vy,
+		  &m_ramp_init_w})
+		v->resize(n, .0);
+	// <0: no pending ramp cmd
+	m_ramp_issue_time.resize(n, -1.0);
+}
+
+void CVehicleSimulBatch::resetStatus()
+{
+	const size_t n = size();
+	for (auto* v :
+		 {&m_gt_x, &m_gt_y, &m_gt_phi, &m_gt_vx, &m_gt_vy, &m_gt_w, &m_odo_x,
+		  &m_odo_y, &m_odo_phi, &m_odo_vx, &m_odo_vy, &m_odo_w, &m_v, &m_w,
+		  &m_cmd_time, &m_cmd_v, &m_cmd_w, &m_cmd_v0, &m_cmd_w0,
+		  &m_ramp_target_vx, &m_ramp_target_vy, &m_ramp_time,
+		  &m_ramp_rot_speed, &m_ramp_dir, &m_ramp_init_vx, &m_ramp_init_vy,
+		  &m_ramp_init_w})
+		v->assign(n, .0);
+	m_ramp_issue_time.assign(n, -1.0);
+}
+
+void CVehicleSimulBatch::setFirmwareControlPeriod(double period)
+{
+	ASSERT_GT_(period, .0);
+	m_firmware_control_period = period;
+}
+
+void CVehicleSimulBatch::setCurrentGTPose(
+	size_t i, const mrpt::math::TPose2D& pose)
+{
+	ASSERT_LT_(i, size());
+	m_gt_x[i] = pose.x;
+	m_gt_y[i] = pose.y;
+	m_gt_phi[i] = pose.phi;
+}
+
+void CVehicleSimulBatch::setCurrentOdometricPose(
+	size_t i, const mrpt::math::TPose2D& pose)
+{
+	ASSERT_LT_(i, size());
+	m_odo_x[i] = pose.x;
+	m_odo_y[i] = pose.y;
+	m_odo_phi[i] = pose.phi;
+}
+
+mrpt::math::TTwist2D CVehicleSimulBatch::getCurrentGTVelLocal(size_t i) const
+{
+	mrpt::math::TTwist2D tl = getCurrentGTVel(i);
+	tl.rotate(-m_gt_phi[i]);
+	return tl;
+}
+
+mrpt::math::TTwist2D CVehicleSimulBatch::getCurrentOdometricVelLocal(
+	size_t i) const
+{
+	mrpt::math::TTwist2D tl = getCurrentOdometricVel(i);
+	tl.rotate(-m_odo_phi[i]);
+	return tl;
+}
+
+void CVehicleSimulBatch::sendVelCmd(size_t i, const CVehicleVelCmd& cmd_vel)
+{
+	if (m_model == Model::DiffDriven)
+	{
+		const auto* cmd =
+			dynamic_cast<const CVehicleVelCmd_DiffDriven*>(&cmd_vel);
+		ASSERTMSG_(
+			cmd,
+			"Wrong vehicle kinematic class, expected "
+			"`CVehicleVelCmd_DiffDriven`");
+		movementCommand(i, cmd->lin_vel, cmd->ang_vel);
+	}
+	else
+	{
+		const auto* cmd = dynamic_cast<const CVehicleVelCmd_Holo*>(&cmd_vel);
+		ASSERTMSG_(
+			cmd,
+			"Wrong vehicle kinematic class, expected `CVehicleVelCmd_Holo`");
+		sendVelRampCmd(
+			i, cmd->vel,
+			cmd->dir_local + m_odo_phi[i] /* local to odometry dir */,
+			cmd->ramp_time, cmd->rot_speed);
+	}
+}
+
+CVehicleVelCmd::Ptr CVehicleSimulBatch::getVelCmdType() const
+{
+	if (m_model == Model::DiffDriven)
+		return CVehicleVelCmd::Ptr(new CVehicleVelCmd_DiffDriven());
+	else
+		return CVehicleVelCmd::Ptr(new CVehicleVelCmd_Holo());
+}
+
+void CVehicleSimulBatch::movementCommand(
+	size_t i, double lin_vel, double ang_vel)
+{
+	ASSERT_(m_model == Model::DiffDriven);
+	ASSERT_LT_(i, size());
+	m_cmd_time[i] = m_time;
+	m_cmd_v[i] = lin_vel;
+	m_cmd_w[i] = ang_vel;
+	m_cmd_v0[i] = m_v[i];
+	m_cmd_w0[i] = m_w[i];
+}
+
+void CVehicleSimulBatch::setDelayModelParams(
+	double TAU_delay_sec, double CMD_delay_sec)
+{
+	m_cTAU = TAU_delay_sec;
+	m_cDELAY = CMD_delay_sec;
+}
+
+void CVehicleSimulBatch::sendVelRampCmd(
+	size_t i, double vel, double dir, double ramp_time, double rot_speed)
+{
+	ASSERT_(m_model == Model::Holo);
+	ASSERT_LT_(i, size());
+	ASSERT_GT_(ramp_time, 0);
+
+	m_ramp_issue_time[i] = m_time;
+	m_ramp_time[i] = ramp_time;
+	m_ramp_rot_speed[i] = rot_speed;
+	m_ramp_init_vx[i] = m_odo_vx[i];
+	m_ramp_init_vy[i] = m_odo_vy[i];
+	m_ramp_init_w[i] = m_odo_w[i];
+	m_ramp_target_vx[i] = cos(dir) * vel;
+	m_ramp_target_vy[i] = sin(dir) * vel;
+	m_ramp_dir[i] = dir;
+}
+
+void CVehicleSimulBatch::setOdometryErrors(
+	bool enabled, double Ax_err_bias, double Ax_err_std, double Ay_err_bias,
+	double Ay_err_std, double Aphi_err_bias, double Aphi_err_std)
+{
+	m_use_odo_error = enabled;
+	m_Ax_err_bias = Ax_err_bias;
+	m_Ax_err_std = Ax_err_std;
+	m_Ay_err_bias = Ay_err_bias;
+	m_Ay_err_std = Ay_err_std;
+	m_Aphi_err_bias = Aphi_err_bias;
+	m_Aphi_err_std = Aphi_err_std;
+}
+
+// Same as CVehicleSimul_DiffDriven::internal_simulControlStep(), for the
+// vehicles [i0,i1). Reads m_odo_phi, writes m_v, m_w and m_odo_v*.
+void CVehicleSimulBatch::internal_controlDiffDriven(
+	size_t i0, size_t i1, double t)
+{
+	const bool immediate = (m_cTAU == 0 && m_cDELAY == 0);
+	for (size_t i = i0; i < i1; i++)
+	{
+		double v = m_cmd_v[i], w = m_cmd_w[i];
+		if (!immediate)
+		{
+			const double elapsed_time =
+				std::max(0.0, t - m_cmd_time[i] - m_cDELAY);
+			const double f = 1 - exp(-elapsed_time / m_cTAU);
+			v = m_cmd_v0[i] + (m_cmd_v[i] - m_cmd_v0[i]) * f;
+			w = m_cmd_w0[i] + (m_cmd_w[i] - m_cmd_w0[i]) * f;
+		}
+		m_v[i] = v;
+		m_w[i] = w;
+		m_odo_vx[i] = cos(m_odo_phi[i]) * v;
+		m_odo_vy[i] = sin(m_odo_phi[i]) * v;
+		m_odo_w[i] = w;
+	}
+}
+
+// Same as CVehicleSimul_Holo::internal_simulControlStep(), for the
+// vehicles [i0,i1). Reads m_odo_phi, writes m_odo_v*.
+void CVehicleSimulBatch::internal_controlHolo(size_t i0, size_t i1, double t)
+{
+	for (size_t i = i0; i < i1; i++)
+	{
+		// are we executing any cmd?
+		if (m_ramp_issue_time[i] < 0 || t <= m_ramp_issue_time[i]) continue;
+
+		const double tc = t - m_ramp_issue_time[i];
+		const double T = m_ramp_time[i];
+		const bool ramping = tc <= T;
+
+		// "Blending" for vx,vy
+		const double vxi = m_ramp_init_vx[i], vyi = m_ramp_init_vy[i];
+		const double vxf = m_ramp_target_vx[i], vyf = m_ramp_target_vy[i];
+		m_odo_vx[i] = ramping ? vxi + tc * (vxf - vxi) / T : vxf;
+		m_odo_vy[i] = ramping ? vyi + tc * (vyf - vyi) / T : vyf;
+
+		// Ramp rotvel until aligned:
+		const double Aang =
+			mrpt::math::wrapToPi(m_ramp_dir[i] - m_odo_phi[i]);
+		if (std::abs(Aang) < mrpt::DEG2RAD(1.0))
+		{
+			m_odo_w[i] = .0;  // we are aligned.
+		}
+		else
+		{
+			const double wf =
+				mrpt::sign(Aang) * std::abs(m_ramp_rot_speed[i]);
+			m_odo_w[i] =
+				ramping ? m_ramp_init_w[i] + tc * (wf - m_ramp_init_w[i]) / T
+						: wf;
+		}
+	}
+}
+
+void CVehicleSimulBatch::internal_simulateRange(
+	size_t i0, size_t i1, size_t nSteps)
+{
+	const double At = m_firmware_control_period;
+	const size_t n = i1 - i0;
+
+	// Headings after each step. The control step needs the old ones.
+	std::vector<double> next_odo_phi(n), next_gt_phi(n), noise;
+	if (m_use_odo_error) noise.resize(3 * n);
+
+	double t = m_time;
+	for (size_t step = 0; step < nSteps; step++, t += At)
+	{
+		// Simulate movement during At, with the velocities of the previous
+		// control step. Vehicles are independent, so the loop over all of
+		// them for each step is vectorizable:
+		for (size_t i = i0, k = 0; i < i1; i++, k++)
+		{
+			m_odo_x[i] += m_odo_vx[i] * At;
+			m_odo_y[i] += m_odo_vy[i] * At;
+			next_odo_phi[k] = wrapAngle(m_odo_phi[i] + m_odo_w[i] * At);
+			m_gt_x[i] += m_gt_vx[i] * At;
+			m_gt_y[i] += m_gt_vy[i] * At;
+			next_gt_phi[k] = wrapAngle(m_gt_phi[i] + m_gt_w[i] * At);
+		}
+
+		// New velocities, from the current headings:
+		if (m_model == Model::DiffDriven)
+			internal_controlDiffDriven(i0, i1, t);
+		else
+			internal_controlHolo(i0, i1, t);
+
+		for (size_t i = i0, k = 0; i < i1; i++, k++)
+		{
+			// Rotate the new odometry velocity into GT coordinates:
+			const double Aphi = m_gt_phi[i] - m_odo_phi[i];
+			const double c = cos(Aphi), s = sin(Aphi);
+			const double gvx = m_odo_vx[i] * c - m_odo_vy[i] * s;
+			const double gvy = m_odo_vx[i] * s + m_odo_vy[i] * c;
+			m_gt_vx[i] = gvx;
+			m_gt_vy[i] = gvy;
+			m_gt_w[i] = m_odo_w[i];
+
+			m_odo_phi[i] = next_odo_phi[k];
+			m_gt_phi[i] = next_gt_phi[k];
+		}
+
+		// Add some errors
+		if (m_use_odo_error)
+		{
+			// (getRandomGenerator() is thread-local)
+			mrpt::random::getRandomGenerator().fillGaussian(noise);
+			for (size_t i = i0, k = 0; i < i1; i++, k += 3)
+			{
+				m_gt_x[i] += m_Ax_err_bias + m_Ax_err_std * noise[k];
+				m_gt_y[i] += m_Ay_err_bias + m_Ay_err_std * noise[k + 1];
+				m_gt_phi[i] = mrpt::math::wrapToPi(
+					m_gt_phi[i] + m_Aphi_err_bias +
+					m_Aphi_err_std * noise[k + 2]);
+			}
+		}
+	}
+}
+
+size_t CVehicleSimulBatch::internal_numSteps(double dt, double& t_end) const
+{
+	// Same number of control periods (and accumulated time) than in
+	// CVehicleSimulVirtualBase::simulateOneTimeStep():
+	const double final_t = m_time + dt;
+	t_end = m_time;
+	size_t nSteps = 0;
+	while (t_end <= final_t)
+	{
+		t_end += m_firmware_control_period;
+		nSteps++;
+	}
+	return nSteps;
+}
+
+// Chunks large enough to keep each thread busy during all control steps:
+static const size_t VEHICLES_PER_CHUNK = 64;
+
+void CVehicleSimulBatch::simulateOneTimeStep(
+	const double dt, size_t numThreads)
+{
+	if (!numThreads)
+		numThreads = std::max(1U, std::thread::hardware_concurrency());
+
+	if (numThreads > 1 && size() > VEHICLES_PER_CHUNK)
+	{
+		mrpt::WorkerThreadsPool pool(
+			numThreads - 1, mrpt::WorkerThreadsPool::POLICY_FIFO,
+			"vehicle_simul");
+		simulateOneTimeStep(dt, pool);
+	}
+	else
+	{
+		double t_end;
+		const size_t nSteps = internal_numSteps(dt, t_end);
+		internal_simulateRange(0, size(), nSteps);
+		m_time = t_end;
+	}
+}
+
+void CVehicleSimulBatch::simulateOneTimeStep(
+	const double dt, mrpt::WorkerThreadsPool& pool)
+{
+	MRPT_START
+
+	double t_end;
+	const size_t nSteps = internal_numSteps(dt, t_end);
+
+	const size_t N = size();
+	const size_t nChunks = (N + VEHICLES_PER_CHUNK - 1) / VEHICLES_PER_CHUNK;
+	pool.parallel_for(0, nChunks, 1, [&](size_t c) {
+		internal_simulateRange(
+			c * VEHICLES_PER_CHUNK, std::min(N, (c + 1) * VEHICLES_PER_CHUNK),
+			nSteps);
+	});
+
+	m_time = t_end;
+
+	MRPT_END
+}
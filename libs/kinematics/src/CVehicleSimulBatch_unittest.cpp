@@ -0,0 +1,115 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/kinematics/CVehicleSimulBatch.h>
+#include <mrpt/kinematics/CVehicleSimul_DiffDriven.h>
+#include <mrpt/kinematics/CVehicleSimul_Holo.h>
+
+#include <memory>
+
+using namespace mrpt::kinematics;
+using mrpt::math::TPose2D;
+
+namespace
+{
+void expectSameState(
+	const CVehicleSimulBatch& batch, size_t i,
+	const CVehicleSimulVirtualBase& sim)
+{
+	const double eps = 1e-9;
+	const TPose2D p = batch.getCurrentGTPose(i), ps = sim.getCurrentGTPose();
+	EXPECT_NEAR(p.x, ps.x, eps);
+	EXPECT_NEAR(p.y, ps.y, eps);
+	EXPECT_NEAR(p.phi, ps.phi, eps);
+	const TPose2D o = batch.getCurrentOdometricPose(i),
+				  os = sim.getCurrentOdometricPose();
+	EXPECT_NEAR(o.x, os.x, eps);
+	EXPECT_NEAR(o.y, os.y, eps);
+	EXPECT_NEAR(o.phi, os.phi, eps);
+	const auto v = batch.getCurrentGTVel(i), vs = sim.getCurrentGTVel();
+	EXPECT_NEAR(v.vx, vs.vx, eps);
+	EXPECT_NEAR(v.vy, vs.vy, eps);
+	EXPECT_NEAR(v.omega, vs.omega, eps);
+}
+
+// Runs N vehicles with different commands in the batch simulator and in
+// one single-vehicle simulator each, which must give the same states:
+template <class SIMUL>
+void runBatchVsSingle(
+	CVehicleSimulBatch::Model model, size_t numThreads, double tau)
+{
+	const size_t N = 150;  // > 1 chunk of vehicles
+	CVehicleSimulBatch batch(model);
+	batch.resize(N);
+	if (model == CVehicleSimulBatch::Model::DiffDriven)
+		batch.setDelayModelParams(tau, 0);
+
+	std::vector<std::unique_ptr<SIMUL>> sims;
+	for (size_t i = 0; i < N; i++)
+	{
+		sims.emplace_back(std::make_unique<SIMUL>());
+		if constexpr (std::is_same_v<SIMUL, CVehicleSimul_DiffDriven>)
+			sims[i]->setDelayModelParams(tau, 0);
+
+		const TPose2D p0(0.1 * i, -0.05 * i, -3.0 + 0.04 * i);
+		batch.setCurrentGTPose(i, p0);
+		batch.setCurrentOdometricPose(i, p0);
+		sims[i]->setCurrentGTPose(p0);
+		sims[i]->setCurrentOdometricPose(p0);
+	}
+
+	for (int step = 0; step < 20; step++)
+	{
+		// New commands every few steps:
+		if (step % 5 == 0)
+		{
+			for (size_t i = 0; i < N; i++)
+			{
+				auto cmd = batch.getVelCmdType();
+				for (size_t k = 0; k < cmd->getVelCmdLength(); k++)
+					cmd->setVelCmdElement(
+						k, 0.2 + 0.01 * ((i + k + step) % 17));
+				batch.sendVelCmd(i, *cmd);
+				sims[i]->sendVelCmd(*cmd);
+			}
+		}
+		batch.simulateOneTimeStep(0.1, numThreads);
+		for (auto& s : sims)
+			s->simulateOneTimeStep(0.1);
+	}
+
+	EXPECT_NEAR(batch.getTime(), sims[0]->getTime(), 1e-12);
+	for (size_t i = 0; i < N; i++)
+		expectSameState(batch, i, *sims[i]);
+}
+}  // namespace
+
+TEST(CVehicleSimulBatch, sameAsDiffDriven)
+{
+	for (const size_t numThreads : {1, 4})
+		for (const double tau : {0.0, 0.2})
+			runBatchVsSingle<CVehicleSimul_DiffDriven>(
+				CVehicleSimulBatch::Model::DiffDriven, numThreads, tau);
+}
+
+TEST(CVehicleSimulBatch, sameAsHolo)
+{
+	for (const size_t numThreads : {1, 4})
+		runBatchVsSingle<CVehicleSimul_Holo>(
+			CVehicleSimulBatch::Model::Holo, numThreads, 0);
+}
+
+TEST(CVehicleSimulBatch, wrongCmdType)
+{
+	CVehicleSimulBatch batch(CVehicleSimulBatch::Model::DiffDriven);
+	batch.resize(1);
+	EXPECT_ANY_THROW(batch.sendVelCmd(0, CVehicleVelCmd_Holo()));
+	EXPECT_ANY_THROW(batch.sendVelRampCmd(0, 1.0, 0.0, 1.0, 0.0));
+}
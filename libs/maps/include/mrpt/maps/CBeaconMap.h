@@ -15,6 +15,8 @@
 #include <mrpt/obs/obs_frwds.h>
 #include <mrpt/serialization/CSerializable.h>
 
+#include <vector>
+
 namespace mrpt::maps
 {
 /** A class for storing a map of 3D probabilistic beacons, using a Montecarlo,
@@ -67,6 +69,20 @@ class CBeaconMap : public mrpt::maps::CMetricMap
 	/** Constructor */
 	CBeaconMap();
 
+	/** Evaluates the log-likelihood of a beacon ranges observation for
+	 * many robot poses at once (e.g. all the particles of a particle filter),
+	 * with the same values than computeObservationLikelihood() for each one.
+	 * Each sensed beacon is looked up in the map only once, and the robot
+	 * poses and the particles or modes of its PDF are arranged as structures
+	 * of arrays, so inner loops run over plain arrays of coordinates.
+	 * \param outLogLiks Output log-likelihoods, one per pose.
+	 * \note (New in MRPT 2.4.9)
+	 */
+	void computeObservationLikelihoodBatch(
+		const mrpt::obs::CObservationBeaconRanges& obs,
+		const std::vector<mrpt::poses::CPose3D>& robotPoses,
+		std::vector<double>& outLogLiks) const;
+
 	/** Resize the number of SOG modes */
 	void resize(const size_t N);
 
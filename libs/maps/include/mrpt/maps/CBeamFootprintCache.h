@@ -0,0 +1,94 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/obs/T2DScanProperties.h>
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+namespace mrpt::maps
+{
+/** A cache of rasterized 2D laser beams ("footprints"), used by the batch
+ * insertion of 2D scans in occupancy grids
+ * (COccupancyGridMap2D::TInsertionOptions::batchInsertion).
+ *
+ * A footprint is the sequence of cells traversed by a beam leaving the
+ * sensor, as (dx,dy) cell increments with respect to the sensor cell. It
+ * only depends on the beam direction and on the position of the sensor
+ * within its cell, so for each scan geometry (mrpt::obs::T2DScanProperties)
+ * beam directions are quantized to a fixed lattice of absolute angles (with
+ * `headingSubdivisions` directions per angular step between beams), and the
+ * sensor position within its cell to `subCellBins` x `subCellBins` bins.
+ * Footprints are then rasterized (lazily, and only as long as needed) the
+ * first time they are used, and reused for any robot pose.
+ *
+ * \note (New in MRPT 2.4.9)
+ * \ingroup mrpt_maps_grp
+ */
+class CBeamFootprintCache
+{
+   public:
+	/** \param maxCachedSteps If the total number of cached cells grows beyond
+	 * this number, the cache is emptied before rasterizing the next scan. */
+	CBeamFootprintCache(
+		unsigned int headingSubdivisions = 4, unsigned int subCellBins = 4,
+		size_t maxCachedSteps = 1U << 24);
+
+	/** Cells traversed by one beam, relative to the sensor cell */
+	struct TFootprint
+	{
+		std::vector<int16_t> dx, dy;
+	};
+
+	/** All the footprints for one scan geometry and sensor sub-cell bin */
+	class TFootprintSet
+	{
+	   public:
+		/** Index of the closest lattice direction to `angle` [rad] */
+		size_t directionIndex(double angle) const;
+		/** Unit vector of a lattice direction */
+		float directionCos(size_t dir) const { return m_cos[dir]; }
+		float directionSin(size_t dir) const { return m_sin[dir]; }
+		/** Returns the footprint of a direction, rasterized to (at least)
+		 * `nSteps` cells. References returned by previous calls for other
+		 * directions remain valid. */
+		const TFootprint& footprint(size_t dir, size_t nSteps);
+
+	   private:
+		friend class CBeamFootprintCache;
+		double m_dirStep = 0;
+		float m_u0 = 0, m_v0 = 0;  //!< Sensor position within its cell
+		std::vector<float> m_cos, m_sin;
+		std::vector<TFootprint> m_footprints;
+		size_t m_steps = 0;	 //!< Total number of rasterized cells
+	};
+
+	/** Returns the footprints for sensors with the given scan geometry, at
+	 * the fractional position (`cell_frac_x`,`cell_frac_y`) in [0,1) within
+	 * their cell. */
+	TFootprintSet& getFootprints(
+		const mrpt::obs::T2DScanProperties& scanProps, float cell_frac_x,
+		float cell_frac_y);
+
+	/** Empties the cache */
+	void clear();
+
+	/** Total number of cached footprint cells */
+	size_t getCachedSteps() const;
+
+   private:
+	unsigned int m_headingSubdivisions, m_subCellBins;
+	size_t m_maxCachedSteps;
+	/** One TFootprintSet per sub-cell bin, for each scan geometry */
+	std::map<mrpt::obs::T2DScanProperties, std::vector<TFootprintSet>> m_sets;
+};
+
+}  // namespace mrpt::maps
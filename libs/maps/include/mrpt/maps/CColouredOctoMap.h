@@ -161,6 +161,17 @@ class CColouredOctoMap
    protected:
 	void internal_clear() override;
 
+	/** Voxels have the color of their node */
+	mrpt::img::TColor internal_getVoxelColor(
+		const octomap::ColorOcTreeNode& node, double z, double zmin,
+		double inv_dz,
+		const mrpt::opengl::COctoMapVoxels& gl_obj) const override;
+
+	/** Merges the color of voxels, with the current TColourUpdate method */
+	void internal_mergeVoxelData(
+		const octomap::ColorOcTreeNode& otherNode, double x, double y,
+		double z) override;
+
 	bool internal_insertObservation(
 		const mrpt::obs::CObservation& obs,
 		const std::optional<const mrpt::poses::CPose3D>& robotPose =
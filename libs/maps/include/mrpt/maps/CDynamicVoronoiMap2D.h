@@ -0,0 +1,172 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace mrpt::maps
+{
+class COccupancyGridMap2D;
+
+/** An Euclidean distance ("clearance") map and generalized Voronoi diagram of
+ * the obstacles in a COccupancyGridMap2D, which can be updated incrementally
+ * when grid cells change.
+ *
+ * Unlike COccupancyGridMap2D::buildVoronoiDiagram(), which recomputes the
+ * whole diagram each time, this class implements the dynamic brushfire
+ * algorithm by B. Lau, C. Sprunk and W. Burgard ("Efficient grid-based
+ * spatial representations for robot navigation in dynamic environments",
+ * RAS 2013): added obstacles start "lower" waves, and removed obstacles
+ * "raise" waves, which only visit the cells whose closest obstacle changes.
+ * Hence, the cost of an update is proportional to the area affected by the
+ * change, not to the map size.
+ *
+ * Typical usage:
+ * \code
+ * CDynamicVoronoiMap2D voronoi;
+ * voronoi.initialize(grid);
+ * // ... after inserting observations into `grid`:
+ * voronoi.update(grid, cx0, cy0, cx1, cy1); // or voronoi.update(grid);
+ * float d = voronoi.getClearance(x, y);
+ * \endcode
+ *
+ * A cell is an obstacle if its occupancy probability (1-getCell()) is above
+ * the threshold given to initialize(), so unknown cells are free by default.
+ * Cells are in the Voronoi diagram if they are (approximately) equidistant to
+ * two different obstacles. Voronoi lines may be up to two cells wide.
+ *
+ * \note (New in MRPT 2.4.9)
+ * \sa COccupancyGridMap2D::buildVoronoiDiagram
+ * \ingroup mrpt_maps_grp
+ */
+class CDynamicVoronoiMap2D
+{
+   public:
+	CDynamicVoronoiMap2D() = default;
+
+	/** Builds the distance map from scratch for the current contents of the
+	 * grid, also storing its geometry.
+	 * \param occupiedThreshold Cells with an occupancy probability above this
+	 * value are obstacles.
+	 * \param maxDistance If >0, distances [meters] are not propagated beyond
+	 * this value, and cells farther than it from any obstacle have an
+	 * infinite clearance. This bounds the cost of updates in open spaces.
+	 */
+	void initialize(
+		const COccupancyGridMap2D& grid, float occupiedThreshold = 0.5f,
+		float maxDistance = 0);
+
+	/** Re-reads the cells in the window [cx0,cx1]x[cy0,cy1] (cell indices,
+	 * inclusive, clipped to the grid) and updates the distances and Voronoi
+	 * diagram for those that became, or stopped being, obstacles.
+	 * If the grid size or origin changed, the map is rebuilt with
+	 * initialize() instead. */
+	void update(
+		const COccupancyGridMap2D& grid, int cx0, int cy0, int cx1, int cy1);
+
+	/** Like update() for the whole grid. The cost of finding the modified
+	 * cells is a comparison per cell, far cheaper than a full rebuild. */
+	void update(const COccupancyGridMap2D& grid);
+
+	/** @name Low-level editing
+		@{ */
+	/** Marks a cell as an obstacle. Changes take effect in processChanges()
+	 */
+	void setObstacle(int cx, int cy);
+	/** Marks a cell as free. Changes take effect in processChanges() */
+	void removeObstacle(int cx, int cy);
+	/** Propagates all the pending changes from setObstacle() and
+	 * removeObstacle(). Called from update(). */
+	void processChanges();
+	/** @} */
+
+	/** @name Queries
+		@{ */
+	unsigned int getSizeX() const { return m_size_x; }
+	unsigned int getSizeY() const { return m_size_y; }
+	float getResolution() const { return m_resolution; }
+
+	bool isObstacle(int cx, int cy) const
+	{
+		const int i = idx(cx, cy);
+		return m_cells[i].obst == i;
+	}
+
+	/** Distance from the cell center to the closest obstacle cell, in cells,
+	 * or infinity if there are no (close enough) obstacles. */
+	float getClearanceCells(int cx, int cy) const;
+
+	/** Distance [meters] from a point to the closest obstacle cell center, or
+	 * infinity if there are no (close enough) obstacles. Points out of the
+	 * grid have zero clearance.
+	 * \sa COccupancyGridMap2D::computeClearance */
+	float getClearance(float x, float y) const;
+
+	/** Gets the cell indices of the closest obstacle to a cell.
+	 * \return false if there are no (close enough) obstacles. */
+	bool getClosestObstacle(int cx, int cy, int& ox, int& oy) const;
+
+	/** Returns true if the cell belongs to the Voronoi diagram */
+	bool isVoronoi(int cx, int cy) const;
+
+	/** Number of cells visited by the last call to processChanges(), as a
+	 * measure of the cost of an update. */
+	size_t getLastUpdatedCellCount() const { return m_lastUpdatedCells; }
+	/** @} */
+
+   private:
+	static constexpr int32_t INVALID = -1;
+	static constexpr int32_t SQDIST_INF = INT32_MAX;
+
+	enum class Queueing : uint8_t
+	{
+		None = 0,
+		FwQueued,
+		FwProcessed,
+		BwProcessed
+	};
+
+	struct TCell
+	{
+		/** Squared distance to `obst`, in cells. */
+		int32_t sqdist = SQDIST_INF;
+		/** Index of the closest obstacle cell (itself if it is an obstacle),
+		 * or INVALID */
+		int32_t obst = INVALID;
+		bool needsRaise = false;
+		Queueing queueing = Queueing::None;
+	};
+
+	unsigned int m_size_x = 0, m_size_y = 0;
+	float m_x_min = 0, m_y_min = 0, m_resolution = 0;
+	float m_occupiedThreshold = 0.5f;
+	float m_maxDistance = 0;
+	int32_t m_maxSqDist = SQDIST_INF;
+
+	std::vector<TCell> m_cells;
+	std::vector<int32_t> m_addList, m_removeList;
+	/** Min-queue of (sqdist, cell index) */
+	std::priority_queue<
+		std::pair<int32_t, int32_t>, std::vector<std::pair<int32_t, int32_t>>,
+		std::greater<std::pair<int32_t, int32_t>>>
+		m_open;
+	size_t m_lastUpdatedCells = 0;
+
+	int idx(int cx, int cy) const { return cx + cy * m_size_x; }
+	bool isOccupied(int32_t i) const { return m_cells[i].obst == i; }
+	bool gridCellIsObstacle(
+		const COccupancyGridMap2D& grid, int cx, int cy) const;
+	bool sameGeometry(const COccupancyGridMap2D& grid) const;
+};
+
+}  // namespace mrpt::maps
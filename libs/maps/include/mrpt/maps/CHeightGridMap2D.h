@@ -120,6 +120,12 @@ class CHeightGridMap2D
 		 * the robot for this filter. */
 		float z_min{-0.5}, z_max{0.5};
 
+		/** (Default: 1) Threads used by insertPoints() (0: as many as
+		 * hardware threads). Only large batches of points are inserted in
+		 * parallel, and the result does not depend on the number of threads.
+		 */
+		unsigned int numThreads{1};
+
 		mrpt::img::TColormap colorMap{mrpt::img::cmJET};
 	} insertionOptions;
 
@@ -150,6 +156,15 @@ class CHeightGridMap2D
 		const double x, const double y, const double z,
 		const CHeightGridMap2D_Base::TPointInsertParams& params =
 			CHeightGridMap2D_Base::TPointInsertParams()) override;
+
+	/** See base class docs. If insertionOptions.numThreads is not 1, the
+	 * cell of each point is computed in parallel, then each thread updates
+	 * the cells in one range of the grid, keeping the order of the points.
+	 */
+	size_t insertPoints(
+		const mrpt::math::TPointCloudView& pts,
+		const TPointInsertParams& params = TPointInsertParams()) override;
+
 	double dem_get_resolution() const override;
 	size_t dem_get_size_x() const override;
 	size_t dem_get_size_y() const override;
@@ -194,6 +209,15 @@ namespace global_settings
  */
 void HEIGHTGRIDMAP_EXPORT3D_AS_MESH(bool value);
 bool HEIGHTGRIDMAP_EXPORT3D_AS_MESH();
+
+/** When exported as a mesh (see HEIGHTGRIDMAP_EXPORT3D_AS_MESH),
+ * mrpt::maps::CHeightGridMap2D with at least this number of cells (default:
+ * 1,000,000) are exported as a opengl::CTerrainMesh, with level of detail
+ * rendering, instead of a opengl::CMesh. 0 means always.
+ *  \note (New in MRPT 2.4.9)
+ */
+void HEIGHTGRIDMAP_EXPORT3D_LOD_MIN_CELLS(size_t cells);
+size_t HEIGHTGRIDMAP_EXPORT3D_LOD_MIN_CELLS();
 }  // namespace global_settings
 }  // namespace mrpt
 
@@ -11,6 +11,7 @@
 
 #include <mrpt/math/TLine3D.h>
 #include <mrpt/math/TObject3D.h>
+#include <mrpt/math/TPointCloudView.h>
 #include <mrpt/obs/CObservation.h>
 #include <mrpt/poses/CPose3D.h>
 
@@ -59,6 +60,17 @@ class CHeightGridMap2D_Base
 		const double x, const double y, const double z,
 		const TPointInsertParams& params = TPointInsertParams()) = 0;
 
+	/** Update the DEM with a batch of points. The default implementation
+	 * calls insertIndividualPoint() for each point, and dem_update_map() at
+	 * the end if `params.update_map_after_insertion`. Derived classes may
+	 * insert them faster.
+	 * \return The number of points within the map bounds.
+	 * \note (New in MRPT 2.4.9)
+	 */
+	virtual size_t insertPoints(
+		const mrpt::math::TPointCloudView& pts,
+		const TPointInsertParams& params = TPointInsertParams());
+
 	virtual double dem_get_resolution() const = 0;
 	virtual size_t dem_get_size_x() const = 0;
 	virtual size_t dem_get_size_y() const = 0;
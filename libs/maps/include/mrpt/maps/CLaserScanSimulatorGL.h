@@ -0,0 +1,92 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/obs/CObservation2DRangeScan.h>
+#include <mrpt/poses/CPose2D.h>
+
+#include <memory>
+#include <vector>
+
+namespace mrpt::maps
+{
+class COccupancyGridMap2D;
+
+/** GPU-based 2D laser scan simulator for occupancy grid maps, using off-screen
+ * OpenGL rendering (mrpt::opengl::CFBORender).
+ *
+ * Occupied cells of the grid are converted once into a mesh of vertical walls.
+ * Then, each call to simulate() renders the depth of many scans from many
+ * poses in a single render pass: each (pose, angular sector) pair is a tiny
+ * viewport of one shared off-screen framebuffer, and all ranges are read back
+ * with one transfer. Scans with an aperture larger than 90 degrees are
+ * split into several sectors, each one rendered by its own pinhole camera.
+ *
+ * Compared to COccupancyGridMap2D::laserScanSimulator(), ranges are computed
+ * against the exact cell borders instead of ray-marching with steps of
+ * COccupancyGridMap2D::RAYTRACE_STEP_SIZE_IN_CELL_UNITS, so differences of up
+ * to one cell size are expected. Beams leaving the map or not hitting any
+ * occupied cell within range are marked as invalid, with range=maxRange.
+ *
+ * The grid map contents are copied upon construction: create a new object if
+ * the map changes.
+ *
+ * \code
+ * CLaserScanSimulatorGL sim(grid);
+ * std::vector<CObservation2DRangeScan> scans;
+ * sim.simulate(poses, scanTemplate, scans);
+ * \endcode
+ *
+ * \note Requires MRPT built with OpenGL and EGL support. See IsAvailable().
+ * \sa COccupancyGridMap2D::laserScanSimulatorBatch()
+ * \note (New in MRPT 2.4.9)
+ * \ingroup mrpt_maps_grp
+ */
+class CLaserScanSimulatorGL
+{
+   public:
+	/** Builds the 3D wall mesh from the grid cells with an occupancy
+	 * probability >= `threshold`.
+	 * \exception std::exception If off-screen rendering is not available. */
+	CLaserScanSimulatorGL(
+		const COccupancyGridMap2D& grid, float threshold = 0.6f);
+	~CLaserScanSimulatorGL();
+
+	CLaserScanSimulatorGL(const CLaserScanSimulatorGL&) = delete;
+	CLaserScanSimulatorGL& operator=(const CLaserScanSimulatorGL&) = delete;
+
+	/** Return false if MRPT was built without off-screen rendering support
+	 * (even if true, creating a context may still fail at runtime, e.g. if
+	 * there is no GPU driver) */
+	static bool IsAvailable();
+
+	/** Maximum number of poses rendered together in each pass (Default=256).
+	 */
+	size_t maxPosesPerPass = 256;
+
+	/** Number of image columns rendered per simulated beam (Default=2) */
+	unsigned int pixelsPerBeam = 2;
+
+	/** Simulates one scan per robot pose. Scan parameters (aperture,
+	 * maxRange, sensorPose, rightToLeft, ...) are taken from `scanTemplate`.
+	 * \param[in] N Number of rays per scan.
+	 * \param[in] noiseStd Optional Gaussian noise added to valid ranges.
+	 */
+	void simulate(
+		const std::vector<mrpt::poses::CPose2D>& robotPoses,
+		const mrpt::obs::CObservation2DRangeScan& scanTemplate,
+		std::vector<mrpt::obs::CObservation2DRangeScan>& outScans,
+		size_t N = 361, float noiseStd = 0);
+
+   private:
+	struct Impl;
+	std::unique_ptr<Impl> m_impl;
+};
+
+}  // namespace mrpt::maps
@@ -9,9 +9,14 @@
 
 #pragma once
 
+#include <mrpt/core/exceptions.h>
 #include <mrpt/maps/CLogOddsGridMapLUT.h>
 #include <mrpt/maps/logoddscell_traits.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
 namespace mrpt::maps
 {
 /** A generic provider of log-odds grid-map maintainance functions.
@@ -108,6 +113,125 @@ struct CLogOddsGridMap2D : public detail::logoddscell_traits<TCELL>
 			*theCell = traits_t::CELLTYPE_MAX;
 	}
 
+	/** Adds the log-odds increments `delta` to `n` consecutive cells, with
+	 * saturation to [CELLTYPE_MIN,CELLTYPE_MAX]. Uses SSE2 or NEON saturating
+	 * additions, if available.
+	 * \note (New in MRPT 2.4.9) */
+	static void updateCells_fast_delta(
+		cell_t* cells, const int32_t* delta, size_t n);
+
+	/** One ray for updateCells_batch(), given as a beam footprint (see
+	 * CBeamFootprintCache): the cells (dx[i],dy[i]), i<nFree, relative to the
+	 * sensor cell, are updated as free, and (hit_dx,hit_dy) as occupied if
+	 * `hit` is true. */
+	struct TBatchRay
+	{
+		const int16_t *dx = nullptr, *dy = nullptr;
+		int32_t nFree = 0;
+		cell_t logodd_free = 0;
+		bool hit = false;
+		int hit_dx = 0, hit_dy = 0;
+		/** Subtracted from the occupied cell (as in updateCell_fast_occupied)
+		 */
+		cell_t logodd_occupied = 0;
+	};
+
+	/** Inserts a batch of rays from a sensor in cell (cx0,cy0). Updates of all
+	 * rays are first accumulated for each cell, then added to the map with
+	 * updateCells_fast_delta(), so each cell saturates once per batch instead
+	 * of once per update.
+	 *
+	 * \param scratch A buffer which must be all zeros, and which is left
+	 * filled with zeros, to be reused between calls.
+	 * \exception std::exception If any ray goes out of the map.
+	 * \note (New in MRPT 2.4.9) */
+	static void updateCells_batch(
+		cell_t* mapArray, const unsigned size_x, const unsigned size_y,
+		const int cx0, const int cy0, const std::vector<TBatchRay>& rays,
+		std::vector<int32_t>& scratch);
+
 };	// end of CLogOddsGridMap2D
 
+// Implemented in CLogOddsGridMap2D.cpp (SSE2/NEON):
+template <>
+void CLogOddsGridMap2D<int8_t>::updateCells_fast_delta(
+	int8_t* cells, const int32_t* delta, size_t n);
+template <>
+void CLogOddsGridMap2D<int16_t>::updateCells_fast_delta(
+	int16_t* cells, const int32_t* delta, size_t n);
+
+template <typename TCELL>
+void CLogOddsGridMap2D<TCELL>::updateCells_batch(
+	cell_t* mapArray, const unsigned size_x, const unsigned size_y,
+	const int cx0, const int cy0, const std::vector<TBatchRay>& rays,
+	std::vector<int32_t>& scratch)
+{
+	if (rays.empty()) return;
+
+	// Window of modified cells. Footprints are monotonic in x and y, so the
+	// first and last cells of each ray bound it:
+	int wx0 = 0, wx1 = 0, wy0 = 0, wy1 = 0;
+	const auto grow = [&](int dx, int dy) {
+		wx0 = std::min(wx0, dx);
+		wx1 = std::max(wx1, dx);
+		wy0 = std::min(wy0, dy);
+		wy1 = std::max(wy1, dy);
+	};
+	for (const auto& r : rays)
+	{
+		if (r.nFree > 0) grow(r.dx[r.nFree - 1], r.dy[r.nFree - 1]);
+		if (r.hit) grow(r.hit_dx, r.hit_dy);
+	}
+	ASSERT_(
+		cx0 + wx0 >= 0 && cy0 + wy0 >= 0 &&
+		static_cast<unsigned>(cx0 + wx1) < size_x &&
+		static_cast<unsigned>(cy0 + wy1) < size_y);
+
+	const int W = wx1 - wx0 + 1, H = wy1 - wy0 + 1;
+	if (scratch.size() < static_cast<size_t>(W) * H)
+		scratch.resize(static_cast<size_t>(W) * H, 0);
+	const int base = -wx0 - wy0 * W;
+
+	// Accumulate, and keep the range of modified columns in each row:
+	std::vector<int> rowMin(H, W), rowMax(H, -1);
+	const auto markRows = [&](int dx0, int dx1, int dy0, int dy1) {
+		if (dx0 > dx1) std::swap(dx0, dx1);
+		if (dy0 > dy1) std::swap(dy0, dy1);
+		for (int dy = dy0; dy <= dy1; dy++)
+		{
+			int& r0 = rowMin[dy - wy0];
+			int& r1 = rowMax[dy - wy0];
+			r0 = std::min(r0, dx0 - wx0);
+			r1 = std::max(r1, dx1 - wx0);
+		}
+	};
+	for (const auto& r : rays)
+	{
+		if (r.nFree > 0)
+		{
+			const int32_t lf = r.logodd_free;
+			for (int32_t k = 0; k < r.nFree; k++)
+				scratch[base + r.dx[k] + r.dy[k] * W] += lf;
+			markRows(0, r.dx[r.nFree - 1], 0, r.dy[r.nFree - 1]);
+		}
+		if (r.hit)
+		{
+			scratch[base + r.hit_dx + r.hit_dy * W] -= r.logodd_occupied;
+			markRows(r.hit_dx, r.hit_dx, r.hit_dy, r.hit_dy);
+		}
+	}
+
+	// Apply to the map, row by row, and leave the scratch buffer zeroed:
+	for (int row = 0; row < H; row++)
+	{
+		if (rowMax[row] < rowMin[row]) continue;
+		const size_t len = rowMax[row] - rowMin[row] + 1;
+		int32_t* d = &scratch[row * W + rowMin[row]];
+		cell_t* cells = mapArray + (cx0 + wx0 + rowMin[row]) +
+			static_cast<size_t>(cy0 + wy0 + row) * size_x;
+		updateCells_fast_delta(cells, d, len);
+		std::fill(d, d + len, 0);
+	}
+}
+
 }  // namespace mrpt::maps
@@ -9,6 +9,7 @@
 #pragma once
 
 #include <mrpt/config/CLoadableOptions.h>
+#include <mrpt/core/WorkerThreadsPool.h>
 #include <mrpt/maps/CMetricMap.h>
 #include <mrpt/obs/obs_frwds.h>
 #include <mrpt/serialization/CSerializable.h>
@@ -193,9 +194,71 @@ class CMultiMetricMap : public mrpt::maps::CMetricMap
 	/** @} */
 
 	/** Sets the list of internal map according to the passed list of map
-	 * initializers (current maps will be deleted) */
+	 * initializers (current maps will be deleted), and numThreads from
+	 * TSetOfMetricMapInitializers::numThreads */
 	void setListOfMaps(const mrpt::maps::TSetOfMetricMapInitializers& init);
 
+	/** Number of threads used to insert observations into, and to evaluate
+	 * observation likelihoods with, the internal maps concurrently (one map
+	 * per thread). 1 (default) means sequential operation, 0 means as many
+	 * threads as hardware cores.
+	 *
+	 * All maps finish processing an observation before insertObservation()
+	 * or computeObservationLikelihood() return, and the
+	 * mrpt::obs::mrptEventMetricMapInsert events of the internal maps are
+	 * still published from the calling thread, in the order of `maps`.
+	 * Entries in `maps` must be different objects for this to be safe.
+	 * This value is not serialized, and it is also copied by operator=().
+	 * \note (New in MRPT 2.4.9)
+	 */
+	unsigned int numThreads{1};
+
+	/** If true, copies of this object (copy constructor and operator=) do not
+	 * duplicate the internal maps, but share them with this object (they
+	 * are smart pointers), and the copies also have copyOnWrite=true. A map
+	 * shared with other objects is cloned the first time it is about to be
+	 * modified through this object (insertObservation(), clear()), so the
+	 * observable behavior is that of deep copies, but copying is cheap, and
+	 * maps which are never modified again are never duplicated.
+	 *
+	 * Maps modified directly (e.g. through mapByClass()) must be detached
+	 * with detachSharedMaps() before.
+	 * \note (New in MRPT 2.4.9)
+	 * \sa mrpt::maps::CMultiMetricMapPDF::TPredictionParams::copyOnWriteMaps
+	 */
+	bool copyOnWrite{false};
+
+	/** Replaces each internal map which is shared with other objects by a
+	 * copy of its own. Only needed with copyOnWrite=true.
+	 * \note (New in MRPT 2.4.9) */
+	void detachSharedMaps();
+
+	/** Like loadFromProbabilisticPosesAndObservations(), but building the
+	 * maps in parallel (using numThreads threads), for large offline
+	 * datasets. Keyframes are partitioned in square tiles of `tileSize`
+	 * meters, by their (x,y) position, and one copy of each map of the
+	 * following kinds is built per tile concurrently, then merged:
+	 *  - Points maps: concatenated, in tile order. If `pointsVoxelSize`>0,
+	 * the result is decimated with a voxel grid of that size (see
+	 * CPointCloudFilterByVoxelGrid), which removes duplicated points from
+	 * overlapping tiles.
+	 *  - COccupancyGridMap2D: log-odds added, see
+	 * COccupancyGridMap2D::mergeLogOddsFrom()
+	 *  - COctoMap and CColouredOctoMap: log-odds added, see
+	 * COctoMapBase::mergeLogOddsFrom()
+	 *
+	 * Other maps are still built from all the keyframes in order, each one
+	 * in a thread of its own. Up to the saturation of log-odds and the order
+	 * of points, the result is that of the sequential insertion. Observations
+	 * are inserted into several maps concurrently (see numThreads), and no
+	 * mrpt::obs::mrptEventMetricMapInsert event is published.
+	 * With numThreads=1, this just calls
+	 * loadFromProbabilisticPosesAndObservations().
+	 * \note (New in MRPT 2.4.9) */
+	void loadFromSimpleMapInTiles(
+		const mrpt::maps::CSimpleMap& sm, double tileSize,
+		double pointsVoxelSize = 0);
+
 	// Implementation of virtual CMetricMap methods.
 	// See docs in base class:
 
@@ -239,6 +302,11 @@ class CMultiMetricMap : public mrpt::maps::CMetricMap
 		const mrpt::obs::CObservation& obs,
 		const mrpt::poses::CPose3D& takenFrom) const override;
 
+   private:
+	/** Pool for numThreads!=1, created upon first use */
+	mutable std::shared_ptr<mrpt::WorkerThreadsPool> m_threadPool;
+	mrpt::WorkerThreadsPool& threadPool() const;
+
 };	// End of class def.
 
 }  // namespace mrpt::maps
@@ -12,10 +12,12 @@
 #include <mrpt/containers/CDynamicGrid.h>
 #include <mrpt/core/safe_pointers.h>
 #include <mrpt/img/CImage.h>
+#include <mrpt/maps/CBeamFootprintCache.h>
 #include <mrpt/maps/CLogOddsGridMap2D.h>
 #include <mrpt/maps/CLogOddsGridMapLUT.h>
 #include <mrpt/maps/CMetricMap.h>
 #include <mrpt/maps/OccupancyGridCellType.h>
+#include <mrpt/math/TPose2D.h>
 #include <mrpt/obs/CObservation2DRangeScanWithUncertainty.h>
 #include <mrpt/obs/obs_frwds.h>
 #include <mrpt/poses/CPosePDFGaussian.h>
@@ -24,6 +26,8 @@
 #include <mrpt/tfest/TMatchingPair.h>
 #include <mrpt/typemeta/TEnumType.h>
 
+#include <array>
+
 namespace mrpt::maps
 {
 /** A class for storing an occupancy grid map.
@@ -93,7 +97,33 @@ class COccupancyGridMap2D
 	 * likelihood values for LF method among others, at a high cost in memory
 	 * (see TLikelihoodOptions::enableLikelihoodCache). */
 	mutable std::vector<double> precomputedLikelihood;
+	/** The cache, if TLikelihoodOptions::LF_compactCache is enabled: an index
+	 * into m_LF_lut per cell, or LF_COMPACT_INVALID if not computed yet. */
+	mutable std::vector<uint16_t> m_compactLikelihood;
+	static constexpr uint16_t LF_COMPACT_INVALID = 0xFFFF;
+	/** Likelihood values for each squared distance [cells^2] from a cell to
+	 * its closest obstacle, up to the last entry, for all the cells with no
+	 * obstacles within LF_maxCorrsDistance. Empty if the compact cache is
+	 * not in use. */
+	mutable std::vector<double> m_LF_lut;
+	/** The parameters used to build m_LF_lut */
+	mutable std::array<double, 8> m_LF_lutParams{};
 	mutable bool m_likelihoodCacheOutDated{true};
+	/** Rectangle of cells modified since the cache was last updated, if
+	 * m_likelihoodCacheOutDated=false (empty if x1<x0).
+	 * \sa markLikelihoodCacheDirty() */
+	mutable int m_lfDirty_x0{0}, m_lfDirty_y0{0}, m_lfDirty_x1{-1},
+		m_lfDirty_y1{-1};
+
+	/** \sa getMapVersion(), newMapVersion() */
+	mutable uint64_t m_mapVersion{0};
+	/** Assigns a new, unique, value to m_mapVersion */
+	void newMapVersion() const;
+
+	/** Beam footprints and buffers for TInsertionOptions::batchInsertion */
+	CBeamFootprintCache m_beamFootprints;
+	std::vector<TBatchRay> m_batchRays;
+	std::vector<int32_t> m_batchScratch;
 
 	/** Used for Voronoi calculation.Same struct as "map", but contains a "0" if
 	 * not a basis point. */
@@ -173,6 +203,18 @@ class COccupancyGridMap2D
 	double computeObservationLikelihood_likelihoodField_Thrun(
 		const mrpt::obs::CObservation& obs,
 		const mrpt::poses::CPose2D& takenFrom) const;
+	/** Used by computeLikelihoodField_Thrun() and
+	 * computeLikelihoodFieldBatch(): returns the likelihood value for a point
+	 * falling into cell (cx,cy), which must be within the map limits, using or
+	 * filling the likelihood cache, if enabled. \sa
+	 * likelihoodField_Thrun_resetCacheIfOutdated() */
+	double likelihoodField_Thrun_cell(const int cx, const int cy) const;
+	/** Used by likelihoodField_Thrun_cell(): squared distance from cell
+	 * (cx,cy) to its closest obstacle, in units of (resolution/10)^2, and
+	 * saturated to LF_maxCorrsDistance. */
+	unsigned int likelihoodField_Thrun_minDist(const int cx, const int cy) const;
+	/** Reset the precomputed likelihood values map, if it is outdated */
+	void likelihoodField_Thrun_resetCacheIfOutdated() const;
 	/** One of the methods that can be selected for implementing
 	 * "computeObservationLikelihood". */
 	double computeObservationLikelihood_likelihoodField_II(
@@ -208,6 +250,15 @@ class COccupancyGridMap2D
 	 * updateInfoChangeOnly, updateCell_fast_occupied, updateCell_fast_free */
 	void updateCell(int x, int y, float v);
 
+	/** Adds the log-odds of all the cells of another grid map, of the same
+	 * resolution, to the cells of this one at the same coordinates
+	 * (saturating as updateCell() does), growing this map if needed to cover
+	 * `other`. This fuses maps built from disjoint sets of observations into
+	 * (up to saturation) the map built from all of them.
+	 * \sa mrpt::maps::CMultiMetricMap::loadFromSimpleMapInTiles()
+	 * \note (New in MRPT 2.4.9) */
+	void mergeLogOddsFrom(const COccupancyGridMap2D& other);
+
 	/** An internal structure for storing data related to counting the new
 	 * information apported by some observation */
 	struct TUpdateCellsInfoChangeOnly
@@ -523,6 +574,16 @@ class COccupancyGridMap2D
 		/** Enabled: Rays widen with distance to approximate the real behavior
 		 * of lasers, disabled: insert rays as simple lines (Default=false) */
 		bool wideningBeamsWithDistance{false};
+		/** Enabled: 2D scans inserted as simple rays
+		 * (wideningBeamsWithDistance=false) are rasterized with cached beam
+		 * footprints (see CBeamFootprintCache), and all their updates are
+		 * accumulated and then applied with saturating SIMD additions
+		 * (CLogOddsGridMap2D::updateCells_batch()). Beam directions are
+		 * quantized to 1/4 of the angular step between beams, and cells
+		 * saturate once per scan instead of once per ray, so results may
+		 * slightly differ from the default method. (Default=false)
+		 * \note (New in MRPT 2.4.9) */
+		bool batchInsertion{false};
 	};
 
 	/** With this struct options are provided to the observation insertion
@@ -622,6 +683,16 @@ class COccupancyGridMap2D
 		/** Enables the usage of a cache of likelihood values (for LF methods),
 		 * if set to true (default=false). */
 		bool enableLikelihoodCache{true};
+		/** [LikelihoodField] If enableLikelihoodCache is set, store in the
+		 * cache a 16-bit index per cell, standing for the squared distance to
+		 * its closest obstacle, and compute the likelihood from a lookup
+		 * table built from LF_stdHit and the rest of LF parameters. Results
+		 * are identical, with a 4x smaller cache than the default `double`
+		 * values, hence less memory and better CPU cache usage for large
+		 * maps. Ignored (the default cache is used) if LF_maxCorrsDistance is
+		 * larger than 255 cells.
+		 * \note (New in MRPT 2.4.9) */
+		bool LF_compactCache{false};
 	} likelihoodOptions;
 
 	/** Auxiliary private class. */
@@ -664,7 +735,8 @@ class COccupancyGridMap2D
 	 * \param x2 Right coordinate of area to be computed. Default, entire map.
 	 * \param y1 Top coordinate of area to be computed. Default, entire map.
 	 * \param y2 Bottom coordinate of area to be computed. Default, entire map.
-	 * \sa findCriticalPoints
+	 * \sa findCriticalPoints, CDynamicVoronoiMap2D for a distance map and
+	 * Voronoi diagram which can be updated incrementally.
 	 */
 	void buildVoronoiDiagram(
 		float threshold, float robot_size, int x1 = 0, int x2 = 0, int y1 = 0,
@@ -792,6 +864,35 @@ class COccupancyGridMap2D
 		size_t N = 361, float noiseStd = 0, unsigned int decimation = 1,
 		float angleNoiseStd = mrpt::DEG2RAD(.0)) const;
 
+	/** Backends for laserScanSimulatorBatch() */
+	enum class TLaserSimulBackend : uint8_t
+	{
+		/** Ray-marching in the CPU, as in laserScanSimulator() */
+		CPU = 0,
+		/** Off-screen OpenGL depth rendering via CLaserScanSimulatorGL. Falls
+		   back to CPU if not available. */
+		OpenGL
+	};
+
+	/** Simulates one laser scan per robot pose, with the scan parameters
+	 * (aperture, maxRange, sensorPose,...) taken from `scanTemplate`.
+	 * With the OpenGL backend, all poses are rendered in a few GPU passes; if
+	 * off-screen rendering is not available in this build or cannot be
+	 * initialized at runtime, the CPU backend is used instead.
+	 *
+	 * For repeated calls against the same map, using CLaserScanSimulatorGL
+	 * directly avoids rebuilding its wall mesh each time.
+	 *
+	 * \sa laserScanSimulator(), CLaserScanSimulatorGL
+	 * \note (New in MRPT 2.4.9)
+	 */
+	void laserScanSimulatorBatch(
+		const std::vector<mrpt::poses::CPose2D>& robotPoses,
+		const mrpt::obs::CObservation2DRangeScan& scanTemplate,
+		std::vector<mrpt::obs::CObservation2DRangeScan>& outScans,
+		float threshold = 0.6f, size_t N = 361, float noiseStd = 0,
+		TLaserSimulBackend backend = TLaserSimulBackend::CPU) const;
+
 	/** Simulates the observations of a sonar rig into the current grid map.
 	 *   The simulated ranges are stored in a CObservationRange object, which is
 	 * also used
@@ -930,6 +1031,72 @@ class COccupancyGridMap2D
 		const CPointsMap* pm,
 		const mrpt::poses::CPose2D* relativePose = nullptr) const;
 
+	/** Evaluates the likelihood field ("Thrun" method) of one set of points
+	 * under many candidate poses at once. It is equivalent to (but much faster
+	 * than) calling computeLikelihoodField_Thrun() for each pose:
+	 * coordinate transformation and cell indexing are vectorized (SSE2, if
+	 * available) using single-precision math, so results may differ
+	 * slightly from the sequential version for points lying on cell borders.
+	 *
+	 * \param pm The points map, in local coordinates (e.g. robot frame).
+	 * \param poses The candidate poses of the points map in this map's
+	 * coordinates.
+	 * \param out_log_lik Output log-likelihood values, one per pose.
+	 *  See "likelihoodOptions" for configuration parameters.
+	 * \note (New in MRPT 2.4.9)
+	 */
+	void computeLikelihoodFieldBatch(
+		const CPointsMap& pm, const std::vector<mrpt::math::TPose2D>& poses,
+		std::vector<double>& out_log_lik) const;
+
+	/** \overload Evaluates a 2D laser scan, built into a point cloud in the
+	 * same way than computeObservationLikelihood() does for the
+	 * lmLikelihoodField_Thrun method. Here, `poses` are robot poses.
+	 * Non-planar scans return -10 for all poses.
+	 */
+	void computeLikelihoodFieldBatch(
+		const mrpt::obs::CObservation2DRangeScan& scan,
+		const std::vector<mrpt::math::TPose2D>& poses,
+		std::vector<double>& out_log_lik) const;
+
+	/** Marks the cells in the rectangle [cx0,cx1]x[cy0,cy1] (cell indices,
+	 * inclusive) as modified, so only the cached likelihood-field values
+	 * within TLikelihoodOptions::LF_maxCorrsDistance of them are recomputed
+	 * the next time they are needed, instead of the whole cache (see
+	 * TLikelihoodOptions::enableLikelihoodCache).
+	 * internal_insertObservation() calls it with the area covered by each
+	 * scan. Call it after editing cells with setCell(), updateCell() or
+	 * getRow(), which do not track changes.
+	 * It also changes getMapVersion().
+	 * \sa invalidateLikelihoodCache
+	 * \note (New in MRPT 2.4.9) */
+	void markLikelihoodCacheDirty(int cx0, int cy0, int cx1, int cy1) const;
+
+	/** Marks the whole likelihood-field cache as outdated.
+	 * It also changes getMapVersion().
+	 * \sa markLikelihoodCacheDirty
+	 * \note (New in MRPT 2.4.9) */
+	void invalidateLikelihoodCache() const;
+
+	/** Fills the whole likelihood-field cache (if
+	 * TLikelihoodOptions::enableLikelihoodCache is set), which is otherwise
+	 * filled lazily as cells are evaluated. Afterwards, and until the map or
+	 * its likelihoodOptions are modified, likelihood-field evaluations only
+	 * read the map, so they can run concurrently from several threads on the
+	 * same map object.
+	 * \note (New in MRPT 2.4.9) */
+	void precomputeLikelihoodCache() const;
+
+	/** An identifier of the current contents of the map, which changes with
+	 * every tracked modification (insertions, clear(), resizing, loading,
+	 * markLikelihoodCacheDirty(), invalidateLikelihoodCache()). Versions are
+	 * unique among all the grid map objects, except for copies of a map,
+	 * which keep the version of the original until they are modified. It can
+	 * be used as a key of caches of data computed from the maps (see
+	 * mrpt::slam::COccupancyGridMapFeatureExtractor).
+	 * \note (New in MRPT 2.4.9) */
+	uint64_t getMapVersion() const { return m_mapVersion; }
+
 	/** Computes the likelihood [0,1] of a set of points, given the current grid
 	 * map as reference.
 	 * \param pm The points map
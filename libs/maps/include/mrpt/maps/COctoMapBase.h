@@ -85,6 +85,8 @@ class COctoMapBase : public mrpt::maps::CMetricMap
 			// Copy all but the m_parent pointer!
 			maxrange = o.maxrange;
 			pruning = o.pruning;
+			numThreads = o.numThreads;
+			insertDiscretized = o.insertDiscretized;
 			const bool o_has_parent = o.m_parent.get() != nullptr;
 			setOccupancyThres(
 				o_has_parent ? o.getOccupancyThres() : o.occupancyThres);
@@ -109,6 +111,21 @@ class COctoMapBase : public mrpt::maps::CMetricMap
 		bool pruning{true};	 //!< whether the tree is (losslessly) pruned after
 		//! insertion (default: true)
 
+		/** Number of threads used to trace the rays of each point cloud or
+		 * observation: rays are split among threads, each one collecting its
+		 * own free and occupied voxel keys, which are then merged and applied
+		 * to the tree in one single pass. 1 (default) keeps the serial
+		 * octomap insertion; 0 means one thread per hardware core.
+		 * \note (New in MRPT 2.4.9) */
+		unsigned int numThreads{1};
+
+		/** If true, points falling into the same voxel are inserted only
+		 * once, by tracing a single ray to the voxel center. Much faster for
+		 * dense clouds, at the cost of slightly different free space.
+		 * (Default: false)
+		 * \note (New in MRPT 2.4.9) */
+		bool insertDiscretized{false};
+
 		/// (key name in .ini files: "occupancyThres") sets the threshold for
 		/// occupancy (sensor model) (Default=0.5)
 		void setOccupancyThres(double prob)
@@ -304,6 +321,28 @@ class COctoMapBase : public mrpt::maps::CMetricMap
 	virtual void getAsOctoMapVoxels(
 		mrpt::opengl::COctoMapVoxels& gl_obj) const = 0;
 
+	/** Like getAsOctoMapVoxels(), but only regenerating the voxels in the
+	 * regions of the map modified since the last call with the same object.
+	 * Everything is regenerated in the first call, or if the rendering options
+	 * or the visualization mode or color of `gl_obj` changed since then.
+	 *
+	 * Modified regions are those updated by observation insertions, and those
+	 * whose occupancy state changed through octomap's API (see getOctomap()),
+	 * reported by octomap change detection, which is enabled by this method.
+	 *
+	 * Voxels are organized in groups (see
+	 * mrpt::opengl::COctoMapVoxels::setVoxelGroup()), one per cubic block of
+	 * 16x16x16 leaves, and leaves larger than a block are drawn as one cube
+	 * per block. Voxels are not sorted by height. Grid lines are not
+	 * generated incrementally: if TRenderingOptions::generateGridLines is
+	 * set, this just calls getAsOctoMapVoxels().
+	 *
+	 * Only one COctoMapVoxels object can be kept updated from each map.
+	 * \sa renderingOptions
+	 * \note (New in MRPT 2.4.9)
+	 */
+	void updateOctoMapVoxels(mrpt::opengl::COctoMapVoxels& gl_obj);
+
 	/** Get the occupancy probability [0,1] of a point
 	 * \return false if the point is not mapped, in which case the returned
 	 * "prob" is undefined. */
@@ -322,6 +361,16 @@ class COctoMapBase : public mrpt::maps::CMetricMap
 		const CPointsMap& ptMap, const float sensor_x, const float sensor_y,
 		const float sensor_z);
 
+	/** Adds the occupancy log-odds of all the voxels of another octomap, of
+	 * the same resolution, to the voxels of this one (clamped as regular
+	 * updates are, see TInsertionOptions::clampingThresMin). This fuses maps
+	 * built from disjoint sets of observations into (up to clamping) the map
+	 * built from all of them. Derived classes also merge voxel contents
+	 * (e.g. colors in CColouredOctoMap).
+	 * \sa mrpt::maps::CMultiMetricMap::loadFromSimpleMapInTiles()
+	 * \note (New in MRPT 2.4.9) */
+	void mergeLogOddsFrom(const myself_t& other);
+
 	/** Performs raycasting in 3d, similar to computeRay().
 	 *
 	 * A ray is cast from origin with a given direction, the first occupied
@@ -375,6 +424,49 @@ class COctoMapBase : public mrpt::maps::CMetricMap
 		const std::optional<const mrpt::poses::CPose3D>& robotPose,
 		octomap_point3d& sensorPt, octomap_pointcloud& scan) const;
 
+	/** Computes the sets of free and occupied voxel keys for a point cloud,
+	 * observing insertionOptions (maxrange, numThreads, insertDiscretized).
+	 * Keys in `occupied_cells` are never in `free_cells`. */
+	template <
+		class octomap_point3d, class octomap_pointcloud, class octomap_keyset>
+	void internal_computeScanUpdate(
+		const octomap_point3d& sensorPt, const octomap_pointcloud& scan,
+		octomap_keyset& free_cells, octomap_keyset& occupied_cells) const;
+
+	/** Integrates a point cloud into the tree, observing insertionOptions.
+	 * With a single thread, it just calls octomap's insertPointCloud() */
+	template <class octomap_point3d, class octomap_pointcloud>
+	void internal_insertScan(
+		const octomap_point3d& sensorPt, const octomap_pointcloud& scan);
+
+	/** Marks the block of a voxel key as modified, for updateOctoMapVoxels()
+	 */
+	template <class octomap_key>
+	void internal_markModifiedVoxel(const octomap_key& key);
+
+	/** Marks the blocks of the voxels along a ray as modified */
+	template <class octomap_point3d>
+	void internal_markModifiedRay(
+		const octomap_point3d& origin, const octomap_point3d& end);
+
+	/** The color of a leaf voxel centered at height `z`, for the
+	 * visualization mode and color of `gl_obj`. `zmin` and `inv_dz` are the
+	 * minimum height and the inverse of the height range of the map.
+	 * By default, colors depend on the occupancy. */
+	virtual mrpt::img::TColor internal_getVoxelColor(
+		const octree_node_t& node, double z, double zmin, double inv_dz,
+		const mrpt::opengl::COctoMapVoxels& gl_obj) const;
+
+	/** Called by mergeLogOddsFrom() for each leaf of the other map, given
+	 * its node and the center of each voxel of this map it covers, to merge
+	 * other contents than the occupancy. Does nothing by default. */
+	virtual void internal_mergeVoxelData(
+		[[maybe_unused]] const octree_node_t& otherNode,
+		[[maybe_unused]] double x, [[maybe_unused]] double y,
+		[[maybe_unused]] double z)
+	{
+	}
+
 	struct Impl;
 
 	mrpt::pimpl<Impl> m_impl;
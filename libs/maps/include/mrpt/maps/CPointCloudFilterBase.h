@@ -8,6 +8,7 @@
    +------------------------------------------------------------------------+ */
 #pragma once
 
+#include <mrpt/math/TPointCloudView.h>
 #include <mrpt/system/datetime.h>
 
 #include <memory>
@@ -63,6 +64,18 @@ class CPointCloudFilterBase
 		const mrpt::poses::CPose3D& pc_reference_pose,
 		/** [in,out] additional in/out parameters */
 		TExtraFilterParams* params = nullptr) = 0;
+
+	/** Runs the filter on a read-only, non-owning point cloud view, and
+	 * returns in `out_deletion_mask` the points that would be removed.
+	 * The default implementation copies the points into a temporary
+	 * CSimplePointsMap and calls filter(); derived classes may override it
+	 * to work directly on the view.
+	 * \note (New in MRPT 2.4.9) */
+	virtual void filter(
+		const mrpt::math::TPointCloudView& pointcloud,
+		const mrpt::system::TTimeStamp pc_timestamp,
+		const mrpt::poses::CPose3D& pc_reference_pose,
+		std::vector<bool>& out_deletion_mask);
 };
 }  // namespace maps
 }  // namespace mrpt
@@ -27,6 +27,8 @@ namespace mrpt::maps
 class CPointCloudFilterByDistance : public mrpt::maps::CPointCloudFilterBase
 {
    public:
+	using CPointCloudFilterBase::filter;
+
 	// See base docs
 	void filter(
 		/** [in,out] The input pointcloud, which will be modified upon
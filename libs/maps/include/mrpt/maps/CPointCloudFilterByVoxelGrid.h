@@ -0,0 +1,103 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/config/CLoadableOptions.h>
+#include <mrpt/maps/CPointCloudFilterBase.h>
+#include <mrpt/typemeta/TEnumType.h>
+
+#include <cstdint>
+
+namespace mrpt::maps
+{
+/** Voxel-grid downsampling of point clouds: space is divided into cubic voxels
+ * of side `options.voxel_size` and only one point is kept per occupied voxel.
+ *
+ * Voxels are stored in a hash table indexed by their (x,y,z) integer
+ * coordinates, so the cost is linear in the number of points, no matter the
+ * extension of the point cloud. Two methods are available to select the
+ * point kept in each voxel (see TVoxelGridMethod):
+ *  - vgFirstPoint: The first point (in the input order) falling into each
+ * voxel. This is the fastest method (one single pass).
+ *  - vgApproxCentroid: The input point closest to the centroid of all points
+ * within the voxel. This approximates a centroid voxel filter, while keeping
+ * actual sensor points (and all their fields, e.g. color or intensity).
+ *
+ * In both cases, the relative order of the kept points is preserved.
+ * Voxels are defined in the frame of the input point cloud, that is,
+ * `pc_reference_pose` is ignored. Points with non-finite coordinates are
+ * always removed.
+ *
+ * If `options.numThreads` is not 1, points are hashed in parallel, then each
+ * thread processes the voxels of one partition of the hash key space, so the
+ * result is identical to the single-threaded one.
+ *
+ * \sa CPointsMap::TInsertionOptions::voxelFilterSize
+ * \note (New in MRPT 2.4.9)
+ * \ingroup mrpt_maps_grp
+ */
+class CPointCloudFilterByVoxelGrid : public mrpt::maps::CPointCloudFilterBase
+{
+   public:
+	/** Selects the point kept in each voxel. See CPointCloudFilterByVoxelGrid
+	 */
+	enum TVoxelGridMethod : uint8_t
+	{
+		vgFirstPoint = 0,
+		vgApproxCentroid
+	};
+
+	// See base docs
+	void filter(
+		mrpt::maps::CPointsMap* inout_pointcloud,
+		const mrpt::system::TTimeStamp pc_timestamp,
+		const mrpt::poses::CPose3D& pc_reference_pose,
+		TExtraFilterParams* params = nullptr) override;
+
+	// See base docs. Works directly on the view, without copying it.
+	void filter(
+		const mrpt::math::TPointCloudView& pointcloud,
+		const mrpt::system::TTimeStamp pc_timestamp,
+		const mrpt::poses::CPose3D& pc_reference_pose,
+		std::vector<bool>& out_deletion_mask) override;
+
+	/** Computes the points to be removed from a point cloud, without the need
+	 * of a timestamp or pose.
+	 * \return The number of kept points. */
+	size_t computeDeletionMask(
+		const mrpt::math::TPointCloudView& pointcloud,
+		std::vector<bool>& out_deletion_mask) const;
+
+	struct TOptions : public mrpt::config::CLoadableOptions
+	{
+		/** (Default: 0.10 m) Side length of each voxel */
+		double voxel_size{0.10};
+		/** (Default: vgFirstPoint) */
+		TVoxelGridMethod method{vgFirstPoint};
+		/** (Default: 1) Number of threads (0: as many as hardware threads).
+		 * Only point clouds with many points are processed in parallel. */
+		unsigned int numThreads{1};
+
+		void loadFromConfigFile(
+			const mrpt::config::CConfigFileBase& source,
+			const std::string& section) override;  // See base docs
+		void saveToConfigFile(
+			mrpt::config::CConfigFileBase& c,
+			const std::string& section) const override;
+	};
+
+	TOptions options;
+};
+}  // namespace mrpt::maps
+
+MRPT_ENUM_TYPE_BEGIN(mrpt::maps::CPointCloudFilterByVoxelGrid::TVoxelGridMethod)
+MRPT_FILL_ENUM_MEMBER(mrpt::maps::CPointCloudFilterByVoxelGrid, vgFirstPoint);
+MRPT_FILL_ENUM_MEMBER(
+	mrpt::maps::CPointCloudFilterByVoxelGrid, vgApproxCentroid);
+MRPT_ENUM_TYPE_END()
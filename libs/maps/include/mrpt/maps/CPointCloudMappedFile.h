@@ -0,0 +1,106 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/maps/CPointsMap.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace mrpt::maps
+{
+/** Read-only, memory-mapped access to a binary columnar point cloud file,
+ * for clouds too large to be parsed from text files or deserialized through
+ * an archive.
+ *
+ * The file has a header page followed by one contiguous array per field:
+ * the x, y, z coordinates and, optionally, the intensity (from
+ * CPointsMapXYZI) or the R, G, B colour channels (from CColouredPointsMap),
+ * all as `float` in the native byte order. Each array starts at a multiple
+ * of COLUMN_ALIGNMENT bytes (one memory page), so after open() the arrays
+ * are used in place, without reading or copying them: pages are loaded by
+ * the OS upon first access.
+ *
+ * \code
+ * CPointCloudMappedFile::Save(map, "cloud.bin");
+ * ...
+ * CPointCloudMappedFile f("cloud.bin");  // instantaneous
+ * const float* xs = f.x();
+ * for (size_t i = 0; i < f.size(); i++) ...
+ *
+ * CSimplePointsMap m;
+ * f.loadInto(m);  // a copy, at memory bandwidth
+ * \endcode
+ *
+ * If memory mapping is not available (e.g. emscripten), open() reads the
+ * whole file into memory instead.
+ *
+ * \sa CPointsMap::save3D_to_text_file()
+ * \note (New in MRPT 2.4.9)
+ * \ingroup mrpt_maps_grp
+ */
+class CPointCloudMappedFile
+{
+   public:
+	CPointCloudMappedFile();
+	/** Calls open() */
+	explicit CPointCloudMappedFile(const std::string& fileName);
+	~CPointCloudMappedFile();
+
+	CPointCloudMappedFile(const CPointCloudMappedFile&) = delete;
+	CPointCloudMappedFile& operator=(const CPointCloudMappedFile&) = delete;
+
+	/** Maps a file written by Save().
+	 * \exception std::exception If the file cannot be opened, or it is not
+	 * a valid point cloud file. */
+	void open(const std::string& fileName);
+	bool isOpen() const;
+	void close();
+
+	/** Number of points */
+	size_t size() const;
+	bool empty() const { return size() == 0; }
+
+	/** @name Point data, valid until close(). All arrays have size()
+	 * elements.
+	 * @{ */
+	const float* x() const;
+	const float* y() const;
+	const float* z() const;
+	/** nullptr if the file has no intensity */
+	const float* intensity() const;
+	/** nullptr if the file has no colours */
+	const float* R() const;
+	const float* G() const;
+	const float* B() const;
+	/** @} */
+
+	bool hasIntensity() const { return intensity() != nullptr; }
+	bool hasColor() const { return R() != nullptr; }
+
+	/** Copies all the points into a map, replacing its contents. Intensity
+	 * is copied into CPointsMapXYZI maps, and colours into CColouredPointsMap
+	 * maps, if present in the file. */
+	void loadInto(CPointsMap& m) const;
+
+	/** Writes all the points of a map to a file, including the intensity of
+	 * CPointsMapXYZI maps, and the colours of CColouredPointsMap maps.
+	 * \exception std::exception On any file error. */
+	static void Save(const CPointsMap& m, const std::string& fileName);
+
+	/** Alignment (bytes) of each array in the file */
+	static constexpr size_t COLUMN_ALIGNMENT = 4096;
+
+   private:
+	struct Impl;
+	std::unique_ptr<Impl> m_impl;
+};
+
+}  // namespace mrpt::maps
@@ -9,23 +9,31 @@
 #pragma once
 
 #include <mrpt/config/CLoadableOptions.h>
+#include <mrpt/core/Clock.h>
 #include <mrpt/core/Stringifyable.h>
 #include <mrpt/core/aligned_std_vector.h>
 #include <mrpt/core/optional_ref.h>
 #include <mrpt/core/safe_pointers.h>
 #include <mrpt/img/color_maps.h>
 #include <mrpt/maps/CMetricMap.h>
+#include <mrpt/maps/CPointCloudFilterByVoxelGrid.h>
 #include <mrpt/math/CMatrixFixed.h>
 #include <mrpt/math/KDTreeCapable.h>
 #include <mrpt/math/TBoundingBox.h>
 #include <mrpt/math/TPoint3D.h>
+#include <mrpt/math/TPointCloudView.h>
 #include <mrpt/obs/CSinCosLookUpTableFor2DScans.h>
 #include <mrpt/obs/obs_frwds.h>
 #include <mrpt/opengl/PLY_import_export.h>
 #include <mrpt/opengl/pointcloud_adapters.h>
 #include <mrpt/serialization/CSerializable.h>
 
+#include <array>
 #include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
 
 // Add for declaration of mexplus::from template specialization
 DECLARE_MEXPLUS_FROM(mrpt::maps::CPointsMap)
@@ -219,6 +227,40 @@ class CPointsMap : public CMetricMap,
 		return squareDistanceToClosestCorrespondence(d2f(p0.x), d2f(p0.y));
 	}
 
+	// See docs in base class
+	void squareDistanceToClosestCorrespondenceBatch(
+		const std::vector<float>& xs, const std::vector<float>& ys,
+		std::vector<float>& outSqrDists,
+		const TBatchQueryParams& params = TBatchQueryParams()) const override;
+
+	/** Batch version of kdTreeNClosestPoint3DIdx(): finds the `knn` closest
+	 * points to each point in `queries`, running the queries in parallel and
+	 * in the order of `params` (see TBatchQueryParams).
+	 * \param[out] outIdx For each query `i`, the indices of its `k` closest
+	 * points, from the closest one, at `outIdx[i*k]` to `outIdx[i*k+k-1]`.
+	 * \param[out] outDistSqr Their squared distances, in the same layout.
+	 * \return `k`, the number of neighbours per query: `knn`, or the number
+	 * of points in the map if it has less.
+	 * \note (New in MRPT 2.4.9)
+	 */
+	size_t kdTreeNClosestPoint3DIdxBatch(
+		const mrpt::math::TPointCloudView& queries, size_t knn,
+		std::vector<size_t>& outIdx, std::vector<float>& outDistSqr,
+		const TBatchQueryParams& params = TBatchQueryParams()) const;
+
+	/** Batch version of kdTreeRadiusSearch3D(): finds the points within a
+	 * squared distance `maxRadiusSqr` of each point in `queries`, running the
+	 * queries in parallel and in the order of `params` (see
+	 * TBatchQueryParams).
+	 * \param[out] outIndicesDist For each query, the pairs of indices and
+	 * squared distances of the points found, from the closest one.
+	 * \note (New in MRPT 2.4.9)
+	 */
+	void kdTreeRadiusSearch3DBatch(
+		const mrpt::math::TPointCloudView& queries, float maxRadiusSqr,
+		std::vector<std::vector<std::pair<size_t, float>>>& outIndicesDist,
+		const TBatchQueryParams& params = TBatchQueryParams()) const;
+
 	/** With this struct options are provided to the observation insertion
 	 * process.
 	 * \sa CObservation::insertIntoPointsMap
@@ -266,6 +308,28 @@ class CPointsMap : public CMetricMap,
 		/** Points with x,y,z coordinates set to zero will also be inserted */
 		bool insertInvalidPoints{false};
 
+		/** If set to true (default=false), insertions that only append new
+		 * points to the map (insertPoint(), insertAnotherMap(), inserting
+		 * observations with addToExistingPointsMap=true) add them to the
+		 * existing KD-tree index instead of marking it for a full rebuild.
+		 * Recommended for large maps that keep growing, e.g. in ICP-SLAM.
+		 * \sa mrpt::math::KDTreeCapable::kdtree_mark_points_appended() */
+		bool incrementalKDTree{false};
+
+		/** If true (default=false), the normals and curvatures computed by
+		 * getLocalSurfaceGeometry(), if any, are saved when serializing the
+		 * map, so they are not recomputed after loading it. */
+		bool serializeSurfaceGeometry{false};
+
+		/** If >0 (default=0, disabled), the points added to the map by each
+		 * inserted observation are decimated with a voxel grid of this size
+		 * (meters), keeping one point per voxel. Points already in the map
+		 * are not affected. \sa CPointCloudFilterByVoxelGrid */
+		float voxelFilterSize{0};
+		/** The point kept in each voxel, if voxelFilterSize>0 */
+		CPointCloudFilterByVoxelGrid::TVoxelGridMethod voxelFilterMethod{
+			CPointCloudFilterByVoxelGrid::vgFirstPoint};
+
 		/** Binary dump to stream - for usage in derived classes' serialization
 		 */
 		void writeToStream(mrpt::serialization::CArchive& out) const;
@@ -392,11 +456,17 @@ class CPointsMap : public CMetricMap,
 	}
 
 	/** 2D or 3D generic implementation of \a load2D_from_text_file and
-	 * load3D_from_text_file */
+	 * load3D_from_text_file. Files are memory-mapped, and large ones are
+	 * parsed in parallel. Numbers may also be separated by commas. */
 	bool load2Dor3D_from_text_file(const std::string& file, const bool is_3D);
 	bool load2Dor3D_from_text_stream(
 		std::istream& in, mrpt::optional_ref<std::string> outErrorMsg,
 		const bool is_3D);
+	/** Like load2Dor3D_from_text_stream(), from a text in memory.
+	 * \note (New in MRPT 2.4.9) */
+	bool load2Dor3D_from_text(
+		std::string_view text, mrpt::optional_ref<std::string> outErrorMsg,
+		const bool is_3D);
 
 	/**  Save to a text file. Each line will contain "X Y" point coordinates.
 	 *		Returns false if any error occured, true elsewere.
@@ -573,6 +643,14 @@ class CPointsMap : public CMetricMap,
 	{
 		return m_z;
 	}
+	/** Returns a non-owning view of the x,y,z point buffers, valid until the
+	 * map is modified.
+	 * \note (New in MRPT 2.4.9) */
+	mrpt::math::TPointCloudView asView() const
+	{
+		return mrpt::math::TPointCloudView::FromVectors(m_x, m_y, m_z);
+	}
+
 	/** Returns a copy of the 2D/3D points as a std::vector of float
 	 * coordinates.
 	 * If decimation is greater than 1, only 1 point out of that number will be
@@ -654,7 +732,7 @@ class CPointsMap : public CMetricMap,
 	inline void insertPoint(float x, float y, float z = 0)
 	{
 		insertPointFast(x, y, z);
-		mark_as_modified();
+		mark_as_points_appended();
 	}
 	/// \overload
 	inline void insertPoint(const mrpt::math::TPoint3D& p)
@@ -767,6 +845,18 @@ class CPointsMap : public CMetricMap,
 		const TMatchingParams& params,
 		TMatchingExtraResults& extraResults) const override;
 
+	/** Like determineMatching3D(), but with the other point cloud given as a
+	 * non-owning view, e.g. directly from a sensor buffer, without copying it
+	 * into a points map first. TMatchingPair::localIdx are indices in the
+	 * view.
+	 * \note (New in MRPT 2.4.9) */
+	void determineMatching3D(
+		const mrpt::math::TPointCloudView& otherPoints,
+		const mrpt::poses::CPose3D& otherMapPose,
+		mrpt::tfest::TMatchingPairList& correspondences,
+		const TMatchingParams& params,
+		TMatchingExtraResults& extraResults) const;
+
 	// See docs in base class
 	float compute3DMatchingRatio(
 		const mrpt::maps::CMetricMap* otherMap,
@@ -859,6 +949,15 @@ class CPointsMap : public CMetricMap,
 		const std::optional<const mrpt::poses::CPose3D>& robotPose =
 			std::nullopt);
 
+	/** Appends all points in a non-owning point cloud view, optionally
+	 * transformed by `pose`. If the view has intensity, it is stored as the
+	 * point color (gray level) by those maps with colors or intensity.
+	 * This method ignores insertionOptions, it always adds the points.
+	 * \note (New in MRPT 2.4.9) */
+	void insertPointsView(
+		const mrpt::math::TPointCloudView& pts,
+		const std::optional<const mrpt::poses::CPose3D>& pose = std::nullopt);
+
 	/** Insert the contents of another map into this one, fusing the previous
 	 *content with the new one.
 	 *    This means that points very close to existing ones will be "fused",
@@ -956,6 +1055,60 @@ class CPointsMap : public CMetricMap,
 		pMax = bb.max;
 	}
 
+	/** Local surface geometry around each point of the map, as returned by
+	 * getLocalSurfaceGeometry() */
+	struct TLocalSurfaceGeometry
+	{
+		/** Number of neighbours used to estimate it (0: not computed) */
+		size_t knn = 0;
+		/** Unit normal at each point: the direction of least variance of its
+		 * neighbours */
+		std::vector<mrpt::math::TVector3Df> normals;
+		/** Curvature (surface variation) at each point:
+		 * \f$ \lambda_0 / (\lambda_0+\lambda_1+\lambda_2) \f$, for the
+		 * eigenvalues \f$ \lambda_0 \le \lambda_1 \le \lambda_2 \f$ of the
+		 * covariance of its neighbours. 0 for planes, up to 1/3. */
+		std::vector<float> curvatures;
+		/** Covariance of each point, as a flat disc tangent to the surface:
+		 * variance 1 along the tangent plane and `1e-3` along the normal, as
+		 * used in generalized-ICP (Segal et al., 2009) */
+		std::vector<mrpt::math::CMatrixFloat33> covariances;
+		/** Squared distance from each point to its farthest neighbour
+		 * (infinity if the map had less than `knn` points). Points appended
+		 * closer than this invalidate it. */
+		std::vector<float> neighbourhoodRadiiSqr;
+
+		/** Number of points with their geometry computed */
+		size_t size() const { return normals.size(); }
+	};
+
+	/** Estimates the normal, curvature and covariance of every point from its
+	 * `knn` nearest neighbours (PCA), in parallel with `numThreads` threads
+	 * (0: as many as hardware threads).
+	 *
+	 * Results are cached together with the KD-tree: later calls with the same
+	 * `knn` are free until the map is modified. If points are only appended
+	 * (see mark_as_points_appended()), the next call only computes the new
+	 * points and the existing ones having a new point among their `knn`
+	 * nearest neighbours, with the same results than a full computation.
+	 *
+	 * \note Not thread-safe: do not call it from several threads at once.
+	 * \sa TInsertionOptions::serializeSurfaceGeometry,
+	 * mrpt::slam::CICP::TConfigParams::ICP3D_metric
+	 * \note (New in MRPT 2.4.9)
+	 */
+	const TLocalSurfaceGeometry& getLocalSurfaceGeometry(
+		size_t knn = 10, size_t numThreads = 1) const;
+
+	/** Returns the cached surface geometry without computing it: its `knn`
+	 * is 0 if it is not available, and its size() may be smaller than the
+	 * number of points if points were appended since it was computed.
+	 * \note (New in MRPT 2.4.9) */
+	const TLocalSurfaceGeometry& getLocalSurfaceGeometryNoRecompute() const
+	{
+		return m_localSurfaceGeometry;
+	}
+
 	/** Extracts the points in the map within a cylinder in 3D defined the
 	 * provided radius and zmin/zmax values.
 	 */
@@ -1012,6 +1165,42 @@ class CPointsMap : public CMetricMap,
 		const mrpt::poses::CPose3D& pc_in_map, const float* xs, const float* ys,
 		const float* zs, const std::size_t num_pts) const;
 
+	/** The points of a mrpt::obs::CObservationPointCloud or
+	 * mrpt::obs::CObservationVelodyneScan observation, decimated by
+	 * TLikelihoodOptions::decimation, in the sensor frame.
+	 * \note (New in MRPT 2.4.9) */
+	struct TLikelihoodCloud
+	{
+		/** Observation these points were built from, its timestamp, and its
+		 * number of points (or scan packets, for Velodyne scans without a
+		 * point cloud) */
+		const mrpt::obs::CObservation* obs = nullptr;
+		mrpt::Clock::time_point timestamp;
+		std::size_t rawSize = 0;
+		uint32_t decimation = 0;
+
+		mrpt::aligned_std_vector<float> x, y, z;
+	};
+
+	/** Returns the decimated points of a point cloud or Velodyne
+	 * observation, used to evaluate its likelihood, from a cache of the
+	 * latest observations, so they are built only once for all the
+	 * evaluated poses (e.g. all the particles of a particle filter).
+	 * Cache entries are identified by the observation address, timestamp
+	 * and number of points. Safe to call from several threads.
+	 * \return nullptr for other observation classes.
+	 * \note (New in MRPT 2.4.9) */
+	std::shared_ptr<const TLikelihoodCloud> getLikelihoodCloud(
+		const mrpt::obs::CObservation& obs) const;
+
+	/** Log-likelihood of a cloud returned by getLikelihoodCloud(), with its
+	 * sensor at the given pose in the map, with batched point
+	 * transformations.
+	 * \note (New in MRPT 2.4.9) */
+	double internal_computeObservationLikelihoodCloud(
+		const mrpt::poses::CPose3D& sensorPoseInMap,
+		const TLikelihoodCloud& cloud) const;
+
 	/** @name PCL library support
 		@{ */
 
@@ -1137,9 +1326,24 @@ class CPointsMap : public CMetricMap,
 	{
 		m_largestDistanceFromOriginIsUpdated = false;
 		m_boundingBoxIsUpdated = false;
+		m_localSurfaceGeometry.knn = 0;
 		kdtree_mark_as_outdated();
 	}
 
+	/** Like mark_as_modified(), but to be called when the only change has been
+	 * the addition of new points at the end of the point list. If
+	 * TInsertionOptions::incrementalKDTree is enabled, the KD-tree will be
+	 * updated incrementally instead of being rebuilt.
+	 */
+	inline void mark_as_points_appended() const
+	{
+		m_largestDistanceFromOriginIsUpdated = false;
+		m_boundingBoxIsUpdated = false;
+		if (insertionOptions.incrementalKDTree) kdtree_mark_points_appended();
+		else
+			kdtree_mark_as_outdated();
+	}
+
 	/** Returns a short description of the map. */
 	std::string asString() const override
 	{
@@ -1169,6 +1373,35 @@ class CPointsMap : public CMetricMap,
 	mutable bool m_boundingBoxIsUpdated;
 	mutable mrpt::math::TBoundingBoxf m_boundingBox;
 
+	/** Cache of getLocalSurfaceGeometry(), invalid if `knn==0`. Kept when
+	 * points are appended, for an incremental update. */
+	mutable TLocalSurfaceGeometry m_localSurfaceGeometry;
+
+	/** Cache of getLikelihoodCloud() */
+	struct TLikelihoodCloudCache
+	{
+		TLikelihoodCloudCache() = default;
+		/** Do NOT copy neither the cache nor the mutex */
+		TLikelihoodCloudCache(const TLikelihoodCloudCache&) {}
+		TLikelihoodCloudCache& operator=(const TLikelihoodCloudCache&)
+		{
+			return *this;
+		}
+
+		std::array<std::shared_ptr<const TLikelihoodCloud>, 4> entries;
+		/** Next entry to be replaced */
+		std::size_t next = 0;
+		std::mutex mtx;
+	};
+	mutable TLikelihoodCloudCache m_likelihoodCloudCache;
+
+	/** For serializeTo() and serializeFrom() of derived classes: the cached
+	 * surface geometry, if complete and
+	 * TInsertionOptions::serializeSurfaceGeometry, to be called after
+	 * reading/writing the points and insertionOptions. */
+	void writeLocalSurfaceGeometry(mrpt::serialization::CArchive& out) const;
+	void readLocalSurfaceGeometry(mrpt::serialization::CArchive& in);
+
 	/** This is a common version of CMetricMap::insertObservation() for point
 	 * maps (actually, CMetricMap::internal_insertObservation),
 	 *   so derived classes don't need to worry implementing that method unless
@@ -1180,6 +1413,16 @@ class CPointsMap : public CMetricMap,
 		const std::optional<const mrpt::poses::CPose3D>& robotPose =
 			std::nullopt) override;
 
+	/** Does the actual work of internal_insertObservation(), before the
+	 * optional voxel filter (TInsertionOptions::voxelFilterSize) */
+	bool internal_insertObservationPoints(
+		const mrpt::obs::CObservation& obs,
+		const std::optional<const mrpt::poses::CPose3D>& robotPose);
+
+	/** Decimates with a voxel grid the points with index >= firstIndex,
+	 * according to TInsertionOptions::voxelFilterSize */
+	void internal_voxelFilterPointsFrom(size_t firstIndex);
+
 	/** Helper method for ::copyFrom() */
 	void base_copyFrom(const CPointsMap& obj);
 
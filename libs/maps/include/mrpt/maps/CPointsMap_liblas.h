@@ -10,14 +10,23 @@
 
 /** \file Include this file in your user application only if you have libLAS
  * installed in your system */
+#include <mrpt/maps/CColouredPointsMap.h>
 #include <mrpt/maps/CPointsMap.h>
+#include <mrpt/maps/CPointsMapXYZI.h>
+#include <mrpt/math/TBoundingBox.h>
 
+#include <algorithm>
+#include <cmath>
 #include <fstream>
 #include <iostream>
 #include <liblas/liblas.hpp>
 #include <liblas/reader.hpp>
 #include <liblas/writer.hpp>
+#include <memory>
+#include <optional>
 #include <string>
+#include <type_traits>
+#include <vector>
 
 namespace mrpt
 {
@@ -58,6 +67,26 @@ struct LAS_HeaderInfo
 	LAS_HeaderInfo() : creation_year(0), creation_DOY(0) {}
 };
 
+namespace detail
+{
+inline void fillLASHeaderInfo(
+	liblas::Header const& header, LAS_HeaderInfo& out_headerInfo)
+{
+	out_headerInfo.FileSignature = header.GetFileSignature();
+	out_headerInfo.SystemIdentifier = header.GetSystemId();
+	out_headerInfo.SoftwareIdentifier = header.GetSoftwareId();
+#if LIBLAS_VERSION_NUM < 1800
+	out_headerInfo.project_guid = header.GetProjectId().to_string();
+#else
+	out_headerInfo.project_guid =
+		boost::lexical_cast<std::string>(header.GetProjectId());
+#endif
+	out_headerInfo.spatial_reference_proj4 = header.GetSRS().GetProj4();
+	out_headerInfo.creation_year = header.GetCreationYear();
+	out_headerInfo.creation_DOY = header.GetCreationDOY();
+}
+}  // namespace detail
+
 /** Save the point cloud as an ASPRS LAS binary file (requires MRPT built
  * against liblas). Refer to http://www.liblas.org/
  * \return false on any error */
@@ -95,7 +124,7 @@ bool saveLASFile(
 	for (size_t i = 0; i < nPts; i++)
 	{
 		float x, y, z, R, G, B;
-		ptmap.getPoint(i, x, y, z, R, G, B);
+		ptmap.getPointRGB(i, x, y, z, R, G, B);
 
 		pt.SetX(x);
 		pt.SetY(y);
@@ -153,18 +182,7 @@ bool loadLASFile(
 	const size_t nPts = header.GetPointRecordsCount();
 	ptmap.reserve(nPts);
 
-	out_headerInfo.FileSignature = header.GetFileSignature();
-	out_headerInfo.SystemIdentifier = header.GetSystemId();
-	out_headerInfo.SoftwareIdentifier = header.GetSoftwareId();
-#if LIBLAS_VERSION_NUM < 1800
-	out_headerInfo.project_guid = header.GetProjectId().to_string();
-#else
-	out_headerInfo.project_guid =
-		boost::lexical_cast<std::string>(header.GetProjectId());
-#endif
-	out_headerInfo.spatial_reference_proj4 = header.GetSRS().GetProj4();
-	out_headerInfo.creation_year = header.GetCreationYear();
-	out_headerInfo.creation_DOY = header.GetCreationDOY();
+	detail::fillLASHeaderInfo(header, out_headerInfo);
 
 	// Load points:
 	// ---------------------
@@ -195,6 +213,367 @@ bool loadLASFile(
 
 	return true;  // All ok.
 }
+
+/** @name Streaming (out-of-core) LAS/LAZ input/output
+ * For files too large to be loaded at once: points are read and written by
+ * chunks, so memory usage does not depend on the file size.
+ * \note (New in MRPT 2.4.9)
+ * @{ */
+
+/** Settings for readLASFileChunks() and loadLASFileChunked() */
+struct LAS_StreamReadParams
+{
+	/** Maximum number of points passed in each chunk (Default=1,000,000) */
+	size_t chunkSize = 1000000;
+	/** If set, only the points inside this box (in file coordinates) are
+	 * read. */
+	std::optional<mrpt::math::TBoundingBox> boundingBox;
+	/** Only keep 1 out of this number of points, after the bounding box
+	 * filter (Default=1: all of them) */
+	size_t decimation = 1;
+	/** Subtracted from the file coordinates when inserting points into maps,
+	 * which store them as `float`: e.g. the survey origin, to keep the
+	 * precision of UTM coordinates. Not applied to LAS_PointChunk. */
+	mrpt::math::TPoint3D coordinatesOffset{0, 0, 0};
+};
+
+/** A chunk of points read from a LAS/LAZ file, as a structure of arrays */
+struct LAS_PointChunk
+{
+	/** File coordinates */
+	std::vector<double> x, y, z;
+	std::vector<uint16_t> intensity;
+	/** Colours, as stored in the file */
+	std::vector<uint16_t> R, G, B;
+	/** ASPRS classification codes */
+	std::vector<uint8_t> classification;
+	/** Number of points in the file before this chunk (before filtering) */
+	uint64_t firstPointIndex = 0;
+
+	size_t size() const { return x.size(); }
+	bool empty() const { return x.empty(); }
+	void clear()
+	{
+		x.clear();
+		y.clear();
+		z.clear();
+		intensity.clear();
+		R.clear();
+		G.clear();
+		B.clear();
+		classification.clear();
+	}
+	void reserve(size_t n)
+	{
+		x.reserve(n);
+		y.reserve(n);
+		z.reserve(n);
+		intensity.reserve(n);
+		R.reserve(n);
+		G.reserve(n);
+		B.reserve(n);
+		classification.reserve(n);
+	}
+};
+
+/** Reads an ASPRS LAS file (or LAZ, if liblas was built with LASzip) by
+ * chunks of at most LAS_StreamReadParams::chunkSize points, optionally
+ * filtered by a bounding box and decimated, calling
+ * `bool onChunk(const LAS_PointChunk&)` for each one. Reading stops if it
+ * returns false. Requires MRPT built against liblas.
+ *
+ * \code
+ * LAS_StreamReadParams p;
+ * p.boundingBox = mrpt::math::TBoundingBox({x0, y0, -1e3}, {x1, y1, 1e3});
+ * readLASFileChunks("survey.laz", [&](const LAS_PointChunk& c) {
+ *   // process c.x, c.y, c.z...
+ *   return true;
+ * }, p);
+ * \endcode
+ * \return false on any error
+ */
+template <class FUNCTOR>
+bool readLASFileChunks(
+	const std::string& filename, FUNCTOR&& onChunk,
+	const LAS_StreamReadParams& params = LAS_StreamReadParams(),
+	LAS_HeaderInfo* out_headerInfo = nullptr)
+{
+	std::ifstream ifs;
+	ifs.open(filename.c_str(), std::ios::in | std::ios::binary);
+	if (!ifs.is_open())
+	{
+		std::cerr << "[readLASFileChunks] Couldn't open file: " << filename
+				  << std::endl;
+		return false;
+	}
+
+	// The factory also handles compressed (LAZ) files:
+	liblas::ReaderFactory factory;
+	liblas::Reader reader = factory.CreateWithStream(ifs);
+	if (out_headerInfo)
+		detail::fillLASHeaderInfo(reader.GetHeader(), *out_headerInfo);
+
+	const size_t chunkSize = std::max<size_t>(1, params.chunkSize);
+	const size_t decimation = std::max<size_t>(1, params.decimation);
+
+	LAS_PointChunk chunk;
+	chunk.reserve(chunkSize);
+	uint64_t nRead = 0;
+	size_t nAccepted = 0;
+	while (reader.ReadNextPoint())
+	{
+		nRead++;
+		liblas::Point const& p = reader.GetPoint();
+		const double x = p.GetX(), y = p.GetY(), z = p.GetZ();
+		if (params.boundingBox &&
+			!params.boundingBox->containsPoint({x, y, z}))
+			continue;
+		if (nAccepted++ % decimation != 0) continue;
+
+		chunk.x.push_back(x);
+		chunk.y.push_back(y);
+		chunk.z.push_back(z);
+		chunk.intensity.push_back(p.GetIntensity());
+		liblas::Color const& col = p.GetColor();
+		chunk.R.push_back(col.GetRed());
+		chunk.G.push_back(col.GetGreen());
+		chunk.B.push_back(col.GetBlue());
+		chunk.classification.push_back(p.GetClassification().GetClass());
+
+		if (chunk.size() >= chunkSize)
+		{
+			if (!onChunk(static_cast<const LAS_PointChunk&>(chunk)))
+				return true;
+			chunk.clear();
+			chunk.firstPointIndex = nRead;
+		}
+	}
+	if (!chunk.empty()) onChunk(static_cast<const LAS_PointChunk&>(chunk));
+	return true;
+}
+
+/** Appends the points of a chunk to a map, after subtracting
+ * `coordinatesOffset`. Colours are inserted into
+ * mrpt::maps::CColouredPointsMap and intensities into
+ * mrpt::maps::CPointsMapXYZI, both mapped to the range [0,1] as in
+ * loadLASFile(). */
+template <class POINTSMAP>
+void insertLASPointChunk(
+	POINTSMAP& ptmap, const LAS_PointChunk& chunk,
+	const mrpt::math::TPoint3D& coordinatesOffset = {0, 0, 0})
+{
+	const size_t N = chunk.size();
+	ptmap.reserve(ptmap.size() + N);
+	for (size_t i = 0; i < N; i++)
+	{
+		const auto x = static_cast<float>(chunk.x[i] - coordinatesOffset.x);
+		const auto y = static_cast<float>(chunk.y[i] - coordinatesOffset.y);
+		const auto z = static_cast<float>(chunk.z[i] - coordinatesOffset.z);
+		if constexpr (std::is_base_of_v<CPointsMapXYZI, POINTSMAP>)
+		{
+			const float I = chunk.intensity[i] * (1.0f / 65535.0f);
+			ptmap.insertPointRGB(x, y, z, I, I, I);
+		}
+		else if constexpr (std::is_base_of_v<CColouredPointsMap, POINTSMAP>)
+		{
+			const float col_fract = 1.0f / 255.0f;
+			ptmap.insertPointRGB(
+				x, y, z, chunk.R[i] * col_fract, chunk.G[i] * col_fract,
+				chunk.B[i] * col_fract);
+		}
+		else
+		{
+			ptmap.insertPointFast(x, y, z);
+		}
+	}
+	ptmap.mark_as_points_appended();
+}
+
+/** Loads the points of a LAS/LAZ file into a map by chunks, with the
+ * filters and coordinates offset of `params`, without ever holding the
+ * whole file in memory.
+ * \sa readLASFileChunks(), insertLASPointChunk()
+ * \return false on any error */
+template <class POINTSMAP>
+bool loadLASFileChunked(
+	POINTSMAP& ptmap, const std::string& filename,
+	LAS_HeaderInfo& out_headerInfo,
+	const LAS_StreamReadParams& params = LAS_StreamReadParams())
+{
+	ptmap.clear();
+	return readLASFileChunks(
+		filename,
+		[&](const LAS_PointChunk& chunk) {
+			insertLASPointChunk(ptmap, chunk, params.coordinatesOffset);
+			return true;
+		},
+		params, &out_headerInfo);
+}
+
+/** Settings for LAS_StreamWriter */
+struct LAS_StreamWriteParams
+{
+	/** Write a compressed LAZ file (requires liblas built with LASzip) */
+	bool compressed = false;
+	/** Header scale and offset of the coordinates stored in the file */
+	mrpt::math::TPoint3D scale{0.01, 0.01, 0.01}, offset{0, 0, 0};
+	/** Added to the coordinates of the points of maps, e.g. to go back to
+	 * UTM coordinates. See LAS_StreamReadParams::coordinatesOffset */
+	mrpt::math::TPoint3D coordinatesOffset{0, 0, 0};
+	/** Whether to store colours, that is, use LAS point format 3 instead of
+	 * 1 (Default=true) */
+	bool withColor = true;
+};
+
+/** Writes an ASPRS LAS/LAZ file incrementally, from any number of point maps
+ * or chunks, so the whole cloud never needs to be in memory. The point count
+ * in the header is updated upon close(). Colours of
+ * mrpt::maps::CColouredPointsMap and intensities of
+ * mrpt::maps::CPointsMapXYZI are saved too. Requires MRPT built against
+ * liblas.
+ *
+ * \code
+ * LAS_StreamWriter w;
+ * w.open("out.laz", params);
+ * for (...) w.write(localMap);
+ * w.close();
+ * \endcode
+ */
+class LAS_StreamWriter
+{
+   public:
+	LAS_StreamWriter() = default;
+	~LAS_StreamWriter() { close(); }
+
+	LAS_StreamWriter(const LAS_StreamWriter&) = delete;
+	LAS_StreamWriter& operator=(const LAS_StreamWriter&) = delete;
+
+	/** Creates the file, discarding any former one.
+	 * \return false on any error */
+	bool open(
+		const std::string& filename,
+		const LAS_StreamWriteParams& params = LAS_StreamWriteParams())
+	{
+		close();
+		m_ofs.open(filename.c_str(), std::ios::out | std::ios::binary);
+		if (!m_ofs.is_open())
+		{
+			std::cerr << "[LAS_StreamWriter] Couldn't write to file: "
+					  << filename << std::endl;
+			return false;
+		}
+		m_params = params;
+		m_header = std::make_unique<liblas::Header>();
+		m_header->SetDataFormatId(
+			params.withColor ? liblas::ePointFormat3 : liblas::ePointFormat1);
+		m_header->SetScale(params.scale.x, params.scale.y, params.scale.z);
+		m_header->SetOffset(params.offset.x, params.offset.y, params.offset.z);
+		if (params.compressed)
+		{
+#if LIBLAS_VERSION_NUM >= 1800
+			m_header->SetCompressed(true);
+#else
+			std::cerr << "[LAS_StreamWriter] LAZ output needs liblas>=1.8\n";
+			close();
+			return false;
+#endif
+		}
+		m_writer = std::make_unique<liblas::Writer>(m_ofs, *m_header);
+		m_point = std::make_unique<liblas::Point>(m_header.get());
+		m_count = 0;
+		return true;
+	}
+
+	bool isOpen() const { return m_writer != nullptr; }
+
+	/** Appends all the points of a map, adding
+	 * LAS_StreamWriteParams::coordinatesOffset.
+	 * \return false on any error */
+	template <class POINTSMAP>
+	bool write(const POINTSMAP& ptmap)
+	{
+		if (!isOpen()) return false;
+		const size_t N = ptmap.size();
+		const auto& o = m_params.coordinatesOffset;
+		for (size_t i = 0; i < N; i++)
+		{
+			float x, y, z, R = 0, G = 0, B = 0;
+			ptmap.getPointRGB(i, x, y, z, R, G, B);
+			uint16_t intensity = 0;
+			if constexpr (std::is_base_of_v<CPointsMapXYZI, POINTSMAP>)
+			{
+				intensity = static_cast<uint16_t>(
+					std::clamp(R, 0.0f, 1.0f) * 65535.0f);
+				R = G = B = 0;
+			}
+			if (!writePoint(
+					x + o.x, y + o.y, z + o.z, intensity,
+					static_cast<uint16_t>(R * 255.0f),
+					static_cast<uint16_t>(G * 255.0f),
+					static_cast<uint16_t>(B * 255.0f), 0))
+				return false;
+		}
+		return true;
+	}
+
+	/** Appends the points of a chunk, e.g. from readLASFileChunks(), with
+	 * their coordinates unchanged.
+	 * \return false on any error */
+	bool write(const LAS_PointChunk& chunk)
+	{
+		if (!isOpen()) return false;
+		for (size_t i = 0; i < chunk.size(); i++)
+			if (!writePoint(
+					chunk.x[i], chunk.y[i], chunk.z[i], chunk.intensity[i],
+					chunk.R[i], chunk.G[i], chunk.B[i],
+					chunk.classification[i]))
+				return false;
+		return true;
+	}
+
+	/** Number of points written since open() */
+	uint64_t pointCount() const { return m_count; }
+
+	/** Finishes the file (updating the point count in its header) and
+	 * closes it. Called upon destruction. */
+	void close()
+	{
+		// liblas updates the header point count upon destruction:
+		m_point.reset();
+		m_writer.reset();
+		m_header.reset();
+		if (m_ofs.is_open()) m_ofs.close();
+	}
+
+   private:
+	std::ofstream m_ofs;
+	LAS_StreamWriteParams m_params;
+	std::unique_ptr<liblas::Header> m_header;
+	std::unique_ptr<liblas::Writer> m_writer;
+	std::unique_ptr<liblas::Point> m_point;
+	uint64_t m_count = 0;
+
+	bool writePoint(
+		double x, double y, double z, uint16_t intensity, uint16_t R,
+		uint16_t G, uint16_t B, uint8_t classification)
+	{
+		auto& pt = *m_point;
+		pt.SetCoordinates(x, y, z);
+		pt.SetIntensity(intensity);
+		pt.SetClassification(liblas::Classification(classification));
+		if (m_params.withColor) pt.SetColor(liblas::Color(R, G, B));
+		if (!m_writer->WritePoint(pt))
+		{
+			std::cerr << "[LAS_StreamWriter] liblas returned error writing "
+						 "point #"
+					  << m_count << " to file.\n";
+			return false;
+		}
+		m_count++;
+		return true;
+	}
+};
+/** @} */
 /** @} */
 }  // namespace maps
 }  // namespace mrpt
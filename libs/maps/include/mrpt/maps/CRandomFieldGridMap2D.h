@@ -274,6 +274,11 @@ class CRandomFieldGridMap2D
 		/** [DM/DM+V methods] The scaling parameter for the confidence "alpha"
 		 * values (see the IROS 2009 paper; see CRandomFieldGridMap2D) */
 		double dm_sigma_omega{0.05};
+		/** [DM/DM+V methods] (Default: 1) Threads used by
+		 * insertIndividualReadings() (0: as many as hardware threads). Only
+		 * large batches are processed in parallel, and the result does not
+		 * depend on the number of threads. */
+		unsigned int numThreads{1};
 		/** @} */
 
 		/** @name Kalman-filter methods (mrKalmanFilter, mrKalmanApproximate)
@@ -322,6 +327,13 @@ class CRandomFieldGridMap2D
 		/** (Default:false) Skip the computation of the variance, just compute
 		 * the mean */
 		bool GMRF_skip_variance{false};
+		/** (Default:-1) If >=0, each map update only recovers the variance
+		 * of the cells with new observations since the previous update, and
+		 * of the cells within this distance (in cells) of them; the rest keep
+		 * their former values. Since the variance of far cells barely changes
+		 * with local observations, this approximation makes the cost of
+		 * updates independent of the map size. -1: all the cells. */
+		int GMRF_variance_update_radius{-1};
 		/** @} */
 	};
 
@@ -435,6 +447,30 @@ class CRandomFieldGridMap2D
 		   */
 		const double reading_stddev = .0);
 
+	/** Like insertIndividualReading(), for a batch of readings at once.
+	 *
+	 * For the kernel methods (mrKernelDM, mrKernelDMV) the grid is resized
+	 * only once for all the readings, and, if
+	 * TInsertionOptionsCommon::numThreads is not 1, each thread fuses all the
+	 * readings into the cells of one band of rows of the grid, so the result
+	 * is identical to inserting them one by one. Other methods insert them
+	 * one by one, with a single map update at the end if `update_map`.
+	 *
+	 * 
+ote (New in MRPT 2.4.9)
+	 */
+	void insertIndividualReadings(
+		/** [in] The values observed in each position */
+		const std::vector<double>& sensorReadings,
+		/** [in] The (x,y) locations, one per reading */
+		const std::vector<mrpt::math::TPoint2D>& points,
+		/** [in] Run a global map update after inserting all the readings
+		   (algorithm-dependant) */
+		const bool update_map = true,
+		/** [in] Whether the observations "vanish" with time (false) or not
+		   (true) [Only for GMRF methods] */
+		const bool time_invariant = true);
+
 	enum TGridInterpolationMethod
 	{
 		gimNearest = 0,
@@ -537,6 +573,11 @@ class CRandomFieldGridMap2D
 	ConnectivityDescriptor::Ptr m_gmrf_connectivity;
 
 	mrpt::graphs::ScalarFactorGraph m_gmrf;
+	/** Cells with new GMRF observations since the last map update, for
+	 * TInsertionOptionsCommon::GMRF_variance_update_radius */
+	std::vector<size_t> m_gmrf_observedCells;
+	/** Whether all GMRF variances must be recovered in the next update */
+	bool m_gmrf_updateAllVariances{true};
 
 	struct TObservationGMRF
 		: public mrpt::graphs::ScalarFactorGraph::UnaryFactorVirtualBase
@@ -597,6 +638,17 @@ class CRandomFieldGridMap2D
 	void insertObservation_KernelDM_DMV(
 		double normReading, const mrpt::math::TPoint2D& point, bool is_DMV);
 
+	/** Computes m_DM_gaussWindow, if the cutoff radius changed since the last
+	 * call, and returns the window half-size (in cells) */
+	int internal_updateWindow_KernelDM_DMV();
+
+	/** Fuses one reading into the cells of the kernel window with `cy` in
+	 * the range [cy_min,cy_max]. The grid must already contain the window,
+	 * and m_DM_gaussWindow must be up to date. */
+	void internal_fuseReading_KernelDM_DMV(
+		double normReading, const mrpt::math::TPoint2D& point, bool is_DMV,
+		int cy_min, int cy_max);
+
 	/** The implementation of "insertObservation" for the (whole) Kalman Filter
 	 * map model.
 	 * \param normReading Is a [0,1] normalized concentration reading.
@@ -0,0 +1,196 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/containers/CVoxelBlockGrid3D.h>
+#include <mrpt/maps/COccupancyGridMap3D.h>
+
+namespace mrpt::maps
+{
+/** A 3D occupancy grid map stored as sparse, hashed blocks of 8x8x8 voxels
+ * (see mrpt::containers::CVoxelBlockGrid3D).
+ *
+ * It offers the same API than COccupancyGridMap3D (updateCell(),
+ * insertRay(), insertPointCloud(), computeObservationLikelihood(),...) and
+ * shares its insertion, likelihood and rendering options, but the map has no
+ * bounds: voxel blocks are allocated the first time any of their voxels is
+ * observed, so memory usage grows with the observed volume and growing the
+ * map costs nothing. Use it instead of COccupancyGridMap3D for large, mostly
+ * unknown areas.
+ *
+ * Each voxel follows a Bernoulli probability distribution: a value of 0 means
+ * certainly occupied, 1 means a certainly empty voxel. Initially 0.5 means
+ * uncertainty.
+ *
+ * Voxel indices are signed integers, with voxel (0,0,0) spanning from the
+ * origin to (resolution,resolution,resolution).
+ *
+ * \note (New in MRPT 2.4.9)
+ * \ingroup mrpt_maps_grp
+ **/
+class CSparseOccupancyGridMap3D : public CMetricMap
+{
+	DEFINE_SERIALIZABLE(CSparseOccupancyGridMap3D, mrpt::maps)
+   public:
+	/** The type of the map voxels: */
+	using voxelType = COccupancyGridMap3D::voxelType;
+	using grid_t = mrpt::containers::CVoxelBlockGrid3D<voxelType, 3>;
+	using TInsertionOptions = COccupancyGridMap3D::TInsertionOptions;
+	using TLikelihoodOptions = COccupancyGridMap3D::TLikelihoodOptions;
+	using TRenderingOptions = COccupancyGridMap3D::TRenderingOptions;
+
+	/** Constructor */
+	CSparseOccupancyGridMap3D(float resolution = 0.10f);
+
+	/** Removes all voxels and changes the voxel size */
+	void setResolution(double resolution);
+	double getResolution() const { return m_grid.getResolution(); }
+
+	/** Read-only access to the voxel blocks */
+	const grid_t& grid() const { return m_grid; }
+
+	/** Scales an integer representation of the log-odd into a real valued
+	 * probability in [0,1], using p=exp(l)/(1+exp(l))  */
+	static inline float l2p(const voxelType l)
+	{
+		return COccupancyGridMap3D::l2p(l);
+	}
+	/** Scales a real valued probability in [0,1] to an integer representation
+	 * of: log(p)-log(1-p)  in the valid range of voxelType */
+	static inline voxelType p2l(const float p)
+	{
+		return COccupancyGridMap3D::p2l(p);
+	}
+
+	/** Performs the Bayesian fusion of a new observation of a cell,
+	 * allocating its block if needed. */
+	void updateCell(int cx_idx, int cy_idx, int cz_idx, float v);
+
+	/** Change the contents [0,1] (0:occupied, 1:free) of a voxel, given its
+	 * index. */
+	inline void setCellFreeness(int cx, int cy, int cz, float value)
+	{
+		m_grid.cellRefByIndexAlloc(cx, cy, cz) = p2l(value);
+	}
+
+	/** Read the real valued [0,1] (0:occupied, 1:free) contents of a voxel,
+	 * given its index. Returns 0.5 for never observed voxels. */
+	inline float getCellFreeness(int cx, int cy, int cz) const
+	{
+		if (auto* c = m_grid.cellByIndex(cx, cy, cz); c != nullptr)
+			return l2p(*c);
+		else
+			return .5f;
+	}
+
+	/** Change the contents [0,1] of a voxel, given its coordinates */
+	inline void setFreenessByPos(float x, float y, float z, float value)
+	{
+		setCellFreeness(
+			m_grid.x2idx(x), m_grid.y2idx(y), m_grid.z2idx(z), value);
+	}
+
+	/** Read the real valued [0,1] contents of a voxel, given its coordinates */
+	inline float getFreenessByPos(float x, float y, float z) const
+	{
+		return getCellFreeness(
+			m_grid.x2idx(x), m_grid.y2idx(y), m_grid.z2idx(z));
+	}
+
+	/** Increases the freeness of a ray segment, and the occupancy of the voxel
+	 * at its end point (unless endIsOccupied=false).
+	 * Rays longer than insertionOptions.maxDistanceInsertion are truncated,
+	 * without marking their end as occupied.
+	 */
+	void insertRay(
+		const mrpt::math::TPoint3D& sensor, const mrpt::math::TPoint3D& end,
+		bool endIsOccupied = true);
+
+	/** Calls insertRay() for each point in the point cloud, using as sensor
+	 * central point (the origin of all rays), the given `sensorCenter`.
+	 * \param[in] maxValidRange If a point has larger distance from
+	 * `sensorCenter` than `maxValidRange`, it will be considered a non-echo,
+	 * and NO occupied voxel will be created at the end of the segment.
+	 * \sa insertionOptions parameters are observed in this method.
+	 */
+	void insertPointCloud(
+		const mrpt::math::TPoint3D& sensorCenter,
+		const mrpt::maps::CPointsMap& pts,
+		const float maxValidRange = std::numeric_limits<float>::max());
+
+	/** Computes the log-likelihood of a set of points, given the current map
+	 * as reference, with a likelihood-field model: the distance from each
+	 * point to its closest occupied voxel (up to LF_maxCorrsDistance) is
+	 * searched in the voxel neighborhood.
+	 * \param pm The points map
+	 * \param relativePose The relative pose of the points map in this map's
+	 * coordinates.
+	 *  See "likelihoodOptions" for configuration parameters.
+	 */
+	double computeLikelihoodField_Thrun(
+		const CPointsMap& pm,
+		const mrpt::poses::CPose3D& relativePose =
+			mrpt::poses::CPose3D()) const;
+
+	/** \sa renderingOptions */
+	void getAsOctoMapVoxels(mrpt::opengl::COctoMapVoxels& gl_obj) const;
+
+	/** Returns a 3D object representing the map. \sa renderingOptions */
+	void getVisualizationInto(
+		mrpt::opengl::CSetOfObjects& outObj) const override;
+
+	TInsertionOptions insertionOptions;
+	TLikelihoodOptions likelihoodOptions;
+	TRenderingOptions renderingOptions;
+
+	bool isEmpty() const override;
+
+	void saveMetricMapRepresentationToFile(const std::string& f) const override;
+
+	/** Returns a short description of the map. */
+	std::string asString() const override
+	{
+		return mrpt::format(
+			"Sparse 3D gridmap, voxel resolution=%f, %u blocks allocated "
+			"(%s bytes)",
+			m_grid.getResolution(),
+			static_cast<unsigned int>(m_grid.getBlockCount()),
+			std::to_string(m_grid.getMemoryUsage()).c_str());
+	}
+
+   protected:
+	/** The actual voxels container */
+	grid_t m_grid;
+
+	/** True upon construction; used by isEmpty() */
+	bool m_is_empty{true};
+
+	void OnPostSuccesfulInsertObs(const mrpt::obs::CObservation&) override;
+	void internal_clear() override;
+	bool internal_insertObservation(
+		const mrpt::obs::CObservation& obs,
+		const std::optional<const mrpt::poses::CPose3D>& robotPose =
+			std::nullopt) override;
+	double internal_computeObservationLikelihood(
+		const mrpt::obs::CObservation& obs,
+		const mrpt::poses::CPose3D& takenFrom) const override;
+	bool internal_canComputeObservationLikelihood(
+		const mrpt::obs::CObservation& obs) const override;
+
+	MAP_DEFINITION_START(CSparseOccupancyGridMap3D)
+	float resolution{0.10f};
+
+	/** Observations insertion options */
+	mrpt::maps::COccupancyGridMap3D::TInsertionOptions insertionOpts;
+	/** Probabilistic observation likelihood options */
+	mrpt::maps::COccupancyGridMap3D::TLikelihoodOptions likelihoodOpts;
+	MAP_DEFINITION_END(CSparseOccupancyGridMap3D)
+};
+
+}  // namespace mrpt::maps
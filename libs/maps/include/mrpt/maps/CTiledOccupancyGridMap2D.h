@@ -0,0 +1,205 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/maps/COccupancyGridMap2D.h>
+
+#include <cmath>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mrpt::maps
+{
+/** An unbounded 2D occupancy grid stored as square tiles of cells, for maps
+ * too large to be kept in a single COccupancyGridMap2D (e.g. a 1.5 km x 1.5 km
+ * campus at 5 cm is 9e8 cells).
+ *
+ * - Tiles are allocated the first time any of their cells is written.
+ * Reading a cell in a never written tile returns 0.5 (unknown) without
+ * allocating memory, and the map grows at no cost: there is no equivalent
+ * to COccupancyGridMap2D::resizeGrid().
+ * - At most `maxTilesInMemory` tiles are kept in RAM. When more are needed,
+ * the least recently used ones are paged out to a memory-mapped tile file
+ * on disk, and paged in again transparently when accessed.
+ *
+ * Cells have the same log-odds representation, and getCell(), setCell(),
+ * updateCell(), getPos() and setPos() have the same semantics, than in
+ * COccupancyGridMap2D, but cell indices are signed, global integers: cell
+ * (0,0) spans from the origin to (resolution,resolution).
+ *
+ * Algorithms written for COccupancyGridMap2D (e.g.
+ * mrpt::slam::CMonteCarloLocalization2D, mrpt::nav::PlannerSimple2D or
+ * COccupancyGridMap2D::laserScanSimulator()) are used on a local window of
+ * this map, extracted with extractWindow() around the area of interest;
+ * changes done to the window (e.g. by inserting observations) can be stored
+ * back with storeWindow().
+ *
+ * This class is not thread-safe, even for read-only (const) accesses, since
+ * they may page tiles in and out.
+ *
+ * \sa COccupancyGridMap2D
+ * \note (New in MRPT 2.4.9)
+ * \ingroup mrpt_maps_grp
+ */
+class CTiledOccupancyGridMap2D
+{
+   public:
+	using cellType = COccupancyGridMap2D::cellType;
+
+	/** Creates an empty map.
+	 * \param resolution Cell size [m]
+	 * \param tileSize Number of cells on each side of a tile
+	 * \param maxTilesInMemory Tiles beyond this number are paged out to disk
+	 * \param tileFile The file used to page tiles out. If empty, a temporary
+	 * file is used and deleted upon destruction. It is created only if tiles
+	 * need to be paged out.
+	 */
+	CTiledOccupancyGridMap2D(
+		float resolution = 0.05f, unsigned int tileSize = 256,
+		size_t maxTilesInMemory = 1024, const std::string& tileFile = {});
+	~CTiledOccupancyGridMap2D();
+
+	CTiledOccupancyGridMap2D(const CTiledOccupancyGridMap2D&) = delete;
+	CTiledOccupancyGridMap2D& operator=(const CTiledOccupancyGridMap2D&) =
+		delete;
+
+	/** Removes all tiles, in memory and on disk. */
+	void clear();
+
+	float getResolution() const { return m_resolution; }
+	unsigned int getTileSize() const { return m_tileSize; }
+
+	inline int x2idx(double x) const
+	{
+		return static_cast<int>(std::floor(x / m_resolution));
+	}
+	inline int y2idx(double y) const { return x2idx(y); }
+	/** Coordinate of the center of a cell */
+	inline float idx2x(int cx) const { return (cx + 0.5f) * m_resolution; }
+	inline float idx2y(int cy) const { return idx2x(cy); }
+
+	/** Read the real valued [0,1] contents of a cell, given its index */
+	float getCell(int cx, int cy) const
+	{
+		const cellType* c = cellPtr(cx, cy, false);
+		return c ? COccupancyGridMap2D::l2p(*c) : 0.5f;
+	}
+	/** Change the contents [0,1] of a cell, given its index */
+	void setCell(int cx, int cy, float value)
+	{
+		*cellPtr(cx, cy, true) = COccupancyGridMap2D::p2l(value);
+	}
+	/** Performs the Bayesian fusion of a new observation of a cell, with the
+	 * same log-odds saturation than COccupancyGridMap2D::updateCell() */
+	void updateCell(int cx, int cy, float v);
+
+	/** Read the real valued [0,1] contents of a cell, given its coordinates */
+	float getPos(float x, float y) const
+	{
+		return getCell(x2idx(x), y2idx(y));
+	}
+	/** Change the contents [0,1] of a cell, given its coordinates */
+	void setPos(float x, float y, float value)
+	{
+		setCell(x2idx(x), y2idx(y), value);
+	}
+
+	/** Fills `out` with the contents of the rectangle [x_min,x_max] x
+	 * [y_min,y_max] (meters) of this map. Limits are rounded to cell
+	 * borders. Unknown areas are filled with 0.5.
+	 * \exception std::exception If the limits are not valid. */
+	void extractWindow(
+		COccupancyGridMap2D& out, float x_min, float x_max, float y_min,
+		float y_max) const;
+
+	/** Copies all cells of `grid`, which must have the same resolution than
+	 * this map, into their place in this map. Tiles whose part of the window
+	 * is all unknown and which do not exist yet are not allocated.
+	 * \exception std::exception If resolutions do not match. */
+	void storeWindow(const COccupancyGridMap2D& grid);
+
+	/** Number of allocated tiles, either in memory or paged out */
+	size_t getTileCount() const;
+	/** Number of tiles currently in memory */
+	size_t getTileCountInMemory() const { return m_tiles.size(); }
+	/** Number of tiles currently paged out to the tile file */
+	size_t getTileCountOnDisk() const;
+
+	/** Maximum number of tiles kept in RAM. Reducing it pages out tiles
+	 * the next time a tile is accessed. */
+	size_t maxTilesInMemory;
+
+   private:
+	using tile_key_t = uint64_t;
+	using tile_t = std::vector<cellType>;
+
+	struct TTileInMemory
+	{
+		std::unique_ptr<tile_t> cells;
+		std::list<tile_key_t>::iterator lruIt;
+		/** Modified since it was last read from/written to the file */
+		bool dirty = true;
+	};
+
+	static inline tile_key_t tileKey(int tx, int ty)
+	{
+		return (static_cast<tile_key_t>(static_cast<uint32_t>(tx)) << 32) |
+			static_cast<uint32_t>(ty);
+	}
+	inline int floorDiv(int c) const
+	{
+		return c >= 0 ? c / m_tileSizeInt
+					  : -((-c + m_tileSizeInt - 1) / m_tileSizeInt);
+	}
+
+	/** Returns the cell, or nullptr if `allocate`=false and the tile does not
+	 * exist. */
+	inline cellType* cellPtr(int cx, int cy, bool allocate) const
+	{
+		const int tx = floorDiv(cx), ty = floorDiv(cy);
+		const tile_key_t key = tileKey(tx, ty);
+		TTileInMemory* t = (m_lastTile && key == m_lastKey)
+			? m_lastTile
+			: findTile(key, allocate);
+		if (!t) return nullptr;
+		if (allocate) t->dirty = true;
+		const int lx = cx - tx * m_tileSizeInt, ly = cy - ty * m_tileSizeInt;
+		return &(*t->cells)[lx + ly * m_tileSizeInt];
+	}
+
+	/** Looks up, pages in or (if allocate=true) creates a tile, and makes it
+	 * the most recently used one. */
+	TTileInMemory* findTile(tile_key_t key, bool allocate) const;
+	/** Pages out the least recently used tiles, until there is room for one
+	 * more tile in memory */
+	void makeRoomForOneTile() const;
+
+	float m_resolution;
+	unsigned int m_tileSize;
+	int m_tileSizeInt;
+
+	mutable std::unordered_map<tile_key_t, TTileInMemory> m_tiles;
+	/** Most recently used tiles first */
+	mutable std::list<tile_key_t> m_lru;
+	/** One-entry cache, since consecutive accesses mostly fall in the same
+	 * tile (pointers to unordered_map elements survive rehashing) */
+	mutable tile_key_t m_lastKey = 0;
+	mutable TTileInMemory* m_lastTile = nullptr;
+
+	/** The tile file, with fixed-size slots; and tile -> slot index map */
+	struct TileFile;
+	std::unique_ptr<TileFile> m_file;
+	mutable std::unordered_map<tile_key_t, size_t> m_tileSlots;
+};
+
+}  // namespace mrpt::maps
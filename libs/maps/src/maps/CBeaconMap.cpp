@@ -28,6 +28,8 @@
 #include <mrpt/system/string_utils.h>
 
 #include <Eigen/Dense>
+#include <array>
+#include <unordered_map>
 
 using namespace mrpt;
 using namespace mrpt::maps;
@@ -147,6 +149,41 @@ double CBeaconMap::internal_computeObservationLikelihood(
 {
 	MRPT_START
 
+	if (CLASS_ID(CObservationBeaconRanges) == obs.GetRuntimeClass())
+	{
+		/********************************************************************
+
+						OBSERVATION TYPE: CObservationBeaconRanges
+
+				Lik. between "this" and "auxMap";
+
+			********************************************************************/
+		// The batch method, for just one pose:
+		const auto& o = dynamic_cast<const CObservationBeaconRanges&>(obs);
+		thread_local std::vector<double> ret;
+		computeObservationLikelihoodBatch(o, {robotPose3D}, ret);
+		return ret[0];
+
+	}  // end of likelihood of CObservationBeaconRanges
+	else
+	{
+		/********************************************************************
+					OBSERVATION TYPE: Unknown
+		********************************************************************/
+		return 0;
+	}
+	MRPT_END
+}
+
+/*---------------------------------------------------------------
+				computeObservationLikelihoodBatch
+  ---------------------------------------------------------------*/
+void CBeaconMap::computeObservationLikelihoodBatch(
+	const CObservationBeaconRanges& o, const std::vector<CPose3D>& robotPoses,
+	std::vector<double>& outLogLiks) const
+{
+	MRPT_START
+
 	/* ===============================================================================================================
 		Refer to the papers:
 		- IROS 2008, "Efficient Probabilistic Range-Only SLAM",
@@ -157,193 +194,197 @@ double CBeaconMap::internal_computeObservationLikelihood(
 	   ===============================================================================================================
 	   */
 
-	if (CLASS_ID(CObservationBeaconRanges) == obs.GetRuntimeClass())
+	const size_t M = robotPoses.size();
+	outLogLiks.assign(M, .0);
+	if (!M) return;
+
+	// Working buffers, per thread since this may be called for many
+	// particles in parallel, kept between calls to reuse their memory:
+	thread_local std::array<std::vector<double>, 3> T;
+	thread_local std::array<std::vector<double>, 9> R;
+	// Sensor positions for each pose:
+	thread_local std::vector<double> sx, sy, sz;
+	// The particles or modes of one beacon:
+	thread_local std::vector<double> bx, by, bz, cxx, cxy, cxz, cyy, cyz,
+		czz;
+	thread_local CVectorDouble logWeights, logLiks;
+
+	// Robot poses, as a structure of arrays:
+	for (auto* v : {&T[0], &T[1], &T[2], &sx, &sy, &sz})
+		v->resize(M);
+	for (auto& v : R)
+		v.resize(M);
+	for (size_t p = 0; p < M; p++)
 	{
-		/********************************************************************
-
-						OBSERVATION TYPE: CObservationBeaconRanges
+		const auto& pose = robotPoses[p];
+		const auto& rot = pose.getRotationMatrix();
+		T[0][p] = pose.x();
+		T[1][p] = pose.y();
+		T[2][p] = pose.z();
+		for (int r = 0; r < 3; r++)
+			for (int c = 0; c < 3; c++)
+				R[r * 3 + c][p] = rot(r, c);
+	}
 
-				Lik. between "this" and "auxMap";
+	const double varR = square(likelihoodOptions.rangeStd);
 
-			********************************************************************/
-		double ret = 0;
-		const auto& o = dynamic_cast<const CObservationBeaconRanges&>(obs);
-		const CBeacon* beac;
-		CPoint3D sensor3D;
+	for (const auto& meas : o.sensedData)
+	{
+		// Look for the beacon in this map:
+		const CBeacon* beac = getBeaconByID(meas.beaconID);
 
-		for (auto& it_obs : o.sensedData)
+		if (beac == nullptr || !(meas.sensedDistance > 0))
 		{
-			// Look for the beacon in this map:
-			beac = getBeaconByID(it_obs.beaconID);
-
-			if (beac != nullptr && it_obs.sensedDistance > 0 &&
-				!std::isnan(it_obs.sensedDistance))
+			// If not found, a uniform distribution:
+			if (o.maxSensorDistance != o.minSensorDistance)
 			{
-				float sensedRange = it_obs.sensedDistance;
+				const double unif =
+					log(1.0 / (o.maxSensorDistance - o.minSensorDistance));
+				for (size_t p = 0; p < M; p++)
+					outLogLiks[p] += unif;
+			}
+			continue;
+		}
 
-				// FOUND: Compute the likelihood function:
-				// -----------------------------------------------------
-				// Compute the 3D position of the sensor:
-				sensor3D = robotPose3D + it_obs.sensorLocationOnRobot;
+		const double sensedRange = meas.sensedDistance;
 
-				// Depending on the PDF type of the beacon in the map:
-				switch (beac->m_typePDF)
+		// Compute the 3D position of the sensor for all poses:
+		const auto& l = meas.sensorLocationOnRobot;
+		const double lx = l.x(), ly = l.y(), lz = l.z();
+		for (size_t p = 0; p < M; p++)
+		{
+			sx[p] = T[0][p] + R[0][p] * lx + R[1][p] * ly + R[2][p] * lz;
+			sy[p] = T[1][p] + R[3][p] * lx + R[4][p] * ly + R[5][p] * lz;
+			sz[p] = T[2][p] + R[6][p] * lx + R[7][p] * ly + R[8][p] * lz;
+		}
+
+		// Copies the means and covariances of Gaussians into the buffers:
+		auto lmbLoadGaussians = [&](size_t n, auto&& gaussian) {
+			for (auto* v : {&bx, &by, &bz, &cxx, &cxy, &cxz, &cyy, &cyz, &czz})
+				v->resize(n);
+			for (size_t k = 0; k < n; k++)
+			{
+				const CPointPDFGaussian& g = gaussian(k);
+				bx[k] = g.mean.x();
+				by[k] = g.mean.y();
+				bz[k] = g.mean.z();
+				cxx[k] = g.cov(0, 0);
+				// (Sums of both off-diagonal terms, which may differ)
+				cxy[k] = g.cov(0, 1) + g.cov(1, 0);
+				cxz[k] = g.cov(0, 2) + g.cov(2, 0);
+				cyy[k] = g.cov(1, 1);
+				cyz[k] = g.cov(1, 2) + g.cov(2, 1);
+				czz[k] = g.cov(2, 2);
+			}
+		};
+		// Log-likelihood of the range from sensor "p" to Gaussian "k", with
+		// the variance of the expected range (H*C*H', H=Jacobian) plus varR:
+		auto lmbGaussianLogLik = [&](size_t p, size_t k) {
+			const double Ax = bx[k] - sx[p], Ay = by[k] - sy[p],
+						 Az = bz[k] - sz[p];
+			const double expectedRange2 = Ax * Ax + Ay * Ay + Az * Az;
+			const double HCHt =
+				(cxx[k] * Ax * Ax + cyy[k] * Ay * Ay + czz[k] * Az * Az +
+				 cxy[k] * Ax * Ay + cxz[k] * Ax * Az + cyz[k] * Ay * Az) /
+				expectedRange2;
+			return -0.5 * square(sensedRange - std::sqrt(expectedRange2)) /
+				(HCHt + varR);
+		};
+
+		// Depending on the PDF type of the beacon in the map:
+		switch (beac->m_typePDF)
+		{
+			// ------------------------------
+			// PDF is MonteCarlo
+			// ------------------------------
+			case CBeacon::pdfMonteCarlo:
+			{
+				const auto& parts = beac->m_locationMC.m_particles;
+				const size_t n = parts.size();
+				if (!n) break;
+				bx.resize(n);
+				by.resize(n);
+				bz.resize(n);
+				logWeights.resize(n);
+				logLiks.resize(n);
+				for (size_t k = 0; k < n; k++)
 				{
-					// ------------------------------
-					// PDF is MonteCarlo
-					// ------------------------------
-					case CBeacon::pdfMonteCarlo:
-					{
-						CPointPDFParticles::CParticleList::const_iterator it;
-						CVectorDouble logWeights(
-							beac->m_locationMC.m_particles.size());
-						CVectorDouble logLiks(
-							beac->m_locationMC.m_particles.size());
-						CVectorDouble::iterator itLW, itLL;
-
-						for (it = beac->m_locationMC.m_particles.begin(),
-							itLW = logWeights.begin(), itLL = logLiks.begin();
-							 it != beac->m_locationMC.m_particles.end();
-							 ++it, ++itLW, ++itLL)
-						{
-							float expectedRange = sensor3D.distance3DTo(
-								it->d->x, it->d->y, it->d->z);
-							// expectedRange +=
-							// float(0.1*(1-exp(-0.16*expectedRange)));
-
-							*itLW = it->log_w;	// Linear weight of this
-							// likelihood component
-							*itLL = -0.5 *
-								square(
-									(sensedRange - expectedRange) /
-									likelihoodOptions.rangeStd);
-							// ret+= exp(
-							// -0.5*square((sensedRange-expectedRange)/likelihoodOptions.rangeStd)
-							// );
-						}  // end for it
-
-						if (logWeights.size())
-							ret += math::averageLogLikelihood(
-								logWeights, logLiks);  // A numerically-stable
-						// method to average the
-						// likelihoods
-					}
-					break;
-					// ------------------------------
-					// PDF is Gaussian
-					// ------------------------------
-					case CBeacon::pdfGauss:
-					{
-						// Compute the Jacobian H and varZ
-						CMatrixFixed<double, 1, 3> H;
-						float varZ, varR = square(likelihoodOptions.rangeStd);
-						float Ax =
-							beac->m_locationGauss.mean.x() - sensor3D.x();
-						float Ay =
-							beac->m_locationGauss.mean.y() - sensor3D.y();
-						float Az =
-							beac->m_locationGauss.mean.z() - sensor3D.z();
-						H(0, 0) = Ax;
-						H(0, 1) = Ay;
-						H(0, 2) = Az;
-						float expectedRange =
-							sensor3D.distanceTo(beac->m_locationGauss.mean);
-						H.asEigen() *=
-							1.0 / expectedRange;  // sqrt(Ax*Ax+Ay*Ay+Az*Az);
-
-						varZ = mrpt::math::multiply_HCHt_scalar(
-							H, beac->m_locationGauss.cov);
-
-						varZ += varR;
-
-						// Compute the mean expected range (add bias!):
-						// expectedRange +=
-						// float(0.1*(1-exp(-0.16*expectedRange)));
-
-						// Compute the likelihood:
-						//   lik \propto exp( -0.5* ( ^z - z  )^2 / varZ );
-						//   log_lik = -0.5* ( ^z - z  )^2 / varZ
-						ret +=
-							-0.5 * square(sensedRange - expectedRange) / varZ;
-					}
-					break;
-					// ------------------------------
-					// PDF is SOG
-					// ------------------------------
-					case CBeacon::pdfSOG:
+					bx[k] = parts[k].d->x;
+					by[k] = parts[k].d->y;
+					bz[k] = parts[k].d->z;
+					logWeights[k] = parts[k].log_w;
+				}
+				for (size_t p = 0; p < M; p++)
+				{
+					for (size_t k = 0; k < n; k++)
 					{
-						CMatrixDouble13 H;
-						CVectorDouble logWeights(beac->m_locationSOG.size());
-						CVectorDouble logLiks(beac->m_locationSOG.size());
-						CVectorDouble::iterator itLW, itLL;
-						CPointPDFSOG::const_iterator it;
-						// For each Gaussian mode:
-						for (it = beac->m_locationSOG.begin(),
-							itLW = logWeights.begin(), itLL = logLiks.begin();
-							 it != beac->m_locationSOG.end();
-							 ++it, ++itLW, ++itLL)
-						{
-							// Compute the Jacobian H and varZ
-							double varZ,
-								varR = square(likelihoodOptions.rangeStd);
-							double Ax = it->val.mean.x() - sensor3D.x();
-							double Ay = it->val.mean.y() - sensor3D.y();
-							double Az = it->val.mean.z() - sensor3D.z();
-							H(0, 0) = Ax;
-							H(0, 1) = Ay;
-							H(0, 2) = Az;
-							double expectedRange =
-								sensor3D.distanceTo(it->val.mean);
-							H.asEigen() *= 1.0 /
-								expectedRange;	// sqrt(Ax*Ax+Ay*Ay+Az*Az);
-
-							varZ = mrpt::math::multiply_HCHt_scalar(
-								H, it->val.cov);
-							varZ += varR;
-
-							// Compute the mean expected range (add bias!):
-							// expectedRange +=
-							// float(0.1*(1-exp(-0.16*expectedRange)));
-
-							// Compute the likelihood:
-							*itLW = it->log_w;	// log-weight of this likelihood
-							// component
-							*itLL = -0.5 * square(sensedRange - expectedRange) /
-								varZ;
-						}  // end for each mode
-
-						// Accumulate to the overall (log) likelihood value:
-						if (logWeights.size())
-							ret += math::averageLogLikelihood(
-								logWeights,
-								logLiks);  // log( linear_lik / sumW );
+						const double expectedRange = std::sqrt(
+							square(bx[k] - sx[p]) + square(by[k] - sy[p]) +
+							square(bz[k] - sz[p]));
+						logLiks[k] = -0.5 *
+							square(
+								(sensedRange - expectedRange) /
+								likelihoodOptions.rangeStd);
 					}
-					break;
-
-					default: THROW_EXCEPTION("Invalid beac->m_typePDF!!!");
-				};
+					// A numerically-stable method to average the
+					// likelihoods:
+					outLogLiks[p] +=
+						math::averageLogLikelihood(logWeights, logLiks);
+				}
+			}
+			break;
+			// ------------------------------
+			// PDF is Gaussian
+			// ------------------------------
+			case CBeacon::pdfGauss:
+			{
+				lmbLoadGaussians(
+					1, [&](size_t) -> const CPointPDFGaussian& {
+						return beac->m_locationGauss;
+					});
+				// Compute the likelihood:
+				//   lik \propto exp( -0.5* ( ^z - z  )^2 / varZ );
+				//   log_lik = -0.5* ( ^z - z  )^2 / varZ
+				for (size_t p = 0; p < M; p++)
+					outLogLiks[p] += lmbGaussianLogLik(p, 0);
 			}
-			else
+			break;
+			// ------------------------------
+			// PDF is SOG
+			// ------------------------------
+			case CBeacon::pdfSOG:
 			{
-				// If not found, a uniform distribution:
-				if (o.maxSensorDistance != o.minSensorDistance)
-					ret +=
-						log(1.0 / (o.maxSensorDistance - o.minSensorDistance));
+				const auto& sog = beac->m_locationSOG;
+				const size_t n = sog.size();
+				if (!n) break;
+				lmbLoadGaussians(n, [&](size_t k) -> const CPointPDFGaussian& {
+					return sog.get(k).val;
+				});
+				logWeights.resize(n);
+				logLiks.resize(n);
+				for (size_t k = 0; k < n; k++)
+					logWeights[k] = sog.get(k).log_w;
+
+				for (size_t p = 0; p < M; p++)
+				{
+					// For each Gaussian mode:
+					for (size_t k = 0; k < n; k++)
+						logLiks[k] = lmbGaussianLogLik(p, k);
+					// Accumulate to the overall (log) likelihood value:
+					//  log( linear_lik / sumW ):
+					outLogLiks[p] +=
+						math::averageLogLikelihood(logWeights, logLiks);
+				}
 			}
-		}  // for each sensed beacon "it"
+			break;
+
+			default: THROW_EXCEPTION("Invalid beac->m_typePDF!!!");
+		};
+	}  // for each sensed beacon
 
-		// printf("ret: %e\n",ret);
+	for (const double ret : outLogLiks)
 		MRPT_CHECK_NORMAL_NUMBER(ret);
-		return ret;
 
-	}  // end of likelihood of CObservationBeaconRanges
-	else
-	{
-		/********************************************************************
-					OBSERVATION TYPE: Unknown
-		********************************************************************/
-		return 0;
-	}
 	MRPT_END
 }
 
@@ -845,11 +886,10 @@ void CBeaconMap::computeMatchingWith3DLandmarks(
 {
 	MRPT_START
 
-	TSequenceBeacons::const_iterator thisIt, otherIt;
+	TSequenceBeacons::const_iterator otherIt;
 	size_t nThis, nOther;
-	unsigned int j, k;
+	unsigned int k;
 	TMatchingPair match;
-	CPointPDFGaussian pointPDF_k, pointPDF_j;
 	vector<bool> thisLandmarkAssigned;
 
 	// Get the number of landmarks:
@@ -865,44 +905,45 @@ void CBeaconMap::computeMatchingWith3DLandmarks(
 	otherCorrespondences.resize(nOther, false);
 	correspondencesRatio = 0;
 
+	// Indices of the beacons in "this" with each ID, in ascending order:
+	std::unordered_map<CBeacon::TBeaconID, std::vector<unsigned int>> thisIdxs;
+	thisIdxs.reserve(nThis);
+	for (unsigned int j = 0; j < nThis; j++)
+		thisIdxs[m_beacons[j].m_ID].push_back(j);
+
 	for (k = 0, otherIt = anotherMap->m_beacons.begin();
 		 otherIt != anotherMap->m_beacons.end(); ++otherIt, ++k)
 	{
-		for (j = 0, thisIt = m_beacons.begin(); thisIt != m_beacons.end();
-			 ++thisIt, ++j)
-		{
-			// Is it a correspondence?
-			if ((otherIt)->m_ID == (thisIt)->m_ID)
-			{
-				// If a previous correspondence for this LM was found, discard
-				// this one!
-				if (!thisLandmarkAssigned[j])
-				{
-					thisLandmarkAssigned[j] = true;
+		const auto itIdxs = thisIdxs.find(otherIt->m_ID);
+		if (itIdxs == thisIdxs.end()) continue;
 
-					// OK: A correspondence found!!
-					otherCorrespondences[k] = true;
+		// Each one is a correspondence:
+		for (const unsigned int j : itIdxs->second)
+		{
+			// If a previous correspondence for this LM was found, discard
+			// this one!
+			if (thisLandmarkAssigned[j]) continue;
+			thisLandmarkAssigned[j] = true;
 
-					match.globalIdx = j;
+			// OK: A correspondence found!!
+			otherCorrespondences[k] = true;
 
-					CPoint3D mean_j = m_beacons[j].getMeanVal();
+			match.globalIdx = j;
 
-					match.global.x = mean_j.x();
-					match.global.y = mean_j.y();
-					match.global.z = mean_j.z();
+			CPoint3D mean_j = m_beacons[j].getMeanVal();
 
-					CPoint3D mean_k = anotherMap->m_beacons[k].getMeanVal();
-					match.localIdx = k;
-					match.local.x = mean_k.x();
-					match.local.y = mean_k.y();
-					match.local.z = mean_k.z();
+			match.global.x = mean_j.x();
+			match.global.y = mean_j.y();
+			match.global.z = mean_j.z();
 
-					correspondences.push_back(match);
-				}
-			}
-
-		}  // end of "otherIt" is SIFT
+			CPoint3D mean_k = anotherMap->m_beacons[k].getMeanVal();
+			match.localIdx = k;
+			match.local.x = mean_k.x();
+			match.local.y = mean_k.y();
+			match.local.z = mean_k.z();
 
+			correspondences.push_back(match);
+		}
 	}  // end of other it., k
 
 	// Compute the corrs ratio:
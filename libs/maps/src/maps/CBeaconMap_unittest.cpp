@@ -0,0 +1,121 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/maps/CBeaconMap.h>
+#include <mrpt/obs/CObservationBeaconRanges.h>
+#include <mrpt/random/RandomGenerators.h>
+
+using namespace mrpt::maps;
+using namespace mrpt::obs;
+using mrpt::poses::CPoint3D;
+using mrpt::poses::CPose3D;
+
+namespace
+{
+CObservationBeaconRanges makeObservation(
+	const std::vector<std::pair<int32_t, float>>& ranges)
+{
+	CObservationBeaconRanges obs;
+	obs.minSensorDistance = 0;
+	obs.maxSensorDistance = 20;
+	for (const auto& [id, r] : ranges)
+	{
+		CObservationBeaconRanges::TMeasurement m;
+		m.beaconID = id;
+		m.sensedDistance = r;
+		m.sensorLocationOnRobot = CPoint3D(0.1, -0.05, 0.3);
+		obs.sensedData.push_back(m);
+	}
+	return obs;
+}
+
+std::vector<CPose3D> somePoses()
+{
+	std::vector<CPose3D> poses;
+	for (int i = 0; i < 25; i++)
+		poses.emplace_back(
+			-2.0 + 0.2 * i, 1.0 - 0.1 * i, 0.01 * i, 0.1 * i, 0.02 * i, 0);
+	return poses;
+}
+
+void expectBatchSameAsSingle(
+	const CBeaconMap& map, const CObservationBeaconRanges& obs)
+{
+	const auto poses = somePoses();
+	std::vector<double> logLiks;
+	map.computeObservationLikelihoodBatch(obs, poses, logLiks);
+	ASSERT_EQ(logLiks.size(), poses.size());
+	for (size_t i = 0; i < poses.size(); i++)
+		EXPECT_NEAR(
+			logLiks[i], map.computeObservationLikelihood(obs, poses[i]),
+			1e-9);
+}
+}  // namespace
+
+TEST(CBeaconMap, likelihoodBatchGaussian)
+{
+	CBeaconMap map;
+	const std::vector<mrpt::math::TPoint3D> beacons = {
+		{2.0, 1.0, 2.5}, {-3.0, 4.0, 2.0}, {0.0, -5.0, 3.0}};
+	for (size_t i = 0; i < beacons.size(); i++)
+	{
+		CBeacon b;
+		b.m_ID = static_cast<CBeacon::TBeaconID>(i);
+		b.m_typePDF = CBeacon::pdfGauss;
+		b.m_locationGauss.mean = CPoint3D(beacons[i]);
+		b.m_locationGauss.cov.setZero();
+		map.push_back(b);
+	}
+
+	// Beacon #7 is not in the map:
+	const auto obs = makeObservation({{0, 3.1f}, {2, 5.6f}, {7, 1.0f}});
+
+	const auto poses = somePoses();
+	std::vector<double> logLiks;
+	map.computeObservationLikelihoodBatch(obs, poses, logLiks);
+	ASSERT_EQ(logLiks.size(), poses.size());
+
+	const double varR = mrpt::square(map.likelihoodOptions.rangeStd);
+	for (size_t i = 0; i < poses.size(); i++)
+	{
+		double expected = std::log(1.0 / 20.0);
+		for (const auto& m : obs.sensedData)
+		{
+			if (m.beaconID >= static_cast<int32_t>(beacons.size())) continue;
+			const auto sensor = poses[i] + m.sensorLocationOnRobot;
+			const double r =
+				sensor.asTPoint().distanceTo(beacons.at(m.beaconID));
+			expected += -0.5 * mrpt::square(m.sensedDistance - r) / varR;
+		}
+		EXPECT_NEAR(logLiks[i], expected, 1e-6 * std::abs(expected));
+	}
+
+	expectBatchSameAsSingle(map, obs);
+}
+
+TEST(CBeaconMap, likelihoodBatchMonteCarloAndSOG)
+{
+	mrpt::random::getRandomGenerator().randomize(123);
+
+	const auto obs = makeObservation({{0, 3.0f}, {1, 4.5f}});
+	for (const bool asMonteCarlo : {true, false})
+	{
+		CBeaconMap map;
+		map.insertionOptions.insertAsMonteCarlo = asMonteCarlo;
+		map.insertionOptions.MC_numSamplesPerMeter = 50;
+		map.insertObservation(obs, CPose3D(0.5, 0.2, 0, 0.3, 0, 0));
+		ASSERT_EQ(map.size(), 2U);
+		EXPECT_EQ(
+			map.get(0).m_typePDF,
+			asMonteCarlo ? CBeacon::pdfMonteCarlo : CBeacon::pdfSOG);
+
+		expectBatchSameAsSingle(map, obs);
+	}
+}
@@ -0,0 +1,122 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "maps-precomp.h"  // Precomp header
+//
+#include <mrpt/core/bits_math.h>
+#include <mrpt/core/exceptions.h>
+#include <mrpt/maps/CBeamFootprintCache.h>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace mrpt::maps;
+
+CBeamFootprintCache::CBeamFootprintCache(
+	unsigned int headingSubdivisions, unsigned int subCellBins,
+	size_t maxCachedSteps)
+	: m_headingSubdivisions(headingSubdivisions),
+	  m_subCellBins(subCellBins),
+	  m_maxCachedSteps(maxCachedSteps)
+{
+	ASSERT_GT_(headingSubdivisions, 0U);
+	ASSERT_GT_(subCellBins, 0U);
+}
+
+void CBeamFootprintCache::clear() { m_sets.clear(); }
+
+size_t CBeamFootprintCache::getCachedSteps() const
+{
+	size_t n = 0;
+	for (const auto& kv : m_sets)
+		for (const auto& s : kv.second)
+			n += s.m_steps;
+	return n;
+}
+
+CBeamFootprintCache::TFootprintSet& CBeamFootprintCache::getFootprints(
+	const mrpt::obs::T2DScanProperties& scanProps, float cell_frac_x,
+	float cell_frac_y)
+{
+	ASSERT_GT_(scanProps.nRays, 0U);
+	if (getCachedSteps() > m_maxCachedSteps) clear();
+
+	auto it = m_sets.find(scanProps);
+	if (it == m_sets.end())
+	{
+		// Angular step between beams, as used while inserting scans:
+		double dA = scanProps.aperture / scanProps.nRays;
+		if (dA <= 0) dA = mrpt::DEG2RAD(1.0);
+		const size_t nDirs = std::max<size_t>(
+			1, static_cast<size_t>(
+				   std::round(2 * M_PI * m_headingSubdivisions / dA)));
+
+		std::vector<TFootprintSet> sets(m_subCellBins * m_subCellBins);
+		for (unsigned int by = 0; by < m_subCellBins; by++)
+		{
+			for (unsigned int bx = 0; bx < m_subCellBins; bx++)
+			{
+				auto& s = sets[bx + by * m_subCellBins];
+				s.m_dirStep = 2 * M_PI / nDirs;
+				s.m_u0 = (bx + 0.5f) / m_subCellBins;
+				s.m_v0 = (by + 0.5f) / m_subCellBins;
+				s.m_cos.resize(nDirs);
+				s.m_sin.resize(nDirs);
+				for (size_t i = 0; i < nDirs; i++)
+				{
+					s.m_cos[i] = static_cast<float>(std::cos(i * s.m_dirStep));
+					s.m_sin[i] = static_cast<float>(std::sin(i * s.m_dirStep));
+				}
+				s.m_footprints.resize(nDirs);
+			}
+		}
+		it = m_sets.emplace(scanProps, std::move(sets)).first;
+	}
+
+	const auto bin = [this](float f) {
+		return std::clamp<int>(
+			static_cast<int>(f * m_subCellBins), 0, m_subCellBins - 1);
+	};
+	return it->second[bin(cell_frac_x) + bin(cell_frac_y) * m_subCellBins];
+}
+
+size_t CBeamFootprintCache::TFootprintSet::directionIndex(double angle) const
+{
+	const auto n = static_cast<long>(m_cos.size());
+	long i = std::lround(angle / m_dirStep) % n;
+	if (i < 0) i += n;
+	return static_cast<size_t>(i);
+}
+
+const CBeamFootprintCache::TFootprint&
+	CBeamFootprintCache::TFootprintSet::footprint(size_t dir, size_t nSteps)
+{
+	TFootprint& fp = m_footprints[dir];
+	const size_t n0 = fp.dx.size();
+	if (nSteps <= n0) return fp;
+	ASSERT_LT_(nSteps, 32767U);
+
+	// Rasterize a bit more than needed, to avoid growing it too often:
+	const size_t n1 = std::min<size_t>(32766, (nSteps + 63) & ~size_t(63));
+
+	// One cell per step along the major axis; since the position of each
+	// cell only depends on its step index, footprints can be extended.
+	const double c = m_cos[dir], s = m_sin[dir];
+	const double major = std::max(std::abs(c), std::abs(s));
+	const double ux = c / major, uy = s / major;
+	fp.dx.resize(n1);
+	fp.dy.resize(n1);
+	for (size_t k = n0; k < n1; k++)
+	{
+		fp.dx[k] = static_cast<int16_t>(std::floor(m_u0 + k * ux));
+		fp.dy[k] = static_cast<int16_t>(std::floor(m_v0 + k * uy));
+	}
+	m_steps += n1 - n0;
+	return fp;
+}
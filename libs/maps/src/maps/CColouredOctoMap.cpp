@@ -134,6 +134,7 @@ void CColouredOctoMap::serializeFrom(
 				ss.str(buf);
 				ss.seekg(0);
 				m_impl->m_octomap.readBinary(ss);
+				m_impl->voxelsSync = {};
 			}
 		}
 		break;
@@ -192,9 +193,7 @@ bool CColouredOctoMap::internal_insertObservation(
 		}
 
 		// Insert rays:
-		m_impl->m_octomap.insertPointCloud(
-			scan, sensorPt, insertionOptions.maxrange,
-			insertionOptions.pruning);
+		internal_insertScan(sensorPt, scan);
 		return true;
 	}
 	else if (IS_CLASS(obs, CObservation3DRangeScan))
@@ -235,17 +234,17 @@ bool CColouredOctoMap::internal_insertObservation(
 
 		// Insert rays:
 		octomap::KeySet free_cells, occupied_cells;
-		m_impl->m_octomap.computeUpdate(
-			scan, sensorPt, free_cells, occupied_cells,
-			insertionOptions.maxrange);
+		internal_computeScanUpdate(sensorPt, scan, free_cells, occupied_cells);
 
 		// insert data into tree  -----------------------
 		for (const auto& free_cell : free_cells)
 		{
+			internal_markModifiedVoxel(free_cell);
 			m_impl->m_octomap.updateNode(free_cell, false, false);
 		}
 		for (const auto& occupied_cell : occupied_cells)
 		{
+			internal_markModifiedVoxel(occupied_cell);
 			m_impl->m_octomap.updateNode(occupied_cell, true, false);
 		}
 
@@ -299,6 +298,10 @@ void CColouredOctoMap::updateVoxelColour(
 	const double x, const double y, const double z, const uint8_t r,
 	const uint8_t g, const uint8_t b)
 {
+	octomap::OcTreeKey key;
+	if (m_impl->m_octomap.coordToKeyChecked(octomap::point3d(x, y, z), key))
+		internal_markModifiedVoxel(key);
+
 	switch (m_colour_method)
 	{
 		case INTEGRATE:
@@ -312,6 +315,22 @@ void CColouredOctoMap::updateVoxelColour(
 	}
 }
 
+void CColouredOctoMap::internal_mergeVoxelData(
+	const octomap::ColorOcTreeNode& otherNode, double x, double y, double z)
+{
+	const octomap::ColorOcTreeNode::Color c = otherNode.getColor();
+	updateVoxelColour(x, y, z, c.r, c.g, c.b);
+}
+
+mrpt::img::TColor CColouredOctoMap::internal_getVoxelColor(
+	const octomap::ColorOcTreeNode& node, [[maybe_unused]] double z,
+	[[maybe_unused]] double zmin, [[maybe_unused]] double inv_dz,
+	[[maybe_unused]] const mrpt::opengl::COctoMapVoxels& gl_obj) const
+{
+	const octomap::ColorOcTreeNode::Color c = node.getColor();
+	return TColor(c.r, c.g, c.b);
+}
+
 /** Builds a renderizable representation of the octomap as a
  * mrpt::opengl::COctoMapVoxels object. */
 void CColouredOctoMap::getAsOctoMapVoxels(
@@ -360,9 +379,8 @@ void CColouredOctoMap::getAsOctoMapVoxels(
 			if ((occ >= 0.5 && renderingOptions.generateOccupiedVoxels) ||
 				(occ < 0.5 && renderingOptions.generateFreeVoxels))
 			{
-				mrpt::img::TColor vx_color;
-				octomap::ColorOcTreeNode::Color node_color = it->getColor();
-				vx_color = TColor(node_color.r, node_color.g, node_color.b);
+				const mrpt::img::TColor vx_color = internal_getVoxelColor(
+					*it, vx_center.z(), zmin, 0, gl_obj);
 
 				const size_t vx_set = (m_impl->m_octomap.isNodeOccupied(*it))
 					? VOXEL_SET_OCCUPIED
@@ -404,14 +422,18 @@ void CColouredOctoMap::insertRay(
 	const float end_x, const float end_y, const float end_z,
 	const float sensor_x, const float sensor_y, const float sensor_z)
 {
+	const octomap::point3d sensorPt(sensor_x, sensor_y, sensor_z),
+		endPt(end_x, end_y, end_z);
+	internal_markModifiedRay(sensorPt, endPt);
 	m_impl->m_octomap.insertRay(
-		octomap::point3d(sensor_x, sensor_y, sensor_z),
-		octomap::point3d(end_x, end_y, end_z), insertionOptions.maxrange,
-		insertionOptions.pruning);
+		sensorPt, endPt, insertionOptions.maxrange, insertionOptions.pruning);
 }
 void CColouredOctoMap::updateVoxel(
 	const double x, const double y, const double z, bool occupied)
 {
+	octomap::OcTreeKey key;
+	if (m_impl->m_octomap.coordToKeyChecked(octomap::point3d(x, y, z), key))
+		internal_markModifiedVoxel(key);
 	m_impl->m_octomap.updateNode(x, y, z, occupied);
 }
 bool CColouredOctoMap::isPointWithinOctoMap(
@@ -535,4 +557,8 @@ float CColouredOctoMap::getClampingThresMaxLog() const
 {
 	return m_impl->m_octomap.getClampingThresMaxLog();
 }
-void CColouredOctoMap::internal_clear() { m_impl->m_octomap.clear(); }
+void CColouredOctoMap::internal_clear()
+{
+	m_impl->m_octomap.clear();
+	m_impl->voxelsSync = {};
+}
@@ -122,7 +122,7 @@ void CColouredPointsMap::impl_copyFrom(const CPointsMap& obj)
 	}
 }
 
-uint8_t CColouredPointsMap::serializeGetVersion() const { return 9; }
+uint8_t CColouredPointsMap::serializeGetVersion() const { return 10; }
 void CColouredPointsMap::serializeTo(mrpt::serialization::CArchive& out) const
 {
 	uint32_t n = m_x.size();
@@ -142,6 +142,7 @@ void CColouredPointsMap::serializeTo(mrpt::serialization::CArchive& out) const
 	insertionOptions.writeToStream(
 		out);  // version 9?: insert options are saved with its own method
 	likelihoodOptions.writeToStream(out);  // Added in version 5
+	writeLocalSurfaceGeometry(out);	 // v10
 }
 
 void CColouredPointsMap::serializeFrom(
@@ -151,6 +152,7 @@ void CColouredPointsMap::serializeFrom(
 	{
 		case 8:
 		case 9:
+		case 10:
 		{
 			mark_as_modified();
 
@@ -177,6 +179,7 @@ void CColouredPointsMap::serializeFrom(
 			}
 			insertionOptions.readFromStream(in);
 			likelihoodOptions.readFromStream(in);
+			if (version >= 10) readLocalSurfaceGeometry(in);
 		}
 		break;
 
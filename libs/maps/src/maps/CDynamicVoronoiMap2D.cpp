@@ -0,0 +1,293 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "maps-precomp.h"  // Precomp header
+//
+#include <mrpt/core/exceptions.h>
+#include <mrpt/maps/CDynamicVoronoiMap2D.h>
+#include <mrpt/maps/COccupancyGridMap2D.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace mrpt::maps;
+
+bool CDynamicVoronoiMap2D::gridCellIsObstacle(
+	const COccupancyGridMap2D& grid, int cx, int cy) const
+{
+	return 1.0f - grid.getCell(cx, cy) > m_occupiedThreshold;
+}
+
+bool CDynamicVoronoiMap2D::sameGeometry(const COccupancyGridMap2D& grid) const
+{
+	return grid.getSizeX() == m_size_x && grid.getSizeY() == m_size_y &&
+		grid.getXMin() == m_x_min && grid.getYMin() == m_y_min &&
+		grid.getResolution() == m_resolution;
+}
+
+void CDynamicVoronoiMap2D::initialize(
+	const COccupancyGridMap2D& grid, float occupiedThreshold, float maxDistance)
+{
+	MRPT_START
+
+	m_size_x = grid.getSizeX();
+	m_size_y = grid.getSizeY();
+	m_x_min = grid.getXMin();
+	m_y_min = grid.getYMin();
+	m_resolution = grid.getResolution();
+	m_occupiedThreshold = occupiedThreshold;
+	m_maxDistance = maxDistance;
+	m_maxSqDist = SQDIST_INF;
+	if (maxDistance > 0)
+	{
+		const double d = maxDistance / m_resolution;
+		m_maxSqDist = static_cast<int32_t>(
+			std::min<double>(d * d, std::numeric_limits<int32_t>::max() - 1));
+	}
+
+	m_cells.assign(static_cast<size_t>(m_size_x) * m_size_y, TCell());
+	m_addList.clear();
+	m_removeList.clear();
+	m_open = decltype(m_open)();
+
+	for (unsigned int cy = 0; cy < m_size_y; cy++)
+		for (unsigned int cx = 0; cx < m_size_x; cx++)
+			if (gridCellIsObstacle(grid, cx, cy)) setObstacle(cx, cy);
+	processChanges();
+
+	MRPT_END
+}
+
+void CDynamicVoronoiMap2D::update(
+	const COccupancyGridMap2D& grid, int cx0, int cy0, int cx1, int cy1)
+{
+	MRPT_START
+
+	if (!sameGeometry(grid))
+	{
+		initialize(grid, m_occupiedThreshold, m_maxDistance);
+		return;
+	}
+
+	cx0 = std::max(cx0, 0);
+	cy0 = std::max(cy0, 0);
+	cx1 = std::min(cx1, static_cast<int>(m_size_x) - 1);
+	cy1 = std::min(cy1, static_cast<int>(m_size_y) - 1);
+
+	for (int cy = cy0; cy <= cy1; cy++)
+	{
+		for (int cx = cx0; cx <= cx1; cx++)
+		{
+			const bool occ = gridCellIsObstacle(grid, cx, cy);
+			if (occ == isOccupied(idx(cx, cy))) continue;
+			if (occ)
+				setObstacle(cx, cy);
+			else
+				removeObstacle(cx, cy);
+		}
+	}
+	processChanges();
+
+	MRPT_END
+}
+
+void CDynamicVoronoiMap2D::update(const COccupancyGridMap2D& grid)
+{
+	update(grid, 0, 0, grid.getSizeX() - 1, grid.getSizeY() - 1);
+}
+
+void CDynamicVoronoiMap2D::setObstacle(int cx, int cy)
+{
+	ASSERT_LT_(static_cast<unsigned int>(cx), m_size_x);
+	ASSERT_LT_(static_cast<unsigned int>(cy), m_size_y);
+	const int32_t i = idx(cx, cy);
+	if (isOccupied(i)) return;
+	m_addList.push_back(i);
+	m_cells[i].obst = i;
+}
+
+void CDynamicVoronoiMap2D::removeObstacle(int cx, int cy)
+{
+	ASSERT_LT_(static_cast<unsigned int>(cx), m_size_x);
+	ASSERT_LT_(static_cast<unsigned int>(cy), m_size_y);
+	const int32_t i = idx(cx, cy);
+	if (!isOccupied(i)) return;
+	m_removeList.push_back(i);
+	m_cells[i].obst = INVALID;
+	m_cells[i].queueing = Queueing::None;
+}
+
+void CDynamicVoronoiMap2D::processChanges()
+{
+	// New obstacles start "lower" waves:
+	for (const int32_t i : m_addList)
+	{
+		TCell& c = m_cells[i];
+		if (!isOccupied(i)) continue;  // Added, then removed again
+		c.sqdist = 0;
+		c.needsRaise = false;
+		c.queueing = Queueing::FwQueued;
+		m_open.emplace(0, i);
+	}
+	// Removed obstacles start "raise" waves:
+	for (const int32_t i : m_removeList)
+	{
+		TCell& c = m_cells[i];
+		if (isOccupied(i)) continue;  // Removed, then added again
+		c.sqdist = SQDIST_INF;
+		c.needsRaise = true;
+		m_open.emplace(0, i);
+	}
+	m_addList.clear();
+	m_removeList.clear();
+
+	const int sx = static_cast<int>(m_size_x), sy = static_cast<int>(m_size_y);
+	m_lastUpdatedCells = 0;
+
+	while (!m_open.empty())
+	{
+		const int32_t i = m_open.top().second;
+		m_open.pop();
+		TCell& c = m_cells[i];
+		if (c.queueing == Queueing::FwProcessed) continue;
+		m_lastUpdatedCells++;
+
+		const int x = i % sx, y = i / sx;
+		const int nx0 = std::max(x - 1, 0), nx1 = std::min(x + 1, sx - 1);
+		const int ny0 = std::max(y - 1, 0), ny1 = std::min(y + 1, sy - 1);
+
+		if (c.needsRaise)
+		{
+			// Raise: invalidate the neighbors whose obstacle vanished, and
+			// queue the others so they "lower" again into the cleared area:
+			for (int ny = ny0; ny <= ny1; ny++)
+			{
+				for (int nx = nx0; nx <= nx1; nx++)
+				{
+					const int32_t n = idx(nx, ny);
+					if (n == i) continue;
+					TCell& nc = m_cells[n];
+					if (nc.obst == INVALID || nc.needsRaise) continue;
+					if (!isOccupied(nc.obst))
+					{
+						m_open.emplace(nc.sqdist, n);
+						nc.queueing = Queueing::FwQueued;
+						nc.needsRaise = true;
+						nc.obst = INVALID;
+						nc.sqdist = SQDIST_INF;
+					}
+					else if (nc.queueing != Queueing::FwQueued)
+					{
+						m_open.emplace(nc.sqdist, n);
+						nc.queueing = Queueing::FwQueued;
+					}
+				}
+			}
+			c.needsRaise = false;
+			c.queueing = Queueing::BwProcessed;
+		}
+		else if (c.obst != INVALID && isOccupied(c.obst))
+		{
+			// Lower: propagate our closest obstacle to the neighbors:
+			c.queueing = Queueing::FwProcessed;
+			const int ox = c.obst % sx, oy = c.obst / sx;
+			for (int ny = ny0; ny <= ny1; ny++)
+			{
+				for (int nx = nx0; nx <= nx1; nx++)
+				{
+					const int32_t n = idx(nx, ny);
+					if (n == i) continue;
+					TCell& nc = m_cells[n];
+					if (nc.needsRaise) continue;
+					const int32_t dx = nx - ox, dy = ny - oy;
+					const int32_t d2 = dx * dx + dy * dy;
+					if (d2 > m_maxSqDist) continue;
+					bool overwrite = d2 < nc.sqdist;
+					if (!overwrite && d2 == nc.sqdist)
+						overwrite =
+							nc.obst == INVALID || !isOccupied(nc.obst);
+					if (!overwrite) continue;
+					m_open.emplace(d2, n);
+					nc.queueing = Queueing::FwQueued;
+					nc.sqdist = d2;
+					nc.obst = c.obst;
+				}
+			}
+		}
+	}
+}
+
+float CDynamicVoronoiMap2D::getClearanceCells(int cx, int cy) const
+{
+	const TCell& c = m_cells[idx(cx, cy)];
+	if (c.obst == INVALID) return std::numeric_limits<float>::infinity();
+	return std::sqrt(static_cast<float>(c.sqdist));
+}
+
+float CDynamicVoronoiMap2D::getClearance(float x, float y) const
+{
+	const int cx = static_cast<int>(std::floor((x - m_x_min) / m_resolution));
+	const int cy = static_cast<int>(std::floor((y - m_y_min) / m_resolution));
+	if (cx < 0 || cy < 0 || cx >= static_cast<int>(m_size_x) ||
+		cy >= static_cast<int>(m_size_y))
+		return 0;
+
+	const TCell& c = m_cells[idx(cx, cy)];
+	if (c.obst == INVALID) return std::numeric_limits<float>::infinity();
+	const int sx = static_cast<int>(m_size_x);
+	const float ox = m_x_min + (c.obst % sx + 0.5f) * m_resolution;
+	const float oy = m_y_min + (c.obst / sx + 0.5f) * m_resolution;
+	return std::hypot(x - ox, y - oy);
+}
+
+bool CDynamicVoronoiMap2D::getClosestObstacle(
+	int cx, int cy, int& ox, int& oy) const
+{
+	const TCell& c = m_cells[idx(cx, cy)];
+	if (c.obst == INVALID) return false;
+	ox = c.obst % static_cast<int>(m_size_x);
+	oy = c.obst / static_cast<int>(m_size_x);
+	return true;
+}
+
+bool CDynamicVoronoiMap2D::isVoronoi(int cx, int cy) const
+{
+	// Same criterion than in the paper by Lau et al., evaluated from the
+	// current distance map, so it never needs to be updated:
+	const int32_t i = idx(cx, cy);
+	const TCell& c = m_cells[i];
+	if (c.obst == INVALID || isOccupied(i) || c.sqdist <= 2) return false;
+
+	const int sx = static_cast<int>(m_size_x), sy = static_cast<int>(m_size_y);
+	const int ox = c.obst % sx, oy = c.obst / sx;
+	for (int ny = std::max(cy - 1, 0); ny <= std::min(cy + 1, sy - 1); ny++)
+	{
+		for (int nx = std::max(cx - 1, 0); nx <= std::min(cx + 1, sx - 1);
+			 nx++)
+		{
+			const TCell& nc = m_cells[idx(nx, ny)];
+			if (nc.obst == INVALID) continue;
+			const int nox = nc.obst % sx, noy = nc.obst / sx;
+			// Both obstacles must be distinct (not adjacent) cells:
+			if (std::abs(ox - nox) <= 1 && std::abs(oy - noy) <= 1) continue;
+
+			// "Stability": how much farther the obstacle of the other cell
+			// is, compared to the own closest one. The more stable cell of
+			// the pair (or both, if tied) belongs to the diagram:
+			const int32_t stab = (cx - nox) * (cx - nox) +
+				(cy - noy) * (cy - noy) - c.sqdist;
+			const int32_t nstab = (nx - ox) * (nx - ox) +
+				(ny - oy) * (ny - oy) - nc.sqdist;
+			if (stab < 0 || nstab < 0) continue;
+			if (stab <= nstab) return true;
+		}
+	}
+	return false;
+}
@@ -0,0 +1,105 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/maps/CDynamicVoronoiMap2D.h>
+#include <mrpt/maps/COccupancyGridMap2D.h>
+#include <mrpt/random/RandomGenerators.h>
+
+#include <cmath>
+
+using mrpt::maps::CDynamicVoronoiMap2D;
+using mrpt::maps::COccupancyGridMap2D;
+
+static float bruteForceClearance(const COccupancyGridMap2D& grid, int x, int y)
+{
+	float best = std::numeric_limits<float>::infinity();
+	for (unsigned int oy = 0; oy < grid.getSizeY(); oy++)
+		for (unsigned int ox = 0; ox < grid.getSizeX(); ox++)
+			if (grid.getCell(ox, oy) < 0.5f)
+				best = std::min(best, std::hypot(x - ox * 1.0f, y - oy * 1.0f));
+	return best;
+}
+
+TEST(CDynamicVoronoiMap2D, incrementalClearance)
+{
+	COccupancyGridMap2D grid(0, 6.0f, 0, 5.0f, 0.1f);
+	const int W = grid.getSizeX(), H = grid.getSizeY();
+
+	auto& rng = mrpt::random::getRandomGenerator();
+	rng.randomize(123);
+	for (int i = 0; i < 40; i++)
+		grid.setCell(
+			rng.drawUniform32bit() % W, rng.drawUniform32bit() % H, 0.1f);
+
+	CDynamicVoronoiMap2D voronoi;
+	voronoi.initialize(grid);
+
+	// Add and remove blobs of obstacles:
+	for (int i = 0; i < 100; i++)
+	{
+		const int x = rng.drawUniform32bit() % (W - 2);
+		const int y = rng.drawUniform32bit() % (H - 2);
+		const float v = (i % 2) ? 0.1f : 0.9f;
+		for (int dy = 0; dy < 3; dy++)
+			for (int dx = 0; dx < 3; dx++)
+				grid.setCell(x + dx, y + dy, v);
+		voronoi.update(grid, x, y, x + 2, y + 2);
+	}
+
+	for (int y = 0; y < H; y++)
+		for (int x = 0; x < W; x++)
+		{
+			EXPECT_EQ(voronoi.isObstacle(x, y), grid.getCell(x, y) < 0.5f);
+			EXPECT_NEAR(
+				voronoi.getClearanceCells(x, y),
+				bruteForceClearance(grid, x, y), 1e-4f);
+		}
+}
+
+TEST(CDynamicVoronoiMap2D, corridor)
+{
+	// A horizontal corridor between y=1.05 and y=3.05:
+	COccupancyGridMap2D grid(0, 10.0f, 0, 4.0f, 0.1f);
+	for (float x = 0.05f; x < 10.0f; x += 0.1f)
+	{
+		grid.setPos(x, 1.05f, 0.0f);
+		grid.setPos(x, 3.05f, 0.0f);
+	}
+
+	CDynamicVoronoiMap2D voronoi;
+	voronoi.initialize(grid);
+
+	EXPECT_NEAR(voronoi.getClearance(5.05f, 2.05f), 1.0f, 1e-4f);
+	EXPECT_NEAR(voronoi.getClearance(5.05f, 1.55f), 0.5f, 1e-4f);
+	EXPECT_NEAR(voronoi.getClearance(5.05f, 1.05f), 0.0f, 1e-4f);
+	EXPECT_EQ(voronoi.getClearance(-1.0f, 2.0f), 0.0f);
+
+	const int cy = grid.y2idx(2.05f);
+	for (int cx = 5; cx < 95; cx++)
+	{
+		EXPECT_TRUE(voronoi.isVoronoi(cx, cy));
+		EXPECT_FALSE(voronoi.isVoronoi(cx, cy - 5));
+	}
+
+	// Open a door in the lower wall: only the nearby cells are visited.
+	for (float x = 4.55f; x < 5.5f; x += 0.1f)
+		grid.setPos(x, 1.05f, 1.0f);
+	voronoi.update(grid);
+	EXPECT_LT(voronoi.getLastUpdatedCellCount(), 1500U);
+	EXPECT_GT(voronoi.getClearance(5.05f, 1.05f), 0.4f);
+	int ox, oy;
+	ASSERT_TRUE(voronoi.getClosestObstacle(grid.x2idx(5.05f), cy, ox, oy));
+	EXPECT_EQ(oy, grid.y2idx(3.05f));
+
+	// Unlimited propagation vs. maxDistance:
+	voronoi.initialize(grid, 0.5f, 0.25f);
+	EXPECT_TRUE(std::isinf(voronoi.getClearance(5.05f, 2.05f)));
+	EXPECT_NEAR(voronoi.getClearance(8.05f, 1.25f), 0.2f, 1e-4f);
+}
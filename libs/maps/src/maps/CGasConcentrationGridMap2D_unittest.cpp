@@ -11,6 +11,8 @@
 #include <mrpt/maps/CGasConcentrationGridMap2D.h>
 #include <mrpt/system/filesystem.h>
 
+#include <cmath>
+
 const double xMin = -4.0, xMax = 4.0, yMin = -4.0, yMax = 4.0;
 const double val = 0.2, sigma = 1.0;
 const bool ti = true;  // time invariant
@@ -74,3 +76,50 @@ TEST(CGasConcentrationGridMap2D, insertAndRead)
 		[](const mrpt::maps::TRandomFieldCell& c) { return c.dm_mean(); });
 #endif
 }
+
+static void test_CGasConcentrationGridMap2D_insertBatch(
+	mrpt::maps::CRandomFieldGridMap2D::TMapRepresentation mapType)
+{
+	std::vector<double> readings;
+	std::vector<mrpt::math::TPoint2D> points;
+	for (int i = 0; i < 5000; i++)
+	{
+		// Deterministic, scattered positions:
+		points.emplace_back(
+			3.0 * std::sin(0.37 * i), 3.0 * std::cos(0.23 * i + 1.0));
+		readings.push_back(0.5 + 0.4 * std::sin(0.11 * i));
+	}
+
+	mrpt::maps::CGasConcentrationGridMap2D gridOneByOne(
+		mapType, xMin, xMax, yMin, yMax, 0.1);
+	for (size_t i = 0; i < points.size(); i++)
+		gridOneByOne.insertIndividualReading(readings[i], points[i]);
+
+	for (unsigned int nThreads : {1U, 4U})
+	{
+		mrpt::maps::CGasConcentrationGridMap2D grid(
+			mapType, xMin, xMax, yMin, yMax, 0.1);
+		grid.insertionOptions.numThreads = nThreads;
+		grid.insertIndividualReadings(readings, points);
+
+		for (double x = -3.5; x < 3.5; x += 0.1)
+			for (double y = -3.5; y < 3.5; y += 0.1)
+			{
+				const auto* c1 = gridOneByOne.cellByPos(x, y);
+				const auto* c2 = grid.cellByPos(x, y);
+				ASSERT_TRUE(c1 != nullptr && c2 != nullptr);
+				EXPECT_NEAR(c1->dm_mean(), c2->dm_mean(), 1e-9)
+					<< "mapType: " << mapType << " nThreads: " << nThreads;
+				EXPECT_NEAR(c1->dm_mean_w(), c2->dm_mean_w(), 1e-9);
+				EXPECT_NEAR(c1->dmv_var_mean, c2->dmv_var_mean, 1e-9);
+			}
+	}
+}
+
+TEST(CGasConcentrationGridMap2D, insertIndividualReadings)
+{
+	test_CGasConcentrationGridMap2D_insertBatch(
+		mrpt::maps::CRandomFieldGridMap2D::mrKernelDM);
+	test_CGasConcentrationGridMap2D_insertBatch(
+		mrpt::maps::CRandomFieldGridMap2D::mrKernelDMV);
+}
@@ -14,10 +14,14 @@
 #include <mrpt/maps/CHeightGridMap2D.h>
 #include <mrpt/opengl/CMesh.h>
 #include <mrpt/opengl/CPointCloudColoured.h>
+#include <mrpt/opengl/CTerrainMesh.h>
 #include <mrpt/poses/CPose3D.h>
 #include <mrpt/serialization/CArchive.h>
 #include <mrpt/serialization/stl_serialization.h>
 
+#include <algorithm>
+#include <thread>
+
 using namespace mrpt::maps;
 using namespace mrpt::obs;
 using namespace mrpt::poses;
@@ -96,6 +100,17 @@ void mrpt::global_settings::HEIGHTGRIDMAP_EXPORT3D_AS_MESH(bool value)
 	HEIGHTGRIDMAP_EXPORT3D_AS_MESH_value = value;
 }
 
+size_t HEIGHTGRIDMAP_EXPORT3D_LOD_MIN_CELLS_value = 1000000;
+
+size_t mrpt::global_settings::HEIGHTGRIDMAP_EXPORT3D_LOD_MIN_CELLS()
+{
+	return HEIGHTGRIDMAP_EXPORT3D_LOD_MIN_CELLS_value;
+}
+void mrpt::global_settings::HEIGHTGRIDMAP_EXPORT3D_LOD_MIN_CELLS(size_t cells)
+{
+	HEIGHTGRIDMAP_EXPORT3D_LOD_MIN_CELLS_value = cells;
+}
+
 /*---------------------------------------------------------------
 						Constructor
   ---------------------------------------------------------------*/
@@ -116,6 +131,28 @@ void CHeightGridMap2D::internal_clear() { fill(THeightGridmapCell()); }
 						isEmpty
   ---------------------------------------------------------------*/
 bool CHeightGridMap2D::isEmpty() const { return false; }
+namespace
+{
+// Running average and variance of the heights in one cell:
+inline void updateCellHeight(THeightGridmapCell& cell, const float z)
+{
+	cell.u += z;
+	cell.v += z * z;
+	if (!cell.w)
+	{
+		cell.h = z;  // First observation
+		cell.w = 1;
+	}
+	else
+	{
+		float W = cell.w++;  // W = N-1
+		cell.h = (cell.h * W + z) / cell.w;
+		if (W > 0)
+			cell.var = (cell.v - mrpt::d2f(pow(cell.u, 2)) / cell.w) / W;
+	}
+}
+}  // namespace
+
 bool CHeightGridMap2D::insertIndividualPoint(
 	const double x, const double y, const double zz,
 	const CHeightGridMap2D_Base::TPointInsertParams& params)
@@ -127,23 +164,75 @@ bool CHeightGridMap2D::insertIndividualPoint(
 	const float z = d2f(zz);
 	if (!insertionOptions.filterByHeight ||
 		(z >= insertionOptions.z_min && z <= insertionOptions.z_max))
-	{
-		cell->u += z;
-		cell->v += z * z;
-		if (!cell->w)
+		updateCellHeight(*cell, z);
+	return true;
+}
+
+size_t CHeightGridMap2D::insertPoints(
+	const mrpt::math::TPointCloudView& pts, const TPointInsertParams& params)
+{
+	const size_t N = pts.count;
+	const int nCells = static_cast<int>(m_map.size());
+
+	size_t nThreads = insertionOptions.numThreads;
+	if (nThreads == 0) nThreads = std::thread::hardware_concurrency();
+	// Less than this number of points per thread is not worth a thread:
+	constexpr size_t minPointsPerThread = 16384;
+	nThreads = std::max<size_t>(
+		1,
+		std::min<size_t>({nThreads, N / minPointsPerThread, m_map.size()}));
+
+	// 1) The cell index of each point, computed in parallel:
+	//    (-1: out of the map, -2: filtered out by height)
+	constexpr int OUT_OF_MAP = -1, FILTERED_OUT = -2;
+	std::vector<int> cellIdxs(N);
+	const auto lambdaComputeCells = [&](size_t th) {
+		const size_t i0 = N * th / nThreads, i1 = N * (th + 1) / nThreads;
+		const bool filter = insertionOptions.filterByHeight;
+		const float z_min = insertionOptions.z_min,
+					z_max = insertionOptions.z_max;
+		for (size_t i = i0; i < i1; i++)
 		{
-			cell->h = z;  // First observation
-			cell->w = 1;
+			const int cx = x2idx(pts.x[i]), cy = y2idx(pts.y[i]);
+			if (cx < 0 || cx >= static_cast<int>(m_size_x) || cy < 0 ||
+				cy >= static_cast<int>(m_size_y))
+				cellIdxs[i] = OUT_OF_MAP;
+			else if (filter && !(pts.z[i] >= z_min && pts.z[i] <= z_max))
+				cellIdxs[i] = FILTERED_OUT;
+			else
+				cellIdxs[i] = cx + cy * static_cast<int>(m_size_x);
 		}
-		else
+	};
+
+	// 2) Each thread updates the cells in one range of indices, with the
+	//    points in their original order, so the results do not depend on
+	//    the number of threads:
+	const auto lambdaUpdateCells = [&](size_t th) {
+		const int c0 = static_cast<int>(nCells * th / nThreads),
+				  c1 = static_cast<int>(nCells * (th + 1) / nThreads);
+		for (size_t i = 0; i < N; i++)
 		{
-			float W = cell->w++;  // W = N-1
-			cell->h = (cell->h * W + z) / cell->w;
-			if (W > 0)
-				cell->var = (cell->v - d2f(pow(cell->u, 2)) / cell->w) / W;
+			const int c = cellIdxs[i];
+			if (c >= c0 && c < c1) updateCellHeight(m_map[c], pts.z[i]);
 		}
-	}  // end if really inserted
-	return true;
+	};
+
+	const auto runInThreads = [nThreads](const auto& lambda) {
+		std::vector<std::thread> threads;
+		for (size_t th = 1; th < nThreads; th++)
+			threads.emplace_back(lambda, th);
+		lambda(0);
+		for (auto& t : threads)
+			t.join();
+	};
+	runInThreads(lambdaComputeCells);
+	runInThreads(lambdaUpdateCells);
+
+	if (params.update_map_after_insertion) this->dem_update_map();
+
+	return N -
+		static_cast<size_t>(
+			   std::count(cellIdxs.begin(), cellIdxs.end(), OUT_OF_MAP));
 }
 
 bool CHeightGridMap2D::internal_insertObservation(
@@ -249,6 +338,8 @@ void CHeightGridMap2D::TInsertionOptions::dumpToTextStream(
 		"z_min                                   = %f\n", z_min);
 	out << mrpt::format(
 		"z_max                                   = %f\n", z_max);
+	out << mrpt::format(
+		"numThreads                              = %u\n", numThreads);
 	out << mrpt::format(
 		"colormap                                = %s\n",
 		colorMap == cmJET ? "jet" : "grayscale");
@@ -264,6 +355,7 @@ void CHeightGridMap2D::TInsertionOptions::loadFromConfigFile(
 	MRPT_LOAD_CONFIG_VAR(filterByHeight, bool, iniFile, section)
 	MRPT_LOAD_CONFIG_VAR(z_min, float, iniFile, section)
 	MRPT_LOAD_CONFIG_VAR(z_max, float, iniFile, section)
+	MRPT_LOAD_CONFIG_VAR(numThreads, int, iniFile, section)
 	string aux = iniFile.read_string(section, "colorMap", "jet");
 
 	if (strCmp(aux, "jet")) colorMap = cmJET;
@@ -288,19 +380,7 @@ void CHeightGridMap2D::getVisualizationInto(
 
 	if (HEIGHTGRIDMAP_EXPORT3D_AS_MESH_value)
 	{
-		opengl::CMesh::Ptr mesh = std::make_shared<opengl::CMesh>();
-
-		mesh->setGridLimits(m_x_min, m_x_max, m_y_min, m_y_max);
-
-		mesh->setColor(0.4f, 0.4f, 0.4f);
-
-		mesh->enableWireFrame(true);
-		mesh->enableColorFromZ(true, insertionOptions.colorMap /*cmJET*/);
-
 		CMatrixFloat Z, mask;
-		/*mesh->getZ(Z);
-
-		mesh->getMask(mask);*/
 
 		Z.setSize(m_size_x, m_size_y);
 		mask.setSize(m_size_x, m_size_y);
@@ -315,6 +395,28 @@ void CHeightGridMap2D::getVisualizationInto(
 				mask(x, y) = c->w ? 1 : 0;
 			}
 		}
+
+		if (m_size_x * m_size_y >= HEIGHTGRIDMAP_EXPORT3D_LOD_MIN_CELLS_value)
+		{
+			// Large maps: with level of detail
+			auto mesh = mrpt::opengl::CTerrainMesh::Create();
+			mesh->setGridLimits(m_x_min, m_x_max, m_y_min, m_y_max);
+			mesh->enableColorFromZ(true, insertionOptions.colorMap);
+			mesh->setZ(Z);
+			mesh->setMask(mask);
+			o.insert(mesh);
+			return;
+		}
+
+		opengl::CMesh::Ptr mesh = std::make_shared<opengl::CMesh>();
+
+		mesh->setGridLimits(m_x_min, m_x_max, m_y_min, m_y_max);
+
+		mesh->setColor(0.4f, 0.4f, 0.4f);
+
+		mesh->enableWireFrame(true);
+		mesh->enableColorFromZ(true, insertionOptions.colorMap /*cmJET*/);
+
 		mesh->setZ(Z);
 		mesh->setMask(mask);
 
@@ -25,6 +25,22 @@ CHeightGridMap2D_Base::TPointInsertParams::TPointInsertParams()
 
 CHeightGridMap2D_Base::CHeightGridMap2D_Base() = default;
 CHeightGridMap2D_Base::~CHeightGridMap2D_Base() = default;
+
+size_t CHeightGridMap2D_Base::insertPoints(
+	const mrpt::math::TPointCloudView& pts, const TPointInsertParams& params)
+{
+	TPointInsertParams pt_params = params;
+	pt_params.update_map_after_insertion = false;  // update only once at end
+
+	size_t nInserted = 0;
+	for (size_t i = 0; i < pts.count; i++)
+		if (insertIndividualPoint(pts.x[i], pts.y[i], pts.z[i], pt_params))
+			nInserted++;
+
+	if (params.update_map_after_insertion) this->dem_update_map();
+	return nInserted;
+}
+
 bool CHeightGridMap2D_Base::getMinMaxHeight(float& z_min, float& z_max) const
 {
 	const size_t size_x = dem_get_size_x();
@@ -170,18 +186,8 @@ bool CHeightGridMap2D_Base::dem_internal_insertObservation(
 	// Factorized insertion of points, for different observation classes:
 	if (!thePointsMoved.empty())
 	{
-		TPointInsertParams pt_params;
-		pt_params.update_map_after_insertion =
-			false;	// update only once at end
-
-		const size_t N = thePointsMoved.size();
-		for (size_t i = 0; i < N; i++)
-		{
-			float x, y, z;
-			thePointsMoved.getPoint(i, x, y, z);
-			insertIndividualPoint(x, y, z, pt_params);
-		}  // end for i
-		this->dem_update_map();
+		// Update the map only once at end:
+		insertPoints(thePointsMoved.asView());
 		return true;  // Done, new points inserted
 	}
 	return false;  // No insertion done
@@ -11,6 +11,8 @@
 #include <mrpt/maps/CHeightGridMap2D.h>
 #include <mrpt/maps/CHeightGridMap2D_MRF.h>
 
+#include <cmath>
+
 template <class MAP>
 void do_test_insertCheckMapBounds()
 {
@@ -53,3 +55,85 @@ TEST(CHeightGridMap2Ds, insertPointsAndRead)
 	do_test_insertPointsAndRead<mrpt::maps::CHeightGridMap2D>();
 	do_test_insertPointsAndRead<mrpt::maps::CHeightGridMap2D_MRF>();
 }
+
+TEST(CHeightGridMap2Ds, insertPointsMultiThreaded)
+{
+	std::vector<float> xs, ys, zs;
+	for (int i = 0; i < 100000; i++)
+	{
+		// Deterministic, scattered points, some out of the map:
+		xs.push_back(5.5f * std::sin(0.37f * i));
+		ys.push_back(5.5f * std::cos(0.23f * i + 1.0f));
+		zs.push_back(0.3f * std::sin(0.11f * i));
+	}
+	const auto pts = mrpt::math::TPointCloudView::FromVectors(xs, ys, zs);
+
+	mrpt::maps::CHeightGridMap2D demOneByOne;
+	demOneByOne.setSize(-5.0, 5.0, -5.0, 5.0, 0.1);
+	demOneByOne.insertionOptions.filterByHeight = true;
+	demOneByOne.insertionOptions.z_min = -0.2f;
+	demOneByOne.insertionOptions.z_max = 0.2f;
+	size_t nInside = 0;
+	for (size_t i = 0; i < xs.size(); i++)
+		if (demOneByOne.insertIndividualPoint(xs[i], ys[i], zs[i])) nInside++;
+
+	for (unsigned int nThreads : {1U, 4U})
+	{
+		mrpt::maps::CHeightGridMap2D dem;
+		dem.setSize(-5.0, 5.0, -5.0, 5.0, 0.1);
+		dem.insertionOptions = demOneByOne.insertionOptions;
+		dem.insertionOptions.numThreads = nThreads;
+		EXPECT_EQ(dem.insertPoints(pts), nInside);
+
+		ASSERT_EQ(dem.getSizeX(), demOneByOne.getSizeX());
+		ASSERT_EQ(dem.getSizeY(), demOneByOne.getSizeY());
+		for (size_t cy = 0; cy < dem.getSizeY(); cy++)
+			for (size_t cx = 0; cx < dem.getSizeX(); cx++)
+			{
+				const auto* c1 = demOneByOne.cellByIndex(cx, cy);
+				const auto* c2 = dem.cellByIndex(cx, cy);
+				EXPECT_EQ(c1->w, c2->w) << "nThreads: " << nThreads;
+				EXPECT_EQ(c1->h, c2->h) << "nThreads: " << nThreads;
+				EXPECT_EQ(c1->var, c2->var) << "nThreads: " << nThreads;
+			}
+	}
+}
+
+TEST(CHeightGridMap2Ds, MRF_varianceUpdateRadius)
+{
+	using mrpt::maps::CHeightGridMap2D_MRF;
+	CHeightGridMap2D_MRF demAll(
+		CHeightGridMap2D_MRF::mrGMRF_SD, 0, 5, 0, 5, 0.25);
+	CHeightGridMap2D_MRF demLocal(
+		CHeightGridMap2D_MRF::mrGMRF_SD, 0, 5, 0, 5, 0.25);
+	demLocal.insertionOptions.GMRF_variance_update_radius = 1;
+
+	std::vector<mrpt::math::TPoint2D> observed;
+	for (int step = 0; step < 3; step++)
+	{
+		std::vector<float> xs, ys, zs;
+		for (int i = 0; i < 10; i++)
+		{
+			const int k = step * 10 + i;
+			xs.push_back(2.5f + 2.0f * std::sin(0.7f * k));
+			ys.push_back(2.5f + 2.0f * std::cos(1.3f * k));
+			zs.push_back(0.1f * k);
+			observed.emplace_back(xs.back(), ys.back());
+		}
+		const auto pts = mrpt::math::TPointCloudView::FromVectors(xs, ys, zs);
+		demAll.insertPoints(pts);
+		demLocal.insertPoints(pts);
+
+		// Means and the variances of the observed cells must be the same:
+		for (size_t cy = 0; cy < demAll.getSizeY(); cy++)
+			for (size_t cx = 0; cx < demAll.getSizeX(); cx++)
+				EXPECT_NEAR(
+					demAll.cellByIndex(cx, cy)->gmrf_mean(),
+					demLocal.cellByIndex(cx, cy)->gmrf_mean(), 1e-6);
+		for (const auto& p : observed)
+			EXPECT_NEAR(
+				demAll.cellByPos(p.x, p.y)->gmrf_std(),
+				demLocal.cellByPos(p.x, p.y)->gmrf_std(), 1e-6)
+				<< "step: " << step;
+	}
+}
@@ -0,0 +1,287 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "maps-precomp.h"  // Precomp header
+//
+#include <mrpt/config.h>
+#include <mrpt/core/format.h>
+#include <mrpt/img/TCamera.h>
+#include <mrpt/maps/CLaserScanSimulatorGL.h>
+#include <mrpt/maps/COccupancyGridMap2D.h>
+#include <mrpt/opengl/CFBORender.h>
+#include <mrpt/opengl/COpenGLScene.h>
+#include <mrpt/opengl/CSetOfTriangles.h>
+#include <mrpt/poses/CPose3D.h>
+#include <mrpt/random.h>
+
+#include <cmath>
+
+using namespace mrpt;
+using namespace mrpt::maps;
+using namespace mrpt::obs;
+using namespace mrpt::poses;
+
+// Minimum off-screen rendering requirements, as in CFBORender:
+#define HAVE_GL_SIMUL (MRPT_HAS_OPENCV && MRPT_HAS_OPENGL_GLUT && MRPT_HAS_EGL)
+
+namespace
+{
+// Height (pixels) of each viewport. The center row is the scan plane.
+constexpr unsigned int VIEWPORT_ROWS = 3;
+// Walls span this vertical range around the scan plane (z=0):
+constexpr float WALLS_HALF_HEIGHT = 1.0f;
+// Max. horizontal FOV of each rendered sector:
+constexpr double MAX_SECTOR_APERTURE = M_PI / 2;
+constexpr float CLIP_NEAR = 0.05f;
+}  // namespace
+
+struct CLaserScanSimulatorGL::Impl
+{
+	std::vector<mrpt::opengl::TTriangle> triangles;
+
+	// Current layout. All must be rebuilt together if it changes, since the
+	// OpenGL buffers belong to the CFBORender context:
+	size_t nPoses = 0, nSectors = 0;
+	unsigned int sectorCols = 0;
+	float clipFar = 0;
+	std::unique_ptr<mrpt::opengl::COpenGLScene> scene;
+	std::vector<mrpt::opengl::COpenGLViewport::Ptr> viewports;
+	std::unique_ptr<mrpt::opengl::CFBORender> fbo;
+	mrpt::math::CMatrixFloat depth;
+
+	void prepareLayout(
+		size_t poses, size_t sectors, unsigned int cols, double secAperture,
+		float maxDepth)
+	{
+		if (poses == nPoses && sectors == nSectors && cols == sectorCols &&
+			maxDepth == clipFar && fbo)
+		{
+			// Only the cameras have to be updated
+			return;
+		}
+
+		// Release GL objects while their context is still alive:
+		viewports.clear();
+		scene.reset();
+		fbo.reset();
+
+		nPoses = poses;
+		nSectors = sectors;
+		sectorCols = cols;
+		clipFar = maxDepth;
+
+		fbo = std::make_unique<mrpt::opengl::CFBORender>(
+			static_cast<unsigned int>(nSectors * sectorCols),
+			static_cast<unsigned int>(nPoses * VIEWPORT_ROWS));
+
+		auto walls = mrpt::opengl::CSetOfTriangles::Create();
+		walls->insertTriangles(triangles.begin(), triangles.end());
+
+		mrpt::img::TCamera cam;
+		cam.ncols = sectorCols;
+		cam.nrows = VIEWPORT_ROWS;
+		const double f = 0.5 * sectorCols / std::tan(0.5 * secAperture);
+		cam.fx(f);
+		cam.fy(f);
+		cam.cx(0.5 * sectorCols);
+		cam.cy(0.5 * VIEWPORT_ROWS);
+
+		scene = std::make_unique<mrpt::opengl::COpenGLScene>();
+		for (size_t k = 0; k < nPoses; k++)
+		{
+			for (size_t s = 0; s < nSectors; s++)
+			{
+				const size_t v = k * nSectors + s;
+				auto vp = v == 0 ? scene->getViewport()
+								 : scene->createViewport(mrpt::format(
+									   "sim%u", static_cast<unsigned>(v)));
+				vp->setViewportPosition(
+					s * sectorCols, k * VIEWPORT_ROWS, sectorCols,
+					VIEWPORT_ROWS);
+				vp->setViewportClipDistances(CLIP_NEAR, clipFar);
+				auto& c = vp->getCamera();
+				c.setProjectiveFromPinhole(cam);
+				c.set6DOFMode(true);
+				vp->insert(walls);
+				viewports.push_back(vp);
+			}
+		}
+	}
+};
+
+bool CLaserScanSimulatorGL::IsAvailable()
+{
+#if HAVE_GL_SIMUL
+	return true;
+#else
+	return false;
+#endif
+}
+
+CLaserScanSimulatorGL::CLaserScanSimulatorGL(
+	const COccupancyGridMap2D& grid, float threshold)
+	: m_impl(std::make_unique<Impl>())
+{
+	MRPT_START
+
+	if (!IsAvailable())
+		THROW_EXCEPTION(
+			"This class requires MRPT built with: OpenCV; OpenGL, and EGL.");
+
+	// Convert rows of occupied cells into vertical walls:
+	const float free_thres = 1.0f - threshold;
+	const float res = grid.getResolution();
+	const auto addWall = [this](float x0, float y0, float x1, float y1) {
+		const mrpt::math::TPoint3Df a0(x0, y0, -WALLS_HALF_HEIGHT),
+			a1(x0, y0, WALLS_HALF_HEIGHT), b0(x1, y1, -WALLS_HALF_HEIGHT),
+			b1(x1, y1, WALLS_HALF_HEIGHT);
+		m_impl->triangles.emplace_back(a0, b0, b1);
+		m_impl->triangles.emplace_back(a0, b1, a1);
+	};
+
+	for (unsigned int cy = 0; cy < grid.getSizeY(); cy++)
+	{
+		const float y0 = grid.idx2y(cy) - 0.5f * res, y1 = y0 + res;
+		for (unsigned int cx = 0; cx < grid.getSizeX(); cx++)
+		{
+			if (grid.getCell(cx, cy) > free_thres) continue;
+			// Start of a run of occupied cells:
+			unsigned int cx_end = cx;
+			while (cx_end + 1 < grid.getSizeX() &&
+				   grid.getCell(cx_end + 1, cy) <= free_thres)
+				cx_end++;
+
+			const float x0 = grid.idx2x(cx) - 0.5f * res;
+			const float x1 = grid.idx2x(cx_end) + 0.5f * res;
+			addWall(x0, y0, x1, y0);
+			addWall(x1, y0, x1, y1);
+			addWall(x1, y1, x0, y1);
+			addWall(x0, y1, x0, y0);
+
+			cx = cx_end;
+		}
+	}
+
+	MRPT_END
+}
+
+CLaserScanSimulatorGL::~CLaserScanSimulatorGL() = default;
+
+void CLaserScanSimulatorGL::simulate(
+	const std::vector<CPose2D>& robotPoses,
+	const CObservation2DRangeScan& scanTemplate,
+	std::vector<CObservation2DRangeScan>& outScans, size_t N, float noiseStd)
+{
+	MRPT_START
+
+	ASSERT_GE_(N, 2U);
+	ASSERT_GE_(maxPosesPerPass, 1U);
+	ASSERT_GE_(pixelsPerBeam, 1U);
+	ASSERT_GT_(scanTemplate.maxRange, 0);
+
+	outScans.assign(robotPoses.size(), scanTemplate);
+	if (robotPoses.empty()) return;
+
+	const double aperture = scanTemplate.aperture;
+	ASSERT_GT_(aperture, 0);
+	const size_t nSectors = std::max<size_t>(
+		1, static_cast<size_t>(std::ceil(aperture / MAX_SECTOR_APERTURE - 1e-6)));
+	const double secAperture = aperture / nSectors;
+	const unsigned int sectorCols = std::max<unsigned int>(
+		16, static_cast<unsigned int>(
+				std::ceil(double(pixelsPerBeam) * N / nSectors)));
+	const double f = 0.5 * sectorCols / std::tan(0.5 * secAperture);
+
+	const size_t nPosesPerPass = std::min(maxPosesPerPass, robotPoses.size());
+	m_impl->prepareLayout(
+		nPosesPerPass, nSectors, sectorCols, secAperture,
+		scanTemplate.maxRange);
+
+	// Sensor -> camera axes (+Z forward, +X right, +Y down):
+	const auto sensorToCam = CPose3D::FromYawPitchRoll(
+		-90.0_deg /*yaw*/, 0.0_deg /*pitch*/, -90.0_deg /*roll*/);
+
+	// Precompute the image sampling of each beam:
+	struct TBeamSample
+	{
+		size_t col;	 // in the whole framebuffer
+		double cosine;	// of the angle between the pixel ray and the axis
+	};
+	std::vector<TBeamSample> beams(N);
+	for (size_t i = 0; i < N; i++)
+	{
+		const double a = scanTemplate.rightToLeft
+			? -0.5 * aperture + i * aperture / (N - 1)
+			: 0.5 * aperture - i * aperture / (N - 1);
+		const size_t s = std::min<size_t>(
+			nSectors - 1,
+			static_cast<size_t>(std::max(
+				0.0, std::floor((a + 0.5 * aperture) / secAperture))));
+		const double center = -0.5 * aperture + (s + 0.5) * secAperture;
+		const int col = std::clamp(
+			static_cast<int>(
+				std::floor(0.5 * sectorCols - f * std::tan(a - center))),
+			0, static_cast<int>(sectorCols) - 1);
+		const double pixelAng = std::atan((0.5 * sectorCols - (col + 0.5)) / f);
+		beams[i] = {s * sectorCols + col, std::cos(pixelAng)};
+	}
+
+	auto& rng = mrpt::random::getRandomGenerator();
+	const unsigned int H = nPosesPerPass * VIEWPORT_ROWS;
+
+	for (size_t first = 0; first < robotPoses.size(); first += nPosesPerPass)
+	{
+		// Set cameras. Unused slots in the last pass repeat the last pose.
+		for (size_t k = 0; k < nPosesPerPass; k++)
+		{
+			const auto& robotPose =
+				robotPoses[std::min(first + k, robotPoses.size() - 1)];
+			// Approximation: grid is 2D
+			const CPose2D sensorPose(
+				CPose3D(robotPose) + scanTemplate.sensorPose);
+			for (size_t s = 0; s < nSectors; s++)
+			{
+				const double center =
+					-0.5 * aperture + (s + 0.5) * secAperture;
+				const CPose3D camPose =
+					CPose3D(
+						sensorPose.x(), sensorPose.y(), 0,
+						sensorPose.phi() + center, 0, 0) +
+					sensorToCam;
+				m_impl->viewports[k * nSectors + s]->getCamera().setPose(
+					camPose);
+			}
+		}
+
+		// Render all of them at once:
+		m_impl->fbo->render_depth(*m_impl->scene, m_impl->depth);
+
+		for (size_t k = 0; k < nPosesPerPass && first + k < robotPoses.size();
+			 k++)
+		{
+			auto& scan = outScans[first + k];
+			scan.resizeScan(N);
+			// depth rows are top to bottom:
+			const unsigned int row = H - k * VIEWPORT_ROWS - 2;
+			for (size_t i = 0; i < N; i++)
+			{
+				const float d = m_impl->depth(row, beams[i].col);
+				float range = d / beams[i].cosine;
+				bool valid = d > 0 && range < scan.maxRange;
+				if (!valid) range = scan.maxRange;
+				else if (noiseStd > 0)
+					range += noiseStd * rng.drawGaussian1D_normalized();
+				scan.setScanRange(i, range);
+				scan.setScanRangeValidity(i, valid);
+			}
+		}
+	}
+
+	MRPT_END
+}
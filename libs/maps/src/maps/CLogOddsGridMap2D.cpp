@@ -0,0 +1,127 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "maps-precomp.h"  // Precomp header
+//
+#include <mrpt/core/SSE_types.h>
+#include <mrpt/maps/CLogOddsGridMap2D.h>
+
+#if !MRPT_HAS_SSE2 && (defined(__ARM_NEON) || defined(__aarch64__))
+#include <arm_neon.h>
+#define LOGODDS_BATCH_NEON 1
+#else
+#define LOGODDS_BATCH_NEON 0
+#endif
+
+using namespace mrpt::maps;
+
+namespace
+{
+template <typename cell_t>
+inline void updateCells_scalar(cell_t* cells, const int32_t* delta, size_t n)
+{
+	using traits_t = mrpt::maps::detail::logoddscell_traits<cell_t>;
+	for (size_t i = 0; i < n; i++)
+	{
+		const int32_t v = static_cast<int32_t>(cells[i]) + delta[i];
+		cells[i] = static_cast<cell_t>(std::clamp<int32_t>(
+			v, traits_t::CELLTYPE_MIN, traits_t::CELLTYPE_MAX));
+	}
+}
+}  // namespace
+
+template <>
+void CLogOddsGridMap2D<int8_t>::updateCells_fast_delta(
+	int8_t* cells, const int32_t* delta, size_t n)
+{
+	size_t i = 0;
+#if MRPT_HAS_SSE2
+	// 16 cells per iteration, added as int16, since int8 saturation
+	// (-128) is not CELLTYPE_MIN (-127):
+	const __m128i v_min = _mm_set1_epi16(traits_t::CELLTYPE_MIN);
+	const __m128i v_max = _mm_set1_epi16(traits_t::CELLTYPE_MAX);
+	for (; i + 16 <= n; i += 16)
+	{
+		const __m128i* d = reinterpret_cast<const __m128i*>(delta + i);
+		const __m128i d_lo =
+			_mm_packs_epi32(_mm_loadu_si128(d), _mm_loadu_si128(d + 1));
+		const __m128i d_hi =
+			_mm_packs_epi32(_mm_loadu_si128(d + 2), _mm_loadu_si128(d + 3));
+		__m128i* p = reinterpret_cast<__m128i*>(cells + i);
+		const __m128i c = _mm_loadu_si128(p);
+		// Sign extension to int16:
+		const __m128i c_lo = _mm_srai_epi16(_mm_unpacklo_epi8(c, c), 8);
+		const __m128i c_hi = _mm_srai_epi16(_mm_unpackhi_epi8(c, c), 8);
+		const __m128i r_lo = _mm_min_epi16(
+			v_max, _mm_max_epi16(v_min, _mm_adds_epi16(c_lo, d_lo)));
+		const __m128i r_hi = _mm_min_epi16(
+			v_max, _mm_max_epi16(v_min, _mm_adds_epi16(c_hi, d_hi)));
+		_mm_storeu_si128(p, _mm_packs_epi16(r_lo, r_hi));
+	}
+#elif LOGODDS_BATCH_NEON
+	const int16x8_t v_min = vdupq_n_s16(traits_t::CELLTYPE_MIN);
+	const int16x8_t v_max = vdupq_n_s16(traits_t::CELLTYPE_MAX);
+	for (; i + 16 <= n; i += 16)
+	{
+		const int16x8_t d_lo = vcombine_s16(
+			vqmovn_s32(vld1q_s32(delta + i)),
+			vqmovn_s32(vld1q_s32(delta + i + 4)));
+		const int16x8_t d_hi = vcombine_s16(
+			vqmovn_s32(vld1q_s32(delta + i + 8)),
+			vqmovn_s32(vld1q_s32(delta + i + 12)));
+		const int8x16_t c = vld1q_s8(cells + i);
+		const int16x8_t c_lo = vmovl_s8(vget_low_s8(c));
+		const int16x8_t c_hi = vmovl_s8(vget_high_s8(c));
+		const int16x8_t r_lo =
+			vminq_s16(v_max, vmaxq_s16(v_min, vqaddq_s16(c_lo, d_lo)));
+		const int16x8_t r_hi =
+			vminq_s16(v_max, vmaxq_s16(v_min, vqaddq_s16(c_hi, d_hi)));
+		vst1q_s8(cells + i, vcombine_s8(vqmovn_s16(r_lo), vqmovn_s16(r_hi)));
+	}
+#endif
+	updateCells_scalar(cells + i, delta + i, n - i);
+}
+
+template <>
+void CLogOddsGridMap2D<int16_t>::updateCells_fast_delta(
+	int16_t* cells, const int32_t* delta, size_t n)
+{
+	size_t i = 0;
+#if MRPT_HAS_SSE2
+	// 8 cells per iteration, added as int32 since deltas may not fit in
+	// int16; int16 saturation (-32768) is not CELLTYPE_MIN (-32767):
+	const __m128i v_min = _mm_set1_epi16(traits_t::CELLTYPE_MIN);
+	for (; i + 8 <= n; i += 8)
+	{
+		const __m128i* d = reinterpret_cast<const __m128i*>(delta + i);
+		__m128i* p = reinterpret_cast<__m128i*>(cells + i);
+		const __m128i c = _mm_loadu_si128(p);
+		// Sign extension to int32:
+		const __m128i c_lo = _mm_srai_epi32(_mm_unpacklo_epi16(c, c), 16);
+		const __m128i c_hi = _mm_srai_epi32(_mm_unpackhi_epi16(c, c), 16);
+		const __m128i r = _mm_packs_epi32(
+			_mm_add_epi32(c_lo, _mm_loadu_si128(d)),
+			_mm_add_epi32(c_hi, _mm_loadu_si128(d + 1)));
+		_mm_storeu_si128(p, _mm_max_epi16(v_min, r));
+	}
+#elif LOGODDS_BATCH_NEON
+	const int16x8_t v_min = vdupq_n_s16(traits_t::CELLTYPE_MIN);
+	for (; i + 8 <= n; i += 8)
+	{
+		const int16x8_t c = vld1q_s16(cells + i);
+		const int32x4_t c_lo = vmovl_s16(vget_low_s16(c));
+		const int32x4_t c_hi = vmovl_s16(vget_high_s16(c));
+		const int16x8_t r = vcombine_s16(
+			vqmovn_s32(vaddq_s32(c_lo, vld1q_s32(delta + i))),
+			vqmovn_s32(vaddq_s32(c_hi, vld1q_s32(delta + i + 4))));
+		vst1q_s16(cells + i, vmaxq_s16(v_min, r));
+	}
+#endif
+	updateCells_scalar(cells + i, delta + i, n - i);
+}
@@ -0,0 +1,91 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/maps/CBeamFootprintCache.h>
+#include <mrpt/maps/CLogOddsGridMap2D.h>
+#include <mrpt/random/RandomGenerators.h>
+
+#include <algorithm>
+
+template <typename cell_t>
+void test_updateCells_fast_delta()
+{
+	using grid_t = mrpt::maps::CLogOddsGridMap2D<cell_t>;
+	auto& rnd = mrpt::random::getRandomGenerator();
+	rnd.randomize(1);
+
+	// All lengths, to test both the SIMD and the scalar loops:
+	for (size_t n = 0; n < 70; n++)
+	{
+		std::vector<cell_t> cells(n);
+		std::vector<int32_t> delta(n);
+		for (size_t i = 0; i < n; i++)
+		{
+			cells[i] = static_cast<cell_t>(rnd.drawUniform32bit() % 255) - 127;
+			// Small increments, and large ones which saturate:
+			const double maxDelta = (i % 2) ? 50 : 1e5;
+			delta[i] =
+				static_cast<int32_t>(rnd.drawUniform(-maxDelta, maxDelta));
+		}
+		auto expected = cells;
+		for (size_t i = 0; i < n; i++)
+			expected[i] = static_cast<cell_t>(std::clamp<int32_t>(
+				expected[i] + delta[i], grid_t::CELLTYPE_MIN,
+				grid_t::CELLTYPE_MAX));
+
+		grid_t::updateCells_fast_delta(cells.data(), delta.data(), n);
+		EXPECT_EQ(cells, expected) << " n=" << n;
+	}
+}
+
+TEST(CLogOddsGridMap2D, updateCells_fast_delta_8bit)
+{
+	test_updateCells_fast_delta<int8_t>();
+}
+TEST(CLogOddsGridMap2D, updateCells_fast_delta_16bit)
+{
+	test_updateCells_fast_delta<int16_t>();
+}
+
+TEST(CLogOddsGridMap2D, updateCells_batch)
+{
+	using grid_t = mrpt::maps::CLogOddsGridMap2D<int8_t>;
+
+	mrpt::maps::CBeamFootprintCache cache;
+	auto& footprints = cache.getFootprints({361, M_PI, true}, 0.3f, 0.7f);
+	const auto& fp = footprints.footprint(footprints.directionIndex(0.3), 30);
+	ASSERT_GE(fp.dx.size(), 30U);
+	EXPECT_EQ(fp.dx[0], 0);
+	EXPECT_EQ(fp.dy[0], 0);
+	EXPECT_EQ(fp.dx[29], 29);
+	EXPECT_EQ(fp.dy[29], 9);  // floor(0.625 + 29*tan(0.3))
+
+	grid_t::TBatchRay r;
+	r.dx = fp.dx.data();
+	r.dy = fp.dy.data();
+	r.nFree = 30;
+	r.logodd_free = 10;
+	r.hit = true;
+	r.hit_dx = 30;
+	r.hit_dy = 9;
+	r.logodd_occupied = 100;
+	const std::vector<grid_t::TBatchRay> rays = {r, r};
+
+	std::vector<int8_t> map(100 * 100, 0);
+	std::vector<int32_t> scratch;
+	grid_t::updateCells_batch(map.data(), 100, 100, 50, 50, rays, scratch);
+
+	EXPECT_EQ(map[50 + 50 * 100], 20);
+	EXPECT_EQ(map[79 + 59 * 100], 20);
+	EXPECT_EQ(map[80 + 59 * 100], grid_t::CELLTYPE_MIN);  // -200, saturated
+	EXPECT_EQ(std::count(map.begin(), map.end(), 0), 100 * 100 - 31);
+	EXPECT_TRUE(std::all_of(
+		scratch.begin(), scratch.end(), [](int32_t v) { return v == 0; }));
+}
@@ -11,13 +11,24 @@
 //
 #include <mrpt/config/CConfigFile.h>
 #include <mrpt/io/CMemoryStream.h>
+#include <mrpt/maps/CColouredOctoMap.h>
 #include <mrpt/maps/CMultiMetricMap.h>
+#include <mrpt/maps/COccupancyGridMap2D.h>
+#include <mrpt/maps/COctoMap.h>
+#include <mrpt/maps/CPointCloudFilterByVoxelGrid.h>
+#include <mrpt/maps/CSimpleMap.h>
 #include <mrpt/maps/CSimplePointsMap.h>
+#include <mrpt/obs/CSensoryFrame.h>
 #include <mrpt/poses/CPoint2D.h>
 #include <mrpt/serialization/CArchive.h>
 #include <mrpt/serialization/metaprogramming_serialization.h>
 #include <mrpt/system/filesystem.h>
 
+#include <cmath>
+#include <future>
+#include <map>
+#include <thread>
+
 using namespace mrpt::maps;
 using namespace mrpt::poses;
 using namespace mrpt::obs;
@@ -128,11 +139,157 @@ void CMultiMetricMap::setListOfMaps(const TSetOfMetricMapInitializers& inits)
 		// Add to the list of maps:
 		this->maps.emplace_back(theMap);
 	}
+	numThreads = inits.numThreads;
+	MRPT_END
+}
+
+mrpt::WorkerThreadsPool& CMultiMetricMap::threadPool() const
+{
+	size_t nThreads = numThreads;
+	if (!nThreads) nThreads = std::max(1U, std::thread::hardware_concurrency());
+	if (!m_threadPool || m_threadPool->size() != nThreads)
+		m_threadPool = std::make_shared<mrpt::WorkerThreadsPool>(
+			nThreads, mrpt::WorkerThreadsPool::POLICY_FIFO, "CMultiMetricMap");
+	return *m_threadPool;
+}
+
+void CMultiMetricMap::detachSharedMaps()
+{
+	for (auto& m : maps)
+		if (m && m.use_count() > 1)
+			m = std::dynamic_pointer_cast<CMetricMap>(
+				m->duplicateGetSmartPtr());
+}
+
+void CMultiMetricMap::loadFromSimpleMapInTiles(
+	const CSimpleMap& sm, double tileSize, double pointsVoxelSize)
+{
+	MRPT_START
+	ASSERT_GT_(tileSize, 0);
+	if (numThreads == 1)
+	{
+		loadFromProbabilisticPosesAndObservations(sm);
+		return;
+	}
+
+	// Erase previous contents:
+	this->clear();
+
+	// (Sensory frames are only accessed when inserted, so externally stored
+	// ones are loaded on demand)
+	struct TKeyframe
+	{
+		CPose3D pose;
+		size_t index;
+	};
+	std::vector<TKeyframe> kfs;
+	kfs.reserve(sm.size());
+	for (const auto& pair : sm)
+	{
+		ASSERTMSG_(pair.pose, "Input map has an empty `CPose3DPDF` ptr");
+		kfs.push_back({pair.pose->getMeanVal(), kfs.size()});
+	}
+
+	// Keyframes in each tile, in their original order:
+	std::map<std::pair<int, int>, std::vector<size_t>> tiles;
+	for (size_t i = 0; i < kfs.size(); i++)
+		tiles[{static_cast<int>(std::floor(kfs[i].pose.x() / tileSize)),
+			   static_cast<int>(std::floor(kfs[i].pose.y() / tileSize))}]
+			.push_back(i);
+
+	auto lmbMergeable = [](const CMetricMap& m) {
+		return dynamic_cast<const CPointsMap*>(&m) ||
+			dynamic_cast<const COccupancyGridMap2D*>(&m) ||
+			dynamic_cast<const COctoMap*>(&m) ||
+			dynamic_cast<const CColouredOctoMap*>(&m);
+	};
+	// As CMetricMap::insertObservation(), without events:
+	auto lmbInsert = [&sm](CMetricMap& m, const TKeyframe& kf) {
+		if (!m.genericMapParams.enableObservationInsertion) return;
+		const auto sf = sm.getAsPair(kf.index).sf;
+		ASSERTMSG_(sf, "Input map has an empty `CSensoryFrame` ptr");
+		for (const auto& obs : *sf)
+			if (obs && m.internal_insertObservation(*obs, kf.pose))
+				m.OnPostSuccesfulInsertObs(*obs);
+	};
+	auto lmbWaitAll = [](std::vector<std::future<void>>& futs) {
+		for (auto& f : futs)
+			f.wait();
+		for (auto& f : futs)
+			f.get();  // Rethrow exceptions, if any
+		futs.clear();
+	};
+
+	auto& pool = threadPool();
+	std::vector<std::future<void>> futs;
+
+	// Maps that cannot be merged, from all the keyframes:
+	for (const auto& m : maps)
+		if (m && !lmbMergeable(*m))
+			futs.emplace_back(pool.enqueue([&kfs, &lmbInsert, m = m.get()]() {
+				for (const auto& kf : kfs)
+					lmbInsert(*m, kf);
+			}));
+
+	// One (empty) copy of the other maps per tile:
+	std::vector<TListMaps> tileMaps;
+	tileMaps.reserve(tiles.size());
+	for (const auto& tile : tiles)
+	{
+		auto& tm = tileMaps.emplace_back();
+		for (const auto& m : maps)
+			tm.push_back(
+				m && lmbMergeable(*m)
+					? std::dynamic_pointer_cast<CMetricMap>(
+						  m->duplicateGetSmartPtr())
+					: CMetricMap::Ptr());
+		futs.emplace_back(
+			pool.enqueue([&kfs, &lmbInsert, &tm, idxs = &tile.second]() {
+				for (const size_t i : *idxs)
+					for (const auto& m : tm)
+						if (m) lmbInsert(*m, kfs[i]);
+			}));
+	}
+	lmbWaitAll(futs);
+
+	// Merge tiles, one map per thread:
+	for (size_t k = 0; k < maps.size(); k++)
+	{
+		if (!maps[k] || !lmbMergeable(*maps[k])) continue;
+		futs.emplace_back(pool.enqueue([&, k]() {
+			CMetricMap* m = maps[k].get();
+			auto* pts = dynamic_cast<CPointsMap*>(m);
+			for (const auto& tm : tileMaps)
+			{
+				const CMetricMap* src = tm[k].get();
+				if (pts)
+					pts->insertAnotherMap(
+						dynamic_cast<const CPointsMap*>(src),
+						CPose3D::Identity());
+				else if (auto* g = dynamic_cast<COccupancyGridMap2D*>(m); g)
+					g->mergeLogOddsFrom(
+						dynamic_cast<const COccupancyGridMap2D&>(*src));
+				else if (auto* o = dynamic_cast<COctoMap*>(m); o)
+					o->mergeLogOddsFrom(dynamic_cast<const COctoMap&>(*src));
+				else if (auto* c = dynamic_cast<CColouredOctoMap*>(m); c)
+					c->mergeLogOddsFrom(
+						dynamic_cast<const CColouredOctoMap&>(*src));
+			}
+			if (pts && pointsVoxelSize > 0)
+			{
+				CPointCloudFilterByVoxelGrid filter;
+				filter.options.voxel_size = pointsVoxelSize;
+				filter.filter(pts, INVALID_TIMESTAMP, CPose3D::Identity());
+			}
+		}));
+	}
+	lmbWaitAll(futs);
 	MRPT_END
 }
 
 void CMultiMetricMap::internal_clear()
 {
+	if (copyOnWrite) detachSharedMaps();
 	std::for_each(maps.begin(), maps.end(), [](auto ptr) {
 		if (ptr) ptr->clear();
 	});
@@ -182,6 +339,23 @@ double CMultiMetricMap::internal_computeObservationLikelihood(
 	MRPT_START
 	double ret_log_lik = 0;
 
+	if (numThreads != 1 && maps.size() > 1)
+	{
+		auto& pool = threadPool();
+		std::vector<std::future<double>> futs;
+		futs.reserve(maps.size());
+		for (const auto& ptr : maps)
+			futs.emplace_back(pool.enqueue([&obs, &takenFrom, m = ptr.get()]() {
+				return m->computeObservationLikelihood(obs, takenFrom);
+			}));
+		for (auto& f : futs)
+			f.wait();
+		// Sum in the same order than the sequential version:
+		for (auto& f : futs)
+			ret_log_lik += f.get();
+		return ret_log_lik;
+	}
+
 	std::for_each(maps.begin(), maps.end(), [&](auto& ptr) {
 		ret_log_lik += ptr->computeObservationLikelihood(obs, takenFrom);
 	});
@@ -206,6 +380,35 @@ bool CMultiMetricMap::internal_insertObservation(
 	const std::optional<const mrpt::poses::CPose3D>& robotPose)
 {
 	int total_insert = 0;
+	if (copyOnWrite) detachSharedMaps();
+
+	if (numThreads != 1 && maps.size() > 1)
+	{
+		// Only the actual insertion runs in parallel. Post-insertion hooks
+		// and events are run afterwards from this thread, in map order, as
+		// done by CMetricMap::insertObservation():
+		auto& pool = threadPool();
+		std::vector<std::future<bool>> futs;
+		futs.reserve(maps.size());
+		for (const auto& ptr : maps)
+			futs.emplace_back(pool.enqueue([&obs, &robotPose, m = ptr.get()]() {
+				if (!m->genericMapParams.enableObservationInsertion)
+					return false;
+				return m->internal_insertObservation(obs, robotPose);
+			}));
+		for (auto& f : futs)
+			f.wait();
+
+		for (size_t i = 0; i < maps.size(); i++)
+		{
+			if (!futs[i].get()) continue;
+			maps[i]->OnPostSuccesfulInsertObs(obs);
+			maps[i]->publishEvent(
+				mrptEventMetricMapInsert(maps[i].get(), &obs, robotPose));
+			total_insert++;
+		}
+		return total_insert != 0;
+	}
 
 	std::for_each(maps.begin(), maps.end(), [&](auto& ptr) {
 		const bool ret = ptr->insertObservation(obs, robotPose);
@@ -327,11 +530,21 @@ CMultiMetricMap& CMultiMetricMap::operator=(const CMultiMetricMap& o)
 {
 	if (&o == this) return *this;
 
+	if (o.copyOnWrite)
+	{
+		maps = o.maps;
+		numThreads = o.numThreads;
+		copyOnWrite = true;
+		return *this;
+	}
+
 	mrpt::io::CMemoryStream buf;
 	auto ar = mrpt::serialization::archiveFrom(buf);
 	ar << o;
 	buf.Seek(0);
 	ar.ReadObject(this);
+	numThreads = o.numThreads;
+	copyOnWrite = false;
 
 	return *this;
 }
@@ -10,7 +10,15 @@
 #include <gtest/gtest.h>
 #include <mrpt/maps/CMultiMetricMap.h>
 #include <mrpt/maps/COccupancyGridMap2D.h>
+#include <mrpt/maps/CMetricMapEvents.h>
+#include <mrpt/maps/CSimpleMap.h>
 #include <mrpt/maps/CSimplePointsMap.h>
+#include <mrpt/obs/CObservation2DRangeScan.h>
+#include <mrpt/obs/CSensoryFrame.h>
+#include <mrpt/obs/stock_observations.h>
+#include <mrpt/poses/CPose3D.h>
+#include <mrpt/poses/CPose3DPDFGaussian.h>
+#include <mrpt/system/CObserver.h>
 #include <test_mrpt_common.h>
 
 TEST(CMultiMetricMapTests, isEmpty)
@@ -102,3 +110,165 @@ TEST(CMultiMetricMapTests, moveOp)
 
 	EXPECT_EQ(m2.mapByClass<CSimplePointsMap>()->size(), 1U);
 }
+
+namespace
+{
+struct InsertEventsLog : public mrpt::system::CObserver
+{
+	std::vector<const mrpt::maps::CMetricMap*> sources;
+
+   protected:
+	void OnEvent(const mrpt::system::mrptEvent& e) override
+	{
+		if (e.isOfType<mrpt::maps::mrptEventMetricMapInsert>())
+			sources.push_back(
+				static_cast<const mrpt::maps::mrptEventMetricMapInsert&>(e)
+					.source_map);
+	}
+};
+}  // namespace
+
+TEST(CMultiMetricMapTests, parallelInsertAndLikelihood)
+{
+	using mrpt::maps::COccupancyGridMap2D;
+	using mrpt::maps::CSimplePointsMap;
+
+	mrpt::obs::CObservation2DRangeScan scan;
+	mrpt::obs::stock_observations::example2DRangeScan(scan);
+	const mrpt::poses::CPose3D p1(0.5, -0.2, 0, 0.3, 0, 0);
+	const mrpt::poses::CPose3D p2(1.0, 0.1, 0, -0.2, 0, 0);
+
+	auto seq = initializer1();
+	auto par = initializer1();
+	par.numThreads = 4;
+
+	InsertEventsLog events;
+	for (const auto& m : par.maps)
+		events.observeBegin(*m);
+
+	for (auto* m : {&seq, &par})
+	{
+		EXPECT_TRUE(m->insertObservation(scan, p1));
+		EXPECT_TRUE(m->insertObservation(scan, p2));
+	}
+
+	// Events from the calling thread, in map order, one per map and obs:
+	ASSERT_EQ(events.sources.size(), 4U);
+	for (size_t i = 0; i < events.sources.size(); i++)
+		EXPECT_EQ(events.sources[i], par.maps.at(i % 2).get());
+
+	EXPECT_EQ(
+		seq.mapByClass<CSimplePointsMap>()->size(),
+		par.mapByClass<CSimplePointsMap>()->size());
+	EXPECT_EQ(
+		seq.mapByClass<COccupancyGridMap2D>()->getRawMap(),
+		par.mapByClass<COccupancyGridMap2D>()->getRawMap());
+
+	const mrpt::poses::CPose3D p3(0.6, -0.1, 0, 0.25, 0, 0);
+	EXPECT_DOUBLE_EQ(
+		seq.computeObservationLikelihood(scan, p3),
+		par.computeObservationLikelihood(scan, p3));
+
+	// Copies keep the number of threads:
+	const auto par2 = par;
+	EXPECT_EQ(par2.numThreads, 4U);
+}
+
+TEST(CMultiMetricMapTests, numThreadsFromInitializers)
+{
+	mrpt::maps::TSetOfMetricMapInitializers inits;
+	inits.push_back(mrpt::maps::CSimplePointsMap::TMapDefinition());
+	inits.numThreads = 0;
+	const mrpt::maps::CMultiMetricMap m(inits);
+	EXPECT_EQ(m.numThreads, 0U);
+}
+
+TEST(CMultiMetricMapTests, copyOnWrite)
+{
+	using mrpt::maps::COccupancyGridMap2D;
+	using mrpt::maps::CSimplePointsMap;
+
+	mrpt::obs::CObservation2DRangeScan scan;
+	mrpt::obs::stock_observations::example2DRangeScan(scan);
+
+	auto orig = initializer1();
+	orig.copyOnWrite = true;
+	EXPECT_TRUE(orig.insertObservation(scan));
+	const auto nPts = orig.mapByClass<CSimplePointsMap>()->size();
+
+	// Copies share the maps until modified:
+	auto copy = orig;
+	EXPECT_TRUE(copy.copyOnWrite);
+	ASSERT_EQ(copy.maps.size(), orig.maps.size());
+	for (size_t i = 0; i < orig.maps.size(); i++)
+		EXPECT_EQ(copy.maps[i].get(), orig.maps[i].get());
+
+	const mrpt::poses::CPose3D p(0.5, -0.2, 0, 0.3, 0, 0);
+	EXPECT_TRUE(copy.insertObservation(scan, p));
+	for (size_t i = 0; i < orig.maps.size(); i++)
+		EXPECT_NE(copy.maps[i].get(), orig.maps[i].get());
+	EXPECT_EQ(orig.mapByClass<CSimplePointsMap>()->size(), nPts);
+	EXPECT_GT(copy.mapByClass<CSimplePointsMap>()->size(), nPts);
+
+	// Explicit detach:
+	auto copy2 = orig;
+	copy2.detachSharedMaps();
+	EXPECT_NE(copy2.maps[0].get(), orig.maps[0].get());
+	EXPECT_EQ(
+		copy2.mapByClass<COccupancyGridMap2D>()->getRawMap(),
+		orig.mapByClass<COccupancyGridMap2D>()->getRawMap());
+
+	// Without copyOnWrite, copies are deep:
+	orig.copyOnWrite = false;
+	const auto deep = orig;
+	EXPECT_FALSE(deep.copyOnWrite);
+	EXPECT_NE(deep.maps[0].get(), orig.maps[0].get());
+}
+
+TEST(CMultiMetricMapTests, loadFromSimpleMapInTiles)
+{
+	using mrpt::maps::COccupancyGridMap2D;
+	using mrpt::maps::CSimplePointsMap;
+
+	mrpt::maps::CSimpleMap sm;
+	for (int i = 0; i < 8; i++)
+	{
+		auto scan = mrpt::obs::CObservation2DRangeScan::Create();
+		mrpt::obs::stock_observations::example2DRangeScan(*scan);
+		auto sf = mrpt::obs::CSensoryFrame::Create();
+		sf->insert(scan);
+		sm.insert(
+			mrpt::poses::CPose3DPDFGaussian(
+				mrpt::poses::CPose3D(i * 1.5, 0.2 * (i % 3), 0, 0.1 * i, 0, 0)),
+			*sf);
+	}
+
+	auto seq = initializer1();
+	seq.loadFromProbabilisticPosesAndObservations(sm);
+	auto par = initializer1();
+	par.numThreads = 4;
+	par.loadFromSimpleMapInTiles(sm, 3.0 /*tileSize*/);
+
+	EXPECT_EQ(
+		seq.mapByClass<CSimplePointsMap>()->size(),
+		par.mapByClass<CSimplePointsMap>()->size());
+
+	// Equal up to log-odds saturation:
+	const auto gs = seq.mapByClass<COccupancyGridMap2D>();
+	const auto gp = par.mapByClass<COccupancyGridMap2D>();
+	for (unsigned int cy = 0; cy < gs->getSizeY(); cy += 3)
+		for (unsigned int cx = 0; cx < gs->getSizeX(); cx += 3)
+		{
+			const float x = gs->idx2x(cx), y = gs->idx2y(cy);
+			EXPECT_NEAR(gs->getPos(x, y), gp->getPos(x, y), 0.05);
+		}
+
+	// Voxel grid decimation of points:
+	auto dec = initializer1();
+	dec.numThreads = 4;
+	dec.loadFromSimpleMapInTiles(sm, 3.0, 0.5 /*pointsVoxelSize*/);
+	EXPECT_GT(dec.mapByClass<CSimplePointsMap>()->size(), 0U);
+	EXPECT_LT(
+		dec.mapByClass<CSimplePointsMap>()->size(),
+		par.mapByClass<CSimplePointsMap>()->size());
+}
@@ -134,7 +134,7 @@ void COccupancyGridMap2D::copyMapContentFrom(const COccupancyGridMap2D& o)
 	m_basis_map.clear();
 	m_voronoi_diagram.clear();
 
-	m_likelihoodCacheOutDated = true;
+	invalidateLikelihoodCache();
 	m_is_empty = o.m_is_empty;
 }
 
@@ -151,7 +151,7 @@ void COccupancyGridMap2D::setSize(
 	ASSERT_LE_(default_value, 1.0f);
 
 	freeMap();
-	m_likelihoodCacheOutDated = true;
+	invalidateLikelihoodCache();
 
 	// Adjust sizes to adapt them to full sized cells acording to the
 	// resolution:
@@ -225,7 +225,7 @@ void COccupancyGridMap2D::resizeGrid(
 		return;
 
 	// For the precomputed likelihood trick:
-	m_likelihoodCacheOutDated = true;
+	invalidateLikelihoodCache();
 
 	// Add an additional margin:
 	if (additionalMargin)
@@ -329,7 +329,7 @@ void COccupancyGridMap2D::freeMap()
 	size_x = size_y = 0;
 
 	// For the precomputed likelihood trick:
-	m_likelihoodCacheOutDated = true;
+	invalidateLikelihoodCache();
 
 	m_is_empty = true;
 
@@ -421,7 +421,7 @@ void COccupancyGridMap2D::internal_clear()
 {
 	setSize(-10, 10, -10, 10, getResolution());
 	// For the precomputed likelihood trick:
-	m_likelihoodCacheOutDated = true;
+	invalidateLikelihoodCache();
 }
 
 /*---------------------------------------------------------------
@@ -433,7 +433,7 @@ void COccupancyGridMap2D::fill(float default_value)
 	for (auto it = map.begin(); it < map.end(); ++it)
 		*it = defValue;
 	// For the precomputed likelihood trick:
-	m_likelihoodCacheOutDated = true;
+	invalidateLikelihoodCache();
 }
 
 /*---------------------------------------------------------------
@@ -478,6 +478,40 @@ void COccupancyGridMap2D::updateCell(int x, int y, float v)
 	}
 }
 
+void COccupancyGridMap2D::mergeLogOddsFrom(const COccupancyGridMap2D& other)
+{
+	MRPT_START
+	ASSERTMSG_(
+		std::abs(resolution - other.resolution) < 1e-3f * resolution,
+		"Both grid maps must have the same resolution");
+	if (other.isEmpty() || other.map.empty()) return;
+
+	resizeGrid(
+		other.x_min, other.x_max, other.y_min, other.y_max, 0.5f, false);
+
+	const int dx = x2idx(other.idx2x(0)), dy = y2idx(other.idx2y(0));
+	for (unsigned int cy = 0; cy < other.size_y; cy++)
+	{
+		const cellType* src = other.getRow(cy);
+		if (static_cast<unsigned int>(cy + dy) >= size_y) continue;
+		cellType* dst = getRow(cy + dy);
+		for (unsigned int cx = 0; cx < other.size_x; cx++)
+		{
+			if (!src[cx] || static_cast<unsigned int>(cx + dx) >= size_x)
+				continue;
+			cellType& c = dst[cx + dx];
+			const int v = static_cast<int>(c) + src[cx];
+			c = static_cast<cellType>(mrpt::saturate_val<int>(
+				v, OCCGRID_CELLTYPE_MIN, OCCGRID_CELLTYPE_MAX));
+		}
+	}
+	m_is_empty = false;
+	markLikelihoodCacheDirty(
+		dx, dy, dx + static_cast<int>(other.size_x) - 1,
+		dy + static_cast<int>(other.size_y) - 1);
+	MRPT_END
+}
+
 /*---------------------------------------------------------------
 							subSample
  ---------------------------------------------------------------*/
@@ -51,10 +51,6 @@ bool COccupancyGridMap2D::internal_insertObservation(
 	CPose2D robotPose2D;
 	CPose3D robotPose3D;
 
-	// This is required to indicate the grid map has changed!
-	// For the precomputed likelihood trick:
-	m_likelihoodCacheOutDated = true;
-
 	if (robotPose)
 	{
 		robotPose2D = CPose2D(*robotPose);
@@ -172,6 +168,8 @@ bool COccupancyGridMap2D::internal_insertObservation(
 					dAK = -K * o.aperture / N;
 				}
 
+				const float A0 = A;	 // Direction of the first ray
+
 				new_x_max = -(numeric_limits<float>::max)();
 				new_x_min = (numeric_limits<float>::max)();
 				new_y_max = -(numeric_limits<float>::max)();
@@ -216,6 +214,12 @@ bool COccupancyGridMap2D::internal_insertObservation(
 					new_y_min = min(new_y_min, *scanPoint_y);
 				}
 
+				// The area actually modified by the scan:
+				const float scan_x_min = min(new_x_min, px),
+							scan_x_max = max(new_x_max, px),
+							scan_y_min = min(new_y_min, py),
+							scan_y_max = max(new_y_max, py);
+
 				// Add an extra margin:
 				float securMargen = 15 * resolution;
 
@@ -240,6 +244,12 @@ bool COccupancyGridMap2D::internal_insertObservation(
 				// -----------------------
 				resizeGrid(new_x_min, new_x_max, new_y_min, new_y_max, 0.5);
 
+				// For the precomputed likelihood trick (one extra cell, for
+				// widened beams and rounding):
+				markLikelihoodCacheDirty(
+					x2idx(scan_x_min) - 1, y2idx(scan_y_min) - 1,
+					x2idx(scan_x_max) + 1, y2idx(scan_y_max) + 1);
+
 				// For updateCell_fast methods:
 				cellType* theMapArray = &map[0];
 				unsigned theMapSize_x = size_x;
@@ -248,6 +258,66 @@ bool COccupancyGridMap2D::internal_insertObservation(
 					x2idx(px);	// Remember: This must be after the resizeGrid!!
 				int cy0 = y2idx(py);
 
+				if (insertionOptions.batchInsertion)
+				{
+					// Batch insertion with cached beam footprints:
+					// ----------------------------------------------
+					mrpt::obs::T2DScanProperties scanProps;
+					o.getScanProperties(scanProps);
+					auto& footprints = m_beamFootprints.getFootprints(
+						scanProps, (px - x_min) / resolution - cx0,
+						(py - y_min) / resolution - cy0);
+
+					// 1st pass: footprint direction and length of each ray:
+					m_batchRays.clear();
+					std::vector<size_t> rayDirs;
+					rayDirs.reserve(nRanges / K + 1);
+					for (idx = 0; idx < nRanges; idx += K)
+					{
+						const bool valid = o.getScanRangeValidity(idx);
+						if (!valid && !invalidAsFree) continue;
+
+						const int trg_cx = x2idx(scanPoints_x[idx]);
+						const int trg_cy = y2idx(scanPoints_y[idx]);
+						ASSERT_(
+							static_cast<unsigned int>(trg_cx) < size_x &&
+							static_cast<unsigned int>(trg_cy) < size_y);
+
+						TBatchRay r;
+						r.nFree = max(abs(trg_cx - cx0), abs(trg_cy - cy0));
+						r.logodd_free = valid ? logodd_observation_free
+											  : logodd_noecho_free;
+						r.hit = valid &&
+							o.getScanRange(idx) < maxDistanceInsertion;
+						r.hit_dx = trg_cx - cx0;
+						r.hit_dy = trg_cy - cy0;
+						r.logodd_occupied = logodd_observation_occupied;
+						if (!r.nFree && !r.hit) continue;
+
+						const size_t dir = footprints.directionIndex(
+							A0 + (idx / K) * dAK);
+						footprints.footprint(dir, r.nFree);
+						m_batchRays.push_back(r);
+						rayDirs.push_back(dir);
+					}
+					// 2nd pass, once footprints do not grow anymore:
+					for (size_t i = 0; i < m_batchRays.size(); i++)
+					{
+						const auto& fp =
+							footprints.footprint(rayDirs[i], 0);
+						m_batchRays[i].dx = fp.dx.data();
+						m_batchRays[i].dy = fp.dy.data();
+					}
+
+					updateCells_batch(
+						theMapArray, size_x, size_y, cx0, cy0, m_batchRays,
+						m_batchScratch);
+
+					mrpt_alloca_free(scanPoints_x);
+					mrpt_alloca_free(scanPoints_y);
+					return true;
+				}
+
 				// Insert rays:
 				for (idx = 0; idx < nRanges; idx += K)
 				{
@@ -382,6 +452,12 @@ bool COccupancyGridMap2D::internal_insertObservation(
 					new_y_min = min(new_y_min, scanPoint_y);
 				}
 
+				// The area actually modified by the scan:
+				const float scan_x_min = min(new_x_min, px),
+							scan_x_max = max(new_x_max, px),
+							scan_y_min = min(new_y_min, py),
+							scan_y_max = max(new_y_max, py);
+
 				// Add an extra margin:
 				float securMargen = 15 * resolution;
 
@@ -406,6 +482,12 @@ bool COccupancyGridMap2D::internal_insertObservation(
 				// -----------------------
 				resizeGrid(new_x_min, new_x_max, new_y_min, new_y_max, 0.5);
 
+				// For the precomputed likelihood trick (one extra cell, for
+				// widened beams and rounding):
+				markLikelihoodCacheDirty(
+					x2idx(scan_x_min) - 1, y2idx(scan_y_min) - 1,
+					x2idx(scan_x_max) + 1, y2idx(scan_y_max) + 1);
+
 				// For updateCell_fast methods:
 				cellType* theMapArray = &map[0];
 				unsigned theMapSize_x = size_x;
@@ -801,6 +883,10 @@ bool COccupancyGridMap2D::internal_insertObservation(
 	}
 	else if (IS_CLASS(obs, CObservationRange))
 	{
+		// This is required to indicate the grid map has changed!
+		// For the precomputed likelihood trick:
+		invalidateLikelihoodCache();
+
 		const auto& o = dynamic_cast<const CObservationRange&>(obs);
 		CPose3D spose;
 		o.getSensorPose(spose);
@@ -1326,6 +1412,7 @@ void COccupancyGridMap2D::TInsertionOptions::loadFromConfigFile(
 	MRPT_LOAD_CONFIG_VAR(CFD_features_gaussian_size, float, iniFile, section);
 	MRPT_LOAD_CONFIG_VAR(CFD_features_median_size, float, iniFile, section);
 	MRPT_LOAD_CONFIG_VAR(wideningBeamsWithDistance, bool, iniFile, section);
+	MRPT_LOAD_CONFIG_VAR(batchInsertion, bool, iniFile, section);
 }
 
 /*---------------------------------------------------------------
@@ -1350,6 +1437,7 @@ void COccupancyGridMap2D::TInsertionOptions::dumpToTextStream(
 	LOADABLEOPTS_DUMP_VAR(CFD_features_gaussian_size, float)
 	LOADABLEOPTS_DUMP_VAR(CFD_features_median_size, float)
 	LOADABLEOPTS_DUMP_VAR(wideningBeamsWithDistance, bool)
+	LOADABLEOPTS_DUMP_VAR(batchInsertion, bool)
 
 	out << "\n";
 }
@@ -203,7 +203,7 @@ void COccupancyGridMap2D::serializeFrom(
 			}
 
 			// For the precomputed likelihood trick:
-			m_likelihoodCacheOutDated = true;
+			invalidateLikelihoodCache();
 
 			if (version >= 1)
 			{
@@ -284,7 +284,7 @@ bool COccupancyGridMap2D::loadFromBitmap(
 	MRPT_START
 
 	// For the precomputed likelihood trick:
-	m_likelihoodCacheOutDated = true;
+	invalidateLikelihoodCache();
 
 	size_t bmpWidth = imgFl.getWidth();
 	size_t bmpHeight = imgFl.getHeight();
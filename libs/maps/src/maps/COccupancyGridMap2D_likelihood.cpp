@@ -9,12 +9,15 @@
 
 #include "maps-precomp.h"  // Precomp header
 //
+#include <mrpt/core/SSE_types.h>
 #include <mrpt/maps/COccupancyGridMap2D.h>
 #include <mrpt/maps/CSimplePointsMap.h>
 #include <mrpt/obs/CObservation2DRangeScan.h>
 #include <mrpt/obs/CObservationRange.h>
 #include <mrpt/serialization/CArchive.h>
 
+#include <atomic>
+
 using namespace mrpt;
 using namespace mrpt::math;
 using namespace mrpt::maps;
@@ -505,6 +508,276 @@ double COccupancyGridMap2D::computeObservationLikelihood_likelihoodField_II(
 	MRPT_END
 }
 
+#define LIK_LF_CACHE_INVALID (66)
+
+void COccupancyGridMap2D::invalidateLikelihoodCache() const
+{
+	m_likelihoodCacheOutDated = true;
+	newMapVersion();
+}
+
+void COccupancyGridMap2D::newMapVersion() const
+{
+	// Versions are drawn from a global counter, so they are never repeated,
+	// not even by a new map created at the address of a destroyed one:
+	static std::atomic<uint64_t> nextVersion{1};
+	m_mapVersion = nextVersion++;
+}
+
+void COccupancyGridMap2D::markLikelihoodCacheDirty(
+	int cx0, int cy0, int cx1, int cy1) const
+{
+	if (cx1 < cx0 || cy1 < cy0) return;
+	newMapVersion();
+	if (m_lfDirty_x1 < m_lfDirty_x0)
+	{
+		m_lfDirty_x0 = cx0;
+		m_lfDirty_y0 = cy0;
+		m_lfDirty_x1 = cx1;
+		m_lfDirty_y1 = cy1;
+	}
+	else
+	{
+		keep_min(m_lfDirty_x0, cx0);
+		keep_min(m_lfDirty_y0, cy0);
+		keep_max(m_lfDirty_x1, cx1);
+		keep_max(m_lfDirty_y1, cy1);
+	}
+}
+
+namespace
+{
+// Likelihood for the closest obstacle distance `minDist`, in the units of
+// COccupancyGridMap2D::likelihoodField_Thrun_minDist():
+double likelihoodFromMinDist(
+	const COccupancyGridMap2D::TLikelihoodOptions& lo, double _resolution,
+	unsigned int minDist)
+{
+	const float zHit = lo.LF_zHit;
+	const float zRandomTerm = lo.LF_zRandom / lo.LF_maxRange;
+	const float Q = -0.5f / square(lo.LF_stdHit);
+
+	const double constDist2DiscrUnits = 100 / (_resolution * _resolution);
+	const double constDist2DiscrUnits_INV = 1.0 / constDist2DiscrUnits;
+
+	float occupiedMinDist = minDist * constDist2DiscrUnits_INV;
+	if (lo.LF_useSquareDist) occupiedMinDist *= occupiedMinDist;
+
+	return zRandomTerm + zHit * exp(Q * occupiedMinDist);
+}
+
+// The saturation value of likelihoodField_Thrun_minDist():
+unsigned int maxMinDist(
+	const COccupancyGridMap2D::TLikelihoodOptions& lo, double _resolution)
+{
+	const double maxCorrDist_sq = square(lo.LF_maxCorrsDistance);
+	const double constDist2DiscrUnits = 100 / (_resolution * _resolution);
+	return mrpt::round(maxCorrDist_sq * constDist2DiscrUnits);
+}
+}  // namespace
+
+void COccupancyGridMap2D::likelihoodField_Thrun_resetCacheIfOutdated() const
+{
+	if (!likelihoodOptions.enableLikelihoodCache) return;
+
+	// Rebuild the lookup table of the compact cache if its parameters
+	// changed. Distances are multiples of 100 units (1 sq. cell), except
+	// the saturation value, hence:
+	//  m_LF_lut[i] = lik(100*i), and m_LF_lut[(maxDist+99)/100] = lik(maxDist)
+	const auto& lo = likelihoodOptions;
+	bool lutChanged = false;
+	if (lo.LF_compactCache)
+	{
+		const std::array<double, 8> params = {
+			1.0,
+			lo.LF_stdHit,
+			lo.LF_zHit,
+			lo.LF_zRandom,
+			lo.LF_maxRange,
+			lo.LF_maxCorrsDistance,
+			lo.LF_useSquareDist ? 1.0 : 0.0,
+			resolution};
+		if (params != m_LF_lutParams)
+		{
+			lutChanged = true;
+			m_LF_lutParams = params;
+			m_LF_lut.clear();
+
+			const unsigned int maxDist = maxMinDist(lo, resolution);
+			const size_t lutSize = (maxDist + 99) / 100 + 1;
+			if (lutSize < LF_COMPACT_INVALID)
+			{
+				m_LF_lut.resize(lutSize);
+				for (size_t i = 0; i + 1 < lutSize; i++)
+					m_LF_lut[i] = likelihoodFromMinDist(lo, resolution, 100 * i);
+				m_LF_lut.back() = likelihoodFromMinDist(lo, resolution, maxDist);
+			}
+		}
+	}
+	else if (m_LF_lutParams[0] != 0)
+	{
+		lutChanged = true;
+		m_LF_lutParams = {};
+		m_LF_lut.clear();
+	}
+	const bool compact = !m_LF_lut.empty();
+
+	// Only one of the caches is used at a time:
+	if (compact && !precomputedLikelihood.empty())
+		std::vector<double>().swap(precomputedLikelihood);
+	if (!compact && !m_compactLikelihood.empty())
+		std::vector<uint16_t>().swap(m_compactLikelihood);
+
+	const size_t cacheSize =
+		compact ? m_compactLikelihood.size() : precomputedLikelihood.size();
+
+	const bool hasDirtyRect = m_lfDirty_x1 >= m_lfDirty_x0;
+	if (m_likelihoodCacheOutDated || lutChanged ||
+		(hasDirtyRect && cacheSize != map.size()))
+	{
+		if (compact)
+			m_compactLikelihood.assign(map.size(), LF_COMPACT_INVALID);
+		else if (!map.empty())
+			precomputedLikelihood.assign(map.size(), LIK_LF_CACHE_INVALID);
+		else
+			precomputedLikelihood.clear();
+	}
+	else if (hasDirtyRect && !map.empty())
+	{
+		// A cached value depends on the occupied cells up to K cells away,
+		// so only those around the modified cells must be recomputed:
+		const int K = static_cast<int>(
+			ceil(likelihoodOptions.LF_maxCorrsDistance / resolution));
+		const int x0 = std::max(0, m_lfDirty_x0 - K);
+		const int y0 = std::max(0, m_lfDirty_y0 - K);
+		const int x1 = std::min<int>(size_x - 1, m_lfDirty_x1 + K);
+		const int y1 = std::min<int>(size_y - 1, m_lfDirty_y1 + K);
+		for (int cy = y0; cy <= y1; cy++)
+		{
+			if (compact)
+			{
+				auto* row = &m_compactLikelihood[cy * size_x];
+				std::fill(row + x0, row + x1 + 1, LF_COMPACT_INVALID);
+			}
+			else
+			{
+				auto* row = &precomputedLikelihood[cy * size_x];
+				std::fill(row + x0, row + x1 + 1, LIK_LF_CACHE_INVALID);
+			}
+		}
+	}
+
+	// Only written if changed, so evaluations on an up-to-date cache do not
+	// write to the map (see precomputeLikelihoodCache()):
+	if (m_likelihoodCacheOutDated) m_likelihoodCacheOutDated = false;
+	if (hasDirtyRect)
+	{
+		m_lfDirty_x0 = m_lfDirty_y0 = 0;
+		m_lfDirty_x1 = m_lfDirty_y1 = -1;
+	}
+}
+
+double COccupancyGridMap2D::likelihoodField_Thrun_cell(
+	const int cx, const int cy) const
+{
+	const bool useCache = likelihoodOptions.enableLikelihoodCache;
+	const bool compact = useCache && !m_LF_lut.empty();
+
+	// Precomputed table:
+	if (compact)
+	{
+		const uint16_t idx = m_compactLikelihood[cx + cy * size_x];
+		if (idx != LF_COMPACT_INVALID) return m_LF_lut[idx];
+	}
+	else if (useCache)
+	{
+		const double thisLik = precomputedLikelihood[cx + cy * size_x];
+		if (thisLik != LIK_LF_CACHE_INVALID) return thisLik;
+	}
+
+	// Compute now:
+	// -------------
+	const unsigned int minDist = likelihoodField_Thrun_minDist(cx, cy);
+
+	if (compact)
+	{
+		// See likelihoodField_Thrun_resetCacheIfOutdated():
+		const auto idx = static_cast<uint16_t>((minDist + 99) / 100);
+		m_compactLikelihood[cx + cy * size_x] = idx;
+		return m_LF_lut[idx];
+	}
+
+	const double thisLik =
+		likelihoodFromMinDist(likelihoodOptions, resolution, minDist);
+
+	if (useCache)
+		// And save it into the table and into "thisLik":
+		precomputedLikelihood[cx + cy * size_x] = thisLik;
+
+	return thisLik;
+}
+
+void COccupancyGridMap2D::precomputeLikelihoodCache() const
+{
+	if (!likelihoodOptions.enableLikelihoodCache) return;
+	likelihoodField_Thrun_resetCacheIfOutdated();
+	for (int cy = 0; cy < static_cast<int>(size_y); cy++)
+		for (int cx = 0; cx < static_cast<int>(size_x); cx++)
+			likelihoodField_Thrun_cell(cx, cy);
+}
+
+unsigned int COccupancyGridMap2D::likelihoodField_Thrun_minDist(
+	const int cx, const int cy) const
+{
+	// The size of the checking area for matchings:
+	const int K =
+		(int)ceil(likelihoodOptions.LF_maxCorrsDistance /*m*/ / resolution);
+
+	const unsigned int size_x_1 = size_x - 1;
+	const unsigned int size_y_1 = size_y - 1;
+
+	const cellType thresholdCellValue = p2l(0.5f);
+
+	// Find the closest occupied cell in a certain range, given by K:
+	int xx1 = max(0, cx - K);
+	int xx2 = min(size_x_1, (unsigned)(cx + K));
+	int yy1 = max(0, cy - K);
+	int yy2 = min(size_y_1, (unsigned)(cy + K));
+
+	// Optimized code: this part will be invoked a *lot* of times:
+	// Initial pointer position
+	const cellType* mapPtr = &map[xx1 + yy1 * size_x];
+	unsigned incrAfterRow = size_x - ((xx2 - xx1) + 1);
+
+	signed int Ax0 = 10 * (xx1 - cx);
+	signed int Ay = 10 * (yy1 - cy);
+
+	unsigned int occupiedMinDistInt = maxMinDist(likelihoodOptions, resolution);
+
+	for (int yy = yy1; yy <= yy2; yy++)
+	{
+		unsigned int Ay2 = square((unsigned int)(Ay));	// Square is faster
+		// with unsigned.
+		signed short Ax = Ax0;
+		cellType cell;
+
+		for (int xx = xx1; xx <= xx2; xx++)
+		{
+			if ((cell = *mapPtr++) < thresholdCellValue)
+			{
+				unsigned int d = square((unsigned int)(Ax)) + Ay2;
+				keep_min(occupiedMinDistInt, d);
+			}
+			Ax += 10;
+		}
+		// Go to (xx1,yy++)
+		mapPtr += incrAfterRow;
+		Ay += 10;
+	}
+
+	return occupiedMinDistInt;
+}
+
 /*---------------------------------------------------------------
 					computeLikelihoodField_Thrun
  ---------------------------------------------------------------*/
@@ -515,9 +788,6 @@ double COccupancyGridMap2D::computeLikelihoodField_Thrun(
 
 	double ret;
 	size_t N = pm->size();
-	int K = (int)ceil(
-		likelihoodOptions.LF_maxCorrsDistance /*m*/ /
-		resolution);  // The size of the checking area for matchings:
 
 	bool Product_T_OrSum_F = !likelihoodOptions.LF_alternateAverageMethod;
 
@@ -540,35 +810,17 @@ double COccupancyGridMap2D::computeLikelihoodField_Thrun(
 	unsigned int size_x_1 = size_x - 1;
 	unsigned int size_y_1 = size_y - 1;
 
-#define LIK_LF_CACHE_INVALID (66)
-
 	// Aux. variables for the "for j" loop:
 	double thisLik = LIK_LF_CACHE_INVALID;
 	double maxCorrDist_sq = square(likelihoodOptions.LF_maxCorrsDistance);
 	double minimumLik = zRandomTerm + zHit * exp(Q * maxCorrDist_sq);
 	double ccos, ssin;
 
-	if (likelihoodOptions.enableLikelihoodCache)
-	{
-		// Reset the precomputed likelihood values map
-		if (m_likelihoodCacheOutDated)
-		{
-			if (!map.empty())
-				precomputedLikelihood.assign(map.size(), LIK_LF_CACHE_INVALID);
-			else
-				precomputedLikelihood.clear();
-
-			m_likelihoodCacheOutDated = false;
-		}
-	}
+	// Reset the precomputed likelihood values map
+	likelihoodField_Thrun_resetCacheIfOutdated();
 
-	cellType thresholdCellValue = p2l(0.5f);
 	int decimation = likelihoodOptions.LF_decimation;
 
-	const double _resolution = this->resolution;
-	const double constDist2DiscrUnits = 100 / (_resolution * _resolution);
-	const double constDist2DiscrUnits_INV = 1.0 / constDist2DiscrUnits;
-
 	if (N < 10) decimation = 1;
 
 	TPoint2D pointLocal;
@@ -613,70 +865,7 @@ double COccupancyGridMap2D::computeLikelihoodField_Thrun(
 		else
 		{
 			// We are into the map limits:
-			if (likelihoodOptions.enableLikelihoodCache)
-			{ thisLik = precomputedLikelihood[cx + cy * size_x]; }
-
-			if (!likelihoodOptions.enableLikelihoodCache ||
-				thisLik == LIK_LF_CACHE_INVALID)
-			{
-				// Compute now:
-				// -------------
-				// Find the closest occupied cell in a certain range, given by
-				// K:
-				int xx1 = max(0, cx - K);
-				int xx2 = min(size_x_1, (unsigned)(cx + K));
-				int yy1 = max(0, cy - K);
-				int yy2 = min(size_y_1, (unsigned)(cy + K));
-
-				// Optimized code: this part will be invoked a *lot* of times:
-				float occupiedMinDist;
-				{
-					// Initial pointer position
-					const cellType* mapPtr = &map[xx1 + yy1 * size_x];
-					unsigned incrAfterRow = size_x - ((xx2 - xx1) + 1);
-
-					signed int Ax0 = 10 * (xx1 - cx);
-					signed int Ay = 10 * (yy1 - cy);
-
-					unsigned int occupiedMinDistInt =
-						mrpt::round(maxCorrDist_sq * constDist2DiscrUnits);
-
-					for (int yy = yy1; yy <= yy2; yy++)
-					{
-						unsigned int Ay2 =
-							square((unsigned int)(Ay));	 // Square is faster
-						// with unsigned.
-						signed short Ax = Ax0;
-						cellType cell;
-
-						for (int xx = xx1; xx <= xx2; xx++)
-						{
-							if ((cell = *mapPtr++) < thresholdCellValue)
-							{
-								unsigned int d =
-									square((unsigned int)(Ax)) + Ay2;
-								keep_min(occupiedMinDistInt, d);
-							}
-							Ax += 10;
-						}
-						// Go to (xx1,yy++)
-						mapPtr += incrAfterRow;
-						Ay += 10;
-					}
-
-					occupiedMinDist =
-						occupiedMinDistInt * constDist2DiscrUnits_INV;
-				}
-
-				if (likelihoodOptions.LF_useSquareDist)
-					occupiedMinDist *= occupiedMinDist;
-
-				thisLik = zRandomTerm + zHit * exp(Q * occupiedMinDist);
-
-				if (likelihoodOptions.enableLikelihoodCache)
-					// And save it into the table and into "thisLik":
-					precomputedLikelihood[cx + cy * size_x] = thisLik;
-			}
+			thisLik = likelihoodField_Thrun_cell(cx, cy);
 		}
 
 		// Update the likelihood:
@@ -695,6 +884,172 @@ double COccupancyGridMap2D::computeLikelihoodField_Thrun(
 	MRPT_END
 }
 
+/*---------------------------------------------------------------
+					computeLikelihoodFieldBatch
+ ---------------------------------------------------------------*/
+void COccupancyGridMap2D::computeLikelihoodFieldBatch(
+	const CPointsMap& pm, const std::vector<mrpt::math::TPose2D>& poses,
+	std::vector<double>& out_log_lik) const
+{
+	MRPT_START
+
+	const size_t nPoses = poses.size();
+	out_log_lik.assign(nPoses, -100);  // -100: No points, no way to estimate
+
+	const size_t N = pm.size();
+	if (!N || !nPoses) return;
+
+	const bool Product_T_OrSum_F = !likelihoodOptions.LF_alternateAverageMethod;
+
+	const float zRandomTerm =
+		likelihoodOptions.LF_zRandom / likelihoodOptions.LF_maxRange;
+	const float Q = -0.5f / square(likelihoodOptions.LF_stdHit);
+	const double maxCorrDist_sq = square(likelihoodOptions.LF_maxCorrsDistance);
+	const double minimumLik =
+		zRandomTerm + likelihoodOptions.LF_zHit * exp(Q * maxCorrDist_sq);
+
+	const unsigned int size_x_1 = size_x - 1;
+	const unsigned int size_y_1 = size_y - 1;
+
+	likelihoodField_Thrun_resetCacheIfOutdated();
+
+	int decimation = likelihoodOptions.LF_decimation;
+	if (N < 10) decimation = 1;
+
+	// Gather the (decimated) local points once, for all poses, in
+	// contiguous buffers padded to a multiple of 4:
+	const size_t nPts = (N + decimation - 1) / decimation;
+	const size_t nPtsPadded = ((nPts + 3) / 4) * 4;
+	std::vector<float> xs(nPtsPadded, 0), ys(nPtsPadded, 0);
+	{
+		const auto& pm_xs = pm.getPointsBufferRef_x();
+		const auto& pm_ys = pm.getPointsBufferRef_y();
+		for (size_t j = 0, k = 0; j < N; j += decimation, k++)
+		{
+			xs[k] = pm_xs[j];
+			ys[k] = pm_ys[j];
+		}
+	}
+
+	// Cell indices of all points, for one pose:
+	std::vector<int32_t> cxs(nPtsPadded), cys(nPtsPadded);
+
+	// Accumulated products of likelihoods are converted into log-likelihood
+	// just once every few points, which saves many log() calls. The product
+	// is also flushed whenever it becomes too small, so it cannot underflow.
+	constexpr size_t LOG_EVERY = 16;
+	constexpr double MIN_ACCUM_PROD = 1e-100;
+
+	for (size_t p = 0; p < nPoses; p++)
+	{
+		const auto& pose = poses[p];
+		const float ccos = static_cast<float>(cos(pose.phi));
+		const float ssin = static_cast<float>(sin(pose.phi));
+		const float x0 = static_cast<float>(pose.x);
+		const float y0 = static_cast<float>(pose.y);
+
+		// Transform points and compute their cell indices:
+#if MRPT_HAS_SSE2
+		const __m128 cos_4val = _mm_set1_ps(ccos);
+		const __m128 sin_4val = _mm_set1_ps(ssin);
+		const __m128 x0_4val = _mm_set1_ps(x0 - x_min);
+		const __m128 y0_4val = _mm_set1_ps(y0 - y_min);
+		const __m128 res_4val = _mm_set1_ps(resolution);
+
+		for (size_t k = 0; k < nPtsPadded; k += 4)
+		{
+			const __m128 lxs = _mm_loadu_ps(&xs[k]);
+			const __m128 lys = _mm_loadu_ps(&ys[k]);
+
+			const __m128 gxs = _mm_add_ps(
+				x0_4val, _mm_sub_ps(
+							 _mm_mul_ps(lxs, cos_4val),
+							 _mm_mul_ps(lys, sin_4val)));
+			const __m128 gys = _mm_add_ps(
+				y0_4val, _mm_add_ps(
+							 _mm_mul_ps(lxs, sin_4val),
+							 _mm_mul_ps(lys, cos_4val)));
+
+			// Truncation, as in x2idx():
+			_mm_storeu_si128(
+				reinterpret_cast<__m128i*>(&cxs[k]),
+				_mm_cvttps_epi32(_mm_div_ps(gxs, res_4val)));
+			_mm_storeu_si128(
+				reinterpret_cast<__m128i*>(&cys[k]),
+				_mm_cvttps_epi32(_mm_div_ps(gys, res_4val)));
+		}
+#else
+		for (size_t k = 0; k < nPts; k++)
+		{
+			cxs[k] = x2idx(x0 + xs[k] * ccos - ys[k] * ssin);
+			cys[k] = y2idx(y0 + xs[k] * ssin + ys[k] * ccos);
+		}
+#endif
+
+		// Gather likelihood values:
+		double ret = 0, accumProd = 1;
+		for (size_t k = 0; k < nPts; k++)
+		{
+			const int cx = cxs[k], cy = cys[k];
+			const double thisLik = (static_cast<unsigned>(cx) >= size_x_1 ||
+									static_cast<unsigned>(cy) >= size_y_1)
+				? minimumLik
+				: likelihoodField_Thrun_cell(cx, cy);
+
+			if (Product_T_OrSum_F)
+			{
+				accumProd *= thisLik;
+				if ((k % LOG_EVERY) == LOG_EVERY - 1 ||
+					accumProd < MIN_ACCUM_PROD)
+				{
+					ret += log(accumProd);
+					accumProd = 1;
+				}
+			}
+			else
+				ret += thisLik;
+		}
+
+		if (Product_T_OrSum_F) ret += log(accumProd);
+		else
+			ret = log(ret / nPts);
+
+		out_log_lik[p] = ret;
+	}
+
+	MRPT_END
+}
+
+void COccupancyGridMap2D::computeLikelihoodFieldBatch(
+	const CObservation2DRangeScan& scan,
+	const std::vector<mrpt::math::TPose2D>& poses,
+	std::vector<double>& out_log_lik) const
+{
+	MRPT_START
+
+	// Insert only HORIZONTAL scans, since the grid is supposed to
+	//  be a horizontal representation of space.
+	if (!scan.isPlanarScan(insertionOptions.horizontalTolerance))
+	{
+		out_log_lik.assign(poses.size(), -10);
+		return;
+	}
+
+	// Same points-map representation of the scan than in
+	// computeObservationLikelihood_likelihoodField_Thrun():
+	CPointsMap::TInsertionOptions opts;
+	opts.minDistBetweenLaserPoints = resolution * 0.5f;
+	opts.isPlanarMap = true;  // Already filtered above!
+	opts.horizontalTolerance = insertionOptions.horizontalTolerance;
+
+	const auto* pm = scan.buildAuxPointsMap<mrpt::maps::CPointsMap>(&opts);
+	ASSERT_(pm != nullptr);
+
+	computeLikelihoodFieldBatch(*pm, poses, out_log_lik);
+
+	MRPT_END
+}
+
 /*---------------------------------------------------------------
 					computeLikelihoodField_II
  ---------------------------------------------------------------*/
@@ -827,6 +1182,8 @@ void COccupancyGridMap2D::TLikelihoodOptions::loadFromConfigFile(
 		iniFile.read_bool(section, "LF_useSquareDist", LF_useSquareDist);
 	LF_alternateAverageMethod = iniFile.read_bool(
 		section, "LF_alternateAverageMethod", LF_alternateAverageMethod);
+	LF_compactCache =
+		iniFile.read_bool(section, "LF_compactCache", LF_compactCache);
 
 	MI_exponent = iniFile.read_float(section, "MI_exponent", MI_exponent);
 	MI_skip_rays = iniFile.read_int(section, "MI_skip_rays", MI_skip_rays);
@@ -891,6 +1248,9 @@ void COccupancyGridMap2D::TLikelihoodOptions::dumpToTextStream(
 	out << mrpt::format(
 		"LF_alternateAverageMethod               = %c\n",
 		LF_alternateAverageMethod ? 'Y' : 'N');
+	out << mrpt::format(
+		"LF_compactCache                         = %c\n",
+		LF_compactCache ? 'Y' : 'N');
 	out << mrpt::format(
 		"MI_exponent                             = %f\n", MI_exponent);
 	out << mrpt::format(
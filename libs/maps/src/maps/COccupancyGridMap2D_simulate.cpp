@@ -10,6 +10,7 @@
 #include "maps-precomp.h"  // Precomp header
 //
 #include <mrpt/core/round.h>  // round()
+#include <mrpt/maps/CLaserScanSimulatorGL.h>
 #include <mrpt/maps/COccupancyGridMap2D.h>
 #include <mrpt/math/CVectorFixed.h>
 #include <mrpt/math/transform_gaussian.h>
@@ -68,6 +69,38 @@ void COccupancyGridMap2D::laserScanSimulator(
 	MRPT_END
 }
 
+void COccupancyGridMap2D::laserScanSimulatorBatch(
+	const std::vector<CPose2D>& robotPoses,
+	const CObservation2DRangeScan& scanTemplate,
+	std::vector<CObservation2DRangeScan>& outScans, float threshold, size_t N,
+	float noiseStd, TLaserSimulBackend backend) const
+{
+	MRPT_START
+
+	if (backend == TLaserSimulBackend::OpenGL &&
+		CLaserScanSimulatorGL::IsAvailable())
+	{
+		try
+		{
+			CLaserScanSimulatorGL sim(*this, threshold);
+			sim.simulate(robotPoses, scanTemplate, outScans, N, noiseStd);
+			return;
+		}
+		catch (const std::exception& e)
+		{
+			std::cerr << "[COccupancyGridMap2D::laserScanSimulatorBatch] "
+						 "OpenGL backend failed, falling back to CPU: "
+					  << e.what() << std::endl;
+		}
+	}
+
+	outScans.assign(robotPoses.size(), scanTemplate);
+	for (size_t i = 0; i < robotPoses.size(); i++)
+		laserScanSimulator(outScans[i], robotPoses[i], threshold, N, noiseStd);
+
+	MRPT_END
+}
+
 void COccupancyGridMap2D::sonarSimulator(
 	CObservationRange& inout_observation, const CPose2D& robotPose,
 	float threshold, float rangeNoiseStd, float angleNoiseStd) const
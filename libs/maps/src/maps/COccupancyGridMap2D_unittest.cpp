@@ -12,6 +12,8 @@
 #include <mrpt/obs/CObservation2DRangeScan.h>
 #include <mrpt/obs/stock_observations.h>
 
+#include <thread>
+
 using namespace mrpt;
 using namespace mrpt::maps;
 using namespace mrpt::obs;
@@ -33,3 +35,320 @@ TEST(COccupancyGridMap2DTests, insert2DScan)
 		// should have a high "freeness"
 	}
 }
+
+TEST(COccupancyGridMap2DTests, computeLikelihoodFieldBatch)
+{
+	mrpt::obs::CObservation2DRangeScan scan1;
+	stock_observations::example2DRangeScan(scan1);
+
+	COccupancyGridMap2D grid(-50.0f, 50.0f, -50.0f, 50.0f, 0.10f);
+	grid.insertObservation(scan1);
+
+	const std::vector<TPose2D> poses = {
+		{0, 0, 0}, {0.05, -0.02, 0.01}, {0.3, 0.2, 0.1}, {-1.0, 2.0, -0.5}};
+
+	std::vector<double> batchLiks;
+	grid.computeLikelihoodFieldBatch(scan1, poses, batchLiks);
+	ASSERT_EQ(batchLiks.size(), poses.size());
+
+	grid.likelihoodOptions.likelihoodMethod =
+		COccupancyGridMap2D::lmLikelihoodField_Thrun;
+	for (size_t i = 0; i < poses.size(); i++)
+	{
+		const double lik = grid.computeObservationLikelihood(
+			scan1, CPose3D(CPose2D(poses[i])));
+		// Points falling on cell borders may differ due to float rounding:
+		EXPECT_NEAR(batchLiks[i], lik, 0.05 * std::abs(lik) + 1e-3);
+	}
+
+	// The ground-truth pose must be the most likely one:
+	EXPECT_GT(batchLiks[0], batchLiks[2]);
+	EXPECT_GT(batchLiks[0], batchLiks[3]);
+}
+
+TEST(COccupancyGridMap2DTests, laserScanSimulatorBatch)
+{
+	// A 6x4 m room, centered at the origin:
+	COccupancyGridMap2D grid(-5.0f, 5.0f, -5.0f, 5.0f, 0.05f);
+	for (float x = -3.0f; x <= 3.0f; x += 0.025f)
+	{
+		grid.setPos(x, -2.0f, 0.0f);
+		grid.setPos(x, 2.0f, 0.0f);
+	}
+	for (float y = -2.0f; y <= 2.0f; y += 0.025f)
+	{
+		grid.setPos(-3.0f, y, 0.0f);
+		grid.setPos(3.0f, y, 0.0f);
+	}
+
+	CObservation2DRangeScan scanTemplate;
+	scanTemplate.aperture = mrpt::DEG2RAD(180.0);
+	scanTemplate.maxRange = 8.0f;
+
+	const std::vector<CPose2D> poses = {
+		{0, 0, 0}, {1.0, 0.5, 0.3}, {-2.0, -1.0, -2.0}, {0.5, 1.5, 1.2}};
+	const size_t N = 181;
+
+	std::vector<CObservation2DRangeScan> cpuScans;
+	grid.laserScanSimulatorBatch(poses, scanTemplate, cpuScans, 0.6f, N);
+	ASSERT_EQ(cpuScans.size(), poses.size());
+
+	for (size_t i = 0; i < poses.size(); i++)
+	{
+		CObservation2DRangeScan scan = scanTemplate;
+		grid.laserScanSimulator(scan, poses[i], 0.6f, N);
+		ASSERT_EQ(cpuScans[i].getScanSize(), N);
+		for (size_t j = 0; j < N; j++)
+		{
+			EXPECT_EQ(cpuScans[i].getScanRange(j), scan.getScanRange(j));
+			EXPECT_EQ(
+				cpuScans[i].getScanRangeValidity(j),
+				scan.getScanRangeValidity(j));
+		}
+	}
+	// Facing the right wall:
+	EXPECT_NEAR(cpuScans[0].getScanRange(N / 2), 3.0f, 0.1f);
+
+	// OpenGL backend (it may fall back to CPU if not available). Ranges are
+	// computed against exact cell borders, so allow one cell of difference:
+	std::vector<CObservation2DRangeScan> glScans;
+	grid.laserScanSimulatorBatch(
+		poses, scanTemplate, glScans, 0.6f, N, 0,
+		COccupancyGridMap2D::TLaserSimulBackend::OpenGL);
+	ASSERT_EQ(glScans.size(), poses.size());
+
+	size_t nMismatches = 0;
+	for (size_t i = 0; i < poses.size(); i++)
+	{
+		ASSERT_EQ(glScans[i].getScanSize(), N);
+		for (size_t j = 0; j < N; j++)
+		{
+			if (!cpuScans[i].getScanRangeValidity(j)) continue;
+			if (!glScans[i].getScanRangeValidity(j) ||
+				std::abs(
+					glScans[i].getScanRange(j) - cpuScans[i].getScanRange(j)) >
+					0.1f)
+				nMismatches++;
+		}
+	}
+	// Tolerate a few corner rays:
+	EXPECT_LT(nMismatches, poses.size() * N / 50);
+}
+
+TEST(COccupancyGridMap2DTests, likelihoodCacheDirtyRegion)
+{
+	mrpt::obs::CObservation2DRangeScan scan1;
+	stock_observations::example2DRangeScan(scan1);
+
+	COccupancyGridMap2D grid(-20.0f, 20.0f, -20.0f, 20.0f, 0.10f);
+	grid.likelihoodOptions.likelihoodMethod =
+		COccupancyGridMap2D::lmLikelihoodField_Thrun;
+	grid.likelihoodOptions.enableLikelihoodCache = true;
+	grid.insertObservation(scan1);
+
+	std::vector<CPose3D> poses;
+	for (double x = -1.0; x <= 1.0; x += 0.25)
+		for (double phi = -0.4; phi <= 0.4; phi += 0.2)
+			poses.emplace_back(x, 0.1 * x, 0, phi, 0, 0);
+
+	// Fill the cache:
+	for (const auto& p : poses)
+		grid.computeObservationLikelihood(scan1, p);
+
+	// Edit the map: by inserting a scan, and by hand:
+	grid.insertObservation(scan1, CPose3D(0.5, 0.2, 0, 0.3, 0, 0));
+	for (int cx = 200; cx < 210; cx++)
+		grid.setCell(cx, 205, 0.01f);
+	grid.markLikelihoodCacheDirty(200, 205, 209, 205);
+
+	COccupancyGridMap2D ref = grid;
+	ref.invalidateLikelihoodCache();
+
+	for (const auto& p : poses)
+		EXPECT_DOUBLE_EQ(
+			grid.computeObservationLikelihood(scan1, p),
+			ref.computeObservationLikelihood(scan1, p));
+}
+
+TEST(COccupancyGridMap2DTests, likelihoodCompactCache)
+{
+	mrpt::obs::CObservation2DRangeScan scan1;
+	stock_observations::example2DRangeScan(scan1);
+
+	COccupancyGridMap2D ref(-20.0f, 20.0f, -20.0f, 20.0f, 0.05f);
+	ref.likelihoodOptions.likelihoodMethod =
+		COccupancyGridMap2D::lmLikelihoodField_Thrun;
+	ref.likelihoodOptions.enableLikelihoodCache = true;
+	ref.insertObservation(scan1);
+
+	COccupancyGridMap2D grid = ref;
+	grid.likelihoodOptions.LF_compactCache = true;
+
+	std::vector<CPose3D> poses;
+	for (double x = -1.0; x <= 1.0; x += 0.25)
+		for (double phi = -0.4; phi <= 0.4; phi += 0.2)
+			poses.emplace_back(x, 0.1 * x, 0, phi, 0, 0);
+
+	for (const bool useSquareDist : {false, true})
+	{
+		ref.likelihoodOptions.LF_useSquareDist = useSquareDist;
+		grid.likelihoodOptions.LF_useSquareDist = useSquareDist;
+		ref.invalidateLikelihoodCache();
+
+		// Twice: filling and reading the cache:
+		for (int pass = 0; pass < 2; pass++)
+			for (const auto& p : poses)
+				EXPECT_DOUBLE_EQ(
+					grid.computeObservationLikelihood(scan1, p),
+					ref.computeObservationLikelihood(scan1, p));
+	}
+
+	// The lookup table is rebuilt if the likelihood parameters change:
+	grid.likelihoodOptions.LF_stdHit = ref.likelihoodOptions.LF_stdHit = 0.2f;
+	ref.invalidateLikelihoodCache();
+	grid.insertObservation(scan1, CPose3D(0.5, 0.2, 0, 0.3, 0, 0));
+	ref.insertObservation(scan1, CPose3D(0.5, 0.2, 0, 0.3, 0, 0));
+	for (const auto& p : poses)
+		EXPECT_DOUBLE_EQ(
+			grid.computeObservationLikelihood(scan1, p),
+			ref.computeObservationLikelihood(scan1, p));
+}
+
+TEST(COccupancyGridMap2DTests, precomputeLikelihoodCache)
+{
+	mrpt::obs::CObservation2DRangeScan scan1;
+	stock_observations::example2DRangeScan(scan1);
+
+	for (const bool compact : {false, true})
+	{
+		COccupancyGridMap2D ref(-20.0f, 20.0f, -20.0f, 20.0f, 0.10f);
+		ref.likelihoodOptions.likelihoodMethod =
+			COccupancyGridMap2D::lmLikelihoodField_Thrun;
+		ref.likelihoodOptions.enableLikelihoodCache = true;
+		ref.likelihoodOptions.LF_compactCache = compact;
+		ref.insertObservation(scan1);
+
+		COccupancyGridMap2D grid = ref;
+		grid.precomputeLikelihoodCache();
+		// This also builds the points of the scan, cached in the observation:
+		grid.computeObservationLikelihood(scan1, CPose3D());
+
+		// The filled cache is only read, from several threads at once:
+		std::vector<CPose3D> poses;
+		for (double x = -1.0; x <= 1.0; x += 0.1)
+			poses.emplace_back(x, 0.1 * x, 0, 0.2 * x, 0, 0);
+		std::vector<double> liks(poses.size());
+		std::vector<std::thread> threads;
+		for (size_t t = 0; t < 4; t++)
+			threads.emplace_back([&, t]() {
+				for (size_t i = t; i < poses.size(); i += 4)
+					liks[i] = grid.computeObservationLikelihood(scan1, poses[i]);
+			});
+		for (auto& t : threads)
+			t.join();
+
+		for (size_t i = 0; i < poses.size(); i++)
+			EXPECT_DOUBLE_EQ(
+				liks[i], ref.computeObservationLikelihood(scan1, poses[i]));
+	}
+}
+
+TEST(COccupancyGridMap2DTests, batchInsertion)
+{
+	mrpt::obs::CObservation2DRangeScan scan1;
+	stock_observations::example2DRangeScan(scan1);
+
+	COccupancyGridMap2D ref(-20.0f, 20.0f, -20.0f, 20.0f, 0.05f);
+	COccupancyGridMap2D grid(-20.0f, 20.0f, -20.0f, 20.0f, 0.05f);
+	grid.insertionOptions.batchInsertion = true;
+	for (const auto& p :
+		 {CPose3D(), CPose3D(0.51, 0.23, 0, 0.3, 0, 0),
+		  CPose3D(-0.37, 1.02, 0, -2.1, 0, 0)})
+	{
+		ref.insertObservation(scan1, p);
+		grid.insertObservation(scan1, p);
+	}
+	EXPECT_GT(grid.getPos(0.5, 0), 0.51f);
+
+	// Rays are rasterized from the actual sensor position within its cell, so
+	// they may traverse cells next to those of the default method, but
+	// both should update a similar number of cells and the same obstacles:
+	size_t nUpdatedRef = 0, nUpdated = 0, nOccupiedRef = 0, nOccupiedBoth = 0;
+	for (unsigned int cy = 0; cy < ref.getSizeY(); cy++)
+	{
+		for (unsigned int cx = 0; cx < ref.getSizeX(); cx++)
+		{
+			const float pr = ref.getCell(cx, cy), pg = grid.getCell(cx, cy);
+			if (pr != 0.5f) nUpdatedRef++;
+			if (pg != 0.5f) nUpdated++;
+			if (pr >= 0.5f) continue;
+			nOccupiedRef++;
+			if (pg < 0.5f) nOccupiedBoth++;
+		}
+	}
+	EXPECT_GT(nUpdatedRef, 10000U);
+	EXPECT_NEAR(nUpdated, nUpdatedRef, nUpdatedRef / 10);
+	EXPECT_GT(nOccupiedRef, 100U);
+	EXPECT_GT(nOccupiedBoth, nOccupiedRef * 9 / 10);
+}
+
+TEST(COccupancyGridMap2DTests, mapVersion)
+{
+	mrpt::obs::CObservation2DRangeScan scan1;
+	stock_observations::example2DRangeScan(scan1);
+
+	COccupancyGridMap2D grid1(-10.0f, 10.0f, -10.0f, 10.0f, 0.10f);
+	COccupancyGridMap2D grid2(-10.0f, 10.0f, -10.0f, 10.0f, 0.10f);
+	EXPECT_NE(grid1.getMapVersion(), grid2.getMapVersion());
+
+	// Copies keep the version, until modified:
+	COccupancyGridMap2D copy = grid1;
+	EXPECT_EQ(copy.getMapVersion(), grid1.getMapVersion());
+
+	uint64_t v = grid1.getMapVersion();
+	grid1.insertObservation(scan1);
+	EXPECT_NE(grid1.getMapVersion(), v);
+	EXPECT_NE(grid1.getMapVersion(), copy.getMapVersion());
+
+	v = grid1.getMapVersion();
+	grid1.setCell(5, 5, 0.1f);
+	grid1.markLikelihoodCacheDirty(5, 5, 5, 5);
+	EXPECT_NE(grid1.getMapVersion(), v);
+
+	v = grid1.getMapVersion();
+	grid1.clear();
+	EXPECT_NE(grid1.getMapVersion(), v);
+
+	// Queries do not change it:
+	v = grid1.getMapVersion();
+	grid1.computeObservationLikelihood(scan1, CPose3D());
+	EXPECT_EQ(grid1.getMapVersion(), v);
+}
+
+TEST(COccupancyGridMap2DTests, mergeLogOddsFrom)
+{
+	CObservation2DRangeScan scan;
+	stock_observations::example2DRangeScan(scan);
+	const CPose3D p1(0, 0, 0, 0, 0, 0), p2(6.0, 1.0, 0, 0.5, 0, 0);
+
+	COccupancyGridMap2D all(-5.0f, 5.0f, -5.0f, 5.0f, 0.10f);
+	all.insertObservation(scan, p1);
+	all.insertObservation(scan, p2);
+
+	COccupancyGridMap2D g1(-5.0f, 5.0f, -5.0f, 5.0f, 0.10f);
+	COccupancyGridMap2D g2(-5.0f, 5.0f, -5.0f, 5.0f, 0.10f);
+	g1.insertObservation(scan, p1);
+	g2.insertObservation(scan, p2);
+	g1.mergeLogOddsFrom(g2);
+
+	EXPECT_FALSE(g1.isEmpty());
+	EXPECT_LE(g1.getXMin(), g2.getXMin());
+	EXPECT_GE(g1.getXMax(), g2.getXMax());
+	for (float y = all.getYMin(); y < all.getYMax(); y += 0.3f)
+		for (float x = all.getXMin(); x < all.getXMax(); x += 0.3f)
+			EXPECT_NEAR(all.getPos(x, y), g1.getPos(x, y), 0.05f);
+
+	// Different resolution:
+	COccupancyGridMap2D g3(-5.0f, 5.0f, -5.0f, 5.0f, 0.05f);
+	EXPECT_ANY_THROW(g3.mergeLogOddsFrom(g2));
+}
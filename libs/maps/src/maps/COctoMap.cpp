@@ -126,6 +126,7 @@ void COctoMap::serializeFrom(mrpt::serialization::CArchive& in, uint8_t version)
 				ss.str(buf);
 				ss.seekg(0);
 				m_impl->m_octomap.readBinary(ss);
+				m_impl->voxelsSync = {};
 			}
 		}
 		break;
@@ -143,8 +144,7 @@ bool COctoMap::internal_insertObservation(
 			obs, robotPose, sensorPt, scan))
 		return false;  // Nothing to do.
 	// Insert rays:
-	m_impl->m_octomap.insertPointCloud(
-		scan, sensorPt, insertionOptions.maxrange, insertionOptions.pruning);
+	internal_insertScan(sensorPt, scan);
 	return true;
 }
 
@@ -157,10 +157,6 @@ void COctoMap::getAsOctoMapVoxels(mrpt::opengl::COctoMapVoxels& gl_obj) const
 	octomap::OcTree::tree_iterator it_end = m_impl->m_octomap.end_tree();
 
 	const unsigned char max_depth = 0;	// all
-	const TColorf general_color = gl_obj.getColor();
-	const TColor general_color_u(
-		general_color.R * 255, general_color.G * 255, general_color.B * 255,
-		general_color.A * 255);
 
 	gl_obj.clear();
 	gl_obj.reserveGridCubes(this->calcNumNodes());
@@ -195,53 +191,8 @@ void COctoMap::getAsOctoMapVoxels(mrpt::opengl::COctoMapVoxels& gl_obj) const
 			if ((occ >= 0.5 && renderingOptions.generateOccupiedVoxels) ||
 				(occ < 0.5 && renderingOptions.generateFreeVoxels))
 			{
-				mrpt::img::TColor vx_color;
-				double coefc, coeft;
-				switch (gl_obj.getVisualizationMode())
-				{
-					case COctoMapVoxels::FIXED:
-						vx_color = general_color_u;
-						break;
-					case COctoMapVoxels::COLOR_FROM_HEIGHT:
-						coefc = 255 * inv_dz * (vx_center.z() - zmin);
-						vx_color = TColor(
-							coefc * general_color.R, coefc * general_color.G,
-							coefc * general_color.B, 255.0 * general_color.A);
-						break;
-
-					case COctoMapVoxels::COLOR_FROM_OCCUPANCY:
-						coefc = 240 * (1 - occ) + 15;
-						vx_color = TColor(
-							coefc * general_color.R, coefc * general_color.G,
-							coefc * general_color.B, 255.0 * general_color.A);
-						break;
-
-					case COctoMapVoxels::TRANSPARENCY_FROM_OCCUPANCY:
-						coeft = 255 - 510 * (1 - occ);
-						if (coeft < 0) { coeft = 0; }
-						vx_color = TColor(
-							255 * general_color.R, 255 * general_color.G,
-							255 * general_color.B, coeft);
-						break;
-
-					case COctoMapVoxels::TRANS_AND_COLOR_FROM_OCCUPANCY:
-						coefc = 240 * (1 - occ) + 15;
-						vx_color = TColor(
-							coefc * general_color.R, coefc * general_color.G,
-							coefc * general_color.B, 50);
-						break;
-
-					case COctoMapVoxels::MIXED:
-						coefc = 255 * inv_dz * (vx_center.z() - zmin);
-						coeft = 255 - 510 * (1 - occ);
-						if (coeft < 0) { coeft = 0; }
-						vx_color = TColor(
-							coefc * general_color.R, coefc * general_color.G,
-							coefc * general_color.B, coeft);
-						break;
-
-					default: THROW_EXCEPTION("Unknown coloring scheme!");
-				}
+				const mrpt::img::TColor vx_color = internal_getVoxelColor(
+					*it, vx_center.z(), zmin, inv_dz, gl_obj);
 
 				const size_t vx_set = (m_impl->m_octomap.isNodeOccupied(*it))
 					? VOXEL_SET_OCCUPIED
@@ -283,14 +234,18 @@ void COctoMap::insertRay(
 	const float end_x, const float end_y, const float end_z,
 	const float sensor_x, const float sensor_y, const float sensor_z)
 {
+	const octomap::point3d sensorPt(sensor_x, sensor_y, sensor_z),
+		endPt(end_x, end_y, end_z);
+	internal_markModifiedRay(sensorPt, endPt);
 	m_impl->m_octomap.insertRay(
-		octomap::point3d(sensor_x, sensor_y, sensor_z),
-		octomap::point3d(end_x, end_y, end_z), insertionOptions.maxrange,
-		insertionOptions.pruning);
+		sensorPt, endPt, insertionOptions.maxrange, insertionOptions.pruning);
 }
 void COctoMap::updateVoxel(
 	const double x, const double y, const double z, bool occupied)
 {
+	octomap::OcTreeKey key;
+	if (m_impl->m_octomap.coordToKeyChecked(octomap::point3d(x, y, z), key))
+		internal_markModifiedVoxel(key);
 	m_impl->m_octomap.updateNode(x, y, z, occupied);
 }
 bool COctoMap::isPointWithinOctoMap(
@@ -399,4 +354,8 @@ float COctoMap::getClampingThresMaxLog() const
 {
 	return m_impl->m_octomap.getClampingThresMaxLog();
 }
-void COctoMap::internal_clear() { m_impl->m_octomap.clear(); }
+void COctoMap::internal_clear()
+{
+	m_impl->m_octomap.clear();
+	m_impl->voxelsSync = {};
+}
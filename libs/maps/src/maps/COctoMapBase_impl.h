@@ -16,12 +16,50 @@
 #include <mrpt/obs/CObservationVelodyneScan.h>
 #include <mrpt/serialization/CArchive.h>
 
+#include <algorithm>
+#include <array>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
 namespace mrpt::maps
 {
 template <class OCTREE, class OCTREE_NODE>
 struct mrpt::maps::COctoMapBase<OCTREE, OCTREE_NODE>::Impl
 {
 	OCTREE m_octomap;
+
+	/** log2 of the side length, in leaves, of the blocks of voxels
+	 * regenerated by updateOctoMapVoxels() */
+	static constexpr unsigned int VOXEL_BLOCK_BITS = 4;
+
+	static uint64_t voxelBlockId(
+		uint64_t bx, uint64_t by, uint64_t bz)
+	{
+		return (bx << 32) | (by << 16) | bz;
+	}
+	static uint64_t voxelBlockOf(const octomap::OcTreeKey& k)
+	{
+		return voxelBlockId(
+			k[0] >> VOXEL_BLOCK_BITS, k[1] >> VOXEL_BLOCK_BITS,
+			k[2] >> VOXEL_BLOCK_BITS);
+	}
+
+	/** The COctoMapVoxels kept updated by updateOctoMapVoxels(), and the
+	 * parameters used to generate its voxels */
+	struct VoxelsSync
+	{
+		const mrpt::opengl::COctoMapVoxels* glObj = nullptr;
+		mrpt::opengl::COctoMapVoxels::visualization_mode_t mode =
+			mrpt::opengl::COctoMapVoxels::FIXED;
+		mrpt::img::TColor color;
+		bool generateOccupied = true, generateFree = true;
+		double zmin = 0, zmax = 0;
+		/** Blocks modified since the last update */
+		std::unordered_set<uint64_t> modifiedBlocks;
+	};
+	VoxelsSync voxelsSync;
 };
 
 template <class OCTREE, class OCTREE_NODE>
@@ -262,13 +300,456 @@ void COctoMapBase<OCTREE, OCTREE_NODE>::insertPointCloud(
 	size_t N;
 	const float *xs, *ys, *zs;
 	ptMap.getPointsBuffer(N, xs, ys, zs);
+	if (insertionOptions.numThreads == 1 && !insertionOptions.insertDiscretized)
+	{
+		for (size_t i = 0; i < N; i++)
+			m_impl->m_octomap.insertRay(
+				sensorPt, octomap::point3d(xs[i], ys[i], zs[i]),
+				insertionOptions.maxrange, insertionOptions.pruning);
+		return;
+	}
+
+	octomap::Pointcloud scan;
+	scan.reserve(N);
 	for (size_t i = 0; i < N; i++)
-		m_impl->m_octomap.insertRay(
-			sensorPt, octomap::point3d(xs[i], ys[i], zs[i]),
-			insertionOptions.maxrange, insertionOptions.pruning);
+		scan.push_back(xs[i], ys[i], zs[i]);
+	internal_insertScan(sensorPt, scan);
+	MRPT_END
+}
+
+template <class OCTREE, class OCTREE_NODE>
+template <class octomap_point3d, class octomap_pointcloud, class octomap_keyset>
+void COctoMapBase<OCTREE, OCTREE_NODE>::internal_computeScanUpdate(
+	const octomap_point3d& sensorPt, const octomap_pointcloud& scan,
+	octomap_keyset& free_cells, octomap_keyset& occupied_cells) const
+{
+	const auto& tree = m_impl->m_octomap;
+	const double maxrange = insertionOptions.maxrange;
+	const size_t N = scan.size();
+
+	free_cells.clear();
+	occupied_cells.clear();
+
+	size_t nThreads = insertionOptions.numThreads;
+	if (nThreads == 0) nThreads = std::thread::hardware_concurrency();
+	// Less than this number of rays per thread is not worth a thread:
+	constexpr size_t minRaysPerThread = 256;
+	nThreads = std::max<size_t>(
+		1, std::min<size_t>(nThreads, N / minRaysPerThread));
+
+	if (nThreads == 1)
+	{
+		// Same as octomap::insertPointCloud():
+		auto& t = const_cast<OCTREE&>(tree);
+		if (insertionOptions.insertDiscretized)
+			t.computeDiscreteUpdate(
+				scan, sensorPt, free_cells, occupied_cells, maxrange);
+		else
+			t.computeUpdate(
+				scan, sensorPt, free_cells, occupied_cells, maxrange);
+		return;
+	}
+
+	std::vector<octomap_keyset> thFree(nThreads), thOccupied(nThreads);
+
+	auto lambdaTraceRays = [&](size_t th) {
+		auto& freeKeys = thFree[th];
+		auto& occKeys = thOccupied[th];
+		octomap::KeyRay keyRay;
+		octomap::OcTreeKey key;
+		const size_t i0 = N * th / nThreads, i1 = N * (th + 1) / nThreads;
+		for (size_t i = i0; i < i1; i++)
+		{
+			octomap_point3d p = scan[i];
+			if (insertionOptions.insertDiscretized)
+			{
+				// Skip rays ending at an already inserted voxel, and trace
+				// the rest up to the voxel center:
+				if (!tree.coordToKeyChecked(p, key)) continue;
+				if (!occKeys.insert(key).second) continue;
+				p = tree.keyToCoord(key);
+			}
+
+			if (maxrange < 0.0 || (p - sensorPt).norm() <= maxrange)
+			{
+				if (tree.computeRayKeys(sensorPt, p, keyRay))
+					freeKeys.insert(keyRay.begin(), keyRay.end());
+				if (!insertionOptions.insertDiscretized &&
+					tree.coordToKeyChecked(p, key))
+					occKeys.insert(key);
+			}
+			else
+			{
+				// Out of range: only free space up to maxrange.
+				if (insertionOptions.insertDiscretized) occKeys.erase(key);
+				const octomap_point3d newEnd =
+					sensorPt + (p - sensorPt).normalized() * maxrange;
+				if (tree.computeRayKeys(sensorPt, newEnd, keyRay))
+					freeKeys.insert(keyRay.begin(), keyRay.end());
+			}
+		}
+	};
+
+	std::vector<std::thread> threads;
+	for (size_t th = 1; th < nThreads; th++)
+		threads.emplace_back(lambdaTraceRays, th);
+	lambdaTraceRays(0);
+	for (auto& t : threads)
+		t.join();
+
+	// Merge, giving preference to occupied over free voxels:
+	for (size_t th = 0; th < nThreads; th++)
+	{
+		occupied_cells.insert(thOccupied[th].begin(), thOccupied[th].end());
+		thOccupied[th].clear();
+	}
+	for (size_t th = 0; th < nThreads; th++)
+	{
+		for (const auto& k : thFree[th])
+			if (occupied_cells.find(k) == occupied_cells.end())
+				free_cells.insert(k);
+		thFree[th].clear();
+	}
+}
+
+template <class OCTREE, class OCTREE_NODE>
+template <class octomap_point3d, class octomap_pointcloud>
+void COctoMapBase<OCTREE, OCTREE_NODE>::internal_insertScan(
+	const octomap_point3d& sensorPt, const octomap_pointcloud& scan)
+{
+	auto& tree = m_impl->m_octomap;
+	const bool trackChanges = m_impl->voxelsSync.glObj != nullptr;
+	if (insertionOptions.numThreads == 1 && !trackChanges)
+	{
+		tree.insertPointCloud(
+			scan, sensorPt, insertionOptions.maxrange, insertionOptions.pruning,
+			insertionOptions.insertDiscretized);
+		return;
+	}
+
+	octomap::KeySet free_cells, occupied_cells;
+	internal_computeScanUpdate(sensorPt, scan, free_cells, occupied_cells);
+
+	if (trackChanges)
+	{
+		for (const auto& k : free_cells)
+			internal_markModifiedVoxel(k);
+		for (const auto& k : occupied_cells)
+			internal_markModifiedVoxel(k);
+	}
+	if (insertionOptions.numThreads == 1)
+	{
+		// Same as the insertPointCloud() call above:
+		for (const auto& k : free_cells)
+			tree.updateNode(k, false, insertionOptions.pruning);
+		for (const auto& k : occupied_cells)
+			tree.updateNode(k, true, insertionOptions.pruning);
+		return;
+	}
+
+	// Single pass over the tree, updating inner nodes only once at the end:
+	for (const auto& k : free_cells)
+		tree.updateNode(k, false, true /*lazy*/);
+	for (const auto& k : occupied_cells)
+		tree.updateNode(k, true, true /*lazy*/);
+	tree.updateInnerOccupancy();
+	if (insertionOptions.pruning) tree.prune();
+}
+
+template <class OCTREE, class OCTREE_NODE>
+void COctoMapBase<OCTREE, OCTREE_NODE>::mergeLogOddsFrom(const myself_t& other)
+{
+	MRPT_START
+	auto& tree = m_impl->m_octomap;
+	const auto& src = other.m_impl->m_octomap;
+	ASSERTMSG_(
+		std::abs(tree.getResolution() - src.getResolution()) <
+			1e-6 * tree.getResolution(),
+		"Both octomaps must have the same resolution");
+
+	const unsigned int treeDepth = src.getTreeDepth();
+	for (auto it = src.begin_leafs(), end = src.end_leafs(); it != end; ++it)
+	{
+		// A pruned leaf stands for a cube of leaves at the maximum depth:
+		const octomap::OcTreeKey k0 = it.getIndexKey();
+		const unsigned int side = 1U << (treeDepth - it.getDepth());
+		const float logOdds = it->getLogOdds();
+		octomap::OcTreeKey k;
+		for (unsigned int i = 0; i < side; i++)
+			for (unsigned int j = 0; j < side; j++)
+				for (unsigned int l = 0; l < side; l++)
+				{
+					k[0] = static_cast<octomap::key_type>(k0[0] + i);
+					k[1] = static_cast<octomap::key_type>(k0[1] + j);
+					k[2] = static_cast<octomap::key_type>(k0[2] + l);
+					tree.updateNode(k, logOdds, true /*lazy*/);
+					internal_markModifiedVoxel(k);
+					const octomap::point3d c = tree.keyToCoord(k);
+					internal_mergeVoxelData(*it, c.x(), c.y(), c.z());
+				}
+	}
+	tree.updateInnerOccupancy();
+	if (insertionOptions.pruning) tree.prune();
 	MRPT_END
 }
 
+template <class OCTREE, class OCTREE_NODE>
+template <class octomap_key>
+void COctoMapBase<OCTREE, OCTREE_NODE>::internal_markModifiedVoxel(
+	const octomap_key& key)
+{
+	// Only tracked while some COctoMapVoxels is kept updated:
+	auto& sync = m_impl->voxelsSync;
+	if (sync.glObj) sync.modifiedBlocks.insert(Impl::voxelBlockOf(key));
+}
+
+template <class OCTREE, class OCTREE_NODE>
+template <class octomap_point3d>
+void COctoMapBase<OCTREE, OCTREE_NODE>::internal_markModifiedRay(
+	const octomap_point3d& origin, const octomap_point3d& end)
+{
+	if (!m_impl->voxelsSync.glObj) return;
+	const auto& tree = m_impl->m_octomap;
+
+	// (More voxels than the updated ones, if beyond maxrange)
+	octomap::KeyRay keyRay;
+	if (tree.computeRayKeys(origin, end, keyRay))
+		for (const auto& k : keyRay)
+			internal_markModifiedVoxel(k);
+	octomap::OcTreeKey key;
+	if (tree.coordToKeyChecked(end, key)) internal_markModifiedVoxel(key);
+}
+
+template <class OCTREE, class OCTREE_NODE>
+mrpt::img::TColor COctoMapBase<OCTREE, OCTREE_NODE>::internal_getVoxelColor(
+	const OCTREE_NODE& node, double z, double zmin, double inv_dz,
+	const mrpt::opengl::COctoMapVoxels& gl_obj) const
+{
+	using mrpt::img::TColor;
+	using mrpt::opengl::COctoMapVoxels;
+
+	const mrpt::img::TColorf general_color = gl_obj.getColor();
+	const double occ = node.getOccupancy();
+	double coefc, coeft;
+	switch (gl_obj.getVisualizationMode())
+	{
+		case COctoMapVoxels::FIXED: return gl_obj.getColor_u8();
+
+		case COctoMapVoxels::COLOR_FROM_HEIGHT:
+			coefc = 255 * inv_dz * (z - zmin);
+			return TColor(
+				coefc * general_color.R, coefc * general_color.G,
+				coefc * general_color.B, 255.0 * general_color.A);
+
+		case COctoMapVoxels::COLOR_FROM_OCCUPANCY:
+			coefc = 240 * (1 - occ) + 15;
+			return TColor(
+				coefc * general_color.R, coefc * general_color.G,
+				coefc * general_color.B, 255.0 * general_color.A);
+
+		case COctoMapVoxels::TRANSPARENCY_FROM_OCCUPANCY:
+			coeft = 255 - 510 * (1 - occ);
+			if (coeft < 0) { coeft = 0; }
+			return TColor(
+				255 * general_color.R, 255 * general_color.G,
+				255 * general_color.B, coeft);
+
+		case COctoMapVoxels::TRANS_AND_COLOR_FROM_OCCUPANCY:
+			coefc = 240 * (1 - occ) + 15;
+			return TColor(
+				coefc * general_color.R, coefc * general_color.G,
+				coefc * general_color.B, 50);
+
+		case COctoMapVoxels::MIXED:
+			coefc = 255 * inv_dz * (z - zmin);
+			coeft = 255 - 510 * (1 - occ);
+			if (coeft < 0) { coeft = 0; }
+			return TColor(
+				coefc * general_color.R, coefc * general_color.G,
+				coefc * general_color.B, coeft);
+
+		default: THROW_EXCEPTION("Unknown coloring scheme!");
+	}
+}
+
+template <class OCTREE, class OCTREE_NODE>
+void COctoMapBase<OCTREE, OCTREE_NODE>::updateOctoMapVoxels(
+	mrpt::opengl::COctoMapVoxels& gl_obj)
+{
+	using mrpt::opengl::COctoMapVoxels;
+	using mrpt::opengl::VOXEL_SET_FREESPACE;
+	using mrpt::opengl::VOXEL_SET_OCCUPIED;
+	constexpr unsigned int BITS = Impl::VOXEL_BLOCK_BITS;
+
+	auto& tree = m_impl->m_octomap;
+	auto& sync = m_impl->voxelsSync;
+
+	if (renderingOptions.generateGridLines)
+	{
+		sync = typename Impl::VoxelsSync();
+		tree.enableChangeDetection(false);
+		getAsOctoMapVoxels(gl_obj);
+		return;
+	}
+
+	mrpt::math::TPoint3D bbMin, bbMax;
+	tree.getMetricMin(bbMin.x, bbMin.y, bbMin.z);
+	tree.getMetricMax(bbMax.x, bbMax.y, bbMax.z);
+	const double inv_dz = 1 / (bbMax.z - bbMin.z + 0.01);
+
+	const auto mode = gl_obj.getVisualizationMode();
+	const bool colorFromHeight = mode == COctoMapVoxels::COLOR_FROM_HEIGHT ||
+		mode == COctoMapVoxels::MIXED;
+
+	const bool fullUpdate = sync.glObj != &gl_obj ||
+		!tree.isChangeDetectionEnabled() || gl_obj.getVoxelSetCount() != 2 ||
+		sync.mode != mode || !(sync.color == gl_obj.getColor_u8()) ||
+		sync.generateOccupied != renderingOptions.generateOccupiedVoxels ||
+		sync.generateFree != renderingOptions.generateFreeVoxels ||
+		(colorFromHeight && (sync.zmin != bbMin.z || sync.zmax != bbMax.z));
+
+	// New voxels (occupied, free) of each block to regenerate:
+	using block_voxels_t = std::array<std::vector<COctoMapVoxels::TVoxel>, 2>;
+	std::unordered_map<uint64_t, block_voxels_t> blocks;
+	if (fullUpdate)
+	{
+		gl_obj.clear();
+		gl_obj.resizeVoxelSets(2);	// 2 sets of voxels: occupied & free
+	}
+	else
+	{
+		for (const auto b : sync.modifiedBlocks)
+			blocks[b];
+		for (auto it = tree.changedKeysBegin(); it != tree.changedKeysEnd();
+			 ++it)
+			blocks[Impl::voxelBlockOf(it->first)];
+	}
+	sync.modifiedBlocks.clear();
+	tree.enableChangeDetection(true);
+	tree.resetChangeDetection();
+
+	// Only if they changed, to avoid uploading all voxels again:
+	if (gl_obj.areVoxelsVisible(VOXEL_SET_OCCUPIED) !=
+		renderingOptions.visibleOccupiedVoxels)
+		gl_obj.showVoxels(
+			VOXEL_SET_OCCUPIED, renderingOptions.visibleOccupiedVoxels);
+	if (gl_obj.areVoxelsVisible(VOXEL_SET_FREESPACE) !=
+		renderingOptions.visibleFreeVoxels)
+		gl_obj.showVoxels(
+			VOXEL_SET_FREESPACE, renderingOptions.visibleFreeVoxels);
+
+	const unsigned int blockDepth = tree.getTreeDepth() - BITS;
+	const double blockSize = tree.getNodeSize(blockDepth);
+	const double halfLeaf = 0.5 * tree.getResolution();
+
+	// Adds the voxels of a leaf, clipped to the blocks within [b0,b1]:
+	const auto addLeaf = [&](const auto& it, const std::array<uint64_t, 3>& b0,
+							 const std::array<uint64_t, 3>& b1) {
+		const double occ = it->getOccupancy();
+		if (!((occ >= 0.5 && renderingOptions.generateOccupiedVoxels) ||
+			  (occ < 0.5 && renderingOptions.generateFreeVoxels)))
+			return;
+
+		const size_t vx_set = tree.isNodeOccupied(*it) ? VOXEL_SET_OCCUPIED
+													   : VOXEL_SET_FREESPACE;
+		const unsigned int depth = it.getDepth();
+		if (depth >= blockDepth)
+		{
+			const octomap::point3d c = it.getCoordinate();
+			blocks[Impl::voxelBlockOf(it.getKey())][vx_set].emplace_back(
+				mrpt::math::TPoint3Df(c.x(), c.y(), c.z()), it.getSize(),
+				internal_getVoxelColor(*it, c.z(), bbMin.z, inv_dz, gl_obj));
+			return;
+		}
+
+		// A leaf larger than a block: one cube per block, so each block only
+		// depends on its own leaves.
+		const octomap::OcTreeKey ik = it.getIndexKey();
+		const uint64_t nBlocks = uint64_t(1) << (blockDepth - depth);
+		std::array<uint64_t, 3> l0, l1;
+		for (int a = 0; a < 3; a++)
+		{
+			l0[a] = std::max<uint64_t>(ik[a] >> BITS, b0[a]);
+			l1[a] = std::min<uint64_t>((ik[a] >> BITS) + nBlocks - 1, b1[a]);
+		}
+		const auto blockCenter = [&](uint64_t b) {
+			return tree.keyToCoord(octomap::key_type(b << BITS)) - halfLeaf +
+				0.5 * blockSize;
+		};
+		for (uint64_t bx = l0[0]; bx <= l1[0]; bx++)
+			for (uint64_t by = l0[1]; by <= l1[1]; by++)
+				for (uint64_t bz = l0[2]; bz <= l1[2]; bz++)
+				{
+					const mrpt::math::TPoint3Df c(
+						blockCenter(bx), blockCenter(by), blockCenter(bz));
+					blocks[Impl::voxelBlockId(bx, by, bz)][vx_set]
+						.emplace_back(
+							c, blockSize,
+							internal_getVoxelColor(
+								*it, c.z, bbMin.z, inv_dz, gl_obj));
+				}
+	};
+
+	if (fullUpdate)
+	{
+		// All leaves, with large ones clipped to the known space:
+		std::array<uint64_t, 3> b0 = {0, 0, 0}, b1;
+		b1.fill(((uint64_t(1) << tree.getTreeDepth()) - 1) >> BITS);
+		octomap::OcTreeKey kMin, kMax;
+		if (tree.coordToKeyChecked(
+				octomap::point3d(bbMin.x, bbMin.y, bbMin.z), kMin) &&
+			tree.coordToKeyChecked(
+				octomap::point3d(bbMax.x, bbMax.y, bbMax.z), kMax))
+		{
+			for (int a = 0; a < 3; a++)
+			{
+				b0[a] = kMin[a] >> BITS;
+				b1[a] = kMax[a] >> BITS;
+			}
+		}
+		for (auto it = tree.begin_leafs(), end = tree.end_leafs(); it != end;
+			 ++it)
+			addLeaf(it, b0, b1);
+	}
+	else
+	{
+		std::vector<uint64_t> ids;
+		for (const auto& b : blocks)
+			ids.push_back(b.first);
+
+		for (const auto id : ids)
+		{
+			const std::array<uint64_t, 3> b = {
+				id >> 32, (id >> 16) & 0xffff, id & 0xffff};
+			octomap::OcTreeKey kMin, kMax;
+			for (int a = 0; a < 3; a++)
+			{
+				kMin[a] = octomap::key_type(b[a] << BITS);
+				kMax[a] = octomap::key_type(kMin[a] + (1U << BITS) - 1);
+			}
+			for (auto it = tree.begin_leafs_bbx(kMin, kMax),
+					  end = tree.end_leafs_bbx();
+				 it != end; ++it)
+				addLeaf(it, b, b);
+		}
+	}
+
+	for (const auto& b : blocks)
+	{
+		gl_obj.setVoxelGroup(VOXEL_SET_OCCUPIED, b.first, b.second[0]);
+		gl_obj.setVoxelGroup(VOXEL_SET_FREESPACE, b.first, b.second[1]);
+	}
+	gl_obj.setBoundingBox(bbMin, bbMax);
+
+	sync.glObj = &gl_obj;
+	sync.mode = mode;
+	sync.color = gl_obj.getColor_u8();
+	sync.generateOccupied = renderingOptions.generateOccupiedVoxels;
+	sync.generateFree = renderingOptions.generateFreeVoxels;
+	sync.zmin = bbMin.z;
+	sync.zmax = bbMax.z;
+}
+
 template <class OCTREE, class OCTREE_NODE>
 bool COctoMapBase<OCTREE, OCTREE_NODE>::castRay(
 	const mrpt::math::TPoint3D& origin, const mrpt::math::TPoint3D& direction,
@@ -352,6 +833,8 @@ void COctoMapBase<OCTREE, OCTREE_NODE>::TInsertionOptions::dumpToTextStream(
 
 	LOADABLEOPTS_DUMP_VAR(maxrange, double);
 	LOADABLEOPTS_DUMP_VAR(pruning, bool);
+	LOADABLEOPTS_DUMP_VAR(numThreads, int);
+	LOADABLEOPTS_DUMP_VAR(insertDiscretized, bool);
 
 	LOADABLEOPTS_DUMP_VAR(getOccupancyThres(), double);
 	LOADABLEOPTS_DUMP_VAR(getProbHit(), double);
@@ -381,6 +864,8 @@ void COctoMapBase<OCTREE, OCTREE_NODE>::TInsertionOptions::loadFromConfigFile(
 {
 	MRPT_LOAD_CONFIG_VAR(maxrange, double, iniFile, section);
 	MRPT_LOAD_CONFIG_VAR(pruning, bool, iniFile, section);
+	MRPT_LOAD_CONFIG_VAR(numThreads, int, iniFile, section);
+	MRPT_LOAD_CONFIG_VAR(insertDiscretized, bool, iniFile, section);
 
 	MRPT_LOAD_CONFIG_VAR(occupancyThres, double, iniFile, section);
 	MRPT_LOAD_CONFIG_VAR(probHit, double, iniFile, section);
@@ -9,7 +9,9 @@
 
 #include <gtest/gtest.h>
 #include <mrpt/maps/COctoMap.h>
+#include <mrpt/maps/CSimplePointsMap.h>
 #include <mrpt/obs/CObservation2DRangeScan.h>
+#include <mrpt/obs/CObservationPointCloud.h>
 #include <mrpt/obs/stock_observations.h>
 
 using namespace mrpt;
@@ -60,3 +62,44 @@ TEST(COctoMapTests, insert2DScan)
 		map.insertObservation(scan1);
 	}
 }
+
+TEST(COctoMapTests, parallelInsertion)
+{
+	// A dense wall in front of the sensor, with several points per voxel:
+	auto obs = CObservationPointCloud::Create();
+	auto pts = CSimplePointsMap::Create();
+	for (float y = -2.0f; y < 2.0f; y += 0.02f)
+		for (float z = -1.0f; z < 1.0f; z += 0.02f)
+			pts->insertPoint(3.0f, y, z);
+	obs->pointcloud = pts;
+
+	for (const bool discretized : {false, true})
+	{
+		COctoMap serialMap(0.1), parallelMap(0.1);
+		serialMap.insertionOptions.insertDiscretized = discretized;
+		parallelMap.insertionOptions.insertDiscretized = discretized;
+		parallelMap.insertionOptions.numThreads = 4;
+
+		serialMap.insertObservation(*obs);
+		parallelMap.insertObservation(*obs);
+
+		size_t nOccupied = 0;
+		for (float x = -0.45f; x < 3.5f; x += 0.1f)
+			for (float y = -2.45f; y < 2.5f; y += 0.1f)
+				for (float z = -1.45f; z < 1.5f; z += 0.1f)
+				{
+					double pSerial = 0, pParallel = 0;
+					const bool mSerial =
+						serialMap.getPointOccupancy(x, y, z, pSerial);
+					const bool mParallel =
+						parallelMap.getPointOccupancy(x, y, z, pParallel);
+					ASSERT_EQ(mSerial, mParallel)
+						<< "x=" << x << " y=" << y << " z=" << z;
+					if (!mSerial) continue;
+					EXPECT_NEAR(pSerial, pParallel, 1e-4);
+					if (pParallel > 0.5) nOccupied++;
+				}
+		// The wall: 40x20 voxels
+		EXPECT_GT(nOccupied, 700U);
+	}
+}
@@ -10,6 +10,7 @@
 #include "maps-precomp.h"  // Precomp header
 //
 #include <mrpt/maps/CPointCloudFilterBase.h>
+#include <mrpt/maps/CSimplePointsMap.h>
 
 using namespace mrpt::maps;
 
@@ -18,3 +19,18 @@ CPointCloudFilterBase::~CPointCloudFilterBase() = default;
 mrpt::maps::CPointCloudFilterBase::TExtraFilterParams::TExtraFilterParams()
 
 	= default;
+
+void CPointCloudFilterBase::filter(
+	const mrpt::math::TPointCloudView& pointcloud,
+	const mrpt::system::TTimeStamp pc_timestamp,
+	const mrpt::poses::CPose3D& pc_reference_pose,
+	std::vector<bool>& out_deletion_mask)
+{
+	CSimplePointsMap pc;
+	pc.insertPointsView(pointcloud);
+
+	TExtraFilterParams params;
+	params.out_deletion_mask = &out_deletion_mask;
+	params.do_not_delete = true;
+	filter(&pc, pc_timestamp, pc_reference_pose, &params);
+}
@@ -0,0 +1,201 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "maps-precomp.h"  // Precomp header
+//
+#include <mrpt/config/CConfigFileBase.h>
+#include <mrpt/maps/CPointCloudFilterByVoxelGrid.h>
+#include <mrpt/maps/CPointsMap.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace mrpt::maps;
+
+namespace
+{
+constexpr uint64_t INVALID_VOXEL = std::numeric_limits<uint64_t>::max();
+
+/** Packs the 21 lower bits of each voxel coordinate. Two voxels only share a
+ * key if they are 2^21 voxels apart in all axes. */
+inline uint64_t voxelKey(float x, float y, float z, float invVoxelSize)
+{
+	if (!std::isfinite(x) || !std::isfinite(y) || !std::isfinite(z))
+		return INVALID_VOXEL;
+	const auto idx = [invVoxelSize](float v) -> uint64_t {
+		return static_cast<uint32_t>(
+				   static_cast<int32_t>(std::floor(v * invVoxelSize))) &
+			0x1fffff;
+	};
+	return idx(x) | (idx(y) << 21) | (idx(z) << 42);
+}
+
+/** Spreads consecutive voxel keys among partitions */
+inline size_t keyPartition(uint64_t key, size_t nParts)
+{
+	return static_cast<size_t>((key * 0x9E3779B97F4A7C15ULL) >> 40) % nParts;
+}
+
+struct TVoxel
+{
+	size_t best = 0;  //!< Index of the kept point
+	float sx = 0, sy = 0, sz = 0;  //!< Sum of coordinates
+	uint32_t n = 0;
+	float bestSqrDist = std::numeric_limits<float>::max();
+};
+
+}  // namespace
+
+size_t CPointCloudFilterByVoxelGrid::computeDeletionMask(
+	const mrpt::math::TPointCloudView& pc,
+	std::vector<bool>& out_deletion_mask) const
+{
+	MRPT_START
+	ASSERT_GT_(options.voxel_size, 0);
+
+	const size_t N = pc.size();
+	const float invVoxelSize = static_cast<float>(1.0 / options.voxel_size);
+
+	size_t nThreads = options.numThreads;
+	if (nThreads == 0) nThreads = std::thread::hardware_concurrency();
+	// Less than this number of points per thread is not worth a thread:
+	constexpr size_t minPointsPerThread = 16384;
+	nThreads = std::max<size_t>(
+		1, std::min<size_t>(nThreads, N / minPointsPerThread));
+
+	// 1) Voxel key of each point, computed in parallel:
+	std::vector<uint64_t> keys(N);
+	const auto lambdaComputeKeys = [&](size_t th) {
+		const size_t i0 = N * th / nThreads, i1 = N * (th + 1) / nThreads;
+		for (size_t i = i0; i < i1; i++)
+			keys[i] = voxelKey(pc.x[i], pc.y[i], pc.z[i], invVoxelSize);
+	};
+
+	// 2) Each thread handles the voxels in one partition of the key space:
+	// (not std::vector<bool>, since threads write to neighboring elements)
+	std::vector<uint8_t> keep(N, 0);
+	const auto lambdaProcessVoxels = [&](size_t th) {
+		std::unordered_map<uint64_t, TVoxel> voxels;
+		voxels.reserve(N / nThreads);
+		const auto isMine = [&](size_t i) {
+			return keys[i] != INVALID_VOXEL &&
+				(nThreads == 1 || keyPartition(keys[i], nThreads) == th);
+		};
+
+		if (options.method == vgFirstPoint)
+		{
+			for (size_t i = 0; i < N; i++)
+				if (isMine(i) && voxels.try_emplace(keys[i]).second)
+					keep[i] = 1;
+			return;
+		}
+
+		// vgApproxCentroid:
+		for (size_t i = 0; i < N; i++)
+		{
+			if (!isMine(i)) continue;
+			auto& v = voxels[keys[i]];
+			v.sx += pc.x[i];
+			v.sy += pc.y[i];
+			v.sz += pc.z[i];
+			v.n++;
+		}
+		for (size_t i = 0; i < N; i++)
+		{
+			if (!isMine(i)) continue;
+			auto& v = voxels[keys[i]];
+			const float dx = pc.x[i] - v.sx / v.n, dy = pc.y[i] - v.sy / v.n,
+						dz = pc.z[i] - v.sz / v.n;
+			const float d2 = dx * dx + dy * dy + dz * dz;
+			if (d2 < v.bestSqrDist)
+			{
+				v.bestSqrDist = d2;
+				v.best = i;
+			}
+		}
+		for (const auto& kv : voxels)
+			keep[kv.second.best] = 1;
+	};
+
+	const auto runInThreads = [nThreads](const auto& lambda) {
+		std::vector<std::thread> threads;
+		for (size_t th = 1; th < nThreads; th++)
+			threads.emplace_back(lambda, th);
+		lambda(0);
+		for (auto& t : threads)
+			t.join();
+	};
+	runInThreads(lambdaComputeKeys);
+	runInThreads(lambdaProcessVoxels);
+
+	out_deletion_mask.resize(N);
+	size_t nKept = 0;
+	for (size_t i = 0; i < N; i++)
+	{
+		out_deletion_mask[i] = !keep[i];
+		nKept += keep[i];
+	}
+	return nKept;
+
+	MRPT_END
+}
+
+void CPointCloudFilterByVoxelGrid::filter(
+	const mrpt::math::TPointCloudView& pointcloud,
+	[[maybe_unused]] const mrpt::system::TTimeStamp pc_timestamp,
+	[[maybe_unused]] const mrpt::poses::CPose3D& pc_reference_pose,
+	std::vector<bool>& out_deletion_mask)
+{
+	computeDeletionMask(pointcloud, out_deletion_mask);
+}
+
+void CPointCloudFilterByVoxelGrid::filter(
+	mrpt::maps::CPointsMap* pc,
+	[[maybe_unused]] const mrpt::system::TTimeStamp pc_timestamp,
+	[[maybe_unused]] const mrpt::poses::CPose3D& pc_reference_pose,
+	TExtraFilterParams* params)
+{
+	MRPT_START
+	ASSERT_(pc != nullptr);
+
+	std::vector<bool> deletion_mask;
+	const size_t nKept = computeDeletionMask(pc->asView(), deletion_mask);
+
+	if ((params == nullptr || params->do_not_delete == false) &&
+		nKept != pc->size())
+		pc->applyDeletionMask(deletion_mask);
+
+	if (params != nullptr && params->out_deletion_mask != nullptr)
+		*params->out_deletion_mask = std::move(deletion_mask);
+
+	MRPT_END
+}
+
+void CPointCloudFilterByVoxelGrid::TOptions::loadFromConfigFile(
+	const mrpt::config::CConfigFileBase& c, const std::string& s)
+{
+	MRPT_LOAD_CONFIG_VAR(voxel_size, double, c, s);
+	MRPT_LOAD_CONFIG_VAR(method, enum, c, s);
+	MRPT_LOAD_CONFIG_VAR(numThreads, int, c, s);
+}
+
+void CPointCloudFilterByVoxelGrid::TOptions::saveToConfigFile(
+	mrpt::config::CConfigFileBase& c, const std::string& s) const
+{
+	MRPT_SAVE_CONFIG_VAR_COMMENT(voxel_size, "Voxel side length [m]");
+	MRPT_SAVE_CONFIG_VAR_COMMENT(
+		method,
+		"Point kept in each voxel: `vgFirstPoint` or `vgApproxCentroid`");
+	MRPT_SAVE_CONFIG_VAR_COMMENT(
+		numThreads, "Number of threads (0: all hardware threads)");
+}
@@ -0,0 +1,127 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/maps/CPointCloudFilterByVoxelGrid.h>
+#include <mrpt/maps/CSimplePointsMap.h>
+#include <mrpt/obs/CObservationPointCloud.h>
+#include <mrpt/random/RandomGenerators.h>
+
+#include <cmath>
+#include <set>
+#include <tuple>
+
+using mrpt::maps::CPointCloudFilterByVoxelGrid;
+
+TEST(CPointCloudFilterByVoxelGrid, onePointPerVoxel)
+{
+	// 3 voxels of 1m, with 4, 1 and 2 points:
+	const float pts[7][3] = {{0.1f, 0.1f, 0.1f}, {0.9f, 0.9f, 0.9f},
+							 {0.5f, 0.5f, 0.5f}, {0.4f, 0.6f, 0.5f},
+							 {-0.5f, 0.5f, 0.5f}, {2.2f, 0.1f, 0.1f},
+							 {2.3f, 0.2f, 0.1f}};
+	for (const auto method : {CPointCloudFilterByVoxelGrid::vgFirstPoint,
+							  CPointCloudFilterByVoxelGrid::vgApproxCentroid})
+	{
+		mrpt::maps::CSimplePointsMap map;
+		for (const auto& p : pts)
+			map.insertPoint(p[0], p[1], p[2]);
+
+		CPointCloudFilterByVoxelGrid vg;
+		vg.options.voxel_size = 1.0;
+		vg.options.method = method;
+
+		std::vector<bool> mask;
+		CPointCloudFilterByVoxelGrid::TExtraFilterParams params;
+		params.out_deletion_mask = &mask;
+		vg.filter(&map, mrpt::system::now(), mrpt::poses::CPose3D(), &params);
+
+		ASSERT_EQ(map.size(), 3U);
+		ASSERT_EQ(mask.size(), 7U);
+		if (method == CPointCloudFilterByVoxelGrid::vgFirstPoint)
+		{
+			const std::vector<bool> expected = {false, true, true, true,
+												false, false, true};
+			EXPECT_EQ(mask, expected);
+		}
+		else
+		{
+			// Closest to the centroid (0.475,0.525,0.5) is the 3rd point:
+			const std::vector<bool> expected = {true,  true,  false, true,
+												false, false, true};
+			EXPECT_EQ(mask, expected);
+		}
+	}
+}
+
+TEST(CPointCloudFilterByVoxelGrid, multiThreadedSameResult)
+{
+	auto& rnd = mrpt::random::getRandomGenerator();
+	rnd.randomize(123);
+
+	const size_t N = 200000;
+	std::vector<float> xs(N), ys(N), zs(N);
+	for (size_t i = 0; i < N; i++)
+	{
+		xs[i] = rnd.drawUniform(-20.0f, 20.0f);
+		ys[i] = rnd.drawUniform(-20.0f, 20.0f);
+		zs[i] = rnd.drawUniform(-2.0f, 2.0f);
+	}
+	xs[10] = std::nanf("");
+	const auto view = mrpt::math::TPointCloudView::FromVectors(xs, ys, zs);
+
+	for (const auto method : {CPointCloudFilterByVoxelGrid::vgFirstPoint,
+							  CPointCloudFilterByVoxelGrid::vgApproxCentroid})
+	{
+		CPointCloudFilterByVoxelGrid vg;
+		vg.options.voxel_size = 0.5;
+		vg.options.method = method;
+
+		std::vector<bool> mask1, mask4;
+		vg.options.numThreads = 1;
+		const size_t nKept = vg.computeDeletionMask(view, mask1);
+		vg.options.numThreads = 4;
+		vg.filter(view, mrpt::system::now(), mrpt::poses::CPose3D(), mask4);
+		EXPECT_EQ(mask1, mask4);
+		EXPECT_TRUE(mask1[10]);	 // NaN
+
+		// Exactly one point per occupied voxel:
+		std::set<std::tuple<int, int, int>> voxels;
+		size_t n = 0;
+		for (size_t i = 0; i < N; i++)
+		{
+			if (i == 10) continue;
+			const auto v = std::make_tuple(
+				static_cast<int>(std::floor(xs[i] / 0.5f)),
+				static_cast<int>(std::floor(ys[i] / 0.5f)),
+				static_cast<int>(std::floor(zs[i] / 0.5f)));
+			voxels.insert(v);
+			if (!mask1[i]) n++;
+		}
+		EXPECT_EQ(n, nKept);
+		EXPECT_EQ(nKept, voxels.size());
+	}
+}
+
+TEST(CPointCloudFilterByVoxelGrid, insertionOptions)
+{
+	mrpt::maps::CSimplePointsMap map;
+	map.insertPoint(0.05f, 0.05f, 0);
+	map.insertPoint(0.05f, 0.05f, 0);  // old points are never filtered
+
+	mrpt::maps::CSimplePointsMap other;
+	for (int i = 0; i < 100; i++)
+		other.insertPoint(0.01f * i, 0, 0);
+
+	map.insertionOptions.voxelFilterSize = 0.10f;
+	mrpt::obs::CObservationPointCloud obs;
+	obs.pointcloud = mrpt::maps::CSimplePointsMap::Create(other);
+	map.insertObservation(obs);
+	EXPECT_EQ(map.size(), 2U + 10U);
+}
@@ -0,0 +1,331 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "maps-precomp.h"  // Precomp header
+//
+#include <mrpt/io/CFileInputStream.h>
+#include <mrpt/io/CFileOutputStream.h>
+#include <mrpt/maps/CColouredPointsMap.h>
+#include <mrpt/maps/CPointCloudMappedFile.h>
+#include <mrpt/maps/CPointsMapXYZI.h>
+#include <mrpt/system/filesystem.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#elif !MRPT_IN_EMSCRIPTEN
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#define POINTCLOUDFILE_HAS_MMAP
+#endif
+
+using namespace mrpt::maps;
+
+namespace
+{
+// Arrays in the file, in this order:
+enum TField : uint32_t
+{
+	fX = 0,
+	fY,
+	fZ,
+	fIntensity,
+	fR,
+	fG,
+	fB,
+	NUM_FIELDS
+};
+
+constexpr char FILE_MAGIC[8] = {'M', 'R', 'P', 'T', 'P', 'C', 'F', '\0'};
+constexpr uint32_t FILE_VERSION = 1;
+constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+/** The first bytes of the file. Absent fields have a zero offset. */
+struct FileHeader
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t byteOrder;
+	uint64_t numPoints;
+	uint64_t offsets[NUM_FIELDS];
+};
+
+uint64_t alignUp(uint64_t n)
+{
+	constexpr uint64_t A = CPointCloudMappedFile::COLUMN_ALIGNMENT;
+	return (n + A - 1) / A * A;
+}
+}  // namespace
+
+struct CPointCloudMappedFile::Impl
+{
+	const uint8_t* data = nullptr;
+	uint64_t dataSize = 0;
+	size_t numPoints = 0;
+	std::array<const float*, NUM_FIELDS> fields{};
+
+#if defined(_WIN32)
+	HANDLE hFile = INVALID_HANDLE_VALUE, hMap = nullptr;
+#elif defined(POINTCLOUDFILE_HAS_MMAP)
+	int fd = -1;
+#endif
+	// Fallback if memory mapping is not available:
+	std::vector<uint8_t> buffer;
+
+	void map(const std::string& fileName)
+	{
+		dataSize = mrpt::system::getFileSize(fileName);
+		ASSERTMSG_(
+			dataSize != static_cast<uint64_t>(-1),
+			"Cannot open point cloud file: " + fileName);
+		if (dataSize == 0) return;	// Validated in open()
+#if defined(_WIN32)
+		hFile = CreateFileA(
+			fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+			OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		ASSERTMSG_(
+			hFile != INVALID_HANDLE_VALUE,
+			"Cannot open point cloud file: " + fileName);
+		hMap = CreateFileMappingA(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		ASSERTMSG_(hMap, "Cannot map point cloud file: " + fileName);
+		data = static_cast<const uint8_t*>(
+			MapViewOfFile(hMap, FILE_MAP_READ, 0, 0, 0));
+#elif defined(POINTCLOUDFILE_HAS_MMAP)
+		fd = ::open(fileName.c_str(), O_RDONLY);
+		ASSERTMSG_(fd >= 0, "Cannot open point cloud file: " + fileName);
+		void* p = ::mmap(
+			nullptr, static_cast<size_t>(dataSize), PROT_READ, MAP_SHARED, fd,
+			0);
+		if (p != MAP_FAILED) data = static_cast<const uint8_t*>(p);
+#else
+		mrpt::io::CFileInputStream f;
+		ASSERTMSG_(
+			f.open(fileName), "Cannot open point cloud file: " + fileName);
+		buffer.resize(static_cast<size_t>(dataSize));
+		ASSERT_EQUAL_(f.Read(buffer.data(), buffer.size()), buffer.size());
+		data = buffer.data();
+#endif
+		ASSERTMSG_(data, "Cannot map point cloud file: " + fileName);
+	}
+
+	void unmap()
+	{
+#if defined(_WIN32)
+		if (data) UnmapViewOfFile(data);
+		if (hMap) CloseHandle(hMap);
+		if (hFile != INVALID_HANDLE_VALUE) CloseHandle(hFile);
+		hMap = nullptr;
+		hFile = INVALID_HANDLE_VALUE;
+#elif defined(POINTCLOUDFILE_HAS_MMAP)
+		if (data) ::munmap(const_cast<uint8_t*>(data), dataSize);
+		if (fd >= 0) ::close(fd);
+		fd = -1;
+#endif
+		buffer = std::vector<uint8_t>();
+		data = nullptr;
+		dataSize = 0;
+		numPoints = 0;
+		fields.fill(nullptr);
+	}
+};
+
+CPointCloudMappedFile::CPointCloudMappedFile()
+	: m_impl(std::make_unique<Impl>())
+{
+}
+
+CPointCloudMappedFile::CPointCloudMappedFile(const std::string& fileName)
+	: CPointCloudMappedFile()
+{
+	open(fileName);
+}
+
+CPointCloudMappedFile::~CPointCloudMappedFile() { close(); }
+
+void CPointCloudMappedFile::open(const std::string& fileName)
+{
+	close();
+	auto& m = *m_impl;
+	try
+	{
+		m.map(fileName);
+
+		FileHeader h;
+		ASSERTMSG_(
+			m.dataSize >= sizeof(h), "Point cloud file too short: " + fileName);
+		std::memcpy(&h, m.data, sizeof(h));
+		ASSERTMSG_(
+			std::memcmp(h.magic, FILE_MAGIC, sizeof(FILE_MAGIC)) == 0,
+			"Not a point cloud file: " + fileName);
+		ASSERTMSG_(
+			h.version == FILE_VERSION,
+			mrpt::format(
+				"Unsupported point cloud file version: %u",
+				static_cast<unsigned int>(h.version)));
+		ASSERTMSG_(
+			h.byteOrder == BYTE_ORDER_MARK,
+			"Point cloud file written with a different byte order: " +
+				fileName);
+		ASSERT_(h.offsets[fX] && h.offsets[fY] && h.offsets[fZ]);
+
+		const uint64_t arrayBytes = h.numPoints * sizeof(float);
+		for (size_t k = 0; k < NUM_FIELDS; k++)
+		{
+			const uint64_t o = h.offsets[k];
+			if (!o) continue;
+			ASSERTMSG_(
+				o % COLUMN_ALIGNMENT == 0 && o + arrayBytes <= m.dataSize,
+				"Corrupted point cloud file: " + fileName);
+			m.fields[k] = reinterpret_cast<const float*>(m.data + o);
+		}
+		ASSERTMSG_(
+			(m.fields[fR] && m.fields[fG] && m.fields[fB]) ||
+				(!m.fields[fR] && !m.fields[fG] && !m.fields[fB]),
+			"Corrupted point cloud file: " + fileName);
+		m.numPoints = static_cast<size_t>(h.numPoints);
+	}
+	catch (...)
+	{
+		m.unmap();
+		throw;
+	}
+}
+
+bool CPointCloudMappedFile::isOpen() const
+{
+	return m_impl->fields[fX] != nullptr;
+}
+
+void CPointCloudMappedFile::close() { m_impl->unmap(); }
+
+size_t CPointCloudMappedFile::size() const { return m_impl->numPoints; }
+
+const float* CPointCloudMappedFile::x() const { return m_impl->fields[fX]; }
+const float* CPointCloudMappedFile::y() const { return m_impl->fields[fY]; }
+const float* CPointCloudMappedFile::z() const { return m_impl->fields[fZ]; }
+const float* CPointCloudMappedFile::intensity() const
+{
+	return m_impl->fields[fIntensity];
+}
+const float* CPointCloudMappedFile::R() const { return m_impl->fields[fR]; }
+const float* CPointCloudMappedFile::G() const { return m_impl->fields[fG]; }
+const float* CPointCloudMappedFile::B() const { return m_impl->fields[fB]; }
+
+void CPointCloudMappedFile::loadInto(CPointsMap& m) const
+{
+	ASSERTMSG_(isOpen(), "open() must be called first");
+	const size_t N = size();
+	const float *xs = x(), *ys = y(), *zs = z();
+
+	m.clear();
+	m.resize(N);
+	for (size_t i = 0; i < N; i++)
+		m.setPointFast(i, xs[i], ys[i], zs[i]);
+
+	if (auto* mi = dynamic_cast<CPointsMapXYZI*>(&m); mi && hasIntensity())
+	{
+		const float* I = intensity();
+		for (size_t i = 0; i < N; i++)
+			mi->setPointIntensity(i, I[i]);
+	}
+	if (auto* mc = dynamic_cast<CColouredPointsMap*>(&m); mc && hasColor())
+	{
+		const float *Rs = R(), *Gs = G(), *Bs = B();
+		for (size_t i = 0; i < N; i++)
+			mc->setPointColor_fast(i, Rs[i], Gs[i], Bs[i]);
+	}
+	m.mark_as_modified();
+}
+
+void CPointCloudMappedFile::Save(
+	const CPointsMap& m, const std::string& fileName)
+{
+	const size_t N = m.size();
+	const auto* mi = dynamic_cast<const CPointsMapXYZI*>(&m);
+	const auto* mc = dynamic_cast<const CColouredPointsMap*>(&m);
+
+	FileHeader h;
+	std::memset(&h, 0, sizeof(h));
+	std::memcpy(h.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+	h.version = FILE_VERSION;
+	h.byteOrder = BYTE_ORDER_MARK;
+	h.numPoints = N;
+
+	const uint64_t arrayBytes = alignUp(N * sizeof(float));
+	uint64_t offset = alignUp(sizeof(h));
+	for (size_t k = 0; k < NUM_FIELDS; k++)
+	{
+		const bool present = k <= fZ || (k == fIntensity && mi) ||
+			(k >= fR && k <= fB && mc);
+		if (!present) continue;
+		h.offsets[k] = offset;
+		offset += arrayBytes;
+	}
+
+	mrpt::io::CFileOutputStream f;
+	if (!f.open(fileName))
+		THROW_EXCEPTION_FMT(
+			"Error creating point cloud file '%s'", fileName.c_str());
+
+	const std::vector<uint8_t> zeros(COLUMN_ALIGNMENT, 0);
+	uint64_t written = 0;
+	auto lmbWrite = [&](const void* p, size_t n) {
+		if (n == 0) return;
+		if (f.Write(p, n) != n)
+			THROW_EXCEPTION_FMT(
+				"Error writing point cloud file '%s'", fileName.c_str());
+		written += n;
+	};
+	auto lmbPad = [&]() {
+		lmbWrite(zeros.data(), static_cast<size_t>(alignUp(written) - written));
+	};
+
+	// Writes one array, from a function returning the value of each point:
+	std::vector<float> block;
+	auto lmbWriteField = [&](auto&& valueOf) {
+		constexpr size_t BLOCK = COLUMN_ALIGNMENT * 16;
+		for (size_t i0 = 0; i0 < N; i0 += BLOCK)
+		{
+			const size_t n = std::min(BLOCK, N - i0);
+			block.resize(n);
+			for (size_t i = 0; i < n; i++)
+				block[i] = valueOf(i0 + i);
+			lmbWrite(block.data(), n * sizeof(float));
+		}
+		lmbPad();
+	};
+
+	lmbWrite(&h, sizeof(h));
+	lmbPad();
+	// Coordinates are already contiguous:
+	for (const auto* v :
+		 {&m.getPointsBufferRef_x(), &m.getPointsBufferRef_y(),
+		  &m.getPointsBufferRef_z()})
+	{
+		lmbWrite(v->data(), N * sizeof(float));
+		lmbPad();
+	}
+	if (mi)
+		lmbWriteField([mi](size_t i) { return mi->getPointIntensity_fast(i); });
+	if (mc)
+	{
+		for (int ch = 0; ch < 3; ch++)
+			lmbWriteField([mc, ch](size_t i) {
+				float rgb[3];
+				mc->getPointColor_fast(i, rgb[0], rgb[1], rgb[2]);
+				return rgb[ch];
+			});
+	}
+	ASSERT_EQUAL_(written, offset);
+}
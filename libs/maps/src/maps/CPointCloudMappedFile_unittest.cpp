@@ -0,0 +1,109 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/maps/CColouredPointsMap.h>
+#include <mrpt/maps/CPointCloudMappedFile.h>
+#include <mrpt/maps/CPointsMapXYZI.h>
+#include <mrpt/maps/CSimplePointsMap.h>
+#include <mrpt/system/filesystem.h>
+
+#include <cstdint>
+
+using mrpt::maps::CPointCloudMappedFile;
+
+TEST(CPointCloudMappedFile, saveAndMapXYZI)
+{
+	mrpt::maps::CPointsMapXYZI m;
+	for (int i = 0; i < 5000; i++)
+		m.insertPointRGB(
+			i * 0.1f, -i * 0.2f, 1.0f + i % 7, (i % 10) * 0.1f, 0, 0);
+
+	const auto fil = mrpt::system::getTempFileName();
+	CPointCloudMappedFile::Save(m, fil);
+	{
+		CPointCloudMappedFile f(fil);
+		ASSERT_EQUAL_(f.size(), m.size());
+		EXPECT_TRUE(f.hasIntensity());
+		EXPECT_FALSE(f.hasColor());
+		EXPECT_EQ(
+			reinterpret_cast<uintptr_t>(f.x()) %
+				CPointCloudMappedFile::COLUMN_ALIGNMENT,
+			0U);
+		for (size_t i = 0; i < m.size(); i++)
+		{
+			EXPECT_EQ(f.x()[i], m.getPointsBufferRef_x()[i]);
+			EXPECT_EQ(f.y()[i], m.getPointsBufferRef_y()[i]);
+			EXPECT_EQ(f.z()[i], m.getPointsBufferRef_z()[i]);
+			EXPECT_EQ(f.intensity()[i], m.getPointIntensity_fast(i));
+		}
+
+		mrpt::maps::CPointsMapXYZI m2;
+		f.loadInto(m2);
+		ASSERT_EQUAL_(m2.size(), m.size());
+		for (size_t i = 0; i < m.size(); i += 97)
+			EXPECT_EQ(
+				m2.getPointIntensity_fast(i), m.getPointIntensity_fast(i));
+
+		// Loading into a map without intensity just drops it:
+		mrpt::maps::CSimplePointsMap m3;
+		f.loadInto(m3);
+		EXPECT_EQ(m3.size(), m.size());
+	}
+	mrpt::system::deleteFile(fil);
+}
+
+TEST(CPointCloudMappedFile, saveAndMapColoured)
+{
+	mrpt::maps::CColouredPointsMap m;
+	for (int i = 0; i < 1000; i++)
+		m.insertPointRGB(i * 0.1f, 0, -1, 0.1f, 0.5f, (i % 4) * 0.25f);
+
+	const auto fil = mrpt::system::getTempFileName();
+	CPointCloudMappedFile::Save(m, fil);
+	{
+		CPointCloudMappedFile f(fil);
+		ASSERT_EQUAL_(f.size(), m.size());
+		EXPECT_FALSE(f.hasIntensity());
+		ASSERT_TRUE(f.hasColor());
+
+		mrpt::maps::CColouredPointsMap m2;
+		f.loadInto(m2);
+		for (size_t i = 0; i < m.size(); i++)
+		{
+			float R1, G1, B1, R2, G2, B2;
+			m.getPointColor_fast(i, R1, G1, B1);
+			m2.getPointColor_fast(i, R2, G2, B2);
+			EXPECT_EQ(R1, R2);
+			EXPECT_EQ(G1, G2);
+			EXPECT_EQ(B1, B2);
+		}
+	}
+	mrpt::system::deleteFile(fil);
+}
+
+TEST(CPointCloudMappedFile, emptyAndInvalidFiles)
+{
+	const auto fil = mrpt::system::getTempFileName();
+	CPointCloudMappedFile::Save(mrpt::maps::CSimplePointsMap(), fil);
+	{
+		CPointCloudMappedFile f(fil);
+		EXPECT_TRUE(f.isOpen());
+		EXPECT_TRUE(f.empty());
+	}
+
+	mrpt::maps::CSimplePointsMap m;
+	m.insertPoint(1, 2, 3);
+	m.save3D_to_text_file(fil);
+	CPointCloudMappedFile f;
+	EXPECT_ANY_THROW(f.open(fil));
+	EXPECT_FALSE(f.isOpen());
+
+	mrpt::system::deleteFile(fil);
+}
@@ -10,8 +10,11 @@
 #include "maps-precomp.h"  // Precomp header
 //
 #include <mrpt/config/CConfigFile.h>
+#include <mrpt/containers/grid_layouts.h>
 #include <mrpt/core/SSE_macros.h>
 #include <mrpt/core/SSE_types.h>
+#include <mrpt/core/WorkerThreadsPool.h>
+#include <mrpt/io/CMemoryMappedFile.h>
 #include <mrpt/maps/CPointsMap.h>
 #include <mrpt/maps/CSimplePointsMap.h>
 #include <mrpt/math/TPose2D.h>
@@ -27,9 +30,15 @@
 #include <mrpt/system/CTicTac.h>
 #include <mrpt/system/CTimeLogger.h>
 #include <mrpt/system/os.h>
+#include <mrpt/system/text_parsing.h>
 
+#include <Eigen/Dense>
+#include <algorithm>
 #include <fstream>
+#include <iterator>
+#include <numeric>
 #include <sstream>
+#include <thread>
 
 #if MRPT_HAS_MATLAB
 #include <mexplus.h>
@@ -104,8 +113,76 @@ bool CPointsMap::save3D_to_text_stream(std::ostream& out) const
 	return true;
 }
 
-bool CPointsMap::load2Dor3D_from_text_stream(
-	std::istream& in, mrpt::optional_ref<std::string> outErrorMsg,
+namespace
+{
+/** Parses "X Y [Z]" lines, in parallel chunks for large texts. Returns the
+ * coordinates (3 per point) up to the first line with a format error, if any,
+ * whose error message is then stored into `errorMsg`. */
+std::vector<float> parseTextPoints(
+	std::string_view text, const bool is_3D, std::string& errorMsg)
+{
+	const size_t nCoords = is_3D ? 3 : 2;
+	const auto chunks = mrpt::system::split_text_into_chunks(
+		text, std::max(1U, std::thread::hardware_concurrency()));
+
+	struct TChunkResult
+	{
+		std::vector<float> xyz;
+		size_t errorLine = 0, errorCoord = 0;
+	};
+	std::vector<TChunkResult> results(chunks.size());
+	auto lmbParseChunk = [&](size_t i) {
+		auto& r = results[i];
+		r.xyz.reserve(chunks[i].text.size() / 8);
+		size_t linIdx = chunks[i].firstLine;
+		mrpt::system::for_each_line(chunks[i].text, [&](std::string_view lin) {
+			float coords[3] = {0, 0, 0};
+			const size_t n = mrpt::system::parse_numbers(lin, coords, nCoords);
+			if (n != nCoords)
+			{
+				r.errorLine = linIdx;
+				r.errorCoord = n + 1;
+				return false;
+			}
+			r.xyz.insert(r.xyz.end(), coords, coords + 3);
+			linIdx++;
+			return true;
+		});
+	};
+	if (chunks.size() > 1)
+	{
+		mrpt::WorkerThreadsPool pool(
+			chunks.size() - 1, mrpt::WorkerThreadsPool::POLICY_FIFO,
+			"loadPoints");
+		pool.parallel_for(0, chunks.size(), 1, lmbParseChunk);
+	}
+	else if (!chunks.empty())
+		lmbParseChunk(0);
+
+	// Join all chunks, up to the first error:
+	size_t total = 0;
+	for (const auto& r : results)
+		total += r.xyz.size();
+	std::vector<float> xyz;
+	xyz.reserve(total);
+	for (const auto& r : results)
+	{
+		xyz.insert(xyz.end(), r.xyz.begin(), r.xyz.end());
+		if (r.errorLine)
+		{
+			errorMsg = mrpt::format(
+				"[CPointsMap::load2Dor3D_from_text_stream] Unexpected format "
+				"on line %zu for coordinate #%zu\n",
+				r.errorLine, r.errorCoord);
+			break;
+		}
+	}
+	return xyz;
+}
+}  // namespace
+
+bool CPointsMap::load2Dor3D_from_text(
+	std::string_view text, mrpt::optional_ref<std::string> outErrorMsg,
 	const bool is_3D)
 {
 	MRPT_START
@@ -114,34 +191,32 @@ bool CPointsMap::load2Dor3D_from_text_stream(
 	mark_as_modified();
 	this->clear();
 
-	size_t linIdx = 1;
-	for (std::string line; std::getline(in, line); ++linIdx)
-	{
-		float coords[3] = {0, 0, 0};
-		std::stringstream ss(line);
-		for (int idxCoord = 0; idxCoord < (is_3D ? 3 : 2); idxCoord++)
-		{
-			if (!(ss >> coords[idxCoord]))
-			{
-				std::stringstream sErr;
-				sErr << "[CPointsMap::load2Dor3D_from_text_stream] Unexpected "
-						"format on line "
-					 << linIdx << " for coordinate #" << (idxCoord + 1) << "\n";
-
-				if (outErrorMsg) outErrorMsg.value().get() = sErr.str();
-				else
-					std::cerr << sErr.str();
+	std::string errorMsg;
+	const std::vector<float> xyz = parseTextPoints(text, is_3D, errorMsg);
+	this->reserve(xyz.size() / 3);
+	for (size_t i = 0; i < xyz.size(); i += 3)
+		this->insertPointFast(xyz[i], xyz[i + 1], xyz[i + 2]);
+	mark_as_modified();
 
-				return false;
-			}
-		}
+	if (errorMsg.empty()) return true;
+	if (outErrorMsg) outErrorMsg.value().get() = errorMsg;
+	else
+		std::cerr << errorMsg;
+	return false;
 
-		this->insertPoint(coords[0], coords[1], coords[2]);
-	}
-	return true;
 	MRPT_END
 }
 
+bool CPointsMap::load2Dor3D_from_text_stream(
+	std::istream& in, mrpt::optional_ref<std::string> outErrorMsg,
+	const bool is_3D)
+{
+	// Parsing the whole text at once is much faster than line by line:
+	const std::string text{
+		std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+	return load2Dor3D_from_text(text, outErrorMsg, is_3D);
+}
+
 bool CPointsMap::load2Dor3D_from_text_file(
 	const std::string& file, const bool is_3D)
 {
@@ -151,10 +226,16 @@ bool CPointsMap::load2Dor3D_from_text_file(
 	mark_as_modified();
 	this->clear();
 
-	std::ifstream fi(file);
-	if (!fi.is_open()) return false;
-
-	return load2Dor3D_from_text_stream(fi, std::nullopt, is_3D);
+	mrpt::io::CMemoryMappedFile f;
+	try
+	{
+		f.open(file);
+	}
+	catch (const std::exception&)
+	{
+		return false;
+	}
+	return load2Dor3D_from_text(f.text(), std::nullopt, is_3D);
 
 	MRPT_END
 }
@@ -277,6 +358,137 @@ void CPointsMap::clipOutOfRange(const TPoint2D& p, float maxRange)
 	mark_as_modified();
 }
 
+namespace
+{
+/** Buffers of determineMatching2D() and determineMatching3D(), kept by each
+ * calling thread between calls (e.g. ICP iterations) to avoid reallocating
+ * them. */
+struct TMatchingBuffers
+{
+	/** The "other" map points, transformed */
+	mrpt::aligned_std_vector<float> xs, ys, zs;
+	/** For each query point: its closest point, or NO_MATCH, and the squared
+	 * distance to it */
+	std::vector<uint32_t> matchIdx;
+	std::vector<float> matchDistSqr;
+	/** Pairings before the onlyUniqueRobust filter */
+	TMatchingPairList corrs;
+
+	static constexpr uint32_t NO_MATCH = std::numeric_limits<uint32_t>::max();
+};
+
+TMatchingBuffers& matchingBuffers()
+{
+	thread_local TMatchingBuffers b;
+	return b;
+}
+
+/** Runs f(q0,q1) for the range [first,last) split into contiguous ranges, one
+ * per thread (0: as many as hardware threads). */
+template <typename F>
+void runMatchingQueries(
+	size_t first, size_t last, size_t numThreads, const F& lmbQueries)
+{
+	const size_t N = last > first ? last - first : 0;
+	size_t nThreads = numThreads;
+	if (nThreads == 0) nThreads = std::thread::hardware_concurrency();
+	// Less than this number of KD-tree queries is not worth a thread:
+	constexpr size_t minQueriesPerThread = 1024;
+	nThreads = std::max<size_t>(1, std::min(nThreads, N / minQueriesPerThread));
+
+	std::vector<std::thread> threads;
+	for (size_t th = 1; th < nThreads; th++)
+		threads.emplace_back([&, th]() {
+			lmbQueries(
+				first + N * th / nThreads, first + N * (th + 1) / nThreads);
+		});
+	lmbQueries(first, first + N / nThreads);
+	for (auto& t : threads)
+		t.join();
+}
+
+/** The order in which to run a batch of KD-tree queries: along the Morton
+ * (Z-order) curve of the query points in their bounding box, so consecutive
+ * queries are close in space. `zs` is nullptr for 2D queries. */
+std::vector<uint32_t> mortonOrder(
+	const float* xs, const float* ys, const float* zs, size_t N)
+{
+	using mrpt::containers::internal::morton_part1by1;
+	using mrpt::containers::internal::morton_part1by2;
+
+	ASSERT_LT_(N, std::numeric_limits<uint32_t>::max());
+	const bool is3D = zs != nullptr;
+	const size_t nDims = is3D ? 3 : 2;
+	const float* coords[3] = {xs, ys, zs};
+
+	// Cells per axis: 10 bits in 3D, 16 bits in 2D.
+	const float maxCell = is3D ? 1023.0f : 65535.0f;
+	float mins[3] = {0, 0, 0}, scales[3] = {0, 0, 0};
+	for (size_t d = 0; d < nDims; d++)
+	{
+		float lo = std::numeric_limits<float>::max(), hi = -lo;
+		for (size_t i = 0; i < N; i++)
+		{
+			const float v = coords[d][i];
+			if (v < lo) lo = v;
+			if (v > hi) hi = v;
+		}
+		mins[d] = lo;
+		if (hi > lo && std::isfinite(hi - lo)) scales[d] = maxCell / (hi - lo);
+	}
+	// (NaN or infinite coordinates go to cell 0)
+	const auto cell = [&](size_t d, size_t i) -> uint32_t {
+		const float c = (coords[d][i] - mins[d]) * scales[d];
+		return c >= 0 && c <= maxCell ? static_cast<uint32_t>(c) : 0;
+	};
+
+	// Sort (code, index) pairs as 64-bit keys:
+	std::vector<uint64_t> keys(N);
+	for (size_t i = 0; i < N; i++)
+	{
+		const uint32_t code = is3D
+			? morton_part1by2(cell(0, i)) | (morton_part1by2(cell(1, i)) << 1) |
+				(morton_part1by2(cell(2, i)) << 2)
+			: morton_part1by1(cell(0, i)) | (morton_part1by1(cell(1, i)) << 1);
+		keys[i] = (static_cast<uint64_t>(code) << 32) | i;
+	}
+	std::sort(keys.begin(), keys.end());
+
+	std::vector<uint32_t> order(N);
+	for (size_t i = 0; i < N; i++)
+		order[i] = static_cast<uint32_t>(keys[i]);
+	return order;
+}
+
+/** Runs lmbQuery(i) for the N query points (xs[i],ys[i],zs[i]), with zs
+ * nullptr for 2D queries, in parallel and in the order given by `params`. */
+template <typename F>
+void runBatchQueries(
+	const float* xs, const float* ys, const float* zs, size_t N,
+	const TBatchQueryParams& params, const F& lmbQuery)
+{
+	if (!N) return;
+
+	// (Not worth sorting a few queries)
+	constexpr size_t minQueriesToSort = 256;
+	std::vector<uint32_t> order;
+	if (params.mortonOrder && N >= minQueriesToSort)
+		order = mortonOrder(xs, ys, zs, N);
+
+	const auto lmbQueries = [&](size_t k0, size_t k1) {
+		if (order.empty())
+			for (size_t k = k0; k < k1; k++)
+				lmbQuery(k);
+		else
+			for (size_t k = k0; k < k1; k++)
+				lmbQuery(order[k]);
+	};
+	// The first query builds the KD-tree, if needed, before any thread:
+	lmbQueries(0, 1);
+	runMatchingQueries(1, N, params.numThreads, lmbQueries);
+}
+}  // namespace
+
 void CPointsMap::determineMatching2D(
 	const mrpt::maps::CMetricMap* otherMap2, const CPose2D& otherMapPose_,
 	TMatchingPairList& correspondences, const TMatchingParams& params,
@@ -304,23 +516,19 @@ void CPointsMap::determineMatching2D(
 
 	auto bbLocal = mrpt::math::TBoundingBoxf::PlusMinusInfinity();
 
-	double maxDistForCorrespondenceSquared;
-	float x_local, y_local;
-	unsigned int localIdx;
-
-	const float *x_other_it, *y_other_it, *z_other_it;
-
 	// Prepare output: no correspondences initially:
 	correspondences.clear();
-	correspondences.reserve(nLocalPoints);
 	extraResults.correspondencesRatio = 0;
 
-	TMatchingPairList tempCorrs;
-	tempCorrs.reserve(nLocalPoints);
-
 	// Nothing to do if we have an empty map!
 	if (!nGlobalPoints || !nLocalPoints) return;
 
+	auto& buf = matchingBuffers();
+	auto& x_locals = buf.xs;
+	auto& y_locals = buf.ys;
+	x_locals.resize(nLocalPoints);
+	y_locals.resize(nLocalPoints);
+
 	const double sin_phi = sin(otherMapPose.phi);
 	const double cos_phi = cos(otherMapPose.phi);
 
@@ -332,8 +540,6 @@ void CPointsMap::determineMatching2D(
 	// Number of 4-floats:
 	size_t nPackets = nLocalPoints / 4;
 
-	Eigen::ArrayXf x_locals(nLocalPoints), y_locals(nLocalPoints);
-
 	// load 4 copies of the same value
 	const __m128 cos_4val = _mm_set1_ps(cos_phi);
 	const __m128 sin_4val = _mm_set1_ps(sin_phi);
@@ -413,15 +619,15 @@ void CPointsMap::determineMatching2D(
 	const Eigen::Map<Eigen::Matrix<float, Eigen::Dynamic, 1>> y_org(
 		const_cast<float*>(&otherMap->m_y[0]), otherMap->m_y.size(), 1);
 
-	Eigen::Array<float, Eigen::Dynamic, 1> x_locals =
-		otherMapPose.x + cos_phi * x_org.array() - sin_phi * y_org.array();
-	Eigen::Array<float, Eigen::Dynamic, 1> y_locals =
-		otherMapPose.y + sin_phi * x_org.array() + cos_phi * y_org.array();
+	Eigen::Map<Eigen::ArrayXf> xs(x_locals.data(), nLocalPoints);
+	Eigen::Map<Eigen::ArrayXf> ys(y_locals.data(), nLocalPoints);
+	xs = otherMapPose.x + cos_phi * x_org.array() - sin_phi * y_org.array();
+	ys = otherMapPose.y + sin_phi * x_org.array() + cos_phi * y_org.array();
 
-	bbLocal.min.x = x_locals.minCoeff();
-	bbLocal.min.y = y_locals.minCoeff();
-	bbLocal.max.x = x_locals.maxCoeff();
-	bbLocal.max.y = y_locals.maxCoeff();
+	bbLocal.min.x = xs.minCoeff();
+	bbLocal.min.y = ys.minCoeff();
+	bbLocal.max.x = xs.maxCoeff();
+	bbLocal.max.y = ys.maxCoeff();
 #endif
 
 	// Find the bounding box:
@@ -433,72 +639,84 @@ void CPointsMap::determineMatching2D(
 		bbLocal.min.y > bbGlobal.max.y || bbLocal.max.y < bbGlobal.min.y)
 		return;	 // We know for sure there is no matching at all
 
-	// Loop for each point in local map:
-	// --------------------------------------------------
-	for (localIdx = params.offset_other_map_points,
-		x_other_it = &otherMap->m_x[params.offset_other_map_points],
-		y_other_it = &otherMap->m_y[params.offset_other_map_points],
-		z_other_it = &otherMap->m_z[params.offset_other_map_points];
-		 localIdx < nLocalPoints;
-		 x_other_it += params.decimation_other_map_points,
-		y_other_it += params.decimation_other_map_points,
-		z_other_it += params.decimation_other_map_points,
-		localIdx += params.decimation_other_map_points)
-	{
-		// For speed-up:
-		x_local = x_locals[localIdx];  // *x_locals_it;
-		y_local = y_locals[localIdx];  // *y_locals_it;
-
-		// Find all the matchings in the requested distance:
-
-		// KD-TREE implementation =================================
-		// Use a KD-tree to look for the nearnest neighbor of:
-		//   (x_local, y_local, z_local)
-		// In "this" (global/reference) points map.
-
-		float tentativ_err_sq;
-		unsigned int tentativ_this_idx = kdTreeClosestPoint2D(
-			x_local, y_local,  // Look closest to this guy
-			tentativ_err_sq	 // save here the min. distance squared
-		);
+	// KD-tree queries for the decimated local points, by ranges of points in
+	// parallel threads. Pairings are then gathered in order, so results do
+	// not depend on the number of threads:
+	const size_t dec = params.decimation_other_map_points;
+	const size_t nQueries = nLocalPoints > params.offset_other_map_points
+		? (nLocalPoints - params.offset_other_map_points + dec - 1) / dec
+		: 0;
+	buf.matchIdx.resize(nQueries);
+	buf.matchDistSqr.resize(nQueries);
+
+	const auto lmbQueries = [&](size_t q0, size_t q1) {
+		for (size_t q = q0; q < q1; q++)
+		{
+			const size_t localIdx = params.offset_other_map_points + q * dec;
+			const float x_local = x_locals[localIdx];
+			const float y_local = y_locals[localIdx];
 
-		// Compute max. allowed distance:
-		maxDistForCorrespondenceSquared = square(
-			params.maxAngularDistForCorrespondence *
-				std::sqrt(
-					square(params.angularDistPivotPoint.x - x_local) +
-					square(params.angularDistPivotPoint.y - y_local)) +
-			params.maxDistForCorrespondence);
+			// Use a KD-tree to look for the nearnest neighbor of:
+			//   (x_local, y_local, z_local)
+			// In "this" (global/reference) points map.
+			float tentativ_err_sq;
+			const unsigned int tentativ_this_idx = kdTreeClosestPoint2D(
+				x_local, y_local,  // Look closest to this guy
+				tentativ_err_sq	 // save here the min. distance squared
+			);
 
-		// Distance below the threshold??
-		if (tentativ_err_sq < maxDistForCorrespondenceSquared)
-		{
-			// Save all the correspondences:
-			tempCorrs.resize(tempCorrs.size() + 1);
+			// Compute max. allowed distance:
+			const double maxDistForCorrespondenceSquared = square(
+				params.maxAngularDistForCorrespondence *
+					std::sqrt(
+						square(params.angularDistPivotPoint.x - x_local) +
+						square(params.angularDistPivotPoint.y - y_local)) +
+				params.maxDistForCorrespondence);
 
-			TMatchingPair& p = tempCorrs.back();
+			// Distance below the threshold??
+			buf.matchIdx[q] =
+				tentativ_err_sq < maxDistForCorrespondenceSquared
+				? tentativ_this_idx
+				: TMatchingBuffers::NO_MATCH;
+			buf.matchDistSqr[q] = tentativ_err_sq;
+		}
+	};
+	// The first query builds the KD-tree, if needed, before any thread:
+	lmbQueries(0, std::min<size_t>(1, nQueries));
+	runMatchingQueries(1, nQueries, params.numThreads, lmbQueries);
+
+	// Gather the pairings:
+	TMatchingPairList& tempCorrs =
+		params.onlyUniqueRobust ? buf.corrs : correspondences;
+	tempCorrs.clear();
+	for (size_t q = 0; q < nQueries; q++)
+	{
+		const uint32_t tentativ_this_idx = buf.matchIdx[q];
+		if (tentativ_this_idx == TMatchingBuffers::NO_MATCH) continue;
+		const size_t localIdx = params.offset_other_map_points + q * dec;
 
-			p.globalIdx = tentativ_this_idx;
-			p.global.x = m_x[tentativ_this_idx];
-			p.global.y = m_y[tentativ_this_idx];
-			p.global.z = m_z[tentativ_this_idx];
+		// Save all the correspondences:
+		TMatchingPair& p = tempCorrs.emplace_back();
 
-			p.localIdx = localIdx;
-			p.local.x = *x_other_it;
-			p.local.y = *y_other_it;
-			p.local.z = *z_other_it;
+		p.globalIdx = tentativ_this_idx;
+		p.global.x = m_x[tentativ_this_idx];
+		p.global.y = m_y[tentativ_this_idx];
+		p.global.z = m_z[tentativ_this_idx];
 
-			p.errorSquareAfterTransformation = tentativ_err_sq;
+		p.localIdx = localIdx;
+		p.local.x = otherMap->m_x[localIdx];
+		p.local.y = otherMap->m_y[localIdx];
+		p.local.z = otherMap->m_z[localIdx];
 
-			// At least one:
-			nOtherMapPointsWithCorrespondence++;
+		p.errorSquareAfterTransformation = buf.matchDistSqr[q];
 
-			// Accumulate the MSE:
-			_sumSqrDist += p.errorSquareAfterTransformation;
-			_sumSqrCount++;
-		}
+		// At least one:
+		nOtherMapPointsWithCorrespondence++;
 
-	}  // For each local point
+		// Accumulate the MSE:
+		_sumSqrDist += p.errorSquareAfterTransformation;
+		_sumSqrCount++;
+	}
 
 	// Additional consistency filter: "onlyKeepTheClosest" up to now
 	//  led to just one correspondence for each "local map" point, but
@@ -512,10 +730,6 @@ void CPointsMap::determineMatching2D(
 			"onlyUniqueRobust=true.");
 		tempCorrs.filterUniqueRobustPairs(nGlobalPoints, correspondences);
 	}
-	else
-	{
-		correspondences.swap(tempCorrs);
-	}
 
 	// If requested, copy sum of squared distances to output pointer:
 	// -------------------------------------------------------------------
@@ -537,15 +751,9 @@ void CPointsMap::determineMatching2D(
  ---------------------------------------------------------------*/
 void CPointsMap::changeCoordinatesReference(const CPose2D& newBase)
 {
-	const size_t N = m_x.size();
-
-	const CPose3D newBase3D(newBase);
-
-	for (size_t i = 0; i < N; i++)
-		newBase3D.composePoint(
-			m_x[i], m_y[i], m_z[i],	 // In
-			m_x[i], m_y[i], m_z[i]	// Out
-		);
+	// z remains unmodified:
+	newBase.composePoints(
+		m_x.data(), m_y.data(), m_x.data(), m_y.data(), m_x.size());
 
 	mark_as_modified();
 }
@@ -555,13 +763,9 @@ void CPointsMap::changeCoordinatesReference(const CPose2D& newBase)
  ---------------------------------------------------------------*/
 void CPointsMap::changeCoordinatesReference(const CPose3D& newBase)
 {
-	const size_t N = m_x.size();
-
-	for (size_t i = 0; i < N; i++)
-		newBase.composePoint(
-			m_x[i], m_y[i], m_z[i],	 // In
-			m_x[i], m_y[i], m_z[i]	// Out
-		);
+	newBase.composePoints(
+		m_x.data(), m_y.data(), m_z.data(), m_x.data(), m_y.data(),
+		m_z.data(), m_x.size());
 
 	mark_as_modified();
 }
@@ -593,13 +797,16 @@ CPointsMap::TInsertionOptions::TInsertionOptions()
 void CPointsMap::TInsertionOptions::writeToStream(
 	mrpt::serialization::CArchive& out) const
 {
-	const int8_t version = 0;
+	const int8_t version = 3;
 	out << version;
 
 	out << minDistBetweenLaserPoints << addToExistingPointsMap
 		<< also_interpolate << disableDeletion << fuseWithExisting
 		<< isPlanarMap << horizontalTolerance << maxDistForInterpolatePoints
 		<< insertInvalidPoints;	 // v0
+	out << incrementalKDTree;  // v1
+	out << voxelFilterSize << static_cast<uint8_t>(voxelFilterMethod);  // v2
+	out << serializeSurfaceGeometry;  // v3
 }
 
 void CPointsMap::TInsertionOptions::readFromStream(
@@ -610,11 +817,30 @@ void CPointsMap::TInsertionOptions::readFromStream(
 	switch (version)
 	{
 		case 0:
+		case 1:
+		case 2:
+		case 3:
 		{
 			in >> minDistBetweenLaserPoints >> addToExistingPointsMap >>
 				also_interpolate >> disableDeletion >> fuseWithExisting >>
 				isPlanarMap >> horizontalTolerance >>
 				maxDistForInterpolatePoints >> insertInvalidPoints;	 // v0
+			if (version >= 1) in >> incrementalKDTree;
+			else
+				incrementalKDTree = false;
+			if (version >= 2)
+			{
+				in >> voxelFilterSize;
+				in.ReadAsAndCastTo<uint8_t>(voxelFilterMethod);
+			}
+			else
+			{
+				voxelFilterSize = 0;
+				voxelFilterMethod = CPointCloudFilterByVoxelGrid::vgFirstPoint;
+			}
+			if (version >= 3) in >> serializeSurfaceGeometry;
+			else
+				serializeSurfaceGeometry = false;
 		}
 		break;
 		default: MRPT_THROW_UNKNOWN_SERIALIZATION_VERSION(version);
@@ -689,6 +915,10 @@ void CPointsMap::TInsertionOptions::dumpToTextStream(std::ostream& out) const
 	LOADABLEOPTS_DUMP_VAR(isPlanarMap, bool);
 
 	LOADABLEOPTS_DUMP_VAR(insertInvalidPoints, bool);
+	LOADABLEOPTS_DUMP_VAR(incrementalKDTree, bool);
+	LOADABLEOPTS_DUMP_VAR(serializeSurfaceGeometry, bool);
+	LOADABLEOPTS_DUMP_VAR(voxelFilterSize, double);
+	LOADABLEOPTS_DUMP_VAR(voxelFilterMethod, int);
 
 	out << endl;
 }
@@ -730,6 +960,10 @@ void CPointsMap::TInsertionOptions::loadFromConfigFile(
 	MRPT_LOAD_CONFIG_VAR(maxDistForInterpolatePoints, float, iniFile, section);
 
 	MRPT_LOAD_CONFIG_VAR(insertInvalidPoints, bool, iniFile, section);
+	MRPT_LOAD_CONFIG_VAR(incrementalKDTree, bool, iniFile, section);
+	MRPT_LOAD_CONFIG_VAR(serializeSurfaceGeometry, bool, iniFile, section);
+	MRPT_LOAD_CONFIG_VAR(voxelFilterSize, float, iniFile, section);
+	MRPT_LOAD_CONFIG_VAR(voxelFilterMethod, enum, iniFile, section);
 }
 
 void CPointsMap::TLikelihoodOptions::loadFromConfigFile(
@@ -785,17 +1019,44 @@ float CPointsMap::compute3DMatchingRatio(
 	const mrpt::poses::CPose3D& otherMapPose,
 	const TMatchingRatioParams& mrp) const
 {
-	TMatchingPairList correspondences;
-	TMatchingParams params;
-	TMatchingExtraResults extraResults;
+	MRPT_START
+
+	// The same ratio than determineMatching3D(), without building the list
+	// of pairings:
+	const auto* otherMap = otherMap2->getAsSimplePointsMap();
+	ASSERTMSG_(otherMap, "The other map must have a points map");
+
+	const auto otherPoints = otherMap->asView();
+	const size_t nOther = otherPoints.size();
+	if (!nOther || !size()) return 0;
+
+	auto& buf = matchingBuffers();
+	buf.xs.resize(nOther);
+	buf.ys.resize(nOther);
+	buf.zs.resize(nOther);
+	otherMapPose.composePoints(
+		otherPoints, buf.xs.data(), buf.ys.data(), buf.zs.data());
+	auto bbOther = mrpt::math::TBoundingBoxf::PlusMinusInfinity();
+	for (size_t i = 0; i < nOther; i++)
+		bbOther.updateWithPoint({buf.xs[i], buf.ys[i], buf.zs[i]});
+	if (!bbOther.intersection(boundingBox()).has_value()) return 0;
 
-	params.maxDistForCorrespondence = mrp.maxDistForCorr;
+	TBatchQueryParams params;
+	params.numThreads = mrp.numThreads;
+	std::vector<size_t> idxs;
+	std::vector<float>& distsSqr = buf.matchDistSqr;
+	kdTreeNClosestPoint3DIdxBatch(
+		mrpt::math::TPointCloudView::FromVectors(buf.xs, buf.ys, buf.zs), 1,
+		idxs, distsSqr, params);
 
-	this->determineMatching3D(
-		otherMap2->getAsSimplePointsMap(), otherMapPose, correspondences,
-		params, extraResults);
+	const float maxDistSqr = square(mrp.maxDistForCorr);
+	const auto nMatched = std::count_if(
+		distsSqr.begin(), distsSqr.end(),
+		[maxDistSqr](float d) { return d < maxDistSqr; });
 
-	return extraResults.correspondencesRatio;
+	return static_cast<float>(nMatched) / static_cast<float>(nOther);
+
+	MRPT_END
 }
 
 /*---------------------------------------------------------------
@@ -894,6 +1155,66 @@ float CPointsMap::squareDistanceToClosestCorrespondence(
 #endif
 }
 
+void CPointsMap::squareDistanceToClosestCorrespondenceBatch(
+	const std::vector<float>& xs, const std::vector<float>& ys,
+	std::vector<float>& outSqrDists, const TBatchQueryParams& params) const
+{
+	MRPT_START
+	ASSERT_EQUAL_(xs.size(), ys.size());
+	outSqrDists.resize(xs.size());
+	runBatchQueries(
+		xs.data(), ys.data(), nullptr, xs.size(), params, [&](size_t i) {
+			outSqrDists[i] =
+				squareDistanceToClosestCorrespondence(xs[i], ys[i]);
+		});
+	MRPT_END
+}
+
+size_t CPointsMap::kdTreeNClosestPoint3DIdxBatch(
+	const mrpt::math::TPointCloudView& queries, size_t knn,
+	std::vector<size_t>& outIdx, std::vector<float>& outDistSqr,
+	const TBatchQueryParams& params) const
+{
+	MRPT_START
+	ASSERT_GT_(knn, 0U);
+
+	const size_t N = queries.size();
+	const size_t k = std::min(knn, size());
+	outIdx.resize(N * k);
+	outDistSqr.resize(N * k);
+	if (!k) return 0;
+
+	runBatchQueries(
+		queries.x, queries.y, queries.z, N, params, [&](size_t i) {
+			thread_local std::vector<size_t> idxs;
+			thread_local std::vector<float> distsSqr;
+			kdTreeNClosestPoint3DIdx(
+				queries.x[i], queries.y[i], queries.z[i], k, idxs, distsSqr);
+			std::copy(idxs.begin(), idxs.end(), outIdx.begin() + i * k);
+			std::copy(
+				distsSqr.begin(), distsSqr.end(), outDistSqr.begin() + i * k);
+		});
+	return k;
+	MRPT_END
+}
+
+void CPointsMap::kdTreeRadiusSearch3DBatch(
+	const mrpt::math::TPointCloudView& queries, float maxRadiusSqr,
+	std::vector<std::vector<std::pair<size_t, float>>>& outIndicesDist,
+	const TBatchQueryParams& params) const
+{
+	MRPT_START
+	const size_t N = queries.size();
+	outIndicesDist.resize(N);
+	runBatchQueries(
+		queries.x, queries.y, queries.z, N, params, [&](size_t i) {
+			kdTreeRadiusSearch3D(
+				queries.x[i], queries.y[i], queries.z[i], maxRadiusSqr,
+				outIndicesDist[i]);
+		});
+	MRPT_END
+}
+
 mrpt::math::TBoundingBoxf CPointsMap::boundingBox() const
 {
 	MRPT_START
@@ -1000,6 +1321,205 @@ mrpt::math::TBoundingBoxf CPointsMap::boundingBox() const
 	MRPT_END
 }
 
+namespace
+{
+/** The GICP covariance for a point with normal `n`: U*diag(1e-3,1,1)*U^T,
+ * for U the eigenvectors with `n` as the first one */
+mrpt::math::CMatrixFloat33 surfaceCovarianceFromNormal(
+	const mrpt::math::TVector3Df& n)
+{
+	const Eigen::Vector3f v(n.x, n.y, n.z);
+	return mrpt::math::CMatrixFloat33(
+		(Eigen::Matrix3f::Identity() - (1.0f - 1e-3f) * v * v.transpose())
+			.eval());
+}
+}  // namespace
+
+const CPointsMap::TLocalSurfaceGeometry& CPointsMap::getLocalSurfaceGeometry(
+	size_t knn, size_t numThreads) const
+{
+	MRPT_START
+
+	ASSERT_GE_(knn, 3U);
+	auto& g = m_localSurfaceGeometry;
+	const size_t N = m_x.size();
+	if (g.knn == knn && g.size() == N) return g;
+
+	size_t nThreads = numThreads;
+	if (nThreads == 0) nThreads = std::thread::hardware_concurrency();
+	nThreads = std::max<size_t>(1, nThreads);
+	// Less than this number of points per thread is not worth a thread:
+	constexpr size_t minPointsPerThread = 2048;
+	const auto lmbRunInThreads = [&](size_t nItems, const auto& lmbRange) {
+		const size_t nTh = std::max<size_t>(
+			1, std::min(nThreads, nItems / minPointsPerThread));
+		std::vector<std::thread> threads;
+		for (size_t th = 1; th < nTh; th++)
+			threads.emplace_back([&, th]() {
+				lmbRange(nItems * th / nTh, nItems * (th + 1) / nTh, th);
+			});
+		lmbRange(0, nItems / nTh, 0);
+		for (auto& t : threads)
+			t.join();
+	};
+
+	// The first query builds the KD-tree, so worker threads only read it:
+	if (N)
+	{
+		std::vector<size_t> idxs;
+		std::vector<float> dists2;
+		kdTreeNClosestPoint3DIdx(m_x[0], m_y[0], m_z[0], 1, idxs, dists2);
+	}
+
+	// The points to (re)compute:
+	std::vector<size_t> toUpdate;
+	const size_t N0 = g.size();
+	const float maxRadiusSqr = g.neighbourhoodRadiiSqr.empty()
+		? 0
+		: *std::max_element(
+			  g.neighbourhoodRadiiSqr.begin(), g.neighbourhoodRadiiSqr.end());
+	if (N && g.knn == knn && N0 < N && N0 > 0 && std::isfinite(maxRadiusSqr))
+	{
+		// Incremental update after points were appended: the existing points
+		// whose neighbourhood contains some new point, plus the new points.
+		std::vector<std::vector<size_t>> affected(nThreads);
+		lmbRunInThreads(N - N0, [&](size_t i0, size_t i1, size_t th) {
+			std::vector<std::pair<size_t, float>> found;
+			for (size_t i = N0 + i0; i < N0 + i1; i++)
+			{
+				kdTreeRadiusSearch3D(
+					m_x[i], m_y[i], m_z[i], maxRadiusSqr, found);
+				for (const auto& [j, distSqr] : found)
+					if (j < N0 && distSqr <= g.neighbourhoodRadiiSqr[j])
+						affected[th].push_back(j);
+			}
+		});
+		for (const auto& a : affected)
+			toUpdate.insert(toUpdate.end(), a.begin(), a.end());
+		std::sort(toUpdate.begin(), toUpdate.end());
+		toUpdate.erase(
+			std::unique(toUpdate.begin(), toUpdate.end()), toUpdate.end());
+		for (size_t i = N0; i < N; i++)
+			toUpdate.push_back(i);
+	}
+	else
+	{
+		toUpdate.resize(N);
+		std::iota(toUpdate.begin(), toUpdate.end(), 0);
+	}
+
+	g.normals.resize(N);
+	g.curvatures.resize(N);
+	g.covariances.resize(N);
+	g.neighbourhoodRadiiSqr.resize(N);
+	if (!N)
+	{
+		g.knn = knn;
+		return g;
+	}
+	const size_t K = std::min(knn, N);
+
+	lmbRunInThreads(toUpdate.size(), [&](size_t k0, size_t k1, size_t) {
+		std::vector<size_t> idxs;
+		std::vector<float> dists2;
+		for (size_t k = k0; k < k1; k++)
+		{
+			const size_t i = toUpdate[k];
+			kdTreeNClosestPoint3DIdx(m_x[i], m_y[i], m_z[i], K, idxs, dists2);
+
+			// Mean and covariance of the neighbours:
+			Eigen::Vector3d mean = Eigen::Vector3d::Zero();
+			for (const auto j : idxs)
+				mean += Eigen::Vector3d(m_x[j], m_y[j], m_z[j]);
+			mean /= static_cast<double>(K);
+			Eigen::Matrix3d cov = Eigen::Matrix3d::Zero();
+			for (const auto j : idxs)
+			{
+				const Eigen::Vector3d d =
+					Eigen::Vector3d(m_x[j], m_y[j], m_z[j]) - mean;
+				cov += d * d.transpose();
+			}
+			cov /= static_cast<double>(K);
+
+			// Eigenvalues in increasing order: the first eigenvector is the
+			// normal.
+			Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> es;
+			es.computeDirect(cov);
+			const Eigen::Vector3d n = es.eigenvectors().col(0);
+			const Eigen::Vector3d lambdas = es.eigenvalues().cwiseMax(0.0);
+			const double sumLambdas = lambdas.sum();
+
+			g.normals[i] = mrpt::math::TVector3Df(
+				mrpt::d2f(n.x()), mrpt::d2f(n.y()), mrpt::d2f(n.z()));
+			g.curvatures[i] =
+				sumLambdas > 0 ? mrpt::d2f(lambdas[0] / sumLambdas) : 0.0f;
+			g.covariances[i] = surfaceCovarianceFromNormal(g.normals[i]);
+			g.neighbourhoodRadiiSqr[i] = K < knn
+				? std::numeric_limits<float>::infinity()
+				: *std::max_element(dists2.begin(), dists2.end());
+		}
+	});
+
+	g.knn = knn;
+	return g;
+
+	MRPT_END
+}
+
+void CPointsMap::writeLocalSurfaceGeometry(
+	mrpt::serialization::CArchive& out) const
+{
+	const auto& g = m_localSurfaceGeometry;
+	const bool save = insertionOptions.serializeSurfaceGeometry &&
+		g.knn != 0 && g.size() == m_x.size();
+	out << save;
+	if (!save) return;
+
+	const uint32_t N = static_cast<uint32_t>(g.size());
+	out << static_cast<uint32_t>(g.knn) << N;
+	std::vector<float> buf(3 * N);
+	for (uint32_t i = 0; i < N; i++)
+	{
+		buf[3 * i + 0] = g.normals[i].x;
+		buf[3 * i + 1] = g.normals[i].y;
+		buf[3 * i + 2] = g.normals[i].z;
+	}
+	if (N)
+	{
+		out.WriteBufferFixEndianness(buf.data(), buf.size());
+		out.WriteBufferFixEndianness(g.curvatures.data(), N);
+		out.WriteBufferFixEndianness(g.neighbourhoodRadiiSqr.data(), N);
+	}
+}
+
+void CPointsMap::readLocalSurfaceGeometry(mrpt::serialization::CArchive& in)
+{
+	auto& g = m_localSurfaceGeometry;
+	g = TLocalSurfaceGeometry();
+	if (!in.ReadAs<bool>()) return;
+
+	const auto knn = in.ReadAs<uint32_t>();
+	const auto N = in.ReadAs<uint32_t>();
+	ASSERT_EQUAL_(N, m_x.size());
+	std::vector<float> buf(3 * N);
+	g.normals.resize(N);
+	g.curvatures.resize(N);
+	g.covariances.resize(N);
+	g.neighbourhoodRadiiSqr.resize(N);
+	if (N)
+	{
+		in.ReadBufferFixEndianness(buf.data(), buf.size());
+		in.ReadBufferFixEndianness(g.curvatures.data(), N);
+		in.ReadBufferFixEndianness(g.neighbourhoodRadiiSqr.data(), N);
+	}
+	for (uint32_t i = 0; i < N; i++)
+	{
+		g.normals[i] = {buf[3 * i + 0], buf[3 * i + 1], buf[3 * i + 2]};
+		g.covariances[i] = surfaceCovarianceFromNormal(g.normals[i]);
+	}
+	g.knn = knn;
+}
+
 /*---------------------------------------------------------------
 				computeMatchingWith3D
 ---------------------------------------------------------------*/
@@ -1010,16 +1530,30 @@ void CPointsMap::determineMatching3D(
 {
 	MRPT_START
 
+	ASSERT_(otherMap2->GetRuntimeClass()->derivedFrom(CLASS_ID(CPointsMap)));
+	const auto* otherMap = static_cast<const CPointsMap*>(otherMap2);
+
+	determineMatching3D(
+		otherMap->asView(), otherMapPose, correspondences, params,
+		extraResults);
+
+	MRPT_END
+}
+
+void CPointsMap::determineMatching3D(
+	const mrpt::math::TPointCloudView& otherPoints, const CPose3D& otherMapPose,
+	TMatchingPairList& correspondences, const TMatchingParams& params,
+	TMatchingExtraResults& extraResults) const
+{
+	MRPT_START
+
 	extraResults = TMatchingExtraResults();
 
 	ASSERT_GT_(params.decimation_other_map_points, 0);
 	ASSERT_LT_(
 		params.offset_other_map_points, params.decimation_other_map_points);
 
-	ASSERT_(otherMap2->GetRuntimeClass()->derivedFrom(CLASS_ID(CPointsMap)));
-	const auto* otherMap = static_cast<const CPointsMap*>(otherMap2);
-
-	const size_t nLocalPoints = otherMap->size();
+	const size_t nLocalPoints = otherPoints.size();
 	const size_t nGlobalPoints = this->size();
 	float _sumSqrDist = 0;
 	size_t _sumSqrCount = 0;
@@ -1028,22 +1562,21 @@ void CPointsMap::determineMatching3D(
 
 	auto bbLocal = mrpt::math::TBoundingBoxf::PlusMinusInfinity();
 
-	double maxDistForCorrespondenceSquared;
-
 	// Prepare output: no correspondences initially:
 	correspondences.clear();
-	correspondences.reserve(nLocalPoints);
-
-	TMatchingPairList tempCorrs;
-	tempCorrs.reserve(nLocalPoints);
 
 	// Empty maps?  Nothing to do
 	if (!nGlobalPoints || !nLocalPoints) return;
 
 	// Try to do matching only if the bounding boxes have some overlap:
 	// Transform all local points:
-	vector<float> x_locals(nLocalPoints), y_locals(nLocalPoints),
-		z_locals(nLocalPoints);
+	auto& buf = matchingBuffers();
+	auto& x_locals = buf.xs;
+	auto& y_locals = buf.ys;
+	auto& z_locals = buf.zs;
+	x_locals.resize(nLocalPoints);
+	y_locals.resize(nLocalPoints);
+	z_locals.resize(nLocalPoints);
 
 	for (unsigned int localIdx = params.offset_other_map_points;
 		 localIdx < nLocalPoints;
@@ -1051,8 +1584,8 @@ void CPointsMap::determineMatching3D(
 	{
 		float x_local, y_local, z_local;
 		otherMapPose.composePoint(
-			otherMap->m_x[localIdx], otherMap->m_y[localIdx],
-			otherMap->m_z[localIdx], x_local, y_local, z_local);
+			otherPoints.x[localIdx], otherPoints.y[localIdx],
+			otherPoints.z[localIdx], x_local, y_local, z_local);
 
 		x_locals[localIdx] = x_local;
 		y_locals[localIdx] = y_local;
@@ -1070,23 +1603,27 @@ void CPointsMap::determineMatching3D(
 	if (!bbLocal.intersection(bbGlobal).has_value())
 		return;	 // No need to compute: matching is ZERO.
 
-	// Loop for each point in local map:
-	// --------------------------------------------------
-	for (unsigned int localIdx = params.offset_other_map_points;
-		 localIdx < nLocalPoints;
-		 localIdx += params.decimation_other_map_points)
-	{
-		// For speed-up:
-		const float x_local = x_locals[localIdx];
-		const float y_local = y_locals[localIdx];
-		const float z_local = z_locals[localIdx];
-
+	// KD-tree queries for the decimated local points, by ranges of points in
+	// parallel threads. Pairings are then gathered in order, so results do
+	// not depend on the number of threads:
+	const size_t dec = params.decimation_other_map_points;
+	const size_t nQueries = nLocalPoints > params.offset_other_map_points
+		? (nLocalPoints - params.offset_other_map_points + dec - 1) / dec
+		: 0;
+	buf.matchIdx.resize(nQueries);
+	buf.matchDistSqr.resize(nQueries);
+
+	const auto lmbQueries = [&](size_t q0, size_t q1) {
+		for (size_t q = q0; q < q1; q++)
 		{
-			// KD-TREE implementation
+			const size_t localIdx = params.offset_other_map_points + q * dec;
+			const float x_local = x_locals[localIdx];
+			const float y_local = y_locals[localIdx];
+			const float z_local = z_locals[localIdx];
+
 			// Use a KD-tree to look for the nearnest neighbor of:
 			//   (x_local, y_local, z_local)
 			// In "this" (global/reference) points map.
-
 			float tentativ_err_sq;
 			const unsigned int tentativ_this_idx = kdTreeClosestPoint3D(
 				x_local, y_local, z_local,	// Look closest to this guy
@@ -1094,42 +1631,56 @@ void CPointsMap::determineMatching3D(
 			);
 
 			// Compute max. allowed distance:
-			maxDistForCorrespondenceSquared = square(
+			const double maxDistForCorrespondenceSquared = square(
 				params.maxAngularDistForCorrespondence *
 					params.angularDistPivotPoint.distanceTo(
 						TPoint3D(x_local, y_local, z_local)) +
 				params.maxDistForCorrespondence);
 
 			// Distance below the threshold??
-			if (tentativ_err_sq < maxDistForCorrespondenceSquared)
-			{
-				// Save all the correspondences:
-				tempCorrs.resize(tempCorrs.size() + 1);
-
-				TMatchingPair& p = tempCorrs.back();
+			buf.matchIdx[q] =
+				tentativ_err_sq < maxDistForCorrespondenceSquared
+				? tentativ_this_idx
+				: TMatchingBuffers::NO_MATCH;
+			buf.matchDistSqr[q] = tentativ_err_sq;
+		}
+	};
+	// The first query builds the KD-tree, if needed, before any thread:
+	lmbQueries(0, std::min<size_t>(1, nQueries));
+	runMatchingQueries(1, nQueries, params.numThreads, lmbQueries);
+
+	// Gather the pairings:
+	TMatchingPairList& tempCorrs =
+		params.onlyUniqueRobust ? buf.corrs : correspondences;
+	tempCorrs.clear();
+	for (size_t q = 0; q < nQueries; q++)
+	{
+		const uint32_t tentativ_this_idx = buf.matchIdx[q];
+		if (tentativ_this_idx == TMatchingBuffers::NO_MATCH) continue;
+		const size_t localIdx = params.offset_other_map_points + q * dec;
 
-				p.globalIdx = tentativ_this_idx;
-				p.global.x = m_x[tentativ_this_idx];
-				p.global.y = m_y[tentativ_this_idx];
-				p.global.z = m_z[tentativ_this_idx];
+		// Save all the correspondences:
+		TMatchingPair& p = tempCorrs.emplace_back();
 
-				p.localIdx = localIdx;
-				p.local.x = otherMap->m_x[localIdx];
-				p.local.y = otherMap->m_y[localIdx];
-				p.local.z = otherMap->m_z[localIdx];
+		p.globalIdx = tentativ_this_idx;
+		p.global.x = m_x[tentativ_this_idx];
+		p.global.y = m_y[tentativ_this_idx];
+		p.global.z = m_z[tentativ_this_idx];
 
-				p.errorSquareAfterTransformation = tentativ_err_sq;
+		p.localIdx = localIdx;
+		p.local.x = otherPoints.x[localIdx];
+		p.local.y = otherPoints.y[localIdx];
+		p.local.z = otherPoints.z[localIdx];
 
-				// At least one:
-				nOtherMapPointsWithCorrespondence++;
+		p.errorSquareAfterTransformation = buf.matchDistSqr[q];
 
-				// Accumulate the MSE:
-				_sumSqrDist += p.errorSquareAfterTransformation;
-				_sumSqrCount++;
-			}
+		// At least one:
+		nOtherMapPointsWithCorrespondence++;
 
-		}  // End of test_match
-	}  // For each local point
+		// Accumulate the MSE:
+		_sumSqrDist += p.errorSquareAfterTransformation;
+		_sumSqrCount++;
+	}
 
 	// Additional consistency filter: "onlyKeepTheClosest" up to now
 	//  led to just one correspondence for each "local map" point, but
@@ -1143,10 +1694,6 @@ void CPointsMap::determineMatching3D(
 			"onlyUniqueRobust=true.");
 		tempCorrs.filterUniqueRobustPairs(nGlobalPoints, correspondences);
 	}
-	else
-	{
-		correspondences = std::move(tempCorrs);
-	}
 
 	// If requested, copy sum of squared distances to output pointer:
 	// -------------------------------------------------------------------
@@ -1461,44 +2008,133 @@ double CPointsMap::internal_computeObservationLikelihood(
 				takenFrom, xs, ys, zs, N);
 		}
 	}
-	else if (IS_CLASS(obs, CObservationVelodyneScan))
+	else if (
+		IS_CLASS(obs, CObservationVelodyneScan) ||
+		IS_CLASS(obs, CObservationPointCloud))
 	{
-		const auto& o = dynamic_cast<const CObservationVelodyneScan&>(obs);
+		if (!this->size()) return -100;
 
-		// Automatically generate pointcloud if needed:
-		if (!o.point_cloud.size())
-			const_cast<CObservationVelodyneScan&>(o).generatePointCloud();
+		// Decimated points, built once for all the evaluated poses:
+		const auto cloud = getLikelihoodCloud(obs);
+		if (!cloud || cloud->x.empty()) return -100;
 
-		const size_t N = o.point_cloud.size();
-		if (!N || !this->size()) return -100;
+		CPose3D sensorPose;
+		obs.getSensorPose(sensorPose);
+		return internal_computeObservationLikelihoodCloud(
+			takenFrom + sensorPose, *cloud);
+	}
 
-		const CPose3D sensorAbsPose = takenFrom + o.sensorPose;
+	return .0;
+}
 
-		const float* xs = &o.point_cloud.x[0];
-		const float* ys = &o.point_cloud.y[0];
-		const float* zs = &o.point_cloud.z[0];
+std::shared_ptr<const CPointsMap::TLikelihoodCloud>
+	CPointsMap::getLikelihoodCloud(const CObservation& obs) const
+{
+	const auto* velo = dynamic_cast<const CObservationVelodyneScan*>(&obs);
+	const auto* pc = dynamic_cast<const CObservationPointCloud*>(&obs);
+	if (!velo && !pc) return {};
+	if (pc && !pc->pointcloud) return {};
+
+	const uint32_t dec = std::max<uint32_t>(1, likelihoodOptions.decimation);
+	size_t rawSize;
+	if (pc) rawSize = pc->pointcloud->size();
+	else if (velo->point_cloud.size())
+		rawSize = velo->point_cloud.size();
+	else
+		rawSize = velo->scan_packets.size();
 
-		return internal_computeObservationLikelihoodPointCloud3D(
-			sensorAbsPose, xs, ys, zs, N);
+	auto& cache = m_likelihoodCloudCache;
+	{
+		std::lock_guard<std::mutex> lck(cache.mtx);
+		for (const auto& e : cache.entries)
+			if (e && e->obs == &obs && e->timestamp == obs.timestamp &&
+				e->rawSize == rawSize && e->decimation == dec)
+				return e;
 	}
-	else if (IS_CLASS(obs, CObservationPointCloud))
+
+	auto c = std::make_shared<TLikelihoodCloud>();
+	c->obs = &obs;
+	c->timestamp = obs.timestamp;
+	c->rawSize = rawSize;
+	c->decimation = dec;
+
+	auto lmbDecimate = [&](const float* xs, const float* ys, const float* zs,
+						   size_t N) {
+		const size_t n = (N + dec - 1) / dec;
+		c->x.resize(n);
+		c->y.resize(n);
+		c->z.resize(n);
+		for (size_t i = 0, j = 0; j < n; i += dec, j++)
+		{
+			c->x[j] = xs[i];
+			c->y[j] = ys[i];
+			c->z[j] = zs[i];
+		}
+	};
+
+	if (pc)
+	{
+		const auto& m = *pc->pointcloud;
+		lmbDecimate(
+			m.getPointsBufferRef_x().data(), m.getPointsBufferRef_y().data(),
+			m.getPointsBufferRef_z().data(), m.size());
+	}
+	else if (velo->point_cloud.size())
 	{
-		const auto& o = dynamic_cast<const CObservationPointCloud&>(obs);
+		const auto& p = velo->point_cloud;
+		lmbDecimate(p.x.data(), p.y.data(), p.z.data(), p.size());
+	}
+	else
+	{
+		// Generate the point cloud without modifying the observation, which
+		// may be used from other threads:
+		CObservationVelodyneScan::TPointCloud p;
+		velo->generatePointCloud(p);
+		lmbDecimate(p.x.data(), p.y.data(), p.z.data(), p.size());
+	}
 
-		const size_t N = o.pointcloud->size();
-		if (!N || !this->size()) return -100;
+	std::lock_guard<std::mutex> lck(cache.mtx);
+	cache.entries[cache.next] = c;
+	cache.next = (cache.next + 1) % cache.entries.size();
+	return c;
+}
 
-		const CPose3D sensorAbsPose = takenFrom + o.sensorPose;
+double CPointsMap::internal_computeObservationLikelihoodCloud(
+	const mrpt::poses::CPose3D& sensorPoseInMap,
+	const TLikelihoodCloud& cloud) const
+{
+	MRPT_TRY_START
 
-		auto xs = o.pointcloud->getPointsBufferRef_x();
-		auto ys = o.pointcloud->getPointsBufferRef_y();
-		auto zs = o.pointcloud->getPointsBufferRef_z();
+	const size_t n = cloud.x.size();
+	if (!n) return .0;
 
-		return internal_computeObservationLikelihoodPointCloud3D(
-			sensorAbsPose, &xs[0], &ys[0], &zs[0], N);
+	// Per-thread buffers, since this may be called for many particles in
+	// parallel:
+	thread_local mrpt::aligned_std_vector<float> gx, gy, gz;
+	gx.resize(n);
+	gy.resize(n);
+	gz.resize(n);
+	sensorPoseInMap.composePoints(
+		cloud.x.data(), cloud.y.data(), cloud.z.data(), gx.data(), gy.data(),
+		gz.data(), n);
+
+	float closest_x, closest_y, closest_z;
+	float closest_err;
+	const float max_sqr_err = square(likelihoodOptions.max_corr_distance);
+	double sumSqrDist = 0;
+	for (size_t i = 0; i < n; i++)
+	{
+		kdTreeClosestPoint3D(
+			gx[i], gy[i], gz[i], closest_x, closest_y, closest_z, closest_err);
+		mrpt::keep_min(closest_err, max_sqr_err);
+		sumSqrDist += static_cast<double>(closest_err);
 	}
+	sumSqrDist /= n;
 
-	return .0;
+	// Log-likelihood:
+	return -sumSqrDist / likelihoodOptions.sigma_dist;
+
+	MRPT_TRY_END
 }
 
 namespace mrpt::obs
@@ -1625,24 +2261,22 @@ void CPointsMap::insertAnotherMap(
 		if (filterOutPointsAtZero && pt.x == 0 && pt.y == 0 && pt.z == 0)
 			continue;  // Skip
 
-		// Translation:
-		mrpt::math::TPoint3D g;
-
-		if (!identity_tf)
-			otherPose.composePoint(pt.x, pt.y, pt.z, g.x, g.y, g.z);
-		else
-		{
-			g = pt;
-		}
-
 		// Add to this map:
-		this->insertPointFast(g.x, g.y, g.z);
+		this->insertPointFast(pt.x, pt.y, pt.z);
+	}
+
+	// Transform all the new points at once:
+	if (!identity_tf)
+	{
+		float *x = m_x.data() + N_this, *y = m_y.data() + N_this,
+			  *z = m_z.data() + N_this;
+		otherPose.composePoints(x, y, z, x, y, z, m_x.size() - N_this);
 	}
 
 	// Also copy other data fields (color, ...)
 	addFrom_classSpecific(*otherMap, N_this, filterOutPointsAtZero);
 
-	mark_as_modified();
+	mark_as_points_appended();
 }
 
 /** Helper method for ::copyFrom() */
@@ -1663,6 +2297,7 @@ void CPointsMap::base_copyFrom(const CPointsMap& obj)
 	// Fill missing fields (R,G,B,min_dist) with default values.
 	this->resize(m_x.size());
 
+	m_localSurfaceGeometry.knn = 0;
 	kdtree_mark_as_outdated();
 
 	MRPT_END
@@ -1675,6 +2310,58 @@ void CPointsMap::base_copyFrom(const CPointsMap& obj)
  ---------------------------------------------------------------*/
 bool CPointsMap::internal_insertObservation(
 	const CObservation& obs, const std::optional<const CPose3D>& robotPose)
+{
+	const size_t nPrevPoints = size();
+	const bool done = internal_insertObservationPoints(obs, robotPose);
+	if (done && insertionOptions.voxelFilterSize > 0)
+	{
+		// Only the new points, unless the map was cleared or shrank:
+		internal_voxelFilterPointsFrom(
+			size() >= nPrevPoints && insertionOptions.addToExistingPointsMap
+				? nPrevPoints
+				: 0);
+	}
+	return done;
+}
+
+void CPointsMap::internal_voxelFilterPointsFrom(size_t firstIndex)
+{
+	MRPT_START
+	const size_t N = size();
+	if (firstIndex >= N) return;
+
+	CPointCloudFilterByVoxelGrid vg;
+	vg.options.voxel_size = insertionOptions.voxelFilterSize;
+	vg.options.method = insertionOptions.voxelFilterMethod;
+
+	std::vector<bool> deletion;
+	const size_t nKept = vg.computeDeletionMask(
+		asView().subView(firstIndex, N - firstIndex), deletion);
+	if (nKept == N - firstIndex) return;
+
+	// Compact the new points in place, keeping the old ones untouched so an
+	// incremental KD-tree remains valid:
+	std::vector<float> pt;
+	size_t j = firstIndex;
+	for (size_t i = firstIndex; i < N; i++)
+	{
+		if (deletion[i - firstIndex]) continue;
+		if (i != j)
+		{
+			getPointAllFieldsFast(i, pt);
+			setPointAllFieldsFast(j, pt);
+		}
+		j++;
+	}
+	resize(j);
+	if (firstIndex > 0) mark_as_points_appended();
+	else
+		mark_as_modified();
+	MRPT_END
+}
+
+bool CPointsMap::internal_insertObservationPoints(
+	const CObservation& obs, const std::optional<const CPose3D>& robotPose)
 {
 	MRPT_START
 
@@ -2055,49 +2742,64 @@ void CPointsMap::loadFromVelodyneScan(
 
 	if (scan.point_cloud.x.empty()) return;
 
-	this->mark_as_modified();
-
 	// Insert vs. load and replace:
 	if (!insertionOptions.addToExistingPointsMap)
 		resize(0);	// Resize to 0 instead of clear() so the std::vector<>
 	// memory is not actually deallocated and can be reused.
 
-	// Alloc space:
-	const size_t nOldPtsCount = this->size();
-	const size_t nScanPts = scan.point_cloud.size();
-	const size_t nNewPtsCount = nOldPtsCount + nScanPts;
-	this->resize(nNewPtsCount);
-
-	const float K = 1.0f / 255;	 // Intensity scale.
-
 	// global 3D pose:
 	CPose3D sensorGlobalPose;
 	if (robotPose) sensorGlobalPose = *robotPose + scan.sensorPose;
 	else
 		sensorGlobalPose = scan.sensorPose;
 
+	insertPointsView(scan.point_cloud.asView(), sensorGlobalPose);
+}
+
+void CPointsMap::insertPointsView(
+	const mrpt::math::TPointCloudView& pts,
+	const std::optional<const mrpt::poses::CPose3D>& pose)
+{
+	if (pts.empty()) return;
+
+	this->mark_as_modified();
+
+	// Alloc space:
+	const size_t nOldPtsCount = this->size();
+	const size_t nScanPts = pts.size();
+	this->resize(nOldPtsCount + nScanPts);
+
 	mrpt::math::CMatrixDouble44 HM;
-	sensorGlobalPose.getHomogeneousMatrix(HM);
+	if (pose) pose->getHomogeneousMatrix(HM);
+	else
+		HM.setIdentity();
 
 	const double m00 = HM(0, 0), m01 = HM(0, 1), m02 = HM(0, 2), m03 = HM(0, 3);
 	const double m10 = HM(1, 0), m11 = HM(1, 1), m12 = HM(1, 2), m13 = HM(1, 3);
 	const double m20 = HM(2, 0), m21 = HM(2, 1), m22 = HM(2, 2), m23 = HM(2, 3);
 
+	const bool hasIntensity = pts.hasIntensity();
+
 	// Copy points:
 	for (size_t i = 0; i < nScanPts; i++)
 	{
-		const float inten = scan.point_cloud.intensity[i] * K;
-		const double lx = scan.point_cloud.x[i];
-		const double ly = scan.point_cloud.y[i];
-		const double lz = scan.point_cloud.z[i];
+		const double lx = pts.x[i];
+		const double ly = pts.y[i];
+		const double lz = pts.z[i];
 
 		const double gx = m00 * lx + m01 * ly + m02 * lz + m03;
 		const double gy = m10 * lx + m11 * ly + m12 * lz + m13;
 		const double gz = m20 * lx + m21 * ly + m22 * lz + m23;
 
-		this->setPointRGB(
-			nOldPtsCount + i, gx, gy, gz,  // XYZ
-			inten, inten, inten	 // RGB
-		);
+		if (hasIntensity)
+		{
+			const float inten = pts.getIntensity(i);
+			this->setPointRGB(
+				nOldPtsCount + i, gx, gy, gz,  // XYZ
+				inten, inten, inten	 // RGB
+			);
+		}
+		else
+			this->setPointFast(nOldPtsCount + i, gx, gy, gz);
 	}
 }
@@ -111,7 +111,7 @@ void CPointsMapXYZI::impl_copyFrom(const CPointsMap& obj)
 	if (pXYZI) m_intensity = pXYZI->m_intensity;
 }
 
-uint8_t CPointsMapXYZI::serializeGetVersion() const { return 0; }
+uint8_t CPointsMapXYZI::serializeGetVersion() const { return 1; }
 void CPointsMapXYZI::serializeTo(mrpt::serialization::CArchive& out) const
 {
 	uint32_t n = m_x.size();
@@ -128,6 +128,7 @@ void CPointsMapXYZI::serializeTo(mrpt::serialization::CArchive& out) const
 	}
 	insertionOptions.writeToStream(out);
 	likelihoodOptions.writeToStream(out);
+	writeLocalSurfaceGeometry(out);	 // v1
 }
 
 void CPointsMapXYZI::serializeFrom(
@@ -136,6 +137,7 @@ void CPointsMapXYZI::serializeFrom(
 	switch (version)
 	{
 		case 0:
+		case 1:
 		{
 			mark_as_modified();
 
@@ -152,6 +154,7 @@ void CPointsMapXYZI::serializeFrom(
 			}
 			insertionOptions.readFromStream(in);
 			likelihoodOptions.readFromStream(in);
+			if (version >= 1) readLocalSurfaceGeometry(in);
 		}
 		break;
 		default: MRPT_THROW_UNKNOWN_SERIALIZATION_VERSION(version);
@@ -8,11 +8,18 @@
    +------------------------------------------------------------------------+ */
 
 #include <gtest/gtest.h>
+#include <mrpt/io/CMemoryStream.h>
 #include <mrpt/maps/CColouredPointsMap.h>
 #include <mrpt/maps/CPointsMapXYZI.h>
 #include <mrpt/maps/CSimplePointsMap.h>
 #include <mrpt/maps/CWeightedPointsMap.h>
+#include <mrpt/obs/CObservationPointCloud.h>
 #include <mrpt/poses/CPoint2D.h>
+#include <mrpt/random/RandomGenerators.h>
+#include <mrpt/serialization/CArchive.h>
+#include <mrpt/system/filesystem.h>
+
+#include <fstream>
 
 #include <sstream>
 
@@ -242,6 +249,45 @@ void do_tests_loadSaveStreams()
 	}
 }
 
+TEST(CSimplePointsMapTests, loadLargeTextFile)
+{
+	// Large enough to be parsed in several chunks:
+	const size_t N = 300000, BAD_LINE = 250000;
+	const auto fil = mrpt::system::getTempFileName();
+	{
+		std::ofstream f(fil);
+		for (size_t i = 0; i < N; i++)
+			f << i << " " << i * 0.5 << ",-" << i % 10 << "\n";
+	}
+	CSimplePointsMap pts;
+	ASSERT_TRUE(pts.load3D_from_text_file(fil));
+	ASSERT_EQ(pts.size(), N);
+	for (size_t i = 0; i < N; i += 997)
+	{
+		float x, y, z;
+		pts.getPoint(i, x, y, z);
+		EXPECT_EQ(x, static_cast<float>(i));
+		EXPECT_EQ(y, static_cast<float>(i * 0.5));
+		EXPECT_EQ(z, -static_cast<float>(i % 10));
+	}
+
+	// Errors are reported at the right line, with all points before it:
+	{
+		std::ofstream f(fil);
+		for (size_t i = 1; i <= N; i++)
+			f << i << " " << (i == BAD_LINE ? "x" : "1") << " 2\n";
+	}
+	std::ifstream f(fil);
+	std::string errMsg;
+	EXPECT_FALSE(pts.load3D_from_text_stream(f, errMsg));
+	EXPECT_EQ(pts.size(), BAD_LINE - 1);
+	EXPECT_NE(errMsg.find("line 250000 for coordinate #2"), std::string::npos)
+		<< errMsg;
+
+	mrpt::system::deleteFile(fil);
+	EXPECT_FALSE(pts.load3D_from_text_file(fil));
+}
+
 TEST(CSimplePointsMapTests, insertPoints)
 {
 	do_test_insertPoints<CSimplePointsMap>();
@@ -303,3 +349,376 @@ TEST(CColouredPointsMapTests, loadSaveStreams)
 {
 	do_tests_loadSaveStreams<CColouredPointsMap>();
 }
+
+TEST(CSimplePointsMapTests, incrementalKDTree)
+{
+	CSimplePointsMap pts_incr, pts_full;
+	pts_incr.insertionOptions.incrementalKDTree = true;
+
+	const float query[3] = {3.3f, -1.2f, 0.5f};
+	for (int step = 0; step < 5; step++)
+	{
+		// Append a batch of points to both maps:
+		for (int i = 0; i < 100; i++)
+		{
+			const float x = 0.1f * (i + step * 100);
+			const float y = -0.05f * i;
+			const float z = 0.01f * step;
+			pts_incr.insertPoint(x, y, z);
+			pts_full.insertPoint(x, y, z);
+		}
+
+		// Queries must give the same results no matter the index type:
+		for (int is3D = 0; is3D < 2; is3D++)
+		{
+			std::vector<size_t> idx_incr, idx_full;
+			std::vector<float> d_incr, d_full;
+			if (is3D)
+			{
+				pts_incr.kdTreeNClosestPoint3DIdx(
+					query[0], query[1], query[2], 5, idx_incr, d_incr);
+				pts_full.kdTreeNClosestPoint3DIdx(
+					query[0], query[1], query[2], 5, idx_full, d_full);
+			}
+			else
+			{
+				pts_incr.kdTreeNClosestPoint2DIdx(
+					query[0], query[1], 5, idx_incr, d_incr);
+				pts_full.kdTreeNClosestPoint2DIdx(
+					query[0], query[1], 5, idx_full, d_full);
+			}
+			ASSERT_EQ(d_incr.size(), d_full.size());
+			for (size_t k = 0; k < d_incr.size(); k++)
+				EXPECT_NEAR(d_incr[k], d_full[k], 1e-6f);
+		}
+
+		std::vector<std::pair<size_t, float>> r_incr, r_full;
+		pts_incr.kdTreeRadiusSearch3D(
+			query[0], query[1], query[2], 4.0f, r_incr);
+		pts_full.kdTreeRadiusSearch3D(
+			query[0], query[1], query[2], 4.0f, r_full);
+		EXPECT_EQ(r_incr.size(), r_full.size());
+	}
+
+	// Modifying a point must invalidate the incremental index too:
+	pts_incr.setPoint(0, query[0], query[1], query[2]);
+	float dist_sqr;
+	const size_t idx = pts_incr.kdTreeClosestPoint3D(
+		query[0], query[1], query[2], dist_sqr);
+	EXPECT_EQ(idx, 0U);
+	EXPECT_NEAR(dist_sqr, 0.0f, 1e-6f);
+}
+
+TEST(CSimplePointsMapTests, insertPointsView)
+{
+	std::vector<float> xs, ys, zs;
+	for (size_t i = 0; i < demo9_N; i++)
+	{
+		xs.push_back(demo9_xs[i]);
+		ys.push_back(demo9_ys[i]);
+		zs.push_back(demo9_zs[i]);
+	}
+	const auto view = TPointCloudView::FromVectors(xs, ys, zs);
+
+	CSimplePointsMap pts;
+	pts.insertPointsView(view);
+	pts.insertPointsView(view.subView(3, 3), CPose3D(10.0, 0, 0, 0, 0, 0));
+	ASSERT_EQ(pts.size(), demo9_N + 3);
+	for (size_t i = 0; i < demo9_N; i++)
+	{
+		float x, y, z;
+		pts.getPoint(i, x, y, z);
+		EXPECT_EQ(x, demo9_xs[i]);
+		EXPECT_EQ(y, demo9_ys[i]);
+		EXPECT_EQ(z, demo9_zs[i]);
+	}
+	for (size_t i = 0; i < 3; i++)
+	{
+		float x, y, z;
+		pts.getPoint(demo9_N + i, x, y, z);
+		EXPECT_NEAR(x, demo9_xs[3 + i] + 10.0f, 1e-5f);
+		EXPECT_NEAR(y, demo9_ys[3 + i], 1e-5f);
+		EXPECT_NEAR(z, demo9_zs[3 + i], 1e-5f);
+	}
+
+	// Matching against a view or a map must give the same pairings:
+	CSimplePointsMap other;
+	other.insertPointsView(view);
+	const CPose3D otherPose(0.05, 0.02, 0, 0, 0, 0);
+	TMatchingParams mp;
+	mp.maxDistForCorrespondence = 0.5f;
+	TMatchingExtraResults er1, er2;
+	mrpt::tfest::TMatchingPairList c1, c2;
+	pts.determineMatching3D(&other, otherPose, c1, mp, er1);
+	pts.determineMatching3D(other.asView(), otherPose, c2, mp, er2);
+	ASSERT_EQ(c1.size(), demo9_N);
+	ASSERT_EQ(c1.size(), c2.size());
+	for (size_t i = 0; i < c1.size(); i++)
+	{
+		EXPECT_EQ(c1[i].globalIdx, c2[i].globalIdx);
+		EXPECT_EQ(c1[i].localIdx, c2[i].localIdx);
+	}
+	EXPECT_NEAR(er1.sumSqrDist, er2.sumSqrDist, 1e-6);
+}
+
+TEST(CSimplePointsMapTests, determineMatchingMultiThread)
+{
+	auto& rng = mrpt::random::getRandomGenerator();
+	rng.randomize(1234);
+
+	CSimplePointsMap m1, m2;
+	for (size_t i = 0; i < 20000; i++)
+	{
+		m1.insertPoint(
+			rng.drawUniform(0.0f, 10.0f), rng.drawUniform(0.0f, 10.0f),
+			rng.drawUniform(0.0f, 2.0f));
+		m2.insertPoint(
+			rng.drawUniform(0.0f, 10.0f), rng.drawUniform(0.0f, 10.0f),
+			rng.drawUniform(0.0f, 2.0f));
+	}
+
+	for (const bool robust : {false, true})
+	{
+		TMatchingParams mp;
+		mp.maxDistForCorrespondence = 0.05f;
+		mp.onlyUniqueRobust = robust;
+		mp.decimation_other_map_points = 3;
+		mp.offset_other_map_points = 1;
+
+		TMatchingExtraResults er1, er2;
+		mrpt::tfest::TMatchingPairList c1, c2;
+
+		const auto lmbCompare = [&]() {
+			ASSERT_GT(c1.size(), 0U);
+			ASSERT_EQ(c1.size(), c2.size());
+			for (size_t i = 0; i < c1.size(); i++)
+			{
+				EXPECT_EQ(c1[i].globalIdx, c2[i].globalIdx);
+				EXPECT_EQ(c1[i].localIdx, c2[i].localIdx);
+			}
+			EXPECT_EQ(er1.sumSqrDist, er2.sumSqrDist);
+			EXPECT_EQ(er1.correspondencesRatio, er2.correspondencesRatio);
+		};
+
+		const CPose2D pose2D(0.1, -0.2, 0.05);
+		mp.numThreads = 1;
+		m1.determineMatching2D(&m2, pose2D, c1, mp, er1);
+		mp.numThreads = 4;
+		m1.determineMatching2D(&m2, pose2D, c2, mp, er2);
+		lmbCompare();
+
+		const CPose3D pose3D(0.1, -0.2, 0.05, 0.05, 0.02, -0.01);
+		mp.numThreads = 1;
+		m1.determineMatching3D(&m2, pose3D, c1, mp, er1);
+		mp.numThreads = 4;
+		m1.determineMatching3D(&m2, pose3D, c2, mp, er2);
+		lmbCompare();
+	}
+}
+
+TEST(CSimplePointsMapTests, batchQueries)
+{
+	auto& rng = mrpt::random::getRandomGenerator();
+	rng.randomize(4321);
+
+	CSimplePointsMap m;
+	std::vector<float> xs, ys, zs;
+	for (size_t i = 0; i < 5000; i++)
+	{
+		m.insertPoint(
+			rng.drawUniform(0.0f, 10.0f), rng.drawUniform(0.0f, 10.0f),
+			rng.drawUniform(0.0f, 2.0f));
+		xs.push_back(rng.drawUniform(-1.0f, 11.0f));
+		ys.push_back(rng.drawUniform(-1.0f, 11.0f));
+		zs.push_back(rng.drawUniform(-0.5f, 2.5f));
+	}
+	const auto queries = TPointCloudView::FromVectors(xs, ys, zs);
+	const size_t knn = 3;
+	const float r2 = square(0.2f);
+
+	for (const size_t nThreads : {1, 4})
+		for (const bool morton : {false, true})
+		{
+			TBatchQueryParams bp;
+			bp.numThreads = nThreads;
+			bp.mortonOrder = morton;
+
+			std::vector<float> sqrDists2D;
+			m.squareDistanceToClosestCorrespondenceBatch(
+				xs, ys, sqrDists2D, bp);
+
+			std::vector<size_t> idxs;
+			std::vector<float> distsSqr;
+			ASSERT_EQ(
+				m.kdTreeNClosestPoint3DIdxBatch(
+					queries, knn, idxs, distsSqr, bp),
+				knn);
+
+			std::vector<std::vector<std::pair<size_t, float>>> inRadius;
+			m.kdTreeRadiusSearch3DBatch(queries, r2, inRadius, bp);
+			ASSERT_EQ(inRadius.size(), xs.size());
+
+			for (size_t i = 0; i < xs.size(); i++)
+			{
+				EXPECT_EQ(
+					sqrDists2D[i],
+					m.squareDistanceToClosestCorrespondence(xs[i], ys[i]));
+
+				std::vector<size_t> idxs1;
+				std::vector<float> distsSqr1;
+				m.kdTreeNClosestPoint3DIdx(
+					xs[i], ys[i], zs[i], knn, idxs1, distsSqr1);
+				for (size_t j = 0; j < knn; j++)
+				{
+					EXPECT_EQ(idxs[i * knn + j], idxs1[j]);
+					EXPECT_EQ(distsSqr[i * knn + j], distsSqr1[j]);
+				}
+
+				std::vector<std::pair<size_t, float>> inRadius1;
+				m.kdTreeRadiusSearch3D(xs[i], ys[i], zs[i], r2, inRadius1);
+				EXPECT_EQ(inRadius[i], inRadius1);
+			}
+		}
+
+	// Same ratio than determineMatching3D():
+	CSimplePointsMap m2;
+	for (size_t i = 0; i < xs.size(); i++)
+		m2.insertPoint(xs[i], ys[i], zs[i]);
+	const CPose3D pose(0.1, -0.2, 0.05, 0.05, 0.02, -0.01);
+
+	TMatchingParams mp;
+	mp.maxDistForCorrespondence = 0.1f;
+	TMatchingExtraResults er;
+	mrpt::tfest::TMatchingPairList corrs;
+	m.determineMatching3D(&m2, pose, corrs, mp, er);
+	ASSERT_GT(corrs.size(), 0U);
+
+	TMatchingRatioParams mrp;
+	mrp.maxDistForCorr = mp.maxDistForCorrespondence;
+	for (const size_t nThreads : {1, 4})
+	{
+		mrp.numThreads = nThreads;
+		EXPECT_FLOAT_EQ(
+			m.compute3DMatchingRatio(&m2, pose, mrp), er.correspondencesRatio);
+	}
+}
+
+TEST(CSimplePointsMapTests, localSurfaceGeometry)
+{
+	auto& rng = mrpt::random::getRandomGenerator();
+	rng.randomize(4321);
+
+	// Points on a plane z=0.1*x, then more points appended:
+	const auto lmbAddPoints = [&](CSimplePointsMap& m, size_t n) {
+		for (size_t i = 0; i < n; i++)
+		{
+			const float x = rng.drawUniform(0.0f, 4.0f);
+			const float y = rng.drawUniform(0.0f, 4.0f);
+			m.insertPoint(x, y, 0.1f * x);
+		}
+	};
+	CSimplePointsMap m;
+	lmbAddPoints(m, 5000);
+
+	const size_t knn = 8;
+	const auto& g = m.getLocalSurfaceGeometry(knn, 4);
+	ASSERT_EQ(g.size(), m.size());
+	const float nx = -0.1f / std::sqrt(1.01f), nz = 1.0f / std::sqrt(1.01f);
+	for (size_t i = 0; i < g.size(); i++)
+	{
+		const float dot = g.normals[i].x * nx + g.normals[i].z * nz;
+		EXPECT_NEAR(std::abs(dot), 1.0f, 1e-3f);
+		EXPECT_NEAR(g.curvatures[i], 0.0f, 1e-4f);
+	}
+
+	// Incremental update == full computation:
+	lmbAddPoints(m, 500);
+	EXPECT_EQ(m.getLocalSurfaceGeometryNoRecompute().size(), 5000U);
+	const auto gIncr = m.getLocalSurfaceGeometry(knn, 4);
+	CSimplePointsMap m2;
+	m2 = m;
+	m2.mark_as_modified();	// Force a full computation
+	const auto& gFull = m2.getLocalSurfaceGeometry(knn, 1);
+	ASSERT_EQ(gIncr.size(), m.size());
+	ASSERT_EQ(gFull.size(), m.size());
+	for (size_t i = 0; i < m.size(); i++)
+	{
+		EXPECT_EQ(gIncr.normals[i], gFull.normals[i]);
+		EXPECT_EQ(gIncr.curvatures[i], gFull.curvatures[i]);
+		EXPECT_EQ(
+			gIncr.neighbourhoodRadiiSqr[i], gFull.neighbourhoodRadiiSqr[i]);
+	}
+
+	// Optional serialization:
+	for (const bool save : {false, true})
+	{
+		m.insertionOptions.serializeSurfaceGeometry = save;
+		mrpt::io::CMemoryStream buf;
+		auto arch = mrpt::serialization::archiveFrom(buf);
+		arch << m;
+		buf.Seek(0);
+		CSimplePointsMap m3;
+		arch >> m3;
+		const auto& g3 = m3.getLocalSurfaceGeometryNoRecompute();
+		if (!save)
+		{
+			EXPECT_EQ(g3.knn, 0U);
+			continue;
+		}
+		EXPECT_EQ(g3.knn, knn);
+		ASSERT_EQ(g3.size(), m.size());
+		for (size_t i = 0; i < m.size(); i++)
+		{
+			EXPECT_EQ(g3.normals[i], gIncr.normals[i]);
+			EXPECT_EQ(g3.curvatures[i], gIncr.curvatures[i]);
+		}
+	}
+}
+
+TEST(CSimplePointsMapTests, pointCloudLikelihoodCache)
+{
+	auto& rng = mrpt::random::getRandomGenerator();
+	rng.randomize(1234);
+
+	CSimplePointsMap m;
+	auto pts = CSimplePointsMap::Create();
+	for (size_t i = 0; i < 5000; i++)
+	{
+		const float x = rng.drawUniform(0.0f, 10.0f),
+					y = rng.drawUniform(0.0f, 10.0f),
+					z = rng.drawUniform(0.0f, 2.0f);
+		m.insertPoint(x, y, z);
+		if (i % 3 == 0) pts->insertPoint(x - 1.0f, y - 0.5f, z - 0.2f);
+	}
+	m.likelihoodOptions.decimation = 7;
+
+	CObservationPointCloud obs;
+	obs.timestamp = mrpt::Clock::now();
+	obs.pointcloud = pts;
+	obs.sensorPose = CPose3D(0.1, 0.2, 0.3, 0.01, 0.02, 0.03);
+
+	const auto cloud = m.getLikelihoodCloud(obs);
+	ASSERT_TRUE(cloud);
+	EXPECT_EQ(cloud->x.size(), (pts->size() + 6) / 7);
+	EXPECT_EQ(m.getLikelihoodCloud(obs), cloud);
+
+	for (int i = 0; i < 10; i++)
+	{
+		const CPose3D p(
+			1 + rng.drawGaussian1D(0, 0.1), 0.5 + rng.drawGaussian1D(0, 0.1),
+			0, rng.drawGaussian1D(0, 0.05), 0, 0);
+		const CPose3D sensorPose = p + obs.sensorPose;
+		const double lik = m.computeObservationLikelihood(obs, p);
+		const double likRef =
+			m.internal_computeObservationLikelihoodPointCloud3D(
+				sensorPose, pts->getPointsBufferRef_x().data(),
+				pts->getPointsBufferRef_y().data(),
+				pts->getPointsBufferRef_z().data(), pts->size());
+		EXPECT_NEAR(lik, likRef, 1e-4 * std::abs(likRef));
+	}
+	EXPECT_EQ(m.getLikelihoodCloud(obs), cloud);
+
+	// A new observation:
+	obs.timestamp += std::chrono::seconds(1);
+	EXPECT_NE(m.getLikelihoodCloud(obs), cloud);
+}
@@ -9,6 +9,7 @@
 
 #include "maps-precomp.h"  // Precomp header
 //
+#include <mrpt/core/bits_math.h>
 #include <mrpt/core/round.h>
 #include <mrpt/img/color_maps.h>
 #include <mrpt/io/CFileGZInputStream.h>
@@ -23,7 +24,10 @@
 #include <mrpt/system/CTimeLogger.h>
 #include <mrpt/system/os.h>
 
+#include <algorithm>
+#include <exception>
 #include <numeric>
+#include <thread>
 
 using namespace mrpt;
 using namespace mrpt::maps;
@@ -335,6 +339,8 @@ void CRandomFieldGridMap2D::internal_clear()
 
 			m_gmrf.clear();
 			m_gmrf.initialize(nodeCount);
+			m_gmrf_observedCells.clear();
+			m_gmrf_updateAllVariances = true;
 
 			m_mrf_factors_activeObs.clear();
 			m_mrf_factors_activeObs.resize(
@@ -589,13 +595,20 @@ void CRandomFieldGridMap2D::insertObservation_KernelDM_DMV(
 		point.y - m_insertOptions_common->cutoffRadius * 2,
 		point.y + m_insertOptions_common->cutoffRadius * 2, defCell);
 
+	internal_updateWindow_KernelDM_DMV();
+	internal_fuseReading_KernelDM_DMV(
+		normReading, point, is_DMV, 0, static_cast<int>(m_size_y) - 1);
+
+	MRPT_END
+}
+
+int CRandomFieldGridMap2D::internal_updateWindow_KernelDM_DMV()
+{
 	// Compute the "parzen Gaussian" once only:
 	// -------------------------------------------------
 	ASSERT_LT_(m_resolution, 0.5 * m_insertOptions_common->cutoffRadius);
 	int Ac_cutoff = round(m_insertOptions_common->cutoffRadius / m_resolution);
 	unsigned Ac_all = 1 + 2 * Ac_cutoff;
-	double minWinValueAtCutOff = exp(-square(
-		m_insertOptions_common->cutoffRadius / m_insertOptions_common->sigma));
 
 	if (m_DM_lastCutOff != m_insertOptions_common->cutoffRadius ||
 		m_DM_gaussWindow.size() != square(Ac_all))
@@ -631,22 +644,42 @@ void CRandomFieldGridMap2D::insertObservation_KernelDM_DMV(
 			"[CRandomFieldGridMap2D::insertObservation_KernelDM_DMV] Done!");
 	}  // end of computing the gauss. window.
 
+	return Ac_cutoff;
+}
+
+void CRandomFieldGridMap2D::internal_fuseReading_KernelDM_DMV(
+	double normReading, const mrpt::math::TPoint2D& point, bool is_DMV,
+	int cy_min, int cy_max)
+{
+	const int Ac_cutoff =
+		round(m_insertOptions_common->cutoffRadius / m_resolution);
+	const int Ac_all = 1 + 2 * Ac_cutoff;
+	const double minWinValueAtCutOff = exp(-square(
+		m_insertOptions_common->cutoffRadius / m_insertOptions_common->sigma));
+
 	//	Fuse with current content of grid (the MEAN of each cell):
 	// --------------------------------------------------------------
 	const int sensor_cx = x2idx(point.x);
 	const int sensor_cy = y2idx(point.y);
-	TRandomFieldCell* cell;
-	auto windowIt = m_DM_gaussWindow.begin();
+
+	// Only the part of the window within [cy_min,cy_max]:
+	const int Acy0 = std::max(-Ac_cutoff, cy_min - sensor_cy);
+	const int Acy1 = std::min(Ac_cutoff, cy_max - sensor_cy);
+	if (Acy0 > Acy1) return;
 
 	for (int Acx = -Ac_cutoff; Acx <= Ac_cutoff; Acx++)
 	{
-		for (int Acy = -Ac_cutoff; Acy <= Ac_cutoff; ++Acy, ++windowIt)
+		const float* window =
+			&m_DM_gaussWindow[(Acx + Ac_cutoff) * Ac_all + Ac_cutoff];
+
+		for (int Acy = Acy0; Acy <= Acy1; ++Acy)
 		{
-			const double windowValue = *windowIt;
+			const double windowValue = window[Acy];
 
 			if (windowValue > minWinValueAtCutOff)
 			{
-				cell = cellByIndex(sensor_cx + Acx, sensor_cy + Acy);
+				TRandomFieldCell* cell =
+					cellByIndex(sensor_cx + Acx, sensor_cy + Acy);
 				ASSERT_(cell != nullptr);
 				cell->dm_mean_w() += windowValue;
 				cell->dm_mean() += windowValue * normReading;
@@ -659,8 +692,6 @@ void CRandomFieldGridMap2D::insertObservation_KernelDM_DMV(
 			}
 		}
 	}
-
-	MRPT_END
 }
 
 /*---------------------------------------------------------------
@@ -694,6 +725,8 @@ void CRandomFieldGridMap2D::TInsertionOptionsCommon::
 		"R_max                                   = %f\n", R_max);
 	out << mrpt::format(
 		"dm_sigma_omega                          = %f\n", dm_sigma_omega);
+	out << mrpt::format(
+		"numThreads                              = %u\n", numThreads);
 
 	out << mrpt::format(
 		"KF_covSigma                             = %f\n", KF_covSigma);
@@ -714,6 +747,9 @@ void CRandomFieldGridMap2D::TInsertionOptionsCommon::
 		"GMRF_lambdaObs                          = %f\n", GMRF_lambdaObs);
 	out << mrpt::format(
 		"GMRF_lambdaObsLoss                      = %f\n", GMRF_lambdaObs);
+	out << mrpt::format(
+		"GMRF_variance_update_radius             = %i\n",
+		GMRF_variance_update_radius);
 
 	out << mrpt::format(
 		"GMRF_use_occupancy_information          = %s\n",
@@ -749,6 +785,7 @@ void CRandomFieldGridMap2D::TInsertionOptionsCommon::
 	R_min = iniFile.read_float(section.c_str(), "R_min", R_min);
 	R_max = iniFile.read_float(section.c_str(), "R_max", R_max);
 	MRPT_LOAD_CONFIG_VAR(dm_sigma_omega, double, iniFile, section);
+	MRPT_LOAD_CONFIG_VAR(numThreads, int, iniFile, section);
 
 	KF_covSigma =
 		iniFile.read_float(section.c_str(), "KF_covSigma", KF_covSigma);
@@ -766,6 +803,7 @@ void CRandomFieldGridMap2D::TInsertionOptionsCommon::
 		iniFile.read_float(section.c_str(), "GMRF_lambdaObs", GMRF_lambdaObs);
 	GMRF_lambdaObsLoss = iniFile.read_float(
 		section.c_str(), "GMRF_lambdaObsLoss", GMRF_lambdaObsLoss);
+	MRPT_LOAD_CONFIG_VAR(GMRF_variance_update_radius, int, iniFile, section);
 
 	GMRF_use_occupancy_information = iniFile.read_bool(
 		section.c_str(), "GMRF_use_occupancy_information", false, false);
@@ -866,6 +904,10 @@ void CRandomFieldGridMap2D::resize(
 	// Do we really resized?
 	if (m_size_x != old_sizeX || m_size_y != old_sizeY)
 	{
+		// Cell indices changed:
+		m_gmrf_observedCells.clear();
+		m_gmrf_updateAllVariances = true;
+
 		// YES:
 		// If we are in a Kalman Filter representation, also build the new
 		// covariance matrix:
@@ -1206,7 +1248,7 @@ void CRandomFieldGridMap2D::insertObservation_KF(
 	// The kalman gain:
 	std::vector<TRandomFieldCell>::iterator it;
 
-	static CTicTac tictac;
+	CTicTac tictac;
 	MRPT_LOG_DEBUG("[insertObservation_KF] Updating mean values...");
 	tictac.Tic();
 
@@ -2209,7 +2251,7 @@ void CRandomFieldGridMap2D::insertObservation_KF2(
 
 	double sk_1 = 1.0 / sk;
 
-	static CTicTac tictac;
+	CTicTac tictac;
 	MRPT_LOG_DEBUG("[insertObservation_KF2] Updating mean values...");
 	tictac.Tic();
 
@@ -2478,6 +2520,83 @@ void CRandomFieldGridMap2D::insertIndividualReading(
 	};
 }
 
+void CRandomFieldGridMap2D::insertIndividualReadings(
+	const std::vector<double>& sensorReadings,
+	const std::vector<mrpt::math::TPoint2D>& points, const bool update_map,
+	const bool time_invariant)
+{
+	MRPT_START
+	ASSERT_EQUAL_(sensorReadings.size(), points.size());
+	const size_t N = points.size();
+
+	if (m_mapType != mrKernelDM && m_mapType != mrKernelDMV)
+	{
+		for (size_t i = 0; i < N; i++)
+			insertIndividualReading(
+				sensorReadings[i], points[i], false, time_invariant);
+		if (update_map && N) updateMapEstimation();
+		return;
+	}
+	if (!N) return;
+
+	// Assure we have room enough in the grid for all the readings at once:
+	static const TRandomFieldCell defCell(0, 0);
+	TPoint2D bbMin = points[0], bbMax = points[0];
+	for (const auto& p : points)
+	{
+		mrpt::keep_min(bbMin.x, p.x);
+		mrpt::keep_min(bbMin.y, p.y);
+		mrpt::keep_max(bbMax.x, p.x);
+		mrpt::keep_max(bbMax.y, p.y);
+	}
+	const double R = m_insertOptions_common->cutoffRadius * 2;
+	resize(bbMin.x - R, bbMax.x + R, bbMin.y - R, bbMax.y + R, defCell);
+
+	const int Ac_cutoff = internal_updateWindow_KernelDM_DMV();
+	const bool is_DMV = (m_mapType == mrKernelDMV);
+
+	// Each thread updates the cells in one band of rows, fusing all the
+	// readings in the same order than a single thread would do:
+	size_t nThreads = m_insertOptions_common->numThreads;
+	if (nThreads == 0) nThreads = std::thread::hardware_concurrency();
+	// Less than this number of cell updates per thread is not worth a thread:
+	constexpr size_t minUpdatesPerThread = 65536;
+	const size_t nUpdates = N * square(1 + 2 * Ac_cutoff);
+	nThreads = std::max<size_t>(
+		1,
+		std::min<size_t>(
+			{nThreads, m_size_y / (1 + Ac_cutoff),
+			 nUpdates / minUpdatesPerThread}));
+
+	std::vector<std::exception_ptr> errors(nThreads);
+	const auto lambdaFuseBand = [&](size_t th) {
+		const int cy_min = static_cast<int>(m_size_y * th / nThreads);
+		const int cy_max = static_cast<int>(m_size_y * (th + 1) / nThreads) - 1;
+		try
+		{
+			for (size_t i = 0; i < N; i++)
+				internal_fuseReading_KernelDM_DMV(
+					sensorReadings[i], points[i], is_DMV, cy_min, cy_max);
+		}
+		catch (...)
+		{
+			errors[th] = std::current_exception();
+		}
+	};
+
+	std::vector<std::thread> threads;
+	for (size_t th = 1; th < nThreads; th++)
+		threads.emplace_back(lambdaFuseBand, th);
+	lambdaFuseBand(0);
+	for (auto& t : threads)
+		t.join();
+
+	for (const auto& e : errors)
+		if (e) std::rethrow_exception(e);
+
+	MRPT_END
+}
+
 /*---------------------------------------------------------------
 					insertObservation_GMRF
   ---------------------------------------------------------------*/
@@ -2503,6 +2622,7 @@ void CRandomFieldGridMap2D::insertObservation_GMRF(
 		m_mrf_factors_activeObs[cellIdx].push_back(new_obs);
 		m_gmrf.addConstraint(
 			*m_mrf_factors_activeObs[cellIdx].rbegin());  // add to graph
+		m_gmrf_observedCells.push_back(cellIdx);
 	}
 	catch (const std::exception& e)
 	{
@@ -2519,27 +2639,56 @@ void CRandomFieldGridMap2D::insertObservation_GMRF(
   ---------------------------------------------------------------*/
 void CRandomFieldGridMap2D::updateMapEstimation_GMRF()
 {
+	const int R = m_insertOptions_common->GMRF_variance_update_radius;
+	const bool skipVariance = m_insertOptions_common->GMRF_skip_variance;
+	const bool allVariances = R < 0 || m_gmrf_updateAllVariances;
+
 	mrpt::math::CVectorDouble x_incr, x_var;
-	m_gmrf.updateEstimation(
-		x_incr, m_insertOptions_common->GMRF_skip_variance ? nullptr : &x_var);
+	std::vector<size_t> varCells;
+	if (skipVariance || allVariances)
+	{
+		m_gmrf.updateEstimation(x_incr, skipVariance ? nullptr : &x_var);
+		ASSERT_(skipVariance || size_t(m_map.size()) == size_t(x_var.size()));
+	}
+	else
+	{
+		// Only the variances around the newly observed cells:
+		for (const size_t idx : m_gmrf_observedCells)
+		{
+			int cx, cy;
+			idx2cxcy(static_cast<int>(idx), cx, cy);
+			for (int y = std::max(0, cy - R);
+				 y <= std::min<int>(m_size_y - 1, cy + R); y++)
+				for (int x = std::max(0, cx - R);
+					 x <= std::min<int>(m_size_x - 1, cx + R); x++)
+					varCells.push_back(x + y * m_size_x);
+		}
+		std::sort(varCells.begin(), varCells.end());
+		varCells.erase(
+			std::unique(varCells.begin(), varCells.end()), varCells.end());
+
+		m_gmrf.updateEstimation(x_incr, varCells, x_var);
+		ASSERT_EQUAL_(varCells.size(), size_t(x_var.size()));
+	}
+	m_gmrf_observedCells.clear();
+	m_gmrf_updateAllVariances = skipVariance;
 
 	ASSERT_(size_t(m_map.size()) == size_t(x_incr.size()));
-	ASSERT_(
-		m_insertOptions_common->GMRF_skip_variance ||
-		size_t(m_map.size()) == size_t(x_var.size()));
 
 	// Update Mean-Variance in the base grid class
 	for (size_t j = 0; j < m_map.size(); j++)
 	{
-		m_map[j].gmrf_std() = m_insertOptions_common->GMRF_skip_variance
-			? .0
-			: std::sqrt(x_var[j]);
+		if (skipVariance) m_map[j].gmrf_std() = .0;
+		else if (allVariances)
+			m_map[j].gmrf_std() = std::sqrt(x_var[j]);
 		m_map[j].gmrf_mean() += x_incr[j];
 
 		mrpt::saturate(
 			m_map[j].gmrf_mean(), m_insertOptions_common->GMRF_saturate_min,
 			m_insertOptions_common->GMRF_saturate_max);
 	}
+	for (size_t k = 0; k < varCells.size(); k++)
+		m_map[varCells[k]].gmrf_std() = std::sqrt(x_var[k]);
 
 	// Update Information/Strength of Active Observations
 	//---------------------------------------------------------
@@ -94,7 +94,7 @@ void CSimplePointsMap::impl_copyFrom(const CPointsMap& obj)
 	CPointsMap::base_copyFrom(obj);
 }
 
-uint8_t CSimplePointsMap::serializeGetVersion() const { return 10; }
+uint8_t CSimplePointsMap::serializeGetVersion() const { return 11; }
 void CSimplePointsMap::serializeTo(mrpt::serialization::CArchive& out) const
 {
 	uint32_t n = m_x.size();
@@ -112,6 +112,7 @@ void CSimplePointsMap::serializeTo(mrpt::serialization::CArchive& out) const
 	insertionOptions.writeToStream(out);  // v9
 	likelihoodOptions.writeToStream(out);  // v5
 	renderOptions.writeToStream(out);  // v10
+	writeLocalSurfaceGeometry(out);	 // v11
 }
 
 /*---------------------------------------------------------------
@@ -127,6 +128,7 @@ void CSimplePointsMap::serializeFrom(
 		case 8:
 		case 9:
 		case 10:
+		case 11:
 		{
 			mark_as_modified();
 
@@ -152,6 +154,7 @@ void CSimplePointsMap::serializeFrom(
 			insertionOptions.readFromStream(in);
 			likelihoodOptions.readFromStream(in);
 			if (version >= 10) renderOptions.readFromStream(in);
+			if (version >= 11) readLocalSurfaceGeometry(in);
 		}
 		break;
 
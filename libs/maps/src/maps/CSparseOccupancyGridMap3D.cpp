@@ -0,0 +1,630 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "maps-precomp.h"  // Precomp header
+//
+#include <mrpt/config/CConfigFileBase.h>
+#include <mrpt/maps/CSimplePointsMap.h>
+#include <mrpt/maps/CSparseOccupancyGridMap3D.h>
+#include <mrpt/obs/CObservation2DRangeScan.h>
+#include <mrpt/obs/CObservation3DRangeScan.h>
+#include <mrpt/opengl/COctoMapVoxels.h>
+#include <mrpt/opengl/CSetOfObjects.h>
+#include <mrpt/poses/CPose3D.h>
+#include <mrpt/serialization/CArchive.h>
+
+using namespace mrpt;
+using namespace mrpt::maps;
+
+//  =========== Begin of Map definition ============
+MAP_DEFINITION_REGISTER(
+	"mrpt::maps::CSparseOccupancyGridMap3D",
+	mrpt::maps::CSparseOccupancyGridMap3D)
+
+CSparseOccupancyGridMap3D::TMapDefinition::TMapDefinition() = default;
+
+void CSparseOccupancyGridMap3D::TMapDefinition::loadFromConfigFile_map_specific(
+	const mrpt::config::CConfigFileBase& source, const std::string& sect)
+{
+	using namespace std::string_literals;
+
+	// [<sect>+"_creationOpts"]
+	const auto sSectCreation = sect + "_creationOpts"s;
+	MRPT_LOAD_CONFIG_VAR(resolution, float, source, sSectCreation);
+
+	// [<sectionName>+"_occupancyGrid_##_insertOpts"]
+	insertionOpts.loadFromConfigFile(source, sect + "_insertOpts"s);
+
+	// [<sectionName>+"_occupancyGrid_##_likelihoodOpts"]
+	likelihoodOpts.loadFromConfigFile(source, sect + "_likelihoodOpts"s);
+}
+
+void CSparseOccupancyGridMap3D::TMapDefinition::dumpToTextStream_map_specific(
+	std::ostream& out) const
+{
+	LOADABLEOPTS_DUMP_VAR(resolution, float);
+
+	this->insertionOpts.dumpToTextStream(out);
+	this->likelihoodOpts.dumpToTextStream(out);
+}
+
+mrpt::maps::CMetricMap*
+	CSparseOccupancyGridMap3D::internal_CreateFromMapDefinition(
+		const mrpt::maps::TMetricMapInitializer& _def)
+{
+	auto& def =
+		dynamic_cast<const CSparseOccupancyGridMap3D::TMapDefinition&>(_def);
+	auto* obj = new CSparseOccupancyGridMap3D(def.resolution);
+	obj->insertionOptions = def.insertionOpts;
+	obj->likelihoodOptions = def.likelihoodOpts;
+	return obj;
+}
+//  =========== End of Map definition Block =========
+
+IMPLEMENTS_SERIALIZABLE(CSparseOccupancyGridMap3D, CMetricMap, mrpt::maps)
+
+// bits to left-shift for fixed-point arithmetic simulation in raytracing.
+static constexpr unsigned FRBITS = 9;
+
+using logodd_t = CLogOddsGridMap3D<CSparseOccupancyGridMap3D::voxelType>;
+
+CSparseOccupancyGridMap3D::CSparseOccupancyGridMap3D(float resolution)
+{
+	setResolution(resolution);
+}
+
+void CSparseOccupancyGridMap3D::setResolution(double resolution)
+{
+	MRPT_START
+	ASSERT_GT_(resolution, 0.0);
+	m_grid.setResolution(resolution, p2l(0.5f));
+	m_is_empty = true;
+	MRPT_END
+}
+
+void CSparseOccupancyGridMap3D::internal_clear()
+{
+	m_grid.clear();
+	m_is_empty = true;
+}
+
+bool CSparseOccupancyGridMap3D::isEmpty() const { return m_is_empty; }
+
+void CSparseOccupancyGridMap3D::OnPostSuccesfulInsertObs(
+	const mrpt::obs::CObservation&)
+{
+	m_is_empty = false;
+}
+
+void CSparseOccupancyGridMap3D::updateCell(int x, int y, int z, float v)
+{
+	voxelType& theCell = m_grid.cellRefByIndexAlloc(x, y, z);
+
+	// Compute the new Bayesian-fused value of the cell:
+	// The observation: will be >0 for free, <0 for occupied.
+	const voxelType obs = p2l(v);
+	if (obs > 0)
+	{
+		// Saturate
+		if (theCell > (logodd_t::CELLTYPE_MAX - obs))
+			theCell = logodd_t::CELLTYPE_MAX;
+		else
+			theCell += obs;
+	}
+	else
+	{
+		// Saturate
+		if (theCell < (logodd_t::CELLTYPE_MIN - obs))
+			theCell = logodd_t::CELLTYPE_MIN;
+		else
+			theCell += obs;
+	}
+}
+
+bool CSparseOccupancyGridMap3D::internal_insertObservation(
+	const mrpt::obs::CObservation& obs,
+	const std::optional<const mrpt::poses::CPose3D>& robotPose)
+{
+	MRPT_START
+
+	const mrpt::poses::CPose3D robotPose3D =
+		(robotPose) ? *robotPose : mrpt::poses::CPose3D();
+
+	if (auto* o = dynamic_cast<const mrpt::obs::CObservation2DRangeScan*>(&obs);
+		o != nullptr)
+	{
+		// Convert to point cloud:
+		mrpt::maps::CSimplePointsMap pts;
+		pts.insertionOptions.also_interpolate = false;
+		pts.insertionOptions.addToExistingPointsMap = true;
+		pts.insertionOptions.disableDeletion = true;
+		pts.insertionOptions.fuseWithExisting = false;
+		pts.insertionOptions.insertInvalidPoints = false;
+		pts.insertionOptions.minDistBetweenLaserPoints = .0;  // insert all
+
+		pts.loadFromRangeScan(*o, robotPose3D);
+
+		const auto sensorPose3D = robotPose3D + o->sensorPose;
+		insertPointCloud(
+			mrpt::math::TPoint3D(sensorPose3D.asTPose()), pts, o->maxRange);
+		return true;
+	}
+	if (auto* o = dynamic_cast<const mrpt::obs::CObservation3DRangeScan*>(&obs);
+		o != nullptr)
+	{
+		// Depth -> 3D points:
+		mrpt::maps::CSimplePointsMap pts;
+		mrpt::obs::T3DPointsProjectionParams pp;
+		pp.takeIntoAccountSensorPoseOnRobot = false;  // done below
+		pp.decimation = insertionOptions.decimation_3d_range;
+
+		const_cast<mrpt::obs::CObservation3DRangeScan&>(*o).unprojectInto(
+			pts, pp);
+
+		const auto sensorPose3D = robotPose3D + o->sensorPose;
+		// Shift everything to its proper pose in the global frame:
+		pts.changeCoordinatesReference(sensorPose3D);
+
+		insertPointCloud(
+			mrpt::math::TPoint3D(sensorPose3D.asTPose()), pts, o->maxRange);
+		return true;
+	}
+
+	return false;
+
+	MRPT_END
+}
+
+void CSparseOccupancyGridMap3D::insertPointCloud(
+	const mrpt::math::TPoint3D& sensorPt, const mrpt::maps::CPointsMap& pts,
+	const float maxValidRange)
+{
+	MRPT_START
+
+	ASSERT_GE_(insertionOptions.decimation, 1);
+
+	const auto& xs = pts.getPointsBufferRef_x();
+	const auto& ys = pts.getPointsBufferRef_y();
+	const auto& zs = pts.getPointsBufferRef_z();
+
+	const double maxValidRange2 = mrpt::square(double(maxValidRange));
+
+	// Process points one by one as rays:
+	for (std::size_t idx = 0; idx < xs.size();
+		 idx += insertionOptions.decimation)
+	{
+		const mrpt::math::TPoint3D pt(xs[idx], ys[idx], zs[idx]);
+		const bool isEcho = (pt - sensorPt).sqrNorm() <= maxValidRange2;
+		insertRay(sensorPt, pt, isEcho);
+	}
+
+	MRPT_END
+}
+
+void CSparseOccupancyGridMap3D::insertRay(
+	const mrpt::math::TPoint3D& sensor, const mrpt::math::TPoint3D& endPt,
+	bool endIsOccupied)
+{
+	MRPT_START
+
+	// Truncate long rays, since the map is unbounded:
+	mrpt::math::TPoint3D end = endPt;
+	const double rayLen = (end - sensor).norm();
+	if (rayLen > insertionOptions.maxDistanceInsertion)
+	{
+		end = sensor +
+			(end - sensor) * (insertionOptions.maxDistanceInsertion / rayLen);
+		endIsOccupied = false;
+	}
+
+	// the occupied and free probabilities:
+	const float maxCertainty = insertionOptions.maxOccupancyUpdateCertainty;
+	float maxFreeCertainty = insertionOptions.maxFreenessUpdateCertainty;
+	if (maxFreeCertainty == .0f) maxFreeCertainty = maxCertainty;
+
+	const voxelType logodd_observation_free =
+		std::max<voxelType>(1, p2l(maxFreeCertainty));
+	const voxelType logodd_observation_occupied =
+		3 * std::max<voxelType>(1, p2l(maxCertainty));
+
+	// saturation limits:
+	const voxelType logodd_thres_occupied =
+		logodd_t::CELLTYPE_MIN + logodd_observation_occupied;
+	const voxelType logodd_thres_free =
+		logodd_t::CELLTYPE_MAX - logodd_observation_free;
+
+	// Start: (in cell index units)
+	int cx = m_grid.x2idx(sensor.x);
+	int cy = m_grid.y2idx(sensor.y);
+	int cz = m_grid.z2idx(sensor.z);
+
+	// End: (in cell index units)
+	const int trg_cx = m_grid.x2idx(end.x);
+	const int trg_cy = m_grid.y2idx(end.y);
+	const int trg_cz = m_grid.z2idx(end.z);
+
+	// Use "fractional integers" to approximate float operations
+	//  during the ray tracing:
+	const int Acx = trg_cx - cx;
+	const int Acy = trg_cy - cy;
+	const int Acz = trg_cz - cz;
+
+	const int Acx_ = std::abs(Acx);
+	const int Acy_ = std::abs(Acy);
+	const int Acz_ = std::abs(Acz);
+
+	const int nStepsRay = mrpt::max3(Acx_, Acy_, Acz_);
+	if (!nStepsRay) return;	 // May be...
+
+	const float N_1 = 1.0f / nStepsRay;
+
+	// Increments at each raytracing step:
+	const int frAcx = (Acx < 0 ? -1 : +1) * mrpt::round((Acx_ << FRBITS) * N_1);
+	const int frAcy = (Acy < 0 ? -1 : +1) * mrpt::round((Acy_ << FRBITS) * N_1);
+	const int frAcz = (Acz < 0 ? -1 : +1) * mrpt::round((Acz_ << FRBITS) * N_1);
+
+	// fractional integers for the running raytracing point:
+	int frCX = cx * (1 << FRBITS);
+	int frCY = cy * (1 << FRBITS);
+	int frCZ = cz * (1 << FRBITS);
+
+	for (int nStep = 0; nStep < nStepsRay; nStep++)
+	{
+		logodd_t::updateCell_fast_free(
+			&m_grid.cellRefByIndexAlloc(cx, cy, cz), logodd_observation_free,
+			logodd_thres_free);
+
+		frCX += frAcx;
+		frCY += frAcy;
+		frCZ += frAcz;
+
+		// (arithmetic shift: rounds towards -inf for negative indices)
+		cx = frCX >> FRBITS;
+		cy = frCY >> FRBITS;
+		cz = frCZ >> FRBITS;
+	}
+
+	// And finally, the occupied cell at the end:
+	if (endIsOccupied)
+		logodd_t::updateCell_fast_occupied(
+			&m_grid.cellRefByIndexAlloc(trg_cx, trg_cy, trg_cz),
+			logodd_observation_occupied, logodd_thres_occupied);
+
+	MRPT_END
+}
+
+double CSparseOccupancyGridMap3D::computeLikelihoodField_Thrun(
+	const CPointsMap& pm, const mrpt::poses::CPose3D& relativePose) const
+{
+	MRPT_START
+
+	const auto& lo = likelihoodOptions;
+	ASSERT_GE_(lo.LF_decimation, 1U);
+
+	const double res = m_grid.getResolution();
+	const int R = static_cast<int>(std::ceil(lo.LF_maxCorrsDistance / res));
+	const double maxCorrDist_sq = mrpt::square(lo.LF_maxCorrsDistance);
+	const double zRandomTerm = lo.LF_zRandom / lo.LF_maxRange;
+	const double Q = -0.5 / mrpt::square(lo.LF_stdHit);
+
+	const auto& xs = pm.getPointsBufferRef_x();
+	const auto& ys = pm.getPointsBufferRef_y();
+	const auto& zs = pm.getPointsBufferRef_z();
+
+	double ret = 0;
+	for (size_t i = 0; i < xs.size(); i += lo.LF_decimation)
+	{
+		const auto pt = relativePose.composePoint(
+			mrpt::math::TPoint3D(xs[i], ys[i], zs[i]));
+		const int cx = m_grid.x2idx(pt.x), cy = m_grid.y2idx(pt.y),
+				  cz = m_grid.z2idx(pt.z);
+
+		// Closest occupied voxel center in the neighborhood:
+		double minDist_sq = maxCorrDist_sq;
+		for (int dz = -R; dz <= R; dz++)
+			for (int dy = -R; dy <= R; dy++)
+				for (int dx = -R; dx <= R; dx++)
+				{
+					const auto* c = m_grid.cellByIndex(cx + dx, cy + dy, cz + dz);
+					if (!c || *c >= 0) continue;  // unknown or free
+					const mrpt::math::TPoint3D center(
+						m_grid.idx2x(cx + dx) + 0.5 * res,
+						m_grid.idx2y(cy + dy) + 0.5 * res,
+						m_grid.idx2z(cz + dz) + 0.5 * res);
+					mrpt::keep_min(minDist_sq, (center - pt).sqrNorm());
+				}
+
+		ret += std::log(zRandomTerm + lo.LF_zHit * std::exp(Q * minDist_sq));
+	}
+	return ret;
+
+	MRPT_END
+}
+
+double CSparseOccupancyGridMap3D::internal_computeObservationLikelihood(
+	const mrpt::obs::CObservation& obs,
+	const mrpt::poses::CPose3D& takenFrom) const
+{
+	MRPT_START
+
+	if (likelihoodOptions.likelihoodMethod !=
+		COccupancyGridMap3D::lmLikelihoodField_Thrun)
+		THROW_EXCEPTION("Only lmLikelihoodField_Thrun is implemented");
+
+	if (auto* o = dynamic_cast<const mrpt::obs::CObservation2DRangeScan*>(&obs);
+		o != nullptr)
+	{
+		const auto* pts = o->buildAuxPointsMap<CPointsMap>();
+		ASSERT_(pts);
+		return computeLikelihoodField_Thrun(*pts, takenFrom);
+	}
+	return .0;
+
+	MRPT_END
+}
+
+bool CSparseOccupancyGridMap3D::internal_canComputeObservationLikelihood(
+	const mrpt::obs::CObservation& obs) const
+{
+	return dynamic_cast<const mrpt::obs::CObservation2DRangeScan*>(&obs) !=
+		nullptr;
+}
+
+void CSparseOccupancyGridMap3D::getAsOctoMapVoxels(
+	mrpt::opengl::COctoMapVoxels& gl_obj) const
+{
+	MRPT_START
+
+	using mrpt::img::TColor;
+	using mrpt::img::TColorf;
+	using namespace mrpt::opengl;
+
+	const TColorf general_color = gl_obj.getColor();
+	const TColor general_color_u = general_color.asTColor();
+
+	gl_obj.clear();
+	gl_obj.resizeVoxelSets(2);	// 2 sets of voxels: occupied & free
+
+	gl_obj.showVoxels(
+		mrpt::opengl::VOXEL_SET_OCCUPIED,
+		renderingOptions.visibleOccupiedVoxels);
+	gl_obj.showVoxels(
+		mrpt::opengl::VOXEL_SET_FREESPACE, renderingOptions.visibleFreeVoxels);
+
+	const double res = m_grid.getResolution();
+	const double L = 0.5 * res;
+
+	// 1st pass: bounding box of observed voxels, for the height colormap:
+	mrpt::math::TPoint3D bbmin(0, 0, 0), bbmax(0, 0, 0);
+	bool first = true;
+	for (const auto& kv : m_grid.blocks())
+	{
+		int cx0, cy0, cz0;
+		grid_t::blockKeyToFirstVoxel(kv.first, cx0, cy0, cz0);
+		const mrpt::math::TPoint3D p0(
+			m_grid.idx2x(cx0), m_grid.idx2y(cy0), m_grid.idx2z(cz0));
+		const mrpt::math::TPoint3D p1 = p0 +
+			mrpt::math::TPoint3D(1, 1, 1) * (res * grid_t::BLOCK_SIDE);
+		if (first)
+		{
+			bbmin = p0;
+			bbmax = p1;
+			first = false;
+		}
+		mrpt::keep_min(bbmin.x, p0.x);
+		mrpt::keep_min(bbmin.y, p0.y);
+		mrpt::keep_min(bbmin.z, p0.z);
+		mrpt::keep_max(bbmax.x, p1.x);
+		mrpt::keep_max(bbmax.y, p1.y);
+		mrpt::keep_max(bbmax.z, p1.z);
+	}
+	const float inv_dz = 1.0f / d2f(bbmax.z - bbmin.z + 0.01f);
+
+	m_grid.forEachAllocatedVoxel([&](int cx, int cy, int cz,
+									 const voxelType& v) {
+		const float occ = 1.0f - l2p(v);
+		const bool is_occupied = occ > 0.501f;
+		const bool is_free = occ < 0.499f;
+		// voxel center coordinates:
+		const double x = m_grid.idx2x(cx) + L;
+		const double y = m_grid.idx2y(cy) + L;
+		const double z = m_grid.idx2z(cz) + L;
+
+		if ((is_occupied && renderingOptions.generateOccupiedVoxels) ||
+			(is_free && renderingOptions.generateFreeVoxels))
+		{
+			mrpt::img::TColor vx_color;
+			float coefc, coeft;
+			switch (gl_obj.getVisualizationMode())
+			{
+				case COctoMapVoxels::FIXED: vx_color = general_color_u; break;
+				case COctoMapVoxels::COLOR_FROM_HEIGHT:
+					coefc = 255 * inv_dz * d2f(z - bbmin.z);
+					vx_color = TColor(
+						f2u8(coefc * general_color.R),
+						f2u8(coefc * general_color.G),
+						f2u8(coefc * general_color.B),
+						f2u8(255 * general_color.A));
+					break;
+
+				case COctoMapVoxels::COLOR_FROM_OCCUPANCY:
+					coefc = 240 * (1 - occ) + 15;
+					vx_color = TColor(
+						f2u8(coefc * general_color.R),
+						f2u8(coefc * general_color.G),
+						f2u8(coefc * general_color.B),
+						f2u8(255 * general_color.A));
+					break;
+
+				case COctoMapVoxels::TRANSPARENCY_FROM_OCCUPANCY:
+					coeft = 255 - 510 * (1 - occ);
+					if (coeft < 0) { coeft = 0; }
+					vx_color = general_color.asTColor();
+					vx_color.A = mrpt::round(coeft);
+					break;
+
+				case COctoMapVoxels::TRANS_AND_COLOR_FROM_OCCUPANCY:
+					coefc = 240 * (1 - occ) + 15;
+					vx_color = TColor(
+						f2u8(coefc * general_color.R),
+						f2u8(coefc * general_color.G),
+						f2u8(coefc * general_color.B), 50);
+					break;
+
+				case COctoMapVoxels::MIXED:
+					coefc = d2f(255 * inv_dz * (z - bbmin.z));
+					coeft = d2f(255 - 510 * (1 - occ));
+					if (coeft < 0) { coeft = 0; }
+					vx_color = TColor(
+						f2u8(coefc * general_color.R),
+						f2u8(coefc * general_color.G),
+						f2u8(coefc * general_color.B),
+						static_cast<uint8_t>(coeft));
+					break;
+
+				default: THROW_EXCEPTION("Unknown coloring scheme!");
+			}
+
+			const size_t vx_set =
+				is_occupied ? VOXEL_SET_OCCUPIED : VOXEL_SET_FREESPACE;
+
+			gl_obj.push_back_Voxel(
+				vx_set,
+				COctoMapVoxels::TVoxel(
+					mrpt::math::TPoint3D(x, y, z), 2 * L, vx_color));
+		}
+
+		if (renderingOptions.generateGridLines && (is_occupied || is_free))
+		{
+			const mrpt::math::TPoint3D pt_min(x - L, y - L, z - L);
+			const mrpt::math::TPoint3D pt_max(x + L, y + L, z + L);
+			gl_obj.push_back_GridCube(
+				COctoMapVoxels::TGridCube(pt_min, pt_max));
+		}
+	});
+
+	// if we use transparency, sort cubes by "Z" as an approximation to
+	// far-to-near render ordering:
+	if (gl_obj.isCubeTransparencyEnabled()) gl_obj.sort_voxels_by_z();
+
+	// Set bounding box:
+	gl_obj.setBoundingBox(bbmin, bbmax);
+
+	MRPT_END
+}
+
+void CSparseOccupancyGridMap3D::getVisualizationInto(
+	mrpt::opengl::CSetOfObjects& o) const
+{
+	auto gl_obj = mrpt::opengl::COctoMapVoxels::Create();
+	this->getAsOctoMapVoxels(*gl_obj);
+	o.insert(gl_obj);
+}
+
+uint8_t CSparseOccupancyGridMap3D::serializeGetVersion() const { return 0; }
+void CSparseOccupancyGridMap3D::serializeTo(
+	mrpt::serialization::CArchive& out) const
+{
+#ifdef OCCUPANCY_GRIDMAP_CELL_SIZE_8BITS
+	out << uint8_t(8);
+#else
+	out << uint8_t(16);
+#endif
+
+	m_grid.writeToStream(
+		out,
+		[](mrpt::serialization::CArchive& a, const voxelType* p, size_t n) {
+#ifdef OCCUPANCY_GRIDMAP_CELL_SIZE_8BITS
+			a.WriteBuffer(p, sizeof(voxelType) * n);
+#else
+			a.WriteBufferFixEndianness(p, n);
+#endif
+		});
+
+	// insertionOptions:
+	out << insertionOptions.maxDistanceInsertion
+		<< insertionOptions.maxOccupancyUpdateCertainty
+		<< insertionOptions.maxFreenessUpdateCertainty
+		<< insertionOptions.decimation << insertionOptions.decimation_3d_range;
+
+	// Likelihood:
+	out.WriteAs<int32_t>(likelihoodOptions.likelihoodMethod);
+	out << likelihoodOptions.LF_stdHit << likelihoodOptions.LF_zHit
+		<< likelihoodOptions.LF_zRandom << likelihoodOptions.LF_maxRange
+		<< likelihoodOptions.LF_decimation
+		<< likelihoodOptions.LF_maxCorrsDistance
+		<< likelihoodOptions.LF_useSquareDist
+		<< likelihoodOptions.rayTracing_decimation
+		<< likelihoodOptions.rayTracing_stdHit;
+
+	out << genericMapParams;
+
+	renderingOptions.writeToStream(out);
+}
+
+void CSparseOccupancyGridMap3D::serializeFrom(
+	mrpt::serialization::CArchive& in, uint8_t version)
+{
+	switch (version)
+	{
+		case 0:
+		{
+			uint8_t bitsPerCellStream;
+			in >> bitsPerCellStream;
+
+#ifdef OCCUPANCY_GRIDMAP_CELL_SIZE_8BITS
+			ASSERT_(bitsPerCellStream == 8);
+#else
+			ASSERT_(bitsPerCellStream == 16);
+#endif
+
+			m_grid.readFromStream(
+				in, p2l(0.5f),
+				[](mrpt::serialization::CArchive& a, voxelType* p, size_t n) {
+#ifdef OCCUPANCY_GRIDMAP_CELL_SIZE_8BITS
+					a.ReadBuffer(p, sizeof(voxelType) * n);
+#else
+					a.ReadBufferFixEndianness(p, n);
+#endif
+				});
+			m_is_empty = m_grid.getBlockCount() == 0;
+
+			// insertionOptions:
+			in >> insertionOptions.maxDistanceInsertion >>
+				insertionOptions.maxOccupancyUpdateCertainty >>
+				insertionOptions.maxFreenessUpdateCertainty >>
+				insertionOptions.decimation >>
+				insertionOptions.decimation_3d_range;
+
+			// Likelihood:
+			in.ReadAsAndCastTo<int32_t, COccupancyGridMap3D::TLikelihoodMethod>(
+				likelihoodOptions.likelihoodMethod);
+
+			in >> likelihoodOptions.LF_stdHit >> likelihoodOptions.LF_zHit >>
+				likelihoodOptions.LF_zRandom >> likelihoodOptions.LF_maxRange >>
+				likelihoodOptions.LF_decimation >>
+				likelihoodOptions.LF_maxCorrsDistance >>
+				likelihoodOptions.LF_useSquareDist >>
+				likelihoodOptions.rayTracing_decimation >>
+				likelihoodOptions.rayTracing_stdHit;
+
+			in >> genericMapParams;
+
+			renderingOptions.readFromStream(in);
+		}
+		break;
+		default: MRPT_THROW_UNKNOWN_SERIALIZATION_VERSION(version);
+	};
+}
+
+void CSparseOccupancyGridMap3D::saveMetricMapRepresentationToFile(
+	[[maybe_unused]] const std::string& filNamePrefix) const
+{
+	// todo
+}
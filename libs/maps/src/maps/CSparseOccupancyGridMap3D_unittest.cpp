@@ -0,0 +1,101 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/io/CMemoryStream.h>
+#include <mrpt/maps/CSimplePointsMap.h>
+#include <mrpt/maps/CSparseOccupancyGridMap3D.h>
+#include <mrpt/obs/CObservation2DRangeScan.h>
+#include <mrpt/obs/stock_observations.h>
+#include <mrpt/serialization/CArchive.h>
+
+TEST(CSparseOccupancyGridMap3DTests, insert2DScan)
+{
+	mrpt::obs::CObservation2DRangeScan scan1;
+	mrpt::obs::stock_observations::example2DRangeScan(scan1);
+
+	mrpt::maps::CSparseOccupancyGridMap3D grid(0.10f);
+	EXPECT_TRUE(grid.isEmpty());
+	grid.insertObservation(scan1);
+	EXPECT_FALSE(grid.isEmpty());
+
+	// A cell in front of the laser should have a high "freeness"
+	EXPECT_GT(grid.getFreenessByPos(0.5, 0, 0), 0.53f);
+	// Never observed:
+	EXPECT_EQ(grid.getFreenessByPos(0.5, 0, 3.0), 0.5f);
+
+	// The same scan, as seen by a dense grid:
+	mrpt::maps::COccupancyGridMap3D dense(
+		{-20.0, -20.0, -1.0}, {20.0, 20.0, 1.0}, 0.10f);
+	dense.insertObservation(scan1);
+	EXPECT_NEAR(
+		grid.getFreenessByPos(0.5, 0, 0), dense.getFreenessByPos(0.5, 0, 0),
+		0.05f);
+}
+
+TEST(CSparseOccupancyGridMap3DTests, memoryTracksObservedVolume)
+{
+	mrpt::maps::CSparseOccupancyGridMap3D grid(0.10f);
+	grid.insertionOptions.maxDistanceInsertion = 5.0f;
+
+	// Two short rays, 1 km apart: a dense grid would need ~1e9 voxels.
+	grid.insertRay({0.05, 0.05, 0.05}, {2.05, 0.05, 0.05});
+	grid.insertRay({1000.05, -999.95, 100.05}, {1000.05, -997.95, 100.05});
+
+	EXPECT_LT(grid.getFreenessByPos(2.05, 0.05, 0.05), 0.5f);
+	EXPECT_GT(grid.getFreenessByPos(1.05, 0.05, 0.05), 0.5f);
+	EXPECT_LT(grid.getFreenessByPos(1000.05, -997.95, 100.05), 0.5f);
+	EXPECT_GT(grid.getFreenessByPos(1000.05, -998.95, 100.05), 0.5f);
+
+	// 21 voxels per ray, 8 voxels per block:
+	EXPECT_LE(grid.grid().getBlockCount(), 8U);
+
+	// Rays longer than maxDistanceInsertion are truncated, with no hit:
+	grid.insertRay({0.05, 5.05, 0.05}, {0.05, 50.05, 0.05});
+	EXPECT_EQ(grid.getFreenessByPos(0.05, 50.05, 0.05), 0.5f);
+	EXPECT_GT(grid.getFreenessByPos(0.05, 9.05, 0.05), 0.5f);
+}
+
+TEST(CSparseOccupancyGridMap3DTests, serialization)
+{
+	mrpt::obs::CObservation2DRangeScan scan1;
+	mrpt::obs::stock_observations::example2DRangeScan(scan1);
+
+	mrpt::maps::CSparseOccupancyGridMap3D grid(0.10f);
+	grid.insertObservation(scan1);
+
+	mrpt::io::CMemoryStream buf;
+	auto arch = mrpt::serialization::archiveFrom(buf);
+	arch << grid;
+	buf.Seek(0);
+
+	mrpt::maps::CSparseOccupancyGridMap3D grid2;
+	arch >> grid2;
+
+	EXPECT_EQ(grid2.getResolution(), grid.getResolution());
+	EXPECT_EQ(grid2.grid().getBlockCount(), grid.grid().getBlockCount());
+	grid.grid().forEachAllocatedVoxel([&](int cx, int cy, int cz, auto v) {
+		EXPECT_EQ(grid2.getCellFreeness(cx, cy, cz), grid.l2p(v));
+	});
+}
+
+TEST(CSparseOccupancyGridMap3DTests, likelihoodField)
+{
+	mrpt::obs::CObservation2DRangeScan scan1;
+	mrpt::obs::stock_observations::example2DRangeScan(scan1);
+
+	mrpt::maps::CSparseOccupancyGridMap3D grid(0.05f);
+	grid.insertObservation(scan1);
+
+	const double likGT =
+		grid.computeObservationLikelihood(scan1, mrpt::poses::CPose3D());
+	const double likOff = grid.computeObservationLikelihood(
+		scan1, mrpt::poses::CPose3D(0.2, 0.1, 0, 0.1, 0, 0));
+	EXPECT_GT(likGT, likOff);
+}
@@ -0,0 +1,407 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "maps-precomp.h"  // Precomp header
+//
+#include <mrpt/io/CFileStream.h>
+#include <mrpt/maps/CTiledOccupancyGridMap2D.h>
+#include <mrpt/system/filesystem.h>
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#elif !MRPT_IN_EMSCRIPTEN
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define TILEDGRID_HAS_MMAP
+#endif
+
+using namespace mrpt::maps;
+
+// ---------------------------------------------------------------------------
+//  Tile file: an array of fixed-size slots, memory-mapped and grown on demand
+// ---------------------------------------------------------------------------
+struct CTiledOccupancyGridMap2D::TileFile
+{
+	TileFile(const std::string& file, size_t bytesPerSlot)
+		: fileName(file.empty() ? mrpt::system::getTempFileName() : file),
+		  isTemporary(file.empty()),
+		  slotBytes(bytesPerSlot)
+	{
+	}
+	~TileFile()
+	{
+		close();
+		if (isTemporary) mrpt::system::deleteFile(fileName);
+	}
+
+	const std::string fileName;
+	const bool isTemporary;
+	const size_t slotBytes;
+	size_t capacity = 0;  //!< Number of slots in the mapped file
+	size_t used = 0;  //!< Number of slots assigned to a tile
+
+	uint8_t* mapped = nullptr;
+#if defined(_WIN32)
+	HANDLE hFile = INVALID_HANDLE_VALUE, hMap = nullptr;
+#elif defined(TILEDGRID_HAS_MMAP)
+	int fd = -1;
+#endif
+	// Fallback if memory mapping is not available:
+	mrpt::io::CFileStream f;
+	bool opened = false;
+
+	void open()
+	{
+		if (opened) return;
+#if defined(_WIN32)
+		hFile = CreateFileA(
+			fileName.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr,
+			CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+		ASSERTMSG_(
+			hFile != INVALID_HANDLE_VALUE,
+			"Cannot create tile file: " + fileName);
+#elif defined(TILEDGRID_HAS_MMAP)
+		fd = ::open(fileName.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+		ASSERTMSG_(fd >= 0, "Cannot create tile file: " + fileName);
+#else
+		ASSERTMSG_(
+			f.open(fileName, mrpt::io::fomRead | mrpt::io::fomWrite),
+			"Cannot create tile file: " + fileName);
+#endif
+		opened = true;
+	}
+
+	void unmap()
+	{
+		if (!mapped) return;
+#if defined(_WIN32)
+		UnmapViewOfFile(mapped);
+		CloseHandle(hMap);
+		hMap = nullptr;
+#elif defined(TILEDGRID_HAS_MMAP)
+		::munmap(mapped, capacity * slotBytes);
+#endif
+		mapped = nullptr;
+	}
+
+	/** Grows the file (if needed) and maps it again */
+	void reserve(size_t nSlots)
+	{
+		if (nSlots <= capacity) return;
+		open();
+		const size_t newCapacity = std::max<size_t>(nSlots, 2 * capacity);
+		[[maybe_unused]] const uint64_t newSize =
+			static_cast<uint64_t>(newCapacity) * slotBytes;
+		unmap();
+#if defined(_WIN32)
+		hMap = CreateFileMappingA(
+			hFile, nullptr, PAGE_READWRITE, static_cast<DWORD>(newSize >> 32),
+			static_cast<DWORD>(newSize & 0xffffffff), nullptr);
+		ASSERTMSG_(hMap, "Cannot grow tile file: " + fileName);
+		mapped = static_cast<uint8_t*>(
+			MapViewOfFile(hMap, FILE_MAP_ALL_ACCESS, 0, 0, 0));
+#elif defined(TILEDGRID_HAS_MMAP)
+		ASSERTMSG_(
+			::ftruncate(fd, static_cast<off_t>(newSize)) == 0,
+			"Cannot grow tile file: " + fileName);
+		void* p = ::mmap(
+			nullptr, static_cast<size_t>(newSize), PROT_READ | PROT_WRITE,
+			MAP_SHARED, fd, 0);
+		if (p != MAP_FAILED) mapped = static_cast<uint8_t*>(p);
+#endif
+		ASSERTMSG_(mapped, "Cannot map tile file: " + fileName);
+		capacity = newCapacity;
+	}
+
+	size_t newSlot()
+	{
+#if defined(_WIN32) || defined(TILEDGRID_HAS_MMAP)
+		reserve(used + 1);
+#else
+		open();
+#endif
+		return used++;
+	}
+
+	void write(size_t slot, const void* data)
+	{
+		if (mapped)
+		{
+			std::memcpy(mapped + slot * slotBytes, data, slotBytes);
+			return;
+		}
+		f.Seek(static_cast<int64_t>(slot * slotBytes));
+		ASSERT_EQUAL_(f.Write(data, slotBytes), slotBytes);
+	}
+
+	void read(size_t slot, void* data)
+	{
+		if (mapped)
+		{
+			std::memcpy(data, mapped + slot * slotBytes, slotBytes);
+			return;
+		}
+		f.Seek(static_cast<int64_t>(slot * slotBytes));
+		ASSERT_EQUAL_(f.Read(data, slotBytes), slotBytes);
+	}
+
+	void close()
+	{
+		unmap();
+#if defined(_WIN32)
+		if (hFile != INVALID_HANDLE_VALUE) CloseHandle(hFile);
+		hFile = INVALID_HANDLE_VALUE;
+#elif defined(TILEDGRID_HAS_MMAP)
+		if (fd >= 0) ::close(fd);
+		fd = -1;
+#endif
+		if (f.fileOpenCorrectly()) f.close();
+		opened = false;
+		capacity = used = 0;
+	}
+};
+
+// ---------------------------------------------------------------------------
+//  CTiledOccupancyGridMap2D
+// ---------------------------------------------------------------------------
+CTiledOccupancyGridMap2D::CTiledOccupancyGridMap2D(
+	float resolution, unsigned int tileSize, size_t maxTiles,
+	const std::string& tileFile)
+	: maxTilesInMemory(maxTiles),
+	  m_resolution(resolution),
+	  m_tileSize(tileSize),
+	  m_tileSizeInt(static_cast<int>(tileSize))
+{
+	ASSERT_GT_(resolution, 0);
+	ASSERT_GE_(tileSize, 8U);
+	ASSERT_LE_(tileSize, 4096U);
+	m_file = std::make_unique<TileFile>(
+		tileFile, sizeof(cellType) * tileSize * tileSize);
+}
+
+CTiledOccupancyGridMap2D::~CTiledOccupancyGridMap2D() = default;
+
+void CTiledOccupancyGridMap2D::clear()
+{
+	m_tiles.clear();
+	m_lru.clear();
+	m_tileSlots.clear();
+	m_lastTile = nullptr;
+	m_file->close();
+}
+
+size_t CTiledOccupancyGridMap2D::getTileCount() const
+{
+	size_t n = m_tileSlots.size();
+	// Tiles in memory never paged out:
+	for (const auto& kv : m_tiles)
+		if (m_tileSlots.count(kv.first) == 0) n++;
+	return n;
+}
+
+size_t CTiledOccupancyGridMap2D::getTileCountOnDisk() const
+{
+	size_t n = 0;
+	for (const auto& kv : m_tileSlots)
+		if (m_tiles.count(kv.first) == 0) n++;
+	return n;
+}
+
+void CTiledOccupancyGridMap2D::makeRoomForOneTile() const
+{
+	const size_t maxTiles = std::max<size_t>(1, maxTilesInMemory);
+	while (!m_lru.empty() && m_tiles.size() >= maxTiles)
+	{
+		const tile_key_t key = m_lru.back();
+		auto it = m_tiles.find(key);
+		ASSERT_(it != m_tiles.end());
+		if (it->second.dirty)
+		{
+			auto itSlot = m_tileSlots.find(key);
+			if (itSlot == m_tileSlots.end())
+				itSlot = m_tileSlots.emplace(key, m_file->newSlot()).first;
+			m_file->write(itSlot->second, it->second.cells->data());
+		}
+		if (m_lastTile == &it->second) m_lastTile = nullptr;
+		m_tiles.erase(it);
+		m_lru.pop_back();
+	}
+}
+
+CTiledOccupancyGridMap2D::TTileInMemory* CTiledOccupancyGridMap2D::findTile(
+	tile_key_t key, bool allocate) const
+{
+	TTileInMemory* t = nullptr;
+	if (auto it = m_tiles.find(key); it != m_tiles.end())
+	{
+		t = &it->second;
+		// Most recently used:
+		m_lru.splice(m_lru.begin(), m_lru, t->lruIt);
+	}
+	else
+	{
+		const auto itSlot = m_tileSlots.find(key);
+		if (itSlot == m_tileSlots.end() && !allocate) return nullptr;
+
+		makeRoomForOneTile();
+
+		t = &m_tiles[key];
+		t->cells = std::make_unique<tile_t>(m_tileSize * m_tileSize);
+		if (itSlot != m_tileSlots.end())
+		{
+			// Page in:
+			m_file->read(itSlot->second, t->cells->data());
+			t->dirty = false;
+		}
+		else
+		{
+			// New tile, all unknown:
+			std::fill(
+				t->cells->begin(), t->cells->end(),
+				COccupancyGridMap2D::p2l(0.5f));
+			t->dirty = true;
+		}
+		m_lru.push_front(key);
+		t->lruIt = m_lru.begin();
+	}
+	m_lastKey = key;
+	m_lastTile = t;
+	return t;
+}
+
+void CTiledOccupancyGridMap2D::updateCell(int cx, int cy, float v)
+{
+	constexpr cellType CELLTYPE_MIN = COccupancyGridMap2D::OCCGRID_CELLTYPE_MIN;
+	constexpr cellType CELLTYPE_MAX = COccupancyGridMap2D::OCCGRID_CELLTYPE_MAX;
+
+	cellType& theCell = *cellPtr(cx, cy, true);
+	// The observation: will be >0 for free, <0 for occupied.
+	const cellType obs = COccupancyGridMap2D::p2l(v);
+	if (obs > 0)
+	{
+		if (theCell > (CELLTYPE_MAX - obs)) theCell = CELLTYPE_MAX;	 // Saturate
+		else
+			theCell += obs;
+	}
+	else
+	{
+		if (theCell < (CELLTYPE_MIN - obs)) theCell = CELLTYPE_MIN;	 // Saturate
+		else
+			theCell += obs;
+	}
+}
+
+void CTiledOccupancyGridMap2D::extractWindow(
+	COccupancyGridMap2D& out, float x_min, float x_max, float y_min,
+	float y_max) const
+{
+	MRPT_START
+	ASSERT_GT_(x_max, x_min);
+	ASSERT_GT_(y_max, y_min);
+
+	const int cx0 = x2idx(x_min), cy0 = y2idx(y_min);
+	const int cx1 = x2idx(x_max - 0.5f * m_resolution),
+			  cy1 = y2idx(y_max - 0.5f * m_resolution);
+	out.setSize(
+		cx0 * m_resolution, (cx1 + 1) * m_resolution, cy0 * m_resolution,
+		(cy1 + 1) * m_resolution, m_resolution, 0.5f);
+
+	// setSize() may round the limits or pad the rows:
+	const int ocx0 = x2idx(out.getXMin() + 0.5f * m_resolution);
+	const int ocy0 = y2idx(out.getYMin() + 0.5f * m_resolution);
+	const int nx = static_cast<int>(out.getSizeX());
+	const int ny = static_cast<int>(out.getSizeY());
+
+	// Copy tile by tile, row segment by row segment:
+	for (int ty = floorDiv(ocy0); ty <= floorDiv(ocy0 + ny - 1); ty++)
+	{
+		for (int tx = floorDiv(ocx0); tx <= floorDiv(ocx0 + nx - 1); tx++)
+		{
+			const TTileInMemory* t = findTile(tileKey(tx, ty), false);
+			if (!t) continue;  // Unknown, as already set by setSize()
+			const tile_t& cells = *t->cells;
+
+			const int gx0 = std::max(ocx0, tx * m_tileSizeInt);
+			const int gx1 =
+				std::min(ocx0 + nx - 1, (tx + 1) * m_tileSizeInt - 1);
+			const int gy0 = std::max(ocy0, ty * m_tileSizeInt);
+			const int gy1 =
+				std::min(ocy0 + ny - 1, (ty + 1) * m_tileSizeInt - 1);
+			for (int gy = gy0; gy <= gy1; gy++)
+			{
+				cellType* dst = out.getRow(gy - ocy0) + (gx0 - ocx0);
+				const cellType* src = &cells
+					[(gx0 - tx * m_tileSizeInt) +
+					 (gy - ty * m_tileSizeInt) * m_tileSizeInt];
+				std::copy(src, src + (gx1 - gx0 + 1), dst);
+			}
+		}
+	}
+	MRPT_END
+}
+
+void CTiledOccupancyGridMap2D::storeWindow(const COccupancyGridMap2D& grid)
+{
+	MRPT_START
+	ASSERTMSG_(
+		std::abs(grid.getResolution() - m_resolution) < 1e-4f * m_resolution,
+		"Grid and tiled map resolutions do not match");
+
+	const int ocx0 = x2idx(grid.getXMin() + 0.5f * m_resolution);
+	const int ocy0 = y2idx(grid.getYMin() + 0.5f * m_resolution);
+	const int nx = static_cast<int>(grid.getSizeX());
+	const int ny = static_cast<int>(grid.getSizeY());
+	if (!nx || !ny) return;
+	const cellType unknown = COccupancyGridMap2D::p2l(0.5f);
+
+	for (int ty = floorDiv(ocy0); ty <= floorDiv(ocy0 + ny - 1); ty++)
+	{
+		for (int tx = floorDiv(ocx0); tx <= floorDiv(ocx0 + nx - 1); tx++)
+		{
+			const int gx0 = std::max(ocx0, tx * m_tileSizeInt);
+			const int gx1 =
+				std::min(ocx0 + nx - 1, (tx + 1) * m_tileSizeInt - 1);
+			const int gy0 = std::max(ocy0, ty * m_tileSizeInt);
+			const int gy1 =
+				std::min(ocy0 + ny - 1, (ty + 1) * m_tileSizeInt - 1);
+
+			TTileInMemory* t = findTile(tileKey(tx, ty), false);
+			if (!t)
+			{
+				// Do not allocate new tiles for unknown areas:
+				bool allUnknown = true;
+				for (int gy = gy0; allUnknown && gy <= gy1; gy++)
+				{
+					const cellType* src = grid.getRow(gy - ocy0) + (gx0 - ocx0);
+					allUnknown = std::all_of(
+						src, src + (gx1 - gx0 + 1),
+						[unknown](cellType c) { return c == unknown; });
+				}
+				if (allUnknown) continue;
+				t = findTile(tileKey(tx, ty), true);
+			}
+			t->dirty = true;
+			tile_t& cells = *t->cells;
+			for (int gy = gy0; gy <= gy1; gy++)
+			{
+				const cellType* src = grid.getRow(gy - ocy0) + (gx0 - ocx0);
+				cellType* dst = &cells
+					[(gx0 - tx * m_tileSizeInt) +
+					 (gy - ty * m_tileSizeInt) * m_tileSizeInt];
+				std::copy(src, src + (gx1 - gx0 + 1), dst);
+			}
+		}
+	}
+	MRPT_END
+}
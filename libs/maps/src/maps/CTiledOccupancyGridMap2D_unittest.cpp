@@ -0,0 +1,97 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/maps/CTiledOccupancyGridMap2D.h>
+
+using mrpt::maps::COccupancyGridMap2D;
+using mrpt::maps::CTiledOccupancyGridMap2D;
+
+TEST(CTiledOccupancyGridMap2D, setGetCells)
+{
+	CTiledOccupancyGridMap2D map(0.1f, 16);
+	EXPECT_NEAR(map.getCell(-1000, 2000), 0.5f, 0.01f);
+	EXPECT_EQ(map.getTileCount(), 0U);
+
+	map.setCell(-1, -1, 0.9f);
+	map.setCell(15, 0, 0.1f);
+	map.setCell(16, 0, 0.2f);
+	EXPECT_EQ(map.getTileCount(), 3U);
+	EXPECT_NEAR(map.getCell(-1, -1), 0.9f, 0.01f);
+	EXPECT_NEAR(map.getCell(15, 0), 0.1f, 0.01f);
+	EXPECT_NEAR(map.getCell(16, 0), 0.2f, 0.01f);
+	EXPECT_NEAR(map.getCell(0, 0), 0.5f, 0.01f);
+
+	EXPECT_EQ(map.x2idx(-0.05), -1);
+	EXPECT_NEAR(map.getPos(-0.05f, -0.05f), 0.9f, 0.01f);
+
+	// Same saturation than COccupancyGridMap2D:
+	COccupancyGridMap2D grid(0, 1, 0, 1, 0.1f);
+	for (int i = 0; i < 100; i++)
+	{
+		map.updateCell(3, 3, 0.2f);
+		grid.updateCell(3, 3, 0.2f);
+	}
+	EXPECT_EQ(map.getCell(3, 3), grid.getCell(3, 3));
+}
+
+TEST(CTiledOccupancyGridMap2D, pageOutAndIn)
+{
+	const int T = 8, N = 10;
+	CTiledOccupancyGridMap2D map(0.1f, T, 2 /* max tiles in memory*/);
+
+	const auto value = [](int x, int y) {
+		return 0.05f + 0.09f * ((x * 7 + y * 13 + 1000) % 10);
+	};
+	for (int ty = -N; ty < N; ty++)
+		for (int tx = -N; tx < N; tx++)
+			map.setCell(tx * T + 3, ty * T + 5, value(tx, ty));
+
+	EXPECT_EQ(map.getTileCount(), static_cast<size_t>(4 * N * N));
+	EXPECT_LE(map.getTileCountInMemory(), 2U);
+	EXPECT_EQ(
+		map.getTileCountOnDisk() + map.getTileCountInMemory(),
+		map.getTileCount());
+
+	for (int ty = -N; ty < N; ty++)
+		for (int tx = -N; tx < N; tx++)
+		{
+			EXPECT_NEAR(
+				map.getCell(tx * T + 3, ty * T + 5), value(tx, ty), 0.01f);
+			EXPECT_NEAR(map.getCell(tx * T, ty * T), 0.5f, 0.01f);
+		}
+
+	map.clear();
+	EXPECT_EQ(map.getTileCount(), 0U);
+	EXPECT_NEAR(map.getCell(3, 5), 0.5f, 0.01f);
+}
+
+TEST(CTiledOccupancyGridMap2D, extractStoreWindow)
+{
+	CTiledOccupancyGridMap2D map(0.1f, 16, 3);
+	map.setPos(-2.05f, 1.05f, 0.1f);
+	map.setPos(3.05f, -1.05f, 0.8f);
+
+	COccupancyGridMap2D grid;
+	map.extractWindow(grid, -3.0f, 4.0f, -2.0f, 2.0f);
+	EXPECT_NEAR(grid.getResolution(), 0.1f, 1e-6f);
+	EXPECT_NEAR(grid.getPos(-2.05f, 1.05f), 0.1f, 0.01f);
+	EXPECT_NEAR(grid.getPos(3.05f, -1.05f), 0.8f, 0.01f);
+	EXPECT_NEAR(grid.getPos(0.55f, 0.55f), 0.5f, 0.01f);
+
+	const size_t nTiles = map.getTileCount();
+	grid.setPos(0.55f, 0.55f, 0.3f);
+	grid.setPos(-2.05f, 1.05f, 0.7f);
+	map.storeWindow(grid);
+	// Only the tile of (0.55,0.55) is new:
+	EXPECT_EQ(map.getTileCount(), nTiles + 1);
+	EXPECT_NEAR(map.getPos(0.55f, 0.55f), 0.3f, 0.01f);
+	EXPECT_NEAR(map.getPos(-2.05f, 1.05f), 0.7f, 0.01f);
+	EXPECT_NEAR(map.getPos(3.05f, -1.05f), 0.8f, 0.01f);
+}
@@ -136,7 +136,7 @@ void CWeightedPointsMap::addFrom_classSpecific(
 	}
 }
 
-uint8_t CWeightedPointsMap::serializeGetVersion() const { return 2; }
+uint8_t CWeightedPointsMap::serializeGetVersion() const { return 3; }
 void CWeightedPointsMap::serializeTo(mrpt::serialization::CArchive& out) const
 {
 	uint32_t n = m_x.size();
@@ -156,6 +156,7 @@ void CWeightedPointsMap::serializeTo(mrpt::serialization::CArchive& out) const
 	insertionOptions.writeToStream(
 		out);  // version 9: insert options are saved with its own method
 	likelihoodOptions.writeToStream(out);  // Added in version 5
+	writeLocalSurfaceGeometry(out);	 // v3
 }
 
 void CWeightedPointsMap::serializeFrom(
@@ -166,6 +167,7 @@ void CWeightedPointsMap::serializeFrom(
 		case 0:
 		case 1:
 		case 2:
+		case 3:
 		{
 			mark_as_modified();
 
@@ -218,6 +220,7 @@ void CWeightedPointsMap::serializeFrom(
 			}
 
 			likelihoodOptions.readFromStream(in);  // Added in version 5
+			if (version >= 3) readLocalSurfaceGeometry(in);
 		}
 		break;
 		default: MRPT_THROW_UNKNOWN_SERIALIZATION_VERSION(version);
@@ -39,6 +39,7 @@ TEST_CLASS_MOVE_COPY_CTORS(CReflectivityGridMap2D);
 TEST_CLASS_MOVE_COPY_CTORS(COccupancyGridMap2D);
 TEST_CLASS_MOVE_COPY_CTORS(COccupancyGridMap3D);
 TEST_CLASS_MOVE_COPY_CTORS(CSimplePointsMap);
+TEST_CLASS_MOVE_COPY_CTORS(CSparseOccupancyGridMap3D);
 TEST_CLASS_MOVE_COPY_CTORS(CRandomFieldGridMap3D);
 TEST_CLASS_MOVE_COPY_CTORS(CWeightedPointsMap);
 TEST_CLASS_MOVE_COPY_CTORS(CPointsMapXYZI);
@@ -67,6 +68,7 @@ TEST(SerializeTestMaps, WriteReadToMem)
 		CLASS_ID(COccupancyGridMap2D),
 		CLASS_ID(COccupancyGridMap3D),
 		CLASS_ID(CSimplePointsMap),
+		CLASS_ID(CSparseOccupancyGridMap3D),
 		CLASS_ID(CRandomFieldGridMap3D),
 		CLASS_ID(CWeightedPointsMap),
 		CLASS_ID(CPointsMapXYZI),
@@ -36,6 +36,7 @@ MRPT_INITIALIZER(registerAllClasses_mrpt_maps)
 	registerClass(CLASS_ID(CPointsMapXYZI));
 	registerClass(CLASS_ID(COccupancyGridMap2D));
 	registerClass(CLASS_ID(COccupancyGridMap3D));
+	registerClass(CLASS_ID(CSparseOccupancyGridMap3D));
 	registerClass(CLASS_ID(CGasConcentrationGridMap2D));
 	registerClass(CLASS_ID(CWirelessPowerGridMap2D));
 	registerClass(CLASS_ID(CRandomFieldGridMap3D));
@@ -0,0 +1,192 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/math/CMatrixDynamic.h>
+#include <mrpt/math/CSparseMatrix.h>
+#include <mrpt/math/CVectorDynamic.h>
+#include <mrpt/system/COutputLogger.h>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace mrpt
+{
+class WorkerThreadsPool;
+}
+
+namespace mrpt::math
+{
+/** Levenberg-Marquardt least-squares minimization for large problems with a
+ * sparse Jacobian, e.g. bundle adjustment or pose graphs.
+ *
+ * The state vector is split into parameter blocks (e.g. the 6 coordinates of
+ * a pose, or the 3 of a landmark), and the errors into residual blocks, each
+ * of which depends on a few parameter blocks only. That sparsity pattern is
+ * defined with setParameterBlocks() and addResidualBlock(), then execute()
+ * runs the same algorithm than CLevenbergMarquardtTempl, but:
+ *  - The Hessian approximation \f$ J^\top J \f$ is accumulated block by
+ * block into a CSparseMatrix, without building the whole Jacobian.
+ *  - Each iteration solves with CSparseMatrix::CholeskyDecomp, whose
+ * fill-in reducing ordering and symbolic analysis are computed only once,
+ * then reused with CSparseMatrix::CholeskyDecomp::update().
+ *  - Residual blocks (and their Jacobians) are evaluated in parallel by
+ * TOptions::numThreads threads, so the user functor must be thread-safe in
+ * that case.
+ *
+ * Usage example:
+ *  \code
+ *   CLevenbergMarquardtSparse lm;
+ *   lm.setParameterBlocks({6, 6, 3, 3 ...});  // Sizes of each block
+ *   lm.addResidualBlock(2, {0, 2});  // 2 errors, from blocks #0 and #2
+ *   ...
+ *   lm.execute(x, x0, [](size_t k, const auto& params, auto& err, auto* J) {
+ *      // err = ... (function of params[0][0], params[1][2], etc.)
+ *      // if (J) { (*J)[0] = d_err/d_params[0]; (*J)[1] = ... }
+ *   }, info);
+ *  \endcode
+ *
+ * \sa CLevenbergMarquardtTempl, MatrixBlockSparseCols
+ * \note (New in MRPT 2.4.9)
+ * \ingroup mrpt_math_grp
+ */
+class CLevenbergMarquardtSparse : public mrpt::system::COutputLogger
+{
+   public:
+	using vector_t = CVectorDouble;
+	using matrix_t = CMatrixDouble;
+
+	CLevenbergMarquardtSparse();
+	~CLevenbergMarquardtSparse() override;
+
+	/** Evaluates the residual block `blockIdx`. `params[j]` points to the
+	 * values of its j-th parameter block (in the order given to
+	 * addResidualBlock()). It must fill in `residual`, already resized to
+	 * the block dimension. If `jacobians` is not nullptr, it must also fill
+	 * in `(*jacobians)[j]`, already resized to the block dimension times the
+	 * size of the j-th parameter block, with the Jacobian of `residual` wrt
+	 * that parameter block. If TOptions::numericJacobians is true,
+	 * `jacobians` is always nullptr.
+	 */
+	using TFunctorResidual = std::function<void(
+		size_t blockIdx, const std::vector<const double*>& params,
+		vector_t& residual, std::vector<matrix_t>* jacobians)>;
+
+	/** An optional functor passed to execute() to replace the Euclidean
+	 * addition "x_new = x_old + x_incr" by any other operation. */
+	using TFunctorIncrement = std::function<void(
+		vector_t& x_new, const vector_t& x_old, const vector_t& x_incr)>;
+
+	struct TOptions
+	{
+		/** Maximum number of iterations */
+		size_t maxIter = 200;
+		/** Initial damping factor, relative to the largest diagonal entry of
+		 * \f$ J^\top J \f$ */
+		double tau = 1e-3;
+		/** Stops if the infinity norm of the gradient is below this */
+		double e1 = 1e-8;
+		/** Stops if the norm of the increment is below e2*(|x|+e2) */
+		double e2 = 1e-8;
+		/** Threads evaluating residual blocks (0: as many as CPU cores) */
+		unsigned int numThreads = 1;
+		/** If true, Jacobians are estimated by central finite differences
+		 * instead of computed by the user functor */
+		bool numericJacobians = false;
+		/** Increment of each parameter for numericJacobians */
+		double numericJacobianStep = 1e-6;
+	};
+
+	/** Options of the next calls to execute() */
+	TOptions options;
+
+	struct TResultInfo
+	{
+		double final_sqr_err = 0, initial_sqr_err = 0;
+		size_t iterations_executed = 0;
+		/** The last error vector, as all the residual blocks one after the
+		 * other. */
+		vector_t last_err_vector;
+	};
+
+	/** @name Problem definition
+		@{ */
+
+	/** Sets the size of each parameter block, in the order they are stored
+	 * in the state vector. Removes all existing residual blocks. */
+	void setParameterBlocks(const std::vector<size_t>& blockSizes);
+
+	/** Adds a residual block of `dim` errors, which depend on the given
+	 * (distinct) parameter blocks. \return The index of the new block, as
+	 * passed to the TFunctorResidual functor.
+	 */
+	size_t addResidualBlock(size_t dim, const std::vector<size_t>& paramBlocks);
+
+	size_t parameterBlockCount() const { return m_paramSizes.size(); }
+	size_t residualBlockCount() const { return m_resBlocks.size(); }
+	/** Length of the state vector */
+	size_t stateDimension() const { return m_stateDim; }
+
+	/** @} */
+
+	/** Runs the optimization from `x0`, which must have stateDimension()
+	 * elements. The sparsity pattern of the Hessian and its symbolic
+	 * factorization are kept for the next calls, as long as the problem
+	 * definition does not change.
+	 */
+	void execute(
+		vector_t& out_optimal_x, const vector_t& x0,
+		const TFunctorResidual& functor, TResultInfo& out_info,
+		const TFunctorIncrement& x_increment_adder = nullptr);
+
+   private:
+	struct TResidualBlock
+	{
+		size_t dim = 0;
+		std::vector<size_t> params;
+		/** Index of its first error in the error vector */
+		size_t offset = 0;
+		/** For each pair (j1,j2) of its parameter blocks with
+		 * params[j1]<=params[j2], in row-major order, its index in
+		 * m_blockPairPos */
+		std::vector<size_t> hessianPairs;
+	};
+
+	std::vector<size_t> m_paramSizes, m_paramOffsets;
+	size_t m_stateDim = 0, m_residualDim = 0;
+	std::vector<TResidualBlock> m_resBlocks;
+
+	/** Storage of the last evaluation of each residual block */
+	std::vector<vector_t> m_residuals;
+	std::vector<std::vector<matrix_t>> m_jacobians;
+
+	/** \f$ J^\top J \f$, only its upper triangular part, and the same plus
+	 * the damping term */
+	CSparseMatrix m_H, m_H_lm;
+	/** Index, in the values of m_H, of each diagonal entry */
+	std::vector<int> m_diagPos;
+	/** For each pair of coupled parameter blocks, the index of each entry
+	 * of their Hessian block (row-major) in the values of m_H (-1: lower
+	 * triangular part of a diagonal block) */
+	std::vector<std::vector<int>> m_blockPairPos;
+	bool m_patternReady = false;
+	std::unique_ptr<CSparseMatrix::CholeskyDecomp> m_chol;
+
+	void buildHessianPattern();
+	/** Evaluates all residual blocks at x (and their Jacobians, if
+	 * `withJacobians`), returning the squared error norm. */
+	double evaluate(
+		const vector_t& x, const TFunctorResidual& functor, bool withJacobians,
+		mrpt::WorkerThreadsPool* pool);
+	/** Fills in m_H and the gradient from the last evaluation */
+	void buildHessianAndGradient(vector_t& g);
+};
+
+}  // namespace mrpt::math
@@ -18,6 +18,7 @@
 #include <mrpt/typemeta/num_to_string.h>
 
 #include <array>
+#include <cmath>
 #include <cstddef>	// std::size_t
 
 namespace mrpt::math
@@ -360,6 +361,98 @@ class CMatrixFixed : public MatrixBase<T, CMatrixFixed<T, ROWS, COLS>>
 	}
 
 	/** @} */
+
+	/** @name Products and inverses of small matrices
+	 * Products are evaluated coefficient-wise into a stack result, skipping
+	 * the general Eigen product and its temporaries, and the inverse uses an
+	 * unrolled Cholesky decomposition. All of them can be used with the
+	 * output being one of the inputs.
+	 *  @{ */
+
+	/** this = A*B, for any compatible size of A and B
+	 * \note (Generalized to inputs of different sizes in MRPT 2.4.9) */
+	template <std::size_t N>
+	void matProductOf_AB(
+		const CMatrixFixed<T, ROWS, N>& A, const CMatrixFixed<T, N, COLS>& B)
+	{
+		const eigen_t r = A.asEigen().lazyProduct(B.asEigen());
+		asEigen() = r;
+	}
+
+	/** this = H*C*H<sup>T</sup>, e.g. the propagation of the covariance C
+	 * through the Jacobian H.
+	 * \sa mrpt::math::multiply_HCHt()
+	 * \note (New in MRPT 2.4.9) */
+	template <std::size_t N>
+	void matProductOf_HCHt(
+		const CMatrixFixed<T, ROWS, N>& H, const CMatrixFixed<T, N, N>& C)
+	{
+		static_assert(ROWS == COLS, "H*C*H^T is a square matrix");
+		const typename CMatrixFixed<T, ROWS, N>::eigen_t HC =
+			H.asEigen().lazyProduct(C.asEigen());
+		const eigen_t r = HC.lazyProduct(H.asEigen().transpose());
+		asEigen() = r;
+	}
+
+	/** Returns the inverse of this symmetric, definite positive matrix, from
+	 * its Cholesky decomposition (only its lower triangular part is read).
+	 * Up to 8x8 matrices, it uses an unrolled decomposition and the result
+	 * is exactly symmetric. Larger or not definite positive matrices are
+	 * inverted by MatrixBase::inverse_LLt().
+	 * \note (Specialized for small sizes in MRPT 2.4.9) */
+	CMatrixFixed inverse_LLt() const
+	{
+		using Base = MatrixBase<T, CMatrixFixed<T, ROWS, COLS>>;
+		if constexpr (ROWS != COLS || ROWS > 8) return Base::inverse_LLt();
+		else
+		{
+			constexpr std::size_t n = ROWS;
+			// Cholesky: this = L*L^T
+			T L[n][n], invDiag[n];
+			for (std::size_t j = 0; j < n; j++)
+			{
+				T d = (*this)(j, j);
+				for (std::size_t k = 0; k < j; k++)
+					d -= L[j][k] * L[j][k];
+				if (!(d > 0)) return Base::inverse_LLt();
+				L[j][j] = std::sqrt(d);
+				invDiag[j] = 1 / L[j][j];
+				for (std::size_t i = j + 1; i < n; i++)
+				{
+					T v = (*this)(i, j);
+					for (std::size_t k = 0; k < j; k++)
+						v -= L[i][k] * L[j][k];
+					L[i][j] = v * invDiag[j];
+				}
+			}
+			// M = L^-1 (lower triangular):
+			T M[n][n];
+			for (std::size_t j = 0; j < n; j++)
+			{
+				M[j][j] = invDiag[j];
+				for (std::size_t i = j + 1; i < n; i++)
+				{
+					T v = 0;
+					for (std::size_t k = j; k < i; k++)
+						v -= L[i][k] * M[k][j];
+					M[i][j] = v * invDiag[i];
+				}
+			}
+			// inverse = M^T * M
+			CMatrixFixed inv(UNINITIALIZED_MATRIX);
+			for (std::size_t i = 0; i < n; i++)
+				for (std::size_t j = i; j < n; j++)
+				{
+					T v = 0;
+					for (std::size_t k = j; k < n; k++)
+						v += M[k][i] * M[k][j];
+					inv(i, j) = inv(j, i) = v;
+				}
+			return inv;
+		}
+	}
+
+	/** @} */
 };
 
 /** @name Typedefs for common sizes
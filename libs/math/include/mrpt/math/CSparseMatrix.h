@@ -16,7 +16,9 @@
 #include <mrpt/math/math_frwds.h>
 
 #include <cstring>	// memcpy
+#include <memory>
 #include <stdexcept>
+#include <vector>
 
 // Include CSparse lib headers, either from the system or embedded:
 extern "C"
@@ -338,6 +340,43 @@ class CSparseMatrix
 	 */
 	void compressFromTriplet();
 
+	/** ONLY for column-compressed matrices: the number of stored entries.
+	 * \note (New in MRPT 2.4.9) */
+	inline size_t nonZeroCount() const
+	{
+		ASSERT_(isColumnCompressed());
+		return sparse_matrix.p[sparse_matrix.n];
+	}
+	/** ONLY for column-compressed matrices: direct access to the values of
+	 * the stored entries, which can be modified without changing the
+	 * sparsity pattern. The entries of column `c` are those with indices in
+	 * the range [colPointers()[c], colPointers()[c+1]), and their rows are
+	 * in rowIndices().
+	 * \note (New in MRPT 2.4.9) */
+	inline double* values()
+	{
+		ASSERT_(isColumnCompressed());
+		return sparse_matrix.x;
+	}
+	/** \overload */
+	inline const double* values() const
+	{
+		ASSERT_(isColumnCompressed());
+		return sparse_matrix.x;
+	}
+	/** \sa values() \note (New in MRPT 2.4.9) */
+	inline const int* colPointers() const
+	{
+		ASSERT_(isColumnCompressed());
+		return sparse_matrix.p;
+	}
+	/** \sa values() \note (New in MRPT 2.4.9) */
+	inline const int* rowIndices() const
+	{
+		ASSERT_(isColumnCompressed());
+		return sparse_matrix.i;
+	}
+
 	/** Return a dense representation of the sparse matrix.
 	 * \sa saveToTextFile_dense
 	 */
@@ -435,6 +474,13 @@ class CSparseMatrix
 	 *Strasdat, Steven Lovegrove and Andrew J. Davison. See
 	 *http://www.openslam.org/robotvision.html
 	 * \note This class designed to be "uncopiable".
+	 * \note If MRPT is built with the CMake option
+	 *MRPT_SPARSE_CHOLESKY_CHOLMOD (and SuiteSparse CHOLMOD is found), the
+	 *factorization is done by CHOLMOD instead of CSparse: this is supernodal
+	 *for matrices with enough fill-in, using the (possibly multithreaded)
+	 *BLAS/LAPACK CHOLMOD was built against, and is much faster for large
+	 *graph-SLAM or GMRF problems. The API and results are the same, up to
+	 *numerical round-off. See BackendName(). (New in MRPT 2.4.9)
 	 * \sa The main class: CSparseMatrix
 	 */
 	class CholeskyDecomp
@@ -442,11 +488,22 @@ class CSparseMatrix
 	   private:
 		css* m_symbolic_structure;
 		csn* m_numeric_structure;
-		/** A const reference to the original matrix used to build this
-		 * decomposition. */
-		const CSparseMatrix* m_originalSM;
+		/** A copy of the sparsity pattern (column pointers and row indices)
+		 * of the matrix used to build the symbolic decomposition. */
+		std::vector<int> m_pattern_p, m_pattern_i;
+#if MRPT_HAS_CHOLMOD
+		/** CHOLMOD data, used instead of the two CSparse structures above */
+		struct CholmodImpl;
+		std::unique_ptr<CholmodImpl> m_cholmod;
+#endif
 
 	   public:
+		/** Returns the name of the library doing the factorization, as
+		 * selected at build time: "CSparse" or "CHOLMOD".
+		 * \note (New in MRPT 2.4.9)
+		 */
+		static const char* BackendName();
+
 		/** Constructor from a square definite-positive sparse matrix A, which
 		 * can be use to solve Ax=b
 		 *   The actual Cholesky decomposition takes places in this
@@ -494,10 +551,49 @@ class CSparseMatrix
 
 		/** Update the Cholesky factorization from an updated vesion of the
 		 * original input, square definite-positive sparse matrix.
+		 * Only the numeric factorization is recomputed, reusing the fill-in
+		 * reducing ordering and symbolic analysis.
 		 *  NOTE: This new matrix MUST HAVE exactly the same sparse structure
 		 * than the original one.
+		 *  \exception std::exception If the sparsity pattern differs.
+		 *  \sa hasSameSparsityPattern()
 		 */
 		void update(const CSparseMatrix& new_SM);
+
+		/** Returns true if `SM` has exactly the same sparsity pattern (same
+		 * size, column pointers and row indices) than the matrix used to build
+		 * this decomposition, hence it can be passed to update().
+		 * \note (New in MRPT 2.4.9)
+		 */
+		bool hasSameSparsityPattern(const CSparseMatrix& SM) const;
+
+		/** Modifies the factorization so it becomes that of \f$ A + c c^\top
+		 * \f$ (or \f$ A - c c^\top \f$ if `downdate` is true) in time
+		 * proportional to the nonzero entries of L involved, instead of
+		 * factorizing that matrix again. The sparse vector `c` is given as
+		 * pairs (index, value), and the nonzero pattern of the updated matrix
+		 * must not change, e.g. `c` has a single nonzero entry at an index
+		 * whose diagonal entry already is in the original matrix.
+		 * \exception mrpt::math::CExceptionNotDefPos If the result of a
+		 * downdate is not positive definite, in which case the factorization
+		 * is no longer valid and update() must be called before using it.
+		 * \note (New in MRPT 2.4.9)
+		 */
+		void rankOneUpdate(
+			const std::vector<std::pair<size_t, double>>& c,
+			bool downdate = false);
+
+		/** Computes the diagonal entries \f$ (A^{-1})_{ii} \f$ of the inverse
+		 * of the decomposed matrix, only for the given indices, without
+		 * building the whole inverse (e.g. for the variances of a few
+		 * variables of a large system). Each entry costs a sparse triangular
+		 * solve along the path from the variable to the root of the
+		 * elimination tree. It is safe to call this method from several
+		 * threads at once.
+		 * \note (New in MRPT 2.4.9)
+		 */
+		void getInverseDiagonal(
+			const std::vector<size_t>& indices, CVectorDouble& out) const;
 	};
 	static_assert(
 		!std::is_copy_constructible_v<CholeskyDecomp> &&
@@ -14,6 +14,7 @@
 #include <mrpt/math/TPoint2D.h>
 #include <mrpt/math/TPoint3D.h>
 
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <memory>  // unique_ptr
@@ -104,6 +105,13 @@ class KDTreeCapable
 		TKDTreeSearchParams() = default;
 		/** Max points per leaf */
 		size_t leaf_max_size = 10;
+		/** If true, a dynamic index (a logarithmic forest of static
+		 * sub-trees, via nanoflann::KDTreeSingleIndexDynamicAdaptor) is
+		 * always built, so points notified through
+		 * kdtree_mark_points_appended() are added without rebuilding the
+		 * whole tree. Queries on a dynamic index are slightly slower than
+		 * on a static one. Default: false. */
+		bool incremental = false;
 	};
 
 	/** Parameters to tune KD-tree searches. Refer to nanoflann docs.
@@ -145,7 +153,7 @@ class KDTreeCapable
 		resultSet.init(&ret_index, &out_dist_sqr);
 
 		const std::array<num_t, 2> query_point{{x0, y0}};
-		m_kdtree2d_data.index->findNeighbors(
+		m_kdtree2d_data.findNeighbors(
 			resultSet, &query_point[0], nanoflann::SearchParams());
 
 		// Copy output to user vars:
@@ -171,7 +179,7 @@ class KDTreeCapable
 		resultSet.init(&ret_index, &out_dist_sqr);
 
 		const std::array<num_t, 2> query_point{{x0, y0}};
-		m_kdtree2d_data.index->findNeighbors(
+		m_kdtree2d_data.findNeighbors(
 			resultSet, &query_point[0], nanoflann::SearchParams());
 
 		return ret_index;
@@ -241,7 +249,7 @@ class KDTreeCapable
 		resultSet.init(&ret_indexes[0], &ret_sqdist[0]);
 
 		const std::array<num_t, 2> query_point{{x0, y0}};
-		m_kdtree2d_data.index->findNeighbors(
+		m_kdtree2d_data.findNeighbors(
 			resultSet, &query_point[0], nanoflann::SearchParams());
 
 		// Copy output to user vars:
@@ -308,7 +316,7 @@ class KDTreeCapable
 		resultSet.init(&ret_indexes[0], &out_dist_sqr[0]);
 
 		const std::array<num_t, 2> query_point{{x0, y0}};
-		m_kdtree2d_data.index->findNeighbors(
+		m_kdtree2d_data.findNeighbors(
 			resultSet, &query_point[0], nanoflann::SearchParams());
 
 		for (size_t i = 0; i < knn; i++)
@@ -367,7 +375,7 @@ class KDTreeCapable
 		resultSet.init(&out_idx[0], &out_dist_sqr[0]);
 
 		const std::array<num_t, 2> query_point{{x0, y0}};
-		m_kdtree2d_data.index->findNeighbors(
+		m_kdtree2d_data.findNeighbors(
 			resultSet, &query_point[0], nanoflann::SearchParams());
 		MRPT_END
 	}
@@ -414,7 +422,7 @@ class KDTreeCapable
 		resultSet.init(&ret_index, &out_dist_sqr);
 
 		const std::array<num_t, 3> query_point{{x0, y0, z0}};
-		m_kdtree3d_data.index->findNeighbors(
+		m_kdtree3d_data.findNeighbors(
 			resultSet, &query_point[0], nanoflann::SearchParams());
 
 		// Copy output to user vars:
@@ -441,7 +449,7 @@ class KDTreeCapable
 		resultSet.init(&ret_index, &out_dist_sqr);
 
 		const std::array<num_t, 3> query_point{{x0, y0, z0}};
-		m_kdtree3d_data.index->findNeighbors(
+		m_kdtree3d_data.findNeighbors(
 			resultSet, &query_point[0], nanoflann::SearchParams());
 
 		return ret_index;
@@ -503,7 +511,7 @@ class KDTreeCapable
 		resultSet.init(&ret_indexes[0], &out_dist_sqr[0]);
 
 		const std::array<num_t, 3> query_point{{x0, y0, z0}};
-		m_kdtree3d_data.index->findNeighbors(
+		m_kdtree3d_data.findNeighbors(
 			resultSet, &query_point[0], nanoflann::SearchParams());
 
 		for (size_t i = 0; i < knn; i++)
@@ -558,7 +566,7 @@ class KDTreeCapable
 		resultSet.init(&out_idx[0], &out_dist_sqr[0]);
 
 		const std::array<num_t, 3> query_point{{x0, y0, z0}};
-		m_kdtree3d_data.index->findNeighbors(
+		m_kdtree3d_data.findNeighbors(
 			resultSet, &query_point[0], nanoflann::SearchParams());
 
 		for (size_t i = 0; i < knn; i++)
@@ -614,9 +622,8 @@ class KDTreeCapable
 		if (m_kdtree3d_data.m_num_points != 0)
 		{
 			const num_t xyz[3] = {x0, y0, z0};
-			m_kdtree3d_data.index->radiusSearch(
-				&xyz[0], maxRadiusSqr, out_indices_dist,
-				nanoflann::SearchParams());
+			m_kdtree3d_data.radiusSearch(
+				&xyz[0], maxRadiusSqr, out_indices_dist);
 		}
 		return out_indices_dist.size();
 		MRPT_END
@@ -648,9 +655,8 @@ class KDTreeCapable
 		if (m_kdtree2d_data.m_num_points != 0)
 		{
 			const num_t xyz[2] = {x0, y0};
-			m_kdtree2d_data.index->radiusSearch(
-				&xyz[0], maxRadiusSqr, out_indices_dist,
-				nanoflann::SearchParams());
+			m_kdtree2d_data.radiusSearch(
+				&xyz[0], maxRadiusSqr, out_indices_dist);
 		}
 		return out_indices_dist.size();
 		MRPT_END
@@ -688,7 +694,7 @@ class KDTreeCapable
 		resultSet.init(&out_idx[0], &out_dist_sqr[0]);
 
 		const std::array<num_t, 3> query_point{{x0, y0, z0}};
-		m_kdtree3d_data.index->findNeighbors(
+		m_kdtree3d_data.findNeighbors(
 			resultSet, &query_point[0], nanoflann::SearchParams());
 		MRPT_END
 	}
@@ -711,7 +717,23 @@ class KDTreeCapable
 	inline void kdtree_mark_as_outdated() const
 	{
 		std::lock_guard<std::mutex> lck(m_kdtree_mtx);
-		m_kdtree_is_uptodate = false;
+		m_kdtree2d_data.mark_as_outdated(false);
+		m_kdtree3d_data.mark_as_outdated(false);
+	}
+
+	/** To be called by child classes *instead of* kdtree_mark_as_outdated()
+	 * when the only change in the data is that new points have been appended
+	 * at the end (i.e. existing points keep their indices and coordinates).
+	 * The next query will then just insert the new points into a dynamic
+	 * index, instead of rebuilding the KD-tree from scratch.
+	 * If the existing index is a static one, it will be rebuilt once as a
+	 * dynamic index, so subsequent appends become incremental.
+	 */
+	inline void kdtree_mark_points_appended() const
+	{
+		std::lock_guard<std::mutex> lck(m_kdtree_mtx);
+		m_kdtree2d_data.mark_as_outdated(true);
+		m_kdtree3d_data.mark_as_outdated(true);
 	}
 
    private:
@@ -730,96 +752,153 @@ class KDTreeCapable
 		 * will be created if required!  */
 		inline TKDTreeDataHolder& operator=(const TKDTreeDataHolder& o) noexcept
 		{
-			if (&o != this) clear();
+			if (&o != this)
+			{
+				clear();
+				mark_as_outdated(false);
+			}
 			return *this;
 		}
 
 		/** Free memory (if allocated)  */
-		inline void clear() noexcept { index.reset(); }
+		inline void clear() noexcept
+		{
+			index.reset();
+			dyn_index.reset();
+			m_num_points = 0;
+		}
+
+		/** Must be called with the owner mutex locked.
+		 * \param only_appended true if the index still holds a valid prefix
+		 * of the data points. */
+		inline void mark_as_outdated(bool only_appended) noexcept
+		{
+			m_is_uptodate = false;
+			if (only_appended) m_wants_dynamic = true;
+			else
+				m_is_valid_prefix = false;
+		}
+
 		using kdtree_index_t = nanoflann::KDTreeSingleIndexAdaptor<
 			metric_t, Derived, _DIM, std::size_t /*index*/>;
+		using kdtree_dyn_index_t = nanoflann::KDTreeSingleIndexDynamicAdaptor<
+			metric_t, Derived, _DIM, std::size_t /*index*/>;
 
-		/** nullptr or the up-to-date index */
+		/** nullptr or the up-to-date static index */
 		std::unique_ptr<kdtree_index_t> index;
+		/** nullptr or the up-to-date dynamic index. At most one of `index`
+		 * and `dyn_index` is non-null at any time. */
+		std::unique_ptr<kdtree_dyn_index_t> dyn_index;
 
 		/** Dimensionality. typ: 2,3 */
 		size_t m_dim = _DIM;
+		/** Number of data points in the index */
 		size_t m_num_points = 0;
-	};
-
-	mutable std::mutex m_kdtree_mtx;
-	mutable TKDTreeDataHolder<2> m_kdtree2d_data;
-	mutable TKDTreeDataHolder<3> m_kdtree3d_data;
-	/** whether the KD tree needs to be rebuilt or not. */
-	mutable std::atomic_bool m_kdtree_is_uptodate{false};
-
-	/// Rebuild, if needed the KD-tree for 2D (nDims=2), 3D (nDims=3), ...
-	/// asking the child class for the data points.
-	void rebuild_kdTree_2D() const
-	{
-		if (m_kdtree_is_uptodate) return;
-
-		std::lock_guard<std::mutex> lck(m_kdtree_mtx);
-		using tree2d_t = typename TKDTreeDataHolder<2>::kdtree_index_t;
 
-		if (!m_kdtree_is_uptodate)
+		/** Whether the index matches the current data points */
+		std::atomic_bool m_is_uptodate{false};
+		/** Whether the first `m_num_points` data points are unchanged since
+		 * the index was built (protected by the owner mutex) */
+		bool m_is_valid_prefix = false;
+		/** Set after a points-appended notification: build a dynamic index
+		 * next time (protected by the owner mutex) */
+		bool m_wants_dynamic = false;
+
+		template <typename RESULTSET>
+		inline void findNeighbors(
+			RESULTSET& result, const num_t* query,
+			const nanoflann::SearchParams& params) const
 		{
-			m_kdtree2d_data.clear();
-			m_kdtree3d_data.clear();
+			if (index) index->findNeighbors(result, query, params);
+			else if (dyn_index)
+				dyn_index->findNeighbors(result, query, params);
 		}
 
-		if (!m_kdtree2d_data.index)
+		inline void radiusSearch(
+			const num_t* query, const num_t radiusSqr,
+			std::vector<std::pair<size_t, num_t>>& out_indices_dist) const
 		{
-			// Erase previous tree:
-			m_kdtree2d_data.clear();
-			// And build new index:
-			const size_t N = derived().kdtree_get_point_count();
-			m_kdtree2d_data.m_num_points = N;
-			m_kdtree2d_data.m_dim = 2;
-			if (N)
+			if (index)
 			{
-				m_kdtree2d_data.index = std::make_unique<tree2d_t>(
-					2, derived(),
-					nanoflann::KDTreeSingleIndexAdaptorParams(
-						kdtree_search_params.leaf_max_size));
-				m_kdtree2d_data.index->buildIndex();
+				index->radiusSearch(
+					query, radiusSqr, out_indices_dist,
+					nanoflann::SearchParams());
+			}
+			else if (dyn_index)
+			{
+				nanoflann::RadiusResultSet<num_t, size_t> resultSet(
+					radiusSqr, out_indices_dist);
+				dyn_index->findNeighbors(
+					resultSet, query, nanoflann::SearchParams());
+				// Keep the same (sorted) output than the static index:
+				std::sort(
+					out_indices_dist.begin(), out_indices_dist.end(),
+					nanoflann::IndexDist_Sorter());
 			}
-			m_kdtree_is_uptodate = true;
 		}
-	}
+	};
+
+	mutable std::mutex m_kdtree_mtx;
+	mutable TKDTreeDataHolder<2> m_kdtree2d_data;
+	mutable TKDTreeDataHolder<3> m_kdtree3d_data;
+
+	/// Rebuild, if needed the KD-tree for 2D (nDims=2), 3D (nDims=3), ...
+	/// asking the child class for the data points.
+	void rebuild_kdTree_2D() const { rebuild_kdTree(m_kdtree2d_data); }
 
 	/// Rebuild, if needed the KD-tree for 2D (nDims=2), 3D (nDims=3), ...
 	/// asking the child class for the data points.
-	void rebuild_kdTree_3D() const
+	void rebuild_kdTree_3D() const { rebuild_kdTree(m_kdtree3d_data); }
+
+	template <int _DIM>
+	void rebuild_kdTree(TKDTreeDataHolder<_DIM>& data) const
 	{
-		if (m_kdtree_is_uptodate) return;
+		if (data.m_is_uptodate) return;
+
 		std::lock_guard<std::mutex> lck(m_kdtree_mtx);
-		using tree3d_t = typename TKDTreeDataHolder<3>::kdtree_index_t;
+		if (data.m_is_uptodate) return;
+
+		using tree_t = typename TKDTreeDataHolder<_DIM>::kdtree_index_t;
+		using dyn_tree_t = typename TKDTreeDataHolder<_DIM>::kdtree_dyn_index_t;
 
-		if (!m_kdtree_is_uptodate)
+		const size_t N = derived().kdtree_get_point_count();
+		const nanoflann::KDTreeSingleIndexAdaptorParams params(
+			kdtree_search_params.leaf_max_size);
+
+		if (data.dyn_index && data.m_is_valid_prefix &&
+			N >= data.m_num_points)
 		{
-			m_kdtree2d_data.clear();
-			m_kdtree3d_data.clear();
+			// Incremental update: only add the new points:
+			if (N > data.m_num_points)
+				data.dyn_index->addPoints(data.m_num_points, N - 1);
+			data.m_num_points = N;
 		}
-
-		if (!m_kdtree3d_data.index)
+		else
 		{
 			// Erase previous tree:
-			m_kdtree3d_data.clear();
+			data.clear();
 			// And build new index:
-			const size_t N = derived().kdtree_get_point_count();
-			m_kdtree3d_data.m_num_points = N;
-			m_kdtree3d_data.m_dim = 3;
+			data.m_num_points = N;
+			data.m_dim = _DIM;
 			if (N)
 			{
-				m_kdtree3d_data.index = std::make_unique<tree3d_t>(
-					3, derived(),
-					nanoflann::KDTreeSingleIndexAdaptorParams(
-						kdtree_search_params.leaf_max_size));
-				m_kdtree3d_data.index->buildIndex();
+				if (kdtree_search_params.incremental || data.m_wants_dynamic)
+				{
+					// (The dynamic index adds all existing points in its
+					// ctor)
+					data.dyn_index =
+						std::make_unique<dyn_tree_t>(_DIM, derived(), params);
+				}
+				else
+				{
+					data.index =
+						std::make_unique<tree_t>(_DIM, derived(), params);
+					data.index->buildIndex();
+				}
 			}
-			m_kdtree_is_uptodate = true;
 		}
+		data.m_is_valid_prefix = true;
+		data.m_is_uptodate = true;
 	}
 
 };	// end of KDTreeCapable
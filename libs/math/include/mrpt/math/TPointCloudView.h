@@ -0,0 +1,103 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/core/exceptions.h>
+#include <mrpt/math/TPoint3D.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mrpt::math
+{
+/** \addtogroup  geometry_grp
+ * @{ */
+
+/** A non-owning, read-only view of a point cloud stored as separate arrays
+ * (structure of arrays) of x, y, z coordinates and, optionally, intensity.
+ *
+ * It allows passing point clouds generated into any container (e.g.
+ * mrpt::obs::CObservationVelodyneScan::TPointCloud, the buffers of a
+ * mrpt::maps::CPointsMap, or user std::vector's) to consumers like
+ * mrpt::maps::CPointsMap::insertPointsView(),
+ * mrpt::maps::CPointsMap::determineMatching3D() or
+ * mrpt::opengl::CPointCloud::setAllPoints() without copying them first.
+ *
+ * The user must ensure the viewed buffers outlive the view and are not
+ * reallocated while using it.
+ *
+ * \note (New in MRPT 2.4.9)
+ */
+struct TPointCloudView
+{
+	TPointCloudView() = default;
+
+	TPointCloudView(
+		const float* X, const float* Y, const float* Z, std::size_t N)
+		: x(X), y(Y), z(Z), count(N)
+	{
+	}
+
+	/** Builds a view of three contiguous containers of `float` with data()
+	 * and size(), e.g. std::vector. */
+	template <class VECTOR>
+	static TPointCloudView FromVectors(
+		const VECTOR& X, const VECTOR& Y, const VECTOR& Z)
+	{
+		ASSERT_EQUAL_(X.size(), Y.size());
+		ASSERT_EQUAL_(X.size(), Z.size());
+		return TPointCloudView(X.data(), Y.data(), Z.data(), X.size());
+	}
+
+	/** Point coordinates. Can be nullptr only if count=0 */
+	const float *x = nullptr, *y = nullptr, *z = nullptr;
+
+	/** Optional intensity of each point, either as float in the range [0,1]
+	 * or uint8_t in the range [0,255] (nullptr if not available). */
+	const float* intensity = nullptr;
+	const uint8_t* intensity_u8 = nullptr;
+
+	/** Number of points */
+	std::size_t count = 0;
+
+	std::size_t size() const { return count; }
+	bool empty() const { return count == 0; }
+
+	mrpt::math::TPoint3Df point(std::size_t i) const
+	{
+		return {x[i], y[i], z[i]};
+	}
+
+	bool hasIntensity() const
+	{
+		return intensity != nullptr || intensity_u8 != nullptr;
+	}
+	/** Intensity in the range [0,1] of the i-th point, or 0 if not available
+	 */
+	float getIntensity(std::size_t i) const
+	{
+		if (intensity) return intensity[i];
+		if (intensity_u8) return intensity_u8[i] * (1.0f / 255);
+		return .0f;
+	}
+
+	/** A view of a subrange of `n` points starting at index `first` */
+	TPointCloudView subView(std::size_t first, std::size_t n) const
+	{
+		ASSERT_LE_(first + n, count);
+		TPointCloudView v(x + first, y + first, z + first, n);
+		if (intensity) v.intensity = intensity + first;
+		if (intensity_u8) v.intensity_u8 = intensity_u8 + first;
+		return v;
+	}
+};
+
+/** @} */  // end of grouping
+
+}  // namespace mrpt::math
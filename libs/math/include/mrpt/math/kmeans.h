@@ -11,10 +11,43 @@
 #include <mrpt/math/CMatrixDynamic.h>
 #include <mrpt/math/CMatrixFixed.h>
 
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
 namespace mrpt
 {
 namespace math
 {
+/** Options for kmeans_parallel()
+ * \note (New in MRPT 2.4.9)
+ */
+struct TKMeansParallelOptions
+{
+	/** Number of threads for the assignment and update steps, including the
+	 * calling one. 0 means std::thread::hardware_concurrency() */
+	unsigned int numThreads = 0;
+	/** Seed the centers with k-means++ (true) or with k distinct random
+	 * points (false) */
+	bool kmeansplusplus = true;
+	/** Number of independent runs; the one with the lowest cost is returned */
+	size_t attempts = 3;
+	/** Maximum number of Lloyd (or mini-batch) iterations per attempt */
+	size_t maxIterations = 100;
+	/** Lloyd iterations end when the relative decrease of the cost is below
+	 * this value, or no point changes its cluster */
+	double relativeTolerance = 1e-6;
+	/** If >0, use mini-batch k-means (Sculley, 2010) with batches of this many
+	 * random points, instead of full Lloyd iterations. Intended for very large
+	 * N, where a few hundred batches are much cheaper than one full pass. The
+	 * final assignments and cost are always computed with all points. */
+	size_t miniBatchSize = 0;
+	/** The seed of the random generator (one stream per attempt). 0 means a
+	 * random seed from std::random_device. Results for a given seed do not
+	 * depend on numThreads. */
+	uint64_t seed = 0;
+};
+
 namespace detail
 {
 // Auxiliary method: templatized for working with float/double's.
@@ -24,11 +57,18 @@ double internal_kmeans(
 	const size_t dims, const SCALAR* points, const size_t attempts,
 	SCALAR* out_center, int* out_assignments);
 
+// Auxiliary method for kmeans_parallel(), instantiated for float/double.
+template <typename SCALAR>
+double internal_kmeans_parallel(
+	const size_t k, const SCALAR* points, const size_t nPoints,
+	const size_t dims, const size_t stride, int* out_assignments,
+	SCALAR* out_centers, const TKMeansParallelOptions& opts);
+
 // Auxiliary method, the actual code of the two front-end functions offered to
 // the user below.
 template <class LIST_OF_VECTORS1, class LIST_OF_VECTORS2>
 double stub_kmeans(
-	[[maybe_unused]] const bool use_kmeansplusplus_method, const size_t k,
+	const bool use_kmeansplusplus_method, const size_t k,
 	const LIST_OF_VECTORS1& points, std::vector<int>& assignments,
 	LIST_OF_VECTORS2* out_centers, const size_t attempts)
 {
@@ -71,7 +111,7 @@ double stub_kmeans(
 	// Call the internal implementation:
 	std::vector<typename TInnerVectorCenters::value_type> centers(dims * k);
 	const double ret = detail::internal_kmeans(
-		false, N, k, points.begin()->size(), &raw_vals[0], attempts,
+		use_kmeansplusplus_method, N, k, points.begin()->size(), &raw_vals[0], attempts,
 		&centers[0], &assignments[0]);
 	// Centers:
 	if (out_centers)
@@ -165,6 +205,77 @@ inline double kmeanspp(
 		attempts);
 }
 
+/** Parallel k-means (or k-means++) over N points of dimensionality `dims`,
+ * read in place from `points`: coordinate `j` of point `i` is
+ * `points[i*stride + j]`, so no copy of the input is made.
+ *
+ * The assignment and update steps of each iteration are split in chunks of
+ * points run in parallel, with per-chunk partial sums reduced afterwards, and
+ * the k-means++ seeding updates the distance of each point to its closest
+ * center in parallel too. With TKMeansParallelOptions::miniBatchSize, only
+ * random batches of points are assigned in each iteration.
+ *
+ *  \param k [IN] Number of clusters to look for (`k<=nPoints`).
+ *  \param assignments [OUT] A number [0,k-1] for each of the N points.
+ *  \param out_centers [OUT] If not nullptr, the `k*dims` coordinates of the
+ * centers, one center after the other.
+ *  \return The final cost: the sum of the squared distances of points to
+ * their centers.
+ *
+ * \sa kmeans, kmeanspp
+ * \note (New in MRPT 2.4.9)
+ */
+template <typename T>
+double kmeans_parallel(
+	const size_t k, const T* points, const size_t nPoints, const size_t dims,
+	std::vector<int>& assignments, std::vector<T>* out_centers = nullptr,
+	const TKMeansParallelOptions& opts = TKMeansParallelOptions(),
+	const size_t stride = 0)
+{
+	static_assert(
+		std::is_same_v<T, float> || std::is_same_v<T, double>,
+		"Only float and double coordinates are supported");
+	assignments.resize(nPoints);
+	if (out_centers) out_centers->resize(k * dims);
+	return detail::internal_kmeans_parallel<T>(
+		k, points, nPoints, dims, stride ? stride : dims, assignments.data(),
+		out_centers ? out_centers->data() : nullptr, opts);
+}
+
+/** \overload For a contiguous container (e.g. std::vector) of fixed-size
+ * points, such as mrpt::math::CVectorFixedDouble<N> or
+ * mrpt::math::TPoint3D, read in place. Centers are returned as points of
+ * the same type.
+ * \note (New in MRPT 2.4.9)
+ */
+template <class CONTAINER>
+double kmeans_parallel(
+	const size_t k, const CONTAINER& points, std::vector<int>& assignments,
+	std::vector<typename CONTAINER::value_type>* out_centers = nullptr,
+	const TKMeansParallelOptions& opts = TKMeansParallelOptions())
+{
+	using POINT = typename CONTAINER::value_type;
+	using T = std::remove_cv_t<
+		std::remove_reference_t<decltype(std::declval<POINT>()[0])>>;
+	const size_t dims = points.empty() ? 0 : points.begin()->size();
+	static_assert(
+		sizeof(POINT) % sizeof(T) == 0,
+		"Point type must be an array of its coordinate type");
+	std::vector<T> centers;
+	const double ret = kmeans_parallel<T>(
+		k, reinterpret_cast<const T*>(points.data()), points.size(), dims,
+		assignments, out_centers ? &centers : nullptr, opts,
+		sizeof(POINT) / sizeof(T));
+	if (out_centers)
+	{
+		out_centers->resize(k);
+		for (size_t i = 0; i < k; i++)
+			for (size_t j = 0; j < dims; j++)
+				(*out_centers)[i][j] = centers[i * dims + j];
+	}
+	return ret;
+}
+
 /** @} */
 
 }  // namespace math
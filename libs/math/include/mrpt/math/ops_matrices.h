@@ -37,14 +37,35 @@ inline void multiply_HCHt(
 	}
 }
 
+/** R = H * C * H^t, for fixed-size matrices.
+ * \sa CMatrixFixed::matProductOf_HCHt() */
+template <std::size_t H_ROWS, std::size_t H_COLS, typename Scalar>
+inline void multiply_HCHt(
+	const mrpt::math::CMatrixFixed<Scalar, H_ROWS, H_COLS>& H,
+	const mrpt::math::CMatrixFixed<Scalar, H_COLS, H_COLS>& C,
+	mrpt::math::CMatrixFixed<Scalar, H_ROWS, H_ROWS>& R,
+	bool accumResultInOutput = false)
+{
+	if (accumResultInOutput)
+	{
+		mrpt::math::CMatrixFixed<Scalar, H_ROWS, H_ROWS> res(
+			mrpt::math::UNINITIALIZED_MATRIX);
+		res.matProductOf_HCHt(H, C);
+		R += res;
+	}
+	else
+		R.matProductOf_HCHt(H, C);
+}
+
 /** return a fixed-size matrix with the result of: H * C * H^t */
 template <std::size_t H_ROWS, std::size_t H_COLS, typename Scalar>
 mrpt::math::CMatrixFixed<Scalar, H_ROWS, H_ROWS> multiply_HCHt(
 	const mrpt::math::CMatrixFixed<Scalar, H_ROWS, H_COLS>& H,
 	const mrpt::math::CMatrixFixed<Scalar, H_COLS, H_COLS>& C)
 {
-	mrpt::math::CMatrixFixed<Scalar, H_ROWS, H_ROWS> R;
-	R.asEigen() = (mat2eig(H) * mat2eig(C) * mat2eig(H).transpose()).eval();
+	mrpt::math::CMatrixFixed<Scalar, H_ROWS, H_ROWS> R(
+		mrpt::math::UNINITIALIZED_MATRIX);
+	R.matProductOf_HCHt(H, C);
 	return R;
 }
 
@@ -8,10 +8,12 @@
    +------------------------------------------------------------------------+ */
 #pragma once
 
+#include <mrpt/core/WorkerThreadsPool.h>
 #include <mrpt/math/CMatrixDynamic.h>
 #include <mrpt/system/COutputLogger.h>
 
 #include <functional>
+#include <memory>
 #include <set>
 
 namespace mrpt::math
@@ -29,6 +31,42 @@ size_t ransacDatasetSize(const CMatrixDynamic<T>& dataset)
 	return dataset.cols();
 }
 
+/** Parameters of RANSAC_Template::executeParallel()
+ * \note (New in MRPT 2.4.9)
+ */
+struct TRansacParallelParams
+{
+	/** Number of threads (0: as many as CPU cores). The result does not
+	 * depend on this value. */
+	unsigned int numThreads = 0;
+
+	/** Number of hypotheses generated and scored (in parallel) in each round,
+	 * before updating the best model and the estimated number of iterations.
+	 */
+	unsigned int hypothesesPerBatch = 64;
+
+	/** If >0, each hypothesis is first scored against a fixed random subset
+	 * of this many data (Preemptive RANSAC, or the T(d,d) test), and
+	 * discarded without scoring the rest of the data if its ratio of inliers
+	 * there is below `preemptiveRatio` times that of the best model so far.
+	 */
+	unsigned int preemptiveSubsetSize = 0;
+
+	/** See preemptiveSubsetSize */
+	double preemptiveRatio = 0.5;
+
+	/** Probability of picking at least one sample free of outliers, used to
+	 * estimate the number of iterations. */
+	double prob_good_sample = 0.999;
+
+	/** Maximum number of hypotheses */
+	size_t maxIter = 2000;
+
+	/** Seed of the sampling of data. The result is reproducible for a given
+	 * seed. */
+	uint64_t seed = 0;
+};
+
 /** A generic RANSAC implementation. By default, the input "dataset" and output
  * "model" are matrices, but this can be changed via template arguments to be
  * any user-defined type. Define ransacDatasetSize() for your custom data types.
@@ -91,6 +129,38 @@ class RANSAC_Template : public mrpt::system::COutputLogger
 		const double prob_good_sample = 0.999,
 		const size_t maxIter = 2000) const;
 
+	/** A parallel version of execute(), which generates and scores batches of
+	 * hypotheses in a thread pool, and stops scoring a hypothesis as soon as
+	 * it cannot improve the best one found so far.
+	 *
+	 * Functors are template arguments (any callable, e.g. lambdas), so they
+	 * can be inlined by the compiler:
+	 *  - `fit_func(data, useIndices, std::vector<MODEL>& fitModels)`: as in
+	 *    execute().
+	 *  - `dist_func(data, const MODEL& model, size_t index) -> NUMTYPE`: the
+	 *    distance between one datum and a model. Data with a distance below
+	 *    `distanceThreshold` are inliers.
+	 *  - `degen_func(data, useIndices) -> bool`: as in execute().
+	 *
+	 * All of them are invoked concurrently from several threads, so they
+	 * must be thread-safe.
+	 *
+	 * \return false if no good solution can be found, true on success.
+	 * \note (New in MRPT 2.4.9)
+	 */
+	template <class FIT_FUNC, class DIST_FUNC, class DEGEN_FUNC>
+	bool executeParallel(
+		const DATASET& data, const FIT_FUNC& fit_func,
+		const DIST_FUNC& dist_func, const DEGEN_FUNC& degen_func,
+		const double distanceThreshold,
+		const unsigned int minimumSizeSamplesToFit,
+		std::vector<size_t>& out_best_inliers, MODEL& out_best_model,
+		const TRansacParallelParams& params = TRansacParallelParams()) const;
+
+   private:
+	/** Reused among calls to executeParallel() */
+	mutable std::shared_ptr<mrpt::WorkerThreadsPool> m_threadPool;
+
 };	// end class
 
 /** The default instance of RANSAC, for double type */
@@ -11,7 +11,12 @@
 #include <mrpt/core/exceptions.h>
 #include <mrpt/random/RandomGenerators.h>
 
+#include <algorithm>
+#include <cmath>
 #include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <thread>
 #include <vector>
 
 // To be included from ransac.h only
@@ -177,4 +182,207 @@ bool RANSAC_Template<NUMTYPE, DATASET, MODEL>::execute(
 	MRPT_END
 }
 
+namespace internal
+{
+/** SplitMix64: a tiny PRNG, so each RANSAC hypothesis has its own random
+ * sequence regardless of the thread running it */
+inline uint64_t ransacRandom(uint64_t& state)
+{
+	uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+/** Draws `ind.size()` different random indices in [0,N) */
+inline void ransacSample(uint64_t& state, size_t N, std::vector<size_t>& ind)
+{
+	for (size_t i = 0; i < ind.size(); i++)
+	{
+		bool repeated;
+		do
+		{
+			ind[i] = static_cast<size_t>(ransacRandom(state) % N);
+			repeated =
+				std::find(ind.begin(), ind.begin() + i, ind[i]) !=
+				ind.begin() + i;
+		} while (repeated && ind.size() <= N);
+	}
+}
+
+/** Number of iterations to pick, with probability p, a sample free of
+ * outliers */
+inline size_t ransacNumIters(
+	size_t ninliers, size_t Npts, unsigned int sampleSize, double p)
+{
+	const double fracinliers = ninliers / static_cast<double>(Npts);
+	double pNoOutliers =
+		1 - std::pow(fracinliers, static_cast<double>(sampleSize));
+	pNoOutliers = std::clamp(
+		pNoOutliers, std::numeric_limits<double>::epsilon(),
+		1.0 - std::numeric_limits<double>::epsilon());
+	return static_cast<size_t>(std::log(1 - p) / std::log(pNoOutliers));
+}
+}  // namespace internal
+
+template <typename NUMTYPE, typename DATASET, typename MODEL>
+template <class FIT_FUNC, class DIST_FUNC, class DEGEN_FUNC>
+bool RANSAC_Template<NUMTYPE, DATASET, MODEL>::executeParallel(
+	const DATASET& data, const FIT_FUNC& fit_func, const DIST_FUNC& dist_func,
+	const DEGEN_FUNC& degen_func, const double distanceThreshold,
+	const unsigned int minimumSizeSamplesToFit,
+	std::vector<size_t>& out_best_inliers, MODEL& out_best_model,
+	const TRansacParallelParams& params) const
+{
+	MRPT_START
+
+	ASSERT_GE_(minimumSizeSamplesToFit, 1U);
+	ASSERT_GE_(params.hypothesesPerBatch, 1U);
+
+	const size_t Npts = ransacDatasetSize(data);
+	ASSERT_GT_(Npts, 1);
+
+	const auto thres = static_cast<NUMTYPE>(distanceThreshold);
+	const size_t maxDataTrials = 100;
+
+	out_best_model = MODEL();
+	out_best_inliers.clear();
+
+	// Fixed random subset of data for the preemptive test:
+	std::vector<size_t> subset;
+	uint64_t rndState = ~params.seed;
+	if (params.preemptiveSubsetSize > 0 && params.preemptiveSubsetSize < Npts)
+	{
+		std::vector<size_t> all(Npts);
+		for (size_t i = 0; i < Npts; i++)
+			all[i] = i;
+		for (size_t i = 0; i < params.preemptiveSubsetSize; i++)
+			std::swap(
+				all[i],
+				all[i + internal::ransacRandom(rndState) % (Npts - i)]);
+		subset.assign(all.begin(), all.begin() + params.preemptiveSubsetSize);
+	}
+
+	struct THypothesis
+	{
+		size_t ninliers = 0;
+		MODEL model;
+	};
+	std::vector<THypothesis> batch;
+
+	size_t bestscore = 0;
+	bool found = false;
+	size_t trialcount = 0;
+	size_t N = params.maxIter;
+
+	while (trialcount < std::min(N, params.maxIter))
+	{
+		const size_t nHyps = std::min<size_t>(
+			params.hypothesesPerBatch,
+			std::min(N, params.maxIter) - trialcount);
+		batch.assign(nHyps, THypothesis());
+
+		// Scores of the best model so far, for the early rejection of worse
+		// hypotheses:
+		const size_t curBest = bestscore;
+		const double minSubsetRatio =
+			params.preemptiveRatio * curBest / static_cast<double>(Npts);
+
+		const auto evalHypothesis = [&](size_t h) {
+			// Each hypothesis has its own random sequence:
+			uint64_t st = params.seed ^ (0x51ED270B27A7ULL * (trialcount + h));
+			std::vector<size_t> ind(minimumSizeSamplesToFit);
+			std::vector<MODEL> models;
+			for (size_t count = 0; count < maxDataTrials && models.empty();
+				 count++)
+			{
+				internal::ransacSample(st, Npts, ind);
+				if (!degen_func(data, ind)) fit_func(data, ind, models);
+			}
+			for (auto& m : models)
+			{
+				// Preemptive test on the subset:
+				if (!subset.empty() && curBest > 0)
+				{
+					size_t k = 0;
+					for (size_t i : subset)
+						if (dist_func(data, m, i) < thres) k++;
+					if (k < minSubsetRatio * subset.size()) continue;
+				}
+				// Full scoring, leaving as soon as it cannot beat the best:
+				const size_t target = std::max(curBest, batch[h].ninliers);
+				size_t n = 0;
+				for (size_t i = 0; i < Npts && n + (Npts - i) > target; i++)
+					if (dist_func(data, m, i) < thres) n++;
+				if (n > target)
+				{
+					batch[h].ninliers = n;
+					batch[h].model = std::move(m);
+				}
+			}
+		};
+
+		size_t nThreads = params.numThreads;
+		if (!nThreads)
+			nThreads = std::max(1U, std::thread::hardware_concurrency());
+		nThreads = std::min(nThreads, nHyps);
+		if (nThreads <= 1)
+		{
+			for (size_t h = 0; h < nHyps; h++)
+				evalHypothesis(h);
+		}
+		else
+		{
+			// The calling thread also runs tasks:
+			if (!m_threadPool || m_threadPool->size() < nThreads - 1)
+				m_threadPool = std::make_shared<mrpt::WorkerThreadsPool>(
+					nThreads - 1, mrpt::WorkerThreadsPool::POLICY_FIFO,
+					"ransac");
+			m_threadPool->parallel_for(0, nHyps, 1, evalHypothesis);
+		}
+
+		// Sequential merge, in the order of hypotheses:
+		bool improved = false;
+		for (auto& h : batch)
+		{
+			if (h.ninliers <= bestscore) continue;
+			bestscore = h.ninliers;
+			out_best_model = std::move(h.model);
+			found = improved = true;
+		}
+
+		if (improved || trialcount == 0)
+		{
+			N = internal::ransacNumIters(
+				bestscore, Npts, minimumSizeSamplesToFit,
+				params.prob_good_sample);
+			MRPT_LOG_DEBUG_FMT(
+				"Iter #%u Estimated number of iters: %u #inliers: %u",
+				static_cast<unsigned>(trialcount), static_cast<unsigned>(N),
+				static_cast<unsigned>(bestscore));
+		}
+		trialcount += nHyps;
+	}
+
+	if (trialcount >= params.maxIter && N > params.maxIter)
+		MRPT_LOG_WARN_FMT(
+			"Warning: maximum number of trials (%u) reached\n",
+			static_cast<unsigned>(params.maxIter));
+
+	if (!found)
+	{
+		MRPT_LOG_WARN("Finished without any proper solution");
+		return false;
+	}
+
+	for (size_t i = 0; i < Npts; i++)
+		if (dist_func(data, out_best_model, i) < thres)
+			out_best_inliers.push_back(i);
+
+	MRPT_LOG_INFO_FMT("Finished in %u iterations.", (unsigned)trialcount);
+	return true;
+
+	MRPT_END
+}
+
 }  // namespace mrpt::math
@@ -0,0 +1,415 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "math-precomp.h"  // Precompiled headers
+//
+#include <mrpt/core/WorkerThreadsPool.h>
+#include <mrpt/math/CLevenbergMarquardtSparse.h>
+#include <mrpt/math/ops_containers.h>
+
+#include <Eigen/Dense>
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <thread>
+
+using namespace mrpt::math;
+
+CLevenbergMarquardtSparse::CLevenbergMarquardtSparse()
+	: mrpt::system::COutputLogger("CLevenbergMarquardtSparse")
+{
+}
+
+CLevenbergMarquardtSparse::~CLevenbergMarquardtSparse() = default;
+
+void CLevenbergMarquardtSparse::setParameterBlocks(
+	const std::vector<size_t>& blockSizes)
+{
+	m_paramSizes = blockSizes;
+	m_paramOffsets.resize(blockSizes.size());
+	m_stateDim = 0;
+	for (size_t i = 0; i < blockSizes.size(); i++)
+	{
+		ASSERT_GT_(blockSizes[i], 0U);
+		m_paramOffsets[i] = m_stateDim;
+		m_stateDim += blockSizes[i];
+	}
+	m_resBlocks.clear();
+	m_residualDim = 0;
+	m_patternReady = false;
+	m_chol.reset();
+}
+
+size_t CLevenbergMarquardtSparse::addResidualBlock(
+	size_t dim, const std::vector<size_t>& paramBlocks)
+{
+	ASSERT_GT_(dim, 0U);
+	ASSERT_(!paramBlocks.empty());
+	for (size_t j = 0; j < paramBlocks.size(); j++)
+	{
+		ASSERT_LT_(paramBlocks[j], m_paramSizes.size());
+		ASSERTMSG_(
+			std::count(
+				paramBlocks.begin(), paramBlocks.end(), paramBlocks[j]) == 1,
+			"Repeated parameter block in a residual block");
+	}
+	TResidualBlock rb;
+	rb.dim = dim;
+	rb.params = paramBlocks;
+	rb.offset = m_residualDim;
+	m_residualDim += dim;
+	m_resBlocks.push_back(std::move(rb));
+
+	m_patternReady = false;
+	m_chol.reset();
+	return m_resBlocks.size() - 1;
+}
+
+void CLevenbergMarquardtSparse::buildHessianPattern()
+{
+	const size_t nP = m_paramSizes.size();
+	const size_t N = m_stateDim;
+
+	// Pairs (a,b), a<=b, of blocks coupled by some residual block. All
+	// diagonal blocks are included, so the damped system is always full rank:
+	std::map<std::pair<size_t, size_t>, size_t> pairIdx;
+	std::vector<std::pair<size_t, size_t>> pairs;
+	const auto getPair = [&](size_t a, size_t b) {
+		const auto it = pairIdx.find({a, b});
+		if (it != pairIdx.end()) return it->second;
+		pairIdx[{a, b}] = pairs.size();
+		pairs.emplace_back(a, b);
+		return pairs.size() - 1;
+	};
+	for (size_t a = 0; a < nP; a++)
+		getPair(a, a);
+	for (auto& rb : m_resBlocks)
+	{
+		rb.hessianPairs.clear();
+		for (size_t j1 = 0; j1 < rb.params.size(); j1++)
+			for (size_t j2 = 0; j2 < rb.params.size(); j2++)
+				if (rb.params[j1] <= rb.params[j2])
+					rb.hessianPairs.push_back(
+						getPair(rb.params[j1], rb.params[j2]));
+	}
+
+	// Upper triangular part of the pattern:
+	CSparseMatrix triplet(N, N);
+	std::vector<std::vector<size_t>> pairsByCol(nP);
+	for (size_t pi = 0; pi < pairs.size(); pi++)
+	{
+		const auto [a, b] = pairs[pi];
+		pairsByCol[b].push_back(pi);
+		for (size_t r = 0; r < m_paramSizes[a]; r++)
+			for (size_t c = 0; c < m_paramSizes[b]; c++)
+			{
+				const size_t row = m_paramOffsets[a] + r;
+				const size_t col = m_paramOffsets[b] + c;
+				if (row <= col) triplet.insert_entry(row, col, 1.0);
+			}
+	}
+	triplet.compressFromTriplet();
+	m_H.swap(triplet);
+
+	// Position of each entry of each block pair in the values of m_H:
+	const int* colPtr = m_H.colPointers();
+	const int* rowIdx = m_H.rowIndices();
+	m_blockPairPos.assign(pairs.size(), {});
+	for (size_t pi = 0; pi < pairs.size(); pi++)
+		m_blockPairPos[pi].assign(
+			m_paramSizes[pairs[pi].first] * m_paramSizes[pairs[pi].second], -1);
+	m_diagPos.assign(N, -1);
+
+	std::vector<int> entryOfRow(N, -1);
+	for (size_t b = 0; b < nP; b++)
+	{
+		const size_t sizeB = m_paramSizes[b];
+		for (size_t c = 0; c < sizeB; c++)
+		{
+			const size_t col = m_paramOffsets[b] + c;
+			for (int idx = colPtr[col]; idx < colPtr[col + 1]; idx++)
+				entryOfRow[rowIdx[idx]] = idx;
+
+			for (const size_t pi : pairsByCol[b])
+			{
+				const size_t a = pairs[pi].first;
+				auto& pos = m_blockPairPos[pi];
+				for (size_t r = 0; r < m_paramSizes[a]; r++)
+				{
+					const size_t row = m_paramOffsets[a] + r;
+					if (row <= col) pos[r * sizeB + c] = entryOfRow[row];
+				}
+			}
+			m_diagPos[col] = entryOfRow[col];
+			ASSERT_(m_diagPos[col] >= 0);
+
+			for (int idx = colPtr[col]; idx < colPtr[col + 1]; idx++)
+				entryOfRow[rowIdx[idx]] = -1;
+		}
+	}
+
+	m_H_lm = m_H;
+	m_chol.reset();
+	m_patternReady = true;
+}
+
+double CLevenbergMarquardtSparse::evaluate(
+	const vector_t& x, const TFunctorResidual& functor, bool withJacobians,
+	mrpt::WorkerThreadsPool* pool)
+{
+	const bool userJacobians = withJacobians && !options.numericJacobians;
+	const bool numJacobians = withJacobians && options.numericJacobians;
+	const double h = options.numericJacobianStep;
+
+	const auto evalBlock = [&](size_t k) {
+		const auto& rb = m_resBlocks[k];
+		std::vector<const double*> params(rb.params.size());
+		for (size_t j = 0; j < rb.params.size(); j++)
+			params[j] = &x[m_paramOffsets[rb.params[j]]];
+
+		functor(
+			k, params, m_residuals[k],
+			userJacobians ? &m_jacobians[k] : nullptr);
+		ASSERT_EQUAL_(static_cast<size_t>(m_residuals[k].size()), rb.dim);
+		if (!numJacobians) return;
+
+		// Central differences, perturbing a copy of each parameter block:
+		vector_t errPlus(rb.dim), errMinus(rb.dim);
+		for (size_t j = 0; j < rb.params.size(); j++)
+		{
+			const size_t len = m_paramSizes[rb.params[j]];
+			std::vector<double> block(params[j], params[j] + len);
+			params[j] = block.data();
+			auto& J = m_jacobians[k][j];
+			for (size_t i = 0; i < len; i++)
+			{
+				const double v = block[i];
+				block[i] = v + h;
+				functor(k, params, errPlus, nullptr);
+				block[i] = v - h;
+				functor(k, params, errMinus, nullptr);
+				block[i] = v;
+				for (size_t r = 0; r < rb.dim; r++)
+					J(r, i) = (errPlus[r] - errMinus[r]) / (2 * h);
+			}
+			params[j] = &x[m_paramOffsets[rb.params[j]]];
+		}
+	};
+
+	const size_t nBlocks = m_resBlocks.size();
+	if (pool)
+	{
+		const size_t nThreads = pool->size() + 1;
+		pool->parallel_for(
+			0, nBlocks, std::max<size_t>(1, nBlocks / (4 * nThreads)),
+			evalBlock);
+	}
+	else
+	{
+		for (size_t k = 0; k < nBlocks; k++)
+			evalBlock(k);
+	}
+
+	double sqErr = 0;
+	for (const auto& r : m_residuals)
+		sqErr += r.asEigen().squaredNorm();
+	return sqErr;
+}
+
+void CLevenbergMarquardtSparse::buildHessianAndGradient(vector_t& g)
+{
+	g.setZero(m_stateDim);
+	double* H = m_H.values();
+	std::fill(H, H + m_H.nonZeroCount(), 0.0);
+
+	Eigen::MatrixXd JtJ;
+	for (size_t k = 0; k < m_resBlocks.size(); k++)
+	{
+		const auto& rb = m_resBlocks[k];
+		const auto& err = m_residuals[k];
+		const auto& Js = m_jacobians[k];
+		size_t pairCount = 0;
+		for (size_t j1 = 0; j1 < rb.params.size(); j1++)
+		{
+			const auto J1 = Js[j1].asEigen();
+			g.asEigen()
+				.segment(m_paramOffsets[rb.params[j1]], J1.cols())
+				.noalias() += J1.transpose() * err.asEigen();
+
+			for (size_t j2 = 0; j2 < rb.params.size(); j2++)
+			{
+				if (rb.params[j1] > rb.params[j2]) continue;
+				const auto J2 = Js[j2].asEigen();
+				const auto& pos = m_blockPairPos[rb.hessianPairs[pairCount++]];
+				JtJ.noalias() = J1.transpose() * J2;
+				const size_t nC = JtJ.cols();
+				for (size_t r = 0; r < size_t(JtJ.rows()); r++)
+					for (size_t c = 0; c < nC; c++)
+						if (const int p = pos[r * nC + c]; p >= 0)
+							H[p] += JtJ(r, c);
+			}
+		}
+	}
+}
+
+void CLevenbergMarquardtSparse::execute(
+	vector_t& out_optimal_x, const vector_t& x0,
+	const TFunctorResidual& functor, TResultInfo& out_info,
+	const TFunctorIncrement& x_increment_adder)
+{
+	MRPT_START
+
+	ASSERT_EQUAL_(static_cast<size_t>(x0.size()), m_stateDim);
+	ASSERT_(!m_resBlocks.empty());
+
+	if (!m_patternReady) buildHessianPattern();
+
+	// Storage for the residual blocks:
+	const size_t nBlocks = m_resBlocks.size();
+	m_residuals.resize(nBlocks);
+	m_jacobians.resize(nBlocks);
+	for (size_t k = 0; k < nBlocks; k++)
+	{
+		const auto& rb = m_resBlocks[k];
+		m_residuals[k].resize(rb.dim);
+		m_jacobians[k].resize(rb.params.size());
+		for (size_t j = 0; j < rb.params.size(); j++)
+			m_jacobians[k][j].setSize(rb.dim, m_paramSizes[rb.params[j]]);
+	}
+
+	size_t nThreads = options.numThreads;
+	if (!nThreads) nThreads = std::max(1U, std::thread::hardware_concurrency());
+	nThreads = std::min(nThreads, nBlocks);
+	std::unique_ptr<mrpt::WorkerThreadsPool> pool;
+	// The calling thread also evaluates residual blocks:
+	if (nThreads > 1)
+		pool = std::make_unique<mrpt::WorkerThreadsPool>(
+			nThreads - 1, mrpt::WorkerThreadsPool::POLICY_FIFO, "levmarq");
+
+	vector_t& x = out_optimal_x;  // Var rename
+	x = x0;
+
+	vector_t g;	 // The gradient
+	double F_x = evaluate(x, functor, true, pool.get());
+	buildHessianAndGradient(g);
+	out_info.initial_sqr_err = F_x;
+	// Whether m_residuals holds the errors at "x":
+	bool residualsAtX = true;
+
+	bool found = math::norm_inf(g) <= options.e1;
+	if (found)
+		logFmt(
+			mrpt::system::LVL_INFO,
+			"End condition: math::norm_inf(g)<=e1 :%f\n", math::norm_inf(g));
+
+	double maxDiag = 0;
+	for (const int p : m_diagPos)
+		maxDiag = std::max(maxDiag, m_H.values()[p]);
+	double lambda = options.tau * maxDiag;
+	double v = 2;
+	size_t iter = 0;
+
+	vector_t h_lm, xnew;
+	const size_t nnz = m_H.nonZeroCount();
+
+	while (!found && ++iter < options.maxIter)
+	{
+		// H_lm = -( H + \lambda I ) ^-1 * g
+		std::copy(m_H.values(), m_H.values() + nnz, m_H_lm.values());
+		for (const int p : m_diagPos)
+			m_H_lm.values()[p] += lambda;
+
+		try
+		{
+			if (!m_chol)
+				m_chol =
+					std::make_unique<CSparseMatrix::CholeskyDecomp>(m_H_lm);
+			else
+				m_chol->update(m_H_lm);
+		}
+		catch (const CExceptionNotDefPos&)
+		{
+			// Increase the damping and try again:
+			lambda *= v;
+			v *= 2;
+			continue;
+		}
+		m_chol->backsub(g, h_lm);
+		h_lm *= -1.0;
+
+		const double h_lm_n2 = math::norm(h_lm);
+		const double x_n2 = math::norm(x);
+
+		if (h_lm_n2 < options.e2 * (x_n2 + options.e2))
+		{
+			// Done:
+			found = true;
+			logFmt(
+				mrpt::system::LVL_INFO, "End condition: %e < %e\n", h_lm_n2,
+				options.e2 * (x_n2 + options.e2));
+			continue;
+		}
+
+		// Improvement: xnew = x + h_lm;
+		if (!x_increment_adder)
+			xnew = x + h_lm;  // Normal Euclidean space addition.
+		else
+			x_increment_adder(xnew, x, h_lm);
+
+		const double F_xnew = evaluate(xnew, functor, false, pool.get());
+		residualsAtX = false;
+
+		// denom = h_lm^t * ( \lambda * h_lm - g )
+		vector_t tmp(h_lm);
+		tmp *= lambda;
+		tmp -= g;
+		const double denom = tmp.dot(h_lm);
+		const double l = (F_x - F_xnew) / denom;
+
+		if (l > 0)	// There is an improvement:
+		{
+			// Accept new point:
+			x = xnew;
+			F_x = F_xnew;
+
+			evaluate(x, functor, true, pool.get());
+			residualsAtX = true;
+			buildHessianAndGradient(g);
+
+			found = math::norm_inf(g) <= options.e1;
+			if (found)
+				logFmt(
+					mrpt::system::LVL_INFO,
+					"End condition: math::norm_inf(g)<=e1 : %e\n",
+					math::norm_inf(g));
+
+			lambda *= std::max(0.33, 1 - std::pow(2 * l - 1, 3));
+			v = 2;
+		}
+		else
+		{
+			// Nope...
+			lambda *= v;
+			v *= 2;
+		}
+	}  // end while
+
+	if (!residualsAtX) evaluate(x, functor, false, pool.get());
+
+	// Output info:
+	out_info.final_sqr_err = F_x;
+	out_info.iterations_executed = iter;
+	out_info.last_err_vector.resize(m_residualDim);
+	for (size_t k = 0; k < nBlocks; k++)
+		out_info.last_err_vector.asEigen().segment(
+			m_resBlocks[k].offset, m_resBlocks[k].dim) =
+			m_residuals[k].asEigen();
+
+	MRPT_END
+}
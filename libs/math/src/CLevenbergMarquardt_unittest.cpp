@@ -8,6 +8,9 @@
    +------------------------------------------------------------------------+ */
 
 #include <gtest/gtest.h>
+#include <mrpt/math/CLevenbergMarquardtSparse.h>
+
+#include <random>
 
 // Reuse code from example:
 #include "samples/math_optimize_lm_example/LevMarqTest_impl.cpp"
@@ -17,3 +20,98 @@ TEST(LevMarq, optimizeTest)
 	TestLevMarq();
 	EXPECT_LT(levmarq_final_error, 1e-2);
 }
+
+TEST(LevMarq, sparseChainOfPoints)
+{
+	using mrpt::math::CLevenbergMarquardtSparse;
+
+	// 2D points, with a prior on the first one, their relative positions to
+	// the next one, and distances to another five positions ahead:
+	const size_t nPts = 60;
+	std::vector<double> gt(2 * nPts);
+	for (size_t i = 0; i < nPts; i++)
+	{
+		gt[2 * i] = i;
+		gt[2 * i + 1] = std::sin(0.3 * i);
+	}
+
+	CLevenbergMarquardtSparse lm;
+	lm.setParameterBlocks(std::vector<size_t>(nPts, 2));
+	lm.addResidualBlock(2, {0});
+	for (size_t i = 0; i + 1 < nPts; i++)
+		lm.addResidualBlock(2, {i, i + 1});
+	for (size_t i = 0; i + 5 < nPts; i++)
+		lm.addResidualBlock(1, {i + 5, i});
+	EXPECT_EQ(lm.stateDimension(), 2 * nPts);
+
+	const auto functor = [&](size_t k, const std::vector<const double*>& p,
+							 CLevenbergMarquardtSparse::vector_t& err,
+							 std::vector<CLevenbergMarquardtSparse::matrix_t>*
+								 J) {
+		if (k == 0)
+		{
+			err[0] = p[0][0] - gt[0];
+			err[1] = p[0][1] - gt[1];
+			if (J) (*J)[0].setIdentity();
+		}
+		else if (k < nPts)
+		{
+			const size_t i = k - 1;
+			for (int d = 0; d < 2; d++)
+				err[d] =
+					p[1][d] - p[0][d] - (gt[2 * i + 2 + d] - gt[2 * i + d]);
+			if (J)
+			{
+				(*J)[0].setIdentity();
+				(*J)[0] *= -1.0;
+				(*J)[1].setIdentity();
+			}
+		}
+		else
+		{
+			const size_t i = k - nPts, j = i + 5;
+			const double dx = p[0][0] - p[1][0], dy = p[0][1] - p[1][1];
+			const double gdx = gt[2 * j] - gt[2 * i],
+						 gdy = gt[2 * j + 1] - gt[2 * i + 1];
+			const double dist = std::sqrt(dx * dx + dy * dy);
+			err[0] = dist - std::sqrt(gdx * gdx + gdy * gdy);
+			if (J)
+			{
+				(*J)[0](0, 0) = dx / dist;
+				(*J)[0](0, 1) = dy / dist;
+				(*J)[1](0, 0) = -dx / dist;
+				(*J)[1](0, 1) = -dy / dist;
+			}
+		}
+	};
+
+	std::mt19937 rng(1);
+	std::normal_distribution<double> noise(0, 0.2);
+	mrpt::math::CVectorDouble x0(2 * nPts), x1, x;
+	for (size_t i = 0; i < 2 * nPts; i++)
+		x0[i] = gt[i] + noise(rng);
+
+	CLevenbergMarquardtSparse::TResultInfo info;
+	lm.setMinLoggingLevel(mrpt::system::LVL_ERROR);
+	lm.execute(x1, x0, functor, info);
+	EXPECT_GT(info.initial_sqr_err, 1.0);
+	EXPECT_LT(info.final_sqr_err, 1e-12);
+	EXPECT_EQ(
+		static_cast<size_t>(info.last_err_vector.size()),
+		2 + 2 * (nPts - 1) + (nPts - 5));
+	for (size_t i = 0; i < 2 * nPts; i++)
+		EXPECT_NEAR(x1[i], gt[i], 1e-6);
+
+	// Same result with threads (reusing the symbolic factorization):
+	lm.options.numThreads = 4;
+	lm.execute(x, x0, functor, info);
+	for (size_t i = 0; i < 2 * nPts; i++)
+		EXPECT_EQ(x[i], x1[i]);
+
+	// And with numeric Jacobians:
+	lm.options.numericJacobians = true;
+	lm.execute(x, x0, functor, info);
+	EXPECT_LT(info.final_sqr_err, 1e-12);
+	for (size_t i = 0; i < 2 * nPts; i++)
+		EXPECT_NEAR(x[i], gt[i], 1e-6);
+}
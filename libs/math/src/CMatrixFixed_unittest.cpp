@@ -9,6 +9,7 @@
 
 #include <gtest/gtest.h>
 #include <mrpt/math/CMatrixFixed.h>
+#include <mrpt/math/ops_matrices.h>
 
 #include <Eigen/Dense>
 
@@ -73,3 +74,47 @@ TEST(CMatrixFixed, GetSetEigen)
 			}
 	}
 }
+
+TEST(CMatrixFixed, SmallProductsAndInverseMatchEigen)
+{
+	using namespace mrpt::math;
+	CMatrixFixed<double, 3, 6> H;
+	CMatrixFixed<double, 6, 6> C, A;
+	H.asEigen().setRandom();
+	A.asEigen().setRandom();
+	C.asEigen() = A.asEigen() * A.asEigen().transpose();
+	C.asEigen() += Eigen::Matrix<double, 6, 6>::Identity();
+
+	CMatrixFixed<double, 3, 6> HC;
+	HC.matProductOf_AB(H, C);
+	EXPECT_NEAR((HC.asEigen() - H.asEigen() * C.asEigen()).norm(), 0, 1e-12);
+
+	CMatrixFixed<double, 3, 3> R;
+	R.matProductOf_HCHt(H, C);
+	const Eigen::Matrix3d R_ref =
+		H.asEigen() * C.asEigen() * H.asEigen().transpose();
+	EXPECT_NEAR((R.asEigen() - R_ref).norm(), 0, 1e-10);
+	EXPECT_NEAR((multiply_HCHt(H, C).asEigen() - R_ref).norm(), 0, 1e-10);
+	multiply_HCHt(H, C, R, true);
+	EXPECT_NEAR((R.asEigen() - 2 * R_ref).norm(), 0, 1e-10);
+
+	// Output aliased with an input:
+	const Eigen::Matrix<double, 6, 6> AC_ref = A.asEigen() * C.asEigen();
+	A.matProductOf_AB(A, C);
+	EXPECT_NEAR((A.asEigen() - AC_ref).norm(), 0, 1e-10);
+
+	const CMatrixFixed<double, 6, 6> Cinv = C.inverse_LLt();
+	EXPECT_NEAR(
+		(Cinv.asEigen() * C.asEigen() - Eigen::Matrix<double, 6, 6>::Identity())
+			.norm(),
+		0, 1e-10);
+	EXPECT_EQ(Cinv, Cinv.transpose());
+
+	// Not definite positive: same result than Eigen's LLt
+	CMatrixFixed<double, 2, 2> N;
+	N(0, 0) = 1;
+	N(1, 1) = -1;
+	const Eigen::Matrix2d N_ref =
+		N.asEigen().llt().solve(Eigen::Matrix2d::Identity());
+	EXPECT_EQ(N.inverse_LLt().asEigen(), N_ref);
+}
@@ -11,10 +11,16 @@
 //
 #include <mrpt/math/CSparseMatrix.h>
 
+#include <algorithm>
 #include <cstring>
 #include <iostream>
+#include <mutex>
 #include <string>
 
+#if MRPT_HAS_CHOLMOD
+#include <cholmod.h>
+#endif
+
 using std::cout;
 using std::endl;
 using std::string;
@@ -84,7 +90,7 @@ void CSparseMatrix::swap(CSparseMatrix& other)
 {
 	// Fast copy / Move:
 	std::swap(sparse_matrix.m, other.sparse_matrix.m);
-	std::swap(sparse_matrix.n, sparse_matrix.n);
+	std::swap(sparse_matrix.n, other.sparse_matrix.n);
 	std::swap(sparse_matrix.nz, other.sparse_matrix.nz);
 	std::swap(sparse_matrix.nzmax, other.sparse_matrix.nzmax);
 
@@ -356,21 +362,213 @@ bool CSparseMatrix::saveToTextFile_sparse(const std::string& filName)
  *  \exception mrpt::math::CExceptionNotDefPos On non-semidefinite-positive
  * matrix as input.
  */
+#if MRPT_HAS_CHOLMOD
+namespace
+{
+/** A cholmod_sparse view of the upper triangular part of a column-compressed
+ * CSparse matrix, without copying it */
+cholmod_sparse cholmodViewUpper(const cs& A)
+{
+	cholmod_sparse S{};
+	S.nrow = S.ncol = static_cast<size_t>(A.n);
+	S.nzmax = static_cast<size_t>(A.p[A.n]);
+	S.p = A.p;
+	S.i = A.i;
+	S.x = A.x;
+	S.stype = 1;
+	S.itype = CHOLMOD_INT;
+	S.xtype = CHOLMOD_REAL;
+	S.dtype = CHOLMOD_DOUBLE;
+	S.sorted = 0;
+	S.packed = 1;
+	return S;
+}
+}  // namespace
+
+struct CSparseMatrix::CholeskyDecomp::CholmodImpl
+{
+	CholmodImpl() { cholmod_start(&common); }
+	~CholmodImpl()
+	{
+		freeNumeric();
+		cholmod_free_factor(&symbolic, &common);
+		cholmod_free_dense(&X, &common);
+		cholmod_free_dense(&Y, &common);
+		cholmod_free_dense(&E, &common);
+		cholmod_finish(&common);
+	}
+	CholmodImpl(const CholmodImpl&) = delete;
+	CholmodImpl& operator=(const CholmodImpl&) = delete;
+
+	/** Not thread-safe: all calls to CHOLMOD are protected by `mtx` */
+	mutable cholmod_common common;
+	mutable std::mutex mtx;
+
+	/** The output of cholmod_analyze(), copied for each factorization */
+	cholmod_factor* symbolic = nullptr;
+	/** The numeric factorization, of the permuted matrix */
+	cholmod_factor* L = nullptr;
+	/** Inverse of the fill-reducing permutation L->Perm */
+	std::vector<int> pinv;
+
+	/** A simplicial, packed LL' copy of L and its elimination tree, built
+	 * on demand for get_L() and getInverseDiagonal() */
+	mutable cholmod_factor* Lsimplicial = nullptr;
+	mutable std::vector<int> parent;
+
+	/** Workspaces of cholmod_solve2() */
+	mutable cholmod_dense *X = nullptr, *Y = nullptr, *E = nullptr;
+
+	void freeNumeric()
+	{
+		cholmod_free_factor(&L, &common);
+		cholmod_free_factor(&Lsimplicial, &common);
+	}
+
+	void factorize(const cs& A, const char* errorMsg)
+	{
+		cholmod_sparse S = cholmodViewUpper(A);
+		if (!symbolic)
+		{
+			// Ordering and symbolic analysis, supernodal if it is worth:
+			symbolic = cholmod_analyze(&S, &common);
+			ASSERTMSG_(symbolic, "cholmod_analyze() failed");
+			const int* perm = static_cast<const int*>(symbolic->Perm);
+			pinv.resize(symbolic->n);
+			for (size_t k = 0; k < symbolic->n; k++)
+				pinv[perm[k]] = static_cast<int>(k);
+		}
+		freeNumeric();
+		L = cholmod_copy_factor(symbolic, &common);
+		ASSERTMSG_(L, "cholmod_copy_factor() failed");
+		cholmod_factorize(&S, L, &common);
+		if (common.status == CHOLMOD_NOT_POSDEF)
+			throw mrpt::math::CExceptionNotDefPos(errorMsg);
+		ASSERTMSG_(common.status >= CHOLMOD_OK, "cholmod_factorize() failed");
+	}
+
+	/** Must be called with `mtx` locked */
+	const cholmod_factor& simplicialLL() const
+	{
+		if (Lsimplicial) return *Lsimplicial;
+
+		Lsimplicial = cholmod_copy_factor(L, &common);
+		ASSERTMSG_(Lsimplicial, "cholmod_copy_factor() failed");
+		cholmod_change_factor(
+			CHOLMOD_REAL, 1 /*LL'*/, 0 /*simplicial*/, 1 /*packed*/,
+			1 /*monotonic*/, Lsimplicial, &common);
+		ASSERTMSG_(
+			common.status >= CHOLMOD_OK, "cholmod_change_factor() failed");
+
+		// The parent of a column is its first off-diagonal row. The
+		// diagonal entry always goes first, but rows may be unsorted:
+		const int n = static_cast<int>(Lsimplicial->n);
+		const int* Lp = static_cast<const int*>(Lsimplicial->p);
+		const int* Li = static_cast<const int*>(Lsimplicial->i);
+		parent.assign(n, -1);
+		for (int j = 0; j < n; j++)
+			for (int p = Lp[j] + 1; p < Lp[j + 1]; p++)
+				if (parent[j] < 0 || Li[p] < parent[j]) parent[j] = Li[p];
+		return *Lsimplicial;
+	}
+};
+
+const char* CSparseMatrix::CholeskyDecomp::BackendName() { return "CHOLMOD"; }
+
 CSparseMatrix::CholeskyDecomp::CholeskyDecomp(const CSparseMatrix& SM)
 	: m_symbolic_structure(nullptr),
 	  m_numeric_structure(nullptr),
-	  m_originalSM(&SM)
+	  m_cholmod(std::make_unique<CholmodImpl>())
 {
 	ASSERT_(SM.cols() == SM.rows());
 	ASSERT_(SM.isColumnCompressed());
 
+	// Keep the pattern, to check it in update():
+	const auto& A = SM.sparse_matrix;
+	m_pattern_p.assign(A.p, A.p + A.n + 1);
+	m_pattern_i.assign(A.i, A.i + A.p[A.n]);
+
+	m_cholmod->factorize(
+		A, "CSparseMatrix::CholeskyDecomp: Not positive definite matrix.");
+}
+
+CSparseMatrix::CholeskyDecomp::~CholeskyDecomp() = default;
+
+void CSparseMatrix::CholeskyDecomp::get_L(CMatrixDouble& L) const
+{
+	std::lock_guard<std::mutex> lck(m_cholmod->mtx);
+	const cholmod_factor& F = m_cholmod->simplicialLL();
+	const int n = static_cast<int>(F.n);
+	const int* Lp = static_cast<const int*>(F.p);
+	const int* Li = static_cast<const int*>(F.i);
+	const double* Lx = static_cast<const double*>(F.x);
+	L.setZero(n, n);
+	for (int j = 0; j < n; j++)
+		for (int p = Lp[j]; p < Lp[j + 1]; p++)
+			L(Li[p], j) = Lx[p];
+}
+
+void CSparseMatrix::CholeskyDecomp::backsub(
+	const CVectorDouble& b, CVectorDouble& sol) const
+{
+	ASSERT_(b.size() > 0);
+	sol.resize(b.size());
+	this->backsub(&b[0], &sol[0], b.size());
+}
+
+void CSparseMatrix::CholeskyDecomp::backsub(
+	const double* b, double* sol, const size_t N) const
+{
+	auto& I = *m_cholmod;
+	ASSERT_EQUAL_(N, I.L->n);
+
+	cholmod_dense B{};
+	B.nrow = B.nzmax = B.d = N;
+	B.ncol = 1;
+	B.x = const_cast<double*>(b);
+	B.xtype = CHOLMOD_REAL;
+	B.dtype = CHOLMOD_DOUBLE;
+
+	std::lock_guard<std::mutex> lck(I.mtx);
+	if (!cholmod_solve2(
+			CHOLMOD_A, I.L, &B, nullptr, &I.X, nullptr, &I.Y, &I.E,
+			&I.common))
+		THROW_EXCEPTION("cholmod_solve2() failed");
+	std::memcpy(sol, I.X->x, N * sizeof(double));
+}
+
+void CSparseMatrix::CholeskyDecomp::update(const CSparseMatrix& new_SM)
+{
+	ASSERTMSG_(
+		hasSameSparsityPattern(new_SM),
+		"New matrix doesn't have the same sparse structure!");
+
+	std::lock_guard<std::mutex> lck(m_cholmod->mtx);
+	m_cholmod->factorize(
+		new_SM.sparse_matrix,
+		"CholeskyDecomp::update: Not positive definite matrix.");
+}
+
+#else  // MRPT_HAS_CHOLMOD
+
+const char* CSparseMatrix::CholeskyDecomp::BackendName() { return "CSparse"; }
+
+CSparseMatrix::CholeskyDecomp::CholeskyDecomp(const CSparseMatrix& SM)
+	: m_symbolic_structure(nullptr), m_numeric_structure(nullptr)
+{
+	ASSERT_(SM.cols() == SM.rows());
+	ASSERT_(SM.isColumnCompressed());
+
+	// Keep the pattern, to check it in update():
+	const auto& A = SM.sparse_matrix;
+	m_pattern_p.assign(A.p, A.p + A.n + 1);
+	m_pattern_i.assign(A.i, A.i + A.p[A.n]);
+
 	// symbolic decomposition:
-	m_symbolic_structure =
-		cs_schol(1 /* order */, &m_originalSM->sparse_matrix);
+	m_symbolic_structure = cs_schol(1 /* order */, &A);
 
 	// numeric decomposition:
-	m_numeric_structure =
-		cs_chol(&m_originalSM->sparse_matrix, m_symbolic_structure);
+	m_numeric_structure = cs_chol(&A, m_symbolic_structure);
 
 	if (!m_numeric_structure)
 		throw mrpt::math::CExceptionNotDefPos(
@@ -427,25 +625,186 @@ void CSparseMatrix::CholeskyDecomp::backsub(
 void CSparseMatrix::CholeskyDecomp::update(const CSparseMatrix& new_SM)
 {
 	ASSERTMSG_(
-		m_originalSM->sparse_matrix.nzmax == new_SM.sparse_matrix.nzmax,
-		"New matrix doesn't have the same sparse structure!");
-	ASSERTMSG_(
-		m_originalSM->sparse_matrix.n == new_SM.sparse_matrix.n,
+		hasSameSparsityPattern(new_SM),
 		"New matrix doesn't have the same sparse structure!");
 
-	m_originalSM = &new_SM;	 // Just copy the reference.
-
 	// Release old data:
 	cs_nfree(m_numeric_structure);
 	m_numeric_structure = nullptr;
 
 	// numeric decomposition:
 	m_numeric_structure =
-		cs_chol(&m_originalSM->sparse_matrix, m_symbolic_structure);
+		cs_chol(&new_SM.sparse_matrix, m_symbolic_structure);
 	if (!m_numeric_structure)
 		throw mrpt::math::CExceptionNotDefPos(
 			"CholeskyDecomp::update: Not positive definite matrix.");
 }
 
+#endif	// MRPT_HAS_CHOLMOD
+
+bool CSparseMatrix::CholeskyDecomp::hasSameSparsityPattern(
+	const CSparseMatrix& SM) const
+{
+	if (!SM.isColumnCompressed()) return false;
+	const auto& A = SM.sparse_matrix;
+	if (static_cast<size_t>(A.n) + 1 != m_pattern_p.size()) return false;
+	if (!std::equal(m_pattern_p.begin(), m_pattern_p.end(), A.p))
+		return false;
+	return std::equal(m_pattern_i.begin(), m_pattern_i.end(), A.i);
+}
+
+#if MRPT_HAS_CHOLMOD
+void CSparseMatrix::CholeskyDecomp::rankOneUpdate(
+	const std::vector<std::pair<size_t, double>>& c, bool downdate)
+{
+	auto& I = *m_cholmod;
+	if (c.empty()) return;
+
+	// c, in the order of the fill-reducing permutation and sorted, as a
+	// 1-column matrix:
+	const size_t n = I.L->n;
+	std::vector<std::pair<int, double>> pc;
+	for (const auto& [idx, val] : c)
+	{
+		ASSERT_LT_(idx, n);
+		pc.emplace_back(I.pinv[idx], val);
+	}
+	std::sort(pc.begin(), pc.end());
+	std::vector<int> colPtr = {0, static_cast<int>(pc.size())}, rows;
+	std::vector<double> vals;
+	for (const auto& [row, val] : pc)
+	{
+		rows.push_back(row);
+		vals.push_back(val);
+	}
+	cholmod_sparse C{};
+	C.nrow = n;
+	C.ncol = 1;
+	C.nzmax = pc.size();
+	C.p = colPtr.data();
+	C.i = rows.data();
+	C.x = vals.data();
+	C.stype = 0;
+	C.itype = CHOLMOD_INT;
+	C.xtype = CHOLMOD_REAL;
+	C.dtype = CHOLMOD_DOUBLE;
+	C.sorted = 1;
+	C.packed = 1;
+
+	std::lock_guard<std::mutex> lck(I.mtx);
+	cholmod_free_factor(&I.Lsimplicial, &I.common);
+	// (This turns L into a simplicial LDL' factorization, if it was not)
+	if (!cholmod_updown(downdate ? 0 : 1, &C, I.L, &I.common) ||
+		I.common.status == CHOLMOD_NOT_POSDEF)
+		throw mrpt::math::CExceptionNotDefPos(
+			"CholeskyDecomp::rankOneUpdate: Not positive definite matrix.");
+}
+
+void CSparseMatrix::CholeskyDecomp::getInverseDiagonal(
+	const std::vector<size_t>& indices, CVectorDouble& out) const
+{
+	const auto& I = *m_cholmod;
+	const cholmod_factor* F;
+	{
+		std::lock_guard<std::mutex> lck(I.mtx);
+		F = &I.simplicialLL();
+	}
+	const int* Lp = static_cast<const int*>(F->p);
+	const int* Li = static_cast<const int*>(F->i);
+	const double* Lx = static_cast<const double*>(F->x);
+	const int n = static_cast<int>(F->n);
+
+	// Same algorithm than the CSparse version below:
+	std::vector<double> x(n, 0.0);
+	out.resize(indices.size());
+	for (size_t k = 0; k < indices.size(); k++)
+	{
+		ASSERT_LT_(indices[k], static_cast<size_t>(n));
+		const int start = I.pinv[indices[k]];
+		x[start] = 1.0;
+		double sqNorm = 0;
+		for (int j = start; j != -1; j = I.parent[j])
+		{
+			int p = Lp[j];
+			x[j] /= Lx[p];	// The diagonal entry goes first
+			const double xj = x[j];
+			sqNorm += xj * xj;
+			for (p++; p < Lp[j + 1]; p++)
+				x[Li[p]] -= Lx[p] * xj;
+		}
+		for (int j = start; j != -1; j = I.parent[j])
+			x[j] = 0;
+		out[k] = sqNorm;
+	}
+}
+
+#else  // MRPT_HAS_CHOLMOD
+
+void CSparseMatrix::CholeskyDecomp::rankOneUpdate(
+	const std::vector<std::pair<size_t, double>>& c, bool downdate)
+{
+	ASSERT_(m_numeric_structure && m_symbolic_structure);
+	if (c.empty()) return;
+
+	// c, in the order of the fill-reducing permutation, as a 1-column matrix:
+	const int n = m_numeric_structure->L->n;
+	std::vector<int> colPtr = {0, static_cast<int>(c.size())}, rows;
+	std::vector<double> vals;
+	for (const auto& [idx, val] : c)
+	{
+		ASSERT_LT_(idx, static_cast<size_t>(n));
+		rows.push_back(m_symbolic_structure->pinv[idx]);
+		vals.push_back(val);
+	}
+	cs C;
+	C.nzmax = static_cast<int>(c.size());
+	C.m = n;
+	C.n = 1;
+	C.p = colPtr.data();
+	C.i = rows.data();
+	C.x = vals.data();
+	C.nz = -1;
+
+	if (!cs_updown(
+			m_numeric_structure->L, downdate ? -1 : +1, &C,
+			m_symbolic_structure->parent))
+		throw mrpt::math::CExceptionNotDefPos(
+			"CholeskyDecomp::rankOneUpdate: Not positive definite matrix.");
+}
+
+void CSparseMatrix::CholeskyDecomp::getInverseDiagonal(
+	const std::vector<size_t>& indices, CVectorDouble& out) const
+{
+	ASSERT_(m_numeric_structure && m_symbolic_structure);
+	const cs* L = m_numeric_structure->L;
+	const int* parent = m_symbolic_structure->parent;
+	const int n = L->n;
+
+	// (A^-1)_ii = |inv(L)*P*e_i|^2, and the nonzero entries of inv(L)*e_k
+	// are those of the path from k to the root in the elimination tree:
+	std::vector<double> x(n, 0.0);
+	out.resize(indices.size());
+	for (size_t k = 0; k < indices.size(); k++)
+	{
+		ASSERT_LT_(indices[k], static_cast<size_t>(n));
+		const int start = m_symbolic_structure->pinv[indices[k]];
+		x[start] = 1.0;
+		double sqNorm = 0;
+		for (int j = start; j != -1; j = parent[j])
+		{
+			int p = L->p[j];
+			x[j] /= L->x[p];  // The diagonal entry goes first
+			const double xj = x[j];
+			sqNorm += xj * xj;
+			for (p++; p < L->p[j + 1]; p++)
+				x[L->i[p]] -= L->x[p] * xj;
+		}
+		for (int j = start; j != -1; j = parent[j])
+			x[j] = 0;
+		out[k] = sqNorm;
+	}
+}
+#endif	// MRPT_HAS_CHOLMOD
+
 // ===============    END OF: CSparseMatrix::CholeskyDecomp  inner class
 // ==============================
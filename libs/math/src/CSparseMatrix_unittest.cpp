@@ -235,3 +235,138 @@ TEST(SparseMatrix, CholeskyDecomp)
 	const double err = (Ud.transpose() - L.asEigen()).array().abs().mean();
 	EXPECT_TRUE(err < 1e-8);
 }
+
+TEST(SparseMatrix, CholeskyDecompUpdate)
+{
+	auto& rng = mrpt::random::getRandomGenerator();
+	const auto buildMatrix = [&](bool extraBlock) {
+		CSparseMatrix SM(10, 10);
+		SM.insert_submatrix(
+			0, 0, rng.drawDefinitePositiveMatrix<CMatrixDouble>(6, 0.2));
+		SM.insert_submatrix(
+			6, 6, rng.drawDefinitePositiveMatrix<CMatrixDouble>(4, 0.2));
+		if (extraBlock) SM.insert_entry(0, 9, 0.01);
+		SM.compressFromTriplet();
+		return SM;
+	};
+
+	const CSparseMatrix SM1 = buildMatrix(false);
+	CSparseMatrix::CholeskyDecomp Chol(SM1);
+
+	// Same pattern, new values: only numeric refactorization
+	const CSparseMatrix SM2 = buildMatrix(false);
+	EXPECT_TRUE(Chol.hasSameSparsityPattern(SM2));
+	Chol.update(SM2);
+
+	CMatrixDouble D, Ud;
+	SM2.get_dense(D);
+	D.chol(Ud);
+	const CMatrixDouble L = Chol.get_L();
+	const double err = (Ud.transpose() - L.asEigen()).array().abs().mean();
+	EXPECT_LT(err, 1e-8);
+
+	// Different pattern:
+	const CSparseMatrix SM3 = buildMatrix(true);
+	EXPECT_FALSE(Chol.hasSameSparsityPattern(SM3));
+	EXPECT_ANY_THROW(Chol.update(SM3));
+}
+
+TEST(SparseMatrix, CholeskyDecompRankOneAndInverseDiagonal)
+{
+	auto& rng = mrpt::random::getRandomGenerator();
+	// Two well-conditioned diagonal blocks:
+	CSparseMatrix SM(10, 10);
+	CMatrixDouble B1 = rng.drawDefinitePositiveMatrix<CMatrixDouble>(6, 0.2);
+	CMatrixDouble B2 = rng.drawDefinitePositiveMatrix<CMatrixDouble>(4, 0.2);
+	B1.asEigen() += Eigen::MatrixXd::Identity(6, 6);
+	B2.asEigen() += Eigen::MatrixXd::Identity(4, 4);
+	SM.insert_submatrix(0, 0, B1);
+	SM.insert_submatrix(6, 6, B2);
+	SM.compressFromTriplet();
+	CMatrixDouble D;
+	SM.get_dense(D);
+
+	CSparseMatrix::CholeskyDecomp Chol(SM);
+
+	CVectorDouble b(10), x;
+	for (int i = 0; i < 10; i++)
+		b[i] = rng.drawGaussian1D(0, 1);
+
+	// A + c*c^T, with c=0.7*e_3:
+	Chol.rankOneUpdate({{3, 0.7}});
+	CMatrixDouble D2 = D;
+	D2(3, 3) += 0.49;
+	Chol.backsub(b, x);
+	const Eigen::VectorXd x2 = D2.asEigen().llt().solve(b.asEigen());
+	EXPECT_LT((x.asEigen() - x2).norm(), 1e-8);
+
+	// And back to A:
+	Chol.rankOneUpdate({{3, 0.7}}, true /*downdate*/);
+	Chol.backsub(b, x);
+	const Eigen::VectorXd x1 = D.asEigen().llt().solve(b.asEigen());
+	EXPECT_LT((x.asEigen() - x1).norm(), 1e-8);
+
+	// Diagonal of the inverse:
+	const std::vector<size_t> idxs = {0, 3, 9, 6};
+	CVectorDouble invDiag;
+	Chol.getInverseDiagonal(idxs, invDiag);
+	const CMatrixDouble Dinv = D.inverse_LLt();
+	ASSERT_EQ(invDiag.size(), 4);
+	for (size_t k = 0; k < idxs.size(); k++)
+		EXPECT_NEAR(invDiag[k], Dinv(idxs[k], idxs[k]), 1e-8);
+}
+
+TEST(SparseMatrix, CholeskyDecompGraphLikeMatrix)
+{
+	// Information matrix of a ring of 2D poses with some loop closures, as
+	// in graph-SLAM, for whatever backend the library was built with:
+	const int nNodes = 40, B = 3, N = nNodes * B;
+	CMatrixDouble H(N, N);
+	H.setZero();
+	auto lmbAddEdge = [&](int i, int j, double w) {
+		for (int k = 0; k < B; k++)
+		{
+			H(i * B + k, i * B + k) += w;
+			H(j * B + k, j * B + k) += w;
+			H(i * B + k, j * B + k) -= w;
+			H(j * B + k, i * B + k) -= w;
+		}
+	};
+	for (int i = 0; i + 1 < nNodes; i++)
+		lmbAddEdge(i, i + 1, 1.0 + 0.01 * i);
+	for (int i = 0; i + 7 < nNodes; i += 5)
+		lmbAddEdge(i, i + 7, 0.5);
+	for (int k = 0; k < B; k++)
+		H(k, k) += 10.0;  // Prior on the first node
+
+	const CSparseMatrix SM(H);
+	CSparseMatrix::CholeskyDecomp Chol(SM);
+
+	CVectorDouble b(N), x;
+	for (int i = 0; i < N; i++)
+		b[i] = std::sin(0.1 * i);
+	Chol.backsub(b, x);
+	const Eigen::VectorXd x1 = H.asEigen().llt().solve(b.asEigen());
+	EXPECT_LT((x.asEigen() - x1).norm(), 1e-8) << Chol.BackendName();
+
+	// L*L^T is a permutation of H, with the same trace:
+	const CMatrixDouble L = Chol.get_L();
+	EXPECT_NEAR(
+		(L.asEigen() * L.asEigen().transpose()).trace(), H.asEigen().trace(),
+		1e-8);
+
+	// Numeric updates, after a rank-one update:
+	Chol.rankOneUpdate({{5, 0.3}});
+	CMatrixDouble H2 = H;
+	H2.asEigen() *= 2.0;
+	Chol.update(CSparseMatrix(H2));
+	Chol.backsub(b, x);
+	EXPECT_LT((x.asEigen() - 0.5 * x1).norm(), 1e-8);
+
+	const std::vector<size_t> idxs = {0, 17, N - 1};
+	CVectorDouble invDiag;
+	Chol.getInverseDiagonal(idxs, invDiag);
+	const CMatrixDouble H2inv = H2.inverse_LLt();
+	for (size_t k = 0; k < idxs.size(); k++)
+		EXPECT_NEAR(invDiag[k], H2inv(idxs[k], idxs[k]), 1e-8);
+}
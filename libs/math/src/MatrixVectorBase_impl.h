@@ -10,14 +10,17 @@
 
 #include <mrpt/core/exceptions.h>
 #include <mrpt/math/MatrixVectorBase.h>
+#include <mrpt/system/text_parsing.h>
 
 #include <Eigen/Dense>
 #include <cstdint>
 #include <cstdio>  // fopen(),...
 #include <ctime>  // time(),...
 #include <fstream>	// ifstream
+#include <iterator>
 #include <sstream>	// stringstream
 #include <stdexcept>
+#include <string_view>
 #include <vector>
 
 namespace mrpt::math
@@ -226,103 +229,97 @@ void MatrixVectorBase<Scalar, Derived>::saveToTextFile(
 	::fclose(f);
 }
 
+namespace internal
+{
+/** Implementation of MatrixVectorBase::loadFromTextFile(), parsing a whole
+ * text in memory */
 template <typename Scalar, class Derived>
-void MatrixVectorBase<Scalar, Derived>::loadFromTextFile(std::istream& f)
+void loadFromText(std::string_view text, Derived& M)
 {
 	using Index = typename Derived::Index;
-	std::string str;
-	std::vector<double> fil(512);
+	std::vector<double> fil;
+	fil.reserve(512);
 	size_t nRows = 0;
-	while (!f.eof() && !f.fail())
-	{
-		std::getline(f, str);
-		if (str.size() && str[0] != '#' && str[0] != '%')
+	mrpt::system::for_each_line(text, [&](std::string_view str) {
+		if (str.empty() || str[0] == '#' || str[0] == '%') return true;
+
+		// Parse row to floats. "i": # of columns:
+		fil.clear();
+		const size_t i = mrpt::system::parse_numbers(str, fil);
+
+		if (!i && nRows == 0)
+			throw std::runtime_error("loadFromTextFile: Empty first line!");
+
+		if ((Derived::ColsAtCompileTime != Eigen::Dynamic &&
+			 Index(i) != Derived::ColsAtCompileTime))
+			throw std::runtime_error(
+				"loadFromTextFile: The matrix in the text file does not "
+				"match fixed matrix size");
+		if (Derived::ColsAtCompileTime == Eigen::Dynamic && nRows > 0 &&
+			Index(i) != M.cols())
+			throw std::runtime_error(
+				"loadFromTextFile: The matrix in the text file does not "
+				"have the same number of columns in all rows");
+
+		// Append to the matrix:
+		if (Derived::RowsAtCompileTime == Eigen::Dynamic ||
+			Derived::ColsAtCompileTime == Eigen::Dynamic)
 		{
-			// Parse row to floats:
-			const char* ptr = str.c_str();
-			char* ptrEnd = nullptr;
-			size_t i = 0;
-			// Process each number in this row:
-			while (ptr[0] && ptr != ptrEnd)
-			{
-				// Find next number: (non white-space character):
-				while (ptr[0] &&
-					   (ptr[0] == ' ' || ptr[0] == ',' || ptr[0] == '\t' ||
-						ptr[0] == '\r' || ptr[0] == '\n'))
-					ptr++;
-				if (fil.size() <= i) fil.resize(fil.size() + (fil.size() >> 1));
-				// Convert to "double":
-				fil[i] = strtod(ptr, &ptrEnd);
-				// A valid conversion has been done?
-				if (ptr != ptrEnd)
-				{
-					i++;  // Yes
-					ptr = ptrEnd;
-					ptrEnd = nullptr;
-				}
-			};	// end while procesing this row
-
-			if (!i && nRows == 0)
-				throw std::runtime_error("loadFromTextFile: Empty first line!");
-
-			// "i": # of columns:
-			if ((Derived::ColsAtCompileTime != Eigen::Dynamic &&
-				 Index(i) != Derived::ColsAtCompileTime))
-				throw std::runtime_error(
-					"loadFromTextFile: The matrix in the text file does not "
-					"match fixed matrix size");
-			if (Derived::ColsAtCompileTime == Eigen::Dynamic && nRows > 0 &&
-				Index(i) != mvbDerived().cols())
-				throw std::runtime_error(
-					"loadFromTextFile: The matrix in the text file does not "
-					"have the same number of columns in all rows");
-
-			// Append to the matrix:
-			if (Derived::RowsAtCompileTime == Eigen::Dynamic ||
-				Derived::ColsAtCompileTime == Eigen::Dynamic)
+			if (M.rows() < static_cast<int>(nRows + 1) ||
+				M.cols() < static_cast<int>(i))
 			{
-				if (mvbDerived().rows() < static_cast<int>(nRows + 1) ||
-					mvbDerived().cols() < static_cast<int>(i))
-				{
-					const size_t extra_rows =
-						std::max(static_cast<size_t>(1), nRows >> 1);
-					mvbDerived().resize(nRows + extra_rows, i);
-				}
+				const size_t extra_rows =
+					std::max(static_cast<size_t>(1), nRows >> 1);
+				M.resize(nRows + extra_rows, i);
 			}
-			else if (
-				Derived::RowsAtCompileTime != Eigen::Dynamic &&
-				int(nRows) >= Derived::RowsAtCompileTime)
-				throw std::runtime_error(
-					"loadFromTextFile: Read more rows than the capacity of the "
-					"fixed sized matrix.");
+		}
+		else if (
+			Derived::RowsAtCompileTime != Eigen::Dynamic &&
+			int(nRows) >= Derived::RowsAtCompileTime)
+			throw std::runtime_error(
+				"loadFromTextFile: Read more rows than the capacity of the "
+				"fixed sized matrix.");
 
-			for (size_t q = 0; q < i; q++)
-				mvbDerived()(nRows, q) = Scalar(fil[q]);
+		for (size_t q = 0; q < i; q++)
+			M(nRows, q) = Scalar(fil[q]);
 
-			nRows++;
-		}  // end if fgets
-	}  // end while not feof
+		nRows++;
+		return true;
+	});
 
 	// Final resize to the real size (in case we allocated space in advance):
 	if (Derived::RowsAtCompileTime == Eigen::Dynamic ||
 		Derived::ColsAtCompileTime == Eigen::Dynamic)
-		mvbDerived().resize(nRows, mvbDerived().cols());
+		M.resize(nRows, M.cols());
 
 	// Report error as exception
 	if (!nRows)
 		throw std::runtime_error(
 			"loadFromTextFile: Error loading from text file");
 }
+}  // namespace internal
+
+template <typename Scalar, class Derived>
+void MatrixVectorBase<Scalar, Derived>::loadFromTextFile(std::istream& f)
+{
+	// Parsing the whole text at once is much faster than line by line:
+	const std::string text{
+		std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>()};
+	internal::loadFromText<Scalar>(text, mvbDerived());
+}
 
 template <typename Scalar, class Derived>
 void MatrixVectorBase<Scalar, Derived>::loadFromTextFile(
 	const std::string& file)
 {
-	std::ifstream f(file.c_str());
+	std::ifstream f(file.c_str(), std::ios::binary | std::ios::ate);
 	if (f.fail())
 		throw std::runtime_error(
 			std::string("loadFromTextFile: can't open file:") + file);
-	loadFromTextFile(f);
+	std::string text(static_cast<size_t>(f.tellg()), '\0');
+	f.seekg(0);
+	f.read(&text[0], static_cast<std::streamsize>(text.size()));
+	internal::loadFromText<Scalar>(text, mvbDerived());
 }
 
 template <typename Scalar, class Derived>
@@ -9,7 +9,16 @@
 
 #include "math-precomp.h"  // Precompiled headers
 //
+#include <mrpt/core/WorkerThreadsPool.h>
+#include <mrpt/core/exceptions.h>
 #include <mrpt/math/kmeans.h>
+#include <mrpt/random/RandomGenerators.h>
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <random>
+#include <thread>
 
 // This file is just a stub for the k-means++ library so MRPT users don't need
 //  to include those headers too.
@@ -28,20 +37,20 @@ namespace mrpt::math::detail
    ------------------------------------------- */
 template <>
 double internal_kmeans<double>(
-	[[maybe_unused]] const bool use_kmeansplusplus_method, const size_t nPoints,
-	const size_t k, const size_t dims, const double* points,
-	const size_t attempts, double* out_center, int* out_assignments)
+	const bool use_kmeansplusplus_method, const size_t nPoints, const size_t k,
+	const size_t dims, const double* points, const size_t attempts,
+	double* out_center, int* out_assignments)
 {
-	return RunKMeans(
+	return (use_kmeansplusplus_method ? RunKMeansPlusPlus : RunKMeans)(
 		nPoints, k, dims, const_cast<double*>(points), attempts, out_center,
 		out_assignments);
 }
 
 template <>
 double internal_kmeans<float>(
-	[[maybe_unused]] const bool use_kmeansplusplus_method, const size_t nPoints,
-	const size_t k, const size_t dims, const float* points,
-	const size_t attempts, float* out_center, int* out_assignments)
+	const bool use_kmeansplusplus_method, const size_t nPoints, const size_t k,
+	const size_t dims, const float* points, const size_t attempts,
+	float* out_center, int* out_assignments)
 {
 	std::vector<double> points_d(nPoints * dims);
 	std::vector<double> centers_d(k * dims);
@@ -49,7 +58,8 @@ double internal_kmeans<float>(
 	for (size_t i = 0; i < nPoints * dims; i++)
 		points_d[i] = double(points[i]);
 
-	const double ret = RunKMeans(
+	const double ret = (use_kmeansplusplus_method ? RunKMeansPlusPlus
+												  : RunKMeans)(
 		nPoints, k, dims, &points_d[0], attempts, &centers_d[0],
 		out_assignments);
 
@@ -60,4 +70,354 @@ double internal_kmeans<float>(
 
 	return ret;
 }
+
+namespace
+{
+// Points per chunk of the parallel loops. Fixed (not depending on the number
+// of threads), so partial sums are always reduced in the same order.
+constexpr size_t KMEANS_CHUNK = 2048;
+
+template <typename T>
+class KMeansParallelImpl
+{
+   public:
+	KMeansParallelImpl(
+		const size_t k, const T* points, const size_t nPoints,
+		const size_t dims, const size_t stride,
+		const TKMeansParallelOptions& opts)
+		: m_k(k),
+		  m_pts(points),
+		  m_N(nPoints),
+		  m_dims(dims),
+		  m_stride(stride),
+		  m_opts(opts),
+		  m_nChunks((nPoints + KMEANS_CHUNK - 1) / KMEANS_CHUNK)
+	{
+		size_t nThreads = opts.numThreads;
+		if (!nThreads)
+			nThreads = std::max(1U, std::thread::hardware_concurrency());
+		nThreads = std::min(nThreads, m_nChunks);
+		// The calling thread also runs chunks:
+		if (nThreads > 1)
+			m_pool = std::make_unique<mrpt::WorkerThreadsPool>(
+				nThreads - 1, mrpt::WorkerThreadsPool::POLICY_FIFO, "kmeans");
+
+		m_centers.resize(k * dims);
+		if (opts.kmeansplusplus) m_minDist2.resize(nPoints);
+		m_chunkSums.resize(m_nChunks * k * dims);
+		m_chunkCounts.resize(m_nChunks * k);
+		m_chunkCost.resize(m_nChunks);
+		m_chunkChanged.resize(m_nChunks);
+	}
+
+	// One attempt. Returns the cost; centers in m_centers.
+	double run(mrpt::random::Generator_Xoshiro256pp& rng, int* assignments)
+	{
+		if (m_opts.kmeansplusplus) seedKMeansPlusPlus(rng);
+		else
+			seedRandom(rng);
+
+		if (m_opts.miniBatchSize > 0)
+		{
+			miniBatch(rng);
+			return assign(assignments, false);
+		}
+
+		std::fill(assignments, assignments + m_N, -1);
+		double cost = std::numeric_limits<double>::max();
+		for (size_t iter = 0; iter < m_opts.maxIterations; iter++)
+		{
+			const double newCost = assign(assignments, true);
+			bool changed = false;
+			for (size_t c = 0; c < m_nChunks; c++)
+				changed = changed || m_chunkChanged[c];
+			const bool converged = !changed ||
+				newCost >= cost * (1.0 - m_opts.relativeTolerance);
+			cost = newCost;
+			if (converged) return cost;
+			updateCenters();
+		}
+		// Out of iterations: assignments for the last updated centers.
+		return assign(assignments, false);
+	}
+
+	const std::vector<double>& centers() const { return m_centers; }
+
+   private:
+	const size_t m_k;
+	const T* m_pts;
+	const size_t m_N, m_dims, m_stride;
+	const TKMeansParallelOptions& m_opts;
+	const size_t m_nChunks;
+	std::unique_ptr<mrpt::WorkerThreadsPool> m_pool;
+
+	std::vector<double> m_centers;	//!< k x dims
+	std::vector<double> m_minDist2;	 //!< per point, for k-means++ seeding
+	std::vector<double> m_chunkSums;  //!< nChunks x k x dims
+	std::vector<size_t> m_chunkCounts;	//!< nChunks x k
+	std::vector<double> m_chunkCost;
+	std::vector<char> m_chunkChanged;
+
+	const T* point(size_t i) const { return m_pts + i * m_stride; }
+
+	double dist2(const T* p, const double* c) const
+	{
+		double d2 = 0;
+		for (size_t j = 0; j < m_dims; j++)
+		{
+			const double d = double(p[j]) - c[j];
+			d2 += d * d;
+		}
+		return d2;
+	}
+
+	template <class FUNC>
+	void forEachChunk(FUNC&& fn)
+	{
+		if (m_pool) m_pool->parallel_for(0, m_nChunks, 1, fn);
+		else
+			for (size_t c = 0; c < m_nChunks; c++)
+				fn(c);
+	}
+
+	template <class FUNC>
+	void forEachIndex(size_t n, FUNC&& fn)
+	{
+		if (m_pool && n > KMEANS_CHUNK)
+			m_pool->parallel_for(0, n, KMEANS_CHUNK, fn);
+		else
+			for (size_t i = 0; i < n; i++)
+				fn(i);
+	}
+
+	void setCenter(size_t c, const T* p)
+	{
+		for (size_t j = 0; j < m_dims; j++)
+			m_centers[c * m_dims + j] = p[j];
+	}
+
+	// Returns the index of the closest center, and its squared distance:
+	size_t closest(const T* p, double& bestD2) const
+	{
+		size_t best = 0;
+		bestD2 = std::numeric_limits<double>::max();
+		for (size_t c = 0; c < m_k; c++)
+		{
+			const double d2 = dist2(p, &m_centers[c * m_dims]);
+			if (d2 < bestD2)
+			{
+				bestD2 = d2;
+				best = c;
+			}
+		}
+		return best;
+	}
+
+	void seedRandom(mrpt::random::Generator_Xoshiro256pp& rng)
+	{
+		// k distinct points (Floyd's sampling algorithm):
+		std::vector<size_t> chosen;
+		for (size_t j = m_N - m_k; j < m_N; j++)
+		{
+			const size_t t = std::uniform_int_distribution<size_t>(0, j)(rng);
+			if (std::find(chosen.begin(), chosen.end(), t) == chosen.end())
+				chosen.push_back(t);
+			else
+				chosen.push_back(j);
+		}
+		for (size_t c = 0; c < m_k; c++)
+			setCenter(c, point(chosen[c]));
+	}
+
+	// k-means++ seeding (Arthur & Vassilvitskii, 2007): each new center is
+	// drawn with a probability proportional to the squared distance of points
+	// to their closest center so far. Distances are updated in parallel, and
+	// the draw first picks a chunk from the per-chunk sums.
+	void seedKMeansPlusPlus(mrpt::random::Generator_Xoshiro256pp& rng)
+	{
+		std::uniform_real_distribution<double> unif(0.0, 1.0);
+		size_t next = std::uniform_int_distribution<size_t>(0, m_N - 1)(rng);
+		std::fill(
+			m_minDist2.begin(), m_minDist2.end(),
+			std::numeric_limits<double>::max());
+		for (size_t c = 0; c < m_k; c++)
+		{
+			setCenter(c, point(next));
+			if (c + 1 == m_k) break;
+
+			const double* ctr = &m_centers[c * m_dims];
+			forEachChunk([&](size_t ch) {
+				const size_t i1 = std::min(m_N, (ch + 1) * KMEANS_CHUNK);
+				double sum = 0;
+				for (size_t i = ch * KMEANS_CHUNK; i < i1; i++)
+				{
+					const double d2 = dist2(point(i), ctr);
+					if (d2 < m_minDist2[i]) m_minDist2[i] = d2;
+					sum += m_minDist2[i];
+				}
+				m_chunkCost[ch] = sum;
+			});
+			double total = 0;
+			for (size_t ch = 0; ch < m_nChunks; ch++)
+				total += m_chunkCost[ch];
+			if (total <= 0)
+			{
+				// All points coincide with the centers so far:
+				next = std::uniform_int_distribution<size_t>(0, m_N - 1)(rng);
+				continue;
+			}
+			double r = unif(rng) * total;
+			size_t ch = 0;
+			while (ch + 1 < m_nChunks && r >= m_chunkCost[ch])
+				r -= m_chunkCost[ch++];
+			const size_t i1 = std::min(m_N, (ch + 1) * KMEANS_CHUNK);
+			next = i1 - 1;
+			for (size_t i = ch * KMEANS_CHUNK; i < i1; i++)
+			{
+				if (r < m_minDist2[i] && m_minDist2[i] > 0)
+				{
+					next = i;
+					break;
+				}
+				r -= m_minDist2[i];
+			}
+		}
+	}
+
+	// Assignment step over all points. If accumulate=true, also computes the
+	// per-chunk sums of points and counts per cluster for updateCenters().
+	double assign(int* assignments, const bool accumulate)
+	{
+		forEachChunk([&](size_t ch) {
+			double* sums = &m_chunkSums[ch * m_k * m_dims];
+			size_t* counts = &m_chunkCounts[ch * m_k];
+			if (accumulate)
+			{
+				std::fill(sums, sums + m_k * m_dims, 0.0);
+				std::fill(counts, counts + m_k, 0);
+			}
+			const size_t i1 = std::min(m_N, (ch + 1) * KMEANS_CHUNK);
+			double cost = 0;
+			bool changed = false;
+			for (size_t i = ch * KMEANS_CHUNK; i < i1; i++)
+			{
+				const T* p = point(i);
+				double d2;
+				const int c = static_cast<int>(closest(p, d2));
+				cost += d2;
+				if (assignments[i] != c)
+				{
+					assignments[i] = c;
+					changed = true;
+				}
+				if (!accumulate) continue;
+				counts[c]++;
+				double* s = &sums[c * m_dims];
+				for (size_t j = 0; j < m_dims; j++)
+					s[j] += p[j];
+			}
+			m_chunkCost[ch] = cost;
+			m_chunkChanged[ch] = changed;
+		});
+		double cost = 0;
+		for (size_t ch = 0; ch < m_nChunks; ch++)
+			cost += m_chunkCost[ch];
+		return cost;
+	}
+
+	// Update step: reduce per-chunk sums. Empty clusters keep their center.
+	void updateCenters()
+	{
+		for (size_t c = 0; c < m_k; c++)
+		{
+			size_t n = 0;
+			for (size_t ch = 0; ch < m_nChunks; ch++)
+				n += m_chunkCounts[ch * m_k + c];
+			if (!n) continue;
+			double* ctr = &m_centers[c * m_dims];
+			std::fill(ctr, ctr + m_dims, 0.0);
+			for (size_t ch = 0; ch < m_nChunks; ch++)
+			{
+				const double* s = &m_chunkSums[(ch * m_k + c) * m_dims];
+				for (size_t j = 0; j < m_dims; j++)
+					ctr[j] += s[j];
+			}
+			for (size_t j = 0; j < m_dims; j++)
+				ctr[j] /= n;
+		}
+	}
+
+	// Mini-batch k-means (D. Sculley, "Web-scale k-means clustering", 2010):
+	// batch points are assigned in parallel, then each center moves towards
+	// its points with a per-center learning rate 1/count.
+	void miniBatch(mrpt::random::Generator_Xoshiro256pp& rng)
+	{
+		const size_t b = std::min(m_opts.miniBatchSize, m_N);
+		std::vector<size_t> batch(b), batchCluster(b);
+		std::vector<size_t> counts(m_k, 0);
+		std::uniform_int_distribution<size_t> unifIdx(0, m_N - 1);
+		for (size_t iter = 0; iter < m_opts.maxIterations; iter++)
+		{
+			for (auto& i : batch)
+				i = unifIdx(rng);
+			forEachIndex(b, [&](size_t i) {
+				double d2;
+				batchCluster[i] = closest(point(batch[i]), d2);
+			});
+			for (size_t i = 0; i < b; i++)
+			{
+				const size_t c = batchCluster[i];
+				const double eta = 1.0 / ++counts[c];
+				double* ctr = &m_centers[c * m_dims];
+				const T* p = point(batch[i]);
+				for (size_t j = 0; j < m_dims; j++)
+					ctr[j] += eta * (p[j] - ctr[j]);
+			}
+		}
+	}
+};
+}  // namespace
+
+template <typename SCALAR>
+double internal_kmeans_parallel(
+	const size_t k, const SCALAR* points, const size_t nPoints,
+	const size_t dims, const size_t stride, int* out_assignments,
+	SCALAR* out_centers, const TKMeansParallelOptions& opts)
+{
+	MRPT_START
+	ASSERT_(k >= 1);
+	if (!nPoints) return 0;
+	ASSERT_(points != nullptr);
+	ASSERTMSG_(dims > 0, "Dimensionality of points can't be zero.");
+	ASSERT_GE_(stride, dims);
+	ASSERTMSG_(k <= nPoints, "There must be at least k points.");
+
+	const uint64_t seed = opts.seed ? opts.seed : std::random_device()();
+
+	KMeansParallelImpl<SCALAR> impl(k, points, nPoints, dims, stride, opts);
+	std::vector<int> assig(nPoints);
+	double bestCost = std::numeric_limits<double>::max();
+	const size_t nAttempts = std::max<size_t>(1, opts.attempts);
+	for (size_t attempt = 0; attempt < nAttempts; attempt++)
+	{
+		mrpt::random::Generator_Xoshiro256pp rng(seed, attempt);
+		const double cost = impl.run(rng, assig.data());
+		if (cost >= bestCost) continue;
+		bestCost = cost;
+		std::copy(assig.begin(), assig.end(), out_assignments);
+		if (out_centers)
+			for (size_t i = 0; i < k * dims; i++)
+				out_centers[i] = static_cast<SCALAR>(impl.centers()[i]);
+	}
+	return bestCost;
+	MRPT_END
+}
+
+template double internal_kmeans_parallel<float>(
+	const size_t, const float*, const size_t, const size_t, const size_t,
+	int*, float*, const TKMeansParallelOptions&);
+template double internal_kmeans_parallel<double>(
+	const size_t, const double*, const size_t, const size_t, const size_t,
+	int*, double*, const TKMeansParallelOptions&);
+
 }  // namespace mrpt::math::detail
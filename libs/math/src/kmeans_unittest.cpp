@@ -0,0 +1,135 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/math/CVectorFixed.h>
+#include <mrpt/math/TPoint3D.h>
+#include <mrpt/math/kmeans.h>
+
+#include <random>
+
+using namespace mrpt::math;
+
+namespace
+{
+const TPoint3D clusterCenters[3] = {{0, 0, 0}, {5, 0, 0}, {0, 5, 5}};
+
+std::vector<TPoint3D> clusteredPoints(size_t n)
+{
+	std::mt19937 rng(1);
+	std::normal_distribution<double> noise(0, 0.1);
+	std::vector<TPoint3D> pts(n);
+	for (size_t i = 0; i < n; i++)
+	{
+		const auto& c = clusterCenters[i % 3];
+		pts[i] = {c.x + noise(rng), c.y + noise(rng), c.z + noise(rng)};
+	}
+	return pts;
+}
+
+void checkClusters(
+	const std::vector<TPoint3D>& pts, const std::vector<int>& assignments,
+	const std::vector<TPoint3D>& centers)
+{
+	ASSERT_EQ(assignments.size(), pts.size());
+	ASSERT_EQ(centers.size(), 3U);
+	// Each true cluster maps to exactly one center, near its true position:
+	for (size_t i = 0; i < pts.size(); i++)
+	{
+		EXPECT_EQ(assignments[i], assignments[i % 3]);
+		EXPECT_NEAR(
+			(centers[assignments[i]] - clusterCenters[i % 3]).norm(), 0, 0.05);
+	}
+	EXPECT_NE(assignments[0], assignments[1]);
+	EXPECT_NE(assignments[0], assignments[2]);
+	EXPECT_NE(assignments[1], assignments[2]);
+}
+}  // namespace
+
+TEST(KMeans, kmeansParallel)
+{
+	const auto pts = clusteredPoints(10000);
+	for (bool plusplus : {true, false})
+	{
+		TKMeansParallelOptions opts;
+		opts.kmeansplusplus = plusplus;
+		opts.seed = 1;
+		std::vector<int> assignments;
+		std::vector<TPoint3D> centers;
+		kmeans_parallel(3, pts, assignments, &centers, opts);
+		checkClusters(pts, assignments, centers);
+	}
+}
+
+TEST(KMeans, kmeansParallelMiniBatch)
+{
+	const auto pts = clusteredPoints(20000);
+	TKMeansParallelOptions opts;
+	opts.miniBatchSize = 300;
+	opts.seed = 1;
+	std::vector<int> assignments;
+	std::vector<TPoint3D> centers;
+	kmeans_parallel(3, pts, assignments, &centers, opts);
+	checkClusters(pts, assignments, centers);
+}
+
+TEST(KMeans, kmeansParallelSameResultAnyThreads)
+{
+	const auto pts = clusteredPoints(10000);
+	std::vector<int> assig1, assig4;
+	std::vector<TPoint3D> c1, c4;
+	TKMeansParallelOptions opts;
+	opts.seed = 123;
+	opts.numThreads = 1;
+	const double cost1 = kmeans_parallel(3, pts, assig1, &c1, opts);
+	opts.numThreads = 4;
+	const double cost4 = kmeans_parallel(3, pts, assig4, &c4, opts);
+	EXPECT_EQ(cost1, cost4);
+	EXPECT_EQ(assig1, assig4);
+}
+
+TEST(KMeans, kmeansParallelStridedFloats)
+{
+	// 2D points, each followed by an unused value:
+	const auto pts = clusteredPoints(3000);
+	std::vector<float> buf;
+	for (const auto& p : pts)
+		buf.insert(buf.end(), {float(p.x), float(p.y), -1.0f});
+
+	std::vector<int> assignments;
+	std::vector<float> centers;
+	TKMeansParallelOptions opts;
+	opts.seed = 1;
+	const double cost = kmeans_parallel<float>(
+		3, buf.data(), pts.size(), 2, assignments, &centers, opts, 3);
+	ASSERT_EQ(centers.size(), 6U);
+	EXPECT_LT(cost, pts.size() * 2 * 0.1 * 0.1 * 1.5);
+	for (size_t i = 0; i < pts.size(); i++)
+	{
+		const float* c = &centers[2 * assignments[i]];
+		EXPECT_NEAR(c[0], clusterCenters[i % 3].x, 0.05);
+		EXPECT_NEAR(c[1], clusterCenters[i % 3].y, 0.05);
+	}
+}
+
+TEST(KMeans, kmeanspp)
+{
+	const auto pts = clusteredPoints(3000);
+	std::vector<CVectorFixedDouble<3>> v(pts.size());
+	for (size_t i = 0; i < pts.size(); i++)
+		for (int j = 0; j < 3; j++)
+			v[i][j] = pts[i][j];
+	std::vector<int> assignments;
+	std::vector<CVectorFixedDouble<3>> centers;
+	kmeanspp(3, v, assignments, &centers);
+	ASSERT_EQ(centers.size(), 3U);
+	EXPECT_NE(assignments[0], assignments[1]);
+	EXPECT_NE(assignments[0], assignments[2]);
+	EXPECT_NE(assignments[1], assignments[2]);
+}
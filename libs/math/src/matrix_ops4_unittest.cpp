@@ -283,3 +283,16 @@ TEST(Matrices, loadFromTextFile)
 		EXPECT_FALSE(retval) << "string:\n" << s1 << endl;
 	}
 }
+
+TEST(Matrices, loadFromTextFileSeparators)
+{
+	// Comments, commas, explicit signs and DOS line ends:
+	std::stringstream s("% comment\r\n1,2e1 +3\r\n4 5 -6\r\n");
+	CMatrixFloat M;
+	M.loadFromTextFile(s);
+	ASSERT_EQ(M.rows(), 2);
+	ASSERT_EQ(M.cols(), 3);
+	EXPECT_EQ(M(0, 1), 20.0f);
+	EXPECT_EQ(M(0, 2), 3.0f);
+	EXPECT_EQ(M(1, 2), -6.0f);
+}
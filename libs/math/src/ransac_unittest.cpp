@@ -0,0 +1,120 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/math/ransac.h>
+#include <mrpt/math/ransac_applications.h>
+
+#include <cmath>
+#include <random>
+
+using namespace mrpt::math;
+
+namespace
+{
+// Points on the line y=0.5*x+1, plus uniform outliers:
+CMatrixDouble linePoints(size_t nIn, size_t nOut, unsigned int seed)
+{
+	std::mt19937 rng(seed);
+	std::uniform_real_distribution<double> u(-10, 10), noise(-0.01, 0.01);
+	CMatrixDouble d(2, nIn + nOut);
+	for (size_t i = 0; i < nIn + nOut; i++)
+	{
+		const double x = u(rng);
+		d(0, i) = x;
+		d(1, i) = i < nIn ? 0.5 * x + 1 + noise(rng) : u(rng);
+	}
+	return d;
+}
+
+const auto lineFit = [](const CMatrixDouble& d, const std::vector<size_t>& idx,
+						std::vector<TLine2D>& models) {
+	const TPoint2D p1(d(0, idx[0]), d(1, idx[0]));
+	const TPoint2D p2(d(0, idx[1]), d(1, idx[1]));
+	models.assign(1, TLine2D(p1, p2));
+	models[0].unitarize();
+};
+const auto lineDist = [](const CMatrixDouble& d, const TLine2D& l, size_t i) {
+	return l.distance(TPoint2D(d(0, i), d(1, i)));
+};
+const auto noDegen = [](const CMatrixDouble&, const std::vector<size_t>&) {
+	return false;
+};
+}  // namespace
+
+TEST(RANSAC, executeParallelFindsLine)
+{
+	const auto data = linePoints(300, 700, 1);
+
+	RANSAC_Template<double, CMatrixDouble, TLine2D> ransac;
+	ransac.setMinLoggingLevel(mrpt::system::LVL_ERROR);
+
+	std::vector<size_t> inliers1, inliers;
+	TLine2D line1, line;
+	TRansacParallelParams params;
+	params.numThreads = 1;
+	ASSERT_TRUE(ransac.executeParallel(
+		data, lineFit, lineDist, noDegen, 0.05, 2, inliers1, line1, params));
+	EXPECT_GE(inliers1.size(), 300U);
+	EXPECT_LT(inliers1.size(), 320U);
+	EXPECT_NEAR(line1.distance(TPoint2D(4, 3)), 0, 0.01);
+
+	// Same result with any number of threads, and with the preemptive test:
+	for (unsigned int nThreads : {2, 4})
+	{
+		params.numThreads = nThreads;
+		params.preemptiveSubsetSize = 0;
+		ASSERT_TRUE(ransac.executeParallel(
+			data, lineFit, lineDist, noDegen, 0.05, 2, inliers, line, params));
+		EXPECT_EQ(inliers, inliers1);
+
+		params.preemptiveSubsetSize = 50;
+		ASSERT_TRUE(ransac.executeParallel(
+			data, lineFit, lineDist, noDegen, 0.05, 2, inliers, line, params));
+		EXPECT_GE(inliers.size(), 300U);
+		EXPECT_NEAR(line.distance(TPoint2D(4, 3)), 0, 0.01);
+	}
+}
+
+TEST(RANSAC, detect2DLines)
+{
+	const auto data = linePoints(200, 50, 2);
+	CVectorDouble xs(data.cols()), ys(data.cols());
+	for (int i = 0; i < data.cols(); i++)
+	{
+		xs[i] = data(0, i);
+		ys[i] = data(1, i);
+	}
+	std::vector<std::pair<size_t, TLine2D>> lines;
+	ransac_detect_2D_lines(xs, ys, lines, 0.05, 100);
+	ASSERT_EQ(lines.size(), 1U);
+	EXPECT_GE(lines[0].first, 200U);
+	EXPECT_NEAR(lines[0].second.distance(TPoint2D(-2, 0)), 0, 0.01);
+}
+
+TEST(RANSAC, detect3DPlanes)
+{
+	// Two perpendicular planes, z=1 and x=-1:
+	std::mt19937 rng(3);
+	std::uniform_real_distribution<double> u(-5, 5);
+	CVectorDouble xs(400), ys(400), zs(400);
+	for (int i = 0; i < 400; i++)
+	{
+		xs[i] = i < 250 ? u(rng) : -1.0;
+		ys[i] = u(rng);
+		zs[i] = i < 250 ? 1.0 : u(rng);
+	}
+	std::vector<std::pair<size_t, TPlane>> planes;
+	ransac_detect_3D_planes(xs, ys, zs, planes, 0.01, 100);
+	ASSERT_EQ(planes.size(), 2U);
+	EXPECT_GE(planes[0].first, 250U);
+	EXPECT_NEAR(planes[0].second.distance(TPoint3D(2, 3, 1)), 0, 1e-6);
+	EXPECT_GE(planes[1].first, 140U);
+	EXPECT_NEAR(planes[1].second.distance(TPoint3D(-1, 3, 2)), 0, 1e-6);
+}
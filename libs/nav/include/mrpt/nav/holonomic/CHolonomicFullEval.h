@@ -153,6 +153,14 @@ class CHolonomicFullEval : public CAbstractHolonomicReactiveMethod
 	void evalSingleTarget(
 		unsigned int target_idx, const NavInput& ni, EvalOutput& eo);
 
+	/** Working buffers, kept between calls to navigate() to avoid
+	 * reallocations: TP-Obstacles as separate x,y arrays (structure of
+	 * arrays, for vectorized evaluation of clearances), evaluations for each
+	 * target, and overall scores. */
+	std::vector<double> m_obs_x, m_obs_y;
+	std::vector<EvalOutput> m_evals;
+	std::vector<double> m_overall_scores;
+
 	mrpt::obs::CSinCosLookUpTableFor2DScans m_sincos_lut;
 };	// end of CHolonomicFullEval
 
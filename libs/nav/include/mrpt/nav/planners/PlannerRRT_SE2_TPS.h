@@ -13,7 +13,15 @@
 #include <mrpt/nav/planners/PlannerRRT_common.h>
 #include <mrpt/nav/planners/TMoveTree.h>
 
+#include <atomic>
+#include <memory>
 #include <numeric>
+#include <vector>
+
+namespace mrpt::random
+{
+class CRandomGenerator;
+}
 
 namespace mrpt::nav
 {
@@ -57,6 +65,21 @@ namespace mrpt::nav
  * // Analyze contents of planner_result...
  * \endcode
  *
+ *  Alternatively, solveAnytime() returns the best path found within a fixed
+ * time budget, while the planner keeps improving it (with RRT* rewiring) in
+ * a background thread. Improved paths can be then retrieved with
+ * getAnytimeSolution(), without restarting the search:
+ * \code
+ * PlannerRRT_SE2_TPS::TPlannerAnytimeSolution sol;
+ * planner.solveAnytime(planner_input, 0.5, sol);  // 0.5 s budget
+ * // ... use sol.path ...
+ * if (planner.getAnytimeSolution(sol))
+ * {
+ *   // A better path was found since then...
+ * }
+ * planner.stopAnytime();
+ * \endcode
+ *
  *  - Changes history:
  *    - 06/MAR/2014: Creation (MB)
  *    - 06/JAN/2015: Refactoring (JLBC)
@@ -85,8 +108,34 @@ class PlannerRRT_SE2_TPS : public PlannerTPS_VirtualBase
 	{
 	};
 
+	/** A self-contained copy of the best path found by the anytime planner.
+	 * \sa solveAnytime(), getAnytimeSolution()
+	 * \note (New in MRPT 2.4.9) */
+	struct TPlannerAnytimeSolution
+	{
+		/** Whether a path to the target was found */
+		bool success{false};
+		/** Distance from the end of the path to the goal */
+		double goal_distance{std::numeric_limits<double>::max()};
+		/** Total cost of the path */
+		double path_cost{std::numeric_limits<double>::max()};
+		/** The sequence of motions from the start pose to the goal. Each one
+		 * holds its PTG index and TP-space coordinates (ptg_K, ptg_dist). */
+		std::vector<TMoveEdgeSE2_TP> path;
+		/** Number of nodes in the tree when this path was found */
+		size_t tree_size{0};
+		/** Time (in secs) since solveAnytime() was called, when this path was
+		 * found */
+		double computation_time{0};
+		/** Incremented each time a better path is found. It keeps growing
+		 * across solveAnytime() calls. */
+		size_t version{0};
+	};
+
 	/** Constructor */
 	PlannerRRT_SE2_TPS();
+	/** Destructor: stops the anytime planner, if running */
+	~PlannerRRT_SE2_TPS();
 
 	/** Load all params from a config file source */
 	void loadConfig(
@@ -101,9 +150,72 @@ class PlannerRRT_SE2_TPS : public PlannerTPS_VirtualBase
 	 * 'target' */
 	void solve(const TPlannerInput& pi, TPlannerResult& result);
 
+	/** @name Anytime planning
+	 * @{ */
+
+	/** Starts planning from scratch in a background thread, then blocks for
+	 * `timeBudget` seconds and returns the best path found so far in `out`
+	 * (`out.success` is false if none was found yet).
+	 *
+	 * The background thread keeps growing and rewiring (RRT*-style, see
+	 * RRTAlgorithmParams::rewireRadius) the tree after returning, until
+	 * stopAnytime() is called, solve() or solveAnytime() are called again,
+	 * or RRTEndCriteria::maxComputationTime (if >0) is exceeded.
+	 * It uses its own random number generator, seeded from
+	 * mrpt::random::getRandomGenerator().
+	 *
+	 * \exception std::exception Any error in the planner thread so far.
+	 * \note (New in MRPT 2.4.9)
+	 */
+	void solveAnytime(
+		const TPlannerInput& pi, const double timeBudget,
+		TPlannerAnytimeSolution& out);
+
+	/** Retrieves the best path found by the anytime planner, if it's better
+	 * than `out` (as told by TPlannerAnytimeSolution::version).
+	 * \return true if `out` has been updated.
+	 * \exception std::exception Any error in the planner thread.
+	 * \note (New in MRPT 2.4.9)
+	 */
+	bool getAnytimeSolution(TPlannerAnytimeSolution& out) const;
+
+	/** Stops the anytime planner thread and waits for it to finish. The last
+	 * solution remains available via getAnytimeSolution().
+	 * \note (New in MRPT 2.4.9) */
+	void stopAnytime();
+
+	/** Whether the anytime planner thread is running.
+	 * \note (New in MRPT 2.4.9) */
+	bool isAnytimeRunning() const;
+
+	/** @} */
+
    protected:
 	bool m_initialized{false};
 
+	/** State of the anytime planner thread */
+	struct TAnytimeState;
+	std::unique_ptr<TAnytimeState> m_anytime;
+
+	/** The planning loop. If `anytime_stop` is not null, it runs until that
+	 * flag is set, with rewiring, instead of until the end criteria. */
+	void internal_solve(
+		const TPlannerInput& pi, TPlannerResult& result,
+		mrpt::random::CRandomGenerator& rng,
+		const std::atomic_bool* anytime_stop);
+
+	/** Looks for the lowest-cost obstacle-free PTG motion from `from` that
+	 * ends within RRTAlgorithmParams::rewireMaxDistError and
+	 * rewireMaxAngError of `to`.
+	 * \return false if there is none. */
+	bool connectPoses(
+		const TPlannerInput& pi, const mrpt::graphs::TNodeID from_id,
+		const mrpt::math::TPose2D& from, const mrpt::math::TPose2D& to,
+		TMoveEdgeSE2_TP& out_edge);
+
+	/** Called by the planner thread each time a better path is found */
+	void publishAnytimeSolution(const TPlannerResult& result, double elapsed);
+
 };	// end class PlannerRRT_SE2_TPS
 
 /** @} */
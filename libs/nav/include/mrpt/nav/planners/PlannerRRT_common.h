@@ -118,6 +118,19 @@ struct RRTAlgorithmParams
 	 * (default=15 deg) (Any of minDistanceBetweenNewNodes and
 	 * minAngBetweenNewNodes must be satisfied) */
 	double minAngBetweenNewNodes;
+	/** RRT* rewiring: radius [meters] around each new node in which to look
+	 * for a lower-cost parent, and for existing nodes that can be reached at
+	 * a lower cost through the new one. 0 (default) disables rewiring, except
+	 * in PlannerRRT_SE2_TPS::solveAnytime(), which then uses `maxLength`.
+	 * \note (New in MRPT 2.4.9) */
+	double rewireRadius{0};
+	/** Maximum position [meters] and orientation [rad] errors between the end
+	 * of a PTG path and an existing node, to accept the path as a connection
+	 * to that node while rewiring (default=0.05 m, 5 deg).
+	 * \note (New in MRPT 2.4.9) */
+	double rewireMaxDistError{0.05};
+	/** \sa rewireMaxDistError */
+	double rewireMaxAngError{mrpt::DEG2RAD(5.0)};
 	/** Display PTG construction info (default=true) */
 	bool ptg_verbose{true};
 
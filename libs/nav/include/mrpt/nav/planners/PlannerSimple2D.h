@@ -12,6 +12,11 @@
 #include <mrpt/math/TPoint2D.h>
 #include <mrpt/poses/CPose2D.h>
 
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+
 namespace mrpt::nav
 {
 /** \addtogroup nav_planners Path planning
@@ -27,12 +32,31 @@ namespace mrpt::nav
  *
  * Notice that this simple planner does not take into account robot kinematic
  * constraints.
+ *
+ * Other algorithms can be selected with `method`:
+ *  - PlannerMethod::DStarLite: An incremental D* Lite search, from the target
+ *    towards the robot, in the 8-connected grid of free cells. Its state is
+ *    kept between calls to computePath() for the same target: when the robot
+ *    moves, or when some cells of the gridmap change (detected with
+ *    mrpt::maps::COccupancyGridMap2D::getMapVersion(), see
+ *    mrpt::maps::COccupancyGridMap2D::markLikelihoodCacheDirty() for cells
+ *    edited manually), only the affected part of the search is repaired.
+ *  - PlannerMethod::Hierarchical: For long-distance queries. An A* search in
+ *    a coarse grid of blocks of `hierarchicalBlockSize` cells finds a
+ *    corridor, then a regular A* finds the path within it (or in the whole
+ *    grid, if the corridor has no path).
+ *
+ * Both methods keep the inflated obstacle grid between calls, so they only
+ * recompute the cells that changed in the gridmap. Unlike the wavefront, they
+ * are not thread-safe: use one planner object per thread.
  */
 class PlannerSimple2D
 {
    public:
-	PlannerSimple2D() = default;
-	virtual ~PlannerSimple2D() = default;
+	PlannerSimple2D();
+	PlannerSimple2D(const PlannerSimple2D& o);
+	PlannerSimple2D& operator=(const PlannerSimple2D& o);
+	virtual ~PlannerSimple2D();
 
 	/** The maximum occupancy probability to consider a cell as an obstacle,
 	 * default=0.5  */
@@ -50,6 +74,31 @@ class PlannerSimple2D
 	 */
 	float robotRadius{0.35f};
 
+	/** Path search algorithms. \sa method */
+	enum class PlannerMethod : uint8_t
+	{
+		/** Bidirectional wavefront, computed from scratch in each call */
+		Wavefront = 0,
+		/** Incremental D* Lite, repaired between calls */
+		DStarLite,
+		/** A* in a coarse grid, then in the corridor it defines */
+		Hierarchical
+	};
+
+	/** The path search algorithm (default=Wavefront)
+	 * \note (New in MRPT 2.4.9) */
+	PlannerMethod method{PlannerMethod::Wavefront};
+
+	/** For PlannerMethod::Hierarchical: side length, in cells, of the blocks
+	 * of the coarse grid (default=8). A block is free if any of its cells is
+	 * free. */
+	unsigned int hierarchicalBlockSize{8};
+
+	/** For PlannerMethod::Hierarchical: width, in blocks, added at each side
+	 * of the coarse path to build the corridor for the fine search
+	 * (default=1). */
+	unsigned int hierarchicalCorridorWidth{1};
+
 	/** This method compute the optimal path for a circular robot, in the given
 	 *   occupancy grid map, from the origin location to a target point.
 	 * The options and additional parameters to this method can be set with
@@ -78,6 +127,37 @@ class PlannerSimple2D
 		const mrpt::poses::CPose2D& origin, const mrpt::poses::CPose2D& target,
 		std::deque<mrpt::math::TPoint2D>& path, bool& notFound,
 		float maxSearchPathLength = -1) const;
+
+	/** Discards the state kept between calls by the DStarLite and
+	 * Hierarchical methods, so the next query starts from scratch.
+	 * \note (New in MRPT 2.4.9) */
+	void resetSearchState();
+
+   private:
+	void computePathWavefront(
+		const mrpt::maps::COccupancyGridMap2D& theMap,
+		const mrpt::math::TPoint2D& origin, const mrpt::math::TPoint2D& target,
+		std::deque<mrpt::math::TPoint2D>& path, bool& notFound,
+		float maxSearchPathLength) const;
+	void computePathIncremental(
+		const mrpt::maps::COccupancyGridMap2D& theMap,
+		const mrpt::math::TPoint2D& origin, const mrpt::math::TPoint2D& target,
+		std::deque<mrpt::math::TPoint2D>& path, bool& notFound,
+		float maxSearchPathLength) const;
+	/** Converts a path of cells (excluding those of the origin and target)
+	 * into points, subsampled with minStepInReturnedPath */
+	void cellsToPath(
+		const mrpt::maps::COccupancyGridMap2D& theMap,
+		const mrpt::math::TPoint2D& origin, const mrpt::math::TPoint2D& target,
+		const std::vector<int32_t>& cells_x,
+		const std::vector<int32_t>& cells_y,
+		std::deque<mrpt::math::TPoint2D>& path, bool& notFound,
+		float maxSearchPathLength) const;
+
+	/** Obstacle grid and search state of the DStarLite and Hierarchical
+	 * methods (defined in PlannerSimple2D_incremental.cpp) */
+	struct TSearchState;
+	mutable std::unique_ptr<TSearchState> m_state;
 };
 
 /** @} */
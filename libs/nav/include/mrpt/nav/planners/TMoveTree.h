@@ -11,10 +11,18 @@
 
 #include <mrpt/containers/traits_map.h>
 #include <mrpt/graphs/CDirectedTree.h>
+#include <mrpt/math/TPoint2D.h>
 #include <mrpt/math/wrap2pi.h>
 #include <mrpt/nav/tpspace/CParameterizedTrajectoryGenerator.h>
 #include <mrpt/poses/CPose2D.h>
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <set>
+#include <vector>
+
 namespace mrpt::nav
 {
 /** \addtogroup nav_planners Path planning
@@ -78,7 +86,19 @@ class TMoveTree : public mrpt::graphs::CDirectedTree<EDGE_TYPE>
 	/** A topological path up-tree */
 	using path_t = std::list<node_t>;
 
-	/** Finds the nearest node to a given pose, using the given metric */
+	/** Finds the nearest node to a given pose, using the given metric.
+	 *
+	 * Candidates are retrieved from an incremental 2D KD-tree of the node
+	 * (x,y) coordinates, which is kept up to date by insertNode() and
+	 * insertNodeAndEdge(). Whole subtrees are discarded with the
+	 * PoseDistanceMetric::cannotBeNearerThan() Euclidean lower bound, so the
+	 * (potentially expensive) exact distance is only evaluated for a few
+	 * nodes. The result is the same than getNearestNodeBruteForce(): in case
+	 * of ties, the node with the lowest ID is returned.
+	 *
+	 * \note (New in MRPT 2.4.9) Nodes are searched with a KD-tree instead of
+	 * a linear scan.
+	 */
 	template <class NODE_TYPE_FOR_METRIC>
 	mrpt::graphs::TNodeID getNearestNode(
 		const NODE_TYPE_FOR_METRIC& query_pt,
@@ -89,6 +109,89 @@ class TMoveTree : public mrpt::graphs::CDirectedTree<EDGE_TYPE>
 		ASSERT_(!m_nodes.empty());
 		double min_d = std::numeric_limits<double>::max();
 		auto min_id = mrpt::graphs::INVALID_NODEID;
+
+		// Explicit stack, since the tree may become unbalanced between
+		// rebuilds:
+		struct TPending
+		{
+			uint32_t idx;
+			uint32_t depth;
+			/** Whether to check the splitting line of the parent first */
+			bool check_split;
+			bool split_x;
+			double split;
+		};
+		std::vector<TPending> pending;
+		pending.reserve(64);
+		if (!m_kdNodes.empty()) pending.push_back({0, 0, false, false, .0});
+
+		const NODE_TYPE_FOR_METRIC ptTo(query_pt.state);
+		while (!pending.empty())
+		{
+			const TPending p = pending.back();
+			pending.pop_back();
+			if (p.check_split)
+			{
+				// Lower bound for all nodes beyond the parent splitting line:
+				NODE_TYPE_FOR_METRIC ptSplit(query_pt.state);
+				if (p.split_x) ptSplit.state.x = p.split;
+				else
+					ptSplit.state.y = p.split;
+				if (distanceMetricEvaluator.cannotBeNearerThan(
+						ptSplit, ptTo, min_d))
+					continue;
+			}
+
+			const TKdNode& n = m_kdNodes[p.idx];
+			if (!ignored_nodes ||
+				ignored_nodes->find(n.node_id) == ignored_nodes->end())
+			{
+				const NODE_TYPE_FOR_METRIC ptFrom(n.state);
+				if (!distanceMetricEvaluator.cannotBeNearerThan(
+						ptFrom, ptTo, min_d))
+				{
+					const double d =
+						distanceMetricEvaluator.distance(ptFrom, ptTo);
+					if (d < min_d ||
+						(d == min_d && min_id != mrpt::graphs::INVALID_NODEID &&
+						 n.node_id < min_id))
+					{
+						min_d = d;
+						min_id = n.node_id;
+					}
+				}
+			}
+
+			const bool axisX = (p.depth % 2) == 0;
+			const double split = axisX ? n.state.x : n.state.y;
+			const double q = axisX ? query_pt.state.x : query_pt.state.y;
+			const uint32_t nearChild = q < split ? n.left : n.right;
+			const uint32_t farChild = q < split ? n.right : n.left;
+			// The far side is pushed first, so it's visited later, once
+			// min_d has been (hopefully) reduced by the near side:
+			if (farChild != KD_NONE)
+				pending.push_back({farChild, p.depth + 1, true, axisX, split});
+			if (nearChild != KD_NONE)
+				pending.push_back({nearChild, p.depth + 1, false, false, .0});
+		}
+		if (out_distance) *out_distance = min_d;
+		return min_id;
+	}
+
+	/** Like getNearestNode(), but doing a linear search over all nodes.
+	 * Kept for reference and benchmarking.
+	 * \note (New in MRPT 2.4.9)
+	 */
+	template <class NODE_TYPE_FOR_METRIC>
+	mrpt::graphs::TNodeID getNearestNodeBruteForce(
+		const NODE_TYPE_FOR_METRIC& query_pt,
+		const PoseDistanceMetric<NODE_TYPE_FOR_METRIC>& distanceMetricEvaluator,
+		double* out_distance = nullptr,
+		const std::set<mrpt::graphs::TNodeID>* ignored_nodes = nullptr) const
+	{
+		ASSERT_(!m_nodes.empty());
+		double min_d = std::numeric_limits<double>::max();
+		auto min_id = mrpt::graphs::INVALID_NODEID;
 		for (auto it = m_nodes.begin(); it != m_nodes.end(); ++it)
 		{
 			if (ignored_nodes &&
@@ -110,6 +213,37 @@ class TMoveTree : public mrpt::graphs::CDirectedTree<EDGE_TYPE>
 		return min_id;
 	}
 
+	/** Returns the IDs of all the nodes whose (x,y) coordinates are within a
+	 * Euclidean distance `radius` of `pt`, in no particular order.
+	 * \note (New in MRPT 2.4.9)
+	 */
+	void getNodesWithinRadius(
+		const mrpt::math::TPoint2D& pt, const double radius,
+		std::vector<mrpt::graphs::TNodeID>& out_ids) const
+	{
+		out_ids.clear();
+		std::vector<std::pair<uint32_t, uint32_t>> pending;	 // (idx,depth)
+		if (!m_kdNodes.empty()) pending.emplace_back(0, 0);
+		const double r2 = mrpt::square(radius);
+		while (!pending.empty())
+		{
+			const auto [idx, depth] = pending.back();
+			pending.pop_back();
+			const TKdNode& n = m_kdNodes[idx];
+			if (mrpt::square(n.state.x - pt.x) +
+					mrpt::square(n.state.y - pt.y) <=
+				r2)
+				out_ids.push_back(n.node_id);
+
+			const bool axisX = (depth % 2) == 0;
+			const double diff = axisX ? pt.x - n.state.x : pt.y - n.state.y;
+			if (n.left != KD_NONE && diff <= radius)
+				pending.emplace_back(n.left, depth + 1);
+			if (n.right != KD_NONE && diff >= -radius)
+				pending.emplace_back(n.right, depth + 1);
+		}
+	}
+
 	void insertNodeAndEdge(
 		const mrpt::graphs::TNodeID parent_id,
 		const mrpt::graphs::TNodeID new_child_id,
@@ -122,9 +256,11 @@ class TMoveTree : public mrpt::graphs::CDirectedTree<EDGE_TYPE>
 		edges_of_parent.push_back(typename base_t::TEdgeInfo(
 			new_child_id, false /*direction_child_to_parent*/, new_edge_data));
 		// node:
+		const size_t nPrev = m_nodes.size();
 		m_nodes[new_child_id] = node_t(
 			new_child_id, parent_id, &edges_of_parent.back().data,
 			new_child_node_data);
+		updateSpatialIndex(nPrev, new_child_id);
 	}
 
 	/** Insert a node without edges (should be used only for a tree root node)
@@ -132,8 +268,40 @@ class TMoveTree : public mrpt::graphs::CDirectedTree<EDGE_TYPE>
 	void insertNode(
 		const mrpt::graphs::TNodeID node_id, const NODE_TYPE_DATA& node_data)
 	{
+		const size_t nPrev = m_nodes.size();
 		m_nodes[node_id] =
 			node_t(node_id, mrpt::graphs::INVALID_NODEID, nullptr, node_data);
+		updateSpatialIndex(nPrev, node_id);
+	}
+
+	/** Makes `new_parent_id` the parent of the existing node `node_id`,
+	 * replacing the edge from its former parent with `new_edge_data` (e.g.
+	 * for RRT* rewiring). The data of the node itself is not modified.
+	 * The caller is responsible of not creating cycles.
+	 * \note (New in MRPT 2.4.9)
+	 */
+	void changeParent(
+		const mrpt::graphs::TNodeID node_id,
+		const mrpt::graphs::TNodeID new_parent_id,
+		const EDGE_TYPE& new_edge_data)
+	{
+		auto it = m_nodes.find(node_id);
+		ASSERT_(it != m_nodes.end());
+		node_t& node = it->second;
+		ASSERTMSG_(
+			node.parent_id != mrpt::graphs::INVALID_NODEID,
+			"Cannot change the parent of the root node");
+
+		base_t::edges_to_children[node.parent_id].remove_if(
+			[node_id](const typename base_t::TEdgeInfo& e) {
+				return e.id == node_id;
+			});
+		typename base_t::TListEdges& edges_of_parent =
+			base_t::edges_to_children[new_parent_id];
+		edges_of_parent.push_back(typename base_t::TEdgeInfo(
+			node_id, false /*direction_child_to_parent*/, new_edge_data));
+		node.parent_id = new_parent_id;
+		node.edge_to_parent = &edges_of_parent.back().data;
 	}
 
 	mrpt::graphs::TNodeID getNextFreeNodeID() const { return m_nodes.size(); }
@@ -176,6 +344,97 @@ class TMoveTree : public mrpt::graphs::CDirectedTree<EDGE_TYPE>
 	/** Info per node */
 	node_map_t m_nodes;
 
+	static constexpr uint32_t KD_NONE = std::numeric_limits<uint32_t>::max();
+
+	/** A node of the KD-tree. Even (odd) depths split along x (y) */
+	struct TKdNode
+	{
+		mrpt::math::TPose2D state;
+		mrpt::graphs::TNodeID node_id;
+		uint32_t left, right;
+	};
+	/** KD-tree with all the nodes in m_nodes. The root is at index 0 */
+	std::vector<TKdNode> m_kdNodes;
+	size_t m_kdInsertsSinceRebuild = 0;
+
+	/** Must be called after inserting or overwriting `node_id` in m_nodes,
+	 * which had `nPrev` entries before. */
+	void updateSpatialIndex(size_t nPrev, mrpt::graphs::TNodeID node_id)
+	{
+		// Overwritten node, or more than one new entry (map_as_vector gaps):
+		if (m_nodes.size() != nPrev + 1)
+		{
+			rebuildSpatialIndex();
+			return;
+		}
+
+		const auto it = m_nodes.find(node_id);
+		ASSERT_(it != m_nodes.end());
+		const TKdNode newNode{it->second.state, node_id, KD_NONE, KD_NONE};
+		const auto newIdx = static_cast<uint32_t>(m_kdNodes.size());
+		m_kdNodes.push_back(newNode);
+		if (newIdx == 0) return;
+
+		uint32_t idx = 0, depth = 0;
+		for (;;)
+		{
+			TKdNode& n = m_kdNodes[idx];
+			const bool goLeft = (depth % 2) == 0 ? newNode.state.x < n.state.x
+												 : newNode.state.y < n.state.y;
+			uint32_t& child = goLeft ? n.left : n.right;
+			depth++;
+			if (child == KD_NONE)
+			{
+				child = newIdx;
+				break;
+			}
+			idx = child;
+		}
+
+		// Rebalance from time to time, if the tree becomes too deep
+		// (typical of RRTs growing towards one direction):
+		m_kdInsertsSinceRebuild++;
+		const double nNodes = static_cast<double>(m_kdNodes.size());
+		if (depth > 2 * std::log2(nNodes) + 4 &&
+			m_kdInsertsSinceRebuild * 8 >= m_kdNodes.size())
+			rebuildSpatialIndex();
+	}
+
+	/** Rebuilds a balanced KD-tree from scratch */
+	void rebuildSpatialIndex()
+	{
+		std::vector<TKdNode> pts;
+		pts.reserve(m_nodes.size());
+		for (auto it = m_nodes.begin(); it != m_nodes.end(); ++it)
+			pts.push_back({it->second.state, it->first, KD_NONE, KD_NONE});
+
+		m_kdNodes.clear();
+		m_kdNodes.reserve(pts.size());
+		m_kdInsertsSinceRebuild = 0;
+		buildSpatialIndex(pts, 0, pts.size(), 0);
+	}
+
+	uint32_t buildSpatialIndex(
+		std::vector<TKdNode>& pts, size_t first, size_t last, uint32_t depth)
+	{
+		if (first >= last) return KD_NONE;
+		const size_t mid = (first + last) / 2;
+		const bool axisX = (depth % 2) == 0;
+		std::nth_element(
+			pts.begin() + first, pts.begin() + mid, pts.begin() + last,
+			[axisX](const TKdNode& a, const TKdNode& b) {
+				return axisX ? a.state.x < b.state.x : a.state.y < b.state.y;
+			});
+		const auto idx = static_cast<uint32_t>(m_kdNodes.size());
+		m_kdNodes.push_back(pts[mid]);
+		const uint32_t left = buildSpatialIndex(pts, first, mid, depth + 1);
+		const uint32_t right =
+			buildSpatialIndex(pts, mid + 1, last, depth + 1);
+		m_kdNodes[idx].left = left;
+		m_kdNodes[idx].right = right;
+		return idx;
+	}
+
 };	// end TMoveTree
 
 /** An edge for the move tree used for planning in SE2 and TP-space */
@@ -223,11 +482,12 @@ struct TNodeSE2
 template <>
 struct PoseDistanceMetric<TNodeSE2>
 {
+	/** Note that distance() is a squared distance */
 	bool cannotBeNearerThan(
 		const TNodeSE2& a, const TNodeSE2& b, const double d) const
 	{
-		if (std::abs(a.state.x - b.state.x) > d) return true;
-		if (std::abs(a.state.y - b.state.y) > d) return true;
+		if (mrpt::square(a.state.x - b.state.x) > d) return true;
+		if (mrpt::square(a.state.y - b.state.y) > d) return true;
 		return false;
 	}
 
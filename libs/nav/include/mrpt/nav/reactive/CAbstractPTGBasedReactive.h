@@ -22,6 +22,12 @@
 #include <mrpt/system/datetime.h>
 
 #include <memory>  // unique_ptr
+#include <mutex>
+
+namespace mrpt
+{
+class WorkerThreadsPool;
+}
 
 namespace mrpt::nav
 {
@@ -170,6 +176,32 @@ class CAbstractPTGBasedReactive : public CWaypointsNavigator
 		m_navlogfiles_dir = sDir;
 	}
 	std::string getLogFileDirectory() const { return m_navlogfiles_dir; }
+
+	/** Enables an in-memory ring buffer with the log records of the last
+	 * `maxRecords` navigation steps. Records are kept serialized in
+	 * preallocated memory blocks and only written to disk upon request
+	 * (dumpLogRingBuffer()) or, if `autoDumpOnError` is true, whenever the
+	 * navigator enters the NAV_ERROR state. The resulting file has the
+	 * regular `.reactivenavlog` format, readable by navlog-viewer.
+	 * Pass `maxRecords=0` to disable it and free its memory.
+	 * \note (New in MRPT 2.4.9)
+	 */
+	void enableLogRingBuffer(size_t maxRecords, bool autoDumpOnError = true);
+
+	/** Number of log records currently held in the ring buffer.
+	 * \sa enableLogRingBuffer()
+	 * \note (New in MRPT 2.4.9) */
+	size_t getLogRingBufferCount() const;
+
+	/** Writes the records in the log ring buffer, oldest first, to a
+	 * `.reactivenavlog` file. If `fileName` is empty, the first free name
+	 * `ring_%03u.reactivenavlog` in the log directory is used.
+	 * \return The name of the written file, or an empty string if the ring
+	 * buffer was empty or the file could not be written.
+	 * \sa enableLogRingBuffer(), setLogFileDirectory()
+	 * \note (New in MRPT 2.4.9)
+	 */
+	std::string dumpLogRingBuffer(const std::string& fileName = std::string());
 	struct TAbstractPTGNavigatorParams : public mrpt::config::CLoadableOptions
 	{
 		/** C++ class name of the holonomic navigation method to run in the
@@ -222,6 +254,14 @@ class CAbstractPTGBasedReactive : public CWaypointsNavigator
 		/** Max dist [meters] to use time-based path prediction for NOP
 		 * evaluation. */
 		double max_dist_for_timebased_path_prediction{2.0};
+		/** Number of threads used to evaluate the PTGs (TP-Obstacles,
+		 * holonomic method and candidate scores) concurrently. 1 means
+		 * sequential evaluation, 0 as many as hardware threads (default=1).
+		 * Values other than 1 require STEP3_WSpaceToTPSpace() and the
+		 * holonomic methods of derived classes to be safe to call for
+		 * different PTGs from different threads.
+		 * \note (New in MRPT 2.4.9) */
+		unsigned int ptg_eval_num_threads{1};
 
 		void loadFromConfigFile(
 			const mrpt::config::CConfigFileBase& c,
@@ -295,6 +335,21 @@ class CAbstractPTGBasedReactive : public CWaypointsNavigator
 	mrpt::io::CStream* m_prev_logfile{nullptr};
 	/** See enableKeepLogRecords */
 	bool m_enableKeepLogRecords{false};
+	/** See enableLogRingBuffer(). Each entry holds one serialized
+	 * CLogFileRecord; its memory is reused once the buffer wraps around. */
+	std::vector<std::vector<uint8_t>> m_logRing;
+	/** Index of the next slot to write in m_logRing, and number of used
+	 * slots */
+	size_t m_logRingNext = 0, m_logRingCount = 0;
+	bool m_logRingAutoDump = true;
+	/** Set by doEmergencyStop(), handled at the end of the navigation step */
+	bool m_logRingDumpPending = false;
+	mutable std::mutex m_logRingCS;
+
+	/** Appends a log record to the ring buffer, if enabled */
+	void pushLogRingBuffer(const CLogFileRecord& rec);
+
+	void doEmergencyStop(const std::string& msg) override;
 	/** The last log */
 	CLogFileRecord lastLogRecord;
 	/** Last velocity commands */
@@ -317,6 +372,8 @@ class CAbstractPTGBasedReactive : public CWaypointsNavigator
 	/** @name Variables for CReactiveNavigationSystem::performNavigationStep
 		@{ */
 	mrpt::system::CTicTac totalExecutionTime, executionTime, tictac;
+	/** Created on demand if ptg_eval_num_threads!=1 */
+	std::shared_ptr<mrpt::WorkerThreadsPool> m_ptgEvalThreadPool;
 	mrpt::math::LowPassFilter_IIR1 meanExecutionTime{0.7, 1};
 	mrpt::math::LowPassFilter_IIR1 meanTotalExecutionTime{0.7, 1};
 	/** Runtime estimation of execution period of the method. */
@@ -329,6 +386,10 @@ class CAbstractPTGBasedReactive : public CWaypointsNavigator
 	bool impl_waypoint_is_reachable(
 		const mrpt::math::TPoint2D& wp_local_wrt_robot)
 		const override;	 // See docs in base class
+	void impl_waypoints_are_reachable(
+		const std::vector<mrpt::math::TPoint2D>& wps_local_wrt_robot,
+		std::vector<bool>& is_reachable)
+		const override;	 // See docs in base class
 
 	// Steps for the reactive navigation sytem.
 	// ----------------------------------------------------------------------------
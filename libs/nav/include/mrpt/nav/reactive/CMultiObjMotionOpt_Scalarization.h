@@ -56,6 +56,10 @@ class CMultiObjMotionOpt_Scalarization
    protected:
 	mrpt::expr::CRuntimeCompiledExpression m_expr_scalar_formula;
 	std::map<std::string, double> m_expr_scalar_vars;
+	/** Score names the formula was compiled for, and their variables in
+	 * m_expr_scalar_vars, in the order of scoreTable() columns. */
+	std::vector<std::string> m_expr_scalar_names;
+	std::vector<double*> m_expr_scalar_ptrs;
 
 	// This virtual method is called by decide().
 	int impl_decide(
@@ -93,6 +93,20 @@ class CMultiObjectiveMotionOptimizerBase : public mrpt::rtti::CObject
    protected:
 	CMultiObjectiveMotionOptimizerBase(TParamsBase& params);
 
+	/** Names of all scores, sorted, as in TParamsBase::formula_score. They
+	 * give the order of the columns in scoreTable().
+	 * \note (New in MRPT 2.4.9) */
+	const std::vector<std::string>& scoreNames() const
+	{
+		return m_score_names;
+	}
+	/** The scores of all candidates in the ongoing decide() call, after
+	 * normalization and asserts: the j-th score of the i-th candidate is
+	 * entry `[i * N + j]`, with `N=scoreNames().size()`. It holds the same
+	 * values as TResultInfo::score_values, without name look-ups.
+	 * \note (New in MRPT 2.4.9) */
+	const std::vector<double>& scoreTable() const { return m_score_table; }
+
    private:
 	// This virtual method is called by decide().
 	virtual int impl_decide(
@@ -105,5 +119,15 @@ class CMultiObjectiveMotionOptimizerBase : public mrpt::rtti::CObject
 	std::map<std::string, mrpt::expr::CRuntimeCompiledExpression> m_score_exprs;
 	std::vector<mrpt::expr::CRuntimeCompiledExpression> m_movement_assert_exprs;
 	std::map<std::string, double> m_expr_vars;
+
+	/** Cached bindings of candidate properties and scores to their variables
+	 * in m_expr_vars (std::map never invalidates references) */
+	std::vector<std::pair<std::string, double*>> m_prop_vars;
+	std::vector<double*> m_all_vars, m_score_vars;
+	std::vector<std::string> m_score_names;
+	std::vector<double> m_score_table;
+
+	/** Resets all variables to NaN and loads the properties of `m` */
+	void bindCandidateVars(const mrpt::nav::TCandidateMovementPTG& m);
 };
 }  // namespace mrpt::nav
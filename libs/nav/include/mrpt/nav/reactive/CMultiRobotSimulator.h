@@ -0,0 +1,203 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/core/Clock.h>
+#include <mrpt/kinematics/CVehicleSimulBatch.h>
+#include <mrpt/maps/COccupancyGridMap2D.h>
+#include <mrpt/nav/reactive/CAbstractNavigator.h>
+#include <mrpt/obs/CObservation2DRangeScan.h>
+#include <mrpt/system/COutputLogger.h>
+#include <mrpt/system/CTimeLogger.h>
+
+#include <functional>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace mrpt
+{
+class WorkerThreadsPool;
+}
+
+namespace mrpt::nav
+{
+/** Simulator of a fleet of robots of the same kind, each one driven by its
+ * own navigator, sensing obstacles with a 2D laser scanner in a shared
+ * occupancy grid map. Meant for fleet-scale tests (e.g. hundreds of robots
+ * in a warehouse map) much faster than real time.
+ *
+ * Each call to step() advances the simulation by TOptions::time_step
+ * seconds, in three stages:
+ *  - The laser scans of all robots are simulated from their current poses,
+ *    in parallel with COccupancyGridMap2D::laserScanSimulator(), or all at
+ *    once with COccupancyGridMap2D::laserScanSimulatorBatch() if the OpenGL
+ *    backend is selected. Optionally, the other robots nearby are added as
+ *    obstacles (see TOptions::robot_radius).
+ *  - The navigationStep() of all navigators is run in parallel. Each one
+ *    reads its robot state and cached scan, and commands its own vehicle.
+ *  - The kinematics of all vehicles are integrated at once with
+ *    mrpt::kinematics::CVehicleSimulBatch.
+ *
+ * Navigators are created by a user-supplied factory when adding each
+ * robot, which receives the robot interface to be used by the navigator
+ * (a CRobot2NavInterfaceForSimulatorBatch) and must return it ready to use
+ * (options loaded and initialize() called). Navigators should not use their
+ * own threads (e.g. keep the default `ptg_eval_num_threads=1` of
+ * CAbstractPTGBasedReactive) since robots are already run in parallel.
+ *
+ * Navigators use mrpt::Clock timestamps, so by default
+ * (TOptions::use_simulated_clock) the global mrpt::Clock is switched to
+ * simulated time upon the first step(), advanced in each step, and restored
+ * to its former source in the destructor.
+ *
+ * \code
+ * CMultiRobotSimulator sim(gridmap);
+ * for (const auto& p : startPoses)
+ *   sim.addRobot(p, [&](CRobot2NavInterface& robot) {
+ *     auto nav = std::make_unique<CReactiveNavigationSystem>(robot, false);
+ *     nav->loadConfigFile(cfg);
+ *     nav->initialize();
+ *     return nav;
+ *   });
+ * // ... send navigation commands with sim.navigator(i).navigate()
+ * sim.runUntilIdle(60.0);
+ * \endcode
+ *
+ * \sa mrpt::kinematics::CVehicleSimulBatch,
+ * CRobot2NavInterfaceForSimulatorBatch
+ * \ingroup nav_reactive
+ * \note (New in MRPT 2.4.9)
+ */
+class CMultiRobotSimulator : public mrpt::system::COutputLogger
+{
+   public:
+	using navigator_factory_t =
+		std::function<std::unique_ptr<CAbstractNavigator>(
+			CRobot2NavInterface&)>;
+
+	/** Uses `map` (which must outlive this object) for all laser scans */
+	CMultiRobotSimulator(
+		const mrpt::maps::COccupancyGridMap2D& map,
+		mrpt::kinematics::CVehicleSimulBatch::Model model =
+			mrpt::kinematics::CVehicleSimulBatch::Model::DiffDriven);
+	~CMultiRobotSimulator() override;
+
+	struct TOptions
+	{
+		TOptions();
+
+		/** Simulated time advanced by each step() (Default: 0.1 s) */
+		double time_step = 0.1;
+		/** Number of threads to run robots in parallel (0: all cores).
+		 * Changes are effective in the next step(). */
+		size_t num_threads = 0;
+
+		/** Parameters of the simulated laser scans (aperture, maxRange,
+		 * sensorPose,...). Default: 270 deg, 20 m, 0.4 m above the ground. */
+		mrpt::obs::CObservation2DRangeScan scan_template;
+		/** Number of rays of each scan */
+		size_t scan_rays = 180;
+		/** See COccupancyGridMap2D::laserScanSimulator() */
+		float occupancy_threshold = 0.4f;
+		/** Std. deviation of the noise of the ranges (meters) */
+		float range_noise_std = .0f;
+		mrpt::maps::COccupancyGridMap2D::TLaserSimulBackend laser_backend =
+			mrpt::maps::COccupancyGridMap2D::TLaserSimulBackend::CPU;
+
+		/** If >0, other robots within the range of each laser are added
+		 * to its sensed obstacles, as circles of this radius (meters). */
+		double robot_radius = .0;
+
+		/** See the class description */
+		bool use_simulated_clock = true;
+	};
+
+	TOptions options;
+
+	/** Adds a new robot at the given pose, and creates its navigator with
+	 * `navFactory` (see the class description).
+	 * \return The index of the new robot. */
+	size_t addRobot(
+		const mrpt::math::TPose2D& initialPose,
+		const navigator_factory_t& navFactory);
+
+	/** Number of robots */
+	size_t size() const { return m_robots.size(); }
+
+	CAbstractNavigator& navigator(size_t i) { return *m_robots.at(i).nav; }
+	const CAbstractNavigator& navigator(size_t i) const
+	{
+		return *m_robots.at(i).nav;
+	}
+
+	/** The kinematic state of all vehicles */
+	const mrpt::kinematics::CVehicleSimulBatch& vehicles() const
+	{
+		return m_vehicles;
+	}
+	/** Read/write access to the vehicles, e.g. for their options. Do not
+	 * resize it. */
+	mrpt::kinematics::CVehicleSimulBatch& vehicles() { return m_vehicles; }
+
+	/** The latest laser scan of robot `i`, without other robots. */
+	const mrpt::obs::CObservation2DRangeScan& lastScan(size_t i) const
+	{
+		return m_scans.at(i);
+	}
+
+	/** Simulated time (seconds) since the first step */
+	double getTime() const { return m_vehicles.getTime(); }
+
+	/** Runs one simulation step, see the class description */
+	void step();
+
+	/** Runs step() until all navigators are IDLE or NAV_ERROR (or
+	 * SUSPENDED), or for `maxSimulTime` seconds.
+	 * \return true if all navigators stopped before the time limit. */
+	bool runUntilIdle(double maxSimulTime);
+
+	/** Enables/disables profiling of the wall-clock time of each stage of
+	 * step(): "step.sense", "step.navigate" and "step.kinematics" (Default:
+	 * disabled). When enabled, a report will be dumped upon destruction.
+	 * \sa getTimeLogger */
+	void enableTimeLog(bool enable = true) { m_timlog.enable(enable); }
+	/** \sa enableTimeLog */
+	const mrpt::system::CTimeLogger& getTimeLogger() const { return m_timlog; }
+
+   private:
+	class RobotInterface;
+
+	struct TRobot
+	{
+		std::unique_ptr<RobotInterface> robot_if;
+		std::unique_ptr<CAbstractNavigator> nav;
+	};
+
+	const mrpt::maps::COccupancyGridMap2D& m_map;
+	mrpt::kinematics::CVehicleSimulBatch m_vehicles;
+	std::vector<TRobot> m_robots;
+	/** Latest scan, and obstacles from other robots, per robot */
+	std::vector<mrpt::obs::CObservation2DRangeScan> m_scans;
+	std::vector<std::vector<mrpt::math::TPoint2Df>> m_robotObstacles;
+
+	std::unique_ptr<mrpt::WorkerThreadsPool> m_pool;
+	/** Clock source before the first step, to be restored */
+	std::optional<mrpt::Clock::Source> m_savedClock;
+
+	/** \sa enableTimeLog() */
+	mrpt::system::CTimeLogger m_timlog{false, "CMultiRobotSimulator"};
+
+	/** Runs fn(i) for all robots, in m_pool if there is one */
+	void forEachRobot(const std::function<void(size_t)>& fn);
+	void senseAll();
+	void updateRobotObstacles();
+};
+
+}  // namespace mrpt::nav
@@ -10,6 +10,10 @@
 
 #include "CAbstractPTGBasedReactive.h"
 
+#include <cstdint>
+#include <memory>
+#include <unordered_set>
+
 namespace mrpt::nav
 {
 /** A 3D robot shape stored as a "sliced" stack of 2D polygons, used for
@@ -128,6 +132,24 @@ class CReactiveNavigationSystem3D : public CAbstractPTGBasedReactive
 	void saveConfigFile(mrpt::config::CConfigFileBase& c)
 		const override;	 // See base class docs!
 
+	/** Parameters of this class, also read from the section
+	 * `[CReactiveNavigationSystem3D]` by loadConfigFile() */
+	struct TParams3D
+	{
+		/** Size [m] of the XY grid cells used to downsample the obstacles of
+		 * each height level, keeping one point per cell. Points within one
+		 * cell yield almost the same TP-Obstacles, so cells of a few cm
+		 * largely reduce the cost of dense clouds (0: disabled, default).
+		 * \note (New in MRPT 2.4.9) */
+		double obstacles_voxel_size{0};
+		/** Number of threads evaluating the height levels of each PTG
+		 * (0: as many as CPU cores; 1: sequentially, default). These
+		 * threads are independent of `ptg_eval_num_threads`.
+		 * \note (New in MRPT 2.4.9) */
+		unsigned int level_eval_num_threads{1};
+	};
+	TParams3D params_reactive_nav_3d;
+
    private:
 	// ------------------------------------------------------
 	//					PRIVATE DEFINITIONS
@@ -152,6 +174,34 @@ class CReactiveNavigationSystem3D : public CAbstractPTGBasedReactive
 	 * robot local frame */
 	std::vector<mrpt::maps::CSimplePointsMap> m_WS_Obstacles_inlevels;
 
+	/** Buffers reused between calls to implementSenseObstacles(): the
+	 * height level of each obstacle (nSlices: discarded), the top height of
+	 * each level, and the occupied cells of each level for downsampling. */
+	std::vector<uint8_t> m_obs_levels;
+	std::vector<float> m_levels_top_height;
+	std::vector<std::unordered_set<uint64_t>> m_obs_voxels;
+
+	/** The obstacles in levels are not sorted again if the robot interface
+	 * returns the same cloud (same timestamp and size) and settings. */
+	struct TSortedObstaclesKey
+	{
+		mrpt::system::TTimeStamp timestamp = INVALID_TIMESTAMP;
+		size_t nPoints = 0;
+		float maxXY = 0, voxelSize = 0;
+		std::vector<float> heights;
+
+		bool operator==(const TSortedObstaclesKey& o) const
+		{
+			return timestamp == o.timestamp && nPoints == o.nPoints &&
+				maxXY == o.maxXY && voxelSize == o.voxelSize &&
+				heights == o.heights;
+		}
+	};
+	TSortedObstaclesKey m_WS_Obstacles_inlevels_key;
+
+	/** Created on demand if level_eval_num_threads!=1 */
+	std::shared_ptr<mrpt::WorkerThreadsPool> m_levelEvalThreadPool;
+
 	/** The robot 3D shape model */
 	TRobotShape m_robotShape;
 
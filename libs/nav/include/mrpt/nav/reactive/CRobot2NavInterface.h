@@ -36,6 +36,7 @@ namespace mrpt::nav
  * classes, which already provide partial implementations:
  *  - mrpt::nav::CRobot2NavInterfaceForSimulator_DiffDriven
  *  - mrpt::nav::CRobot2NavInterfaceForSimulator_Holo
+ *  - mrpt::nav::CRobot2NavInterfaceForSimulatorBatch
  *
  * \sa CReactiveNavigationSystem, CAbstractNavigator
  *  \ingroup nav_reactive
@@ -8,6 +8,7 @@
    +------------------------------------------------------------------------+ */
 #pragma once
 
+#include <mrpt/kinematics/CVehicleSimulBatch.h>
 #include <mrpt/kinematics/CVehicleSimul_DiffDriven.h>
 #include <mrpt/kinematics/CVehicleSimul_Holo.h>
 #include <mrpt/nav/reactive/CRobot2NavInterface.h>
@@ -172,4 +173,111 @@ class CRobot2NavInterfaceForSimulator_DiffDriven : public CRobot2NavInterface
 		m_simul_time_start = m_simul.getTime();
 	}
 };
+
+/** CRobot2NavInterface implemented for one of the vehicles of a
+ * mrpt::kinematics::CVehicleSimulBatch, of any of its kinematic models.
+ * Only `senseObstacles()` remains virtual for the user to implement it.
+ *
+ * The methods of different objects (different vehicles) may be called in
+ * parallel from different threads, but not while the batch simulator is
+ * running.
+ *
+ * \sa CMultiRobotSimulator, mrpt::kinematics::CVehicleSimulBatch
+ *  \ingroup nav_reactive
+ * \note (New in MRPT 2.4.9)
+ */
+class CRobot2NavInterfaceForSimulatorBatch : public CRobot2NavInterface
+{
+   private:
+	mrpt::kinematics::CVehicleSimulBatch& m_simul;
+	/** Index of this vehicle in m_simul */
+	size_t m_index;
+	/** for getNavigationTime */
+	double m_simul_time_start = .0;
+
+	bool isHolo() const
+	{
+		return m_simul.model() ==
+			mrpt::kinematics::CVehicleSimulBatch::Model::Holo;
+	}
+
+   public:
+	CRobot2NavInterfaceForSimulatorBatch(
+		mrpt::kinematics::CVehicleSimulBatch& simul, size_t index)
+		: m_simul(simul), m_index(index)
+	{
+	}
+
+	size_t vehicleIndex() const { return m_index; }
+
+	bool getCurrentPoseAndSpeeds(
+		mrpt::math::TPose2D& curPose, mrpt::math::TTwist2D& curVel,
+		mrpt::system::TTimeStamp& timestamp, mrpt::math::TPose2D& curOdometry,
+		std::string& frame_id) override
+	{
+		curPose = m_simul.getCurrentGTPose(m_index);
+		curVel = m_simul.getCurrentGTVel(m_index);
+		timestamp = mrpt::system::now();
+		curOdometry = m_simul.getCurrentOdometricPose(m_index);
+		return true;  // ok
+	}
+
+	bool changeSpeeds(const mrpt::kinematics::CVehicleVelCmd& vel_cmd) override
+	{
+		m_simul.sendVelCmd(m_index, vel_cmd);
+		return true;  // ok
+	}
+
+	bool stop(bool isEmergencyStop) override
+	{
+		m_simul.sendVelCmd(
+			m_index, isEmergencyStop ? *getEmergencyStopCmd() : *getStopCmd());
+		return true;
+	}
+
+	mrpt::kinematics::CVehicleVelCmd::Ptr getEmergencyStopCmd() override
+	{
+		if (isHolo())
+			return mrpt::kinematics::CVehicleVelCmd::Ptr(
+				new mrpt::kinematics::CVehicleVelCmd_Holo(0.0, 0.0, 0.1, 0.0));
+		return getStopCmd();
+	}
+
+	mrpt::kinematics::CVehicleVelCmd::Ptr getStopCmd() override
+	{
+		if (isHolo())
+			return mrpt::kinematics::CVehicleVelCmd::Ptr(
+				new mrpt::kinematics::CVehicleVelCmd_Holo(0.0, 0.0, 1.0, 0.0));
+		mrpt::kinematics::CVehicleVelCmd::Ptr cmd(
+			new mrpt::kinematics::CVehicleVelCmd_DiffDriven());
+		cmd->setToStop();
+		return cmd;
+	}
+
+	mrpt::kinematics::CVehicleVelCmd::Ptr getAlignCmd(
+		const double relative_heading_radians) override
+	{
+		if (!isHolo()) return {};  // Not supported
+		return mrpt::kinematics::CVehicleVelCmd::Ptr(
+			new mrpt::kinematics::CVehicleVelCmd_Holo(
+				0.0,  // vel
+				relative_heading_radians,  // local_dir
+				0.5,  // ramp_time
+				mrpt::signWithZero(relative_heading_radians) *
+					mrpt::DEG2RAD(40.0)	 // rotvel
+				));
+	}
+
+	/** See CRobot2NavInterface::getNavigationTime(). In this class, simulation
+	 * time is returned instead of wall-clock time. */
+	double getNavigationTime() override
+	{
+		return m_simul.getTime() - m_simul_time_start;
+	}
+	/** See CRobot2NavInterface::resetNavigationTimer() */
+	void resetNavigationTimer() override
+	{
+		m_simul_time_start = m_simul.getTime();
+	}
+};
 }  // namespace mrpt::nav
@@ -168,6 +168,18 @@ class CWaypointsNavigator : public mrpt::nav::CAbstractNavigator
 	virtual bool impl_waypoint_is_reachable(
 		const mrpt::math::TPoint2D& wp_local_wrt_robot) const = 0;
 
+	/** Batch version of impl_waypoint_is_reachable(), invoked once per
+	 * navigation step with all the upcoming waypoints which are candidates to
+	 * be skipped to, so children classes can share the work (e.g. checking
+	 * whether obstacle information is up to date) among all of them.
+	 * `is_reachable` must be filled with one value per input point.
+	 * The default implementation calls impl_waypoint_is_reachable() for each
+	 * point.
+	 * \note (New in MRPT 2.4.9) */
+	virtual void impl_waypoints_are_reachable(
+		const std::vector<mrpt::math::TPoint2D>& wps_local_wrt_robot,
+		std::vector<bool>& is_reachable) const;
+
 	void onStartNewNavigation() override;
 
 	void onNavigateCommandReceived() override;
@@ -182,5 +194,12 @@ class CWaypointsNavigator : public mrpt::nav::CAbstractNavigator
 	bool m_was_aligning{false};
 	bool m_is_aligning{false};
 	mrpt::system::TTimeStamp m_last_alignment_cmd;
+
+   private:
+	/** Temporary buffers of waypoints_navigationStep(), kept to avoid
+	 * reallocations in each step */
+	std::vector<int> m_skip_candidates_idx;
+	std::vector<mrpt::math::TPoint2D> m_skip_candidates_local;
+	std::vector<bool> m_skip_candidates_reachable;
 };
 }  // namespace mrpt::nav
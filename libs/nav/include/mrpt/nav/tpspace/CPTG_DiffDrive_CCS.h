@@ -43,10 +43,16 @@ class CPTG_DiffDrive_CCS : public CPTG_DiffDrive_CollisionGridBased
 	bool PTG_IsIntoDomain(double x, double y) const override;
 	void ptgDiffDriveSteeringFunction(
 		float alpha, float t, float x, float y, float phi, float& v,
-		float& w) const override;
+		float& w) const final;
 	void loadDefaultParams() override;
 
    protected:
+	/** Integrates the paths calling ptgDiffDriveSteeringFunction() directly
+	 * (non-virtual). \note (New in MRPT 2.4.9) */
+	void simulateTrajectories(
+		float max_time, float max_dist, unsigned int max_n, float diferencial_t,
+		float min_dist, float* out_max_acc_v, float* out_max_acc_w) override;
+
 	double R{0}, K{0};
 };
 }  // namespace mrpt::nav
@@ -13,6 +13,10 @@
 #include <mrpt/nav/tpspace/CParameterizedTrajectoryGenerator.h>
 #include <mrpt/typemeta/TEnumType.h>
 
+#include <cstdint>
+#include <functional>
+#include <memory>
+
 namespace mrpt
 {
 namespace nav
@@ -87,11 +91,13 @@ class CPTG_DiffDrive_CollisionGridBased : public CPTG_RobotShape_Polygonal
 	void setRefDistance(const double refDist) override;
 
 	// Access to PTG paths (see docs in base class)
-	size_t getPathStepCount(uint16_t k) const override;
-	mrpt::math::TPose2D getPathPose(uint16_t k, uint32_t step) const override;
-	double getPathDist(uint16_t k, uint32_t step) const override;
+	// Path queries are answered from the flat path table, and are final so
+	// calls through a pointer to this class are not virtual:
+	size_t getPathStepCount(uint16_t k) const final;
+	mrpt::math::TPose2D getPathPose(uint16_t k, uint32_t step) const final;
+	double getPathDist(uint16_t k, uint32_t step) const final;
 	bool getPathStepForDist(
-		uint16_t k, double dist, uint32_t& out_step) const override;
+		uint16_t k, double dist, uint32_t& out_step) const final;
 	double getPathStepDuration() const override;
 	double getMaxLinVel() const override { return V_MAX; }
 	double getMaxAngVel() const override { return W_MAX; }
@@ -99,6 +105,15 @@ class CPTG_DiffDrive_CollisionGridBased : public CPTG_RobotShape_Polygonal
 		double ox, double oy, std::vector<double>& tp_obstacles) const override;
 	void updateTPObstacleSingle(
 		double ox, double oy, uint16_t k, double& tp_obstacle_k) const override;
+	/** Exact batch version of updateTPObstacle(): each distinct collision
+	 * grid cell is visited once, and the result for the last set of cells
+	 * is reused if the next call hits exactly the same cells, as happens
+	 * for a static scene and a stopped robot.
+	 * setTPObstacleCacheResolution() is ignored by this class.
+	 * \note (New in MRPT 2.4.9) */
+	void updateTPObstacleBatch(
+		const std::vector<double>& xs, const std::vector<double>& ys,
+		std::vector<double>& tp_obstacles) const override;
 
 	/** This family of PTGs ignores the dynamic states */
 	void onNewNavDynamicState() override
@@ -111,6 +126,41 @@ class CPTG_DiffDrive_CollisionGridBased : public CPTG_RobotShape_Polygonal
 	double getMax_V() const { return V_MAX; }
 	double getMax_W() const { return W_MAX; }
 
+	/** Enables a compact, flat-array cache file for the collision grid which
+	 * is memory-mapped (read-only) instead of deserialized into the heap, so
+	 * several processes using the same PTGs share one copy of it and startup
+	 * is almost instantaneous once the file exists. The file name is derived
+	 * from the one passed to initialize(), plus a hash of the robot shape,
+	 * the grid geometry and the simulated trajectories, so changing any
+	 * PTG parameter invalidates the cache automatically.
+	 * Can be also set with the config parameter `colgrid_mapped_cache`.
+	 * Must be set before initialize(). Default: false.
+	 * \note (New in MRPT 2.4.9) */
+	void setMappedColGridCache(bool enable) { m_colGridMappedCache = enable; }
+	bool getMappedColGridCache() const { return m_colGridMappedCache; }
+	/** Returns true if the collision grid in use is memory-mapped from a cache
+	 * file \sa setMappedColGridCache() */
+	bool isCollisionGridMapped() const { return m_mappedColGrid != nullptr; }
+
+	/** Number of threads used to build the collision grid in initialize(),
+	 * with 0 meaning as many as hardware threads. The resulting grid is the
+	 * same for any number of threads. Can be also set with the config
+	 * parameter `colgrid_num_threads`. Default: 0.
+	 * \note (New in MRPT 2.4.9) */
+	void setColGridNumThreads(unsigned int n) { m_colGridNumThreads = n; }
+	unsigned int getColGridNumThreads() const { return m_colGridNumThreads; }
+
+	/** Callback for initialize() progress while building the collision grid,
+	 * called once each path is done with the number of finished paths and
+	 * the total count. It may be called from worker threads, but never
+	 * concurrently. \note (New in MRPT 2.4.9) */
+	using init_progress_callback_t =
+		std::function<void(size_t numPathsDone, size_t numPaths)>;
+	void setInitProgressCallback(const init_progress_callback_t& f)
+	{
+		m_initProgressCallback = f;
+	}
+
    protected:
 	CPTG_DiffDrive_CollisionGridBased();
 
@@ -141,6 +191,8 @@ class CPTG_DiffDrive_CollisionGridBased : public CPTG_RobotShape_Polygonal
 
 	double V_MAX{.0}, W_MAX{.0};
 	double turningRadiusReference{.10};
+	/** Simulated trajectories, one vector per path `k`. Queries use a copy
+	 * of them in one flat array, see pathTableStep(). */
 	std::vector<TCPointVector> m_trajectory;
 	double m_resolution{0.05};
 	double m_stepTimeDuration{0.01};
@@ -150,13 +202,48 @@ class CPTG_DiffDrive_CollisionGridBased : public CPTG_RobotShape_Polygonal
 		mrpt::serialization::CArchive& out) const override;
 
 	/** Numerically solve the diferential equations to generate a family of
-	 * trajectories */
-	void simulateTrajectories(
+	 * trajectories.
+	 * The default implementation calls ptgDiffDriveSteeringFunction() for
+	 * each integration step. Derived classes may override it to call
+	 * simulateTrajectoriesImpl() with a non-virtual steering function. */
+	virtual void simulateTrajectories(
 		float max_time, float max_dist, unsigned int max_n, float diferencial_t,
 		float min_dist, float* out_max_acc_v = nullptr,
 		float* out_max_acc_w = nullptr);
 
-	mrpt::math::TTwist2D getPathTwist(uint16_t k, uint32_t step) const override;
+	/** Implementation of simulateTrajectories() for any steering function
+	 * `steering(alpha,t,x,y,phi,v,w)` with the signature of
+	 * ptgDiffDriveSteeringFunction(). Defined in
+	 * CPTG_DiffDrive_CollisionGridBased_impl.h (in the library sources).
+	 * \note (New in MRPT 2.4.9) */
+	template <class STEERING_FUNC>
+	void simulateTrajectoriesImpl(
+		const STEERING_FUNC& steering, float max_time, float max_dist,
+		unsigned int max_n, float diferencial_t, float min_dist,
+		float* out_max_acc_v, float* out_max_acc_w);
+
+	mrpt::math::TTwist2D getPathTwist(uint16_t k, uint32_t step) const final;
+
+	/** All the steps of all paths in m_trajectory, in one contiguous array:
+	 * the steps of path `k` are those in
+	 * [m_pathTableStart[k], m_pathTableStart[k+1]).
+	 * \note (New in MRPT 2.4.9) */
+	std::vector<TCPoint> m_pathTable;
+	std::vector<uint32_t> m_pathTableStart;
+
+	/** Rebuilds m_pathTable from m_trajectory */
+	void buildPathTable();
+
+	/** Number of steps in path `k` (non-virtual, no bound checks) */
+	uint32_t pathTableStepCount(uint16_t k) const
+	{
+		return m_pathTableStart[k + 1] - m_pathTableStart[k];
+	}
+	/** Step `step` of path `k` (non-virtual, no bound checks) */
+	const TCPoint& pathTableStep(uint16_t k, uint32_t step) const
+	{
+		return m_pathTable[m_pathTableStart[k] + step];
+	}
 
 	/**  A list of all the pairs (alpha,distance) such as the robot collides at
 	 *that cell.
@@ -206,6 +293,14 @@ class CPTG_DiffDrive_CollisionGridBased : public CPTG_RobotShape_Polygonal
 			const unsigned int icx, const unsigned int icy, const uint16_t k,
 			const float dist);
 
+		/** Empties the grid and frees the memory of all its cells, e.g. when
+		 * replaced by a memory-mapped cache. \note (New in MRPT 2.4.9) */
+		void releaseCells()
+		{
+			setSize(0, 0, 0, 0, getResolution());
+			grid_data_t().swap(m_map);
+		}
+
 	};	// end of class CCollisionGrid
 
 	// Save/Load from files.
@@ -219,6 +314,49 @@ class CPTG_DiffDrive_CollisionGridBased : public CPTG_RobotShape_Polygonal
 	/** The collision grid */
 	CCollisionGrid m_collisionGrid;
 
+	/** \sa setMappedColGridCache() */
+	bool m_colGridMappedCache{false};
+	/** \sa setColGridNumThreads() */
+	unsigned int m_colGridNumThreads{0};
+	/** \sa setInitProgressCallback() */
+	init_progress_callback_t m_initProgressCallback;
+
+	/** Adds the collisions of the k-th path to a collision grid */
+	void addPathToCollisionGrid(uint16_t k, CCollisionGrid& grid) const;
+	/** A read-only, memory-mapped collision grid (defined in the .cpp) */
+	struct TMappedColGrid;
+	/** If not null, it is used instead of m_collisionGrid. Shared by copies
+	 * of this object, since it is never modified. */
+	std::shared_ptr<const TMappedColGrid> m_mappedColGrid;
+
+	/** Linear index of the collision grid cell of an obstacle, or -1 if it
+	 * falls out of the grid. */
+	int colGridCellIndex(double ox, double oy) const;
+
+	/** Working data of updateTPObstacleBatch() */
+	struct TBatchCache
+	{
+		/** Per grid cell, the last call it was visited in */
+		std::vector<uint32_t> cellStamp;
+		uint32_t stamp{0};
+		/** Sorted cells of the current and the last call */
+		std::vector<int> cells, lastCells;
+		/** Min. distance for each path `k`, for `lastCells` */
+		std::vector<double> lastTPObs;
+	};
+	mutable TBatchCache m_batchCache;
+
+	/** Hash of the robot shape, collision grid geometry and trajectories,
+	 * used to identify valid mapped cache files. m_collisionGrid must be
+	 * already sized. */
+	uint64_t collisionGridKey() const;
+	/** Name of the mapped cache file for a given regular cache file name */
+	std::string mappedColGridFileName(const std::string& cacheFilename) const;
+	/** Saves m_collisionGrid to a flat cache file, true = OK */
+	bool saveMappedColGrid(const std::string& filename) const;
+	/** Maps a flat cache file into m_mappedColGrid, true = OK */
+	bool loadMappedColGrid(const std::string& filename);
+
 	/** Specifies the min/max values for "k" and "n", respectively.
 	 * \sa m_lambdaFunctionOptimizer
 	 */
@@ -21,6 +21,7 @@
 #include <mrpt/serialization/CSerializable.h>
 
 #include <cstdint>
+#include <unordered_map>
 
 namespace mrpt
 {
@@ -274,6 +275,20 @@ class CParameterizedTrajectoryGenerator
 	virtual void updateTPObstacleSingle(
 		double ox, double oy, uint16_t k, double& tp_obstacle_k) const = 0;
 
+	/** Like updateTPObstacle() for a set of obstacle points (xs[i],ys[i]),
+	 * relative to the origin of the PTG. Since most points of a scan fall
+	 * into cells already seen, implementations may convert each distinct
+	 * cell once, so the cost grows with the number of occupied cells rather
+	 * than with the number of points.
+	 * The default implementation calls updateTPObstacle() for each point,
+	 * unless a TP-Obstacles cache is enabled with
+	 * setTPObstacleCacheResolution().
+	 * \note Not thread-safe for concurrent calls on the same PTG object.
+	 * \note (New in MRPT 2.4.9) */
+	virtual void updateTPObstacleBatch(
+		const std::vector<double>& xs, const std::vector<double>& ys,
+		std::vector<double>& tp_obstacles) const;
+
 	/** Loads a set of default parameters into the PTG. Users normally will call
 	 * `loadFromConfigFile()` instead, this method is provided
 	 * exclusively for the PTG-configurator tool. */
@@ -386,6 +401,25 @@ class CParameterizedTrajectoryGenerator
 		m_clearance_num_points = res;
 	}
 
+	/** Enables a cache for the default implementation of
+	 * updateTPObstacleBatch(): obstacles are discretized into square cells of
+	 * this size [m], and each cell is converted into TP-Space only once, at
+	 * its central point. Cells are kept across calls until the PTG is
+	 * (de)initialized or its dynamic state changes, so the TP-Obstacles of a
+	 * static scene are reused between navigation cycles, at the price of an
+	 * error of up to half a cell in the obstacle positions. Obstacles close
+	 * to the robot shape are always converted exactly.
+	 * Derived classes with an exact batch conversion (e.g.
+	 * CPTG_DiffDrive_CollisionGridBased) ignore it.
+	 * Can be also set with the config parameter
+	 * `tp_obstacles_cache_resolution`. Default: 0 (disabled).
+	 * \note (New in MRPT 2.4.9) */
+	void setTPObstacleCacheResolution(double resolution);
+	double getTPObstacleCacheResolution() const
+	{
+		return m_tp_obstacles_cache_resolution;
+	}
+
 	unsigned getClearanceDecimatedPaths() const
 	{
 		return m_clearance_decimated_paths;
@@ -487,6 +521,22 @@ class CParameterizedTrajectoryGenerator
 
 	bool m_is_initialized{false};
 
+	/** \sa setTPObstacleCacheResolution() */
+	double m_tp_obstacles_cache_resolution{.0};
+
+	/** Cache of the default updateTPObstacleBatch() */
+	struct TTPObstacleCache
+	{
+		/** Cell key => (k,distance) TP-Obstacles of the cell */
+		std::unordered_map<
+			uint64_t, std::vector<std::pair<uint16_t, double>>>
+			cells;
+		/** Working buffers, kept to avoid reallocations */
+		std::vector<uint64_t> keys;
+		std::vector<double> tp_obs;
+	};
+	mutable TTPObstacleCache m_tp_obstacles_cache;
+
 	/** To be called by implementors of updateTPObstacle() and
 	 * updateTPObstacleSingle() to
 	 * honor the user settings regarding COLLISION_BEHAVIOR.
@@ -49,6 +49,24 @@ void CHolonomicFullEval::initialize(const mrpt::config::CConfigFileBase& c)
 	options.loadFromConfigFile(c, getConfigFileSectionName());
 }
 
+namespace
+{
+// Minimum distance from the segment (0,0)-(x,y) to the points
+// (xs[i],ys[i]). Evaluated with Eigen arrays, so it is vectorized.
+double minDistSegmentToPoints(
+	const double x, const double y, const double* xs, const double* ys,
+	const size_t n)
+{
+	const Eigen::Map<const Eigen::ArrayXd> px(xs, n), py(ys, n);
+	const double len2 = x * x + y * y;
+	if (len2 <= .0) return std::sqrt((px.square() + py.square()).minCoeff());
+
+	// Projection of each point onto the segment, clamped to its ends:
+	const auto t = ((px * x + py * y) * (1.0 / len2)).max(.0).min(1.0);
+	return std::sqrt(((px - t * x).square() + (py - t * y).square()).minCoeff());
+}
+}  // namespace
+
 struct TGap
 {
 	int k_from{-1}, k_to{-1};
@@ -73,8 +91,6 @@ void CHolonomicFullEval::evalSingleTarget(
 
 	using mrpt::square;
 
-	eo = EvalOutput();
-
 	const auto ptg = getAssociatedPTG();
 	const size_t nDirs = ni.obstacles.size();
 
@@ -85,19 +101,22 @@ void CHolonomicFullEval::evalSingleTarget(
 
 	m_dirs_scores.resize(nDirs, options.factorWeights.size() + 2);
 
-	// TP-Obstacles in 2D:
-	std::vector<mrpt::math::TPoint2D> obstacles_2d(nDirs);
-
 	mrpt::obs::T2DScanProperties sp;
 	sp.aperture = 2.0 * M_PI;
 	sp.nRays = nDirs;
 	sp.rightToLeft = true;
 	const auto& sc_lut = m_sincos_lut.getSinCosForScan(sp);
 
+	// TP-Obstacles in 2D. "No obstacle" (norm_dist=1.0) doesn't count as a
+	// real obstacle for clearance, so move them far away:
+	const double FAR_AWAY = 1e3;
+	m_obs_x.resize(nDirs);
+	m_obs_y.resize(nDirs);
 	for (unsigned int i = 0; i < nDirs; i++)
 	{
-		obstacles_2d[i].x = ni.obstacles[i] * sc_lut.ccos[i];
-		obstacles_2d[i].y = ni.obstacles[i] * sc_lut.csin[i];
+		const bool is_obs = ni.obstacles[i] < 0.99;
+		m_obs_x[i] = is_obs ? ni.obstacles[i] * sc_lut.ccos[i] : FAR_AWAY;
+		m_obs_y[i] = is_obs ? ni.obstacles[i] * sc_lut.csin[i] : FAR_AWAY;
 	}
 
 	// Sanity checks:
@@ -223,25 +242,15 @@ void CHolonomicFullEval::evalSingleTarget(
 		// it's way faster, despite being an approximation:
 		// -------------------------------------------------------------------
 		{
-			sg.point1.x = 0;
-			sg.point1.y = 0;
-			sg.point2.x = x;
-			sg.point2.y = y;
-
-			double& closest_obs = scores[4];
-			closest_obs = 1.0;
-
 			// eval obstacles within a certain region of this "i" direction only
 			const int W = std::max(1, round(nDirs * 0.1));
 			const int i_min = std::max(0, static_cast<int>(i) - W);
 			const int i_max =
 				std::min(static_cast<int>(nDirs) - 1, static_cast<int>(i) + W);
-			for (int oi = i_min; oi <= i_max; oi++)
-			{
-				// "no obstacle" (norm_dist=1.0) doesn't count as a real obs:
-				if (ni.obstacles[oi] >= 0.99) continue;
-				mrpt::keep_min(closest_obs, sg.distance(obstacles_2d[oi]));
-			}
+			scores[4] = std::min(
+				1.0,
+				minDistSegmentToPoints(
+					x, y, &m_obs_x[i_min], &m_obs_y[i_min], i_max - i_min + 1));
 		}
 
 		// Factor [6]: Direct distance in "sectors":
@@ -296,8 +305,9 @@ void CHolonomicFullEval::evalSingleTarget(
 		weights_sum_phase_inv[i] = 1.0 / weights_sum_phase[i];
 	}
 
-	eo.phase_scores = std::vector<std::vector<double>>(
-		NUM_PHASES, std::vector<double>(nDirs, .0));
+	eo.phase_scores.resize(NUM_PHASES);
+	for (auto& s : eo.phase_scores)
+		s.assign(nDirs, .0);
 	auto& phase_scores = eo.phase_scores;  // shortcut
 	double last_phase_threshold = -1.0;	 // don't threshold for the first phase
 
@@ -382,7 +392,8 @@ void CHolonomicFullEval::navigate(const NavInput& ni, NavOutput& no)
 
 	// Evaluate for each target:
 	const size_t numTrgs = ni.targets.size();
-	std::vector<EvalOutput> evals(numTrgs);
+	auto& evals = m_evals;
+	evals.resize(numTrgs);
 	for (unsigned int trg_idx = 0; trg_idx < numTrgs; trg_idx++)
 	{
 		evalSingleTarget(trg_idx, ni, evals[trg_idx]);
@@ -394,7 +405,7 @@ void CHolonomicFullEval::navigate(const NavInput& ni, NavOutput& no)
 
 	// Now, sum all weights for the last stage for each target into an "overall"
 	// score vector, one score per direction of motion:
-	std::vector<double> overall_scores;
+	auto& overall_scores = m_overall_scores;
 	overall_scores.assign(nDirs, .0);
 	for (const auto& e : evals)
 	{
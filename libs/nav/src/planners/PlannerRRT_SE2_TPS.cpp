@@ -15,15 +15,39 @@
 #include <mrpt/system/CTicTac.h>
 #include <mrpt/system/filesystem.h>
 
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+
 using namespace mrpt::nav;
 using namespace mrpt::math;
 using namespace mrpt::system;
 using namespace mrpt::poses;
 using namespace std;
 
-MRPT_TODO("Optimize getNearestNode() with KD-tree!")
+struct PlannerRRT_SE2_TPS::TAnytimeState
+{
+	std::thread thread;
+	std::atomic_bool stop{false};
+	mrpt::random::CRandomGenerator rng;
+	TPlannerInput input;
+	/** Only accessed by the planner thread */
+	TPlannerResult result;
+
+	mutable std::mutex mtx;
+	std::condition_variable cv;
+	// Protected by mtx:
+	bool finished{false};
+	std::exception_ptr error;
+	TPlannerAnytimeSolution solution;
+};
 
 PlannerRRT_SE2_TPS::PlannerRRT_SE2_TPS() = default;
+PlannerRRT_SE2_TPS::~PlannerRRT_SE2_TPS() { stopAnytime(); }
+
 /** Load all params from a config file source */
 void PlannerRRT_SE2_TPS::loadConfig(
 	const mrpt::config::CConfigFileBase& ini, const std::string& sSect)
@@ -45,6 +69,150 @@ void PlannerRRT_SE2_TPS::initialize()
 void PlannerRRT_SE2_TPS::solve(
 	const PlannerRRT_SE2_TPS::TPlannerInput& pi,
 	PlannerRRT_SE2_TPS::TPlannerResult& result)
+{
+	// The planner thread uses the same temporary buffers:
+	stopAnytime();
+
+	internal_solve(pi, result, mrpt::random::getRandomGenerator(), nullptr);
+}
+
+void PlannerRRT_SE2_TPS::solveAnytime(
+	const TPlannerInput& pi, const double timeBudget,
+	TPlannerAnytimeSolution& out)
+{
+	ASSERTMSG_(m_initialized, "initialize() must be called before!");
+	const auto deadline = std::chrono::steady_clock::now() +
+		std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+			std::chrono::duration<double>(timeBudget));
+
+	stopAnytime();
+	// Keep versions increasing across calls, for getAnytimeSolution():
+	const size_t lastVersion = m_anytime ? m_anytime->solution.version : 0;
+
+	m_anytime = std::make_unique<TAnytimeState>();
+	TAnytimeState& st = *m_anytime;
+	st.input = pi;
+	st.solution.version = lastVersion;
+	st.rng.randomize(mrpt::random::getRandomGenerator().drawUniform32bit());
+	st.thread = std::thread([this, &st]() {
+		std::exception_ptr error;
+		try
+		{
+			internal_solve(st.input, st.result, st.rng, &st.stop);
+		}
+		catch (...)
+		{
+			error = std::current_exception();
+		}
+		std::lock_guard<std::mutex> lck(st.mtx);
+		st.finished = true;
+		st.error = error;
+		st.cv.notify_all();
+	});
+
+	std::unique_lock<std::mutex> lck(st.mtx);
+	st.cv.wait_until(lck, deadline, [&st]() { return st.finished; });
+	if (st.error) std::rethrow_exception(st.error);
+	out = st.solution;
+}
+
+bool PlannerRRT_SE2_TPS::getAnytimeSolution(TPlannerAnytimeSolution& out) const
+{
+	if (!m_anytime) return false;
+	std::lock_guard<std::mutex> lck(m_anytime->mtx);
+	if (m_anytime->error) std::rethrow_exception(m_anytime->error);
+	if (m_anytime->solution.version == out.version) return false;
+	out = m_anytime->solution;
+	return true;
+}
+
+void PlannerRRT_SE2_TPS::stopAnytime()
+{
+	if (!m_anytime || !m_anytime->thread.joinable()) return;
+	m_anytime->stop = true;
+	m_anytime->thread.join();
+}
+
+bool PlannerRRT_SE2_TPS::isAnytimeRunning() const
+{
+	if (!m_anytime) return false;
+	std::lock_guard<std::mutex> lck(m_anytime->mtx);
+	return !m_anytime->finished;
+}
+
+void PlannerRRT_SE2_TPS::publishAnytimeSolution(
+	const TPlannerResult& result, double elapsed)
+{
+	TPlannerAnytimeSolution sol;
+	sol.success = (result.goal_distance < end_criteria.acceptedDistToTarget);
+	sol.goal_distance = result.goal_distance;
+	sol.path_cost = result.path_cost;
+	sol.tree_size = result.move_tree.getAllNodes().size();
+	sol.computation_time = elapsed;
+
+	TMoveTreeSE2_TP::path_t path;
+	result.move_tree.backtrackPath(result.best_goal_node_id, path);
+	for (const auto& node : path)
+		if (node.edge_to_parent) sol.path.push_back(*node.edge_to_parent);
+
+	std::lock_guard<std::mutex> lck(m_anytime->mtx);
+	sol.version = m_anytime->solution.version + 1;
+	m_anytime->solution = std::move(sol);
+}
+
+bool PlannerRRT_SE2_TPS::connectPoses(
+	const TPlannerInput& pi, const mrpt::graphs::TNodeID from_id,
+	const mrpt::math::TPose2D& from, const mrpt::math::TPose2D& to,
+	TMoveEdgeSE2_TP& out_edge)
+{
+	const CPose2D fromPose(from);
+	const CPose2D rel = CPose2D(to) - fromPose;
+
+	bool found = false;
+	for (size_t idxPTG = 0; idxPTG < m_PTGs.size(); ++idxPTG)
+	{
+		const CParameterizedTrajectoryGenerator& ptg = *m_PTGs[idxPTG];
+		int k;
+		double d;
+		if (!ptg.inverseMap_WS2TP(rel.x(), rel.y(), k, d)) continue;
+		d *= ptg.getRefDistance();	// in "real meters"
+		if (d > std::min(params.maxLength, ptg.getRefDistance()) ||
+			(found && d >= out_edge.cost))
+			continue;
+
+		// Does the path actually end at the target pose?
+		uint32_t nStep;
+		if (!ptg.getPathStepForDist(k, d, nStep)) continue;
+		mrpt::math::TPose2D rel_end = ptg.getPathPose(k, nStep);
+		mrpt::math::wrapToPiInPlace(rel_end.phi);
+		const CPose2D end = fromPose + CPose2D(rel_end);
+		if (end.distance2DTo(to.x, to.y) > params.rewireMaxDistError ||
+			std::abs(mrpt::math::angDistance(end.phi(), to.phi)) >
+				params.rewireMaxAngError)
+			continue;
+
+		// Is it obstacle-free?
+		const double MAX_DIST_FOR_OBSTACLES = 1.5 * ptg.getRefDistance();
+		transformPointcloudWithSquareClipping(
+			pi.obstacles_points, m_local_obs, fromPose, MAX_DIST_FOR_OBSTACLES);
+		double d_free = .0;
+		spaceTransformerOneDirectionOnly(
+			k, m_local_obs, &ptg, MAX_DIST_FOR_OBSTACLES, d_free);
+		if (d_free < d) continue;
+
+		out_edge = TMoveEdgeSE2_TP(from_id, end.asTPose());
+		out_edge.cost = d;
+		out_edge.ptg_index = idxPTG;
+		out_edge.ptg_K = k;
+		out_edge.ptg_dist = d;
+		found = true;
+	}
+	return found;
+}
+
+void PlannerRRT_SE2_TPS::internal_solve(
+	const TPlannerInput& pi, TPlannerResult& result,
+	mrpt::random::CRandomGenerator& rng, const std::atomic_bool* anytime_stop)
 {
 	mrpt::system::CTimeLoggerEntry tleg(m_timelogger, "PT_RRT::solve");
 
@@ -64,6 +232,24 @@ void PlannerRRT_SE2_TPS::solve(
 			result.move_tree.root, TNodeSE2_TP(pi.start_pose));
 	}
 
+	// RRT* rewiring:
+	const bool rewire = params.rewireRadius > 0 || anytime_stop != nullptr;
+	const double rewireRadius =
+		params.rewireRadius > 0 ? params.rewireRadius : params.maxLength;
+	// Cost from the root to each node (only maintained if rewiring):
+	std::vector<double> cost_to_come;
+	std::vector<mrpt::graphs::TNodeID> near_ids;
+	if (rewire)
+	{
+		cost_to_come.assign(result.move_tree.getNextFreeNodeID(), .0);
+		result.move_tree.visitDepthFirst(
+			result.move_tree.root,
+			[&](const mrpt::graphs::TNodeID parent,
+				const TMoveTreeSE2_TP::TEdgeInfo& edge, size_t) {
+				cost_to_come[edge.id] = cost_to_come[parent] + edge.data.cost;
+			});
+	}
+
 	mrpt::system::CTicTac working_time;
 	working_time.Tic();
 	size_t rrt_iter_counter = 0;
@@ -82,22 +268,27 @@ void PlannerRRT_SE2_TPS::solve(
 	{
 		// Check end conditions:
 		const double elap_tim = working_time.Tac();
-		if ((end_criteria.maxComputationTime > 0 &&
-			 elap_tim > end_criteria.maxComputationTime)  // Max comp time
-			||
+		const bool max_time_reached = end_criteria.maxComputationTime > 0 &&
+			elap_tim > end_criteria.maxComputationTime;
+		if (anytime_stop)
+		{
+			// Anytime mode: keep refining the solution until told to stop
+			if (*anytime_stop || max_time_reached) break;
+		}
+		else if (
+			max_time_reached ||
 			(result.goal_distance < end_criteria.acceptedDistToTarget &&
-			 elap_tim >= end_criteria.minComputationTime)  // Reach closer than
-			// this to target
-		)
-		{ break; }
+			 elap_tim >= end_criteria.minComputationTime))
+		{
+			break;	// Max comp time, or reached closer than this to target
+		}
 
 		// [Algo `tp_space_rrt`: Line 3]: sample random state (with goal
 		// biasing)
 		// -----------------------------------------
 		node_pose_t x_rand;
 		// bool rand_is_target=false;
-		if (mrpt::random::getRandomGenerator().drawUniform(0.0, 1.0) <
-			params.goalBias)
+		if (rng.drawUniform(0.0, 1.0) < params.goalBias)
 		{
 			x_rand = pi.goal_pose;
 			// rand_is_target=true;
@@ -106,8 +297,8 @@ void PlannerRRT_SE2_TPS::solve(
 		{
 			// Sample uniform:
 			for (int i = 0; i < node_pose_t::static_size; i++)
-				x_rand[i] = mrpt::random::getRandomGenerator().drawUniform(
-					pi.world_bbox_min[i], pi.world_bbox_max[i]);
+				x_rand[i] =
+					rng.drawUniform(pi.world_bbox_min[i], pi.world_bbox_max[i]);
 		}
 		const CPose2D x_rand_pose(x_rand);
 
@@ -370,8 +561,39 @@ void PlannerRRT_SE2_TPS::solve(
 		// ------------------------------------------------------------
 		if (!candidate_new_nodes.empty())
 		{
-			const TMoveEdgeSE2_TP& best_edge =
-				candidate_new_nodes.begin()->second;
+			TMoveEdgeSE2_TP best_edge = candidate_new_nodes.begin()->second;
+
+			// [RRT*]: Pick the lowest-cost parent among the nearby nodes:
+			if (rewire)
+			{
+				CTimeLoggerEntry tle(m_timelogger, "PT_RRT::solve.rewire");
+				double best_cost =
+					cost_to_come[best_edge.parent_id] + best_edge.cost;
+				const TPose2D new_state = best_edge.end_state;
+				result.move_tree.getNodesWithinRadius(
+					TPoint2D(new_state.x, new_state.y), rewireRadius,
+					near_ids);
+				for (const auto id : near_ids)
+				{
+					const TPose2D& near_state =
+						result.move_tree.getAllNodes().find(id)->second.state;
+					// Paths are, at least, as long as the Euclidean distance:
+					const double euclid_dist =
+						(new_state.translation() - near_state.translation())
+							.norm();
+					if (id == best_edge.parent_id ||
+						cost_to_come[id] + euclid_dist >= best_cost)
+						continue;
+					TMoveEdgeSE2_TP edge;
+					if (!connectPoses(pi, id, near_state, new_state, edge))
+						continue;
+					if (cost_to_come[id] + edge.cost < best_cost)
+					{
+						best_cost = cost_to_come[id] + edge.cost;
+						best_edge = edge;
+					}
+				}
+			}
 			const TNodeSE2_TP new_state_node(best_edge.end_state);
 
 			// Insert into the tree:
@@ -379,6 +601,12 @@ void PlannerRRT_SE2_TPS::solve(
 				result.move_tree.getNextFreeNodeID();
 			result.move_tree.insertNodeAndEdge(
 				best_edge.parent_id, new_child_id, new_state_node, best_edge);
+			if (rewire)
+			{
+				cost_to_come.resize(new_child_id + 1);
+				cost_to_come[new_child_id] =
+					cost_to_come[best_edge.parent_id] + best_edge.cost;
+			}
 
 			// Distance to goal:
 			const double goal_dist =
@@ -418,8 +646,72 @@ void PlannerRRT_SE2_TPS::solve(
 				result.best_goal_node_id = new_child_id;
 				is_new_best_solution = true;
 			}
+
+			// [RRT*]: Reconnect nearby nodes through the new one, if cheaper:
+			if (rewire)
+			{
+				CTimeLoggerEntry tle(m_timelogger, "PT_RRT::solve.rewire");
+				const double new_cost = cost_to_come[new_child_id];
+				bool any_rewired = false;
+				result.move_tree.getNodesWithinRadius(
+					TPoint2D(new_state_node.state.x, new_state_node.state.y),
+					rewireRadius, near_ids);
+				for (const auto id : near_ids)
+				{
+					if (id == new_child_id || id == best_edge.parent_id ||
+						id == result.move_tree.root)
+						continue;
+					const TPose2D& near_state =
+						result.move_tree.getAllNodes().find(id)->second.state;
+					const double euclid_dist =
+						(new_state_node.state.translation() -
+						 near_state.translation())
+							.norm();
+					if (new_cost + euclid_dist >= cost_to_come[id]) continue;
+					TMoveEdgeSE2_TP edge;
+					if (!connectPoses(
+							pi, new_child_id, new_state_node.state, near_state,
+							edge))
+						continue;
+					// (A strictly positive cost also prevents cycles, since
+					// ancestors of the new node are not more expensive than it)
+					const double delta = new_cost + edge.cost - cost_to_come[id];
+					if (edge.cost <= 0 || delta >= 0) continue;
+
+					result.move_tree.changeParent(id, new_child_id, edge);
+					cost_to_come[id] += delta;
+					result.move_tree.visitDepthFirst(
+						id,
+						[&](const mrpt::graphs::TNodeID,
+							const TMoveTreeSE2_TP::TEdgeInfo& e, size_t) {
+							cost_to_come[e.id] += delta;
+						});
+					any_rewired = true;
+				}
+
+				// Rewiring may have reduced the cost of reaching the goal:
+				if (any_rewired)
+				{
+					const auto& nodes = result.move_tree.getAllNodes();
+					for (const auto id : result.acceptable_goal_node_ids)
+					{
+						if (cost_to_come[id] >= result.path_cost) continue;
+						const TPose2D& goal_node_state =
+							nodes.find(id)->second.state;
+						result.path_cost = cost_to_come[id];
+						result.goal_distance = (goal_node_state.translation() -
+												pi.goal_pose.translation())
+												   .norm();
+						result.best_goal_node_id = id;
+						is_new_best_solution = true;
+					}
+				}
+			}
 		}  // end if any candidate found
 
+		if (anytime_stop && is_new_best_solution)
+			publishAnytimeSolution(result, working_time.Tac());
+
 		//  Graphical logging, if enabled:
 		// ------------------------------------------------------
 		if (params.save_3d_log_freq > 0 &&
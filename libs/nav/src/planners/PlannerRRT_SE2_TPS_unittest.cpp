@@ -0,0 +1,99 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/config/CConfigFileMemory.h>
+#include <mrpt/nav/planners/PlannerRRT_SE2_TPS.h>
+#include <mrpt/random.h>
+#include <mrpt/system/CTicTac.h>
+
+#include <chrono>
+#include <thread>
+
+using namespace mrpt::nav;
+using mrpt::math::TPose2D;
+
+static const char* rrt_test_cfg = R"(
+[PTG_CONFIG]
+robot_shape_circular_radius = 0.3
+PTG_COUNT = 1
+PTG0_Type = CPTG_Holo_Blend
+PTG0_refDistance = 3.0
+PTG0_num_paths = 60
+PTG0_T_ramp_max = 0.8
+PTG0_v_max_mps = 1.0
+PTG0_w_max_dps = 60
+PTG0_robot_radius = 0.3
+)";
+
+TEST(NavTests, PlannerRRT_SE2_TPS_anytime)
+{
+	mrpt::random::getRandomGenerator().randomize(1234);
+
+	PlannerRRT_SE2_TPS planner;
+	planner.loadConfig(mrpt::config::CConfigFileMemory(rrt_test_cfg));
+	planner.params.ptg_verbose = false;
+	planner.end_criteria.acceptedDistToTarget = 0.25;
+	planner.end_criteria.acceptedAngToTarget = mrpt::DEG2RAD(180.0);
+	planner.initialize();
+
+	PlannerRRT_SE2_TPS::TPlannerInput pi;
+	pi.start_pose = TPose2D(0, 0, 0);
+	pi.goal_pose = TPose2D(4, 1, 0);
+	pi.world_bbox_min = TPose2D(-1, -3, -M_PI);
+	pi.world_bbox_max = TPose2D(5, 3, M_PI);
+	// A wall in between:
+	for (double y = -0.5; y < 3.0; y += 0.05)
+		pi.obstacles_points.insertPoint(2.0, y, 0);
+
+	// It must return at the deadline, and keep planning afterwards:
+	const double timeBudget = 0.3;
+	PlannerRRT_SE2_TPS::TPlannerAnytimeSolution sol;
+	mrpt::system::CTicTac tictac;
+	planner.solveAnytime(pi, timeBudget, sol);
+	const double t = tictac.Tac();
+	EXPECT_GE(t, timeBudget);
+	EXPECT_LT(t, timeBudget + 1.0);
+	EXPECT_TRUE(planner.isAnytimeRunning());
+
+	for (int i = 0; i < 100 && !sol.success; i++)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+		planner.getAnytimeSolution(sol);
+	}
+	ASSERT_TRUE(sol.success);
+	ASSERT_FALSE(sol.path.empty());
+
+	// The path is a sequence of PTG motions from the start pose:
+	double cost = 0;
+	for (const auto& edge : sol.path)
+	{
+		cost += edge.cost;
+		EXPECT_EQ(edge.ptg_index, 0);
+		EXPECT_GT(edge.ptg_dist, 0);
+	}
+	EXPECT_NEAR(cost, sol.path_cost, 1e-6);
+	EXPECT_LT(
+		(sol.path.back().end_state.translation() - pi.goal_pose.translation())
+			.norm(),
+		0.25 + planner.params.rewireMaxDistError);
+
+	// Later solutions can only be better:
+	const auto firstSol = sol;
+	std::this_thread::sleep_for(std::chrono::milliseconds(500));
+	planner.stopAnytime();
+	EXPECT_FALSE(planner.isAnytimeRunning());
+
+	if (planner.getAnytimeSolution(sol))
+	{
+		EXPECT_GT(sol.version, firstSol.version);
+		EXPECT_LE(sol.path_cost, firstSol.path_cost);
+	}
+	EXPECT_FALSE(planner.getAnytimeSolution(sol));
+}
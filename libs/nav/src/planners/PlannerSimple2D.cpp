@@ -27,32 +27,18 @@ void PlannerSimple2D::computePath(
 	const CPose2D& target_, std::deque<math::TPoint2D>& path, bool& notFound,
 	float maxSearchPathLength) const
 {
-	using cell_t = int32_t;
-
-	constexpr cell_t CELL_ORIGIN = 0;
-	constexpr cell_t CELL_EMPTY = 0x8000000;
-	constexpr cell_t CELL_OBSTACLE = 0xfffffff;
-	constexpr cell_t CELL_TARGET = 0xffffffe;
-
 	path.clear();
 
 	const TPoint2D origin = TPoint2D(origin_.asTPose());
 	const TPoint2D target = TPoint2D(target_.asTPose());
 
-	std::vector<cell_t> grid;
-	int size_x, size_y, i, n, m;
-	int x, y;
-	bool searching;
-	cell_t minNeigh = CELL_EMPTY, maxNeigh = CELL_EMPTY, v = 0, c;
-	int passCellFound_x = -1, passCellFound_y = -1;
-	std::vector<cell_t> pathcells_x, pathcells_y;
-
 	// Check that origin and target falls inside the grid theMap
 	// -----------------------------------------------------------
-	if (!((origin.x > theMap.getXMin() && origin.x < theMap.getXMax() &&
-		   origin.y > theMap.getYMin() && origin.y < theMap.getYMax()) ||
-		  !(target.x > theMap.getXMin() && target.x < theMap.getXMax() &&
-			target.y > theMap.getYMin() && target.y < theMap.getYMax())))
+	const auto lmbInside = [&theMap](const TPoint2D& p) {
+		return p.x > theMap.getXMin() && p.x < theMap.getXMax() &&
+			p.y > theMap.getYMin() && p.y < theMap.getYMax();
+	};
+	if (!lmbInside(origin) || !lmbInside(target))
 	{
 		notFound = true;
 		return;
@@ -68,6 +54,34 @@ void PlannerSimple2D::computePath(
 		return;
 	}
 
+	if (method == PlannerMethod::Wavefront)
+		computePathWavefront(
+			theMap, origin, target, path, notFound, maxSearchPathLength);
+	else
+		computePathIncremental(
+			theMap, origin, target, path, notFound, maxSearchPathLength);
+}
+
+void PlannerSimple2D::computePathWavefront(
+	const COccupancyGridMap2D& theMap, const TPoint2D& origin,
+	const TPoint2D& target, std::deque<math::TPoint2D>& path, bool& notFound,
+	float maxSearchPathLength) const
+{
+	using cell_t = int32_t;
+
+	constexpr cell_t CELL_ORIGIN = 0;
+	constexpr cell_t CELL_EMPTY = 0x8000000;
+	constexpr cell_t CELL_OBSTACLE = 0xfffffff;
+	constexpr cell_t CELL_TARGET = 0xffffffe;
+
+	std::vector<cell_t> grid;
+	int size_x, size_y, i, n, m;
+	int x, y;
+	bool searching;
+	cell_t minNeigh = CELL_EMPTY, maxNeigh = CELL_EMPTY, v = 0, c;
+	int passCellFound_x = -1, passCellFound_y = -1;
+	std::vector<cell_t> pathcells_x, pathcells_y;
+
 	// Get the grid size:
 	// -----------------------------------------------------------
 	size_x = theMap.getSizeX();
@@ -445,8 +459,21 @@ void PlannerSimple2D::computePath(
 	// STEP 4: Translate the path-of-cells to a path-of-2d-points with
 	// subsampling
 	//-------------------------------------------------------------------------------
+	cellsToPath(
+		theMap, origin, target, pathcells_x, pathcells_y, path, notFound,
+		maxSearchPathLength);
+}
+
+void PlannerSimple2D::cellsToPath(
+	const COccupancyGridMap2D& theMap, const TPoint2D& origin,
+	const TPoint2D& target, const std::vector<int32_t>& pathcells_x,
+	const std::vector<int32_t>& pathcells_y,
+	std::deque<mrpt::math::TPoint2D>& path, bool& notFound,
+	float maxSearchPathLength) const
+{
 	path.clear();
-	n = pathcells_x.size();
+	notFound = false;
+	const size_t n = pathcells_x.size();
 	double last_xx = origin.x;
 	double last_yy = origin.y;
 	auto last_cx = theMap.x2idx(origin.x);
@@ -455,7 +482,7 @@ void PlannerSimple2D::computePath(
 	const auto minDistSqrCells = mrpt::round(
 		mrpt::square(minStepInReturnedPath / theMap.getResolution()));
 	double accumDist = 0;
-	for (i = 0; i < n; i++)
+	for (size_t i = 0; i < n; i++)
 	{
 		// Enough distance??
 		const auto distSqrCells =
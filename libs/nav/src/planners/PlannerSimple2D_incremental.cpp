@@ -0,0 +1,740 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "nav-precomp.h"  // Precompiled headers
+//
+#include <mrpt/nav/planners/PlannerSimple2D.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <queue>
+
+using namespace mrpt;
+using namespace mrpt::maps;
+using namespace mrpt::math;
+using namespace mrpt::nav;
+
+// Path search in the 8-connected grid of cells free of obstacles within the
+// robot radius. Moving between free cells costs COST_STRAIGHT (horizontal,
+// vertical) or COST_DIAGONAL, integers so comparisons of costs and search
+// keys are exact, as D* Lite requires. The cells of the origin and target are
+// always free.
+
+namespace
+{
+using cost_t = int32_t;
+constexpr cost_t INF = std::numeric_limits<cost_t>::max();
+constexpr cost_t COST_STRAIGHT = 10, COST_DIAGONAL = 14;
+
+/** Sum of costs, saturated at INF */
+cost_t addCost(cost_t a, cost_t b) { return (a == INF || b == INF) ? INF : a + b; }
+
+struct TNeighbor
+{
+	int dx, dy;
+	cost_t cost;
+};
+constexpr std::array<TNeighbor, 8> NEIGHBORS = {
+	{{1, 0, COST_STRAIGHT},
+	 {-1, 0, COST_STRAIGHT},
+	 {0, 1, COST_STRAIGHT},
+	 {0, -1, COST_STRAIGHT},
+	 {1, 1, COST_DIAGONAL},
+	 {-1, 1, COST_DIAGONAL},
+	 {1, -1, COST_DIAGONAL},
+	 {-1, -1, COST_DIAGONAL}}};
+
+/** Admissible and consistent heuristic of the 8-connected grid */
+cost_t octileDistance(int x0, int y0, int x1, int y1)
+{
+	const int dx = std::abs(x1 - x0), dy = std::abs(y1 - y0);
+	return COST_STRAIGHT * std::max(dx, dy) +
+		(COST_DIAGONAL - COST_STRAIGHT) * std::min(dx, dy);
+}
+
+/** A grid of blocked (!=0) and free cells, with two cells forced to be free
+ * (origin and target) */
+struct TGridView
+{
+	int size_x = 0, size_y = 0;
+	const uint8_t* blocked = nullptr;
+	int32_t free1 = -1, free2 = -1;
+
+	bool isFree(int32_t c) const
+	{
+		return !blocked[c] || c == free1 || c == free2;
+	}
+	int x(int32_t c) const { return c % size_x; }
+	int y(int32_t c) const { return c / size_x; }
+	cost_t heuristic(int32_t a, int32_t b) const
+	{
+		return octileDistance(x(a), y(a), x(b), y(b));
+	}
+
+	/** Calls f(neighborCell, cost) for all the neighbors of `c` within the
+	 * grid (free or not) */
+	template <class F>
+	void forEachNeighbor(int32_t c, F&& f) const
+	{
+		const int cx = x(c), cy = y(c);
+		for (const auto& n : NEIGHBORS)
+		{
+			const int nx = cx + n.dx, ny = cy + n.dy;
+			if (nx < 0 || ny < 0 || nx >= size_x || ny >= size_y) continue;
+			f(nx + ny * size_x, n.cost);
+		}
+	}
+	/** Cost of the move between two neighbors */
+	cost_t cost(int32_t a, int32_t b, cost_t stepCost) const
+	{
+		return isFree(a) && isFree(b) ? stepCost : INF;
+	}
+};
+
+/** Sum of the costs of the moves of a path of cells */
+cost_t pathCost(const TGridView& grid, const std::vector<int32_t>& cells)
+{
+	cost_t cost = 0;
+	for (size_t i = 1; i < cells.size(); i++)
+	{
+		const bool diagonal = grid.x(cells[i]) != grid.x(cells[i - 1]) &&
+			grid.y(cells[i]) != grid.y(cells[i - 1]);
+		cost += diagonal ? COST_DIAGONAL : COST_STRAIGHT;
+	}
+	return cost;
+}
+
+/** A* search with buffers reused between calls. Cells are only valid if
+ * their stamp is that of the current search. */
+class TAStar
+{
+   public:
+	/** Finds the path from `start` to `goal` (both included in `path`),
+	 * expanding only cells for which `allowed(x,y)` is true.
+	 * \return false if there is no path. */
+	template <class ALLOWED>
+	bool search(
+		const TGridView& grid, int32_t start, int32_t goal, ALLOWED&& allowed,
+		std::vector<int32_t>& path)
+	{
+		const size_t N = static_cast<size_t>(grid.size_x) * grid.size_y;
+		if (m_stamp.size() != N ||
+			m_currentStamp > std::numeric_limits<uint32_t>::max() - 2)
+		{
+			m_stamp.assign(N, 0);
+			m_g.resize(N);
+			m_parent.resize(N);
+			m_currentStamp = 0;
+		}
+		// Open cells are marked with odd stamps, closed with even ones:
+		m_currentStamp += 2;
+		const uint32_t OPEN = m_currentStamp - 1, CLOSED = m_currentStamp;
+
+		using entry_t = std::pair<cost_t, int32_t>;
+		std::priority_queue<
+			entry_t, std::vector<entry_t>, std::greater<entry_t>>
+			open;
+		m_g[start] = 0;
+		m_parent[start] = -1;
+		m_stamp[start] = OPEN;
+		open.emplace(grid.heuristic(start, goal), start);
+
+		while (!open.empty())
+		{
+			const int32_t u = open.top().second;
+			open.pop();
+			if (m_stamp[u] == CLOSED) continue;  // duplicated entry
+			m_stamp[u] = CLOSED;
+			if (u == goal) break;
+
+			grid.forEachNeighbor(u, [&](int32_t v, cost_t stepCost) {
+				if (m_stamp[v] == CLOSED || !grid.isFree(v) ||
+					!allowed(grid.x(v), grid.y(v)))
+					return;
+				const cost_t gv = m_g[u] + stepCost;
+				if (m_stamp[v] == OPEN && gv >= m_g[v]) return;
+				m_stamp[v] = OPEN;
+				m_g[v] = gv;
+				m_parent[v] = u;
+				open.emplace(gv + grid.heuristic(v, goal), v);
+			});
+		}
+
+		path.clear();
+		if (m_stamp[goal] != CLOSED) return false;
+		for (int32_t c = goal; c != -1; c = m_parent[c])
+			path.push_back(c);
+		std::reverse(path.begin(), path.end());
+		return true;
+	}
+
+   private:
+	std::vector<uint32_t> m_stamp;
+	uint32_t m_currentStamp = 0;
+	std::vector<cost_t> m_g;
+	std::vector<int32_t> m_parent;
+};
+
+/** D* Lite (Koenig & Likhachev, 2002), optimized version, searching from the
+ * goal towards the start. Outdated entries of the priority queue are
+ * discarded when popped, instead of being removed. */
+class TDStarLite
+{
+   public:
+	bool valid = false;
+	int32_t goal = -1, start = -1;
+
+	void reset(const TGridView& grid, int32_t start_, int32_t goal_)
+	{
+		const size_t N = static_cast<size_t>(grid.size_x) * grid.size_y;
+		m_g.assign(N, INF);
+		m_rhs.assign(N, INF);
+		m_key.resize(N);
+		m_inOpen.assign(N, 0);
+		m_open = decltype(m_open)();
+		m_km = 0;
+		start = m_last = start_;
+		goal = goal_;
+		m_rhs[goal] = 0;
+		push(grid, goal);
+		valid = true;
+	}
+
+	/** Moves the start (the robot) */
+	void moveStart(const TGridView& grid, int32_t newStart)
+	{
+		m_km += grid.heuristic(m_last, newStart);
+		start = m_last = newStart;
+	}
+
+	/** Updates the vertices around cells whose blocked state changed */
+	void cellsChanged(const TGridView& grid, const std::vector<int32_t>& cells)
+	{
+		for (const int32_t c : cells)
+		{
+			updateRhsAndQueue(grid, c);
+			grid.forEachNeighbor(
+				c, [&](int32_t n, cost_t) { updateRhsAndQueue(grid, n); });
+		}
+	}
+
+	void computeShortestPath(const TGridView& grid)
+	{
+		for (;;)
+		{
+			// Discard outdated entries:
+			while (!m_open.empty() &&
+				   (!m_inOpen[m_open.top().cell] ||
+					m_open.top().key != m_key[m_open.top().cell]))
+				m_open.pop();
+			if (m_open.empty()) break;
+
+			const TEntry top = m_open.top();
+			if (!(top.key < calcKey(grid, start)) &&
+				m_rhs[start] == m_g[start])
+				break;
+
+			const int32_t u = top.cell;
+			m_open.pop();
+			m_inOpen[u] = 0;
+
+			const TKey kNew = calcKey(grid, u);
+			if (top.key < kNew) { push(grid, u); }
+			else if (m_g[u] > m_rhs[u])
+			{
+				m_g[u] = m_rhs[u];
+				grid.forEachNeighbor(u, [&](int32_t s, cost_t stepCost) {
+					if (s == goal) return;
+					m_rhs[s] = std::min(
+						m_rhs[s], addCost(grid.cost(s, u, stepCost), m_g[u]));
+					updateQueue(grid, s);
+				});
+			}
+			else
+			{
+				const cost_t gOld = m_g[u];
+				m_g[u] = INF;
+				const auto lmbUpdate = [&](int32_t s, cost_t c_su) {
+					if (s != goal && m_rhs[s] == addCost(c_su, gOld))
+						m_rhs[s] = minSuccessor(grid, s);
+					updateQueue(grid, s);
+				};
+				lmbUpdate(u, INF);
+				grid.forEachNeighbor(u, [&](int32_t s, cost_t stepCost) {
+					lmbUpdate(s, grid.cost(s, u, stepCost));
+				});
+			}
+		}
+	}
+
+	/** Follows the gradient of costs-to-goal from the start.
+	 * \return false if the goal is not reachable */
+	bool extractPath(const TGridView& grid, std::vector<int32_t>& path) const
+	{
+		path.clear();
+		if (m_g[start] == INF) return false;
+
+		const size_t maxLen = m_g.size();
+		path.push_back(start);
+		for (int32_t c = start; c != goal;)
+		{
+			int32_t next = -1;
+			cost_t best = INF;
+			grid.forEachNeighbor(c, [&](int32_t n, cost_t stepCost) {
+				const cost_t v = addCost(grid.cost(c, n, stepCost), m_g[n]);
+				if (v < best)
+				{
+					best = v;
+					next = n;
+				}
+			});
+			if (next < 0 || path.size() > maxLen) return false;
+			path.push_back(next);
+			c = next;
+		}
+		return true;
+	}
+
+   private:
+	struct TKey
+	{
+		int64_t k1 = 0;
+		cost_t k2 = 0;
+		bool operator<(const TKey& o) const
+		{
+			return k1 < o.k1 || (k1 == o.k1 && k2 < o.k2);
+		}
+		bool operator!=(const TKey& o) const
+		{
+			return k1 != o.k1 || k2 != o.k2;
+		}
+	};
+	struct TEntry
+	{
+		TKey key;
+		int32_t cell;
+		bool operator>(const TEntry& o) const { return o.key < key; }
+	};
+
+	std::vector<cost_t> m_g, m_rhs;
+	/** The key of cells in the queue (m_inOpen!=0) */
+	std::vector<TKey> m_key;
+	std::vector<uint8_t> m_inOpen;
+	std::priority_queue<TEntry, std::vector<TEntry>, std::greater<TEntry>>
+		m_open;
+	int64_t m_km = 0;
+	int32_t m_last = -1;
+
+	TKey calcKey(const TGridView& grid, int32_t s) const
+	{
+		const cost_t m = std::min(m_g[s], m_rhs[s]);
+		return {int64_t(m) + grid.heuristic(start, s) + m_km, m};
+	}
+	void push(const TGridView& grid, int32_t s)
+	{
+		m_key[s] = calcKey(grid, s);
+		m_inOpen[s] = 1;
+		m_open.push({m_key[s], s});
+	}
+	void updateQueue(const TGridView& grid, int32_t s)
+	{
+		if (m_g[s] != m_rhs[s]) push(grid, s);
+		else
+			m_inOpen[s] = 0;
+	}
+	cost_t minSuccessor(const TGridView& grid, int32_t s) const
+	{
+		cost_t best = INF;
+		grid.forEachNeighbor(s, [&](int32_t n, cost_t stepCost) {
+			best = std::min(best, addCost(grid.cost(s, n, stepCost), m_g[n]));
+		});
+		return best;
+	}
+	void updateRhsAndQueue(const TGridView& grid, int32_t s)
+	{
+		if (s != goal) m_rhs[s] = minSuccessor(grid, s);
+		updateQueue(grid, s);
+	}
+};
+}  // namespace
+
+struct PlannerSimple2D::TSearchState
+{
+	// The obstacle grid, and the map and parameters it was built for:
+	int size_x = 0, size_y = 0;
+	float x_min = 0, y_min = 0, resolution = 0;
+	float occupancyThreshold = -1;
+	int enlargement = -1;
+	uint64_t mapVersion = 0;
+	/** Whether each possible cell value is an obstacle */
+	std::vector<uint8_t> cellIsObstacle;
+	/** Obstacles in the gridmap */
+	std::vector<uint8_t> obstacle;
+	/** Number of obstacles within `enlargement` cells (Chebyshev distance)
+	 * of each cell */
+	std::vector<uint32_t> obstacleCount;
+	/** obstacleCount!=0 */
+	std::vector<uint8_t> blocked;
+	/** Cells whose `blocked` state changed in the last update */
+	std::vector<int32_t> changed;
+
+	TDStarLite dstar;
+
+	// Hierarchical search:
+	int coarse_x = 0, coarse_y = 0, blockSize = 0;
+	bool coarseValid = false;
+	/** A block is free if any of its cells is free */
+	std::vector<uint8_t> coarseBlocked;
+	std::vector<uint8_t> corridor;
+	TAStar coarseSearch, fineSearch;
+	std::vector<int32_t> coarsePath;
+
+	/** Updates the obstacle grid from the gridmap.
+	 * \return true if it has been rebuilt from scratch */
+	bool updateObstacles(
+		const COccupancyGridMap2D& m, float threshold, int enlarge);
+	void rebuildObstacleCount();
+	void updateCoarseGrid(bool rebuilt, int newBlockSize);
+	void updateCoarseBlock(int bx, int by);
+	bool planHierarchical(
+		int32_t start, int32_t goal, unsigned int corridorWidth,
+		std::vector<int32_t>& path);
+
+	TGridView fineGrid(int32_t start, int32_t goal) const
+	{
+		TGridView g;
+		g.size_x = size_x;
+		g.size_y = size_y;
+		g.blocked = blocked.data();
+		g.free1 = start;
+		g.free2 = goal;
+		return g;
+	}
+};
+
+bool PlannerSimple2D::TSearchState::updateObstacles(
+	const COccupancyGridMap2D& m, float threshold, int enlarge)
+{
+	changed.clear();
+
+	if (threshold != occupancyThreshold)
+	{
+		using cell_t = COccupancyGridMap2D::cellType;
+		using ucell_t = COccupancyGridMap2D::cellTypeUnsigned;
+		constexpr size_t nValues = size_t(1) << (8 * sizeof(cell_t));
+		cellIsObstacle.resize(nValues);
+		for (size_t i = 0; i < nValues; i++)
+			cellIsObstacle[i] = COccupancyGridMap2D::l2p(static_cast<cell_t>(
+									static_cast<ucell_t>(i))) <= threshold;
+	}
+
+	const bool sameGeometry = size_x == static_cast<int>(m.getSizeX()) &&
+		size_y == static_cast<int>(m.getSizeY()) && x_min == m.getXMin() &&
+		y_min == m.getYMin() && resolution == m.getResolution();
+	const bool rebuild = !sameGeometry || threshold != occupancyThreshold ||
+		enlarge != enlargement || obstacle.empty();
+	if (!rebuild && mapVersion == m.getMapVersion()) return false;
+
+	size_x = static_cast<int>(m.getSizeX());
+	size_y = static_cast<int>(m.getSizeY());
+	x_min = m.getXMin();
+	y_min = m.getYMin();
+	resolution = m.getResolution();
+	occupancyThreshold = threshold;
+	enlargement = enlarge;
+	mapVersion = m.getMapVersion();
+
+	const size_t N = static_cast<size_t>(size_x) * size_y;
+	if (rebuild)
+	{
+		obstacle.resize(N);
+		for (int y = 0; y < size_y; y++)
+		{
+			const auto* row = m.getRow(y);
+			auto* out = &obstacle[static_cast<size_t>(y) * size_x];
+			for (int x = 0; x < size_x; x++)
+				out[x] = cellIsObstacle[static_cast<
+					COccupancyGridMap2D::cellTypeUnsigned>(row[x])];
+		}
+		rebuildObstacleCount();
+		return true;
+	}
+
+	// Find which obstacles changed:
+	std::vector<int32_t> diffs;
+	for (int y = 0; y < size_y; y++)
+	{
+		const auto* row = m.getRow(y);
+		const auto* cur = &obstacle[static_cast<size_t>(y) * size_x];
+		for (int x = 0; x < size_x; x++)
+			if (cellIsObstacle[static_cast<COccupancyGridMap2D::
+											   cellTypeUnsigned>(row[x])] !=
+				cur[x])
+				diffs.push_back(x + y * size_x);
+	}
+	// Many changes: cheaper to start over
+	if (diffs.size() > N / 16)
+	{
+		for (const int32_t c : diffs)
+			obstacle[c] ^= 1;
+		rebuildObstacleCount();
+		return true;
+	}
+
+	for (const int32_t c : diffs)
+	{
+		const bool isObs = (obstacle[c] ^= 1) != 0;
+		const int cx = c % size_x, cy = c / size_x;
+		const int x0 = std::max(0, cx - enlargement),
+				  x1 = std::min(size_x - 1, cx + enlargement);
+		const int y0 = std::max(0, cy - enlargement),
+				  y1 = std::min(size_y - 1, cy + enlargement);
+		for (int y = y0; y <= y1; y++)
+		{
+			for (int x = x0; x <= x1; x++)
+			{
+				const int32_t i = x + y * size_x;
+				auto& cnt = obstacleCount[i];
+				if (isObs ? (cnt++ == 0) : (--cnt == 0))
+				{
+					blocked[i] = isObs ? 1 : 0;
+					changed.push_back(i);
+				}
+			}
+		}
+	}
+	return false;
+}
+
+void PlannerSimple2D::TSearchState::rebuildObstacleCount()
+{
+	const size_t N = static_cast<size_t>(size_x) * size_y;
+	const int k = enlargement;
+
+	// Separable box sum: first along rows, then along columns.
+	std::vector<uint32_t> rowSum(N);
+	for (int y = 0; y < size_y; y++)
+	{
+		const uint8_t* in = &obstacle[static_cast<size_t>(y) * size_x];
+		uint32_t* out = &rowSum[static_cast<size_t>(y) * size_x];
+		uint32_t acc = 0;
+		for (int x = 0; x < std::min(k, size_x); x++)
+			acc += in[x];
+		for (int x = 0; x < size_x; x++)
+		{
+			if (x + k < size_x) acc += in[x + k];
+			if (x - k - 1 >= 0) acc -= in[x - k - 1];
+			out[x] = acc;
+		}
+	}
+	obstacleCount.assign(N, 0);
+	for (int x = 0; x < size_x; x++)
+	{
+		uint32_t acc = 0;
+		for (int y = 0; y < std::min(k, size_y); y++)
+			acc += rowSum[x + static_cast<size_t>(y) * size_x];
+		for (int y = 0; y < size_y; y++)
+		{
+			if (y + k < size_y) acc += rowSum[x + (y + k) * size_t(size_x)];
+			if (y - k - 1 >= 0)
+				acc -= rowSum[x + (y - k - 1) * size_t(size_x)];
+			obstacleCount[x + y * size_t(size_x)] = acc;
+		}
+	}
+
+	blocked.resize(N);
+	for (size_t i = 0; i < N; i++)
+		blocked[i] = obstacleCount[i] != 0 ? 1 : 0;
+}
+
+void PlannerSimple2D::TSearchState::updateCoarseBlock(int bx, int by)
+{
+	const int x1 = std::min(size_x, (bx + 1) * blockSize);
+	const int y1 = std::min(size_y, (by + 1) * blockSize);
+	uint8_t b = 1;
+	for (int y = by * blockSize; y < y1 && b; y++)
+		for (int x = bx * blockSize; x < x1; x++)
+			if (!blocked[x + y * size_t(size_x)])
+			{
+				b = 0;
+				break;
+			}
+	coarseBlocked[bx + by * coarse_x] = b;
+}
+
+void PlannerSimple2D::TSearchState::updateCoarseGrid(
+	bool rebuilt, int newBlockSize)
+{
+	if (rebuilt || !coarseValid || newBlockSize != blockSize)
+	{
+		blockSize = newBlockSize;
+		coarse_x = (size_x + blockSize - 1) / blockSize;
+		coarse_y = (size_y + blockSize - 1) / blockSize;
+		coarseBlocked.resize(static_cast<size_t>(coarse_x) * coarse_y);
+		for (int by = 0; by < coarse_y; by++)
+			for (int bx = 0; bx < coarse_x; bx++)
+				updateCoarseBlock(bx, by);
+		coarseValid = true;
+		return;
+	}
+	for (const int32_t c : changed)
+		updateCoarseBlock((c % size_x) / blockSize, (c / size_x) / blockSize);
+}
+
+bool PlannerSimple2D::TSearchState::planHierarchical(
+	int32_t start, int32_t goal, unsigned int corridorWidth,
+	std::vector<int32_t>& path)
+{
+	const TGridView fine = fineGrid(start, goal);
+	const auto lmbCoarseCell = [&](int32_t c) {
+		return (fine.x(c) / blockSize) + (fine.y(c) / blockSize) * coarse_x;
+	};
+
+	TGridView coarse;
+	coarse.size_x = coarse_x;
+	coarse.size_y = coarse_y;
+	coarse.blocked = coarseBlocked.data();
+	coarse.free1 = lmbCoarseCell(start);
+	coarse.free2 = lmbCoarseCell(goal);
+
+	if (coarseSearch.search(
+			coarse, coarse.free1, coarse.free2, [](int, int) { return true; },
+			coarsePath))
+	{
+		// Corridor: the blocks of the coarse path, and their neighbors:
+		corridor.assign(coarseBlocked.size(), 0);
+		const int w = static_cast<int>(corridorWidth);
+		for (const int32_t c : coarsePath)
+		{
+			const int cx = coarse.x(c), cy = coarse.y(c);
+			for (int y = std::max(0, cy - w);
+				 y <= std::min(coarse_y - 1, cy + w); y++)
+				for (int x = std::max(0, cx - w);
+					 x <= std::min(coarse_x - 1, cx + w); x++)
+					corridor[x + y * coarse_x] = 1;
+		}
+		const auto lmbInCorridor = [&](int x, int y) {
+			return corridor[x / blockSize + (y / blockSize) * coarse_x] != 0;
+		};
+		if (fineSearch.search(fine, start, goal, lmbInCorridor, path))
+			return true;
+	}
+	// Free blocks may not be connected at full resolution: search everywhere
+	return fineSearch.search(
+		fine, start, goal, [](int, int) { return true; }, path);
+}
+
+// PlannerSimple2D methods which need the definition of TSearchState:
+
+PlannerSimple2D::PlannerSimple2D() = default;
+PlannerSimple2D::~PlannerSimple2D() = default;
+
+PlannerSimple2D::PlannerSimple2D(const PlannerSimple2D& o)
+	: occupancyThreshold(o.occupancyThreshold),
+	  minStepInReturnedPath(o.minStepInReturnedPath),
+	  robotRadius(o.robotRadius),
+	  method(o.method),
+	  hierarchicalBlockSize(o.hierarchicalBlockSize),
+	  hierarchicalCorridorWidth(o.hierarchicalCorridorWidth)
+{
+	// The search state is not copied.
+}
+
+PlannerSimple2D& PlannerSimple2D::operator=(const PlannerSimple2D& o)
+{
+	if (this == &o) return *this;
+	occupancyThreshold = o.occupancyThreshold;
+	minStepInReturnedPath = o.minStepInReturnedPath;
+	robotRadius = o.robotRadius;
+	method = o.method;
+	hierarchicalBlockSize = o.hierarchicalBlockSize;
+	hierarchicalCorridorWidth = o.hierarchicalCorridorWidth;
+	m_state.reset();
+	return *this;
+}
+
+void PlannerSimple2D::resetSearchState() { m_state.reset(); }
+
+void PlannerSimple2D::computePathIncremental(
+	const COccupancyGridMap2D& theMap, const TPoint2D& origin,
+	const TPoint2D& target, std::deque<TPoint2D>& path, bool& notFound,
+	float maxSearchPathLength) const
+{
+	notFound = true;
+	if (!m_state) m_state = std::make_unique<TSearchState>();
+	auto& st = *m_state;
+
+	const bool rebuilt = st.updateObstacles(
+		theMap, occupancyThreshold,
+		static_cast<int>(std::ceil(robotRadius / theMap.getResolution())));
+	// The state of the other method can not be repaired any more:
+	if (rebuilt || !st.changed.empty())
+	{
+		if (method == PlannerMethod::DStarLite) st.coarseValid = false;
+		else
+			st.dstar.valid = false;
+	}
+
+	const int32_t start =
+		theMap.x2idx(origin.x) + st.size_x * theMap.y2idx(origin.y);
+	const int32_t goal =
+		theMap.x2idx(target.x) + st.size_x * theMap.y2idx(target.y);
+
+	std::vector<int32_t> cells;
+	bool found = false;
+	if (method == PlannerMethod::DStarLite)
+	{
+		auto& ds = st.dstar;
+		if (rebuilt || !ds.valid || ds.goal != goal)
+			ds.reset(st.fineGrid(start, goal), start, goal);
+		else
+		{
+			// The former start cell is no longer forced to be free, the new
+			// one is:
+			if (ds.start != start)
+			{
+				st.changed.push_back(ds.start);
+				st.changed.push_back(start);
+				ds.moveStart(st.fineGrid(start, goal), start);
+			}
+			ds.cellsChanged(st.fineGrid(start, goal), st.changed);
+		}
+		const TGridView grid = st.fineGrid(start, goal);
+		ds.computeShortestPath(grid);
+		found = ds.extractPath(grid, cells);
+	}
+	else
+	{
+		ASSERT_GT_(hierarchicalBlockSize, 0U);
+		st.updateCoarseGrid(rebuilt, static_cast<int>(hierarchicalBlockSize));
+		found = st.planHierarchical(
+			start, goal, hierarchicalCorridorWidth, cells);
+	}
+	st.changed.clear();
+	if (!found) return;
+
+	const float cost =
+		pathCost(st.fineGrid(start, goal), cells) / float(COST_STRAIGHT);
+	if (maxSearchPathLength > 0 &&
+		cost * theMap.getResolution() > maxSearchPathLength)
+		return;
+
+	// Cells between the origin and the target:
+	std::vector<int32_t> cells_x, cells_y;
+	for (size_t i = 1; i + 1 < cells.size(); i++)
+	{
+		cells_x.push_back(cells[i] % st.size_x);
+		cells_y.push_back(cells[i] / st.size_x);
+	}
+	cellsToPath(
+		theMap, origin, target, cells_x, cells_y, path, notFound,
+		maxSearchPathLength);
+}
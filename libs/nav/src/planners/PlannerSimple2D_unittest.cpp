@@ -85,3 +85,90 @@ TEST(PlannerSimple2D, findPath)
 		EXPECT_EQ(thePath.size(), 0U);
 	}
 }
+
+namespace
+{
+mrpt::maps::COccupancyGridMap2D loadTestGridmap()
+{
+	using namespace std::string_literals;
+	const auto fil = mrpt::UNITTEST_BASEDIR +
+		"/share/mrpt/datasets/2006-MalagaCampus.gridmap.gz"s;
+
+	mrpt::maps::COccupancyGridMap2D gridmap;
+	mrpt::io::CFileGZInputStream f(fil);
+	auto arch = mrpt::serialization::archiveFrom(f);
+	arch >> gridmap;
+	return gridmap;
+}
+
+double pathLength(const std::deque<mrpt::math::TPoint2D>& path)
+{
+	double len = 0;
+	for (size_t i = 1; i < path.size(); i++)
+		len += (path[i] - path[i - 1]).norm();
+	return len;
+}
+}  // namespace
+
+TEST(PlannerSimple2D, incrementalAndHierarchical)
+{
+	using mrpt::nav::PlannerSimple2D;
+
+	auto gridmap = loadTestGridmap();
+	const mrpt::poses::CPose2D origin(20, -110, 0), target(90, 40, 0);
+
+	PlannerSimple2D wavefront;
+	wavefront.robotRadius = 0.30f;
+	std::deque<mrpt::math::TPoint2D> refPath;
+	bool notFound;
+	wavefront.computePath(gridmap, origin, target, refPath, notFound);
+	ASSERT_FALSE(notFound);
+	const double refLen = pathLength(refPath);
+
+	PlannerSimple2D dstar = wavefront, hier = wavefront;
+	dstar.method = PlannerSimple2D::PlannerMethod::DStarLite;
+	hier.method = PlannerSimple2D::PlannerMethod::Hierarchical;
+
+	for (auto* planner : {&dstar, &hier})
+	{
+		std::deque<mrpt::math::TPoint2D> path;
+		planner->computePath(gridmap, origin, target, path, notFound);
+		ASSERT_FALSE(notFound);
+		EXPECT_NEAR(path.front().x, origin.x(), 1.0);
+		EXPECT_NEAR(path.front().y, origin.y(), 1.0);
+		EXPECT_NEAR(path.back().x, target.x(), 1.0);
+		EXPECT_NEAR(path.back().y, target.y(), 1.0);
+		EXPECT_NEAR(pathLength(path), refLen, 0.1 * refLen);
+
+		// Unreachable within the maximum length:
+		planner->computePath(gridmap, origin, target, path, notFound, 10.0f);
+		EXPECT_TRUE(notFound);
+	}
+
+	// Block the middle of the path, and move the robot along it:
+	std::deque<mrpt::math::TPoint2D> path;
+	dstar.computePath(gridmap, origin, target, path, notFound);
+	ASSERT_FALSE(notFound);
+	const auto mid = path.at(path.size() / 2);
+	const int cx = gridmap.x2idx(mid.x), cy = gridmap.y2idx(mid.y);
+	const int W = 10;
+	for (int y = cy - W; y <= cy + W; y++)
+		for (int x = cx - W; x <= cx + W; x++)
+			gridmap.setCell(x, y, 0.0f);
+	gridmap.markLikelihoodCacheDirty(cx - W, cy - W, cx + W, cy + W);
+
+	const mrpt::poses::CPose2D newOrigin(path.at(2).x, path.at(2).y, 0);
+	dstar.computePath(gridmap, newOrigin, target, path, notFound);
+	ASSERT_FALSE(notFound);
+	for (const auto& p : path)
+		EXPECT_FALSE(
+			std::abs(gridmap.x2idx(p.x) - cx) <= W &&
+			std::abs(gridmap.y2idx(p.y) - cy) <= W);
+
+	// The repaired search is as good as a new one:
+	std::deque<mrpt::math::TPoint2D> freshPath;
+	PlannerSimple2D fresh = dstar;	// (copies do not have search state)
+	fresh.computePath(gridmap, newOrigin, target, freshPath, notFound);
+	ASSERT_FALSE(notFound);
+	EXPECT_NEAR(pathLength(path), pathLength(freshPath), 0.02 * refLen);
+}
@@ -0,0 +1,138 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/nav/planners/TMoveTree.h>
+#include <mrpt/random.h>
+
+#include <algorithm>
+
+using namespace mrpt::nav;
+using mrpt::math::TPose2D;
+
+template <class TREE>
+static void testNearestNode()
+{
+	auto& rng = mrpt::random::getRandomGenerator();
+	rng.randomize(1234);
+
+	const auto randomPose = [&]() {
+		return TPose2D(
+			rng.drawUniform(-10.0, 10.0), rng.drawUniform(-10.0, 10.0),
+			rng.drawUniform(-M_PI, M_PI));
+	};
+
+	TREE tree;
+	tree.insertNode(0, TNodeSE2_TP(TPose2D(0, 0, 0)));
+	for (mrpt::graphs::TNodeID id = 1; id < 500; id++)
+	{
+		TPose2D p;
+		if (id < 100)  // Grow along a straight line, to force rebalancing
+			p = TPose2D(0.05 * id, 0.01 * id, 0);
+		else if (id % 7 == 0)  // Repeated poses
+			p = tree.getAllNodes().find(id - 1)->second.state;
+		else
+			p = randomPose();
+		tree.insertNodeAndEdge(
+			id - 1, id, TNodeSE2_TP(p), TMoveEdgeSE2_TP(id - 1, p));
+	}
+	// Overwrite an existing node:
+	tree.insertNode(250, TNodeSE2_TP(TPose2D(-20, -20, 0)));
+
+	const std::set<mrpt::graphs::TNodeID> ignored = {3, 17, 250, 301};
+	const PoseDistanceMetric<TNodeSE2> metric;
+
+	for (int i = 0; i < 300; i++)
+	{
+		const TNodeSE2 q(i == 0 ? TPose2D(-20, -20, 0) : randomPose());
+		for (const auto* ign : {static_cast<decltype(&ignored)>(nullptr),
+								&ignored})
+		{
+			double d1 = 0, d2 = 0;
+			const auto id1 = tree.getNearestNode(q, metric, &d1, ign);
+			const auto id2 =
+				tree.getNearestNodeBruteForce(q, metric, &d2, ign);
+			EXPECT_EQ(id1, id2) << "query=" << q.state.asString();
+			EXPECT_EQ(d1, d2);
+		}
+	}
+	EXPECT_EQ(
+		tree.getNearestNode(TNodeSE2(TPose2D(-20, -20, 0)), metric), 250U);
+}
+
+TEST(NavTests, TMoveTree_getNearestNode)
+{
+	testNearestNode<TMoveTreeSE2_TP>();
+	testNearestNode<TMoveTree<
+		TNodeSE2_TP, TMoveEdgeSE2_TP, mrpt::containers::map_traits_stdmap>>();
+}
+
+TEST(NavTests, TMoveTree_getNodesWithinRadius)
+{
+	auto& rng = mrpt::random::getRandomGenerator();
+	rng.randomize(4321);
+
+	TMoveTreeSE2_TP tree;
+	tree.insertNode(0, TNodeSE2_TP(TPose2D(0, 0, 0)));
+	for (mrpt::graphs::TNodeID id = 1; id < 300; id++)
+	{
+		const TPose2D p(
+			rng.drawUniform(-5.0, 5.0), rng.drawUniform(-5.0, 5.0), 0);
+		tree.insertNodeAndEdge(0, id, TNodeSE2_TP(p), TMoveEdgeSE2_TP(0, p));
+	}
+
+	for (int i = 0; i < 100; i++)
+	{
+		const mrpt::math::TPoint2D q(
+			rng.drawUniform(-6.0, 6.0), rng.drawUniform(-6.0, 6.0));
+		const double r = rng.drawUniform(0.1, 3.0);
+
+		std::vector<mrpt::graphs::TNodeID> ids;
+		tree.getNodesWithinRadius(q, r, ids);
+		std::sort(ids.begin(), ids.end());
+
+		std::vector<mrpt::graphs::TNodeID> expected;
+		for (const auto& n : tree.getAllNodes())
+			if ((n.second.state.translation() - q).norm() <= r)
+				expected.push_back(n.first);
+		EXPECT_EQ(ids, expected);
+	}
+}
+
+TEST(NavTests, TMoveTree_changeParent)
+{
+	// 0 -> 1 -> 2 -> 3, then 3 is reconnected to 0:
+	TMoveTreeSE2_TP tree;
+	tree.root = 0;
+	tree.insertNode(0, TNodeSE2_TP(TPose2D(0, 0, 0)));
+	for (mrpt::graphs::TNodeID id = 1; id <= 3; id++)
+	{
+		const TPose2D p(id, 0, 0);
+		TMoveEdgeSE2_TP e(id - 1, p);
+		e.cost = 1.0;
+		tree.insertNodeAndEdge(id - 1, id, TNodeSE2_TP(p), e);
+	}
+
+	TMoveEdgeSE2_TP e(0, TPose2D(3, 0, 0));
+	e.cost = 2.5;
+	tree.changeParent(3, 0, e);
+
+	TMoveTreeSE2_TP::path_t path;
+	tree.backtrackPath(3, path);
+	ASSERT_EQ(path.size(), 2U);
+	EXPECT_EQ(path.front().node_id, 0U);
+	EXPECT_EQ(path.back().node_id, 3U);
+	ASSERT_TRUE(path.back().edge_to_parent != nullptr);
+	EXPECT_DOUBLE_EQ(path.back().edge_to_parent->cost, 2.5);
+
+	EXPECT_TRUE(tree.edges_to_children[2].empty());
+	EXPECT_EQ(tree.edges_to_children[0].size(), 2U);
+
+	EXPECT_ANY_THROW(tree.changeParent(0, 1, e));
+}
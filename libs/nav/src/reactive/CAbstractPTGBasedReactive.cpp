@@ -11,6 +11,8 @@
 //
 #include <mrpt/containers/copy_container_typecasting.h>
 #include <mrpt/containers/printf_vector.h>
+#include <mrpt/core/WorkerThreadsPool.h>
+#include <mrpt/core/bits_math.h>
 #include <mrpt/core/lock_helper.h>
 #include <mrpt/io/CFileGZOutputStream.h>
 #include <mrpt/io/CMemoryStream.h>
@@ -20,11 +22,15 @@
 #include <mrpt/math/wrap2pi.h>
 #include <mrpt/nav/reactive/CAbstractPTGBasedReactive.h>
 #include <mrpt/serialization/CArchive.h>
+#include <mrpt/serialization/CSerializable.h>
 #include <mrpt/system/filesystem.h>
 
+#include <algorithm>
 #include <array>
+#include <future>
 #include <iomanip>
 #include <limits>
+#include <thread>
 
 using namespace mrpt;
 using namespace mrpt::io;
@@ -199,6 +205,124 @@ void CAbstractPTGBasedReactive::getLastLogRecord(CLogFileRecord& o)
 	o = lastLogRecord;
 }
 
+void CAbstractPTGBasedReactive::enableLogRingBuffer(
+	size_t maxRecords, bool autoDumpOnError)
+{
+	auto lckNav = mrpt::lockHelper(m_nav_cs);
+	auto lck = mrpt::lockHelper(m_logRingCS);
+	m_logRing.clear();
+	m_logRing.shrink_to_fit();
+	m_logRing.resize(maxRecords);
+	m_logRingNext = 0;
+	m_logRingCount = 0;
+	m_logRingAutoDump = autoDumpOnError;
+	m_logRingDumpPending = false;
+}
+
+size_t CAbstractPTGBasedReactive::getLogRingBufferCount() const
+{
+	auto lck = mrpt::lockHelper(m_logRingCS);
+	return m_logRingCount;
+}
+
+void CAbstractPTGBasedReactive::pushLogRingBuffer(const CLogFileRecord& rec)
+{
+	{
+		auto lck = mrpt::lockHelper(m_logRingCS);
+		if (m_logRing.empty()) return;
+
+		// The slot keeps its capacity, so no reallocation happens once the
+		// buffer is full, unless a record grows larger than the former one:
+		mrpt::serialization::ObjectToOctetVector(&rec, m_logRing[m_logRingNext]);
+		m_logRingNext = (m_logRingNext + 1) % m_logRing.size();
+		m_logRingCount = std::min(m_logRingCount + 1, m_logRing.size());
+		if (!m_logRingDumpPending) return;
+		m_logRingDumpPending = false;
+	}
+	dumpLogRingBuffer();
+}
+
+std::string CAbstractPTGBasedReactive::dumpLogRingBuffer(
+	const std::string& fileName)
+{
+	auto lckNav = mrpt::lockHelper(m_nav_cs);
+	auto lck = mrpt::lockHelper(m_logRingCS);
+
+	if (!m_logRingCount) return {};
+
+	try
+	{
+		std::string filToOpen = fileName;
+		if (filToOpen.empty())
+		{
+			mrpt::system::createDirectory(m_navlogfiles_dir);
+			for (unsigned int nFile = 0;; nFile++)
+			{
+				filToOpen = mrpt::format(
+					"%s/ring_%03u.reactivenavlog", m_navlogfiles_dir.c_str(),
+					nFile);
+				if (!system::fileExists(filToOpen)) break;
+			}
+		}
+
+		CFileGZOutputStream fil;
+		if (!fil.open(filToOpen, 1 /* compress level */))
+			THROW_EXCEPTION_FMT(
+				"Error opening log file: `%s`", filToOpen.c_str());
+
+		const size_t N = m_logRing.size();
+		const size_t first = (m_logRingNext + N - m_logRingCount) % N;
+
+		// The first record must carry the PTG parameters, so navlog-viewer
+		// can reconstruct the paths (as done in performNavigationStep()):
+		{
+			mrpt::serialization::CSerializable::Ptr obj;
+			mrpt::serialization::OctetVectorToObject(m_logRing[first], obj);
+			auto rec = std::dynamic_pointer_cast<CLogFileRecord>(obj);
+			ASSERT_(rec);
+			const size_t nPTGs = this->getPTG_count();
+			for (size_t i = 0; i < nPTGs && i < rec->infoPerPTG.size(); i++)
+			{
+				mrpt::io::CMemoryStream buf;
+				auto arch = archiveFrom(buf);
+				arch << *this->getPTG(i);
+				buf.Seek(0);
+				rec->infoPerPTG[i].ptg = std::dynamic_pointer_cast<
+					mrpt::nav::CParameterizedTrajectoryGenerator>(
+					arch.ReadObject());
+			}
+			archiveFrom(fil) << *rec;
+		}
+		// The rest are already in the serialized form of a CArchive:
+		for (size_t i = 1; i < m_logRingCount; i++)
+		{
+			const auto& blob = m_logRing[(first + i) % N];
+			fil.Write(blob.data(), blob.size());
+		}
+
+		MRPT_LOG_INFO_FMT(
+			"[CAbstractPTGBasedReactive::dumpLogRingBuffer] Saved %u log "
+			"records to `%s`",
+			static_cast<unsigned int>(m_logRingCount), filToOpen.c_str());
+		return filToOpen;
+	}
+	catch (const std::exception& e)
+	{
+		MRPT_LOG_ERROR_FMT(
+			"[CAbstractPTGBasedReactive::dumpLogRingBuffer] Exception: %s",
+			e.what());
+	}
+	return {};
+}
+
+void CAbstractPTGBasedReactive::doEmergencyStop(const std::string& msg)
+{
+	CWaypointsNavigator::doEmergencyStop(msg);
+
+	auto lck = mrpt::lockHelper(m_logRingCS);
+	if (!m_logRing.empty() && m_logRingAutoDump) m_logRingDumpPending = true;
+}
+
 void CAbstractPTGBasedReactive::deleteHolonomicObjects()
 {
 	m_holonomicMethod.clear();
@@ -244,7 +368,8 @@ void CAbstractPTGBasedReactive::performNavigationStep()
 	const size_t nPTGs = this->getPTG_count();
 
 	// Whether to worry about log files:
-	const bool fill_log_record = (m_logFile || m_enableKeepLogRecords);
+	const bool fill_log_record =
+		(m_logFile || m_enableKeepLogRecords || !m_logRing.empty());
 	CLogFileRecord newLogRec;
 	newLogRec.infoPerPTG.resize(nPTGs + 1); /* +1: [N] is the "NOP cmdvel"
 											   option; not to be present in all
@@ -519,8 +644,7 @@ void CAbstractPTGBasedReactive::performNavigationStep()
 			nPTGs + 1);	 // the last extra one is for the evaluation of "NOP
 		// motion command" choice.
 
-		for (size_t indexPTG = 0; indexPTG < nPTGs; indexPTG++)
-		{
+		auto evalPTG = [&](const size_t indexPTG, CLogFileRecord& logRec) {
 			mrpt::system::CTimeLoggerEntry tle2(
 				m_navProfiler,
 				"CAbstractPTGBasedReactive::performNavigationStep().eval_"
@@ -541,9 +665,56 @@ void CAbstractPTGBasedReactive::performNavigationStep()
 			ASSERT_(m_navigationParams);
 			build_movement_candidate(
 				ptg, indexPTG, relTargets, rel_pose_PTG_origin_wrt_sense, ipf,
-				cm, newLogRec, false /* this is a regular PTG reactive case */,
+				cm, logRec, false /* this is a regular PTG reactive case */,
 				*holoMethod, tim_start_iteration, *m_navigationParams);
-		}  // end for each PTG
+		};
+
+		size_t nThreads = params_abstract_ptg_navigator.ptg_eval_num_threads;
+		if (!nThreads)
+			nThreads = std::max(1U, std::thread::hardware_concurrency());
+		nThreads = std::min(nThreads, nPTGs);
+
+		if (nThreads <= 1)
+		{
+			for (size_t indexPTG = 0; indexPTG < nPTGs; indexPTG++)
+				evalPTG(indexPTG, newLogRec);
+		}
+		else
+		{
+			if (!m_ptgEvalThreadPool || m_ptgEvalThreadPool->size() != nThreads)
+				m_ptgEvalThreadPool = std::make_shared<mrpt::WorkerThreadsPool>(
+					nThreads, mrpt::WorkerThreadsPool::POLICY_FIFO, "ptg_eval");
+
+			// Each PTG fills its own log record (its infoPerPTG[] entry is
+			// moved in and out of it), so no locks are needed:
+			std::vector<CLogFileRecord> ptgLogRecs(nPTGs);
+			std::vector<std::future<void>> evals;
+			for (size_t indexPTG = 0; indexPTG < nPTGs; indexPTG++)
+			{
+				auto& lr = ptgLogRecs[indexPTG];
+				lr.infoPerPTG.resize(nPTGs + 1);
+				std::swap(
+					lr.infoPerPTG[indexPTG], newLogRec.infoPerPTG[indexPTG]);
+				evals.emplace_back(m_ptgEvalThreadPool->enqueue(
+					evalPTG, indexPTG, std::ref(lr)));
+			}
+			for (auto& e : evals)
+				e.wait();
+
+			// Merge in PTG order, so the log is the same than sequentially:
+			for (size_t indexPTG = 0; indexPTG < nPTGs; indexPTG++)
+			{
+				auto& lr = ptgLogRecs[indexPTG];
+				std::swap(
+					lr.infoPerPTG[indexPTG], newLogRec.infoPerPTG[indexPTG]);
+				for (auto& m : lr.additional_debug_msgs)
+					newLogRec.additional_debug_msgs[m.first] =
+						std::move(m.second);
+			}
+			// Rethrow exceptions, if any:
+			for (auto& e : evals)
+				e.get();
+		}
 
 		// check for collision, which is reflected by ALL TP-Obstacles being
 		// zero:
@@ -928,6 +1099,14 @@ void CAbstractPTGBasedReactive::performNavigationStep()
 			"[CAbstractPTGBasedReactive::performNavigationStep] Stopping robot "
 			"and finishing navigation due to untyped exception.");
 	}
+
+	// Errors without a log record for this step (exceptions):
+	bool dumpRing = false;
+	{
+		auto lck = mrpt::lockHelper(m_logRingCS);
+		std::swap(dumpRing, m_logRingDumpPending);
+	}
+	if (dumpRing) dumpLogRingBuffer();
 }
 
 /** \callergraph */
@@ -991,6 +1170,7 @@ void CAbstractPTGBasedReactive::STEP8_GenerateLogRecord(
 			m_timelogger, "navigationStep.write_log_file");
 		if (m_logFile) archiveFrom(*m_logFile) << newLogRec;
 	}
+	pushLogRingBuffer(newLogRec);
 	// Set as last log record
 	{
 		auto lck = mrpt::lockHelper(m_critZoneLastLog);
@@ -1455,17 +1635,30 @@ double CAbstractPTGBasedReactive::generate_vel_cmd(
 /** \callergraph */
 bool CAbstractPTGBasedReactive::impl_waypoint_is_reachable(
 	const mrpt::math::TPoint2D& wp) const
+{
+	std::vector<bool> is_reachable;
+	impl_waypoints_are_reachable({wp}, is_reachable);
+	return is_reachable[0];
+}
+
+/** \callergraph */
+void CAbstractPTGBasedReactive::impl_waypoints_are_reachable(
+	const std::vector<mrpt::math::TPoint2D>& wps,
+	std::vector<bool>& is_reachable) const
 {
 	MRPT_START
 
+	is_reachable.assign(wps.size(), false);
+
 	const size_t N = this->getPTG_count();
 	if (m_infoPerPTG.size() < N ||
 		m_infoPerPTG_timestamp == INVALID_TIMESTAMP ||
 		mrpt::system::timeDifference(
 			m_infoPerPTG_timestamp, mrpt::system::now()) > 0.5)
-		return false;  // We didn't run yet or obstacle info is old
+		return;	 // We didn't run yet or obstacle info is old
 
-	for (size_t i = 0; i < N; i++)
+	size_t num_pending = wps.size();
+	for (size_t i = 0; i < N && num_pending > 0; i++)
 	{
 		const CParameterizedTrajectoryGenerator* ptg = getPTG(i);
 
@@ -1475,20 +1668,37 @@ bool CAbstractPTGBasedReactive::impl_waypoint_is_reachable(
 			continue;  // May be this PTG has not been used so far? (Target out
 		// of domain,...)
 
-		int wp_k;
-		double wp_norm_d;
-		bool is_into_domain =
-			ptg->inverseMap_WS2TP(wp.x, wp.y, wp_k, wp_norm_d);
-		if (!is_into_domain) continue;
+		// PTG path distances are never shorter than the straight line, so
+		// points farther than the longest collision-free path can be
+		// discarded without the (costly) inverse map:
+		const double max_free_dist =
+			*std::max_element(tp_obs.begin(), tp_obs.end()) *
+			ptg->getRefDistance();
+		const double max_wp_dist_sqr = mrpt::square(max_free_dist / 1.01);
 
-		ASSERT_(wp_k < int(tp_obs.size()));
+		for (size_t j = 0; j < wps.size(); j++)
+		{
+			if (is_reachable[j]) continue;
+			const auto& wp = wps[j];
+			if (wp.sqrNorm() >= max_wp_dist_sqr) continue;
 
-		const double collision_free_dist = tp_obs[wp_k];
-		if (collision_free_dist > 1.01 * wp_norm_d)
-			return true;  // free path found to target
-	}
+			int wp_k;
+			double wp_norm_d;
+			bool is_into_domain =
+				ptg->inverseMap_WS2TP(wp.x, wp.y, wp_k, wp_norm_d);
+			if (!is_into_domain) continue;
+
+			ASSERT_(wp_k < int(tp_obs.size()));
 
-	return false;  // no way found
+			const double collision_free_dist = tp_obs[wp_k];
+			if (collision_free_dist > 1.01 * wp_norm_d)
+			{
+				// free path found to target
+				is_reachable[j] = true;
+				num_pending--;
+			}
+		}
+	}
 	MRPT_END
 }
 
@@ -1549,6 +1759,8 @@ void CAbstractPTGBasedReactive::build_movement_candidate(
 	}
 
 	double timeForTPObsTransformation = .0, timeForHolonomicMethod = .0;
+	// Local, since PTGs may be evaluated in parallel:
+	mrpt::system::CTicTac stopwatch;
 
 	// Normal PTG validity filter: check if target falls into the PTG domain:
 	bool any_TPTarget_is_valid = false;
@@ -1584,7 +1796,7 @@ void CAbstractPTGBasedReactive::build_movement_candidate(
 		//  STEP3(b): Build TP-Obstacles
 		// -----------------------------------------------------------------------------
 		{
-			tictac.Tic();
+			stopwatch.Tic();
 
 			// Initialize TP-Obstacles:
 			const size_t Ki = ptg->getAlphaValuesCount();
@@ -1606,7 +1818,7 @@ void CAbstractPTGBasedReactive::build_movement_candidate(
 			for (size_t i = 0; i < Ki; i++)
 				ipf.TP_Obstacles[i] *= _refD;
 
-			timeForTPObsTransformation = tictac.Tac();
+			timeForTPObsTransformation = stopwatch.Tac();
 			if (m_timelogger.isEnabled())
 				m_timelogger.registerUserMeasure(
 					"navigationStep.STEP3_WSpaceToTPSpace",
@@ -1617,7 +1829,7 @@ void CAbstractPTGBasedReactive::build_movement_candidate(
 		// -----------------------------------------------------------------------------
 		if (!this_is_PTG_continuation)
 		{
-			tictac.Tic();
+			stopwatch.Tic();
 
 			// Slow down if we are approaching the final target, etc.
 			holoMethod.enableApproachTargetSlowDown(
@@ -1684,7 +1896,7 @@ void CAbstractPTGBasedReactive::build_movement_candidate(
 			// Scale:
 			cm.speed *= velScale;
 
-			timeForHolonomicMethod = tictac.Tac();
+			timeForHolonomicMethod = stopwatch.Tac();
 			if (m_timelogger.isEnabled())
 				m_timelogger.registerUserMeasure(
 					"navigationStep.STEP4_HolonomicMethod",
@@ -1723,7 +1935,7 @@ void CAbstractPTGBasedReactive::build_movement_candidate(
 
 	// Logging:
 	const bool fill_log_record =
-		(m_logFile != nullptr || m_enableKeepLogRecords);
+		(m_logFile != nullptr || m_enableKeepLogRecords || !m_logRing.empty());
 	if (fill_log_record)
 	{
 		CLogFileRecord::TInfoPerPTG& ipp =
@@ -1770,6 +1982,7 @@ void CAbstractPTGBasedReactive::TAbstractPTGNavigatorParams::loadFromConfigFile(
 	MRPT_LOAD_CONFIG_VAR_CS(enable_obstacle_filtering, bool);
 	MRPT_LOAD_CONFIG_VAR_CS(evaluate_clearance, bool);
 	MRPT_LOAD_CONFIG_VAR_CS(max_dist_for_timebased_path_prediction, double);
+	MRPT_LOAD_CONFIG_VAR_CS(ptg_eval_num_threads, int);
 
 	MRPT_END
 }
@@ -1846,6 +2059,10 @@ void CAbstractPTGBasedReactive::TAbstractPTGNavigatorParams::saveToConfigFile(
 		max_dist_for_timebased_path_prediction,
 		"Max dist [meters] to use time-based path prediction for NOP "
 		"evaluation");
+	MRPT_SAVE_CONFIG_VAR_COMMENT(
+		ptg_eval_num_threads,
+		"Number of threads to evaluate PTGs in parallel (1=sequential, "
+		"0=all hardware threads)");
 }
 
 CAbstractPTGBasedReactive::TAbstractPTGNavigatorParams::
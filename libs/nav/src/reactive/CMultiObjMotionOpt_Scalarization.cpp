@@ -27,6 +27,8 @@ void CMultiObjMotionOpt_Scalarization::clear()
 	CMultiObjectiveMotionOptimizerBase::clear();
 	m_expr_scalar_formula = mrpt::expr::CRuntimeCompiledExpression();
 	m_expr_scalar_vars.clear();
+	m_expr_scalar_names.clear();
+	m_expr_scalar_ptrs.clear();
 }
 
 void CMultiObjMotionOpt_Scalarization::loadConfigFile(
@@ -56,20 +58,19 @@ int CMultiObjMotionOpt_Scalarization::impl_decide(
 	std::vector<double>& final_evaluation = extra_info.final_evaluation;
 	final_evaluation.clear();
 
-	if (extra_info.score_values.empty()) return -1;	 // No valid candidate
+	const auto& names = scoreNames();
+	const size_t nScores = names.size();
+	if (extra_info.score_values.empty() || !nScores)
+		return -1;	// No valid candidate
 
-	// compile expression upon first use:
-	if (m_expr_scalar_vars.empty())
+	// compile expression upon first use, binding one variable per score:
+	if (m_expr_scalar_names != names)
 	{
-		// vars:
-		for (const auto& c : extra_info.score_values)
-		{
-			for (const auto& score : c)
-			{
-				// double & var =
-				m_expr_scalar_vars[score.first];  // create or reuse placeholder
-			}
-		}
+		m_expr_scalar_vars.clear();
+		m_expr_scalar_ptrs.clear();
+		m_expr_scalar_names.clear();
+		for (const auto& name : names)
+			m_expr_scalar_vars[name];  // create placeholder
 
 		// formula:
 		m_expr_scalar_formula = mrpt::expr::CRuntimeCompiledExpression();
@@ -84,34 +85,27 @@ int CMultiObjMotionOpt_Scalarization::impl_decide(
 			m_expr_scalar_vars.clear();
 			throw;	// rethrow
 		}
+		for (const auto& name : names)
+			m_expr_scalar_ptrs.push_back(&m_expr_scalar_vars[name]);
+		m_expr_scalar_names = names;
 	}
 
-	// Evaluate the formula for all candidates:
+	// Evaluate the formula for all candidates, straight from the table of
+	// scores:
 	const size_t N = extra_info.score_values.size();
+	const double* scores = scoreTable().data();
+	ASSERT_EQUAL_(scoreTable().size(), N * nScores);
+
 	final_evaluation.assign(N, .0);
 	int best_idx = -1;
 	double best_val = .0;
-	for (size_t i = 0; i < N; i++)
+	for (size_t i = 0; i < N; i++, scores += nScores)
 	{
-		if (extra_info.score_values[i].empty())
-			continue;  // this candidate is non-eligible.
+		for (size_t j = 0; j < nScores; j++)
+			*m_expr_scalar_ptrs[j] = scores[j];
 
-		// Update variables & evaluate formula:
-		for (const auto& score : extra_info.score_values[i])
-		{
-			const auto& it = m_expr_scalar_vars.find(
-				score.first);  // this should never *create* a new entry...
-			if (it == m_expr_scalar_vars.cend())
-			{
-				THROW_EXCEPTION_FMT(
-					"Error: found unexpected (unregistered) score named `%s`.",
-					score.first.c_str());
-			}
-			double& var = it->second;
-			var = score.second;
-		}
 		const double val = m_expr_scalar_formula.eval();
-		extra_info.final_evaluation[i] = val;
+		final_evaluation[i] = val;
 
 		if (val > 0 && (best_idx == -1 || val > best_val))
 		{
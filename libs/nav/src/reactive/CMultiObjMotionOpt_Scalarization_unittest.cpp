@@ -0,0 +1,82 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/nav/reactive/CMultiObjMotionOpt_Scalarization.h>
+
+using namespace mrpt::nav;
+
+static TCandidateMovementPTG makeCandidate(double x, double y, double speed)
+{
+	TCandidateMovementPTG m;
+	m.speed = speed;
+	m.props["x"] = x;
+	m.props["y"] = y;
+	return m;
+}
+
+TEST(NavTests, CMultiObjMotionOpt_Scalarization_decide)
+{
+	CMultiObjMotionOpt_Scalarization opt;
+	auto& p = opt.parameters;
+	p.formula_score.clear();
+	p.formula_score["a"] = "x";
+	p.formula_score["b"] = "2*y";
+	p.scores_to_normalize = {"b"};
+	p.movement_assert = {"x < 10", "b > 0.1"};
+	p.scalar_score_formula = "a + 10*b";
+
+	std::vector<TCandidateMovementPTG> movs;
+	movs.push_back(makeCandidate(1.0, 1.0, 1.0));
+	movs.push_back(makeCandidate(2.0, 0.5, 1.0));
+	movs.push_back(makeCandidate(20.0, 2.0, 1.0));	// assert fails
+	movs.push_back(makeCandidate(3.0, 1.0, 0.0));  // invalid speed
+	movs.push_back(makeCandidate(4.0, 0.01, 1.0));	// b assert fails
+	// Different properties:
+	movs.push_back(makeCandidate(1.0, 1.5, 1.0));
+	movs.back().props["z"] = 7.0;
+
+	// The best "b" is that of movs[2] (4.0) before asserts:
+	const std::vector<std::pair<double, double>> expected = {
+		{1.0, 0.5}, {2.0, 0.25}, {0, 0}, {0, 0}, {0, 0}, {1.0, 0.75}};
+
+	for (int rep = 0; rep < 2; rep++)
+	{
+		CMultiObjectiveMotionOptimizerBase::TResultInfo ri;
+		const int best = opt.decide(movs, ri);
+		EXPECT_EQ(best, 5);
+
+		ASSERT_EQ(ri.score_values.size(), movs.size());
+		ASSERT_EQ(ri.final_evaluation.size(), movs.size());
+		for (size_t i = 0; i < movs.size(); i++)
+		{
+			const auto& s = ri.score_values[i];
+			ASSERT_EQ(s.size(), 2U);
+			EXPECT_DOUBLE_EQ(s.at("a"), expected[i].first) << "i=" << i;
+			EXPECT_DOUBLE_EQ(s.at("b"), expected[i].second) << "i=" << i;
+			EXPECT_DOUBLE_EQ(
+				ri.final_evaluation[i],
+				expected[i].first + 10 * expected[i].second)
+				<< "i=" << i;
+		}
+	}
+
+	// Changing the formulas requires clear():
+	p.formula_score.erase("b");
+	p.scores_to_normalize.clear();
+	p.movement_assert.clear();
+	p.scalar_score_formula = "-a";
+	opt.clear();
+
+	CMultiObjectiveMotionOptimizerBase::TResultInfo ri;
+	EXPECT_EQ(opt.decide(movs, ri), -1);
+	ASSERT_EQ(ri.final_evaluation.size(), movs.size());
+	EXPECT_DOUBLE_EQ(ri.final_evaluation[2], -20.0);
+	EXPECT_DOUBLE_EQ(ri.final_evaluation[3], 0.0);
+}
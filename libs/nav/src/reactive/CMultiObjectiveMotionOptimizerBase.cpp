@@ -12,6 +12,7 @@
 #include <mrpt/nav/reactive/CMultiObjectiveMotionOptimizerBase.h>
 #include <mrpt/system/string_utils.h>
 
+#include <algorithm>
 #include <limits>
 
 using namespace mrpt::nav;
@@ -25,34 +26,65 @@ CMultiObjectiveMotionOptimizerBase::CMultiObjectiveMotionOptimizerBase(
 {
 }
 
+void CMultiObjectiveMotionOptimizerBase::bindCandidateVars(
+	const mrpt::nav::TCandidateMovementPTG& m)
+{
+	// Candidates normally share the same list of properties: only look up
+	// their variables by name when it changes.
+	bool sameProps = (m.props.size() == m_prop_vars.size());
+	if (sameProps)
+	{
+		auto it = m_prop_vars.cbegin();
+		for (const auto& prop : m.props)
+		{
+			if (prop.first != (it++)->first)
+			{
+				sameProps = false;
+				break;
+			}
+		}
+	}
+	if (!sameProps)
+	{
+		m_prop_vars.clear();
+		for (const auto& prop : m.props)
+			m_prop_vars.emplace_back(prop.first, &m_expr_vars[prop.first]);
+	}
+	if (m_all_vars.size() != m_expr_vars.size())
+	{
+		m_all_vars.clear();
+		for (auto& p : m_expr_vars)
+			m_all_vars.push_back(&p.second);
+	}
+
+	// Mark all vars as NaN so we detect uninitialized values:
+	for (double* var : m_all_vars)
+		*var = std::numeric_limits<double>::quiet_NaN();
+
+	auto it = m_prop_vars.cbegin();
+	for (const auto& prop : m.props)
+		*(it++)->second = prop.second;
+}
+
 int CMultiObjectiveMotionOptimizerBase::decide(
 	const std::vector<mrpt::nav::TCandidateMovementPTG>& movs,
 	TResultInfo& extra_info)
 {
-	auto& score_values = extra_info.score_values;
-	score_values.resize(movs.size());
+	const size_t nMovs = movs.size();
 
 	// For each movement:
-	for (unsigned int mov_idx = 0; mov_idx < movs.size(); ++mov_idx)
+	for (unsigned int mov_idx = 0; mov_idx < nMovs; ++mov_idx)
 	{
 		const auto& m = movs[mov_idx];
 
-		// Mark all vars as NaN so we detect uninitialized values:
-		for (auto& p : m_expr_vars)
-		{
-			p.second = std::numeric_limits<double>::quiet_NaN();
-		}
-
-		for (const auto& prop : m.props)
-		{
-			double& var = m_expr_vars[prop.first];
-			var = prop.second;
-		}
+		bindCandidateVars(m);
 
 		// Upon first iteration: compile expressions
 		if (m_score_exprs.size() != m_params_base.formula_score.size())
 		{
 			m_score_exprs.clear();
+			m_score_names.clear();
+			m_score_vars.clear();
 
 			for (const auto& f : m_params_base.formula_score)
 			{
@@ -75,14 +107,17 @@ int CMultiObjectiveMotionOptimizerBase::decide(
 					auto it = m_expr_vars.find(f.first);
 					if (it != m_expr_vars.end())
 					{
+						m_score_exprs.clear();
 						THROW_EXCEPTION_FMT(
 							"Error: Expression name `%s` already exists as an "
 							"input variable.",
 							f.first.c_str());
 					}
 					// Add it:
-					m_expr_vars[f.first] =
-						std::numeric_limits<double>::quiet_NaN();
+					double& var = m_expr_vars[f.first];
+					var = std::numeric_limits<double>::quiet_NaN();
+					m_score_names.push_back(f.first);
+					m_score_vars.push_back(&var);
 				}
 			}
 		}  // end for each score expr
@@ -111,7 +146,11 @@ int CMultiObjectiveMotionOptimizerBase::decide(
 			}
 		}
 
+		if (mov_idx == 0) m_score_table.assign(nMovs * m_score_names.size(), .0);
+		double* scores = m_score_table.data() + mov_idx * m_score_names.size();
+
 		// For each score: evaluate it
+		size_t j = 0;
 		for (auto& sc : m_score_exprs)
 		{
 			// Evaluate:
@@ -131,59 +170,53 @@ int CMultiObjectiveMotionOptimizerBase::decide(
 			}
 
 			// Store:
-			score_values[mov_idx][sc.first] = val;
+			scores[j++] = val;
 		}
 	}  // end for mov_idx
 
+	const size_t nScores = m_score_names.size();
+	if (!nMovs) m_score_table.clear();
+
 	// Optional score post-processing: normalize highest value to 1.0
 	for (const auto& sScoreName : m_params_base.scores_to_normalize)
 	{
+		const auto itName = std::lower_bound(
+			m_score_names.cbegin(), m_score_names.cend(), sScoreName);
+		if (itName == m_score_names.cend() || *itName != sScoreName) continue;
+		const size_t j = itName - m_score_names.cbegin();
+
 		// Find max:
 		double maxScore = .0;
-		for (const auto& s : score_values)
-		{
-			const auto it = s.find(sScoreName);
-			if (it != s.cend()) mrpt::keep_max(maxScore, it->second);
-		}
+		for (size_t i = 0; i < nMovs; i++)
+			mrpt::keep_max(maxScore, m_score_table[i * nScores + j]);
 
 		// Normalize:
 		if (maxScore <= 0)	// all scores=0... let's decide that all are equal,
 		// so normalized to "1"
 		{
-			for (auto& s : score_values)
-			{
-				auto it = s.find(sScoreName);
-				if (it != s.end()) { it->second = 1.0; }
-			}
+			for (size_t i = 0; i < nMovs; i++)
+				m_score_table[i * nScores + j] = 1.0;
 		}
 		else if (maxScore > 0 && maxScore != 1.0 /* already normalized! */)
 		{
 			double K = 1.0 / maxScore;
-			for (auto& s : score_values)
-			{
-				auto it = s.find(sScoreName);
-				if (it != s.end()) { it->second *= K; }
-			}
+			for (size_t i = 0; i < nMovs; i++)
+				m_score_table[i * nScores + j] *= K;
 		}
 	}
 
 	// For each assert, evaluate it (*after* score normalization)
-	for (unsigned int mov_idx = 0; mov_idx < movs.size(); ++mov_idx)
+	if (!m_movement_assert_exprs.empty())
 	{
-		const auto& m = movs[mov_idx];
-		// Mark all vars as NaN so we detect uninitialized values:
-		for (auto& p : m_expr_vars)
-		{
-			p.second = std::numeric_limits<double>::quiet_NaN();
-		}
-		for (const auto& prop : m.props)
+		for (unsigned int mov_idx = 0; mov_idx < nMovs; ++mov_idx)
 		{
-			double& var = m_expr_vars[prop.first];
-			var = prop.second;
-		}
+			bindCandidateVars(movs[mov_idx]);
+			double* scores = m_score_table.data() + mov_idx * nScores;
+			// Scores are also usable from asserts:
+			for (size_t j = 0; j < nScores; j++)
+				*m_score_vars[j] = scores[j];
 
-		bool assert_failed = false;
-		{
+			bool assert_failed = false;
 			for (auto& ma : m_movement_assert_exprs)
 			{
 				const double val = ma.eval();
@@ -197,21 +230,49 @@ int CMultiObjectiveMotionOptimizerBase::decide(
 					break;
 				}
 			}
+			if (assert_failed) std::fill(scores, scores + nScores, .0);
+		}  // end mov_idx
+	}
+
+	// Publish the scores, reusing the maps if possible:
+	auto& score_values = extra_info.score_values;
+	score_values.resize(nMovs);
+	for (size_t i = 0; i < nMovs; i++)
+	{
+		auto& s = score_values[i];
+		bool sameNames = (s.size() == nScores);
+		if (sameNames)
+		{
+			size_t j = 0;
+			for (const auto& e : s)
+				if (e.first != m_score_names[j++]) sameNames = false;
 		}
-		if (assert_failed)
+		if (!sameNames)
 		{
-			for (auto& e : score_values[mov_idx])
-			{
-				e.second = .0;
-			}
+			s.clear();
+			for (const auto& name : m_score_names)
+				s.emplace_hint(s.end(), name, .0);
 		}
-	}  // end mov_idx
+		const double* scores = m_score_table.data() + i * nScores;
+		for (auto& e : s)
+			e.second = *scores++;
+	}
 
 	// Run algorithm:
 	return impl_decide(movs, extra_info);
 }
 
-void CMultiObjectiveMotionOptimizerBase::clear() { m_score_exprs.clear(); }
+void CMultiObjectiveMotionOptimizerBase::clear()
+{
+	m_score_exprs.clear();
+	m_movement_assert_exprs.clear();
+	m_expr_vars.clear();
+	m_prop_vars.clear();
+	m_all_vars.clear();
+	m_score_vars.clear();
+	m_score_names.clear();
+	m_score_table.clear();
+}
 CMultiObjectiveMotionOptimizerBase::Ptr
 	CMultiObjectiveMotionOptimizerBase::Factory(
 		const std::string& className) noexcept
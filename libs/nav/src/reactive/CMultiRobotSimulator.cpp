@@ -0,0 +1,285 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "nav-precomp.h"  // Precomp header
+//
+#include <mrpt/core/WorkerThreadsPool.h>
+#include <mrpt/maps/CSimplePointsMap.h>
+#include <mrpt/nav/reactive/CMultiRobotSimulator.h>
+#include <mrpt/nav/reactive/CRobot2NavInterfaceForSimulator.h>
+
+#include <cmath>
+#include <thread>
+#include <unordered_map>
+
+using namespace mrpt::nav;
+
+/** The interface of each robot with its navigator: state and commands go
+ * to its vehicle in the batch, and obstacles come from the scans simulated
+ * at the beginning of each step. */
+class CMultiRobotSimulator::RobotInterface
+	: public CRobot2NavInterfaceForSimulatorBatch
+{
+   public:
+	RobotInterface(CMultiRobotSimulator& sim, size_t index)
+		: CRobot2NavInterfaceForSimulatorBatch(sim.m_vehicles, index),
+		  m_sim(sim)
+	{
+		// Quiet, since there may be hundreds of robots:
+		setMinLoggingLevel(mrpt::system::LVL_ERROR);
+	}
+
+	bool senseObstacles(
+		mrpt::maps::CSimplePointsMap& obstacles,
+		mrpt::system::TTimeStamp& timestamp) override
+	{
+		const size_t i = vehicleIndex();
+		const auto& scan = m_sim.m_scans[i];
+
+		obstacles.clear();
+		timestamp = mrpt::system::now();
+		obstacles.insertionOptions.minDistBetweenLaserPoints = .0;
+		obstacles.loadFromRangeScan(scan);
+
+		// Other robots nearby, at the height of the scanner:
+		const auto z = static_cast<float>(scan.sensorPose.z());
+		for (const auto& p : m_sim.m_robotObstacles[i])
+			obstacles.insertPoint(p.x, p.y, z);
+
+		return true;
+	}
+
+   private:
+	CMultiRobotSimulator& m_sim;
+};
+
+CMultiRobotSimulator::TOptions::TOptions()
+{
+	scan_template.aperture = mrpt::DEG2RAD(270.0);
+	scan_template.maxRange = 20.0;
+	// Height of the lidar (important! it must intersect with the robot
+	// height)
+	scan_template.sensorPose.z(0.4);
+}
+
+CMultiRobotSimulator::CMultiRobotSimulator(
+	const mrpt::maps::COccupancyGridMap2D& map,
+	mrpt::kinematics::CVehicleSimulBatch::Model model)
+	: mrpt::system::COutputLogger("CMultiRobotSimulator"),
+	  m_map(map),
+	  m_vehicles(model)
+{
+}
+
+CMultiRobotSimulator::~CMultiRobotSimulator()
+{
+	// Navigators first, since they use the robot interfaces:
+	m_robots.clear();
+
+	if (m_savedClock) mrpt::Clock::setActiveClock(*m_savedClock);
+}
+
+size_t CMultiRobotSimulator::addRobot(
+	const mrpt::math::TPose2D& initialPose,
+	const navigator_factory_t& navFactory)
+{
+	MRPT_START
+
+	const size_t i = m_robots.size();
+	m_vehicles.resize(i + 1);
+	m_vehicles.setCurrentGTPose(i, initialPose);
+	m_vehicles.setCurrentOdometricPose(i, initialPose);
+
+	m_scans.resize(i + 1);
+	m_robotObstacles.resize(i + 1);
+
+	TRobot r;
+	r.robot_if = std::make_unique<RobotInterface>(*this, i);
+	r.nav = navFactory(*r.robot_if);
+	ASSERTMSG_(r.nav, "The navigator factory returned a null navigator");
+	m_robots.emplace_back(std::move(r));
+
+	return i;
+
+	MRPT_END
+}
+
+void CMultiRobotSimulator::forEachRobot(const std::function<void(size_t)>& fn)
+{
+	if (m_pool) m_pool->parallel_for(0, m_robots.size(), 1, fn);
+	else
+		for (size_t i = 0; i < m_robots.size(); i++)
+			fn(i);
+}
+
+void CMultiRobotSimulator::senseAll()
+{
+	const size_t N = m_robots.size();
+
+	if (options.laser_backend ==
+		mrpt::maps::COccupancyGridMap2D::TLaserSimulBackend::OpenGL)
+	{
+		// All scans at once, in the GPU:
+		std::vector<mrpt::poses::CPose2D> poses(N);
+		for (size_t i = 0; i < N; i++)
+			poses[i] = mrpt::poses::CPose2D(m_vehicles.getCurrentGTPose(i));
+		m_map.laserScanSimulatorBatch(
+			poses, options.scan_template, m_scans,
+			options.occupancy_threshold, options.scan_rays,
+			options.range_noise_std, options.laser_backend);
+		return;
+	}
+
+	// (The random generator for the noise is thread-local)
+	forEachRobot([&](size_t i) {
+		auto& scan = m_scans[i];
+		scan = options.scan_template;
+		m_map.laserScanSimulator(
+			scan, mrpt::poses::CPose2D(m_vehicles.getCurrentGTPose(i)),
+			options.occupancy_threshold, options.scan_rays,
+			options.range_noise_std);
+	});
+}
+
+void CMultiRobotSimulator::updateRobotObstacles()
+{
+	const size_t N = m_robots.size();
+	const double r = options.robot_radius;
+	if (r <= 0)
+	{
+		for (auto& o : m_robotObstacles)
+			o.clear();
+		return;
+	}
+
+	// Bucket the robots in square cells of the size of the sensor range, so
+	// only those in the 3x3 cells around each robot must be checked:
+	const double maxDist = options.scan_template.maxRange + r;
+	const double cellSize = std::max(maxDist, 1e-3);
+	auto cellOf = [cellSize](double x) {
+		return static_cast<int32_t>(std::floor(x / cellSize));
+	};
+	auto cellKey = [](int32_t cx, int32_t cy) {
+		return (static_cast<uint64_t>(static_cast<uint32_t>(cx)) << 32) |
+			static_cast<uint32_t>(cy);
+	};
+	std::unordered_map<uint64_t, std::vector<size_t>> cells;
+	for (size_t i = 0; i < N; i++)
+	{
+		const auto p = m_vehicles.getCurrentGTPose(i);
+		cells[cellKey(cellOf(p.x), cellOf(p.y))].push_back(i);
+	}
+
+	// Points on the perimeter of each robot, spaced like the grid cells:
+	const double perimeter = 2 * M_PI * r;
+	const size_t nPts = std::max<size_t>(
+		8, static_cast<size_t>(std::ceil(perimeter / m_map.getResolution())));
+	std::vector<mrpt::math::TPoint2D> circle(nPts);
+	for (size_t k = 0; k < nPts; k++)
+	{
+		const double a = 2 * M_PI * k / nPts;
+		circle[k] = {r * std::cos(a), r * std::sin(a)};
+	}
+
+	forEachRobot([&](size_t i) {
+		auto& obs = m_robotObstacles[i];
+		obs.clear();
+		const auto pi = m_vehicles.getCurrentGTPose(i);
+		const int32_t cx = cellOf(pi.x), cy = cellOf(pi.y);
+		for (int32_t dx = -1; dx <= 1; dx++)
+			for (int32_t dy = -1; dy <= 1; dy++)
+			{
+				const auto it = cells.find(cellKey(cx + dx, cy + dy));
+				if (it == cells.end()) continue;
+				for (const size_t j : it->second)
+				{
+					if (j == i) continue;
+					const auto pj = m_vehicles.getCurrentGTPose(j);
+					if (mrpt::square(pj.x - pi.x) + mrpt::square(pj.y - pi.y) >
+						mrpt::square(maxDist))
+						continue;
+					// Perimeter of robot j, in the local frame of robot i:
+					for (const auto& c : circle)
+					{
+						const auto l = pi.inverseComposePoint(
+							{pj.x + c.x, pj.y + c.y});
+						obs.emplace_back(
+							static_cast<float>(l.x), static_cast<float>(l.y));
+					}
+				}
+			}
+	});
+}
+
+void CMultiRobotSimulator::step()
+{
+	MRPT_START
+
+	if (options.use_simulated_clock && !m_savedClock)
+	{
+		m_savedClock = mrpt::Clock::getActiveClock();
+		mrpt::Clock::setSimulatedTime(mrpt::Clock::now());
+		mrpt::Clock::setActiveClock(mrpt::Clock::Simulated);
+	}
+
+	// (Re)create the pool if the number of threads changed. The calling
+	// thread also runs tasks in parallel_for():
+	size_t nThreads = options.num_threads;
+	if (!nThreads) nThreads = std::max(1U, std::thread::hardware_concurrency());
+	if (nThreads <= 1) m_pool.reset();
+	else if (!m_pool || m_pool->size() != nThreads - 1)
+		m_pool = std::make_unique<mrpt::WorkerThreadsPool>(
+			nThreads - 1, mrpt::WorkerThreadsPool::POLICY_FIFO, "multi_robot");
+
+	{
+		mrpt::system::CTimeLoggerEntry tle(m_timlog, "step.sense");
+		senseAll();
+		updateRobotObstacles();
+	}
+	{
+		mrpt::system::CTimeLoggerEntry tle(m_timlog, "step.navigate");
+		forEachRobot([this](size_t i) { m_robots[i].nav->navigationStep(); });
+	}
+	const double t0 = getTime();
+	{
+		mrpt::system::CTimeLoggerEntry tle(m_timlog, "step.kinematics");
+		if (m_pool) m_vehicles.simulateOneTimeStep(options.time_step, *m_pool);
+		else
+			m_vehicles.simulateOneTimeStep(options.time_step, 1);
+	}
+
+	// Advance the clock as much as the vehicles (which may be slightly more
+	// than time_step, see CVehicleSimulVirtualBase::simulateOneTimeStep()):
+	if (m_savedClock)
+		mrpt::Clock::setSimulatedTime(
+			mrpt::Clock::now() +
+			std::chrono::duration_cast<mrpt::Clock::duration>(
+				std::chrono::duration<double>(getTime() - t0)));
+
+	MRPT_END
+}
+
+bool CMultiRobotSimulator::runUntilIdle(double maxSimulTime)
+{
+	const double tEnd = getTime() + maxSimulTime;
+	while (getTime() < tEnd)
+	{
+		step();
+
+		bool anyNavigating = false;
+		for (const auto& r : m_robots)
+			if (r.nav->getCurrentState() == CAbstractNavigator::NAVIGATING)
+			{
+				anyNavigating = true;
+				break;
+			}
+		if (!anyNavigating) return true;
+	}
+	return false;
+}
@@ -0,0 +1,86 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/config/CConfigFile.h>
+#include <mrpt/maps/COccupancyGridMap2D.h>
+#include <mrpt/nav/reactive/CMultiRobotSimulator.h>
+#include <mrpt/nav/reactive/CReactiveNavigationSystem.h>
+#include <mrpt/system/filesystem.h>
+
+using mrpt::math::TPoint2D;
+using mrpt::math::TPose2D;
+using namespace mrpt::nav;
+
+TEST(CMultiRobotSimulator, robotsReachTheirTargets)
+{
+	const std::string sFil = mrpt::system::find_mrpt_shared_dir() +
+		std::string("config_files/navigation-ptgs/reactive2d_config.ini");
+	if (!mrpt::system::fileExists(sFil))
+	{
+		std::cerr << "**WARNING* Skipping tests since file cannot be found: '"
+				  << sFil << "'\n";
+		return;
+	}
+	mrpt::config::CConfigFile cfg(sFil);
+	cfg.write("CAbstractPTGBasedReactive", "holonomic_method", "CHolonomicND");
+	cfg.discardSavingChanges();
+
+	mrpt::maps::COccupancyGridMap2D grid;
+	grid.setSize(-10, 10, -10, 10, 0.10f /*resolution*/);
+	grid.fill(0.9f);
+
+	const auto savedClockSrc = mrpt::Clock::getActiveClock();
+	{
+		CMultiRobotSimulator sim(grid);
+		sim.options.time_step = 0.2;
+		sim.options.num_threads = 2;
+		sim.options.robot_radius = 0.3;
+
+		// Robots in a row, each one going 3 m ahead:
+		const size_t N = 4;
+		std::vector<TPoint2D> targets;
+		for (size_t i = 0; i < N; i++)
+		{
+			const double y = -4.5 + 3.0 * i;
+			sim.addRobot(
+				TPose2D(-3.0, y, 0), [&](CRobot2NavInterface& robot) {
+					auto nav = std::make_unique<CReactiveNavigationSystem>(
+						robot, false /*no console output*/);
+					nav->setMinLoggingLevel(mrpt::system::LVL_ERROR);
+					nav->loadConfigFile(cfg);
+					nav->initialize();
+					return nav;
+				});
+			targets.emplace_back(0.0, y);
+
+			CAbstractNavigator::TNavigationParams np;
+			np.target.target_coords = TPose2D(targets.back());
+			np.target.targetAllowedDistance = 0.35f;
+			sim.navigator(i).navigate(&np);
+		}
+		EXPECT_EQ(sim.size(), N);
+
+		EXPECT_TRUE(sim.runUntilIdle(40.0));
+		EXPECT_GT(sim.getTime(), 0.0);
+
+		for (size_t i = 0; i < N; i++)
+		{
+			EXPECT_EQ(
+				sim.navigator(i).getCurrentState(), CAbstractNavigator::IDLE);
+			EXPECT_LT(
+				(TPoint2D(sim.vehicles().getCurrentGTPose(i)) - targets[i])
+					.norm(),
+				0.4);
+			EXPECT_FALSE(sim.lastScan(i).getScanSize() == 0);
+		}
+	}
+	// The clock source is restored:
+	EXPECT_EQ(mrpt::Clock::getActiveClock(), savedClockSrc);
+}
@@ -236,6 +236,11 @@ void CReactiveNavigationSystem::STEP3_WSpaceToTPSpace(
 	const float *xs, *ys, *zs;
 	m_WS_Obstacles.getPointsBuffer(nObs, xs, ys, zs);
 
+	// Local buffers, since PTGs may be evaluated in parallel:
+	std::vector<double> obs_xs, obs_ys;
+	obs_xs.reserve(nObs);
+	obs_ys.reserve(nObs);
+
 	for (size_t obs = 0; obs < nObs; obs++)
 	{
 		double ox, oy, oz = zs[obs];
@@ -245,10 +250,12 @@ void CReactiveNavigationSystem::STEP3_WSpaceToTPSpace(
 			oy < OBS_MAX_XY && oz >= params_reactive_nav.min_obstacles_height &&
 			oz <= params_reactive_nav.max_obstacles_height)
 		{
-			ptg->updateTPObstacle(ox, oy, out_TPObstacles);
+			obs_xs.push_back(ox);
+			obs_ys.push_back(oy);
 			if (eval_clearance) { ptg->updateClearance(ox, oy, out_clearance); }
 		}
 	}
+	ptg->updateTPObstacleBatch(obs_xs, obs_ys, out_TPObstacles);
 }
 
 /** Generates a pointcloud of obstacles, and the robot shape, to be saved in the
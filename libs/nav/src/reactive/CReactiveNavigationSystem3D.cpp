@@ -9,9 +9,15 @@
 
 #include "nav-precomp.h"  // Precomp header
 //
+#include <mrpt/core/WorkerThreadsPool.h>
+#include <mrpt/core/bits_math.h>
 #include <mrpt/nav/reactive/CReactiveNavigationSystem3D.h>
 #include <mrpt/poses/CPose3D.h>
 
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
 using namespace mrpt;
 using namespace mrpt::poses;
 using namespace mrpt::math;
@@ -67,6 +73,18 @@ void CReactiveNavigationSystem3D::saveConfigFile(
 
 	unsigned int PTG_COUNT = m_ptgmultilevel.size();
 	MRPT_SAVE_CONFIG_VAR_COMMENT(PTG_COUNT, "Number of PTGs");
+
+	const double obstacles_voxel_size =
+		params_reactive_nav_3d.obstacles_voxel_size;
+	MRPT_SAVE_CONFIG_VAR_COMMENT(
+		obstacles_voxel_size,
+		"Size [m] of XY cells to downsample obstacles, one point per cell "
+		"and height level (0: disabled)");
+	const unsigned int level_eval_num_threads =
+		params_reactive_nav_3d.level_eval_num_threads;
+	MRPT_SAVE_CONFIG_VAR_COMMENT(
+		level_eval_num_threads,
+		"Threads evaluating the height levels of each PTG (0: all cores)");
 }
 
 void CReactiveNavigationSystem3D::loadConfigFile(
@@ -124,6 +142,13 @@ void CReactiveNavigationSystem3D::loadConfigFile(
 		}
 	}
 
+	auto& p3d = params_reactive_nav_3d;
+	p3d.obstacles_voxel_size =
+		c.read_double(s, "obstacles_voxel_size", p3d.obstacles_voxel_size);
+	p3d.level_eval_num_threads =
+		c.read_int(s, "level_eval_num_threads", p3d.level_eval_num_threads);
+	ASSERT_GE_(p3d.obstacles_voxel_size, .0);
+
 	MRPT_LOG_DEBUG_FMT(
 		" Robot height sections = %u\n",
 		static_cast<unsigned int>(m_robotShape.size()));
@@ -194,7 +219,8 @@ bool CReactiveNavigationSystem3D::implementSenseObstacles(
 	// height sections of the robot.
 	//-------------------------------------------------------------------
 
-	m_timelogger.enter("navigationStep.STEP2_LoadAndSortObstacle");
+	CTimeLoggerEntry tleSort(
+		m_timelogger, "navigationStep.STEP2_LoadAndSortObstacle");
 
 	{
 		CTimeLoggerEntry tle(m_timlog_delays, "senseObstacles()");
@@ -203,43 +229,113 @@ bool CReactiveNavigationSystem3D::implementSenseObstacles(
 			return false;
 	}
 
-	// Empty slice maps:
 	const size_t nSlices = m_robotShape.size();
-	m_WS_Obstacles_inlevels.resize(nSlices);
-	for (size_t i = 0; i < nSlices; i++)
-		m_WS_Obstacles_inlevels[i].clear();
+	ASSERT_LT_(nSlices, 255U);
+
+	// Threads for STEP3_WSpaceToTPSpace(), created here since that method
+	// may be called in parallel for several PTGs. The calling thread also
+	// evaluates levels, hence the "-1":
+	size_t nThreads = params_reactive_nav_3d.level_eval_num_threads;
+	if (!nThreads) nThreads = std::max(1U, std::thread::hardware_concurrency());
+	nThreads = std::min(nThreads, nSlices);
+	if (nThreads <= 1) m_levelEvalThreadPool.reset();
+	else if (
+		!m_levelEvalThreadPool ||
+		m_levelEvalThreadPool->size() != nThreads - 1)
+		m_levelEvalThreadPool = std::make_shared<mrpt::WorkerThreadsPool>(
+			nThreads - 1, mrpt::WorkerThreadsPool::POLICY_FIFO, "level_eval");
 
-	// Sort obstacles in "slices":
 	size_t nPts;
 	const float *xs, *ys, *zs;
 	m_WS_Obstacles_unsorted.getPointsBuffer(nPts, xs, ys, zs);
+
+	// Speed-up: If the obstacle is, for sure, out of the collision grid, just
+	// don't account for it, because we don't know its mapping into
+	// TP-Obstacles anyway...
 	const float OBS_MAX_XY = params_abstract_ptg_navigator.ref_distance * 1.1f;
+	const float voxelSize =
+		static_cast<float>(params_reactive_nav_3d.obstacles_voxel_size);
 
-	for (size_t j = 0; j < nPts; j++)
+	// Top height of each slice:
+	auto& hTop = m_levels_top_height;
+	hTop.resize(nSlices);
 	{
-		float h = 0;
+		double h = 0;
 		for (size_t idxH = 0; idxH < nSlices; ++idxH)
-		{
-			if (zs[j] < 0.01) break;  // skip this points
+			hTop[idxH] = static_cast<float>(h += m_robotShape.getHeight(idxH));
+	}
 
-			h += m_robotShape.getHeight(idxH);
-			if (zs[j] < h)
-			{
-				// Speed-up: If the obstacle is, for sure, out of the collision
-				// grid,
-				// just don't account for it, because we don't know its mapping
-				// into TP-Obstacles anyway...
-				if (xs[j] > -OBS_MAX_XY && xs[j] < OBS_MAX_XY &&
-					ys[j] > -OBS_MAX_XY && ys[j] < OBS_MAX_XY)
-					m_WS_Obstacles_inlevels[idxH].insertPoint(
-						xs[j], ys[j], zs[j]);
-
-				break;	// stop searching for height slots.
-			}
+	// Same obstacles than in the last call? Reuse them:
+	TSortedObstaclesKey key;
+	key.timestamp = obstacles_timestamp;
+	key.nPoints = nPts;
+	key.maxXY = OBS_MAX_XY;
+	key.voxelSize = voxelSize;
+	key.heights = hTop;
+	if (obstacles_timestamp != INVALID_TIMESTAMP &&
+		m_WS_Obstacles_inlevels.size() == nSlices &&
+		key == m_WS_Obstacles_inlevels_key)
+		return true;
+	m_WS_Obstacles_inlevels_key = std::move(key);
+
+	// Sort obstacles in "slices": the level of each point is the number of
+	// slice tops below it (nSlices: above the robot). These loops have no
+	// branches, so compilers vectorize them:
+	auto& levels = m_obs_levels;
+	levels.assign(nPts, 0);
+	for (size_t idxH = 0; idxH < nSlices; ++idxH)
+	{
+		const float h = hTop[idxH];
+		for (size_t j = 0; j < nPts; j++)
+			levels[j] += (zs[j] >= h) ? 1 : 0;
+	}
+	const auto discarded = static_cast<uint8_t>(nSlices);
+	for (size_t j = 0; j < nPts; j++)
+	{
+		const bool valid = (zs[j] >= 0.01f) & (xs[j] > -OBS_MAX_XY) &
+			(xs[j] < OBS_MAX_XY) & (ys[j] > -OBS_MAX_XY) & (ys[j] < OBS_MAX_XY);
+		levels[j] = valid ? levels[j] : discarded;
+	}
+
+	// Optional downsampling: keep the first point in each cell:
+	if (voxelSize > 0)
+	{
+		m_obs_voxels.resize(nSlices);
+		for (auto& v : m_obs_voxels)
+			v.clear();
+		const float invSize = 1.0f / voxelSize;
+		for (size_t j = 0; j < nPts; j++)
+		{
+			if (levels[j] >= discarded) continue;
+			const auto cx = static_cast<int32_t>(std::floor(xs[j] * invSize));
+			const auto cy = static_cast<int32_t>(std::floor(ys[j] * invSize));
+			const uint64_t cell = (static_cast<uint64_t>(
+									   static_cast<uint32_t>(cx))
+								   << 32) |
+				static_cast<uint32_t>(cy);
+			if (!m_obs_voxels[levels[j]].insert(cell).second)
+				levels[j] = discarded;
 		}
 	}
 
-	m_timelogger.leave("navigationStep.STEP2_LoadAndSortObstacle");
+	std::vector<size_t> counts(nSlices + 1, 0);
+	for (size_t j = 0; j < nPts; j++)
+		counts[levels[j]]++;
+
+	m_WS_Obstacles_inlevels.resize(nSlices);
+	for (size_t i = 0; i < nSlices; i++)
+		m_WS_Obstacles_inlevels[i].resize(counts[i]);
+
+	std::fill(counts.begin(), counts.end(), 0);
+	for (size_t j = 0; j < nPts; j++)
+	{
+		const auto idxH = levels[j];
+		if (idxH >= discarded) continue;
+		m_WS_Obstacles_inlevels[idxH].setPointFast(
+			counts[idxH]++, xs[j], ys[j], zs[j]);
+	}
+	for (auto& m : m_WS_Obstacles_inlevels)
+		m.mark_as_modified();
 
 	return true;
 }
@@ -260,23 +356,71 @@ void CReactiveNavigationSystem3D::STEP3_WSpaceToTPSpace(
 	const mrpt::poses::CPose2D rel_pose_PTG_origin_wrt_sense(
 		rel_pose_PTG_origin_wrt_sense_);
 
-	for (size_t j = 0; j < m_robotShape.size(); j++)
-	{
+	const size_t nLevels = m_robotShape.size();
+
+	// Evaluates one height level. Buffers are local, since PTGs and levels
+	// may be evaluated in parallel:
+	auto evalLevel = [&](size_t j, std::vector<double>& tpObstacles,
+						 mrpt::nav::ClearanceDiagram& clearance) {
 		size_t nObs;
 		const float *xs, *ys, *zs;
 		m_WS_Obstacles_inlevels[j].getPointsBuffer(nObs, xs, ys, zs);
 
+		std::vector<double> obs_xs(nObs), obs_ys(nObs);
 		for (size_t obs = 0; obs < nObs; obs++)
 		{
-			double ox, oy;
+			double& ox = obs_xs[obs];
+			double& oy = obs_ys[obs];
 			rel_pose_PTG_origin_wrt_sense.composePoint(
 				xs[obs], ys[obs], ox, oy);
-			m_ptgmultilevel[ptg_idx].PTGs[j]->updateTPObstacle(
-				ox, oy, out_TPObstacles);
 			if (eval_clearance)
 			{
 				m_ptgmultilevel[ptg_idx].PTGs[j]->updateClearance(
-					ox, oy, out_clearance);
+					ox, oy, clearance);
+			}
+		}
+		m_ptgmultilevel[ptg_idx].PTGs[j]->updateTPObstacleBatch(
+			obs_xs, obs_ys, tpObstacles);
+	};
+
+	// The thread pool exists only if level_eval_num_threads!=1, see
+	// implementSenseObstacles():
+	if (!m_levelEvalThreadPool || nLevels <= 1)
+	{
+		for (size_t j = 0; j < nLevels; j++)
+			evalLevel(j, out_TPObstacles, out_clearance);
+	}
+	else
+	{
+		// Each level starts from the input TP-Obstacles and clearance, then
+		// all are merged keeping the minimum values, which is exactly the
+		// result of evaluating them sequentially:
+		std::vector<std::vector<double>> levelTPObs(nLevels, out_TPObstacles);
+		std::vector<mrpt::nav::ClearanceDiagram> levelClearance(
+			eval_clearance ? nLevels : 0, out_clearance);
+
+		m_levelEvalThreadPool->parallel_for(0, nLevels, 1, [&](size_t j) {
+			evalLevel(
+				j, levelTPObs[j],
+				eval_clearance ? levelClearance[j] : out_clearance);
+		});
+
+		for (const auto& tpObs : levelTPObs)
+			for (size_t k = 0; k < out_TPObstacles.size(); k++)
+				mrpt::keep_min(out_TPObstacles[k], tpObs[k]);
+
+		for (const auto& cd : levelClearance)
+		{
+			for (size_t k = 0; k < cd.get_decimated_num_paths(); k++)
+			{
+				auto& outPath = out_clearance.get_path_clearance_decimated(k);
+				auto itOut = outPath.begin();
+				for (const auto& e : cd.get_path_clearance_decimated(k))
+				{
+					ASSERT_(itOut != outPath.end() && itOut->first == e.first);
+					mrpt::keep_min(itOut->second, e.second);
+					++itOut;
+				}
 			}
 		}
 	}
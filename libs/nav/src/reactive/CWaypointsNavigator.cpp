@@ -285,44 +285,62 @@ void CWaypointsNavigator::waypoints_navigationStep()
 				int most_advanced_wp = wps.waypoint_index_current_goal;
 				const int most_advanced_wp_at_begin = most_advanced_wp;
 
+				// Collect the candidate waypoints first, up to the first one
+				// we are not allowed to skip, so the reachability of all of
+				// them is evaluated at once:
+				const double max_dist = params_waypoints_navigator
+											.max_distance_to_allow_skip_waypoint;
+				m_skip_candidates_idx.clear();
+				m_skip_candidates_local.clear();
 				for (int idx = wps.waypoint_index_current_goal;
 					 idx < (int)wps.waypoints.size(); idx++)
 				{
 					if (idx < 0) continue;
-					if (wps.waypoints[idx].reached) continue;
+					const auto& wp = wps.waypoints[idx];
+					if (wp.reached) continue;
 
-					// Is it reachable?
 					mrpt::math::TPoint2D wp_local_wrt_robot;
 					robot_pose.inverseComposePoint(
-						wps.waypoints[idx].target, wp_local_wrt_robot);
+						wp.target, wp_local_wrt_robot);
 
-					if (params_waypoints_navigator
-								.max_distance_to_allow_skip_waypoint > 0 &&
-						wp_local_wrt_robot.norm() >
-							params_waypoints_navigator
-								.max_distance_to_allow_skip_waypoint)
-						continue;  // Skip this one, it is too far away
-
-					const bool is_reachable =
-						this->impl_waypoint_is_reachable(wp_local_wrt_robot);
-
-					if (is_reachable)
+					// Skip this one if it is too far away:
+					if (max_dist <= 0 ||
+						wp_local_wrt_robot.sqrNorm() <= max_dist * max_dist)
 					{
-						// Robustness filter: only skip to a future waypoint if
-						// it is seen as "reachable" during
-						// a given number of timesteps:
-						if (++wps.waypoints[idx].counter_seen_reachable >
-							params_waypoints_navigator
-								.min_timesteps_confirm_skip_waypoints)
-						{ most_advanced_wp = idx; }
+						m_skip_candidates_idx.push_back(idx);
+						m_skip_candidates_local.push_back(wp_local_wrt_robot);
 					}
 
 					// Is allowed to skip it?
-					if (!wps.waypoints[idx].allow_skip)
+					if (!wp.allow_skip)
 						break;	// Do not keep trying, since we are now allowed
 					// to skip this one.
 				}
 
+				// Is it reachable?
+				m_skip_candidates_reachable.assign(
+					m_skip_candidates_local.size(), false);
+				if (!m_skip_candidates_local.empty())
+					this->impl_waypoints_are_reachable(
+						m_skip_candidates_local, m_skip_candidates_reachable);
+				ASSERT_EQUAL_(
+					m_skip_candidates_reachable.size(),
+					m_skip_candidates_idx.size());
+
+				for (size_t i = 0; i < m_skip_candidates_idx.size(); i++)
+				{
+					if (!m_skip_candidates_reachable[i]) continue;
+
+					// Robustness filter: only skip to a future waypoint if
+					// it is seen as "reachable" during
+					// a given number of timesteps:
+					const int idx = m_skip_candidates_idx[i];
+					if (++wps.waypoints[idx].counter_seen_reachable >
+						params_waypoints_navigator
+							.min_timesteps_confirm_skip_waypoints)
+					{ most_advanced_wp = idx; }
+				}
+
 				if (most_advanced_wp >= 0)
 				{
 					wps.waypoint_index_current_goal = most_advanced_wp;
@@ -459,6 +477,15 @@ void CWaypointsNavigator::navigationStep()
 }
 
 /** \callergraph */
+void CWaypointsNavigator::impl_waypoints_are_reachable(
+	const std::vector<mrpt::math::TPoint2D>& wps_local_wrt_robot,
+	std::vector<bool>& is_reachable) const
+{
+	is_reachable.resize(wps_local_wrt_robot.size());
+	for (size_t i = 0; i < wps_local_wrt_robot.size(); i++)
+		is_reachable[i] = impl_waypoint_is_reachable(wps_local_wrt_robot[i]);
+}
+
 void CWaypointsNavigator::onStartNewNavigation() {}
 /** \callergraph */
 bool CWaypointsNavigator::isRelativePointReachable(
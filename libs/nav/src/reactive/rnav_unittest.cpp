@@ -9,13 +9,17 @@
 
 #include <gtest/gtest.h>
 #include <mrpt/config/CConfigFile.h>
+#include <mrpt/io/CFileGZInputStream.h>
 #include <mrpt/kinematics/CVehicleSimul_DiffDriven.h>
 #include <mrpt/maps/COccupancyGridMap2D.h>
 #include <mrpt/nav/reactive/CReactiveNavigationSystem.h>
 #include <mrpt/nav/reactive/CReactiveNavigationSystem3D.h>
 #include <mrpt/nav/reactive/CRobot2NavInterfaceForSimulator.h>
+#include <mrpt/serialization/CArchive.h>
 #include <mrpt/system/filesystem.h>
 
+#include <functional>
+
 using mrpt::math::TPoint2D;
 
 template <typename RNAVCLASS>
@@ -24,7 +28,8 @@ void run_rnav_test_impl(
 	const TPoint2D& nav_target, const TPoint2D& world_topleft,
 	const TPoint2D& world_rightbottom,
 	const TPoint2D& block_obstacle_topleft = TPoint2D(0, 0),
-	const TPoint2D& block_obstacle_rightbottom = TPoint2D(0, 0))
+	const TPoint2D& block_obstacle_rightbottom = TPoint2D(0, 0),
+	const std::function<void(mrpt::config::CConfigFileBase&)>& changeCfg = {})
 {
 	using namespace std;
 	using namespace mrpt;
@@ -42,6 +47,7 @@ void run_rnav_test_impl(
 
 	mrpt::config::CConfigFile cfg(sFil);
 	cfg.write("CAbstractPTGBasedReactive", "holonomic_method", sHoloMethod);
+	if (changeCfg) changeCfg(cfg);
 	cfg.discardSavingChanges();
 
 	// Create a grid map with a synthetic test environment with a simple
@@ -134,6 +140,7 @@ void run_rnav_test_impl(
 		// printf("[run_rnav_test] navlog dir: `%s`\n", sTmpDir.c_str());
 		rnav.setLogFileDirectory(sTmpDir);
 		rnav.enableLogFile(true);
+		rnav.enableLogRingBuffer(10, false /*no auto dump*/);
 	}
 
 	// Load options:
@@ -180,6 +187,40 @@ void run_rnav_test_impl(
 		(TPoint2D(robot_simul.getCurrentGTPose()) - nav_target).norm(), 0.4);
 	EXPECT_TRUE(rnav.getCurrentState() == CAbstractNavigator::IDLE);
 
+	// The ring buffer holds the last steps, in the regular log format:
+	{
+		const size_t nRecs = rnav.getLogRingBufferCount();
+		EXPECT_GT(nRecs, 0U);
+		EXPECT_LE(nRecs, 10U);
+
+		const std::string sRingFil = mrpt::system::getTempFileName();
+		EXPECT_EQ(rnav.dumpLogRingBuffer(sRingFil), sRingFil);
+
+		mrpt::io::CFileGZInputStream f(sRingFil);
+		auto arch = mrpt::serialization::archiveFrom(f);
+		size_t nRead = 0;
+		for (;;)
+		{
+			mrpt::nav::CLogFileRecord::Ptr rec;
+			try
+			{
+				rec = arch.ReadObject<mrpt::nav::CLogFileRecord>();
+			}
+			catch (const mrpt::serialization::CExceptionEOF&)
+			{
+				break;
+			}
+			ASSERT_TRUE(rec);
+			ASSERT_FALSE(rec->infoPerPTG.empty());
+			// PTG parameters come in the first record only:
+			EXPECT_EQ(nRead == 0, rec->infoPerPTG[0].ptg != nullptr);
+			nRead++;
+		}
+		EXPECT_EQ(nRead, nRecs);
+		f.close();
+		mrpt::system::deleteFile(sRingFil);
+	}
+
 	// do not show timelog table to console
 	using mrpt::system::CTimeLogger;
 	const_cast<CTimeLogger&>(rnav.getTimeLogger()).clear(true);
@@ -195,14 +236,15 @@ void run_rnav_test(
 	const TPoint2D& nav_target, const TPoint2D& world_topleft,
 	const TPoint2D& world_rightbottom,
 	const TPoint2D& block_obstacle_topleft = TPoint2D(0, 0),
-	const TPoint2D& block_obstacle_rightbottom = TPoint2D(0, 0))
+	const TPoint2D& block_obstacle_rightbottom = TPoint2D(0, 0),
+	const std::function<void(mrpt::config::CConfigFileBase&)>& changeCfg = {})
 {
 	try
 	{
 		run_rnav_test_impl<RNAVCLASS>(
 			sFilename, sHoloMethod, nav_target, world_topleft,
 			world_rightbottom, block_obstacle_topleft,
-			block_obstacle_rightbottom);
+			block_obstacle_rightbottom, changeCfg);
 	}
 	catch (const std::exception& e)
 	{
@@ -290,3 +332,17 @@ TEST(CReactiveNavigationSystem3D, with_obstacle_nav_FullEval)
 		"reactive3d_config.ini", "CHolonomicFullEval", with_obs_trg,
 		with_obs_topleft, with_obs_bottomright, obs_tl, obs_br);
 }
+
+// Height levels evaluated in parallel, with downsampled obstacles:
+TEST(CReactiveNavigationSystem3D, with_obstacle_nav_parallel_levels)
+{
+	run_rnav_test<mrpt::nav::CReactiveNavigationSystem3D>(
+		"reactive3d_config.ini", "CHolonomicFullEval", with_obs_trg,
+		with_obs_topleft, with_obs_bottomright, obs_tl, obs_br,
+		[](mrpt::config::CConfigFileBase& c) {
+			const std::string s = "CReactiveNavigationSystem3D";
+			c.write(s, "level_eval_num_threads", 3);
+			c.write(s, "obstacles_voxel_size", 0.05);
+			c.write("CAbstractPTGBasedReactive", "evaluate_clearance", true);
+		});
+}
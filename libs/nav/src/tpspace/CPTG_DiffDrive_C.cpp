@@ -13,6 +13,8 @@
 #include <mrpt/nav/tpspace/CPTG_DiffDrive_C.h>
 #include <mrpt/serialization/CArchive.h>
 
+#include "CPTG_DiffDrive_CollisionGridBased_impl.h"
+
 using namespace mrpt;
 using namespace mrpt::nav;
 using namespace mrpt::system;
@@ -65,6 +67,21 @@ std::string CPTG_DiffDrive_C::getDescription() const
 	return mrpt::format("CPTG_DiffDrive_C,K=%i", (int)K);
 }
 
+void CPTG_DiffDrive_C::simulateTrajectories(
+	float max_time, float max_dist, unsigned int max_n, float diferencial_t,
+	float min_dist, float* out_max_acc_v, float* out_max_acc_w)
+{
+	simulateTrajectoriesImpl(
+		[this](
+			float alpha, float t, float x, float y, float phi, float& v,
+			float& w) {
+			CPTG_DiffDrive_C::ptgDiffDriveSteeringFunction(
+				alpha, t, x, y, phi, v, w);
+		},
+		max_time, max_dist, max_n, diferencial_t, min_dist, out_max_acc_v,
+		out_max_acc_w);
+}
+
 void CPTG_DiffDrive_C::ptgDiffDriveSteeringFunction(
 	[[maybe_unused]] float alpha, [[maybe_unused]] float t,
 	[[maybe_unused]] float x, [[maybe_unused]] float y,
@@ -13,6 +13,8 @@
 #include <mrpt/serialization/CArchive.h>
 #include <mrpt/system/os.h>
 
+#include "CPTG_DiffDrive_CollisionGridBased_impl.h"
+
 using namespace mrpt;
 using namespace mrpt::nav;
 using namespace mrpt::system;
@@ -70,6 +72,21 @@ std::string CPTG_DiffDrive_CC::getDescription() const
 	return std::string(str);
 }
 
+void CPTG_DiffDrive_CC::simulateTrajectories(
+	float max_time, float max_dist, unsigned int max_n, float diferencial_t,
+	float min_dist, float* out_max_acc_v, float* out_max_acc_w)
+{
+	simulateTrajectoriesImpl(
+		[this](
+			float alpha, float t, float x, float y, float phi, float& v,
+			float& w) {
+			CPTG_DiffDrive_CC::ptgDiffDriveSteeringFunction(
+				alpha, t, x, y, phi, v, w);
+		},
+		max_time, max_dist, max_n, diferencial_t, min_dist, out_max_acc_v,
+		out_max_acc_w);
+}
+
 void CPTG_DiffDrive_CC::ptgDiffDriveSteeringFunction(
 	[[maybe_unused]] float alpha, [[maybe_unused]] float t,
 	[[maybe_unused]] float x, [[maybe_unused]] float y,
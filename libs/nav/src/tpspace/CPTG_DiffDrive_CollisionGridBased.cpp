@@ -9,16 +9,38 @@
 
 #include "nav-precomp.h"  // Precomp header
 //
+#include <mrpt/core/WorkerThreadsPool.h>
+#include <mrpt/core/lock_helper.h>
 #include <mrpt/io/CFileGZInputStream.h>
 #include <mrpt/io/CFileGZOutputStream.h>
+#include <mrpt/io/CFileInputStream.h>
+#include <mrpt/io/CFileOutputStream.h>
 #include <mrpt/kinematics/CVehicleVelCmd_DiffDriven.h>
 #include <mrpt/math/geometry.h>
 #include <mrpt/nav/tpspace/CPTG_DiffDrive_CollisionGridBased.h>
 #include <mrpt/serialization/CArchive.h>
 #include <mrpt/serialization/stl_serialization.h>
 #include <mrpt/system/CTicTac.h>
+#include <mrpt/system/filesystem.h>
 
+#include <algorithm>
+#include <atomic>
+#include <future>
 #include <iostream>
+#include <limits>
+#include <mutex>
+#include <thread>
+
+#include "CPTG_DiffDrive_CollisionGridBased_impl.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#elif !MRPT_IN_EMSCRIPTEN
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#define COLGRID_HAS_MMAP
+#endif
 
 using namespace mrpt::nav;
 
@@ -55,6 +77,10 @@ void CPTG_DiffDrive_CollisionGridBased::loadFromConfigFile(
 	MRPT_LOAD_HERE_CONFIG_VAR_DEGREES_NO_DEFAULT(
 		w_max_dps, double, W_MAX, cfg, sSection);
 	MRPT_LOAD_CONFIG_VAR(turningRadiusReference, double, cfg, sSection);
+	MRPT_LOAD_HERE_CONFIG_VAR(
+		colgrid_mapped_cache, bool, m_colGridMappedCache, cfg, sSection);
+	MRPT_LOAD_HERE_CONFIG_VAR(
+		colgrid_num_threads, int, m_colGridNumThreads, cfg, sSection);
 }
 void CPTG_DiffDrive_CollisionGridBased::saveToConfigFile(
 	mrpt::config::CConfigFileBase& cfg, const std::string& sSection) const
@@ -77,6 +103,12 @@ void CPTG_DiffDrive_CollisionGridBased::saveToConfigFile(
 		sSection, "turningRadiusReference", turningRadiusReference, WN, WV,
 		"An approximate dimension of the robot (not a critical parameter) "
 		"[m].");
+	cfg.write(
+		sSection, "colgrid_mapped_cache", m_colGridMappedCache, WN, WV,
+		"Use a flat, memory-mapped file to cache the collision grid.");
+	cfg.write(
+		sSection, "colgrid_num_threads", m_colGridNumThreads, WN, WV,
+		"Threads to build the collision grid (0=all hardware threads).");
 
 	CPTG_RobotShape_Polygonal::saveToConfigFile(cfg, sSection);
 
@@ -96,172 +128,32 @@ mrpt::serialization::CArchive& mrpt::nav::operator>>(
 	return i;
 }
 
-/*---------------------------------------------------------------
-					simulateTrajectories
-	Solve trajectories and fill cells.
-  ---------------------------------------------------------------*/
 void CPTG_DiffDrive_CollisionGridBased::simulateTrajectories(
 	float max_time, float max_dist, unsigned int max_n, float diferencial_t,
 	float min_dist, float* out_max_acc_v, float* out_max_acc_w)
 {
-	using mrpt::square;
-
-	internal_deinitialize();  // Free previous paths
-
-	m_stepTimeDuration = diferencial_t;
-
-	// Reserve the size in the buffers:
-	m_trajectory.resize(m_alphaValuesCount);
-
-	const float radio_max_robot = 1.0f;	 // Arbitrary "robot radius", only to
-	// determine the spacing of points
-	// under pure rotation
-
-	// Aux buffer:
-	TCPointVector points;
-
-	float ult_dist, ult_dist1, ult_dist2;
-
-	// For the grid:
-	float x_min = 1e3f, x_max = -1e3;
-	float y_min = 1e3f, y_max = -1e3;
-
-	// Para averiguar las maximas ACELERACIONES lineales y angulares:
-	float max_acc_lin, max_acc_ang;
-
-	max_acc_lin = max_acc_ang = 0;
-
-	try
-	{
-		for (unsigned int k = 0; k < m_alphaValuesCount; k++)
-		{
-			// Simulate / evaluate the trajectory selected by this "alpha":
-			// ------------------------------------------------------------
-			const float alpha = index2alpha(k);
-
-			points.clear();
-			float t = .0f, dist = .0f, girado = .0f;
-			float x = .0f, y = .0f, phi = .0f, v = .0f, w = .0f, _x = .0f,
-				  _y = .0f, _phi = .0f;
-
-			// Sliding window with latest movement commands (for the optional
-			// low-pass filtering):
-			float last_vs[2] = {.0f, .0f}, last_ws[2] = {.0f, .0f};
-
-			// Add the first, initial point:
-			points.push_back(TCPoint(x, y, phi, t, dist, v, w));
-
-			// Simulate until...
-			while (t < max_time && dist < max_dist && points.size() < max_n &&
-				   fabs(girado) < 1.95 * M_PI)
-			{
-				// Max. aceleraciones:
-				if (t > 1)
-				{
-					float acc_lin =
-						fabs((last_vs[0] - last_vs[1]) / diferencial_t);
-					float acc_ang =
-						fabs((last_ws[0] - last_ws[1]) / diferencial_t);
-					mrpt::keep_max(max_acc_lin, acc_lin);
-					mrpt::keep_max(max_acc_ang, acc_ang);
-				}
-
-				// Compute new movement command (v,w):
-				ptgDiffDriveSteeringFunction(alpha, t, x, y, phi, v, w);
-
-				// History of v/w ----------------------------------
-				last_vs[1] = last_vs[0];
-				last_ws[1] = last_ws[0];
-				last_vs[0] = v;
-				last_ws[0] = w;
-				// -------------------------------------------
-
-				// Finite difference equation:
-				x += cos(phi) * v * diferencial_t;
-				y += sin(phi) * v * diferencial_t;
-				phi += w * diferencial_t;
-
-				// Counters:
-				girado += w * diferencial_t;
-
-				float v_inTPSpace =
-					sqrt(square(v) + square(w * turningRadiusReference));
-
-				dist += v_inTPSpace * diferencial_t;
-
-				t += diferencial_t;
-
-				// Save sample if we moved far enough:
-				ult_dist1 = sqrt(square(_x - x) + square(_y - y));
-				ult_dist2 = fabs(radio_max_robot * (_phi - phi));
-				ult_dist = std::max(ult_dist1, ult_dist2);
-
-				if (ult_dist > min_dist)
-				{
-					// Set the (v,w) to the last record:
-					points.back().v = v;
-					points.back().w = w;
-
-					// And add the new record:
-					points.push_back(TCPoint(x, y, phi, t, dist, v, w));
-
-					// For the next iter:
-					_x = x;
-					_y = y;
-					_phi = phi;
-				}
-
-				// for the grid:
-				x_min = std::min(x_min, x);
-				x_max = std::max(x_max, x);
-				y_min = std::min(y_min, y);
-				y_max = std::max(y_max, y);
-			}
-
-			// Add the final point:
-			points.back().v = v;
-			points.back().w = w;
-			points.push_back(TCPoint(x, y, phi, t, dist, v, w));
-
-			// Save data to C-Space path structure:
-			m_trajectory[k] = points;
-
-		}  // end for "k"
-
-		// Save accelerations
-		if (out_max_acc_v) *out_max_acc_v = max_acc_lin;
-		if (out_max_acc_w) *out_max_acc_w = max_acc_ang;
-
-		// --------------------------------------------------------
-		// Build the speeding-up grid for lambda function:
-		// --------------------------------------------------------
-		const TCellForLambdaFunction defaultCell;
-		m_lambdaFunctionOptimizer.setSize(
-			x_min - 0.5f, x_max + 0.5f, y_min - 0.5f, y_max + 0.5f, 0.25f,
-			&defaultCell);
+	simulateTrajectoriesImpl(
+		[this](
+			float alpha, float t, float x, float y, float phi, float& v,
+			float& w) {
+			ptgDiffDriveSteeringFunction(alpha, t, x, y, phi, v, w);
+		},
+		max_time, max_dist, max_n, diferencial_t, min_dist, out_max_acc_v,
+		out_max_acc_w);
+}
 
-		for (uint16_t k = 0; k < m_alphaValuesCount; k++)
-		{
-			const auto M = static_cast<uint32_t>(m_trajectory[k].size());
-			for (uint32_t n = 0; n < M; n++)
-			{
-				TCellForLambdaFunction* cell =
-					m_lambdaFunctionOptimizer.cellByPos(
-						m_trajectory[k][n].x, m_trajectory[k][n].y);
-				ASSERT_(cell);
-				// Keep limits:
-				mrpt::keep_min(cell->k_min, k);
-				mrpt::keep_max(cell->k_max, k);
-				mrpt::keep_min(cell->n_min, n);
-				mrpt::keep_max(cell->n_max, n);
-			}
-		}
-	}
-	catch (...)
+void CPTG_DiffDrive_CollisionGridBased::buildPathTable()
+{
+	m_pathTable.clear();
+	m_pathTableStart.assign(1, 0);
+	size_t nSteps = 0;
+	for (const auto& traj : m_trajectory)
+		nSteps += traj.size();
+	m_pathTable.reserve(nSteps);
+	for (const auto& traj : m_trajectory)
 	{
-		std::cout
-			<< "[CPTG_DiffDrive_CollisionGridBased::simulateTrajectories] "
-			   "Simulation aborted: unexpected exception!\n";
+		m_pathTable.insert(m_pathTable.end(), traj.begin(), traj.end());
+		m_pathTableStart.push_back(static_cast<uint32_t>(m_pathTable.size()));
 	}
 }
 
@@ -533,6 +425,331 @@ bool CPTG_DiffDrive_CollisionGridBased::CCollisionGrid::loadFromFile(
 	}
 }
 
+// ---------------------------------------------------------------------------
+//  Flat, memory-mapped collision grid cache files
+// ---------------------------------------------------------------------------
+namespace
+{
+// File layout (native endianness, detected via the magic number):
+//  - TFlatColGridHeader
+//  - uint32_t offsets[size_x*size_y+1]: first entry of each cell
+//  - Padding up to a multiple of 8 bytes
+//  - TFlatColGridEntry entries[numEntries]
+const uint64_t FLAT_COLGRID_MAGIC = 0x3144495247434C43;	 // "CLCGRID1"
+const uint32_t FLAT_COLGRID_VERSION = 1;
+
+struct TFlatColGridHeader
+{
+	uint64_t magic;
+	uint32_t version, headerSize;
+	uint64_t key;
+	double x_min, y_min, resolution;
+	uint32_t size_x, size_y;
+	uint64_t numEntries;
+};
+struct TFlatColGridEntry
+{
+	uint16_t k, unused;
+	float dist;
+};
+
+size_t flatEntriesOffset(size_t nCells)
+{
+	return (sizeof(TFlatColGridHeader) + (nCells + 1) * sizeof(uint32_t) +
+			7) &
+		~size_t(7);
+}
+
+// 64-bit FNV-1a hash:
+const uint64_t FNV_OFFSET_BASIS = 0xcbf29ce484222325ULL;
+uint64_t fnv1a(uint64_t h, const void* data, size_t len)
+{
+	const auto* p = static_cast<const uint8_t*>(data);
+	for (size_t i = 0; i < len; i++)
+	{
+		h ^= p[i];
+		h *= 0x100000001b3ULL;
+	}
+	return h;
+}
+
+uint32_t currentProcessId()
+{
+#if defined(_WIN32)
+	return static_cast<uint32_t>(GetCurrentProcessId());
+#elif defined(COLGRID_HAS_MMAP)
+	return static_cast<uint32_t>(::getpid());
+#else
+	return 0;
+#endif
+}
+}  // namespace
+
+struct CPTG_DiffDrive_CollisionGridBased::TMappedColGrid
+{
+	TMappedColGrid() = default;
+	TMappedColGrid(const TMappedColGrid&) = delete;
+	TMappedColGrid& operator=(const TMappedColGrid&) = delete;
+	~TMappedColGrid() { close(); }
+
+	const TFlatColGridHeader* hdr = nullptr;
+	const uint32_t* offsets = nullptr;
+	const TFlatColGridEntry* entries = nullptr;
+
+	size_t cellCount() const
+	{
+		return static_cast<size_t>(hdr->size_x) * hdr->size_y;
+	}
+
+	/** Linear index of the cell at (x,y), or -1 if out of the grid */
+	int cellIndex(double x, double y) const
+	{
+		const int cx = static_cast<int>((x - hdr->x_min) / hdr->resolution);
+		const int cy = static_cast<int>((y - hdr->y_min) / hdr->resolution);
+		if (cx < 0 || cx >= static_cast<int>(hdr->size_x) || cy < 0 ||
+			cy >= static_cast<int>(hdr->size_y))
+			return -1;
+		return cx + cy * static_cast<int>(hdr->size_x);
+	}
+
+	/** Calls f(k,dist) for each entry of the cell with linear index `idx` */
+	template <class FUNCTOR>
+	void forEachInCellIndex(size_t idx, FUNCTOR f) const
+	{
+		for (uint32_t i = offsets[idx]; i < offsets[idx + 1]; i++)
+			f(entries[i].k, entries[i].dist);
+	}
+
+	/** Calls f(k,dist) for each entry of the cell at (x,y) */
+	template <class FUNCTOR>
+	void forEachInCell(double x, double y, FUNCTOR f) const
+	{
+		const int idx = cellIndex(x, y);
+		if (idx >= 0) forEachInCellIndex(idx, f);
+	}
+
+	bool open(const std::string& fileName, uint64_t expectedKey)
+	{
+		close();
+		if (!mrpt::system::fileExists(fileName)) return false;
+		fileSize = mrpt::system::getFileSize(fileName);
+		if (fileSize < sizeof(TFlatColGridHeader) ||
+			fileSize > std::numeric_limits<size_t>::max())
+			return false;
+
+#if defined(_WIN32)
+		hFile = CreateFileA(
+			fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+			OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (hFile != INVALID_HANDLE_VALUE)
+		{
+			hMap =
+				CreateFileMappingA(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (hMap)
+				mapped = static_cast<const uint8_t*>(
+					MapViewOfFile(hMap, FILE_MAP_READ, 0, 0, 0));
+		}
+#elif defined(COLGRID_HAS_MMAP)
+		fd = ::open(fileName.c_str(), O_RDONLY);
+		if (fd >= 0)
+		{
+			void* p = ::mmap(
+				nullptr, static_cast<size_t>(fileSize), PROT_READ, MAP_SHARED,
+				fd, 0);
+			if (p != MAP_FAILED) mapped = static_cast<const uint8_t*>(p);
+		}
+#endif
+		const uint8_t* data = mapped;
+		if (!data)
+		{
+			// Fallback: read the whole file into (8-byte aligned) memory:
+			mrpt::io::CFileInputStream f;
+			if (!f.open(fileName)) return false;
+			buf.resize((fileSize + 7) / 8);
+			if (f.Read(buf.data(), fileSize) != fileSize)
+			{
+				close();
+				return false;
+			}
+			data = reinterpret_cast<const uint8_t*>(buf.data());
+		}
+
+		// Validate contents, so a corrupted file is never used:
+		hdr = reinterpret_cast<const TFlatColGridHeader*>(data);
+		const size_t nCells = static_cast<size_t>(hdr->size_x) * hdr->size_y;
+		const size_t entriesOff = flatEntriesOffset(nCells);
+		if (hdr->magic != FLAT_COLGRID_MAGIC ||
+			hdr->version != FLAT_COLGRID_VERSION ||
+			hdr->headerSize != sizeof(TFlatColGridHeader) ||
+			hdr->key != expectedKey ||
+			fileSize !=
+				entriesOff + hdr->numEntries * sizeof(TFlatColGridEntry))
+		{
+			close();
+			return false;
+		}
+		offsets = reinterpret_cast<const uint32_t*>(data + sizeof(*hdr));
+		entries = reinterpret_cast<const TFlatColGridEntry*>(data + entriesOff);
+		bool ok = offsets[0] == 0 && offsets[nCells] == hdr->numEntries;
+		for (size_t i = 0; ok && i < nCells; i++)
+			ok = offsets[i] <= offsets[i + 1];
+		if (!ok) close();
+		return ok;
+	}
+
+   private:
+	uint64_t fileSize = 0;
+	const uint8_t* mapped = nullptr;
+#if defined(_WIN32)
+	HANDLE hFile = INVALID_HANDLE_VALUE, hMap = nullptr;
+#elif defined(COLGRID_HAS_MMAP)
+	int fd = -1;
+#endif
+	// Fallback if memory mapping is not available:
+	std::vector<uint64_t> buf;
+
+	void close()
+	{
+#if defined(_WIN32)
+		if (mapped) UnmapViewOfFile(mapped);
+		if (hMap) CloseHandle(hMap);
+		if (hFile != INVALID_HANDLE_VALUE) CloseHandle(hFile);
+		hMap = nullptr;
+		hFile = INVALID_HANDLE_VALUE;
+#elif defined(COLGRID_HAS_MMAP)
+		if (mapped)
+			::munmap(
+				const_cast<uint8_t*>(mapped), static_cast<size_t>(fileSize));
+		if (fd >= 0) ::close(fd);
+		fd = -1;
+#endif
+		mapped = nullptr;
+		buf.clear();
+		hdr = nullptr;
+		offsets = nullptr;
+		entries = nullptr;
+	}
+};
+
+uint64_t CPTG_DiffDrive_CollisionGridBased::collisionGridKey() const
+{
+	uint64_t h = FNV_OFFSET_BASIS;
+	auto add = [&h](const auto& v) { h = fnv1a(h, &v, sizeof(v)); };
+
+	add(FLAT_COLGRID_VERSION);
+	const std::string desc = getDescription();
+	h = fnv1a(h, desc.data(), desc.size());
+	add(m_alphaValuesCount);
+	add(V_MAX);
+	add(W_MAX);
+	add(refDistance);
+	add(turningRadiusReference);
+
+	// Grid geometry:
+	add(m_collisionGrid.getXMin());
+	add(m_collisionGrid.getYMin());
+	add(m_collisionGrid.getResolution());
+	add(static_cast<uint32_t>(m_collisionGrid.getSizeX()));
+	add(static_cast<uint32_t>(m_collisionGrid.getSizeY()));
+
+	// Robot shape:
+	for (size_t i = 0; i < m_robotShape.size(); i++)
+	{
+		add(m_robotShape.GetVertex_x(i));
+		add(m_robotShape.GetVertex_y(i));
+	}
+
+	// Trajectories, which reflect all the PTG-specific parameters:
+	for (const auto& traj : m_trajectory)
+		for (const auto& p : traj)
+		{
+			const float v[7] = {p.x, p.y, p.phi, p.t, p.dist, p.v, p.w};
+			add(v);
+		}
+
+	return h;
+}
+
+std::string CPTG_DiffDrive_CollisionGridBased::mappedColGridFileName(
+	const std::string& cacheFilename) const
+{
+	return mrpt::system::extractFileDirectory(cacheFilename) +
+		mrpt::system::extractFileName(cacheFilename) +
+		mrpt::format(
+			   "_%016llx.colgrid",
+			   static_cast<unsigned long long>(collisionGridKey()));
+}
+
+bool CPTG_DiffDrive_CollisionGridBased::saveMappedColGrid(
+	const std::string& filename) const
+{
+	try
+	{
+		const size_t sx = m_collisionGrid.getSizeX(),
+					 sy = m_collisionGrid.getSizeY(), nCells = sx * sy;
+
+		std::vector<uint32_t> offsets(nCells + 1, 0);
+		std::vector<TFlatColGridEntry> entries;
+		for (size_t i = 0; i < nCells; i++)
+		{
+			const TCollisionCell* cell =
+				m_collisionGrid.cellByIndex(i % sx, i / sx);
+			ASSERT_(cell);
+			for (const auto& e : *cell)
+				entries.push_back({e.first, 0, e.second});
+			ASSERT_LE_(entries.size(), std::numeric_limits<uint32_t>::max());
+			offsets[i + 1] = static_cast<uint32_t>(entries.size());
+		}
+
+		TFlatColGridHeader hdr;
+		hdr.magic = FLAT_COLGRID_MAGIC;
+		hdr.version = FLAT_COLGRID_VERSION;
+		hdr.headerSize = sizeof(hdr);
+		hdr.key = collisionGridKey();
+		hdr.x_min = m_collisionGrid.getXMin();
+		hdr.y_min = m_collisionGrid.getYMin();
+		hdr.resolution = m_collisionGrid.getResolution();
+		hdr.size_x = static_cast<uint32_t>(sx);
+		hdr.size_y = static_cast<uint32_t>(sy);
+		hdr.numEntries = entries.size();
+
+		// Write to a temporary file first and rename it at the end, so other
+		// processes never see a partial file:
+		const std::string tmpFile =
+			filename + mrpt::format(".tmp%u", currentProcessId());
+		{
+			mrpt::io::CFileOutputStream fo;
+			if (!fo.open(tmpFile)) return false;
+			const uint64_t zeros = 0;
+			const size_t padding = flatEntriesOffset(nCells) - sizeof(hdr) -
+				offsets.size() * sizeof(uint32_t);
+			fo.Write(&hdr, sizeof(hdr));
+			fo.Write(offsets.data(), offsets.size() * sizeof(uint32_t));
+			fo.Write(&zeros, padding);
+			fo.Write(entries.data(), entries.size() * sizeof(entries[0]));
+		}
+		if (!mrpt::system::renameFile(tmpFile, filename))
+		{
+			mrpt::system::deleteFile(tmpFile);
+			return false;
+		}
+		return true;
+	}
+	catch (...)
+	{
+		return false;
+	}
+}
+
+bool CPTG_DiffDrive_CollisionGridBased::loadMappedColGrid(
+	const std::string& filename)
+{
+	auto g = std::make_shared<TMappedColGrid>();
+	if (!g->open(filename, collisionGridKey())) return false;
+	m_mappedColGrid = std::move(g);
+	return true;
+}
+
 bool CPTG_DiffDrive_CollisionGridBased::inverseMap_WS2TP(
 	double x, double y, int& out_k, double& out_d, double tolerance_dist) const
 {
@@ -593,22 +810,23 @@ bool CPTG_DiffDrive_CollisionGridBased::inverseMap_WS2TP(
 
 	if (at_least_one)  // Otherwise, don't even lose time checking...
 	{
-		ASSERT_LT_(k_max, m_trajectory.size());
+		ASSERT_LT_(k_max + 1U, m_pathTableStart.size());
 		for (int k = k_min; k <= k_max; k++)
 		{
-			const size_t n_real = m_trajectory[k].size();
+			const uint32_t n_real = pathTableStepCount(k);
 			const uint32_t n_max_this =
-				std::min(static_cast<uint32_t>(n_real ? n_real - 1 : 0), n_max);
+				std::min(n_real ? n_real - 1 : 0, n_max);
+			const TCPoint* steps = &m_pathTable[m_pathTableStart[k]];
 
 			for (uint32_t n = n_min; n <= n_max_this; n++)
 			{
-				const float dist_a_punto = square(m_trajectory[k][n].x - x) +
-					square(m_trajectory[k][n].y - y);
+				const float dist_a_punto =
+					square(steps[n].x - x) + square(steps[n].y - y);
 				if (dist_a_punto < selected_dist)
 				{
 					selected_dist = dist_a_punto;
 					selected_k = k;
-					selected_d = m_trajectory[k][n].dist;
+					selected_d = steps[n].dist;
 				}
 			}
 		}
@@ -631,9 +849,9 @@ bool CPTG_DiffDrive_CollisionGridBased::inverseMap_WS2TP(
 	selected_dist = std::numeric_limits<float>::max();
 	for (uint16_t k = 0; k < m_alphaValuesCount; k++)
 	{
-		const int n = int(m_trajectory[k].size()) - 1;
-		const float dist_a_punto = square(m_trajectory[k][n].dist) +
-			square(m_trajectory[k][n].x - x) + square(m_trajectory[k][n].y - y);
+		const TCPoint& p = pathTableStep(k, pathTableStepCount(k) - 1);
+		const float dist_a_punto =
+			square(p.dist) + square(p.x - x) + square(p.y - y);
 
 		if (dist_a_punto < selected_dist)
 		{
@@ -675,6 +893,10 @@ void CPTG_DiffDrive_CollisionGridBased::internal_processNewRobotShape()
 void CPTG_DiffDrive_CollisionGridBased::internal_deinitialize()
 {
 	m_trajectory.clear();  // Free trajectories
+	m_pathTable.clear();
+	m_pathTableStart.clear();
+	m_mappedColGrid.reset();
+	m_batchCache = TBatchCache();
 }
 
 void CPTG_DiffDrive_CollisionGridBased::internal_initialize(
@@ -725,8 +947,21 @@ void CPTG_DiffDrive_CollisionGridBased::internal_initialize(
 	const size_t Ki = getAlphaValuesCount();
 	ASSERTMSG_(Ki > 0, "The PTG seems to be not initialized!");
 
+	m_mappedColGrid.reset();
+	const std::string mappedCacheFilename = m_colGridMappedCache
+		? mappedColGridFileName(cacheFilename)
+		: std::string();
+
 	// Load the cached version, if possible
-	if (loadColGridsFromFile(cacheFilename, m_robotShape))
+	if (m_colGridMappedCache && loadMappedColGrid(mappedCacheFilename))
+	{
+		// Free the heap grid, not used anymore:
+		m_collisionGrid.releaseCells();
+		if (verbose) cout << "mapped from file OK" << endl;
+	}
+	else if (
+		!m_colGridMappedCache &&
+		loadColGridsFromFile(cacheFilename, m_robotShape))
 	{
 		if (verbose) cout << "loaded from file OK" << endl;
 	}
@@ -739,137 +974,208 @@ void CPTG_DiffDrive_CollisionGridBased::internal_initialize(
 			-refDistance, refDistance, -refDistance, refDistance,
 			m_collisionGrid.getResolution());
 
-		const int grid_cx_max = m_collisionGrid.getSizeX() - 1;
-		const int grid_cy_max = m_collisionGrid.getSizeY() - 1;
-		const double half_cell = m_collisionGrid.getResolution() * 0.5;
-
-		const size_t nVerts = m_robotShape.verticesCount();
-		std::vector<mrpt::math::TPoint2D> transf_shape(
-			nVerts);  // The robot shape at each location
-
 		// RECOMPUTE THE COLLISION GRIDS:
 		// ---------------------------------------
-		for (size_t k = 0; k < Ki; k++)
+		size_t nThreads = m_colGridNumThreads;
+		if (!nThreads)
+			nThreads = std::max(1U, std::thread::hardware_concurrency());
+		nThreads = std::min(nThreads, Ki);
+
+		// Progress is reported serialized, whatever the calling thread:
+		std::mutex progressMtx;
+		size_t numPathsDone = 0;
+		auto onPathDone = [&]() {
+			auto lck = mrpt::lockHelper(progressMtx);
+			numPathsDone++;
+			if (verbose) cout << numPathsDone << "/" << Ki << ",";
+			if (m_initProgressCallback) m_initProgressCallback(numPathsDone, Ki);
+		};
+
+		if (nThreads <= 1)
 		{
-			const size_t nPoints = getPathStepCount(k);
-			ASSERT_(nPoints > 1);
-			for (size_t n = 0; n < (nPoints - 1); n++)
+			for (size_t k = 0; k < Ki; k++)
 			{
-				// Translate and rotate the robot shape at this C-Space pose:
-				const mrpt::math::TPose2D p = getPathPose(k, n);
-
-				mrpt::math::TPoint2D bb_min(
-					std::numeric_limits<double>::max(),
-					std::numeric_limits<double>::max());
-				mrpt::math::TPoint2D bb_max(
-					-std::numeric_limits<double>::max(),
-					-std::numeric_limits<double>::max());
-
-				for (size_t m = 0; m < nVerts; m++)
+				addPathToCollisionGrid(k, m_collisionGrid);
+				onPathDone();
+			}
+		}
+		else
+		{
+			// Each thread fills its own partial grid with the paths it takes
+			// from a shared counter:
+			std::vector<CCollisionGrid> partialGrids(nThreads, m_collisionGrid);
+			std::atomic<size_t> nextPath{0};
+			mrpt::WorkerThreadsPool pool(
+				nThreads, mrpt::WorkerThreadsPool::POLICY_FIFO, "ptg_colgrid");
+			std::vector<std::future<void>> jobs;
+			for (auto& grid : partialGrids)
+			{
+				jobs.emplace_back(pool.enqueue([&]() {
+					for (size_t k; (k = nextPath++) < Ki;)
+					{
+						addPathToCollisionGrid(k, grid);
+						onPathDone();
+					}
+				}));
+			}
+			for (auto& j : jobs)
+				j.wait();
+			for (auto& j : jobs)
+				j.get();  // Rethrow exceptions, if any
+
+			// Merge them. Each "k" is in one partial grid only, so just sort
+			// the entries as they would be in a sequential build:
+			const size_t sx = m_collisionGrid.getSizeX();
+			const size_t nCells = sx * m_collisionGrid.getSizeY();
+			for (size_t i = 0; i < nCells; i++)
+			{
+				TCollisionCell* cell =
+					m_collisionGrid.cellByIndex(i % sx, i / sx);
+				for (auto& grid : partialGrids)
 				{
-					transf_shape[m].x = p.x +
-						cos(p.phi) * m_robotShape.GetVertex_x(m) -
-						sin(p.phi) * m_robotShape.GetVertex_y(m);
-					transf_shape[m].y = p.y +
-						sin(p.phi) * m_robotShape.GetVertex_x(m) +
-						cos(p.phi) * m_robotShape.GetVertex_y(m);
-					mrpt::keep_max(bb_max.x, transf_shape[m].x);
-					mrpt::keep_max(bb_max.y, transf_shape[m].y);
-					mrpt::keep_min(bb_min.x, transf_shape[m].x);
-					mrpt::keep_min(bb_min.y, transf_shape[m].y);
+					TCollisionCell* src = grid.cellByIndex(i % sx, i / sx);
+					cell->insert(cell->end(), src->begin(), src->end());
+					TCollisionCell().swap(*src);
 				}
-
-				// Robot shape polygon:
-				const mrpt::math::TPolygon2D poly(transf_shape);
-
-				// Get the range of cells that may collide with this shape:
-				const int ix_min =
-					std::max(0, m_collisionGrid.x2idx(bb_min.x) - 1);
-				const int iy_min =
-					std::max(0, m_collisionGrid.y2idx(bb_min.y) - 1);
-				const int ix_max =
-					std::min(m_collisionGrid.x2idx(bb_max.x) + 1, grid_cx_max);
-				const int iy_max =
-					std::min(m_collisionGrid.y2idx(bb_max.y) + 1, grid_cy_max);
-
-				for (int ix = ix_min; ix < ix_max; ix++)
-				{
-					const double cx = m_collisionGrid.idx2x(ix) - half_cell;
-
-					for (int iy = iy_min; iy < iy_max; iy++)
-					{
-						const double cy = m_collisionGrid.idx2y(iy) - half_cell;
-
-						if (poly.contains(mrpt::math::TPoint2D(cx, cy)))
-						{
-							// Collision!! Update cell info:
-							const float d = this->getPathDist(k, n);
-							m_collisionGrid.updateCellInfo(ix, iy, k, d);
-							m_collisionGrid.updateCellInfo(ix - 1, iy, k, d);
-							m_collisionGrid.updateCellInfo(ix, iy - 1, k, d);
-							m_collisionGrid.updateCellInfo(
-								ix - 1, iy - 1, k, d);
-						}
-					}  // for iy
-				}  // for ix
-
-			}  // n
-
-			if (verbose) cout << k << "/" << Ki << ",";
-		}  // k
+				std::sort(cell->begin(), cell->end());
+			}
+		}
 
 		if (verbose) cout << format("Done! [%.03f sec]\n", tictac.Tac());
 
 		// save it to the cache file for the next run:
-		saveColGridsToFile(cacheFilename, m_robotShape);
+		if (!m_colGridMappedCache)
+			saveColGridsToFile(cacheFilename, m_robotShape);
+		else if (
+			saveMappedColGrid(mappedCacheFilename) &&
+			loadMappedColGrid(mappedCacheFilename))
+		{
+			// Use the mapped (shared) copy from now on:
+			m_collisionGrid.releaseCells();
+		}
 
 	}  // "else" recompute all PTG
 
 	MRPT_END
 }
 
+void CPTG_DiffDrive_CollisionGridBased::addPathToCollisionGrid(
+	uint16_t k, CCollisionGrid& grid) const
+{
+	const int grid_cx_max = grid.getSizeX() - 1;
+	const int grid_cy_max = grid.getSizeY() - 1;
+	const double half_cell = grid.getResolution() * 0.5;
+
+	const size_t nVerts = m_robotShape.verticesCount();
+	std::vector<mrpt::math::TPoint2D> transf_shape(
+		nVerts);  // The robot shape at each location
+
+	const size_t nPoints = pathTableStepCount(k);
+	ASSERT_(nPoints > 1);
+	for (size_t n = 0; n < (nPoints - 1); n++)
+	{
+		// Translate and rotate the robot shape at this C-Space pose:
+		const TCPoint& step = pathTableStep(k, n);
+		const mrpt::math::TPose2D p(step.x, step.y, step.phi);
+
+		mrpt::math::TPoint2D bb_min(
+			std::numeric_limits<double>::max(),
+			std::numeric_limits<double>::max());
+		mrpt::math::TPoint2D bb_max(
+			-std::numeric_limits<double>::max(),
+			-std::numeric_limits<double>::max());
+
+		for (size_t m = 0; m < nVerts; m++)
+		{
+			transf_shape[m].x = p.x +
+				cos(p.phi) * m_robotShape.GetVertex_x(m) -
+				sin(p.phi) * m_robotShape.GetVertex_y(m);
+			transf_shape[m].y = p.y +
+				sin(p.phi) * m_robotShape.GetVertex_x(m) +
+				cos(p.phi) * m_robotShape.GetVertex_y(m);
+			mrpt::keep_max(bb_max.x, transf_shape[m].x);
+			mrpt::keep_max(bb_max.y, transf_shape[m].y);
+			mrpt::keep_min(bb_min.x, transf_shape[m].x);
+			mrpt::keep_min(bb_min.y, transf_shape[m].y);
+		}
+
+		// Robot shape polygon:
+		const mrpt::math::TPolygon2D poly(transf_shape);
+
+		// Get the range of cells that may collide with this shape:
+		const int ix_min = std::max(0, grid.x2idx(bb_min.x) - 1);
+		const int iy_min = std::max(0, grid.y2idx(bb_min.y) - 1);
+		const int ix_max = std::min(grid.x2idx(bb_max.x) + 1, grid_cx_max);
+		const int iy_max = std::min(grid.y2idx(bb_max.y) + 1, grid_cy_max);
+
+		for (int ix = ix_min; ix < ix_max; ix++)
+		{
+			const double cx = grid.idx2x(ix) - half_cell;
+
+			for (int iy = iy_min; iy < iy_max; iy++)
+			{
+				const double cy = grid.idx2y(iy) - half_cell;
+
+				if (poly.contains(mrpt::math::TPoint2D(cx, cy)))
+				{
+					// Collision!! Update cell info:
+					const float d = step.dist;
+					grid.updateCellInfo(ix, iy, k, d);
+					grid.updateCellInfo(ix - 1, iy, k, d);
+					grid.updateCellInfo(ix, iy - 1, k, d);
+					grid.updateCellInfo(ix - 1, iy - 1, k, d);
+				}
+			}  // for iy
+		}  // for ix
+
+	}  // n
+}
+
 size_t CPTG_DiffDrive_CollisionGridBased::getPathStepCount(uint16_t k) const
 {
-	ASSERT_(k < m_trajectory.size());
+	ASSERT_(k + 1U < m_pathTableStart.size());
 
-	return m_trajectory[k].size();
+	return pathTableStepCount(k);
 }
 
 mrpt::math::TPose2D CPTG_DiffDrive_CollisionGridBased::getPathPose(
 	uint16_t k, uint32_t step) const
 {
-	ASSERT_(k < m_trajectory.size());
-	ASSERT_(step < m_trajectory[k].size());
+	ASSERT_(k + 1U < m_pathTableStart.size());
+	ASSERT_(step < pathTableStepCount(k));
 
-	return {
-		m_trajectory[k][step].x, m_trajectory[k][step].y,
-		m_trajectory[k][step].phi};
+	const TCPoint& p = pathTableStep(k, step);
+	return {p.x, p.y, p.phi};
 }
 
 double CPTG_DiffDrive_CollisionGridBased::getPathDist(
 	uint16_t k, uint32_t step) const
 {
-	ASSERT_(k < m_trajectory.size());
-	ASSERT_(step < m_trajectory[k].size());
+	ASSERT_(k + 1U < m_pathTableStart.size());
+	ASSERT_(step < pathTableStepCount(k));
 
-	return m_trajectory[k][step].dist;
+	return pathTableStep(k, step).dist;
 }
 
 bool CPTG_DiffDrive_CollisionGridBased::getPathStepForDist(
 	uint16_t k, double dist, uint32_t& out_step) const
 {
-	ASSERT_(k < m_trajectory.size());
-	const size_t numPoints = m_trajectory[k].size();
+	ASSERT_(k + 1U < m_pathTableStart.size());
+	const uint32_t numPoints = pathTableStepCount(k);
 
 	ASSERT_(numPoints > 0);
 
-	for (size_t n = 0; n < numPoints - 1; n++)
+	// Distances along a path never decrease: find the first step n+1 with
+	// a distance >= dist:
+	const TCPoint* first = &pathTableStep(k, 0);
+	const TCPoint* last = first + numPoints;
+	const TCPoint* it = std::lower_bound(
+		first + 1, last, dist,
+		[](const TCPoint& p, double d) { return p.dist < d; });
+	if (it != last)
 	{
-		if (m_trajectory[k][n + 1].dist >= dist)
-		{
-			out_step = n;
-			return true;
-		}
+		out_step = static_cast<uint32_t>(it - first) - 1;
+		return true;
 	}
 
 	out_step = numPoints - 1;
@@ -880,6 +1186,13 @@ void CPTG_DiffDrive_CollisionGridBased::updateTPObstacle(
 	double ox, double oy, std::vector<double>& tp_obstacles) const
 {
 	ASSERTMSG_(!m_trajectory.empty(), "PTG has not been initialized!");
+	if (m_mappedColGrid)
+	{
+		m_mappedColGrid->forEachInCell(ox, oy, [&](uint16_t k, float dist) {
+			internal_TPObsDistancePostprocess(ox, oy, dist, tp_obstacles[k]);
+		});
+		return;
+	}
 	const TCollisionCell& cell = m_collisionGrid.getTPObstacle(ox, oy);
 	// Keep the minimum distance:
 	for (const auto& i : cell)
@@ -889,10 +1202,98 @@ void CPTG_DiffDrive_CollisionGridBased::updateTPObstacle(
 	}
 }
 
+int CPTG_DiffDrive_CollisionGridBased::colGridCellIndex(
+	double ox, double oy) const
+{
+	if (m_mappedColGrid) return m_mappedColGrid->cellIndex(ox, oy);
+
+	// Same float coordinates than in CCollisionGrid::getTPObstacle():
+	const int cx = m_collisionGrid.x2idx(static_cast<float>(ox));
+	const int cy = m_collisionGrid.y2idx(static_cast<float>(oy));
+	if (cx < 0 || cx >= static_cast<int>(m_collisionGrid.getSizeX()) ||
+		cy < 0 || cy >= static_cast<int>(m_collisionGrid.getSizeY()))
+		return -1;
+	return cx + cy * static_cast<int>(m_collisionGrid.getSizeX());
+}
+
+void CPTG_DiffDrive_CollisionGridBased::updateTPObstacleBatch(
+	const std::vector<double>& xs, const std::vector<double>& ys,
+	std::vector<double>& tp_obstacles) const
+{
+	ASSERTMSG_(!m_trajectory.empty(), "PTG has not been initialized!");
+	ASSERT_EQUAL_(xs.size(), ys.size());
+
+	auto& bc = m_batchCache;
+	const size_t nCells = m_mappedColGrid
+		? m_mappedColGrid->cellCount()
+		: m_collisionGrid.getSizeX() * m_collisionGrid.getSizeY();
+	if (bc.cellStamp.size() != nCells)
+	{
+		bc.cellStamp.assign(nCells, 0);
+		bc.stamp = 0;
+		bc.lastCells.clear();
+		bc.lastTPObs.clear();
+	}
+	if (++bc.stamp == 0)
+	{
+		std::fill(bc.cellStamp.begin(), bc.cellStamp.end(), 0);
+		bc.stamp = 1;
+	}
+
+	// Obstacles inside the robot shape need their exact position (see
+	// internal_TPObsDistancePostprocess()), and can't be merged per cell:
+	const double R2 = mrpt::square(getMaxRobotRadius());
+
+	bc.cells.clear();
+	for (size_t i = 0; i < xs.size(); i++)
+	{
+		const double ox = xs[i], oy = ys[i];
+		if (mrpt::square(ox) + mrpt::square(oy) <= R2)
+		{
+			updateTPObstacle(ox, oy, tp_obstacles);
+			continue;
+		}
+		const int idx = colGridCellIndex(ox, oy);
+		if (idx < 0 || bc.cellStamp[idx] == bc.stamp) continue;
+		bc.cellStamp[idx] = bc.stamp;
+		bc.cells.push_back(idx);
+	}
+	std::sort(bc.cells.begin(), bc.cells.end());
+
+	if (bc.cells != bc.lastCells || bc.lastTPObs.size() != tp_obstacles.size())
+	{
+		bc.lastTPObs.assign(
+			tp_obstacles.size(), std::numeric_limits<double>::max());
+		const auto addEntry = [&bc](uint16_t k, float dist) {
+			mrpt::keep_min(bc.lastTPObs[k], static_cast<double>(dist));
+		};
+		for (const int idx : bc.cells)
+		{
+			if (m_mappedColGrid)
+				m_mappedColGrid->forEachInCellIndex(idx, addEntry);
+			else
+				for (const auto& e : m_collisionGrid.data()[idx])
+					addEntry(e.first, e.second);
+		}
+		bc.lastCells.swap(bc.cells);
+	}
+
+	for (size_t k = 0; k < tp_obstacles.size(); k++)
+		mrpt::keep_min(tp_obstacles[k], bc.lastTPObs[k]);
+}
+
 void CPTG_DiffDrive_CollisionGridBased::updateTPObstacleSingle(
 	double ox, double oy, uint16_t k, double& tp_obstacle_k) const
 {
 	ASSERTMSG_(!m_trajectory.empty(), "PTG has not been initialized!");
+	if (m_mappedColGrid)
+	{
+		m_mappedColGrid->forEachInCell(ox, oy, [&](uint16_t kk, float dist) {
+			if (kk == k)
+				internal_TPObsDistancePostprocess(ox, oy, dist, tp_obstacle_k);
+		});
+		return;
+	}
 	const TCollisionCell& cell = m_collisionGrid.getTPObstacle(ox, oy);
 	// Keep the minimum distance:
 	for (const auto& i : cell)
@@ -917,6 +1318,7 @@ void CPTG_DiffDrive_CollisionGridBased::internal_readFromStream(
 			internal_deinitialize();
 			in >> V_MAX >> W_MAX >> turningRadiusReference >> m_robotShape >>
 				m_resolution >> m_trajectory;
+			buildPathTable();
 			break;
 		default: MRPT_THROW_UNKNOWN_SERIALIZATION_VERSION(version);
 	};
@@ -951,12 +1353,12 @@ double CPTG_DiffDrive_CollisionGridBased::getPathStepDuration() const
 mrpt::math::TTwist2D CPTG_DiffDrive_CollisionGridBased::getPathTwist(
 	uint16_t k, uint32_t step) const
 {
-	ASSERT_(k < m_trajectory.size());
-	ASSERT_(step < m_trajectory[k].size());
+	ASSERT_(k + 1U < m_pathTableStart.size());
+	ASSERT_(step < pathTableStepCount(k));
 
-	auto tw = mrpt::math::TTwist2D(
-		m_trajectory[k][step].v, 0, m_trajectory[k][step].w);
-	tw.rotate(m_trajectory[k][step].phi);
+	const TCPoint& p = pathTableStep(k, step);
+	auto tw = mrpt::math::TTwist2D(p.v, 0, p.w);
+	tw.rotate(p.phi);
 
 	return tw;
 }
@@ -15,6 +15,8 @@
 #include <mrpt/system/filesystem.h>
 #include <mrpt/system/os.h>
 
+#include <algorithm>
+#include <cmath>
 #include <fstream>
 
 using namespace mrpt::nav;
@@ -68,6 +70,10 @@ void CParameterizedTrajectoryGenerator::loadFromConfigFile(
 	MRPT_LOAD_HERE_CONFIG_VAR(
 		clearance_decimated_paths, double, m_clearance_decimated_paths, cfg,
 		sSection);
+	MRPT_LOAD_HERE_CONFIG_VAR(
+		tp_obstacles_cache_resolution, double,
+		m_tp_obstacles_cache_resolution, cfg, sSection);
+	m_tp_obstacles_cache.cells.clear();
 
 	// Ensure a minimum of resolution:
 	mrpt::keep_max(
@@ -118,6 +124,11 @@ void CParameterizedTrajectoryGenerator::saveToConfigFile(
 		sSection, "clearance_decimated_paths", m_clearance_decimated_paths, WN,
 		WV,
 		"Number of decimated paths for estimation of clearance (Default=15).");
+	cfg.write(
+		sSection, "tp_obstacles_cache_resolution",
+		m_tp_obstacles_cache_resolution, WN, WV,
+		"Cell size [m] of the cache of TP-Obstacles for batches of obstacles "
+		"(Default=0, disabled).");
 
 	// Optional params, for debugging only
 	cfg.write(
@@ -359,6 +370,7 @@ void CParameterizedTrajectoryGenerator::updateNavDynamicState(
 			newState.targetRelSpeed >= .0 &&
 			newState.targetRelSpeed <= 1.0);  // sanity check
 		m_nav_dyn_state = newState;
+		m_tp_obstacles_cache.cells.clear();
 
 		// 1st) Build PTG paths without counting for target slow-down:
 		m_nav_dyn_state_target_k = INVALID_PTG_PATH_INDEX;
@@ -395,6 +407,7 @@ void CParameterizedTrajectoryGenerator::initialize(
 			mrpt::system::fileNameStripInvalidChars(getDescription()) +
 			std::string(".bin.gz");
 
+	m_tp_obstacles_cache.cells.clear();
 	this->internal_initialize(sCache, verbose);
 	m_is_initialized = true;
 }
@@ -402,9 +415,76 @@ void CParameterizedTrajectoryGenerator::deinitialize()
 {
 	if (!m_is_initialized) return;
 	this->internal_deinitialize();
+	m_tp_obstacles_cache.cells.clear();
 	m_is_initialized = false;
 }
 
+void CParameterizedTrajectoryGenerator::setTPObstacleCacheResolution(
+	double resolution)
+{
+	ASSERT_GE_(resolution, .0);
+	m_tp_obstacles_cache_resolution = resolution;
+	m_tp_obstacles_cache.cells.clear();
+}
+
+void CParameterizedTrajectoryGenerator::updateTPObstacleBatch(
+	const std::vector<double>& xs, const std::vector<double>& ys,
+	std::vector<double>& tp_obstacles) const
+{
+	ASSERT_EQUAL_(xs.size(), ys.size());
+	const double res = m_tp_obstacles_cache_resolution;
+	if (res <= 0)
+	{
+		for (size_t i = 0; i < xs.size(); i++)
+			updateTPObstacle(xs[i], ys[i], tp_obstacles);
+		return;
+	}
+
+	// Obstacles this close might be inside the robot shape, where the exact
+	// position matters (see internal_TPObsDistancePostprocess()):
+	const double R2 = mrpt::square(getMaxRobotRadius() + res);
+
+	auto& c = m_tp_obstacles_cache;
+	c.keys.clear();
+	for (size_t i = 0; i < xs.size(); i++)
+	{
+		if (mrpt::square(xs[i]) + mrpt::square(ys[i]) <= R2)
+		{
+			updateTPObstacle(xs[i], ys[i], tp_obstacles);
+			continue;
+		}
+		const auto cx = static_cast<int32_t>(std::floor(xs[i] / res));
+		const auto cy = static_cast<int32_t>(std::floor(ys[i] / res));
+		c.keys.push_back(
+			(static_cast<uint64_t>(static_cast<uint32_t>(cx)) << 32) |
+			static_cast<uint32_t>(cy));
+	}
+	std::sort(c.keys.begin(), c.keys.end());
+	c.keys.erase(std::unique(c.keys.begin(), c.keys.end()), c.keys.end());
+
+	// Bound the memory used by the cache:
+	const size_t MAX_CACHED_CELLS = 100000;
+	if (c.cells.size() + c.keys.size() > MAX_CACHED_CELLS) c.cells.clear();
+
+	for (const uint64_t key : c.keys)
+	{
+		auto [it, isNew] = c.cells.try_emplace(key);
+		if (isNew)
+		{
+			// Convert the central point of the new cell:
+			const auto cx = static_cast<int32_t>(key >> 32);
+			const auto cy = static_cast<int32_t>(key & 0xffffffffU);
+			initTPObstacles(c.tp_obs);
+			updateTPObstacle((cx + 0.5) * res, (cy + 0.5) * res, c.tp_obs);
+			for (uint16_t k = 0; k < c.tp_obs.size(); k++)
+				if (c.tp_obs[k] < refDistance)
+					it->second.emplace_back(k, c.tp_obs[k]);
+		}
+		for (const auto& e : it->second)
+			mrpt::keep_min(tp_obstacles[e.first], e.second);
+	}
+}
+
 void CParameterizedTrajectoryGenerator::internal_TPObsDistancePostprocess(
 	const double ox, const double oy, const double new_tp_obs_dist,
 	double& inout_tp_obs) const
@@ -9,6 +9,7 @@
 
 #include <gtest/gtest.h>
 #include <mrpt/config/CConfigFile.h>
+#include <mrpt/nav/tpspace/CPTG_DiffDrive_CollisionGridBased.h>
 #include <mrpt/nav/tpspace/CParameterizedTrajectoryGenerator.h>
 #include <mrpt/system/filesystem.h>
 #include <test_mrpt_common.h>
@@ -180,9 +181,181 @@ TEST(NavTests, PTGs_tests)
 			EXPECT_TRUE(any_change_all);
 		}
 
+		// TEST: updateTPObstacleBatch() == updateTPObstacle() for each point
+		{
+			// Points at cell centers, so the cache is also exact. Several
+			// points per collision grid cell, and some of them repeated:
+			const double res = 0.1;
+			std::vector<double> xs, ys;
+			for (int ix = -25; ix < 25; ix++)
+				for (int iy = -25; iy < 25; iy++)
+				{
+					xs.push_back((ix + 0.5) * res);
+					ys.push_back((iy + 0.5) * res);
+					if ((ix + iy) % 5 == 0)
+					{
+						xs.push_back(xs.back());
+						ys.push_back(ys.back());
+					}
+				}
+
+			std::vector<double> tp_ref;
+			ptg->initTPObstacles(tp_ref);
+			const auto tp_init = tp_ref;
+			for (size_t i = 0; i < xs.size(); i++)
+				ptg->updateTPObstacle(xs[i], ys[i], tp_ref);
+			EXPECT_NE(tp_ref, tp_init);
+
+			for (const double cacheRes : {.0, res})
+			{
+				ptg->setTPObstacleCacheResolution(cacheRes);
+				// Twice, to also check reusing cached data:
+				for (int rep = 0; rep < 2; rep++)
+				{
+					auto tp = tp_init;
+					ptg->updateTPObstacleBatch(xs, ys, tp);
+					EXPECT_EQ(tp, tp_ref) << "PTG: " << sPTGDesc << endl;
+				}
+			}
+
+			// A different set of cells, after the cached ones:
+			xs.resize(xs.size() / 3);
+			ys.resize(ys.size() / 3);
+			auto tp_ref2 = tp_init, tp = tp_init;
+			for (size_t i = 0; i < xs.size(); i++)
+				ptg->updateTPObstacle(xs[i], ys[i], tp_ref2);
+			ptg->updateTPObstacleBatch(xs, ys, tp);
+			EXPECT_EQ(tp, tp_ref2) << "PTG: " << sPTGDesc << endl;
+			ptg->setTPObstacleCacheResolution(0);
+		}
+
 		printf(
 			"PTG `%50s` run %6u tests.\n", sPTGDesc.c_str(),
 			(unsigned int)num_tests_run);
 
 	}  // for each ptg
 }
+
+TEST(NavTests, PTGs_mappedCollisionGrid)
+{
+	using namespace mrpt::nav;
+
+	const std::string sFil =
+		mrpt::UNITTEST_BASEDIR + std::string("/tests/PTGs_for_tests.ini");
+	if (!mrpt::system::fileExists(sFil))
+	{
+		std::cerr << "**WARNING* Skipping tests since file cannot be found: '"
+				  << sFil << "'\n";
+		return;
+	}
+	mrpt::config::CConfigFile cfg(sFil);
+
+	const std::string dir = mrpt::system::getTempFileName() + "_colgrid";
+	ASSERT_TRUE(mrpt::system::createDirectory(dir));
+	const std::string cacheFile = dir + "/ReacNavGrid_000.dat.gz";
+
+	// PTG #2 in the test file is a CPTG_DiffDrive_C:
+	auto createPTG = [&](bool mappedCache) {
+		auto ptg = CParameterizedTrajectoryGenerator::CreatePTG(
+			"CPTG_DiffDrive_C", cfg, "PTG_UNIT_TESTS", "PTG2_");
+		auto cg = std::dynamic_pointer_cast<CPTG_DiffDrive_CollisionGridBased>(
+			ptg);
+		EXPECT_TRUE(cg);
+		cg->setMappedColGridCache(mappedCache);
+		cg->initialize(cacheFile, false /*verbose */);
+		return cg;
+	};
+
+	const auto ref = createPTG(false);
+	const auto built = createPTG(true);	 // Builds and maps the cache file
+	const auto loaded = createPTG(true);  // Only maps it
+	EXPECT_FALSE(ref->isCollisionGridMapped());
+	EXPECT_TRUE(built->isCollisionGridMapped());
+	EXPECT_TRUE(loaded->isCollisionGridMapped());
+
+	const double refDist = ref->getRefDistance();
+	bool any_change = false;
+	for (double ox = -refDist; ox < refDist; ox += 0.07)
+		for (double oy = -refDist; oy < refDist; oy += 0.07)
+		{
+			std::vector<double> tp1, tp2, tp3;
+			ref->initTPObstacles(tp1);
+			built->initTPObstacles(tp2);
+			loaded->initTPObstacles(tp3);
+			const auto tp0 = tp1;
+			ref->updateTPObstacle(ox, oy, tp1);
+			built->updateTPObstacle(ox, oy, tp2);
+			loaded->updateTPObstacle(ox, oy, tp3);
+			EXPECT_EQ(tp1, tp2) << "ox=" << ox << " oy=" << oy;
+			EXPECT_EQ(tp1, tp3) << "ox=" << ox << " oy=" << oy;
+			if (tp0 != tp1) any_change = true;
+
+			double d1 = 1e6, d3 = 1e6;
+			ref->updateTPObstacleSingle(ox, oy, 10, d1);
+			loaded->updateTPObstacleSingle(ox, oy, 10, d3);
+			EXPECT_EQ(d1, d3);
+		}
+	EXPECT_TRUE(any_change);
+
+	mrpt::system::deleteFilesInDirectory(dir, true);
+}
+
+TEST(NavTests, PTGs_collisionGridThreads)
+{
+	using namespace mrpt::nav;
+
+	const std::string sFil =
+		mrpt::UNITTEST_BASEDIR + std::string("/tests/PTGs_for_tests.ini");
+	if (!mrpt::system::fileExists(sFil))
+	{
+		std::cerr << "**WARNING* Skipping tests since file cannot be found: '"
+				  << sFil << "'\n";
+		return;
+	}
+	mrpt::config::CConfigFile cfg(sFil);
+
+	const std::string dir = mrpt::system::getTempFileName() + "_colgrid";
+	ASSERT_TRUE(mrpt::system::createDirectory(dir));
+
+	// PTG #3 in the test file is a CPTG_DiffDrive_alpha:
+	std::vector<size_t> progress;
+	auto createPTG = [&](unsigned int nThreads) {
+		auto ptg = CParameterizedTrajectoryGenerator::CreatePTG(
+			"CPTG_DiffDrive_alpha", cfg, "PTG_UNIT_TESTS", "PTG3_");
+		auto cg = std::dynamic_pointer_cast<CPTG_DiffDrive_CollisionGridBased>(
+			ptg);
+		EXPECT_TRUE(cg);
+		cg->setColGridNumThreads(nThreads);
+		progress.clear();
+		cg->setInitProgressCallback([&progress, p = cg.get()](
+										size_t done, size_t total) {
+			EXPECT_EQ(total, p->getPathCount());
+			progress.push_back(done);
+		});
+		// Different cache files, so both are actually built:
+		cg->initialize(dir + mrpt::format("/grid_%u.dat.gz", nThreads), false);
+		return cg;
+	};
+
+	const auto ptg1 = createPTG(1);
+	const auto ptg4 = createPTG(4);
+
+	// Called once per path, in order:
+	ASSERT_EQ(progress.size(), ptg4->getPathCount());
+	for (size_t i = 0; i < progress.size(); i++)
+		EXPECT_EQ(progress[i], i + 1);
+
+	const double refDist = ptg1->getRefDistance();
+	for (double ox = -refDist; ox < refDist; ox += 0.07)
+		for (double oy = -refDist; oy < refDist; oy += 0.07)
+		{
+			std::vector<double> tp1, tp4;
+			ptg1->initTPObstacles(tp1);
+			ptg4->initTPObstacles(tp4);
+			ptg1->updateTPObstacle(ox, oy, tp1);
+			ptg4->updateTPObstacle(ox, oy, tp4);
+			EXPECT_EQ(tp1, tp4) << "ox=" << ox << " oy=" << oy;
+		}
+
+	mrpt::system::deleteFilesInDirectory(dir, true);
+}
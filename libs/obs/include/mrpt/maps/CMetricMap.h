@@ -58,6 +58,9 @@ class CMetricMap : public mrpt::serialization::CSerializable,
 {
 	DEFINE_VIRTUAL_SERIALIZABLE(CMetricMap)
 
+	// To run the internal_*() methods of its maps in parallel:
+	friend class CMultiMetricMap;
+
    private:
 	/** Internal method called by clear() */
 	virtual void internal_clear() = 0;
@@ -293,6 +296,15 @@ class CMetricMap : public mrpt::serialization::CSerializable,
 	virtual float squareDistanceToClosestCorrespondence(
 		float x0, float y0) const;
 
+	/** Batch version of squareDistanceToClosestCorrespondence(), for the 2D
+	 * points (xs[i],ys[i]). The default implementation calls it for each
+	 * point; point maps run the queries in parallel (see TBatchQueryParams).
+	 * \note (New in MRPT 2.4.9) */
+	virtual void squareDistanceToClosestCorrespondenceBatch(
+		const std::vector<float>& xs, const std::vector<float>& ys,
+		std::vector<float>& outSqrDists,
+		const TBatchQueryParams& params = TBatchQueryParams()) const;
+
 	/** If the map is a simple points map or it's a multi-metric map that
 	 * contains EXACTLY one simple points map, return it.
 	 * Otherwise, return nullptr
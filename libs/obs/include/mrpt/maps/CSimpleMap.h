@@ -14,6 +14,10 @@
 #include <mrpt/poses/CPosePDF.h>
 #include <mrpt/serialization/CSerializable.h>
 
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
 #include <tuple>
 
 namespace mrpt::maps
@@ -36,6 +40,14 @@ namespace mrpt::maps
  *       files with the extension `.simplemap`.
  *       See [Robotics file formats](robotics_file_formats.html).
  *
+ * Maps too large to fit in memory can be saved to an indexed (uncompressed)
+ * file with saveToExternalStorageFile(). When loaded with
+ * loadFromExternalStorageFile() (or loadFromFile(), which detects the format),
+ * only the poses are kept in memory, while sensory frames are read from the
+ * file when accessed with get() or getAsPair(), and unloaded in least
+ * recently used order to keep them within a memory budget. See
+ * isExternallyStored().
+ *
  * \sa mrpt::obs::CSensoryFrame, mrpt::poses::CPose3DPDF, mrpt::maps::CMetricMap
  *
  * \ingroup mrpt_obs_grp
@@ -89,6 +101,70 @@ class CSimpleMap : public mrpt::serialization::CSerializable
 	 * \return false on any error. */
 	bool loadFromFile(const std::string& filName);
 
+	/** \name External storage of sensory frames
+	 * @{ */
+
+	/** Saves this map to an indexed file whose sensory frames can be loaded
+	 * one by one, see loadFromExternalStorageFile().
+	 * \return false on any error.
+	 * \note (New in MRPT 2.4.9) */
+	bool saveToExternalStorageFile(const std::string& fileName) const;
+
+	/** Loads the poses of a file written by saveToExternalStorageFile(),
+	 * which is kept open to read sensory frames on demand, when accessed
+	 * with get() or getAsPair().
+	 * \param[in] memoryBudget Approximate maximum memory (bytes) of the
+	 * loaded frames (0: unlimited). See setExternalStorageMemoryBudget().
+	 * \return false on any error.
+	 * \note (New in MRPT 2.4.9) */
+	bool loadFromExternalStorageFile(
+		const std::string& fileName, size_t memoryBudget = 0);
+
+	/** Returns true if the file was written by saveToExternalStorageFile()
+	 * \note (New in MRPT 2.4.9) */
+	static bool IsExternalStorageFile(const std::string& fileName);
+
+	/** Whether sensory frames are read on demand from an external file, see
+	 * loadFromExternalStorageFile().
+	 * \note (New in MRPT 2.4.9) */
+	bool isExternallyStored() const { return m_extStorage != nullptr; }
+
+	/** The file of loadFromExternalStorageFile(), or an empty string */
+	std::string getExternalStorageFile() const;
+
+	/** Changes the maximum memory (bytes) of the externally stored frames
+	 * kept loaded (0: unlimited). When exceeded, the least recently accessed
+	 * frames which are not in use elsewhere are unloaded.
+	 * The size of each frame is estimated from its serialized size.
+	 * \note (New in MRPT 2.4.9) */
+	void setExternalStorageMemoryBudget(size_t bytes);
+
+	/** Estimated memory (bytes) of the externally stored frames currently
+	 * loaded.
+	 * \note (New in MRPT 2.4.9) */
+	size_t getExternalStorageMemoryUsage() const;
+
+	/** Ensures the sensory frame of the i'th pair is loaded. Does nothing if
+	 * the map is not externally stored.
+	 * \exception std::exception On index out of bounds or read errors.
+	 * \note (New in MRPT 2.4.9) */
+	void load(size_t index) const { pageIn(index); }
+
+	/** Releases the sensory frame of the i'th pair, if externally stored
+	 * and unmodified (see set()).
+	 * \note (New in MRPT 2.4.9) */
+	void unload(size_t index) const;
+
+	/** Releases all externally stored sensory frames.
+	 * \note (New in MRPT 2.4.9) */
+	void unload() const;
+
+	/** Whether the sensory frame of the i'th pair is in memory.
+	 * \note (New in MRPT 2.4.9) */
+	bool isLoaded(size_t index) const;
+
+	/** @} */
+
 	/** Returns the count of (pose,sensoryFrame) pairs */
 	size_t size() const { return m_posesObsPairs.size(); }
 
@@ -96,34 +172,38 @@ class CSimpleMap : public mrpt::serialization::CSerializable
 	bool empty() const { return m_posesObsPairs.empty(); }
 
 	/** Access to the 0-based index i'th pair.
+	 * Externally stored sensory frames are loaded if needed (see
+	 * isExternallyStored()). This method is thread-safe for concurrent
+	 * const accesses.
 	 * \exception std::exception On index out of bounds.
 	 */
 	void get(
 		size_t index, mrpt::poses::CPose3DPDF::ConstPtr& out_posePDF,
 		mrpt::obs::CSensoryFrame::ConstPtr& out_SF) const
 	{
-		ASSERTMSG_(index < m_posesObsPairs.size(), "Index out of bounds");
+		out_SF = pageIn(index);
 		out_posePDF = m_posesObsPairs[index].pose;
-		out_SF = m_posesObsPairs[index].sf;
 	}
 	/// \overload
 	std::tuple<
 		mrpt::poses::CPose3DPDF::ConstPtr, mrpt::obs::CSensoryFrame::ConstPtr>
 		get(size_t index) const
 	{
-		ASSERTMSG_(index < m_posesObsPairs.size(), "Index out of bounds");
-		return {m_posesObsPairs[index].pose, m_posesObsPairs[index].sf};
+		auto sf = pageIn(index);
+		return {m_posesObsPairs[index].pose, sf};
 	}
 
 	ConstPair getAsPair(size_t index) const
 	{
-		ASSERTMSG_(index < m_posesObsPairs.size(), "Index out of bounds");
-		return m_posesObsPairs.at(index);
+		ConstPair p;
+		p.sf = pageIn(index);
+		p.pose = m_posesObsPairs[index].pose;
+		return p;
 	}
 	Pair& getAsPair(size_t index)
 	{
-		ASSERTMSG_(index < m_posesObsPairs.size(), "Index out of bounds");
-		return m_posesObsPairs.at(index);
+		pageIn(index);
+		return m_posesObsPairs[index];
 	}
 
 	/// \overload
@@ -131,22 +211,24 @@ class CSimpleMap : public mrpt::serialization::CSerializable
 		size_t index, mrpt::poses::CPose3DPDF::Ptr& out_posePDF,
 		mrpt::obs::CSensoryFrame::Ptr& out_SF)
 	{
-		ASSERTMSG_(index < m_posesObsPairs.size(), "Index out of bounds");
+		out_SF = pageIn(index);
 		out_posePDF = m_posesObsPairs[index].pose;
-		out_SF = m_posesObsPairs[index].sf;
 	}
 
 	/// \overload
 	std::tuple<mrpt::poses::CPose3DPDF::Ptr, mrpt::obs::CSensoryFrame::Ptr> get(
 		size_t index)
 	{
-		ASSERTMSG_(index < m_posesObsPairs.size(), "Index out of bounds");
-		return {m_posesObsPairs[index].pose, m_posesObsPairs[index].sf};
+		auto sf = pageIn(index);
+		return {m_posesObsPairs[index].pose, sf};
 	}
 
 	/** Changes the 0-based index i'th pair.
 	 *  If one of either `in_posePDF` or `in_SF` are empty `shared_ptr`s, the
 	 * corresponding field in the map is not modified.
+	 *  Externally stored frames are never written back to their file, so
+	 * they must be modified with this method (which keeps the new frame in
+	 * memory), instead of through the pointers returned by get().
 	 *
 	 * \exception std::exception On index out of bounds.
 	 * \sa insert, get, remove
@@ -206,7 +288,7 @@ class CSimpleMap : public mrpt::serialization::CSerializable
 		const mrpt::obs::CSensoryFrame::Ptr& in_SF);
 
 	/** Remove all stored pairs.  \sa remove */
-	void clear() { m_posesObsPairs.clear(); }
+	void clear();
 
 	/** Change the coordinate origin of all stored poses, that is, translates
 	 * and rotates the map such that the old SE(3) origin (identity
@@ -217,6 +299,8 @@ class CSimpleMap : public mrpt::serialization::CSerializable
 	/** @} */
 
 	/** \name Iterators API
+	 * Iterators give direct access to the stored pairs: externally stored
+	 * sensory frames which are not loaded are empty pointers (see get()).
 	 * @{ */
 	using TPosePDFSensFramePairList = std::deque<Pair>;
 
@@ -241,8 +325,33 @@ class CSimpleMap : public mrpt::serialization::CSerializable
 	/** @} */
 
    private:
-	/** The stored data */
-	TPosePDFSensFramePairList m_posesObsPairs;
+	/** The stored data. Externally stored frames are a cache of the file,
+	 * hence mutable. */
+	mutable TPosePDFSensFramePairList m_posesObsPairs;
+
+	/** Location of each frame in the external storage file */
+	struct TExternalFrame
+	{
+		/** Offset and size of the serialized frame, or size=0 for frames
+		 * only held in memory (new or modified) */
+		uint64_t offset = 0, size = 0;
+		/** Last access, for the LRU policy */
+		uint64_t lastUse = 0;
+	};
+	struct TExternalStorage;
+
+	/** One entry per pair, only if isExternallyStored() */
+	mutable std::deque<TExternalFrame> m_extFrames;
+	std::shared_ptr<TExternalStorage> m_extStorage;
+
+	/** Checks the index, loads the frame if externally stored, and returns
+	 * it */
+	mrpt::obs::CSensoryFrame::Ptr pageIn(size_t index) const;
+	/** Returns the frame, reading it without caching if not loaded */
+	mrpt::obs::CSensoryFrame::Ptr readFrameNoCache(size_t index) const;
+	/** Unloads LRU frames, except `keepIndex`, while over budget. The
+	 * storage mutex must be locked. */
+	void enforceMemoryBudget(size_t keepIndex) const;
 
 };	// End of class def.
 
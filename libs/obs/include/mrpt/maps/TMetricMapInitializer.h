@@ -110,6 +110,15 @@ class TSetOfMetricMapInitializers : public mrpt::config::CLoadableOptions
 	const_iterator begin() const { return m_list.begin(); }
 	const_iterator end() const { return m_list.end(); }
 	void clear() { m_list.clear(); }
+
+	/** Number of threads used by CMultiMetricMap to insert observations into,
+	 * and evaluate likelihoods with, its maps concurrently (one map per
+	 * thread). 1 (default) means sequential operation, 0 means as many
+	 * threads as hardware cores. See CMultiMetricMap::numThreads.
+	 * \note (New in MRPT 2.4.9)
+	 */
+	unsigned int numThreads{1};
+
 	/** Loads the configuration for the set of internal maps from a textual
 	 *definition in an INI-like file.
 	 *  The format of the ini file is defined in CConfigFile. The list
@@ -118,6 +127,9 @@ class TSetOfMetricMapInitializers : public mrpt::config::CLoadableOptions
 	 *
 	 *  \code
 	 * [<sectionName>]
+	 *  // Optional: number of threads to operate on the maps (Default=1)
+	 *  numThreads=<1: sequential, 0: one per core, N>
+	 *
 	 *  // Creation of maps:
 	 *  occupancyGrid_count=<Number of mrpt::maps::COccupancyGridMap2D maps>
 	 *  octoMap_count=<Number of mrpt::maps::COctoMap maps>
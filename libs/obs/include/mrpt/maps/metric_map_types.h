@@ -40,6 +40,10 @@ struct TMatchingParams
 	/** The point used to calculate angular distances: e.g. the coordinates of
 	 * the sensor for a 2D laser scanner. */
 	mrpt::math::TPoint3D angularDistPivotPoint{0, 0, 0};
+	/** Number of threads for the correspondence search in point maps (0: as
+	 * many as hardware threads). Results do not depend on it. (Default=1)
+	 * \note (New in MRPT 2.4.9) */
+	size_t numThreads{1};
 
 	/** Ctor: default values */
 	TMatchingParams() = default;
@@ -69,10 +73,32 @@ struct TMatchingRatioParams
 	/** (Default: 2.0f) The minimum Mahalanobis distance between 2 probabilistic
 	 * map elements for counting them as a correspondence. */
 	float maxMahaDistForCorr{2.0f};
+	/** Number of threads for the correspondence search in point maps (0: as
+	 * many as hardware threads). Results do not depend on it. (Default=1)
+	 * \note (New in MRPT 2.4.9) */
+	size_t numThreads{1};
 
 	TMatchingRatioParams() = default;
 };
 
+/** Parameters for batched queries of many points in a map, e.g.
+ * CMetricMap::squareDistanceToClosestCorrespondenceBatch()
+ * \note (New in MRPT 2.4.9) */
+struct TBatchQueryParams
+{
+	/** Number of threads (0: as many as hardware threads). Results do not
+	 * depend on it. (Default=1) */
+	size_t numThreads{1};
+	/** Run the queries sorted along a Morton (Z-order) curve of their
+	 * coordinates, so that consecutive queries visit the same KD-tree nodes
+	 * while they are still in the CPU caches. It takes sorting the queries,
+	 * worth it for many queries not already sorted in space (as, e.g., the
+	 * points of a scan are). Results do not depend on it. (Default=true) */
+	bool mortonOrder{true};
+
+	TBatchQueryParams() = default;
+};
+
 /** Common params to all maps derived from mrpt::maps::CMetricMap  */
 class TMapGenericParams : public mrpt::config::CLoadableOptions,
 						  public mrpt::serialization::CSerializable
@@ -9,6 +9,7 @@
 #pragma once
 
 #include <mrpt/containers/deepcopy_poly_ptr.h>
+#include <mrpt/math/TPose2D.h>
 #include <mrpt/math/TTwist2D.h>
 #include <mrpt/obs/CAction.h>
 #include <mrpt/poses/CPose2D.h>
@@ -185,6 +186,17 @@ class CActionRobotMovement2D : public CAction
 	 */
 	void fastDrawSingleSample(mrpt::poses::CPose2D& outSample) const;
 
+	/** Draws `N` samples of the pose change at once, with the same
+	 * distribution than drawSingleSample(). All the random numbers are
+	 * generated in bulk and the samples are computed in one single pass,
+	 * which is much faster than calling drawSingleSample() `N` times (e.g.
+	 * for the prediction step of particle filters). Does not require
+	 * prepareFastDrawSingleSamples().
+	 * \note (New in MRPT 2.4.9)
+	 */
+	void drawManySamples(
+		size_t N, std::vector<mrpt::math::TPose2D>& outSamples) const;
+
 	virtual void getDescriptionAsText(std::ostream& o) const override;
 
    protected:
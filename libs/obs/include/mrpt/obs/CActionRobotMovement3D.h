@@ -8,6 +8,7 @@
    +------------------------------------------------------------------------+ */
 #pragma once
 
+#include <mrpt/math/TPose3D.h>
 #include <mrpt/obs/CAction.h>
 #include <mrpt/poses/CPose3DPDFGaussian.h>
 
@@ -113,6 +114,15 @@ class CActionRobotMovement3D : public CAction
 		const mrpt::poses::CPose3D& odometryIncrement,
 		const TMotionModelOptions& o);
 
+	/** Draws `N` samples of the pose change (poseChange) at once. All the
+	 * random numbers are generated in bulk and the samples are computed in
+	 * one single pass, which is much faster than drawing them one by one
+	 * (e.g. for the prediction step of particle filters).
+	 * \note (New in MRPT 2.4.9)
+	 */
+	void drawManySamples(
+		size_t N, std::vector<mrpt::math::TPose3D>& outSamples) const;
+
 	virtual void getDescriptionAsText(std::ostream& o) const override;
 
 	/** Each "true" entry means that the corresponding "velocities" element
@@ -201,6 +201,15 @@ class CObservation : public mrpt::serialization::CSerializable,
 	virtual void unload() const
 	{ /* Default implementation: do nothing */
 	}
+	/** Hints that this observation will be accessed soon, so its
+	 * externally-stored images (if any) start being loaded in background
+	 * threads. See mrpt::img::CExternalImageCache.
+	 * \sa load
+	 * \note (New in MRPT 2.4.9)
+	 */
+	virtual void prefetch() const
+	{ /* Default implementation: do nothing */
+	}
 
 	/** @} */
 
@@ -152,6 +152,17 @@ class CObservation2DRangeScan : public CObservation
 	 * beginning of the scan). */
 	double deltaPitch{0};
 
+	/** If >0, ranges are serialized (e.g. into rawlogs) quantized to this
+	 * resolution (in meters), encoded as the difference with the previous
+	 * valid range in a variable-length integer, with invalid rays as a one
+	 * byte marker. This typically takes 1 or 2 bytes per ray, instead of
+	 * the 5 bytes of a float range and its validity flag.
+	 * The ranges of invalid rays are not stored (they are read as 0).
+	 * Set when loading compact scans, so they are saved again the same way.
+	 * Default=0: lossless storage of float ranges.
+	 * \note (New in MRPT 2.4.9) */
+	float compactRangeResolution{0};
+
 	/** Fill out a T2DScanProperties structure with the parameters of this scan
 	 */
 	void getScanProperties(T2DScanProperties& p) const;
@@ -169,8 +180,11 @@ class CObservation2DRangeScan : public CObservation
 	 * mrpt-obs on classes on other libraries.
 	 */
 	mutable mrpt::maps::CMetricMap::Ptr m_cachedMap;
-	/** Internal method, used from buildAuxPointsMap() */
-	void internal_buildAuxPointsMap(const void* options = nullptr) const;
+	/** Internal method, used from buildAuxPointsMap(). Builds the cached map
+	 * if it does not exist yet, and returns it. It is safe to call it from
+	 * several threads on the same object. */
+	const mrpt::maps::CMetricMap* internal_buildAuxPointsMap(
+		const void* options = nullptr) const;
 
    public:
 	/** Returns the cached points map representation of the scan, if already
@@ -198,14 +212,17 @@ class CObservation2DRangeScan : public CObservation
 	 *    mrpt::maps::CPointsMap *map =
 	 * obs->buildAuxPointsMap<mrpt::maps::CPointsMap>(&options or nullptr);
 	 *  \endcode
+	 * \note (New in MRPT 2.4.9) It can be safely called from several threads
+	 * at once, e.g. from the parallel insertion of observations in
+	 * mrpt::maps::CMultiMetricMap.
 	 * \sa getAuxPointsMap
 	 */
 	template <class POINTSMAP>
 	inline const POINTSMAP* buildAuxPointsMap(
 		const void* options = nullptr) const
 	{
-		if (!m_cachedMap) internal_buildAuxPointsMap(options);
-		return static_cast<const POINTSMAP*>(m_cachedMap.get());
+		return static_cast<const POINTSMAP*>(
+			internal_buildAuxPointsMap(options));
 	}
 
 	/** @} */
@@ -171,6 +171,10 @@ class CObservation3DRangeScan : public CObservation
 	 * \sa load
 	 */
 	void unload() const override;
+	/** Starts loading the intensity and confidence images in the background,
+	 * if externally stored. Range images and 3D points are not prefetched.
+	 * \sa load */
+	void prefetch() const override;
 	/** @} */
 
 	/** Unprojects the RGB+D image pair into a 3D point cloud (with color if the
@@ -18,6 +18,8 @@
 #include <mrpt/opengl/pointcloud_adapters.h>
 
 #include <Eigen/Dense>	// block<>()
+#include <algorithm>
+#include <limits>
 
 namespace mrpt::obs::detail
 {
@@ -39,6 +41,78 @@ void do_project_3d_pointcloud_SSE2(
 	std::vector<uint16_t>& idxs_x, std::vector<uint16_t>& idxs_y,
 	const mrpt::obs::TRangeImageFilterParams& fp, bool MAKE_ORGANIZED);
 
+
+/** Signature of the SIMD kernels that process one row of W pixels of a range
+ * image: `D[c]` is set to the range (meters) of pixel `c` if it passes the
+ * range filters of TRangeImageFilter, or to 0 otherwise.
+ * If `xs` is not nullptr, the unprojected points `xs[c]=kxs[c]*D[c]`, etc.
+ * are also computed. `Dmin` and `Dmax` are the rows of
+ * TRangeImageFilterParams::rangeMask_{min,max}, or nullptr.
+ * `invertBetween` is the negation of TRangeImageFilterParams::rangeCheckBetween
+ */
+using range_row_kernel_t = void (*)(
+	const int W, const uint16_t* ranges, const float rangeUnits,
+	const float* Dmin, const float* Dmax, const bool invertBetween,
+	const float* kxs, const float* kys, const float* kzs, float* D, float* xs,
+	float* ys, float* zs);
+
+/** Portable version of the range_row_kernel_t kernel, also used for the
+ * last pixels of each row in the SIMD versions. */
+inline void range_row_kernel_scalar(
+	const int W, const uint16_t* ranges, const float rangeUnits,
+	const float* Dmin, const float* Dmax, const bool invertBetween,
+	const float* kxs, const float* kys, const float* kzs, float* D, float* xs,
+	float* ys, float* zs)
+{
+	for (int c = 0; c < W; c++)
+	{
+		const float d = ranges[c] * rangeUnits;
+		const bool hasMin = Dmin && Dmin[c] != .0f;
+		const bool hasMax = Dmax && Dmax[c] != .0f;
+		const bool inRange =
+			(!hasMin || d >= Dmin[c]) && (!hasMax || d <= Dmax[c]);
+		const bool valid =
+			d > .0f && (inRange != (hasMin && hasMax && invertBetween));
+		D[c] = valid ? d : .0f;
+		if (xs)
+		{
+			xs[c] = kxs[c] * D[c];
+			ys[c] = kys[c] * D[c];
+			zs[c] = kzs[c] * D[c];
+		}
+	}
+}
+
+/** AVX2 version of range_row_kernel_t. Only call it if
+ * `mrpt::cpu::supports(mrpt::cpu::feature::AVX2)`.
+ * \note (New in MRPT 2.4.9) */
+void range_row_kernel_AVX2(
+	const int W, const uint16_t* ranges, const float rangeUnits,
+	const float* Dmin, const float* Dmax, const bool invertBetween,
+	const float* kxs, const float* kys, const float* kzs, float* D, float* xs,
+	float* ys, float* zs);
+
+/** ARM NEON version of range_row_kernel_t. Only call it if
+ * `mrpt::cpu::supports(mrpt::cpu::feature::NEON)`.
+ * \note (New in MRPT 2.4.9) */
+void range_row_kernel_NEON(
+	const int W, const uint16_t* ranges, const float rangeUnits,
+	const float* Dmin, const float* Dmax, const bool invertBetween,
+	const float* kxs, const float* kys, const float* kzs, float* D, float* xs,
+	float* ys, float* zs);
+
+/** Unprojection based on a range_row_kernel_t kernel, supporting range masks,
+ * decimation and organized point clouds, with the same output than
+ * do_project_3d_pointcloud(). */
+template <class POINTMAP>
+void do_project_3d_pointcloud_rows(
+	const int H, const int W, const float* kxs, const float* kys,
+	const float* kzs, mrpt::math::CMatrix_u16& rangeImage,
+	const float rangeUnits, mrpt::opengl::PointCloudAdapter<POINTMAP>& pca,
+	std::vector<uint16_t>& idxs_x, std::vector<uint16_t>& idxs_y,
+	const mrpt::obs::TRangeImageFilterParams& fp, bool MAKE_ORGANIZED,
+	const int DECIM, range_row_kernel_t kernel);
+
 template <typename POINTMAP>
 inline void range2XYZ_LUT(
 	mrpt::opengl::PointCloudAdapter<POINTMAP>& pca,
@@ -77,16 +151,27 @@ inline void range2XYZ_LUT(
 		? &src_obs.rangeImage
 		: &src_obs.rangeImageOtherLayers.at(pp.layer);
 
+	if (pp.USE_SSE2 && mrpt::cpu::supports(mrpt::cpu::feature::AVX2))
+		do_project_3d_pointcloud_rows(
+			H, W, kxs, kys, kzs, *ri, src_obs.rangeUnits, pca,
+			src_obs.points3D_idxs_x, src_obs.points3D_idxs_y, fp,
+			pp.MAKE_ORGANIZED, DECIM, &range_row_kernel_AVX2);
+	else if (pp.USE_SSE2 && mrpt::cpu::supports(mrpt::cpu::feature::NEON))
+		do_project_3d_pointcloud_rows(
+			H, W, kxs, kys, kzs, *ri, src_obs.rangeUnits, pca,
+			src_obs.points3D_idxs_x, src_obs.points3D_idxs_y, fp,
+			pp.MAKE_ORGANIZED, DECIM, &range_row_kernel_NEON);
 #if MRPT_HAS_SSE2
 	// if image width is not 8*N, use standard method
-	if ((W & 0x07) == 0 && pp.USE_SSE2 && DECIM == 1 &&
+	else if (
+		(W & 0x07) == 0 && pp.USE_SSE2 && DECIM == 1 &&
 		mrpt::cpu::supports(mrpt::cpu::feature::SSE2))
 		do_project_3d_pointcloud_SSE2(
 			H, W, kxs, kys, kzs, *ri, src_obs.rangeUnits, pca,
 			src_obs.points3D_idxs_x, src_obs.points3D_idxs_y, fp,
 			pp.MAKE_ORGANIZED);
-	else
 #endif
+	else
 		do_project_3d_pointcloud(
 			H, W, kxs, kys, kzs, *ri, src_obs.rangeUnits, pca,
 			src_obs.points3D_idxs_x, src_obs.points3D_idxs_y, fp,
@@ -416,6 +501,104 @@ inline void do_project_3d_pointcloud(
 	idxs_y.resize(idx);
 }
 
+template <class POINTMAP>
+inline void do_project_3d_pointcloud_rows(
+	const int H, const int W, const float* kxs, const float* kys,
+	const float* kzs, mrpt::math::CMatrix_u16& rangeImage,
+	const float rangeUnits, mrpt::opengl::PointCloudAdapter<POINTMAP>& pca,
+	std::vector<uint16_t>& idxs_x, std::vector<uint16_t>& idxs_y,
+	const mrpt::obs::TRangeImageFilterParams& fp, bool MAKE_ORGANIZED,
+	const int DECIM, range_row_kernel_t kernel)
+{
+	const bool invertBetween = !fp.rangeCheckBetween;
+	const auto rowOf = [](const mrpt::math::CMatrixF* m, int r) {
+		return m ? &(*m)(r, 0) : nullptr;
+	};
+	// Per-row buffers, small enough to stay in the L1 cache:
+	std::vector<float> D(W);
+	size_t idx = 0;
+	if (DECIM == 1)
+	{
+		std::vector<float> xs(W), ys(W), zs(W);
+		for (int r = 0; r < H; r++)
+		{
+			const size_t off = static_cast<size_t>(r) * W;
+			kernel(
+				W, &rangeImage(r, 0), rangeUnits, rowOf(fp.rangeMask_min, r),
+				rowOf(fp.rangeMask_max, r), invertBetween, kxs + off,
+				kys + off, kzs + off, D.data(), xs.data(), ys.data(),
+				zs.data());
+			for (int c = 0; c < W; c++)
+			{
+				if (D[c] == .0f)
+				{
+					if (MAKE_ORGANIZED) pca.setInvalidPoint(idx++);
+					if (fp.mark_invalid_ranges) rangeImage.coeffRef(r, c) = 0;
+					continue;
+				}
+				pca.setPointXYZ(idx, xs[c], ys[c], zs[c]);
+				idxs_x[idx] = c;
+				idxs_y[idx] = r;
+				++idx;
+			}
+		}
+	}
+	else
+	{
+		const int Hd = H / DECIM, Wd = W / DECIM;
+		constexpr float NO_RANGE = std::numeric_limits<float>::max();
+		// Minimum valid range of each column within the current block row:
+		std::vector<float> colMinD(W);
+
+		for (int rd = 0; rd < Hd; rd++)
+		{
+			std::fill(colMinD.begin(), colMinD.end(), NO_RANGE);
+			for (int rb = 0; rb < DECIM; rb++)
+			{
+				const int r = rd * DECIM + rb;
+				kernel(
+					W, &rangeImage(r, 0), rangeUnits,
+					rowOf(fp.rangeMask_min, r), rowOf(fp.rangeMask_max, r),
+					invertBetween, nullptr, nullptr, nullptr, D.data(),
+					nullptr, nullptr, nullptr);
+				for (int c = 0; c < W; c++)
+				{
+					if (D[c] == .0f)
+					{
+						if (fp.mark_invalid_ranges)
+							rangeImage.coeffRef(r, c) = 0;
+					}
+					else if (D[c] < colMinD[c])
+						colMinD[c] = D[c];
+				}
+			}
+			for (int cd = 0; cd < Wd; cd++)
+			{
+				const float min_d = *std::min_element(
+					colMinD.begin() + cd * DECIM,
+					colMinD.begin() + (cd + 1) * DECIM);
+				if (min_d == NO_RANGE)
+				{
+					if (MAKE_ORGANIZED) pca.setInvalidPoint(idx++);
+					continue;
+				}
+				const auto eq_r = rd * DECIM + DECIM / 2,
+						   eq_c = cd * DECIM + DECIM / 2;
+				const auto eq_idx = eq_c + eq_r * W;
+				pca.setPointXYZ(
+					idx, kxs[eq_idx] * min_d, kys[eq_idx] * min_d,
+					kzs[eq_idx] * min_d);
+				idxs_x[idx] = eq_c;
+				idxs_y[idx] = eq_r;
+				++idx;
+			}
+		}
+	}
+	pca.resize(idx);
+	idxs_x.resize(idx);
+	idxs_y.resize(idx);
+}
+
 // Auxiliary functions which implement (un)projection of 3D point clouds:
 template <class POINTMAP>
 inline void do_project_3d_pointcloud_SSE2(
@@ -0,0 +1,107 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/obs/CObservation.h>
+#include <mrpt/obs/CObservationCANBusJ1939.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace mrpt::obs
+{
+/** A batch of consecutive frames received from a CAN bus, for busy buses
+ * where one CObservationCANBusJ1939 object per frame would be too expensive.
+ *
+ * Frames are stored as a structure of arrays: per-frame timestamps, CAN
+ * identifiers and data lengths, and one contiguous array with 8 bytes of
+ * payload per frame (only the first `length(i)` bytes of each are valid).
+ *
+ * Identifiers follow the SocketCAN convention: the 11 or 29 bits of the
+ * identifier, plus the flags EXTENDED_ID_FLAG, RTR_FLAG and ERROR_FLAG.
+ *
+ * CObservation::timestamp is the timestamp of the first frame.
+ *
+ * \code
+ * for (size_t i = 0; i < obs->size(); i++) {
+ *   if (obs->id(i) == ...) process(obs->payload(i), obs->length(i));
+ * }
+ * \endcode
+ *
+ * \sa CObservationCANBusJ1939, mrpt::hwdrivers::CCANBusReader
+ * \note (New in MRPT 2.4.9)
+ * \ingroup mrpt_obs_grp
+ */
+class CObservationCANBusBatch : public CObservation
+{
+	DEFINE_SERIALIZABLE(CObservationCANBusBatch, mrpt::obs)
+
+   public:
+	CObservationCANBusBatch() = default;
+	~CObservationCANBusBatch() override = default;
+
+	/** Flags in the CAN identifiers (same values than SocketCAN) */
+	static constexpr uint32_t EXTENDED_ID_FLAG = 0x80000000U;
+	static constexpr uint32_t RTR_FLAG = 0x40000000U;
+	static constexpr uint32_t ERROR_FLAG = 0x20000000U;
+	/** Maximum payload of a (classic) CAN frame */
+	static constexpr size_t MAX_PAYLOAD = 8;
+
+	/** Number of frames */
+	size_t size() const { return m_timestamps.size(); }
+	bool empty() const { return m_timestamps.empty(); }
+	/** Removes all the frames, keeping the allocated memory. */
+	void clear();
+	/** Reserves memory for `n` frames. */
+	void reserve(size_t n);
+
+	/** Appends a new frame, with `len` (up to 8) payload bytes, and returns
+	 * its index. */
+	size_t addFrame(
+		mrpt::Clock::time_point t, uint32_t canId, const uint8_t* data,
+		uint8_t len);
+
+	/** The timestamps of all the frames */
+	const std::vector<mrpt::Clock::time_point>& timestamps() const
+	{
+		return m_timestamps;
+	}
+	/** The CAN identifiers (with flags) of all the frames */
+	const std::vector<uint32_t>& ids() const { return m_ids; }
+	/** The data lengths of all the frames */
+	const std::vector<uint8_t>& lengths() const { return m_lengths; }
+
+	uint32_t id(size_t i) const { return m_ids.at(i); }
+	uint8_t length(size_t i) const { return m_lengths.at(i); }
+	/** The payload of frame `i` (`length(i)` valid bytes) */
+	const uint8_t* payload(size_t i) const
+	{
+		return &m_payloads.at(i * MAX_PAYLOAD);
+	}
+
+	/** Returns frame `i` as a J1939 observation, decoding its 29-bit
+	 * identifier as in CObservationCANBusJ1939::setFromCANFrame() */
+	void getFrame(size_t i, CObservationCANBusJ1939& out) const;
+
+	/** Not used */
+	void getSensorPose(mrpt::poses::CPose3D&) const override {}
+	void setSensorPose(const mrpt::poses::CPose3D&) override {}
+	// See base class docs
+	void getDescriptionAsText(std::ostream& o) const override;
+
+   private:
+	std::vector<mrpt::Clock::time_point> m_timestamps;
+	std::vector<uint32_t> m_ids;
+	std::vector<uint8_t> m_lengths;
+	/** MAX_PAYLOAD bytes per frame */
+	std::vector<uint8_t> m_payloads;
+
+};	// End of class def.
+
+}  // namespace mrpt::obs
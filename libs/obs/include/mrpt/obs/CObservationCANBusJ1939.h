@@ -54,6 +54,13 @@ class CObservationCANBusJ1939 : public CObservation
 	/** The ASCII frame */
 	std::vector<char> m_raw_frame;
 
+	/** Fills the J1939 fields from a frame with a 29-bit identifier
+	 * `canId` (with optional SocketCAN flags in its upper bits) and `len`
+	 * (up to 8) bytes of data. m_raw_frame is left empty.
+	 * 
+ote (New in MRPT 2.4.9) */
+	void setFromCANFrame(uint32_t canId, const uint8_t* data, uint8_t len);
+
 	/** Not used */
 	void getSensorPose(mrpt::poses::CPose3D&) const override {}
 	void setSensorPose(const mrpt::poses::CPose3D&) override {}
@@ -0,0 +1,148 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/obs/CObservation.h>
+#include <mrpt/obs/CObservationIMU.h>
+#include <mrpt/poses/CPose3D.h>
+
+#include <array>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace mrpt::obs
+{
+/** A batch of consecutive samples from an Inertial Measurement Unit (IMU), for
+ * high-rate sensors where one CObservationIMU object per sample would be too
+ * expensive.
+ *
+ * Samples are stored as a structure of arrays: one vector of per-sample
+ * timestamps, and one contiguous vector of values per data field (see
+ * mrpt::obs::TIMUDataIndex for their meaning and units). Only the fields
+ * present in at least one sample have a vector, with `NaN` in the samples
+ * that lacked them.
+ *
+ * CObservation::timestamp is the timestamp of the first sample.
+ *
+ * \code
+ * auto obs = mrpt::obs::CObservationIMUBatch::Create();
+ * for (...) {
+ *   const size_t i = obs->addSample(t);
+ *   obs->set(i, mrpt::obs::IMU_WZ, wz);
+ * }
+ * // Process all the samples at once:
+ * const std::vector<double>& wz = obs->values(mrpt::obs::IMU_WZ);
+ * \endcode
+ *
+ * \sa CObservationIMU
+ * \note (New in MRPT 2.4.9)
+ * \ingroup mrpt_obs_grp
+ */
+class CObservationIMUBatch : public CObservation
+{
+	DEFINE_SERIALIZABLE(CObservationIMUBatch, mrpt::obs)
+
+   public:
+	CObservationIMUBatch();
+	~CObservationIMUBatch() override = default;
+
+	/** The pose of the sensor on the robot. */
+	mrpt::poses::CPose3D sensorPose;
+
+	/** Number of samples */
+	size_t size() const { return m_timestamps.size(); }
+	bool empty() const { return m_timestamps.empty(); }
+	/** Removes all the samples, keeping the allocated memory. */
+	void clear();
+	/** Reserves memory for `n` samples in each present field. */
+	void reserve(size_t n);
+
+	/** Appends a new sample, with all its values missing, and returns its
+	 * index. */
+	size_t addSample(mrpt::Clock::time_point t);
+
+	/** Appends a new sample with its values, the same arrays than
+	 * CObservationIMU::rawMeasurements and CObservationIMU::dataIsPresent.
+	 */
+	size_t addSample(
+		mrpt::Clock::time_point t,
+		const std::array<double, COUNT_IMU_DATA_FIELDS>& rawMeasurements,
+		const std::array<bool, COUNT_IMU_DATA_FIELDS>& dataIsPresent);
+
+	/** Appends a copy of the data in an IMU observation */
+	size_t addSample(const CObservationIMU& o)
+	{
+		return addSample(o.timestamp, o.rawMeasurements, o.dataIsPresent);
+	}
+
+	/** Sets the value of a field in sample `i` */
+	void set(size_t i, TIMUDataIndex idx, double value)
+	{
+		auto& v = m_values.at(idx);
+		if (v.empty() && !m_timestamps.empty())
+			v.assign(m_timestamps.size(), missingValue());
+		v.at(i) = value;
+	}
+
+	/** Whether the field has values for some of the samples */
+	bool has(TIMUDataIndex idx) const { return !m_values.at(idx).empty(); }
+	/** Whether the field has a value in sample `i` */
+	bool has(size_t i, TIMUDataIndex idx) const
+	{
+		const auto& v = m_values.at(idx);
+		return !v.empty() && !std::isnan(v.at(i));
+	}
+
+	/** Returns the value of a field in sample `i`, throwing if missing. */
+	double get(size_t i, TIMUDataIndex idx) const
+	{
+		ASSERTMSG_(has(i, idx), "Trying to access non-set value");
+		return m_values[idx][i];
+	}
+
+	/** The values of a field in all the samples, or an empty vector if it is
+	 * not present in any of them. */
+	const std::vector<double>& values(TIMUDataIndex idx) const
+	{
+		return m_values.at(idx);
+	}
+	/** The timestamps of all the samples */
+	const std::vector<mrpt::Clock::time_point>& timestamps() const
+	{
+		return m_timestamps;
+	}
+
+	/** Returns sample `i` as an IMU observation */
+	void getSample(size_t i, CObservationIMU& out) const;
+
+	/** The value stored in the samples lacking a present field */
+	static double missingValue()
+	{
+		return std::numeric_limits<double>::quiet_NaN();
+	}
+
+	// See base class docs
+	void getSensorPose(mrpt::poses::CPose3D& out_sensorPose) const override
+	{
+		out_sensorPose = sensorPose;
+	}
+	void setSensorPose(const mrpt::poses::CPose3D& newSensorPose) override
+	{
+		sensorPose = newSensorPose;
+	}
+	void getDescriptionAsText(std::ostream& o) const override;
+
+   private:
+	std::vector<mrpt::Clock::time_point> m_timestamps;
+	std::array<std::vector<double>, COUNT_IMU_DATA_FIELDS> m_values;
+
+};	// End of class def.
+
+}  // namespace mrpt::obs
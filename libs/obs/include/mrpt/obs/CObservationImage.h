@@ -85,6 +85,10 @@ class CObservationImage : public CObservation
 	 * \sa load
 	 */
 	void unload() const override;
+
+	/** Starts loading the image in the background, if externally stored.
+	 * \sa load */
+	void prefetch() const override;
 	/** @} */
 
 };	// End of class def.
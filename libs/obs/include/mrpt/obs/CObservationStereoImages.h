@@ -127,6 +127,8 @@ class CObservationStereoImages : public mrpt::obs::CObservation
 	void swap(CObservationStereoImages& o);
 
 	void load() const override;
+	void unload() const override;
+	void prefetch() const override;
 
 };	// End of class def.
 
@@ -9,6 +9,7 @@
 #pragma once
 
 #include <mrpt/core/reverse_bytes.h>
+#include <mrpt/math/TPointCloudView.h>
 #include <mrpt/obs/CObservation.h>
 #include <mrpt/obs/CSinCosLookUpTableFor2DScans.h>
 #include <mrpt/obs/VelodyneCalibration.h>
@@ -254,6 +255,17 @@ class CObservationVelodyneScan : public CObservation
 		void clear();
 		/** Like clear(), but also enforcing freeing memory */
 		void clear_deep();
+
+		/** Returns a non-owning view of the x,y,z and intensity vectors,
+		 * valid while this object is not modified.
+		 * \note (New in MRPT 2.4.9) */
+		mrpt::math::TPointCloudView asView() const
+		{
+			auto v = mrpt::math::TPointCloudView::FromVectors(x, y, z);
+			if (intensity.size() == x.size() && !x.empty())
+				v.intensity_u8 = intensity.data();
+			return v;
+		}
 	};
 
 	/** Optionally, raw data can be converted into a 3D point cloud (local
@@ -355,6 +367,16 @@ class CObservationVelodyneScan : public CObservation
 		const TGeneratePointCloudParameters& params =
 			TGeneratePointCloudParameters());
 
+	/** \overload Generates the point cloud into a user-provided object,
+	 * instead of \a point_cloud. Its vectors are cleared but not deallocated,
+	 * so reusing the same `dest` object for consecutive scans avoids memory
+	 * reallocations. Use TPointCloud::asView() to pass the result to
+	 * point map or rendering classes without copying it.
+	 * \note (New in MRPT 2.4.9) */
+	void generatePointCloud(
+		TPointCloud& dest, const TGeneratePointCloudParameters& params =
+							   TGeneratePointCloudParameters()) const;
+
 	/** Results for generatePointCloudAlongSE3Trajectory() */
 	struct TGeneratePointCloudSE3Results
 	{
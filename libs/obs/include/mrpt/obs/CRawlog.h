@@ -69,6 +69,9 @@ class CRawlog : public mrpt::serialization::CSerializable
 	/** Comments of the rawlog. */
 	CObservationComment m_commentTexts;
 
+	/** See setMemoryArenaChunkSize() */
+	size_t m_arenaChunkSize = 0;
+
    public:
 	CRawlog() = default;
 	virtual ~CRawlog() override = default;
@@ -135,11 +138,26 @@ class CRawlog : public mrpt::serialization::CSerializable
 	 *  - Only if `non_obs_objects_are_legal` is true, any `CSerializable`
 	 * object is allowed in the log file. Otherwise, the read stops on classes
 	 * different from the ones listed in the item above.
+	 *  - An indexed rawlog file (see CRawlogIndexedFile), automatically
+	 * detected from its header (New in MRPT 2.4.9).
 	 * \returns It returns false upon error reading or accessing the file.
 	 */
 	bool loadFromRawLogFile(
 		const std::string& fileName, bool non_obs_objects_are_legal = false);
 
+	/** If set to >0, loadFromRawLogFile() creates the loaded objects within
+	 * memory arenas (see mrpt::MemoryArena) of about this size in bytes,
+	 * or one arena per chunk for indexed rawlog files, instead of one heap
+	 * allocation per object. Each arena is freed at once when all its objects
+	 * are destroyed, making clear() faster and reducing heap fragmentation
+	 * in long-running processes. Note that objects kept alive (e.g. copied
+	 * out of the rawlog) keep their whole arena alive too.
+	 * Default: 0 (disabled).
+	 * \note (New in MRPT 2.4.9)
+	 */
+	void setMemoryArenaChunkSize(size_t bytes) { m_arenaChunkSize = bytes; }
+	size_t getMemoryArenaChunkSize() const { return m_arenaChunkSize; }
+
 	/** Saves the contents to a rawlog-file, compatible with RawlogViewer (As
 	 * the sequence of internal objects).
 	 *  The file is saved with gz-commpressed if MRPT has gz-streams.
@@ -148,6 +166,18 @@ class CRawlog : public mrpt::serialization::CSerializable
 	 */
 	bool saveToRawLogFile(const std::string& fileName) const;
 
+	/** Saves the contents to a chunked, indexed rawlog file, which can be
+	 * opened with random access with CRawlogIndexedFile.
+	 * \param chunkSize Approximate uncompressed size of each chunk, in bytes.
+	 * \param compress Whether to zlib-compress each chunk.
+	 * \returns false if any error is found while writing the target file.
+	 * \sa CRawlogIndexedFileWriter
+	 * \note (New in MRPT 2.4.9)
+	 */
+	bool saveToIndexedRawLogFile(
+		const std::string& fileName, size_t chunkSize = 4 * 1024 * 1024,
+		bool compress = true) const;
+
 	/** Returns the number of actions / observations object in the sequence. */
 	size_t size() const;
 
@@ -201,6 +231,14 @@ class CRawlog : public mrpt::serialization::CSerializable
 	 */
 	CObservation::Ptr getAsObservation(size_t index) const;
 
+	/** Hints that the observations in entries `[first, first+count)` will be
+	 * needed soon, so their externally-stored images start being decoded in
+	 * background threads (see CObservation::prefetch()). Indices beyond the
+	 * end are ignored.
+	 * \note (New in MRPT 2.4.9)
+	 */
+	void prefetchExternalImages(size_t first, size_t count) const;
+
 	/** Get the i'th observation as an observation of the given type.
 	 * \exception std::exception If index is out of bounds, or type not
 	 * compatible.
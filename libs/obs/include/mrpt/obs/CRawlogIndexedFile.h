@@ -0,0 +1,267 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/core/Clock.h>
+#include <mrpt/core/MemoryArena.h>
+#include <mrpt/core/WorkerThreadsPool.h>
+#include <mrpt/io/CFileOutputStream.h>
+#include <mrpt/io/CMemoryStream.h>
+#include <mrpt/serialization/CSerializable.h>
+
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace mrpt::obs
+{
+/** Information stored in the index of a CRawlogIndexedFile for each entry.
+ * \ingroup mrpt_obs_grp */
+struct TRawlogIndexEntry
+{
+	/** Index of the chunk holding this entry */
+	uint32_t chunk = 0;
+	/** Offset and length of the serialized object within the uncompressed
+	 * chunk */
+	uint32_t offsetInChunk = 0, length = 0;
+	/** Timestamp of the observation, of the first observation in a
+	 * CSensoryFrame, or of the first action in a CActionCollection.
+	 * INVALID_TIMESTAMP for other classes. */
+	mrpt::Clock::time_point timestamp;
+	/** Name of the object class (e.g. "mrpt::obs::CObservation2DRangeScan") */
+	std::string className;
+	/** Sensor label, for observations. Empty otherwise */
+	std::string sensorLabel;
+};
+
+/** Writes rawlog entries (observations, actions, sensory frames) into a
+ * chunked, indexed rawlog file, which can be later opened with random access
+ * via CRawlogIndexedFile.
+ *
+ * Entries are serialized into chunks of approximately `chunkSize` bytes,
+ * each one optionally compressed independently with zlib. On close(), an index
+ * with the class name, sensor label, timestamp and location of every entry is
+ * appended to the end of the file.
+ *
+ * \code
+ * CRawlogIndexedFileWriter w;
+ * w.open("dataset.rawlogx");
+ * for (...) w.write(obs);
+ * w.close();
+ * \endcode
+ *
+ * \sa CRawlogIndexedFile, CRawlog
+ * \note (New in MRPT 2.4.9)
+ * \ingroup mrpt_obs_grp
+ */
+class CRawlogIndexedFileWriter
+{
+   public:
+	CRawlogIndexedFileWriter() = default;
+	~CRawlogIndexedFileWriter();
+
+	/** Target (uncompressed) size of each chunk, in bytes (Default=4 MiB).
+	 * Smaller chunks mean faster random accesses, larger ones better
+	 * compression ratios. */
+	size_t chunkSize = 4 * 1024 * 1024;
+	/** Whether to compress chunks with zlib (Default=true) */
+	bool compressChunks = true;
+	/** Threads compressing chunks in the background, while write() goes on
+	 * with the next ones (Default=1: compress in the calling thread; 0: as
+	 * many as hardware threads). Chunks are stored in order anyway. Read in
+	 * open(). */
+	size_t numThreads = 1;
+
+	/** Creates the output file. \return false on error */
+	bool open(const std::string& fileName);
+	bool is_open() const { return m_f.fileOpenCorrectly(); }
+
+	/** Appends one object at the end of the dataset.
+	 * \exception std::exception If the file is not open, or the object is
+	 * larger than 4 GiB.
+	 */
+	void write(const mrpt::serialization::CSerializable& obj);
+	/// \overload
+	void write(const mrpt::serialization::CSerializable::Ptr& obj)
+	{
+		ASSERT_(obj);
+		write(*obj);
+	}
+
+	/** Flushes pending data, writes the index and closes the file. Called
+	 * automatically from the destructor. */
+	void close();
+
+	/** Number of objects written so far */
+	size_t size() const { return m_index.size(); }
+
+   private:
+	mrpt::io::CFileOutputStream m_f;
+	mrpt::io::CMemoryStream m_curChunk;
+
+	struct TChunkInfo
+	{
+		uint64_t fileOffset = 0;
+		uint32_t storedLength = 0, rawLength = 0;
+		uint8_t compressed = 0;
+	};
+	std::vector<TChunkInfo> m_chunks;
+	std::vector<TRawlogIndexEntry> m_index;
+
+	/** A chunk ready to be stored: compressed or not */
+	struct TStoredChunk
+	{
+		TChunkInfo info;
+		std::vector<unsigned char> data;
+	};
+	static TStoredChunk CompressChunk(
+		std::vector<unsigned char>&& raw, bool compress);
+
+	std::unique_ptr<mrpt::WorkerThreadsPool> m_pool;
+	/** Chunks being compressed by m_pool, in file order */
+	std::deque<std::future<TStoredChunk>> m_pendingChunks;
+	size_t m_maxPendingChunks = 0;
+	/** Chunks written plus pending ones */
+	size_t m_chunkCount = 0;
+
+	void flushChunk();
+	void storeChunk(TStoredChunk&& c);
+	/** Stores the pending chunks already compressed, or all if `all` */
+	void storePendingChunks(bool all);
+};
+
+/** Read-only, random access to chunked indexed rawlog files, as generated by
+ * CRawlogIndexedFileWriter or CRawlog::saveToIndexedRawLogFile().
+ *
+ * Only the index is loaded upon open(). The file contents are memory-mapped
+ * (if the OS supports it, falling back to regular file reads otherwise), and
+ * each entry is deserialized on demand by getEntry(), decompressing only the
+ * chunk it belongs to. The last decompressed chunk is cached, so sequential
+ * reads are efficient.
+ *
+ * Entries can be located by index in O(1) and by timestamp in O(log N), via
+ * findByTimestamp().
+ *
+ * \code
+ * CRawlogIndexedFile f;
+ * if (!f.open("dataset.rawlogx")) throw std::runtime_error("error");
+ * const size_t i = f.findByTimestamp(t);
+ * auto obj = f.getEntry(i);
+ * \endcode
+ *
+ * <b>File format</b>: A 16 bytes header (magic string `MRPT-RLX`, format
+ * version), followed by a sequence of chunks (each a concatenation of
+ * serialized objects, zlib-compressed or not), the index, and a 16 bytes
+ * trailer with the file offset of the index and the magic string `RLX-INDX`.
+ *
+ * All public methods are thread-safe.
+ *
+ * \sa CRawlogIndexedFileWriter, CRawlog
+ * \note (New in MRPT 2.4.9)
+ * \ingroup mrpt_obs_grp
+ */
+class CRawlogIndexedFile
+{
+   public:
+	CRawlogIndexedFile();
+	~CRawlogIndexedFile();
+
+	CRawlogIndexedFile(const CRawlogIndexedFile&) = delete;
+	CRawlogIndexedFile& operator=(const CRawlogIndexedFile&) = delete;
+
+	/** Returns true if the given file exists and is in the indexed rawlog
+	 * format, by checking its header magic string. */
+	static bool IsIndexedRawlogFile(const std::string& fileName);
+
+	/** Opens an indexed rawlog and loads its index.
+	 * \return false on any error (file not found, wrong format, corrupted
+	 * index). */
+	bool open(const std::string& fileName);
+	bool is_open() const;
+	void close();
+
+	/** If enabled, all objects returned by getEntry() from the same chunk are
+	 * allocated within one shared memory arena (see mrpt::MemoryArena),
+	 * which is freed at once when all of them are destroyed.
+	 * Default: false.
+	 * \sa CRawlog::setMemoryArenaChunkSize()
+	 */
+	void setUseMemoryArenas(bool enable) { m_useArenas = enable; }
+	bool getUseMemoryArenas() const { return m_useArenas; }
+
+	/** Number of entries in the dataset */
+	size_t size() const { return m_index.size(); }
+	bool empty() const { return m_index.empty(); }
+
+	/** Index information of the i-th entry (0-based), without loading it */
+	const TRawlogIndexEntry& getEntryInfo(size_t i) const
+	{
+		return m_index.at(i);
+	}
+
+	/** Deserializes and returns the i-th entry (0-based).
+	 * \exception std::exception On out of range index or corrupted data. */
+	mrpt::serialization::CSerializable::Ptr getEntry(size_t i) const;
+
+	/** Type-safe version of getEntry()
+	 * \exception std::exception If the entry is not of class T or derived. */
+	template <class T>
+	typename T::Ptr getEntryAs(size_t i) const
+	{
+		auto o = std::dynamic_pointer_cast<T>(getEntry(i));
+		ASSERTMSG_(o, "Rawlog entry is not of the expected class");
+		return o;
+	}
+
+	/** Returns the index of the first entry (in timestamp order) whose
+	 * timestamp is >= `t`, or size() if there is none. Entries without a valid
+	 * timestamp are never returned. Complexity is O(log N).
+	 */
+	size_t findByTimestamp(const mrpt::Clock::time_point& t) const;
+
+	/** Returns the indices of all entries sorted by ascending timestamp
+	 * (excluding those without a valid timestamp). */
+	const std::vector<size_t>& entriesByTimestamp() const { return m_byTime; }
+
+   private:
+	struct Impl;
+	std::unique_ptr<Impl> m_impl;
+
+	struct TChunkInfo
+	{
+		uint64_t fileOffset = 0;
+		uint32_t storedLength = 0, rawLength = 0;
+		uint8_t compressed = 0;
+	};
+	std::vector<TChunkInfo> m_chunks;
+	std::vector<TRawlogIndexEntry> m_index;
+	/** Entry indices, sorted by timestamp */
+	std::vector<size_t> m_byTime;
+
+	mutable std::mutex m_cacheMtx;
+	mutable size_t m_cachedChunk = 0;
+	mutable bool m_cachedChunkValid = false;
+	mutable std::vector<uint8_t> m_cachedChunkData;
+
+	bool m_useArenas = false;
+	/** Arena for the objects of chunk `m_arenaChunk` (if m_useArenas) */
+	mutable mrpt::MemoryArena::Ptr m_arena;
+	mutable size_t m_arenaChunk = 0;
+
+	/** Copies `len` bytes from the file at `offset`, or returns a pointer to
+	 * the mapped memory if available (in which case `buf` is unused). */
+	const uint8_t* readBytes(
+		uint64_t offset, size_t len, std::vector<uint8_t>& buf) const;
+};
+
+}  // namespace mrpt::obs
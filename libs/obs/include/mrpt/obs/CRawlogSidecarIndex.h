@@ -0,0 +1,163 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/core/Clock.h>
+#include <mrpt/io/CStream.h>
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace mrpt::obs
+{
+/** One top-level object (an "entry") of a rawlog file, in a
+ * CRawlogSidecarIndex.
+ * \ingroup mrpt_obs_grp */
+struct TRawlogSidecarEntry
+{
+	/** Offset of the serialized object in the (uncompressed) rawlog stream */
+	uint64_t offset = 0;
+	/** Timestamp of the observation, of the first observation in a
+	 * CSensoryFrame, or of the first action in a CActionCollection.
+	 * INVALID_TIMESTAMP for other classes. */
+	mrpt::Clock::time_point timestamp;
+	/** Name of the object class (e.g. "mrpt::obs::CSensoryFrame") */
+	std::string className;
+};
+
+/** One observation of a rawlog file, either a top-level object or within a
+ * CSensoryFrame, in a CRawlogSidecarIndex.
+ * \ingroup mrpt_obs_grp */
+struct TRawlogSidecarObservation
+{
+	/** Index of the entry holding this observation */
+	uint64_t entry = 0;
+	mrpt::Clock::time_point timestamp;
+	std::string className;
+	std::string sensorLabel;
+};
+
+/** An index of a regular (gz or zstd compressed, or plain) rawlog file, stored
+ * in a small "sidecar" file next to it (see SidecarFileName()), so dataset
+ * summaries (number of entries, sensors, time ranges) and seeking to an entry
+ * do not require deserializing the whole dataset.
+ *
+ * The index holds the offset, timestamp and class of each top-level object
+ * (an "entry"), and the timestamp, class and sensor label of each
+ * observation. It is generated with build(), which parses the rawlog once,
+ * and is only loaded by load() if the rawlog file size and modification time
+ * match the ones stored in the sidecar.
+ *
+ * \code
+ * CRawlogSidecarIndex idx;
+ * idx.loadOrBuild("dataset.rawlog");  // parses the file only once
+ * mrpt::io::CFileGZInputStream f("dataset.rawlog");
+ * const size_t first = idx.skipToEntry(f, idx.findEntryByTimestamp(t));
+ * \endcode
+ *
+ * \sa CRawlogIndexedFile, for random access to chunked rawlogs
+ * \note (New in MRPT 2.4.9)
+ * \ingroup mrpt_obs_grp
+ */
+class CRawlogSidecarIndex
+{
+   public:
+	CRawlogSidecarIndex() = default;
+
+	/** The sidecar file of a rawlog: `<rawlogFile>.idx` */
+	static std::string SidecarFileName(const std::string& rawlogFile)
+	{
+		return rawlogFile + ".idx";
+	}
+
+	/** Loads the sidecar of a rawlog file.
+	 * \return false if it does not exist, is corrupted, or is outdated with
+	 * respect to the rawlog file. */
+	bool load(const std::string& rawlogFile);
+
+	/** Parses the whole rawlog file to generate the index.
+	 * \exception std::exception If the file cannot be opened or parsed. */
+	void build(const std::string& rawlogFile);
+
+	/** Writes the sidecar file of the last rawlog built or loaded.
+	 * \return false on error (e.g. a read-only directory) */
+	bool save() const;
+
+	/** Loads the sidecar or, if not available, builds the index and
+	 * (optionally) saves it.
+	 * \exception std::exception If the rawlog cannot be opened or parsed. */
+	void loadOrBuild(const std::string& rawlogFile, bool saveIfBuilt = true);
+
+	/** Clears the index */
+	void clear();
+
+	/** Rawlog file of the last build() or load() */
+	const std::string& rawlogFile() const { return m_rawlogFile; }
+
+	/** Size of the rawlog file (bytes, compressed) */
+	uint64_t fileSize() const { return m_fileSize; }
+	/** Size of the uncompressed rawlog stream (bytes) */
+	uint64_t uncompressedSize() const { return m_uncompressedSize; }
+
+	/** Top-level objects, in file order */
+	const std::vector<TRawlogSidecarEntry>& entries() const
+	{
+		return m_entries;
+	}
+	/** Observations, in file order */
+	const std::vector<TRawlogSidecarObservation>& observations() const
+	{
+		return m_observations;
+	}
+
+	/** Summary of all the observations with one sensor label */
+	struct TSensorSummary
+	{
+		TSensorSummary() = default;
+
+		std::string className;
+		size_t count = 0;
+		/** Timestamps of the first and last observation, in file order */
+		mrpt::Clock::time_point first, last;
+	};
+	/** Summary of observations for each sensor label */
+	std::map<std::string, TSensorSummary> sensorSummary() const;
+
+	/** Earliest and latest valid timestamp of all observations and actions
+	 * (INVALID_TIMESTAMP if there is none) */
+	mrpt::Clock::time_point firstTimestamp() const { return m_firstTime; }
+	mrpt::Clock::time_point lastTimestamp() const { return m_lastTime; }
+
+	/** Returns the first entry with a timestamp >= `t` (either its own, or
+	 * that of any of its observations), or entries().size() if there is
+	 * none. */
+	size_t findEntryByTimestamp(const mrpt::Clock::time_point& t) const;
+
+	/** Advances a stream, just opened at the beginning of the rawlog, to the
+	 * given entry, by reading and discarding data, which is much faster than
+	 * deserializing it. If `entry` is a CSensoryFrame preceded by its
+	 * CActionCollection, the stream is advanced to the latter instead.
+	 * \return The index of the entry the stream is left at.
+	 * \exception std::exception If the stream ends prematurely. */
+	size_t skipToEntry(mrpt::io::CStream& in, size_t entry) const;
+
+   private:
+	std::string m_rawlogFile;
+	uint64_t m_fileSize = 0, m_uncompressedSize = 0;
+	int64_t m_fileTime = 0;
+	std::vector<TRawlogSidecarEntry> m_entries;
+	std::vector<TRawlogSidecarObservation> m_observations;
+	mrpt::Clock::time_point m_firstTime, m_lastTime;
+
+	void updateTimeRange();
+};
+
+}  // namespace mrpt::obs
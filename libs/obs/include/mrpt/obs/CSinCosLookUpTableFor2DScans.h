@@ -12,6 +12,7 @@
 #include <mrpt/obs/T2DScanProperties.h>
 
 #include <map>
+#include <memory>
 #include <mutex>
 
 namespace mrpt::obs
@@ -22,6 +23,11 @@ class CObservation2DRangeScan;
 /** A smart look-up-table (LUT) of sin/cos values for 2D laser scans.
  *  Refer to the main method CSinCosLookUpTableFor2DScans::getSinCosForScan()
  *
+ *  Tables are computed only once per process and shared by all the objects
+ *  of this class, see getSharedSinCosForScan(). Looking up tables already
+ *  computed takes no lock, so this is cheap and safe to use from many
+ *  threads.
+ *
  *  This class is used in mrpt::maps::CPointsMap
  * \ingroup mrpt_obs_grp
  */
@@ -36,7 +42,9 @@ class CSinCosLookUpTableFor2DScans
 		return *this;
 	}
 
-	/** A pair of vectors with the cos and sin values. */
+	/** A pair of vectors with the cos and sin values, that is, the x and y
+	 * coordinates of the unit direction vector of each ray. Both are
+	 * SIMD-aligned and have room for 4 extra values at the end. */
 	struct TSinCosValues
 	{
 		mrpt::math::CVectorFloat ccos, csin;
@@ -60,10 +68,20 @@ class CSinCosLookUpTableFor2DScans
 	const TSinCosValues& getSinCosForScan(
 		const T2DScanProperties& scan_prop) const;
 
+	/** Returns the sin/cos tables for the given scan properties from the
+	 * process-wide cache, computing them only the first time. Tables are
+	 * never modified once computed, and remain valid while the returned
+	 * pointer is held. This method is thread-safe.
+	 * \note (New in MRPT 2.4.9) */
+	static std::shared_ptr<const TSinCosValues> getSharedSinCosForScan(
+		const T2DScanProperties& scan_prop);
+
    private:
-	/** The cache of known scans and their sin/cos tables. */
-	mutable std::map<T2DScanProperties, TSinCosValues> m_cache;
-	mutable std::recursive_mutex m_cache_mtx;
+	/** The tables used by this object, kept alive for the references
+	 * returned by getSinCosForScan(). */
+	mutable std::map<T2DScanProperties, std::shared_ptr<const TSinCosValues>>
+		m_cache;
+	mutable std::mutex m_cache_mtx;
 };
 
 }  // namespace mrpt::obs
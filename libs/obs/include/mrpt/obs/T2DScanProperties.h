@@ -8,6 +8,8 @@
    +------------------------------------------------------------------------+ */
 #pragma once
 
+#include <cstddef>
+
 namespace mrpt::obs
 {
 /** Auxiliary struct that holds all the relevant *geometry* information about a
@@ -31,7 +31,8 @@ struct T3DPointsProjectionParams
 	/** (Default: none) Read takeIntoAccountSensorPoseOnRobot */
 	std::optional<mrpt::poses::CPose3D> robotPoseInTheWorld = std::nullopt;
 
-	/** (Default:true) If possible, use SSE2 optimized code. */
+	/** (Default:true) If possible, use SIMD optimized code (SSE2, AVX2 or
+	 * NEON, selected at run time). */
 	bool USE_SSE2 = true;
 
 	/** (Default:false) set to true if you want an organized point cloud */
@@ -27,6 +27,7 @@ class CObservationStereoImages;
 class CObservationGPS;
 class CObservationPointCloud;
 class CObservationIMU;
+class CObservationIMUBatch;
 }  // namespace obs
 namespace maps
 {
@@ -696,6 +696,97 @@ void CActionRobotMovement2D::fastDrawSingleSample_modelThrun(
 	drawSingleSample_modelThrun(outSample);
 }
 
+/*---------------------------------------------------------------
+				drawManySamples
+  ---------------------------------------------------------------*/
+void CActionRobotMovement2D::drawManySamples(
+	size_t N, std::vector<mrpt::math::TPose2D>& outSamples) const
+{
+	MRPT_START
+
+	outSamples.resize(N);
+	if (!N) return;
+	auto& rnd = getRandomGenerator();
+
+	if (estimationMethod == emOdometry &&
+		motionModelConfiguration.modelSelection == mmThrun)
+	{
+		// Same model than drawSingleSample_modelThrun(), with the constant
+		// terms computed only once:
+		const auto& thrun = motionModelConfiguration.thrunModel;
+		const auto& odo = rawOdometryIncrementReading;
+		const double Arot1 =
+			(odo.y() != 0 || odo.x() != 0) ? atan2(odo.y(), odo.x()) : 0;
+		const double Atrans = odo.norm();
+		const double Arot2 = math::wrapToPi(odo.phi() - Arot1);
+
+		const double std_rot1 = thrun.alfa1_rot_rot * fabs(Arot1) +
+			thrun.alfa2_rot_trans * Atrans;
+		const double std_trans = thrun.alfa3_trans_trans * Atrans +
+			thrun.alfa4_trans_rot * (fabs(Arot1) + fabs(Arot2));
+		const double std_rot2 = thrun.alfa1_rot_rot * fabs(Arot2) +
+			thrun.alfa2_rot_trans * Atrans;
+		const double std_xy = thrun.additional_std_XY;
+		const double std_phi = thrun.additional_std_phi;
+
+		std::vector<double> z(6 * N);
+		rnd.fillGaussian(z);
+		for (size_t i = 0; i < N; i++)
+		{
+			const double* zi = &z[6 * i];
+			const double rot1 = Arot1 - std_rot1 * zi[0];
+			const double trans = Atrans - std_trans * zi[1];
+			const double rot2 = Arot2 - std_rot2 * zi[2];
+
+			auto& p = outSamples[i];
+			p.x = trans * cos(rot1) + std_xy * zi[3];
+			p.y = trans * sin(rot1) + std_xy * zi[4];
+			p.phi = math::wrapToPi(rot1 + rot2 + std_phi * zi[5]);
+		}
+		return;
+	}
+
+	ASSERT_(poseChange);
+	const auto* gPdf = dynamic_cast<const CPosePDFGaussian*>(poseChange.get());
+	if (!gPdf)
+	{
+		// Any other PDF: draw one by one.
+		CPose2D p;
+		for (auto& s : outSamples)
+		{
+			poseChange->drawSingleSample(p);
+			s = p.asTPose();
+		}
+		return;
+	}
+
+	// Gaussian: cov = Z*D*Z^T, samples are mean + Z*sqrt(D)*z, z ~ N(0,I)
+	CMatrixDouble33 Z;
+	std::vector<double> eigvals;
+	gPdf->cov.eig_symmetric(Z, eigvals);
+	for (int c = 0; c < 3; c++)
+	{
+		const double s = std::sqrt(std::max(eigvals[c], 0.0));
+		for (int r = 0; r < 3; r++)
+			Z(r, c) *= s;
+	}
+	const TPose2D mean = gPdf->mean.asTPose();
+
+	std::vector<double> z(3 * N);
+	rnd.fillGaussian(z);
+	for (size_t i = 0; i < N; i++)
+	{
+		const double* zi = &z[3 * i];
+		auto& p = outSamples[i];
+		p.x = mean.x + Z(0, 0) * zi[0] + Z(0, 1) * zi[1] + Z(0, 2) * zi[2];
+		p.y = mean.y + Z(1, 0) * zi[0] + Z(1, 1) * zi[1] + Z(1, 2) * zi[2];
+		p.phi = math::wrapToPi(
+			mean.phi + Z(2, 0) * zi[0] + Z(2, 1) * zi[1] + Z(2, 2) * zi[2]);
+	}
+
+	MRPT_END
+}
+
 void CActionRobotMovement2D::getDescriptionAsText(std::ostream& o) const
 {
 	CAction::getDescriptionAsText(o);
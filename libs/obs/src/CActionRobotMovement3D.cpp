@@ -9,6 +9,7 @@
 
 #include "obs-precomp.h"  // Precompiled headers
 //
+#include <mrpt/math/wrap2pi.h>
 #include <mrpt/obs/CActionRobotMovement3D.h>
 #include <mrpt/poses/CPose3DPDFParticles.h>
 #include <mrpt/random.h>
@@ -206,6 +207,50 @@ void CActionRobotMovement3D::computeFromOdometry_model6DOF(
 	poseChange.copyFrom(*poseChangeTemp);
 }
 
+void CActionRobotMovement3D::drawManySamples(
+	size_t N, std::vector<mrpt::math::TPose3D>& outSamples) const
+{
+	MRPT_START
+
+	outSamples.resize(N);
+	if (!N) return;
+
+	// cov = Z*D*Z^T, samples are mean + Z*sqrt(D)*z, z ~ N(0,I)
+	mrpt::math::CMatrixDouble66 Z;
+	std::vector<double> eigvals;
+	poseChange.cov.eig_symmetric(Z, eigvals);
+	for (int c = 0; c < 6; c++)
+	{
+		const double s = std::sqrt(std::max(eigvals[c], 0.0));
+		for (int r = 0; r < 6; r++)
+			Z(r, c) *= s;
+	}
+	const mrpt::math::TPose3D mean = poseChange.mean.asTPose();
+
+	std::vector<double> z(6 * N);
+	getRandomGenerator().fillGaussian(z);
+	for (size_t i = 0; i < N; i++)
+	{
+		const double* zi = &z[6 * i];
+		double d[6];
+		for (int r = 0; r < 6; r++)
+		{
+			d[r] = 0;
+			for (int c = 0; c < 6; c++)
+				d[r] += Z(r, c) * zi[c];
+		}
+		auto& p = outSamples[i];
+		p.x = mean.x + d[0];
+		p.y = mean.y + d[1];
+		p.z = mean.z + d[2];
+		p.yaw = mrpt::math::wrapToPi(mean.yaw + d[3]);
+		p.pitch = mrpt::math::wrapToPi(mean.pitch + d[4]);
+		p.roll = mrpt::math::wrapToPi(mean.roll + d[5]);
+	}
+
+	MRPT_END
+}
+
 void CActionRobotMovement3D::getDescriptionAsText(std::ostream& o) const
 {
 	CAction::getDescriptionAsText(o);
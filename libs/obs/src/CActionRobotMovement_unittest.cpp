@@ -0,0 +1,115 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/obs/CActionRobotMovement2D.h>
+#include <mrpt/obs/CActionRobotMovement3D.h>
+#include <mrpt/poses/CPosePDFGaussian.h>
+#include <mrpt/random.h>
+
+using namespace mrpt::obs;
+
+TEST(CActionRobotMovement2D, drawManySamplesGaussian)
+{
+	mrpt::random::getRandomGenerator().randomize(123);
+
+	CActionRobotMovement2D act;
+	CActionRobotMovement2D::TMotionModelOptions opts;
+	opts.modelSelection = CActionRobotMovement2D::mmGaussian;
+	act.computeFromOdometry(mrpt::poses::CPose2D(0.5, 0.1, 0.2), opts);
+
+	const auto& pdf =
+		dynamic_cast<const mrpt::poses::CPosePDFGaussian&>(*act.poseChange);
+
+	const size_t N = 20000;
+	std::vector<mrpt::math::TPose2D> samples;
+	act.drawManySamples(N, samples);
+	ASSERT_EQ(samples.size(), N);
+
+	mrpt::math::CMatrixDouble33 cov;
+	double m[3] = {0, 0, 0};
+	for (const auto& s : samples)
+		for (int k = 0; k < 3; k++)
+			m[k] += s[k] / N;
+	for (const auto& s : samples)
+		for (int r = 0; r < 3; r++)
+			for (int c = 0; c < 3; c++)
+				cov(r, c) += (s[r] - m[r]) * (s[c] - m[c]) / N;
+
+	for (int k = 0; k < 3; k++)
+	{
+		EXPECT_NEAR(m[k], pdf.mean.asTPose()[k], 0.01);
+		for (int c = 0; c < 3; c++)
+			EXPECT_NEAR(cov(k, c), pdf.cov(k, c), 0.1 * pdf.cov(k, k));
+	}
+}
+
+TEST(CActionRobotMovement2D, drawManySamplesThrun)
+{
+	mrpt::random::getRandomGenerator().randomize(123);
+
+	CActionRobotMovement2D act;
+	CActionRobotMovement2D::TMotionModelOptions opts;
+	opts.modelSelection = CActionRobotMovement2D::mmThrun;
+	const mrpt::poses::CPose2D odo(0.5, 0.1, 0.2);
+	act.computeFromOdometry(odo, opts);
+
+	const size_t N = 20000;
+	std::vector<mrpt::math::TPose2D> samples;
+	act.drawManySamples(N, samples);
+	ASSERT_EQ(samples.size(), N);
+
+	// Compare against the one-by-one sampler:
+	double m1[3] = {0, 0, 0}, m2[3] = {0, 0, 0};
+	mrpt::poses::CPose2D p;
+	for (size_t i = 0; i < N; i++)
+	{
+		act.drawSingleSample(p);
+		for (int k = 0; k < 3; k++)
+		{
+			m1[k] += samples[i][k] / N;
+			m2[k] += p.asTPose()[k] / N;
+		}
+	}
+	for (int k = 0; k < 3; k++)
+	{
+		EXPECT_NEAR(m1[k], odo.asTPose()[k], 0.01);
+		EXPECT_NEAR(m1[k], m2[k], 0.01);
+	}
+}
+
+TEST(CActionRobotMovement3D, drawManySamples)
+{
+	mrpt::random::getRandomGenerator().randomize(123);
+
+	CActionRobotMovement3D act;
+	act.poseChange.mean = mrpt::poses::CPose3D(1, 2, 0.5, 0.3, -0.1, 0.05);
+	act.poseChange.cov.setDiagonal(std::vector<double>(
+		{0.01, 0.02, 0.03, 0.001, 0.002, 0.003}));
+
+	const size_t N = 20000;
+	std::vector<mrpt::math::TPose3D> samples;
+	act.drawManySamples(N, samples);
+	ASSERT_EQ(samples.size(), N);
+
+	double m[6] = {0, 0, 0, 0, 0, 0}, v[6] = {0, 0, 0, 0, 0, 0};
+	for (const auto& s : samples)
+		for (int k = 0; k < 6; k++)
+			m[k] += s[k] / N;
+	for (const auto& s : samples)
+		for (int k = 0; k < 6; k++)
+			v[k] += mrpt::square(s[k] - m[k]) / N;
+
+	const auto mean = act.poseChange.mean.asTPose();
+	for (int k = 0; k < 6; k++)
+	{
+		EXPECT_NEAR(m[k], mean[k], 0.01);
+		EXPECT_NEAR(v[k], act.poseChange.cov(k, k), 0.1 * v[k]);
+	}
+}
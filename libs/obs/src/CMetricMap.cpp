@@ -39,9 +39,11 @@ void CMetricMap::loadFromProbabilisticPosesAndObservations(
 	// Erase previous contents:
 	this->clear();
 
-	// Insert new content:
-	for (const auto& pair : sfSeq)
+	// Insert new content (by index, so externally stored frames are
+	// loaded on demand):
+	for (size_t i = 0; i < sfSeq.size(); i++)
 	{
+		const auto pair = sfSeq.getAsPair(i);
 		ASSERTMSG_(pair.pose, "Input map has an empty `CPose3DPDF` ptr");
 		ASSERTMSG_(pair.sf, "Input map has an empty `CSensoryFrame` ptr");
 
@@ -134,6 +136,19 @@ float CMetricMap::squareDistanceToClosestCorrespondence(
 	MRPT_END
 }
 
+void CMetricMap::squareDistanceToClosestCorrespondenceBatch(
+	const std::vector<float>& xs, const std::vector<float>& ys,
+	std::vector<float>& outSqrDists,
+	[[maybe_unused]] const TBatchQueryParams& params) const
+{
+	MRPT_START
+	ASSERT_EQUAL_(xs.size(), ys.size());
+	outSqrDists.resize(xs.size());
+	for (size_t i = 0; i < xs.size(); i++)
+		outSqrDists[i] = squareDistanceToClosestCorrespondence(xs[i], ys[i]);
+	MRPT_END
+}
+
 bool CMetricMap::canComputeObservationLikelihood(
 	const mrpt::obs::CObservation& obs) const
 {
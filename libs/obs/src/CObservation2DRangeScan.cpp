@@ -16,6 +16,9 @@
 #include <mrpt/poses/CPosePDF.h>
 #include <mrpt/serialization/CArchive.h>
 
+#include <array>
+#include <mutex>
+
 #if MRPT_HAS_MATLAB
 #include <mexplus.h>
 #endif
@@ -28,7 +31,79 @@ using namespace mrpt::math;
 // This must be added to any CSerializable class implementation file.
 IMPLEMENTS_SERIALIZABLE(CObservation2DRangeScan, CObservation, mrpt::obs)
 
-uint8_t CObservation2DRangeScan::serializeGetVersion() const { return 7; }
+// Compact ranges (version 8): one variable-length (7 bits per byte) token
+// per ray, 0 for invalid rays, or 1+zigzag(q-q_prev) with q the quantized
+// range and q_prev that of the previous valid ray.
+static void compactRangesEncode(
+	const mrpt::aligned_std_vector<float>& ranges,
+	const mrpt::aligned_std_vector<char>& valid, float resolution,
+	std::vector<uint8_t>& out)
+{
+	out.clear();
+	out.reserve(2 * ranges.size());
+	const float maxQ = 1e9f;
+	int64_t prev = 0;
+	for (size_t i = 0; i < ranges.size(); i++)
+	{
+		if (!valid[i])
+		{
+			out.push_back(0);
+			continue;
+		}
+		float q = ranges[i] / resolution;
+		if (!(q >= 0)) q = 0;  // negative or NaN
+		else if (q > maxQ)
+			q = maxQ;
+		const auto qi = static_cast<int64_t>(q + 0.5f);
+		const int64_t d = qi - prev;
+		prev = qi;
+		auto token = 1 + static_cast<uint64_t>(d >= 0 ? 2 * d : -2 * d - 1);
+		while (token >= 0x80)
+		{
+			out.push_back(static_cast<uint8_t>(token | 0x80));
+			token >>= 7;
+		}
+		out.push_back(static_cast<uint8_t>(token));
+	}
+}
+
+static void compactRangesDecode(
+	const std::vector<uint8_t>& in, float resolution,
+	mrpt::aligned_std_vector<float>& ranges,
+	mrpt::aligned_std_vector<char>& valid)
+{
+	size_t k = 0;
+	int64_t prev = 0;
+	for (size_t i = 0; i < ranges.size(); i++)
+	{
+		uint64_t token = 0;
+		for (unsigned int shift = 0;; shift += 7)
+		{
+			if (k >= in.size() || shift > 63)
+				THROW_EXCEPTION("Corrupted compact scan ranges");
+			const uint8_t b = in[k++];
+			token |= static_cast<uint64_t>(b & 0x7F) << shift;
+			if (!(b & 0x80)) break;
+		}
+		if (token == 0)
+		{
+			ranges[i] = 0;
+			valid[i] = 0;
+			continue;
+		}
+		const uint64_t z = token - 1;
+		prev += (z & 1) ? -static_cast<int64_t>(z >> 1) - 1
+						: static_cast<int64_t>(z >> 1);
+		ranges[i] = prev * resolution;
+		valid[i] = 1;
+	}
+}
+
+uint8_t CObservation2DRangeScan::serializeGetVersion() const
+{
+	// Older versions unless the new compact format is requested:
+	return compactRangeResolution > 0 ? 8 : 7;
+}
 void CObservation2DRangeScan::serializeTo(
 	mrpt::serialization::CArchive& out) const
 {
@@ -37,7 +112,15 @@ void CObservation2DRangeScan::serializeTo(
 	uint32_t N = m_scan.size();
 	out << N;
 	ASSERT_EQUAL_(m_validRange.size(), m_scan.size());
-	if (N)
+	if (compactRangeResolution > 0)
+	{
+		out << compactRangeResolution;
+		std::vector<uint8_t> buf;
+		compactRangesEncode(m_scan, m_validRange, compactRangeResolution, buf);
+		out.WriteAs<uint32_t>(buf.size());
+		if (!buf.empty()) out.WriteBuffer(buf.data(), buf.size());
+	}
+	else if (N)
 	{
 		out.WriteBufferFixEndianness(&m_scan[0], N);
 		out.WriteBuffer(&m_validRange[0], sizeof(m_validRange[0]) * N);
@@ -128,6 +211,7 @@ void CObservation2DRangeScan::serializeFrom(
 
 			deltaPitch = 0;
 			sensorLabel = "";
+			compactRangeResolution = 0;
 		}
 		break;
 
@@ -135,6 +219,7 @@ void CObservation2DRangeScan::serializeFrom(
 		case 5:
 		case 6:
 		case 7:
+		case 8:
 		{
 			uint32_t N;
 
@@ -146,10 +231,23 @@ void CObservation2DRangeScan::serializeFrom(
 
 			in >> N;
 			this->resizeScan(N);
-			if (N)
+			if (version >= 8)
 			{
-				in.ReadBufferFixEndianness(&m_scan[0], N);
-				in.ReadBuffer(&m_validRange[0], sizeof(m_validRange[0]) * N);
+				in >> compactRangeResolution;
+				std::vector<uint8_t> buf(in.ReadAs<uint32_t>());
+				if (!buf.empty()) in.ReadBuffer(buf.data(), buf.size());
+				compactRangesDecode(
+					buf, compactRangeResolution, m_scan, m_validRange);
+			}
+			else
+			{
+				compactRangeResolution = 0;
+				if (N)
+				{
+					in.ReadBufferFixEndianness(&m_scan[0], N);
+					in.ReadBuffer(
+						&m_validRange[0], sizeof(m_validRange[0]) * N);
+				}
 			}
 			in >> stdError;
 			in.ReadBufferFixEndianness(&timestamp, 1);
@@ -431,15 +529,23 @@ void internal_set_build_points_map_from_scan2D(scan2pts_functor fn)
 /*---------------------------------------------------------------
 						internal_buildAuxPointsMap
   ---------------------------------------------------------------*/
-void CObservation2DRangeScan::internal_buildAuxPointsMap(
-	const void* options) const
+const mrpt::maps::CMetricMap*
+	CObservation2DRangeScan::internal_buildAuxPointsMap(
+		const void* options) const
 {
 	if (!ptr_internal_build_points_map_from_scan2D)
 		throw std::runtime_error(
 			"[CObservation2DRangeScan::buildAuxPointsMap] ERROR: This function "
 			"needs linking against mrpt-maps.\n");
 
+	// A small pool of mutexes shared by all objects (instead of one member
+	// per object) keeps observations copyable:
+	static std::array<std::mutex, 16> mtxs;
+	const auto idx = (reinterpret_cast<std::uintptr_t>(this) / 64) % 16;
+	std::lock_guard<std::mutex> lck(mtxs[idx]);
+
 	(*ptr_internal_build_points_map_from_scan2D)(*this, m_cachedMap, options);
+	return m_cachedMap.get();
 }
 
 /** Fill out a T2DScanProperties structure with the parameters of this scan */
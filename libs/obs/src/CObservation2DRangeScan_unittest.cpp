@@ -0,0 +1,51 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/io/CMemoryStream.h>
+#include <mrpt/obs/CObservation2DRangeScan.h>
+#include <mrpt/serialization/CArchive.h>
+
+#include <cmath>
+
+TEST(CObservation2DRangeScan, compactRangesSerialization)
+{
+	using mrpt::obs::CObservation2DRangeScan;
+
+	CObservation2DRangeScan s;
+	const size_t N = 1081;
+	s.resizeScan(N);
+	for (size_t i = 0; i < N; i++)
+	{
+		s.setScanRange(i, 5.0f + 3.0f * std::sin(i * 0.01f) + (i % 7) * 1e-3f);
+		s.setScanRangeValidity(i, (i % 50) != 0);
+	}
+	s.setScanRange(10, 120.0f);	 // long ranges are not clamped
+
+	mrpt::io::CMemoryStream bufFloat, bufCompact;
+	mrpt::serialization::archiveFrom(bufFloat) << s;
+	const float res = 1e-3f;
+	s.compactRangeResolution = res;
+	mrpt::serialization::archiveFrom(bufCompact) << s;
+	EXPECT_LT(
+		bufCompact.getTotalBytesCount(), bufFloat.getTotalBytesCount() / 2);
+
+	bufCompact.Seek(0);
+	CObservation2DRangeScan s2;
+	mrpt::serialization::archiveFrom(bufCompact) >> s2;
+
+	EXPECT_EQ(s2.compactRangeResolution, res);
+	ASSERT_EQ(s2.getScanSize(), N);
+	for (size_t i = 0; i < N; i++)
+	{
+		EXPECT_EQ(s2.getScanRangeValidity(i), s.getScanRangeValidity(i));
+		if (s.getScanRangeValidity(i))
+		{ EXPECT_NEAR(s2.getScanRange(i), s.getScanRange(i), 0.51f * res); }
+	}
+}
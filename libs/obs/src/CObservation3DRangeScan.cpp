@@ -766,6 +766,12 @@ void CObservation3DRangeScan::unload() const
 	confidenceImage.unload();
 }
 
+void CObservation3DRangeScan::prefetch() const
+{
+	if (hasIntensityImage) intensityImage.prefetch();
+	if (hasConfidenceImage) confidenceImage.prefetch();
+}
+
 std::string CObservation3DRangeScan::rangeImage_getExternalStorageFile(
 	const std::string& rangeImageLayer) const
 {
@@ -1315,39 +1321,44 @@ void CObservation3DRangeScan::convertTo2DScan(
 
 		TRangeImageFilter rif(fp);
 
-		// Go thru columns, and keep the minimum distance (along the +X axis,
-		// not 3D distance!)
-		// for each direction (i.e. for each column) which also lies within the
-		// vertical FOV passed
-		// by the user.
-		for (size_t i = 0; i < nLaserRays; i++, ang += A_ang)
+		// Keep the minimum distance (along the +X axis, not 3D distance!)
+		// for each column which also lies within the vertical FOV passed by
+		// the user. This is done once per column, in a cache-friendly sweep
+		// of the rows of raw uint16 ranges, since several rays may share a
+		// column when oversampling:
+		std::vector<float> col_closest(nCols, out_scan2d.maxRange);
+		std::vector<uint8_t> col_valid(nCols, 0);
+		for (size_t r = 0; r < nRows; r++)
 		{
-			// Equivalent column in the range image for the "i'th" ray:
-			const double tan_ang = tan(ang);
-			// make sure we don't go out of range (just in case):
-			const size_t c = std::min(
-				static_cast<size_t>(std::max(0.0, cx + fx * tan_ang)),
-				nCols - 1);
-
-			bool any_valid = false;
-			float closest_range = out_scan2d.maxRange;
-
-			for (size_t r = 0; r < nRows; r++)
+			const uint16_t* row = &rangeImage(r, 0);
+			const float row_tan = vert_ang_tan[r];
+			for (size_t c = 0; c < nCols; c++)
 			{
-				const float D = rangeImage.coeff(r, c) * rangeUnits;
+				const float D = row[c] * rangeUnits;
 				if (!rif.do_range_filter(r, c, D)) continue;
 
 				// All filters passed:
-				const float this_point_tan = vert_ang_tan[r] * D;
+				const float this_point_tan = row_tan * D;
 				if (this_point_tan > tan_min && this_point_tan < tan_max)
 				{
-					any_valid = true;
-					mrpt::keep_min(closest_range, D);
+					col_valid[c] = 1;
+					mrpt::keep_min(col_closest[c], D);
 				}
 			}
+		}
+
+		for (size_t i = 0; i < nLaserRays; i++, ang += A_ang)
+		{
+			// Equivalent column in the range image for the "i'th" ray:
+			const double tan_ang = tan(ang);
+			// make sure we don't go out of range (just in case):
+			const size_t c = std::min(
+				static_cast<size_t>(std::max(0.0, cx + fx * tan_ang)),
+				nCols - 1);
 
-			if (any_valid)
+			if (col_valid[c])
 			{
+				const float closest_range = col_closest[c];
 				out_scan2d.setScanRangeValidity(i, true);
 				// Compute the distance in 2D from the "depth" in closest_range:
 				out_scan2d.setScanRange(
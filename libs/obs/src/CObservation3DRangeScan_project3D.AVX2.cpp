@@ -0,0 +1,91 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "obs-precomp.h"  // Precompiled headers
+//
+#include <mrpt/config.h>
+#include <mrpt/obs/CObservation3DRangeScan.h>
+
+// ---------------------------------------------------------------------------
+//   This file contains the AVX2 version of the range image unprojection
+//   kernel. It is built with "-mavx2" (see DeclareMRPTLib.cmake), and only
+//   called if the CPU supports AVX2.
+// ---------------------------------------------------------------------------
+#if MRPT_ARCH_INTEL_COMPATIBLE
+#include <immintrin.h>
+#endif
+
+void mrpt::obs::detail::range_row_kernel_AVX2(
+	const int W, const uint16_t* ranges, const float rangeUnits,
+	const float* Dmin, const float* Dmax, const bool invertBetween,
+	const float* kxs, const float* kys, const float* kzs, float* D, float* xs,
+	float* ys, float* zs)
+{
+	int c = 0;
+#if MRPT_ARCH_INTEL_COMPATIBLE
+	const __m256 zeros = _mm256_setzero_ps();
+	const __m256 ones = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+	const __m256 units = _mm256_set1_ps(rangeUnits);
+	const __m256 invMask = invertBetween ? ones : zeros;
+
+	// 8 pixels at a time:
+	for (; c + 8 <= W; c += 8)
+	{
+		const __m128i r16 =
+			_mm_loadu_si128(reinterpret_cast<const __m128i*>(ranges + c));
+		const __m256 d = _mm256_mul_ps(
+			_mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(r16)), units);
+
+		__m256 passGt = ones, passLt = ones, hasMin = zeros, hasMax = zeros;
+		if (Dmin)
+		{
+			const __m256 m = _mm256_loadu_ps(Dmin + c);
+			const __m256 noFilter = _mm256_cmp_ps(m, zeros, _CMP_EQ_OQ);
+			hasMin = _mm256_xor_ps(noFilter, ones);
+			passGt =
+				_mm256_or_ps(_mm256_cmp_ps(d, m, _CMP_GE_OQ), noFilter);
+		}
+		if (Dmax)
+		{
+			const __m256 m = _mm256_loadu_ps(Dmax + c);
+			const __m256 noFilter = _mm256_cmp_ps(m, zeros, _CMP_EQ_OQ);
+			hasMax = _mm256_xor_ps(noFilter, ones);
+			passLt =
+				_mm256_or_ps(_mm256_cmp_ps(d, m, _CMP_LE_OQ), noFilter);
+		}
+		// valid = d>0 && (inRange XOR (hasMin && hasMax && invertBetween))
+		const __m256 inRange = _mm256_and_ps(passGt, passLt);
+		const __m256 invert =
+			_mm256_and_ps(_mm256_and_ps(hasMin, hasMax), invMask);
+		const __m256 valid = _mm256_and_ps(
+			_mm256_cmp_ps(d, zeros, _CMP_GT_OQ),
+			_mm256_xor_ps(inRange, invert));
+
+		const __m256 dv = _mm256_and_ps(d, valid);
+		_mm256_storeu_ps(D + c, dv);
+		if (xs)
+		{
+			_mm256_storeu_ps(
+				xs + c, _mm256_mul_ps(_mm256_loadu_ps(kxs + c), dv));
+			_mm256_storeu_ps(
+				ys + c, _mm256_mul_ps(_mm256_loadu_ps(kys + c), dv));
+			_mm256_storeu_ps(
+				zs + c, _mm256_mul_ps(_mm256_loadu_ps(kzs + c), dv));
+		}
+	}
+#endif
+	// Remaining pixels:
+	if (c < W)
+		range_row_kernel_scalar(
+			W - c, ranges + c, rangeUnits, Dmin ? Dmin + c : nullptr,
+			Dmax ? Dmax + c : nullptr, invertBetween, xs ? kxs + c : nullptr,
+			xs ? kys + c : nullptr, xs ? kzs + c : nullptr, D + c,
+			xs ? xs + c : nullptr, xs ? ys + c : nullptr,
+			xs ? zs + c : nullptr);
+}
@@ -0,0 +1,86 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "obs-precomp.h"  // Precompiled headers
+//
+#include <mrpt/config.h>
+#include <mrpt/obs/CObservation3DRangeScan.h>
+
+// ---------------------------------------------------------------------------
+//   This file contains the ARM NEON version of the range image unprojection
+//   kernel. NEON is always available in aarch64, so this file needs no
+//   special build flags.
+// ---------------------------------------------------------------------------
+#if defined(__ARM_NEON) || defined(__aarch64__)
+#define MRPT_OBS_BUILD_NEON 1
+#include <arm_neon.h>
+#else
+#define MRPT_OBS_BUILD_NEON 0
+#endif
+
+void mrpt::obs::detail::range_row_kernel_NEON(
+	const int W, const uint16_t* ranges, const float rangeUnits,
+	const float* Dmin, const float* Dmax, const bool invertBetween,
+	const float* kxs, const float* kys, const float* kzs, float* D, float* xs,
+	float* ys, float* zs)
+{
+	int c = 0;
+#if MRPT_OBS_BUILD_NEON
+	const float32x4_t zeros = vdupq_n_f32(.0f);
+	const uint32x4_t ones = vdupq_n_u32(0xffffffff);
+	const uint32x4_t invMask = vdupq_n_u32(invertBetween ? 0xffffffff : 0);
+
+	// 4 pixels at a time:
+	for (; c + 4 <= W; c += 4)
+	{
+		const float32x4_t d = vmulq_n_f32(
+			vcvtq_f32_u32(vmovl_u16(vld1_u16(ranges + c))), rangeUnits);
+
+		uint32x4_t passGt = ones, passLt = ones, hasMin = vdupq_n_u32(0),
+				   hasMax = vdupq_n_u32(0);
+		if (Dmin)
+		{
+			const float32x4_t m = vld1q_f32(Dmin + c);
+			const uint32x4_t noFilter = vceqq_f32(m, zeros);
+			hasMin = vmvnq_u32(noFilter);
+			passGt = vorrq_u32(vcgeq_f32(d, m), noFilter);
+		}
+		if (Dmax)
+		{
+			const float32x4_t m = vld1q_f32(Dmax + c);
+			const uint32x4_t noFilter = vceqq_f32(m, zeros);
+			hasMax = vmvnq_u32(noFilter);
+			passLt = vorrq_u32(vcleq_f32(d, m), noFilter);
+		}
+		// valid = d>0 && (inRange XOR (hasMin && hasMax && invertBetween))
+		const uint32x4_t inRange = vandq_u32(passGt, passLt);
+		const uint32x4_t invert = vandq_u32(vandq_u32(hasMin, hasMax), invMask);
+		const uint32x4_t valid =
+			vandq_u32(vcgtq_f32(d, zeros), veorq_u32(inRange, invert));
+
+		const float32x4_t dv =
+			vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(d), valid));
+		vst1q_f32(D + c, dv);
+		if (xs)
+		{
+			vst1q_f32(xs + c, vmulq_f32(vld1q_f32(kxs + c), dv));
+			vst1q_f32(ys + c, vmulq_f32(vld1q_f32(kys + c), dv));
+			vst1q_f32(zs + c, vmulq_f32(vld1q_f32(kzs + c), dv));
+		}
+	}
+#endif
+	// Remaining pixels:
+	if (c < W)
+		range_row_kernel_scalar(
+			W - c, ranges + c, rangeUnits, Dmin ? Dmin + c : nullptr,
+			Dmax ? Dmax + c : nullptr, invertBetween, xs ? kxs + c : nullptr,
+			xs ? kys + c : nullptr, xs ? kzs + c : nullptr, D + c,
+			xs ? xs + c : nullptr, xs ? ys + c : nullptr,
+			xs ? zs + c : nullptr);
+}
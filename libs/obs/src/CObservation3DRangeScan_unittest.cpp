@@ -10,6 +10,7 @@
 #include <gtest/gtest.h>
 #include <mrpt/config.h>
 #include <mrpt/containers/copy_container_typecasting.h>
+#include <mrpt/core/cpu.h>
 #include <mrpt/io/CFileGZInputStream.h>
 #include <mrpt/maps/CSimplePointsMap.h>
 #include <mrpt/math/CHistogram.h>
@@ -19,6 +20,8 @@
 #include <mrpt/system/filesystem.h>
 #include <test_mrpt_common.h>
 
+#include <random>
+
 using namespace mrpt;
 using namespace std;
 
@@ -235,6 +238,60 @@ TEST(CObservation3DRangeScan, Project3D_filterMax)
 	}
 }
 
+TEST(CObservation3DRangeScan, Project3D_SIMDvsScalar)
+{
+	// The SIMD kernels (AVX2, NEON), if supported by this CPU, must give
+	// exactly the same points than the scalar version:
+	if (!mrpt::cpu::supports(mrpt::cpu::feature::AVX2) &&
+		!mrpt::cpu::supports(mrpt::cpu::feature::NEON))
+		return;
+
+	std::mt19937 rng(123);
+	mrpt::math::CMatrixF fMax(TEST_RANGEIMG_HEIGHT, TEST_RANGEIMG_WIDTH),
+		fMin(TEST_RANGEIMG_HEIGHT, TEST_RANGEIMG_WIDTH);
+	for (unsigned int r = 0; r < TEST_RANGEIMG_HEIGHT; r++)
+		for (unsigned int c = 0; c < TEST_RANGEIMG_WIDTH; c++)
+		{
+			fMin(r, c) = (rng() % 3 == 0) ? .0f : (rng() % 4000) * 1e-3f;
+			fMax(r, c) = (rng() % 3 == 0) ? .0f : (rng() % 4000) * 1e-3f;
+		}
+
+	for (int i = 0; i < 32; i++)  // test all combinations of flags
+	{
+		mrpt::obs::T3DPointsProjectionParams pp;
+		mrpt::obs::TRangeImageFilterParams fp;
+		pp.decimation = (i & 1) ? 2 : 1;
+		pp.MAKE_ORGANIZED = (i & 2) != 0;
+		fp.rangeCheckBetween = (i & 4) != 0;
+		if (i & 8) fp.rangeMask_min = &fMin;
+		if (i & 16) fp.rangeMask_max = &fMax;
+
+		mrpt::obs::CObservation3DRangeScan o[2];
+		for (int k = 0; k < 2; k++)
+		{
+			fillSampleObs(o[k], pp, 0);
+			pp.USE_SSE2 = (k == 1);
+			std::mt19937 rngRanges(i);
+			for (unsigned int r = 0; r < TEST_RANGEIMG_HEIGHT; r++)
+				for (unsigned int c = 0; c < TEST_RANGEIMG_WIDTH; c++)
+					o[k].rangeImage(r, c) = (rngRanges() % 4 == 0)
+						? 0
+						: static_cast<uint16_t>(rngRanges() % 4000);
+			o[k].unprojectInto(o[k], pp, fp);
+		}
+		ASSERT_EQ(o[0].points3D_x.size(), o[1].points3D_x.size())
+			<< " testcase flags: i=" << i << std::endl;
+		for (size_t j = 0; j < o[0].points3D_x.size(); j++)
+		{
+			EXPECT_EQ(o[0].points3D_x[j], o[1].points3D_x[j]);
+			EXPECT_EQ(o[0].points3D_y[j], o[1].points3D_y[j]);
+			EXPECT_EQ(o[0].points3D_z[j], o[1].points3D_z[j]);
+			EXPECT_EQ(o[0].points3D_idxs_x[j], o[1].points3D_idxs_x[j]);
+			EXPECT_EQ(o[0].points3D_idxs_y[j], o[1].points3D_idxs_y[j]);
+		}
+	}
+}
+
 TEST(CObservation3DRangeScan, LoadAndCheckFloorPoints)
 {
 	const string rawlog_fil =
@@ -0,0 +1,136 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "obs-precomp.h"  // Precompiled headers
+//
+#include <mrpt/obs/CObservationCANBusBatch.h>
+#include <mrpt/serialization/CArchive.h>
+#include <mrpt/system/datetime.h>
+
+#include <algorithm>
+#include <cstring>
+
+using namespace mrpt::obs;
+
+// This must be added to any CSerializable class implementation file.
+IMPLEMENTS_SERIALIZABLE(CObservationCANBusBatch, CObservation, mrpt::obs)
+
+void CObservationCANBusBatch::clear()
+{
+	m_timestamps.clear();
+	m_ids.clear();
+	m_lengths.clear();
+	m_payloads.clear();
+}
+
+void CObservationCANBusBatch::reserve(size_t n)
+{
+	m_timestamps.reserve(n);
+	m_ids.reserve(n);
+	m_lengths.reserve(n);
+	m_payloads.reserve(n * MAX_PAYLOAD);
+}
+
+size_t CObservationCANBusBatch::addFrame(
+	mrpt::Clock::time_point t, uint32_t canId, const uint8_t* data,
+	uint8_t len)
+{
+	ASSERT_LE_(len, MAX_PAYLOAD);
+	if (m_timestamps.empty()) timestamp = t;
+	m_timestamps.push_back(t);
+	m_ids.push_back(canId);
+	m_lengths.push_back(len);
+	const size_t off = m_payloads.size();
+	m_payloads.resize(off + MAX_PAYLOAD, 0);
+	if (len) std::memcpy(&m_payloads[off], data, len);
+	return m_timestamps.size() - 1;
+}
+
+void CObservationCANBusBatch::getFrame(
+	size_t i, CObservationCANBusJ1939& out) const
+{
+	out.timestamp = m_timestamps.at(i);
+	out.sensorLabel = sensorLabel;
+	out.setFromCANFrame(m_ids[i], payload(i), m_lengths[i]);
+}
+
+uint8_t CObservationCANBusBatch::serializeGetVersion() const { return 0; }
+void CObservationCANBusBatch::serializeTo(
+	mrpt::serialization::CArchive& out) const
+{
+	out << sensorLabel << timestamp;
+
+	const uint32_t N = static_cast<uint32_t>(m_timestamps.size());
+	out << N;
+	std::vector<int64_t> ts(N);
+	for (uint32_t i = 0; i < N; i++)
+		ts[i] = m_timestamps[i].time_since_epoch().count();
+	out.WriteBufferFixEndianness(ts.data(), ts.size());
+	out.WriteBufferFixEndianness(m_ids.data(), m_ids.size());
+	if (N)
+	{
+		out.WriteBuffer(m_lengths.data(), m_lengths.size());
+		out.WriteBuffer(m_payloads.data(), m_payloads.size());
+	}
+}
+
+void CObservationCANBusBatch::serializeFrom(
+	mrpt::serialization::CArchive& in, uint8_t version)
+{
+	switch (version)
+	{
+		case 0:
+		{
+			in >> sensorLabel >> timestamp;
+
+			const auto N = in.ReadAs<uint32_t>();
+			std::vector<int64_t> ts(N);
+			in.ReadBufferFixEndianness(ts.data(), ts.size());
+			m_timestamps.resize(N);
+			for (uint32_t i = 0; i < N; i++)
+				m_timestamps[i] =
+					mrpt::Clock::time_point(mrpt::Clock::duration(ts[i]));
+
+			m_ids.resize(N);
+			in.ReadBufferFixEndianness(m_ids.data(), m_ids.size());
+			m_lengths.resize(N);
+			m_payloads.resize(N * MAX_PAYLOAD);
+			if (N)
+			{
+				in.ReadBuffer(m_lengths.data(), m_lengths.size());
+				in.ReadBuffer(m_payloads.data(), m_payloads.size());
+			}
+		}
+		break;
+		default: MRPT_THROW_UNKNOWN_SERIALIZATION_VERSION(version);
+	};
+}
+
+void CObservationCANBusBatch::getDescriptionAsText(std::ostream& o) const
+{
+	CObservation::getDescriptionAsText(o);
+
+	o << "Number of frames: " << size() << "\n";
+	if (empty()) return;
+	o << mrpt::format(
+		"Time span: %.06f s\n",
+		mrpt::system::timeDifference(
+			m_timestamps.front(), m_timestamps.back()));
+
+	// The first frames:
+	const size_t n = std::min<size_t>(size(), 20);
+	o << "First " << n << " frames (id [length] data):\n";
+	for (size_t i = 0; i < n; i++)
+	{
+		o << mrpt::format(" 0x%08X [%u] ", m_ids[i], m_lengths[i]);
+		for (size_t k = 0; k < m_lengths[i]; k++)
+			o << mrpt::format("%02X ", payload(i)[k]);
+		o << "\n";
+	}
+}
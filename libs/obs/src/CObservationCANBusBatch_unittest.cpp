@@ -0,0 +1,63 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/io/CMemoryStream.h>
+#include <mrpt/obs/CObservationCANBusBatch.h>
+#include <mrpt/serialization/CArchive.h>
+
+TEST(CObservationCANBusBatch, addFramesAndSerialize)
+{
+	using namespace mrpt::obs;
+
+	CObservationCANBusBatch b;
+	b.sensorLabel = "CAN";
+	const auto t0 = mrpt::Clock::now();
+	const size_t N = 50;
+	for (size_t i = 0; i < N; i++)
+	{
+		// EEC1 (PGN 0xF004) from source address 0x00, priority 3:
+		const uint32_t id = CObservationCANBusBatch::EXTENDED_ID_FLAG |
+			(3U << 26) | (0xF004U << 8) | 0x00;
+		const uint8_t data[8] = {uint8_t(i), 1, 2, 3, 4, 5, 6, 7};
+		const size_t idx = b.addFrame(
+			t0 + std::chrono::microseconds(100 * i), id, data, 1 + i % 8);
+		EXPECT_EQ(idx, i);
+	}
+	EXPECT_EQ(b.size(), N);
+	EXPECT_EQ(b.timestamp, t0);
+
+	mrpt::io::CMemoryStream buf;
+	auto arch = mrpt::serialization::archiveFrom(buf);
+	arch << b;
+	buf.Seek(0);
+	CObservationCANBusBatch b2;
+	arch >> b2;
+
+	ASSERT_EQ(b2.size(), N);
+	EXPECT_EQ(b2.sensorLabel, "CAN");
+	EXPECT_EQ(b2.timestamps(), b.timestamps());
+	EXPECT_EQ(b2.ids(), b.ids());
+	EXPECT_EQ(b2.lengths(), b.lengths());
+	EXPECT_EQ(b2.payload(10)[0], 10);
+
+	CObservationCANBusJ1939 f;
+	b2.getFrame(9, f);
+	EXPECT_EQ(f.timestamp, t0 + std::chrono::microseconds(900));
+	EXPECT_EQ(f.sensorLabel, "CAN");
+	EXPECT_EQ(f.m_priority, 3);
+	EXPECT_EQ(f.m_pgn, 0xF004);
+	EXPECT_EQ(f.m_pdu_format, 0xF0);
+	EXPECT_EQ(f.m_pdu_spec, 0x04);
+	EXPECT_EQ(f.m_src_address, 0x00);
+	EXPECT_EQ(f.m_data_length, 2);
+	ASSERT_EQ(f.m_data.size(), 2U);
+	EXPECT_EQ(f.m_data[0], 9);
+	EXPECT_EQ(f.m_data[1], 1);
+}
@@ -77,6 +77,21 @@ void CObservationCANBusJ1939::serializeFrom(
 	};
 }
 
+void CObservationCANBusJ1939::setFromCANFrame(
+	uint32_t canId, const uint8_t* data, uint8_t len)
+{
+	// 29-bit identifier: priority (3 bits), reserved and data page (2 bits),
+	// PDU format (8), PDU specific (8), source address (8):
+	m_priority = static_cast<uint8_t>((canId >> 26) & 0x07);
+	m_pdu_format = static_cast<uint8_t>((canId >> 16) & 0xFF);
+	m_pdu_spec = static_cast<uint8_t>((canId >> 8) & 0xFF);
+	m_src_address = static_cast<uint8_t>(canId & 0xFF);
+	m_pgn = uint16_t(m_pdu_format) << 8 | uint16_t(m_pdu_spec);
+	m_data_length = len;
+	m_data.assign(data, data + len);
+	m_raw_frame.clear();
+}
+
 void CObservationCANBusJ1939::getDescriptionAsText(std::ostream& o) const
 {
 	CObservation::getDescriptionAsText(o);
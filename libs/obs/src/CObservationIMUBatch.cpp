@@ -0,0 +1,150 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "obs-precomp.h"  // Precompiled headers
+//
+#include <mrpt/obs/CObservationIMUBatch.h>
+#include <mrpt/serialization/CArchive.h>
+#include <mrpt/system/datetime.h>
+
+using namespace mrpt::obs;
+
+// This must be added to any CSerializable class implementation file.
+IMPLEMENTS_SERIALIZABLE(CObservationIMUBatch, CObservation, mrpt::obs)
+
+CObservationIMUBatch::CObservationIMUBatch() = default;
+
+void CObservationIMUBatch::clear()
+{
+	m_timestamps.clear();
+	for (auto& v : m_values)
+		v.clear();
+}
+
+void CObservationIMUBatch::reserve(size_t n)
+{
+	m_timestamps.reserve(n);
+	for (auto& v : m_values)
+		if (!v.empty()) v.reserve(n);
+}
+
+size_t CObservationIMUBatch::addSample(mrpt::Clock::time_point t)
+{
+	if (m_timestamps.empty()) timestamp = t;
+	m_timestamps.push_back(t);
+	for (auto& v : m_values)
+		if (!v.empty()) v.push_back(missingValue());
+	return m_timestamps.size() - 1;
+}
+
+size_t CObservationIMUBatch::addSample(
+	mrpt::Clock::time_point t,
+	const std::array<double, COUNT_IMU_DATA_FIELDS>& rawMeasurements,
+	const std::array<bool, COUNT_IMU_DATA_FIELDS>& dataIsPresent)
+{
+	const size_t i = addSample(t);
+	for (size_t k = 0; k < COUNT_IMU_DATA_FIELDS; k++)
+		if (dataIsPresent[k])
+			set(i, static_cast<TIMUDataIndex>(k), rawMeasurements[k]);
+	return i;
+}
+
+void CObservationIMUBatch::getSample(size_t i, CObservationIMU& out) const
+{
+	out.timestamp = m_timestamps.at(i);
+	out.sensorLabel = sensorLabel;
+	out.sensorPose = sensorPose;
+	for (size_t k = 0; k < COUNT_IMU_DATA_FIELDS; k++)
+	{
+		const auto idx = static_cast<TIMUDataIndex>(k);
+		out.dataIsPresent[k] = has(i, idx);
+		out.rawMeasurements[k] = out.dataIsPresent[k] ? m_values[k][i] : 0;
+	}
+}
+
+uint8_t CObservationIMUBatch::serializeGetVersion() const { return 0; }
+void CObservationIMUBatch::serializeTo(
+	mrpt::serialization::CArchive& out) const
+{
+	out << sensorPose << timestamp << sensorLabel;
+
+	const uint32_t N = static_cast<uint32_t>(m_timestamps.size());
+	out << N;
+	std::vector<int64_t> ts(N);
+	for (uint32_t i = 0; i < N; i++)
+		ts[i] = m_timestamps[i].time_since_epoch().count();
+	out.WriteBufferFixEndianness(ts.data(), ts.size());
+
+	// Only the present fields:
+	static_assert(COUNT_IMU_DATA_FIELDS <= 32);
+	uint32_t presentMask = 0;
+	for (size_t k = 0; k < COUNT_IMU_DATA_FIELDS; k++)
+		if (!m_values[k].empty()) presentMask |= (1U << k);
+	out << presentMask;
+	for (const auto& v : m_values)
+		if (!v.empty()) out.WriteBufferFixEndianness(v.data(), v.size());
+}
+
+void CObservationIMUBatch::serializeFrom(
+	mrpt::serialization::CArchive& in, uint8_t version)
+{
+	switch (version)
+	{
+		case 0:
+		{
+			in >> sensorPose >> timestamp >> sensorLabel;
+
+			const auto N = in.ReadAs<uint32_t>();
+			std::vector<int64_t> ts(N);
+			in.ReadBufferFixEndianness(ts.data(), ts.size());
+			m_timestamps.resize(N);
+			for (uint32_t i = 0; i < N; i++)
+				m_timestamps[i] =
+					mrpt::Clock::time_point(mrpt::Clock::duration(ts[i]));
+
+			const auto presentMask = in.ReadAs<uint32_t>();
+			for (size_t k = 0; k < COUNT_IMU_DATA_FIELDS; k++)
+			{
+				auto& v = m_values[k];
+				if (presentMask & (1U << k))
+				{
+					v.resize(N);
+					in.ReadBufferFixEndianness(v.data(), v.size());
+				}
+				else
+					v.clear();
+			}
+		}
+		break;
+		default: MRPT_THROW_UNKNOWN_SERIALIZATION_VERSION(version);
+	};
+}
+
+void CObservationIMUBatch::getDescriptionAsText(std::ostream& o) const
+{
+	CObservation::getDescriptionAsText(o);
+
+	o << "Sensor pose on the robot: " << sensorPose << "\n";
+	o << "Number of samples: " << size() << "\n";
+	if (!empty())
+		o << mrpt::format(
+			"Time span: %.06f s\n",
+			mrpt::system::timeDifference(
+				m_timestamps.front(), m_timestamps.back()));
+
+	o << "Present fields (first / last sample values):\n";
+	for (size_t k = 0; k < COUNT_IMU_DATA_FIELDS; k++)
+	{
+		const auto& v = m_values[k];
+		if (v.empty()) continue;
+		o << mrpt::format(
+			" Field #%2u (TIMUDataIndex) = %10f / %10f\n",
+			static_cast<unsigned int>(k), v.front(), v.back());
+	}
+}
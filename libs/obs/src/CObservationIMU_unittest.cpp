@@ -11,7 +11,9 @@
 #include <mrpt/io/CFileGZInputStream.h>
 #include <mrpt/maps/CSimplePointsMap.h>
 #include <mrpt/obs/CObservationIMU.h>
+#include <mrpt/obs/CObservationIMUBatch.h>
 #include <mrpt/obs/CRawlog.h>
+#include <mrpt/io/CMemoryStream.h>
 #include <mrpt/serialization/CArchive.h>
 #include <test_mrpt_common.h>
 
@@ -63,3 +65,58 @@ TEST(CObservationIMU, Deserialize_v4)
 	auto o = dataset.asObservation<mrpt::obs::CObservationIMU>(0);
 	checkExpectedValues(*o);
 }
+
+TEST(CObservationIMUBatch, addSamplesAndSerialize)
+{
+	using namespace mrpt::obs;
+
+	CObservationIMUBatch b;
+	b.sensorLabel = "IMU";
+	const auto t0 = mrpt::Clock::now();
+	const size_t N = 100;
+	for (size_t i = 0; i < N; i++)
+	{
+		const size_t idx = b.addSample(t0 + std::chrono::milliseconds(i));
+		EXPECT_EQ(idx, i);
+		b.set(idx, IMU_WZ, 0.1 * i);
+		// A field only present in the second half:
+		if (i >= N / 2) b.set(idx, IMU_TEMPERATURE, 25.0);
+	}
+	EXPECT_EQ(b.size(), N);
+	EXPECT_EQ(b.timestamp, t0);
+	EXPECT_TRUE(b.has(IMU_WZ));
+	EXPECT_TRUE(b.has(IMU_TEMPERATURE));
+	EXPECT_FALSE(b.has(IMU_X_ACC));
+	EXPECT_FALSE(b.has(0, IMU_TEMPERATURE));
+	EXPECT_TRUE(b.has(N - 1, IMU_TEMPERATURE));
+	EXPECT_EQ(b.values(IMU_WZ).size(), N);
+
+	CObservationIMU o;
+	o.set(IMU_X_ACC, 9.8);
+	o.timestamp = t0 + std::chrono::seconds(1);
+	b.addSample(o);
+	EXPECT_EQ(b.values(IMU_X_ACC).size(), N + 1);
+	EXPECT_FALSE(b.has(N, IMU_WZ));
+
+	mrpt::io::CMemoryStream buf;
+	auto arch = mrpt::serialization::archiveFrom(buf);
+	arch << b;
+	buf.Seek(0);
+	CObservationIMUBatch b2;
+	arch >> b2;
+
+	ASSERT_EQ(b2.size(), N + 1);
+	EXPECT_EQ(b2.sensorLabel, "IMU");
+	EXPECT_EQ(b2.timestamps(), b.timestamps());
+	EXPECT_NEAR(b2.get(10, IMU_WZ), 1.0, 1e-9);
+	EXPECT_NEAR(b2.get(N, IMU_X_ACC), 9.8, 1e-9);
+	EXPECT_FALSE(b2.has(0, IMU_TEMPERATURE));
+
+	CObservationIMU s;
+	b2.getSample(N - 1, s);
+	EXPECT_EQ(s.timestamp, t0 + std::chrono::milliseconds(N - 1));
+	EXPECT_TRUE(s.has(IMU_WZ));
+	EXPECT_TRUE(s.has(IMU_TEMPERATURE));
+	EXPECT_FALSE(s.has(IMU_X_ACC));
+	EXPECT_NEAR(s.get(IMU_WZ), 0.1 * (N - 1), 1e-9);
+}
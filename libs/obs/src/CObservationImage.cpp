@@ -174,3 +174,5 @@ void CObservationImage::unload() const
 
 	image.unload();
 }
+
+void CObservationImage::prefetch() const { image.prefetch(); }
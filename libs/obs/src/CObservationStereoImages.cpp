@@ -281,3 +281,17 @@ void CObservationStereoImages::load() const
 	imageRight.forceLoad();
 	imageDisparity.forceLoad();
 }
+
+void CObservationStereoImages::unload() const
+{
+	imageLeft.unload();
+	imageRight.unload();
+	imageDisparity.unload();
+}
+
+void CObservationStereoImages::prefetch() const
+{
+	imageLeft.prefetch();
+	if (hasImageRight) imageRight.prefetch();
+	if (hasImageDisparity) imageDisparity.prefetch();
+}
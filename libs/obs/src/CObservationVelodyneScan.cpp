@@ -427,32 +427,38 @@ void Velo::generatePointCloud(
 }
 
 void Velo::generatePointCloud(const TGeneratePointCloudParameters& params)
+{
+	generatePointCloud(point_cloud, params);
+}
+
+void Velo::generatePointCloud(
+	TPointCloud& dest, const TGeneratePointCloudParameters& params) const
 {
 	struct PointCloudStorageWrapper_Inner : public PointCloudStorageWrapper
 	{
-		Velo& me_;
+		TPointCloud& pc_;
 		const TGeneratePointCloudParameters& params_;
 		PointCloudStorageWrapper_Inner(
-			Velo& me, const TGeneratePointCloudParameters& p)
-			: me_(me), params_(p)
+			TPointCloud& pc, const TGeneratePointCloudParameters& p)
+			: pc_(pc), params_(p)
 		{
-			// Reset point cloud:
-			me_.point_cloud.clear();
+			// Reset point cloud (keeping the allocated memory):
+			pc_.clear();
 		}
 
 		void resizeLaserCount(std::size_t n) override
 		{
-			me_.point_cloud.pointsForLaserID.resize(n);
+			pc_.pointsForLaserID.resize(n);
 		}
 
 		void reserve(std::size_t n) override
 		{
-			me_.point_cloud.reserve(n);
-			if (!me_.point_cloud.pointsForLaserID.empty())
+			pc_.reserve(n);
+			if (!pc_.pointsForLaserID.empty())
 			{
 				const std::size_t n_per_ring =
-					100 + n / (me_.point_cloud.pointsForLaserID.size());
-				for (auto& v : me_.point_cloud.pointsForLaserID)
+					100 + n / (pc_.pointsForLaserID.size());
+				for (auto& v : pc_.pointsForLaserID)
 					v.reserve(n_per_ring);
 			}
 		}
@@ -462,30 +468,27 @@ void Velo::generatePointCloud(const TGeneratePointCloudParameters& params)
 			const mrpt::system::TTimeStamp& tim, const float azimuth,
 			uint16_t laser_id) override
 		{
-			const auto idx = me_.point_cloud.x.size();
-			me_.point_cloud.x.push_back(pt_x);
-			me_.point_cloud.y.push_back(pt_y);
-			me_.point_cloud.z.push_back(pt_z);
-			me_.point_cloud.intensity.push_back(pt_intensity);
+			const auto idx = pc_.x.size();
+			pc_.x.push_back(pt_x);
+			pc_.y.push_back(pt_y);
+			pc_.z.push_back(pt_z);
+			pc_.intensity.push_back(pt_intensity);
 			if (params_.generatePerPointTimestamp)
-			{ me_.point_cloud.timestamp.push_back(tim); }
+			{ pc_.timestamp.push_back(tim); }
 			if (params_.generatePerPointAzimuth)
 			{
 				const int azimuth_corrected =
 					round(azimuth) % Velo::ROTATION_MAX_UNITS;
-				me_.point_cloud.azimuth.push_back(
-					azimuth_corrected * ROTATION_RESOLUTION);
+				pc_.azimuth.push_back(azimuth_corrected * ROTATION_RESOLUTION);
 			}
-			me_.point_cloud.laser_id.push_back(laser_id);
+			pc_.laser_id.push_back(laser_id);
 			if (params_.generatePointsForLaserID)
-				me_.point_cloud.pointsForLaserID[laser_id].push_back(idx);
+				pc_.pointsForLaserID[laser_id].push_back(idx);
 		}
 	};
 
-	PointCloudStorageWrapper_Inner my_pc_wrap(*this, params);
-	point_cloud.clear();
-
-	generatePointCloud(my_pc_wrap, params);
+	PointCloudStorageWrapper_Inner my_pc_wrap(dest, params);
+	velodyne_scan_to_pointcloud(*this, params, my_pc_wrap);
 }
 
 void Velo::generatePointCloudAlongSE3Trajectory(
@@ -13,9 +13,11 @@
 #include <mrpt/io/CFileGZOutputStream.h>
 #include <mrpt/io/CFileInputStream.h>
 #include <mrpt/obs/CRawlog.h>
+#include <mrpt/obs/CRawlogIndexedFile.h>
 #include <mrpt/serialization/CArchive.h>
 #include <mrpt/system/filesystem.h>
 
+#include <algorithm>
 #include <iostream>
 
 using namespace mrpt;
@@ -108,6 +110,20 @@ CSerializable::Ptr CRawlog::getAsGeneric(size_t index) const
 	MRPT_END
 }
 
+void CRawlog::prefetchExternalImages(size_t first, size_t count) const
+{
+	const size_t last = std::min(first + count, m_seqOfActObs.size());
+	for (size_t i = first; i < last; i++)
+	{
+		const auto& obj = m_seqOfActObs[i];
+		if (auto obs = std::dynamic_pointer_cast<CObservation>(obj); obs)
+			obs->prefetch();
+		else if (auto sf = std::dynamic_pointer_cast<CSensoryFrame>(obj); sf)
+			for (const auto& o : *sf)
+				if (o) o->prefetch();
+	}
+}
+
 CRawlog::TEntryType CRawlog::getType(size_t index) const
 {
 	MRPT_START
@@ -172,6 +188,38 @@ void CRawlog::serializeFrom(mrpt::serialization::CArchive& in, uint8_t version)
 bool CRawlog::loadFromRawLogFile(
 	const std::string& fileName, bool non_obs_objects_are_legal)
 {
+	if (CRawlogIndexedFile::IsIndexedRawlogFile(fileName))
+	{
+		CRawlogIndexedFile fi;
+		fi.setUseMemoryArenas(m_arenaChunkSize > 0);
+		if (!fi.open(fileName)) return false;
+		clear();
+		try
+		{
+			for (size_t i = 0; i < fi.size(); i++)
+			{
+				auto newObj = fi.getEntry(i);
+				if (IS_CLASS(*newObj, CObservationComment))
+					m_commentTexts =
+						*std::dynamic_pointer_cast<CObservationComment>(newObj);
+				else if (
+					non_obs_objects_are_legal ||
+					newObj->GetRuntimeClass()->derivedFrom(
+						CLASS_ID(CObservation)) ||
+					IS_CLASS(*newObj, CSensoryFrame) ||
+					IS_CLASS(*newObj, CActionCollection))
+					m_seqOfActObs.push_back(newObj);
+				else
+					break;
+			}
+		}
+		catch (const std::exception& e)
+		{
+			std::cerr << mrpt::exception_to_str(e) << std::endl;
+		}
+		return true;
+	}
+
 	// Open for read.
 	CFileGZInputStream fi;
 	if (!fi.open(fileName)) return false;
@@ -183,6 +231,12 @@ bool CRawlog::loadFromRawLogFile(
 	bool keepReading = true;
 	while (keepReading)
 	{
+		// Start a new arena once the current one holds enough objects:
+		if (m_arenaChunkSize > 0 &&
+			(!fs.getMemoryArena() ||
+			 fs.getMemoryArena()->allocatedBytes() >= m_arenaChunkSize))
+			fs.setMemoryArena(std::make_shared<mrpt::MemoryArena>());
+
 		CSerializable::Ptr newObj;
 		try
 		{
@@ -284,6 +338,28 @@ bool CRawlog::saveToRawLogFile(const std::string& fileName) const
 	}
 }
 
+bool CRawlog::saveToIndexedRawLogFile(
+	const std::string& fileName, size_t chunkSize, bool compress) const
+{
+	try
+	{
+		CRawlogIndexedFileWriter fo;
+		fo.chunkSize = chunkSize;
+		fo.compressChunks = compress;
+		if (!fo.open(fileName)) return false;
+		if (!m_commentTexts.text.empty()) fo.write(m_commentTexts);
+		for (const auto& obj : m_seqOfActObs)
+			fo.write(obj);
+		fo.close();
+		return true;
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << mrpt::exception_to_str(e) << std::endl;
+		return false;
+	}
+}
+
 void CRawlog::swap(CRawlog& obj)
 {
 	if (this == &obj) return;
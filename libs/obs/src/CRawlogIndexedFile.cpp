@@ -0,0 +1,506 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "obs-precomp.h"  // Precompiled headers
+//
+#include <mrpt/io/CFileInputStream.h>
+#include <mrpt/io/zip.h>
+#include <mrpt/obs/CActionCollection.h>
+#include <mrpt/obs/CRawlogIndexedFile.h>
+#include <mrpt/obs/CSensoryFrame.h>
+#include <mrpt/serialization/CArchive.h>
+#include <mrpt/system/datetime.h>
+#include <mrpt/system/filesystem.h>
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#elif !MRPT_IN_EMSCRIPTEN
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define RAWLOGX_HAS_MMAP
+#endif
+
+using namespace mrpt::obs;
+using namespace mrpt::io;
+using namespace mrpt::serialization;
+
+namespace
+{
+constexpr char HEADER_MAGIC[9] = "MRPT-RLX";
+constexpr char TRAILER_MAGIC[9] = "RLX-INDX";
+constexpr uint32_t FORMAT_VERSION = 1;
+constexpr size_t HEADER_LEN = 16, TRAILER_LEN = 16;
+
+int64_t timestampToInt(const mrpt::Clock::time_point& t)
+{
+	return static_cast<int64_t>(t.time_since_epoch().count());
+}
+mrpt::Clock::time_point intToTimestamp(int64_t t)
+{
+	return mrpt::Clock::time_point(mrpt::Clock::duration(t));
+}
+
+void getObjectTimestampAndLabel(
+	const CSerializable& obj, mrpt::Clock::time_point& t, std::string& label)
+{
+	t = INVALID_TIMESTAMP;
+	label.clear();
+
+	if (auto o = dynamic_cast<const CObservation*>(&obj); o)
+	{
+		t = o->timestamp;
+		label = o->sensorLabel;
+	}
+	else if (auto sf = dynamic_cast<const CSensoryFrame*>(&obj); sf)
+	{
+		if (sf->size() && sf->getObservationByIndex(0))
+		{
+			t = sf->getObservationByIndex(0)->timestamp;
+			label = sf->getObservationByIndex(0)->sensorLabel;
+		}
+	}
+	else if (auto ac = dynamic_cast<const CActionCollection*>(&obj); ac)
+	{
+		if (ac->size()) t = ac->get(0).timestamp;
+	}
+}
+}  // namespace
+
+// ---------------------------------------------------------------------------
+//  CRawlogIndexedFileWriter
+// ---------------------------------------------------------------------------
+CRawlogIndexedFileWriter::~CRawlogIndexedFileWriter()
+{
+	try
+	{
+		close();
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << "[~CRawlogIndexedFileWriter] Exception:\n"
+				  << mrpt::exception_to_str(e);
+	}
+}
+
+bool CRawlogIndexedFileWriter::open(const std::string& fileName)
+{
+	close();
+	m_chunks.clear();
+	m_index.clear();
+	m_curChunk.clear();
+	m_pendingChunks.clear();
+	m_chunkCount = 0;
+
+	if (!m_f.open(fileName)) return false;
+
+	const size_t nThreads = numThreads != 0
+		? numThreads
+		: std::max<size_t>(1, std::thread::hardware_concurrency());
+	m_pool.reset();
+	if (nThreads > 1)
+		m_pool = std::make_unique<mrpt::WorkerThreadsPool>(
+			nThreads, mrpt::WorkerThreadsPool::POLICY_FIFO, "rawlogxWriter");
+	m_maxPendingChunks = 2 * nThreads;
+
+	auto a = archiveFrom(m_f);
+	m_f.Write(HEADER_MAGIC, 8);
+	a << FORMAT_VERSION << uint32_t(0) /* reserved flags */;
+	return true;
+}
+
+void CRawlogIndexedFileWriter::write(const CSerializable& obj)
+{
+	MRPT_START
+	ASSERTMSG_(is_open(), "write() called before open()");
+
+	TRawlogIndexEntry e;
+	e.chunk = static_cast<uint32_t>(m_chunkCount);
+	e.offsetInChunk = static_cast<uint32_t>(m_curChunk.getTotalBytesCount());
+	e.className = obj.GetRuntimeClass()->className;
+	getObjectTimestampAndLabel(obj, e.timestamp, e.sensorLabel);
+
+	archiveFrom(m_curChunk) << obj;
+
+	const uint64_t len = m_curChunk.getTotalBytesCount() - e.offsetInChunk;
+	ASSERTMSG_(len < (uint64_t(1) << 32), "Object too large (>4GiB)");
+	e.length = static_cast<uint32_t>(len);
+	m_index.emplace_back(std::move(e));
+
+	if (m_curChunk.getTotalBytesCount() >= chunkSize) flushChunk();
+	MRPT_END
+}
+
+CRawlogIndexedFileWriter::TStoredChunk
+	CRawlogIndexedFileWriter::CompressChunk(
+		std::vector<unsigned char>&& raw, bool compress)
+{
+	TStoredChunk c;
+	c.info.rawLength = static_cast<uint32_t>(raw.size());
+
+	std::vector<unsigned char> zipped;
+	if (compress) mrpt::io::zip::compress(raw.data(), raw.size(), zipped);
+
+	// Only keep the compressed version if it really saves space:
+	if (compress && zipped.size() < raw.size())
+	{
+		c.info.compressed = 1;
+		c.data = std::move(zipped);
+	}
+	else
+	{
+		c.info.compressed = 0;
+		c.data = std::move(raw);
+	}
+	c.info.storedLength = static_cast<uint32_t>(c.data.size());
+	return c;
+}
+
+void CRawlogIndexedFileWriter::flushChunk()
+{
+	const uint64_t rawLen = m_curChunk.getTotalBytesCount();
+	if (!rawLen) return;
+	ASSERTMSG_(rawLen < (uint64_t(1) << 32), "Chunk too large (>4GiB)");
+
+	const auto* p =
+		static_cast<const unsigned char*>(m_curChunk.getRawBufferData());
+	std::vector<unsigned char> raw(p, p + rawLen);
+	m_curChunk.clear();
+	m_chunkCount++;
+
+	if (!m_pool)
+	{
+		storeChunk(CompressChunk(std::move(raw), compressChunks));
+		return;
+	}
+	m_pendingChunks.push_back(m_pool->enqueue(
+		[compress = compressChunks, raw = std::move(raw)]() mutable {
+			return CompressChunk(std::move(raw), compress);
+		}));
+	storePendingChunks(false);
+}
+
+void CRawlogIndexedFileWriter::storeChunk(TStoredChunk&& c)
+{
+	c.info.fileOffset = m_f.getPosition();
+	m_f.Write(c.data.data(), c.data.size());
+	m_chunks.push_back(c.info);
+}
+
+void CRawlogIndexedFileWriter::storePendingChunks(bool all)
+{
+	while (!m_pendingChunks.empty())
+	{
+		auto& f = m_pendingChunks.front();
+		if (!all && m_pendingChunks.size() <= m_maxPendingChunks &&
+			f.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+			break;
+		storeChunk(f.get());
+		m_pendingChunks.pop_front();
+	}
+}
+
+void CRawlogIndexedFileWriter::close()
+{
+	if (!m_f.fileOpenCorrectly()) return;
+
+	flushChunk();
+	storePendingChunks(true);
+	m_pool.reset();
+
+	// Index:
+	const uint64_t indexOffset = m_f.getPosition();
+	auto a = archiveFrom(m_f);
+	a.WriteAs<uint32_t>(m_chunks.size());
+	for (const auto& c : m_chunks)
+		a << c.fileOffset << c.storedLength << c.rawLength << c.compressed;
+
+	a.WriteAs<uint64_t>(m_index.size());
+	for (const auto& e : m_index)
+		a << e.chunk << e.offsetInChunk << e.length
+		  << timestampToInt(e.timestamp) << e.className << e.sensorLabel;
+
+	// Trailer:
+	a << indexOffset;
+	m_f.Write(TRAILER_MAGIC, 8);
+
+	m_f.close();
+}
+
+// ---------------------------------------------------------------------------
+//  CRawlogIndexedFile
+// ---------------------------------------------------------------------------
+struct CRawlogIndexedFile::Impl
+{
+	uint64_t fileSize = 0;
+	const uint8_t* mapped = nullptr;
+#if defined(_WIN32)
+	HANDLE hFile = INVALID_HANDLE_VALUE, hMap = nullptr;
+#elif defined(RAWLOGX_HAS_MMAP)
+	int fd = -1;
+#endif
+	// Fallback if memory mapping is not available:
+	CFileInputStream f;
+
+	bool open(const std::string& fileName)
+	{
+		close();
+		if (!mrpt::system::fileExists(fileName)) return false;
+		fileSize = mrpt::system::getFileSize(fileName);
+		if (fileSize < HEADER_LEN + TRAILER_LEN) return false;
+
+#if defined(_WIN32)
+		hFile = CreateFileA(
+			fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+			OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (hFile != INVALID_HANDLE_VALUE)
+		{
+			hMap =
+				CreateFileMappingA(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (hMap)
+				mapped = static_cast<const uint8_t*>(
+					MapViewOfFile(hMap, FILE_MAP_READ, 0, 0, 0));
+		}
+#elif defined(RAWLOGX_HAS_MMAP)
+		fd = ::open(fileName.c_str(), O_RDONLY);
+		if (fd >= 0 && fileSize <= std::numeric_limits<size_t>::max())
+		{
+			void* p = ::mmap(
+				nullptr, static_cast<size_t>(fileSize), PROT_READ, MAP_SHARED,
+				fd, 0);
+			if (p != MAP_FAILED) mapped = static_cast<const uint8_t*>(p);
+		}
+#endif
+		if (!mapped) return f.open(fileName);
+		return true;
+	}
+
+	void close()
+	{
+#if defined(_WIN32)
+		if (mapped) UnmapViewOfFile(mapped);
+		if (hMap) CloseHandle(hMap);
+		if (hFile != INVALID_HANDLE_VALUE) CloseHandle(hFile);
+		hMap = nullptr;
+		hFile = INVALID_HANDLE_VALUE;
+#elif defined(RAWLOGX_HAS_MMAP)
+		if (mapped)
+			::munmap(
+				const_cast<uint8_t*>(mapped), static_cast<size_t>(fileSize));
+		if (fd >= 0) ::close(fd);
+		fd = -1;
+#endif
+		mapped = nullptr;
+		if (f.fileOpenCorrectly()) f.close();
+		fileSize = 0;
+	}
+
+	bool is_open() const { return mapped || f.fileOpenCorrectly(); }
+};
+
+CRawlogIndexedFile::CRawlogIndexedFile() : m_impl(std::make_unique<Impl>()) {}
+CRawlogIndexedFile::~CRawlogIndexedFile() { close(); }
+
+bool CRawlogIndexedFile::IsIndexedRawlogFile(const std::string& fileName)
+{
+	CFileInputStream f;
+	if (!f.open(fileName)) return false;
+	char magic[8];
+	if (f.Read(magic, 8) != 8) return false;
+	return 0 == std::memcmp(magic, HEADER_MAGIC, 8);
+}
+
+bool CRawlogIndexedFile::is_open() const { return m_impl->is_open(); }
+
+void CRawlogIndexedFile::close()
+{
+	m_impl->close();
+	m_chunks.clear();
+	m_index.clear();
+	m_byTime.clear();
+	std::lock_guard<std::mutex> lck(m_cacheMtx);
+	m_cachedChunkValid = false;
+	m_cachedChunkData.clear();
+	m_arena.reset();
+}
+
+const uint8_t* CRawlogIndexedFile::readBytes(
+	uint64_t offset, size_t len, std::vector<uint8_t>& buf) const
+{
+	ASSERTMSG_(
+		offset + len <= m_impl->fileSize, "Read out of file bounds (corrupt?)");
+	if (m_impl->mapped) return m_impl->mapped + offset;
+
+	buf.resize(len);
+	m_impl->f.Seek(static_cast<int64_t>(offset));
+	ASSERTMSG_(
+		m_impl->f.Read(buf.data(), len) == len, "Error reading from file");
+	return buf.data();
+}
+
+bool CRawlogIndexedFile::open(const std::string& fileName)
+{
+	close();
+	if (!IsIndexedRawlogFile(fileName)) return false;
+	if (!m_impl->open(fileName)) return false;
+
+	try
+	{
+		std::lock_guard<std::mutex> lck(m_cacheMtx);
+		std::vector<uint8_t> buf;
+		const uint64_t fileSize = m_impl->fileSize;
+
+		// Header:
+		{
+			CMemoryStream ms;
+			ms.assignMemoryNotOwn(readBytes(0, HEADER_LEN, buf), HEADER_LEN);
+			ms.Seek(8);
+			uint32_t version, flags;
+			auto a = archiveFrom(ms);
+			a >> version >> flags;
+			if (version != FORMAT_VERSION)
+				THROW_EXCEPTION_FMT(
+					"Unsupported indexed rawlog format version: %u",
+					static_cast<unsigned>(version));
+		}
+
+		// Trailer:
+		uint64_t indexOffset;
+		{
+			const uint8_t* p =
+				readBytes(fileSize - TRAILER_LEN, TRAILER_LEN, buf);
+			if (0 != std::memcmp(p + 8, TRAILER_MAGIC, 8))
+				THROW_EXCEPTION("Missing index (was the file closed?)");
+			CMemoryStream ms;
+			ms.assignMemoryNotOwn(p, 8);
+			auto a = archiveFrom(ms);
+			a >> indexOffset;
+			ASSERT_(
+				indexOffset >= HEADER_LEN &&
+				indexOffset <= fileSize - TRAILER_LEN);
+		}
+
+		// Index:
+		const size_t indexLen =
+			static_cast<size_t>(fileSize - TRAILER_LEN - indexOffset);
+		CMemoryStream ms;
+		ms.assignMemoryNotOwn(readBytes(indexOffset, indexLen, buf), indexLen);
+		auto a = archiveFrom(ms);
+
+		const auto nChunks = a.ReadAs<uint32_t>();
+		m_chunks.resize(nChunks);
+		for (auto& c : m_chunks)
+		{
+			a >> c.fileOffset >> c.storedLength >> c.rawLength >> c.compressed;
+			ASSERT_(c.fileOffset + c.storedLength <= indexOffset);
+		}
+
+		const auto nEntries = a.ReadAs<uint64_t>();
+		m_index.resize(nEntries);
+		for (auto& e : m_index)
+		{
+			int64_t t;
+			a >> e.chunk >> e.offsetInChunk >> e.length >> t >> e.className >>
+				e.sensorLabel;
+			e.timestamp = intToTimestamp(t);
+			ASSERT_LT_(e.chunk, m_chunks.size());
+			ASSERT_LE_(
+				uint64_t(e.offsetInChunk) + e.length,
+				m_chunks[e.chunk].rawLength);
+		}
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << "[CRawlogIndexedFile::open] Error loading index of '"
+				  << fileName << "':\n"
+				  << mrpt::exception_to_str(e);
+		close();
+		return false;
+	}
+
+	// Temporal index:
+	m_byTime.reserve(m_index.size());
+	for (size_t i = 0; i < m_index.size(); i++)
+		if (m_index[i].timestamp != INVALID_TIMESTAMP) m_byTime.push_back(i);
+	std::stable_sort(m_byTime.begin(), m_byTime.end(), [this](auto a, auto b) {
+		return m_index[a].timestamp < m_index[b].timestamp;
+	});
+
+	return true;
+}
+
+CSerializable::Ptr CRawlogIndexedFile::getEntry(size_t i) const
+{
+	MRPT_START
+	ASSERTMSG_(is_open(), "getEntry() called before open()");
+	const auto& e = m_index.at(i);
+	const auto& c = m_chunks.at(e.chunk);
+
+	std::lock_guard<std::mutex> lck(m_cacheMtx);
+
+	const uint8_t* data = nullptr;
+	std::vector<uint8_t> buf;
+	if (!c.compressed)
+	{
+		// Read only the required entry, directly from the mapped memory if
+		// possible:
+		data = readBytes(c.fileOffset + e.offsetInChunk, e.length, buf);
+	}
+	else
+	{
+		if (!m_cachedChunkValid || m_cachedChunk != e.chunk)
+		{
+			m_cachedChunkValid = false;
+			const uint8_t* zipped =
+				readBytes(c.fileOffset, c.storedLength, buf);
+			m_cachedChunkData.resize(c.rawLength);
+			size_t actualLen = 0;
+			mrpt::io::zip::decompress(
+				const_cast<uint8_t*>(zipped), c.storedLength,
+				m_cachedChunkData.data(), c.rawLength, actualLen);
+			ASSERT_EQUAL_(actualLen, c.rawLength);
+			m_cachedChunk = e.chunk;
+			m_cachedChunkValid = true;
+		}
+		data = m_cachedChunkData.data() + e.offsetInChunk;
+	}
+
+	CMemoryStream ms;
+	ms.assignMemoryNotOwn(data, e.length);
+	auto arch = archiveFrom(ms);
+	if (m_useArenas)
+	{
+		if (!m_arena || m_arenaChunk != e.chunk)
+		{
+			m_arena = std::make_shared<mrpt::MemoryArena>();
+			m_arenaChunk = e.chunk;
+		}
+		arch.setMemoryArena(m_arena);
+	}
+	return arch.ReadObject();
+	MRPT_END
+}
+
+size_t CRawlogIndexedFile::findByTimestamp(
+	const mrpt::Clock::time_point& t) const
+{
+	const auto it = std::lower_bound(
+		m_byTime.begin(), m_byTime.end(), t,
+		[this](size_t idx, const mrpt::Clock::time_point& tt) {
+			return m_index[idx].timestamp < tt;
+		});
+	return it == m_byTime.end() ? size() : *it;
+}
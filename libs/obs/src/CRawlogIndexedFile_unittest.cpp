@@ -0,0 +1,118 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/obs/CObservationOdometry.h>
+#include <mrpt/obs/CRawlog.h>
+#include <mrpt/obs/CRawlogIndexedFile.h>
+#include <mrpt/system/filesystem.h>
+
+using namespace mrpt::obs;
+
+namespace
+{
+// Timestamps are deliberately not in order, to test the temporal index:
+mrpt::Clock::time_point entryTimestamp(size_t i)
+{
+	return mrpt::Clock::fromDouble(1000.0 + ((i * 7) % 500));
+}
+
+void writeTestFile(
+	const std::string& fil, bool compress, size_t N, size_t numThreads = 1)
+{
+	CRawlogIndexedFileWriter w;
+	w.chunkSize = 2000;	 // force many chunks
+	w.compressChunks = compress;
+	w.numThreads = numThreads;
+	ASSERT_TRUE(w.open(fil));
+	for (size_t i = 0; i < N; i++)
+	{
+		CObservationOdometry obs;
+		obs.sensorLabel = (i % 2) ? "ODO_A" : "ODO_B";
+		obs.timestamp = entryTimestamp(i);
+		obs.odometry = mrpt::poses::CPose2D(i * 0.1, 0, 0);
+		w.write(obs);
+	}
+	w.close();
+}
+
+void checkTestFile(const std::string& fil, size_t N)
+{
+	EXPECT_TRUE(CRawlogIndexedFile::IsIndexedRawlogFile(fil));
+
+	CRawlogIndexedFile f;
+	ASSERT_TRUE(f.open(fil));
+	ASSERT_EQ(f.size(), N);
+
+	// Random access:
+	for (size_t i : {N - 1, size_t(0), N / 2, size_t(3), N - 2})
+	{
+		const auto& info = f.getEntryInfo(i);
+		EXPECT_EQ(info.className, "mrpt::obs::CObservationOdometry");
+		EXPECT_EQ(info.sensorLabel, (i % 2) ? "ODO_A" : "ODO_B");
+		EXPECT_EQ(info.timestamp, entryTimestamp(i));
+
+		const auto obs = f.getEntryAs<CObservationOdometry>(i);
+		EXPECT_NEAR(obs->odometry.x(), i * 0.1, 1e-9);
+		EXPECT_EQ(obs->timestamp, entryTimestamp(i));
+	}
+
+	// Seek by time:
+	const size_t idx = f.findByTimestamp(entryTimestamp(13));
+	ASSERT_LT(idx, N);
+	EXPECT_EQ(f.getEntryInfo(idx).timestamp, entryTimestamp(13));
+	EXPECT_EQ(f.findByTimestamp(mrpt::Clock::fromDouble(1e6)), N);
+
+	// Full load through CRawlog:
+	CRawlog rawlog;
+	ASSERT_TRUE(rawlog.loadFromRawLogFile(fil));
+	EXPECT_EQ(rawlog.size(), N);
+}
+}  // namespace
+
+TEST(CRawlogIndexedFile, WriteReadCompressed)
+{
+	const auto fil = mrpt::system::getTempFileName();
+	writeTestFile(fil, true, 300);
+	checkTestFile(fil, 300);
+	mrpt::system::deleteFile(fil);
+}
+
+TEST(CRawlogIndexedFile, WriteReadUncompressed)
+{
+	const auto fil = mrpt::system::getTempFileName();
+	writeTestFile(fil, false, 300);
+	checkTestFile(fil, 300);
+	mrpt::system::deleteFile(fil);
+}
+
+#if !MRPT_IN_EMSCRIPTEN
+TEST(CRawlogIndexedFile, WriteReadParallelCompression)
+{
+	const auto fil = mrpt::system::getTempFileName();
+	writeTestFile(fil, true, 2000, 4);
+	checkTestFile(fil, 2000);
+	mrpt::system::deleteFile(fil);
+}
+#endif
+
+TEST(CRawlogIndexedFile, NotIndexedFile)
+{
+	const auto fil = mrpt::system::getTempFileName();
+	{
+		CRawlog rawlog;
+		auto obs = CObservationOdometry::Create();
+		rawlog.insert(obs);
+		ASSERT_TRUE(rawlog.saveToRawLogFile(fil));
+	}
+	EXPECT_FALSE(CRawlogIndexedFile::IsIndexedRawlogFile(fil));
+	CRawlogIndexedFile f;
+	EXPECT_FALSE(f.open(fil));
+	mrpt::system::deleteFile(fil);
+}
@@ -0,0 +1,337 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "obs-precomp.h"  // Precompiled headers
+//
+#include <mrpt/io/CFileGZInputStream.h>
+#include <mrpt/io/CFileGZOutputStream.h>
+#include <mrpt/obs/CActionCollection.h>
+#include <mrpt/obs/CRawlogSidecarIndex.h>
+#include <mrpt/obs/CSensoryFrame.h>
+#include <mrpt/serialization/CArchive.h>
+#include <mrpt/system/datetime.h>
+#include <mrpt/system/filesystem.h>
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+using namespace mrpt::obs;
+using namespace mrpt::io;
+using namespace mrpt::serialization;
+
+namespace
+{
+constexpr char SIDECAR_MAGIC[9] = "MRPT-RIX";
+constexpr uint32_t FORMAT_VERSION = 1;
+
+int64_t timestampToInt(const mrpt::Clock::time_point& t)
+{
+	return static_cast<int64_t>(t.time_since_epoch().count());
+}
+mrpt::Clock::time_point intToTimestamp(int64_t t)
+{
+	return mrpt::Clock::time_point(mrpt::Clock::duration(t));
+}
+
+/** Counts the bytes read from another stream, since the file position of
+ * compressed streams is not the uncompressed one */
+class CCountingInputStream : public CStream
+{
+   public:
+	explicit CCountingInputStream(CStream& in) : m_in(in) {}
+
+	size_t Read(void* buf, size_t n) override
+	{
+		const size_t r = m_in.Read(buf, n);
+		m_count += r;
+		return r;
+	}
+	size_t Write(const void*, size_t) override
+	{
+		THROW_EXCEPTION("Trying to write to an input stream.");
+	}
+	uint64_t Seek(int64_t, CStream::TSeekOrigin) override
+	{
+		THROW_EXCEPTION("Method not available in this class.");
+	}
+	uint64_t getTotalBytesCount() const override
+	{
+		return m_in.getTotalBytesCount();
+	}
+	uint64_t getPosition() const override { return m_count; }
+
+   private:
+	CStream& m_in;
+	uint64_t m_count = 0;
+};
+}  // namespace
+
+void CRawlogSidecarIndex::clear()
+{
+	m_rawlogFile.clear();
+	m_fileSize = m_uncompressedSize = 0;
+	m_fileTime = 0;
+	m_entries.clear();
+	m_observations.clear();
+	m_firstTime = m_lastTime = INVALID_TIMESTAMP;
+}
+
+void CRawlogSidecarIndex::build(const std::string& rawlogFile)
+{
+	MRPT_START
+	clear();
+
+	CFileGZInputStream f;
+	std::string errMsg;
+	if (!f.open(rawlogFile, errMsg))
+		THROW_EXCEPTION_FMT(
+			"Error opening rawlog file `%s`: %s", rawlogFile.c_str(),
+			errMsg.c_str());
+
+	CCountingInputStream in(f);
+	auto arch = archiveFrom(in);
+	for (;;)
+	{
+		TRawlogSidecarEntry e;
+		e.offset = in.getPosition();
+		CSerializable::Ptr obj;
+		try
+		{
+			obj = arch.ReadObject();
+		}
+		catch (const CExceptionEOF&)
+		{
+			break;
+		}
+		const uint64_t entryIdx = m_entries.size();
+		auto lmbAddObs = [&](const CObservation& o) {
+			TRawlogSidecarObservation so;
+			so.entry = entryIdx;
+			so.timestamp = o.timestamp;
+			so.className = o.GetRuntimeClass()->className;
+			so.sensorLabel = o.sensorLabel;
+			m_observations.emplace_back(std::move(so));
+		};
+
+		e.timestamp = INVALID_TIMESTAMP;
+		if (obj) e.className = obj->GetRuntimeClass()->className;
+		if (auto o = dynamic_cast<const CObservation*>(obj.get()); o)
+		{
+			e.timestamp = o->timestamp;
+			lmbAddObs(*o);
+		}
+		else if (auto sf = dynamic_cast<const CSensoryFrame*>(obj.get()); sf)
+		{
+			for (const auto& so : *sf)
+			{
+				if (!so) continue;
+				if (e.timestamp == INVALID_TIMESTAMP)
+					e.timestamp = so->timestamp;
+				lmbAddObs(*so);
+			}
+		}
+		else if (auto ac = dynamic_cast<const CActionCollection*>(obj.get());
+				 ac && ac->size())
+			e.timestamp = ac->get(0).timestamp;
+
+		m_entries.emplace_back(std::move(e));
+	}
+
+	m_rawlogFile = rawlogFile;
+	m_fileSize = mrpt::system::getFileSize(rawlogFile);
+	m_fileTime = mrpt::system::getFileModificationTime(rawlogFile);
+	m_uncompressedSize = in.getPosition();
+	updateTimeRange();
+	MRPT_END
+}
+
+bool CRawlogSidecarIndex::save() const
+{
+	if (m_rawlogFile.empty()) return false;
+	const std::string fileName = SidecarFileName(m_rawlogFile);
+	try
+	{
+		CFileGZOutputStream f;
+		if (!f.open(fileName)) return false;
+
+		f.Write(SIDECAR_MAGIC, 8);
+		auto a = archiveFrom(f);
+		a << FORMAT_VERSION << m_fileSize << m_fileTime << m_uncompressedSize;
+
+		a.WriteAs<uint64_t>(m_entries.size());
+		for (const auto& e : m_entries)
+			a << e.offset << timestampToInt(e.timestamp) << e.className;
+
+		a.WriteAs<uint64_t>(m_observations.size());
+		for (const auto& o : m_observations)
+			a << o.entry << timestampToInt(o.timestamp) << o.className
+			  << o.sensorLabel;
+		return true;
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << "[CRawlogSidecarIndex::save] Error writing '" << fileName
+				  << "':\n"
+				  << mrpt::exception_to_str(e);
+		mrpt::system::deleteFile(fileName);
+		return false;
+	}
+}
+
+bool CRawlogSidecarIndex::load(const std::string& rawlogFile)
+{
+	clear();
+	const std::string fileName = SidecarFileName(rawlogFile);
+	if (!mrpt::system::fileExists(fileName)) return false;
+
+	try
+	{
+		CFileGZInputStream f;
+		if (!f.open(fileName)) return false;
+
+		char magic[8];
+		if (f.Read(magic, 8) != 8 || std::memcmp(magic, SIDECAR_MAGIC, 8) != 0)
+			THROW_EXCEPTION("Not a rawlog sidecar index file");
+
+		auto a = archiveFrom(f);
+		uint32_t version;
+		a >> version;
+		if (version != FORMAT_VERSION)
+			THROW_EXCEPTION_FMT(
+				"Unsupported rawlog index format version: %u",
+				static_cast<unsigned>(version));
+
+		a >> m_fileSize >> m_fileTime >> m_uncompressedSize;
+
+		// Outdated? This is not an error:
+		const auto fileTime = static_cast<int64_t>(
+			mrpt::system::getFileModificationTime(rawlogFile));
+		if (m_fileSize != mrpt::system::getFileSize(rawlogFile) ||
+			m_fileTime != fileTime)
+		{
+			clear();
+			return false;
+		}
+
+		m_entries.resize(a.ReadAs<uint64_t>());
+		for (auto& e : m_entries)
+		{
+			int64_t t;
+			a >> e.offset >> t >> e.className;
+			e.timestamp = intToTimestamp(t);
+			ASSERT_LE_(e.offset, m_uncompressedSize);
+		}
+
+		m_observations.resize(a.ReadAs<uint64_t>());
+		for (auto& o : m_observations)
+		{
+			int64_t t;
+			a >> o.entry >> t >> o.className >> o.sensorLabel;
+			o.timestamp = intToTimestamp(t);
+			ASSERT_LT_(o.entry, m_entries.size());
+		}
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << "[CRawlogSidecarIndex::load] Error loading '" << fileName
+				  << "':\n"
+				  << mrpt::exception_to_str(e);
+		clear();
+		return false;
+	}
+
+	m_rawlogFile = rawlogFile;
+	updateTimeRange();
+	return true;
+}
+
+void CRawlogSidecarIndex::loadOrBuild(
+	const std::string& rawlogFile, bool saveIfBuilt)
+{
+	if (load(rawlogFile)) return;
+	build(rawlogFile);
+	if (saveIfBuilt) save();
+}
+
+void CRawlogSidecarIndex::updateTimeRange()
+{
+	m_firstTime = m_lastTime = INVALID_TIMESTAMP;
+	auto lmbUpdate = [this](const mrpt::Clock::time_point& t) {
+		if (t == INVALID_TIMESTAMP) return;
+		if (m_firstTime == INVALID_TIMESTAMP || t < m_firstTime)
+			m_firstTime = t;
+		if (m_lastTime == INVALID_TIMESTAMP || t > m_lastTime) m_lastTime = t;
+	};
+	for (const auto& e : m_entries)
+		lmbUpdate(e.timestamp);
+	for (const auto& o : m_observations)
+		lmbUpdate(o.timestamp);
+}
+
+std::map<std::string, CRawlogSidecarIndex::TSensorSummary>
+	CRawlogSidecarIndex::sensorSummary() const
+{
+	std::map<std::string, TSensorSummary> ret;
+	for (const auto& o : m_observations)
+	{
+		auto& s = ret[o.sensorLabel];
+		s.className = o.className;
+		s.count++;
+		if (s.first == INVALID_TIMESTAMP) s.first = o.timestamp;
+		s.last = o.timestamp;
+	}
+	return ret;
+}
+
+size_t CRawlogSidecarIndex::findEntryByTimestamp(
+	const mrpt::Clock::time_point& t) const
+{
+	size_t best = m_entries.size();
+	for (size_t i = 0; i < m_entries.size(); i++)
+	{
+		const auto& ti = m_entries[i].timestamp;
+		if (ti != INVALID_TIMESTAMP && ti >= t)
+		{
+			best = i;
+			break;
+		}
+	}
+	// An observation within a sensory frame may come before:
+	for (const auto& o : m_observations)
+	{
+		if (o.entry >= best) break;
+		if (o.timestamp != INVALID_TIMESTAMP && o.timestamp >= t)
+			return static_cast<size_t>(o.entry);
+	}
+	return best;
+}
+
+size_t CRawlogSidecarIndex::skipToEntry(CStream& in, size_t entry) const
+{
+	if (entry >= m_entries.size())
+		entry = m_entries.size();
+	else if (
+		entry > 0 && m_entries[entry].className == "mrpt::obs::CSensoryFrame" &&
+		m_entries[entry - 1].className == "mrpt::obs::CActionCollection")
+		entry--;
+
+	uint64_t remaining =
+		entry < m_entries.size() ? m_entries[entry].offset : m_uncompressedSize;
+	std::vector<uint8_t> buf(std::min<uint64_t>(remaining, 1024 * 1024));
+	while (remaining > 0)
+	{
+		const size_t n = static_cast<size_t>(
+			std::min<uint64_t>(remaining, buf.size()));
+		if (in.Read(buf.data(), n) != n)
+			THROW_EXCEPTION("Rawlog file shorter than stated by its index");
+		remaining -= n;
+	}
+	return entry;
+}
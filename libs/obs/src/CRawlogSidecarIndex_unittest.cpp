@@ -0,0 +1,127 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/io/CFileGZInputStream.h>
+#include <mrpt/io/CFileGZOutputStream.h>
+#include <mrpt/obs/CActionCollection.h>
+#include <mrpt/obs/CActionRobotMovement2D.h>
+#include <mrpt/obs/CObservationOdometry.h>
+#include <mrpt/obs/CRawlogSidecarIndex.h>
+#include <mrpt/obs/CSensoryFrame.h>
+#include <mrpt/serialization/CArchive.h>
+#include <mrpt/system/filesystem.h>
+
+using namespace mrpt::obs;
+
+namespace
+{
+mrpt::Clock::time_point obsTimestamp(size_t i)
+{
+	return mrpt::Clock::fromDouble(1000.0 + i);
+}
+
+CObservationOdometry::Ptr makeObs(size_t i)
+{
+	auto obs = CObservationOdometry::Create();
+	obs->sensorLabel = (i % 2) ? "ODO_A" : "ODO_B";
+	obs->timestamp = obsTimestamp(i);
+	obs->odometry = mrpt::poses::CPose2D(i * 0.1, 0, 0);
+	return obs;
+}
+
+// N observations, then N/2 pairs of actions and sensory frames with two
+// observations each:
+void writeTestFile(const std::string& fil, size_t N)
+{
+	mrpt::io::CFileGZOutputStream f(fil);
+	auto arch = mrpt::serialization::archiveFrom(f);
+	for (size_t i = 0; i < N; i++)
+		arch << *makeObs(i);
+	for (size_t i = N; i < 2 * N; i += 2)
+	{
+		CActionCollection acts;
+		CActionRobotMovement2D act;
+		act.timestamp = obsTimestamp(i);
+		acts.insert(act);
+
+		CSensoryFrame sf;
+		sf.insert(makeObs(i));
+		sf.insert(makeObs(i + 1));
+		arch << acts << sf;
+	}
+}
+}  // namespace
+
+TEST(CRawlogSidecarIndex, BuildSaveLoad)
+{
+	const size_t N = 100;
+	const auto fil = mrpt::system::getTempFileName() + ".rawlog";
+	writeTestFile(fil, N);
+
+	CRawlogSidecarIndex idx;
+	EXPECT_FALSE(idx.load(fil));
+	idx.build(fil);
+	ASSERT_TRUE(idx.save());
+
+	CRawlogSidecarIndex idx2;
+	ASSERT_TRUE(idx2.load(fil));
+	for (const auto* i : {&idx, &idx2})
+	{
+		ASSERT_EQ(i->entries().size(), 2 * N);
+		ASSERT_EQ(i->observations().size(), 2 * N);
+		EXPECT_EQ(i->entries()[N].className, "mrpt::obs::CActionCollection");
+		EXPECT_EQ(i->entries()[N + 1].className, "mrpt::obs::CSensoryFrame");
+		EXPECT_EQ(i->observations()[N + 1].entry, N + 1);
+		EXPECT_EQ(i->firstTimestamp(), obsTimestamp(0));
+		EXPECT_EQ(i->lastTimestamp(), obsTimestamp(2 * N - 1));
+
+		const auto sensors = i->sensorSummary();
+		ASSERT_EQ(sensors.size(), 2U);
+		EXPECT_EQ(sensors.at("ODO_A").count, N);
+		EXPECT_EQ(sensors.at("ODO_B").first, obsTimestamp(0));
+		EXPECT_EQ(sensors.at("ODO_A").last, obsTimestamp(2 * N - 1));
+	}
+
+	// Seek by time, into the second observation of a sensory frame:
+	const size_t e = idx2.findEntryByTimestamp(obsTimestamp(N + 3));
+	EXPECT_EQ(e, N + 3);
+	EXPECT_EQ(
+		idx2.findEntryByTimestamp(obsTimestamp(10 * N)),
+		idx2.entries().size());
+
+	// Skipping to a sensory frame stops at its action collection:
+	{
+		mrpt::io::CFileGZInputStream f(fil);
+		EXPECT_EQ(idx2.skipToEntry(f, e), N + 2);
+		auto arch = mrpt::serialization::archiveFrom(f);
+		EXPECT_TRUE(IS_CLASS(*arch.ReadObject(), CActionCollection));
+		auto sf = arch.ReadObject<CSensoryFrame>();
+		ASSERT_EQ(sf->size(), 2U);
+		EXPECT_EQ(
+			sf->getObservationByIndex(1)->timestamp, obsTimestamp(N + 3));
+	}
+	{
+		mrpt::io::CFileGZInputStream f(fil);
+		EXPECT_EQ(idx2.skipToEntry(f, 7), 7U);
+		auto arch = mrpt::serialization::archiveFrom(f);
+		auto obs = arch.ReadObject<CObservationOdometry>();
+		EXPECT_EQ(obs->timestamp, obsTimestamp(7));
+	}
+
+	// An outdated sidecar is ignored:
+	writeTestFile(fil, N / 2);
+	EXPECT_FALSE(idx2.load(fil));
+	idx2.loadOrBuild(fil);
+	EXPECT_EQ(idx2.entries().size(), N);
+	EXPECT_TRUE(idx2.load(fil));
+
+	mrpt::system::deleteFile(fil);
+	mrpt::system::deleteFile(CRawlogSidecarIndex::SidecarFileName(fil));
+}
@@ -40,6 +40,7 @@ TEST_CLASS_MOVE_COPY_CTORS(CObservationGasSensors);
 TEST_CLASS_MOVE_COPY_CTORS(CObservationGPS);
 TEST_CLASS_MOVE_COPY_CTORS(CObservationReflectivity);
 TEST_CLASS_MOVE_COPY_CTORS(CObservationIMU);
+TEST_CLASS_MOVE_COPY_CTORS(CObservationIMUBatch);
 TEST_CLASS_MOVE_COPY_CTORS(CObservationOdometry);
 TEST_CLASS_MOVE_COPY_CTORS(CObservationRange);
 #if MRPT_HAS_OPENCV	 // These classes need CImage serialization
@@ -47,6 +48,7 @@ TEST_CLASS_MOVE_COPY_CTORS(CObservationImage);
 TEST_CLASS_MOVE_COPY_CTORS(CObservationStereoImages);
 #endif
 TEST_CLASS_MOVE_COPY_CTORS(CObservationCANBusJ1939);
+TEST_CLASS_MOVE_COPY_CTORS(CObservationCANBusBatch);
 TEST_CLASS_MOVE_COPY_CTORS(CObservationRawDAQ);
 TEST_CLASS_MOVE_COPY_CTORS(CObservation6DFeatures);
 TEST_CLASS_MOVE_COPY_CTORS(CObservationVelodyneScan);
@@ -62,13 +64,14 @@ const mrpt::rtti::TRuntimeClassId* lstClasses[] = {
 	CLASS_ID(CObservationRFID), CLASS_ID(CObservationBeaconRanges),
 	CLASS_ID(CObservationComment), CLASS_ID(CObservationGasSensors),
 	CLASS_ID(CObservationGPS), CLASS_ID(CObservationReflectivity),
-	CLASS_ID(CObservationIMU), CLASS_ID(CObservationOdometry),
-	CLASS_ID(CObservationRange),
+	CLASS_ID(CObservationIMU), CLASS_ID(CObservationIMUBatch),
+	CLASS_ID(CObservationOdometry), CLASS_ID(CObservationRange),
 #if MRPT_HAS_OPENCV	 // These classes need CImage serialization
 	CLASS_ID(CObservationImage), CLASS_ID(CObservationStereoImages),
 #endif
-	CLASS_ID(CObservationCANBusJ1939), CLASS_ID(CObservationRawDAQ),
-	CLASS_ID(CObservation6DFeatures), CLASS_ID(CObservationVelodyneScan),
+	CLASS_ID(CObservationCANBusJ1939), CLASS_ID(CObservationCANBusBatch),
+	CLASS_ID(CObservationRawDAQ), CLASS_ID(CObservation6DFeatures),
+	CLASS_ID(CObservationVelodyneScan),
 	// Actions:
 	CLASS_ID(CActionRobotMovement2D), CLASS_ID(CActionRobotMovement3D)};
 
@@ -204,6 +207,7 @@ TEST(Observations, CopyCtorAssignOp)
 	run_copy_tests<CObservation3DScene>();
 	run_copy_tests<CObservationGPS>();
 	run_copy_tests<CObservationIMU>();
+	run_copy_tests<CObservationIMUBatch>();
 	run_copy_tests<CObservationOdometry>();
 	run_copy_tests<CObservationRGBD360>();
 	run_copy_tests<CObservationBearingRange>();
@@ -220,6 +224,7 @@ TEST(Observations, CopyCtorAssignOp)
 	run_copy_tests<CObservationStereoImages>();
 #endif
 	run_copy_tests<CObservationCANBusJ1939>();
+	run_copy_tests<CObservationCANBusBatch>();
 	run_copy_tests<CObservationRawDAQ>();
 	run_copy_tests<CObservation6DFeatures>();
 	run_copy_tests<CObservationVelodyneScan>();
@@ -11,10 +11,16 @@
 //
 #include <mrpt/io/CFileGZInputStream.h>
 #include <mrpt/io/CFileGZOutputStream.h>
+#include <mrpt/io/CFileInputStream.h>
+#include <mrpt/io/CFileOutputStream.h>
 #include <mrpt/maps/CSimpleMap.h>
 #include <mrpt/serialization/CArchive.h>
 #include <mrpt/serialization/metaprogramming_serialization.h>
 
+#include <cstring>
+#include <mutex>
+#include <vector>
+
 using namespace mrpt::obs;
 using namespace mrpt::maps;
 using namespace mrpt::poses;
@@ -25,23 +31,79 @@ using namespace mrpt::serialization::metaprogramming;
 
 IMPLEMENTS_SERIALIZABLE(CSimpleMap, CSerializable, mrpt::maps)
 
+namespace
+{
+// External storage file format:
+//  - Magic string (8 bytes), format version (uint32_t).
+//  - Serialized sensory frames.
+//  - Index: number of pairs (uint64_t) and, for each one, its serialized pose
+//    PDF, and the offset and size (uint64_t) of its sensory frame.
+//  - Offset of the index (uint64_t).
+constexpr char EXT_STORAGE_MAGIC[9] = "MRPT-SMX";
+constexpr uint32_t EXT_STORAGE_VERSION = 1;
+}  // namespace
+
+struct CSimpleMap::TExternalStorage
+{
+	std::string fileName;
+	mrpt::io::CFileInputStream f;
+	/** Protects the stream, the frames cache and the members below */
+	std::mutex mtx;
+	size_t memoryBudget = 0, memoryUsage = 0;
+	uint64_t useCounter = 0;
+
+	bool open(const std::string& fil)
+	{
+		fileName = fil;
+		return f.open(fil);
+	}
+
+	/** Must be called with `mtx` locked */
+	CSensoryFrame::Ptr read(const TExternalFrame& e)
+	{
+		f.Seek(e.offset);
+		auto sf = CSensoryFrame::Create();
+		archiveFrom(f) >> *sf;
+		return sf;
+	}
+};
+
 const auto fn_pair_make_unique = [](auto& ptr) {
 	ptr.pose.reset(dynamic_cast<mrpt::poses::CPose3DPDF*>(ptr.pose->clone()));
-	ptr.sf.reset(dynamic_cast<mrpt::obs::CSensoryFrame*>(ptr.sf->clone()));
+	// (Not loaded externally stored frames are empty)
+	if (ptr.sf)
+		ptr.sf.reset(dynamic_cast<mrpt::obs::CSensoryFrame*>(ptr.sf->clone()));
 };
 
-CSimpleMap::CSimpleMap(const CSimpleMap& o) : m_posesObsPairs(o.m_posesObsPairs)
-{
-	for_each(
-		m_posesObsPairs.begin(), m_posesObsPairs.end(), fn_pair_make_unique);
-}
+CSimpleMap::CSimpleMap(const CSimpleMap& o) { *this = o; }
 
 CSimpleMap& CSimpleMap::operator=(const CSimpleMap& o)
 {
 	MRPT_START
 	if (this == &o) return *this;  // It may be used sometimes
 
-	m_posesObsPairs = o.m_posesObsPairs;
+	clear();
+	if (o.m_extStorage)
+	{
+		// Open the file again, with no frame loaded except those only held
+		// in memory:
+		auto es = std::make_shared<TExternalStorage>();
+		if (!es->open(o.m_extStorage->fileName))
+			THROW_EXCEPTION_FMT(
+				"Cannot open external storage file '%s'",
+				o.m_extStorage->fileName.c_str());
+
+		std::lock_guard<std::mutex> lck(o.m_extStorage->mtx);
+		es->memoryBudget = o.m_extStorage->memoryBudget;
+		m_posesObsPairs = o.m_posesObsPairs;
+		m_extFrames = o.m_extFrames;
+		for (size_t i = 0; i < m_extFrames.size(); i++)
+			if (m_extFrames[i].size != 0) m_posesObsPairs[i].sf.reset();
+		m_extStorage = std::move(es);
+	}
+	else
+		m_posesObsPairs = o.m_posesObsPairs;
+
 	for_each(
 		m_posesObsPairs.begin(), m_posesObsPairs.end(), fn_pair_make_unique);
 
@@ -49,10 +111,24 @@ CSimpleMap& CSimpleMap::operator=(const CSimpleMap& o)
 	MRPT_END
 }
 
+void CSimpleMap::clear()
+{
+	m_posesObsPairs.clear();
+	m_extFrames.clear();
+	m_extStorage.reset();
+}
+
 void CSimpleMap::remove(size_t index)
 {
 	MRPT_START
 	ASSERTMSG_(index < m_posesObsPairs.size(), "Index out of bounds");
+	if (m_extStorage)
+	{
+		std::lock_guard<std::mutex> lck(m_extStorage->mtx);
+		if (m_posesObsPairs[index].sf)
+			m_extStorage->memoryUsage -= m_extFrames[index].size;
+		m_extFrames.erase(m_extFrames.begin() + index);
+	}
 	m_posesObsPairs.erase(m_posesObsPairs.begin() + index);
 	MRPT_END
 }
@@ -64,7 +140,18 @@ void CSimpleMap::set(
 	MRPT_START
 	ASSERTMSG_(index < m_posesObsPairs.size(), "Index out of bounds");
 	if (in_posePDF) m_posesObsPairs[index].pose = in_posePDF;
-	if (in_SF) m_posesObsPairs[index].sf = in_SF;
+	if (in_SF)
+	{
+		if (m_extStorage)
+		{
+			// From now on, it is only held in memory:
+			std::lock_guard<std::mutex> lck(m_extStorage->mtx);
+			if (m_posesObsPairs[index].sf)
+				m_extStorage->memoryUsage -= m_extFrames[index].size;
+			m_extFrames[index] = TExternalFrame();
+		}
+		m_posesObsPairs[index].sf = in_SF;
+	}
 	MRPT_END
 }
 
@@ -74,10 +161,9 @@ void CSimpleMap::set(
 {
 	MRPT_START
 	ASSERTMSG_(index < m_posesObsPairs.size(), "Index out of bounds");
-	if (in_posePDF)
-		m_posesObsPairs[index].pose =
-			CPose3DPDF::Ptr(CPose3DPDF::createFrom2D(*in_posePDF));
-	if (in_SF) m_posesObsPairs[index].sf = in_SF;
+	CPose3DPDF::Ptr pose3D;
+	if (in_posePDF) pose3D.reset(CPose3DPDF::createFrom2D(*in_posePDF));
+	set(index, pose3D, in_SF);
 
 	MRPT_END
 }
@@ -93,6 +179,7 @@ void CSimpleMap::insert(
 	pair.pose = in_posePDF;
 
 	m_posesObsPairs.push_back(pair);
+	if (m_extStorage) m_extFrames.emplace_back();
 
 	MRPT_END
 }
@@ -109,6 +196,7 @@ void CSimpleMap::insert(
 	ASSERT_(pair.pose);
 
 	m_posesObsPairs.push_back(pair);
+	if (m_extStorage) m_extFrames.emplace_back();
 
 	MRPT_END
 }
@@ -124,6 +212,7 @@ void CSimpleMap::insert(const CPosePDF& in_posePDF, const CSensoryFrame& in_SF)
 	ASSERT_(pair.pose);
 
 	m_posesObsPairs.push_back(pair);
+	if (m_extStorage) m_extFrames.emplace_back();
 
 	MRPT_END
 }
@@ -138,11 +227,13 @@ uint8_t CSimpleMap::serializeGetVersion() const { return 1; }
 void CSimpleMap::serializeTo(mrpt::serialization::CArchive& out) const
 {
 	out.WriteAs<uint32_t>(m_posesObsPairs.size());
-	for (const auto& p : m_posesObsPairs)
+	for (size_t i = 0; i < m_posesObsPairs.size(); i++)
 	{
+		const auto& p = m_posesObsPairs[i];
+		const auto sf = readFrameNoCache(i);
 		ASSERT_(p.pose);
-		ASSERT_(p.sf);
-		out << *p.pose << *p.sf;
+		ASSERT_(sf);
+		out << *p.pose << *sf;
 	}
 }
 
@@ -206,6 +297,8 @@ bool CSimpleMap::saveToFile(const std::string& filName) const
 
 bool CSimpleMap::loadFromFile(const std::string& filName)
 {
+	if (IsExternalStorageFile(filName))
+		return loadFromExternalStorageFile(filName);
 	try
 	{
 		mrpt::io::CFileGZInputStream fi(filName);
@@ -217,3 +310,206 @@ bool CSimpleMap::loadFromFile(const std::string& filName)
 		return false;
 	}
 }
+
+bool CSimpleMap::saveToExternalStorageFile(const std::string& fileName) const
+{
+	try
+	{
+		ASSERTMSG_(
+			fileName != getExternalStorageFile(),
+			"Cannot overwrite the file this map is being read from");
+
+		mrpt::io::CFileOutputStream f;
+		if (!f.open(fileName)) return false;
+		f.Write(EXT_STORAGE_MAGIC, 8);
+		auto arch = archiveFrom(f);
+		arch << EXT_STORAGE_VERSION;
+
+		std::vector<TExternalFrame> frames(m_posesObsPairs.size());
+		for (size_t i = 0; i < frames.size(); i++)
+		{
+			const auto sf = readFrameNoCache(i);
+			ASSERT_(sf);
+			frames[i].offset = f.getPosition();
+			arch << *sf;
+			frames[i].size = f.getPosition() - frames[i].offset;
+		}
+
+		const uint64_t indexOffset = f.getPosition();
+		arch.WriteAs<uint64_t>(frames.size());
+		for (size_t i = 0; i < frames.size(); i++)
+		{
+			ASSERT_(m_posesObsPairs[i].pose);
+			arch << *m_posesObsPairs[i].pose << frames[i].offset
+				 << frames[i].size;
+		}
+		arch << indexOffset;
+		return true;
+	}
+	catch (...)
+	{
+		return false;
+	}
+}
+
+bool CSimpleMap::loadFromExternalStorageFile(
+	const std::string& fileName, size_t memoryBudget)
+{
+	clear();
+	try
+	{
+		auto es = std::make_shared<TExternalStorage>();
+		if (!es->open(fileName)) return false;
+
+		char magic[8];
+		if (es->f.Read(magic, 8) != 8 ||
+			std::memcmp(magic, EXT_STORAGE_MAGIC, 8) != 0)
+			THROW_EXCEPTION("Not an external storage simplemap file");
+
+		auto arch = archiveFrom(es->f);
+		uint32_t version;
+		arch >> version;
+		if (version != EXT_STORAGE_VERSION)
+			THROW_EXCEPTION_FMT(
+				"Unsupported external storage simplemap version: %u",
+				static_cast<unsigned>(version));
+
+		const uint64_t fileSize = es->f.getTotalBytesCount();
+		ASSERT_GE_(fileSize, 8 + sizeof(uint32_t) + 2 * sizeof(uint64_t));
+		es->f.Seek(fileSize - sizeof(uint64_t));
+		uint64_t indexOffset;
+		arch >> indexOffset;
+		ASSERT_LT_(indexOffset, fileSize);
+		es->f.Seek(indexOffset);
+
+		const auto n = arch.ReadAs<uint64_t>();
+		m_posesObsPairs.resize(n);
+		m_extFrames.resize(n);
+		for (size_t i = 0; i < n; i++)
+		{
+			auto& e = m_extFrames[i];
+			arch >> m_posesObsPairs[i].pose >> e.offset >> e.size;
+			ASSERT_(m_posesObsPairs[i].pose);
+			ASSERT_GT_(e.size, 0U);
+			ASSERT_LE_(e.offset + e.size, indexOffset);
+		}
+		es->memoryBudget = memoryBudget;
+		m_extStorage = std::move(es);
+		return true;
+	}
+	catch (...)
+	{
+		clear();
+		return false;
+	}
+}
+
+bool CSimpleMap::IsExternalStorageFile(const std::string& fileName)
+{
+	mrpt::io::CFileInputStream f;
+	if (!f.open(fileName)) return false;
+	char magic[8];
+	return f.Read(magic, 8) == 8 &&
+		std::memcmp(magic, EXT_STORAGE_MAGIC, 8) == 0;
+}
+
+std::string CSimpleMap::getExternalStorageFile() const
+{
+	return m_extStorage ? m_extStorage->fileName : std::string();
+}
+
+void CSimpleMap::setExternalStorageMemoryBudget(size_t bytes)
+{
+	if (!m_extStorage) return;
+	std::lock_guard<std::mutex> lck(m_extStorage->mtx);
+	m_extStorage->memoryBudget = bytes;
+	enforceMemoryBudget(m_posesObsPairs.size());
+}
+
+size_t CSimpleMap::getExternalStorageMemoryUsage() const
+{
+	if (!m_extStorage) return 0;
+	std::lock_guard<std::mutex> lck(m_extStorage->mtx);
+	return m_extStorage->memoryUsage;
+}
+
+CSensoryFrame::Ptr CSimpleMap::pageIn(size_t index) const
+{
+	ASSERTMSG_(index < m_posesObsPairs.size(), "Index out of bounds");
+	auto& p = m_posesObsPairs[index];
+	if (!m_extStorage) return p.sf;
+
+	auto& es = *m_extStorage;
+	std::lock_guard<std::mutex> lck(es.mtx);
+	auto& e = m_extFrames[index];
+	e.lastUse = ++es.useCounter;
+	if (!p.sf && e.size != 0)
+	{
+		p.sf = es.read(e);
+		es.memoryUsage += e.size;
+		enforceMemoryBudget(index);
+	}
+	return p.sf;
+}
+
+CSensoryFrame::Ptr CSimpleMap::readFrameNoCache(size_t index) const
+{
+	ASSERTMSG_(index < m_posesObsPairs.size(), "Index out of bounds");
+	const auto& p = m_posesObsPairs[index];
+	if (!m_extStorage) return p.sf;
+
+	std::lock_guard<std::mutex> lck(m_extStorage->mtx);
+	if (p.sf || m_extFrames[index].size == 0) return p.sf;
+	return m_extStorage->read(m_extFrames[index]);
+}
+
+void CSimpleMap::enforceMemoryBudget(size_t keepIndex) const
+{
+	auto& es = *m_extStorage;
+	while (es.memoryBudget != 0 && es.memoryUsage > es.memoryBudget)
+	{
+		// Least recently used frame, not in use elsewhere:
+		const size_t N = m_extFrames.size();
+		size_t lru = N;
+		for (size_t i = 0; i < N; i++)
+		{
+			const auto& sf = m_posesObsPairs[i].sf;
+			if (i == keepIndex || m_extFrames[i].size == 0 || !sf ||
+				sf.use_count() > 1)
+				continue;
+			if (lru == N || m_extFrames[i].lastUse < m_extFrames[lru].lastUse)
+				lru = i;
+		}
+		if (lru == N) break;  // All loaded frames are in use
+
+		m_posesObsPairs[lru].sf.reset();
+		es.memoryUsage -= m_extFrames[lru].size;
+	}
+}
+
+void CSimpleMap::unload(size_t index) const
+{
+	ASSERTMSG_(index < m_posesObsPairs.size(), "Index out of bounds");
+	if (!m_extStorage) return;
+
+	std::lock_guard<std::mutex> lck(m_extStorage->mtx);
+	auto& sf = m_posesObsPairs[index].sf;
+	if (!sf || m_extFrames[index].size == 0) return;
+	sf.reset();
+	m_extStorage->memoryUsage -= m_extFrames[index].size;
+}
+
+void CSimpleMap::unload() const
+{
+	for (size_t i = 0; i < m_posesObsPairs.size(); i++)
+		unload(i);
+}
+
+bool CSimpleMap::isLoaded(size_t index) const
+{
+	ASSERTMSG_(index < m_posesObsPairs.size(), "Index out of bounds");
+	if (!m_extStorage) return m_posesObsPairs[index].sf != nullptr;
+
+	std::lock_guard<std::mutex> lck(m_extStorage->mtx);
+	return m_posesObsPairs[index].sf != nullptr;
+}
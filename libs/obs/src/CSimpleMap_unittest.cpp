@@ -9,6 +9,7 @@
 
 #include <gtest/gtest.h>
 #include <mrpt/maps/CSimpleMap.h>
+#include <mrpt/system/filesystem.h>
 #include <test_mrpt_common.h>
 
 TEST(CSimpleMap, ParseFileInFormat_v1_5)
@@ -22,3 +23,69 @@ TEST(CSimpleMap, ParseFileInFormat_v1_5)
 	EXPECT_TRUE(load_ok);
 	EXPECT_EQ(sm.size(), 72U);
 }
+
+TEST(CSimpleMap, ExternalStorage)
+{
+	const std::string fil = mrpt::UNITTEST_BASEDIR +
+		std::string("/share/mrpt/datasets/localization_demo.simplemap.gz");
+
+	mrpt::maps::CSimpleMap sm;
+	ASSERT_TRUE(sm.loadFromFile(fil));
+	EXPECT_FALSE(sm.isExternallyStored());
+
+	const auto extFil = mrpt::system::getTempFileName();
+	ASSERT_TRUE(sm.saveToExternalStorageFile(extFil));
+	EXPECT_TRUE(mrpt::maps::CSimpleMap::IsExternalStorageFile(extFil));
+	EXPECT_FALSE(mrpt::maps::CSimpleMap::IsExternalStorageFile(fil));
+
+	// A budget for (roughly) a few frames:
+	const size_t budget = 3 * mrpt::system::getFileSize(extFil) / sm.size();
+
+	mrpt::maps::CSimpleMap ext;
+	ASSERT_TRUE(ext.loadFromFile(extFil));
+	ASSERT_TRUE(ext.isExternallyStored());
+	ext.setExternalStorageMemoryBudget(budget);
+	ASSERT_EQ(ext.size(), sm.size());
+	EXPECT_FALSE(ext.isLoaded(0));
+
+	for (size_t i = 0; i < sm.size(); i++)
+	{
+		const auto [pose, sf] = sm.get(i);
+		const auto [extPose, extSf] = ext.get(i);
+		ASSERT_TRUE(extSf);
+		EXPECT_TRUE(ext.isLoaded(i));
+		EXPECT_EQ(
+			pose->getMeanVal().asTPose(), extPose->getMeanVal().asTPose());
+		ASSERT_EQ(sf->size(), extSf->size());
+		for (size_t k = 0; k < sf->size(); k++)
+			EXPECT_EQ(
+				sf->getObservationByIndex(k)->timestamp,
+				extSf->getObservationByIndex(k)->timestamp);
+	}
+	// Frames were unloaded to keep memory within the budget:
+	size_t numLoaded = 0;
+	for (size_t i = 0; i < ext.size(); i++)
+		if (ext.isLoaded(i)) numLoaded++;
+	EXPECT_FALSE(ext.isLoaded(0));
+	EXPECT_LT(numLoaded, ext.size() / 2);
+
+	ext.unload();
+	EXPECT_EQ(ext.getExternalStorageMemoryUsage(), 0U);
+
+	// Copies and regular serialization read all frames from the file:
+	const mrpt::maps::CSimpleMap extCopy = ext;
+	EXPECT_TRUE(extCopy.isExternallyStored());
+	const auto regFil = mrpt::system::getTempFileName();
+	ASSERT_TRUE(extCopy.saveToFile(regFil));
+
+	mrpt::maps::CSimpleMap sm2;
+	ASSERT_TRUE(sm2.loadFromFile(regFil));
+	EXPECT_FALSE(sm2.isExternallyStored());
+	ASSERT_EQ(sm2.size(), sm.size());
+	EXPECT_EQ(
+		std::get<1>(sm2.get(sm.size() - 1))->size(),
+		std::get<1>(sm.get(sm.size() - 1))->size());
+
+	mrpt::system::deleteFile(extFil);
+	mrpt::system::deleteFile(regFil);
+}
@@ -9,10 +9,11 @@
 
 #include "obs-precomp.h"  // Precompiled headers
 //
-#include <mrpt/core/lock_helper.h>
 #include <mrpt/obs/CObservation2DRangeScan.h>
 #include <mrpt/obs/CSinCosLookUpTableFor2DScans.h>
 
+#include <atomic>
+
 using namespace std;
 using namespace mrpt::obs;
 
@@ -29,57 +30,106 @@ const CSinCosLookUpTableFor2DScans::TSinCosValues&
 	return getSinCosForScan(scan_prop);
 }
 
-/** Return two vectors with the cos and the sin of the angles for each of the
- * rays in a scan, computing them only the first time and returning a cached
- * copy the rest.
- */
 const CSinCosLookUpTableFor2DScans::TSinCosValues&
 	CSinCosLookUpTableFor2DScans::getSinCosForScan(
 		const T2DScanProperties& scan_prop) const
 {
-	auto lck = mrpt::lockHelper(m_cache_mtx);
+	std::lock_guard<std::mutex> lck(m_cache_mtx);
 
 	auto it = m_cache.find(scan_prop);
 	if (it != m_cache.end())
 	{  // Found in the cache:
-		return it->second;
+		return *it->second;
 	}
-	else
+
+	// If there're too many LUTs, something is wrong, so just free the
+	// memory:
+	// (If you someday find someone with TWENTY *different* laser scanner
+	// models, please, accept my apologies... but send me a photo of them
+	// all!! ;-)
+	if (m_cache.size() > 20) m_cache.clear();
+
+	auto& entry = m_cache[scan_prop];
+	entry = getSharedSinCosForScan(scan_prop);
+	return *entry;
+}
+
+namespace
+{
+using shared_cache_t = std::map<
+	T2DScanProperties,
+	std::shared_ptr<const CSinCosLookUpTableFor2DScans::TSinCosValues>>;
+
+// Read-copy-update: readers take a snapshot of the current map without any
+// lock; writers (only upon new scan properties) copy it, insert the new
+// table, and publish the new map.
+struct SharedCache
+{
+	std::shared_ptr<const shared_cache_t> tables =
+		std::make_shared<const shared_cache_t>();
+	std::mutex writeMtx;
+
+	static SharedCache& Instance()
 	{
-		// If there're too many LUTs, something is wrong, so just free the
-		// memory:
-		// (If you someday find someone with TWENTY *different* laser scanner
-		// models,
-		//   please, accept my apologies... but send me a photo of them all!!
-		//   ;-)
-		if (m_cache.size() > 20) m_cache.clear();
-
-		// Compute and insert in the cache:
-		TSinCosValues& new_entry = m_cache[scan_prop];
-
-		// Make sure the allocated memory at least have room for 4 extra
-		// double's at the end,
-		//  for the case we use these buffers for SSE2 optimized code. If the
-		//  final values are uninitialized it doesn't matter.
-		new_entry.ccos.resize(scan_prop.nRays + 4);
-		new_entry.csin.resize(scan_prop.nRays + 4);
-
-		ASSERT_(scan_prop.nRays >= 2);
-		if (scan_prop.nRays > 0)
-		{
-			double Ang =
-				(scan_prop.rightToLeft ? -0.5 : +0.5) * scan_prop.aperture;
-			const double dA = (scan_prop.rightToLeft ? 1.0 : -1.0) *
-				(scan_prop.aperture / (scan_prop.nRays - 1));
-
-			for (size_t i = 0; i < scan_prop.nRays; i++)
-			{
-				new_entry.ccos[i] = d2f(cos(Ang));
-				new_entry.csin[i] = d2f(sin(Ang));
-				Ang += dA;
-			}
-		}
-		// return them:
-		return new_entry;
+		static SharedCache c;
+		return c;
 	}
+};
+
+std::shared_ptr<const CSinCosLookUpTableFor2DScans::TSinCosValues>
+	computeSinCos(const T2DScanProperties& scan_prop)
+{
+	ASSERT_(scan_prop.nRays >= 2);
+
+	auto new_entry =
+		std::make_shared<CSinCosLookUpTableFor2DScans::TSinCosValues>();
+
+	// Make sure the allocated memory at least have room for 4 extra
+	// values at the end, for the case we use these buffers for SIMD
+	// optimized code. If the final values are uninitialized it doesn't
+	// matter.
+	new_entry->ccos.resize(scan_prop.nRays + 4);
+	new_entry->csin.resize(scan_prop.nRays + 4);
+
+	double Ang = (scan_prop.rightToLeft ? -0.5 : +0.5) * scan_prop.aperture;
+	const double dA = (scan_prop.rightToLeft ? 1.0 : -1.0) *
+		(scan_prop.aperture / (scan_prop.nRays - 1));
+
+	for (size_t i = 0; i < scan_prop.nRays; i++)
+	{
+		new_entry->ccos[i] = mrpt::d2f(cos(Ang));
+		new_entry->csin[i] = mrpt::d2f(sin(Ang));
+		Ang += dA;
+	}
+	return new_entry;
+}
+}  // namespace
+
+std::shared_ptr<const CSinCosLookUpTableFor2DScans::TSinCosValues>
+	CSinCosLookUpTableFor2DScans::getSharedSinCosForScan(
+		const T2DScanProperties& scan_prop)
+{
+	auto& sc = SharedCache::Instance();
+	{
+		const auto tables = std::atomic_load(&sc.tables);
+		auto it = tables->find(scan_prop);
+		if (it != tables->end()) return it->second;
+	}
+
+	auto new_entry = computeSinCos(scan_prop);
+
+	std::lock_guard<std::mutex> lck(sc.writeMtx);
+	const auto tables = std::atomic_load(&sc.tables);
+	if (auto it = tables->find(scan_prop); it != tables->end())
+		return it->second;	// Inserted by another thread meanwhile
+
+	// Too many different tables: start again (tables still in use remain
+	// alive in their owners):
+	auto new_tables = tables->size() > 64
+		? std::make_shared<shared_cache_t>()
+		: std::make_shared<shared_cache_t>(*tables);
+	new_tables->emplace(scan_prop, new_entry);
+	std::atomic_store(
+		&sc.tables, std::shared_ptr<const shared_cache_t>(new_tables));
+	return new_entry;
 }
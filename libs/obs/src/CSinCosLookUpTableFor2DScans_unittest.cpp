@@ -0,0 +1,53 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/core/bits_math.h>
+#include <mrpt/obs/CSinCosLookUpTableFor2DScans.h>
+
+#include <cmath>
+#include <thread>
+#include <vector>
+
+TEST(CSinCosLookUpTableFor2DScans, sharedTablesFromManyThreads)
+{
+	using mrpt::obs::CSinCosLookUpTableFor2DScans;
+
+	mrpt::obs::T2DScanProperties p;
+	p.nRays = 361;
+	p.aperture = M_PIf;
+	p.rightToLeft = true;
+
+	const auto shared = CSinCosLookUpTableFor2DScans::getSharedSinCosForScan(p);
+	ASSERT_TRUE(shared);
+	EXPECT_NEAR(shared->ccos[0], 0.0f, 1e-6f);
+	EXPECT_NEAR(shared->csin[0], -1.0f, 1e-6f);
+	EXPECT_NEAR(shared->ccos[180], 1.0f, 1e-6f);
+
+	// All threads and objects get the same table:
+	std::vector<std::thread> threads;
+	std::vector<const void*> tables(8);
+	for (size_t t = 0; t < tables.size(); t++)
+		threads.emplace_back([&, t]() {
+			CSinCosLookUpTableFor2DScans lut;
+			auto q = p;
+			for (size_t n = 2; n < 30; n++)
+			{
+				q.nRays = n;
+				const auto& v = lut.getSinCosForScan(q);
+				EXPECT_EQ(static_cast<size_t>(v.ccos.size()), n + 4);
+			}
+			tables[t] = &lut.getSinCosForScan(p);
+		});
+	for (auto& th : threads)
+		th.join();
+
+	for (const auto* t : tables)
+		EXPECT_EQ(t, shared.get());
+}
@@ -76,6 +76,8 @@ void TSetOfMetricMapInitializers::loadFromConfigFile(
 	// Delete previous contents:
 	clear();
 
+	numThreads = ini.read_uint64_t(sectionName, "numThreads", numThreads);
+
 	TMetricMapTypesRegistry& mmr = TMetricMapTypesRegistry::Instance();
 
 	const auto& allMapKinds = mmr.getAllRegistered();
@@ -114,6 +116,7 @@ void TSetOfMetricMapInitializers::loadFromConfigFile(
 void TSetOfMetricMapInitializers::saveToConfigFile(
 	mrpt::config::CConfigFileBase& target, const std::string& section) const
 {
+	target.write(section, "numThreads", numThreads);
 	for (auto& mi : *this)
 		mi->saveToConfigFile(target, section);
 }
@@ -125,7 +128,8 @@ void TSetOfMetricMapInitializers::dumpToTextStream(std::ostream& out) const
 		   "      Set of internal maps for 'CMultiMetricMap' object\n\n"
 		   "=================================================================\n"
 		   "Showing next the "
-		<< this->size() << " internal maps:\n\n";
+		<< this->size() << " internal maps (numThreads=" << numThreads
+		<< "):\n\n";
 
 	int i = 0;
 	for (auto it = begin(); it != end(); ++it, i++)
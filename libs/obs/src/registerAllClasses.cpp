@@ -46,6 +46,7 @@ MRPT_INITIALIZER(registerAllClasses_mrpt_obs)
 	registerClass(CLASS_ID(CObservationGPS));
 	registerClass(CLASS_ID(CObservationImage));
 	registerClass(CLASS_ID(CObservationIMU));
+	registerClass(CLASS_ID(CObservationIMUBatch));
 	registerClass(CLASS_ID(CObservationOdometry));
 	registerClass(CLASS_ID(CObservationRange));
 	registerClass(CLASS_ID(CObservationReflectivity));
@@ -54,6 +55,7 @@ MRPT_INITIALIZER(registerAllClasses_mrpt_obs)
 	registerClass(CLASS_ID(CObservation6DFeatures));
 	registerClass(CLASS_ID(CObservationRobotPose));
 	registerClass(CLASS_ID(CObservationCANBusJ1939));
+	registerClass(CLASS_ID(CObservationCANBusBatch));
 	registerClass(CLASS_ID(CObservationRawDAQ));
 
 	registerClass(CLASS_ID(CSimpleMap));
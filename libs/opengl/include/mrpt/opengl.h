@@ -28,14 +28,17 @@
 #include <mrpt/opengl/COpenGLScene.h>
 #include <mrpt/opengl/COpenGLViewport.h>
 #include <mrpt/opengl/CPointCloud.h>
+#include <mrpt/opengl/CPointCloudBlocks.h>
 #include <mrpt/opengl/CPointCloudColoured.h>
 #include <mrpt/opengl/CRenderizable.h>
+#include <mrpt/opengl/CSetOfInstances.h>
 #include <mrpt/opengl/CSetOfLines.h>
 #include <mrpt/opengl/CSetOfObjects.h>
 #include <mrpt/opengl/CSetOfTexturedTriangles.h>
 #include <mrpt/opengl/CSetOfTriangles.h>
 #include <mrpt/opengl/CSimpleLine.h>
 #include <mrpt/opengl/CSphere.h>
+#include <mrpt/opengl/CTerrainMesh.h>
 #include <mrpt/opengl/CText.h>
 #include <mrpt/opengl/CText3D.h>
 #include <mrpt/opengl/CTexturedPlane.h>
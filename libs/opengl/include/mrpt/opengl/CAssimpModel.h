@@ -110,6 +110,40 @@ class CAssimpModel : public CRenderizableShaderTriangles,
 	/** Empty the object */
 	void clear();
 
+	/** @name Processed mesh cache
+	 * @{ */
+
+	/** Sets a directory where loadScene() stores the result of importing and
+	 * processing each model with assimp: its triangles, lines and points, as
+	 * the GPU-ready buffers to be uploaded to OpenGL. Later loads of the same
+	 * file with the same flags read them from there in a single pass and skip
+	 * assimp, which may take much longer for large models.
+	 *
+	 * Cache files are named after the MD5 hash of the contents of the model
+	 * file and the load flags, so a modified model is processed again. Note
+	 * that changes in other files referenced by a model (e.g. the .mtl
+	 * materials of .obj files) are not detected. Texture images are always
+	 * loaded from their files.
+	 *
+	 * An empty string (default) disables the cache. The directory is created
+	 * if it does not exist.
+	 * \sa loadedFromMeshCache
+	 * 
+ote (New in MRPT 2.4.9)
+	 */
+	static void setMeshCacheDirectory(const std::string& dir);
+	/** \sa setMeshCacheDirectory */
+	static std::string getMeshCacheDirectory();
+
+	/** Whether the last loadScene() read the model from the mesh cache.
+	 * \sa setMeshCacheDirectory
+	 * 
+ote (New in MRPT 2.4.9)
+	 */
+	bool loadedFromMeshCache() const { return m_loadedFromMeshCache; }
+
+	/** @} */
+
 	/* Simulation of ray-trace. */
 	bool traceRay(const mrpt::poses::CPose3D& o, double& dist) const override;
 
@@ -140,11 +174,18 @@ class CAssimpModel : public CRenderizableShaderTriangles,
 	// handling to that class:
 	mutable std::vector<CSetOfTexturedTriangles::Ptr> m_texturedObjects;
 	bool m_verboseLoad = false;
+	bool m_loadedFromMeshCache = false;
 
 	void recursive_render(
 		const aiScene* sc, const aiNode* nd, const mrpt::poses::CPose3D& transf,
 		mrpt::opengl::internal::RenderElements& re);
 	void process_textures(const aiScene* scene);
+	/** Creates one textured object per entry in m_textureIdMap */
+	void load_textures();
+
+	/** \return false if the file does not exist or is not a valid cache */
+	bool loadMeshCache(const std::string& cacheFile);
+	void saveMeshCache(const std::string& cacheFile) const;
 
 };	// namespace mrpt::opengl
 
@@ -13,6 +13,10 @@
 #include <mrpt/img/CImage.h>
 #include <mrpt/opengl/COpenGLFramebuffer.h>
 #include <mrpt/opengl/COpenGLScene.h>
+#include <mrpt/poses/CPose3D.h>
+
+#include <functional>
+#include <vector>
 
 namespace mrpt::opengl
 {
@@ -89,6 +93,76 @@ class CFBORender
 	void render_depth(
 		const COpenGLScene& scene, mrpt::math::CMatrixFloat& outDepth);
 
+	/** @name Batch rendering
+	 *  @{ */
+
+	/** Options for render_batch() */
+	struct TBatchOptions
+	{
+		bool rgb = true;
+		bool depth = true;
+		/** Number of frames in flight, each one with its own framebuffer
+		 * and pixel buffer objects (>=1) */
+		unsigned int numBuffers = 3;
+	};
+
+	/** One frame of render_batch(). The images are reused for later frames,
+	 * so copy them if they are needed after the callback returns. */
+	struct TBatchFrame
+	{
+		/** Index of the camera pose */
+		size_t index = 0;
+		/** Empty if TBatchOptions::rgb is false */
+		mrpt::img::CImage rgb;
+		/** Linear depth, as in render_RGBD(). Empty if TBatchOptions::depth
+		 * is false. \sa depthToRangeImage() */
+		mrpt::math::CMatrixFloat depth;
+	};
+	using batch_callback_t = std::function<void(const TBatchFrame&)>;
+
+	/** Renders the scene from many camera poses, passing the images of each
+	 * one to `callback`, in the same order as the poses.
+	 *
+	 * The scene `"main"` viewport camera is set to 6DOF mode and moved to
+	 * each pose, keeping its projection parameters, and it is restored
+	 * afterwards. Each frame is rendered into one of a ring of framebuffers
+	 * and read back asynchronously through pixel buffer objects, so the
+	 * transfer of a frame to the CPU overlaps rendering the next ones: the
+	 * callback of each frame is invoked (from this thread) while rendering
+	 * the frame `numBuffers` positions later, or at the end.
+	 *
+	 * Together with the display-less EGL context created by the
+	 * constructor, this allows synthesizing images on headless machines.
+	 *
+	 * \note (New in MRPT 2.4.9)
+	 */
+	void render_batch(
+		const COpenGLScene& scene,
+		const std::vector<mrpt::poses::CPose3D>& cameraPoses,
+		const batch_callback_t& callback, const TBatchOptions& options);
+
+	/** \overload With default options */
+	void render_batch(
+		const COpenGLScene& scene,
+		const std::vector<mrpt::poses::CPose3D>& cameraPoses,
+		const batch_callback_t& callback)
+	{
+		render_batch(scene, cameraPoses, callback, TBatchOptions());
+	}
+
+	/** Converts a depth image from render_RGBD() or render_batch() into a
+	 * range image like mrpt::obs::CObservation3DRangeScan::rangeImage, with
+	 * the given units (the scan `rangeUnits`, e.g. 1e-3 for millimeters).
+	 * Note that values are depths, so the scan `range_is_depth` must be true.
+	 * Pixels without depth, or out of the range of uint16_t, are set to 0.
+	 * \note (New in MRPT 2.4.9)
+	 */
+	static void depthToRangeImage(
+		const mrpt::math::CMatrixFloat& depth,
+		mrpt::math::CMatrix_u16& rangeImage, float rangeUnits = 0.001f);
+
+	/** @} */
+
    protected:
 	COpenGLFramebuffer m_fb;
 
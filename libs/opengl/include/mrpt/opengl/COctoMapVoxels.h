@@ -9,10 +9,16 @@
 #pragma once
 
 #include <mrpt/math/TPoint3D.h>
+#include <mrpt/opengl/COpenGLBuffer.h>
+#include <mrpt/opengl/COpenGLVertexArrayObject.h>
 #include <mrpt/opengl/CRenderizableShaderPoints.h>
 #include <mrpt/opengl/CRenderizableShaderTriangles.h>
 #include <mrpt/opengl/CRenderizableShaderWireFrame.h>
 
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+
 namespace mrpt::opengl
 {
 enum predefined_voxel_sets_t
@@ -55,6 +61,11 @@ enum predefined_voxel_sets_t
  * Several coloring schemes can be selected with setVisualizationMode(). See
  *COctoMapVoxels::visualization_mode_t
  *
+ * Voxels are drawn as instances of one cube. They can be organized in
+ * groups (see setVoxelGroup()) to replace some of them without regenerating
+ * nor uploading again the rest to the GPU, e.g. with
+ * mrpt::maps::COctoMapBase::updateOctoMapVoxels().
+ *
  * ![mrpt::opengl::COctoMapVoxels](preview_COctoMapVoxels.png)
  *
  * \sa opengl::COpenGLScene
@@ -144,6 +155,41 @@ class COctoMapVoxels : public CRenderizableShaderTriangles,
 	mrpt::img::TColor m_grid_color;
 	visualization_mode_t m_visual_mode{COctoMapVoxels::COLOR_FROM_OCCUPANCY};
 
+	/** Bookkeeping of the voxel groups of one voxel set */
+	struct TVoxelGroups
+	{
+		/** Indices of the voxels of each group */
+		std::unordered_map<uint64_t, std::vector<size_t>> groups;
+		/** The group of each voxel, where voxels without group are
+		 * NO_VOXEL_GROUP (may be shorter than the list of voxels) */
+		std::vector<uint64_t> voxelGroup;
+		/** Voxels modified since the last upload to the GPU */
+		mutable std::vector<size_t> modified;
+	};
+	std::vector<TVoxelGroups> m_voxel_groups;
+
+	static constexpr uint64_t NO_VOXEL_GROUP =
+		std::numeric_limits<uint64_t>::max();
+
+	/** Voxel instances (pose and color) buffers of one voxel set */
+	struct TVoxelSetBuffers
+	{
+		COpenGLBuffer poses, colors;
+		/** Number of voxels in the buffers, and allocated room */
+		size_t count = 0, capacity = 0;
+	};
+	mutable std::vector<TVoxelSetBuffers> m_voxel_buffers;
+	mutable COpenGLBuffer m_cube_buffer;
+	mutable COpenGLVertexArrayObject m_cube_vao;
+	/** Whether all voxels must be uploaded to the GPU, instead of only those
+	 * in TVoxelGroups::modified */
+	mutable bool m_allVoxelsChanged = true;
+
+	/** Removes a voxel, moving the last one of the set to its place */
+	void eraseVoxel(size_t set_index, size_t idx);
+	void updateVoxelBuffers() const;
+	void renderVoxels(const RenderContext& rc) const;
+
    public:
 	/** @name Renderizable shader API virtual methods
 	 * @{ */
@@ -152,21 +198,24 @@ class COctoMapVoxels : public CRenderizableShaderTriangles,
 
 	virtual shader_list_t requiredShaders() const override
 	{
-		// May use up to two shaders (triangles and lines):
+		// May use up to two shaders (cubes and lines):
 		return {
 			DefaultShaderID::WIREFRAME, DefaultShaderID::POINTS,
-			DefaultShaderID::TRIANGLES};
+			DefaultShaderID::TRIANGLES_INSTANCED};
 	}
 	void onUpdateBuffers_Points() override;
 	void onUpdateBuffers_Wireframe() override;
 	void onUpdateBuffers_Triangles() override;
-	void freeOpenGLResources() override
+	void freeOpenGLResources() override;
+	/** @} */
+
+	/** Like CRenderizable::notifyChange(), also marking all voxels to be
+	 * uploaded again to the GPU. */
+	void notifyChange() const
 	{
-		CRenderizableShaderTriangles::freeOpenGLResources();
-		CRenderizableShaderWireFrame::freeOpenGLResources();
-		CRenderizableShaderPoints::freeOpenGLResources();
+		m_allVoxelsChanged = true;
+		CRenderizable::notifyChange();
 	}
-	/** @} */
 
 	/** Clears everything */
 	void clear();
@@ -176,7 +225,7 @@ class COctoMapVoxels : public CRenderizableShaderTriangles,
 	inline void setVisualizationMode(visualization_mode_t mode)
 	{
 		m_visual_mode = mode;
-		CRenderizable::notifyChange();
+		notifyChange();
 	}
 	inline visualization_mode_t getVisualizationMode() const
 	{
@@ -187,7 +236,7 @@ class COctoMapVoxels : public CRenderizableShaderTriangles,
 	inline void enableLights(bool enable)
 	{
 		m_enable_lighting = enable;
-		CRenderizable::notifyChange();
+		notifyChange();
 	}
 	inline bool areLightsEnabled() const { return m_enable_lighting; }
 	/** By default, the alpha (transparency) component of voxel cubes is taken
@@ -195,7 +244,7 @@ class COctoMapVoxels : public CRenderizableShaderTriangles,
 	inline void enableCubeTransparency(bool enable)
 	{
 		m_enable_cube_transparency = enable;
-		CRenderizable::notifyChange();
+		notifyChange();
 	}
 	inline bool isCubeTransparencyEnabled() const
 	{
@@ -206,7 +255,7 @@ class COctoMapVoxels : public CRenderizableShaderTriangles,
 	inline void showGridLines(bool show)
 	{
 		m_show_grids = show;
-		CRenderizable::notifyChange();
+		notifyChange();
 	}
 	inline bool areGridLinesVisible() const { return m_show_grids; }
 	/** Shows/hides the voxels (voxel_set is a 0-based index for the set of
@@ -215,7 +264,7 @@ class COctoMapVoxels : public CRenderizableShaderTriangles,
 	{
 		ASSERT_(voxel_set < m_voxel_sets.size());
 		m_voxel_sets[voxel_set].visible = show;
-		CRenderizable::notifyChange();
+		notifyChange();
 	}
 	inline bool areVoxelsVisible(unsigned int voxel_set) const
 	{
@@ -228,14 +277,14 @@ class COctoMapVoxels : public CRenderizableShaderTriangles,
 	inline void showVoxelsAsPoints(const bool enable)
 	{
 		m_showVoxelsAsPoints = enable;
-		CRenderizable::notifyChange();
+		notifyChange();
 	}
 	inline bool areVoxelsShownAsPoints() const { return m_showVoxelsAsPoints; }
 	/** Only used when showVoxelsAsPoints() is enabled.  */
 	inline void setVoxelAsPointsSize(float pointSize)
 	{
 		m_showVoxelsAsPointsSize = pointSize;
-		CRenderizable::notifyChange();
+		notifyChange();
 	}
 	inline float getVoxelAsPointsSize() const
 	{
@@ -246,14 +295,14 @@ class COctoMapVoxels : public CRenderizableShaderTriangles,
 	inline void setGridLinesWidth(float w)
 	{
 		m_grid_width = w;
-		CRenderizable::notifyChange();
+		notifyChange();
 	}
 	/** Gets the width of grid lines */
 	inline float getGridLinesWidth() const { return m_grid_width; }
 	inline void setGridLinesColor(const mrpt::img::TColor& color)
 	{
 		m_grid_color = color;
-		CRenderizable::notifyChange();
+		notifyChange();
 	}
 	inline const mrpt::img::TColor& getGridLinesColor() const
 	{
@@ -279,18 +328,18 @@ class COctoMapVoxels : public CRenderizableShaderTriangles,
 	inline void resizeGridCubes(const size_t nCubes)
 	{
 		m_grid_cubes.resize(nCubes);
-		CRenderizable::notifyChange();
+		notifyChange();
 	}
 	inline void resizeVoxelSets(const size_t nVoxelSets)
 	{
 		m_voxel_sets.resize(nVoxelSets);
-		CRenderizable::notifyChange();
+		notifyChange();
 	}
 	inline void resizeVoxels(const size_t set_index, const size_t nVoxels)
 	{
 		ASSERT_(set_index < m_voxel_sets.size());
 		m_voxel_sets[set_index].voxels.resize(nVoxels);
-		CRenderizable::notifyChange();
+		notifyChange();
 	}
 
 	inline void reserveGridCubes(const size_t nCubes)
@@ -301,13 +350,13 @@ class COctoMapVoxels : public CRenderizableShaderTriangles,
 	{
 		ASSERT_(set_index < m_voxel_sets.size());
 		m_voxel_sets[set_index].voxels.reserve(nVoxels);
-		CRenderizable::notifyChange();
+		notifyChange();
 	}
 
 	inline TGridCube& getGridCubeRef(const size_t idx)
 	{
 		ASSERTDEB_(idx < m_grid_cubes.size());
-		CRenderizable::notifyChange();
+		notifyChange();
 		return m_grid_cubes[idx];
 	}
 	inline const TGridCube& getGridCube(const size_t idx) const
@@ -321,7 +370,7 @@ class COctoMapVoxels : public CRenderizableShaderTriangles,
 		ASSERTDEB_(
 			set_index < m_voxel_sets.size() &&
 			idx < m_voxel_sets[set_index].voxels.size());
-		CRenderizable::notifyChange();
+		notifyChange();
 		return m_voxel_sets[set_index].voxels[idx];
 	}
 	inline const TVoxel& getVoxel(
@@ -330,22 +379,46 @@ class COctoMapVoxels : public CRenderizableShaderTriangles,
 		ASSERTDEB_(
 			set_index < m_voxel_sets.size() &&
 			idx < m_voxel_sets[set_index].voxels.size());
-		CRenderizable::notifyChange();
+		notifyChange();
 		return m_voxel_sets[set_index].voxels[idx];
 	}
 
 	inline void push_back_GridCube(const TGridCube& c)
 	{
-		CRenderizable::notifyChange();
+		notifyChange();
 		m_grid_cubes.push_back(c);
 	}
 	inline void push_back_Voxel(const size_t set_index, const TVoxel& v)
 	{
 		ASSERTDEB_(set_index < m_voxel_sets.size());
-		CRenderizable::notifyChange();
+		notifyChange();
 		m_voxel_sets[set_index].voxels.push_back(v);
 	}
 
+	/** @name Voxel groups
+	 * Voxels can be organized in groups, identified by an arbitrary integer
+	 * (e.g. a spatial block of the source map), so one group can be replaced
+	 * without modifying the others. Only the modified voxels are uploaded to
+	 * the GPU in the next render. Voxels inserted with push_back_Voxel() do
+	 * not belong to any group.
+	 * Voxels may be reordered when a group changes, so voxel indices should
+	 * not be kept across calls to setVoxelGroup().
+	 * \note (New in MRPT 2.4.9)
+	 * @{ */
+
+	/** Replaces all the voxels of one group in one voxel set with the given
+	 * ones, creating the group if it does not exist yet, or removing it if
+	 * `voxels` is empty. */
+	void setVoxelGroup(
+		size_t set_index, uint64_t group_id, const std::vector<TVoxel>& voxels);
+
+	/** Number of voxels of one group in one voxel set (0 if the group does
+	 * not exist) */
+	size_t getVoxelGroupSize(size_t set_index, uint64_t group_id) const;
+	/** @} */
+
+	/** Sorts the voxels of each set by ascending Z. This removes all voxel
+	 * groups. */
 	void sort_voxels_by_z();
 
 	mrpt::math::TBoundingBox getBoundingBox() const override;
@@ -14,8 +14,14 @@
 #include <mrpt/opengl/CRenderizable.h>
 #include <mrpt/opengl/CSetOfObjects.h>
 
+#include <algorithm>
 #include <atomic>
+#include <cmath>
+#include <cstdint>
 #include <deque>
+#include <numeric>
+#include <utility>
+#include <vector>
 
 namespace mrpt
 {
@@ -57,8 +63,9 @@ class COctreePointRenderer
 	COctreePointRenderer() = default;
 
 	/** Copy ctor */
-	COctreePointRenderer(const COctreePointRenderer&)
+	COctreePointRenderer(const COctreePointRenderer& o)
 		: m_octree_has_to_rebuild_all(true),
+		  m_octree_lod(o.m_octree_lod),
 		  m_visible_octree_nodes(0),
 		  m_visible_octree_nodes_ongoing(0)
 	{
@@ -113,6 +120,101 @@ class COctreePointRenderer
 		}
 	}
 
+	/** Fills `idxs` with the indices of all points sorted by octree leaf
+	 * node, to be uploaded to the GPU once per octree rebuild for the LOD
+	 * mode (see octree_enable_lod()). The points of each node are in an
+	 * order such that any prefix is a subsample spread over the whole node,
+	 * so each node can be drawn at any detail level without reordering.
+	 */
+	void octree_build_draw_order(std::vector<uint32_t>& idxs)
+	{
+		internal_octree_assure_uptodate();
+
+		const size_t N = octree_derived().size();
+		idxs.clear();
+		idxs.reserve(N);
+		for (TNode& node : m_octree_nodes)
+		{
+			if (!node.is_leaf) continue;
+			const size_t n = node.all ? N : node.pts.size();
+			node.draw_first = idxs.size();
+			node.draw_count = n;
+			if (!n) continue;
+
+			// Visit the points with a stride close to n/golden_ratio, coprime
+			// with n so all of them are visited once:
+			size_t step =
+				std::max<size_t>(1, static_cast<size_t>(0.618034 * n));
+			while (std::gcd(step, n) != 1)
+				step++;
+			for (size_t j = 0, k = 0; j < n; j++)
+			{
+				idxs.push_back(
+					static_cast<uint32_t>(node.all ? k : node.pts[k]));
+				k += step;
+				if (k >= n) k -= n;
+			}
+		}
+	}
+
+	/** Determines the visible octree leaf nodes from the current camera, as
+	 * octree_render() does, and returns them as ranges (first, count) of the
+	 * draw order of octree_build_draw_order(), each count limited to the
+	 * points allowed by OCTREE_RENDER_MAX_DENSITY_POINTS_PER_SQPIXEL() on
+	 * the node screen area. Consecutive ranges are merged.
+	 *
+	 * If `splatScales` is not null, it is filled with the factor by which
+	 * the splats of each range should be enlarged to cover the same surface
+	 * than all the node points, sqrt(draw_count/count), and only ranges with
+	 * the same factor are merged.
+	 */
+	void octree_get_visible_draw_ranges(
+		const mrpt::opengl::TRenderMatrices& ri,
+		std::vector<std::pair<size_t, size_t>>& ranges,
+		std::vector<float>* splatScales = nullptr) const
+	{
+		ranges.clear();
+		if (splatScales) splatScales->clear();
+		m_visible_octree_nodes_ongoing = 0;
+		m_render_queue.clear();
+		if (octree_derived().size() != 0)
+		{
+			mrpt::img::TPixelCoordf cr_px[8];
+			float cr_z[8];
+			octree_recursive_render(
+				OCTREE_ROOT_NODE, ri, cr_px, cr_z,
+				false /* corners are not computed for this first iteration */);
+		}
+		m_visible_octree_nodes = m_visible_octree_nodes_ongoing;
+
+		const float density = mrpt::global_settings::
+			OCTREE_RENDER_MAX_DENSITY_POINTS_PER_SQPIXEL();
+		for (const auto& e : m_render_queue)
+		{
+			const TNode& node = m_octree_nodes[e.node_id];
+			if (!node.draw_count) continue;
+			const auto maxCount = static_cast<size_t>(
+				std::ceil(density * e.render_area_sqpixels));
+			const size_t count =
+				std::max<size_t>(1, std::min(node.draw_count, maxCount));
+
+			const float scale = count < node.draw_count
+				? std::sqrt(static_cast<float>(node.draw_count) / count)
+				: 1.0f;
+
+			if (!ranges.empty() &&
+				ranges.back().first + ranges.back().second ==
+					node.draw_first &&
+				(!splatScales || splatScales->back() == scale))
+				ranges.back().second += count;
+			else
+			{
+				ranges.emplace_back(node.draw_first, count);
+				if (splatScales) splatScales->push_back(scale);
+			}
+		}
+	}
+
 	std::optional<mrpt::math::TBoundingBox> octree_getBoundingBox() const
 	{
 		octree_assure_uptodate();
@@ -169,6 +271,10 @@ class COctreePointRenderer
 		 */
 		size_t child_id[8];
 
+		/** [is_leaf=true] Range of the node points in the draw order of
+		 * octree_build_draw_order() */
+		size_t draw_first{0}, draw_count{0};
+
 		/** update bounding box with a new point: */
 		inline void update_bb(const mrpt::math::TPoint3Df& p)
 		{
@@ -278,6 +384,7 @@ class COctreePointRenderer
 	mutable std::vector<TRenderQueueElement> m_render_queue;
 
 	bool m_octree_has_to_rebuild_all{true};
+	bool m_octree_lod{false};
 	/** First one [0] is always the root node */
 	std::deque<TNode> m_octree_nodes;
 
@@ -723,6 +830,23 @@ class COctreePointRenderer
 		m_octree_has_to_rebuild_all = true;
 	}
 
+	/** Enables the octree level-of-detail rendering mode (default: disabled,
+	 * all points are drawn). In this mode, the point indices sorted by octree
+	 * node are kept in a GPU buffer, rebuilt only when the octree is, and on
+	 * each rendering only the octree leaf nodes within the viewport are
+	 * drawn, all of them in a single draw call, and each one with at most
+	 * OCTREE_RENDER_MAX_DENSITY_POINTS_PER_SQPIXEL() points per squared pixel
+	 * of its size on the screen. Recommended for clouds with millions of
+	 * points, with a smaller OCTREE_RENDER_MAX_POINTS_PER_NODE() value.
+	 * \note (New in MRPT 2.4.9)
+	 */
+	void octree_enable_lod(bool enable = true)
+	{
+		m_octree_lod = enable;
+		octree_derived().notifyChange();
+	}
+	bool octree_is_lod_enabled() const { return m_octree_lod; }
+
 	/** Returns a graphical representation of all the bounding boxes of the
 	 * octree (leaf) nodes.
 	 * \param[in] draw_solid_boxes If false, will draw solid boxes of color \a
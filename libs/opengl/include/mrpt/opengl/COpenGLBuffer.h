@@ -81,6 +81,17 @@ class COpenGLBuffer
 		m_impl->allocate(data, byteCount);
 	}
 
+	/** Overwrites byteCount bytes of the buffer, starting at the given byte
+	 * offset, without reallocating it (glBufferSubData()). The range must be
+	 * within the size passed to the last allocate(), and bind() must be
+	 * called before using this method.
+	 * \note (New in MRPT 2.4.9)
+	 */
+	void write(int offset, const void* data, int byteCount)
+	{
+		m_impl->write(offset, data, byteCount);
+	}
+
    private:
 	struct RAII_Impl
 	{
@@ -95,6 +106,7 @@ class COpenGLBuffer
 		void bind();
 		void unbind();
 		void allocate(const void* data, int byteCount);
+		void write(int offset, const void* data, int byteCount);
 
 		bool created = false;
 		unsigned int buffer_id = 0;
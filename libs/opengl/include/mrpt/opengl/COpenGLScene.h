@@ -204,6 +204,47 @@ class COpenGLScene : public mrpt::serialization::CSerializable
 	 */
 	bool loadFromFile(const std::string& fil);
 
+	/** Saves the scene to a compact block file, where the points of large
+	 * point clouds (objects only drawn with the points shader, with
+	 * `minPoints` points or more) are not serialized, but stored as chunks of
+	 * at most `pointsPerBlock` points, in the memory layout of the GPU
+	 * buffers, optionally compressed. They are replaced in the saved scene by
+	 * mrpt::opengl::CPointCloudBlocks objects, which load them on demand
+	 * while rendering, only if visible, refining the clouds progressively.
+	 *
+	 * Block files can be loaded with loadFromFile() or loadFromBlockFile(),
+	 * and are supported by \ref app_SceneViewer3D. The file must not be
+	 * moved nor modified while loaded scenes are alive.
+	 *
+	 * File format (all integers in the native byte order, little-endian in
+	 * all supported platforms):
+	 *  - 8 bytes: `MRPTSCNB`
+	 *  - `uint32_t`: format version (1), `uint32_t`: 0x01020304 (byte order
+	 *    mark).
+	 *  - `uint64_t`, `uint64_t`: offset and size of the serialized scene.
+	 *  - Point blocks, each one aligned to 4096 bytes.
+	 *  - The scene, serialized with mrpt::serialization::CArchive.
+	 *
+	 * \sa mrpt::opengl::CPointCloudBlocks
+	 * \return false on any error.
+	 * \note (New in MRPT 2.4.9)
+	 */
+	bool saveToBlockFile(
+		const std::string& fil, size_t minPoints = 100000,
+		size_t pointsPerBlock = 65536, bool compress = true) const;
+
+	/** Loads a scene saved with saveToBlockFile(). Points are loaded later, as
+	 * they are rendered.
+	 * \return false on any error.
+	 * \note (New in MRPT 2.4.9)
+	 */
+	bool loadFromBlockFile(const std::string& fil);
+
+	/** Returns whether the given file was saved with saveToBlockFile()
+	 * \note (New in MRPT 2.4.9)
+	 */
+	static bool isBlockFile(const std::string& fil);
+
 	/** Traces a ray
 	 */
 	bool traceRay(const mrpt::poses::CPose3D& o, double& dist) const;
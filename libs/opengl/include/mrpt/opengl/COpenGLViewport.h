@@ -14,6 +14,7 @@
 #include <mrpt/opengl/CSetOfLines.h>
 #include <mrpt/opengl/CSetOfObjects.h>
 #include <mrpt/opengl/CTextMessageCapable.h>
+#include <mrpt/opengl/COpenGLVertexArrayObject.h>
 #include <mrpt/opengl/CTexturedPlane.h>
 #include <mrpt/opengl/Shader.h>
 #include <mrpt/opengl/TLightParameters.h>
@@ -136,9 +137,43 @@ class COpenGLViewport : public mrpt::serialization::CSerializable,
 	}
 	bool isPolygonNicestEnabled() const { return m_OpenGL_enablePolygonNicest; }
 
+	/** Sets the number of threads used to build the queue of objects to
+	 * render in each frame (0: as many as CPU cores; default: 1, the
+	 * rendering thread only). Useful for scenes with many thousands of
+	 * objects. With more than one thread, objects must not be inserted more
+	 * than once in the scene.
+	 * \sa mrpt::opengl::enqueForRendering()
+	 * \note (New in MRPT 2.4.9) */
+	void setRenderQueueNumThreads(unsigned int numThreads);
+	unsigned int getRenderQueueNumThreads() const
+	{
+		return m_renderQueueNumThreads;
+	}
+
 	const TLightParameters& lightParameters() const { return m_lights; }
 	TLightParameters& lightParameters() { return m_lights; }
 
+	/** Enables eye-dome lighting (EDL), a screen-space shading computed from
+	 * the depth buffer after rendering the viewport objects: pixels farther
+	 * from the camera than their neighbors are darkened, which makes the
+	 * shape of unlit geometry like point clouds (see
+	 * CRenderizableShaderPoints::enableSplats()) easy to perceive, and
+	 * outlines silhouettes against the background.
+	 * \param strength Darkening strength (default: 1.0)
+	 * \param radius Distance to the neighbor pixels, in pixels.
+	 * \note Ignored in emscripten builds.
+	 * \note (New in MRPT 2.4.9) */
+	void enableEyeDomeLighting(
+		bool enable = true, float strength = 1.0f, float radius = 1.4f)
+	{
+		m_edl = enable;
+		m_edlStrength = strength;
+		m_edlRadius = radius;
+	}
+	bool isEyeDomeLightingEnabled() const { return m_edl; }
+	float getEyeDomeLightingStrength() const { return m_edlStrength; }
+	float getEyeDomeLightingRadius() const { return m_edlRadius; }
+
 	/** @} */
 
 	/** @name Change or read viewport properties (except "viewport modes")
@@ -399,6 +434,9 @@ class COpenGLViewport : public mrpt::serialization::CSerializable,
 	/** Render the viewport border, if enabled */
 	void renderViewportBorder() const;
 
+	/** Applies eye-dome lighting to the viewport area, if enabled */
+	void renderEyeDomeLighting(int vx, int vy, int vw, int vh) const;
+
 	/** The camera associated to the viewport */
 	opengl::CCamera m_camera;
 
@@ -462,8 +500,28 @@ class COpenGLViewport : public mrpt::serialization::CSerializable,
 	// OpenGL global settings:
 	bool m_OpenGL_enablePolygonNicest{true};
 
+	unsigned int m_renderQueueNumThreads{1};
+	/** Created on demand, if m_renderQueueNumThreads!=1 */
+	mutable std::shared_ptr<mrpt::WorkerThreadsPool> m_renderQueuePool;
+
 	TLightParameters m_lights;
 
+	bool m_edl{false};
+	float m_edlStrength{1.0f}, m_edlRadius{1.4f};
+	/** OpenGL resources for eye-dome lighting: a copy of the depth buffer.
+	 * Not shared by copies of the viewport. */
+	struct EDLResources
+	{
+		EDLResources() = default;
+		EDLResources(const EDLResources&) {}
+		EDLResources& operator=(const EDLResources&) { return *this; }
+
+		unsigned int depthTexture = 0;
+		int width = 0, height = 0;
+		COpenGLVertexArrayObject vao;
+	};
+	mutable EDLResources m_edlResources;
+
 	/** Renders all messages in the underlying class CTextMessageCapable */
 	void renderTextMessages() const;
 };
@@ -9,11 +9,14 @@
 #pragma once
 
 #include <mrpt/math/TPoint3D.h>
+#include <mrpt/math/TPointCloudView.h>
 #include <mrpt/opengl/COctreePointRenderer.h>
 #include <mrpt/opengl/CRenderizableShaderPoints.h>
 #include <mrpt/opengl/PLY_import_export.h>
 #include <mrpt/opengl/pointcloud_adapters.h>
 
+#include <optional>
+
 namespace mrpt::opengl
 {
 /** A cloud of points, all with the same color or each depending on its value
@@ -138,6 +141,19 @@ class CPointCloud : public CRenderizableShaderPoints,
 	/// \overload Prefer setAllPointsFast() instead
 	void setAllPoints(const std::vector<mrpt::math::TPoint3D>& pts);
 
+	/** \overload Set the list of (X,Y,Z) point coordinates from a non-owning
+	 * point cloud view (e.g. a sensor buffer), without intermediary copies.
+	 * \note (New in MRPT 2.4.9) */
+	void setAllPoints(const mrpt::math::TPointCloudView& pts)
+	{
+		const auto N = pts.size();
+		m_points.resize(N);
+		for (size_t i = 0; i < N; i++)
+			m_points[i] = {pts.x[i], pts.y[i], pts.z[i]};
+		m_minmax_valid = false;
+		markAllPointsAsNew();
+	}
+
 	/** Set the list of (X,Y,Z) point coordinates, DESTROYING the contents
 	 * of the input vectors (via swap) */
 	void setAllPointsFast(std::vector<mrpt::math::TPoint3Df>& pts)
@@ -160,7 +176,8 @@ class CPointCloud : public CRenderizableShaderPoints,
 
 	bool empty() const { return m_points.empty(); }
 
-	/** Adds a new point to the cloud */
+	/** Adds a new point to the cloud. If all points have the same color,
+	 * only the new points are uploaded to the GPU in the next rendering. */
 	void insertPoint(float x, float y, float z);
 
 	void insertPoint(const mrpt::math::TPoint3Df& p)
@@ -197,7 +214,8 @@ class CPointCloud : public CRenderizableShaderPoints,
 	{
 		m_points[i] = {x, y, z};
 		m_minmax_valid = false;
-		markAllPointsAsNew();
+		octree_mark_as_outdated();
+		markPointsRangeDirty(i, i + 1);
 	}
 
 	/** Load the points from any other point map class supported by the
@@ -263,6 +281,11 @@ class CPointCloud : public CRenderizableShaderPoints,
 	/** @} */
 
 	void onUpdateBuffers_Points() override;
+	bool onUpdateBuffers_PointsRange(size_t first, size_t last) override;
+	void onRenderPointsRanges(
+		const RenderContext& rc,
+		std::vector<std::pair<size_t, size_t>>& ranges,
+		std::vector<float>* splatScales) const override;
 
 	/** Render a subset of points (required by octree renderer) */
 	void render_subset(
@@ -284,6 +307,9 @@ class CPointCloud : public CRenderizableShaderPoints,
 	/** Color linear function slope */
 	mutable mrpt::img::TColorf m_col_slop, m_col_slop_inv;
 	mutable bool m_minmax_valid{false};
+	/** The color of all points in the shader buffer, if it is the same for
+	 * all of them. */
+	std::optional<mrpt::img::TColor> m_bufferUniformColor;
 
 	/** The colors used to interpolate when m_colorFromDepth is true. */
 	mrpt::img::TColorf m_colorFromDepth_min = {0, 0, 0},
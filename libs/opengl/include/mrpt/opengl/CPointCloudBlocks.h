@@ -0,0 +1,154 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/io/CStream.h>
+#include <mrpt/math/TBoundingBox.h>
+#include <mrpt/opengl/CRenderizableShaderPoints.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace mrpt::opengl
+{
+/** A cloud of colored points whose coordinates and colors are stored in
+ * blocks of an external file, loaded on demand while rendering. This is the
+ * class used for large point clouds in scenes saved with
+ * COpenGLScene::saveToBlockFile().
+ *
+ * Each block holds the coordinates (as mrpt::math::TPoint3Df) and the colors
+ * (as mrpt::img::TColor) of a subset of points, in the same memory layout
+ * than the GPU buffers, optionally compressed with zlib. Blocks of a cloud
+ * are interleaved subsets of its points (block `b` out of `B` holds the
+ * points `b, b+B, b+2B...`), so each loaded block uniformly refines the whole
+ * cloud.
+ *
+ * Blocks are only loaded while the cloud bounding box is in the camera
+ * frustum, up to getLoadBudget() points per rendered frame, and uploaded to
+ * the GPU without regenerating the already loaded points. Check
+ * hasPendingVisibleBlocks() to find out whether the owner window should keep
+ * redrawing the scene to complete the loading.
+ *
+ * Only the list of blocks, the file name and the rendering parameters are
+ * serialized, not the points.
+ *
+ *  \sa COpenGLScene::saveToBlockFile(), CPointCloudColoured
+ *  \note (New in MRPT 2.4.9)
+ * \ingroup mrpt_opengl_grp
+ */
+class CPointCloudBlocks : public CRenderizableShaderPoints
+{
+	DEFINE_SERIALIZABLE(CPointCloudBlocks, mrpt::opengl)
+
+   public:
+	/** A block of points within the block file */
+	struct TBlock
+	{
+		TBlock() = default;
+
+		/** Position of the block data in the file, in bytes */
+		uint64_t offset = 0;
+		/** Size of the block data in the file, in bytes */
+		uint64_t fileSize = 0;
+		/** Number of points in the block */
+		uint32_t numPoints = 0;
+		/** Whether the data is zlib-compressed (otherwise, it is stored as
+		 * is) */
+		bool compressed = false;
+	};
+
+	CPointCloudBlocks() = default;
+	virtual ~CPointCloudBlocks() override = default;
+
+	/** @name Renderizable shader API virtual methods
+	 * @{ */
+	void render(const RenderContext& rc) const override;
+	void renderUpdateBuffers() const override;
+	void onUpdateBuffers_Points() override;
+	bool onUpdateBuffers_PointsRange(size_t first, size_t last) override;
+	void freeOpenGLResources() override
+	{
+		CRenderizableShaderPoints::freeOpenGLResources();
+	}
+	/** @} */
+
+	/** Writes the points and colors in the shader buffers of `src` (see
+	 * CRenderizableShaderPoints::onUpdateBuffers_Points()) to `out` as blocks
+	 * of at most `pointsPerBlock` points, and returns a new object with the
+	 * same properties than `src` referring to them, with an empty block file
+	 * name (see setBlockFile()). Each block starts at a position multiple of
+	 * `blockAlignment` bytes, counted from the beginning of the stream.
+	 */
+	static Ptr FromPointsObject(
+		const CRenderizableShaderPoints& src, mrpt::io::CStream& out,
+		size_t pointsPerBlock, bool compress, size_t blockAlignment = 4096);
+
+	/** Changes the file the blocks are loaded from, e.g. after moving it.
+	 * Loaded points are discarded. */
+	void setBlockFile(const std::string& fileName);
+	const std::string& getBlockFile() const { return m_blockFile; }
+
+	const std::vector<TBlock>& getBlocks() const { return m_blocks; }
+
+	/** Total number of points of the cloud */
+	size_t getTotalPointCount() const { return m_totalPoints; }
+	/** Number of points loaded so far */
+	size_t getLoadedPointCount() const
+	{
+		return m_vertex_buffer_data.size() + m_stagedPoints.size();
+	}
+	bool isFullyLoaded() const { return m_nextBlock >= m_blocks.size(); }
+
+	/** Loads all the pending blocks now, e.g. to process the points, which
+	 * are then available in shaderPointsVertexPointBuffer() and
+	 * shaderPointsVertexColorBuffer(). */
+	void loadAllBlocks();
+
+	/** Whether in the last rendering the cloud was visible and some of its
+	 * blocks were not loaded yet. */
+	bool hasPendingVisibleBlocks() const { return m_pendingVisible; }
+
+	/** Maximum number of points loaded in each rendered frame (default:
+	 * 1 million) */
+	void setLoadBudget(size_t maxPointsPerFrame)
+	{
+		m_loadBudget = maxPointsPerFrame;
+	}
+	size_t getLoadBudget() const { return m_loadBudget; }
+
+	/** Returns the bounding box of the whole cloud, even if not loaded. */
+	mrpt::math::TBoundingBox getBoundingBox() const override
+	{
+		return m_bbox.compose(m_pose);
+	}
+
+   private:
+	std::string m_blockFile;
+	std::vector<TBlock> m_blocks;
+	size_t m_totalPoints = 0;
+	mrpt::math::TBoundingBox m_bbox;
+	size_t m_loadBudget = 1000000;
+
+	/** Index of the next block to load */
+	mutable size_t m_nextBlock = 0;
+	/** Loaded points not passed to the shader buffers yet */
+	mutable std::vector<mrpt::math::TPoint3Df> m_stagedPoints;
+	mutable std::vector<mrpt::img::TColor> m_stagedColors;
+	mutable bool m_pendingVisible = false;
+
+	/** Loads the next blocks, up to `maxPoints` points (at least one block),
+	 * into the staging buffers. */
+	void loadBlocks(size_t maxPoints) const;
+	/** Appends the staging buffers to the shader buffers */
+	void moveStagedPoints() const;
+	void discardLoadedPoints();
+};
+
+}  // namespace mrpt::opengl
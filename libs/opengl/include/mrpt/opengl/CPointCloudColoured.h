@@ -51,6 +51,11 @@ class CPointCloudColoured : public CRenderizableShaderPoints,
 
    public:
 	void onUpdateBuffers_Points() override;
+	bool onUpdateBuffers_PointsRange(size_t first, size_t last) override;
+	void onRenderPointsRanges(
+		const RenderContext& rc,
+		std::vector<std::pair<size_t, size_t>>& ranges,
+		std::vector<float>* splatScales) const override;
 
 	CPointCloudColoured() = default;
 	virtual ~CPointCloudColoured() override = default;
@@ -71,7 +76,8 @@ class CPointCloudColoured : public CRenderizableShaderPoints,
 	/** @name Read/Write of the list of points to render
 		@{ */
 
-	/** Inserts a new point into the point cloud. */
+	/** Inserts a new point into the point cloud. Only the new points are
+	 * uploaded to the GPU in the next rendering. */
 	void push_back(
 		float x, float y, float z, float R, float G, float B, float A = 1);
 
@@ -108,7 +114,8 @@ class CPointCloudColoured : public CRenderizableShaderPoints,
 	{
 		m_points[i] = p.pt;
 		m_point_colors[i] = mrpt::img::TColor(p.r, p.g, p.b, p.a);
-		markAllPointsAsNew();
+		octree_mark_as_outdated();
+		markPointsRangeDirty(i, i + 1);
 	}
 
 	/** Like \a setPoint() but does not check for index out of bounds */
@@ -116,7 +123,8 @@ class CPointCloudColoured : public CRenderizableShaderPoints,
 		const size_t i, const float x, const float y, const float z)
 	{
 		m_points[i] = {x, y, z};
-		markAllPointsAsNew();
+		octree_mark_as_outdated();
+		markPointsRangeDirty(i, i + 1);
 	}
 
 	/** Like \c setPointColor but without checking for out-of-index erors */
@@ -127,6 +135,7 @@ class CPointCloudColoured : public CRenderizableShaderPoints,
 		m_point_colors[index].G = f2u8(G);
 		m_point_colors[index].B = f2u8(B);
 		m_point_colors[index].A = f2u8(A);
+		markPointsRangeDirty(index, index + 1);
 	}
 	void setPointColor_u8_fast(
 		size_t index, uint8_t r, uint8_t g, uint8_t b, uint8_t a = 0xff)
@@ -135,6 +144,7 @@ class CPointCloudColoured : public CRenderizableShaderPoints,
 		m_point_colors[index].G = g;
 		m_point_colors[index].B = b;
 		m_point_colors[index].A = a;
+		markPointsRangeDirty(index, index + 1);
 	}
 	/** Like \c getPointColor but without checking for out-of-index erors */
 	void getPointColor_fast(size_t index, float& R, float& G, float& B) const
@@ -23,8 +23,14 @@
 #include <mrpt/serialization/CSerializable.h>
 #include <mrpt/typemeta/TEnumType.h>
 
+#include <array>
 #include <deque>
 
+namespace mrpt
+{
+class WorkerThreadsPool;
+}
+
 namespace mrpt::opengl
 {
 /** The base class of 3D objects that can be directly rendered through OpenGL.
@@ -224,6 +230,12 @@ class CRenderizable : public mrpt::serialization::CSerializable
 	inline float getScaleY() const { return m_scale_y; }
 	/** Get the current scaling factor in one axis */
 	inline float getScaleZ() const { return m_scale_z; }
+
+	/** Returns the 4x4 homogeneous matrix of the object pose, with its scale
+	 * applied. It is cached, and only recomputed when the pose or the scale
+	 * change.
+	 * \note (New in MRPT 2.4.9) */
+	const mrpt::math::CMatrixFloat44& getLocalTransform() const;
 	/** Returns the object color property as a TColorf */
 	inline mrpt::img::TColorf getColor() const
 	{
@@ -382,6 +394,18 @@ class CRenderizable : public mrpt::serialization::CSerializable
 
 	/** Optional pointer to a mrpt::opengl::CText */
 	mutable std::shared_ptr<mrpt::opengl::CText> m_label_obj;
+
+   private:
+	/** Cache of getLocalTransform() */
+	struct TLocalTransformCache
+	{
+		bool valid = false;
+		/** Rotation matrix, translation and scale of the cached matrix */
+		std::array<double, 12> pose;
+		std::array<float, 3> scale;
+		mrpt::math::CMatrixFloat44 HM;
+	};
+	mutable TLocalTransformCache m_localTransform;
 };
 
 /** A list of smart pointers to renderizable objects */
@@ -421,6 +445,22 @@ void enqueForRendering(
 	const mrpt::opengl::CListOpenGLObjects& objs,
 	const mrpt::opengl::TRenderMatrices& state, RenderQueue& rq);
 
+/** Like enqueForRendering(), but splitting long lists of objects (at any
+ * level of the tree, e.g. children of CSetOfObjects) among the threads of
+ * `pool`, then merging their queues. Objects whose OpenGL buffers must be
+ * updated, and object labels, are still processed in the calling thread,
+ * which must own the OpenGL context. If `pool` is nullptr, it is equivalent
+ * to enqueForRendering().
+ *
+ * \note Objects must not be inserted more than once in the tree of objects
+ * when using a thread pool.
+ * \note (New in MRPT 2.4.9)
+ */
+void enqueForRendering(
+	const mrpt::opengl::CListOpenGLObjects& objs,
+	const mrpt::opengl::TRenderMatrices& state, RenderQueue& rq,
+	mrpt::WorkerThreadsPool* pool);
+
 /** After enqueForRendering(), actually executes the rendering tasks, grouped
  * shader by shader.
  *
@@ -13,6 +13,10 @@
 #include <mrpt/opengl/COpenGLVertexArrayObject.h>
 #include <mrpt/opengl/CRenderizable.h>
 
+#include <cstdint>
+#include <utility>
+#include <vector>
+
 namespace mrpt::opengl
 {
 /** Renderizable generic renderer for objects using the points shader.
@@ -31,6 +35,20 @@ namespace mrpt::opengl
  * setVariablePointSize_k(), and setVariablePointSize_DepthScale(),
  * respectively.
  *
+ * Alternatively, points may be rendered as splats (see enableSplats()):
+ * round discs whose size in pixels is that of a sphere of a given radius in
+ * space (see setSplatRadius()), writing a paraboloid-shaped depth so that
+ * overlapping splats blend into a continuous surface. This is best combined
+ * with the eye-dome lighting of the viewport (see
+ * COpenGLViewport::enableEyeDomeLighting()) to perceive the shape of unlit
+ * point clouds. With level-of-detail rendering, splats are enlarged to
+ * compensate for the points not drawn for distant octree nodes.
+ *
+ * Derived classes may mark which points changed since the last rendering
+ * with markPointsRangeDirty() and implement onUpdateBuffers_PointsRange(),
+ * so only those points are uploaded to the GPU (e.g. when appending a few
+ * points per frame to a large cloud), instead of the whole buffers.
+ *
  *  \sa opengl::COpenGLScene
  *
  * \ingroup mrpt_opengl_grp
@@ -45,6 +63,7 @@ class CRenderizableShaderPoints : public virtual CRenderizable
 
 	virtual shader_list_t requiredShaders() const override
 	{
+		if (m_splats) return {DefaultShaderID::POINTS_SPLAT};
 		return {DefaultShaderID::POINTS};
 	}
 	void render(const RenderContext& rc) const override;
@@ -54,6 +73,20 @@ class CRenderizableShaderPoints : public virtual CRenderizable
 	 * to be drawn in "m_*_buffer" fields. */
 	virtual void onUpdateBuffers_Points() = 0;
 
+	/** May be implemented in derived classes to update the "m_*_buffer"
+	 * fields after only the points with indices in [first,last) were added
+	 * or modified (see markPointsRangeDirty()). Upon return, the buffers
+	 * must hold all the points, not only those in the range.
+	 * \return false if this is not possible, and onUpdateBuffers_Points()
+	 * must be called instead (the default).
+	 * \note (New in MRPT 2.4.9)
+	 */
+	virtual bool onUpdateBuffers_PointsRange(
+		[[maybe_unused]] size_t first, [[maybe_unused]] size_t last)
+	{
+		return false;
+	}
+
 	/** By default is 1.0. \sa enableVariablePointSize() */
 	inline void setPointSize(float p) { m_pointSize = p; }
 	inline float getPointSize() const { return m_pointSize; }
@@ -82,12 +115,36 @@ class CRenderizableShaderPoints : public virtual CRenderizable
 		return m_variablePointSize_DepthScale;
 	}
 
+	/** Enable/disable rendering points as splats (default=false). If
+	 * enabled, the point size parameters above are ignored.
+	 * \sa setSplatRadius()
+	 * \note (New in MRPT 2.4.9) */
+	void enableSplats(bool enable = true)
+	{
+		m_splats = enable;
+		CRenderizable::notifyChange();
+	}
+	bool isEnabledSplats() const { return m_splats; }
+
+	/** Radius of each splat, in the object coordinates (default=0.05).
+	 * It should be about the typical distance between neighboring points.
+	 * \note (New in MRPT 2.4.9) */
+	void setSplatRadius(float r) { m_splatRadius = r; }
+	float getSplatRadius() const { return m_splatRadius; }
+
+	/** Maximum diameter of the splats, in pixels (default=64).
+	 * \note (New in MRPT 2.4.9) */
+	void setSplatMaxSize(float pixels) { m_splatMaxSize = pixels; }
+	float getSplatMaxSize() const { return m_splatMaxSize; }
+
 	// See base docs
 	void freeOpenGLResources() override
 	{
 		m_vertexBuffer.destroy();
 		m_colorBuffer.destroy();
+		m_indexBuffer.destroy();
 		m_vao.destroy();
+		m_bufferCapacity = 0;
 	}
 
 	/** @name Raw access to point shader buffer data
@@ -106,21 +163,69 @@ class CRenderizableShaderPoints : public virtual CRenderizable
 	mutable std::vector<mrpt::math::TPoint3Df> m_vertex_buffer_data;
 	mutable std::vector<mrpt::img::TColor> m_color_buffer_data;
 
+	/** If not empty, the indices of the points (in m_vertex_buffer_data) in
+	 * the order they are drawn, and only the ranges of it returned by
+	 * onRenderPointsRanges() are drawn in each rendering. Used for
+	 * level-of-detail rendering. Uploaded with the other buffers.
+	 * \note (New in MRPT 2.4.9) */
+	mutable std::vector<uint32_t> m_index_buffer_data;
+
+	/** Called from render() if m_index_buffer_data is not empty, to get the
+	 * ranges (first, count) of it to be drawn in this rendering, e.g. after
+	 * culling with the camera of rc.state. By default, all of it.
+	 * If `splatScales` is not null (rendering splats), it must be filled with
+	 * the factor to enlarge the splats of each range, e.g. to compensate for
+	 * drawing only a subset of the points of a region.
+	 * \note (New in MRPT 2.4.9) */
+	virtual void onRenderPointsRanges(
+		[[maybe_unused]] const RenderContext& rc,
+		std::vector<std::pair<size_t, size_t>>& ranges,
+		std::vector<float>* splatScales) const
+	{
+		ranges.assign(1, {0, m_index_buffer_data.size()});
+		if (splatScales) splatScales->assign(1, 1.0f);
+	}
+
 	/** Returns the bounding box of m_vertex_buffer_data, or (0,0,0)-(0,0,0) if
 	 * empty. */
 	const mrpt::math::TBoundingBox verticesBoundingBox() const;
 
+	/** Marks the points with indices in [first,last) as added or modified
+	 * since the last rendering, so only them are uploaded to the GPU if the
+	 * derived class implements onUpdateBuffers_PointsRange(). Successive
+	 * calls extend the range. Calls notifyChange().
+	 * \note (New in MRPT 2.4.9) */
+	void markPointsRangeDirty(size_t first, size_t last) const;
+
+	/** Marks all points as modified, so the whole buffers are regenerated
+	 * with onUpdateBuffers_Points() and uploaded again. Calls notifyChange().
+	 * \note (New in MRPT 2.4.9) */
+	void markAllPointsDirty() const;
+
 	float m_pointSize = 1.0f;
 	bool m_variablePointSize = true;
 	float m_variablePointSize_K = 0.1f;
 	float m_variablePointSize_DepthScale = 0.1f;
+	bool m_splats = false;
+	float m_splatRadius = 0.05f;
+	float m_splatMaxSize = 64.0f;
 
 	void params_serialize(mrpt::serialization::CArchive& out) const;
 	void params_deserialize(mrpt::serialization::CArchive& in);
 
    private:
 	mutable COpenGLBuffer m_vertexBuffer, m_colorBuffer;
+	mutable COpenGLBuffer m_indexBuffer{COpenGLBuffer::Type::ElementIndex};
 	mutable COpenGLVertexArrayObject m_vao;
+	mutable std::vector<std::pair<size_t, size_t>> m_drawRanges;
+	mutable std::vector<float> m_drawRangesSplatScales;
+
+	/** Number of points the GPU buffers can hold without reallocating */
+	mutable size_t m_bufferCapacity = 0;
+
+	/** Points changed since the last renderUpdateBuffers() */
+	mutable size_t m_dirtyFirst = 0, m_dirtyLast = 0;
+	mutable bool m_dirtyRange = false, m_allPointsDirty = true;
 };
 
 }  // namespace mrpt::opengl
@@ -0,0 +1,150 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/math/TPose3D.h>
+#include <mrpt/opengl/COpenGLBuffer.h>
+#include <mrpt/opengl/COpenGLVertexArrayObject.h>
+#include <mrpt/opengl/CRenderizable.h>
+#include <mrpt/opengl/TTriangle.h>
+
+#include <array>
+#include <vector>
+
+namespace mrpt::opengl
+{
+/** Many copies (instances) of one same object, each one with its own pose and
+ * color, rendered with one single instanced draw call per shader, instead of
+ * one per copy. Use it instead of a CSetOfObjects with thousands of identical
+ * children (e.g. the particles of a PDF, or the nodes of a graph).
+ *
+ * The shape is given by a prototype object, which may be any object rendered
+ * with triangles or wireframe lines (e.g. mrpt::opengl::CArrow,
+ * mrpt::opengl::CBox, mrpt::opengl::CEllipsoid3D), or a CSetOfObjects of them
+ * (e.g. mrpt::opengl::stock_objects::CornerXYZSimple()), including the pose
+ * and scale of the prototype itself and of its children. Points, text and
+ * textures in the prototype are not rendered.
+ *
+ * The color of each instance multiplies the prototype vertex colors, so a
+ * white prototype takes the color of each instance (default: white, i.e. the
+ * prototype colors).
+ *
+ * The geometry of the prototype is read when this object buffers are updated,
+ * so notifyChange() must be called on this object after modifying the
+ * prototype.
+ *
+ *  \sa opengl::COpenGLScene, CSetOfObjects
+ *  \note (New in MRPT 2.4.9)
+ * \ingroup mrpt_opengl_grp
+ */
+class CSetOfInstances : public CRenderizable
+{
+	DEFINE_SERIALIZABLE(CSetOfInstances, mrpt::opengl)
+
+   public:
+	CSetOfInstances() = default;
+	CSetOfInstances(const CRenderizable::Ptr& prototype)
+		: m_prototype(prototype)
+	{
+	}
+	virtual ~CSetOfInstances() override = default;
+
+	/** @name Renderizable shader API virtual methods
+	 * @{ */
+	shader_list_t requiredShaders() const override;
+	void render(const RenderContext& rc) const override;
+	void renderUpdateBuffers() const override;
+	void freeOpenGLResources() override;
+	/** @} */
+
+	void setPrototype(const CRenderizable::Ptr& prototype)
+	{
+		m_prototype = prototype;
+		CRenderizable::notifyChange();
+	}
+	const CRenderizable::Ptr& getPrototype() const { return m_prototype; }
+
+	/** Adds a new instance */
+	void insert(
+		const mrpt::math::TPose3D& pose,
+		const mrpt::img::TColor& color = mrpt::img::TColor::white())
+	{
+		m_poses.push_back(pose);
+		m_colors.push_back(color);
+		CRenderizable::notifyChange();
+	}
+
+	/** Removes all instances */
+	void clear()
+	{
+		m_poses.clear();
+		m_colors.clear();
+		CRenderizable::notifyChange();
+	}
+	void reserve(size_t N)
+	{
+		m_poses.reserve(N);
+		m_colors.reserve(N);
+	}
+	/** Sets the number of instances. New ones are white, at the origin. */
+	void resize(size_t N)
+	{
+		m_poses.resize(N);
+		m_colors.resize(N, mrpt::img::TColor::white());
+		CRenderizable::notifyChange();
+	}
+
+	/** Number of instances */
+	size_t size() const { return m_poses.size(); }
+	bool empty() const { return m_poses.empty(); }
+
+	void setInstancePose(size_t i, const mrpt::math::TPose3D& pose)
+	{
+		m_poses.at(i) = pose;
+		CRenderizable::notifyChange();
+	}
+	const mrpt::math::TPose3D& getInstancePose(size_t i) const
+	{
+		return m_poses.at(i);
+	}
+	void setInstanceColor(size_t i, const mrpt::img::TColor& color)
+	{
+		m_colors.at(i) = color;
+		CRenderizable::notifyChange();
+	}
+	const mrpt::img::TColor& getInstanceColor(size_t i) const
+	{
+		return m_colors.at(i);
+	}
+
+	/** Evaluates the bounding box of all instances, in the coordinate frame of
+	 * the object parent. */
+	mrpt::math::TBoundingBox getBoundingBox() const override;
+
+   private:
+	CRenderizable::Ptr m_prototype;
+	std::vector<mrpt::math::TPose3D> m_poses;
+	std::vector<mrpt::img::TColor> m_colors;
+
+	/** The prototype geometry, in its parent frame */
+	mutable std::vector<mrpt::opengl::TTriangle> m_triangles;
+	mutable std::vector<mrpt::math::TPoint3Df> m_lineVertices;
+	mutable std::vector<mrpt::img::TColor> m_lineColors;
+
+	/** Column-major transformation matrix of each instance */
+	mutable std::vector<std::array<float, 16>> m_instanceMatrices;
+
+	mutable COpenGLBuffer m_trianglesBuffer, m_lineVerticesBuffer,
+		m_lineColorsBuffer, m_instanceMatricesBuffer, m_instanceColorsBuffer;
+	mutable COpenGLVertexArrayObject m_trianglesVao, m_linesVao;
+
+	void setupInstanceAttributes(const RenderContext& rc) const;
+};
+
+}  // namespace mrpt::opengl
@@ -0,0 +1,161 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/img/color_maps.h>
+#include <mrpt/math/CMatrixF.h>
+#include <mrpt/opengl/COpenGLBuffer.h>
+#include <mrpt/opengl/COpenGLVertexArrayObject.h>
+#include <mrpt/opengl/CRenderizable.h>
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace mrpt::opengl
+{
+/** A planar (XY) grid of heights, like CMesh, for large terrain models (e.g.
+ * digital elevation maps of thousands of cells per side), rendered with a
+ * level of detail (LOD) depending on the distance to the camera.
+ *
+ * The grid is split into square chunks of getChunkSize() cells. Each chunk
+ * is drawn with the full resolution when closer to the camera than
+ * getLODDistance(), with half the resolution up to twice that distance, and
+ * so on, and it is not drawn at all if it is out of the camera frustum.
+ * Vertical "skirts" around each chunk hide the cracks between neighbor
+ * chunks with different LOD.
+ *
+ * Vertices are uploaded to the GPU chunk by chunk: updateZ() only regenerates
+ * the chunks affected by the modified heights.
+ *
+ * Cells can be hidden with a mask, and colored by height (see
+ * enableColorFromZ()); otherwise, the object color is used. Textures and
+ * wireframe rendering are not supported, use CMesh for them.
+ *
+ *  \sa CMesh, opengl::COpenGLScene
+ *  \note (New in MRPT 2.4.9)
+ * \ingroup mrpt_opengl_grp
+ */
+class CTerrainMesh : public CRenderizable
+{
+	DEFINE_SERIALIZABLE(CTerrainMesh, mrpt::opengl)
+
+   public:
+	CTerrainMesh() = default;
+	virtual ~CTerrainMesh() override = default;
+
+	/** @name Renderizable shader API virtual methods
+	 * @{ */
+	shader_list_t requiredShaders() const override
+	{
+		return {DefaultShaderID::TRIANGLES};
+	}
+	void render(const RenderContext& rc) const override;
+	void renderUpdateBuffers() const override;
+	void freeOpenGLResources() override;
+	/** @} */
+
+	void setGridLimits(float xMin, float xMax, float yMin, float yMax);
+	void getGridLimits(float& xMin, float& xMax, float& yMin, float& yMax) const
+	{
+		xMin = m_xMin;
+		xMax = m_xMax;
+		yMin = m_yMin;
+		yMax = m_yMax;
+	}
+
+	/** Sets the height of each grid vertex: `Z(i,j)` is the height at
+	 * `x=xMin+i*(xMax-xMin)/(rows-1)`, `y=yMin+j*(yMax-yMin)/(cols-1)`, as in
+	 * CMesh. */
+	void setZ(const mrpt::math::CMatrixDynamic<float>& Z);
+	const mrpt::math::CMatrixF& getZ() const { return m_Z; }
+
+	/** Overwrites the heights of a block of vertices, whose top-left element
+	 * goes to `Z(row0,col0)`. Only the chunks affected by the change are
+	 * regenerated. */
+	void updateZ(
+		size_t row0, size_t col0,
+		const mrpt::math::CMatrixDynamic<float>& block);
+
+	/** Sets a mask of valid vertices, with the same size than Z, or an empty
+	 * matrix to draw all cells. Cells with any corner with a mask value of 0
+	 * are not drawn. */
+	void setMask(const mrpt::math::CMatrixDynamic<float>& mask);
+	const mrpt::math::CMatrixF& getMask() const { return m_mask; }
+
+	void enableColorFromZ(
+		bool v, mrpt::img::TColormap colorMap = mrpt::img::cmJET)
+	{
+		m_colorFromZ = v;
+		m_colorMap = colorMap;
+		CRenderizable::notifyChange();
+	}
+
+	/** Side length of the chunks, in cells (a power of 2, from 4 to 128,
+	 * default=64) */
+	void setChunkSize(unsigned int cells);
+	unsigned int getChunkSize() const { return m_chunkSize; }
+
+	/** Distance from the camera up to which chunks are drawn with the full
+	 * resolution (resolution is halved each time distance doubles). 0
+	 * (default) means twice the chunk side length. */
+	void setLODDistance(float d)
+	{
+		m_lodDistance = d;
+		CRenderizable::notifyChange();
+	}
+	float getLODDistance() const { return m_lodDistance; }
+
+	bool isLightEnabled() const { return m_enableLight; }
+	void enableLight(bool enable = true) { m_enableLight = enable; }
+
+	/** Number of triangles (including skirts) drawn in the last render() */
+	size_t getLastRenderedTriangleCount() const { return m_lastTriangleCount; }
+
+	mrpt::math::TBoundingBox getBoundingBox() const override;
+
+   private:
+	mrpt::math::CMatrixF m_Z, m_mask;
+	float m_xMin = -1, m_xMax = 1, m_yMin = -1, m_yMax = 1;
+	bool m_colorFromZ = false;
+	mrpt::img::TColormap m_colorMap = mrpt::img::cmJET;
+	unsigned int m_chunkSize = 64;
+	float m_lodDistance = 0;
+	bool m_enableLight = true;
+
+	struct TChunk
+	{
+		/** First grid vertex, and number of vertex rows and columns */
+		size_t row0 = 0, col0 = 0, rows = 0, cols = 0;
+		float zMin = 0, zMax = 0;
+		/** (first, count) of the indices of each LOD level in the index
+		 * buffer */
+		std::vector<std::pair<uint32_t, uint32_t>> levels;
+		/** Whether its vertices must be regenerated */
+		bool dirty = true;
+	};
+	/** Chunks, row by row of chunks */
+	mutable std::vector<TChunk> m_chunks;
+	/** Whether the chunks and their indices must be rebuilt */
+	mutable bool m_layoutDirty = true;
+	/** Height range and color used to generate the current vertices */
+	mutable float m_builtZMin = 0, m_builtZMax = 0;
+	mutable mrpt::img::TColor m_builtColor;
+	mutable size_t m_lastTriangleCount = 0;
+
+	mutable COpenGLBuffer m_vertexBuffer;
+	mutable COpenGLBuffer m_indexBuffer{COpenGLBuffer::Type::ElementIndex};
+	mutable COpenGLVertexArrayObject m_vao;
+
+	void rebuildLayout() const;
+	void updateChunkVertices(size_t chunkIdx) const;
+	size_t verticesPerChunk() const;
+};
+
+}  // namespace mrpt::opengl
@@ -27,6 +27,16 @@ struct DefaultShaderID
 	static constexpr shader_id_t TEXT = 2;
 	static constexpr shader_id_t TRIANGLES = 3;
 	static constexpr shader_id_t TEXTURED_TRIANGLES = 4;
+	/** Versions of WIREFRAME and TRIANGLES with one pose and color per
+	 * instance, see CSetOfInstances (New in MRPT 2.4.9) */
+	static constexpr shader_id_t WIREFRAME_INSTANCED = 5;
+	static constexpr shader_id_t TRIANGLES_INSTANCED = 6;
+	/** Points rendered as round splats of a given size in space, see
+	 * CRenderizableShaderPoints::enableSplats() (New in MRPT 2.4.9) */
+	static constexpr shader_id_t POINTS_SPLAT = 7;
+	/** Full-screen eye-dome lighting pass, see
+	 * COpenGLViewport::enableEyeDomeLighting() (New in MRPT 2.4.9) */
+	static constexpr shader_id_t EYE_DOME_LIGHTING = 8;
 };
 
 /** Loads a set of OpenGL Vertex+Fragment shaders from the default library
@@ -12,6 +12,7 @@
 #include <mrpt/img/TColor.h>
 #include <mrpt/opengl/CGridPlaneXY.h>
 #include <mrpt/opengl/CPointCloud.h>
+#include <mrpt/opengl/CSetOfInstances.h>
 #include <mrpt/opengl/CSetOfLines.h>
 #include <mrpt/opengl/CSetOfObjects.h>
 #include <mrpt/opengl/CSimpleLine.h>
@@ -106,8 +107,21 @@ CSetOfObjects::Ptr graph_visualize(
 		ret->insert(pnts);
 	}  // end draw node points
 
+	// Without ID labels, all node corners are drawn with one instanced call:
+	if (show_node_corners && !show_ID_labels)
+	{
+		auto gl_corners = CSetOfInstances::Create(
+			is_3D_graph ? stock_objects::CornerXYZSimple(
+							  nodes_corner_scale, 1.0 /*line width*/)
+						: stock_objects::CornerXYSimple(
+							  nodes_corner_scale, 1.0 /*line width*/));
+		gl_corners->reserve(g.nodes.size());
+		for (auto itNod = g.nodes.begin(); itNod != g.nodes.end(); ++itNod)
+			gl_corners->insert(CPose3D(itNod->second).asTPose());
+		ret->insert(gl_corners);
+	}
 	// Show a 2D corner at each node (or just an empty object with the ID label)
-	if (show_node_corners || show_ID_labels)
+	else if (show_node_corners || show_ID_labels)
 	{
 		for (auto itNod = g.nodes.begin(); itNod != g.nodes.end(); ++itNod)
 		{
@@ -0,0 +1,54 @@
+R"XXX(#version 300 es
+
+// FRAGMENT SHADER: Eye-dome lighting (EDL), a screen-space shading of
+// unlit geometry (e.g. point clouds) from the depth buffer only.
+// See: C. Boucheny, "Interactive scientific visualization of large datasets:
+// towards a perceptive-based approach", PhD thesis, 2009.
+// Part of the MRPT project
+
+in highp vec2 frag_uv;
+
+uniform highp sampler2D depthTexture;
+uniform highp vec2 pixelSize;  // 1/viewport size
+uniform float edlStrength;
+uniform float edlRadius;  // pixels
+uniform float zNear, zFar;
+uniform int isProjective;  // 0 or 1
+
+out highp vec4 color;
+
+highp float logDepth(highp float d)
+{
+    highp float z;
+    if (isProjective != 0)
+        z = 2.0 * zNear * zFar / (zFar + zNear - (2.0 * d - 1.0) * (zFar - zNear));
+    else
+        z = zNear + d * (zFar - zNear);
+    return log2(max(z, 1e-6));
+}
+
+void main()
+{
+    highp float d = texture(depthTexture, frag_uv).r;
+    if (d >= 1.0) discard;  // background
+
+    highp float l = logDepth(d);
+
+    // Sum of how much each neighbor is closer to the camera than this pixel.
+    // Background neighbors count as very close, outlining silhouettes:
+    highp float response = 0.0;
+    for (int i = 0; i < 8; i++)
+    {
+        highp float a = float(i) * 0.785398163;
+        highp vec2 uv = frag_uv + edlRadius * pixelSize * vec2(cos(a), sin(a));
+        highp float dn = texture(depthTexture, uv).r;
+        highp float ln = (dn >= 1.0) ? 0.0 : logDepth(dn);
+        response += max(0.0, l - ln);
+    }
+    response /= 8.0;
+
+    // Multiplied by the scene colors (see the blending setup):
+    highp float shade = exp(-response * 300.0 * edlStrength);
+    color = vec4(shade, shade, shade, 1.0);
+}
+)XXX"
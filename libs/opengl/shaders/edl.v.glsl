@@ -0,0 +1,14 @@
+R"XXX(#version 300 es
+
+// VERTEX SHADER: Full-screen triangle for the eye-dome lighting pass
+// Part of the MRPT project
+
+out highp vec2 frag_uv;
+
+void main()
+{
+    // Vertices 0,1,2 -> uv (0,0), (2,0), (0,2): covers the whole viewport
+    frag_uv = vec2(float((gl_VertexID << 1) & 2), float(gl_VertexID & 2));
+    gl_Position = vec4(2.0 * frag_uv - 1.0, 0.0, 1.0);
+}
+)XXX"
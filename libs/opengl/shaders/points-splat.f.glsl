@@ -0,0 +1,28 @@
+R"XXX(#version 300 es
+
+// FRAGMENT SHADER: Points rendered as round, depth-correct splats
+// Part of the MRPT project
+
+in highp vec4 frag_color;
+in highp float frag_eye_z;
+in highp float frag_radius;
+
+uniform mat4 p_matrix;
+
+out highp vec4 color;
+
+void main()
+{
+    highp vec2 c = 2.0 * gl_PointCoord - 1.0;
+    highp float r2 = dot(c, c);
+    if (r2 > 1.0) discard;
+
+    // Each splat is a paraboloid facing the camera, so overlapping splats
+    // intersect smoothly in the depth buffer instead of popping:
+    highp float z = frag_eye_z + (1.0 - r2) * frag_radius;
+    highp vec4 clip = p_matrix * vec4(0.0, 0.0, z, 1.0);
+    gl_FragDepth = 0.5 * (clip.z / clip.w) + 0.5;
+
+    color = frag_color;
+}
+)XXX"
@@ -0,0 +1,34 @@
+R"XXX(#version 300 es
+
+// VERTEX SHADER: Points rendered as round, depth-correct splats
+// Part of the MRPT project
+
+in vec3 position;
+in vec4 vertexColor;
+
+uniform mat4 p_matrix;
+uniform mat4 mv_matrix;
+uniform float splatRadius;  // object units
+uniform float splatScale;  // LOD compensation factor (>=1)
+uniform float splatMaxSize;  // pixels
+uniform float viewportHeight;  // pixels
+
+out highp vec4 frag_color;
+out highp float frag_eye_z;
+out highp float frag_radius;
+
+void main()
+{
+    highp vec4 eye_position = mv_matrix * vec4(position, 1.0);
+    gl_Position = p_matrix * eye_position;
+
+    // Screen-space diameter of a sphere of radius "frag_radius":
+    frag_radius = splatRadius * splatScale;
+    highp float size = frag_radius * p_matrix[1][1] * viewportHeight /
+        max(gl_Position.w, 1e-6);
+    gl_PointSize = clamp(size, 1.0, splatMaxSize);
+
+    frag_eye_z = eye_position.z;
+    frag_color = vertexColor;
+}
+)XXX"
@@ -0,0 +1,30 @@
+R"XXX(#version 300 es
+
+// VERTEX SHADER: Default shader for MRPT CRenderizable objects,
+// instanced version: one pose and color per instance.
+// Part of the MRPT project
+
+
+in vec3 position;
+in vec4 vertexColor;
+in vec3 vertexNormal;
+in highp mat4 instancePose;
+in vec4 instanceColor;
+
+uniform highp mat4 p_matrix;
+uniform highp mat4 mv_matrix;
+
+out highp vec3 frag_position, frag_normal;
+out highp vec4 frag_materialColor;
+
+void main()
+{
+    highp mat4 instance_mv_matrix = mv_matrix * instancePose;
+    mediump vec4 eye_position = instance_mv_matrix * vec4(position, 1.0);
+    gl_Position = p_matrix * eye_position;
+
+    frag_position = eye_position.xyz;
+    frag_materialColor = vertexColor * instanceColor;
+    frag_normal   = (instance_mv_matrix * vec4(normalize(vertexNormal), 0.0)).xyz;
+}
+)XXX"
@@ -0,0 +1,24 @@
+R"XXX(#version 300 es
+
+// VERTEX SHADER: Default shader for MRPT CRenderizable objects,
+// instanced version: one pose and color per instance.
+// Part of the MRPT project
+
+
+in vec3 position;
+in vec4 vertexColor;
+in highp mat4 instancePose;
+in vec4 instanceColor;
+
+uniform highp mat4 p_matrix;
+uniform highp mat4 mv_matrix;
+
+out highp vec4 frag_color;
+
+void main()
+{
+    highp vec4 eye_position = mv_matrix * instancePose * vec4(position, 1.0);
+    gl_Position = p_matrix * eye_position;
+    frag_color = vertexColor * instanceColor;
+}
+)XXX"
@@ -31,13 +31,20 @@
 #endif
 #endif
 
+#include <mrpt/core/Clock.h>
 #include <mrpt/core/lock_helper.h>
+#include <mrpt/io/CFileInputStream.h>
+#include <mrpt/io/CFileOutputStream.h>
+#include <mrpt/io/vector_loadsave.h>
 #include <mrpt/opengl/opengl_api.h>
 #include <mrpt/serialization/CArchive.h>
 #include <mrpt/system/filesystem.h>
+#include <mrpt/system/md5.h>
 
 #include <mutex>
 #include <optional>
+#include <thread>
+#include <type_traits>
 
 using namespace mrpt;
 using namespace mrpt::opengl;
@@ -116,6 +123,33 @@ class TexturesCache
 	std::mutex gTextureCacheMtx;
 };
 
+class MeshCacheDirectory
+{
+   public:
+	static MeshCacheDirectory& Instance()
+	{
+		static MeshCacheDirectory i;
+		return i;
+	}
+
+	void set(const std::string& dir)
+	{
+		auto lck = mrpt::lockHelper(m_mtx);
+		m_dir = dir;
+	}
+	std::string get()
+	{
+		auto lck = mrpt::lockHelper(m_mtx);
+		return m_dir;
+	}
+
+   private:
+	MeshCacheDirectory() = default;
+
+	std::string m_dir;
+	std::mutex m_mtx;
+};
+
 struct RenderElements
 {
 	std::vector<mrpt::math::TPoint3Df>* lines_vbd = nullptr;
@@ -293,6 +327,7 @@ void CAssimpModel::clear()
 	m_modelPath.clear();
 	m_textureIdMap.clear();
 	m_texturedObjects.clear();
+	m_loadedFromMeshCache = false;
 }
 
 void CAssimpModel::loadScene(const std::string& filepath, int flags)
@@ -316,6 +351,21 @@ void CAssimpModel::loadScene(const std::string& filepath, int flags)
 	// Own flags:
 	m_verboseLoad = !!(flags & LoadFlags::Verbose);
 
+	// Already processed?
+	std::string cacheFile;
+	if (const auto cacheDir = getMeshCacheDirectory(); !cacheDir.empty())
+		cacheFile = meshCacheFileName(cacheDir, filepath, flags);
+
+	if (!cacheFile.empty())
+	{
+		m_modelPath = filepath;	 // (Needed to locate textures)
+		if (loadMeshCache(cacheFile))
+		{
+			m_loadedFromMeshCache = true;
+			return;
+		}
+	}
+
 	m_assimp_scene->scene =
 		m_assimp_scene->importer.ReadFile(filepath.c_str(), pFlags);
 
@@ -344,6 +394,8 @@ void CAssimpModel::loadScene(const std::string& filepath, int flags)
 	// buffers
 	const_cast<CAssimpModel&>(*this).onUpdateBuffers_all();
 
+	if (!cacheFile.empty()) saveMeshCache(cacheFile);
+
 #else
 	THROW_EXCEPTION("MRPT compiled without OpenGL and/or Assimp");
 #endif
@@ -362,6 +414,202 @@ bool CAssimpModel::traceRay(
 	return false;
 }
 
+// Increase if the format of the mesh cache files changes:
+static const uint8_t MESH_CACHE_VERSION = 0;
+static const char* const MESH_CACHE_MAGIC = "MRPT_CAssimpModel_mesh_cache";
+// Written in native byte order, to detect cache files from other platforms:
+static const uint32_t MESH_CACHE_BYTE_ORDER = 0x01020304;
+
+// Returns an empty string if the model file cannot be read.
+static std::string meshCacheFileName(
+	const std::string& cacheDir, const std::string& modelFile, int flags)
+{
+	std::vector<uint8_t> contents;
+	if (!mrpt::io::loadBinaryFile(contents, modelFile)) return {};
+
+	// (Verbose does not change the processed mesh)
+	const auto meshFlags = static_cast<unsigned int>(flags) &
+		~static_cast<unsigned int>(CAssimpModel::LoadFlags::Verbose);
+
+	return mrpt::system::filePathSeparatorsToNative(
+		cacheDir + "/" + mrpt::system::md5(contents) +
+		mrpt::format("_%04x.mesh", meshFlags));
+}
+
+template <typename T>
+static void writeRawVector(
+	mrpt::serialization::CArchive& out, const std::vector<T>& v)
+{
+	static_assert(std::is_standard_layout_v<T>);
+	out.WriteAs<uint64_t>(v.size());
+	if (!v.empty()) out.WriteBuffer(v.data(), sizeof(T) * v.size());
+}
+
+template <typename T>
+static void readRawVector(mrpt::serialization::CArchive& in, std::vector<T>& v)
+{
+	static_assert(std::is_standard_layout_v<T>);
+	v.resize(in.ReadAs<uint64_t>());
+	const size_t len = sizeof(T) * v.size();
+	if (len && in.ReadBuffer(v.data(), len) != len)
+		THROW_EXCEPTION("Unexpected end of file");
+}
+
+void CAssimpModel::setMeshCacheDirectory(const std::string& dir)
+{
+	internal::MeshCacheDirectory::Instance().set(dir);
+}
+
+std::string CAssimpModel::getMeshCacheDirectory()
+{
+	return internal::MeshCacheDirectory::Instance().get();
+}
+
+bool CAssimpModel::loadMeshCache(const std::string& cacheFile)
+{
+	if (!mrpt::system::fileExists(cacheFile)) return false;
+
+	auto& lines_vbd = CRenderizableShaderWireFrame::m_vertex_buffer_data;
+	auto& lines_cbd = CRenderizableShaderWireFrame::m_color_buffer_data;
+	auto& pts_vbd = CRenderizableShaderPoints::m_vertex_buffer_data;
+	auto& pts_cbd = CRenderizableShaderPoints::m_color_buffer_data;
+	auto& tris = CRenderizableShaderTriangles::m_triangles;
+
+	try
+	{
+		mrpt::io::CFileInputStream f(cacheFile);
+		auto in = mrpt::serialization::archiveFrom(f);
+
+		std::string magic;
+		in >> magic;
+		if (magic != MESH_CACHE_MAGIC) return false;
+		uint32_t byteOrder = 0;
+		in.ReadBuffer(&byteOrder, sizeof(byteOrder));
+		const auto version = in.ReadAs<uint8_t>();
+		const auto triangleSize = in.ReadAs<uint32_t>();
+		if (byteOrder != MESH_CACHE_BYTE_ORDER ||
+			version != MESH_CACHE_VERSION || triangleSize != sizeof(TTriangle))
+			return false;
+
+		in >> m_bbox_min >> m_bbox_max;
+		readRawVector(in, tris);
+		readRawVector(in, lines_vbd);
+		readRawVector(in, lines_cbd);
+		readRawVector(in, pts_vbd);
+		readRawVector(in, pts_cbd);
+
+		std::map<filepath_t, std::vector<TTriangle>> texturedTris;
+		const auto nTextures = in.ReadAs<uint32_t>();
+		for (uint32_t i = 0; i < nTextures; i++)
+		{
+			filepath_t texFile;
+			in >> texFile;
+			readRawVector(in, texturedTris[texFile]);
+		}
+
+		m_textureIdMap.clear();
+		m_texturedObjects.clear();
+		for (const auto& kv : texturedTris)
+			m_textureIdMap[kv.first].id_idx = std::string::npos;	// pending
+		load_textures();
+
+		for (const auto& kv : texturedTris)
+		{
+			auto& obj =
+				m_texturedObjects.at(m_textureIdMap.at(kv.first).id_idx);
+			for (const auto& t : kv.second)
+				obj->insertTriangle(t);
+		}
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << "[CAssimpModel] Ignoring invalid mesh cache file '"
+				  << cacheFile << "': " << e.what() << "\n";
+
+		lines_vbd.clear();
+		lines_cbd.clear();
+		pts_vbd.clear();
+		pts_cbd.clear();
+		tris.clear();
+		m_textureIdMap.clear();
+		m_texturedObjects.clear();
+		return false;
+	}
+
+	if (m_verboseLoad)
+		std::cout << "[CAssimpModel] Loaded processed mesh from cache: "
+				  << cacheFile << "\n";
+	return true;
+}
+
+void CAssimpModel::saveMeshCache(const std::string& cacheFile) const
+{
+	const auto dir = mrpt::system::extractFileDirectory(cacheFile);
+	if (!mrpt::system::directoryExists(dir))
+		mrpt::system::createDirectory(dir);
+
+	// Written to a temporary file first, so that other processes loading the
+	// same model never read an incomplete cache file:
+	const size_t tmpId =
+		std::hash<std::thread::id>()(std::this_thread::get_id()) ^
+		static_cast<size_t>(mrpt::Clock::now().time_since_epoch().count());
+	const auto tmpFile = cacheFile + mrpt::format(".%zx.tmp", tmpId);
+
+	try
+	{
+		{
+			mrpt::io::CFileOutputStream f;
+			if (!f.open(tmpFile))
+				THROW_EXCEPTION_FMT("Cannot create file '%s'", tmpFile.c_str());
+			auto out = mrpt::serialization::archiveFrom(f);
+
+			out << std::string(MESH_CACHE_MAGIC);
+			out.WriteBuffer(
+				&MESH_CACHE_BYTE_ORDER, sizeof(MESH_CACHE_BYTE_ORDER));
+			out.WriteAs<uint8_t>(MESH_CACHE_VERSION);
+			out.WriteAs<uint32_t>(sizeof(TTriangle));
+
+			out << m_bbox_min << m_bbox_max;
+			writeRawVector(out, CRenderizableShaderTriangles::m_triangles);
+			writeRawVector(
+				out, CRenderizableShaderWireFrame::m_vertex_buffer_data);
+			writeRawVector(
+				out, CRenderizableShaderWireFrame::m_color_buffer_data);
+			writeRawVector(
+				out, CRenderizableShaderPoints::m_vertex_buffer_data);
+			writeRawVector(out, CRenderizableShaderPoints::m_color_buffer_data);
+
+			out.WriteAs<uint32_t>(m_textureIdMap.size());
+			std::vector<TTriangle> texturedTris;
+			for (const auto& kv : m_textureIdMap)
+			{
+				const auto& obj = m_texturedObjects.at(kv.second.id_idx);
+				texturedTris.resize(obj->getTrianglesCount());
+				for (size_t i = 0; i < texturedTris.size(); i++)
+					texturedTris[i] = obj->getTriangle(i);
+
+				out << kv.first;
+				writeRawVector(out, texturedTris);
+			}
+		}
+		std::string errMsg;
+		if (!mrpt::system::renameFile(tmpFile, cacheFile, &errMsg))
+			THROW_EXCEPTION(errMsg);
+	}
+	catch (const std::exception& e)
+	{
+		// Not fatal, the model was loaded anyway:
+		std::cerr << "[CAssimpModel] Could not save mesh cache file '"
+				  << cacheFile << "': " << e.what() << "\n";
+		mrpt::system::deleteFile(tmpFile);
+		return;
+	}
+
+	if (m_verboseLoad)
+		std::cout << "[CAssimpModel] Saved processed mesh to cache: "
+				  << cacheFile << "\n";
+}
+
 #if (MRPT_HAS_OPENGL_GLUT || MRPT_HAS_EGL) && MRPT_HAS_ASSIMP
 
 static void get_bounding_box_for_node(
@@ -644,6 +892,13 @@ void CAssimpModel::process_textures(const aiScene* scene)
 		}
 	}
 
+	load_textures();
+}
+
+#endif	// MRPT_HAS_OPENGL_GLUT && MRPT_HAS_ASSIMP
+
+void CAssimpModel::load_textures()
+{
 	const auto basepath = mrpt::system::filePathSeparatorsToNative(
 		mrpt::system::extractFileDirectory(m_modelPath));
 
@@ -675,5 +930,3 @@ void CAssimpModel::process_textures(const aiScene* scene)
 		}
 	}
 }
-
-#endif	// MRPT_HAS_OPENGL_GLUT && MRPT_HAS_ASSIMP
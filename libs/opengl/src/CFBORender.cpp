@@ -30,6 +30,17 @@ using mrpt::img::CImage;
 const thread_local bool MRPT_FBORENDER_SHOW_DEVICES =
 	mrpt::get_env<bool>("MRPT_FBORENDER_SHOW_DEVICES");
 
+namespace
+{
+// Depth buffer -> linear depth (0 for pixels without objects):
+float linearDepth(float depthSample, float zn, float zf)
+{
+	if (depthSample == 1) return 0;  // no "echo return"
+	depthSample = 2.0 * depthSample - 1.0;
+	return 2.0 * zn * zf / (zf + zn - depthSample * (zf - zn));
+}
+}  // namespace
+
 /*---------------------------------------------------------------
 						Constructor
 ---------------------------------------------------------------*/
@@ -263,19 +274,8 @@ void CFBORender::internal_render_RGBD(
 		const float zn = mats.getLastClipZNear();
 		const float zf = mats.getLastClipZFar();
 
-		// Depth buffer -> linear depth:
-		const auto linearDepth = [zn, zf](float depthSample) -> float {
-			depthSample = 2.0 * depthSample - 1.0;
-			float zLinear = 2.0 * zn * zf / (zf + zn - depthSample * (zf - zn));
-			return zLinear;
-		};
-
 		for (auto& d : outDepth)
-		{
-			if (d == 1) d = 0;	// no "echo return"
-			else
-				d = linearDepth(d);
-		}
+			d = linearDepth(d, zn, zf);
 
 		// flip lines:
 		std::vector<float> bufLine(m_fb.width());
@@ -316,3 +316,211 @@ void CFBORender::render_depth(
 {
 	internal_render_RGBD(scene, std::nullopt, outDepth);
 }
+
+#if HAVE_FBO
+namespace
+{
+// One frame in flight in CFBORender::render_batch():
+struct BatchSlot
+{
+	COpenGLFramebuffer fb;
+	COpenGLBuffer pboRGB{COpenGLBuffer::Type::PixelPack};
+	COpenGLBuffer pboDepth{COpenGLBuffer::Type::PixelPack};
+	GLsync fence = nullptr;
+	bool pending = false;
+	size_t index = 0;
+	float zn = 0, zf = 0;
+
+	~BatchSlot()
+	{
+		if (fence) glDeleteSync(fence);
+	}
+};
+
+// Restores the GL state and the camera changed by render_batch():
+struct BatchStateGuard
+{
+	BatchStateGuard(CCamera& cam) : camera(cam), oldCamera(cam)
+	{
+		oldFBs = COpenGLFramebuffer::CurrentBinding();
+		glGetIntegerv(GL_VIEWPORT, oldViewport);
+		glGetIntegerv(GL_PACK_ALIGNMENT, &oldPackAlignment);
+	}
+	~BatchStateGuard()
+	{
+		camera = oldCamera;
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+		glPixelStorei(GL_PACK_ALIGNMENT, oldPackAlignment);
+		COpenGLFramebuffer::Bind(oldFBs);
+		glViewport(
+			oldViewport[0], oldViewport[1], oldViewport[2], oldViewport[3]);
+	}
+
+	CCamera& camera;
+	const CCamera oldCamera;
+	FrameBufferBinding oldFBs;
+	GLint oldViewport[4];
+	GLint oldPackAlignment = 4;
+};
+}  // namespace
+#endif
+
+void CFBORender::render_batch(
+	[[maybe_unused]] const COpenGLScene& scene,
+	[[maybe_unused]] const std::vector<mrpt::poses::CPose3D>& cameraPoses,
+	[[maybe_unused]] const batch_callback_t& callback,
+	[[maybe_unused]] const TBatchOptions& options)
+{
+#if HAVE_FBO
+	MRPT_START
+
+	ASSERT_(options.rgb || options.depth);
+	ASSERT_GE_(options.numBuffers, 1U);
+
+	const auto mainVp = scene.getViewport("main");
+	ASSERT_(mainVp);
+
+	const unsigned int W = m_fb.width(), H = m_fb.height();
+	const int rgbBytes = 3 * W * H, depthBytes = sizeof(float) * W * H;
+
+	BatchStateGuard guard(mainVp->getCamera());
+	// Pixel rows are tightly packed in the PBOs:
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+
+	std::vector<BatchSlot> slots(
+		std::min<size_t>(options.numBuffers, cameraPoses.size()));
+	const auto createPBO = [](COpenGLBuffer& pbo, int byteCount) {
+		pbo.setUsage(COpenGLBuffer::Usage::StreamRead);
+		pbo.create();
+		pbo.bind();
+		pbo.allocate(nullptr, byteCount);
+	};
+	for (auto& slot : slots)
+	{
+		slot.fb.create(W, H);
+		if (options.rgb) createPBO(slot.pboRGB, rgbBytes);
+		if (options.depth) createPBO(slot.pboDepth, depthBytes);
+	}
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	CHECK_OPENGL_ERROR();
+
+	TBatchFrame frame;
+	if (options.rgb) frame.rgb.resize(W, H, mrpt::img::CH_RGB);
+	if (options.depth) frame.depth.resize(H, W);
+
+	// Waits for the transfers of a frame, and passes it to the callback:
+	const auto readBack = [&](BatchSlot& slot) {
+		const GLenum ret = glClientWaitSync(
+			slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+		glDeleteSync(slot.fence);
+		slot.fence = nullptr;
+		slot.pending = false;
+		ASSERTMSG_(ret != GL_WAIT_FAILED, "glClientWaitSync() failed");
+
+		if (options.rgb)
+		{
+			slot.pboRGB.bind();
+			const auto* src = reinterpret_cast<const uint8_t*>(glMapBufferRange(
+				GL_PIXEL_PACK_BUFFER, 0, rgbBytes, GL_MAP_READ_BIT));
+			ASSERT_(src);
+			// OpenGL rows go bottom to top:
+			for (unsigned int r = 0; r < H; r++)
+				::memcpy(
+					frame.rgb.ptrLine<uint8_t>(H - 1 - r), src + 3 * W * r,
+					3 * W);
+			glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+		}
+		if (options.depth)
+		{
+			slot.pboDepth.bind();
+			const auto* src = reinterpret_cast<const float*>(glMapBufferRange(
+				GL_PIXEL_PACK_BUFFER, 0, depthBytes, GL_MAP_READ_BIT));
+			ASSERT_(src);
+			for (unsigned int r = 0; r < H; r++)
+			{
+				const float* srcRow = src + W * r;
+				for (unsigned int c = 0; c < W; c++)
+					frame.depth(H - 1 - r, c) =
+						linearDepth(srcRow[c], slot.zn, slot.zf);
+			}
+			glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+		}
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+		CHECK_OPENGL_ERROR();
+
+		frame.index = slot.index;
+		callback(frame);
+	};
+
+	CCamera& camera = mainVp->getCamera();
+	camera.set6DOFMode(true);
+
+	for (size_t i = 0; i < cameraPoses.size(); i++)
+	{
+		BatchSlot& slot = slots[i % slots.size()];
+		if (slot.pending) readBack(slot);
+
+		camera.setPose(cameraPoses[i]);
+
+		slot.fb.bind();
+		glViewport(0, 0, W, H);
+		glEnable(GL_DEPTH_TEST);
+		CHECK_OPENGL_ERROR();
+
+		for (const auto& viewport : scene.viewports())
+			viewport->render(W, H, 0, 0);
+
+		const auto mats = mainVp->getRenderMatrices();
+		slot.zn = mats.getLastClipZNear();
+		slot.zf = mats.getLastClipZFar();
+
+		// Asynchronous transfers into the PBOs:
+		if (options.rgb)
+		{
+			slot.pboRGB.bind();
+			glReadPixels(
+				0, 0, W, H, GL_BGR_EXT, GL_UNSIGNED_BYTE, BUFFER_OFFSET(0));
+		}
+		if (options.depth)
+		{
+			slot.pboDepth.bind();
+			glReadPixels(
+				0, 0, W, H, GL_DEPTH_COMPONENT, GL_FLOAT, BUFFER_OFFSET(0));
+		}
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+		CHECK_OPENGL_ERROR();
+
+		slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		slot.index = i;
+		slot.pending = true;
+	}
+
+	// Remaining frames, in order:
+	const size_t N = cameraPoses.size();
+	for (size_t i = N - std::min(N, slots.size()); i < N; i++)
+		readBack(slots[i % slots.size()]);
+
+	MRPT_END
+#else
+	THROW_EXCEPTION(
+		"This class requires MRPT built with: OpenCV; OpenGL, and EGL.");
+#endif
+}
+
+void CFBORender::depthToRangeImage(
+	const mrpt::math::CMatrixFloat& depth, mrpt::math::CMatrix_u16& rangeImage,
+	float rangeUnits)
+{
+	ASSERT_GT_(rangeUnits, 0);
+
+	rangeImage.resize(depth.rows(), depth.cols());
+	const float k = 1.0f / rangeUnits;
+	for (int r = 0; r < depth.rows(); r++)
+		for (int c = 0; c < depth.cols(); c++)
+		{
+			const float d = depth(r, c) * k + 0.5f;
+			rangeImage(r, c) = (d >= 1.0f && d < 65536.0f)
+				? static_cast<uint16_t>(d)
+				: 0;
+		}
+}
@@ -261,3 +261,85 @@ TEST(OpenGL, DISABLED_CFBORender_camera_fov)
 {
 	test_opengl_CFBORender(false);
 }
+
+#if defined(RUN_OFFSCREEN_RENDER_TESTS)
+TEST(OpenGL, CFBORender_batch)
+#else
+TEST(OpenGL, DISABLED_CFBORender_batch)
+#endif
+{
+	using namespace mrpt::opengl;
+	using mrpt::poses::CPose3D;
+
+	COpenGLScene scene;
+	{
+		auto obj = CBox::Create(
+			mrpt::math::TPoint3D(-1, -1, -1), mrpt::math::TPoint3D(1, 1, 1));
+		obj->setColor(1.0f, 0.f, 0.f);
+		obj->setLocation(5.0, 0, 0);
+		scene.insert(obj);
+	}
+	scene.insert(CGridPlaneXY::Create(-20, 20, -20, 20, -2, 1));
+	scene.getViewport()->setViewportClipDistances(0.1, 30.0);
+
+	const int width = 160, height = 120;
+	CFBORender renderer(width, height);
+
+	// Camera axes: +Z forward
+	const auto camRot = CPose3D::FromYawPitchRoll(
+		mrpt::DEG2RAD(-90.0), 0.0, mrpt::DEG2RAD(-90.0));
+	std::vector<CPose3D> poses;
+	for (int i = 0; i < 5; i++)
+		poses.push_back(CPose3D(0, 0.2 * i, 0, 0, 0, 0) + camRot);
+
+	CFBORender::TBatchOptions opts;
+	opts.numBuffers = 2;
+	std::vector<size_t> indices;
+	std::vector<mrpt::img::CImage> batchRGB;
+	std::vector<mrpt::math::CMatrixFloat> batchDepth;
+	renderer.render_batch(
+		scene, poses,
+		[&](const CFBORender::TBatchFrame& f) {
+			indices.push_back(f.index);
+			batchRGB.push_back(f.rgb.makeDeepCopy());
+			batchDepth.push_back(f.depth);
+		},
+		opts);
+
+	ASSERT_EQ(indices.size(), poses.size());
+	for (size_t i = 0; i < poses.size(); i++)
+	{
+		EXPECT_EQ(indices[i], i);
+
+		CCamera& cam = renderer.getCamera(scene);
+		cam.set6DOFMode(true);
+		cam.setPose(poses[i]);
+
+		mrpt::img::CImage rgb;
+		mrpt::math::CMatrixFloat depth;
+		renderer.render_RGBD(scene, rgb, depth);
+
+		EXPECT_LT(imageDiff(rgb, batchRGB[i]), 1.0f);
+		EXPECT_LT(
+			(depth - batchDepth[i]).asEigen().array().abs().maxCoeff(), 1e-4f);
+	}
+}
+
+TEST(OpenGL, CFBORender_depthToRangeImage)
+{
+	mrpt::math::CMatrixFloat depth(2, 2);
+	depth(0, 0) = 0;  // no return
+	depth(0, 1) = 1.2344f;
+	depth(1, 0) = 70.0f;  // out of range with mm units
+	depth(1, 1) = 0.5f;
+
+	mrpt::math::CMatrix_u16 ri;
+	mrpt::opengl::CFBORender::depthToRangeImage(depth, ri, 0.001f);
+
+	ASSERT_EQ(ri.rows(), 2);
+	ASSERT_EQ(ri.cols(), 2);
+	EXPECT_EQ(ri(0, 0), 0);
+	EXPECT_EQ(ri(0, 1), 1234);
+	EXPECT_EQ(ri(1, 0), 0);
+	EXPECT_EQ(ri(1, 1), 500);
+}
@@ -10,10 +10,15 @@
 #include "opengl-precomp.h"	 // Precompiled header
 //
 #include <mrpt/opengl/COctoMapVoxels.h>
+#include <mrpt/opengl/Shader.h>
+#include <mrpt/opengl/TLightParameters.h>
 #include <mrpt/opengl/opengl_api.h>
 #include <mrpt/serialization/CArchive.h>
 #include <mrpt/serialization/stl_serialization.h>
 
+#include <array>
+#include <optional>
+
 using namespace mrpt;
 using namespace mrpt::opengl;
 using namespace mrpt::math;
@@ -28,8 +33,9 @@ void COctoMapVoxels::clear()
 {
 	m_voxel_sets.clear();
 	m_grid_cubes.clear();
+	m_voxel_groups.clear();
 
-	CRenderizable::notifyChange();
+	notifyChange();
 }
 
 void COctoMapVoxels::setBoundingBox(
@@ -46,8 +52,8 @@ void COctoMapVoxels::render(const RenderContext& rc) const
 		case DefaultShaderID::POINTS:
 			if (m_showVoxelsAsPoints) CRenderizableShaderPoints::render(rc);
 			break;
-		case DefaultShaderID::TRIANGLES:
-			if (!m_showVoxelsAsPoints) CRenderizableShaderTriangles::render(rc);
+		case DefaultShaderID::TRIANGLES_INSTANCED:
+			if (!m_showVoxelsAsPoints) renderVoxels(rc);
 			break;
 		case DefaultShaderID::WIREFRAME:
 			if (m_show_grids) CRenderizableShaderWireFrame::render(rc);
@@ -57,8 +63,19 @@ void COctoMapVoxels::render(const RenderContext& rc) const
 void COctoMapVoxels::renderUpdateBuffers() const
 {
 	CRenderizableShaderPoints::renderUpdateBuffers();
-	CRenderizableShaderTriangles::renderUpdateBuffers();
 	CRenderizableShaderWireFrame::renderUpdateBuffers();
+	updateVoxelBuffers();
+}
+
+void COctoMapVoxels::freeOpenGLResources()
+{
+	CRenderizableShaderTriangles::freeOpenGLResources();
+	CRenderizableShaderWireFrame::freeOpenGLResources();
+	CRenderizableShaderPoints::freeOpenGLResources();
+	m_voxel_buffers.clear();
+	m_cube_buffer.destroy();
+	m_cube_vao.destroy();
+	m_allVoxelsChanged = true;
 }
 
 // See: http://www.songho.ca/opengl/gl_vertexarray.html
@@ -108,7 +125,7 @@ void COctoMapVoxels::onUpdateBuffers_Wireframe()
 
 	CRenderizableShaderWireFrame::setLineWidth(m_grid_width);
 
-	const size_t nGrids = m_grid_cubes.size();
+	const size_t nGrids = m_show_grids ? m_grid_cubes.size() : 0;
 	for (size_t i = 0; i < nGrids; i++)
 	{
 		const TGridCube& c = m_grid_cubes[i];
@@ -134,64 +151,18 @@ void COctoMapVoxels::onUpdateBuffers_Wireframe()
 
 void COctoMapVoxels::onUpdateBuffers_Triangles()
 {
-	auto& tris = CRenderizableShaderTriangles::m_triangles;
-	tris.clear();
-
-	for (const auto& m_voxel_set : m_voxel_sets)
-	{
-		if (!m_voxel_set.visible) continue;
-
-		const std::vector<TVoxel>& voxels = m_voxel_set.voxels;
-		const size_t N = voxels.size();
-		for (size_t j = 0; j < N; j++)
-		{
-			const mrpt::img::TColor& vx_j_col = voxels[j].color;
-			// Was: glColor4ub(vx_j_col.R, vx_j_col.G, vx_j_col.B, vx_j_col.A);
-
-			const mrpt::math::TPoint3Df& c = voxels[j].coords;
-			const float L = voxels[j].side_length * 0.5f;
-
-			// Render as cubes:
-			const mrpt::math::TPoint3Df vs[8] = {
-				{c.x + L, c.y + L, c.z + L}, {c.x + L, c.y - L, c.z + L},
-				{c.x + L, c.y - L, c.z - L}, {c.x + L, c.y + L, c.z - L},
-				{c.x - L, c.y + L, c.z - L}, {c.x - L, c.y + L, c.z + L},
-				{c.x - L, c.y - L, c.z + L}, {c.x - L, c.y - L, c.z - L}};
-
-			// Was: glDrawElements(
-			// GL_TRIANGLES, sizeof(cube_indices) / sizeof(cube_indices[0]),
-			// GL_UNSIGNED_BYTE, cube_indices);
-			// glDrawElements(GL_LINES, , GL_UNSIGNED_BYTE, grid_line_indices);
-
-			const auto& ci = cube_indices;
-			const auto& ns = normals_cube;
-
-			for (size_t k = 0; k < sizeof(ci) / sizeof(ci[0]); k += 3)
-			{
-				mrpt::opengl::TTriangle tri(
-					// vertices:
-					vs[ci[k]], vs[ci[k + 1]], vs[ci[k + 2]],
-					// normals:
-					ns[k / 3], ns[k / 3], ns[k / 3]);
-
-				for (int p = 0; p < 3; p++)
-				{
-					tri.vertices[p].xyzrgba.r = vx_j_col.R;
-					tri.vertices[p].xyzrgba.g = vx_j_col.G;
-					tri.vertices[p].xyzrgba.b = vx_j_col.B;
-					tri.vertices[p].xyzrgba.a = vx_j_col.A;
-				}
-
-				tris.emplace_back(std::move(tri));
-			}
-		}
-	}
+	// Voxels are rendered as instances of one cube, see updateVoxelBuffers()
+	CRenderizableShaderTriangles::m_triangles.clear();
 }
 
 void COctoMapVoxels::onUpdateBuffers_Points()
 {
 	auto& vbd = CRenderizableShaderPoints::m_vertex_buffer_data;
 	auto& cbd = CRenderizableShaderPoints::m_color_buffer_data;
+	vbd.clear();
+	cbd.clear();
+
+	if (!m_showVoxelsAsPoints) return;
 
 	for (const auto& m_voxel_set : m_voxel_sets)
 	{
@@ -301,7 +272,8 @@ void COctoMapVoxels::serializeFrom(CArchive& in, uint8_t version)
 		default: MRPT_THROW_UNKNOWN_SERIALIZATION_VERSION(version);
 	};
 
-	CRenderizable::notifyChange();
+	m_voxel_groups.clear();
+	notifyChange();
 }
 
 auto COctoMapVoxels::getBoundingBox() const -> mrpt::math::TBoundingBox
@@ -323,4 +295,317 @@ void COctoMapVoxels::sort_voxels_by_z()
 			m_voxel_set.voxels.begin(), m_voxel_set.voxels.end(),
 			&sort_voxels_z);
 	}
+	m_voxel_groups.clear();
+	notifyChange();
+}
+
+void COctoMapVoxels::setVoxelGroup(
+	size_t set_index, uint64_t group_id, const std::vector<TVoxel>& voxels)
+{
+	ASSERT_(set_index < m_voxel_sets.size());
+	if (m_voxel_groups.size() < m_voxel_sets.size())
+		m_voxel_groups.resize(m_voxel_sets.size());
+
+	auto& vs = m_voxel_sets[set_index].voxels;
+	auto& g = m_voxel_groups[set_index];
+
+	// Voxels removed by other means (e.g. resizeVoxels()): start over.
+	if (g.voxelGroup.size() > vs.size()) g = TVoxelGroups();
+
+	auto itGroup = g.groups.find(group_id);
+	if (itGroup == g.groups.end())
+	{
+		if (voxels.empty()) return;
+		itGroup = g.groups.emplace(group_id, std::vector<size_t>()).first;
+	}
+	std::vector<size_t>& idxs = itGroup->second;
+
+	// Overwrite the existing voxels of the group, and append the rest:
+	for (size_t i = 0; i < voxels.size(); i++)
+	{
+		if (i < idxs.size())
+		{
+			vs[idxs[i]] = voxels[i];
+			g.modified.push_back(idxs[i]);
+			continue;
+		}
+		const size_t idx = vs.size();
+		vs.push_back(voxels[i]);
+		g.voxelGroup.resize(idx, NO_VOXEL_GROUP);
+		g.voxelGroup.push_back(group_id);
+		idxs.push_back(idx);
+		g.modified.push_back(idx);
+	}
+	// ...or remove the ones left:
+	while (idxs.size() > voxels.size())
+	{
+		const size_t idx = idxs.back();
+		idxs.pop_back();
+		eraseVoxel(set_index, idx);
+	}
+	if (idxs.empty()) g.groups.erase(itGroup);
+
+	// Not notifyChange(): only the modified voxels must be uploaded.
+	CRenderizable::notifyChange();
+}
+
+void COctoMapVoxels::eraseVoxel(size_t set_index, size_t idx)
+{
+	auto& vs = m_voxel_sets[set_index].voxels;
+	auto& g = m_voxel_groups[set_index];
+
+	const size_t last = vs.size() - 1;
+	g.voxelGroup.resize(vs.size(), NO_VOXEL_GROUP);
+	if (idx != last)
+	{
+		vs[idx] = vs[last];
+		const uint64_t lastGroup = g.voxelGroup[last];
+		g.voxelGroup[idx] = lastGroup;
+		if (lastGroup != NO_VOXEL_GROUP)
+		{
+			auto& li = g.groups.at(lastGroup);
+			*std::find(li.begin(), li.end(), last) = idx;
+		}
+		g.modified.push_back(idx);
+	}
+	vs.pop_back();
+	g.voxelGroup.pop_back();
+}
+
+size_t COctoMapVoxels::getVoxelGroupSize(
+	size_t set_index, uint64_t group_id) const
+{
+	if (set_index >= m_voxel_groups.size()) return 0;
+	const auto& groups = m_voxel_groups[set_index].groups;
+	const auto it = groups.find(group_id);
+	return it == groups.end() ? 0 : it->second.size();
+}
+
+namespace
+{
+using instance_pose_t = std::array<float, 16>;
+
+// Column-major transformation of the unit half-size cube into a voxel:
+instance_pose_t voxelInstancePose(const COctoMapVoxels::TVoxel& v)
+{
+	const float L = 0.5f * static_cast<float>(v.side_length);
+	return {L, 0, 0, 0, 0, L, 0, 0, 0, 0, L, 0, v.coords.x, v.coords.y,
+			v.coords.z, 1};
+}
+}  // namespace
+
+void COctoMapVoxels::updateVoxelBuffers() const
+{
+#if MRPT_HAS_OPENGL_GLUT || MRPT_HAS_EGL
+	// The cube to be instanced, with white vertices (colors are per-instance):
+	if (!m_cube_buffer.initialized())
+	{
+		const mrpt::math::TPoint3Df vs[8] = {
+			{1, 1, 1},	 {1, -1, 1},	{1, -1, -1},  {1, 1, -1},
+			{-1, 1, -1}, {-1, 1, 1},	{-1, -1, 1},  {-1, -1, -1}};
+		const auto& ci = cube_indices;
+		const auto& ns = normals_cube;
+
+		std::vector<mrpt::opengl::TTriangle> tris;
+		for (size_t k = 0; k < sizeof(ci) / sizeof(ci[0]); k += 3)
+		{
+			tris.emplace_back(
+				vs[ci[k]], vs[ci[k + 1]], vs[ci[k + 2]], ns[k / 3], ns[k / 3],
+				ns[k / 3]);
+			tris.back().setColor(mrpt::img::TColor::white());
+		}
+		m_cube_buffer.createOnce();
+		m_cube_buffer.bind();
+		m_cube_buffer.allocate(tris.data(), sizeof(tris[0]) * tris.size());
+	}
+	m_cube_vao.createOnce();
+
+	m_voxel_buffers.resize(m_voxel_sets.size());
+	std::vector<instance_pose_t> poses;
+	std::vector<mrpt::img::TColor> colors;
+
+	for (size_t s = 0; s < m_voxel_sets.size(); s++)
+	{
+		const auto& voxels = m_voxel_sets[s].voxels;
+		auto& b = m_voxel_buffers[s];
+		auto* modified =
+			s < m_voxel_groups.size() ? &m_voxel_groups[s].modified : nullptr;
+
+		// Hidden sets are uploaded again by showVoxels() -> notifyChange():
+		const size_t N = m_voxel_sets[s].visible ? voxels.size() : 0;
+
+		if (m_allVoxelsChanged || N > b.capacity)
+		{
+			// Reallocate with some room to grow:
+			b.capacity = N + N / 2;
+			poses.resize(N);
+			colors.resize(N);
+			for (size_t i = 0; i < N; i++)
+			{
+				poses[i] = voxelInstancePose(voxels[i]);
+				colors[i] = voxels[i].color;
+			}
+			b.poses.setUsage(COpenGLBuffer::Usage::DynamicDraw);
+			b.poses.createOnce();
+			b.poses.bind();
+			b.poses.allocate(nullptr, sizeof(instance_pose_t) * b.capacity);
+			b.poses.write(0, poses.data(), sizeof(instance_pose_t) * N);
+
+			b.colors.setUsage(COpenGLBuffer::Usage::DynamicDraw);
+			b.colors.createOnce();
+			b.colors.bind();
+			b.colors.allocate(nullptr, sizeof(mrpt::img::TColor) * b.capacity);
+			b.colors.write(0, colors.data(), sizeof(mrpt::img::TColor) * N);
+		}
+		else if (modified && !modified->empty())
+		{
+			// Upload runs of consecutive modified voxels:
+			std::sort(modified->begin(), modified->end());
+			modified->erase(
+				std::unique(modified->begin(), modified->end()),
+				modified->end());
+
+			for (size_t i = 0; i < modified->size();)
+			{
+				const size_t first = (*modified)[i];
+				if (first >= N) break;
+				size_t n = 1;
+				while (i + n < modified->size() &&
+					   (*modified)[i + n] == first + n && first + n < N)
+					n++;
+
+				poses.resize(n);
+				colors.resize(n);
+				for (size_t k = 0; k < n; k++)
+				{
+					poses[k] = voxelInstancePose(voxels[first + k]);
+					colors[k] = voxels[first + k].color;
+				}
+				b.poses.bind();
+				b.poses.write(
+					sizeof(instance_pose_t) * first, poses.data(),
+					sizeof(instance_pose_t) * n);
+				b.colors.bind();
+				b.colors.write(
+					sizeof(mrpt::img::TColor) * first, colors.data(),
+					sizeof(mrpt::img::TColor) * n);
+				i += n;
+			}
+		}
+		b.count = N;
+		if (modified) modified->clear();
+	}
+	m_allVoxelsChanged = false;
+#endif
+}
+
+void COctoMapVoxels::renderVoxels(const RenderContext& rc) const
+{
+#if MRPT_HAS_OPENGL_GLUT || MRPT_HAS_EGL
+	const Program& s = *rc.shader;
+
+	const bool enableLight = CRenderizableShaderTriangles::isLightEnabled();
+	if (s.hasUniform("enableLight"))
+		glUniform1i(s.uniformId("enableLight"), enableLight ? 1 : 0);
+	if (enableLight && rc.lights && s.hasUniform("light_diffuse") &&
+		s.hasUniform("light_ambient") && s.hasUniform("light_direction"))
+	{
+		const auto& l = *rc.lights;
+		glUniform4f(
+			s.uniformId("light_diffuse"), l.diffuse.R, l.diffuse.G, l.diffuse.B,
+			l.diffuse.A);
+		glUniform4f(
+			s.uniformId("light_ambient"), l.ambient.R, l.ambient.G, l.ambient.B,
+			l.ambient.A);
+		glUniform3f(
+			s.uniformId("light_direction"), l.direction.x, l.direction.y,
+			l.direction.z);
+	}
+	CHECK_OPENGL_ERROR();
+
+	const auto cullFace = CRenderizableShaderTriangles::cullFaces();
+	if (cullFace == TCullFace::NONE) { glDisable(GL_CULL_FACE); }
+	else
+	{
+		glEnable(GL_CULL_FACE);
+		glCullFace(cullFace == TCullFace::FRONT ? GL_FRONT : GL_BACK);
+	}
+
+	std::vector<GLuint> enabledAttribs;
+	const auto enableAttrib = [&](const char* name) -> std::optional<GLuint> {
+		if (!s.hasAttribute(name)) return {};
+		const GLuint attr = s.attributeId(name);
+		glEnableVertexAttribArray(attr);
+		enabledAttribs.push_back(attr);
+		return attr;
+	};
+
+	m_cube_vao.bind();
+	m_cube_buffer.bind();
+	if (const auto attr = enableAttrib("position"); attr)
+		glVertexAttribPointer(
+			*attr, 3, GL_FLOAT, GL_FALSE, sizeof(TTriangle::Vertex),
+			BUFFER_OFFSET(offsetof(TTriangle::Vertex, xyzrgba.pt.x)));
+	if (const auto attr = enableAttrib("vertexColor"); attr)
+		glVertexAttribPointer(
+			*attr, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(TTriangle::Vertex),
+			BUFFER_OFFSET(offsetof(TTriangle::Vertex, xyzrgba.r)));
+	if (const auto attr = enableAttrib("vertexNormal"); attr)
+		glVertexAttribPointer(
+			*attr, 3, GL_FLOAT, GL_FALSE, sizeof(TTriangle::Vertex),
+			BUFFER_OFFSET(offsetof(TTriangle::Vertex, normal.x)));
+	CHECK_OPENGL_ERROR();
+
+	// A mat4 attribute takes 4 consecutive locations, one per column:
+	std::optional<GLuint> attrPose, attrColor;
+	if (s.hasAttribute("instancePose"))
+	{
+		attrPose = s.attributeId("instancePose");
+		for (GLuint c = 0; c < 4; c++)
+			enabledAttribs.push_back(*attrPose + c);
+	}
+	if (s.hasAttribute("instanceColor"))
+	{
+		attrColor = s.attributeId("instanceColor");
+		enabledAttribs.push_back(*attrColor);
+	}
+
+	for (size_t i = 0; i < m_voxel_buffers.size(); i++)
+	{
+		auto& b = m_voxel_buffers[i];
+		if (!b.count || !m_voxel_sets.at(i).visible) continue;
+
+		if (attrPose)
+		{
+			b.poses.bind();
+			for (GLuint c = 0; c < 4; c++)
+			{
+				glEnableVertexAttribArray(*attrPose + c);
+				glVertexAttribPointer(
+					*attrPose + c, 4, GL_FLOAT, GL_FALSE,
+					sizeof(instance_pose_t),
+					BUFFER_OFFSET(sizeof(float) * 4 * c));
+				glVertexAttribDivisor(*attrPose + c, 1);
+			}
+		}
+		if (attrColor)
+		{
+			b.colors.bind();
+			glEnableVertexAttribArray(*attrColor);
+			glVertexAttribPointer(
+				*attrColor, 4, GL_UNSIGNED_BYTE, GL_TRUE, 0, BUFFER_OFFSET(0));
+			glVertexAttribDivisor(*attrColor, 1);
+		}
+		CHECK_OPENGL_ERROR();
+
+		glDrawArraysInstanced(
+			GL_TRIANGLES, 0, sizeof(cube_indices) / sizeof(cube_indices[0]),
+			static_cast<GLsizei>(b.count));
+		CHECK_OPENGL_ERROR();
+	}
+
+	for (const auto attr : enabledAttribs)
+		glDisableVertexAttribArray(attr);
+	CHECK_OPENGL_ERROR();
+#endif
 }
@@ -107,3 +107,12 @@ void COpenGLBuffer::RAII_Impl::allocate(const void* data, int byteCount)
 		static_cast<GLenum>(type), byteCount, data, static_cast<GLenum>(usage));
 #endif
 }
+
+void COpenGLBuffer::RAII_Impl::write(
+	int offset, const void* data, int byteCount)
+{
+#if MRPT_HAS_OPENGL_GLUT || MRPT_HAS_EGL
+	ASSERT_(created);
+	glBufferSubData(static_cast<GLenum>(type), offset, byteCount, data);
+#endif
+}
@@ -11,12 +11,17 @@
 //
 #include <mrpt/io/CFileGZInputStream.h>
 #include <mrpt/io/CFileGZOutputStream.h>
+#include <mrpt/io/CFileInputStream.h>
+#include <mrpt/io/CFileOutputStream.h>
+#include <mrpt/opengl/CPointCloudBlocks.h>
 #include <mrpt/opengl/COpenGLScene.h>
 #include <mrpt/opengl/CRenderizable.h>
 #include <mrpt/opengl/opengl_api.h>
 #include <mrpt/serialization/CArchive.h>
 #include <mrpt/serialization/metaprogramming_serialization.h>
 
+#include <algorithm>
+
 using namespace mrpt;
 using namespace mrpt::opengl;
 using namespace mrpt::serialization::metaprogramming;
@@ -74,10 +79,11 @@ COpenGLScene& COpenGLScene::operator=(const COpenGLScene& obj)
 
 		clear();
 		m_viewports = obj.m_viewports;
-		for_each(m_viewports.begin(), m_viewports.end(), [](auto& ptr) {
+		for_each(m_viewports.begin(), m_viewports.end(), [this](auto& ptr) {
 			// make a unique copy of each object (copied as a shared ptr)
 			ptr.reset(
 				dynamic_cast<mrpt::opengl::COpenGLViewport*>(ptr->clone()));
+			ptr->m_parent = this;
 		});
 	}
 	return *this;
@@ -318,6 +324,8 @@ bool COpenGLScene::saveToFile(const std::string& fil) const
 
 bool COpenGLScene::loadFromFile(const std::string& fil)
 {
+	if (isBlockFile(fil)) return loadFromBlockFile(fil);
+
 	try
 	{
 		mrpt::io::CFileGZInputStream f(fil);
@@ -330,6 +338,144 @@ bool COpenGLScene::loadFromFile(const std::string& fil)
 	}
 }
 
+namespace
+{
+const char BLOCK_FILE_MAGIC[8] = {'M', 'R', 'P', 'T', 'S', 'C', 'N', 'B'};
+constexpr uint32_t BLOCK_FILE_VERSION = 1;
+constexpr uint32_t BLOCK_FILE_BYTE_ORDER = 0x01020304;
+
+struct TBlockFileHeader
+{
+	char magic[8];
+	uint32_t version = BLOCK_FILE_VERSION;
+	uint32_t byteOrder = BLOCK_FILE_BYTE_ORDER;
+	uint64_t sceneOffset = 0, sceneSize = 0;
+};
+static_assert(sizeof(TBlockFileHeader) == 32);
+
+bool readBlockFileHeader(mrpt::io::CStream& f, TBlockFileHeader& h)
+{
+	return f.Read(&h, sizeof(h)) == sizeof(h) &&
+		std::equal(h.magic, h.magic + 8, BLOCK_FILE_MAGIC);
+}
+
+// Copy of the object `o` with its large point clouds (and those of its
+// children) written to `out` as blocks:
+CRenderizable::Ptr toBlocksObject(
+	const CRenderizable::Ptr& o, mrpt::io::CStream& out, size_t minPoints,
+	size_t pointsPerBlock, bool compress)
+{
+	if (auto objs = std::dynamic_pointer_cast<CSetOfObjects>(o); objs)
+	{
+		// Same properties, but different children:
+		auto newObjs = std::dynamic_pointer_cast<CSetOfObjects>(
+			CRenderizable::Ptr(dynamic_cast<CRenderizable*>(objs->clone())));
+		ASSERT_(newObjs);
+		newObjs->clear();
+		for (const auto& child : *objs)
+			newObjs->insert(toBlocksObject(
+				child, out, minPoints, pointsPerBlock, compress));
+		return newObjs;
+	}
+
+	// Only objects rendered as points only (as a whole or as splats):
+	auto pts = std::dynamic_pointer_cast<CRenderizableShaderPoints>(o);
+	if (!pts || std::dynamic_pointer_cast<CPointCloudBlocks>(o)) return o;
+	const auto shaders = o->requiredShaders();
+	if (shaders != shader_list_t({DefaultShaderID::POINTS}) &&
+		shaders != shader_list_t({DefaultShaderID::POINTS_SPLAT}))
+		return o;
+
+	// Generate the shader buffers, as for rendering:
+	pts->onUpdateBuffers_Points();
+	if (pts->shaderPointsVertexPointBuffer().size() < minPoints) return o;
+
+	return CPointCloudBlocks::FromPointsObject(
+		*pts, out, pointsPerBlock, compress);
+}
+}  // namespace
+
+bool COpenGLScene::saveToBlockFile(
+	const std::string& fil, size_t minPoints, size_t pointsPerBlock,
+	bool compress) const
+{
+	try
+	{
+		mrpt::io::CFileOutputStream f;
+		if (!f.open(fil)) return false;
+
+		TBlockFileHeader h;
+		std::copy(BLOCK_FILE_MAGIC, BLOCK_FILE_MAGIC + 8, h.magic);
+		f.Write(&h, sizeof(h));
+
+		// Points go first, then the scene referring to them:
+		COpenGLScene scene;
+		scene.m_followCamera = m_followCamera;
+		scene.m_viewports.clear();
+		for (const auto& vp : m_viewports)
+		{
+			auto newVp = COpenGLViewport::Ptr(
+				dynamic_cast<COpenGLViewport*>(vp->clone()));
+			ASSERT_(newVp);
+			newVp->m_parent = &scene;
+			newVp->clear();
+			for (const auto& o : *vp)
+				newVp->insert(toBlocksObject(
+					o, f, minPoints, pointsPerBlock, compress));
+			scene.m_viewports.push_back(newVp);
+		}
+
+		h.sceneOffset = f.getPosition();
+		mrpt::serialization::archiveFrom(f) << scene;
+		h.sceneSize = f.getPosition() - h.sceneOffset;
+
+		f.Seek(0);
+		f.Write(&h, sizeof(h));
+		return true;
+	}
+	catch (...)
+	{
+		return false;
+	}
+}
+
+bool COpenGLScene::loadFromBlockFile(const std::string& fil)
+{
+	try
+	{
+		mrpt::io::CFileInputStream f;
+		if (!f.open(fil)) return false;
+
+		TBlockFileHeader h;
+		if (!readBlockFileHeader(f, h) || h.version != BLOCK_FILE_VERSION ||
+			h.byteOrder != BLOCK_FILE_BYTE_ORDER)
+			return false;
+
+		f.Seek(h.sceneOffset);
+		mrpt::serialization::archiveFrom(f) >> *this;
+
+		// Clouds with an empty file name have their points in this file:
+		visitAllObjects([&fil](const CRenderizable::Ptr& o) {
+			if (auto b = std::dynamic_pointer_cast<CPointCloudBlocks>(o);
+				b && b->getBlockFile().empty())
+				b->setBlockFile(fil);
+		});
+		return true;
+	}
+	catch (...)
+	{
+		return false;
+	}
+}
+
+bool COpenGLScene::isBlockFile(const std::string& fil)
+{
+	mrpt::io::CFileInputStream f;
+	if (!f.open(fil)) return false;
+	TBlockFileHeader h;
+	return readBlockFileHeader(f, h);
+}
+
 /** Evaluates the bounding box of this object (including possible children) in
  * the coordinate frame of the object parent. */
 auto COpenGLScene::getBoundingBox(const std::string& vpn) const
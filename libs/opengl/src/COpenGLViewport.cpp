@@ -11,6 +11,7 @@
 //
 #include <Eigen/Dense>	// First! to avoid conflicts with X.h
 //
+#include <mrpt/core/WorkerThreadsPool.h>
 #include <mrpt/math/TLine3D.h>
 #include <mrpt/math/geometry.h>	 // crossProduct3D()
 #include <mrpt/opengl/COpenGLScene.h>
@@ -185,7 +186,21 @@ void COpenGLViewport::renderImageMode() const
 #endif
 }
 
-void COpenGLViewport::unloadShaders() { m_shaders.clear(); }
+void COpenGLViewport::unloadShaders()
+{
+	m_shaders.clear();
+
+	// Other OpenGL resources bound to the same context:
+#if MRPT_HAS_OPENGL_GLUT || MRPT_HAS_EGL
+	auto& edl = m_edlResources;
+	if (edl.depthTexture)
+	{
+		glDeleteTextures(1, &edl.depthTexture);
+		edl.depthTexture = 0;
+	}
+	edl.vao.destroy();
+#endif
+}
 
 void COpenGLViewport::loadDefaultShaders() const
 {
@@ -195,7 +210,9 @@ void COpenGLViewport::loadDefaultShaders() const
 	std::vector<shader_id_t> lstShaderIDs = {
 		DefaultShaderID::POINTS, DefaultShaderID::WIREFRAME,
 		DefaultShaderID::TRIANGLES, DefaultShaderID::TEXTURED_TRIANGLES,
-		DefaultShaderID::TEXT};
+		DefaultShaderID::TEXT, DefaultShaderID::WIREFRAME_INSTANCED,
+		DefaultShaderID::TRIANGLES_INSTANCED, DefaultShaderID::POINTS_SPLAT,
+		DefaultShaderID::EYE_DOME_LIGHTING};
 
 	for (const auto& id : lstShaderIDs)
 	{
@@ -274,8 +291,19 @@ void COpenGLViewport::renderNormalSceneMode() const
 #endif
 
 	// Pass 1: Process all objects (recursively for sets of objects):
+	if (m_renderQueueNumThreads != 1 && !m_renderQueuePool)
+	{
+		const unsigned int nThreads = m_renderQueueNumThreads == 0
+			? std::thread::hardware_concurrency()
+			: m_renderQueueNumThreads;
+		// The rendering thread also takes part:
+		m_renderQueuePool = std::make_shared<mrpt::WorkerThreadsPool>(
+			nThreads > 1 ? nThreads - 1 : 1,
+			mrpt::WorkerThreadsPool::POLICY_FIFO, "RenderQueue");
+	}
 	mrpt::opengl::RenderQueue rq;
-	mrpt::opengl::enqueForRendering(*objectsToRender, _, rq);
+	mrpt::opengl::enqueForRendering(
+		*objectsToRender, _, rq, m_renderQueuePool.get());
 
 	// pass 2: render, sorted by shader program:
 	mrpt::opengl::processRenderQueue(rq, m_shaders, m_lights);
@@ -326,6 +354,74 @@ void COpenGLViewport::renderViewportBorder() const
 #endif
 }
 
+void COpenGLViewport::renderEyeDomeLighting(
+	[[maybe_unused]] int vx, [[maybe_unused]] int vy, [[maybe_unused]] int vw,
+	[[maybe_unused]] int vh) const
+{
+	// WebGL cannot copy the depth buffer into a texture:
+#if (MRPT_HAS_OPENGL_GLUT || MRPT_HAS_EGL) && !defined(__EMSCRIPTEN__)
+	MRPT_START
+	if (vw <= 0 || vh <= 0) return;
+
+	// Copy the depth buffer of the viewport area into a texture:
+	auto& edl = m_edlResources;
+	glActiveTexture(GL_TEXTURE0);
+	if (!edl.depthTexture)
+	{
+		glGenTextures(1, &edl.depthTexture);
+		edl.width = edl.height = 0;
+	}
+	glBindTexture(GL_TEXTURE_2D, edl.depthTexture);
+	CHECK_OPENGL_ERROR();
+
+	if (edl.width != vw || edl.height != vh)
+	{
+		glTexImage2D(
+			GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, vw, vh, 0,
+			GL_DEPTH_COMPONENT, GL_UNSIGNED_INT, nullptr);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_MODE, GL_NONE);
+		CHECK_OPENGL_ERROR();
+		edl.width = vw;
+		edl.height = vh;
+	}
+	glCopyTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, vx, vy, vw, vh);
+	CHECK_OPENGL_ERROR();
+
+	// Full-viewport pass, multiplying the rendered colors by the shading:
+	const auto& shader = *m_shaders.at(DefaultShaderID::EYE_DOME_LIGHTING);
+	glUseProgram(shader.programId());
+	glUniform1i(shader.uniformId("depthTexture"), 0);
+	glUniform2f(shader.uniformId("pixelSize"), 1.0f / vw, 1.0f / vh);
+	glUniform1f(shader.uniformId("edlStrength"), m_edlStrength);
+	glUniform1f(shader.uniformId("edlRadius"), m_edlRadius);
+	glUniform1f(shader.uniformId("zNear"), m_state.getLastClipZNear());
+	glUniform1f(shader.uniformId("zFar"), m_state.getLastClipZFar());
+	glUniform1i(
+		shader.uniformId("isProjective"), m_state.is_projective ? 1 : 0);
+	CHECK_OPENGL_ERROR();
+
+	glDisable(GL_DEPTH_TEST);
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_ZERO, GL_SRC_COLOR);
+
+	// No vertex attributes, but a VAO must be bound:
+	edl.vao.createOnce();
+	edl.vao.bind();
+	glDrawArrays(GL_TRIANGLES, 0, 3);
+	CHECK_OPENGL_ERROR();
+
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	glEnable(GL_DEPTH_TEST);
+	glBindTexture(GL_TEXTURE_2D, 0);
+	glUseProgram(0);
+	MRPT_END
+#endif
+}
+
 void COpenGLViewport::renderTextMessages() const
 {
 #if MRPT_HAS_OPENGL_GLUT || MRPT_HAS_EGL
@@ -476,7 +572,10 @@ void COpenGLViewport::render(
 	//  ortho projection and render the image quad:
 	if (isImageViewMode()) renderImageMode();
 	else
+	{
 		renderNormalSceneMode();
+		if (m_edl) renderEyeDomeLighting(vx, vy, vw, vh);
+	}
 
 	// Draw text messages, if any:
 	renderTextMessages();
@@ -499,7 +598,7 @@ void COpenGLViewport::render(
 #endif
 }
 
-uint8_t COpenGLViewport::serializeGetVersion() const { return 6; }
+uint8_t COpenGLViewport::serializeGetVersion() const { return 7; }
 void COpenGLViewport::serializeTo(mrpt::serialization::CArchive& out) const
 {
 	// Save data:
@@ -544,6 +643,9 @@ void COpenGLViewport::serializeTo(mrpt::serialization::CArchive& out) const
 
 	// Added in v6:
 	out << m_clonedCameraViewport;
+
+	// Added in v7: eye-dome lighting
+	out << m_edl << m_edlStrength << m_edlRadius;
 }
 
 void COpenGLViewport::serializeFrom(
@@ -558,6 +660,7 @@ void COpenGLViewport::serializeFrom(
 		case 4:
 		case 5:
 		case 6:
+		case 7:
 		{
 			// Load data:
 			in >> m_camera >> m_isCloned >> m_isClonedCamera >>
@@ -634,6 +737,14 @@ void COpenGLViewport::serializeFrom(
 			if (version >= 6) in >> m_clonedCameraViewport;
 			else
 				m_clonedCameraViewport.clear();
+
+			if (version >= 7) in >> m_edl >> m_edlStrength >> m_edlRadius;
+			else
+			{
+				m_edl = false;
+				m_edlStrength = 1.0f;
+				m_edlRadius = 1.4f;
+			}
 		}
 		break;
 		default: MRPT_THROW_UNKNOWN_SERIALIZATION_VERSION(version);
@@ -749,6 +860,13 @@ void COpenGLViewport::setViewportClipDistances(
 	m_clip_max = clip_max;
 }
 
+void COpenGLViewport::setRenderQueueNumThreads(unsigned int numThreads)
+{
+	m_renderQueueNumThreads = numThreads;
+	// Recreated on demand:
+	m_renderQueuePool.reset();
+}
+
 void COpenGLViewport::getViewportClipDistances(
 	float& clip_min, float& clip_max) const
 {
@@ -67,6 +67,11 @@ void CPointCloud::onUpdateBuffers_Points()
 	octree_assure_uptodate();  // Rebuild octree if needed
 	m_last_rendered_count_ongoing = 0;
 
+	// Draw order for the octree LOD mode:
+	if (octree_is_lod_enabled()) octree_build_draw_order(m_index_buffer_data);
+	else
+		m_index_buffer_data.clear();
+
 	if (m_colorFromDepth != colNone)
 	{
 		if (!m_minmax_valid)
@@ -146,10 +151,41 @@ void CPointCloud::onUpdateBuffers_Points()
 		// all points: same color
 		cbd.assign(N, m_color);
 	}
+	if (m_colorFromDepth == colNone) m_bufferUniformColor = m_color;
+	else
+		m_bufferUniformColor.reset();
 
 	m_last_rendered_count = m_last_rendered_count_ongoing;
 }
 
+bool CPointCloud::onUpdateBuffers_PointsRange(
+	[[maybe_unused]] size_t first, [[maybe_unused]] size_t last)
+{
+	// Colors from depth may change for all points if the limits change, and
+	// the LOD draw order is rebuilt with the octree:
+	if (octree_is_lod_enabled() || m_colorFromDepth != colNone ||
+		!m_bufferUniformColor || !(*m_bufferUniformColor == m_color))
+		return false;
+
+	// All points have the same color: only the new ones need one.
+	// The octree is not needed for rendering, it is rebuilt upon demand.
+	CRenderizableShaderPoints::m_color_buffer_data.resize(
+		m_points.size(), m_color);
+	return true;
+}
+
+void CPointCloud::onRenderPointsRanges(
+	const RenderContext& rc,
+	std::vector<std::pair<size_t, size_t>>& ranges,
+	std::vector<float>* splatScales) const
+{
+	octree_get_visible_draw_ranges(*rc.state, ranges, splatScales);
+
+	m_last_rendered_count = 0;
+	for (const auto& r : ranges)
+		m_last_rendered_count += r.second;
+}
+
 inline void CPointCloud::internal_render_one_point([
 	[maybe_unused]] size_t i) const
 {
@@ -360,11 +396,8 @@ void CPointCloud::insertPoint(float x, float y, float z)
 	m_points.emplace_back(x, y, z);
 
 	m_minmax_valid = false;
-
-	// JL: TODO note: Well, this can be clearly done much more efficiently
-	// but...I don't have time! :-(
-	markAllPointsAsNew();
-	CRenderizable::notifyChange();
+	octree_mark_as_outdated();
+	markPointsRangeDirty(m_points.size() - 1, m_points.size());
 }
 
 /** Write an individual point (checks for "i" in the valid range only in
@@ -376,11 +409,8 @@ void CPointCloud::setPoint(
 	m_points.at(i) = {x, y, z};
 
 	m_minmax_valid = false;
-
-	// JL: TODO note: Well, this can be clearly done much more efficiently
-	// but...I don't have time! :-(
-	markAllPointsAsNew();
-	CRenderizable::notifyChange();
+	octree_mark_as_outdated();
+	markPointsRangeDirty(i, i + 1);
 }
 
 /*---------------------------------------------------------------
@@ -398,7 +428,7 @@ void CPointCloud::markAllPointsAsNew()
 {
 	m_minmax_valid = false;
 	octree_mark_as_outdated();
-	CRenderizable::notifyChange();
+	markAllPointsDirty();
 }
 
 /** In a base class, reserve memory to prepare subsequent calls to
@@ -0,0 +1,326 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "opengl-precomp.h"	 // Precompiled header
+//
+#include <mrpt/io/CFileInputStream.h>
+#include <mrpt/io/zip.h>
+#include <mrpt/math/TPose3D.h>
+#include <mrpt/opengl/CPointCloudBlocks.h>
+#include <mrpt/poses/CPose3D.h>
+#include <mrpt/serialization/CArchive.h>
+
+#include <Eigen/Dense>
+#include <cstring>
+#include <iostream>
+
+using namespace mrpt;
+using namespace mrpt::opengl;
+using mrpt::img::TColor;
+using mrpt::math::TPoint3Df;
+
+IMPLEMENTS_SERIALIZABLE(
+	CPointCloudBlocks, CRenderizableShaderPoints, mrpt::opengl)
+
+namespace
+{
+constexpr size_t BYTES_PER_POINT = sizeof(TPoint3Df) + sizeof(TColor);
+}
+
+void CPointCloudBlocks::onUpdateBuffers_Points()
+{
+	// The shader buffers themselves hold the loaded points: nothing to do.
+}
+
+bool CPointCloudBlocks::onUpdateBuffers_PointsRange(
+	[[maybe_unused]] size_t first, [[maybe_unused]] size_t last)
+{
+	return true;
+}
+
+void CPointCloudBlocks::moveStagedPoints() const
+{
+	if (m_stagedPoints.empty()) return;
+
+	m_vertex_buffer_data.insert(
+		m_vertex_buffer_data.end(), m_stagedPoints.begin(),
+		m_stagedPoints.end());
+	m_color_buffer_data.insert(
+		m_color_buffer_data.end(), m_stagedColors.begin(),
+		m_stagedColors.end());
+	m_stagedPoints.clear();
+	m_stagedColors.clear();
+}
+
+void CPointCloudBlocks::renderUpdateBuffers() const
+{
+	// Move the points loaded in the last rendering to the shader buffers.
+	// Only them are uploaded (see markPointsRangeDirty() in render()):
+	moveStagedPoints();
+
+	CRenderizableShaderPoints::renderUpdateBuffers();
+}
+
+void CPointCloudBlocks::render(const RenderContext& rc) const
+{
+	CRenderizableShaderPoints::render(rc);
+
+	m_pendingVisible = false;
+	if (isFullyLoaded() || m_blockFile.empty()) return;
+
+	// Frustum culling: the cloud is not visible if all bounding box corners
+	// are out of the same clip plane.
+	const auto& pmv = rc.state->pmv_matrix.asEigen();
+	unsigned int outside = 0x3f;
+	for (int c = 0; c < 8 && outside; c++)
+	{
+		const Eigen::Vector4f p = pmv *
+			Eigen::Vector4f(
+				static_cast<float>((c & 1) ? m_bbox.max.x : m_bbox.min.x),
+				static_cast<float>((c & 2) ? m_bbox.max.y : m_bbox.min.y),
+				static_cast<float>((c & 4) ? m_bbox.max.z : m_bbox.min.z),
+				1.0f);
+		unsigned int code = 0;
+		if (p.x() < -p.w()) code |= 0x01;
+		if (p.x() > p.w()) code |= 0x02;
+		if (p.y() < -p.w()) code |= 0x04;
+		if (p.y() > p.w()) code |= 0x08;
+		if (p.z() < -p.w()) code |= 0x10;
+		if (p.z() > p.w()) code |= 0x20;
+		outside &= code;
+	}
+	if (outside) return;
+
+	// Load more blocks, to be uploaded before the next rendering. Points are
+	// appended after those already in the shader buffers and the staging
+	// ones, not passed to the shader buffers yet:
+	const size_t first = getLoadedPointCount();
+	try
+	{
+		loadBlocks(m_loadBudget);
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << "[CPointCloudBlocks] Error loading blocks from '"
+				  << m_blockFile << "' (giving up): " << e.what() << "\n";
+		m_nextBlock = m_blocks.size();
+	}
+	markPointsRangeDirty(first, getLoadedPointCount());
+
+	m_pendingVisible = true;
+}
+
+void CPointCloudBlocks::loadBlocks(size_t maxPoints) const
+{
+	if (isFullyLoaded()) return;
+
+	mrpt::io::CFileInputStream f;
+	if (!f.open(m_blockFile))
+		THROW_EXCEPTION_FMT(
+			"Cannot open block file '%s'", m_blockFile.c_str());
+
+	std::vector<uint8_t> fileData, rawData;
+	size_t loaded = 0;
+	while (!isFullyLoaded() && (loaded == 0 || loaded < maxPoints))
+	{
+		const TBlock& b = m_blocks[m_nextBlock];
+		const size_t n = b.numPoints;
+		const size_t rawSize = n * BYTES_PER_POINT;
+
+		fileData.resize(b.fileSize);
+		f.Seek(b.offset);
+		if (f.Read(fileData.data(), fileData.size()) != fileData.size())
+			THROW_EXCEPTION_FMT(
+				"Unexpected end of file reading block #%u",
+				static_cast<unsigned int>(m_nextBlock));
+
+		if (b.compressed)
+		{
+			rawData.resize(rawSize);
+			size_t actualSize = 0;
+			mrpt::io::zip::decompress(
+				fileData.data(), fileData.size(), rawData.data(), rawSize,
+				actualSize);
+			ASSERT_EQUAL_(actualSize, rawSize);
+		}
+		else
+		{
+			ASSERT_EQUAL_(fileData.size(), rawSize);
+			rawData.swap(fileData);
+		}
+
+		// Block data: all the point coordinates, then all the colors, with
+		// the memory layout of the shader buffers:
+		const size_t n0 = m_stagedPoints.size();
+		m_stagedPoints.resize(n0 + n);
+		m_stagedColors.resize(n0 + n);
+		if (n)
+		{
+			std::memcpy(
+				&m_stagedPoints[n0], rawData.data(), n * sizeof(TPoint3Df));
+			std::memcpy(
+				static_cast<void*>(&m_stagedColors[n0]),
+				rawData.data() + n * sizeof(TPoint3Df), n * sizeof(TColor));
+		}
+
+		loaded += n;
+		m_nextBlock++;
+	}
+}
+
+void CPointCloudBlocks::loadAllBlocks()
+{
+	const size_t first = getLoadedPointCount();
+	loadBlocks(m_totalPoints);
+	moveStagedPoints();
+	markPointsRangeDirty(first, getLoadedPointCount());
+}
+
+void CPointCloudBlocks::discardLoadedPoints()
+{
+	m_vertex_buffer_data.clear();
+	m_color_buffer_data.clear();
+	m_stagedPoints.clear();
+	m_stagedColors.clear();
+	m_nextBlock = 0;
+	m_pendingVisible = false;
+	markAllPointsDirty();
+}
+
+void CPointCloudBlocks::setBlockFile(const std::string& fileName)
+{
+	m_blockFile = fileName;
+	discardLoadedPoints();
+}
+
+CPointCloudBlocks::Ptr CPointCloudBlocks::FromPointsObject(
+	const CRenderizableShaderPoints& src, mrpt::io::CStream& out,
+	size_t pointsPerBlock, bool compress, size_t blockAlignment)
+{
+	ASSERT_(pointsPerBlock > 0);
+	ASSERT_(blockAlignment > 0);
+
+	const auto& pts = src.shaderPointsVertexPointBuffer();
+	const auto& colors = src.shaderPointsVertexColorBuffer();
+	const size_t N = pts.size();
+
+	auto o = std::make_shared<CPointCloudBlocks>();
+
+	o->setName(src.getName());
+	o->setColor_u8(src.getColor_u8());
+	o->setPose(src.getPose());
+	o->setScale(src.getScaleX(), src.getScaleY(), src.getScaleZ());
+	o->setVisibility(src.isVisible());
+	o->enableShowName(src.isShowNameEnabled());
+	o->setLocalRepresentativePoint(src.getLocalRepresentativePoint());
+	o->setPointSize(src.getPointSize());
+	o->enableVariablePointSize(src.isEnabledVariablePointSize());
+	o->setVariablePointSize_k(src.getVariablePointSize_k());
+	o->setVariablePointSize_DepthScale(src.getVariablePointSize_DepthScale());
+	o->enableSplats(src.isEnabledSplats());
+	o->setSplatRadius(src.getSplatRadius());
+	o->setSplatMaxSize(src.getSplatMaxSize());
+
+	o->m_totalPoints = N;
+	if (N)
+	{
+		o->m_bbox = mrpt::math::TBoundingBox::PlusMinusInfinity();
+		for (const auto& p : pts)
+			o->m_bbox.updateWithPoint(p.cast<double>());
+	}
+
+	// Interleaved blocks, so each one is a uniform subsample of the cloud:
+	const size_t nBlocks = (N + pointsPerBlock - 1) / pointsPerBlock;
+	std::vector<uint8_t> rawData, compressedData;
+	const std::vector<uint8_t> zeros(blockAlignment, 0);
+
+	for (size_t b = 0; b < nBlocks; b++)
+	{
+		const size_t n = (N - b + nBlocks - 1) / nBlocks;
+
+		rawData.resize(n * BYTES_PER_POINT);
+		uint8_t* outPts = rawData.data();
+		uint8_t* outColors = rawData.data() + n * sizeof(TPoint3Df);
+		for (size_t k = 0; k < n; k++)
+		{
+			const size_t i = b + k * nBlocks;
+			std::memcpy(
+				outPts + k * sizeof(TPoint3Df), &pts[i], sizeof(TPoint3Df));
+			const TColor c =
+				i < colors.size() ? colors[i] : src.getColor_u8();
+			std::memcpy(outColors + k * sizeof(TColor), &c, sizeof(TColor));
+		}
+
+		// Align the start of the block:
+		if (const size_t rem = out.getPosition() % blockAlignment; rem != 0)
+			out.Write(zeros.data(), blockAlignment - rem);
+
+		TBlock blk;
+		blk.offset = out.getPosition();
+		blk.numPoints = static_cast<uint32_t>(n);
+
+		if (compress)
+			mrpt::io::zip::compress(
+				rawData.data(), rawData.size(), compressedData);
+		if (compress && compressedData.size() < rawData.size())
+		{
+			blk.compressed = true;
+			blk.fileSize = compressedData.size();
+			out.Write(compressedData.data(), compressedData.size());
+		}
+		else
+		{
+			blk.fileSize = rawData.size();
+			out.Write(rawData.data(), rawData.size());
+		}
+		o->m_blocks.push_back(blk);
+	}
+
+	return o;
+}
+
+uint8_t CPointCloudBlocks::serializeGetVersion() const { return 0; }
+void CPointCloudBlocks::serializeTo(mrpt::serialization::CArchive& out) const
+{
+	writeToStreamRender(out);
+	CRenderizableShaderPoints::params_serialize(out);
+
+	out << m_blockFile;
+	out.WriteAs<uint64_t>(m_totalPoints);
+	out << m_bbox.min << m_bbox.max;
+	out.WriteAs<uint64_t>(m_loadBudget);
+	out.WriteAs<uint32_t>(m_blocks.size());
+	for (const auto& b : m_blocks)
+		out << b.offset << b.fileSize << b.numPoints << b.compressed;
+}
+
+void CPointCloudBlocks::serializeFrom(
+	mrpt::serialization::CArchive& in, uint8_t version)
+{
+	switch (version)
+	{
+		case 0:
+		{
+			readFromStreamRender(in);
+			CRenderizableShaderPoints::params_deserialize(in);
+
+			in >> m_blockFile;
+			m_totalPoints = in.ReadAs<uint64_t>();
+			in >> m_bbox.min >> m_bbox.max;
+			m_loadBudget = in.ReadAs<uint64_t>();
+			m_blocks.resize(in.ReadAs<uint32_t>());
+			for (auto& b : m_blocks)
+				in >> b.offset >> b.fileSize >> b.numPoints >> b.compressed;
+		}
+		break;
+		default: MRPT_THROW_UNKNOWN_SERIALIZATION_VERSION(version);
+	};
+
+	discardLoadedPoints();
+}
@@ -0,0 +1,91 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/opengl/COpenGLScene.h>
+#include <mrpt/opengl/CPointCloud.h>
+#include <mrpt/opengl/CPointCloudBlocks.h>
+#include <mrpt/opengl/CSetOfObjects.h>
+#include <mrpt/system/filesystem.h>
+
+#include <algorithm>
+
+using namespace mrpt::opengl;
+
+namespace
+{
+std::vector<float> sortedXs(const std::vector<mrpt::math::TPoint3Df>& pts)
+{
+	std::vector<float> xs;
+	for (const auto& p : pts)
+		xs.push_back(p.x);
+	std::sort(xs.begin(), xs.end());
+	return xs;
+}
+}  // namespace
+
+TEST(CPointCloudBlocks, saveLoadBlockFile)
+{
+	for (const bool compress : {false, true})
+	{
+		const size_t N = 1000;
+
+		auto bigCloud = CPointCloud::Create();
+		for (size_t i = 0; i < N; i++)
+			bigCloud->insertPoint(i * 0.1f, std::sin(i * 0.1f), 1.0f);
+		bigCloud->setName("big");
+		bigCloud->setPointSize(3.0f);
+
+		auto smallCloud = CPointCloud::Create();
+		smallCloud->insertPoint(1.0f, 2.0f, 3.0f);
+
+		auto objs = CSetOfObjects::Create();
+		objs->insert(bigCloud);
+
+		COpenGLScene scene;
+		scene.insert(objs);
+		scene.insert(smallCloud);
+
+		const auto fil = mrpt::system::getTempFileName();
+		ASSERT_TRUE(scene.saveToBlockFile(fil, 100, 300, compress));
+		EXPECT_TRUE(COpenGLScene::isBlockFile(fil));
+
+		// The original scene is not modified:
+		EXPECT_EQ(objs->getByClass<CPointCloud>(), bigCloud);
+
+		COpenGLScene loaded;
+		ASSERT_TRUE(loaded.loadFromFile(fil));
+
+		auto loadedObjs = loaded.getByClass<CSetOfObjects>();
+		ASSERT_TRUE(loadedObjs);
+		auto blocks = loadedObjs->getByClass<CPointCloudBlocks>();
+		ASSERT_TRUE(blocks);
+		EXPECT_TRUE(loaded.getByClass<CPointCloud>());  // the small one
+
+		EXPECT_EQ(blocks->getName(), "big");
+		EXPECT_EQ(blocks->getPointSize(), 3.0f);
+		EXPECT_EQ(blocks->getBlockFile(), fil);
+		EXPECT_EQ(blocks->getBlocks().size(), 4U);
+		EXPECT_EQ(blocks->getTotalPointCount(), N);
+		EXPECT_EQ(blocks->getLoadedPointCount(), 0U);
+		EXPECT_FALSE(blocks->isFullyLoaded());
+
+		const auto bb = blocks->getBoundingBox();
+		EXPECT_NEAR(bb.min.x, 0.0, 1e-4);
+		EXPECT_NEAR(bb.max.x, (N - 1) * 0.1, 1e-4);
+
+		blocks->loadAllBlocks();
+		EXPECT_TRUE(blocks->isFullyLoaded());
+		EXPECT_EQ(blocks->getLoadedPointCount(), N);
+		EXPECT_EQ(blocks->shaderPointsVertexColorBuffer().size(), N);
+		EXPECT_EQ(
+			sortedXs(blocks->shaderPointsVertexPointBuffer()),
+			sortedXs(bigCloud->shaderPointsVertexPointBuffer()));
+	}
+}
@@ -46,6 +46,11 @@ void CPointCloudColoured::onUpdateBuffers_Points()
 	octree_assure_uptodate();  // Rebuild octree if needed
 	m_last_rendered_count_ongoing = 0;
 
+	// Draw order for the octree LOD mode:
+	if (octree_is_lod_enabled()) octree_build_draw_order(m_index_buffer_data);
+	else
+		m_index_buffer_data.clear();
+
 	// TODO: Restore rendering using octrees?
 	// octree_render(*rc.state);  // Render all points recursively:
 
@@ -61,6 +66,27 @@ void CPointCloudColoured::onUpdateBuffers_Points()
 	m_last_rendered_count = m_last_rendered_count_ongoing;
 }
 
+bool CPointCloudColoured::onUpdateBuffers_PointsRange(
+	[[maybe_unused]] size_t first, [[maybe_unused]] size_t last)
+{
+	// Both shader buffers are aliases of the points and their colors, and the
+	// octree is not needed for rendering (it is rebuilt upon demand), unless
+	// the LOD draw order has to be rebuilt:
+	return !octree_is_lod_enabled();
+}
+
+void CPointCloudColoured::onRenderPointsRanges(
+	const RenderContext& rc,
+	std::vector<std::pair<size_t, size_t>>& ranges,
+	std::vector<float>* splatScales) const
+{
+	octree_get_visible_draw_ranges(*rc.state, ranges, splatScales);
+
+	m_last_rendered_count = 0;
+	for (const auto& r : ranges)
+		m_last_rendered_count += r.second;
+}
+
 /** Render a subset of points (required by octree renderer) */
 void CPointCloudColoured::render_subset(
 	[[maybe_unused]] const bool all,
@@ -151,10 +177,8 @@ void CPointCloudColoured::setPoint(size_t i, const TPointXYZfRGBAu8& p)
 	c.B = p.b;
 	c.A = p.a;
 
-	// JL: TODO note: Well, this can be clearly done much more efficiently
-	// but...I don't have time! :-(
-	markAllPointsAsNew();
-	CRenderizable::notifyChange();
+	octree_mark_as_outdated();
+	markPointsRangeDirty(i, i + 1);
 }
 
 /** Inserts a new point into the point cloud. */
@@ -164,10 +188,8 @@ void CPointCloudColoured::push_back(
 	m_points.emplace_back(x, y, z);
 	m_point_colors.emplace_back(f2u8(R), f2u8(G), f2u8(B), f2u8(A));
 
-	// JL: TODO note: Well, this can be clearly done much more efficiently
-	// but...I don't have time! :-(
-	markAllPointsAsNew();
-	CRenderizable::notifyChange();
+	octree_mark_as_outdated();
+	markPointsRangeDirty(m_points.size() - 1, m_points.size());
 }
 
 void CPointCloudColoured::insertPoint(const mrpt::math::TPointXYZfRGBAu8& p)
@@ -175,15 +197,15 @@ void CPointCloudColoured::insertPoint(const mrpt::math::TPointXYZfRGBAu8& p)
 	m_points.emplace_back(p.pt);
 	m_point_colors.emplace_back(p.r, p.g, p.b, p.a);
 
-	markAllPointsAsNew();
-	CRenderizable::notifyChange();
+	octree_mark_as_outdated();
+	markPointsRangeDirty(m_points.size() - 1, m_points.size());
 }
 
 // Do needed internal work if all points are new (octree rebuilt,...)
 void CPointCloudColoured::markAllPointsAsNew()
 {
 	octree_mark_as_outdated();
-	CRenderizable::notifyChange();
+	markAllPointsDirty();
 }
 /** In a base class, reserve memory to prepare subsequent calls to
  * PLY_import_set_vertex */
@@ -227,10 +249,8 @@ void CPointCloudColoured::PLY_export_get_vertex(
 	const size_t idx, mrpt::math::TPoint3Df& pt, bool& pt_has_color,
 	mrpt::img::TColorf& pt_color) const
 {
-	auto& p = m_points[idx];
-	auto& p_color = m_point_colors[idx];
-	p = pt;
-	p_color = pt_color.asTColor();
+	pt = m_points[idx];
+	pt_color = mrpt::img::TColorf(m_point_colors[idx]);
 	pt_has_color = true;
 }
 
@@ -20,6 +20,7 @@
 #include <mrpt/poses/CPose3D.h>
 #include <mrpt/serialization/CArchive.h>
 
+#include <algorithm>
 #include <mutex>
 
 using namespace std;
@@ -41,6 +42,33 @@ CRenderizable::CRenderizable()
 // Destructor:
 CRenderizable::~CRenderizable() = default;
 
+const mrpt::math::CMatrixFloat44& CRenderizable::getLocalTransform() const
+{
+	auto& c = m_localTransform;
+
+	std::array<double, 12> pose;
+	const auto& R = m_pose.getRotationMatrix();
+	std::copy(R.data(), R.data() + 9, pose.begin());
+	pose[9] = m_pose.x();
+	pose[10] = m_pose.y();
+	pose[11] = m_pose.z();
+	const std::array<float, 3> scale = {m_scale_x, m_scale_y, m_scale_z};
+
+	if (c.valid && c.pose == pose && c.scale == scale) return c.HM;
+
+	c.HM = m_pose.getHomogeneousMatrixVal<mrpt::math::CMatrixDouble44>()
+			   .cast_float();
+	// Scaling (HM * diag(sx,sy,sz,1)):
+	for (int col = 0; col < 3; col++)
+		for (int row = 0; row < 3; row++)
+			c.HM(row, col) *= scale[col];
+
+	c.pose = pose;
+	c.scale = scale;
+	c.valid = true;
+	return c.HM;
+}
+
 void CRenderizable::writeToStreamRender(
 	mrpt::serialization::CArchive& out) const
 {
@@ -14,6 +14,8 @@
 #include <mrpt/opengl/opengl_api.h>
 #include <mrpt/serialization/CArchive.h>
 
+#include <algorithm>
+
 using namespace mrpt;
 using namespace mrpt::opengl;
 
@@ -26,46 +28,160 @@ CRenderizableShaderPoints::~CRenderizableShaderPoints() = default;
 void CRenderizableShaderPoints::renderUpdateBuffers() const
 {
 #if MRPT_HAS_OPENGL_GLUT || MRPT_HAS_EGL
+	auto& me = const_cast<CRenderizableShaderPoints&>(*this);
+
+	// Only upload the modified points, if possible:
+	const bool tryPartial = m_dirtyRange && !m_allPointsDirty &&
+		m_index_buffer_data.empty() && m_vertexBuffer.initialized() &&
+		m_colorBuffer.initialized();
+	const size_t first = m_dirtyFirst, last = m_dirtyLast;
+	m_dirtyRange = false;
+	m_allPointsDirty = false;
+
+	const bool rangeDone =
+		tryPartial && me.onUpdateBuffers_PointsRange(first, last);
+	if (!rangeDone)
+	{
+		// Generate vertices & colors:
+		me.onUpdateBuffers_Points();
+	}
 
-	// Generate vertices & colors:
-	const_cast<CRenderizableShaderPoints&>(*this).onUpdateBuffers_Points();
+	const size_t N = m_vertex_buffer_data.size();
+	const size_t vertexSize = sizeof(m_vertex_buffer_data[0]);
+	const size_t colorSize = sizeof(m_color_buffer_data[0]);
+
+	if (rangeDone && N <= m_bufferCapacity && last <= N &&
+		m_color_buffer_data.size() == N)
+	{
+		if (first < last)
+		{
+			m_vertexBuffer.bind();
+			m_vertexBuffer.write(
+				vertexSize * first, &m_vertex_buffer_data[first],
+				vertexSize * (last - first));
+
+			m_colorBuffer.bind();
+			m_colorBuffer.write(
+				colorSize * first, &m_color_buffer_data[first],
+				colorSize * (last - first));
+		}
+		m_vao.createOnce();
+		return;
+	}
+
+	// Reallocate the buffers. The first time, with the exact size. Then, leave
+	// some room to grow, so appending points does not reallocate every frame:
+	if (!m_vertexBuffer.initialized()) m_bufferCapacity = 0;
+
+	size_t capacity = N;
+	if (m_bufferCapacity != 0)
+	{
+		if (N > m_bufferCapacity)
+			capacity = std::max(N, m_bufferCapacity + m_bufferCapacity / 2);
+		else if (N >= m_bufferCapacity / 4)
+			capacity = m_bufferCapacity;
+
+		m_vertexBuffer.setUsage(COpenGLBuffer::Usage::DynamicDraw);
+		m_colorBuffer.setUsage(COpenGLBuffer::Usage::DynamicDraw);
+	}
+	m_bufferCapacity = capacity;
 
 	// Define OpenGL buffers:
 	m_vertexBuffer.createOnce();
 	m_vertexBuffer.bind();
-	m_vertexBuffer.allocate(
-		m_vertex_buffer_data.data(),
-		sizeof(m_vertex_buffer_data[0]) * m_vertex_buffer_data.size());
+	m_vertexBuffer.allocate(nullptr, vertexSize * capacity);
+	if (N) m_vertexBuffer.write(0, m_vertex_buffer_data.data(), vertexSize * N);
 
 	// color buffer:
+	const size_t nColors = m_color_buffer_data.size();
 	m_colorBuffer.createOnce();
 	m_colorBuffer.bind();
-	m_colorBuffer.allocate(
-		m_color_buffer_data.data(),
-		sizeof(m_color_buffer_data[0]) * m_color_buffer_data.size());
+	m_colorBuffer.allocate(nullptr, colorSize * std::max(capacity, nColors));
+	if (nColors)
+		m_colorBuffer.write(
+			0, m_color_buffer_data.data(), colorSize * nColors);
 
 	// VAO: required to use glEnableVertexAttribArray()
 	m_vao.createOnce();
+
+	// Draw order, if any:
+	if (!m_index_buffer_data.empty())
+	{
+		m_vao.bind();
+		m_indexBuffer.createOnce();
+		m_indexBuffer.bind();
+		m_indexBuffer.allocate(
+			m_index_buffer_data.data(),
+			sizeof(m_index_buffer_data[0]) * m_index_buffer_data.size());
+	}
+	else
+		m_indexBuffer.destroy();
 #endif
 }
 
+void CRenderizableShaderPoints::markPointsRangeDirty(
+	size_t first, size_t last) const
+{
+	if (!m_allPointsDirty && first < last)
+	{
+		if (m_dirtyRange)
+		{
+			m_dirtyFirst = std::min(m_dirtyFirst, first);
+			m_dirtyLast = std::max(m_dirtyLast, last);
+		}
+		else if (hasToUpdateBuffers())
+		{
+			// Pending changes of unknown extent:
+			m_allPointsDirty = true;
+		}
+		else
+		{
+			m_dirtyRange = true;
+			m_dirtyFirst = first;
+			m_dirtyLast = last;
+		}
+	}
+	notifyChange();
+}
+
+void CRenderizableShaderPoints::markAllPointsDirty() const
+{
+	m_allPointsDirty = true;
+	notifyChange();
+}
+
 void CRenderizableShaderPoints::render(const RenderContext& rc) const
 {
 #if MRPT_HAS_OPENGL_GLUT || MRPT_HAS_EGL
 
-	// Point size as uniform:
-	glUniform1f(rc.shader->uniformId("vertexPointSize"), m_pointSize);
+	const bool splats = rc.shader_id == DefaultShaderID::POINTS_SPLAT;
+	if (splats)
+	{
+		// Splat size in space, and the viewport height to get it in pixels:
+		glUniform1f(rc.shader->uniformId("splatRadius"), m_splatRadius);
+		glUniform1f(rc.shader->uniformId("splatScale"), 1.0f);
+		glUniform1f(rc.shader->uniformId("splatMaxSize"), m_splatMaxSize);
+		glUniform1f(
+			rc.shader->uniformId("viewportHeight"),
+			static_cast<float>(rc.state->viewport_height));
+	}
+	else
+	{
+		// Point size as uniform:
+		glUniform1f(rc.shader->uniformId("vertexPointSize"), m_pointSize);
 
-	// Variable point size code in the shader:
-	glUniform1i(
-		rc.shader->uniformId("enableVariablePointSize"),
-		m_variablePointSize ? 1 : 0);
+		// Variable point size code in the shader:
+		glUniform1i(
+			rc.shader->uniformId("enableVariablePointSize"),
+			m_variablePointSize ? 1 : 0);
 
-	glUniform1f(
-		rc.shader->uniformId("variablePointSize_K"), m_variablePointSize_K);
-	glUniform1f(
-		rc.shader->uniformId("variablePointSize_DepthScale"),
-		m_variablePointSize_DepthScale);
+		glUniform1f(
+			rc.shader->uniformId("variablePointSize_K"),
+			m_variablePointSize_K);
+		glUniform1f(
+			rc.shader->uniformId("variablePointSize_DepthScale"),
+			m_variablePointSize_DepthScale);
+	}
 
 	// Set up the vertex array:
 	std::optional<GLuint> attr_position;
@@ -104,7 +220,53 @@ void CRenderizableShaderPoints::render(const RenderContext& rc) const
 		CHECK_OPENGL_ERROR();
 	}
 
-	glDrawArrays(GL_POINTS, 0, m_vertex_buffer_data.size());
+	if (m_index_buffer_data.empty())
+		glDrawArrays(GL_POINTS, 0, m_vertex_buffer_data.size());
+	else
+	{
+		// Only some subsets of the points, in one single call:
+		onRenderPointsRanges(
+			rc, m_drawRanges, splats ? &m_drawRangesSplatScales : nullptr);
+		m_vao.bind();
+		m_indexBuffer.bind();
+		if (splats)
+		{
+			// One call per range, each with its own splat size:
+			ASSERT_EQUAL_(m_drawRangesSplatScales.size(), m_drawRanges.size());
+			const auto scaleId = rc.shader->uniformId("splatScale");
+			for (size_t i = 0; i < m_drawRanges.size(); i++)
+			{
+				const auto& r = m_drawRanges[i];
+				glUniform1f(scaleId, m_drawRangesSplatScales[i]);
+				glDrawElements(
+					GL_POINTS, r.second, GL_UNSIGNED_INT,
+					BUFFER_OFFSET(sizeof(uint32_t) * r.first));
+			}
+		}
+		else
+		{
+#if defined(__EMSCRIPTEN__)
+			for (const auto& r : m_drawRanges)
+				glDrawElements(
+					GL_POINTS, r.second, GL_UNSIGNED_INT,
+					BUFFER_OFFSET(sizeof(uint32_t) * r.first));
+#else
+			std::vector<GLsizei> counts;
+			std::vector<const GLvoid*> offsets;
+			counts.reserve(m_drawRanges.size());
+			offsets.reserve(m_drawRanges.size());
+			for (const auto& r : m_drawRanges)
+			{
+				counts.push_back(static_cast<GLsizei>(r.second));
+				offsets.push_back(BUFFER_OFFSET(sizeof(uint32_t) * r.first));
+			}
+			if (!counts.empty())
+				glMultiDrawElements(
+					GL_POINTS, counts.data(), GL_UNSIGNED_INT, offsets.data(),
+					static_cast<GLsizei>(counts.size()));
+#endif
+		}
+	}
 	CHECK_OPENGL_ERROR();
 
 	if (attr_position) glDisableVertexAttribArray(*attr_position);
@@ -116,9 +278,11 @@ void CRenderizableShaderPoints::render(const RenderContext& rc) const
 void CRenderizableShaderPoints::params_serialize(
 	mrpt::serialization::CArchive& out) const
 {
-	out.WriteAs<uint8_t>(0);  // serialization version
+	out.WriteAs<uint8_t>(1);  // serialization version
 	out << m_pointSize << m_variablePointSize << m_variablePointSize_K
 		<< m_variablePointSize_DepthScale;
+	// v1:
+	out << m_splats << m_splatRadius << m_splatMaxSize;
 }
 void CRenderizableShaderPoints::params_deserialize(
 	mrpt::serialization::CArchive& in)
@@ -128,8 +292,17 @@ void CRenderizableShaderPoints::params_deserialize(
 	switch (version)
 	{
 		case 0:
+		case 1:
 			in >> m_pointSize >> m_variablePointSize >> m_variablePointSize_K >>
 				m_variablePointSize_DepthScale;
+			if (version >= 1)
+				in >> m_splats >> m_splatRadius >> m_splatMaxSize;
+			else
+			{
+				m_splats = false;
+				m_splatRadius = 0.05f;
+				m_splatMaxSize = 64.0f;
+			}
 			break;
 		default: MRPT_THROW_UNKNOWN_SERIALIZATION_VERSION(version);
 	};
@@ -0,0 +1,392 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "opengl-precomp.h"	 // Precompiled header
+//
+#include <mrpt/opengl/CRenderizableShaderTriangles.h>
+#include <mrpt/opengl/CRenderizableShaderWireFrame.h>
+#include <mrpt/opengl/CSetOfInstances.h>
+#include <mrpt/opengl/CSetOfObjects.h>
+#include <mrpt/opengl/Shader.h>
+#include <mrpt/opengl/TLightParameters.h>
+#include <mrpt/opengl/opengl_api.h>
+#include <mrpt/poses/CPose3D.h>
+#include <mrpt/serialization/CArchive.h>
+
+#include <Eigen/Dense>
+#include <algorithm>
+
+using namespace mrpt;
+using namespace mrpt::opengl;
+using namespace mrpt::math;
+using mrpt::poses::CPose3D;
+
+IMPLEMENTS_SERIALIZABLE(CSetOfInstances, CRenderizable, mrpt::opengl)
+
+namespace
+{
+// Pose and scale of an object, as in RenderQueue:
+CMatrixDouble44 objectMatrix(const CRenderizable& o)
+{
+	auto HM = o.getPoseRef().getHomogeneousMatrixVal<CMatrixDouble44>();
+	for (int r = 0; r < 3; r++)
+	{
+		HM(r, 0) *= o.getScaleX();
+		HM(r, 1) *= o.getScaleY();
+		HM(r, 2) *= o.getScaleZ();
+	}
+	return HM;
+}
+
+TPoint3Df transformPoint(const CMatrixDouble44& M, const TPoint3Df& p)
+{
+	return TPoint3Df(
+		d2f(M(0, 0) * p.x + M(0, 1) * p.y + M(0, 2) * p.z + M(0, 3)),
+		d2f(M(1, 0) * p.x + M(1, 1) * p.y + M(1, 2) * p.z + M(1, 3)),
+		d2f(M(2, 0) * p.x + M(2, 1) * p.y + M(2, 2) * p.z + M(2, 3)));
+}
+
+TVector3Df rotateVector(const CMatrixDouble44& M, const TVector3Df& v)
+{
+	return TVector3Df(
+		d2f(M(0, 0) * v.x + M(0, 1) * v.y + M(0, 2) * v.z),
+		d2f(M(1, 0) * v.x + M(1, 1) * v.y + M(1, 2) * v.z),
+		d2f(M(2, 0) * v.x + M(2, 1) * v.y + M(2, 2) * v.z));
+}
+
+// Collects the triangles and lines of an object and its children, in the
+// frame of its parent:
+void flattenObject(
+	const CRenderizable& o, const CMatrixDouble44& parentHM,
+	std::vector<TTriangle>& tris, std::vector<TPoint3Df>& lineVertices,
+	std::vector<mrpt::img::TColor>& lineColors)
+{
+	if (!o.isVisible()) return;
+
+	CMatrixDouble44 HM;
+	HM.asEigen() = parentHM.asEigen() * objectMatrix(o).asEigen();
+
+	if (const auto* s = dynamic_cast<const CSetOfObjects*>(&o); s)
+	{
+		for (const auto& child : *s)
+			if (child)
+				flattenObject(*child, HM, tris, lineVertices, lineColors);
+		return;
+	}
+
+	const auto shaders = o.requiredShaders();
+	const auto usesShader = [&shaders](shader_id_t id) {
+		return std::find(shaders.begin(), shaders.end(), id) != shaders.end();
+	};
+
+	if (const auto* t = dynamic_cast<const CRenderizableShaderTriangles*>(&o);
+		t && usesShader(DefaultShaderID::TRIANGLES))
+	{
+		const_cast<CRenderizableShaderTriangles*>(t)
+			->onUpdateBuffers_Triangles();
+		for (TTriangle tri : t->shaderTexturedTrianglesBuffer())
+		{
+			for (auto& v : tri.vertices)
+			{
+				v.xyzrgba.pt = transformPoint(HM, v.xyzrgba.pt);
+				v.normal = rotateVector(HM, v.normal);
+			}
+			tris.push_back(tri);
+		}
+	}
+
+	if (const auto* w = dynamic_cast<const CRenderizableShaderWireFrame*>(&o);
+		w && usesShader(DefaultShaderID::WIREFRAME))
+	{
+		const_cast<CRenderizableShaderWireFrame*>(w)
+			->onUpdateBuffers_Wireframe();
+		const auto& vs = w->shaderWireframeVertexPointBuffer();
+		const auto& cs = w->shaderWireframeVertexColorBuffer();
+		for (size_t i = 0; i < vs.size(); i++)
+		{
+			lineVertices.push_back(transformPoint(HM, vs[i]));
+			lineColors.push_back(i < cs.size() ? cs[i] : o.getColor_u8());
+		}
+	}
+}
+}  // namespace
+
+shader_list_t CSetOfInstances::requiredShaders() const
+{
+	shader_list_t lst;
+	if (!m_lineVertices.empty())
+		lst.push_back(DefaultShaderID::WIREFRAME_INSTANCED);
+	if (!m_triangles.empty())
+		lst.push_back(DefaultShaderID::TRIANGLES_INSTANCED);
+	return lst;
+}
+
+void CSetOfInstances::renderUpdateBuffers() const
+{
+#if MRPT_HAS_OPENGL_GLUT || MRPT_HAS_EGL
+	// The prototype geometry:
+	m_triangles.clear();
+	m_lineVertices.clear();
+	m_lineColors.clear();
+	if (m_prototype)
+		flattenObject(
+			*m_prototype, CMatrixDouble44::Identity(), m_triangles,
+			m_lineVertices, m_lineColors);
+
+	// The instance poses, as column-major matrices:
+	const size_t N = m_poses.size();
+	m_instanceMatrices.resize(N);
+	CMatrixDouble44 HM;
+	for (size_t i = 0; i < N; i++)
+	{
+		CPose3D(m_poses[i]).getHomogeneousMatrix(HM);
+		for (int c = 0; c < 4; c++)
+			for (int r = 0; r < 4; r++)
+				m_instanceMatrices[i][c * 4 + r] = d2f(HM(r, c));
+	}
+
+	// Define OpenGL buffers:
+	m_trianglesBuffer.createOnce();
+	m_trianglesBuffer.bind();
+	m_trianglesBuffer.allocate(
+		m_triangles.data(), sizeof(m_triangles[0]) * m_triangles.size());
+
+	m_lineVerticesBuffer.createOnce();
+	m_lineVerticesBuffer.bind();
+	m_lineVerticesBuffer.allocate(
+		m_lineVertices.data(),
+		sizeof(m_lineVertices[0]) * m_lineVertices.size());
+
+	m_lineColorsBuffer.createOnce();
+	m_lineColorsBuffer.bind();
+	m_lineColorsBuffer.allocate(
+		m_lineColors.data(), sizeof(m_lineColors[0]) * m_lineColors.size());
+
+	m_instanceMatricesBuffer.createOnce();
+	m_instanceMatricesBuffer.bind();
+	m_instanceMatricesBuffer.allocate(
+		m_instanceMatrices.data(), sizeof(m_instanceMatrices[0]) * N);
+
+	m_instanceColorsBuffer.createOnce();
+	m_instanceColorsBuffer.bind();
+	m_instanceColorsBuffer.allocate(
+		m_colors.data(), sizeof(m_colors[0]) * m_colors.size());
+
+	// VAOs: required to use glEnableVertexAttribArray()
+	m_trianglesVao.createOnce();
+	m_linesVao.createOnce();
+#endif
+}
+
+void CSetOfInstances::freeOpenGLResources()
+{
+	m_trianglesBuffer.destroy();
+	m_lineVerticesBuffer.destroy();
+	m_lineColorsBuffer.destroy();
+	m_instanceMatricesBuffer.destroy();
+	m_instanceColorsBuffer.destroy();
+	m_trianglesVao.destroy();
+	m_linesVao.destroy();
+}
+
+// Per-instance attributes, with the VAO of the current shader already bound:
+void CSetOfInstances::setupInstanceAttributes(const RenderContext& rc) const
+{
+#if MRPT_HAS_OPENGL_GLUT || MRPT_HAS_EGL
+	if (rc.shader->hasAttribute("instancePose"))
+	{
+		// A mat4 attribute takes 4 consecutive locations, one per column:
+		const GLuint attr = rc.shader->attributeId("instancePose");
+		m_instanceMatricesBuffer.bind();
+		for (GLuint c = 0; c < 4; c++)
+		{
+			glEnableVertexAttribArray(attr + c);
+			glVertexAttribPointer(
+				attr + c, /* attribute */
+				4, /* size */
+				GL_FLOAT, /* type */
+				GL_FALSE, /* normalized? */
+				sizeof(m_instanceMatrices[0]), /* stride */
+				BUFFER_OFFSET(sizeof(float) * 4 * c));
+			glVertexAttribDivisor(attr + c, 1);
+		}
+		CHECK_OPENGL_ERROR();
+	}
+	if (rc.shader->hasAttribute("instanceColor"))
+	{
+		const GLuint attr = rc.shader->attributeId("instanceColor");
+		glEnableVertexAttribArray(attr);
+		m_instanceColorsBuffer.bind();
+		glVertexAttribPointer(
+			attr, /* attribute */
+			4, /* size */
+			GL_UNSIGNED_BYTE, /* type */
+			GL_TRUE, /* normalized? */
+			0, /* stride */
+			BUFFER_OFFSET(0) /* array buffer offset */
+		);
+		glVertexAttribDivisor(attr, 1);
+		CHECK_OPENGL_ERROR();
+	}
+#endif
+}
+
+void CSetOfInstances::render(const RenderContext& rc) const
+{
+#if MRPT_HAS_OPENGL_GLUT || MRPT_HAS_EGL
+	const GLsizei nInstances = static_cast<GLsizei>(m_poses.size());
+	if (!nInstances) return;
+
+	std::vector<GLuint> enabledAttribs;
+	const auto enableAttrib = [&](const char* name) -> std::optional<GLuint> {
+		if (!rc.shader->hasAttribute(name)) return {};
+		const GLuint attr = rc.shader->attributeId(name);
+		glEnableVertexAttribArray(attr);
+		enabledAttribs.push_back(attr);
+		return attr;
+	};
+
+	switch (rc.shader_id)
+	{
+		case DefaultShaderID::TRIANGLES_INSTANCED:
+		{
+			const Program& s = *rc.shader;
+			if (s.hasUniform("enableLight"))
+				glUniform1i(s.uniformId("enableLight"), 1);
+			if (rc.lights && s.hasUniform("light_diffuse") &&
+				s.hasUniform("light_ambient") &&
+				s.hasUniform("light_direction"))
+			{
+				const auto& l = *rc.lights;
+				glUniform4f(
+					s.uniformId("light_diffuse"), l.diffuse.R, l.diffuse.G,
+					l.diffuse.B, l.diffuse.A);
+				glUniform4f(
+					s.uniformId("light_ambient"), l.ambient.R, l.ambient.G,
+					l.ambient.B, l.ambient.A);
+				glUniform3f(
+					s.uniformId("light_direction"), l.direction.x,
+					l.direction.y, l.direction.z);
+			}
+			CHECK_OPENGL_ERROR();
+
+			m_trianglesVao.bind();
+			m_trianglesBuffer.bind();
+			if (const auto attr = enableAttrib("position"); attr)
+				glVertexAttribPointer(
+					*attr, 3, GL_FLOAT, GL_FALSE, sizeof(TTriangle::Vertex),
+					BUFFER_OFFSET(offsetof(TTriangle::Vertex, xyzrgba.pt.x)));
+			if (const auto attr = enableAttrib("vertexColor"); attr)
+				glVertexAttribPointer(
+					*attr, 4, GL_UNSIGNED_BYTE, GL_TRUE,
+					sizeof(TTriangle::Vertex),
+					BUFFER_OFFSET(offsetof(TTriangle::Vertex, xyzrgba.r)));
+			if (const auto attr = enableAttrib("vertexNormal"); attr)
+				glVertexAttribPointer(
+					*attr, 3, GL_FLOAT, GL_FALSE, sizeof(TTriangle::Vertex),
+					BUFFER_OFFSET(offsetof(TTriangle::Vertex, normal.x)));
+			CHECK_OPENGL_ERROR();
+			setupInstanceAttributes(rc);
+
+			glDisable(GL_CULL_FACE);
+			glDrawArraysInstanced(
+				GL_TRIANGLES, 0, 3 * m_triangles.size(), nInstances);
+			CHECK_OPENGL_ERROR();
+		}
+		break;
+
+		case DefaultShaderID::WIREFRAME_INSTANCED:
+		{
+#if !defined(__EMSCRIPTEN__)
+			glEnable(GL_LINE_SMOOTH);
+			CHECK_OPENGL_ERROR();
+#endif
+			m_linesVao.bind();
+			if (const auto attr = enableAttrib("position"); attr)
+			{
+				m_lineVerticesBuffer.bind();
+				glVertexAttribPointer(
+					*attr, 3, GL_FLOAT, GL_FALSE, 0, BUFFER_OFFSET(0));
+			}
+			if (const auto attr = enableAttrib("vertexColor"); attr)
+			{
+				m_lineColorsBuffer.bind();
+				glVertexAttribPointer(
+					*attr, 4, GL_UNSIGNED_BYTE, GL_TRUE, 0, BUFFER_OFFSET(0));
+			}
+			CHECK_OPENGL_ERROR();
+			setupInstanceAttributes(rc);
+
+			glDrawArraysInstanced(
+				GL_LINES, 0, m_lineVertices.size(), nInstances);
+			CHECK_OPENGL_ERROR();
+		}
+		break;
+	};
+
+	for (const auto attr : enabledAttribs)
+		glDisableVertexAttribArray(attr);
+	CHECK_OPENGL_ERROR();
+#endif
+}
+
+auto CSetOfInstances::getBoundingBox() const -> mrpt::math::TBoundingBox
+{
+	mrpt::math::TBoundingBox bb;
+	if (!m_prototype || m_poses.empty()) return bb;
+
+	const auto protoBB = m_prototype->getBoundingBox();
+	for (size_t i = 0; i < m_poses.size(); i++)
+	{
+		const auto instBB = protoBB.compose(CPose3D(m_poses[i]));
+		bb = (i == 0) ? instBB : bb.unionWith(instBB);
+	}
+	return bb.compose(m_pose);
+}
+
+uint8_t CSetOfInstances::serializeGetVersion() const { return 0; }
+void CSetOfInstances::serializeTo(mrpt::serialization::CArchive& out) const
+{
+	writeToStreamRender(out);
+
+	out << m_prototype;
+	out.WriteAs<uint32_t>(m_poses.size());
+	for (size_t i = 0; i < m_poses.size(); i++)
+	{
+		const auto& p = m_poses[i];
+		out << p.x << p.y << p.z << p.yaw << p.pitch << p.roll
+			<< m_colors[i];
+	}
+}
+
+void CSetOfInstances::serializeFrom(
+	mrpt::serialization::CArchive& in, uint8_t version)
+{
+	switch (version)
+	{
+		case 0:
+		{
+			readFromStreamRender(in);
+
+			in >> m_prototype;
+			const auto n = in.ReadAs<uint32_t>();
+			m_poses.resize(n);
+			m_colors.resize(n);
+			for (uint32_t i = 0; i < n; i++)
+			{
+				auto& p = m_poses[i];
+				in >> p.x >> p.y >> p.z >> p.yaw >> p.pitch >> p.roll >>
+					m_colors[i];
+			}
+		}
+		break;
+		default: MRPT_THROW_UNKNOWN_SERIALIZATION_VERSION(version);
+	};
+	CRenderizable::notifyChange();
+}
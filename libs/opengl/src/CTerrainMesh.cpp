@@ -0,0 +1,570 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "opengl-precomp.h"	 // Precompiled header
+//
+#include <Eigen/Dense>	// First! to avoid conflicts with X.h
+//
+#include <mrpt/opengl/CTerrainMesh.h>
+#include <mrpt/opengl/Shader.h>
+#include <mrpt/opengl/TLightParameters.h>
+#include <mrpt/opengl/opengl_api.h>
+#include <mrpt/serialization/CArchive.h>
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <optional>
+
+using namespace mrpt;
+using namespace mrpt::opengl;
+
+IMPLEMENTS_SERIALIZABLE(CTerrainMesh, CRenderizable, mrpt::opengl)
+
+namespace
+{
+// Vertex layout in the GPU buffer:
+struct TerrainVertex
+{
+	mrpt::math::TPoint3Df pt;
+	mrpt::math::TVector3Df normal;
+	uint8_t r = 0, g = 0, b = 0, a = 0;
+};
+
+// The sampled vertex indices along one side of a chunk with `n` vertices
+// for a LOD level with a step of `s` vertices. The last one is always
+// included, for chunks whose size is not a multiple of `s`.
+std::vector<size_t> lodSamples(size_t n, size_t s)
+{
+	std::vector<size_t> v;
+	for (size_t i = 0; i + 1 < n; i += s)
+		v.push_back(i);
+	v.push_back(n - 1);
+	return v;
+}
+
+// Appends the triangles (and skirts) of a chunk with nr x nc vertices at a
+// given LOD level.
+// vertexValid(r,c) tells whether a vertex has data (may be empty).
+template <typename VALID>
+void appendChunkIndices(
+	size_t C, size_t nr, size_t nc, unsigned int level,
+	const VALID& vertexValid, std::vector<uint16_t>& out)
+{
+	const size_t rowStride = C + 1;
+	const size_t skirtBase = (C + 1) * (C + 1);
+	const auto vid = [&](size_t r, size_t c) {
+		return static_cast<uint16_t>(r * rowStride + c);
+	};
+	// Skirt vertex below the grid vertex at position `t` of edge `e`:
+	const auto sid = [&](size_t e, size_t t) {
+		return static_cast<uint16_t>(skirtBase + e * (C + 1) + t);
+	};
+	const auto addQuad = [&](uint16_t a, uint16_t b, uint16_t c, uint16_t d) {
+		out.insert(out.end(), {a, b, c, a, c, d});
+	};
+
+	const auto rs = lodSamples(nr, size_t(1) << level);
+	const auto cs = lodSamples(nc, size_t(1) << level);
+
+	for (size_t i = 0; i + 1 < rs.size(); i++)
+		for (size_t j = 0; j + 1 < cs.size(); j++)
+		{
+			const size_t r0 = rs[i], r1 = rs[i + 1], c0 = cs[j], c1 = cs[j + 1];
+			if (!vertexValid(r0, c0) || !vertexValid(r1, c0) ||
+				!vertexValid(r1, c1) || !vertexValid(r0, c1))
+				continue;
+			addQuad(vid(r0, c0), vid(r1, c0), vid(r1, c1), vid(r0, c1));
+		}
+
+	// Skirts: edges 0,1 (first/last row) along columns, 2,3 (first/last
+	// column) along rows:
+	for (size_t j = 0; j + 1 < cs.size(); j++)
+	{
+		const size_t c0 = cs[j], c1 = cs[j + 1];
+		const size_t edgeRows[2] = {0, nr - 1};
+		for (size_t e = 0; e < 2; e++)
+		{
+			const size_t r = edgeRows[e];
+			if (!vertexValid(r, c0) || !vertexValid(r, c1)) continue;
+			addQuad(vid(r, c0), vid(r, c1), sid(e, c1), sid(e, c0));
+		}
+	}
+	for (size_t i = 0; i + 1 < rs.size(); i++)
+	{
+		const size_t r0 = rs[i], r1 = rs[i + 1];
+		const size_t edgeCols[2] = {0, nc - 1};
+		for (size_t e = 0; e < 2; e++)
+		{
+			const size_t c = edgeCols[e];
+			if (!vertexValid(r0, c) || !vertexValid(r1, c)) continue;
+			addQuad(vid(r0, c), vid(r1, c), sid(2 + e, r1), sid(2 + e, r0));
+		}
+	}
+}
+}  // namespace
+
+size_t CTerrainMesh::verticesPerChunk() const
+{
+	// Grid vertices, plus the skirt vertices of the 4 edges:
+	return (m_chunkSize + 1) * (m_chunkSize + 1) + 4 * (m_chunkSize + 1);
+}
+
+void CTerrainMesh::setGridLimits(float xMin, float xMax, float yMin, float yMax)
+{
+	m_xMin = xMin;
+	m_xMax = xMax;
+	m_yMin = yMin;
+	m_yMax = yMax;
+	for (auto& ch : m_chunks)
+		ch.dirty = true;
+	CRenderizable::notifyChange();
+}
+
+void CTerrainMesh::setZ(const mrpt::math::CMatrixDynamic<float>& Z)
+{
+	if (Z.rows() != m_Z.rows() || Z.cols() != m_Z.cols())
+		m_layoutDirty = true;
+	m_Z = Z;
+	for (auto& ch : m_chunks)
+		ch.dirty = true;
+	CRenderizable::notifyChange();
+}
+
+void CTerrainMesh::updateZ(
+	size_t row0, size_t col0, const mrpt::math::CMatrixDynamic<float>& block)
+{
+	ASSERT_LE_(row0 + block.rows(), static_cast<size_t>(m_Z.rows()));
+	ASSERT_LE_(col0 + block.cols(), static_cast<size_t>(m_Z.cols()));
+	if (block.rows() == 0 || block.cols() == 0) return;
+
+	m_Z.asEigen().block(row0, col0, block.rows(), block.cols()) =
+		block.asEigen();
+
+	// Normals also change in the neighbors of the modified vertices:
+	const size_t r0 = row0 > 0 ? row0 - 1 : 0, r1 = row0 + block.rows();
+	const size_t c0 = col0 > 0 ? col0 - 1 : 0, c1 = col0 + block.cols();
+	for (auto& ch : m_chunks)
+	{
+		if (ch.row0 <= r1 && r0 < ch.row0 + ch.rows && ch.col0 <= c1 &&
+			c0 < ch.col0 + ch.cols)
+			ch.dirty = true;
+	}
+	CRenderizable::notifyChange();
+}
+
+void CTerrainMesh::setMask(const mrpt::math::CMatrixDynamic<float>& mask)
+{
+	m_mask = mask;
+	m_layoutDirty = true;
+	CRenderizable::notifyChange();
+}
+
+void CTerrainMesh::setChunkSize(unsigned int cells)
+{
+	ASSERTMSG_(
+		cells >= 4 && cells <= 128 && (cells & (cells - 1)) == 0,
+		"Chunk size must be a power of 2 in the range [4,128]");
+	m_chunkSize = cells;
+	m_layoutDirty = true;
+	CRenderizable::notifyChange();
+}
+
+void CTerrainMesh::rebuildLayout() const
+{
+#if MRPT_HAS_OPENGL_GLUT || MRPT_HAS_EGL
+	m_chunks.clear();
+
+	const size_t R = m_Z.rows(), Cols = m_Z.cols(), C = m_chunkSize;
+	if (R < 2 || Cols < 2) return;
+
+	const bool useMask =
+		m_mask.rows() == m_Z.rows() && m_mask.cols() == m_Z.cols();
+
+	unsigned int numLevels = 1;
+	while ((1U << (numLevels - 1)) < C)
+		numLevels++;
+
+	std::vector<uint16_t> indices;
+
+	// Index patterns shared by all the complete chunks without masked
+	// vertices (vertex indices are relative to each chunk):
+	std::vector<std::pair<uint32_t, uint32_t>> fullChunkLevels;
+	for (unsigned int l = 0; l < numLevels; l++)
+	{
+		const size_t first = indices.size();
+		appendChunkIndices(
+			C, C + 1, C + 1, l, [](size_t, size_t) { return true; }, indices);
+		fullChunkLevels.emplace_back(first, indices.size() - first);
+	}
+
+	for (size_t row0 = 0; row0 + 1 < R; row0 += C)
+		for (size_t col0 = 0; col0 + 1 < Cols; col0 += C)
+		{
+			TChunk ch;
+			ch.row0 = row0;
+			ch.col0 = col0;
+			ch.rows = std::min(C, R - 1 - row0) + 1;
+			ch.cols = std::min(C, Cols - 1 - col0) + 1;
+
+			const auto vertexValid = [&](size_t r, size_t c) {
+				return !useMask || m_mask(row0 + r, col0 + c) != 0;
+			};
+
+			bool allValid = true;
+			for (size_t r = 0; r < ch.rows && allValid; r++)
+				for (size_t c = 0; c < ch.cols && allValid; c++)
+					allValid = vertexValid(r, c);
+
+			if (allValid && ch.rows == C + 1 && ch.cols == C + 1)
+				ch.levels = fullChunkLevels;
+			else
+			{
+				for (unsigned int l = 0; l < numLevels; l++)
+				{
+					const size_t first = indices.size();
+					appendChunkIndices(
+						C, ch.rows, ch.cols, l, vertexValid, indices);
+					ch.levels.emplace_back(first, indices.size() - first);
+				}
+			}
+			m_chunks.push_back(std::move(ch));
+		}
+
+	const size_t vertexBytes =
+		m_chunks.size() * verticesPerChunk() * sizeof(TerrainVertex);
+	ASSERTMSG_(
+		vertexBytes < static_cast<size_t>(INT_MAX) &&
+			indices.size() * sizeof(uint16_t) < static_cast<size_t>(INT_MAX),
+		"Height grid too large for one GPU buffer");
+
+	// The element buffer binding is part of the VAO state:
+	m_vao.createOnce();
+	m_vao.bind();
+
+	m_indexBuffer.createOnce();
+	m_indexBuffer.bind();
+	m_indexBuffer.allocate(indices.data(), sizeof(uint16_t) * indices.size());
+
+	// Allocated here, filled chunk by chunk:
+	m_vertexBuffer.setUsage(COpenGLBuffer::Usage::DynamicDraw);
+	m_vertexBuffer.createOnce();
+	m_vertexBuffer.bind();
+	m_vertexBuffer.allocate(nullptr, vertexBytes);
+#endif
+}
+
+void CTerrainMesh::updateChunkVertices(size_t chunkIdx) const
+{
+#if MRPT_HAS_OPENGL_GLUT || MRPT_HAS_EGL
+	TChunk& ch = m_chunks.at(chunkIdx);
+	const size_t R = m_Z.rows(), Cols = m_Z.cols(), C = m_chunkSize;
+	const bool useMask =
+		m_mask.rows() == m_Z.rows() && m_mask.cols() == m_Z.cols();
+
+	const float cellX = (m_xMax - m_xMin) / (R - 1);
+	const float cellY = (m_yMax - m_yMin) / (Cols - 1);
+	const float zRange = m_builtZMax - m_builtZMin;
+
+	std::vector<TerrainVertex> verts(verticesPerChunk());
+
+	ch.zMin = std::numeric_limits<float>::max();
+	ch.zMax = -std::numeric_limits<float>::max();
+
+	for (size_t lr = 0; lr < ch.rows; lr++)
+	{
+		const size_t i = ch.row0 + lr;
+		const size_t iPrev = i > 0 ? i - 1 : i, iNext = i + 1 < R ? i + 1 : i;
+		for (size_t lc = 0; lc < ch.cols; lc++)
+		{
+			const size_t j = ch.col0 + lc;
+			const size_t jPrev = j > 0 ? j - 1 : j,
+						 jNext = j + 1 < Cols ? j + 1 : j;
+
+			const float z = m_Z(i, j);
+			if (!useMask || m_mask(i, j) != 0)
+			{
+				mrpt::keep_min(ch.zMin, z);
+				mrpt::keep_max(ch.zMax, z);
+			}
+
+			auto& v = verts[lr * (C + 1) + lc];
+			v.pt = {m_xMin + i * cellX, m_yMin + j * cellY, z};
+
+			// Normal from central differences:
+			const float dzdx =
+				(m_Z(iNext, j) - m_Z(iPrev, j)) / ((iNext - iPrev) * cellX);
+			const float dzdy =
+				(m_Z(i, jNext) - m_Z(i, jPrev)) / ((jNext - jPrev) * cellY);
+			v.normal = mrpt::math::TVector3Df(-dzdx, -dzdy, 1.0f).unitarize();
+
+			mrpt::img::TColor col = m_builtColor;
+			if (m_colorFromZ)
+			{
+				const float t = zRange > 0 ? (z - m_builtZMin) / zRange : 0;
+				col = mrpt::img::colormap(m_colorMap, t);
+				col.A = m_builtColor.A;
+			}
+			v.r = col.R;
+			v.g = col.G;
+			v.b = col.B;
+			v.a = col.A;
+		}
+	}
+	if (ch.zMin > ch.zMax) ch.zMin = ch.zMax = 0;  // all masked
+
+	// Skirts, deep enough to cover the gaps with any neighbor LOD:
+	const float skirtDepth =
+		(ch.zMax - ch.zMin) + 0.01f * std::max(cellX, cellY) * C;
+	const size_t skirtBase = (C + 1) * (C + 1);
+	const auto setSkirt = [&](size_t e, size_t t, size_t lr, size_t lc) {
+		auto& v = verts[skirtBase + e * (C + 1) + t];
+		v = verts[lr * (C + 1) + lc];
+		v.pt.z -= skirtDepth;
+	};
+	for (size_t lc = 0; lc < ch.cols; lc++)
+	{
+		setSkirt(0, lc, 0, lc);
+		setSkirt(1, lc, ch.rows - 1, lc);
+	}
+	for (size_t lr = 0; lr < ch.rows; lr++)
+	{
+		setSkirt(2, lr, lr, 0);
+		setSkirt(3, lr, lr, ch.cols - 1);
+	}
+	ch.zMin -= skirtDepth;
+
+	m_vertexBuffer.write(
+		chunkIdx * verts.size() * sizeof(TerrainVertex), verts.data(),
+		verts.size() * sizeof(TerrainVertex));
+	ch.dirty = false;
+#endif
+}
+
+void CTerrainMesh::renderUpdateBuffers() const
+{
+#if MRPT_HAS_OPENGL_GLUT || MRPT_HAS_EGL
+	if (m_layoutDirty)
+	{
+		rebuildLayout();
+		m_layoutDirty = false;
+	}
+	if (m_chunks.empty()) return;
+
+	// Colors depend on the height range of the whole grid:
+	float zMin = 0, zMax = 0;
+	if (m_colorFromZ)
+	{
+		zMin = m_Z.asEigen().minCoeff();
+		zMax = m_Z.asEigen().maxCoeff();
+	}
+	if (zMin != m_builtZMin || zMax != m_builtZMax ||
+		!(m_color == m_builtColor))
+	{
+		m_builtZMin = zMin;
+		m_builtZMax = zMax;
+		m_builtColor = m_color;
+		for (auto& ch : m_chunks)
+			ch.dirty = true;
+	}
+
+	m_vertexBuffer.bind();
+	for (size_t k = 0; k < m_chunks.size(); k++)
+		if (m_chunks[k].dirty) updateChunkVertices(k);
+#endif
+}
+
+void CTerrainMesh::freeOpenGLResources()
+{
+	m_vertexBuffer.destroy();
+	m_indexBuffer.destroy();
+	m_vao.destroy();
+	m_layoutDirty = true;
+}
+
+void CTerrainMesh::render(const RenderContext& rc) const
+{
+#if MRPT_HAS_OPENGL_GLUT || MRPT_HAS_EGL
+	m_lastTriangleCount = 0;
+	if (m_chunks.empty()) return;
+
+	const Program& s = *rc.shader;
+
+	// Enable/disable lights:
+	if (s.hasUniform("enableLight"))
+	{
+		glUniform1i(s.uniformId("enableLight"), m_enableLight ? 1 : 0);
+		CHECK_OPENGL_ERROR();
+	}
+	if (m_enableLight && rc.lights && s.hasUniform("light_diffuse") &&
+		s.hasUniform("light_ambient") && s.hasUniform("light_direction"))
+	{
+		const auto& l = *rc.lights;
+		glUniform4f(
+			s.uniformId("light_diffuse"), l.diffuse.R, l.diffuse.G, l.diffuse.B,
+			l.diffuse.A);
+		glUniform4f(
+			s.uniformId("light_ambient"), l.ambient.R, l.ambient.G, l.ambient.B,
+			l.ambient.A);
+		glUniform3f(
+			s.uniformId("light_direction"), l.direction.x, l.direction.y,
+			l.direction.z);
+		CHECK_OPENGL_ERROR();
+	}
+
+	// Camera position in this object frame:
+	const Eigen::Matrix4f mvInv = rc.state->mv_matrix.asEigen().inverse();
+	const Eigen::Vector3f eye = mvInv.col(3).head<3>() / mvInv(3, 3);
+	const auto& pmv = rc.state->pmv_matrix.asEigen();
+
+	const float cellX = (m_xMax - m_xMin) / (m_Z.rows() - 1);
+	const float cellY = (m_yMax - m_yMin) / (m_Z.cols() - 1);
+	const float lodDist = m_lodDistance > 0
+		? m_lodDistance
+		: 2 * m_chunkSize * std::max(cellX, cellY);
+
+	m_vao.bind();
+	m_indexBuffer.bind();
+	m_vertexBuffer.bind();
+
+	std::optional<GLuint> attr_position, attr_color, attr_normals;
+	if (s.hasAttribute("position")) attr_position = s.attributeId("position");
+	if (s.hasAttribute("vertexColor"))
+		attr_color = s.attributeId("vertexColor");
+	if (s.hasAttribute("vertexNormal"))
+		attr_normals = s.attributeId("vertexNormal");
+	for (const auto& attr : {attr_position, attr_color, attr_normals})
+		if (attr) glEnableVertexAttribArray(*attr);
+	CHECK_OPENGL_ERROR();
+
+	glDisable(GL_CULL_FACE);
+
+	const size_t chunkBytes = verticesPerChunk() * sizeof(TerrainVertex);
+	for (size_t k = 0; k < m_chunks.size(); k++)
+	{
+		const TChunk& ch = m_chunks[k];
+
+		const float x0 = m_xMin + ch.row0 * cellX,
+					x1 = m_xMin + (ch.row0 + ch.rows - 1) * cellX;
+		const float y0 = m_yMin + ch.col0 * cellY,
+					y1 = m_yMin + (ch.col0 + ch.cols - 1) * cellY;
+
+		// Frustum culling: skip if all bounding box corners are out of the
+		// same clip plane.
+		unsigned int outside = 0x3f;
+		for (int c = 0; c < 8 && outside; c++)
+		{
+			const Eigen::Vector4f p = pmv *
+				Eigen::Vector4f(
+					(c & 1) ? x1 : x0, (c & 2) ? y1 : y0,
+					(c & 4) ? ch.zMax : ch.zMin, 1.0f);
+			unsigned int code = 0;
+			if (p.x() < -p.w()) code |= 0x01;
+			if (p.x() > p.w()) code |= 0x02;
+			if (p.y() < -p.w()) code |= 0x04;
+			if (p.y() > p.w()) code |= 0x08;
+			if (p.z() < -p.w()) code |= 0x10;
+			if (p.z() > p.w()) code |= 0x20;
+			outside &= code;
+		}
+		if (outside) continue;
+
+		// LOD from the distance between the camera and the bounding box:
+		const float dx = std::max({x0 - eye.x(), 0.0f, eye.x() - x1});
+		const float dy = std::max({y0 - eye.y(), 0.0f, eye.y() - y1});
+		const float dz = std::max({ch.zMin - eye.z(), 0.0f, eye.z() - ch.zMax});
+		const float dist = std::sqrt(dx * dx + dy * dy + dz * dz);
+
+		size_t level = 0;
+		if (dist >= lodDist)
+			level = std::min<size_t>(
+				ch.levels.size() - 1,
+				1 + static_cast<size_t>(std::log2(dist / lodDist)));
+
+		const auto [first, count] = ch.levels[level];
+		if (!count) continue;
+
+		// Vertex indices are relative to the chunk first vertex:
+		const size_t base = k * chunkBytes;
+		if (attr_position)
+			glVertexAttribPointer(
+				*attr_position, 3, GL_FLOAT, GL_FALSE, sizeof(TerrainVertex),
+				BUFFER_OFFSET(base + offsetof(TerrainVertex, pt)));
+		if (attr_color)
+			glVertexAttribPointer(
+				*attr_color, 4, GL_UNSIGNED_BYTE, GL_TRUE,
+				sizeof(TerrainVertex),
+				BUFFER_OFFSET(base + offsetof(TerrainVertex, r)));
+		if (attr_normals)
+			glVertexAttribPointer(
+				*attr_normals, 3, GL_FLOAT, GL_FALSE, sizeof(TerrainVertex),
+				BUFFER_OFFSET(base + offsetof(TerrainVertex, normal)));
+
+		glDrawElements(
+			GL_TRIANGLES, count, GL_UNSIGNED_SHORT,
+			BUFFER_OFFSET(first * sizeof(uint16_t)));
+
+		m_lastTriangleCount += count / 3;
+	}
+	CHECK_OPENGL_ERROR();
+
+	for (const auto& attr : {attr_position, attr_color, attr_normals})
+		if (attr) glDisableVertexAttribArray(*attr);
+	CHECK_OPENGL_ERROR();
+#endif
+}
+
+auto CTerrainMesh::getBoundingBox() const -> mrpt::math::TBoundingBox
+{
+	float zMin = 0, zMax = 0;
+	if (m_Z.rows() > 0 && m_Z.cols() > 0)
+	{
+		zMin = m_Z.asEigen().minCoeff();
+		zMax = m_Z.asEigen().maxCoeff();
+	}
+	return mrpt::math::TBoundingBox(
+			   {m_xMin, m_yMin, zMin}, {m_xMax, m_yMax, zMax})
+		.compose(m_pose);
+}
+
+uint8_t CTerrainMesh::serializeGetVersion() const { return 0; }
+void CTerrainMesh::serializeTo(mrpt::serialization::CArchive& out) const
+{
+	writeToStreamRender(out);
+
+	out << m_xMin << m_xMax << m_yMin << m_yMax;
+	out << m_Z << m_mask;
+	out << m_colorFromZ << int16_t(m_colorMap);
+	out.WriteAs<uint32_t>(m_chunkSize);
+	out << m_lodDistance << m_enableLight;
+}
+
+void CTerrainMesh::serializeFrom(
+	mrpt::serialization::CArchive& in, uint8_t version)
+{
+	switch (version)
+	{
+		case 0:
+		{
+			readFromStreamRender(in);
+
+			in >> m_xMin >> m_xMax >> m_yMin >> m_yMax;
+			in >> m_Z >> m_mask;
+			int16_t colorMap;
+			in >> m_colorFromZ >> colorMap;
+			m_colorMap = mrpt::img::TColormap(colorMap);
+			m_chunkSize = in.ReadAs<uint32_t>();
+			in >> m_lodDistance >> m_enableLight;
+		}
+		break;
+		default: MRPT_THROW_UNKNOWN_SERIALIZATION_VERSION(version);
+	};
+	m_layoutDirty = true;
+	CRenderizable::notifyChange();
+}
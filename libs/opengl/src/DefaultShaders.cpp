@@ -84,6 +84,55 @@ Program::Ptr mrpt::opengl::LoadDefaultShader(const shader_id_t id)
 			attribs = {"position", "vertexUV", "vertexNormal"};
 			break;
 			// ==============================
+		case DefaultShaderID::WIREFRAME_INSTANCED:
+			vertex_shader =
+#include "../shaders/wireframe-instanced.v.glsl"
+				;
+			fragment_shader =
+#include "../shaders/wireframe.f.glsl"
+				;
+			uniforms = {"p_matrix", "mv_matrix"};
+			attribs = {
+				"position", "vertexColor", "instancePose", "instanceColor"};
+			break;
+			// ==============================
+		case DefaultShaderID::TRIANGLES_INSTANCED:
+			vertex_shader =
+#include "../shaders/triangles-instanced.v.glsl"
+				;
+			fragment_shader =
+#include "../shaders/triangles.f.glsl"
+				;
+			uniforms = {"p_matrix",		 "mv_matrix",		"light_diffuse",
+						"light_ambient", "light_direction", "enableLight"};
+			attribs = {
+				"position", "vertexColor", "vertexNormal", "instancePose",
+				"instanceColor"};
+			break;
+			// ==============================
+		case DefaultShaderID::POINTS_SPLAT:
+			vertex_shader =
+#include "../shaders/points-splat.v.glsl"
+				;
+			fragment_shader =
+#include "../shaders/points-splat.f.glsl"
+				;
+			uniforms = {"p_matrix",		"mv_matrix",	"splatRadius",
+						"splatScale",	"splatMaxSize", "viewportHeight"};
+			attribs = {"position", "vertexColor"};
+			break;
+			// ==============================
+		case DefaultShaderID::EYE_DOME_LIGHTING:
+			vertex_shader =
+#include "../shaders/edl.v.glsl"
+				;
+			fragment_shader =
+#include "../shaders/edl.f.glsl"
+				;
+			uniforms = {"depthTexture", "pixelSize", "edlStrength", "edlRadius",
+						"zNear",		"zFar",		 "isProjective"};
+			break;
+			// ==============================
 		case DefaultShaderID::TEXT:
 			vertex_shader =
 #include "../shaders/text.v.glsl"
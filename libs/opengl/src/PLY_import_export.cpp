@@ -52,7 +52,9 @@ WARRANTY OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE.
 #include <mrpt/opengl/PLY_import_export.h>
 #include <mrpt/system/string_utils.h>
 
+#include <algorithm>
 #include <cstdio>
+#include <cstring>
 
 using namespace std;
 using namespace mrpt;
@@ -248,7 +250,7 @@ PlyFile* ply_open_for_writing(
 
 	/* open the file for writing */
 
-	fp = fopen(name, "w");
+	fp = fopen(name, "wb");
 	if (fp == nullptr) { return (nullptr); }
 
 	/* create the actual PlyFile structure */
@@ -698,7 +700,7 @@ PlyFile* ply_open_for_reading(
 
 	/* open the file for reading */
 
-	fp = fopen(filename, "r");
+	fp = fopen(filename, "rb");
 	if (fp == nullptr) return (nullptr);
 
 	/* create the PlyFile data structure */
@@ -1481,84 +1483,69 @@ int get_binary_item(
 	FILE* fp, int bin_file_type, int type, int* int_val, unsigned int* uint_val,
 	double* double_val)
 {
+	if (type <= PLY_START_TYPE || type >= PLY_END_TYPE)
+		throw std::runtime_error(
+			format("get_binary_item: bad type = %d", type));
+
 	char c[8];
-	void* ptr;
+	void* ptr = (void*)c;
 
-	ptr = (void*)c;
+	const int item_size = ply_type_size[type];
+	if (fread(ptr, item_size, 1, fp) != 1) return 0;
+
+// Added by JL:
+// If the Big/Little endian format in the file is different than the native
+// format, do the conversion (of the raw bytes, before interpreting them):
+#if MRPT_IS_BIG_ENDIAN
+	const bool do_reverse = (bin_file_type == PLY_BINARY_LE);
+#else
+	const bool do_reverse = (bin_file_type == PLY_BINARY_BE);
+#endif
+	if (do_reverse) std::reverse(c, c + item_size);
 
 	switch (type)
 	{
 		case PLY_CHAR:
-			if (fread(ptr, 1, 1, fp) != 1) return 0;
 			*int_val = *((char*)ptr);
 			*uint_val = *int_val;
 			*double_val = *int_val;
 			break;
 		case PLY_UCHAR:
-			if (fread(ptr, 1, 1, fp) != 1) return 0;
 			*uint_val = *((unsigned char*)ptr);
 			*int_val = *uint_val;
 			*double_val = *uint_val;
 			break;
 		case PLY_SHORT:
-			if (fread(ptr, 2, 1, fp) != 1) return 0;
 			*int_val = *((short int*)ptr);
 			*uint_val = *int_val;
 			*double_val = *int_val;
 			break;
 		case PLY_USHORT:
-			if (fread(ptr, 2, 1, fp) != 1) return 0;
 			*uint_val = *((unsigned short int*)ptr);
 			*int_val = *uint_val;
 			*double_val = *uint_val;
 			break;
 		case PLY_INT:
-			if (fread(ptr, 4, 1, fp) != 1) return 0;
 			*int_val = *((int*)ptr);
 			*uint_val = *int_val;
 			*double_val = *int_val;
 			break;
 		case PLY_UINT:
-			if (fread(ptr, 4, 1, fp) != 1) return 0;
 			*uint_val = *((unsigned int*)ptr);
 			*int_val = *uint_val;
 			*double_val = *uint_val;
 			break;
 		case PLY_FLOAT:
-			if (fread(ptr, 4, 1, fp) != 1) return 0;
 			*double_val = *((float*)ptr);
 			*int_val = static_cast<int>(*double_val);
 			*uint_val = static_cast<unsigned int>(*double_val);
 			break;
 		case PLY_DOUBLE:
-			if (fread(ptr, 8, 1, fp) != 1) return 0;
 			*double_val = *((double*)ptr);
 			*int_val = static_cast<int>(*double_val);
 			*uint_val = static_cast<unsigned int>(*double_val);
 			break;
-		default:
-			throw std::runtime_error(
-				format("get_binary_item: bad type = %d", type));
-	}
-
-// Added by JL:
-// If the Big/Little endian format in the file is different than the native
-// format, do the conversion:
-#if MRPT_IS_BIG_ENDIAN
-	const bool do_reverse = (bin_file_type == PLY_BINARY_LE);
-#else
-	const bool do_reverse = (bin_file_type == PLY_BINARY_BE);
-#endif
-
-	if (do_reverse)
-	{
-		int int_val2 = *int_val;
-		unsigned int uint_val2 = *uint_val;
-		double double_val2 = *double_val;
-		mrpt::reverseBytes(int_val2, *int_val);
-		mrpt::reverseBytes(uint_val2, *uint_val);
-		mrpt::reverseBytes(double_val2, *double_val);
-	}
+	};
 
 	return 1;
 }
@@ -1814,6 +1801,122 @@ const PlyProperty face_props[] =
 	 {"vertex_indices", PLY_INT, PLY_INT, offsetof(TFace, verts), 1, PLY_UCHAR,
 	  PLY_UCHAR, offsetof(TFace, nverts)}};
 
+/* Converts the values of one scalar property of all the instances of an
+ * element, stored with a stride of `stride` bytes, into floats. */
+template <typename T>
+void binary_column_to_float(
+	const char* src, size_t stride, size_t count, bool reverse, float* dst)
+{
+	for (size_t i = 0; i < count; i++, src += stride)
+	{
+		T v;
+		std::memcpy(&v, src, sizeof(T));
+		if (reverse) mrpt::reverseBytesInPlace(v);
+		dst[i] = static_cast<float>(v);
+	}
+}
+
+/******************************************************************************
+Read all the instances of an element with a single fread(), and return the
+requested properties as arrays of floats. Much faster than one call to
+ply_get_element() per instance for large binary files (e.g. point clouds).
+
+Entry:
+  plyfile    - file identifier, positioned at the beginning of the element data
+  elem_name  - name of the element
+  prop_names - names of the properties to return
+
+Exit:
+  columns - one array per requested property with the values of all the
+			instances, or an empty one if the element has no such property
+  returns false, without reading anything, if the file is not binary or the
+  element has list properties (i.e. a variable size)
+******************************************************************************/
+
+bool binary_get_element_columns(
+	PlyFile* plyfile, const string& elem_name, const vector<string>& prop_names,
+	vector<vector<float>>& columns)
+{
+	if (plyfile->file_type == PLY_ASCII) return false;
+
+	PlyElement* elem = find_element(plyfile, elem_name);
+	if (elem == nullptr) return false;
+
+	/* byte offset of each property within an instance of the element */
+	vector<size_t> offsets;
+	size_t stride = 0;
+	for (const auto& prop : elem->props)
+	{
+		if (prop.is_list || prop.external_type <= PLY_START_TYPE ||
+			prop.external_type >= PLY_END_TYPE)
+			return false;
+		offsets.push_back(stride);
+		stride += ply_type_size[prop.external_type];
+	}
+
+	const size_t num = elem->num;
+	vector<char> buf(num * stride);
+	if (!buf.empty() && fread(buf.data(), stride, num, plyfile->fp) != num)
+		throw std::runtime_error(
+			"binary_get_element_columns: Error reading binary file!");
+
+#if MRPT_IS_BIG_ENDIAN
+	const bool do_reverse = (plyfile->file_type == PLY_BINARY_LE);
+#else
+	const bool do_reverse = (plyfile->file_type == PLY_BINARY_BE);
+#endif
+
+	columns.assign(prop_names.size(), vector<float>());
+	for (size_t k = 0; k < prop_names.size(); k++)
+	{
+		int index;
+		const PlyProperty* prop = find_property(elem, prop_names[k], &index);
+		if (prop == nullptr) continue;
+
+		vector<float>& col = columns[k];
+		col.resize(num);
+		const char* src = buf.data() + offsets[index];
+		float* dst = col.data();
+
+		switch (prop->external_type)
+		{
+			case PLY_CHAR:
+				binary_column_to_float<int8_t>(
+					src, stride, num, do_reverse, dst);
+				break;
+			case PLY_SHORT:
+				binary_column_to_float<int16_t>(
+					src, stride, num, do_reverse, dst);
+				break;
+			case PLY_INT:
+				binary_column_to_float<int32_t>(
+					src, stride, num, do_reverse, dst);
+				break;
+			case PLY_UCHAR:
+				binary_column_to_float<uint8_t>(
+					src, stride, num, do_reverse, dst);
+				break;
+			case PLY_USHORT:
+				binary_column_to_float<uint16_t>(
+					src, stride, num, do_reverse, dst);
+				break;
+			case PLY_UINT:
+				binary_column_to_float<uint32_t>(
+					src, stride, num, do_reverse, dst);
+				break;
+			case PLY_FLOAT:
+				binary_column_to_float<float>(
+					src, stride, num, do_reverse, dst);
+				break;
+			case PLY_DOUBLE:
+				binary_column_to_float<double>(
+					src, stride, num, do_reverse, dst);
+				break;
+		};
+	}
+	return true;
+}
+
 /*
 		Loads from a PLY file.
 */
@@ -1829,6 +1932,9 @@ bool PLY_Importer::loadFromPlyFile(
 		float version;
 		PlyFile* ply =
 			ply_open_for_reading(filename.c_str(), elist, &file_type, &version);
+		if (!ply)
+			throw std::runtime_error(format(
+				"Cannot open or parse the header of '%s'", filename.c_str()));
 
 		/* go through each kind of element that we learned is in the file */
 		/* and read them */
@@ -1845,7 +1951,36 @@ bool PLY_Importer::loadFromPlyFile(
 			// printf ("element %s %d\n", elem_name, num_elems);
 
 			/* if we're on vertex elements, read them in */
-			if ("vertex" == elem_name)
+			vector<vector<float>> cols;
+			if ("vertex" == elem_name &&
+				binary_get_element_columns(
+					ply, elem_name, {"x", "y", "z", "intensity"}, cols))
+			{
+				/* all the vertices at once, in binary files */
+				for (auto& col : cols)
+					if (col.empty()) col.assign(num_elems, VAL_NOT_SET);
+				const vector<float>& xs = cols[0];
+				const vector<float>& ys = cols[1];
+				const vector<float>& zs = cols[2];
+				const vector<float>& intensity = cols[3];
+
+				this->PLY_import_set_vertex_count(num_elems);
+				for (int j = 0; j < num_elems; j++)
+				{
+					const TPoint3Df xyz(xs[j], ys[j], zs[j]);
+					if (intensity[j] != VAL_NOT_SET)
+					{  // Grayscale
+						const TColorf col(
+							intensity[j], intensity[j], intensity[j]);
+						this->PLY_import_set_vertex(j, xyz, &col);
+					}
+					else
+					{  // No color
+						this->PLY_import_set_vertex(j, xyz);
+					}
+				}
+			}
+			else if ("vertex" == elem_name)
 			{
 				/* set up for getting vertex elements */
 				for (const auto& vert_prop : vert_props)
@@ -1990,26 +2125,56 @@ bool PLY_Exporter::saveToPlyFile(
 
 		/* set up and write the vertex elements */
 		ply_put_element_setup(ply, "vertex");
-		for (size_t i = 0; i < nverts; i++)
+		if (save_in_binary && nverts)
 		{
+			/* all at once, since the file is in the native byte order */
 			TPoint3Df pt;
 			bool pt_has_color;
 			TColorf pt_color;
-			this->PLY_export_get_vertex(i, pt, pt_has_color, pt_color);
-
-			TVertex ver;
-			ver.x = pt.x;
-			ver.y = pt.y;
-			ver.z = pt.z;
-
-			if (pt_has_color)
-				ver.intensity =
-					(1.0f / 3.0f) * (pt_color.R + pt_color.G + pt_color.B);
-			else
-				ver.intensity = 0.5;
+			this->PLY_export_get_vertex(0, pt, pt_has_color, pt_color);
+			const size_t nFields = pt_has_color ? 4 : 3;
 
-			ply_put_element(ply, (void*)&ver);
+			vector<float> buf(nverts * nFields);
+			for (size_t i = 0; i < nverts; i++)
+			{
+				this->PLY_export_get_vertex(i, pt, pt_has_color, pt_color);
+				float* v = &buf[i * nFields];
+				v[0] = pt.x;
+				v[1] = pt.y;
+				v[2] = pt.z;
+				if (nFields < 4) continue;
+				if (pt_has_color)
+					v[3] =
+						(1.0f / 3.0f) * (pt_color.R + pt_color.G + pt_color.B);
+				else
+					v[3] = 0.5f;
+			}
+			if (fwrite(buf.data(), sizeof(float), buf.size(), ply->fp) !=
+				buf.size())
+				throw std::runtime_error(format(
+					"Error writing vertices to '%s'", filename.c_str()));
 		}
+		else
+			for (size_t i = 0; i < nverts; i++)
+			{
+				TPoint3Df pt;
+				bool pt_has_color;
+				TColorf pt_color;
+				this->PLY_export_get_vertex(i, pt, pt_has_color, pt_color);
+
+				TVertex ver;
+				ver.x = pt.x;
+				ver.y = pt.y;
+				ver.z = pt.z;
+
+				if (pt_has_color)
+					ver.intensity =
+						(1.0f / 3.0f) * (pt_color.R + pt_color.G + pt_color.B);
+				else
+					ver.intensity = 0.5;
+
+				ply_put_element(ply, (void*)&ver);
+			}
 
 		/* set up and write the face elements */
 		/*		ply_put_element_setup (ply, "face");
@@ -0,0 +1,122 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/core/reverse_bytes.h>
+#include <mrpt/opengl/CPointCloud.h>
+#include <mrpt/opengl/CPointCloudColoured.h>
+#include <mrpt/system/filesystem.h>
+
+#include <cstdio>
+
+using namespace mrpt::opengl;
+
+TEST(PLY_import_export, saveLoadAsciiAndBinary)
+{
+	for (const bool binary : {false, true})
+	{
+		CPointCloudColoured pc;
+		const size_t N = 500;
+		for (size_t i = 0; i < N; i++)
+		{
+			const float gray = (i % 2) ? 1.0f / 3 : 0.2f;
+			pc.push_back(i * 0.1f, -1.0f * i, 2.0f + i, gray, gray, gray);
+		}
+
+		const auto fil = mrpt::system::getTempFileName() + ".ply";
+		ASSERT_TRUE(pc.saveToPlyFile(fil, binary, {"a comment"}))
+			<< pc.getSavePLYErrorString();
+
+		// The saved cloud is not modified:
+		EXPECT_EQ(pc.size(), N);
+		EXPECT_FLOAT_EQ(pc.getPoint3Df(10).x, 1.0f);
+
+		CPointCloudColoured pc2;
+		std::vector<std::string> comments;
+		ASSERT_TRUE(pc2.loadFromPlyFile(fil, &comments))
+			<< pc2.getLoadPLYErrorString();
+		ASSERT_EQ(pc2.size(), N);
+		ASSERT_EQ(comments.size(), 1U);
+
+		for (size_t i = 0; i < N; i++)
+		{
+			const auto p1 = pc.getPoint3Df(i), p2 = pc2.getPoint3Df(i);
+			EXPECT_FLOAT_EQ(p1.x, p2.x);
+			EXPECT_FLOAT_EQ(p1.y, p2.y);
+			EXPECT_FLOAT_EQ(p1.z, p2.z);
+			// Colors are saved as intensities:
+			const uint8_t expected = (i % 2) ? 0x55 : 0x33;
+			EXPECT_NEAR(pc2.getPointColor(i).R, expected, 1);
+		}
+
+		// Without colors:
+		CPointCloud pc3;
+		pc3.insertPoint(1.0f, 2.0f, 3.0f);
+		pc3.insertPoint(4.0f, 5.0f, 6.0f);
+		ASSERT_TRUE(pc3.saveToPlyFile(fil, binary));
+		CPointCloud pc4;
+		ASSERT_TRUE(pc4.loadFromPlyFile(fil));
+		ASSERT_EQ(pc4.size(), 2U);
+		EXPECT_FLOAT_EQ(pc4.getPoint3Df(1).z, 6.0f);
+
+		mrpt::system::deleteFile(fil);
+	}
+}
+
+namespace
+{
+template <typename T>
+void writeBigEndian(FILE* f, T v)
+{
+#if !MRPT_IS_BIG_ENDIAN
+	mrpt::reverseBytesInPlace(v);
+#endif
+	fwrite(&v, sizeof(v), 1, f);
+}
+}  // namespace
+
+// Files with other property types and byte order than the ones we save:
+TEST(PLY_import_export, loadBinaryBigEndian)
+{
+	const auto fil = mrpt::system::getTempFileName() + ".ply";
+	{
+		FILE* f = fopen(fil.c_str(), "wb");
+		ASSERT_TRUE(f != nullptr);
+		fprintf(
+			f,
+			"ply\nformat binary_big_endian 1.0\nelement vertex 3\n"
+			"property double x\nproperty double y\nproperty short z\n"
+			"property uchar intensity\nproperty float other\n"
+			"element face 0\nproperty list uchar int vertex_indices\n"
+			"end_header\n");
+		for (int i = 0; i < 3; i++)
+		{
+			writeBigEndian(f, 1.5 * i);
+			writeBigEndian(f, -2.0 * i);
+			writeBigEndian(f, static_cast<int16_t>(1000 + i));
+			writeBigEndian(f, static_cast<uint8_t>(1));
+			writeBigEndian(f, 1.0f);
+		}
+		fclose(f);
+	}
+
+	CPointCloudColoured pc;
+	ASSERT_TRUE(pc.loadFromPlyFile(fil)) << pc.getLoadPLYErrorString();
+	ASSERT_EQ(pc.size(), 3U);
+	for (size_t i = 0; i < 3; i++)
+	{
+		const auto p = pc.getPoint3Df(i);
+		EXPECT_FLOAT_EQ(p.x, 1.5f * i);
+		EXPECT_FLOAT_EQ(p.y, -2.0f * i);
+		EXPECT_FLOAT_EQ(p.z, 1000.0f + i);
+		EXPECT_EQ(pc.getPointColor(i).R, 0xff);
+	}
+
+	mrpt::system::deleteFile(fil);
+}
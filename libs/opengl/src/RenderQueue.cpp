@@ -11,13 +11,16 @@
 //
 #include <Eigen/Dense>	// First! to avoid conflicts with X.h
 //
+#include <mrpt/core/WorkerThreadsPool.h>
 #include <mrpt/opengl/CSetOfObjects.h>
 #include <mrpt/opengl/CText.h>
 #include <mrpt/opengl/RenderQueue.h>
 #include <mrpt/opengl/opengl_api.h>
 #include <mrpt/system/os.h>
 
+#include <algorithm>
 #include <map>
+#include <vector>
 
 using namespace std;
 using namespace mrpt;
@@ -26,93 +29,200 @@ using namespace mrpt::poses;
 using namespace mrpt::system;
 using namespace mrpt::opengl;
 
-// Render a set of objects
-void mrpt::opengl::enqueForRendering(
-	const mrpt::opengl::CListOpenGLObjects& objs,
-	const mrpt::opengl::TRenderMatrices& state, RenderQueue& rq)
-{
 #if MRPT_HAS_OPENGL_GLUT || MRPT_HAS_EGL
-	using mrpt::math::CMatrixDouble44;
+namespace
+{
+// Minimum number of objects in a list to split it among threads:
+constexpr size_t MIN_OBJECTS_PER_THREAD = 256;
 
-	const char* curClassName = nullptr;
-	try
+// A part of a list of objects, enqueued by one thread. OpenGL calls are only
+// allowed in the thread rendering, so updating buffers and labels is deferred.
+struct RenderQueueChunk
+{
+	RenderQueue rq;
+	/** Objects that must update their buffers, with their parent state */
+	std::vector<std::pair<const CRenderizable*, TRenderMatrices>> deferred;
+	struct Label
 	{
-		for (const auto& objPtr : objs)
+		const CRenderizable* obj;
+		TRenderMatrices state;
+		float depth;
+	};
+	std::vector<Label> labels;
+};
+
+// The pool for the current (outermost) enqueForRendering() call, and the
+// chunk being processed by the current thread, if any:
+thread_local mrpt::WorkerThreadsPool* tl_pool = nullptr;
+thread_local RenderQueueChunk* tl_chunk = nullptr;
+
+void enqueLabel(
+	const CRenderizable* obj, const TRenderMatrices& state, float depth,
+	RenderQueue& rq)
+{
+	CText& label = obj->labelObject();
+
+	// Update the label, only if it changed:
+	if (label.getString() != obj->getName()) label.setString(obj->getName());
+
+	// Regenerate opengl vertex buffers, if first time or label
+	// changed:
+	if (label.hasToUpdateBuffers()) label.updateBuffers();
+
+	rq[DefaultShaderID::TEXT].emplace(depth, RenderQueueElement(&label, state));
+}
+
+void enqueObject(
+	const CRenderizable* obj, const TRenderMatrices& state, RenderQueue& rq,
+	RenderQueueChunk* chunk)
+{
+	// Regenerate opengl vertex buffers?
+	if (obj->hasToUpdateBuffers())
+	{
+		if (chunk)
 		{
-			if (!objPtr) continue;
-			// Use plain pointers, faster than smart pointers:
-			const CRenderizable* obj = objPtr.get();
-			// Save class name: just in case we have an exception, for error
-			// reporting:
-			curClassName = obj->GetRuntimeClass()->className;
+			chunk->deferred.emplace_back(obj, state);
+			return;
+		}
+		obj->updateBuffers();
+	}
 
-			// Regenerate opengl vertex buffers?
-			if (obj->hasToUpdateBuffers()) obj->updateBuffers();
+	if (!obj->isVisible()) return;
 
-			if (!obj->isVisible()) continue;
+	// Pose and scaling:
+	const CMatrixFloat44& HM = obj->getLocalTransform();
 
-			const CPose3D& thisPose = obj->getPoseRef();
-			CMatrixFloat44 HM =
-				thisPose.getHomogeneousMatrixVal<CMatrixDouble44>()
-					.cast_float();
+	// Make a copy of rendering state, so we always have the original
+	// version of my parent intact.
+	auto _ = state;
 
-			// Scaling:
-			if (obj->getScaleX() != 1 || obj->getScaleY() != 1 ||
-				obj->getScaleZ() != 1)
-			{
-				auto scale = CMatrixFloat44::Identity();
-				scale(0, 0) = obj->getScaleX();
-				scale(1, 1) = obj->getScaleY();
-				scale(2, 2) = obj->getScaleZ();
-				HM.asEigen() = HM.asEigen() * scale.asEigen();
-			}
+	// Compose relative to my parent pose:
+	_.mv_matrix.asEigen() = _.mv_matrix.asEigen() * HM.asEigen();
+
+	// Precompute pmv_matrix to be used in shaders:
+	_.pmv_matrix.asEigen() = _.p_matrix.asEigen() * _.mv_matrix.asEigen();
 
-			// Make a copy of rendering state, so we always have the original
-			// version of my parent intact.
-			auto _ = state;
+	// Get a representative depth for this object (to sort objects from
+	// eye-distance):
+	mrpt::math::TPoint3Df lrp = obj->getLocalRepresentativePoint();
 
-			// Compose relative to my parent pose:
-			_.mv_matrix.asEigen() = _.mv_matrix.asEigen() * HM.asEigen();
+	Eigen::Vector4f lrp_hm(lrp.x, lrp.y, lrp.z, 1.0f);
+	const auto lrp_proj = (_.pmv_matrix.asEigen() * lrp_hm).eval();
+	const float depth = (lrp_proj(3) != 0) ? lrp_proj(2) / lrp_proj(3) : .001f;
+
+	// Enqeue this object...
+	const auto lst_shaders = obj->requiredShaders();
+	for (const auto shader_id : lst_shaders)
+	{
+		// eye-to-object depth:
+		rq[shader_id].emplace(depth, RenderQueueElement(obj, _));
+	}
 
-			// Precompute pmv_matrix to be used in shaders:
-			_.pmv_matrix.asEigen() =
-				_.p_matrix.asEigen() * _.mv_matrix.asEigen();
+	// ...and its children:
+	obj->enqueForRenderRecursive(_, rq);
 
-			// Get a representative depth for this object (to sort objects from
-			// eye-distance):
-			mrpt::math::TPoint3Df lrp = obj->getLocalRepresentativePoint();
+	if (obj->isShowNameEnabled())
+	{
+		if (chunk)
+			chunk->labels.push_back({obj, _, depth});
+		else
+			enqueLabel(obj, _, depth, rq);
+	}
+}
 
-			Eigen::Vector4f lrp_hm(lrp.x, lrp.y, lrp.z, 1.0f);
-			const auto lrp_proj = (_.pmv_matrix.asEigen() * lrp_hm).eval();
-			const float depth =
-				(lrp_proj(3) != 0) ? lrp_proj(2) / lrp_proj(3) : .001f;
+void enqueInParallel(
+	const mrpt::opengl::CListOpenGLObjects& objs,
+	const mrpt::opengl::TRenderMatrices& state, RenderQueue& rq,
+	mrpt::WorkerThreadsPool& pool)
+{
+	const size_t nObjs = objs.size();
+	const size_t nChunks =
+		std::min(nObjs / MIN_OBJECTS_PER_THREAD, pool.size() + 1);
+
+	std::vector<RenderQueueChunk> chunks(nChunks);
+	pool.parallel_for(0, nChunks, 1, [&](size_t c) {
+		RenderQueueChunk& chunk = chunks[c];
+		// Restore it on exit: this thread may be running a nested task
+		struct ChunkScope
+		{
+			RenderQueueChunk* old = tl_chunk;
+			~ChunkScope() { tl_chunk = old; }
+		} scope;
+		tl_chunk = &chunk;
 
-			// Enqeue this object...
-			const auto lst_shaders = obj->requiredShaders();
-			for (const auto shader_id : lst_shaders)
+		const char* curClassName = nullptr;
+		try
+		{
+			for (size_t i = nObjs * c / nChunks, i1 = nObjs * (c + 1) / nChunks;
+				 i < i1; i++)
 			{
-				// eye-to-object depth:
-				rq[shader_id].emplace(depth, RenderQueueElement(obj, _));
+				if (!objs[i]) continue;
+				curClassName = objs[i]->GetRuntimeClass()->className;
+				enqueObject(objs[i].get(), state, chunk.rq, &chunk);
 			}
+		}
+		catch (const exception& e)
+		{
+			THROW_EXCEPTION_FMT(
+				"Exception while rendering class '%s':\n%s",
+				curClassName ? curClassName : "(undefined)", e.what());
+		}
+	});
 
-			// ...and its children:
-			obj->enqueForRenderRecursive(_, rq);
+	// Merge the queues, and do the deferred work from this thread:
+	for (auto& chunk : chunks)
+	{
+		for (auto& shaderQueue : chunk.rq)
+			rq[shaderQueue.first].merge(shaderQueue.second);
 
-			if (obj->isShowNameEnabled())
+		for (const auto& d : chunk.deferred)
+		{
+			const CRenderizable* obj = d.first;
+			try
+			{
+				enqueObject(obj, d.second, rq, nullptr);
+			}
+			catch (const exception& e)
 			{
-				CText& label = obj->labelObject();
+				THROW_EXCEPTION_FMT(
+					"Exception while rendering class '%s':\n%s",
+					obj->GetRuntimeClass()->className, e.what());
+			}
+		}
+		for (const auto& l : chunk.labels)
+			enqueLabel(l.obj, l.state, l.depth, rq);
+	}
+}
+}  // namespace
+#endif
 
-				// Update the label, only if it changed:
-				if (label.getString() != obj->getName())
-					label.setString(obj->getName());
+// Render a set of objects
+void mrpt::opengl::enqueForRendering(
+	const mrpt::opengl::CListOpenGLObjects& objs,
+	const mrpt::opengl::TRenderMatrices& state, RenderQueue& rq)
+{
+#if MRPT_HAS_OPENGL_GLUT || MRPT_HAS_EGL
+	// Split long lists among threads, unless we are already in a thread:
+	if (tl_pool && !tl_chunk && tl_pool->size() > 0 &&
+		objs.size() >= 2 * MIN_OBJECTS_PER_THREAD)
+	{
+		enqueInParallel(objs, state, rq, *tl_pool);
+		return;
+	}
 
-				// Regenerate opengl vertex buffers, if first time or label
-				// changed:
-				if (label.hasToUpdateBuffers()) label.updateBuffers();
+	const char* curClassName = nullptr;
+	try
+	{
+		for (const auto& objPtr : objs)
+		{
+			if (!objPtr) continue;
+			// Use plain pointers, faster than smart pointers:
+			const CRenderizable* obj = objPtr.get();
+			// Save class name: just in case we have an exception, for error
+			// reporting:
+			curClassName = obj->GetRuntimeClass()->className;
 
-				rq[DefaultShaderID::TEXT].emplace(
-					depth, RenderQueueElement(&label, _));
-			}
+			enqueObject(obj, state, rq, tl_chunk);
 
 		}  // end foreach object
 	}
@@ -125,6 +235,24 @@ void mrpt::opengl::enqueForRendering(
 #endif
 }
 
+void mrpt::opengl::enqueForRendering(
+	const mrpt::opengl::CListOpenGLObjects& objs,
+	const mrpt::opengl::TRenderMatrices& state, RenderQueue& rq,
+	mrpt::WorkerThreadsPool* pool)
+{
+#if MRPT_HAS_OPENGL_GLUT || MRPT_HAS_EGL
+	// Make the pool available to nested calls (e.g. from CSetOfObjects):
+	struct PoolScope
+	{
+		mrpt::WorkerThreadsPool* old = tl_pool;
+		~PoolScope() { tl_pool = old; }
+	} scope;
+	tl_pool = pool;
+
+	enqueForRendering(objs, state, rq);
+#endif
+}
+
 void mrpt::opengl::processRenderQueue(
 	const RenderQueue& rq,
 	std::map<shader_id_t, mrpt::opengl::Program::Ptr>& shaders,
@@ -140,6 +268,13 @@ void mrpt::opengl::processRenderQueue(
 		glUseProgram(shader.programId());
 		CHECK_OPENGL_ERROR();
 
+		// Uniform locations, looked up once per shader:
+		const GLint u_pmat = shader.uniformId("p_matrix");
+		const GLint u_mvmat = shader.uniformId("mv_matrix");
+		const GLint u_pmvmat = shader.hasUniform("pmv_matrix")
+			? shader.uniformId("pmv_matrix")
+			: -1;
+
 		// Process all objects using this shader:
 		const auto& rqMap = rqSet.second;
 
@@ -151,16 +286,14 @@ void mrpt::opengl::processRenderQueue(
 			// Load matrices in shader:
 			const auto IS_TRANSPOSED = GL_TRUE;
 			glUniformMatrix4fv(
-				shader.uniformId("p_matrix"), 1, IS_TRANSPOSED,
-				rqe.renderState.p_matrix.data());
+				u_pmat, 1, IS_TRANSPOSED, rqe.renderState.p_matrix.data());
 
 			glUniformMatrix4fv(
-				shader.uniformId("mv_matrix"), 1, IS_TRANSPOSED,
-				rqe.renderState.mv_matrix.data());
+				u_mvmat, 1, IS_TRANSPOSED, rqe.renderState.mv_matrix.data());
 
-			if (shader.hasUniform("pmv_matrix"))
+			if (u_pmvmat >= 0)
 				glUniformMatrix4fv(
-					shader.uniformId("pmv_matrix"), 1, IS_TRANSPOSED,
+					u_pmvmat, 1, IS_TRANSPOSED,
 					rqe.renderState.pmv_matrix.data());
 
 			CRenderizable::RenderContext rc;
@@ -12,6 +12,7 @@
 #include <mrpt/opengl/CEllipsoid2D.h>
 #include <mrpt/opengl/CEllipsoid3D.h>
 #include <mrpt/opengl/CPointCloud.h>
+#include <mrpt/opengl/CSetOfInstances.h>
 #include <mrpt/opengl/CSetOfLines.h>
 #include <mrpt/opengl/CSetOfObjects.h>
 #include <mrpt/opengl/stock_objects.h>
@@ -272,13 +273,13 @@ CSetOfObjects::Ptr CSetOfObjects::posePDF2opengl(const CPose3DPDF& o)
 		const auto* p = dynamic_cast<const CPose3DPDFParticles*>(&o);
 		ASSERT_(p != nullptr);
 
+		// All particles are drawn with one instanced draw call:
+		auto axes = opengl::CSetOfInstances::Create(
+			opengl::stock_objects::CornerXYZSimple(POSE_AXIS_SCALE));
+		axes->reserve(p->size());
 		for (size_t i = 0; i < p->size(); i++)
-		{
-			opengl::CSetOfObjects::Ptr axes =
-				opengl::stock_objects::CornerXYZSimple(POSE_AXIS_SCALE);
-			axes->setPose(p->m_particles[i].d);
-			outObj->insert(axes);
-		}
+			axes->insert(p->m_particles[i].d);
+		outObj->insert(axes);
 	}
 
 	return outObj;
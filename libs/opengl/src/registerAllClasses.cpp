@@ -48,13 +48,16 @@ MRPT_INITIALIZER(registerAllClasses_mrpt_opengl)
 	registerClass(CLASS_ID(COpenGLViewport));
 	registerClass(CLASS_ID(CPointCloud));
 	registerClass(CLASS_ID(CPointCloudColoured));
+	registerClass(CLASS_ID(CPointCloudBlocks));
 	registerClass(CLASS_ID(CPolyhedron));
 	registerClass(CLASS_ID(CRenderizable));
 	registerClass(CLASS_ID(CSetOfLines));
 	registerClass(CLASS_ID(CSetOfObjects));
+	registerClass(CLASS_ID(CSetOfInstances));
 	registerClass(CLASS_ID(CSetOfTriangles));
 	registerClass(CLASS_ID(CSimpleLine));
 	registerClass(CLASS_ID(CSphere));
+	registerClass(CLASS_ID(CTerrainMesh));
 	registerClass(CLASS_ID(CText));
 	registerClass(CLASS_ID(CText3D));
 	registerClass(CLASS_ID(CTexturedPlane));
@@ -46,6 +46,7 @@ TEST(SerializeTestOpenGL, WriteReadToMem)
 		CLASS_ID(COpenGLViewport),
 		CLASS_ID(CPointCloud),
 		CLASS_ID(CPointCloudColoured),
+		CLASS_ID(CPointCloudBlocks),
 		CLASS_ID(CSetOfLines),
 		CLASS_ID(CSetOfTriangles),
 		CLASS_ID(CSphere),
@@ -57,7 +58,9 @@ TEST(SerializeTestOpenGL, WriteReadToMem)
 		CLASS_ID(CGridPlaneXZ),
 		CLASS_ID(COpenGLScene),
 		CLASS_ID(CSetOfObjects),
+		CLASS_ID(CSetOfInstances),
 		CLASS_ID(CSimpleLine),
+		CLASS_ID(CTerrainMesh),
 		CLASS_ID(CText),
 		CLASS_ID(CText3D),
 		CLASS_ID(CEllipsoidInverseDepth2D),
@@ -201,6 +201,30 @@ class CPose2D : public CPose<CPose2D, 3>,
 	mrpt::math::TPoint2D inverseComposePoint(
 		const mrpt::math::TPoint2D& g) const;
 
+	/** Computes \f$ G = P \oplus L \f$ for `N` 2D points, given as separate
+	 * arrays of x, y coordinates (structure of arrays). Much faster than
+	 * calling composePoint() for each point, uses AVX2 or NEON code if
+	 * available. Output arrays can be the same than the input ones.
+	 * \note (New in MRPT 2.4.9) */
+	void composePoints(
+		const float* lx, const float* ly, float* gx, float* gy,
+		std::size_t N) const;
+	/** \overload For `double` coordinates */
+	void composePoints(
+		const double* lx, const double* ly, double* gx, double* gy,
+		std::size_t N) const;
+
+	/** Computes \f$ L = G \ominus P \f$ for `N` 2D points, like
+	 * inverseComposePoint(). See composePoints().
+	 * \note (New in MRPT 2.4.9) */
+	void inverseComposePoints(
+		const float* gx, const float* gy, float* lx, float* ly,
+		std::size_t N) const;
+	/** \overload For `double` coordinates */
+	void inverseComposePoints(
+		const double* gx, const double* gy, double* lx, double* ly,
+		std::size_t N) const;
+
 	/** The operator \f$ u' = this \oplus u \f$ is the pose/point compounding
 	 * operator. */
 	CPoint3D operator+(const CPoint3D& u) const;
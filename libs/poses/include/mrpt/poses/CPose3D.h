@@ -15,6 +15,7 @@
 #include <mrpt/math/MatrixVectorBase.h>
 #include <mrpt/math/TPoint2D.h>
 #include <mrpt/math/TPoint3D.h>
+#include <mrpt/math/TPointCloudView.h>
 #include <mrpt/poses/CPose.h>
 #include <mrpt/system/string_utils.h>
 
@@ -416,6 +417,37 @@ class CPose3D : public CPose<CPose3D, 6>,
 		gz = d2f(ggz);
 	}
 
+	/** Computes \f$ G = P \oplus L \f$ for `N` points, given as separate
+	 * arrays of x, y, z coordinates (structure of arrays). Much faster than
+	 * calling composePoint() for each point, uses AVX2 or NEON code if
+	 * available. Output arrays can be the same than the input ones.
+	 * \note (New in MRPT 2.4.9) */
+	void composePoints(
+		const float* lx, const float* ly, const float* lz, float* gx,
+		float* gy, float* gz, std::size_t N) const;
+	/** \overload For `double` coordinates */
+	void composePoints(
+		const double* lx, const double* ly, const double* lz, double* gx,
+		double* gy, double* gz, std::size_t N) const;
+	/** \overload For the points of a point cloud view */
+	void composePoints(
+		const mrpt::math::TPointCloudView& local, float* gx, float* gy,
+		float* gz) const
+	{
+		composePoints(local.x, local.y, local.z, gx, gy, gz, local.size());
+	}
+
+	/** Computes \f$ L = G \ominus P \f$ for `N` points, like
+	 * inverseComposePoint(). See composePoints().
+	 * \note (New in MRPT 2.4.9) */
+	void inverseComposePoints(
+		const float* gx, const float* gy, const float* gz, float* lx,
+		float* ly, float* lz, std::size_t N) const;
+	/** \overload For `double` coordinates */
+	void inverseComposePoints(
+		const double* gx, const double* gy, const double* gz, double* lx,
+		double* ly, double* lz, std::size_t N) const;
+
 	/** Rotates a vector (i.e. like composePoint(), but ignoring translation) */
 	mrpt::math::TVector3D rotateVector(
 		const mrpt::math::TVector3D& local) const;
@@ -41,7 +41,7 @@ namespace mrpt::poses
  *  See TInterpolatorMethod for the list of interpolation methods. The default
  * method at constructor is "imLinearSlerp".
  *
- * \sa CPoseOrPoint
+ * \sa CPoseOrPoint, CTrajectoryMappedFile
  * \ingroup interpolation_grp poses_grp
  */
 class CPose3DInterpolator : public mrpt::serialization::CSerializable,
@@ -13,6 +13,7 @@
 #include <mrpt/core/Stringifyable.h>
 #include <mrpt/math/TPose3D.h>
 #include <mrpt/poses/CPose3DPDF.h>
+#include <mrpt/poses/TPoseParticlesSoA.h>
 
 namespace mrpt::poses
 {
@@ -85,6 +86,19 @@ class CPose3DPDFParticles
 	/** Returns the pose of the i'th particle */
 	mrpt::math::TPose3D getParticlePose(int i) const;
 
+	/** Copies all particles into a "structure of arrays" container, whose
+	 * prediction, weighting and resampling methods run in vectorizable loops.
+	 * \sa setParticlesSoA
+	 * \note (New in MRPT 2.4.9)
+	 */
+	void getParticlesSoA(TPoseParticlesSoA3D& out) const;
+
+	/** Replaces all particles with those in a "structure of arrays" container.
+	 * \sa getParticlesSoA
+	 * \note (New in MRPT 2.4.9)
+	 */
+	void setParticlesSoA(const TPoseParticlesSoA3D& in);
+
 	/** Save PDF's m_particles to a text file. In each line it will go: "x y z"
 	 */
 	bool saveToTextFile(const std::string& file) const override;
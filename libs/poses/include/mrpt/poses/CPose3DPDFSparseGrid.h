@@ -0,0 +1,235 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/core/bits_math.h>  // .0_deg
+#include <mrpt/core/round.h>
+#include <mrpt/math/CMatrixDynamic.h>
+#include <mrpt/math/TPose3D.h>
+#include <mrpt/poses/CPose3DPDF.h>
+#include <mrpt/poses/CSparsePoseGridCells.h>
+
+#include <array>
+
+namespace mrpt::poses
+{
+class CPose3DPDFGrid;
+class CPose3DPDFParticles;
+
+/** A Probability Density Function (PDF) of a SE(3) pose (x,y,z, yaw, pitch,
+ * roll), stored as a sparse 6-dimensional grid: only voxels with a non-zero
+ * probability are kept in memory. Voxels not stored have a probability of
+ * zero.
+ *
+ * Voxel indices and coordinates follow the same conventions than
+ * CPose3DPDFGrid, which can be converted to and from this class.
+ * Normalization, marginals, moments and sampling loop over the stored voxels
+ * only, and normalize() or prune() can drop the voxels below a probability
+ * threshold.
+ *
+ * \sa CPose3DPDFGrid, CPosePDFSparseGrid, CSparsePoseGridCells
+ * \ingroup poses_pdf_grp
+ * \note (New in MRPT 2.4.9)
+ */
+class CPose3DPDFSparseGrid : public CPose3DPDF
+{
+	DEFINE_SERIALIZABLE(CPose3DPDFSparseGrid, mrpt::poses)
+
+   public:
+	/** Index of a voxel: x,y,z,yaw,pitch,roll cell indices */
+	using voxel_idx_t = std::array<uint32_t, 6>;
+
+	/** Constructor: an empty grid (all voxels with zero probability) within
+	 * the given bounding box */
+	CPose3DPDFSparseGrid(
+		const mrpt::math::TPose3D& bb_min =
+			mrpt::math::TPose3D(-1., -1., -1., -M_PI, -.5 * M_PI, -.5 * M_PI),
+		const mrpt::math::TPose3D& bb_max =
+			mrpt::math::TPose3D(1., 1., 1., M_PI, .5 * M_PI, .5 * M_PI),
+		double resolution_XYZ = 0.10,
+		double resolution_YPR = mrpt::DEG2RAD(10.0));
+
+	/** Builds from a dense grid with the same limits and resolution, storing
+	 * only the voxels with a value greater than `minValue` */
+	explicit CPose3DPDFSparseGrid(
+		const CPose3DPDFGrid& dense, double minValue = 0);
+
+	~CPose3DPDFSparseGrid() override = default;
+
+	/** Changes the limits and size of the grid, erasing previous contents */
+	void setSize(
+		const mrpt::math::TPose3D& bb_min, const mrpt::math::TPose3D& bb_max,
+		double resolution_XYZ, double resolution_YPR);
+
+	/** @name Voxel indices and coordinates
+	 * @{ */
+	/** Voxel index of a pose. Throws if out of the grid limits. */
+	voxel_idx_t pose2idx(const mrpt::math::TPose3D& p) const;
+	/** Pose of the center of a voxel */
+	mrpt::math::TPose3D idx2pose(const voxel_idx_t& idx) const;
+
+	/** Linear index of a voxel, as in the equivalent dense grid */
+	uint64_t cellKey(const voxel_idx_t& idx) const
+	{
+		uint64_t key = 0;
+		for (int i = 5; i >= 0; i--)
+		{
+			ASSERT_(idx[i] < m_size[i]);
+			key = key * m_size[i] + idx[i];
+		}
+		return key;
+	}
+	voxel_idx_t keyToIndices(uint64_t key) const
+	{
+		voxel_idx_t idx;
+		for (int i = 0; i < 6; i++)
+		{
+			idx[i] = static_cast<uint32_t>(key % m_size[i]);
+			key /= m_size[i];
+		}
+		return idx;
+	}
+	/** @} */
+
+	/** @name Voxel access
+	 * @{ */
+	/** Value of a voxel, zero if it is not stored */
+	double getByIndex(const voxel_idx_t& idx) const
+	{
+		const double* v = m_cells.find(cellKey(idx));
+		return v ? *v : 0.0;
+	}
+	double getByPos(const mrpt::math::TPose3D& p) const
+	{
+		return getByIndex(pose2idx(p));
+	}
+	/** Sets the value of a voxel, storing it if it was not */
+	void setByIndex(const voxel_idx_t& idx, double value)
+	{
+		m_cells[cellKey(idx)] = value;
+	}
+	void setByPos(const mrpt::math::TPose3D& p, double value)
+	{
+		setByIndex(pose2idx(p), value);
+	}
+	/** Adds to the value of a voxel, storing it if it was not */
+	void addByPos(const mrpt::math::TPose3D& p, double value)
+	{
+		m_cells[cellKey(pose2idx(p))] += value;
+	}
+
+	/** Calls `f(const voxel_idx_t& idx, double value)` for each stored
+	 * voxel */
+	template <class FUNCTOR>
+	void forEachCell(FUNCTOR&& f) const
+	{
+		const auto& keys = m_cells.keys();
+		const auto& values = m_cells.values();
+		for (size_t i = 0; i < keys.size(); i++)
+			f(keyToIndices(keys[i]), values[i]);
+	}
+
+	/** Direct access to the stored voxels */
+	const CSparsePoseGridCells<double>& cells() const { return m_cells; }
+	CSparsePoseGridCells<double>& cells() { return m_cells; }
+
+	/** Number of stored voxels */
+	size_t getStoredCellCount() const { return m_cells.size(); }
+	/** Number of voxels of the equivalent dense grid */
+	uint64_t getTotalCellCount() const
+	{
+		uint64_t n = 1;
+		for (const auto s : m_size)
+			n *= s;
+		return n;
+	}
+	/** @} */
+
+	/** Normalizes the PDF, such as all voxels sum the unity. Then, if
+	 * `pruneThreshold>0`, drops the voxels with a lower probability and
+	 * normalizes again. */
+	void normalize(double pruneThreshold = 0);
+
+	/** Drops the voxels with a value lower or equal than `threshold` (without
+	 * normalizing). \return The number of removed voxels */
+	size_t prune(double threshold);
+
+	/** Marginal over (x,y): a matrix with one row per y and one column per x
+	 * cell, summing all other dimensions. */
+	void getMarginalXY(mrpt::math::CMatrixDouble& out) const;
+	/** Marginal over one dimension (0-5 for x,y,z,yaw,pitch,roll): one value
+	 * per cell of that dimension, summing all the others. */
+	void getMarginal(int dim, std::vector<double>& out) const;
+
+	/** Converts into particles. With `numParticles=0`, one particle per
+	 * stored voxel is created at its center, weighted with its probability.
+	 * Otherwise, `numParticles` equally-weighted particles are drawn as in
+	 * drawSingleSample(), with a low-variance (systematic) sampling of the
+	 * voxels. */
+	void getAsParticles(
+		CPose3DPDFParticles& out, size_t numParticles = 0) const;
+
+	/** Converts into a dense grid with the same limits and resolution */
+	void getAsDenseGrid(CPose3DPDFGrid& out) const;
+
+	/** Copy from another sparse grid, or from a CPose3DPDFGrid (storing all
+	 * its non-zero voxels) */
+	void copyFrom(const CPose3DPDF& o) override;
+
+	void getMean(CPose3D& mean_pose) const override;
+
+	std::tuple<cov_mat_t, type_value> getCovarianceAndMean() const override;
+
+	/** Saves one line per stored voxel: `x y z yaw pitch roll probability`
+	 * \return false on error */
+	bool saveToTextFile(const std::string& dataFile) const override;
+
+	// See base docs. Not implemented in this class.
+	void changeCoordinatesReference(const CPose3D& newReferenceBase) override;
+	/** Bayesian fusion of 2 sparse grids with the same limits and resolution
+	 * (a pointwise product, so only voxels stored in both are kept). The
+	 * result is normalized. */
+	void bayesianFusion(const CPose3DPDF& p1, const CPose3DPDF& p2) override;
+	// See base docs. Not implemented in this class.
+	void inverse(CPose3DPDF& o) const override;
+	/** Draws a single sample: a random voxel, drawn with its probability, and
+	 * a uniformly-distributed pose within it. Probabilities are assumed to be
+	 * normalized. */
+	void drawSingleSample(CPose3D& outPart) const override;
+	/** Draws N samples as in drawSingleSample(), as 1x6 vectors
+	 * (x,y,z,yaw,pitch,roll) */
+	void drawManySamples(
+		size_t N,
+		std::vector<mrpt::math::CVectorDouble>& outSamples) const override;
+
+	/** @name Grid limits and resolution
+	 * @{ */
+	mrpt::math::TPose3D getMinBoundingBox() const { return m_bb_min; }
+	mrpt::math::TPose3D getMaxBoundingBox() const { return m_bb_max; }
+	double getResolutionXYZ() const { return m_resolutionXYZ; }
+	double getResolutionAngles() const { return m_resolutionYPR; }
+	/** Number of cells in each dimension (x,y,z,yaw,pitch,roll) */
+	const voxel_idx_t& getSizes() const { return m_size; }
+	/** @} */
+
+   private:
+	mrpt::math::TPose3D m_bb_min, m_bb_max;
+	double m_resolutionXYZ, m_resolutionYPR;
+	voxel_idx_t m_size;
+
+	CSparsePoseGridCells<double> m_cells;
+
+	double resolution(int dim) const
+	{
+		return dim < 3 ? m_resolutionXYZ : m_resolutionYPR;
+	}
+	void drawInCell(size_t cellIdx, mrpt::math::TPose3D& p) const;
+
+};	// End of class def.
+}  // namespace mrpt::poses
@@ -14,6 +14,11 @@
 #include <mrpt/poses/poses_frwds.h>
 #include <mrpt/typemeta/TEnumType.h>
 
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <vector>
+
 namespace mrpt::poses
 {
 /** Type to select the interpolation method in CPoseInterpolatorBase derived
@@ -44,6 +49,16 @@ enum TInterpolatorMethod
 };
 
 /** Base class for SE(2)/SE(3) interpolators. See docs for derived classes.
+ *
+ * Queries do not search the std::map of poses, but a sorted contiguous copy
+ * of it which is (re)built on the first query after any change of the path.
+ * The search for the neighbours of the query time starts at the position
+ * predicted from the average sampling period, so it takes constant time for
+ * trajectories sampled at a (nearly) constant rate. Note that poses modified
+ * through references or iterators obtained before a call to interpolate()
+ * are not seen by later queries; call the non-const begin(), find(), at(),
+ * etc. again after interpolating to modify the path.
+ *
  * \ingroup interpolation_grp poses_grp
  */
 template <int DIM>
@@ -53,6 +68,9 @@ class CPoseInterpolatorBase
 	/** Default ctor: empty sequence of poses */
 	CPoseInterpolatorBase();
 
+	CPoseInterpolatorBase(const CPoseInterpolatorBase& o);
+	CPoseInterpolatorBase& operator=(const CPoseInterpolatorBase& o);
+
 	/** @name Type definitions and STL-like container interface
 	 * @{ */
 
@@ -70,18 +88,35 @@ class CPoseInterpolatorBase
 	using reverse_iterator = typename TPath::reverse_iterator;
 	using const_reverse_iterator = typename TPath::const_reverse_iterator;
 
-	inline iterator begin() { return m_path.begin(); }
+	inline iterator begin()
+	{
+		invalidateFlatPath();
+		return m_path.begin();
+	}
 	inline const_iterator begin() const { return m_path.begin(); }
 	inline const_iterator cbegin() const { return m_path.cbegin(); }
-	inline iterator end() { return m_path.end(); }
+	inline iterator end()
+	{
+		invalidateFlatPath();
+		return m_path.end();
+	}
 	inline const_iterator end() const { return m_path.end(); }
 	inline const_iterator cend() const { return m_path.cend(); }
-	inline reverse_iterator rbegin() { return m_path.rbegin(); }
+	inline reverse_iterator rbegin()
+	{
+		invalidateFlatPath();
+		return m_path.rbegin();
+	}
 	inline const_reverse_iterator rbegin() const { return m_path.rbegin(); }
-	inline reverse_iterator rend() { return m_path.rend(); }
+	inline reverse_iterator rend()
+	{
+		invalidateFlatPath();
+		return m_path.rend();
+	}
 	inline const_reverse_iterator rend() const { return m_path.rend(); }
 	iterator lower_bound(const mrpt::Clock::time_point& t)
 	{
+		invalidateFlatPath();
 		return m_path.lower_bound(t);
 	}
 	const_iterator lower_bound(const mrpt::Clock::time_point& t) const
@@ -91,6 +126,7 @@ class CPoseInterpolatorBase
 
 	iterator upper_bound(const mrpt::Clock::time_point& t)
 	{
+		invalidateFlatPath();
 		return m_path.upper_bound(t);
 	}
 	const_iterator upper_bound(const mrpt::Clock::time_point& t) const
@@ -100,18 +136,27 @@ class CPoseInterpolatorBase
 
 	iterator erase(iterator element_to_erase)
 	{
+		invalidateFlatPath();
 		m_path.erase(element_to_erase++);
 		return element_to_erase;
 	}
 
 	size_t size() const { return m_path.size(); }
 	bool empty() const { return m_path.empty(); }
-	iterator find(const mrpt::Clock::time_point& t) { return m_path.find(t); }
+	iterator find(const mrpt::Clock::time_point& t)
+	{
+		invalidateFlatPath();
+		return m_path.find(t);
+	}
 	const_iterator find(const mrpt::Clock::time_point& t) const
 	{
 		return m_path.find(t);
 	}
-	pose_t& at(const mrpt::Clock::time_point& t) { return m_path.at(t); }
+	pose_t& at(const mrpt::Clock::time_point& t)
+	{
+		invalidateFlatPath();
+		return m_path.at(t);
+	}
 	const pose_t& at(const mrpt::Clock::time_point& t) const
 	{
 		return m_path.at(t);
@@ -141,6 +186,22 @@ class CPoseInterpolatorBase
 		const mrpt::Clock::time_point& t, cpose_t& out_interp,
 		bool& out_valid_interp) const;
 
+	/** Interpolates the poses at a sequence of times, as interpolate() does
+	 * for each one, but faster. The search for the neighbours of each time
+	 * starts where the previous one ended, so it is especially fast for
+	 * sorted times, e.g. the timestamps of the points of a lidar scan.
+	 * \param ts The times of the poses to interpolate.
+	 * \param out_interp The output poses, resized to the size of ts.
+	 * \param out_valid If not null, it is resized and filled with whether
+	 * each pose of out_interp could be interpolated.
+	 * \return The number of valid interpolated poses.
+	 * \note (New in MRPT 2.4.9)
+	 */
+	size_t interpolate(
+		const std::vector<mrpt::Clock::time_point>& ts,
+		std::vector<pose_t>& out_interp,
+		std::vector<bool>* out_valid = nullptr) const;
+
 	/** Clears the current sequence of poses */
 	void clear();
 
@@ -217,6 +278,38 @@ class CPoseInterpolatorBase
 		const TInterpolatorMethod method, const mrpt::Clock::time_point& td,
 		pose_t& out_interp) const;
 
+	/** Sorted, contiguous copy of m_path, used to search for the neighbours
+	 * of query times */
+	struct TFlatPath
+	{
+		std::vector<mrpt::Clock::time_point> times;
+		std::vector<TTimePosePair> poses;
+	};
+
+	/** Must be called after any change of m_path */
+	void invalidateFlatPath()
+	{
+		m_flatValid.store(false, std::memory_order_relaxed);
+	}
+	/** Returns the flat version of m_path, building it if needed */
+	const TFlatPath& flatPath() const;
+
+	/** Index of the first element of the flat path with time >= t, searched
+	 * for starting at `hint` (or at the position predicted from the average
+	 * sampling period, if hint>size) */
+	size_t flatLowerBound(
+		const TFlatPath& f, const mrpt::Clock::time_point& t,
+		size_t hint) const;
+
+	/** Interpolates at t given the flatLowerBound() index `idx` of t */
+	bool interpolateAt(
+		const TFlatPath& f, size_t idx, const mrpt::Clock::time_point& t,
+		pose_t& out_interp) const;
+
+   private:
+	mutable TFlatPath m_flat;
+	mutable std::atomic_bool m_flatValid{false};
+	mutable std::mutex m_flatMtx;
 };	// End of class def.
 }  // namespace mrpt::poses
 MRPT_ENUM_TYPE_BEGIN(mrpt::poses::TInterpolatorMethod)
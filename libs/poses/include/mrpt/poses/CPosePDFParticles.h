@@ -14,6 +14,7 @@
 #include <mrpt/math/TPose2D.h>
 #include <mrpt/poses/CPosePDF.h>
 #include <mrpt/poses/CPoseRandomSampler.h>
+#include <mrpt/poses/TPoseParticlesSoA.h>
 
 namespace mrpt::poses
 {
@@ -111,6 +112,19 @@ class CPosePDFParticles : public CPosePDF,
 	 */
 	mrpt::math::TPose2D getParticlePose(size_t i) const;
 
+	/** Copies all particles into a "structure of arrays" container, whose
+	 * prediction, weighting and resampling methods run in vectorizable loops.
+	 * \sa setParticlesSoA
+	 * \note (New in MRPT 2.4.9)
+	 */
+	void getParticlesSoA(TPoseParticlesSoA2D& out) const;
+
+	/** Replaces all particles with those in a "structure of arrays" container.
+	 * \sa getParticlesSoA
+	 * \note (New in MRPT 2.4.9)
+	 */
+	void setParticlesSoA(const TPoseParticlesSoA2D& in);
+
 	/** Save PDF's m_particles to a text file. In each line it will go: "x y phi
 	 * weight"
 	 */
@@ -0,0 +1,235 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/core/bits_math.h>  // .0_deg
+#include <mrpt/core/round.h>
+#include <mrpt/math/CMatrixDynamic.h>
+#include <mrpt/poses/CPosePDF.h>
+#include <mrpt/poses/CSparsePoseGridCells.h>
+
+namespace mrpt::poses
+{
+class CPosePDFGrid;
+class CPosePDFParticles;
+
+/** A Probability Density Function (PDF) of a 2D pose (x,y,phi), stored as a
+ * sparse 3D grid: only cells with a non-zero probability are kept in memory,
+ * so large areas with a fine angular resolution (e.g. for global
+ * localization) only cost memory for their likely cells. Cells not stored
+ * have a probability of zero.
+ *
+ * Cell indices and coordinates follow the same conventions than
+ * CPosePDFGrid, which can be converted to and from this class. Normalization,
+ * marginals, moments and sampling loop over the stored cells only, and
+ * normalize() or prune() can drop the cells below a probability threshold.
+ *
+ * \sa CPosePDFGrid, CPose3DPDFSparseGrid, CSparsePoseGridCells
+ * \ingroup poses_pdf_grp
+ * \note (New in MRPT 2.4.9)
+ */
+class CPosePDFSparseGrid : public CPosePDF
+{
+	DEFINE_SERIALIZABLE(CPosePDFSparseGrid, mrpt::poses)
+
+   public:
+	/** Constructor: an empty grid (all cells with zero probability) */
+	CPosePDFSparseGrid(
+		double xMin = -1.0, double xMax = 1.0, double yMin = -1.0,
+		double yMax = 1.0, double resolutionXY = 0.5,
+		double resolutionPhi = mrpt::DEG2RAD(180.0), double phiMin = -M_PI,
+		double phiMax = M_PI);
+
+	/** Builds from a dense grid with the same limits and resolution, storing
+	 * only the cells with a value greater than `minValue` */
+	explicit CPosePDFSparseGrid(const CPosePDFGrid& dense, double minValue = 0);
+
+	~CPosePDFSparseGrid() override = default;
+
+	/** Changes the limits and size of the grid, erasing previous contents */
+	void setSize(
+		double xMin, double xMax, double yMin, double yMax, double resolutionXY,
+		double resolutionPhi, double phiMin = -M_PI, double phiMax = M_PI);
+
+	/** @name Cell indices and coordinates
+	 * @{ */
+	size_t x2idx(double x) const
+	{
+		const int idx = mrpt::round((x - m_xMin) / m_resolutionXY);
+		ASSERT_(idx >= 0 && idx < static_cast<int>(m_sizeX));
+		return idx;
+	}
+	size_t y2idx(double y) const
+	{
+		const int idx = mrpt::round((y - m_yMin) / m_resolutionXY);
+		ASSERT_(idx >= 0 && idx < static_cast<int>(m_sizeY));
+		return idx;
+	}
+	size_t phi2idx(double phi) const
+	{
+		const int idx = mrpt::round((phi - m_phiMin) / m_resolutionPhi);
+		ASSERT_(idx >= 0 && idx < static_cast<int>(m_sizePhi));
+		return idx;
+	}
+	double idx2x(size_t x) const { return m_xMin + x * m_resolutionXY; }
+	double idx2y(size_t y) const { return m_yMin + y * m_resolutionXY; }
+	double idx2phi(size_t phi) const { return m_phiMin + phi * m_resolutionPhi; }
+
+	/** Linear index of a cell, as in the equivalent dense grid */
+	uint64_t cellKey(size_t x, size_t y, size_t phi) const
+	{
+		ASSERT_(x < m_sizeX && y < m_sizeY && phi < m_sizePhi);
+		return x + m_sizeX * (y + m_sizeY * uint64_t(phi));
+	}
+	void keyToIndices(uint64_t key, size_t& x, size_t& y, size_t& phi) const
+	{
+		x = key % m_sizeX;
+		key /= m_sizeX;
+		y = key % m_sizeY;
+		phi = key / m_sizeY;
+	}
+	/** @} */
+
+	/** @name Cell access
+	 * @{ */
+	/** Value of a cell, zero if it is not stored */
+	double getByIndex(size_t x, size_t y, size_t phi) const
+	{
+		const double* v = m_cells.find(cellKey(x, y, phi));
+		return v ? *v : 0.0;
+	}
+	double getByPos(double x, double y, double phi) const
+	{
+		return getByIndex(x2idx(x), y2idx(y), phi2idx(phi));
+	}
+	/** Sets the value of a cell, storing it if it was not */
+	void setByIndex(size_t x, size_t y, size_t phi, double value)
+	{
+		m_cells[cellKey(x, y, phi)] = value;
+	}
+	void setByPos(double x, double y, double phi, double value)
+	{
+		setByIndex(x2idx(x), y2idx(y), phi2idx(phi), value);
+	}
+	/** Adds to the value of a cell, storing it if it was not */
+	void addByPos(double x, double y, double phi, double value)
+	{
+		m_cells[cellKey(x2idx(x), y2idx(y), phi2idx(phi))] += value;
+	}
+
+	/** Calls `f(x_idx, y_idx, phi_idx, value)` for each stored cell */
+	template <class FUNCTOR>
+	void forEachCell(FUNCTOR&& f) const
+	{
+		const auto& keys = m_cells.keys();
+		const auto& values = m_cells.values();
+		size_t x, y, phi;
+		for (size_t i = 0; i < keys.size(); i++)
+		{
+			keyToIndices(keys[i], x, y, phi);
+			f(x, y, phi, values[i]);
+		}
+	}
+
+	/** Direct access to the stored cells */
+	const CSparsePoseGridCells<double>& cells() const { return m_cells; }
+	CSparsePoseGridCells<double>& cells() { return m_cells; }
+
+	/** Number of stored cells */
+	size_t getStoredCellCount() const { return m_cells.size(); }
+	/** Number of cells of the equivalent dense grid */
+	uint64_t getTotalCellCount() const
+	{
+		return uint64_t(m_sizeX) * m_sizeY * m_sizePhi;
+	}
+	/** @} */
+
+	/** Normalizes the PDF, such as all cells sum the unity. Then, if
+	 * `pruneThreshold>0`, drops the cells with a lower probability and
+	 * normalizes again. */
+	void normalize(double pruneThreshold = 0);
+
+	/** Drops the cells with a value lower or equal than `threshold` (without
+	 * normalizing). \return The number of removed cells */
+	size_t prune(double threshold);
+
+	/** Marginal over (x,y): a matrix with one row per y and one column per x
+	 * cell, summing all phi cells. */
+	void getMarginalXY(mrpt::math::CMatrixDouble& out) const;
+	/** Marginal over phi: one value per phi cell, summing all (x,y) cells. */
+	void getMarginalPhi(std::vector<double>& out) const;
+
+	/** Converts into particles. With `numParticles=0`, one particle per
+	 * stored cell is created at its center, weighted with its probability.
+	 * Otherwise, `numParticles` equally-weighted particles are drawn as in
+	 * drawSingleSample(), with a low-variance (systematic) sampling of the
+	 * cells. */
+	void getAsParticles(
+		CPosePDFParticles& out, size_t numParticles = 0) const;
+
+	/** Converts into a dense grid with the same limits and resolution */
+	void getAsDenseGrid(CPosePDFGrid& out) const;
+
+	/** Copy from another sparse grid, or from a CPosePDFGrid (storing all its
+	 * non-zero cells) */
+	void copyFrom(const CPosePDF& o) override;
+
+	void getMean(CPose2D& mean_pose) const override;
+
+	std::tuple<cov_mat_t, type_value> getCovarianceAndMean() const override;
+
+	/** Saves one line per stored cell: `x y phi probability`
+	 * \return false on error */
+	bool saveToTextFile(const std::string& dataFile) const override;
+
+	/** Not implemented in this class */
+	void changeCoordinatesReference(const CPose3D& newReferenceBase) override;
+	/** Bayesian fusion of 2 sparse grids with the same limits and resolution
+	 * (a pointwise product, so only cells stored in both are kept). The result
+	 * is normalized. */
+	void bayesianFusion(
+		const CPosePDF& p1, const CPosePDF& p2,
+		const double minMahalanobisDistToDrop = 0) override;
+	/** Not implemented in this class */
+	void inverse(CPosePDF& o) const override;
+	/** Draws a single sample: a random cell, drawn with its probability, and
+	 * a uniformly-distributed pose within it. Probabilities are assumed to be
+	 * normalized. */
+	void drawSingleSample(CPose2D& outPart) const override;
+	/** Draws N samples as in drawSingleSample(), as 1x3 vectors (x,y,phi) */
+	void drawManySamples(
+		size_t N,
+		std::vector<mrpt::math::CVectorDouble>& outSamples) const override;
+
+	/** @name Grid limits and resolution
+	 * @{ */
+	double getXMin() const { return m_xMin; }
+	double getXMax() const { return m_xMax; }
+	double getYMin() const { return m_yMin; }
+	double getYMax() const { return m_yMax; }
+	double getPhiMin() const { return m_phiMin; }
+	double getPhiMax() const { return m_phiMax; }
+	double getResolutionXY() const { return m_resolutionXY; }
+	double getResolutionPhi() const { return m_resolutionPhi; }
+	size_t getSizeX() const { return m_sizeX; }
+	size_t getSizeY() const { return m_sizeY; }
+	size_t getSizePhi() const { return m_sizePhi; }
+	/** @} */
+
+   private:
+	double m_xMin, m_xMax, m_yMin, m_yMax, m_phiMin, m_phiMax, m_resolutionXY,
+		m_resolutionPhi;
+	size_t m_sizeX, m_sizeY, m_sizePhi;
+
+	CSparsePoseGridCells<double> m_cells;
+
+	void drawInCell(size_t cellIdx, mrpt::math::TPose2D& p) const;
+
+};	// End of class def.
+}  // namespace mrpt::poses
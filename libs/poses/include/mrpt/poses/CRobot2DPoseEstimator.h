@@ -13,8 +13,11 @@
 #include <mrpt/math/TTwist2D.h>
 #include <mrpt/poses/poses_frwds.h>
 
+#include <atomic>
+#include <cstdint>
 #include <mutex>
 #include <optional>
+#include <vector>
 
 namespace mrpt::poses
 {
@@ -24,14 +27,22 @@ namespace mrpt::poses
  *		- TPose2D (x,y,phi) + TTwist2D (vx,vy,omega)
  *  The filter can be asked for an extrapolation for some arbitrary time `t'`,
  *and it'll do a simple linear prediction.
- *  **All methods are thread-safe**.
+ *  The estimates after each update are also kept in a bounded history (see
+ *getHistoryLength()), so getEstimateAt() can interpolate the pose at past
+ *times.
+ *
+ *  **All methods are thread-safe**. Updates are serialized with a mutex,
+ *while queries never lock nor wait for updates: they read the latest state
+ *optimistically and read it again only if an update was published meanwhile
+ *(seqlock), so many threads can query the estimator at high rates.
  * \ingroup poses_grp poses_pdf_grp
  */
 class CRobot2DPoseEstimator
 {
    public:
-	/** Default constructor */
-	CRobot2DPoseEstimator();
+	/** Default constructor. Up to `historyLength` past estimates are kept for
+	 * getEstimateAt(). */
+	explicit CRobot2DPoseEstimator(size_t historyLength = 256);
 	/** Destructor */
 	virtual ~CRobot2DPoseEstimator();
 	/** Resets all internal state. */
@@ -65,6 +76,22 @@ class CRobot2DPoseEstimator
 		mrpt::math::TTwist2D& velGlobal,
 		mrpt::Clock::time_point tim_query = mrpt::Clock::now()) const;
 
+	/** Get the estimate for a past timestamp, interpolated from the history
+	 * of estimates after each update (linearly in x,y and velocities, along
+	 * the shortest arc in phi). Times later than the last update are
+	 * extrapolated as in getCurrentEstimate().
+	 * \return false if `tim_query` is older than the history, or there is no
+	 * valid data yet.
+	 * \note (New in MRPT 2.4.9)
+	 */
+	bool getEstimateAt(
+		mrpt::Clock::time_point tim_query, mrpt::math::TPose2D& pose,
+		mrpt::math::TTwist2D& velLocal) const;
+
+	/** Maximum number of past estimates kept for getEstimateAt()
+	 * \note (New in MRPT 2.4.9) */
+	size_t getHistoryLength() const { return m_history.size(); }
+
 	/** Get the latest known robot pose, either from odometry or localization.
 	 *  This differs from getCurrentEstimate() in that this method does NOT
 	 * extrapolate as getCurrentEstimate() does.
@@ -96,20 +123,49 @@ class CRobot2DPoseEstimator
 		mrpt::math::TPose2D& new_p);
 
    private:
+	/** Serializes updates */
 	std::mutex m_cs;
 
-	std::optional<mrpt::Clock::time_point> m_last_loc_time;
-	/** Last pose as estimated by the localization/SLAM subsystem. */
-	mrpt::math::TPose2D m_last_loc;
+	/** All the state read by queries, copied at once */
+	struct TState
+	{
+		std::optional<mrpt::Clock::time_point> last_loc_time;
+		/** Last pose as estimated by the localization/SLAM subsystem. */
+		mrpt::math::TPose2D last_loc{0, 0, 0};
+
+		/** The interpolated odometry position for the last "m_robot_pose"
+		 * (used as "coordinates base" for subsequent odo readings) */
+		mrpt::math::TPose2D loc_odo_ref{0, 0, 0};
+
+		std::optional<mrpt::Clock::time_point> last_odo_time;
+		mrpt::math::TPose2D last_odo{0, 0, 0};
+		/** Robot odometry-based velocity in a local frame of reference. */
+		mrpt::math::TTwist2D robot_vel_local{0, 0, 0};
+
+		/** Physical index of the oldest entry of m_history, and number of
+		 * them */
+		size_t hist_start = 0, hist_size = 0;
+	};
 
-	/** The interpolated odometry position for the last "m_robot_pose" (used as
-	 * "coordinates base" for subsequent odo readings) */
-	mrpt::math::TPose2D m_loc_odo_ref;
+	/** A past estimate, after an update */
+	struct TTimedEstimate
+	{
+		mrpt::Clock::time_point time;
+		mrpt::math::TPose2D pose;
+		mrpt::math::TTwist2D velLocal;
+	};
 
-	std::optional<mrpt::Clock::time_point> m_last_odo_time;
-	mrpt::math::TPose2D m_last_odo;
-	/** Robot odometry-based velocity in a local frame of reference. */
-	mrpt::math::TTwist2D m_robot_vel_local;
+	TState m_state;
+	/** Ring buffer of past estimates, sorted by time */
+	std::vector<TTimedEstimate> m_history;
+	/** Odd while an update modifies m_state or m_history */
+	std::atomic<uint64_t> m_seq{0};
+
+	/** Returns a consistent copy of the state */
+	TState readState() const;
+	/** Publishes a new state, with a new history entry, if the state has
+	 * both odometry and localization. Call with m_cs locked. */
+	void publishState(const TState& s, mrpt::Clock::time_point entryTime);
 
 };	// end of class
 
@@ -0,0 +1,191 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/core/exceptions.h>
+#include <mrpt/random/RandomGenerators.h>
+#include <mrpt/serialization/CArchive.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace mrpt::poses
+{
+/** Storage of the non-empty cells of a sparse pose grid: cell keys (the
+ * linear index of the cell in the equivalent dense grid) and values are kept
+ * in two contiguous arrays, so operations on all cells (normalization,
+ * marginals, sampling) are plain loops, plus a hash index for random access
+ * to cells by key.
+ *
+ * \sa CPosePDFSparseGrid, CPose3DPDFSparseGrid
+ * \ingroup poses_pdf_grp
+ * \note (New in MRPT 2.4.9)
+ */
+template <class T>
+class CSparsePoseGridCells
+{
+   public:
+	using key_t = uint64_t;
+
+	void clear()
+	{
+		m_keys.clear();
+		m_values.clear();
+		m_index.clear();
+	}
+	size_t size() const { return m_keys.size(); }
+	bool empty() const { return m_keys.empty(); }
+	void reserve(size_t n)
+	{
+		m_keys.reserve(n);
+		m_values.reserve(n);
+		m_index.reserve(n);
+	}
+
+	/** Returns the value of a cell, or nullptr if it is not stored */
+	const T* find(key_t key) const
+	{
+		const auto it = m_index.find(key);
+		return it == m_index.end() ? nullptr : &m_values[it->second];
+	}
+	T* find(key_t key)
+	{
+		const auto it = m_index.find(key);
+		return it == m_index.end() ? nullptr : &m_values[it->second];
+	}
+
+	/** Returns the value of a cell, inserting it with `T()` if not stored.
+	 * The reference is invalidated by later insertions or removals. */
+	T& operator[](key_t key)
+	{
+		const auto [it, isNew] = m_index.try_emplace(key, m_keys.size());
+		if (isNew)
+		{
+			m_keys.push_back(key);
+			m_values.emplace_back();
+		}
+		return m_values[it->second];
+	}
+
+	/** Removes all cells whose value satisfies `pred(value)`, keeping the
+	 * order of the rest. \return The number of removed cells */
+	template <class PRED>
+	size_t removeIf(PRED&& pred)
+	{
+		size_t n = 0;
+		for (size_t i = 0; i < m_keys.size(); i++)
+		{
+			if (pred(m_values[i])) continue;
+			m_keys[n] = m_keys[i];
+			m_values[n] = std::move(m_values[i]);
+			n++;
+		}
+		const size_t removed = m_keys.size() - n;
+		if (removed)
+		{
+			m_keys.resize(n);
+			m_values.resize(n);
+			rebuildIndex();
+		}
+		return removed;
+	}
+
+	/** Keys of stored cells, in the same order than values() */
+	const std::vector<key_t>& keys() const { return m_keys; }
+	const std::vector<T>& values() const { return m_values; }
+	/** Values can be modified in place, but not inserted or removed */
+	std::vector<T>& values() { return m_values; }
+
+	/** Replaces all cells. Keys must be unique. */
+	void assign(std::vector<key_t>&& keys, std::vector<T>&& values)
+	{
+		ASSERT_EQUAL_(keys.size(), values.size());
+		m_keys = std::move(keys);
+		m_values = std::move(values);
+		rebuildIndex();
+		ASSERTMSG_(m_index.size() == m_keys.size(), "Duplicated cell keys");
+	}
+
+	/** Draws `N` cells with a probability proportional to their values, and
+	 * returns their positions in keys()/values(). With `systematic=true`,
+	 * draws a low-variance (systematic) sample instead of independent ones.
+	 * Uses mrpt::random::getRandomGenerator(). */
+	void drawCells(
+		size_t N, bool systematic, std::vector<size_t>& cellIdxs) const
+	{
+		ASSERTMSG_(!m_values.empty(), "Cannot draw samples from empty grid");
+		std::vector<double> cumSum(m_values.size());
+		double sum = 0;
+		for (size_t i = 0; i < m_values.size(); i++)
+			cumSum[i] = (sum += m_values[i]);
+		ASSERT_GT_(sum, 0);
+
+		auto& rng = mrpt::random::getRandomGenerator();
+		cellIdxs.resize(N);
+		if (!N) return;
+		const double u0 = rng.drawUniform(0.0, sum / N);
+		size_t k = 0;
+		for (size_t i = 0; i < N; i++)
+		{
+			if (systematic)
+			{
+				// Increasing thresholds: go on from the last cell
+				const double u = u0 + i * sum / N;
+				while (k + 1 < cumSum.size() && cumSum[k] <= u)
+					k++;
+			}
+			else
+			{
+				const double u = rng.drawUniform(0.0, sum);
+				k = std::upper_bound(cumSum.begin(), cumSum.end(), u) -
+					cumSum.begin();
+				k = std::min(k, cumSum.size() - 1);
+			}
+			cellIdxs[i] = k;
+		}
+	}
+
+	void writeTo(mrpt::serialization::CArchive& out) const
+	{
+		out.WriteAs<uint64_t>(m_keys.size());
+		if (m_keys.empty()) return;
+		out.WriteBufferFixEndianness(m_keys.data(), m_keys.size());
+		out.WriteBufferFixEndianness(m_values.data(), m_values.size());
+	}
+	void readFrom(mrpt::serialization::CArchive& in)
+	{
+		const auto n = static_cast<size_t>(in.ReadAs<uint64_t>());
+		std::vector<key_t> keys(n);
+		std::vector<T> values(n);
+		if (n)
+		{
+			in.ReadBufferFixEndianness(keys.data(), n);
+			in.ReadBufferFixEndianness(values.data(), n);
+		}
+		assign(std::move(keys), std::move(values));
+	}
+
+   private:
+	std::vector<key_t> m_keys;
+	std::vector<T> m_values;
+	/** key -> index in m_keys/m_values */
+	std::unordered_map<key_t, size_t> m_index;
+
+	void rebuildIndex()
+	{
+		m_index.clear();
+		m_index.reserve(m_keys.size());
+		for (size_t i = 0; i < m_keys.size(); i++)
+			m_index.emplace(m_keys[i], i);
+	}
+};
+
+}  // namespace mrpt::poses
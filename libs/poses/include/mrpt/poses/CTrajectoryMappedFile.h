@@ -0,0 +1,146 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/core/Clock.h>
+#include <mrpt/math/TPose3D.h>
+#include <mrpt/poses/CPose3DInterpolator.h>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace mrpt::poses
+{
+/** Read-only, memory-mapped access to a binary columnar trajectory file, for
+ * long, high-rate trajectories (e.g. multi-day ground truth at hundreds of
+ * Hz) too large to be saved with CPose3DInterpolator::saveToTextFile() or
+ * serialized, and to be queried by time without loading them whole.
+ *
+ * The poses are stored in blocks of consecutive timestamps. Each block holds
+ * its timestamps as deltas (variable-length integers) and the x, y, z, yaw,
+ * pitch, roll columns as `float` or `double` (`float` positions are relative
+ * to the first pose of the block, to keep their precision in large maps),
+ * and it is compressed with zlib. An index at the end of the file, with the
+ * time range and location of each block, is used in place after open(), so
+ * opening is instantaneous regardless of the file size and time-range
+ * queries only read and decompress the blocks they need. The latest decoded
+ * blocks are cached, so nearby queries are fast.
+ *
+ * \code
+ * CTrajectoryMappedFile::Save(path, "gt.traj");
+ * ...
+ * CTrajectoryMappedFile f("gt.traj");  // instantaneous
+ * CPose3DInterpolator part;
+ * f.loadTimeRange(t0, t1, part);
+ *
+ * mrpt::math::TPose3D p;
+ * bool valid;
+ * f.interpolate(t, p, valid);
+ * \endcode
+ *
+ * All const methods are thread-safe. If memory mapping is not available
+ * (e.g. emscripten), open() reads the whole file into memory instead.
+ *
+ * \sa CPose3DInterpolator, mrpt::io::CMemoryMappedFile
+ * \note (New in MRPT 2.4.9)
+ * \ingroup interpolation_grp poses_grp
+ */
+class CTrajectoryMappedFile
+{
+   public:
+	CTrajectoryMappedFile();
+	/** Calls open() */
+	explicit CTrajectoryMappedFile(const std::string& fileName);
+	~CTrajectoryMappedFile();
+
+	CTrajectoryMappedFile(const CTrajectoryMappedFile&) = delete;
+	CTrajectoryMappedFile& operator=(const CTrajectoryMappedFile&) = delete;
+
+	/** Maps a file written by Save().
+	 * \exception std::exception If the file cannot be opened, or it is not
+	 * a valid trajectory file. */
+	void open(const std::string& fileName);
+	bool isOpen() const;
+	void close();
+
+	/** Number of poses */
+	size_t size() const;
+	bool empty() const { return size() == 0; }
+	/** Number of blocks of poses in the file */
+	size_t blockCount() const;
+	/** true if poses are stored as `double`, false for `float` */
+	bool isDoublePrecision() const;
+
+	/** Time of the first and last poses
+	 * \exception std::exception If the file is empty or not open. */
+	mrpt::Clock::time_point startTime() const;
+	mrpt::Clock::time_point endTime() const;
+
+	/** Calls `fn` for each pose with time in [t0, t1], in time order. Only
+	 * the blocks overlapping the time range are decompressed. */
+	void forEachPose(
+		const mrpt::Clock::time_point& t0, const mrpt::Clock::time_point& t1,
+		const std::function<void(
+			const mrpt::Clock::time_point&, const mrpt::math::TPose3D&)>& fn)
+		const;
+
+	/** Inserts the poses with time in [t0, t1] into `out`, which is not
+	 * cleared first. */
+	void loadTimeRange(
+		const mrpt::Clock::time_point& t0, const mrpt::Clock::time_point& t1,
+		CPose3DInterpolator& out) const;
+
+	/** Copies all the poses into `out`, replacing its contents. */
+	void loadInto(CPose3DInterpolator& out) const;
+
+	/** Returns the pose at time `t`, as CPose3DInterpolator::interpolate()
+	 * would with the whole trajectory, but only decoding the blocks with the
+	 * two poses before and after `t`.
+	 * \param maxTimeInterpolation See
+	 * CPose3DInterpolator::setMaxTimeInterpolation() (<=0: no limit)
+	 * \return A reference to out_interp */
+	mrpt::math::TPose3D& interpolate(
+		const mrpt::Clock::time_point& t, mrpt::math::TPose3D& out_interp,
+		bool& out_valid_interp, TInterpolatorMethod method = imLinearSlerp,
+		const mrpt::Clock::duration& maxTimeInterpolation =
+			std::chrono::seconds(-1)) const;
+
+	struct TSaveOptions
+	{
+		/** Store poses as `double` (true, exact) or `float` (false, half
+		 * the size before compression, with a resolution of 0.1 mm or
+		 * better for positions within 1 km of the first pose of each
+		 * block) */
+		bool doublePrecision = true;
+		/** Number of poses per block (min: 2). Larger blocks compress
+		 * better, smaller ones are faster to decode for short queries. */
+		size_t posesPerBlock = 4096;
+		/** Compress the blocks with zlib */
+		bool compress = true;
+		/** Threads compressing the blocks (0: as many as CPU cores) */
+		size_t numThreads = 0;
+	};
+
+	/** Writes all the poses of a trajectory to a file.
+	 * \exception std::exception On any file error. */
+	static void Save(
+		const CPose3DInterpolator& path, const std::string& fileName,
+		const TSaveOptions& options);
+	/** \overload With default options */
+	static void Save(
+		const CPose3DInterpolator& path, const std::string& fileName);
+
+   private:
+	struct Impl;
+	std::unique_ptr<Impl> m_impl;
+};
+
+}  // namespace mrpt::poses
@@ -11,8 +11,12 @@
 #include <mrpt/poses/Lie/SE.h>
 #include <mrpt/system/datetime.h>
 
+#include <atomic>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
 namespace mrpt::poses
 {
@@ -82,6 +86,22 @@ class FrameTransformerInterface
 
 /** See docs in FrameTransformerInterface.
  *   This class is an implementation for standalone (non ROS) applications.
+ *
+ * Frames form a tree: each sendTransform() (re)defines the parent of the
+ * child frame, and lookupTransform() composes the transforms along the path
+ * between any two frames of the same tree. The last getBufferLength()
+ * transforms of each (parent,child) pair are kept, so transforms can be
+ * looked up at past timestamps, interpolating between the two closest ones
+ * (linearly for translations, SLERP for 3D rotations). A pair with a single
+ * transform is considered static, and used for any query time.
+ *
+ * Thread safety: sendTransform() and lookupTransform() can be called
+ * concurrently from any number of threads. Lookups never lock: the tree
+ * topology is an immutable snapshot replaced as a whole when frames are
+ * added or re-parented (RCU), and the transform buffers of each pair are
+ * read optimistically and re-read if a writer changed them meanwhile
+ * (seqlock). Writers are serialized with a mutex.
+ *
  * \ingroup poses_grp
  * \sa FrameTransformerInterface
  */
@@ -94,6 +114,9 @@ class FrameTransformer : public FrameTransformerInterface<DIM>
 	FrameTransformer();
 	~FrameTransformer() override;
 
+	FrameTransformer(const FrameTransformer&) = delete;
+	FrameTransformer& operator=(const FrameTransformer&) = delete;
+
 	// See base docs
 	void sendTransform(
 		const std::string& parent_frame, const std::string& child_frame,
@@ -122,30 +145,95 @@ class FrameTransformer : public FrameTransformerInterface<DIM>
 		return ret;
 	}
 
+	/** Number of past transforms kept for each (parent,child) pair, used
+	 * for lookups at a given time (Default: 100). It only affects pairs
+	 * published for the first time afterwards.
+	 * \note (New in MRPT 2.4.9) */
+	void setBufferLength(size_t n);
+	size_t getBufferLength() const { return m_bufferLength; }
+
+	/** Lookups at a time out of the range of the buffered transforms of a
+	 * pair are allowed up to this time [s] before the first or after the
+	 * last one, returning the closest transform (Default: 0). Beyond that,
+	 * lookupTransform() returns LKUP_EXTRAPOLATION_ERROR.
+	 * \note (New in MRPT 2.4.9) */
+	void setMaxExtrapolationTime(double secs) { m_maxExtrapolation = secs; }
+	double getMaxExtrapolationTime() const { return m_maxExtrapolation; }
+
    protected:
-	// double m_max_extrapolation_time;  //!< for extrapolation in the past or
-	// in the future [s]
-	// double m_max_age_pose_cache;      //!< Max age of stored poses [s]
+	using light_type = typename base_t::light_type;
 
-	struct TF_TreeEdge
+	struct TTimedPose
 	{
-		// TODO: CPose{2,3}DInterpolator?
-		typename base_t::pose_t pose;
 		mrpt::system::TTimeStamp timestamp;
+		light_type pose;
+	};
+
+	/** The transforms of one (parent,child) pair: a ring buffer, sorted by
+	 * time, of the last ones. `seq` is odd while a writer modifies it. */
+	struct TF_TreeEdge
+	{
+		explicit TF_TreeEdge(size_t capacity) : ring(capacity) {}
 
-		TF_TreeEdge(
-			const typename base_t::pose_t& pose_,
-			const mrpt::system::TTimeStamp& timestamp_)
-			: pose(pose_), timestamp(timestamp_)
-		{
-		}
-		TF_TreeEdge() : timestamp(INVALID_TIMESTAMP) {}
+		std::vector<TTimedPose> ring;
+		/** Physical index of the oldest transform, and number of them */
+		std::atomic<size_t> start{0}, size{0};
+		std::atomic<uint64_t> seq{0};
 	};
 
-	// map: [parent] -> { [child] -> relPoseChildWRTParent }
-	using pose_tree_t =
-		std::map<std::string, std::map<std::string, TF_TreeEdge>>;
-	pose_tree_t m_pose_edges_buffer;
+	/** An edge to follow from the source to the target frame, which is
+	 * inverted when going from a child to its parent */
+	struct TChainStep
+	{
+		const TF_TreeEdge* edge;
+		bool inverse;
+	};
+	struct TChain
+	{
+		bool connected = false;
+		std::vector<TChainStep> steps;
+	};
+
+	/** Immutable snapshot of the tree topology, except for the chains
+	 * between pairs of frames, which are built on demand by lookups. */
+	struct TTopology
+	{
+		explicit TTopology(size_t nFrames);
+		~TTopology();
+
+		std::map<std::string, size_t> frameIDs;
+		/** Parent of each frame (-1 for roots), and edge to it */
+		std::vector<int> parent;
+		std::vector<TF_TreeEdge*> edgeToParent;
+		/** Cached chains, indexed by source*N+target */
+		std::unique_ptr<std::atomic<const TChain*>[]> chains;
+
+		const TChain& chain(size_t source, size_t target) const;
+	};
+
+	static void insertIntoEdge(TF_TreeEdge& e, const TTimedPose& p);
+	/** Returns false on extrapolation error */
+	bool readEdge(
+		const TF_TreeEdge& e, const mrpt::system::TTimeStamp& t,
+		light_type& out) const;
+
+	FrameLookUpStatus lookupOnce(
+		const std::string& target_frame, const std::string& source_frame,
+		light_type& child_wrt_parent,
+		const mrpt::system::TTimeStamp& query_time);
+
+	std::atomic<const TTopology*> m_topology{nullptr};
+	/** Number of lookups in progress, to know when the topologies replaced
+	 * by newer ones can be freed */
+	std::atomic<size_t> m_activeReaders{0};
+
+	/** Guards all the members below, and writing to edges */
+	std::mutex m_writeMtx;
+	std::unique_ptr<const TTopology> m_currentTopology;
+	std::vector<std::unique_ptr<const TTopology>> m_retiredTopologies;
+	std::vector<std::unique_ptr<TF_TreeEdge>> m_edges;
+	size_t m_bufferLength = 100;
+	double m_maxExtrapolation = 0;
 };
 
 }  // namespace mrpt::poses
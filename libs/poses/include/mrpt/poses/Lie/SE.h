@@ -15,6 +15,8 @@
 #include <mrpt/math/TPose3D.h>
 #include <mrpt/poses/poses_frwds.h>
 
+#include <vector>
+
 /** \defgroup mrpt_poses_lie_grp Lie Algebra methods for SO(2),SO(3),SE(2),SE(3)
  * \ingroup poses_grp */
 
@@ -151,6 +153,48 @@ struct SE<3>
 		const type& Dinv, const type& P1, const type& P2,
 		mrpt::optional_ref<matrix_TxT> df_de1 = std::nullopt,
 		mrpt::optional_ref<matrix_TxT> df_de2 = std::nullopt);
+
+	/** @name Light versions, on manifold vectors instead of CPose3D objects
+	 * These methods are equivalent to the ones above, but take or return the
+	 * poses as 3x4 matrices (see asManifoldVector()), so no CPose3D objects
+	 * (nor their cached yaw/pitch/roll angles) are built. The batch versions
+	 * process whole arrays in tight, allocation-free loops, e.g. for graph
+	 * optimization or IMU preintegration.
+	 * @{ */
+
+	/** exp(), with the pose returned as a manifold vector.
+	 * \note (New in MRPT 2.4.9) */
+	static manifold_vector expAsManifoldVector(const tangent_vector& x);
+
+	/** log() of a pose given as a manifold vector.
+	 * \note (New in MRPT 2.4.9) */
+	static tangent_vector logFromManifoldVector(const manifold_vector& P);
+
+	/** Batch expAsManifoldVector(): out[i]=exp(x[i]). out is resized.
+	 * \note (New in MRPT 2.4.9) */
+	static void exp(
+		const std::vector<tangent_vector>& x,
+		std::vector<manifold_vector>& out);
+
+	/** Batch logFromManifoldVector(): out[i]=log(P[i]). out is resized.
+	 * \note (New in MRPT 2.4.9) */
+	static void log(
+		const std::vector<manifold_vector>& P,
+		std::vector<tangent_vector>& out);
+
+	/** Batch jacob_dexpe_de(): out[i] is the Jacobian at x[i]. out is
+	 * resized. \note (New in MRPT 2.4.9) */
+	static void jacob_dexpe_de(
+		const std::vector<tangent_vector>& x,
+		std::vector<tang2mat_jacob>& out);
+
+	/** Batch jacob_dlogv_dv() for poses given as manifold vectors: out[i] is
+	 * the Jacobian at P[i]. out is resized. \note (New in MRPT 2.4.9) */
+	static void jacob_dlogv_dv(
+		const std::vector<manifold_vector>& P,
+		std::vector<mat2tang_jacob>& out);
+
+	/** @} */
 };
 
 /** Traits for SE(2), rigid-body transformations in R^2 space.
@@ -0,0 +1,157 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/math/TPose2D.h>
+#include <mrpt/math/TPose3D.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace mrpt::poses
+{
+/** \addtogroup poses_pdf_grp
+ *  @{ */
+
+/** A set of weighted 2D pose particles stored as a "structure of arrays":
+ * one contiguous array per coordinate and another one for the logarithmic
+ * weights.
+ *
+ * The regular particle filter containers (mrpt::bayes::CParticleFilterData)
+ * keep a `std::deque` of particles, which is convenient for generic payloads
+ * but forces per-particle, non-contiguous memory accesses. For pose-only
+ * particles, this container allows the compiler to vectorize the loops of the
+ * prediction (composeIncrement(), composeIncrements()), weighting
+ * (updateLogWeights(), normalizeWeights()) and resampling
+ * (performSubstitution()) steps.
+ *
+ * Use CPosePDFParticles::getParticlesSoA() and
+ * CPosePDFParticles::setParticlesSoA() to convert from/to the regular PDF
+ * class, e.g. for serialization.
+ *
+ * \note (New in MRPT 2.4.9)
+ * \sa TPoseParticlesSoA3D, CPosePDFParticles
+ */
+struct TPoseParticlesSoA2D
+{
+	std::vector<double> x, y, phi;
+	/** The (logarithmic) weight of each particle */
+	std::vector<double> log_w;
+
+	size_t size() const { return x.size(); }
+	bool empty() const { return x.empty(); }
+	/** Changes the number of particles. New particles are set to the origin,
+	 * with log_w=0. */
+	void resize(size_t n);
+	void clear();
+
+	mrpt::math::TPose2D getPose(size_t i) const
+	{
+		return {x[i], y[i], phi[i]};
+	}
+	void setPose(size_t i, const mrpt::math::TPose2D& p)
+	{
+		x[i] = p.x;
+		y[i] = p.y;
+		phi[i] = p.phi;
+	}
+
+	/** Sets all particles to the same pose, with log_w=0 */
+	void resetDeterministic(const mrpt::math::TPose2D& p);
+
+	/** Prediction step with a deterministic increment: each particle pose
+	 * becomes `p_i = p_i (+) Ap`. */
+	void composeIncrement(const mrpt::math::TPose2D& Ap);
+
+	/** Prediction step with one increment per particle (e.g. samples of the
+	 * motion model): `p_i = p_i (+) Ap_i`. The weights of `Ap` are ignored.
+	 * \exception std::exception If the sizes do not match. */
+	void composeIncrements(const TPoseParticlesSoA2D& Ap);
+
+	/** Weighting step: `log_w[i] += log_likelihood[i]`.
+	 * \exception std::exception If the sizes do not match. */
+	void updateLogWeights(const std::vector<double>& log_likelihood);
+
+	/** Subtracts the maximum log-weight from all weights, so the most likely
+	 * particle has log_w=0. Same semantics than
+	 * mrpt::bayes::CParticleFilterCapable::normalizeWeights()
+	 * \return The max/min ratio of linear weights. */
+	double normalizeWeights(double* out_max_log_w = nullptr);
+
+	/** Effective sample size, normalized to [0,1].
+	 * \sa mrpt::bayes::CParticleFilterCapable::ESS() */
+	double ESS() const;
+
+	/** Resampling step: replaces the set of particles with copies of those
+	 * given by their indices (which may be repeated, and whose count may
+	 * differ from the current one), e.g. as computed by
+	 * mrpt::bayes::CParticleFilterCapable::computeResampling(). Weights of the
+	 * new particles are copied from the original ones.
+	 * \sa mrpt::bayes::CParticleFilterCapable::performSubstitution() */
+	void performSubstitution(const std::vector<size_t>& indx);
+
+	/** Weighted mean on SE(2) (circular average of the orientations).
+	 * \sa CPosePDFParticles::getMean() */
+	mrpt::math::TPose2D getMean() const;
+};
+
+/** A set of weighted 3D pose particles stored as a "structure of arrays",
+ * with the same API than TPoseParticlesSoA2D.
+ *
+ * \note (New in MRPT 2.4.9)
+ * \sa TPoseParticlesSoA2D, CPose3DPDFParticles
+ */
+struct TPoseParticlesSoA3D
+{
+	std::vector<double> x, y, z, yaw, pitch, roll;
+	/** The (logarithmic) weight of each particle */
+	std::vector<double> log_w;
+
+	size_t size() const { return x.size(); }
+	bool empty() const { return x.empty(); }
+	/** \sa TPoseParticlesSoA2D::resize() */
+	void resize(size_t n);
+	void clear();
+
+	mrpt::math::TPose3D getPose(size_t i) const
+	{
+		return {x[i], y[i], z[i], yaw[i], pitch[i], roll[i]};
+	}
+	void setPose(size_t i, const mrpt::math::TPose3D& p)
+	{
+		x[i] = p.x;
+		y[i] = p.y;
+		z[i] = p.z;
+		yaw[i] = p.yaw;
+		pitch[i] = p.pitch;
+		roll[i] = p.roll;
+	}
+
+	/** \sa TPoseParticlesSoA2D::resetDeterministic() */
+	void resetDeterministic(const mrpt::math::TPose3D& p);
+	/** \sa TPoseParticlesSoA2D::composeIncrement() */
+	void composeIncrement(const mrpt::math::TPose3D& Ap);
+	/** \sa TPoseParticlesSoA2D::composeIncrements() */
+	void composeIncrements(const TPoseParticlesSoA3D& Ap);
+	/** \sa TPoseParticlesSoA2D::updateLogWeights() */
+	void updateLogWeights(const std::vector<double>& log_likelihood);
+	/** \sa TPoseParticlesSoA2D::normalizeWeights() */
+	double normalizeWeights(double* out_max_log_w = nullptr);
+	/** \sa TPoseParticlesSoA2D::ESS() */
+	double ESS() const;
+	/** \sa TPoseParticlesSoA2D::performSubstitution() */
+	void performSubstitution(const std::vector<size_t>& indx);
+	/** Weighted mean on SE(3).
+	 * \sa CPose3DPDFParticles::getMean() */
+	mrpt::math::TPose3D getMean() const;
+};
+
+/** @} */
+
+}  // namespace mrpt::poses
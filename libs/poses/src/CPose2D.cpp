@@ -22,6 +22,8 @@
 #include <Eigen/Dense>
 #include <limits>
 
+#include "transform_points_kernels.h"
+
 using namespace mrpt;
 using namespace mrpt::math;
 using namespace mrpt::poses;
@@ -259,6 +261,48 @@ mrpt::math::TPoint2D CPose2D::inverseComposePoint(
 /*---------------------------------------------------------------
 The operator u'="this"+u is the pose/point compounding operator.
  ---------------------------------------------------------------*/
+void CPose2D::composePoints(
+	const float* lx, const float* ly, float* gx, float* gy, std::size_t N) const
+{
+	update_cached_cos_sin();
+	const float M[6] = {d2f(m_cosphi), d2f(-m_sinphi), d2f(m_coords[0]),
+						d2f(m_sinphi), d2f(m_cosphi),  d2f(m_coords[1])};
+	detail::transformPointsKernels().tf2D(M, lx, ly, gx, gy, N);
+}
+
+void CPose2D::composePoints(
+	const double* lx, const double* ly, double* gx, double* gy,
+	std::size_t N) const
+{
+	update_cached_cos_sin();
+	const double M[6] = {m_cosphi, -m_sinphi, m_coords[0],
+						 m_sinphi, m_cosphi,  m_coords[1]};
+	detail::transform_points_2D_portable(M, lx, ly, gx, gy, N);
+}
+
+void CPose2D::inverseComposePoints(
+	const float* gx, const float* gy, float* lx, float* ly, std::size_t N) const
+{
+	update_cached_cos_sin();
+	// l = R^t * (g - t)
+	const double tx = -(m_coords[0] * m_cosphi + m_coords[1] * m_sinphi);
+	const double ty = m_coords[0] * m_sinphi - m_coords[1] * m_cosphi;
+	const float M[6] = {d2f(m_cosphi), d2f(m_sinphi), d2f(tx),
+						d2f(-m_sinphi), d2f(m_cosphi), d2f(ty)};
+	detail::transformPointsKernels().tf2D(M, gx, gy, lx, ly, N);
+}
+
+void CPose2D::inverseComposePoints(
+	const double* gx, const double* gy, double* lx, double* ly,
+	std::size_t N) const
+{
+	update_cached_cos_sin();
+	const double tx = -(m_coords[0] * m_cosphi + m_coords[1] * m_sinphi);
+	const double ty = m_coords[0] * m_sinphi - m_coords[1] * m_cosphi;
+	const double M[6] = {m_cosphi, m_sinphi, tx, -m_sinphi, m_cosphi, ty};
+	detail::transform_points_2D_portable(M, gx, gy, lx, ly, N);
+}
+
 CPoint3D CPose2D::operator+(const CPoint3D& u) const
 {
 	update_cached_cos_sin();
@@ -41,6 +41,8 @@
 #include <ostream>	// for operator<<
 #include <string>  // for allocator
 
+#include "transform_points_kernels.h"
+
 using namespace mrpt;
 using namespace mrpt::math;
 using namespace mrpt::poses;
@@ -462,6 +464,64 @@ void CPose3D::composePoint(
 	}
 }
 
+namespace
+{
+// The 3x4 transformation [R | t], as a row-major array
+template <typename T>
+void asRowMajor34(
+	const CMatrixDouble33& R, const CVectorFixedDouble<3>& t, T M[12])
+{
+	for (int r = 0; r < 3; r++)
+	{
+		for (int c = 0; c < 3; c++)
+			M[4 * r + c] = static_cast<T>(R(r, c));
+		M[4 * r + 3] = static_cast<T>(t[r]);
+	}
+}
+}  // namespace
+
+void CPose3D::composePoints(
+	const float* lx, const float* ly, const float* lz, float* gx, float* gy,
+	float* gz, std::size_t N) const
+{
+	float M[12];
+	asRowMajor34(m_ROT, m_coords, M);
+	detail::transformPointsKernels().tf3D(M, lx, ly, lz, gx, gy, gz, N);
+}
+
+void CPose3D::composePoints(
+	const double* lx, const double* ly, const double* lz, double* gx,
+	double* gy, double* gz, std::size_t N) const
+{
+	double M[12];
+	asRowMajor34(m_ROT, m_coords, M);
+	detail::transform_points_3D_portable(M, lx, ly, lz, gx, gy, gz, N);
+}
+
+void CPose3D::inverseComposePoints(
+	const float* gx, const float* gy, const float* gz, float* lx, float* ly,
+	float* lz, std::size_t N) const
+{
+	CMatrixDouble33 R_inv(UNINITIALIZED_MATRIX);
+	CVectorFixedDouble<3> t_inv;
+	mrpt::math::homogeneousMatrixInverse(m_ROT, m_coords, R_inv, t_inv);
+	float M[12];
+	asRowMajor34(R_inv, t_inv, M);
+	detail::transformPointsKernels().tf3D(M, gx, gy, gz, lx, ly, lz, N);
+}
+
+void CPose3D::inverseComposePoints(
+	const double* gx, const double* gy, const double* gz, double* lx,
+	double* ly, double* lz, std::size_t N) const
+{
+	CMatrixDouble33 R_inv(UNINITIALIZED_MATRIX);
+	CVectorFixedDouble<3> t_inv;
+	mrpt::math::homogeneousMatrixInverse(m_ROT, m_coords, R_inv, t_inv);
+	double M[12];
+	asRowMajor34(R_inv, t_inv, M);
+	detail::transform_points_3D_portable(M, gx, gy, gz, lx, ly, lz, N);
+}
+
 mrpt::math::TVector3D CPose3D::rotateVector(
 	const mrpt::math::TVector3D& l) const
 {
@@ -48,6 +48,7 @@ void CPose3DInterpolator::serializeFrom(
 		break;
 		default: MRPT_THROW_UNKNOWN_SERIALIZATION_VERSION(version);
 	};
+	invalidateFlatPath();
 }
 
 namespace mrpt::poses
@@ -52,3 +52,62 @@ TEST(CPose3DInterpolator, interp)
 			.sum(),
 		2e-4);
 }
+
+TEST(CPose3DInterpolator, interpBatch)
+{
+	using namespace mrpt::poses;
+	using mrpt::math::TPose3D;
+	using namespace std::chrono_literals;
+
+	const auto t0 = mrpt::Clock::now();
+	for (bool uniform : {true, false})
+	{
+		CPose3DInterpolator pose_path;
+		pose_path.setInterpolationMethod(imSpline);
+		auto t = t0;
+		for (int i = 0; i < 100; i++)
+		{
+			pose_path.insert(t, TPose3D(0.1 * i, 0.01 * i * i, 0, 0, 0, 0));
+			t += uniform ? 10ms : (i % 7 == 0 ? 55ms : 3ms);
+		}
+
+		std::vector<mrpt::Clock::time_point> ts;
+		for (auto tq = t0 - 5ms; tq < t + 5ms; tq += 1ms)
+			ts.push_back(tq);
+		// Some unsorted queries too:
+		ts.push_back(t0 + 13ms);
+		ts.push_back(t0 + 101ms);
+
+		std::vector<TPose3D> poses;
+		std::vector<bool> valids;
+		const size_t nValid = pose_path.interpolate(ts, poses, &valids);
+		ASSERT_EQ(poses.size(), ts.size());
+		ASSERT_EQ(valids.size(), ts.size());
+
+		size_t nValidSingle = 0;
+		for (size_t i = 0; i < ts.size(); i++)
+		{
+			TPose3D p;
+			bool valid;
+			pose_path.interpolate(ts[i], p, valid);
+			EXPECT_EQ(valid, valids[i]);
+			if (valid) nValidSingle++;
+			for (int k = 0; k < 6; k++)
+				EXPECT_DOUBLE_EQ(p[k], poses[i][k]);
+		}
+		EXPECT_EQ(nValid, nValidSingle);
+		EXPECT_FALSE(valids.front());
+		EXPECT_TRUE(valids.back());
+
+		// Changes after a query must be seen by the next one:
+		pose_path.insert(t0 + 13ms, TPose3D(9, 9, 9, 0, 0, 0));
+		TPose3D p;
+		bool valid;
+		pose_path.interpolate(t0 + 13ms, p, valid);
+		EXPECT_TRUE(valid);
+		EXPECT_DOUBLE_EQ(p.x, 9.0);
+		pose_path.at(t0 + 13ms).x = 8;
+		pose_path.interpolate(t0 + 13ms, p, valid);
+		EXPECT_DOUBLE_EQ(p.x, 8.0);
+	}
+}
@@ -238,6 +238,28 @@ mrpt::math::TPose3D CPose3DPDFParticles::getParticlePose(int i) const
 	return m_particles[i].d;
 }
 
+void CPose3DPDFParticles::getParticlesSoA(TPoseParticlesSoA3D& out) const
+{
+	const size_t N = m_particles.size();
+	out.resize(N);
+	for (size_t i = 0; i < N; i++)
+	{
+		out.setPose(i, m_particles[i].d);
+		out.log_w[i] = m_particles[i].log_w;
+	}
+}
+
+void CPose3DPDFParticles::setParticlesSoA(const TPoseParticlesSoA3D& in)
+{
+	const size_t N = in.size();
+	m_particles.resize(N);
+	for (size_t i = 0; i < N; i++)
+	{
+		m_particles[i].d = in.getPose(i);
+		m_particles[i].log_w = in.log_w[i];
+	}
+}
+
 void CPose3DPDFParticles::changeCoordinatesReference(
 	const CPose3D& newReferenceBase)
 {
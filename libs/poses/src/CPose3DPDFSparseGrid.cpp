@@ -0,0 +1,354 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "poses-precomp.h"	// Precompiled headers
+//
+#include <mrpt/math/wrap2pi.h>
+#include <mrpt/poses/CPose3D.h>
+#include <mrpt/poses/CPose3DPDFGrid.h>
+#include <mrpt/poses/CPose3DPDFParticles.h>
+#include <mrpt/poses/CPose3DPDFSparseGrid.h>
+#include <mrpt/poses/SO_SE_average.h>
+#include <mrpt/random.h>
+#include <mrpt/serialization/CArchive.h>
+
+#include <fstream>
+
+using namespace mrpt;
+using namespace mrpt::math;
+using namespace mrpt::poses;
+
+IMPLEMENTS_SERIALIZABLE(CPose3DPDFSparseGrid, CPose3DPDF, mrpt::poses)
+
+CPose3DPDFSparseGrid::CPose3DPDFSparseGrid(
+	const TPose3D& bb_min, const TPose3D& bb_max, double resolution_XYZ,
+	double resolution_YPR)
+{
+	setSize(bb_min, bb_max, resolution_XYZ, resolution_YPR);
+}
+
+CPose3DPDFSparseGrid::CPose3DPDFSparseGrid(
+	const CPose3DPDFGrid& dense, double minValue)
+{
+	setSize(
+		dense.getMinBoundingBox(), dense.getMaxBoundingBox(),
+		dense.getResolutionXYZ(), dense.getResolutionAngles());
+	ASSERT_EQUAL_(getTotalCellCount(), dense.getTotalVoxelCount());
+
+	// Both use the same linear indices:
+	const auto& data = dense.getData();
+	for (size_t i = 0; i < data.size(); i++)
+		if (data[i] > minValue) m_cells[i] = data[i];
+}
+
+void CPose3DPDFSparseGrid::setSize(
+	const TPose3D& bb_min, const TPose3D& bb_max, double resolution_XYZ,
+	double resolution_YPR)
+{
+	for (int i = 0; i < 6; i++)
+		ASSERT_GT_(bb_max[i], bb_min[i]);
+	ASSERT_GT_(resolution_XYZ, .0);
+	ASSERT_GT_(resolution_YPR, .0);
+
+	m_bb_min = bb_min;
+	m_bb_max = bb_max;
+	m_resolutionXYZ = resolution_XYZ;
+	m_resolutionYPR = resolution_YPR;
+
+	// Same number of cells than CPose3DGridTemplate:
+	for (int i = 0; i < 6; i++)
+		m_size[i] = mrpt::round(bb_max[i] / resolution(i)) -
+			mrpt::round(bb_min[i] / resolution(i)) + 1;
+
+	m_cells.clear();
+}
+
+CPose3DPDFSparseGrid::voxel_idx_t CPose3DPDFSparseGrid::pose2idx(
+	const TPose3D& p) const
+{
+	voxel_idx_t idx;
+	for (int i = 0; i < 6; i++)
+	{
+		const int c = mrpt::round((p[i] - m_bb_min[i]) / resolution(i));
+		ASSERT_(c >= 0 && c < static_cast<int>(m_size[i]));
+		idx[i] = c;
+	}
+	return idx;
+}
+
+TPose3D CPose3DPDFSparseGrid::idx2pose(const voxel_idx_t& idx) const
+{
+	TPose3D p;
+	for (int i = 0; i < 6; i++)
+		p[i] = m_bb_min[i] + idx[i] * resolution(i);
+	return p;
+}
+
+void CPose3DPDFSparseGrid::copyFrom(const CPose3DPDF& o)
+{
+	if (this == &o) return;
+
+	if (const auto* sg = dynamic_cast<const CPose3DPDFSparseGrid*>(&o); sg)
+	{
+		*this = *sg;
+		return;
+	}
+	if (const auto* g = dynamic_cast<const CPose3DPDFGrid*>(&o); g)
+	{
+		*this = CPose3DPDFSparseGrid(*g);
+		return;
+	}
+	THROW_EXCEPTION("Not implemented yet for this PDF class");
+}
+
+void CPose3DPDFSparseGrid::normalize(double pruneThreshold)
+{
+	auto& values = m_cells.values();
+	for (int pass = 0; pass < 2; pass++)
+	{
+		double sum = 0;
+		for (const double v : values)
+			sum += v;
+		if (sum <= 0) return;
+
+		const double f = 1.0 / sum;
+		for (double& v : values)
+			v *= f;
+
+		if (pruneThreshold <= 0 || pass == 1) break;
+		if (!prune(pruneThreshold)) break;
+	}
+}
+
+size_t CPose3DPDFSparseGrid::prune(double threshold)
+{
+	return m_cells.removeIf([threshold](double v) { return v <= threshold; });
+}
+
+void CPose3DPDFSparseGrid::getMarginalXY(CMatrixDouble& out) const
+{
+	out.setZero(m_size[1], m_size[0]);
+	// x,y are the fastest-varying indices of keys:
+	const uint64_t xySize = uint64_t(m_size[0]) * m_size[1];
+	const auto& keys = m_cells.keys();
+	const auto& values = m_cells.values();
+	for (size_t i = 0; i < keys.size(); i++)
+	{
+		const uint64_t xy = keys[i] % xySize;
+		out(xy / m_size[0], xy % m_size[0]) += values[i];
+	}
+}
+
+void CPose3DPDFSparseGrid::getMarginal(int dim, std::vector<double>& out) const
+{
+	ASSERT_(dim >= 0 && dim < 6);
+	out.assign(m_size[dim], 0.0);
+	uint64_t stride = 1;
+	for (int i = 0; i < dim; i++)
+		stride *= m_size[i];
+	const auto& keys = m_cells.keys();
+	const auto& values = m_cells.values();
+	for (size_t i = 0; i < keys.size(); i++)
+		out[(keys[i] / stride) % m_size[dim]] += values[i];
+}
+
+void CPose3DPDFSparseGrid::getMean(CPose3D& p) const
+{
+	mrpt::poses::SE_average<3> se_averager;
+	forEachCell([&](const voxel_idx_t& idx, double w) {
+		se_averager.append(CPose3D(idx2pose(idx)), w);
+	});
+	se_averager.get_average(p);
+}
+
+std::tuple<CMatrixDouble66, CPose3D> CPose3DPDFSparseGrid::getCovarianceAndMean()
+	const
+{
+	CPose3D meanPose;
+	getMean(meanPose);
+	const TPose3D mean = meanPose.asTPose();
+
+	CMatrixDouble66 cov;
+	double sumW = 0;
+	forEachCell([&](const voxel_idx_t& idx, double w) {
+		const TPose3D p = idx2pose(idx);
+		double d[6];
+		for (int i = 0; i < 6; i++)
+			d[i] = i < 3 ? p[i] - mean[i]
+						 : mrpt::math::wrapToPi(p[i] - mean[i]);
+		for (int r = 0; r < 6; r++)
+			for (int c = r; c < 6; c++)
+				cov(r, c) += w * d[r] * d[c];
+		sumW += w;
+	});
+	if (sumW > 0) cov *= 1.0 / sumW;
+	for (int r = 0; r < 6; r++)
+		for (int c = 0; c < r; c++)
+			cov(r, c) = cov(c, r);
+	return {cov, meanPose};
+}
+
+void CPose3DPDFSparseGrid::drawInCell(size_t cellIdx, TPose3D& p) const
+{
+	auto& rng = mrpt::random::getRandomGenerator();
+	p = idx2pose(keyToIndices(m_cells.keys()[cellIdx]));
+	for (int i = 0; i < 6; i++)
+	{
+		const double h = 0.5 * resolution(i);
+		p[i] += rng.drawUniform(-h, h);
+		if (i >= 3) p[i] = mrpt::math::wrapToPi(p[i]);
+	}
+}
+
+void CPose3DPDFSparseGrid::drawSingleSample(CPose3D& outPart) const
+{
+	std::vector<size_t> idxs;
+	m_cells.drawCells(1, false, idxs);
+	TPose3D p;
+	drawInCell(idxs[0], p);
+	outPart = CPose3D(p);
+}
+
+void CPose3DPDFSparseGrid::drawManySamples(
+	size_t N, std::vector<CVectorDouble>& outSamples) const
+{
+	std::vector<size_t> idxs;
+	m_cells.drawCells(N, false, idxs);
+	outSamples.resize(N);
+	TPose3D p;
+	for (size_t i = 0; i < N; i++)
+	{
+		drawInCell(idxs[i], p);
+		outSamples[i].resize(6);
+		for (int j = 0; j < 6; j++)
+			outSamples[i][j] = p[j];
+	}
+}
+
+void CPose3DPDFSparseGrid::getAsParticles(
+	CPose3DPDFParticles& out, size_t numParticles) const
+{
+	if (!numParticles)
+	{
+		out.resetDeterministic(TPose3D(), m_cells.size());
+		size_t i = 0;
+		forEachCell([&](const voxel_idx_t& idx, double w) {
+			auto& part = out.m_particles[i++];
+			part.d = idx2pose(idx);
+			part.log_w = std::log(w);
+		});
+		return;
+	}
+
+	std::vector<size_t> idxs;
+	m_cells.drawCells(numParticles, true, idxs);
+	out.resetDeterministic(TPose3D(), numParticles);
+	for (size_t i = 0; i < numParticles; i++)
+	{
+		TPose3D p;
+		drawInCell(idxs[i], p);
+		out.m_particles[i].d = p;
+		out.m_particles[i].log_w = 0;
+	}
+}
+
+void CPose3DPDFSparseGrid::getAsDenseGrid(CPose3DPDFGrid& out) const
+{
+	out.setSize(m_bb_min, m_bb_max, m_resolutionXYZ, m_resolutionYPR);
+	// setSize() zeroes all voxels, with the same linear indices:
+	auto& data = out.getData();
+	const auto& keys = m_cells.keys();
+	const auto& values = m_cells.values();
+	for (size_t i = 0; i < keys.size(); i++)
+		data.at(keys[i]) = values[i];
+}
+
+uint8_t CPose3DPDFSparseGrid::serializeGetVersion() const { return 0; }
+void CPose3DPDFSparseGrid::serializeTo(
+	mrpt::serialization::CArchive& out) const
+{
+	out << m_bb_min << m_bb_max << m_resolutionXYZ << m_resolutionYPR;
+	m_cells.writeTo(out);
+}
+void CPose3DPDFSparseGrid::serializeFrom(
+	mrpt::serialization::CArchive& in, uint8_t version)
+{
+	switch (version)
+	{
+		case 0:
+		{
+			TPose3D bbMin, bbMax;
+			double resXYZ, resYPR;
+			in >> bbMin >> bbMax >> resXYZ >> resYPR;
+			setSize(bbMin, bbMax, resXYZ, resYPR);
+			m_cells.readFrom(in);
+		}
+		break;
+		default: MRPT_THROW_UNKNOWN_SERIALIZATION_VERSION(version);
+	};
+}
+
+bool CPose3DPDFSparseGrid::saveToTextFile(const std::string& dataFile) const
+{
+	std::ofstream f(dataFile);
+	if (!f.is_open()) return false;
+
+	f << "% x y z yaw pitch roll probability\n";
+	forEachCell([&](const voxel_idx_t& idx, double v) {
+		const TPose3D p = idx2pose(idx);
+		f << mrpt::format(
+			"%f %f %f %f %f %f %.5e\n", p.x, p.y, p.z, p.yaw, p.pitch, p.roll,
+			v);
+	});
+	return true;
+}
+
+void CPose3DPDFSparseGrid::changeCoordinatesReference(
+	[[maybe_unused]] const CPose3D& newReferenceBase)
+{
+	THROW_EXCEPTION("Not implemented yet!");
+}
+
+void CPose3DPDFSparseGrid::bayesianFusion(
+	const CPose3DPDF& p1_, const CPose3DPDF& p2_)
+{
+	const auto* p1 = dynamic_cast<const CPose3DPDFSparseGrid*>(&p1_);
+	const auto* p2 = dynamic_cast<const CPose3DPDFSparseGrid*>(&p2_);
+	ASSERTMSG_(
+		p1 && p2, "Only implemented for two CPose3DPDFSparseGrid densities");
+	ASSERTMSG_(
+		p1->m_size == p2->m_size && p1->m_bb_min == p2->m_bb_min,
+		"Both grids must have the same limits and resolution");
+
+	// Iterate over the smaller one:
+	if (p2->m_cells.size() < p1->m_cells.size()) std::swap(p1, p2);
+
+	std::vector<uint64_t> keys;
+	std::vector<double> values;
+	const auto& k1 = p1->m_cells.keys();
+	const auto& v1 = p1->m_cells.values();
+	for (size_t i = 0; i < k1.size(); i++)
+	{
+		const double* v2 = p2->m_cells.find(k1[i]);
+		if (!v2 || *v2 * v1[i] <= 0) continue;
+		keys.push_back(k1[i]);
+		values.push_back(*v2 * v1[i]);
+	}
+
+	CPose3DPDFSparseGrid res(
+		p1->m_bb_min, p1->m_bb_max, p1->m_resolutionXYZ, p1->m_resolutionYPR);
+	res.m_cells.assign(std::move(keys), std::move(values));
+	res.normalize();
+	*this = std::move(res);
+}
+
+void CPose3DPDFSparseGrid::inverse([[maybe_unused]] CPose3DPDF& o) const
+{
+	THROW_EXCEPTION("Not implemented yet!");
+}
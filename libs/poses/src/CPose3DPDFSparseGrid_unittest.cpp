@@ -0,0 +1,84 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <CTraitsTest.h>
+#include <gtest/gtest.h>
+#include <mrpt/poses/CPose3D.h>
+#include <mrpt/poses/CPose3DPDFGrid.h>
+#include <mrpt/poses/CPose3DPDFParticles.h>
+#include <mrpt/poses/CPose3DPDFSparseGrid.h>
+
+using namespace mrpt;
+using namespace mrpt::poses;
+using namespace mrpt::math;
+
+template class mrpt::CTraitsTest<CPose3DPDFSparseGrid>;
+
+TEST(CPose3DPDFSparseGrid, setManualPDF)
+{
+	const auto bb_min = TPose3D(-50, -50, 0, -180.0_deg, -30.0_deg, -30.0_deg);
+	const auto bb_max = TPose3D(50, 50, 5, 180.0_deg, 30.0_deg, 30.0_deg);
+	const auto gt_mean = TPose3D(2, 3, 4, 9.0_deg, 14.0_deg, 12.0_deg);
+
+	// ~10^14 voxels in the equivalent dense grid:
+	CPose3DPDFSparseGrid grid(bb_min, bb_max, 0.05, mrpt::DEG2RAD(2.0));
+	EXPECT_GT(grid.getTotalCellCount(), uint64_t(1e13));
+
+	grid.setByPos(gt_mean, 0.1);
+	grid.addByPos(TPose3D(-20, 10, 1, 0, 0, 0), 1e-9);
+	grid.normalize(1e-6);
+	EXPECT_EQ(grid.getStoredCellCount(), 1U);
+
+	const auto idx = grid.pose2idx(gt_mean);
+	EXPECT_EQ(grid.keyToIndices(grid.cellKey(idx)), idx);
+
+	auto [COV, MEAN] = grid.getCovarianceAndMean();
+
+	EXPECT_NEAR(MEAN.x(), gt_mean.x, 0.05);
+	EXPECT_NEAR(MEAN.y(), gt_mean.y, 0.05);
+	EXPECT_NEAR(MEAN.z(), gt_mean.z, 0.05);
+	EXPECT_NEAR(MEAN.yaw(), gt_mean.yaw, 0.02);
+	EXPECT_NEAR(MEAN.pitch(), gt_mean.pitch, 0.02);
+	EXPECT_NEAR(MEAN.roll(), gt_mean.roll, 0.02);
+	for (int i = 0; i < 6; i++)
+		EXPECT_LT(COV(i, i), mrpt::square(0.01));
+
+	std::vector<double> mYaw;
+	grid.getMarginal(3, mYaw);
+	EXPECT_NEAR(mYaw.at(idx[3]), 1.0, 1e-9);
+
+	CPose3DPDFParticles parts;
+	grid.getAsParticles(parts, 100);
+	ASSERT_EQ(parts.size(), 100U);
+	for (const auto& p : parts.m_particles)
+		EXPECT_NEAR(p.d.x, gt_mean.x, 0.05);
+}
+
+TEST(CPose3DPDFSparseGrid, denseConversion)
+{
+	const auto bb_min = TPose3D(1, 2, 3, -20.0_deg, -30.0_deg, -40.0_deg);
+	const auto bb_max = TPose3D(3, 4, 5, 20.0_deg, 30.0_deg, 40.0_deg);
+	const auto p = TPose3D(2, 3, 4, 9.0_deg, 14.0_deg, 12.0_deg);
+
+	CPose3DPDFGrid dense(bb_min, bb_max, 0.5, mrpt::DEG2RAD(20.0));
+	dense.fill(0);
+	*dense.getByPos(p) = 1.0;
+
+	const CPose3DPDFSparseGrid sg(dense);
+	EXPECT_EQ(sg.getStoredCellCount(), 1U);
+	EXPECT_EQ(sg.getByPos(p), 1.0);
+
+	CPose3DPDFGrid dense2;
+	sg.getAsDenseGrid(dense2);
+	EXPECT_EQ(dense2.getData(), dense.getData());
+
+	CMatrixDouble mXY;
+	sg.getMarginalXY(mXY);
+	EXPECT_EQ(mXY(dense.y2idx(p.y), dense.x2idx(p.x)), 1.0);
+}
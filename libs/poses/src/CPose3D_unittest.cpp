@@ -918,6 +918,58 @@ TEST_F(Pose3DTests, ComposeAndInvComposeWithPoint)
 	}
 }
 
+TEST_F(Pose3DTests, ComposeAndInvComposePointsBatch)
+{
+	// Enough points for the SIMD loops and their remainders:
+	const size_t N = 37;
+	std::vector<float> xs(N), ys(N), zs(N), gx(N), gy(N), gz(N);
+	for (size_t i = 0; i < N; i++)
+	{
+		xs[i] = -5.0f + 0.3f * i;
+		ys[i] = 2.0f - 0.1f * i;
+		zs[i] = 0.05f * i * i;
+	}
+	for (const auto& p : ptc)
+	{
+		p.composePoints(
+			xs.data(), ys.data(), zs.data(), gx.data(), gy.data(), gz.data(),
+			N);
+		for (size_t i = 0; i < N; i++)
+		{
+			const auto g = p.composePoint({xs[i], ys[i], zs[i]});
+			EXPECT_NEAR(gx[i], g.x, 1e-4);
+			EXPECT_NEAR(gy[i], g.y, 1e-4);
+			EXPECT_NEAR(gz[i], g.z, 1e-4);
+		}
+		// In place, back to the local points:
+		p.inverseComposePoints(
+			gx.data(), gy.data(), gz.data(), gx.data(), gy.data(), gz.data(),
+			N);
+		for (size_t i = 0; i < N; i++)
+		{
+			EXPECT_NEAR(gx[i], xs[i], 1e-4);
+			EXPECT_NEAR(gy[i], ys[i], 1e-4);
+			EXPECT_NEAR(gz[i], zs[i], 1e-4);
+		}
+
+		const CPose2D p2(p);
+		p2.composePoints(xs.data(), ys.data(), gx.data(), gy.data(), N);
+		for (size_t i = 0; i < N; i++)
+		{
+			double x, y;
+			p2.composePoint(xs[i], ys[i], x, y);
+			EXPECT_NEAR(gx[i], x, 1e-4);
+			EXPECT_NEAR(gy[i], y, 1e-4);
+		}
+		p2.inverseComposePoints(gx.data(), gy.data(), gx.data(), gy.data(), N);
+		for (size_t i = 0; i < N; i++)
+		{
+			EXPECT_NEAR(gx[i], xs[i], 1e-4);
+			EXPECT_NEAR(gy[i], ys[i], 1e-4);
+		}
+	}
+}
+
 TEST_F(Pose3DTests, ComposePointJacob)
 {
 	for (const auto& p : ptc)
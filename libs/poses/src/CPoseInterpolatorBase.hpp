@@ -19,6 +19,7 @@
 #include <mrpt/poses/CPose3DPDFParticles.h>
 #include <mrpt/serialization/stl_serialization.h>
 #include <mrpt/system/datetime.h>
+#include <algorithm>
 #include <fstream>
 #include <mrpt/math/interp_fit.hpp>
 
@@ -31,10 +32,32 @@ CPoseInterpolatorBase<DIM>::CPoseInterpolatorBase()
 {
 }
 
+template <int DIM>
+CPoseInterpolatorBase<DIM>::CPoseInterpolatorBase(
+	const CPoseInterpolatorBase& o)
+	: m_path(o.m_path),
+	  maxTimeInterpolation(o.maxTimeInterpolation),
+	  m_method(o.m_method)
+{
+}
+
+template <int DIM>
+CPoseInterpolatorBase<DIM>& CPoseInterpolatorBase<DIM>::operator=(
+	const CPoseInterpolatorBase& o)
+{
+	if (this == &o) return *this;
+	m_path = o.m_path;
+	maxTimeInterpolation = o.maxTimeInterpolation;
+	m_method = o.m_method;
+	invalidateFlatPath();
+	return *this;
+}
+
 template <int DIM>
 void CPoseInterpolatorBase<DIM>::clear()
 {
 	m_path.clear();
+	invalidateFlatPath();
 }
 
 template <int DIM>
@@ -42,12 +65,14 @@ void CPoseInterpolatorBase<DIM>::insert(
 	const mrpt::Clock::time_point& t, const cpose_t& p)
 {
 	m_path[t] = p.asTPose();
+	invalidateFlatPath();
 }
 template <int DIM>
 void CPoseInterpolatorBase<DIM>::insert(
 	const mrpt::Clock::time_point& t, const pose_t& p)
 {
 	m_path[t] = p;
+	invalidateFlatPath();
 }
 
 /*---------------------------------------------------------------
@@ -70,14 +95,100 @@ typename CPoseInterpolatorBase<DIM>::pose_t&
 	CPoseInterpolatorBase<DIM>::interpolate(
 		const mrpt::Clock::time_point& t, pose_t& out_interp,
 		bool& out_valid_interp) const
+{
+	const TFlatPath& f = flatPath();
+	out_valid_interp = interpolateAt(
+		f, flatLowerBound(f, t, f.times.size() + 1), t, out_interp);
+	return out_interp;
+}
+
+template <int DIM>
+size_t CPoseInterpolatorBase<DIM>::interpolate(
+	const std::vector<mrpt::Clock::time_point>& ts,
+	std::vector<pose_t>& out_interp, std::vector<bool>* out_valid) const
+{
+	const TFlatPath& f = flatPath();
+	const size_t N = ts.size();
+	out_interp.resize(N);
+	if (out_valid) out_valid->resize(N);
+
+	size_t nValid = 0, idx = f.times.size() + 1;
+	for (size_t i = 0; i < N; i++)
+	{
+		idx = flatLowerBound(f, ts[i], idx);
+		const bool valid = interpolateAt(f, idx, ts[i], out_interp[i]);
+		if (out_valid) (*out_valid)[i] = valid;
+		if (valid) nValid++;
+	}
+	return nValid;
+}
+
+template <int DIM>
+const typename CPoseInterpolatorBase<DIM>::TFlatPath&
+	CPoseInterpolatorBase<DIM>::flatPath() const
+{
+	if (!m_flatValid.load(std::memory_order_acquire))
+	{
+		std::lock_guard<std::mutex> lck(m_flatMtx);
+		if (!m_flatValid.load(std::memory_order_relaxed))
+		{
+			m_flat.times.clear();
+			m_flat.poses.clear();
+			m_flat.times.reserve(m_path.size());
+			m_flat.poses.reserve(m_path.size());
+			for (const auto& p : m_path)
+			{
+				m_flat.times.push_back(p.first);
+				m_flat.poses.push_back(p);
+			}
+			m_flatValid.store(true, std::memory_order_release);
+		}
+	}
+	return m_flat;
+}
+
+template <int DIM>
+size_t CPoseInterpolatorBase<DIM>::flatLowerBound(
+	const TFlatPath& f, const mrpt::Clock::time_point& t, size_t hint) const
+{
+	const auto& T = f.times;
+	const size_t n = T.size();
+	if (n == 0 || t <= T.front()) return 0;
+	if (t > T.back()) return n;
+
+	// Here, the result is in [1,n-1]. Predict it from the average period:
+	if (hint > n)
+	{
+		const double ratio = static_cast<double>((t - T.front()).count()) /
+			static_cast<double>((T.back() - T.front()).count());
+		hint = static_cast<size_t>(ratio * (n - 1));
+	}
+	hint = std::clamp<size_t>(hint, 1, n - 1);
+
+	// Walk a few steps from the hint (enough for a constant sampling rate, or
+	// for sorted query times), then fall back to binary search:
+	constexpr size_t MAX_STEPS = 8;
+	for (size_t step = 0; step < MAX_STEPS; step++)
+	{
+		if (T[hint] < t) hint++;
+		else if (T[hint - 1] >= t)
+			hint--;
+		else
+			return hint;
+	}
+	return std::lower_bound(T.begin(), T.end(), t) - T.begin();
+}
+
+template <int DIM>
+bool CPoseInterpolatorBase<DIM>::interpolateAt(
+	const TFlatPath& f, size_t idx, const mrpt::Clock::time_point& t,
+	pose_t& out_interp) const
 {
 	// Default value in case of invalid interp
 	for (size_t k = 0; k < pose_t::static_size; k++)
 	{
 		out_interp[k] = 0;
 	}
-	TTimePosePair p1, p2, p3, p4;
-	p1.second = p2.second = p3.second = p4.second = out_interp;
 
 	// We'll look for 4 consecutive time points.
 	// Check if the selected method needs all 4 points or just the central 2 of
@@ -95,54 +206,28 @@ typename CPoseInterpolatorBase<DIM>::pose_t&
 			break;
 	};
 
-	// Out of range?
-	auto it_ge1 = m_path.lower_bound(t);
+	const size_t n = f.times.size();
 
 	// Exact match?
-	if (it_ge1 != m_path.end() && it_ge1->first == t)
+	if (idx < n && f.times[idx] == t)
 	{
-		out_interp = it_ge1->second;
-		out_valid_interp = true;
-		return out_interp;
+		out_interp = f.poses[idx].second;
+		return true;
 	}
 
 	// Are we in the beginning or the end of the path?
-	if (it_ge1 == m_path.end() || it_ge1 == m_path.begin())
-	{
-		out_valid_interp = false;
-		return out_interp;
-	}  // end
-
-	p3 = *it_ge1;  // Third pair
-	auto it_ge2 = it_ge1;
-	++it_ge2;
-	if (it_ge2 == m_path.end())
-	{
-		if (interp_method_requires_4pts)
-		{
-			out_valid_interp = false;
-			return out_interp;
-		}
-	}
-	else
-	{
-		p4 = *(it_ge2);  // Fourth pair
-	}
+	if (idx == n || idx == 0) return false;
 
-	p2 = *(--it_ge1);  // Second pair
+	// Pairs 1 and 4 are not used without interp_method_requires_4pts:
+	TTimePosePair none;
+	none.second = out_interp;
 
-	if (it_ge1 == m_path.begin())
-	{
-		if (interp_method_requires_4pts)
-		{
-			out_valid_interp = false;
-			return out_interp;
-		}
-	}
-	else
-	{
-		p1 = *(--it_ge1);  // First pair
-	}
+	const TTimePosePair& p2 = f.poses[idx - 1];  // Second pair
+	const TTimePosePair& p3 = f.poses[idx];	 // Third pair
+	if (interp_method_requires_4pts && (idx + 1 == n || idx == 1))
+		return false;
+	const TTimePosePair& p1 = idx > 1 ? f.poses[idx - 2] : none;
+	const TTimePosePair& p4 = idx + 1 < n ? f.poses[idx + 1] : none;
 
 	// Test if the difference between the desired timestamp and the next
 	// timestamp is lower than a certain (configurable) value
@@ -158,8 +243,7 @@ typename CPoseInterpolatorBase<DIM>::pose_t&
 		(dt12 > maxTimeInterpolation || dt23 > maxTimeInterpolation ||
 		 dt34 > maxTimeInterpolation))
 	{
-		out_valid_interp = false;
-		return out_interp;
+		return false;
 	}
 
 	// Do interpolation:
@@ -172,10 +256,9 @@ typename CPoseInterpolatorBase<DIM>::pose_t&
 
 	impl_interpolation(p1, p2, p3, p4, m_method, t, out_interp);
 
-	out_valid_interp = true;
-	return out_interp;
+	return true;
 
-}  // end interpolate
+}  // end interpolateAt
 
 template <int DIM>
 bool CPoseInterpolatorBase<DIM>::getPreviousPoseWithMinDistance(
@@ -437,5 +520,6 @@ void CPoseInterpolatorBase<DIM>::filter(
 		aux[it1->first] = pose_t(auxPose.asTPose());
 	}  // end for it1
 	m_path = aux;
+	invalidateFlatPath();
 }
 }  // namespace mrpt::poses
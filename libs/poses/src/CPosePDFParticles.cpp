@@ -278,6 +278,28 @@ TPose2D CPosePDFParticles::getParticlePose(size_t i) const
 	return m_particles[i].d;
 }
 
+void CPosePDFParticles::getParticlesSoA(TPoseParticlesSoA2D& out) const
+{
+	const size_t N = m_particles.size();
+	out.resize(N);
+	for (size_t i = 0; i < N; i++)
+	{
+		out.setPose(i, m_particles[i].d);
+		out.log_w[i] = m_particles[i].log_w;
+	}
+}
+
+void CPosePDFParticles::setParticlesSoA(const TPoseParticlesSoA2D& in)
+{
+	const size_t N = in.size();
+	m_particles.resize(N);
+	for (size_t i = 0; i < N; i++)
+	{
+		m_particles[i].d = in.getPose(i);
+		m_particles[i].log_w = in.log_w[i];
+	}
+}
+
 void CPosePDFParticles::changeCoordinatesReference(
 	const CPose3D& newReferenceBase_)
 {
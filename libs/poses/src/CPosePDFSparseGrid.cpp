@@ -0,0 +1,337 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "poses-precomp.h"	// Precompiled headers
+//
+#include <mrpt/math/wrap2pi.h>
+#include <mrpt/poses/CPose3D.h>
+#include <mrpt/poses/CPosePDFGrid.h>
+#include <mrpt/poses/CPosePDFParticles.h>
+#include <mrpt/poses/CPosePDFSparseGrid.h>
+#include <mrpt/poses/SO_SE_average.h>
+#include <mrpt/random.h>
+#include <mrpt/serialization/CArchive.h>
+
+#include <fstream>
+
+using namespace mrpt;
+using namespace mrpt::math;
+using namespace mrpt::poses;
+
+IMPLEMENTS_SERIALIZABLE(CPosePDFSparseGrid, CPosePDF, mrpt::poses)
+
+CPosePDFSparseGrid::CPosePDFSparseGrid(
+	double xMin, double xMax, double yMin, double yMax, double resolutionXY,
+	double resolutionPhi, double phiMin, double phiMax)
+{
+	setSize(xMin, xMax, yMin, yMax, resolutionXY, resolutionPhi, phiMin, phiMax);
+}
+
+CPosePDFSparseGrid::CPosePDFSparseGrid(
+	const CPosePDFGrid& dense, double minValue)
+{
+	setSize(
+		dense.getXMin(), dense.getXMax(), dense.getYMin(), dense.getYMax(),
+		dense.getResolutionXY(), dense.getResolutionPhi(), dense.getPhiMin(),
+		dense.getPhiMax());
+	ASSERT_EQUAL_(m_sizeX, dense.getSizeX());
+	ASSERT_EQUAL_(m_sizeY, dense.getSizeY());
+	ASSERT_EQUAL_(m_sizePhi, dense.getSizePhi());
+
+	for (size_t phi = 0; phi < m_sizePhi; phi++)
+		for (size_t y = 0; y < m_sizeY; y++)
+			for (size_t x = 0; x < m_sizeX; x++)
+			{
+				const double v = *dense.getByIndex(x, y, phi);
+				if (v > minValue) setByIndex(x, y, phi, v);
+			}
+}
+
+void CPosePDFSparseGrid::setSize(
+	double xMin, double xMax, double yMin, double yMax, double resolutionXY,
+	double resolutionPhi, double phiMin, double phiMax)
+{
+	ASSERT_(xMax > xMin);
+	ASSERT_(yMax > yMin);
+	ASSERT_(phiMax >= phiMin);
+	ASSERT_(resolutionXY > 0);
+	ASSERT_(resolutionPhi > 0);
+
+	m_xMin = xMin;
+	m_xMax = xMax;
+	m_yMin = yMin;
+	m_yMax = yMax;
+	m_phiMin = phiMin;
+	m_phiMax = phiMax;
+	m_resolutionXY = resolutionXY;
+	m_resolutionPhi = resolutionPhi;
+
+	// Same number of cells than CPose2DGridTemplate:
+	m_sizeX = mrpt::round(xMax / resolutionXY) -
+		mrpt::round(xMin / resolutionXY) + 1;
+	m_sizeY = mrpt::round(yMax / resolutionXY) -
+		mrpt::round(yMin / resolutionXY) + 1;
+	m_sizePhi = mrpt::round(phiMax / resolutionPhi) -
+		mrpt::round(phiMin / resolutionPhi) + 1;
+
+	m_cells.clear();
+}
+
+void CPosePDFSparseGrid::copyFrom(const CPosePDF& o)
+{
+	if (this == &o) return;
+
+	if (const auto* sg = dynamic_cast<const CPosePDFSparseGrid*>(&o); sg)
+	{
+		*this = *sg;
+		return;
+	}
+	if (const auto* g = dynamic_cast<const CPosePDFGrid*>(&o); g)
+	{
+		*this = CPosePDFSparseGrid(*g);
+		return;
+	}
+	THROW_EXCEPTION("Not implemented yet for this PDF class");
+}
+
+void CPosePDFSparseGrid::normalize(double pruneThreshold)
+{
+	auto& values = m_cells.values();
+	for (int pass = 0; pass < 2; pass++)
+	{
+		double sum = 0;
+		for (const double v : values)
+			sum += v;
+		if (sum <= 0) return;
+
+		const double f = 1.0 / sum;
+		for (double& v : values)
+			v *= f;
+
+		if (pruneThreshold <= 0 || pass == 1) break;
+		if (!prune(pruneThreshold)) break;
+	}
+}
+
+size_t CPosePDFSparseGrid::prune(double threshold)
+{
+	return m_cells.removeIf([threshold](double v) { return v <= threshold; });
+}
+
+void CPosePDFSparseGrid::getMarginalXY(CMatrixDouble& out) const
+{
+	out.setZero(m_sizeY, m_sizeX);
+	forEachCell([&](size_t x, size_t y, size_t, double v) { out(y, x) += v; });
+}
+
+void CPosePDFSparseGrid::getMarginalPhi(std::vector<double>& out) const
+{
+	out.assign(m_sizePhi, 0.0);
+	// phi is the slowest-varying index of keys:
+	const uint64_t xySize = uint64_t(m_sizeX) * m_sizeY;
+	const auto& keys = m_cells.keys();
+	const auto& values = m_cells.values();
+	for (size_t i = 0; i < keys.size(); i++)
+		out[keys[i] / xySize] += values[i];
+}
+
+void CPosePDFSparseGrid::getMean(CPose2D& p) const
+{
+	mrpt::poses::SE_average<2> se_averager;
+	forEachCell([&](size_t x, size_t y, size_t phi, double w) {
+		se_averager.append(TPose2D(idx2x(x), idx2y(y), idx2phi(phi)), w);
+	});
+	se_averager.get_average(p);
+}
+
+std::tuple<CMatrixDouble33, CPose2D> CPosePDFSparseGrid::getCovarianceAndMean()
+	const
+{
+	CPose2D mean;
+	getMean(mean);
+
+	CMatrixDouble33 cov;
+	double sumW = 0;
+	forEachCell([&](size_t x, size_t y, size_t phi, double w) {
+		const double d[3] = {
+			idx2x(x) - mean.x(), idx2y(y) - mean.y(),
+			mrpt::math::wrapToPi(idx2phi(phi) - mean.phi())};
+		for (int r = 0; r < 3; r++)
+			for (int c = r; c < 3; c++)
+				cov(r, c) += w * d[r] * d[c];
+		sumW += w;
+	});
+	if (sumW > 0) cov *= 1.0 / sumW;
+	for (int r = 0; r < 3; r++)
+		for (int c = 0; c < r; c++)
+			cov(r, c) = cov(c, r);
+	return {cov, mean};
+}
+
+void CPosePDFSparseGrid::drawInCell(size_t cellIdx, TPose2D& p) const
+{
+	auto& rng = mrpt::random::getRandomGenerator();
+	size_t x, y, phi;
+	keyToIndices(m_cells.keys()[cellIdx], x, y, phi);
+	const double hXY = 0.5 * m_resolutionXY, hPhi = 0.5 * m_resolutionPhi;
+	p.x = idx2x(x) + rng.drawUniform(-hXY, hXY);
+	p.y = idx2y(y) + rng.drawUniform(-hXY, hXY);
+	p.phi =
+		mrpt::math::wrapToPi(idx2phi(phi) + rng.drawUniform(-hPhi, hPhi));
+}
+
+void CPosePDFSparseGrid::drawSingleSample(CPose2D& outPart) const
+{
+	std::vector<size_t> idxs;
+	m_cells.drawCells(1, false, idxs);
+	TPose2D p;
+	drawInCell(idxs[0], p);
+	outPart = CPose2D(p);
+}
+
+void CPosePDFSparseGrid::drawManySamples(
+	size_t N, std::vector<CVectorDouble>& outSamples) const
+{
+	std::vector<size_t> idxs;
+	m_cells.drawCells(N, false, idxs);
+	outSamples.resize(N);
+	TPose2D p;
+	for (size_t i = 0; i < N; i++)
+	{
+		drawInCell(idxs[i], p);
+		outSamples[i].resize(3);
+		outSamples[i][0] = p.x;
+		outSamples[i][1] = p.y;
+		outSamples[i][2] = p.phi;
+	}
+}
+
+void CPosePDFSparseGrid::getAsParticles(
+	CPosePDFParticles& out, size_t numParticles) const
+{
+	if (!numParticles)
+	{
+		out.resetDeterministic(TPose2D(0, 0, 0), m_cells.size());
+		size_t i = 0;
+		forEachCell([&](size_t x, size_t y, size_t phi, double w) {
+			auto& part = out.m_particles[i++];
+			part.d = TPose2D(idx2x(x), idx2y(y), idx2phi(phi));
+			part.log_w = std::log(w);
+		});
+		return;
+	}
+
+	std::vector<size_t> idxs;
+	m_cells.drawCells(numParticles, true, idxs);
+	out.resetDeterministic(TPose2D(0, 0, 0), numParticles);
+	for (size_t i = 0; i < numParticles; i++)
+	{
+		TPose2D p;
+		drawInCell(idxs[i], p);
+		out.m_particles[i].d = p;
+		out.m_particles[i].log_w = 0;
+	}
+}
+
+void CPosePDFSparseGrid::getAsDenseGrid(CPosePDFGrid& out) const
+{
+	out.setSize(
+		m_xMin, m_xMax, m_yMin, m_yMax, m_resolutionXY, m_resolutionPhi,
+		m_phiMin, m_phiMax);
+	// setSize() zeroes all cells
+	forEachCell([&](size_t x, size_t y, size_t phi, double v) {
+		*out.getByIndex(x, y, phi) = v;
+	});
+}
+
+uint8_t CPosePDFSparseGrid::serializeGetVersion() const { return 0; }
+void CPosePDFSparseGrid::serializeTo(mrpt::serialization::CArchive& out) const
+{
+	out << m_xMin << m_xMax << m_yMin << m_yMax << m_phiMin << m_phiMax
+		<< m_resolutionXY << m_resolutionPhi;
+	m_cells.writeTo(out);
+}
+void CPosePDFSparseGrid::serializeFrom(
+	mrpt::serialization::CArchive& in, uint8_t version)
+{
+	switch (version)
+	{
+		case 0:
+		{
+			double xMin, xMax, yMin, yMax, phiMin, phiMax, resXY, resPhi;
+			in >> xMin >> xMax >> yMin >> yMax >> phiMin >> phiMax >> resXY >>
+				resPhi;
+			setSize(xMin, xMax, yMin, yMax, resXY, resPhi, phiMin, phiMax);
+			m_cells.readFrom(in);
+		}
+		break;
+		default: MRPT_THROW_UNKNOWN_SERIALIZATION_VERSION(version);
+	};
+}
+
+bool CPosePDFSparseGrid::saveToTextFile(const std::string& dataFile) const
+{
+	std::ofstream f(dataFile);
+	if (!f.is_open()) return false;
+
+	f << "% x y phi probability\n";
+	forEachCell([&](size_t x, size_t y, size_t phi, double v) {
+		f << mrpt::format(
+			"%f %f %f %.5e\n", idx2x(x), idx2y(y), idx2phi(phi), v);
+	});
+	return true;
+}
+
+void CPosePDFSparseGrid::changeCoordinatesReference(
+	[[maybe_unused]] const CPose3D& newReferenceBase)
+{
+	THROW_EXCEPTION("Not implemented yet!");
+}
+
+void CPosePDFSparseGrid::bayesianFusion(
+	const CPosePDF& p1_, const CPosePDF& p2_,
+	[[maybe_unused]] const double minMahalanobisDistToDrop)
+{
+	const auto* p1 = dynamic_cast<const CPosePDFSparseGrid*>(&p1_);
+	const auto* p2 = dynamic_cast<const CPosePDFSparseGrid*>(&p2_);
+	ASSERTMSG_(
+		p1 && p2, "Only implemented for two CPosePDFSparseGrid densities");
+	ASSERTMSG_(
+		p1->m_sizeX == p2->m_sizeX && p1->m_sizeY == p2->m_sizeY &&
+			p1->m_sizePhi == p2->m_sizePhi && p1->m_xMin == p2->m_xMin &&
+			p1->m_yMin == p2->m_yMin && p1->m_phiMin == p2->m_phiMin,
+		"Both grids must have the same limits and resolution");
+
+	// Iterate over the smaller one:
+	if (p2->m_cells.size() < p1->m_cells.size()) std::swap(p1, p2);
+
+	std::vector<uint64_t> keys;
+	std::vector<double> values;
+	const auto& k1 = p1->m_cells.keys();
+	const auto& v1 = p1->m_cells.values();
+	for (size_t i = 0; i < k1.size(); i++)
+	{
+		const double* v2 = p2->m_cells.find(k1[i]);
+		if (!v2 || *v2 * v1[i] <= 0) continue;
+		keys.push_back(k1[i]);
+		values.push_back(*v2 * v1[i]);
+	}
+
+	CPosePDFSparseGrid res(
+		p1->m_xMin, p1->m_xMax, p1->m_yMin, p1->m_yMax, p1->m_resolutionXY,
+		p1->m_resolutionPhi, p1->m_phiMin, p1->m_phiMax);
+	res.m_cells.assign(std::move(keys), std::move(values));
+	res.normalize();
+	*this = std::move(res);
+}
+
+void CPosePDFSparseGrid::inverse([[maybe_unused]] CPosePDF& o) const
+{
+	THROW_EXCEPTION("Not implemented yet!");
+}
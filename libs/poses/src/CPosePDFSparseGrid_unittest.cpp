@@ -0,0 +1,133 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <CTraitsTest.h>
+#include <gtest/gtest.h>
+#include <mrpt/io/CMemoryStream.h>
+#include <mrpt/poses/CPosePDFGrid.h>
+#include <mrpt/poses/CPosePDFParticles.h>
+#include <mrpt/poses/CPosePDFSparseGrid.h>
+#include <mrpt/random.h>
+#include <mrpt/serialization/CArchive.h>
+
+using namespace mrpt::poses;
+
+template class mrpt::CTraitsTest<mrpt::poses::CPosePDFSparseGrid>;
+
+TEST(CPosePDFSparseGrid, basicOps)
+{
+	// A large area with a fine angular resolution: 10^6 x 360 cells
+	CPosePDFSparseGrid pg(
+		0, 100.0, 0.0, 100.0, 0.1 /*res xy*/, mrpt::DEG2RAD(1.0) /*res phi*/);
+	EXPECT_GT(pg.getTotalCellCount(), 300'000'000U);
+	EXPECT_EQ(pg.getStoredCellCount(), 0U);
+	EXPECT_EQ(pg.getByPos(1.0, 2.0, 0.7), 0.0);
+
+	pg.setByPos(1.0, 2.0, 0.7, 10.0);
+	pg.setByPos(4.0, 7.0, -0.7, 10.0);
+	pg.setByPos(50.0, 50.0, 0.0, 1e-6);
+	EXPECT_EQ(pg.getStoredCellCount(), 3U);
+	EXPECT_NEAR(pg.getByPos(1.0, 2.0, 0.7), 10.0, 1e-5);
+
+	// Normalize, dropping the unlikely cell:
+	pg.normalize(1e-3);
+	EXPECT_EQ(pg.getStoredCellCount(), 2U);
+	EXPECT_NEAR(pg.getByPos(1.0, 2.0, 0.7), 0.5, 1e-5);
+	EXPECT_NEAR(pg.getByPos(4.0, 7.0, -0.7), 0.5, 1e-5);
+	EXPECT_EQ(pg.getByPos(50.0, 50.0, 0.0), 0.0);
+
+	const auto m = pg.getMeanVal();
+	EXPECT_NEAR(m.x(), 2.5, 1e-4);
+	EXPECT_NEAR(m.y(), 4.5, 1e-4);
+	EXPECT_NEAR(m.phi(), 0.0, 5e-2);
+
+	// Marginals:
+	std::vector<double> mPhi;
+	pg.getMarginalPhi(mPhi);
+	EXPECT_EQ(mPhi.size(), pg.getSizePhi());
+	EXPECT_NEAR(mPhi.at(pg.phi2idx(0.7)), 0.5, 1e-9);
+	EXPECT_NEAR(mPhi.at(pg.phi2idx(-0.7)), 0.5, 1e-9);
+
+	mrpt::math::CMatrixDouble mXY;
+	pg.getMarginalXY(mXY);
+	EXPECT_NEAR(mXY(pg.y2idx(2.0), pg.x2idx(1.0)), 0.5, 1e-9);
+	EXPECT_NEAR(mXY.sum(), 1.0, 1e-9);
+}
+
+TEST(CPosePDFSparseGrid, denseConversionAndParticles)
+{
+	CPosePDFGrid dense(-2.0, 2.0, -1.0, 1.0, 0.25, mrpt::DEG2RAD(10.0));
+	for (size_t phi = 0; phi < dense.getSizePhi(); phi++)
+		for (size_t y = 0; y < dense.getSizeY(); y++)
+			for (size_t x = 0; x < dense.getSizeX(); x++)
+				*dense.getByIndex(x, y, phi) = 0;
+	*dense.getByPos(0.5, 0.5, 0.2) = 3.0;
+	*dense.getByPos(-1.0, 0.0, -0.5) = 1.0;
+
+	CPosePDFSparseGrid sg(dense);
+	EXPECT_EQ(sg.getStoredCellCount(), 2U);
+	sg.normalize();
+	EXPECT_NEAR(sg.getByPos(0.5, 0.5, 0.2), 0.75, 1e-9);
+
+	CPosePDFGrid dense2;
+	sg.getAsDenseGrid(dense2);
+	EXPECT_NEAR(*dense2.getByPos(0.5, 0.5, 0.2), 0.75, 1e-9);
+	EXPECT_NEAR(*dense2.getByPos(-1.0, 0.0, -0.5), 0.25, 1e-9);
+	EXPECT_EQ(*dense2.getByPos(1.0, 1.0, 0.0), 0.0);
+
+	// One particle per cell:
+	CPosePDFParticles parts;
+	sg.getAsParticles(parts);
+	EXPECT_EQ(parts.size(), 2U);
+
+	// Sampled particles:
+	mrpt::random::getRandomGenerator().randomize(1234);
+	sg.getAsParticles(parts, 1000);
+	ASSERT_EQ(parts.size(), 1000U);
+	size_t nFirst = 0;
+	for (const auto& p : parts.m_particles)
+	{
+		if (std::abs(p.d.x - 0.5) <= 0.125 + 1e-9 &&
+			std::abs(p.d.y - 0.5) <= 0.125 + 1e-9)
+			nFirst++;
+	}
+	EXPECT_NEAR(nFirst, 750U, 2U);
+}
+
+TEST(CPosePDFSparseGrid, serialization)
+{
+	CPosePDFSparseGrid pg(0, 10.0, 0.0, 20.0, 0.5, 0.1);
+	pg.setByPos(1.0, 2.0, 0.7, 0.25);
+	pg.setByPos(4.0, 7.0, -0.7, 0.75);
+
+	mrpt::io::CMemoryStream buf;
+	auto arch = mrpt::serialization::archiveFrom(buf);
+	arch << pg;
+	buf.Seek(0);
+	CPosePDFSparseGrid pg2;
+	arch >> pg2;
+
+	EXPECT_EQ(pg2.getStoredCellCount(), 2U);
+	EXPECT_EQ(pg2.getSizeX(), pg.getSizeX());
+	EXPECT_NEAR(pg2.getByPos(1.0, 2.0, 0.7), 0.25, 1e-12);
+	EXPECT_NEAR(pg2.getByPos(4.0, 7.0, -0.7), 0.75, 1e-12);
+}
+
+TEST(CPosePDFSparseGrid, bayesianFusion)
+{
+	CPosePDFSparseGrid p1(0, 10.0, 0.0, 10.0, 0.5, 0.1), p2 = p1, res;
+	p1.setByPos(1.0, 1.0, 0.0, 0.5);
+	p1.setByPos(2.0, 2.0, 0.0, 0.5);
+	p2.setByPos(2.0, 2.0, 0.0, 0.2);
+	p2.setByPos(3.0, 3.0, 0.0, 0.8);
+
+	res.bayesianFusion(p1, p2);
+	EXPECT_EQ(res.getStoredCellCount(), 1U);
+	EXPECT_NEAR(res.getByPos(2.0, 2.0, 0.0), 1.0, 1e-9);
+}
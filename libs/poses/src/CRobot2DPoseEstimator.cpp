@@ -17,6 +17,7 @@
 
 #include <iostream>
 #include <mutex>
+#include <thread>
 
 using namespace mrpt;
 using namespace mrpt::poses;
@@ -24,10 +25,26 @@ using namespace mrpt::math;
 using namespace mrpt::system;
 using namespace std;
 
+namespace
+{
+// last_loc (+) [ last_odo (-) odo_ref ]
+template <class STATE>
+TPose2D fusedPose(const STATE& s)
+{
+	return (CPose2D(s.last_loc) +
+			(CPose2D(s.last_odo) - CPose2D(s.loc_odo_ref)))
+		.asTPose();
+}
+}  // namespace
+
 /* --------------------------------------------------------
 				Ctor
    -------------------------------------------------------- */
-CRobot2DPoseEstimator::CRobot2DPoseEstimator() { reset(); }
+CRobot2DPoseEstimator::CRobot2DPoseEstimator(size_t historyLength)
+	: m_history(historyLength)
+{
+	reset();
+}
 /* --------------------------------------------------------
 				Dtor
    -------------------------------------------------------- */
@@ -38,15 +55,85 @@ CRobot2DPoseEstimator::~CRobot2DPoseEstimator() = default;
 void CRobot2DPoseEstimator::reset()
 {
 	std::lock_guard<std::mutex> lock(m_cs);
+	publishState(TState(), Clock::time_point());
+}
+
+CRobot2DPoseEstimator::TState CRobot2DPoseEstimator::readState() const
+{
+	for (;;)
+	{
+		const uint64_t seq0 = m_seq.load(std::memory_order_acquire);
+		if (seq0 & 1)
+		{
+			std::this_thread::yield();
+			continue;
+		}
+		// May be torn by a concurrent update, then discarded below:
+		const TState s = m_state;
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (m_seq.load(std::memory_order_relaxed) == seq0) return s;
+	}
+}
+
+void CRobot2DPoseEstimator::publishState(
+	const TState& newState, Clock::time_point entryTime)
+{
+	TState s = newState;
+	const size_t cap = m_history.size();
+	size_t n = s.hist_size, start = s.hist_start;
+	const auto at = [&](size_t k) -> TTimedEstimate& {
+		return m_history[(start + k) % cap];
+	};
+
+	// New history entry, only if there is both localization and odometry:
+	TTimedEstimate e;
+	size_t pos = 0;
+	bool addEntry = cap > 0 && s.last_loc_time && s.last_odo_time;
+	bool replace = false;
+	if (addEntry)
+	{
+		e.time = entryTime;
+		extrapolateRobotPose(
+			fusedPose(s), s.robot_vel_local,
+			timeDifference(s.last_odo_time.value(), entryTime), e.pose);
+		e.velLocal = s.robot_vel_local;
 
-	m_last_loc_time.reset();
-	m_last_odo_time.reset();
+		// Sorted position of the new entry (usually, the end):
+		pos = n;
+		while (pos > 0 && at(pos - 1).time > e.time)
+			pos--;
+		replace = pos > 0 && at(pos - 1).time == e.time;
+		// Older than all of them?
+		if (!replace && n == cap && pos == 0) addEntry = false;
+	}
+
+	const uint64_t seq = m_seq.load(std::memory_order_relaxed);
+	m_seq.store(seq + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
 
-	m_last_loc = TPose2D(0, 0, 0);
-	m_loc_odo_ref = TPose2D(0, 0, 0);
-	m_last_odo = TPose2D(0, 0, 0);
+	if (addEntry)
+	{
+		if (replace) at(pos - 1) = e;
+		else
+		{
+			if (n == cap)
+			{
+				// Drop the oldest one:
+				start = (start + 1) % cap;
+				n--;
+				pos--;
+			}
+			for (size_t k = n; k > pos; k--)
+				at(k) = at(k - 1);
+			at(pos) = e;
+			n++;
+		}
+	}
+	s.hist_start = start;
+	s.hist_size = n;
+	m_state = s;
 
-	m_robot_vel_local = TTwist2D(.0, .0, .0);
+	m_seq.store(seq + 2, std::memory_order_release);
 }
 
 /** Updates the filter so the pose is tracked to the current time */
@@ -54,17 +141,20 @@ void CRobot2DPoseEstimator::processUpdateNewPoseLocalization(
 	const TPose2D& newPose, Clock::time_point cur_tim)
 {
 	std::lock_guard<std::mutex> lock(m_cs);
+	TState s = m_state;
 
 	// Overwrite old localization data:
-	m_last_loc_time = cur_tim;
-	m_last_loc = newPose;
+	s.last_loc_time = cur_tim;
+	s.last_loc = newPose;
 
 	// And create interpolated odometry data to work as "reference pose":
-	if (m_last_odo_time)
+	if (s.last_odo_time)
 	{
-		const double dT = timeDifference(m_last_odo_time.value(), cur_tim);
-		extrapolateRobotPose(m_last_odo, m_robot_vel_local, dT, m_loc_odo_ref);
+		const double dT = timeDifference(s.last_odo_time.value(), cur_tim);
+		extrapolateRobotPose(
+			s.last_odo, s.robot_vel_local, dT, s.loc_odo_ref);
 	}
+	publishState(s, cur_tim);
 }
 
 /** Updates the filter so the pose is tracked to the current time */
@@ -75,10 +165,11 @@ void CRobot2DPoseEstimator::processUpdateNewOdometry(
 	MRPT_START
 
 	std::lock_guard<std::mutex> lock(m_cs);
+	TState s = m_state;
 
-	if (m_last_odo_time)
+	if (s.last_odo_time)
 	{
-		const double dT = timeDifference(m_last_odo_time.value(), cur_tim);
+		const double dT = timeDifference(s.last_odo_time.value(), cur_tim);
 		if (dT <= 0)
 			std::cerr << "[CRobot2DPoseEstimator::processUpdateNewOdometry] "
 						 "WARNING: Diff. in timestamps between odometry should "
@@ -87,19 +178,20 @@ void CRobot2DPoseEstimator::processUpdateNewOdometry(
 	}
 
 	// First, update velocities:
-	if (hasVelocities) { m_robot_vel_local = velLocal; }
+	if (hasVelocities) { s.robot_vel_local = velLocal; }
 	else
 	{  // Note: JLBC 23/Nov/2016: I have removed an estimation of velocity from
 		// increments of odometry
 		// because it was really bad. Just don't make up things: if the user
 		// doesn't provide us velocities,
 		// we don't use velocities.
-		m_robot_vel_local = TTwist2D(.0, .0, .0);
+		s.robot_vel_local = TTwist2D(.0, .0, .0);
 	}
 
 	// And now times & odo:
-	m_last_odo_time = cur_tim;
-	m_last_odo = newGlobalOdometry;
+	s.last_odo_time = cur_tim;
+	s.last_odo = newGlobalOdometry;
+	publishState(s, cur_tim);
 
 	MRPT_END
 }
@@ -108,57 +200,131 @@ bool CRobot2DPoseEstimator::getCurrentEstimate(
 	mrpt::math::TPose2D& pose, mrpt::math::TTwist2D& velLocal,
 	mrpt::math::TTwist2D& velGlobal, mrpt::Clock::time_point tim_query) const
 {
-	if (!m_last_odo_time || !m_last_loc_time) return false;
+	const TState s = readState();
+	if (!s.last_odo_time || !s.last_loc_time) return false;
 
-	const double dTimeLoc = timeDifference(m_last_loc_time.value(), tim_query);
+	const double dTimeLoc = timeDifference(s.last_loc_time.value(), tim_query);
 	if (dTimeLoc > params.max_localiz_age) return false;
 
 	//  Overall estimate:
 	// last_loc (+) [ last_odo (-) odo_ref ] (+) extrapolation_from_vw
-	const TPose2D p =
-		(CPose2D(m_last_loc) + (CPose2D(m_last_odo) - CPose2D(m_loc_odo_ref)))
-			.asTPose();
+	const TPose2D p = fusedPose(s);
 
 	// Add the extrapolation:
-	const double dTimeOdo = timeDifference(m_last_odo_time.value(), tim_query);
+	const double dTimeOdo = timeDifference(s.last_odo_time.value(), tim_query);
 	if (dTimeOdo > params.max_odometry_age) return false;
 
-	extrapolateRobotPose(p, m_robot_vel_local, dTimeOdo, pose);
+	extrapolateRobotPose(p, s.robot_vel_local, dTimeOdo, pose);
 
 	// Constant speed model:
-	velLocal = m_robot_vel_local;
+	velLocal = s.robot_vel_local;
 	velGlobal = velLocal;
 	velGlobal.rotate(pose.phi);
 
 	return true;
 }
 
+bool CRobot2DPoseEstimator::getEstimateAt(
+	mrpt::Clock::time_point t, mrpt::math::TPose2D& pose,
+	mrpt::math::TTwist2D& velLocal) const
+{
+	const size_t cap = m_history.size();
+	TTimedEstimate a, b;
+	enum
+	{
+		BEFORE,
+		BETWEEN,
+		AFTER
+	} where;
+
+	for (;;)
+	{
+		const uint64_t seq0 = m_seq.load(std::memory_order_acquire);
+		if (seq0 & 1)
+		{
+			std::this_thread::yield();
+			continue;
+		}
+		const size_t start = m_state.hist_start, n = m_state.hist_size;
+		// Only the ranges are checked here: the data may be torn by a
+		// concurrent update, and then it is discarded below.
+		where = AFTER;
+		if (start < cap && n > 0 && n <= cap)
+		{
+			const auto at = [&](size_t k) -> const TTimedEstimate& {
+				return m_history[(start + k) % cap];
+			};
+			// First entry with time >= t:
+			size_t lo = 0, hi = n;
+			while (lo < hi)
+			{
+				const size_t mid = (lo + hi) / 2;
+				if (at(mid).time < t) lo = mid + 1;
+				else
+					hi = mid;
+			}
+			if (lo < n && at(lo).time == t)
+			{
+				a = b = at(lo);
+				where = BETWEEN;
+			}
+			else if (lo == 0)
+				where = BEFORE;
+			else if (lo < n)
+			{
+				a = at(lo - 1);
+				b = at(lo);
+				where = BETWEEN;
+			}
+		}
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (m_seq.load(std::memory_order_relaxed) == seq0) break;
+	}
+
+	if (where == BEFORE) return false;
+	if (where == AFTER)
+	{
+		mrpt::math::TTwist2D velGlobal;
+		return getCurrentEstimate(pose, velLocal, velGlobal, t);
+	}
+
+	const double dt = timeDifference(a.time, b.time);
+	const double r = dt > 0 ? timeDifference(a.time, t) / dt : 0.0;
+	pose.x = a.pose.x + r * (b.pose.x - a.pose.x);
+	pose.y = a.pose.y + r * (b.pose.y - a.pose.y);
+	pose.phi = mrpt::math::wrapToPi(
+		a.pose.phi + r * mrpt::math::wrapToPi(b.pose.phi - a.pose.phi));
+	velLocal.vx = a.velLocal.vx + r * (b.velLocal.vx - a.velLocal.vx);
+	velLocal.vy = a.velLocal.vy + r * (b.velLocal.vy - a.velLocal.vy);
+	velLocal.omega =
+		a.velLocal.omega + r * (b.velLocal.omega - a.velLocal.omega);
+	return true;
+}
+
 /** get the current estimate
  * \return true is the estimate can be trusted. False if the real observed data
  * is too old.
  */
 bool CRobot2DPoseEstimator::getLatestRobotPose(TPose2D& pose) const
 {
-	if (!m_last_odo_time && !m_last_loc_time)
+	const TState s = readState();
+	if (!s.last_odo_time && !s.last_loc_time)
 	{
 		pose = TPose2D(0, 0, 0);
 		return false;
 	}
 
 	bool ret_odo;
-	if (m_last_odo_time && m_last_loc_time)
-		ret_odo = (m_last_odo_time.value() > m_last_loc_time.value());
-	else if (m_last_odo_time)
+	if (s.last_odo_time && s.last_loc_time)
+		ret_odo = (s.last_odo_time.value() > s.last_loc_time.value());
+	else if (s.last_odo_time)
 		ret_odo = true;
 	else
 		ret_odo = false;
 
-	if (ret_odo)
-		pose = (CPose2D(m_last_loc) +
-				(CPose2D(m_last_odo) - CPose2D(m_loc_odo_ref)))
-				   .asTPose();
+	if (ret_odo) pose = fusedPose(s);
 	else
-		pose = m_last_loc;
+		pose = s.last_loc;
 
 	return true;
 }
@@ -173,8 +339,9 @@ void CRobot2DPoseEstimator::extrapolateRobotPose(
 	{  // Still
 		new_p = p;
 	}
-	else if (std::abs(velLocal.vy) > 1e-2)
-	{  // non-Ackermann-like vehicle: extrapolate as a straight line:
+	else if (std::abs(velLocal.vy) > 1e-2 || velLocal.omega == 0)
+	{  // non-Ackermann-like vehicle, or no rotation: extrapolate as a straight
+		// line:
 		const TPoint2D dp =
 			TPoint2D(delta_time * velLocal.vx, delta_time * velLocal.vy);
 		TPoint2D pg;
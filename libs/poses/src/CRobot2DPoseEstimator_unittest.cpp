@@ -11,6 +11,11 @@
 #include <mrpt/poses/CRobot2DPoseEstimator.h>
 #include <mrpt/system/datetime.h>
 
+#include <atomic>
+#include <cmath>
+#include <thread>
+#include <vector>
+
 TEST(CRobot2DPoseEstimator, defaultCtor)
 {
 	mrpt::poses::CRobot2DPoseEstimator rpe;
@@ -94,3 +99,97 @@ TEST(CRobot2DPoseEstimator, integrateOdometryAndLocalization)
 	ok = rpe.getCurrentEstimate(p, vl, vg, t1);
 	EXPECT_FALSE(ok);
 }
+
+TEST(CRobot2DPoseEstimator, getEstimateAt)
+{
+	const mrpt::math::TTwist2D vel = {1.0, 0.0, 0.0};
+	mrpt::poses::CRobot2DPoseEstimator rpe(4);
+	EXPECT_EQ(rpe.getHistoryLength(), 4U);
+	rpe.params.max_localiz_age = 10.0;
+	rpe.params.max_odometry_age = 10.0;
+
+	const auto t0 = mrpt::Clock::now();
+	const auto t = [&](double dt) {
+		return mrpt::system::timestampAdd(t0, dt);
+	};
+
+	mrpt::math::TPose2D p;
+	mrpt::math::TTwist2D vl;
+	EXPECT_FALSE(rpe.getEstimateAt(t0, p, vl));
+
+	// Localization at the odometry origin, then straight motion along +X:
+	rpe.processUpdateNewOdometry({0, 0, 0}, t(0), true, vel);
+	rpe.processUpdateNewPoseLocalization({5.0, 0, 0}, t(0));
+	for (int i = 1; i <= 5; i++)
+		rpe.processUpdateNewOdometry({double(i), 0, 0}, t(i), true, vel);
+
+	// Only the last 4 estimates are kept (t=2..5):
+	EXPECT_FALSE(rpe.getEstimateAt(t(0.5), p, vl));
+	EXPECT_FALSE(rpe.getEstimateAt(t(1.5), p, vl));
+
+	ASSERT_TRUE(rpe.getEstimateAt(t(2.0), p, vl));
+	EXPECT_NEAR(p.x, 7.0, 1e-6);
+
+	ASSERT_TRUE(rpe.getEstimateAt(t(3.25), p, vl));
+	EXPECT_NEAR(p.x, 8.25, 1e-6);
+	EXPECT_NEAR(p.y, 0.0, 1e-6);
+	EXPECT_NEAR(vl.vx, 1.0, 1e-6);
+
+	// Later than the last update: extrapolated
+	ASSERT_TRUE(rpe.getEstimateAt(t(6.0), p, vl));
+	EXPECT_NEAR(p.x, 11.0, 1e-6);
+
+	// Out of order (older) updates are inserted sorted by time:
+	rpe.processUpdateNewPoseLocalization({20.0, 0, 0}, t(4.5));
+	ASSERT_TRUE(rpe.getEstimateAt(t(4.5), p, vl));
+	EXPECT_NEAR(p.x, 20.0, 1e-6);
+
+	rpe.reset();
+	EXPECT_FALSE(rpe.getEstimateAt(t(3.0), p, vl));
+}
+
+TEST(CRobot2DPoseEstimator, concurrentQueries)
+{
+	mrpt::poses::CRobot2DPoseEstimator rpe(64);
+	rpe.params.max_localiz_age = 1e6;
+	rpe.params.max_odometry_age = 1e6;
+
+	const auto t0 = mrpt::Clock::now();
+	rpe.processUpdateNewOdometry({0, 0, 0}, t0);
+	rpe.processUpdateNewPoseLocalization({0, 0, 0}, t0);
+
+	// The writer always publishes poses with y=2x, so any torn read would
+	// break that relation:
+	std::atomic_bool done{false};
+	std::atomic_int errors{0};
+	std::vector<std::thread> readers;
+	for (int r = 0; r < 3; r++)
+		readers.emplace_back([&]() {
+			mrpt::math::TPose2D p;
+			mrpt::math::TTwist2D vl, vg;
+			while (!done)
+			{
+				if (rpe.getLatestRobotPose(p) &&
+					std::abs(p.y - 2 * p.x) > 1e-9)
+					errors++;
+				if (rpe.getCurrentEstimate(p, vl, vg) &&
+					std::abs(p.y - 2 * p.x) > 1e-9)
+					errors++;
+				if (rpe.getEstimateAt(
+						mrpt::system::timestampAdd(t0, 1e-3), p, vl) &&
+					std::abs(p.y - 2 * p.x) > 1e-6)
+					errors++;
+			}
+		});
+
+	for (int i = 1; i <= 20000; i++)
+	{
+		const double x = i * 1e-3;
+		rpe.processUpdateNewOdometry(
+			{x, 2 * x, 0}, mrpt::system::timestampAdd(t0, i * 1e-5));
+	}
+	done = true;
+	for (auto& th : readers)
+		th.join();
+	EXPECT_EQ(errors, 0);
+}
@@ -0,0 +1,579 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "poses-precomp.h"	// Precompiled headers
+//
+#include <mrpt/core/WorkerThreadsPool.h>
+#include <mrpt/io/CFileOutputStream.h>
+#include <mrpt/io/CMemoryMappedFile.h>
+#include <mrpt/io/zip.h>
+#include <mrpt/poses/CTrajectoryMappedFile.h>
+
+#include <algorithm>
+#include <cstring>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace mrpt::poses;
+using mrpt::math::TPose3D;
+
+namespace
+{
+constexpr char FILE_MAGIC[8] = {'M', 'R', 'P', 'T', 'T', 'R', 'J', '\0'};
+constexpr uint32_t FILE_VERSION = 1;
+constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+/** x, y, z, yaw, pitch, roll, as in TPose3D::operator[] */
+constexpr size_t NUM_COLUMNS = 6;
+constexpr size_t MAX_CACHED_BLOCKS = 8;
+
+enum TCodec : uint32_t
+{
+	codecNone = 0,
+	codecZlib = 1
+};
+
+/** The first bytes of the file */
+struct FileHeader
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t byteOrder;
+	/** Bytes of each pose value: 4 (float) or 8 (double) */
+	uint32_t valueSize;
+	uint32_t reserved;
+	uint64_t numPoses;
+	uint64_t numBlocks;
+	/** Position of the array of BlockIndexEntry, after the blocks */
+	uint64_t indexOffset;
+};
+
+/** Time range and location of each block in the file. The (uncompressed)
+ * block holds the origin of positions (3 doubles), the deltas of the
+ * timestamps from tFirst (numPoses-1 LEB128 varints) and the 6 columns of
+ * numPoses values, each one byte-shuffled (byte 0 of all values, then byte
+ * 1, etc.), which makes them more compressible. */
+struct BlockIndexEntry
+{
+	/** Timestamps of the first and last poses (Clock ticks) */
+	int64_t tFirst, tLast;
+	uint64_t offset, storedSize, rawSize;
+	uint32_t numPoses;
+	uint32_t codec;
+};
+
+static_assert(sizeof(FileHeader) == 48, "Unexpected padding");
+static_assert(sizeof(BlockIndexEntry) == 48, "Unexpected padding");
+
+using TTimedPose = std::pair<int64_t, TPose3D>;
+
+struct TEncodedBlock
+{
+	BlockIndexEntry entry;
+	std::vector<uint8_t> data;
+};
+
+struct TDecodedBlock
+{
+	std::vector<mrpt::Clock::time_point> t;
+	std::vector<TPose3D> p;
+};
+
+void putVarint(std::vector<uint8_t>& b, uint64_t v)
+{
+	while (v >= 0x80)
+	{
+		b.push_back(static_cast<uint8_t>(v | 0x80));
+		v >>= 7;
+	}
+	b.push_back(static_cast<uint8_t>(v));
+}
+
+uint64_t getVarint(const uint8_t*& p, const uint8_t* end)
+{
+	uint64_t v = 0;
+	for (unsigned int shift = 0; shift < 64; shift += 7)
+	{
+		ASSERTMSG_(p < end, "Corrupted trajectory file block");
+		const uint8_t byte = *p++;
+		v |= static_cast<uint64_t>(byte & 0x7f) << shift;
+		if (!(byte & 0x80)) return v;
+	}
+	THROW_EXCEPTION("Corrupted trajectory file block");
+}
+
+template <typename T>
+void putColumn(
+	std::vector<uint8_t>& b, const TTimedPose* poses, size_t n, size_t c,
+	double origin)
+{
+	const size_t base = b.size();
+	b.resize(base + n * sizeof(T));
+	for (size_t i = 0; i < n; i++)
+	{
+		const T v = static_cast<T>(poses[i].second[c] - origin);
+		uint8_t bytes[sizeof(T)];
+		std::memcpy(bytes, &v, sizeof(T));
+		for (size_t k = 0; k < sizeof(T); k++)
+			b[base + k * n + i] = bytes[k];
+	}
+}
+
+template <typename T>
+void getColumn(
+	const uint8_t* src, size_t n, size_t c, double origin,
+	std::vector<TPose3D>& out)
+{
+	for (size_t i = 0; i < n; i++)
+	{
+		uint8_t bytes[sizeof(T)];
+		for (size_t k = 0; k < sizeof(T); k++)
+			bytes[k] = src[k * n + i];
+		T v;
+		std::memcpy(&v, bytes, sizeof(T));
+		out[i][c] = static_cast<double>(v) + origin;
+	}
+}
+
+TEncodedBlock encodeBlock(
+	const TTimedPose* poses, size_t n, bool doublePrecision, bool compress)
+{
+	TEncodedBlock ret;
+	auto& e = ret.entry;
+	std::memset(&e, 0, sizeof(e));
+	e.tFirst = poses[0].first;
+	e.tLast = poses[n - 1].first;
+	e.numPoses = static_cast<uint32_t>(n);
+
+	// Float positions are relative to the first one, to keep their precision:
+	double origin[3] = {0, 0, 0};
+	if (!doublePrecision)
+	{
+		origin[0] = poses[0].second.x;
+		origin[1] = poses[0].second.y;
+		origin[2] = poses[0].second.z;
+	}
+
+	std::vector<uint8_t> raw(sizeof(origin));
+	std::memcpy(raw.data(), origin, sizeof(origin));
+	raw.reserve(
+		raw.size() + n * (2 + NUM_COLUMNS * (doublePrecision ? 8 : 4)));
+	for (size_t i = 1; i < n; i++)
+		putVarint(
+			raw, static_cast<uint64_t>(poses[i].first - poses[i - 1].first));
+	for (size_t c = 0; c < NUM_COLUMNS; c++)
+	{
+		const double o = c < 3 ? origin[c] : .0;
+		if (doublePrecision) putColumn<double>(raw, poses, n, c, o);
+		else
+			putColumn<float>(raw, poses, n, c, o);
+	}
+	e.rawSize = raw.size();
+
+	if (compress)
+	{
+		mrpt::io::zip::compress(raw.data(), raw.size(), ret.data);
+		if (ret.data.size() < raw.size()) e.codec = codecZlib;
+	}
+	if (e.codec == codecNone) ret.data = std::move(raw);
+	e.storedSize = ret.data.size();
+	return ret;
+}
+}  // namespace
+
+struct CTrajectoryMappedFile::Impl
+{
+	mrpt::io::CMemoryMappedFile file;
+	FileHeader header{};
+	const BlockIndexEntry* index = nullptr;
+
+	/** The latest decoded blocks, most recent first */
+	std::list<std::pair<size_t, std::shared_ptr<const TDecodedBlock>>> cache;
+	std::mutex cacheMtx;
+
+	size_t numBlocks() const
+	{
+		return index ? static_cast<size_t>(header.numBlocks) : 0;
+	}
+
+	/** The first block whose last pose is at or after t, or numBlocks() */
+	size_t findBlock(const mrpt::Clock::time_point& t) const
+	{
+		const int64_t ticks = t.time_since_epoch().count();
+		return static_cast<size_t>(
+			std::lower_bound(
+				index, index + numBlocks(), ticks,
+				[](const BlockIndexEntry& e, int64_t v) {
+					return e.tLast < v;
+				}) -
+			index);
+	}
+
+	std::shared_ptr<const TDecodedBlock> block(size_t i)
+	{
+		{
+			std::lock_guard<std::mutex> lck(cacheMtx);
+			for (auto it = cache.begin(); it != cache.end(); ++it)
+			{
+				if (it->first != i) continue;
+				cache.splice(cache.begin(), cache, it);
+				return it->second;
+			}
+		}
+		// Decoded without holding the lock:
+		auto b = decode(i);
+		std::lock_guard<std::mutex> lck(cacheMtx);
+		cache.emplace_front(i, b);
+		if (cache.size() > MAX_CACHED_BLOCKS) cache.pop_back();
+		return b;
+	}
+
+	std::shared_ptr<const TDecodedBlock> decode(size_t i) const
+	{
+		const BlockIndexEntry& e = index[i];
+		const uint8_t* p = file.data() + e.offset;
+
+		std::vector<uint8_t> raw;
+		if (e.codec == codecZlib)
+		{
+			raw.resize(static_cast<size_t>(e.rawSize));
+			size_t actualSize = 0;
+			mrpt::io::zip::decompress(
+				const_cast<uint8_t*>(p), static_cast<size_t>(e.storedSize),
+				raw.data(), raw.size(), actualSize);
+			ASSERTMSG_(
+				actualSize == raw.size(), "Corrupted trajectory file block");
+			p = raw.data();
+		}
+		const uint8_t* end = p + e.rawSize;
+		const size_t n = e.numPoses, valueSize = header.valueSize;
+
+		double origin[3];
+		std::memcpy(origin, p, sizeof(origin));
+		p += sizeof(origin);
+
+		auto b = std::make_shared<TDecodedBlock>();
+		b->t.resize(n);
+		b->p.resize(n);
+		int64_t t = e.tFirst;
+		for (size_t k = 0; k < n; k++)
+		{
+			if (k > 0) t += static_cast<int64_t>(getVarint(p, end));
+			b->t[k] = mrpt::Clock::time_point(mrpt::Clock::duration(t));
+		}
+		ASSERTMSG_(
+			t == e.tLast && end - p == static_cast<std::ptrdiff_t>(
+										  NUM_COLUMNS * n * valueSize),
+			"Corrupted trajectory file block");
+
+		for (size_t c = 0; c < NUM_COLUMNS; c++)
+		{
+			const double o = c < 3 ? origin[c] : .0;
+			if (valueSize == sizeof(double))
+				getColumn<double>(p, n, c, o, b->p);
+			else
+				getColumn<float>(p, n, c, o, b->p);
+			p += n * valueSize;
+		}
+		return b;
+	}
+
+	void reset()
+	{
+		file.close();
+		header = FileHeader();
+		index = nullptr;
+		std::lock_guard<std::mutex> lck(cacheMtx);
+		cache.clear();
+	}
+};
+
+CTrajectoryMappedFile::CTrajectoryMappedFile()
+	: m_impl(std::make_unique<Impl>())
+{
+}
+
+CTrajectoryMappedFile::CTrajectoryMappedFile(const std::string& fileName)
+	: CTrajectoryMappedFile()
+{
+	open(fileName);
+}
+
+CTrajectoryMappedFile::~CTrajectoryMappedFile() = default;
+
+void CTrajectoryMappedFile::open(const std::string& fileName)
+{
+	close();
+	auto& m = *m_impl;
+	try
+	{
+		m.file.open(fileName);
+		const uint64_t fileSize = m.file.size();
+
+		FileHeader& h = m.header;
+		ASSERTMSG_(
+			fileSize >= sizeof(h), "Trajectory file too short: " + fileName);
+		std::memcpy(&h, m.file.data(), sizeof(h));
+		ASSERTMSG_(
+			std::memcmp(h.magic, FILE_MAGIC, sizeof(FILE_MAGIC)) == 0,
+			"Not a trajectory file: " + fileName);
+		ASSERTMSG_(
+			h.version == FILE_VERSION,
+			mrpt::format(
+				"Unsupported trajectory file version: %u",
+				static_cast<unsigned int>(h.version)));
+		ASSERTMSG_(
+			h.byteOrder == BYTE_ORDER_MARK,
+			"Trajectory file written with a different byte order: " +
+				fileName);
+		ASSERTMSG_(
+			(h.valueSize == sizeof(float) || h.valueSize == sizeof(double)) &&
+				h.indexOffset % alignof(BlockIndexEntry) == 0 &&
+				h.indexOffset >= sizeof(h) &&
+				h.indexOffset + h.numBlocks * sizeof(BlockIndexEntry) ==
+					fileSize,
+			"Corrupted trajectory file: " + fileName);
+
+		// Check the index once, so queries can trust it:
+		const auto* index = reinterpret_cast<const BlockIndexEntry*>(
+			m.file.data() + h.indexOffset);
+		uint64_t numPoses = 0;
+		for (size_t i = 0; i < h.numBlocks; i++)
+		{
+			const auto& e = index[i];
+			const bool ok = e.numPoses > 0 && e.tFirst <= e.tLast &&
+				(i == 0 || index[i - 1].tLast < e.tFirst) &&
+				e.offset >= sizeof(h) &&
+				e.offset + e.storedSize <= h.indexOffset &&
+				(e.codec == codecZlib ||
+				 (e.codec == codecNone && e.storedSize == e.rawSize)) &&
+				e.rawSize >= 3 * sizeof(double) +
+						NUM_COLUMNS * e.numPoses * h.valueSize;
+			ASSERTMSG_(ok, "Corrupted trajectory file: " + fileName);
+			numPoses += e.numPoses;
+		}
+		ASSERTMSG_(
+			numPoses == h.numPoses, "Corrupted trajectory file: " + fileName);
+		m.index = index;
+	}
+	catch (...)
+	{
+		m.reset();
+		throw;
+	}
+}
+
+bool CTrajectoryMappedFile::isOpen() const
+{
+	return m_impl->index != nullptr;
+}
+
+void CTrajectoryMappedFile::close() { m_impl->reset(); }
+
+size_t CTrajectoryMappedFile::size() const
+{
+	return isOpen() ? static_cast<size_t>(m_impl->header.numPoses) : 0;
+}
+
+size_t CTrajectoryMappedFile::blockCount() const
+{
+	return m_impl->numBlocks();
+}
+
+bool CTrajectoryMappedFile::isDoublePrecision() const
+{
+	return m_impl->header.valueSize == sizeof(double);
+}
+
+mrpt::Clock::time_point CTrajectoryMappedFile::startTime() const
+{
+	ASSERTMSG_(!empty(), "Empty or not open trajectory file");
+	return mrpt::Clock::time_point(
+		mrpt::Clock::duration(m_impl->index[0].tFirst));
+}
+
+mrpt::Clock::time_point CTrajectoryMappedFile::endTime() const
+{
+	ASSERTMSG_(!empty(), "Empty or not open trajectory file");
+	return mrpt::Clock::time_point(
+		mrpt::Clock::duration(m_impl->index[blockCount() - 1].tLast));
+}
+
+void CTrajectoryMappedFile::forEachPose(
+	const mrpt::Clock::time_point& t0, const mrpt::Clock::time_point& t1,
+	const std::function<void(
+		const mrpt::Clock::time_point&, const mrpt::math::TPose3D&)>& fn) const
+{
+	auto& m = *m_impl;
+	const size_t nBlocks = m.numBlocks();
+	const int64_t ticks1 = t1.time_since_epoch().count();
+	for (size_t b = m.findBlock(t0); b < nBlocks && m.index[b].tFirst <= ticks1;
+		 b++)
+	{
+		const auto blk = m.block(b);
+		for (size_t k = std::lower_bound(blk->t.begin(), blk->t.end(), t0) -
+				 blk->t.begin();
+			 k < blk->t.size() && blk->t[k] <= t1; k++)
+			fn(blk->t[k], blk->p[k]);
+	}
+}
+
+void CTrajectoryMappedFile::loadTimeRange(
+	const mrpt::Clock::time_point& t0, const mrpt::Clock::time_point& t1,
+	CPose3DInterpolator& out) const
+{
+	forEachPose(t0, t1, [&out](const auto& t, const auto& p) {
+		out.insert(t, p);
+	});
+}
+
+void CTrajectoryMappedFile::loadInto(CPose3DInterpolator& out) const
+{
+	out.clear();
+	if (empty()) return;
+	loadTimeRange(startTime(), endTime(), out);
+}
+
+mrpt::math::TPose3D& CTrajectoryMappedFile::interpolate(
+	const mrpt::Clock::time_point& t, mrpt::math::TPose3D& out_interp,
+	bool& out_valid_interp, TInterpolatorMethod method,
+	const mrpt::Clock::duration& maxTimeInterpolation) const
+{
+	out_valid_interp = false;
+	if (empty()) return out_interp;
+
+	auto& m = *m_impl;
+	const size_t nBlocks = m.numBlocks();
+	const size_t b = std::min(m.findBlock(t), nBlocks - 1);
+	const auto blk = m.block(b);
+	const auto j = static_cast<int64_t>(
+		std::lower_bound(blk->t.begin(), blk->t.end(), t) - blk->t.begin());
+
+	// The two poses before and after t (the only ones used by any
+	// interpolation method), which may be in the neighbouring blocks:
+	CPose3DInterpolator path;
+	path.setInterpolationMethod(method);
+	if (maxTimeInterpolation.count() > 0)
+		path.setMaxTimeInterpolation(maxTimeInterpolation);
+	for (int64_t k = j - 2; k < j + 2; k++)
+	{
+		size_t bk = b;
+		int64_t idx = k;
+		auto cur = blk;
+		while (idx < 0 && bk > 0)
+		{
+			cur = m.block(--bk);
+			idx += static_cast<int64_t>(cur->t.size());
+		}
+		while (idx >= static_cast<int64_t>(cur->t.size()) && bk + 1 < nBlocks)
+		{
+			idx -= static_cast<int64_t>(cur->t.size());
+			cur = m.block(++bk);
+		}
+		if (idx < 0 || idx >= static_cast<int64_t>(cur->t.size())) continue;
+		path.insert(cur->t[idx], cur->p[idx]);
+	}
+	return path.interpolate(t, out_interp, out_valid_interp);
+}
+
+void CTrajectoryMappedFile::Save(
+	const CPose3DInterpolator& path, const std::string& fileName,
+	const TSaveOptions& options)
+{
+	const size_t posesPerBlock = options.posesPerBlock;
+	ASSERT_GE_(posesPerBlock, 2U);
+	ASSERT_LE_(posesPerBlock, static_cast<size_t>(UINT32_MAX));
+
+	size_t nThreads = options.numThreads;
+	if (!nThreads) nThreads = std::max(1U, std::thread::hardware_concurrency());
+	std::unique_ptr<mrpt::WorkerThreadsPool> pool;
+	if (nThreads > 1 && path.size() > posesPerBlock)
+		pool = std::make_unique<mrpt::WorkerThreadsPool>(
+			nThreads - 1, mrpt::WorkerThreadsPool::POLICY_FIFO, "traj_save");
+
+	mrpt::io::CFileOutputStream f;
+	if (!f.open(fileName))
+		THROW_EXCEPTION_FMT(
+			"Error creating trajectory file '%s'", fileName.c_str());
+
+	uint64_t written = 0;
+	auto lmbWrite = [&](const void* p, size_t n) {
+		if (n == 0) return;
+		if (f.Write(p, n) != n)
+			THROW_EXCEPTION_FMT(
+				"Error writing trajectory file '%s'", fileName.c_str());
+		written += n;
+	};
+
+	FileHeader h;
+	std::memset(&h, 0, sizeof(h));
+	std::memcpy(h.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+	h.version = FILE_VERSION;
+	h.byteOrder = BYTE_ORDER_MARK;
+	h.valueSize = options.doublePrecision ? sizeof(double) : sizeof(float);
+	h.numPoses = path.size();
+	// Rewritten with the index location at the end:
+	lmbWrite(&h, sizeof(h));
+
+	// Blocks are encoded in batches, in parallel, to bound the memory used:
+	const size_t batchBlocks = 4 * nThreads;
+	std::vector<BlockIndexEntry> index;
+	std::vector<TTimedPose> poses;
+	std::vector<TEncodedBlock> blocks;
+	for (auto it = path.begin(); it != path.end();)
+	{
+		poses.clear();
+		for (; it != path.end() && poses.size() < batchBlocks * posesPerBlock;
+			 ++it)
+			poses.emplace_back(
+				it->first.time_since_epoch().count(), it->second);
+
+		const size_t nBlocks =
+			(poses.size() + posesPerBlock - 1) / posesPerBlock;
+		blocks.resize(nBlocks);
+		auto lmbEncode = [&](size_t k) {
+			const size_t i0 = k * posesPerBlock;
+			blocks[k] = encodeBlock(
+				&poses[i0], std::min(posesPerBlock, poses.size() - i0),
+				options.doublePrecision, options.compress);
+		};
+		if (pool) pool->parallel_for(0, nBlocks, 1, lmbEncode);
+		else
+			for (size_t k = 0; k < nBlocks; k++)
+				lmbEncode(k);
+
+		for (auto& b : blocks)
+		{
+			b.entry.offset = written;
+			lmbWrite(b.data.data(), b.data.size());
+			index.push_back(b.entry);
+		}
+	}
+
+	// The index, aligned so it can be used in place:
+	const uint8_t zeros[alignof(BlockIndexEntry)] = {0};
+	lmbWrite(
+		zeros,
+		static_cast<size_t>(
+			(alignof(BlockIndexEntry) - written % alignof(BlockIndexEntry)) %
+			alignof(BlockIndexEntry)));
+	h.indexOffset = written;
+	h.numBlocks = index.size();
+	lmbWrite(index.data(), index.size() * sizeof(BlockIndexEntry));
+
+	f.Seek(0);
+	lmbWrite(&h, sizeof(h));
+}
+
+void CTrajectoryMappedFile::Save(
+	const CPose3DInterpolator& path, const std::string& fileName)
+{
+	Save(path, fileName, TSaveOptions());
+}
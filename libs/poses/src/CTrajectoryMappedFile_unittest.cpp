@@ -0,0 +1,178 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/poses/CTrajectoryMappedFile.h>
+#include <mrpt/system/filesystem.h>
+
+#include <cmath>
+#include <fstream>
+
+using namespace mrpt::poses;
+using mrpt::math::TPose3D;
+
+namespace
+{
+// A path at ~200 Hz, with irregular periods, far from the origin:
+CPose3DInterpolator makePath(size_t N, double x0)
+{
+	CPose3DInterpolator path;
+	auto t = mrpt::Clock::fromDouble(1.6e9);
+	for (size_t i = 0; i < N; i++)
+	{
+		const double s = i * 0.005;
+		path.insert(
+			t,
+			TPose3D(
+				x0 + 2.0 * s, -1e5 + std::sin(s), 10.0 + 0.1 * s,
+				std::fmod(0.1 * s, 3.0), 0.01 * std::cos(s), 0.02));
+		t += std::chrono::microseconds(5000 + (i % 7) * 10);
+	}
+	return path;
+}
+
+void expectNear(const TPose3D& a, const TPose3D& b, double tolPos)
+{
+	for (size_t k = 0; k < 3; k++)
+		EXPECT_NEAR(a[k], b[k], tolPos);
+	for (size_t k = 3; k < 6; k++)
+		EXPECT_NEAR(a[k], b[k], 1e-6);
+}
+}  // namespace
+
+TEST(CTrajectoryMappedFile, saveLoad)
+{
+	const auto path = makePath(10000, 4e5);
+	const auto fil = mrpt::system::getTempFileName() + ".traj";
+
+	for (const bool dbl : {true, false})
+	{
+		for (const bool compress : {true, false})
+		{
+			CTrajectoryMappedFile::TSaveOptions opts;
+			opts.doublePrecision = dbl;
+			opts.compress = compress;
+			opts.posesPerBlock = 256;
+			opts.numThreads = compress ? 2 : 1;
+			CTrajectoryMappedFile::Save(path, fil, opts);
+
+			CTrajectoryMappedFile f(fil);
+			ASSERT_TRUE(f.isOpen());
+			EXPECT_EQ(f.size(), path.size());
+			EXPECT_EQ(f.blockCount(), (path.size() + 255) / 256);
+			EXPECT_EQ(f.isDoublePrecision(), dbl);
+			EXPECT_EQ(f.startTime(), path.begin()->first);
+			EXPECT_EQ(f.endTime(), path.rbegin()->first);
+
+			CPose3DInterpolator path2;
+			f.loadInto(path2);
+			ASSERT_EQ(path2.size(), path.size());
+			for (auto it1 = path.cbegin(), it2 = path2.cbegin();
+				 it1 != path.end(); ++it1, ++it2)
+			{
+				ASSERT_EQ(it1->first, it2->first);
+				if (dbl) EXPECT_EQ(it1->second, it2->second);
+				else
+					expectNear(it1->second, it2->second, 1e-4);
+			}
+		}
+	}
+	mrpt::system::deleteFile(fil);
+}
+
+TEST(CTrajectoryMappedFile, timeRangeQueries)
+{
+	const auto path = makePath(5000, 0);
+	const auto fil = mrpt::system::getTempFileName() + ".traj";
+	CTrajectoryMappedFile::TSaveOptions opts;
+	opts.posesPerBlock = 100;
+	CTrajectoryMappedFile::Save(path, fil, opts);
+
+	CTrajectoryMappedFile f(fil);
+	const auto tStart = path.begin()->first;
+	const auto dt = std::chrono::milliseconds(1234);
+	for (const auto& t0 : {tStart - dt, tStart + dt, tStart + 10 * dt})
+	{
+		const auto t1 = t0 + 3 * dt;
+		CPose3DInterpolator part;
+		f.loadTimeRange(t0, t1, part);
+
+		size_t expected = 0;
+		for (auto it = path.lower_bound(t0);
+			 it != path.end() && it->first <= t1; ++it)
+		{
+			expected++;
+			ASSERT_TRUE(part.find(it->first) != part.end());
+			EXPECT_EQ(part.at(it->first), it->second);
+		}
+		EXPECT_EQ(part.size(), expected);
+	}
+
+	// Out of range:
+	CPose3DInterpolator none;
+	f.loadTimeRange(tStart - 3 * dt, tStart - dt, none);
+	EXPECT_TRUE(none.empty());
+
+	mrpt::system::deleteFile(fil);
+}
+
+TEST(CTrajectoryMappedFile, interpolate)
+{
+	auto path = makePath(3000, 0);
+	const auto fil = mrpt::system::getTempFileName() + ".traj";
+	CTrajectoryMappedFile::TSaveOptions opts;
+	opts.posesPerBlock = 64;
+	CTrajectoryMappedFile::Save(path, fil, opts);
+	CTrajectoryMappedFile f(fil);
+
+	const auto tStart = path.begin()->first;
+	for (const auto method : {imLinearSlerp, imSplineSlerp, imLinear4Neig})
+	{
+		path.setInterpolationMethod(method);
+		// Queries around block boundaries, at poses, and out of the path:
+		for (int i = -3; i < 3100; i += 7)
+		{
+			const auto t = tStart + std::chrono::microseconds(i * 4999);
+			TPose3D p1, p2;
+			bool valid1, valid2;
+			path.interpolate(t, p1, valid1);
+			f.interpolate(t, p2, valid2, method);
+			ASSERT_EQ(valid1, valid2) << "i=" << i;
+			if (valid1) expectNear(p1, p2, 1e-9);
+		}
+	}
+	mrpt::system::deleteFile(fil);
+}
+
+TEST(CTrajectoryMappedFile, emptyAndInvalidFiles)
+{
+	const auto fil = mrpt::system::getTempFileName() + ".traj";
+
+	CTrajectoryMappedFile::Save(CPose3DInterpolator(), fil);
+	CTrajectoryMappedFile f(fil);
+	EXPECT_TRUE(f.isOpen());
+	EXPECT_TRUE(f.empty());
+	CPose3DInterpolator path;
+	f.loadInto(path);
+	EXPECT_TRUE(path.empty());
+	TPose3D p;
+	bool valid = true;
+	f.interpolate(mrpt::Clock::now(), p, valid);
+	EXPECT_FALSE(valid);
+	f.close();
+
+	{
+		std::ofstream o(fil);
+		o << "0 1 2 3 4 5 6\n";
+	}
+	EXPECT_THROW(f.open(fil), std::exception);
+	EXPECT_FALSE(f.isOpen());
+
+	mrpt::system::deleteFile(fil);
+}
@@ -10,12 +10,16 @@
 #include "poses-precomp.h"	// Precompiled headers
 //
 #include <mrpt/core/exceptions.h>  // for ASSERTMSG_
+#include <mrpt/math/slerp.h>
+#include <mrpt/math/wrap2pi.h>
 #include <mrpt/poses/CPose2D.h>
 #include <mrpt/poses/CPose3D.h>
 #include <mrpt/poses/FrameTransformer.h>  // for FrameTransformer, FrameTran...
 #include <mrpt/system/datetime.h>  // for TTimeStamp, INVALID_TIMESTAMP
 
+#include <algorithm>
 #include <string>  // for string
+#include <thread>
 
 using namespace mrpt::poses;
 
@@ -36,24 +40,270 @@ template class FrameTransformerInterface<3>;
 }  // namespace mrpt
 
 // ------- FrameTransformer --------
+namespace
+{
+void interpolate(
+	const mrpt::math::TPose2D& a, const mrpt::math::TPose2D& b, double ratio,
+	mrpt::math::TPose2D& out)
+{
+	out.x = a.x + ratio * (b.x - a.x);
+	out.y = a.y + ratio * (b.y - a.y);
+	out.phi = mrpt::math::wrapToPi(
+		a.phi + ratio * mrpt::math::wrapToPi(b.phi - a.phi));
+}
+void interpolate(
+	const mrpt::math::TPose3D& a, const mrpt::math::TPose3D& b, double ratio,
+	mrpt::math::TPose3D& out)
+{
+	mrpt::math::slerp(a, b, ratio, out);
+}
+}  // namespace
+
 template <int DIM>
 FrameTransformer<DIM>::FrameTransformer() = default;
 template <int DIM>
 FrameTransformer<DIM>::~FrameTransformer() = default;
 
+template <int DIM>
+FrameTransformer<DIM>::TTopology::TTopology(size_t nFrames)
+	: parent(nFrames, -1),
+	  edgeToParent(nFrames, nullptr),
+	  chains(new std::atomic<const TChain*>[nFrames * nFrames])
+{
+	for (size_t i = 0; i < nFrames * nFrames; i++)
+		chains[i].store(nullptr, std::memory_order_relaxed);
+}
+
+template <int DIM>
+FrameTransformer<DIM>::TTopology::~TTopology()
+{
+	const size_t N = parent.size();
+	for (size_t i = 0; i < N * N; i++)
+		delete chains[i].load(std::memory_order_relaxed);
+}
+
+template <int DIM>
+const typename FrameTransformer<DIM>::TChain&
+	FrameTransformer<DIM>::TTopology::chain(size_t source, size_t target) const
+{
+	auto& cached = chains[source * parent.size() + target];
+	if (const TChain* c = cached.load(std::memory_order_acquire); c)
+		return *c;
+
+	// Frames from each one up to its root:
+	std::vector<size_t> upS, upT;
+	for (int f = source; f >= 0; f = parent[f])
+		upS.push_back(f);
+	for (int f = target; f >= 0; f = parent[f])
+		upT.push_back(f);
+
+	auto c = std::make_unique<TChain>();
+	for (size_t iT = 0; iT < upT.size() && !c->connected; iT++)
+	{
+		const auto itS = std::find(upS.begin(), upS.end(), upT[iT]);
+		if (itS == upS.end()) continue;
+		// Common ancestor found: go up from the source, down to the target.
+		c->connected = true;
+		for (auto it = upS.begin(); it != itS; ++it)
+			c->steps.push_back({edgeToParent[*it], true});
+		for (size_t k = iT; k-- > 0;)
+			c->steps.push_back({edgeToParent[upT[k]], false});
+	}
+
+	// Publish it, unless another thread did it first:
+	const TChain* expected = nullptr;
+	if (cached.compare_exchange_strong(
+			expected, c.get(), std::memory_order_acq_rel))
+		return *c.release();
+	return *expected;
+}
+
+template <int DIM>
+void FrameTransformer<DIM>::setBufferLength(size_t n)
+{
+	ASSERT_GT_(n, 0U);
+	std::lock_guard<std::mutex> lck(m_writeMtx);
+	m_bufferLength = n;
+}
+
+template <int DIM>
+void FrameTransformer<DIM>::insertIntoEdge(TF_TreeEdge& e, const TTimedPose& p)
+{
+	const size_t cap = e.ring.size();
+	size_t start = e.start.load(std::memory_order_relaxed);
+	size_t n = e.size.load(std::memory_order_relaxed);
+	const auto at = [&](size_t k) -> TTimedPose& {
+		return e.ring[(start + k) % cap];
+	};
+
+	// Sorted position of the new entry (usually, the end):
+	size_t pos = n;
+	while (pos > 0 && at(pos - 1).timestamp > p.timestamp)
+		pos--;
+	const bool replace = pos > 0 && at(pos - 1).timestamp == p.timestamp;
+	if (!replace && n == cap && pos == 0) return;  // Older than all of them
+
+	const uint64_t seq = e.seq.load(std::memory_order_relaxed);
+	e.seq.store(seq + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	if (replace) at(pos - 1) = p;
+	else
+	{
+		if (n == cap)
+		{
+			// Drop the oldest one:
+			start = (start + 1) % cap;
+			n--;
+			pos--;
+		}
+		for (size_t k = n; k > pos; k--)
+			at(k) = at(k - 1);
+		at(pos) = p;
+		n++;
+	}
+	e.start.store(start, std::memory_order_relaxed);
+	e.size.store(n, std::memory_order_relaxed);
+
+	e.seq.store(seq + 2, std::memory_order_release);
+}
+
+template <int DIM>
+bool FrameTransformer<DIM>::readEdge(
+	const TF_TreeEdge& e, const mrpt::system::TTimeStamp& t,
+	light_type& out) const
+{
+	const size_t cap = e.ring.size();
+	for (;;)
+	{
+		const uint64_t seq0 = e.seq.load(std::memory_order_acquire);
+		if (seq0 & 1)
+		{
+			std::this_thread::yield();
+			continue;
+		}
+		const size_t start = e.start.load(std::memory_order_relaxed);
+		const size_t n = e.size.load(std::memory_order_relaxed);
+		// Only the ranges are checked here: the data may be torn by a
+		// concurrent writer, and then it is discarded below.
+		if (start < cap && n > 0 && n <= cap)
+		{
+			const auto at = [&](size_t k) -> const TTimedPose& {
+				return e.ring[(start + k) % cap];
+			};
+			bool ok = true;
+			if (t == INVALID_TIMESTAMP || n == 1) out = at(n - 1).pose;
+			else
+			{
+				// First entry with timestamp >= t:
+				size_t lo = 0, hi = n;
+				while (lo < hi)
+				{
+					const size_t mid = (lo + hi) / 2;
+					if (at(mid).timestamp < t) lo = mid + 1;
+					else
+						hi = mid;
+				}
+				const double maxExtr = m_maxExtrapolation;
+				if (lo == 0)
+				{
+					out = at(0).pose;
+					ok = mrpt::system::timeDifference(t, at(0).timestamp) <=
+						maxExtr;
+				}
+				else if (lo == n)
+				{
+					out = at(n - 1).pose;
+					ok = mrpt::system::timeDifference(
+							 at(n - 1).timestamp, t) <= maxExtr;
+				}
+				else
+				{
+					const TTimedPose &a = at(lo - 1), &b = at(lo);
+					const double dt =
+						mrpt::system::timeDifference(a.timestamp, b.timestamp);
+					const double ratio = dt > 0
+						? mrpt::system::timeDifference(a.timestamp, t) / dt
+						: 0.0;
+					if (ratio >= 0 && ratio <= 1)
+						interpolate(a.pose, b.pose, ratio, out);
+				}
+			}
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (e.seq.load(std::memory_order_relaxed) == seq0) return ok;
+		}
+		else if (e.seq.load(std::memory_order_acquire) == seq0)
+			return false;  // Empty
+	}
+}
+
 template <int DIM>
 void FrameTransformer<DIM>::sendTransform(
 	const std::string& parent_frame, const std::string& child_frame,
 	const typename base_t::pose_t& child_wrt_parent,
 	const mrpt::system::TTimeStamp& timestamp)
 {
-	m_pose_edges_buffer[parent_frame][child_frame] =
-		TF_TreeEdge(child_wrt_parent, timestamp);
-}
+	ASSERTMSG_(parent_frame != child_frame, "A frame cannot be its parent");
+	std::lock_guard<std::mutex> lck(m_writeMtx);
 
-// future work: allow graph traversal and do pose chain composition?
-// We dont need to replicate the full functionality of ROS tf, though... just
-// what we really need.
+	const TTopology* topo = m_currentTopology.get();
+	const auto idOf = [](const TTopology* tp, const std::string& name) {
+		if (!tp) return -1;
+		const auto it = tp->frameIDs.find(name);
+		return it == tp->frameIDs.end() ? -1 : static_cast<int>(it->second);
+	};
+	const int parentID = idOf(topo, parent_frame),
+			  childID = idOf(topo, child_frame);
+
+	const TTimedPose tp{timestamp, child_wrt_parent.asTPose()};
+
+	if (childID >= 0 && parentID >= 0 && topo->parent[childID] == parentID)
+		insertIntoEdge(*topo->edgeToParent[childID], tp);
+	else
+	{
+		// New frames or a new parent: new topology.
+		std::map<std::string, size_t> ids;
+		if (topo) ids = topo->frameIDs;
+		ids.emplace(parent_frame, ids.size());
+		ids.emplace(child_frame, ids.size());
+
+		auto newTopo = std::make_unique<TTopology>(ids.size());
+		newTopo->frameIDs = std::move(ids);
+		if (topo)
+		{
+			std::copy(
+				topo->parent.begin(), topo->parent.end(),
+				newTopo->parent.begin());
+			std::copy(
+				topo->edgeToParent.begin(), topo->edgeToParent.end(),
+				newTopo->edgeToParent.begin());
+		}
+		const size_t p = newTopo->frameIDs.at(parent_frame),
+					 c = newTopo->frameIDs.at(child_frame);
+		for (int f = p; f >= 0; f = newTopo->parent[f])
+			ASSERTMSG_(
+				f != static_cast<int>(c),
+				mrpt::format(
+					"Frame '%s' cannot be a child of its descendant '%s'",
+					child_frame.c_str(), parent_frame.c_str()));
+
+		// The edge is filled in before lookups can see it:
+		m_edges.push_back(std::make_unique<TF_TreeEdge>(m_bufferLength));
+		TF_TreeEdge* edge = m_edges.back().get();
+		insertIntoEdge(*edge, tp);
+		newTopo->parent[c] = static_cast<int>(p);
+		newTopo->edgeToParent[c] = edge;
+
+		if (m_currentTopology)
+			m_retiredTopologies.push_back(std::move(m_currentTopology));
+		m_currentTopology = std::move(newTopo);
+		m_topology.store(m_currentTopology.get());
+	}
+
+	// Free old topologies once no lookup may still be using them:
+	if (!m_retiredTopologies.empty() && m_activeReaders.load() == 0)
+		m_retiredTopologies.clear();
+}
 
 template <int DIM>
 FrameLookUpStatus FrameTransformer<DIM>::lookupTransform(
@@ -61,22 +311,55 @@ FrameLookUpStatus FrameTransformer<DIM>::lookupTransform(
 	typename base_t::light_type& child_wrt_parent,
 	const mrpt::system::TTimeStamp query_time, const double timeout_secs)
 {
-	ASSERTMSG_(
-		timeout_secs == .0,
-		"timeout_secs!=0: Blocking calls not supported yet!");
-	ASSERTMSG_(
-		query_time == INVALID_TIMESTAMP,
-		"`query_time` different than 'latest' not supported yet!");
+	const auto tStart = mrpt::Clock::now();
+	for (;;)
+	{
+		const auto ret = lookupOnce(
+			target_frame, source_frame, child_wrt_parent, query_time);
+		if (ret == LKUP_GOOD ||
+			mrpt::system::timeDifference(tStart, mrpt::Clock::now()) >=
+				timeout_secs)
+			return ret;
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+}
+
+template <int DIM>
+FrameLookUpStatus FrameTransformer<DIM>::lookupOnce(
+	const std::string& target_frame, const std::string& source_frame,
+	light_type& child_wrt_parent, const mrpt::system::TTimeStamp& query_time)
+{
+	// Keep the topologies alive while using them (see sendTransform()):
+	m_activeReaders++;
+	struct ReaderGuard
+	{
+		std::atomic<size_t>& n;
+		~ReaderGuard() { n--; }
+	} guard{m_activeReaders};
 
-	const auto& it_src = m_pose_edges_buffer.find(source_frame);
-	if (it_src == m_pose_edges_buffer.end()) { return LKUP_UNKNOWN_FRAME; }
+	const TTopology* topo = m_topology.load();
+	if (!topo) return LKUP_UNKNOWN_FRAME;
 
-	const auto& it_dst = it_src->second.find(target_frame);
-	if (it_dst == it_src->second.end()) { return LKUP_NO_CONNECTIVITY; }
+	const auto itS = topo->frameIDs.find(source_frame),
+			   itT = topo->frameIDs.find(target_frame);
+	if (itS == topo->frameIDs.end() || itT == topo->frameIDs.end())
+		return LKUP_UNKNOWN_FRAME;
 
-	const TF_TreeEdge& te = it_dst->second;
-	child_wrt_parent = te.pose.asTPose();
+	const TChain& chain = topo->chain(itS->second, itT->second);
+	if (!chain.connected) return LKUP_NO_CONNECTIVITY;
 
+	typename base_t::pose_t p;
+	light_type edgePose;
+	for (const auto& step : chain.steps)
+	{
+		if (!readEdge(*step.edge, query_time, edgePose))
+			return LKUP_EXTRAPOLATION_ERROR;
+		const typename base_t::pose_t e(edgePose);
+		if (step.inverse) p = p + (-e);
+		else
+			p = p + e;
+	}
+	child_wrt_parent = p.asTPose();
 	return LKUP_GOOD;
 }
 
@@ -13,6 +13,8 @@
 #include <mrpt/poses/FrameTransformer.h>
 
 #include <Eigen/Dense>
+#include <atomic>
+#include <thread>
 
 template <int DIM>
 void run_tf_test1(const mrpt::poses::CPose2D& A2B_)
@@ -47,3 +49,90 @@ TEST(FrameTransformer, SimplePublishAndLookup)
 	run_tf_test1<2>(test_A2B);
 	run_tf_test1<3>(test_A2B);
 }
+
+TEST(FrameTransformer, ChainsAndTimedLookups)
+{
+	using namespace mrpt::poses;
+	using mrpt::math::TPose3D;
+
+	FrameTransformer<3> tf;
+	const CPose3D A2B(1, 2, 3, 0.1, 0.2, 0.3), B2C(-1, 0.5, 0, 0.5, 0, -0.1),
+		A2D(0, 0, 4, -0.3, 0, 0);
+	tf.sendTransform("A", "B", A2B);
+	tf.sendTransform("B", "C", B2C);
+	tf.sendTransform("A", "D", A2D);
+	tf.sendTransform("X", "Y", CPose3D());
+
+	CPose3D p;
+	ASSERT_EQ(tf.lookupTransform("C", "D", p), LKUP_GOOD);
+	EXPECT_NEAR(
+		((p - (A2B + B2C - A2D)).asVectorVal()).array().abs().sum(), 0, 1e-9);
+	ASSERT_EQ(tf.lookupTransform("A", "C", p), LKUP_GOOD);
+	EXPECT_NEAR(
+		((p - (-(A2B + B2C))).asVectorVal()).array().abs().sum(), 0, 1e-9);
+	EXPECT_EQ(tf.lookupTransform("C", "Y", p), LKUP_NO_CONNECTIVITY);
+	EXPECT_EQ(tf.lookupTransform("C", "Z", p), LKUP_UNKNOWN_FRAME);
+	EXPECT_ANY_THROW(tf.sendTransform("C", "A", CPose3D()));
+
+	// Time-buffered edge, with the static ones above:
+	const auto t0 = mrpt::Clock::now();
+	using namespace std::chrono_literals;
+	tf.sendTransform("D", "E", CPose3D(0, 0, 0, 0, 0, 0), t0);
+	tf.sendTransform("D", "E", CPose3D(2, 0, 0, 0.4, 0, 0), t0 + 200ms);
+	ASSERT_EQ(tf.lookupTransform("E", "A", p, t0 + 50ms), LKUP_GOOD);
+	const CPose3D D2E(0.5, 0, 0, 0.1, 0, 0);
+	EXPECT_NEAR(
+		((p - (A2D + D2E)).asVectorVal()).array().abs().sum(), 0, 1e-9);
+	ASSERT_EQ(tf.lookupTransform("E", "D", p), LKUP_GOOD);  // latest
+	EXPECT_NEAR(p.x(), 2.0, 1e-9);
+	EXPECT_EQ(
+		tf.lookupTransform("E", "D", p, t0 + 300ms), LKUP_EXTRAPOLATION_ERROR);
+	tf.setMaxExtrapolationTime(0.2);
+	EXPECT_EQ(tf.lookupTransform("E", "D", p, t0 + 300ms), LKUP_GOOD);
+	EXPECT_NEAR(p.x(), 2.0, 1e-9);
+}
+
+TEST(FrameTransformer, ConcurrentAccess)
+{
+	using namespace mrpt::poses;
+
+	FrameTransformer<2> tf;
+	tf.setBufferLength(8);
+	const auto t0 = mrpt::Clock::now();
+	using namespace std::chrono_literals;
+
+	std::atomic_bool done{false};
+	std::atomic<size_t> nBad{0};
+	std::vector<std::thread> readers;
+	for (int r = 0; r < 4; r++)
+		readers.emplace_back([&]() {
+			while (!done)
+			{
+				mrpt::math::TPose2D p;
+				const auto ret = tf.lookupTransform("odom", "map", p);
+				// Either not published yet, or one of the written poses,
+				// which have y=2*x:
+				if (ret == LKUP_GOOD && std::abs(p.y - 2 * p.x) > 1e-9) nBad++;
+			}
+		});
+	for (int i = 1; i <= 20000; i++)
+	{
+		tf.sendTransform("map", "odom", CPose2D(i, 2 * i, 0), t0 + i * 1ms);
+		if (i % 1000 == 0)
+			tf.sendTransform(
+				"odom", mrpt::format("f%i", i), CPose2D(), t0 + i * 1ms);
+	}
+	done = true;
+	for (auto& t : readers)
+		t.join();
+	EXPECT_EQ(nBad.load(), 0U);
+
+	// Interpolated between the last buffered ones:
+	mrpt::math::TPose2D p;
+	ASSERT_EQ(
+		tf.lookupTransform("odom", "map", p, t0 + 19995500us), LKUP_GOOD);
+	EXPECT_NEAR(p.x, 19995.5, 1e-6);
+	EXPECT_EQ(
+		tf.lookupTransform("odom", "map", p, t0 + 19990ms),
+		LKUP_EXTRAPOLATION_ERROR);
+}
@@ -280,3 +280,56 @@ TEST_F(SE3_traits_tests, SE3_jacobs_dAB_dAB) { tests_jacobs_dAB_dAB(); }
 
 TEST_F(SE2_traits_tests, SE2_jacobs_DinvP1InvP2) { tests_jacobs_DinvP1InvP2(); }
 TEST_F(SE2_traits_tests, SE2_jacobs_dAB_dAB) { tests_jacobs_dAB_dAB(); }
+
+TEST(SE3_traits, batchMatchesSingle)
+{
+	using Lie::SE;
+	std::vector<SE<3>::manifold_vector> Ps;
+	std::vector<SE<3>::tangent_vector> xs;
+	for (const auto& p : ptc)
+	{
+		Ps.push_back(SE<3>::asManifoldVector(p));
+		xs.push_back(SE<3>::log(p));
+	}
+	// Small and near-pi rotations:
+	SE<3>::tangent_vector x;
+	x.fill(0);
+	x[3] = 1e-9;
+	xs.push_back(x);
+	x[3] = M_PI - 1e-6;
+	xs.push_back(x);
+
+	std::vector<SE<3>::manifold_vector> exps;
+	SE<3>::exp(xs, exps);
+	ASSERT_EQ(exps.size(), xs.size());
+	for (size_t i = 0; i < xs.size(); i++)
+	{
+		const auto P = SE<3>::asManifoldVector(SE<3>::exp(xs[i]));
+		EXPECT_NEAR((exps[i] - P).sum_abs(), 0, 1e-9) << "x=" << xs[i];
+	}
+
+	std::vector<SE<3>::tangent_vector> logs;
+	SE<3>::log(Ps, logs);
+	ASSERT_EQ(logs.size(), Ps.size());
+	for (size_t i = 0; i < Ps.size(); i++)
+	{
+		EXPECT_NEAR((logs[i] - xs[i]).sum_abs(), 0, 1e-9) << ptc[i];
+		EXPECT_NEAR((exps[i] - Ps[i]).sum_abs(), 0, 1e-9) << ptc[i];
+	}
+
+	std::vector<SE<3>::mat2tang_jacob> dlogs;
+	SE<3>::jacob_dlogv_dv(Ps, dlogs);
+	std::vector<SE<3>::tang2mat_jacob> dexps;
+	SE<3>::jacob_dexpe_de(xs, dexps);
+	ASSERT_EQ(dlogs.size(), Ps.size());
+	ASSERT_EQ(dexps.size(), xs.size());
+	for (size_t i = 0; i < Ps.size(); i++)
+	{
+		const auto dlog = SE<3>::jacob_dlogv_dv(ptc[i]);
+		const auto dexp = SE<3>::jacob_dexpe_de(xs[i]);
+		EXPECT_NEAR(
+			(dlogs[i].asEigen() - dlog.asEigen()).cwiseAbs().sum(), 0, 1e-12);
+		EXPECT_NEAR(
+			(dexps[i].asEigen() - dexp.asEigen()).cwiseAbs().sum(), 0, 1e-12);
+	}
+}
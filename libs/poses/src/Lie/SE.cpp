@@ -17,6 +17,8 @@
 
 #include <Eigen/Dense>
 
+#include "so3_kernels.h"
+
 using namespace mrpt;
 using namespace mrpt::math;
 using namespace mrpt::poses;
@@ -66,13 +68,30 @@ SE<3>::tang2mat_jacob SE<3>::jacob_dexpe_de(const SE<3>::tangent_vector& x)
 	return J;
 }
 
-SE<3>::mat2tang_jacob SE<3>::jacob_dlogv_dv(const SE<3>::type& P)
+namespace
+{
+void se3_jacob_dlogv_dv(const CMatrixDouble33& R, CMatrixDouble6_12& J)
 {
-	mrpt::math::CMatrixDouble6_12 J;
 	J.setZero();
-	const CMatrixDouble33& R = P.getRotationMatrix();
 	J.block<3, 9>(3, 0) = SO<3>::jacob_dlogv_dv(R).asEigen();
 	J(0, 9) = J(1, 10) = J(2, 11) = 1.0;
+}
+
+// Rotation part of a manifold vector, which is stored in column-major order:
+CMatrixDouble33 rotationOf(const SE<3>::manifold_vector& P)
+{
+	CMatrixDouble33 R(UNINITIALIZED_MATRIX);
+	for (int c = 0; c < 3; c++)
+		for (int r = 0; r < 3; r++)
+			R(r, c) = P[r + 3 * c];
+	return R;
+}
+}  // namespace
+
+SE<3>::mat2tang_jacob SE<3>::jacob_dlogv_dv(const SE<3>::type& P)
+{
+	mrpt::math::CMatrixDouble6_12 J;
+	se3_jacob_dlogv_dv(P.getRotationMatrix(), J);
 	return J;
 }
 
@@ -202,6 +221,64 @@ SE<3>::matrix_MxM SE<3>::jacob_dAB_dB(
 	return J;
 }
 
+SE<3>::manifold_vector SE<3>::expAsManifoldVector(
+	const SE<3>::tangent_vector& x)
+{
+	manifold_vector P;
+	detail::so3_exp(&x[3], &P[0]);
+	P[9] = x[0];
+	P[10] = x[1];
+	P[11] = x[2];
+	return P;
+}
+
+SE<3>::tangent_vector SE<3>::logFromManifoldVector(
+	const SE<3>::manifold_vector& P)
+{
+	tangent_vector v;
+	v[0] = P[9];
+	v[1] = P[10];
+	v[2] = P[11];
+	detail::so3_log(&P[0], &v[3]);
+	return v;
+}
+
+void SE<3>::exp(
+	const std::vector<tangent_vector>& x, std::vector<manifold_vector>& out)
+{
+	const size_t N = x.size();
+	out.resize(N);
+	for (size_t i = 0; i < N; i++)
+		out[i] = expAsManifoldVector(x[i]);
+}
+
+void SE<3>::log(
+	const std::vector<manifold_vector>& P, std::vector<tangent_vector>& out)
+{
+	const size_t N = P.size();
+	out.resize(N);
+	for (size_t i = 0; i < N; i++)
+		out[i] = logFromManifoldVector(P[i]);
+}
+
+void SE<3>::jacob_dexpe_de(
+	const std::vector<tangent_vector>& x, std::vector<tang2mat_jacob>& out)
+{
+	const size_t N = x.size();
+	out.resize(N);
+	for (size_t i = 0; i < N; i++)
+		out[i] = jacob_dexpe_de(x[i]);
+}
+
+void SE<3>::jacob_dlogv_dv(
+	const std::vector<manifold_vector>& P, std::vector<mat2tang_jacob>& out)
+{
+	const size_t N = P.size();
+	out.resize(N);
+	for (size_t i = 0; i < N; i++)
+		se3_jacob_dlogv_dv(rotationOf(P[i]), out[i]);
+}
+
 // See .h for documentation
 // ====== SE(2) ===========
 SE<2>::type SE<2>::exp(const SE<2>::tangent_vector& x)
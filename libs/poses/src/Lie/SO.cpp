@@ -17,6 +17,8 @@
 
 #include <cmath>
 
+#include "so3_kernels.h"
+
 using namespace mrpt;
 using namespace mrpt::math;
 using namespace mrpt::poses;
@@ -58,59 +60,11 @@ SO<3>::tang2mat_jacob SO<3>::jacob_dexpe_de(const SO<3>::tangent_vector& x)
 
 SO<3>::tangent_vector SO<3>::log(const SO<3>::type& R)
 {
-	// Based on original code from Sophus:
-	// Copyright: 2011-2017 Hauke Strasdat
-	//            2012-2017 Steven Lovegrove
-	// License: Expat
-
-	// From: Sophus::SO3<>::log()
-
-	using std::abs;
-	using std::atan;
-	using std::sqrt;
-
-	mrpt::math::CQuaternionDouble q;
-	mrpt::poses::CPose3D(R, CVectorFixedDouble<3>()).getAsQuaternion(q);
-
-	const auto squared_n = q.x() * q.x() + q.y() * q.y() + q.z() * q.z();
-	const auto n = sqrt(squared_n);
-	const auto w = q.r();
-
-	double two_atan_nbyw_by_n;
-
-	// Atan-based log thanks to
-	//
-	// C. Hertzberg et al.:
-	// "Integrating Generic Sensor Fusion Algorithms with Sound State
-	// Representation through Encapsulation of Manifolds"
-	// Information Fusion, 2011
-
-	if (n < 1e-7)
-	{
-		// If quaternion is normalized and n=0, then w should be 1;
-		// w=0 should never happen here!
-		ASSERTMSG_(std::abs(w) >= 1e-7, "Quaternion should be normalized!");
-		two_atan_nbyw_by_n = 2.0 / w - 2.0 * (squared_n) / (w * w * w);
-	}
-	else
-	{
-		if (std::abs(w) < 1e-7)
-		{
-			if (w > 0) two_atan_nbyw_by_n = M_PI / n;
-			else
-				two_atan_nbyw_by_n = -M_PI / n;
-		}
-		else
-		{
-			two_atan_nbyw_by_n = 2.0 * atan(n / w) / n;
-		}
-	}
-
+	// Column-major copy for the kernel:
+	const double Rc[9] = {R(0, 0), R(1, 0), R(2, 0), R(0, 1), R(1, 1),
+						  R(2, 1), R(0, 2), R(1, 2), R(2, 2)};
 	tangent_vector ret;
-	ret[0] = two_atan_nbyw_by_n * q.x();
-	ret[1] = two_atan_nbyw_by_n * q.y();
-	ret[2] = two_atan_nbyw_by_n * q.z();
-
+	detail::so3_log(Rc, &ret[0]);
 	return ret;
 }
 
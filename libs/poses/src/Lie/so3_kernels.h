@@ -0,0 +1,132 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/core/exceptions.h>
+
+#include <cmath>
+
+// Allocation-free SO(3) exp/log on raw column-major 3x3 matrices, shared by
+// the single and the batch versions of SO<3> and SE<3> methods.
+namespace mrpt::poses::Lie::detail
+{
+/** R=exp(w^), via the Rodrigues formula. R is a column-major 3x3 matrix. */
+inline void so3_exp(const double* w, double* R)
+{
+	const double x = w[0], y = w[1], z = w[2];
+	const double th2 = x * x + y * y + z * z, th = std::sqrt(th2);
+	double A, B;  // R = I + A*[w]x + B*[w]x^2
+	if (th < 1e-6)
+	{
+		// Taylor series approximation:
+		A = 1.0 - th2 / 6.0;
+		B = 0.5 - th2 / 24.0;
+	}
+	else
+	{
+		A = std::sin(th) / th;
+		B = (1.0 - std::cos(th)) / th2;
+	}
+	// [w]x^2 = w*w' - |w|^2*I
+	R[0] = 1.0 + B * (x * x - th2);
+	R[1] = A * z + B * x * y;
+	R[2] = -A * y + B * x * z;
+	R[3] = -A * z + B * x * y;
+	R[4] = 1.0 + B * (y * y - th2);
+	R[5] = A * x + B * y * z;
+	R[6] = A * y + B * x * z;
+	R[7] = -A * x + B * y * z;
+	R[8] = 1.0 + B * (z * z - th2);
+}
+
+/** w=log(R)^vee for a column-major 3x3 rotation matrix R. */
+inline void so3_log(const double* R, double* w)
+{
+	// R(r,c)=R[r+3*c]. Matrix to quaternion (Shepperd's method):
+	const double tr = R[0] + R[4] + R[8];
+	double qr, qx, qy, qz;
+	if (tr > 0)
+	{
+		const double s = 0.5 / std::sqrt(tr + 1.0);
+		qr = 0.25 / s;
+		qx = (R[5] - R[7]) * s;
+		qy = (R[6] - R[2]) * s;
+		qz = (R[1] - R[3]) * s;
+	}
+	else if (R[0] > R[4] && R[0] > R[8])
+	{
+		const double s = 2.0 * std::sqrt(1.0 + R[0] - R[4] - R[8]);
+		qr = (R[5] - R[7]) / s;
+		qx = 0.25 * s;
+		qy = (R[3] + R[1]) / s;
+		qz = (R[6] + R[2]) / s;
+	}
+	else if (R[4] > R[8])
+	{
+		const double s = 2.0 * std::sqrt(1.0 + R[4] - R[0] - R[8]);
+		qr = (R[6] - R[2]) / s;
+		qx = (R[3] + R[1]) / s;
+		qy = 0.25 * s;
+		qz = (R[7] + R[5]) / s;
+	}
+	else
+	{
+		const double s = 2.0 * std::sqrt(1.0 + R[8] - R[0] - R[4]);
+		qr = (R[1] - R[3]) / s;
+		qx = (R[6] + R[2]) / s;
+		qy = (R[7] + R[5]) / s;
+		qz = 0.25 * s;
+	}
+	const double qn = 1.0 / std::sqrt(qr * qr + qx * qx + qy * qy + qz * qz);
+	qr *= qn;
+	qx *= qn;
+	qy *= qn;
+	qz *= qn;
+
+	// Based on original code from Sophus:
+	// Copyright: 2011-2017 Hauke Strasdat
+	//            2012-2017 Steven Lovegrove
+	// License: Expat
+	// From: Sophus::SO3<>::log()
+	// Atan-based log thanks to
+	//
+	// C. Hertzberg et al.:
+	// "Integrating Generic Sensor Fusion Algorithms with Sound State
+	// Representation through Encapsulation of Manifolds"
+	// Information Fusion, 2011
+	const double squared_n = qx * qx + qy * qy + qz * qz;
+	const double n = std::sqrt(squared_n);
+
+	double two_atan_nbyw_by_n;
+	if (n < 1e-7)
+	{
+		// If quaternion is normalized and n=0, then w should be 1;
+		// w=0 should never happen here!
+		ASSERTMSG_(std::abs(qr) >= 1e-7, "Quaternion should be normalized!");
+		two_atan_nbyw_by_n = 2.0 / qr - 2.0 * (squared_n) / (qr * qr * qr);
+	}
+	else
+	{
+		if (std::abs(qr) < 1e-7)
+		{
+			if (qr > 0) two_atan_nbyw_by_n = M_PI / n;
+			else
+				two_atan_nbyw_by_n = -M_PI / n;
+		}
+		else
+		{
+			two_atan_nbyw_by_n = 2.0 * std::atan(n / qr) / n;
+		}
+	}
+
+	w[0] = two_atan_nbyw_by_n * qx;
+	w[1] = two_atan_nbyw_by_n * qy;
+	w[2] = two_atan_nbyw_by_n * qz;
+}
+}  // namespace mrpt::poses::Lie::detail
@@ -0,0 +1,312 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "poses-precomp.h"	// Precompiled headers
+//
+#include <mrpt/core/exceptions.h>
+#include <mrpt/math/CMatrixFixed.h>
+#include <mrpt/poses/CPose3D.h>
+#include <mrpt/poses/SO_SE_average.h>
+#include <mrpt/poses/TPoseParticlesSoA.h>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace mrpt::poses;
+
+namespace
+{
+// Branchless version of wrapToPi(), so loops can be vectorized. It returns
+// angles in [-pi,pi) instead of (-pi,pi].
+inline double wrapToPiNoBranch(double a)
+{
+	return a - M_2PI * std::floor((a + M_PI) * (1.0 / M_2PI));
+}
+
+void updateLogWeightsImpl(
+	std::vector<double>& log_w, const std::vector<double>& log_likelihood)
+{
+	ASSERT_EQUAL_(log_w.size(), log_likelihood.size());
+	const size_t N = log_w.size();
+	double* w = log_w.data();
+	const double* l = log_likelihood.data();
+	for (size_t i = 0; i < N; i++)
+		w[i] += l[i];
+}
+
+double normalizeWeightsImpl(std::vector<double>& log_w, double* out_max_log_w)
+{
+	if (log_w.empty()) return 0;
+	const auto [minIt, maxIt] = std::minmax_element(log_w.begin(), log_w.end());
+	const double minW = *minIt, maxW = *maxIt;
+
+	const size_t N = log_w.size();
+	double* w = log_w.data();
+	for (size_t i = 0; i < N; i++)
+		w[i] -= maxW;
+
+	if (out_max_log_w) *out_max_log_w = maxW;
+	return std::exp(maxW - minW);
+}
+
+double ESSImpl(const std::vector<double>& log_w)
+{
+	// sum(w_i/W)^2 == sum(w_i^2)/W^2, with W=sum(w_i):
+	const size_t N = log_w.size();
+	const double* lw = log_w.data();
+	double sumW = 0, sumW2 = 0;
+	for (size_t i = 0; i < N; i++)
+	{
+		const double w = std::exp(lw[i]);
+		sumW += w;
+		sumW2 += w * w;
+	}
+	if (sumW2 == 0) return 0;
+	return mrpt::square(sumW) / (N * sumW2);
+}
+
+// Gathers the elements of one array. `buf` is swapped with `v` so its
+// storage is reused for the next array:
+void gather(
+	std::vector<double>& v, const std::vector<size_t>& indx,
+	std::vector<double>& buf)
+{
+	const size_t N = indx.size();
+	[[maybe_unused]] const size_t M = v.size();
+	buf.resize(N);
+	const double* src = v.data();
+	double* dst = buf.data();
+	for (size_t i = 0; i < N; i++)
+	{
+		ASSERTDEB_(indx[i] < M);
+		dst[i] = src[indx[i]];
+	}
+	v.swap(buf);
+}
+}  // namespace
+
+// ---------------------------------------------------------------------------
+//  TPoseParticlesSoA2D
+// ---------------------------------------------------------------------------
+void TPoseParticlesSoA2D::resize(size_t n)
+{
+	x.resize(n, 0);
+	y.resize(n, 0);
+	phi.resize(n, 0);
+	log_w.resize(n, 0);
+}
+
+void TPoseParticlesSoA2D::clear()
+{
+	x.clear();
+	y.clear();
+	phi.clear();
+	log_w.clear();
+}
+
+void TPoseParticlesSoA2D::resetDeterministic(const mrpt::math::TPose2D& p)
+{
+	std::fill(x.begin(), x.end(), p.x);
+	std::fill(y.begin(), y.end(), p.y);
+	std::fill(phi.begin(), phi.end(), p.phi);
+	std::fill(log_w.begin(), log_w.end(), 0.0);
+}
+
+void TPoseParticlesSoA2D::composeIncrement(const mrpt::math::TPose2D& Ap)
+{
+	const size_t N = size();
+	double *px = x.data(), *py = y.data(), *pphi = phi.data();
+	for (size_t i = 0; i < N; i++)
+	{
+		const double c = std::cos(pphi[i]), s = std::sin(pphi[i]);
+		px[i] += Ap.x * c - Ap.y * s;
+		py[i] += Ap.x * s + Ap.y * c;
+		pphi[i] = wrapToPiNoBranch(pphi[i] + Ap.phi);
+	}
+}
+
+void TPoseParticlesSoA2D::composeIncrements(const TPoseParticlesSoA2D& Ap)
+{
+	ASSERT_EQUAL_(Ap.size(), size());
+	const size_t N = size();
+	double *px = x.data(), *py = y.data(), *pphi = phi.data();
+	const double *ax = Ap.x.data(), *ay = Ap.y.data(), *aphi = Ap.phi.data();
+	for (size_t i = 0; i < N; i++)
+	{
+		const double c = std::cos(pphi[i]), s = std::sin(pphi[i]);
+		px[i] += ax[i] * c - ay[i] * s;
+		py[i] += ax[i] * s + ay[i] * c;
+		pphi[i] = wrapToPiNoBranch(pphi[i] + aphi[i]);
+	}
+}
+
+void TPoseParticlesSoA2D::updateLogWeights(
+	const std::vector<double>& log_likelihood)
+{
+	updateLogWeightsImpl(log_w, log_likelihood);
+}
+
+double TPoseParticlesSoA2D::normalizeWeights(double* out_max_log_w)
+{
+	return normalizeWeightsImpl(log_w, out_max_log_w);
+}
+
+double TPoseParticlesSoA2D::ESS() const { return ESSImpl(log_w); }
+
+void TPoseParticlesSoA2D::performSubstitution(const std::vector<size_t>& indx)
+{
+	std::vector<double> buf;
+	gather(x, indx, buf);
+	gather(y, indx, buf);
+	gather(phi, indx, buf);
+	gather(log_w, indx, buf);
+}
+
+mrpt::math::TPose2D TPoseParticlesSoA2D::getMean() const
+{
+	// Same than SE_average<2>, in a single vectorizable pass:
+	const size_t N = size();
+	if (!N) return {0, 0, 0};
+
+	const double *px = x.data(), *py = y.data(), *pphi = phi.data(),
+				 *lw = log_w.data();
+	double sw = 0, sx = 0, sy = 0, sc = 0, ss = 0;
+	for (size_t i = 0; i < N; i++)
+	{
+		const double w = std::exp(lw[i]);
+		sw += w;
+		sx += w * px[i];
+		sy += w * py[i];
+		sc += w * std::cos(pphi[i]);
+		ss += w * std::sin(pphi[i]);
+	}
+	ASSERTMSG_(sw > 0, "Sum of weights is zero.");
+	return {sx / sw, sy / sw, std::atan2(ss, sc)};
+}
+
+// ---------------------------------------------------------------------------
+//  TPoseParticlesSoA3D
+// ---------------------------------------------------------------------------
+void TPoseParticlesSoA3D::resize(size_t n)
+{
+	for (auto* v : {&x, &y, &z, &yaw, &pitch, &roll, &log_w})
+		v->resize(n, 0);
+}
+
+void TPoseParticlesSoA3D::clear()
+{
+	for (auto* v : {&x, &y, &z, &yaw, &pitch, &roll, &log_w})
+		v->clear();
+}
+
+void TPoseParticlesSoA3D::resetDeterministic(const mrpt::math::TPose3D& p)
+{
+	std::fill(x.begin(), x.end(), p.x);
+	std::fill(y.begin(), y.end(), p.y);
+	std::fill(z.begin(), z.end(), p.z);
+	std::fill(yaw.begin(), yaw.end(), p.yaw);
+	std::fill(pitch.begin(), pitch.end(), p.pitch);
+	std::fill(roll.begin(), roll.end(), p.roll);
+	std::fill(log_w.begin(), log_w.end(), 0.0);
+}
+
+namespace
+{
+// Rotation matrix from yaw/pitch/roll, as in Lie::SO<3>::fromYPR():
+inline void ypr2rot(double yw, double pt, double rl, double R[9])
+{
+	const double cy = std::cos(yw), sy = std::sin(yw);
+	const double cp = std::cos(pt), sp = std::sin(pt);
+	const double cr = std::cos(rl), sr = std::sin(rl);
+	R[0] = cy * cp;
+	R[1] = cy * sp * sr - sy * cr;
+	R[2] = cy * sp * cr + sy * sr;
+	R[3] = sy * cp;
+	R[4] = sy * sp * sr + cy * cr;
+	R[5] = sy * sp * cr - cy * sr;
+	R[6] = -sp;
+	R[7] = cp * sr;
+	R[8] = cp * cr;
+}
+
+// p = p (+) Ap, for the i-th particle:
+inline void compose3D(
+	TPoseParticlesSoA3D& p, size_t i, double ax, double ay, double az,
+	const double RA[9])
+{
+	double R[9];
+	ypr2rot(p.yaw[i], p.pitch[i], p.roll[i], R);
+
+	p.x[i] += R[0] * ax + R[1] * ay + R[2] * az;
+	p.y[i] += R[3] * ax + R[4] * ay + R[5] * az;
+	p.z[i] += R[6] * ax + R[7] * ay + R[8] * az;
+
+	mrpt::math::CMatrixDouble33 Rn;
+	for (int r = 0; r < 3; r++)
+		for (int c = 0; c < 3; c++)
+			Rn(r, c) = R[r * 3 + 0] * RA[0 * 3 + c] +
+				R[r * 3 + 1] * RA[1 * 3 + c] + R[r * 3 + 2] * RA[2 * 3 + c];
+	mrpt::math::TPose3D::SO3_to_yaw_pitch_roll(
+		Rn, p.yaw[i], p.pitch[i], p.roll[i]);
+}
+}  // namespace
+
+void TPoseParticlesSoA3D::composeIncrement(const mrpt::math::TPose3D& Ap)
+{
+	double RA[9];
+	ypr2rot(Ap.yaw, Ap.pitch, Ap.roll, RA);
+	const size_t N = size();
+	for (size_t i = 0; i < N; i++)
+		compose3D(*this, i, Ap.x, Ap.y, Ap.z, RA);
+}
+
+void TPoseParticlesSoA3D::composeIncrements(const TPoseParticlesSoA3D& Ap)
+{
+	ASSERT_EQUAL_(Ap.size(), size());
+	const size_t N = size();
+	for (size_t i = 0; i < N; i++)
+	{
+		double RA[9];
+		ypr2rot(Ap.yaw[i], Ap.pitch[i], Ap.roll[i], RA);
+		compose3D(*this, i, Ap.x[i], Ap.y[i], Ap.z[i], RA);
+	}
+}
+
+void TPoseParticlesSoA3D::updateLogWeights(
+	const std::vector<double>& log_likelihood)
+{
+	updateLogWeightsImpl(log_w, log_likelihood);
+}
+
+double TPoseParticlesSoA3D::normalizeWeights(double* out_max_log_w)
+{
+	return normalizeWeightsImpl(log_w, out_max_log_w);
+}
+
+double TPoseParticlesSoA3D::ESS() const { return ESSImpl(log_w); }
+
+void TPoseParticlesSoA3D::performSubstitution(const std::vector<size_t>& indx)
+{
+	std::vector<double> buf;
+	for (auto* v : {&x, &y, &z, &yaw, &pitch, &roll, &log_w})
+		gather(*v, indx, buf);
+}
+
+mrpt::math::TPose3D TPoseParticlesSoA3D::getMean() const
+{
+	const size_t N = size();
+	if (!N) return {0, 0, 0, 0, 0, 0};
+
+	mrpt::poses::SE_average<3> se_averager;
+	for (size_t i = 0; i < N; i++)
+		se_averager.append(getPose(i), std::exp(log_w[i]));
+	CPose3D mean;
+	se_averager.get_average(mean);
+	return mean.asTPose();
+}
@@ -0,0 +1,126 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/math/wrap2pi.h>
+#include <mrpt/poses/CPose3D.h>
+#include <mrpt/poses/CPose3DPDFParticles.h>
+#include <mrpt/poses/CPosePDFParticles.h>
+#include <mrpt/poses/TPoseParticlesSoA.h>
+#include <mrpt/random.h>
+
+using namespace mrpt::poses;
+using mrpt::math::TPose2D;
+using mrpt::math::TPose3D;
+
+TEST(TPoseParticlesSoA, CPosePDFParticles)
+{
+	auto& rng = mrpt::random::getRandomGenerator();
+	rng.randomize(1234);
+
+	CPosePDFParticles pdf(100);
+	pdf.resetUniform(-5, 5, -5, 5);
+	for (size_t i = 0; i < pdf.size(); i++)
+		pdf.setW(i, rng.drawUniform(-10.0, 0.0));
+
+	TPoseParticlesSoA2D soa;
+	pdf.getParticlesSoA(soa);
+	ASSERT_EQ(soa.size(), pdf.size());
+
+	// Prediction:
+	const TPose2D Ap(0.3, -0.2, mrpt::DEG2RAD(170.0));
+	pdf += Ap;
+	soa.composeIncrement(Ap);
+
+	// Weighting:
+	std::vector<double> logLik(soa.size());
+	for (size_t i = 0; i < logLik.size(); i++)
+	{
+		logLik[i] = rng.drawUniform(-5.0, 0.0);
+		pdf.setW(i, pdf.getW(i) + logLik[i]);
+	}
+	soa.updateLogWeights(logLik);
+
+	double maxW1 = 0, maxW2 = 0;
+	EXPECT_NEAR(
+		pdf.normalizeWeights(&maxW1), soa.normalizeWeights(&maxW2), 1e-6);
+	EXPECT_NEAR(maxW1, maxW2, 1e-9);
+	EXPECT_NEAR(pdf.ESS(), soa.ESS(), 1e-9);
+
+	// Resampling:
+	std::vector<double> logWeights;
+	pdf.getWeights(logWeights);
+	std::vector<size_t> indx;
+	pdf.computeResampling(
+		mrpt::bayes::CParticleFilter::prSystematic, logWeights, indx, 150);
+	pdf.performSubstitution(indx);
+	soa.performSubstitution(indx);
+
+	const TPose2D m1 = pdf.getMeanVal().asTPose(), m2 = soa.getMean();
+	EXPECT_NEAR(m1.x, m2.x, 1e-6);
+	EXPECT_NEAR(m1.y, m2.y, 1e-6);
+	EXPECT_NEAR(mrpt::math::angDistance(m1.phi, m2.phi), 0, 1e-6);
+
+	// Round trip (the particles of pdf may be in a different order than the
+	// ones of soa after the substitution, as it reuses the discarded slots):
+	CPosePDFParticles pdf2;
+	pdf2.setParticlesSoA(soa);
+	ASSERT_EQ(pdf2.size(), 150U);
+	for (size_t i = 0; i < pdf2.size(); i++)
+	{
+		const TPose2D p1 = soa.getPose(i), p2 = pdf2.getParticlePose(i);
+		EXPECT_NEAR(p1.x, p2.x, 1e-9);
+		EXPECT_NEAR(p1.y, p2.y, 1e-9);
+		EXPECT_NEAR(mrpt::math::angDistance(p1.phi, p2.phi), 0, 1e-9);
+		EXPECT_DOUBLE_EQ(soa.log_w[i], pdf2.getW(i));
+	}
+}
+
+TEST(TPoseParticlesSoA, CPose3DPDFParticles)
+{
+	auto& rng = mrpt::random::getRandomGenerator();
+	rng.randomize(4321);
+
+	CPose3DPDFParticles pdf(50);
+	for (size_t i = 0; i < pdf.size(); i++)
+	{
+		pdf.m_particles[i].d = TPose3D(
+			rng.drawUniform(-5.0, 5.0), rng.drawUniform(-5.0, 5.0),
+			rng.drawUniform(-1.0, 1.0), rng.drawUniform(-M_PI, M_PI),
+			rng.drawUniform(-1.0, 1.0), rng.drawUniform(-M_PI, M_PI));
+		pdf.m_particles[i].log_w = rng.drawUniform(-3.0, 0.0);
+	}
+
+	TPoseParticlesSoA3D soa;
+	pdf.getParticlesSoA(soa);
+
+	const TPose3D Ap(0.5, 0.1, -0.2, 0.3, -0.4, 0.2);
+	soa.composeIncrement(Ap);
+
+	TPoseParticlesSoA3D incrs;
+	incrs.resize(soa.size());
+	for (size_t i = 0; i < incrs.size(); i++)
+		incrs.setPose(i, TPose3D(0.1 * i, 0, 0.2, -0.01 * i, 0.1, 0));
+	soa.composeIncrements(incrs);
+
+	for (size_t i = 0; i < soa.size(); i++)
+	{
+		const CPose3D expected = CPose3D(pdf.getParticlePose(i)) +
+			CPose3D(Ap) + CPose3D(incrs.getPose(i));
+		const CPose3D p(soa.getPose(i));
+		EXPECT_NEAR((expected.asVectorVal() - p.asVectorVal()).norm(), 0, 1e-9)
+			<< "expected=" << expected << " p=" << p;
+	}
+
+	EXPECT_NEAR(pdf.ESS(), soa.ESS(), 1e-9);
+	soa.performSubstitution({3, 3, 7});
+	ASSERT_EQ(soa.size(), 3U);
+	EXPECT_EQ(soa.getPose(0), soa.getPose(1));
+	EXPECT_DOUBLE_EQ(soa.log_w[2], pdf.getW(7));
+}
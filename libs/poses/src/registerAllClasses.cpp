@@ -26,6 +26,7 @@
 #include <mrpt/poses/CPose3DPDFGrid.h>
 #include <mrpt/poses/CPose3DPDFParticles.h>
 #include <mrpt/poses/CPose3DPDFSOG.h>
+#include <mrpt/poses/CPose3DPDFSparseGrid.h>
 #include <mrpt/poses/CPose3DQuat.h>
 #include <mrpt/poses/CPose3DQuatPDF.h>
 #include <mrpt/poses/CPose3DQuatPDFGaussian.h>
@@ -36,6 +37,7 @@
 #include <mrpt/poses/CPosePDFGrid.h>
 #include <mrpt/poses/CPosePDFParticles.h>
 #include <mrpt/poses/CPosePDFSOG.h>
+#include <mrpt/poses/CPosePDFSparseGrid.h>
 #include <mrpt/poses/CPoses2DSequence.h>
 #include <mrpt/poses/CPoses3DSequence.h>
 #include <mrpt/poses/registerAllClasses.h>
@@ -60,6 +62,7 @@ MRPT_INITIALIZER(registerAllClasses_mrpt_poses)
 	registerClass(CLASS_ID(CPosePDFGaussianInf));
 	registerClass(CLASS_ID(CPosePDFParticles));
 	registerClass(CLASS_ID(CPosePDFGrid));
+	registerClass(CLASS_ID(CPosePDFSparseGrid));
 	registerClass(CLASS_ID(CPosePDFSOG));
 
 	registerClass(CLASS_ID(CPointPDF));
@@ -75,6 +78,7 @@ MRPT_INITIALIZER(registerAllClasses_mrpt_poses)
 	registerClass(CLASS_ID(CPose3DPDFParticles));
 	registerClass(CLASS_ID(CPose3DPDFSOG));
 	registerClass(CLASS_ID(CPose3DPDFGrid));
+	registerClass(CLASS_ID(CPose3DPDFSparseGrid));
 
 	registerClass(CLASS_ID(CPose3DQuatPDF));
 	registerClass(CLASS_ID(CPose3DQuatPDFGaussian));
@@ -0,0 +1,90 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "poses-precomp.h"	// Precompiled headers
+//
+#include <mrpt/config.h>
+
+#include "transform_points_kernels.h"
+
+// ---------------------------------------------------------------------------
+//   This file contains the AVX2 version of the batched point transformation
+//   kernels of CPose3D::composePoints() and CPose2D::composePoints(). It is
+//   built with "-mavx2" (see DeclareMRPTLib.cmake), and only called if the
+//   CPU supports AVX2.
+// ---------------------------------------------------------------------------
+#if MRPT_ARCH_INTEL_COMPATIBLE
+#include <immintrin.h>
+#endif
+
+using namespace mrpt::poses::detail;
+
+void mrpt::poses::detail::transform_points_3D_AVX2(
+	const float M[12], const float* lx, const float* ly, const float* lz,
+	float* gx, float* gy, float* gz, std::size_t n)
+{
+	std::size_t i = 0;
+#if MRPT_ARCH_INTEL_COMPATIBLE
+	__m256 m[12];
+	for (int k = 0; k < 12; k++)
+		m[k] = _mm256_set1_ps(M[k]);
+
+	// 8 points at a time. All inputs are loaded before storing, so it also
+	// works in place:
+	for (; i + 8 <= n; i += 8)
+	{
+		const __m256 x = _mm256_loadu_ps(lx + i);
+		const __m256 y = _mm256_loadu_ps(ly + i);
+		const __m256 z = _mm256_loadu_ps(lz + i);
+		__m256 r[3];
+		for (int k = 0; k < 3; k++)
+			r[k] = _mm256_add_ps(
+				_mm256_add_ps(
+					_mm256_add_ps(
+						_mm256_mul_ps(m[4 * k], x),
+						_mm256_mul_ps(m[4 * k + 1], y)),
+					_mm256_mul_ps(m[4 * k + 2], z)),
+				m[4 * k + 3]);
+		_mm256_storeu_ps(gx + i, r[0]);
+		_mm256_storeu_ps(gy + i, r[1]);
+		_mm256_storeu_ps(gz + i, r[2]);
+	}
+#endif
+	// Remaining points:
+	transform_points_3D_portable(
+		M, lx + i, ly + i, lz + i, gx + i, gy + i, gz + i, n - i);
+}
+
+void mrpt::poses::detail::transform_points_2D_AVX2(
+	const float M[6], const float* lx, const float* ly, float* gx, float* gy,
+	std::size_t n)
+{
+	std::size_t i = 0;
+#if MRPT_ARCH_INTEL_COMPATIBLE
+	__m256 m[6];
+	for (int k = 0; k < 6; k++)
+		m[k] = _mm256_set1_ps(M[k]);
+
+	for (; i + 8 <= n; i += 8)
+	{
+		const __m256 x = _mm256_loadu_ps(lx + i);
+		const __m256 y = _mm256_loadu_ps(ly + i);
+		const __m256 rx = _mm256_add_ps(
+			_mm256_add_ps(_mm256_mul_ps(m[0], x), _mm256_mul_ps(m[1], y)),
+			m[2]);
+		const __m256 ry = _mm256_add_ps(
+			_mm256_add_ps(_mm256_mul_ps(m[3], x), _mm256_mul_ps(m[4], y)),
+			m[5]);
+		_mm256_storeu_ps(gx + i, rx);
+		_mm256_storeu_ps(gy + i, ry);
+	}
+#endif
+	// Remaining points:
+	transform_points_2D_portable(M, lx + i, ly + i, gx + i, gy + i, n - i);
+}
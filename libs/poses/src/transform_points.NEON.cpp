@@ -0,0 +1,83 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "poses-precomp.h"	// Precompiled headers
+//
+#include <mrpt/config.h>
+
+#include "transform_points_kernels.h"
+
+// ---------------------------------------------------------------------------
+//   This file contains the ARM NEON version of the batched point
+//   transformation kernels. NEON is always available in aarch64, so this file
+//   needs no special build flags.
+// ---------------------------------------------------------------------------
+#if defined(__ARM_NEON) || defined(__aarch64__)
+#define MRPT_POSES_BUILD_NEON 1
+#include <arm_neon.h>
+#else
+#define MRPT_POSES_BUILD_NEON 0
+#endif
+
+using namespace mrpt::poses::detail;
+
+void mrpt::poses::detail::transform_points_3D_NEON(
+	const float M[12], const float* lx, const float* ly, const float* lz,
+	float* gx, float* gy, float* gz, std::size_t n)
+{
+	std::size_t i = 0;
+#if MRPT_POSES_BUILD_NEON
+	// 4 points at a time. All inputs are loaded before storing, so it also
+	// works in place:
+	for (; i + 4 <= n; i += 4)
+	{
+		const float32x4_t x = vld1q_f32(lx + i);
+		const float32x4_t y = vld1q_f32(ly + i);
+		const float32x4_t z = vld1q_f32(lz + i);
+		float32x4_t r[3];
+		for (int k = 0; k < 3; k++)
+		{
+			r[k] = vmulq_n_f32(x, M[4 * k]);
+			r[k] = vmlaq_n_f32(r[k], y, M[4 * k + 1]);
+			r[k] = vmlaq_n_f32(r[k], z, M[4 * k + 2]);
+			r[k] = vaddq_f32(r[k], vdupq_n_f32(M[4 * k + 3]));
+		}
+		vst1q_f32(gx + i, r[0]);
+		vst1q_f32(gy + i, r[1]);
+		vst1q_f32(gz + i, r[2]);
+	}
+#endif
+	// Remaining points:
+	transform_points_3D_portable(
+		M, lx + i, ly + i, lz + i, gx + i, gy + i, gz + i, n - i);
+}
+
+void mrpt::poses::detail::transform_points_2D_NEON(
+	const float M[6], const float* lx, const float* ly, float* gx, float* gy,
+	std::size_t n)
+{
+	std::size_t i = 0;
+#if MRPT_POSES_BUILD_NEON
+	for (; i + 4 <= n; i += 4)
+	{
+		const float32x4_t x = vld1q_f32(lx + i);
+		const float32x4_t y = vld1q_f32(ly + i);
+		float32x4_t rx = vmulq_n_f32(x, M[0]);
+		rx = vmlaq_n_f32(rx, y, M[1]);
+		rx = vaddq_f32(rx, vdupq_n_f32(M[2]));
+		float32x4_t ry = vmulq_n_f32(x, M[3]);
+		ry = vmlaq_n_f32(ry, y, M[4]);
+		ry = vaddq_f32(ry, vdupq_n_f32(M[5]));
+		vst1q_f32(gx + i, rx);
+		vst1q_f32(gy + i, ry);
+	}
+#endif
+	// Remaining points:
+	transform_points_2D_portable(M, lx + i, ly + i, gx + i, gy + i, n - i);
+}
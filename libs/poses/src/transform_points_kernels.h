@@ -0,0 +1,100 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/core/cpu.h>
+
+#include <cstddef>
+
+namespace mrpt::poses::detail
+{
+/** Applies the 3x4 transformation `M` (row-major: `[R | t]`) to `n` points:
+ * `g[i] = R * l[i] + t`. Output arrays may be the same than input ones. */
+using transform_points_3D_t = void (*)(
+	const float M[12], const float* lx, const float* ly, const float* lz,
+	float* gx, float* gy, float* gz, std::size_t n);
+
+/** Applies the 2x3 transformation `M` (row-major: `[R | t]`) to `n` 2D
+ * points. Output arrays may be the same than input ones. */
+using transform_points_2D_t = void (*)(
+	const float M[6], const float* lx, const float* ly, float* gx, float* gy,
+	std::size_t n);
+
+template <typename T>
+inline void transform_points_3D_portable(
+	const T M[12], const T* lx, const T* ly, const T* lz, T* gx, T* gy, T* gz,
+	std::size_t n)
+{
+	for (std::size_t i = 0; i < n; i++)
+	{
+		const T x = lx[i], y = ly[i], z = lz[i];
+		gx[i] = M[0] * x + M[1] * y + M[2] * z + M[3];
+		gy[i] = M[4] * x + M[5] * y + M[6] * z + M[7];
+		gz[i] = M[8] * x + M[9] * y + M[10] * z + M[11];
+	}
+}
+
+template <typename T>
+inline void transform_points_2D_portable(
+	const T M[6], const T* lx, const T* ly, T* gx, T* gy, std::size_t n)
+{
+	for (std::size_t i = 0; i < n; i++)
+	{
+		const T x = lx[i], y = ly[i];
+		gx[i] = M[0] * x + M[1] * y + M[2];
+		gy[i] = M[3] * x + M[4] * y + M[5];
+	}
+}
+
+/** Only call it if mrpt::cpu::supports(mrpt::cpu::feature::AVX2) */
+void transform_points_3D_AVX2(
+	const float M[12], const float* lx, const float* ly, const float* lz,
+	float* gx, float* gy, float* gz, std::size_t n);
+/** Only call it if mrpt::cpu::supports(mrpt::cpu::feature::AVX2) */
+void transform_points_2D_AVX2(
+	const float M[6], const float* lx, const float* ly, float* gx, float* gy,
+	std::size_t n);
+
+/** Only call it if mrpt::cpu::supports(mrpt::cpu::feature::NEON) */
+void transform_points_3D_NEON(
+	const float M[12], const float* lx, const float* ly, const float* lz,
+	float* gx, float* gy, float* gz, std::size_t n);
+/** Only call it if mrpt::cpu::supports(mrpt::cpu::feature::NEON) */
+void transform_points_2D_NEON(
+	const float M[6], const float* lx, const float* ly, float* gx, float* gy,
+	std::size_t n);
+
+/** The fastest kernels for this CPU */
+struct TTransformPointsKernels
+{
+	transform_points_3D_t tf3D = &transform_points_3D_portable<float>;
+	transform_points_2D_t tf2D = &transform_points_2D_portable<float>;
+};
+
+inline const TTransformPointsKernels& transformPointsKernels()
+{
+	static const TTransformPointsKernels k = []() {
+		using mrpt::cpu::feature;
+		TTransformPointsKernels r;
+		if (mrpt::cpu::supports(feature::AVX2))
+		{
+			r.tf3D = &transform_points_3D_AVX2;
+			r.tf2D = &transform_points_2D_AVX2;
+		}
+		else if (mrpt::cpu::supports(feature::NEON))
+		{
+			r.tf3D = &transform_points_3D_NEON;
+			r.tf2D = &transform_points_2D_NEON;
+		}
+		return r;
+	}();
+	return k;
+}
+
+}  // namespace mrpt::poses::detail
@@ -8,10 +8,13 @@
    +------------------------------------------------------------------------+ */
 #pragma once
 
+#include <mrpt/random/random_fill.h>
 #include <mrpt/random/random_shuffle.h>
 
 #include <algorithm>
+#include <array>
 #include <cstddef>
+#include <cstdint>
 #include <limits>
 #include <limits>  // numeric_limits
 #include <random>
@@ -65,6 +68,153 @@ class Generator_MT19937
 	void generateNumbers();
 };
 
+/** Portable xoshiro256++ random generator, C++11 UniformRandomBitGenerator
+ * compliant, with 64-bit outputs, 256 bits of state and a period of 2^256-1.
+ *
+ * It is much faster than MT19937 and supports jumping ahead 2^128 numbers
+ * with jump(), which provides non-overlapping streams for parallel code:
+ * stream `i` of a seed is the sequence after `i` jumps (see seed()). Each
+ * jump costs about as much as drawing a thousand numbers, so
+ * Generator_Philox4x32 is better suited for thousands of streams.
+ *
+ * Reference: D. Blackman and S. Vigna, "Scrambled linear pseudorandom number
+ * generators", ACM Trans. Math. Softw., 2021. https://prng.di.unimi.it/
+ *
+ * \ingroup mrpt_random_grp
+ * \note (New in MRPT 2.4.9)
+ */
+class Generator_Xoshiro256pp
+{
+   public:
+	using result_type = uint64_t;
+	static constexpr result_type min()
+	{
+		return std::numeric_limits<result_type>::min();
+	}
+	static constexpr result_type max()
+	{
+		return std::numeric_limits<result_type>::max();
+	}
+
+	/** Initializes the state with seed()=0 */
+	Generator_Xoshiro256pp() { seed(0); }
+	/** Initializes the state with seed() */
+	explicit Generator_Xoshiro256pp(uint64_t seedValue, uint64_t stream = 0)
+	{
+		seed(seedValue, stream);
+	}
+
+	result_type operator()()
+	{
+		const uint64_t result = rotl(m_s[0] + m_s[3], 23) + m_s[0];
+		const uint64_t t = m_s[1] << 17;
+		m_s[2] ^= m_s[0];
+		m_s[3] ^= m_s[1];
+		m_s[1] ^= m_s[2];
+		m_s[0] ^= m_s[3];
+		m_s[2] ^= t;
+		m_s[3] = rotl(m_s[3], 45);
+		return result;
+	}
+
+	/** Initializes the state from a 64-bit seed (expanded with SplitMix64),
+	 * then jumps to the given stream index, so different streams of one seed
+	 * never overlap for 2^128 numbers. */
+	void seed(uint64_t seedValue, uint64_t stream = 0);
+
+	/** Advances the state as 2^128 calls to operator() */
+	void jump();
+	/** Advances the state as 2^192 calls to operator() */
+	void longJump();
+
+	/** Raw generator state, which must not be all zeros */
+	const std::array<uint64_t, 4>& state() const { return m_s; }
+	void setState(const std::array<uint64_t, 4>& s);
+
+   private:
+	std::array<uint64_t, 4> m_s;
+
+	static uint64_t rotl(const uint64_t x, int k)
+	{
+		return (x << k) | (x >> (64 - k));
+	}
+	void jump(const std::array<uint64_t, 4>& poly);
+};
+
+/** Portable Philox4x32-10 counter-based random generator, C++11
+ * UniformRandomBitGenerator compliant.
+ *
+ * Each block of four 32-bit outputs is a keyed bijection of a 128-bit
+ * counter, so there is no state to be advanced: discard() is O(1), and any
+ * number of independent streams of one seed are obtained just by changing
+ * the upper half of the counter (the `stream` of seed()). Typical usage is
+ * one stream per particle, sample or work item, which gives the same results
+ * regardless of which thread processes each item:
+ *
+ * \code
+ * mrpt::random::Generator_Philox4x32 rng(seed, particleIndex);
+ * mrpt::random::fillGaussian(rng, noise.data(), noise.size());
+ * \endcode
+ *
+ * Reference: J. K. Salmon et al., "Parallel random numbers: as easy as 1, 2,
+ * 3", SC'11. Outputs match the Random123 known-answer test vectors.
+ *
+ * \ingroup mrpt_random_grp
+ * \note (New in MRPT 2.4.9)
+ */
+class Generator_Philox4x32
+{
+   public:
+	using result_type = uint32_t;
+	static constexpr result_type min()
+	{
+		return std::numeric_limits<result_type>::min();
+	}
+	static constexpr result_type max()
+	{
+		return std::numeric_limits<result_type>::max();
+	}
+
+	using counter_t = std::array<uint32_t, 4>;
+	using key_t = std::array<uint32_t, 2>;
+
+	/** Initializes the generator with seed()=0 */
+	Generator_Philox4x32() = default;
+	/** Initializes the generator with seed() */
+	explicit Generator_Philox4x32(uint64_t seedValue, uint64_t stream = 0)
+	{
+		seed(seedValue, stream);
+	}
+
+	result_type operator()()
+	{
+		const auto i = static_cast<unsigned int>(m_pos & 3);
+		if (i == 0) generateBlock(m_pos >> 2);
+		m_pos++;
+		return m_out[i];
+	}
+
+	/** Sets the key from the seed, and selects a stream (the upper 64 bits
+	 * of the counter). Resets the position within the stream to zero. */
+	void seed(uint64_t seedValue, uint64_t stream = 0);
+
+	/** Skips `n` outputs, in constant time */
+	void discard(uint64_t n);
+
+	/** Number of outputs drawn (or discarded) since seed() */
+	uint64_t position() const { return m_pos; }
+
+	/** The Philox4x32-10 bijection, mapping a counter to 128 random bits */
+	static counter_t Block(const counter_t& ctr, const key_t& key);
+
+   private:
+	key_t m_key{{0, 0}};
+	uint64_t m_stream = 0, m_pos = 0;
+	counter_t m_out{{0, 0, 0, 0}};
+
+	void generateBlock(uint64_t block);
+};
+
 /** A thred-safe pseudo random number generator, based on an internal MT19937
  * randomness generator.
  * The base algorithm for randomness is platform-independent. See
@@ -162,6 +312,23 @@ class CRandomGenerator
 					drawUniform(unif_min, unif_max));
 	}
 
+	/** Fills `n` values with independent, uniformly distributed samples, in
+	 * bulk with mrpt::random::fillUniform().
+	 * \note (New in MRPT 2.4.9) */
+	template <typename T>
+	void fillUniform(
+		T* data, size_t n, const double unif_min = 0, const double unif_max = 1)
+	{
+		mrpt::random::fillUniform(m_MT19937, data, n, unif_min, unif_max);
+	}
+	/** \overload For containers with `data()` and `size()` */
+	template <class VEC, typename = internal::has_data_t<VEC>>
+	void fillUniform(
+		VEC& v, const double unif_min = 0, const double unif_max = 1)
+	{
+		mrpt::random::fillUniform(m_MT19937, v, unif_min, unif_max);
+	}
+
 	/** Fills the given vector with independent, uniformly distributed samples.
 	 * \sa drawUniform
 	 */
@@ -197,6 +364,23 @@ class CRandomGenerator
 		return static_cast<return_t>(mean + std * drawGaussian1D_normalized());
 	}
 
+	/** Fills `n` values with independent, normally distributed samples, in
+	 * bulk with the vectorizable mrpt::random::fillGaussian(). Faster than
+	 * drawGaussian1DVector(), but the sequence of numbers differs.
+	 * \note (New in MRPT 2.4.9) */
+	template <typename T>
+	void fillGaussian(
+		T* data, size_t n, const double mean = 0, const double std = 1)
+	{
+		mrpt::random::fillGaussian(m_MT19937, data, n, mean, std);
+	}
+	/** \overload For containers with `data()` and `size()` */
+	template <class VEC, typename = internal::has_data_t<VEC>>
+	void fillGaussian(VEC& v, const double mean = 0, const double std = 1)
+	{
+		mrpt::random::fillGaussian(m_MT19937, v, mean, std);
+	}
+
 	/** Fills the given matrix with independent, 1D-normally distributed
 	 * samples.
 	 * Matrix classes can be mrpt::math::CMatrixDynamic or
@@ -318,7 +502,7 @@ class CRandomGenerator
 		{
 			const auto s = std::sqrt(eigVals[c]);
 			for (typename COVMATRIX::Index r = 0; r < eigVecs.rows(); r++)
-				eigVecs(c, r) *= s;
+				eigVecs(r, c) *= s;
 		}
 
 		// Set size of output vector:
@@ -366,7 +550,7 @@ class CRandomGenerator
 		{
 			const auto s = std::sqrt(eigVals[c]);
 			for (typename COVMATRIX::Index r = 0; r < eigVecs.rows(); r++)
-				eigVecs(c, r) *= s;
+				eigVecs(r, c) *= s;
 		}
 
 		// Set size of output vector:
@@ -417,8 +601,12 @@ class CRandomGenerator
 };	// end of CRandomGenerator
 // --------------------------------------------------------------
 
-/** A static instance of a CRandomGenerator class, for use in single-thread
- * applications */
+/** A static instance of a CRandomGenerator class. It is `thread_local`: each
+ * thread has its own instance, seeded from std::random_device unless
+ * randomize() is called from that thread.
+ * For reproducible parallel code, use one Generator_Philox4x32 or
+ * Generator_Xoshiro256pp stream per thread or work item instead.
+ */
 CRandomGenerator& getRandomGenerator();
 
 /** A random number generator for usage in STL algorithms expecting a function
@@ -0,0 +1,182 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>	// declval
+#include <vector>
+
+namespace mrpt::random
+{
+namespace internal
+{
+/** A uniform double in [0,1), with 53 bits of resolution for 64-bit
+ * generators and 32 bits otherwise */
+template <class URBG>
+inline double uniform01(URBG& g)
+{
+	using result_t = typename URBG::result_type;
+	static_assert(
+		URBG::min() == 0 &&
+			URBG::max() == std::numeric_limits<result_t>::max() &&
+			(sizeof(result_t) == 4 || sizeof(result_t) == 8),
+		"Requires a generator of full-range 32 or 64 bit numbers");
+	if constexpr (sizeof(result_t) == 8) return (g() >> 11) * 0x1.0p-53;
+	else
+		return g() * 0x1.0p-32;
+}
+
+template <class VEC>
+using has_data_t =
+	decltype(std::declval<VEC&>().data(), std::declval<VEC&>().size());
+}  // namespace internal
+
+/** Fills `n` values with independent, uniformly distributed samples in
+ * [min,max), using any generator of full-range 32 or 64-bit numbers (e.g.
+ * Generator_MT19937, Generator_Xoshiro256pp, Generator_Philox4x32).
+ * \ingroup mrpt_random_grp
+ * \note (New in MRPT 2.4.9)
+ */
+template <class URBG, typename T>
+void fillUniform(
+	URBG& g, T* data, size_t n, const double min = 0, const double max = 1)
+{
+	const double k = max - min;
+	for (size_t i = 0; i < n; i++)
+		data[i] = static_cast<T>(min + k * internal::uniform01(g));
+}
+
+/** Fills `n` values with independent, normally distributed samples.
+ *
+ * Uses the Box-Muller transform on blocks of uniform samples, with the
+ * transcendental functions in separate loops without dependencies between
+ * iterations, which compilers can vectorize. Much faster than one
+ * std::normal_distribution call per sample, but gives different sequences
+ * than CRandomGenerator::drawGaussian1D().
+ *
+ * \ingroup mrpt_random_grp
+ * \note (New in MRPT 2.4.9)
+ */
+template <class URBG, typename T>
+void fillGaussian(
+	URBG& g, T* data, size_t n, const double mean = 0, const double std = 1)
+{
+	constexpr size_t BLOCK = 64;  // pairs of samples
+	constexpr double TWO_PI = 6.283185307179586476925286766559;
+	double r[BLOCK], a[BLOCK];
+
+	for (size_t i = 0; i < n;)
+	{
+		const size_t nPairs = std::min(BLOCK, (n - i + 1) / 2);
+		// u1 in (0,1], to avoid log(0):
+		for (size_t k = 0; k < nPairs; k++)
+		{
+			r[k] = 1.0 - internal::uniform01(g);
+			a[k] = TWO_PI * internal::uniform01(g);
+		}
+		for (size_t k = 0; k < nPairs; k++)
+			r[k] = std * std::sqrt(-2.0 * std::log(r[k]));
+
+		T* out = data + i;
+		const size_t nOut = std::min(2 * nPairs, n - i);
+		for (size_t k = 0; k < nOut / 2; k++)
+		{
+			out[2 * k] = static_cast<T>(mean + r[k] * std::cos(a[k]));
+			out[2 * k + 1] = static_cast<T>(mean + r[k] * std::sin(a[k]));
+		}
+		if (nOut & 1)
+			out[nOut - 1] =
+				static_cast<T>(mean + r[nPairs - 1] * std::cos(a[nPairs - 1]));
+		i += nOut;
+	}
+}
+
+/** \overload For any container with `data()` and `size()`, like std::vector
+ * or mrpt::math::CVectorDynamic */
+template <class URBG, class VEC, typename = internal::has_data_t<VEC>>
+void fillUniform(
+	URBG& g, VEC& v, const double min = 0, const double max = 1)
+{
+	fillUniform(g, v.data(), static_cast<size_t>(v.size()), min, max);
+}
+
+/** \overload For any container with `data()` and `size()`, like std::vector
+ * or mrpt::math::CVectorDynamic */
+template <class URBG, class VEC, typename = internal::has_data_t<VEC>>
+void fillGaussian(
+	URBG& g, VEC& v, const double mean = 0, const double std = 1)
+{
+	fillGaussian(g, v.data(), static_cast<size_t>(v.size()), mean, std);
+}
+
+/** Generates a given number of multidimensional samples of a Gaussian
+ * distribution with the given covariance matrix (and `mean`, or zero if
+ * nullptr), drawing all the normalized samples at once with fillGaussian().
+ *
+ * \param ret The output list of samples, e.g. a `std::vector` of
+ *        `std::vector<double>` or mrpt::math::CVectorDouble.
+ * \exception std::exception On invalid covariance matrix
+ * \ingroup mrpt_random_grp
+ * \note (New in MRPT 2.4.9)
+ */
+template <class URBG, typename VECTOR_OF_VECTORS, typename COVMATRIX>
+void drawGaussianMultivariateMany(
+	URBG& g, VECTOR_OF_VECTORS& ret, size_t desiredSamples,
+	const COVMATRIX& cov,
+	const typename VECTOR_OF_VECTORS::value_type* mean = nullptr)
+{
+	using scalar_t = typename COVMATRIX::Scalar;
+	using index_t = typename COVMATRIX::Index;
+	const index_t N = cov.rows();
+	if (cov.rows() != cov.cols())
+		throw std::runtime_error(
+			"drawGaussianMultivariateMany(): cov is not square.");
+	if (mean && size_t(mean->size()) != size_t(N))
+		throw std::runtime_error(
+			"drawGaussianMultivariateMany(): mean and cov sizes ");
+
+	// cov = V*D*V^T, samples are V*sqrt(D)*z, with z ~ N(0,I):
+	COVMATRIX L;
+	std::vector<scalar_t> eigVals;
+	if (!cov.eig_symmetric(L, eigVals, false /*sorted*/))
+		throw std::runtime_error(
+			"drawGaussianMultivariateMany(): eigen decomposition failed.");
+	for (index_t c = 0; c < N; c++)
+	{
+		const scalar_t s = std::sqrt(std::max<scalar_t>(eigVals[c], 0));
+		for (index_t r = 0; r < N; r++)
+			L(r, c) *= s;
+	}
+
+	std::vector<scalar_t> z(desiredSamples * size_t(N));
+	fillGaussian(g, z.data(), z.size());
+
+	ret.resize(desiredSamples);
+	for (size_t k = 0; k < desiredSamples; k++)
+	{
+		auto& out = ret[k];
+		out.resize(N);
+		const scalar_t* zk = z.data() + k * size_t(N);
+		for (index_t d = 0; d < N; d++)
+		{
+			scalar_t acc = mean ? (*mean)[d] : 0;
+			for (index_t i = 0; i < N; i++)
+				acc += L(d, i) * zk[i];
+			out[d] = acc;
+		}
+	}
+}
+
+}  // namespace mrpt::random
@@ -88,6 +88,108 @@ void Generator_MT19937::seed(const uint32_t seed)
 	m_index = 0;
 }
 
+// xoshiro256++ reference implementation: https://prng.di.unimi.it/
+void Generator_Xoshiro256pp::seed(uint64_t seedValue, uint64_t stream)
+{
+	// SplitMix64, as recommended by the authors:
+	uint64_t x = seedValue;
+	for (auto& s : m_s)
+	{
+		uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+		s = z ^ (z >> 31);
+	}
+	for (uint64_t i = 0; i < stream; i++)
+		jump();
+}
+
+void Generator_Xoshiro256pp::setState(const std::array<uint64_t, 4>& s)
+{
+	if (!s[0] && !s[1] && !s[2] && !s[3])
+		throw std::invalid_argument(
+			"Generator_Xoshiro256pp: state must not be all zeros");
+	m_s = s;
+}
+
+void Generator_Xoshiro256pp::jump(const std::array<uint64_t, 4>& poly)
+{
+	std::array<uint64_t, 4> s = {0, 0, 0, 0};
+	for (const uint64_t p : poly)
+	{
+		for (int b = 0; b < 64; b++)
+		{
+			if (p & (uint64_t(1) << b))
+				for (int i = 0; i < 4; i++)
+					s[i] ^= m_s[i];
+			(*this)();
+		}
+	}
+	m_s = s;
+}
+
+void Generator_Xoshiro256pp::jump()
+{
+	jump({0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL, 0xa9582618e03fc9aaULL,
+		  0x39abdc4529b1661cULL});
+}
+
+void Generator_Xoshiro256pp::longJump()
+{
+	jump({0x76e15d3efefdcbbfULL, 0xc5004e441c522fb3ULL, 0x77710069854ee241ULL,
+		  0x39109bb02acbe635ULL});
+}
+
+// Philox4x32-10, as in Random123: https://github.com/DEShawResearch/random123
+Generator_Philox4x32::counter_t Generator_Philox4x32::Block(
+	const counter_t& ctr, const key_t& key)
+{
+	constexpr uint32_t M0 = 0xD2511F53, M1 = 0xCD9E8D57;
+	constexpr uint32_t W0 = 0x9E3779B9, W1 = 0xBB67AE85;
+
+	counter_t c = ctr;
+	key_t k = key;
+	for (int round = 0; round < 10; round++)
+	{
+		if (round > 0)
+		{
+			k[0] += W0;
+			k[1] += W1;
+		}
+		const uint64_t p0 = uint64_t(M0) * c[0];
+		const uint64_t p1 = uint64_t(M1) * c[2];
+		c = {static_cast<uint32_t>(p1 >> 32) ^ c[1] ^ k[0],
+			 static_cast<uint32_t>(p1),
+			 static_cast<uint32_t>(p0 >> 32) ^ c[3] ^ k[1],
+			 static_cast<uint32_t>(p0)};
+	}
+	return c;
+}
+
+void Generator_Philox4x32::seed(uint64_t seedValue, uint64_t stream)
+{
+	m_key = {static_cast<uint32_t>(seedValue),
+			 static_cast<uint32_t>(seedValue >> 32)};
+	m_stream = stream;
+	m_pos = 0;
+}
+
+void Generator_Philox4x32::discard(uint64_t n)
+{
+	m_pos += n;
+	// In the middle of a block? Compute it now:
+	if (m_pos & 3) generateBlock(m_pos >> 2);
+}
+
+void Generator_Philox4x32::generateBlock(uint64_t block)
+{
+	m_out = Block(
+		{static_cast<uint32_t>(block), static_cast<uint32_t>(block >> 32),
+		 static_cast<uint32_t>(m_stream),
+		 static_cast<uint32_t>(m_stream >> 32)},
+		m_key);
+}
+
 CRandomGenerator& mrpt::random::getRandomGenerator() { return randomGenerator; }
 uint64_t CRandomGenerator::drawUniform64bit() { return m_uint64(m_MT19937); }
 uint32_t CRandomGenerator::drawUniform32bit() { return m_uint32(m_MT19937); }
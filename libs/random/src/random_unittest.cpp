@@ -180,3 +180,120 @@ TEST(Random, shuffle)
 		EXPECT_EQ(list2, std::vector<int>({3, 5, 8, 0, 7, 1, 6, 2, 4, 9}));
 	}
 }
+
+TEST(Random, Philox4x32_KnownAnswers)
+{
+	using mrpt::random::Generator_Philox4x32;
+
+	// Random123 known-answer test vectors for philox4x32-10:
+	EXPECT_EQ(
+		Generator_Philox4x32::Block({0, 0, 0, 0}, {0, 0}),
+		Generator_Philox4x32::counter_t(
+			{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}));
+	EXPECT_EQ(
+		Generator_Philox4x32::Block(
+			{0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344},
+			{0xa4093822, 0x299f31d0}),
+		Generator_Philox4x32::counter_t(
+			{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}));
+
+	// Streams and O(1) discard():
+	Generator_Philox4x32 a(1234, 5), b(1234, 5), other(1234, 6);
+	std::vector<uint32_t> seqA(20);
+	for (auto& v : seqA)
+		v = a();
+	b.discard(7);
+	EXPECT_EQ(b(), seqA[7]);
+	EXPECT_EQ(b(), seqA[8]);
+	b.discard(3);
+	EXPECT_EQ(b(), seqA[12]);
+	EXPECT_EQ(b.position(), 13U);
+	EXPECT_NE(other(), seqA[0]);
+}
+
+TEST(Random, Xoshiro256pp)
+{
+	using mrpt::random::Generator_Xoshiro256pp;
+
+	// Reference outputs from the state {1,2,3,4}:
+	Generator_Xoshiro256pp g;
+	g.setState({1, 2, 3, 4});
+	EXPECT_EQ(g(), 41943041ULL);
+	EXPECT_EQ(g(), 58720359ULL);
+	EXPECT_EQ(g(), 3588806011781223ULL);
+	EXPECT_EQ(g(), 3591011842654386ULL);
+
+	// Streams are the same sequence after jump():
+	Generator_Xoshiro256pp s0(42), s2(42, 2);
+	s0.jump();
+	s0.jump();
+	EXPECT_EQ(s0.state(), s2.state());
+	EXPECT_NE(Generator_Xoshiro256pp(42, 1)(), Generator_Xoshiro256pp(42)());
+}
+
+TEST(Random, fillGaussian)
+{
+	mrpt::random::Generator_Xoshiro256pp g(1);
+	for (const size_t N : {1U, 2U, 127U, 100001U})
+	{
+		std::vector<double> v(N, -999.0);
+		mrpt::random::fillGaussian(g, v, 3.0, 2.0);
+		for (const double x : v)
+			EXPECT_NE(x, -999.0);
+		if (N < 1000) continue;
+
+		double mean = 0, var = 0;
+		for (const double x : v)
+			mean += x;
+		mean /= N;
+		for (const double x : v)
+			var += (x - mean) * (x - mean);
+		var /= N;
+		EXPECT_NEAR(mean, 3.0, 0.05);
+		EXPECT_NEAR(var, 4.0, 0.1);
+	}
+
+	mrpt::random::CRandomGenerator rnd(1);
+	std::vector<float> u(1000);
+	rnd.fillUniform(u, 2.0, 3.0);
+	for (const float x : u)
+	{
+		EXPECT_GE(x, 2.0f);
+		EXPECT_LE(x, 3.0f);
+	}
+}
+
+TEST(Random, drawGaussianMultivariateManyCorrelated)
+{
+	mrpt::math::CMatrixDouble33 cov;
+	cov(0, 0) = 6.0, cov(0, 1) = -5.0, cov(0, 2) = 2.0;
+	cov(1, 0) = -5.0, cov(1, 1) = 6.0, cov(1, 2) = 1.0;
+	cov(2, 0) = 2.0, cov(2, 1) = 1.0, cov(2, 2) = 7.0;
+	const std::vector<double> mean = {1.0, 2.0, 3.0};
+	const size_t nSamples = 100000;
+
+	auto lmbCheckCov = [&](const std::vector<std::vector<double>>& samples) {
+		ASSERT_EQ(samples.size(), nSamples);
+		for (int i = 0; i < 3; i++)
+		{
+			for (int j = 0; j < 3; j++)
+			{
+				double c = 0;
+				for (const auto& s : samples)
+					c += (s[i] - mean[i]) * (s[j] - mean[j]);
+				EXPECT_NEAR(c / nSamples, cov(i, j), 0.15)
+					<< "i=" << i << " j=" << j;
+			}
+		}
+	};
+
+	std::vector<std::vector<double>> samples;
+	mrpt::random::Generator_Philox4x32 g(1);
+	mrpt::random::drawGaussianMultivariateMany(
+		g, samples, nSamples, cov, &mean);
+	lmbCheckCov(samples);
+
+	mrpt::random::CRandomGenerator rnd(1);
+	rnd.drawGaussianMultivariateMany(samples, nSamples, cov, &mean);
+	lmbCheckCov(samples);
+}
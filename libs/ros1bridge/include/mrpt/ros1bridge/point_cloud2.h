@@ -42,6 +42,14 @@ bool fromROS(
 bool fromROS(
 	const sensor_msgs::PointCloud2& msg, mrpt::maps::CPointsMapXYZI& obj);
 
+/** \overload For (x,y,z,rgb) channels, with the colour packed as in PCL
+ * (0x00RRGGBB, in a float32 or uint32 field named "rgb" or "rgba").
+ * Requires point cloud fields: x,y,z (float32),rgb
+ * \note (New in MRPT 2.4.9)
+ */
+bool fromROS(
+	const sensor_msgs::PointCloud2& msg, mrpt::maps::CColouredPointsMap& obj);
+
 /** Convert sensor_msgs/PointCloud2 -> mrpt::obs::CObservationRotatingScan.
  * Requires point cloud fields: x,y,z,intensity,ring
  */
@@ -68,6 +76,21 @@ bool toROS(
 	const mrpt::maps::CSimplePointsMap& obj, const std_msgs::Header& msg_header,
 	sensor_msgs::PointCloud2& msg);
 
+/** \overload For (x,y,z,intensity) channels, all of them float32, with
+ * intensities in the range [0,255] as expected by fromROS().
+ * \note (New in MRPT 2.4.9)
+ */
+bool toROS(
+	const mrpt::maps::CPointsMapXYZI& obj,
+	const std_msgs::Header& msg_header, sensor_msgs::PointCloud2& msg);
+
+/** \overload For (x,y,z,rgb) channels, with the colour packed as in PCL.
+ * \note (New in MRPT 2.4.9)
+ */
+bool toROS(
+	const mrpt::maps::CColouredPointsMap& obj,
+	const std_msgs::Header& msg_header, sensor_msgs::PointCloud2& msg);
+
 /** @} */
 /** @} */
 
@@ -15,9 +15,13 @@
  */
 
 #include <gtest/gtest.h>
+#include <mrpt/maps/CColouredPointsMap.h>
+#include <mrpt/maps/CPointsMapXYZI.h>
 #include <mrpt/maps/CSimplePointsMap.h>
 #include <mrpt/ros1bridge/point_cloud2.h>
 
+#include <cstring>
+
 #if HAVE_PCL
 #include <pcl/common/common_headers.h>
 #include <pcl/conversions.h>
@@ -66,3 +70,98 @@ TEST(PointCloud2, basicTest)
 }
 
 #endif	// HAVE_PCL
+
+TEST(PointCloud2, roundTripXYZI)
+{
+	mrpt::maps::CPointsMapXYZI pc;
+	for (int i = 0; i < 100; i++)
+		pc.insertPointRGB(i * 0.5f, -i * 1.0f, i * 2.0f, (i % 5) * 0.25f, 0, 0);
+
+	std_msgs::Header header;
+	header.frame_id = "lidar";
+	sensor_msgs::PointCloud2 msg;
+	EXPECT_TRUE(mrpt::ros1bridge::toROS(pc, header, msg));
+	EXPECT_EQ(msg.width * msg.height, pc.size());
+	EXPECT_EQ(msg.header.frame_id, "lidar");
+	EXPECT_EQ(mrpt::ros1bridge::extractFields(msg).count("intensity"), 1U);
+
+	mrpt::maps::CPointsMapXYZI pc2;
+	ASSERT_TRUE(mrpt::ros1bridge::fromROS(msg, pc2));
+	ASSERT_EQ(pc2.size(), pc.size());
+	for (size_t i = 0; i < pc.size(); i++)
+	{
+		EXPECT_EQ(pc2.getPointsBufferRef_x()[i], pc.getPointsBufferRef_x()[i]);
+		EXPECT_EQ(pc2.getPointsBufferRef_y()[i], pc.getPointsBufferRef_y()[i]);
+		EXPECT_EQ(pc2.getPointsBufferRef_z()[i], pc.getPointsBufferRef_z()[i]);
+		EXPECT_NEAR(
+			pc2.getPointIntensity_fast(i), pc.getPointIntensity_fast(i), 1e-6);
+	}
+
+	// Without the intensity:
+	mrpt::maps::CSimplePointsMap pc3;
+	ASSERT_TRUE(mrpt::ros1bridge::fromROS(msg, pc3));
+	EXPECT_EQ(pc3.size(), pc.size());
+}
+
+TEST(PointCloud2, roundTripXYZRGB)
+{
+	mrpt::maps::CColouredPointsMap pc;
+	for (int i = 0; i < 50; i++)
+		pc.insertPointRGB(i * 0.1f, 1.0f, -1.0f, 1.0f, 0.0f, (i % 2) * 1.0f);
+
+	sensor_msgs::PointCloud2 msg;
+	EXPECT_TRUE(mrpt::ros1bridge::toROS(pc, std_msgs::Header(), msg));
+
+	mrpt::maps::CColouredPointsMap pc2;
+	ASSERT_TRUE(mrpt::ros1bridge::fromROS(msg, pc2));
+	ASSERT_EQ(pc2.size(), pc.size());
+	for (size_t i = 0; i < pc.size(); i++)
+	{
+		float R1, G1, B1, R2, G2, B2;
+		pc.getPointColor_fast(i, R1, G1, B1);
+		pc2.getPointColor_fast(i, R2, G2, B2);
+		EXPECT_NEAR(R1, R2, 1e-6);
+		EXPECT_NEAR(G1, G2, 1e-6);
+		EXPECT_NEAR(B1, B2, 1e-6);
+	}
+}
+
+TEST(PointCloud2, float64Fields)
+{
+	// A layout not converted in bulk: (x,y,z) as float64, with padding
+	sensor_msgs::PointCloud2 msg;
+	msg.height = 2;
+	msg.width = 3;
+	msg.point_step = 32;
+	msg.row_step = msg.width * msg.point_step;
+	msg.is_bigendian = false;
+	const char* names[3] = {"x", "y", "z"};
+	for (int k = 0; k < 3; k++)
+	{
+		sensor_msgs::PointField f;
+		f.name = names[k];
+		f.offset = 8 * k;
+		f.datatype = sensor_msgs::PointField::FLOAT64;
+		f.count = 1;
+		msg.fields.push_back(f);
+	}
+	msg.data.resize(msg.row_step * msg.height);
+	for (size_t i = 0; i < 6; i++)
+		for (int k = 0; k < 3; k++)
+		{
+			const double v = i * 10.0 + k;
+			std::memcpy(&msg.data[i * msg.point_step + 8 * k], &v, sizeof(v));
+		}
+
+	mrpt::maps::CSimplePointsMap pc;
+	ASSERT_TRUE(mrpt::ros1bridge::fromROS(msg, pc));
+	ASSERT_EQ(pc.size(), 6U);
+	for (size_t i = 0; i < 6; i++)
+	{
+		float x, y, z;
+		pc.getPoint(i, x, y, z);
+		EXPECT_FLOAT_EQ(x, i * 10.0f);
+		EXPECT_FLOAT_EQ(y, i * 10.0f + 1);
+		EXPECT_FLOAT_EQ(z, i * 10.0f + 2);
+	}
+}
@@ -7,6 +7,7 @@
    | Released under BSD License. See: https://www.mrpt.org/License          |
    +------------------------------------------------------------------------+ */
 
+#include <mrpt/config.h>
 #include <mrpt/maps/CColouredPointsMap.h>
 #include <mrpt/maps/CSimplePointsMap.h>
 #include <mrpt/ros2bridge/point_cloud2.h>
@@ -16,6 +17,8 @@
 #include <sensor_msgs/msg/point_cloud2.hpp>
 #include <sensor_msgs/msg/point_field.hpp>
 
+#include <cstring>
+
 using namespace mrpt::maps;
 
 namespace mrpt::ros2bridge
@@ -73,6 +76,121 @@ static void get_uint16_from_field(
 		output = 0;
 }
 
+// Whether a field can be read in place as a float32 in the byte order of this
+// machine, the common case which is converted in bulk:
+static bool is_native_float32(
+	const sensor_msgs::msg::PointCloud2& msg,
+	const sensor_msgs::msg::PointField* field)
+{
+	return field != nullptr &&
+		field->datatype == sensor_msgs::msg::PointField::FLOAT32 &&
+		field->count <= 1 && field->offset + sizeof(float) <= msg.point_step &&
+		static_cast<bool>(msg.is_bigendian) == (MRPT_IS_BIG_ENDIAN != 0);
+}
+
+static float read_float32(const unsigned char* data, uint32_t offset)
+{
+	float v;
+	std::memcpy(&v, data + offset, sizeof(v));
+	return v;
+}
+
+// Bulk conversion of native float32 (x,y,z) fields into a preallocated map.
+// `extra(i, point_data)` is called for each point to copy other fields.
+template <class EXTRA>
+static bool copy_xyz_float32(
+	const sensor_msgs::msg::PointCloud2& msg,
+	const sensor_msgs::msg::PointField& x_field,
+	const sensor_msgs::msg::PointField& y_field,
+	const sensor_msgs::msg::PointField& z_field, CPointsMap& obj, EXTRA&& extra)
+{
+	const size_t num_points = static_cast<size_t>(msg.width) * msg.height;
+	if (num_points != 0 &&
+		msg.data.size() < static_cast<size_t>(msg.height - 1) * msg.row_step +
+				static_cast<size_t>(msg.width) * msg.point_step)
+		return false;
+
+	obj.resize(num_points);
+	size_t i = 0;
+	for (unsigned int row = 0; row < msg.height; ++row)
+	{
+		const unsigned char* msg_data = &msg.data[row * msg.row_step];
+		for (uint32_t col = 0; col < msg.width;
+			 ++col, ++i, msg_data += msg.point_step)
+		{
+			obj.setPointFast(
+				i, read_float32(msg_data, x_field.offset),
+				read_float32(msg_data, y_field.offset),
+				read_float32(msg_data, z_field.offset));
+			extra(i, msg_data);
+		}
+	}
+	obj.mark_as_modified();
+	return true;
+}
+
+// Packed colour, as in PCL: a float32 or uint32 field with 0x00RRGGBB.
+static bool is_packed_rgb(
+	const sensor_msgs::msg::PointCloud2& msg,
+	const sensor_msgs::msg::PointField& field)
+{
+	return (field.name == "rgb" || field.name == "rgba") &&
+		(field.datatype == sensor_msgs::msg::PointField::FLOAT32 ||
+		 field.datatype == sensor_msgs::msg::PointField::UINT32) &&
+		field.count <= 1 && field.offset + sizeof(uint32_t) <= msg.point_step &&
+		static_cast<bool>(msg.is_bigendian) == (MRPT_IS_BIG_ENDIAN != 0);
+}
+
+// Sets the header, layout and size of a PointCloud2 with float32 fields, in
+// this order, as a single row of `num_points`.
+static void init_float32_cloud(
+	const std_msgs::msg::Header& msg_header,
+	const std::vector<std::string>& names, size_t num_points,
+	sensor_msgs::msg::PointCloud2& msg)
+{
+	msg.header = msg_header;
+	msg.height = 1;
+	msg.width = static_cast<uint32_t>(num_points);
+	msg.is_bigendian = MRPT_IS_BIG_ENDIAN != 0;
+	msg.is_dense = true;
+	msg.fields.resize(names.size());
+	for (size_t k = 0; k < names.size(); k++)
+	{
+		auto& f = msg.fields[k];
+		f.name = names[k];
+		f.offset = static_cast<uint32_t>(k * sizeof(float));
+		f.datatype = sensor_msgs::msg::PointField::FLOAT32;
+		f.count = 1;
+	}
+	msg.point_step = static_cast<uint32_t>(names.size() * sizeof(float));
+	msg.row_step = msg.point_step * msg.width;
+	msg.data.resize(static_cast<size_t>(msg.row_step));
+}
+
+// Interleaves the map coordinates, and the values returned by
+// `extra(i, float* out)` for the rest of fields, into msg.data.
+template <class EXTRA>
+static void write_xyz_float32(
+	const CPointsMap& obj, sensor_msgs::msg::PointCloud2& msg, EXTRA&& extra)
+{
+	const auto& xs = obj.getPointsBufferRef_x();
+	const auto& ys = obj.getPointsBufferRef_y();
+	const auto& zs = obj.getPointsBufferRef_z();
+	const size_t nFields = msg.fields.size();
+	float pt[8];
+	ASSERT_LE_(nFields, sizeof(pt) / sizeof(pt[0]));
+
+	unsigned char* out = msg.data.data();
+	for (size_t i = 0; i < obj.size(); i++, out += msg.point_step)
+	{
+		pt[0] = xs[i];
+		pt[1] = ys[i];
+		pt[2] = zs[i];
+		extra(i, pt + 3);
+		std::memcpy(out, pt, nFields * sizeof(float));
+	}
+}
+
 std::set<std::string> extractFields(const sensor_msgs::msg::PointCloud2& msg)
 {
 	std::set<std::string> lst;
@@ -105,6 +223,12 @@ bool fromROS(const sensor_msgs::msg::PointCloud2& msg, CSimplePointsMap& obj)
 
 	if (incompatible || (!x_field || !y_field || !z_field)) return false;
 
+	if (is_native_float32(msg, x_field) && is_native_float32(msg, y_field) &&
+		is_native_float32(msg, z_field))
+		return copy_xyz_float32(
+			msg, *x_field, *y_field, *z_field, obj,
+			[](size_t, const unsigned char*) {});
+
 	// If not, memcpy each group of contiguous fields separately
 	for (unsigned int row = 0; row < msg.height; ++row)
 	{
@@ -146,6 +270,15 @@ bool fromROS(const sensor_msgs::msg::PointCloud2& msg, CPointsMapXYZI& obj)
 	if (incompatible || (!x_field || !y_field || !z_field || !i_field))
 		return false;
 
+	if (is_native_float32(msg, x_field) && is_native_float32(msg, y_field) &&
+		is_native_float32(msg, z_field) && is_native_float32(msg, i_field))
+		return copy_xyz_float32(
+			msg, *x_field, *y_field, *z_field, obj,
+			[&](size_t i, const unsigned char* msg_data) {
+				obj.setPointIntensity(
+					i, read_float32(msg_data, i_field->offset) / 255.0f);
+			});
+
 	// If not, memcpy each group of contiguous fields separately
 	for (unsigned int row = 0; row < msg.height; ++row)
 	{
@@ -167,6 +300,38 @@ bool fromROS(const sensor_msgs::msg::PointCloud2& msg, CPointsMapXYZI& obj)
 	return true;
 }
 
+bool fromROS(const sensor_msgs::msg::PointCloud2& msg, CColouredPointsMap& obj)
+{
+	bool incompatible = false;
+	const sensor_msgs::msg::PointField *x_field = nullptr, *y_field = nullptr,
+									   *z_field = nullptr, *rgb_field = nullptr;
+
+	for (unsigned int i = 0; i < msg.fields.size() && !incompatible; i++)
+	{
+		incompatible |= check_field(msg.fields[i], "x", &x_field);
+		incompatible |= check_field(msg.fields[i], "y", &y_field);
+		incompatible |= check_field(msg.fields[i], "z", &z_field);
+		if (is_packed_rgb(msg, msg.fields[i])) rgb_field = &msg.fields[i];
+	}
+
+	if (incompatible || (!x_field || !y_field || !z_field || !rgb_field) ||
+		!is_native_float32(msg, x_field) || !is_native_float32(msg, y_field) ||
+		!is_native_float32(msg, z_field))
+		return false;
+
+	obj.clear();
+	return copy_xyz_float32(
+		msg, *x_field, *y_field, *z_field, obj,
+		[&](size_t i, const unsigned char* msg_data) {
+			uint32_t rgb;
+			std::memcpy(&rgb, msg_data + rgb_field->offset, sizeof(rgb));
+			const float f = 1.0f / 255.0f;
+			obj.setPointColor_fast(
+				i, ((rgb >> 16) & 0xff) * f, ((rgb >> 8) & 0xff) * f,
+				(rgb & 0xff) * f);
+		});
+}
+
 /** Convert mrpt::slam::CSimplePointsMap -> sensor_msgs/PointCloud2
  *  The user must supply the "msg_header" field to be copied into the output
  * message object, since that part does not appear in MRPT classes.
@@ -179,7 +344,37 @@ bool toROS(
 	const CSimplePointsMap& obj, const std_msgs::msg::Header& msg_header,
 	sensor_msgs::msg::PointCloud2& msg)
 {
-	THROW_EXCEPTION("not implemented yet.");
+	init_float32_cloud(msg_header, {"x", "y", "z"}, obj.size(), msg);
+	write_xyz_float32(obj, msg, [](size_t, float*) {});
+	return true;
+}
+
+bool toROS(
+	const CPointsMapXYZI& obj, const std_msgs::msg::Header& msg_header,
+	sensor_msgs::msg::PointCloud2& msg)
+{
+	init_float32_cloud(
+		msg_header, {"x", "y", "z", "intensity"}, obj.size(), msg);
+	write_xyz_float32(obj, msg, [&](size_t i, float* out) {
+		out[0] = obj.getPointIntensity_fast(i) * 255.0f;
+	});
+	return true;
+}
+
+bool toROS(
+	const CColouredPointsMap& obj, const std_msgs::msg::Header& msg_header,
+	sensor_msgs::msg::PointCloud2& msg)
+{
+	init_float32_cloud(msg_header, {"x", "y", "z", "rgb"}, obj.size(), msg);
+	write_xyz_float32(obj, msg, [&](size_t i, float* out) {
+		float R, G, B;
+		obj.getPointColor_fast(i, R, G, B);
+		const uint32_t rgb = (static_cast<uint32_t>(R * 255.0f) << 16) |
+			(static_cast<uint32_t>(G * 255.0f) << 8) |
+			static_cast<uint32_t>(B * 255.0f);
+		std::memcpy(out, &rgb, sizeof(rgb));
+	});
+	return true;
 }
 
 /** Convert sensor_msgs/PointCloud2 -> mrpt::obs::CObservationRotatingScan */
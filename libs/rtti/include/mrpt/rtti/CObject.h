@@ -8,6 +8,7 @@
    +------------------------------------------------------------------------+ */
 #pragma once
 
+#include <mrpt/core/MemoryArena.h>
 #include <mrpt/core/aligned_allocator.h>
 #include <mrpt/core/safe_pointers.h>
 #include <mrpt/typemeta/static_string.h>  // literal()
@@ -37,9 +38,19 @@ struct TRuntimeClassId
 	std::function<std::shared_ptr<CObject>(void)> ptrCreateObject;
 	/** Gets the base class runtime id. */
 	const TRuntimeClassId* (*getBaseClass)();
+	/** Create an object of the related class within a memory arena, or
+	 * nullptr if it is virtual. (New in MRPT 2.4.9) */
+	std::shared_ptr<CObject> (*ptrCreateObjectInArena)(
+		const mrpt::MemoryArena::Ptr&) = nullptr;
 
 	// Operations
 	std::shared_ptr<CObject> createObject() const;
+	/** Like createObject(), but the object and its shared_ptr control block
+	 * are allocated from the given arena, which is kept alive until the object
+	 * is destroyed. Falls back to createObject() if `arena` is empty.
+	 * \note (New in MRPT 2.4.9) */
+	std::shared_ptr<CObject> createObject(
+		const mrpt::MemoryArena::Ptr& arena) const;
 	bool derivedFrom(const TRuntimeClassId* pBaseClass) const;
 	bool derivedFrom(const char* pBaseClass_name) const;
 };
@@ -232,6 +243,8 @@ inline mrpt::rtti::CObject::Ptr CObject::duplicateGetSmartPtr() const
 		const override;                                                        \
 	virtual mrpt::rtti::CObject* clone() const override;                       \
 	static std::shared_ptr<CObject> CreateObject();                            \
+	static std::shared_ptr<CObject> CreateObjectInArena(                       \
+		const mrpt::MemoryArena::Ptr& arena);                                  \
 	template <typename... Args>                                                \
 	static Ptr Create(Args&&... args)                                          \
 	{                                                                          \
@@ -258,6 +271,13 @@ inline mrpt::rtti::CObject::Ptr CObject::duplicateGetSmartPtr() const
 		return std::static_pointer_cast<CObject>(                              \
 			std::make_shared<NameSpace::class_name>());                        \
 	}                                                                          \
+	mrpt::rtti::CObject::Ptr NameSpace::class_name::CreateObjectInArena(       \
+		const mrpt::MemoryArena::Ptr& arena)                                   \
+	{                                                                          \
+		return std::static_pointer_cast<CObject>(                              \
+			std::allocate_shared<NameSpace::class_name>(                       \
+				mrpt::arena_allocator<NameSpace::class_name>(arena)));         \
+	}                                                                          \
 	const mrpt::rtti::TRuntimeClassId* NameSpace::class_name::_GetBaseClass()  \
 	{                                                                          \
 		return CLASS_ID(base);                                                 \
@@ -269,7 +289,8 @@ inline mrpt::rtti::CObject::Ptr CObject::duplicateGetSmartPtr() const
 	}                                                                          \
 	const mrpt::rtti::TRuntimeClassId NameSpace::class_name::runtimeClassId =  \
 		{class_registry_name, NameSpace::class_name::CreateObject,             \
-		 &class_name::_GetBaseClass};                                          \
+		 &class_name::_GetBaseClass,                                           \
+		 &NameSpace::class_name::CreateObjectInArena};                         \
 	const mrpt::rtti::TRuntimeClassId*                                         \
 		NameSpace::class_name::GetRuntimeClass() const                         \
 	{                                                                          \
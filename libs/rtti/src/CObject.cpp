@@ -100,6 +100,13 @@ CObject::Ptr TRuntimeClassId::createObject() const
 	}
 }
 
+CObject::Ptr TRuntimeClassId::createObject(
+	const mrpt::MemoryArena::Ptr& arena) const
+{
+	if (!arena || !ptrCreateObjectInArena) return createObject();
+	return ptrCreateObjectInArena(arena);
+}
+
 // For class CObject, special methods must be defined
 // since it has no base class. These methods are defined
 // automatically for derived classes.
@@ -16,11 +16,14 @@
 #include <mrpt/typemeta/TEnumType.h>
 #include <mrpt/typemeta/TTypeName.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <cstring>	// memcpy
 #include <stdexcept>
 #include <string>
 #include <type_traits>	// remove_reference_t, is_polymorphic
+#include <unordered_map>
+#include <utility>
 #include <variant>
 #include <vector>
 
@@ -101,8 +104,16 @@ class CArchive
 #else
 		// big endian: convert.
 		const size_t nread = ReadBuffer(ptr, ElementCount * sizeof(T));
-		for (size_t i = 0; i < ElementCount; i++)
-			mrpt::reverseBytesInPlace(ptr[i]);
+		if constexpr (std::is_arithmetic_v<T>)
+		{
+			// Whole block at once:
+			mrpt::reverseBytesInPlaceBlock(ptr, ElementCount);
+		}
+		else
+		{
+			for (size_t i = 0; i < ElementCount; i++)
+				mrpt::reverseBytesInPlace(ptr[i]);
+		}
 		return nread;
 #endif
 	}
@@ -138,9 +149,27 @@ class CArchive
 		// little endian: no conversion needed.
 		return WriteBuffer(ptr, ElementCount * sizeof(T));
 #else
-		// big endian: the individual "<<" functions already convert endiannes
-		for (size_t i = 0; i < ElementCount; i++)
-			(*this) << ptr[i];
+		// big endian: convert into a temporary buffer, one chunk at a time.
+		if constexpr (std::is_arithmetic_v<T>)
+		{
+			constexpr size_t CHUNK_LEN = 4096 / sizeof(T);
+			T buf[CHUNK_LEN];
+			while (ElementCount)
+			{
+				const size_t n = std::min(ElementCount, CHUNK_LEN);
+				std::memcpy(buf, ptr, n * sizeof(T));
+				mrpt::reverseBytesInPlaceBlock(buf, n);
+				WriteBuffer(buf, n * sizeof(T));
+				ptr += n;
+				ElementCount -= n;
+			}
+		}
+		else
+		{
+			// the individual "<<" functions already convert endiannes
+			for (size_t i = 0; i < ElementCount; i++)
+				(*this) << ptr[i];
+		}
 #endif
 	}
 	/** Read a value from a stream stored in a type different of the target
@@ -198,16 +227,17 @@ class CArchive
 		std::string strClassName;
 		bool isOldFormat{false};
 		int8_t version{-1};
-		internal_ReadObjectHeader(strClassName, isOldFormat, version);
+		const mrpt::rtti::TRuntimeClassId* classId = nullptr;
+		internal_ReadObjectHeader(
+			strClassName, isOldFormat, version, &classId);
 		if (strClassName != "nullptr")
 		{
-			const mrpt::rtti::TRuntimeClassId* classId =
-				mrpt::rtti::findRegisteredClass(strClassName);
 			if (!classId)
 				THROW_EXCEPTION_FMT(
 					"Stored object has class '%s' which is not registered!",
 					strClassName.c_str());
-			obj = mrpt::ptr_cast<CSerializable>::from(classId->createObject());
+			obj = mrpt::ptr_cast<CSerializable>::from(
+				classId->createObject(m_arena));
 		}
 		internal_ReadObject(
 			obj.get() /* may be nullptr */, strClassName, isOldFormat,
@@ -272,17 +302,18 @@ class CArchive
 		std::string strClassName;
 		bool isOldFormat;
 		int8_t version;
-		internal_ReadObjectHeader(strClassName, isOldFormat, version);
+		const mrpt::rtti::TRuntimeClassId* classId = nullptr;
+		internal_ReadObjectHeader(
+			strClassName, isOldFormat, version, &classId);
 		if (strClassName == "std::monostate") return {};
-		const mrpt::rtti::TRuntimeClassId* classId =
-			mrpt::rtti::findRegisteredClass(strClassName);
 		if (!classId)
 			THROW_EXCEPTION_FMT(
 				"Stored object has class '%s' which is not registered!",
 				strClassName.c_str());
 		if (strClassName != "nullptr")
 		{
-			obj = mrpt::ptr_cast<CSerializable>::from(classId->createObject());
+			obj = mrpt::ptr_cast<CSerializable>::from(
+				classId->createObject(m_arena));
 		}
 		internal_ReadObject(obj.get(), strClassName, isOldFormat, version);
 		if (!obj) { return std::variant<T...>(); }
@@ -365,6 +396,40 @@ class CArchive
 	 */
 	bool receiveMessage(CMessage& msg);
 
+	/** Enables or disables the class-ID dictionary mode for writing objects.
+	 * In this mode, the class name of each object is only written the first
+	 * time the class appears in this archive, together with a numeric ID,
+	 * and later objects of the same class refer to it with a single varint
+	 * ID, saving space and class registry look-ups when reading.
+	 *
+	 * Readers detect this mode automatically (no need to call this method),
+	 * but all objects of the stream must be read through one single CArchive
+	 * object, since IDs are only defined once per archive. Streams written
+	 * in this mode cannot be read by MRPT versions older than 2.4.9.
+	 * Disabled by default.
+	 * \note (New in MRPT 2.4.9)
+	 */
+	void enableClassIdDictionary(bool enable = true)
+	{
+		m_useClassIdDictionary = enable;
+	}
+	bool isClassIdDictionaryEnabled() const { return m_useClassIdDictionary; }
+
+	/** Sets a memory arena where ReadObject() and ReadVariant() will create
+	 * all new objects (including those nested within other objects), instead
+	 * of one heap allocation per object. Each object keeps the arena alive,
+	 * so a whole arena is freed at once when all objects read into it are
+	 * destroyed. Pass an empty pointer to go back to the default heap
+	 * allocation.
+	 * \sa mrpt::MemoryArena, mrpt::obs::CRawlog::setMemoryArenaChunkSize()
+	 * \note (New in MRPT 2.4.9)
+	 */
+	void setMemoryArena(const mrpt::MemoryArena::Ptr& arena)
+	{
+		m_arena = arena;
+	}
+	const mrpt::MemoryArena::Ptr& getMemoryArena() const { return m_arena; }
+
 	/** Write a CSerializable object to a stream in the binary MRPT format */
 	CArchive& operator<<(const CSerializable& obj);
 	/** \overload */
@@ -396,9 +461,27 @@ class CArchive
 		CSerializable* newObj, const std::string& className, bool isOldFormat,
 		int8_t version);
 
-	/** Read the object Header*/
+	/** Read the object Header. If `classId` is provided, the class of the
+	 * object is also resolved (nullptr for "nullptr" objects or unregistered
+	 * classes). */
 	void internal_ReadObjectHeader(
-		std::string& className, bool& isOldFormat, int8_t& version);
+		std::string& className, bool& isOldFormat, int8_t& version,
+		const mrpt::rtti::TRuntimeClassId** classId = nullptr);
+
+   private:
+	/** See enableClassIdDictionary() */
+	bool m_useClassIdDictionary = false;
+	/** Class IDs already defined in the output stream */
+	std::unordered_map<const mrpt::rtti::TRuntimeClassId*, uint32_t>
+		m_writeClassIds;
+	/** Class names and their classes by ID, as defined in the input stream */
+	std::vector<std::pair<std::string, const mrpt::rtti::TRuntimeClassId*>>
+		m_readClassIds;
+	/** See setMemoryArena() */
+	mrpt::MemoryArena::Ptr m_arena;
+
+	void internal_WriteVarUInt(uint32_t v);
+	uint32_t internal_ReadVarUInt();
 };
 
 // Note: write op accepts parameters by value on purpose, to avoid misaligned
@@ -25,6 +25,62 @@ namespace mrpt::serialization
 /** \addtogroup mrpt_serialization_stlext_grp
  * @{ */
 
+namespace detail
+{
+/** Element types whose serialized form is just their little-endian bytes, so
+ * that contiguous containers of them can be streamed with one single
+ * CArchive::WriteBufferFixEndianness() / ReadBufferFixEndianness() call.
+ * \note (New in MRPT 2.4.9) */
+template <typename T>
+constexpr bool is_bulk_serializable_v = is_simple_type<T>::value &&
+	!std::is_same_v<T, bool> && !std::is_same_v<T, long double>;
+
+/** True for contiguous STL containers of bulk-serializable elements. */
+template <typename C>
+struct is_bulk_seq_container : std::false_type
+{
+};
+template <typename T, typename _Ax>
+struct is_bulk_seq_container<std::vector<T, _Ax>>
+	: std::bool_constant<is_bulk_serializable_v<T>>
+{
+};
+
+template <typename C>
+void writeSeqContainerItems(CArchive& out, const C& obj)
+{
+	if constexpr (is_bulk_seq_container<C>::value)
+	{
+		if (!obj.empty()) out.WriteBufferFixEndianness(obj.data(), obj.size());
+	}
+	else
+	{
+		std::for_each(
+			obj.begin(), obj.end(),
+			metaprogramming::ObjectWriteToStream(&out));
+	}
+}
+
+template <typename C>
+void readSeqContainerItems(CArchive& in, C& obj)
+{
+	if constexpr (is_bulk_seq_container<C>::value)
+	{
+		if (obj.empty()) return;
+		const size_t nBytes = obj.size() * sizeof(typename C::value_type);
+		if (in.ReadBufferFixEndianness(obj.data(), obj.size()) != nBytes)
+			THROW_EXCEPTION(
+				"(EOF?) Cannot read requested number of bytes from stream");
+	}
+	else
+	{
+		std::for_each(
+			obj.begin(), obj.end(),
+			metaprogramming::ObjectReadFromStream(&in));
+	}
+}
+}  // namespace detail
+
 #define MRPTSTL_SERIALIZABLE_SEQ_CONTAINER(CONTAINER)                          \
 	/** Template method to serialize a sequential STL container  */            \
 	template <class T, class _Ax>                                              \
@@ -32,9 +88,7 @@ namespace mrpt::serialization
 	{                                                                          \
 		out << std::string(#CONTAINER) << mrpt::typemeta::TTypeName<T>::get(); \
 		out.WriteAs<uint32_t>(obj.size());                                     \
-		std::for_each(                                                         \
-			obj.begin(), obj.end(),                                            \
-			metaprogramming::ObjectWriteToStream(&out));                       \
+		detail::writeSeqContainerItems(out, obj);                              \
 		return out;                                                            \
 	}                                                                          \
 	/** Template method to deserialize a sequential STL container */           \
@@ -59,9 +113,7 @@ namespace mrpt::serialization
 				mrpt::typemeta::TTypeName<T>::get().c_str());                  \
 		const uint32_t n = in.ReadAs<uint32_t>();                              \
 		obj.resize(n);                                                         \
-		std::for_each(                                                         \
-			obj.begin(), obj.end(),                                            \
-			metaprogramming::ObjectReadFromStream(&in));                       \
+		detail::readSeqContainerItems(in, obj);                                \
 		return in;                                                             \
 	}
 
@@ -199,8 +251,11 @@ CArchive& operator<<(CArchive& out, const std::array<T, N>& obj)
 {
 	out << std::string("std::array") << static_cast<uint32_t>(N)
 		<< mrpt::typemeta::TTypeName<T>::get();
-	std::for_each(
-		obj.begin(), obj.end(), metaprogramming::ObjectWriteToStream(&out));
+	if constexpr (detail::is_bulk_serializable_v<T> && N != 0)
+		out.WriteBufferFixEndianness(obj.data(), N);
+	else
+		std::for_each(
+			obj.begin(), obj.end(), metaprogramming::ObjectWriteToStream(&out));
 	return out;
 }
 
@@ -222,8 +277,15 @@ CArchive& operator>>(CArchive& in, std::array<T, N>& obj)
 		THROW_EXCEPTION_FMT(
 			"Error: serialized container std::array< %s != %s >",
 			stored_T.c_str(), mrpt::typemeta::TTypeName<T>::get().c_str());
-	std::for_each(
-		obj.begin(), obj.end(), metaprogramming::ObjectReadFromStream(&in));
+	if constexpr (detail::is_bulk_serializable_v<T> && N != 0)
+	{
+		if (in.ReadBufferFixEndianness(obj.data(), N) != N * sizeof(T))
+			THROW_EXCEPTION(
+				"(EOF?) Cannot read requested number of bytes from stream");
+	}
+	else
+		std::for_each(
+			obj.begin(), obj.end(), metaprogramming::ObjectReadFromStream(&in));
 	return in;
 }
 
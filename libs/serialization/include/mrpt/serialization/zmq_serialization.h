@@ -9,45 +9,46 @@
 #pragma once
 
 #include <mrpt/io/CMemoryStream.h>
+#include <mrpt/serialization/CArchive.h>
 #include <mrpt/serialization/CSerializable.h>
 
+#include <algorithm>
 #include <cmath>  // ceil()
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
 
 namespace mrpt
 {
 namespace serialization
 {
 // clang-format off
-/** \addtogroup mrpt_serialization_zmq Serialization functions for ZMQ (v3 or above) (in #include <mrpt/serialization/serialization_zmq.h>)
+/** \addtogroup mrpt_serialization_zmq Serialization functions for ZMQ (v3 or above) (in #include <mrpt/serialization/zmq_serialization.h>)
  * \ingroup  mrpt_serialization_grp
  * @{ */
 //clang-format on
 
-/** Send an MRPT object to a ZMQ socket.
- * \param[in] obj The object to be serialized and sent to the socket.
+/** Sends the contents of a memory buffer to a ZMQ socket, without copying
+ * them: the ZMQ message parts refer to the memory of `buf`, whose ownership
+ * is moved to ZMQ, and which is freed once all of them have been sent.
  * \param[in] zmq_socket The zmq socket object.
- * \param[in] max_packet_len The object will be split into a series of ZMQ
+ * \param[in] buf The data to send, normally an object serialized with
+ * mrpt::serialization::archiveFrom(*buf).WriteObject(...).
+ * \param[in] max_packet_len The buffer will be split into a series of ZMQ
  * "message parts" of this maximum length (in bytes). Default=0, which means do
  * not split in parts.
- * \note Including `<mrpt/serialization/serialization_zmq.h>` requires libzmq to
- * be
- * available in your system and linked
- *  to your user code. This function can be used even if MRPT was built without
- * ZMQ support, thanks to the use of templates.
- * \exception std::exception If the object finds any critical error during
- * serialization or on ZMQ errors.
- * \note See examples of usage in
- * https://github.com/MRPT/mrpt/tree/master/doc/mrpt-zeromq-example
+ * \exception std::exception On ZMQ errors.
+ * \sa mrpt_send_to_zmq
+ * \note (New in MRPT 2.4.9)
  */
 template <typename ZMQ_SOCKET_TYPE>
-void mrpt_send_to_zmq(
-	ZMQ_SOCKET_TYPE zmq_socket, const mrpt::serialization::CSerializable& obj,
+void mrpt_send_buffer_to_zmq(
+	ZMQ_SOCKET_TYPE zmq_socket, std::unique_ptr<mrpt::io::CMemoryStream> buf,
 	const size_t max_packet_len = 0)
 {
-	mrpt::io::CMemoryStream* buf = new mrpt::io::CMemoryStream();
-	if (!buf) throw std::bad_alloc();
-
-	buf->WriteObject(&obj);
+	if (!buf) throw std::invalid_argument("[mrpt_send_to_zmq] null buffer");
 	const size_t nBytes = buf->getTotalBytesCount();
 	if (!nBytes)
 		throw std::runtime_error(
@@ -57,18 +58,16 @@ void mrpt_send_to_zmq(
 		(!max_packet_len)
 			? 1U
 			: static_cast<unsigned int>(ceil(double(nBytes) / max_packet_len));
+	// All message parts share the buffer, freed after the last one is gone:
+	const std::shared_ptr<mrpt::io::CMemoryStream> sharedBuf(std::move(buf));
 	for (unsigned int iPkt = 0; iPkt < nPkts; ++iPkt)
 	{
 		// Prepare a msg part:
-		mrpt::serialization::internal::TFreeFnDataForZMQ* fd =
-			new mrpt::serialization::internal::TFreeFnDataForZMQ();
-		if (!fd) throw std::bad_alloc();
-		fd->buf = buf;
-		fd->do_free =
-			iPkt ==
-			(nPkts - 1);  // Free buffer only after the last part is disposed.
+		auto* fd = new mrpt::io::internal::TFreeFnDataForZMQ();
+		fd->buf = sharedBuf;
+		const bool isLast = iPkt == (nPkts - 1);
 		void* pkt_data = reinterpret_cast<char*>(fd->buf->getRawBufferData()) +
-						 max_packet_len * iPkt;
+			max_packet_len * iPkt;
 		size_t nBytesThisPkt = nBytes - max_packet_len * iPkt;
 		if (max_packet_len != 0 && nBytesThisPkt > max_packet_len)
 			nBytesThisPkt = max_packet_len;
@@ -76,12 +75,15 @@ void mrpt_send_to_zmq(
 		zmq_msg_t message;
 		if (0 != zmq_msg_init_data(
 					 &message, pkt_data, nBytesThisPkt,
-					 &mrpt::serialization::internal::free_fn_for_zmq, fd))
+					 &mrpt::io::internal::free_fn_for_zmq, fd))
+		{
+			delete fd;
 			throw std::runtime_error(
 				"[mrpt_send_to_zmq] Error in zmq_msg_init_data()");
+		}
 		// Send:
 		const int sent_size =
-			zmq_msg_send(&message, zmq_socket, fd->do_free ? 0 : ZMQ_SNDMORE);
+			zmq_msg_send(&message, zmq_socket, isLast ? 0 : ZMQ_SNDMORE);
 		if (0 != zmq_msg_close(&message))
 			throw std::runtime_error(
 				"[mrpt_send_to_zmq] Error in zmq_msg_close()");
@@ -91,26 +93,129 @@ void mrpt_send_to_zmq(
 	}
 }
 
-/** Users may normally call mrpt_recv_from_zmq() and mrpt_recv_from_zmq_into().
- * This function just stores the received data into a memory buffer without
- * parsing it into an MRPT object.
- * \return false on any error */
+/** Send an MRPT object to a ZMQ socket.
+ * The object is serialized into a memory buffer which is then handed over to
+ * ZMQ without any further copy (see mrpt_send_buffer_to_zmq()).
+ * \param[in] obj The object to be serialized and sent to the socket.
+ * \param[in] zmq_socket The zmq socket object.
+ * \param[in] max_packet_len The object will be split into a series of ZMQ
+ * "message parts" of this maximum length (in bytes). Default=0, which means do
+ * not split in parts.
+ * \note Including `<mrpt/serialization/zmq_serialization.h>` requires libzmq
+ * to be available in your system and linked to your user code. This function
+ * can be used even if MRPT was built without ZMQ support, thanks to the use of
+ * templates.
+ * \exception std::exception If the object finds any critical error during
+ * serialization or on ZMQ errors.
+ * \note See examples of usage in
+ * https://github.com/MRPT/mrpt/tree/master/doc/mrpt-zeromq-example
+ */
+template <typename ZMQ_SOCKET_TYPE>
+void mrpt_send_to_zmq(
+	ZMQ_SOCKET_TYPE zmq_socket, const mrpt::serialization::CSerializable& obj,
+	const size_t max_packet_len = 0)
+{
+	auto buf = std::make_unique<mrpt::io::CMemoryStream>();
+	mrpt::serialization::archiveFrom(*buf).WriteObject(&obj);
+	mrpt_send_buffer_to_zmq(zmq_socket, std::move(buf), max_packet_len);
+}
+
+namespace internal
+{
+/** A read-only stream over the data of a list of received ZMQ message parts,
+ * which are neither copied nor owned, so objects can be deserialized directly
+ * from the ZMQ buffers. Used in mrpt_recv_from_zmq().
+ * \note (New in MRPT 2.4.9) */
+class CZmqMsgPartsInputStream : public mrpt::io::CStream
+{
+   public:
+	CZmqMsgPartsInputStream() = default;
+
+	/** Appends a block of memory, which must exist during the life of this
+	 * object, to the end of the stream. */
+	void addPart(const void* data, size_t len)
+	{
+		if (!len) return;
+		m_parts.emplace_back(static_cast<const uint8_t*>(data), len);
+		m_total += len;
+	}
+
+	size_t Read(void* Buffer, size_t Count) override
+	{
+		auto* out = static_cast<uint8_t*>(Buffer);
+		size_t nRead = 0;
+		while (nRead < Count && m_curPart < m_parts.size())
+		{
+			const auto& part = m_parts[m_curPart];
+			const size_t n =
+				std::min(Count - nRead, part.second - m_curPartOffset);
+			std::memcpy(out + nRead, part.first + m_curPartOffset, n);
+			nRead += n;
+			m_curPartOffset += n;
+			if (m_curPartOffset == part.second)
+			{
+				m_curPart++;
+				m_curPartOffset = 0;
+			}
+		}
+		m_position += nRead;
+		return nRead;
+	}
+	size_t Write(const void*, size_t) override
+	{
+		throw std::runtime_error(
+			"[CZmqMsgPartsInputStream] Write() on a read-only stream");
+	}
+	uint64_t Seek(
+		int64_t Offset, CStream::TSeekOrigin Origin = sFromBeginning) override
+	{
+		int64_t newPos = Offset;
+		if (Origin == sFromCurrent) newPos += static_cast<int64_t>(m_position);
+		else if (Origin == sFromEnd)
+			newPos += static_cast<int64_t>(m_total);
+		m_position = static_cast<uint64_t>(
+			std::clamp<int64_t>(newPos, 0, static_cast<int64_t>(m_total)));
+		// Locate the part of the new position:
+		uint64_t remaining = m_position;
+		for (m_curPart = 0; m_curPart < m_parts.size() &&
+			 remaining >= m_parts[m_curPart].second;
+			 m_curPart++)
+			remaining -= m_parts[m_curPart].second;
+		m_curPartOffset = static_cast<size_t>(remaining);
+		return m_position;
+	}
+	uint64_t getTotalBytesCount() const override { return m_total; }
+	uint64_t getPosition() const override { return m_position; }
+	std::string getStreamDescription() const override
+	{
+		return "mrpt::serialization::internal::CZmqMsgPartsInputStream with " +
+			std::to_string(m_parts.size()) +
+			" parts, size=" + std::to_string(m_total);
+	}
+
+   private:
+	std::vector<std::pair<const uint8_t*, size_t>> m_parts;
+	uint64_t m_total = 0, m_position = 0;
+	size_t m_curPart = 0, m_curPartOffset = 0;
+};
+
+/** Receives all the parts of one ZMQ message into `out_lst_msgs`, which the
+ * caller must free with free_zmq_msg_lst(). \return false on any error */
 template <typename ZMQ_SOCKET_TYPE, typename VECTOR_MSG_T>
-bool mrpt_recv_from_zmq_buf(
-	ZMQ_SOCKET_TYPE zmq_socket, VECTOR_MSG_T& out_lst_msgs,
-	mrpt::io::CMemoryStream& target_buf, bool dont_wait,
-	size_t* rx_obj_length_in_bytes)
+bool recv_zmq_msg_parts(
+	ZMQ_SOCKET_TYPE zmq_socket, VECTOR_MSG_T& out_lst_msgs, bool dont_wait)
 {
-	if (rx_obj_length_in_bytes) *rx_obj_length_in_bytes = 0;
-	out_lst_msgs.clear();
-	target_buf.clear();
 	int64_t more;
 	size_t more_size = sizeof(more);
 	do
 	{
 		// Init rx msg:
-		zmq_msg_t* msg = new zmq_msg_t();
-		if (0 != zmq_msg_init(msg)) return false;
+		auto* msg = new zmq_msg_t();
+		if (0 != zmq_msg_init(msg))
+		{
+			delete msg;
+			return false;
+		}
 		out_lst_msgs.push_back(msg);
 		// Recv:
 		int rc = zmq_msg_recv(msg, zmq_socket, dont_wait ? ZMQ_DONTWAIT : 0);
@@ -118,20 +223,41 @@ bool mrpt_recv_from_zmq_buf(
 		// Determine if more message parts are to follow
 		rc = zmq_getsockopt(zmq_socket, ZMQ_RCVMORE, &more, &more_size);
 		if (rc != 0) return false;
-		// Only one part?
-		if (out_lst_msgs.size() == 1 && !more)
-		{
-			target_buf.assignMemoryNotOwn(zmq_msg_data(msg), zmq_msg_size(msg));
-			if (rx_obj_length_in_bytes)
-				*rx_obj_length_in_bytes = zmq_msg_size(msg);
-		}
 	} while (more);
+	return true;
+}
+}  // namespace internal
+
+/** Users may normally call mrpt_recv_from_zmq() and mrpt_recv_from_zmq_into().
+ * This function just stores the received data into a memory buffer without
+ * parsing it into an MRPT object. Single-part messages are not copied, but
+ * multi-part ones are concatenated into `target_buf`.
+ * \return false on any error */
+template <typename ZMQ_SOCKET_TYPE, typename VECTOR_MSG_T>
+bool mrpt_recv_from_zmq_buf(
+	ZMQ_SOCKET_TYPE zmq_socket, VECTOR_MSG_T& out_lst_msgs,
+	mrpt::io::CMemoryStream& target_buf, bool dont_wait,
+	size_t* rx_obj_length_in_bytes)
+{
+	if (rx_obj_length_in_bytes) *rx_obj_length_in_bytes = 0;
+	out_lst_msgs.clear();
+	target_buf.clear();
+	if (!internal::recv_zmq_msg_parts(zmq_socket, out_lst_msgs, dont_wait))
+		return false;
+	// Only one part?
+	if (out_lst_msgs.size() == 1)
+	{
+		zmq_msg_t* msg = out_lst_msgs[0];
+		target_buf.assignMemoryNotOwn(zmq_msg_data(msg), zmq_msg_size(msg));
+		if (rx_obj_length_in_bytes)
+			*rx_obj_length_in_bytes = zmq_msg_size(msg);
+	}
 	// More than 1 part?
 	if (out_lst_msgs.size() > 1)
 	{
 		for (size_t i = 0; i < out_lst_msgs.size(); i++)
 		{
-			target_buf.WriteBuffer(
+			target_buf.Write(
 				zmq_msg_data(out_lst_msgs[i]), zmq_msg_size(out_lst_msgs[i]));
 		}
 		if (rx_obj_length_in_bytes)
@@ -151,11 +277,36 @@ void free_zmq_msg_lst(VECTOR_MSG_T& lst_msgs)
 		zmq_msg_close(lst_msgs[i]);
 		delete lst_msgs[i];
 	}
+	lst_msgs.clear();
 }
+
+/** Receives one (possibly multi-part) ZMQ message and keeps its parts alive,
+ * exposing their data as a stream, until this object is destroyed. */
+template <typename MSG_T>
+struct TZmqReceivedMsg
+{
+	std::vector<MSG_T*> parts;
+	CZmqMsgPartsInputStream stream;
+
+	TZmqReceivedMsg() = default;
+	TZmqReceivedMsg(const TZmqReceivedMsg&) = delete;
+	TZmqReceivedMsg& operator=(const TZmqReceivedMsg&) = delete;
+	~TZmqReceivedMsg() { free_zmq_msg_lst(parts); }
+
+	template <typename ZMQ_SOCKET_TYPE>
+	bool receive(ZMQ_SOCKET_TYPE zmq_socket, bool dont_wait)
+	{
+		if (!recv_zmq_msg_parts(zmq_socket, parts, dont_wait)) return false;
+		for (auto* msg : parts)
+			stream.addPart(zmq_msg_data(msg), zmq_msg_size(msg));
+		return true;
+	}
+};
 }  // namespace internal
 
 /** Receives an MRPT object from a ZMQ socket, determining the type of the
- *  object on-the-fly.
+ *  object on-the-fly. The object is deserialized directly from the received
+ *  ZMQ message parts, with no intermediate copy.
  * \param[in] zmq_socket The zmq socket object.
  * \param[in] dont_wait If true, will fail if there is no data ready to
  *  be read. If false (default) this function will block until data arrives.
@@ -163,9 +314,8 @@ void free_zmq_msg_lst(VECTOR_MSG_T& lst_msgs)
  * stored here.
  * \return An empty smart pointer if there was any error. The received
  *  object if all went OK.
- * \note Including `<mrpt/serialization/serialization_zmq.h>` requires libzmq to
- * be
- *  available in your system and linked to your user code. This function
+ * \note Including `<mrpt/serialization/zmq_serialization.h>` requires libzmq
+ * to be available in your system and linked to your user code. This function
  *  can be used even if MRPT was built without ZMQ support, thanks to the
  *  use of templates.
  * \exception std::exception If the object finds any critical error during
@@ -179,17 +329,13 @@ mrpt::serialization::CSerializable::Ptr mrpt_recv_from_zmq(
 	ZMQ_SOCKET_TYPE zmq_socket, bool dont_wait = false,
 	size_t* rx_obj_length_in_bytes = nullptr)
 {
-	CMemoryStream target_buf;
-	mrpt::serialization::CSerializable::Ptr obj;
-	std::vector<zmq_msg_t*> lst_msgs_to_close;
-	if (!mrpt_recv_from_zmq_buf(
-			zmq_socket, lst_msgs_to_close, target_buf, dont_wait,
-			rx_obj_length_in_bytes))
-		return obj;
-	// De-serialize:
-	obj = target_buf.ReadObject();
-	internal::free_zmq_msg_lst(lst_msgs_to_close);  // Free msgs mem
-	return obj;
+	if (rx_obj_length_in_bytes) *rx_obj_length_in_bytes = 0;
+	internal::TZmqReceivedMsg<zmq_msg_t> rx;
+	if (!rx.receive(zmq_socket, dont_wait)) return {};
+	if (rx_obj_length_in_bytes)
+		*rx_obj_length_in_bytes = rx.stream.getTotalBytesCount();
+	// De-serialize directly from the ZMQ buffers:
+	return mrpt::serialization::archiveFrom(rx.stream).ReadObject();
 }
 /** Like mrpt_recv_from_zmq() but without dynamically allocating the received
  * object,
@@ -208,15 +354,13 @@ bool mrpt_recv_from_zmq_into(
 	mrpt::serialization::CSerializable& target_object, bool dont_wait = false,
 	size_t* rx_obj_length_in_bytes = nullptr)
 {
-	CMemoryStream target_buf;
-	std::vector<zmq_msg_t*> lst_msgs_to_close;
-	if (!mrpt_recv_from_zmq_buf(
-			zmq_socket, lst_msgs_to_close, target_buf, dont_wait,
-			rx_obj_length_in_bytes))
-		return false;
-	// De-serialize:
-	target_buf.ReadObject(&target_object);
-	internal::free_zmq_msg_lst(lst_msgs_to_close);  // Free msgs mem
+	if (rx_obj_length_in_bytes) *rx_obj_length_in_bytes = 0;
+	internal::TZmqReceivedMsg<zmq_msg_t> rx;
+	if (!rx.receive(zmq_socket, dont_wait)) return false;
+	if (rx_obj_length_in_bytes)
+		*rx_obj_length_in_bytes = rx.stream.getTotalBytesCount();
+	// De-serialize directly from the ZMQ buffers:
+	mrpt::serialization::archiveFrom(rx.stream).ReadObject(&target_object);
 	return true;
 }
 
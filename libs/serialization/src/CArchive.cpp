@@ -23,6 +23,14 @@ using namespace mrpt::serialization;
 
 const uint8_t SERIALIZATION_END_FLAG = 0x88;
 
+// Object headers in the class-ID dictionary mode: classic headers start with
+// the class name length (at most 120) | 0x80, so these values never collide.
+// A class definition is followed by the format version, the varint ID, and
+// the class name; a class reference, by the varint ID only.
+const uint8_t CLASSID_DEFINITION_FLAG = 0xFE;
+const uint8_t CLASSID_REFERENCE_FLAG = 0xFD;
+const uint8_t CLASSID_FORMAT_VERSION = 0;
+
 size_t CArchive::ReadBuffer(void* Buffer, size_t Count)
 {
 	ASSERT_(Buffer != nullptr);
@@ -108,6 +116,35 @@ CArchive& CArchive::operator<<(const std::monostate&)
 	return *this;
 }
 
+void CArchive::internal_WriteVarUInt(uint32_t v)
+{
+	// LEB128: 7 bits per byte, MSB set if more bytes follow.
+	uint8_t buf[5];
+	size_t n = 0;
+	do
+	{
+		buf[n] = v & 0x7F;
+		v >>= 7;
+		if (v) buf[n] |= 0x80;
+		n++;
+	} while (v);
+	WriteBuffer(buf, n);
+}
+
+uint32_t CArchive::internal_ReadVarUInt()
+{
+	uint32_t v = 0;
+	for (int shift = 0; shift < 35; shift += 7)
+	{
+		uint8_t b;
+		if (sizeof(b) != ReadBuffer(&b, sizeof(b)))
+			THROW_EXCEPTION("Cannot read class ID from stream!");
+		v |= static_cast<uint32_t>(b & 0x7F) << shift;
+		if (!(b & 0x80)) return v;
+	}
+	THROW_EXCEPTION("Invalid class ID in stream");
+}
+
 /*---------------------------------------------------------------
 Writes an object to the stream.
 ---------------------------------------------------------------*/
@@ -124,10 +161,34 @@ void CArchive::WriteObject(const CSerializable* o)
 	}
 
 	int8_t classNamLen = strlen(className);
-	int8_t classNamLen_mod = classNamLen | 0x80;
 
-	(*this) << classNamLen_mod;
-	this->WriteBuffer(className, classNamLen);
+	if (o != nullptr && m_useClassIdDictionary)
+	{
+		// Only the first object of each class includes its name:
+		const auto* classId = o->GetRuntimeClass();
+		const auto it = m_writeClassIds.find(classId);
+		if (it != m_writeClassIds.end())
+		{
+			(*this) << CLASSID_REFERENCE_FLAG;
+			internal_WriteVarUInt(it->second);
+		}
+		else
+		{
+			const auto id = static_cast<uint32_t>(m_writeClassIds.size());
+			(*this) << CLASSID_DEFINITION_FLAG << CLASSID_FORMAT_VERSION;
+			internal_WriteVarUInt(id);
+			(*this) << classNamLen;
+			this->WriteBuffer(className, classNamLen);
+			m_writeClassIds[classId] = id;
+		}
+	}
+	else
+	{
+		int8_t classNamLen_mod = classNamLen | 0x80;
+
+		(*this) << classNamLen_mod;
+		this->WriteBuffer(className, classNamLen);
+	}
 
 	// Next, the version number:
 	if (o != nullptr)
@@ -337,7 +398,8 @@ CArchive& mrpt::serialization::operator>>(CArchive& in, std::string& str)
 #define CARCHIVE_VERBOSE 0
 
 void CArchive::internal_ReadObjectHeader(
-	std::string& strClassName, bool& isOldFormat, int8_t& version)
+	std::string& strClassName, bool& isOldFormat, int8_t& version,
+	const mrpt::rtti::TRuntimeClassId** classId)
 {
 	uint8_t lengthReadClassName = 255;
 	char readClassName[260];
@@ -352,6 +414,59 @@ void CArchive::internal_ReadObjectHeader(
 				(void*)&lengthReadClassName, sizeof(lengthReadClassName)))
 			THROW_EXCEPTION("Cannot read object header from stream! (EOF?)");
 
+		// Class-ID dictionary mode (MRPT >= 2.4.9)?
+		if (lengthReadClassName == CLASSID_DEFINITION_FLAG ||
+			lengthReadClassName == CLASSID_REFERENCE_FLAG)
+		{
+			isOldFormat = false;
+			if (lengthReadClassName == CLASSID_DEFINITION_FLAG)
+			{
+				uint8_t formatVersion, len;
+				(*this) >> formatVersion;
+				if (formatVersion != CLASSID_FORMAT_VERSION)
+					THROW_EXCEPTION_FMT(
+						"Unsupported class-ID dictionary format version: %u",
+						static_cast<unsigned int>(formatVersion));
+				const uint32_t id = internal_ReadVarUInt();
+				if (id != m_readClassIds.size())
+					THROW_EXCEPTION_FMT(
+						"Unexpected definition of class ID %u (expected: %u)",
+						static_cast<unsigned int>(id),
+						static_cast<unsigned int>(m_readClassIds.size()));
+				(*this) >> len;
+				if (len > 120)
+					THROW_EXCEPTION(
+						"Class name has more than 120 chars. This probably "
+						"means a corrupted binary stream.");
+				if (len != ReadBuffer(readClassName, len))
+					THROW_EXCEPTION(
+						"Cannot read object class name from stream!");
+				readClassName[len] = '\0';
+				m_readClassIds.emplace_back(
+					readClassName,
+					mrpt::rtti::findRegisteredClass(readClassName));
+			}
+			const uint32_t id = lengthReadClassName == CLASSID_DEFINITION_FLAG
+				? m_readClassIds.size() - 1
+				: internal_ReadVarUInt();
+			if (id >= m_readClassIds.size())
+				THROW_EXCEPTION_FMT(
+					"Class ID %u has not been defined in this archive. Note "
+					"that streams written with enableClassIdDictionary() "
+					"must be read with one single CArchive object.",
+					static_cast<unsigned int>(id));
+
+			const auto& c = m_readClassIds[id];
+			strClassName = c.first;
+			if (classId) *classId = c.second;
+
+			if (sizeof(version) !=
+				ReadBuffer((void*)&version, sizeof(version)))
+				THROW_EXCEPTION(
+					"Cannot read object streaming version from stream!");
+			return;
+		}
+
 		// Is in old format (< MRPT 0.5.5)?
 		if (!(lengthReadClassName & 0x80))
 		{
@@ -388,6 +503,12 @@ void CArchive::internal_ReadObjectHeader(
 
 		// Pass to string class:
 		strClassName = readClassName;
+		if (classId)
+		{
+			*classId = (strClassName != "nullptr")
+				? mrpt::rtti::findRegisteredClass(strClassName)
+				: nullptr;
+		}
 
 		// Next, the version number:
 		if (isOldFormat)
@@ -492,13 +613,13 @@ void CArchive::ReadObject(CSerializable* existingObj)
 	bool isOldFormat{false};
 	int8_t version{-1};
 
-	internal_ReadObjectHeader(strClassName, isOldFormat, version);
+	const TRuntimeClassId* id2 = nullptr;
+	internal_ReadObjectHeader(strClassName, isOldFormat, version, &id2);
 
 	ASSERT_(existingObj && strClassName != "nullptr");
 	ASSERT_(strClassName != "nullptr");
 
 	const TRuntimeClassId* id = existingObj->GetRuntimeClass();
-	const TRuntimeClassId* id2 = mrpt::rtti::findRegisteredClass(strClassName);
 
 	if (!id2)
 		THROW_EXCEPTION_FMT(
@@ -29,9 +29,17 @@ class Foo : public CSerializable
 
 	int16_t value = 0;
 };
+
+class BarWithLongerName : public CSerializable
+{
+	DEFINE_SERIALIZABLE(BarWithLongerName, MyNS)
+   public:
+	double value = 0;
+};
 }  // namespace MyNS
 
 IMPLEMENTS_SERIALIZABLE(Foo, CSerializable, MyNS);
+IMPLEMENTS_SERIALIZABLE(BarWithLongerName, CSerializable, MyNS);
 
 uint8_t MyNS::Foo::serializeGetVersion() const { return 0; }
 void MyNS::Foo::serializeTo(CArchive& out) const { out << value; }
@@ -40,6 +48,18 @@ void MyNS::Foo::serializeFrom(CArchive& in, uint8_t serial_version)
 	in >> value;
 }
 
+uint8_t MyNS::BarWithLongerName::serializeGetVersion() const { return 1; }
+void MyNS::BarWithLongerName::serializeTo(CArchive& out) const
+{
+	out << value;
+}
+void MyNS::BarWithLongerName::serializeFrom(
+	CArchive& in, uint8_t serial_version)
+{
+	ASSERT_EQUAL_(serial_version, 1);
+	in >> value;
+}
+
 TEST(Serialization, CustomClassSerialize)
 {
 	mrpt::rtti::registerClass(CLASS_ID(MyNS::Foo));
@@ -120,3 +140,117 @@ TEST(Serialization, enums)
 
 	EXPECT_EQ(im1, im2);
 }
+
+TEST(Serialization, ClassIdDictionary)
+{
+	mrpt::rtti::registerClass(CLASS_ID(MyNS::Foo));
+	mrpt::rtti::registerClass(CLASS_ID(MyNS::BarWithLongerName));
+
+	const auto writeAll = [](CArchive& arch) {
+		for (int i = 0; i < 10; i++)
+		{
+			arch << MyNS::Foo(i);
+			auto bar = std::make_shared<MyNS::BarWithLongerName>();
+			bar->value = 0.5 * i;
+			arch << bar;
+		}
+		arch << CSerializable::Ptr();
+	};
+	const auto readAll = [](CArchive& arch) {
+		for (int i = 0; i < 10; i++)
+		{
+			MyNS::Foo foo;
+			arch >> foo;
+			EXPECT_EQ(foo.value, i);
+			auto bar = arch.ReadObject<MyNS::BarWithLongerName>();
+			ASSERT_TRUE(bar);
+			EXPECT_EQ(bar->value, 0.5 * i);
+		}
+		EXPECT_FALSE(arch.ReadObject());
+	};
+
+	mrpt::io::CMemoryStream bufClassic, bufDict;
+	{
+		auto arch = mrpt::serialization::archiveFrom(bufClassic);
+		writeAll(arch);
+	}
+	{
+		auto arch = mrpt::serialization::archiveFrom(bufDict);
+		arch.enableClassIdDictionary();
+		writeAll(arch);
+		// Classic objects can follow in the same stream:
+		arch.enableClassIdDictionary(false);
+		arch << MyNS::Foo(99);
+	}
+	EXPECT_LT(bufDict.getTotalBytesCount(), bufClassic.getTotalBytesCount());
+
+	// Both formats are read by the same code:
+	for (auto* buf : {&bufClassic, &bufDict})
+	{
+		buf->Seek(0);
+		auto arch = mrpt::serialization::archiveFrom(*buf);
+		readAll(arch);
+	}
+	{
+		auto arch = mrpt::serialization::archiveFrom(bufDict);
+		auto foo = arch.ReadObject<MyNS::Foo>();
+		ASSERT_TRUE(foo);
+		EXPECT_EQ(foo->value, 99);
+	}
+
+	// References to classes defined in the stream, by another archive:
+	{
+		bufDict.Seek(0);
+		auto arch = mrpt::serialization::archiveFrom(bufDict);
+		MyNS::Foo foo;
+		MyNS::BarWithLongerName bar;
+		arch >> foo >> bar;
+		auto arch2 = mrpt::serialization::archiveFrom(bufDict);
+		EXPECT_ANY_THROW(arch2 >> foo);
+	}
+}
+
+TEST(Serialization, MemoryArena)
+{
+	mrpt::rtti::registerClass(CLASS_ID(MyNS::BarWithLongerName));
+
+	mrpt::io::CMemoryStream buf;
+	{
+		auto arch = mrpt::serialization::archiveFrom(buf);
+		for (int i = 0; i < 100; i++)
+		{
+			MyNS::BarWithLongerName bar;
+			bar.value = i;
+			arch << bar;
+		}
+	}
+	buf.Seek(0);
+
+	auto arena = std::make_shared<mrpt::MemoryArena>();
+	std::weak_ptr<mrpt::MemoryArena> weakArena = arena;
+
+	std::vector<CSerializable::Ptr> objs;
+	{
+		auto arch = mrpt::serialization::archiveFrom(buf);
+		arch.setMemoryArena(arena);
+		for (int i = 0; i < 100; i++)
+			objs.push_back(arch.ReadObject());
+	}
+	EXPECT_GE(
+		arena->allocatedBytes(), 100 * sizeof(MyNS::BarWithLongerName));
+	EXPECT_EQ(arena->blockCount(), 1U);
+	arena.reset();
+
+	// The objects keep the arena alive:
+	for (int i = 0; i < 100; i++)
+	{
+		auto bar = std::dynamic_pointer_cast<MyNS::BarWithLongerName>(objs[i]);
+		ASSERT_TRUE(bar);
+		EXPECT_EQ(bar->value, i);
+	}
+	EXPECT_FALSE(weakArena.expired());
+	objs.resize(1);
+	EXPECT_FALSE(weakArena.expired());
+	objs.clear();
+	EXPECT_TRUE(weakArena.expired());
+}
@@ -8,12 +8,14 @@
    +------------------------------------------------------------------------+ */
 
 #include <gtest/gtest.h>
+#include <mrpt/core/aligned_std_vector.h>
 #include <mrpt/io/CMemoryStream.h>
 #include <mrpt/serialization/CArchive.h>
 #include <mrpt/serialization/CSerializable.h>
 #include <mrpt/serialization/optional_serialization.h>
 #include <mrpt/serialization/stl_serialization.h>
 
+#include <cstring>
 #include <memory>  // shared_ptr
 
 using namespace mrpt::serialization;
@@ -31,6 +33,47 @@ TEST(Serialization, STL_stdvector)
 	EXPECT_EQ(m1, m2);
 }
 
+// Bulk (contiguous) and per-element containers must produce the same bytes:
+TEST(Serialization, STL_bulk_containers)
+{
+	// (std::vector<double> has its own non-template operator, but not this:)
+	const mrpt::aligned_std_vector<double> v1{1.0, -2.0, 1e10};
+	const std::deque<double> d1(v1.begin(), v1.end());
+	const std::array<float, 4> a1{1.0f, -2.5f, 3.0f, 1e-6f};
+
+	mrpt::io::CMemoryStream fv, fd;
+	auto archV = mrpt::serialization::archiveFrom(fv);
+	auto archD = mrpt::serialization::archiveFrom(fd);
+	archV << v1;
+	archD << d1;
+
+	// Same payload after the container name ("std::vector" vs "std::deque"):
+	ASSERT_EQ(fv.getTotalBytesCount(), fd.getTotalBytesCount() + 1);
+	const size_t payload = 8 * v1.size();
+	const auto* rv = static_cast<const uint8_t*>(fv.getRawBufferData());
+	const auto* rd = static_cast<const uint8_t*>(fd.getRawBufferData());
+	EXPECT_EQ(
+		0,
+		std::memcmp(
+			rv + fv.getTotalBytesCount() - payload,
+			rd + fd.getTotalBytesCount() - payload, payload));
+
+	archV << a1;
+	fv.Seek(0);
+	mrpt::aligned_std_vector<double> v2;
+	std::array<float, 4> a2;
+	archV >> v2 >> a2;
+	EXPECT_EQ(v1, v2);
+	EXPECT_EQ(a1, a2);
+
+	// Truncated streams must still throw:
+	mrpt::io::CMemoryStream ft;
+	ft.assignMemoryNotOwn(fv.getRawBufferData(), fv.getTotalBytesCount() - 4);
+	auto archT = mrpt::serialization::archiveFrom(ft);
+	archT >> v2;
+	EXPECT_ANY_THROW(archT >> a2);
+}
+
 TEST(Serialization, STL_stdmap)
 {
 	std::map<uint32_t, uint8_t> m2, m1;
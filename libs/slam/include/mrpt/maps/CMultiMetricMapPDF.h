@@ -137,6 +137,17 @@ class CMultiMetricMapPDF
 		 */
 		float ICPGlobalAlign_MinQuality{0.70f};
 
+		/** If true, particles duplicated while resampling share their maps
+		 * (see CMultiMetricMap::copyOnWrite), and each one only clones a
+		 * map when it inserts a new observation into it. Results are the
+		 * same, but memory and copying time are saved, since many copies
+		 * are discarded by later resamplings before they insert anything.
+		 * If maps of particles are modified directly, call
+		 * CMultiMetricMap::detachSharedMaps() before (default=false).
+		 * \note (New in MRPT 2.4.9)
+		 */
+		bool copyOnWriteMaps{false};
+
 		mrpt::slam::TKLDParams KLD_params;
 
 		/** ICP parameters, used only when "PF_algorithm=2" in the particle
@@ -257,6 +268,11 @@ class CMultiMetricMapPDF
 
 	bool PF_SLAM_implementation_skipRobotMovement() const override;
 
+	/** Adds the first particle of each group of particles sharing a map
+	 * (TPredictionParams::copyOnWriteMaps). */
+	void PF_SLAM_particlesToEvaluateFirst(
+		std::vector<size_t>& indices) const override;
+
 	/** Evaluate the observation likelihood for one particle at a given location
 	 */
 	double PF_SLAM_computeObservationLikelihoodForParticle(
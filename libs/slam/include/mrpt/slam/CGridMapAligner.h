@@ -18,6 +18,18 @@
 #include <mrpt/typemeta/TEnumType.h>
 #include <mrpt/vision/CFeatureExtraction.h>
 
+#include <memory>
+#include <vector>
+
+namespace mrpt
+{
+class WorkerThreadsPool;
+}
+namespace mrpt::random
+{
+class CRandomGenerator;
+}
+
 namespace mrpt::slam
 {
 /** A class for aligning two multi-metric maps (with an occupancy grid maps and
@@ -25,8 +37,8 @@ namespace mrpt::slam
  * The matching pose is returned as a Sum of Gaussians (poses::CPosePDFSOG).
  *
  *  This class can use three methods (see options.methodSelection):
- *   - amCorrelation: "Brute-force" correlation of the two maps over a
- * 2D+orientation grid of possible 2D poses.
+ *   - amCorrelation: FFT-based phase correlation of the two maps for each
+ * orientation hypothesis, with a coarse-to-fine search in orientation.
  *   - amRobustMatch: Detection of features + RANSAC matching
  *   - amModifiedRANSAC: Detection of features + modified multi-hypothesis
  * RANSAC matching as described in was reported in the paper
@@ -40,7 +52,12 @@ namespace mrpt::slam
 class CGridMapAligner : public mrpt::slam::CMetricMapsAlignmentAlgorithm
 {
    public:
-	CGridMapAligner() : options() {}
+	CGridMapAligner()
+		: options(),
+		  m_grid_feat_extr(
+			  std::make_shared<COccupancyGridMapFeatureExtractor>())
+	{
+	}
 	/** The type for selecting the grid-map alignment algorithm.
 	 */
 	enum TAlignerMethod
@@ -116,6 +133,24 @@ class CGridMapAligner : public mrpt::slam::CMetricMapsAlignmentAlgorithm
 		/** Maximum KL-divergence for merging modes of the SOG (default=0.9) */
 		double maxKLd_for_merge{0.9};
 
+		/** [amCorrelation method only] Orientation step [rad] of the initial
+		 * sweep over all orientations (default=5 deg). */
+		double correlation_coarse_phi_step{mrpt::DEG2RAD(5.0)};
+		/** [amCorrelation method only] Final orientation resolution [rad]
+		 * (default=0.2 deg). */
+		double correlation_fine_phi_step{mrpt::DEG2RAD(0.2)};
+		/** [amCorrelation method only] How many of the best orientations of
+		 * the coarse sweep are refined (default=3). */
+		unsigned int correlation_num_hypotheses{3};
+		/** [amCorrelation method only] Number of threads to evaluate
+		 * orientation hypotheses in parallel (0=as many as CPU cores). */
+		unsigned int correlation_num_threads{0};
+
+		/** [AlignPDFBatch() only] Number of threads to align the candidate
+		 * maps in parallel (0=as many as CPU cores).
+		 * \note (New in MRPT 2.4.9) */
+		unsigned int batch_num_threads{0};
+
 		/** DEBUG - Dump all feature correspondences in a directory "grid_feats"
 		 */
 		bool save_feat_coors{false};
@@ -204,7 +239,7 @@ class CGridMapAligner : public mrpt::slam::CMetricMapsAlignmentAlgorithm
 	 *
 	 * \note The returned PDF depends on the selected alignment method:
 	 *		- "amRobustMatch" --> A "poses::CPosePDFSOG" object.
-	 *		- "amCorrelation" --> A "poses::CPosePDFGrid" object.
+	 *		- "amCorrelation" --> A "poses::CPosePDFGaussian" object.
 	 *
 	 * \return A smart pointer to the output estimated pose PDF.
 	 * \sa CPointsMapAlignmentAlgorithm, options
@@ -215,6 +250,41 @@ class CGridMapAligner : public mrpt::slam::CMetricMapsAlignmentAlgorithm
 		mrpt::optional_ref<TMetricMapAlignmentResult> outInfo =
 			std::nullopt) override;
 
+	/** Aligns one query map against each of a set of candidate maps, like
+	 * calling AlignPDF(query, candidates[i], ...) for each `i`, but running
+	 * the alignments in parallel (see TConfigParams::batch_num_threads).
+	 * The features of the query grid are extracted only once, and those of
+	 * all the grids are kept in the feature extractor cache (see
+	 * setFeatureExtractor()) for the next calls.
+	 *
+	 * \param outInfos If not null, it is resized to the number of
+	 * candidates and filled with the information of each alignment.
+	 * \return The estimated pose PDF of each candidate relative to the
+	 * query map, in the same order than `candidates`.
+	 * \note (New in MRPT 2.4.9)
+	 */
+	std::vector<mrpt::poses::CPosePDF::Ptr> AlignPDFBatch(
+		const mrpt::maps::CMetricMap* query,
+		const std::vector<const mrpt::maps::CMetricMap*>& candidates,
+		const mrpt::poses::CPosePDFGaussian& initialEstimationPDF,
+		std::vector<TReturnInfo>* outInfos = nullptr);
+
+	/** Sets the grid map features extractor, which can be shared among
+	 * several aligners to reuse the features of the same maps (e.g. the
+	 * areas of a topological map). By default, each aligner has its own.
+	 * \note (New in MRPT 2.4.9) */
+	void setFeatureExtractor(
+		const std::shared_ptr<COccupancyGridMapFeatureExtractor>& fe)
+	{
+		ASSERT_(fe);
+		m_grid_feat_extr = fe;
+	}
+	const std::shared_ptr<COccupancyGridMapFeatureExtractor>&
+		getFeatureExtractor() const
+	{
+		return m_grid_feat_extr;
+	}
+
 	/** Not applicable in this class, will launch an exception if used. */
 	mrpt::poses::CPose3DPDF::Ptr Align3DPDF(
 		const mrpt::maps::CMetricMap* m1, const mrpt::maps::CMetricMap* m2,
@@ -223,7 +293,11 @@ class CGridMapAligner : public mrpt::slam::CMetricMapsAlignmentAlgorithm
 			std::nullopt) override;
 
    private:
-	/** Private member, implements one the algorithms.
+	/** Private member, implements one the algorithms: the translation for
+	 * each orientation is found as the peak of the phase correlation of both
+	 * grids, computed with mrpt::math::dft2_real(), evaluating orientations
+	 * from a coarse sweep to the final resolution in parallel threads.
+	 * \note (Reimplemented in MRPT 2.4.9)
 	 */
 	mrpt::poses::CPosePDF::Ptr AlignPDF_correlation(
 		const mrpt::maps::CMetricMap* m1, const mrpt::maps::CMetricMap* m2,
@@ -239,7 +313,14 @@ class CGridMapAligner : public mrpt::slam::CMetricMapsAlignmentAlgorithm
 		TReturnInfo& info);
 
 	/** Grid map features extractor */
-	COccupancyGridMapFeatureExtractor m_grid_feat_extr;
+	std::shared_ptr<COccupancyGridMapFeatureExtractor> m_grid_feat_extr;
+
+	/** For the amCorrelation method and AlignPDFBatch() */
+	std::shared_ptr<mrpt::WorkerThreadsPool> m_threadPool;
+
+	/** RANSAC random numbers source, for the aligners running in parallel in
+	 * AlignPDFBatch() (if null, the global generator is used) */
+	std::shared_ptr<mrpt::random::CRandomGenerator> m_rng;
 };
 
 }  // namespace mrpt::slam
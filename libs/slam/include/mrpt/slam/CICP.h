@@ -12,6 +12,13 @@
 #include <mrpt/slam/CMetricMapsAlignmentAlgorithm.h>
 #include <mrpt/typemeta/TEnumType.h>
 
+#include <memory>
+
+namespace mrpt
+{
+class WorkerThreadsPool;
+}
+
 namespace mrpt::slam
 {
 /** The ICP algorithm selection, used in mrpt::slam::CICP::options  \ingroup
@@ -19,7 +26,11 @@ namespace mrpt::slam
 enum TICPAlgorithm
 {
 	icpClassic = 0,
-	icpLevenbergMarquardt
+	icpLevenbergMarquardt,
+	/** Coarse-to-fine icpClassic over voxel-grid decimated versions of the
+	 * maps, with parallel correspondence search. See
+	 * CICP::TConfigParams::multires_levels (New in MRPT 2.4.9) */
+	icpMultiResolution
 };
 
 /** ICP covariance estimation methods, used in mrpt::slam::CICP::options
@@ -34,6 +45,22 @@ enum TICPCovarianceMethod
 	icpCovFiniteDifferences
 };
 
+/** The error metric minimized at each iteration of 3D ICP, used in
+ * mrpt::slam::CICP::options (New in MRPT 2.4.9) \ingroup mrpt_slam_grp */
+enum TICP3DMetric
+{
+	/** Distance between matched points, minimized in closed form with
+	 * mrpt::tfest::se3_l2() */
+	icp3dPointToPoint = 0,
+	/** Distance from each point to the tangent plane of its match in the
+	 * reference map, minimized with one Gauss-Newton step */
+	icp3dPointToPlane,
+	/** Generalized-ICP (plane-to-plane): Mahalanobis distance between matched
+	 * points with the local covariances of both maps, minimized with one
+	 * Gauss-Newton step */
+	icp3dGeneralized
+};
+
 /** Several implementations of ICP (Iterative closest point) algorithms for
  * aligning two point maps or a point map wrt a grid map.
  *
@@ -85,6 +112,16 @@ class CICP : public mrpt::slam::CMetricMapsAlignmentAlgorithm
 		/** The method to use for covariance estimation (Default:
 		 * icpCovFiniteDifferences) */
 		TICPCovarianceMethod ICP_covariance_method{icpCovFiniteDifferences};
+		/** [3D ICP only] The metric to minimize (default: icp3dPointToPoint).
+		 * The plane-based ones usually converge in much fewer iterations in
+		 * structured scenes. They need both maps to be point maps, otherwise
+		 * icp3dPointToPoint is used. */
+		TICP3DMetric ICP3D_metric{icp3dPointToPoint};
+		/** [3D ICP only] Number of neighbours used to estimate the normals and
+		 * covariances of the points for icp3dPointToPlane and icp3dGeneralized
+		 * (default=10). They are cached in the maps, see
+		 * mrpt::maps::CPointsMap::getLocalSurfaceGeometry() */
+		unsigned int ICP3D_normals_knn{10};
 		/** @} */
 
 		/** @name Correspondence-finding criteria
@@ -174,6 +211,20 @@ class CICP : public mrpt::slam::CMetricMapsAlignmentAlgorithm
 		 * queries,
 		 *  the most expensive step in ICP */
 		uint32_t corresponding_points_decimation{5};
+
+		/** @name icpMultiResolution options
+			@{ */
+		/** Number of resolution levels, including the original maps
+		 * (default=3). */
+		unsigned int multires_levels{3};
+		/** Voxel size (meters) for the first decimated level. Each coarser
+		 * level doubles it (default=0.10). */
+		double multires_voxel_size{0.10};
+		/** Number of threads for the correspondence search, and for the
+		 * normals and the Gauss-Newton steps of 3D ICP. 0 means as many as
+		 * hardware threads (default=1). */
+		unsigned int numThreads{1};
+		/** @} */
 	};
 
 	/** The options employed by the ICP align. */
@@ -235,10 +286,13 @@ class CICP : public mrpt::slam::CMetricMapsAlignmentAlgorithm
 	 */
 	float kernel(float x2, float rho2);
 
+	/** Used to split the correspondence search among threads */
+	struct TParallelMatching;
+
 	mrpt::poses::CPosePDF::Ptr ICP_Method_Classic(
 		const mrpt::maps::CMetricMap* m1, const mrpt::maps::CMetricMap* m2,
 		const mrpt::poses::CPosePDFGaussian& initialEstimationPDF,
-		TReturnInfo& outInfo);
+		TReturnInfo& outInfo, const TParallelMatching* parallel = nullptr);
 	mrpt::poses::CPosePDF::Ptr ICP_Method_LM(
 		const mrpt::maps::CMetricMap* m1, const mrpt::maps::CMetricMap* m2,
 		const mrpt::poses::CPosePDFGaussian& initialEstimationPDF,
@@ -247,12 +301,27 @@ class CICP : public mrpt::slam::CMetricMapsAlignmentAlgorithm
 		const mrpt::maps::CMetricMap* m1, const mrpt::maps::CMetricMap* m2,
 		const mrpt::poses::CPose3DPDFGaussian& initialEstimationPDF,
 		TReturnInfo& outInfo);
+	mrpt::poses::CPosePDF::Ptr ICP_Method_MultiResolution(
+		const mrpt::maps::CMetricMap* m1, const mrpt::maps::CMetricMap* m2,
+		const mrpt::poses::CPosePDFGaussian& initialEstimationPDF,
+		TReturnInfo& outInfo);
+
+	/** Created on demand if options.numThreads!=1 */
+	std::shared_ptr<mrpt::WorkerThreadsPool> m_threadPool;
 };
 }  // namespace mrpt::slam
 MRPT_ENUM_TYPE_BEGIN(mrpt::slam::TICPAlgorithm)
 using namespace mrpt::slam;
 MRPT_FILL_ENUM(icpClassic);
 MRPT_FILL_ENUM(icpLevenbergMarquardt);
+MRPT_FILL_ENUM(icpMultiResolution);
+MRPT_ENUM_TYPE_END()
+
+MRPT_ENUM_TYPE_BEGIN(mrpt::slam::TICP3DMetric)
+using namespace mrpt::slam;
+MRPT_FILL_ENUM(icp3dPointToPoint);
+MRPT_FILL_ENUM(icp3dPointToPlane);
+MRPT_FILL_ENUM(icp3dGeneralized);
 MRPT_ENUM_TYPE_END()
 
 MRPT_ENUM_TYPE_BEGIN(mrpt::slam::TICPCovarianceMethod)
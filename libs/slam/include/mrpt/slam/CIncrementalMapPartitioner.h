@@ -16,6 +16,7 @@
 #include <mrpt/math/CMatrixD.h>
 #include <mrpt/opengl/CSetOfObjects.h>
 #include <mrpt/poses/poses_frwds.h>
+#include <mrpt/slam/observations_overlap.h>
 #include <mrpt/system/COutputLogger.h>
 #include <mrpt/typemeta/TEnumType.h>
 
@@ -79,7 +80,8 @@ class CIncrementalMapPartitioner : public mrpt::system::COutputLogger,
 		double partitionThreshold{1.0};
 
 		/** These parameters are loaded/saved to config files
-		 * with the prefix "mrp.{param_name}" */
+		 * with the prefix "mrp.{param_name}". `mrp.numThreads` is also used
+		 * to evaluate smOBSERVATION_OVERLAP similarities in parallel. */
 		mrpt::maps::TMatchingRatioParams mrp;
 
 		/* Force bisection (true) or automatically determine
@@ -109,6 +111,22 @@ class CIncrementalMapPartitioner : public mrpt::system::COutputLogger,
 		uint64_t maxKeyFrameDistanceToEval{
 			std::numeric_limits<uint64_t>::max()};
 
+		/** If >0, the similarity of a new keyframe is only evaluated against
+		 * those keyframes whose mean position is closer than this distance
+		 * [meters], found with a KD-tree of keyframe positions instead of
+		 * visiting all of them. Default=0 (no limit).
+		 * \note (New in MRPT 2.4.9) */
+		double maxDistanceToEval{0};
+
+		/** If true, updatePartitions() only re-partitions the clusters with
+		 * new keyframes, or with keyframes related (nonzero similarity) to
+		 * them, keeping all other clusters from the last partition. Each
+		 * affected subgraph is split with the same spectral N-cut method, so
+		 * the cost depends on the size of the modified region, not on the
+		 * whole map. Default=false (re-partition the whole graph).
+		 * \note (New in MRPT 2.4.9) */
+		bool incrementalPartitions{false};
+
 		TOptions();
 	};
 
@@ -138,7 +156,8 @@ class CIncrementalMapPartitioner : public mrpt::system::COutputLogger,
 		const mrpt::obs::CSensoryFrame& frame,
 		const mrpt::poses::CPose3DPDF& robotPose3D);
 
-	/** Recalculate the map/graph partitions. \sa addMapFrame() */
+	/** Recalculate the map/graph partitions. \sa addMapFrame(),
+	 * TOptions::incrementalPartitions */
 	void updatePartitions(std::vector<std::vector<uint32_t>>& partitions);
 
 	/**Get the total node count currently in the internal map/graph. */
@@ -221,8 +240,24 @@ class CIncrementalMapPartitioner : public mrpt::system::COutputLogger,
 	 * "updatePartitions" is invoked. */
 	bool m_last_last_partition_are_new_ones{false};
 
+	/** False if m_last_partition does not come from a spectral partition
+	 * (e.g. after removing nodes), hence it cannot be updated incrementally.
+	 */
+	bool m_last_partition_is_valid{false};
+
+	/** Mean position of each keyframe, for TOptions::maxDistanceToEval */
+	mrpt::maps::CSimplePointsMap m_framePositions;
+	void rebuildFramePositions();
+
 	similarity_func_t m_sim_func;
 
+	/** Points of the keyframe observations, for smOBSERVATION_OVERLAP */
+	mrpt::slam::CObservationsOverlapCache m_overlapCache{[]() {
+		mrpt::slam::TObservationsOverlapParams p;
+		p.symmetric = true;
+		return p;
+	}()};
+
 };	// End of class def.
 }  // namespace mrpt::slam
 MRPT_ENUM_TYPE_BEGIN(mrpt::slam::similarity_method_t)
@@ -8,11 +8,18 @@
    +------------------------------------------------------------------------+ */
 #pragma once
 
+#include <mrpt/maps/CPointCloudFilterByVoxelGrid.h>
 #include <mrpt/poses/CRobot2DPoseEstimator.h>
 #include <mrpt/slam/CICP.h>
 #include <mrpt/slam/CMetricMapBuilder.h>
 
+#include <condition_variable>
+#include <deque>
+#include <exception>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
 
 namespace mrpt::slam
 {
@@ -21,6 +28,10 @@ namespace mrpt::slam
  *   Map are stored as in files as binary dumps of "mrpt::maps::CSimpleMap"
  *objects. The methods are
  *	 thread-safe.
+ *
+ * With TConfigParams::asyncMapUpdate, observations are localized against a
+ * read-only snapshot of the map, while a background thread inserts the
+ * keyframes into the map and publishes updated snapshots.
  * \ingroup metric_slam_grp
  */
 class CMetricMapBuilderICP : public mrpt::slam::CMetricMapBuilder
@@ -72,6 +83,27 @@ class CMetricMapBuilderICP : public mrpt::slam::CMetricMapBuilder
 		 * position (default: 0.40) */
 		double minICPgoodnessToAccept;
 
+		/** If >0 (default=0, disabled), the points generated from each
+		 * observation are decimated with a voxel grid of this size (meters)
+		 * before being aligned with ICP against the map.
+		 * \sa mrpt::maps::CPointCloudFilterByVoxelGrid */
+		double voxelFilterSize{0};
+		/** The point kept in each voxel, if voxelFilterSize>0 */
+		mrpt::maps::CPointCloudFilterByVoxelGrid::TVoxelGridMethod
+			voxelFilterMethod{mrpt::maps::CPointCloudFilterByVoxelGrid::
+								  vgFirstPoint};
+
+		/** If true (default=false), processObservation() only localizes the
+		 * robot, against a read-only snapshot of the map, and the
+		 * observations selected for insertion (keyframes) are inserted into
+		 * the map by a background thread, which then publishes a new
+		 * snapshot that is used from the next processObservation() call on.
+		 * This keeps the time per observation bounded by the ICP cost, at
+		 * the price of localizing against a map a few keyframes old.
+		 * \sa waitForMapUpdates()
+		 * \note (New in MRPT 2.4.9) */
+		bool asyncMapUpdate{false};
+
 		mrpt::system::VerbosityLevel& verbosity_level;
 
 		/** What maps to create (at least one points map and/or a grid map are
@@ -136,9 +168,21 @@ class CMetricMapBuilderICP : public mrpt::slam::CMetricMapBuilder
 	 * far built map */
 	void getCurrentlyBuiltMap(mrpt::maps::CSimpleMap& out_map) const override;
 
+	/** With TConfigParams::asyncMapUpdate, blocks until the background
+	 * thread has inserted all pending keyframes into the map, and makes the
+	 * resulting map the one used for localization and returned by
+	 * getCurrentlyBuiltMetricMap(). Call it before saving the final map.
+	 * Does nothing in the synchronous mode.
+	 * \exception std::exception Any error from the mapping thread.
+	 * \note (New in MRPT 2.4.9) */
+	void waitForMapUpdates();
+
 	/** Returns the 2D points of current local map */
 	void getCurrentMapPoints(std::vector<float>& x, std::vector<float>& y);
 
+	/** With TConfigParams::asyncMapUpdate, this is the map snapshot used for
+	 * localization, valid until the next call to processObservation() or
+	 * waitForMapUpdates(). */
 	const mrpt::maps::CMultiMetricMap* getCurrentlyBuiltMetricMap()
 		const override;
 
@@ -191,6 +235,40 @@ class CMetricMapBuilderICP : public mrpt::slam::CMetricMapBuilder
 	std::map<std::string, TDist> m_distSinceLastInsertion;
 	bool m_there_has_been_an_odometry{false};
 
+	/** TConfigParams::asyncMapUpdate state. The mapping thread only accesses
+	 * metricMap and SF_Poses_seq with m_mapMtx locked, and the rest of
+	 * members below with m_keyframesMtx locked. */
+	struct TKeyframe
+	{
+		mrpt::obs::CObservation::Ptr obs;
+		mrpt::poses::CPose2D pose;
+	};
+	mutable std::mutex m_mapMtx;
+	/** Map used for localization (only accessed from the front thread) */
+	std::shared_ptr<mrpt::maps::CMultiMetricMap> m_mapSnapshot;
+	std::mutex m_keyframesMtx;
+	std::condition_variable m_keyframesCv;
+	std::deque<TKeyframe> m_keyframes;
+	/** Keyframes queued or being inserted */
+	size_t m_keyframesPending = 0;
+	/** Latest snapshot published by the mapping thread */
+	std::shared_ptr<mrpt::maps::CMultiMetricMap> m_updatedSnapshot;
+	std::exception_ptr m_mappingError;
+	bool m_mappingThreadExit = false;
+	std::thread m_mappingThread;
+
+	void mappingThreadMain();
+	/** Joins the mapping thread, once it has inserted all pending keyframes
+	 */
+	void stopMappingThread();
+	/** Takes the latest published map snapshot, or creates the first one */
+	void updateMapSnapshot();
+	/** Inserts one observation into metricMap and SF_Poses_seq. m_mapMtx
+	 * must be locked. */
+	void insertKeyframe(
+		const mrpt::obs::CObservation::Ptr& obs,
+		const mrpt::poses::CPose2D& pose);
+
 	void accumulateRobotDisplacementCounters(
 		const mrpt::poses::CPose2D& new_pose);
 	void resetRobotDisplacementCounters(const mrpt::poses::CPose2D& new_pose);
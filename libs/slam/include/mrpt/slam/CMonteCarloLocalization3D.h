@@ -22,6 +22,13 @@ namespace mrpt::slam
  * the MRPT
  *   application "app/pf-localization" for an example of usage.
  *
+ * The likelihood of point cloud observations (mrpt::obs::CObservationPointCloud
+ * and mrpt::obs::CObservationVelodyneScan) in point maps is evaluated over
+ * a decimated copy of each observation, built only once for all particles
+ * (see mrpt::maps::CPointsMap::getLikelihoodCloud()). Particles can be
+ * evaluated in parallel, see
+ * mrpt::bayes::CParticleFilter::TParticleFilterOptions::numThreads.
+ *
  * \sa CMonteCarloLocalization2D, CPose2D, CPosePDF, CPoseGaussianPDF,
  * CParticleFilterCapable
  * \ingroup mrpt_slam_grp
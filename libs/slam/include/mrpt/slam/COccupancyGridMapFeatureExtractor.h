@@ -13,6 +13,10 @@
 #include <mrpt/system/CObserver.h>
 #include <mrpt/vision/CFeatureExtraction.h>
 
+#include <list>
+#include <map>
+#include <mutex>
+
 namespace mrpt::slam
 {
 /**  A class for detecting features from occupancy grid maps.
@@ -26,6 +30,13 @@ namespace mrpt::slam
  * without instantiating COccupancyGridMapFeatureExtractor)
  *  see COccupancyGridMapFeatureExtractor::uncached_extractFeatures()
  *
+ *  Cached features are validated against
+ * mrpt::maps::COccupancyGridMap2D::getMapVersion(), so they are recomputed
+ * if the grid was modified after the extraction, and the cache keeps at most
+ * getCacheSize() grids (the least recently used ones are dropped first).
+ * All methods are thread-safe, so one extractor can be shared by several
+ * CGridMapAligner objects, even when they are used from different threads.
+ *
  * \ingroup mrpt_slam_grp
  */
 class COccupancyGridMapFeatureExtractor : public mrpt::system::CObserver
@@ -38,6 +49,9 @@ class COccupancyGridMapFeatureExtractor : public mrpt::system::CObserver
 	 * mrpt::vision::CFeatureExtraction::TOptions
 	 *
 	 * \note See the paper "..."
+	 * \note Cached results are reused only for the same grid, map version,
+	 * number_of_features and descriptors: `feat_options` is assumed not to
+	 * change between calls (call clearCache() otherwise).
 	 * \sa uncached_extractFeatures
 	 */
 	void extractFeatures(
@@ -61,13 +75,45 @@ class COccupancyGridMapFeatureExtractor : public mrpt::system::CObserver
 		const mrpt::vision::TDescriptorType descriptors,
 		const mrpt::vision::CFeatureExtraction::TOptions& feat_options);
 
+	/** Removes all the cached features. \note (New in MRPT 2.4.9) */
+	void clearCache();
+
+	/** Number of grid maps with cached features.
+	 * \note (New in MRPT 2.4.9) */
+	size_t cachedMapsCount() const;
+
+	/** Sets the maximum number of grid maps with cached features (default:
+	 * 100). \note (New in MRPT 2.4.9) */
+	void setCacheSize(size_t maxGrids);
+	size_t getCacheSize() const;
+
    protected:
 	/** This will receive the events from maps in order to purge the cache. */
 	void OnEvent(const mrpt::system::mrptEvent& e) override;
-	using TCache = std::map<
-		const mrpt::maps::COccupancyGridMap2D*, mrpt::maps::CLandmarksMap::Ptr>;
+
+	/** An entry of the cache: the features of a grid map, and the
+	 * parameters they were computed with. */
+	struct TCacheEntry
+	{
+		uint64_t mapVersion = 0;
+		size_t number_of_features = 0;
+		mrpt::vision::TDescriptorType descriptors = mrpt::vision::descAny;
+		mrpt::maps::CLandmarksMap::Ptr landmarks;
+		/** Position in m_lru */
+		std::list<const mrpt::maps::COccupancyGridMap2D*>::iterator lru;
+	};
+	using TCache =
+		std::map<const mrpt::maps::COccupancyGridMap2D*, TCacheEntry>;
 	/** A cache of already computed maps. */
 	TCache m_cache;
+	/** Grids in m_cache, from the most to the least recently used */
+	std::list<const mrpt::maps::COccupancyGridMap2D*> m_lru;
+	size_t m_cacheSize = 100;
+	/** Protects m_cache, m_lru and m_cacheSize */
+	mutable std::mutex m_cache_mtx;
+
+	/** Drops the least recently used entries. Call with m_cache_mtx locked */
+	void internal_shrinkCache();
 
 };	// End of class def.
 
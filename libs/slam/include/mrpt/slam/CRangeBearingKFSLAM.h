@@ -211,6 +211,11 @@ class CRangeBearingKFSLAM
 		/** Only if data_assoc_IC_metric==ML, the log-ML threshold (Default=0.0)
 		 */
 		double data_assoc_IC_ml_threshold{0.0};
+		/** Options for data_assoc_method==assocJCBB, loaded from the keys
+		 * `data_assoc_JCBB_numThreads`, `data_assoc_JCBB_timeBudget` and
+		 * `data_assoc_JCBB_ransacSeedIterations`.
+		 * \note (New in MRPT 2.4.9) */
+		TJCBBOptions data_assoc_JCBB;
 
 		/** Whether to fill m_SFs (default=false) */
 		bool create_simplemap{false};
@@ -140,6 +140,11 @@ class CRangeBearingKFSLAM2D
 		/** Only if data_assoc_IC_metric==ML, the log-ML threshold (Default=0.0)
 		 */
 		double data_assoc_IC_ml_threshold{0.0};
+		/** Options for data_assoc_method==assocJCBB, loaded from the keys
+		 * `data_assoc_JCBB_numThreads`, `data_assoc_JCBB_timeBudget` and
+		 * `data_assoc_JCBB_ransacSeedIterations`.
+		 * \note (New in MRPT 2.4.9) */
+		TJCBBOptions data_assoc_JCBB;
 	};
 
 	/** The options for the algorithm */
@@ -13,6 +13,9 @@
 #include <mrpt/poses/CPoint2D.h>
 #include <mrpt/poses/CPoint3D.h>
 #include <mrpt/poses/CPose2D.h>
+#include <mrpt/random/RandomGenerators.h>
+
+#include <vector>
 
 namespace mrpt
 {
@@ -66,6 +69,19 @@ class CRejectionSamplingRangeOnlyLocalization
 		float sigmaRanges, const mrpt::poses::CPose2D& oldPose,
 		float robot_z = 0, bool autoCheckAngleRanges = true);
 
+	/** Like rejectionSampling(), drawing the samples in parallel with
+	 * `numThreads` threads (0: all cores).
+	 * Samples are drawn in blocks of consecutive samples, each one with its
+	 * own random generator seeded from mrpt::random::getRandomGenerator(),
+	 * so results do not depend on the number of threads. Call setParams()
+	 * before.
+	 * 
+ote (New in MRPT 2.4.9)
+	 */
+	void rejectionSamplingParallel(
+		size_t desiredSamples, std::vector<TParticle>& outSamples,
+		size_t timeoutTrials = 1000, size_t numThreads = 0);
+
    protected:
 	/** Generates one sample, drawing from some proposal distribution.
 	 */
@@ -104,6 +120,24 @@ class CRejectionSamplingRangeOnlyLocalization
 	/** Data for each beacon observation with a correspondence with the map.
 	 */
 	std::deque<TDataPerBeacon> m_dataPerBeacon;
+
+   private:
+	/** The beacons in m_dataPerBeacon but m_drawIndex, as a structure of
+	 * arrays, for the likelihood evaluation. Built by setParams(). */
+	struct TLikelihoodBeacons
+	{
+		std::vector<double> sensor_x, sensor_y, beacon_x, beacon_y, radius;
+		void clear();
+		void push_back(const TDataPerBeacon& d);
+	};
+	TLikelihoodBeacons m_likBeacons;
+
+	/** RS_drawFromProposal() with a given random generator */
+	void drawFromProposal(
+		mrpt::random::CRandomGenerator& rng,
+		mrpt::poses::CPose2D& outSample) const;
+	/** RS_observationLikelihood(), thread-safe */
+	double observationLikelihood(const mrpt::poses::CPose2D& x) const;
 };
 
 }  // namespace slam
@@ -8,8 +8,13 @@
    +------------------------------------------------------------------------+ */
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
 #include <iostream>
 #include <iterator>
+#include <map>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace mrpt::slam::detail
@@ -18,6 +23,12 @@ using namespace mrpt;
 using namespace mrpt::math;
 using namespace std;
 
+/** Combines bin indices into a hash value */
+inline void hashCombineBin(std::size_t& h, int v)
+{
+	h ^= static_cast<std::size_t>(v) + 0x9e3779b9 + (h << 6) + (h >> 2);
+}
+
 /** Auxiliary structure used in KLD-sampling in particle filters \sa
  * CPosePDFParticles, CMultiMetricMapPDF */
 struct TPoseBin2D
@@ -38,6 +49,19 @@ struct TPoseBin2D
 			return s1.phi < s2.phi;
 		}
 	};
+
+	/** Hash of bins for usage in TStateSpaceBins */
+	struct hash_operator
+	{
+		inline std::size_t operator()(const TPoseBin2D& s) const
+		{
+			std::size_t h = 0;
+			hashCombineBin(h, s.x);
+			hashCombineBin(h, s.y);
+			hashCombineBin(h, s.phi);
+			return h;
+		}
+	};
 };
 
 /** Auxiliary structure   */
@@ -64,6 +88,22 @@ struct TPathBin2D
 			return false;  // If they're exactly equal, s1 is NOT < s2.
 		}
 	};
+
+	/** Hash of bins for usage in TStateSpaceBins */
+	struct hash_operator
+	{
+		std::size_t operator()(const TPathBin2D& s) const
+		{
+			std::size_t h = 0;
+			for (const auto& b : s.bins)
+			{
+				hashCombineBin(h, b.x);
+				hashCombineBin(h, b.y);
+				hashCombineBin(h, b.phi);
+			}
+			return h;
+		}
+	};
 };
 
 /** Auxiliary structure used in KLD-sampling in particle filters \sa
@@ -92,6 +132,147 @@ struct TPoseBin3D
 			return s1.roll < s2.roll;
 		}
 	};
+
+	/** Hash of bins for usage in TStateSpaceBins */
+	struct hash_operator
+	{
+		std::size_t operator()(const TPoseBin3D& s) const
+		{
+			std::size_t h = 0;
+			for (const int v : {s.x, s.y, s.z, s.yaw, s.pitch, s.roll})
+				hashCombineBin(h, v);
+			return h;
+		}
+	};
+};
+
+/** Set of occupied bins for KLD-sampling, implemented as a flat hash table
+ * with open addressing (linear probing), for BINTYPE's with a
+ * `hash_operator`. Bins are identified by their index, in order of insertion.
+ * clear() takes O(1) and keeps the allocated memory, so the same object can be
+ * reused for all the iterations of a particle filter.
+ * \sa TStateSpaceBins
+ * \note (New in MRPT 2.4.9)
+ */
+template <class BINTYPE>
+class TStateSpaceBinsHashSet
+{
+   public:
+	/** Inserts a bin, if it is not already in the set.
+	 * \return The index of the bin, and true if it was inserted. */
+	std::pair<std::size_t, bool> insert(const BINTYPE& b)
+	{
+		if (2 * (m_count + 1) > m_slots.size()) grow();
+		const std::size_t h = typename BINTYPE::hash_operator()(b);
+		const std::size_t mask = m_slots.size() - 1;
+		for (std::size_t i = spread(h) & mask;; i = (i + 1) & mask)
+		{
+			TSlot& s = m_slots[i];
+			if (s.generation != m_generation)
+			{
+				s.generation = m_generation;
+				s.hash = h;
+				s.index = m_count;
+				s.bin = b;
+				return {m_count++, true};
+			}
+			if (s.hash == h && !lt(s.bin, b) && !lt(b, s.bin))
+				return {s.index, false};
+		}
+	}
+
+	/** Number of bins in the set */
+	std::size_t size() const { return m_count; }
+
+	/** Empties the set, without freeing memory */
+	void clear()
+	{
+		m_count = 0;
+		if (++m_generation == 0)
+		{
+			// Wrap around of the counter (once in 2^32 calls):
+			for (auto& s : m_slots)
+				s.generation = 0;
+			m_generation = 1;
+		}
+	}
+
+   private:
+	struct TSlot
+	{
+		BINTYPE bin;
+		std::size_t hash = 0, index = 0;
+		/** The slot is in use only if this equals m_generation */
+		uint32_t generation = 0;
+	};
+	std::vector<TSlot> m_slots;
+	std::size_t m_count = 0;
+	uint32_t m_generation = 1;
+	typename BINTYPE::lt_operator lt;
+
+	static std::size_t spread(std::size_t h)
+	{
+		// Fibonacci hashing, for small, consecutive bin indices:
+		return static_cast<std::size_t>(
+			(static_cast<uint64_t>(h) * UINT64_C(0x9E3779B97F4A7C15)) >> 16);
+	}
+
+	void grow()
+	{
+		std::vector<TSlot> old;
+		old.swap(m_slots);
+		m_slots.resize(std::max<std::size_t>(64, 2 * old.size()));
+		const std::size_t mask = m_slots.size() - 1;
+		for (auto& o : old)
+		{
+			if (o.generation != m_generation) continue;
+			std::size_t i = spread(o.hash) & mask;
+			while (m_slots[i].generation == m_generation)
+				i = (i + 1) & mask;
+			m_slots[i] = std::move(o);
+		}
+	}
+};
+
+/** Set of occupied bins for KLD-sampling for BINTYPE's with only a
+ * `lt_operator`, based on std::map, with the same interface than
+ * TStateSpaceBinsHashSet.
+ * \sa TStateSpaceBins
+ * \note (New in MRPT 2.4.9)
+ */
+template <class BINTYPE>
+class TStateSpaceBinsTreeSet
+{
+   public:
+	std::pair<std::size_t, bool> insert(const BINTYPE& b)
+	{
+		const auto [it, isNew] = m_bins.emplace(b, m_bins.size());
+		return {it->second, isNew};
+	}
+	std::size_t size() const { return m_bins.size(); }
+	void clear() { m_bins.clear(); }
+
+   private:
+	std::map<BINTYPE, std::size_t, typename BINTYPE::lt_operator> m_bins;
 };
 
+template <class BINTYPE, class = void>
+struct has_bin_hash_operator : std::false_type
+{
+};
+template <class BINTYPE>
+struct has_bin_hash_operator<
+	BINTYPE, std::void_t<typename BINTYPE::hash_operator>> : std::true_type
+{
+};
+
+/** The set of occupied bins used in KLD-sampling: a TStateSpaceBinsHashSet
+ * if BINTYPE defines a `hash_operator`, or a TStateSpaceBinsTreeSet otherwise.
+ * \note (New in MRPT 2.4.9)
+ */
+template <class BINTYPE>
+using TStateSpaceBins = std::conditional_t<
+	has_bin_hash_operator<BINTYPE>::value, TStateSpaceBinsHashSet<BINTYPE>,
+	TStateSpaceBinsTreeSet<BINTYPE>>;
+
 }  // namespace mrpt::slam::detail
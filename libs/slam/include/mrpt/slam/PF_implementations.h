@@ -17,6 +17,7 @@
 #include <mrpt/obs/CActionRobotMovement2D.h>
 #include <mrpt/obs/CActionRobotMovement3D.h>
 #include <mrpt/random.h>
+#include <mrpt/slam/PF_aux_structs.h>
 #include <mrpt/slam/PF_implementations_data.h>
 #include <mrpt/slam/TKLDParams.h>
 
@@ -183,7 +184,6 @@ void PF_implementation<PARTICLE_TYPE, MYSELF, STORAGE>::
 		const TKLDParams& KLD_options)
 {
 	MRPT_START
-	using TSetStateSpaceBins = std::set<BINTYPE, typename BINTYPE::lt_operator>;
 
 	auto* me = static_cast<MYSELF*>(this);
 
@@ -199,9 +199,10 @@ void PF_implementation<PARTICLE_TYPE, MYSELF, STORAGE>::
 	{
 		// Find a robot movement estimation:
 		mrpt::poses::CPose3D motionModelMeanIncr;
+		mrpt::obs::CActionRobotMovement2D::Ptr robotMovement2D =
+			actions->getBestMovementEstimation();
+		mrpt::obs::CActionRobotMovement3D::Ptr robotMovement3D;
 		{
-			mrpt::obs::CActionRobotMovement2D::Ptr robotMovement2D =
-				actions->getBestMovementEstimation();
 			// If there is no 2D action, look for a 3D action:
 			if (robotMovement2D)
 			{
@@ -212,7 +213,7 @@ void PF_implementation<PARTICLE_TYPE, MYSELF, STORAGE>::
 			}
 			else
 			{
-				mrpt::obs::CActionRobotMovement3D::Ptr robotMovement3D =
+				robotMovement3D =
 					actions
 						->getActionByClass<mrpt::obs::CActionRobotMovement3D>();
 				if (robotMovement3D)
@@ -237,16 +238,32 @@ void PF_implementation<PARTICLE_TYPE, MYSELF, STORAGE>::
 			// -------------------------------------------------------------
 			// FIXED SAMPLE SIZE
 			// -------------------------------------------------------------
-			mrpt::poses::CPose3D incrPose;
-			for (size_t i = 0; i < M; i++)
+			// Generate 2D or 3D pose increments from the motion model, all at
+			// once. They are all drawn here, in this thread, so the
+			// sequence of random samples (hence, the results) does not depend
+			// on the number of threads:
+			std::vector<mrpt::poses::CPose3D> incrPoses(M);
+			if (robotMovement2D)
 			{
-				// Generate gaussian-distributed 2D-pose increments according to
-				// mean-cov:
-				m_movementDrawer.drawSample(incrPose);
+				std::vector<mrpt::math::TPose2D> incrs;
+				robotMovement2D->drawManySamples(M, incrs);
+				for (size_t i = 0; i < M; i++)
+					incrPoses[i] =
+						mrpt::poses::CPose3D(mrpt::math::TPose3D(incrs[i]));
+			}
+			else
+			{
+				std::vector<mrpt::math::TPose3D> incrs;
+				robotMovement3D->drawManySamples(M, incrs);
+				for (size_t i = 0; i < M; i++)
+					incrPoses[i] = mrpt::poses::CPose3D(incrs[i]);
+			}
+
+			PF_SLAM_parallel_for(PF_options, M, [&](const size_t i) {
 				bool pose_is_valid;
 				const mrpt::poses::CPose3D finalPose =
 					mrpt::poses::CPose3D(getLastPose(i, pose_is_valid)) +
-					incrPose;
+					incrPoses[i];
 
 				// Update the particle with the new pose: this part is
 				// caller-dependant and must be implemented there:
@@ -261,7 +278,7 @@ void PF_implementation<PARTICLE_TYPE, MYSELF, STORAGE>::
 					PF_SLAM_implementation_custom_update_particle_with_new_pose(
 						&me->m_particles[i].d, finalPose.asTPose());
 				}
-			}
+			});
 		}
 		else
 		{
@@ -271,7 +288,10 @@ void PF_implementation<PARTICLE_TYPE, MYSELF, STORAGE>::
 			//  31-Oct-2006 (JLBC): First version
 			//  19-Jan-2009 (JLBC): Rewriten within a generic template
 			// -------------------------------------------------------------
-			TSetStateSpaceBins stateSpaceBins;
+			// Kept between calls, to reuse its memory:
+			static thread_local detail::TStateSpaceBins<BINTYPE>
+				stateSpaceBins;
+			stateSpaceBins.clear();
 
 			size_t Nx = KLD_options.KLD_minSampleSize;
 			const double delta_1 = 1.0 - KLD_options.KLD_delta;
@@ -321,12 +341,9 @@ void PF_implementation<PARTICLE_TYPE, MYSELF, STORAGE>::
 				KLF_loadBinFromParticle<PARTICLE_TYPE, BINTYPE>(
 					p, KLD_options, part, &newPose_s);
 
-				if (stateSpaceBins.find(p) == stateSpaceBins.end())
+				if (stateSpaceBins.insert(p).second)
 				{
 					// It falls into a new bin:
-					// Add to the stateSpaceBins:
-					stateSpaceBins.insert(p);
-
 					// K = K + 1
 					size_t K = stateSpaceBins.size();
 					if (K > 1)	//&& newParticles.size() >
@@ -361,8 +378,7 @@ void PF_implementation<PARTICLE_TYPE, MYSELF, STORAGE>::
 		//	UPDATE STAGE
 		// ----------------------------------------------------------------------
 		// Compute all the likelihood values & update particles weight:
-		for (size_t i = 0; i < M; i++)
-		{
+		auto lambdaUpdateParticle = [&](const size_t i) {
 			bool pose_is_valid;
 			const mrpt::math::TPose3D partPose =
 				getLastPose(i, pose_is_valid);	// Take the particle data:
@@ -372,7 +388,28 @@ void PF_implementation<PARTICLE_TYPE, MYSELF, STORAGE>::
 					PF_options, i, *sf, partPose2);
 			ASSERT_(!std::isnan(obs_log_lik) && std::isfinite(obs_log_lik));
 			me->m_particles[i].log_w += obs_log_lik * PF_options.powFactor;
-		}  // for each particle "i"
+		};
+
+		if (M > 0)
+		{
+			// Some particles (at least, the first one) are always evaluated
+			// in this thread, so maps with lazily-built data (e.g. the
+			// likelihood field cache in occupancy grids) have it ready
+			// before going multithreaded:
+			std::vector<size_t> firstIdxs;
+			me->PF_SLAM_particlesToEvaluateFirst(firstIdxs);
+			std::vector<bool> done(M, false);
+			for (const size_t i : firstIdxs)
+			{
+				ASSERT_LT_(i, M);
+				if (done[i]) continue;
+				lambdaUpdateParticle(i);
+				done[i] = true;
+			}
+			PF_SLAM_parallel_for(PF_options, M, [&](const size_t i) {
+				if (!done[i]) lambdaUpdateParticle(i);
+			});
+		}
 
 		// Normalization of weights is done outside of this method
 		// automatically.
@@ -610,7 +647,6 @@ void PF_implementation<PARTICLE_TYPE, MYSELF, STORAGE>::
 		const TKLDParams& KLD_options, const bool USE_OPTIMAL_SAMPLING)
 {
 	MRPT_START
-	using TSetStateSpaceBins = std::set<BINTYPE, typename BINTYPE::lt_operator>;
 
 	auto* me = static_cast<MYSELF*>(this);
 
@@ -776,7 +812,10 @@ void PF_implementation<PARTICLE_TYPE, MYSELF, STORAGE>::
 		//      "stateSpaceBinsLastTimestepParticles"
 		//  - Added JLBC (01/DEC/2006)
 		// ------------------------------------------------------------------------------
-		TSetStateSpaceBins stateSpaceBinsLastTimestep;
+		// Kept between calls, to reuse its memory:
+		static thread_local detail::TStateSpaceBins<BINTYPE>
+			stateSpaceBinsLastTimestep;
+		stateSpaceBinsLastTimestep.clear();
 		std::vector<std::vector<uint32_t>> stateSpaceBinsLastTimestepParticles;
 		typename MYSELF::CParticleList::iterator partIt;
 		unsigned int partIndex;
@@ -798,16 +837,13 @@ void PF_implementation<PARTICLE_TYPE, MYSELF, STORAGE>::
 				p, KLD_options, part);
 
 			// Is it a new bin?
-			auto posFound = stateSpaceBinsLastTimestep.find(p);
-			if (posFound == stateSpaceBinsLastTimestep.end())
+			const auto [idx, isNew] = stateSpaceBinsLastTimestep.insert(p);
+			if (isNew)
 			{  // Yes, create a new pair <bin,index_list> in the list:
-				stateSpaceBinsLastTimestep.insert(p);
 				stateSpaceBinsLastTimestepParticles.emplace_back(1, partIndex);
 			}
 			else
 			{  // No, add the particle's index to the existing entry:
-				const size_t idx =
-					std::distance(stateSpaceBinsLastTimestep.begin(), posFound);
 				stateSpaceBinsLastTimestepParticles[idx].push_back(partIndex);
 			}
 		}
@@ -856,7 +892,8 @@ void PF_implementation<PARTICLE_TYPE, MYSELF, STORAGE>::
 		size_t k = 0;
 		size_t N = 0;
 
-		TSetStateSpaceBins stateSpaceBins;
+		static thread_local detail::TStateSpaceBins<BINTYPE> stateSpaceBins;
+		stateSpaceBins.clear();
 
 		do	// "N" is the index of the current "new particle":
 		{
@@ -967,11 +1004,9 @@ void PF_implementation<PARTICLE_TYPE, MYSELF, STORAGE>::
 			// -----------------------------------------------------------------------------
 
 			// Found?
-			if (stateSpaceBins.find(p) == stateSpaceBins.end())
+			if (stateSpaceBins.insert(p).second)
 			{
-				// It falls into a new bin: add to the stateSpaceBins:
-				stateSpaceBins.insert(p);
-
+				// It falls into a new bin:
 				// K = K + 1
 				int K = stateSpaceBins.size();
 				if (K > 1)
@@ -10,6 +10,7 @@
 
 #include <mrpt/bayes/CParticleFilterCapable.h>
 #include <mrpt/bayes/CParticleFilterData.h>
+#include <mrpt/core/WorkerThreadsPool.h>
 #include <mrpt/math/TPose3D.h>
 #include <mrpt/obs/CActionRobotMovement2D.h>
 #include <mrpt/poses/CPose3D.h>
@@ -18,6 +19,10 @@
 #include <mrpt/slam/TKLDParams.h>
 #include <mrpt/system/COutputLogger.h>
 
+#include <algorithm>
+#include <memory>
+#include <thread>
+
 namespace mrpt::slam
 {
 // Frwd decl:
@@ -62,6 +67,56 @@ class PF_implementation : public mrpt::system::COutputLogger
 		m_pfAuxiliaryPFOptimal_maxLikDrawnMovement;
 	std::vector<bool> m_pfAuxiliaryPFOptimal_maxLikMovementDrawHasBeenUsed;
 
+	/** Thread pool used if TParticleFilterOptions::numThreads!=1. It is
+	 * created on demand, and shared between copies of this object. */
+	mutable std::shared_ptr<mrpt::WorkerThreadsPool> m_threadPool;
+
+	/** Runs `f(i)` for all `i` in `[0,N)`, splitting the range into contiguous
+	 * blocks processed in parallel by TParticleFilterOptions::numThreads
+	 * threads (0=use all hardware threads). It falls back to a plain loop in
+	 * the calling thread for numThreads=1. Exceptions thrown by `f` are
+	 * re-thrown in the calling thread.
+	 * `f` must be safe to call concurrently for different indices.
+	 */
+	template <typename FUNCTOR>
+	void PF_SLAM_parallel_for(
+		const mrpt::bayes::CParticleFilter::TParticleFilterOptions& PF_options,
+		const size_t N, FUNCTOR&& f) const
+	{
+		size_t nThreads = PF_options.numThreads;
+		if (nThreads == 0)
+			nThreads = std::max<size_t>(1, std::thread::hardware_concurrency());
+		nThreads = std::min(nThreads, N);
+
+		if (nThreads <= 1)
+		{
+			for (size_t i = 0; i < N; i++)
+				f(i);
+			return;
+		}
+
+		if (!m_threadPool || m_threadPool->size() != nThreads)
+			m_threadPool = std::make_shared<mrpt::WorkerThreadsPool>(
+				nThreads, mrpt::WorkerThreadsPool::POLICY_FIFO, "PF_threads");
+
+		std::vector<std::future<void>> tasks;
+		tasks.reserve(nThreads);
+		const size_t blockLen = (N + nThreads - 1) / nThreads;
+		for (size_t i0 = 0; i0 < N; i0 += blockLen)
+		{
+			const size_t i1 = std::min(N, i0 + blockLen);
+			tasks.emplace_back(m_threadPool->enqueue([&f, i0, i1]() {
+				for (size_t i = i0; i < i1; i++)
+					f(i);
+			}));
+		}
+		// Wait for all and propagate exceptions, if any:
+		for (auto& t : tasks)
+			t.wait();
+		for (auto& t : tasks)
+			t.get();
+	}
+
 	/**  Compute w[i]*p(z_t | mu_t^i), with mu_t^i being
 	 *    the mean of the new robot pose
 	 *
@@ -279,6 +334,21 @@ class PF_implementation : public mrpt::system::COutputLogger
 		const mrpt::obs::CSensoryFrame& observation,
 		const mrpt::poses::CPose3D& x) const = 0;
 
+	/** Indices of the particles whose observation likelihood is evaluated in
+	 * the calling thread, before evaluating the rest in parallel (only with
+	 * TParticleFilterOptions::numThreads!=1), so data built upon the first
+	 * likelihood evaluation (e.g. the likelihood field cache of occupancy
+	 * grids) exists before maps are used from several threads. It must
+	 * include one particle per map shared by several particles. By default,
+	 * just the first particle.
+	 * \note (New in MRPT 2.4.9)
+	 */
+	virtual void PF_SLAM_particlesToEvaluateFirst(
+		std::vector<size_t>& indices) const
+	{
+		indices.assign(1, 0);
+	}
+
 	/** @} */
 
 	/** Auxiliary method called by PF implementations: return true if we have
@@ -51,6 +51,39 @@ using observation_index_t = size_t;
 /** Used in mrpt::slam::TDataAssociationResults */
 using prediction_index_t = size_t;
 
+/** Options for the JCBB method (assocJCBB) in
+ * mrpt::slam::data_association_full_covariance() and
+ * mrpt::slam::data_association_independent_predictions().
+ *
+ * With the default values, the search is exhaustive and single-threaded.
+ * \note (New in MRPT 2.4.9)
+ */
+struct TJCBBOptions
+{
+	/** Number of threads exploring the interpretation tree. The first levels
+	 * of the tree are split into subtrees, which are searched in parallel
+	 * sharing the size of the best hypothesis found so far as the bound to
+	 * prune branches. The result is the same than with one thread. 0 means as
+	 * many as hardware threads (default=1). */
+	unsigned int numThreads{1};
+
+	/** If >0, maximum time [seconds] for the search ("anytime" mode): once
+	 * exceeded, the best hypothesis found so far is returned, and
+	 * TDataAssociationResults::JCBB_timedOut is set. Use it together with
+	 * ransacSeedIterations, so there is always a good hypothesis to return
+	 * (default=0: unlimited). */
+	double timeBudget{0};
+
+	/** If >0, the number of randomized greedy hypotheses generated before
+	 * the search, RANSAC-like, each one pairing the observations, taken in a
+	 * random order, to their closest free IC prediction. The best one seeds
+	 * the bound of the search, pruning from the start all the branches that
+	 * cannot match as many features, which is much faster in large cluttered
+	 * problems. The result of an exhaustive search is not changed
+	 * (default=0). */
+	unsigned int ransacSeedIterations{0};
+};
+
 /** The results from mrpt::slam::data_association_independent_predictions()
  */
 struct TDataAssociationResults
@@ -73,6 +106,7 @@ struct TDataAssociationResults
 		indiv_compatibility.setSize(0, 0);
 		indiv_compatibility_counts.clear();
 		nNodesExploredInJCBB = 0;
+		JCBB_timedOut = false;
 	}
 
 	/** For each observation (with row index IDX_obs in the input
@@ -110,6 +144,11 @@ struct TDataAssociationResults
 	/** Only for the JCBB method,the number of recursive calls expent in the
 	 * algorithm. */
 	size_t nNodesExploredInJCBB{0};
+
+	/** Only for the JCBB method, true if the search was stopped due to
+	 * TJCBBOptions::timeBudget, so the hypothesis may not be the best one.
+	 * \note (New in MRPT 2.4.9) */
+	bool JCBB_timedOut{false};
 };
 
 /** Computes the data-association between the prediction of a set of landmarks
@@ -140,6 +179,8 @@ struct TDataAssociationResults
  * \param predictions_IDs [IN, optional] (default:none) An N-vector. If
  *provided, the resulting associations in "results.associations" will not
  *contain prediction indices "i", but "predictions_IDs[i]".
+ * \param jcbbOptions [IN, optional] Parallel, time-budgeted and seeded
+ *search for JCBB. See TJCBBOptions.
  *
  * \sa data_association_independent_predictions,
  *data_association_independent_2d_points,
@@ -156,7 +197,8 @@ void data_association_full_covariance(
 	const std::vector<prediction_index_t>& predictions_IDs =
 		std::vector<prediction_index_t>(),
 	const TDataAssociationMetric compatibilityTestMetric = metricMaha,
-	const double log_ML_compat_test_threshold = 0.0);
+	const double log_ML_compat_test_threshold = 0.0,
+	const TJCBBOptions& jcbbOptions = TJCBBOptions());
 
 /** Computes the data-association between the prediction of a set of landmarks
  *and their observations, all of them with covariance matrices - Generic
@@ -186,6 +228,8 @@ void data_association_full_covariance(
  * \param predictions_IDs [IN, optional] (default:none) An N-vector. If
  *provided, the resulting associations in "results.associations" will not
  *contain prediction indices "i", but "predictions_IDs[i]".
+ * \param jcbbOptions [IN, optional] Parallel, time-budgeted and seeded
+ *search for JCBB. See TJCBBOptions.
  *
  * \sa data_association_full_covariance,
  *data_association_independent_2d_points,
@@ -202,7 +246,8 @@ void data_association_independent_predictions(
 	const std::vector<prediction_index_t>& predictions_IDs =
 		std::vector<prediction_index_t>(),
 	const TDataAssociationMetric compatibilityTestMetric = metricMaha,
-	const double log_ML_compat_test_threshold = 0.0);
+	const double log_ML_compat_test_threshold = 0.0,
+	const TJCBBOptions& jcbbOptions = TJCBBOptions());
 
 /** @} */
 
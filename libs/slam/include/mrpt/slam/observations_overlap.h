@@ -8,9 +8,15 @@
    +------------------------------------------------------------------------+ */
 #pragma once
 
+#include <mrpt/maps/CSimplePointsMap.h>
 #include <mrpt/obs/CSensoryFrame.h>
 #include <mrpt/obs/obs_frwds.h>
 
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
 namespace mrpt::slam
 {
 /**  \addtogroup mrpt_slam_grp
@@ -63,6 +69,140 @@ inline double observationsOverlap(
 	return observationsOverlap(*sf1.get(), *sf2.get(), pose_sf2_wrt_sf1);
 }
 
+/** Parameters of the overlap computations with a CObservationsOverlapCache
+ * \note (New in MRPT 2.4.9) */
+struct TObservationsOverlapParams
+{
+	/** Max. distance between points of both observations to count them as
+	 * overlapping [meters] */
+	float maxDistForCorrespondence = 0.04f;
+	/** Only one out of `decimation` points of each observation is matched
+	 * against the other one (all of them are used as reference points). */
+	size_t decimation = 1;
+	/** If true, the overlap of two observations is the average of the
+	 * overlap in both directions (so it does not depend on their order). */
+	bool symmetric = false;
+	/** Number of threads for the batch functions (0: all cores) */
+	size_t numThreads = 1;
+};
+
+/** The points of an observation as used in overlap computations: all of
+ * them in the robot frame, as a points map with its KD-tree, and a decimated
+ * subset to be matched against other observations.
+ * \sa CObservationsOverlapCache
+ * \note (New in MRPT 2.4.9) */
+struct TObservationOverlapPoints
+{
+	using Ptr = std::shared_ptr<const TObservationOverlapPoints>;
+
+	mrpt::maps::CSimplePointsMap points;
+	mrpt::math::TBoundingBoxf bbox;
+	/** The decimated points */
+	std::vector<float> xs, ys, zs;
+};
+
+/** Cache of the projected and decimated points of observations, so
+ * repeated overlap computations with the same observations (e.g. in
+ * mrpt::slam::CIncrementalMapPartitioner, or place recognition) do not
+ * build temporary points maps nor KD-trees each time.
+ *
+ * Unlike the observationsOverlap() versions without a cache, which only
+ * support pairs of 2D laser scans, any observation that can be inserted
+ * into a mrpt::maps::CSimplePointsMap is supported (2D and 3D range scans,
+ * point clouds, Velodyne scans,...).
+ *
+ * Entries are kept while their observations are alive (they hold weak
+ * references), and are rebuilt if the observation object is replaced. The
+ * cache is thread-safe. Copies of a cache have its parameters but no
+ * entries.
+ *
+ * \note (New in MRPT 2.4.9)
+ */
+class CObservationsOverlapCache
+{
+   public:
+	explicit CObservationsOverlapCache(
+		const TObservationsOverlapParams& params = {})
+		: m_params(params)
+	{
+	}
+	CObservationsOverlapCache(const CObservationsOverlapCache& o)
+		: m_params(o.m_params)
+	{
+	}
+	CObservationsOverlapCache& operator=(const CObservationsOverlapCache& o)
+	{
+		if (this != &o) setParams(o.m_params);
+		return *this;
+	}
+
+	const TObservationsOverlapParams& params() const { return m_params; }
+	/** Changes the parameters. Cached entries are discarded if the
+	 * decimation changes. Not to be called during an overlap computation. */
+	void setParams(const TObservationsOverlapParams& params);
+
+	/** Returns the points of an observation, building them upon the first
+	 * call. Returns nullptr if the observation cannot be converted into
+	 * points. */
+	TObservationOverlapPoints::Ptr getPoints(
+		const mrpt::obs::CObservation::Ptr& obs);
+
+	/** Number of cached observations */
+	size_t size() const;
+	void clear();
+
+   private:
+	TObservationsOverlapParams m_params;
+
+	struct TEntry
+	{
+		std::weak_ptr<mrpt::obs::CObservation> obs;
+		TObservationOverlapPoints::Ptr points;
+	};
+	std::map<const mrpt::obs::CObservation*, TEntry> m_entries;
+	/** Size of m_entries upon which expired entries will be removed */
+	size_t m_nextPurgeSize = 64;
+	mutable std::mutex m_mtx;
+};
+
+/** Like observationsOverlap(), with the points of the observations from a
+ * cache, and the parameters of the cache.
+ * \note (New in MRPT 2.4.9) */
+double observationsOverlap(
+	CObservationsOverlapCache& cache, const mrpt::obs::CObservation::Ptr& o1,
+	const mrpt::obs::CObservation::Ptr& o2,
+	const mrpt::poses::CPose3D* pose_o2_wrt_o1 = nullptr);
+
+/** Like observationsOverlap() for sensory frames, with the points of the
+ * observations from a cache, and the parameters of the cache. The result is
+ * the average overlap of all pairs of observations with points (other
+ * observations, e.g. odometry, are ignored).
+ * \note (New in MRPT 2.4.9) */
+double observationsOverlap(
+	CObservationsOverlapCache& cache, const mrpt::obs::CSensoryFrame& sf1,
+	const mrpt::obs::CSensoryFrame& sf2,
+	const mrpt::poses::CPose3D* pose_sf2_wrt_sf1 = nullptr);
+
+/** Overlap of one observation `o1` with each of the observations in
+ * `others`, computed in parallel (see TObservationsOverlapParams::numThreads)
+ * sharing the KD-tree of `o1`.
+ * \param poses_wrt_o1 Pose of each observation in `others` with respect to
+ * `o1`, or empty to use the origin for all of them.
+ * \return The overlap of each observation in `others`, in the same order.
+ * \note (New in MRPT 2.4.9) */
+std::vector<double> observationsOverlapBatch(
+	CObservationsOverlapCache& cache, const mrpt::obs::CObservation::Ptr& o1,
+	const std::vector<mrpt::obs::CObservation::Ptr>& others,
+	const std::vector<mrpt::poses::CPose3D>& poses_wrt_o1 = {});
+
+/** Overlap of one sensory frame `sf1` with each of the sensory frames in
+ * `others`, computed in parallel. See the version for observations.
+ * \note (New in MRPT 2.4.9) */
+std::vector<double> observationsOverlapBatch(
+	CObservationsOverlapCache& cache, const mrpt::obs::CSensoryFrame& sf1,
+	const std::vector<mrpt::obs::CSensoryFrame::Ptr>& others,
+	const std::vector<mrpt::poses::CPose3D>& poses_wrt_sf1 = {});
+
 /** @} */
 
 /** @} */  // end grouping
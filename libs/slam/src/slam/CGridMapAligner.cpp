@@ -9,6 +9,7 @@
 
 #include "slam-precomp.h"  // Precompiled headers
 //
+#include <mrpt/core/WorkerThreadsPool.h>
 #include <mrpt/img/CEnhancedMetaFile.h>
 #include <mrpt/maps/CLandmarksMap.h>
 #include <mrpt/maps/CMultiMetricMap.h>
@@ -16,8 +17,10 @@
 #include <mrpt/maps/CSimplePointsMap.h>
 #include <mrpt/math/TPose2D.h>
 #include <mrpt/math/distributions.h>
+#include <mrpt/math/fourier.h>
 #include <mrpt/math/geometry.h>
 #include <mrpt/math/ops_containers.h>
+#include <mrpt/math/wrap2pi.h>
 #include <mrpt/poses/CPoint2DPDFGaussian.h>
 #include <mrpt/poses/CPose3DPDFGaussian.h>
 #include <mrpt/poses/CPosePDFGaussian.h>
@@ -28,6 +31,10 @@
 #include <mrpt/tfest/se2.h>
 
 #include <Eigen/Dense>
+#include <algorithm>
+#include <future>
+#include <limits>
+#include <thread>
 
 using namespace mrpt::math;
 using namespace mrpt::slam;
@@ -74,6 +81,93 @@ CPosePDF::Ptr CGridMapAligner::AlignPDF(
 	MRPT_END
 }
 
+std::vector<CPosePDF::Ptr> CGridMapAligner::AlignPDFBatch(
+	const mrpt::maps::CMetricMap* query,
+	const std::vector<const mrpt::maps::CMetricMap*>& candidates,
+	const CPosePDFGaussian& initialEstimationPDF,
+	std::vector<TReturnInfo>* outInfos)
+{
+	MRPT_START
+
+	ASSERT_(query);
+	const size_t N = candidates.size();
+	std::vector<CPosePDF::Ptr> ret(N);
+	std::vector<TReturnInfo> infos(N);
+
+	// se2_l2_robust() already runs in parallel, and draws from the global
+	// random generator, so amRobustMatch candidates are aligned one by one:
+	size_t nThreads = options.batch_num_threads;
+	if (!nThreads) nThreads = std::max(1U, std::thread::hardware_concurrency());
+	nThreads = std::min(nThreads, N);
+	if (options.methodSelection == CGridMapAligner::amRobustMatch)
+		nThreads = 1;
+
+	if (nThreads <= 1)
+	{
+		for (size_t i = 0; i < N; i++)
+			ret[i] = AlignPDF(
+				query, candidates[i], initialEstimationPDF, infos[i]);
+	}
+	else
+	{
+		// Extract the query features once, before all threads need them:
+		if (options.methodSelection != CGridMapAligner::amCorrelation)
+		{
+			const COccupancyGridMap2D* grid = nullptr;
+			if (const auto* mm = dynamic_cast<const CMultiMetricMap*>(query);
+				mm && mm->countMapsByClass<COccupancyGridMap2D>())
+				grid = mm->mapByClass<COccupancyGridMap2D>().get();
+			else
+				grid = dynamic_cast<const COccupancyGridMap2D*>(query);
+			if (grid)
+			{
+				CLandmarksMap lms;
+				m_grid_feat_extr->extractFeatures(
+					*grid, lms,
+					std::max(
+						40,
+						mrpt::round(
+							grid->getArea() * options.featsPerSquareMeter)),
+					options.feature_descriptor,
+					options.feature_detector_options);
+			}
+		}
+
+		if (!m_threadPool || m_threadPool->size() != nThreads)
+			m_threadPool = std::make_shared<mrpt::WorkerThreadsPool>(
+				nThreads, mrpt::WorkerThreadsPool::POLICY_FIFO,
+				"CGridMapAligner");
+
+		// One aligner per candidate, sharing the features cache. Tasks must
+		// not use the pool of this object (they would wait for each other),
+		// so amCorrelation orientations are evaluated sequentially within
+		// each task:
+		CRandomGenerator& rng = m_rng ? *m_rng : getRandomGenerator();
+		std::vector<std::future<void>> futs;
+		futs.reserve(N);
+		for (size_t i = 0; i < N; i++)
+		{
+			const uint32_t seed = rng.drawUniform32bit();
+			futs.emplace_back(m_threadPool->enqueue([&, i, seed]() {
+				CGridMapAligner aligner;
+				aligner.options = options;
+				aligner.options.correlation_num_threads = 1;
+				aligner.m_grid_feat_extr = m_grid_feat_extr;
+				aligner.m_rng = std::make_shared<CRandomGenerator>(seed);
+				ret[i] = aligner.AlignPDF(
+					query, candidates[i], initialEstimationPDF, infos[i]);
+			}));
+		}
+		for (auto& f : futs)
+			f.get();
+	}
+
+	if (outInfos) *outInfos = std::move(infos);
+	return ret;
+
+	MRPT_END
+}
+
 static bool myVectorOrder(
 	const pair<size_t, float>& o1, const pair<size_t, float>& o2)
 {
@@ -162,10 +256,10 @@ CPosePDF::Ptr CGridMapAligner::AlignPDF_robustMatch(
 	const size_t N2 =
 		std::max(40, mrpt::round(m2->getArea() * options.featsPerSquareMeter));
 
-	m_grid_feat_extr.extractFeatures(
+	m_grid_feat_extr->extractFeatures(
 		*m1, *lm1, N1, options.feature_descriptor,
 		options.feature_detector_options);
-	m_grid_feat_extr.extractFeatures(
+	m_grid_feat_extr->extractFeatures(
 		*m2, *lm2, N2, options.feature_descriptor,
 		options.feature_detector_options);
 
@@ -384,6 +478,7 @@ CPosePDF::Ptr CGridMapAligner::AlignPDF_robustMatch(
 				tfest_params.probability_find_good_model =
 					options.ransac_prob_good_inliers;
 				tfest_params.verbose = false;
+				tfest_params.num_threads = 0;  // as many as CPU cores
 
 				mrpt::tfest::TSE2RobustResult tfest_result;
 				mrpt::tfest::se2_l2_robust(
@@ -444,6 +539,7 @@ CPosePDF::Ptr CGridMapAligner::AlignPDF_robustMatch(
 
 				// RANSAC loop
 				// ---------------------
+				CRandomGenerator& rng = m_rng ? *m_rng : getRandomGenerator();
 				const size_t minInliersTOaccept =
 					round(options.ransac_minSetSizeRatio * 0.5 * (nLM1 + nLM2));
 				// Set an initial # of iterations:
@@ -490,10 +586,10 @@ CPosePDF::Ptr CGridMapAligner::AlignPDF_robustMatch(
 
 					// Pick 2 random correspondences:
 					uint32_t idx1, idx2;
-					idx1 = getRandomGenerator().drawUniform32bit() % nCorrs;
+					idx1 = rng.drawUniform32bit() % nCorrs;
 					do
 					{
-						idx2 = getRandomGenerator().drawUniform32bit() % nCorrs;
+						idx2 = rng.drawUniform32bit() % nCorrs;
 					} while (idx1 == idx2);	 // Avoid a degenerated case!
 
 					// Uniqueness of features:
@@ -949,6 +1045,15 @@ CPosePDF::Ptr CGridMapAligner::AlignPDF_robustMatch(
 	MRPT_END
 }
 
+namespace
+{
+struct TCorrelationHypothesis
+{
+	double phi = 0, x = 0, y = 0;
+	float score = -std::numeric_limits<float>::max();
+};
+}  // namespace
+
 /*---------------------------------------------------------------
 					AlignPDF_correlation
 ---------------------------------------------------------------*/
@@ -959,8 +1064,6 @@ CPosePDF::Ptr CGridMapAligner::AlignPDF_correlation(
 {
 	MRPT_START
 
-	//#define	CORRELATION_SHOW_DEBUG
-
 	mrpt::system::CTicTac tictac;
 	tictac.Tic();
 
@@ -972,116 +1075,179 @@ CPosePDF::Ptr CGridMapAligner::AlignPDF_correlation(
 	const auto* m2 = dynamic_cast<const COccupancyGridMap2D*>(mm2);
 
 	ASSERT_EQUAL_(m1->getResolution(), m2->getResolution());
+	ASSERT_GT_(options.correlation_fine_phi_step, 0);
+	ASSERT_GE_(
+		options.correlation_coarse_phi_step, options.correlation_fine_phi_step);
+
+	const double res = m1->getResolution();
+	const int lx1 = m1->getSizeX(), ly1 = m1->getSizeY();
+
+	// Map2, rotated by any angle, fits into a square of its diagonal:
+	const int l2 = 1 +
+		static_cast<int>(std::ceil(
+			std::hypot(
+				m2->getXMax() - m2->getXMin(), m2->getYMax() - m2->getYMin()) /
+			res));
+
+	// Zero padding, large enough to avoid wrapping of the correlation:
+	const size_t Nx = mrpt::round2up<size_t>(lx1 + l2);
+	const size_t Ny = mrpt::round2up<size_t>(ly1 + l2);
+
+	// Cell values are >0 for occupied, <0 for free, 0 for unknown cells:
+	CMatrixFloat A(Ny, Nx), A_re, A_im;
+	A.setZero();
+	for (int cy = 0; cy < ly1; cy++)
+		for (int cx = 0; cx < lx1; cx++)
+			A(cy, cx) = 0.5f - m1->getCell(cx, cy);
+	mrpt::math::dft2_real(A, A_re, A_im);
+
+	// Evaluates one orientation: finds the best translation with the phase
+	// correlation of map1 and the rotated map2.
+	const auto evalOrientation = [&](const double phi) {
+		TCorrelationHypothesis h;
+		h.phi = phi;
+		const double c = std::cos(phi), s = std::sin(phi);
+
+		// Bounding box corner of the rotated map2:
+		double bx0 = std::numeric_limits<double>::max(), by0 = bx0;
+		for (const double x : {m2->getXMin(), m2->getXMax()})
+			for (const double y : {m2->getYMin(), m2->getYMax()})
+			{
+				mrpt::keep_min(bx0, c * x - s * y);
+				mrpt::keep_min(by0, s * x + c * y);
+			}
 
-	// The PDF to estimate:
-	// ------------------------------------------------------
-	CPosePDFGaussian::Ptr PDF = std::make_shared<CPosePDFGaussian>();
-
-	// Determine the extension to compute the correlation into:
-	// ----------------------------------------------------------
-	float phiResolution = DEG2RAD(0.2f);
-	float phiMin = -M_PIf + 0.5f * phiResolution;
-	float phiMax = M_PIf;
-
-	// Compute the difference between maps for each (u,v) pair!
-	// --------------------------------------------------------------
-	float phi;
-	float pivotPt_x = 0.5f * (m1->getXMax() + m1->getXMin());
-	float pivotPt_y = 0.5f * (m1->getYMax() + m1->getYMin());
-	COccupancyGridMap2D map2_mod;
-	CImage map1_img, map2_img;
-	float currentMaxCorr = -1e6f;
-
-	m1->getAsImage(map1_img);
-
-	map2_mod.setSize(
-		m1->getXMin(), m1->getXMax(), m1->getYMin(), m1->getYMax(),
-		m1->getResolution());
-	size_t map2_lx = map2_mod.getSizeX();
-	size_t map2_ly = map2_mod.getSizeY();
-	CMatrixF outCrossCorr, bestCrossCorr;
-	float map2width_2 = 0.5f * (map2_mod.getXMax() - map2_mod.getXMin());
-
-#ifdef CORRELATION_SHOW_DEBUG
-	CDisplayWindow* win = new CDisplayWindow("corr");
-	CDisplayWindow* win2 = new CDisplayWindow("map2_mod");
-#endif
-
-	// --------------------------------------------------------
-	// Use FFT-based correlation for each orientation:
-	// --------------------------------------------------------
-	for (phi = phiMin; phi < phiMax; phi += phiResolution)
-	{
-		// Create the displaced map2 grid, for the size of map1:
-		// --------------------------------------------------------
-		CPose2D v2(
-			pivotPt_x - cos(phi) * map2width_2,
-			pivotPt_y - sin(phi) * map2width_2,
-			phi);  // Rotation point: the centre of img1:
-		CPoint2D v1, v3;
-		v2 = CPose2D(0, 0, 0) - v2;	 // Inverse
-
-		for (size_t cy2 = 0; cy2 < map2_ly; cy2++)
+		CMatrixFloat B(Ny, Nx), B_re, B_im;
+		B.setZero();
+		for (int j = 0; j < l2; j++)
 		{
-			COccupancyGridMap2D::cellType* row = map2_mod.getRow(cy2);
-			for (size_t cx2 = 0; cx2 < map2_lx; cx2++)
+			const double py = by0 + (j + 0.5) * res;
+			for (int i = 0; i < l2; i++)
 			{
-				v3 = v2 + CPoint2D(map2_mod.idx2x(cx2), map2_mod.idx2y(cy2));
-				*row++ = m2->p2l(m2->getPos(v3.x(), v3.y()));
+				const double px = bx0 + (i + 0.5) * res;
+				B(j, i) = 0.5f -
+					m2->getPos(
+						static_cast<float>(c * px + s * py),
+						static_cast<float>(-s * px + c * py));
 			}
 		}
+		mrpt::math::dft2_real(B, B_re, B_im);
 
-		map2_mod.getAsImage(map2_img);
-		//		map2_img.saveToBMP("__debug_map2mod.bmp");
-
-		// Compute the correlation:
-		map1_img.cross_correlation_FFT(
-			map2_img, outCrossCorr, -1, -1, -1, -1,
-			127,  // Bias to be substracted
-			127	 // Bias to be substracted
-		);
-
-		float corrPeak = outCrossCorr.maxCoeff();
-		MRPT_LOG_INFO_FMT("phi = %fdeg \tmax corr=%f", RAD2DEG(phi), corrPeak);
+		// Normalized cross-power spectrum conj(A)*B/|conj(A)*B| (for the sign
+		// convention of mrpt::math::dft2_real()), whose inverse transform
+		// peaks at the cell shift between both grids:
+		for (size_t y = 0; y < Ny; y++)
+			for (size_t x = 0; x < Nx; x++)
+			{
+				const float ar = A_re(y, x), ai = A_im(y, x);
+				const float br = B_re(y, x), bi = B_im(y, x);
+				const float re = ar * br + ai * bi, im = ar * bi - ai * br;
+				const float mag = std::hypot(re, im) + 1e-9f;
+				B_re(y, x) = re / mag;
+				B_im(y, x) = im / mag;
+			}
 
-		// Keep the maximum:
-		if (corrPeak > currentMaxCorr)
+		CMatrixFloat C_re, C_im;
+		mrpt::math::idft2_complex(B_re, B_im, C_re, C_im);
+
+		std::size_t sy, sx;
+		h.score = C_re.maxCoeff(sy, sx);
+
+		// Circular shifts to signed displacements [cells]:
+		const double dx = sx < Nx / 2 ? double(sx) : double(sx) - Nx;
+		const double dy = sy < Ny / 2 ? double(sy) : double(sy) - Ny;
+		h.x = m1->getXMin() - bx0 + dx * res;
+		h.y = m1->getYMin() - by0 + dy * res;
+		return h;
+	};
+
+	size_t nThreads = options.correlation_num_threads;
+	if (!nThreads) nThreads = std::max(1U, std::thread::hardware_concurrency());
+	if (nThreads > 1 && (!m_threadPool || m_threadPool->size() != nThreads))
+		m_threadPool = std::make_shared<mrpt::WorkerThreadsPool>(
+			nThreads, mrpt::WorkerThreadsPool::POLICY_FIFO, "CGridMapAligner");
+
+	const auto evalOrientations = [&](const std::vector<double>& phis) {
+		std::vector<TCorrelationHypothesis> hs(phis.size());
+		if (nThreads > 1)
 		{
-			currentMaxCorr = corrPeak;
-			bestCrossCorr = outCrossCorr;
-			PDF->mean.phi(phi);
+			std::vector<std::future<void>> futs;
+			futs.reserve(phis.size());
+			for (size_t k = 0; k < phis.size(); k++)
+				futs.emplace_back(m_threadPool->enqueue(
+					[&, k]() { hs[k] = evalOrientation(phis[k]); }));
+			for (auto& f : futs)
+				f.get();
 		}
+		else
+		{
+			for (size_t k = 0; k < phis.size(); k++)
+				hs[k] = evalOrientation(phis[k]);
+		}
+		return hs;
+	};
 
-#ifdef CORRELATION_SHOW_DEBUG
-		outCrossCorr.adjustRange(0, 1);
-		CImage aux(outCrossCorr, true);
-		win->showImage(aux);
-		win2->showImage(map2_img);
-		std::this_thread::sleep_for(5ms);
-#endif
-
-	}  // end for phi
+	// Coarse sweep over all orientations:
+	// --------------------------------------------------------
+	const size_t nCoarse = std::max<size_t>(
+		1, mrpt::round(2 * M_PI / options.correlation_coarse_phi_step));
+	double step = 2 * M_PI / nCoarse;
+	std::vector<double> phis(nCoarse);
+	for (size_t k = 0; k < nCoarse; k++)
+		phis[k] = -M_PI + k * step;
+
+	std::vector<TCorrelationHypothesis> best = evalOrientations(phis);
+	std::sort(best.begin(), best.end(), [](const auto& a, const auto& b) {
+		return a.score > b.score;
+	});
+	best.resize(std::min<size_t>(
+		best.size(), std::max(1U, options.correlation_num_hypotheses)));
+
+	// Refine the best ones, down to the final resolution:
+	// --------------------------------------------------------
+	while (step > options.correlation_fine_phi_step)
+	{
+		const double newStep =
+			std::max(0.25 * step, options.correlation_fine_phi_step);
+		const int nSide = static_cast<int>(std::ceil(step / newStep)) - 1;
+
+		phis.clear();
+		for (const auto& h : best)
+			for (int i = -nSide; i <= nSide; i++)
+				if (i != 0)
+					phis.push_back(mrpt::math::wrapToPi(h.phi + i * newStep));
+
+		const auto hs = evalOrientations(phis);
+		for (size_t k = 0; k < best.size(); k++)
+			for (int i = 0; i < 2 * nSide; i++)
+				if (const auto& h = hs[k * 2 * nSide + i];
+					h.score > best[k].score)
+					best[k] = h;
+
+		step = newStep;
+	}
 
-	outInfo.executionTime = tictac.Tac();
+	const auto& bestH = *std::max_element(
+		best.begin(), best.end(),
+		[](const auto& a, const auto& b) { return a.score < b.score; });
 
-#ifdef CORRELATION_SHOW_DEBUG
-	CImage aux;
-	aux.setFromMatrix(bestCrossCorr, false /* do normalization [0,1]*/);
-	aux.saveToFile("_debug_best_corr.png");
-	delete win;
-	delete win2;
-#endif
+	MRPT_LOG_DEBUG_FMT(
+		"Best correlation: x=%f y=%f phi=%fdeg corr=%f", bestH.x, bestH.y,
+		RAD2DEG(bestH.phi), bestH.score);
 
-	// Transform the best corr matrix peak into coordinates:
-	std::size_t uMax, vMax;
-	currentMaxCorr = bestCrossCorr.maxCoeff(uMax, vMax);
+	// The PDF to estimate:
+	// ------------------------------------------------------
+	CPosePDFGaussian::Ptr PDF = std::make_shared<CPosePDFGaussian>();
+	PDF->mean = CPose2D(bestH.x, bestH.y, bestH.phi);
+	PDF->cov.setDiagonal(std::vector<double>(
+		{mrpt::square(res), mrpt::square(res),
+		 mrpt::square(options.correlation_fine_phi_step)}));
 
-	PDF->mean.x(m1->idx2x(uMax));
-	PDF->mean.y(m1->idx2y(vMax));
+	outInfo.goodness = bestH.score;
+	outInfo.executionTime = tictac.Tac();
 
 	return PDF;
 
-	// Done!
 	MRPT_END
 }
 
@@ -1111,6 +1277,11 @@ void CGridMapAligner::TConfigParams::dumpToTextStream(std::ostream& out) const
 	LOADABLEOPTS_DUMP_VAR(save_feat_coors, bool)
 	LOADABLEOPTS_DUMP_VAR(debug_show_corrs, bool)
 	LOADABLEOPTS_DUMP_VAR(debug_save_map_pairs, bool)
+	LOADABLEOPTS_DUMP_VAR_DEG(correlation_coarse_phi_step)
+	LOADABLEOPTS_DUMP_VAR_DEG(correlation_fine_phi_step)
+	LOADABLEOPTS_DUMP_VAR(correlation_num_hypotheses, int)
+	LOADABLEOPTS_DUMP_VAR(correlation_num_threads, int)
+	LOADABLEOPTS_DUMP_VAR(batch_num_threads, int)
 
 	LOADABLEOPTS_DUMP_VAR(feature_descriptor, int)
 
@@ -1152,6 +1323,12 @@ void CGridMapAligner::TConfigParams::loadFromConfigFile(
 	MRPT_LOAD_CONFIG_VAR(debug_show_corrs, bool, iniFile, section)
 	MRPT_LOAD_CONFIG_VAR(debug_save_map_pairs, bool, iniFile, section)
 
+	MRPT_LOAD_CONFIG_VAR_DEGREES(correlation_coarse_phi_step, iniFile, section)
+	MRPT_LOAD_CONFIG_VAR_DEGREES(correlation_fine_phi_step, iniFile, section)
+	MRPT_LOAD_CONFIG_VAR(correlation_num_hypotheses, int, iniFile, section)
+	MRPT_LOAD_CONFIG_VAR(correlation_num_threads, int, iniFile, section)
+	MRPT_LOAD_CONFIG_VAR(batch_num_threads, int, iniFile, section)
+
 	feature_descriptor = iniFile.read_enum(
 		section, "feature_descriptor", feature_descriptor, true);
 	feature_detector_options.loadFromConfigFile(iniFile, section);
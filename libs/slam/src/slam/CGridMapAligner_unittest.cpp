@@ -0,0 +1,113 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/maps/COccupancyGridMap2D.h>
+#include <mrpt/math/wrap2pi.h>
+#include <mrpt/poses/CPose2D.h>
+#include <mrpt/poses/CPosePDFGaussian.h>
+#include <mrpt/slam/CGridMapAligner.h>
+
+using mrpt::maps::COccupancyGridMap2D;
+using mrpt::poses::CPose2D;
+
+// Free space with some walls, in "world" coordinates:
+static float worldCell(double x, double y)
+{
+	const double walls[][4] = {{0, 0, 5, 0.2},	   {0, 0, 0.2, 4},
+							   {4.8, 0, 5, 4},	   {0, 3.8, 5, 4},
+							   {1.5, 1, 1.7, 2.5}, {3, 2, 4, 2.2}};
+	for (const auto& w : walls)
+		if (x >= w[0] && x <= w[2] && y >= w[1] && y <= w[3]) return 0.05f;
+	if (x < 0 || y < 0 || x > 5 || y > 4) return 0.5f;
+	return 0.95f;
+}
+
+// Fills a grid with the world, as seen from the given pose:
+static void fillGrid(COccupancyGridMap2D& grid, const CPose2D& pose)
+{
+	for (unsigned int cy = 0; cy < grid.getSizeY(); cy++)
+		for (unsigned int cx = 0; cx < grid.getSizeX(); cx++)
+		{
+			const auto p = pose.composePoint(
+				mrpt::math::TPoint2D(grid.idx2x(cx), grid.idx2y(cy)));
+			grid.setCell(cx, cy, worldCell(p.x, p.y));
+		}
+}
+
+TEST(CGridMapAligner, amCorrelation)
+{
+	const CPose2D gtPose(0.6, -0.3, mrpt::DEG2RAD(-52.0));
+
+	COccupancyGridMap2D m1(-0.5f, 5.5f, -0.5f, 4.5f, 0.05f);
+	COccupancyGridMap2D m2(-1.5f, 5.5f, -1.5f, 5.0f, 0.05f);
+	fillGrid(m1, CPose2D());
+	fillGrid(m2, gtPose);
+
+	mrpt::slam::CGridMapAligner gma;
+	gma.options.methodSelection = mrpt::slam::CGridMapAligner::amCorrelation;
+
+	for (const unsigned int nThreads : {1U, 2U})
+	{
+		gma.options.correlation_num_threads = nThreads;
+		const auto pdf = gma.AlignPDF(&m1, &m2, {});
+		const auto p = pdf->getMeanVal();
+
+		EXPECT_NEAR(p.x(), gtPose.x(), 0.1);
+		EXPECT_NEAR(p.y(), gtPose.y(), 0.1);
+		EXPECT_NEAR(
+			mrpt::math::angDistance(p.phi(), gtPose.phi()), 0,
+			mrpt::DEG2RAD(0.5));
+	}
+}
+
+TEST(CGridMapAligner, AlignPDFBatch)
+{
+	const CPose2D gtPoses[] = {
+		CPose2D(0.6, -0.3, mrpt::DEG2RAD(-52.0)),
+		CPose2D(-0.2, 0.4, mrpt::DEG2RAD(30.0)),
+		CPose2D(0.1, 0.2, mrpt::DEG2RAD(175.0))};
+
+	COccupancyGridMap2D query(-0.5f, 5.5f, -0.5f, 4.5f, 0.05f);
+	fillGrid(query, CPose2D());
+
+	std::vector<COccupancyGridMap2D> grids;
+	std::vector<const mrpt::maps::CMetricMap*> candidates;
+	for (const auto& p : gtPoses)
+	{
+		grids.emplace_back(-1.5f, 5.5f, -1.5f, 5.0f, 0.05f);
+		fillGrid(grids.back(), p);
+	}
+	for (const auto& g : grids)
+		candidates.push_back(&g);
+
+	mrpt::slam::CGridMapAligner gma;
+	gma.options.methodSelection = mrpt::slam::CGridMapAligner::amCorrelation;
+
+	for (const unsigned int nThreads : {1U, 3U})
+	{
+		gma.options.batch_num_threads = nThreads;
+		std::vector<mrpt::slam::CGridMapAligner::TReturnInfo> infos;
+		const auto pdfs = gma.AlignPDFBatch(&query, candidates, {}, &infos);
+		ASSERT_EQ(pdfs.size(), candidates.size());
+		ASSERT_EQ(infos.size(), candidates.size());
+
+		for (size_t i = 0; i < pdfs.size(); i++)
+		{
+			const auto p = pdfs[i]->getMeanVal();
+			EXPECT_NEAR(p.x(), gtPoses[i].x(), 0.1);
+			EXPECT_NEAR(p.y(), gtPoses[i].y(), 0.1);
+			EXPECT_NEAR(
+				mrpt::math::angDistance(p.phi(), gtPoses[i].phi()), 0,
+				mrpt::DEG2RAD(0.5));
+		}
+	}
+
+	EXPECT_TRUE(gma.AlignPDFBatch(&query, {}, {}).empty());
+}
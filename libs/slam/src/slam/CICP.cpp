@@ -10,6 +10,8 @@
 #include "slam-precomp.h"  // Precompiled headers
 //
 #include <mrpt/config/CConfigFileBase.h>  // MRPT_LOAD_*()
+#include <mrpt/core/WorkerThreadsPool.h>
+#include <mrpt/maps/CSimplePointsMap.h>
 #include <mrpt/math/TPose2D.h>
 #include <mrpt/math/ops_containers.h>
 #include <mrpt/math/wrap2pi.h>
@@ -19,12 +21,17 @@
 #include <mrpt/poses/CPosePDF.h>
 #include <mrpt/poses/CPosePDFGaussian.h>
 #include <mrpt/poses/CPosePDFSOG.h>
+#include <mrpt/poses/Lie/SE.h>
 #include <mrpt/serialization/CArchive.h>
 #include <mrpt/slam/CICP.h>
 #include <mrpt/system/CTicTac.h>
 #include <mrpt/tfest.h>
 
 #include <Eigen/Dense>
+#include <algorithm>
+#include <future>
+#include <thread>
+#include <unordered_map>
 
 using namespace mrpt::slam;
 using namespace mrpt::maps;
@@ -57,6 +64,10 @@ CPosePDF::Ptr CICP::AlignPDF(
 			resultPDF =
 				ICP_Method_LM(m1, mm2, initialEstimationPDF, outInfoVal);
 			break;
+		case icpMultiResolution:
+			resultPDF = ICP_Method_MultiResolution(
+				m1, mm2, initialEstimationPDF, outInfoVal);
+			break;
 		default:
 			THROW_EXCEPTION_FMT(
 				"Invalid value for ICP_algorithm: %i",
@@ -89,6 +100,9 @@ void CICP::TConfigParams::loadFromConfigFile(
 		section, "ICP_algorithm", ICP_algorithm);
 	ICP_covariance_method = iniFile.read_enum<TICPCovarianceMethod>(
 		section, "ICP_covariance_method", ICP_covariance_method);
+	ICP3D_metric =
+		iniFile.read_enum<TICP3DMetric>(section, "ICP3D_metric", ICP3D_metric);
+	MRPT_LOAD_CONFIG_VAR(ICP3D_normals_knn, int, iniFile, section);
 
 	MRPT_LOAD_CONFIG_VAR(thresholdDist, float, iniFile, section);
 	thresholdAng = DEG2RAD(iniFile.read_float(
@@ -122,6 +136,10 @@ void CICP::TConfigParams::loadFromConfigFile(
 
 	MRPT_LOAD_CONFIG_VAR(
 		corresponding_points_decimation, int, iniFile, section);
+
+	MRPT_LOAD_CONFIG_VAR(multires_levels, int, iniFile, section);
+	MRPT_LOAD_CONFIG_VAR(multires_voxel_size, double, iniFile, section);
+	MRPT_LOAD_CONFIG_VAR(numThreads, int, iniFile, section);
 }
 
 void CICP::TConfigParams::saveToConfigFile(
@@ -133,6 +151,11 @@ void CICP::TConfigParams::saveToConfigFile(
 		ICP_covariance_method,
 		"Method to use for covariance estimation (see enum "
 		"TICPCovarianceMethod)");
+	MRPT_SAVE_CONFIG_VAR_COMMENT(
+		ICP3D_metric, "[3D ICP] The metric to minimize (see enum TICP3DMetric)");
+	MRPT_SAVE_CONFIG_VAR_COMMENT(
+		ICP3D_normals_knn,
+		"[3D ICP] Neighbours to estimate normals and covariances");
 	MRPT_SAVE_CONFIG_VAR_COMMENT(
 		onlyUniqueRobust,
 		"Only the closest correspondence for each reference point will be "
@@ -170,6 +193,15 @@ void CICP::TConfigParams::saveToConfigFile(
 	MRPT_SAVE_CONFIG_VAR_COMMENT(skip_cov_calculation, "");
 	MRPT_SAVE_CONFIG_VAR_COMMENT(skip_quality_calculation, "");
 	MRPT_SAVE_CONFIG_VAR_COMMENT(corresponding_points_decimation, "");
+	MRPT_SAVE_CONFIG_VAR_COMMENT(
+		multires_levels,
+		"[icpMultiResolution] Number of levels, including the original maps");
+	MRPT_SAVE_CONFIG_VAR_COMMENT(
+		multires_voxel_size,
+		"[icpMultiResolution] Voxel size [m] of the first decimated level");
+	MRPT_SAVE_CONFIG_VAR_COMMENT(
+		numThreads,
+		"Threads for correspondence search and 3D ICP steps (0=all)");
 }
 
 float CICP::kernel(float x2, float rho2)
@@ -177,6 +209,78 @@ float CICP::kernel(float x2, float rho2)
 	return options.use_kernel ? (x2 / (x2 + rho2)) : x2;
 }
 
+/** Splits the points of the "other" map into interleaved subsets (point `i`
+ * goes into subset `i % K`), and runs determineMatching2D() for each one in
+ * a thread pool. Results are merged so they are equivalent to those of a
+ * single call over the whole map. */
+struct CICP::TParallelMatching
+{
+	const CMetricMap* m1 = nullptr;
+	mrpt::WorkerThreadsPool* pool = nullptr;
+	std::vector<CSimplePointsMap> parts;
+
+	TParallelMatching(
+		const CMetricMap* map1, const CPointsMap& m2, size_t nParts,
+		mrpt::WorkerThreadsPool& threadPool)
+		: m1(map1), pool(&threadPool), parts(nParts)
+	{
+		const auto& xs = m2.getPointsBufferRef_x();
+		const auto& ys = m2.getPointsBufferRef_y();
+		const auto& zs = m2.getPointsBufferRef_z();
+		for (auto& p : parts)
+			p.reserve(xs.size() / nParts + 1);
+		for (size_t i = 0; i < xs.size(); i++)
+			parts[i % nParts].insertPointFast(xs[i], ys[i], zs[i]);
+
+		// Build lazy caches (KD-tree, bounding box) of m1 now, so worker
+		// threads only read them:
+		if (const auto* pm1 = dynamic_cast<const CPointsMap*>(m1);
+			pm1 && !pm1->empty())
+		{
+			pm1->boundingBox();
+			float dist2;
+			pm1->kdTreeClosestPoint2D(0, 0, dist2);
+		}
+	}
+
+	void determineMatching2D(
+		const CPose2D& pose, TMatchingPairList& corrs,
+		const TMatchingParams& params, TMatchingExtraResults& extra) const
+	{
+		const size_t K = parts.size();
+		std::vector<TMatchingPairList> partCorrs(K);
+		std::vector<TMatchingExtraResults> partExtra(K);
+		std::vector<std::future<void>> futs;
+		futs.reserve(K);
+		for (size_t k = 0; k < K; k++)
+			futs.emplace_back(pool->enqueue([&, k]() {
+				m1->determineMatching2D(
+					&parts[k], pose, partCorrs[k], params, partExtra[k]);
+			}));
+		for (auto& f : futs)
+			f.get();
+
+		// Merge, with indices referred to the original "other" map:
+		corrs.clear();
+		size_t nTotal = 0;
+		double ratio = 0, sqrDist = 0;
+		for (size_t k = 0; k < K; k++)
+		{
+			const size_t nPart = parts[k].size();
+			nTotal += nPart;
+			ratio += partExtra[k].correspondencesRatio * nPart;
+			sqrDist += partExtra[k].sumSqrDist * partCorrs[k].size();
+			for (auto c : partCorrs[k])
+			{
+				c.localIdx = c.localIdx * K + k;
+				corrs.push_back(c);
+			}
+		}
+		extra.correspondencesRatio = nTotal ? ratio / nTotal : 0;
+		extra.sumSqrDist = corrs.empty() ? 0 : sqrDist / corrs.size();
+	}
+};
+
 /*----------------------------------------------------------------------------
 
 					ICP_Method_Classic
@@ -184,7 +288,8 @@ float CICP::kernel(float x2, float rho2)
   ----------------------------------------------------------------------------*/
 CPosePDF::Ptr CICP::ICP_Method_Classic(
 	const mrpt::maps::CMetricMap* m1, const mrpt::maps::CMetricMap* mm2,
-	const CPosePDFGaussian& initialEstimationPDF, TReturnInfo& outInfo)
+	const CPosePDFGaussian& initialEstimationPDF, TReturnInfo& outInfo,
+	const TParallelMatching* parallel)
 {
 	MRPT_START
 
@@ -232,6 +337,18 @@ CPosePDF::Ptr CICP::ICP_Method_Classic(
 	matchParams.onlyUniqueRobust = options.onlyUniqueRobust;
 	matchParams.decimation_other_map_points =
 		options.corresponding_points_decimation;
+	// Threads within each search, unless already split among threads:
+	matchParams.numThreads = parallel ? 1 : options.numThreads;
+
+	// Correspondence search, maybe split among threads:
+	const auto determineMatching = [&](const CPose2D& pose,
+										 TMatchingPairList& corrs,
+										 const TMatchingParams& params,
+										 TMatchingExtraResults& extra) {
+		if (parallel) parallel->determineMatching2D(pose, corrs, params, extra);
+		else
+			m1->determineMatching2D(m2, pose, corrs, params, extra);
+	};
 
 	// Ensure maps are not empty!
 	// ------------------------------------------------------
@@ -251,8 +368,7 @@ CPosePDF::Ptr CICP::ICP_Method_Classic(
 				gaussPdf->mean.x(), gaussPdf->mean.y(),
 				0);	 // Pivot point for angular measurements
 
-			m1->determineMatching2D(
-				m2,	 // The other map
+			determineMatching(
 				gaussPdf->mean,	 // The other map pose
 				correspondences, matchParams, matchExtraResults);
 
@@ -470,31 +586,26 @@ CPosePDF::Ptr CICP::ICP_Method_Classic(
 
 			matchParams.angularDistPivotPoint =
 				TPoint3D(gaussPdf->mean.x(), gaussPdf->mean.y(), 0);
-			m1->determineMatching2D(
-				m2,	 // The other map
+			determineMatching(
 				P0,	 // The other map pose
 				correspondences, matchParams, matchExtraResults);
 			const float E0 = matchExtraResults.correspondencesRatio;
 
-			m1->determineMatching2D(
-				m2,	 // The other map
+			determineMatching(
 				PX1,  // The other map pose
 				correspondences, matchParams, matchExtraResults);
 			const float EX1 = matchExtraResults.correspondencesRatio;
 
-			m1->determineMatching2D(
-				m2,	 // The other map
+			determineMatching(
 				PX2,  // The other map pose
 				correspondences, matchParams, matchExtraResults);
 			const float EX2 = matchExtraResults.correspondencesRatio;
 
-			m1->determineMatching2D(
-				m2,	 // The other map
+			determineMatching(
 				PY1,  // The other map pose
 				correspondences, matchParams, matchExtraResults);
 			const float EY1 = matchExtraResults.correspondencesRatio;
-			m1->determineMatching2D(
-				m2,	 // The other map
+			determineMatching(
 				PY2,  // The other map pose
 				correspondences, matchParams, matchExtraResults);
 			const float EY2 = matchExtraResults.correspondencesRatio;
@@ -544,6 +655,155 @@ CPosePDF::Ptr CICP::ICP_Method_Classic(
 	MRPT_END
 }
 
+/*----------------------------------------------------------------------------
+
+					ICP_Method_MultiResolution
+
+  ----------------------------------------------------------------------------*/
+namespace
+{
+/** Returns a map with the centroid of the points within each voxel */
+CSimplePointsMap voxelGridDecimate(const CPointsMap& in, double voxelSize)
+{
+	const auto& xs = in.getPointsBufferRef_x();
+	const auto& ys = in.getPointsBufferRef_y();
+	const auto& zs = in.getPointsBufferRef_z();
+
+	struct TVoxel
+	{
+		float x = 0, y = 0, z = 0;
+		size_t n = 0;
+	};
+	const auto voxelIndex = [voxelSize](float v) {
+		return static_cast<int32_t>(std::floor(v / voxelSize));
+	};
+	const auto voxelKey = [&](float x, float y, float z) {
+		const uint64_t ix = static_cast<uint32_t>(voxelIndex(x)) & 0x1fffff;
+		const uint64_t iy = static_cast<uint32_t>(voxelIndex(y)) & 0x1fffff;
+		const uint64_t iz = static_cast<uint32_t>(voxelIndex(z)) & 0x1fffff;
+		return ix | (iy << 21) | (iz << 42);
+	};
+
+	std::unordered_map<uint64_t, TVoxel> voxels;
+	std::vector<uint64_t> order;  // Keep the original points ordering
+	voxels.reserve(xs.size());
+	for (size_t i = 0; i < xs.size(); i++)
+	{
+		const auto key = voxelKey(xs[i], ys[i], zs[i]);
+		auto& v = voxels[key];
+		if (!v.n) order.push_back(key);
+		v.x += xs[i];
+		v.y += ys[i];
+		v.z += zs[i];
+		v.n++;
+	}
+
+	CSimplePointsMap out;
+	out.reserve(order.size());
+	for (const auto key : order)
+	{
+		const auto& v = voxels[key];
+		out.insertPointFast(v.x / v.n, v.y / v.n, v.z / v.n);
+	}
+	return out;
+}
+}  // namespace
+
+CPosePDF::Ptr CICP::ICP_Method_MultiResolution(
+	const mrpt::maps::CMetricMap* m1, const mrpt::maps::CMetricMap* mm2,
+	const CPosePDFGaussian& initialEstimationPDF, TReturnInfo& outInfo)
+{
+	MRPT_START
+
+	ASSERT_GE_(options.multires_levels, 1U);
+	ASSERT_GT_(options.multires_voxel_size, 0);
+
+	const auto* m2 = dynamic_cast<const CPointsMap*>(mm2);
+	// The "other" map must be a point map, both for decimation and splitting:
+	if (!m2) return ICP_Method_Classic(m1, mm2, initialEstimationPDF, outInfo);
+
+	const auto* pm1 = dynamic_cast<const CPointsMap*>(m1);
+
+	size_t nThreads = options.numThreads;
+	if (!nThreads) nThreads = std::max(1U, std::thread::hardware_concurrency());
+	if (nThreads > 1 && (!m_threadPool || m_threadPool->size() != nThreads))
+		m_threadPool = std::make_shared<mrpt::WorkerThreadsPool>(
+			nThreads, mrpt::WorkerThreadsPool::POLICY_FIFO, "CICP");
+
+	// Per-level options are set into "options", restored upon exit:
+	const TConfigParams origOptions = options;
+	struct RestoreOptions
+	{
+		TConfigParams& o;
+		const TConfigParams& orig;
+		~RestoreOptions() { o = orig; }
+	} restorer{options, origOptions};
+
+	CPosePDFGaussian estimate = initialEstimationPDF;
+	CPosePDF::Ptr resultPDF;
+	unsigned int nTotalIterations = 0;
+
+	for (int level = static_cast<int>(origOptions.multires_levels) - 1;
+		 level >= 0; level--)
+	{
+		// Level 0 = original maps
+		CSimplePointsMap dec1, dec2;
+		const CMetricMap* lm1 = m1;
+		const CPointsMap* lm2 = m2;
+		options = origOptions;
+		if (level > 0)
+		{
+			const double voxel =
+				origOptions.multires_voxel_size * std::pow(2.0, level - 1);
+			if (pm1)
+			{
+				dec1 = voxelGridDecimate(*pm1, voxel);
+				lm1 = &dec1;
+			}
+			dec2 = voxelGridDecimate(*m2, voxel);
+			lm2 = &dec2;
+
+			options.thresholdDist *= std::pow(2.0, level);
+			options.smallestThresholdDist =
+				std::max(origOptions.smallestThresholdDist, voxel);
+			options.skip_cov_calculation = true;
+			options.skip_quality_calculation = true;
+			options.doRANSAC = false;
+			options.corresponding_points_decimation = 1;
+		}
+
+		TReturnInfo levelInfo;
+		if (nThreads > 1 && !options.onlyUniqueRobust && pm1 &&
+			lm2->size() >= 2 * nThreads)
+		{
+			const TParallelMatching parallel(
+				lm1, *lm2, nThreads, *m_threadPool);
+			resultPDF =
+				ICP_Method_Classic(lm1, lm2, estimate, levelInfo, &parallel);
+		}
+		else
+		{
+			resultPDF = ICP_Method_Classic(lm1, lm2, estimate, levelInfo);
+		}
+		nTotalIterations += levelInfo.nIterations;
+
+		if (level > 0)
+		{
+			// Carry the estimate to the next finer level:
+			estimate.mean = resultPDF->getMeanVal();
+		}
+		else
+		{
+			outInfo = levelInfo;
+		}
+	}
+	outInfo.nIterations = nTotalIterations;
+
+	return resultPDF;
+
+	MRPT_END
+}
+
 /*----------------------------------------------------------------------------
 
 						ICP_Method_LM
@@ -919,6 +1179,7 @@ CPose3DPDF::Ptr CICP::Align3DPDF(
 				ICP3D_Method_Classic(m1, mm2, initialEstimationPDF, outInfoVal);
 			break;
 		case icpLevenbergMarquardt:
+		case icpMultiResolution:
 			THROW_EXCEPTION("Only icpClassic is implemented for ICP-3D");
 			break;
 		default:
@@ -939,6 +1200,118 @@ CPose3DPDF::Ptr CICP::Align3DPDF(
 	MRPT_END
 }
 
+namespace
+{
+/** One Gauss-Newton step of the icp3dPointToPlane or icp3dGeneralized cost
+ * for the given correspondences, starting at `pose`. The normal equations
+ * are accumulated by chunks of correspondences in the thread pool, if any.
+ * Returns false if the step could not be computed. */
+bool gaussNewtonStep3D(
+	const TMatchingPairList& corrs, const CPose3D& pose, TICP3DMetric metric,
+	const CPointsMap::TLocalSurfaceGeometry& geom1,
+	const CPointsMap::TLocalSurfaceGeometry* geom2,
+	mrpt::WorkerThreadsPool* pool, CPose3D& newPose)
+{
+	using Matrix6d = Eigen::Matrix<double, 6, 6>;
+	using Vector6d = Eigen::Matrix<double, 6, 1>;
+
+	struct NormalEquations
+	{
+		Matrix6d H = Matrix6d::Zero();
+		Vector6d g = Vector6d::Zero();
+	};
+
+	const Eigen::Matrix3d R = pose.getRotationMatrix().asEigen();
+	const Eigen::Vector3d t(pose.x(), pose.y(), pose.z());
+
+	// Residuals are r = T*q - p, for "p" in m1 and "q" in m2, with Jacobian
+	// [I, -[T*q]_x] wrt a left increment (SE<3>::exp) of T:
+	const auto lmbAccumulate = [&](size_t i0, size_t i1) {
+		NormalEquations ne;
+		for (size_t i = i0; i < i1; i++)
+		{
+			const auto& c = corrs[i];
+			const Eigen::Vector3d p(c.global.x, c.global.y, c.global.z);
+			const Eigen::Vector3d q =
+				R * Eigen::Vector3d(c.local.x, c.local.y, c.local.z) + t;
+			const Eigen::Vector3d r = q - p;
+
+			if (metric == icp3dPointToPlane)
+			{
+				const auto& n1 = geom1.normals[c.globalIdx];
+				const Eigen::Vector3d n(n1.x, n1.y, n1.z);
+				Vector6d J;
+				J.head<3>() = n;
+				J.tail<3>() = q.cross(n);
+				ne.H.noalias() += J * J.transpose();
+				ne.g.noalias() += J * n.dot(r);
+			}
+			else
+			{
+				const Eigen::Matrix3d C =
+					geom1.covariances[c.globalIdx].asEigen().cast<double>() +
+					R *
+						geom2->covariances[c.localIdx]
+							.asEigen()
+							.cast<double>() *
+						R.transpose();
+				const Eigen::Matrix3d M = C.inverse();
+				Eigen::Matrix<double, 3, 6> J;
+				J.leftCols<3>().setIdentity();
+				J.rightCols<3>() << 0, q.z(), -q.y(),  //
+					-q.z(), 0, q.x(),  //
+					q.y(), -q.x(), 0;
+				const Eigen::Matrix<double, 6, 3> JtM = J.transpose() * M;
+				ne.H.noalias() += JtM * J;
+				ne.g.noalias() += JtM * r;
+			}
+		}
+		return ne;
+	};
+
+	const size_t N = corrs.size();
+	// Less than this number of correspondences per task is not worth it:
+	constexpr size_t minCorrsPerTask = 1024;
+	const size_t nTasks = pool
+		? std::max<size_t>(1, std::min(pool->size(), N / minCorrsPerTask))
+		: 1;
+
+	NormalEquations total;
+	if (nTasks == 1)
+		total = lmbAccumulate(0, N);
+	else
+	{
+		std::vector<std::future<NormalEquations>> tasks;
+		for (size_t k = 0; k < nTasks; k++)
+			tasks.emplace_back(pool->enqueue(
+				lmbAccumulate, N * k / nTasks, N * (k + 1) / nTasks));
+		// Always summed up in the same order:
+		for (auto& f : tasks)
+		{
+			const auto ne = f.get();
+			total.H += ne.H;
+			total.g += ne.g;
+		}
+	}
+
+	// A tiny damping keeps the system solvable in degenerate scenes (e.g. one
+	// single plane), leaving the unobservable directions unchanged:
+	const double damping = 1e-9 * std::max(1.0, total.H.diagonal().maxCoeff());
+	total.H.diagonal().array() += damping;
+
+	const Eigen::LDLT<Matrix6d> ldlt(total.H);
+	if (ldlt.info() != Eigen::Success) return false;
+	const Vector6d delta = -ldlt.solve(total.g);
+	if (!delta.allFinite()) return false;
+
+	mrpt::poses::Lie::SE<3>::tangent_vector incr;
+	for (int k = 0; k < 6; k++)
+		incr[k] = delta[k];
+	newPose = mrpt::poses::Lie::SE<3>::exp(incr) + pose;
+	return true;
+}
+}  // namespace
+
 CPose3DPDF::Ptr CICP::ICP3D_Method_Classic(
 	const mrpt::maps::CMetricMap* m1, const mrpt::maps::CMetricMap* mm2,
 	const CPose3DPDFGaussian& initialEstimationPDF, TReturnInfo& outInfo)
@@ -959,6 +1332,26 @@ CPose3DPDF::Ptr CICP::ICP3D_Method_Classic(
 	ASSERT_(mm2->GetRuntimeClass()->derivedFrom(CLASS_ID(CPointsMap)));
 	const CPointsMap* m2 = (CPointsMap*)mm2;
 
+	// Normals and covariances for the plane-based metrics:
+	const auto* pm1 = dynamic_cast<const CPointsMap*>(m1);
+	const TICP3DMetric metric = pm1 ? options.ICP3D_metric : icp3dPointToPoint;
+	const CPointsMap::TLocalSurfaceGeometry *geom1 = nullptr, *geom2 = nullptr;
+	size_t nThreads = options.numThreads;
+	if (!nThreads) nThreads = std::max(1U, std::thread::hardware_concurrency());
+	if (metric != icp3dPointToPoint && !pm1->isEmpty() && !m2->isEmpty())
+	{
+		geom1 =
+			&pm1->getLocalSurfaceGeometry(options.ICP3D_normals_knn, nThreads);
+		if (metric == icp3dGeneralized)
+			geom2 = &m2->getLocalSurfaceGeometry(
+				options.ICP3D_normals_knn, nThreads);
+
+		if (nThreads > 1 &&
+			(!m_threadPool || m_threadPool->size() != nThreads))
+			m_threadPool = std::make_shared<mrpt::WorkerThreadsPool>(
+				nThreads, mrpt::WorkerThreadsPool::POLICY_FIFO, "CICP");
+	}
+
 	// Asserts:
 	// -----------------
 	ASSERT_(options.ALFA > 0 && options.ALFA < 1);
@@ -988,6 +1381,7 @@ CPose3DPDF::Ptr CICP::ICP3D_Method_Classic(
 	matchParams.onlyUniqueRobust = options.onlyUniqueRobust;
 	matchParams.decimation_other_map_points =
 		options.corresponding_points_decimation;
+	matchParams.numThreads = options.numThreads;
 
 	// Ensure maps are not empty!
 	// ------------------------------------------------------
@@ -1020,14 +1414,27 @@ CPose3DPDF::Ptr CICP::ICP3D_Method_Classic(
 			}
 			else
 			{
-				// Compute the estimated pose, using Horn's method.
-				// ----------------------------------------------------------------------
-				mrpt::poses::CPose3DQuat estPoseQuat;
-				double transf_scale;
-				mrpt::tfest::se3_l2(
-					correspondences, estPoseQuat, transf_scale,
-					false /* dont force unit scale */);
-				gaussPdf->mean = mrpt::poses::CPose3D(estPoseQuat);
+				if (geom1)
+				{
+					// Gauss-Newton step of the point-to-plane or GICP cost:
+					CPose3D newPose;
+					if (gaussNewtonStep3D(
+							correspondences, gaussPdf->mean, metric, *geom1,
+							geom2, nThreads > 1 ? m_threadPool.get() : nullptr,
+							newPose))
+						gaussPdf->mean = newPose;
+				}
+				else
+				{
+					// Compute the estimated pose, using Horn's method.
+					// ------------------------------------------------------
+					mrpt::poses::CPose3DQuat estPoseQuat;
+					double transf_scale;
+					mrpt::tfest::se3_l2(
+						correspondences, estPoseQuat, transf_scale,
+						false /* dont force unit scale */);
+					gaussPdf->mean = mrpt::poses::CPose3D(estPoseQuat);
+				}
 
 				// If matching has not changed, decrease the thresholds:
 				// --------------------------------------------------------
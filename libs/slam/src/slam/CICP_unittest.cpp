@@ -8,6 +8,7 @@
    +------------------------------------------------------------------------+ */
 
 #include <gtest/gtest.h>
+#include <mrpt/config.h>
 #include <mrpt/maps/CSimplePointsMap.h>
 #include <mrpt/obs/stock_observations.h>
 #include <mrpt/opengl/CAngularObservationMesh.h>
@@ -37,7 +38,8 @@ class ICPTests : public ::testing::Test
    protected:
 	void SetUp() override {}
 	void TearDown() override {}
-	void align2scans(const TICPAlgorithm icp_method)
+	void align2scans(
+		const TICPAlgorithm icp_method, const unsigned int numThreads = 1)
 	{
 		CSimplePointsMap m1, m2;
 		CICP::TReturnInfo info;
@@ -63,6 +65,7 @@ class ICPTests : public ::testing::Test
 		ICP.options.ALFA = 0.5f;
 		ICP.options.smallestThresholdDist = 0.05f;
 		ICP.options.doRANSAC = false;
+		ICP.options.numThreads = numThreads;
 		// ICP.options.dumpToConsole();
 		// -----------------------------------------------------
 		CPose2D initialPose(0.8f, 0.0f, (float)DEG2RAD(0.0f));
@@ -74,6 +77,56 @@ class ICPTests : public ::testing::Test
 		EXPECT_NEAR(good_pose.distanceTo(pdf->getMeanVal()), 0, 0.02);
 	}
 
+	/** Aligns two samplings (with different grids) of the corner of a room
+	 * and a box on its floor. */
+	static void align3DPlanes(
+		const TICP3DMetric metric, const unsigned int numThreads = 1)
+	{
+		const auto lmbSampleScene = [](CSimplePointsMap& m, float offset) {
+			const float step = 0.05f;
+			for (float a = offset; a < 4.0f; a += step)
+				for (float b = offset; b < 3.0f; b += step)
+				{
+					m.insertPoint(a, b, 0);	 // floor
+					m.insertPoint(a, 0, b);	 // wall
+					m.insertPoint(0, a, b);	 // wall
+				}
+			for (float a = offset; a < 1.0f; a += step)
+				for (float b = offset; b < 0.5f; b += step)
+				{
+					m.insertPoint(2 + a, 2, b);	 // box
+					m.insertPoint(3, 2 + a, b);
+					m.insertPoint(2 + a, 2 + b, 0.5f);
+				}
+		};
+
+		CSimplePointsMap M1, M2;
+		lmbSampleScene(M1, 0.0f);
+		lmbSampleScene(M2, 0.025f);
+
+		const CPose3D poseError(0.10, -0.05, 0.08, 3.0_deg, -2.0_deg, 2.0_deg);
+		M1.changeCoordinatesReference(poseError);
+
+		CICP icp;
+		icp.options.ICP3D_metric = metric;
+		icp.options.numThreads = numThreads;
+		icp.options.thresholdDist = 0.40;
+		icp.options.thresholdAng = 0;
+		icp.options.smallestThresholdDist = 0.05;
+
+		CICP::TReturnInfo info;
+		const CPose3DPDF::Ptr pdf = icp.Align3D(&M1, &M2, CPose3D(), info);
+		const CPose3D mean = pdf->getMeanVal();
+
+		const auto err = mean.asVectorVal() - poseError.asVectorVal();
+		EXPECT_NEAR(
+			0, err.array().abs().maxCoeff(),
+			metric == icp3dPointToPoint ? 0.02 : 0.005)
+			<< "ICP output: mean= " << mean << endl
+			<< "Real displacement: " << poseError << endl
+			<< "Iterations: " << info.nIterations << endl;
+	}
+
 	static void generateObjects(CSetOfObjects::Ptr& world)
 	{
 		CSphere::Ptr sph = std::make_shared<CSphere>(0.5);
@@ -103,6 +156,35 @@ TEST_F(ICPTests, AlignScans_icpLevenbergMarquardt)
 {
 	align2scans(icpLevenbergMarquardt);
 }
+TEST_F(ICPTests, AlignScans_icpMultiResolution)
+{
+	align2scans(icpMultiResolution);
+}
+#if !MRPT_IN_EMSCRIPTEN
+TEST_F(ICPTests, AlignScans_icpMultiResolution_MultiThread)
+{
+	align2scans(icpMultiResolution, 4);
+}
+#endif
+
+TEST_F(ICPTests, AlignPlanes3D_icp3dPointToPoint)
+{
+	align3DPlanes(icp3dPointToPoint);
+}
+TEST_F(ICPTests, AlignPlanes3D_icp3dPointToPlane)
+{
+	align3DPlanes(icp3dPointToPlane);
+}
+TEST_F(ICPTests, AlignPlanes3D_icp3dGeneralized)
+{
+	align3DPlanes(icp3dGeneralized);
+}
+#if !MRPT_IN_EMSCRIPTEN
+TEST_F(ICPTests, AlignPlanes3D_icp3dGeneralized_MultiThread)
+{
+	align3DPlanes(icp3dGeneralized, 4);
+}
+#endif
 
 TEST_F(ICPTests, RayTracingICP3D)
 {
@@ -10,6 +10,7 @@
 #include "slam-precomp.h"  // Precompiled headers
 //
 #include <mrpt/config/CConfigFilePrefixer.h>
+#include <mrpt/core/bits_math.h>
 #include <mrpt/graphs/CGraphPartitioner.h>
 #include <mrpt/maps/CMultiMetricMap.h>
 #include <mrpt/opengl/CGridPlaneXY.h>
@@ -24,6 +25,8 @@
 #include <mrpt/system/CTicTac.h>
 
 #include <Eigen/Dense>
+#include <algorithm>
+#include <numeric>
 
 using namespace mrpt::slam;
 using namespace mrpt::obs;
@@ -43,13 +46,6 @@ static double eval_similarity_metric_map_matching(
 	return kf1.metric_map->compute3DMatchingRatio(
 		kf2.metric_map.get(), relPose2wrt1, parent->options.mrp);
 }
-static double eval_similarity_observation_overlap(
-	const map_keyframe_t& kf1, const map_keyframe_t& kf2,
-	const mrpt::poses::CPose3D& relPose2wrt1)
-{
-	return observationsOverlap(
-		kf1.raw_observations, kf2.raw_observations, &relPose2wrt1);
-}
 
 CIncrementalMapPartitioner::TOptions::TOptions()
 {
@@ -74,6 +70,8 @@ void CIncrementalMapPartitioner::TOptions::loadFromConfigFile(
 		"minMahaDistForCorrespondence", double, mrp.maxMahaDistForCorr, source,
 		section);
 	MRPT_LOAD_CONFIG_VAR(maxKeyFrameDistanceToEval, uint64_t, source, section);
+	MRPT_LOAD_CONFIG_VAR(maxDistanceToEval, double, source, section);
+	MRPT_LOAD_CONFIG_VAR(incrementalPartitions, bool, source, section);
 
 	mrpt::config::CConfigFilePrefixer cfp(
 		source, section + std::string("."), "");
@@ -96,6 +94,11 @@ void CIncrementalMapPartitioner::TOptions::saveToConfigFile(
 	MRPT_SAVE_CONFIG_VAR_COMMENT(minimumNumberElementsEachCluster, "");
 	MRPT_SAVE_CONFIG_VAR_COMMENT(
 		maxKeyFrameDistanceToEval, "Max KF ID distance");
+	MRPT_SAVE_CONFIG_VAR_COMMENT(
+		maxDistanceToEval, "Max KF distance [m] to evaluate (0=no limit)");
+	MRPT_SAVE_CONFIG_VAR_COMMENT(
+		incrementalPartitions,
+		"Only re-partition the clusters affected by new KFs");
 	c.write(
 		s, "minDistForCorrespondence", mrp.maxDistForCorr,
 		mrpt::config::MRPT_SAVE_NAME_PADDING(),
@@ -116,6 +119,20 @@ void CIncrementalMapPartitioner::clear()
 	m_individualFrames.clear();	 // Free the map...
 	m_individualMaps.clear();
 	m_last_partition.clear();  // Delete last partitions
+	m_last_partition_is_valid = false;
+	m_framePositions.clear();
+	m_overlapCache.clear();
+}
+
+void CIncrementalMapPartitioner::rebuildFramePositions()
+{
+	m_framePositions.clear();
+	m_framePositions.reserve(m_individualFrames.size());
+	for (const auto& pair : m_individualFrames)
+	{
+		const auto p = pair.pose->getMeanVal();
+		m_framePositions.insertPoint(p.x(), p.y(), p.z());
+	}
 }
 
 uint32_t CIncrementalMapPartitioner::addMapFrame(
@@ -154,7 +171,7 @@ uint32_t CIncrementalMapPartitioner::addMapFrame(
 				&eval_similarity_metric_map_matching, this, _1, _2, _3);
 			break;
 		case smOBSERVATION_OVERLAP:
-			sim_func = &eval_similarity_observation_overlap;
+			// Evaluated in batch below.
 			break;
 		case smCUSTOM_FUNCTION: sim_func = m_sim_func; break;
 		default: THROW_EXCEPTION("Invalid value for `simil_method`");
@@ -174,34 +191,77 @@ uint32_t CIncrementalMapPartitioner::addMapFrame(
 		m_individualFrames.get(i, posePDF_i, map_i.raw_observations);
 		auto pose_i = posePDF_i->getMeanVal();
 
-		for (uint32_t j = 0; j < new_id; j++)
+		// Keyframes to evaluate: all of them, or only those nearby:
+		std::vector<uint32_t> candidates;
+		if (options.maxDistanceToEval > 0)
+		{
+			std::vector<std::pair<size_t, float>> nearby;
+			m_framePositions.kdTreeRadiusSearch3D(
+				pose_i.x(), pose_i.y(), pose_i.z(),
+				mrpt::square(options.maxDistanceToEval), nearby);
+			candidates.reserve(nearby.size());
+			for (const auto& idx_dist : nearby)
+				candidates.push_back(idx_dist.first);
+			std::sort(candidates.begin(), candidates.end());
+		}
+		else
+		{
+			candidates.resize(new_id);
+			std::iota(candidates.begin(), candidates.end(), 0);
+		}
+		m_framePositions.insertPoint(pose_i.x(), pose_i.y(), pose_i.z());
+
+		// Skip keyframes too far away in IDs:
+		std::vector<uint32_t> toEval;
+		std::vector<CSensoryFrame::Ptr> sfs;
+		std::vector<CPose3D> relPoses;
+		for (const uint32_t j : candidates)
 		{
 			const auto id_diff = new_id - j;
-			double s_sym;
 			if (id_diff > options.maxKeyFrameDistanceToEval)
 			{
 				// skip evaluation
-				s_sym = .0;
+				m_A(i, j) = m_A(j, i) = .0;
+				continue;
 			}
-			else
+			CPose3DPDF::Ptr posePDF_j;
+			CSensoryFrame::Ptr sf_j;
+			m_individualFrames.get(j, posePDF_j, sf_j);
+			toEval.push_back(j);
+			sfs.push_back(sf_j);
+			relPoses.push_back(posePDF_j->getMeanVal() - pose_i);
+		}
+
+		std::vector<double> s_sym(toEval.size());
+		if (options.simil_method == smOBSERVATION_OVERLAP)
+		{
+			// All KFs at once, in parallel, with the points of KF "i" shared
+			// by all of them and cached for the next calls:
+			auto overlapParams = m_overlapCache.params();
+			overlapParams.numThreads = options.mrp.numThreads;
+			m_overlapCache.setParams(overlapParams);
+
+			s_sym = observationsOverlapBatch(
+				m_overlapCache, *map_i.raw_observations, sfs, relPoses);
+		}
+		else
+		{
+			for (size_t k = 0; k < toEval.size(); k++)
 			{
 				// KF "j":
 				map_keyframe_t map_j;
-				CPose3DPDF::Ptr posePDF_j;
-				map_j.kf_id = j;
-				m_individualFrames.get(j, posePDF_j, map_j.raw_observations);
-				auto pose_j = posePDF_j->getMeanVal();
-				map_j.metric_map = m_individualMaps[j];
-
-				auto relPose = pose_j - pose_i;
+				map_j.kf_id = toEval[k];
+				map_j.raw_observations = sfs[k];
+				map_j.metric_map = m_individualMaps[toEval[k]];
 
 				// Evaluate similarity metric & make it symetric:
-				const auto s_ij = sim_func(map_i, map_j, relPose);
-				const auto s_ji = sim_func(map_j, map_i, relPose);
-				s_sym = 0.5 * (s_ij + s_ji);
+				const auto s_ij = sim_func(map_i, map_j, relPoses[k]);
+				const auto s_ji = sim_func(map_j, map_i, relPoses[k]);
+				s_sym[k] = 0.5 * (s_ij + s_ji);
 			}
-			m_A(i, j) = m_A(j, i) = s_sym;
-		}  // for j
+		}
+		for (size_t k = 0; k < toEval.size(); k++)
+			m_A(i, toEval[k]) = m_A(toEval[k], i) = s_sym[k];
 	}  // i=n-1=new_id
 
 	// Self-similatity: Not used
@@ -238,14 +298,75 @@ void CIncrementalMapPartitioner::updatePartitions(
 	MRPT_START
 
 	partitions.clear();
-	CGraphPartitioner<CMatrixD>::RecursiveSpectralPartition(
-		m_A, partitions, options.partitionThreshold, true, true,
-		!options.forceBisectionOnly, options.minimumNumberElementsEachCluster,
-		false /* verbose */
-	);
+	if (!options.incrementalPartitions || !m_last_partition_is_valid)
+	{
+		CGraphPartitioner<CMatrixD>::RecursiveSpectralPartition(
+			m_A, partitions, options.partitionThreshold, true, true,
+			!options.forceBisectionOnly,
+			options.minimumNumberElementsEachCluster, false /* verbose */
+		);
+	}
+	else if (!m_last_last_partition_are_new_ones)
+	{
+		// Nothing changed since the last call:
+		partitions = m_last_partition;
+	}
+	else
+	{
+		// Affected clusters: the "new_ones" partition, and those with any
+		// keyframe related to the new ones.
+		const size_t n = m_A.cols();
+		const size_t nClusters = m_last_partition.size();
+		std::vector<size_t> clusterOf(n);
+		for (size_t c = 0; c < nClusters; c++)
+			for (const auto idx : m_last_partition[c])
+				clusterOf[idx] = c;
+
+		std::vector<bool> affected(nClusters, false);
+		affected.back() = true;
+		for (const auto i : m_last_partition.back())
+			for (size_t j = 0; j < n; j++)
+				if (m_A(i, j) != 0) affected[clusterOf[j]] = true;
+
+		std::vector<uint32_t> subNodes;
+		for (size_t c = 0; c < nClusters; c++)
+		{
+			if (affected[c])
+				subNodes.insert(
+					subNodes.end(), m_last_partition[c].begin(),
+					m_last_partition[c].end());
+			else
+				partitions.push_back(m_last_partition[c]);
+		}
+		std::sort(subNodes.begin(), subNodes.end());
+
+		// Re-partition the affected subgraph only:
+		const size_t nSub = subNodes.size();
+		CMatrixD subA(nSub, nSub);
+		for (size_t i = 0; i < nSub; i++)
+			for (size_t j = 0; j < nSub; j++)
+				subA(i, j) = m_A(subNodes[i], subNodes[j]);
+
+		std::vector<std::vector<uint32_t>> subParts;
+		CGraphPartitioner<CMatrixD>::RecursiveSpectralPartition(
+			subA, subParts, options.partitionThreshold, true, true,
+			!options.forceBisectionOnly,
+			options.minimumNumberElementsEachCluster, false /* verbose */
+		);
+		for (auto& part : subParts)
+		{
+			for (auto& idx : part)
+				idx = subNodes[idx];
+			partitions.emplace_back(std::move(part));
+		}
+		std::sort(
+			partitions.begin(), partitions.end(),
+			[](const auto& a, const auto& b) { return a.front() < b.front(); });
+	}
 
 	m_last_partition = partitions;
 	m_last_last_partition_are_new_ones = false;
+	m_last_partition_is_valid = true;
 
 	MRPT_END
 }
@@ -303,6 +424,7 @@ void CIncrementalMapPartitioner::removeSetOfNodes(
 		m_last_partition[0][i] = i;
 
 	m_last_last_partition_are_new_ones = false;
+	m_last_partition_is_valid = false;
 
 	// The new sequence of maps:
 	// --------------------------------------------------
@@ -330,6 +452,7 @@ void CIncrementalMapPartitioner::removeSetOfNodes(
 		posePDF->getMean(p);
 		m_individualFrames.changeCoordinatesOrigin(p);
 	}
+	rebuildFramePositions();
 
 	// All done!
 	MRPT_END
@@ -339,6 +462,7 @@ void CIncrementalMapPartitioner::changeCoordinatesOrigin(
 	const CPose3D& newOrigin)
 {
 	m_individualFrames.changeCoordinatesOrigin(newOrigin);
+	rebuildFramePositions();
 }
 
 void CIncrementalMapPartitioner::changeCoordinatesOriginPoseIndex(
@@ -448,6 +572,8 @@ void CIncrementalMapPartitioner::serializeFrom(
 				std::vector<uint8_t> old_modified_nodes;
 				in >> old_modified_nodes;
 			}
+			m_last_partition_is_valid = false;
+			rebuildFramePositions();
 		}
 		break;
 		default: MRPT_THROW_UNKNOWN_SERIALIZATION_VERSION(version);
@@ -55,3 +55,110 @@ TEST(CIncrementalMapPartitioner, test_dataset)
 	EXPECT_EQ(parts[0], expected_p0);
 	EXPECT_EQ(parts[1], expected_p1);
 }
+
+TEST(CIncrementalMapPartitioner, incremental_and_nearby)
+{
+	const std::string map_file = mrpt::UNITTEST_BASEDIR +
+		std::string("/share/mrpt/datasets/malaga-cs-fac-building.simplemap.gz");
+	ASSERT_FILE_EXISTS_(map_file);
+
+	mrpt::maps::CSimpleMap in_map;
+	in_map.loadFromFile(map_file);
+
+	mrpt::slam::CIncrementalMapPartitioner imp_full, imp_near, imp_incr;
+	for (auto* imp : {&imp_full, &imp_near, &imp_incr})
+	{
+		imp->options.partitionThreshold = 0.5;
+		imp->options.mrp.maxDistForCorr = 0.2f;
+		imp->options.mrp.maxMahaDistForCorr = 10.0f;
+	}
+	// A radius large enough to include all keyframes:
+	imp_near.options.maxDistanceToEval = 1e4;
+	imp_incr.options.maxDistanceToEval = 5.0;
+	imp_incr.options.incrementalPartitions = true;
+
+	std::vector<std::vector<uint32_t>> parts;
+	size_t count = 0;
+	for (const auto& pair : in_map)
+	{
+		const auto& [posePDF, sf] = pair;
+		for (auto* imp : {&imp_full, &imp_near, &imp_incr})
+			imp->addMapFrame(*sf, *posePDF);
+		if (++count % 10 == 0) imp_incr.updatePartitions(parts);
+	}
+	imp_incr.updatePartitions(parts);
+
+	// Same similarities if all keyframes are within the KD-tree radius:
+	const auto& A_full = imp_full.getAdjacencyMatrix();
+	const auto& A_near = imp_near.getAdjacencyMatrix();
+	ASSERT_EQ(A_full.rows(), A_near.rows());
+	for (int i = 0; i < A_full.rows(); i++)
+		for (int j = 0; j < A_full.cols(); j++)
+			EXPECT_EQ(A_full(i, j), A_near(i, j));
+
+	// Keyframes farther than the radius are not related:
+	const auto& A = imp_incr.getAdjacencyMatrix();
+	const auto& frames = *imp_incr.getSequenceOfFrames();
+	for (size_t i = 0; i < frames.size(); i++)
+	{
+		for (size_t j = 0; j < frames.size(); j++)
+		{
+			const auto pi = frames.getAsPair(i).pose->getMeanVal();
+			const auto pj = frames.getAsPair(j).pose->getMeanVal();
+			const double d = (pi.translation() - pj.translation()).norm();
+			EXPECT_TRUE(d < 5.01 || A(i, j) == 0);
+		}
+	}
+
+	// Incremental partitions must cover all keyframes, once:
+	std::vector<int> seen(count, 0);
+	for (const auto& p : parts)
+	{
+		EXPECT_FALSE(p.empty());
+		for (const auto idx : p)
+		{
+			ASSERT_LT(idx, count);
+			seen[idx]++;
+		}
+	}
+	for (const auto s : seen)
+		EXPECT_EQ(s, 1);
+	EXPECT_GE(parts.size(), 2UL);
+}
+
+TEST(CIncrementalMapPartitioner, observation_overlap_parallel)
+{
+	const std::string map_file = mrpt::UNITTEST_BASEDIR +
+		std::string("/share/mrpt/datasets/malaga-cs-fac-building.simplemap.gz");
+	ASSERT_FILE_EXISTS_(map_file);
+
+	mrpt::maps::CSimpleMap in_map;
+	in_map.loadFromFile(map_file);
+
+	mrpt::slam::CIncrementalMapPartitioner imp1, imp4;
+	for (auto* imp : {&imp1, &imp4})
+	{
+		imp->options.partitionThreshold = 0.5;
+		imp->options.simil_method = mrpt::slam::smOBSERVATION_OVERLAP;
+	}
+	imp4.options.mrp.numThreads = 4;
+
+	for (const auto& pair : in_map)
+	{
+		const auto& [posePDF, sf] = pair;
+		for (auto* imp : {&imp1, &imp4})
+			imp->addMapFrame(*sf, *posePDF);
+	}
+
+	const auto& A1 = imp1.getAdjacencyMatrix();
+	const auto& A4 = imp4.getAdjacencyMatrix();
+	ASSERT_EQ(A1.rows(), A4.rows());
+	// Consecutive keyframes overlap:
+	EXPECT_GT(A1(0, 1), 0.1);
+	for (int i = 0; i < A1.rows(); i++)
+		for (int j = 0; j < A1.cols(); j++)
+		{
+			EXPECT_EQ(A1(i, j), A4(i, j));
+			EXPECT_EQ(A1(i, j), A1(j, i));
+		}
+}
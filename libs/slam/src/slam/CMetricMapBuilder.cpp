@@ -64,10 +64,9 @@ void CMetricMapBuilder::loadCurrentMapFromFile(const std::string& fileName)
 			"[CMetricMapBuilder::loadCurrentMapFromFile] Loading current map "
 			"from '"
 			<< fileName << "' ..." << std::endl);
-		CFileGZInputStream f(fileName);
-
-		// Load from file:
-		archiveFrom(f) >> map;
+		// Load from file (possibly with externally stored frames):
+		if (!map.loadFromFile(fileName))
+			THROW_EXCEPTION_FMT("Error loading map from '%s'", fileName.c_str());
 	}
 	else
 	{  // Is a new file, start with an empty map:
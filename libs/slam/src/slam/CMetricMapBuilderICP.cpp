@@ -20,6 +20,7 @@
 #include <mrpt/slam/CICP.h>
 #include <mrpt/slam/CMetricMapBuilderICP.h>
 #include <mrpt/system/CTicTac.h>
+#include <mrpt/system/thread_name.h>
 
 using namespace std;
 using namespace mrpt::slam;
@@ -46,6 +47,9 @@ CMetricMapBuilderICP::~CMetricMapBuilderICP()
 	enterCriticalSection();
 	leaveCriticalSection();
 
+	// Insert pending keyframes, if asyncMapUpdate:
+	stopMappingThread();
+
 	// Save current map to current file:
 	setCurrentMapFile("");
 }
@@ -76,6 +80,9 @@ CMetricMapBuilderICP::TConfigParams&
 	localizationLinDistance = other.localizationLinDistance;
 	localizationAngDistance = other.localizationAngDistance;
 	minICPgoodnessToAccept = other.minICPgoodnessToAccept;
+	voxelFilterSize = other.voxelFilterSize;
+	voxelFilterMethod = other.voxelFilterMethod;
+	asyncMapUpdate = other.asyncMapUpdate;
 	//	We can't copy a reference type
 	//	verbosity_level         = other.verbosity_level;
 	mapInitializers = other.mapInitializers;
@@ -94,6 +101,9 @@ void CMetricMapBuilderICP::TConfigParams::loadFromConfigFile(
 		section, "verbosity_level", verbosity_level);
 
 	MRPT_LOAD_CONFIG_VAR(minICPgoodnessToAccept, double, source, section)
+	MRPT_LOAD_CONFIG_VAR(voxelFilterSize, double, source, section)
+	MRPT_LOAD_CONFIG_VAR(voxelFilterMethod, enum, source, section)
+	MRPT_LOAD_CONFIG_VAR(asyncMapUpdate, bool, source, section)
 
 	mapInitializers.loadFromConfigFile(source, section);
 }
@@ -116,6 +126,17 @@ void CMetricMapBuilderICP::TConfigParams::dumpToTextStream(
 	out << mrpt::format(
 		"localizationAngDistance                 = %f deg\n",
 		RAD2DEG(localizationAngDistance));
+	out << mrpt::format(
+		"voxelFilterSize                         = %f m\n", voxelFilterSize);
+	out << mrpt::format(
+		"voxelFilterMethod                       = %s\n",
+		mrpt::typemeta::TEnumType<
+			mrpt::maps::CPointCloudFilterByVoxelGrid::TVoxelGridMethod>::
+			value2name(voxelFilterMethod)
+				.c_str());
+	out << mrpt::format(
+		"asyncMapUpdate                          = %s\n",
+		asyncMapUpdate ? "YES" : "NO");
 	out << mrpt::format(
 		"verbosity_level                         = %s\n",
 		mrpt::typemeta::TEnumType<mrpt::system::VerbosityLevel>::value2name(
@@ -138,8 +159,20 @@ void CMetricMapBuilderICP::processObservation(const CObservation::Ptr& obs)
 
 	MRPT_START
 
-	if (metricMap.countMapsByClass<mrpt::maps::CPointsMap>() == 0 &&
-		metricMap.countMapsByClass<mrpt::maps::COccupancyGridMap2D>() == 0)
+	// The map to localize against:
+	const bool async = ICP_options.asyncMapUpdate;
+	if (async)
+		updateMapSnapshot();
+	else if (m_mapSnapshot)
+	{
+		stopMappingThread();
+		m_mapSnapshot.reset();
+		m_updatedSnapshot.reset();
+	}
+	CMultiMetricMap& localMap = async ? *m_mapSnapshot : metricMap;
+
+	if (localMap.countMapsByClass<mrpt::maps::CPointsMap>() == 0 &&
+		localMap.countMapsByClass<mrpt::maps::COccupancyGridMap2D>() == 0)
 		throw std::runtime_error(
 			"Neither grid maps nor points map: Have you called initialize() "
 			"after setting ICP_options.mapInitializers?");
@@ -240,7 +273,7 @@ void CMetricMapBuilderICP::processObservation(const CObservation::Ptr& obs)
 
 		// Select the map to match with ....
 		CMetricMap* matchWith = nullptr;
-		if (auto pGrid = metricMap.mapByClass<COccupancyGridMap2D>();
+		if (auto pGrid = localMap.mapByClass<COccupancyGridMap2D>();
 			ICP_options.matchAgainstTheGrid && pGrid)
 		{
 			matchWith = static_cast<CMetricMap*>(pGrid.get());
@@ -248,7 +281,7 @@ void CMetricMapBuilderICP::processObservation(const CObservation::Ptr& obs)
 		}
 		else
 		{
-			auto pPts = metricMap.mapByClass<CPointsMap>();
+			auto pPts = localMap.mapByClass<CPointsMap>();
 			ASSERTMSG_(pPts, "No points map in multi-metric map.");
 
 			matchWith = static_cast<CMetricMap*>(pPts.get());
@@ -269,13 +302,17 @@ void CMetricMapBuilderICP::processObservation(const CObservation::Ptr& obs)
 			CSimplePointsMap sensedPoints;
 			sensedPoints.insertionOptions.minDistBetweenLaserPoints = 0.02f;
 			sensedPoints.insertionOptions.also_interpolate = false;
+			sensedPoints.insertionOptions.voxelFilterSize =
+				static_cast<float>(ICP_options.voxelFilterSize);
+			sensedPoints.insertionOptions.voxelFilterMethod =
+				ICP_options.voxelFilterMethod;
 
 			// Create points representation of the observation:
 			// Insert only those planar range scans in the altitude of
 			// the grid map:
 			if (ICP_options.matchAgainstTheGrid &&
-				0 != metricMap.countMapsByClass<COccupancyGridMap2D>() &&
-				metricMap.mapByClass<COccupancyGridMap2D>(0)
+				0 != localMap.countMapsByClass<COccupancyGridMap2D>() &&
+				localMap.mapByClass<COccupancyGridMap2D>(0)
 					->insertionOptions.useMapAltitude)
 			{
 				// Use grid altitude:
@@ -284,7 +321,7 @@ void CMetricMapBuilderICP::processObservation(const CObservation::Ptr& obs)
 					CObservation2DRangeScan::Ptr obsLaser =
 						std::dynamic_pointer_cast<CObservation2DRangeScan>(obs);
 					if (std::abs(
-							metricMap.mapByClass<COccupancyGridMap2D>(0)
+							localMap.mapByClass<COccupancyGridMap2D>(0)
 								->insertionOptions.mapAltitude -
 							obsLaser->sensorPose.z()) < 0.01)
 						can_do_icp = sensedPoints.insertObservationPtr(obs);
@@ -392,8 +429,13 @@ void CMetricMapBuilderICP::processObservation(const CObservation::Ptr& obs)
 		// beginning until the first one
 		//  that actually insert some points into the map used as a
 		//  reference, since otherwise we'll not be able to do ICP
-		//  against an empty map!!
-		if (matchWith && matchWith->isEmpty()) update = true;
+		//  against an empty map!! (With asyncMapUpdate, the map snapshot
+		//  remains empty until the mapping thread inserts them)
+		if (matchWith && matchWith->isEmpty())
+		{
+			auto lckKF = mrpt::lockHelper(m_keyframesMtx);
+			if (!async || m_keyframesPending == 0) update = true;
+		}
 
 		MRPT_LOG_DEBUG_STREAM(
 			"update map: " << (update ? "YES" : "NO")
@@ -422,29 +464,35 @@ void CMetricMapBuilderICP::processObservation(const CObservation::Ptr& obs)
 				"Updating map from pose %s\n",
 				currentKnownRobotPose.asString().c_str()));
 
-			CPose3D estimatedPose3D(currentKnownRobotPose);
-			const bool anymap_update =
-				metricMap.insertObservationPtr(obs, estimatedPose3D);
-			if (!anymap_update)
-				MRPT_LOG_WARN_STREAM(
-					"**No map was updated** after inserting an "
-					"observation of "
-					"type `"
-					<< obs->GetRuntimeClass()->className << "`");
-
-			// Add to the vector of "poses"-"SFs" pairs:
-			CPosePDFGaussian posePDF(currentKnownRobotPose);
-			CPose3DPDF::Ptr pose3D =
-				CPose3DPDF::Ptr(CPose3DPDF::createFrom2D(posePDF));
-
-			CSensoryFrame::Ptr sf = std::make_shared<CSensoryFrame>();
-			sf->insert(obs);
-
-			SF_Poses_seq.insert(pose3D, sf);
+			if (async)
+			{
+				// Leave it to the mapping thread:
+				{
+					auto lckKF = mrpt::lockHelper(m_keyframesMtx);
+					m_keyframes.push_back({obs, currentKnownRobotPose});
+					m_keyframesPending++;
+					if (!m_mappingThread.joinable())
+					{
+						m_mappingThreadExit = false;
+						m_mappingThread = std::thread(
+							&CMetricMapBuilderICP::mappingThreadMain, this);
+						mrpt::system::thread_name(
+							"ICPmapping", m_mappingThread);
+					}
+				}
+				m_keyframesCv.notify_all();
+			}
+			else
+			{
+				auto lckMap = mrpt::lockHelper(m_mapMtx);
+				insertKeyframe(obs, currentKnownRobotPose);
+			}
 
-			MRPT_LOG_INFO_STREAM(
-				"Map updated OK. Done in "
-				<< mrpt::system::formatTimeInterval(tictac.Tac()) << std::endl);
+			if (!async)
+				MRPT_LOG_INFO_STREAM(
+					"Map updated OK. Done in "
+					<< mrpt::system::formatTimeInterval(tictac.Tac())
+					<< std::endl);
 		}
 
 	}  // end other observation
@@ -459,6 +507,135 @@ void CMetricMapBuilderICP::processObservation(const CObservation::Ptr& obs)
 
 }  // end processObservation
 
+void CMetricMapBuilderICP::insertKeyframe(
+	const CObservation::Ptr& obs, const CPose2D& pose)
+{
+	CPose3D estimatedPose3D(pose);
+	const bool anymap_update =
+		metricMap.insertObservationPtr(obs, estimatedPose3D);
+	if (!anymap_update)
+		MRPT_LOG_WARN_STREAM(
+			"**No map was updated** after inserting an "
+			"observation of "
+			"type `"
+			<< obs->GetRuntimeClass()->className << "`");
+
+	// Add to the vector of "poses"-"SFs" pairs:
+	CPosePDFGaussian posePDF(pose);
+	CPose3DPDF::Ptr pose3D = CPose3DPDF::Ptr(CPose3DPDF::createFrom2D(posePDF));
+
+	CSensoryFrame::Ptr sf = std::make_shared<CSensoryFrame>();
+	sf->insert(obs);
+
+	SF_Poses_seq.insert(pose3D, sf);
+}
+
+namespace
+{
+/** Builds the KD-tree used by ICP beforehand, so the map can be read from
+ * several threads afterwards without modifying it */
+void prepareForLocalization(const CMultiMetricMap& m)
+{
+	auto pts = m.mapByClass<CPointsMap>();
+	if (pts && !pts->empty()) pts->kdTreeClosestPoint2DsqrError(0, 0);
+}
+}  // namespace
+
+void CMetricMapBuilderICP::updateMapSnapshot()
+{
+	{
+		auto lckKF = mrpt::lockHelper(m_keyframesMtx);
+		if (m_mappingError)
+		{
+			auto e = m_mappingError;
+			m_mappingError = nullptr;
+			std::rethrow_exception(e);
+		}
+		if (m_updatedSnapshot) m_mapSnapshot = std::move(m_updatedSnapshot);
+	}
+	if (m_mapSnapshot) return;
+
+	// Copies share the internal maps with metricMap, which clones them
+	// before inserting them new observations:
+	auto lckMap = mrpt::lockHelper(m_mapMtx);
+	metricMap.copyOnWrite = true;
+	m_mapSnapshot = std::make_shared<CMultiMetricMap>(metricMap);
+	prepareForLocalization(*m_mapSnapshot);
+}
+
+void CMetricMapBuilderICP::mappingThreadMain()
+{
+	for (;;)
+	{
+		std::deque<TKeyframe> keyframes;
+		{
+			std::unique_lock<std::mutex> lckKF(m_keyframesMtx);
+			m_keyframesCv.wait(lckKF, [this]() {
+				return !m_keyframes.empty() || m_mappingThreadExit;
+			});
+			if (m_keyframes.empty()) return;
+			keyframes.swap(m_keyframes);
+		}
+
+		CTicTac tictac;
+		std::shared_ptr<CMultiMetricMap> snapshot;
+		std::exception_ptr err;
+		try
+		{
+			{
+				auto lckMap = mrpt::lockHelper(m_mapMtx);
+				for (const auto& kf : keyframes)
+					insertKeyframe(kf.obs, kf.pose);
+				snapshot = std::make_shared<CMultiMetricMap>(metricMap);
+			}
+			// The maps are shared with metricMap, but they will not be
+			// modified through it, since it will clone them first:
+			prepareForLocalization(*snapshot);
+		}
+		catch (...)
+		{
+			err = std::current_exception();
+		}
+
+		{
+			auto lckKF = mrpt::lockHelper(m_keyframesMtx);
+			if (snapshot) m_updatedSnapshot = std::move(snapshot);
+			if (err) m_mappingError = err;
+			m_keyframesPending -= keyframes.size();
+		}
+		m_keyframesCv.notify_all();
+
+		if (!err)
+			MRPT_LOG_INFO_STREAM(
+				"Map updated OK with " << keyframes.size()
+									   << " keyframe(s). Done in "
+									   << mrpt::system::formatTimeInterval(
+											  tictac.Tac()));
+	}
+}
+
+void CMetricMapBuilderICP::stopMappingThread()
+{
+	if (!m_mappingThread.joinable()) return;
+	{
+		auto lckKF = mrpt::lockHelper(m_keyframesMtx);
+		m_mappingThreadExit = true;
+	}
+	m_keyframesCv.notify_all();
+	m_mappingThread.join();
+}
+
+void CMetricMapBuilderICP::waitForMapUpdates()
+{
+	if (!m_mappingThread.joinable()) return;
+	{
+		std::unique_lock<std::mutex> lckKF(m_keyframesMtx);
+		m_keyframesCv.wait(
+			lckKF, [this]() { return m_keyframesPending == 0; });
+	}
+	updateMapSnapshot();
+}
+
 /*---------------------------------------------------------------
 
 						processActionObservation
@@ -533,8 +710,14 @@ void CMetricMapBuilderICP::initialize(
 
 	m_there_has_been_an_odometry = false;
 
+	stopMappingThread();
+	m_mapSnapshot.reset();
+	m_updatedSnapshot.reset();
+	m_mappingError = nullptr;
+
 	// Init path & map:
 	auto lck = mrpt::lockHelper(critZoneChangingMap);
+	auto lckMap = mrpt::lockHelper(m_mapMtx);
 
 	// Create metric maps:
 	metricMap.setListOfMaps(ICP_options.mapInitializers);
@@ -571,6 +754,7 @@ void CMetricMapBuilderICP::getCurrentMapPoints(
 	std::vector<float>& x, std::vector<float>& y)
 {
 	auto lck = mrpt::lockHelper(critZoneChangingMap);
+	auto lckMap = mrpt::lockHelper(m_mapMtx);
 
 	auto pPts = metricMap.mapByClass<CPointsMap>(0);
 
@@ -583,11 +767,13 @@ void CMetricMapBuilderICP::getCurrentMapPoints(
   ---------------------------------------------------------------*/
 void CMetricMapBuilderICP::getCurrentlyBuiltMap(CSimpleMap& out_map) const
 {
+	auto lckMap = mrpt::lockHelper(m_mapMtx);
 	out_map = SF_Poses_seq;
 }
 
 const CMultiMetricMap* CMetricMapBuilderICP::getCurrentlyBuiltMetricMap() const
 {
+	if (m_mapSnapshot) return m_mapSnapshot.get();
 	return &metricMap;
 }
 
@@ -596,6 +782,7 @@ const CMultiMetricMap* CMetricMapBuilderICP::getCurrentlyBuiltMetricMap() const
   ---------------------------------------------------------------*/
 unsigned int CMetricMapBuilderICP::getCurrentlyBuiltMapSize()
 {
+	auto lckMap = mrpt::lockHelper(m_mapMtx);
 	return SF_Poses_seq.size();
 }
 
@@ -612,6 +799,8 @@ void CMetricMapBuilderICP::saveCurrentEstimationToImage(
 
 	if (!formatEMF_BMP) THROW_EXCEPTION("Not implemented yet for BMP!");
 
+	auto lckMap = mrpt::lockHelper(m_mapMtx);
+
 	// grid map as bitmap:
 	auto pGrid = metricMap.mapByClass<COccupancyGridMap2D>();
 	if (pGrid) pGrid->getAsImage(img);
@@ -8,6 +8,7 @@
    +------------------------------------------------------------------------+ */
 
 #include <gtest/gtest.h>
+#include <mrpt/config.h>
 #include <mrpt/config/CConfigFile.h>
 #include <mrpt/io/CFileGZInputStream.h>
 #include <mrpt/maps/CMultiMetricMap.h>
@@ -34,7 +35,8 @@ using namespace mrpt::system;
 using namespace mrpt::obs;
 using namespace std;
 
-void run_test_pf_localization(CPose2D& meanPose, CMatrixDouble33& cov)
+void run_test_pf_localization(
+	CPose2D& meanPose, CMatrixDouble33& cov, unsigned int numThreads = 1)
 {
 	// ------------------------------------------------------
 	// The code below is a simplification of the program "pf-localization"
@@ -79,6 +81,7 @@ void run_test_pf_localization(CPose2D& meanPose, CMatrixDouble33& cov)
 	// ---------------------------
 	CParticleFilter::TParticleFilterOptions pfOptions;
 	pfOptions.loadFromConfigFile(iniFile, "PF_options");
+	pfOptions.numThreads = numThreads;
 
 	// PDF Options:
 	// ------------------
@@ -259,8 +262,7 @@ void run_test_pf_localization(CPose2D& meanPose, CMatrixDouble33& cov)
 	}  // end of loop for different # of particles
 }
 
-// TEST =================
-TEST(MonteCarlo2D, RunSampleDataset)
+void run_test_pf_localization_and_check(unsigned int numThreads)
 {
 	try
 	{
@@ -276,7 +278,7 @@ TEST(MonteCarlo2D, RunSampleDataset)
 		// even twice in an extreme bad luck:
 		for (int op = 0; op < 3; op++)
 		{
-			run_test_pf_localization(meanPose, cov);
+			run_test_pf_localization(meanPose, cov, numThreads);
 
 			const double final_pf_cov_trace = cov.trace();
 			const CPose2D final_pf_pose = meanPose;
@@ -299,3 +301,13 @@ TEST(MonteCarlo2D, RunSampleDataset)
 		FAIL() << mrpt::exception_to_str(e);
 	}
 }
+
+// TEST =================
+TEST(MonteCarlo2D, RunSampleDataset) { run_test_pf_localization_and_check(1); }
+
+#if !MRPT_IN_EMSCRIPTEN	 // No multithreading
+TEST(MonteCarlo2D, RunSampleDatasetMultiThread)
+{
+	run_test_pf_localization_and_check(4);
+}
+#endif
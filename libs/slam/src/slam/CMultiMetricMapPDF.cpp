@@ -53,6 +53,8 @@ CMultiMetricMapPDF::CMultiMetricMapPDF(
 	{
 		m_particle.log_w = 0;
 		m_particle.d.reset(new CRBPFParticleData(mapsInitializers));
+		m_particle.d->mapTillNow.copyOnWrite =
+			predictionOptions.copyOnWriteMaps;
 	}
 
 	// Initialize:
@@ -82,6 +84,7 @@ void CMultiMetricMapPDF::clear(const CPose3D& initialPose)
 	{
 		m_particles[i].log_w = 0;
 
+		m_particles[i].d->mapTillNow.copyOnWrite = options.copyOnWriteMaps;
 		m_particles[i].d->mapTillNow.clear();
 
 		m_particles[i].d->robotPath.resize(1);
@@ -110,6 +113,7 @@ void CMultiMetricMapPDF::clear(
 		auto& p = m_particles[idxPart];
 		p.log_w = 0;
 
+		p.d->mapTillNow.copyOnWrite = options.copyOnWriteMaps;
 		p.d->mapTillNow.clear();
 
 		p.d->robotPath.resize(nOldKeyframes);
@@ -600,6 +604,9 @@ void CMultiMetricMapPDF::TPredictionParams::dumpToTextStream(
 	out << mrpt::format(
 		"ICPGlobalAlign_MinQuality               = %f\n",
 		ICPGlobalAlign_MinQuality);
+	out << mrpt::format(
+		"copyOnWriteMaps                         = %s\n",
+		copyOnWriteMaps ? "true" : "false");
 
 	KLD_params.dumpToTextStream(out);
 	icp_params.dumpToTextStream(out);
@@ -617,6 +624,7 @@ void CMultiMetricMapPDF::TPredictionParams::loadFromConfigFile(
 		pfOptimalProposal_mapSelection, true);
 
 	MRPT_LOAD_CONFIG_VAR(ICPGlobalAlign_MinQuality, float, iniFile, section);
+	MRPT_LOAD_CONFIG_VAR(copyOnWriteMaps, bool, iniFile, section);
 
 	KLD_params.loadFromConfigFile(iniFile, section);
 	icp_params.loadFromConfigFile(iniFile, section);
@@ -26,6 +26,8 @@
 #include <mrpt/slam/PF_aux_structs.h>
 #include <mrpt/system/CTicTac.h>
 
+#include <set>
+
 using namespace mrpt;
 using namespace mrpt::bayes;
 using namespace mrpt::math;
@@ -282,7 +284,7 @@ void CMultiMetricMapPDF::prediction_and_update_pfOptimalProposal(
 			CPosePDFGaussian icpEstimation;
 
 			// Configure the matchings that will take place in the ICP process:
-			auto partMap = partIt->d->mapTillNow;
+			const auto& partMap = partIt->d->mapTillNow;
 			const auto numPtMaps = partMap.countMapsByClass<CSimplePointsMap>();
 
 			ASSERT_(numPtMaps == 0 || numPtMaps == 1);
@@ -395,6 +397,8 @@ void CMultiMetricMapPDF::prediction_and_update_pfOptimalProposal(
 			//     Perform optimal sampling with the beacon map:
 			//  Described in paper: IROS 2008
 			// --------------------------------------------------------
+			// (The beacon map may be modified below)
+			partIt->d->mapTillNow.detachSharedMaps();
 			auto beacMap = partIt->d->mapTillNow.mapByClass<CBeaconMap>();
 
 			// We'll also update the weight of the particle here
@@ -934,6 +938,20 @@ bool CMultiMetricMapPDF::PF_SLAM_implementation_skipRobotMovement() const
 	return 0 == getNumberOfObservationsInSimplemap();
 }
 
+void CMultiMetricMapPDF::PF_SLAM_particlesToEvaluateFirst(
+	std::vector<size_t>& indices) const
+{
+	indices.assign(1, 0);
+	std::set<const CMetricMap*> seen;
+	for (size_t i = 0; i < m_particles.size(); i++)
+	{
+		bool first = false;
+		for (const auto& m : m_particles[i].d->mapTillNow.maps)
+			if (m.use_count() > 1 && seen.insert(m.get()).second) first = true;
+		if (first && i != 0) indices.push_back(i);
+	}
+}
+
 /*---------------------------------------------------------------
  Evaluate the observation likelihood for one
    particle at a given location
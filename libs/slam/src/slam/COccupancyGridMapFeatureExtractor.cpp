@@ -83,33 +83,82 @@ void COccupancyGridMapFeatureExtractor::extractFeatures(
 	const mrpt::vision::TDescriptorType descriptors,
 	const mrpt::vision::CFeatureExtraction::TOptions& feat_options)
 {
-#if 0
-	// Un-cashed version:
-	uncached_extractFeatures(grid,outMap,number_of_features,descriptors,feat_options);
-#else
-	// Use cache mechanism:
+	const uint64_t version = grid.getMapVersion();
 
+	// Already in the cache?
+	{
+		std::lock_guard<std::mutex> lck(m_cache_mtx);
+		auto it = m_cache.find(&grid);
+		if (it != m_cache.end() && it->second.mapVersion == version &&
+			it->second.number_of_features == number_of_features &&
+			it->second.descriptors == descriptors)
+		{
+			m_lru.splice(m_lru.begin(), m_lru, it->second.lru);
+			outMap = *it->second.landmarks;
+			return;
+		}
+	}
+
+	// We have to recompute the features (without holding the lock, so other
+	// grids can be processed in parallel):
+	CLandmarksMap::Ptr theMap = std::make_shared<CLandmarksMap>();
+	uncached_extractFeatures(
+		grid, *theMap, number_of_features, descriptors, feat_options);
+	outMap = *theMap;
+
+	// Insert into the cache:
+	std::lock_guard<std::mutex> lck(m_cache_mtx);
 	auto it = m_cache.find(&grid);
 	if (it == m_cache.end())
 	{
-		// We have to recompute the features:
-		CLandmarksMap::Ptr theMap = std::make_shared<CLandmarksMap>();
+		m_lru.push_front(&grid);
+		it = m_cache.emplace(&grid, TCacheEntry()).first;
+		it->second.lru = m_lru.begin();
+	}
+	else
+		m_lru.splice(m_lru.begin(), m_lru, it->second.lru);
 
-		uncached_extractFeatures(
-			grid, *theMap, number_of_features, descriptors, feat_options);
+	it->second.mapVersion = version;
+	it->second.number_of_features = number_of_features;
+	it->second.descriptors = descriptors;
+	it->second.landmarks = theMap;
 
-		outMap = *theMap;
+	internal_shrinkCache();
+}
 
-		// Insert into the cache:
-		m_cache[&grid] = theMap;
-	}
-	else
+void COccupancyGridMapFeatureExtractor::internal_shrinkCache()
+{
+	while (m_cache.size() > m_cacheSize)
 	{
-		// Already in the cache:
-		outMap = *(it->second);
+		m_cache.erase(m_lru.back());
+		m_lru.pop_back();
 	}
+}
 
-#endif
+void COccupancyGridMapFeatureExtractor::clearCache()
+{
+	std::lock_guard<std::mutex> lck(m_cache_mtx);
+	m_cache.clear();
+	m_lru.clear();
+}
+
+size_t COccupancyGridMapFeatureExtractor::cachedMapsCount() const
+{
+	std::lock_guard<std::mutex> lck(m_cache_mtx);
+	return m_cache.size();
+}
+
+void COccupancyGridMapFeatureExtractor::setCacheSize(size_t maxGrids)
+{
+	std::lock_guard<std::mutex> lck(m_cache_mtx);
+	m_cacheSize = maxGrids;
+	internal_shrinkCache();
+}
+
+size_t COccupancyGridMapFeatureExtractor::getCacheSize() const
+{
+	std::lock_guard<std::mutex> lck(m_cache_mtx);
+	return m_cacheSize;
 }
 
 // This will receive the events from maps in order to purge the cache.
@@ -131,7 +180,14 @@ void COccupancyGridMapFeatureExtractor::OnEvent(const mrptEvent& e)
 	if (src)
 	{
 		// Remove from cache:
-		m_cache.erase(src);
+		{
+			std::lock_guard<std::mutex> lck(m_cache_mtx);
+			if (auto it = m_cache.find(src); it != m_cache.end())
+			{
+				m_lru.erase(it->second.lru);
+				m_cache.erase(it);
+			}
+		}
 
 		// Unsubscribe:
 		this->observeEnd(*const_cast<COccupancyGridMap2D*>(src));
@@ -107,7 +107,7 @@ void CRangeBearingKFSLAM::getCurrentRobotPose(
 	out_robotPose.mean.m_quat[3] = m_xkk[6];
 
 	// and cov:
-	out_robotPose.cov = m_pkk.blockCopy<7, 7>(0, 0);
+	getVehicleCov(out_robotPose.cov);
 
 	MRPT_END
 }
@@ -154,7 +154,7 @@ void CRangeBearingKFSLAM::getCurrentState(
 	out_robotPose.mean.m_quat[3] = m_xkk[6];
 
 	// and cov:
-	out_robotPose.cov = m_pkk.blockCopy<7, 7>(0, 0);
+	getVehicleCov(out_robotPose.cov);
 
 	// Landmarks:
 	ASSERT_(((m_xkk.size() - get_vehicle_size()) % get_feature_size()) == 0);
@@ -177,7 +177,7 @@ void CRangeBearingKFSLAM::getCurrentState(
 	out_fullState.resize(m_xkk.size());
 	std::copy(m_xkk.begin(), m_xkk.end(), out_fullState.begin());
 	// Full cov:
-	out_fullCovariance = m_pkk;
+	getFullCovariance(out_fullCovariance);
 
 	MRPT_END
 }
@@ -196,7 +196,7 @@ void CRangeBearingKFSLAM::processActionObservation(
 	// Sanity check:
 	ASSERT_(
 		m_IDs.size() ==
-		(m_pkk.cols() - get_vehicle_size()) / get_feature_size());
+		(m_xkk.size() - get_vehicle_size()) / get_feature_size());
 
 	// ===================================================================================================================
 	// Here's the meat!: Call the main method for the KF algorithm, which will
@@ -689,7 +689,7 @@ void CRangeBearingKFSLAM::OnGetObservationsAndDataAssociation(
 				true,  // Use KD-tree
 				m_last_data_association.predictions_IDs,
 				options.data_assoc_IC_metric,
-				options.data_assoc_IC_ml_threshold);
+				options.data_assoc_IC_ml_threshold, options.data_assoc_JCBB);
 
 			// Return pairings to the main KF algorithm:
 			for (auto it = m_last_data_association.results.associations.begin();
@@ -770,6 +770,13 @@ void CRangeBearingKFSLAM::TOptions::loadFromConfigFile(
 
 	MRPT_LOAD_CONFIG_VAR(data_assoc_IC_chi2_thres, double, source, section);
 	MRPT_LOAD_CONFIG_VAR(data_assoc_IC_ml_threshold, double, source, section);
+	data_assoc_JCBB.numThreads = source.read_int(
+		section, "data_assoc_JCBB_numThreads", data_assoc_JCBB.numThreads);
+	data_assoc_JCBB.timeBudget = source.read_double(
+		section, "data_assoc_JCBB_timeBudget", data_assoc_JCBB.timeBudget);
+	data_assoc_JCBB.ransacSeedIterations = source.read_int(
+		section, "data_assoc_JCBB_ransacSeedIterations",
+		data_assoc_JCBB.ransacSeedIterations);
 
 	MRPT_LOAD_CONFIG_VAR(quantiles_3D_representation, float, source, section);
 }
@@ -821,6 +828,15 @@ void CRangeBearingKFSLAM::TOptions::dumpToTextStream(std::ostream& out) const
 	out << mrpt::format(
 		"data_assoc_IC_ml_threshold              = %.06f\n",
 		data_assoc_IC_ml_threshold);
+	out << mrpt::format(
+		"data_assoc_JCBB_numThreads              = %u\n",
+		data_assoc_JCBB.numThreads);
+	out << mrpt::format(
+		"data_assoc_JCBB_timeBudget              = %.06f\n",
+		data_assoc_JCBB.timeBudget);
+	out << mrpt::format(
+		"data_assoc_JCBB_ransacSeedIterations    = %u\n",
+		data_assoc_JCBB.ransacSeedIterations);
 
 	out << "\n";
 }
@@ -975,7 +991,9 @@ void CRangeBearingKFSLAM::getAs3DObject(
 	pointGauss.mean.x(m_xkk[0]);
 	pointGauss.mean.y(m_xkk[1]);
 	pointGauss.mean.z(m_xkk[2]);
-	pointGauss.cov = m_pkk.blockCopy<3, 3>(0, 0);
+	KFMatrix_VxV Pxx;
+	getVehicleCov(Pxx);
+	pointGauss.cov = Pxx.blockCopy<3, 3>(0, 0);
 
 	{
 		auto ellip = opengl::CEllipsoid3D::Create();
@@ -1001,10 +1019,7 @@ void CRangeBearingKFSLAM::getAs3DObject(
 		pointGauss.mean.z(
 			m_xkk[get_vehicle_size() + get_feature_size() * i + 2]);
 
-		pointGauss.cov =
-			m_pkk.blockCopy<get_feature_size(), get_feature_size()>(
-				get_vehicle_size() + get_feature_size() * i,
-				get_vehicle_size() + get_feature_size() * i);
+		getLandmarkCov(i, pointGauss.cov);
 
 		auto ellip = opengl::CEllipsoid3D::Create();
 
@@ -1168,7 +1183,8 @@ double CRangeBearingKFSLAM::computeOffDiagonalBlocksApproximationError(
 	MRPT_START
 
 	// Compute the information matrix:
-	CMatrixDynamic<kftype> fullCov(m_pkk);
+	CMatrixDynamic<kftype> fullCov;
+	getFullCovariance(fullCov);
 	size_t i;
 	for (i = 0; i < get_vehicle_size(); i++)
 		fullCov(i, i) = max(fullCov(i, i), 1e-6);
@@ -1263,9 +1279,11 @@ void CRangeBearingKFSLAM::saveMapAndPath2DRepresentationAsMATLABFile(
 	{
 		size_t idx = get_vehicle_size() + i * get_feature_size();
 
-		cov(0, 0) = m_pkk(idx + 0, idx + 0);
-		cov(1, 1) = m_pkk(idx + 1, idx + 1);
-		cov(0, 1) = cov(1, 0) = m_pkk(idx + 0, idx + 1);
+		KFMatrix_FxF Pyy;
+		getLandmarkCov(i, Pyy);
+		cov(0, 0) = Pyy(0, 0);
+		cov(1, 1) = Pyy(1, 1);
+		cov(0, 1) = cov(1, 0) = Pyy(0, 1);
 
 		mean[0] = m_xkk[idx + 0];
 		mean[1] = m_xkk[idx + 1];
@@ -1296,9 +1314,11 @@ void CRangeBearingKFSLAM::saveMapAndPath2DRepresentationAsMATLABFile(
 	}
 
 	// The robot pose:
-	cov(0, 0) = m_pkk(0, 0);
-	cov(1, 1) = m_pkk(1, 1);
-	cov(0, 1) = cov(1, 0) = m_pkk(0, 1);
+	KFMatrix_VxV Pxx;
+	getVehicleCov(Pxx);
+	cov(0, 0) = Pxx(0, 0);
+	cov(1, 1) = Pxx(1, 1);
+	cov(0, 1) = cov(1, 0) = Pxx(0, 1);
 
 	mean[0] = m_xkk[0];
 	mean[1] = m_xkk[1];
@@ -1367,8 +1387,10 @@ void CRangeBearingKFSLAM::OnPreComputingPredictions(
 	const double fov_yaw = obs->fieldOfView_yaw;
 	const double fov_pitch = obs->fieldOfView_pitch;
 
+	KFMatrix_VxV Pxx;
+	getVehicleCov(Pxx);
 	const double max_vehicle_loc_uncertainty =
-		4 * std::sqrt(m_pkk(0, 0) + m_pkk(1, 1) + m_pkk(2, 2));
+		4 * std::sqrt(Pxx(0, 0) + Pxx(1, 1) + Pxx(2, 2));
 #endif
 
 	out_LM_indices_to_predict.clear();
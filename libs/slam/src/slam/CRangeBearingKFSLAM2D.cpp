@@ -81,7 +81,7 @@ void CRangeBearingKFSLAM2D::getCurrentRobotPose(
 	out_robotPose.mean = CPose2D(m_xkk[0], m_xkk[1], m_xkk[2]);
 
 	// and cov:
-	out_robotPose.cov = m_pkk.blockCopy<3, 3>(0, 0);
+	getVehicleCov(out_robotPose.cov);
 
 	MRPT_END
 }
@@ -103,7 +103,7 @@ void CRangeBearingKFSLAM2D::getCurrentState(
 	out_robotPose.mean = CPose2D(m_xkk[0], m_xkk[1], m_xkk[2]);
 
 	// and cov:
-	out_robotPose.cov = m_pkk.blockCopy<3, 3>(0, 0);
+	getVehicleCov(out_robotPose.cov);
 
 	// Landmarks:
 	ASSERT_(((m_xkk.size() - 3) % 2) == 0);
@@ -123,7 +123,7 @@ void CRangeBearingKFSLAM2D::getCurrentState(
 	std::copy(m_xkk.begin(), m_xkk.end(), out_fullState.begin());
 
 	// Full cov:
-	out_fullCovariance = m_pkk;
+	getFullCovariance(out_fullCovariance);
 
 	MRPT_END
 }
@@ -690,7 +690,7 @@ void CRangeBearingKFSLAM2D::OnGetObservationsAndDataAssociation(
 				true,  // Use KD-tree
 				m_last_data_association.predictions_IDs,
 				options.data_assoc_IC_metric,
-				options.data_assoc_IC_ml_threshold);
+				options.data_assoc_IC_ml_threshold, options.data_assoc_JCBB);
 
 			// Return pairings to the main KF algorithm:
 			for (auto it = m_last_data_association.results.associations.begin();
@@ -752,6 +752,13 @@ void CRangeBearingKFSLAM2D::TOptions::loadFromConfigFile(
 
 	MRPT_LOAD_CONFIG_VAR(data_assoc_IC_chi2_thres, double, source, section);
 	MRPT_LOAD_CONFIG_VAR(data_assoc_IC_ml_threshold, double, source, section);
+	data_assoc_JCBB.numThreads = source.read_int(
+		section, "data_assoc_JCBB_numThreads", data_assoc_JCBB.numThreads);
+	data_assoc_JCBB.timeBudget = source.read_double(
+		section, "data_assoc_JCBB_timeBudget", data_assoc_JCBB.timeBudget);
+	data_assoc_JCBB.ransacSeedIterations = source.read_int(
+		section, "data_assoc_JCBB_ransacSeedIterations",
+		data_assoc_JCBB.ransacSeedIterations);
 }
 
 /*---------------------------------------------------------------
@@ -795,6 +802,15 @@ void CRangeBearingKFSLAM2D::TOptions::dumpToTextStream(std::ostream& out) const
 	out << mrpt::format(
 		"data_assoc_IC_ml_threshold              = %.06f\n",
 		data_assoc_IC_ml_threshold);
+	out << mrpt::format(
+		"data_assoc_JCBB_numThreads              = %u\n",
+		data_assoc_JCBB.numThreads);
+	out << mrpt::format(
+		"data_assoc_JCBB_timeBudget              = %.06f\n",
+		data_assoc_JCBB.timeBudget);
+	out << mrpt::format(
+		"data_assoc_JCBB_ransacSeedIterations    = %u\n",
+		data_assoc_JCBB.ransacSeedIterations);
 
 	out << "\n";
 }
@@ -938,7 +954,9 @@ void CRangeBearingKFSLAM2D::getAs3DObject(
 	CPoint2DPDFGaussian pointGauss;
 	pointGauss.mean.x(m_xkk[0]);
 	pointGauss.mean.y(m_xkk[1]);
-	pointGauss.cov = m_pkk.blockCopy<2, 2>(0, 0);
+	KFMatrix_VxV Pxx;
+	getVehicleCov(Pxx);
+	pointGauss.cov = Pxx.blockCopy<2, 2>(0, 0);
 
 	{
 		auto ellip = opengl::CEllipsoid2D::Create();
@@ -958,7 +976,7 @@ void CRangeBearingKFSLAM2D::getAs3DObject(
 	{
 		pointGauss.mean.x(m_xkk[3 + 2 * i + 0]);
 		pointGauss.mean.y(m_xkk[3 + 2 * i + 1]);
-		pointGauss.cov = m_pkk.blockCopy<2, 2>(3 + 2 * i, 3 + 2 * i);
+		getLandmarkCov(i, pointGauss.cov);
 
 		auto ellip = opengl::CEllipsoid2D::Create();
 
@@ -1018,9 +1036,11 @@ void CRangeBearingKFSLAM2D::saveMapAndPath2DRepresentationAsMATLABFile(
 	{
 		size_t idx = get_vehicle_size() + i * get_feature_size();
 
-		cov(0, 0) = m_pkk(idx + 0, idx + 0);
-		cov(1, 1) = m_pkk(idx + 1, idx + 1);
-		cov(0, 1) = cov(1, 0) = m_pkk(idx + 0, idx + 1);
+		KFMatrix_FxF Pyy;
+		getLandmarkCov(i, Pyy);
+		cov(0, 0) = Pyy(0, 0);
+		cov(1, 1) = Pyy(1, 1);
+		cov(0, 1) = cov(1, 0) = Pyy(0, 1);
 
 		mean[0] = m_xkk[idx + 0];
 		mean[1] = m_xkk[idx + 1];
@@ -1052,9 +1072,11 @@ void CRangeBearingKFSLAM2D::saveMapAndPath2DRepresentationAsMATLABFile(
 	}
 
 	// The robot pose:
-	cov(0, 0) = m_pkk(0, 0);
-	cov(1, 1) = m_pkk(1, 1);
-	cov(0, 1) = cov(1, 0) = m_pkk(0, 1);
+	KFMatrix_VxV Pxx;
+	getVehicleCov(Pxx);
+	cov(0, 0) = Pxx(0, 0);
+	cov(1, 1) = Pxx(1, 1);
+	cov(0, 1) = cov(1, 0) = Pxx(0, 1);
 
 	mean[0] = m_xkk[0];
 	mean[1] = m_xkk[1];
@@ -1118,9 +1140,11 @@ void CRangeBearingKFSLAM2D::OnPreComputingPredictions(
 	const double sensor_max_range = obs->maxSensorDistance;
 	const double fov_yaw = obs->fieldOfView_yaw;
 
+	KFMatrix_VxV Pxx;
+	getVehicleCov(Pxx);
 	const double max_vehicle_loc_uncertainty =
-		4 * std::sqrt(m_pkk(0, 0) + m_pkk(1, 1));
-	const double max_vehicle_ang_uncertainty = 4 * std::sqrt(m_pkk(2, 2));
+		4 * std::sqrt(Pxx(0, 0) + Pxx(1, 1));
+	const double max_vehicle_ang_uncertainty = 4 * std::sqrt(Pxx(2, 2));
 
 	out_LM_indices_to_predict.clear();
 	for (size_t i = 0; i < prediction_means.size(); i++)
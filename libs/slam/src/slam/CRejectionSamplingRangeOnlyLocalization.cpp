@@ -9,6 +9,7 @@
 
 #include "slam-precomp.h"  // Precompiled headers
 //
+#include <mrpt/core/WorkerThreadsPool.h>
 #include <mrpt/maps/CLandmark.h>
 #include <mrpt/maps/CLandmarksMap.h>
 #include <mrpt/math/TPose2D.h>
@@ -16,6 +17,10 @@
 #include <mrpt/obs/CObservationBeaconRanges.h>
 #include <mrpt/slam/CRejectionSamplingRangeOnlyLocalization.h>
 
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
 using namespace mrpt::math;
 using namespace mrpt::slam;
 using namespace mrpt::maps;
@@ -40,6 +45,12 @@ CRejectionSamplingRangeOnlyLocalization::
 ---------------------------------------------------------------*/
 void CRejectionSamplingRangeOnlyLocalization::RS_drawFromProposal(
 	CPose2D& outSample)
+{
+	drawFromProposal(getRandomGenerator(), outSample);
+}
+
+void CRejectionSamplingRangeOnlyLocalization::drawFromProposal(
+	CRandomGenerator& rng, CPose2D& outSample) const
 {
 	MRPT_START
 
@@ -50,25 +61,20 @@ void CRejectionSamplingRangeOnlyLocalization::RS_drawFromProposal(
 			"'setParams' with valid data!");
 
 	ASSERT_(m_drawIndex < m_dataPerBeacon.size());
+	const TDataPerBeacon& d = m_dataPerBeacon[m_drawIndex];
 
-	float ang = getRandomGenerator().drawUniform(
-		m_dataPerBeacon[m_drawIndex].minAngle,
-		m_dataPerBeacon[m_drawIndex].maxAngle);
-	float R = getRandomGenerator().drawGaussian1D(
-		m_dataPerBeacon[m_drawIndex].radiusAtRobotPlane, m_sigmaRanges);
+	float ang = rng.drawUniform(d.minAngle, d.maxAngle);
+	float R = rng.drawGaussian1D(d.radiusAtRobotPlane, m_sigmaRanges);
 
 	// This is the point where the SENSOR is:
-	outSample.x(m_dataPerBeacon[m_drawIndex].beaconPosition.x + cos(ang) * R);
-	outSample.y(m_dataPerBeacon[m_drawIndex].beaconPosition.y + sin(ang) * R);
+	outSample.x(d.beaconPosition.x + cos(ang) * R);
+	outSample.y(d.beaconPosition.y + sin(ang) * R);
 
-	outSample.phi(
-		getRandomGenerator().drawGaussian1D(m_oldPose.phi(), 2.0_deg));
+	outSample.phi(rng.drawGaussian1D(m_oldPose.phi(), 2.0_deg));
 
 	// Compute the robot pose P.
 	//	  P = SAMPLE - ROT · SENSOR_ON_ROBOT
-	mrpt::math::TPoint2D on(
-		m_dataPerBeacon[m_drawIndex].sensorOnRobot.x,
-		m_dataPerBeacon[m_drawIndex].sensorOnRobot.y);
+	mrpt::math::TPoint2D on(d.sensorOnRobot.x, d.sensorOnRobot.y);
 	mrpt::math::TPoint2D S(outSample.x(), outSample.y());
 	on = mrpt::math::TPoint2D(mrpt::math::TPose2D(0, 0, outSample.phi()) + on);
 	S = S - on;
@@ -84,33 +90,132 @@ void CRejectionSamplingRangeOnlyLocalization::RS_drawFromProposal(
 ---------------------------------------------------------------*/
 double CRejectionSamplingRangeOnlyLocalization::RS_observationLikelihood(
 	const CPose2D& x)
+{
+	return observationLikelihood(x);
+}
+
+double CRejectionSamplingRangeOnlyLocalization::observationLikelihood(
+	const CPose2D& x) const
+{
+	// Evaluate the likelihood for all the observations but the "m_drawIndex",
+	// accumulating the squared errors of all beacons in a vectorizable loop,
+	// with one exp() at the end:
+	// TODO: height now includes the sensor "z"!!!...
+	const auto& b = m_likBeacons;
+	const size_t n = b.radius.size();
+	const double c = std::cos(x.phi()), s = std::sin(x.phi());
+	const double x0 = x.x(), y0 = x.y();
+
+	double sumSqErr = 0;
+	for (size_t i = 0; i < n; i++)
+	{
+		const double px = x0 + c * b.sensor_x[i] - s * b.sensor_y[i];
+		const double py = y0 + s * b.sensor_x[i] + c * b.sensor_y[i];
+		const double dist = std::sqrt(
+			square(px - b.beacon_x[i]) + square(py - b.beacon_y[i]));
+		sumSqErr += square(b.radius[i] - dist);
+	}
+
+	return std::exp(-0.5 * sumSqErr / square(m_sigmaRanges));
+}
+
+void CRejectionSamplingRangeOnlyLocalization::TLikelihoodBeacons::clear()
+{
+	sensor_x.clear();
+	sensor_y.clear();
+	beacon_x.clear();
+	beacon_y.clear();
+	radius.clear();
+}
+
+void CRejectionSamplingRangeOnlyLocalization::TLikelihoodBeacons::push_back(
+	const TDataPerBeacon& d)
+{
+	sensor_x.push_back(d.sensorOnRobot.x);
+	sensor_y.push_back(d.sensorOnRobot.y);
+	beacon_x.push_back(d.beaconPosition.x);
+	beacon_y.push_back(d.beaconPosition.y);
+	radius.push_back(d.radiusAtRobotPlane);
+}
+
+/*---------------------------------------------------------------
+					rejectionSamplingParallel
+---------------------------------------------------------------*/
+void CRejectionSamplingRangeOnlyLocalization::rejectionSamplingParallel(
+	size_t desiredSamples, std::vector<TParticle>& outSamples,
+	size_t timeoutTrials, size_t numThreads)
 {
 	MRPT_START
 
-	double lik = 1.0;
-	double m_sigmaRanges2 = square(m_sigmaRanges);
+	ASSERTMSG_(
+		!m_dataPerBeacon.empty(),
+		"There is no information from which to draw samples!! Use "
+		"'setParams' with valid data!");
+
+	outSamples.resize(desiredSamples);
+	for (auto& p : outSamples)
+		if (!p.d) p.d.reset(new CPose2D);
+
+	// One random generator per block of samples, seeded here so the
+	// samples do not depend on the number of threads:
+	const size_t blockSize = 64;
+	const size_t nBlocks = (desiredSamples + blockSize - 1) / blockSize;
+	std::vector<uint32_t> seeds(nBlocks);
+	for (auto& seed : seeds)
+		seed = getRandomGenerator().drawUniform32bit();
+
+	auto lmbBlock = [&](size_t blk) {
+		CRandomGenerator rng(seeds[blk]);
+		const size_t i1 = std::min(desiredSamples, (blk + 1) * blockSize);
+		for (size_t i = blk * blockSize; i < i1; i++)
+		{
+			CPose2D x, bestVal;
+			double acceptanceProb, bestLik = -1;
+			size_t timeoutCount = 0;
+			do
+			{
+				drawFromProposal(rng, x);
+				acceptanceProb = observationLikelihood(x);
+				if (acceptanceProb > bestLik)
+				{
+					bestLik = acceptanceProb;
+					bestVal = x;
+				}
+			} while (acceptanceProb < rng.drawUniform(0.0, 0.999) &&
+					 (++timeoutCount) < timeoutTrials);
 
-	// Evaluate the likelihood for all the observations but the "m_drawIndex":
-	for (size_t i = 0; i < m_dataPerBeacon.size(); i++)
+			// Save weights:
+			auto& sample = outSamples[i];
+			if (timeoutCount >= timeoutTrials)
+			{
+				sample.log_w = std::log(bestLik);
+				*sample.d = bestVal;
+			}
+			else
+			{
+				sample.log_w = 0;
+				*sample.d = x;
+			}
+		}
+	};
+
+	if (!numThreads)
+		numThreads = std::max(1U, std::thread::hardware_concurrency());
+	numThreads = std::min(numThreads, nBlocks);
+
+	if (numThreads <= 1)
 	{
-		// TODO: height now includes the sensor "z"!!!...
-		CPoint3D P(
-			x +
-			CPoint3D(
-				m_dataPerBeacon[i].sensorOnRobot.x,
-				m_dataPerBeacon[i].sensorOnRobot.y, 0));
-
-		if (i != m_drawIndex)
-			// Evalute:
-			lik *=
-				exp(-0.5 *
-					square(
-						m_dataPerBeacon[i].radiusAtRobotPlane -
-						P.distanceTo(m_dataPerBeacon[i].beaconPosition)) /
-					m_sigmaRanges2);
+		for (size_t blk = 0; blk < nBlocks; blk++)
+			lmbBlock(blk);
+	}
+	else
+	{
+		// The calling thread also runs blocks in parallel_for():
+		mrpt::WorkerThreadsPool pool(
+			numThreads - 1, mrpt::WorkerThreadsPool::POLICY_FIFO,
+			"rej_sampling");
+		pool.parallel_for(0, nBlocks, 1, lmbBlock);
 	}
-
-	return lik;
 
 	MRPT_END
 }
@@ -311,6 +416,10 @@ bool CRejectionSamplingRangeOnlyLocalization::setParams(
 		}
 	}  // end for i
 
+	m_likBeacons.clear();
+	for (i = 0; i < m_dataPerBeacon.size(); i++)
+		if (i != m_drawIndex) m_likBeacons.push_back(m_dataPerBeacon[i]);
+
 	// End!
 	return m_dataPerBeacon.size() != 0;
 	MRPT_END
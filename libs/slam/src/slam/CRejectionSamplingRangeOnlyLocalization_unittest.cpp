@@ -0,0 +1,73 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/maps/CLandmarksMap.h>
+#include <mrpt/obs/CObservationBeaconRanges.h>
+#include <mrpt/random/RandomGenerators.h>
+#include <mrpt/slam/CRejectionSamplingRangeOnlyLocalization.h>
+
+using namespace mrpt::slam;
+using mrpt::math::TPoint3D;
+using mrpt::poses::CPoint3D;
+using mrpt::poses::CPose2D;
+using mrpt::poses::CPose3D;
+
+TEST(CRejectionSamplingRangeOnlyLocalization, parallelSampling)
+{
+	// Beacons at 2.5 m above the ground, and a robot at (1,2) with the
+	// sensor 0.5 m ahead of it:
+	const std::vector<TPoint3D> beacons = {
+		{-4.0, -3.0, 2.5}, {6.0, -2.0, 2.5}, {5.0, 7.0, 2.5}, {-3.0, 6.0, 2.5}};
+	const CPose2D robot(1.0, 2.0, 0.0);
+	const CPoint3D sensorOnRobot(0.5, 0, 0);
+	const auto sensor = (CPose3D(robot) + sensorOnRobot).asTPoint();
+
+	mrpt::maps::CLandmarksMap map;
+	mrpt::obs::CObservationBeaconRanges obs;
+	for (size_t i = 0; i < beacons.size(); i++)
+	{
+		mrpt::maps::CLandmark lm;
+		lm.ID = i;
+		lm.pose_mean = beacons[i];
+		map.landmarks.push_back(lm);
+
+		mrpt::obs::CObservationBeaconRanges::TMeasurement m;
+		m.beaconID = static_cast<int32_t>(i);
+		m.sensedDistance = static_cast<float>(sensor.distanceTo(beacons[i]));
+		m.sensorLocationOnRobot = sensorOnRobot;
+		obs.sensedData.push_back(m);
+	}
+
+	CRejectionSamplingRangeOnlyLocalization rs;
+	ASSERT_TRUE(rs.setParams(map, obs, 0.05f, robot));
+
+	std::vector<CRejectionSamplingRangeOnlyLocalization::TParticle> samples1,
+		samples4;
+	mrpt::random::getRandomGenerator().randomize(1234);
+	rs.rejectionSamplingParallel(300, samples1, 1000, 1);
+	mrpt::random::getRandomGenerator().randomize(1234);
+	rs.rejectionSamplingParallel(300, samples4, 1000, 4);
+
+	ASSERT_EQ(samples1.size(), 300U);
+	ASSERT_EQ(samples4.size(), 300U);
+	double mx = 0, my = 0;
+	for (size_t i = 0; i < samples1.size(); i++)
+	{
+		// Same samples, regardless of the number of threads:
+		EXPECT_EQ(*samples1[i].d, *samples4[i].d);
+		EXPECT_EQ(samples1[i].log_w, samples4[i].log_w);
+		mx += samples1[i].d->x();
+		my += samples1[i].d->y();
+	}
+	mx /= samples1.size();
+	my /= samples1.size();
+	EXPECT_NEAR(mx, robot.x(), 0.1);
+	EXPECT_NEAR(my, robot.y(), 0.1);
+}
@@ -0,0 +1,100 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/core/exceptions.h>
+#include <mrpt/math/math_frwds.h>
+#include <mrpt/random/RandomGenerators.h>
+#include <mrpt/slam/PF_aux_structs.h>
+
+#include <set>
+
+using namespace mrpt::slam::detail;
+
+// A bin type without hash_operator:
+struct TMyBin
+{
+	int a{0};
+	struct lt_operator
+	{
+		bool operator()(const TMyBin& s1, const TMyBin& s2) const
+		{
+			return s1.a < s2.a;
+		}
+	};
+};
+
+static_assert(std::is_same_v<
+			  TStateSpaceBins<TPoseBin2D>, TStateSpaceBinsHashSet<TPoseBin2D>>);
+static_assert(std::is_same_v<
+			  TStateSpaceBins<TMyBin>, TStateSpaceBinsTreeSet<TMyBin>>);
+
+template <class SET>
+void testBinsSet()
+{
+	auto& rng = mrpt::random::getRandomGenerator();
+	rng.randomize(1234);
+
+	SET bins;
+	for (int iter = 0; iter < 3; iter++)
+	{
+		bins.clear();
+		EXPECT_EQ(bins.size(), 0U);
+
+		std::set<TPoseBin3D, TPoseBin3D::lt_operator> gt;
+		std::vector<TPoseBin3D> inserted;
+		for (int i = 0; i < 5000; i++)
+		{
+			TPoseBin3D b;
+			b.x = rng.drawUniform32bit() % 20 - 10;
+			b.y = rng.drawUniform32bit() % 20 - 10;
+			b.yaw = rng.drawUniform32bit() % 4;
+
+			const auto [idx, isNew] = bins.insert(b);
+			EXPECT_EQ(isNew, gt.insert(b).second);
+			if (isNew)
+			{
+				EXPECT_EQ(idx, inserted.size());
+				inserted.push_back(b);
+			}
+			else
+			{
+				ASSERT_LT(idx, inserted.size());
+				EXPECT_FALSE(TPoseBin3D::lt_operator()(inserted[idx], b));
+				EXPECT_FALSE(TPoseBin3D::lt_operator()(b, inserted[idx]));
+			}
+		}
+		EXPECT_EQ(bins.size(), gt.size());
+	}
+}
+
+TEST(PF_aux_structs, TStateSpaceBinsHashSet)
+{
+	testBinsSet<TStateSpaceBinsHashSet<TPoseBin3D>>();
+}
+
+TEST(PF_aux_structs, TStateSpaceBinsTreeSet)
+{
+	testBinsSet<TStateSpaceBinsTreeSet<TPoseBin3D>>();
+}
+
+TEST(PF_aux_structs, TPathBin2D)
+{
+	TStateSpaceBins<TPathBin2D> bins;
+	TPathBin2D p1, p2;
+	p1.bins.resize(3);
+	p2.bins.resize(3);
+	p2.bins[2].phi = 1;
+
+	EXPECT_TRUE(bins.insert(p1).second);
+	EXPECT_TRUE(bins.insert(p2).second);
+	EXPECT_FALSE(bins.insert(p1).second);
+	EXPECT_EQ(bins.insert(p2).first, 1U);
+	EXPECT_EQ(bins.size(), 2U);
+}
@@ -9,20 +9,26 @@
 
 #include "slam-precomp.h"  // Precompiled headers
 //
+#include <mrpt/core/WorkerThreadsPool.h>
 #include <mrpt/math/KDTreeCapable.h>  // For kd-tree's
 #include <mrpt/math/data_utils.h>
 #include <mrpt/math/distributions.h>  // for chi2inv
 #include <mrpt/math/ops_matrices.h>	 // extractSubmatrix
 #include <mrpt/poses/CPoint2DPDFGaussian.h>
 #include <mrpt/poses/CPointPDFGaussian.h>
+#include <mrpt/random/random_shuffle.h>
 #include <mrpt/slam/data_association.h>
 
 #include <Eigen/Dense>
+#include <atomic>
+#include <chrono>
 #include <memory>
 #include <memory>  // unique_ptr
 #include <nanoflann.hpp>  // For kd-tree's
-#include <numeric>	// accumulate
+#include <optional>
+#include <random>
 #include <set>
+#include <thread>
 
 /*
    For all data association algorithms, the individual compatibility is
@@ -146,6 +152,45 @@ bool isCloser<metricML>(const double v1, const double v2)
 	return v1 > v2;
 }
 
+/** State of the JCBB search shared by all the threads */
+struct TJCBBSharedData
+{
+	/** potentialsFrom[i]: number of observations with index >=i with at
+	 * least one IC prediction, i.e. an upper bound of the number of pairings
+	 * that can be added to a hypothesis from the i'th observation on. */
+	std::vector<size_t> potentialsFrom;
+	/** Size of the largest hypothesis found so far by any thread */
+	std::atomic<size_t> bestSize{0};
+	std::atomic<size_t> nNodes{0};
+	std::atomic<bool> timedOut{false};
+	bool hasDeadline = false;
+	std::chrono::steady_clock::time_point deadline;
+};
+
+/** A hypothesis and its joint distance (mahalanobis or matching likelihood) */
+struct TJCBBHypothesis
+{
+	std::map<observation_index_t, prediction_index_t> associations;
+	double distance = 0;
+};
+
+/** The state of one thread of the JCBB search, at one node of the tree */
+struct TJCBBNode
+{
+	TAuxDataRecursiveJCBB info;
+	std::vector<bool> predUsed;
+	observation_index_t curObsIdx = 0;
+};
+
+template <TDataAssociationMetric METRIC>
+bool isBetterHypothesis(const TJCBBHypothesis& h, const TJCBBHypothesis& best)
+{
+	if (h.associations.size() != best.associations.size())
+		return h.associations.size() > best.associations.size();
+	return !h.associations.empty() &&
+		isCloser<METRIC>(h.distance, best.distance);
+}
+
 /* Based on MATLAB code by:
   University of Zaragoza
   Centro Politecnico Superior
@@ -158,101 +203,277 @@ void JCBB_recursive(
 	const mrpt::math::CMatrixDynamic<T>& Z_observations_mean,
 	const mrpt::math::CMatrixDynamic<T>& Y_predictions_mean,
 	const mrpt::math::CMatrixDynamic<T>& Y_predictions_cov,
-	TDataAssociationResults& results, const TAuxDataRecursiveJCBB& info,
-	const observation_index_t curObsIdx)
+	const TDataAssociationResults& results, TJCBBSharedData& shared,
+	TJCBBNode& node, TJCBBHypothesis& best, size_t& nNodes)
 {
+	// Anytime mode: check the clock from time to time:
+	if (shared.hasDeadline && (nNodes & 0xff) == 0 &&
+		std::chrono::steady_clock::now() > shared.deadline)
+		shared.timedOut = true;
+	if (shared.timedOut.load(std::memory_order_relaxed)) return;
+
+	auto& curAssoc = node.info.currentAssociation;
+	const observation_index_t obsIdx = node.curObsIdx;
+
 	// End of iteration?
-	if (curObsIdx >= info.nObservations)
+	if (obsIdx >= node.info.nObservations)
 	{
-		if (info.currentAssociation.size() > results.associations.size())
-		{
-			// It's a better choice since more features are matched.
-			results.associations = info.currentAssociation;
-			results.distance = joint_pdf_metric<T, METRIC>(
-				Z_observations_mean, Y_predictions_mean, Y_predictions_cov,
-				info, results);
-		}
-		else if (
-			!info.currentAssociation.empty() &&
-			info.currentAssociation.size() == results.associations.size())
+		// Smaller than the best one found by another thread?
+		if (curAssoc.empty() || curAssoc.size() < best.associations.size() ||
+			curAssoc.size() < shared.bestSize.load(std::memory_order_relaxed))
+			return;
+
+		TJCBBHypothesis h;
+		h.distance = joint_pdf_metric<T, METRIC>(
+			Z_observations_mean, Y_predictions_mean, Y_predictions_cov,
+			node.info, results);
+		// More features matched, or the same number with a better distance:
+		if (curAssoc.size() > best.associations.size() ||
+			isCloser<METRIC>(h.distance, best.distance))
 		{
-			// The same # of features matched than the previous best one...
-			// decide by better distance:
-			const double d2 = joint_pdf_metric<T, METRIC>(
-				Z_observations_mean, Y_predictions_mean, Y_predictions_cov,
-				info, results);
+			best.associations = curAssoc;
+			best.distance = h.distance;
 
-			if (isCloser<METRIC>(d2, results.distance))
+			size_t prev = shared.bestSize.load();
+			while (prev < curAssoc.size() &&
+				   !shared.bestSize.compare_exchange_weak(
+					   prev, curAssoc.size()))
 			{
-				results.associations = info.currentAssociation;
-				results.distance = d2;
 			}
 		}
+		return;
 	}
-	else  // A normal iteration:
+
+	// Can we do it better than the best hypothesis so far? This can be
+	// checked by counting the potential new pairings+the so-far
+	// established ones.
+	//    Matlab: potentials  = pairings(compatibility.AL(i+1:end))
+	// Moved up by Kasra Khosoussi
+	const size_t potentials = shared.potentialsFrom[obsIdx + 1];
+	const size_t nPreds = results.indiv_compatibility.rows();
+
+	node.curObsIdx = obsIdx + 1;
+	for (prediction_index_t predIdx = 0; predIdx < nPreds; predIdx++)
 	{
-		// Iterate for all compatible landmarsk of "curObsIdx"
-		const observation_index_t obsIdx = curObsIdx;
-
-		const size_t nPreds = results.indiv_compatibility.rows();
-
-		// Can we do it better than the current "results.associations"?
-		// This can be checked by counting the potential new pairings+the so-far
-		// established ones.
-		//    Matlab: potentials  = pairings(compatibility.AL(i+1:end))
-		// Moved up by Kasra Khosoussi
-		const size_t potentials = std::accumulate(
-			results.indiv_compatibility_counts.begin() + (obsIdx + 1),
-			results.indiv_compatibility_counts.end(), 0);
-		for (prediction_index_t predIdx = 0; predIdx < nPreds; predIdx++)
+		// Only if predIdx is compatible and NOT already assigned:
+		if (!results.indiv_compatibility(predIdx, obsIdx) ||
+			node.predUsed[predIdx])
+			continue;
+
+		// The bound only grows, so the rest of predictions can be skipped:
+		if (curAssoc.size() + 1 + potentials <
+			shared.bestSize.load(std::memory_order_relaxed))
+			break;
+
+		// Launch a new recursive line for this hipothesis:
+		curAssoc[obsIdx] = predIdx;
+		node.predUsed[predIdx] = true;
+		nNodes++;
+		JCBB_recursive<T, METRIC>(
+			Z_observations_mean, Y_predictions_mean, Y_predictions_cov,
+			results, shared, node, best, nNodes);
+		node.predUsed[predIdx] = false;
+		curAssoc.erase(obsIdx);
+	}
+
+	// star node: Ei not paired
+	if (curAssoc.size() + potentials >=
+		shared.bestSize.load(std::memory_order_relaxed))
+	{
+		nNodes++;
+		JCBB_recursive<T, METRIC>(
+			Z_observations_mean, Y_predictions_mean, Y_predictions_cov,
+			results, shared, node, best, nNodes);
+	}
+	node.curObsIdx = obsIdx;
+}
+
+/** Randomized greedy hypotheses, the best of which is used as the initial
+ * bound of JCBB: in each iteration, observations are visited in random order
+ * (in index order in the first one) and paired to their closest, still
+ * unpaired, IC prediction. */
+template <typename T, TDataAssociationMetric METRIC>
+TJCBBHypothesis JCBB_ransac_seed(
+	const mrpt::math::CMatrixDynamic<T>& Z_observations_mean,
+	const mrpt::math::CMatrixDynamic<T>& Y_predictions_mean,
+	const mrpt::math::CMatrixDynamic<T>& Y_predictions_cov,
+	const TDataAssociationResults& results, const TAuxDataRecursiveJCBB& info0,
+	const unsigned int nIterations)
+{
+	TJCBBHypothesis best;
+	std::vector<observation_index_t> obsOrder;
+	for (size_t j = 0; j < info0.nObservations; j++)
+		if (results.indiv_compatibility_counts[j] > 0) obsOrder.push_back(j);
+	if (obsOrder.empty()) return best;
+
+	// Fixed seed, for repeatable results:
+	std::mt19937 rng(0);
+	TAuxDataRecursiveJCBB info = info0;
+	std::vector<bool> predUsed;
+
+	for (unsigned int it = 0; it < nIterations; it++)
+	{
+		if (it > 0)
+			mrpt::random::shuffle(obsOrder.begin(), obsOrder.end(), rng);
+
+		info.currentAssociation.clear();
+		predUsed.assign(info.nPredictions, false);
+		for (const auto j : obsOrder)
 		{
-			if ((info.currentAssociation.size() + potentials) >=
-				results.associations.size())
+			std::optional<prediction_index_t> closest;
+			for (prediction_index_t i = 0; i < info.nPredictions; i++)
 			{
-				// Only if predIdx is NOT already assigned:
-				if (results.indiv_compatibility(predIdx, obsIdx))
-				{
-					// Only if predIdx is NOT already assigned:
-					bool already_asigned = false;
-					for (auto itS : info.currentAssociation)
-					{
-						if (itS.second == predIdx)
-						{
-							already_asigned = true;
-							break;
-						}
-					}
+				if (!results.indiv_compatibility(i, j) || predUsed[i]) continue;
+				if (!closest ||
+					isCloser<METRIC>(
+						results.indiv_distances(i, j),
+						results.indiv_distances(*closest, j)))
+					closest = i;
+			}
+			if (!closest) continue;
+			info.currentAssociation[j] = *closest;
+			predUsed[*closest] = true;
+		}
+		if (info.currentAssociation.empty()) continue;
+
+		TJCBBHypothesis h;
+		h.associations = info.currentAssociation;
+		h.distance = joint_pdf_metric<T, METRIC>(
+			Z_observations_mean, Y_predictions_mean, Y_predictions_cov, info,
+			results);
+		if (isBetterHypothesis<METRIC>(h, best)) best = std::move(h);
+	}
+	return best;
+}
 
-					if (!already_asigned)
-					{
-						// Launch a new recursive line for this hipothesis:
-						TAuxDataRecursiveJCBB new_info = info;
-						new_info.currentAssociation[curObsIdx] = predIdx;
+/** JCBB, optionally seeded, time-bounded and multi-threaded. Leaves in
+ * `results` the best hypothesis. */
+template <typename T, TDataAssociationMetric METRIC>
+void JCBB_search(
+	const mrpt::math::CMatrixDynamic<T>& Z_observations_mean,
+	const mrpt::math::CMatrixDynamic<T>& Y_predictions_mean,
+	const mrpt::math::CMatrixDynamic<T>& Y_predictions_cov,
+	TDataAssociationResults& results, const TAuxDataRecursiveJCBB& info0,
+	const TJCBBOptions& opts)
+{
+	const size_t nObs = info0.nObservations;
+
+	TJCBBSharedData shared;
+	shared.potentialsFrom.assign(nObs + 1, 0);
+	for (size_t j = nObs; j-- > 0;)
+		shared.potentialsFrom[j] = shared.potentialsFrom[j + 1] +
+			(results.indiv_compatibility_counts[j] > 0 ? 1 : 0);
+	if (opts.timeBudget > 0)
+	{
+		shared.hasDeadline = true;
+		shared.deadline = std::chrono::steady_clock::now() +
+			std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+							  std::chrono::duration<double>(opts.timeBudget));
+	}
 
-						results.nNodesExploredInJCBB++;
+	// Candidates, in the order in which the sequential search would find
+	// them (ties are resolved in favor of the first one):
+	std::vector<TJCBBHypothesis> candidates;
+	if (opts.ransacSeedIterations > 0)
+	{
+		candidates.push_back(JCBB_ransac_seed<T, METRIC>(
+			Z_observations_mean, Y_predictions_mean, Y_predictions_cov,
+			results, info0, opts.ransacSeedIterations));
+		shared.bestSize = candidates.back().associations.size();
+	}
 
-						JCBB_recursive<T, METRIC>(
-							Z_observations_mean, Y_predictions_mean,
-							Y_predictions_cov, results, new_info,
-							curObsIdx + 1);
-					}
+	TJCBBNode root;
+	root.info = info0;
+	root.predUsed.assign(info0.nPredictions, false);
+
+	size_t nThreads = opts.numThreads;
+	if (nThreads == 0)
+		nThreads = std::max<size_t>(1, std::thread::hardware_concurrency());
+
+	// Split the first levels of the interpretation tree into subtrees, in
+	// depth-first order, enough to keep all threads busy:
+	std::vector<TJCBBNode> subtrees(1, root);
+	size_t nNodes = 0;
+	if (nThreads > 1)
+	{
+		const size_t minSubtrees = 8 * nThreads;
+		while (subtrees.size() < minSubtrees &&
+			   subtrees.front().curObsIdx < nObs)
+		{
+			std::vector<TJCBBNode> next;
+			for (auto& n : subtrees)
+			{
+				const size_t j = n.curObsIdx;
+				const size_t bound = shared.bestSize;
+				const size_t base = n.info.currentAssociation.size() +
+					shared.potentialsFrom[j + 1];
+				for (size_t i = 0; i < info0.nPredictions; i++)
+				{
+					if (!results.indiv_compatibility(i, j) || n.predUsed[i] ||
+						base + 1 < bound)
+						continue;
+					TJCBBNode c = n;
+					c.info.currentAssociation[j] = i;
+					c.predUsed[i] = true;
+					c.curObsIdx = j + 1;
+					next.push_back(std::move(c));
+				}
+				if (base >= bound)
+				{
+					n.curObsIdx = j + 1;
+					next.push_back(std::move(n));
 				}
 			}
+			nNodes += next.size();
+			subtrees = std::move(next);
+			if (subtrees.empty()) break;
 		}
+	}
 
-		// Can we do it better than the current "results.associations"?
-		if ((info.currentAssociation.size() + potentials) >=
-			results.associations.size())
-		{
-			// Yes we can </obama>
+	std::vector<TJCBBHypothesis> subtreeBest(subtrees.size());
+	const auto lambdaSearch = [&](size_t k) {
+		size_t n = 0;
+		JCBB_recursive<T, METRIC>(
+			Z_observations_mean, Y_predictions_mean, Y_predictions_cov,
+			results, shared, subtrees[k], subtreeBest[k], n);
+		shared.nNodes += n;
+	};
 
-			// star node: Ei not paired
-			results.nNodesExploredInJCBB++;
-			JCBB_recursive<T, METRIC>(
-				Z_observations_mean, Y_predictions_mean, Y_predictions_cov,
-				results, info, curObsIdx + 1);
-		}
+	if (nThreads <= 1 || subtrees.size() <= 1)
+	{
+		for (size_t k = 0; k < subtrees.size(); k++)
+			lambdaSearch(k);
+	}
+	else
+	{
+		mrpt::WorkerThreadsPool pool(
+			std::min(nThreads, subtrees.size()),
+			mrpt::WorkerThreadsPool::POLICY_FIFO, "JCBB");
+		std::vector<std::future<void>> tasks;
+		tasks.reserve(subtrees.size());
+		for (size_t k = 0; k < subtrees.size(); k++)
+			tasks.emplace_back(pool.enqueue(lambdaSearch, k));
+		for (auto& t : tasks)
+			t.wait();
+		// Rethrow exceptions, if any:
+		for (auto& t : tasks)
+			t.get();
+	}
+
+	for (auto& h : subtreeBest)
+		candidates.push_back(std::move(h));
+
+	TJCBBHypothesis best;
+	for (auto& h : candidates)
+		if (isBetterHypothesis<METRIC>(h, best)) best = std::move(h);
+
+	if (!best.associations.empty())
+	{
+		results.associations = std::move(best.associations);
+		results.distance = best.distance;
 	}
+	results.nNodesExploredInJCBB = nNodes + shared.nNodes;
+	results.JCBB_timedOut = shared.timedOut;
 }
 
 }  // namespace mrpt::slam
@@ -304,7 +525,7 @@ void mrpt::slam::data_association_full_covariance(
 	const bool DAT_ASOC_USE_KDTREE,
 	const std::vector<prediction_index_t>& predictions_IDs,
 	const TDataAssociationMetric compatibilityTestMetric,
-	const double log_ML_compat_test_threshold)
+	const double log_ML_compat_test_threshold, const TJCBBOptions& jcbbOptions)
 {
 	// For details on the theory, see the papers cited at the beginning of this
 	// file.
@@ -536,20 +757,19 @@ void mrpt::slam::data_association_full_covariance(
 		// ------------------------------------
 		case assocJCBB:
 		{
-			// Call to the recursive method:
 			TAuxDataRecursiveJCBB info;
 			info.nPredictions = nPredictions;
 			info.nObservations = nObservations;
 			info.length_O = length_O;
 
 			if (metric == metricMaha)
-				JCBB_recursive<CMatrixDouble::Scalar, metricMaha>(
+				JCBB_search<CMatrixDouble::Scalar, metricMaha>(
 					Z_observations_mean, Y_predictions_mean, Y_predictions_cov,
-					results, info, 0);
+					results, info, jcbbOptions);
 			else
-				JCBB_recursive<CMatrixDouble::Scalar, metricML>(
+				JCBB_search<CMatrixDouble::Scalar, metricML>(
 					Z_observations_mean, Y_predictions_mean, Y_predictions_cov,
-					results, info, 0);
+					results, info, jcbbOptions);
 		}
 		break;
 
@@ -581,7 +801,7 @@ void mrpt::slam::data_association_independent_predictions(
 	const bool DAT_ASOC_USE_KDTREE,
 	const std::vector<prediction_index_t>& predictions_IDs,
 	const TDataAssociationMetric compatibilityTestMetric,
-	const double log_ML_compat_test_threshold)
+	const double log_ML_compat_test_threshold, const TJCBBOptions& jcbbOptions)
 {
 	MRPT_START
 
@@ -616,7 +836,8 @@ void mrpt::slam::data_association_independent_predictions(
 	data_association_full_covariance(
 		Z_observations_mean, Y_predictions_mean, Y_predictions_cov_full,
 		results, method, metric, chi2quantile, DAT_ASOC_USE_KDTREE,
-		predictions_IDs, compatibilityTestMetric, log_ML_compat_test_threshold);
+		predictions_IDs, compatibilityTestMetric, log_ML_compat_test_threshold,
+		jcbbOptions);
 
 	MRPT_END
 }
@@ -8,8 +8,11 @@
    +------------------------------------------------------------------------+ */
 
 #include <gtest/gtest.h>
+#include <mrpt/random/RandomGenerators.h>
 #include <mrpt/slam/data_association.h>
 
+#include <set>
+
 using namespace mrpt;
 using namespace mrpt::slam;
 using namespace mrpt::math;
@@ -55,3 +58,85 @@ TEST(DataAssociation, TestNoICs)
 		}
 	}
 }
+
+// A cluttered scene: many observations, each one compatible with several
+// predictions.
+static void clutteredScene(
+	size_t nPreds, size_t nObs, CMatrixDouble& y, CMatrixDouble& y_cov,
+	CMatrixDouble& z)
+{
+	mrpt::random::CRandomGenerator rng(1234);
+	y.setSize(nPreds, 2);
+	y_cov.setZero(2 * nPreds, 2);
+	for (size_t i = 0; i < nPreds; i++)
+	{
+		y(i, 0) = rng.drawUniform(0, 0.5 * nPreds);
+		y(i, 1) = rng.drawUniform(-1.0, 1.0);
+		y_cov(2 * i, 0) = y_cov(2 * i + 1, 1) = 0.5;
+	}
+	z.setSize(nObs, 2);
+	for (size_t j = 0; j < nObs; j++)
+	{
+		const size_t i = j % nPreds;
+		z(j, 0) = y(i, 0) + rng.drawGaussian1D(0, 0.3);
+		z(j, 1) = y(i, 1) + rng.drawGaussian1D(0, 0.3);
+	}
+}
+
+TEST(DataAssociation, JCBBParallelAndSeeded)
+{
+	CMatrixDouble y, y_cov, z;
+	clutteredScene(9, 7, y, y_cov, z);
+
+	for (const auto metric : {metricMaha, metricML})
+	{
+		TDataAssociationResults ref;
+		data_association_independent_predictions(
+			z, y, y_cov, ref, assocJCBB, metric, 0.99, false);
+		EXPECT_FALSE(ref.JCBB_timedOut);
+		EXPECT_GT(ref.associations.size(), 4U);
+
+		for (const unsigned int nThreads : {1U, 3U, 0U})
+		{
+			for (const unsigned int nSeeds : {0U, 20U})
+			{
+				TJCBBOptions opts;
+				opts.numThreads = nThreads;
+				opts.ransacSeedIterations = nSeeds;
+
+				TDataAssociationResults res;
+				data_association_independent_predictions(
+					z, y, y_cov, res, assocJCBB, metric, 0.99, false, {},
+					metricMaha, 0.0, opts);
+				EXPECT_EQ(res.associations, ref.associations)
+					<< "nThreads=" << nThreads << " nSeeds=" << nSeeds;
+				EXPECT_DOUBLE_EQ(res.distance, ref.distance);
+			}
+		}
+	}
+}
+
+TEST(DataAssociation, JCBBTimeBudget)
+{
+	CMatrixDouble y, y_cov, z;
+	clutteredScene(60, 60, y, y_cov, z);
+
+	TJCBBOptions opts;
+	opts.timeBudget = 0.05;
+	opts.ransacSeedIterations = 10;
+
+	TDataAssociationResults res;
+	data_association_independent_predictions(
+		z, y, y_cov, res, assocJCBB, metricMaha, 0.99, false, {}, metricMaha,
+		0.0, opts);
+	EXPECT_TRUE(res.JCBB_timedOut);
+	// At least, the seed hypothesis:
+	EXPECT_GT(res.associations.size(), 30U);
+
+	std::set<prediction_index_t> preds;
+	for (const auto& a : res.associations)
+	{
+		EXPECT_TRUE(res.indiv_compatibility(a.second, a.first));
+		EXPECT_TRUE(preds.insert(a.second).second);
+	}
+}
@@ -9,10 +9,13 @@
 
 #include "slam-precomp.h"  // Precompiled headers
 //
+#include <mrpt/core/WorkerThreadsPool.h>
 #include <mrpt/maps/CPointsMap.h>
 #include <mrpt/obs/CObservation2DRangeScan.h>
 #include <mrpt/slam/observations_overlap.h>
 
+#include <thread>
+
 using namespace mrpt::slam;
 using namespace mrpt::maps;
 using namespace mrpt::obs;
@@ -41,18 +44,10 @@ double mrpt::slam::observationsOverlap(
 		CPose3D otherObsPose;
 		if (pose_o2_wrt_o1) otherObsPose = *pose_o2_wrt_o1;
 
-		mrpt::tfest::TMatchingPairList correspondences;
-		mrpt::maps::TMatchingParams matchParams;
-		mrpt::maps::TMatchingExtraResults matchExtraResults;
-
-		matchParams.maxDistForCorrespondence = 0.04f;
-		matchParams.maxAngularDistForCorrespondence = 0;
-		map1->determineMatching3D(
-			map2,  // The other map
-			otherObsPose,  // The other map pose
-			correspondences, matchParams, matchExtraResults);
-
-		return matchExtraResults.correspondencesRatio;
+		// The ratio of points of map2 with a correspondence in map1:
+		mrpt::maps::TMatchingRatioParams mrp;
+		mrp.maxDistForCorr = 0.04f;
+		return map1->compute3DMatchingRatio(map2, otherObsPose, mrp);
 	}
 	else
 	{
@@ -69,7 +64,7 @@ double mrpt::slam::observationsOverlap(
  */
 double mrpt::slam::observationsOverlap(
 	const mrpt::obs::CSensoryFrame& sf1, const mrpt::obs::CSensoryFrame& sf2,
-	[[maybe_unused]] const mrpt::poses::CPose3D* pose_sf2_wrt_sf1)
+	const mrpt::poses::CPose3D* pose_sf2_wrt_sf1)
 {
 	// Return the average value:
 	size_t N = 0;
@@ -78,9 +73,247 @@ double mrpt::slam::observationsOverlap(
 	{
 		for (const auto& i2 : sf2)
 		{
-			accum += observationsOverlap(i1, i2);
+			accum += observationsOverlap(i1, i2, pose_sf2_wrt_sf1);
 			N++;
 		}
 	}
 	return N ? (accum / N) : 0;
 }
+
+// ------------------------------------------------------------------------
+//  CObservationsOverlapCache
+// ------------------------------------------------------------------------
+void CObservationsOverlapCache::setParams(
+	const TObservationsOverlapParams& params)
+{
+	std::lock_guard<std::mutex> lck(m_mtx);
+	if (params.decimation != m_params.decimation) m_entries.clear();
+	m_params = params;
+}
+
+TObservationOverlapPoints::Ptr CObservationsOverlapCache::getPoints(
+	const CObservation::Ptr& obs)
+{
+	MRPT_START
+	ASSERT_(obs);
+
+	{
+		std::lock_guard<std::mutex> lck(m_mtx);
+		const auto it = m_entries.find(obs.get());
+		if (it != m_entries.end() && it->second.obs.lock() == obs)
+			return it->second.points;
+	}
+
+	// Build them out of the lock, since it may take a while:
+	auto pts = std::make_shared<TObservationOverlapPoints>();
+	if (pts->points.insertObservation(*obs) && !pts->points.empty())
+	{
+		const auto& m = pts->points;
+		const auto &mx = m.getPointsBufferRef_x(),
+				   &my = m.getPointsBufferRef_y(),
+				   &mz = m.getPointsBufferRef_z();
+		const size_t dec = std::max<size_t>(1, m_params.decimation);
+		for (size_t i = 0; i < m.size(); i += dec)
+		{
+			pts->xs.push_back(mx[i]);
+			pts->ys.push_back(my[i]);
+			pts->zs.push_back(mz[i]);
+		}
+		// Build the bounding box and KD-tree now, before being shared:
+		pts->bbox = m.boundingBox();
+		float dummyDistSqr;
+		m.kdTreeClosestPoint3D(0, 0, 0, dummyDistSqr);
+	}
+	else
+		pts.reset();
+
+	std::lock_guard<std::mutex> lck(m_mtx);
+	// Remove the entries of destroyed observations from time to time:
+	if (m_entries.size() >= m_nextPurgeSize)
+	{
+		for (auto it = m_entries.begin(); it != m_entries.end();)
+		{
+			if (it->second.obs.expired()) it = m_entries.erase(it);
+			else
+				++it;
+		}
+		m_nextPurgeSize = std::max<size_t>(64, 2 * m_entries.size());
+	}
+	auto& e = m_entries[obs.get()];
+	e.obs = obs;
+	e.points = pts;
+	return pts;
+
+	MRPT_END
+}
+
+size_t CObservationsOverlapCache::size() const
+{
+	std::lock_guard<std::mutex> lck(m_mtx);
+	return m_entries.size();
+}
+
+void CObservationsOverlapCache::clear()
+{
+	std::lock_guard<std::mutex> lck(m_mtx);
+	m_entries.clear();
+}
+
+namespace
+{
+/** Ratio of the decimated points of `query`, at `pose` with respect to
+ * `ref`, with a point of `ref` closer than `maxDist`. */
+double overlapRatio(
+	const TObservationOverlapPoints& ref,
+	const TObservationOverlapPoints& query, const CPose3D& pose,
+	float maxDist)
+{
+	const size_t N = query.xs.size();
+	if (!N) return 0;
+
+	thread_local std::vector<float> xs, ys, zs;
+	xs.resize(N);
+	ys.resize(N);
+	zs.resize(N);
+	pose.composePoints(
+		query.xs.data(), query.ys.data(), query.zs.data(), xs.data(),
+		ys.data(), zs.data(), N);
+
+	auto bbQuery = mrpt::math::TBoundingBoxf::PlusMinusInfinity();
+	for (size_t i = 0; i < N; i++)
+		bbQuery.updateWithPoint({xs[i], ys[i], zs[i]});
+	if (!bbQuery.intersection(ref.bbox, maxDist).has_value()) return 0;
+
+	const float maxDistSqr = mrpt::square(maxDist);
+	size_t nMatched = 0;
+	for (size_t i = 0; i < N; i++)
+	{
+		float distSqr;
+		ref.points.kdTreeClosestPoint3D(xs[i], ys[i], zs[i], distSqr);
+		if (distSqr < maxDistSqr) nMatched++;
+	}
+	return static_cast<double>(nMatched) / N;
+}
+
+double overlapOfPoints(
+	const TObservationOverlapPoints& p1, const TObservationOverlapPoints& p2,
+	const CPose3D& pose2wrt1, const TObservationsOverlapParams& params)
+{
+	const double r = overlapRatio(
+		p1, p2, pose2wrt1, params.maxDistForCorrespondence);
+	if (!params.symmetric) return r;
+	return 0.5 *
+		(r +
+		 overlapRatio(p2, p1, -pose2wrt1, params.maxDistForCorrespondence));
+}
+
+/** Points of all the observations of a SF that have them */
+std::vector<TObservationOverlapPoints::Ptr> sensoryFramePoints(
+	CObservationsOverlapCache& cache, const CSensoryFrame& sf)
+{
+	std::vector<TObservationOverlapPoints::Ptr> pts;
+	for (const auto& o : sf)
+		if (auto p = cache.getPoints(o); p) pts.emplace_back(std::move(p));
+	return pts;
+}
+
+double overlapOfSensoryFrames(
+	const std::vector<TObservationOverlapPoints::Ptr>& sf1,
+	const std::vector<TObservationOverlapPoints::Ptr>& sf2,
+	const CPose3D& pose2wrt1, const TObservationsOverlapParams& params)
+{
+	double accum = 0;
+	for (const auto& p1 : sf1)
+		for (const auto& p2 : sf2)
+			accum += overlapOfPoints(*p1, *p2, pose2wrt1, params);
+	const size_t N = sf1.size() * sf2.size();
+	return N ? (accum / N) : 0;
+}
+
+/** Runs fn(i) for i in [0,N) in the number of threads of `params` */
+template <typename F>
+void runInParallel(size_t N, const TObservationsOverlapParams& params, F fn)
+{
+	size_t numThreads = params.numThreads;
+	if (!numThreads)
+		numThreads = std::max(1U, std::thread::hardware_concurrency());
+	numThreads = std::min(numThreads, N);
+
+	if (numThreads <= 1)
+	{
+		for (size_t i = 0; i < N; i++)
+			fn(i);
+		return;
+	}
+	// The calling thread also runs tasks in parallel_for():
+	mrpt::WorkerThreadsPool pool(
+		numThreads - 1, mrpt::WorkerThreadsPool::POLICY_FIFO, "obs_overlap");
+	pool.parallel_for(0, N, 1, fn);
+}
+}  // namespace
+
+double mrpt::slam::observationsOverlap(
+	CObservationsOverlapCache& cache, const CObservation::Ptr& o1,
+	const CObservation::Ptr& o2, const CPose3D* pose_o2_wrt_o1)
+{
+	const auto p1 = cache.getPoints(o1), p2 = cache.getPoints(o2);
+	if (!p1 || !p2) return 0;
+	return overlapOfPoints(
+		*p1, *p2, pose_o2_wrt_o1 ? *pose_o2_wrt_o1 : CPose3D(),
+		cache.params());
+}
+
+double mrpt::slam::observationsOverlap(
+	CObservationsOverlapCache& cache, const CSensoryFrame& sf1,
+	const CSensoryFrame& sf2, const CPose3D* pose_sf2_wrt_sf1)
+{
+	return overlapOfSensoryFrames(
+		sensoryFramePoints(cache, sf1), sensoryFramePoints(cache, sf2),
+		pose_sf2_wrt_sf1 ? *pose_sf2_wrt_sf1 : CPose3D(), cache.params());
+}
+
+std::vector<double> mrpt::slam::observationsOverlapBatch(
+	CObservationsOverlapCache& cache, const CObservation::Ptr& o1,
+	const std::vector<CObservation::Ptr>& others,
+	const std::vector<CPose3D>& poses_wrt_o1)
+{
+	MRPT_START
+	ASSERT_(poses_wrt_o1.empty() || poses_wrt_o1.size() == others.size());
+
+	std::vector<double> overlaps(others.size(), 0.0);
+	const auto p1 = cache.getPoints(o1);
+	if (!p1) return overlaps;
+
+	runInParallel(others.size(), cache.params(), [&](size_t i) {
+		const auto p2 = cache.getPoints(others[i]);
+		if (!p2) return;
+		overlaps[i] = overlapOfPoints(
+			*p1, *p2, poses_wrt_o1.empty() ? CPose3D() : poses_wrt_o1[i],
+			cache.params());
+	});
+	return overlaps;
+	MRPT_END
+}
+
+std::vector<double> mrpt::slam::observationsOverlapBatch(
+	CObservationsOverlapCache& cache, const CSensoryFrame& sf1,
+	const std::vector<CSensoryFrame::Ptr>& others,
+	const std::vector<CPose3D>& poses_wrt_sf1)
+{
+	MRPT_START
+	ASSERT_(poses_wrt_sf1.empty() || poses_wrt_sf1.size() == others.size());
+
+	std::vector<double> overlaps(others.size(), 0.0);
+	const auto pts1 = sensoryFramePoints(cache, sf1);
+	if (pts1.empty()) return overlaps;
+
+	runInParallel(others.size(), cache.params(), [&](size_t i) {
+		ASSERT_(others[i]);
+		overlaps[i] = overlapOfSensoryFrames(
+			pts1, sensoryFramePoints(cache, *others[i]),
+			poses_wrt_sf1.empty() ? CPose3D() : poses_wrt_sf1[i],
+			cache.params());
+	});
+	return overlaps;
+	MRPT_END
+}
@@ -0,0 +1,98 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/maps/CSimpleMap.h>
+#include <mrpt/obs/CObservation2DRangeScan.h>
+#include <mrpt/slam/observations_overlap.h>
+#include <mrpt/system/filesystem.h>
+#include <test_mrpt_common.h>
+
+using namespace mrpt::slam;
+using namespace mrpt::obs;
+using namespace mrpt::poses;
+
+TEST(observations_overlap, cacheAndBatch)
+{
+	const std::string map_file = mrpt::UNITTEST_BASEDIR +
+		std::string("/share/mrpt/datasets/malaga-cs-fac-building.simplemap.gz");
+	ASSERT_FILE_EXISTS_(map_file);
+
+	mrpt::maps::CSimpleMap sm;
+	sm.loadFromFile(map_file);
+
+	// The first 2D scans, and their poses wrt the first one:
+	std::vector<CObservation::Ptr> scans;
+	std::vector<CSensoryFrame::Ptr> sfs;
+	std::vector<CPose3D> poses;
+	for (size_t i = 0; i < sm.size() && scans.size() < 20; i++)
+	{
+		const auto& [posePDF, sf] = sm.getAsPair(i);
+		const auto scan = sf->getObservationByClass<CObservation2DRangeScan>();
+		if (!scan) continue;
+		scans.push_back(scan);
+		sfs.push_back(sf);
+		poses.push_back(posePDF->getMeanVal());
+	}
+	ASSERT_GT(scans.size(), 5U);
+	for (size_t i = poses.size(); i-- > 0;)
+		poses[i] = poses[i] - poses[0];
+
+	CObservationsOverlapCache cache;
+	std::vector<double> overlaps;
+	for (size_t i = 0; i < scans.size(); i++)
+	{
+		overlaps.push_back(
+			observationsOverlap(cache, scans[0], scans[i], &poses[i]));
+		EXPECT_NEAR(
+			overlaps.back(),
+			observationsOverlap(scans[0], scans[i], &poses[i]), 1e-6);
+	}
+	EXPECT_DOUBLE_EQ(overlaps[0], 1.0);
+	EXPECT_GT(overlaps[1], 0.1);
+	EXPECT_EQ(cache.size(), scans.size());
+
+	// Batches, in parallel:
+	auto params = cache.params();
+	params.numThreads = 4;
+	cache.setParams(params);
+	EXPECT_EQ(cache.size(), scans.size());
+	EXPECT_EQ(
+		observationsOverlapBatch(cache, scans[0], scans, poses), overlaps);
+
+	const auto sfOverlaps =
+		observationsOverlapBatch(cache, *sfs[0], sfs, poses);
+	ASSERT_EQ(sfOverlaps.size(), sfs.size());
+	for (size_t i = 0; i < sfs.size(); i++)
+		EXPECT_DOUBLE_EQ(
+			sfOverlaps[i],
+			observationsOverlap(cache, *sfs[0], *sfs[i], &poses[i]));
+
+	// Symmetric overlap (up to round-off errors of the inverse poses):
+	params.symmetric = true;
+	cache.setParams(params);
+	const auto symOverlaps =
+		observationsOverlapBatch(cache, scans[0], scans, poses);
+	for (size_t i = 0; i < scans.size(); i++)
+	{
+		const CPose3D inv = -poses[i];
+		EXPECT_NEAR(
+			symOverlaps[i],
+			observationsOverlap(cache, scans[i], scans[0], &inv), 1e-2);
+	}
+
+	// Decimation discards the cached points:
+	params.decimation = 4;
+	cache.setParams(params);
+	EXPECT_EQ(cache.size(), 0U);
+	const auto p = cache.getPoints(scans[0]);
+	ASSERT_TRUE(p);
+	EXPECT_EQ(p->xs.size(), (p->points.size() + 3) / 4);
+	EXPECT_EQ(cache.getPoints(scans[0]), p);
+}
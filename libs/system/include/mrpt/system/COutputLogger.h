@@ -15,6 +15,7 @@
 #include <mrpt/typemeta/TEnumType.h>
 
 #include <array>
+#include <cstdint>
 #include <deque>
 #include <functional>
 #include <iosfwd>
@@ -117,6 +118,9 @@ using output_logger_callback_t = std::function<void(
  * logging_enable_console_output class variable if that's not the desired
  * behavior
  *
+ * Console output and user callbacks can be moved out of the calling thread
+ * with logEnableAsyncOutput(), for loggers used in high-rate loops.
+ *
  * \note [New in MRPT 1.5.0]
  * \sa TMsg
  * \ingroup mrpt_system_grp
@@ -255,6 +259,34 @@ class COutputLogger
 	void logRegisterCallback(output_logger_callback_t userFunc);
 	/** \return true if an entry was found and deleted. */
 	bool logDeregisterCallback(output_logger_callback_t userFunc);
+
+	/** Enables (or disables) the asynchronous output of this logger: the
+	 * messages to be shown in the console and sent to the user callbacks are
+	 * copied into a preallocated lock-free buffer, and a background thread
+	 * (shared by all asynchronous loggers) decorates them with their timestamp
+	 * and level, writes them to the console and invokes the callbacks. Hence,
+	 * logStr() never waits for console I/O or callbacks.
+	 *
+	 * If the buffer is full, LVL_ERROR messages wait for free space, while
+	 * the rest are dropped (see logAsyncDroppedMessages()). Callbacks are
+	 * invoked from the background thread, and should be registered before
+	 * enabling this mode. Copies of this object keep using the asynchronous
+	 * output.
+	 *
+	 * \sa logFlush
+	 * \note (New in MRPT 2.4.9)
+	 */
+	void logEnableAsyncOutput(bool enable = true);
+	bool isLogAsyncOutputEnabled() const { return m_async != nullptr; }
+
+	/** Waits until all the messages of asynchronous loggers, logged so far,
+	 * have been output. Called from the destructor. Does nothing for loggers
+	 * without asynchronous output. \sa logEnableAsyncOutput */
+	void logFlush() const;
+
+	/** Number of messages dropped by asynchronous loggers due to a full
+	 * buffer. \sa logEnableAsyncOutput */
+	uint64_t logAsyncDroppedMessages() const;
 	/** @} */
 
    protected:
@@ -312,6 +344,9 @@ class COutputLogger
 		std::string body; /**< Actual content of the message. */
 	};
 
+	/** Writes a message to the console and sends it to user callbacks */
+	void dispatchMsg(const TMsg& msg) const;
+
 	/** Helper method for generating a std::string instance from printf-like
 	 * arguments */
 	std::string generateStringFromFormat(
@@ -323,6 +358,10 @@ class COutputLogger
 	std::shared_ptr<std::mutex> m_historyMtx = std::make_shared<std::mutex>();
 
 	std::deque<output_logger_callback_t> m_listCallbacks;
+
+	/** Background thread and message buffer for asynchronous output */
+	struct TAsyncBackend;
+	std::shared_ptr<TAsyncBackend> m_async;
 };
 
 /** For use in MRPT_LOG_DEBUG_STREAM(), etc. */
@@ -358,13 +397,22 @@ struct COutputLoggerStreamWrapper
 	const COutputLogger& m_logger;
 };
 
-#define INTERNAL_MRPT_LOG(_LVL, _STRING) this->logStr(_LVL, _STRING)
+// The message is not even evaluated if it is not going to be used:
+#define INTERNAL_MRPT_LOG(_LVL, _STRING)                                       \
+	do                                                                         \
+	{                                                                          \
+		if (this->isLoggingLevelVisible(_LVL) ||                               \
+			this->logging_enable_keep_record)                                  \
+		{ this->logStr(_LVL, _STRING); }                                       \
+	} while (0)
 
 #define INTERNAL_MRPT_LOG_ONCE(_LVL, _STRING)                                  \
 	do                                                                         \
 	{                                                                          \
 		static bool once_flag = false;                                         \
-		if (!once_flag)                                                        \
+		if (!once_flag &&                                                      \
+			(this->isLoggingLevelVisible(_LVL) ||                              \
+			 this->logging_enable_keep_record))                                \
 		{                                                                      \
 			once_flag = true;                                                  \
 			this->logStr(_LVL, _STRING);                                       \
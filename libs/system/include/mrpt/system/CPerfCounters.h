@@ -0,0 +1,125 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+namespace mrpt::system
+{
+/** Values of the hardware performance counters read with CPerfCounters.
+ * Counters which are not available are reported as zero, and their ratios
+ * (ipc(), cacheMissRate(), branchMissRate()) as NaN.
+ * \ingroup mrpt_system_grp
+ * \note (New in MRPT 2.4.9)
+ */
+struct TPerfCounterValues
+{
+	enum Counter : uint8_t
+	{
+		CYCLES = 0,
+		INSTRUCTIONS,
+		CACHE_REFERENCES,
+		CACHE_MISSES,
+		BRANCHES,
+		BRANCH_MISSES,
+		COUNT
+	};
+
+	std::array<uint64_t, COUNT> values{};
+	/** Bit `i` is set if counter `i` is available */
+	uint8_t available = 0;
+
+	bool has(Counter c) const { return (available >> c) & 1; }
+	uint64_t operator[](Counter c) const { return values[c]; }
+
+	/** Instructions per cycle */
+	double ipc() const { return ratio(INSTRUCTIONS, CYCLES); }
+	/** Fraction of the last level cache references that missed */
+	double cacheMissRate() const
+	{
+		return ratio(CACHE_MISSES, CACHE_REFERENCES);
+	}
+	/** Fraction of the branches that were mispredicted */
+	double branchMissRate() const { return ratio(BRANCH_MISSES, BRANCHES); }
+
+	/** Difference of all counters (e.g. end minus start of a section) */
+	TPerfCounterValues operator-(const TPerfCounterValues& o) const;
+	/** Sum of all counters. Only those available in both are kept. */
+	TPerfCounterValues& operator+=(const TPerfCounterValues& o);
+
+	/** "IPC=1.23 cache-miss=4.5% branch-miss=0.6%", or "n/a" */
+	std::string asString() const;
+
+	static const char* CounterName(Counter c);
+
+   private:
+	double ratio(Counter num, Counter den) const;
+};
+
+/** Hardware performance counters (cycles, instructions, last level cache
+ * references and misses, branches and branch mispredictions) of the calling
+ * thread, from the Linux `perf_event_open()` syscall.
+ *
+ * The counters start counting upon construction, and read() returns their
+ * accumulated values, so the cost of a section of code is the difference of
+ * two reads:
+ * \code
+ *  mrpt::system::CPerfCounters pc;
+ *  const auto c0 = pc.read();
+ *  doSomething();
+ *  const auto c = pc.read() - c0;
+ *  std::cout << c.asString() << "\n";
+ * \endcode
+ *
+ * Counters are measured for the thread which created the object only (use
+ * one object per thread, see ThreadInstance()). The counters of each ratio
+ * are scheduled together; if the PMU has to multiplex them, values are
+ * scaled by the fraction of time they were actually counting.
+ *
+ * Counters are not available in other OSes, in virtual machines without a
+ * virtual PMU, or if forbidden by `/proc/sys/kernel/perf_event_paranoid`
+ * (values >2 forbid them for non-root users). In such cases available()
+ * is false, and read() returns values with no available counter.
+ *
+ * \sa CTimeLogger::enablePerfCounters()
+ * \ingroup mrpt_system_grp
+ * \note (New in MRPT 2.4.9)
+ */
+class CPerfCounters
+{
+   public:
+	CPerfCounters();
+	~CPerfCounters();
+
+	CPerfCounters(const CPerfCounters&) = delete;
+	CPerfCounters& operator=(const CPerfCounters&) = delete;
+
+	/** Whether at least one counter could be opened */
+	bool available() const { return m_available != 0; }
+
+	/** Current accumulated values since construction */
+	TPerfCounterValues read() const;
+
+	/** The instance for the calling thread, created upon first use */
+	static CPerfCounters& ThreadInstance();
+
+   private:
+	/** Counters are opened in groups of 2 (2*g, 2*g+1) */
+	static constexpr uint8_t NUM_GROUPS = TPerfCounterValues::COUNT / 2;
+
+	/** File descriptors of each counter, or -1. The first valid one of each
+	 * group is its leader. */
+	std::array<int, TPerfCounterValues::COUNT> m_fd;
+	/** Bit `i` is set if counter `i` was opened */
+	uint8_t m_available = 0;
+};
+
+}  // namespace mrpt::system
@@ -11,10 +11,14 @@
 #include <mrpt/containers/ts_hash_map.h>
 #include <mrpt/core/exceptions.h>
 #include <mrpt/system/COutputLogger.h>
+#include <mrpt/system/CPerfCounters.h>
 #include <mrpt/system/CTicTac.h>
 
+#include <cstdint>
 #include <deque>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <stack>
 #include <vector>
@@ -43,6 +47,36 @@ namespace mrpt::system
  * the latter case (and, actually, in general since it's safer against
  * exceptions), use the RAII helper class CTimeLoggerEntry.
  *
+ * <b>Low overhead sections:</b> Each call to `enter(name)`/`leave(name)`
+ * looks up the section name in a table shared by all threads. For short
+ * functions in hot loops, register the section once with registerSection()
+ * and use the returned ID instead. Calls with section IDs only touch data
+ * owned by the calling thread (no shared locks, no contention), which is
+ * merged into the global stats only when they are queried or printed.
+ * In addition, setSamplingPeriod() can make them time only one of every N
+ * calls (all of them are still counted).
+ * \code
+ * static const auto SEC_ID = logger.registerSection("myFunction");
+ * {
+ *     CTimeLoggerEntry tle(logger, SEC_ID);
+ *     ...
+ * }
+ * \endcode
+ *
+ * <b>Tracing:</b> enableTracing() makes calls to all sections (by name or
+ * ID) to be also recorded as individual events, one timeline per thread,
+ * which can be saved with saveToChromeTrace() and inspected as flame charts
+ * with [Perfetto](https://ui.perfetto.dev) or `chrome://tracing`. Events
+ * follow the same sampling period as ID sections.
+ *
+ * <b>Hardware counters:</b> enablePerfCounters() makes CTimeLoggerEntry
+ * scopes to also measure the CPU cycles, instructions, cache and branch
+ * misses of the calling thread (see CPerfCounters), reported as the IPC and
+ * miss rates of each section by getStatsAsText() and getStats(). This
+ * tells apart memory-bound (low IPC, high cache-miss rate) from
+ * compute-bound sections. Where counters are not available, it has no
+ * effect.
+ *
  * \sa CTimeLoggerEntry
  *
  * \note The default behavior is dumping all the information at destruction.
@@ -64,6 +98,7 @@ class CTimeLogger : public mrpt::system::COutputLogger
 		std::stack<double, std::vector<double>> open_calls;
 		bool has_time_units{true};
 		std::optional<std::deque<double>> whole_history{};
+		std::optional<TPerfCounterValues> counters{};
 
 		// Each instance holds its own mutex, even after = operations.
 		std::mutex mtx;
@@ -83,6 +118,7 @@ class CTimeLogger : public mrpt::system::COutputLogger
 			open_calls = d.open_calls;
 			has_time_units = d.has_time_units;
 			whole_history = d.whole_history;
+			counters = d.counters;
 			return *this;
 		}
 		TCallData& operator=(TCallData&& d)
@@ -95,6 +131,7 @@ class CTimeLogger : public mrpt::system::COutputLogger
 			open_calls = std::move(d.open_calls);
 			has_time_units = d.has_time_units;
 			whole_history = std::move(d.whole_history);
+			counters = d.counters;
 			return *this;
 		}
 	};
@@ -106,11 +143,49 @@ class CTimeLogger : public mrpt::system::COutputLogger
 	using TDataMap = mrpt::containers::ts_hash_map<
 		std::string, TCallData, HASH_SIZE_IN_BYTES, HASH_ALLOWED_COLLISIONS>;
 
-	TDataMap m_data;
+	// Mutable, since const methods merge into it the per-thread data
+	mutable TDataMap m_data;
 
 	void do_enter(const std::string_view& func_name) noexcept;
 	double do_leave(const std::string_view& func_name) noexcept;
 
+   public:
+	/** Identifier of a section, see registerSection()
+	 * \note (New in MRPT 2.4.9) */
+	using section_id_t = uint32_t;
+
+   private:
+	/** Per-thread data of ID sections and trace events (see .cpp) */
+	struct TThreadData;
+
+	std::vector<std::string> m_sectionNames;  //!< Indexed by section_id_t
+	std::map<std::string, section_id_t, std::less<>> m_sectionIDs;
+	std::vector<std::unique_ptr<TThreadData>> m_threadData;
+	/** For m_sectionNames, m_sectionIDs and m_threadData */
+	mutable std::mutex m_threadDataMtx;
+	/** Unique among all instances ever created, used by threads to find
+	 * their TThreadData */
+	uint64_t m_uid;
+	unsigned int m_samplingPeriod{1};
+	bool m_tracing{false};
+	size_t m_maxTraceEventsPerThread{1000000};
+	bool m_perfCounters{false};
+
+	TThreadData& threadData() noexcept;
+	void do_enter(section_id_t id) noexcept;
+	double do_leave(section_id_t id) noexcept;
+	void addTraceEvent(
+		const std::string_view& name, double t_start, double t_len) noexcept;
+	void addPerfCounters(
+		const std::string_view& name, const TPerfCounterValues& c) noexcept;
+	void addPerfCounters(
+		section_id_t id, const TPerfCounterValues& c) noexcept;
+
+   protected:
+	/** Merges the data of all threads for sections used via IDs into
+	 * m_data */
+	void mergeThreadData() const;
+
    public:
 	/** Data of each call section: # of calls, minimum, maximum, average and
 	 * overall execution time (in seconds) \sa getStats */
@@ -118,6 +193,9 @@ class CTimeLogger : public mrpt::system::COutputLogger
 	{
 		size_t n_calls{0};
 		double min_t{0}, max_t{0}, mean_t{0}, total_t{0}, last_t{0};
+		/** Hardware counters of all the calls, if enablePerfCounters()
+		 * \note (New in MRPT 2.4.9) */
+		std::optional<TPerfCounterValues> counters;
 	};
 
 	CTimeLogger(
@@ -128,10 +206,10 @@ class CTimeLogger : public mrpt::system::COutputLogger
 
 	// We must define these 4 because of the definition of a virtual dtor
 	// (compiler will not generate the defaults)
-	CTimeLogger(const CTimeLogger& o) = default;
-	CTimeLogger& operator=(const CTimeLogger& o) = default;
-	CTimeLogger(CTimeLogger&& o) = default;
-	CTimeLogger& operator=(CTimeLogger&& o) = default;
+	CTimeLogger(const CTimeLogger& o);
+	CTimeLogger& operator=(const CTimeLogger& o);
+	CTimeLogger(CTimeLogger&& o);
+	CTimeLogger& operator=(CTimeLogger&& o);
 
 	/** Dump all stats to a multi-line text string. \sa dumpAllStats,
 	 * saveToCVSFile */
@@ -187,6 +265,67 @@ class CTimeLogger : public mrpt::system::COutputLogger
 	{
 		return m_enabled ? do_leave(func_name) : 0;
 	}
+
+	/** Registers a section name (or returns its ID if already registered),
+	 * for use in the low overhead enter(section_id_t) / leave(section_id_t).
+	 * IDs remain valid during the whole life of the object, even after
+	 * clear().
+	 * \note (New in MRPT 2.4.9) */
+	section_id_t registerSection(const std::string_view& name);
+
+	/** Start of a section given by its ID \sa registerSection
+	 * \note (New in MRPT 2.4.9) */
+	inline void enter(section_id_t id) noexcept
+	{
+		if (m_enabled) do_enter(id);
+	}
+	/** End of a section given by its ID. \return The ellapsed time, in
+	 * seconds, or 0 if disabled or the call was not sampled.
+	 * \note (New in MRPT 2.4.9) */
+	inline double leave(section_id_t id) noexcept
+	{
+		return m_enabled ? do_leave(id) : 0;
+	}
+
+	/** Makes sections given by ID, and trace events, to be timed only once
+	 * every `period` calls (default=1, all calls). Statistics of the timed
+	 * calls are extrapolated to the total number of calls.
+	 * \note Set it before starting to use the logger from several threads.
+	 * \note (New in MRPT 2.4.9) */
+	void setSamplingPeriod(unsigned int period)
+	{
+		m_samplingPeriod = period < 1 ? 1 : period;
+	}
+	unsigned int getSamplingPeriod() const { return m_samplingPeriod; }
+
+	/** Enables recording each (sampled) call as a trace event, to be saved
+	 * later with saveToChromeTrace(). Once `maxEventsPerThread` are
+	 * recorded by a thread, its later events are dropped.
+	 * \note Set it before starting to use the logger from several threads.
+	 * \note (New in MRPT 2.4.9) */
+	void enableTracing(bool enable = true, size_t maxEventsPerThread = 1000000)
+	{
+		m_tracing = enable;
+		m_maxTraceEventsPerThread = maxEventsPerThread;
+	}
+	bool isEnabledTracing() const { return m_tracing; }
+
+	/** Enables measuring hardware performance counters in CTimeLoggerEntry
+	 * scopes (see CPerfCounters). Reading the counters costs about one
+	 * microsecond per scope. If they are not available, it has no effect
+	 * (and isEnabledPerfCounters() returns false).
+	 * \note Set it before starting to use the logger from several threads.
+	 * \note (New in MRPT 2.4.9) */
+	void enablePerfCounters(bool enable = true);
+	bool isEnabledPerfCounters() const { return m_perfCounters; }
+
+	/** Saves all trace events recorded so far (see enableTracing()) as a
+	 * Chrome Trace Event Format JSON file, with one timeline per thread,
+	 * which can be opened with [Perfetto](https://ui.perfetto.dev) or
+	 * `chrome://tracing`.
+	 * \exception std::exception On error creating the file.
+	 * \note (New in MRPT 2.4.9) */
+	void saveToChromeTrace(const std::string& json_file) const;
 	/** Return the mean execution time of the given "section", or 0 if it hasn't
 	 * ever been called "enter" with that section name */
 	double getMeanTime(const std::string& name) const;
@@ -232,6 +371,10 @@ struct CTimeLoggerEntry
 {
 	CTimeLoggerEntry(
 		const CTimeLogger& logger, const std::string_view& section_name);
+	/** Uses a section registered with CTimeLogger::registerSection(), for
+	 * lower overhead. \note (New in MRPT 2.4.9) */
+	CTimeLoggerEntry(
+		const CTimeLogger& logger, CTimeLogger::section_id_t section_id);
 	~CTimeLoggerEntry();
 	CTimeLogger& m_logger;
 	void stop();  //!< for correct use, see docs for CTimeLoggerEntry
@@ -240,8 +383,10 @@ struct CTimeLoggerEntry
 	// Note we cannot store the string_view since we have no guarantees of the
 	// life-time of the provided string buffer.
 	const std::string m_section_name;
+	std::optional<CTimeLogger::section_id_t> m_section_id;
 	double m_entry = 0;
 	bool stopped_{false};
+	std::optional<TPerfCounterValues> m_counters;
 };
 
 /** A helper class to save CSV stats upon self destruction, for example, at the
@@ -0,0 +1,132 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+namespace mrpt::system
+{
+/** \addtogroup text_parsing Fast parsing of numbers and lines of text
+ * Parsing of large numeric text files (ground truth files, point clouds,
+ * matrices,...) held in memory (e.g. in a mrpt::io::CMemoryMappedFile),
+ * without stream or string copies, and optionally in parallel chunks.
+ * Numbers are converted with `std::from_chars()` if the standard library
+ * supports it for floating point types, or `strtod()` otherwise.
+ *
+ * Header: `#include <mrpt/system/text_parsing.h>`.
+ * Library: \ref mrpt_system_grp
+ * \note (New in MRPT 2.4.9)
+ * \ingroup mrpt_system_grp
+ * @{ */
+
+/** Converts the number at the beginning of `[first,last)`, with the same
+ * syntax than `strtod()` in the "C" locale (an optional sign, decimal or
+ * scientific notation, "inf" or "nan"), except hexadecimal numbers. Leading
+ * blanks are not skipped.
+ * \return A pointer past the number, or `first` if there is no valid number
+ * (then, `out` is not modified).
+ */
+const char* parse_number(const char* first, const char* last, double& out);
+/// \overload
+const char* parse_number(const char* first, const char* last, float& out);
+
+/** Whether `c` separates numbers in parse_numbers(): blanks or commas */
+constexpr bool is_number_separator(char c)
+{
+	return c == ' ' || c == ',' || c == '\t' || c == '\r' || c == '\n';
+}
+
+/** Parses up to `maxCount` numbers separated by blanks or commas (see
+ * is_number_separator()) at the beginning of `s`, stopping at the first
+ * token which is not a number.
+ * \return The number of values stored in `out`.
+ */
+template <typename T>
+size_t parse_numbers(std::string_view s, T* out, size_t maxCount)
+{
+	const char* p = s.data();
+	const char* const end = p + s.size();
+	size_t n = 0;
+	while (n < maxCount)
+	{
+		while (p != end && is_number_separator(*p))
+			++p;
+		const char* next = parse_number(p, end, out[n]);
+		if (next == p) break;
+		p = next;
+		n++;
+	}
+	return n;
+}
+
+/** Like parse_numbers(std::string_view,T*,size_t), appending all the numbers
+ * to a vector.
+ * \return The number of values appended to `out`.
+ */
+template <typename T>
+size_t parse_numbers(std::string_view s, std::vector<T>& out)
+{
+	const char* p = s.data();
+	const char* const end = p + s.size();
+	const size_t n0 = out.size();
+	for (;;)
+	{
+		while (p != end && is_number_separator(*p))
+			++p;
+		T v;
+		const char* next = parse_number(p, end, v);
+		if (next == p) break;
+		p = next;
+		out.push_back(v);
+	}
+	return out.size() - n0;
+}
+
+/** Calls `fn(line)` with each line of a text as a `std::string_view`, split
+ * at `'\n'` like `std::getline()` does, and without the trailing `'\r'` of
+ * DOS line ends. `fn` returns false to stop.
+ * \return false if stopped by `fn`.
+ */
+template <class FUNCTOR>
+bool for_each_line(std::string_view text, FUNCTOR&& fn)
+{
+	while (!text.empty())
+	{
+		const size_t eol = text.find('\n');
+		std::string_view line = text.substr(0, eol);
+		if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+		if (!fn(line)) return false;
+		if (eol == std::string_view::npos) break;
+		text.remove_prefix(eol + 1);
+	}
+	return true;
+}
+
+/** Removes leading and trailing blanks (spaces and tabs), like trim() */
+std::string_view trim_view(std::string_view s);
+
+/** A fragment of a text, made of whole lines \sa split_text_into_chunks */
+struct TTextChunk
+{
+	std::string_view text;
+	/** Line number of the first line in the chunk (first line=1) */
+	size_t firstLine = 1;
+};
+
+/** Splits a text into up to `numChunks` chunks of similar size, at line ends,
+ * to parse them in parallel. Chunks are not smaller than `minChunkSize`
+ * bytes (except the last one), so small texts give a single chunk.
+ */
+std::vector<TTextChunk> split_text_into_chunks(
+	std::string_view text, size_t numChunks, size_t minChunkSize = 1 << 20);
+
+/** @} */
+}  // namespace mrpt::system
@@ -9,17 +9,23 @@
 
 #include "system-precomp.h"	 // Precompiled headers
 //
+#include <mrpt/containers/lockfree_byte_ring.h>
 #include <mrpt/core/exceptions.h>
 #include <mrpt/core/lock_helper.h>
 #include <mrpt/system/COutputLogger.h>
 #include <mrpt/system/datetime.h>
 #include <mrpt/system/filesystem.h>
+#include <mrpt/system/thread_name.h>
 
+#include <atomic>
+#include <condition_variable>
 #include <cstdarg>	// for logFmt
 #include <cstdio>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <sstream>
+#include <thread>
 #include <vector>
 
 #ifdef _MSC_VER
@@ -66,29 +72,274 @@ std::array<std::string, NUMBER_OF_VERBOSITY_LEVELS>&
 	return ::logging_levels_to_names;
 }
 
-COutputLogger::~COutputLogger() = default;
+// Asynchronous output
+// ////////////////////////////////////////////////////////////
+
+/** Messages are written by any thread into a lock-free byte ring, as one
+ * block holding a TRecordHeader, the logger name and the message body, and
+ * are output by one thread shared by all asynchronous loggers. Records
+ * without a logger are flush markers. */
+struct COutputLogger::TAsyncBackend
+{
+	static constexpr size_t BUFFER_SIZE = 1024 * 1024;
+
+	struct TRecordHeader
+	{
+		const COutputLogger* logger;
+		mrpt::Clock::rep timestamp;
+		uint32_t level, nameLen, bodyLen;
+	};
+
+	/** The instance shared by all loggers, created on demand and destroyed
+	 * with the last logger using it */
+	static std::shared_ptr<TAsyncBackend> Instance()
+	{
+		static std::mutex mtx;
+		static std::weak_ptr<TAsyncBackend> instance;
+
+		auto lck = mrpt::lockHelper(mtx);
+		auto ret = instance.lock();
+		if (!ret)
+		{
+			ret = std::make_shared<TAsyncBackend>();
+			instance = ret;
+		}
+		return ret;
+	}
+
+	TAsyncBackend()
+	{
+		m_thread = std::thread([this]() { run(); });
+		mrpt::system::thread_name("COutputLogger", m_thread);
+	}
+	~TAsyncBackend()
+	{
+		m_stop = true;
+		wakeUp();
+		if (m_thread.joinable()) m_thread.join();
+	}
+
+	/** Called from any thread. \return false if the message was dropped */
+	bool push(
+		const COutputLogger& logger, VerbosityLevel level,
+		mrpt::Clock::time_point timestamp, std::string_view body)
+	{
+		thread_local std::vector<uint8_t> buf;
+
+		const std::string& name = logger.m_logger_name;
+		TRecordHeader h;
+		h.logger = &logger;
+		h.timestamp = timestamp.time_since_epoch().count();
+		h.level = static_cast<uint32_t>(level);
+		h.nameLen = static_cast<uint32_t>(name.size());
+		h.bodyLen = static_cast<uint32_t>(body.size());
+		const size_t n = sizeof(h) + name.size() + body.size();
+
+		buf.resize(n);
+		std::memcpy(buf.data(), &h, sizeof(h));
+		std::memcpy(buf.data() + sizeof(h), name.data(), name.size());
+		std::memcpy(
+			buf.data() + sizeof(h) + name.size(), body.data(), body.size());
+
+		if (!write(buf.data(), n, level == LVL_ERROR))
+		{
+			m_dropped++;
+			return false;
+		}
+		return true;
+	}
+
+	/** Waits until all the messages pushed so far have been output */
+	void flush()
+	{
+		if (std::this_thread::get_id() == m_thread.get_id()) return;
+
+		// Records are published in order, so once this marker is processed,
+		// so are all the records pushed before:
+		TRecordHeader h;
+		h.logger = nullptr;
+		h.timestamp = ++m_flushRequested;
+		h.level = h.nameLen = h.bodyLen = 0;
+		write(&h, sizeof(h), true);
+
+		while (m_flushDone.load() < h.timestamp)
+		{
+			wakeUp();
+			std::this_thread::sleep_for(std::chrono::microseconds(100));
+		}
+	}
+
+	uint64_t dropped() const { return m_dropped.load(); }
+
+   private:
+	mrpt::containers::lockfree_byte_ring m_ring{BUFFER_SIZE};
+	std::atomic<mrpt::Clock::rep> m_flushRequested{0}, m_flushDone{0};
+	std::atomic<uint64_t> m_dropped{0};
+	uint64_t m_droppedReported = 0;
+	std::atomic_bool m_stop{false}, m_sleeping{false};
+	std::mutex m_wakeMtx;
+	std::condition_variable m_wakeCv;
+	std::thread m_thread;
+	std::vector<uint8_t> m_record;
+
+	bool write(const void* data, size_t n, bool waitIfFull)
+	{
+		if (n > m_ring.capacity()) return false;
+		while (!m_ring.write(data, n))
+		{
+			if (!waitIfFull) return false;
+			wakeUp();
+			std::this_thread::yield();
+		}
+
+		// The consumer sets m_sleeping and then checks the ring:
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (m_sleeping.load(std::memory_order_relaxed)) wakeUp();
+		return true;
+	}
+
+	void wakeUp()
+	{
+		// Do not notify between the consumer checks for new data and waits:
+		{
+			auto lck = mrpt::lockHelper(m_wakeMtx);
+		}
+		m_wakeCv.notify_one();
+	}
+
+	void run()
+	{
+		for (;;)
+		{
+			while (processOne())
+			{
+			}
+			reportDropped();
+			if (m_stop) break;
+
+			std::unique_lock<std::mutex> lck(m_wakeMtx);
+			m_sleeping = true;
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (m_ring.empty() && !m_stop)
+				m_wakeCv.wait_for(lck, std::chrono::milliseconds(50));
+			m_sleeping = false;
+		}
+	}
+
+	bool processOne()
+	{
+		// Records are published as a whole, so the header is enough:
+		TRecordHeader h;
+		if (m_ring.size() < sizeof(h)) return false;
+		m_ring.peek_many(reinterpret_cast<uint8_t*>(&h), sizeof(h));
+		if (!h.logger)
+		{
+			m_ring.discard(sizeof(h));
+			if (h.timestamp > m_flushDone.load()) m_flushDone = h.timestamp;
+			return true;
+		}
+
+		m_record.resize(sizeof(h) + h.nameLen + h.bodyLen);
+		m_ring.read(m_record.data(), m_record.size());
+		const auto* name = reinterpret_cast<const char*>(m_record.data()) +
+			sizeof(h);
+
+		TMsg msg(
+			static_cast<VerbosityLevel>(h.level),
+			std::string_view(name + h.nameLen, h.bodyLen), *h.logger);
+		msg.timestamp =
+			mrpt::Clock::time_point(mrpt::Clock::duration(h.timestamp));
+		msg.name.assign(name, h.nameLen);
+		try
+		{
+			h.logger->dispatchMsg(msg);
+		}
+		catch (const std::exception& e)
+		{
+			std::cerr << "[COutputLogger] Exception in asynchronous output:\n"
+					  << mrpt::exception_to_str(e);
+		}
+		return true;
+	}
+
+	void reportDropped()
+	{
+		const uint64_t n = m_dropped.load();
+		if (n == m_droppedReported) return;
+		std::cerr << "[COutputLogger] " << (n - m_droppedReported)
+				  << " messages dropped due to a full asynchronous buffer.\n";
+		m_droppedReported = n;
+	}
+};
+
+// COutputLogger
+// ////////////////////////////////////////////////////////////
+
+COutputLogger::~COutputLogger()
+{
+	// Pending asynchronous messages refer to this object:
+	logFlush();
+}
 
 void COutputLogger::logStr(
 	const VerbosityLevel level, std::string_view msg_str) const
 {
+	const bool visible =
+		level >= m_min_verbosity_level && logging_enable_console_output;
+	if (!visible && !logging_enable_keep_record) return;
+
 	// initialize a TMsg object
-	TMsg msg(level, msg_str, *this);
+	const auto now = mrpt::Clock::now();
 	if (logging_enable_keep_record)
 	{
+		TMsg msg(level, msg_str, *this);
+		msg.timestamp = now;
 		auto lck = mrpt::lockHelper(*m_historyMtx);
-		m_history.push_back(msg);
+		m_history.emplace_back(std::move(msg));
 	}
 
-	if (level >= m_min_verbosity_level && logging_enable_console_output)
+	if (!visible) return;
+	if (m_async)
 	{
-		msg.dumpToConsole();
+		m_async->push(*this, level, now, msg_str);
+		return;
+	}
+
+	TMsg msg(level, msg_str, *this);
+	msg.timestamp = now;
+	dispatchMsg(msg);
+}
+
+void COutputLogger::dispatchMsg(const TMsg& msg) const
+{
+	msg.dumpToConsole();
+
+	// User callbacks:
+	for (const auto& c : m_listCallbacks)
+		c(msg.body, msg.level, msg.name, msg.timestamp);
+}
 
-		// User callbacks:
-		for (const auto& c : m_listCallbacks)
-			c(msg.body, msg.level, msg.name, msg.timestamp);
+void COutputLogger::logEnableAsyncOutput(bool enable)
+{
+	if (enable == (m_async != nullptr)) return;
+	if (enable) { m_async = TAsyncBackend::Instance(); }
+	else
+	{
+		logFlush();
+		m_async.reset();
 	}
 }
 
+void COutputLogger::logFlush() const
+{
+	if (m_async) m_async->flush();
+}
+
+uint64_t COutputLogger::logAsyncDroppedMessages() const
+{
+	return m_async ? m_async->dropped() : 0;
+}
+
 void COutputLogger::logFmt(
 	const VerbosityLevel level, const char* fmt, ...) const
 {
@@ -203,7 +454,11 @@ void COutputLogger::getLoggerLastMsg(std::string& msg_str) const
 	msg_str = this->getLoggerLastMsg();
 }
 
-void COutputLogger::loggerReset() { *this = COutputLogger(); }
+void COutputLogger::loggerReset()
+{
+	logFlush();
+	*this = COutputLogger();
+}
 
 // TMsg Struct
 // ////////////////////////////////////////////////////////////
@@ -0,0 +1,109 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/system/COutputLogger.h>
+
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace mrpt::system;
+
+namespace
+{
+struct TestLogger : public COutputLogger
+{
+	TestLogger() : COutputLogger("TestLogger")
+	{
+		logRegisterCallback([this](
+								std::string_view msg, const VerbosityLevel,
+								std::string_view name,
+								const mrpt::Clock::time_point) {
+			EXPECT_EQ(name, "TestLogger");
+			std::lock_guard<std::mutex> lck(mtx);
+			msgs.emplace_back(msg);
+		});
+	}
+
+	std::string evaluate(const std::string& s)
+	{
+		evaluations++;
+		return s;
+	}
+	void logHidden()
+	{
+		MRPT_LOG_DEBUG(evaluate("debug"));
+		MRPT_LOG_ONCE_DEBUG(evaluate("debug"));
+		MRPT_LOG_DEBUG_STREAM(evaluate("debug"));
+		MRPT_LOG_WARN(evaluate("warn"));
+	}
+	void logMany(const std::string& prefix, int count)
+	{
+		for (int i = 0; i < count; i++)
+			MRPT_LOG_INFO_STREAM(prefix << i);
+	}
+
+	int evaluations = 0;
+	std::mutex mtx;
+	std::vector<std::string> msgs;
+};
+}  // namespace
+
+TEST(COutputLogger, hiddenMessagesAreNotEvaluated)
+{
+	TestLogger log;
+	log.logHidden();
+	EXPECT_EQ(log.evaluations, 1);
+	ASSERT_EQ(log.msgs.size(), 1U);
+	EXPECT_EQ(log.msgs[0], "warn");
+
+	// ...unless they are kept in the history:
+	log.logging_enable_keep_record = true;
+	log.logHidden();
+	EXPECT_EQ(log.evaluations, 4);
+	EXPECT_EQ(log.msgs.size(), 2U);
+	EXPECT_NE(log.getLogAsString().find("DEBUG"), std::string::npos);
+}
+
+TEST(COutputLogger, asyncOutput)
+{
+	const int nThreads = 4, nMsgs = 10;
+
+	TestLogger log;
+	log.logEnableAsyncOutput();
+	EXPECT_TRUE(log.isLogAsyncOutputEnabled());
+
+	std::vector<std::thread> threads;
+	for (int t = 0; t < nThreads; t++)
+		threads.emplace_back(
+			[&log, t]() { log.logMany(std::to_string(t) + ":", nMsgs); });
+	for (auto& t : threads)
+		t.join();
+	log.logFlush();
+
+	ASSERT_EQ(log.msgs.size(), static_cast<size_t>(nThreads * nMsgs));
+	EXPECT_EQ(log.logAsyncDroppedMessages(), 0U);
+
+	// The messages of each thread keep their order:
+	for (int t = 0; t < nThreads; t++)
+	{
+		const std::string prefix = std::to_string(t) + ":";
+		int next = 0;
+		for (const auto& m : log.msgs)
+			if (m.rfind(prefix, 0) == 0)
+				EXPECT_EQ(m, prefix + std::to_string(next++));
+		EXPECT_EQ(next, nMsgs);
+	}
+
+	log.logEnableAsyncOutput(false);
+	log.logMany("sync:", 1);
+	EXPECT_EQ(log.msgs.back(), "sync:0");
+}
@@ -0,0 +1,181 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "system-precomp.h"	 // Precompiled headers
+//
+#include <mrpt/config.h>
+#include <mrpt/core/format.h>
+#include <mrpt/system/CPerfCounters.h>
+
+#include <cmath>
+#include <limits>
+
+#if defined(MRPT_OS_LINUX)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace mrpt::system;
+
+const char* TPerfCounterValues::CounterName(Counter c)
+{
+	static const char* names[COUNT] = {"cycles",		"instructions",
+									   "cache-references", "cache-misses",
+									   "branches",		"branch-misses"};
+	return c < COUNT ? names[c] : "";
+}
+
+double TPerfCounterValues::ratio(Counter num, Counter den) const
+{
+	if (!has(num) || !has(den) || values[den] == 0)
+		return std::numeric_limits<double>::quiet_NaN();
+	return static_cast<double>(values[num]) / values[den];
+}
+
+TPerfCounterValues TPerfCounterValues::operator-(
+	const TPerfCounterValues& o) const
+{
+	TPerfCounterValues r;
+	r.available = available & o.available;
+	for (size_t i = 0; i < COUNT; i++)
+		// (Scaled multiplexed counters might not be monotonic)
+		r.values[i] = values[i] > o.values[i] ? values[i] - o.values[i] : 0;
+	return r;
+}
+
+TPerfCounterValues& TPerfCounterValues::operator+=(const TPerfCounterValues& o)
+{
+	available &= o.available;
+	for (size_t i = 0; i < COUNT; i++)
+		values[i] += o.values[i];
+	return *this;
+}
+
+std::string TPerfCounterValues::asString() const
+{
+	if (!available) return "n/a";
+	std::string s;
+	auto add = [&s](const char* name, double v, bool percent) {
+		if (std::isnan(v)) return;
+		if (!s.empty()) s += " ";
+		s += percent ? mrpt::format("%s=%.02f%%", name, 100 * v)
+					 : mrpt::format("%s=%.02f", name, v);
+	};
+	add("IPC", ipc(), false);
+	add("cache-miss", cacheMissRate(), true);
+	add("branch-miss", branchMissRate(), true);
+	return s.empty() ? "n/a" : s;
+}
+
+#if defined(MRPT_OS_LINUX)
+namespace
+{
+int perfEventOpen(perf_event_attr& attr, int groupFd)
+{
+	return static_cast<int>(
+		syscall(__NR_perf_event_open, &attr, 0 /*this thread*/, -1 /*any cpu*/,
+				groupFd, 0 /*flags*/));
+}
+}  // namespace
+#endif
+
+CPerfCounters::CPerfCounters()
+{
+	m_fd.fill(-1);
+#if defined(MRPT_OS_LINUX)
+	constexpr uint64_t configs[TPerfCounterValues::COUNT] = {
+		PERF_COUNT_HW_CPU_CYCLES,		PERF_COUNT_HW_INSTRUCTIONS,
+		PERF_COUNT_HW_CACHE_REFERENCES, PERF_COUNT_HW_CACHE_MISSES,
+		PERF_COUNT_HW_BRANCH_INSTRUCTIONS, PERF_COUNT_HW_BRANCH_MISSES};
+
+	// Each pair of counters (numerator and denominator of each ratio) is
+	// a group, always scheduled together on the PMU. Smaller groups are
+	// more likely to fit in the available hardware counters.
+	for (uint8_t g = 0; g < NUM_GROUPS; g++)
+	{
+		int leader = -1;
+		for (uint8_t i = 2 * g; i < 2 * g + 2; i++)
+		{
+			perf_event_attr attr{};
+			attr.size = sizeof(attr);
+			attr.type = PERF_TYPE_HARDWARE;
+			attr.config = configs[i];
+			attr.disabled = leader < 0 ? 1 : 0;	 // Enabled with the leader
+			attr.exclude_kernel = 1;
+			attr.exclude_hv = 1;
+			attr.read_format = PERF_FORMAT_GROUP |
+				PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+			const int fd = perfEventOpen(attr, leader);
+			if (fd < 0) continue;  // Unsupported event, or no permissions
+			if (leader < 0) leader = fd;
+			m_fd[i] = fd;
+			m_available |= 1U << i;
+		}
+		if (leader >= 0)
+		{
+			ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+			ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+		}
+	}
+#endif
+}
+
+CPerfCounters::~CPerfCounters()
+{
+#if defined(MRPT_OS_LINUX)
+	for (const int fd : m_fd)
+		if (fd >= 0) close(fd);
+#endif
+}
+
+TPerfCounterValues CPerfCounters::read() const
+{
+	TPerfCounterValues r;
+#if defined(MRPT_OS_LINUX)
+	for (uint8_t g = 0; g < NUM_GROUPS; g++)
+	{
+		const uint8_t i0 = 2 * g;
+		const int leader = m_fd[i0] >= 0 ? m_fd[i0] : m_fd[i0 + 1];
+		if (leader < 0) continue;
+
+		// Format: nr, time_enabled, time_running, values[nr], in the order
+		// the counters were opened:
+		uint64_t buf[3 + 2];
+		const int nr = (m_fd[i0] >= 0) + (m_fd[i0 + 1] >= 0);
+		const auto nBytes = static_cast<ssize_t>((3 + nr) * sizeof(uint64_t));
+		if (::read(leader, buf, nBytes) != nBytes) continue;
+
+		const uint64_t enabled = buf[1], running = buf[2];
+		if (running == 0) continue;	 // Never scheduled on the PMU
+		// Extrapolate if the PMU had to multiplex the groups:
+		const double scale = static_cast<double>(enabled) / running;
+
+		int k = 0;
+		for (uint8_t i = i0; i < i0 + 2; i++)
+		{
+			if (m_fd[i] < 0) continue;
+			const uint64_t v = buf[3 + k++];
+			r.values[i] = running == enabled
+				? v
+				: static_cast<uint64_t>(static_cast<double>(v) * scale);
+			r.available |= 1U << i;
+		}
+	}
+#endif
+	return r;
+}
+
+CPerfCounters& CPerfCounters::ThreadInstance()
+{
+	thread_local CPerfCounters instance;
+	return instance;
+}
@@ -17,8 +17,12 @@
 #include <mrpt/system/string_utils.h>
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
 #include <fstream>
 #include <iostream>
+#include <thread>
 
 using namespace mrpt;
 using namespace mrpt::system;
@@ -63,14 +67,120 @@ void global_profiler_leave(const char* func_name) noexcept
 }
 }  // namespace mrpt::system
 
+/** Per-thread data of sections used via IDs */
+struct CTimeLogger::TThreadData
+{
+	struct TSection
+	{
+		size_t n_calls = 0, n_timed = 0;
+		double sum_t = 0, min_t = 0, max_t = 0, last_t = 0;
+		/** Start times of open calls, or <0 for non-sampled calls */
+		std::vector<double> open_calls;
+		std::vector<double> history;  //!< If keep_whole_history
+		unsigned int sample_counter = 0;
+		std::optional<TPerfCounterValues> counters;
+	};
+	struct TTraceEvent
+	{
+		section_id_t id;
+		double t_start, t_len;
+	};
+
+	/** Held by the owner thread while updating, and by the merging thread */
+	std::mutex mtx;
+	std::thread::id tid;
+	unsigned int thread_index = 0;
+	std::vector<TSection> sections;	 //!< Indexed by section_id_t
+	std::vector<TTraceEvent> trace;
+	size_t dropped_events = 0;
+	/** Only accessed by the owner thread */
+	std::map<std::string, section_id_t, std::less<>> name_cache;
+
+	TThreadData() = default;
+	TThreadData(const TThreadData& o)
+		: tid(o.tid),
+		  thread_index(o.thread_index),
+		  sections(o.sections),
+		  trace(o.trace),
+		  dropped_events(o.dropped_events),
+		  name_cache(o.name_cache)
+	{
+	}
+
+	TSection& section(section_id_t id)
+	{
+		if (id >= sections.size()) sections.resize(id + 1);
+		return sections[id];
+	}
+};
+
+static std::atomic<uint64_t> timeLoggerNextUID{1};
+
+namespace
+{
+// Recently used CTimeLogger::TThreadData of the current thread:
+struct TThreadDataCacheEntry
+{
+	uint64_t uid = 0;
+	void* data = nullptr;
+};
+thread_local std::array<TThreadDataCacheEntry, 4> tlThreadDataCache;
+thread_local unsigned int tlThreadDataCacheNext = 0;
+}  // namespace
+
 CTimeLogger::CTimeLogger(
 	bool enabled, const std::string& name, const bool keep_whole_history)
-	: m_enabled(enabled), m_keep_whole_history(keep_whole_history)
+	: m_enabled(enabled),
+	  m_keep_whole_history(keep_whole_history),
+	  m_uid(timeLoggerNextUID++)
 {
 	setName(name);
 	m_tictac.Tic();
 }
 
+CTimeLogger::CTimeLogger(const CTimeLogger& o)
+	: COutputLogger(o), m_uid(timeLoggerNextUID++)
+{
+	*this = o;
+}
+CTimeLogger::CTimeLogger(CTimeLogger&& o)
+	: COutputLogger(o), m_uid(timeLoggerNextUID++)
+{
+	*this = o;
+}
+CTimeLogger& CTimeLogger::operator=(CTimeLogger&& o) { return *this = o; }
+
+CTimeLogger& CTimeLogger::operator=(const CTimeLogger& o)
+{
+	if (this == &o) return *this;
+	o.mergeThreadData();
+
+	COutputLogger::operator=(o);
+	m_tictac = o.m_tictac;
+	m_enabled = o.m_enabled;
+	m_name = o.m_name;
+	m_keep_whole_history = o.m_keep_whole_history;
+	m_data = o.m_data;
+
+	auto lck1 = mrpt::lockHelper(m_threadDataMtx);
+	auto lck2 = mrpt::lockHelper(o.m_threadDataMtx);
+	m_sectionNames = o.m_sectionNames;
+	m_sectionIDs = o.m_sectionIDs;
+	m_threadData.clear();
+	for (const auto& td : o.m_threadData)
+	{
+		auto lck3 = mrpt::lockHelper(td->mtx);
+		m_threadData.emplace_back(std::make_unique<TThreadData>(*td));
+	}
+	// Threads might be caching pointers to our former thread data:
+	m_uid = timeLoggerNextUID++;
+	m_samplingPeriod = o.m_samplingPeriod;
+	m_tracing = o.m_tracing;
+	m_maxTraceEventsPerThread = o.m_maxTraceEventsPerThread;
+	m_perfCounters = o.m_perfCounters;
+	return *this;
+}
+
 void CTimeLogger::setName(const std::string& name) noexcept
 {
 	m_name = name;
@@ -81,6 +191,7 @@ void CTimeLogger::setName(const std::string& name) noexcept
 
 CTimeLogger::~CTimeLogger()
 {
+	mergeThreadData();
 	// Dump all stats:
 	if (!m_data.empty())  // If logging is disabled, do nothing...
 		dumpAllStats();
@@ -88,6 +199,24 @@ CTimeLogger::~CTimeLogger()
 
 void CTimeLogger::clear(bool deep_clear)
 {
+	// Discard all per-thread data, but not the registered sections:
+	{
+		auto lck = mrpt::lockHelper(m_threadDataMtx);
+		for (auto& td : m_threadData)
+		{
+			auto lck2 = mrpt::lockHelper(td->mtx);
+			for (auto& sec : td->sections)
+			{
+				sec.n_calls = sec.n_timed = 0;
+				sec.sum_t = 0;
+				sec.history.clear();
+				sec.counters.reset();
+			}
+			td->trace.clear();
+			td->dropped_events = 0;
+		}
+	}
+
 	if (deep_clear) m_data.clear();
 	else
 	{
@@ -114,6 +243,7 @@ std::string aux_format_string_multilines(const std::string& s, const size_t len)
 
 void CTimeLogger::getStats(std::map<std::string, TCallStats>& out_stats) const
 {
+	mergeThreadData();
 	out_stats.clear();
 	for (const auto& e : m_data)
 	{
@@ -126,6 +256,7 @@ void CTimeLogger::getStats(std::map<std::string, TCallStats>& out_stats) const
 		cs.mean_t = e.second.n_calls ? e.second.mean_t / e.second.n_calls : 0;
 		cs.n_calls = e.second.n_calls;
 		cs.last_t = e.second.last_t;
+		cs.counters = e.second.counters;
 	}
 }
 
@@ -134,6 +265,8 @@ std::string CTimeLogger::getStatsAsText(const size_t column_width) const
 	using std::string;
 	using namespace std::string_literals;
 
+	mergeThreadData();
+
 	string stats_text;
 	string name_tmp = m_name.size() != 0 ? " "s + m_name + ": "s : " "s;
 	string mrpt_string = "MRPT CTimeLogger report "s;
@@ -212,6 +345,36 @@ std::string CTimeLogger::getStatsAsText(const size_t column_width) const
 			i.second.has_time_units ? 's' : ' ');
 	}
 
+	// Hardware counters, if any:
+	bool anyCounters = false;
+	for (const auto& i : stat_strs)
+		if (i.second.counters) anyCounters = true;
+	if (anyCounters)
+	{
+		stats_text += bottom_header + "\n"s;
+		stats_text +=
+			"           FUNCTION                          IPC  CACHE-MISS "
+			"BRANCH-MISS\n"s;
+		stats_text += bottom_header + "\n"s;
+		for (const auto& i : stat_strs)
+		{
+			if (!i.second.counters) continue;
+			const auto& c = *i.second.counters;
+			auto fmt = [](double v, bool percent) {
+				if (std::isnan(v)) return "     -"s;
+				return percent ? mrpt::format("%5.02f%%", 100 * v)
+							   : mrpt::format("%6.02f", v);
+			};
+			stats_text += mrpt::format(
+				"%s %6s     %6s      %6s\n",
+				aux_format_string_multilines(std::string(i.first), 39)
+					.c_str(),
+				fmt(c.ipc(), false).c_str(),
+				fmt(c.cacheMissRate(), true).c_str(),
+				fmt(c.branchMissRate(), true).c_str());
+		}
+	}
+
 	std::string footer(top_header);
 	stats_text += footer + "\n";
 
@@ -220,6 +383,8 @@ std::string CTimeLogger::getStatsAsText(const size_t column_width) const
 
 void CTimeLogger::saveToCSVFile(const std::string& csv_file) const
 {
+	mergeThreadData();
+
 	std::string s;
 	s += "FUNCTION, #CALLS, LAST.T, MIN.T, MEAN.T, MAX.T, TOTAL.T [, "
 		 "WHOLE_HISTORY]\n";
@@ -253,6 +418,8 @@ void CTimeLogger::saveToMFile(const std::string& file) const
 	using std::string;
 	using namespace std::string_literals;
 
+	mergeThreadData();
+
 	string s;
 	s += "function [s] = "s + mrpt::system::extractFileName(file) +
 		"()\n"
@@ -367,6 +534,8 @@ double CTimeLogger::do_leave(const std::string_view& func_name) noexcept
 			// Append to history:
 			d.whole_history.value().push_back(At);
 		}
+		lck.unlock();
+		if (m_tracing) addTraceEvent(func_name, tim - At, At);
 		return At;
 	}
 	else
@@ -411,8 +580,277 @@ void CTimeLogger::registerUserMeasure(
 	}
 }
 
+CTimeLogger::section_id_t CTimeLogger::registerSection(
+	const std::string_view& name)
+{
+	auto lck = mrpt::lockHelper(m_threadDataMtx);
+	if (auto it = m_sectionIDs.find(name); it != m_sectionIDs.end())
+		return it->second;
+	const auto id = static_cast<section_id_t>(m_sectionNames.size());
+	m_sectionNames.emplace_back(name);
+	m_sectionIDs.emplace(std::string(name), id);
+	return id;
+}
+
+CTimeLogger::TThreadData& CTimeLogger::threadData() noexcept
+{
+	for (const auto& e : tlThreadDataCache)
+		if (e.uid == m_uid) return *static_cast<TThreadData*>(e.data);
+
+	// First use from this thread, or evicted from the cache:
+	auto lck = mrpt::lockHelper(m_threadDataMtx);
+	const auto tid = std::this_thread::get_id();
+	TThreadData* td = nullptr;
+	for (auto& t : m_threadData)
+		if (t->tid == tid) td = t.get();
+	if (!td)
+	{
+		td = m_threadData.emplace_back(std::make_unique<TThreadData>()).get();
+		td->tid = tid;
+		td->thread_index = static_cast<unsigned int>(m_threadData.size());
+	}
+	auto& e = tlThreadDataCache
+		[tlThreadDataCacheNext++ % tlThreadDataCache.size()];
+	e.uid = m_uid;
+	e.data = td;
+	return *td;
+}
+
+void CTimeLogger::do_enter(section_id_t id) noexcept
+{
+	auto& td = threadData();
+	auto lck = mrpt::lockHelper(td.mtx);
+	auto& sec = td.section(id);
+	sec.n_calls++;
+	if (sec.sample_counter++ % m_samplingPeriod != 0)
+	{
+		sec.open_calls.push_back(-1.0);
+		return;
+	}
+	sec.open_calls.push_back(0);  // Dummy value, it'll be written below
+	sec.open_calls.back() = m_tictac.Tac();	 // to avoid possible delays.
+}
+
+double CTimeLogger::do_leave(section_id_t id) noexcept
+{
+	auto& td = threadData();
+	auto lck = mrpt::lockHelper(td.mtx);
+	auto& sec = td.section(id);
+	if (sec.open_calls.empty()) return 0;  // This shouldn't happen!
+
+	const double t_start = sec.open_calls.back();
+	sec.open_calls.pop_back();
+	if (t_start < 0) return 0;	// Not sampled
+
+	const double At = m_tictac.Tac() - t_start;
+	sec.last_t = At;
+	sec.sum_t += At;
+	if (++sec.n_timed == 1)
+	{
+		sec.min_t = At;
+		sec.max_t = At;
+	}
+	else
+	{
+		mrpt::keep_min(sec.min_t, At);
+		mrpt::keep_max(sec.max_t, At);
+	}
+	if (m_keep_whole_history) sec.history.push_back(At);
+
+	if (m_tracing)
+	{
+		if (td.trace.size() < m_maxTraceEventsPerThread)
+			td.trace.push_back({id, t_start, At});
+		else
+			td.dropped_events++;
+	}
+	return At;
+}
+
+void CTimeLogger::enablePerfCounters(bool enable)
+{
+	m_perfCounters = enable && CPerfCounters::ThreadInstance().available();
+	if (enable && !m_perfCounters)
+		MRPT_LOG_WARN(
+			"Hardware performance counters are not available in this "
+			"system, ignoring enablePerfCounters()");
+}
+
+void CTimeLogger::addPerfCounters(
+	const std::string_view& name, const TPerfCounterValues& c) noexcept
+{
+	TCallData* d_ptr = m_data.find_or_alloc(std::string(name));
+	if (!d_ptr) return;
+	auto lck = mrpt::lockHelper(d_ptr->mtx);
+	if (d_ptr->counters) *d_ptr->counters += c;
+	else
+		d_ptr->counters = c;
+}
+
+void CTimeLogger::addPerfCounters(
+	section_id_t id, const TPerfCounterValues& c) noexcept
+{
+	auto& td = threadData();
+	auto lck = mrpt::lockHelper(td.mtx);
+	auto& sec = td.section(id);
+	if (sec.counters) *sec.counters += c;
+	else
+		sec.counters = c;
+}
+
+void CTimeLogger::addTraceEvent(
+	const std::string_view& name, double t_start, double t_len) noexcept
+{
+	try
+	{
+		auto& td = threadData();
+		// Section IDs are also used to store the names of traced events:
+		auto it = td.name_cache.find(name);
+		if (it == td.name_cache.end())
+			it = td.name_cache.emplace(std::string(name), registerSection(name))
+					 .first;
+
+		auto lck = mrpt::lockHelper(td.mtx);
+		auto& sec = td.section(it->second);
+		if (sec.sample_counter++ % m_samplingPeriod != 0) return;
+		if (td.trace.size() < m_maxTraceEventsPerThread)
+			td.trace.push_back({it->second, t_start, t_len});
+		else
+			td.dropped_events++;
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << "[CTimeLogger::addTraceEvent] Exception:\n"
+				  << mrpt::exception_to_str(e);
+	}
+}
+
+void CTimeLogger::mergeThreadData() const
+{
+	auto lck = mrpt::lockHelper(m_threadDataMtx);
+	for (auto& td : m_threadData)
+	{
+		auto lck2 = mrpt::lockHelper(td->mtx);
+		for (size_t id = 0; id < td->sections.size(); id++)
+		{
+			auto& sec = td->sections[id];
+			if (!sec.n_calls) continue;
+
+			TCallData* d_ptr = m_data.find_or_alloc(m_sectionNames[id]);
+			if (!d_ptr)
+			{
+				std::cerr << "[CTimeLogger::mergeThreadData] Warning: "
+							 "skipping due to hash collision.\n";
+				continue;
+			}
+			auto& d = *d_ptr;
+			auto lck3 = mrpt::lockHelper(d.mtx);
+
+			if (sec.counters)
+			{
+				if (d.counters) *d.counters += *sec.counters;
+				else
+					d.counters = sec.counters;
+				sec.counters.reset();
+			}
+
+			const bool isFirst = d.n_calls == 0;
+			d.n_calls += sec.n_calls;
+			if (sec.n_timed)
+			{
+				// Extrapolate to non-sampled calls:
+				d.mean_t += sec.sum_t * sec.n_calls / sec.n_timed;
+				d.last_t = sec.last_t;
+				if (isFirst)
+				{
+					d.min_t = sec.min_t;
+					d.max_t = sec.max_t;
+				}
+				else
+				{
+					mrpt::keep_min(d.min_t, sec.min_t);
+					mrpt::keep_max(d.max_t, sec.max_t);
+				}
+			}
+			if (!sec.history.empty())
+			{
+				if (!d.whole_history)
+					d.whole_history = decltype(d.whole_history)::value_type();
+				d.whole_history->insert(
+					d.whole_history->end(), sec.history.begin(),
+					sec.history.end());
+				sec.history.clear();
+			}
+			sec.n_calls = sec.n_timed = 0;
+			sec.sum_t = 0;
+		}
+	}
+}
+
+static std::string jsonEscape(const std::string& s)
+{
+	std::string r;
+	r.reserve(s.size());
+	for (const char c : s)
+	{
+		switch (c)
+		{
+			case '"': r += "\\\""; break;
+			case '\\': r += "\\\\"; break;
+			case '\n': r += "\\n"; break;
+			case '\t': r += "\\t"; break;
+			default:
+				if (static_cast<unsigned char>(c) < 0x20)
+					r += mrpt::format("\\u%04x", static_cast<unsigned int>(c));
+				else
+					r += c;
+		}
+	}
+	return r;
+}
+
+void CTimeLogger::saveToChromeTrace(const std::string& json_file) const
+{
+	std::ofstream f(json_file);
+	if (!f.is_open())
+		THROW_EXCEPTION_FMT("Error creating file: `%s`", json_file.c_str());
+
+	const std::string processName = m_name.empty() ? "CTimeLogger" : m_name;
+	f << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n"
+	  << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,"
+	  << "\"args\":{\"name\":\"" << jsonEscape(processName) << "\"}}";
+
+	size_t nDropped = 0;
+	auto lck = mrpt::lockHelper(m_threadDataMtx);
+	for (const auto& td : m_threadData)
+	{
+		auto lck2 = mrpt::lockHelper(td->mtx);
+		if (td->trace.empty()) continue;
+		nDropped += td->dropped_events;
+
+		f << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+		  << td->thread_index << ",\"args\":{\"name\":\"thread #"
+		  << td->thread_index << "\"}}";
+		// Times in microseconds:
+		for (const auto& ev : td->trace)
+			f << mrpt::format(
+				",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,"
+				"\"ts\":%.3f,\"dur\":%.3f}",
+				jsonEscape(m_sectionNames.at(ev.id)).c_str(),
+				td->thread_index, ev.t_start * 1e6, ev.t_len * 1e6);
+	}
+	f << "\n]}\n";
+
+	if (nDropped)
+		MRPT_LOG_WARN_STREAM(
+			"saveToChromeTrace: " << nDropped
+								  << " events were dropped, since the "
+									 "maximum per thread was reached.");
+}
+
 double CTimeLogger::getMeanTime(const std::string& name) const
 {
+	mergeThreadData();
 	TDataMap::const_iterator it = m_data.find(name);
 	if (it == m_data.end()) return 0;
 	else
@@ -424,6 +862,7 @@ double CTimeLogger::getMeanTime(const std::string& name) const
 }
 double CTimeLogger::getLastTime(const std::string& name) const
 {
+	mergeThreadData();
 	TDataMap::const_iterator it = m_data.find(name);
 	if (it == m_data.end()) return 0;
 	else
@@ -437,15 +876,42 @@ CTimeLoggerEntry::CTimeLoggerEntry(
 	const CTimeLogger& logger, const std::string_view& section_name)
 	: m_logger(const_cast<CTimeLogger&>(logger)), m_section_name(section_name)
 {
+	if (logger.m_perfCounters && logger.m_enabled)
+		m_counters = CPerfCounters::ThreadInstance().read();
 	m_entry = logger.m_tictac.Tac();
 }
+CTimeLoggerEntry::CTimeLoggerEntry(
+	const CTimeLogger& logger, CTimeLogger::section_id_t section_id)
+	: m_logger(const_cast<CTimeLogger&>(logger)), m_section_id(section_id)
+{
+	if (logger.m_perfCounters && logger.m_enabled)
+		m_counters = CPerfCounters::ThreadInstance().read();
+	m_logger.enter(section_id);
+}
 void CTimeLoggerEntry::stop()
 {
 	if (stopped_) return;
+	if (m_section_id)
+	{
+		m_logger.leave(*m_section_id);
+		if (m_counters)
+			m_logger.addPerfCounters(
+				*m_section_id,
+				CPerfCounters::ThreadInstance().read() - *m_counters);
+		stopped_ = true;
+		return;
+	}
 	const double leave = m_logger.m_tictac.Tac();
 	const double dt = leave - m_entry;
 
+	if (m_counters)
+		m_logger.addPerfCounters(
+			m_section_name,
+			CPerfCounters::ThreadInstance().read() - *m_counters);
+
 	m_logger.registerUserMeasure(m_section_name, dt, true);
+	if (m_logger.m_tracing && m_logger.m_enabled)
+		m_logger.addTraceEvent(m_section_name, m_entry, dt);
 	stopped_ = true;
 }
 
@@ -10,8 +10,12 @@
 #include <gtest/gtest.h>
 #include <mrpt/system/CTimeLogger.h>
 
+#include <mrpt/system/filesystem.h>
+
 #include <chrono>
+#include <fstream>
 #include <mutex>
+#include <sstream>
 #include <thread>
 
 static void doTimLogEntry(
@@ -123,3 +127,142 @@ TEST(CTimeLogger, multithread)
 	tl.clear(true);	 // to silent console output upon dtor
 	EXPECT_EQ(std::count(s.begin(), s.end(), '\n'), 9U);
 }
+
+TEST(CTimeLogger, sectionIDs)
+{
+	mrpt::system::CTimeLogger tl;
+	const auto idFoo = tl.registerSection("foo");
+	const auto idBar = tl.registerSection("bar");
+	EXPECT_NE(idFoo, idBar);
+	EXPECT_EQ(tl.registerSection("foo"), idFoo);
+
+	tl.enter(idFoo);
+	std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	EXPECT_GT(tl.leave(idFoo), 5e-3);
+	{
+		mrpt::system::CTimeLoggerEntry tle(tl, idBar);
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+	// Mixed with calls by name:
+	doTimLogEntry(tl, "foo", 10);
+
+	std::map<std::string, mrpt::system::CTimeLogger::TCallStats> stats;
+	tl.getStats(stats);
+	EXPECT_EQ(stats["foo"].n_calls, 2U);
+	EXPECT_EQ(stats["bar"].n_calls, 1U);
+	EXPECT_GT(tl.getMeanTime("foo"), 5e-3);
+	EXPECT_GT(tl.getLastTime("bar"), 5e-3);
+
+	// IDs remain valid after clear():
+	tl.clear(true);
+	tl.enter(idFoo);
+	tl.leave(idFoo);
+	tl.getStats(stats);
+	EXPECT_EQ(stats.size(), 1U);
+	EXPECT_EQ(stats["foo"].n_calls, 1U);
+
+	// Copies get the stats:
+	const auto tl2 = tl;
+	EXPECT_GT(tl2.getLastTime("foo"), 0);
+
+	tl.clear(true);	 // to silent console output upon dtor
+}
+
+TEST(CTimeLogger, sectionIDsMultithreadAndSampling)
+{
+	mrpt::system::CTimeLogger tl;
+	tl.setSamplingPeriod(10);
+	const auto id = tl.registerSection("hot");
+
+	std::vector<std::thread> ths;
+	for (int i = 0; i < 4; i++)
+		ths.emplace_back([&tl, id]() {
+			for (int j = 0; j < 1000; j++)
+			{
+				mrpt::system::CTimeLoggerEntry tle(tl, id);
+			}
+		});
+	for (auto& t : ths)
+		t.join();
+
+	std::map<std::string, mrpt::system::CTimeLogger::TCallStats> stats;
+	tl.getStats(stats);
+	EXPECT_EQ(stats["hot"].n_calls, 4000U);
+	EXPECT_GT(stats["hot"].total_t, 0);
+	EXPECT_LE(stats["hot"].min_t, stats["hot"].max_t);
+
+	tl.clear(true);	 // to silent console output upon dtor
+}
+
+TEST(CTimeLogger, saveToChromeTrace)
+{
+	mrpt::system::CTimeLogger tl(true, "myTrace");
+	tl.enableTracing();
+	const auto id = tl.registerSection("func\"1\"");
+
+	std::thread th([&]() { doTimLogEntry(tl, "other_thread", 1); });
+	th.join();
+	tl.enter(id);
+	doTimLogEntry(tl, "nested", 1);
+	tl.leave(id);
+	{
+		mrpt::system::CTimeLoggerEntry tle(tl, "entry");
+	}
+
+	const auto fil = mrpt::system::getTempFileName();
+	tl.saveToChromeTrace(fil);
+	std::stringstream ss;
+	ss << std::ifstream(fil).rdbuf();
+	const std::string s = ss.str();
+	mrpt::system::deleteFile(fil);
+
+	// 4 events, in 2 threads:
+	size_t nEvents = 0;
+	for (size_t p = 0; (p = s.find("\"ph\":\"X\"", p)) != std::string::npos;
+		 p++)
+		nEvents++;
+	EXPECT_EQ(nEvents, 4U);
+	EXPECT_NE(s.find("\"name\":\"func\\\"1\\\"\""), std::string::npos);
+	EXPECT_NE(s.find("\"name\":\"myTrace\""), std::string::npos);
+	EXPECT_NE(s.find("\"tid\":1"), std::string::npos);
+	EXPECT_NE(s.find("\"tid\":2"), std::string::npos);
+	EXPECT_EQ(s.find("\"tid\":3"), std::string::npos);
+
+	tl.clear(true);	 // to silent console output upon dtor
+}
+
+TEST(CTimeLogger, perfCounters)
+{
+	mrpt::system::CTimeLogger tl(true, "counters");
+	tl.setMinLoggingLevel(mrpt::system::LVL_ERROR);
+	tl.enablePerfCounters();
+	const bool available = tl.isEnabledPerfCounters();
+	const auto id = tl.registerSection("byID");
+
+	volatile double acc = 0;
+	for (int i = 0; i < 10; i++)
+	{
+		mrpt::system::CTimeLoggerEntry tle1(tl, "byName");
+		mrpt::system::CTimeLoggerEntry tle2(tl, id);
+		for (int k = 0; k < 10000; k++)
+			acc = acc + k;
+	}
+
+	std::map<std::string, mrpt::system::CTimeLogger::TCallStats> stats;
+	tl.getStats(stats);
+	for (const auto& name : {"byName", "byID"})
+	{
+		ASSERT_EQ(stats.count(name), 1U);
+		EXPECT_EQ(stats[name].n_calls, 10U);
+		// Without counters (other OSes, VMs...) this is just a no-op:
+		EXPECT_EQ(stats[name].counters.has_value(), available);
+		if (!available) continue;
+		const auto& c = *stats[name].counters;
+		if (c.has(mrpt::system::TPerfCounterValues::INSTRUCTIONS))
+			EXPECT_GT(c[mrpt::system::TPerfCounterValues::INSTRUCTIONS], 1e4);
+	}
+	if (available)
+		EXPECT_NE(tl.getStatsAsText().find("IPC"), std::string::npos);
+
+	tl.clear(true);	 // to silent console output upon dtor
+}
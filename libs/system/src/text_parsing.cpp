@@ -0,0 +1,115 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "system-precomp.h"	 // Precompiled headers
+//
+#include <mrpt/system/text_parsing.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+// Floating point std::from_chars() is not available in all standard
+// libraries, even if <charconv> is:
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+#define MRPT_HAS_FP_FROM_CHARS
+#endif
+
+using namespace mrpt::system;
+
+namespace
+{
+double strtoT(const char* s, char** end, double*)
+{
+	return std::strtod(s, end);
+}
+float strtoT(const char* s, char** end, float*) { return std::strtof(s, end); }
+
+template <typename T>
+const char* parseStrtod(const char* first, const char* last, T& out)
+{
+	// strtod() needs a null-terminated string:
+	char buf[64];
+	const size_t n = std::min<size_t>(last - first, sizeof(buf) - 1);
+	std::memcpy(buf, first, n);
+	buf[n] = '\0';
+	char* end = nullptr;
+	const T v = strtoT(buf, &end, static_cast<T*>(nullptr));
+	if (end == buf) return first;
+	out = v;
+	return first + (end - buf);
+}
+
+template <typename T>
+const char* parseImpl(const char* first, const char* last, T& out)
+{
+	// strtod() would skip them:
+	if (first == last || *first == ' ' || *first == '\t' || *first == '\r' ||
+		*first == '\n')
+		return first;
+#if defined(MRPT_HAS_FP_FROM_CHARS)
+	// from_chars() does not accept a leading '+':
+	const char* p = first;
+	if (*p == '+' && ++p != last && *p == '-') return first;
+	const auto r = std::from_chars(p, last, out, std::chars_format::general);
+	if (r.ec == std::errc()) return r.ptr;
+	if (r.ec != std::errc::result_out_of_range) return first;
+	// Out of range: return the same HUGE_VAL or 0 as strtod():
+#endif
+	return parseStrtod(first, last, out);
+}
+}  // namespace
+
+const char* mrpt::system::parse_number(
+	const char* first, const char* last, double& out)
+{
+	return parseImpl(first, last, out);
+}
+
+const char* mrpt::system::parse_number(
+	const char* first, const char* last, float& out)
+{
+	return parseImpl(first, last, out);
+}
+
+std::string_view mrpt::system::trim_view(std::string_view s)
+{
+	const size_t b = s.find_first_not_of(" \t");
+	if (b == std::string_view::npos) return {};
+	const size_t e = s.find_last_not_of(" \t");
+	return s.substr(b, e - b + 1);
+}
+
+std::vector<TTextChunk> mrpt::system::split_text_into_chunks(
+	std::string_view text, size_t numChunks, size_t minChunkSize)
+{
+	std::vector<TTextChunk> chunks;
+	const size_t target = std::max<size_t>(
+		{minChunkSize, text.size() / std::max<size_t>(numChunks, 1), 1});
+	size_t pos = 0, line = 1;
+	while (pos < text.size())
+	{
+		size_t end = text.size();
+		if (text.size() - pos > target)
+		{
+			const size_t eol = text.find('\n', pos + target - 1);
+			if (eol != std::string_view::npos) end = eol + 1;
+		}
+		TTextChunk c;
+		c.text = text.substr(pos, end - pos);
+		c.firstLine = line;
+		line += std::count(c.text.begin(), c.text.end(), '\n');
+		chunks.push_back(c);
+		pos = end;
+	}
+	return chunks;
+}
@@ -0,0 +1,109 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/system/text_parsing.h>
+
+#include <cmath>
+#include <string>
+
+using namespace mrpt::system;
+
+TEST(text_parsing, parse_number)
+{
+	const std::string s = "+1.5e3x";
+	double d = 0;
+	const char* end = parse_number(s.data(), s.data() + s.size(), d);
+	EXPECT_EQ(end, s.data() + 6);
+	EXPECT_EQ(d, 1500.0);
+
+	// Only the given range is parsed:
+	float f = 0;
+	EXPECT_EQ(parse_number(s.data(), s.data() + 3, f), s.data() + 3);
+	EXPECT_EQ(f, 1.0f);
+
+	for (const std::string bad : {"", " 1", "x", "+-1", "-"})
+	{
+		d = 7;
+		const char* last = bad.data() + bad.size();
+		EXPECT_EQ(parse_number(bad.data(), last, d), bad.data()) << bad;
+		EXPECT_EQ(d, 7);
+	}
+
+	const std::string big = "-1e999 nan";
+	end = parse_number(big.data(), big.data() + big.size(), d);
+	EXPECT_EQ(end, big.data() + 6);
+	EXPECT_TRUE(std::isinf(d) && d < 0);
+	end = parse_number(end + 1, big.data() + big.size(), d);
+	EXPECT_EQ(end, big.data() + big.size());
+	EXPECT_TRUE(std::isnan(d));
+}
+
+TEST(text_parsing, parse_numbers)
+{
+	std::vector<double> v;
+	EXPECT_EQ(parse_numbers(" 1,2.5\t-3e-1 \r 4 x 5", v), 4U);
+	ASSERT_EQ(v.size(), 4U);
+	EXPECT_EQ(v[1], 2.5);
+	EXPECT_EQ(v[2], -0.3);
+
+	float xyz[3];
+	EXPECT_EQ(parse_numbers("10 20 30 40", xyz, 3), 3U);
+	EXPECT_EQ(xyz[2], 30.0f);
+	EXPECT_EQ(parse_numbers("10 a", xyz, 3), 1U);
+	EXPECT_EQ(parse_numbers("", xyz, 3), 0U);
+}
+
+TEST(text_parsing, for_each_line)
+{
+	std::vector<std::string> lines;
+	auto lmb = [&](std::string_view l) {
+		lines.emplace_back(l);
+		return true;
+	};
+	for_each_line("a\r\n\nbc\n", lmb);
+	EXPECT_EQ(lines, (std::vector<std::string>{"a", "", "bc"}));
+
+	lines.clear();
+	EXPECT_TRUE(for_each_line("a\nb", lmb));
+	EXPECT_EQ(lines, (std::vector<std::string>{"a", "b"}));
+
+	int n = 0;
+	EXPECT_FALSE(for_each_line("a\nb\nc", [&](std::string_view) {
+		return ++n < 2;
+	}));
+	EXPECT_EQ(n, 2);
+
+	EXPECT_EQ(trim_view(" \t ab c\t"), "ab c");
+	EXPECT_EQ(trim_view(" \t "), "");
+}
+
+TEST(text_parsing, split_text_into_chunks)
+{
+	std::string text;
+	for (int i = 0; i < 1000; i++)
+		text += std::to_string(i) + "\n";
+	text += "last";
+
+	EXPECT_EQ(split_text_into_chunks(text, 8).size(), 1U);
+	EXPECT_TRUE(split_text_into_chunks("", 8).empty());
+
+	const auto chunks = split_text_into_chunks(text, 8, 100);
+	EXPECT_EQ(chunks.size(), 8U);
+	std::string joined;
+	for (const auto& c : chunks)
+	{
+		// Chunks start at the beginning of a line:
+		const int firstNum = std::stoi(std::string(c.text.substr(0, 4)));
+		EXPECT_EQ(static_cast<size_t>(firstNum), c.firstLine - 1);
+		joined += c.text;
+	}
+	EXPECT_EQ(joined, text);
+	EXPECT_EQ(chunks.back().text.substr(chunks.back().text.size() - 4), "last");
+}
@@ -109,6 +109,12 @@ struct TSE2RobustParams
 	double max_rmse_to_end{0};
 	/** (Default=false) */
 	bool verbose{false};
+	/** (Default=1) Number of threads building RANSAC hypotheses in parallel
+	 * (0: as many as CPU cores). The result does not depend on it. Only used
+	 * if ransac_algorithmForLandmarks=true, and if it is not 1,
+	 * user_individual_compat_callback must be thread-safe.
+	 * \note (New in MRPT 2.4.9) */
+	unsigned int num_threads{1};
 
 	/** If provided, this user callback will be invoked to determine the
 	 * individual compatibility between each potential pair
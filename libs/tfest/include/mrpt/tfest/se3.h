@@ -10,6 +10,7 @@
 
 #include <mrpt/math/CMatrixFixed.h>
 #include <mrpt/math/math_frwds.h>
+#include <mrpt/math/robust_kernels.h>
 #include <mrpt/poses/CPose3DQuat.h>
 #include <mrpt/poses/poses_frwds.h>
 #include <mrpt/tfest/TMatchingPair.h>
@@ -92,11 +93,46 @@ struct TSE3RobustParams
 	/** (Default=false) */
 	bool verbose{false};
 
+	/** (Default=false) If true, each RANSAC hypothesis (computed from a
+	 * random subset of `ransac_minSetSize` pairs) is scored by the number
+	 * of pairs it transforms with an error below `ransac_threshold_residual`,
+	 * and the best one is refined with IRLS (see `irls_iterations`). This is
+	 * much faster than the default method, which checks the consistency of
+	 * the transformation computed from each hypothesis plus each other pair,
+	 * and `ransac_threshold_lin`, `ransac_threshold_ang` and
+	 * `ransac_threshold_scale` are not used.
+	 * \note (New in MRPT 2.4.9) */
+	bool ransac_scoreByResiduals{false};
+	/** (Default=0.05) Maximum distance (in meters) between a point in
+	 * `this` frame and its matched point from `other`, once transformed, for
+	 * the pair to be an inlier. Only if ransac_scoreByResiduals=true.
+	 * \note (New in MRPT 2.4.9) */
+	double ransac_threshold_residual{0.05};
+	/** (Default=1) Number of threads evaluating hypotheses in parallel (0: as
+	 * many as CPU cores). The result does not depend on it. Only if
+	 * ransac_scoreByResiduals=true.
+	 * \note (New in MRPT 2.4.9) */
+	unsigned int num_threads{1};
+	/** (Default=5) Number of iterations of iteratively reweighted least
+	 * squares (IRLS) refining the best hypothesis with its inliers. Only if
+	 * ransac_scoreByResiduals=true.
+	 * \note (New in MRPT 2.4.9) */
+	unsigned int irls_iterations{5};
+	/** (Default=rkPseudoHuber) The robust kernel of the IRLS weights.
+	 * \note (New in MRPT 2.4.9) */
+	mrpt::math::TRobustKernelType irls_kernel{mrpt::math::rkPseudoHuber};
+	/** (Default=0) The parameter (in meters) of `irls_kernel`. Special value
+	 * 0 means "auto", that is, `ransac_threshold_residual/3`.
+	 * \note (New in MRPT 2.4.9) */
+	double irls_kernel_param{0};
+
 	/** If provided, this user callback will be invoked to determine the
 	 * individual compatibility between each potential pair
 	 * of elements. Can check image descriptors, geometrical properties, etc.
 	 * \return Must return true if the pair is a potential match, false
 	 * otherwise.
+	 * \note With ransac_scoreByResiduals=true, it is invoked only once for
+	 * each pair, and incompatible pairs are never inliers.
 	 */
 	TFunctorCheckPotentialMatch user_individual_compat_callback;
 };
@@ -112,6 +148,10 @@ struct TSE3RobustResult
 	/** Indexes within the `in_correspondences` list which corresponds with
 	 * inliers */
 	std::vector<uint32_t> inliers_idx;
+	/** Root mean square error of the inliers, once transformed. Only if
+	 * TSE3RobustParams::ransac_scoreByResiduals=true.
+	 * \note (New in MRPT 2.4.9) */
+	double rmse{.0};
 };
 
 /** Least-squares (L2 norm) solution to finding the optimal SE(3) transform
@@ -133,6 +173,9 @@ struct TSE3RobustResult
  * \return True if the minimum number of correspondences was found, false
  * otherwise.
  * \note Implemented by FAMD, 2008. Re-factored by JLBC, 2015.
+ * \note See TSE3RobustParams::ransac_scoreByResiduals for a faster method,
+ * with parallel evaluation of hypotheses and IRLS refinement (New in MRPT
+ * 2.4.9).
  * \note [New in MRPT 1.3.0] This function replaces
  * mrpt::scanmatching::leastSquareErrorRigidTransformation6DRANSAC()
  * \sa se2_l2, se3_l2
@@ -9,6 +9,7 @@
 
 #include "tfest-precomp.h"	// Precompiled headers
 //
+#include <mrpt/core/WorkerThreadsPool.h>
 #include <mrpt/core/round.h>
 #include <mrpt/math/distributions.h>
 #include <mrpt/math/geometry.h>
@@ -19,6 +20,9 @@
 #include <mrpt/tfest/se2.h>
 
 #include <iostream>
+#include <memory>
+#include <random>
+#include <thread>
 
 using namespace mrpt;
 using namespace mrpt::tfest;
@@ -199,9 +203,6 @@ bool tfest::se2_l2_robust(
 
 	std::deque<TMatchingPairList> alreadyAddedSubSets;
 
-	CPosePDFGaussian referenceEstimation;
-	CPoint2DPDFGaussian pt_this;
-
 	const double ransac_consistency_test_chi2_quantile = 0.99;
 	const double chi2_thres_dim1 =
 		mrpt::math::chi2inv(ransac_consistency_test_chi2_quantile, 1);
@@ -224,64 +225,53 @@ bool tfest::se2_l2_robust(
 		// changed in the first loop
 	}
 
-	std::vector<bool> alreadySelectedThis, alreadySelectedOther;
-
+	// Each hypothesis (a consensus subset and its transformation) is built
+	// from its own random permutation of the correspondences:
+	struct THypothesis
+	{
+		uint32_t seed = 0;
+		TMatchingPairList subSet;
+		CPosePDFGaussian estimation;
+		double rmse = std::numeric_limits<double>::max();
+	};
+
+	// Marks of already picked elements. For landmarks, they are reset for
+	// each hypothesis; for points, they are kept along all of them, so
+	// hypotheses must be built sequentially in that case.
+	std::vector<bool> pickedThis, pickedOther;
 	if (!params.ransac_algorithmForLandmarks)
 	{
-		alreadySelectedThis.assign(maxThis + 1, false);
-		alreadySelectedOther.assign(maxOther + 1, false);
+		pickedThis.assign(maxThis + 1, false);
+		pickedOther.assign(maxOther + 1, false);
 	}
-	// else -> It will be done anyway inside the for() below
 
-	// First: Build a permutation of the correspondences to pick from it
-	// sequentially:
-	std::vector<size_t> corrsIdxs(nCorrs), corrsIdxsPermutation;
+	std::vector<size_t> corrsIdxs(nCorrs);
 	for (size_t i = 0; i < nCorrs; i++)
 		corrsIdxs[i] = i;
 
-	size_t iter_idx;
-	for (iter_idx = 0; iter_idx < results.ransac_iters;
-		 iter_idx++)  // results.ransac_iters can be dynamic
-	{
-#ifdef DO_PROFILING
-		CTimeLoggerEntry tle(timlog, "ransac.iter");
-#endif
-
-#ifdef DO_PROFILING
-		timlog.enter("ransac.permute");
-#endif
-		getRandomGenerator().permuteVector(corrsIdxs, corrsIdxsPermutation);
-
-#ifdef DO_PROFILING
-		timlog.leave("ransac.permute");
-#endif
-
-		TMatchingPairList subSet;
-
-		// Select a subset of correspondences at random:
+	const auto buildHypothesis = [&](THypothesis& h) {
+		std::vector<bool> localThis, localOther;
 		if (params.ransac_algorithmForLandmarks)
 		{
-#ifdef DO_PROFILING
-			timlog.enter("ransac.reset_selection_marks");
-#endif
-			alreadySelectedThis.assign(maxThis + 1, false);
-			alreadySelectedOther.assign(maxOther + 1, false);
-#ifdef DO_PROFILING
-			timlog.leave("ransac.reset_selection_marks");
-#endif
-		}
-		else
-		{
-			// For points: Do not repeat the corrs, and take the number of corrs
-			// as weights
+			localThis.assign(maxThis + 1, false);
+			localOther.assign(maxOther + 1, false);
 		}
-
-// Try to build a subsetof "ransac_maxSetSize" (maximum) elements that achieve
-// consensus:
-// ------------------------------------------------------------------------------------------
-#ifdef DO_PROFILING
-		timlog.enter("ransac.inner_loops");
-#endif
+		std::vector<bool>& alreadySelectedThis =
+			params.ransac_algorithmForLandmarks ? localThis : pickedThis;
+		std::vector<bool>& alreadySelectedOther =
+			params.ransac_algorithmForLandmarks ? localOther : pickedOther;
+
+		std::mt19937 rng(h.seed);
+		std::vector<size_t> corrsIdxsPermutation = corrsIdxs;
+		mrpt::random::shuffle(
+			corrsIdxsPermutation.begin(), corrsIdxsPermutation.end(), rng);
+
+		TMatchingPairList& subSet = h.subSet;
+		CPosePDFGaussian& referenceEstimation = h.estimation;
+		CPoint2DPDFGaussian pt_this;
+
+		// Try to build a subset of "ransac_maxSetSize" (maximum) elements that
+		// achieve consensus:
 		for (unsigned int j = 0;
 			 j < nCorrs && subSet.size() < params.ransac_maxSetSize; j++)
 		{
@@ -305,10 +295,8 @@ bool tfest::se2_l2_robust(
 
 			if (subSet.size() < 2)
 			{
-				// ------------------------------------------------------------------------------------------------------
-				// If we are within the first two correspondences, just add them
-				// to the subset:
-				// ------------------------------------------------------------------------------------------------------
+				// If we are within the first two correspondences, just add
+				// them to the subset:
 				subSet.push_back(corr_j);
 				markAsPicked(corr_j, alreadySelectedThis, alreadySelectedOther);
 
@@ -370,17 +358,11 @@ bool tfest::se2_l2_robust(
 			}
 			else
 			{
-#ifdef DO_PROFILING
-				timlog.enter("ransac.test_consistency");
-#endif
-
-				// ------------------------------------------------------------------------------------------------------
 				// The normal case:
 				//  - test for "consensus" with the current group:
 				//		- If it is compatible (ransac_maxErrorXY,
 				// ransac_maxErrorPHI), grow the "consensus set"
 				//		- If not, do not add it.
-				// ------------------------------------------------------------------------------------------------------
 
 				// Test for the mahalanobis distance between:
 				//  "referenceEstimation (+) point_other" AND "point_this"
@@ -402,34 +384,20 @@ bool tfest::se2_l2_robust(
 						corr_j, alreadySelectedThis, alreadySelectedOther);
 				}
 				// else -> Test failed
-
-#ifdef DO_PROFILING
-				timlog.leave("ransac.test_consistency");
-#endif
 			}  // end else "normal case"
 
 		}  // end for j
-#ifdef DO_PROFILING
-		timlog.leave("ransac.inner_loops");
-#endif
-
-		const bool has_to_eval_RMSE =
-			(subSet.size() >= params.ransac_minSetSize);
 
 		// Compute the RMSE of this matching and the corresponding
 		// transformation (only if we'll use this value below)
-		double this_subset_RMSE = 0;
-		if (has_to_eval_RMSE)
+		if (subSet.size() >= params.ransac_minSetSize)
 		{
-#ifdef DO_PROFILING
-			CTimeLoggerEntry tle(timlog, "ransac.comp_rmse");
-#endif
-
 			// Recompute referenceEstimation from all the corrs:
 			tfest::se2_l2(subSet, referenceEstimation);
 			// Normalized covariance: scale!
 			referenceEstimation.cov *= square(normalizationStd);
 
+			double this_subset_RMSE = 0;
 			for (size_t k = 0; k < subSet.size(); k++)
 			{
 				double gx, gy;
@@ -441,157 +409,183 @@ bool tfest::se2_l2_robust(
 						subSet[k].global.x, subSet[k].global.y, gx, gy);
 			}
 			this_subset_RMSE /= std::max(static_cast<size_t>(1), subSet.size());
+			h.rmse = this_subset_RMSE;
 		}
+	};
+
+	// Hypotheses are built in parallel, in batches, while their results are
+	// merged sequentially in the same order they would have been generated
+	// by a single thread, so the result does not depend on the number of
+	// threads:
+	size_t nThreads = params.ransac_algorithmForLandmarks ? params.num_threads
+														  : 1;
+	if (!nThreads) nThreads = std::max(1U, std::thread::hardware_concurrency());
+	std::unique_ptr<mrpt::WorkerThreadsPool> pool;
+	if (nThreads > 1)
+		pool = std::make_unique<mrpt::WorkerThreadsPool>(
+			nThreads - 1, mrpt::WorkerThreadsPool::POLICY_FIFO, "se2_ransac");
+	const size_t batchSize = nThreads > 1 ? 4 * nThreads : 1;
+	std::vector<THypothesis> batch;
+
+	size_t iter_idx = 0;
+	bool done = false;
+	while (!done && iter_idx < results.ransac_iters)
+	{
+		batch.resize(std::min(batchSize, results.ransac_iters - iter_idx));
+		for (auto& h : batch)
+			h = THypothesis{getRandomGenerator().drawUniform32bit()};
+
+		if (pool)
+			pool->parallel_for(0, batch.size(), 1, [&](size_t i) {
+				buildHypothesis(batch[i]);
+			});
 		else
-		{
-			this_subset_RMSE = std::numeric_limits<double>::max();
-		}
+			for (auto& h : batch)
+				buildHypothesis(h);
 
-		// Save the estimation result as a "particle", only if the subSet
-		// contains
-		//  "ransac_minSetSize" elements at least:
-		if (subSet.size() >= params.ransac_minSetSize)
+		for (size_t b = 0; b < batch.size(); b++, iter_idx++)
 		{
-			// If this subset was previously added to the SOG, just increment
-			// its weight
-			//  and do not add a new mode:
-			int indexFound = -1;
-
-			// JLBC Added DEC-2007: An alternative (optional) method to fuse
-			// Gaussian modes:
-			if (!params.ransac_fuseByCorrsMatch)
+			// results.ransac_iters can be dynamic:
+			if (iter_idx >= results.ransac_iters) break;
+
+			TMatchingPairList& subSet = batch[b].subSet;
+			const CPosePDFGaussian& referenceEstimation = batch[b].estimation;
+			const double this_subset_RMSE = batch[b].rmse;
+
+			// Save the estimation result as a "particle", only if the subSet
+			// contains
+			//  "ransac_minSetSize" elements at least:
+			if (subSet.size() >= params.ransac_minSetSize)
 			{
-				// Find matching by approximate match in the X,Y,PHI means
-				// -------------------------------------------------------------------
-				for (size_t i = 0; i < results.transformation.size(); i++)
+				// If this subset was previously added to the SOG, just
+				// increment its weight and do not add a new mode:
+				int indexFound = -1;
+
+				// JLBC Added DEC-2007: An alternative (optional) method to
+				// fuse Gaussian modes:
+				if (!params.ransac_fuseByCorrsMatch)
 				{
-					double diffXY =
-						results.transformation.get(i).mean.distanceTo(
-							referenceEstimation.mean);
-					double diffPhi = fabs(math::wrapToPi(
-						results.transformation.get(i).mean.phi() -
-						referenceEstimation.mean.phi()));
-					if (diffXY < params.ransac_fuseMaxDiffXY &&
-						diffPhi < params.ransac_fuseMaxDiffPhi)
+					// Find matching by approximate match in the X,Y,PHI means
+					for (size_t i = 0; i < results.transformation.size(); i++)
 					{
-						// printf("Match by distance found: distXY:%f distPhi=%f
-						// deg\n",diffXY,RAD2DEG(diffPhi));
-						indexFound = i;
-						break;
+						double diffXY =
+							results.transformation.get(i).mean.distanceTo(
+								referenceEstimation.mean);
+						double diffPhi = fabs(math::wrapToPi(
+							results.transformation.get(i).mean.phi() -
+							referenceEstimation.mean.phi()));
+						if (diffXY < params.ransac_fuseMaxDiffXY &&
+							diffPhi < params.ransac_fuseMaxDiffPhi)
+						{
+							indexFound = i;
+							break;
+						}
 					}
 				}
-			}
-			else
-			{
-				// Find matching mode by exact match in the list of
-				// correspondences:
-				// -------------------------------------------------------------------
-				// Sort "subSet" in order to compare them easily!
-				// std::sort( subSet.begin(), subSet.end() );
-
-				// Try to find matching corrs:
-				for (size_t i = 0; i < alreadyAddedSubSets.size(); i++)
+				else
 				{
-					if (subSet == alreadyAddedSubSets[i])
+					// Find matching mode by exact match in the list of
+					// correspondences:
+					for (size_t i = 0; i < alreadyAddedSubSets.size(); i++)
 					{
-						indexFound = i;
-						break;
+						if (subSet == alreadyAddedSubSets[i])
+						{
+							indexFound = i;
+							break;
+						}
 					}
 				}
-			}
 
-			if (indexFound != -1)
-			{
-				// This is an already added mode:
-				if (params.ransac_algorithmForLandmarks)
-					results.transformation.get(indexFound).log_w = log(
-						1 + exp(results.transformation.get(indexFound).log_w));
-				else
-					results.transformation.get(indexFound).log_w =
-						log(subSet.size() +
-							exp(results.transformation.get(indexFound).log_w));
-			}
-			else
-			{
-				// Add a new mode to the SOG:
-				alreadyAddedSubSets.push_back(subSet);
-
-				CPosePDFSOG::TGaussianMode newSOGMode;
-				if (params.ransac_algorithmForLandmarks)
-					newSOGMode.log_w = 0;  // log(1);
+				if (indexFound != -1)
+				{
+					// This is an already added mode:
+					auto& mode = results.transformation.get(indexFound);
+					if (params.ransac_algorithmForLandmarks)
+						mode.log_w = log(1 + exp(mode.log_w));
+					else
+						mode.log_w = log(subSet.size() + exp(mode.log_w));
+				}
 				else
-					newSOGMode.log_w = log(static_cast<double>(subSet.size()));
+				{
+					// Add a new mode to the SOG:
+					alreadyAddedSubSets.push_back(subSet);
 
-				newSOGMode.mean = referenceEstimation.mean;
-				newSOGMode.cov = referenceEstimation.cov;
+					CPosePDFSOG::TGaussianMode newSOGMode;
+					if (params.ransac_algorithmForLandmarks)
+						newSOGMode.log_w = 0;  // log(1);
+					else
+						newSOGMode.log_w =
+							log(static_cast<double>(subSet.size()));
 
-				// Add a new mode to the SOG!
-				results.transformation.push_back(newSOGMode);
-			}
-		}  // end if subSet.size()>=ransac_minSetSize
+					newSOGMode.mean = referenceEstimation.mean;
+					newSOGMode.cov = referenceEstimation.cov;
 
-		const size_t ninliers = subSet.size();
-		if (largest_consensus_yet < ninliers)
-		{
-			largest_consensus_yet = ninliers;
+					// Add a new mode to the SOG!
+					results.transformation.push_back(newSOGMode);
+				}
+			}  // end if subSet.size()>=ransac_minSetSize
 
-			// Dynamic # of steps:
-			if (use_dynamic_iter_number)
+			const size_t ninliers = subSet.size();
+			if (largest_consensus_yet < ninliers)
 			{
-				// Update estimate of nCorrs, the number of trials to ensure we
-				// pick,
-				// with probability p, a data set with no outliers.
-				const double fracinliers = ninliers /
-					static_cast<double>(howManyDifCorrs);  // corrsIdxs.size());
-				double pNoOutliers = 1 -
-					pow(fracinliers,
-						static_cast<double>(2.0 /*minimumSizeSamplesToFit*/));
-
-				pNoOutliers = std::max(
-					std::numeric_limits<double>::epsilon(),
-					pNoOutliers);  // Avoid division by -Inf
-				pNoOutliers = std::min(
-					1.0 - std::numeric_limits<double>::epsilon(),
-					pNoOutliers);  // Avoid division by 0.
-				// Number of
-				results.ransac_iters = mrpt::round(
-					log(1 - params.probability_find_good_model) /
-					log(pNoOutliers));
-
-				results.ransac_iters = std::max(
-					results.ransac_iters, params.ransac_min_nSimulations);
+				largest_consensus_yet = ninliers;
 
-				if (params.verbose)
-					cout << "[tfest::RANSAC] Iter #" << iter_idx
-						 << ":est. # iters=" << results.ransac_iters
-						 << " pNoOutliers=" << pNoOutliers
-						 << " #inliers: " << ninliers << endl;
+				// Dynamic # of steps:
+				if (use_dynamic_iter_number)
+				{
+					// Update estimate of nCorrs, the number of trials to
+					// ensure we pick, with probability p, a data set with no
+					// outliers.
+					const double fracinliers =
+						ninliers / static_cast<double>(howManyDifCorrs);
+					double pNoOutliers = 1 -
+						pow(fracinliers,
+							static_cast<double>(
+								2.0 /*minimumSizeSamplesToFit*/));
+
+					pNoOutliers = std::max(
+						std::numeric_limits<double>::epsilon(),
+						pNoOutliers);  // Avoid division by -Inf
+					pNoOutliers = std::min(
+						1.0 - std::numeric_limits<double>::epsilon(),
+						pNoOutliers);  // Avoid division by 0.
+					// Number of
+					results.ransac_iters = mrpt::round(
+						log(1 - params.probability_find_good_model) /
+						log(pNoOutliers));
+
+					results.ransac_iters = std::max(
+						results.ransac_iters, params.ransac_min_nSimulations);
+
+					if (params.verbose)
+						cout << "[tfest::RANSAC] Iter #" << iter_idx
+							 << ":est. # iters=" << results.ransac_iters
+							 << " pNoOutliers=" << pNoOutliers
+							 << " #inliers: " << ninliers << endl;
+				}
 			}
-		}
 
-		// Save the largest subset:
-		if (subSet.size() >= params.ransac_minSetSize &&
-			this_subset_RMSE < largestSubSet_RMSE)
-		{
-			if (params.verbose)
-				cout << "[tfest::RANSAC] Iter #" << iter_idx
-					 << " Better subset: " << subSet.size()
-					 << " inliers, RMSE=" << this_subset_RMSE << endl;
-
-			results.largestSubSet = subSet;
-			largestSubSet_RMSE = this_subset_RMSE;
-		}
+			// Save the largest subset:
+			if (subSet.size() >= params.ransac_minSetSize &&
+				this_subset_RMSE < largestSubSet_RMSE)
+			{
+				if (params.verbose)
+					cout << "[tfest::RANSAC] Iter #" << iter_idx
+						 << " Better subset: " << subSet.size()
+						 << " inliers, RMSE=" << this_subset_RMSE << endl;
 
-		// Is the found subset good enough?
-		if (subSet.size() >= params.ransac_minSetSize &&
-			this_subset_RMSE < MAX_RMSE_TO_END)
-		{
-			break;	// end RANSAC iterations.
-		}
+				results.largestSubSet = subSet;
+				largestSubSet_RMSE = this_subset_RMSE;
+			}
 
-#ifdef DO_PROFILING
-		timlog.leave("ransac.iter");
-#endif
+			// Is the found subset good enough?
+			if (subSet.size() >= params.ransac_minSetSize &&
+				this_subset_RMSE < MAX_RMSE_TO_END)
+			{
+				done = true;  // end RANSAC iterations.
+				break;
+			}
+		}  // end for each hypothesis in the batch
 	}  // end for each iteration
 
 	if (params.verbose)
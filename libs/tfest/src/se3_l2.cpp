@@ -15,6 +15,8 @@
 
 #include <Eigen/Dense>
 
+#include "se3_l2_internal.h"
+
 using namespace mrpt;
 using namespace mrpt::tfest;
 using namespace mrpt::poses;
@@ -65,15 +67,15 @@ using namespace std;
 //		t = ct_this-sR(ct_others)
 
 /*---------------------------------------------------------------
-					se3_l2  (old "HornMethod()")
+			se3_l2_weighted  (old "HornMethod()")
   ---------------------------------------------------------------*/
-static bool se3_l2_internal(
+bool mrpt::tfest::internal::se3_l2_weighted(
 	std::vector<mrpt::math::TPoint3D>&
 		points_this,  // IN/OUT: It gets modified!
 	std::vector<mrpt::math::TPoint3D>&
 		points_other,  // IN/OUT: It gets modified!
-	mrpt::poses::CPose3DQuat& out_transform, double& out_scale,
-	bool forceScaleToUnity)
+	const double* weights, mrpt::poses::CPose3DQuat& out_transform,
+	double& out_scale, bool forceScaleToUnity)
 {
 	MRPT_START
 
@@ -85,13 +87,17 @@ static bool se3_l2_internal(
 	if (nMatches < 3)
 		return false;  // Nothing we can estimate without 3 points!!
 
+	double sumW = 0;
 	for (size_t i = 0; i < nMatches; i++)
 	{
-		ct_others += points_other[i];
-		ct_this += points_this[i];
+		const double w = weights ? weights[i] : 1.0;
+		ct_others += points_other[i] * w;
+		ct_this += points_this[i] * w;
+		sumW += w;
 	}
+	if (sumW <= 0) return false;
 
-	const double F = 1.0 / nMatches;
+	const double F = 1.0 / sumW;
 	ct_others *= F;
 	ct_this *= F;
 
@@ -103,17 +109,20 @@ static bool se3_l2_internal(
 		points_this[i] -= ct_this;
 		points_other[i] -= ct_others;
 
-		S(0, 0) += points_other[i].x * points_this[i].x;
-		S(0, 1) += points_other[i].x * points_this[i].y;
-		S(0, 2) += points_other[i].x * points_this[i].z;
+		const double w = weights ? weights[i] : 1.0;
+		const TPoint3D wo = points_other[i] * w;
+
+		S(0, 0) += wo.x * points_this[i].x;
+		S(0, 1) += wo.x * points_this[i].y;
+		S(0, 2) += wo.x * points_this[i].z;
 
-		S(1, 0) += points_other[i].y * points_this[i].x;
-		S(1, 1) += points_other[i].y * points_this[i].y;
-		S(1, 2) += points_other[i].y * points_this[i].z;
+		S(1, 0) += wo.y * points_this[i].x;
+		S(1, 1) += wo.y * points_this[i].y;
+		S(1, 2) += wo.y * points_this[i].z;
 
-		S(2, 0) += points_other[i].z * points_this[i].x;
-		S(2, 1) += points_other[i].z * points_this[i].y;
-		S(2, 2) += points_other[i].z * points_this[i].z;
+		S(2, 0) += wo.z * points_this[i].x;
+		S(2, 1) += wo.z * points_this[i].y;
+		S(2, 2) += wo.z * points_this[i].z;
 	}
 
 	// Construct the N matrix
@@ -177,10 +186,13 @@ static bool se3_l2_internal(
 		double den = 0.0;
 		for (size_t i = 0; i < nMatches; i++)
 		{
-			num += square(points_other[i].x) + square(points_other[i].y) +
-				square(points_other[i].z);
-			den += square(points_this[i].x) + square(points_this[i].y) +
-				square(points_this[i].z);
+			const double w = weights ? weights[i] : 1.0;
+			num += w *
+				(square(points_other[i].x) + square(points_other[i].y) +
+				 square(points_other[i].z));
+			den += w *
+				(square(points_this[i].x) + square(points_this[i].y) +
+				 square(points_this[i].z));
 		}  // end-for
 
 		// The scale:
@@ -200,7 +212,7 @@ static bool se3_l2_internal(
 	return true;
 
 	MRPT_END
-}  // end se3_l2_internal()
+}  // end se3_l2_weighted()
 
 bool tfest::se3_l2(
 	const std::vector<mrpt::math::TPoint3D>& in_points_this,
@@ -213,8 +225,9 @@ bool tfest::se3_l2(
 	std::vector<mrpt::math::TPoint3D> points_this = in_points_this;
 	std::vector<mrpt::math::TPoint3D> points_other = in_points_other;
 
-	return se3_l2_internal(
-		points_this, points_other, out_transform, out_scale, forceScaleToUnity);
+	return mrpt::tfest::internal::se3_l2_weighted(
+		points_this, points_other, nullptr, out_transform, out_scale,
+		forceScaleToUnity);
 }
 
 bool tfest::se3_l2(
@@ -234,8 +247,9 @@ bool tfest::se3_l2(
 		points_other[i].y = corrs[i].local.y;
 		points_other[i].z = corrs[i].local.z;
 	}
-	return se3_l2_internal(
-		points_this, points_other, out_transform, out_scale, forceScaleToUnity);
+	return mrpt::tfest::internal::se3_l2_weighted(
+		points_this, points_other, nullptr, out_transform, out_scale,
+		forceScaleToUnity);
 }
 
 bool tfest::se3_l2(
@@ -255,6 +269,7 @@ bool tfest::se3_l2(
 		points_other[i].y = corrs[i].local.y;
 		points_other[i].z = corrs[i].local.z;
 	}
-	return se3_l2_internal(
-		points_this, points_other, out_transform, out_scale, forceScaleToUnity);
+	return mrpt::tfest::internal::se3_l2_weighted(
+		points_this, points_other, nullptr, out_transform, out_scale,
+		forceScaleToUnity);
 }
@@ -0,0 +1,25 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/math/TPoint3D.h>
+#include <mrpt/poses/CPose3DQuat.h>
+
+#include <vector>
+
+namespace mrpt::tfest::internal
+{
+/** Horn's method, with an optional (if !=nullptr) weight for each pair of
+ * points. Both input vectors get modified (their centroids subtracted). */
+bool se3_l2_weighted(
+	std::vector<mrpt::math::TPoint3D>& points_this,
+	std::vector<mrpt::math::TPoint3D>& points_other, const double* weights,
+	mrpt::poses::CPose3DQuat& out_transform, double& out_scale,
+	bool forceScaleToUnity);
+}  // namespace mrpt::tfest::internal
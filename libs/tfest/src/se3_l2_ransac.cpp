@@ -9,7 +9,9 @@
 
 #include "tfest-precomp.h"	// Precompiled headers
 //
+#include <mrpt/core/WorkerThreadsPool.h>
 #include <mrpt/core/round.h>
+#include <mrpt/math/robust_kernels.h>
 #include <mrpt/math/utils.h>  // linspace()
 #include <mrpt/poses/CPose3D.h>
 #include <mrpt/poses/CPose3DQuat.h>
@@ -17,8 +19,14 @@
 #include <mrpt/random.h>
 #include <mrpt/tfest/se3.h>
 
+#include <algorithm>
+#include <atomic>
 #include <iostream>
 #include <numeric>
+#include <random>
+#include <thread>
+
+#include "se3_l2_internal.h"
 
 using namespace mrpt;
 using namespace mrpt::tfest;
@@ -27,6 +35,311 @@ using namespace mrpt::poses;
 using namespace mrpt::math;
 using namespace std;
 
+namespace
+{
+// The correspondences as a structure of arrays, for scoring hypotheses:
+struct TMatchingPairsSoA
+{
+	std::vector<double> gx, gy, gz, lx, ly, lz;
+	// Index of each pair in the input list:
+	std::vector<uint32_t> idx;
+
+	void reserve(size_t n)
+	{
+		for (auto* v : {&gx, &gy, &gz, &lx, &ly, &lz})
+			v->reserve(n);
+		idx.reserve(n);
+	}
+	void push_back(const TMatchingPair& p, uint32_t i)
+	{
+		gx.push_back(p.global.x);
+		gy.push_back(p.global.y);
+		gz.push_back(p.global.z);
+		lx.push_back(p.local.x);
+		ly.push_back(p.local.y);
+		lz.push_back(p.local.z);
+		idx.push_back(i);
+	}
+	size_t size() const { return idx.size(); }
+	TPoint3D global(size_t i) const { return {gx[i], gy[i], gz[i]}; }
+	TPoint3D local(size_t i) const { return {lx[i], ly[i], lz[i]}; }
+};
+
+// p_this = s*R*p_other + t, for the output of se3_l2():
+struct TSimilarity
+{
+	TSimilarity(const CPose3DQuat& q, double s)
+	{
+		const auto R = q.quat().rotationMatrix<CMatrixDouble33>();
+		for (int r = 0; r < 3; r++)
+		{
+			for (int c = 0; c < 3; c++)
+				sR[3 * r + c] = s * R(r, c);
+			t[r] = q[r];
+		}
+	}
+	double sR[9];  // Row-major
+	double t[3];
+
+	double sqErr(const TMatchingPairsSoA& m, size_t i) const
+	{
+		const double ex = m.gx[i] -
+			(sR[0] * m.lx[i] + sR[1] * m.ly[i] + sR[2] * m.lz[i] + t[0]);
+		const double ey = m.gy[i] -
+			(sR[3] * m.lx[i] + sR[4] * m.ly[i] + sR[5] * m.lz[i] + t[1]);
+		const double ez = m.gz[i] -
+			(sR[6] * m.lx[i] + sR[7] * m.ly[i] + sR[8] * m.lz[i] + t[2]);
+		return ex * ex + ey * ey + ez * ez;
+	}
+};
+
+// Returns the number of pairs with a square error below `thr2`, or 0 as soon
+// as it is known to be less than `best`:
+size_t countInliers(
+	const TMatchingPairsSoA& m, const TSimilarity& T, double thr2,
+	const std::atomic<size_t>& best)
+{
+	const size_t N = m.size();
+	const double *gx = m.gx.data(), *gy = m.gy.data(), *gz = m.gz.data();
+	const double *lx = m.lx.data(), *ly = m.ly.data(), *lz = m.lz.data();
+	const double* R = T.sR;
+	const double* t = T.t;
+
+	constexpr size_t BLOCK = 64;
+	size_t nInliers = 0;
+	for (size_t i0 = 0; i0 < N; i0 += BLOCK)
+	{
+		const size_t i1 = std::min(N, i0 + BLOCK);
+		for (size_t i = i0; i < i1; i++)
+		{
+			const double ex =
+				gx[i] - (R[0] * lx[i] + R[1] * ly[i] + R[2] * lz[i] + t[0]);
+			const double ey =
+				gy[i] - (R[3] * lx[i] + R[4] * ly[i] + R[5] * lz[i] + t[1]);
+			const double ez =
+				gz[i] - (R[6] * lx[i] + R[7] * ly[i] + R[8] * lz[i] + t[2]);
+			nInliers += (ex * ex + ey * ey + ez * ez < thr2) ? 1 : 0;
+		}
+		// Early rejection:
+		if (nInliers + (N - i1) < best.load(std::memory_order_relaxed))
+			return 0;
+	}
+	return nInliers;
+}
+
+// The derivative of the robustified square error wrt r2 is the IRLS weight:
+double irlsWeight(TRobustKernelType kernel, double param_sq, double r2)
+{
+	double d1, d2;
+	switch (kernel)
+	{
+		case rkLeastSquares:
+		{
+			RobustKernel<rkLeastSquares> rk;
+			rk.eval(r2, d1, d2);
+			return d1;
+		}
+		case rkPseudoHuber:
+		{
+			RobustKernel<rkPseudoHuber> rk;
+			rk.param_sq = param_sq;
+			rk.eval(r2, d1, d2);
+			return d1;
+		}
+		default:
+			THROW_EXCEPTION("Unknown robust kernel type");
+	}
+}
+
+// se3_l2_robust() for params.ransac_scoreByResiduals=true
+bool se3_l2_robust_residuals(
+	const mrpt::tfest::TMatchingPairList& in_correspondences,
+	const TSE3RobustParams& params, TSE3RobustResult& results)
+{
+	const size_t nCorrs = in_correspondences.size();
+
+	// Minimum number of points to fit the model
+	const size_t n = params.ransac_minSetSize;
+	// Minimum number of points to be considered a good set
+	const size_t d = mrpt::round(nCorrs * params.ransac_maxSetSizePct);
+	const size_t nHyps = params.ransac_nmaxSimulations;
+
+	ASSERT_(n >= 3);
+	ASSERT_GT_(params.ransac_threshold_residual, 0);
+	ASSERTMSG_(
+		d >= n,
+		"Minimum number of points to be considered a good set is < Minimum "
+		"number of points to fit the model");
+
+	// Compatible pairs, as SoA:
+	TMatchingPairsSoA m;
+	m.reserve(nCorrs);
+	for (size_t i = 0; i < nCorrs; i++)
+	{
+		if (params.user_individual_compat_callback)
+		{
+			mrpt::tfest::TPotentialMatch pm;
+			pm.idx_this = in_correspondences[i].globalIdx;
+			pm.idx_other = in_correspondences[i].localIdx;
+			if (!params.user_individual_compat_callback(pm)) continue;
+		}
+		m.push_back(in_correspondences[i], i);
+	}
+	const size_t N = m.size();
+	if (N < d)
+	{
+		if (params.verbose)
+			std::cerr << "[tfest::se3_l2_robust] Only " << N
+					  << " compatible matching pairs, " << d
+					  << " required.\n";
+		return false;
+	}
+
+	// Each hypothesis has its own seed, so results do not depend on the
+	// number of threads. Hypotheses that cannot have more inliers than the
+	// best one so far are aborted, so the first one with the largest number
+	// of inliers is always fully evaluated.
+	std::vector<uint32_t> seeds(nHyps);
+	for (auto& seed : seeds)
+		seed = getRandomGenerator().drawUniform32bit();
+	std::vector<size_t> nInliers(nHyps, 0);
+	std::vector<CPose3DQuat> poses(nHyps);
+	std::vector<double> scales(nHyps, 1.0);
+	std::atomic<size_t> best{0};
+	const double thr2 = square(params.ransac_threshold_residual);
+
+	const auto evalHypothesis = [&](size_t h) {
+		std::mt19937 rng(seeds[h]);
+		std::vector<uint32_t> sample;
+		sample.reserve(n);
+		while (sample.size() < n)
+		{
+			const uint32_t k = rng() % N;
+			if (std::find(sample.begin(), sample.end(), k) == sample.end())
+				sample.push_back(k);
+		}
+		std::vector<TPoint3D> pThis(n), pOther(n);
+		for (size_t j = 0; j < n; j++)
+		{
+			pThis[j] = m.global(sample[j]);
+			pOther[j] = m.local(sample[j]);
+		}
+		if (!mrpt::tfest::internal::se3_l2_weighted(
+				pThis, pOther, nullptr, poses[h], scales[h],
+				params.forceScaleToUnity))
+			return;
+
+		const size_t c =
+			countInliers(m, TSimilarity(poses[h], scales[h]), thr2, best);
+		nInliers[h] = c;
+		size_t b = best.load();
+		while (c > b && !best.compare_exchange_weak(b, c))
+		{
+		}
+	};
+
+	size_t nThreads = params.num_threads;
+	if (!nThreads) nThreads = std::max(1U, std::thread::hardware_concurrency());
+	nThreads = std::min(nThreads, nHyps);
+	if (nThreads > 1)
+	{
+		// The calling thread also evaluates hypotheses:
+		mrpt::WorkerThreadsPool pool(
+			nThreads - 1, mrpt::WorkerThreadsPool::POLICY_FIFO, "se3_ransac");
+		pool.parallel_for(0, nHyps, 1, evalHypothesis);
+	}
+	else
+	{
+		for (size_t h = 0; h < nHyps; h++)
+			evalHypothesis(h);
+	}
+
+	const size_t bestIdx =
+		std::max_element(nInliers.begin(), nInliers.end()) - nInliers.begin();
+	if (nHyps == 0 || nInliers[bestIdx] < d)
+	{
+		if (params.verbose)
+			std::cerr << "[tfest::se3_l2_robust] No hypothesis with at least "
+					  << d << " inliers.\n";
+		return false;
+	}
+	if (params.verbose)
+		std::cout << "[tfest::se3_l2_robust] Best hypothesis: " << bestIdx
+				  << ", with " << nInliers[bestIdx] << "/" << N
+				  << " inliers.\n";
+
+	// IRLS refinement with the inliers of the current estimate:
+	CPose3DQuat q = poses[bestIdx];
+	double scale = scales[bestIdx];
+	const double kernelParam = params.irls_kernel_param > 0
+		? params.irls_kernel_param
+		: params.ransac_threshold_residual / 3;
+
+	std::vector<uint32_t> inliers;
+	std::vector<double> sqErrs;
+	const auto findInliers = [&](const TSimilarity& T) {
+		inliers.clear();
+		sqErrs.clear();
+		for (size_t i = 0; i < N; i++)
+		{
+			const double e2 = T.sqErr(m, i);
+			if (e2 >= thr2) continue;
+			inliers.push_back(i);
+			sqErrs.push_back(e2);
+		}
+	};
+	findInliers(TSimilarity(q, scale));
+
+	std::vector<TPoint3D> pThis, pOther;
+	std::vector<double> weights;
+	for (unsigned int it = 0; it < params.irls_iterations; it++)
+	{
+		const size_t nIn = inliers.size();
+		pThis.resize(nIn);
+		pOther.resize(nIn);
+		weights.resize(nIn);
+		for (size_t j = 0; j < nIn; j++)
+		{
+			pThis[j] = m.global(inliers[j]);
+			pOther[j] = m.local(inliers[j]);
+			weights[j] =
+				irlsWeight(params.irls_kernel, square(kernelParam), sqErrs[j]);
+		}
+		CPose3DQuat newQ;
+		double newScale;
+		if (!mrpt::tfest::internal::se3_l2_weighted(
+				pThis, pOther, weights.data(), newQ, newScale,
+				params.forceScaleToUnity))
+			break;
+
+		const auto prevInliers = inliers;
+		const auto prevSqErrs = sqErrs;
+		findInliers(TSimilarity(newQ, newScale));
+		if (inliers.size() < n)
+		{
+			// Degenerate solution: keep the former one
+			inliers = prevInliers;
+			sqErrs = prevSqErrs;
+			break;
+		}
+		q = newQ;
+		scale = newScale;
+	}
+
+	results.transformation = q;
+	results.scale = scale;
+	results.inliers_idx.resize(inliers.size());
+	double sumSqErr = 0;
+	for (size_t j = 0; j < inliers.size(); j++)
+	{
+		results.inliers_idx[j] = m.idx[inliers[j]];
+		sumSqErr += sqErrs[j];
+	}
+	results.rmse = std::sqrt(sumSqErr / inliers.size());
+	return true;
+}
+}  // namespace
+
 /*---------------------------------------------------------------
 						 se3_l2_robust
   ---------------------------------------------------------------*/
@@ -36,6 +349,9 @@ bool tfest::se3_l2_robust(
 {
 	MRPT_START
 
+	if (params.ransac_scoreByResiduals)
+		return se3_l2_robust_residuals(in_correspondences, params, results);
+
 	const size_t nCorrs = in_correspondences.size();
 
 	// -------------------------------------------
@@ -228,3 +228,62 @@ TEST(tfest, se3_l2_robust)
 					 << outQuat << endl;
 	}
 }
+
+TEST(tfest, se3_l2_robust_scoreByResiduals)
+{
+	const CPose3D gt(0.5, -1.5, 0.75, 30.0_deg, -10.0_deg, 5.0_deg);
+	const CPose3DQuat gtQuat(gt);
+
+	// 60% of inliers with some noise, 40% of random pairs:
+	auto& rng = getRandomGenerator();
+	rng.randomize(123);
+	const size_t nPairs = 1000, nInliers = 600;
+	TMatchingPairList list;
+	for (uint32_t i = 0; i < nPairs; i++)
+	{
+		const TPoint3D local(
+			rng.drawUniform(-10, 10), rng.drawUniform(-10, 10),
+			rng.drawUniform(-2, 2));
+		TPoint3D global;
+		if (i < nInliers)
+			global = gt.composePoint(local) +
+				TPoint3D(rng.drawGaussian1D(0, 0.005),
+						 rng.drawGaussian1D(0, 0.005),
+						 rng.drawGaussian1D(0, 0.005));
+		else
+			global = TPoint3D(
+				rng.drawUniform(-10, 10), rng.drawUniform(-10, 10),
+				rng.drawUniform(-2, 2));
+		list.emplace_back(i, i, TPoint3Df(global), TPoint3Df(local));
+	}
+
+	TSE3RobustParams params;
+	params.ransac_scoreByResiduals = true;
+	params.ransac_minSetSize = 3;
+	params.ransac_maxSetSizePct = 0.4;
+	params.ransac_nmaxSimulations = 200;
+	params.ransac_threshold_residual = 0.03;
+
+	TSE3RobustResult res1;
+	rng.randomize(1);
+	params.num_threads = 1;
+	ASSERT_TRUE(se3_l2_robust(list, params, res1));
+
+	EXPECT_GE(res1.inliers_idx.size(), nInliers - 5);
+	EXPECT_LE(res1.inliers_idx.size(), nInliers + 5);
+	EXPECT_LT((CPose3D(res1.transformation) - gt).translation().norm(), 2e-3);
+	EXPECT_LT(res1.rmse, 0.015);
+
+	// Same result with several threads:
+	TSE3RobustResult res4;
+	rng.randomize(1);
+	params.num_threads = 4;
+	ASSERT_TRUE(se3_l2_robust(list, params, res4));
+	EXPECT_EQ(res1.inliers_idx, res4.inliers_idx);
+	for (unsigned int i = 0; i < 7; i++)
+		EXPECT_DOUBLE_EQ(res1.transformation[i], res4.transformation[i]);
+
+	// Not enough inliers:
+	params.ransac_maxSetSizePct = 0.7;
+	EXPECT_FALSE(se3_l2_robust(list, params, res4));
+}
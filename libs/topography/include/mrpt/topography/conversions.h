@@ -11,6 +11,7 @@
 #include <mrpt/math/TPoint3D.h>
 #include <mrpt/topography/data_types.h>
 
+#include <cstddef>
 #include <vector>
 
 namespace mrpt
@@ -271,6 +272,44 @@ inline void ENU_axes_from_WGS84(
 		in_coords.lon, in_coords.lat, in_coords.height, out_ENU, only_angles);
 }
 
+/** @}
+	======================================================================= */
+
+/** =======================================================================
+   @name Batch conversions of many points
+ * Versions of the conversions above for `N` points at once, given as one
+ * array for each coordinate (structure of arrays). The trigonometric terms of
+ * the reference point and the ellipsoid constants are computed only once, and
+ * the loops over the points have no branches nor calls other than sin(),
+ * cos(), atan2() and sqrt(), so compilers can vectorize them.
+ * Latitudes and longitudes are in degrees, heights and X/Y/Z coordinates in
+ * meters. The output arrays may be the input ones (in-place conversion).
+ * \note (New in MRPT 2.4.9)
+	@{ */
+
+/** Batch version of geodeticToGeocentric() */
+void geodeticToGeocentric(
+	const double* lat, const double* lon, const double* height, double* x,
+	double* y, double* z, size_t N,
+	const TEllipsoid& ellip = TEllipsoid::Ellipsoid_WGS84());
+
+/** Batch version of geocentricToGeodetic() */
+void geocentricToGeodetic(
+	const double* x, const double* y, const double* z, double* lat,
+	double* lon, double* height, size_t N,
+	const TEllipsoid& ellip = TEllipsoid::Ellipsoid_WGS84());
+
+/** Batch version of geocentricToENU_WGS84(): converts geocentric X/Y/Z
+ * coordinates into ENU coordinates relative to `in_coords_origin` */
+void geocentricToENU_WGS84(
+	const double* x_geo, const double* y_geo, const double* z_geo, double* x,
+	double* y, double* z, size_t N, const TGeodeticCoords& in_coords_origin);
+
+/** Batch version of geodeticToENU_WGS84() */
+void geodeticToENU_WGS84(
+	const double* lat, const double* lon, const double* height, double* x,
+	double* y, double* z, size_t N, const TGeodeticCoords& in_coords_origin);
+
 /** @}
 	======================================================================= */
 
@@ -51,6 +51,10 @@ struct TPathFromRTKInfo
  * noise filtering.
  *  \param outInfo [OUT] Optional output: additional information from the
  * optimization
+ *  \param numThreads [IN] Number of threads used to estimate the vehicle pose
+ * of all the epochs (instants with 3 or more GPS readings), which are solved
+ * independently. 0 means the number of CPU cores. Results do not depend on
+ * it. (New in MRPT 2.4.9)
  *
  *  For more details on the method, refer to the paper: (...)
  * \sa mrpt::topography
@@ -59,7 +63,8 @@ void path_from_rtk_gps(
 	mrpt::poses::CPose3DInterpolator& robot_path,
 	const mrpt::obs::CRawlog& rawlog, size_t rawlog_first, size_t rawlog_last,
 	bool isGUI = false, bool disableGPSInterp = false,
-	int path_smooth_filter_size = 2, TPathFromRTKInfo* outInfo = nullptr);
+	int path_smooth_filter_size = 2, TPathFromRTKInfo* outInfo = nullptr,
+	size_t numThreads = 0);
 
 /** @} */  // end of grouping
 
@@ -230,15 +230,14 @@ void mrpt::topography::geodeticToGeocentric(
 	const TGeodeticCoords& in_coords, TGeocentricCoords& out_point,
 	const TEllipsoid& ellip)
 {
-	static const precnum_t a =
-		ellip.sa;  // Semi-major axis of the Earth (meters)
-	static const precnum_t b = ellip.sb;  // Semi-minor axis:
+	const precnum_t a = ellip.sa;  // Semi-major axis of the Earth (meters)
+	const precnum_t b = ellip.sb;  // Semi-minor axis:
 
-	static const precnum_t ae = acos(b / a);  // eccentricity:
-	static const precnum_t cos2_ae_earth =
+	const precnum_t ae = acos(b / a);  // eccentricity:
+	const precnum_t cos2_ae_earth =
 		square(cos(ae));  // The cos^2 of the angular eccentricity of the Earth:
 	// // 0.993305619995739L;
-	static const precnum_t sin2_ae_earth =
+	const precnum_t sin2_ae_earth =
 		square(sin(ae));  // The sin^2 of the angular eccentricity of the Earth:
 	// // 0.006694380004261L;
 
@@ -287,6 +286,104 @@ void mrpt::topography::geocentricToGeodetic(
 	out_coords.lat = RAD2DEG(out_coords.lat);
 }
 
+/*---------------------------------------------------------------
+			Batch conversions
+ ---------------------------------------------------------------*/
+namespace
+{
+// Semi-axes of the Earth used in the *_WGS84() functions:
+constexpr double WGS84_a = 6378137.0, WGS84_b = 6356752.3142;
+
+void geodeticToGeocentricBatch(
+	const double* lat, const double* lon, const double* height, double* x,
+	double* y, double* z, size_t N, const double a, const double b)
+{
+	// cos^2 and sin^2 of the angular eccentricity:
+	const double cos2_ae = square(b / a), sin2_ae = 1.0 - cos2_ae;
+
+	for (size_t i = 0; i < N; i++)
+	{
+		const double la = DEG2RAD(lat[i]), lo = DEG2RAD(lon[i]), h = height[i];
+		const double slat = std::sin(la), clat = std::cos(la);
+
+		// The radius of curvature in the prime vertical:
+		const double Nr = a / std::sqrt(1.0 - sin2_ae * slat * slat);
+
+		x[i] = (Nr + h) * clat * std::cos(lo);
+		y[i] = (Nr + h) * clat * std::sin(lo);
+		z[i] = (cos2_ae * Nr + h) * slat;
+	}
+}
+}  // namespace
+
+void mrpt::topography::geodeticToGeocentric(
+	const double* lat, const double* lon, const double* height, double* x,
+	double* y, double* z, size_t N, const TEllipsoid& ellip)
+{
+	geodeticToGeocentricBatch(lat, lon, height, x, y, z, N, ellip.sa, ellip.sb);
+}
+
+void mrpt::topography::geocentricToGeodetic(
+	const double* x, const double* y, const double* z, double* lat,
+	double* lon, double* height, size_t N, const TEllipsoid& ellip)
+{
+	const double sa2 = ellip.sa * ellip.sa;
+	const double sb2 = ellip.sb * ellip.sb;
+	const double e2 = (sa2 - sb2) / sa2;
+	const double ep2 = (sa2 - sb2) / sb2;
+
+	for (size_t i = 0; i < N; i++)
+	{
+		const double X = x[i], Y = y[i], Z = z[i];
+		const double p = std::sqrt(X * X + Y * Y);
+		const double theta = std::atan2(Z * ellip.sa, p * ellip.sb);
+		const double st = std::sin(theta), ct = std::cos(theta);
+
+		const double la = std::atan2(
+			Z + ep2 * ellip.sb * st * st * st, p - e2 * ellip.sa * ct * ct * ct);
+		const double clat = std::cos(la), slat = std::sin(la);
+		const double Nr = sa2 / std::sqrt(sa2 * clat * clat + sb2 * slat * slat);
+
+		lon[i] = RAD2DEG(std::atan2(Y, X));
+		lat[i] = RAD2DEG(la);
+		height[i] = p / clat - Nr;
+	}
+}
+
+void mrpt::topography::geocentricToENU_WGS84(
+	const double* x_geo, const double* y_geo, const double* z_geo, double* x,
+	double* y, double* z, size_t N, const TGeodeticCoords& in_coords_origin)
+{
+	TPoint3D P_ref;
+	geodeticToGeocentric_WGS84(in_coords_origin, P_ref);
+
+	const double clat = cos(DEG2RAD(in_coords_origin.lat)),
+				 slat = sin(DEG2RAD(in_coords_origin.lat));
+	const double clon = cos(DEG2RAD(in_coords_origin.lon)),
+				 slon = sin(DEG2RAD(in_coords_origin.lon));
+
+	// Transposed rotation matrix from ENU -> ECEF:
+	const double r10 = -clon * slat, r11 = -slon * slat;
+	const double r20 = clon * clat, r21 = slon * clat;
+
+	for (size_t i = 0; i < N; i++)
+	{
+		const double dx = x_geo[i] - P_ref.x, dy = y_geo[i] - P_ref.y,
+					 dz = z_geo[i] - P_ref.z;
+		x[i] = -slon * dx + clon * dy;
+		y[i] = r10 * dx + r11 * dy + clat * dz;
+		z[i] = r20 * dx + r21 * dy + slat * dz;
+	}
+}
+
+void mrpt::topography::geodeticToENU_WGS84(
+	const double* lat, const double* lon, const double* height, double* x,
+	double* y, double* z, size_t N, const TGeodeticCoords& in_coords_origin)
+{
+	geodeticToGeocentricBatch(lat, lon, height, x, y, z, N, WGS84_a, WGS84_b);
+	geocentricToENU_WGS84(x, y, z, x, y, z, N, in_coords_origin);
+}
+
 /*---------------------------------------------------------------
 					UTMToGeodesic
  ---------------------------------------------------------------*/
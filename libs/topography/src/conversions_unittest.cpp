@@ -76,3 +76,56 @@ TEST(TopographyConversion, geodeticToENU_WGS84)
 	EXPECT_NEAR(P.y, 0, 0.1e-3);
 	EXPECT_NEAR(P.z, A_height, 0.1e-3);
 }
+
+TEST(TopographyConversion, batchConversions)
+{
+	const TGeodeticCoords ref(36.714459075, -4.4789588283333330, 38.8887);
+
+	const size_t N = 100;
+	std::vector<double> lat(N), lon(N), h(N), x(N), y(N), z(N);
+	for (size_t i = 0; i < N; i++)
+	{
+		lat[i] = ref.lat + 0.001 * std::sin(i * 0.3);
+		lon[i] = ref.lon + 0.001 * std::cos(i * 0.7);
+		h[i] = ref.height + 10.0 * std::sin(i * 0.1);
+	}
+
+	geodeticToENU_WGS84(
+		lat.data(), lon.data(), h.data(), x.data(), y.data(), z.data(), N, ref);
+	for (size_t i = 0; i < N; i++)
+	{
+		TPoint3D P;
+		geodeticToENU_WGS84(TGeodeticCoords(lat[i], lon[i], h[i]), P, ref);
+		EXPECT_NEAR(x[i], P.x, 1e-6);
+		EXPECT_NEAR(y[i], P.y, 1e-6);
+		EXPECT_NEAR(z[i], P.z, 1e-6);
+	}
+
+	for (const auto& ellip :
+		 {TEllipsoid::Ellipsoid_WGS84(), TEllipsoid::Ellipsoid_Hayford_1909()})
+	{
+		geodeticToGeocentric(
+			lat.data(), lon.data(), h.data(), x.data(), y.data(), z.data(), N,
+			ellip);
+		for (size_t i = 0; i < N; i++)
+		{
+			TGeocentricCoords P;
+			geodeticToGeocentric(
+				TGeodeticCoords(lat[i], lon[i], h[i]), P, ellip);
+			EXPECT_NEAR(x[i], P.x, 1e-6);
+			EXPECT_NEAR(y[i], P.y, 1e-6);
+			EXPECT_NEAR(z[i], P.z, 1e-6);
+		}
+
+		// And back, in place:
+		geocentricToGeodetic(
+			x.data(), y.data(), z.data(), x.data(), y.data(), z.data(), N,
+			ellip);
+		for (size_t i = 0; i < N; i++)
+		{
+			EXPECT_NEAR(x[i], lat[i], 1e-8);
+			EXPECT_NEAR(y[i], lon[i], 1e-8);
+			EXPECT_NEAR(z[i], h[i], 1e-4);
+		}
+	}
+}
@@ -9,6 +9,7 @@
 
 #include "topography-precomp.h"	 // Precompiled headers
 //
+#include <mrpt/core/WorkerThreadsPool.h>
 #include <mrpt/math/data_utils.h>
 #include <mrpt/obs/CObservationGPS.h>
 #include <mrpt/tfest/se3.h>
@@ -16,7 +17,9 @@
 #include <mrpt/topography/data_types.h>
 #include <mrpt/topography/path_from_rtk_gps.h>
 
+#include <algorithm>
 #include <memory>
+#include <thread>
 
 using namespace std;
 using namespace mrpt;
@@ -43,7 +46,8 @@ std::set<T> make_set(const T& v0, const T& v1)
 void mrpt::topography::path_from_rtk_gps(
 	mrpt::poses::CPose3DInterpolator& robot_path,
 	const mrpt::obs::CRawlog& rawlog, size_t first, size_t last, bool isGUI,
-	bool disableGPSInterp, int PATH_SMOOTH_FILTER, TPathFromRTKInfo* outInfo)
+	bool disableGPSInterp, int PATH_SMOOTH_FILTER, TPathFromRTKInfo* outInfo,
+	size_t numThreads)
 {
 	MRPT_START
 
@@ -353,143 +357,175 @@ void mrpt::topography::path_from_rtk_gps(
 			}  // end loop interpolate 1-out-of-5
 		}
 
-		int idx_in_GPSs = 0;
+		// Epochs with 3 or more GPSs are solved independently, in parallel,
+		// by buckets of consecutive epochs:
+		std::vector<TListGPSs::const_iterator> epochs;
+		for (auto i = list_gps_obs.cbegin(); i != list_gps_obs.cend(); ++i)
+			if (i->second.size() >= 3) epochs.push_back(i);
 
-		for (auto i = list_gps_obs.begin(); i != list_gps_obs.end();
-			 ++i, idx_in_GPSs++)
+		if (!ref_valid && !epochs.empty())
 		{
-			// Now check if we have 3 gps with the same time stamp:
-			if (i->second.size() >= 3)
-			{
-				const size_t N = i->second.size();
-				std::map<std::string, CObservationGPS::Ptr>& GPS = i->second;
-				CVectorDouble X(N), Y(N), Z(N);	 // Global XYZ coordinates
-				std::map<string, size_t>
-					XYZidxs;  // Sensor label -> indices in X Y Z
-
-				if (!ref_valid)	 // get the reference lat/lon, if it's not set
-				// from rawlog configuration block.
-				{
-					ref_valid = true;
-					ref = GPS.begin()
-							  ->second->getMsgByClass<gnss::Message_NMEA_GGA>()
-							  .getAsStruct<TGeodeticCoords>();
-				}
+			// get the reference lat/lon, if it's not set from rawlog
+			// configuration block.
+			ref_valid = true;
+			ref = epochs.front()
+					  ->second.begin()
+					  ->second->getMsgByClass<gnss::Message_NMEA_GGA>()
+					  .getAsStruct<TGeodeticCoords>();
+		}
 
-				// Compute the XYZ coordinates of all sensors:
-				TMatchingPairList corrs;
-				unsigned int k;
-				std::map<std::string, CObservationGPS::Ptr>::iterator g_it;
+		// Correction of offsets of each GPS:
+		std::map<std::string, TPoint3D> offsets;
+		for (const auto& label : lstGPSLabels)
+		{
+			const string sect = string("OFFSET_") + label;
+			offsets[label] = TPoint3D(
+				memFil.read_double(sect, "x", 0),
+				memFil.read_double(sect, "y", 0),
+				memFil.read_double(sect, "z", 0));
+		}
 
-				for (k = 0, g_it = GPS.begin(); g_it != GPS.end(); ++g_it, ++k)
-				{
-					TPoint3D P;
-					mrpt::topography::geodeticToENU_WGS84(
-						g_it->second->getMsgByClass<gnss::Message_NMEA_GGA>()
-							.getAsStruct<TGeodeticCoords>(),
-						P, ref);
-
-					// Correction of offsets:
-					const string sect =
-						string("OFFSET_") + g_it->second->sensorLabel;
-					P.x += memFil.read_double(sect, "x", 0);
-					P.y += memFil.read_double(sect, "y", 0);
-					P.z += memFil.read_double(sect, "z", 0);
-
-					XYZidxs[g_it->second->sensorLabel] =
-						k;	// Save index correspondence
-
-					// Create the correspondence:
-					corrs.push_back(TMatchingPair(
-						k, k,  // Indices
-						// "This"/Global coords
-						d2f(P.x), d2f(P.y), d2f(P.z),
-						// "other"/local coordinates
-						d2f(g_it->second->sensorPose.x()),
-						d2f(g_it->second->sensorPose.y()),
-						d2f(g_it->second->sensorPose.z())));
-
-					X[k] = P.x;
-					Y[k] = P.y;
-					Z[k] = P.z;
-				}
+		struct TEpochResult
+		{
+			CPose3D veh_pose;
+			double mahaD = 0;
+			CMatrixDouble66 cov;
+		};
+		std::vector<TEpochResult> results(epochs.size());
+
+		auto solveEpoch = [&](size_t e) {
+			const std::map<std::string, CObservationGPS::Ptr>& GPS =
+				epochs[e]->second;
+			TEpochResult& res = results[e];
+
+			const size_t N = GPS.size();
+			CVectorDouble X(N), Y(N), Z(N);	 // Global XYZ coordinates
+			std::vector<double> lat(N), lon(N), h(N);
+			std::map<string, size_t>
+				XYZidxs;  // Sensor label -> indices in X Y Z
+
+			// Compute the XYZ coordinates of all sensors:
+			size_t k = 0;
+			for (const auto& g : GPS)
+			{
+				const auto& gga =
+					g.second->getMsgByClass<gnss::Message_NMEA_GGA>().fields;
+				lat[k] = gga.latitude_degrees;
+				lon[k] = gga.longitude_degrees;
+				h[k] = gga.altitude_meters;
+				k++;
+			}
+			mrpt::topography::geodeticToENU_WGS84(
+				lat.data(), lon.data(), h.data(), &X[0], &Y[0], &Z[0], N, ref);
 
-				if (doConsistencyCheck && GPS.size() == 3)
-				{
-					// XYZ[k] have the k'd final coordinates of each GPS
-					// GPS[k] are the CObservations:
-
-					// Compute the inter-GPS square distances:
-					CVectorDouble iGPSdist2(3);
-
-					// [0]: sq dist between:
-					// D_cov_rev_indexes[0],D_cov_rev_indexes[1]
-					TPoint3D P0(
-						X[XYZidxs[D_cov_rev_indexes[0]]],
-						Y[XYZidxs[D_cov_rev_indexes[0]]],
-						Z[XYZidxs[D_cov_rev_indexes[0]]]);
-					TPoint3D P1(
-						X[XYZidxs[D_cov_rev_indexes[1]]],
-						Y[XYZidxs[D_cov_rev_indexes[1]]],
-						Z[XYZidxs[D_cov_rev_indexes[1]]]);
-					TPoint3D P2(
-						X[XYZidxs[D_cov_rev_indexes[2]]],
-						Y[XYZidxs[D_cov_rev_indexes[2]]],
-						Z[XYZidxs[D_cov_rev_indexes[2]]]);
-
-					iGPSdist2[0] = P0.sqrDistanceTo(P1);
-					iGPSdist2[1] = P0.sqrDistanceTo(P2);
-					iGPSdist2[2] = P1.sqrDistanceTo(P2);
-
-					double mahaD = mrpt::math::mahalanobisDistance(
-						iGPSdist2, D_mean, D_cov_1);
-					outInfoTemp.mahalabis_quality_measure[i->first] = mahaD;
-
-					// cout << "x: " << iGPSdist2 << " MU: " <<  D_mean << " ->
-					// " << mahaD  << endl;
-				}  // end consistency
-
-				// Use a 6D matching method to estimate the location of the
-				// vehicle:
-				CPose3DQuat optimal_pose;
-				double optimal_scale;
-
-				// "this" (reference map) -> GPS global coordinates
-				// "other" -> GPS local coordinates on the vehicle
-				mrpt::tfest::se3_l2(
-					corrs, optimal_pose, optimal_scale, true);	// Force scale=1
-				// cout << "optimal pose: " << optimal_pose << " " <<
-				// optimal_scale << endl;
-				MRPT_CHECK_NORMAL_NUMBER(optimal_pose.x());
-				MRPT_CHECK_NORMAL_NUMBER(optimal_pose.y());
-				MRPT_CHECK_NORMAL_NUMBER(optimal_pose.z());
-				MRPT_CHECK_NORMAL_NUMBER(optimal_pose.quat().x());
-				MRPT_CHECK_NORMAL_NUMBER(optimal_pose.quat().y());
-				MRPT_CHECK_NORMAL_NUMBER(optimal_pose.quat().z());
-				MRPT_CHECK_NORMAL_NUMBER(optimal_pose.quat().r());
-
-				// Final vehicle pose:
-				const CPose3D veh_pose = CPose3D(optimal_pose);
-
-				// Add to the interpolator:
-				robot_path.insert(i->first, veh_pose);
-
-				// If we have W_star, compute the pose uncertainty:
-				if (doUncertaintyCovs)
-				{
-					CPose3DPDFGaussian final_veh_uncert;
-					final_veh_uncert.mean.setFromValues(0, 0, 0, 0, 0, 0);
-					final_veh_uncert.cov = outInfoTemp.W_star;
+			TMatchingPairList corrs;
+			k = 0;
+			for (const auto& g : GPS)
+			{
+				const TPoint3D& off = offsets.at(g.second->sensorLabel);
+				X[k] += off.x;
+				Y[k] += off.y;
+				Z[k] += off.z;
+
+				XYZidxs[g.second->sensorLabel] =
+					k;	// Save index correspondence
+
+				// Create the correspondence:
+				corrs.push_back(TMatchingPair(
+					k, k,  // Indices
+					// "This"/Global coords
+					d2f(X[k]), d2f(Y[k]), d2f(Z[k]),
+					// "other"/local coordinates
+					d2f(g.second->sensorPose.x()),
+					d2f(g.second->sensorPose.y()),
+					d2f(g.second->sensorPose.z())));
+				k++;
+			}
 
-					// Rotate the covariance according to the real vehicle pose:
-					final_veh_uncert.changeCoordinatesReference(veh_pose);
+			if (doConsistencyCheck && GPS.size() == 3)
+			{
+				// XYZ[k] have the k'd final coordinates of each GPS
+				// GPS[k] are the CObservations:
+
+				// Compute the inter-GPS square distances:
+				CVectorDouble iGPSdist2(3);
+
+				// [0]: sq dist between:
+				// D_cov_rev_indexes[0],D_cov_rev_indexes[1]
+				const size_t i0 = XYZidxs[D_cov_rev_indexes.at(0)],
+							 i1 = XYZidxs[D_cov_rev_indexes.at(1)],
+							 i2 = XYZidxs[D_cov_rev_indexes.at(2)];
+				const TPoint3D P0(X[i0], Y[i0], Z[i0]);
+				const TPoint3D P1(X[i1], Y[i1], Z[i1]);
+				const TPoint3D P2(X[i2], Y[i2], Z[i2]);
+
+				iGPSdist2[0] = P0.sqrDistanceTo(P1);
+				iGPSdist2[1] = P0.sqrDistanceTo(P2);
+				iGPSdist2[2] = P1.sqrDistanceTo(P2);
+
+				res.mahaD = mrpt::math::mahalanobisDistance(
+					iGPSdist2, D_mean, D_cov_1);
+			}  // end consistency
+
+			// Use a 6D matching method to estimate the location of the
+			// vehicle:
+			CPose3DQuat optimal_pose;
+			double optimal_scale;
+
+			// "this" (reference map) -> GPS global coordinates
+			// "other" -> GPS local coordinates on the vehicle
+			mrpt::tfest::se3_l2(
+				corrs, optimal_pose, optimal_scale, true);	// Force scale=1
+			MRPT_CHECK_NORMAL_NUMBER(optimal_pose.x());
+			MRPT_CHECK_NORMAL_NUMBER(optimal_pose.y());
+			MRPT_CHECK_NORMAL_NUMBER(optimal_pose.z());
+			MRPT_CHECK_NORMAL_NUMBER(optimal_pose.quat().x());
+			MRPT_CHECK_NORMAL_NUMBER(optimal_pose.quat().y());
+			MRPT_CHECK_NORMAL_NUMBER(optimal_pose.quat().z());
+			MRPT_CHECK_NORMAL_NUMBER(optimal_pose.quat().r());
+
+			// Final vehicle pose:
+			res.veh_pose = CPose3D(optimal_pose);
+
+			// If we have W_star, compute the pose uncertainty:
+			if (doUncertaintyCovs)
+			{
+				CPose3DPDFGaussian final_veh_uncert;
+				final_veh_uncert.mean.setFromValues(0, 0, 0, 0, 0, 0);
+				final_veh_uncert.cov = outInfoTemp.W_star;
 
-					outInfoTemp.vehicle_uncertainty[i->first] =
-						final_veh_uncert.cov;
-				}
+				// Rotate the covariance according to the real vehicle pose:
+				final_veh_uncert.changeCoordinatesReference(res.veh_pose);
+				res.cov = final_veh_uncert.cov;
 			}
+		};
+
+		size_t nThreads = numThreads;
+		if (!nThreads)
+			nThreads = std::max(1U, std::thread::hardware_concurrency());
+		const size_t EPOCHS_PER_BUCKET = 64;
+		if (nThreads > 1 && epochs.size() > EPOCHS_PER_BUCKET)
+		{
+			mrpt::WorkerThreadsPool pool(
+				nThreads - 1, mrpt::WorkerThreadsPool::POLICY_FIFO,
+				"path_from_rtk");
+			pool.parallel_for(0, epochs.size(), EPOCHS_PER_BUCKET, solveEpoch);
+		}
+		else
+			for (size_t e = 0; e < epochs.size(); e++)
+				solveEpoch(e);
 
-		}  // end for i
+		// Insert the results in time order:
+		for (size_t e = 0; e < epochs.size(); e++)
+		{
+			const auto t = epochs[e]->first;
+			robot_path.insert(t, results[e].veh_pose);
+			if (doConsistencyCheck && epochs[e]->second.size() == 3)
+				outInfoTemp.mahalabis_quality_measure[t] = results[e].mahaD;
+			if (doUncertaintyCovs)
+				outInfoTemp.vehicle_uncertainty[t] = results[e].cov;
+		}
+		results.clear();
 
 		if (PATH_SMOOTH_FILTER > 0 && robot_path.size() > 1)
 		{
@@ -570,21 +606,31 @@ void mrpt::topography::path_from_rtk_gps(
 		const double off_Z = memFil.read_double(sect, "z", 0);
 
 		// map<TTimeStamp,TPoint3D> best_gps_path;		// time -> 3D local
-		// coords
-		for (auto& i : outInfoTemp.best_gps_path)
+		// coords. Convert (lat, lon, height) into X Y Z all at once:
+		auto& path = outInfoTemp.best_gps_path;
+		const size_t nPts = path.size();
+		std::vector<double> lat, lon, h;
+		lat.reserve(nPts);
+		lon.reserve(nPts);
+		h.reserve(nPts);
+		for (const auto& i : path)
+		{
+			lat.push_back(i.second.x);
+			lon.push_back(i.second.y);
+			h.push_back(i.second.z);
+		}
+		mrpt::topography::geodeticToENU_WGS84(
+			lat.data(), lon.data(), h.data(), lat.data(), lon.data(), h.data(),
+			nPts, ref);
+
+		size_t k = 0;
+		for (auto& i : path)
 		{
-			TPoint3D P;
 			TPoint3D& pl = i.second;
-			mrpt::topography::geodeticToENU_WGS84(
-				TGeodeticCoords(
-					pl.x, pl.y, pl.z),	// i->second.x,i->second.y,i->second.z,
-				// // lat, lon, heigh
-				P,	// X Y Z
-				ref);
-
-			pl.x = P.x + off_X;
-			pl.y = P.y + off_Y;
-			pl.z = P.z + off_Z;
+			pl.x = lat[k] + off_X;
+			pl.y = lon[k] + off_Y;
+			pl.z = h[k] + off_Z;
+			k++;
 		}
 	}  // end best_gps_path
 
@@ -87,5 +87,21 @@ TEST(TopographyReconstructPathFrom3RTK, sampleDataset)
 		pose_GT_2.getAs12Vector(p2vec_gt);
 		EXPECT_NEAR((p1vec - p1vec_gt).sum_abs(), 0, 1e-3);
 		EXPECT_NEAR((p2vec - p2vec_gt).sum_abs(), 0, 1e-3);
+
+		// The results do not depend on the number of threads:
+		for (size_t numThreads : {1, 3})
+		{
+			mrpt::poses::CPose3DInterpolator path2;
+			mrpt::topography::path_from_rtk_gps(
+				path2, rawlog, 0, rawlog.size() - 1, false, false, 1, nullptr,
+				numThreads);
+			ASSERT_EQ(path2.size(), robot_path.size());
+			for (auto it1 = robot_path.cbegin(), it2 = path2.cbegin();
+				 it1 != robot_path.cend(); ++it1, ++it2)
+			{
+				EXPECT_EQ(it1->first, it2->first);
+				EXPECT_EQ(it1->second, it2->second);
+			}
+		}
 	}
 }
@@ -152,6 +152,12 @@ class CLandmarksMap : public mrpt::maps::CMetricMap
 		 */
 		mutable bool m_largestDistanceFromOriginIsUpdated{false};
 
+		/** Auxiliary variables used in "getLargestPositionVariance"
+		 * \sa getLargestPositionVariance
+		 */
+		mutable float m_largestPositionVariance{};
+		mutable bool m_largestPositionVarianceIsUpdated{false};
+
 	   public:
 		/** Default constructor
 		 */
@@ -196,6 +202,22 @@ class CLandmarksMap : public mrpt::maps::CMetricMap
 		 */
 		float getLargestDistanceFromOrigin() const;
 
+		/** Returns the largest trace of the covariance matrix of the
+		 * position of any landmark, an upper bound of the variance of any of
+		 * them in any direction (buffered as getLargestDistanceFromOrigin()).
+		 * \note (New in MRPT 2.4.9)
+		 */
+		float getLargestPositionVariance() const;
+
+		/** Returns, in ascending order, the indices of the landmarks whose
+		 * (x,y) coordinates are within a distance `maxDist` of (x,y), looking
+		 * only at the cells of the grid around it.
+		 * \note (New in MRPT 2.4.9)
+		 */
+		void getLandmarksNear2D(
+			double x, double y, double maxDist,
+			std::vector<int32_t>& outIndices) const;
+
 	} landmarks;
 
 	CLandmarksMap() = default;
@@ -17,6 +17,7 @@ MRPT_WARNING(
 	"warning)")
 #endif
 
+#include <mrpt/vision/CBinaryDescriptorMatcher.h>
 #include <mrpt/vision/CDifodo.h>
 #include <mrpt/vision/CFeatureExtraction.h>
 #include <mrpt/vision/CImagePyramid.h>
@@ -0,0 +1,162 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/core/WorkerThreadsPool.h>
+#include <mrpt/core/aligned_std_vector.h>
+#include <mrpt/vision/CFeature.h>
+#include <mrpt/vision/types.h>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace mrpt::vision
+{
+/** \addtogroup  mrptvision_features
+	@{ */
+
+/** Hamming distance between two binary descriptors of `nBytes` bytes each.
+ * Uses the POPCNT instruction if supported by the CPU.
+ * \note (New in MRPT 2.4.9)
+ */
+uint32_t hamming_distance(const uint8_t* a, const uint8_t* b, size_t nBytes);
+
+/** A pairing found by CBinaryDescriptorMatcher: indices of the features in
+ * the first and second lists, and the Hamming distance of their descriptors.
+ * \note (New in MRPT 2.4.9)
+ */
+struct TBinaryDescriptorMatch
+{
+	TBinaryDescriptorMatch() = default;
+	TBinaryDescriptorMatch(size_t i1, size_t i2, uint32_t d)
+		: idx1(i1), idx2(i2), distance(d)
+	{
+	}
+
+	size_t idx1 = 0, idx2 = 0;
+	uint32_t distance = 0;
+};
+
+/** Nearest neighbor matching of binary descriptors (ORB, LATCH, BLD) by their
+ * Hamming distance, with optional Lowe's ratio test and cross-checking.
+ *
+ * Descriptors are first packed into contiguous rows of 64-bit words
+ * (TPackedDescriptors), then each descriptor of the first set is compared
+ * against the second set with one of these methods:
+ *  - Brute force: all the pairs are compared, in blocks which fit in the CPU
+ *    cache, with AVX2 or POPCNT instructions when available.
+ *  - Multi-index hashing (Norouzi et al., "Fast Exact Search in Hamming Space
+ *    with Multi-Index Hashing", TPAMI 2014): descriptors are split into
+ *    16-bit substrings, each indexed in its own hash table, and only those
+ *    descriptors sharing a similar substring with the query are compared.
+ *    The search is exact, that is, it gives the same results as brute force,
+ *    and is much faster for large sets (thousands of descriptors) with close
+ *    neighbors. Queries without close neighbors fall back to brute force.
+ *
+ * Queries are distributed among a pool of threads for large sets.
+ *
+ * \code
+ *  CBinaryDescriptorMatcher matcher;
+ *  matcher.options.descriptor = mrpt::vision::descORB;
+ *  matcher.options.ratioTest = 0.8;
+ *  std::vector<TBinaryDescriptorMatch> matches;
+ *  matcher.match(feats1, feats2, matches);
+ * \endcode
+ *
+ * \note (New in MRPT 2.4.9)
+ */
+class CBinaryDescriptorMatcher
+{
+   public:
+	enum TSearchMethod : uint8_t
+	{
+		/** Multi-index hashing for sets of at least
+		 * TOptions::mihMinSetSize descriptors, brute force otherwise */
+		smAuto = 0,
+		smBruteForce,
+		smMultiIndexHashing
+	};
+
+	struct TOptions
+	{
+		/** One of descORB, descLATCH, descBLD */
+		TDescriptorType descriptor = descORB;
+		/** Maximum Hamming distance (in bits) of a valid pairing */
+		uint32_t maxDistance = 64;
+		/** Lowe's ratio test: pairings are only accepted if the distance to
+		 * the best candidate is below this ratio times the distance to the
+		 * second best one. Zero disables it. */
+		double ratioTest = 0.8;
+		/** Only keep pairings (i,j) where i is also the best match of j in
+		 * the first set */
+		bool crossCheck = true;
+		TSearchMethod method = smAuto;
+		/** See smAuto */
+		size_t mihMinSetSize = 4096;
+		/** Number of threads (0: as many as CPU cores) */
+		size_t numThreads = 0;
+		/** Queries are run in parallel only for sets larger than this */
+		size_t minQueriesForParallel = 256;
+		/** Use AVX2 or POPCNT instructions if supported by the CPU */
+		bool useSIMD = true;
+	};
+
+	TOptions options;
+
+	/** A set of binary descriptors of the same length, stored as rows of
+	 * `stride` 64-bit words (zero padded to a multiple of 32 bytes). */
+	struct TPackedDescriptors
+	{
+		size_t rows = 0, bytesPerRow = 0, stride = 0;
+		mrpt::aligned_std_vector<uint64_t> data;
+
+		const uint64_t* row(size_t i) const { return &data[i * stride]; }
+		size_t bits() const { return bytesPerRow * 8; }
+
+		/** Allocates and zeroes `n` rows of `bytes` bytes each */
+		void resize(size_t n, size_t bytes);
+		/** Copies one descriptor into row `i` */
+		void setRow(size_t i, const uint8_t* desc);
+	};
+
+	/** Builds the packed set of descriptors of a given type (descORB,
+	 * descLATCH, descBLD) from a feature list. All features must have that
+	 * descriptor, with the same length. */
+	static void packDescriptors(
+		const CFeatureList& feats, TDescriptorType descriptor,
+		TPackedDescriptors& out);
+
+	/** Finds matches between two feature lists, using the descriptor in
+	 * TOptions::descriptor. Matches are sorted by their index in `list1`. */
+	void match(
+		const CFeatureList& list1, const CFeatureList& list2,
+		std::vector<TBinaryDescriptorMatch>& matches);
+
+	/** \overload Returns pairs of features */
+	void match(
+		const CFeatureList& list1, const CFeatureList& list2,
+		CMatchedFeatureList& matches);
+
+	/** \overload For already packed descriptors */
+	void match(
+		const TPackedDescriptors& set1, const TPackedDescriptors& set2,
+		std::vector<TBinaryDescriptorMatch>& matches);
+
+   private:
+	std::shared_ptr<mrpt::WorkerThreadsPool> m_threadPool;
+
+	void internal_forEachChunk(
+		size_t nQueries, size_t nChunks,
+		const std::function<void(size_t)>& fn);
+};
+
+/** @} */
+}  // namespace mrpt::vision
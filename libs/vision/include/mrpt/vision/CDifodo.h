@@ -14,6 +14,16 @@
 #include <mrpt/math/TTwist3D.h>
 #include <mrpt/poses/CPose3D.h>
 
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+
+namespace mrpt
+{
+class WorkerThreadsPool;
+}
+
 namespace mrpt::vision
 {
 /** This abstract class implements a method called "Difodo" to perform Visual
@@ -32,6 +42,11 @@ namespace mrpt::vision
  *		- Call loadFrame();
  *		- Call odometryCalculation();
  *
+ * All the steps run in parallel by bands of image rows, see num_threads. To
+ * overlap the loading and pyramid of each frame with the solver of the
+ * previous one, use odometryCalculationAsync() + waitForOdometry() instead of
+ * odometryCalculation().
+ *
  *	For further information have a look at the apps:
  *    -
  *[DifOdometry-Camera](http://www.mrpt.org/list-of-mrpt-apps/application-difodometry-camera/)
@@ -76,6 +91,11 @@ class CDifodo
 	std::vector<mrpt::math::CMatrixFloat> yy_inter;
 	std::vector<mrpt::math::CMatrixFloat> yy_old;
 	std::vector<mrpt::math::CMatrixFloat> yy_warped;
+	/** The pyramid of the next frame, built while the solver may still be
+	 * running for the current one (see odometryCalculationAsync()) */
+	std::vector<mrpt::math::CMatrixFloat> depth_next;
+	std::vector<mrpt::math::CMatrixFloat> xx_next;
+	std::vector<mrpt::math::CMatrixFloat> yy_next;
 
 	/** Matrices that store the depth derivatives */
 	mrpt::math::CMatrixFloat du;
@@ -90,6 +110,12 @@ class CDifodo
 	 * or not (null = 00).*/
 	mrpt::math::CMatrixBool null;
 
+	/** Aux buffers, kept between frames to avoid reallocations: weights of
+	 * the warped depth, and connectivity along rows and cols */
+	mrpt::math::CMatrixFloat wacu;
+	mrpt::math::CMatrixFloat rx_ninv;
+	mrpt::math::CMatrixFloat ry_ninv;
+
 	/** Least squares covariance matrix */
 	mrpt::math::CMatrixFloat66 est_cov;
 
@@ -187,6 +213,20 @@ class CDifodo
 	/** Update camera pose and the velocities for the filter */
 	void poseUpdate();
 
+	/** Builds the pyramid of depth_wf into depth_next, xx_next, yy_next,
+	 * with the method of buildCoordinatesPyramidFast() if `fast`, or that of
+	 * buildCoordinatesPyramid() otherwise. It only modifies those and
+	 * depth_wf, so it can run while the solver works on the current and
+	 * former frames. */
+	void buildNextPyramid(bool fast);
+
+	/** The former "next" pyramid becomes the current one, and the current
+	 * one the "old" one. */
+	void pushPyramid();
+
+	/** The coarse-to-fine solver and the pose update */
+	void solveAllLevels();
+
    public:
 	/** Frames per second (Hz) */
 	double fps;
@@ -207,6 +247,10 @@ class CDifodo
 	/** Execution time (ms) */
 	float execution_time;
 
+	/** Number of threads for all the steps of the method (0: as many as CPU
+	 * cores, 1: single-threaded). (New in MRPT 2.4.9) */
+	unsigned int num_threads = 0;
+
 	/** Camera poses */
 	/** Last camera pose */
 	mrpt::poses::CPose3D cam_pose;
@@ -218,6 +262,22 @@ class CDifodo
 		and updates the camera pose */
 	void odometryCalculation();
 
+	/** Like odometryCalculation(), but the solver runs in a background
+	 * thread: this builds the pyramid of the frame just loaded (while the
+	 * solver of the former frame may be still running), waits for that solver
+	 * to end and starts the solver of the new frame, and returns. loadFrame()
+	 * can then be called right away for the next frame.
+	 *
+	 * The results (cam_pose, execution_time, the getters, ...) are only
+	 * valid after waitForOdometry().
+	 * \note (New in MRPT 2.4.9) */
+	void odometryCalculationAsync();
+
+	/** Waits for the end of the solver started by the last call to
+	 * odometryCalculationAsync(), if any, rethrowing its exceptions.
+	 * \note (New in MRPT 2.4.9) */
+	void waitForOdometry();
+
 	/** Get the rows and cols of the depth image that are considered by the
 	 * visual odometry method. */
 	inline void getRowsAndCols(
@@ -303,5 +363,21 @@ class CDifodo
 
 	// Constructor. Initialize variables and matrix sizes
 	CDifodo();
+	virtual ~CDifodo();
+
+   private:
+	std::shared_ptr<mrpt::WorkerThreadsPool> m_threadPool;
+	std::shared_ptr<mrpt::WorkerThreadsPool> m_solverThread;
+	std::mutex m_threadPoolMtx;
+	std::future<void> m_pendingSolver;
+	/** Time (ms) to build the pyramid of the frame being solved in the
+	 * background */
+	float m_pyramidTime = 0;
+
+	/** Runs `fn(band, firstRow, endRow)` for all the bands of rows of an
+	 * image of `nRows` rows */
+	void internal_forEachBand(
+		unsigned int nRows,
+		const std::function<void(size_t, unsigned int, unsigned int)>& fn);
 };
 }  // namespace mrpt::vision
@@ -15,6 +15,15 @@
 #include <mrpt/vision/TKeyPoint.h>
 #include <mrpt/vision/utils.h>
 
+#include <functional>
+#include <memory>
+
+namespace mrpt
+{
+// Frwd decl:
+class WorkerThreadsPool;
+}  // namespace mrpt
+
 namespace mrpt::vision
 {
 /** The central class from which images can be analyzed in search of different
@@ -286,6 +295,39 @@ class CFeatureExtraction
 			bool rotationInvariance{true};
 			int half_ssd_size{3};
 		} LATCHOptions;
+
+		/** Tiled, parallel detection and descriptor computation.
+		 * \sa detectFeatures, computeDescriptors
+		 * \note (New in MRPT 2.4.9) */
+		struct TTilingOptions
+		{
+			/** If true, the image (or ROI) is split into square cells which
+			 * are processed in parallel (default=false) */
+			bool enabled{false};
+			/** Size of each cell, in pixels (default=256) */
+			unsigned int tileSize{256};
+			/** Extra pixels around each cell seen by the detector, so
+			 * features near cell borders are detected as in the whole
+			 * image. At least patchSize/2+1 is always used (default=16) */
+			unsigned int overlap{16};
+			/** Maximum number of features kept per cell, the strongest ones.
+			 * If 0, nDesiredFeatures divided by the number of cells is used,
+			 * or no limit if nDesiredFeatures=0 (default=0) */
+			unsigned int maxFeaturesPerTile{0};
+			/** Features closer than this distance (pixels) to a stronger
+			 * one from another cell are removed. 0 disables this
+			 * non-maximum suppression at cell boundaries (default=3) */
+			float boundaryNMSRadius{3.0f};
+			/** Extra pixels around each cell available to descriptors.
+			 * Patch-based descriptors also use their radius, if larger
+			 * (default=64) */
+			unsigned int descriptorMargin{64};
+			/** Minimum number of features for computeDescriptors() to use
+			 * cells (default=64) */
+			unsigned int minFeaturesForParallelDescriptors{64};
+			/** Number of threads, 0: one per CPU core (default=0) */
+			unsigned int numThreads{0};
+		} tiling;
 	};
 
 	/** Set all the parameters of the desired method here before calling
@@ -299,6 +341,13 @@ class CFeatureExtraction
 	 * nDesiredFeatures (op. input) Number of features to be extracted.
 	 * Default: all possible.
 	 *
+	 * If TOptions::tiling is enabled, the detector runs in parallel over
+	 * overlapping cells of the image, each one with its own budget of
+	 * features (which also spreads them more evenly over the image), and
+	 * results are merged sorted by decreasing response, with a non-maximum
+	 * suppression at cell boundaries. Relative thresholds (e.g. in KLT) are
+	 * then relative to each cell. featLSD line segments are never tiled.
+	 *
 	 * \sa computeDescriptors
 	 */
 	void detectFeatures(
@@ -327,12 +376,32 @@ class CFeatureExtraction
 	 * CFeatureExtraction::TOptions::SIFTOptions.
 	 *
 	 * \note This call will also use additional parameters from \a options
+	 *
+	 * \note If TOptions::tiling is enabled, descriptors are computed in
+	 * parallel for the features of each cell, over that cell and its
+	 * surrounding TTilingOptions::descriptorMargin pixels. The order of
+	 * features is kept. BLD line descriptors are never tiled.
 	 */
 	void computeDescriptors(
 		const mrpt::img::CImage& in_img, CFeatureList& inout_features,
 		TDescriptorType in_descriptor_list);
 
    private:
+	/** Created upon first use by tiled detection or descriptors */
+	std::shared_ptr<mrpt::WorkerThreadsPool> m_threadPool;
+
+	/** Runs fn(i) for i in [0,n), in parallel if tiling.numThreads!=1 */
+	void internal_forEachTile(size_t n, const std::function<void(size_t)>& fn);
+
+	void internal_detectFeaturesTiled(
+		const mrpt::img::CImage& img, CFeatureList& feats,
+		unsigned int init_ID, unsigned int nDesiredFeatures,
+		const TImageROI& ROI);
+
+	void internal_computeDescriptorsTiled(
+		const mrpt::img::CImage& in_img, CFeatureList& inout_features,
+		TDescriptorType in_descriptor_list);
+
 	/** Compute the SIFT descriptor of the provided features into the input
 	image
 	* \param in_img (input) The image from where to compute the descriptors.
@@ -11,8 +11,26 @@
 
 #include <mrpt/img/CImage.h>
 
+#include <cstdint>
+
 namespace mrpt::vision
 {
+/** Filters to halve images in CImagePyramid::buildPyramid()
+ * \note (New in MRPT 2.4.9)
+ * \ingroup mrpt_vision_grp
+ */
+enum class PyramidFilter : uint8_t
+{
+	/** 1:2 decimation: takes the top-left pixel of each 2x2 block */
+	Decimate = 0,
+	/** Arithmetic mean of each 2x2 block */
+	Mean2x2,
+	/** 5x5 Gaussian kernel ([1 4 6 4 1]/16 in each direction) centered at
+	 * the even pixels, as in cv::pyrDown(), with the smoothing fused into the
+	 * downsampling. Output images are floor(w/2) x floor(h/2). */
+	Gaussian5
+};
+
 /** Holds and builds a pyramid of images: starting with an image at full
  * resolution (octave=1), it builds
  *  a number of half-resolution images: octave=2 at 1/2 , octave=3 at 1/2^2,
@@ -22,8 +40,17 @@ namespace mrpt::vision
  * only grayscale pyramids can be built from
  *   grayscale images.
  *
- *  The algorithm to halve the images can be either a 1:2 decimation or a
- * smooth filter (arithmetic mean of every 4 pixels).
+ *  The algorithm to halve the images can be either a 1:2 decimation, a
+ * smooth filter (arithmetic mean of every 4 pixels) or a 5x5 Gaussian
+ * filter (see PyramidFilter).
+ *
+ *  Pyramids are meant to be rebuilt for each new frame: the buffers of the
+ * former levels are reused (overwritten) whenever they have the right size
+ * and are not shared with any other CImage. Otherwise, new ones are taken
+ * from the pool of pixel buffers (see mrpt::img::CImageBufferPool).
+ * When converting color images to grayscale, the conversion and the 2nd
+ * octave are built in a single pass over bands of rows, while they are still
+ * in the CPU cache (see \a fusedGrayscale).
  *
  *  Pyramids are built by invoking the method \a buildPyramid() or \a
  * buildPyramidFast()
@@ -46,7 +73,8 @@ namespace mrpt::vision
  * \endcode
  *
  *  \note Both converting to grayscale and building the octave images have
- * SSE2-optimized implementations (if available).
+ * SSE2-optimized implementations (if available). The Gaussian filter has AVX2
+ * and NEON versions.
  *
  * \sa mrpt::img::CImage
  * \ingroup mrpt_vision_grp
@@ -74,6 +102,15 @@ class CImagePyramid
 		const mrpt::img::CImage& img, const size_t nOctaves,
 		const bool smooth_halves = true, const bool convert_grayscale = false);
 
+	/** \overload With a choice of filter to halve images.
+	 * \return true if SIMD-optimized versions were used to build **all** the
+	 * scales in the pyramid.
+	 * \note (New in MRPT 2.4.9)
+	 */
+	bool buildPyramid(
+		const mrpt::img::CImage& img, const size_t nOctaves,
+		const PyramidFilter filter, const bool convert_grayscale = false);
+
 	/**  Exactly like \a buildPyramid(), but if the input image has not to be
 	 * converted from RGB to grayscale, the image data buffer is *reutilized*
 	 *   for the 1st octave in \a images[0], emptying the input image.
@@ -83,6 +120,12 @@ class CImagePyramid
 		mrpt::img::CImage& img, const size_t nOctaves,
 		const bool smooth_halves = true, const bool convert_grayscale = false);
 
+	/** \overload With a choice of filter to halve images.
+	 * \note (New in MRPT 2.4.9) */
+	bool buildPyramidFast(
+		mrpt::img::CImage& img, const size_t nOctaves,
+		const PyramidFilter filter, const bool convert_grayscale = false);
+
 	/** The individual images:
 	 *  - images[0]: 1st octave (full-size)
 	 *  - images[1]: 2nd octave (1/2 size)
@@ -91,5 +134,23 @@ class CImagePyramid
 	 *  - images[i]: (i+1)-th octave (1/2^i size)
 	 */
 	std::vector<mrpt::img::CImage> images;
+
+	/** If >0, each level is allocated with this many extra pixels around it,
+	 * filled by reflection (cv::BORDER_REFLECT_101), and `images[i]` are
+	 * views of their central part. The 1st octave is then always a copy of
+	 * the input image. Set it (at least) to the window size to pass the
+	 * levels to cv::calcOpticalFlowPyrLK() (default: 0).
+	 * \note (New in MRPT 2.4.9) */
+	unsigned int borderPadding = 0;
+
+	/** Convert to grayscale and build the 2nd octave in one pass, see
+	 * buildPyramid() (default: true).
+	 * \note (New in MRPT 2.4.9) */
+	bool fusedGrayscale = true;
+
+	/** Use the AVX2 or NEON versions of the Gaussian filter, if supported by
+	 * the CPU (default: true).
+	 * \note (New in MRPT 2.4.9) */
+	bool useSIMD = true;
 };
 }  // namespace mrpt::vision
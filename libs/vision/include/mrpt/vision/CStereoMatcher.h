@@ -0,0 +1,179 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/core/WorkerThreadsPool.h>
+#include <mrpt/img/CImage.h>
+#include <mrpt/math/CMatrixDynamic.h>
+#include <mrpt/obs/CObservation3DRangeScan.h>
+#include <mrpt/obs/CObservationStereoImages.h>
+#include <mrpt/vision/CStereoRectifyMap.h>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace mrpt::vision
+{
+/** Dense stereo matching, from a pair of stereo images to a disparity map,
+ * or from a mrpt::obs::CObservationStereoImages to a depth image in a
+ * mrpt::obs::CObservation3DRangeScan, without OpenCV (but for the
+ * computation of the rectification maps).
+ *
+ * The matching cost of two pixels is the Hamming distance of their 5x5
+ * census transforms (robust to changes of brightness between both cameras),
+ * computed with POPCNT or AVX2 instructions when available. Costs are then
+ * aggregated with one of these methods:
+ *  - smBlockMatching: the sum of costs over a square window around each
+ * pixel (fast, but blurs depth discontinuities).
+ *  - smSemiGlobal: semi-global matching (SGM) along 4 paths (left-right,
+ * right-left, top-bottom and bottom-top), with penalties P1 and P2 for
+ * changes of disparity of one or more pixels. See: H. Hirschmuller, "Stereo
+ * Processing by Semiglobal Matching and Mutual Information", IEEE TPAMI,
+ * 2008.
+ *
+ * The disparity of each pixel is that of minimum aggregated cost, optionally
+ * rejected if it is not unique or fails the left-right consistency check,
+ * and refined to subpixel precision with a parabola. All the stages run in
+ * parallel, in bands of rows (or of columns, for vertical SGM paths).
+ *
+ * processObservation() is a complete pipeline stage: it rectifies the images
+ * with a CStereoRectifyMap (computed once and kept while the camera
+ * parameters of the observations do not change), computes the disparity of
+ * the left image, and fills in the depth image, intrinsics and pose of a
+ * CObservation3DRangeScan, ready for unprojectInto().
+ *
+ * \code
+ *  mrpt::vision::CStereoMatcher matcher;
+ *  matcher.options.method = CStereoMatcher::smSemiGlobal;
+ *  matcher.options.numDisparities = 96;
+ *  mrpt::obs::CObservation3DRangeScan obs3D;
+ *  matcher.processObservation(*obsStereo, obs3D);
+ *  mrpt::maps::CSimplePointsMap pts;
+ *  obs3D.unprojectInto(pts);
+ * \endcode
+ *
+ * \sa CStereoRectifyMap
+ * \ingroup mrpt_vision_grp
+ * \note (New in MRPT 2.4.9)
+ */
+class CStereoMatcher
+{
+   public:
+	enum TMethod : uint8_t
+	{
+		smBlockMatching = 0,
+		smSemiGlobal
+	};
+
+	/** Disparity of the pixels without a valid match */
+	static constexpr float INVALID_DISPARITY = -1.0f;
+
+	struct TOptions
+	{
+		TMethod method = smSemiGlobal;
+		/** Minimum disparity (>=0), in pixels */
+		int minDisparity = 0;
+		/** Number of disparities searched for, from minDisparity (a multiple
+		 * of 16) */
+		int numDisparities = 64;
+		/** smBlockMatching: half the size of the aggregation window */
+		int blockRadius = 3;
+		/** smSemiGlobal: penalty of changes of disparity of one pixel along
+		 * a path, in the same units than the costs (census bits, 0-24) */
+		uint16_t P1 = 4;
+		/** smSemiGlobal: penalty of larger changes of disparity (>P1) */
+		uint16_t P2 = 40;
+		/** A disparity is rejected if the cost of any other one (but its
+		 * neighbors) is not at least this percent larger (0: disabled) */
+		int uniquenessRatio = 10;
+		/** Reject disparities if the match from the right image back to the
+		 * left one differs in more than leftRightMaxDiff pixels */
+		bool leftRightCheck = true;
+		int leftRightMaxDiff = 1;
+		/** Refine disparities with a parabola fit to the costs */
+		bool subpixel = true;
+		/** processObservation(): match images of half the width and height
+		 * of the rectified images (4 times faster) */
+		bool halfResolution = false;
+		/** processObservation(): points farther than this (meters) are
+		 * discarded */
+		float maxDepth = 20.0f;
+		/** Number of threads (0: as many as CPU cores) */
+		size_t numThreads = 0;
+		/** Images with fewer pixels than this are processed by the calling
+		 * thread only */
+		size_t minPixelsForParallel = 320 * 240;
+		/** Use POPCNT or AVX2 instructions if supported by the CPU */
+		bool useSIMD = true;
+	};
+
+	TOptions options;
+
+	CStereoMatcher() = default;
+
+	/** Computes the disparity map of a pair of rectified grayscale (or color,
+	 * converted on the fly) images of the same size: `disparity(r,c)` is the
+	 * disparity, in pixels, of the left image pixel (c,r), that is, it
+	 * matches the right image pixel (c-disparity,r); or INVALID_DISPARITY
+	 * if there is no valid match. */
+	void computeDisparity(
+		const mrpt::img::CImage& left, const mrpt::img::CImage& right,
+		mrpt::math::CMatrixFloat& disparity);
+
+	/** \overload For 8-bit grayscale images in memory buffers of `height`
+	 * rows of `rowStride` bytes each (with `width` pixels). */
+	void computeDisparity(
+		const uint8_t* left, const uint8_t* right, size_t width, size_t height,
+		size_t rowStride, mrpt::math::CMatrixFloat& disparity);
+
+	/** Rectifies the images of a stereo observation (unless they are already
+	 * rectified, see CObservationStereoImages::areImagesRectified()),
+	 * computes their disparity and stores the resulting depth image into
+	 * `out`, along with the intrinsics of the rectified left camera (as both
+	 * the depth and intensity cameras), its pose on the robot, the timestamp
+	 * and sensor label of the input observation. The rectified left image is
+	 * stored as the (grayscale) intensity image.
+	 */
+	void processObservation(
+		const mrpt::obs::CObservationStereoImages& in,
+		mrpt::obs::CObservation3DRangeScan& out);
+
+	/** The rectification maps used by processObservation(). Its options
+	 * (e.g. CStereoRectifyMap::setAlpha()) can be changed before the first
+	 * call, which computes them from the camera parameters of the
+	 * observation, if they were not set already. */
+	CStereoRectifyMap& rectifyMap() { return m_rectify; }
+	const CStereoRectifyMap& rectifyMap() const { return m_rectify; }
+
+	/** The disparity map computed by the last call to processObservation() */
+	const mrpt::math::CMatrixFloat& lastDisparity() const { return m_disp; }
+
+   private:
+	CStereoRectifyMap m_rectify;
+	mrpt::math::CMatrixFloat m_disp;
+
+	/** Census transforms of both images, row-major */
+	std::vector<uint32_t> m_censusL, m_censusR;
+	/** Matching costs, of W*H*numDisparities */
+	std::vector<uint8_t> m_costs;
+	/** Aggregated costs, of W*H*numDisparities */
+	std::vector<uint16_t> m_aggr;
+
+	mutable std::shared_ptr<mrpt::WorkerThreadsPool> m_threadPool;
+
+	/** Runs fn(first,last) for bands of [0,n), in parallel if the image of
+	 * `nPixels` is large enough */
+	void internal_forBands(
+		size_t n, size_t nPixels,
+		const std::function<void(size_t, size_t)>& fn) const;
+};
+
+}  // namespace mrpt::vision
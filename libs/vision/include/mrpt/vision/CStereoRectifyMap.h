@@ -12,6 +12,9 @@
 #include <mrpt/img/TStereoCamera.h>
 #include <mrpt/obs/CObservationStereoImages.h>
 #include <mrpt/poses/CPose3DQuat.h>
+#include <mrpt/vision/TRemapOptions.h>
+
+#include <string>
 
 namespace mrpt::vision
 {
@@ -31,6 +34,12 @@ namespace mrpt::vision
  *
  *  Works with grayscale or color images.
  *
+ * Maps are kept in fixed point (the format of cv::convertMaps() with
+ * CV_16SC2), and both images are remapped in parallel bands of rows,
+ * optionally converted to grayscale and downscaled to half the resolution in
+ * the same pass (see TRemapOptions). Maps can be cached on disk with
+ * setMapCacheDirectory(), so they are only computed once per calibration.
+ *
  *  Refer to the program stereo-calib-gui for a tool that generates the
  * required stereo camera parameters
  *  from a set of stereo images of a checkerboard.
@@ -208,6 +217,15 @@ class CStereoRectifyMap
 		std::vector<int16_t>& left_x, std::vector<uint16_t>& left_y,
 		std::vector<int16_t>& right_x, std::vector<uint16_t>& right_y);
 
+	/** If not empty, setFromCamParams() loads the maps (and the rectified
+	 * camera parameters) from a file in this directory, named after a hash of
+	 * the camera parameters and the options of the maps (alpha, output size,
+	 * etc.), or computes and saves them there (if it can be written) if it
+	 * does not exist yet.
+	 * \note (New in MRPT 2.4.9) */
+	void setMapCacheDirectory(const std::string& dir) { m_cache_dir = dir; }
+	const std::string& getMapCacheDirectory() const { return m_cache_dir; }
+
 	/** @} */
 
 	/** @name Rectify methods
@@ -232,6 +250,18 @@ class CStereoRectifyMap
 		mrpt::img::CImage& out_left_image,
 		mrpt::img::CImage& out_right_image) const;
 
+	/** \overload With options for the conversion to grayscale, downscaling
+	 * and multithreading. Bands of rows of both images are remapped in
+	 * parallel.
+	 * \note With TRemapOptions::halfResolution, the intrinsic parameters of
+	 * the output images are those of getRectifiedImageParams() scaled by 1/2.
+	 * \note (New in MRPT 2.4.9) */
+	void rectify(
+		const mrpt::img::CImage& in_left_image,
+		const mrpt::img::CImage& in_right_image,
+		mrpt::img::CImage& out_left_image, mrpt::img::CImage& out_right_image,
+		const TRemapOptions& opts) const;
+
 	/** Overloaded version for in-place rectification of image pairs stored in a
 	 * mrpt::obs::CObservationStereoImages.
 	 *  Upon return, the new camera intrinsic parameters will be already stored
@@ -275,7 +305,11 @@ class CStereoRectifyMap
 	 * plane is the same after rectification. */
 	mrpt::poses::CPose3DQuat m_rot_left, m_rot_right;
 
+	std::string m_cache_dir;
+
 	void internal_invalidate();
+	bool internal_loadCache(const std::string& file);
+	bool internal_saveCache(const std::string& file) const;
 
 };	// end class
 
@@ -0,0 +1,155 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/core/WorkerThreadsPool.h>
+#include <mrpt/img/CImage.h>
+#include <mrpt/math/CMatrixDynamic.h>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace mrpt::vision
+{
+/** \addtogroup  mrptvision_features
+	@{ */
+
+/** Normalized cross correlation (NCC) of grayscale patches against an image,
+ * without OpenCV.
+ *
+ * The sums of the pixels and of their squares over any window of the image
+ * come from integral images, built once by setImage(), so only the inner
+ * products of the patch with the image are computed for each candidate
+ * position, with AVX2 or NEON instructions when available, for many
+ * positions at a time.
+ *
+ * Many patches (e.g. those of a list of features) can be searched for, each
+ * within its own window, in one call to match(), in parallel. The correlation
+ * of two patches of the same size is given by patchCorrelation().
+ *
+ * \code
+ *  CTemplateMatcher matcher;
+ *  matcher.setImage(img);
+ *  std::vector<CTemplateMatcher::TSearch> searches;
+ *  for (const auto& f : feats)
+ *    searches.emplace_back(&*f.patch, f.keypoint.pt.x - 20 - hw,
+ *                          f.keypoint.pt.y - 20 - hw, 40, 40);
+ *  std::vector<CTemplateMatcher::TMatch> matches;
+ *  matcher.match(searches, matches);
+ * \endcode
+ *
+ * \sa openCV_cross_correlation
+ * \note (New in MRPT 2.4.9)
+ */
+class CTemplateMatcher
+{
+   public:
+	enum TMethod : uint8_t
+	{
+		/** sum(I*T) / sqrt(sum(I^2) sum(T^2)), as cv::TM_CCORR_NORMED and
+		 * openCV_cross_correlation() */
+		nccRaw = 0,
+		/** The same for the zero-mean image window and patch, as
+		 * cv::TM_CCOEFF_NORMED. Invariant to changes of brightness. */
+		nccZeroMean
+	};
+
+	struct TOptions
+	{
+		TMethod method = nccRaw;
+		/** Number of threads for match() (0: as many as CPU cores) */
+		size_t numThreads = 0;
+		/** Searches are run in parallel only if there are at least these */
+		size_t minSearchesForParallel = 16;
+		/** Use AVX2 or NEON instructions if supported by the CPU */
+		bool useSIMD = true;
+	};
+
+	TOptions options;
+
+	/** A search of a patch within a window of the image, as in
+	 * openCV_cross_correlation(): the top-left corner of the patch is placed
+	 * at all the positions from (x_ini,y_ini) to (x_ini+x_size,
+	 * y_ini+y_size), clipped to the image. Negative values search the whole
+	 * image. */
+	struct TSearch
+	{
+		TSearch() = default;
+		TSearch(
+			const mrpt::img::CImage* p, int xIni, int yIni, int xSize,
+			int ySize)
+			: patch(p), x_ini(xIni), y_ini(yIni), x_size(xSize), y_size(ySize)
+		{
+		}
+
+		/** A grayscale (or color, converted on the fly) 8-bit image */
+		const mrpt::img::CImage* patch = nullptr;
+		int x_ini = -1, y_ini = -1, x_size = -1, y_size = -1;
+	};
+
+	/** The best position of a patch: coordinates of the patch center in the
+	 * image (top-left + (size-1)/2, as openCV_cross_correlation()), and its
+	 * correlation, in [-1,1]. x=y=-1 if the patch did not fit. */
+	struct TMatch
+	{
+		int x = -1, y = -1;
+		float score = -1;
+	};
+
+	CTemplateMatcher() = default;
+
+	/** Sets the image to search in (converted to grayscale, if needed), and
+	 * builds its integral images. The image is referenced (not copied) by
+	 * this object, so it must not be modified while in use. */
+	void setImage(const mrpt::img::CImage& img);
+
+	/** Finds the best position of one patch */
+	TMatch match(const TSearch& search) const;
+
+	/** Finds the best positions of many patches, in parallel */
+	void match(
+		const std::vector<TSearch>& searches,
+		std::vector<TMatch>& matches) const;
+
+	/** The correlation of the patch at all the positions of the search
+	 * window: `out(y,x)` is the score with the patch top-left at
+	 * (x_ini+x,y_ini+y), as the output of cv::matchTemplate(). */
+	void correlationMap(
+		const TSearch& search, mrpt::math::CMatrixFloat& out) const;
+
+	/** The correlation of two grayscale patches of the same size, without
+	 * memory allocations, as openCV_cross_correlation() for those patches
+	 * (with TMethod nccRaw). */
+	static float patchCorrelation(
+		const mrpt::img::CImage& a, const mrpt::img::CImage& b,
+		TMethod method = nccRaw, bool useSIMD = true);
+
+   private:
+	mrpt::img::CImage m_img;
+	/** Integral images of the pixels and their squares, of
+	 * (width+1)x(height+1) */
+	std::vector<uint32_t> m_sum;
+	std::vector<uint64_t> m_sqSum;
+	mutable std::shared_ptr<mrpt::WorkerThreadsPool> m_threadPool;
+
+	/** The correlation with the patch top-left at (x0+x, y0+y) for x, y in
+	 * [0,nx)x[0,ny), into `out` (row-major), or only its maximum if
+	 * `out==nullptr`. */
+	TMatch internal_search(
+		const mrpt::img::CImage& patch, int x0, int y0, int nx, int ny,
+		float* out) const;
+
+	void internal_forEach(
+		size_t n, const std::function<void(size_t)>& fn) const;
+};
+
+/** @} */
+}  // namespace mrpt::vision
@@ -10,6 +10,9 @@
 
 #include <mrpt/img/CImage.h>
 #include <mrpt/img/TCamera.h>
+#include <mrpt/vision/TRemapOptions.h>
+
+#include <string>
 
 namespace mrpt::vision
 {
@@ -22,6 +25,13 @@ namespace mrpt::vision
  *
  *  Works with grayscale or color images.
  *
+ * The map keeps, for each pixel, fixed-point source coordinates (the format
+ * of cv::convertMaps() with CV_16SC2), and images are remapped in parallel
+ * bands of rows, optionally converted to grayscale and downscaled to half
+ * the resolution in the same pass (see TRemapOptions). Maps can be cached on
+ * disk with setMapCacheDirectory(), so they are only computed once per
+ * calibration.
+ *
  * Example of usage:
  * \code
  *   CUndistortMap   unmap;
@@ -60,6 +70,14 @@ class CUndistortMap
 	void undistort(
 		const mrpt::img::CImage& in_img, mrpt::img::CImage& out_img) const;
 
+	/** \overload With options for the conversion to grayscale, downscaling
+	 * and multithreading. \a out_img cannot be \a in_img (or a shallow copy
+	 * of it).
+	 * \note (New in MRPT 2.4.9) */
+	void undistort(
+		const mrpt::img::CImage& in_img, mrpt::img::CImage& out_img,
+		const TRemapOptions& opts) const;
+
 	/** Undistort the input image and saves the result in-place- \a
 	 * setFromCamParams() must have been set prior to calling this.
 	 */
@@ -79,6 +97,13 @@ class CUndistortMap
 	 */
 	inline bool isSet() const { return !m_dat_mapx.empty(); }
 
+	/** If not empty, setFromCamParams() loads the maps from a file in this
+	 * directory, named after a hash of the camera parameters, or computes and
+	 * saves them there (if it can be written) if it does not exist yet.
+	 * \note (New in MRPT 2.4.9) */
+	void setMapCacheDirectory(const std::string& dir) { m_cache_dir = dir; }
+	const std::string& getMapCacheDirectory() const { return m_cache_dir; }
+
    private:
 	std::vector<int16_t> m_dat_mapx;
 	std::vector<uint16_t> m_dat_mapy;
@@ -86,5 +111,10 @@ class CUndistortMap
 	/** A copy of the data provided by the user */
 	mrpt::img::TCamera m_camera_params;
 
+	std::string m_cache_dir;
+
+	bool internal_loadCache(const std::string& file);
+	bool internal_saveCache(const std::string& file) const;
+
 };	// end class
 }  // namespace mrpt::vision
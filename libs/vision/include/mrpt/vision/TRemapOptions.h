@@ -0,0 +1,41 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <cstddef>
+
+namespace mrpt::vision
+{
+/** Options of the remapping of images by CUndistortMap::undistort() and
+ * CStereoRectifyMap::rectify().
+ *
+ * Images are remapped with the fixed-point maps of these classes (integer
+ * source coordinates plus a 5-bit fractional part, as generated by
+ * cv::convertMaps()), with the same arithmetic as cv::remap(). The
+ * conversion to grayscale and the downscaling are done in the same pass, row
+ * by row, without intermediary images.
+ *
+ * \note (New in MRPT 2.4.9)
+ * \ingroup mrpt_vision_grp
+ */
+struct TRemapOptions
+{
+	/** Convert color images to grayscale (as cv::cvtColor(), BGR to gray) */
+	bool grayscale = false;
+	/** Output images of half the width and height of the maps, each pixel
+	 * being the mean of 2x2 remapped pixels (as CImage::scaleHalf()) */
+	bool halfResolution = false;
+	/** Number of threads (0: as many as CPU cores) */
+	size_t numThreads = 0;
+	/** Output images with fewer pixels than this are remapped by the calling
+	 * thread only */
+	size_t minPixelsForParallel = 640 * 480;
+};
+
+}  // namespace mrpt::vision
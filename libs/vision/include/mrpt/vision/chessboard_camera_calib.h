@@ -13,6 +13,7 @@
 #include <mrpt/math/CMatrixFixed.h>
 #include <mrpt/math/TPose3D.h>
 #include <mrpt/poses/CPose3D.h>
+#include <mrpt/vision/chessboard_find_corners.h>
 #include <mrpt/vision/types.h>
 
 namespace mrpt::vision
@@ -46,6 +47,10 @@ struct TImageCalibData
 	/** At output, like projectedPoints_distorted but for the undistorted image.
 	 */
 	std::vector<mrpt::img::TPixelCoordf> projectedPoints_undistorted;
+	/** Set once the checkerboard has been searched for in this image,
+	 * whether it was found or not. In incremental calibration, these images
+	 * are not searched again. (New in MRPT 2.4.9) */
+	bool corners_searched = false;
 
 	/** Empty all the data */
 	void clear() { *this = TImageCalibData(); }
@@ -94,6 +99,25 @@ bool checkerBoardCameraCalibration(
 	bool skipDrawDetectedImgs = false,
 	bool useScaramuzzaAlternativeDetector = false);
 
+/** \overload With all the options of the detection of corners (run in
+ * parallel for all the images, see findChessboardCornersBatch()), and
+ * incremental calibration.
+ *
+ * If `incremental` is true, the images already processed in a former call
+ * (see TImageCalibData::corners_searched) are not loaded nor searched for
+ * corners again, and `camera_params` must hold the result of that call:
+ * it is the initial guess of the optimization, which is skipped altogether
+ * if no new image was added to the list.
+ *
+ * \note (New in MRPT 2.4.9)
+ */
+bool checkerBoardCameraCalibration(
+	TCalibrationImageList& images, unsigned int check_size_x,
+	unsigned int check_size_y, double check_squares_length_X_meters,
+	double check_squares_length_Y_meters, mrpt::img::TCamera& camera_params,
+	const TChessboardCornersOptions& detectionOptions, bool incremental = false,
+	double* out_MSE = nullptr);
+
 /** \overload with matrix of intrinsic params instead of mrpt::img::TCamera
  */
 bool checkerBoardCameraCalibration(
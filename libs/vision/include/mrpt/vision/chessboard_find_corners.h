@@ -61,6 +61,46 @@ bool findChessboardCorners(
 	unsigned int check_size_x, unsigned int check_size_y,
 	bool normalize_image = true, bool useScaramuzzaMethod = false);
 
+/** Options of findChessboardCorners() and findChessboardCornersBatch()
+ * \note (New in MRPT 2.4.9)
+ */
+struct TChessboardCornersOptions
+{
+	/** Whether to normalize the image before detection */
+	bool normalize_image = true;
+	/** Whether to use the alternative, more robust method by M. Rufli, D.
+	 * Scaramuzza, and R. Siegwart. */
+	bool useScaramuzzaMethod = false;
+	/** If >0, images wider than this are halved (as many times as needed)
+	 * before searching for the chessboard, and the corners found there are
+	 * then refined in the full resolution image. If it is not found in the
+	 * small image, it is searched for again at full resolution. */
+	unsigned int maxDetectionWidth = 0;
+	/** Number of threads of findChessboardCornersBatch() (0: as many as CPU
+	 * cores) */
+	unsigned int numThreads = 0;
+};
+
+/** \overload With all the detection options in a structure.
+ * \note (New in MRPT 2.4.9)
+ */
+bool findChessboardCorners(
+	const mrpt::img::CImage& img,
+	std::vector<mrpt::img::TPixelCoordf>& cornerCoords,
+	unsigned int check_size_x, unsigned int check_size_y,
+	const TChessboardCornersOptions& opts);
+
+/** Runs findChessboardCorners() for each of a list of images, in parallel.
+ * \param cornerCoords [OUT] The corners of each image, or an empty vector for
+ * those in which the chessboard was not found.
+ * \note (New in MRPT 2.4.9)
+ */
+void findChessboardCornersBatch(
+	const std::vector<const mrpt::img::CImage*>& images,
+	std::vector<std::vector<mrpt::img::TPixelCoordf>>& cornerCoords,
+	unsigned int check_size_x, unsigned int check_size_y,
+	const TChessboardCornersOptions& opts = TChessboardCornersOptions());
+
 /** Look for the corners of one or more chessboard/checkerboards in the image.
  *  This method uses an improved version of OpenCV's cvFindChessboardCorners
  *published
@@ -67,6 +67,19 @@ struct TStereoCalibParams
 	bool verbose{true};
 	/** Maximum number of iterations of the optimizer (default=300) */
 	size_t maxIters{2000};
+	/** Number of threads to search for corners in the images (0: as many as
+	 * CPU cores). (New in MRPT 2.4.9) */
+	unsigned int num_threads{0};
+	/** If >0, corners are first searched for in images downscaled to at most
+	 * this width. See TChessboardCornersOptions::maxDetectionWidth.
+	 * (New in MRPT 2.4.9) */
+	unsigned int detection_max_width{0};
+	/** If true, only the image pairs not processed in a former call (see
+	 * TImageCalibData::corners_searched) are searched for corners, and the
+	 * output results of that call are used as the initial guess of the
+	 * optimization, which is skipped altogether if no image pair was added.
+	 * (New in MRPT 2.4.9) */
+	bool incremental{false};
 
 	/** Select which distortion parameters (of both left/right cameras) will be
 	 * optimzed:
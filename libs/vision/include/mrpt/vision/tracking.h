@@ -10,11 +10,14 @@
 #pragma once
 
 #include <mrpt/containers/yaml.h>
+#include <mrpt/core/WorkerThreadsPool.h>
 #include <mrpt/img/CImage.h>
 #include <mrpt/system/CTimeLogger.h>
+#include <mrpt/vision/CImagePyramid.h>
 #include <mrpt/vision/TKeyPoint.h>
 #include <mrpt/vision/types.h>
 
+#include <functional>
 #include <memory>  // for unique_ptr
 
 namespace mrpt::vision
@@ -164,7 +167,9 @@ struct CGenericFeatureTracker
 	 *be
 	 *also added to the existing ones in areas of the image poor of features.
 	 * This method does:
-	 *    - Convert old and new images to grayscale, if they're in color.
+	 *    - Convert old and new images to grayscale, if they're in color. If
+	 *"old_img" is the "new_img" of the former call (or a shallow copy of it),
+	 *its grayscale version is reused.
 	 *    - Call the pure virtual "trackFeatures_impl" method.
 	 *    - Implement the optional detection of new features if
 	 *"add_new_features"!=0.
@@ -239,7 +244,15 @@ struct CGenericFeatureTracker
 	void updateAdaptiveNewFeatsThreshold(
 		const size_t nNewlyDetectedFeats, const size_t desired_num_features);
 
+	/** Whether both images are loaded in memory and share their pixels, e.g.
+	 * one is a shallow copy of the other. */
+	static bool isSameImageBuffer(
+		const mrpt::img::CImage& a, const mrpt::img::CImage& b);
+
    private:
+	/** The last "new_img", and its grayscale version, to be reused if it
+	 * is the next "old_img" */
+	mrpt::img::CImage m_lastNewImg, m_lastNewGray;
 	/** for use when "update_patches_every">=1 */
 	size_t m_update_patches_counter{0};
 	/** For use when "check_KLT_response_every">=1 */
@@ -275,6 +288,22 @@ using CGenericFeatureTrackerAutoPtr = std::unique_ptr<CGenericFeatureTracker>;
  *		- "LK_max_tracking_error" (Default=150.0) The maximum "tracking error"
  *of
  *LK tracking such as a feature is marked as "lost".
+ *		- "LK_use_opencv" (Default=false) Use cv::calcOpticalFlowPyrLK()
+ *instead of the built-in batched tracker (see below).
+ *		- "LK_num_threads" (Default=0: as many as CPU cores) Threads of the
+ *batched tracker.
+ *		- "LK_use_SIMD" (Default=true) Use AVX2 kernels in the batched
+ *tracker, if supported by the CPU.
+ *
+ * The built-in tracker follows the same (fixed point) computations as
+ *cv::calcOpticalFlowPyrLK(), but the Scharr derivatives of each level of the
+ *old image are computed only once, and features are tracked in chunks whose
+ *patches are packed together, in parallel. (New in MRPT 2.4.9)
+ *
+ * The Gaussian pyramid of each new image (see CImagePyramid) is kept and
+ *reused as the pyramid of the old image in the next call, rebuilding the
+ *levels in place, so only one pyramid is built per frame. It can be retrieved
+ *with getLastPyramid() to be shared with other algorithms.
  *
  *  \sa OpenCV's method cvCalcOpticalFlowPyrLK
  */
@@ -288,6 +317,12 @@ struct CFeatureTracker_KL : public CGenericFeatureTracker
 	{
 	}
 
+	/** The grayscale pyramid of the last "new_img" used for tracking. Its
+	 * levels have a border of the window size plus 16 pixels, as required by
+	 * cv::calcOpticalFlowPyrLK() and the SIMD kernels.
+	 * \note (New in MRPT 2.4.9) */
+	const CImagePyramid& getLastPyramid() const { return m_curPyr; }
+
    protected:
 	void trackFeatures_impl(
 		const mrpt::img::CImage& old_img, const mrpt::img::CImage& new_img,
@@ -297,6 +332,17 @@ struct CFeatureTracker_KL : public CGenericFeatureTracker
 		TKeyPointfList& inout_featureList) override;
 
    private:
+	/** Pyramids of the old and new images */
+	CImagePyramid m_prevPyr, m_curPyr;
+	/** The image m_curPyr was built from */
+	mrpt::img::CImage m_curPyrSource;
+	/** Scharr derivatives of each level of m_prevPyr, with its border */
+	std::vector<std::vector<int16_t>> m_derivX, m_derivY;
+	std::shared_ptr<mrpt::WorkerThreadsPool> m_threadPool;
+
+	void internal_forEach(
+		size_t n, size_t nThreads, const std::function<void(size_t)>& fn);
+
 	template <typename FEATLIST>
 	void trackFeatures_impl_templ(
 		const mrpt::img::CImage& old_img, const mrpt::img::CImage& new_img,
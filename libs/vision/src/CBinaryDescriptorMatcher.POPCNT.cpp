@@ -0,0 +1,78 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "vision-precomp.h"	 // Precompiled headers
+//
+#include <mrpt/config.h>
+
+#include "CBinaryDescriptorMatcher_kernels.h"
+
+// ---------------------------------------------------------------------------
+//   This file contains the POPCNT version of the Hamming distance kernels.
+//   It is built with "-mpopcnt" (see DeclareMRPTLib.cmake), and only called
+//   if the CPU supports POPCNT.
+// ---------------------------------------------------------------------------
+#if MRPT_ARCH_INTEL_COMPATIBLE
+#include <nmmintrin.h>
+#endif
+
+namespace
+{
+inline uint32_t popcount64(uint64_t x)
+{
+#if MRPT_ARCH_INTEL_COMPATIBLE && MRPT_WORD_SIZE == 64
+	return static_cast<uint32_t>(_mm_popcnt_u64(x));
+#elif MRPT_ARCH_INTEL_COMPATIBLE
+	return static_cast<uint32_t>(
+		_mm_popcnt_u32(static_cast<uint32_t>(x)) +
+		_mm_popcnt_u32(static_cast<uint32_t>(x >> 32)));
+#else
+	return mrpt::vision::detail::popcount64_portable(x);
+#endif
+}
+}  // namespace
+
+void mrpt::vision::detail::hamming_kernel_POPCNT(
+	const uint64_t* q, const uint64_t* rows, size_t nRows, size_t stride,
+	uint32_t* dists)
+{
+	if (stride == 4)
+	{
+		// 256-bit descriptors (ORB, LATCH, BLD): fully unrolled
+		const uint64_t q0 = q[0], q1 = q[1], q2 = q[2], q3 = q[3];
+		for (size_t r = 0; r < nRows; r++, rows += 4)
+			dists[r] = popcount64(q0 ^ rows[0]) + popcount64(q1 ^ rows[1]) +
+				popcount64(q2 ^ rows[2]) + popcount64(q3 ^ rows[3]);
+		return;
+	}
+	for (size_t r = 0; r < nRows; r++, rows += stride)
+	{
+		uint32_t d = 0;
+		for (size_t w = 0; w < stride; w++)
+			d += popcount64(q[w] ^ rows[w]);
+		dists[r] = d;
+	}
+}
+
+uint32_t mrpt::vision::detail::hamming_bytes_POPCNT(
+	const uint8_t* a, const uint8_t* b, size_t nBytes)
+{
+	uint32_t d = 0;
+	size_t i = 0;
+	for (; i + 8 <= nBytes; i += 8)
+	{
+		uint64_t x, y;
+		std::memcpy(&x, a + i, 8);
+		std::memcpy(&y, b + i, 8);
+		d += popcount64(x ^ y);
+	}
+	for (; i < nBytes; i++)
+		d += popcount64(a[i] ^ b[i]);
+	return d;
+}
@@ -0,0 +1,442 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "vision-precomp.h"	 // Precompiled headers
+//
+#include <mrpt/core/cpu.h>
+#include <mrpt/vision/CBinaryDescriptorMatcher.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <thread>
+
+#include "CBinaryDescriptorMatcher_kernels.h"
+
+using namespace mrpt::vision;
+using namespace mrpt::vision::detail;
+
+void mrpt::vision::detail::hamming_kernel_portable(
+	const uint64_t* q, const uint64_t* rows, size_t nRows, size_t stride,
+	uint32_t* dists)
+{
+	for (size_t r = 0; r < nRows; r++, rows += stride)
+	{
+		uint32_t d = 0;
+		for (size_t w = 0; w < stride; w++)
+			d += popcount64_portable(q[w] ^ rows[w]);
+		dists[r] = d;
+	}
+}
+
+uint32_t mrpt::vision::hamming_distance(
+	const uint8_t* a, const uint8_t* b, size_t nBytes)
+{
+	static const bool hasPOPCNT =
+		mrpt::cpu::supports(mrpt::cpu::feature::POPCNT);
+	return hasPOPCNT ? hamming_bytes_POPCNT(a, b, nBytes)
+					 : hamming_bytes_portable(a, b, nBytes);
+}
+
+namespace
+{
+constexpr uint32_t INF_DIST = std::numeric_limits<uint32_t>::max();
+
+// Queries run by each thread task:
+constexpr size_t QUERIES_PER_CHUNK = 64;
+// Descriptors compared at once against each query, in brute force:
+constexpr size_t BRUTE_FORCE_BLOCK = 1024;
+
+hamming_kernel_t selectKernel(bool useSIMD, size_t stride)
+{
+	using mrpt::cpu::feature;
+	const bool avx2 = useSIMD && mrpt::cpu::supports(feature::AVX2);
+	const bool popcnt = useSIMD && mrpt::cpu::supports(feature::POPCNT);
+	// For 256-bit descriptors, 4 POPCNT's are as fast as AVX2:
+	if (avx2 && (stride > 4 || !popcnt)) return &hamming_kernel_AVX2;
+	if (popcnt) return &hamming_kernel_POPCNT;
+	return &hamming_kernel_portable;
+}
+
+// The two nearest neighbors of a query, sorted by (distance, index)
+struct TTop2
+{
+	uint32_t d1 = INF_DIST, d2 = INF_DIST;
+	size_t i1 = 0, i2 = 0;
+
+	void add(uint32_t d, size_t i)
+	{
+		if (d < d1 || (d == d1 && i < i1))
+		{
+			d2 = d1;
+			i2 = i1;
+			d1 = d;
+			i1 = i;
+		}
+		else if (d < d2 || (d == d2 && i < i2))
+		{
+			d2 = d;
+			i2 = i;
+		}
+	}
+};
+
+// Multi-index hash tables: one per 16-bit substring of the descriptors,
+// each one stored as buckets of descriptor indices (CSR format).
+struct TMultiIndex
+{
+	static constexpr size_t BUCKETS = 1 << 16;
+
+	size_t nTables = 0, rows = 0;
+	std::vector<uint32_t> offsets;	//!< nTables x (BUCKETS+1)
+	std::vector<uint32_t> ids;	//!< nTables x rows
+
+	static uint32_t substring(const uint64_t* row, size_t t)
+	{
+		const auto* b = reinterpret_cast<const uint8_t*>(row);
+		return b[2 * t] | (static_cast<uint32_t>(b[2 * t + 1]) << 8);
+	}
+
+	void build(const CBinaryDescriptorMatcher::TPackedDescriptors& set)
+	{
+		ASSERT_LT_(set.rows, static_cast<size_t>(INF_DIST));
+		rows = set.rows;
+		nTables = (set.bytesPerRow + 1) / 2;
+		offsets.assign(nTables * (BUCKETS + 1), 0);
+		ids.resize(nTables * rows);
+		for (size_t t = 0; t < nTables; t++)
+		{
+			uint32_t* off = &offsets[t * (BUCKETS + 1)];
+			for (size_t i = 0; i < rows; i++)
+				off[substring(set.row(i), t) + 1]++;
+			std::partial_sum(off, off + BUCKETS + 1, off);
+			std::vector<uint32_t> next(off, off + BUCKETS);
+			uint32_t* tIds = &ids[t * rows];
+			for (size_t i = 0; i < rows; i++)
+				tIds[next[substring(set.row(i), t)]++] =
+					static_cast<uint32_t>(i);
+		}
+	}
+};
+
+// All 16-bit values, grouped by their number of bits set:
+const std::array<std::vector<uint16_t>, 17>& masksByNumBits()
+{
+	static const auto masks = []() {
+		std::array<std::vector<uint16_t>, 17> m;
+		for (uint32_t v = 0; v < TMultiIndex::BUCKETS; v++)
+			m[popcount64_portable(v)].push_back(static_cast<uint16_t>(v));
+		return m;
+	}();
+	return masks;
+}
+
+// Multi-index hashing search: substrings are probed at increasing Hamming
+// radius r. After radius r, all descriptors closer than m*(r+1) to the query
+// (m: number of substrings) have been found, since at least one of their
+// substrings must be within distance r (pigeonhole principle).
+// The second neighbor is only searched for while it may fail the ratio test
+// (ratio>0), that is, while it may be closer than d1/ratio.
+// Queries without close neighbors require probing many buckets, so the
+// search is given up (returning false) once it becomes more expensive than
+// half a brute force search.
+bool mihSearch(
+	const TMultiIndex& mih,
+	const CBinaryDescriptorMatcher::TPackedDescriptors& train,
+	const uint64_t* q, uint32_t bound, double ratio, hamming_kernel_t kernel,
+	std::vector<uint32_t>& stamp, uint32_t stampId, TTop2& top)
+{
+	const auto& masks = masksByNumBits();
+	const size_t m = mih.nTables;
+	// In units of sequentially compared descriptors, as in brute force.
+	// Random accesses to buckets and descriptors are much slower:
+	const size_t budget = train.rows / 2;
+	size_t work = 0;
+
+	for (size_t r = 0; r < masks.size(); r++)
+	{
+		for (size_t t = 0; t < m; t++)
+		{
+			const uint32_t s = TMultiIndex::substring(q, t);
+			const uint32_t* off = &mih.offsets[t * (TMultiIndex::BUCKETS + 1)];
+			const uint32_t* ids = &mih.ids[t * mih.rows];
+			work += 4 * masks[r].size();
+			for (const uint16_t mask : masks[r])
+			{
+				const uint32_t b = s ^ mask;
+				work += 8 * (off[b + 1] - off[b]);
+				for (uint32_t k = off[b]; k < off[b + 1]; k++)
+				{
+					const uint32_t id = ids[k];
+					if (stamp[id] == stampId) continue;
+					stamp[id] = stampId;
+					uint32_t d;
+					kernel(q, train.row(id), 1, train.stride, &d);
+					if (d <= bound) top.add(d, id);
+				}
+			}
+			if (work > budget) return false;
+		}
+		const size_t reach = m * (r + 1);
+		if (bound < reach) break;
+		if (top.d1 < reach &&
+			(ratio <= 0 || top.d2 < reach || top.d1 < ratio * reach))
+			break;
+	}
+	return true;
+}
+
+// Nearest neighbors in `train` of the queries qIdx[0:nq-1], by brute force,
+// in blocks of train descriptors kept in the CPU cache:
+void bruteForceChunk(
+	const CBinaryDescriptorMatcher::TPackedDescriptors& queries,
+	const size_t* qIdx, size_t nq,
+	const CBinaryDescriptorMatcher::TPackedDescriptors& train, uint32_t bound,
+	hamming_kernel_t kernel, TTop2* out)
+{
+	std::vector<uint32_t> dists(BRUTE_FORCE_BLOCK);
+	for (size_t j0 = 0; j0 < train.rows; j0 += BRUTE_FORCE_BLOCK)
+	{
+		const size_t nb = std::min(BRUTE_FORCE_BLOCK, train.rows - j0);
+		for (size_t k = 0; k < nq; k++)
+		{
+			kernel(
+				queries.row(qIdx[k]), train.row(j0), nb, train.stride,
+				dists.data());
+			for (size_t b = 0; b < nb; b++)
+				if (dists[b] <= bound) out[k].add(dists[b], j0 + b);
+		}
+	}
+}
+
+// Idem, with multi-index hashing if `mih` is not null:
+void searchChunk(
+	const CBinaryDescriptorMatcher::TPackedDescriptors& queries,
+	const size_t* qIdx, size_t nq,
+	const CBinaryDescriptorMatcher::TPackedDescriptors& train,
+	const TMultiIndex* mih, uint32_t bound, double ratio,
+	hamming_kernel_t kernel, TTop2* out)
+{
+	if (!mih)
+	{
+		bruteForceChunk(queries, qIdx, nq, train, bound, kernel, out);
+		return;
+	}
+
+	std::vector<uint32_t> stamp(train.rows, 0);
+	std::vector<size_t> giveUps, giveUpIdx;
+	for (size_t k = 0; k < nq; k++)
+	{
+		if (mihSearch(
+				*mih, train, queries.row(qIdx[k]), bound, ratio, kernel, stamp,
+				static_cast<uint32_t>(k + 1), out[k]))
+			continue;
+		giveUps.push_back(k);
+		giveUpIdx.push_back(qIdx[k]);
+	}
+	if (giveUps.empty()) return;
+
+	std::vector<TTop2> bf(giveUps.size());
+	bruteForceChunk(
+		queries, giveUpIdx.data(), giveUpIdx.size(), train, bound, kernel,
+		bf.data());
+	for (size_t g = 0; g < giveUps.size(); g++)
+		out[giveUps[g]] = bf[g];
+}
+
+const std::vector<uint8_t>& binaryDescriptor(
+	const CFeature& f, TDescriptorType descriptor)
+{
+	const std::optional<std::vector<uint8_t>>* d = nullptr;
+	switch (descriptor)
+	{
+		case descORB: d = &f.descriptors.ORB; break;
+		case descLATCH: d = &f.descriptors.LATCH; break;
+		case descBLD: d = &f.descriptors.BLD; break;
+		default:
+			THROW_EXCEPTION(
+				"Only binary descriptors (descORB, descLATCH, descBLD) are "
+				"supported");
+	};
+	ASSERTMSG_(d->has_value(), "Feature without the requested descriptor");
+	return d->value();
+}
+}  // namespace
+
+void CBinaryDescriptorMatcher::TPackedDescriptors::resize(
+	size_t n, size_t bytes)
+{
+	rows = n;
+	bytesPerRow = bytes;
+	stride = 4 * ((bytes + 31) / 32);
+	data.assign(rows * stride, 0);
+}
+
+void CBinaryDescriptorMatcher::TPackedDescriptors::setRow(
+	size_t i, const uint8_t* desc)
+{
+	ASSERT_LT_(i, rows);
+	std::memcpy(&data[i * stride], desc, bytesPerRow);
+}
+
+void CBinaryDescriptorMatcher::packDescriptors(
+	const CFeatureList& feats, TDescriptorType descriptor,
+	TPackedDescriptors& out)
+{
+	MRPT_START
+	if (feats.empty())
+	{
+		out.resize(0, 0);
+		return;
+	}
+	const size_t bytes = binaryDescriptor(feats[0], descriptor).size();
+	out.resize(feats.size(), bytes);
+	for (size_t i = 0; i < feats.size(); i++)
+	{
+		const auto& d = binaryDescriptor(feats[i], descriptor);
+		ASSERT_EQUAL_(d.size(), bytes);
+		out.setRow(i, d.data());
+	}
+	MRPT_END
+}
+
+void CBinaryDescriptorMatcher::internal_forEachChunk(
+	size_t nQueries, size_t nChunks, const std::function<void(size_t)>& fn)
+{
+	size_t nThreads = options.numThreads;
+	if (!nThreads) nThreads = std::max(1U, std::thread::hardware_concurrency());
+
+	if (nThreads <= 1 || nChunks <= 1 ||
+		nQueries < options.minQueriesForParallel)
+	{
+		for (size_t i = 0; i < nChunks; i++)
+			fn(i);
+		return;
+	}
+	// The calling thread also runs chunks:
+	if (!m_threadPool || m_threadPool->size() != nThreads - 1)
+		m_threadPool = std::make_shared<mrpt::WorkerThreadsPool>(
+			nThreads - 1, mrpt::WorkerThreadsPool::POLICY_FIFO,
+			"CBinaryDescriptorMatcher");
+	m_threadPool->parallel_for(0, nChunks, 1, fn);
+}
+
+void CBinaryDescriptorMatcher::match(
+	const TPackedDescriptors& set1, const TPackedDescriptors& set2,
+	std::vector<TBinaryDescriptorMatch>& matches)
+{
+	MRPT_START
+
+	matches.clear();
+	if (!set1.rows || !set2.rows) return;
+	ASSERT_EQUAL_(set1.bytesPerRow, set2.bytesPerRow);
+
+	const hamming_kernel_t kernel = selectKernel(options.useSIMD, set1.stride);
+	const uint32_t nBits = static_cast<uint32_t>(set1.bits());
+	const uint32_t maxDist = std::min(options.maxDistance, nBits);
+	const double ratio = options.ratioTest;
+
+	// Second neighbors farther than this always pass the ratio test, so
+	// there is no need to find them:
+	uint32_t bound = maxDist;
+	if (ratio > 0)
+		bound = static_cast<uint32_t>(std::max<double>(
+			maxDist, std::min<double>(nBits, std::floor(maxDist / ratio))));
+
+	auto useMIH = [this](const TPackedDescriptors& s) {
+		return options.method == smMultiIndexHashing ||
+			(options.method == smAuto && s.rows >= options.mihMinSetSize);
+	};
+
+	// Nearest neighbors of `qIdx` queries from `queries` in `train`:
+	auto search = [&](const TPackedDescriptors& queries,
+					  const std::vector<size_t>& qIdx,
+					  const TPackedDescriptors& train, uint32_t maxD,
+					  double ratioTest, std::vector<TTop2>& out) {
+		TMultiIndex mih;
+		if (useMIH(train)) mih.build(train);
+		out.assign(qIdx.size(), TTop2());
+		const size_t nChunks =
+			(qIdx.size() + QUERIES_PER_CHUNK - 1) / QUERIES_PER_CHUNK;
+		internal_forEachChunk(qIdx.size(), nChunks, [&](size_t c) {
+			const size_t q0 = c * QUERIES_PER_CHUNK;
+			const size_t nq = std::min(QUERIES_PER_CHUNK, qIdx.size() - q0);
+			searchChunk(
+				queries, &qIdx[q0], nq, train, mih.nTables ? &mih : nullptr,
+				maxD, ratioTest, kernel, &out[q0]);
+		});
+	};
+
+	std::vector<size_t> queries1(set1.rows);
+	std::iota(queries1.begin(), queries1.end(), 0);
+	std::vector<TTop2> nn12;
+	search(set1, queries1, set2, bound, ratio, nn12);
+
+	for (size_t i = 0; i < set1.rows; i++)
+	{
+		const TTop2& t = nn12[i];
+		if (t.d1 > maxDist) continue;
+		if (ratio > 0 && t.d2 != INF_DIST && !(t.d1 < ratio * t.d2)) continue;
+		matches.emplace_back(i, t.i1, t.d1);
+	}
+
+	if (options.crossCheck && !matches.empty())
+	{
+		// Only the descriptors of set2 in some pairing are needed:
+		std::vector<size_t> queries2;
+		queries2.reserve(matches.size());
+		for (const auto& m : matches)
+			queries2.push_back(m.idx2);
+		std::sort(queries2.begin(), queries2.end());
+		queries2.erase(
+			std::unique(queries2.begin(), queries2.end()), queries2.end());
+
+		std::vector<TTop2> nn21;
+		search(set2, queries2, set1, maxDist, 0, nn21);
+
+		matches.erase(
+			std::remove_if(
+				matches.begin(), matches.end(),
+				[&](const TBinaryDescriptorMatch& m) {
+					const auto it = std::lower_bound(
+						queries2.begin(), queries2.end(), m.idx2);
+					return nn21[it - queries2.begin()].i1 != m.idx1;
+				}),
+			matches.end());
+	}
+
+	MRPT_END
+}
+
+void CBinaryDescriptorMatcher::match(
+	const CFeatureList& list1, const CFeatureList& list2,
+	std::vector<TBinaryDescriptorMatch>& matches)
+{
+	TPackedDescriptors set1, set2;
+	packDescriptors(list1, options.descriptor, set1);
+	packDescriptors(list2, options.descriptor, set2);
+	match(set1, set2, matches);
+}
+
+void CBinaryDescriptorMatcher::match(
+	const CFeatureList& list1, const CFeatureList& list2,
+	CMatchedFeatureList& matches)
+{
+	std::vector<TBinaryDescriptorMatch> idxs;
+	match(list1, list2, idxs);
+	matches.clear();
+	for (const auto& m : idxs)
+		matches.emplace_back(
+			list1[static_cast<unsigned int>(m.idx1)],
+			list2[static_cast<unsigned int>(m.idx2)]);
+}
@@ -0,0 +1,68 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace mrpt::vision::detail
+{
+/** Hamming distances from one packed descriptor `query` to `nRows`
+ * consecutive packed descriptors in `rows`, all of them with `stride` 64-bit
+ * words (a multiple of 4). */
+using hamming_kernel_t = void (*)(
+	const uint64_t* query, const uint64_t* rows, size_t nRows, size_t stride,
+	uint32_t* dists);
+
+/** Portable (SWAR) number of bits set */
+inline uint32_t popcount64_portable(uint64_t x)
+{
+	x = x - ((x >> 1) & 0x5555555555555555ULL);
+	x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+	x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+	return static_cast<uint32_t>((x * 0x0101010101010101ULL) >> 56);
+}
+
+inline uint32_t hamming_bytes_portable(
+	const uint8_t* a, const uint8_t* b, size_t nBytes)
+{
+	uint32_t d = 0;
+	size_t i = 0;
+	for (; i + 8 <= nBytes; i += 8)
+	{
+		uint64_t x, y;
+		std::memcpy(&x, a + i, 8);
+		std::memcpy(&y, b + i, 8);
+		d += popcount64_portable(x ^ y);
+	}
+	for (; i < nBytes; i++)
+		d += popcount64_portable(a[i] ^ b[i]);
+	return d;
+}
+
+void hamming_kernel_portable(
+	const uint64_t* query, const uint64_t* rows, size_t nRows, size_t stride,
+	uint32_t* dists);
+
+/** Only call it if mrpt::cpu::supports(mrpt::cpu::feature::POPCNT) */
+void hamming_kernel_POPCNT(
+	const uint64_t* query, const uint64_t* rows, size_t nRows, size_t stride,
+	uint32_t* dists);
+
+/** Only call it if mrpt::cpu::supports(mrpt::cpu::feature::POPCNT) */
+uint32_t hamming_bytes_POPCNT(
+	const uint8_t* a, const uint8_t* b, size_t nBytes);
+
+/** Only call it if mrpt::cpu::supports(mrpt::cpu::feature::AVX2) */
+void hamming_kernel_AVX2(
+	const uint64_t* query, const uint64_t* rows, size_t nRows, size_t stride,
+	uint32_t* dists);
+
+}  // namespace mrpt::vision::detail
@@ -0,0 +1,189 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/vision/CBinaryDescriptorMatcher.h>
+
+#include <random>
+
+using mrpt::vision::CBinaryDescriptorMatcher;
+using mrpt::vision::TBinaryDescriptorMatch;
+
+namespace
+{
+uint32_t naiveHamming(const uint8_t* a, const uint8_t* b, size_t n)
+{
+	uint32_t d = 0;
+	for (size_t i = 0; i < n; i++)
+		for (int bit = 0; bit < 8; bit++)
+			d += ((a[i] ^ b[i]) >> bit) & 1;
+	return d;
+}
+
+using packed_t = CBinaryDescriptorMatcher::TPackedDescriptors;
+
+// Random descriptors in s1, and noisy copies of some of them in s2:
+void makeSets(
+	size_t n1, size_t n2, size_t bytes, packed_t& s1, packed_t& s2,
+	unsigned seed)
+{
+	std::mt19937 rng(seed);
+	std::uniform_int_distribution<int> byte(0, 255);
+	std::uniform_int_distribution<size_t> bitIdx(0, bytes * 8 - 1);
+	std::vector<std::vector<uint8_t>> d1(n1, std::vector<uint8_t>(bytes));
+	for (auto& d : d1)
+		for (auto& b : d)
+			b = static_cast<uint8_t>(byte(rng));
+
+	s1.resize(n1, bytes);
+	s2.resize(n2, bytes);
+	for (size_t i = 0; i < n1; i++)
+		s1.setRow(i, d1[i].data());
+	for (size_t j = 0; j < n2; j++)
+	{
+		std::vector<uint8_t> d(bytes);
+		if (j % 2 == 0)
+		{
+			d = d1[(j * 7) % n1];
+			for (size_t k = 0, nFlips = j % 40; k < nFlips; k++)
+			{
+				const size_t bit = bitIdx(rng);
+				d[bit / 8] ^= static_cast<uint8_t>(1 << (bit % 8));
+			}
+		}
+		else
+			for (auto& b : d)
+				b = static_cast<uint8_t>(byte(rng));
+		s2.setRow(j, d.data());
+	}
+}
+
+void expectSameMatches(
+	const std::vector<TBinaryDescriptorMatch>& a,
+	const std::vector<TBinaryDescriptorMatch>& b)
+{
+	ASSERT_EQ(a.size(), b.size());
+	for (size_t i = 0; i < a.size(); i++)
+	{
+		EXPECT_EQ(a[i].idx1, b[i].idx1);
+		EXPECT_EQ(a[i].idx2, b[i].idx2);
+		EXPECT_EQ(a[i].distance, b[i].distance);
+	}
+}
+}  // namespace
+
+TEST(CBinaryDescriptorMatcher, hamming_distance)
+{
+	std::mt19937 rng(1);
+	std::uniform_int_distribution<int> byte(0, 255);
+	for (size_t n : {1, 7, 8, 32, 61, 64})
+	{
+		std::vector<uint8_t> a(n), b(n);
+		for (size_t i = 0; i < n; i++)
+		{
+			a[i] = static_cast<uint8_t>(byte(rng));
+			b[i] = static_cast<uint8_t>(byte(rng));
+		}
+		EXPECT_EQ(
+			mrpt::vision::hamming_distance(a.data(), b.data(), n),
+			naiveHamming(a.data(), b.data(), n));
+		EXPECT_EQ(mrpt::vision::hamming_distance(a.data(), a.data(), n), 0U);
+	}
+}
+
+TEST(CBinaryDescriptorMatcher, ratioAndCrossCheck)
+{
+	packed_t s1, s2;
+	s1.resize(2, 32);
+	s2.resize(3, 32);
+	std::vector<uint8_t> d(32, 0);
+	s1.setRow(0, d.data());	 // 0...0
+	d[0] = 0x01;
+	s2.setRow(0, d.data());	 // dist to s1[0]: 1
+	d[0] = 0x02;
+	s2.setRow(1, d.data());	 // dist to s1[0]: 1
+	d.assign(32, 0xff);
+	s1.setRow(1, d.data());	 // 1...1
+	d[0] = 0;
+	s2.setRow(2, d.data());	 // dist to s1[1]: 8
+
+	CBinaryDescriptorMatcher m;
+	m.options.maxDistance = 16;
+	m.options.ratioTest = 0;
+	m.options.crossCheck = false;
+	std::vector<TBinaryDescriptorMatch> matches;
+	m.match(s1, s2, matches);
+	ASSERT_EQ(matches.size(), 2U);
+	// Ties are resolved by the lowest index:
+	EXPECT_EQ(matches[0].idx2, 0U);
+	EXPECT_EQ(matches[0].distance, 1U);
+	EXPECT_EQ(matches[1].idx2, 2U);
+	EXPECT_EQ(matches[1].distance, 8U);
+
+	// s1[0] has two equally close candidates:
+	m.options.ratioTest = 0.8;
+	m.match(s1, s2, matches);
+	ASSERT_EQ(matches.size(), 1U);
+	EXPECT_EQ(matches[0].idx1, 1U);
+
+	// The best match of s2[1] is s1[0], but the best one of s1[0] is s2[0]:
+	m.options.ratioTest = 0;
+	m.options.crossCheck = true;
+	m.match(s2, s1, matches);
+	ASSERT_EQ(matches.size(), 2U);
+	EXPECT_EQ(matches[0].idx1, 0U);
+	EXPECT_EQ(matches[1].idx1, 2U);
+
+	m.options.maxDistance = 4;
+	m.match(s1, s2, matches);
+	ASSERT_EQ(matches.size(), 1U);
+}
+
+TEST(CBinaryDescriptorMatcher, methodsGiveSameResults)
+{
+	for (const size_t bytes : {32, 61})
+	{
+		packed_t s1, s2;
+		makeSets(8000, 1000, bytes, s1, s2, static_cast<unsigned>(bytes));
+
+		for (const double ratio : {0.0, 0.8})
+			for (const bool crossCheck : {false, true})
+			{
+				CBinaryDescriptorMatcher m;
+				m.options.ratioTest = ratio;
+				m.options.crossCheck = crossCheck;
+				m.options.maxDistance = 40;
+
+				std::vector<TBinaryDescriptorMatch> ref, other;
+				m.options.method = CBinaryDescriptorMatcher::smBruteForce;
+				m.options.useSIMD = false;
+				m.options.numThreads = 1;
+				m.match(s2, s1, ref);
+				EXPECT_GT(ref.size(), 100U);
+
+				m.options.useSIMD = true;
+				m.options.numThreads = 4;
+				m.match(s2, s1, other);
+				expectSameMatches(ref, other);
+
+				m.options.method =
+					CBinaryDescriptorMatcher::smMultiIndexHashing;
+				m.match(s2, s1, other);
+				expectSameMatches(ref, other);
+
+				for (const auto& mt : ref)
+					EXPECT_EQ(
+						mt.distance,
+						naiveHamming(
+							reinterpret_cast<const uint8_t*>(s2.row(mt.idx1)),
+							reinterpret_cast<const uint8_t*>(s1.row(mt.idx2)),
+							bytes));
+			}
+	}
+}
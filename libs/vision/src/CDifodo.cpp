@@ -9,13 +9,16 @@
 
 #include "vision-precomp.h"	 // Precompiled headers
 //
+#include <mrpt/core/WorkerThreadsPool.h>
 #include <mrpt/core/round.h>
 #include <mrpt/poses/Lie/SE.h>
 #include <mrpt/system/CTicTac.h>
 #include <mrpt/vision/CDifodo.h>
 
 #include <Eigen/Dense>
+#include <algorithm>
 #include <iostream>
+#include <thread>
 
 using namespace mrpt;
 using namespace mrpt::vision;
@@ -53,6 +56,9 @@ CDifodo::CDifodo()
 	yy_inter.resize(pyr_levels);
 	yy_old.resize(pyr_levels);
 	yy_warped.resize(pyr_levels);
+	depth_next.resize(pyr_levels);
+	xx_next.resize(pyr_levels);
+	yy_next.resize(pyr_levels);
 	transformations.resize(pyr_levels);
 
 	for (unsigned int i = 0; i < pyr_levels; i++)
@@ -75,6 +81,9 @@ CDifodo::CDifodo()
 		yy_old[i].resize(rows_i, cols_i);
 		yy[i].fill(0.0f);
 		yy_old[i].fill(0.0f);
+		depth_next[i].resize(rows_i, cols_i);
+		xx_next[i].resize(rows_i, cols_i);
+		yy_next[i].resize(rows_i, cols_i);
 		transformations[i].resize(4, 4);
 
 		if (cols_i <= cols)
@@ -111,277 +120,332 @@ CDifodo::CDifodo()
 			g_mask[i][j] = v_mask2[i] * v_mask2[j] / 256.f;
 }
 
-void CDifodo::buildCoordinatesPyramid()
+CDifodo::~CDifodo()
 {
-	const float max_depth_dif = 0.1f;
-
-	// Push coordinates back
-	depth_old.swap(depth);
-	xx_old.swap(xx);
-	yy_old.swap(yy);
-
-	// The number of levels of the pyramid does not match the number of levels
-	// used
-	// in the odometry computation (because we might want to finish with lower
-	// resolutions)
+	// The solver thread may still be using this object:
+	try
+	{
+		waitForOdometry();
+	}
+	catch (const std::exception&)
+	{
+	}
+}
 
-	unsigned int pyr_levels =
-		round(log(float(m_width / cols)) / log(2.f)) + ctf_levels;
+namespace
+{
+// Rows of the images processed by each parallel task:
+constexpr unsigned int ROWS_PER_BAND = 8;
 
-	// Generate levels
-	for (unsigned int i = 0; i < pyr_levels; i++)
-	{
-		unsigned int s = static_cast<unsigned int>(pow(2., int(i)));
-		cols_i = m_width / s;
-		rows_i = m_height / s;
-		const int rows_i2 = 2 * rows_i;
-		const int cols_i2 = 2 * cols_i;
-		const int i_1 = i - 1;
+size_t numRowBands(unsigned int nRows)
+{
+	return (nRows + ROWS_PER_BAND - 1) / ROWS_PER_BAND;
+}
 
-		if (i == 0) depth[i].swap(depth_wf);
+// Rows [v0,v1) of `dst`, downsampled from `src`, of twice its size, with a
+// 5x5 gaussian mask which ignores pixels of too different depth
+void downsampleRows(
+	const CMatrixFloat& src, CMatrixFloat& dst, unsigned int v0,
+	unsigned int v1, const float (&g_mask)[5][5])
+{
+	const float max_depth_dif = 0.1f;
+	const unsigned int rows_i = dst.rows(), cols_i = dst.cols();
+	const int rows_i2 = 2 * rows_i;
+	const int cols_i2 = 2 * cols_i;
 
-		//                              Downsampling
-		//-----------------------------------------------------------------------------
-		else
+	for (unsigned int v = v0; v < v1; v++)
+		for (unsigned int u = 0; u < cols_i; u++)
 		{
-			for (unsigned int u = 0; u < cols_i; u++)
-				for (unsigned int v = 0; v < rows_i; v++)
+			const int u2 = 2 * u;
+			const int v2 = 2 * v;
+			const float dcenter = src(v2, u2);
+
+			// Inner pixels
+			if ((v > 0) && (v < rows_i - 1) && (u > 0) && (u < cols_i - 1))
+			{
+				if (dcenter > 0.f)
 				{
-					const int u2 = 2 * u;
-					const int v2 = 2 * v;
-					const float dcenter = depth[i_1](v2, u2);
+					float sum = 0.f;
+					float weight = 0.f;
 
-					// Inner pixels
-					if ((v > 0) && (v < rows_i - 1) && (u > 0) &&
-						(u < cols_i - 1))
-					{
-						if (dcenter > 0.f)
+					for (int l = -2; l < 3; l++)
+						for (int k = -2; k < 3; k++)
 						{
-							float sum = 0.f;
-							float weight = 0.f;
-
-							for (int l = -2; l < 3; l++)
-								for (int k = -2; k < 3; k++)
-								{
-									const float abs_dif = abs(
-										depth[i_1](v2 + k, u2 + l) - dcenter);
-									if (abs_dif < max_depth_dif)
-									{
-										const float aux_w =
-											g_mask[2 + k][2 + l] *
-											(max_depth_dif - abs_dif);
-										weight += aux_w;
-										sum +=
-											aux_w * depth[i_1](v2 + k, u2 + l);
-									}
-								}
-							depth[i](v, u) = sum / weight;
+							const float abs_dif =
+								abs(src(v2 + k, u2 + l) - dcenter);
+							if (abs_dif < max_depth_dif)
+							{
+								const float aux_w = g_mask[2 + k][2 + l] *
+									(max_depth_dif - abs_dif);
+								weight += aux_w;
+								sum += aux_w * src(v2 + k, u2 + l);
+							}
 						}
-						else
+					dst(v, u) = sum / weight;
+				}
+				else
+				{
+					float min_depth = 10.f;
+					for (int l = -2; l < 3; l++)
+						for (int k = -2; k < 3; k++)
 						{
-							float min_depth = 10.f;
-							for (int l = -2; l < 3; l++)
-								for (int k = -2; k < 3; k++)
-								{
-									const float d = depth[i_1](v2 + k, u2 + l);
-									if ((d > 0.f) && (d < min_depth))
-										min_depth = d;
-								}
-
-							if (min_depth < 10.f) depth[i](v, u) = min_depth;
-							else
-								depth[i](v, u) = 0.f;
+							const float d = src(v2 + k, u2 + l);
+							if ((d > 0.f) && (d < min_depth)) min_depth = d;
 						}
-					}
 
-					// Boundary
+					if (min_depth < 10.f) dst(v, u) = min_depth;
 					else
-					{
-						if (dcenter > 0.f)
-						{
-							float sum = 0.f;
-							float weight = 0.f;
+						dst(v, u) = 0.f;
+				}
+			}
+
+			// Boundary
+			else
+			{
+				if (dcenter > 0.f)
+				{
+					float sum = 0.f;
+					float weight = 0.f;
 
-							for (int l = -2; l < 3; l++)
-								for (int k = -2; k < 3; k++)
+					for (int l = -2; l < 3; l++)
+						for (int k = -2; k < 3; k++)
+						{
+							const int indv = v2 + k, indu = u2 + l;
+							if ((indv >= 0) && (indv < rows_i2) &&
+								(indu >= 0) && (indu < cols_i2))
+							{
+								const float abs_dif =
+									abs(src(indv, indu) - dcenter);
+								if (abs_dif < max_depth_dif)
 								{
-									const int indv = v2 + k, indu = u2 + l;
-									if ((indv >= 0) && (indv < rows_i2) &&
-										(indu >= 0) && (indu < cols_i2))
-									{
-										const float abs_dif = abs(
-											depth[i_1](indv, indu) - dcenter);
-										if (abs_dif < max_depth_dif)
-										{
-											const float aux_w =
-												g_mask[2 + k][2 + l] *
-												(max_depth_dif - abs_dif);
-											weight += aux_w;
-											sum +=
-												aux_w * depth[i_1](indv, indu);
-										}
-									}
+									const float aux_w = g_mask[2 + k][2 + l] *
+										(max_depth_dif - abs_dif);
+									weight += aux_w;
+									sum += aux_w * src(indv, indu);
 								}
-							depth[i](v, u) = sum / weight;
+							}
 						}
-						else
+					dst(v, u) = sum / weight;
+				}
+				else
+				{
+					float min_depth = 10.f;
+					for (int l = -2; l < 3; l++)
+						for (int k = -2; k < 3; k++)
 						{
-							float min_depth = 10.f;
-							for (int l = -2; l < 3; l++)
-								for (int k = -2; k < 3; k++)
-								{
-									const int indv = v2 + k, indu = u2 + l;
-									if ((indv >= 0) && (indv < rows_i2) &&
-										(indu >= 0) && (indu < cols_i2))
-									{
-										const float d = depth[i_1](indv, indu);
-										if ((d > 0.f) && (d < min_depth))
-											min_depth = d;
-									}
-								}
-
-							if (min_depth < 10.f) depth[i](v, u) = min_depth;
-							else
-								depth[i](v, u) = 0.f;
+							const int indv = v2 + k, indu = u2 + l;
+							if ((indv >= 0) && (indv < rows_i2) &&
+								(indu >= 0) && (indu < cols_i2))
+							{
+								const float d = src(indv, indu);
+								if ((d > 0.f) && (d < min_depth))
+									min_depth = d;
+							}
 						}
-					}
+
+					if (min_depth < 10.f) dst(v, u) = min_depth;
+					else
+						dst(v, u) = 0.f;
 				}
+			}
 		}
+}
 
-		// Calculate coordinates "xy" of the points
-		const float inv_f_i = 2.f * tan(0.5f * fovh) / float(cols_i);
-		const float disp_u_i = 0.5f * (cols_i - 1);
-		const float disp_v_i = 0.5f * (rows_i - 1);
+// As downsampleRows(), with a 4x4 mask around the median of the 4 central
+// pixels
+void downsampleRowsFast(
+	const CMatrixFloat& src, CMatrixFloat& dst, unsigned int v0,
+	unsigned int v1, const CMatrixFloat44& f_mask)
+{
+	const float max_depth_dif = 0.1f;
+	const unsigned int rows_i = dst.rows(), cols_i = dst.cols();
 
+	for (unsigned int v = v0; v < v1; v++)
 		for (unsigned int u = 0; u < cols_i; u++)
-			for (unsigned int v = 0; v < rows_i; v++)
-				if (depth[i](v, u) > 0.f)
-				{
-					xx[i](v, u) = (u - disp_u_i) * depth[i](v, u) * inv_f_i;
-					yy[i](v, u) = (v - disp_v_i) * depth[i](v, u) * inv_f_i;
-				}
+		{
+			const int u2 = 2 * u;
+			const int v2 = 2 * v;
+
+			// Inner pixels
+			if ((v > 0) && (v < rows_i - 1) && (u > 0) && (u < cols_i - 1))
+			{
+				const Matrix4f d_block =
+					src.asEigen().block<4, 4>(v2 - 1, u2 - 1);
+				float depths[4] = {
+					d_block(5), d_block(6), d_block(9), d_block(10)};
+				float dcenter;
+
+				// Sort the array (try to find a good/representative value)
+				for (signed char k = 2; k >= 0; k--)
+					if (depths[k + 1] < depths[k])
+						std::swap(depths[k + 1], depths[k]);
+				for (unsigned char k = 1; k < 3; k++)
+					if (depths[k] > depths[k + 1])
+						std::swap(depths[k + 1], depths[k]);
+				if (depths[2] < depths[1]) dcenter = depths[1];
 				else
+					dcenter = depths[2];
+
+				if (dcenter > 0.f)
 				{
-					xx[i](v, u) = 0.f;
-					yy[i](v, u) = 0.f;
+					float sum = 0.f;
+					float weight = 0.f;
+
+					for (unsigned char k = 0; k < 16; k++)
+					{
+						const float abs_dif = std::abs(d_block(k) - dcenter);
+						if (abs_dif < max_depth_dif)
+						{
+							const float aux_w = f_mask(k % 4, k / 4) *
+								(max_depth_dif - abs_dif);
+							weight += aux_w;
+							sum += aux_w * d_block(k);
+						}
+					}
+					if (weight > 0) dst(v, u) = sum / weight;
 				}
+				else
+					dst(v, u) = 0.f;
+			}
+
+			// Boundary
+			else
+			{
+				const Matrix2f d_block = src.asEigen().block<2, 2>(v2, u2);
+				const float new_d = 0.25f * d_block.array().sum();
+				if (new_d < 0.4f) dst(v, u) = 0.f;
+				else
+					dst(v, u) = new_d;
+			}
+		}
+}
+
+// Coordinates "xy" of the points of rows [v0,v1) of the depth image `d`
+void pointCoordinates(
+	const CMatrixFloat& d, CMatrixFloat& xx, CMatrixFloat& yy,
+	unsigned int v0, unsigned int v1, float fovh)
+{
+	const unsigned int rows_i = d.rows(), cols_i = d.cols();
+	const float inv_f_i = 2.f * tan(0.5f * fovh) / float(cols_i);
+	const float disp_u_i = 0.5f * (cols_i - 1);
+	const float disp_v_i = 0.5f * (rows_i - 1);
+
+	for (unsigned int v = v0; v < v1; v++)
+	{
+		const float* z = &d(v, 0);
+		float* x = &xx(v, 0);
+		float* y = &yy(v, 0);
+		const float yv = v - disp_v_i;
+		for (unsigned int u = 0; u < cols_i; u++)
+		{
+			x[u] = z[u] > 0.f ? (u - disp_u_i) * z[u] * inv_f_i : 0.f;
+			y[u] = z[u] > 0.f ? yv * z[u] * inv_f_i : 0.f;
+		}
 	}
 }
+}  // namespace
 
-void CDifodo::buildCoordinatesPyramidFast()
+void CDifodo::internal_forEachBand(
+	unsigned int nRows,
+	const std::function<void(size_t, unsigned int, unsigned int)>& fn)
 {
-	const float max_depth_dif = 0.1f;
+	const size_t nBands = numRowBands(nRows);
+	const auto runBand = [&](size_t b) {
+		const unsigned int v0 = b * ROWS_PER_BAND;
+		fn(b, v0, std::min(v0 + ROWS_PER_BAND, nRows));
+	};
+
+	size_t nThreads = num_threads;
+	if (!nThreads) nThreads = std::max(1U, std::thread::hardware_concurrency());
+	if (nThreads <= 1 || nBands <= 1)
+	{
+		for (size_t b = 0; b < nBands; b++)
+			runBand(b);
+		return;
+	}
 
-	// Push coordinates back
-	depth_old.swap(depth);
-	xx_old.swap(xx);
-	yy_old.swap(yy);
+	// This may be called from the caller and the solver threads at once:
+	std::shared_ptr<mrpt::WorkerThreadsPool> pool;
+	{
+		std::lock_guard<std::mutex> lck(m_threadPoolMtx);
+		if (!m_threadPool || m_threadPool->size() != nThreads - 1)
+			m_threadPool = std::make_shared<mrpt::WorkerThreadsPool>(
+				nThreads - 1, mrpt::WorkerThreadsPool::POLICY_FIFO, "CDifodo");
+		pool = m_threadPool;
+	}
+	// The calling thread also runs bands:
+	pool->parallel_for(0, nBands, 1, runBand);
+}
 
+void CDifodo::buildNextPyramid(bool fast)
+{
 	// The number of levels of the pyramid does not match the number of levels
 	// used
 	// in the odometry computation (because we might want to finish with lower
 	// resolutions)
 
-	unsigned int pyr_levels =
+	const unsigned int pyr_levels =
 		round(log(float(m_width / cols)) / log(2.f)) + ctf_levels;
+	depth_next.resize(pyr_levels);
+	xx_next.resize(pyr_levels);
+	yy_next.resize(pyr_levels);
 
 	// Generate levels
 	for (unsigned int i = 0; i < pyr_levels; i++)
 	{
-		unsigned int s = static_cast<unsigned int>(pow(2., int(i)));
-		cols_i = m_width / s;
-		rows_i = m_height / s;
-		// const int rows_i2 = 2*rows_i;
-		// const int cols_i2 = 2*cols_i;
-		const int i_1 = i - 1;
-
-		if (i == 0) depth[i].swap(depth_wf);
+		const unsigned int s = 1U << i;
+		const unsigned int cols_l = m_width / s;
+		const unsigned int rows_l = m_height / s;
 
-		//                              Downsampling
-		//-----------------------------------------------------------------------------
-		else
+		if (i == 0)
 		{
-			for (unsigned int u = 0; u < cols_i; u++)
-				for (unsigned int v = 0; v < rows_i; v++)
-				{
-					const int u2 = 2 * u;
-					const int v2 = 2 * v;
-
-					// Inner pixels
-					if ((v > 0) && (v < rows_i - 1) && (u > 0) &&
-						(u < cols_i - 1))
-					{
-						const Matrix4f d_block =
-							depth[i_1].block<4, 4>(v2 - 1, u2 - 1);
-						float depths[4] = {
-							d_block(5), d_block(6), d_block(9), d_block(10)};
-						float dcenter;
-
-						// Sort the array (try to find a good/representative
-						// value)
-						for (signed char k = 2; k >= 0; k--)
-							if (depths[k + 1] < depths[k])
-								std::swap(depths[k + 1], depths[k]);
-						for (unsigned char k = 1; k < 3; k++)
-							if (depths[k] > depths[k + 1])
-								std::swap(depths[k + 1], depths[k]);
-						if (depths[2] < depths[1]) dcenter = depths[1];
-						else
-							dcenter = depths[2];
-
-						if (dcenter > 0.f)
-						{
-							float sum = 0.f;
-							float weight = 0.f;
+			depth_next[i].swap(depth_wf);
+			// The buffer of the next frame, if this was the first one:
+			depth_wf.resize(m_height, m_width);
+		}
+		else
+			depth_next[i].resize(rows_l, cols_l);
+		xx_next[i].resize(depth_next[i].rows(), depth_next[i].cols());
+		yy_next[i].resize(depth_next[i].rows(), depth_next[i].cols());
+
+		// Downsampling and coordinates, in the same pass of each band:
+		internal_forEachBand(
+			depth_next[i].rows(),
+			[&](size_t, unsigned int v0, unsigned int v1) {
+				if (i > 0 && fast)
+					downsampleRowsFast(
+						depth_next[i - 1], depth_next[i], v0, v1, f_mask);
+				else if (i > 0)
+					downsampleRows(
+						depth_next[i - 1], depth_next[i], v0, v1, g_mask);
+				pointCoordinates(
+					depth_next[i], xx_next[i], yy_next[i], v0, v1, fovh);
+			});
+	}
+}
 
-							for (unsigned char k = 0; k < 16; k++)
-							{
-								const float abs_dif =
-									std::abs(d_block(k) - dcenter);
-								if (abs_dif < max_depth_dif)
-								{
-									const float aux_w =
-										f_mask[k] * (max_depth_dif - abs_dif);
-									weight += aux_w;
-									sum += aux_w * d_block(k);
-								}
-							}
-							if (weight > 0) depth[i](v, u) = sum / weight;
-						}
-						else
-							depth[i](v, u) = 0.f;
-					}
+void CDifodo::pushPyramid()
+{
+	// Push coordinates back
+	depth_old.swap(depth);
+	xx_old.swap(xx);
+	yy_old.swap(yy);
 
-					// Boundary
-					else
-					{
-						const Matrix2f d_block = depth[i_1].block<2, 2>(v2, u2);
-						const float new_d = 0.25f * d_block.array().sum();
-						if (new_d < 0.4f) depth[i](v, u) = 0.f;
-						else
-							depth[i](v, u) = new_d;
-					}
-				}
-		}
+	depth.swap(depth_next);
+	xx.swap(xx_next);
+	yy.swap(yy_next);
+}
 
-		// Calculate coordinates "xy" of the points
-		const float inv_f_i = 2.f * tan(0.5f * fovh) / float(cols_i);
-		const float disp_u_i = 0.5f * (cols_i - 1);
-		const float disp_v_i = 0.5f * (rows_i - 1);
+void CDifodo::buildCoordinatesPyramid()
+{
+	buildNextPyramid(false);
+	pushPyramid();
+}
 
-		for (unsigned int u = 0; u < cols_i; u++)
-			for (unsigned int v = 0; v < rows_i; v++)
-				if (depth[i](v, u) > 0.f)
-				{
-					xx[i](v, u) = (u - disp_u_i) * depth[i](v, u) * inv_f_i;
-					yy[i](v, u) = (v - disp_v_i) * depth[i](v, u) * inv_f_i;
-				}
-				else
-				{
-					xx[i](v, u) = 0.f;
-					yy[i](v, u) = 0.f;
-				}
-	}
+void CDifodo::buildCoordinatesPyramidFast()
+{
+	buildNextPyramid(true);
+	pushPyramid();
 }
 
 void CDifodo::performWarping()
@@ -397,7 +461,7 @@ void CDifodo::performWarping()
 	for (unsigned int i = 1; i <= level; i++)
 		acu_trans = transformations[i - 1].asEigen() * acu_trans;
 
-	MatrixXf wacu(rows_i, cols_i);
+	wacu.resize(rows_i, cols_i);
 	wacu.fill(0.f);
 	depth_warped[image_level].fill(0.f);
 
@@ -406,8 +470,8 @@ void CDifodo::performWarping()
 
 	//						Warping loop
 	//---------------------------------------------------------
-	for (unsigned int j = 0; j < cols_i; j++)
-		for (unsigned int i = 0; i < rows_i; i++)
+	for (unsigned int i = 0; i < rows_i; i++)
+		for (unsigned int j = 0; j < cols_i; j++)
 		{
 			const float z = depth[image_level](i, j);
 
@@ -478,147 +542,150 @@ void CDifodo::performWarping()
 		}
 
 	// Scale the averaged depth and compute spatial coordinates
+	auto& dw = depth_warped[image_level];
+	auto& xw = xx_warped[image_level];
+	auto& yw = yy_warped[image_level];
 	const float inv_f_i = 1.f / f;
-	for (unsigned int u = 0; u < cols_i; u++)
-		for (unsigned int v = 0; v < rows_i; v++)
-		{
-			if (wacu(v, u) > 0.f)
-			{
-				depth_warped[image_level](v, u) /= wacu(v, u);
-				xx_warped[image_level](v, u) =
-					(u - disp_u_i) * depth_warped[image_level](v, u) * inv_f_i;
-				yy_warped[image_level](v, u) =
-					(v - disp_v_i) * depth_warped[image_level](v, u) * inv_f_i;
-			}
-			else
+	internal_forEachBand(rows_i, [&](size_t, unsigned int v0, unsigned int v1) {
+		for (unsigned int v = v0; v < v1; v++)
+			for (unsigned int u = 0; u < cols_i; u++)
 			{
-				depth_warped[image_level](v, u) = 0.f;
-				xx_warped[image_level](v, u) = 0.f;
-				yy_warped[image_level](v, u) = 0.f;
+				if (wacu(v, u) > 0.f)
+				{
+					dw(v, u) /= wacu(v, u);
+					xw(v, u) = (u - disp_u_i) * dw(v, u) * inv_f_i;
+					yw(v, u) = (v - disp_v_i) * dw(v, u) * inv_f_i;
+				}
+				else
+				{
+					dw(v, u) = 0.f;
+					xw(v, u) = 0.f;
+					yw(v, u) = 0.f;
+				}
 			}
-		}
+	});
 }
 
 void CDifodo::calculateCoord()
 {
 	null.resize(rows_i, cols_i);
-	null.fill(false);
-	num_valid_points = 0;
 
-	for (unsigned int u = 0; u < cols_i; u++)
-		for (unsigned int v = 0; v < rows_i; v++)
-		{
-			if ((depth_old[image_level](v, u)) == 0.f ||
-				(depth_warped[image_level](v, u) == 0.f))
-			{
-				depth_inter[image_level](v, u) = 0.f;
-				xx_inter[image_level](v, u) = 0.f;
-				yy_inter[image_level](v, u) = 0.f;
-				null(v, u) = true;
-			}
-			else
-			{
-				depth_inter[image_level](v, u) = 0.5f *
-					(depth_old[image_level](v, u) +
-					 depth_warped[image_level](v, u));
-				xx_inter[image_level](v, u) = 0.5f *
-					(xx_old[image_level](v, u) + xx_warped[image_level](v, u));
-				yy_inter[image_level](v, u) = 0.5f *
-					(yy_old[image_level](v, u) + yy_warped[image_level](v, u));
-				null(v, u) = false;
-				if ((u > 0) && (v > 0) && (u < cols_i - 1) && (v < rows_i - 1))
-					num_valid_points++;
-			}
-		}
+	const auto& d_old = depth_old[image_level];
+	const auto& d_warped = depth_warped[image_level];
+	const auto& x_old = xx_old[image_level];
+	const auto& x_warped = xx_warped[image_level];
+	const auto& y_old = yy_old[image_level];
+	const auto& y_warped = yy_warped[image_level];
+	auto& d_inter = depth_inter[image_level];
+	auto& x_inter = xx_inter[image_level];
+	auto& y_inter = yy_inter[image_level];
+
+	std::vector<unsigned int> valid(numRowBands(rows_i), 0);
+	internal_forEachBand(
+		rows_i, [&](size_t band, unsigned int v0, unsigned int v1) {
+			for (unsigned int v = v0; v < v1; v++)
+				for (unsigned int u = 0; u < cols_i; u++)
+				{
+					if (d_old(v, u) == 0.f || d_warped(v, u) == 0.f)
+					{
+						d_inter(v, u) = 0.f;
+						x_inter(v, u) = 0.f;
+						y_inter(v, u) = 0.f;
+						null(v, u) = true;
+					}
+					else
+					{
+						d_inter(v, u) = 0.5f * (d_old(v, u) + d_warped(v, u));
+						x_inter(v, u) = 0.5f * (x_old(v, u) + x_warped(v, u));
+						y_inter(v, u) = 0.5f * (y_old(v, u) + y_warped(v, u));
+						null(v, u) = false;
+						if ((u > 0) && (v > 0) && (u < cols_i - 1) &&
+							(v < rows_i - 1))
+							valid[band]++;
+					}
+				}
+		});
+
+	num_valid_points = 0;
+	for (const auto n : valid)
+		num_valid_points += n;
 }
 
 void CDifodo::calculateDepthDerivatives()
 {
 	dt.resize(rows_i, cols_i);
-	dt.fill(0.f);
 	du.resize(rows_i, cols_i);
-	du.fill(0.f);
 	dv.resize(rows_i, cols_i);
-	dv.fill(0.f);
+	rx_ninv.resize(rows_i, cols_i);
+	ry_ninv.resize(rows_i, cols_i);
 
-	// Compute connectivity
-	MatrixXf rx_ninv(rows_i, cols_i);
-	MatrixXf ry_ninv(rows_i, cols_i);
-	rx_ninv.fill(1.f);
-	ry_ninv.fill(1.f);
-
-	for (unsigned int u = 0; u < cols_i - 1; u++)
-		for (unsigned int v = 0; v < rows_i; v++)
-			if (null(v, u) == false)
-			{
-				rx_ninv(v, u) = sqrtf(
-					square(
-						xx_inter[image_level](v, u + 1) -
-						xx_inter[image_level](v, u)) +
-					square(
-						depth_inter[image_level](v, u + 1) -
-						depth_inter[image_level](v, u)));
-			}
+	const auto& d_inter = depth_inter[image_level];
+	const auto& x_inter = xx_inter[image_level];
+	const auto& y_inter = yy_inter[image_level];
 
-	for (unsigned int u = 0; u < cols_i; u++)
-		for (unsigned int v = 0; v < rows_i - 1; v++)
-			if (null(v, u) == false)
+	// Compute connectivity
+	internal_forEachBand(rows_i, [&](size_t, unsigned int v0, unsigned int v1) {
+		for (unsigned int v = v0; v < v1; v++)
+			for (unsigned int u = 0; u < cols_i; u++)
 			{
-				ry_ninv(v, u) = sqrtf(
-					square(
-						yy_inter[image_level](v + 1, u) -
-						yy_inter[image_level](v, u)) +
-					square(
-						depth_inter[image_level](v + 1, u) -
-						depth_inter[image_level](v, u)));
+				du(v, u) = dv(v, u) = dt(v, u) = 0.f;
+
+				rx_ninv(v, u) = (u < cols_i - 1 && !null(v, u))
+					? sqrtf(
+						  square(x_inter(v, u + 1) - x_inter(v, u)) +
+						  square(d_inter(v, u + 1) - d_inter(v, u)))
+					: 1.f;
+				ry_ninv(v, u) = (v < rows_i - 1 && !null(v, u))
+					? sqrtf(
+						  square(y_inter(v + 1, u) - y_inter(v, u)) +
+						  square(d_inter(v + 1, u) - d_inter(v, u)))
+					: 1.f;
 			}
+	});
+
+	// Spatial and temporal derivatives
+	const auto& d_warped = depth_warped[image_level];
+	const auto& d_old = depth_old[image_level];
+	const float fps_f = d2f(fps);
+	internal_forEachBand(rows_i, [&](size_t, unsigned int v0, unsigned int v1) {
+		for (unsigned int v = v0; v < v1; v++)
+		{
+			for (unsigned int u = 1; u < cols_i - 1; u++)
+				if (null(v, u) == false)
+					du(v, u) = (rx_ninv(v, u - 1) *
+									(d_inter(v, u + 1) - d_inter(v, u)) +
+								rx_ninv(v, u) *
+									(d_inter(v, u) - d_inter(v, u - 1))) /
+						(rx_ninv(v, u) + rx_ninv(v, u - 1));
+
+			du(v, 0) = du(v, 1);
+			du(v, cols_i - 1) = du(v, cols_i - 2);
+
+			if (v > 0 && v < rows_i - 1)
+				for (unsigned int u = 0; u < cols_i; u++)
+					if (null(v, u) == false)
+						dv(v, u) = (ry_ninv(v - 1, u) *
+										(d_inter(v + 1, u) - d_inter(v, u)) +
+									ry_ninv(v, u) *
+										(d_inter(v, u) - d_inter(v - 1, u))) /
+							(ry_ninv(v, u) + ry_ninv(v - 1, u));
 
-	// Spatial derivatives
-	for (unsigned int v = 0; v < rows_i; v++)
-	{
-		for (unsigned int u = 1; u < cols_i - 1; u++)
-			if (null(v, u) == false)
-				du(v, u) = (rx_ninv(v, u - 1) *
-								(depth_inter[image_level](v, u + 1) -
-								 depth_inter[image_level](v, u)) +
-							rx_ninv(v, u) *
-								(depth_inter[image_level](v, u) -
-								 depth_inter[image_level](v, u - 1))) /
-					(rx_ninv(v, u) + rx_ninv(v, u - 1));
-
-		du(v, 0) = du(v, 1);
-		du(v, cols_i - 1) = du(v, cols_i - 2);
-	}
+			for (unsigned int u = 0; u < cols_i; u++)
+				if (null(v, u) == false)
+					dt(v, u) = fps_f * (d_warped(v, u) - d_old(v, u));
+		}
+	});
 
 	for (unsigned int u = 0; u < cols_i; u++)
 	{
-		for (unsigned int v = 1; v < rows_i - 1; v++)
-			if (null(v, u) == false)
-				dv(v, u) = (ry_ninv(v - 1, u) *
-								(depth_inter[image_level](v + 1, u) -
-								 depth_inter[image_level](v, u)) +
-							ry_ninv(v, u) *
-								(depth_inter[image_level](v, u) -
-								 depth_inter[image_level](v - 1, u))) /
-					(ry_ninv(v, u) + ry_ninv(v - 1, u));
-
 		dv(0, u) = dv(1, u);
 		dv(rows_i - 1, u) = dv(rows_i - 2, u);
 	}
-
-	// Temporal derivative
-	for (unsigned int u = 0; u < cols_i; u++)
-		for (unsigned int v = 0; v < rows_i; v++)
-			if (null(v, u) == false)
-				dt(v, u) = d2f(fps) *
-					(depth_warped[image_level](v, u) -
-					 depth_old[image_level](v, u));
 }
 
 void CDifodo::computeWeights()
 {
 	weights.resize(rows_i, cols_i);
-	weights.fill(0.f);
 
 	// Obtain the velocity associated to the rigid transformation estimated up
 	// to the present level
@@ -649,183 +716,187 @@ void CDifodo::computeWeights()
 	const float k2dt = 5e-6f;
 	const float k2duv = 5e-6f;
 
-	for (unsigned int u = 1; u < cols_i - 1; u++)
-		for (unsigned int v = 1; v < rows_i - 1; v++)
-			if (null(v, u) == false)
-			{
-				//					Compute measurment error (simplified)
-				//-----------------------------------------------------------------------
-				const float z = depth_inter[image_level](v, u);
-				const float inv_d = 1.f / z;
-				// const float dycomp = du2(v,u)*f_inv_y*inv_d;
-				// const float dzcomp = dv2(v,u)*f_inv_z*inv_d;
-				const float z2 = z * z;
-				const float z4 = z2 * z2;
-
-				// const float var11 = kz2*z4;
-				// const float var12 =
-				// kz2*xx_inter[image_level](v,u)*z2*depth_inter[image_level](v,u);
-				// const float var13 =
-				// kz2*yy_inter[image_level](v,u)*z2*depth_inter[image_level](v,u);
-				// const float var22 =
-				// kz2*square(xx_inter[image_level](v,u))*z2;
-				// const float var23 =
-				// kz2*xx_inter[image_level](v,u)*yy_inter[image_level](v,u)*z2;
-				// const float var33 =
-				// kz2*square(yy_inter[image_level](v,u))*z2;
-				const float var44 = kz2 * z4 * square<double, float>(fps);
-				const float var55 = kz2 * z4 * 0.25f;
-				const float var66 = var55;
-
-				// const float j1 =
-				// -2.f*inv_d*inv_d*(xx_inter[image_level](v,u)*dycomp +
-				// yy_inter[image_level](v,u)*dzcomp)*(kai_level[0] +
-				// yy_inter[image_level](v,u)*kai_level[4] -
-				// xx_inter[image_level](v,u)*kai_level[5])
-				//				+ inv_d*dycomp*(kai_level[1] -
-				// yy_inter[image_level](v,u)*kai_level[3]) +
-				// inv_d*dzcomp*(kai_level[2] +
-				// xx_inter[image_level](v,u)*kai_level[3]);
-				// const float j2 = inv_d*dycomp*(kai_level[0] +
-				// yy_inter[image_level](v,u)*kai_level[4] -
-				// 2.f*xx_inter[image_level](v,u)*kai_level[5]) -
-				// dzcomp*kai_level[3];
-				// const float j3 = inv_d*dzcomp*(kai_level[0] +
-				// 2.f*yy_inter[image_level](v,u)*kai_level[4] -
-				// xx_inter[image_level](v,u)*kai_level[5]) +
-				// dycomp*kai_level[3];
-
-				const float j4 = 1.f;
-				const float j5 = xx_inter[image_level](v, u) * inv_d * inv_d *
-						f_inv *
-						(kai_level[0] +
-						 yy_inter[image_level](v, u) * kai_level[4] -
-						 xx_inter[image_level](v, u) * kai_level[5]) +
-					inv_d * f_inv *
-						(-kai_level[1] - z * kai_level[5] +
-						 yy_inter[image_level](v, u) * kai_level[3]);
-				const float j6 = yy_inter[image_level](v, u) * inv_d * inv_d *
-						f_inv *
-						(kai_level[0] +
-						 yy_inter[image_level](v, u) * kai_level[4] -
-						 xx_inter[image_level](v, u) * kai_level[5]) +
-					inv_d * f_inv *
-						(-kai_level[2] + z * kai_level[4] -
-						 xx_inter[image_level](v, u) * kai_level[3]);
-
-				// error_measurement(v,u) = j1*(j1*var11+j2*var12+j3*var13) +
-				// j2*(j1*var12+j2*var22+j3*var23)
-				//						+j3*(j1*var13+j2*var23+j3*var33) +
-				// j4*j4*var44
-				//+
-				// j5*j5*var55 + j6*j6*var66;
-
-				const float error_m =
-					j4 * j4 * var44 + j5 * j5 * var55 + j6 * j6 * var66;
-
-				//					Compute linearization error
-				//-----------------------------------------------------------------------
-				const float ini_du = depth_old[image_level](v, u + 1) -
-					depth_old[image_level](v, u - 1);
-				const float ini_dv = depth_old[image_level](v + 1, u) -
-					depth_old[image_level](v - 1, u);
-				const float final_du = depth_warped[image_level](v, u + 1) -
-					depth_warped[image_level](v, u - 1);
-				const float final_dv = depth_warped[image_level](v + 1, u) -
-					depth_warped[image_level](v - 1, u);
-
-				const float dut = ini_du - final_du;
-				const float dvt = ini_dv - final_dv;
-				const float duu = du(v, u + 1) - du(v, u - 1);
-				const float dvv = dv(v + 1, u) - dv(v - 1, u);
-				const float dvu = dv(v, u + 1) -
-					dv(v, u - 1);  // Completely equivalent to compute duv
-
-				const float error_l = kdt * square(dt(v, u)) +
-					kduv * (square(du(v, u)) + square(dv(v, u))) +
-					k2dt * (square(dut) + square(dvt)) +
-					k2duv * (square(duu) + square(dvv) + square(dvu));
-
-				// Weight
-				weights(v, u) = sqrt(1.f / (error_m + error_l));
-			}
+	const auto& d_inter = depth_inter[image_level];
+	const auto& x_inter = xx_inter[image_level];
+	const auto& y_inter = yy_inter[image_level];
+	const auto& d_old = depth_old[image_level];
+	const auto& d_warped = depth_warped[image_level];
+
+	std::vector<float> maxWeight(numRowBands(rows_i), 0.f);
+	internal_forEachBand(
+		rows_i, [&](size_t band, unsigned int v0, unsigned int v1) {
+			for (unsigned int v = v0; v < v1; v++)
+				for (unsigned int u = 0; u < cols_i; u++)
+				{
+					weights(v, u) = 0.f;
+					if (u == 0 || v == 0 || u == cols_i - 1 ||
+						v == rows_i - 1 || null(v, u))
+						continue;
+
+					//				Compute measurment error (simplified)
+					//-------------------------------------------------------
+					const float z = d_inter(v, u);
+					const float inv_d = 1.f / z;
+					const float z2 = z * z;
+					const float z4 = z2 * z2;
+					const float x = x_inter(v, u), y = y_inter(v, u);
+
+					const float var44 = kz2 * z4 * square<double, float>(fps);
+					const float var55 = kz2 * z4 * 0.25f;
+					const float var66 = var55;
+
+					const float j4 = 1.f;
+					const float j5 = x * inv_d * inv_d * f_inv *
+							(kai_level[0] + y * kai_level[4] -
+							 x * kai_level[5]) +
+						inv_d * f_inv *
+							(-kai_level[1] - z * kai_level[5] +
+							 y * kai_level[3]);
+					const float j6 = y * inv_d * inv_d * f_inv *
+							(kai_level[0] + y * kai_level[4] -
+							 x * kai_level[5]) +
+						inv_d * f_inv *
+							(-kai_level[2] + z * kai_level[4] -
+							 x * kai_level[3]);
+
+					const float error_m =
+						j4 * j4 * var44 + j5 * j5 * var55 + j6 * j6 * var66;
+
+					//				Compute linearization error
+					//-------------------------------------------------------
+					const float ini_du = d_old(v, u + 1) - d_old(v, u - 1);
+					const float ini_dv = d_old(v + 1, u) - d_old(v - 1, u);
+					const float final_du =
+						d_warped(v, u + 1) - d_warped(v, u - 1);
+					const float final_dv =
+						d_warped(v + 1, u) - d_warped(v - 1, u);
+
+					const float dut = ini_du - final_du;
+					const float dvt = ini_dv - final_dv;
+					const float duu = du(v, u + 1) - du(v, u - 1);
+					const float dvv = dv(v + 1, u) - dv(v - 1, u);
+					const float dvu = dv(v, u + 1) -
+						dv(v, u - 1);  // Completely equivalent to compute duv
+
+					const float error_l = kdt * square(dt(v, u)) +
+						kduv * (square(du(v, u)) + square(dv(v, u))) +
+						k2dt * (square(dut) + square(dvt)) +
+						k2duv * (square(duu) + square(dvv) + square(dvu));
+
+					// Weight
+					weights(v, u) = sqrt(1.f / (error_m + error_l));
+					maxWeight[band] = std::max(maxWeight[band], weights(v, u));
+				}
+		});
 
 	// Normalize weights in the range [0,1]
-	const float inv_max = 1.f / weights.maxCoeff();
+	const float inv_max =
+		1.f / *std::max_element(maxWeight.begin(), maxWeight.end());
 	weights *= inv_max;
 }
 
 void CDifodo::solveOneLevel()
 {
-	MatrixXf A(num_valid_points, 6);
-	MatrixXf B(num_valid_points, 1);
-	unsigned int cont = 0;
-
-	// Fill the matrix A and the vector B
+	// The equations of the overdetermined system are those of the pixels
+	// (1,1), (1,2)...(1,cols-1), (2,1), (2,2)...(row-1,cols-1) with valid
+	// depth. Their normal equations are accumulated in parallel by bands.
 	// The order of the unknowns is (vz, vx, vy, wz, wx, wy)
-	// The points order will be (1,1), (1,2)...(1,cols-1), (2,1),
-	// (2,2)...(row-1,cols-1).
+	using Vector6f = Matrix<float, 6, 1>;
+	using Matrix6d = Matrix<double, 6, 6>;
+	using Vector6d = Matrix<double, 6, 1>;
 
 	const float f_inv = float(cols_i) / (2.f * tan(0.5f * fovh));
-
-	for (unsigned int u = 1; u < cols_i - 1; u++)
-		for (unsigned int v = 1; v < rows_i - 1; v++)
-			if (null(v, u) == false)
+	const auto& d_inter = depth_inter[image_level];
+	const auto& x_inter = xx_inter[image_level];
+	const auto& y_inter = yy_inter[image_level];
+
+	// Row of A and element of B of the equation of pixel (v,u):
+	const auto equation = [&](unsigned int v, unsigned int u, Vector6f& a,
+							  float& b) {
+		// Precomputed expressions
+		const float d = d_inter(v, u);
+		const float inv_d = 1.f / d;
+		const float x = x_inter(v, u);
+		const float y = y_inter(v, u);
+		const float dycomp = du(v, u) * f_inv * inv_d;
+		const float dzcomp = dv(v, u) * f_inv * inv_d;
+		const float tw = weights(v, u);
+
+		a[0] = tw * (1.f + dycomp * x * inv_d + dzcomp * y * inv_d);
+		a[1] = tw * (-dycomp);
+		a[2] = tw * (-dzcomp);
+		a[3] = tw * (dycomp * y - dzcomp * x);
+		a[4] = tw * (y + dycomp * inv_d * y * x + dzcomp * (y * y * inv_d + d));
+		a[5] = tw *
+			(-x - dycomp * (x * x * inv_d + d) - dzcomp * inv_d * y * x);
+		b = tw * (-dt(v, u));
+	};
+
+	const size_t nBands = numRowBands(rows_i);
+	std::vector<Matrix6d> bandAtA(nBands, Matrix6d::Zero());
+	std::vector<Vector6d> bandAtB(nBands, Vector6d::Zero());
+	internal_forEachBand(
+		rows_i, [&](size_t band, unsigned int v0, unsigned int v1) {
+			Vector6f a;
+			float b;
+			for (unsigned int v = std::max(v0, 1U);
+				 v < std::min(v1, rows_i - 1); v++)
 			{
-				// Precomputed expressions
-				const float d = depth_inter[image_level](v, u);
-				const float inv_d = 1.f / d;
-				const float x = xx_inter[image_level](v, u);
-				const float y = yy_inter[image_level](v, u);
-				const float dycomp = du(v, u) * f_inv * inv_d;
-				const float dzcomp = dv(v, u) * f_inv * inv_d;
-				const float tw = weights(v, u);
-
-				// Fill the matrix A
-				A(cont, 0) =
-					tw * (1.f + dycomp * x * inv_d + dzcomp * y * inv_d);
-				A(cont, 1) = tw * (-dycomp);
-				A(cont, 2) = tw * (-dzcomp);
-				A(cont, 3) = tw * (dycomp * y - dzcomp * x);
-				A(cont, 4) = tw *
-					(y + dycomp * inv_d * y * x + dzcomp * (y * y * inv_d + d));
-				A(cont, 5) = tw *
-					(-x - dycomp * (x * x * inv_d + d) -
-					 dzcomp * inv_d * y * x);
-				B(cont, 0) = tw * (-dt(v, u));
-
-				cont++;
+				// Single precision within each row:
+				Matrix<float, 6, 6> rowAtA = Matrix<float, 6, 6>::Zero();
+				Vector6f rowAtB = Vector6f::Zero();
+				for (unsigned int u = 1; u < cols_i - 1; u++)
+					if (null(v, u) == false)
+					{
+						equation(v, u, a, b);
+						rowAtA.noalias() += a * a.transpose();
+						rowAtB += b * a;
+					}
+				bandAtA[band] += rowAtA.cast<double>();
+				bandAtB[band] += rowAtB.cast<double>();
 			}
+		});
 
 	// Solve the linear system of equations using weighted least squares
-	const MatrixXf AtA = A.transpose() * A;
-	const MatrixXf AtB = A.transpose() * B;
-	VectorXf Var = AtA.ldlt().solve(AtB);
+	Matrix6d AtA = Matrix6d::Zero();
+	Vector6d AtB = Vector6d::Zero();
+	for (size_t i = 0; i < nBands; i++)
+	{
+		AtA += bandAtA[i];
+		AtB += bandAtB[i];
+	}
+	const Vector6d Var = AtA.ldlt().solve(AtB);
+	const Vector6f Varf = Var.cast<float>();
 
 	// Covariance matrix calculation
-	MatrixXf res = -B;
-	for (unsigned int k = 0; k < 6; k++)
-		res += Var(k) * A.col(k);
+	std::vector<double> bandRes2(nBands, 0);
+	internal_forEachBand(
+		rows_i, [&](size_t band, unsigned int v0, unsigned int v1) {
+			Vector6f a;
+			float b;
+			for (unsigned int v = std::max(v0, 1U);
+				 v < std::min(v1, rows_i - 1); v++)
+				for (unsigned int u = 1; u < cols_i - 1; u++)
+					if (null(v, u) == false)
+					{
+						equation(v, u, a, b);
+						bandRes2[band] += square(a.dot(Varf) - b);
+					}
+		});
+	double res2 = 0;
+	for (const auto r : bandRes2)
+		res2 += r;
 
-	est_cov =
-		(1.f / float(num_valid_points - 6)) * AtA.inverse() * res.squaredNorm();
+	est_cov.asEigen() =
+		(AtA.inverse() * (res2 / double(num_valid_points - 6))).cast<float>();
 
 	// Update last velocity in local coordinates
 	// (vx, vy, vz, wx, wy, wz)
 	kai_loc_level.fromVector(Var);
 }
 
-void CDifodo::odometryCalculation()
+void CDifodo::solveAllLevels()
 {
-	// Clock to measure the runtime
-	mrpt::system::CTicTac clock;
-	clock.Tic();
-
-	// Build the gaussian pyramid
-	if (fast_pyramid) buildCoordinatesPyramidFast();
-	else
-		buildCoordinatesPyramid();
-
 	// Coarse-to-fines scheme
 	for (unsigned int i = 0; i < ctf_levels; i++)
 	{
@@ -868,11 +939,54 @@ void CDifodo::odometryCalculation()
 
 	// Update poses
 	poseUpdate();
+}
+
+void CDifodo::odometryCalculation()
+{
+	waitForOdometry();
+
+	// Clock to measure the runtime
+	mrpt::system::CTicTac clock;
+	clock.Tic();
+
+	// Build the gaussian pyramid
+	buildNextPyramid(fast_pyramid);
+	pushPyramid();
+
+	solveAllLevels();
 
 	// Save runtime
 	execution_time = d2f(1000 * clock.Tac());
 }
 
+void CDifodo::odometryCalculationAsync()
+{
+	mrpt::system::CTicTac clock;
+	clock.Tic();
+
+	// While the solver of the former frame may be running:
+	buildNextPyramid(fast_pyramid);
+	const float pyramidTime = d2f(1000 * clock.Tac());
+
+	waitForOdometry();
+	pushPyramid();
+
+	if (!m_solverThread)
+		m_solverThread = std::make_shared<mrpt::WorkerThreadsPool>(
+			1, mrpt::WorkerThreadsPool::POLICY_FIFO, "CDifodo_solver");
+	m_pendingSolver = m_solverThread->enqueue([this, pyramidTime]() {
+		mrpt::system::CTicTac solverClock;
+		solverClock.Tic();
+		solveAllLevels();
+		execution_time = pyramidTime + d2f(1000 * solverClock.Tac());
+	});
+}
+
+void CDifodo::waitForOdometry()
+{
+	if (m_pendingSolver.valid()) m_pendingSolver.get();
+}
+
 void CDifodo::filterLevelSolution()
 {
 	//		Calculate Eigenvalues and Eigenvectors
@@ -17,7 +17,9 @@
 #include <mrpt/serialization/optional_serialization.h>
 #include <mrpt/serialization/stl_serialization.h>
 #include <mrpt/system/os.h>
+#include <mrpt/vision/CBinaryDescriptorMatcher.h>
 #include <mrpt/vision/CFeature.h>
+#include <mrpt/vision/CTemplateMatcher.h>
 #include <mrpt/vision/types.h>
 #include <mrpt/vision/utils.h>
 
@@ -363,10 +365,15 @@ float CFeature::patchCorrelationTo(const CFeature& oFeature) const
 	ASSERT_(patch->getWidth() == oFeature.patch->getWidth());
 	ASSERT_(patch->getHeight() == oFeature.patch->getHeight());
 	ASSERT_(patch->getHeight() > 0 && patch->getWidth() > 0);
-	size_t x_max, y_max;
 	double max_val;
-	mrpt::vision::openCV_cross_correlation(
-		*patch, *oFeature.patch, x_max, y_max, max_val);
+	if (!patch->isColor() && !oFeature.patch->isColor())
+		max_val = CTemplateMatcher::patchCorrelation(*patch, *oFeature.patch);
+	else
+	{
+		size_t x_max, y_max;
+		mrpt::vision::openCV_cross_correlation(
+			*patch, *oFeature.patch, x_max, y_max, max_val);
+	}
 
 	// Value as "distance" in the range [0,1], best = 0
 	return d2f(0.5 - 0.5 * max_val);
@@ -710,20 +717,8 @@ uint8_t CFeature::descriptorORBDistanceTo(const CFeature& oFeature) const
 	const std::vector<uint8_t>& o_desc = *oFeature.descriptors.ORB;
 
 	// Descriptors XOR + Hamming weight
-	uint8_t distance = 0;
-	for (uint8_t k = 0; k < t_desc.size(); ++k)
-	{
-		// from : Wegner, Peter (1960), "A technique for counting ones in a
-		// binary computer", Communications of the ACM 3 (5): 322,
-		// doi:10.1145/367236.367286
-		uint8_t x_or = t_desc[k] ^ o_desc[k];
-		uint8_t count;
-		for (count = 0; x_or; count++)	// ...
-			x_or &= x_or - 1;  // ...
-		distance += count;
-	}
-
-	return distance;
+	return static_cast<uint8_t>(
+		hamming_distance(t_desc.data(), o_desc.data(), t_desc.size()));
 }
 
 // # added by Raghavender Sahdev
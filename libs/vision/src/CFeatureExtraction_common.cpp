@@ -40,6 +40,13 @@ void CFeatureExtraction::detectFeatures(
 {
 	CTimeLoggerEntry tle(profiler, "detectFeatures");
 
+	if (options.tiling.enabled && options.featsType != featLSD)
+	{
+		internal_detectFeaturesTiled(
+			img, feats, init_ID, nDesiredFeatures, ROI);
+		return;
+	}
+
 	switch (options.featsType)
 	{
 		case featHarris:
@@ -90,6 +97,19 @@ void CFeatureExtraction::computeDescriptors(
 
 	int nDescComputed = 0;
 
+	// All but BLD descriptors, in parallel cells:
+	const auto tiledDescs =
+		static_cast<TDescriptorType>(in_descriptor_list & ~descBLD);
+	if (options.tiling.enabled && tiledDescs != 0 &&
+		inout_features.size() >=
+			options.tiling.minFeaturesForParallelDescriptors)
+	{
+		internal_computeDescriptorsTiled(in_img, inout_features, tiledDescs);
+		in_descriptor_list = static_cast<TDescriptorType>(
+			in_descriptor_list & descBLD);
+		++nDescComputed;
+	}
+
 	if ((in_descriptor_list & descSIFT) != 0)
 	{
 		this->internal_computeSiftDescriptors(in_img, inout_features);
@@ -210,6 +230,15 @@ void CFeatureExtraction::TOptions::dumpToTextStream(std::ostream& out) const
 	LOADABLEOPTS_DUMP_VAR(LATCHOptions.half_ssd_size, int)
 	LOADABLEOPTS_DUMP_VAR(LATCHOptions.rotationInvariance, bool)
 
+	LOADABLEOPTS_DUMP_VAR(tiling.enabled, bool)
+	LOADABLEOPTS_DUMP_VAR(tiling.tileSize, int)
+	LOADABLEOPTS_DUMP_VAR(tiling.overlap, int)
+	LOADABLEOPTS_DUMP_VAR(tiling.maxFeaturesPerTile, int)
+	LOADABLEOPTS_DUMP_VAR(tiling.boundaryNMSRadius, float)
+	LOADABLEOPTS_DUMP_VAR(tiling.descriptorMargin, int)
+	LOADABLEOPTS_DUMP_VAR(tiling.minFeaturesForParallelDescriptors, int)
+	LOADABLEOPTS_DUMP_VAR(tiling.numThreads, int)
+
 	out << "\n";
 }
 
@@ -298,4 +327,14 @@ void CFeatureExtraction::TOptions::loadFromConfigFile(
 	MRPT_LOAD_CONFIG_VAR(LATCHOptions.half_ssd_size, int, iniFile, section)
 	MRPT_LOAD_CONFIG_VAR(
 		LATCHOptions.rotationInvariance, bool, iniFile, section)
+
+	MRPT_LOAD_CONFIG_VAR(tiling.enabled, bool, iniFile, section)
+	MRPT_LOAD_CONFIG_VAR(tiling.tileSize, int, iniFile, section)
+	MRPT_LOAD_CONFIG_VAR(tiling.overlap, int, iniFile, section)
+	MRPT_LOAD_CONFIG_VAR(tiling.maxFeaturesPerTile, int, iniFile, section)
+	MRPT_LOAD_CONFIG_VAR(tiling.boundaryNMSRadius, float, iniFile, section)
+	MRPT_LOAD_CONFIG_VAR(tiling.descriptorMargin, int, iniFile, section)
+	MRPT_LOAD_CONFIG_VAR(
+		tiling.minFeaturesForParallelDescriptors, int, iniFile, section)
+	MRPT_LOAD_CONFIG_VAR(tiling.numThreads, int, iniFile, section)
 }
@@ -0,0 +1,318 @@
+/* +---------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)               |
+   |                          https://www.mrpt.org/                            |
+   |                                                                           |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file        |
+   | See: https://www.mrpt.org/Authors - All rights reserved.                  |
+   | Released under BSD License. See details in https://www.mrpt.org/License   |
+   +---------------------------------------------------------------------------+
+   */
+
+#include "vision-precomp.h"	 // Precompiled headers
+//
+#include <mrpt/core/WorkerThreadsPool.h>
+#include <mrpt/vision/CFeatureExtraction.h>
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <unordered_map>
+
+using namespace mrpt::img;
+using namespace mrpt::vision;
+
+namespace
+{
+// A rectangle of pixels [x0,x1)x[y0,y1)
+struct TRect
+{
+	unsigned int x0 = 0, y0 = 0, x1 = 0, y1 = 0;
+
+	bool contains(float x, float y) const
+	{
+		return x >= x0 && x < x1 && y >= y0 && y < y1;
+	}
+	TRect expanded(unsigned int margin, unsigned int W, unsigned int H) const
+	{
+		TRect r;
+		r.x0 = x0 > margin ? x0 - margin : 0;
+		r.y0 = y0 > margin ? y0 - margin : 0;
+		r.x1 = std::min(x1 + margin, W);
+		r.y1 = std::min(y1 + margin, H);
+		return r;
+	}
+};
+
+// Splits an area into square cells of (at most) `size` pixels
+struct TTileGrid
+{
+	TTileGrid(const TRect& area, unsigned int tileSize)
+		: a(area),
+		  size(tileSize),
+		  nx((area.x1 - area.x0 + tileSize - 1) / tileSize),
+		  ny((area.y1 - area.y0 + tileSize - 1) / tileSize)
+	{
+	}
+	TRect a;
+	unsigned int size, nx, ny;
+
+	size_t count() const { return static_cast<size_t>(nx) * ny; }
+
+	TRect cell(size_t i) const
+	{
+		const auto cx = static_cast<unsigned int>(i % nx);
+		const auto cy = static_cast<unsigned int>(i / nx);
+		TRect r;
+		r.x0 = a.x0 + cx * size;
+		r.y0 = a.y0 + cy * size;
+		r.x1 = std::min(r.x0 + size, a.x1);
+		r.y1 = std::min(r.y0 + size, a.y1);
+		return r;
+	}
+	size_t cellOf(float x, float y) const
+	{
+		const auto cx = std::clamp<int>(
+			static_cast<int>((x - a.x0) / size), 0, static_cast<int>(nx) - 1);
+		const auto cy = std::clamp<int>(
+			static_cast<int>((y - a.y0) / size), 0, static_cast<int>(ny) - 1);
+		return static_cast<size_t>(cy) * nx + cx;
+	}
+};
+
+bool strongerFeature(const CFeature& a, const CFeature& b)
+{
+	return a.response > b.response;
+}
+
+// Greedy non-maximum suppression of features closer than `radius` to a
+// stronger one from another cell. `feats` must be sorted by response.
+void boundaryNMS(
+	std::vector<CFeature>& feats, const std::vector<size_t>& cellIdx,
+	float radius)
+{
+	std::unordered_map<uint64_t, std::vector<size_t>> grid;
+	auto key = [](int gx, int gy) {
+		return (static_cast<uint64_t>(static_cast<uint32_t>(gx)) << 32) |
+			static_cast<uint32_t>(gy);
+	};
+	const float r2 = radius * radius;
+	std::vector<bool> keep(feats.size(), true);
+
+	for (size_t i = 0; i < feats.size(); i++)
+	{
+		const auto& pt = feats[i].keypoint.pt;
+		const int gx = static_cast<int>(std::floor(pt.x / radius));
+		const int gy = static_cast<int>(std::floor(pt.y / radius));
+		for (int dy = -1; dy <= 1 && keep[i]; dy++)
+			for (int dx = -1; dx <= 1 && keep[i]; dx++)
+			{
+				const auto it = grid.find(key(gx + dx, gy + dy));
+				if (it == grid.end()) continue;
+				for (const size_t j : it->second)
+				{
+					if (cellIdx[j] == cellIdx[i]) continue;
+					const auto& q = feats[j].keypoint.pt;
+					const float ex = q.x - pt.x, ey = q.y - pt.y;
+					if (ex * ex + ey * ey < r2)
+					{
+						keep[i] = false;
+						break;
+					}
+				}
+			}
+		if (keep[i]) grid[key(gx, gy)].push_back(i);
+	}
+
+	size_t n = 0;
+	for (size_t i = 0; i < feats.size(); i++)
+		if (keep[i]) feats[n++] = std::move(feats[i]);
+	feats.erase(feats.begin() + n, feats.end());
+}
+}  // namespace
+
+void CFeatureExtraction::internal_forEachTile(
+	size_t n, const std::function<void(size_t)>& fn)
+{
+	size_t nThreads = options.tiling.numThreads;
+	if (!nThreads) nThreads = std::max(1U, std::thread::hardware_concurrency());
+
+	if (nThreads <= 1 || n <= 1)
+	{
+		for (size_t i = 0; i < n; i++)
+			fn(i);
+		return;
+	}
+	// The calling thread also runs tiles:
+	if (!m_threadPool || m_threadPool->size() != nThreads - 1)
+		m_threadPool = std::make_shared<mrpt::WorkerThreadsPool>(
+			nThreads - 1, mrpt::WorkerThreadsPool::POLICY_FIFO,
+			"CFeatureExtraction");
+	m_threadPool->parallel_for(0, n, 1, fn);
+}
+
+void CFeatureExtraction::internal_detectFeaturesTiled(
+	const CImage& img, CFeatureList& feats, unsigned int init_ID,
+	unsigned int nDesiredFeatures, const TImageROI& ROI)
+{
+	MRPT_START
+
+	const auto& to = options.tiling;
+	ASSERT_GT_(to.tileSize, 0U);
+
+	// Make sure it is loaded before reading it from several threads:
+	img.forceLoad();
+	const unsigned int W = img.getWidth(), H = img.getHeight();
+
+	TRect area{0, 0, W, H};
+	if (ROI.xMin != 0 || ROI.xMax != 0 || ROI.yMin != 0 || ROI.yMax != 0)
+	{
+		ASSERT_(
+			ROI.xMin <= ROI.xMax && ROI.xMax < W && ROI.yMin <= ROI.yMax &&
+			ROI.yMax < H);
+		area = {
+			static_cast<unsigned int>(ROI.xMin),
+			static_cast<unsigned int>(ROI.yMin),
+			static_cast<unsigned int>(ROI.xMax + 1),
+			static_cast<unsigned int>(ROI.yMax + 1)};
+	}
+	const TTileGrid grid(area, to.tileSize);
+	const unsigned int margin = std::max(to.overlap, options.patchSize / 2 + 1);
+
+	size_t budget = to.maxFeaturesPerTile;
+	if (!budget && nDesiredFeatures)
+		budget = (nDesiredFeatures + grid.count() - 1) / grid.count();
+
+	// Detect in each cell, and keep the features of its central part:
+	std::vector<std::vector<CFeature>> cellFeats(grid.count());
+	internal_forEachTile(grid.count(), [&](size_t i) {
+		const TRect cell = grid.cell(i);
+		const TRect ext = cell.expanded(margin, W, H);
+
+		CImage tileImg;
+		img.extract_patch(
+			tileImg, ext.x0, ext.y0, ext.x1 - ext.x0, ext.y1 - ext.y0);
+
+		CFeatureExtraction fe;
+		fe.options = options;
+		fe.options.tiling.enabled = false;
+		fe.options.addNewFeatures = false;
+		CFeatureList lst;
+		fe.detectFeatures(tileImg, lst);
+
+		auto& out = cellFeats[i];
+		for (auto& f : lst)
+		{
+			f.keypoint.pt.x += ext.x0;
+			f.keypoint.pt.y += ext.y0;
+			if (cell.contains(f.keypoint.pt.x, f.keypoint.pt.y))
+				out.emplace_back(std::move(f));
+		}
+		if (budget && out.size() > budget)
+		{
+			std::partial_sort(
+				out.begin(), out.begin() + budget, out.end(), strongerFeature);
+			out.erase(out.begin() + budget, out.end());
+		}
+	});
+
+	// Merge, sorted by response:
+	std::vector<CFeature> merged;
+	std::vector<size_t> mergedCell;
+	for (size_t i = 0; i < cellFeats.size(); i++)
+		for (auto& f : cellFeats[i])
+			merged.emplace_back(std::move(f));
+	std::stable_sort(merged.begin(), merged.end(), strongerFeature);
+	mergedCell.reserve(merged.size());
+	for (const auto& f : merged)
+		mergedCell.push_back(grid.cellOf(f.keypoint.pt.x, f.keypoint.pt.y));
+
+	if (to.boundaryNMSRadius > 0)
+		boundaryNMS(merged, mergedCell, to.boundaryNMSRadius);
+
+	if (nDesiredFeatures && merged.size() > nDesiredFeatures)
+		merged.erase(merged.begin() + nDesiredFeatures, merged.end());
+
+	if (!options.addNewFeatures) feats.clear();
+	for (auto& f : merged)
+	{
+		f.keypoint.ID = init_ID++;
+		feats.emplace_back(std::move(f));
+	}
+
+	MRPT_END
+}
+
+void CFeatureExtraction::internal_computeDescriptorsTiled(
+	const CImage& in_img, CFeatureList& inout_features,
+	TDescriptorType in_descriptor_list)
+{
+	MRPT_START
+
+	const auto& to = options.tiling;
+	ASSERT_GT_(to.tileSize, 0U);
+
+	in_img.forceLoad();
+	const unsigned int W = in_img.getWidth(), H = in_img.getHeight();
+	const TTileGrid grid({0, 0, W, H}, to.tileSize);
+
+	// Pixels around each feature which may be needed by the descriptors:
+	unsigned int margin = std::max(to.descriptorMargin, to.overlap);
+	if (in_descriptor_list & descSpinImages)
+		margin = std::max(margin, options.SpinImagesOptions.radius + 1);
+	if (in_descriptor_list & descPolarImages)
+		margin = std::max(margin, options.PolarImagesOptions.radius + 1);
+	if (in_descriptor_list & descLogPolarImages)
+		margin = std::max(margin, options.LogPolarImagesOptions.radius + 1);
+
+	// Indices of the features in each cell:
+	std::vector<std::vector<size_t>> cellIdxs(grid.count());
+	for (size_t k = 0; k < inout_features.size(); k++)
+	{
+		const auto& pt = inout_features[k].keypoint.pt;
+		cellIdxs[grid.cellOf(pt.x, pt.y)].push_back(k);
+	}
+
+	internal_forEachTile(grid.count(), [&](size_t i) {
+		const auto& idxs = cellIdxs[i];
+		if (idxs.empty()) return;
+		const TRect ext = grid.cell(i).expanded(margin, W, H);
+
+		CImage tileImg;
+		in_img.extract_patch(
+			tileImg, ext.x0, ext.y0, ext.x1 - ext.x0, ext.y1 - ext.y0);
+
+		// Features are moved into the cell list, and back when done:
+		CFeatureList lst;
+		for (const size_t k : idxs)
+		{
+			CFeature& f = inout_features[k];
+			f.keypoint.pt.x -= ext.x0;
+			f.keypoint.pt.y -= ext.y0;
+			lst.emplace_back(std::move(f));
+		}
+
+		CFeatureExtraction fe;
+		fe.options = options;
+		fe.options.tiling.enabled = false;
+		std::exception_ptr error;
+		try
+		{
+			fe.computeDescriptors(tileImg, lst, in_descriptor_list);
+		}
+		catch (...)
+		{
+			error = std::current_exception();
+		}
+
+		for (size_t j = 0; j < idxs.size(); j++)
+		{
+			CFeature& f = inout_features[idxs[j]];
+			f = std::move(lst[j]);
+			f.keypoint.pt.x += ext.x0;
+			f.keypoint.pt.y += ext.y0;
+		}
+		if (error) std::rethrow_exception(error);
+	});
+
+	MRPT_END
+}
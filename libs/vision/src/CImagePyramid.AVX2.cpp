@@ -0,0 +1,103 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "vision-precomp.h"	 // Precompiled headers
+//
+#include <mrpt/config.h>
+
+#include "CImagePyramid_kernels.h"
+
+// ---------------------------------------------------------------------------
+//   This file contains the AVX2 version of the Gaussian half-scaling kernels
+//   of CImagePyramid. It is built with "-mavx2" (see DeclareMRPTLib.cmake),
+//   and only called if the CPU supports AVX2.
+//   All sums fit in 16 bits: at most 16*16*255+128 = 65408.
+// ---------------------------------------------------------------------------
+#if MRPT_ARCH_INTEL_COMPATIBLE
+#include <immintrin.h>
+
+namespace
+{
+template <typename T>
+inline __m256i load(const T* p)
+{
+	return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+}
+
+// a + 4 (b + d) + 6 c + e
+inline __m256i weighted_sum(
+	__m256i a, __m256i b, __m256i c, __m256i d, __m256i e)
+{
+	const __m256i bd = _mm256_slli_epi16(_mm256_add_epi16(b, d), 2);
+	const __m256i c6 = _mm256_add_epi16(
+		_mm256_slli_epi16(c, 2), _mm256_slli_epi16(c, 1));
+	return _mm256_add_epi16(_mm256_add_epi16(a, e), _mm256_add_epi16(bd, c6));
+}
+
+// 16 output pixels, in 16-bit lanes:
+inline __m256i horz16(const uint16_t* E, const uint16_t* O, __m256i half)
+{
+	const __m256i s = weighted_sum(
+		load(E - 1), load(O - 1), load(E), load(O), load(E + 1));
+	return _mm256_srli_epi16(_mm256_add_epi16(s, half), 8);
+}
+}  // namespace
+#endif
+
+void mrpt::vision::detail::pyr_gauss_vert_AVX2(
+	const uint8_t* const rows[5], size_t n, uint16_t* E, uint16_t* O)
+{
+	size_t k = 0;
+#if MRPT_ARCH_INTEL_COMPATIBLE
+	const __m256i lowBytes = _mm256_set1_epi16(0x00ff);
+
+	// 32 input pixels at a time, split into even and odd ones:
+	for (; k + 16 <= n; k += 16)
+	{
+		__m256i e[5], o[5];
+		for (int r = 0; r < 5; r++)
+		{
+			const __m256i v = load(rows[r] + 2 * k);
+			e[r] = _mm256_and_si256(v, lowBytes);
+			o[r] = _mm256_srli_epi16(v, 8);
+		}
+		_mm256_storeu_si256(
+			reinterpret_cast<__m256i*>(E + k),
+			weighted_sum(e[0], e[1], e[2], e[3], e[4]));
+		_mm256_storeu_si256(
+			reinterpret_cast<__m256i*>(O + k),
+			weighted_sum(o[0], o[1], o[2], o[3], o[4]));
+	}
+#endif
+	for (; k < n; k++)
+	{
+		E[k] = pyr_gauss_col(rows, 2 * k);
+		O[k] = pyr_gauss_col(rows, 2 * k + 1);
+	}
+}
+
+void mrpt::vision::detail::pyr_gauss_horz_AVX2(
+	const uint16_t* E, const uint16_t* O, size_t n, uint8_t* out)
+{
+	size_t x = 0;
+#if MRPT_ARCH_INTEL_COMPATIBLE
+	const __m256i half = _mm256_set1_epi16(128);
+
+	for (; x + 32 <= n; x += 32)
+	{
+		const __m256i a = horz16(E + x, O + x, half);
+		const __m256i b = horz16(E + x + 16, O + x + 16, half);
+		// packus works within 128-bit lanes: reorder its 64-bit words.
+		_mm256_storeu_si256(
+			reinterpret_cast<__m256i*>(out + x),
+			_mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xD8));
+	}
+#endif
+	if (x < n) pyr_gauss_horz_portable(E + x, O + x, n - x, out + x);
+}
@@ -0,0 +1,100 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "vision-precomp.h"	 // Precompiled headers
+//
+#include <mrpt/config.h>
+
+#include "CImagePyramid_kernels.h"
+
+// ---------------------------------------------------------------------------
+//   This file contains the ARM NEON version of the Gaussian half-scaling
+//   kernels of CImagePyramid. NEON is always available in aarch64, so this
+//   file needs no special build flags.
+// ---------------------------------------------------------------------------
+#if defined(__ARM_NEON) || defined(__aarch64__)
+#define MRPT_VISION_BUILD_NEON 1
+#include <arm_neon.h>
+
+namespace
+{
+// a + 4 (b + d) + 6 c + e, widened to 16 bits:
+inline uint16x8_t weighted_sum(
+	uint8x8_t a, uint8x8_t b, uint8x8_t c, uint8x8_t d, uint8x8_t e)
+{
+	uint16x8_t s = vaddl_u8(a, e);
+	s = vmlal_u8(s, c, vdup_n_u8(6));
+	return vaddq_u16(s, vshlq_n_u16(vaddl_u8(b, d), 2));
+}
+
+// 8 output pixels:
+inline uint8x8_t horz8(const uint16_t* E, const uint16_t* O)
+{
+	const uint16x8_t em = vld1q_u16(E - 1), e0 = vld1q_u16(E),
+					 ep = vld1q_u16(E + 1);
+	const uint16x8_t o = vaddq_u16(vld1q_u16(O - 1), vld1q_u16(O));
+	uint16x8_t s = vaddq_u16(em, ep);
+	s = vmlaq_n_u16(s, e0, 6);
+	s = vaddq_u16(s, vshlq_n_u16(o, 2));
+	// (s + 128) >> 8:
+	return vrshrn_n_u16(s, 8);
+}
+}  // namespace
+#else
+#define MRPT_VISION_BUILD_NEON 0
+#endif
+
+void mrpt::vision::detail::pyr_gauss_vert_NEON(
+	const uint8_t* const rows[5], size_t n, uint16_t* E, uint16_t* O)
+{
+	size_t k = 0;
+#if MRPT_VISION_BUILD_NEON
+	// 32 input pixels at a time, deinterleaved into even and odd ones:
+	for (; k + 16 <= n; k += 16)
+	{
+		uint8x16x2_t v[5];
+		for (int r = 0; r < 5; r++)
+			v[r] = vld2q_u8(rows[r] + 2 * k);
+		for (int i = 0; i < 2; i++)
+		{
+			uint16_t* dst = i == 0 ? E : O;
+			vst1q_u16(
+				dst + k,
+				weighted_sum(
+					vget_low_u8(v[0].val[i]), vget_low_u8(v[1].val[i]),
+					vget_low_u8(v[2].val[i]), vget_low_u8(v[3].val[i]),
+					vget_low_u8(v[4].val[i])));
+			vst1q_u16(
+				dst + k + 8,
+				weighted_sum(
+					vget_high_u8(v[0].val[i]), vget_high_u8(v[1].val[i]),
+					vget_high_u8(v[2].val[i]), vget_high_u8(v[3].val[i]),
+					vget_high_u8(v[4].val[i])));
+		}
+	}
+#endif
+	for (; k < n; k++)
+	{
+		E[k] = pyr_gauss_col(rows, 2 * k);
+		O[k] = pyr_gauss_col(rows, 2 * k + 1);
+	}
+}
+
+void mrpt::vision::detail::pyr_gauss_horz_NEON(
+	const uint16_t* E, const uint16_t* O, size_t n, uint8_t* out)
+{
+	size_t x = 0;
+#if MRPT_VISION_BUILD_NEON
+	for (; x + 16 <= n; x += 16)
+		vst1q_u8(
+			out + x,
+			vcombine_u8(horz8(E + x, O + x), horz8(E + x + 8, O + x + 8)));
+#endif
+	if (x < n) pyr_gauss_horz_portable(E + x, O + x, n - x, out + x);
+}
@@ -9,29 +9,244 @@
 
 #include "vision-precomp.h"	 // Precompiled headers
 //
+#include <mrpt/core/cpu.h>
 #include <mrpt/vision/CImagePyramid.h>
 
+#include <algorithm>
+#include <vector>
+
+#include "CImagePyramid_kernels.h"
+
+// Universal include for all versions of OpenCV
+#include <mrpt/3rdparty/do_opencv_includes.h>
+
 using namespace mrpt;
 using namespace mrpt::vision;
 using namespace mrpt::img;
 
+#if MRPT_HAS_OPENCV
+namespace
+{
+// Index of the pixel `p` in [0,n), with cv::BORDER_REFLECT_101:
+int reflect101(int p, int n)
+{
+	if (n == 1) return 0;
+	while (p < 0 || p >= n)
+		p = p < 0 ? -p : 2 * n - 2 - p;
+	return p;
+}
+
+struct TGaussKernels
+{
+	detail::pyr_gauss_vert_t vert = &detail::pyr_gauss_vert_portable;
+	detail::pyr_gauss_horz_t horz = &detail::pyr_gauss_horz_portable;
+	bool simd = false;
+};
+
+TGaussKernels selectGaussKernels(bool useSIMD)
+{
+	using mrpt::cpu::feature;
+	TGaussKernels k;
+	if (useSIMD && mrpt::cpu::supports(feature::AVX2))
+	{
+		k.vert = &detail::pyr_gauss_vert_AVX2;
+		k.horz = &detail::pyr_gauss_horz_AVX2;
+		k.simd = true;
+	}
+	else if (useSIMD && mrpt::cpu::supports(feature::NEON))
+	{
+		k.vert = &detail::pyr_gauss_vert_NEON;
+		k.horz = &detail::pyr_gauss_horz_NEON;
+		k.simd = true;
+	}
+	return k;
+}
+
+// Rows [y0,y1) of the Gaussian half-scaling of a grayscale image.
+void gaussianHalfRows(
+	const cv::Mat& in, cv::Mat& out, int y0, int y1, const TGaussKernels& k,
+	std::vector<uint16_t>& buf)
+{
+	const int w = in.cols, h = in.rows, ow = out.cols;
+	if (ow == 0) return;
+
+	// Weighted column sums of even (E[-1..ow]) and odd (O[-1..ow-1]) pixels:
+	buf.resize(2 * (ow + 2));
+	uint16_t* E = buf.data() + 1;
+	uint16_t* O = E + ow + 2;
+
+	const uint8_t* rows[5];
+	for (int y = y0; y < y1; y++)
+	{
+		for (int d = 0; d < 5; d++)
+			rows[d] = in.ptr<uint8_t>(reflect101(2 * y + d - 2, h));
+
+		if (w >= 4)
+		{
+			k.vert(rows, ow, E, O);
+			E[-1] = E[1];
+			O[-1] = O[0];
+			E[ow] = (w & 1) ? detail::pyr_gauss_col(rows, w - 1) : E[ow - 1];
+		}
+		else
+		{
+			for (int c = -1; c <= ow; c++)
+			{
+				E[c] = detail::pyr_gauss_col(rows, reflect101(2 * c, w));
+				if (c == ow) break;
+				O[c] = detail::pyr_gauss_col(rows, reflect101(2 * c + 1, w));
+			}
+		}
+		k.horz(E, O, ow, out.ptr<uint8_t>(y));
+	}
+}
+
+// Rows [y0,y1) of `out`, the half-scaled version of `in`. Returns true if
+// a SIMD implementation was used.
+bool halfScaleRows(
+	const CImage& in, CImage& out, int y0, int y1, PyramidFilter filter,
+	const TGaussKernels& k, std::vector<uint16_t>& buf)
+{
+	const cv::Mat& src = in.asCvMatRef();
+	cv::Mat dst = out.asCvMatRef();
+	if (filter == PyramidFilter::Gaussian5)
+	{
+		if (src.channels() == 1)
+		{
+			gaussianHalfRows(src, dst, y0, y1, k, buf);
+			return k.simd;
+		}
+		ASSERT_(y0 == 0 && y1 == dst.rows);
+		cv::pyrDown(src, dst, dst.size(), cv::BORDER_REFLECT_101);
+		return false;
+	}
+	// CImage::scaleHalf() over views of the rows, writing into `out`:
+	const CImage inRows(src.rowRange(2 * y0, 2 * y1), SHALLOW_COPY);
+	CImage outRows(dst.rowRange(y0, y1), SHALLOW_COPY);
+	return inRows.scaleHalf(
+		outRows,
+		filter == PyramidFilter::Mean2x2 ? IMG_INTERP_LINEAR : IMG_INTERP_NN);
+}
+
+// Whether `lvl` can be overwritten as a w x h image with `pad` extra pixels:
+bool isReusable(const CImage& lvl, int w, int h, int cvType, int pad)
+{
+	if (lvl.isExternallyStored() || lvl.isEmpty()) return false;
+	const cv::Mat& m = lvl.asCvMatRef();
+	// Not shared with any other image:
+	if (m.cols != w || m.rows != h || m.type() != cvType || !m.u ||
+		m.u->refcount != 1)
+		return false;
+	cv::Size whole;
+	cv::Point ofs;
+	m.locateROI(whole, ofs);
+	return ofs.x == pad && ofs.y == pad && whole.width == w + 2 * pad &&
+		whole.height == h + 2 * pad;
+}
+
+// Makes `lvl` a w x h image, reusing its former buffer if possible.
+void prepareLevel(
+	CImage& lvl, int w, int h, TImageChannels ch, unsigned int padding)
+{
+	const int pad = (w > 0 && h > 0) ? static_cast<int>(padding) : 0;
+	if (isReusable(lvl, w, h, CV_8UC(ch), pad)) return;
+
+	CImage buf(w + 2 * pad, h + 2 * pad, ch);
+	if (!pad) lvl = std::move(buf);
+	else
+		lvl = CImage(buf.asCvMatRef()(cv::Rect(pad, pad, w, h)), SHALLOW_COPY);
+}
+
+// Fills the extra pixels around a level, as cv::buildOpticalFlowPyramid():
+void fillBorder(CImage& lvl, unsigned int padding)
+{
+	cv::Mat m = lvl.asCvMatRef();
+	if (!padding || m.empty()) return;
+	const int pad = static_cast<int>(padding);
+	cv::Mat whole = m;
+	whole.adjustROI(pad, pad, pad, pad);
+	cv::copyMakeBorder(
+		m, whole, pad, pad, pad, pad,
+		cv::BORDER_REFLECT_101 | cv::BORDER_ISOLATED);
+}
+
+// Converts `color` to grayscale into `gray`, building `half` from each band
+// of rows while they are still in the CPU cache.
+bool grayscaleAndHalf(
+	const CImage& color, CImage& gray, CImage& half, PyramidFilter filter,
+	const TGaussKernels& k, std::vector<uint16_t>& buf)
+{
+	const cv::Mat& src = color.asCvMatRef();
+	cv::Mat dst = gray.asCvMatRef();
+	const int h = src.rows, oh = half.asCvMatRef().rows;
+
+	// Bands of ~128 KiB of input pixels:
+	const int bandRows = std::max<int>(4, (128 * 1024) / (2 * src.step[0]));
+	// The Gaussian filter also needs the next row:
+	const int extraRow = filter == PyramidFilter::Gaussian5 ? 1 : 0;
+
+	bool simd = true;
+	int nGray = 0;	// Rows already converted
+	auto convertUpTo = [&](int row) {
+		if (row <= nGray) return;
+		const CImage srcRows(src.rowRange(nGray, row), SHALLOW_COPY);
+		CImage dstRows(dst.rowRange(nGray, row), SHALLOW_COPY);
+		srcRows.grayscale(dstRows);
+		nGray = row;
+	};
+	for (int y0 = 0; y0 < oh; y0 += bandRows)
+	{
+		const int y1 = std::min(oh, y0 + bandRows);
+		convertUpTo(std::min(h, 2 * y1 + extraRow));
+		simd = halfScaleRows(gray, half, y0, y1, filter, k, buf) && simd;
+	}
+	convertUpTo(h);
+	return simd;
+}
+}  // namespace
+#endif
+
 // Template that generalizes the two user entry-points below:
 template <bool FASTLOAD>
 bool buildPyramid_templ(
 	CImagePyramid& obj, mrpt::img::CImage& img, const size_t nOctaves,
-	const bool smooth_halves, const bool convert_grayscale)
+	const PyramidFilter filter, const bool convert_grayscale)
 {
 	ASSERT_GT_(nOctaves, 0);
-
-	// TImageSize  img_size = img.getSize();
+#if MRPT_HAS_OPENCV
 	obj.images.resize(nOctaves);
 
-	// First octave: Just copy the image:
-	if (convert_grayscale && img.isColor())
+	const unsigned int pad = obj.borderPadding;
+	const bool toGray = convert_grayscale && img.isColor();
+	const TImageChannels ch = toGray ? CH_GRAY : img.getChannelCount();
+	const int w = static_cast<int>(img.getWidth());
+	const int h = static_cast<int>(img.getHeight());
+
+	const TGaussKernels k = selectGaussKernels(obj.useSIMD);
+	std::vector<uint16_t> buf;
+	bool all_used_simd = true;
+	size_t firstHalved = 1;
+
+	// First octave:
+	if (toGray)
+	{
+		prepareLevel(obj.images[0], w, h, CH_GRAY, pad);
+		if (obj.fusedGrayscale && nOctaves > 1)
+		{
+			prepareLevel(obj.images[1], w / 2, h / 2, CH_GRAY, pad);
+			all_used_simd = grayscaleAndHalf(
+				img, obj.images[0], obj.images[1], filter, k, buf);
+			fillBorder(obj.images[1], pad);
+			firstHalved = 2;
+		}
+		else
+			img.grayscale(obj.images[0]);  // Into the prepared buffer
+	}
+	else if (pad)
 	{
-		// In this case we have to convert to grayscale, so FASTLOAD doesn't
-		// really matter:
-		img.grayscale(obj.images[0]);
+		prepareLevel(obj.images[0], w, h, ch, pad);
+		cv::Mat dst = obj.images[0].asCvMatRef();
+		img.asCvMatRef().copyTo(dst);
 	}
 	else
 	{
@@ -41,31 +256,59 @@ bool buildPyramid_templ(
 		else
 			obj.images[0] = img;  // Normal copy
 	}
+	fillBorder(obj.images[0], pad);
 
 	// Rest of octaves, if any:
-	bool all_used_sse2 = true;
-	for (size_t o = 1; o < nOctaves; o++)
+	for (size_t o = firstHalved; o < nOctaves; o++)
 	{
-		bool ret = obj.images[o - 1].scaleHalf(
-			obj.images[o], smooth_halves ? IMG_INTERP_LINEAR : IMG_INTERP_NN);
-		all_used_sse2 = all_used_sse2 && ret;
+		const CImage& prev = obj.images[o - 1];
+		const int ow = static_cast<int>(prev.getWidth() / 2);
+		const int oh = static_cast<int>(prev.getHeight() / 2);
+		prepareLevel(obj.images[o], ow, oh, ch, pad);
+		const bool ret =
+			halfScaleRows(prev, obj.images[o], 0, oh, filter, k, buf);
+		fillBorder(obj.images[o], pad);
+		all_used_simd = all_used_simd && ret;
 	}
-	return all_used_sse2;
+	return all_used_simd;
+#else
+	THROW_EXCEPTION("MRPT has been compiled with MRPT_HAS_OPENCV=0 !");
+#endif
 }
 
 bool CImagePyramid::buildPyramid(
 	const mrpt::img::CImage& img, const size_t nOctaves,
 	const bool smooth_halves, const bool convert_grayscale)
+{
+	return buildPyramid(
+		img, nOctaves,
+		smooth_halves ? PyramidFilter::Mean2x2 : PyramidFilter::Decimate,
+		convert_grayscale);
+}
+
+bool CImagePyramid::buildPyramid(
+	const mrpt::img::CImage& img, const size_t nOctaves,
+	const PyramidFilter filter, const bool convert_grayscale)
 {
 	return buildPyramid_templ<false>(
-		*this, *const_cast<mrpt::img::CImage*>(&img), nOctaves, smooth_halves,
+		*this, *const_cast<mrpt::img::CImage*>(&img), nOctaves, filter,
 		convert_grayscale);
 }
 
 bool CImagePyramid::buildPyramidFast(
 	mrpt::img::CImage& img, const size_t nOctaves, const bool smooth_halves,
 	const bool convert_grayscale)
+{
+	return buildPyramidFast(
+		img, nOctaves,
+		smooth_halves ? PyramidFilter::Mean2x2 : PyramidFilter::Decimate,
+		convert_grayscale);
+}
+
+bool CImagePyramid::buildPyramidFast(
+	mrpt::img::CImage& img, const size_t nOctaves, const PyramidFilter filter,
+	const bool convert_grayscale)
 {
 	return buildPyramid_templ<true>(
-		*this, img, nOctaves, smooth_halves, convert_grayscale);
+		*this, img, nOctaves, filter, convert_grayscale);
 }
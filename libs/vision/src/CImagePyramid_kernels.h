@@ -0,0 +1,71 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mrpt::vision::detail
+{
+/** Vertical pass of the 5x5 Gaussian half-scaling ([1 4 6 4 1]/16 in each
+ * direction): for the pixels 0 to 2*n-1 of the five input `rows`, stores
+ * the weighted column sums of the even pixels into `E[0..n-1]` and of the
+ * odd pixels into `O[0..n-1]`. */
+using pyr_gauss_vert_t = void (*)(
+	const uint8_t* const rows[5], size_t n, uint16_t* E, uint16_t* O);
+
+/** Horizontal pass of the 5x5 Gaussian half-scaling: output pixel `x` (in
+ * [0,n)) is `(E[x-1] + 4 O[x-1] + 6 E[x] + 4 O[x] + E[x+1] + 128) >> 8`, so
+ * `E[-1]`, `O[-1]` and `E[n]` must be valid. */
+using pyr_gauss_horz_t = void (*)(
+	const uint16_t* E, const uint16_t* O, size_t n, uint8_t* out);
+
+inline uint16_t pyr_gauss_col(const uint8_t* const rows[5], size_t c)
+{
+	return static_cast<uint16_t>(
+		rows[0][c] + rows[4][c] + 4 * (rows[1][c] + rows[3][c]) +
+		6 * rows[2][c]);
+}
+
+inline void pyr_gauss_vert_portable(
+	const uint8_t* const rows[5], size_t n, uint16_t* E, uint16_t* O)
+{
+	for (size_t k = 0; k < n; k++)
+	{
+		E[k] = pyr_gauss_col(rows, 2 * k);
+		O[k] = pyr_gauss_col(rows, 2 * k + 1);
+	}
+}
+
+inline void pyr_gauss_horz_portable(
+	const uint16_t* E, const uint16_t* O, size_t n, uint8_t* out)
+{
+	for (size_t x = 0; x < n; x++)
+	{
+		const unsigned int s = E[x - 1] + E[x + 1] + 4 * (O[x - 1] + O[x]) +
+			6 * E[x] + 128;
+		out[x] = static_cast<uint8_t>(s >> 8);
+	}
+}
+
+/** Only call it if mrpt::cpu::supports(mrpt::cpu::feature::AVX2) */
+void pyr_gauss_vert_AVX2(
+	const uint8_t* const rows[5], size_t n, uint16_t* E, uint16_t* O);
+/** Only call it if mrpt::cpu::supports(mrpt::cpu::feature::AVX2) */
+void pyr_gauss_horz_AVX2(
+	const uint16_t* E, const uint16_t* O, size_t n, uint8_t* out);
+
+/** Only call it if mrpt::cpu::supports(mrpt::cpu::feature::NEON) */
+void pyr_gauss_vert_NEON(
+	const uint8_t* const rows[5], size_t n, uint16_t* E, uint16_t* O);
+/** Only call it if mrpt::cpu::supports(mrpt::cpu::feature::NEON) */
+void pyr_gauss_horz_NEON(
+	const uint16_t* E, const uint16_t* O, size_t n, uint8_t* out);
+
+}  // namespace mrpt::vision::detail
@@ -0,0 +1,173 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/config.h>
+#include <mrpt/vision/CImagePyramid.h>
+
+// Universal include for all versions of OpenCV
+#include <mrpt/3rdparty/do_opencv_includes.h>
+
+#include <cstring>
+#include <random>
+
+using mrpt::img::CImage;
+using mrpt::vision::CImagePyramid;
+using mrpt::vision::PyramidFilter;
+
+#if MRPT_HAS_OPENCV
+namespace
+{
+CImage randomImage(
+	unsigned int w, unsigned int h, mrpt::img::TImageChannels ch,
+	unsigned int seed)
+{
+	std::mt19937 rng(seed);
+	std::uniform_int_distribution<int> pix(0, 255);
+	CImage img(w, h, ch);
+	for (unsigned int y = 0; y < h; y++)
+	{
+		auto* row = img.ptrLine<uint8_t>(y);
+		for (unsigned int x = 0; x < w * ch; x++)
+			row[x] = static_cast<uint8_t>(pix(rng));
+	}
+	return img;
+}
+
+int reflect101(int p, int n)
+{
+	if (n == 1) return 0;
+	while (p < 0 || p >= n)
+		p = p < 0 ? -p : 2 * n - 2 - p;
+	return p;
+}
+
+// Straightforward 5x5 Gaussian half-scaling:
+uint8_t gaussianHalfAt(const CImage& img, int x, int y)
+{
+	const int k[5] = {1, 4, 6, 4, 1};
+	const int w = img.getWidth(), h = img.getHeight();
+	int s = 0;
+	for (int i = 0; i < 5; i++)
+		for (int j = 0; j < 5; j++)
+			s += k[i] * k[j] *
+				img.at<uint8_t>(
+					reflect101(2 * x + j - 2, w),
+					reflect101(2 * y + i - 2, h));
+	return static_cast<uint8_t>((s + 128) >> 8);
+}
+
+bool sameImages(const CImage& a, const CImage& b)
+{
+	if (a.getWidth() != b.getWidth() || a.getHeight() != b.getHeight() ||
+		a.getChannelCount() != b.getChannelCount())
+		return false;
+	const size_t rowBytes = a.getWidth() * a.getChannelCount();
+	for (unsigned int y = 0; y < a.getHeight(); y++)
+		if (std::memcmp(
+				a.ptrLine<uint8_t>(y), b.ptrLine<uint8_t>(y), rowBytes) != 0)
+			return false;
+	return true;
+}
+}  // namespace
+
+TEST(CImagePyramid, gaussian)
+{
+	for (const auto& sz :
+		 {std::make_pair(3U, 5U), std::make_pair(64U, 32U),
+		  std::make_pair(101U, 47U), std::make_pair(320U, 241U)})
+	{
+		const CImage img =
+			randomImage(sz.first, sz.second, mrpt::img::CH_GRAY, 1);
+		for (const bool simd : {false, true})
+		{
+			CImagePyramid pyr;
+			pyr.useSIMD = simd;
+			pyr.buildPyramid(img, 3, PyramidFilter::Gaussian5);
+			ASSERT_EQ(pyr.images.size(), 3U);
+			for (size_t o = 1; o < 3; o++)
+			{
+				const CImage& prev = pyr.images[o - 1];
+				const CImage& lvl = pyr.images[o];
+				ASSERT_EQ(lvl.getWidth(), prev.getWidth() / 2);
+				ASSERT_EQ(lvl.getHeight(), prev.getHeight() / 2);
+				for (unsigned int y = 0; y < lvl.getHeight(); y++)
+					for (unsigned int x = 0; x < lvl.getWidth(); x++)
+						ASSERT_EQ(
+							lvl.at<uint8_t>(x, y), gaussianHalfAt(prev, x, y))
+							<< "size=" << sz.first << "x" << sz.second
+							<< " simd=" << simd << " octave=" << o;
+			}
+		}
+	}
+}
+
+TEST(CImagePyramid, fusedGrayscaleAndPadding)
+{
+	const CImage img = randomImage(333, 250, mrpt::img::CH_RGB, 2);
+
+	for (const auto filter : {PyramidFilter::Decimate, PyramidFilter::Mean2x2,
+							  PyramidFilter::Gaussian5})
+	{
+		CImagePyramid ref, fused;
+		ref.fusedGrayscale = false;
+		ref.buildPyramid(img, 4, filter, true);
+		fused.borderPadding = 8;
+		fused.buildPyramid(img, 4, filter, true);
+
+		ASSERT_EQ(fused.images.size(), 4U);
+		for (size_t o = 0; o < 4; o++)
+		{
+			EXPECT_FALSE(fused.images[o].isColor());
+			EXPECT_TRUE(sameImages(ref.images[o], fused.images[o]))
+				<< "octave=" << o;
+
+			// Border pixels, as cv::BORDER_REFLECT_101:
+			const cv::Mat& m = fused.images[o].asCvMatRef();
+			cv::Size whole;
+			cv::Point ofs;
+			m.locateROI(whole, ofs);
+			EXPECT_EQ(ofs.x, 8);
+			EXPECT_EQ(ofs.y, 8);
+			const auto px = [&m](int x, int y) {
+				return m.ptr<uint8_t>(0)[y * static_cast<int>(m.step[0]) + x];
+			};
+			EXPECT_EQ(px(-2, -1), px(2, 1));
+			EXPECT_EQ(px(m.cols + 1, m.rows), px(m.cols - 3, m.rows - 2));
+		}
+	}
+}
+
+TEST(CImagePyramid, reuseLevelBuffers)
+{
+	CImage img = randomImage(200, 100, mrpt::img::CH_RGB, 3);
+
+	CImagePyramid pyr;
+	pyr.buildPyramid(img, 3, PyramidFilter::Gaussian5, true);
+	std::vector<const uint8_t*> bufs;
+	for (const auto& lvl : pyr.images)
+		bufs.push_back(lvl.ptrLine<uint8_t>(0));
+
+	// A level kept by the user must not be overwritten:
+	const CImage kept = pyr.images[1].makeDeepCopy();
+	const CImage shared = pyr.images[1];
+
+	img = randomImage(200, 100, mrpt::img::CH_RGB, 4);
+	pyr.buildPyramid(img, 3, PyramidFilter::Gaussian5, true);
+	EXPECT_EQ(pyr.images[0].ptrLine<uint8_t>(0), bufs[0]);
+	EXPECT_NE(pyr.images[1].ptrLine<uint8_t>(0), bufs[1]);
+	EXPECT_EQ(pyr.images[2].ptrLine<uint8_t>(0), bufs[2]);
+	EXPECT_TRUE(sameImages(kept, shared));
+
+	CImagePyramid ref;
+	ref.buildPyramid(img, 3, PyramidFilter::Gaussian5, true);
+	for (size_t o = 0; o < 3; o++)
+		EXPECT_TRUE(sameImages(ref.images[o], pyr.images[o]));
+}
+#endif
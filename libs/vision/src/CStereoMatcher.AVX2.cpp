@@ -0,0 +1,114 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "vision-precomp.h"	 // Precompiled headers
+//
+#include <mrpt/config.h>
+
+#include "CStereoMatcher_kernels.h"
+
+// ---------------------------------------------------------------------------
+//   This file contains the AVX2 versions of the census cost and SGM kernels.
+//   It is built with "-mavx2" (see DeclareMRPTLib.cmake), and only called if
+//   the CPU supports AVX2.
+//   Bits are counted with 4-bit lookup tables (vpshufb), as in
+//   CBinaryDescriptorMatcher.AVX2.cpp. SGM costs are kept in 16 bits, with
+//   saturated additions for the 0xffff padding at both ends of the paths.
+// ---------------------------------------------------------------------------
+#if MRPT_ARCH_INTEL_COMPATIBLE
+#include <immintrin.h>
+
+namespace
+{
+template <typename T>
+inline __m256i load(const T* p)
+{
+	return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+}
+
+// Number of bits set in each uint32:
+inline __m256i popcount_epi32(__m256i x, __m256i lut, __m256i lowMask)
+{
+	const __m256i lo = _mm256_and_si256(x, lowMask);
+	const __m256i hi = _mm256_and_si256(_mm256_srli_epi16(x, 4), lowMask);
+	const __m256i cnt8 = _mm256_add_epi8(
+		_mm256_shuffle_epi8(lut, lo), _mm256_shuffle_epi8(lut, hi));
+	const __m256i cnt16 =
+		_mm256_maddubs_epi16(cnt8, _mm256_set1_epi8(1));
+	return _mm256_madd_epi16(cnt16, _mm256_set1_epi16(1));
+}
+}  // namespace
+#endif
+
+void mrpt::vision::detail::census_costs_AVX2(
+	uint32_t left, const uint32_t* right, size_t n, uint8_t* costs)
+{
+	size_t k = 0;
+#if MRPT_ARCH_INTEL_COMPATIBLE
+	const __m256i lut = _mm256_setr_epi8(
+		0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,	 //
+		0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+	const __m256i lowMask = _mm256_set1_epi8(0x0f);
+	const __m256i l = _mm256_set1_epi32(static_cast<int>(left));
+
+	// 16 costs at a time:
+	for (; k + 16 <= n; k += 16)
+	{
+		const __m256i a = popcount_epi32(
+			_mm256_xor_si256(l, load(right + k)), lut, lowMask);
+		const __m256i b = popcount_epi32(
+			_mm256_xor_si256(l, load(right + k + 8)), lut, lowMask);
+		// [a0-3 b0-3 a4-7 b4-7] -> [a0-7 b0-7]:
+		const __m256i ab = _mm256_permute4x64_epi64(
+			_mm256_packus_epi32(a, b), _MM_SHUFFLE(3, 1, 2, 0));
+		_mm_storeu_si128(
+			reinterpret_cast<__m128i*>(costs + k),
+			_mm_packus_epi16(
+				_mm256_castsi256_si128(ab),
+				_mm256_extracti128_si256(ab, 1)));
+	}
+#endif
+	for (; k < n; k++)
+		costs[k] = static_cast<uint8_t>(popcount32_portable(left ^ right[k]));
+}
+
+uint16_t mrpt::vision::detail::sgm_path_step_AVX2(
+	const uint8_t* C, const uint16_t* prev, uint16_t prevMin, size_t D,
+	uint16_t P1, uint16_t P2, uint16_t* cur, uint16_t* S)
+{
+#if MRPT_ARCH_INTEL_COMPATIBLE
+	const __m256i p1 = _mm256_set1_epi16(static_cast<short>(P1));
+	const __m256i pm = _mm256_set1_epi16(static_cast<short>(prevMin));
+	const __m256i jump = _mm256_adds_epu16(
+		pm, _mm256_set1_epi16(static_cast<short>(P2)));
+	__m256i newMin = _mm256_set1_epi16(-1);
+
+	for (size_t d = 0; d < D; d += 16)
+	{
+		const __m256i side = _mm256_adds_epu16(
+			_mm256_min_epu16(load(prev + d - 1), load(prev + d + 1)), p1);
+		const __m256i v = _mm256_min_epu16(
+			_mm256_min_epu16(load(prev + d), side), jump);
+		const __m256i c = _mm256_cvtepu8_epi16(
+			_mm_loadu_si128(reinterpret_cast<const __m128i*>(C + d)));
+		const __m256i l = _mm256_add_epi16(c, _mm256_sub_epi16(v, pm));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(cur + d), l);
+		_mm256_storeu_si256(
+			reinterpret_cast<__m256i*>(S + d),
+			_mm256_add_epi16(load(S + d), l));
+		newMin = _mm256_min_epu16(newMin, l);
+	}
+	const __m128i m = _mm_minpos_epu16(_mm_min_epu16(
+		_mm256_castsi256_si128(newMin),
+		_mm256_extracti128_si256(newMin, 1)));
+	return static_cast<uint16_t>(_mm_cvtsi128_si32(m) & 0xffff);
+#else
+	return sgm_path_step_portable(C, prev, prevMin, D, P1, P2, cur, S);
+#endif
+}
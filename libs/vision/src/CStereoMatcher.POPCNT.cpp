@@ -0,0 +1,36 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "vision-precomp.h"	 // Precompiled headers
+//
+#include <mrpt/config.h>
+
+#include "CStereoMatcher_kernels.h"
+
+// ---------------------------------------------------------------------------
+//   This file contains the POPCNT version of the census cost kernel. It is
+//   built with "-mpopcnt" (see DeclareMRPTLib.cmake), and only called if the
+//   CPU supports POPCNT.
+// ---------------------------------------------------------------------------
+#if MRPT_ARCH_INTEL_COMPATIBLE
+#include <nmmintrin.h>
+#endif
+
+void mrpt::vision::detail::census_costs_POPCNT(
+	uint32_t left, const uint32_t* right, size_t n, uint8_t* costs)
+{
+	for (size_t k = 0; k < n; k++)
+	{
+#if MRPT_ARCH_INTEL_COMPATIBLE
+		costs[k] = static_cast<uint8_t>(_mm_popcnt_u32(left ^ right[k]));
+#else
+		costs[k] = static_cast<uint8_t>(popcount32_portable(left ^ right[k]));
+#endif
+	}
+}
@@ -0,0 +1,523 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "vision-precomp.h"	 // Precompiled headers
+//
+#include <mrpt/core/bits_math.h>
+#include <mrpt/core/cpu.h>
+#include <mrpt/poses/CPose3DQuat.h>
+#include <mrpt/vision/CStereoMatcher.h>
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+#include "CStereoMatcher_kernels.h"
+
+using namespace mrpt::vision;
+using namespace mrpt::vision::detail;
+using mrpt::img::CImage;
+
+namespace
+{
+/** Cost of the disparities out of the right image: all 24 census bits */
+constexpr uint8_t MAX_CENSUS_COST = 24;
+
+struct TKernels
+{
+	census_costs_t costs = &census_costs_portable;
+	sgm_path_step_t sgmStep = &sgm_path_step_portable;
+};
+
+TKernels selectKernels(bool useSIMD)
+{
+	using mrpt::cpu::feature;
+	TKernels k;
+	if (useSIMD && mrpt::cpu::supports(feature::AVX2))
+	{
+		k.costs = &census_costs_AVX2;
+		k.sgmStep = &sgm_path_step_AVX2;
+	}
+	else if (useSIMD && mrpt::cpu::supports(feature::POPCNT))
+		k.costs = &census_costs_POPCNT;
+	return k;
+}
+
+// Returns `img` itself, or its grayscale version (into `buf`) if it is color
+const CImage& asGray(const CImage& img, CImage& buf)
+{
+	ASSERTMSG_(
+		img.getPixelDepth() == mrpt::img::PixelDepth::D8U,
+		"Only 8-bit images are supported");
+	if (!img.isColor()) return img;
+	img.grayscale(buf);
+	return buf;
+}
+
+// 5x5 census transform of one pixel of row `rows[2]`, at the columns `xs`
+inline uint32_t census5x5(const uint8_t* const rows[5], const int xs[5], int x)
+{
+	const uint8_t c = rows[2][x];
+	uint32_t bits = 0;
+	for (int i = 0; i < 5; i++)
+		for (int j = 0; j < 5; j++)
+		{
+			if (i == 2 && j == 2) continue;
+			bits = (bits << 1) | (rows[i][xs[j]] < c ? 1U : 0U);
+		}
+	return bits;
+}
+
+// 5x5 census transform of rows [y0,y1): one bit per neighbor, set if it is
+// darker than the central pixel. Borders are replicated.
+void censusTransform(
+	const uint8_t* img, size_t stride, int W, int H, size_t y0, size_t y1,
+	uint32_t* out)
+{
+	const uint8_t* rows[5];
+	const int offsets[5] = {-2, -1, 0, 1, 2};
+	// Columns [x0,x1) do not need clamping:
+	const int x0 = std::min(2, W), x1 = std::max(x0, W - 2);
+	for (int y = static_cast<int>(y0); y < static_cast<int>(y1); y++)
+	{
+		for (int k = 0; k < 5; k++)
+			rows[k] = img + stride * std::clamp(y + k - 2, 0, H - 1);
+		uint32_t* o = out + size_t(y) * W;
+
+		auto border = [&](int x) {
+			int xs[5];
+			for (int k = 0; k < 5; k++)
+				xs[k] = std::clamp(x + offsets[k], 0, W - 1);
+			o[x] = census5x5(rows, xs, x);
+		};
+		for (int x = 0; x < x0; x++)
+			border(x);
+		// One bit at a time for the whole row (vectorizable):
+		std::fill(o + x0, o + x1, 0);
+		for (int i = 0; i < 5; i++)
+			for (int j = 0; j < 5; j++)
+			{
+				if (i == 2 && j == 2) continue;
+				const uint8_t* n = rows[i] + offsets[j];
+				for (int x = x0; x < x1; x++)
+					o[x] = (o[x] << 1) | (n[x] < rows[2][x] ? 1U : 0U);
+			}
+		for (int x = x1; x < W; x++)
+			border(x);
+	}
+}
+
+// Best disparity (index in [0,D)) of each pixel of one row of aggregated
+// costs `A` (W*D), as seen from the right image: the right pixel xr matches
+// the left pixel xr+minDisp+k.
+void rightImageDisparities(
+	const uint16_t* A, int W, int D, int minDisp, std::vector<int>& dispR,
+	std::vector<uint16_t>& costR)
+{
+	dispR.assign(W, -1);
+	costR.assign(W, 0xffff);
+	for (int x = minDisp; x < W; x++)
+	{
+		const uint16_t* a = A + size_t(x) * D;
+		const int nk = std::min(D, x - minDisp + 1);
+		for (int k = 0; k < nk; k++)
+		{
+			const int xr = x - minDisp - k;
+			if (a[k] < costR[xr])
+			{
+				costR[xr] = a[k];
+				dispR[xr] = k;
+			}
+		}
+	}
+}
+
+inline uint16_t minCost(const uint16_t* a, int n)
+{
+	uint16_t m = 0xffff;
+	for (int k = 0; k < n; k++)
+		m = std::min(m, a[k]);
+	return m;
+}
+
+// Winner-takes-all disparities of one row of aggregated costs `A` (W*D)
+void selectDisparities(
+	const uint16_t* A, int W, const CStereoMatcher::TOptions& opts,
+	std::vector<int>& dispR, std::vector<uint16_t>& costR, float* out)
+{
+	const int D = opts.numDisparities;
+	if (opts.leftRightCheck)
+		rightImageDisparities(A, W, D, opts.minDisparity, dispR, costR);
+
+	for (int x = 0; x < W; x++, A += D)
+	{
+		out[x] = CStereoMatcher::INVALID_DISPARITY;
+
+		const uint16_t bestCost = minCost(A, D);
+		int best = 0;
+		while (A[best] != bestCost)
+			best++;
+		const int disp = opts.minDisparity + best;
+		if (x - disp < 0) continue;
+
+		if (opts.uniquenessRatio > 0)
+		{
+			const uint32_t second = std::min(
+				minCost(A, best - 1), minCost(A + best + 2, D - best - 2));
+			if (second * 100U < bestCost * (100U + opts.uniquenessRatio))
+				continue;
+		}
+		if (opts.leftRightCheck &&
+			(dispR[x - disp] < 0 ||
+			 std::abs(dispR[x - disp] - best) > opts.leftRightMaxDiff))
+			continue;
+
+		float d = static_cast<float>(disp);
+		if (opts.subpixel && best > 0 && best < D - 1)
+		{
+			const int c0 = A[best - 1], c1 = A[best], c2 = A[best + 1];
+			const int denom = c0 + c2 - 2 * c1;
+			if (denom > 0) d += (c0 - c2) / (2.0f * denom);
+		}
+		out[x] = d;
+	}
+}
+
+bool sameCameraParams(
+	const mrpt::img::TStereoCamera& a, const mrpt::img::TStereoCamera& b)
+{
+	return a.leftCamera == b.leftCamera && a.rightCamera == b.rightCamera &&
+		mrpt::poses::CPose3DQuat(a.rightCameraPose) ==
+		mrpt::poses::CPose3DQuat(b.rightCameraPose);
+}
+}  // namespace
+
+void CStereoMatcher::internal_forBands(
+	size_t n, size_t nPixels,
+	const std::function<void(size_t, size_t)>& fn) const
+{
+	size_t nThreads = options.numThreads;
+	if (!nThreads)
+		nThreads = std::max(1U, std::thread::hardware_concurrency());
+
+	if (nThreads <= 1 || n < 2 || nPixels < options.minPixelsForParallel)
+	{
+		fn(0, n);
+		return;
+	}
+	// The calling thread also runs tasks:
+	if (!m_threadPool || m_threadPool->size() != nThreads - 1)
+		m_threadPool = std::make_shared<mrpt::WorkerThreadsPool>(
+			nThreads - 1, mrpt::WorkerThreadsPool::POLICY_FIFO,
+			"CStereoMatcher");
+
+	// A few bands per thread, to balance the load:
+	const size_t nBands = std::min(n, nThreads * 4);
+	m_threadPool->parallel_for(0, nBands, 1, [&](size_t b) {
+		fn(b * n / nBands, (b + 1) * n / nBands);
+	});
+}
+
+void CStereoMatcher::computeDisparity(
+	const CImage& inLeft, const CImage& inRight,
+	mrpt::math::CMatrixFloat& disparity)
+{
+	MRPT_START
+	CImage bufL, bufR;
+	const CImage& left = asGray(inLeft, bufL);
+	const CImage& right = asGray(inRight, bufR);
+	ASSERTMSG_(
+		left.getWidth() == right.getWidth() &&
+			left.getHeight() == right.getHeight(),
+		"Both images must have the same size");
+	ASSERT_EQUAL_(left.getRowStride(), right.getRowStride());
+
+	computeDisparity(
+		left.ptrLine<uint8_t>(0), right.ptrLine<uint8_t>(0), left.getWidth(),
+		left.getHeight(), left.getRowStride(), disparity);
+	MRPT_END
+}
+
+void CStereoMatcher::computeDisparity(
+	const uint8_t* left, const uint8_t* right, size_t width, size_t height,
+	size_t rowStride, mrpt::math::CMatrixFloat& disparity)
+{
+	MRPT_START
+	const auto& o = options;
+	ASSERT_GE_(o.minDisparity, 0);
+	ASSERT_GT_(o.numDisparities, 0);
+	ASSERTMSG_(
+		o.numDisparities % 16 == 0, "numDisparities must be a multiple of 16");
+	ASSERT_(o.blockRadius >= 0 && o.blockRadius <= 16);
+	ASSERT_(
+		uint32_t(MAX_CENSUS_COST) + o.P2 <= 0xffff / 4 && o.P1 <= o.P2);
+	ASSERT_GE_(rowStride, width);
+
+	const int W = static_cast<int>(width);
+	const int H = static_cast<int>(height);
+	const int D = o.numDisparities;
+	const size_t nPixels = size_t(W) * H;
+	const TKernels k = selectKernels(o.useSIMD);
+
+	disparity.setSize(H, W);
+	if (!nPixels) return;
+
+	// 1) Census transforms:
+	m_censusL.resize(nPixels);
+	m_censusR.resize(nPixels);
+	internal_forBands(H, nPixels, [&](size_t y0, size_t y1) {
+		censusTransform(left, rowStride, W, H, y0, y1, m_censusL.data());
+		censusTransform(right, rowStride, W, H, y0, y1, m_censusR.data());
+	});
+
+	// 2) Matching costs, with disparities contiguous in memory for each
+	// pixel: the right census rows are reversed (and padded), so the right
+	// pixels for increasing disparities are consecutive.
+	m_costs.resize(nPixels * D);
+	internal_forBands(H, nPixels, [&](size_t y0, size_t y1) {
+		std::vector<uint32_t> rev(W + o.minDisparity + D, 0);
+		for (size_t y = y0; y < y1; y++)
+		{
+			const uint32_t* cL = &m_censusL[y * W];
+			const uint32_t* cR = &m_censusR[y * W];
+			for (int i = 0; i < W; i++)
+				rev[i] = cR[W - 1 - i];
+			for (int x = 0; x < W; x++)
+			{
+				uint8_t* c = &m_costs[(y * W + x) * D];
+				k.costs(cL[x], &rev[W - 1 - x + o.minDisparity], D, c);
+				for (int d = std::max(0, x - o.minDisparity + 1); d < D; d++)
+					c[d] = MAX_CENSUS_COST;
+			}
+		}
+	});
+
+	// 3) Aggregation and 4) disparity selection:
+	m_aggr.resize(nPixels * D);
+	const size_t rowLen = size_t(W) * D;
+
+	if (o.method == smBlockMatching)
+	{
+		// Horizontal box sums of each row into m_aggr:
+		const int r = o.blockRadius;
+		internal_forBands(H, nPixels, [&](size_t y0, size_t y1) {
+			std::vector<uint16_t> acc(D);
+			for (size_t y = y0; y < y1; y++)
+			{
+				const uint8_t* C = &m_costs[y * rowLen];
+				uint16_t* A = &m_aggr[y * rowLen];
+				std::fill(acc.begin(), acc.end(), 0);
+				for (int x = -r; x <= r; x++)
+				{
+					const uint8_t* c = C + size_t(std::clamp(x, 0, W - 1)) * D;
+					for (int d = 0; d < D; d++)
+						acc[d] += c[d];
+				}
+				for (int x = 0; x < W; x++)
+				{
+					if (x > 0)
+					{
+						const uint8_t* cIn =
+							C + size_t(std::min(x + r, W - 1)) * D;
+						const uint8_t* cOut =
+							C + size_t(std::max(x - r - 1, 0)) * D;
+						for (int d = 0; d < D; d++)
+							acc[d] += cIn[d] - cOut[d];
+					}
+					std::copy(acc.begin(), acc.end(), A + size_t(x) * D);
+				}
+			}
+		});
+		// Vertical sums of the window rows (running sums within each band of
+		// rows), and WTA:
+		internal_forBands(H, nPixels, [&](size_t y0, size_t y1) {
+			std::vector<uint16_t> rowSum(rowLen, 0);
+			std::vector<int> dispR;
+			std::vector<uint16_t> costR;
+			auto hRow = [&](int y) {
+				return &m_aggr[std::clamp(y, 0, H - 1) * rowLen];
+			};
+			for (int dy = -r; dy <= r; dy++)
+			{
+				const uint16_t* A = hRow(int(y0) + dy);
+				for (size_t i = 0; i < rowLen; i++)
+					rowSum[i] += A[i];
+			}
+			for (size_t y = y0; y < y1; y++)
+			{
+				if (y > y0)
+				{
+					const uint16_t* In = hRow(int(y) + r);
+					const uint16_t* Out = hRow(int(y) - r - 1);
+					for (size_t i = 0; i < rowLen; i++)
+						rowSum[i] += In[i] - Out[i];
+				}
+				selectDisparities(
+					rowSum.data(), W, o, dispR, costR, &disparity(y, 0));
+			}
+		});
+		return;
+	}
+
+	// SGM: horizontal paths, in bands of rows:
+	const size_t Dp = D + 2;  // path buffers, padded with 0xffff
+	internal_forBands(H, nPixels, [&](size_t y0, size_t y1) {
+		std::vector<uint16_t> bufA(Dp), bufB(Dp);
+		for (size_t y = y0; y < y1; y++)
+		{
+			const uint8_t* C = &m_costs[y * rowLen];
+			uint16_t* S = &m_aggr[y * rowLen];
+			std::fill(S, S + rowLen, 0);
+			for (int dir = 0; dir < 2; dir++)
+			{
+				std::fill(bufA.begin(), bufA.end(), 0);
+				bufA.front() = bufA.back() = bufB.front() = bufB.back() =
+					0xffff;
+				uint16_t *prev = &bufA[1], *cur = &bufB[1];
+				uint16_t prevMin = 0;
+				for (int i = 0; i < W; i++)
+				{
+					const size_t x = dir == 0 ? i : W - 1 - i;
+					prevMin = k.sgmStep(
+						C + x * D, prev, prevMin, D, o.P1, o.P2, cur,
+						S + x * D);
+					std::swap(prev, cur);
+				}
+			}
+		}
+	});
+	// Vertical paths, in bands of columns:
+	internal_forBands(W, nPixels, [&](size_t x0, size_t x1) {
+		const size_t n = x1 - x0;
+		std::vector<uint16_t> bufA(n * Dp), bufB(n * Dp), prevMin(n);
+		for (int dir = 0; dir < 2; dir++)
+		{
+			std::fill(bufA.begin(), bufA.end(), 0);
+			for (size_t i = 0; i < n; i++)
+				bufA[i * Dp] = bufA[i * Dp + Dp - 1] = bufB[i * Dp] =
+					bufB[i * Dp + Dp - 1] = 0xffff;
+			std::fill(prevMin.begin(), prevMin.end(), 0);
+			uint16_t *prev = &bufA[1], *cur = &bufB[1];
+			for (int i = 0; i < H; i++)
+			{
+				const size_t y = dir == 0 ? i : H - 1 - i;
+				const size_t base = (y * W + x0) * D;
+				for (size_t j = 0; j < n; j++)
+					prevMin[j] = k.sgmStep(
+						&m_costs[base + j * D], prev + j * Dp, prevMin[j], D,
+						o.P1, o.P2, cur + j * Dp, &m_aggr[base + j * D]);
+				std::swap(prev, cur);
+			}
+		}
+	});
+	internal_forBands(H, nPixels, [&](size_t y0, size_t y1) {
+		std::vector<int> dispR;
+		std::vector<uint16_t> costR;
+		for (size_t y = y0; y < y1; y++)
+			selectDisparities(
+				&m_aggr[y * rowLen], W, o, dispR, costR, &disparity(y, 0));
+	});
+	MRPT_END
+}
+
+void CStereoMatcher::processObservation(
+	const mrpt::obs::CObservationStereoImages& in,
+	mrpt::obs::CObservation3DRangeScan& out)
+{
+	MRPT_START
+	ASSERTMSG_(in.hasImageRight, "The observation has no right image");
+
+	CImage left, right;
+	mrpt::img::TCamera cam;
+	mrpt::poses::CPose3DQuat camPose = in.cameraPose;
+	// Rectification does not change the length of the baseline:
+	const double baseline = in.rightCameraPose.m_coords.norm();
+
+	if (in.areImagesRectified())
+	{
+		CImage bufL, bufR;
+		const CImage& grayL = asGray(in.imageLeft, bufL);
+		const CImage& grayR = asGray(in.imageRight, bufR);
+		cam = in.leftCamera;
+		if (options.halfResolution)
+		{
+			grayL.scaleHalf(left, mrpt::img::IMG_INTERP_LINEAR);
+			grayR.scaleHalf(right, mrpt::img::IMG_INTERP_LINEAR);
+		}
+		else
+		{
+			left = grayL.makeShallowCopy();
+			right = grayR.makeShallowCopy();
+		}
+	}
+	else
+	{
+		// (Re)compute the maps only if the cameras changed:
+		const auto params = in.getStereoCameraParams();
+		if (!m_rectify.isSet() ||
+			!sameCameraParams(m_rectify.getCameraParams(), params))
+			m_rectify.setFromCamParams(params);
+
+		TRemapOptions ro;
+		ro.grayscale = true;
+		ro.halfResolution = options.halfResolution;
+		ro.numThreads = options.numThreads;
+		m_rectify.rectify(in.imageLeft, in.imageRight, left, right, ro);
+
+		cam = m_rectify.getRectifiedLeftImageParams();
+		camPose += m_rectify.getLeftCameraRot();
+	}
+	if (cam.ncols != left.getWidth() || cam.nrows != left.getHeight())
+		cam.scaleToResolution(left.getWidth(), left.getHeight());
+
+	computeDisparity(left, right, m_disp);
+
+	// Depth image:
+	const int W = static_cast<int>(left.getWidth());
+	const int H = static_cast<int>(left.getHeight());
+	const double fB = cam.fx() * baseline;
+	const double maxDepth = options.maxDepth;
+	const double maxRangeUnits = 0xffff;
+
+	out.hasRangeImage = true;
+	out.range_is_depth = true;
+	out.rangeImage_setSize(H, W);
+	for (int y = 0; y < H; y++)
+		for (int x = 0; x < W; x++)
+		{
+			const float d = m_disp(y, x);
+			uint16_t r = 0;
+			if (d > 0)
+			{
+				const double z = fB / d;
+				const double zu = z / out.rangeUnits;
+				if (z <= maxDepth && zu < maxRangeUnits)
+					r = static_cast<uint16_t>(zu + 0.5);
+			}
+			out.rangeImage(y, x) = r;
+		}
+
+	// Intensity image, cameras and poses:
+	out.hasIntensityImage = true;
+	out.intensityImage = left;
+	out.intensityImageChannel = mrpt::obs::CObservation3DRangeScan::CH_VISIBLE;
+	out.hasPoints3D = false;
+	out.hasConfidenceImage = false;
+	out.cameraParams = cam;
+	out.cameraParamsIntensity = cam;
+	// The depth frame has +X forward, the camera frame +Z forward:
+	out.relativePoseIntensityWRTDepth =
+		mrpt::poses::CPose3D(0, 0, 0, -90.0_deg, 0.0_deg, -90.0_deg);
+	out.sensorPose = mrpt::poses::CPose3D(camPose) +
+		(-out.relativePoseIntensityWRTDepth);
+	out.maxRange = options.maxDepth;
+	out.timestamp = in.timestamp;
+	out.sensorLabel = in.sensorLabel;
+	MRPT_END
+}
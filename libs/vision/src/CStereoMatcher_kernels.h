@@ -0,0 +1,78 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace mrpt::vision::detail
+{
+/** Census matching costs of one left pixel: `costs[k]` is the Hamming
+ * distance between the census `left` and `right[k]`, for k in [0,n). */
+using census_costs_t = void (*)(
+	uint32_t left, const uint32_t* right, size_t n, uint8_t* costs);
+
+/** One step of a SGM path, for `D` disparities (a multiple of 16):
+ * `cur[d] = C[d] + min(prev[d], prev[d-1]+P1, prev[d+1]+P1, prevMin+P2) -
+ * prevMin`, and `S[d] += cur[d]`. `prev[-1]` and `prev[D]` must be 0xffff.
+ * \return The minimum of `cur` */
+using sgm_path_step_t = uint16_t (*)(
+	const uint8_t* C, const uint16_t* prev, uint16_t prevMin, size_t D,
+	uint16_t P1, uint16_t P2, uint16_t* cur, uint16_t* S);
+
+/** Portable (SWAR) number of bits set */
+inline uint32_t popcount32_portable(uint32_t x)
+{
+	x = x - ((x >> 1) & 0x55555555U);
+	x = (x & 0x33333333U) + ((x >> 2) & 0x33333333U);
+	x = (x + (x >> 4)) & 0x0f0f0f0fU;
+	return (x * 0x01010101U) >> 24;
+}
+
+inline void census_costs_portable(
+	uint32_t left, const uint32_t* right, size_t n, uint8_t* costs)
+{
+	for (size_t k = 0; k < n; k++)
+		costs[k] = static_cast<uint8_t>(popcount32_portable(left ^ right[k]));
+}
+
+inline uint16_t sgm_path_step_portable(
+	const uint8_t* C, const uint16_t* prev, uint16_t prevMin, size_t D,
+	uint16_t P1, uint16_t P2, uint16_t* cur, uint16_t* S)
+{
+	const uint32_t jump = uint32_t(prevMin) + P2;
+	uint16_t newMin = 0xffff;
+	for (size_t d = 0; d < D; d++)
+	{
+		const uint32_t v = std::min(
+			std::min<uint32_t>(prev[d], jump),
+			std::min(uint32_t(prev[d - 1]), uint32_t(prev[d + 1])) + P1);
+		const auto l = static_cast<uint16_t>(C[d] + v - prevMin);
+		cur[d] = l;
+		S[d] += l;
+		newMin = std::min(newMin, l);
+	}
+	return newMin;
+}
+
+/** Only call it if mrpt::cpu::supports(mrpt::cpu::feature::POPCNT) */
+void census_costs_POPCNT(
+	uint32_t left, const uint32_t* right, size_t n, uint8_t* costs);
+
+/** Only call it if mrpt::cpu::supports(mrpt::cpu::feature::AVX2) */
+void census_costs_AVX2(
+	uint32_t left, const uint32_t* right, size_t n, uint8_t* costs);
+
+/** Only call it if mrpt::cpu::supports(mrpt::cpu::feature::AVX2) */
+uint16_t sgm_path_step_AVX2(
+	const uint8_t* C, const uint16_t* prev, uint16_t prevMin, size_t D,
+	uint16_t P1, uint16_t P2, uint16_t* cur, uint16_t* S);
+
+}  // namespace mrpt::vision::detail
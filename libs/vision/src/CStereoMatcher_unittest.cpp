@@ -0,0 +1,222 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/core/cpu.h>
+#include <mrpt/vision/CStereoMatcher.h>
+
+#include <cmath>
+#include <random>
+
+#include "CStereoMatcher_kernels.h"
+
+using mrpt::vision::CStereoMatcher;
+
+namespace
+{
+constexpr int W = 160, H = 120;
+
+// A random texture seen by the right camera, and the left image with a
+// disparity of `dBack` pixels, but for a square with a disparity of `dFront`
+void syntheticPair(
+	int dBack, int dFront, std::vector<uint8_t>& left,
+	std::vector<uint8_t>& right)
+{
+	std::mt19937 rng(42);
+	std::uniform_int_distribution<int> px(0, 255);
+	// Blobs of 2x2 pixels, so the texture is not aliased by the census:
+	std::vector<uint8_t> back(W * H), front(W * H);
+	for (int y = 0; y < H; y++)
+		for (int x = 0; x < W; x++)
+		{
+			if (x % 2 == 0 && y % 2 == 0)
+			{
+				back[y * W + x] = px(rng);
+				front[y * W + x] = px(rng);
+			}
+			else
+			{
+				back[y * W + x] = back[(y & ~1) * W + (x & ~1)];
+				front[y * W + x] = front[(y & ~1) * W + (x & ~1)];
+			}
+		}
+
+	auto inSquare = [](int x, int y) {
+		return x >= 70 && x < 110 && y >= 40 && y < 80;
+	};
+	left.resize(W * H);
+	right.resize(W * H);
+	for (int y = 0; y < H; y++)
+		for (int x = 0; x < W; x++)
+		{
+			left[y * W + x] =
+				inSquare(x, y) ? front[y * W + x] : back[y * W + x];
+			const int xl = x + dFront;
+			right[y * W + x] = xl < W && inSquare(xl, y)
+				? front[y * W + xl]
+				: back[y * W + std::min(x + dBack, W - 1)];
+		}
+}
+
+// Fraction of the pixels (in the area where both images overlap, away from
+// the square borders) with the expected disparity
+double fractionCorrect(
+	const mrpt::math::CMatrixFloat& disp, int dBack, int dFront)
+{
+	size_t n = 0, ok = 0;
+	for (int y = 4; y < H - 4; y++)
+		for (int x = dFront + 4; x < W - 4; x++)
+		{
+			const bool front = x >= 74 && x < 106 && y >= 44 && y < 76;
+			const bool back = x < 60 || x >= 120 || y < 30 || y >= 90;
+			if (!front && !back) continue;
+			n++;
+			const float d = disp(y, x);
+			if (d != CStereoMatcher::INVALID_DISPARITY &&
+				std::abs(d - (front ? dFront : dBack)) < 0.6f)
+				ok++;
+		}
+	return double(ok) / n;
+}
+}  // namespace
+
+TEST(CStereoMatcher, kernelsMatchPortable)
+{
+	using namespace mrpt::vision::detail;
+	std::mt19937 rng(123);
+	std::uniform_int_distribution<uint32_t> bits(0, (1U << 24) - 1);
+	std::uniform_int_distribution<int> cost(0, 24);
+
+	std::vector<uint32_t> census(100);
+	for (auto& c : census)
+		c = bits(rng);
+	for (size_t n : {1, 15, 16, 33, 64})
+	{
+		std::vector<uint8_t> a(n), b(n);
+		census_costs_portable(census[0], &census[1], n, a.data());
+		if (mrpt::cpu::supports(mrpt::cpu::feature::POPCNT))
+		{
+			census_costs_POPCNT(census[0], &census[1], n, b.data());
+			EXPECT_EQ(a, b) << "n=" << n;
+		}
+		if (mrpt::cpu::supports(mrpt::cpu::feature::AVX2))
+		{
+			census_costs_AVX2(census[0], &census[1], n, b.data());
+			EXPECT_EQ(a, b) << "n=" << n;
+		}
+	}
+
+	if (!mrpt::cpu::supports(mrpt::cpu::feature::AVX2)) return;
+	for (size_t D : {16, 48})
+	{
+		std::vector<uint8_t> C(D);
+		std::vector<uint16_t> prev(D + 2, 0xffff), S1(D, 5), S2(D, 5),
+			cur1(D), cur2(D);
+		for (size_t d = 0; d < D; d++)
+		{
+			C[d] = cost(rng);
+			prev[d + 1] = 30 + cost(rng) * 3;
+		}
+		const uint16_t prevMin = 30;
+		const auto m1 = sgm_path_step_portable(
+			C.data(), &prev[1], prevMin, D, 4, 40, cur1.data(), S1.data());
+		const auto m2 = sgm_path_step_AVX2(
+			C.data(), &prev[1], prevMin, D, 4, 40, cur2.data(), S2.data());
+		EXPECT_EQ(m1, m2);
+		EXPECT_EQ(cur1, cur2);
+		EXPECT_EQ(S1, S2);
+	}
+}
+
+TEST(CStereoMatcher, syntheticDisparities)
+{
+	const int dBack = 8, dFront = 24;
+	std::vector<uint8_t> left, right;
+	syntheticPair(dBack, dFront, left, right);
+
+	for (const auto method :
+		 {CStereoMatcher::smBlockMatching, CStereoMatcher::smSemiGlobal})
+	{
+		for (bool useSIMD : {false, true})
+		{
+			CStereoMatcher matcher;
+			matcher.options.method = method;
+			matcher.options.numDisparities = 32;
+			matcher.options.useSIMD = useSIMD;
+			matcher.options.minPixelsForParallel = 0;
+
+			mrpt::math::CMatrixFloat disp;
+			matcher.computeDisparity(
+				left.data(), right.data(), W, H, W, disp);
+			ASSERT_EQ(disp.rows(), H);
+			ASSERT_EQ(disp.cols(), W);
+			EXPECT_GT(fractionCorrect(disp, dBack, dFront), 0.95)
+				<< "method=" << int(method) << " useSIMD=" << useSIMD;
+		}
+	}
+}
+
+TEST(CStereoMatcher, singleThreadSameResult)
+{
+	std::vector<uint8_t> left, right;
+	syntheticPair(5, 17, left, right);
+
+	CStereoMatcher matcher;
+	matcher.options.minPixelsForParallel = 0;
+	mrpt::math::CMatrixFloat d1, d2;
+	matcher.computeDisparity(left.data(), right.data(), W, H, W, d1);
+	matcher.options.numThreads = 1;
+	matcher.computeDisparity(left.data(), right.data(), W, H, W, d2);
+	EXPECT_EQ(d1, d2);
+}
+
+#if MRPT_HAS_OPENCV
+TEST(CStereoMatcher, processRectifiedObservation)
+{
+	const int dBack = 8, dFront = 24;
+	std::vector<uint8_t> left, right;
+	syntheticPair(dBack, dFront, left, right);
+
+	mrpt::obs::CObservationStereoImages obs;
+	obs.imageLeft.resize(W, H, mrpt::img::CH_GRAY);
+	obs.imageRight.resize(W, H, mrpt::img::CH_GRAY);
+	for (int y = 0; y < H; y++)
+		for (int x = 0; x < W; x++)
+		{
+			*obs.imageLeft(x, y) = left[y * W + x];
+			*obs.imageRight(x, y) = right[y * W + x];
+		}
+	obs.hasImageRight = true;
+	obs.leftCamera.ncols = obs.rightCamera.ncols = W;
+	obs.leftCamera.nrows = obs.rightCamera.nrows = H;
+	obs.leftCamera.setIntrinsicParamsFromValues(200, 200, W / 2, H / 2);
+	obs.rightCamera.setIntrinsicParamsFromValues(200, 200, W / 2, H / 2);
+	obs.leftCamera.dist.fill(0);
+	obs.rightCamera.dist.fill(0);
+	const double baseline = 0.12;
+	obs.rightCameraPose = mrpt::poses::CPose3DQuat(
+		baseline, 0, 0, mrpt::math::CQuaternionDouble());
+	ASSERT_TRUE(obs.areImagesRectified());
+
+	CStereoMatcher matcher;
+	mrpt::obs::CObservation3DRangeScan obs3D;
+	matcher.processObservation(obs, obs3D);
+
+	ASSERT_TRUE(obs3D.hasRangeImage);
+	ASSERT_EQ(obs3D.rangeImage.cols(), W);
+	ASSERT_EQ(obs3D.rangeImage.rows(), H);
+	EXPECT_NEAR(
+		obs3D.rangeImage(60, 90) * obs3D.rangeUnits, 200 * baseline / dFront,
+		0.02);
+	EXPECT_NEAR(
+		obs3D.rangeImage(20, 140) * obs3D.rangeUnits, 200 * baseline / dBack,
+		0.1);
+	EXPECT_TRUE(obs3D.doDepthAndIntensityCamerasCoincide());
+}
+#endif
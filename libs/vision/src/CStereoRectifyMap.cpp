@@ -10,10 +10,17 @@
 #include "vision-precomp.h"	 // Precompiled headers
 //
 #include <mrpt/3rdparty/do_opencv_includes.h>
+#include <mrpt/io/CFileInputStream.h>
+#include <mrpt/io/CFileOutputStream.h>
+#include <mrpt/io/CMemoryStream.h>
+#include <mrpt/serialization/CArchive.h>
+#include <mrpt/system/filesystem.h>
 #include <mrpt/vision/CStereoRectifyMap.h>
 
 #include <Eigen/Dense>
 
+#include "remap_fixed_point.h"
+
 using namespace mrpt;
 using namespace mrpt::poses;
 using namespace mrpt::vision;
@@ -22,50 +29,12 @@ using namespace mrpt::math;
 
 #if MRPT_HAS_OPENCV
 #include <opencv2/core/eigen.hpp>
-
-static void do_rectify(
-	const CStereoRectifyMap& me, const cv::Mat& src_left,
-	const cv::Mat& src_right, cv::Mat& out_left, cv::Mat& out_right,
-	int16_t* map_xl, int16_t* map_xr, uint16_t* map_yl, uint16_t* map_yr,
-	int interp_method)
-{
-	MRPT_START
-	ASSERTMSG_(
-		src_left.data != out_left.data && src_right.data != out_right.data,
-		"in-place rectify not supported");
-
-	if (!me.isSet())
-		THROW_EXCEPTION(
-			"Error: setFromCamParams() must be called prior to rectify().");
-
-	const uint32_t ncols = me.getCameraParams().leftCamera.ncols;
-	const uint32_t nrows = me.getCameraParams().leftCamera.nrows;
-
-	const int ncols_out =
-		me.isEnabledResizeOutput() ? me.getResizeOutputSize().x : ncols;
-	const int nrows_out =
-		me.isEnabledResizeOutput() ? me.getResizeOutputSize().y : nrows;
-
-	const CvMat mapx_left = cvMat(nrows_out, ncols_out, CV_16SC2, map_xl);
-	const CvMat mapy_left = cvMat(nrows_out, ncols_out, CV_16UC1, map_yl);
-	const CvMat mapx_right = cvMat(nrows_out, ncols_out, CV_16SC2, map_xr);
-	const CvMat mapy_right = cvMat(nrows_out, ncols_out, CV_16UC1, map_yr);
-
-	const cv::Mat mapx1 = cv::cvarrToMat(&mapx_left);
-	const cv::Mat mapy1 = cv::cvarrToMat(&mapy_left);
-	const cv::Mat mapx2 = cv::cvarrToMat(&mapx_right);
-	const cv::Mat mapy2 = cv::cvarrToMat(&mapy_right);
-
-	cv::remap(
-		src_left, out_left, mapx1, mapy1, interp_method, cv::BORDER_CONSTANT,
-		cvScalarAll(0));
-	cv::remap(
-		src_right, out_right, mapx2, mapy2, interp_method, cv::BORDER_CONSTANT,
-		cvScalarAll(0));
-	MRPT_END
-}
 #endif
 
+// Version of the format of the cached maps:
+static const std::string CACHE_MAGIC = "MRPT_STEREO_RECTIFY_MAP";
+static constexpr uint8_t CACHE_VERSION = 1;
+
 void CStereoRectifyMap::internal_invalidate()
 {
 	// don't do a "strong clear" since memory is likely to be reasigned soon.
@@ -128,6 +97,21 @@ void CStereoRectifyMap::setFromCamParams(const mrpt::img::TStereoCamera& params)
 	// save a copy for future reference
 	m_camera_params = params;
 
+	std::string cacheFile;
+	if (!m_cache_dir.empty())
+	{
+		mrpt::io::CMemoryStream buf;
+		auto a = mrpt::serialization::archiveFrom(buf);
+		a << CACHE_MAGIC << CACHE_VERSION << params << m_alpha
+		  << m_resize_output << m_resize_output_value.x
+		  << m_resize_output_value.y << m_enable_both_centers_coincide;
+		const auto* p = static_cast<const uint8_t*>(buf.getRawBufferData());
+		cacheFile = detail::remapCacheFile(
+			m_cache_dir, "stereo_rectify",
+			std::vector<uint8_t>(p, p + buf.getTotalBytesCount()));
+		if (internal_loadCache(cacheFile)) return;
+	}
+
 	// Create OpenCV's wrappers for output maps:
 	m_dat_mapx_left.resize(2 * nrows_out * ncols_out);
 	m_dat_mapy_left.resize(nrows_out * ncols_out);
@@ -256,6 +240,8 @@ void CStereoRectifyMap::setFromCamParams(const mrpt::img::TStereoCamera& params)
 
 	m_rectified_image_params.rightCameraPose = params.rightCameraPose;
 
+	if (!cacheFile.empty()) internal_saveCache(cacheFile);
+
 #else
 	THROW_EXCEPTION("MRPT built without OpenCV >=2.0.0!");
 #endif
@@ -266,37 +252,42 @@ void CStereoRectifyMap::rectify(
 	const mrpt::img::CImage& in_left_image,
 	const mrpt::img::CImage& in_right_image, mrpt::img::CImage& out_left_image,
 	mrpt::img::CImage& out_right_image) const
+{
+	rectify(
+		in_left_image, in_right_image, out_left_image, out_right_image,
+		TRemapOptions());
+}
+
+void CStereoRectifyMap::rectify(
+	const mrpt::img::CImage& in_left_image,
+	const mrpt::img::CImage& in_right_image, mrpt::img::CImage& out_left_image,
+	mrpt::img::CImage& out_right_image, const TRemapOptions& opts) const
 {
 	MRPT_START
+	if (!isSet())
+		THROW_EXCEPTION(
+			"Error: setFromCamParams() must be called prior to rectify().");
 
-#if MRPT_HAS_OPENCV
 	const uint32_t ncols = m_camera_params.leftCamera.ncols;
 	const uint32_t nrows = m_camera_params.leftCamera.nrows;
 
-	const CvSize trg_size = m_resize_output
-		? cvSize(m_resize_output_value.x, m_resize_output_value.y)
-		: cvSize(ncols, nrows);
-
-	out_left_image.resize(
-		trg_size.width, trg_size.height, in_left_image.getChannelCount());
-	out_right_image.resize(
-		trg_size.width, trg_size.height, in_left_image.getChannelCount());
-
-	const cv::Mat in_left = in_left_image.asCvMat<cv::Mat>(SHALLOW_COPY);
-	const cv::Mat in_right = in_right_image.asCvMat<cv::Mat>(SHALLOW_COPY);
-
-	cv::Mat& out_left = out_left_image.asCvMatRef();
-	cv::Mat& out_right = out_right_image.asCvMatRef();
-
-	do_rectify(
-		*this, in_left, in_right, out_left, out_right,
-		const_cast<int16_t*>(&m_dat_mapx_left[0]),
-		const_cast<int16_t*>(&m_dat_mapx_right[0]),
-		const_cast<uint16_t*>(&m_dat_mapy_left[0]),
-		const_cast<uint16_t*>(&m_dat_mapy_right[0]),
-		static_cast<int>(m_interpolation_method));
-
-#endif
+	detail::TFixedPointMap map;
+	map.cols = m_resize_output ? m_resize_output_value.x : ncols;
+	map.rows = m_resize_output ? m_resize_output_value.y : nrows;
+
+	detail::TRemapJob left, right;
+	left.in = &in_left_image;
+	left.out = &out_left_image;
+	left.map = map;
+	left.map.xy = m_dat_mapx_left.data();
+	left.map.frac = m_dat_mapy_left.data();
+	right.in = &in_right_image;
+	right.out = &out_right_image;
+	right.map = map;
+	right.map.xy = m_dat_mapx_right.data();
+	right.map.frac = m_dat_mapy_right.data();
+
+	detail::remapFixedPoint({left, right}, opts, m_interpolation_method);
 	MRPT_END
 }
 
@@ -383,3 +374,64 @@ void CStereoRectifyMap::setRectifyMapsFast(
 	right_x.swap(m_dat_mapx_right);
 	right_y.swap(m_dat_mapy_right);
 }
+
+bool CStereoRectifyMap::internal_loadCache(const std::string& file)
+{
+	if (!mrpt::system::fileExists(file)) return false;
+	try
+	{
+		mrpt::io::CFileInputStream f(file);
+		auto a = mrpt::serialization::archiveFrom(f);
+		std::string magic;
+		uint8_t version = 0;
+		a >> magic >> version;
+		if (magic != CACHE_MAGIC || version != CACHE_VERSION) return false;
+
+		std::vector<int16_t> xl, xr;
+		std::vector<uint16_t> yl, yr;
+		mrpt::img::TStereoCamera rectified;
+		CPose3DQuat rotLeft, rotRight;
+		a >> xl >> yl >> xr >> yr >> rectified >> rotLeft >> rotRight;
+		const size_t n =
+			size_t(rectified.leftCamera.ncols) * rectified.leftCamera.nrows;
+		if (xl.size() != 2 * n || xr.size() != 2 * n || yl.size() != n ||
+			yr.size() != n)
+			return false;
+
+		setRectifyMapsFast(xl, yl, xr, yr);
+		m_rectified_image_params = rectified;
+		m_rot_left = rotLeft;
+		m_rot_right = rotRight;
+		return true;
+	}
+	catch (const std::exception&)
+	{
+		return false;  // Corrupted file: compute the maps again
+	}
+}
+
+bool CStereoRectifyMap::internal_saveCache(const std::string& file) const
+{
+	try
+	{
+		if (!mrpt::system::directoryExists(m_cache_dir) &&
+			!mrpt::system::createDirectory(m_cache_dir))
+			return false;
+		// Written to a temporary file first, so other processes never read
+		// incomplete maps:
+		const std::string tmpFile = file + ".tmp";
+		{
+			mrpt::io::CFileOutputStream f;
+			if (!f.open(tmpFile)) return false;
+			auto a = mrpt::serialization::archiveFrom(f);
+			a << CACHE_MAGIC << CACHE_VERSION << m_dat_mapx_left
+			  << m_dat_mapy_left << m_dat_mapx_right << m_dat_mapy_right
+			  << m_rectified_image_params << m_rot_left << m_rot_right;
+		}
+		return mrpt::system::renameFile(tmpFile, file);
+	}
+	catch (const std::exception&)
+	{
+		return false;
+	}
+}
@@ -0,0 +1,78 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "vision-precomp.h"	 // Precompiled headers
+//
+#include <mrpt/config.h>
+
+#include "CTemplateMatcher_kernels.h"
+
+// ---------------------------------------------------------------------------
+//   This file contains the AVX2 version of the inner products of
+//   CTemplateMatcher. It is built with "-mavx2" (see DeclareMRPTLib.cmake),
+//   and only called if the CPU supports AVX2.
+// ---------------------------------------------------------------------------
+#if MRPT_ARCH_INTEL_COMPATIBLE
+#include <immintrin.h>
+#endif
+
+uint32_t mrpt::vision::detail::tm_dot_AVX2(
+	const uint8_t* a, const uint8_t* b, size_t n)
+{
+	size_t i = 0;
+	uint32_t s = 0;
+#if MRPT_ARCH_INTEL_COMPATIBLE
+	// Products of 16-bit values (in [0,255]) summed by pairs into 32 bits:
+	__m256i acc = _mm256_setzero_si256();
+	for (; i + 16 <= n; i += 16)
+	{
+		const __m256i va = _mm256_cvtepu8_epi16(
+			_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)));
+		const __m256i vb = _mm256_cvtepu8_epi16(
+			_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+		acc = _mm256_add_epi32(acc, _mm256_madd_epi16(va, vb));
+	}
+	__m128i s4 = _mm_add_epi32(
+		_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+	s4 = _mm_add_epi32(s4, _mm_shuffle_epi32(s4, _MM_SHUFFLE(1, 0, 3, 2)));
+	s4 = _mm_add_epi32(s4, _mm_shuffle_epi32(s4, _MM_SHUFFLE(2, 3, 0, 1)));
+	s = static_cast<uint32_t>(_mm_cvtsi128_si32(s4));
+#endif
+	return s + tm_dot_portable(a + i, b + i, n - i);
+}
+
+void mrpt::vision::detail::tm_row_corr_AVX2(
+	const uint8_t* img, const uint8_t* p, size_t w, size_t n, uint32_t* acc)
+{
+	size_t x = 0;
+#if MRPT_ARCH_INTEL_COMPATIBLE
+	// 16 positions at a time, all the patch pixels for each:
+	for (; x + 16 <= n; x += 16)
+	{
+		__m256i lo = _mm256_loadu_si256(reinterpret_cast<__m256i*>(acc + x));
+		__m256i hi =
+			_mm256_loadu_si256(reinterpret_cast<__m256i*>(acc + x + 8));
+		for (size_t k = 0; k < w; k++)
+		{
+			const __m256i v = _mm256_cvtepu8_epi16(_mm_loadu_si128(
+				reinterpret_cast<const __m128i*>(img + x + k)));
+			// At most 255*255, which fits in an unsigned 16-bit value:
+			const __m256i prod =
+				_mm256_mullo_epi16(v, _mm256_set1_epi16(p[k]));
+			lo = _mm256_add_epi32(
+				lo, _mm256_cvtepu16_epi32(_mm256_castsi256_si128(prod)));
+			hi = _mm256_add_epi32(
+				hi, _mm256_cvtepu16_epi32(_mm256_extracti128_si256(prod, 1)));
+		}
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(acc + x), lo);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(acc + x + 8), hi);
+	}
+#endif
+	if (x < n) tm_row_corr_portable(img + x, p, w, n - x, acc + x);
+}
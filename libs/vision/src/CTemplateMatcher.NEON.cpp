@@ -0,0 +1,68 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "vision-precomp.h"	 // Precompiled headers
+//
+#include <mrpt/config.h>
+
+#include "CTemplateMatcher_kernels.h"
+
+// ---------------------------------------------------------------------------
+//   This file contains the ARM NEON version of the inner products of
+//   CTemplateMatcher. NEON is always available in aarch64, so this file needs
+//   no special build flags.
+// ---------------------------------------------------------------------------
+#if defined(__ARM_NEON) || defined(__aarch64__)
+#define MRPT_VISION_BUILD_NEON 1
+#include <arm_neon.h>
+#else
+#define MRPT_VISION_BUILD_NEON 0
+#endif
+
+uint32_t mrpt::vision::detail::tm_dot_NEON(
+	const uint8_t* a, const uint8_t* b, size_t n)
+{
+	size_t i = 0;
+	uint32_t s = 0;
+#if MRPT_VISION_BUILD_NEON
+	uint32x4_t acc = vdupq_n_u32(0);
+	for (; i + 16 <= n; i += 16)
+	{
+		const uint8x16_t va = vld1q_u8(a + i), vb = vld1q_u8(b + i);
+		acc = vpadalq_u16(acc, vmull_u8(vget_low_u8(va), vget_low_u8(vb)));
+		acc = vpadalq_u16(acc, vmull_u8(vget_high_u8(va), vget_high_u8(vb)));
+	}
+	const uint64x2_t s2 = vpaddlq_u32(acc);
+	s = static_cast<uint32_t>(vgetq_lane_u64(s2, 0) + vgetq_lane_u64(s2, 1));
+#endif
+	return s + tm_dot_portable(a + i, b + i, n - i);
+}
+
+void mrpt::vision::detail::tm_row_corr_NEON(
+	const uint8_t* img, const uint8_t* p, size_t w, size_t n, uint32_t* acc)
+{
+	size_t x = 0;
+#if MRPT_VISION_BUILD_NEON
+	// 8 positions at a time, all the patch pixels for each:
+	for (; x + 8 <= n; x += 8)
+	{
+		uint32x4_t lo = vld1q_u32(acc + x), hi = vld1q_u32(acc + x + 4);
+		for (size_t k = 0; k < w; k++)
+		{
+			const uint16x8_t prod =
+				vmull_u8(vld1_u8(img + x + k), vdup_n_u8(p[k]));
+			lo = vaddw_u16(lo, vget_low_u16(prod));
+			hi = vaddw_u16(hi, vget_high_u16(prod));
+		}
+		vst1q_u32(acc + x, lo);
+		vst1q_u32(acc + x + 4, hi);
+	}
+#endif
+	if (x < n) tm_row_corr_portable(img + x, p, w, n - x, acc + x);
+}
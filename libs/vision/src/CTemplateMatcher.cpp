@@ -0,0 +1,302 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "vision-precomp.h"	 // Precompiled headers
+//
+#include <mrpt/core/cpu.h>
+#include <mrpt/vision/CTemplateMatcher.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <thread>
+
+#include "CTemplateMatcher_kernels.h"
+
+using namespace mrpt::vision;
+using namespace mrpt::vision::detail;
+using mrpt::img::CImage;
+
+namespace
+{
+struct TKernels
+{
+	tm_dot_t dot = &tm_dot_portable;
+	tm_row_corr_t rowCorr = &tm_row_corr_portable;
+};
+
+TKernels selectKernels(bool useSIMD)
+{
+	using mrpt::cpu::feature;
+	TKernels k;
+	if (useSIMD && mrpt::cpu::supports(feature::AVX2))
+	{
+		k.dot = &tm_dot_AVX2;
+		k.rowCorr = &tm_row_corr_AVX2;
+	}
+	else if (useSIMD && mrpt::cpu::supports(feature::NEON))
+	{
+		k.dot = &tm_dot_NEON;
+		k.rowCorr = &tm_row_corr_NEON;
+	}
+	return k;
+}
+
+// Returns `img` itself, or its grayscale version (into `buf`) if it is color
+const CImage& asGray(const CImage& img, CImage& buf)
+{
+	ASSERTMSG_(
+		img.getPixelDepth() == mrpt::img::PixelDepth::D8U,
+		"Only 8-bit images are supported");
+	if (!img.isColor()) return img;
+	img.grayscale(buf);
+	return buf;
+}
+
+// Sum of the pixels and of their squares of a patch
+void patchSums(
+	const CImage& p, const TKernels& k, uint64_t& sum, uint64_t& sqSum)
+{
+	sum = sqSum = 0;
+	const size_t w = p.getWidth();
+	for (size_t y = 0; y < p.getHeight(); y++)
+	{
+		const uint8_t* row = p.ptrLine<uint8_t>(y);
+		for (size_t x = 0; x < w; x++)
+			sum += row[x];
+		sqSum += k.dot(row, row, w);
+	}
+}
+
+// Normalized correlation from the sums (over N pixels) of I*T, I, I^2, T, T^2
+float nccScore(
+	CTemplateMatcher::TMethod method, double N, double sIT, double sI,
+	double sI2, double sT, double sT2)
+{
+	double num = sIT, den = sI2 * sT2;
+	if (method == CTemplateMatcher::nccZeroMean)
+	{
+		num -= sI * sT / N;
+		den = (sI2 - sI * sI / N) * (sT2 - sT * sT / N);
+	}
+	if (!(den > 0)) return 0;
+	return static_cast<float>(std::clamp(num / std::sqrt(den), -1.0, 1.0));
+}
+}  // namespace
+
+void CTemplateMatcher::setImage(const CImage& img)
+{
+	MRPT_START
+	CImage gray;
+	m_img = asGray(img, gray).makeShallowCopy();
+
+	const size_t W = m_img.getWidth(), H = m_img.getHeight();
+	ASSERTMSG_(
+		W * H * 255ULL <= std::numeric_limits<uint32_t>::max(),
+		"Image too large");
+
+	// Integral images, with a first row and column of zeros:
+	m_sum.assign((W + 1) * (H + 1), 0);
+	m_sqSum.assign((W + 1) * (H + 1), 0);
+	for (size_t y = 0; y < H; y++)
+	{
+		const uint8_t* row = m_img.ptrLine<uint8_t>(y);
+		uint32_t s = 0;
+		uint64_t s2 = 0;
+		const size_t i = (y + 1) * (W + 1) + 1, iPrev = y * (W + 1) + 1;
+		for (size_t x = 0; x < W; x++)
+		{
+			s += row[x];
+			s2 += static_cast<uint32_t>(row[x]) * row[x];
+			m_sum[i + x] = m_sum[iPrev + x] + s;
+			m_sqSum[i + x] = m_sqSum[iPrev + x] + s2;
+		}
+	}
+	MRPT_END
+}
+
+CTemplateMatcher::TMatch CTemplateMatcher::internal_search(
+	const CImage& patch, int x0, int y0, int nx, int ny, float* out) const
+{
+	const TKernels k = selectKernels(options.useSIMD);
+	const size_t pw = patch.getWidth(), ph = patch.getHeight();
+	const size_t W1 = m_img.getWidth() + 1;
+	const double N = static_cast<double>(pw * ph);
+
+	uint64_t sT, sT2;
+	patchSums(patch, k, sT, sT2);
+
+	TMatch best;
+	std::vector<uint32_t> acc(nx);
+	for (int y = 0; y < ny; y++)
+	{
+		// Inner products for all the positions in this row:
+		std::fill(acc.begin(), acc.end(), 0);
+		for (size_t r = 0; r < ph; r++)
+			k.rowCorr(
+				m_img.ptrLine<uint8_t>(y0 + y + r) + x0,
+				patch.ptrLine<uint8_t>(r), pw, nx, acc.data());
+
+		// Sums over the window, from the integral images:
+		const size_t top = (y0 + y) * W1 + x0, bottom = top + ph * W1;
+		for (int x = 0; x < nx; x++)
+		{
+			const size_t a = top + x, b = a + pw, c = bottom + x, d = c + pw;
+			const double sI =
+				double(m_sum[d]) + m_sum[a] - m_sum[b] - m_sum[c];
+			const double sI2 =
+				double(m_sqSum[d]) + m_sqSum[a] - m_sqSum[b] - m_sqSum[c];
+			const float score = nccScore(
+				options.method, N, acc[x], sI, sI2, double(sT), double(sT2));
+			if (out) *out++ = score;
+			// The first maximum in row-major order, as cv::minMaxLoc():
+			if (best.x < 0 || score > best.score)
+			{
+				best.x = x;
+				best.y = y;
+				best.score = score;
+			}
+		}
+	}
+	return best;
+}
+
+namespace
+{
+// The search window of openCV_cross_correlation(), clipped to the image.
+// Returns false if the patch does not fit in it.
+bool searchWindow(
+	const CTemplateMatcher::TSearch& s, int W, int H, int pw, int ph,
+	int& x0, int& y0, int& nx, int& ny)
+{
+	x0 = s.x_ini;
+	y0 = s.y_ini;
+	int xs = s.x_size, ys = s.y_size;
+	if (x0 < 0 || y0 < 0 || xs < 0 || ys < 0)
+	{
+		x0 = y0 = 0;
+		xs = W - pw;
+		ys = H - ph;
+	}
+	if (x0 + xs + pw > W) xs -= x0 + xs + pw - W;
+	if (y0 + ys + ph > H) ys -= y0 + ys + ph - H;
+	nx = xs + 1;
+	ny = ys + 1;
+	return pw > 0 && ph > 0 && xs >= 0 && ys >= 0;
+}
+}  // namespace
+
+CTemplateMatcher::TMatch CTemplateMatcher::match(const TSearch& search) const
+{
+	MRPT_START
+	ASSERTMSG_(!m_sum.empty(), "setImage() must be called first");
+	ASSERT_(search.patch);
+
+	CImage buf;
+	const CImage& patch = asGray(*search.patch, buf);
+	const int pw = patch.getWidth(), ph = patch.getHeight();
+	int x0, y0, nx, ny;
+	if (!searchWindow(
+			search, m_img.getWidth(), m_img.getHeight(), pw, ph, x0, y0, nx,
+			ny))
+		return TMatch();
+
+	TMatch m = internal_search(patch, x0, y0, nx, ny, nullptr);
+	m.x += x0 + ((pw - 1) >> 1);
+	m.y += y0 + ((ph - 1) >> 1);
+	return m;
+	MRPT_END
+}
+
+void CTemplateMatcher::internal_forEach(
+	size_t n, const std::function<void(size_t)>& fn) const
+{
+	size_t nThreads = options.numThreads;
+	if (!nThreads)
+		nThreads = std::max(1U, std::thread::hardware_concurrency());
+
+	if (nThreads <= 1 ||
+		n < std::max<size_t>(2, options.minSearchesForParallel))
+	{
+		for (size_t i = 0; i < n; i++)
+			fn(i);
+		return;
+	}
+	// The calling thread also runs tasks:
+	if (!m_threadPool || m_threadPool->size() != nThreads - 1)
+		m_threadPool = std::make_shared<mrpt::WorkerThreadsPool>(
+			nThreads - 1, mrpt::WorkerThreadsPool::POLICY_FIFO,
+			"CTemplateMatcher");
+	m_threadPool->parallel_for(0, n, 1, fn);
+}
+
+void CTemplateMatcher::match(
+	const std::vector<TSearch>& searches, std::vector<TMatch>& matches) const
+{
+	MRPT_START
+	matches.resize(searches.size());
+	internal_forEach(
+		searches.size(), [&](size_t i) { matches[i] = match(searches[i]); });
+	MRPT_END
+}
+
+void CTemplateMatcher::correlationMap(
+	const TSearch& search, mrpt::math::CMatrixFloat& out) const
+{
+	MRPT_START
+	ASSERTMSG_(!m_sum.empty(), "setImage() must be called first");
+	ASSERT_(search.patch);
+
+	CImage buf;
+	const CImage& patch = asGray(*search.patch, buf);
+	int x0, y0, nx, ny;
+	const bool fits = searchWindow(
+		search, m_img.getWidth(), m_img.getHeight(), patch.getWidth(),
+		patch.getHeight(), x0, y0, nx, ny);
+	ASSERTMSG_(fits, "The patch does not fit in the search window");
+
+	out.setSize(ny, nx);
+	internal_search(patch, x0, y0, nx, ny, &out(0, 0));
+	MRPT_END
+}
+
+float CTemplateMatcher::patchCorrelation(
+	const CImage& a, const CImage& b, TMethod method, bool useSIMD)
+{
+	MRPT_START
+	ASSERT_(!a.isColor() && !b.isColor());
+	ASSERT_(a.getPixelDepth() == mrpt::img::PixelDepth::D8U);
+	ASSERT_(b.getPixelDepth() == mrpt::img::PixelDepth::D8U);
+	ASSERT_EQUAL_(a.getWidth(), b.getWidth());
+	ASSERT_EQUAL_(a.getHeight(), b.getHeight());
+
+	static const TKernels kSIMD = selectKernels(true), kPortable;
+	const TKernels& k = useSIMD ? kSIMD : kPortable;
+
+	const size_t w = a.getWidth();
+	uint64_t sAB = 0, sA2 = 0, sB2 = 0, sA = 0, sB = 0;
+	for (size_t y = 0; y < a.getHeight(); y++)
+	{
+		const uint8_t* ra = a.ptrLine<uint8_t>(y);
+		const uint8_t* rb = b.ptrLine<uint8_t>(y);
+		sAB += k.dot(ra, rb, w);
+		sA2 += k.dot(ra, ra, w);
+		sB2 += k.dot(rb, rb, w);
+		if (method == nccZeroMean)
+			for (size_t x = 0; x < w; x++)
+			{
+				sA += ra[x];
+				sB += rb[x];
+			}
+	}
+	return nccScore(
+		method, double(w * a.getHeight()), double(sAB), double(sA),
+		double(sA2), double(sB), double(sB2));
+	MRPT_END
+}
@@ -0,0 +1,56 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mrpt::vision::detail
+{
+/** Sum of `a[i] * b[i]` for i in [0,n) (n < 2^15) */
+using tm_dot_t = uint32_t (*)(const uint8_t* a, const uint8_t* b, size_t n);
+
+/** Correlation of one row of the patch `p` (`w` pixels) along one row of the
+ * image `img`: `acc[x] += sum_k img[x + k] * p[k]` for x in [0,n), k in
+ * [0,w). So `img[0..n+w-2]` must be valid. */
+using tm_row_corr_t = void (*)(
+	const uint8_t* img, const uint8_t* p, size_t w, size_t n, uint32_t* acc);
+
+inline uint32_t tm_dot_portable(const uint8_t* a, const uint8_t* b, size_t n)
+{
+	uint32_t s = 0;
+	for (size_t i = 0; i < n; i++)
+		s += static_cast<uint32_t>(a[i]) * b[i];
+	return s;
+}
+
+inline void tm_row_corr_portable(
+	const uint8_t* img, const uint8_t* p, size_t w, size_t n, uint32_t* acc)
+{
+	for (size_t k = 0; k < w; k++)
+	{
+		const uint32_t pk = p[k];
+		for (size_t x = 0; x < n; x++)
+			acc[x] += pk * img[x + k];
+	}
+}
+
+/** Only call it if mrpt::cpu::supports(mrpt::cpu::feature::AVX2) */
+uint32_t tm_dot_AVX2(const uint8_t* a, const uint8_t* b, size_t n);
+/** Only call it if mrpt::cpu::supports(mrpt::cpu::feature::AVX2) */
+void tm_row_corr_AVX2(
+	const uint8_t* img, const uint8_t* p, size_t w, size_t n, uint32_t* acc);
+
+/** Only call it if mrpt::cpu::supports(mrpt::cpu::feature::NEON) */
+uint32_t tm_dot_NEON(const uint8_t* a, const uint8_t* b, size_t n);
+/** Only call it if mrpt::cpu::supports(mrpt::cpu::feature::NEON) */
+void tm_row_corr_NEON(
+	const uint8_t* img, const uint8_t* p, size_t w, size_t n, uint32_t* acc);
+
+}  // namespace mrpt::vision::detail
@@ -0,0 +1,176 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/core/cpu.h>
+#include <mrpt/vision/CTemplateMatcher.h>
+#include <mrpt/vision/utils.h>
+
+#include <cmath>
+#include <random>
+
+#include "CTemplateMatcher_kernels.h"
+
+using mrpt::img::CImage;
+using mrpt::vision::CTemplateMatcher;
+
+TEST(CTemplateMatcher, kernelsMatchPortable)
+{
+	using namespace mrpt::vision::detail;
+	std::mt19937 rng(123);
+	std::uniform_int_distribution<int> px(0, 255);
+	std::vector<uint8_t> img(200), p(40);
+	for (auto& v : img)
+		v = px(rng);
+	for (auto& v : p)
+		v = px(rng);
+
+	const bool avx2 = mrpt::cpu::supports(mrpt::cpu::feature::AVX2);
+	const bool neon = mrpt::cpu::supports(mrpt::cpu::feature::NEON);
+	if (!avx2 && !neon) return;
+
+	for (size_t w : {1, 7, 16, 33, 40})
+	{
+		const auto dot = avx2 ? &tm_dot_AVX2 : &tm_dot_NEON;
+		EXPECT_EQ(
+			dot(img.data(), p.data(), w),
+			tm_dot_portable(img.data(), p.data(), w));
+
+		const auto corr = avx2 ? &tm_row_corr_AVX2 : &tm_row_corr_NEON;
+		for (size_t n : {1, 5, 16, 31, 100})
+		{
+			std::vector<uint32_t> a(n, 7), b(n, 7);
+			corr(img.data(), p.data(), w, n, a.data());
+			tm_row_corr_portable(img.data(), p.data(), w, n, b.data());
+			EXPECT_EQ(a, b) << "w=" << w << " n=" << n;
+		}
+	}
+}
+
+#if MRPT_HAS_OPENCV
+
+namespace
+{
+CImage randomImage(int w, int h, unsigned seed)
+{
+	std::mt19937 rng(seed);
+	std::uniform_int_distribution<int> px(0, 255);
+	CImage img(w, h, mrpt::img::CH_GRAY);
+	for (int y = 0; y < h; y++)
+		for (int x = 0; x < w; x++)
+			*img(x, y) = px(rng);
+	return img;
+}
+
+double naiveNCC(
+	const CImage& img, const CImage& p, int x0, int y0, bool zeroMean)
+{
+	const int w = p.getWidth(), h = p.getHeight();
+	double mI = 0, mT = 0;
+	if (zeroMean)
+	{
+		for (int y = 0; y < h; y++)
+			for (int x = 0; x < w; x++)
+			{
+				mI += *img(x0 + x, y0 + y);
+				mT += *p(x, y);
+			}
+		mI /= w * h;
+		mT /= w * h;
+	}
+	double sIT = 0, sI2 = 0, sT2 = 0;
+	for (int y = 0; y < h; y++)
+		for (int x = 0; x < w; x++)
+		{
+			const double i = *img(x0 + x, y0 + y) - mI, t = *p(x, y) - mT;
+			sIT += i * t;
+			sI2 += i * i;
+			sT2 += t * t;
+		}
+	return sIT / std::sqrt(sI2 * sT2);
+}
+}  // namespace
+
+TEST(CTemplateMatcher, correlationMapMatchesNaive)
+{
+	const CImage img = randomImage(80, 60, 1), patch = randomImage(11, 9, 2);
+	for (auto method :
+		 {CTemplateMatcher::nccRaw, CTemplateMatcher::nccZeroMean})
+	{
+		CTemplateMatcher m;
+		m.options.method = method;
+		m.setImage(img);
+
+		mrpt::math::CMatrixFloat map;
+		m.correlationMap({&patch, 5, 3, 30, 20}, map);
+		ASSERT_EQ(map.rows(), 21);
+		ASSERT_EQ(map.cols(), 31);
+		for (int y = 0; y < map.rows(); y++)
+			for (int x = 0; x < map.cols(); x++)
+				EXPECT_NEAR(
+					map(y, x),
+					naiveNCC(
+						img, patch, 5 + x, 3 + y,
+						method == CTemplateMatcher::nccZeroMean),
+					1e-5);
+	}
+}
+
+TEST(CTemplateMatcher, findsPatchesInBatch)
+{
+	const CImage img = randomImage(160, 120, 3);
+	// Patches cut from known positions of the image:
+	std::vector<CImage> patches(40);
+	std::vector<CTemplateMatcher::TSearch> searches;
+	std::mt19937 rng(4);
+	std::uniform_int_distribution<int> px(20, 120), py(20, 90);
+	std::vector<std::pair<int, int>> truth;
+	for (auto& p : patches)
+	{
+		const int x = px(rng), y = py(rng);
+		img.extract_patch(p, x, y, 9, 9);
+		truth.emplace_back(x + 4, y + 4);
+		searches.emplace_back(&p, x - 10, y - 8, 20, 16);
+	}
+
+	CTemplateMatcher m;
+	m.options.numThreads = 4;
+	m.setImage(img);
+	std::vector<CTemplateMatcher::TMatch> matches;
+	m.match(searches, matches);
+	ASSERT_EQ(matches.size(), patches.size());
+	for (size_t i = 0; i < matches.size(); i++)
+	{
+		EXPECT_EQ(matches[i].x, truth[i].first);
+		EXPECT_EQ(matches[i].y, truth[i].second);
+		EXPECT_NEAR(matches[i].score, 1.0f, 1e-5f);
+
+		// Same result as a single search, and as the OpenCV-based one:
+		const auto m1 = m.match(searches[i]);
+		EXPECT_EQ(m1.x, matches[i].x);
+		EXPECT_EQ(m1.y, matches[i].y);
+
+		size_t cx, cy;
+		double cv;
+		mrpt::vision::openCV_cross_correlation(
+			img, patches[i], cx, cy, cv, searches[i].x_ini, searches[i].y_ini,
+			searches[i].x_size, searches[i].y_size);
+		EXPECT_EQ(int(cx), matches[i].x);
+		EXPECT_EQ(int(cy), matches[i].y);
+	}
+
+	// Patch-to-patch, with and without SIMD:
+	const float c1 = CTemplateMatcher::patchCorrelation(patches[0], patches[1]);
+	const float c2 = CTemplateMatcher::patchCorrelation(
+		patches[0], patches[1], CTemplateMatcher::nccRaw, false);
+	EXPECT_NEAR(c1, c2, 1e-6f);
+	EXPECT_NEAR(c1, naiveNCC(patches[0], patches[1], 0, 0, false), 1e-5);
+}
+
+#endif
@@ -9,8 +9,15 @@
 
 #include "vision-precomp.h"	 // Precompiled headers
 //
+#include <mrpt/io/CFileInputStream.h>
+#include <mrpt/io/CFileOutputStream.h>
+#include <mrpt/io/CMemoryStream.h>
+#include <mrpt/serialization/CArchive.h>
+#include <mrpt/system/filesystem.h>
 #include <mrpt/vision/CUndistortMap.h>
 
+#include "remap_fixed_point.h"
+
 // Universal include for all versions of OpenCV
 #include <mrpt/3rdparty/do_opencv_includes.h>
 
@@ -18,6 +25,10 @@ using namespace mrpt;
 using namespace mrpt::vision;
 using namespace mrpt::img;
 
+// Version of the format of the cached maps:
+static const std::string CACHE_MAGIC = "MRPT_UNDISTORT_MAP";
+static constexpr uint8_t CACHE_VERSION = 1;
+
 // Ctor: Leave all vectors empty
 CUndistortMap::CUndistortMap() = default;
 /** Prepares the mapping from the distortion parameters of a camera.
@@ -29,6 +40,19 @@ void CUndistortMap::setFromCamParams(const mrpt::img::TCamera& campar)
 #if MRPT_HAS_OPENCV
 	m_camera_params = campar;
 
+	std::string cacheFile;
+	if (!m_cache_dir.empty())
+	{
+		mrpt::io::CMemoryStream buf;
+		auto a = mrpt::serialization::archiveFrom(buf);
+		a << CACHE_MAGIC << CACHE_VERSION << campar;
+		const auto* p = static_cast<const uint8_t*>(buf.getRawBufferData());
+		cacheFile = detail::remapCacheFile(
+			m_cache_dir, "undistort",
+			std::vector<uint8_t>(p, p + buf.getTotalBytesCount()));
+		if (internal_loadCache(cacheFile)) return;
+	}
+
 	// Convert to opencv's format:
 	double aux1[3][3], aux2[1][5];
 	for (int i = 0; i < 3; i++)
@@ -48,66 +72,95 @@ void CUndistortMap::setFromCamParams(const mrpt::img::TCamera& campar)
 
 	cv::initUndistortRectifyMap(
 		inMat, distM, cv::Mat(), inMat, mapx.size(), mapx.type(), mapx, mapy);
+
+	if (!cacheFile.empty()) internal_saveCache(cacheFile);
 #else
 	THROW_EXCEPTION("MRPT built without OpenCV >=2.0.0!");
 #endif
 	MRPT_END
 }
 
-/** Undistort the input image and saves the result in-place- \a
- * setFromCamParams() must have been set prior to calling this.
- */
 void CUndistortMap::undistort(
 	const mrpt::img::CImage& in_img, mrpt::img::CImage& out_img) const
+{
+	undistort(in_img, out_img, TRemapOptions());
+}
+
+void CUndistortMap::undistort(
+	const mrpt::img::CImage& in_img, mrpt::img::CImage& out_img,
+	const TRemapOptions& opts) const
 {
 	MRPT_START
 	if (m_dat_mapx.empty())
 		THROW_EXCEPTION(
 			"Error: setFromCamParams() must be called prior to undistort().");
 
-#if MRPT_HAS_OPENCV
-	using namespace cv;
-	Mat mapx(
-		m_camera_params.nrows, m_camera_params.ncols, CV_16SC2,
-		const_cast<int16_t*>(&m_dat_mapx[0]));
-	Mat mapy(
-		m_camera_params.nrows, m_camera_params.ncols, CV_16UC1,
-		const_cast<uint16_t*>(&m_dat_mapy[0]));
-
-	out_img.resize(
-		in_img.getWidth(), in_img.getHeight(), in_img.getChannelCount());
-
-	cv::remap(
-		in_img.asCvMat<Mat>(SHALLOW_COPY), out_img.asCvMat<Mat>(SHALLOW_COPY),
-		mapx, mapy, INTER_LINEAR);
-#endif
+	detail::TRemapJob job;
+	job.in = &in_img;
+	job.out = &out_img;
+	job.map.xy = m_dat_mapx.data();
+	job.map.frac = m_dat_mapy.data();
+	job.map.cols = m_camera_params.ncols;
+	job.map.rows = m_camera_params.nrows;
+	detail::remapFixedPoint({job}, opts, IMG_INTERP_LINEAR);
 	MRPT_END
 }
 
-/** Undistort the input image and saves the result in-place- \a
- * setFromCamParams() must have been set prior to calling this.
- */
 void CUndistortMap::undistort(mrpt::img::CImage& in_out_img) const
 {
 	MRPT_START
-	if (m_dat_mapx.empty())
-		THROW_EXCEPTION(
-			"Error: setFromCamParams() must be called prior to undistort().");
-
-#if MRPT_HAS_OPENCV
-	cv::Mat mapx(
-		m_camera_params.nrows, m_camera_params.ncols, CV_16SC2,
-		const_cast<int16_t*>(&m_dat_mapx[0]));
-	cv::Mat mapy(
-		m_camera_params.nrows, m_camera_params.ncols, CV_16UC1,
-		const_cast<uint16_t*>(&m_dat_mapy[0]));
-
-	cv::Mat in = in_out_img.asCvMat<cv::Mat>(SHALLOW_COPY);
-	cv::Mat out(in.size(), in.type());
+	CImage out;
+	undistort(in_out_img, out);
+	in_out_img = std::move(out);
+	MRPT_END
+}
 
-	cv::remap(in, out, mapx, mapy, cv::INTER_LINEAR);
+bool CUndistortMap::internal_loadCache(const std::string& file)
+{
+	if (!mrpt::system::fileExists(file)) return false;
+	try
+	{
+		mrpt::io::CFileInputStream f(file);
+		auto a = mrpt::serialization::archiveFrom(f);
+		std::string magic;
+		uint8_t version = 0;
+		a >> magic >> version;
+		if (magic != CACHE_MAGIC || version != CACHE_VERSION) return false;
+		std::vector<int16_t> mapx;
+		std::vector<uint16_t> mapy;
+		a >> mapx >> mapy;
+		const size_t n = size_t(m_camera_params.ncols) * m_camera_params.nrows;
+		if (mapx.size() != 2 * n || mapy.size() != n) return false;
+		m_dat_mapx.swap(mapx);
+		m_dat_mapy.swap(mapy);
+		return true;
+	}
+	catch (const std::exception&)
+	{
+		return false;  // Corrupted file: compute the maps again
+	}
+}
 
-	in_out_img = CImage(out, SHALLOW_COPY);
-#endif
-	MRPT_END
+bool CUndistortMap::internal_saveCache(const std::string& file) const
+{
+	try
+	{
+		if (!mrpt::system::directoryExists(m_cache_dir) &&
+			!mrpt::system::createDirectory(m_cache_dir))
+			return false;
+		// Written to a temporary file first, so other processes never read
+		// incomplete maps:
+		const std::string tmpFile = file + ".tmp";
+		{
+			mrpt::io::CFileOutputStream f;
+			if (!f.open(tmpFile)) return false;
+			auto a = mrpt::serialization::archiveFrom(f);
+			a << CACHE_MAGIC << CACHE_VERSION << m_dat_mapx << m_dat_mapy;
+		}
+		return mrpt::system::renameFile(tmpFile, file);
+	}
+	catch (const std::exception&)
+	{
+		return false;
+	}
 }
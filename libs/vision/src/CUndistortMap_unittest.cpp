@@ -0,0 +1,137 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/config.h>
+#include <mrpt/system/CDirectoryExplorer.h>
+#include <mrpt/system/filesystem.h>
+#include <mrpt/vision/CUndistortMap.h>
+
+// Universal include for all versions of OpenCV
+#include <mrpt/3rdparty/do_opencv_includes.h>
+
+#include <random>
+
+using mrpt::img::CImage;
+using mrpt::vision::CUndistortMap;
+using mrpt::vision::TRemapOptions;
+
+#if MRPT_HAS_OPENCV
+namespace
+{
+mrpt::img::TCamera testCamera()
+{
+	mrpt::img::TCamera cam;
+	cam.ncols = 333;
+	cam.nrows = 250;
+	cam.setIntrinsicParamsFromValues(300, 310, 170, 120);
+	cam.distortion = mrpt::img::DistortionModel::plumb_bob;
+	cam.dist[0] = -0.25;
+	cam.dist[1] = 0.08;
+	cam.dist[2] = 0.001;
+	cam.dist[3] = -0.002;
+	return cam;
+}
+
+CImage randomImage(unsigned int w, unsigned int h, unsigned int seed)
+{
+	std::mt19937 rng(seed);
+	std::uniform_int_distribution<int> pix(0, 255);
+	CImage img(w, h, mrpt::img::CH_RGB);
+	for (unsigned int y = 0; y < h; y++)
+	{
+		auto* row = img.ptrLine<uint8_t>(y);
+		for (unsigned int x = 0; x < 3 * w; x++)
+			row[x] = static_cast<uint8_t>(pix(rng));
+	}
+	return img;
+}
+
+int maxAbsDiff(const cv::Mat& a, const cv::Mat& b)
+{
+	EXPECT_EQ(a.size(), b.size());
+	EXPECT_EQ(a.type(), b.type());
+	return static_cast<int>(cv::norm(a, b, cv::NORM_INF));
+}
+}  // namespace
+
+TEST(CUndistortMap, sameAsOpenCVRemap)
+{
+	const auto cam = testCamera();
+	CUndistortMap unmap;
+	unmap.setFromCamParams(cam);
+
+	const CImage img = randomImage(cam.ncols, cam.nrows, 1);
+	CImage out;
+	unmap.undistort(img, out);
+
+	// Reference: OpenCV with the same fixed-point maps
+	cv::Mat K(3, 3, CV_64F), D(1, 5, CV_64F), map1, map2, ref;
+	for (int i = 0; i < 3; i++)
+		for (int j = 0; j < 3; j++)
+			K.at<double>(i, j) = cam.intrinsicParams(i, j);
+	for (int i = 0; i < 5; i++)
+		D.at<double>(0, i) = cam.dist[i];
+	cv::initUndistortRectifyMap(
+		K, D, cv::Mat(), K, cv::Size(cam.ncols, cam.nrows), CV_16SC2, map1,
+		map2);
+	cv::remap(
+		img.asCvMatRef(), ref, map1, map2, cv::INTER_LINEAR,
+		cv::BORDER_CONSTANT, cv::Scalar::all(0));
+	EXPECT_LE(maxAbsDiff(out.asCvMatRef(), ref), 1);
+
+	// Fused grayscale and downscaling, multithreaded:
+	TRemapOptions opts;
+	opts.grayscale = true;
+	opts.halfResolution = true;
+	opts.numThreads = 4;
+	opts.minPixelsForParallel = 0;
+	CImage fused;
+	unmap.undistort(img, fused, opts);
+
+	cv::Mat refGray;
+	cv::cvtColor(ref, refGray, cv::COLOR_BGR2GRAY);
+	cv::resize(
+		refGray, refGray, cv::Size(cam.ncols / 2, cam.nrows / 2), 0, 0,
+		cv::INTER_AREA);
+	EXPECT_FALSE(fused.isColor());
+	EXPECT_LE(maxAbsDiff(fused.asCvMatRef(), refGray), 1);
+
+	// Same results in a single thread:
+	opts.numThreads = 1;
+	CImage serial;
+	unmap.undistort(img, serial, opts);
+	EXPECT_EQ(maxAbsDiff(fused.asCvMatRef(), serial.asCvMatRef()), 0);
+}
+
+TEST(CUndistortMap, mapCache)
+{
+	const auto cam = testCamera();
+	const std::string dir = mrpt::system::getTempFileName() + "_remap_cache";
+
+	CUndistortMap computed, loaded;
+	computed.setMapCacheDirectory(dir);
+	computed.setFromCamParams(cam);
+	const auto files =
+		mrpt::system::CDirectoryExplorer::explore(dir, FILE_ATTRIB_ARCHIVE);
+	ASSERT_EQ(files.size(), 1U);
+
+	loaded.setMapCacheDirectory(dir);
+	loaded.setFromCamParams(cam);
+	EXPECT_TRUE(loaded.isSet());
+
+	const CImage img = randomImage(cam.ncols, cam.nrows, 2);
+	CImage out1, out2;
+	computed.undistort(img, out1);
+	loaded.undistort(img, out2);
+	EXPECT_EQ(maxAbsDiff(out1.asCvMatRef(), out2.asCvMatRef()), 0);
+
+	mrpt::system::deleteFilesInDirectory(dir, true);
+}
+#endif
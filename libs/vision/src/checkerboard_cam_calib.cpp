@@ -63,6 +63,25 @@ bool mrpt::vision::checkerBoardCameraCalibration(
 	bool normalize_image, double* out_MSE,
 	[[maybe_unused]] bool skipDrawDetectedImgs,
 	bool useScaramuzzaAlternativeDetector)
+{
+	TChessboardCornersOptions opts;
+	opts.normalize_image = normalize_image;
+	opts.useScaramuzzaMethod = useScaramuzzaAlternativeDetector;
+	return checkerBoardCameraCalibration(
+		images, check_size_x, check_size_y, check_squares_length_X_meters,
+		check_squares_length_Y_meters, out_camera_params, opts, false,
+		out_MSE);
+}
+
+/* -------------------------------------------------------
+				checkerBoardCameraCalibration
+   ------------------------------------------------------- */
+bool mrpt::vision::checkerBoardCameraCalibration(
+	TCalibrationImageList& images, unsigned int check_size_x,
+	unsigned int check_size_y, double check_squares_length_X_meters,
+	double check_squares_length_Y_meters, mrpt::img::TCamera& out_camera_params,
+	const TChessboardCornersOptions& detectionOptions, bool incremental,
+	double* out_MSE)
 {
 #if MRPT_HAS_OPENCV
 	try
@@ -79,7 +98,6 @@ bool mrpt::vision::checkerBoardCameraCalibration(
 		}
 
 		const unsigned CORNERS_COUNT = check_size_x * check_size_y;
-		const CvSize check_size = cvSize(check_size_x, check_size_y);
 
 		// Fill the pattern of expected pattern points only once out of the
 		// loop:
@@ -110,7 +128,9 @@ bool mrpt::vision::checkerBoardCameraCalibration(
 			dat.projectedPoints_distorted.clear();	// Clear reprojected points.
 			dat.projectedPoints_undistorted.clear();
 
-			// Skip if images are marked as "externalStorage":
+			// Skip if images are marked as "externalStorage", or were already
+			// processed in incremental mode:
+			if (incremental && dat.corners_searched) continue;
 			if (!dat.img_original.isExternallyStored() &&
 				!mrpt::system::extractFileExtension(it->first).empty())
 			{
@@ -123,148 +143,137 @@ bool mrpt::vision::checkerBoardCameraCalibration(
 			}
 		}
 
-		// For each image, find checkerboard corners:
-		// -----------------------------------------------
-		vector<vector<cv::Point3f>>
-			objectPoints;  // final container for detected stuff
-		vector<vector<cv::Point2f>>
-			imagePoints;  // final container for detected stuff
-
-		unsigned int valid_detected_imgs = 0;
-		vector<string> pointsIdx2imageFile;
+		// All the images must have the same size:
+		// -------------------------------------------
 		cv::Size imgSize(0, 0);
-
-		unsigned int i;
-		for (i = 0, it = images.begin(); it != images.end(); it++, i++)
+		for (it = images.begin(); it != images.end(); ++it)
 		{
-			TImageCalibData& dat = it->second;
-
-			// Make grayscale version:
-			const CImage img_gray(
-				dat.img_original, FAST_REF_OR_CONVERT_TO_GRAY);
-
-			if (!i)
+			const auto sz = it->second.img_original.getSize();
+			if (it == images.begin())
 			{
-				imgSize = cv::Size(img_gray.getWidth(), img_gray.getHeight());
+				imgSize = cv::Size(sz.x, sz.y);
 				out_camera_params.ncols = imgSize.width;
 				out_camera_params.nrows = imgSize.height;
 			}
-			else
-			{
-				if (imgSize.height != (int)img_gray.getHeight() ||
-					imgSize.width != (int)img_gray.getWidth())
-				{
-					std::cout << "ERROR: All the images must have the same size"
-							  << std::endl;
-					return false;
-				}
-			}
-
-			// Try with expanded versions of the image if it fails to detect the
-			// checkerboard:
-			unsigned corners_count;
-			bool corners_found = false;
-
-			corners_count = CORNERS_COUNT;
-
-			vector<cv::Point2f> this_img_pts(
-				CORNERS_COUNT);	 // Temporary buffer for points, to be added if
-			// the points pass the checks.
-
-			dat.detected_corners.clear();
-
-			// Do detection (this includes the "refine corners" with
-			// cvFindCornerSubPix):
-			vector<TPixelCoordf> detectedCoords;
-			corners_found = mrpt::vision::findChessboardCorners(
-				img_gray, detectedCoords, check_size_x, check_size_y,
-				normalize_image,  // normalize_image
-				useScaramuzzaAlternativeDetector);
-
-			corners_count = detectedCoords.size();
-
-			// Copy the data into the overall array of coords:
-			ASSERT_(detectedCoords.size() <= CORNERS_COUNT);
-			for (size_t p = 0; p < detectedCoords.size(); p++)
+			else if (imgSize.height != sz.y || imgSize.width != sz.x)
 			{
-				this_img_pts[p].x = detectedCoords[p].x;
-				this_img_pts[p].y = detectedCoords[p].y;
+				std::cout << "ERROR: All the images must have the same size"
+						  << std::endl;
+				return false;
 			}
+		}
 
-			if (corners_found && corners_count != CORNERS_COUNT)
-				corners_found = false;
+		// For each image (not processed yet, if incremental), find
+		// checkerboard corners, in parallel (this includes the "refine
+		// corners" with cornerSubPix):
+		// -----------------------------------------------
+		vector<const CImage*> imgsToSearch;
+		vector<TCalibrationImageList::iterator> itsToSearch;
+		for (it = images.begin(); it != images.end(); ++it)
+		{
+			if (incremental && it->second.corners_searched) continue;
+			imgsToSearch.push_back(&it->second.img_original);
+			itsToSearch.push_back(it);
+		}
+		// With incremental calibration, the former results are valid only if
+		// some image was processed in a former call:
+		const bool hasFormerCalib = incremental &&
+			itsToSearch.size() < images.size() &&
+			out_camera_params.fx() > 0;
+
+		vector<vector<TPixelCoordf>> detectedCoords;
+		findChessboardCornersBatch(
+			imgsToSearch, detectedCoords, check_size_x, check_size_y,
+			detectionOptions);
+
+		for (size_t k = 0; k < itsToSearch.size(); k++)
+		{
+			it = itsToSearch[k];
+			TImageCalibData& dat = it->second;
+			dat.detected_corners = std::move(detectedCoords[k]);
+			dat.corners_searched = true;
+			dat.reconstructed_camera_pose = CPose3D();
+			const bool corners_found =
+				dat.detected_corners.size() == CORNERS_COUNT;
+			if (!corners_found) dat.detected_corners.clear();
 
 			cout << format(
 				"Img %s: %s\n",
 				mrpt::system::extractFileName(it->first).c_str(),
 				corners_found ? "DETECTED" : "NOT DETECTED");
 
-			if (corners_found)
+			// Draw the checkerboard in the corresponding image:
+			// ----------------------------------------------------
+			if (corners_found && !dat.img_original.isExternallyStored())
 			{
-				// save the corners in the data structure:
-				int x, y;
-				unsigned int k;
-				for (y = 0, k = 0; y < check_size.height; y++)
-					for (x = 0; x < check_size.width; x++, k++)
-						dat.detected_corners.emplace_back(
-							this_img_pts[k].x, this_img_pts[k].y);
-
-				// Draw the checkerboard in the corresponding image:
-				// ----------------------------------------------------
-				if (!dat.img_original.isExternallyStored())
+				const int r = 4;
+				cv::Point prev_pt = cvPoint(0, 0);
+				const int line_max = 8;
+				cv::Scalar line_colors[8];
+
+				line_colors[0] = CV_RGB(255, 0, 0);
+				line_colors[1] = CV_RGB(255, 128, 0);
+				line_colors[2] = CV_RGB(255, 128, 0);
+				line_colors[3] = CV_RGB(200, 200, 0);
+				line_colors[4] = CV_RGB(0, 255, 0);
+				line_colors[5] = CV_RGB(0, 200, 200);
+				line_colors[6] = CV_RGB(0, 0, 255);
+				line_colors[7] = CV_RGB(255, 0, 255);
+
+				// Checkboad as color image:
+				dat.img_original.colorImage(dat.img_checkboard);
+
+				cv::Mat rgb_img =
+					dat.img_checkboard.asCvMat<cv::Mat>(SHALLOW_COPY);
+
+				unsigned int x, y, kk;
+				for (y = 0, kk = 0; y < check_size_y; y++)
 				{
-					const int r = 4;
-					cv::Point prev_pt = cvPoint(0, 0);
-					const int line_max = 8;
-					cv::Scalar line_colors[8];
-
-					line_colors[0] = CV_RGB(255, 0, 0);
-					line_colors[1] = CV_RGB(255, 128, 0);
-					line_colors[2] = CV_RGB(255, 128, 0);
-					line_colors[3] = CV_RGB(200, 200, 0);
-					line_colors[4] = CV_RGB(0, 255, 0);
-					line_colors[5] = CV_RGB(0, 200, 200);
-					line_colors[6] = CV_RGB(0, 0, 255);
-					line_colors[7] = CV_RGB(255, 0, 255);
-
-					// Checkboad as color image:
-					dat.img_original.colorImage(dat.img_checkboard);
-
-					cv::Mat rgb_img =
-						dat.img_checkboard.asCvMat<cv::Mat>(SHALLOW_COPY);
-
-					for (y = 0, k = 0; y < check_size.height; y++)
+					cv::Scalar color = line_colors[y % line_max];
+					for (x = 0; x < check_size_x; x++, kk++)
 					{
-						cv::Scalar color = line_colors[y % line_max];
-						for (x = 0; x < check_size.width; x++, k++)
-						{
-							cv::Point pt{
-								cvRound(this_img_pts[k].x),
-								cvRound(this_img_pts[k].y)};
-
-							if (k != 0) cv::line(rgb_img, prev_pt, pt, color);
-
-							cv::line(
-								rgb_img, cv::Point(pt.x - r, pt.y - r),
-								cv::Point(pt.x + r, pt.y + r), color);
-							cv::line(
-								rgb_img, cv::Point(pt.x - r, pt.y + r),
-								cv::Point(pt.x + r, pt.y - r), color);
-							cv::circle(rgb_img, pt, r + 1, color);
-							prev_pt = pt;
-						}
+						cv::Point pt{
+							cvRound(dat.detected_corners[kk].x),
+							cvRound(dat.detected_corners[kk].y)};
+
+						if (kk != 0) cv::line(rgb_img, prev_pt, pt, color);
+
+						cv::line(
+							rgb_img, cv::Point(pt.x - r, pt.y - r),
+							cv::Point(pt.x + r, pt.y + r), color);
+						cv::line(
+							rgb_img, cv::Point(pt.x - r, pt.y + r),
+							cv::Point(pt.x + r, pt.y - r), color);
+						cv::circle(rgb_img, pt, r + 1, color);
+						prev_pt = pt;
 					}
 				}
+			}
+		}  // end find corners
+
+		// Accept the images with all the corners:
+		vector<vector<cv::Point3f>>
+			objectPoints;  // final container for detected stuff
+		vector<vector<cv::Point2f>>
+			imagePoints;  // final container for detected stuff
+
+		unsigned int valid_detected_imgs = 0;
+		vector<string> pointsIdx2imageFile;
+		for (it = images.begin(); it != images.end(); ++it)
+		{
+			const TImageCalibData& dat = it->second;
+			if (dat.detected_corners.size() != CORNERS_COUNT) continue;
 
-				// Accept this image as good:
-				pointsIdx2imageFile.push_back(it->first);
-				imagePoints.push_back(this_img_pts);
-				objectPoints.push_back(pattern_obj_points);
+			vector<cv::Point2f> this_img_pts;
+			for (const auto& pt : dat.detected_corners)
+				this_img_pts.emplace_back(pt.x, pt.y);
 
-				valid_detected_imgs++;
-			}
+			pointsIdx2imageFile.push_back(it->first);
+			imagePoints.push_back(this_img_pts);
+			objectPoints.push_back(pattern_obj_points);
 
-		}  // end find corners
+			valid_detected_imgs++;
+		}
 
 		std::cout << valid_detected_imgs << " valid images." << std::endl;
 		if (!valid_detected_imgs)
@@ -278,56 +287,79 @@ bool mrpt::vision::checkerBoardCameraCalibration(
 		// ---------------------------------------------
 		// Calculate the camera parameters
 		// ---------------------------------------------
-		// Calibrate camera
-		cv::Mat cameraMatrix, distCoeffs(1, 5, CV_64F, cv::Scalar::all(0));
-		vector<cv::Mat> rvecs, tvecs;
-
-		const double cv_calib_err = cv::calibrateCamera(
-			objectPoints, imagePoints, imgSize, cameraMatrix, distCoeffs, rvecs,
-			tvecs, 0 /*flags*/);
-
-		// Load matrix:
+		// In incremental mode, keep the former results if no image was added,
+		// or use them as the initial guess otherwise.
+		double cv_calib_err = 0;
+		unsigned int i;
+		if (hasFormerCalib && itsToSearch.empty())
 		{
-			Eigen::Matrix3d M;
-			cv::cv2eigen(cameraMatrix, M);
-			out_camera_params.intrinsicParams = M;
+			std::cout << "No new images: keeping the former calibration.\n";
 		}
-
-		out_camera_params.distortion = DistortionModel::plumb_bob;
-		out_camera_params.dist.fill(0);
-		for (int k = 0; k < 5; k++)
-			out_camera_params.dist[k] = distCoeffs.ptr<double>()[k];
-
-		// Load camera poses:
-		for (i = 0; i < valid_detected_imgs; i++)
+		else
 		{
-			CMatrixDouble44 HM;
-			HM.setZero();
-			HM(3, 3) = 1;
+			// Calibrate camera
+			cv::Mat cameraMatrix, distCoeffs(1, 5, CV_64F, cv::Scalar::all(0));
+			vector<cv::Mat> rvecs, tvecs;
 
+			int flags = 0;
+			if (hasFormerCalib)
 			{
-				// Convert rotation vectors -> rot matrices:
-				cv::Mat cv_rot;
-				cv::Rodrigues(rvecs[i], cv_rot);
-
-				Eigen::Matrix3d rot;
-				cv::cv2eigen(cv_rot, rot);
-				HM.block<3, 3>(0, 0) = rot;
+				const Eigen::Matrix3d M =
+					out_camera_params.intrinsicParams.asEigen();
+				cv::eigen2cv(M, cameraMatrix);
+				for (int k = 0; k < 5; k++)
+					distCoeffs.ptr<double>()[k] = out_camera_params.dist[k];
+				flags |= cv::CALIB_USE_INTRINSIC_GUESS;
 			}
 
+			cv_calib_err = cv::calibrateCamera(
+				objectPoints, imagePoints, imgSize, cameraMatrix, distCoeffs,
+				rvecs, tvecs, flags);
+
+			// Load matrix:
 			{
-				Eigen::Matrix<double, 3, 1> trans;
-				cv::cv2eigen(tvecs[i], trans);
-				HM.block<3, 1>(0, 3) = trans;
+				Eigen::Matrix3d M;
+				cv::cv2eigen(cameraMatrix, M);
+				out_camera_params.intrinsicParams = M;
 			}
 
-			CPose3D p = CPose3D(0, 0, 0) - CPose3D(HM);
+			out_camera_params.distortion = DistortionModel::plumb_bob;
+			out_camera_params.dist.fill(0);
+			for (int k = 0; k < 5; k++)
+				out_camera_params.dist[k] = distCoeffs.ptr<double>()[k];
+
+			// Load camera poses:
+			for (i = 0; i < valid_detected_imgs; i++)
+			{
+				CMatrixDouble44 HM;
+				HM.setZero();
+				HM(3, 3) = 1;
+
+				{
+					// Convert rotation vectors -> rot matrices:
+					cv::Mat cv_rot;
+					cv::Rodrigues(rvecs[i], cv_rot);
+
+					Eigen::Matrix3d rot;
+					cv::cv2eigen(cv_rot, rot);
+					HM.block<3, 3>(0, 0) = rot;
+				}
 
-			images[pointsIdx2imageFile[i]].reconstructed_camera_pose = p;
+				{
+					Eigen::Matrix<double, 3, 1> trans;
+					cv::cv2eigen(tvecs[i], trans);
+					HM.block<3, 1>(0, 3) = trans;
+				}
+
+				CPose3D p = CPose3D(0, 0, 0) - CPose3D(HM);
 
-			std::cout << "Img: "
-					  << mrpt::system::extractFileName(pointsIdx2imageFile[i])
-					  << ": " << p << std::endl;
+				images[pointsIdx2imageFile[i]].reconstructed_camera_pose = p;
+
+				std::cout
+					<< "Img: "
+					<< mrpt::system::extractFileName(pointsIdx2imageFile[i])
+					<< ": " << p << std::endl;
+			}
 		}
 
 		{
@@ -9,9 +9,14 @@
 
 #include "vision-precomp.h"	 // Precompiled headers
 //
+#include <mrpt/core/WorkerThreadsPool.h>
 #include <mrpt/math/geometry.h>	 // crossProduct3D()
 #include <mrpt/vision/chessboard_find_corners.h>
 
+#include <algorithm>
+#include <limits>
+#include <thread>
+
 // Universal include for all versions of OpenCV
 #include <mrpt/3rdparty/do_opencv_includes.h>
 
@@ -23,21 +28,74 @@ using namespace mrpt::img;
 using namespace mrpt::math;
 using namespace std;
 
-/** Look for the corners of a chessboard in the image
- * \param cornerCoords [OUT] The pixel coordinates of all the corners.
- * \param check_size_x [IN] The number of squares, in the X direction
- * \param check_size_y [IN] The number of squares, in the Y direction
- * \param normalize_image [IN] Whether to normalize the image before detection
- * \param useScaramuzzaMethod [IN] Whether to use the alternative, more robust
- * method by M. Rufli, D. Scaramuzza, and R. Siegwart.
- *
- * \return true on success
- */
+#if MRPT_HAS_OPENCV
+namespace
+{
+// Detection (without subpixel refinement) in a grayscale image:
+bool detectCorners(
+	const CImage& img, unsigned int check_size_x, unsigned int check_size_y,
+	bool normalize_image, bool useScaramuzzaMethod,
+	vector<cv::Point2f>& corners)
+{
+	const CvSize check_size = cvSize(check_size_x, check_size_y);
+	const size_t CORNERS_COUNT = check_size_x * check_size_y;
+
+	corners.clear();
+	bool corners_found = false;
+	if (!useScaramuzzaMethod)
+	{
+		int find_chess_flags = cv::CALIB_CB_ADAPTIVE_THRESH;
+		if (normalize_image) find_chess_flags |= cv::CALIB_CB_NORMALIZE_IMAGE;
+
+		// Standard OpenCV's function:
+		corners_found = 0 !=
+			cv::findChessboardCorners(
+							img.asCvMat<cv::Mat>(SHALLOW_COPY), check_size,
+							corners, find_chess_flags);
+	}
+	else
+	{
+		vector<CvPoint2D32f> corners_list(CORNERS_COUNT);
+		// Return: -1: errors, 0: not found, 1: found OK
+		corners_found =
+			1 == cvFindChessboardCorners3(img, check_size, corners_list);
+		for (const auto& c : corners_list)
+			corners.emplace_back(c.x, c.y);
+	}
+
+	// Check # of corners:
+	return corners_found && corners.size() == CORNERS_COUNT;
+}
+
+void refineCorners(const CImage& img, vector<cv::Point2f>& corners, int win)
+{
+	cv::cornerSubPix(
+		img.asCvMat<cv::Mat>(SHALLOW_COPY), corners, cv::Size(win, win),
+		cv::Size(-1, -1),
+		cv::TermCriteria(
+			cv::TermCriteria::COUNT | cv::TermCriteria::EPS, 10, 0.01));
+}
+}  // namespace
+#endif
+
 bool mrpt::vision::findChessboardCorners(
 	const mrpt::img::CImage& in_img, std::vector<TPixelCoordf>& cornerCoords,
 	unsigned int check_size_x, unsigned int check_size_y, bool normalize_image,
 	bool useScaramuzzaMethod)
 {
+	TChessboardCornersOptions opts;
+	opts.normalize_image = normalize_image;
+	opts.useScaramuzzaMethod = useScaramuzzaMethod;
+	return findChessboardCorners(
+		in_img, cornerCoords, check_size_x, check_size_y, opts);
+}
+
+bool mrpt::vision::findChessboardCorners(
+	const mrpt::img::CImage& in_img, std::vector<TPixelCoordf>& cornerCoords,
+	unsigned int check_size_x, unsigned int check_size_y,
+	const TChessboardCornersOptions& opts)
+{
+	cornerCoords.clear();
 #if MRPT_HAS_OPENCV
 	MRPT_START
 
@@ -46,66 +104,54 @@ bool mrpt::vision::findChessboardCorners(
 	// Grayscale version:
 	const CImage img(in_img, FAST_REF_OR_CONVERT_TO_GRAY);
 
-	// Try with expanded versions of the image if it fails to detect the
-	// checkerboard:
-	int corners_count;
-	bool corners_found = false;
-
-	const CvSize check_size = cvSize(check_size_x, check_size_y);
-
-	const int CORNERS_COUNT = check_size_x * check_size_y;
-
-	vector<CvPoint2D32f> corners_list;
-	corners_count = CORNERS_COUNT;
-	corners_list.resize(CORNERS_COUNT);
-
-	cornerCoords.clear();
-
-	int find_chess_flags = cv::CALIB_CB_ADAPTIVE_THRESH;
-	if (normalize_image) find_chess_flags |= cv::CALIB_CB_NORMALIZE_IMAGE;
-
-	cv::Mat cvImg = img.asCvMat<cv::Mat>(SHALLOW_COPY);
-	if (!useScaramuzzaMethod)
+	// Downscaled version for a first, faster, detection:
+	CImage small = img.makeShallowCopy();
+	unsigned int nHalvings = 0;
+	while (opts.maxDetectionWidth > 0 &&
+		   small.getWidth() > opts.maxDetectionWidth)
 	{
-		vector<cv::Point2f> pointbuf;
-
-		// Standard OpenCV's function:
-		corners_found = 0 !=
-			cv::findChessboardCorners(
-							cvImg, check_size, pointbuf, find_chess_flags);
+		small = small.scaleHalf(IMG_INTERP_LINEAR);
+		nHalvings++;
+	}
 
-		corners_list.resize(pointbuf.size());
-		for (size_t i = 0; i < pointbuf.size(); i++)
+	vector<cv::Point2f> corners;
+	bool corners_found = false;
+	if (nHalvings > 0 &&
+		detectCorners(
+			small, check_size_x, check_size_y, opts.normalize_image,
+			opts.useScaramuzzaMethod, corners))
+	{
+		// Each pixel of the small image is the average of a block of
+		// (2^nHalvings)^2 pixels:
+		const float K = static_cast<float>(1U << nHalvings);
+		float minDist = std::numeric_limits<float>::max();
+		for (size_t i = 0; i < corners.size(); i++)
 		{
-			corners_list[i].x = pointbuf[i].x;
-			corners_list[i].y = pointbuf[i].y;
+			if (i > 0)
+				minDist = std::min<float>(
+					minDist, cv::norm(corners[i] - corners[i - 1]));
+			corners[i] = (corners[i] + cv::Point2f(0.5f, 0.5f)) * K -
+				cv::Point2f(0.5f, 0.5f);
 		}
+		// Refine with a window that covers the error of the coarse corners,
+		// but smaller than the squares, then as in the full-resolution case:
+		const int win = static_cast<int>(std::min(K, 0.4f * K * minDist));
+		if (win > 5) refineCorners(img, corners, win);
+		corners_found = true;
 	}
 	else
-	{
-		// Return: -1: errors, 0: not found, 1: found OK
-		corners_found =
-			1 == cvFindChessboardCorners3(img, check_size, corners_list);
-	}
-
-	// Check # of corners:
-	if (corners_found && corners_count != CORNERS_COUNT) corners_found = false;
+		corners_found = detectCorners(
+			img, check_size_x, check_size_y, opts.normalize_image,
+			opts.useScaramuzzaMethod, corners);
 
 	if (corners_found)
 	{
-		IplImage iplImg = cvIplImage(cvImg);
 		// Refine corners:
-		cvFindCornerSubPix(
-			&iplImg, &corners_list[0], corners_count, cvSize(5, 5),	 // window
-			cvSize(-1, -1),
-			cvTermCriteria(CV_TERMCRIT_ITER | CV_TERMCRIT_EPS, 10, 0.01f));
+		refineCorners(img, corners, 5);
 
 		// save the corners in the data structure:
-		int y;
-		unsigned int k;
-		for (y = 0, k = 0; y < check_size.height; y++)
-			for (int x = 0; x < check_size.width; x++, k++)
-				cornerCoords.emplace_back(corners_list[k].x, corners_list[k].y);
+		for (const auto& c : corners)
+			cornerCoords.emplace_back(c.x, c.y);
 	}
 
 	return corners_found;
@@ -116,6 +162,39 @@ bool mrpt::vision::findChessboardCorners(
 #endif
 }
 
+void mrpt::vision::findChessboardCornersBatch(
+	const std::vector<const mrpt::img::CImage*>& images,
+	std::vector<std::vector<TPixelCoordf>>& cornerCoords,
+	unsigned int check_size_x, unsigned int check_size_y,
+	const TChessboardCornersOptions& opts)
+{
+	MRPT_START
+	const size_t n = images.size();
+	cornerCoords.resize(n);
+
+	const auto fn = [&](size_t i) {
+		ASSERT_(images[i]);
+		findChessboardCorners(
+			*images[i], cornerCoords[i], check_size_x, check_size_y, opts);
+	};
+
+	size_t nThreads = opts.numThreads;
+	if (!nThreads)
+		nThreads = std::max(1U, std::thread::hardware_concurrency());
+	nThreads = std::min(nThreads, n);
+	if (nThreads <= 1)
+	{
+		for (size_t i = 0; i < n; i++)
+			fn(i);
+		return;
+	}
+	// The calling thread also runs tasks:
+	mrpt::WorkerThreadsPool pool(
+		nThreads - 1, mrpt::WorkerThreadsPool::POLICY_FIFO, "chessboard");
+	pool.parallel_for(0, n, 1, fn);
+	MRPT_END
+}
+
 /** Look for the corners of one or more chessboard/checkerboards in the image.
  *  This method uses an improved version of OpenCV's cvFindChessboardCorners
  * published
@@ -65,104 +65,120 @@ bool mrpt::vision::checkerBoardStereoCalibration(
 			TImageSize(p.check_size_x, p.check_size_y);
 		TImageStereoCallbackData cbPars;
 
-		// For each image, find checkerboard corners:
+		// Left/Right sizes (may be different), the same for all the images
+		// of each channel:
 		// -----------------------------------------------
-		// Left/Right sizes (may be different)
 		TImageSize imgSize[2] = {TImageSize(0, 0), TImageSize(0, 0)};
-
-		vector<size_t> valid_image_pair_indices;  // Indices in images[] which
-		// are valid pairs to be used
-		// in the optimization
-
 		for (size_t i = 0; i < images.size(); i++)
 		{
-			// Do loop for each left/right image:
-			TImageCalibData* dats[2] = {&images[i].left, &images[i].right};
-			bool corners_found[2] = {false, false};
-
+			const TImageCalibData* dats[2] = {&images[i].left, &images[i].right};
 			for (int lr = 0; lr < 2; lr++)
 			{
-				TImageCalibData& dat = *dats[lr];
-				dat.detected_corners.clear();
-
-				// Make grayscale version:
-				const CImage img_gray(
-					dat.img_original, FAST_REF_OR_CONVERT_TO_GRAY);
-
+				const TImageSize sz = dats[lr]->img_original.getSize();
 				if (!i)
 				{
-					imgSize[lr] = img_gray.getSize();
-					if (lr == 0)
-					{
-						out.cam_params.leftCamera.ncols = imgSize[lr].x;
-						out.cam_params.leftCamera.nrows = imgSize[lr].y;
-					}
-					else
-					{
-						out.cam_params.rightCamera.ncols = imgSize[lr].x;
-						out.cam_params.rightCamera.nrows = imgSize[lr].y;
-					}
+					imgSize[lr] = sz;
+					auto& cam = lr == 0 ? out.cam_params.leftCamera
+										: out.cam_params.rightCamera;
+					cam.ncols = sz.x;
+					cam.nrows = sz.y;
 				}
-				else
+				else if (imgSize[lr].x != sz.x || imgSize[lr].y != sz.y)
 				{
-					if (imgSize[lr].y != (int)img_gray.getHeight() ||
-						imgSize[lr].x != (int)img_gray.getWidth())
-					{
-						std::cout << "ERROR: All the images in each left/right "
-									 "channel must have the same size."
-								  << std::endl;
-						return false;
-					}
+					std::cout << "ERROR: All the images in each left/right "
+								 "channel must have the same size."
+							  << std::endl;
+					return false;
 				}
+			}
+		}
 
-				// Do detection (this includes the "refine corners" with
-				// cvFindCornerSubPix):
-				corners_found[lr] = mrpt::vision::findChessboardCorners(
-					img_gray, dat.detected_corners, p.check_size_x,
-					p.check_size_y,
-					p.normalize_image  // normalize_image
-				);
-
-				if (corners_found[lr] &&
-					dat.detected_corners.size() != CORNERS_COUNT)
-					corners_found[lr] = false;
-
-				if (p.verbose)
-					cout << format(
-						"%s img #%u: %s\n", lr == 0 ? "LEFT" : "RIGHT",
-						static_cast<unsigned int>(i),
-						corners_found[lr] ? "DETECTED" : "NOT DETECTED");
-				// User Callback?
-				if (p.callback)
-				{
-					cbPars.calibRound = -1;	 // Detecting corners
-					cbPars.current_iter = 0;
-					cbPars.current_rmse = 0;
-					cbPars.nImgsProcessed = i * 2 + lr + 1;
-					cbPars.nImgsToProcess = images.size() * 2;
-					(*p.callback)(cbPars, p.callback_user_param);
-				}
+		// Image pairs to search for corners (in incremental mode, only those
+		// not processed in a former call):
+		vector<size_t> pairsToSearch;
+		for (size_t i = 0; i < images.size(); i++)
+			if (!p.incremental || !images[i].left.corners_searched ||
+				!images[i].right.corners_searched)
+				pairsToSearch.push_back(i);
+
+		const bool hasFormerCalib = p.incremental &&
+			pairsToSearch.size() < images.size() &&
+			out.final_number_good_image_pairs > 0 &&
+			out.left_cam_poses.size() <= images.size();
+
+		// Find checkerboard corners of all images in parallel (this includes
+		// the "refine corners" with cornerSubPix), in chunks of pairs if the
+		// user wants progress callbacks:
+		// -----------------------------------------------
+		TChessboardCornersOptions detOpts;
+		detOpts.normalize_image = p.normalize_image;
+		detOpts.maxDetectionWidth = p.detection_max_width;
+		detOpts.numThreads = p.num_threads;
+		const size_t CHUNK = p.callback ? 16 : pairsToSearch.size();
+
+		for (size_t c0 = 0; c0 < pairsToSearch.size(); c0 += CHUNK)
+		{
+			const size_t c1 = std::min(c0 + CHUNK, pairsToSearch.size());
+			vector<const CImage*> imgs;
+			for (size_t c = c0; c < c1; c++)
+			{
+				imgs.push_back(&images[pairsToSearch[c]].left.img_original);
+				imgs.push_back(&images[pairsToSearch[c]].right.img_original);
+			}
+			vector<vector<TPixelCoordf>> corners;
+			findChessboardCornersBatch(
+				imgs, corners, p.check_size_x, p.check_size_y, detOpts);
+
+			for (size_t c = c0; c < c1; c++)
+			{
+				const size_t i = pairsToSearch[c];
+				TImageCalibData* dats[2] = {&images[i].left, &images[i].right};
+				bool corners_found[2] = {false, false};
 
-				if (corners_found[lr])
+				for (int lr = 0; lr < 2; lr++)
 				{
-					// Draw the checkerboard in the corresponding image:
-					if (!dat.img_original.isExternallyStored())
+					TImageCalibData& dat = *dats[lr];
+					dat.detected_corners = std::move(corners[2 * (c - c0) + lr]);
+					dat.corners_searched = true;
+					corners_found[lr] =
+						dat.detected_corners.size() == CORNERS_COUNT;
+					if (!corners_found[lr]) dat.detected_corners.clear();
+
+					if (p.verbose)
+						cout << format(
+							"%s img #%u: %s\n", lr == 0 ? "LEFT" : "RIGHT",
+							static_cast<unsigned int>(i),
+							corners_found[lr] ? "DETECTED" : "NOT DETECTED");
+					// User Callback?
+					if (p.callback)
 					{
-						// Checkboad as color image:
-						dat.img_original.colorImage(dat.img_checkboard);
-						dat.img_checkboard.drawChessboardCorners(
-							dat.detected_corners, check_size.x, check_size.y);
+						cbPars.calibRound = -1;	 // Detecting corners
+						cbPars.current_iter = 0;
+						cbPars.current_rmse = 0;
+						cbPars.nImgsProcessed = c * 2 + lr + 1;
+						cbPars.nImgsToProcess = pairsToSearch.size() * 2;
+						(*p.callback)(cbPars, p.callback_user_param);
 					}
-				}
 
-			}  // end for lr
+					if (corners_found[lr])
+					{
+						// Draw the checkerboard in the corresponding image:
+						if (!dat.img_original.isExternallyStored())
+						{
+							// Checkboad as color image:
+							dat.img_original.colorImage(dat.img_checkboard);
+							dat.img_checkboard.drawChessboardCorners(
+								dat.detected_corners, check_size.x,
+								check_size.y);
+						}
+					}
 
-			// We just finished detecting corners in a left/right pair.
-			// Only if corners were detected perfectly in BOTH images, add this
-			// image pair as a good one for optimization:
-			if (corners_found[0] && corners_found[1])
-			{
-				valid_image_pair_indices.push_back(i);
+				}  // end for lr
+
+				// We just finished detecting corners in a left/right pair.
+				// Only if corners were detected perfectly in BOTH images,
+				// this image pair will be used for optimization:
+				if (!corners_found[0] || !corners_found[1]) continue;
 
 				// Consistency between left/right pair: the corners MUST BE
 				// ORDERED so they match to each other,
@@ -171,11 +187,9 @@ bool mrpt::vision::checkerBoardStereoCalibration(
 
 				// Key idea: Generate a representative vector that goes along
 				// rows and columns.
-				// Check the angle of those director vectors between L/R images.
-				// That can be done
+				// Check the angle of those director vectors between L/R
+				// images. That can be done
 				// via the dot product. Swap rows/columns order as needed.
-				bool has_to_redraw_corners = false;
-
 				const TPixelCoordf pt_l0 = images[i].left.detected_corners[0],
 								   pt_l1 = images[i].left.detected_corners[1],
 								   pt_r0 = images[i].right.detected_corners[0],
@@ -189,15 +203,11 @@ bool mrpt::vision::checkerBoardStereoCalibration(
 				// corners:
 				if (Al.x * Ar.x + Al.y * Ar.y < 0)
 				{
-					has_to_redraw_corners = true;
 					// Invert all corners:
 					std::reverse(
 						images[i].right.detected_corners.begin(),
 						images[i].right.detected_corners.end());
-				}
 
-				if (has_to_redraw_corners)
-				{
 					// Checkboad as color image:
 					images[i].right.img_original.colorImage(
 						images[i].right.img_checkboard);
@@ -206,9 +216,27 @@ bool mrpt::vision::checkerBoardStereoCalibration(
 						check_size.y);
 				}
 			}
-
 		}  // end find corners
 
+		// Indices in images[] which are valid pairs to be used in the
+		// optimization:
+		vector<size_t> valid_image_pair_indices;
+		for (size_t i = 0; i < images.size(); i++)
+			if (images[i].left.detected_corners.size() == CORNERS_COUNT &&
+				images[i].right.detected_corners.size() == CORNERS_COUNT)
+				valid_image_pair_indices.push_back(i);
+
+		if (hasFormerCalib && pairsToSearch.empty() &&
+			out.image_pair_was_used.size() == images.size() &&
+			out.final_number_good_image_pairs ==
+				valid_image_pair_indices.size())
+		{
+			if (p.verbose)
+				std::cout << "No new image pairs: keeping the former "
+							 "calibration.\n";
+			return true;
+		}
+
 		if (p.verbose)
 			std::cout << valid_image_pair_indices.size()
 					  << " valid image pairs.\n";
@@ -272,6 +300,34 @@ bool mrpt::vision::checkerBoardStereoCalibration(
 			lm_stat.right_cam_params[6] = lm_stat.right_cam_params[7] =
 				lm_stat.right_cam_params[8] = 0;
 
+		// Incremental mode: start from the former results
+		if (hasFormerCalib)
+		{
+			const TCamera* cams[2] = {
+				&out.cam_params.leftCamera, &out.cam_params.rightCamera};
+			CVectorFixedDouble<9>* params[2] = {
+				&lm_stat.left_cam_params, &lm_stat.right_cam_params};
+			for (int lr = 0; lr < 2; lr++)
+			{
+				const TCamera& c = *cams[lr];
+				auto& v = *params[lr];
+				v[0] = c.fx();
+				v[1] = c.fy();
+				v[2] = c.cx();
+				v[3] = c.cy();
+				v[4] = c.k1();
+				v[5] = c.k2();
+				v[6] = c.k3();
+				v[7] = c.p1();
+				v[8] = c.p2();
+			}
+			lm_stat.right2left_pose = out.right2left_camera_pose.asTPose();
+			for (size_t i = 0; i < out.left_cam_poses.size(); i++)
+				if (i < out.image_pair_was_used.size() &&
+					out.image_pair_was_used[i])
+					lm_stat.left_cam_poses[i] = out.left_cam_poses[i];
+		}
+
 		// ===============================================================================
 		//   Run stereo calibration in two stages:
 		//   (0) Estimate all parameters except distortion
@@ -286,7 +342,9 @@ bool mrpt::vision::checkerBoardStereoCalibration(
 		// uncertainty measure)
 		mrpt::math::CMatrixDouble H;
 
-		for (int calibRound = 0; calibRound < 2; calibRound++)
+		// (Round 0 is skipped if starting from a former calibration)
+		for (int calibRound = hasFormerCalib ? 1 : 0; calibRound < 2;
+			 calibRound++)
 		{
 			cbPars.calibRound = calibRound;
 			if (p.verbose)
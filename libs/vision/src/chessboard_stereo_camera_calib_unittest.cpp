@@ -9,6 +9,7 @@
 
 #include <gtest/gtest.h>
 #include <mrpt/config.h>
+#include <mrpt/vision/chessboard_find_corners.h>
 #include <mrpt/vision/chessboard_stereo_camera_calib.h>
 #include <test_mrpt_common.h>
 
@@ -103,3 +104,70 @@ TEST(Vision, DISABLED_checkerBoardStereoCalibration_empty)
 		mrpt::vision::checkerBoardStereoCalibration(images, params, out);
 	EXPECT_FALSE(ok);
 }
+
+#if MRPT_HAS_OPENCV
+TEST(Vision, checkerBoardStereoCalibration_incremental)
+#else
+TEST(Vision, DISABLED_checkerBoardStereoCalibration_incremental)
+#endif
+{
+	using namespace std::string_literals;
+	const auto dir =
+		mrpt::UNITTEST_BASEDIR + "/share/mrpt/datasets/stereo-calib/"s;
+
+	mrpt::vision::TCalibrationStereoImageList images(4);
+	for (unsigned int i = 0; i < images.size(); i++)
+	{
+		ASSERT_TRUE(images[i].left.img_original.loadFromFile(
+			dir + mrpt::format("%u_left.jpg", i)));
+		ASSERT_TRUE(images[i].right.img_original.loadFromFile(
+			dir + mrpt::format("%u_right.jpg", i)));
+	}
+
+	// Corners found in downscaled images, refined at full resolution:
+	{
+		const auto& img = images[0].left.img_original;
+		std::vector<mrpt::img::TPixelCoordf> full, fromSmall;
+		mrpt::vision::TChessboardCornersOptions opts;
+		ASSERT_TRUE(
+			mrpt::vision::findChessboardCorners(img, full, 6, 9, opts));
+		opts.maxDetectionWidth = img.getWidth() / 2;
+		ASSERT_TRUE(
+			mrpt::vision::findChessboardCorners(img, fromSmall, 6, 9, opts));
+		ASSERT_EQ(full.size(), fromSmall.size());
+		for (size_t i = 0; i < full.size(); i++)
+		{
+			EXPECT_NEAR(full[i].x, fromSmall[i].x, 0.5) << "i=" << i;
+			EXPECT_NEAR(full[i].y, fromSmall[i].y, 0.5) << "i=" << i;
+		}
+	}
+
+	mrpt::vision::TStereoCalibParams params;
+	params.check_size_x = 6;
+	params.check_size_y = 9;
+	params.check_squares_length_X_meters = 0.034;
+	params.check_squares_length_Y_meters = 0.034;
+	params.verbose = false;
+	params.incremental = true;
+
+	// Calibrate with 3 pairs, then add the 4th one:
+	mrpt::vision::TStereoCalibResults out;
+	auto last = images.back();
+	images.pop_back();
+	EXPECT_TRUE(
+		mrpt::vision::checkerBoardStereoCalibration(images, params, out));
+	EXPECT_EQ(out.final_number_good_image_pairs, 3UL);
+
+	images.push_back(last);
+	EXPECT_TRUE(
+		mrpt::vision::checkerBoardStereoCalibration(images, params, out));
+	EXPECT_EQ(out.final_number_good_image_pairs, 4UL);
+	EXPECT_LT(out.final_rmse, 3.0);
+	EXPECT_NEAR(out.cam_params.rightCameraPose.x, 0.1194, 0.005);
+
+	// Nothing new: the former results are kept
+	const size_t iters = out.final_iters;
+	EXPECT_TRUE(
+		mrpt::vision::checkerBoardStereoCalibration(images, params, out));
+	EXPECT_EQ(out.final_iters, iters);
+}
@@ -29,6 +29,8 @@
 #include <mrpt/system/os.h>
 
 #include <Eigen/Dense>
+#include <algorithm>
+#include <numeric>
 
 using namespace mrpt;
 using namespace mrpt::math;
@@ -1095,6 +1097,7 @@ void CLandmarksMap::computeMatchingWith3DLandmarks(
 	switch (insertionOptions.SIFTMatching3DMethod)
 	{
 		case 0:
+		{
 			// Our method: Filter out by the likelihood of the 3D position and
 			// compute the likelihood of the Euclidean descriptor distance
 
@@ -1103,9 +1106,18 @@ void CLandmarksMap::computeMatchingWith3DLandmarks(
 				-0.5 / square(likelihoodOptions.SIFTs_sigma_descriptor_dist);
 			K_dist = -0.5 / square(likelihoodOptions.SIFTs_mahaDist_std);
 
-			// CDynamicGrid<std::vector<int32_t>>		*gridLandmarks =
-			// landmarks.getGrid();
-			// std::vector<int32_t>						closeLandmarksList;
+			// Landmarks with lik_dist<=1e-2 have lik<=1e-5, so they can be
+			// skipped if the likelihood threshold is larger. Since the
+			// squared Mahalanobis distance is at least the squared Euclidean
+			// distance over the largest eigenvalue of the covariance (which is
+			// bounded by its trace), only "this" landmarks within this
+			// distance of each "other" landmark must be checked:
+			//   |d|^2 < -log(1e-2)/(-K_dist) * (trace(Ck) + max trace(Cj))
+			const bool useGrid =
+				insertionOptions.SiftLikelihoodThreshold >= 1e-5;
+			const double maxMahaDist2 = std::log(1e-2) / K_dist;
+			const double maxVarThis = landmarks.getLargestPositionVariance();
+			std::vector<int32_t> candidates;
 
 			for (k = 0, otherIt = anotherMap->landmarks.begin();
 				 otherIt != anotherMap->landmarks.end(); otherIt++, k++)
@@ -1119,21 +1131,38 @@ void CLandmarksMap::computeMatchingWith3DLandmarks(
 					maxLik = -1;
 					maxIdx = -1;
 
-					for (j = 0, thisIt = landmarks.begin();
-						 thisIt != landmarks.end(); thisIt++, j++)
+					if (useGrid)
+					{
+						const double maxVar = maxVarThis +
+							otherIt->pose_cov_11 + otherIt->pose_cov_22 +
+							otherIt->pose_cov_33;
+						landmarks.getLandmarksNear2D(
+							otherIt->pose_mean.x, otherIt->pose_mean.y,
+							1.01 * std::sqrt(maxMahaDist2 * maxVar),
+							candidates);
+					}
+					else
 					{
-						if (thisIt->getType() == featSIFT &&
-							thisIt->features.size() ==
+						candidates.resize(nThis);
+						std::iota(candidates.begin(), candidates.end(), 0);
+					}
+
+					for (const int32_t jj : candidates)
+					{
+						j = jj;
+						const CLandmark* thisLM = landmarks.get(j);
+						if (thisLM->getType() == featSIFT &&
+							thisLM->features.size() ==
 								otherIt->features.size() &&
-							!thisIt->features.empty() &&
-							thisIt->features[0].descriptors.SIFT->size() ==
+							!thisLM->features.empty() &&
+							thisLM->features[0].descriptors.SIFT->size() ==
 								otherIt->features[0].descriptors.SIFT->size())
 						{
 							// Compute "coincidence probability":
 							// --------------------------------------
 							// Load into "pointPDF_j" the PDF of landmark
 							// "otherIt":
-							thisIt->getPose(pointPDF_j);
+							thisLM->getPose(pointPDF_j);
 
 							// Compute lik:
 							// lik_dist =
@@ -1174,9 +1203,10 @@ void CLandmarksMap::computeMatchingWith3DLandmarks(
 								std::pair<
 									mrpt::maps::CLandmark::TLandmarkID,
 									mrpt::maps::CLandmark::TLandmarkID>
-									mPair(thisIt->ID, otherIt->ID);
+									mPair(thisLM->ID, otherIt->ID);
 
-								if (CLandmarksMap::_mEDD[mPair] == 0)
+								double& cachedEDD = CLandmarksMap::_mEDD[mPair];
+								if (cachedEDD == 0)
 								{
 									n = otherIt->features[0]
 											.descriptors.SIFT->size();
@@ -1185,14 +1215,14 @@ void CLandmarksMap::computeMatchingWith3DLandmarks(
 										desc += square(
 											(*otherIt->features[0]
 												  .descriptors.SIFT)[i] -
-											(*thisIt->features[0]
+											(*thisLM->features[0]
 												  .descriptors.SIFT)[i]);
 
-									CLandmarksMap::_mEDD[mPair] = desc;
+									cachedEDD = desc;
 								}  // end if
 								else
 								{
-									desc = CLandmarksMap::_mEDD[mPair];
+									desc = cachedEDD;
 								}
 
 								lik_desc = exp(K_desc * desc);	// Likelihood
@@ -1208,16 +1238,8 @@ void CLandmarksMap::computeMatchingWith3DLandmarks(
 							// --------------------------------------
 							lik = lik_dist * lik_desc;
 
-							//						os::fprintf( f,
-							//"%i\t%i\t%f\t%f\t%f\n", k, j, lik_desc, lik_dist,
-							// lik );
-
 							if (lik > maxLik)
 							{
-								//							maxLikDist =
-								// lik_dist;
-								//							maxLikDesc =
-								// lik_desc;
 								maxLik = lik;
 								maxIdx = j;
 							}
@@ -1225,8 +1247,6 @@ void CLandmarksMap::computeMatchingWith3DLandmarks(
 						}  // end of this landmark is SIFT
 
 					}  // End of for each "this", j
-					// os::fprintf(f, "%i\t%i\t%f\t%f\t%f\n", maxIdx, k,
-					// maxLikDist, maxLikDesc, maxLik);
 
 					// Is it a correspondence?
 					if (maxLik > insertionOptions.SiftLikelihoodThreshold)
@@ -1264,8 +1284,8 @@ void CLandmarksMap::computeMatchingWith3DLandmarks(
 			// Compute the corrs ratio:
 			correspondencesRatio = correspondences.size() / d2f(nOther);
 			//		os::fclose(f);
-
-			break;
+		}
+		break;
 
 		case 1:
 
@@ -1762,6 +1782,7 @@ void CLandmarksMap::TCustomSequenceLandmarks::clear()
 	m_grid.clear();
 
 	m_largestDistanceFromOriginIsUpdated = false;
+	m_largestPositionVarianceIsUpdated = false;
 }
 
 void CLandmarksMap::TCustomSequenceLandmarks::push_back(const CLandmark& l)
@@ -1783,6 +1804,7 @@ void CLandmarksMap::TCustomSequenceLandmarks::push_back(const CLandmark& l)
 	cell->push_back(m_landmarks.size() - 1);
 
 	m_largestDistanceFromOriginIsUpdated = false;
+	m_largestPositionVarianceIsUpdated = false;
 }
 
 CLandmark* CLandmarksMap::TCustomSequenceLandmarks::get(unsigned int indx)
@@ -1812,12 +1834,26 @@ void CLandmarksMap::TCustomSequenceLandmarks::isToBeModified(unsigned int indx)
 	}
 
 	m_largestDistanceFromOriginIsUpdated = false;
+	m_largestPositionVarianceIsUpdated = false;
 }
 
 void CLandmarksMap::TCustomSequenceLandmarks::erase(unsigned int indx)
 {
+	// Keep the grid consistent: remove this landmark, and shift the indices
+	// of those after it:
+	const auto idx = static_cast<int32_t>(indx);
+	for (unsigned int cy = 0; cy < m_grid.getSizeY(); cy++)
+		for (unsigned int cx = 0; cx < m_grid.getSizeX(); cx++)
+		{
+			std::vector<int32_t>& cell = *m_grid.cellByIndex(cx, cy);
+			cell.erase(std::remove(cell.begin(), cell.end(), idx), cell.end());
+			for (auto& i : cell)
+				if (i > idx) i--;
+		}
+
 	m_landmarks.erase(m_landmarks.begin() + indx);
 	m_largestDistanceFromOriginIsUpdated = false;
+	m_largestPositionVarianceIsUpdated = false;
 }
 
 void CLandmarksMap::TCustomSequenceLandmarks::hasBeenModified(unsigned int indx)
@@ -1826,16 +1862,18 @@ void CLandmarksMap::TCustomSequenceLandmarks::hasBeenModified(unsigned int indx)
 
 	// Resize grid if necesary:
 	m_grid.resize(
-		min(m_grid.getXMin(), m_landmarks[indx].pose_mean.x),
-		max(m_grid.getXMax(), m_landmarks[indx].pose_mean.x),
-		min(m_grid.getYMin(), m_landmarks[indx].pose_mean.y),
-		max(m_grid.getYMax(), m_landmarks[indx].pose_mean.y), dummyEmpty);
+		min(m_grid.getXMin(), m_landmarks[indx].pose_mean.x - 0.1),
+		max(m_grid.getXMax(), m_landmarks[indx].pose_mean.x + 0.1),
+		min(m_grid.getYMin(), m_landmarks[indx].pose_mean.y - 0.1),
+		max(m_grid.getYMax(), m_landmarks[indx].pose_mean.y + 0.1),
+		dummyEmpty);
 
 	// Add to the grid:
 	std::vector<int32_t>* cell = m_grid.cellByPos(
 		m_landmarks[indx].pose_mean.x, m_landmarks[indx].pose_mean.y);
 	cell->push_back(indx);
 	m_largestDistanceFromOriginIsUpdated = false;
+	m_largestPositionVarianceIsUpdated = false;
 }
 
 void CLandmarksMap::TCustomSequenceLandmarks::hasBeenModifiedAll()
@@ -1860,7 +1898,8 @@ void CLandmarksMap::TCustomSequenceLandmarks::hasBeenModifiedAll()
 		min_y = min(min_y, it->pose_mean.y);
 		max_y = max(max_y, it->pose_mean.y);
 	}
-	m_grid.resize(min_x, max_x, min_y, max_y, dummyEmpty);
+	m_grid.resize(
+		min_x - 0.1, max_x + 0.1, min_y - 0.1, max_y + 0.1, dummyEmpty);
 
 	// Add landmarks to cells:
 	for (idx = 0, it = m_landmarks.begin(); it != m_landmarks.end();
@@ -1872,6 +1911,7 @@ void CLandmarksMap::TCustomSequenceLandmarks::hasBeenModifiedAll()
 	}
 
 	m_largestDistanceFromOriginIsUpdated = false;
+	m_largestPositionVarianceIsUpdated = false;
 	MRPT_END
 }
 
@@ -1899,6 +1939,62 @@ float CLandmarksMap::TCustomSequenceLandmarks::getLargestDistanceFromOrigin()
 	return m_largestDistanceFromOrigin;
 }
 
+float CLandmarksMap::TCustomSequenceLandmarks::getLargestPositionVariance()
+	const
+{
+	if (!m_largestPositionVarianceIsUpdated)
+	{
+		float maxVar = 0;
+		for (const auto& lm : *this)
+			maxVar =
+				max(maxVar, lm.pose_cov_11 + lm.pose_cov_22 + lm.pose_cov_33);
+
+		m_largestPositionVariance = maxVar;
+		m_largestPositionVarianceIsUpdated = true;
+	}
+	return m_largestPositionVariance;
+}
+
+void CLandmarksMap::TCustomSequenceLandmarks::getLandmarksNear2D(
+	double x, double y, double maxDist, std::vector<int32_t>& outIndices) const
+{
+	outIndices.clear();
+	const double maxDistSqr = square(maxDist);
+	const auto isNear = [&](int32_t i) {
+		const auto& p = m_landmarks[i].pose_mean;
+		return square(p.x - x) + square(p.y - y) <= maxDistSqr;
+	};
+
+	// Range of cell indices, clamped before converting to integers:
+	const auto cellRange = [&](double v, double v_min, size_t n, int& i0,
+							   int& i1) {
+		const double res = m_grid.getResolution();
+		const double maxIdx = static_cast<double>(n) - 1;
+		i0 = static_cast<int>(
+			std::max(0.0, std::min(maxIdx, (v - maxDist - v_min) / res)));
+		i1 = static_cast<int>(
+			std::max(0.0, std::min(maxIdx, (v + maxDist - v_min) / res)));
+	};
+	int cx0, cx1, cy0, cy1;
+	cellRange(x, m_grid.getXMin(), m_grid.getSizeX(), cx0, cx1);
+	cellRange(y, m_grid.getYMin(), m_grid.getSizeY(), cy0, cy1);
+
+	const size_t nCells = size_t(cx1 - cx0 + 1) * size_t(cy1 - cy0 + 1);
+	if (nCells > m_landmarks.size())
+	{
+		// Cheaper to check all the landmarks:
+		for (size_t i = 0; i < m_landmarks.size(); i++)
+			if (isNear(i)) outIndices.push_back(i);
+		return;
+	}
+
+	for (int cy = cy0; cy <= cy1; cy++)
+		for (int cx = cx0; cx <= cx1; cx++)
+			for (const int32_t i : *m_grid.cellByIndex(cx, cy))
+				if (isNear(i)) outIndices.push_back(i);
+	std::sort(outIndices.begin(), outIndices.end());
+}
+
 /*---------------------------------------------------------------
 					computeLikelihood_SIFT_LandmarkMap
   ---------------------------------------------------------------*/
@@ -1916,7 +2012,7 @@ double CLandmarksMap::computeLikelihood_SIFT_LandmarkMap(
 	double K_desc =
 		-0.5 / square(likelihoodOptions.SIFTs_sigma_descriptor_dist);
 
-	unsigned int idx1, idx2;
+	unsigned int idx1;
 	CPointPDFGaussian lm1_pose, lm2_pose;
 	CMatrixD dij(1, 3), Cij(3, 3), Cij_1;
 	double distMahaFlik2;
@@ -1930,7 +2026,14 @@ double CLandmarksMap::computeLikelihood_SIFT_LandmarkMap(
 			// lik = 1e-9;		// For consensus
 			lik = 1.0;	// For traditional
 
-			TSequenceLandmarks::const_iterator lm1, lm2;
+			const double maxMahaDist2 = std::log(1e-2) / K_dist;
+			const double maxVarThis = landmarks.getLargestPositionVariance();
+			const size_t nSIFTThis = std::count_if(
+				landmarks.begin(), landmarks.end(),
+				[](const CLandmark& lm) { return lm.getType() == featSIFT; });
+			std::vector<int32_t> candidates;
+
+			TSequenceLandmarks::const_iterator lm1;
 			for (idx1 = 0, lm1 = theMap->landmarks.begin();
 				 lm1 < theMap->landmarks.end();
 				 lm1 += decimation, idx1 += decimation)	 // Other theMap LM1
@@ -1942,12 +2045,23 @@ double CLandmarksMap::computeLikelihood_SIFT_LandmarkMap(
 
 					lik_i = 0;	// Counter
 
-					for (idx2 = 0, lm2 = landmarks.begin();
-						 lm2 != landmarks.end();
-						 lm2++, idx2++)	 // This theMap LM2
+					// Only the landmarks that may have likByDist > 1e-2 (see
+					// computeMatchingWith3DLandmarks()) are checked, the rest
+					// add 1e-10 each:
+					const double maxVar = maxVarThis + lm1->pose_cov_11 +
+						lm1->pose_cov_22 + lm1->pose_cov_33;
+					landmarks.getLandmarksNear2D(
+						lm1->pose_mean.x, lm1->pose_mean.y,
+						1.01 * std::sqrt(maxMahaDist2 * maxVar), candidates);
+					size_t nSIFTCandidates = 0;
+
+					for (const int32_t idx : candidates)  // This theMap LM2
 					{
+						const CLandmark* lm2 = landmarks.get(idx);
 						if (lm2->getType() == featSIFT)
 						{
+							nSIFTCandidates++;
+
 							// Get the pose of lm2 as an object:
 							lm2->getPose(lm2_pose);
 
@@ -2030,6 +2144,7 @@ double CLandmarksMap::computeLikelihood_SIFT_LandmarkMap(
 							}
 						}  // end if
 					}  // end for "lm2"
+					lik_i += 1e-10f * (nSIFTThis - nSIFTCandidates);
 					lik *= (0.1 + 0.9 * lik_i);	 // (TRADITIONAL) Total
 				}
 			}  // end for "lm1"
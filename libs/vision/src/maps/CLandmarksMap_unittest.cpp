@@ -0,0 +1,69 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/core/bits_math.h>
+#include <mrpt/maps/CLandmarksMap.h>
+
+#include <cmath>
+
+using mrpt::maps::CLandmarksMap;
+
+static void checkNear2D(
+	const CLandmarksMap& map, double x, double y, double maxDist)
+{
+	std::vector<int32_t> found, expected;
+	map.landmarks.getLandmarksNear2D(x, y, maxDist, found);
+	for (size_t i = 0; i < map.landmarks.size(); i++)
+	{
+		const auto& p = map.landmarks.get(i)->pose_mean;
+		if (mrpt::square(p.x - x) + mrpt::square(p.y - y) <=
+			mrpt::square(maxDist))
+			expected.push_back(i);
+	}
+	EXPECT_EQ(found, expected) << "x=" << x << " y=" << y << " r=" << maxDist;
+}
+
+TEST(CLandmarksMap, getLandmarksNear2D)
+{
+	CLandmarksMap map;
+	for (int i = 0; i < 2000; i++)
+	{
+		mrpt::maps::CLandmark lm;
+		lm.pose_mean = {
+			15.0 * std::sin(0.37 * i), 15.0 * std::cos(0.23 * i + 1.0),
+			0.1 * i};
+		lm.pose_cov_11 = lm.pose_cov_22 = lm.pose_cov_33 = 0.01f * (i % 7);
+		lm.ID = i;
+		map.landmarks.push_back(lm);
+	}
+	EXPECT_NEAR(map.landmarks.getLargestPositionVariance(), 0.18f, 1e-6);
+
+	const auto lmbCheckAll = [&]() {
+		for (double r : {0.05, 0.5, 3.0, 100.0})
+			for (int k = 0; k < 20; k++)
+				checkNear2D(map, -16.0 + 1.6 * k, 10.0 * std::cos(k), r);
+	};
+	lmbCheckAll();
+
+	// The grid must remain consistent after removing landmarks:
+	for (unsigned int i = 1900; i > 0; i -= 100)
+		map.landmarks.erase(i);
+	lmbCheckAll();
+
+	// and after modifying them:
+	for (unsigned int i = 0; i < map.landmarks.size(); i += 10)
+	{
+		map.landmarks.isToBeModified(i);
+		map.landmarks.get(i)->pose_mean.x += 25.0;
+		map.landmarks.hasBeenModified(i);
+	}
+	lmbCheckAll();
+	checkNear2D(map, 30.0, 0.0, 5.0);
+}
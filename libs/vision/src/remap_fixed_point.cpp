@@ -0,0 +1,293 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "vision-precomp.h"	 // Precompiled headers
+//
+#include <mrpt/core/WorkerThreadsPool.h>
+#include <mrpt/system/md5.h>
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "remap_fixed_point.h"
+
+// Universal include for all versions of OpenCV
+#include <mrpt/3rdparty/do_opencv_includes.h>
+
+using namespace mrpt::vision::detail;
+using mrpt::img::CImage;
+
+namespace
+{
+constexpr int TAB_SIZE = 1 << REMAP_INTER_BITS;
+// Bits of the bilinear weights, as cv::INTER_REMAP_COEF_BITS
+constexpr int COEF_BITS = 15;
+
+// Rows of output pixels per parallel task:
+constexpr unsigned int ROWS_PER_TASK = 16;
+
+// A pool shared by all the maps, so they can be freely copied and used from
+// different threads:
+std::shared_ptr<mrpt::WorkerThreadsPool> remapThreadPool(size_t nWorkers)
+{
+	static std::mutex mtx;
+	static std::shared_ptr<mrpt::WorkerThreadsPool> pool;
+	std::lock_guard<std::mutex> lck(mtx);
+	if (!pool || pool->size() != nWorkers)
+		pool = std::make_shared<mrpt::WorkerThreadsPool>(
+			nWorkers, mrpt::WorkerThreadsPool::POLICY_FIFO, "remap");
+	return pool;
+}
+
+struct TSource
+{
+	const uint8_t* data;
+	size_t step;
+	int cols, rows, ch;
+};
+
+// Remaps one row of the map into `dst` (of `src.ch` channels)
+template <int CH>
+void remapRow(
+	const TSource& src, const int16_t* xy, const uint16_t* frac,
+	unsigned int n, bool nearest, uint8_t* dst)
+{
+	const int w = src.cols, h = src.rows;
+	const std::ptrdiff_t step = static_cast<std::ptrdiff_t>(src.step);
+	for (unsigned int x = 0; x < n; x++, dst += CH)
+	{
+		const int sx = xy[2 * x], sy = xy[2 * x + 1];
+		if (nearest)
+		{
+			if (sx >= 0 && sy >= 0 && sx < w && sy < h)
+				std::copy_n(src.data + sy * step + sx * CH, CH, dst);
+			else
+				std::fill_n(dst, CH, 0);
+			continue;
+		}
+		const int f = frac[x] & (TAB_SIZE * TAB_SIZE - 1);
+		const int fx = f & (TAB_SIZE - 1), fy = f >> REMAP_INTER_BITS;
+		// (1-ax)(1-ay), etc. in units of 1/2^COEF_BITS:
+		constexpr int K = 1 << (COEF_BITS - 2 * REMAP_INTER_BITS);
+		const int w00 = (TAB_SIZE - fx) * (TAB_SIZE - fy) * K;
+		const int w01 = fx * (TAB_SIZE - fy) * K;
+		const int w10 = (TAB_SIZE - fx) * fy * K;
+		const int w11 = fx * fy * K;
+		constexpr int ROUND = 1 << (COEF_BITS - 1);
+
+		if (sx >= 0 && sy >= 0 && sx < w - 1 && sy < h - 1)
+		{
+			const uint8_t* p = src.data + sy * step + sx * CH;
+			for (int c = 0; c < CH; c++)
+				dst[c] = static_cast<uint8_t>(
+					(p[c] * w00 + p[c + CH] * w01 + p[c + step] * w10 +
+					 p[c + step + CH] * w11 + ROUND) >>
+					COEF_BITS);
+			continue;
+		}
+		// Border pixels: those out of the image are black (as
+		// cv::BORDER_CONSTANT)
+		const auto px = [&](int x, int y, int c) -> int {
+			return (x >= 0 && y >= 0 && x < w && y < h)
+				? src.data[y * step + x * CH + c]
+				: 0;
+		};
+		for (int c = 0; c < CH; c++)
+			dst[c] = static_cast<uint8_t>(
+				(px(sx, sy, c) * w00 + px(sx + 1, sy, c) * w01 +
+				 px(sx, sy + 1, c) * w10 + px(sx + 1, sy + 1, c) * w11 +
+				 ROUND) >>
+				COEF_BITS);
+	}
+}
+
+// BGR to gray, with the fixed-point coefficients of cv::cvtColor()
+void bgrToGray(const uint8_t* bgr, unsigned int n, uint8_t* gray)
+{
+	for (unsigned int x = 0; x < n; x++, bgr += 3)
+		gray[x] = static_cast<uint8_t>(
+			(bgr[0] * 1868 + bgr[1] * 9617 + bgr[2] * 4899 + (1 << 13)) >> 14);
+}
+
+struct TJobInfo
+{
+	TSource src;
+	TFixedPointMap map;
+	CImage* out;
+	unsigned int outRows;
+	int outCh;
+};
+
+// Remapped (and converted) row `y` of the map, into `dst`:
+void remapAndConvertRow(
+	const TJobInfo& j, unsigned int y, bool nearest, uint8_t* dst,
+	std::vector<uint8_t>& tmp)
+{
+	const int16_t* xy = j.map.xy + 2 * static_cast<size_t>(y) * j.map.cols;
+	const uint16_t* frac = j.map.frac + static_cast<size_t>(y) * j.map.cols;
+	if (j.src.ch == 1)
+		remapRow<1>(j.src, xy, frac, j.map.cols, nearest, dst);
+	else if (j.outCh == 3)
+		remapRow<3>(j.src, xy, frac, j.map.cols, nearest, dst);
+	else
+	{
+		tmp.resize(3 * j.map.cols);
+		remapRow<3>(j.src, xy, frac, j.map.cols, nearest, tmp.data());
+		bgrToGray(tmp.data(), j.map.cols, dst);
+	}
+}
+
+void remapBand(
+	const TJobInfo& j, unsigned int y0, unsigned int y1, bool half,
+	bool nearest)
+{
+	std::vector<uint8_t> tmp, rowA, rowB;
+	if (!half)
+	{
+		for (unsigned int y = y0; y < y1; y++)
+			remapAndConvertRow(
+				j, y, nearest, j.out->ptrLine<uint8_t>(y), tmp);
+		return;
+	}
+	const size_t rowLen = static_cast<size_t>(j.outCh) * j.map.cols;
+	rowA.resize(rowLen);
+	rowB.resize(rowLen);
+	const unsigned int outCols = j.map.cols / 2;
+	const int ch = j.outCh;
+	for (unsigned int y = y0; y < y1; y++)
+	{
+		remapAndConvertRow(j, 2 * y, nearest, rowA.data(), tmp);
+		remapAndConvertRow(j, 2 * y + 1, nearest, rowB.data(), tmp);
+		uint8_t* dst = j.out->ptrLine<uint8_t>(y);
+		for (unsigned int x = 0; x < outCols; x++)
+			for (int c = 0; c < ch; c++)
+			{
+				const size_t i = 2 * x * ch + c;
+				dst[x * ch + c] = static_cast<uint8_t>(
+					(rowA[i] + rowA[i + ch] + rowB[i] + rowB[i + ch] + 2) >> 2);
+			}
+	}
+}
+
+#if MRPT_HAS_OPENCV
+// Interpolation methods other than NN and bilinear:
+void remapWithOpenCV(
+	const TRemapJob& job, const TRemapOptions& opts,
+	mrpt::img::TInterpolationMethod interp)
+{
+	const auto& m = job.map;
+	const cv::Mat mapxy(
+		m.rows, m.cols, CV_16SC2, const_cast<int16_t*>(m.xy));
+	const cv::Mat mapf(m.rows, m.cols, CV_16UC1, const_cast<uint16_t*>(m.frac));
+	cv::Mat out;
+	cv::remap(
+		job.in->asCvMatRef(), out, mapxy, mapf, static_cast<int>(interp),
+		cv::BORDER_CONSTANT, cv::Scalar::all(0));
+	if (opts.grayscale && out.channels() == 3)
+		cv::cvtColor(out, out, cv::COLOR_BGR2GRAY);
+	if (opts.halfResolution)
+		cv::resize(
+			out, out, cv::Size(m.cols / 2, m.rows / 2), 0, 0, cv::INTER_AREA);
+	*job.out = CImage(out, mrpt::img::SHALLOW_COPY);
+}
+#endif
+}  // namespace
+
+void mrpt::vision::detail::remapFixedPoint(
+	const std::vector<TRemapJob>& jobs, const TRemapOptions& opts,
+	mrpt::img::TInterpolationMethod interp)
+{
+	MRPT_START
+	for (const auto& job : jobs)
+	{
+		ASSERT_(job.in && job.out && job.in != job.out);
+		ASSERT_(job.map.xy && job.map.frac);
+		ASSERT_(!job.in->isEmpty());
+		ASSERT_(job.in->getPixelDepth() == mrpt::img::PixelDepth::D8U);
+		ASSERTMSG_(
+			job.in->getChannelCount() == 1 || job.in->getChannelCount() == 3,
+			"Only grayscale or BGR images can be remapped");
+	}
+
+	if (interp != mrpt::img::IMG_INTERP_NN &&
+		interp != mrpt::img::IMG_INTERP_LINEAR)
+	{
+#if MRPT_HAS_OPENCV
+		for (const auto& job : jobs)
+			remapWithOpenCV(job, opts, interp);
+		return;
+#else
+		THROW_EXCEPTION("MRPT built without OpenCV!");
+#endif
+	}
+
+	// Allocate outputs and split them in bands of rows:
+	std::vector<TJobInfo> infos;
+	std::vector<std::pair<size_t, unsigned int>> tasks;
+	size_t totalPixels = 0;
+	for (const auto& job : jobs)
+	{
+		TJobInfo j;
+		j.src.data = job.in->ptrLine<uint8_t>(0);
+		j.src.step = job.in->getRowStride();
+		j.src.cols = static_cast<int>(job.in->getWidth());
+		j.src.rows = static_cast<int>(job.in->getHeight());
+		j.src.ch = static_cast<int>(job.in->getChannelCount());
+		j.map = job.map;
+		j.out = job.out;
+		j.outCh = opts.grayscale ? 1 : j.src.ch;
+
+		const unsigned int outCols =
+			opts.halfResolution ? job.map.cols / 2 : job.map.cols;
+		j.outRows = opts.halfResolution ? job.map.rows / 2 : job.map.rows;
+		job.out->resize(
+			outCols, j.outRows,
+			j.outCh == 1 ? mrpt::img::CH_GRAY : mrpt::img::CH_RGB);
+		ASSERTMSG_(
+			job.out->ptrLine<uint8_t>(0) != j.src.data,
+			"In-place remapping is not supported");
+
+		for (unsigned int y = 0; y < j.outRows; y += ROWS_PER_TASK)
+			tasks.emplace_back(infos.size(), y);
+		totalPixels += static_cast<size_t>(outCols) * j.outRows;
+		infos.push_back(j);
+	}
+
+	const bool nearest = interp == mrpt::img::IMG_INTERP_NN;
+	const auto runTask = [&](size_t t) {
+		const auto& j = infos[tasks[t].first];
+		const unsigned int y0 = tasks[t].second;
+		remapBand(
+			j, y0, std::min(y0 + ROWS_PER_TASK, j.outRows),
+			opts.halfResolution, nearest);
+	};
+
+	size_t nThreads = opts.numThreads;
+	if (!nThreads) nThreads = std::max(1U, std::thread::hardware_concurrency());
+	if (nThreads <= 1 || tasks.size() <= 1 ||
+		totalPixels < opts.minPixelsForParallel)
+	{
+		for (size_t t = 0; t < tasks.size(); t++)
+			runTask(t);
+		return;
+	}
+	// The calling thread also runs tasks:
+	remapThreadPool(nThreads - 1)->parallel_for(0, tasks.size(), 1, runTask);
+	MRPT_END
+}
+
+std::string mrpt::vision::detail::remapCacheFile(
+	const std::string& dir, const std::string& prefix,
+	const std::vector<uint8_t>& calibration)
+{
+	return dir + "/" + prefix + "_" + mrpt::system::md5(calibration) +
+		".bin";
+}
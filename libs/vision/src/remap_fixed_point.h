@@ -0,0 +1,57 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/img/CImage.h>
+#include <mrpt/vision/TRemapOptions.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace mrpt::vision::detail
+{
+/** Fractional bits of the coordinates of the fixed-point maps, as
+ * cv::INTER_BITS */
+constexpr int REMAP_INTER_BITS = 5;
+
+/** A map in the format of cv::convertMaps() to CV_16SC2 + CV_16UC1: for
+ * each output pixel, the integer source coordinates (x,y) and the index
+ * `fy * 32 + fx` of their fractional parts. */
+struct TFixedPointMap
+{
+	const int16_t* xy = nullptr;
+	const uint16_t* frac = nullptr;
+	unsigned int cols = 0, rows = 0;
+};
+
+/** An image to remap with one map */
+struct TRemapJob
+{
+	const mrpt::img::CImage* in = nullptr;
+	mrpt::img::CImage* out = nullptr;
+	TFixedPointMap map;
+};
+
+/** Remaps all the images (in parallel, in bands of rows, if so set in
+ * `opts`). Nearest neighbor and bilinear interpolation are done in a single
+ * pass with the conversion to grayscale and downscaling; other methods
+ * resort to cv::remap() and later conversions. Output images are resized
+ * only if needed. */
+void remapFixedPoint(
+	const std::vector<TRemapJob>& jobs, const TRemapOptions& opts,
+	mrpt::img::TInterpolationMethod interp);
+
+/** The file of the cached maps for a given calibration (as a serialized
+ * blob of all the parameters affecting the maps) in directory `dir` */
+std::string remapCacheFile(
+	const std::string& dir, const std::string& prefix,
+	const std::vector<uint8_t>& calibration);
+
+}  // namespace mrpt::vision::detail
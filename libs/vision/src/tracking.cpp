@@ -454,8 +454,13 @@ void CGenericFeatureTracker::internal_trackFeatures(
 	// =========================================
 	m_timlog.enter("CGenericFeatureTracker.to_grayscale");
 
-	const CImage prev_gray(old_img, FAST_REF_OR_CONVERT_TO_GRAY);
+	// The old image may be the new one of the former call:
+	const CImage prev_gray = isSameImageBuffer(old_img, m_lastNewImg)
+		? m_lastNewGray
+		: CImage(old_img, FAST_REF_OR_CONVERT_TO_GRAY);
 	const CImage cur_gray(new_img, FAST_REF_OR_CONVERT_TO_GRAY);
+	m_lastNewImg = new_img;
+	m_lastNewGray = cur_gray;
 
 	m_timlog.leave("CGenericFeatureTracker.to_grayscale");
 
@@ -654,6 +659,20 @@ void CGenericFeatureTracker::trackFeatures(
 	internal_trackFeatures<TKeyPointfList>(old_img, new_img, featureList);
 }
 
+bool CGenericFeatureTracker::isSameImageBuffer(const CImage& a, const CImage& b)
+{
+#if MRPT_HAS_OPENCV
+	if (a.isExternallyStored() || b.isExternallyStored() || a.isEmpty() ||
+		b.isEmpty())
+		return false;
+	const cv::Mat &ma = a.asCvMatRef(), &mb = b.asCvMatRef();
+	return ma.data == mb.data && ma.size() == mb.size() &&
+		ma.type() == mb.type() && ma.step[0] == mb.step[0];
+#else
+	return false;
+#endif
+}
+
 void CGenericFeatureTracker::updateAdaptiveNewFeatsThreshold(
 	const size_t nNewlyDetectedFeats, const size_t desired_num_features)
 {
@@ -0,0 +1,198 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "vision-precomp.h"	 // Precompiled headers
+//
+#include <mrpt/config.h>
+
+#include "tracking_KL_kernels.h"
+
+// ---------------------------------------------------------------------------
+//   This file contains the AVX2 versions of the Lucas-Kanade kernels of
+//   CFeatureTracker_KL. It is built with "-mavx2" (see DeclareMRPTLib.cmake),
+//   and only called if the CPU supports AVX2.
+//   Products are summed in 32-bit lanes with _mm256_madd_epi16(), and moved
+//   into 64-bit totals often enough for them not to overflow, so results are
+//   exactly those of the portable versions.
+// ---------------------------------------------------------------------------
+#if MRPT_ARCH_INTEL_COMPATIBLE
+#include <immintrin.h>
+
+using mrpt::vision::detail::KLT_W_BITS;
+using mrpt::vision::detail::klt_patch_stride;
+using mrpt::vision::detail::TKLTWeights;
+
+namespace
+{
+inline __m256i load16(const int16_t* p)
+{
+	return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+}
+inline __m256i load16(const uint8_t* p)
+{
+	return _mm256_cvtepu8_epi16(
+		_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+}
+
+// Adds the 8 lanes of `acc` to `sum`, and clears it:
+inline void flush(__m256i& acc, int64_t& sum)
+{
+	alignas(32) int32_t v[8];
+	_mm256_store_si256(reinterpret_cast<__m256i*>(v), acc);
+	for (int i = 0; i < 8; i++)
+		sum += v[i];
+	acc = _mm256_setzero_si256();
+}
+
+// Each madd sums two products of at most 2^26 in absolute value:
+constexpr size_t ITERS_PER_FLUSH = 16;
+
+template <int SHIFT, typename T>
+void interp_AVX2(
+	const T* src, size_t step, int cols, int rows, const TKLTWeights& w,
+	int16_t* out)
+{
+	const size_t stride = klt_patch_stride(cols);
+	// Interleaved weights, for the pairs (I(x), I(x+1)):
+	const __m256i w0 = _mm256_set1_epi32(
+		static_cast<int32_t>((static_cast<uint32_t>(w.w01) << 16) | w.w00));
+	const __m256i w1 = _mm256_set1_epi32(
+		static_cast<int32_t>((static_cast<uint32_t>(w.w11) << 16) | w.w10));
+	const __m256i half = _mm256_set1_epi32(1 << (SHIFT - 1));
+
+	for (int r = 0; r < rows; r++, src += step, out += stride)
+	{
+		const T* s1 = src + step;
+		for (size_t x = 0; x < stride; x += 16)
+		{
+			const __m256i a0 = load16(src + x), a1 = load16(src + x + 1);
+			const __m256i b0 = load16(s1 + x), b1 = load16(s1 + x + 1);
+			// madd works within 128-bit lanes, and so does packs:
+			const __m256i lo = _mm256_add_epi32(
+				_mm256_madd_epi16(_mm256_unpacklo_epi16(a0, a1), w0),
+				_mm256_madd_epi16(_mm256_unpacklo_epi16(b0, b1), w1));
+			const __m256i hi = _mm256_add_epi32(
+				_mm256_madd_epi16(_mm256_unpackhi_epi16(a0, a1), w0),
+				_mm256_madd_epi16(_mm256_unpackhi_epi16(b0, b1), w1));
+			_mm256_storeu_si256(
+				reinterpret_cast<__m256i*>(out + x),
+				_mm256_packs_epi32(
+					_mm256_srai_epi32(_mm256_add_epi32(lo, half), SHIFT),
+					_mm256_srai_epi32(_mm256_add_epi32(hi, half), SHIFT)));
+		}
+	}
+}
+}  // namespace
+#endif
+
+void mrpt::vision::detail::klt_scharr_row_AVX2(
+	const uint8_t* a, const uint8_t* b, const uint8_t* c, size_t n,
+	int16_t* dx, int16_t* dy)
+{
+	size_t i = 0;
+#if MRPT_ARCH_INTEL_COMPATIBLE
+	const __m256i k3 = _mm256_set1_epi16(3), k10 = _mm256_set1_epi16(10);
+	for (; i + 16 <= n; i += 16)
+	{
+		const __m256i am = load16(a + i - 1), a0 = load16(a + i),
+					  ap = load16(a + i + 1);
+		const __m256i bm = load16(b + i - 1), bp = load16(b + i + 1);
+		const __m256i cm = load16(c + i - 1), c0 = load16(c + i),
+					  cp = load16(c + i + 1);
+
+		const __m256i gx = _mm256_add_epi16(
+			_mm256_mullo_epi16(
+				_mm256_add_epi16(
+					_mm256_sub_epi16(ap, am), _mm256_sub_epi16(cp, cm)),
+				k3),
+			_mm256_mullo_epi16(_mm256_sub_epi16(bp, bm), k10));
+		const __m256i gy = _mm256_add_epi16(
+			_mm256_mullo_epi16(
+				_mm256_add_epi16(
+					_mm256_sub_epi16(cm, am), _mm256_sub_epi16(cp, ap)),
+				k3),
+			_mm256_mullo_epi16(_mm256_sub_epi16(c0, a0), k10));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dx + i), gx);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dy + i), gy);
+	}
+#endif
+	if (i < n)
+		klt_scharr_row_portable(a + i, b + i, c + i, n - i, dx + i, dy + i);
+}
+
+void mrpt::vision::detail::klt_interp_u8_AVX2(
+	const uint8_t* src, size_t step, int cols, int rows, const TKLTWeights& w,
+	int16_t* out)
+{
+#if MRPT_ARCH_INTEL_COMPATIBLE
+	interp_AVX2<KLT_W_BITS - 5>(src, step, cols, rows, w, out);
+#else
+	klt_interp_u8_portable(src, step, cols, rows, w, out);
+#endif
+}
+
+void mrpt::vision::detail::klt_interp_s16_AVX2(
+	const int16_t* src, size_t step, int cols, int rows, const TKLTWeights& w,
+	int16_t* out)
+{
+#if MRPT_ARCH_INTEL_COMPATIBLE
+	interp_AVX2<KLT_W_BITS>(src, step, cols, rows, w, out);
+#else
+	klt_interp_s16_portable(src, step, cols, rows, w, out);
+#endif
+}
+
+void mrpt::vision::detail::klt_gram_AVX2(
+	const int16_t* Ix, const int16_t* Iy, size_t n, int64_t sums[3])
+{
+	sums[0] = sums[1] = sums[2] = 0;
+#if MRPT_ARCH_INTEL_COMPATIBLE
+	__m256i xx = _mm256_setzero_si256(), xy = xx, yy = xx;
+	for (size_t i = 0, it = 0; i < n; i += 16)
+	{
+		const __m256i x = load16(Ix + i), y = load16(Iy + i);
+		xx = _mm256_add_epi32(xx, _mm256_madd_epi16(x, x));
+		xy = _mm256_add_epi32(xy, _mm256_madd_epi16(x, y));
+		yy = _mm256_add_epi32(yy, _mm256_madd_epi16(y, y));
+		if (++it == ITERS_PER_FLUSH || i + 16 >= n)
+		{
+			flush(xx, sums[0]);
+			flush(xy, sums[1]);
+			flush(yy, sums[2]);
+			it = 0;
+		}
+	}
+#else
+	klt_gram_portable(Ix, Iy, n, sums);
+#endif
+}
+
+void mrpt::vision::detail::klt_residual_AVX2(
+	const int16_t* J, const int16_t* I, const int16_t* Ix, const int16_t* Iy,
+	size_t n, int64_t sums[2])
+{
+	sums[0] = sums[1] = 0;
+#if MRPT_ARCH_INTEL_COMPATIBLE
+	__m256i b1 = _mm256_setzero_si256(), b2 = b1;
+	for (size_t i = 0, it = 0; i < n; i += 16)
+	{
+		const __m256i d = _mm256_sub_epi16(load16(J + i), load16(I + i));
+		b1 = _mm256_add_epi32(b1, _mm256_madd_epi16(d, load16(Ix + i)));
+		b2 = _mm256_add_epi32(b2, _mm256_madd_epi16(d, load16(Iy + i)));
+		if (++it == ITERS_PER_FLUSH || i + 16 >= n)
+		{
+			flush(b1, sums[0]);
+			flush(b2, sums[1]);
+			it = 0;
+		}
+	}
+#else
+	klt_residual_portable(J, I, Ix, Iy, n, sums);
+#endif
+}
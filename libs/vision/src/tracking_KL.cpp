@@ -9,10 +9,19 @@
 
 #include "vision-precomp.h"	 // Precompiled headers
 //
+#include <mrpt/core/cpu.h>
+#include <mrpt/core/round.h>
 #include <mrpt/system/memory.h>
 #include <mrpt/vision/CFeatureExtraction.h>
 #include <mrpt/vision/tracking.h>
 
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <thread>
+
+#include "tracking_KL_kernels.h"
+
 // Universal include for all versions of OpenCV
 #include <mrpt/3rdparty/do_opencv_includes.h>
 
@@ -25,6 +34,268 @@ using namespace mrpt::vision;
 using namespace mrpt::img;
 using namespace std;
 
+#if MRPT_HAS_OPENCV
+namespace
+{
+using namespace mrpt::vision::detail;
+
+// Sums of products of int16 values, to floats (as cv::calcOpticalFlowPyrLK)
+constexpr float FLT_SCALE = 1.f / (1 << 20);
+
+TKLTKernels selectKLTKernels(bool useSIMD)
+{
+	if (useSIMD && mrpt::cpu::supports(mrpt::cpu::feature::AVX2))
+		return {
+			&klt_scharr_row_AVX2, &klt_interp_u8_AVX2, &klt_interp_s16_AVX2,
+			&klt_gram_AVX2, &klt_residual_AVX2};
+	return {
+		&klt_scharr_row_portable, &klt_interp_u8_portable,
+		&klt_interp_s16_portable, &klt_gram_portable, &klt_residual_portable};
+}
+
+TKLTWeights bilinearWeights(float ax, float ay)
+{
+	constexpr float one = 1 << KLT_W_BITS;
+	TKLTWeights w;
+	w.w00 = mrpt::round((1.f - ax) * (1.f - ay) * one);
+	w.w01 = mrpt::round(ax * (1.f - ay) * one);
+	w.w10 = mrpt::round((1.f - ax) * ay * one);
+	w.w11 = (1 << KLT_W_BITS) - w.w00 - w.w01 - w.w10;
+	return w;
+}
+
+// A pyramid level of the old image (I) with its derivatives, and the new
+// one (J). Pointers to pixel (0,0), with `pad` valid pixels around.
+struct TLKLevel
+{
+	const uint8_t *I = nullptr, *J = nullptr;
+	const int16_t *dx = nullptr, *dy = nullptr;
+	std::ptrdiff_t stepI = 0, stepJ = 0, stepD = 0;
+	int cols = 0, rows = 0;
+};
+
+struct TLKParams
+{
+	int winW = 15, winH = 15;
+	int maxIters = 10;
+	float eps2 = 0.01f;	 // Squared minimum step
+	float minEig = 1e-4f;
+};
+
+struct TLKResult
+{
+	float x = 0, y = 0, err = 0;
+	bool ok = true;
+};
+
+// Scharr derivatives of rows [y0,y1) of a padded level, except its outer
+// ring of pixels, which is left untouched (zero):
+void levelDerivatives(
+	const cv::Mat& lvl, int pad, int y0, int y1, std::ptrdiff_t stepD,
+	int16_t* dx, int16_t* dy, const TKLTKernels& k)
+{
+	const size_t n = static_cast<size_t>(lvl.cols + 2 * pad - 2);
+	const auto step = static_cast<std::ptrdiff_t>(lvl.step[0]);
+	for (int y = y0; y < y1; y++)
+	{
+		// Inner pixel (-pad+1, y) of the level:
+		const uint8_t* b = lvl.ptr<uint8_t>(0) + y * step - pad + 1;
+		const std::ptrdiff_t o = (y + pad) * stepD + 1;
+		k.scharr(b - step, b, b + step, n, dx + o, dy + o);
+	}
+}
+
+// Pyramidal Lucas-Kanade of `n` features, as in cv::calcOpticalFlowPyrLK()
+// (J.-Y. Bouguet, "Pyramidal implementation of the Lucas Kanade feature
+// tracker", 2000). All the patches of the features are packed for each level
+// before running their iterations.
+void trackFeaturesLK(
+	const std::vector<TLKLevel>& levels, const TLKParams& p,
+	const TKLTKernels& k, const cv::Point2f* prevPts, size_t n,
+	TLKResult* out)
+{
+	const int maxLevel = static_cast<int>(levels.size()) - 1;
+	const size_t stride = klt_patch_stride(p.winW);
+	const size_t area = stride * p.winH;
+	const float halfW = (p.winW - 1) * 0.5f, halfH = (p.winH - 1) * 0.5f;
+	const float winArea = static_cast<float>(p.winW * p.winH);
+
+	// I, Ix, Iy of each feature, and the interpolated new patch:
+	std::vector<int16_t> patches(3 * area * n), J(area);
+	struct TState
+	{
+		float A11 = 0, A12 = 0, A22 = 0, invD = 0;
+		bool active = false;
+	};
+	std::vector<TState> st(n);
+
+	auto isOutside = [&p](int ix, int iy, const TLKLevel& lv) {
+		return ix < -p.winW || ix >= lv.cols || iy < -p.winH || iy >= lv.rows;
+	};
+
+	for (int L = maxLevel; L >= 0; L--)
+	{
+		const TLKLevel& lv = levels[L];
+		const float scale = 1.f / static_cast<float>(1 << L);
+
+		// 1) Pack the old patches, and their spatial gradient matrices:
+		for (size_t i = 0; i < n; i++)
+		{
+			TLKResult& r = out[i];
+			TState& s = st[i];
+			s.active = false;
+			if (!r.ok) continue;
+
+			const float px = prevPts[i].x * scale - halfW;
+			const float py = prevPts[i].y * scale - halfH;
+			if (L == maxLevel)
+			{
+				r.x = px + halfW;
+				r.y = py + halfH;
+			}
+			else
+			{
+				r.x *= 2;
+				r.y *= 2;
+			}
+
+			const int ix = static_cast<int>(std::floor(px));
+			const int iy = static_cast<int>(std::floor(py));
+			if (isOutside(ix, iy, lv))
+			{
+				if (L == 0) r.ok = false;
+				continue;
+			}
+			const TKLTWeights w = bilinearWeights(px - ix, py - iy);
+			int16_t* I = &patches[3 * area * i];
+			int16_t* Ix = I + area;
+			int16_t* Iy = Ix + area;
+			k.interp_u8(
+				lv.I + iy * lv.stepI + ix, lv.stepI, p.winW, p.winH, w, I);
+			const std::ptrdiff_t oD = iy * lv.stepD + ix;
+			k.interp_s16(lv.dx + oD, lv.stepD, p.winW, p.winH, w, Ix);
+			k.interp_s16(lv.dy + oD, lv.stepD, p.winW, p.winH, w, Iy);
+			// Padding values must not count in the sums:
+			for (int row = 0; row < p.winH; row++)
+				for (size_t c = p.winW; c < stride; c++)
+					Ix[row * stride + c] = Iy[row * stride + c] = 0;
+
+			int64_t g[3];
+			k.gram(Ix, Iy, area, g);
+			s.A11 = g[0] * FLT_SCALE;
+			s.A12 = g[1] * FLT_SCALE;
+			s.A22 = g[2] * FLT_SCALE;
+			const float D = s.A11 * s.A22 - s.A12 * s.A12;
+			const float minEig = (s.A22 + s.A11 -
+								  std::sqrt(
+									  (s.A11 - s.A22) * (s.A11 - s.A22) +
+									  4.f * s.A12 * s.A12)) /
+				(2 * winArea);
+			if (minEig < p.minEig || D < FLT_EPSILON)
+			{
+				if (L == 0) r.ok = false;
+				continue;
+			}
+			s.invD = 1.f / D;
+			s.active = true;
+		}
+
+		// 2) Lucas-Kanade iterations:
+		for (size_t i = 0; i < n; i++)
+		{
+			const TState& s = st[i];
+			if (!s.active) continue;
+			TLKResult& r = out[i];
+			const int16_t* I = &patches[3 * area * i];
+			const int16_t* Ix = I + area;
+			const int16_t* Iy = Ix + area;
+
+			float nx = r.x - halfW, ny = r.y - halfH;
+			float prevDx = 0, prevDy = 0;
+			for (int j = 0; j < p.maxIters; j++)
+			{
+				const int ix = static_cast<int>(std::floor(nx));
+				const int iy = static_cast<int>(std::floor(ny));
+				if (isOutside(ix, iy, lv))
+				{
+					if (L == 0) r.ok = false;
+					break;
+				}
+				k.interp_u8(
+					lv.J + iy * lv.stepJ + ix, lv.stepJ, p.winW, p.winH,
+					bilinearWeights(nx - ix, ny - iy), J.data());
+				int64_t b[2];
+				k.residual(J.data(), I, Ix, Iy, area, b);
+				const float b1 = b[0] * FLT_SCALE, b2 = b[1] * FLT_SCALE;
+
+				const float dx = (s.A12 * b2 - s.A22 * b1) * s.invD;
+				const float dy = (s.A12 * b1 - s.A11 * b2) * s.invD;
+				nx += dx;
+				ny += dy;
+				r.x = nx + halfW;
+				r.y = ny + halfH;
+				if (dx * dx + dy * dy <= p.eps2) break;
+				// Oscillating around the solution:
+				if (j > 0 && std::abs(dx + prevDx) < 0.01f &&
+					std::abs(dy + prevDy) < 0.01f)
+				{
+					r.x -= dx * 0.5f;
+					r.y -= dy * 0.5f;
+					break;
+				}
+				prevDx = dx;
+				prevDy = dy;
+			}
+		}
+	}
+
+	// Tracking error: mean absolute difference of intensities.
+	const TLKLevel& lv = levels[0];
+	for (size_t i = 0; i < n; i++)
+	{
+		TLKResult& r = out[i];
+		if (!r.ok) continue;
+		const float nx = r.x - halfW, ny = r.y - halfH;
+		const int ix = static_cast<int>(std::floor(nx));
+		const int iy = static_cast<int>(std::floor(ny));
+		if (isOutside(ix, iy, lv))
+		{
+			r.ok = false;
+			continue;
+		}
+		k.interp_u8(
+			lv.J + iy * lv.stepJ + ix, lv.stepJ, p.winW, p.winH,
+			bilinearWeights(nx - ix, ny - iy), J.data());
+		const int16_t* I = &patches[3 * area * i];
+		int64_t sumAbs = 0;
+		for (int row = 0; row < p.winH; row++)
+			for (int c = 0; c < p.winW; c++)
+				sumAbs += std::abs(J[row * stride + c] - I[row * stride + c]);
+		r.err = static_cast<float>(sumAbs) / (32 * winArea);
+	}
+}
+}  // namespace
+#endif
+
+void CFeatureTracker_KL::internal_forEach(
+	size_t n, size_t nThreads, const std::function<void(size_t)>& fn)
+{
+	if (!nThreads) nThreads = std::max(1U, std::thread::hardware_concurrency());
+
+	if (nThreads <= 1 || n <= 1)
+	{
+		for (size_t i = 0; i < n; i++)
+			fn(i);
+		return;
+	}
+	// The calling thread also runs tasks:
+	if (!m_threadPool || m_threadPool->size() != nThreads - 1)
+		m_threadPool = std::make_shared<mrpt::WorkerThreadsPool>(
+			nThreads - 1, mrpt::WorkerThreadsPool::POLICY_FIFO,
+			"CFeatureTracker_KL");
+	m_threadPool->parallel_for(0, n, 1, fn);
+}
+
 /** Track a set of features from old_img -> new_img using sparse optimal flow
  *(classic KL method)
  *  Optional parameters that can be passed in "extra_params":
@@ -46,9 +317,16 @@ void CFeatureTracker_KL::trackFeatures_impl_templ(
 
 	const int LK_levels = extra_params.getOrDefault<int>("LK_levels", 3);
 	const int LK_max_iters = extra_params.getOrDefault<int>("LK_max_iters", 10);
-	const int LK_epsilon = extra_params.getOrDefault<int>("LK_epsilon", 0.1);
+	const double LK_epsilon =
+		extra_params.getOrDefault<double>("LK_epsilon", 0.1);
 	const float LK_max_tracking_error =
 		extra_params.getOrDefault<float>("LK_max_tracking_error", 150.0f);
+	const bool LK_use_opencv =
+		extra_params.getOrDefault<bool>("LK_use_opencv", false);
+	const bool LK_use_SIMD =
+		extra_params.getOrDefault<bool>("LK_use_SIMD", true);
+	const size_t LK_num_threads =
+		extra_params.getOrDefault<size_t>("LK_num_threads", 0);
 
 	// Both images must be of the same size
 	ASSERT_(
@@ -60,13 +338,30 @@ void CFeatureTracker_KL::trackFeatures_impl_templ(
 
 	const size_t nFeatures = featureList.size();  // Number of features
 
-	// Grayscale images
-	const CImage prev_gray(old_img, FAST_REF_OR_CONVERT_TO_GRAY);
-	const CImage cur_gray(new_img, FAST_REF_OR_CONVERT_TO_GRAY);
-
 	// Array conversion MRPT->OpenCV
 	if (nFeatures > 0)
 	{
+		// Grayscale pyramids, with the border required by OpenCV and by the
+		// reads of whole SIMD vectors. That of the old image is reused from
+		// the former call, if possible:
+		m_timlog.enter("CFeatureTracker_KL.pyramids");
+		const int pad = std::max(window_width, window_height) + 16;
+		const auto buildPyr = [&](CImagePyramid& pyr, const CImage& img) {
+			pyr.borderPadding = pad;
+			pyr.buildPyramid(
+				img, LK_levels + 1, PyramidFilter::Gaussian5, true);
+		};
+		if (isSameImageBuffer(old_img, m_curPyrSource) &&
+			m_curPyr.borderPadding == static_cast<unsigned>(pad) &&
+			m_curPyr.images.size() == static_cast<size_t>(LK_levels + 1))
+			std::swap(m_prevPyr, m_curPyr);
+		else
+			buildPyr(m_prevPyr, old_img);
+		// Into the buffers of the pyramid of two frames ago:
+		buildPyr(m_curPyr, new_img);
+		m_curPyrSource = new_img;
+		m_timlog.leave("CFeatureTracker_KL.pyramids");
+
 		std::vector<cv::Point2f> points_prev(nFeatures), points_cur;
 		std::vector<uchar> status(nFeatures);
 		std::vector<float> track_error(nFeatures);
@@ -77,15 +372,96 @@ void CFeatureTracker_KL::trackFeatures_impl_templ(
 			points_prev[i].y = featureList.getFeatureY(i);
 		}
 
-		const cv::Mat& prev = prev_gray.asCvMatRef();
-		const cv::Mat& cur = cur_gray.asCvMatRef();
+		if (LK_use_opencv)
+		{
+			std::vector<cv::Mat> prev, cur;
+			for (const auto& lvl : m_prevPyr.images)
+				prev.push_back(lvl.asCvMatRef());
+			for (const auto& lvl : m_curPyr.images)
+				cur.push_back(lvl.asCvMatRef());
 
-		cv::calcOpticalFlowPyrLK(
-			prev, cur, points_prev, points_cur, status, track_error,
-			cv::Size(window_width, window_height), LK_levels,
-			cv::TermCriteria(
-				cv::TermCriteria::MAX_ITER | cv::TermCriteria::EPS,
-				LK_max_iters, LK_epsilon));
+			cv::calcOpticalFlowPyrLK(
+				prev, cur, points_prev, points_cur, status, track_error,
+				cv::Size(window_width, window_height), LK_levels,
+				cv::TermCriteria(
+					cv::TermCriteria::MAX_ITER | cv::TermCriteria::EPS,
+					LK_max_iters, LK_epsilon));
+		}
+		else
+		{
+			mrpt::system::CTimeLoggerEntry tle(
+				m_timlog, "CFeatureTracker_KL.batched_LK");
+			const TKLTKernels k = selectKLTKernels(LK_use_SIMD);
+
+			// Derivatives of each level of the old image, computed once:
+			const size_t nLevels = m_prevPyr.images.size();
+			m_derivX.resize(nLevels);
+			m_derivY.resize(nLevels);
+			std::vector<TLKLevel> levels(nLevels);
+			for (size_t L = 0; L < nLevels; L++)
+			{
+				const cv::Mat& I = m_prevPyr.images[L].asCvMatRef();
+				const cv::Mat& J = m_curPyr.images[L].asCvMatRef();
+				const std::ptrdiff_t stepD = I.cols + 2 * pad;
+				const size_t len = stepD * (I.rows + 2 * pad);
+				if (m_derivX[L].size() != len)
+				{
+					m_derivX[L].assign(len, 0);
+					m_derivY[L].assign(len, 0);
+				}
+				TLKLevel& lv = levels[L];
+				lv.I = I.ptr<uint8_t>(0);
+				lv.J = J.ptr<uint8_t>(0);
+				lv.stepI = I.step[0];
+				lv.stepJ = J.step[0];
+				lv.stepD = stepD;
+				lv.dx = m_derivX[L].data() + pad * stepD + pad;
+				lv.dy = m_derivY[L].data() + pad * stepD + pad;
+				lv.cols = I.cols;
+				lv.rows = I.rows;
+			}
+			// In blocks of rows of all the levels:
+			constexpr int ROWS_PER_TASK = 32;
+			std::vector<std::pair<size_t, int>> derivTasks;
+			for (size_t L = 0; L < nLevels; L++)
+				for (int y = -pad + 1; y < levels[L].rows + pad - 1;
+					 y += ROWS_PER_TASK)
+					derivTasks.emplace_back(L, y);
+			internal_forEach(derivTasks.size(), LK_num_threads, [&](size_t t) {
+				const auto [L, y0] = derivTasks[t];
+				const auto& lv = levels[L];
+				levelDerivatives(
+					m_prevPyr.images[L].asCvMatRef(), pad, y0,
+					std::min(y0 + ROWS_PER_TASK, lv.rows + pad - 1), lv.stepD,
+					m_derivX[L].data(), m_derivY[L].data(), k);
+			});
+
+			TLKParams p;
+			p.winW = window_width;
+			p.winH = window_height;
+			p.maxIters = LK_max_iters;
+			p.eps2 = static_cast<float>(LK_epsilon * LK_epsilon);
+
+			// Features are tracked in chunks, in parallel:
+			constexpr size_t FEATS_PER_TASK = 32;
+			std::vector<TLKResult> res(nFeatures);
+			internal_forEach(
+				(nFeatures + FEATS_PER_TASK - 1) / FEATS_PER_TASK,
+				LK_num_threads, [&](size_t t) {
+					const size_t i0 = t * FEATS_PER_TASK;
+					const size_t n = std::min(FEATS_PER_TASK, nFeatures - i0);
+					trackFeaturesLK(
+						levels, p, k, &points_prev[i0], n, &res[i0]);
+				});
+
+			points_cur.resize(nFeatures);
+			for (size_t i = 0; i < nFeatures; i++)
+			{
+				points_cur[i] = cv::Point2f(res[i].x, res[i].y);
+				status[i] = res[i].ok ? 1 : 0;
+				track_error[i] = res[i].err;
+			}
+		}
 
 		for (size_t i = 0; i < nFeatures; ++i)
 		{
@@ -0,0 +1,169 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mrpt::vision::detail
+{
+/** Fractional bits of the bilinear interpolation weights, as in
+ * cv::calcOpticalFlowPyrLK() */
+constexpr int KLT_W_BITS = 14;
+
+/** Bilinear interpolation weights of pixels (x,y), (x+1,y), (x,y+1) and
+ * (x+1,y+1), adding up to 1 << KLT_W_BITS */
+struct TKLTWeights
+{
+	int32_t w00 = 0, w01 = 0, w10 = 0, w11 = 0;
+};
+
+/** Packed patches hold rows of this many int16 values, a multiple of 16 */
+inline size_t klt_patch_stride(int cols)
+{
+	return (static_cast<size_t>(cols) + 15) & ~static_cast<size_t>(15);
+}
+
+/** Scharr derivatives, unnormalized ([-3 0 3; -10 0 10; -3 0 3] and its
+ * transpose), of the pixels [0,n) of row `b`, with `a` and `c` the rows above
+ * and below. Pixels -1 and n are also read. */
+using klt_scharr_row_t = void (*)(
+	const uint8_t* a, const uint8_t* b, const uint8_t* c, size_t n,
+	int16_t* dx, int16_t* dy);
+
+/** Bilinear interpolation of `rows` x `cols` pixels starting at `src` (rows
+ * of `step` pixels), into `out`, with rows of klt_patch_stride(cols) values.
+ * Intensities are scaled by 32 (5 fractional bits). The output values past
+ * `cols` are undefined, and the input pixels up to klt_patch_stride(cols)
+ * (plus one) may be read. */
+using klt_interp_u8_t = void (*)(
+	const uint8_t* src, size_t step, int cols, int rows, const TKLTWeights& w,
+	int16_t* out);
+
+/** Like klt_interp_u8_t, for derivatives (without any extra scaling) */
+using klt_interp_s16_t = void (*)(
+	const int16_t* src, size_t step, int cols, int rows, const TKLTWeights& w,
+	int16_t* out);
+
+/** sums = {sum(Ix^2), sum(Ix*Iy), sum(Iy^2)} over `n` values, a multiple of
+ * 16 */
+using klt_gram_t =
+	void (*)(const int16_t* Ix, const int16_t* Iy, size_t n, int64_t sums[3]);
+
+/** sums = {sum((J-I)*Ix), sum((J-I)*Iy)} over `n` values, a multiple of 16 */
+using klt_residual_t = void (*)(
+	const int16_t* J, const int16_t* I, const int16_t* Ix, const int16_t* Iy,
+	size_t n, int64_t sums[2]);
+
+struct TKLTKernels
+{
+	klt_scharr_row_t scharr;
+	klt_interp_u8_t interp_u8;
+	klt_interp_s16_t interp_s16;
+	klt_gram_t gram;
+	klt_residual_t residual;
+};
+
+inline void klt_scharr_row_portable(
+	const uint8_t* a, const uint8_t* b, const uint8_t* c, size_t n,
+	int16_t* dx, int16_t* dy)
+{
+	for (size_t i = 0; i < n; i++)
+	{
+		const int x = static_cast<int>(i);
+		dx[i] = static_cast<int16_t>(
+			3 * (a[x + 1] - a[x - 1] + c[x + 1] - c[x - 1]) +
+			10 * (b[x + 1] - b[x - 1]));
+		dy[i] = static_cast<int16_t>(
+			3 * (c[x - 1] - a[x - 1] + c[x + 1] - a[x + 1]) +
+			10 * (c[x] - a[x]));
+	}
+}
+
+template <int SHIFT, typename T>
+inline void klt_interp_portable(
+	const T* src, size_t step, int cols, int rows, const TKLTWeights& w,
+	int16_t* out)
+{
+	const size_t stride = klt_patch_stride(cols);
+	for (int r = 0; r < rows; r++, src += step, out += stride)
+	{
+		const T* s1 = src + step;
+		for (int x = 0; x < cols; x++)
+		{
+			const int32_t v = src[x] * w.w00 + src[x + 1] * w.w01 +
+				s1[x] * w.w10 + s1[x + 1] * w.w11;
+			out[x] = static_cast<int16_t>((v + (1 << (SHIFT - 1))) >> SHIFT);
+		}
+		for (size_t x = cols; x < stride; x++)
+			out[x] = 0;
+	}
+}
+
+inline void klt_interp_u8_portable(
+	const uint8_t* src, size_t step, int cols, int rows, const TKLTWeights& w,
+	int16_t* out)
+{
+	klt_interp_portable<KLT_W_BITS - 5>(src, step, cols, rows, w, out);
+}
+
+inline void klt_interp_s16_portable(
+	const int16_t* src, size_t step, int cols, int rows, const TKLTWeights& w,
+	int16_t* out)
+{
+	klt_interp_portable<KLT_W_BITS>(src, step, cols, rows, w, out);
+}
+
+inline void klt_gram_portable(
+	const int16_t* Ix, const int16_t* Iy, size_t n, int64_t sums[3])
+{
+	int64_t xx = 0, xy = 0, yy = 0;
+	for (size_t i = 0; i < n; i++)
+	{
+		xx += Ix[i] * Ix[i];
+		xy += Ix[i] * Iy[i];
+		yy += Iy[i] * Iy[i];
+	}
+	sums[0] = xx;
+	sums[1] = xy;
+	sums[2] = yy;
+}
+
+inline void klt_residual_portable(
+	const int16_t* J, const int16_t* I, const int16_t* Ix, const int16_t* Iy,
+	size_t n, int64_t sums[2])
+{
+	int64_t b1 = 0, b2 = 0;
+	for (size_t i = 0; i < n; i++)
+	{
+		const int32_t d = J[i] - I[i];
+		b1 += d * Ix[i];
+		b2 += d * Iy[i];
+	}
+	sums[0] = b1;
+	sums[1] = b2;
+}
+
+/** Only call them if mrpt::cpu::supports(mrpt::cpu::feature::AVX2) */
+void klt_scharr_row_AVX2(
+	const uint8_t* a, const uint8_t* b, const uint8_t* c, size_t n,
+	int16_t* dx, int16_t* dy);
+void klt_interp_u8_AVX2(
+	const uint8_t* src, size_t step, int cols, int rows, const TKLTWeights& w,
+	int16_t* out);
+void klt_interp_s16_AVX2(
+	const int16_t* src, size_t step, int cols, int rows, const TKLTWeights& w,
+	int16_t* out);
+void klt_gram_AVX2(
+	const int16_t* Ix, const int16_t* Iy, size_t n, int64_t sums[3]);
+void klt_residual_AVX2(
+	const int16_t* J, const int16_t* I, const int16_t* Ix, const int16_t* Iy,
+	size_t n, int64_t sums[2]);
+
+}  // namespace mrpt::vision::detail
@@ -0,0 +1,86 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/config.h>
+#include <mrpt/vision/tracking.h>
+
+#include <cmath>
+
+using mrpt::img::CImage;
+using mrpt::vision::CFeatureTracker_KL;
+using mrpt::vision::TKeyPointf;
+using mrpt::vision::TKeyPointfList;
+
+#if MRPT_HAS_OPENCV
+namespace
+{
+// A smooth pattern, shifted by (dx,dy):
+CImage syntheticImage(unsigned int w, unsigned int h, float dx, float dy)
+{
+	CImage img(w, h, mrpt::img::CH_GRAY);
+	for (unsigned int y = 0; y < h; y++)
+	{
+		auto* row = img.ptrLine<uint8_t>(y);
+		for (unsigned int x = 0; x < w; x++)
+		{
+			const float u = x - dx, v = y - dy;
+			row[x] = static_cast<uint8_t>(std::lround(
+				128 + 60 * std::sin(u * 0.11f) * std::cos(v * 0.07f) +
+				40 * std::sin((u + v) * 0.05f)));
+		}
+	}
+	return img;
+}
+
+TKeyPointfList gridOfFeatures(unsigned int w, unsigned int h)
+{
+	TKeyPointfList feats;
+	for (unsigned int y = 20; y + 20 < h; y += 23)
+		for (unsigned int x = 20; x + 20 < w; x += 29)
+			feats.push_back(TKeyPointf(x + 0.25f, y + 0.5f));
+	return feats;
+}
+}  // namespace
+
+TEST(CFeatureTracker_KL, batchedTrackerMatchesOpenCV)
+{
+	const unsigned int W = 320, H = 240;
+	const float dx = 6.6f, dy = -4.2f;
+	const CImage img1 = syntheticImage(W, H, 0, 0);
+	const CImage img2 = syntheticImage(W, H, dx, dy);
+	const TKeyPointfList initial = gridOfFeatures(W, H);
+
+	const auto track = [&](bool opencv, bool simd, size_t nThreads) {
+		CFeatureTracker_KL tracker;
+		tracker.extra_params["LK_use_opencv"] = opencv;
+		tracker.extra_params["LK_use_SIMD"] = simd;
+		tracker.extra_params["LK_num_threads"] = nThreads;
+		TKeyPointfList feats = initial;
+		tracker.trackFeatures(img1, img2, feats);
+		return feats;
+	};
+	const TKeyPointfList ref = track(true, false, 1);
+	for (const bool simd : {false, true})
+		for (const size_t nThreads : {1, 4})
+		{
+			const TKeyPointfList feats = track(false, simd, nThreads);
+			ASSERT_EQ(feats.size(), initial.size());
+			for (size_t i = 0; i < feats.size(); i++)
+			{
+				ASSERT_EQ(feats[i].track_status, mrpt::vision::status_TRACKED)
+					<< "i=" << i << " simd=" << simd;
+				EXPECT_NEAR(feats[i].pt.x, initial[i].pt.x + dx, 0.2);
+				EXPECT_NEAR(feats[i].pt.y, initial[i].pt.y + dy, 0.2);
+				EXPECT_NEAR(feats[i].pt.x, ref[i].pt.x, 0.05);
+				EXPECT_NEAR(feats[i].pt.y, ref[i].pt.y, 0.05);
+			}
+		}
+}
+#endif
@@ -23,6 +23,7 @@
 #include <mrpt/system/filesystem.h>
 #include <mrpt/vision/CFeature.h>
 #include <mrpt/vision/CFeatureExtraction.h>
+#include <mrpt/vision/CTemplateMatcher.h>
 #include <mrpt/vision/pinhole.h>
 #include <mrpt/vision/utils.h>
 
@@ -449,8 +450,15 @@ size_t vision::matchFeatures(
 						// Ensure that both features have patches
 						ASSERT_(
 							itList1->patchSize > 0 && itList2->patchSize > 0);
-						vision::openCV_cross_correlation(
-							*itList1->patch, *itList2->patch, u, v, res);
+						const CImage& p1 = *itList1->patch;
+						const CImage& p2 = *itList2->patch;
+						if (!p1.isColor() && !p2.isColor() &&
+							p1.getWidth() == p2.getWidth() &&
+							p1.getHeight() == p2.getHeight())
+							res = CTemplateMatcher::patchCorrelation(p1, p2);
+						else
+							vision::openCV_cross_correlation(
+								p1, p2, u, v, res);
 
 						// Search for the two maximum values
 						if (res > maxCC1)
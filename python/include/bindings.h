@@ -88,6 +88,48 @@ void IndexError();
 void TypeError(std::string message);
 // end of Helpers
 
+// NumPy arrays (see numpy_bindings.cpp)
+enum class NumpyType
+{
+	UInt8,
+	UInt16,
+	Float32,
+	Float64
+};
+/** Must be called once, on module initialization */
+void import_numpy();
+/** A NumPy array sharing the memory `data` (shape in elements, strides in
+ * bytes) without copying it. The array holds a reference to `owner`, the
+ * Python object `data` belongs to, so it stays alive as long as the array,
+ * but the view is invalidated if the owner container is resized. */
+boost::python::object numpy_view(
+	boost::python::object owner, void* data, NumpyType type,
+	const std::vector<Py_ssize_t>& shape,
+	const std::vector<Py_ssize_t>& strides, bool writeable);
+/** A new, zero-filled, C-contiguous NumPy array */
+boost::python::object numpy_empty(
+	NumpyType type, const std::vector<Py_ssize_t>& shape);
+/** Converts any array-like object into a C-contiguous, aligned NumPy array
+ * of the given type, only copying it if needed */
+boost::python::object numpy_contiguous(
+	boost::python::object obj, NumpyType type);
+void* numpy_data(const boost::python::object& arr);
+std::vector<Py_ssize_t> numpy_shape(const boost::python::object& arr);
+
+/** Releases the Python GIL in the current scope, so other Python threads may
+ * run during long batch computations. No Python object may be used within. */
+struct ScopedGILRelease
+{
+	ScopedGILRelease() : m_state(PyEval_SaveThread()) {}
+	~ScopedGILRelease() { PyEval_RestoreThread(m_state); }
+	ScopedGILRelease(const ScopedGILRelease&) = delete;
+	ScopedGILRelease& operator=(const ScopedGILRelease&) = delete;
+
+   private:
+	PyThreadState* m_state;
+};
+// end of NumPy arrays
+
 // STL list-like containers (vector, list, deque)
 template <class T>
 struct StlListLike
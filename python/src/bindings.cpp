@@ -50,6 +50,9 @@ BOOST_PYTHON_MODULE(pymrpt)
 	package.attr("__path__") = "pymrpt";
 	package.attr("greeter") = greeter;
 
+	// NumPy C API, for zero-copy array views of MRPT containers
+	import_numpy();
+
 	// STL
 	{
 		object stl_module(handle<>(borrowed(PyImport_AddModule("pymrpt.stl"))));
@@ -16,6 +16,8 @@
 #include <mrpt/maps/TMetricMapInitializer.h>
 #include <mrpt/maps/metric_map_types.h>
 #include <mrpt/opengl/CSetOfObjects.h>
+#include <mrpt/poses/CPose2D.h>
+#include <mrpt/poses/CPose3D.h>
 #include <mrpt/poses/CPosePDFGaussian.h>
 #include <mrpt/system/datetime.h>
 
@@ -51,6 +53,36 @@ CSetOfObjects::Ptr CMetricMap_getAs3DObject(CMetricMap& me)
 {
 	return me.getVisualization();
 }
+
+// Evaluates the observation likelihood for N poses, given as a Nx3 (x, y,
+// phi) or Nx6 (x, y, z, yaw, pitch, roll) array:
+object CMetricMap_computeObservationLikelihoods(
+	CMetricMap& me, const CObservation& obs, object poses)
+{
+	object p = numpy_contiguous(poses, NumpyType::Float64);
+	const auto shape = numpy_shape(p);
+	if (shape.size() != 2 || (shape[1] != 3 && shape[1] != 6))
+		TypeError("poses must be a Nx3 (x,y,phi) or Nx6 (x,y,z,yaw,pitch,roll) "
+				  "array");
+	const size_t N = static_cast<size_t>(shape[0]), dim = shape[1];
+	const auto* in = static_cast<const double*>(numpy_data(p));
+
+	object ret = numpy_empty(NumpyType::Float64, {shape[0]});
+	auto* out = static_cast<double*>(numpy_data(ret));
+	{
+		ScopedGILRelease noGIL;
+		for (size_t i = 0; i < N; i++)
+		{
+			const double* q = in + i * dim;
+			const CPose3D pose = dim == 3
+				? CPose3D(CPose2D(q[0], q[1], q[2]))
+				: CPose3D(q[0], q[1], q[2], q[3], q[4], q[5]);
+			out[i] = me.computeObservationLikelihood(obs, pose);
+		}
+	}
+	return ret;
+}
+
 BOOST_PYTHON_FUNCTION_OVERLOADS(
 	CMetricMap_insertObservation_overloads, CMetricMap_insertObservation, 2, 3)
 BOOST_PYTHON_FUNCTION_OVERLOADS(
@@ -177,6 +209,49 @@ mrpt::opengl::CSetOfObjects::Ptr CPointsMap_getAs3DObject(CPointsMap& me)
 {
 	return me.getVisualization();
 }
+
+// Read-only, since the map must be notified of changes (see setAllPoints):
+object CPointsMap_getPointsBuffer(object self, int coord)
+{
+	const CPointsMap& me = extract<const CPointsMap&>(self);
+	const auto& v = coord == 0
+		? me.getPointsBufferRef_x()
+		: (coord == 1 ? me.getPointsBufferRef_y() : me.getPointsBufferRef_z());
+	return numpy_view(
+		self, const_cast<float*>(v.data()), NumpyType::Float32,
+		{static_cast<Py_ssize_t>(v.size())}, {sizeof(float)}, false);
+}
+object CPointsMap_getPointsBufferRef_x(object self)
+{
+	return CPointsMap_getPointsBuffer(self, 0);
+}
+object CPointsMap_getPointsBufferRef_y(object self)
+{
+	return CPointsMap_getPointsBuffer(self, 1);
+}
+object CPointsMap_getPointsBufferRef_z(object self)
+{
+	return CPointsMap_getPointsBuffer(self, 2);
+}
+
+void CPointsMap_setAllPoints(CPointsMap& me, object xs, object ys, object zs)
+{
+	object X = numpy_contiguous(xs, NumpyType::Float32);
+	object Y = numpy_contiguous(ys, NumpyType::Float32);
+	object Z = numpy_contiguous(zs, NumpyType::Float32);
+	const auto shape = numpy_shape(X);
+	if (shape.size() != 1 || numpy_shape(Y) != shape || numpy_shape(Z) != shape)
+		TypeError("x, y and z must be 1-D arrays of the same length");
+
+	const auto *x = static_cast<const float*>(numpy_data(X)),
+			   *y = static_cast<const float*>(numpy_data(Y)),
+			   *z = static_cast<const float*>(numpy_data(Z));
+	const size_t N = static_cast<size_t>(shape[0]);
+	me.setSize(N);
+	for (size_t i = 0; i < N; i++)
+		me.setPointFast(i, x[i], y[i], z[i]);
+	me.mark_as_modified();
+}
 // end of CPointsMap
 
 // CSimplePointsMap
@@ -368,6 +443,14 @@ void export_maps()
 				.def(
 					"getAs3DObject", &CMetricMap_getAs3DObject,
 					"Returns a 3D object representing the map.")
+				.def(
+					"computeObservationLikelihoods",
+					&CMetricMap_computeObservationLikelihoods,
+					args("obs", "poses"),
+					"Computes the log-likelihood of an observation taken from "
+					"each of the poses in a Nx3 (x,y,phi) or Nx6 "
+					"(x,y,z,yaw,pitch,roll) array, and returns them as an "
+					"array of N values.")
 				.def_readwrite(
 					"genericMapParams", &CMetricMap::genericMapParams,
 					"Common params to all maps.");
@@ -630,7 +713,27 @@ void export_maps()
 					"or [X Y Z R G B], etc...")
 				.def(
 					"getAs3DObject", &CPointsMap_getAs3DObject,
-					"Returns a 3D object representing the map.");
+					"Returns a 3D object representing the map.")
+				.def(
+					"getPointsBufferRef_x", &CPointsMap_getPointsBufferRef_x,
+					"Returns a read-only NumPy view (no copy) of the X "
+					"coordinates of all points, invalidated if the map is "
+					"resized.")
+				.def(
+					"getPointsBufferRef_y", &CPointsMap_getPointsBufferRef_y,
+					"Returns a read-only NumPy view (no copy) of the Y "
+					"coordinates of all points, invalidated if the map is "
+					"resized.")
+				.def(
+					"getPointsBufferRef_z", &CPointsMap_getPointsBufferRef_z,
+					"Returns a read-only NumPy view (no copy) of the Z "
+					"coordinates of all points, invalidated if the map is "
+					"resized.")
+				.def(
+					"setAllPoints", &CPointsMap_setAllPoints,
+					args("x", "y", "z"),
+					"Replaces all the points in the map with those in three "
+					"1-D arrays of coordinates.");
 	}
 
 	// CSimplePointsMap
@@ -9,6 +9,7 @@
 #include "bindings.h"
 
 /* MRPT */
+#include <mrpt/math/CMatrixDynamic.h>
 #include <mrpt/math/CMatrixFixed.h>
 #include <mrpt/math/TPoint2D.h>
 #include <mrpt/math/TPoint3D.h>
@@ -29,7 +30,10 @@
 		.def(STRINGIFY(__getitem__), &CMatrixDouble##rows##cols##_getitem1)    \
 		.def(STRINGIFY(__getitem__), &CMatrixDouble##rows##cols##_getitem2)    \
 		.def(STRINGIFY(__setitem__), &CMatrixDouble##rows##cols##_setitem1)    \
-		.def(STRINGIFY(__setitem__), &CMatrixDouble##rows##cols##_setitem2);
+		.def(STRINGIFY(__setitem__), &CMatrixDouble##rows##cols##_setitem2)   \
+		.def(                                                                  \
+			"asarray", &CMatrix_asarray<CMatrixDouble##rows##cols>,            \
+			"Returns a writeable NumPy view (no copy) of the matrix.");
 
 #define MAKE_FIXED_DOUBLE_MATRIX_GETITEM(rows, cols)                           \
 	double CMatrixDouble##rows##cols##_getitem1(                               \
@@ -128,6 +132,26 @@ MAKE_SETITEM(TPose3DQuat, double)
 // end of TPose3DQuat
 
 // CMatrixF
+// Both fixed and dynamic matrices store their elements contiguously, in
+// RowMajor order:
+template <class MATRIX>
+object CMatrix_asarray(object self)
+{
+	MATRIX& me = extract<MATRIX&>(self);
+	constexpr Py_ssize_t elem = sizeof(double);
+	return numpy_view(
+		self, me.data(), NumpyType::Float64,
+		{static_cast<Py_ssize_t>(me.rows()), static_cast<Py_ssize_t>(me.cols())},
+		{static_cast<Py_ssize_t>(me.cols()) * elem, elem}, true);
+}
+
+size_t CMatrixDouble_rows(CMatrixDouble& me) { return me.rows(); }
+size_t CMatrixDouble_cols(CMatrixDouble& me) { return me.cols(); }
+void CMatrixDouble_setSize(CMatrixDouble& me, size_t rows, size_t cols)
+{
+	me.setSize(rows, cols);
+}
+
 MAKE_FIXED_DOUBLE_MATRIX_GETSET(3, 3)
 MAKE_FIXED_DOUBLE_MATRIX_GETSET(6, 6)
 
@@ -255,6 +279,21 @@ void export_math()
 		MAKE_FIXED_DOUBLE_MATRIX(3, 3)
 		MAKE_FIXED_DOUBLE_MATRIX(6, 6)
 	}
+
+	// CMatrixDynamic
+	{
+		class_<CMatrixDouble>("CMatrixDouble", init<>())
+			.def(init<size_t, size_t>(args("rows", "cols")))
+			.def("rows", &CMatrixDouble_rows, "Number of rows.")
+			.def("cols", &CMatrixDouble_cols, "Number of columns.")
+			.def(
+				"setSize", &CMatrixDouble_setSize, args("rows", "cols"),
+				"Changes the size of the matrix, invalidating its views.")
+			.def(
+				"asarray", &CMatrix_asarray<CMatrixDouble>,
+				"Returns a writeable NumPy view (no copy) of the matrix, "
+				"invalidated if it is resized.");
+	}
 }
 
 void export_math_stl()
@@ -0,0 +1,96 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#define NPY_NO_DEPRECATED_API NPY_1_7_API_VERSION
+#include "bindings.h"
+
+#include <numpy/arrayobject.h>
+
+/* namespaces */
+using namespace boost::python;
+
+namespace
+{
+int toNumpyType(NumpyType type)
+{
+	switch (type)
+	{
+		case NumpyType::UInt8: return NPY_UINT8;
+		case NumpyType::UInt16: return NPY_UINT16;
+		case NumpyType::Float32: return NPY_FLOAT32;
+		case NumpyType::Float64: return NPY_FLOAT64;
+	}
+	return NPY_NOTYPE;
+}
+
+PyArrayObject* asArray(const object& arr)
+{
+	if (!PyArray_Check(arr.ptr())) TypeError("Expected a NumPy array");
+	return reinterpret_cast<PyArrayObject*>(arr.ptr());
+}
+}  // namespace
+
+void import_numpy()
+{
+	if (_import_array() < 0) throw_error_already_set();
+}
+
+object numpy_view(
+	object owner, void* data, NumpyType type,
+	const std::vector<Py_ssize_t>& shape,
+	const std::vector<Py_ssize_t>& strides, bool writeable)
+{
+	if (shape.size() != strides.size())
+		TypeError("numpy_view: shape and strides must have the same size");
+	// Empty containers may have no buffer at all:
+	if (!data) return numpy_empty(type, shape);
+
+	std::vector<npy_intp> dims(shape.begin(), shape.end());
+	std::vector<npy_intp> steps(strides.begin(), strides.end());
+	PyObject* arr = PyArray_New(
+		&PyArray_Type, static_cast<int>(dims.size()), dims.data(),
+		toNumpyType(type), steps.data(), data, 0,
+		writeable ? NPY_ARRAY_WRITEABLE : 0, nullptr);
+	if (!arr) throw_error_already_set();
+
+	// The array keeps the owner of the memory alive (steals a reference):
+	Py_INCREF(owner.ptr());
+	if (PyArray_SetBaseObject(
+			reinterpret_cast<PyArrayObject*>(arr), owner.ptr()) < 0)
+	{
+		Py_DECREF(arr);
+		throw_error_already_set();
+	}
+	return object(handle<>(arr));
+}
+
+object numpy_empty(NumpyType type, const std::vector<Py_ssize_t>& shape)
+{
+	std::vector<npy_intp> dims(shape.begin(), shape.end());
+	PyObject* arr = PyArray_ZEROS(
+		static_cast<int>(dims.size()), dims.data(), toNumpyType(type), 0);
+	if (!arr) throw_error_already_set();
+	return object(handle<>(arr));
+}
+
+object numpy_contiguous(object obj, NumpyType type)
+{
+	PyObject* arr = PyArray_FROMANY(
+		obj.ptr(), toNumpyType(type), 0, 0, NPY_ARRAY_IN_ARRAY);
+	if (!arr) throw_error_already_set();
+	return object(handle<>(arr));
+}
+
+void* numpy_data(const object& arr) { return PyArray_DATA(asArray(arr)); }
+
+std::vector<Py_ssize_t> numpy_shape(const object& arr)
+{
+	PyArrayObject* a = asArray(arr);
+	const npy_intp* dims = PyArray_DIMS(a);
+	return std::vector<Py_ssize_t>(dims, dims + PyArray_NDIM(a));
+}
@@ -253,6 +253,21 @@ void CObservation2DRangeScan_from_ROS_LaserScan_msg(
 #endif
 // end of CObservation2DRangeScan
 
+// CObservation3DRangeScan
+// A HxW view of the range image, sharing the observation memory:
+object CObservation3DRangeScan_getRangeImage(object self)
+{
+	CObservation3DRangeScan& me = extract<CObservation3DRangeScan&>(self);
+	me.load();	// For delayed-load observations stored externally
+	auto& m = me.rangeImage;
+	constexpr Py_ssize_t elem = sizeof(uint16_t);
+	return numpy_view(
+		self, m.data(), NumpyType::UInt16,
+		{static_cast<Py_ssize_t>(m.rows()), static_cast<Py_ssize_t>(m.cols())},
+		{static_cast<Py_ssize_t>(m.cols()) * elem, elem}, true);
+}
+// end of CObservation3DRangeScan
+
 // CRawLog
 tuple CRawlog_readActionObservationPair(CStream& inStream, size_t rawlogEntry)
 {
@@ -297,6 +312,7 @@ MAKE_PTR_CTX(CObservation)
 MAKE_PTR_CTX(CObservationOdometry)
 MAKE_PTR_CTX(CObservationRange)
 MAKE_PTR_CTX(CObservation2DRangeScan)
+MAKE_PTR_CTX(CObservation3DRangeScan)
 MAKE_PTR_CTX(CObservationBearingRange)
 MAKE_PTR_CTX(CSensoryFrame)
 
@@ -617,6 +633,31 @@ void export_obs()
 			;
 	}
 
+	// CObservation3DRangeScan
+	{
+		MAKE_PTR(CObservation3DRangeScan)
+
+		class_<CObservation3DRangeScan, bases<CObservation>>(
+			"CObservation3DRangeScan", init<>())
+			.def_readwrite(
+				"hasRangeImage", &CObservation3DRangeScan::hasRangeImage)
+			.def_readwrite("rangeUnits", &CObservation3DRangeScan::rangeUnits)
+			.def_readwrite(
+				"range_is_depth", &CObservation3DRangeScan::range_is_depth)
+			.def_readwrite("maxRange", &CObservation3DRangeScan::maxRange)
+			.def_readwrite("sensorPose", &CObservation3DRangeScan::sensorPose)
+			.def(
+				"rangeImage_setSize",
+				&CObservation3DRangeScan::rangeImage_setSize,
+				args("height", "width"),
+				"Resizes the range image, invalidating its views.")
+			.def(
+				"getRangeImage", &CObservation3DRangeScan_getRangeImage,
+				"Returns a writeable NumPy view (no copy) of the HxW uint16 "
+				"range image, in units of rangeUnits, invalidated if it is "
+				"resized.") MAKE_CREATE(CObservation3DRangeScan);
+	}
+
 	// CObservationBearingRange
 	{
 		MAKE_PTR(CObservationBearingRange)
@@ -78,6 +78,40 @@ tuple CICP_AlignPDF2(
 	ret_val.append(info);
 	return tuple(ret_val);
 }
+
+// Aligns m2 to m1 from each of the N initial guesses in a Nx3 (x, y, phi)
+// array, returning a Nx5 array of (x, y, phi, goodness, nIterations):
+object CICP_AlignBatch(
+	CICP& me, CMetricMap& m1, CMetricMap& m2, object initialGuesses)
+{
+	object g = numpy_contiguous(initialGuesses, NumpyType::Float64);
+	const auto shape = numpy_shape(g);
+	if (shape.size() != 2 || shape[1] != 3)
+		TypeError("initialGuesses must be a Nx3 (x,y,phi) array");
+	const size_t N = static_cast<size_t>(shape[0]);
+	const auto* in = static_cast<const double*>(numpy_data(g));
+
+	object ret = numpy_empty(NumpyType::Float64, {shape[0], 5});
+	auto* out = static_cast<double*>(numpy_data(ret));
+	{
+		ScopedGILRelease noGIL;
+		for (size_t i = 0; i < N; i++)
+		{
+			const double* q = in + 3 * i;
+			CICP::TReturnInfo info;
+			const CPose2D p =
+				me.Align(&m1, &m2, CPose2D(q[0], q[1], q[2]), info)
+					->getMeanVal();
+			double* o = out + 5 * i;
+			o[0] = p.x();
+			o[1] = p.y();
+			o[2] = p.phi();
+			o[3] = info.goodness;
+			o[4] = info.nIterations;
+		}
+	}
+	return ret;
+}
 // end of CICP
 
 // CMetricMapBuilder
@@ -445,7 +479,14 @@ void export_slam()
 						  "(relative pose) between two maps "
 						  "(CSimplePointsMap/CSimplePointsMap): the relative "
 						  "pose of m2 with respect to m1. This pose is "
-						  "returned as a PDF rather than a single value.");
+						  "returned as a PDF rather than a single value.")
+					  .def(
+						  "AlignBatch", &CICP_AlignBatch,
+						  args("m1", "m2", "initialGuesses"),
+						  "Aligns m2 with respect to m1 from each of the "
+						  "initial guesses in a Nx3 (x,y,phi) array, and "
+						  "returns a Nx5 array with the (x, y, phi, goodness, "
+						  "nIterations) of each result.");
 
 		class_<CICP::TConfigParams, bases<CLoadableOptions>>(
 			"TConfigParams", init<>())
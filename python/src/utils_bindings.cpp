@@ -12,6 +12,7 @@
 #include <mrpt/config/CConfigFile.h>
 #include <mrpt/config/CConfigFileBase.h>
 #include <mrpt/config/CLoadableOptions.h>
+#include <mrpt/img/CImage.h>
 #include <mrpt/img/TColor.h>
 #include <mrpt/io/CFileGZInputStream.h>
 #include <mrpt/rtti/CObject.h>
@@ -59,6 +60,51 @@ BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(
 // TODO implement read_vector, read_matrix and read_enum
 // end of CConfigFileBase
 
+// CImage
+bool CImage_loadFromFile(CImage& me, const std::string& fileName)
+{
+	return me.loadFromFile(fileName);
+}
+bool CImage_saveToFile(CImage& me, const std::string& fileName)
+{
+	return me.saveToFile(fileName);
+}
+size_t CImage_getChannelCount(CImage& me) { return me.getChannelCount(); }
+
+// A HxW (gray) or HxWx3 (BGR) view of the pixels, sharing the image memory
+// (rows may be padded):
+object CImage_asarray(object self)
+{
+	CImage& me = extract<CImage&>(self);
+	if (me.isEmpty()) return numpy_empty(NumpyType::UInt8, {0, 0});
+	if (me.getPixelDepth() != PixelDepth::D8U)
+		TypeError("CImage.asarray() only supports 8-bit images");
+
+	const auto H = static_cast<Py_ssize_t>(me.getHeight());
+	const auto W = static_cast<Py_ssize_t>(me.getWidth());
+	const auto C = static_cast<Py_ssize_t>(me.getChannelCount());
+	const auto stride = static_cast<Py_ssize_t>(me.getRowStride());
+	uint8_t* data = me.ptrLine<uint8_t>(0);
+	if (C == 1)
+		return numpy_view(
+			self, data, NumpyType::UInt8, {H, W}, {stride, 1}, true);
+	return numpy_view(
+		self, data, NumpyType::UInt8, {H, W, C}, {stride, C, 1}, true);
+}
+
+// Copies a HxW (gray) or HxWx3 (BGR) uint8 array:
+void CImage_loadFromArray(CImage& me, object arr)
+{
+	object a = numpy_contiguous(arr, NumpyType::UInt8);
+	const auto shape = numpy_shape(a);
+	if (!(shape.size() == 2 || (shape.size() == 3 && shape[2] == 3)))
+		TypeError("Expected a HxW or HxWx3 array");
+	me.loadFromMemoryBuffer(
+		static_cast<unsigned int>(shape[1]), static_cast<unsigned int>(shape[0]),
+		shape.size() == 3, static_cast<unsigned char*>(numpy_data(a)));
+}
+// end of CImage
+
 // Utils
 double mrpt_utils_DEG2RAD(double deg) { return mrpt::DEG2RAD(deg); }
 double mrpt_utils_RAD2DEG(double rad) { return mrpt::RAD2DEG(rad); }
@@ -231,6 +277,33 @@ void export_utils()
 			.def("close", &CFileGZInputStream::close, "Closes the file.");
 	}
 
+	// CImage
+	{
+		class_<CImage, bases<CSerializable>>(
+			"CImage", "A class for storing images.", init<>())
+			.def(
+				"loadFromFile", &CImage_loadFromFile, args("fileName"),
+				"Loads an image from a file, returns false on error.")
+			.def(
+				"saveToFile", &CImage_saveToFile, args("fileName"),
+				"Saves the image to a file, returns false on error.")
+			.def("getWidth", &CImage::getWidth, "Width of the image.")
+			.def("getHeight", &CImage::getHeight, "Height of the image.")
+			.def(
+				"getChannelCount", &CImage_getChannelCount,
+				"Number of channels (1: gray, 3: BGR).")
+			.def("isColor", &CImage::isColor, "True for BGR images.")
+			.def(
+				"asarray", &CImage_asarray,
+				"Returns a writeable NumPy view (no copy) of the pixels, as a "
+				"HxW (gray) or HxWx3 (BGR) uint8 array, invalidated if the "
+				"image is resized or reloaded.")
+			.def(
+				"loadFromArray", &CImage_loadFromArray, args("array"),
+				"Copies the pixels of a HxW (gray) or HxWx3 (BGR) uint8 "
+				"array into the image.");
+	}
+
 	// static module functions
 	def("DEG2RAD", &mrpt_utils_DEG2RAD, args("deg"),
 		"Convert degrees to radiants.");